@@ -25,13 +25,12 @@ echo ========================================
 REM Copy executable
 copy "Build\Editor\%BUILD_CONFIG%\Editor.exe" "%DIST_DIR%\"
 
-REM Copy shaders
-mkdir "%DIST_DIR%\Shaders"
-copy "Build\Editor\%BUILD_CONFIG%\Shaders\*.spv" "%DIST_DIR%\Shaders\"
+REM Pack assets and shaders into one archive, mounted at startup
+"Build\bin\%BUILD_CONFIG%\AssetPacker.exe" --shaders "Build\Editor\%BUILD_CONFIG%\Shaders" --output "%DIST_DIR%\Assets.nbpak" Editor
 
-REM Copy assets
-if exist "Editor\Assets" (
-    xcopy "Editor\Assets" "%DIST_DIR%\Assets\" /E /I /Y
+REM glTF models are still read as loose files
+if exist "Editor\Assets\Models" (
+    xcopy "Editor\Assets\Models" "%DIST_DIR%\Assets\Models\" /E /I /Y
 )
 
 echo.
@@ -1,17 +1,18 @@
 //------------------------------------------------------------------------------
 // Clouds.frag
 //
-// Thin composite shader — samples the low-res cloud raymarch result
-// (computed by CloudRaymarch.comp, see .claude/ROADMAP.md Phase 1.4 for the
-// performance rationale) with hardware bilinear upscale, and outputs it
-// directly. No raymarching, no camera/lighting data needed here at all —
+// Thin composite shader — samples the cloud raymarch result (computed at
+// low resolution by CloudRaymarch.comp, see .claude/ROADMAP.md Phase 1.4
+// for the performance rationale, and brought to full resolution by
+// CloudUpsample.comp), and outputs it directly. The water reflection's
+// composite samples its own low-res result, marched whole, the same way. No raymarching, no camera/lighting data needed here at all —
 // occlusion against terrain/opaque geometry is still handled entirely by
 // the normal full-resolution GPU depth test (Clouds.vert's fixed "at
 // infinity" depth output, depth-test on, write off), unchanged from before
 // this pass was split into compute + composite.
 //
 // Descriptor sets:
-//   set 0 - the low-res raymarch result (only set needed)
+//   set 0 - the cloud result (only set needed)
 //------------------------------------------------------------------------------
 #version 450
 
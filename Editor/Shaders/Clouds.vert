@@ -8,6 +8,7 @@
 // after opaque/terrain have already written real depth, the normal GPU
 // depth test (GreaterOrEqual) discards cloud pixels wherever anything closer
 // was already drawn, occluding clouds behind terrain/mountains for free.
+// Sky.frag draws the atmosphere over the same triangle.
 //------------------------------------------------------------------------------
 #version 450
 
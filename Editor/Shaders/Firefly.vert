@@ -4,12 +4,13 @@
 // Camera-facing billboard quad for one firefly agent. No vertex/index buffer —
 // the quad is generated procedurally from gl_VertexIndex (6 verts/instance,
 // 2 triangles), and per-agent data is read from the storage buffer (set 1)
+// through the billboard half of the visible list FireflyCull.comp compacts,
 // by gl_InstanceIndex. Camera right/up are derived from the view matrix's
 // basis columns rather than passed in separately.
 //
 // Descriptor sets:
 //   set 0 - FrameUniforms (view, proj)
-//   set 1 - firefly agent storage buffer (vertex+compute visible)
+//   set 1 - firefly agent storage buffer + visible lists (vertex+compute visible)
 //------------------------------------------------------------------------------
 #version 450
 
@@ -24,6 +25,10 @@ layout(set = 1, binding = 0, std430) readonly buffer AgentBuffer {
     vec4 data[];
 } agentBuffer;
 
+layout(set = 1, binding = 1, std430) readonly buffer VisibleBuffer {
+    uint indices[];
+} visible;
+
 layout(location = 0) out vec2 outUV;
 layout(location = 1) out vec4 outColor;
 
@@ -49,7 +54,7 @@ void main()
     vec2 corner = kCorners[cornerIndex];
     outUV = kUVs[cornerIndex];
 
-    uint agentIndex = uint(gl_InstanceIndex);
+    uint agentIndex = visible.indices[gl_InstanceIndex];
     uint baseIndex = agentIndex * 4u;
 
     vec4 posAndBrightness = agentBuffer.data[baseIndex + 0u];
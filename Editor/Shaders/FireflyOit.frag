@@ -0,0 +1,11 @@
+//------------------------------------------------------------------------------
+// FireflyOit.frag
+//
+// Firefly.frag writing the weighted-blended OIT accumulation/revealage pair
+// (oit.glsl) for the first subpass of the order-independent transparency
+// pass.
+//------------------------------------------------------------------------------
+#version 450
+
+#define NB_OIT_ACCUMULATE
+#include "firefly_shading.glsl"
@@ -0,0 +1,10 @@
+//------------------------------------------------------------------------------
+// FireflyPoint.frag
+//
+// Firefly.frag for the point sprites of distant fireflies: the same glow,
+// over gl_PointCoord instead of the billboard's UVs.
+//------------------------------------------------------------------------------
+#version 450
+
+#define NB_FIREFLY_POINT
+#include "firefly_shading.glsl"
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+// FireflyPoint.vert
+//
+// A distant firefly as a single point, sized to the billboard Firefly.vert
+// would have drawn. The agent comes from the point half of the visible list
+// (FireflyCull.comp), which starts halfway through the buffer. Points that
+// would cover less than a pixel are dimmed by their coverage instead, so
+// the swarm keeps its brightness as it recedes rather than sparkling.
+//
+// Descriptor sets:
+//   set 0 - FrameUniforms (view, proj)
+//   set 1 - firefly agent storage buffer + visible lists (vertex+compute visible)
+// Push constants: customData.x = render target height in pixels
+//------------------------------------------------------------------------------
+#version 450
+
+layout(set = 0, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+} frame;
+
+layout(set = 1, binding = 0, std430) readonly buffer AgentBuffer {
+    vec4 data[];
+} agentBuffer;
+
+layout(set = 1, binding = 1, std430) readonly buffer VisibleBuffer {
+    uint indices[];
+} visible;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;        // unused
+    vec4 customData;
+} push;
+
+layout(location = 1) out vec4 outColor;
+
+// Largest point drawn; pointDistance keeps real ones well below it
+const float kMaxPointSize = 16.0;
+
+void main()
+{
+    uint listStart = uint(visible.indices.length()) / 2u;
+    uint agentIndex = visible.indices[listStart + uint(gl_InstanceIndex)];
+    uint baseIndex = agentIndex * 4u;
+
+    vec4 posAndBrightness = agentBuffer.data[baseIndex + 0u];
+    float size = agentBuffer.data[baseIndex + 1u].w;
+    vec3 fireflyColor = agentBuffer.data[baseIndex + 3u].xyz;
+
+    gl_Position = frame.proj * frame.view * vec4(posAndBrightness.xyz, 1.0);
+
+    // The billboard's side in pixels at this depth
+    float pixels = size * abs(frame.proj[1][1]) * 0.5 * push.customData.x / max(gl_Position.w, 1e-4);
+    gl_PointSize = clamp(pixels, 1.0, kMaxPointSize);
+
+    float coverage = min(pixels * pixels, 1.0);
+    outColor = vec4(fireflyColor * posAndBrightness.w * coverage, 1.0);
+}
@@ -0,0 +1,11 @@
+//------------------------------------------------------------------------------
+// FireflyPointOit.frag
+//
+// FireflyPoint.frag writing the weighted-blended OIT accumulation/revealage
+// pair (oit.glsl), as FireflyOit.frag does for the billboards.
+//------------------------------------------------------------------------------
+#version 450
+
+#define NB_FIREFLY_POINT
+#define NB_OIT_ACCUMULATE
+#include "firefly_shading.glsl"
@@ -8,18 +8,26 @@
 // a back-light translucency term (grass glows when the sun is behind it), a
 // root-darkening fake AO, and the same PCF shadow lookup Terrain.frag uses
 // (struct layouts copied verbatim — this codebase has no shared .glsl include
-// mechanism). No specular, no point lights — not worth it for thin blades.
+// mechanism). No specular — not worth it for thin blades. Point lights (the
+// fireflies among them) only come from the light clusters: wrap diffuse, no
+// shadow, so a swarm lights the field around it.
 //
 // Descriptor sets:
 //   set 0 - FrameUBO (cameraPos — used for the two-sided view-facing flip)
 //   set 1 - foliage storage buffer (vertex stage — unused here)
-//   set 2 - SceneLightingData
+//   set 2 - SceneLightingData + clustered point lights
 //   set 3 - shadow map sampler
 //   set 4 - heightmap (vertex stage — unused here)
+//
+// Also built with NB_HALF_PRECISION (Grass.frag.fp16.spv) for the
+// HalfPrecision variant: the colour and lighting terms are mfloat, the
+// shadow lookup and the point-light distances stay float.
 //------------------------------------------------------------------------------
 #version 450
 
+#include "half_precision.glsl"   // first: the fp16 build enables an extension
 #include "shadows.glsl"   // set 0 frame, set 2 lighting, set 3 shadowMap + CSM functions
+#include "grass_field.glsl"   // root/tip colours, shared with the far field
 
 layout(location = 0) in vec3 inWorldPos;
 layout(location = 1) in vec3 inNormal;
@@ -33,10 +41,7 @@ void main()
 {
     ClipReflection(inWorldPos);  // drop below-water blades in the reflection pass
 
-    const vec3 kRootColor = vec3(0.08, 0.22, 0.05);
-    const vec3 kTipColor  = vec3(0.46, 0.62, 0.20);
-
-    vec3 albedo = mix(kRootColor, kTipColor, inHeightFraction) * inTint;
+    mvec3 albedo = mvec3(mix(GRASS_ROOT_COLOR, GRASS_TIP_COLOR, inHeightFraction) * inTint);
 
     // Up-biased normal. The baked blade normal always points up-ish (the
     // per-instance transform is a Y-rotation, which preserves the up
@@ -49,26 +54,47 @@ void main()
     vec3 Nshade = normalize(mix(N, vec3(0.0, 1.0, 0.0), 0.4));
 
     vec3 L = normalize(-lighting.lights[0].position.xyz);
-    vec3 lightColor = lighting.lights[0].color.xyz * lighting.lights[0].color.w;
+    mvec3 lightColor = mvec3(lighting.lights[0].color.xyz * lighting.lights[0].color.w);
     // Thin blades: no receiver-plane bias (pass 0), default bias scale.
     int cascade;
-    float shadow = SampleShadow(inWorldPos, Nshade, L, 1.0, 0.0, cascade);
+    mfloat shadow = mfloat(SampleShadow(inWorldPos, Nshade, L, 1.0, 0.0, cascade));
 
     // Half-Lambert (wrap) diffuse — softer falloff suits grass.
-    float diffuse = clamp(dot(Nshade, L) * 0.5 + 0.5, 0.0, 1.0);
+    mfloat NdotL = mfloat(dot(Nshade, L));
+    mfloat diffuse = clamp(NdotL * mfloat(0.5) + mfloat(0.5), mfloat(0.0), mfloat(1.0));
     diffuse *= diffuse;
 
     // Translucency / back-light glow: light passing THROUGH the blade when the
     // sun is behind it. The single biggest "real grass" cue with no texture.
-    float backLight = clamp(dot(-Nshade, L), 0.0, 1.0);
-    float transmission = pow(backLight, 2.0) * 0.6;
+    mfloat backLight = clamp(-NdotL, mfloat(0.0), mfloat(1.0));
+    mfloat transmission = backLight * backLight * mfloat(0.6);
 
     // Fake AO: darker toward the root (less sky/light reaches between blades).
-    float ao = mix(0.45, 1.0, inHeightFraction);
+    mfloat ao = mix(mfloat(0.45), mfloat(1.0), mfloat(inHeightFraction));
+
+    mvec3 ambient = mvec3(lighting.ambient.xyz * lighting.ambient.w) * albedo * ao;
+    mvec3 direct  = lightColor * albedo * (diffuse + transmission) * shadow * ao;
+
+    mvec3 pointLight = mvec3(0.0);
+    if (ClusteredLightsActive())
+    {
+        uint cluster = FragmentLightCluster(inWorldPos);
+        uint count = lightClusters.counts[cluster];
+        for (uint j = 0u; j < count; ++j)
+        {
+            ClusterLight light = clusterLights.lights[lightClusters.indices[cluster * LIGHT_CLUSTER_MAX_LIGHTS + j]];
+            vec3  toLight = light.position.xyz - inWorldPos;
+            float dist    = length(toLight);
+            float radius  = light.attenuation.w;
+            if (dist >= radius) continue;
 
-    vec3 ambient = lighting.ambient.xyz * lighting.ambient.w * albedo * ao;
-    vec3 direct  = lightColor * albedo * (diffuse + transmission) * shadow * ao;
+            mfloat wrap = mfloat(clamp(dot(Nshade, toLight / max(dist, 0.0001)) * 0.5 + 0.5, 0.0, 1.0));
+            mfloat att  = mfloat((1.0 - smoothstep(0.0, radius, dist)) *
+                                 LocalLightShadow(light.position, inWorldPos, vec3(Nshade)));
+            pointLight += mvec3(light.color.rgb * light.color.a) * wrap * att;
+        }
+    }
 
-    vec3 finalColor = ambient + direct;
+    vec3 finalColor = vec3(ambient + direct + pointLight * albedo * ao);
     outColor = vec4(ApplyCascadeDebug(finalColor, cascade), 1.0);
 }
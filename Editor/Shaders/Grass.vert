@@ -4,13 +4,13 @@
 // Real instanced blade mesh (VertexPNT, see BladeMesh.hpp) — root at origin,
 // local height 0..1, forward-curved with a baked per-row normal. Per-instance
 // world position/rotation/scale/tint/wind-phase comes from the foliage storage
-// buffer (set 1), indexed by gl_InstanceIndex, same raw-vec4-array pattern
-// Firefly.vert uses for its agent buffer.
+// buffer (set 1), indexed by gl_InstanceIndex, packed to 16 bytes a blade
+// (UnpackBlade in grass_field.glsl).
 //
-// Terrain height + slope are sampled from the same heightmap (set 4) Terrain
-// itself uses, with the same finite-difference technique Terrain.vert uses
-// for normals — there is no CPU-side height query in this engine, so all of
-// this must happen here. Blades on slopes steeper than a threshold fade to
+// Terrain height + slope come from one fetch of the same surface map (set 4)
+// Terrain itself uses — height plus its gradient, precomputed by
+// TerrainSurface.comp, so the normal costs no extra samples. Blades on
+// slopes steeper than a threshold fade to
 // a zero-size point at the root over a soft falloff band (cheap
 // cliff-avoidance with no hard "wall" at the cutoff, no compute compaction
 // needed).
@@ -30,18 +30,27 @@
 // PushConstantData struct (which every other pipeline also uses).
 // See GrassSystem::SubmitDraw.
 //
+// GPU-culled path: when pc.model[2].x is set the patch was drawn through an
+// indirect draw written by GrassCull.comp, so the per-patch LOD params above
+// come from the patch-LOD buffer (set 1 binding 1) instead, looked up by the
+// patch index baked into each instance at pc.model[2].y + patchIndex.
+//
 // Descriptor set layout (matches VulkanPipelineAdapter's if-chain order for
 // the Foliage pipeline config — see Renderer.cpp's Foliage pipeline block):
-//   set 0 - FrameUniforms (view, proj, time, cameraPos)
-//   set 1 - foliage instance storage buffer (vertex-only)
+//   set 0 - FrameUniforms (view, proj, time, cameraPos, wind window) + the
+//           wind field (binding 2, wind_field.glsl)
+//   set 1 - foliage instance storage buffer + per-patch LOD buffer (vertex-only)
 //   set 2 - lighting UBO (fragment only — unused here)
 //   set 3 - shadow map (fragment only — unused here)
-//   set 4 - heightmap (vertex stage — sampled here)
+//   set 4 - terrain surface map (vertex stage — sampled here)
 //------------------------------------------------------------------------------
 #version 450
 
+#include "grass_field.glsl"   // UnpackBlade
+#include "wind_field.glsl"    // SampleWind, WindSway
+
 layout(location = 0) in vec3 inPosition;   // local blade space: x=tapered half-width, y=height fraction, z=0
-layout(location = 1) in vec3 inNormal;     // unused — terrain finite-difference normal used instead
+layout(location = 1) in vec3 inNormal;     // baked blade normal (rotated per instance below)
 layout(location = 2) in vec2 inTexCoord;   // x = side (0=left,1=right), y = height fraction (matches inPosition.y)
 
 layout(location = 0) out vec3 outWorldPos;
@@ -50,52 +59,57 @@ layout(location = 2) out float outHeightFraction;
 layout(location = 3) out vec3 outTint;
 layout(location = 4) out vec4 outShadowCoord;
 
+// Bit-identical depth in the prepass (FoliageDepth) and the EQUAL color pass
+invariant gl_Position;
+
+// The FrameUBO of scene_common.glsl, down to the wind field
 layout(set = 0, binding = 0) uniform FrameUniforms {
     mat4 view;
     mat4 proj;
     vec4 time;
     vec4 cameraPos;
+    mat4 invView;
+    mat4 invProj;
+    vec4 reflection;
+    vec4 farGrassLod;
+    vec4 farGrassDensity;
+    vec4 farGrassSlope;
+    vec4 windField;       // xy = window min corner, z = window side, w = baked
+    vec4 windDirection;   // xy = unit heading in xz
 } frame;
 
+// One packed blade each (GrassInstance, 16 bytes; see grass_field.glsl)
 layout(set = 1, binding = 0, std430) readonly buffer FoliageBuffer {
-    vec4 data[];
+    uvec4 blades[];
 } foliage;
 
-layout(set = 4, binding = 0) uniform sampler2D heightmap;
+// (drawCountF, fadeBand, firstInstance, unused) per patch, per frame in flight
+layout(set = 1, binding = 1, std430) readonly buffer PatchLodBuffer {
+    vec4 data[];
+} patchLod;
+
+layout(set = 4, binding = 0) uniform sampler2D heightmap;  // r = height, gb = gradient per uv unit
 
 layout(push_constant) uniform PushConstants
 {
     mat4 model;       // model[0] repurposed: (terrainWorldSize, terrainHeightScale, terrainPosX, terrainPosZ)
                       // model[1] repurposed: (slopeFalloffCos, lodFirstInstance, lodDrawCountF, lodFadeBand)
-    vec4 customData;  // x = slopeThresholdCos (upper bound), y = windStrength, z = windFrequency, w = windSpeed
+                      // model[2] repurposed: (gpuCulled, patchLodBase, -, -)
+    vec4 customData;  // x = slopeThresholdCos (upper bound), y = windStrength
 } pc;
 
-float SampleHeight(vec2 uv)
+vec4 SampleSurface(vec2 uv)
 {
     uv = clamp(uv, vec2(0.001), vec2(0.999));
-    return textureLod(heightmap, uv, 0.0).r;
+    return textureLod(heightmap, uv, 0.0);
 }
 
-// Coarse finite-difference slope/normal estimate. Grass doesn't need the
-// pixel-accurate normal Terrain.vert computes (it has the heightmap's exact
-// texel size available) — a fixed small step is sufficient for a binary
-// "is this too steep to grow grass" test and a reasonable shading normal.
-vec3 ComputeTerrainNormal(vec2 uv, float worldSize, float heightScale)
+// Same normal Terrain.vert builds: the gradient is height per uv unit, and
+// one uv unit spans the whole terrain here
+vec3 ComputeTerrainNormal(vec2 gradient, float worldSize, float heightScale)
 {
-    const float kSampleStep = 1.0 / 256.0;
-
-    float hL = SampleHeight(uv + vec2(-kSampleStep, 0.0));
-    float hR = SampleHeight(uv + vec2( kSampleStep, 0.0));
-    float hD = SampleHeight(uv + vec2(0.0, -kSampleStep));
-    float hU = SampleHeight(uv + vec2(0.0,  kSampleStep));
-
-    float worldStep = 2.0 * kSampleStep * worldSize;
-
-    return normalize(vec3(
-        (hL - hR) * heightScale,
-        worldStep,
-        (hD - hU) * heightScale
-    ));
+    float slopeScale = heightScale / worldSize;
+    return normalize(vec3(-gradient.x * slopeScale, 1.0, -gradient.y * slopeScale));
 }
 
 void main()
@@ -116,19 +130,24 @@ void main()
     float lodDrawCountF     = pc.model[1].z;
     float lodFadeBand       = pc.model[1].w;
     float windStrength      = pc.customData.y;
-    float windFrequency     = pc.customData.z;
-    float windSpeed         = pc.customData.w;
 
-    uint idx = uint(gl_InstanceIndex);
-    vec4 d0 = foliage.data[idx * 2u + 0u];
-    vec4 d1 = foliage.data[idx * 2u + 1u];
+    GrassBlade blade = UnpackBlade(foliage.blades[gl_InstanceIndex],
+        terrainPosXZ - 0.5 * terrainWorldSize, terrainWorldSize);
 
-    float worldX = d0.x;
-    float worldZ = d0.y;
-    float rotY   = d0.z;
-    float scale  = d0.w;
-    vec3  tint   = d1.xyz;
-    float windPhase = d1.w;
+    float worldX = blade.worldXZ.x;
+    float worldZ = blade.worldXZ.y;
+    float rotY   = blade.rotY;
+    float scale  = blade.scale;
+    vec3  tint   = vec3(blade.tint);
+    float windPhase = blade.windPhase;
+
+    if (pc.model[2].x > 0.5)
+    {
+        vec4 lod = patchLod.data[uint(pc.model[2].y) + blade.patchIndex];
+        lodDrawCountF    = lod.x;
+        lodFadeBand      = lod.y;
+        lodFirstInstance = lod.z;
+    }
 
     // Cross-fade this blade by its position in the drawn prefix.
     float localIdx = float(gl_InstanceIndex) - lodFirstInstance;
@@ -136,8 +155,9 @@ void main()
     scale *= lodFade;
 
     vec2 uv = (vec2(worldX, worldZ) - terrainPosXZ) / terrainWorldSize + 0.5;
-    float terrainY = SampleHeight(uv) * terrainHeightScale;
-    vec3 terrainNormal = ComputeTerrainNormal(uv, terrainWorldSize, terrainHeightScale);
+    vec4 surface = SampleSurface(uv);
+    float terrainY = surface.r * terrainHeightScale;
+    vec3 terrainNormal = ComputeTerrainNormal(surface.gb, terrainWorldSize, terrainHeightScale);
 
     // Don't grow grass underwater. frame.time.y = water surface Y, frame.time.z
     // = water-enabled flag (set by the Renderer when a WaterSystem is active).
@@ -186,13 +206,13 @@ void main()
 
     vec3 scaledLocal = rotated * scale;
 
-    // Wind bends toward the tip (height fraction^2 weighting), blowing along
-    // a fixed world +X direction — a v1 simplification, easily replaced with
-    // a real wind direction parameter later.
+    // Wind bends toward the tip (height fraction^2 weighting) along the wind
+    // direction: the field's sway, shifted by the blade's own phase, plus
+    // the gust pushing it downwind.
+    WindSample wind = SampleWind(vec2(worldX, worldZ), frame.windField);
     float windWeight = inTexCoord.y * inTexCoord.y;
-    float windPhaseTotal = frame.time.x * windSpeed + worldX * windFrequency + windPhase;
-    float windOffsetMag = sin(windPhaseTotal) * windStrength * windWeight * scale;
-    vec3 windOffset = vec3(windOffsetMag, 0.0, 0.0);
+    float windOffsetMag = (WindSway(wind, windPhase) + wind.gust) * windStrength * windWeight * scale;
+    vec3 windOffset = vec3(frame.windDirection.x, 0.0, frame.windDirection.y) * windOffsetMag;
 
     vec3 worldPos = vec3(
         worldX + (scaledLocal.x + windOffset.x) * cullFactor,
@@ -0,0 +1,278 @@
+//------------------------------------------------------------------------------
+// atmosphere.glsl
+//
+// The atmosphere's maths for the LUT passes (AtmosphereLuts): a straight port
+// of Atmosphere.hpp - keep the two in sync - plus Hillaire's in-scattering
+// integral. Distances are in km, the planet centred at the origin with the
+// camera above it on +y.
+//
+// Provides:
+//   AtmosphereData (mirrors AtmosphereParamsData)
+//   SampleMedium, RaySphereNearest, RayleighPhase, MiePhase
+//   TransmittanceLutUv / TransmittanceLutRMu, SkyViewLutUv / SkyViewLutParams
+//   UnitToTexelUv / TexelUvToUnit, MultiScatteringLutUv
+//   IntegrateScattering
+//------------------------------------------------------------------------------
+#ifndef NB_ATMOSPHERE_GLSL
+#define NB_ATMOSPHERE_GLSL
+
+// Mirror Atmosphere's constants
+const vec2  TRANSMITTANCE_LUT_SIZE = vec2(256.0, 64.0);
+const float MULTI_SCATTERING_LUT_SIZE = 32.0;
+const vec2  SKY_VIEW_LUT_SIZE = vec2(192.0, 108.0);
+const float AERIAL_LUT_SIZE = 32.0;
+const float AERIAL_DEPTH_KM = 32.0;
+const float PLANET_RADIUS_OFFSET = 0.01;
+const float OZONE_CENTER_KM = 25.0;
+const float OZONE_HALF_WIDTH_KM = 15.0;
+const float ATMOSPHERE_PI = 3.14159265358979;
+
+struct AtmosphereData
+{
+    vec4 radii;     // x = planet, y = top of the atmosphere, z = camera (km), w = Mie anisotropy
+    vec4 rayleigh;  // rgb = scattering (1/km), w = scale height (km)
+    vec4 mie;       // x = scattering, y = absorption (1/km), z = scale height (km), w = ground albedo
+    vec4 ozone;     // rgb = absorption (1/km), w = km of haze per world unit (0 = no aerial perspective)
+    vec4 sun;       // xyz = toward the sun, w = illuminance (0 = atmosphere off)
+};
+
+struct MediumSample
+{
+    vec3 rayleighScattering;
+    vec3 mieScattering;
+    vec3 scattering;
+    vec3 extinction;
+};
+
+MediumSample SampleMedium(AtmosphereData atmosphere, float altitude)
+{
+    float rayleighDensity = exp(-altitude / atmosphere.rayleigh.w);
+    float mieDensity = exp(-altitude / atmosphere.mie.z);
+    float ozoneDensity = max(0.0, 1.0 - abs(altitude - OZONE_CENTER_KM) / OZONE_HALF_WIDTH_KM);
+
+    MediumSample medium;
+    medium.rayleighScattering = atmosphere.rayleigh.rgb * rayleighDensity;
+    medium.mieScattering = vec3(atmosphere.mie.x * mieDensity);
+    medium.scattering = medium.rayleighScattering + medium.mieScattering;
+    medium.extinction = medium.rayleighScattering + vec3((atmosphere.mie.x + atmosphere.mie.y) * mieDensity) +
+                        atmosphere.ozone.rgb * ozoneDensity;
+    return medium;
+}
+
+// Distance along the unit direction to the nearest hit of a sphere centred
+// at the origin, 0 from inside it, -1 when it is behind or missed
+float RaySphereNearest(vec3 origin, vec3 direction, float radius)
+{
+    float b = dot(origin, direction);
+    float c = dot(origin, origin) - radius * radius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0)
+        return -1.0;
+
+    float root = sqrt(discriminant);
+    float t0 = -b - root;
+    float t1 = -b + root;
+    if (t0 < 0.0 && t1 < 0.0)
+        return -1.0;
+    if (t0 < 0.0)
+        return max(0.0, t1);
+    return max(0.0, t0);
+}
+
+float RayleighPhase(float cosTheta)
+{
+    return 3.0 / (16.0 * ATMOSPHERE_PI) * (1.0 + cosTheta * cosTheta);
+}
+
+// Cornette-Shanks: Henyey-Greenstein with the Rayleigh-like lobe that keeps
+// the forward peak from washing out the sky away from the sun
+float MiePhase(float g, float cosTheta)
+{
+    float k = 3.0 / (8.0 * ATMOSPHERE_PI) * (1.0 - g * g) / (2.0 + g * g);
+    return k * (1.0 + cosTheta * cosTheta) / pow(max(1.0 + g * g - 2.0 * g * cosTheta, 1e-4), 1.5);
+}
+
+float UnitToTexelUv(float unit, float resolution)
+{
+    return 0.5 / resolution + unit * (resolution - 1.0) / resolution;
+}
+
+float TexelUvToUnit(float uv, float resolution)
+{
+    return (uv - 0.5 / resolution) * resolution / (resolution - 1.0);
+}
+
+// Atmosphere::TransmittanceLutUv
+vec2 TransmittanceLutUv(AtmosphereData atmosphere, float r, float mu)
+{
+    float bottom = atmosphere.radii.x;
+    float top = atmosphere.radii.y;
+    float H = sqrt(max(0.0, top * top - bottom * bottom));
+    float rho = sqrt(max(0.0, r * r - bottom * bottom));
+    float discriminant = r * r * (mu * mu - 1.0) + top * top;
+    float d = max(0.0, -r * mu + sqrt(max(0.0, discriminant)));
+    float dMin = top - r;
+    float dMax = rho + H;
+    float x = dMax > dMin ? (d - dMin) / (dMax - dMin) : 0.0;
+    return vec2(x, H > 0.0 ? rho / H : 0.0);
+}
+
+// Atmosphere::TransmittanceLutRMu
+void TransmittanceLutRMu(AtmosphereData atmosphere, vec2 uv, out float r, out float mu)
+{
+    float bottom = atmosphere.radii.x;
+    float top = atmosphere.radii.y;
+    float H = sqrt(max(0.0, top * top - bottom * bottom));
+    float rho = H * uv.y;
+    r = sqrt(rho * rho + bottom * bottom);
+
+    float dMin = top - r;
+    float dMax = rho + H;
+    float d = dMin + uv.x * (dMax - dMin);
+    mu = d == 0.0 ? 1.0 : (H * H - rho * rho - d * d) / (2.0 * r * d);
+    mu = clamp(mu, -1.0, 1.0);
+}
+
+// Atmosphere::SkyViewLutUv
+vec2 SkyViewLutUv(AtmosphereData atmosphere, float r, float viewZenithCos, float lightViewCos)
+{
+    float horizonDistance = sqrt(max(0.0, r * r - atmosphere.radii.x * atmosphere.radii.x));
+    float beta = acos(clamp(horizonDistance / r, -1.0, 1.0));
+    float zenithHorizonAngle = ATMOSPHERE_PI - beta;
+    float viewZenithAngle = acos(clamp(viewZenithCos, -1.0, 1.0));
+
+    float v;
+    if (viewZenithAngle < zenithHorizonAngle)
+        v = (1.0 - sqrt(max(0.0, 1.0 - viewZenithAngle / zenithHorizonAngle))) * 0.5;
+    else
+        v = sqrt(max(0.0, (viewZenithAngle - zenithHorizonAngle) / beta)) * 0.5 + 0.5;
+    float u = sqrt(clamp(-lightViewCos * 0.5 + 0.5, 0.0, 1.0));
+    return vec2(UnitToTexelUv(u, SKY_VIEW_LUT_SIZE.x), UnitToTexelUv(v, SKY_VIEW_LUT_SIZE.y));
+}
+
+// Atmosphere::SkyViewLutParams
+void SkyViewLutParams(AtmosphereData atmosphere, float r, vec2 uv, out float viewZenithCos, out float lightViewCos)
+{
+    float u = TexelUvToUnit(uv.x, SKY_VIEW_LUT_SIZE.x);
+    float v = TexelUvToUnit(uv.y, SKY_VIEW_LUT_SIZE.y);
+
+    float horizonDistance = sqrt(max(0.0, r * r - atmosphere.radii.x * atmosphere.radii.x));
+    float beta = acos(clamp(horizonDistance / r, -1.0, 1.0));
+    float zenithHorizonAngle = ATMOSPHERE_PI - beta;
+
+    if (v < 0.5)
+    {
+        float coord = 1.0 - 2.0 * v;
+        viewZenithCos = cos(zenithHorizonAngle * (1.0 - coord * coord));
+    }
+    else
+    {
+        float coord = v * 2.0 - 1.0;
+        viewZenithCos = cos(zenithHorizonAngle + beta * coord * coord);
+    }
+    lightViewCos = -(u * u * 2.0 - 1.0);
+}
+
+// x = sun zenith cos, y = altitude through the atmosphere
+vec2 MultiScatteringLutUv(AtmosphereData atmosphere, float r, float sunZenithCos)
+{
+    vec2 unit = vec2(sunZenithCos * 0.5 + 0.5,
+                     (r - atmosphere.radii.x) / (atmosphere.radii.y - atmosphere.radii.x));
+    return vec2(UnitToTexelUv(clamp(unit.x, 0.0, 1.0), MULTI_SCATTERING_LUT_SIZE),
+                UnitToTexelUv(clamp(unit.y, 0.0, 1.0), MULTI_SCATTERING_LUT_SIZE));
+}
+
+struct ScatteringResult
+{
+    vec3 luminance;      // in-scattered light toward the origin, for a sun of illuminance 1
+    vec3 throughput;     // transmittance along the ray
+    vec3 multiScatterAs1; // f_ms of Hillaire's equation 7 (isotropic phase)
+};
+
+// Hillaire's IntegrateScatteredLuminance: sampleCount steps along the ray to
+// the ground or the top of the atmosphere (at most tMaxLimit km).
+// uniformPhase scatters isotropically (the multi-scattering pass); the
+// multi-scattering LUT is only read when withMultiScattering is set, so the
+// multi-scattering pass may pass the transmittance LUT in its place.
+ScatteringResult IntegrateScattering(AtmosphereData atmosphere, vec3 origin, vec3 direction, vec3 sunDirection,
+                                     float sampleCount, float tMaxLimit, bool uniformPhase, bool withGround,
+                                     bool withMultiScattering, sampler2D transmittanceLut,
+                                     sampler2D multiScatteringLut)
+{
+    ScatteringResult result;
+    result.luminance = vec3(0.0);
+    result.throughput = vec3(1.0);
+    result.multiScatterAs1 = vec3(0.0);
+
+    float bottom = atmosphere.radii.x;
+    float tBottom = RaySphereNearest(origin, direction, bottom);
+    float tTop = RaySphereNearest(origin, direction, atmosphere.radii.y);
+    float tMax;
+    if (tBottom < 0.0)
+    {
+        if (tTop < 0.0)
+            return result;
+        tMax = tTop;
+    }
+    else
+    {
+        tMax = tTop > 0.0 ? min(tTop, tBottom) : tBottom;
+    }
+    bool hitsGround = tBottom >= 0.0 && tMax == tBottom;
+    tMax = min(tMax, tMaxLimit);
+
+    float dt = tMax / sampleCount;
+    float cosTheta = dot(sunDirection, direction);
+    float miePhase = MiePhase(atmosphere.radii.w, cosTheta);
+    float rayleighPhase = RayleighPhase(cosTheta);
+    const float uniformPhaseValue = 1.0 / (4.0 * ATMOSPHERE_PI);
+
+    for (float i = 0.0; i < sampleCount; i += 1.0)
+    {
+        float t = (i + 0.3) * dt;
+        vec3 p = origin + t * direction;
+        float height = length(p);
+        vec3 up = p / height;
+
+        MediumSample medium = SampleMedium(atmosphere, max(height - bottom, 0.0));
+        vec3 sampleTransmittance = exp(-medium.extinction * dt);
+
+        float sunZenithCos = dot(sunDirection, up);
+        vec3 transmittanceToSun = textureLod(transmittanceLut, TransmittanceLutUv(atmosphere, height, sunZenithCos), 0.0).rgb;
+        vec3 phaseTimesScattering = uniformPhase
+            ? medium.scattering * uniformPhaseValue
+            : medium.mieScattering * miePhase + medium.rayleighScattering * rayleighPhase;
+
+        // The planet's shadow, from just above the ground
+        float tEarth = RaySphereNearest(p - up * PLANET_RADIUS_OFFSET, sunDirection, bottom);
+        float earthShadow = tEarth >= 0.0 ? 0.0 : 1.0;
+
+        vec3 multiScattered = withMultiScattering
+            ? textureLod(multiScatteringLut, MultiScatteringLutUv(atmosphere, height, sunZenithCos), 0.0).rgb
+            : vec3(0.0);
+
+        vec3 S = earthShadow * transmittanceToSun * phaseTimesScattering + multiScattered * medium.scattering;
+
+        // Energy-conserving step (Hillaire 2015): integrate over the step
+        // analytically instead of taking one point's value
+        vec3 extinction = max(medium.extinction, vec3(1e-6));
+        result.multiScatterAs1 += result.throughput * (medium.scattering - medium.scattering * sampleTransmittance) / extinction;
+        result.luminance += result.throughput * (S - S * sampleTransmittance) / extinction;
+        result.throughput *= sampleTransmittance;
+    }
+
+    // Sunlight bouncing off the ground (Lambertian, ground albedo)
+    if (withGround && hitsGround && tMax < tMaxLimit)
+    {
+        vec3 p = origin + tMax * direction;
+        float height = length(p);
+        vec3 up = p / height;
+        float sunZenithCos = dot(sunDirection, up);
+        vec3 transmittanceToSun = textureLod(transmittanceLut, TransmittanceLutUv(atmosphere, height, sunZenithCos), 0.0).rgb;
+        float NdotL = clamp(sunZenithCos, 0.0, 1.0);
+        result.luminance += transmittanceToSun * result.throughput * NdotL * atmosphere.mie.w / ATMOSPHERE_PI;
+    }
+    return result;
+}
+
+#endif // NB_ATMOSPHERE_GLSL
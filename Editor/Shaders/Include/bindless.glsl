@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+// bindless.glsl
+//
+// The bindless descriptor table (VulkanDescriptorManager::InitializeBindless),
+// bound at set 1 of the Mesh/Transparent passes on devices with descriptor
+// indexing. Slots are indices into these arrays; BINDLESS_INVALID marks "none".
+// Include before anything else: it enables GL_EXT_nonuniform_qualifier.
+//
+// Provides:
+//   set 1, binding 0 -> sampler2D `bindlessTextures[]` (partially bound)
+//   set 1, binding 1 -> BindlessMaterial `bindlessMaterials[]`
+//   SampleBindless
+//------------------------------------------------------------------------------
+#ifndef NB_BINDLESS_GLSL
+#define NB_BINDLESS_GLSL
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+const uint BINDLESS_INVALID = 0xFFFFFFFFu;
+
+layout(set = 1, binding = 0) uniform sampler2D bindlessTextures[];
+
+// Matches BindlessMaterialData (std430, 32 bytes)
+struct BindlessMaterial
+{
+    vec4 albedoColor;
+    uint albedoTexture;
+    uint normalTexture;
+    float roughness;
+    float metallic;
+};
+
+layout(set = 1, binding = 1, std430) readonly buffer BindlessMaterialTable {
+    BindlessMaterial bindlessMaterials[];
+};
+
+// Unregistered slots read as white so a missing texture doesn't go black.
+// nonuniformEXT costs nothing for push-constant slots and keeps this correct
+// for slots that vary per invocation (e.g. read from the material table).
+vec4 SampleBindless(uint slot, vec2 uv)
+{
+    if (slot == BINDLESS_INVALID)
+        return vec4(1.0);
+    return texture(bindlessTextures[nonuniformEXT(slot)], uv);
+}
+
+#endif // NB_BINDLESS_GLSL
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+// bloom.glsl
+//
+// Shared by the bloom mip-chain shaders (BloomPrefilter/BloomDownsample/
+// BloomUpsample.comp, see BloomMipChain). Set 0 is the same for all three:
+// binding 0 the level read (sampler), binding 1 the level written (storage).
+//
+// The downsample is the 13-tap filter from Jimenez, "Next Generation Post
+// Processing in Call of Duty: Advanced Warfare" (SIGGRAPH 2014): five
+// overlapping 2x2 box averages around the target texel's 4x4 source
+// footprint, weighted 0.5 for the inner box and 0.125 for each outer one.
+// With the boxes centred on texel corners a bilinear fetch (prefilter) or
+// four point loads (shared-memory tile) give the same result.
+//------------------------------------------------------------------------------
+#ifndef NB_BLOOM_GLSL
+#define NB_BLOOM_GLSL
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(set = 0, binding = 0) uniform sampler2D sourceLevel;
+layout(set = 0, binding = 1, rgba16f) uniform image2D targetLevel;
+
+layout(push_constant) uniform BloomParams
+{
+    ivec4 sizes;   // xy = source size, zw = target size
+    vec4  params;  // per shader, see each main()
+} pc;
+
+float Luma(vec3 c) { return dot(c, vec3(0.2126, 0.7152, 0.0722)); }
+
+// Boxes: a..m as laid out in the paper (row by row, outer corners a c k m,
+// inner ring d e i j, centre g)
+vec3 Downsample13(vec3 a, vec3 b, vec3 c, vec3 d, vec3 e, vec3 f, vec3 g,
+                  vec3 h, vec3 i, vec3 j, vec3 k, vec3 l, vec3 m, bool karis)
+{
+    vec3 inner = (d + e + i + j) * 0.25;
+    vec3 topLeft = (a + b + f + g) * 0.25;
+    vec3 topRight = (b + c + g + h) * 0.25;
+    vec3 bottomLeft = (f + g + k + l) * 0.25;
+    vec3 bottomRight = (g + h + l + m) * 0.25;
+
+    if (!karis)
+        return inner * 0.5 + (topLeft + topRight + bottomLeft + bottomRight) * 0.125;
+
+    // Karis average: weight each box by 1 / (1 + luma) so a single very
+    // bright texel can't become a flickering square several mips down
+    float wInner = 0.5 / (1.0 + Luma(inner));
+    float wTL = 0.125 / (1.0 + Luma(topLeft));
+    float wTR = 0.125 / (1.0 + Luma(topRight));
+    float wBL = 0.125 / (1.0 + Luma(bottomLeft));
+    float wBR = 0.125 / (1.0 + Luma(bottomRight));
+    vec3 sum = inner * wInner + topLeft * wTL + topRight * wTR + bottomLeft * wBL + bottomRight * wBR;
+    return sum / (wInner + wTL + wTR + wBL + wBR);
+}
+
+#endif // NB_BLOOM_GLSL
@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+// cdlod_patch.glsl
+//
+// CDLOD patch records and grid morphing (see TerrainQuadtree.hpp), shared by
+// the terrain (terrain_cdlod.glsl) and the water's LOD grid (Water.vert).
+// Each instance is one TerrainPatch selected on the CPU; the grid itself only
+// supplies the vertex's [0,1] position within the patch (grid_vertex.glsl).
+//
+// Provides:
+//   set 0, binding 1 -> TerrainPatch records (the renderer's instance buffer)
+//   MorphGridVertex / CdlodMorphFactor / CdlodPatchXZ
+//------------------------------------------------------------------------------
+#ifndef NB_CDLOD_PATCH_GLSL
+#define NB_CDLOD_PATCH_GLSL
+
+#include "grid_vertex.glsl"
+
+// Mirrors TerrainPatch in TerrainQuadtree.hpp (64 bytes, one instance slot)
+struct TerrainPatch
+{
+    vec4 offsetSize;  // xy = min corner (local XZ), z = edge length, w = LOD level
+    vec4 morphRange;  // x = morph start, y = morph end distance
+    vec4 lodCamera;   // xyz = camera the ranges are measured from (local)
+    vec4 heightmapWindow; // xy = uv at the terrain's min corner, z = uv span, w = edge inset (terrain only)
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer TerrainPatchBuffer {
+    TerrainPatch patches[];
+} terrainPatches;
+
+// Slides odd grid vertices onto their even neighbour as k goes 0 -> 1, which
+// turns the patch into the next-coarser level's grid
+vec2 MorphGridVertex(vec2 gridPos, float gridQuads, float k)
+{
+    vec2 fracPart = fract(gridPos * gridQuads * 0.5) * 2.0 / gridQuads;
+    return gridPos - fracPart * k;
+}
+
+// How far a point at `localPos` has morphed towards the next-coarser level
+float CdlodMorphFactor(TerrainPatch tile, vec3 localPos)
+{
+    float dist = distance(localPos, tile.lodCamera.xyz);
+    float band = max(tile.morphRange.y - tile.morphRange.x, 1e-4);
+    return clamp((dist - tile.morphRange.x) / band, 0.0, 1.0);
+}
+
+// Local XZ of a grid vertex, morphed by k
+vec2 CdlodPatchXZ(TerrainPatch tile, vec2 gridPos, float gridQuads, float k)
+{
+    return tile.offsetSize.xy + MorphGridVertex(gridPos, gridQuads, k) * tile.offsetSize.z;
+}
+
+#endif // NB_CDLOD_PATCH_GLSL
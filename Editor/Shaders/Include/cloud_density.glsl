@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+// cloud_density.glsl
+//
+// The cloud layer's density field, shared by the raymarch (CloudRaymarch.comp)
+// and the cloud shadow map bake (CloudShadow.comp) so the shadows are cast by
+// exactly the clouds on screen.
+//
+// The noise volumes may be packed (NoiseTextureDesc::format) with mip
+// chains: callers pass each sample's footprint - the world-space width it
+// stands for - and the fetches pick the mip whose texels match it, so far
+// samples read small, cache-resident levels. With the CloudShape channel
+// layout (layerBounds.z = 1) the shape fetch carries three Worley octaves
+// in GBA that erode its R.
+//
+// Provides:
+//   set 1, bindings 0-1 -> shapeSampler, detailSampler
+//   set 1, binding 2    -> CloudParamsUBO instance `params`
+//   remap, CloudNoiseLod, SampleCloudShape, SampleCloudShapeBound, SampleCloudDensity
+//------------------------------------------------------------------------------
+#ifndef NB_CLOUD_DENSITY_GLSL
+#define NB_CLOUD_DENSITY_GLSL
+
+layout(set = 1, binding = 0) uniform sampler3D shapeSampler;
+layout(set = 1, binding = 1) uniform sampler3D detailSampler;
+
+// Must match CloudParamsData (CloudSystem.hpp)
+layout(std140, set = 1, binding = 2) uniform CloudParamsUBO {
+    vec4 layerBounds; // x=minY, y=maxY, z=1: shape noise in the CloudShape layout
+    vec4 wind;        // xyz = wind direction*speed, w = totalTime
+    vec4 shape;       // x=shapeScale, y=detailScale, z=detailStrength, w=coverage
+    vec4 density;     // x=densityMultiplier, y=extinctionCoefficient, z=hgAnisotropy(g), w=stepCount
+    vec4 sunTint;     // rgb = the atmosphere's transmittance to the sun at the layer (white without one)
+    vec4 shadowWindow; // the cloud shadow map's window (cloud_shadow.glsl); z = 0 without one
+} params;
+
+float remap(float v, float lo, float hi, float newLo, float newHi)
+{
+    return newLo + clamp((v - lo) / max(hi - lo, 1e-6), 0.0, 1.0) * (newHi - newLo);
+}
+
+// The mip of `volume` (sampled at world * scale) whose texels are about
+// footprint world units across
+float CloudNoiseLod(sampler3D volume, float scale, float footprint)
+{
+    float texels = footprint * scale * float(textureSize(volume, 0).x);
+    return max(log2(max(texels, 1e-6)), 0.0);
+}
+
+float SampleCloudShape(vec3 scrolledPos, float footprint)
+{
+    float scale = params.shape.x;
+    vec4 shape = textureLod(shapeSampler, scrolledPos * scale, CloudNoiseLod(shapeSampler, scale, footprint));
+    if (params.layerBounds.z < 0.5)
+        return shape.r;
+
+    // The packed octaves' FBM lowers the floor R is remapped from
+    float worleyFbm = dot(shape.gba, vec3(0.625, 0.25, 0.125));
+    return remap(shape.r, worleyFbm - 1.0, 1.0, 0.0, 1.0);
+}
+
+// Shape-only density bound (detail erosion and the height fade only lower
+// it): 0 means no cloud here, whatever SampleCloudDensity would return
+float SampleCloudShapeBound(vec3 worldPos, vec3 windOffset, float footprint)
+{
+    float shapeVal = SampleCloudShape(worldPos + windOffset, footprint);
+    return clamp(shapeVal + (params.shape.w - 0.5) * 1.5, 0.0, 1.0);
+}
+
+float SampleCloudDensity(vec3 worldPos, vec3 windOffset, float footprint)
+{
+    vec3 scrolledPos = worldPos + windOffset;
+
+    float shapeVal = SampleCloudShape(scrolledPos, footprint);
+    float coverage = params.shape.w;
+
+    // Cheap upper-bound check before paying for the detail sample + lighting
+    // math: detail erosion can only SUBTRACT from density, never add to it,
+    // so if the shape value alone (the zero-erosion best case) already can't
+    // clear the coverage threshold, this step contributes nothing no matter
+    // what detail/height-fade would have done. This matters most for sparse
+    // coverage, where the loop's transmittance early-out in main() rarely
+    // triggers (rays never accumulate enough density to go opaque), so most
+    // steps were paying full price for "obviously empty" samples.
+    float maxPossibleDensity = clamp(shapeVal + (coverage - 0.5) * 1.5, 0.0, 1.0);
+    if (maxPossibleDensity <= 0.001)
+        return 0.0;
+
+    float detailScale = params.shape.y;
+    float detailVal = textureLod(detailSampler, scrolledPos * detailScale,
+                                 CloudNoiseLod(detailSampler, detailScale, footprint)).r;
+    float eroded = shapeVal - detailVal * params.shape.z;
+    float density = clamp(eroded + (coverage - 0.5) * 1.5, 0.0, 1.0);
+
+    float layerMinY = params.layerBounds.x;
+    float layerMaxY = params.layerBounds.y;
+    float heightFrac = clamp((worldPos.y - layerMinY) / max(layerMaxY - layerMinY, 1e-4), 0.0, 1.0);
+    float heightFade = smoothstep(0.0, 0.15, heightFrac) * smoothstep(0.0, 0.15, 1.0 - heightFrac);
+
+    return density * heightFade;
+}
+
+#endif // NB_CLOUD_DENSITY_GLSL
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+// cloud_shadow.glsl
+//
+// The cloud shadow map CloudShadow.comp bakes each frame (see CloudSystem.hpp):
+// a square window of the top of the cloud layer around the camera, each
+// texel looking down the light through the slab. Texels hold a Beer shadow
+// map - where the cloud starts along the light ray, its mean extinction and
+// its total optical depth - so any point along the ray, inside the clouds or
+// on the ground below, reads its transmittance to the light in one fetch.
+//
+// The window is a vec4: xy = min corner (world xz), z = side (0 = no cloud
+// shadows), w = the top of the layer (world y). The raymarch passes
+// params.shadowWindow, the lit passes frame.cloudShadow.
+//
+// Provides:
+//   set 0, binding 5 -> cloudShadowMap
+//   CLOUD_SHADOW_MIN_ELEVATION, CloudShadowRay, CloudShadowTransmittance
+//------------------------------------------------------------------------------
+#ifndef NB_CLOUD_SHADOW_GLSL
+#define NB_CLOUD_SHADOW_GLSL
+
+layout(set = 0, binding = 5) uniform sampler2D cloudShadowMap;
+
+// Lower lights are treated as this high, so a low sun's shadow rays stay
+// inside a bounded stretch of the window
+const float CLOUD_SHADOW_MIN_ELEVATION = 0.1;
+
+// The light ray through worldPos: where it crosses the top of the layer
+// (xz) and how far below that crossing worldPos sits along it
+vec2 CloudShadowRay(vec3 worldPos, vec3 towardLight, vec4 window, out float depth)
+{
+    vec3 L = normalize(vec3(towardLight.x, max(towardLight.y, CLOUD_SHADOW_MIN_ELEVATION), towardLight.z));
+    depth = (window.w - worldPos.y) / L.y;
+    return worldPos.xz + L.xz * depth;
+}
+
+// Transmittance from worldPos up to the light through the clouds; 1
+// outside the window, fading out over its outer tenth
+float CloudShadowTransmittance(vec3 worldPos, vec3 towardLight, vec4 window)
+{
+    if (window.z <= 0.0)
+        return 1.0;
+
+    float depth;
+    vec2 topXZ = CloudShadowRay(worldPos, towardLight, window, depth);
+    vec2 uv = (topXZ - window.xy) / window.z;
+    vec2 edge = min(uv, 1.0 - uv);
+    float coverage = smoothstep(0.0, 0.1, min(edge.x, edge.y));
+    if (coverage <= 0.0 || depth <= 0.0)
+        return 1.0;
+
+    // r = front (distance below the top), g = mean extinction, b = total optical depth
+    vec3 beer = textureLod(cloudShadowMap, uv, 0.0).rgb;
+    float opticalDepth = min(max(depth - beer.r, 0.0) * beer.g, beer.b);
+    return mix(1.0, exp(-opticalDepth), coverage);
+}
+
+#endif // NB_CLOUD_SHADOW_GLSL
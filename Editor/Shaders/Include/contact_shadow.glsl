@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// contact_shadow.glsl
+//
+// Screen-space contact shadows (see ContactShadow.hpp): one invocation per
+// render pixel, after the scene pass. The pixel's view-space position is
+// rebuilt from the depth buffer and marched pc.light.w world units toward
+// the light in pc.params.w steps; a step whose depth sample lies in front
+// of it by less than the thickness is blocked. The scene color is then
+// scaled down by the share of its light that came straight from the light
+// (N.L against the ambient, with the normal rebuilt from depth), so the
+// cascades' shadows aren't darkened twice over where they already removed
+// the light... mostly - the share is an estimate. The including shader
+// declares the scene depth at set 2 binding 0 and defines
+// LoadSceneDepth(ivec2) (reverse-Z) before including this file.
+//
+// Descriptor sets:
+//   set 0 - FrameUBO (this frame's camera)
+//   set 1 - the scene color, read and written in place
+//   set 2 - the scene depth (the includer's)
+//------------------------------------------------------------------------------
+#ifndef NB_CONTACT_SHADOW_GLSL
+#define NB_CONTACT_SHADOW_GLSL
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(set = 0, binding = 0) uniform FrameUBO {
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+    mat4 invView;
+    mat4 invProj;
+} frame;
+
+// Must match RenderPassManager::SCENE_COLOR_FORMAT
+layout(set = 1, binding = 0, r11f_g11f_b10f) uniform image2D sceneColor;
+
+// Must match ContactShadowData in ContactShadow.hpp
+layout(push_constant) uniform ContactShadowParams
+{
+    vec4  light;     // xyz = toward the light (view space), w = march length (world units)
+    vec4  params;    // x = thickness, y = strength, z = max distance, w = steps
+    vec4  direct;    // rgb = the light's colour times intensity
+    vec4  ambient;   // rgb = the scene's ambient light
+    ivec4 extents;   // xy = render extent
+} pc;
+
+// Depth differences below this share of the distance are the surface itself
+const float SELF_BIAS = 0.004;
+
+float Luma(vec3 c)
+{
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+float InterleavedGradientNoise(vec2 screenPos)
+{
+    const vec3 magic = vec3(0.06711056, 0.00583715, 52.9829189);
+    return fract(magic.z * fract(dot(screenPos, magic.xy)));
+}
+
+vec3 ViewPosition(ivec2 texel, float depth)
+{
+    vec2 ndc = (vec2(texel) + 0.5) / vec2(pc.extents.xy) * 2.0 - 1.0;
+    vec4 p = frame.invProj * vec4(ndc, depth, 1.0);
+    return p.xyz / p.w;
+}
+
+vec3 LoadViewPosition(ivec2 texel)
+{
+    texel = clamp(texel, ivec2(0), pc.extents.xy - 1);
+    return ViewPosition(texel, LoadSceneDepth(texel));
+}
+
+// From the neighbour on each axis whose depth is closer to this pixel's,
+// so silhouettes don't bend the normal
+vec3 ViewNormal(ivec2 texel, vec3 position)
+{
+    vec3 right = LoadViewPosition(texel + ivec2(1, 0)) - position;
+    vec3 left = position - LoadViewPosition(texel - ivec2(1, 0));
+    vec3 down = LoadViewPosition(texel + ivec2(0, 1)) - position;
+    vec3 up = position - LoadViewPosition(texel - ivec2(0, 1));
+    vec3 dx = abs(right.z) < abs(left.z) ? right : left;
+    vec3 dy = abs(down.z) < abs(up.z) ? down : up;
+    vec3 normal = normalize(cross(dy, dx));
+    return dot(normal, position) > 0.0 ? -normal : normal;   // facing the camera
+}
+
+// 1 where something within the march blocks the light, fading with the
+// distance along it
+float Occlusion(vec3 position, ivec2 pixel)
+{
+    float steps = pc.params.w;
+    float stepLength = pc.light.w / steps;
+    float offset = InterleavedGradientNoise(vec2(pixel));
+
+    for (float i = 0.0; i < steps; i += 1.0)
+    {
+        vec3 ray = position + pc.light.xyz * (stepLength * (i + offset));
+        vec4 clip = frame.proj * vec4(ray, 1.0);
+        if (clip.w <= 0.0)
+            break;
+        ivec2 texel = ivec2((clip.xy / clip.w * 0.5 + 0.5) * vec2(pc.extents.xy));
+        if (any(lessThan(texel, ivec2(0))) || any(greaterThanEqual(texel, pc.extents.xy)))
+            break;
+
+        float depth = LoadSceneDepth(texel);
+        if (depth <= 0.0)
+            continue;   // sky
+
+        // The camera looks down -z: a larger z is nearer
+        float inFront = ViewPosition(texel, depth).z - ray.z;
+        if (inFront > SELF_BIAS * -ray.z && inFront < pc.params.x)
+            return 1.0 - i / steps;
+    }
+    return 0.0;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, pc.extents.xy)))
+        return;
+
+    float depth = LoadSceneDepth(pixel);
+    if (depth <= 0.0)
+        return;   // sky
+
+    vec3 position = ViewPosition(pixel, depth);
+    float maxDistance = pc.params.z;
+    float fade = 1.0 - smoothstep(0.75 * maxDistance, maxDistance, length(position));
+    if (fade <= 0.0)
+        return;
+
+    // Facing away, the light never reached it
+    float NdotL = dot(ViewNormal(pixel, position), pc.light.xyz);
+    if (NdotL <= 0.0)
+        return;
+
+    float occlusion = Occlusion(position, pixel);
+    if (occlusion <= 0.0)
+        return;
+
+    float direct = Luma(pc.direct.rgb) * NdotL;
+    float share = direct / (direct + Luma(pc.ambient.rgb) + 1e-4);
+    vec3 color = imageLoad(sceneColor, pixel).rgb;
+    imageStore(sceneColor, pixel, vec4(color * (1.0 - occlusion * pc.params.y * share * fade), 1.0));
+}
+
+#endif // NB_CONTACT_SHADOW_GLSL
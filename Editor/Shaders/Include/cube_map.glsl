@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+// cube_map.glsl
+//
+// Cube face addressing for the passes that write a cube as a 2D array, one
+// layer per face (EnvironmentCapture.comp, EnvironmentFilter.comp). Faces
+// follow Vulkan's order, +X, -X, +Y, -Y, +Z, -Z, with v running down, so a
+// samplerCube over the same image finds what they wrote.
+//
+// A straight port of EnvironmentProbe::FaceDirection - keep the two in sync.
+//
+// Provides:
+//   CubeFaceDirection, CubeTexelDirection
+//------------------------------------------------------------------------------
+#ifndef NB_CUBE_MAP_GLSL
+#define NB_CUBE_MAP_GLSL
+
+// Unit direction through uv ([0,1]^2, v down) of a face
+vec3 CubeFaceDirection(int face, vec2 uv)
+{
+    vec2 st = uv * 2.0 - 1.0;
+    vec3 direction;
+    if (face == 0)      direction = vec3(1.0, -st.y, -st.x);
+    else if (face == 1) direction = vec3(-1.0, -st.y, st.x);
+    else if (face == 2) direction = vec3(st.x, 1.0, st.y);
+    else if (face == 3) direction = vec3(st.x, -1.0, -st.y);
+    else if (face == 4) direction = vec3(st.x, -st.y, 1.0);
+    else                direction = vec3(-st.x, -st.y, -1.0);
+    return normalize(direction);
+}
+
+// Through the centre of texel `texel` of a face `size` texels across
+vec3 CubeTexelDirection(ivec3 texel, int size)
+{
+    return CubeFaceDirection(texel.z, (vec2(texel.xy) + 0.5) / float(size));
+}
+
+#endif // NB_CUBE_MAP_GLSL
@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+// environment_probe.glsl
+//
+// The cached environment cube EnvironmentProbeCache captures around the
+// camera and prefilters (see EnvironmentProbe.hpp): the sky, the sun, the
+// clouds and a stand-in for the far terrain, with mip m blurred for GGX
+// roughness m / (ENVIRONMENT_PROBE_MIPS - 1). One trilinear fetch replaces
+// evaluating the sky per pixel. Black until the first capture, and without
+// compute.
+//
+// Provides:
+//   set 0, binding 7 -> environmentProbe
+//   ENVIRONMENT_PROBE_MIPS, EnvironmentRadiance, EnvironmentSpecular
+//------------------------------------------------------------------------------
+#ifndef NB_ENVIRONMENT_PROBE_GLSL
+#define NB_ENVIRONMENT_PROBE_GLSL
+
+// Mirrors EnvironmentProbe::MIP_COUNT
+const float ENVIRONMENT_PROBE_MIPS = 5.0;
+
+layout(set = 0, binding = 7) uniform samplerCube environmentProbe;
+
+// Light arriving from the world-space unit direction, blurred for roughness
+vec3 EnvironmentRadiance(vec3 direction, float roughness)
+{
+    float lod = clamp(roughness, 0.0, 1.0) * (ENVIRONMENT_PROBE_MIPS - 1.0);
+    return textureLod(environmentProbe, direction, lod).rgb;
+}
+
+// The environment's specular reflection off a surface with normal N seen
+// along V (toward the eye): the prefiltered radiance around the mirror
+// direction, weighted by Schlick's Fresnel for reflectance f0 (rougher
+// surfaces lose some of the grazing boost)
+vec3 EnvironmentSpecular(vec3 N, vec3 V, float roughness, float f0)
+{
+    float NdotV = clamp(dot(N, V), 0.0, 1.0);
+    float fresnel = f0 + (max(1.0 - roughness, f0) - f0) * pow(1.0 - NdotV, 5.0);
+    return EnvironmentRadiance(reflect(-V, N), roughness) * fresnel;
+}
+
+#endif // NB_ENVIRONMENT_PROBE_GLSL
@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+// firefly_grid.glsl
+//
+// Uniform neighbour grid over the swarm bounds, rebuilt every frame by
+// FireflyGrid.comp (count -> scan -> scatter) and read by FireflyUpdate.comp.
+// Cells are at least perceptionRadius wide, so every neighbour of an agent
+// lies in the 3x3x3 block of cells around its own. Agents outside the
+// bounds clamp into the border cells.
+//
+//   cellStart[c]      first sorted index of cell c (cellStart[cellCount] = N);
+//                     holds per-cell counts until the scan pass
+//   agentCell[i]      x = cell of agent i, y = its rank within that cell
+//   sortedAgents[2k]  position.xyz / velocity.xyz of sorted agent k
+//------------------------------------------------------------------------------
+#ifndef NB_FIREFLY_GRID_GLSL
+#define NB_FIREFLY_GRID_GLSL
+
+layout(set = 2, binding = 0, std430) buffer CellStartBuffer
+{
+    uint cellStart[];
+};
+
+layout(set = 2, binding = 1, std430) buffer AgentCellBuffer
+{
+    uvec2 agentCell[];
+};
+
+layout(set = 2, binding = 2, std430) buffer SortedAgentBuffer
+{
+    vec4 sortedAgents[];
+};
+
+layout(push_constant) uniform GridParams
+{
+    vec4  origin;  // xyz = grid minimum corner, w = 1 / cell size
+    uvec4 dims;    // xyz = cells per axis, w = pass (FireflyGrid.comp only)
+} grid;
+
+ivec3 GridCoord(vec3 position)
+{
+    ivec3 coord = ivec3(floor((position - grid.origin.xyz) * grid.origin.w));
+    return clamp(coord, ivec3(0), ivec3(grid.dims.xyz) - 1);
+}
+
+uint GridCellIndex(ivec3 coord)
+{
+    return (uint(coord.z) * grid.dims.y + uint(coord.y)) * grid.dims.x + uint(coord.x);
+}
+
+uint GridCellCount()
+{
+    return grid.dims.x * grid.dims.y * grid.dims.z;
+}
+
+#endif
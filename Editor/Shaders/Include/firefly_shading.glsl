@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+// firefly_shading.glsl
+//
+// The body of Firefly.frag, shared with FireflyOit.frag. Under
+// NB_OIT_ACCUMULATE (oit.glsl) the glow is coverage-weighted like any other
+// transparent instead of summed, so overlapping fireflies average towards
+// the nearer ones rather than adding up. Under NB_FIREFLY_POINT (the
+// FireflyPoint pair) the glow spans the point sprite instead of a quad.
+//------------------------------------------------------------------------------
+#ifndef NB_FIREFLY_SHADING_GLSL
+#define NB_FIREFLY_SHADING_GLSL
+
+#ifndef NB_FIREFLY_POINT
+layout(location = 0) in vec2 inUV;
+#endif
+layout(location = 1) in vec4 inColor;
+
+#include "oit.glsl"
+
+void main()
+{
+#ifdef NB_FIREFLY_POINT
+    vec2 p = gl_PointCoord * 2.0 - 1.0;
+#else
+    vec2 p = inUV * 2.0 - 1.0;
+#endif
+    float dist = length(p);
+
+    if (dist > 1.0) discard;
+
+    float glow = clamp(1.0 - dist, 0.0, 1.0);
+    glow *= glow;
+    glow *= glow;
+
+    vec3 color = inColor.rgb * (0.25 + 2.5 * glow);
+    float alpha = glow;
+
+    WriteColor(vec4(color, alpha));
+}
+
+#endif // NB_FIREFLY_SHADING_GLSL
@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+// firefly_update.glsl
+//
+// Boids flocking step shared by the two firefly neighbour searches
+// (FireflyUpdate.comp walks the grid, FireflyUpdateTiled.comp loops over
+// all agents in shared-memory tiles). Ported from a Forge-engine demo
+// (.claude/firefly code/AgentUpdate.comp.fsl): separation/alignment/cohesion
+// + wander force + sinusoidal blink pulse + soft box-bounds bounce. The
+// wind drift on top is this engine's (Wind.hpp).
+//
+// Agent buffer is a flat vec4 array (4 per agent) rather than a GLSL struct,
+// matching the original's approach and avoiding std430 vec3-padding pitfalls:
+//   data[base+0] = position.xyz, brightness
+//   data[base+1] = velocity.xyz, scale
+//   data[base+2] = blinkPhase, blinkSpeed, minBrightness, maxBrightness
+//   data[base+3] = color.xyz, personality
+//
+// Neighbours are read from the position/velocity copy in the grid's
+// sortedAgents buffer, never from the agent buffer this pass writes. The
+// including shader feeds each one to AccumulateNeighbor, then calls
+// IntegrateAgent with the sums.
+//------------------------------------------------------------------------------
+#ifndef NB_FIREFLY_UPDATE_GLSL
+#define NB_FIREFLY_UPDATE_GLSL
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(set = 0, binding = 0, std430) buffer AgentBuffer
+{
+    vec4 data[];
+} agentBuffer;
+
+layout(set = 1, binding = 0, std140) uniform FireflyParamsUBO
+{
+    vec4 params1;      // x=separation, y=alignment, z=cohesion, w=deltaTime
+    vec4 params2;      // x=perceptionRadius, y=separationRadius, z=minSpeed, w=maxSpeed
+    vec4 params3;      // x=totalTime, y=wanderStrength, z=wanderForceScale, w=wind force x
+    vec4 params4;      // x=globalBlinkSpeedScale, y=globalBlinkAmplitude, z=agentCount, w=wind force z
+    vec4 boundsCenter; // xyz = swarm center
+    vec4 boundsExtent; // xyz = swarm half-extents
+} params;
+
+#include "firefly_grid.glsl"
+
+struct NeighborSums
+{
+    vec3 separationForce;
+    vec3 alignmentSum;
+    vec3 cohesionSum;
+    int separationCount;
+    int perceptionCount;
+};
+
+NeighborSums EmptyNeighborSums()
+{
+    NeighborSums sums;
+    sums.separationForce = vec3(0.0);
+    sums.alignmentSum = vec3(0.0);
+    sums.cohesionSum = vec3(0.0);
+    sums.separationCount = 0;
+    sums.perceptionCount = 0;
+    return sums;
+}
+
+void AccumulateNeighbor(inout NeighborSums sums, vec3 position, vec3 otherPosition, vec3 otherVelocity)
+{
+    float perceptionRadius = params.params2.x;
+    float separationRadius = params.params2.y;
+
+    vec3 displacement = otherPosition - position;
+    float dist = length(displacement);
+
+    if (dist < separationRadius && dist > 0.0001)
+    {
+        vec3 away = -displacement / dist;
+        float falloff = 1.0 - clamp(dist / separationRadius, 0.0, 1.0);
+        sums.separationForce += away * (0.5 + falloff);
+        sums.separationCount++;
+    }
+
+    if (dist < perceptionRadius)
+    {
+        sums.alignmentSum += otherVelocity;
+        sums.cohesionSum += otherPosition;
+        sums.perceptionCount++;
+    }
+}
+
+void IntegrateAgent(uint agentIndex, NeighborSums sums)
+{
+    uint baseIndex = agentIndex * 4u;
+
+    vec4 posAndBrightness = agentBuffer.data[baseIndex + 0u];
+    vec4 velAndScale       = agentBuffer.data[baseIndex + 1u];
+    vec4 blinkData         = agentBuffer.data[baseIndex + 2u];
+
+    vec3 position   = posAndBrightness.xyz;
+    vec3 velocity   = velAndScale.xyz;
+    float scale     = velAndScale.w;
+
+    float blinkPhase    = blinkData.x;
+    float blinkSpeed    = blinkData.y;
+    float minBrightness = blinkData.z;
+    float maxBrightness = blinkData.w;
+
+    float separationScale = params.params1.x;
+    float alignmentScale  = params.params1.y;
+    float cohesionScale   = params.params1.z;
+    float dt              = params.params1.w;
+
+    float minSpeed         = params.params2.z;
+    float maxSpeed         = params.params2.w;
+
+    float time             = params.params3.x;
+    float wanderStrength   = params.params3.y;
+    float wanderForceScale = params.params3.z;
+
+    float globalBlinkSpeedScale = params.params4.x;
+    float globalBlinkAmplitude  = params.params4.y;
+
+    float speed = length(velocity);
+    vec3 forward = speed > 0.0001 ? (velocity / speed) : vec3(0.0, 0.0, 1.0);
+
+    float t = time * 0.8 + float(agentIndex) * 19.37;
+    vec3 randomDir = normalize(vec3(
+        sin(t * 1.11),
+        cos(t * 0.93 + 2.1),
+        sin(t * 1.27 + 0.7)));
+
+    vec3 wanderDir = normalize(forward + randomDir * wanderStrength);
+    vec3 wanderForce = wanderDir * wanderForceScale;
+
+    vec3 separationForce = vec3(0.0);
+    if (sums.separationCount > 0)
+    {
+        separationForce = (sums.separationForce / float(sums.separationCount)) * separationScale;
+    }
+
+    vec3 alignmentForce = vec3(0.0);
+    vec3 cohesionForce = vec3(0.0);
+
+    if (sums.perceptionCount > 0)
+    {
+        vec3 avgNeighborVelocity = sums.alignmentSum / float(sums.perceptionCount);
+        float avgNeighborSpeed = length(avgNeighborVelocity);
+
+        if (avgNeighborSpeed > 0.0001)
+        {
+            vec3 desiredAlignment = normalize(avgNeighborVelocity) * maxSpeed;
+            alignmentForce = (desiredAlignment - velocity) * alignmentScale;
+        }
+
+        vec3 center = sums.cohesionSum / float(sums.perceptionCount);
+        vec3 toCenter = center - position;
+        float centerDist = length(toCenter);
+
+        if (centerDist > 0.0001)
+        {
+            vec3 desiredCohesion = normalize(toCenter) * maxSpeed;
+            cohesionForce = (desiredCohesion - velocity) * cohesionScale;
+        }
+    }
+
+    // The wind at the swarm's centre (FireflySystem::SetWind), so the swarm
+    // drifts with the gusts that cross the grass
+    vec3 windForce = vec3(params.params3.w, 0.0, params.params4.w);
+
+    velocity += (wanderForce + separationForce + alignmentForce + cohesionForce + windForce) * dt;
+
+    speed = length(velocity);
+    if (speed > 0.0001)
+    {
+        vec3 dir = velocity / speed;
+        if (speed < minSpeed)      velocity = dir * minSpeed;
+        else if (speed > maxSpeed) velocity = dir * maxSpeed;
+    }
+    else
+    {
+        velocity = forward * minSpeed;
+    }
+
+    position += velocity * dt;
+
+    // Soft bounce against the swarm's box bounds (center + half-extents)
+    vec3 boundsMin = params.boundsCenter.xyz - params.boundsExtent.xyz;
+    vec3 boundsMax = params.boundsCenter.xyz + params.boundsExtent.xyz;
+
+    if (position.x > boundsMax.x) { position.x = boundsMax.x; velocity.x *= -1.0; }
+    if (position.x < boundsMin.x) { position.x = boundsMin.x; velocity.x *= -1.0; }
+    if (position.y > boundsMax.y) { position.y = boundsMax.y; velocity.y *= -1.0; }
+    if (position.y < boundsMin.y) { position.y = boundsMin.y; velocity.y *= -1.0; }
+    if (position.z > boundsMax.z) { position.z = boundsMax.z; velocity.z *= -1.0; }
+    if (position.z < boundsMin.z) { position.z = boundsMin.z; velocity.z *= -1.0; }
+
+    float pulseTime = time * blinkSpeed * globalBlinkSpeedScale + blinkPhase;
+    float pulse01 = 0.5 + 0.5 * sin(pulseTime);
+    float brightness = mix(minBrightness, maxBrightness, pulse01) * globalBlinkAmplitude;
+    brightness = clamp(brightness, 0.0, 1.0);
+
+    agentBuffer.data[baseIndex + 0u] = vec4(position, brightness);
+    agentBuffer.data[baseIndex + 1u] = vec4(velocity, scale);
+    // blinkData (index 2) and color/personality (index 3) are unchanged — left as-is
+}
+
+#endif
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+// grass_field.glsl
+//
+// The grass density field and blade colours, shared by the blades and their
+// far field: GrassGenerate.comp keeps a candidate where Fbm2D exceeds the
+// density threshold, Grass.frag shades the blades between the root and tip
+// colours, and Terrain.frag tints the ground with them past the blades'
+// distance LOD (GrassDesc::farField). The noise is a straight port of
+// GrassScatter.hpp's value noise. The packed blade instance (16 bytes) is
+// GrassScatter.hpp's GrassInstance: GrassGenerate.comp packs it, Grass.vert
+// unpacks it.
+//
+// Provides:
+//   Hash2D, SmoothNoise2D, Fbm2D
+//   GRASS_ROOT_COLOR, GRASS_TIP_COLOR
+//   GrassBlade, PackBlade, UnpackBlade
+//------------------------------------------------------------------------------
+#ifndef NB_GRASS_FIELD_GLSL
+#define NB_GRASS_FIELD_GLSL
+
+const vec3 GRASS_ROOT_COLOR = vec3(0.08, 0.22, 0.05);
+const vec3 GRASS_TIP_COLOR  = vec3(0.46, 0.62, 0.20);
+
+float Hash2D(int x, int y, uint seed)
+{
+    uint h = uint(x) * 374761393u + uint(y) * 668265263u + seed * 2147483647u;
+    h = (h ^ (h >> 13u)) * 1274126177u;
+    h ^= (h >> 16u);
+    return float(h & 0xFFFFFFu) / float(0xFFFFFFu);
+}
+
+float SmoothNoise2D(vec2 p, uint seed)
+{
+    ivec2 i = ivec2(floor(p));
+    vec2 t = p - vec2(i);
+    vec2 s = t * t * (3.0 - 2.0 * t);
+
+    float n00 = Hash2D(i.x, i.y, seed);
+    float n10 = Hash2D(i.x + 1, i.y, seed);
+    float n01 = Hash2D(i.x, i.y + 1, seed);
+    float n11 = Hash2D(i.x + 1, i.y + 1, seed);
+
+    float nx0 = n00 + s.x * (n10 - n00);
+    float nx1 = n01 + s.x * (n11 - n01);
+    return nx0 + s.y * (nx1 - nx0);
+}
+
+float Fbm2D(vec2 p, uint seed, uint octaves)
+{
+    float value = 0.0;
+    float amplitude = 0.5;
+    float frequency = 1.0;
+    float maxValue = 0.0;
+    for (uint i = 0u; i < octaves; ++i)
+    {
+        value += SmoothNoise2D(p * frequency, seed + i * 101u) * amplitude;
+        maxValue += amplitude;
+        amplitude *= 0.5;
+        frequency *= 2.0;
+    }
+    return maxValue > 0.0 ? value / maxValue : 0.0;
+}
+
+// ---- Packed blade instance ---------------------------------------------------
+//   x = world x as 24-bit unorm across the terrain square | rotation, 8 bits of a turn
+//   y = world z as 24-bit unorm                            | tint, 8-bit unorm over 0.5..1.5
+//   z = scale as a half float | wind phase, 8 bits of a turn | unused
+//   w = patch index
+
+struct GrassBlade
+{
+    vec2  worldXZ;
+    float rotY;
+    float scale;
+    float tint;
+    float windPhase;
+    uint  patchIndex;
+};
+
+const float GRASS_TURN = 6.2831853;
+
+uint QuantizeTurn(float radians)
+{
+    return uint(int(floor(radians / GRASS_TURN * 256.0 + 0.5))) & 0xFFu;
+}
+
+// terrainMin = min corner of the terrain square (world xz), terrainSize = its side
+uvec4 PackBlade(GrassBlade blade, vec2 terrainMin, float terrainSize)
+{
+    uvec2 xz = uvec2(clamp((blade.worldXZ - terrainMin) / terrainSize, 0.0, 1.0) * 16777215.0 + 0.5);
+    uint tint = uint(clamp(blade.tint - 0.5, 0.0, 1.0) * 255.0 + 0.5);
+    return uvec4(
+        xz.x | (QuantizeTurn(blade.rotY) << 24),
+        xz.y | (tint << 24),
+        (packHalf2x16(vec2(blade.scale, 0.0)) & 0xFFFFu) | (QuantizeTurn(blade.windPhase) << 16),
+        blade.patchIndex);
+}
+
+GrassBlade UnpackBlade(uvec4 instance, vec2 terrainMin, float terrainSize)
+{
+    GrassBlade blade;
+    blade.worldXZ = terrainMin + vec2(instance.xy & 0xFFFFFFu) / 16777215.0 * terrainSize;
+    blade.rotY = float(instance.x >> 24) * (GRASS_TURN / 256.0);
+    blade.tint = 0.5 + float(instance.y >> 24) / 255.0;
+    blade.scale = unpackHalf2x16(instance.z).x;
+    blade.windPhase = float((instance.z >> 16) & 0xFFu) * (GRASS_TURN / 256.0);
+    blade.patchIndex = instance.w;
+    return blade;
+}
+
+#endif // NB_GRASS_FIELD_GLSL
@@ -0,0 +1,23 @@
+//------------------------------------------------------------------------------
+// grid_vertex.glsl
+//
+// Regular grids drawn without a vertex buffer (see GridMesh.hpp). A grid of
+// `quads` x `quads` cells numbers its (quads + 1)^2 vertices row by row; the
+// draw's index buffer only says which vertices make each triangle, and the
+// vertex's place on the grid comes back from gl_VertexIndex.
+//
+// Provides:
+//   GridVertexUV - the vertex's [0,1]^2 position across the grid
+//                  (GridMesh::GetVertexUV is the CPU twin)
+//------------------------------------------------------------------------------
+#ifndef NB_GRID_VERTEX_GLSL
+#define NB_GRID_VERTEX_GLSL
+
+vec2 GridVertexUV(uint quads)
+{
+    uint resolution = quads + 1u;
+    uint index = uint(gl_VertexIndex);
+    return vec2(float(index % resolution), float(index / resolution)) / float(quads);
+}
+
+#endif
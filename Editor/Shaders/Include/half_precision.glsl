@@ -0,0 +1,32 @@
+//------------------------------------------------------------------------------
+// half_precision.glsl
+//
+// Precision-agnostic types for shading math. The fp16 build of a shader
+// (compiled again with NB_HALF_PRECISION, loaded as <name>.frag.fp16.spv for
+// ShaderFeature::HalfPrecision) gets float16 types; the normal build gets
+// plain floats, so the same source serves both.
+//
+// Use mfloat/mvec* for colours, lighting terms and weights - values with a
+// small range that tolerate ~3 significant digits. Keep positions, depths,
+// UVs and anything summed over many terms in float. fp16 tops out at 65504:
+// clamp HDR values before squaring them.
+//
+// Include it before any declaration: the fp16 build enables an extension.
+//------------------------------------------------------------------------------
+#ifndef NB_HALF_PRECISION_GLSL
+#define NB_HALF_PRECISION_GLSL
+
+#ifdef NB_HALF_PRECISION
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+#define mfloat float16_t
+#define mvec2  f16vec2
+#define mvec3  f16vec3
+#define mvec4  f16vec4
+#else
+#define mfloat float
+#define mvec2  vec2
+#define mvec3  vec3
+#define mvec4  vec4
+#endif
+
+#endif // NB_HALF_PRECISION_GLSL
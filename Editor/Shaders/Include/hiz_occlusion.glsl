@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+// hiz_occlusion.glsl
+//
+// Hi-Z occlusion test against OcclusionCuller's depth pyramid, shared by the
+// cull shaders (MeshOcclusion.comp, MeshletCull.comp, GrassCull.comp). The
+// pyramid stores the FARTHEST depth per texel (reverse-Z: min), built from
+// the previous frame.
+//
+// Provides:
+//   set 1, binding 0 -> sampler2D `hizPyramid` (R32F, full mip chain)
+//   HiZOccluded
+//------------------------------------------------------------------------------
+#ifndef NB_HIZ_OCCLUSION_GLSL
+#define NB_HIZ_OCCLUSION_GLSL
+
+layout(set = 1, binding = 0) uniform sampler2D hizPyramid;
+
+// True if the world AABB is entirely behind the depth stored in the pyramid.
+// viewProj is the matrix the pyramid was built with; params is
+// (mip0 width, mip0 height, mip count, enabled). Anything straddling the
+// camera plane or the screen edge is treated as visible.
+bool HiZOccluded(vec3 center, vec3 extents, mat4 viewProj, vec4 params)
+{
+    if (params.w < 0.5)
+        return false;
+
+    vec2 uvMin = vec2(1.0);
+    vec2 uvMax = vec2(0.0);
+    float nearestDepth = 0.0;
+    for (int i = 0; i < 8; ++i)
+    {
+        vec3 corner = center + extents * vec3(
+            (i & 1) != 0 ? 1.0 : -1.0,
+            (i & 2) != 0 ? 1.0 : -1.0,
+            (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = viewProj * vec4(corner, 1.0);
+        if (clip.w <= 1e-4)
+            return false;
+
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        uvMin = min(uvMin, uv);
+        uvMax = max(uvMax, uv);
+        nearestDepth = max(nearestDepth, ndc.z);  // reverse-Z: larger is closer
+    }
+
+    if (any(lessThan(uvMin, vec2(0.0))) || any(greaterThan(uvMax, vec2(1.0))))
+        return false;
+
+    // Smallest mip where the rect spans at most two texels per axis
+    vec2 sizeTexels = (uvMax - uvMin) * params.xy;
+    float mip = ceil(log2(max(max(sizeTexels.x, sizeTexels.y), 1.0)));
+    int level = int(clamp(mip, 0.0, params.z - 1.0));
+
+    ivec2 mipSize = max(ivec2(params.xy) >> level, ivec2(1));
+    ivec2 p0 = clamp(ivec2(uvMin * vec2(mipSize)), ivec2(0), mipSize - 1);
+    ivec2 p1 = clamp(ivec2(uvMax * vec2(mipSize)), ivec2(0), mipSize - 1);
+
+    float farthest = min(
+        min(texelFetch(hizPyramid, p0, level).r, texelFetch(hizPyramid, ivec2(p1.x, p0.y), level).r),
+        min(texelFetch(hizPyramid, ivec2(p0.x, p1.y), level).r, texelFetch(hizPyramid, p1, level).r));
+
+    return nearestDepth < farthest;
+}
+
+#endif // NB_HIZ_OCCLUSION_GLSL
@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+// hiz_reduce.glsl
+//
+// One step of the Hi-Z pyramid build: each target texel takes the minimum
+// (farthest, reverse-Z) of the source texels it covers for layer 0 (the
+// occlusion tests) and the maximum (nearest) for layer 1 (screen-space
+// reflection tracing). The footprint is rounded outward so odd source sizes
+// never drop a row or column. The including shader declares its sources and
+// defines LoadSourceDepth(ivec2) -> (farthest, nearest) before including
+// this file.
+//------------------------------------------------------------------------------
+#ifndef NB_HIZ_REDUCE_GLSL
+#define NB_HIZ_REDUCE_GLSL
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(set = 0, binding = 1, r32f) uniform writeonly image2D targetMip;
+layout(set = 0, binding = 3, r32f) uniform writeonly image2D targetNearestMip;
+
+layout(push_constant) uniform ReduceParams
+{
+    ivec4 sizes;  // xy = source size, zw = target size
+} pc;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 srcSize = pc.sizes.xy;
+    ivec2 dstSize = pc.sizes.zw;
+    if (any(greaterThanEqual(texel, dstSize)))
+        return;
+
+    vec2 ratio = vec2(srcSize) / vec2(dstSize);
+    ivec2 first = ivec2(floor(vec2(texel) * ratio));
+    ivec2 last = min(ivec2(ceil(vec2(texel + 1) * ratio)) - 1, srcSize - 1);
+
+    float farthest = 1.0;
+    float nearest = 0.0;
+    for (int y = first.y; y <= last.y; ++y)
+    {
+        for (int x = first.x; x <= last.x; ++x)
+        {
+            vec2 depth = LoadSourceDepth(ivec2(x, y));
+            farthest = min(farthest, depth.x);
+            nearest = max(nearest, depth.y);
+        }
+    }
+
+    imageStore(targetMip, texel, vec4(farthest));
+    imageStore(targetNearestMip, texel, vec4(nearest));
+}
+
+#endif // NB_HIZ_REDUCE_GLSL
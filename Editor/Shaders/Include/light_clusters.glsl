@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+// light_clusters.glsl
+//
+// Clustered point lights (see LightClusterCuller): the view frustum of the
+// render region is cut into LIGHT_CLUSTERS_X x Y screen tiles and
+// LIGHT_CLUSTERS_Z depth slices, exponentially spaced in view depth from the
+// near plane to grid.far (the last slice runs on to infinity). The cluster
+// passes list, per cluster, the lights whose sphere of influence touches it,
+// so a fragment shades only the lights of its own cluster.
+//
+// Provides (set 2 next to SceneLighting, or LIGHT_CLUSTER_SET):
+//   binding 1 -> buffer `clusterLights` (header + every point light)
+//   binding 2 -> buffer `lightClusters` (per-cluster light counts + lists)
+//   LightClusterSlice(viewDepth), LightClusterSliceDepth(slice), LightClusterIndex(id)
+//
+// Read-only unless the includer defines LIGHT_CLUSTER_WRITER (the compute
+// passes). Must match LightClusterCuller.hpp.
+//------------------------------------------------------------------------------
+#ifndef NB_LIGHT_CLUSTERS_GLSL
+#define NB_LIGHT_CLUSTERS_GLSL
+
+#ifndef LIGHT_CLUSTER_SET
+#define LIGHT_CLUSTER_SET 2
+#endif
+
+#ifdef LIGHT_CLUSTER_WRITER
+#define LIGHT_CLUSTER_ACCESS
+#else
+#define LIGHT_CLUSTER_ACCESS readonly
+#endif
+
+const uint LIGHT_CLUSTERS_X = 16u;
+const uint LIGHT_CLUSTERS_Y = 9u;
+const uint LIGHT_CLUSTERS_Z = 24u;
+const uint LIGHT_CLUSTER_COUNT = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z;
+const uint LIGHT_CLUSTER_MAX_LIGHTS = 128u;  // per cluster; the rest are dropped
+
+// Same layout as LightData in scene_common.glsl
+struct ClusterLight {
+    vec4 position;     // xyz = world position, w = 1, or 2 + shadow slot (shadows.glsl)
+    vec4 color;        // rgb = color, a = intensity
+    vec4 attenuation;  // x=constant, y=linear, z=quadratic, w=radius (<= 0: off)
+};
+
+layout(std430, set = LIGHT_CLUSTER_SET, binding = 1) LIGHT_CLUSTER_ACCESS buffer ClusterLightBuffer {
+    uvec4 counts;  // x = scene point lights, y = firefly lights, z = total, w = clustered shading on (1/0)
+    vec4  grid;    // xy = clusters per pixel of the render region, z = slice scale, w = slice bias
+    vec4  params;  // x = near, y = far of the sliced range, z = firefly light radius, w = firefly intensity
+    ClusterLight lights[];
+} clusterLights;
+
+layout(std430, set = LIGHT_CLUSTER_SET, binding = 2) LIGHT_CLUSTER_ACCESS buffer LightClusterBuffer {
+    uint counts[LIGHT_CLUSTER_COUNT];
+    uint indices[];  // LIGHT_CLUSTER_MAX_LIGHTS per cluster
+} lightClusters;
+
+// Slice k spans near * (far / near)^(k / Z) .. ^((k + 1) / Z), so
+// slice = log(depth) * scale + bias with scale = Z / log(far / near)
+uint LightClusterSlice(float viewDepth)
+{
+    float slice = log(max(viewDepth, 1e-4)) * clusterLights.grid.z + clusterLights.grid.w;
+    return uint(clamp(slice, 0.0, float(LIGHT_CLUSTERS_Z - 1u)));
+}
+
+float LightClusterSliceDepth(uint slice)
+{
+    return exp((float(slice) - clusterLights.grid.w) / clusterLights.grid.z);
+}
+
+uint LightClusterIndex(uvec3 id)
+{
+    return id.x + LIGHT_CLUSTERS_X * (id.y + LIGHT_CLUSTERS_Y * id.z);
+}
+
+#endif // NB_LIGHT_CLUSTERS_GLSL
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+// mesh_shading.glsl
+//
+// Everything in Mesh.frag after the set 1 / push constant declarations, so the
+// per-texture-set variant (Mesh.frag) and the bindless one (MeshBindless.frag)
+// share a single copy of the emissive, glass and Blinn-Phong paths. Glass
+// reflects the environment probe (environment_probe.glsl); opaque meshes
+// pick up a faint, rough reflection of it on top of Blinn-Phong.
+//
+// The including shader provides, before the include:
+//   push (PushConstants with at least model + customData)
+//   vec4 SampleAlbedo(vec2 uv)
+//
+// Requires shadows.glsl.
+//------------------------------------------------------------------------------
+#ifndef NB_MESH_SHADING_GLSL
+#define NB_MESH_SHADING_GLSL
+
+// ---- Fragment Inputs ----
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in vec3 fragWorldPos;
+
+// ---- Output (outColor, or the OIT pair under NB_OIT_ACCUMULATE) ----
+#include "oit.glsl"
+#include "environment_probe.glsl"
+
+// The opaque meshes' environment reflection: a dielectric, fairly rough
+const float MESH_ROUGHNESS = 0.6;
+const float MESH_F0 = 0.04;
+
+// ============================================================================
+// Cheap 3D value-noise FBM for the moon's surface mottling (maria/craters).
+// Sampled on the sphere's object-space direction (== fragNormal, since the moon
+// transform is translate + uniform-scale with no rotation), which is SEAMLESS —
+// no UV seam or pole pinching like a fragTexCoord sample would show, and stays
+// fixed to the moon surface as the moon translates.
+// ============================================================================
+float EmissiveHash3(vec3 p)
+{
+    p = fract(p * 0.3183099 + 0.1);
+    p *= 17.0;
+    return fract(p.x * p.y * p.z * (p.x + p.y + p.z));
+}
+
+float EmissiveNoise3(vec3 x)
+{
+    vec3 i = floor(x);
+    vec3 f = fract(x);
+    f = f * f * (3.0 - 2.0 * f);
+    return mix(mix(mix(EmissiveHash3(i + vec3(0,0,0)), EmissiveHash3(i + vec3(1,0,0)), f.x),
+                   mix(EmissiveHash3(i + vec3(0,1,0)), EmissiveHash3(i + vec3(1,1,0)), f.x), f.y),
+               mix(mix(EmissiveHash3(i + vec3(0,0,1)), EmissiveHash3(i + vec3(1,0,1)), f.x),
+                   mix(EmissiveHash3(i + vec3(0,1,1)), EmissiveHash3(i + vec3(1,1,1)), f.x), f.y), f.z);
+}
+
+float EmissiveFbm3(vec3 p)
+{
+    float sum = 0.0;
+    float amp = 0.5;
+    for (int i = 0; i < 4; ++i)
+    {
+        sum += amp * EmissiveNoise3(p);
+        p *= 2.0;
+        amp *= 0.5;
+    }
+    return sum;
+}
+
+// ============================================================================
+// Blinn-Phong lighting
+// ============================================================================
+vec3 CalcBlinnPhong(vec3 N, vec3 V, vec3 lightDir, vec3 lightColor, float lightIntensity)
+{
+    float NdotL = max(dot(N, lightDir), 0.0);
+    vec3 diffuse = lightColor * lightIntensity * NdotL;
+
+    vec3 H = normalize(lightDir + V);
+    float NdotH = max(dot(N, H), 0.0);
+    float spec = pow(NdotH, 32.0);
+    vec3 specular = lightColor * lightIntensity * spec * 0.5;
+
+    return diffuse + specular;
+}
+
+// Point light with 1 / (c + l*d + q*d^2) falloff, faded out over the last
+// quarter of its radius
+vec3 CalcPointLight(vec3 N, vec3 V, vec3 worldPos, vec4 position, vec4 color, vec4 falloff)
+{
+    vec3 toLight = position.xyz - worldPos;
+    float dist = length(toLight);
+    float radius = falloff.w;
+    if (dist > radius) return vec3(0.0);
+
+    float attenuation = 1.0 / (falloff.x + falloff.y * dist + falloff.z * dist * dist);
+    attenuation *= 1.0 - smoothstep(radius * 0.75, radius, dist);
+
+    vec3 lightDir = toLight / max(dist, 0.0001);
+    attenuation *= LocalLightShadow(position, worldPos, N);   // 1 without a shadow slot
+    return CalcBlinnPhong(N, V, lightDir, color.rgb, color.a) * attenuation;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+void main()
+{
+    ClipReflection(fragWorldPos);  // drop below-water geometry in the reflection pass
+
+    vec4 texColor = SampleAlbedo(fragTexCoord);
+
+    // ---- Emissive branch (e.g. the moon) -------------------------------------
+    // customData.w >= 2.0 flags an unlit emissive surface (glass uses w in
+    // (0.01, 1.0] as alpha, so >= 2.0 is unambiguous; this MUST be checked before
+    // the glass branch below). customData.rgb is the HDR emissive color (tint *
+    // intensity), kept bright (> 1.0) so the HDR target + bloom bright-pass pick
+    // it up. The day/night cycle drives rgb (warm/bright by day, cool/dim by
+    // night); the bound texture (set 1) supplies surface detail.
+    if (push.customData.w >= 2.0)
+    {
+        vec3 N = normalize(fragNormal);
+        vec3 V = normalize(frame.cameraPos.xyz - fragWorldPos);
+        float ndv = clamp(dot(N, V), 0.0, 1.0);
+        vec3 emissive = texColor.rgb * push.customData.rgb;
+
+        if (push.customData.w >= 2.5)
+        {
+            // SUN: flat, uniformly bright disc with a slightly hotter core; no limb
+            // darkening, so it reads as a blazing light source (bloom does the glow).
+            float core = mix(0.9, 1.3, ndv);
+            WriteColor(vec4(emissive * core, 1.0));
+        }
+        else
+        {
+            // MOON: nearly-flat disc (only faint limb darkening so it doesn't read as
+            // a shaded 3D ball) with subtle seamless maria/crater mottling. Kept dim
+            // by the day/night intensity so its cool color + surface actually show
+            // instead of blooming out to the same white blob as the sun.
+            float limb = mix(0.8, 1.0, ndv);
+            float mott = mix(0.45, 1.0, EmissiveFbm3(N * 3.0)); // larger, more visible maria
+            WriteColor(vec4(emissive * limb * mott, 1.0));
+        }
+        return;
+    }
+
+
+    bool isMaterialDriven = (push.customData.w > 0.01);
+    vec4 albedo = isMaterialDriven ? push.customData : texColor;
+
+    vec3 N = normalize(fragNormal);
+    vec3 V = normalize(frame.cameraPos.xyz - fragWorldPos);
+
+    vec3 totalLight = lighting.ambient.rgb * lighting.ambient.a;
+
+    // Cascaded shadow factor for the primary directional light (lights[0]).
+    int cascade;
+    vec3 sunDir = normalize(-lighting.lights[0].position.xyz);
+    float shadowFactor = SampleShadow(fragWorldPos, N, sunDir, 1.0, 0.005, cascade);
+
+    // Point lights come from the fragment's cluster when clustered shading
+    // is on (light_clusters.glsl), otherwise from SceneLighting
+    bool clustered = ClusteredLightsActive();
+    for (int i = 0; i < lighting.numLights; ++i)
+    {
+        LightData light = lighting.lights[i];
+
+        if (light.position.w < 0.5)
+        {
+            vec3 lightDir = normalize(-light.position.xyz);
+            float lightShadow = (i == 0) ? shadowFactor : 1.0;
+            totalLight += CalcBlinnPhong(N, V, lightDir, light.color.rgb, light.color.a) * lightShadow;
+        }
+        else if (!clustered)
+        {
+            totalLight += CalcPointLight(N, V, fragWorldPos, light.position, light.color, light.attenuation);
+        }
+    }
+
+    if (clustered)
+    {
+        uint cluster = FragmentLightCluster(fragWorldPos);
+        uint count = lightClusters.counts[cluster];
+        for (uint j = 0u; j < count; ++j)
+        {
+            ClusterLight light = clusterLights.lights[lightClusters.indices[cluster * LIGHT_CLUSTER_MAX_LIGHTS + j]];
+            totalLight += CalcPointLight(N, V, fragWorldPos, light.position, light.color, light.attenuation);
+        }
+    }
+
+    if (isMaterialDriven)
+    {
+        float NdotV = clamp(dot(N, V), 0.0, 1.0);
+        float fresnel = pow(1.0 - NdotV, 5.0);
+        vec3 tint = albedo.rgb;
+        vec3 reflectionColor = EnvironmentRadiance(reflect(-V, N), 0.0);
+        float reflectStrength = 0.15 + 0.85 * fresnel;
+        vec3 glassRgb = mix(tint * totalLight, reflectionColor, reflectStrength);
+        WriteColor(vec4(ApplyCascadeDebug(glassRgb, cascade), albedo.a));
+        return;
+    }
+
+    vec3 specular = EnvironmentSpecular(N, V, MESH_ROUGHNESS, MESH_F0);
+    WriteColor(vec4(ApplyCascadeDebug(albedo.rgb * totalLight + specular, cascade), albedo.a));
+}
+
+#endif // NB_MESH_SHADING_GLSL
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+// mesh_vertex.glsl
+//
+// Body of Mesh.vert, shared with MeshPacked.vert. PACKED_VERTEX (defined by
+// the including shader) switches the inputs to VertexPNTPacked; the model
+// matrix then already carries the per-mesh dequant transform, and the normal
+// matrix built from it undoes the scale the normals were packed with.
+// Outputs MUST match Mesh.frag inputs exactly!
+//------------------------------------------------------------------------------
+#ifndef NB_MESH_VERTEX_GLSL
+#define NB_MESH_VERTEX_GLSL
+
+// ---- Descriptor Set 0: Frame Uniforms ----
+layout(set = 0, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+} frame;
+
+// ---- Per-instance transforms (filled by DrawList::BuildInstanceBatches) ----
+// Batched draws index this with gl_InstanceIndex (firstInstance + instance).
+layout(set = 0, binding = 1) readonly buffer InstanceBuffer {
+    mat4 models[];
+} instances;
+
+// ---- Push Constants ----
+// model is kept for layout compatibility; the transform comes from instances.
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;
+} push;
+
+// ---- Vertex Inputs ----
+// Must match your VertexPCU/VertexPNT format in VulkanPipeline.cpp.
+// Packed (VertexPNTPacked): the unorm position is dequantized by the model
+// matrix and the normal arrives octahedral-encoded; the UV is already float.
+layout(location = 0) in vec3 inPosition;
+#ifdef PACKED_VERTEX
+layout(location = 1) in vec2 inNormalOct;
+#else
+layout(location = 1) in vec3 inNormal;      // Note: This is INPUT, different from output
+#endif
+layout(location = 2) in vec2 inTexCoord;
+
+// ---- Vertex Outputs (to Fragment Shader) ----
+// CRITICAL: These MUST match Mesh.frag inputs EXACTLY!
+layout(location = 0) out vec3 fragNormal;      // vec3 - matches frag input
+layout(location = 1) out vec2 fragTexCoord;    // vec2 - matches frag input (NOT vec3!)
+layout(location = 2) out vec3 fragWorldPos;    // vec3 - matches frag input
+
+// The depth prepass (MeshDepth/MeshPackedDepth) runs this same body with
+// Shadow.frag; EQUAL in the color pass needs the exact same depth
+invariant gl_Position;
+
+#ifdef PACKED_VERTEX
+// Same fold as OctDecode in VertexPacking.cpp
+vec3 OctDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float fold = max(-n.z, 0.0);
+    n.xy += mix(vec2(fold), vec2(-fold), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+#endif
+
+void main() {
+#ifdef PACKED_VERTEX
+    vec3 inNormal = OctDecode(inNormalOct);
+#endif
+
+    mat4 model = instances.models[gl_InstanceIndex];
+
+    // World position (needed for specular + point light distance)
+    vec4 worldPos = model * vec4(inPosition, 1.0);
+    fragWorldPos = worldPos.xyz;
+
+    // World normal (normal matrix = transpose of inverse of upper-left 3x3)
+    mat3 normalMatrix = transpose(inverse(mat3(model)));
+    fragNormal = normalize(normalMatrix * inNormal);
+
+    // Pass through texture coordinates (vec2, not vec3!)
+    fragTexCoord = inTexCoord;
+
+    // Final clip-space position
+    gl_Position = frame.proj * frame.view * worldPos;
+
+    // Emissive sky discs (moon/sun, customData.w >= 2.0) are pinned to the
+    // reverse-Z far plane (NDC z = 0), the same depth the cloud composite draws
+    // at. Without this the moon sits slightly nearer than infinity, so the
+    // clouds' GreaterOrEqual depth test fails over it and the moon punches
+    // through in FRONT of the clouds. Pinning to far lets the cloud pass blend
+    // over the moon (and real geometry still occludes it, having depth > 0).
+    if (push.customData.w >= 2.0) {
+        gl_Position.z = 0.0;
+    }
+}
+
+#endif
@@ -0,0 +1,43 @@
+//------------------------------------------------------------------------------
+// ocean.glsl
+//
+// Shared by the FFT ocean passes (OceanSpectrum/OceanFFT/OceanResolve.comp,
+// see OceanWaves). Set 0 is the same for all three. Every map is an array
+// with one layer per cascade; the spectrum has two, each texel holding two
+// complex numbers (xy, zw) that each pack two real fields:
+//   layer 2c:     (h   + i Dx,  Dz  + i hx)
+//   layer 2c + 1: (hz  + i Dxx, Dzz + i Dxz)
+// h = height, D = horizontal displacement, subscripts = partial derivatives.
+// A real field's spectrum is Hermitian, so the inverse FFT of f + i g leaves
+// f in the real part and g in the imaginary part.
+//
+// Provides:
+//   set 0, binding 0 -> image2DArray `spectrumImage` (rgba32f, read/write)
+//   set 0, binding 1 -> image2DArray `displacementImage` (rgba16f)
+//   set 0, binding 2 -> image2DArray `derivativesImage` (rgba16f)
+//------------------------------------------------------------------------------
+#ifndef NB_OCEAN_GLSL
+#define NB_OCEAN_GLSL
+
+layout(set = 0, binding = 0, rgba32f) uniform image2DArray spectrumImage;
+layout(set = 0, binding = 1, rgba16f) uniform writeonly image2DArray displacementImage;
+layout(set = 0, binding = 2, rgba16f) uniform writeonly image2DArray derivativesImage;
+
+// Must match OceanPushConstants in OceanWaves.cpp (64 bytes)
+layout(push_constant) uniform OceanPush
+{
+    vec4  cascadeLengths;  // patch size per cascade (world units)
+    vec4  wind;            // direction xy (unit), speed (m/s), amplitude
+    vec4  params;          // time (s), choppiness, foam, shortest wavelength kept
+    ivec4 grid;            // N, cascade count, FFT direction (0 rows, 1 columns), log2(N)
+} pc;
+
+const float OCEAN_PI = 3.14159265359;
+const float OCEAN_GRAVITY = 9.81;
+
+vec2 complexMul(vec2 a, vec2 b)
+{
+    return vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+#endif // NB_OCEAN_GLSL
@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+// ocean_waves.glsl
+//
+// Set 3 of the Water pipeline: the FFT ocean maps (see OceanWaves), read by
+// Water.vert (displacement) and Water.frag (normals, foam). Each cascade
+// tiles the world every cascadeLengths[c] units, so a point's texture
+// coordinate is its undisplaced world xz over that length.
+//
+// Provides:
+//   set 3, binding 0 -> sampler2DArray `oceanDisplacement` (dx, h, dz, foam)
+//   set 3, binding 1 -> sampler2DArray `oceanDerivatives` (hx, hz, dxx, dzz)
+//   set 3, binding 2 -> uniform `ocean` (OceanParams)
+//   OceanActive(), OceanDisplacement(xz), OceanSurface(xz, out normal, out foam)
+//------------------------------------------------------------------------------
+#ifndef NB_OCEAN_WAVES_GLSL
+#define NB_OCEAN_WAVES_GLSL
+
+layout(set = 3, binding = 0) uniform sampler2DArray oceanDisplacement;
+layout(set = 3, binding = 1) uniform sampler2DArray oceanDerivatives;
+
+// Must match OceanParamsData in OceanWaves.cpp
+layout(std140, set = 3, binding = 2) uniform OceanParams {
+    vec4  cascadeLengths;
+    vec4  vertexWeights;  // per cascade: how much it moves the vertices
+    ivec4 info;           // x = cascade count (0 = FFT waves off), y = N
+} ocean;
+
+bool OceanActive()
+{
+    return ocean.info.x > 0;
+}
+
+// Sum of the cascades the grid can resolve (the rest only shade)
+vec3 OceanDisplacement(vec2 worldXZ)
+{
+    vec3 offset = vec3(0.0);
+    for (int c = 0; c < ocean.info.x; ++c)
+    {
+        vec2 uv = worldXZ / ocean.cascadeLengths[c];
+        offset += textureLod(oceanDisplacement, vec3(uv, float(c)), 0.0).xyz * ocean.vertexWeights[c];
+    }
+    return offset;
+}
+
+// Normal of the displaced surface from all cascades' slopes, and foam
+void OceanSurface(vec2 worldXZ, out vec3 normal, out float foam)
+{
+    vec2 slope = vec2(0.0);
+    vec2 stretch = vec2(0.0);
+    foam = 0.0;
+    for (int c = 0; c < ocean.info.x; ++c)
+    {
+        vec3 uvw = vec3(worldXZ / ocean.cascadeLengths[c], float(c));
+        vec4 derivatives = texture(oceanDerivatives, uvw);
+        slope += derivatives.xy;
+        stretch += derivatives.zw;
+        foam += texture(oceanDisplacement, uvw).w;
+    }
+
+    // The horizontal displacement stretches the surface, which flattens
+    // the slope seen at a displaced point (kept positive where crests fold)
+    vec2 scale = max(vec2(1.0) + stretch, vec2(0.1));
+    normal = normalize(vec3(-slope.x / scale.x, 1.0, -slope.y / scale.y));
+    foam = clamp(foam, 0.0, 1.0);
+}
+
+#endif // NB_OCEAN_WAVES_GLSL
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+// oit.glsl
+//
+// Color output of the shaders that can draw as order-independent
+// transparency (Mesh/MeshBindless for glass, Water, Firefly, Particle). They write
+// their straight-alpha color through WriteColor(). Built normally that is
+// the single blended color attachment; built with NB_OIT_ACCUMULATE defined
+// (the *Oit.frag wrappers) it is the weighted-blended OIT pair of the OIT
+// pass's first subpass (McGuire & Bavoil, "Weighted Blended Order-Independent
+// Transparency", 2013):
+//   location 0 - accumulation: premultiplied color and alpha scaled by a
+//                depth weight, summed (blend One/One)
+//   location 1 - revealage: alpha, multiplied in as (1 - alpha)
+//                (blend Zero/OneMinusSrcColor)
+// OitComposite.frag resolves the pair over the scene color.
+//------------------------------------------------------------------------------
+#ifndef NB_OIT_GLSL
+#define NB_OIT_GLSL
+
+#ifdef NB_OIT_ACCUMULATE
+layout(location = 0) out vec4 outAccumulation;
+layout(location = 1) out float outRevealage;
+#else
+layout(location = 0) out vec4 outColor;
+#endif
+
+// Nearer layers weigh more, so the front surfaces dominate the average the
+// way they would in a sorted blend. The paper's eq. 7 on view depth
+// (1 / gl_FragCoord.w), with the upper clamp lowered from 3e3 to 3e2 so a
+// handful of bright, near layers (HDR fireflies) stay inside the RGBA16F
+// accumulation target's range.
+float OitWeight(float alpha)
+{
+    float z = 1.0 / gl_FragCoord.w;
+    float w = 10.0 / (1e-5 + pow(z / 5.0, 2.0) + pow(z / 200.0, 6.0));
+    return alpha * clamp(w, 1e-2, 3e2);
+}
+
+void WriteColor(vec4 color)
+{
+#ifdef NB_OIT_ACCUMULATE
+    float alpha = clamp(color.a, 0.0, 1.0);
+    outAccumulation = vec4(color.rgb * alpha, alpha) * OitWeight(alpha);
+    outRevealage = alpha;
+#else
+    outColor = color;
+#endif
+}
+
+#endif // NB_OIT_GLSL
@@ -0,0 +1,34 @@
+//------------------------------------------------------------------------------
+// particle_shading.glsl
+//
+// The body of Particle.frag, shared with ParticleOit.frag: a soft disc
+// (stretched into a streak with the quad). The Particle pipeline blends
+// premultiplied (One/OneMinusSrcAlpha), so one pipeline covers both
+// ParticleBlend modes: translucent particles write their coverage as
+// alpha, additive ones write none and only add their color. Under
+// NB_OIT_ACCUMULATE both are weighted like any other transparent.
+//------------------------------------------------------------------------------
+#ifndef NB_PARTICLE_SHADING_GLSL
+#define NB_PARTICLE_SHADING_GLSL
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) flat in float inAdditive;
+
+#include "oit.glsl"
+
+void main()
+{
+    float dist = length(inUV * 2.0 - 1.0);
+    float coverage = 1.0 - smoothstep(0.4, 1.0, dist);
+    float alpha = inColor.a * coverage;
+    if (alpha <= 1.0 / 255.0) discard;
+
+#ifdef NB_OIT_ACCUMULATE
+    WriteColor(vec4(inColor.rgb, alpha));
+#else
+    WriteColor(vec4(inColor.rgb * alpha, alpha * (1.0 - inAdditive)));
+#endif
+}
+
+#endif // NB_PARTICLE_SHADING_GLSL
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// particle_sim.glsl
+//
+// Data layout of ParticleSystem's pool, as ParticleSimulate.comp sees it.
+// Every emitter owns [base, base + capacity) of the particles, the dead
+// list and both alive lists; the second alive list starts halfway through
+// its buffer. Particles are flat vec4s (3 per particle) to dodge std430
+// vec3 padding, as the firefly agents are:
+//   data[slot*3+0] = position.xyz, age
+//   data[slot*3+1] = velocity.xyz, lifetime
+//   data[slot*3+2] = size, random, -, -
+// Counters are 4 uints per emitter: alive count of list 0, of list 1, dead
+// count, and which alive list is current (the one the draws read).
+//------------------------------------------------------------------------------
+#ifndef NB_PARTICLE_SIM_GLSL
+#define NB_PARTICLE_SIM_GLSL
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(set = 0, binding = 0, std430) buffer ParticleBuffer
+{
+    vec4 data[];
+} particles;
+
+layout(set = 0, binding = 1, std430) buffer AliveBuffer
+{
+    uint indices[];
+} alive;
+
+layout(set = 0, binding = 2, std430) buffer DeadBuffer
+{
+    uint indices[];
+} dead;
+
+layout(set = 0, binding = 3, std430) buffer CounterBuffer
+{
+    uint counters[];
+} counts;
+
+// A VkDrawIndirectCommand per emitter, then the update's
+// VkDispatchIndirectCommand at MAX_EMITTERS * 4
+layout(set = 0, binding = 4, std430) buffer ArgsBuffer
+{
+    uint args[];
+} indirect;
+
+const uint kMaxEmitters = 16u;
+const uint kCounterAlive0 = 0u;
+const uint kCounterDead = 2u;
+const uint kCounterCurrent = 3u;
+
+// Matches ParticleEmitterGpu in ParticleEmitter.hpp
+struct Emitter
+{
+    vec4  center;       // xyz = spawn box centre (world), w = drag
+    vec4  extents;      // xyz = half extents, w = wind influence
+    vec4  velocityMin;  // xyz, w = lifetime min
+    vec4  velocityMax;  // xyz, w = lifetime max
+    vec4  gravity;      // xyz, w = kill height
+    vec4  motion;       // turbulence, turbulence scale, size min, size max
+    uvec4 range;        // base, capacity, spawn count, -
+    vec4  reserved;
+};
+
+layout(set = 1, binding = 0, std140) uniform EmitterUBO
+{
+    Emitter emitters[kMaxEmitters];
+} emitterData;
+
+// Matches ParticlePushConstants in ParticleSystem.cpp
+layout(push_constant) uniform PassParams
+{
+    vec4  frame;  // deltaTime, total time, wind x, wind z
+    uvec4 info;   // pass, emitter count, frame seed, -
+} params;
+
+uint PoolCapacity()
+{
+    return uint(alive.indices.length()) / 2u;
+}
+
+uint CounterIndex(uint emitter, uint counter)
+{
+    return emitter * 4u + counter;
+}
+
+uint PcgHash(uint v)
+{
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+// Uniform [0, 1); `stream` picks one of the seed's independent values
+float Random(uint seed, uint stream)
+{
+    uint h = PcgHash(seed ^ PcgHash(stream + 0x9E3779B9u));
+    return float(h >> 8u) * (1.0 / 16777216.0);
+}
+
+// Cheap divergence-free-looking swirl: three offset sine waves, one per
+// axis, scrolling with time. Enough to break up straight-line drift.
+vec3 Turbulence(vec3 p, float scale, float time)
+{
+    vec3 q = p * scale * 6.2831853;
+    return vec3(
+        sin(q.y + 1.7 * time) + sin(q.z * 1.3 + 0.9 * time),
+        sin(q.z + 1.3 * time) + sin(q.x * 1.1 + 0.7 * time),
+        sin(q.x + 1.1 * time) + sin(q.y * 1.7 + 1.9 * time)) * 0.5;
+}
+
+#endif // NB_PARTICLE_SIM_GLSL
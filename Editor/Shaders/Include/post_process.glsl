@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+// post_process.glsl
+//
+// The final composite, shared by the full-screen PostProcess.frag and the
+// single-dispatch PostProcess.comp: FXAA-style edge blur, additive bloom,
+// exposure + ACES tonemap (or clamp), vignette. Both bind the scene color
+// at set 0 and the bloom chain at set 1. The including shader defines
+// SceneTap (declared below): the scene color at this pixel plus an offset
+// in texels.
+//
+// PostProcess.frag has an fp16 build (half_precision.glsl): the luma edge
+// test and the grading math run in mfloat there; scene taps and the blur
+// sum stay float.
+//------------------------------------------------------------------------------
+#ifndef NB_POST_PROCESS_GLSL
+#define NB_POST_PROCESS_GLSL
+
+#include "half_precision.glsl"
+#include "shader_features.glsl"
+
+// Tone mapping / grading params. Must match PostProcessPushConstants on the
+// C++ side (Renderer). Push-constant block = std430 scalar layout.
+layout(push_constant) uniform PushConstants
+{
+    int   aaEnabled;        // FXAA edge-aware AA on/off
+    int   tonemapEnabled;   // ACES filmic tonemap on/off (off = hard clamp to [0,1])
+    float exposure;         // linear exposure multiplier applied before tonemap
+    float vignetteStrength; // 0 = none; darkens toward frame edges
+    float bloomIntensity;   // additive bloom strength (0 = off)
+    float uvScaleX;         // rendered part of the scene target (dynamic resolution; 1 = all)
+    float uvScaleY;
+} pc;
+
+vec3 SceneTap(vec2 offsetTexels);
+
+mfloat Luma(vec3 c)
+{
+    return dot(mvec3(c), mvec3(0.299, 0.587, 0.114));
+}
+
+// ACES filmic tone curve (Narkowicz approximation). Operates on linear HDR and
+// returns linear [0,1]. Compresses highlights gracefully instead of clipping —
+// the whole reason for the HDR scene target. Inputs up to 100 (Grade clamps
+// there; the curve is already past 1.0) keep x * x inside fp16's range.
+mvec3 ACESFilmic(mvec3 x)
+{
+    const mfloat a = mfloat(2.51), b = mfloat(0.03), c = mfloat(2.43), d = mfloat(0.59), e = mfloat(0.14);
+    return clamp((x * (a * x + b)) / (x * (c * x + d) + e), mfloat(0.0), mfloat(1.0));
+}
+
+// The scene-color target is LINEAR HDR (B10G11R11), so these samples can
+// exceed 1.0. FXAA runs here on HDR values (acceptable; ideally it would run
+// post-tonemap on LDR — flagged as a future refinement, AA is already a known
+// soft spot).
+vec3 ResolveAA(vec3 colorCenter)
+{
+    vec3 colorUp    = SceneTap(vec2(0.0,  1.0));
+    vec3 colorDown  = SceneTap(vec2(0.0, -1.0));
+    vec3 colorLeft  = SceneTap(vec2(-1.0, 0.0));
+    vec3 colorRight = SceneTap(vec2( 1.0, 0.0));
+
+    mfloat lumaCenter = Luma(colorCenter);
+    mfloat lumaUp = Luma(colorUp);
+    mfloat lumaDown = Luma(colorDown);
+    mfloat lumaLeft = Luma(colorLeft);
+    mfloat lumaRight = Luma(colorRight);
+
+    mfloat lumaMin = min(lumaCenter, min(min(lumaUp, lumaDown), min(lumaLeft, lumaRight)));
+    mfloat lumaMax = max(lumaCenter, max(max(lumaUp, lumaDown), max(lumaLeft, lumaRight)));
+    mfloat lumaRange = lumaMax - lumaMin;
+
+    // Only blur actual edges; low-contrast interiors pass through unchanged.
+    const mfloat kEdgeThresholdMin = mfloat(0.0312);
+    const mfloat kEdgeThresholdMax = mfloat(0.125);
+    mfloat threshold = max(kEdgeThresholdMin, lumaMax * kEdgeThresholdMax);
+    if (lumaRange < threshold)
+        return colorCenter;
+
+    // Widened 9-tap box blur — radius kWideningFactor texels, including
+    // diagonals. See ROADMAP.md for the full FXAA investigation history;
+    // these constants (1.4 / 0.35) are a calm middle point, not final.
+    const float w = 1.4;  // kWideningFactor
+
+    // Summed in float: nine HDR taps can overflow fp16
+    vec3 blurred = (colorCenter
+        + SceneTap(vec2(0.0,  w)) + SceneTap(vec2(0.0, -w))
+        + SceneTap(vec2(-w, 0.0)) + SceneTap(vec2( w, 0.0))
+        + SceneTap(vec2(-w,  w)) + SceneTap(vec2( w,  w))
+        + SceneTap(vec2(-w, -w)) + SceneTap(vec2( w, -w))) / 9.0;
+
+    mfloat edgeStrength = clamp(lumaRange / max(lumaMax, mfloat(0.0001)), mfloat(0.0), mfloat(1.0));
+    mfloat blendAmount = max(edgeStrength, mfloat(0.35));
+    return mix(colorCenter, blurred, float(blendAmount));
+}
+
+// Bloom (already added, in HDR) -> exposure -> tonemap -> vignette. uv is
+// the display UV. Returns linear [0,1].
+vec3 Grade(vec3 sceneCol, vec2 uv)
+{
+    // Exposure in linear HDR, then compress to displayable range. With tonemap
+    // off we just clamp (so HDR still shows *something* sane on the 8-bit output).
+    // Both saturate well below 100, so clamping there first changes nothing
+    // but keeps the fp16 build in range.
+    mvec3 color = mvec3(min(sceneCol * pc.exposure, vec3(100.0)));
+    color = (NB_FEATURE_TONEMAP && pc.tonemapEnabled != 0) ? ACESFilmic(color) : clamp(color, mfloat(0.0), mfloat(1.0));
+
+    // Vignette — gentle radial darkening toward the frame edge (display space).
+    if (pc.vignetteStrength > 0.0)
+    {
+        float dist = length(uv - vec2(0.5));
+        mfloat vig = mfloat(1.0 - pc.vignetteStrength * smoothstep(0.35, 0.85, dist));
+        color *= vig;
+    }
+    return vec3(color);
+}
+
+// sRGB transfer functions, for the compute path's 8-bit UNORM target (the
+// swapchain is sRGB and encodes on write, which a storage image can't do)
+vec3 LinearToSrgb(vec3 c)
+{
+    vec3 lo = c * 12.92;
+    vec3 hi = 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055;
+    return mix(hi, lo, lessThanEqual(c, vec3(0.0031308)));
+}
+
+vec3 SrgbToLinear(vec3 c)
+{
+    vec3 lo = c / 12.92;
+    vec3 hi = pow((c + 0.055) / 1.055, vec3(2.4));
+    return mix(hi, lo, lessThanEqual(c, vec3(0.04045)));
+}
+
+#endif // NB_POST_PROCESS_GLSL
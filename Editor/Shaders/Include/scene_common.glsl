@@ -9,7 +9,13 @@
 //
 // Provides:
 //   set 0, binding 0  -> FrameUBO        instance `frame`
+//   (set 0, binding 2 -> the wind field: wind_field.glsl)
+//   (set 0, bindings 3-4 -> the sky-view LUT and aerial perspective: sky.glsl)
+//   (set 0, binding 5 -> the cloud shadow map: cloud_shadow.glsl)
+//   (set 0, binding 7 -> the environment probe: environment_probe.glsl)
 //   set 2, binding 0  -> SceneLighting   instance `lighting`
+//   set 2, bindings 1-2 -> clustered point lights (light_clusters.glsl)
+//   ClusteredLightsActive(), FragmentLightCluster(worldPos)
 //
 // Set 1 (textures / storage) is pass-specific and stays in each shader.
 //------------------------------------------------------------------------------
@@ -21,12 +27,50 @@
 const int NUM_CASCADES = 4;
 const int MAX_LIGHTS   = 16;
 
+#include "atmosphere.glsl"
+
+// The terrain's virtual texture pages (Terrain.frag); must match
+// TerrainVirtualTextureData in TerrainVirtualTexture.hpp
+const int TERRAIN_VIRTUAL_LEVELS = 6;
+struct TerrainVirtualData {
+    vec4  config;                           // x = finest page world size, y = page texels, z = radius (pages), w = levels (0 = none)
+    ivec4 levels[TERRAIN_VIRTUAL_LEVELS];   // xy = window centre page, z = 1 once resident
+};
+
+// The terrain's sun shadow map (terrain_shadow.glsl); must match
+// TerrainSunShadowData in TerrainSunShadow.hpp
+struct TerrainShadowData {
+    vec4 window;   // xy = min corner (world xz), z = side (0 = off)
+    vec4 params;   // x = bias, y = penumbra (world height)
+};
+
 // ---- Set 0: per-frame camera/time ----
 layout(set = 0, binding = 0) uniform FrameUBO {
     mat4 view;
     mat4 proj;
     vec4 time;
     vec4 cameraPos;
+    mat4 invView;
+    mat4 invProj;
+    vec4 reflection;
+    // Far-field grass (Terrain.frag); w of farGrassLod = 0 turns it off
+    vec4 farGrassLod;       // x = lodFullDistance, y = lodFadeDistance, z = strength, w = enabled
+    vec4 farGrassDensity;   // x = densityFrequency, y = densityThreshold, z = seed (uint bits), w = densityOctaves
+    vec4 farGrassSlope;     // x = slopeThresholdCos, y = slopeFalloffCos
+    // Wind field (wind_field.glsl); w of windField = 0 is still air
+    vec4 windField;         // xy = window min corner (world xz), z = window side, w = baked
+    vec4 windDirection;     // xy = unit heading in xz
+    // The atmosphere (sky.glsl); sun.w = 0 when there is none
+    AtmosphereData atmosphere;
+    vec4 skyColor;          // rgb = the clear colour, the sky's floor
+    // The cloud shadow map's window (cloud_shadow.glsl); z = 0 without clouds
+    vec4 cloudShadow;       // xy = min corner (world xz), z = side, w = top of the layer
+    // The terrain's virtual texture pages (Terrain.frag); w of config = 0 without one
+    TerrainVirtualData terrainVirtual;
+    // The terrain's sun shadow map's window (terrain_shadow.glsl); z of window = 0 without one
+    TerrainShadowData terrainShadow;
+    // World position -> reflection target uv, as of its last render (Water.frag)
+    mat4 reflectionLookup;
 } frame;
 
 // ---- Set 2: scene lighting (must match SceneLightingData in Light.hpp) ----
@@ -39,7 +83,7 @@ struct LightData {
 struct ShadowData {
     mat4 lightSpaceMatrix[NUM_CASCADES];   // one light VP per cascade
     vec4 cascadeSplits;                    // view-space FAR distance of each cascade (selection)
-    vec4 cascadeRadii;                     // ortho half-size of each cascade (bias scaling)
+    vec4 cascadeRadii;                     // ortho half-size of each cascade over a full layer (bias scaling)
     vec4 shadowParams;                     // x=bias, y=normalBias, z=debugTint, w=enabled
     vec4 extraParams;                      // x=cascade blend fraction, yzw=reserved
 };
@@ -52,15 +96,36 @@ layout(std140, set = 2, binding = 0) uniform SceneLighting {
     ShadowData shadowData;
 } lighting;
 
+#include "light_clusters.glsl"
+
+// With clustered shading on, SceneLighting's point lights are ignored and
+// every point light comes from the fragment's cluster instead. The clusters
+// are built for the main camera, so the reflection pass (frame.time.w == 1)
+// keeps the SceneLighting loop.
+bool ClusteredLightsActive()
+{
+    return frame.time.w < 0.5 && clusterLights.counts.w != 0u;
+}
+
+uint FragmentLightCluster(vec3 worldPos)
+{
+    float viewDepth = -(frame.view * vec4(worldPos, 1.0)).z;
+    uvec2 tile = min(uvec2(gl_FragCoord.xy * clusterLights.grid.xy),
+                     uvec2(LIGHT_CLUSTERS_X - 1u, LIGHT_CLUSTERS_Y - 1u));
+    return LightClusterIndex(uvec3(tile, LightClusterSlice(viewDepth)));
+}
+
 // ---- Planar-reflection below-water clip ----
 // The reflection pass re-renders the world from a mirror-flipped camera. Geometry that sits
 // BELOW the water surface in the real world (e.g. terrain dipping under the lake) would still
 // be rasterized and leak into the reflection as dark mirrored patches. frame.time.w is 1.0 ONLY
-// during the reflection pass (0 in the main/shadow passes), and frame.time.y is the water
-// surface Y — so clip anything below it. discard-from-a-helper is valid GLSL.
+// during the reflection pass (0 in the main/shadow passes, 2 in the editor's auxiliary views,
+// which share its other secondary-camera fallbacks but keep underwater geometry), and
+// frame.time.y is the water surface Y — so clip anything below it. discard-from-a-helper is
+// valid GLSL.
 void ClipReflection(vec3 worldPos)
 {
-    if (frame.time.w > 0.5 && worldPos.y < frame.time.y)
+    if (frame.time.w > 0.5 && frame.time.w < 1.5 && worldPos.y < frame.time.y)
         discard;
 }
 
@@ -0,0 +1,18 @@
+//------------------------------------------------------------------------------
+// shader_features.glsl
+//
+// Feature toggles as specialization constants. constant_id i is bit i of the
+// C++ ShaderVariantKey (Engine/Renderer/ShaderVariant.hpp); the pipeline
+// manager fills them per variant, so a disabled feature's branch is folded
+// away when the pipeline is built. The defaults here match
+// DEFAULT_SHADER_VARIANT and apply to pipelines built without variants.
+//------------------------------------------------------------------------------
+#ifndef NB_SHADER_FEATURES_GLSL
+#define NB_SHADER_FEATURES_GLSL
+
+layout(constant_id = 0) const bool NB_FEATURE_SHADOW_PCF      = true;   // 3x3 PCF (off: one tap)
+layout(constant_id = 1) const bool NB_FEATURE_CASCADE_DEBUG   = false;  // cascade tint
+layout(constant_id = 2) const bool NB_FEATURE_FXAA            = true;   // post-process AA
+layout(constant_id = 3) const bool NB_FEATURE_TONEMAP         = true;   // ACES (off: clamp)
+
+#endif // NB_SHADER_FEATURES_GLSL
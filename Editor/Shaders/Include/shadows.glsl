@@ -8,18 +8,168 @@
 //
 // Provides:
 //   set 3, binding 0 -> sampler2DArrayShadow `shadowMap`
+//   set 3, binding 2 -> sampler2DShadow `localShadowAtlas` (point lights)
+//   set 3, binding 3 -> LocalShadowBlock `localShadows`, its face matrices
+//   LocalLightShadow, the lit factor of a point light with a shadow slot
 //   SelectCascade / CascadeRadius / ComputeShadow / SampleShadow / ApplyCascadeDebug
+//   (SampleShadow includes the clouds' shadow, cloud_shadow.glsl, and the
+//   terrain's heightfield sun shadow, terrain_shadow.glsl)
 //
 // Requires scene_common.glsl (frame + lighting blocks); pulled in below.
+//
+// The ray-query build (compiled again with NB_RAY_QUERY, loaded as
+// <name>.frag.rayquery.spv for ShaderFeature::RayQueryShadow) also binds the
+// sun's TLAS at set 3, binding 1 and traces lights[0] instead of reading the
+// cascades whenever extraParams.y selects a RAY_SHADOW_* mode (see
+// RayTracedShadow.hpp). Include it before any declaration: that build enables
+// an extension.
 //------------------------------------------------------------------------------
 #ifndef NB_SHADOWS_GLSL
 #define NB_SHADOWS_GLSL
 
+#ifdef NB_RAY_QUERY
+#extension GL_EXT_ray_query : require
+#endif
+
 #include "scene_common.glsl"
+#include "shader_features.glsl"
+#include "cloud_shadow.glsl"
+#include "terrain_shadow.glsl"
 
 // ---- Set 3: cascaded shadow map array (depth-compare sampler) ----
 layout(set = 3, binding = 0) uniform sampler2DArrayShadow shadowMap;
 
+#ifdef NB_RAY_QUERY
+// ---- Set 3: the casters' TLAS (RayTracedShadows), rebuilt or refit per frame ----
+layout(set = 3, binding = 1) uniform accelerationStructureEXT sunTlas;
+
+// extraParams.y; mirrors RayTracedShadow::MODE_*
+#define RAY_SHADOW_OFF            0
+#define RAY_SHADOW_PIXEL          1
+#define RAY_SHADOW_PIXEL_DENOISED 2
+#define RAY_SHADOW_QUAD_SHARED    3
+
+// Two uniform [0,1) numbers per pixel and frame, for the cone jitter
+vec2 RayShadowNoise(uvec2 pixel)
+{
+    uint h = pixel.x * 1973u + pixel.y * 9277u + floatBitsToUint(frame.time.x) * 26699u;
+    h = (h ^ (h >> 16)) * 0x7feb352du;
+    h = (h ^ (h >> 15)) * 0x846ca68bu;
+    h ^= h >> 16;
+    return vec2(h & 0xffffu, h >> 16) / 65536.0;
+}
+
+// 1 if nothing in the TLAS lies between worldPos and the sun, else 0. The
+// ray leaves from a point lifted along the normal (shadowParams.y while
+// tracing) and is jittered over the sun's disc (extraParams.z = tan of its
+// angular radius), so the penumbra widens with the distance to the caster.
+float TraceSunShadow(vec3 worldPos, vec3 normal, vec3 lightDir, uvec2 pixel)
+{
+    vec3 L = normalize(lightDir);
+    vec3 N = normalize(normal);
+    N = dot(N, L) < 0.0 ? -N : N;
+
+    vec3 tangent   = normalize(abs(L.y) < 0.99 ? cross(L, vec3(0.0, 1.0, 0.0)) : cross(L, vec3(1.0, 0.0, 0.0)));
+    vec3 bitangent = cross(L, tangent);
+    vec2 xi        = RayShadowNoise(pixel);
+    float radius   = lighting.shadowData.extraParams.z * sqrt(xi.x);
+    float angle    = 6.28318530718 * xi.y;
+    vec3 dir = normalize(L + (tangent * cos(angle) + bitangent * sin(angle)) * radius);
+
+    vec3 origin = worldPos + N * lighting.shadowData.shadowParams.y;
+
+    rayQueryEXT query;
+    rayQueryInitializeEXT(query, sunTlas, gl_RayFlagsTerminateOnFirstHitEXT | gl_RayFlagsOpaqueEXT,
+                          0xFF, origin, 0.0, dir, lighting.shadowData.extraParams.w);
+    while (rayQueryProceedEXT(query)) {}
+    return rayQueryGetIntersectionTypeEXT(query, true) == gl_RayQueryCommittedIntersectionNoneEXT ? 1.0 : 0.0;
+}
+
+// The lit factor the 2x2 quad's weighted pixels agree on: each pixel reads
+// its three neighbours through fine derivatives. Quad-uniform control flow only.
+float QuadAverage(float value, float weight)
+{
+    vec2 side = vec2(equal(uvec2(gl_FragCoord.xy) & 1u, uvec2(0u))) * 2.0 - 1.0;
+    vec2 v  = vec2(value * weight, weight);
+    vec2 vx = v + side.x * dFdxFine(v);
+    vec2 vy = v + side.y * dFdyFine(v);
+    vec2 vd = vx + side.y * dFdyFine(vx);
+    vec2 sum = v + vx + vy + vd;
+    return sum.y > 0.0 ? sum.x / sum.y : value;
+}
+
+// The traced lit factor for the current mode. QuadShared traces the quad's
+// diagonal pair only; helper lanes' rays count for less, since they hit
+// points off the triangle.
+float RayTracedShadow(vec3 worldPos, vec3 normal, vec3 lightDir, int mode)
+{
+    uvec2 pixel = uvec2(gl_FragCoord.xy);
+    bool trace = mode != RAY_SHADOW_QUAD_SHARED || ((pixel.x ^ pixel.y) & 1u) == 0u;
+
+    float lit = 1.0;
+    if (trace)
+        lit = TraceSunShadow(worldPos, normal, lightDir, pixel);
+
+    if (mode == RAY_SHADOW_PIXEL)
+        return lit;
+    float weight = trace ? (gl_HelperInvocation ? 0.25 : 1.0) : 0.0;
+    return QuadAverage(lit, weight);
+}
+#endif
+
+// ---- Set 3: point light shadows, six tiles a light (LocalShadowAtlas.hpp) ----
+#define MAX_LOCAL_SHADOWS 8   // mirrors MAX_LOCAL_SHADOWS
+#define LOCAL_SHADOW_SLOT_W_BASE 2.0   // position.w of a light in slot 0
+
+layout(set = 3, binding = 2) uniform sampler2DShadow localShadowAtlas;
+
+layout(std140, set = 3, binding = 3) uniform LocalShadowBlock {
+    mat4 faceMatrices[MAX_LOCAL_SHADOWS * 6];   // world -> atlas clip space, +X -X +Y -Y +Z -Z
+    vec4 faceRects[MAX_LOCAL_SHADOWS * 6];      // the tile's uv, inset half a texel
+    vec4 lightParams[MAX_LOCAL_SHADOWS];        // x = texel size per unit of distance, y = normal bias (texels), w = 1 if live
+    vec4 atlas;                                 // x = 1 / atlas size
+} localShadows;
+
+// The lit factor of a point light at position (w carries its slot, see
+// EncodeLight); 1 for lights without one. 3x3 PCF, kept inside the tile.
+float LocalLightShadow(vec4 position, vec3 worldPos, vec3 N)
+{
+    int slot = int(position.w + 0.5) - int(LOCAL_SHADOW_SLOT_W_BASE);
+    if (slot < 0 || slot >= MAX_LOCAL_SHADOWS) return 1.0;
+    vec4 params = localShadows.lightParams[slot];
+    if (params.w < 0.5) return 1.0;
+
+    // Lift the receiver along its normal by a few of the face's texels there
+    vec3 fromLight = worldPos - position.xyz;
+    float dist = length(fromLight);
+    vec3 receiver = worldPos + N * (params.y * params.x * dist);
+
+    // Major axis, as LocalShadowAtlas::SelectFace
+    vec3 a = abs(fromLight);
+    int face = (a.x >= a.y && a.x >= a.z) ? (fromLight.x >= 0.0 ? 0 : 1)
+             : (a.y >= a.z)               ? (fromLight.y >= 0.0 ? 2 : 3)
+                                          : (fromLight.z >= 0.0 ? 4 : 5);
+    int index = slot * 6 + face;
+
+    vec4 clip = localShadows.faceMatrices[index] * vec4(receiver, 1.0);
+    if (clip.w <= 0.0) return 1.0;
+    vec3 ndc = clip.xyz / clip.w;
+    vec2 uv = ndc.xy * 0.5 + 0.5;
+    vec4 rect = localShadows.faceRects[index];
+
+    float texel = localShadows.atlas.x;
+    float lit = 0.0;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec2 tap = clamp(uv + vec2(x, y) * texel, rect.xy, rect.zw);
+            lit += texture(localShadowAtlas, vec3(tap, ndc.z));
+        }
+    }
+    return lit / 9.0;
+}
+
 // View-space forward distance of a world position (matches how cascades are split CPU-side).
 float ViewDepth(vec3 worldPos)
 {
@@ -112,6 +262,10 @@ float ComputeShadow(vec3 worldPos, vec3 normal, vec3 lightDir, int cascade,
 
     float currentDepth = depth - bias - receiverBias;
 
+    // Specialization constant: the unused path is compiled out
+    if (!NB_FEATURE_SHADOW_PCF)
+        return texture(shadowMap, vec4(uv, float(cascade), currentDepth));
+
     float shadow = 0.0;
     for (int x = -1; x <= 1; ++x)
         for (int y = -1; y <= 1; ++y)
@@ -130,6 +284,19 @@ float ComputeShadow(vec3 worldPos, vec3 normal, vec3 lightDir, int cascade,
 float SampleShadow(vec3 worldPos, vec3 normal, vec3 lightDir,
                    float biasScale, float maxReceiverBias, out int cascadeOut)
 {
+#ifdef NB_RAY_QUERY
+    // Traced instead (RayTracedShadows), when the renderer turned it on
+    int rayMode = int(lighting.shadowData.extraParams.y + 0.5);
+    if (rayMode != RAY_SHADOW_OFF)
+    {
+        cascadeOut = 0;
+        float traced = lighting.shadowData.shadowParams.w < 0.5
+            ? 1.0 : RayTracedShadow(worldPos, normal, lightDir, rayMode);
+        traced = min(traced, TerrainSunShadow(worldPos, frame.terrainShadow));
+        return traced * CloudShadowTransmittance(worldPos, -lighting.lights[0].position.xyz, frame.cloudShadow);
+    }
+#endif
+
     int c = SelectCascade(worldPos);
     cascadeOut = c;
 
@@ -152,13 +319,20 @@ float SampleShadow(vec3 worldPos, vec3 normal, vec3 lightDir,
                          t);
         }
     }
-    return shadow;
+
+    // The terrain (terrain_shadow.glsl), which casts into the near cascades
+    // at most; where both see it the darker one wins
+    shadow = min(shadow, TerrainSunShadow(worldPos, frame.terrainShadow));
+
+    // The clouds overhead (cloud_shadow.glsl), toward lights[0] as baked
+    return shadow * CloudShadowTransmittance(worldPos, -lighting.lights[0].position.xyz, frame.cloudShadow);
 }
 
 // Debug: tint by cascade when shadowParams.z >= 0.5 (0=red,1=green,2=blue,3=yellow).
+// Only the CascadeDebug variant carries the code at all.
 vec3 ApplyCascadeDebug(vec3 color, int cascade)
 {
-    if (lighting.shadowData.shadowParams.z < 0.5) return color;
+    if (!NB_FEATURE_CASCADE_DEBUG || lighting.shadowData.shadowParams.z < 0.5) return color;
     vec3 tint = (cascade == 0) ? vec3(1.0, 0.4, 0.4)
               : (cascade == 1) ? vec3(0.4, 1.0, 0.4)
               : (cascade == 2) ? vec3(0.4, 0.4, 1.0)
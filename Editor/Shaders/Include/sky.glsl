@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+// sky.glsl
+//
+// Lookups into the atmosphere LUTs AtmosphereLuts bakes (see
+// AtmosphereLuts.hpp, atmosphere.glsl): the sky's luminance along a view
+// direction, and the haze between the camera and a surface. Reads
+// frame.atmosphere, so include it after the frame block is declared
+// (scene_common.glsl, or a shader's own FrameUniforms down to skyColor).
+//
+// Both do nothing while frame.atmosphere.sun.w is 0 (no atmosphere).
+//
+// Provides:
+//   set 0, binding 3 -> skyViewLut
+//   set 0, binding 4 -> aerialPerspectiveLut
+//   SkyLuminance, ApplyAerialPerspective
+//------------------------------------------------------------------------------
+#ifndef NB_SKY_GLSL
+#define NB_SKY_GLSL
+
+#include "atmosphere.glsl"
+
+layout(set = 0, binding = 3) uniform sampler2D skyViewLut;
+layout(set = 0, binding = 4) uniform sampler3D aerialPerspectiveLut;
+
+// Sky luminance toward the world-space unit direction, sun illuminance
+// applied. The LUT holds one sun elevation; its azimuth is the angle
+// between the sun's and the view's headings.
+vec3 SkyLuminance(vec3 direction)
+{
+    AtmosphereData atmosphere = frame.atmosphere;
+    if (atmosphere.sun.w <= 0.0)
+        return vec3(0.0);
+
+    vec2 viewXZ = direction.xz;
+    vec2 sunXZ = atmosphere.sun.xz;
+    float viewLength = length(viewXZ);
+    float sunLength = length(sunXZ);
+    float lightViewCos = (viewLength > 1e-5 && sunLength > 1e-5)
+        ? dot(viewXZ / viewLength, sunXZ / sunLength)
+        : 1.0;
+
+    vec2 uv = SkyViewLutUv(atmosphere, atmosphere.radii.z, direction.y, lightViewCos);
+    return textureLod(skyViewLut, uv, 0.0).rgb * atmosphere.sun.w;
+}
+
+// The surface colour at worldPos as seen through the air in front of it.
+// The froxels are built for the main camera, so the reflection pass leaves
+// the colour alone.
+vec3 ApplyAerialPerspective(vec3 color, vec3 worldPos)
+{
+    AtmosphereData atmosphere = frame.atmosphere;
+    if (atmosphere.sun.w <= 0.0 || atmosphere.ozone.w <= 0.0 || frame.time.w > 0.5)
+        return color;
+
+    vec4 clip = frame.proj * frame.view * vec4(worldPos, 1.0);
+    if (clip.w <= 0.0)
+        return color;
+    vec2 uv = clip.xy / clip.w * 0.5 + 0.5;
+
+    // Slice s holds the haze out to (s + 1) / AERIAL_LUT_SIZE of the depth;
+    // nearer than the first slice fades in from nothing
+    float distanceKm = distance(worldPos, frame.cameraPos.xyz) * atmosphere.ozone.w;
+    float w = distanceKm / AERIAL_DEPTH_KM - 0.5 / AERIAL_LUT_SIZE;
+    float fade = clamp(distanceKm * AERIAL_LUT_SIZE / AERIAL_DEPTH_KM, 0.0, 1.0);
+
+    vec4 haze = textureLod(aerialPerspectiveLut, vec3(uv, clamp(w, 0.0, 1.0)), 0.0);
+    vec3 transmittance = mix(vec3(1.0), vec3(haze.a), fade);
+    return color * transmittance + haze.rgb * fade * atmosphere.sun.w;
+}
+
+#endif // NB_SKY_GLSL
@@ -0,0 +1,33 @@
+//------------------------------------------------------------------------------
+// ssr.glsl
+//
+// Shared by the screen-space reflection passes (SSRHistory.comp,
+// SSRTrace.comp; see ScreenSpaceReflections): the set 1 images and the push
+// constants. The history is a half-resolution copy of the scene color,
+// texel-aligned with OcclusionCuller's Hi-Z pyramid mip 0.
+//
+// Provides:
+//   set 1, binding 0 -> sampler2D `sceneColor` (this frame, after the scene pass)
+//   set 1, binding 1 -> sampler2D `colorHistory` (last frame, GENERAL)
+//   set 1, binding 2 -> image2D `historyImage` (same image, written)
+//   set 1, binding 3 -> image2D `reflectionImage` (the water's reflection input)
+//------------------------------------------------------------------------------
+#ifndef NB_SSR_GLSL
+#define NB_SSR_GLSL
+
+layout(set = 1, binding = 0) uniform sampler2D sceneColor;
+layout(set = 1, binding = 1) uniform sampler2D colorHistory;
+layout(set = 1, binding = 2, rgba16f) uniform writeonly image2D historyImage;
+layout(set = 1, binding = 3, rgba16f) uniform writeonly image2D reflectionImage;
+
+// Must match SSRPushConstants in ScreenSpaceReflections.cpp (128 bytes)
+layout(push_constant) uniform SSRParams
+{
+    mat4  prevViewProj;  // the matrix the pyramid and history were rendered with
+    vec4  pyramid;       // mip 0 region built (w, h), mip count, history valid 0/1
+    vec4  params;        // water plane Y, near plane, max ray distance, thickness (world units)
+    ivec4 extents;       // render region (w, h), reflection image (w, h)
+    vec4  reserved;      // unused (keeps the block at 128 bytes)
+} pc;
+
+#endif // NB_SSR_GLSL
@@ -0,0 +1,38 @@
+//------------------------------------------------------------------------------
+// subgroup_ops.glsl
+//
+// Subgroup paths for the compute kernels that append to a counter. The
+// subgroup build of a shader (compiled again with NB_SUBGROUP_OPS, loaded as
+// <name>.comp.subgroup.spv when SupportsFeature("subgroup_ops")) enables the
+// KHR subgroup extensions; the normal build falls back to one atomic per
+// invocation, so the same source serves both.
+//
+// NB_APPEND_SLOT(counter, slot) reserves one slot of `counter` for every
+// active invocation. The subgroup build ballots the invocations, lets one of
+// them do a single atomicAdd for all, and hands out ranks by ballot bit
+// count. `counter` must be the same for every active invocation: split
+// appends to different counters into branches first.
+//
+// Include it before any declaration: the subgroup build enables extensions.
+//------------------------------------------------------------------------------
+#ifndef NB_SUBGROUP_OPS_GLSL
+#define NB_SUBGROUP_OPS_GLSL
+
+#ifdef NB_SUBGROUP_OPS
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_ballot : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+
+#define NB_APPEND_SLOT(counter, slot)                                               \
+    {                                                                               \
+        uvec4 nbBallot = subgroupBallot(true);                                      \
+        uint nbBase = 0u;                                                           \
+        if (subgroupElect())                                                        \
+            nbBase = atomicAdd(counter, subgroupBallotBitCount(nbBallot));          \
+        slot = subgroupBroadcastFirst(nbBase) + subgroupBallotExclusiveBitCount(nbBallot); \
+    }
+#else
+#define NB_APPEND_SLOT(counter, slot) { slot = atomicAdd(counter, 1u); }
+#endif
+
+#endif // NB_SUBGROUP_OPS_GLSL
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+// temporal_upscale.glsl
+//
+// Temporal upscale resolve: one invocation per display pixel. The current
+// color is reconstructed from the jittered render-resolution samples around
+// it (Gaussian weights on their distance to the pixel), the history is
+// reprojected through the nearest depth of that neighbourhood and clipped
+// to the samples' color box (YCoCg, mean +- sigma), then the two blend.
+// Colors are blended tonemapped so HDR highlights don't dominate. The
+// including shader declares the scene depth at set 0 binding 1 and defines
+// LoadSceneDepth(ivec2) (reverse-Z) before including this file.
+//------------------------------------------------------------------------------
+#ifndef NB_TEMPORAL_UPSCALE_GLSL
+#define NB_TEMPORAL_UPSCALE_GLSL
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(set = 0, binding = 0) uniform sampler2D sceneColor;
+layout(set = 0, binding = 2) uniform sampler2D historyColor;
+layout(set = 0, binding = 3, rgba16f) uniform writeonly image2D outputColor;
+
+layout(push_constant) uniform ResolveParams
+{
+    mat4 reprojection;  // current (unjittered) NDC + depth -> previous clip
+    vec4 jitter;        // xy = sub-pixel jitter in render pixels
+    ivec4 extents;      // xy = render extent, zw = output extent
+    vec4 params;        // x = history valid
+} pc;
+
+const float CLIP_SIGMA = 1.25;
+const float MAX_CURRENT_WEIGHT = 0.1;  // blend weight of a sample on the pixel center
+const float MIN_CURRENT_WEIGHT = 0.02;
+
+float Luma(vec3 c)
+{
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 Tonemap(vec3 c)
+{
+    return c / (1.0 + Luma(c));
+}
+
+vec3 TonemapInverse(vec3 c)
+{
+    return c / max(1.0 - Luma(c), 1e-4);
+}
+
+vec3 RGBToYCoCg(vec3 c)
+{
+    return vec3(0.25 * c.r + 0.5 * c.g + 0.25 * c.b,
+                0.5 * c.r - 0.5 * c.b,
+                -0.25 * c.r + 0.5 * c.g - 0.25 * c.b);
+}
+
+vec3 YCoCgToRGB(vec3 c)
+{
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Catmull-Rom from five bilinear taps: a single bilinear tap would soften
+// the history a little more every frame
+vec3 SampleHistory(vec2 uv, vec2 size)
+{
+    vec2 samplePos = uv * size;
+    vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+    vec2 f = samplePos - texPos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    vec2 w12 = w1 + w2;
+
+    vec2 texPos0 = (texPos1 - 1.0) / size;
+    vec2 texPos3 = (texPos1 + 2.0) / size;
+    vec2 texPos12 = (texPos1 + w2 / w12) / size;
+
+    vec3 result =
+        texture(historyColor, vec2(texPos12.x, texPos0.y)).rgb * (w12.x * w0.y) +
+        texture(historyColor, vec2(texPos0.x, texPos12.y)).rgb * (w0.x * w12.y) +
+        texture(historyColor, texPos12).rgb * (w12.x * w12.y) +
+        texture(historyColor, vec2(texPos3.x, texPos12.y)).rgb * (w3.x * w12.y) +
+        texture(historyColor, vec2(texPos12.x, texPos3.y)).rgb * (w12.x * w3.y);
+    float totalWeight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return max(result / totalWeight, vec3(0.0));
+}
+
+// Clip toward the box center rather than clamping per channel: keeps the
+// history's hue when it is only slightly out of range
+vec3 ClipToBox(vec3 history, vec3 boxMin, vec3 boxMax)
+{
+    vec3 center = 0.5 * (boxMax + boxMin);
+    vec3 extents = max(0.5 * (boxMax - boxMin), vec3(1e-4));
+    vec3 offset = history - center;
+    vec3 units = abs(offset / extents);
+    float maxUnit = max(units.x, max(units.y, units.z));
+    return (maxUnit > 1.0) ? center + offset / maxUnit : history;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 renderSize = pc.extents.xy;
+    ivec2 outputSize = pc.extents.zw;
+    if (any(greaterThanEqual(pixel, outputSize)))
+        return;
+
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(outputSize);
+
+    // This pixel's center in the jittered render: sample t covers the
+    // scene point (t + 0.5 - jitter)
+    vec2 renderPos = uv * vec2(renderSize);
+    ivec2 center = clamp(ivec2(floor(renderPos + pc.jitter.xy)), ivec2(0), renderSize - 1);
+
+    vec3 current = vec3(0.0);
+    float currentWeight = 0.0;
+    float nearestWeight = 0.0;
+    vec3 m1 = vec3(0.0);
+    vec3 m2 = vec3(0.0);
+    float closestDepth = 0.0;
+
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            ivec2 texel = clamp(center + ivec2(x, y), ivec2(0), renderSize - 1);
+            vec3 c = RGBToYCoCg(Tonemap(texelFetch(sceneColor, texel, 0).rgb));
+            m1 += c;
+            m2 += c * c;
+
+            // Gaussian (~Blackman-Harris width) in render pixels
+            vec2 d = (vec2(texel) + 0.5 - pc.jitter.xy) - renderPos;
+            float w = exp(-2.29 * dot(d, d));
+            current += c * w;
+            currentWeight += w;
+            nearestWeight = max(nearestWeight, w);
+
+            closestDepth = max(closestDepth, LoadSceneDepth(texel));
+        }
+    }
+    current /= max(currentWeight, 1e-4);
+
+    vec3 mean = m1 / 9.0;
+    vec3 sigma = sqrt(max(m2 / 9.0 - mean * mean, vec3(0.0)));
+    vec3 boxMin = mean - CLIP_SIGMA * sigma;
+    vec3 boxMax = mean + CLIP_SIGMA * sigma;
+
+    vec3 result = current;
+    vec4 prevClip = pc.reprojection * vec4(uv * 2.0 - 1.0, closestDepth, 1.0);
+    if (pc.params.x > 0.5 && prevClip.w > 0.0)
+    {
+        vec2 prevUV = (prevClip.xy / prevClip.w) * 0.5 + 0.5;
+        if (all(greaterThanEqual(prevUV, vec2(0.0))) && all(lessThanEqual(prevUV, vec2(1.0))))
+        {
+            vec3 history = RGBToYCoCg(Tonemap(SampleHistory(prevUV, vec2(outputSize))));
+            history = ClipToBox(history, boxMin, boxMax);
+
+            // Pixels far from any new sample (more so when upscaling) lean
+            // on the history longer
+            float alpha = max(MAX_CURRENT_WEIGHT * nearestWeight, MIN_CURRENT_WEIGHT);
+            result = mix(history, current, alpha);
+        }
+    }
+
+    imageStore(outputColor, pixel, vec4(TonemapInverse(max(YCoCgToRGB(result), vec3(0.0))), 1.0));
+}
+
+#endif // NB_TEMPORAL_UPSCALE_GLSL
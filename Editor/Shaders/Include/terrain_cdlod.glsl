@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+// terrain_cdlod.glsl
+//
+// CDLOD patch placement shared by every terrain vertex shader (Terrain,
+// TerrainShadow, TerrainShadowLayered), so all passes build bit-identical
+// geometry. The patch records and the morph come from cdlod_patch.glsl.
+//
+// Provides:
+//   cdlod_patch.glsl's patch records and morphing
+//   TerrainSurface / TerrainHeight / TerrainHeightmapUV / TerrainPatchVertex
+//
+// Requires `sampler2D heightmap` to be declared before inclusion - its set
+// differs between the scene and shadow pipelines. It is bound to the
+// terrain's surface map (TerrainSurface.comp): r = height, gb = height
+// gradient per heightmap uv unit.
+//------------------------------------------------------------------------------
+#ifndef NB_TERRAIN_CDLOD_GLSL
+#define NB_TERRAIN_CDLOD_GLSL
+
+#include "cdlod_patch.glsl"
+
+vec4 TerrainSurface(TerrainPatch tile, vec2 uv)
+{
+    // Clamp to avoid bleeding at edges (for a streamed window, into the
+    // spare tile slots - the sampler repeats, so uv may run past 1 there)
+    vec4 window = tile.heightmapWindow;
+    uv = clamp(uv, window.xy + window.w, window.xy + window.z - window.w);
+    return textureLod(heightmap, uv, 0.0);  // force mip 0
+}
+
+float TerrainHeight(TerrainPatch tile, vec2 uv)
+{
+    return TerrainSurface(tile, uv).r;
+}
+
+// Heightmap uv of a terrain-local XZ position
+vec2 TerrainHeightmapUV(TerrainPatch tile, vec2 local, float worldSize)
+{
+    return tile.heightmapWindow.xy + (local / worldSize + 0.5) * tile.heightmapWindow.z;
+}
+
+// Terrain-local displaced position of a grid vertex; uv receives the
+// heightmap coordinate it was sampled at and surface the sample itself
+vec3 TerrainPatchVertex(TerrainPatch tile, vec2 gridPos, float gridQuads,
+                        float worldSize, float heightScale, out vec2 uv, out vec4 surface)
+{
+    vec2 local = tile.offsetSize.xy + gridPos * tile.offsetSize.z;
+    uv = TerrainHeightmapUV(tile, local, worldSize);
+
+    // Morph factor from the unmorphed vertex's distance to the LOD camera
+    float h = TerrainHeight(tile, uv) * heightScale;
+    float k = CdlodMorphFactor(tile, vec3(local.x, h, local.y));
+
+    local = CdlodPatchXZ(tile, gridPos, gridQuads, k);
+    uv = TerrainHeightmapUV(tile, local, worldSize);
+    surface = TerrainSurface(tile, uv);
+    return vec3(local.x, surface.r * heightScale, local.y);
+}
+
+vec3 TerrainPatchVertex(TerrainPatch tile, vec2 gridPos, float gridQuads,
+                        float worldSize, float heightScale, out vec2 uv)
+{
+    vec4 surface;
+    return TerrainPatchVertex(tile, gridPos, gridQuads, worldSize, heightScale, uv, surface);
+}
+
+#endif // NB_TERRAIN_CDLOD_GLSL
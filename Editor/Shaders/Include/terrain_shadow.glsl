@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+// terrain_shadow.glsl
+//
+// The terrain's sun shadow map TerrainSunShadow.comp bakes (see
+// TerrainSunShadow.hpp): over the terrain's square, each texel holds the
+// lowest world height a point above it must reach to see the light past
+// the terrain. A receiver is lit above that height, fading in over the
+// penumbra, whatever it is - the terrain, a grass blade, a mesh.
+// TerrainSunShadowVisibility is the CPU twin.
+//
+// Provides:
+//   set 0, binding 6 -> terrainShadowMap
+//   TerrainSunShadow
+//
+// Requires scene_common.glsl (frame.terrainShadow).
+//------------------------------------------------------------------------------
+#ifndef NB_TERRAIN_SHADOW_GLSL
+#define NB_TERRAIN_SHADOW_GLSL
+
+layout(set = 0, binding = 6) uniform sampler2D terrainShadowMap;
+
+// Lit fraction of worldPos from the terrain; 1 off the terrain or without
+// a map
+float TerrainSunShadow(vec3 worldPos, TerrainShadowData data)
+{
+    if (data.window.z <= 0.0)
+        return 1.0;
+
+    vec2 uv = (worldPos.xz - data.window.xy) / data.window.z;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))))
+        return 1.0;
+
+    float shadowHeight = textureLod(terrainShadowMap, uv, 0.0).r;
+    return clamp((worldPos.y + data.params.x - shadowHeight) / max(data.params.y, 0.0001), 0.0, 1.0);
+}
+
+#endif // NB_TERRAIN_SHADOW_GLSL
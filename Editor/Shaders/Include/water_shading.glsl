@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+// water_shading.glsl
+//
+// Everything in Water.frag after #version, so the blended variant
+// (Water.frag) and the order-independent one (WaterOit.frag, which defines
+// NB_OIT_ACCUMULATE first - see oit.glsl) share one copy of the surface.
+//------------------------------------------------------------------------------
+#ifndef NB_WATER_SHADING_GLSL
+#define NB_WATER_SHADING_GLSL
+
+// ---- Set 0: Frame Uniforms ----
+layout(set = 0, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+    mat4 invView;
+    mat4 invProj;
+    vec4 reflection;  // yz = uv extent of the reflection target that was rendered
+    vec4 farGrassLod;       // (unused here; keeps the wind fields at their offsets)
+    vec4 farGrassDensity;
+    vec4 farGrassSlope;
+    vec4 windField;   // xy = window min corner, z = window side, w = baked
+    vec4 windDirection;
+    vec4 sceneFields[16];   // atmosphere..terrainShadow (unused here; keeps the lookup at its offset)
+    mat4 reflectionLookup;  // world position -> reflection target uv
+} frame;
+
+#include "wind_field.glsl"
+
+// ---- Set 1: Scene Lighting ----
+// Water only needs the sun (lights[0]) + ambient. The trailing shadowData block
+// member is intentionally omitted: std140 matches by offset, and everything Water
+// reads sits before shadowData, so dropping it keeps this in sync automatically as
+// the CSM ShadowData layout evolves (it has changed twice — cascadeRadii, extraParams).
+struct LightData {
+    vec4 position;
+    vec4 color;
+    vec4 attenuation;
+};
+layout(std140, set = 1, binding = 0) uniform SceneLighting {
+    LightData lights[16];
+    vec4 ambient;
+    int numLights;
+    int _pad1, _pad2, _pad3;
+} lighting;
+
+// ---- Set 2: Planar reflection target ----
+layout(set = 2, binding = 0) uniform sampler2D reflectionTex;
+
+// ---- Set 3: FFT ocean maps ----
+#include "ocean_waves.glsl"
+
+// ---- Push Constants ----
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData; // (waveAmplitude, waveSpeed, fresnelPower, alpha)
+} push;
+
+// ---- Inputs ----
+layout(location = 0) in vec3 fragWorldPos;
+layout(location = 1) in vec2 fragSurfaceXZ;  // before the FFT displacement
+
+// ---- Output (outColor, or the OIT pair under NB_OIT_ACCUMULATE) ----
+#include "oit.glsl"
+
+// Water body colors (shader-side defaults for v1; Phase C exposes these on the
+// editor panel). deep = looking straight down, shallow tints the Fresnel mix.
+const vec3 kDeepColor    = vec3(0.02, 0.10, 0.16);
+const vec3 kShallowColor = vec3(0.10, 0.28, 0.34);
+const vec3 kFoamColor    = vec3(0.85, 0.90, 0.92);
+
+void main()
+{
+    float waveAmplitude = push.customData.x;
+    float waveSpeed     = push.customData.y;
+    float fresnelPower   = max(push.customData.z, 0.5);
+    float alpha          = clamp(push.customData.w, 0.0, 1.0);
+
+    vec3 N = vec3(0.0, 1.0, 0.0);
+    float foam = 0.0;
+    if (OceanActive())
+    {
+        // ---- FFT ocean: every cascade's slope, sampled where the vertex
+        // started (the maps are indexed by the undisplaced surface) ----
+        OceanSurface(fragSurfaceXZ, N, foam);
+    }
+    else
+    {
+        // ---- Animated surface normal (the cheap "waves") ----
+        // Perturb the flat up-normal with a couple of scrolling sine lobes over
+        // world XZ. No vertex displacement — this only tilts the shading normal,
+        // which is enough to ripple the reflection and the specular highlight.
+        // Gusts in the wind field roughen the water as they cross it.
+        vec2 p = fragWorldPos.xz;
+        float t = frame.time.x * waveSpeed;
+        waveAmplitude *= WindPush(SampleWind(p, frame.windField));
+        N.x += waveAmplitude * (sin(p.x * 0.50 + t) + 0.5 * sin(p.x * 0.23 - p.y * 0.31 + t * 1.3));
+        N.z += waveAmplitude * (cos(p.y * 0.50 + t * 0.8) + 0.5 * sin(p.x * 0.17 + p.y * 0.40 + t * 0.9));
+        N = normalize(N);
+    }
+
+    vec3 V = normalize(frame.cameraPos.xyz - fragWorldPos);
+
+    // ---- Planar reflection lookup ----
+    // Points on the water plane are their own mirror images, so projecting
+    // the fragment with the camera the reflection was rendered with finds its
+    // reflected texel - this frame's camera, or an earlier one when the
+    // reflection is reused (WaterDesc::reflectionInterval). The lookup folds
+    // in the planar resolution fraction and the negative-height viewport's
+    // vertical flip (see ReflectionSchedule::BuildLookup).
+    vec4 reflClip = frame.reflectionLookup * vec4(fragWorldPos, 1.0);
+    vec2 reflUV = reflClip.xy / reflClip.w;
+    // Ripple the lookup by the surface normal's horizontal tilt, and keep it
+    // inside the region that was rendered (the bottom-left, flipped).
+    reflUV += N.xz * 0.04;
+    reflUV = clamp(reflUV, vec2(0.001, 1.001 - frame.reflection.z),
+        vec2(frame.reflection.y - 0.001, 0.999));
+    vec3 reflectionColor = texture(reflectionTex, reflUV).rgb;
+
+    // ---- Fresnel (Schlick): reflective at grazing angles ----
+    float NdotV = clamp(dot(N, V), 0.0, 1.0);
+    float fresnel = pow(1.0 - NdotV, fresnelPower);
+    fresnel = clamp(fresnel, 0.02, 1.0); // small base reflectivity even head-on
+
+    // Water body color (deep when looking down, shallower tint at grazing).
+    vec3 bodyColor = mix(kDeepColor, kShallowColor, fresnel);
+
+    vec3 color = mix(bodyColor, reflectionColor, fresnel);
+
+    // ---- Sun specular (directional light 0) ----
+    if (lighting.numLights > 0)
+    {
+        LightData sun = lighting.lights[0];
+        if (sun.position.w < 0.5) // directional
+        {
+            vec3 L = normalize(-sun.position.xyz);
+            vec3 H = normalize(L + V);
+            float NdotH = max(dot(N, H), 0.0);
+            float spec = pow(NdotH, 128.0);
+            color += sun.color.rgb * sun.color.a * spec;
+        }
+    }
+
+    // Foam sits on top: lit by the ambient and the sun, and opaque
+    if (foam > 0.0)
+    {
+        vec3 foamLight = lighting.ambient.rgb;
+        if (lighting.numLights > 0 && lighting.lights[0].position.w < 0.5)
+            foamLight += lighting.lights[0].color.rgb * lighting.lights[0].color.a *
+                max(dot(N, normalize(-lighting.lights[0].position.xyz)), 0.0);
+        color = mix(color, kFoamColor * foamLight, foam);
+        alpha = mix(alpha, 1.0, foam);
+    }
+
+    WriteColor(vec4(color, alpha));
+}
+
+#endif // NB_WATER_SHADING_GLSL
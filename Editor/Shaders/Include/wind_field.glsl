@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+// wind_field.glsl
+//
+// The wind field texture WindField.comp bakes each frame around the camera
+// (see WindField.hpp / Wind.hpp): rg = the sway wave as a phasor, b = the
+// gust push. Grass sways with it and the water ripples pick up its gusts,
+// one fetch each, so both agree on where a gust is.
+//
+// The window is toroidal: sampled with a repeating sampler at
+// worldXZ / window side. Positions outside the window take its edge. The
+// caller passes frame.windField (xy = window min corner, z = side, w = 0 for
+// still air), as Water.frag declares its own FrameUniforms.
+//
+// Provides:
+//   set 0, binding 2 -> windFieldMap
+//   WindSample, SampleWind, WindSway, WindPush
+//------------------------------------------------------------------------------
+#ifndef NB_WIND_FIELD_GLSL
+#define NB_WIND_FIELD_GLSL
+
+// Mirrors Wind::FIELD_RESOLUTION
+const float WIND_FIELD_RESOLUTION = 64.0;
+
+layout(set = 0, binding = 2) uniform sampler2D windFieldMap;
+
+struct WindSample
+{
+    vec2  sway;   // amplitude * (cos theta, sin theta)
+    float gust;
+};
+
+WindSample SampleWind(vec2 worldXZ, vec4 window)
+{
+    WindSample wind;
+    wind.sway = vec2(0.0);
+    wind.gust = 0.0;
+    if (window.w < 0.5)
+        return wind;
+
+    // Half a texel in from the edge, so the bilinear footprint never
+    // straddles the seam where the window wraps
+    float halfTexel = 0.5 * window.z / WIND_FIELD_RESOLUTION;
+    vec2 p = clamp(worldXZ, window.xy + halfTexel, window.xy + window.z - halfTexel);
+    vec3 texel = textureLod(windFieldMap, p / window.z, 0.0).rgb;
+    wind.sway = texel.rg;
+    wind.gust = texel.b;
+    return wind;
+}
+
+// Wind::Sway: the sway of something whose own phase is `phase` radians
+float WindSway(WindSample wind, float phase)
+{
+    return wind.sway.y * cos(phase) + wind.sway.x * sin(phase);
+}
+
+// Wind::Push: steady push downwind plus the gusts
+float WindPush(WindSample wind)
+{
+    return 1.0 + wind.gust;
+}
+
+#endif // NB_WIND_FIELD_GLSL
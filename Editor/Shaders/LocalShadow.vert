@@ -0,0 +1,30 @@
+//------------------------------------------------------------------------------
+// LocalShadow.vert
+//
+// Point light shadow faces (LocalShadowMaps): like Shadow.vert, but the
+// face's view-projection comes in the push block instead of the frame
+// uniforms, so the six faces of every light share one pipeline and set 0.
+//------------------------------------------------------------------------------
+#version 450
+
+// Vertex input
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;     // Not used but must be declared
+layout(location = 2) in vec2 inTexCoord;   // Not used but must be declared
+
+// Per-instance transforms, shared with Mesh.vert (batched draws)
+layout(set = 0, binding = 1) readonly buffer InstanceBuffer {
+    mat4 models[];
+} instances;
+
+// Push constants: model holds the face's view-projection
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;
+} push;
+
+void main()
+{
+    vec4 worldPos = instances.models[gl_InstanceIndex] * vec4(inPosition, 1.0);
+    gl_Position = push.model * worldPos;
+}
@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+// MeshBindless.frag
+//
+// Mesh.frag for the bindless path: the albedo comes from the shared texture
+// array by slot (push.textureIndex) instead of a per-draw set 1. Shading is
+// identical - see mesh_shading.glsl.
+//------------------------------------------------------------------------------
+#version 450
+
+#include "bindless.glsl"  // set 1 texture array + material table (first: it enables an extension)
+#include "shadows.glsl"   // set 0 frame, set 2 lighting, set 3 shadowMap + CSM functions
+
+// ---- Push Constants (PushConstantData) ----
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;   // w > 0.01 => material-driven color (glass); xyz=tint, w=alpha
+    uint textureIndex;
+    uint materialIndex;
+} push;
+
+vec4 SampleAlbedo(vec2 uv)
+{
+    return SampleBindless(push.textureIndex, uv);
+}
+
+#include "mesh_shading.glsl"
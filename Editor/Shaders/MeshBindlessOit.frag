@@ -0,0 +1,27 @@
+//------------------------------------------------------------------------------
+// MeshBindlessOit.frag
+//
+// MeshBindless.frag writing the weighted-blended OIT accumulation/revealage pair
+// (oit.glsl) for the first subpass of the order-independent transparency
+// pass: glass drawn by the Transparent* pipelines' OIT twins.
+//------------------------------------------------------------------------------
+#version 450
+
+#define NB_OIT_ACCUMULATE
+#include "bindless.glsl"  // set 1 texture array + material table (first: it enables an extension)
+#include "shadows.glsl"   // set 0 frame, set 2 lighting, set 3 shadowMap + CSM functions
+
+// ---- Push Constants (PushConstantData) ----
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;   // w > 0.01 => material-driven color (glass); xyz=tint, w=alpha
+    uint textureIndex;
+    uint materialIndex;
+} push;
+
+vec4 SampleAlbedo(vec2 uv)
+{
+    return SampleBindless(push.textureIndex, uv);
+}
+
+#include "mesh_shading.glsl"
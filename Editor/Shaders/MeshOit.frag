@@ -0,0 +1,27 @@
+//------------------------------------------------------------------------------
+// MeshOit.frag
+//
+// Mesh.frag writing the weighted-blended OIT accumulation/revealage pair
+// (oit.glsl) for the first subpass of the order-independent transparency
+// pass: glass drawn by the Transparent* pipelines' OIT twins.
+//------------------------------------------------------------------------------
+#version 450
+
+#define NB_OIT_ACCUMULATE
+#include "shadows.glsl"   // set 0 frame, set 2 lighting, set 3 shadowMap + CSM functions
+
+// ---- Descriptor Set 1: Albedo texture ----
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+
+// ---- Push Constants ----
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;   // w > 0.01 => material-driven color (glass); xyz=tint, w=alpha
+} push;
+
+vec4 SampleAlbedo(vec2 uv)
+{
+    return texture(texSampler, uv);
+}
+
+#include "mesh_shading.glsl"
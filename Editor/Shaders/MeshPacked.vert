@@ -0,0 +1,10 @@
+//------------------------------------------------------------------------------
+// MeshPacked.vert
+//
+// Mesh.vert over compressed vertices (VertexPNTPacked: unorm16 position,
+// octahedral snorm16 normal, half-float UV)
+//------------------------------------------------------------------------------
+#version 450
+
+#define PACKED_VERTEX
+#include "mesh_vertex.glsl"
@@ -0,0 +1,39 @@
+//------------------------------------------------------------------------------
+// OitComposite.frag
+//
+// Second subpass of the order-independent transparency pass: resolves the
+// weighted-blended accumulation/revealage pair the first subpass wrote
+// (oit.glsl) over the scene color, drawn with PostProcess.vert's full-screen
+// triangle and blended SrcAlpha / OneMinusSrcAlpha:
+//   color = accumulation.rgb / accumulation.a  (weighted average of layers)
+//   alpha = 1 - revealage                      (total coverage)
+//
+// Set 0 - the two attachments as input attachments (same pixel only, so no
+// sampler; under MSAA these are the single-sample resolves).
+//------------------------------------------------------------------------------
+#version 450
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput accumulation;
+layout(input_attachment_index = 1, set = 0, binding = 1) uniform subpassInput revealage;
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    float reveal = subpassLoad(revealage).r;
+
+    // Nothing transparent covered this pixel
+    if (reveal >= 0.9999)
+        discard;
+
+    vec4 accum = subpassLoad(accumulation);
+
+    // A pile of bright, near layers can still overflow half floats
+    if (any(isinf(accum)))
+        accum.rgb = vec3(accum.a);
+
+    vec3 average = accum.rgb / max(accum.a, 1e-5);
+    outColor = vec4(average, 1.0 - reveal);
+}
@@ -0,0 +1,10 @@
+//------------------------------------------------------------------------------
+// Particle.frag
+//
+// Soft round particle, premultiplied-alpha blended so additive and
+// translucent emitters share the pipeline. The body is in
+// particle_shading.glsl, shared with ParticleOit.frag.
+//------------------------------------------------------------------------------
+#version 450
+
+#include "particle_shading.glsl"
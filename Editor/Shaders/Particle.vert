@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+// Particle.vert
+//
+// Camera-facing billboard for one particle of one ParticleSystem emitter.
+// No vertex/index buffer: the quad comes from gl_VertexIndex (6 verts per
+// instance), and gl_InstanceIndex indexes the emitter's current alive list
+// (the instance count came from ParticleSimulate.comp's finalize pass). With
+// a stretch the quad's long axis follows the particle's screen-space motion
+// (rain streaks, sparks); otherwise it is square to the camera.
+//
+// Descriptor sets:
+//   set 0 - FrameUniforms (view, proj)
+//   set 1 - particle storage: particles, alive lists, -, counters (vertex+compute visible)
+// Push constants (ParticleSystem::SubmitDraw):
+//   model[0] = color at birth, model[1] = color at death
+//   model[2] = size scale at death, stretch (s), additive, -
+//   model[3] = emitter centre (for the sort only)
+//   customData = emitter index, slice base, fade-in, fade-out (life fractions)
+//------------------------------------------------------------------------------
+#version 450
+
+layout(set = 0, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+} frame;
+
+layout(set = 1, binding = 0, std430) readonly buffer ParticleBuffer {
+    vec4 data[];
+} particles;
+
+layout(set = 1, binding = 1, std430) readonly buffer AliveBuffer {
+    uint indices[];
+} alive;
+
+layout(set = 1, binding = 3, std430) readonly buffer CounterBuffer {
+    uint counters[];
+} counts;
+
+layout(push_constant) uniform ParticleDraw {
+    mat4 model;
+    vec4 customData;
+    uint textureIndex;
+    uint materialIndex;
+    uint padding[2];
+} draw;
+
+layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) flat out float outAdditive;
+
+const vec2 kCorners[4] = vec2[4](
+    vec2(-0.5, -0.5),
+    vec2(-0.5,  0.5),
+    vec2( 0.5,  0.5),
+    vec2( 0.5, -0.5)
+);
+const vec2 kUVs[4] = vec2[4](
+    vec2(0.0, 1.0),
+    vec2(0.0, 0.0),
+    vec2(1.0, 0.0),
+    vec2(1.0, 1.0)
+);
+const int kIndices[6] = int[6](0, 1, 2, 0, 2, 3);
+
+void main()
+{
+    int cornerIndex = kIndices[gl_VertexIndex % 6];
+    vec2 corner = kCorners[cornerIndex];
+    outUV = kUVs[cornerIndex];
+
+    uint emitter = uint(draw.customData.x);
+    uint base = uint(draw.customData.y);
+    uint current = counts.counters[emitter * 4u + 3u];
+    uint capacity = uint(alive.indices.length()) / 2u;
+    uint slot = alive.indices[current * capacity + base + uint(gl_InstanceIndex)];
+
+    vec4 positionAge = particles.data[slot * 3u + 0u];
+    vec4 velocityLifetime = particles.data[slot * 3u + 1u];
+    vec4 sizeRandom = particles.data[slot * 3u + 2u];
+
+    float life = clamp(positionAge.w / max(velocityLifetime.w, 1e-3), 0.0, 1.0);
+    float size = sizeRandom.x * mix(1.0, draw.model[2].x, life);
+
+    vec3 cameraRight = vec3(frame.view[0][0], frame.view[1][0], frame.view[2][0]);
+    vec3 cameraUp    = vec3(frame.view[0][1], frame.view[1][1], frame.view[2][1]);
+    vec3 right = cameraRight * size;
+    vec3 up = cameraUp * size;
+
+    // Streak: the quad's up axis along the motion across the view, as long
+    // as the distance covered in `stretch` seconds
+    float stretch = draw.model[2].y;
+    if (stretch > 0.0)
+    {
+        vec3 toCamera = normalize(frame.cameraPos.xyz - positionAge.xyz);
+        vec3 motion = velocityLifetime.xyz - toCamera * dot(velocityLifetime.xyz, toCamera);
+        float speed = length(motion);
+        if (speed > 1e-4)
+        {
+            vec3 axis = motion / speed;
+            up = axis * (size + speed * stretch);
+            right = normalize(cross(axis, toCamera)) * size;
+        }
+    }
+
+    vec3 worldPos = positionAge.xyz + right * corner.x + up * corner.y;
+    gl_Position = frame.proj * frame.view * vec4(worldPos, 1.0);
+
+    float fadeIn = clamp(life / draw.customData.z, 0.0, 1.0);
+    float fadeOut = clamp((1.0 - life) / draw.customData.w, 0.0, 1.0);
+    vec4 color = mix(draw.model[0], draw.model[1], life);
+    outColor = vec4(color.rgb, color.a * fadeIn * fadeOut);
+    outAdditive = draw.model[2].z;
+}
@@ -0,0 +1,28 @@
+//------------------------------------------------------------------------------
+// PostProcessCopy.frag
+//
+// Draws PostProcess.comp's output into the swapchain's scene viewport rect
+// (pixel for pixel unless the scene has a resolution scale) when the
+// compute post pass is on; the UI is drawn on top in the same pass. The
+// output is sRGB-encoded in an 8-bit UNORM image, so decode it here and let
+// the sRGB swapchain encode it again on write.
+//------------------------------------------------------------------------------
+#version 450
+
+layout(location = 0) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D postProcessed;
+
+vec3 SrgbToLinear(vec3 c)
+{
+    vec3 lo = c / 12.92;
+    vec3 hi = pow((c + 0.055) / 1.055, vec3(2.4));
+    return mix(hi, lo, lessThanEqual(c, vec3(0.04045)));
+}
+
+void main()
+{
+    vec3 color = texture(postProcessed, inUV).rgb;
+    outColor = vec4(SrgbToLinear(color), 1.0);
+}
@@ -20,6 +20,11 @@ layout(set = 0, binding = 0) uniform FrameUniforms {
     vec4 cameraPos;
 } frame;
 
+// Per-instance transforms, shared with Mesh.vert (batched draws)
+layout(set = 0, binding = 1) readonly buffer InstanceBuffer {
+    mat4 models[];
+} instances;
+
 // Push constants
 layout(push_constant) uniform PushConstants {
     mat4 model;
@@ -31,6 +36,6 @@ void main()
     // Transform vertex to clip space using light's view-projection
     // Note: For shadow pass, frame.view and frame.proj should be set to 
     // the light's view and projection matrices
-    vec4 worldPos = push.model * vec4(inPosition, 1.0);
+    vec4 worldPos = instances.models[gl_InstanceIndex] * vec4(inPosition, 1.0);
     gl_Position = frame.proj * frame.view * worldPos;
 }
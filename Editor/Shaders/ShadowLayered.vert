@@ -0,0 +1,45 @@
+//------------------------------------------------------------------------------
+// ShadowLayered.vert
+//
+// Single-pass cascaded shadows: one draw covers every cascade it reaches.
+// The CPU multiplies instanceCount by the number of target cascades; each
+// block of instanceCount instances goes to the next cascade in cascadeList
+// (2 bits per cascade) through gl_Layer.
+//------------------------------------------------------------------------------
+#version 450
+#extension GL_ARB_shader_viewport_layer_array : require
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;     // Not used but must be declared
+layout(location = 2) in vec2 inTexCoord;   // Not used but must be declared
+
+// Every cascade's light view-projection (Renderer::m_ShadowLayeredUniforms)
+layout(set = 0, binding = 0) uniform ShadowCascades {
+    mat4 viewProj[4];
+} cascades;
+
+// Per-instance transforms, shared with Mesh.vert (batched draws)
+layout(set = 0, binding = 1) readonly buffer InstanceBuffer {
+    mat4 models[];
+} instances;
+
+// Same 96-byte block as PushConstantData; the trailing words carry the fan-out
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;
+    uint firstInstance;
+    uint instanceCount;
+    uint cascadeList;
+    uint cascadeCount;
+} push;
+
+void main()
+{
+    uint local = uint(gl_InstanceIndex) - push.firstInstance;
+    uint slot = local / push.instanceCount;
+    uint cascade = (push.cascadeList >> (2u * slot)) & 3u;
+
+    vec4 worldPos = instances.models[push.firstInstance + local % push.instanceCount] * vec4(inPosition, 1.0);
+    gl_Position = cascades.viewProj[cascade] * worldPos;
+    gl_Layer = int(cascade);
+}
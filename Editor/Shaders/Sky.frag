@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// Sky.frag
+//
+// The sky behind everything: the sky-view LUT (sky.glsl) along each pixel's
+// view ray, with the clear colour as its floor so night keeps its tint.
+// Drawn first in the main and reflection passes over Clouds.vert's
+// far-plane triangle, so the depth test keeps it behind the scene and the
+// water reflects it. Without an atmosphere (sun.w == 0) it is the clear
+// colour.
+//
+// Descriptor sets:
+//   set 0 - FrameUniforms + the sky-view LUT (binding 3)
+//------------------------------------------------------------------------------
+#version 450
+
+#include "atmosphere.glsl"
+
+// ---- Set 0: Frame Uniforms (down to the sky's fields) ----
+layout(set = 0, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+    mat4 invView;
+    mat4 invProj;
+    vec4 reflection;
+    vec4 farGrassLod;       // (unused here; keeps the sky's fields at their offsets)
+    vec4 farGrassDensity;
+    vec4 farGrassSlope;
+    vec4 windField;
+    vec4 windDirection;
+    AtmosphereData atmosphere;
+    vec4 skyColor;          // rgb = the clear colour
+} frame;
+
+#include "sky.glsl"
+
+layout(location = 0) in vec2 inNDC;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    vec3 floorColor = frame.skyColor.rgb;
+    if (frame.atmosphere.sun.w <= 0.0)
+    {
+        outColor = vec4(floorColor, 1.0);
+        return;
+    }
+
+    // The same view-ray reconstruction as CloudRaymarch
+    vec4 viewSpacePos = frame.invProj * vec4(inNDC, 1.0, 1.0);
+    viewSpacePos /= viewSpacePos.w;
+    vec3 rayDir = normalize((frame.invView * vec4(normalize(viewSpacePos.xyz), 0.0)).xyz);
+
+    outColor = vec4(max(SkyLuminance(rayDir), floorColor), 1.0);
+}
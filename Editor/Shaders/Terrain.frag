@@ -3,27 +3,34 @@
 //
 // Fragment shader for GPU-displaced terrain.
 // Receives interpolated world position and normal from Terrain.vert.
-// Applies simple diffuse + specular lighting and PCF shadow lookup —
-// matching the visual style of the Mesh pipeline.
+// Takes its albedo and normal from the terrain's virtual texture where it
+// has pages; elsewhere blends grass, dirt and rock by the baked material
+// map. Then applies simple diffuse + specular lighting and PCF shadow
+// lookup — matching the visual style of the Mesh pipeline. Past the grass blades' distance LOD, flat
+// ground takes on the blades' colour (FarGrassCoverage).
+// Distant ground fades into the sky through the aerial perspective froxels.
 //
 // Descriptor sets:
-//   set 0 - FrameUBO  (cameraPos)
+//   set 0 - FrameUBO  (cameraPos) + aerial perspective froxels (binding 4)
 //   set 1 - albedo texture (terrain colour / grass texture)
-//   set 2 - SceneLightingData
+//   set 2 - SceneLightingData + clustered point lights
 //   set 3 - shadow map sampler
-//   set 4 - heightmap (vertex stage — not used here)
+//   set 4 - surface map (vertex stage — not used here) + material map (binding 1)
+//           + virtual texture albedo / normal pages (bindings 2-3)
 //------------------------------------------------------------------------------
 
 #version 450
 
 #include "shadows.glsl"   // set 0 frame, set 2 lighting, set 3 shadowMap + CSM functions
+#include "grass_field.glsl"   // density field + blade colours for the far field
+#include "sky.glsl"           // aerial perspective: the haze toward the horizon
 
 // ---------------------------------------------------------------------------
 // Inputs from vertex shader
 // ---------------------------------------------------------------------------
 layout(location = 0) in vec3 inWorldPos;
 layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inTexCoord;
+layout(location = 2) in vec2 inTexCoord;      // surface / material map uv
 layout(location = 3) in vec4 inShadowCoord;   // World position, passed through
 
 // ---------------------------------------------------------------------------
@@ -38,6 +45,13 @@ layout(set = 1, binding = 0) uniform sampler2D uGrassTex;
 layout(set = 1, binding = 1) uniform sampler2D uDirtTex;
 layout(set = 1, binding = 2) uniform sampler2D uRockTex;
 
+// Grass / dirt / rock weights per heightmap texel (TerrainSurface.comp)
+layout(set = 4, binding = 1) uniform sampler2D uMaterialMap;
+
+// The virtual texture's pages, one clipmap level per layer (TerrainVirtualPage.comp)
+layout(set = 4, binding = 2) uniform sampler2DArray uVirtualAlbedo;
+layout(set = 4, binding = 3) uniform sampler2DArray uVirtualNormal;
+
 // ---------------------------------------------------------------------------
 // Push constants
 // ---------------------------------------------------------------------------
@@ -48,65 +62,126 @@ layout(push_constant) uniform PushConstants
 } pc;
 
 // ---------------------------------------------------------------------------
-// Terrain material blending
+// Terrain material blending: the weights were baked per heightmap texel
+// (TerrainSurface.comp, TerrainMaterial.hpp), so a layer without weight here
+// costs nothing. Over most of the terrain one layer carries all of it and
+// this takes a single sample. The world derivatives are taken by the
+// caller, before any branch that may diverge across a quad.
 // ---------------------------------------------------------------------------
-vec3 SampleTerrainAlbedo(vec3 worldPos, vec3 worldNormal)
+vec3 SampleTerrainAlbedo(vec3 worldPos, vec2 materialUV, vec2 worldDx, vec2 worldDy)
 {
-    vec3 N = normalize(worldNormal);
-
     float tileScale = 0.08;
     vec2 uv = worldPos.xz * tileScale;
+    vec2 uvDx = worldDx * tileScale;
+    vec2 uvDy = worldDy * tileScale;
+
+    vec3 weights = textureLod(uMaterialMap, materialUV, 0.0).rgb;
+
+    vec3 albedo = vec3(0.0);
+    if (weights.r > 0.0)
+        albedo += textureGrad(uGrassTex, uv, uvDx, uvDy).rgb * weights.r;
+    if (weights.g > 0.0)
+        albedo += textureGrad(uDirtTex, uv, uvDx, uvDy).rgb * weights.g;
+    if (weights.b > 0.0)
+        albedo += textureGrad(uRockTex, uv, uvDx, uvDy).rgb * weights.b;
+
+    // Filtering between texels keeps the sum at 1; this only guards a map
+    // not baked yet
+    return albedo / max(weights.r + weights.g + weights.b, 0.0001);
+}
 
-    vec3 grass = texture(uGrassTex, uv).rgb;
-    vec3 dirt  = texture(uDirtTex,  uv).rgb;
-    vec3 rock  = texture(uRockTex,  uv).rgb;
+// ---------------------------------------------------------------------------
+// Runtime virtual texture (TerrainVirtualTexture.hpp): the albedo and normal
+// TerrainVirtualPage.comp rendered for this point, from the finest clipmap
+// level whose texels are no smaller than the pixel's footprint and whose
+// resident window holds it a texel in from the edge (TerrainVirtualLevelFor
+// and TerrainVirtualTexture::Covers are the CPU twins). False where no level
+// does; the caller blends the layers itself there.
+// ---------------------------------------------------------------------------
+bool SampleTerrainVirtual(vec3 worldPos, float footprint, out vec3 albedo, out vec3 normal)
+{
+    albedo = vec3(0.0);
+    normal = vec3(0.0, 1.0, 0.0);
 
-    float slope = 1.0 - dot(N, vec3(0,1,0));
-    slope = clamp(slope * 1.5, 0.0, 1.0);
+    int levels = int(frame.terrainVirtual.config.w);
+    if (levels == 0)
+        return false;
 
-    float terrainBaseY = pc.model[3].y;
-    float localHeight = worldPos.y - terrainBaseY;
-    float normalizedHeight = clamp(localHeight / max(pc.customData.x, 0.001), 0.0, 1.0);
+    float pageWorldSize = frame.terrainVirtual.config.x;
+    float pageTexels = frame.terrainVirtual.config.y;
+    float radius = frame.terrainVirtual.config.z;
+    float margin = 1.0 / pageTexels;
 
-    float breakup = texture(uRockTex, uv * 0.02).r;
-    breakup = (breakup - 0.5) * 0.15;
+    float ratio = footprint * pageTexels / pageWorldSize;
+    int first = ratio <= 1.0 ? 0 : int(ceil(log2(ratio)));
 
-    float grassFactor =
-    (1.0 - slope) *
-    smoothstep(0.0, 0.5, 1.0 - normalizedHeight);
+    for (int level = first; level < levels; ++level)
+    {
+        ivec4 window = frame.terrainVirtual.levels[level];
+        if (window.z == 0)
+            continue;
+
+        float levelPageSize = pageWorldSize * exp2(float(level));
+        vec2 page = worldPos.xz / levelPageSize;
+        vec2 offset = page - vec2(window.xy);
+        if (any(lessThan(offset, vec2(-radius + margin))) || any(greaterThan(offset, vec2(radius + 1.0 - margin))))
+            continue;
+
+        // Page p lives in slot p mod slots, so the whole layer repeats every
+        // slots pages (REPEAT sampler)
+        vec3 uvw = vec3(page / (2.0 * radius + 2.0), float(level));
+        albedo = textureLod(uVirtualAlbedo, uvw, 0.0).rgb;
+        albedo *= albedo;   // stored square-rooted
+        vec2 xz = textureLod(uVirtualNormal, uvw, 0.0).rg * 2.0 - 1.0;
+        normal = vec3(xz.x, sqrt(max(1.0 - dot(xz, xz), 0.0)), xz.y);
+        return true;
+    }
+    return false;
+}
 
-    float rockFactor =
-    smoothstep(0.2, 0.6, slope) +
-    smoothstep(0.6, 1.0, normalizedHeight);
+// ---------------------------------------------------------------------------
+// Far-field grass (GrassDesc::farField): how much of the blades' look this
+// fragment takes on. The share of blades the distance LOD has dropped here,
+// times the same density test, slope fade and waterline as the blades
+// themselves. The density edge widens with the fragment's footprint on the
+// noise so distant patches don't alias.
+// ---------------------------------------------------------------------------
+float FarGrassCoverage(vec3 worldPos, vec3 N)
+{
+    if (frame.farGrassLod.w < 0.5)
+        return 0.0;
 
-    float dirtFactor =
-    smoothstep(0.2, 0.5, normalizedHeight) *
-    (1.0 - slope);  
+    // Derivatives before any non-uniform branch
+    vec2 noisePos = worldPos.xz * frame.farGrassDensity.x;
+    float footprint = length(fwidth(noisePos));
 
-    grassFactor += breakup;
-    dirtFactor  -= breakup * 0.5;
+    float dist = length(frame.cameraPos.xyz - worldPos);
+    float dropped = smoothstep(frame.farGrassLod.x, frame.farGrassLod.y, dist);
+    if (dropped <= 0.0)
+        return 0.0;
 
-    // sharpen
-    grassFactor = pow(grassFactor, 3.5);
-    dirtFactor  = pow(dirtFactor, 3.5);
-    rockFactor  = pow(rockFactor, 3.5);
+    float slope = smoothstep(frame.farGrassSlope.x, frame.farGrassSlope.y, N.y);
+    float water = frame.time.z > 0.5 ? smoothstep(frame.time.y - 0.2, frame.time.y + 0.4, worldPos.y) : 1.0;
 
-    grassFactor = max(grassFactor, 0.0);
-    dirtFactor  = max(dirtFactor,  0.0);
-    rockFactor  = max(rockFactor,  0.0);
+    float density = Fbm2D(noisePos, floatBitsToUint(frame.farGrassDensity.z), uint(frame.farGrassDensity.w));
+    float edge = clamp(footprint * 0.5, 0.02, 0.25);
+    float kept = smoothstep(frame.farGrassDensity.y - edge, frame.farGrassDensity.y + edge, density);
 
-    // normalize
-    float total = grassFactor + dirtFactor + rockFactor;
-    grassFactor /= total;
-    dirtFactor  /= total;
-    rockFactor  /= total;
+    return dropped * slope * water * kept * frame.farGrassLod.z;
+}
 
-    vec3 albedo =
-        grass * grassFactor +
-        dirt  * dirtFactor +
-        rock  * rockFactor;
+// Point light, linear-ish falloff to zero at the radius; NdotL floored so
+// slopes facing away still pick up a little of a nearby light
+vec3 TerrainPointLight(vec3 N, vec3 worldPos, vec4 position, vec4 color, float radius)
+{
+    vec3  toLight = position.xyz - worldPos;
+    float dist    = length(toLight);
+    if (dist >= radius) return vec3(0.0);
 
-    return albedo;
+    vec3  Lp     = toLight / max(dist, 0.0001);
+    float att    = (1.0 - smoothstep(0.0, radius, dist)) * LocalLightShadow(position, worldPos, N);
+    float NdotLp = max(dot(N, Lp), 0.05);
+    return color.xyz * color.w * NdotLp * att;
 }
 
 // ---------------------------------------------------------------------------
@@ -119,7 +194,23 @@ void main()
     vec3 N = normalize(inNormal);
     vec3 V = normalize(frame.cameraPos.xyz - inWorldPos);
 
-    vec3 albedo = SampleTerrainAlbedo(inWorldPos, N);
+    // Derivatives before the branch below
+    vec2 worldDx = dFdx(inWorldPos.xz);
+    vec2 worldDy = dFdy(inWorldPos.xz);
+    float footprint = max(length(worldDx), length(worldDy));
+
+    vec3 albedo;
+    vec3 virtualNormal;
+    if (SampleTerrainVirtual(inWorldPos, footprint, albedo, virtualNormal))
+        N = virtualNormal;
+    else
+        albedo = SampleTerrainAlbedo(inWorldPos, inTexCoord, worldDx, worldDy);
+
+    // Far-field grass: the canopy's colour (mostly tips, a little root
+    // showing through) and the blades' up-biased shading normal
+    float farGrass = FarGrassCoverage(inWorldPos, N);
+    albedo = mix(albedo, mix(GRASS_ROOT_COLOR, GRASS_TIP_COLOR, 0.65) * 0.85, farGrass);
+    N = normalize(mix(N, vec3(0.0, 1.0, 0.0), 0.4 * farGrass));
 
     vec3 ambient = lighting.ambient.xyz * lighting.ambient.w * albedo.rgb;
 
@@ -138,25 +229,29 @@ void main()
                    * spec * shadow * 0.1;
 
     vec3 pointContrib = vec3(0.0);
-    for (int i = 0; i < lighting.numLights && i < 16; ++i)
+    if (ClusteredLightsActive())
     {
-        // Skip directional lights (w == 0)
-        if (lighting.lights[i].position.w < 0.5) continue;
-
-        vec3  toLight = lighting.lights[i].position.xyz - inWorldPos;
-        float dist    = length(toLight);
-        float radius  = lighting.lights[i].attenuation.w;
-        if (dist < radius)
+        uint cluster = FragmentLightCluster(inWorldPos);
+        uint count = lightClusters.counts[cluster];
+        for (uint j = 0u; j < count; ++j)
         {
-            vec3  Lp     = normalize(toLight);
-            float att    = 1.0 - smoothstep(0.0, radius, dist);
-            float NdotLp = max(dot(N, Lp), 0.05);
-            pointContrib += lighting.lights[i].color.xyz
-                          * lighting.lights[i].color.w
-                          * NdotLp * att * albedo.rgb;
+            ClusterLight light = clusterLights.lights[lightClusters.indices[cluster * LIGHT_CLUSTER_MAX_LIGHTS + j]];
+            pointContrib += TerrainPointLight(N, inWorldPos, light.position, light.color, light.attenuation.w);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < lighting.numLights && i < MAX_LIGHTS; ++i)
+        {
+            // Skip directional lights (w == 0)
+            if (lighting.lights[i].position.w < 0.5) continue;
+
+            pointContrib += TerrainPointLight(N, inWorldPos, lighting.lights[i].position,
+                lighting.lights[i].color, lighting.lights[i].attenuation.w);
         }
     }
+    pointContrib *= albedo.rgb;
 
-    vec3 finalColor = ambient + diffuse + specular + pointContrib;
+    vec3 finalColor = ApplyAerialPerspective(ambient + diffuse + specular + pointContrib, inWorldPos);
     outColor = vec4(ApplyCascadeDebug(finalColor, cascade), 1.0);
 }
\ No newline at end of file
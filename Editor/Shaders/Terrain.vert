@@ -1,28 +1,23 @@
 //------------------------------------------------------------------------------
 // Terrain.vert
 //
-// Vertex shader for GPU-displaced terrain.
-// Input: flat NxN grid with Y=0 (VertexPNT layout)
-// Displacement: samples heightmap at (texCoord) in vertex stage
-// Normals: computed via finite differences on the heightmap
+// Vertex shader for GPU-displaced CDLOD terrain.
+// Input: the shared patch grid's indices only (no vertex buffer, see
+//        grid_vertex.glsl), one instance per patch
+// Placement/morph: terrain_cdlod.glsl, from the instance's TerrainPatch
+// Displacement: samples the surface map in vertex stage
+// Normals: from the surface map's height gradient, same fetch as the height
 //
 // Descriptor set layout (matches Terrain pipeline layout):
-//   set 0 - FrameUniform  (view, proj, time, cameraPos)
+//   set 0 - FrameUniform  (view, proj, time, cameraPos) + TerrainPatch buffer
 //   set 1 - albedo texture (fragment only — unused here)
 //   set 2 - lighting UBO   (fragment only — unused here)
 //   set 3 - shadow map     (fragment only — unused here)
-//   set 4 - heightmap      (vertex stage — sampled here)
+//   set 4 - surface map    (vertex stage — sampled here)
 //------------------------------------------------------------------------------
 
 #version 450
 
-// ---------------------------------------------------------------------------
-// Vertex inputs (VertexPNT layout)
-// ---------------------------------------------------------------------------
-layout(location = 0) in vec3 inPosition;   // XZ grid position, Y = 0
-layout(location = 1) in vec3 inNormal;     // Unused — normals computed here
-layout(location = 2) in vec2 inTexCoord;   // [0,1] UV over the terrain patch
-
 // ---------------------------------------------------------------------------
 // Outputs to fragment shader
 // ---------------------------------------------------------------------------
@@ -31,6 +26,10 @@ layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outTexCoord;
 layout(location = 3) out vec4 outShadowCoord;
 
+// The depth prepass (TerrainDepth) runs this same shader; EQUAL in the color
+// pass needs both to produce the exact same depth
+invariant gl_Position;
+
 // ---------------------------------------------------------------------------
 // Descriptor sets
 // ---------------------------------------------------------------------------
@@ -44,47 +43,30 @@ layout(set = 0, binding = 0) uniform FrameUBO
 
 // set 1,2,3 are bound but not accessed in this stage
 
-// Heightmap — vertex-stage sampler (set 4)
+// Surface map (height + gradient, TerrainSurface.comp) — vertex-stage sampler (set 4)
 layout(set = 4, binding = 0) uniform sampler2D heightmap;
 
+#include "terrain_cdlod.glsl"   // set 0 binding 1 patches + TerrainHeight / TerrainPatchVertex
+
 // ---------------------------------------------------------------------------
 // Push constants
 // ---------------------------------------------------------------------------
 layout(push_constant) uniform PushConstants
 {
     mat4  model;
-    vec4  customData;   // x = heightScale, y = texelSize (1/gridResolution), zw = unused
+    vec4  customData;   // x = heightScale, y = 1/patch grid quads, z = worldSize, w = unused
 } pc;
 
 // ---------------------------------------------------------------------------
 // Helpers
 // ---------------------------------------------------------------------------
 
-float SampleHeight(vec2 uv)
-{
-    // Clamp to avoid bleeding at edges
-    uv = clamp(uv, vec2(0.001), vec2(0.999));
-    return textureLod(heightmap, uv, 0.0).r;  // force mip 0
-}
-
-vec3 ComputeNormal(vec2 uv, float texelSize, float heightScale, float worldSize)
+vec3 ComputeNormal(TerrainPatch tile, vec2 gradient, float heightScale, float worldSize)
 {
-    float sampleStep = texelSize * 2.0;
-
-    float hL = SampleHeight(uv + vec2(-sampleStep, 0.0));
-    float hR = SampleHeight(uv + vec2( sampleStep, 0.0));
-    float hD = SampleHeight(uv + vec2(0.0, -sampleStep));
-    float hU = SampleHeight(uv + vec2(0.0,  sampleStep));
-
-    // World-space horizontal distance between the two sample points
-    float worldStep = 2.0 * sampleStep * worldSize;
-
-    vec3 n = normalize(vec3(
-        (hL - hR) * heightScale,
-        worldStep,              // correct denominator
-        (hD - hU) * heightScale
-    ));
-    return n;
+    // gradient is height per heightmap uv unit; one uv unit spans
+    // worldSize / heightmapWindow.z world units
+    float slopeScale = heightScale * tile.heightmapWindow.z / worldSize;
+    return normalize(vec3(-gradient.x * slopeScale, 1.0, -gradient.y * slopeScale));
 }
 
 // ---------------------------------------------------------------------------
@@ -98,23 +80,23 @@ vec3 ComputeNormal(vec2 uv, float texelSize, float heightScale, float worldSize)
 void main()
 {
     float heightScale      = pc.customData.x;
-    float texelSize        = pc.customData.y;  // grid spacing (for displacement) // DEPRICATED?
+    float gridQuads        = 1.0 / pc.customData.y;  // patch grid spacing (for morphing)
     float worldSize        = pc.customData.z;
-    float hmapTexelSize    = pc.customData.w;  // heightmap spacing (for normals)
 
-    // Sample height and displace vertex up
-    float h = SampleHeight(inTexCoord) * heightScale;
-    vec3 displacedPos = inPosition + vec3(0.0, h, 0.0);
+    // Place, morph and displace this vertex within its patch
+    TerrainPatch tile = terrainPatches.patches[gl_InstanceIndex];
+    vec2 uv;
+    vec4 surface;
+    vec3 displacedPos = TerrainPatchVertex(tile, GridVertexUV(uint(round(gridQuads))), gridQuads, worldSize, heightScale, uv, surface);
 
     // Compute world-space position
     vec4 worldPos4 = pc.model * vec4(displacedPos, 1.0);
     outWorldPos  = worldPos4.xyz;
-    outTexCoord  = inTexCoord;
+    outTexCoord  = uv;
 
-    // Compute normal in object space, then transform to world space
-    vec3 objNormal = ComputeNormal(inTexCoord, hmapTexelSize, heightScale, worldSize);
-    mat3 normalMatrix = transpose(inverse(mat3(pc.model)));
-    outNormal = normalize(normalMatrix * objNormal);
+    // The model matrix is a translation (TerrainSystem::SubmitDraw), so the
+    // object-space normal is already the world-space one
+    outNormal = ComputeNormal(tile, surface.gb, heightScale, worldSize);
 
     // Shadow coordinate — pass world position; fragment shader handles projection
     outShadowCoord = worldPos4;  // Fragment shader will apply light matrix
@@ -3,10 +3,6 @@
 
 #version 450
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inTexCoord;
-
 layout(set = 0, binding = 0) uniform FrameUBO
 {
     mat4 view;
@@ -17,15 +13,18 @@ layout(set = 0, binding = 0) uniform FrameUBO
 
 layout(set = 1, binding = 0) uniform sampler2D heightmap;
 
+#include "terrain_cdlod.glsl"   // same patch placement as Terrain.vert
+
 layout(push_constant) uniform PushConstants
 {
     mat4 model;
-    vec4 customData; // x = heightScale, y = texelSize
+    vec4 customData; // x = heightScale, y = 1/patch grid quads, z = worldSize
 } pc;
 
 void main()
 {
-    float h = textureLod(heightmap, inTexCoord, 0.0).r * pc.customData.x;
-    vec3 displacedPos = inPosition + vec3(0.0, h, 0.0);
+    vec2 uv;
+    vec3 displacedPos = TerrainPatchVertex(terrainPatches.patches[gl_InstanceIndex],
+        GridVertexUV(uint(round(1.0 / pc.customData.y))), 1.0 / pc.customData.y, pc.customData.z, pc.customData.x, uv);
     gl_Position = frame.proj * frame.view * pc.model * vec4(displacedPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+//------------------------------------------------------------------------------
+// TerrainShadowLayered.vert
+//
+// TerrainShadow.vert for the single-pass cascade path: the patch instances
+// repeat once per target cascade, routed through gl_Layer (see
+// ShadowLayered.vert).
+//------------------------------------------------------------------------------
+#version 450
+#extension GL_ARB_shader_viewport_layer_array : require
+
+layout(set = 0, binding = 0) uniform ShadowCascades {
+    mat4 viewProj[4];
+} cascades;
+
+layout(set = 1, binding = 0) uniform sampler2D heightmap;
+
+#include "terrain_cdlod.glsl"   // same patch placement as Terrain.vert
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 customData;  // x = heightScale, y = 1/patch grid quads, z = worldSize
+    uint firstInstance;
+    uint instanceCount;
+    uint cascadeList;
+    uint cascadeCount;
+} pc;
+
+void main()
+{
+    uint local = uint(gl_InstanceIndex) - pc.firstInstance;
+    uint slot = local / pc.instanceCount;
+    uint cascade = (pc.cascadeList >> (2u * slot)) & 3u;
+
+    vec2 uv;
+    vec3 displacedPos = TerrainPatchVertex(terrainPatches.patches[pc.firstInstance + local % pc.instanceCount],
+        GridVertexUV(uint(round(1.0 / pc.customData.y))), 1.0 / pc.customData.y, pc.customData.z, pc.customData.x, uv);
+    gl_Position = cascades.viewProj[cascade] * pc.model * vec4(displacedPos, 1.0);
+    gl_Layer = int(cascade);
+}
@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+// TerrainTess.vert
+//
+// Vertex stage of the tessellated terrain (TerrainTessellated pipeline, see
+// TerrainTessellation.hpp). Places, morphs and displaces the coarse patch
+// grid exactly as Terrain.vert does. The corners TerrainTess.tese keeps are
+// therefore the vertices the untessellated terrain would have drawn.
+// Everything the later stages need from the push constants and the patch
+// record is handed on from here, so they read neither.
+//
+// Descriptor sets: as Terrain.vert
+//------------------------------------------------------------------------------
+
+#version 450
+
+// ---------------------------------------------------------------------------
+// Outputs to the control shader
+// ---------------------------------------------------------------------------
+layout(location = 0) out vec3 outWorldPos;
+layout(location = 1) out vec2 outUV;              // surface map uv, before TerrainSurface's clamp
+layout(location = 2) out vec3 outCameraOffset;    // outWorldPos - camera, for the edge factors
+layout(location = 3) out vec4 outUVWindow;        // TerrainSurface's clamp: xy = min, zw = max
+layout(location = 4) out vec4 outSurfaceParams;   // x = heightScale, y = slope scale, z = terrain base y, w = heightmap texel (world)
+layout(location = 5) out float outTessScale;      // proj[1][1] * TerrainTessScreenScale
+
+// ---------------------------------------------------------------------------
+// Descriptor sets
+// ---------------------------------------------------------------------------
+layout(set = 0, binding = 0) uniform FrameUBO
+{
+    mat4 view;
+    mat4 proj;
+    vec4 time;
+    vec4 cameraPos;
+} frame;
+
+layout(set = 4, binding = 0) uniform sampler2D heightmap;
+
+#include "terrain_cdlod.glsl"   // set 0 binding 1 patches + TerrainPatchVertex
+
+// ---------------------------------------------------------------------------
+// Push constants
+// ---------------------------------------------------------------------------
+layout(push_constant) uniform PushConstants
+{
+    mat4  model;
+    vec4  customData;   // x = heightScale, y = 1/patch grid quads, z = worldSize, w = TerrainTessScreenScale
+} pc;
+
+void main()
+{
+    float heightScale = pc.customData.x;
+    float gridQuads   = 1.0 / pc.customData.y;
+    float worldSize   = pc.customData.z;
+
+    TerrainPatch tile = terrainPatches.patches[gl_InstanceIndex];
+    vec2 uv;
+    vec4 surface;
+    vec3 displacedPos = TerrainPatchVertex(tile, GridVertexUV(uint(round(gridQuads))), gridQuads, worldSize, heightScale, uv, surface);
+
+    // Translation only (TerrainSystem::SubmitDraw)
+    outWorldPos = (pc.model * vec4(displacedPos, 1.0)).xyz;
+    outUV = uv;
+    outCameraOffset = outWorldPos - frame.cameraPos.xyz;
+
+    vec4 window = tile.heightmapWindow;
+    outUVWindow = vec4(window.xy + window.w, window.xy + window.z - window.w);
+
+    // Terrain.vert's ComputeNormal scale, and one texel of the surface map
+    float texelSize = worldSize / (window.z * float(textureSize(heightmap, 0).x));
+    outSurfaceParams = vec4(heightScale, heightScale * window.z / worldSize, pc.model[3].y, texelSize);
+    outTessScale = frame.proj[1][1] * pc.customData.w;
+}
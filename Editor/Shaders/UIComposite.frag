@@ -0,0 +1,20 @@
+//------------------------------------------------------------------------------
+// UIComposite.frag
+//
+// Lays the cached UI over the frame (PostProcess.vert's full-screen
+// triangle). The UI was drawn into a cleared target with ImGui's usual
+// blend, which leaves its color premultiplied by coverage; the pipeline
+// blends ONE / ONE_MINUS_SRC_ALPHA, so the result matches drawing the UI
+// straight onto the frame.
+//------------------------------------------------------------------------------
+#version 450
+
+layout(location = 0) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D uiCache;
+
+void main()
+{
+    outColor = texture(uiCache, inUV);
+}
@@ -0,0 +1,18 @@
+//------------------------------------------------------------------------------
+// UIOverlay.frag
+//
+// One ImGui draw command: its texture (the font atlas or an
+// ImGui_ImplVulkan_AddTexture image) times the vertex color
+//------------------------------------------------------------------------------
+#version 450
+
+layout(location = 0) in vec4 inColor;
+layout(location = 1) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D uiTexture;
+
+void main()
+{
+    outColor = inColor * texture(uiTexture, inUV);
+}
@@ -0,0 +1,28 @@
+//------------------------------------------------------------------------------
+// UIOverlay.vert
+//
+// ImGui's vertices (ImDrawVert: pos, uv, packed RGBA8 color) from
+// UIManager's per-frame buffer; scale/translate map ImGui's display space to
+// clip space, as in ImGui's own Vulkan backend.
+//------------------------------------------------------------------------------
+#version 450
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+
+layout(push_constant) uniform PushConstants
+{
+    vec2 scale;
+    vec2 translate;
+} pc;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outUV;
+
+void main()
+{
+    outColor = inColor;
+    outUV = inUV;
+    gl_Position = vec4(inPosition * pc.scale + pc.translate, 0.0, 1.0);
+}
@@ -1,13 +1,22 @@
 //------------------------------------------------------------------------------
 // Water.vert
 //
-// Transforms the flat water plane (a VertexPNT grid generated at Y=0, the same
-// generator the terrain uses). The push-constant model matrix lifts it to the
-// water surface height. No vertex displacement — the "waves" are an animated
-// normal perturbation in Water.frag, so this is a plain transform.
+// Places the flat water plane's LOD grid: one instance per CDLOD patch that
+// WaterSystem::UpdateLOD selected around the camera (cdlod_patch.glsl), each
+// a small grid built from gl_VertexIndex with no vertex buffer. Patches morph
+// onto the next-coarser level over the end of their range, so levels meet
+// without cracks. The push-constant model matrix lifts the plane to the water
+// surface height. In the Normals wave mode that is all: the "waves" are
+// an animated normal perturbation in Water.frag. In the FFT mode the vertices
+// are displaced by the ocean cascades (set 3, see OceanWaves); the fragment
+// shader gets the undisplaced position too, which is where the maps are
+// sampled for the normal.
 //------------------------------------------------------------------------------
 #version 450
 
+#include "ocean_waves.glsl"
+#include "cdlod_patch.glsl"
+
 // ---- Set 0: Frame Uniforms (scene camera) ----
 layout(set = 0, binding = 0) uniform FrameUniforms {
     mat4 view;
@@ -20,18 +29,30 @@ layout(set = 0, binding = 0) uniform FrameUniforms {
 layout(push_constant) uniform PushConstants {
     mat4 model;
     vec4 customData; // (waveAmplitude, waveSpeed, fresnelPower, alpha)
+    uint textureIndex;
+    uint materialIndex;
+    uint gridQuads;  // cells per side of one patch's grid
 } push;
 
-// ---- Vertex Inputs (VertexPNT) ----
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inTexCoord;
-
 // ---- Outputs ----
 layout(location = 0) out vec3 fragWorldPos;
+layout(location = 1) out vec2 fragSurfaceXZ;
 
 void main() {
-    vec4 worldPos = push.model * vec4(inPosition, 1.0);
+    TerrainPatch tile = terrainPatches.patches[gl_InstanceIndex];
+    vec2 gridPos = GridVertexUV(push.gridQuads);
+    float gridQuads = float(push.gridQuads);
+
+    // Flat plane: the morph is measured at the undisplaced surface, as the
+    // CPU selection does
+    vec2 local = tile.offsetSize.xy + gridPos * tile.offsetSize.z;
+    float k = CdlodMorphFactor(tile, vec3(local.x, 0.0, local.y));
+    local = CdlodPatchXZ(tile, gridPos, gridQuads, k);
+
+    vec4 worldPos = push.model * vec4(local.x, 0.0, local.y, 1.0);
+    fragSurfaceXZ = worldPos.xz;
+    if (OceanActive())
+        worldPos.xyz += OceanDisplacement(worldPos.xz);
     fragWorldPos = worldPos.xyz;
     gl_Position = frame.proj * frame.view * worldPos;
 }
@@ -0,0 +1,11 @@
+//------------------------------------------------------------------------------
+// WaterOit.frag
+//
+// Water.frag writing the weighted-blended OIT accumulation/revealage pair
+// (oit.glsl) for the first subpass of the order-independent transparency
+// pass. Same descriptor sets as Water.frag.
+//------------------------------------------------------------------------------
+#version 450
+
+#define NB_OIT_ACCUMULATE
+#include "water_shading.glsl"
@@ -15,9 +15,13 @@
 #include "Engine/Renderer/Model.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/AssetHotReload.hpp"
 #include "Engine/Core/Scene.hpp"
 #include "Engine/Core/SceneSerializer.hpp"
+#include "Engine/Core/SceneAutosave.hpp"
+#include "Engine/Core/IdleThrottle.hpp"
 #include "EditorFileUtils.hpp"
+#include "ShaderCompileService.hpp"
 #include "EditorContext.hpp"
 
 // Panels
@@ -36,6 +40,7 @@
 #include "Panels/TerrainEditorPanel.hpp"
 #include "Panels/GrassPanel.hpp"
 #include "Panels/FireflyPanel.hpp"
+#include "Panels/ParticlePanel.hpp"
 #include "Panels/CloudPanel.hpp"
 #include "Panels/WaterEditorPanel.hpp"
 
@@ -45,6 +50,7 @@
 #include <nlohmann/json.hpp>
 #include <memory>
 #include <filesystem>
+#include <chrono>
 
 // Check if docking is available
 #ifdef IMGUI_HAS_DOCK
@@ -55,27 +61,46 @@
 
 namespace Nightbloom {
 
+    // The console's lines. Added to the Logger before the engine starts
+    // (CreateApplication), so its startup lines show up too.
+    static std::shared_ptr<LogRingSink> s_ConsoleLog;
+
     class EditorApplication : public Application
     {
     public:
         EditorApplication() : Application("Nightbloom Editor")
         {
+            m_Console.SetSink(s_ConsoleLog);
             LOG_INFO("=== Nightbloom Editor Starting ===");
+
+            // Assets and shaders are edited on disk; a packed archive only
+            // fills in what isn't there
+            AssetManager::Get().SetPreferLooseFiles(true);
             SetupDefaultProject();
+            m_Autosave.Start();
         }
 
         ~EditorApplication()
         {
+            m_Autosave.Stop();
+            Editor::ShaderCompileService::Get().Shutdown();
+
             if (GetRenderer())
+            {
                 GetRenderer()->WaitForIdle();
+                GetRenderer()->SetAssetHotReload(false);
+            }
 
             // Cleanup panels that hold GPU resources before renderer goes away
             m_NoiseDebug.Cleanup();
+            m_Viewport.Cleanup();
             m_TerrainPanel.Cleanup();
             m_GrassPanel.Cleanup();
             m_FireflyPanel.Cleanup();
+            m_ParticlePanel.Cleanup();
             m_CloudPanel.Cleanup();
             m_WaterPanel.Cleanup();
+            m_AssetBrowser.Cleanup();
 
             m_EditorScene.reset();
             SaveEditorSettings();
@@ -92,6 +117,9 @@ namespace Nightbloom {
                 UpdateWindowTitle();
             }
 
+            InitShaderCompiler();
+            InitAssetHotReload();
+
             // Camera
             m_Camera = std::make_unique<Camera>();
             m_Camera->SetPosition(glm::vec3(3.0f, 3.0f, 3.0f));
@@ -107,16 +135,21 @@ namespace Nightbloom {
             Texture* defaultTex = resources ? resources->GetTexture("default_white") : nullptr;
 
             // Load ToyCar
-            auto toyCar = std::make_unique<Model>("ToyCar");
             std::string modelPath = AssetManager::Get().GetModelPath("ToyCar/ToyCar.gltf");
+            std::shared_ptr<Model> toyCar = resources->GetModelCache().Acquire(modelPath,
+                [&]() -> std::shared_ptr<Model>
+                {
+                    auto model = std::make_shared<Model>("ToyCar");
+                    if (!model->LoadFromFile(modelPath, resources, GetRenderer()->GetDescriptorManager()))
+                        return nullptr;
+                    return model;
+                });
 
-            if (toyCar->LoadFromFile(modelPath,
-                GetRenderer()->GetResourceManager(),
-                GetRenderer()->GetDescriptorManager()))
+            if (toyCar)
             {
-                toyCar->SetScale(.012f);
-                toyCar->SetPosition(glm::vec3(-3.0f, -2.0f, -3.0f));
-                m_EditorScene->AddObject("ToyCar", std::move(toyCar), defaultTex);
+                SceneObject* obj = m_EditorScene->AddObject("ToyCar", std::move(toyCar), defaultTex);
+                obj->SetScale(.012f);
+                obj->SetPosition(glm::vec3(-3.0f, -2.0f, -3.0f));
                 LOG_INFO("Added ToyCar to scene");
             }
 
@@ -146,8 +179,7 @@ namespace Nightbloom {
                 obj2->pipeline = PipelineType::Mesh;
                 obj2->primitiveKind = PrimitiveKind::TestCube;
                 obj2->primitiveTexture = "default_white";
-                obj2->primitivePosition = glm::vec3(0.5f, 0.2f, -1.0f);
-                obj2->UpdatePrimitiveTransform();
+                obj2->SetPosition(glm::vec3(0.5f, 0.2f, -1.0f));
             }
 
             // Ground plane
@@ -168,7 +200,7 @@ namespace Nightbloom {
             //         m_EditorScene->AddPrimitive("Ground", std::move(groundPlane));
             //     groundObj->textureIndex = 1;
             //     groundObj->pipeline = PipelineType::Mesh;
-            //     groundObj->primitiveTransform = groundTransform;
+            //     groundObj->localTransform = groundTransform;
             // }
 
             // Lighting
@@ -220,7 +252,7 @@ namespace Nightbloom {
                         moon->AddTexture(white);
                     SceneObject* moonObj = m_EditorScene->AddPrimitive("Moon", std::move(moon));
                     moonObj->pipeline = PipelineType::Mesh;
-                    moonObj->primitiveTransform = moonTransform;
+                    moonObj->SetLocalTransform(moonTransform);
                     moonObj->primitiveKind = PrimitiveKind::MoonSphere;
                     moonObj->primitiveTexture = "default_white";
                     LOG_INFO("Added Moon to scene");
@@ -240,14 +272,23 @@ namespace Nightbloom {
             // Initialize panels
             m_ShaderCompiler.Initialize();
 
-            // Window resize -> update camera aspect
-            GetWindow()->SetResizeCallback([this](uint32_t width, uint32_t height) {
-                if (width > 0 && height > 0 && m_Camera)
-                {
-                    float aspect = static_cast<float>(width) / static_cast<float>(height);
-                    m_Camera->SetPerspectiveInfiniteReverseZ(45.0f, aspect, 0.1f);
-                }
-                });
+        }
+
+        // Render on demand: input, a widget being dragged or typed into,
+        // play mode or a pending scene op keep the full frame rate; otherwise
+        // IdleThrottle caps it by whether anything on screen moves by itself
+        bool ShouldRunFrame() override
+        {
+            const double now = NowSeconds();
+            InputSystem* input = GetInput();
+            if (input->HasFrameInput() || input->IsAnyDown() || ImGui::IsAnyItemActive() ||
+                m_Viewport.isPlayMode || m_PendingSceneLoad || m_PendingNewScene ||
+                Editor::ShaderCompileService::Get().IsRebuilding() || m_ShaderCompiler.HasPendingCompile() ||
+                m_TerrainPanel.IsRegenerating() || m_CloudPanel.IsRegenerating())
+            {
+                m_IdleThrottle.NotifyActivity(now);
+            }
+            return m_IdleThrottle.ShouldRunFrame(now, IsSceneAnimating());
         }
 
         void OnUpdate(float deltaTime) override
@@ -259,6 +300,23 @@ namespace Nightbloom {
             // free buffers this frame's draw list still references.
             ProcessPendingSceneOps();
 
+            // Effects the scene uses get their systems here, on first enable,
+            // and release them when disabled - also before the draw list
+            // is built, since a teardown waits for the GPU
+            m_TerrainPanel.ApplyEnabled(GetRenderer());
+            m_GrassPanel.ApplyEnabled(GetRenderer(), m_TerrainPanel.GetTerrainSystem());
+            m_FireflyPanel.ApplyEnabled(GetRenderer());
+            m_CloudPanel.ApplyEnabled(GetRenderer());
+            m_WaterPanel.ApplyEnabled(GetRenderer());
+
+            // Rebuilt SPIR-V is deployed; the pipelines swap in at a later BeginFrame
+            Editor::ShaderCompileService::RebuildStats shaderStats;
+            if (Editor::ShaderCompileService::Get().PollRebuild(shaderStats) && GetRenderer())
+                GetRenderer()->ReloadShaders();
+
+            if (m_Autosave.Tick(deltaTime))
+                AutosaveScene();
+
             // FPS tracking
             m_FrameTime += deltaTime;
             m_FrameCount++;
@@ -274,7 +332,8 @@ namespace Nightbloom {
             if (GetInput()->IsDown(InputCode::Mouse_Right))
             {
                 m_CameraControlActive = true;
-                glm::vec2 mouseDelta(GetInput()->GetMouseDeltaX(), GetInput()->GetMouseDeltaY());
+                // Every raw report since last frame, not the cursor's end point
+                glm::vec2 mouseDelta(GetInput()->GetMouseMotionX(), GetInput()->GetMouseMotionY());
                 m_Camera->SetRotationInput(glm::vec2(mouseDelta.x, -mouseDelta.y));
 
                 glm::vec3 moveInput(0.0f);
@@ -302,16 +361,32 @@ namespace Nightbloom {
 
             m_Camera->Update(deltaTime);
 
+            // A camera still gliding after its keys are released counts as activity
+            if (m_Camera->GetViewMatrix() != m_LastViewMatrix)
+            {
+                m_LastViewMatrix = m_Camera->GetViewMatrix();
+                m_IdleThrottle.NotifyActivity(NowSeconds());
+            }
+
             // Day/night cycle: drives lights[0] direction/color/intensity + ambient
             // from the time-of-day slider, and positions/tints the moon disc. Runs
             // before BuildLightingData below so its changes take effect this frame.
             if (m_EditorScene) m_DayNight.Apply(*m_EditorScene, deltaTime);
+            // The atmosphere follows the true sun; off, it follows lights[0]
+            GetRenderer()->SetSunDirection(m_DayNight.enabled ? m_DayNight.GetSunDirection() : glm::vec3(0.0f));
 
             // Push camera/lighting to renderer
             GetRenderer()->SetViewMatrix(m_Camera->GetViewMatrix());
             GetRenderer()->SetProjectionMatrix(m_Camera->GetProjectionMatrix());
             GetRenderer()->SetCameraPosition(m_Camera->GetPosition());
-            GetRenderer()->SetLightingData(m_EditorScene->BuildLightingData());
+
+            // Lights whose radius misses the view are culled, the rest sent in
+            // order of importance; the renderer re-uploads only on a change
+            const Frustum lightFrustum = Frustum::ExtractFromMatrix(
+                m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix());
+            GetRenderer()->SetLightingData(m_EditorScene->BuildLightingData(&lightFrustum, m_Camera->GetPosition()));
+            m_EditorScene->BuildPointLights(m_PointLights, &lightFrustum, m_Camera->GetPosition());
+            GetRenderer()->SetPointLights(m_PointLights);
 
             // Sync shadow config in case editor changed it
             if (m_EditorScene->GetLightCount() > 0)
@@ -327,35 +402,82 @@ namespace Nightbloom {
             {
                 if (toyCar->model)
                 {
-                    toyCar->model->SetRotation(
+                    toyCar->SetRotation(
                         glm::vec3(glm::radians(90.f), m_LiveShaderTest.GetRotation(), 0));
                 }
             }
 
             if (m_EditorScene) m_EditorScene->Update(deltaTime);
 
+            // Click-to-select in the 3D view, or hold to sculpt / paint grass while
+            // one of those brushes is on (ImGui's flag is from last frame's UI)
+            const bool viewportMouse = !m_CameraControlActive && !ImGui::GetIO().WantCaptureMouse;
+            if (viewportMouse && m_TerrainPanel.IsSculpting())
+            {
+                glm::vec3 origin, direction;
+                if (GetInput()->IsDown(InputCode::Mouse_Left) && MouseRay(origin, direction))
+                    m_TerrainPanel.SculptAlongRay(origin, direction, deltaTime);
+            }
+            else if (viewportMouse && m_GrassPanel.IsPainting())
+            {
+                glm::vec3 origin, direction;
+                if (GetInput()->IsDown(InputCode::Mouse_Left) && MouseRay(origin, direction))
+                    m_GrassPanel.PaintAlongRay(m_TerrainPanel.GetTerrainSystem(), origin, direction, deltaTime);
+            }
+            else if (m_EditorScene && viewportMouse && GetInput()->IsPressed(InputCode::Mouse_Left))
+            {
+                PickObjectUnderMouse();
+            }
+
             HandleEditorShortcuts();
         }
 
         void OnRender() override
         {
-            DrawList drawList;
+            // The scene is shown in the viewport panel's region, which moves
+            // with the docking layout as well as the window
+            const float aspect = SceneAspect();
+            if (aspect != m_Camera->GetAspect())
+                m_Camera->SetPerspectiveInfiniteReverseZ(m_Camera->GetFov(), aspect, m_Camera->GetNearPlane());
+
+            DrawList& drawList = GetRenderer()->GetFrameDrawList();
             glm::mat4 viewProj = m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix();
             Frustum frustum = Frustum::ExtractFromMatrix(viewProj);
 
+            // Model meshes pick their LOD by projected error against this camera
+            drawList.SetLodView(LodView::FromCamera(m_Camera->GetPosition(), m_Camera->GetFov(),
+                static_cast<float>(GetRenderer()->GetSceneViewportRect().height)));
+
+            // The viewport's orthographic views, culled in the same pass as
+            // the camera and drawn from the same list
+            AuxiliaryView auxViews[MAX_AUXILIARY_VIEWS];
+            Frustum auxFrusta[MAX_AUXILIARY_VIEWS];
+            uint32_t auxCount = GetRenderer()->SupportsAuxiliaryViews()
+                ? m_Viewport.BuildAuxiliaryViews(m_Camera->GetPosition(), auxViews)
+                : 0;
+            for (uint32_t i = 0; i < auxCount; ++i)
+                auxFrusta[i] = Frustum::ExtractFromMatrix(auxViews[i].projection * auxViews[i].view);
+            GetRenderer()->SetAuxiliaryViews(auxViews, auxCount);
+
             if (m_EditorScene)
             {
-                m_EditorScene->BuildDrawList(drawList, &frustum);
+                m_EditorScene->BuildDrawList(drawList, &frustum, auxFrusta, auxCount);
             }
 
-            RenderEditorUI();
+            // Only on the frames the UI is rebuilt (every frame unless the
+            // renderer caches it)
+            if (GetRenderer()->IsUIFrame())
+                RenderEditorUI();
+            GetRenderer()->SetSceneViewportRegion(m_Viewport.GetSceneRegion());
 
             m_TerrainPanel.SubmitTerrainDraw(drawList, m_Camera->GetPosition());
             m_GrassPanel.SubmitGrassDraw(drawList, frustum, m_TerrainPanel.GetTerrainSystem(), m_Camera->GetPosition());
             m_FireflyPanel.SubmitFireflyDraw(drawList);
+            m_ParticlePanel.SubmitParticleDraw(drawList, m_Camera->GetPosition());
             m_CloudPanel.SubmitCloudDraw(drawList);
-            m_WaterPanel.SubmitWaterDraw(drawList);
-            drawList.SortByPipeline();
+            m_WaterPanel.SubmitWaterDraw(drawList, frustum, m_Camera->GetPosition());
+            GetRenderer()->SubmitSkyDraw(drawList);
+            drawList.Sort(m_Camera->GetPosition());
             GetRenderer()->SubmitDrawList(drawList);
         }
 
@@ -364,6 +486,7 @@ namespace Nightbloom {
         std::unique_ptr<Scene>  m_EditorScene;
         std::unique_ptr<Camera> m_Camera;
         bool m_CameraControlActive = false;
+        std::vector<LightData>  m_PointLights;   // per-frame scratch for the renderer's light clusters
 
         // Project info
         std::string           m_CurrentProjectName = "Sandbox";
@@ -378,9 +501,30 @@ namespace Nightbloom {
         bool        m_PendingSceneLoad = false;
         bool        m_PendingNewScene = false;
 
+        // Periodic background save to <scene>.autosave.nbscene; this thread
+        // only takes the snapshot (see AutosaveScene)
+        SceneAutosave m_Autosave;
+
         // Win32 double-null-terminated filter for the scene file dialogs.
+        // .nbscene saves binary; "Save As" a .json exports the readable form.
         static constexpr const char* kSceneFilter =
-            "Nightbloom Scene (*.nbscene)\0*.nbscene\0All Files (*.*)\0*.*\0";
+            "Nightbloom Scene (*.nbscene)\0*.nbscene\0Scene JSON (*.json)\0*.json\0All Files (*.*)\0*.*\0";
+
+        // Render on demand (View > Throttle When Idle)
+        IdleThrottle m_IdleThrottle;
+        glm::mat4    m_LastViewMatrix = glm::mat4(0.0f);
+
+        static double NowSeconds()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool IsSceneAnimating() const
+        {
+            return m_FireflyPanel.IsAnimating() || m_ParticlePanel.IsAnimating() ||
+                m_CloudPanel.IsAnimating() || m_GrassPanel.IsAnimating() ||
+                m_WaterPanel.IsAnimating() || m_DayNight.IsAnimating() || m_LiveShaderTest.IsAnimating();
+        }
 
         // FPS tracking
         float m_FrameTime = 0.0f;
@@ -414,6 +558,7 @@ namespace Nightbloom {
         TerrainPanel            m_TerrainPanel;
         GrassPanel              m_GrassPanel;
         FireflyPanel            m_FireflyPanel;
+        ParticlePanel           m_ParticlePanel;
         CloudPanel              m_CloudPanel;
         WaterEditorPanel        m_WaterPanel;
 
@@ -446,14 +591,19 @@ namespace Nightbloom {
             ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
             ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
 
+            // Transparent host: the scene shows through wherever a panel
+            // doesn't cover it (the viewport panel in particular)
+            windowFlags |= ImGuiWindowFlags_NoBackground;
+
             ImGui::Begin("DockSpace", nullptr, windowFlags);
             ImGui::PopStyleVar(3);
             ImGuiID dockspaceId = ImGui::GetID("EditorDockSpace");
-            ImGui::DockSpace(dockspaceId, ImVec2(0.0f, 0.0f), ImGuiDockNodeFlags_None);
+            ImGui::DockSpace(dockspaceId, ImVec2(0.0f, 0.0f), ImGuiDockNodeFlags_PassthruCentralNode);
             ImGui::End();
 #endif
 
             // Draw panels
+            m_Console.Poll();
             if (m_SceneHierarchy.isOpen)  m_SceneHierarchy.Draw(ctx);
             if (m_Inspector.isOpen)       m_Inspector.Draw(ctx);
             if (m_Console.isOpen)         m_Console.Draw(ctx);
@@ -467,6 +617,7 @@ namespace Nightbloom {
             if (m_TerrainPanel.isOpen) m_TerrainPanel.Draw(ctx);
             if (m_GrassPanel.isOpen) m_GrassPanel.Draw(ctx, m_TerrainPanel.GetTerrainSystem());
             if (m_FireflyPanel.isOpen) m_FireflyPanel.Draw(ctx);
+            if (m_ParticlePanel.isOpen) m_ParticlePanel.Draw(ctx);
             if (m_CloudPanel.isOpen) m_CloudPanel.Draw(ctx);
             if (m_WaterPanel.isOpen) m_WaterPanel.Draw(ctx);
 
@@ -475,6 +626,14 @@ namespace Nightbloom {
 
             m_ShaderCompiler.Draw(ctx);
 
+            // Opened like File > Open, on the next OnUpdate
+            std::string stressScene;
+            if (m_DebugPanel.TakeSceneToOpen(stressScene))
+            {
+                m_PendingLoadPath = stressScene;
+                m_PendingSceneLoad = true;
+            }
+
             if (m_ShowDemoWindow)    ImGui::ShowDemoWindow(&m_ShowDemoWindow);
             if (m_ShowMetricsWindow) ImGui::ShowMetricsWindow(&m_ShowMetricsWindow);
         }
@@ -516,7 +675,7 @@ namespace Nightbloom {
                 if (ImGui::MenuItem("Asset Browser", nullptr, &m_AssetBrowser.isOpen)) {}
                 ImGui::Separator();
                 if (ImGui::MenuItem("Reload Shaders", "Ctrl+R"))
-                    if (GetRenderer()) GetRenderer()->ReloadShaders();
+                    Editor::ShaderCompileService::Get().RebuildChangedAsync();
                 ImGui::EndMenu();
             }
 
@@ -531,12 +690,45 @@ namespace Nightbloom {
                 ImGui::MenuItem("Terrain", nullptr, &m_TerrainPanel.isOpen);
                 ImGui::MenuItem("Grass", nullptr, &m_GrassPanel.isOpen);
                 ImGui::MenuItem("Fireflies", nullptr, &m_FireflyPanel.isOpen);
+                ImGui::MenuItem("Particles", nullptr, &m_ParticlePanel.isOpen);
                 ImGui::MenuItem("Clouds", nullptr, &m_CloudPanel.isOpen);
                 ImGui::MenuItem("Water", nullptr, &m_WaterPanel.isOpen);
                 ImGui::MenuItem("Live Shader Test", nullptr, &m_LiveShaderTest.isOpen);
                 ImGui::Separator();
                 ImGui::MenuItem("ImGui Demo", nullptr, &m_ShowDemoWindow);
                 ImGui::MenuItem("ImGui Metrics", nullptr, &m_ShowMetricsWindow);
+                ImGui::Separator();
+                ImGui::MenuItem("Throttle When Idle", nullptr, &m_IdleThrottle.GetSettings().enabled);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Redraws at %.0f fps while only animations run and %.0f fps\n"
+                                      "when nothing changes; input wakes it at once.",
+                                      m_IdleThrottle.GetSettings().animatedFps, m_IdleThrottle.GetSettings().idleFps);
+                const bool frameLimitOpen = ImGui::BeginMenu("Frame Limit");
+                if (ImGui::IsItemHovered() && !frameLimitOpen)
+                    ImGui::SetTooltip("Sleeps between frames to hold a steady rate: smoother\n"
+                                      "frame times and less power than running flat out.");
+                if (frameLimitOpen)
+                {
+                    const FramePacer::Settings current = GetFrameLimit();
+                    auto option = [&](const char* label, float fps, uint32_t divisor)
+                    {
+                        const bool selected = current.targetFps == fps && current.refreshDivisor == divisor;
+                        if (ImGui::MenuItem(label, nullptr, selected))
+                        {
+                            FramePacer::Settings settings = current;
+                            settings.targetFps = fps;
+                            settings.refreshDivisor = divisor;
+                            SetFrameLimit(settings);
+                        }
+                    };
+                    option("Unlimited", 0.0f, 0);
+                    option("Display Refresh", 0.0f, 1);
+                    option("Half Refresh", 0.0f, 2);
+                    option("30 fps", 30.0f, 0);
+                    option("60 fps", 60.0f, 0);
+                    option("120 fps", 120.0f, 0);
+                    ImGui::EndMenu();
+                }
                 ImGui::EndMenu();
             }
 
@@ -545,7 +737,7 @@ namespace Nightbloom {
                 ImGui::MenuItem("Debug Panel", nullptr, &m_DebugPanel.isOpen);
                 ImGui::Separator();
                 if (ImGui::MenuItem("Reload Shaders", "Ctrl+R"))
-                    if (GetRenderer()) GetRenderer()->ReloadShaders();
+                    Editor::ShaderCompileService::Get().RebuildChangedAsync();
                 ImGui::EndMenu();
             }
 
@@ -577,6 +769,46 @@ namespace Nightbloom {
             ImGui::EndMainMenuBar();
         }
 
+        // -------------------------------------------------------------------------
+        // Viewport picking: a ray from the camera through the mouse, tested
+        // against the scene BVH (object bounds, so models only)
+        // -------------------------------------------------------------------------
+        bool MouseRay(glm::vec3& outOrigin, glm::vec3& outDirection) const
+        {
+            const SceneViewportRect& rect = GetRenderer()->GetSceneViewportRect();
+            const float width = static_cast<float>(rect.width);
+            const float height = static_cast<float>(rect.height);
+            if (width <= 0.0f || height <= 0.0f) return false;
+
+            // Window pixels -> the scene region -> Vulkan NDC (y down,
+            // matching the projection's flip), then two depths back to world
+            // space. Reverse-Z: 1 is the near plane; 0.5 is still finite with
+            // the infinite far plane.
+            const glm::vec2 ndc(2.0f * (GetInput()->GetMouseX() - rect.x) / width - 1.0f,
+                                2.0f * (GetInput()->GetMouseY() - rect.y) / height - 1.0f);
+            const glm::mat4 invViewProj = glm::inverse(m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix());
+            glm::vec4 nearPoint = invViewProj * glm::vec4(ndc, 1.0f, 1.0f);
+            glm::vec4 farPoint = invViewProj * glm::vec4(ndc, 0.5f, 1.0f);
+            nearPoint /= nearPoint.w;
+            farPoint /= farPoint.w;
+
+            outOrigin = glm::vec3(nearPoint);
+            outDirection = glm::normalize(glm::vec3(farPoint) - outOrigin);
+            return true;
+        }
+
+        void PickObjectUnderMouse()
+        {
+            glm::vec3 origin, direction;
+            if (!MouseRay(origin, direction)) return;
+
+            const int picked = m_EditorScene->Raycast(origin, direction);
+            if (picked >= 0)
+                m_EditorScene->Select(picked);
+            else
+                m_EditorScene->Deselect();
+        }
+
         // -------------------------------------------------------------------------
         // Keyboard shortcuts
         // -------------------------------------------------------------------------
@@ -586,7 +818,7 @@ namespace Nightbloom {
             bool ctrl = GetInput()->IsDown(InputCode::Key_Control);
 
             if (ctrl && GetInput()->IsPressed(InputCode::Key_R))
-                if (GetRenderer()) GetRenderer()->ReloadShaders();
+                Editor::ShaderCompileService::Get().RebuildChangedAsync();
 
             if (ctrl && GetInput()->IsPressed(InputCode::Key_S))
             {
@@ -613,7 +845,7 @@ namespace Nightbloom {
         void TogglePlayMode()
         {
             m_Viewport.isPlayMode = !m_Viewport.isPlayMode;
-            LOG_INFO(m_Viewport.isPlayMode ? "Entering play mode" : "Exiting play mode");
+            LOG_INFO("{}", m_Viewport.isPlayMode ? "Entering play mode" : "Exiting play mode");
         }
 
         void StopPlayMode()
@@ -674,9 +906,45 @@ namespace Nightbloom {
             LOG_INFO("Project: {} at {}", m_CurrentProjectName, m_CurrentProjectPath.string());
         }
 
+        // Ctrl+R and the Reload Shaders buttons recompile whatever changed in
+        // the source tree's Shaders/ (includes followed) before reloading
+        void InitShaderCompiler()
+        {
+#ifdef NIGHTBLOOM_EDITOR_SHADER_DIR
+            Editor::ShaderCompileService::Paths paths;
+            paths.sourceDir = NIGHTBLOOM_EDITOR_SHADER_DIR;
+            paths.includeDir = paths.sourceDir / "Include";
+            paths.runtimeDir = AssetManager::Get().GetShadersPath();
+            paths.cacheDir = paths.runtimeDir / "Cache";
+            Editor::ShaderCompileService::Get().Initialize(paths);
+#else
+            LOG_WARN("Shader source directory unknown; Reload Shaders only reloads existing SPIR-V");
+#endif
+        }
+
+        // Textures, models and SPIR-V edited on disk are swapped in at the
+        // frame boundary (AssetHotReload.hpp); reloaded models get their
+        // bounds and animation refreshed in whichever scene is open
+        void InitAssetHotReload()
+        {
+            if (!GetRenderer()->SetAssetHotReload(true))
+            {
+                LOG_WARN("Asset hot reload unavailable; edited assets need a scene reload");
+                return;
+            }
+
+            GetRenderer()->GetAssetHotReload()->SetModelReloadedCallback([this](Model& model, bool reloaded)
+            {
+                if (reloaded && m_EditorScene)
+                    m_EditorScene->RefreshReloadedModel(&model);
+            });
+        }
+
         void UpdateWindowTitle()
         {
             std::string title = "Nightbloom Editor v0.1.0 | Project: " + m_CurrentProjectName;
+            if (m_IdleThrottle.GetState() != IdleThrottle::State::Interactive)
+                title += std::string(" | ") + GetIdleThrottleStateName(m_IdleThrottle.GetState());
             GetWindow()->SetTitle(title);
         }
 
@@ -711,21 +979,37 @@ namespace Nightbloom {
 
         void RequestNewScene() { m_PendingNewScene = true; }
 
-        void DoSaveScene(const std::string& path)
+        SceneCameraState CaptureCameraState() const
         {
-            if (!m_EditorScene || !m_Camera) return;
-
             SceneCameraState cam;
             cam.position = m_Camera->GetPosition();
             cam.yaw = m_Camera->GetYaw();
             cam.pitch = m_Camera->GetPitch();
             cam.fov = m_Camera->GetFov();
             cam.nearPlane = m_Camera->GetNearPlane();
+            return cam;
+        }
+
+        void DoSaveScene(const std::string& path)
+        {
+            if (!m_EditorScene || !m_Camera) return;
 
-            SceneSerializer::Save(*m_EditorScene, cam, path, m_CurrentProjectName,
+            SceneSerializer::Save(*m_EditorScene, CaptureCameraState(), path, m_CurrentProjectName,
                 SerializeEditorState());
         }
 
+        // Snapshot here, encode and write on the autosave thread. Skipped in
+        // play mode (the scene is mid-simulation) and around a pending
+        // open/new, which is about to replace the scene.
+        void AutosaveScene()
+        {
+            if (!m_EditorScene || !m_Camera || m_Viewport.isPlayMode) return;
+            if (m_PendingSceneLoad || m_PendingNewScene) return;
+
+            m_Autosave.Submit(SceneSerializer::Capture(*m_EditorScene, CaptureCameraState(),
+                m_CurrentProjectName, SerializeEditorState()), SceneAutosave::GetAutosavePath(m_ScenePath));
+        }
+
         void ProcessPendingSceneOps()
         {
             if (m_PendingNewScene)
@@ -760,7 +1044,9 @@ namespace Nightbloom {
             cam.nearPlane = m_Camera->GetNearPlane();
 
             std::string editorState;
-            if (SceneSerializer::Load(*m_EditorScene, cam, path, GetRenderer(), &editorState))
+            // Models stream in over the next frames instead of stalling the editor
+            if (SceneSerializer::Load(*m_EditorScene, cam, path, GetRenderer(), &editorState,
+                GetRenderer()->GetAssetLoader()))
             {
                 m_ScenePath = path;
                 ApplyCameraState(cam);
@@ -783,6 +1069,7 @@ namespace Nightbloom {
             m_EditorScene->SetAmbient(glm::vec3(0.03f, 0.03f, 0.05f), 1.0f);
 
             m_DayNight = DayNightPanel{};   // reset cycle to defaults (no GPU resources)
+            SetEffectsEnabled(false);       // torn down by the next OnUpdate
             m_ScenePath.clear();
 
             // Reset camera to the editor's default framing.
@@ -795,13 +1082,27 @@ namespace Nightbloom {
         {
             m_Camera->SetPosition(cam.position);
             m_Camera->SetRotation(cam.yaw, cam.pitch);
-            uint32_t w = GetRenderer()->GetWidth();
-            uint32_t h = GetRenderer()->GetHeight();
-            float aspect = (h > 0) ? static_cast<float>(w) / static_cast<float>(h) : (1280.0f / 720.0f);
-            m_Camera->SetPerspectiveInfiniteReverseZ(cam.fov, aspect, cam.nearPlane);
+            m_Camera->SetPerspectiveInfiniteReverseZ(cam.fov, SceneAspect(), cam.nearPlane);
+        }
+
+        // Width over height of the region the scene is shown in
+        float SceneAspect() const
+        {
+            const SceneViewportRect& rect = GetRenderer()->GetSceneViewportRect();
+            return (rect.height > 0) ? static_cast<float>(rect.width) / static_cast<float>(rect.height) : (1280.0f / 720.0f);
         }
 
-        // --- DayNight panel state <-> the scene file's opaque "editor" blob ---
+        // The optional systems follow these from the next OnUpdate (ApplyEnabled)
+        void SetEffectsEnabled(bool enabled)
+        {
+            m_TerrainPanel.enabled = enabled;
+            m_GrassPanel.enabled = enabled;
+            m_FireflyPanel.enabled = enabled;
+            m_CloudPanel.enabled = enabled;
+            m_WaterPanel.enabled = enabled;
+        }
+
+        // --- DayNight panel + effects state <-> the scene file's opaque "editor" blob ---
         std::string SerializeEditorState() const
         {
             auto v3 = [](const glm::vec3& v) { return nlohmann::json::array({ v.x, v.y, v.z }); };
@@ -830,17 +1131,37 @@ namespace Nightbloom {
             dn["discDistance"] = d.discDistance;
             dn["discRadius"] = d.discRadius;
 
+            nlohmann::json effects;
+            effects["terrain"] = m_TerrainPanel.enabled;
+            effects["grass"] = m_GrassPanel.enabled;
+            effects["fireflies"] = m_FireflyPanel.enabled;
+            effects["clouds"] = m_CloudPanel.enabled;
+            effects["water"] = m_WaterPanel.enabled;
+
             nlohmann::json root;
             root["dayNight"] = std::move(dn);
+            root["effects"] = std::move(effects);
             return root.dump();
         }
 
         void ApplyEditorState(const std::string& stateJson)
         {
+            // Scenes saved before the effects were recorded use none
+            SetEffectsEnabled(false);
             if (stateJson.empty()) return;
             try
             {
                 nlohmann::json root = nlohmann::json::parse(stateJson);
+                if (root.contains("effects"))
+                {
+                    const nlohmann::json& fx = root["effects"];
+                    m_TerrainPanel.enabled = fx.value("terrain", false);
+                    m_GrassPanel.enabled = fx.value("grass", false);
+                    m_FireflyPanel.enabled = fx.value("fireflies", false);
+                    m_CloudPanel.enabled = fx.value("clouds", false);
+                    m_WaterPanel.enabled = fx.value("water", false);
+                }
+
                 if (!root.contains("dayNight")) return;
                 const nlohmann::json& dn = root["dayNight"];
 
@@ -888,5 +1209,7 @@ namespace Nightbloom {
 // Entry point
 Nightbloom::Application* Nightbloom::CreateApplication()
 {
+    Nightbloom::s_ConsoleLog = std::make_shared<Nightbloom::LogRingSink>();
+    Nightbloom::Logger::Get().AddSink(Nightbloom::s_ConsoleLog);
     return new Nightbloom::EditorApplication();
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------
 
 #include "EditorFileUtils.hpp"
+#include "ShaderCompileService.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include "Engine/Renderer/AssetManager.hpp"
 #include <fstream>
@@ -114,32 +115,13 @@ namespace Editor {
 		return compiled;
 	}
 
-	static const char* StageFlagFor(const std::string& path) {
-		auto ends = [](const std::string& s, const char* suf) {
-#ifdef _WIN32
-			return s.size() >= strlen(suf) &&
-				_stricmp(s.c_str() + s.size() - strlen(suf), suf) == 0;
-#else
-			return s.size() >= strlen(suf) &&
-				strcasecmp(s.c_str() + s.size() - strlen(suf), suf) == 0;
-#endif
-			};
-		if (ends(path, ".vert")) return "-fshader-stage=vert";
-		if (ends(path, ".frag")) return "-fshader-stage=frag";
-		if (ends(path, ".comp")) return "-fshader-stage=comp";
-		if (ends(path, ".geom")) return "-fshader-stage=geom";
-		if (ends(path, ".tesc")) return "-fshader-stage=tesc";
-		if (ends(path, ".tese")) return "-fshader-stage=tese";
-		return "";
-	}
-
 	static std::string Quote(const std::string& s) {
 		if (s.empty()) return "\"\"";
 		if (s.front() == '"' && s.back() == '"') return s; // already quoted
 		return "\"" + s + "\"";
 	}
 
-	static int RunAndCapture(const std::string& exePath,
+	int EditorFileUtils::RunAndCapture(const std::string& exePath,
 		const std::vector<std::string>& args,
 		std::string& out)
 	{
@@ -176,46 +158,6 @@ namespace Editor {
 
 	bool EditorFileUtils::CompileShader(const std::string& shaderPath)
 	{
-		// Get the path to glslc compiler
-		//std::string glslcPath = FindGlslcCompiler();
-		//if (glslcPath.empty())
-		//{
-		//	LOG_ERROR("Could not find glslc compiler! Please ensure Vulkan SDK is installed.");
-		//	return false;
-		//}
-		//
-		//// Get output path for compiled shader
-		//std::filesystem::path inputPath(shaderPath);
-		//std::string outputDir = GetEditorShadersCompiledDirectory();
-		//CreateDirectory(outputDir);
-		//
-		//std::filesystem::path outputPath = std::filesystem::path(outputDir) / (inputPath.filename().string() + ".spv");
-		//
-		//// Build compile command
-		//std::string command = "\"" + glslcPath + "\" \"" + shaderPath + "\" -o \"" + outputPath.string() + "\"";
-		//
-		//LOG_INFO("Compiling shader: {}", command);
-		//
-		//// Execute compilation
-		//int result = std::system(command.c_str());
-		//
-		//if (result == 0)
-		//{
-		//	LOG_INFO("Successfully compiled shader to: {}", outputPath.string());
-		//	return true;
-		//}
-		//else
-		//{
-		//	LOG_ERROR("Shader compilation failed with error code: {}", result);
-		//	return false;
-		//}
-
-		std::string glslcPath = FindGlslcCompiler();
-		if (glslcPath.empty() || !std::filesystem::exists(glslcPath)) {
-			LOG_ERROR("Could not find glslc compiler! Please ensure Vulkan SDK is installed.");
-			return false;
-		}
-
 		std::filesystem::path inputPath(shaderPath);
 		std::string outputDir = GetEditorShadersCompiledDirectory();
 		MakeDirectory(outputDir);
@@ -223,20 +165,8 @@ namespace Editor {
 		std::filesystem::path outputPath =
 			std::filesystem::path(outputDir) / (inputPath.filename().string() + ".spv");
 
-		// Build args
-		std::vector<std::string> args;
-		if (const char* st = StageFlagFor(shaderPath); st[0]) args.emplace_back(st);
-		//args.emplace_back("--target-env=vulkan1.3"); // tweak if needed
-		args.emplace_back("-O");                     // optional
-		args.emplace_back(shaderPath);        // quote individual paths too
-		args.emplace_back("-o");
-		args.emplace_back(outputPath.string());
-
-		// Run and capture output
-		std::string compilerOut;
-		int rc = RunAndCapture(glslcPath, args, compilerOut);
-
-		if (rc == 0) {
+		// In-process when shaderc is available, through the SPIR-V cache either way
+		if (ShaderCompileService::Get().CompileFile(inputPath, outputPath)) {
 			// Get the shader path from AssetManager - this is where shaders are LOADED from
 			std::string assetShaderPath = AssetManager::Get().GetShadersPath();
 			std::filesystem::path runtimeShadersPath;
@@ -266,10 +196,7 @@ namespace Editor {
 
 			return true;
 		}
-		else {
-			LOG_ERROR("glslc failed (code {}):\n{}", rc, compilerOut);
-			return false;
-		}
+		return false;
 	}
 
 	bool EditorFileUtils::CopyCompiledShaderToCurrentProject(const std::string& compiledShaderName)
@@ -40,7 +40,7 @@ namespace Editor {
 	// 3. Copy the .spv to Sandbox/Shaders/
 		static bool SaveShaderFile(const std::string& filename, const std::string& content);
 
-		// Compile a shader file to SPIR-V
+		// Compile a shader file to SPIR-V (see ShaderCompileService)
 		static bool CompileShader(const std::string& shaderPath);
 
 		// Copy compiled shader to Sandbox
@@ -49,6 +49,10 @@ namespace Editor {
 		// Find the glslc compiler
 		static std::string FindGlslcCompiler();
 
+		// Run an executable, capturing stdout and stderr; returns its exit code
+		static int RunAndCapture(const std::string& exePath, const std::vector<std::string>& args,
+			std::string& out);
+
 		// Create directory if it doesn't exist
 		static bool MakeDirectory(const std::string& path);
 
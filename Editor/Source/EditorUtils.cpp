@@ -25,7 +25,7 @@ namespace Nightbloom
         ResourceManager* resources = ctx.renderer->GetResourceManager();
 
         auto newDrawable = std::make_unique<MeshDrawable>(vb, ib, ic, pipeline);
-        newDrawable->SetTransform(selected->primitiveTransform);
+        newDrawable->SetTransform(selected->GetWorldTransform());
 
         if (resources)
         {
@@ -1,27 +1,328 @@
 // Panels/AssetBrowserPanel.cpp
 #include "AssetBrowserPanel.hpp"
-#include <imgui.h>
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <imgui_impl_vulkan.h>
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
 
 namespace Nightbloom
 {
-    void AssetBrowserPanel::Draw(EditorContext& /*ctx*/)
+    namespace
+    {
+        constexpr float kThumbnailSize = static_cast<float>(ThumbnailCache::THUMBNAIL_SIZE);
+        constexpr float kCellWidth = kThumbnailSize + 24.0f;
+        constexpr float kTreeWidth = 220.0f;
+
+        // The name, cut to fit `width` with a trailing "..."
+        std::string FitName(const std::string& name, float width)
+        {
+            if (ImGui::CalcTextSize(name.c_str()).x <= width)
+                return name;
+
+            std::string fitted = name;
+            while (!fitted.empty() && ImGui::CalcTextSize((fitted + "...").c_str()).x > width)
+                fitted.pop_back();
+            return fitted + "...";
+        }
+    }
+
+    void AssetBrowserPanel::Start()
+    {
+        if (!m_Index.IsRunning())
+        {
+            const AssetManager& assets = AssetManager::Get();
+            m_Index.Start({
+                { "Shaders", assets.GetShadersPath() },
+                { "Textures", assets.GetTexturesPath() },
+                { "Models", assets.GetModelsPath() } });
+        }
+
+        if (!m_Thumbnails)
+        {
+            m_Thumbnails = std::make_unique<ThumbnailCache>(
+                (std::filesystem::current_path() / "ThumbnailCache").string());
+            m_Pages.resize(m_Thumbnails->GetPageCount());
+        }
+        m_Thumbnails->Start(2);
+    }
+
+    void AssetBrowserPanel::Stop()
+    {
+        m_Index.Stop();
+        if (m_Thumbnails)
+            m_Thumbnails->Stop();
+    }
+
+    void AssetBrowserPanel::Cleanup()
+    {
+        // Queued uploads would write into pages about to be released
+        if (m_Tasks)
+            m_Tasks->Cancel(this);
+        Stop();
+        for (AtlasPage& page : m_Pages)
+            ReleasePage(page, false);
+    }
+
+    void AssetBrowserPanel::ReleasePage(AtlasPage& page, bool deferred)
+    {
+        if (page.id)
+        {
+            VkDescriptorSet set = reinterpret_cast<VkDescriptorSet>(page.id);
+            // Frames in flight may still draw with it
+            if (deferred && m_Resources)
+                m_Resources->Defer([set]() { ImGui_ImplVulkan_RemoveTexture(set); });
+            else
+                ImGui_ImplVulkan_RemoveTexture(set);
+        }
+        if (!page.textureName.empty() && m_Resources)
+            m_Resources->DestroyTexture(page.textureName);
+        page = AtlasPage{};
+    }
+
+    void AssetBrowserPanel::UploadPages(MainThreadTaskQueue& tasks)
+    {
+        // The upload path only writes whole images, so a changed page is
+        // replaced by a new texture - at most every PAGE_UPLOAD_INTERVAL
+        const auto now = std::chrono::steady_clock::now();
+        if (now - m_LastPageUpload < PAGE_UPLOAD_INTERVAL)
+            return;
+
+        for (uint32_t i = 0; i < m_Pages.size(); ++i)
+        {
+            AtlasPage& page = m_Pages[i];
+            const uint64_t revision = m_Thumbnails->GetPageRevision(i);
+            if (revision == page.revision || revision == page.queued)
+                continue;
+
+            page.queued = revision;
+            m_Tasks = &tasks;
+            tasks.Post([this, i]() { UploadPage(i); }, TaskPriority::Low, this);
+            m_LastPageUpload = now;
+        }
+    }
+
+    void AssetBrowserPanel::UploadPage(uint32_t index)
+    {
+        if (!m_Resources || !m_Thumbnails || index >= m_Pages.size())
+            return;
+
+        // The page as it is now, which may be past the revision queued
+        AtlasPage& page = m_Pages[index];
+        const uint64_t revision = m_Thumbnails->GetPageRevision(index);
+        if (revision == page.revision)
+            return;
+
+        TextureDesc desc;
+        desc.width = ThumbnailCache::PAGE_SIZE;
+        desc.height = ThumbnailCache::PAGE_SIZE;
+        desc.format = TextureFormat::RGBA8;
+        desc.usage = TextureUsage::Sampled | TextureUsage::Transfer;
+
+        const std::string name = "AssetBrowserThumbnails_" + std::to_string(m_PageUploadCount++);
+        const std::vector<uint8_t>& pixels = m_Thumbnails->GetPagePixels(index);
+        VulkanTexture* texture = m_Resources->CreateTextureFromMemory(name, pixels.data(), pixels.size(), desc);
+        if (!texture)
+        {
+            LOG_WARN("Asset browser: failed to upload thumbnail page {}", index);
+            page.revision = revision;
+            return;
+        }
+
+        ReleasePage(page, true);
+        page.textureName = name;
+        page.id = reinterpret_cast<ImTextureID>(ImGui_ImplVulkan_AddTexture(
+            texture->GetSampler(), texture->GetImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+        page.revision = revision;
+        page.queued = revision;
+    }
+
+    void AssetBrowserPanel::DrawFolderTree(const AssetIndexSnapshot& snapshot, uint32_t folderIndex)
+    {
+        const AssetFolder& folder = snapshot.folders[folderIndex];
+
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick |
+            ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (folder.folders.empty())
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        if (folder.parent == AssetFolder::NO_PARENT)
+            flags |= ImGuiTreeNodeFlags_DefaultOpen;
+        if (folderIndex == m_Folder)
+            flags |= ImGuiTreeNodeFlags_Selected;
+
+        // Keyed by path so open state survives a rescan
+        const bool open = ImGui::TreeNodeEx(folder.path.c_str(), flags, "%s", folder.name.c_str());
+        if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+        {
+            m_Folder = folderIndex;
+            m_FolderPath = folder.path;
+        }
+
+        if (open)
+        {
+            for (uint32_t child : folder.folders)
+                DrawFolderTree(snapshot, child);
+            ImGui::TreePop();
+        }
+    }
+
+    void AssetBrowserPanel::UpdateShownEntries(const AssetIndexSnapshot& snapshot)
+    {
+        std::string search = m_Search;
+        std::transform(search.begin(), search.end(), search.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (snapshot.version == m_ShownVersion && m_Folder == m_ShownFolder && search == m_ShownSearch)
+            return;
+        m_ShownVersion = snapshot.version;
+        m_ShownFolder = m_Folder;
+        m_ShownSearch = search;
+
+        m_Shown.clear();
+        if (!search.empty())
+        {
+            // Every folder
+            for (uint32_t i = 0; i < snapshot.entries.size(); ++i)
+            {
+                if (snapshot.entries[i].lowerName.find(search) != std::string::npos)
+                    m_Shown.push_back(i);
+            }
+        }
+        else if (m_Folder < snapshot.folders.size())
+        {
+            m_Shown = snapshot.folders[m_Folder].entries;
+        }
+    }
+
+    void AssetBrowserPanel::DrawGrid(const AssetIndexSnapshot& snapshot)
+    {
+        if (m_Shown.empty())
+        {
+            ImGui::TextDisabled(m_Search[0] ? "No matches" : "Empty folder");
+            return;
+        }
+
+        const ImGuiStyle& style = ImGui::GetStyle();
+        const int columns = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().x / kCellWidth));
+        const int rows = (static_cast<int>(m_Shown.size()) + columns - 1) / columns;
+        const float rowHeight = kThumbnailSize + ImGui::GetTextLineHeight() + style.ItemSpacing.y * 2.0f;
+
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, rowHeight);
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+            {
+                const float rowStartY = ImGui::GetCursorPosY();
+                for (int column = 0; column < columns; ++column)
+                {
+                    const size_t index = static_cast<size_t>(row) * columns + column;
+                    if (index >= m_Shown.size())
+                        break;
+                    const AssetEntry& entry = snapshot.entries[m_Shown[index]];
+
+                    if (column > 0)
+                        ImGui::SameLine(column * kCellWidth);
+                    ImGui::PushID(static_cast<int>(m_Shown[index]));
+                    ImGui::BeginGroup();
+
+                    bool drawn = false;
+                    if (entry.kind == AssetKind::Texture)
+                    {
+                        ThumbnailCache::Cell cell;
+                        if (m_Thumbnails->Request(entry.path, entry.size, entry.modified, cell) == ThumbnailCache::Status::Ready &&
+                            cell.page < m_Pages.size() && m_Pages[cell.page].id)
+                        {
+                            ImGui::Image(m_Pages[cell.page].id, ImVec2(kThumbnailSize, kThumbnailSize),
+                                ImVec2(cell.u0, cell.v0), ImVec2(cell.u1, cell.v1));
+                            drawn = true;
+                        }
+                    }
+                    if (!drawn)
+                        ImGui::Button(GetAssetKindName(entry.kind), ImVec2(kThumbnailSize, kThumbnailSize));
+
+                    ImGui::TextUnformatted(FitName(entry.name, kCellWidth - style.ItemSpacing.x).c_str());
+                    ImGui::EndGroup();
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::SetTooltip("%s\n%s, %.1f KB", entry.path.c_str(), GetAssetKindName(entry.kind),
+                            static_cast<double>(entry.size) / 1024.0);
+                    }
+                    ImGui::PopID();
+                }
+                ImGui::SetCursorPosY(rowStartY + rowHeight);
+            }
+        }
+        clipper.End();
+    }
+
+    void AssetBrowserPanel::Draw(EditorContext& ctx)
     {
         ImGui::Begin("Asset Browser", &isOpen);
 
-        if (ImGui::Button("Import Asset...")) { /* TODO: file dialog */ }
+        // Closed this frame: no scanning or decoding while nobody looks
+        if (!isOpen)
+        {
+            Stop();
+            ImGui::End();
+            return;
+        }
+
+        Start();
+        if (ctx.renderer)
+            m_Resources = ctx.renderer->GetResourceManager();
+
+        m_Thumbnails->Update();
+        if (ctx.renderer)
+            UploadPages(ctx.renderer->GetMainThreadTasks());
+
+        std::shared_ptr<const AssetIndexSnapshot> snapshot = m_Index.GetSnapshot();
+        if (snapshot != m_Snapshot)
+        {
+            m_Snapshot = std::move(snapshot);
+            m_Folder = m_Snapshot ? m_Snapshot->FindFolder(m_FolderPath) : AssetFolder::NO_PARENT;
+        }
+
+        ImGui::SetNextItemWidth(200.0f);
+        ImGui::InputTextWithHint("##Search", "Search all folders", m_Search, sizeof(m_Search));
+        ImGui::SameLine();
+        if (ImGui::Button("Rescan"))
+            m_Index.RequestRescan();
+
+        if (!m_Snapshot)
+        {
+            ImGui::TextDisabled("Indexing...");
+            ImGui::End();
+            return;
+        }
+
+        ImGui::SameLine();
+        ImGui::TextDisabled("%zu files | %zu thumbnails queued", m_Snapshot->entries.size(),
+            m_Thumbnails->GetQueuedCount());
         ImGui::Separator();
 
-        if (ImGui::TreeNode("Shaders"))
+        if (m_Folder == AssetFolder::NO_PARENT && !m_Snapshot->roots.empty())
         {
-            ImGui::Text("triangle.vert");
-            ImGui::Text("triangle.frag");
-            ImGui::Text("mesh.vert");
-            ImGui::Text("mesh.frag");
-            ImGui::TreePop();
+            m_Folder = m_Snapshot->roots[0];
+            m_FolderPath = m_Snapshot->folders[m_Folder].path;
         }
-        if (ImGui::TreeNode("Textures")) { ImGui::Text("No textures"); ImGui::TreePop(); }
-        if (ImGui::TreeNode("Models")) { ImGui::Text("No models");   ImGui::TreePop(); }
+
+        ImGui::BeginChild("Folders", ImVec2(kTreeWidth, 0), true);
+        for (uint32_t root : m_Snapshot->roots)
+            DrawFolderTree(*m_Snapshot, root);
+        ImGui::EndChild();
+
+        ImGui::SameLine();
+        ImGui::BeginChild("Assets", ImVec2(0, 0), true);
+        UpdateShownEntries(*m_Snapshot);
+        DrawGrid(*m_Snapshot);
+        ImGui::EndChild();
 
         ImGui::End();
     }
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
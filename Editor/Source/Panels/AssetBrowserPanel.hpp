@@ -1,13 +1,76 @@
 // Panels/AssetBrowserPanel.hpp
 #pragma once
 #include "../EditorContext.hpp"
+#include "Engine/Core/AssetIndex.hpp"
+#include "Engine/Renderer/ThumbnailCache.hpp"
+#include <imgui.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace Nightbloom
 {
+    class ResourceManager;
+    class VulkanTexture;
+    class MainThreadTaskQueue;
+
+    // Browses the AssetManager's shader, texture and model directories from
+    // an AssetIndex (scanned and watched on its own thread) and shows texture
+    // thumbnails from a ThumbnailCache. Each frame only reads the latest
+    // index snapshot and lays out the visible rows; thumbnails are requested
+    // for those rows only.
     class AssetBrowserPanel
     {
     public:
+        // An atlas page is re-uploaded whole, so changes are batched
+        static constexpr std::chrono::milliseconds PAGE_UPLOAD_INTERVAL{ 250 };
+
         bool isOpen = false;
+
         void Draw(EditorContext& ctx);
+
+        // Call this before the renderer shuts down, while the Vulkan device is still alive.
+        void Cleanup();
+
+    private:
+        struct AtlasPage
+        {
+            std::string textureName;
+            ImTextureID id = 0;
+            uint64_t revision = 0;
+            uint64_t queued = 0;   // revision an upload task was posted for
+        };
+
+        void Start();
+        void Stop();
+        // Posts an upload task per changed page, so a burst of new
+        // thumbnails is spread over frames (Renderer::GetMainThreadTasks)
+        void UploadPages(MainThreadTaskQueue& tasks);
+        void UploadPage(uint32_t index);
+        void ReleasePage(AtlasPage& page, bool deferred);
+
+        void DrawFolderTree(const AssetIndexSnapshot& snapshot, uint32_t folder);
+        void DrawGrid(const AssetIndexSnapshot& snapshot);
+        void UpdateShownEntries(const AssetIndexSnapshot& snapshot);
+
+        AssetIndex m_Index;
+        std::unique_ptr<ThumbnailCache> m_Thumbnails;
+        std::vector<AtlasPage> m_Pages;
+        ResourceManager* m_Resources = nullptr;
+        MainThreadTaskQueue* m_Tasks = nullptr;   // where uploads were posted, for Cleanup
+        std::chrono::steady_clock::time_point m_LastPageUpload{};
+        uint32_t m_PageUploadCount = 0;
+
+        std::shared_ptr<const AssetIndexSnapshot> m_Snapshot;
+        std::string m_FolderPath;  // Kept by path: indices change between snapshots
+        uint32_t m_Folder = AssetFolder::NO_PARENT;
+        char m_Search[128] = "";
+
+        // The grid's entries, rebuilt when the snapshot, folder or search changes
+        std::vector<uint32_t> m_Shown;
+        uint64_t m_ShownVersion = 0;
+        uint32_t m_ShownFolder = AssetFolder::NO_PARENT;
+        std::string m_ShownSearch;
     };
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
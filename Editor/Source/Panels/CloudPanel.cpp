@@ -28,9 +28,10 @@ namespace Nightbloom
             return;
         }
 
-        if (!EnsureInitialized(ctx.renderer))
+        ImGui::Checkbox("Enabled", &enabled);
+        if (!enabled || !m_Initialized)
         {
-            ImGui::TextDisabled("CloudSystem failed to initialize.");
+            ImGui::TextDisabled(enabled ? "Starting..." : "Off - created when enabled.");
             ImGui::End();
             return;
         }
@@ -59,45 +60,84 @@ namespace Nightbloom
             ImGui::SliderFloat("Extinction Coefficient", &desc.extinctionCoefficient, 0.0f, 5.0f);
             ImGui::SliderFloat("HG Anisotropy (g)", &desc.hgAnisotropy, -0.99f, 0.99f);
             ImGui::SliderInt("Step Count", &desc.stepCount, 16, 256);
+            ImGui::SliderFloat("Reflection Steps", &desc.reflectionStepScale, 0.1f, 1.0f, "%.2f");
+            // Side of the square the cloud shadow map covers around the
+            // camera; 0 turns the clouds' shadows off
+            ImGui::SliderFloat("Shadow Extent", &desc.shadowMapExtent, 0.0f, 40000.0f, "%.0f");
         }
 
         if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen))
         {
             // The raymarch runs in a compute pass at this fraction of the
-            // screen resolution (see CloudRaymarch.comp) - lower = faster,
-            // higher = sharper. Doesn't need a noise Regenerate, just
-            // resizes the result image.
-            if (ImGui::SliderFloat("Resolution Scale", &desc.resolutionScale, 0.25f, 1.0f))
+            // screen resolution (see CloudRaymarch.comp), upsampled around
+            // silhouettes by CloudUpsample.comp - lower = faster, higher =
+            // sharper. Doesn't need a noise Regenerate, just resizes the
+            // result image.
+            if (ImGui::SliderFloat("Resolution Scale", &desc.resolutionScale, 0.15f, 1.0f))
             {
-                m_Clouds.ResizeResultImage(ctx.renderer->GetWidth(), ctx.renderer->GetHeight());
+                m_Clouds.ResizeResultImage(ctx.renderer->GetSceneExtent().width, ctx.renderer->GetSceneExtent().height);
             }
             ImGui::TextDisabled("Lower = faster, less detailed");
+
+            // One pixel per block is marched each frame, the rest reproject
+            // last frame's result (see CloudRaymarch.comp)
+            const char* checkerboardOptions[] = { "Every pixel", "1/4 per frame", "1/16 per frame" };
+            int checkerboardIndex = (desc.checkerboardSize >= 4) ? 2 : (desc.checkerboardSize >= 2) ? 1 : 0;
+            if (ImGui::Combo("Temporal Update", &checkerboardIndex, checkerboardOptions, 3))
+                desc.checkerboardSize = 1 << checkerboardIndex;
+            ImGui::TextDisabled("Fewer pixels per frame = faster, slight smearing in fast pans");
         }
 
         ImGui::Separator();
         if (ImGui::CollapsingHeader("Noise (requires Regenerate)"))
         {
+            bool noiseChanged = false;
+
             const char* shapeResOptions[] = { "64", "128", "256" };
-            ImGui::Combo("Shape Resolution", &m_ShapeResIndex, shapeResOptions, 3);
-            ImGui::SliderInt("Shape Octaves", &m_ShapeOctaves, 1, 8);
-            ImGui::SliderFloat("Shape Frequency", &m_ShapeFrequency, 1.0f, 16.0f);
+            noiseChanged |= ImGui::Combo("Shape Resolution", &m_ShapeResIndex, shapeResOptions, 3);
+            noiseChanged |= ImGui::SliderInt("Shape Octaves", &m_ShapeOctaves, 1, 8);
+            noiseChanged |= ImGui::SliderFloat("Shape Frequency", &m_ShapeFrequency, 1.0f, 16.0f);
 
             const char* detailResOptions[] = { "32", "64" };
-            ImGui::Combo("Detail Resolution", &m_DetailResIndex, detailResOptions, 2);
-            ImGui::SliderInt("Detail Octaves", &m_DetailOctaves, 1, 6);
-            ImGui::SliderFloat("Detail Frequency", &m_DetailFrequency, 1.0f, 32.0f);
+            noiseChanged |= ImGui::Combo("Detail Resolution", &m_DetailResIndex, detailResOptions, 2);
+            noiseChanged |= ImGui::SliderInt("Detail Octaves", &m_DetailOctaves, 1, 6);
+            noiseChanged |= ImGui::SliderFloat("Detail Frequency", &m_DetailFrequency, 1.0f, 32.0f);
 
-            ImGui::SliderInt("Seed", &m_Seed, 0, 9999);
+            noiseChanged |= ImGui::SliderInt("Seed", &m_Seed, 0, 9999);
+            noiseChanged |= ImGui::Checkbox("Packed Noise (RGBA8 / BC4 + mips)", &m_PackedNoise);
+
+            // Generated in the background and swapped in when done, so
+            // scrubbing doesn't stall the frame
+            ImGui::Checkbox("Live Regenerate", &m_LiveRegenerate);
+            if (noiseChanged && m_LiveRegenerate)
+            {
+                m_Clouds.RequestRegenerate(BuildDesc());
+            }
 
             if (ImGui::Button("Regenerate Noise", ImVec2(-1, 0)))
             {
-                m_Clouds.Regenerate(BuildDesc());
+                m_Clouds.RequestRegenerate(BuildDesc());
+            }
+            if (m_Clouds.IsRegenerating())
+            {
+                ImGui::TextDisabled("Generating noise...");
             }
         }
 
         ImGui::End();
     }
 
+    void CloudPanel::ApplyEnabled(Renderer* renderer)
+    {
+        if (!enabled)
+            Cleanup();
+        else if (renderer && !EnsureInitialized(renderer))
+        {
+            Cleanup();
+            enabled = false;
+        }
+    }
+
     bool CloudPanel::EnsureInitialized(Renderer* renderer)
     {
         if (m_Initialized) return true;
@@ -108,9 +148,11 @@ namespace Nightbloom
             return false;
         }
 
-        if (!m_Clouds.Regenerate(BuildDesc()))
+        // The volumes come in over the next frames; IsReady until then is false
+        if (!m_Clouds.GenerateInBackground(BuildDesc()))
         {
-            LOG_ERROR("CloudPanel: CloudSystem::Regenerate failed");
+            LOG_ERROR("CloudPanel: CloudSystem::GenerateInBackground failed");
+            m_Clouds.Shutdown();
             return false;
         }
 
@@ -136,6 +178,9 @@ namespace Nightbloom
         desc.shapeNoise.persistence = 0.5f;
         desc.shapeNoise.lacunarity = 2.0f;
         desc.shapeNoise.seed = static_cast<uint32_t>(m_Seed);
+        desc.shapeNoise.format = m_PackedNoise ? NoiseTextureFormat::RGBA8 : NoiseTextureFormat::RGBA32F;
+        desc.shapeNoise.channels = m_PackedNoise ? NoiseChannelLayout::CloudShape : NoiseChannelLayout::Single;
+        desc.shapeNoise.generateMips = m_PackedNoise;
 
         desc.detailNoise.width = desc.detailNoise.height = desc.detailNoise.depth = detailRes[m_DetailResIndex];
         desc.detailNoise.noiseType = NoiseType::Worley;
@@ -144,6 +189,8 @@ namespace Nightbloom
         desc.detailNoise.persistence = 0.5f;
         desc.detailNoise.lacunarity = 2.0f;
         desc.detailNoise.seed = static_cast<uint32_t>(m_Seed) + 1; // distinct from shape's seed
+        desc.detailNoise.format = m_PackedNoise ? NoiseTextureFormat::BC4 : NoiseTextureFormat::RGBA32F;
+        desc.detailNoise.generateMips = m_PackedNoise;
 
         return desc;
     }
@@ -10,9 +10,15 @@ namespace Nightbloom
     {
     public:
         bool isOpen = true;
+        // Part of the scene: the CloudSystem exists only while enabled
+        bool enabled = false;
 
         void Draw(EditorContext& ctx);
 
+        // Creates or tears down the CloudSystem to match `enabled`, once per
+        // frame before the draw list is built. A failed start clears `enabled`.
+        void ApplyEnabled(Renderer* renderer);
+
         // Call before renderer shuts down (while Vulkan device is still alive)
         void Cleanup();
 
@@ -23,6 +29,10 @@ namespace Nightbloom
         }
 
         CloudSystem& GetSystem() { return m_Clouds; }
+        // The wind scrolls the clouds
+        bool IsAnimating() const { return m_Initialized && m_Clouds.IsReady() && m_Clouds.GetDesc().windSpeed != 0.0f; }
+        // Frames must keep coming for background noise to be swapped in
+        bool IsRegenerating() const { return m_Initialized && m_Clouds.IsRegenerating(); }
 
     private:
         CloudSystem m_Clouds;
@@ -42,6 +52,8 @@ namespace Nightbloom
         int   m_DetailOctaves = 3;
         float m_DetailFrequency = 8.0f;
         int   m_Seed = 1337;
+        bool  m_PackedNoise = true;     // RGBA8 shape + BC4 detail with mips; off = RGBA32F
+        bool  m_LiveRegenerate = true;  // RequestRegenerate on every noise edit
 
         CloudDesc BuildDesc() const;
         bool      EnsureInitialized(Renderer* renderer);
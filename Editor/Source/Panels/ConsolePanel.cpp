@@ -2,19 +2,138 @@
 #include "ConsolePanel.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include <imgui.h>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 
 namespace Nightbloom
 {
+    namespace
+    {
+        struct LevelStyle
+        {
+            LogLevel level;
+            const char* name;
+            ImVec4 color;
+        };
+
+        const LevelStyle kLevels[] = {
+            { LogLevel::Trace, "TRACE", ImVec4(0.55f, 0.55f, 0.55f, 1.0f) },
+            { LogLevel::Debug, "DEBUG", ImVec4(0.40f, 0.80f, 0.85f, 1.0f) },
+            { LogLevel::Info,  "INFO",  ImVec4(0.90f, 0.90f, 0.90f, 1.0f) },
+            { LogLevel::Warn,  "WARN",  ImVec4(1.00f, 0.80f, 0.30f, 1.0f) },
+            { LogLevel::Error, "ERROR", ImVec4(1.00f, 0.35f, 0.35f, 1.0f) },
+        };
+
+        const LevelStyle& StyleOf(LogLevel level)
+        {
+            const size_t index = static_cast<size_t>(level);
+            return index < IM_ARRAYSIZE(kLevels) ? kLevels[index] : kLevels[2];
+        }
+
+        // hh:mm:ss.mmm, local time; only the visible rows pay for this
+        void FormatTime(std::chrono::system_clock::time_point time, char* out, size_t size)
+        {
+            const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+            const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                time.time_since_epoch()).count() % 1000;
+            const std::tm* local = std::localtime(&seconds);
+            std::snprintf(out, size, "%02d:%02d:%02d.%03d",
+                local ? local->tm_hour : 0, local ? local->tm_min : 0, local ? local->tm_sec : 0,
+                static_cast<int>(millis));
+        }
+    }
+
+    void ConsolePanel::Poll()
+    {
+        if (m_Sink)
+            m_Sink->Drain(m_History);
+    }
+
+    void ConsolePanel::DrawFilterBar()
+    {
+        bool changed = false;
+        for (const LevelStyle& style : kLevels)
+        {
+            const uint32_t bit = LogFilter::LevelBit(style.level);
+            bool shown = (m_LevelMask & bit) != 0;
+            ImGui::PushStyleColor(ImGuiCol_Text, style.color);
+            if (ImGui::Checkbox(style.name, &shown))
+            {
+                m_LevelMask = shown ? (m_LevelMask | bit) : (m_LevelMask & ~bit);
+                changed = true;
+            }
+            ImGui::PopStyleColor();
+            ImGui::SameLine();
+        }
+
+        ImGui::SetNextItemWidth(200.0f);
+        changed |= ImGui::InputTextWithHint("##Filter", "Filter", m_FilterText, sizeof(m_FilterText));
+        ImGui::SameLine();
+        if (ImGui::Button("Clear"))
+        {
+            m_History.Clear();
+            m_LastAppendedCount = 0;
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Auto-scroll", &m_AutoScroll);
+
+        if (changed)
+        {
+            LogFilter filter;
+            filter.levelMask = m_LevelMask;
+            filter.text = m_FilterText;
+            m_History.SetFilter(filter);
+        }
+
+        ImGui::TextDisabled("%zu of %zu lines", m_History.GetFilteredCount(), m_History.GetCount());
+        const uint64_t dropped = m_Sink ? m_Sink->GetDroppedCount() : 0;
+        if (dropped > 0)
+        {
+            ImGui::SameLine();
+            ImGui::TextColored(kLevels[3].color, "(%llu dropped - logged faster than the console drained)",
+                static_cast<unsigned long long>(dropped));
+        }
+    }
+
     void ConsolePanel::Draw(EditorContext& /*ctx*/)
     {
         ImGui::Begin("Console", &isOpen);
 
-        ImGui::Text("Console output:");
+        DrawFilterBar();
         ImGui::Separator();
 
-        ImGui::BeginChild("LogScroll", ImVec2(0, -25), true);
-        ImGui::Text("[INFO] Editor started");
-        ImGui::Text("[INFO] Renderer initialized");
+        ImGui::BeginChild("LogScroll", ImVec2(0, -25), true, ImGuiWindowFlags_HorizontalScrollbar);
+        // Follow new lines only while the view is already at the bottom
+        const bool atBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+
+        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4.0f, 1.0f));
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(m_History.GetFilteredCount()));
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+            {
+                const LogEntry& entry = m_History.GetFiltered(static_cast<size_t>(row));
+                const LevelStyle& style = StyleOf(entry.level);
+
+                char time[16];
+                FormatTime(entry.time, time, sizeof(time));
+                ImGui::TextDisabled("%s T%u", time, entry.thread);
+                ImGui::SameLine();
+                ImGui::TextColored(style.color, "%-5s", style.name);
+                ImGui::SameLine();
+                const std::string& text = m_History.GetText(entry.message);
+                ImGui::TextUnformatted(text.data(), text.data() + text.size());
+            }
+        }
+        clipper.End();
+        ImGui::PopStyleVar();
+
+        const uint64_t appended = m_History.GetAppendedCount();
+        if (m_AutoScroll && atBottom && appended != m_LastAppendedCount)
+            ImGui::SetScrollHereY(1.0f);
+        m_LastAppendedCount = appended;
         ImGui::EndChild();
 
         static char inputBuf[256] = "";
@@ -27,4 +146,4 @@ namespace Nightbloom
 
         ImGui::End();
     }
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
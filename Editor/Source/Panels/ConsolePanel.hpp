@@ -1,13 +1,37 @@
 // Panels/ConsolePanel.hpp
 #pragma once
 #include "../EditorContext.hpp"
+#include "Engine/Core/Logger/LogHistory.hpp"
+#include "Engine/Core/Logger/LogRingSink.hpp"
+#include <memory>
 
 namespace Nightbloom
 {
+    // The log, from the sink the app added to the Logger. Holds the last
+    // HISTORY_CAPACITY lines; only the visible rows are laid out, and the
+    // filter index is kept up as lines arrive (see LogHistory).
     class ConsolePanel
     {
     public:
+        static constexpr size_t HISTORY_CAPACITY = 256 * 1024;
+
         bool isOpen = true;
+
+        void SetSink(std::shared_ptr<LogRingSink> sink) { m_Sink = std::move(sink); }
+
+        // Moves what was logged since into the history; every frame, open or
+        // not, so the sink's ring doesn't fill up while the panel is closed
+        void Poll();
         void Draw(EditorContext& ctx);
+
+    private:
+        void DrawFilterBar();
+
+        std::shared_ptr<LogRingSink> m_Sink;
+        LogHistory m_History{ HISTORY_CAPACITY };
+        char m_FilterText[128] = "";
+        uint32_t m_LevelMask = ~0u;
+        bool m_AutoScroll = true;
+        uint64_t m_LastAppendedCount = 0;
     };
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
@@ -2,6 +2,7 @@
 #include "DayNightPanel.hpp"
 #include "Engine/Core/Scene.hpp"
 #include "Engine/Renderer/Light.hpp"
+#include "Engine/Renderer/Renderer.hpp"
 #include <imgui.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -29,6 +30,7 @@ namespace Nightbloom
             std::cos(ang) * std::cos(arcTilt),
             std::sin(ang),
             std::cos(ang) * std::sin(arcTilt)));
+        m_SunDirection = sunPos;
 
         // Single-light engine: keep the lit body in the UPPER hemisphere always, so
         // the scene is lit from above at all hours (sun by day, its mirror = the moon
@@ -69,8 +71,7 @@ namespace Nightbloom
             glm::mat4 xform =
                 glm::translate(glm::mat4(1.0f), discPos) *
                 glm::scale(glm::mat4(1.0f), glm::vec3(discRadius));
-            obj.meshDrawable->SetTransform(xform);
-            obj.primitiveTransform = xform;
+            obj.SetLocalTransform(xform);
 
             if (enabled)
             {
@@ -85,7 +86,7 @@ namespace Nightbloom
                 obj.meshDrawable->SetCustomData(glm::vec4(dc * di, discFlag));
                 // Hide entirely once faded out, else a zero-color emissive disc would
                 // still write depth as a black spot on the horizon.
-                obj.visible = (discFade > 0.02f);
+                obj.SetVisible(discFade > 0.02f);
             }
             break;
         }
@@ -93,7 +94,8 @@ namespace Nightbloom
 
     void DayNightPanel::Draw(EditorContext& ctx)
     {
-        (void)ctx; // panel edits its own state; EditorApp applies it in OnUpdate
+        // The panel edits its own state (EditorApp applies it in OnUpdate) and
+        // the renderer's atmosphere settings
         if (!isOpen) return;
         if (!ImGui::Begin("Day / Night", &isOpen)) { ImGui::End(); return; }
 
@@ -139,6 +141,37 @@ namespace Nightbloom
             ImGui::SliderFloat("Disc radius", &discRadius, 5.0f, 200.0f);
         }
 
+        if (ctx.renderer && ImGui::CollapsingHeader("Atmosphere"))
+        {
+            // Medium changes rebake every LUT; the sun only the sky-view
+            AtmosphereSettings& atmosphere = ctx.renderer->GetAtmosphereSettings();
+            ImGui::Checkbox("Physical sky", &atmosphere.enabled);
+            ImGui::SliderFloat("Sun illuminance", &atmosphere.sunIlluminance, 0.0f, 40.0f);
+            glm::vec3 rayleigh = atmosphere.rayleighScattering * 1000.0f;
+            if (ImGui::DragFloat3("Rayleigh (1/Mm)", &rayleigh.x, 0.1f, 0.0f, 100.0f))
+                atmosphere.rayleighScattering = rayleigh / 1000.0f;
+            float mie = atmosphere.mieScattering * 1000.0f;
+            if (ImGui::SliderFloat("Mie (1/Mm)", &mie, 0.0f, 40.0f))
+                atmosphere.mieScattering = mie / 1000.0f;
+            ImGui::SliderFloat("Mie anisotropy", &atmosphere.mieAnisotropy, 0.0f, 0.95f);
+            ImGui::SliderFloat("Ground albedo", &atmosphere.groundAlbedo, 0.0f, 1.0f);
+            ImGui::SliderFloat("Aerial perspective", &atmosphere.aerialPerspectiveScale, 0.0f, 50.0f);
+            ImGui::SliderFloat("Sky rebuild (deg)", &atmosphere.updateThresholdDeg, 0.0f, 5.0f, "%.2f");
+        }
+
+        if (ctx.renderer && ImGui::CollapsingHeader("Environment Probe"))
+        {
+            // Between captures the cube is reused as is
+            EnvironmentProbeSettings& probe = ctx.renderer->GetEnvironmentProbeSettings();
+            int interval = static_cast<int>(probe.updateInterval);
+            if (ImGui::SliderInt("Update interval", &interval, 1, 600))
+                probe.updateInterval = static_cast<uint32_t>(interval);
+            ImGui::SliderFloat("Sun recapture (deg)", &probe.sunThresholdDeg, 0.0f, 5.0f, "%.2f");
+            ImGui::SliderFloat("Colour recapture", &probe.colorThreshold, 0.0f, 0.5f, "%.3f");
+            ImGui::ColorEdit3("Far ground", &probe.groundColor.x);
+            ImGui::Text("Age: %u frames", ctx.renderer->GetEnvironmentProbeAge());
+        }
+
         ImGui::End();
     }
 } // namespace Nightbloom
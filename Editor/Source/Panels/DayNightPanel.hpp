@@ -23,6 +23,10 @@ namespace Nightbloom
         // Advances time (if auto) and writes light dir/color/intensity, ambient,
         // and the moon disc's transform + emissive color into the scene.
         void Apply(Scene& scene, float deltaTime);
+        bool IsAnimating() const { return enabled && autoAdvance && speedHours != 0.0f; }
+        // Toward the true sun as of the last Apply - below the horizon at
+        // night, unlike lights[0] - for the atmosphere (Renderer::SetSunDirection)
+        glm::vec3 GetSunDirection() const { return m_SunDirection; }
 
         // --- Cycle state ---
         bool  enabled       = true;   // when off, only the moon position tracks the light
@@ -58,5 +62,8 @@ namespace Nightbloom
         float     nightDiscIntensity = 1.1f;
         float     discDistance = 350.0f;
         float     discRadius   = 45.0f;
+
+    private:
+        glm::vec3 m_SunDirection = glm::vec3(0.0f, 1.0f, 0.0f);
     };
 } // namespace Nightbloom
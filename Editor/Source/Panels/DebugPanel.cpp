@@ -1,9 +1,22 @@
 // Panels/DebugPanel.cpp
 #include "DebugPanel.hpp"
+#include "../ShaderCompileService.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Components/GpuProfiler.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSwapchain.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/NoiseVolumePacking.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include "Engine/VFX/CloudSystem.hpp"
 #include "Engine/Core/Scene.hpp"
+#include "Engine/Core/PerformanceMetrics.hpp"
+#include "Engine/Core/CpuMemory.hpp"
+#include "Engine/Core/ChromeTrace.hpp"
+#include "Engine/Core/SceneFile.hpp"
 #include <imgui.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
 
 namespace Nightbloom
 {
@@ -41,8 +54,14 @@ namespace Nightbloom
         ImGui::Separator();
         ImGui::Text("Shader Tools");
 
+        // Changed sources are recompiled first; the editor reloads when done
         if (ImGui::Button("Reload All Shaders", ImVec2(200, 25)))
-            if (ctx.renderer) ctx.renderer->ReloadShaders();
+            Editor::ShaderCompileService::Get().RebuildChangedAsync();
+        if (Editor::ShaderCompileService::Get().IsRebuilding())
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled("compiling...");
+        }
 
         if (ImGui::Button("Toggle Pipeline (P)", ImVec2(200, 25)))
             if (ctx.renderer) ctx.renderer->TogglePipeline();
@@ -68,6 +87,12 @@ namespace Nightbloom
                 }
                 if (!prof->GetResults().empty())
                     ImGui::Text("  %-16s %6.3f ms", "GPU total", total);
+
+                DrawGpuProfiler(*prof);
+
+                const VkExtent2D renderExtent = ctx.renderer->GetRenderExtent();
+                DrawPipelineStats(*prof, static_cast<float>(renderExtent.width) * static_cast<float>(renderExtent.height));
+                DrawHalfPrecisionComparison(*ctx.renderer, *prof);
             }
             else if (prof)
             {
@@ -75,6 +100,178 @@ namespace Nightbloom
             }
         }
 
+        DrawTraceCapture(ctx.renderer ? ctx.renderer->GetGpuProfiler() : nullptr);
+        if (ctx.renderer)
+        {
+            DrawDrawStreamCapture(*ctx.renderer);
+            DrawMetricsExport(*ctx.renderer);
+        }
+
+        if (ctx.renderer && ctx.renderer->GetMemoryManager())
+            DrawGpuMemory(*ctx.renderer, *ctx.renderer->GetMemoryManager());
+        DrawCpuMemory();
+
+        DrawRenderStats();
+        if (ctx.renderer)
+            DrawUIOverlay(*ctx.renderer);
+        DrawStressScene(ctx);
+
+        ImGui::Separator();
+        ImGui::Text("Command Recording");
+        if (ctx.renderer)
+        {
+            bool parallel = ctx.renderer->IsParallelRecording();
+            if (ImGui::Checkbox("Parallel recording", &parallel))
+                ctx.renderer->SetParallelRecording(parallel);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Records the scene, shadow cascades and reflection into\n"
+                                  "secondary command buffers on worker threads. Compare the\n"
+                                  "CPU frame time with it on and off.");
+
+            bool staticCaching = ctx.renderer->IsStaticCommandCaching();
+            if (ImGui::Checkbox("Cache static commands", &staticCaching))
+                ctx.renderer->SetStaticCommandCaching(staticCaching);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Replays the terrain's shadow draws from command buffers\n"
+                                  "kept across frames; they re-record only when the terrain,\n"
+                                  "its patches or the shadow setup change.");
+            uint32_t reused = 0, recorded = 0;
+            ctx.renderer->GetCachedSecondaryStats(reused, recorded);
+            ImGui::Text("Cached buffers: %u replayed, %u re-recorded", reused, recorded);
+
+            int framesInFlight = static_cast<int>(ctx.renderer->GetFramesInFlight());
+            if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, static_cast<int>(MAX_FRAMES_IN_FLIGHT)))
+                ctx.renderer->SetFramesInFlight(static_cast<uint32_t>(framesInFlight));
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("How far the CPU may record ahead of the GPU.\n"
+                                  "1 = lowest input latency, 3 = most CPU/GPU overlap.\n"
+                                  "Applied at the next frame (waits for the GPU once).");
+
+            const VkPresentModeKHR presentMode = ctx.renderer->GetPresentMode();
+            if (ImGui::BeginCombo("Present mode", VulkanSwapchain::GetPresentModeName(presentMode)))
+            {
+                for (VkPresentModeKHR mode : ctx.renderer->GetSupportedPresentModes())
+                {
+                    if (ImGui::Selectable(VulkanSwapchain::GetPresentModeName(mode), mode == presentMode))
+                        ctx.renderer->SetPresentMode(mode);
+                }
+                ImGui::EndCombo();
+            }
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("FIFO = V-Sync, FIFO Relaxed = V-Sync that tears when late,\n"
+                                  "Mailbox = newest frame at each refresh, Immediate = tearing.\n"
+                                  "Switching rebuilds only the swapchain, without a GPU stall.");
+
+            bool lowLatency = ctx.renderer->IsLowLatencyMode();
+            if (ImGui::Checkbox("Low latency", &lowLatency))
+                ctx.renderer->SetLowLatencyMode(lowLatency);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Waits for the GPU (and the last present, with present wait)\n"
+                                  "before reading input, then on V-Sync sleeps so the frame\n"
+                                  "starts as late as the measured CPU+GPU time allows.");
+
+            const PerformanceMetrics& metrics = PerformanceMetrics::Get();
+            ImGui::Text("Input latency: %.2f ms (max %.2f, %s)",
+                metrics.GetInputLatency(), metrics.GetMaxInputLatency(),
+                metrics.IsInputLatencyAtDisplay() ? "at display" : "at present");
+            if (lowLatency)
+                ImGui::Text("Pre-input sleep: %.2f ms", metrics.GetLowLatencySleep());
+            if (metrics.GetPacingTarget() > 0.0f)
+                ImGui::Text("Frame limit: %.2f ms (jitter %.3f ms, waited %.2f ms)",
+                    metrics.GetPacingTarget(), metrics.GetPacingJitter(), metrics.GetPacingWait());
+            ImGui::TextDisabled("Present wait: %s", ctx.renderer->SupportsPresentWait() ? "supported" : "unsupported");
+
+            ImGui::Text("Instances: %u  Draws: %zu",
+                ctx.renderer->GetInstanceCount(), ctx.renderer->GetBatchedDrawCount());
+            if (ctx.renderer->GetDroppedInstanceCount() > 0)
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "Dropped instances: %u (instance buffer full)",
+                    ctx.renderer->GetDroppedInstanceCount());
+
+            if (ctx.renderer->SupportsDepthPrepass())
+            {
+                bool prepass = ctx.renderer->IsDepthPrepass();
+                if (ImGui::Checkbox("Depth prepass", &prepass))
+                    ctx.renderer->SetDepthPrepass(prepass);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Lays down the depth of meshes, terrain and grass first,\n"
+                                      "front to back, then shades them with an EQUAL depth test.\n"
+                                      "Cuts overdraw in dense grass; costs a second vertex pass.");
+            }
+
+            if (ctx.renderer->SupportsOrderIndependentTransparency())
+            {
+                bool oit = ctx.renderer->IsOrderIndependentTransparency();
+                if (ImGui::Checkbox("Order-independent transparency", &oit))
+                    ctx.renderer->SetOrderIndependentTransparency(oit);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Draws glass, water and fireflies unsorted into weighted\n"
+                                      "accumulation/revealage targets, composited after the scene\n"
+                                      "pass. No per-frame sorting; identical glass instances.");
+            }
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Dynamic Resolution");
+        if (ctx.renderer)
+        {
+            DynamicResolutionSettings drs = ctx.renderer->GetDynamicResolution();
+            bool changed = ImGui::Checkbox("Enabled##drs", &drs.enabled);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Scales the scene resolution to keep the GPU frame time\n"
+                                  "under the target. Post-process upscales to the window;\n"
+                                  "UI stays at full resolution.");
+            changed |= ImGui::SliderFloat("Target GPU ms", &drs.targetFrameMs, 4.0f, 33.3f, "%.1f");
+            changed |= ImGui::SliderFloat("Min scale", &drs.minScale, 0.25f, 1.0f, "%.2f");
+            changed |= ImGui::SliderFloat("Max scale", &drs.maxScale, 0.25f, 1.0f, "%.2f");
+            if (changed)
+                ctx.renderer->SetDynamicResolution(drs);
+
+            const VkExtent2D renderExtent = ctx.renderer->GetRenderExtent();
+            ImGui::Text("Render scale: %.2f (%ux%u)", ctx.renderer->GetRenderScale(),
+                renderExtent.width, renderExtent.height);
+
+            if (ctx.renderer->SupportsTemporalUpscaling())
+            {
+                bool temporal = ctx.renderer->IsTemporalUpscaling();
+                if (ImGui::Checkbox("Temporal upscaling", &temporal))
+                    ctx.renderer->SetTemporalUpscaling(temporal);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Jitters the scene and accumulates it over frames at the\n"
+                                      "window resolution, instead of a plain stretch. Also\n"
+                                      "anti-aliases, so FXAA is skipped while it is on.");
+            }
+            else
+            {
+                ImGui::TextDisabled("Temporal upscaling unavailable");
+            }
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Variable Rate Shading");
+        if (ctx.renderer)
+        {
+            if (ctx.renderer->SupportsVariableRateShading())
+            {
+                auto& vrs = ctx.renderer->GetVariableRateShadingSettings();
+                ImGui::Checkbox("Enabled##vrs", &vrs.enabled);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Shades terrain, grass and the cloud composite once per 2x2\n"
+                                      "pixels where they are far away, sky, or under a heavy\n"
+                                      "vignette. Compare the Scene timing either way.");
+                ImGui::SliderFloat("Coarse distance", &vrs.coarseDistance, 10.0f, 1000.0f, "%.0f",
+                    ImGuiSliderFlags_Logarithmic);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("View distance beyond which a whole tile shades at 2x2.");
+                ImGui::SliderFloat("Vignette darkening", &vrs.vignetteDarkening, 0.05f, 1.0f, "%.2f");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Tiles the vignette darkens at least this much shade at 2x2.");
+            }
+            else
+            {
+                ImGui::TextDisabled("Variable rate shading unavailable");
+            }
+        }
+
         ImGui::Separator();
         ImGui::Text("Post-Process");
         if (ctx.renderer)
@@ -107,6 +304,15 @@ namespace Nightbloom
             ImGui::Spacing();
             ImGui::Checkbox("Anti-Aliasing (FXAA)", &pp.aaEnabled);
             ImGui::TextDisabled("Toggle to compare edge softening in the same view.");
+
+            if (ctx.renderer->SupportsComputePostProcess())
+            {
+                ImGui::Checkbox("Compute post pass", &pp.computePost);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Run AA, bloom composite, tonemap and vignette as one compute\n"
+                                      "dispatch over shared-memory tiles, then copy the result\n"
+                                      "under the UI. Compare the PostProcess timing either way.");
+            }
         }
 
         ImGui::Separator();
@@ -119,4 +325,764 @@ namespace Nightbloom
 
         ImGui::End();
     }
+
+    namespace
+    {
+        // Stable per-name colour, so a pass keeps its colour across frames
+        ImU32 SpanColor(StringId name)
+        {
+            // The id is already a hash of the name
+            float hue = static_cast<float>(name.GetValue() % 360u) / 360.0f;
+            float r, g, b;
+            ImGui::ColorConvertHSVtoRGB(hue, 0.45f, 0.75f, r, g, b);
+            return ImGui::ColorConvertFloat4ToU32(ImVec4(r, g, b, 1.0f));
+        }
+    }
+
+    void DebugPanel::DrawGpuProfiler(GpuProfiler& profiler)
+    {
+        GpuProfileHistory& history = profiler.GetHistory();
+
+        if (ImGui::TreeNode("GPU Flame Graph"))
+        {
+            ImGui::Checkbox("Freeze", &m_FreezeProfile);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Keep showing the selected frame while new ones arrive");
+
+            if (!m_FreezeProfile && history.GetFrameCount() > 0)
+            {
+                m_ProfileFrameAge = std::min(m_ProfileFrameAge, static_cast<int>(history.GetFrameCount()) - 1);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(200.0f);
+                ImGui::SliderInt("Frames ago", &m_ProfileFrameAge, 0, static_cast<int>(history.GetFrameCount()) - 1);
+                m_ProfileFrame = history.GetFrame(static_cast<uint32_t>(m_ProfileFrameAge));
+            }
+
+            DrawFlameGraph(m_ProfileFrame);
+            ImGui::TreePop();
+        }
+
+        if (ImGui::TreeNode("GPU Scope Statistics"))
+        {
+            int capacity = static_cast<int>(history.GetCapacity());
+            ImGui::SetNextItemWidth(200.0f);
+            if (ImGui::SliderInt("History frames", &capacity, 30, 1000))
+                history.SetCapacity(static_cast<uint32_t>(capacity));
+            ImGui::SameLine();
+            if (ImGui::Button("Reset"))
+                history.Clear();
+            ImGui::TextDisabled("%u frames", history.GetFrameCount());
+
+            const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Resizable;
+            if (ImGui::BeginTable("GpuScopeStats", 9, flags, ImVec2(0.0f, 300.0f)))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+                for (const char* column : { "Queue", "Last", "Avg", "Min", "Max", "P50", "P95", "P99" })
+                    ImGui::TableSetupColumn(column);
+                ImGui::TableHeadersRow();
+
+                for (const GpuProfileHistory::ScopeStats& stats : history.ComputeStats())
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    // Indent by depth, show only the scope's own name
+                    size_t slash = stats.path.find_last_of('/');
+                    const char* name = stats.path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+                    ImGui::Text("%*s%s", static_cast<int>(stats.depth * 2), "", name);
+                    if (ImGui::IsItemHovered())
+                        ImGui::SetTooltip("%s\n%u samples", stats.path.c_str(), stats.samples);
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(GetGpuQueueName(stats.queue));
+                    for (float ms : { stats.last, stats.avg, stats.min, stats.max, stats.p50, stats.p95, stats.p99 })
+                    {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", ms);
+                    }
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+    }
+
+    void DebugPanel::DrawPipelineStats(GpuProfiler& profiler, float renderPixels)
+    {
+        if (!ImGui::TreeNode("GPU Pipeline Statistics"))
+            return;
+
+        if (!profiler.IsPipelineStatisticsSupported())
+        {
+            ImGui::TextDisabled("Pipeline statistics queries unsupported on this device");
+            ImGui::TreePop();
+            return;
+        }
+
+        bool enabled = profiler.IsPipelineStatisticsEnabled();
+        if (ImGui::Checkbox("Collect", &enabled))
+            profiler.SetPipelineStatisticsEnabled(enabled);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Counts shader invocations and passing samples per scope.\n"
+                              "Averaged over the GPU history window; costs a little GPU time.");
+
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+            ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Resizable;
+        if (enabled && ImGui::BeginTable("GpuPipelineStats", 9, flags, ImVec2(0.0f, 300.0f)))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+            for (const char* column : { "Queue", "Vertices", "Prims In", "Prims Out", "Fragments", "Frag/px", "Samples", "Compute" })
+                ImGui::TableSetupColumn(column);
+            ImGui::TableHeadersRow();
+
+            for (const GpuProfileHistory::ScopeStats& stats : profiler.GetHistory().ComputeStats())
+            {
+                if (stats.pipelineSamples == 0) continue;
+                const GpuPipelineStats& avg = stats.avgPipelineStats;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                size_t slash = stats.path.find_last_of('/');
+                const char* name = stats.path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+                ImGui::Text("%*s%s", static_cast<int>(stats.depth * 2), "", name);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("%s\n%u samples", stats.path.c_str(), stats.pipelineSamples);
+
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(GetGpuQueueName(stats.queue));
+                for (uint64_t count : { avg.vertexInvocations, avg.clippingInvocations, avg.clippingPrimitives, avg.fragmentInvocations })
+                {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(count));
+                }
+                // Fragment shading per output pixel: overdraw, for passes at render resolution
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", renderPixels > 0.0f ? static_cast<float>(avg.fragmentInvocations) / renderPixels : 0.0f);
+                for (uint64_t count : { avg.samplesPassed, avg.computeInvocations })
+                {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(count));
+                }
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawHalfPrecisionComparison(Renderer& renderer, GpuProfiler& profiler)
+    {
+        if (!ImGui::TreeNode("FP16 Shading A/B"))
+            return;
+
+        if (!renderer.IsHalfPrecisionSupported())
+        {
+            ImGui::TextDisabled("shaderFloat16 unsupported on this device; shading stays fp32");
+            ImGui::TreePop();
+            return;
+        }
+
+        GpuProfileHistory& history = profiler.GetHistory();
+        bool half = renderer.GetHalfPrecisionShading();
+        if (ImGui::Checkbox("Half-precision shading", &half))
+        {
+            renderer.SetHalfPrecisionShading(half);
+            history.Clear();   // the window then holds one variant only
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("fp16 builds of Grass.frag and PostProcess.frag.\n"
+                              "Toggling clears the GPU history so captures don't mix variants.");
+
+        // Capture each side once the history has refilled after a toggle
+        if (ImGui::Button("Capture A (fp32)"))
+            m_HalfBaseline = history.ComputeStats();
+        ImGui::SameLine();
+        if (ImGui::Button("Capture B (fp16)"))
+            m_HalfCandidate = history.ComputeStats();
+        ImGui::SameLine();
+        ImGui::TextDisabled("%u frames", history.GetFrameCount());
+
+        const auto comparison = GpuProfileHistory::CompareStats(m_HalfBaseline, m_HalfCandidate);
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+            ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Resizable;
+        if (!comparison.empty() && ImGui::BeginTable("HalfPrecisionAB", 6, flags, ImVec2(0.0f, 240.0f)))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+            for (const char* column : { "A avg", "B avg", "Delta", "A P95", "B P95" })
+                ImGui::TableSetupColumn(column);
+            ImGui::TableHeadersRow();
+
+            for (const GpuProfileHistory::ScopeComparison& entry : comparison)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                size_t slash = entry.path.find_last_of('/');
+                const char* name = entry.path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+                ImGui::Text("%*s%s", static_cast<int>(entry.depth * 2), "", name);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("%s (%s)", entry.path.c_str(), GetGpuQueueName(entry.queue));
+
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", entry.baselineAvg);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", entry.candidateAvg);
+                ImGui::TableNextColumn();
+                const ImVec4 color = entry.GetDeltaMs() <= 0.0f ? ImVec4(0.4f, 0.9f, 0.4f, 1.0f) : ImVec4(0.9f, 0.5f, 0.4f, 1.0f);
+                ImGui::TextColored(color, "%+.3f (%+.0f%%)", entry.GetDeltaMs(), entry.GetDeltaFraction() * 100.0f);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", entry.baselineP95);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", entry.candidateP95);
+            }
+            ImGui::EndTable();
+        }
+        else if (comparison.empty())
+        {
+            ImGui::TextDisabled("Capture both sides to compare");
+        }
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawTraceCapture(GpuProfiler* profiler)
+    {
+        ImGui::Separator();
+        ImGui::Text("Trace Capture");
+
+        bool recording = CpuProfiler::Get().IsEnabled();
+        if (ImGui::Checkbox("Record CPU scopes", &recording))
+            CpuProfiler::Get().SetEnabled(recording);
+        ImGui::SameLine();
+        if (ImGui::Button("Capture Trace"))
+        {
+            char stamp[32] = {};
+            std::time_t now = std::time(nullptr);
+            std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+            const std::string path = std::string("NightbloomTrace_") + stamp + ".json";
+
+            // GPU spans only when timestamps work; otherwise a CPU-only trace
+            const GpuProfileHistory* gpu = (profiler && profiler->IsSupported()) ? &profiler->GetHistory() : nullptr;
+            std::string error;
+            if (WriteChromeTrace(path, CpuProfiler::Get().Capture(), gpu, error))
+                m_TraceStatus = "Saved " + path;
+            else
+                m_TraceStatus = "Trace capture failed: " + error;
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Writes the last few thousand CPU scopes per thread and the\n"
+                              "GPU history as Chrome trace JSON - open it in\n"
+                              "ui.perfetto.dev or chrome://tracing.");
+        if (!m_TraceStatus.empty())
+            ImGui::TextDisabled("%s", m_TraceStatus.c_str());
+    }
+
+    void DebugPanel::DrawDrawStreamCapture(Renderer& renderer)
+    {
+        if (ImGui::Button("Capture Draw Stream"))
+        {
+            char stamp[32] = {};
+            std::time_t now = std::time(nullptr);
+            std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+            m_DrawStreamPath = std::string("NightbloomFrame_") + stamp + ".nbdraw";
+            renderer.RequestDrawStreamCapture(m_DrawStreamPath);
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Writes the next frame's draw list, camera, lighting and\n"
+                              "shadow matrices for NightbloomBench --replay, which times\n"
+                              "the same GPU work without the editor. Terrain, grass,\n"
+                              "water and other system-owned draws aren't captured.");
+        if (renderer.IsDrawStreamCapturePending())
+            ImGui::TextDisabled("Capturing...");
+        else if (!m_DrawStreamPath.empty())
+            ImGui::TextDisabled("Last: %s (result in the log)", m_DrawStreamPath.c_str());
+    }
+
+    void DebugPanel::DrawMetricsExport(Renderer& renderer)
+    {
+        if (!ImGui::TreeNode("Metrics Export"))
+            return;
+
+        MetricsExporter& exporter = renderer.GetMetricsExporter();
+        if (exporter.IsRunning())
+        {
+            const MetricsExportSettings& settings = exporter.GetSettings();
+            ImGui::Text("Every %lld ms, %llu exports", static_cast<long long>(settings.interval.count()),
+                        static_cast<unsigned long long>(exporter.GetExportCount()));
+            if (!settings.csvPath.empty())
+                ImGui::TextDisabled("CSV: %s", settings.csvPath.c_str());
+            if (!settings.statsdHost.empty())
+                ImGui::TextDisabled("StatsD: %s:%u", settings.statsdHost.c_str(), settings.statsdPort);
+            const std::string error = exporter.GetLastError();
+            if (!error.empty())
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "%s", error.c_str());
+            if (ImGui::Button("Stop Export"))
+                exporter.Stop();
+        }
+        else
+        {
+            ImGui::InputTextWithHint("CSV", "file to append to", m_MetricsCsv, sizeof(m_MetricsCsv));
+            ImGui::InputTextWithHint("StatsD", "host[:port]", m_MetricsStatsd, sizeof(m_MetricsStatsd));
+            ImGui::InputText("Instance", m_MetricsInstance, sizeof(m_MetricsInstance));
+            ImGui::InputInt("Interval (ms)", &m_MetricsIntervalMs, 1000);
+            m_MetricsIntervalMs = std::max(m_MetricsIntervalMs, 100);
+
+            MetricsExportSettings settings;
+            settings.csvPath = m_MetricsCsv;
+            settings.instance = m_MetricsInstance;
+            settings.interval = std::chrono::milliseconds(m_MetricsIntervalMs);
+            const bool validEndpoint = m_MetricsStatsd[0] == '\0' ||
+                MetricsExporter::ParseEndpoint(m_MetricsStatsd, settings.statsdHost, settings.statsdPort);
+            if (!validEndpoint)
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "StatsD wants host or host:port");
+
+            ImGui::BeginDisabled(!validEndpoint || (settings.csvPath.empty() && settings.statsdHost.empty()));
+            if (ImGui::Button("Start Export"))
+                exporter.Start(settings);
+            ImGui::EndDisabled();
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+                ImGui::SetTooltip("Frame-time percentiles, GPU pass times, memory against its\n"
+                                  "budget and upload throughput, every interval, from a\n"
+                                  "background thread. Instances started with\n"
+                                  "NIGHTBLOOM_METRICS_CSV or _STATSD set export on their own.");
+        }
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawGpuMemory(Renderer& renderer, VulkanMemoryManager& memoryManager)
+    {
+        if (!ImGui::TreeNode("GPU Memory"))
+            return;
+
+        constexpr float MB = 1024.0f * 1024.0f;
+
+        // Usage against the budget the driver gives this process, per heap
+        const std::vector<VulkanMemoryManager::HeapInfo> heaps = memoryManager.GetHeapInfos();
+        for (size_t i = 0; i < heaps.size(); ++i)
+        {
+            const VulkanMemoryManager::HeapInfo& heap = heaps[i];
+            if (heap.budget == 0) continue;
+
+            const float usedMB = static_cast<float>(heap.usage) / MB;
+            const float budgetMB = static_cast<float>(heap.budget) / MB;
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "%.0f / %.0f MB", usedMB, budgetMB);
+            ImGui::Text("Heap %zu (%s)", i, heap.deviceLocal ? "device" : "host");
+            ImGui::SameLine(140.0f);
+            ImGui::ProgressBar(std::min(usedMB / budgetMB, 1.0f), ImVec2(-1.0f, 0.0f), overlay);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Heap size %.0f MB\nVMA blocks %.1f MB, %.1f MB of it allocated",
+                                  static_cast<float>(heap.size) / MB,
+                                  static_cast<float>(heap.blockBytes) / MB,
+                                  static_cast<float>(heap.allocationBytes) / MB);
+        }
+
+        const GpuMemoryTracker& tracker = memoryManager.GetTracker();
+        ImGui::Text("Tracked: %u allocations, %.1f MB", tracker.GetLiveCount(),
+                    static_cast<float>(tracker.GetLiveBytes()) / MB);
+
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("GpuMemoryCategories", 4, flags))
+        {
+            ImGui::TableSetupColumn("Category", ImGuiTableColumnFlags_WidthStretch);
+            for (const char* column : { "Live MB", "Count", "Peak MB" })
+                ImGui::TableSetupColumn(column);
+            ImGui::TableHeadersRow();
+
+            for (size_t c = 0; c < static_cast<size_t>(GpuMemoryCategory::Count); ++c)
+            {
+                const GpuMemoryCategory category = static_cast<GpuMemoryCategory>(c);
+                const GpuMemoryTracker::CategoryStats stats = tracker.GetCategoryStats(category);
+                if (stats.totalAllocations == 0) continue;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(GetGpuMemoryCategoryName(category));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", static_cast<float>(stats.liveBytes) / MB);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", stats.liveCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", static_cast<float>(stats.peakBytes) / MB);
+            }
+            ImGui::EndTable();
+        }
+
+        if (ImGui::Button("Log live allocations"))
+            memoryManager.LogLiveAllocations();
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Writes every category and the largest live\n"
+                              "allocations to the log, as at shutdown.");
+
+        // Compaction of device-local vertex/index buffers, a pass a frame
+        if (renderer.IsGpuDefragmenting())
+        {
+            ImGui::TextDisabled("Defragmenting...");
+        }
+        else
+        {
+            if (ImGui::Button("Defragment"))
+                renderer.RequestGpuDefragmentation();
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Moves vertex and index buffers together so emptied\n"
+                                  "memory blocks can be freed. Each pass waits for the\n"
+                                  "GPU, so frames hitch until it finishes.");
+
+            const VulkanMemoryManager::DefragmentationStats& defrag = memoryManager.GetDefragmentationStats();
+            if (defrag.passes > 0)
+            {
+                ImGui::SameLine();
+                ImGui::Text("last: %u moved (%.1f MB), %.1f MB freed",
+                    defrag.allocationsMoved, static_cast<float>(defrag.bytesMoved) / MB,
+                    static_cast<float>(defrag.bytesFreed) / MB);
+            }
+        }
+
+        if (renderer.GetCloudSystem())
+            DrawCloudNoiseMemory(*renderer.GetCloudSystem());
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawCpuMemory()
+    {
+        if (!ImGui::TreeNode("CPU Memory"))
+            return;
+
+        constexpr float MB = 1024.0f * 1024.0f;
+
+        // The frame loop's budget is zero; anything here in steady state is a
+        // container growing or being rebuilt every frame
+        const uint64_t frameAllocations = CpuMemory::GetFrameAllocations();
+        if (frameAllocations == 0)
+            ImGui::Text("Last frame: no allocations");
+        else
+            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Last frame: %llu allocations",
+                               static_cast<unsigned long long>(frameAllocations));
+        ImGui::Text("Tracked: %.1f MB", static_cast<float>(CpuMemory::GetLiveBytes()) / MB);
+
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("CpuMemoryCategories", 5, flags))
+        {
+            ImGui::TableSetupColumn("Category", ImGuiTableColumnFlags_WidthStretch);
+            for (const char* column : { "Live MB", "Count", "Peak MB", "Per frame" })
+                ImGui::TableSetupColumn(column);
+            ImGui::TableHeadersRow();
+
+            for (size_t c = 0; c < static_cast<size_t>(CpuMemoryCategory::Count); ++c)
+            {
+                const CpuMemoryCategory category = static_cast<CpuMemoryCategory>(c);
+                const CpuMemory::CategoryStats stats = CpuMemory::GetCategoryStats(category);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(GetCpuMemoryCategoryName(category));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", static_cast<float>(stats.liveBytes) / MB);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(stats.liveCount));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", static_cast<float>(stats.peakBytes) / MB);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(stats.frameAllocations));
+            }
+            ImGui::EndTable();
+        }
+
+        if (ImGui::Button("Reset peaks"))
+            CpuMemory::ResetPeaks();
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawUIOverlay(Renderer& renderer)
+    {
+        if (!ImGui::TreeNode("UI Overlay"))
+            return;
+
+        UIOverlaySettings settings = renderer.GetUIOverlaySettings();
+        bool changed = ImGui::Checkbox("Cache UI", &settings.cached);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Draws the UI into a texture of its own and lays it over every frame;\n"
+                              "panels are only rebuilt after input or at the refresh rate.");
+        ImGui::BeginDisabled(!settings.cached);
+        changed |= ImGui::SliderFloat("Refresh rate", &settings.refreshRate, 0.0f, 60.0f, "%.0f Hz");
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            ImGui::SetTooltip("Rebuilds per second with no input, for text that changes by itself.\n"
+                              "0 waits for input.");
+        ImGui::EndDisabled();
+        if (changed)
+            renderer.SetUIOverlaySettings(settings);
+
+        if (settings.cached)
+            ImGui::Text("Last build shown for %u more frames", renderer.GetUIReusedFrames());
+        ImGui::TreePop();
+    }
+
+    bool DebugPanel::TakeSceneToOpen(std::string& path)
+    {
+        if (m_SceneToOpen.empty())
+            return false;
+        path = std::move(m_SceneToOpen);
+        m_SceneToOpen.clear();
+        return true;
+    }
+
+    void DebugPanel::DrawStressScene(EditorContext& ctx)
+    {
+        if (!ImGui::TreeNode("Stress Scene"))
+            return;
+
+        int objects = static_cast<int>(m_StressDesc.objectCount);
+        if (ImGui::InputInt("Objects", &objects, 1000, 10000))
+            m_StressDesc.objectCount = static_cast<uint32_t>(std::clamp(objects, 1, 1000000));
+        int lights = static_cast<int>(m_StressDesc.pointLightCount);
+        if (ImGui::InputInt("Point lights", &lights, 16, 128))
+            m_StressDesc.pointLightCount = static_cast<uint32_t>(std::clamp(lights, 0, 4096));
+
+        const char* distributions[] = { "Uniform", "Grid", "Clustered" };
+        int distribution = static_cast<int>(m_StressDesc.distribution);
+        if (ImGui::Combo("Distribution", &distribution, distributions, IM_ARRAYSIZE(distributions)))
+            m_StressDesc.distribution = static_cast<StressDistribution>(distribution);
+        if (m_StressDesc.distribution == StressDistribution::Clustered)
+        {
+            int clusters = static_cast<int>(m_StressDesc.clusterCount);
+            if (ImGui::SliderInt("Clusters", &clusters, 1, 256))
+                m_StressDesc.clusterCount = static_cast<uint32_t>(clusters);
+            ImGui::SliderFloat("Cluster radius", &m_StressDesc.clusterRadius, 5.0f, 200.0f, "%.0f m");
+        }
+        ImGui::SliderFloat("Area per object", &m_StressDesc.areaPerObject, 1.0f, 400.0f, "%.0f m^2");
+
+        int seed = static_cast<int>(m_StressDesc.seed);
+        if (ImGui::InputInt("Seed", &seed))
+            m_StressDesc.seed = static_cast<uint32_t>(seed);
+        ImGui::InputText("File", m_StressFile, sizeof(m_StressFile));
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Written into the project folder; .json or binary by extension.\n"
+                              "Water planes and fireflies are NightbloomBench's \"stress\" config only.");
+
+        if (ImGui::Button("Generate and open"))
+        {
+            std::filesystem::path path = m_StressFile;
+            if (path.is_relative() && ctx.projectPath && !ctx.projectPath->empty())
+                path = *ctx.projectPath / path;
+
+            // The same seed always gives the same scene, so the file can be
+            // regenerated instead of kept
+            const StressScene scene = GenerateStressScene(m_StressDesc);
+            std::string error;
+            if (WriteSceneFile(path.string(), scene.data, error))
+            {
+                m_SceneToOpen = path.string();
+                m_StressStatus = "Wrote " + std::to_string(scene.data.objects.size()) + " objects, " +
+                    std::to_string(scene.data.lights.size()) + " lights";
+            }
+            else
+            {
+                m_StressStatus = "Failed: " + error;
+            }
+        }
+        if (!m_StressStatus.empty())
+            ImGui::TextDisabled("%s", m_StressStatus.c_str());
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawRenderStats()
+    {
+        if (!ImGui::TreeNode("Render Statistics"))
+            return;
+
+        RenderStats& stats = RenderStats::Get();
+        bool enabled = stats.IsEnabled();
+        if (ImGui::Checkbox("Count", &enabled))
+            stats.SetEnabled(enabled);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Counts what the CPU records per pass: draws, binds, barriers, uploads.\n"
+                              "Cached secondaries replayed as is count nothing.");
+        ImGui::SameLine();
+        int capacity = static_cast<int>(stats.GetHistoryCapacity());
+        ImGui::SetNextItemWidth(160.0f);
+        if (ImGui::SliderInt("History", &capacity, 30, 1200, "%d frames"))
+            stats.SetHistoryCapacity(static_cast<uint32_t>(capacity));
+
+        // Last frame, one row per pass that counted anything
+        const RenderFrameStats& frame = stats.GetLastFrame();
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+            ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit;
+        if (ImGui::BeginTable("RenderStatsPasses", 1 + RENDER_COUNTER_COUNT, flags, ImVec2(0.0f, 240.0f)))
+        {
+            ImGui::TableSetupScrollFreeze(1, 1);
+            ImGui::TableSetupColumn("Pass");
+            for (uint32_t c = 0; c < RENDER_COUNTER_COUNT; ++c)
+                ImGui::TableSetupColumn(GetRenderCounterName(static_cast<RenderCounter>(c)));
+            ImGui::TableHeadersRow();
+
+            auto row = [](const char* name, const RenderCounters& counters)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name);
+                for (uint64_t count : counters)
+                {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(count));
+                }
+            };
+            for (const RenderPassStats& pass : frame.passes)
+                row(pass.name.c_str(), pass.counters);
+            row("Total", frame.totals);
+            ImGui::EndTable();
+        }
+
+        // One counter over the history, for the frame or a single pass
+        ImGui::SetNextItemWidth(160.0f);
+        if (ImGui::BeginCombo("Counter", GetRenderCounterName(static_cast<RenderCounter>(m_StatsCounter))))
+        {
+            for (int c = 0; c < static_cast<int>(RENDER_COUNTER_COUNT); ++c)
+            {
+                if (ImGui::Selectable(GetRenderCounterName(static_cast<RenderCounter>(c)), c == m_StatsCounter))
+                    m_StatsCounter = c;
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(200.0f);
+        const char* passLabel = m_StatsPass < 0 ? "Frame total" : stats.GetPassName(static_cast<uint32_t>(m_StatsPass)).c_str();
+        if (ImGui::BeginCombo("Pass", passLabel))
+        {
+            if (ImGui::Selectable("Frame total", m_StatsPass < 0))
+                m_StatsPass = -1;
+            for (const RenderPassStats& pass : frame.passes)
+            {
+                const int slot = static_cast<int>(stats.RegisterPass(pass.name));
+                if (ImGui::Selectable(pass.name.c_str(), slot == m_StatsPass))
+                    m_StatsPass = slot;
+            }
+            ImGui::EndCombo();
+        }
+
+        const RenderCounter counter = static_cast<RenderCounter>(m_StatsCounter);
+        const std::vector<float> series = stats.GetSeries(counter,
+            m_StatsPass < 0 ? UINT32_MAX : static_cast<uint32_t>(m_StatsPass));
+        if (!series.empty())
+        {
+            const float peak = *std::max_element(series.begin(), series.end());
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "%.0f (peak %.0f)", series.back(), peak);
+            ImGui::PlotLines("##RenderStatsSeries", series.data(), static_cast<int>(series.size()),
+                             0, overlay, 0.0f, std::max(peak * 1.1f, 1.0f), ImVec2(-1.0f, 80.0f));
+        }
+        if (ImGui::Button("Clear History"))
+            stats.ClearHistory();
+
+        ImGui::TreePop();
+    }
+
+    void DebugPanel::DrawCloudNoiseMemory(const CloudSystem& clouds)
+    {
+        // Each volume as stored against the unpacked RGBA32F it is generated
+        // as: memory (mips included) and bytes per texel fetched
+        constexpr float MB = 1024.0f * 1024.0f;
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (!ImGui::BeginTable("CloudNoiseMemory", 5, flags))
+            return;
+
+        ImGui::TableSetupColumn("Cloud noise", ImGuiTableColumnFlags_WidthStretch);
+        for (const char* column : { "Format", "MB", "RGBA32F MB", "B/fetch" })
+            ImGui::TableSetupColumn(column);
+        ImGui::TableHeadersRow();
+
+        for (bool detail : { false, true })
+        {
+            const std::optional<NoiseTextureDesc> desc = clouds.GetResidentNoiseDesc(detail);
+            if (!desc) continue;
+
+            NoiseTextureDesc unpacked = *desc;
+            unpacked.format = NoiseTextureFormat::RGBA32F;
+            unpacked.generateMips = false;
+            const float bytes = static_cast<float>(GetNoiseTextureBytes(*desc));
+            const float unpackedBytes = static_cast<float>(GetNoiseTextureBytes(unpacked));
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s %u^3%s", detail ? "Detail" : "Shape", desc->width, desc->generateMips ? " +mips" : "");
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(GetNoiseFormatName(desc->format));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", bytes / MB);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f (%.0fx)", unpackedBytes / MB, bytes > 0.0f ? unpackedBytes / bytes : 0.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f / %.0f", GetNoiseBytesPerTexel(desc->format), GetNoiseBytesPerTexel(NoiseTextureFormat::RGBA32F));
+        }
+        ImGui::EndTable();
+    }
+
+    void DebugPanel::DrawFlameGraph(const GpuFrameProfile& frame)
+    {
+        if (frame.spans.empty())
+        {
+            ImGui::TextDisabled("No GPU spans recorded yet");
+            return;
+        }
+
+        // One shared scale, so the lanes compare at a glance (each lane still
+        // starts at its own queue's first timestamp)
+        double frameMs = 0.0;
+        for (int q = 0; q < static_cast<int>(GpuQueue::Count); ++q)
+            frameMs = std::max(frameMs, frame.GetQueueEndMs(static_cast<GpuQueue>(q)));
+        if (frameMs <= 0.0)
+            frameMs = 1.0;
+
+        const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+        const float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+        const float scale = static_cast<float>(width / frameMs);
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+        for (int q = 0; q < static_cast<int>(GpuQueue::Count); ++q)
+        {
+            const GpuQueue queue = static_cast<GpuQueue>(q);
+            uint32_t maxDepth = 0;
+            bool any = false;
+            for (const GpuSpan& span : frame.spans)
+            {
+                if (span.queue != queue) continue;
+                maxDepth = std::max(maxDepth, span.depth);
+                any = true;
+            }
+            if (!any) continue;
+
+            ImGui::Text("%s  %.3f ms", GetGpuQueueName(queue), frame.GetQueueMs(queue));
+
+            const ImVec2 origin = ImGui::GetCursorScreenPos();
+            const ImVec2 size(width, rowHeight * static_cast<float>(maxDepth + 1));
+            drawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(30, 30, 36, 255));
+            ImGui::InvisibleButton("##lane", size);
+            const bool laneHovered = ImGui::IsItemHovered();
+            const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+            for (uint32_t s = 0; s < frame.spans.size(); ++s)
+            {
+                const GpuSpan& span = frame.spans[s];
+                if (span.queue != queue) continue;
+
+                ImVec2 min(origin.x + static_cast<float>(span.startMs) * scale,
+                    origin.y + rowHeight * static_cast<float>(span.depth));
+                ImVec2 max(std::max(min.x + span.ms * scale, min.x + 1.0f), min.y + rowHeight - 1.0f);
+
+                drawList->AddRectFilled(min, max, SpanColor(span.name));
+                drawList->AddRect(min, max, IM_COL32(0, 0, 0, 120));
+                if (max.x - min.x > 24.0f)
+                {
+                    drawList->PushClipRect(min, max, true);
+                    drawList->AddText(ImVec2(min.x + 3.0f, min.y + 2.0f), IM_COL32(255, 255, 255, 255), span.name.c_str());
+                    drawList->PopClipRect();
+                }
+
+                if (laneHovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+                {
+                    ImGui::SetTooltip("%s\n%.3f ms (starts at %.3f ms)",
+                        frame.GetSpanPath(s).c_str(), span.ms, span.startMs);
+                }
+            }
+        }
+    }
 } // namespace Nightbloom
\ No newline at end of file
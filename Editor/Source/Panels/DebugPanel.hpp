@@ -1,16 +1,71 @@
 // Panels/DebugPanel.hpp
 #pragma once
 #include "../EditorContext.hpp"
+#include "Engine/Renderer/GpuProfileHistory.hpp"
+#include "Engine/Core/StressScene.hpp"
+#include <string>
 
 namespace Nightbloom
 {
+    class GpuProfiler;
+    class VulkanMemoryManager;
+    class Renderer;
+    class CloudSystem;
+
     class DebugPanel
     {
     public:
         bool isOpen = false;
         void Draw(EditorContext& ctx);
 
+        // A generated stress scene written this frame, for the editor to
+        // open like any scene file; empty when there is none
+        bool TakeSceneToOpen(std::string& path);
+
     private:
+        void DrawGpuProfiler(GpuProfiler& profiler);
+        void DrawFlameGraph(const GpuFrameProfile& frame);
+        void DrawPipelineStats(GpuProfiler& profiler, float renderPixels);
+        void DrawHalfPrecisionComparison(Renderer& renderer, GpuProfiler& profiler);
+        void DrawTraceCapture(GpuProfiler* profiler);
+        void DrawDrawStreamCapture(Renderer& renderer);
+        void DrawMetricsExport(Renderer& renderer);
+        void DrawGpuMemory(Renderer& renderer, VulkanMemoryManager& memoryManager);
+        void DrawCloudNoiseMemory(const CloudSystem& clouds);
+        void DrawCpuMemory();
+        void DrawRenderStats();
+        void DrawUIOverlay(Renderer& renderer);
+        void DrawStressScene(EditorContext& ctx);
+
         bool m_ComputeTestRan = false;
+
+        // Flame graph: frame shown (0 = newest) and a copy kept while frozen
+        int m_ProfileFrameAge = 0;
+        bool m_FreezeProfile = false;
+        GpuFrameProfile m_ProfileFrame;
+
+        // fp16 shading A/B: scope statistics captured with it off and on
+        std::vector<GpuProfileHistory::ScopeStats> m_HalfBaseline;
+        std::vector<GpuProfileHistory::ScopeStats> m_HalfCandidate;
+
+        std::string m_TraceStatus;   // result of the last trace capture
+        std::string m_DrawStreamPath;   // the last draw stream requested
+
+        // Metrics export settings, edited while it's stopped
+        char m_MetricsCsv[256] = "NightbloomMetrics.csv";
+        char m_MetricsStatsd[128] = "";
+        char m_MetricsInstance[64] = "editor";
+        int m_MetricsIntervalMs = 10000;
+
+        // Render statistics graph: counter plotted and pass (-1 = frame total)
+        int m_StatsCounter = 0;
+        int m_StatsPass = -1;
+
+        // Stress scene generator (StressScene.hpp): the desc edited, the
+        // file it's written to and the scene waiting to be opened
+        StressSceneDesc m_StressDesc;
+        char m_StressFile[128] = "StressScene.json";
+        std::string m_StressStatus;
+        std::string m_SceneToOpen;
     };
 } // namespace Nightbloom
\ No newline at end of file
@@ -28,9 +28,10 @@ namespace Nightbloom
             return;
         }
 
-        if (!EnsureInitialized(ctx.renderer))
+        ImGui::Checkbox("Enabled", &enabled);
+        if (!enabled || !m_Initialized)
         {
-            ImGui::TextDisabled("FireflySystem failed to initialize.");
+            ImGui::TextDisabled(enabled ? "Starting..." : "Off - created when enabled.");
             ImGui::End();
             return;
         }
@@ -45,7 +46,19 @@ namespace Nightbloom
             ImGui::DragFloat3("Extents", &params.boundsExtent.x, 1.0f, 1.0f, 500.0f);
 
             ImGui::Separator();
-            ImGui::SliderInt("New Agent Count", &m_AgentCount, 50, 5000);
+            const char* searchNames[] = { "Auto", "Grid", "Tiled" };
+            int search = static_cast<int>(m_Firefly.GetNeighborSearch());
+            if (ImGui::Combo("Neighbour Search", &search, searchNames, IM_ARRAYSIZE(searchNames)))
+                m_Firefly.SetNeighborSearch(static_cast<FireflyNeighborSearch>(search));
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Grid: bins agents into perception-radius cells and checks\n"
+                                  "only the 27 around each one. Tiled: checks every pair,\n"
+                                  "streamed through shared memory; cheaper for small swarms.\n"
+                                  "Auto picks Tiled up to %u agents.", FireflySystem::TILED_AGENT_LIMIT);
+            ImGui::TextDisabled("Using: %s", m_Firefly.IsUsingTiledSearch() ? "Tiled" : "Grid");
+
+            ImGui::Separator();
+            ImGui::SliderInt("New Agent Count", &m_AgentCount, 50, 100000, "%d", ImGuiSliderFlags_Logarithmic);
             if (ImGui::Button("Reinitialize Swarm", ImVec2(-1, 0)))
             {
                 glm::vec3 center(params.boundsCenter);
@@ -81,6 +94,12 @@ namespace Nightbloom
             ImGui::Separator();
             ImGui::SliderFloat("Wander Strength", &params.params3.y, 0.0f, 2.0f);
             ImGui::SliderFloat("Wander Force", &params.params3.z, 0.0f, 10.0f);
+
+            float windDrift = m_Firefly.GetWindDrift();
+            if (ImGui::SliderFloat("Wind Drift", &windDrift, 0.0f, 5.0f))
+                m_Firefly.SetWindDrift(windDrift);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("How hard the scene wind (Grass panel, Wind) pushes the swarm.");
         }
 
         if (ImGui::CollapsingHeader("Blink", ImGuiTreeNodeFlags_DefaultOpen))
@@ -89,9 +108,36 @@ namespace Nightbloom
             ImGui::SliderFloat("Global Blink Amplitude", &params.params4.y, 0.0f, 2.0f);
         }
 
+        if (ImGui::CollapsingHeader("Draw Culling"))
+        {
+            if (!m_Firefly.IsCulling())
+            {
+                ImGui::TextDisabled("No cull pipeline - every agent is drawn.");
+            }
+            else
+            {
+                FireflyCullSettings& cull = m_Firefly.GetCullSettings();
+                ImGui::Checkbox("Cull", &cull.enabled);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Skip fireflies outside the view, too dim or too far away,\n"
+                                      "and draw distant ones as points instead of billboards.");
+                ImGui::SliderFloat("Min Brightness", &cull.minBrightness, 0.0f, 0.5f);
+                ImGui::SliderFloat("Max Distance", &cull.maxDistance, 10.0f, 2000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+                ImGui::SliderFloat("Point Distance", &cull.pointDistance, 5.0f, 1000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+            }
+        }
+
         ImGui::End();
     }
 
+    void FireflyPanel::ApplyEnabled(Renderer* renderer)
+    {
+        if (!enabled)
+            Cleanup();
+        else if (renderer && !EnsureInitialized(renderer))
+            enabled = false;
+    }
+
     bool FireflyPanel::EnsureInitialized(Renderer* renderer)
     {
         if (m_Initialized) return true;
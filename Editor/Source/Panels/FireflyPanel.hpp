@@ -11,13 +11,19 @@ namespace Nightbloom
     public:
         // Closed by default — fireflies are a placed swarm, not an always-on
         // ambient system like Terrain/Clouds. Open the panel from the
-        // Window menu to add/view a swarm. See ROADMAP.md's Deferred
+        // Window menu and enable it to add/view a swarm. See ROADMAP.md's Deferred
         // Decisions for the planned move to a proper scene-hierarchy
         // entry instead of a dedicated panel.
         bool isOpen = false;
+        // Part of the scene: the swarm exists only while enabled
+        bool enabled = false;
 
         void Draw(EditorContext& ctx);
 
+        // Creates or tears down the FireflySystem to match `enabled` (see
+        // CloudPanel::ApplyEnabled)
+        void ApplyEnabled(Renderer* renderer);
+
         // Call before renderer shuts down (while Vulkan device is still alive)
         void Cleanup();
 
@@ -28,6 +34,8 @@ namespace Nightbloom
         }
 
         FireflySystem& GetSystem() { return m_Firefly; }
+        // Fireflies drift every frame once they exist
+        bool IsAnimating() const { return m_Initialized && m_Firefly.IsReady(); }
 
     private:
         FireflySystem m_Firefly;
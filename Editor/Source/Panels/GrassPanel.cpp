@@ -32,17 +32,17 @@ namespace Nightbloom
             return;
         }
 
-        if (!terrain.IsReady())
+        ImGui::Checkbox("Enabled", &enabled);
+        if (!enabled)
         {
-            ImGui::TextDisabled("Waiting on terrain...");
+            ImGui::TextDisabled("Off - created when enabled.");
             ImGui::End();
             return;
         }
 
-        // Lazy init on first draw
-        if (!EnsureInitialized(ctx.renderer))
+        if (!terrain.IsReady() || !m_GrassInitialized)
         {
-            ImGui::TextDisabled("GrassSystem failed to initialize.");
+            ImGui::TextDisabled(terrain.IsReady() ? "Starting..." : "Waiting on terrain...");
             ImGui::End();
             return;
         }
@@ -78,9 +78,21 @@ namespace Nightbloom
         // ---- Wind ---------------------------------------------------------------
         if (ImGui::CollapsingHeader("Wind", ImGuiTreeNodeFlags_DefaultOpen))
         {
-            if (ImGui::SliderFloat("Wind Speed", &m_WindSpeed, 0.0f, 5.0f)) changed = true;
             if (ImGui::SliderFloat("Wind Strength", &m_WindStrength, 0.0f, 1.0f)) changed = true;
-            if (ImGui::SliderFloat("Wind Frequency", &m_WindFrequency, 0.0f, 2.0f)) changed = true;
+
+            // The scene's wind field: the water ripples and the fireflies
+            // follow it too. Live, no regeneration.
+            WindSettings& wind = ctx.renderer->GetWindSettings();
+            ImGui::Checkbox("Wind Field", &wind.enabled);
+            ImGui::BeginDisabled(!wind.enabled);
+            ImGui::SliderFloat("Direction (deg)", &wind.directionDeg, 0.0f, 360.0f);
+            ImGui::SliderFloat("Wind Speed", &wind.speed, 0.0f, 5.0f);
+            ImGui::SliderFloat("Wind Frequency", &wind.frequency, 0.0f, 2.0f);
+            ImGui::SliderFloat("Gust Strength", &wind.gustStrength, 0.0f, 2.0f);
+            ImGui::SliderFloat("Gust Speed", &wind.gustSpeed, 0.0f, 30.0f, "%.1f m/s");
+            ImGui::SliderFloat("Gust Spacing", &wind.gustSpacing, 10.0f, 200.0f, "%.0f m");
+            ImGui::SliderFloat("Gust Width", &wind.gustWidth, 0.1f, 1.0f);
+            ImGui::EndDisabled();
         }
 
         // ---- Distance visibility (RETIRED) ---------------------------------------
@@ -99,10 +111,57 @@ namespace Nightbloom
             if (ImGui::SliderFloat("Fade Distance", &m_LodFadeDistance, 20.0f, 400.0f)) changed = true;
             if (ImGui::SliderFloat("Fade Band (blades)", &m_LodFadeBandBlades, 1.0f, 128.0f, "%.0f")) changed = true;
             if (ImGui::SliderFloat("Mesh LOD Distance", &m_MeshLodDistance, 10.0f, 300.0f)) changed = true;
+
+            if (ImGui::Checkbox("Far Field", &m_FarField)) changed = true;
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Past the blades, the terrain takes on the grass colour over the\n"
+                                  "same density field. With it on, Fade Distance can come in close\n"
+                                  "and the blade budget stays near the camera.");
+            ImGui::BeginDisabled(!m_FarField);
+            if (ImGui::SliderFloat("Far Field Strength", &m_FarFieldStrength, 0.0f, 1.0f)) changed = true;
+            ImGui::EndDisabled();
+
+            // Culling/LOD selection moves to a compute pass; no regeneration needed
+            bool gpuCulling = m_Grass.IsGpuCulling();
+            ImGui::BeginDisabled(!m_Grass.IsGpuCullingSupported());
+            if (ImGui::Checkbox("GPU Culling", &gpuCulling))
+                m_Grass.SetGpuCulling(gpuCulling);
+            ImGui::EndDisabled();
+            if (!m_Grass.IsGpuCullingSupported())
+                ImGui::TextDisabled("Needs drawIndirectCount + multiDrawIndirect.");
+        }
+
+        // ---- Density paint ------------------------------------------------------
+        if (ImGui::CollapsingHeader("Density Paint"))
+        {
+            // Re-scatters only the patches under the brush
+            ImGui::Checkbox("Paint (LMB in viewport)", &m_PaintEnabled);
+            const char* paintModes[] = { "Add", "Erase" };
+            ImGui::Combo("Brush", &m_PaintMode, paintModes, 2);
+            ImGui::SliderFloat("Radius", &m_PaintRadius, 0.5f, 100.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+            ImGui::SliderFloat("Falloff", &m_PaintFalloff, 0.0f, 1.0f);
+            ImGui::SliderFloat("Strength", &m_PaintStrength, 0.1f, 20.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+
+            ImGui::BeginDisabled(!m_Grass.HasDensityMask());
+            if (ImGui::Button("Clear Mask", ImVec2(-1, 0)))
+                m_Grass.ClearDensityMask();
+            ImGui::EndDisabled();
+            if (m_Grass.HasDensityMask())
+                ImGui::TextDisabled("Painted: scattering on the CPU.");
         }
 
         ImGui::Separator();
 
+        // The two generators use different random streams - switching re-scatters
+        bool gpuGeneration = m_Grass.IsGpuGenerationSupported() && m_Grass.IsGpuGenerationEnabled();
+        ImGui::BeginDisabled(!m_Grass.IsGpuGenerationSupported());
+        if (ImGui::Checkbox("GPU Generation", &gpuGeneration))
+        {
+            m_Grass.SetGpuGeneration(gpuGeneration);
+            changed = true;
+        }
+        ImGui::EndDisabled();
+
         if (ImGui::Button("Regenerate Now", ImVec2(-1, 0)))
             m_Grass.Regenerate(BuildDesc(terrain));
 
@@ -122,8 +181,8 @@ namespace Nightbloom
         ImGui::Separator();
         if (m_Grass.IsReady())
         {
-            ImGui::TextDisabled("Instances: %u  |  Patches: %u",
-                m_Grass.GetActiveInstanceCount(), m_Grass.GetPatchCount());
+            ImGui::TextDisabled("Instances: %u  |  Patches: %u  |  Last edit: %u",
+                m_Grass.GetActiveInstanceCount(), m_Grass.GetPatchCount(), m_Grass.GetLastUpdatedPatchCount());
         }
         else
         {
@@ -132,7 +191,7 @@ namespace Nightbloom
 
         ImGui::End();
 
-        // ---- Regen (outside Begin/End — may call WaitForIdle) -------------------
+        // ---- Regen (outside Begin/End — waits for frames in flight) -------------
         if ((changed || terrainBoundsChanged) && !ImGui::IsAnyItemActive())
         {
             m_Grass.Regenerate(BuildDesc(terrain));
@@ -151,11 +210,37 @@ namespace Nightbloom
         m_LastTerrainHeightScale = terrainDesc.heightScale;
     }
 
+    bool GrassPanel::PaintAlongRay(const TerrainSystem& terrain, const glm::vec3& origin, const glm::vec3& direction,
+        float deltaTime)
+    {
+        if (!IsPainting())
+            return false;
+
+        glm::vec3 hit;
+        if (!terrain.Raycast(origin, direction, 100000.0f, hit))
+            return false;
+
+        const float target = (m_PaintMode == 0) ? 1.0f : 0.0f;
+        return m_Grass.PaintDensity(glm::vec2(hit.x, hit.z), m_PaintRadius, m_PaintFalloff, target,
+            m_PaintStrength * deltaTime);
+    }
+
     // =========================================================================
     // Private helpers
     // =========================================================================
 
-    bool GrassPanel::EnsureInitialized(Renderer* renderer)
+    void GrassPanel::ApplyEnabled(Renderer* renderer, const TerrainSystem& terrain)
+    {
+        if (!enabled)
+            Cleanup();
+        else if (renderer && terrain.IsReady() && !EnsureInitialized(renderer, terrain))
+        {
+            Cleanup();
+            enabled = false;
+        }
+    }
+
+    bool GrassPanel::EnsureInitialized(Renderer* renderer, const TerrainSystem& terrain)
     {
         if (m_GrassInitialized) return true;
 
@@ -166,10 +251,16 @@ namespace Nightbloom
         }
 
         m_GrassInitialized = true;
-        // Terrain bounds aren't known yet without a TerrainSystem reference,
-        // but Draw() always calls BuildDesc(terrain) on the same frame right
-        // after this, since it only reaches here once terrain.IsReady().
-        m_PendingDirty = true;
+        renderer->SetGrassSystem(&m_Grass);
+
+        // Scattered here rather than by Draw, which doesn't run while the
+        // panel is closed
+        m_Grass.Regenerate(BuildDesc(terrain));
+        m_PendingDirty = false;
+        const TerrainDesc& terrainDesc = terrain.GetDesc();
+        m_LastTerrainPosition = terrainDesc.position;
+        m_LastTerrainWorldSize = terrainDesc.worldSize;
+        m_LastTerrainHeightScale = terrainDesc.heightScale;
 
         return true;
     }
@@ -191,9 +282,7 @@ namespace Nightbloom
         desc.densityFrequency = m_DensityFrequency;
         desc.densityOctaves = static_cast<uint32_t>(m_DensityOctaves);
 
-        desc.windSpeed = m_WindSpeed;
         desc.windStrength = m_WindStrength;
-        desc.windFrequency = m_WindFrequency;
 
         desc.slopeThresholdDeg = m_SlopeThresholdDeg;
         desc.slopeFalloffDeg = m_SlopeFalloffDeg;
@@ -203,6 +292,8 @@ namespace Nightbloom
         desc.lodFadeDistance = m_LodFadeDistance;
         desc.lodFadeBandBlades = m_LodFadeBandBlades;
         desc.meshLodDistance = m_MeshLodDistance;
+        desc.farField = m_FarField;
+        desc.farFieldStrength = m_FarFieldStrength;
         desc.colorVariation = m_ColorVariation;
         desc.seed = static_cast<uint32_t>(m_Seed);
 
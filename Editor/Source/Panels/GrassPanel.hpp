@@ -13,6 +13,9 @@ namespace Nightbloom
     {
     public:
         bool isOpen = true;
+        // Part of the scene: the GrassSystem (and its instance buffer) exists
+        // only while enabled. Waits for the terrain to be ready.
+        bool enabled = false;
 
         // Needs the terrain panel's TerrainSystem (world bounds + heightmap)
         // since GrassSystem has no CPU height query of its own — see
@@ -22,15 +25,35 @@ namespace Nightbloom
         // Call before renderer shuts down (while Vulkan device is still alive)
         void Cleanup();
 
+        // Creates or tears down the GrassSystem to match `enabled` (see
+        // CloudPanel::ApplyEnabled)
+        void ApplyEnabled(Renderer* renderer, const TerrainSystem& terrain);
+
         void SubmitGrassDraw(DrawList& drawList, const Frustum& frustum, const TerrainSystem& terrain,
             const glm::vec3& cameraPosition)
         {
-            if (m_GrassInitialized && m_Grass.IsReady() && terrain.IsReady())
+            // Grass maps the whole terrain square onto the heightmap, which a
+            // streamed tile window doesn't have — no grass while streaming
+            if (m_GrassInitialized && m_Grass.IsReady() && terrain.IsReady() && !terrain.IsStreaming())
             {
                 m_Grass.SubmitDraw(drawList, frustum, terrain.GetHeightmapDescriptorSet(), cameraPosition);
             }
         }
 
+        // The editor routes left-drag in the viewport here while painting
+        bool IsPainting() const { return m_PaintEnabled && m_GrassInitialized && m_Grass.IsReady(); }
+
+        // Dabs the density brush where the ray meets the terrain; only the
+        // patches under it are re-scattered. False on a miss.
+        bool PaintAlongRay(const TerrainSystem& terrain, const glm::vec3& origin, const glm::vec3& direction,
+            float deltaTime);
+
+        // Blades sway in the wind
+        bool IsAnimating() const
+        {
+            return m_GrassInitialized && m_Grass.IsReady() && m_WindStrength != 0.0f;
+        }
+
     private:
         GrassSystem m_Grass;
         bool        m_GrassInitialized = false;
@@ -62,10 +85,9 @@ namespace Nightbloom
         int   m_DensityOctaves = 2;
         int   m_Seed = 1337;
 
-        // Wind
-        float m_WindSpeed = 1.0f;
+        // Wind - how far the blades bend; the wind itself is the renderer's
+        // (Renderer::GetWindSettings), edited live in the same section
         float m_WindStrength = 0.15f;
-        float m_WindFrequency = 0.3f;
 
         // Cliff avoidance + color
         float m_SlopeThresholdDeg = 45.0f;
@@ -82,6 +104,15 @@ namespace Nightbloom
         float m_LodFadeDistance = 130.0f;
         float m_LodFadeBandBlades = 16.0f;
         float m_MeshLodDistance = 55.0f;
+        bool  m_FarField = true;
+        float m_FarFieldStrength = 0.85f;
+
+        // Density paint (left-drag in the viewport, see GrassDensityMask)
+        bool  m_PaintEnabled = false;
+        int   m_PaintMode = 1;           // 0 = add, 1 = erase
+        float m_PaintRadius = 6.0f;
+        float m_PaintFalloff = 0.5f;
+        float m_PaintStrength = 4.0f;    // share of the way to the target per second
 
         // Cached terrain bounds, to detect terrain changes that should
         // trigger a re-placement even if no grass slider moved.
@@ -90,7 +121,7 @@ namespace Nightbloom
         float     m_LastTerrainHeightScale = 0.0f;
 
         GrassDesc BuildDesc(const TerrainSystem& terrain) const;
-        bool      EnsureInitialized(Renderer* renderer);
+        bool      EnsureInitialized(Renderer* renderer, const TerrainSystem& terrain);
     };
 
 } // namespace Nightbloom
@@ -32,9 +32,31 @@ namespace Nightbloom
         strncpy(nameBuf, selected->name.c_str(), sizeof(nameBuf) - 1);
         nameBuf[sizeof(nameBuf) - 1] = '\0';
         if (ImGui::InputText("Name", nameBuf, sizeof(nameBuf)))
-            selected->name = nameBuf;
+            ctx.scene->RenameObject(ctx.scene->GetSelectedIndex(), nameBuf);
 
-        ImGui::Checkbox("Visible", &selected->visible);
+        bool visible = selected->IsVisible();
+        if (ImGui::Checkbox("Visible", &visible))
+            selected->SetVisible(visible);
+
+        // Parent (the transform below is relative to it)
+        const int selectedIndex = ctx.scene->GetSelectedIndex();
+        const int parent = ctx.scene->GetParent(selectedIndex);
+        const char* parentName = parent >= 0 ? ctx.scene->GetObject(parent)->name.c_str() : "(none)";
+        if (ImGui::BeginCombo("Parent", parentName))
+        {
+            if (ImGui::Selectable("(none)", parent < 0))
+                ctx.scene->SetParent(selectedIndex, -1);
+            for (size_t i = 0; i < ctx.scene->GetObjectCount(); ++i)
+            {
+                if (static_cast<int>(i) == selectedIndex) continue;
+                ImGui::PushID(static_cast<int>(i));
+                // Fails (no-op) for our own descendants
+                if (ImGui::Selectable(ctx.scene->GetObject(i)->name.c_str(), parent == static_cast<int>(i)))
+                    ctx.scene->SetParent(selectedIndex, static_cast<int>(i));
+                ImGui::PopID();
+            }
+            ImGui::EndCombo();
+        }
         ImGui::Separator();
 
         // Transform
@@ -90,6 +112,8 @@ namespace Nightbloom
             ImGui::Text("Meshes: %zu", selected->GetMeshCount());
             ImGui::Text("Vertices: %zu", selected->GetVertexCount());
             ImGui::Text("Indices: %zu", selected->GetIndexCount());
+            // Other objects placing the same file draw this Model too
+            ImGui::Text("Shared by: %ld objects", selected->model.use_count());
 
             if (ImGui::TreeNode("Meshes"))
             {
@@ -2,6 +2,7 @@
 #include "LightingPanel.hpp"
 #include "Engine/Core/Scene.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Components/LightClusterCuller.hpp"
 #include "Engine/Renderer/Light.hpp"
 #include <imgui.h>
 #include <glm/glm.hpp>
@@ -20,11 +21,14 @@ namespace Nightbloom
             return;
         }
 
+        DrawClusteredLighting(ctx);
+
         Light* selectedLight = ctx.scene->GetSelectedLight();
 
         if (!selectedLight)
         {
-            ImGui::Text("Lights: %zu", ctx.scene->GetLightCount());
+            ImGui::Text("Lights: %zu (%zu point lights out of view)",
+                ctx.scene->GetLightCount(), ctx.scene->GetLastCulledLightCount());
             ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
                 "Select a light in the hierarchy to edit");
             ImGui::End();
@@ -81,6 +85,11 @@ namespace Nightbloom
             ImGui::DragFloat3("Position", &selectedLight->position.x, 0.1f);
             ImGui::SliderFloat("Radius", &selectedLight->radius, 1.0f, 200.0f);
 
+            // Range query on the scene BVH: the objects this light can reach
+            m_ObjectsInRange.clear();
+            ctx.scene->QuerySphere(selectedLight->position, selectedLight->radius, m_ObjectsInRange);
+            ImGui::TextDisabled("Objects in range: %zu", m_ObjectsInRange.size());
+
             if (ImGui::CollapsingHeader("Attenuation"))
             {
                 ImGui::SliderFloat("Constant", &selectedLight->constant, 0.0f, 5.0f);
@@ -138,10 +147,94 @@ namespace Nightbloom
             if (ImGui::Checkbox("Enable Shadow Pass", &shadowEnabled))
                 ctx.renderer->SetShadowEnabled(shadowEnabled);
 
+            // Screen-space, from lights[0]; on top of the cascades
+            if (ctx.renderer->SupportsContactShadows() && ImGui::TreeNode("Contact Shadows"))
+            {
+                ContactShadowSettings& contact = ctx.renderer->GetContactShadowSettings();
+                ImGui::Checkbox("Enabled##contact", &contact.enabled);
+                ImGui::SliderFloat("Length##contact", &contact.length, 0.05f, 4.0f, "%.2f");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("World units marched toward the light from each pixel.");
+                ImGui::SliderFloat("Thickness##contact", &contact.thickness, 0.01f, 2.0f, "%.2f");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip(
+                        "How deep a surface is assumed to be behind what the depth buffer sees.\n"
+                        "Too thin -> blades miss each other; too thick -> halos behind edges.");
+                ImGui::SliderFloat("Strength##contact", &contact.strength, 0.0f, 1.0f, "%.2f");
+                ImGui::SliderFloat("Max Distance##contact", &contact.maxDistance, 5.0f, 300.0f, "%.0f");
+                int steps = static_cast<int>(contact.steps);
+                if (ImGui::SliderInt("Steps##contact", &steps, 1, static_cast<int>(ContactShadow::MAX_STEPS)))
+                    contact.steps = static_cast<uint32_t>(steps);
+                ImGui::TreePop();
+            }
+
+            // Point lights with castsShadows, in tiles of one atlas
+            if (ctx.renderer->SupportsLocalShadows() && ImGui::TreeNode("Point Light Shadows"))
+            {
+                LocalShadowSettings& local = ctx.renderer->GetLocalShadowSettings();
+                ImGui::Checkbox("Enabled##local", &local.enabled);
+
+                int maxLights = static_cast<int>(local.maxLights);
+                if (ImGui::SliderInt("Max Lights##local", &maxLights, 1, static_cast<int>(MAX_LOCAL_SHADOWS)))
+                    local.maxLights = static_cast<uint32_t>(maxLights);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Lights shadowed at once; the largest on screen win.");
+
+                int maxTile = static_cast<int>(local.maxTileSize);
+                if (ImGui::SliderInt("Max Tile##local", &maxTile, 128, 1024))
+                    local.maxTileSize = static_cast<uint32_t>(maxTile);
+                int minTile = static_cast<int>(local.minTileSize);
+                if (ImGui::SliderInt("Min Tile##local", &minTile, 16, 256))
+                    local.minTileSize = static_cast<uint32_t>(minTile);
+                ImGui::SliderFloat("Tile Scale##local", &local.tileScale, 0.1f, 2.0f, "%.2f");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Texels per face for each pixel the light's sphere covers on screen.");
+                ImGui::SliderFloat("Normal Bias##local", &local.normalBias, 0.0f, 4.0f, "%.2f texels");
+                ImGui::Checkbox("Cache Static Lights##local", &local.cacheStatic);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Redraw a light only when a caster within its radius changes.");
+
+                uint32_t lights = 0, faces = 0;
+                ctx.renderer->GetLocalShadowStats(lights, faces);
+                ImGui::Text("Shadowed: %u  Faces drawn: %u", lights, faces);
+                ImGui::TreePop();
+            }
+
+            // Ray queries toward lights[0] instead of the cascades
+            if (ctx.renderer->SupportsRayTracedShadows() && ImGui::TreeNode("Ray-Traced Sun Shadows"))
+            {
+                RayTracedShadowSettings& traced = ctx.renderer->GetRayTracedShadowSettings();
+                ImGui::Checkbox("Enabled##traced", &traced.enabled);
+                if (traced.enabled && !ctx.renderer->IsRayTracedShadowActive())
+                    ImGui::TextDisabled("Building ray-query pipelines - cascades meanwhile");
+
+                int rate = static_cast<int>(traced.rate);
+                if (ImGui::Combo("Rate##traced", &rate, "Full\0Quad Shared\0"))
+                    traced.rate = static_cast<RayTracedShadowRate>(rate);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Quad Shared traces one ray per two pixels and averages each 2x2 quad.");
+                ImGui::BeginDisabled(traced.rate == RayTracedShadowRate::QuadShared);
+                ImGui::Checkbox("Denoise##traced", &traced.denoise);
+                ImGui::EndDisabled();
+
+                ImGui::SliderFloat("Sun Radius##traced", &traced.sunAngularRadiusDeg, 0.0f, 2.0f, "%.2f deg");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Angular radius the rays are jittered over; 0 = hard shadows.");
+                ImGui::SliderFloat("Max Distance##traced", &traced.maxDistance, 10.0f, 2000.0f, "%.0f");
+                ImGui::SliderFloat("Origin Offset##traced", &traced.originOffset, 0.0f, 0.5f, "%.3f");
+
+                uint32_t instances = 0, blases = 0;
+                ctx.renderer->GetRayTracedShadowStats(instances, blases);
+                ImGui::Text("Instances: %u  BLASes: %u", instances, blases);
+                ImGui::TreePop();
+            }
+
             if (selectedLight->type != LightType::Directional)
             {
-                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f),
-                    "Shadow mapping is only supported for Directional lights.");
+                ImGui::Spacing();
+                ImGui::Checkbox("Light Casts Shadows", &selectedLight->shadowConfig.castsShadows);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Six faces in the point light shadow atlas, sized by the light's size on screen.");
                 ImGui::End();
                 return;
             }
@@ -186,6 +279,14 @@ namespace Nightbloom
                     "Higher shrinks the near cascades -> much sharper shadows up close.\n"
                     "*** This is the main knob for close-up shadow quality. ***");
 
+            if (ImGui::Checkbox("Fit Splits To Depth", &cfg.fitSplitsToDepth))
+                changed = true;
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip(
+                    "Split only the depth range that holds visible geometry (measured by\n"
+                    "the Hi-Z pass a few frames back) instead of near..Shadow Distance.\n"
+                    "Sharper cascades when the view ends short of Shadow Distance.");
+
             if (ImGui::SliderFloat("Caster Extrude", &cfg.casterExtrude, 0.0f, 200.0f, "%.0f"))
                 changed = true;
             if (ImGui::IsItemHovered())
@@ -216,6 +317,14 @@ namespace Nightbloom
                         "cascade at long Shadow Distance. Memory shown is for all cascades.");
             }
 
+            if (ImGui::SliderFloat4("Cascade Resolution", cfg.cascadeResolutionScale.data(), 0.125f, 1.0f, "%.3f"))
+                changed = true;
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip(
+                    "Fraction of Shadow Resolution each cascade renders at, near to far\n"
+                    "(e.g. 1 / 0.5 / 0.5 / 0.25). Lower far cascades save shadow fill;\n"
+                    "the layers keep their memory.");
+
             // -----------------------------------------------------------------
             // Bias
             // -----------------------------------------------------------------
@@ -293,6 +402,15 @@ namespace Nightbloom
             if (changed)
                 ctx.renderer->SetShadowConfig(cfg);
 
+            bool pcf = ctx.renderer->GetShadowPcf();
+            if (ImGui::Checkbox("PCF Filtering", &pcf))
+                ctx.renderer->SetShadowPcf(pcf);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip(
+                    "3x3 percentage-closer filtering for soft shadow edges.\n"
+                    "Off samples once per pixel (hard edges, cheaper). The first\n"
+                    "toggle compiles a pipeline variant in the background.");
+
             // -----------------------------------------------------------------
             // CSM debug
             // -----------------------------------------------------------------
@@ -356,4 +474,48 @@ namespace Nightbloom
         ImGui::End();
     }
 
+    void LightingPanel::DrawClusteredLighting(EditorContext& ctx)
+    {
+        if (!ctx.renderer || !ImGui::CollapsingHeader("Clustered Lighting"))
+            return;
+
+        if (!ctx.renderer->SupportsClusteredLighting())
+        {
+            ImGui::TextDisabled("Unavailable (needs compute) - point lights use the 16-light loop.");
+            return;
+        }
+
+        Renderer::ClusteredLightingSettings& cl = ctx.renderer->GetClusteredLightingSettings();
+        ImGui::Checkbox("Enabled##clusters", &cl.enabled);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip(
+                "Cull point lights into 16x9x24 view clusters on the GPU; each pixel\n"
+                "shades only its cluster's lights, however many the scene has.\n"
+                "Off = the first 16 lights in the lighting UBO, looped per pixel.");
+
+        ImGui::SliderFloat("Slice Distance", &cl.farDistance, 50.0f, 2000.0f, "%.0f",
+            ImGuiSliderFlags_Logarithmic);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("View depth the depth slices are spread over (the last one runs on).");
+
+        ImGui::Checkbox("Firefly Lights", &cl.fireflyLights);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Every firefly lights the ground and grass around it.");
+        if (cl.fireflyLights)
+        {
+            ImGui::SliderFloat("Firefly Radius", &cl.fireflyRadius, 0.5f, 16.0f, "%.1f");
+            ImGui::SliderFloat("Firefly Intensity", &cl.fireflyIntensity, 0.0f, 8.0f, "%.2f");
+        }
+
+        if (const LightClusterCuller* culler = ctx.renderer->GetLightClusterCuller())
+        {
+            ImGui::Text("Lights: %u scene, %u firefly", culler->GetSceneLightCount(), culler->GetFireflyLightCount());
+            if (culler->GetDroppedLightCount() > 0)
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%u dropped (over %u)",
+                    culler->GetDroppedLightCount(), LightClusterCuller::MAX_LIGHTS);
+            }
+        }
+    }
+
 } // namespace Nightbloom
\ No newline at end of file
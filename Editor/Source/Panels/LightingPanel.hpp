@@ -2,6 +2,8 @@
 #pragma once
 #include "../EditorContext.hpp"
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
 
 namespace Nightbloom
 {
@@ -12,8 +14,13 @@ namespace Nightbloom
         void Draw(EditorContext& ctx);
 
     private:
+        // Renderer-wide point light culling; independent of the selection
+        void DrawClusteredLighting(EditorContext& ctx);
+
         // Persists shadow frustum center across frames without a static local.
         // Promoted from static so the value survives panel re-opens cleanly.
         glm::vec3 m_ShadowCenter = glm::vec3(0.0f);
+
+        std::vector<uint32_t> m_ObjectsInRange;   // selected point light's range query scratch
     };
 } // namespace Nightbloom
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace Nightbloom
         void Draw(EditorContext& ctx);
 
         float GetRotation() const { return m_Rotation; }
+        bool IsAnimating() const { return m_RotationSpeed != 0.0f; }
 
     private:
         float m_Rotation = 0.0f;
@@ -18,10 +18,14 @@ namespace Nightbloom
             m_PreviewID = 0;
             m_RegisteredTex = nullptr;
         }
+        m_PendingTex = nullptr;
     }
 
     void NoiseDebugPanel::Cleanup()
     {
+        // A queued registration would write into a panel that's gone
+        if (m_Tasks)
+            m_Tasks->Cancel(this);
         UnregisterPreview();
     }
 
@@ -36,6 +40,15 @@ namespace Nightbloom
             return;
         }
 
+        // Closed this frame: the preview is only made for this panel
+        if (!isOpen)
+        {
+            UnregisterPreview();
+            ctx.renderer->ReleaseNoisePreview();
+            ImGui::End();
+            return;
+        }
+
         // Parameters
         const char* noiseTypes[] = { "Perlin", "Worley", "PerlinWorley" };
         ImGui::Combo("Type", &m_NoiseType, noiseTypes, 3);
@@ -71,18 +84,29 @@ namespace Nightbloom
         VulkanTexture* noiseTex = ctx.renderer->GetNoisePreview();
         if (noiseTex)
         {
-            // Register with ImGui if new or changed
-            if (noiseTex != m_RegisteredTex)
+            // Register with ImGui if new or changed, within the frame's
+            // main-thread budget; skipped if the preview changed again first
+            if (noiseTex != m_RegisteredTex && noiseTex != m_PendingTex)
             {
                 UnregisterPreview();
+                m_PendingTex = noiseTex;
+
+                Renderer* renderer = ctx.renderer;
+                m_Tasks = &renderer->GetMainThreadTasks();
+                m_Tasks->Post([this, renderer, noiseTex]()
+                    {
+                        if (m_PendingTex != noiseTex || renderer->GetNoisePreview() != noiseTex)
+                            return;
 
-                m_PreviewID = reinterpret_cast<ImTextureID>(
-                    ImGui_ImplVulkan_AddTexture(
-                        noiseTex->GetSampler(),
-                        noiseTex->GetImageView(),
-                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+                        m_PreviewID = reinterpret_cast<ImTextureID>(
+                            ImGui_ImplVulkan_AddTexture(
+                                noiseTex->GetSampler(),
+                                noiseTex->GetImageView(),
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
 
-                m_RegisteredTex = noiseTex;
+                        m_RegisteredTex = noiseTex;
+                        m_PendingTex = nullptr;
+                    }, TaskPriority::Low, this);
             }
 
             if (m_PreviewID)
@@ -92,6 +116,10 @@ namespace Nightbloom
                 ImGui::Text("256x256 | Type: %s | Octaves: %d | Freq: %.1f",
                     noiseTypes[m_NoiseType], m_NoiseOctaves, m_NoiseFreq);
             }
+            else
+            {
+                ImGui::TextDisabled("Registering preview...");
+            }
         }
         else
         {
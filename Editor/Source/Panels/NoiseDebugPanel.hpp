@@ -6,6 +6,7 @@
 namespace Nightbloom
 {
     class VulkanTexture;
+    class MainThreadTaskQueue;
 
     class NoiseDebugPanel
     {
@@ -26,9 +27,13 @@ namespace Nightbloom
         float m_NoiseLacun = 2.0f;
         int   m_NoiseSeed = 42;
 
-        // ImGui texture state
+        // ImGui texture state. Registration is a main-thread task
+        // (Renderer::GetMainThreadTasks), so a new preview shows a frame or
+        // so after it's generated.
         ImTextureID    m_PreviewID = 0;
         VulkanTexture* m_RegisteredTex = nullptr;
+        VulkanTexture* m_PendingTex = nullptr;
+        MainThreadTaskQueue* m_Tasks = nullptr;   // where the registration was posted, for Cleanup
 
         void UnregisterPreview();
     };
@@ -0,0 +1,177 @@
+// Panels/ParticlePanel.cpp
+#include "ParticlePanel.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <imgui.h>
+#include <algorithm>
+
+namespace Nightbloom
+{
+    void ParticlePanel::Cleanup()
+    {
+        if (m_Initialized)
+        {
+            m_Particles.Shutdown();
+            m_Initialized = false;
+        }
+    }
+
+    void ParticlePanel::Draw(EditorContext& ctx)
+    {
+        if (!isOpen) return;
+
+        ImGui::Begin("Particles", &isOpen);
+
+        if (!ctx.renderer)
+        {
+            ImGui::TextDisabled("No renderer available.");
+            ImGui::End();
+            return;
+        }
+
+        if (!EnsureInitialized(ctx.renderer))
+        {
+            ImGui::TextDisabled("ParticleSystem failed to initialize.");
+            ImGui::End();
+            return;
+        }
+
+        if (ImGui::CollapsingHeader("Pool", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            uint32_t used = 0;
+            for (uint32_t i = 0; i < m_Particles.GetEmitterCount(); ++i)
+                used += m_Particles.GetEmitterRange(i).capacity;
+            ImGui::TextDisabled("Capacity: %u particles, %u assigned", m_Particles.GetPoolCapacity(), used);
+
+            ImGui::SliderInt("New Pool Capacity", &m_PoolCapacity, 1024, 1 << 21, "%d", ImGuiSliderFlags_Logarithmic);
+            if (ImGui::Button("Reinitialize Pool", ImVec2(-1, 0)))
+            {
+                std::vector<ParticleEmitterDesc> emitters;
+                for (uint32_t i = 0; i < m_Particles.GetEmitterCount(); ++i)
+                    emitters.push_back(m_Particles.GetEmitter(i));
+
+                m_Particles.Shutdown(); // also clears Renderer's ParticleSystem pointer
+                m_Initialized = false;
+
+                if (m_Particles.Initialize(ctx.renderer, static_cast<uint32_t>(m_PoolCapacity)))
+                {
+                    m_Initialized = true;
+                    ctx.renderer->SetParticleSystem(&m_Particles);
+                    for (const ParticleEmitterDesc& emitter : emitters)
+                        m_Particles.AddEmitter(emitter);
+                }
+                else
+                {
+                    LOG_ERROR("ParticlePanel: failed to reinitialize ParticleSystem");
+                }
+            }
+        }
+
+        if (!m_Initialized)
+        {
+            ImGui::End();
+            return;
+        }
+
+        if (ImGui::CollapsingHeader("Add Emitter", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            const bool full = m_Particles.GetEmitterCount() >= ParticleSystem::MAX_EMITTERS;
+            ImGui::BeginDisabled(full);
+            if (ImGui::Button("Pollen")) m_Particles.AddEmitter(ParticleEmitterDesc::Pollen());
+            ImGui::SameLine();
+            if (ImGui::Button("Rain")) m_Particles.AddEmitter(ParticleEmitterDesc::Rain());
+            ImGui::SameLine();
+            if (ImGui::Button("Embers")) m_Particles.AddEmitter(ParticleEmitterDesc::Embers());
+            ImGui::SameLine();
+            if (ImGui::Button("Empty")) m_Particles.AddEmitter(ParticleEmitterDesc{});
+            ImGui::EndDisabled();
+        }
+
+        bool replan = false;
+        uint32_t removeIndex = ParticleSystem::INVALID_EMITTER;
+        for (uint32_t i = 0; i < m_Particles.GetEmitterCount(); ++i)
+        {
+            ParticleEmitterDesc& emitter = m_Particles.GetEmitter(i);
+            ImGui::PushID(static_cast<int>(i));
+            if (ImGui::CollapsingHeader(emitter.name.c_str()))
+            {
+                const ParticleRange& range = m_Particles.GetEmitterRange(i);
+                ImGui::TextDisabled("Slice: %u particles from %u", range.capacity, range.base);
+
+                replan |= DrawEmitter(emitter);
+                if (ImGui::Button("Remove", ImVec2(-1, 0)))
+                    removeIndex = i;
+            }
+            ImGui::PopID();
+        }
+
+        if (removeIndex != ParticleSystem::INVALID_EMITTER)
+            m_Particles.RemoveEmitter(removeIndex);
+        else if (replan)
+            m_Particles.RestartEmitters();
+
+        ImGui::End();
+    }
+
+    bool ParticlePanel::DrawEmitter(ParticleEmitterDesc& emitter)
+    {
+        ImGui::Checkbox("Enabled", &emitter.enabled);
+
+        int capacity = static_cast<int>(emitter.capacity);
+        ImGui::SliderInt("Capacity", &capacity, 256, 1 << 20, "%d", ImGuiSliderFlags_Logarithmic);
+        const bool replan = ImGui::IsItemDeactivatedAfterEdit();
+        emitter.capacity = static_cast<uint32_t>(std::max(capacity, 0));
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Restarts every emitter once the slider is released.");
+        ImGui::SliderFloat("Spawn Rate", &emitter.spawnRate, 0.0f, 200000.0f, "%.0f /s", ImGuiSliderFlags_Logarithmic);
+
+        ImGui::Separator();
+        ImGui::Checkbox("Follow Camera", &emitter.followCamera);
+        ImGui::DragFloat3("Center", &emitter.center.x, 0.1f);
+        ImGui::DragFloat3("Extents", &emitter.extents.x, 0.1f, 0.0f, 500.0f);
+        ImGui::DragFloat3("Velocity Min", &emitter.velocityMin.x, 0.05f);
+        ImGui::DragFloat3("Velocity Max", &emitter.velocityMax.x, 0.05f);
+        ImGui::DragFloatRange2("Lifetime", &emitter.lifetimeMin, &emitter.lifetimeMax, 0.05f, 0.01f, 60.0f, "%.2f s");
+
+        ImGui::Separator();
+        ImGui::DragFloat3("Gravity", &emitter.gravity.x, 0.05f);
+        ImGui::SliderFloat("Drag", &emitter.drag, 0.0f, 5.0f);
+        ImGui::SliderFloat("Wind", &emitter.windInfluence, 0.0f, 5.0f);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("How far the scene wind (Grass panel, Wind) carries the particles.");
+        ImGui::SliderFloat("Turbulence", &emitter.turbulence, 0.0f, 10.0f);
+        ImGui::SliderFloat("Turbulence Scale", &emitter.turbulenceScale, 0.01f, 2.0f);
+
+        ImGui::Separator();
+        const char* blendNames[] = { "Additive", "Translucent" };
+        int blend = static_cast<int>(emitter.blend);
+        if (ImGui::Combo("Blend", &blend, blendNames, IM_ARRAYSIZE(blendNames)))
+            emitter.blend = static_cast<ParticleBlend>(blend);
+        ImGui::DragFloatRange2("Size", &emitter.sizeMin, &emitter.sizeMax, 0.001f, 0.001f, 5.0f, "%.3f m");
+        ImGui::SliderFloat("Size At Death", &emitter.sizeEnd, 0.0f, 4.0f);
+        ImGui::SliderFloat("Stretch", &emitter.stretch, 0.0f, 0.2f, "%.3f s");
+        ImGui::ColorEdit4("Color Start", &emitter.colorStart.x, ImGuiColorEditFlags_HDR | ImGuiColorEditFlags_Float);
+        ImGui::ColorEdit4("Color End", &emitter.colorEnd.x, ImGuiColorEditFlags_HDR | ImGuiColorEditFlags_Float);
+        ImGui::SliderFloat("Fade In", &emitter.fadeIn, 0.0f, 1.0f);
+        ImGui::SliderFloat("Fade Out", &emitter.fadeOut, 0.0f, 1.0f);
+
+        return replan;
+    }
+
+    bool ParticlePanel::EnsureInitialized(Renderer* renderer)
+    {
+        if (m_Initialized) return true;
+
+        if (!m_Particles.Initialize(renderer, static_cast<uint32_t>(m_PoolCapacity)))
+        {
+            LOG_ERROR("ParticlePanel: ParticleSystem::Initialize failed");
+            return false;
+        }
+
+        renderer->SetParticleSystem(&m_Particles);
+
+        m_Initialized = true;
+        return true;
+    }
+
+} // namespace Nightbloom
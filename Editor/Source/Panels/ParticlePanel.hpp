@@ -0,0 +1,43 @@
+// Panels/ParticlePanel.hpp
+#pragma once
+#include "../EditorContext.hpp"
+#include "Engine/VFX/ParticleSystem.hpp"
+#include <imgui.h>
+
+namespace Nightbloom
+{
+    class ParticlePanel
+    {
+    public:
+        // Closed by default, like the fireflies: weather and effects are
+        // added from the panel (Window menu), not always on
+        bool isOpen = false;
+
+        void Draw(EditorContext& ctx);
+
+        // Call before renderer shuts down (while Vulkan device is still alive)
+        void Cleanup();
+
+        void SubmitParticleDraw(DrawList& drawList, const glm::vec3& cameraPosition) const
+        {
+            if (m_Initialized && m_Particles.IsReady())
+                m_Particles.SubmitDraw(drawList, cameraPosition);
+        }
+
+        ParticleSystem& GetSystem() { return m_Particles; }
+        // Particles move every frame while any emitter exists
+        bool IsAnimating() const { return m_Initialized && m_Particles.IsReady() && m_Particles.HasEmitters(); }
+
+    private:
+        ParticleSystem m_Particles;
+        bool           m_Initialized = false;
+
+        // Pool size is fixed at init (buffer size); emitters share it
+        int m_PoolCapacity = 262144;
+
+        bool EnsureInitialized(Renderer* renderer);
+        // True when the emitter asks for its pool slice to be replanned
+        bool DrawEmitter(ParticleEmitterDesc& emitter);
+    };
+
+} // namespace Nightbloom
@@ -9,123 +9,250 @@
 #include "Engine/Core/Logger/Logger.hpp"
 #include "../EditorFileUtils.hpp"
 #include <imgui.h>
+#include <algorithm>
+#include <cctype>
 #include <memory>
 #include <filesystem>
 
 namespace Nightbloom
 {
-    void SceneHierarchyPanel::Draw(EditorContext& ctx)
+    namespace
     {
-        ImGui::Begin("Scene Hierarchy", &isOpen);
+        const ImVec4 kDimmed(0.5f, 0.5f, 0.5f, 1.0f);
+    }
 
-        if (!ctx.scene)
-        {
-            ImGui::Text("No scene loaded");
-            ImGui::End();
+    void SceneHierarchyPanel::SyncOutline(const Scene& scene)
+    {
+        if (&scene == m_OutlineScene && scene.GetStructureVersion() == m_OutlineVersion)
             return;
-        }
+        m_OutlineScene = &scene;
+        m_OutlineVersion = scene.GetStructureVersion();
+
+        const auto& objects = scene.GetObjects();
+        m_Outline.Rebuild(static_cast<uint32_t>(objects.size()),
+            [&scene](uint32_t i)
+            {
+                const int parent = scene.GetParent(i);
+                return parent < 0 ? SceneOutline::NONE : static_cast<uint32_t>(parent);
+            },
+            [&objects](uint32_t i) -> const std::string& { return objects[i].name; });
+    }
 
-        ImGuiTreeNodeFlags rootFlags =
-            ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_OpenOnArrow;
+    void SceneHierarchyPanel::UpdateLightMatches(const Scene& scene)
+    {
+        // Few enough to scan every frame, which also catches renames
+        std::string search = m_Search;
+        std::transform(search.begin(), search.end(), search.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
 
-        if (ImGui::TreeNodeEx("Scene", rootFlags))
+        m_LightMatches.clear();
+        const auto& lights = scene.GetLights();
+        for (uint32_t i = 0; i < lights.size(); ++i)
         {
-            auto& objects = ctx.scene->GetObjects();
-            int selectedIndex = ctx.scene->GetSelectedIndex();
+            std::string name = lights[i].name;
+            std::transform(name.begin(), name.end(), name.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (name.find(search) != std::string::npos)
+                m_LightMatches.push_back(i);
+        }
+    }
 
-            for (size_t i = 0; i < objects.size(); ++i)
-            {
-                auto& obj = objects[i];
+    void SceneHierarchyPanel::DrawObjectRow(Scene& scene, uint32_t index, uint32_t depth, bool hasChildren)
+    {
+        SceneObject& obj = scene.GetObjects()[index];
 
-                ImGuiTreeNodeFlags nodeFlags =
-                    ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_OpenOnArrow |
+            ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (!hasChildren)
+            nodeFlags |= ImGuiTreeNodeFlags_Leaf;
+        if (static_cast<int>(index) == scene.GetSelectedIndex())
+            nodeFlags |= ImGuiTreeNodeFlags_Selected;
 
-                if (static_cast<int>(i) == selectedIndex)
-                    nodeFlags |= ImGuiTreeNodeFlags_Selected;
+        const bool dimmed = !obj.IsVisible();
+        if (dimmed)
+            ImGui::PushStyleColor(ImGuiCol_Text, kDimmed);
 
-                if (!obj.visible)
-                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+        // Rows are drawn without tree pushes, so the depth is indented by hand
+        const float indent = static_cast<float>(depth) * ImGui::GetStyle().IndentSpacing;
+        if (indent > 0.0f)
+            ImGui::Indent(indent);
 
-                const char* icon = obj.model ? "[M]" : "[P]";
-                ImGui::TreeNodeEx((void*)(intptr_t)i, nodeFlags,
-                    "%s %s", icon, obj.name.c_str());
+        if (hasChildren)
+            ImGui::SetNextItemOpen(m_Outline.IsExpanded(index));
+        const char* icon = obj.model ? "[M]" : "[P]";
+        ImGui::TreeNodeEx((void*)(intptr_t)index, nodeFlags, "%s %s", icon, obj.name.c_str());
 
-                if (ImGui::IsItemClicked())
-                    ctx.scene->Select(static_cast<int>(i));
+        if (hasChildren && ImGui::IsItemToggledOpen())
+            m_Pending = { PendingAction::ToggleExpanded, index };
+        else if (ImGui::IsItemClicked())
+            scene.Select(static_cast<int>(index));
 
-                if (ImGui::BeginPopupContextItem())
-                {
-                    if (ImGui::MenuItem("Toggle Visibility"))
-                        obj.visible = !obj.visible;
-                    if (ImGui::MenuItem("Rename..."))
-                    { /* TODO */
-                    }
-                    ImGui::Separator();
-                    if (ImGui::MenuItem("Delete"))
-                    {
-                        ctx.scene->RemoveObject(i);
-                        ImGui::EndPopup();
-                        if (!obj.visible) ImGui::PopStyleColor();
-                        break;
-                    }
-                    ImGui::EndPopup();
-                }
-
-                if (!obj.visible)
-                    ImGui::PopStyleColor();
+        if (ImGui::BeginPopupContextItem())
+        {
+            if (ImGui::MenuItem("Toggle Visibility"))
+                obj.SetVisible(!obj.IsVisible());
+            if (ImGui::MenuItem("Rename..."))
+            { /* TODO */
             }
-
             ImGui::Separator();
+            if (ImGui::MenuItem("Delete"))
+                m_Pending = { PendingAction::RemoveObject, index };
+            ImGui::EndPopup();
+        }
 
-            // Lights
-            if (ImGui::TreeNodeEx("Lights", ImGuiTreeNodeFlags_DefaultOpen))
-            {
-                auto& lights = ctx.scene->GetLights();
-                int selectedLightIndex = ctx.scene->GetSelectedLightIndex();
+        if (indent > 0.0f)
+            ImGui::Unindent(indent);
+        if (dimmed)
+            ImGui::PopStyleColor();
+    }
 
-                for (size_t i = 0; i < lights.size(); ++i)
-                {
-                    auto& light = lights[i];
+    void SceneHierarchyPanel::DrawLightRow(Scene& scene, uint32_t index)
+    {
+        Light& light = scene.GetLights()[index];
 
-                    ImGuiTreeNodeFlags nodeFlags =
-                        ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_Leaf |
+            ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (static_cast<int>(index) == scene.GetSelectedLightIndex())
+            nodeFlags |= ImGuiTreeNodeFlags_Selected;
 
-                    if (static_cast<int>(i) == selectedLightIndex)
-                        nodeFlags |= ImGuiTreeNodeFlags_Selected;
+        const bool dimmed = !light.enabled;
+        if (dimmed)
+            ImGui::PushStyleColor(ImGuiCol_Text, kDimmed);
 
-                    if (!light.enabled)
-                        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+        // Own ID space: object rows use their index
+        ImGui::PushID("Lights");
+        ImGui::Indent();
+        const char* icon = (light.type == LightType::Directional) ? "[D]" : "[P]";
+        ImGui::TreeNodeEx((void*)(intptr_t)index, nodeFlags, "%s %s", icon, light.name.c_str());
 
-                    const char* icon = (light.type == LightType::Directional) ? "[D]" : "[P]";
-                    ImGui::TreeNodeEx((void*)(intptr_t)(1000 + i), nodeFlags,
-                        "%s %s", icon, light.name.c_str());
+        if (ImGui::IsItemClicked())
+            scene.SelectLight(static_cast<int>(index));
 
-                    if (ImGui::IsItemClicked())
-                        ctx.scene->SelectLight(static_cast<int>(i));
+        if (ImGui::BeginPopupContextItem())
+        {
+            if (ImGui::MenuItem("Toggle Enabled"))
+                light.enabled = !light.enabled;
+            if (ImGui::MenuItem("Delete"))
+                m_Pending = { PendingAction::RemoveLight, index };
+            ImGui::EndPopup();
+        }
+        ImGui::Unindent();
+        ImGui::PopID();
 
-                    if (ImGui::BeginPopupContextItem())
-                    {
-                        if (ImGui::MenuItem("Toggle Enabled"))
-                            light.enabled = !light.enabled;
-                        if (ImGui::MenuItem("Delete"))
-                        {
-                            ctx.scene->RemoveLight(i);
-                            ImGui::EndPopup();
-                            if (!light.enabled) ImGui::PopStyleColor();
-                            break;
-                        }
-                        ImGui::EndPopup();
-                    }
+        if (dimmed)
+            ImGui::PopStyleColor();
+    }
 
-                    if (!light.enabled)
-                        ImGui::PopStyleColor();
-                }
+    void SceneHierarchyPanel::DrawRows(Scene& scene, bool searching)
+    {
+        const std::vector<SceneOutline::Row>& rows = m_Outline.GetRows();
+        const std::vector<uint32_t>& matches = m_Outline.GetMatches();
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+
+        // Follow a selection made elsewhere (viewport picking) into view
+        const int selected = scene.GetSelectedIndex();
+        if (selected != m_LastSelected && selected >= 0 && !searching)
+        {
+            m_Outline.Reveal(static_cast<uint32_t>(selected));
+            const uint32_t row = m_Outline.FindRow(static_cast<uint32_t>(selected));
+            const float y = static_cast<float>(row) * rowHeight;
+            if (row != SceneOutline::NONE &&
+                (y < ImGui::GetScrollY() || y + rowHeight > ImGui::GetScrollY() + ImGui::GetWindowHeight()))
+            {
+                ImGui::SetScrollY(y - ImGui::GetWindowHeight() * 0.5f);
+            }
+        }
+        m_LastSelected = selected;
+
+        // Objects, then a "Lights" header, then the lights; a search shows
+        // the matches as a flat list
+        const size_t objectRows = searching ? matches.size() : rows.size();
+        const size_t lightRows = searching ? m_LightMatches.size() :
+            (m_LightsOpen ? scene.GetLightCount() : 0);
 
-                ImGui::TreePop();
+        m_Pending = {};
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(objectRows + 1 + lightRows), rowHeight);
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                const size_t row = static_cast<size_t>(i);
+                if (row < objectRows)
+                {
+                    if (searching)
+                        DrawObjectRow(scene, matches[row], 0, false);
+                    else
+                        DrawObjectRow(scene, rows[row].item, rows[row].depth, rows[row].hasChildren);
+                }
+                else if (row == objectRows)
+                {
+                    ImGui::SetNextItemOpen(m_LightsOpen || searching);
+                    ImGui::TreeNodeEx("Lights", ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanAvailWidth);
+                    if (ImGui::IsItemToggledOpen() && !searching)
+                        m_LightsOpen = !m_LightsOpen;
+                }
+                else
+                {
+                    const size_t light = row - objectRows - 1;
+                    DrawLightRow(scene, searching ? m_LightMatches[light] : static_cast<uint32_t>(light));
+                }
             }
+        }
+        clipper.End();
 
-            ImGui::TreePop();
+        // Structural edits wait until no row refers to the old layout
+        switch (m_Pending.kind)
+        {
+        case PendingAction::ToggleExpanded:
+            m_Outline.SetExpanded(m_Pending.index, !m_Outline.IsExpanded(m_Pending.index));
+            break;
+        case PendingAction::RemoveObject:
+            scene.RemoveObject(m_Pending.index);
+            break;
+        case PendingAction::RemoveLight:
+            scene.RemoveLight(m_Pending.index);
+            break;
+        default:
+            break;
         }
+    }
+
+    void SceneHierarchyPanel::Draw(EditorContext& ctx)
+    {
+        ImGui::Begin("Scene Hierarchy", &isOpen);
+
+        if (!ctx.scene)
+        {
+            ImGui::Text("No scene loaded");
+            ImGui::End();
+            return;
+        }
+
+        Scene& scene = *ctx.scene;
+        SyncOutline(scene);
+
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        if (ImGui::InputTextWithHint("##Search", "Search", m_Search, sizeof(m_Search)))
+            m_Outline.SetSearch(m_Search);
+
+        const bool searching = m_Outline.IsSearching();
+        if (searching)
+        {
+            m_Outline.StepSearch(SEARCH_BUDGET);
+            if (m_Outline.GetSearchProgress() < 1.0f)
+                ImGui::TextDisabled("%zu matches (searching %.0f%%)", m_Outline.GetMatches().size(),
+                    m_Outline.GetSearchProgress() * 100.0f);
+            else
+                ImGui::TextDisabled("%zu matches", m_Outline.GetMatches().size());
+            UpdateLightMatches(scene);
+        }
+
+        // Leave room for the add button below
+        const float footer = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
+        ImGui::BeginChild("Rows", ImVec2(0, -footer), false);
+        DrawRows(scene, searching);
+        ImGui::EndChild();
 
         ImGui::Separator();
 
@@ -142,12 +269,19 @@ namespace Nightbloom
                 if (!path.empty())
                 {
                     std::string name = std::filesystem::path(path).stem().string();
-                    auto model = std::make_unique<Model>(name);
-                    if (model->LoadFromFile(path, ctx.renderer->GetResourceManager(),
-                        ctx.renderer->GetDescriptorManager()))
+                    ResourceManager* res = ctx.renderer->GetResourceManager();
+                    // A file already in the scene is placed again, not reloaded
+                    std::shared_ptr<Model> model = res->GetModelCache().Acquire(path,
+                        [&]() -> std::shared_ptr<Model>
+                        {
+                            auto loaded = std::make_shared<Model>(name);
+                            if (!loaded->LoadFromFile(path, res, ctx.renderer->GetDescriptorManager()))
+                                return nullptr;
+                            return loaded;
+                        });
+                    if (model)
                     {
-                        ResourceManager* res = ctx.renderer->GetResourceManager();
-                        Texture* def = res ? res->GetTexture("default_white") : nullptr;
+                        Texture* def = res->GetTexture("default_white");
                         ctx.scene->AddObject(name, std::move(model), def);
                         LOG_INFO("Loaded model '{}' from {}", name, path);
                     }
@@ -1,13 +1,45 @@
 // Panels/SceneHierarchyPanel.hpp
 #pragma once
 #include "../EditorContext.hpp"
+#include "Engine/Core/SceneOutline.hpp"
+#include <cstdint>
+#include <vector>
 
 namespace Nightbloom
 {
+    // The hierarchy is drawn through a clipper over a SceneOutline, rebuilt
+    // only when Scene::GetStructureVersion changes, so a frame lays out the
+    // visible rows and nothing else. Search runs SEARCH_BUDGET names a frame.
     class SceneHierarchyPanel
     {
     public:
+        static constexpr uint32_t SEARCH_BUDGET = 16384;
+
         bool isOpen = true;
         void Draw(EditorContext& ctx);
+
+    private:
+        struct PendingAction
+        {
+            enum Kind : uint8_t { None, ToggleExpanded, RemoveObject, RemoveLight };
+            Kind kind = None;
+            uint32_t index = 0;
+        };
+
+        void SyncOutline(const Scene& scene);
+        void UpdateLightMatches(const Scene& scene);
+        void DrawRows(Scene& scene, bool searching);
+        void DrawObjectRow(Scene& scene, uint32_t index, uint32_t depth, bool hasChildren);
+        void DrawLightRow(Scene& scene, uint32_t index);
+
+        SceneOutline m_Outline;
+        const Scene* m_OutlineScene = nullptr;
+        uint64_t m_OutlineVersion = 0;
+
+        char m_Search[128] = "";
+        std::vector<uint32_t> m_LightMatches;
+        bool m_LightsOpen = true;
+        int m_LastSelected = -1;
+        PendingAction m_Pending;
     };
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
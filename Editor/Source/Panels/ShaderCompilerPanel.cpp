@@ -3,11 +3,13 @@
 
 #include "../Tools/ShaderEditor/ShaderNodeEditor.hpp"
 #include "../EditorFileUtils.hpp"
+#include "../ShaderCompileService.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanShader.hpp"
 #include "Engine/Renderer/Vulkan/VulkanPipeline.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Core/Scene.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include <imgui.h>
 
@@ -28,6 +30,52 @@ namespace Nightbloom
         {
             m_NodeEditor->Draw("Shader Node Editor", &isOpen);
             DrawCompilerWindow(ctx);
+            UpdateLiveCompile(ctx);
+            ApplyParameters(ctx);
+        }
+    }
+
+    bool ShaderCompilerPanel::HasPendingCompile() const
+    {
+        // Nothing goes live before the first explicit Compile & Apply
+        return isOpen && m_LiveUpdate && m_AttemptedHash != 0 && m_SeenHash != m_AttemptedHash;
+    }
+
+    void ShaderCompilerPanel::UpdateLiveCompile(EditorContext& ctx)
+    {
+        const uint64_t hash = m_NodeEditor->RefreshCodeHash();
+        const double now = ImGui::GetTime();
+        if (hash != m_SeenHash)
+        {
+            m_SeenHash = hash;
+            m_LastEditTime = now;
+        }
+
+        if (!HasPendingCompile())
+            return;
+
+        // Still dragging a node, a wire or a value: wait for it to settle
+        if (ImGui::IsAnyItemActive() || ImGui::IsMouseDown(ImGuiMouseButton_Left))
+            return;
+        if (now - m_LastEditTime < LIVE_COMPILE_DELAY)
+            return;
+
+        CompileAndApply(ctx);
+    }
+
+    void ShaderCompilerPanel::ApplyParameters(EditorContext& ctx)
+    {
+        if (!ctx.scene || m_ParameterNodes.empty())
+            return;
+
+        // Slot 0 is push.customData (ShaderGraph::GetParameterExpression)
+        const std::array<float, 4> value = m_NodeEditor->GetParameterValue(m_ParameterNodes[0]);
+        const glm::vec4 customData(value[0], value[1], value[2], value[3]);
+
+        for (SceneObject& obj : ctx.scene->GetObjects())
+        {
+            if (obj.meshDrawable && obj.pipeline == PipelineType::NodeGenerated)
+                obj.meshDrawable->SetCustomData(customData);
         }
     }
 
@@ -45,7 +93,19 @@ namespace Nightbloom
 
         ImGui::SameLine();
         if (ImGui::Button("Reload Shaders", ImVec2(150, 30)))
-            if (ctx.renderer) ctx.renderer->ReloadShaders();
+            Editor::ShaderCompileService::Get().RebuildChangedAsync();
+
+        ImGui::Checkbox("Live Update", &m_LiveUpdate);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip(
+                "Recompile shortly after the graph changes (after the first\n"
+                "Compile & Apply). Color values are pushed per frame and\n"
+                "never recompile.");
+        ImGui::SameLine();
+        if (HasPendingCompile())
+            ImGui::TextDisabled("(pending)");
+        else
+            ImGui::TextDisabled("%u compiled, %u unchanged", m_CompileCount, m_SkippedCount);
 
         // Status
         if (m_CompileSuccess)
@@ -80,6 +140,17 @@ namespace Nightbloom
             return false;
         }
 
+        // Same code as the pipeline already running: nothing to regenerate
+        // or rebuild (e.g. only promoted values or node positions changed)
+        m_AttemptedHash = m_NodeEditor->RefreshCodeHash();
+        IPipelineManager* pipelines = ctx.renderer ? ctx.renderer->GetPipelineManager() : nullptr;
+        if (m_AttemptedHash == m_AppliedHash && pipelines &&
+            pipelines->GetPipeline(PipelineType::NodeGenerated) != nullptr)
+        {
+            m_SkippedCount++;
+            return true;
+        }
+
         if (!m_NodeEditor->CompileShaders())
         {
             m_CompileSuccess = false;
@@ -151,6 +222,9 @@ namespace Nightbloom
             PipelineType::NodeGenerated, config))
         {
             LOG_INFO("NodeGenerated pipeline created and applied");
+            m_ParameterNodes = m_NodeEditor->GetParameterNodes();
+            m_AppliedHash = m_AttemptedHash;
+            m_CompileCount++;
             m_CompileSuccess = true;
             m_CompileError = false;
             m_LastError.clear();
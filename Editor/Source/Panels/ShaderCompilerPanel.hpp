@@ -2,8 +2,10 @@
 #pragma once
 #include "../EditorContext.hpp"
 #include "Engine/Renderer/PipelineInterface.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Nightbloom
 {
@@ -23,6 +25,9 @@ namespace Nightbloom
         // Called from EditorApp::OnStartup()
         void Initialize();
 
+        // A live edit is waiting out the debounce (keeps the editor awake)
+        bool HasPendingCompile() const;
+
     private:
         std::unique_ptr<ShaderNodeEditor> m_NodeEditor;
 
@@ -30,10 +35,26 @@ namespace Nightbloom
         bool        m_CompileError = false;
         std::string m_LastError;
 
+        // Live update: graph edits recompile once the graph has been quiet
+        // for LIVE_COMPILE_DELAY and no drag is in progress. Only code changes
+        // count; promoted parameters are pushed every frame instead.
+        static constexpr double LIVE_COMPILE_DELAY = 0.35;
+        bool        m_LiveUpdate = true;
+        uint64_t    m_SeenHash = 0;        // Code hash as of the last frame
+        uint64_t    m_AttemptedHash = 0;   // Last hash compiled (or failed)
+        uint64_t    m_AppliedHash = 0;     // Hash of the running pipeline
+        double      m_LastEditTime = 0.0;
+        uint32_t    m_CompileCount = 0;
+        uint32_t    m_SkippedCount = 0;
+        std::vector<int> m_ParameterNodes; // Slot -> node, of the applied pipeline
+
         // Builds and hot-loads the NodeGenerated pipeline.
         // Returns true on success.
         bool CompileAndApply(EditorContext& ctx);
 
+        void UpdateLiveCompile(EditorContext& ctx);
+        void ApplyParameters(EditorContext& ctx);
+
         void DrawNodeEditorWindow();
         void DrawCompilerWindow(EditorContext& ctx);
     };
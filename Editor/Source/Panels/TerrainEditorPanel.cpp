@@ -33,10 +33,10 @@ namespace Nightbloom
             return;
         }
 
-        // Lazy init on first draw
-        if (!EnsureInitialized(ctx.renderer))
+        ImGui::Checkbox("Enabled", &enabled);
+        if (!enabled || !m_TerrainInitialized)
         {
-            ImGui::TextDisabled("TerrainSystem failed to initialize.");
+            ImGui::TextDisabled(enabled ? "Starting..." : "Off - created when enabled.");
             ImGui::End();
             return;
         }
@@ -46,12 +46,23 @@ namespace Nightbloom
         // ---- Grid settings --------------------------------------------------
         if (ImGui::CollapsingHeader("Grid", ImGuiTreeNodeFlags_DefaultOpen))
         {
-            const char* resOptions[] = { "32", "64", "128", "256", "512" };
-            if (ImGui::Combo("Resolution", &m_ResolutionIndex, resOptions, 5))
+            const char* resOptions[] = { "32", "64", "128", "256", "512", "1024", "2048", "4096" };
+            if (ImGui::Combo("Resolution", &m_ResolutionIndex, resOptions, 8))
                 changed = true;
 
-            if (ImGui::SliderFloat("World Size", &m_WorldSize, 50.0f, 1000.0f)) changed = true;
+            if (ImGui::SliderFloat("World Size", &m_WorldSize, 50.0f, 16000.0f, "%.0f", ImGuiSliderFlags_Logarithmic)) changed = true;
+            if (ImGui::SliderFloat("LOD Range", &m_LodRangeScale, 2.0f, 8.0f)) changed = true;
             if (ImGui::SliderFloat("Height Scale", &m_HeightScale, 1.0f, 200.0f)) changed = true;
+
+            // Coarse patch grid, split near the camera on the GPU
+            ImGui::BeginDisabled(!ctx.renderer->SupportsTerrainTessellation());
+            if (ImGui::Checkbox("Tessellation", &m_Tessellation)) changed = true;
+            ImGui::BeginDisabled(!m_Tessellation);
+            const char* baseQuadOptions[] = { "4", "8", "16" };
+            if (ImGui::Combo("Base Grid", &m_TessBaseQuadsIndex, baseQuadOptions, 3)) changed = true;
+            if (ImGui::SliderFloat("Edge Pixels", &m_TessEdgePixels, 2.0f, 32.0f, "%.1f")) changed = true;
+            ImGui::EndDisabled();
+            ImGui::EndDisabled();
         }
 
         // ---- Heightmap noise settings ----------------------------------------
@@ -61,8 +72,8 @@ namespace Nightbloom
             if (ImGui::Combo("Noise Type", &m_NoiseType, noiseTypes, 3))
                 changed = true;
 
-            const char* hmapResOptions[] = { "128", "256", "512", "1024" };
-            if (ImGui::Combo("Heightmap Res", &m_HeightmapRes, hmapResOptions, 4))
+            const char* hmapResOptions[] = { "128", "256", "512", "1024", "2048", "4096" };
+            if (ImGui::Combo("Heightmap Res", &m_HeightmapRes, hmapResOptions, 6))
                 changed = true;
 
             if (ImGui::SliderInt("Octaves", &m_Octaves, 1, 8))     changed = true;
@@ -72,6 +83,41 @@ namespace Nightbloom
             if (ImGui::SliderInt("Seed", &m_Seed, 0, 9999))  changed = true;
         }
 
+        // ---- Streaming -------------------------------------------------------
+        if (ImGui::CollapsingHeader("Streaming"))
+        {
+            // World Size above becomes the noise feature scale; the terrain
+            // itself is unbounded
+            if (ImGui::Checkbox("Stream Tiles", &m_Streaming)) changed = true;
+
+            ImGui::BeginDisabled(!m_Streaming);
+            const char* tileResOptions[] = { "64", "128", "256" };
+            if (ImGui::Combo("Tile Res", &m_TileResIndex, tileResOptions, 3)) changed = true;
+            if (ImGui::SliderFloat("Tile Size", &m_TileWorldSize, 32.0f, 2048.0f, "%.0f", ImGuiSliderFlags_Logarithmic)) changed = true;
+            if (ImGui::SliderInt("Radius (tiles)", &m_StreamRadius, 1, 6)) changed = true;
+            if (ImGui::SliderInt("Tiles / Frame", &m_TilesPerFrame, 1, 8)) changed = true;
+            ImGui::EndDisabled();
+        }
+
+        // ---- Sculpt ----------------------------------------------------------
+        if (ImGui::CollapsingHeader("Sculpt"))
+        {
+            // Only strokes' texels are rewritten; regenerating throws them away
+            ImGui::BeginDisabled(!m_Terrain.CanSculpt());
+            ImGui::Checkbox("Sculpt (LMB in viewport)", &m_SculptEnabled);
+            const char* modes[] = { "Raise", "Lower", "Smooth", "Flatten" };
+            ImGui::Combo("Brush", &m_SculptMode, modes, 4);
+            ImGui::SliderFloat("Radius", &m_Brush.radius, 0.5f, 500.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+            ImGui::SliderFloat("Falloff", &m_Brush.falloff, 0.0f, 1.0f);
+            ImGui::SliderFloat("Strength", &m_Brush.strength, 0.01f, 2.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+            ImGui::BeginDisabled(m_SculptMode != static_cast<int>(TerrainBrushMode::Flatten));
+            ImGui::SliderFloat("Target Height", &m_Brush.targetHeight, 0.0f, 1.0f);
+            ImGui::EndDisabled();
+            ImGui::EndDisabled();
+            if (m_Terrain.IsStreaming())
+                ImGui::TextDisabled("Streamed terrain can't be sculpted.");
+        }
+
         // ---- Transform -------------------------------------------------------
         if (ImGui::CollapsingHeader("Transform"))
         {
@@ -84,19 +130,32 @@ namespace Nightbloom
         if (ImGui::Button("Regenerate Now", ImVec2(-1, 0)))
             m_Terrain.Regenerate(BuildDesc());
 
-        if (changed)
-            m_PendingDirty = true;
-
         // ---- Stats -----------------------------------------------------------
         ImGui::Separator();
         if (m_Terrain.IsReady())
         {
             const TerrainDesc& d = m_Terrain.GetDesc();
-            uint32_t verts = d.resolution * d.resolution;
-            uint32_t tris = (d.resolution - 1) * (d.resolution - 1) * 2;
-            ImGui::TextDisabled("Vertices: %u  |  Triangles: %u", verts, tris);
-            ImGui::TextDisabled("Heightmap: %ux%u  |  Height scale: %.1f",
-                d.noise.width, d.noise.height, d.heightScale);
+            const uint32_t patches = m_Terrain.GetPatchCount();
+            const uint32_t quads = m_Terrain.GetPatchQuads();
+            ImGui::TextDisabled("Patches: %u  |  LOD levels: %u  |  %s: %u",
+                patches, m_Terrain.GetLODLevels(), m_Terrain.IsTessellated() ? "Base triangles" : "Triangles",
+                patches * quads * quads * 2);
+            if (m_Terrain.IsStreaming())
+            {
+                const uint32_t side = 2 * d.streamRadius + 1;
+                ImGui::TextDisabled("Tiles: %u / %u resident  |  Heightmap: %ux%u",
+                    m_Terrain.GetResidentTileCount(), side * side,
+                    m_Terrain.GetHeightmap()->GetWidth(), m_Terrain.GetHeightmap()->GetHeight());
+            }
+            else
+            {
+                ImGui::TextDisabled("Heightmap: %ux%u  |  Height scale: %.1f%s",
+                    d.noise.width, d.noise.height, d.heightScale, m_Terrain.IsSculpted() ? "  |  Sculpted" : "");
+            }
+            ImGui::TextDisabled("Virtual texture: %u / %u levels resident  |  %u pages rendered",
+                m_Terrain.GetVirtualResidentLevels(), TERRAIN_VIRTUAL_LEVELS, m_Terrain.GetVirtualPagesRendered());
+            if (m_Terrain.GetSunShadowMap())
+                ImGui::TextDisabled("Sun shadow: %u bakes", m_Terrain.GetSunShadowBakes());
         }
         else
         {
@@ -105,13 +164,16 @@ namespace Nightbloom
 
         ImGui::End();
 
-        // ---- Regen (outside Begin/End — may call WaitForIdle) ----------------
+        // ---- Regen (outside Begin/End — may block on noise generation) -------
         if (changed)
         {
-            // If slider was just released (not currently being dragged), regen now
-            if (!ImGui::IsAnyItemActive())
+            // Noise edits build in the background, so they can follow the
+            // slider; anything that would stall waits for the release
+            const TerrainDesc desc = BuildDesc();
+            if (!ImGui::IsAnyItemActive() || m_Terrain.CanRegenerateInBackground(desc))
             {
-                m_Terrain.Regenerate(BuildDesc());
+                m_Terrain.RequestRegenerate(desc);
+                m_PendingDirty = false;
             }
             else
             {
@@ -123,15 +185,40 @@ namespace Nightbloom
         // Fire regen the frame after the slider is released
         if (m_PendingDirty && !ImGui::IsAnyItemActive())
         {
-            m_Terrain.Regenerate(BuildDesc());
+            m_Terrain.RequestRegenerate(BuildDesc());
             m_PendingDirty = false;
         }
     }
 
+    bool TerrainPanel::SculptAlongRay(const glm::vec3& origin, const glm::vec3& direction, float deltaTime)
+    {
+        if (!IsSculpting())
+            return false;
+
+        glm::vec3 hit;
+        if (!m_Terrain.Raycast(origin, direction, 100000.0f, hit))
+            return false;
+
+        m_Brush.mode = static_cast<TerrainBrushMode>(m_SculptMode);
+        m_Brush.center = glm::vec2(hit.x, hit.z);
+        return m_Terrain.Sculpt(m_Brush, deltaTime);
+    }
+
     // =========================================================================
     // Private helpers
     // =========================================================================
 
+    void TerrainPanel::ApplyEnabled(Renderer* renderer)
+    {
+        if (!enabled)
+            Cleanup();
+        else if (renderer && !EnsureInitialized(renderer))
+        {
+            Cleanup();
+            enabled = false;
+        }
+    }
+
     bool TerrainPanel::EnsureInitialized(Renderer* renderer)
     {
         if (m_TerrainInitialized) return true;
@@ -143,6 +230,7 @@ namespace Nightbloom
         }
 
         m_TerrainInitialized = true;
+        renderer->SetTerrainSystem(&m_Terrain);  // streamed tiles generate in its compute pass
         m_Terrain.Regenerate(BuildDesc());
         //m_TerrainDirty = false;
         m_PendingDirty = false;
@@ -152,14 +240,27 @@ namespace Nightbloom
 
     TerrainDesc TerrainPanel::BuildDesc() const
     {
-        const uint32_t hmapResValues[] = { 128, 256, 512, 1024 };
+        const uint32_t hmapResValues[] = { 128, 256, 512, 1024, 2048, 4096 };
+        const uint32_t tileResValues[] = { 64, 128, 256 };
 
         TerrainDesc desc;
         desc.resolution = ResolutionValues[m_ResolutionIndex];
         desc.worldSize = m_WorldSize;
+        desc.lodRangeScale = m_LodRangeScale;
         desc.heightScale = m_HeightScale;
         desc.position = glm::vec3(m_Position[0], m_Position[1], m_Position[2]);
 
+        const uint32_t tessBaseQuadValues[] = { 4, 8, 16 };
+        desc.tessellation = m_Tessellation;
+        desc.tessellationBaseQuads = tessBaseQuadValues[m_TessBaseQuadsIndex];
+        desc.tessellationEdgePixels = m_TessEdgePixels;
+
+        desc.streaming = m_Streaming;
+        desc.tileWorldSize = m_TileWorldSize;
+        desc.tileResolution = tileResValues[m_TileResIndex];
+        desc.streamRadius = static_cast<uint32_t>(m_StreamRadius);
+        desc.tilesPerFrame = static_cast<uint32_t>(m_TilesPerFrame);
+
         desc.noise.width = hmapResValues[m_HeightmapRes];
         desc.noise.height = hmapResValues[m_HeightmapRes];
         desc.noise.depth = 1;
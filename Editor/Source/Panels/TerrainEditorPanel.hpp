@@ -10,9 +10,15 @@ namespace Nightbloom
     {
     public:
         bool isOpen = true;
+        // Part of the scene: the TerrainSystem exists only while enabled
+        bool enabled = false;
 
         void Draw(EditorContext& ctx);
 
+        // Creates or tears down the TerrainSystem to match `enabled` (see
+        // CloudPanel::ApplyEnabled)
+        void ApplyEnabled(Renderer* renderer);
+
         // Call before renderer shuts down (while Vulkan device is still alive)
         void Cleanup();
 
@@ -20,7 +26,7 @@ namespace Nightbloom
         {
             if (m_TerrainInitialized && m_Terrain.IsReady())
             {
-                m_Terrain.UpdateLOD(cameraPosition, ResolutionValues[m_ResolutionIndex]);
+                m_Terrain.UpdateLOD(cameraPosition);
                 m_Terrain.SubmitDraw(drawList);
             }
         }
@@ -29,10 +35,19 @@ namespace Nightbloom
         // world bounds and heightmap descriptor set, see GrassSystem.
         const TerrainSystem& GetTerrainSystem() const { return m_Terrain; }
 
+        // Frames must keep coming for a background heightmap to be swapped in
+        bool IsRegenerating() const { return m_TerrainInitialized && m_Terrain.IsRegenerating(); }
+
+        // The editor routes left-drag in the viewport here instead of picking
+        bool IsSculpting() const { return m_SculptEnabled && m_TerrainInitialized && m_Terrain.CanSculpt(); }
+
+        // Dabs the brush where the ray meets the terrain; false on a miss
+        bool SculptAlongRay(const glm::vec3& origin, const glm::vec3& direction, float deltaTime);
+
     private:
-        // Shared source of truth for the resolution dropdown, used by both
-        // BuildDesc() and SubmitTerrainDraw()'s LOD base-resolution lookup.
-        static constexpr uint32_t ResolutionValues[5] = { 32, 64, 128, 256, 512 };
+        // Finest-LOD vertices per side across the whole terrain; the CDLOD
+        // quadtree only spends that density near the camera.
+        static constexpr uint32_t ResolutionValues[8] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
 
         // TerrainSystem owned by this panel (holds GPU resources)
         TerrainSystem m_Terrain;
@@ -41,10 +56,16 @@ namespace Nightbloom
         bool          m_PendingDirty = false;
 
         // Grid settings
-        int   m_ResolutionIndex = 3;   // 0=32 1=64 2=128 3=256 4=512
+        int   m_ResolutionIndex = 3;   // index into ResolutionValues
         float m_WorldSize = 200.0f;
+        float m_LodRangeScale = 4.0f;
         float m_HeightScale = 30.0f;
 
+        // Tessellation (coarse grid split near the camera)
+        bool  m_Tessellation = false;
+        int   m_TessBaseQuadsIndex = 1;   // 0=4 1=8 2=16
+        float m_TessEdgePixels = 8.0f;
+
         // Heightmap noise settings
         int   m_NoiseType = 0;    // 0=Perlin 1=Worley 2=PerlinWorley
         int   m_Octaves = 6;
@@ -52,7 +73,19 @@ namespace Nightbloom
         float m_Persistence = 0.5f;
         float m_Lacunarity = 2.0f;
         int   m_Seed = 42;
-        int   m_HeightmapRes = 1;    // 0=128 1=256 2=512 3=1024
+        int   m_HeightmapRes = 1;    // 0=128 1=256 2=512 3=1024 4=2048 5=4096
+
+        // Streaming (tiles generated around the camera)
+        bool  m_Streaming = false;
+        float m_TileWorldSize = 256.0f;
+        int   m_TileResIndex = 1;    // 0=64 1=128 2=256
+        int   m_StreamRadius = 3;
+        int   m_TilesPerFrame = 2;
+
+        // Sculpting (left-drag in the viewport)
+        bool         m_SculptEnabled = false;
+        int          m_SculptMode = 0;    // TerrainBrushMode
+        TerrainBrush m_Brush;
 
         // Position
         float m_Position[3] = { 0.0f, 0.0f, 0.0f };
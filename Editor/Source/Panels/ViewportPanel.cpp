@@ -1,19 +1,94 @@
 // Panels/ViewportPanel.cpp
 #include "ViewportPanel.hpp"
+#include "../ShaderCompileService.hpp"
 #include "Engine/Renderer/Renderer.hpp"
-#include <imgui.h>
+#include <imgui_impl_vulkan.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 namespace Nightbloom
 {
+    namespace
+    {
+        // Ortho cameras sit this far from the focus and see twice as far
+        constexpr float kOrthoDistance = 500.0f;
+    }
+
+    void ViewportPanel::UnregisterPreview(Preview& preview)
+    {
+        if (preview.id)
+        {
+            ImGui_ImplVulkan_RemoveTexture(
+                reinterpret_cast<VkDescriptorSet>(preview.id));
+        }
+        preview = Preview{};
+    }
+
+    void ViewportPanel::Cleanup()
+    {
+        for (Preview& preview : m_Previews)
+            UnregisterPreview(preview);
+    }
+
+    uint32_t ViewportPanel::GetAxes(Axis* axes) const
+    {
+        switch (m_Layout)
+        {
+        case Layout::Top:   axes[0] = Axis::Top; return 1;
+        case Layout::Side:  axes[0] = Axis::Side; return 1;
+        case Layout::Split: axes[0] = Axis::Top; axes[1] = Axis::Side; return 2;
+        default:            return 0;
+        }
+    }
+
+    uint32_t ViewportPanel::BuildAuxiliaryViews(const glm::vec3& focus, AuxiliaryView* views) const
+    {
+        Axis axes[MAX_AUXILIARY_VIEWS];
+        const uint32_t count = isOpen ? GetAxes(axes) : 0;
+        if (count == 0 || m_ViewSize.x < 1.0f || m_ViewSize.y < 1.0f)
+            return 0;
+
+        const float aspect = m_ViewSize.x / m_ViewSize.y;
+        const glm::mat4 projection = MakeOrthographicReverseZ(m_OrthoHalfHeight * aspect, m_OrthoHalfHeight,
+            1.0f, 2.0f * kOrthoDistance);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            AuxiliaryView& view = views[i];
+            if (axes[i] == Axis::Top)
+            {
+                view.position = focus + glm::vec3(0.0f, kOrthoDistance, 0.0f);
+                view.view = glm::lookAt(view.position, focus, glm::vec3(0.0f, 0.0f, -1.0f));
+            }
+            else
+            {
+                view.position = focus + glm::vec3(kOrthoDistance, 0.0f, 0.0f);
+                view.view = glm::lookAt(view.position, focus, glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+            view.projection = projection;
+            view.width = static_cast<uint32_t>(m_ViewSize.x);
+            view.height = static_cast<uint32_t>(m_ViewSize.y);
+        }
+        return count;
+    }
+
     void ViewportPanel::Draw(EditorContext& ctx)
     {
-        ImGui::Begin("Viewport");
+        // In Perspective the scene is drawn into this panel's content
+        // region, so the window must not paint over it
+        const ImGuiWindowFlags flags = m_Layout == Layout::Perspective ? ImGuiWindowFlags_NoBackground : 0;
+        const bool visible = ImGui::Begin("Viewport", nullptr, flags);
 
-        if (ImGui::Button("Perspective")) {}
-        ImGui::SameLine();
-        if (ImGui::Button("Top")) {}
-        ImGui::SameLine();
-        if (ImGui::Button("Side")) {}
+        const Layout layouts[] = { Layout::Perspective, Layout::Top, Layout::Side, Layout::Split };
+        const char* layoutNames[] = { "Perspective", "Top", "Side", "Top + Side" };
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i > 0) ImGui::SameLine();
+            const bool selected = m_Layout == layouts[i];
+            if (selected) ImGui::PushStyleColor(ImGuiCol_Button, ImGui::GetStyleColorVec4(ImGuiCol_ButtonActive));
+            if (ImGui::Button(layoutNames[i])) m_Layout = layouts[i];
+            if (selected) ImGui::PopStyleColor();
+        }
 
         ImGui::Separator();
 
@@ -23,13 +98,23 @@ namespace Nightbloom
                 ctx.renderer->TogglePipeline();
             ImGui::SameLine();
             if (ImGui::Button("Reload Shaders (R)"))
-                ctx.renderer->ReloadShaders();
+                Editor::ShaderCompileService::Get().RebuildChangedAsync();
+
+            SceneViewportSettings sceneSettings = ctx.renderer->GetSceneViewportSettings();
+            ImGui::SetNextItemWidth(160.0f);
+            if (ImGui::SliderFloat("Resolution Scale", &sceneSettings.resolutionScale,
+                SceneViewport::MIN_SCALE, SceneViewport::MAX_SCALE, "%.2fx"))
+                ctx.renderer->SetSceneViewportSettings(sceneSettings);
         }
 
         ImGui::Separator();
 
-        ImVec2 viewportSize = ImGui::GetContentRegionAvail();
-        ImGui::Text("3D Viewport (%dx%d)", (int)viewportSize.x, (int)viewportSize.y);
+        Axis axes[MAX_AUXILIARY_VIEWS];
+        const uint32_t viewCount = GetAxes(axes);
+        if (viewCount > 0)
+        {
+            ImGui::SliderFloat("Zoom", &m_OrthoHalfHeight, 2.0f, 500.0f, "%.0f m", ImGuiSliderFlags_Logarithmic);
+        }
 
         if (ctx.projectName)
             ImGui::Text("Current Project: %s", ctx.projectName->c_str());
@@ -37,6 +122,74 @@ namespace Nightbloom
         if (isPlayMode)
             ImGui::TextColored(ImVec4(0, 1, 0, 1), "PLAYING");
 
+        ImVec2 viewportSize = ImGui::GetContentRegionAvail();
+        m_SceneRegion = SceneViewportRect{};
+        if (viewCount == 0)
+        {
+            m_ViewSize = ImVec2(0.0f, 0.0f);
+
+            // Framebuffer pixels of the main window; a panel undocked onto
+            // another platform window leaves the scene on the whole surface
+            const ImGuiViewport* mainViewport = ImGui::GetMainViewport();
+            if (visible && ImGui::GetWindowViewport() == mainViewport && viewportSize.x >= 1.0f && viewportSize.y >= 1.0f)
+            {
+                const ImVec2 scale = ImGui::GetIO().DisplayFramebufferScale;
+                const ImVec2 origin = ImGui::GetCursorScreenPos();
+                m_SceneRegion.x = static_cast<int32_t>((origin.x - mainViewport->Pos.x) * scale.x);
+                m_SceneRegion.y = static_cast<int32_t>((origin.y - mainViewport->Pos.y) * scale.y);
+                m_SceneRegion.width = static_cast<uint32_t>(viewportSize.x * scale.x);
+                m_SceneRegion.height = static_cast<uint32_t>(viewportSize.y * scale.y);
+            }
+            ImGui::Dummy(viewportSize);
+        }
+        else if (!ctx.renderer || !ctx.renderer->SupportsAuxiliaryViews())
+        {
+            m_ViewSize = ImVec2(0.0f, 0.0f);
+            ImGui::TextDisabled("Orthographic views need a single-sample reflection pass.");
+        }
+        else
+        {
+            // Side by side; the renderer culls and draws them from the main
+            // view's draw list
+            const float spacing = ImGui::GetStyle().ItemSpacing.x;
+            m_ViewSize = ImVec2(
+                std::max(1.0f, (viewportSize.x - spacing * (viewCount - 1)) / viewCount),
+                std::max(1.0f, viewportSize.y));
+
+            const char* axisNames[] = { "Top", "Side" };
+            for (uint32_t i = 0; i < viewCount; ++i)
+            {
+                if (i > 0) ImGui::SameLine();
+
+                Preview& preview = m_Previews[i];
+                VkImageView imageView = i < ctx.renderer->GetAuxiliaryViewCount()
+                    ? ctx.renderer->GetAuxiliaryViewImageView(i)
+                    : VK_NULL_HANDLE;
+                if (imageView != preview.imageView)
+                {
+                    UnregisterPreview(preview);
+                    if (imageView != VK_NULL_HANDLE)
+                    {
+                        preview.id = reinterpret_cast<ImTextureID>(
+                            ImGui_ImplVulkan_AddTexture(
+                                ctx.renderer->GetAuxiliaryViewSampler(),
+                                imageView,
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+                        preview.imageView = imageView;
+                    }
+                }
+
+                ImGui::BeginGroup();
+                if (preview.id)
+                    ImGui::Image(preview.id, m_ViewSize);
+                else
+                    ImGui::Dummy(m_ViewSize);
+                ImGui::GetWindowDrawList()->AddText(ImGui::GetItemRectMin(), IM_COL32(255, 255, 255, 200),
+                    axisNames[static_cast<int>(axes[i])]);
+                ImGui::EndGroup();
+            }
+        }
+
         ImGui::End();
     }
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
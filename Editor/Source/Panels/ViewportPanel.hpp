@@ -1,6 +1,12 @@
 // Panels/ViewportPanel.hpp
 #pragma once
 #include "../EditorContext.hpp"
+#include "Engine/Renderer/AuxiliaryView.hpp"
+#include "Engine/Renderer/SceneViewport.hpp"
+#include <imgui.h>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
 
 namespace Nightbloom
 {
@@ -10,5 +16,40 @@ namespace Nightbloom
         bool isOpen = true;
         bool isPlayMode = false;  // Owned here, menu bar/EditorApp can read it
         void Draw(EditorContext& ctx);
+
+        // Call this before the renderer shuts down, while the Vulkan device is still alive.
+        void Cleanup();
+
+        // The orthographic views the current layout shows (none in
+        // Perspective), centred on focus and sized from the last Draw. Fill
+        // them in before BuildDrawList so the scene culls for them too.
+        uint32_t BuildAuxiliaryViews(const glm::vec3& focus, AuxiliaryView* views) const;
+
+        // The content region the perspective scene is shown in, in surface
+        // pixels as of the last Draw; empty when the scene should cover the
+        // whole window (orthographic layouts, panel closed or undocked).
+        SceneViewportRect GetSceneRegion() const { return isOpen ? m_SceneRegion : SceneViewportRect{}; }
+
+    private:
+        enum class Layout { Perspective, Top, Side, Split };
+        enum class Axis { Top, Side };
+
+        Layout m_Layout = Layout::Perspective;
+        float  m_OrthoHalfHeight = 40.0f;   // world units from the centre to the top edge
+        ImVec2 m_ViewSize = ImVec2(0.0f, 0.0f);
+        SceneViewportRect m_SceneRegion;
+
+        uint32_t GetAxes(Axis* axes) const;
+
+        // ImGui texture per auxiliary view, re-registered when the renderer
+        // recreates the target
+        struct Preview
+        {
+            VkImageView imageView = VK_NULL_HANDLE;
+            ImTextureID id = 0;
+        };
+        std::array<Preview, MAX_AUXILIARY_VIEWS> m_Previews{};
+
+        void UnregisterPreview(Preview& preview);
     };
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
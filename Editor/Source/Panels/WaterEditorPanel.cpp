@@ -28,9 +28,10 @@ namespace Nightbloom
             return;
         }
 
-        if (!EnsureInitialized(ctx.renderer))
+        ImGui::Checkbox("Enabled", &enabled);
+        if (!enabled || !m_Initialized)
         {
-            ImGui::TextDisabled("WaterSystem failed to initialize.");
+            ImGui::TextDisabled(enabled ? "Starting..." : "Off - created when enabled.");
             ImGui::End();
             return;
         }
@@ -44,9 +45,10 @@ namespace Nightbloom
             ImGui::DragFloat("Water Y", &desc.waterY, 0.1f);
             ImGui::DragFloat2("Center XZ", &desc.position.x, 0.5f);
 
-            // worldSize changes the plane mesh — needs a rebuild (Regenerate).
+            // worldSize moves the finest grid spacing the wave maps are
+            // laid out for — needs a rebuild (Regenerate).
             float worldSize = desc.worldSize;
-            if (ImGui::DragFloat("World Size", &worldSize, 1.0f, 1.0f, 2000.0f))
+            if (ImGui::DragFloat("World Size", &worldSize, 1.0f, 1.0f, 8000.0f))
             {
                 WaterDesc next = desc;
                 next.worldSize = worldSize;
@@ -54,22 +56,177 @@ namespace Nightbloom
             }
         }
 
+        // LOD grid — patch size and cell size rebuild (Regenerate); the
+        // range is read each frame by UpdateLOD.
+        if (ImGui::CollapsingHeader("Grid"))
+        {
+            WaterDesc next = desc;
+            bool rebuild = false;
+
+            int patchQuads = static_cast<int>(desc.patchQuads);
+            if (ImGui::SliderInt("Patch Cells", &patchQuads, 8, 64))
+            {
+                next.patchQuads = static_cast<uint32_t>(patchQuads);
+                rebuild = true;
+            }
+            if (ImGui::DragFloat("Cell Size", &next.cellSize, 0.01f, 0.05f, 8.0f, "%.2f m"))
+                rebuild = true;
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Widest the cells nearest the camera may be; each coarser\n"
+                                  "level doubles them. FFT waves need it below the smallest\n"
+                                  "cascade's wavelengths to show.");
+            ImGui::SliderFloat("LOD Range", &desc.lodRangeScale, 2.0f, 16.0f);
+
+            ImGui::Text("%u patches", m_Water.GetPatchCount());
+
+            if (rebuild)
+                m_Water.Regenerate(next);
+        }
+
+        // Waves — the mode and FFT layout rebuild (Regenerate); the
+        // rest is live (draw push constant / OceanWaves' push constants).
+        if (ImGui::CollapsingHeader("Waves", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            if (m_Water.SupportsFFTWaves())
+            {
+                int mode = desc.waveMode == WaterWaveMode::FFT ? 1 : 0;
+                if (ImGui::Combo("Wave Mode", &mode, "Normals\0FFT Ocean\0"))
+                {
+                    WaterDesc next = desc;
+                    next.waveMode = mode == 1 ? WaterWaveMode::FFT : WaterWaveMode::Normals;
+                    m_Water.Regenerate(next);
+                }
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Normals tilts the shading of a flat plane with scrolling sines.\n"
+                                      "FFT Ocean simulates the waves on the GPU (async compute when\n"
+                                      "available) and displaces the grid. Compare the Ocean Waves timing.");
+            }
+            else
+            {
+                ImGui::TextDisabled("Normals (FFT ocean unavailable)");
+            }
+
+            if (desc.waveMode == WaterWaveMode::FFT && m_Water.SupportsFFTWaves())
+            {
+                OceanWaveDesc& ocean = desc.ocean;
+                WaterDesc next = desc;
+                bool rebuild = false;
+
+                static const uint32_t kFFTSizes[] = { 64, 128, 256, 512 };
+                int sizeIndex = 0;
+                for (int i = 0; i < 4; ++i)
+                    if (kFFTSizes[i] == ocean.resolution) sizeIndex = i;
+                if (ImGui::Combo("FFT Size", &sizeIndex, "64\0" "128\0" "256\0" "512\0"))
+                {
+                    next.ocean.resolution = kFFTSizes[sizeIndex];
+                    rebuild = true;
+                }
+
+                int cascades = static_cast<int>(ocean.cascadeCount);
+                if (ImGui::SliderInt("Cascades", &cascades, 1, static_cast<int>(OCEAN_MAX_CASCADES)))
+                {
+                    next.ocean.cascadeCount = static_cast<uint32_t>(cascades);
+                    rebuild = true;
+                }
+
+                glm::vec3 lengths = ocean.cascadeLengths;
+                if (ImGui::DragFloat3("Cascade Sizes", &lengths.x, 0.5f, 1.0f, 2000.0f))
+                {
+                    next.ocean.cascadeLengths = lengths;
+                    rebuild = true;
+                }
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("World size of each tiling patch, far to near. Each cascade\n"
+                                      "keeps a separate band of wavelengths, so keep them decreasing.");
+
+                ImGui::SliderFloat("Wind Speed", &ocean.windSpeed, 0.5f, 30.0f, "%.1f m/s");
+                ImGui::SliderFloat("Wind Angle", &ocean.windAngle, 0.0f, 360.0f, "%.0f deg");
+                ImGui::SliderFloat("Amplitude", &ocean.amplitude, 0.0f, 3.0f);
+                ImGui::SliderFloat("Choppiness", &ocean.choppiness, 0.0f, 2.5f);
+                ImGui::SliderFloat("Foam", &ocean.foam, 0.0f, 3.0f);
+
+                if (rebuild)
+                    m_Water.Regenerate(next);
+            }
+            else
+            {
+                ImGui::SliderFloat("Wave Amplitude", &desc.waveAmplitude, 0.0f, 0.25f);
+                ImGui::SliderFloat("Wave Speed", &desc.waveSpeed, 0.0f, 3.0f);
+            }
+        }
+
         // Surface look — all live (ride in the draw push constant).
         if (ImGui::CollapsingHeader("Surface", ImGuiTreeNodeFlags_DefaultOpen))
         {
-            ImGui::SliderFloat("Wave Amplitude", &desc.waveAmplitude, 0.0f, 0.25f);
-            ImGui::SliderFloat("Wave Speed", &desc.waveSpeed, 0.0f, 3.0f);
             ImGui::SliderFloat("Fresnel Power", &desc.fresnelPower, 0.5f, 8.0f);
             ImGui::SliderFloat("Opacity", &desc.alpha, 0.0f, 1.0f);
         }
 
+        // Reflection technique — switched per frame, no rebuild.
+        if (ImGui::CollapsingHeader("Reflection", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            if (ctx.renderer->SupportsScreenSpaceReflections())
+            {
+                int mode = desc.reflectionMode == WaterReflectionMode::ScreenSpace ? 1 : 0;
+                if (ImGui::Combo("Mode", &mode, "Planar\0Screen-space\0"))
+                    desc.reflectionMode = mode == 1 ? WaterReflectionMode::ScreenSpace : WaterReflectionMode::Planar;
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Planar re-renders the scene from the mirrored camera.\n"
+                                      "Screen-space traces last frame's image and depth instead:\n"
+                                      "much cheaper, but only reflects what is on screen.\n"
+                                      "Compare the Reflection / SSR timings either way.");
+
+                if (desc.reflectionMode == WaterReflectionMode::ScreenSpace)
+                {
+                    ImGui::SliderFloat("Max Distance", &desc.ssrMaxDistance, 10.0f, 500.0f);
+                    ImGui::SliderFloat("Thickness", &desc.ssrThickness, 0.1f, 10.0f);
+                }
+            }
+            else
+            {
+                ImGui::TextDisabled("Planar (screen-space unavailable)");
+            }
+
+            if (desc.reflectionMode == WaterReflectionMode::Planar || !ctx.renderer->SupportsScreenSpaceReflections())
+            {
+                ImGui::SliderFloat("Resolution", &desc.planarScale, 0.25f, 1.0f, "%.2f");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Planar pass resolution as a fraction of the scene's.\n"
+                                      "The ripples hide most of the softness.");
+                int interval = static_cast<int>(desc.reflectionInterval);
+                if (ImGui::SliderInt("Update Every", &interval, 1, static_cast<int>(ReflectionSchedule::MAX_INTERVAL),
+                    interval == 1 ? "frame" : "%d frames"))
+                    desc.reflectionInterval = static_cast<uint32_t>(interval);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Re-render the reflection every Nth frame and reproject\n"
+                                      "it onto the moving camera in between. Above 1 the\n"
+                                      "target keeps its own memory instead of bloom's.");
+                ImGui::SliderFloat("Min Prop Size", &desc.planarMinSize, 0.0f, 0.1f, "%.3f");
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Props covering less of the screen height than this\n"
+                                      "(seen from the mirrored camera) are left out.");
+                ImGui::Checkbox("Reflect Grass", &desc.planarFoliage);
+            }
+        }
+
         ImGui::Separator();
-        ImGui::TextDisabled("Reflects terrain/meshes/grass. Refraction +");
+        ImGui::TextDisabled("Reflects terrain/meshes (grass optional). Refraction +");
         ImGui::TextDisabled("tunable colors are deferred (Phase B/C).");
 
         ImGui::End();
     }
 
+    void WaterEditorPanel::ApplyEnabled(Renderer* renderer)
+    {
+        if (!enabled)
+            Cleanup();
+        else if (renderer && !EnsureInitialized(renderer))
+        {
+            Cleanup();
+            enabled = false;
+        }
+    }
+
     bool WaterEditorPanel::EnsureInitialized(Renderer* renderer)
     {
         if (m_Initialized) return true;
@@ -83,6 +240,7 @@ namespace Nightbloom
         if (!m_Water.Regenerate(m_Water.GetDesc()))
         {
             LOG_ERROR("WaterEditorPanel: WaterSystem::Regenerate failed");
+            m_Water.Shutdown();
             return false;
         }
 
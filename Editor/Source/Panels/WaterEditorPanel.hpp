@@ -1,12 +1,14 @@
 // Panels/WaterEditorPanel.hpp
 //
 // Owns the WaterSystem (a single reflective water plane) and exposes its
-// tunables. Mirrors CloudPanel/TerrainEditorPanel: lazy-initialises on first
-// Draw, registers with the Renderer (SetWaterSystem) so the reflection pass
-// runs, and Cleanup() must run before the Renderer shuts down.
+// tunables. Mirrors CloudPanel/TerrainEditorPanel: initialises when first
+// enabled (ApplyEnabled), registers with the Renderer (SetWaterSystem) so the
+// reflection pass runs, shuts down when disabled, and Cleanup() must run
+// before the Renderer shuts down.
 #pragma once
 #include "../EditorContext.hpp"
 #include "Engine/Hydro/WaterSystem.hpp"
+#include "Engine/Renderer/Frustum.hpp"
 #include <imgui.h>
 
 namespace Nightbloom
@@ -15,26 +17,37 @@ namespace Nightbloom
     {
     public:
         bool isOpen = true;
+        // Part of the scene: the WaterSystem exists only while enabled
+        bool enabled = false;
 
         void Draw(EditorContext& ctx);
 
+        // Creates or tears down the WaterSystem to match `enabled` (see
+        // CloudPanel::ApplyEnabled)
+        void ApplyEnabled(Renderer* renderer);
+
         // Call before the renderer shuts down (Vulkan device still alive).
         void Cleanup();
 
-        void SubmitWaterDraw(DrawList& drawList) const
+        void SubmitWaterDraw(DrawList& drawList, const Frustum& frustum, const glm::vec3& cameraPosition)
         {
             if (m_Initialized && m_Water.IsReady())
-                m_Water.SubmitDraw(drawList);
+            {
+                m_Water.UpdateLOD(cameraPosition);
+                m_Water.SubmitDraw(drawList, &frustum);
+            }
         }
 
         WaterSystem& GetSystem() { return m_Water; }
+        // Waves / scrolling normals
+        bool IsAnimating() const { return m_Initialized && m_Water.IsReady(); }
 
     private:
         WaterSystem m_Water;
         bool        m_Initialized = false;
 
-        // Mirror the live desc so resolution/worldSize edits (which need a mesh
-        // rebuild) can be detected; everything else binds straight to the live
+        // Mirror the live desc so grid/worldSize edits (which need a
+        // Regenerate) can be detected; everything else binds straight to the live
         // desc and is read per-frame in SubmitDraw / the reflection matrix.
         bool EnsureInitialized(Renderer* renderer);
     };
@@ -0,0 +1,475 @@
+//------------------------------------------------------------------------------
+// ShaderCompileService.cpp
+//
+// In-process (shaderc) or child-process (glslc) shader compilation behind
+// the SPIR-V cache
+//------------------------------------------------------------------------------
+
+#include "ShaderCompileService.hpp"
+#include "EditorFileUtils.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Renderer/ShaderVariant.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if NIGHTBLOOM_HAS_SHADERC
+#include <shaderc/shaderc.hpp>
+#endif
+
+namespace Nightbloom {
+namespace Editor {
+
+	namespace
+	{
+		// Everything besides the sources that changes the SPIR-V; part of the key
+		constexpr const char* COMPILE_OPTIONS = "-O";
+		constexpr const char* VULKAN_1_1_OPTION = "--target-env=vulkan1.1";
+		constexpr const char* VULKAN_1_2_OPTION = "--target-env=vulkan1.2";
+
+		// Subgroup operations are SPIR-V 1.3, so that build targets Vulkan 1.1
+		bool TargetsVulkan11(const char* define)
+		{
+			return define && std::string(define) == GetShaderBuildDefine(ShaderBuild::SubgroupOps);
+		}
+
+		// Ray queries are SPIR-V 1.4, so that build targets Vulkan 1.2
+		bool TargetsVulkan12(const char* define)
+		{
+			return define && std::string(define) == GetShaderBuildDefine(ShaderBuild::RayQuery);
+		}
+
+		struct StageInfo
+		{
+			const char* extension;
+			const char* glslcFlag;
+#if NIGHTBLOOM_HAS_SHADERC
+			shaderc_shader_kind kind;
+#endif
+		};
+
+#if NIGHTBLOOM_HAS_SHADERC
+#define NB_STAGE(ext, flag, kind) { ext, flag, kind }
+#else
+#define NB_STAGE(ext, flag, kind) { ext, flag }
+#endif
+		const StageInfo STAGES[] = {
+			NB_STAGE(".vert", "-fshader-stage=vert", shaderc_glsl_vertex_shader),
+			NB_STAGE(".frag", "-fshader-stage=frag", shaderc_glsl_fragment_shader),
+			NB_STAGE(".comp", "-fshader-stage=comp", shaderc_glsl_compute_shader),
+			NB_STAGE(".geom", "-fshader-stage=geom", shaderc_glsl_geometry_shader),
+			NB_STAGE(".tesc", "-fshader-stage=tesc", shaderc_glsl_tess_control_shader),
+			NB_STAGE(".tese", "-fshader-stage=tese", shaderc_glsl_tess_evaluation_shader),
+		};
+#undef NB_STAGE
+
+		const StageInfo* FindStage(const std::filesystem::path& shader)
+		{
+			std::string ext = shader.extension().string();
+			std::transform(ext.begin(), ext.end(), ext.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			for (const StageInfo& stage : STAGES)
+			{
+				if (ext == stage.extension)
+					return &stage;
+			}
+			return nullptr;
+		}
+
+		bool ReadFile(const std::filesystem::path& path, std::string& out)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+				return false;
+			std::stringstream buffer;
+			buffer << file.rdbuf();
+			out = buffer.str();
+			return true;
+		}
+
+#if NIGHTBLOOM_HAS_SHADERC
+		// Same lookup as ShaderBuildCache: next to the includer, then the include dir
+		class Includer : public shaderc::CompileOptions::IncluderInterface
+		{
+		public:
+			explicit Includer(std::filesystem::path includeDir) : m_IncludeDir(std::move(includeDir)) {}
+
+			shaderc_include_result* GetInclude(const char* requested, shaderc_include_type type,
+				const char* requesting, size_t /*depth*/) override
+			{
+				auto* result = new Result();
+				std::filesystem::path candidates[2];
+				size_t count = 0;
+				if (type == shaderc_include_type_relative)
+					candidates[count++] = std::filesystem::path(requesting).parent_path() / requested;
+				candidates[count++] = m_IncludeDir / requested;
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (ReadFile(candidates[i], result->content))
+					{
+						result->name = candidates[i].lexically_normal().string();
+						break;
+					}
+				}
+				if (result->name.empty())
+					result->content = std::string("cannot find include \"") + requested + "\"";
+
+				// An empty source_name is how shaderc signals failure
+				result->result.source_name = result->name.c_str();
+				result->result.source_name_length = result->name.size();
+				result->result.content = result->content.c_str();
+				result->result.content_length = result->content.size();
+				result->result.user_data = result;
+				return &result->result;
+			}
+
+			void ReleaseInclude(shaderc_include_result* data) override
+			{
+				delete static_cast<Result*>(data->user_data);
+			}
+
+		private:
+			struct Result
+			{
+				shaderc_include_result result{};
+				std::string name;
+				std::string content;
+			};
+
+			std::filesystem::path m_IncludeDir;
+		};
+#endif
+	}
+
+	ShaderCompileService& ShaderCompileService::Get()
+	{
+		static ShaderCompileService instance;
+		return instance;
+	}
+
+	void ShaderCompileService::Initialize(const Paths& paths)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Paths = paths;
+		m_Cache = std::make_unique<ShaderBuildCache>(std::vector<std::filesystem::path>{ paths.includeDir });
+
+		EditorFileUtils::MakeDirectory(paths.cacheDir.string());
+		if (!m_Cache->LoadManifest(paths.cacheDir / "manifest.txt"))
+			LOG_INFO("No shader build manifest yet; the first rebuild compiles every shader");
+
+		LOG_INFO("Shader compiler: {} (sources {}, cache {})", GetBackendName(),
+			paths.sourceDir.string(), paths.cacheDir.string());
+	}
+
+	void ShaderCompileService::Shutdown()
+	{
+		if (m_AsyncPending)
+		{
+			JobSystem::Get().Wait(m_RebuildCounter);
+			m_AsyncPending = false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Cache)
+		{
+			m_Cache->SaveManifest(m_Paths.cacheDir / "manifest.txt");
+			m_Cache.reset();
+		}
+	}
+
+	const char* ShaderCompileService::GetBackendName()
+	{
+#if NIGHTBLOOM_HAS_SHADERC
+		return "shaderc";
+#else
+		return "glslc";
+#endif
+	}
+
+	bool ShaderCompileService::CompileFile(const std::filesystem::path& shader, const std::filesystem::path& output)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Cache)
+		{
+			LOG_ERROR("Shader compiler not initialized");
+			return false;
+		}
+
+		ShaderBuildKey key;
+		std::string log;
+		m_Cache->BeginScan();
+		if (!m_Cache->ComputeKey(shader, COMPILE_OPTIONS, key, log))
+		{
+			LOG_ERROR("Shader {}: {}", shader.filename().string(), log);
+			return false;
+		}
+
+		bool fromCache = false;
+		if (!Build(shader, key, output, nullptr, fromCache, log))
+		{
+			LOG_ERROR("Shader {} failed:\n{}", shader.filename().string(), log);
+			return false;
+		}
+
+		LOG_INFO("Shader {} -> {}{}", shader.filename().string(), output.string(), fromCache ? " (cached)" : "");
+		return true;
+	}
+
+	bool ShaderCompileService::RebuildChanged(RebuildStats& stats)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		stats = RebuildStats{};
+		if (!m_Cache)
+		{
+			LOG_WARN("Shader compiler not initialized; nothing rebuilt");
+			return false;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+
+		struct Work
+		{
+			std::filesystem::path shader;
+			std::filesystem::path build;   // what the manifest tracks: the shader, or its second build's name
+			std::filesystem::path output;
+			const char* define = nullptr;  // a second build's (ShaderBuild)
+			ShaderBuildKey key;
+			bool ok = false;
+			bool fromCache = false;
+			std::string log;
+		};
+		std::vector<Work> work;
+
+		// Scan on this thread: one read per file, however many shaders share it
+		std::error_code ec;
+		m_Cache->BeginScan();
+		for (const auto& entry : std::filesystem::directory_iterator(m_Paths.sourceDir, ec))
+		{
+			if (!entry.is_regular_file() || !FindStage(entry.path()))
+				continue;
+
+			// The plain build, then the shader's second builds, one key each
+			const std::string name = entry.path().filename().string();
+			for (uint32_t b = 0; b <= static_cast<uint32_t>(ShaderBuild::Count); ++b)
+			{
+				const bool second = b > 0;
+				const ShaderBuild build = static_cast<ShaderBuild>(b - 1);
+				if (second && (build == ShaderBuild::Count || !HasShaderBuild(name, build)))
+					continue;
+
+				++stats.scanned;
+				Work item;
+				item.shader = entry.path();
+				item.define = second ? GetShaderBuildDefine(build) : nullptr;
+				item.build = second ? entry.path().parent_path() / GetShaderBuildName(name, build) : entry.path();
+				item.output = m_Paths.runtimeDir / (item.build.filename().string() + ".spv");
+
+				std::string options = item.define ? std::string(COMPILE_OPTIONS) + " -D" + item.define : COMPILE_OPTIONS;
+				if (TargetsVulkan11(item.define))
+					options += std::string(" ") + VULKAN_1_1_OPTION;
+				else if (TargetsVulkan12(item.define))
+					options += std::string(" ") + VULKAN_1_2_OPTION;
+				std::string error;
+				if (!m_Cache->ComputeKey(item.shader, options, item.key, error))
+				{
+					LOG_ERROR("Shader {}: {}", item.build.filename().string(), error);
+					++stats.failed;
+					continue;
+				}
+
+				if (m_Cache->IsUpToDate(item.build, item.key) && std::filesystem::exists(item.output))
+				{
+					++stats.upToDate;
+					continue;
+				}
+				work.push_back(std::move(item));
+			}
+		}
+		if (ec)
+		{
+			LOG_ERROR("Cannot scan shader sources {}: {}", m_Paths.sourceDir.string(), ec.message());
+			return false;
+		}
+
+		EditorFileUtils::MakeDirectory(m_Paths.runtimeDir.string());
+
+		// One shader per chunk: compile times vary a lot (ocean vs. a blit)
+		if (!work.empty())
+		{
+			JobSystem::Get().ParallelFor(static_cast<uint32_t>(work.size()), 1,
+				[this, &work](uint32_t begin, uint32_t end) {
+					for (uint32_t i = begin; i < end; ++i)
+					{
+						Work& item = work[i];
+						item.ok = Build(item.shader, item.key, item.output, item.define, item.fromCache, item.log);
+					}
+				});
+		}
+
+		for (const Work& item : work)
+		{
+			if (!item.ok)
+			{
+				LOG_ERROR("Shader {} failed:\n{}", item.build.filename().string(), item.log);
+				++stats.failed;
+				continue;
+			}
+
+			m_Cache->MarkBuilt(item.build, item.key);
+			if (item.fromCache)
+				++stats.fromCache;
+			else
+				++stats.compiled;
+		}
+
+		if (!work.empty())
+			m_Cache->SaveManifest(m_Paths.cacheDir / "manifest.txt");
+
+		stats.milliseconds = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+		LOG_INFO("Shaders: {} compiled, {} from cache, {} up to date, {} failed ({:.1f} ms, {})",
+			stats.compiled, stats.fromCache, stats.upToDate, stats.failed, stats.milliseconds, GetBackendName());
+
+		return stats.failed == 0;
+	}
+
+	void ShaderCompileService::RebuildChangedAsync()
+	{
+		if (m_AsyncPending)
+			return;
+
+		m_AsyncPending = true;
+		JobSystem::Get().Run([this]() { RebuildChanged(m_AsyncStats); }, &m_RebuildCounter);
+	}
+
+	bool ShaderCompileService::PollRebuild(RebuildStats& stats)
+	{
+		if (!m_AsyncPending || !m_RebuildCounter.IsDone())
+			return false;
+
+		m_AsyncPending = false;
+		stats = m_AsyncStats;
+		return true;
+	}
+
+	bool ShaderCompileService::Build(const std::filesystem::path& shader, const ShaderBuildKey& key,
+		const std::filesystem::path& output, const char* define, bool& fromCache, std::string& log) const
+	{
+		const std::filesystem::path cached = ShaderBuildCache::GetCachedSpirvPath(m_Paths.cacheDir, shader, key.hash);
+		std::error_code ec;
+		fromCache = std::filesystem::exists(cached, ec);
+
+		if (!fromCache)
+		{
+			// Compile beside the entry and rename, so a failed or interrupted
+			// compile never leaves a truncated entry under a valid key
+			std::filesystem::path temp = cached;
+			temp += ".tmp";
+			if (!CompileToSpirv(shader, temp, define, log))
+			{
+				std::filesystem::remove(temp, ec);
+				return false;
+			}
+			std::filesystem::rename(temp, cached, ec);
+			if (ec)
+			{
+				log = "cannot write " + cached.string() + ": " + ec.message();
+				return false;
+			}
+		}
+
+		std::filesystem::copy_file(cached, output, std::filesystem::copy_options::overwrite_existing, ec);
+		if (ec)
+		{
+			log = "cannot copy to " + output.string() + ": " + ec.message();
+			return false;
+		}
+		return true;
+	}
+
+	bool ShaderCompileService::CompileToSpirv(const std::filesystem::path& shader,
+		const std::filesystem::path& output, const char* define, std::string& log) const
+	{
+		const StageInfo* stage = FindStage(shader);
+		if (!stage)
+		{
+			log = "unknown shader stage for " + shader.filename().string();
+			return false;
+		}
+
+#if NIGHTBLOOM_HAS_SHADERC
+		std::string source;
+		if (!ReadFile(shader, source))
+		{
+			log = "cannot read " + shader.string();
+			return false;
+		}
+
+		// A compiler per call: cheap next to the compile, and nothing shared
+		// between worker threads
+		shaderc::Compiler compiler;
+		shaderc::CompileOptions options;
+		options.SetOptimizationLevel(shaderc_optimization_level_performance);
+		options.SetIncluder(std::make_unique<Includer>(m_Paths.includeDir));
+		if (define)
+			options.AddMacroDefinition(define);
+		if (TargetsVulkan11(define))
+			options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_1);
+		else if (TargetsVulkan12(define))
+			options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+
+		const std::string sourceName = shader.string();
+		shaderc::SpvCompilationResult result =
+			compiler.CompileGlslToSpv(source, stage->kind, sourceName.c_str(), options);
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+		{
+			log = result.GetErrorMessage();
+			return false;
+		}
+
+		const std::vector<uint32_t> spirv(result.cbegin(), result.cend());
+		std::ofstream file(output, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(spirv.data()),
+			static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+		if (!file)
+		{
+			log = "cannot write " + output.string();
+			return false;
+		}
+		return true;
+#else
+		const std::string glslc = EditorFileUtils::FindGlslcCompiler();
+		if (glslc.empty())
+		{
+			log = "glslc not found; install the Vulkan SDK";
+			return false;
+		}
+
+		std::vector<std::string> args;
+		args.emplace_back(stage->glslcFlag);
+		args.emplace_back(COMPILE_OPTIONS);
+		if (define)
+			args.emplace_back(std::string("-D") + define);
+		if (TargetsVulkan11(define))
+			args.emplace_back(VULKAN_1_1_OPTION);
+		else if (TargetsVulkan12(define))
+			args.emplace_back(VULKAN_1_2_OPTION);
+		args.emplace_back("-I");
+		args.emplace_back(m_Paths.includeDir.string());
+		args.emplace_back(shader.string());
+		args.emplace_back("-o");
+		args.emplace_back(output.string());
+
+		const int rc = EditorFileUtils::RunAndCapture(glslc, args, log);
+		if (rc != 0 && log.empty())
+			log = "glslc exited with code " + std::to_string(rc);
+		return rc == 0;
+#endif
+	}
+
+} // namespace Editor
+} // namespace Nightbloom
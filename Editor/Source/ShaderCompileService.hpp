@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// ShaderCompileService.hpp
+//
+// GLSL -> SPIR-V for the editor. Compiles in-process with shaderc when the
+// Vulkan SDK provides it (NIGHTBLOOM_HAS_SHADERC), otherwise runs glslc as a
+// child process. Either way builds go through ShaderBuildCache: a shader is
+// only compiled when its source, an include it reaches or the options
+// changed, and compiled SPIR-V is kept content-addressed in cacheDir.
+//
+// RebuildChanged() rescans the editor's shader sources, compiles the dirty
+// ones in parallel on the job system and copies the results to where the
+// renderer loads them; Renderer::ReloadShaders() then picks them up. Shaders
+// with second builds (ShaderBuild: fp16, subgroup ops, ray query) get them rebuilt
+// alongside.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Renderer/ShaderBuildCache.hpp"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Nightbloom {
+namespace Editor {
+
+	class ShaderCompileService
+	{
+	public:
+		struct Paths
+		{
+			std::filesystem::path sourceDir;    // Editor/Shaders: *.vert, *.frag, *.comp, ...
+			std::filesystem::path includeDir;   // Editor/Shaders/Include
+			std::filesystem::path runtimeDir;   // where the renderer loads <name>.spv from
+			std::filesystem::path cacheDir;     // content-addressed SPIR-V and the manifest
+		};
+
+		struct RebuildStats
+		{
+			uint32_t scanned = 0;
+			uint32_t upToDate = 0;
+			uint32_t fromCache = 0;   // unchanged content built before: copied, not compiled
+			uint32_t compiled = 0;
+			uint32_t failed = 0;
+			double milliseconds = 0.0;
+		};
+
+		static ShaderCompileService& Get();
+
+		void Initialize(const Paths& paths);
+		// Waits for a running rebuild and saves the manifest
+		void Shutdown();
+		bool IsInitialized() const { return m_Cache != nullptr; }
+
+		// "shaderc" (in-process) or "glslc" (child process)
+		static const char* GetBackendName();
+
+		// Compiles one shader to `output` through the SPIR-V cache. Blocks.
+		bool CompileFile(const std::filesystem::path& shader, const std::filesystem::path& output);
+
+		// Rebuilds every shader in sourceDir whose key changed since it was
+		// last deployed, spread over the job workers, and copies the results
+		// to runtimeDir. Blocks; false when any shader failed.
+		bool RebuildChanged(RebuildStats& stats);
+
+		// RebuildChanged() on a job; PollRebuild() reports when it is done
+		void RebuildChangedAsync();
+		bool IsRebuilding() const { return m_AsyncPending && !m_RebuildCounter.IsDone(); }
+		// True once per finished async rebuild (main thread)
+		bool PollRebuild(RebuildStats& stats);
+
+	private:
+		ShaderCompileService() = default;
+
+		// Cache hit or compile into cacheDir, then copy to `output`. Thread-safe.
+		// `define` (or null) compiles a second build (GetShaderBuildDefine).
+		bool Build(const std::filesystem::path& shader, const ShaderBuildKey& key,
+			const std::filesystem::path& output, const char* define, bool& fromCache, std::string& log) const;
+		bool CompileToSpirv(const std::filesystem::path& shader, const std::filesystem::path& output,
+			const char* define, std::string& log) const;
+
+		Paths m_Paths;
+		// Scans and build records; guarded by m_Mutex (the rebuild job vs a
+		// CompileFile from a panel)
+		std::unique_ptr<ShaderBuildCache> m_Cache;
+		std::mutex m_Mutex;
+
+		JobCounter m_RebuildCounter;
+		bool m_AsyncPending = false;
+		RebuildStats m_AsyncStats;
+	};
+
+} // namespace Editor
+} // namespace Nightbloom
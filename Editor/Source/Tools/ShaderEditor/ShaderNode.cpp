@@ -237,8 +237,15 @@ namespace Nightbloom
 
 	std::string ColorNode::GenerateGLSL(const ShaderGraph* graph) const {
 		std::stringstream ss;
-		ss << "vec4 " << GetOutputVariable(0) << " = vec4("
-			<< color[0] << ", " << color[1] << ", " << color[2] << ", " << color[3] << ");\n";
+		if (parameterSlot >= 0) {
+			// The value isn't part of the code, so editing it never recompiles
+			ss << "vec4 " << GetOutputVariable(0) << " = "
+				<< ShaderGraph::GetParameterExpression(parameterSlot) << ";\n";
+		}
+		else {
+			ss << "vec4 " << GetOutputVariable(0) << " = vec4("
+				<< color[0] << ", " << color[1] << ", " << color[2] << ", " << color[3] << ");\n";
+		}
 		ss << "vec3 " << GetOutputVariable(1) << " = " << GetOutputVariable(0) << ".rgb;\n";
 		return ss.str();
 	}
@@ -138,6 +138,10 @@ namespace Nightbloom
 		void DrawProperties() override;
 
 		float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		// Push-constant slot the color is read from instead of being baked in
+		// as a literal (assigned by ShaderGraph::RefreshShaderInfo); -1 = literal
+		int parameterSlot = -1;
 	};
 
 	class TimeNode : public ShaderNode {
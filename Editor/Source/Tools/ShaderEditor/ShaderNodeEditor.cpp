@@ -164,11 +164,14 @@ namespace Nightbloom
 		ss << "void main() {\n";
 		ss << "    float time = frame.time.x;\n\n";
 
-		// Get nodes in dependency order
+		// Get nodes in dependency order; nodes not feeding the output are left
+		// out, so editing them never changes the code
 		std::vector<int> sortedNodeIds = GetTopologicalSort();
+		std::unordered_set<int> subgraph = GetOutputSubgraph();
 
 		// Generate code in correct order
 		for (int nodeId : sortedNodeIds) {
+			if (!subgraph.count(nodeId)) continue;
 			ShaderNode* node = const_cast<ShaderNode*>(GetNode(nodeId));
 			if (node && dynamic_cast<FragmentOutputNode*>(node) == nullptr) {
 				ss << "    // " << node->name << " (Node " << node->id << ")\n";
@@ -229,6 +232,70 @@ namespace Nightbloom
 		return result;
 	}
 
+	std::unordered_set<int> ShaderGraph::GetOutputSubgraph() const {
+		std::unordered_set<int> reached;
+		std::vector<int> stack;
+		for (const auto& node : nodes) {
+			if (dynamic_cast<FragmentOutputNode*>(node.get()) != nullptr) {
+				stack.push_back(node->id);
+			}
+		}
+
+		// Walk connections upstream from the output
+		while (!stack.empty()) {
+			int nodeId = stack.back();
+			stack.pop_back();
+			if (!reached.insert(nodeId).second) continue;
+
+			for (const auto& conn : connections) {
+				if (conn.endNode == nodeId) {
+					stack.push_back(conn.startNode);
+				}
+			}
+		}
+		return reached;
+	}
+
+	uint64_t ShaderGraph::ComputeCodeHash() const {
+		auto combine = [](uint64_t& seed, uint64_t value) {
+			seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+		};
+
+		// Subgraph hash per node, memoized so shared upstream nodes are
+		// hashed once
+		std::unordered_map<int, uint64_t> subgraphHashes;
+		std::function<uint64_t(int)> hashNode = [&](int nodeId) -> uint64_t {
+			auto it = subgraphHashes.find(nodeId);
+			if (it != subgraphHashes.end()) return it->second;
+			subgraphHashes[nodeId] = 0; // Cycle guard
+
+			const ShaderNode* node = GetNode(nodeId);
+			uint64_t hash = node ? std::hash<std::string>{}(node->GenerateGLSL(this)) : 0;
+			for (const auto& conn : connections) {
+				if (conn.endNode == nodeId) {
+					combine(hash, static_cast<uint64_t>(conn.endPin));
+					combine(hash, hashNode(conn.startNode));
+				}
+			}
+
+			subgraphHashes[nodeId] = hash;
+			return hash;
+			};
+
+		uint64_t hash = usesTextures ? 1 : 0;
+		for (const auto& node : nodes) {
+			if (dynamic_cast<FragmentOutputNode*>(node.get()) != nullptr) {
+				combine(hash, hashNode(node->id));
+			}
+		}
+		return hash;
+	}
+
+	std::string ShaderGraph::GetParameterExpression(int slot) {
+		// Slot 0 is the per-object customData vec4 of the push block below
+		return slot == 0 ? "push.customData" : "vec4(1.0)";
+	}
+
 	std::string ShaderGraph::GenerateVertexShader() const {
 		// For now, use a standard vertex shader
 		std::stringstream ss;
@@ -265,15 +332,29 @@ namespace Nightbloom
 
 	void ShaderGraph::RefreshShaderInfo()
 	{
+		std::unordered_set<int> subgraph = GetOutputSubgraph();
+
 		usesTextures = false;
+		parameterNodes.clear();
 		for (const auto& node : nodes) {
 			if (dynamic_cast<TextureNode*>(node.get()) != nullptr) {
-				usesTextures = true;
+				if (subgraph.count(node->id)) usesTextures = true;
 				
 				for (auto& pin : node->outputPins) {
 					pin.resolvedType = pin.type;
 				}
 			}
+
+			// Nodes are kept in creation order, so slots stay stable as the
+			// graph grows
+			if (auto* color = dynamic_cast<ColorNode*>(node.get())) {
+				color->parameterSlot = -1;
+				if (subgraph.count(node->id) &&
+					static_cast<int>(parameterNodes.size()) < MAX_PARAMETER_SLOTS) {
+					color->parameterSlot = static_cast<int>(parameterNodes.size());
+					parameterNodes.push_back(node->id);
+				}
+			}
 		}
 
 		ResolveAllTypes();
@@ -732,11 +813,28 @@ namespace Nightbloom
 		}
 	}
 
+	uint64_t ShaderNodeEditor::RefreshCodeHash() {
+		graph->RefreshShaderInfo();
+		return graph->ComputeCodeHash();
+	}
+
+	std::array<float, 4> ShaderNodeEditor::GetParameterValue(int nodeId) const {
+		if (const auto* color = dynamic_cast<const ColorNode*>(graph->GetNode(nodeId))) {
+			return { color->color[0], color->color[1], color->color[2], color->color[3] };
+		}
+		return { 1.0f, 1.0f, 1.0f, 1.0f };
+	}
+
 	bool ShaderNodeEditor::CompileShaders() {
 		try {
-			graph->RefreshShaderInfo();
+			uint64_t hash = RefreshCodeHash();
+			if (hash == generatedHash && !fragmentShaderCode.empty()) {
+				return true;
+			}
+
 			vertexShaderCode = graph->GenerateVertexShader();
 			fragmentShaderCode = graph->GenerateFragmentShader();
+			generatedHash = hash;
 			return true;
 		}
 		catch (const std::exception& e) {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ShaderNode.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_set>
 
 namespace Nightbloom
 {
@@ -21,12 +24,27 @@ namespace Nightbloom
 		void Connect(int startNode, int startPin, int endNode, int endPin);
 		void Disconnect(int connectionId);
 
-		// Code generation
+		// Code generation. Only the nodes the output depends on are emitted.
 		std::string GenerateFragmentShader() const;
 		std::string GenerateVertexShader() const;
 
+		// Hash of everything the generated GLSL depends on: each node's own
+		// code combined with its upstream subgraph, from the output node back.
+		// Run RefreshShaderInfo first. Parameter values are not part of it.
+		uint64_t ComputeCodeHash() const;
+
+		// Pure-constant node values (ColorNode) are promoted to push-constant
+		// slots, so tweaking them never changes the code. The per-object
+		// push block only has customData free, hence a single slot; further
+		// colors stay literals.
+		static constexpr int MAX_PARAMETER_SLOTS = 1;
+		static std::string GetParameterExpression(int slot);
+		// Node id per slot, in slot order
+		const std::vector<int>& GetParameterNodes() const { return parameterNodes; }
+
 		// Utility
 		std::vector<int> GetTopologicalSort() const;
+		std::unordered_set<int> GetOutputSubgraph() const;
 		void RefreshShaderInfo();
 		void ResolveAllTypes();
 		bool UsesTextures() const { return usesTextures; }
@@ -38,6 +56,7 @@ namespace Nightbloom
 		int nextConnectionId = 1;
 
 		bool usesTextures = false;
+		std::vector<int> parameterNodes;
 	};
 
 	// Main editor class
@@ -49,10 +68,19 @@ namespace Nightbloom
 		// Main UI function - call this in your ImGui loop
 		void Draw(const char* title, bool* p_open = nullptr);
 
-		// Shader compilation
+		// Shader compilation. Regenerates the GLSL only when the graph's code
+		// hash moved since the last successful call.
 		bool CompileShaders();
 		std::string GetLastError() const { return lastError; }
 
+		// Current code hash; cheap enough to poll every frame
+		uint64_t RefreshCodeHash();
+
+		// Promoted parameter values, read from the nodes of a previous compile
+		// (ids that no longer exist keep their slot at white)
+		std::vector<int> GetParameterNodes() const { return graph->GetParameterNodes(); }
+		std::array<float, 4> GetParameterValue(int nodeId) const;
+
 		// Get generated shaders
 		std::string GetVertexShader() const { return vertexShaderCode; }
 		std::string GetFragmentShader() const { return fragmentShaderCode; }
@@ -87,6 +115,7 @@ namespace Nightbloom
 		std::string vertexShaderCode;
 		std::string fragmentShaderCode;
 		std::string lastError;
+		uint64_t generatedHash = 0;
 
 		// Style
 		std::unordered_map<PinType, PinStyle> pinStyles;
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+// CoreBenchmarks.cpp
+//
+// Logger formatting and the Math types
+//------------------------------------------------------------------------------
+
+#include <benchmark/benchmark.h>
+#include "SyntheticScene.hpp"
+#include "../Core/Logger/Logger.hpp"
+#include "../Math/Vec3.hpp"
+#include "../Math/Vec4.hpp"
+#include "../Math/SimdMath.hpp"
+#include <memory>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Counts what reaches it, so the benchmark measures formatting and
+	// dispatch rather than a console
+	class NullLogSink : public ILogSink
+	{
+	public:
+		void Write(LogLevel level, const std::string& message) override
+		{
+			(void)level;
+			m_Bytes += message.size();
+		}
+
+		size_t m_Bytes = 0;
+	};
+
+	// Installs a NullLogSink on the global Logger for one benchmark run
+	class ScopedNullSink
+	{
+	public:
+		explicit ScopedNullSink(LogLevel level)
+			: m_Sink(std::make_shared<NullLogSink>())
+		{
+			Logger::Get().ClearSinks();
+			Logger::Get().AddSink(m_Sink);
+			Logger::Get().SetLogLevel(level);
+		}
+
+		~ScopedNullSink()
+		{
+			Logger::Get().ClearSinks();
+			Logger::Get().SetLogLevel(LogLevel::Trace);
+		}
+
+		size_t GetBytes() const { return m_Sink->m_Bytes; }
+
+	private:
+		std::shared_ptr<NullLogSink> m_Sink;
+	};
+
+	std::vector<glm::mat4> MakeMatrices(size_t count)
+	{
+		std::vector<glm::mat4> matrices;
+		matrices.reserve(count);
+		for (const Bench::SyntheticObject& object : Bench::MakeSyntheticObjects(count))
+			matrices.push_back(object.transform);
+		return matrices;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Logger
+//------------------------------------------------------------------------------
+
+static void BM_LoggerLogFormatted(benchmark::State& state)
+{
+	ScopedNullSink sink(LogLevel::Trace);
+	int frame = 0;
+	for (auto _ : state)
+		Logger::Get().LogFormatted(LogLevel::Info, "Frame {}: {} draws, {:.2f} ms", frame++, 1234, 16.6667f);
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(static_cast<int64_t>(sink.GetBytes()));
+}
+BENCHMARK(BM_LoggerLogFormatted);
+
+// Below the minimum level: the cost every filtered LOG_TRACE pays
+static void BM_LoggerLogFormattedFiltered(benchmark::State& state)
+{
+	ScopedNullSink sink(LogLevel::Warn);
+	int frame = 0;
+	for (auto _ : state)
+		Logger::Get().LogFormatted(LogLevel::Trace, "Frame {}: {} draws, {:.2f} ms", frame++, 1234, 16.6667f);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLogFormattedFiltered);
+
+//------------------------------------------------------------------------------
+// Math
+//------------------------------------------------------------------------------
+
+static void BM_Vec3Dot(benchmark::State& state)
+{
+	const size_t count = static_cast<size_t>(state.range(0));
+	std::vector<Vec3> a(count), b(count);
+	Bench::BenchRandom random(7);
+	for (size_t i = 0; i < count; ++i)
+	{
+		a[i] = Vec3(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f));
+		b[i] = Vec3(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f));
+	}
+
+	for (auto _ : state)
+	{
+		float sum = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+			sum += (a[i] + b[i] * 0.5f).Dot(b[i]);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec3Dot)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_LARGE);
+
+static void BM_Vec4Normalize(benchmark::State& state)
+{
+	const size_t count = static_cast<size_t>(state.range(0));
+	std::vector<Vec4> vectors(count);
+	Bench::BenchRandom random(11);
+	for (Vec4& v : vectors)
+		v = Vec4(random.Range(0.1f, 1.0f), random.Range(0.1f, 1.0f), random.Range(0.1f, 1.0f), random.Range(0.1f, 1.0f));
+
+	std::vector<Vec4> out(count);
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; ++i)
+			out[i] = vectors[i].Normalized();
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Vec4Normalize)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_LARGE);
+
+// Simd:: kernels against the glm operators they replace. Arg 1 = SIMD.
+static void BM_Mat4Multiply(benchmark::State& state)
+{
+	const std::vector<glm::mat4> matrices = MakeMatrices(static_cast<size_t>(Bench::SCENE_SMALL));
+	const glm::mat4 viewProj = Bench::MakeBenchViewProj(matrices.size());
+	const bool simd = state.range(0) != 0;
+
+	std::vector<glm::mat4> out(matrices.size());
+	for (auto _ : state)
+	{
+		if (simd)
+		{
+			for (size_t i = 0; i < matrices.size(); ++i)
+				out[i] = Simd::Multiply(viewProj, matrices[i]);
+		}
+		else
+		{
+			for (size_t i = 0; i < matrices.size(); ++i)
+				out[i] = viewProj * matrices[i];
+		}
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(matrices.size()));
+}
+BENCHMARK(BM_Mat4Multiply)->Arg(0)->Arg(1);
+
+static void BM_Mat4Inverse(benchmark::State& state)
+{
+	const std::vector<glm::mat4> matrices = MakeMatrices(static_cast<size_t>(Bench::SCENE_SMALL));
+	const bool simd = state.range(0) != 0;
+
+	std::vector<glm::mat4> out(matrices.size());
+	for (auto _ : state)
+	{
+		if (simd)
+		{
+			for (size_t i = 0; i < matrices.size(); ++i)
+				out[i] = Simd::Inverse(matrices[i]);
+		}
+		else
+		{
+			for (size_t i = 0; i < matrices.size(); ++i)
+				out[i] = glm::inverse(matrices[i]);
+		}
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(matrices.size()));
+}
+BENCHMARK(BM_Mat4Inverse)->Arg(0)->Arg(1);
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// CullingBenchmarks.cpp
+//
+// Frustum tests and bounds transforms over synthetic scenes
+//------------------------------------------------------------------------------
+
+#include <benchmark/benchmark.h>
+#include "SyntheticScene.hpp"
+#include "../Renderer/Frustum.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct WorldBoxes
+	{
+		std::vector<glm::vec3> centers;
+		std::vector<glm::vec3> extents;
+	};
+
+	WorldBoxes MakeWorldBoxes(size_t count)
+	{
+		WorldBoxes boxes;
+		boxes.centers.resize(count);
+		boxes.extents.resize(count);
+		const std::vector<Bench::SyntheticObject> objects = Bench::MakeSyntheticObjects(count);
+		for (size_t i = 0; i < count; ++i)
+			TransformAABB(objects[i].localMin, objects[i].localMax, objects[i].transform, boxes.centers[i], boxes.extents[i]);
+		return boxes;
+	}
+}
+
+static void BM_TransformAABB(benchmark::State& state)
+{
+	const size_t count = static_cast<size_t>(state.range(0));
+	const std::vector<Bench::SyntheticObject> objects = Bench::MakeSyntheticObjects(count);
+	std::vector<glm::vec3> centers(count), extents(count);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; ++i)
+			TransformAABB(objects[i].localMin, objects[i].localMax, objects[i].transform, centers[i], extents[i]);
+		benchmark::DoNotOptimize(centers.data());
+		benchmark::DoNotOptimize(extents.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformAABB)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE);
+
+static void BM_FrustumIntersects(benchmark::State& state)
+{
+	const size_t count = static_cast<size_t>(state.range(0));
+	const WorldBoxes boxes = MakeWorldBoxes(count);
+	const Frustum frustum = Frustum::ExtractFromMatrix(Bench::MakeBenchViewProj(count));
+
+	size_t visible = 0;
+	for (auto _ : state)
+	{
+		visible = 0;
+		for (size_t i = 0; i < count; ++i)
+			visible += frustum.Intersects(boxes.centers[i], boxes.extents[i]) ? 1 : 0;
+		benchmark::DoNotOptimize(visible);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["visible"] = static_cast<double>(visible);
+}
+BENCHMARK(BM_FrustumIntersects)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE);
+
+// The same boxes through the SoA path Scene::BuildDrawList uses
+static void BM_FrustumIntersectsBatch(benchmark::State& state)
+{
+	const size_t count = static_cast<size_t>(state.range(0));
+	const WorldBoxes boxes = MakeWorldBoxes(count);
+	const Frustum frustum = Frustum::ExtractFromMatrix(Bench::MakeBenchViewProj(count));
+
+	AABBBatch batch;
+	for (size_t i = 0; i < count; ++i)
+		batch.Add(boxes.centers[i], boxes.extents[i]);
+	std::vector<uint8_t> visible(batch.cx.size());
+
+	for (auto _ : state)
+	{
+		frustum.IntersectsBatch(batch, visible.data());
+		benchmark::DoNotOptimize(visible.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrustumIntersectsBatch)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE);
+
+// Transform + test per object, as a full culling pass does each frame
+static void BM_CullPass(benchmark::State& state)
+{
+	const size_t count = static_cast<size_t>(state.range(0));
+	const std::vector<Bench::SyntheticObject> objects = Bench::MakeSyntheticObjects(count);
+	const Frustum frustum = Frustum::ExtractFromMatrix(Bench::MakeBenchViewProj(count));
+
+	for (auto _ : state)
+	{
+		size_t visible = 0;
+		for (const Bench::SyntheticObject& object : objects)
+		{
+			glm::vec3 center, extents;
+			TransformAABB(object.localMin, object.localMax, object.transform, center, extents);
+			visible += frustum.Intersects(center, extents) ? 1 : 0;
+		}
+		benchmark::DoNotOptimize(visible);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CullPass)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE);
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+// GenerationBenchmarks.cpp
+//
+// CPU-side procedural generation: terrain grids, grass placement and the CPU
+// noise field
+//------------------------------------------------------------------------------
+
+#include <benchmark/benchmark.h>
+#include "../Terrain/TerrainMesh.hpp"
+#include "../Foliage/GrassScatter.hpp"
+#include "../Renderer/NoiseField.hpp"
+#include <vector>
+
+using namespace Nightbloom;
+
+static void BM_TerrainMeshGenerate(benchmark::State& state)
+{
+	const uint32_t resolution = static_cast<uint32_t>(state.range(0));
+	for (auto _ : state)
+	{
+		TerrainMeshData data = TerrainMesh::Generate(resolution, 200.0f);
+		benchmark::DoNotOptimize(data.vertices.data());
+		benchmark::DoNotOptimize(data.indices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_TerrainMeshGenerate)->Arg(65)->Arg(129)->Arg(257)->Arg(513)->Unit(benchmark::kMicrosecond);
+
+// GrassSystem::GenerateInstances' CPU path. Args: terrain world size, scatter
+// threads (0 = hardware concurrency, as GrassSystem passes)
+static void BM_GrassScatterGenerate(benchmark::State& state)
+{
+	GrassScatterSettings settings;
+	settings.terrainWorldSize = static_cast<float>(state.range(0));
+	const uint32_t threads = static_cast<uint32_t>(state.range(1));
+
+	std::vector<glm::vec4> instances;
+	std::vector<GrassPatch> patches;
+	for (auto _ : state)
+	{
+		GrassScatter::Generate(settings, UINT32_MAX, threads, instances, patches);
+		benchmark::DoNotOptimize(instances.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(instances.size()));
+	state.counters["instances"] = static_cast<double>(instances.size());
+}
+BENCHMARK(BM_GrassScatterGenerate)
+	->Args({ 100, 1 })->Args({ 200, 1 })->Args({ 200, 0 })->Args({ 400, 0 })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// A streamed terrain's CPU height queries: one tile's worth of noise points.
+// Args: noise type, 1 = Sample8 batches (0 = one Sample per point)
+static void BM_NoiseFieldSample(benchmark::State& state)
+{
+	NoiseTextureDesc desc;
+	desc.noiseType = static_cast<NoiseType>(state.range(0));
+	const NoiseField field(desc);
+	const bool batched = state.range(1) != 0;
+
+	const size_t count = 128 * 128;
+	std::vector<float> x(count), y(count), z(count, 0.5f), out(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = static_cast<float>(i % 128) / 128.0f;
+		y[i] = static_cast<float>(i / 128) / 128.0f;
+	}
+
+	for (auto _ : state)
+	{
+		if (batched)
+		{
+			for (size_t i = 0; i < count; i += NoiseField::BATCH)
+				field.Sample8(&x[i], &y[i], &z[i], &out[i]);
+		}
+		else
+		{
+			for (size_t i = 0; i < count; ++i)
+				out[i] = field.Sample(glm::vec3(x[i], y[i], z[i]));
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_NoiseFieldSample)
+	->Args({ 0, 0 })->Args({ 0, 1 })->Args({ 1, 0 })->Args({ 1, 1 })->Args({ 2, 0 })->Args({ 2, 1 })
+	->Unit(benchmark::kMillisecond);
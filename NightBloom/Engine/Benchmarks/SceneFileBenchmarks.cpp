@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// SceneFileBenchmarks.cpp
+//
+// Scene save/load round trips on synthetic scenes. SceneSerializer needs a
+// live Scene and renderer; these time the SceneFile encodings it reads and
+// writes through, which is all of its work that isn't resource loading.
+//------------------------------------------------------------------------------
+
+#include <benchmark/benchmark.h>
+#include "SyntheticScene.hpp"
+#include "../Core/SceneFile.hpp"
+#include <filesystem>
+#include <string>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// A sun and a few lamps, then models and primitives with every tenth
+	// object parented to the one before
+	SceneFileData MakeSceneData(size_t count)
+	{
+		SceneFileData data;
+		data.name = "Synthetic" + std::to_string(count);
+		data.camera.position = glm::vec3(0.0f, 20.0f, 50.0f);
+		data.editorJson = R"({"dayNight":{"time":0.25}})";
+
+		Light sun;
+		sun.name = "Sun";
+		sun.direction = glm::vec3(0.0f, -1.0f, 0.5f);
+		sun.shadowConfig.castsShadows = true;
+		data.lights.push_back(sun);
+		for (int i = 0; i < 8; ++i)
+		{
+			Light lamp;
+			lamp.name = "Lamp" + std::to_string(i);
+			lamp.type = LightType::Point;
+			lamp.position = glm::vec3(static_cast<float>(i) * 4.0f, 3.0f, 0.0f);
+			data.lights.push_back(lamp);
+		}
+
+		const std::vector<Bench::SyntheticObject> objects = Bench::MakeSyntheticObjects(count);
+		data.objects.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			SceneFileObject& object = data.objects.emplace_back();
+			object.name = "Object" + std::to_string(i);
+			if (i % 4 == 0)
+			{
+				object.kind = SceneFileObject::Kind::Primitive;
+				object.primitive = "TestCube";
+				object.texture = "grass";
+			}
+			else
+			{
+				object.source = "Assets/Models/Tree/Tree.gltf";
+			}
+			object.parent = (i % 10 == 9) ? static_cast<int32_t>(i - 1) : -1;
+			object.position = objects[i].position;
+			object.rotation = glm::vec3(0.0f, objects[i].yaw, 0.0f);
+			object.scale = glm::vec3(objects[i].scale);
+		}
+		return data;
+	}
+
+	std::string TempScenePath(const char* extension)
+	{
+		return (std::filesystem::temp_directory_path() / (std::string("NightbloomBench") + extension)).string();
+	}
+}
+
+static void BM_SceneJsonRoundTrip(benchmark::State& state)
+{
+	const SceneFileData source = MakeSceneData(static_cast<size_t>(state.range(0)));
+
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		const std::string text = SceneToJson(source);
+		SceneFileData loaded;
+		std::string error;
+		if (!SceneFromJson(text, loaded, error))
+		{
+			state.SkipWithError(error.c_str());
+			break;
+		}
+		bytes = text.size();
+		benchmark::DoNotOptimize(loaded.objects.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_SceneJsonRoundTrip)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE)->Unit(benchmark::kMillisecond);
+
+static void BM_SceneBinaryEncode(benchmark::State& state)
+{
+	const SceneFileData source = MakeSceneData(static_cast<size_t>(state.range(0)));
+
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		const std::vector<uint8_t> encoded = EncodeSceneBinary(source);
+		bytes = encoded.size();
+		benchmark::DoNotOptimize(encoded.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_SceneBinaryEncode)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE)->Unit(benchmark::kMillisecond);
+
+// Through a temp file, as binary scenes are only decoded from disk. Includes
+// the write's rename and the OS file cache.
+static void BM_SceneBinaryRoundTrip(benchmark::State& state)
+{
+	const SceneFileData source = MakeSceneData(static_cast<size_t>(state.range(0)));
+	const std::string path = TempScenePath(".nbscene");
+
+	for (auto _ : state)
+	{
+		std::string error;
+		SceneFileData loaded;
+		if (!WriteSceneBinary(path, source, error) || !ReadSceneBinary(path, loaded, error))
+		{
+			state.SkipWithError(error.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(loaded.objects.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+}
+BENCHMARK(BM_SceneBinaryRoundTrip)->Arg(Bench::SCENE_SMALL)->Arg(Bench::SCENE_MEDIUM)->Arg(Bench::SCENE_LARGE)->Unit(benchmark::kMillisecond)->UseRealTime();
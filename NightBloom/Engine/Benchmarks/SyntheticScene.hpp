@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+// SyntheticScene.hpp
+//
+// Deterministic object layouts for the micro-benchmarks: `count` unit-ish
+// boxes scattered over a square sized so density stays constant as the count
+// grows, with a random yaw and scale each. Same count, same scene.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom::Bench
+{
+	// The scene sizes every scaling benchmark runs at
+	constexpr int64_t SCENE_SMALL = 1000;
+	constexpr int64_t SCENE_MEDIUM = 10000;
+	constexpr int64_t SCENE_LARGE = 100000;
+
+	struct SyntheticObject
+	{
+		glm::vec3 position;
+		float yaw;
+		float scale;
+		glm::mat4 transform;
+		glm::vec3 localMin;
+		glm::vec3 localMax;
+	};
+
+	// xorshift32 - cheap and the same on every platform, unlike <random>'s
+	// distributions
+	class BenchRandom
+	{
+	public:
+		explicit BenchRandom(uint32_t seed) : m_State(seed ? seed : 1u) {}
+
+		uint32_t Next()
+		{
+			m_State ^= m_State << 13;
+			m_State ^= m_State >> 17;
+			m_State ^= m_State << 5;
+			return m_State;
+		}
+
+		// [lo, hi)
+		float Range(float lo, float hi)
+		{
+			return lo + (hi - lo) * static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+		}
+
+	private:
+		uint32_t m_State;
+	};
+
+	inline std::vector<SyntheticObject> MakeSyntheticObjects(size_t count, uint32_t seed = 1234)
+	{
+		// ~1 object per 25 m^2
+		const float halfSize = 0.5f * std::sqrt(static_cast<float>(count) * 25.0f);
+
+		BenchRandom random(seed);
+		std::vector<SyntheticObject> objects(count);
+		for (SyntheticObject& object : objects)
+		{
+			object.position = glm::vec3(random.Range(-halfSize, halfSize), random.Range(0.0f, 10.0f), random.Range(-halfSize, halfSize));
+			object.yaw = random.Range(0.0f, 6.2831853f);
+			object.scale = random.Range(0.5f, 2.0f);
+			object.transform = glm::translate(glm::mat4(1.0f), object.position);
+			object.transform = glm::rotate(object.transform, object.yaw, glm::vec3(0.0f, 1.0f, 0.0f));
+			object.transform = glm::scale(object.transform, glm::vec3(object.scale));
+			object.localMin = glm::vec3(-0.5f, 0.0f, -0.5f);
+			object.localMax = glm::vec3(0.5f, 2.0f, 0.5f);
+		}
+		return objects;
+	}
+
+	// A 60-degree camera at the scene's edge looking across it, so roughly a
+	// third of the objects are inside the frustum
+	inline glm::mat4 MakeBenchViewProj(size_t count)
+	{
+		const float halfSize = 0.5f * std::sqrt(static_cast<float>(count) * 25.0f);
+		const glm::vec3 eye(0.0f, 20.0f, halfSize);
+		const glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 4.0f * halfSize);
+		return proj * view;
+	}
+}
@@ -8,24 +8,40 @@
 #include "Core/Application.hpp"
 #include "Core/Engine.hpp"
 #include "Core/Logger/Logger.hpp"
+#include "Core/CpuProfiler.hpp"
+#include "Core/PerformanceMetrics.hpp"
+#include "Core/StartupTimer.hpp"
+#include "Core/ThreadPlacement.hpp"
 #include <chrono>
 
 #include <iostream>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		WindowDesc DefaultWindowDesc(const std::string& name)
+		{
+			WindowDesc desc;
+			desc.title = name;
+			desc.width = 1280;
+			desc.height = 720;
+			desc.resizable = true;
+			return desc;
+		}
+	}
+
 	Application::Application(const std::string& name)
+		: Application(DefaultWindowDesc(name))
+	{
+	}
+
+	Application::Application(const WindowDesc& desc)
 	{
 		//Engine handles all system initialization
 		EngineInit();
 
 		//Create window
-		WindowDesc desc;
-		desc.title = name;
-		desc.width = 1280;
-		desc.height = 720;
-		desc.resizable = true;
-
 		m_Window = Window::Create(desc);
 
 		if (!m_Window)
@@ -38,6 +54,7 @@ namespace Nightbloom
 
 		// Connect them
 		m_Window->SetInputSystem(m_Input.get());
+		StartupTimer::Get().Mark("Window", StartupTimer::Now());
 
 		// Set up window callbacks
 		m_Window->SetCloseCallback([this]() {
@@ -68,6 +85,9 @@ namespace Nightbloom
 		}
 
 		if (m_Input) {
+			// Detach first: the window's raw-input thread pushes into it
+			if (m_Window)
+				m_Window->SetInputSystem(nullptr);
 			m_Input->Shutdown();
 			m_Input.reset();
 		}
@@ -84,7 +104,11 @@ namespace Nightbloom
 
 	void Application::Run()
 	{
+		NB_PROFILE_THREAD("Main");
+		// Simulation, recording and submit all run here
+		ThreadPlacement::Apply(ThreadRole::FrameCritical);
 		OnStartup();
+		StartupTimer::Get().Mark("Application startup", StartupTimer::Now());
 
 		using Clock = std::chrono::high_resolution_clock;
 		auto lastTime = Clock::now();
@@ -93,49 +117,191 @@ namespace Nightbloom
 		{
 			auto currentTime = Clock::now();
 			float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
-			
-			m_Input->BeginFrame();
-			m_Window->PollEvents();
-			m_Input->EndFrame();
+			if (m_FixedTimestep > 0.0f)
+				deltaTime = m_FixedTimestep;
 
-			if (m_Window->GetWidth() == 0 || m_Window->GetHeight() == 0)
-			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			if (!RunFrame(deltaTime))
 				continue;
+
+			if (StartupTimer::Get().Finish(StartupTimer::Now()))
+				LOG_INFO("{}", StartupTimer::Get().FormatReport());
+
+			lastTime = currentTime;
+			OnFrameEnd();
+			RunMainThreadTasks(currentTime);
+			PaceFrame();
+		}
+
+		OnShutdown();
+	}
+
+	bool Application::RunFrame(float deltaTime)
+	{
+		NB_PROFILE_SCOPE("Frame");
+		// Low-latency mode blocks/sleeps here so input is sampled as late as possible
+		m_Renderer->WaitForLowLatencyStart();
+
+		m_Input->BeginFrame();
+		m_Window->PollEvents();
+		m_Input->EndFrame();
+		m_FrameInputTime = m_Input->GetFrameInputTime();
+
+		if (m_Window->GetWidth() == 0 || m_Window->GetHeight() == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			return false;
+		}
+
+		// Skipped: poll again shortly, so input still wakes it within a few ms
+		if (!ShouldRunFrame())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(4));
+			return false;
+		}
+
+		// Use input
+		if (m_Input->IsPressed(InputCode::Key_P))
+			m_Renderer->TogglePipeline();
+
+		if (m_Input->IsPressed(InputCode::Key_R))
+		{
+			m_Renderer->ReloadShaders();
+		}
+
+		if (m_FramePipelining)
+		{
+			RunPipelinedFrame(deltaTime);
+		}
+		else
+		{
+			{
+				NB_PROFILE_SCOPE("Update");
+				OnUpdate(deltaTime);
 			}
+			RenderFrame(nullptr);
+		}
 
-			// Use input
-			if (m_Input->IsPressed(InputCode::Key_P))
-				m_Renderer->TogglePipeline();
+		return true;
+	}
+
+	void Application::PaceFrame()
+	{
+		// The window may have moved to another display
+		const auto now = std::chrono::steady_clock::now();
+		if (m_FramePacer.GetSettings().refreshDivisor != 0 && now - m_RefreshRateQueried > std::chrono::seconds(1))
+		{
+			m_FramePacer.SetRefreshRate(m_Window->GetRefreshRate());
+			m_RefreshRateQueried = now;
+		}
+
+		if (m_FramePacer.IsEnabled())
+		{
+			NB_PROFILE_SCOPE("Frame Pacing");
+			m_FramePacer.Wait();
+		}
+
+		PerformanceMetrics::Get().SetFramePacing(static_cast<float>(m_FramePacer.GetTargetInterval() * 1000.0),
+			m_FramePacer.GetJitterMs(), m_FramePacer.GetWaitMs());
+	}
+
+	void Application::RunMainThreadTasks(std::chrono::high_resolution_clock::time_point frameStart)
+	{
+		if (!m_Renderer)
+			return;
 
-			if (m_Input->IsPressed(InputCode::Key_R))
+		MainThreadTaskQueue& tasks = m_Renderer->GetMainThreadTasks();
+		if (tasks.GetPendingCount() == 0)
+			return;
+
+		// Whatever the frame is held to: the limiter, else vsync's refresh
+		// (asked for once a second, like PaceFrame does)
+		float intervalMs = static_cast<float>(m_FramePacer.GetTargetInterval() * 1000.0);
+		if (intervalMs <= 0.0f)
+		{
+			const auto now = std::chrono::steady_clock::now();
+			if (now - m_TaskRefreshQueried > std::chrono::seconds(1))
 			{
-				m_Renderer->ReloadShaders();
+				m_TaskRefreshRate = m_Window->GetRefreshRate();
+				m_TaskRefreshQueried = now;
 			}
+			if (m_TaskRefreshRate > 0.0f)
+				intervalMs = 1000.0f / m_TaskRefreshRate;
+		}
+
+		const float elapsedMs = std::chrono::duration<float, std::milli>(
+			std::chrono::high_resolution_clock::now() - frameStart).count();
+
+		NB_PROFILE_SCOPE("Main Thread Tasks");
+		tasks.Run(MainThreadTaskQueue::ComputeBudgetMs(intervalMs, elapsedMs, m_TaskBudget));
+	}
 
-			OnUpdate(deltaTime);
-			
-			// RENDER WITH THE NEW RENDERER
-			if (m_Renderer && m_Renderer->IsInitialized())
+	void Application::SetFixedTimestep(float seconds)
+	{
+		m_FixedTimestep = seconds;
+		if (m_Renderer)
+			m_Renderer->SetFixedTimestep(seconds);
+	}
+
+	void Application::RunPipelinedFrame(float deltaTime)
+	{
+		// Simulate the next frame while this one is recorded and submitted
+		// from the snapshot the last job published (none on the first
+		// pipelined frame)
+		const auto inputTime = m_FrameInputTime;
+		const RenderSnapshot* snapshot = m_FramePipeline.Begin(
+			[this, deltaTime, inputTime](RenderSnapshot& next, uint64_t frameNumber)
 			{
-				m_Renderer->BeginFrame();
+				NB_PROFILE_SCOPE("Simulate");
+				OnUpdate(deltaTime);
+
+				next.Reset();
+				next.deltaTime = deltaTime;
+				next.frameNumber = frameNumber;
+				next.inputTime = inputTime;
+				OnBuildRenderSnapshot(next);
+			});
+
+		if (snapshot)
+			RenderFrame(snapshot);
+
+		// OnFrameEnd and the main-thread tasks run next, and may touch what
+		// OnUpdate does
+		NB_PROFILE_SCOPE("Wait Simulation");
+		m_FramePipeline.Wait();
+	}
+
+	void Application::RenderFrame(const RenderSnapshot* snapshot)
+	{
+		if (!m_Renderer || !m_Renderer->IsInitialized())
+			return;
+
+		NB_PROFILE_SCOPE("Render Frame");
+		m_Renderer->BeginFrame();
+
+		if (m_Renderer->IsFrameValid())
+		{
+			// Input the frame's state was simulated from (a frame older when pipelined)
+			m_Renderer->SetFrameInputTime(snapshot ? snapshot->inputTime : m_FrameInputTime);
+
+			m_Renderer->Clear(0.1f, 0.1f, 0.2f, 1.0f);  // Dark blue background
 
-				if (m_Renderer->IsFrameValid())
+			if (snapshot)
+			{
+				m_Renderer->SetViewMatrix(snapshot->view);
+				m_Renderer->SetProjectionMatrix(snapshot->projection);
+				m_Renderer->SetCameraPosition(snapshot->cameraPosition);
+				if (snapshot->hasLighting)
 				{
-					m_Renderer->Clear(0.1f, 0.1f, 0.2f, 1.0f);  // Dark blue background
-					OnRender();  // Your app can override this
-					m_Renderer->FinalizeFrame();
-					m_Renderer->EndFrame();
+					m_Renderer->SetLightingData(snapshot->lighting);
+					if (!snapshot->pointLights.empty())
+						m_Renderer->SetPointLights(snapshot->pointLights);
 				}
+				m_Renderer->SubmitDrawList(snapshot->drawList);
 			}
-			
-			//m_Window->SwapBuffers();
-			lastTime = currentTime;
 
-			// Sleep to limit frame rate to ~40 FPS for now
-			//std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			OnRender();  // Your app can override this
+			m_Renderer->FinalizeFrame();
+			m_Renderer->EndFrame();
 		}
-
-		OnShutdown();
 	}
 }
\ No newline at end of file
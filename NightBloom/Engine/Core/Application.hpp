@@ -12,7 +12,12 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/PipelineInterface.hpp"  // ADD THIS for PipelineType enum
 #include "Engine/Renderer/DrawCommandSystem.hpp" // For DrawCommand and related types
+#include "Engine/Renderer/RenderSnapshot.hpp"
 #include "Engine/Core/Scene.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/FramePipeline.hpp"
+#include "Engine/Core/FramePacer.hpp"
+#include "Engine/Core/MainThreadTaskQueue.hpp"
 
 #include <glm/glm.hpp> // ToDo: remove this if reg mathclass is better
 
@@ -23,6 +28,7 @@ namespace Nightbloom
 	public:
 		// ToDo: probably need to replace with an application desc later. once i implement xml
 		Application(const std::string& name = "NightBloom Application");
+		explicit Application(const WindowDesc& windowDesc);
 		virtual ~Application();
 
 		//Called by main()
@@ -34,6 +40,49 @@ namespace Nightbloom
 		virtual void OnUpdate(float deltaTime) { (void)(deltaTime); }
 		virtual void OnRender() {}
 		virtual void OnShutdown() {}
+		// After each frame, outside every profiler scope of the main thread
+		virtual void OnFrameEnd() {}
+		// Each loop iteration, after input is polled: false skips this
+		// iteration's OnUpdate and render, and the next frame's deltaTime
+		// covers the gap. Tools use it to stop redrawing a scene that isn't
+		// changing (see IdleThrottle).
+		virtual bool ShouldRunFrame() { return true; }
+
+		// Frame pipelining (off by default). When on, OnUpdate and then
+		// OnBuildRenderSnapshot run for frame N+1 on a job while the main
+		// thread records and submits frame N from the snapshot built the
+		// frame before: the Application applies its camera, lighting and
+		// draw list, then calls OnRender for main-thread-only extras (UI).
+		// Anything OnRender appends to GetFrameDrawList() needs a re-Sort.
+		// OnUpdate and OnBuildRenderSnapshot must then stay off the Renderer
+		// and off anything OnRender touches; both see input as polled at the
+		// start of the frame. The job is done before OnFrameEnd. Costs one
+		// frame of latency (FramePipeline.hpp).
+		void SetFramePipelining(bool enabled) { m_FramePipelining = enabled; }
+		bool IsFramePipeliningEnabled() const { return m_FramePipelining; }
+
+		// Pipelined mode only: capture what the render side needs. The
+		// snapshot arrives Reset() with deltaTime and frameNumber filled in.
+		virtual void OnBuildRenderSnapshot(RenderSnapshot& snapshot) { (void)(snapshot); }
+
+		// Fixed timestep (off at 0): OnUpdate and the Renderer's clock advance
+		// by exactly this many seconds a frame, whatever the wall time, so a
+		// scripted run replays the same frames (NightbloomBench)
+		void SetFixedTimestep(float seconds);
+		float GetFixedTimestep() const { return m_FixedTimestep; }
+
+		// Frame limiter (off by default): after each frame Run sleeps until
+		// the next frame is due, at a fixed rate or a fraction of the display
+		// refresh (FramePacer). Pacing jitter lands in PerformanceMetrics.
+		void SetFrameLimit(const FramePacer::Settings& settings) { m_FramePacer.SetSettings(settings); }
+		const FramePacer::Settings& GetFrameLimit() const { return m_FramePacer.GetSettings(); }
+		const FramePacer& GetFramePacer() const { return m_FramePacer; }
+
+		// After OnFrameEnd, the Renderer's main-thread tasks run within what
+		// is left of the frame: the pacer's target interval, or the display
+		// refresh without one, less the time the frame took (MainThreadTaskQueue)
+		void SetMainThreadTaskBudget(const MainThreadTaskQueue::BudgetSettings& settings) { m_TaskBudget = settings; }
+		const MainThreadTaskQueue::BudgetSettings& GetMainThreadTaskBudget() const { return m_TaskBudget; }
 
 		//saving for later when i add in an event system
 		virtual void OnEvent(/* Event& e */) {}
@@ -65,6 +114,13 @@ namespace Nightbloom
 
 		PipelineType m_CurrentTestPipeline = PipelineType::Mesh;
 	private:
+		// false when skipped (minimized window)
+		bool RunFrame(float deltaTime);
+		void PaceFrame();
+		void RunMainThreadTasks(std::chrono::high_resolution_clock::time_point frameStart);
+		void RunPipelinedFrame(float deltaTime);
+		void RenderFrame(const RenderSnapshot* snapshot);
+
 		// Engine Components
 		std::unique_ptr<Window> m_Window;
 		std::unique_ptr<Renderer> m_Renderer;
@@ -72,6 +128,19 @@ namespace Nightbloom
 
 		bool m_Running = true;
 		float m_LastFrameTime = 0.0f;
+		float m_FixedTimestep = 0.0f;
+
+		FramePacer m_FramePacer;
+		std::chrono::steady_clock::time_point m_RefreshRateQueried{};
+		MainThreadTaskQueue::BudgetSettings m_TaskBudget;
+		float m_TaskRefreshRate = 0.0f;
+		std::chrono::steady_clock::time_point m_TaskRefreshQueried{};
+
+		// Frame pipelining: the simulation job writes one snapshot while the
+		// main thread renders from another
+		bool m_FramePipelining = false;
+		FramePipeline<RenderSnapshot> m_FramePipeline;
+		std::chrono::steady_clock::time_point m_FrameInputTime{};  // sampled this loop iteration
 	};
 
 	//To be defined by the client
@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+// AssetArchive.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/AssetArchive.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		struct ArchiveHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t entryCount;
+			uint32_t tocSize;
+			uint64_t dataOffset;
+			uint64_t fileSize;   // written last: a truncated archive reads as corrupt
+		};
+		static_assert(sizeof(ArchiveHeader) == 32);
+
+		struct TocRecord
+		{
+			uint64_t offset;
+			uint64_t size;
+			uint64_t storedSize;
+			uint32_t compression;
+			uint32_t pathLength;
+		};
+		static_assert(sizeof(TocRecord) == 32);
+
+		// Longest entry path accepted when reading
+		constexpr uint32_t MAX_PATH_LENGTH = 4096;
+
+		uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	bool AssetFile::Open(const std::string& path)
+	{
+		Close();
+		auto mapping = std::make_shared<MappedFile>();
+		if (!mapping->Open(path))
+			return false;
+
+		m_Data = mapping->GetData();
+		m_Size = mapping->GetSize();
+		m_Mapping = std::move(mapping);
+		return true;
+	}
+
+	void AssetFile::Close()
+	{
+		m_Mapping.reset();
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+
+	bool AssetArchive::Open(const std::string& path, std::string& error)
+	{
+		Close();
+
+		auto mapping = std::make_shared<MappedFile>();
+		if (!mapping->Open(path))
+		{
+			error = "can't map the file";
+			return false;
+		}
+
+		const uint8_t* data = mapping->GetData();
+		const size_t fileSize = mapping->GetSize();
+
+		ArchiveHeader header;
+		if (fileSize < sizeof(header))
+		{
+			error = "file too small";
+			return false;
+		}
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+		{
+			error = "not an asset archive";
+			return false;
+		}
+		if (header.version != VERSION)
+		{
+			error = "unsupported version " + std::to_string(header.version);
+			return false;
+		}
+		if (header.fileSize != fileSize || sizeof(header) + uint64_t(header.tocSize) > fileSize)
+		{
+			error = "truncated";
+			return false;
+		}
+
+		std::unordered_map<std::string, Entry> entries;
+		entries.reserve(header.entryCount);
+		size_t cursor = sizeof(header);
+		const size_t tocEnd = sizeof(header) + header.tocSize;
+		for (uint32_t i = 0; i < header.entryCount; ++i)
+		{
+			TocRecord record;
+			if (cursor + sizeof(record) > tocEnd)
+			{
+				error = "table of contents cut short";
+				return false;
+			}
+			std::memcpy(&record, data + cursor, sizeof(record));
+			cursor += sizeof(record);
+
+			if (record.pathLength == 0 || record.pathLength > MAX_PATH_LENGTH || cursor + record.pathLength > tocEnd)
+			{
+				error = "bad entry path";
+				return false;
+			}
+			std::string entryPath(reinterpret_cast<const char*>(data + cursor), record.pathLength);
+			cursor = static_cast<size_t>(AlignUp(cursor + record.pathLength, 8));
+
+			if (record.offset > fileSize || record.storedSize > fileSize - record.offset)
+			{
+				error = "entry '" + entryPath + "' lies outside the file";
+				return false;
+			}
+
+			Entry entry;
+			entry.offset = record.offset;
+			entry.size = record.size;
+			entry.storedSize = record.storedSize;
+			entry.compression = static_cast<AssetCompression>(record.compression);
+			entries.emplace(std::move(entryPath), entry);
+		}
+
+		m_Path = path;
+		m_Mapping = std::move(mapping);
+		m_Entries = std::move(entries);
+		return true;
+	}
+
+	void AssetArchive::Close()
+	{
+		m_Path.clear();
+		m_Mapping.reset();
+		m_Entries.clear();
+	}
+
+	AssetFile AssetArchive::Find(const std::string& entryPath) const
+	{
+		AssetFile file;
+		auto it = m_Entries.find(entryPath);
+		if (it == m_Entries.end())
+			return file;
+
+		// Only stored entries can be viewed in place
+		const Entry& entry = it->second;
+		if (entry.compression != AssetCompression::None || entry.size != entry.storedSize || entry.size == 0)
+			return file;
+
+		file.m_Mapping = m_Mapping;
+		file.m_Data = m_Mapping->GetData() + entry.offset;
+		file.m_Size = static_cast<size_t>(entry.size);
+		return file;
+	}
+
+	std::vector<std::string> AssetArchive::GetEntryPaths() const
+	{
+		std::vector<std::string> paths;
+		paths.reserve(m_Entries.size());
+		for (const auto& [path, entry] : m_Entries)
+			paths.push_back(path);
+		std::sort(paths.begin(), paths.end());
+		return paths;
+	}
+
+	void AssetArchiveWriter::Add(const std::string& entryPath, std::vector<uint8_t> data)
+	{
+		m_Entries[entryPath] = std::move(data);
+	}
+
+	bool AssetArchiveWriter::AddFile(const std::string& entryPath, const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+
+		std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file)
+			return false;
+
+		Add(entryPath, std::move(data));
+		return true;
+	}
+
+	bool AssetArchiveWriter::Write(const std::string& path, std::string& error) const
+	{
+		std::vector<std::string> paths;
+		for (const auto& [entryPath, data] : m_Entries)
+			paths.push_back(entryPath);
+		std::sort(paths.begin(), paths.end());
+
+		uint64_t tocSize = 0;
+		for (const std::string& entryPath : paths)
+			tocSize += AlignUp(sizeof(TocRecord) + entryPath.size(), 8);
+
+		ArchiveHeader header{};
+		std::memcpy(header.magic, AssetArchive::MAGIC, sizeof(header.magic));
+		header.version = AssetArchive::VERSION;
+		header.entryCount = static_cast<uint32_t>(paths.size());
+		header.tocSize = static_cast<uint32_t>(tocSize);
+		header.dataOffset = AlignUp(sizeof(header) + tocSize, AssetArchive::ENTRY_ALIGNMENT);
+
+		// Lay the entries out, then emit header, TOC and data in file order
+		std::vector<uint8_t> bytes(static_cast<size_t>(header.dataOffset));
+		size_t cursor = sizeof(header);
+		for (const std::string& entryPath : paths)
+		{
+			const std::vector<uint8_t>& data = m_Entries.at(entryPath);
+			const uint64_t offset = AlignUp(bytes.size(), AssetArchive::ENTRY_ALIGNMENT);
+			bytes.resize(static_cast<size_t>(offset));
+			bytes.insert(bytes.end(), data.begin(), data.end());
+
+			TocRecord record{};
+			record.offset = offset;
+			record.size = data.size();
+			record.storedSize = data.size();
+			record.compression = static_cast<uint32_t>(AssetCompression::None);
+			record.pathLength = static_cast<uint32_t>(entryPath.size());
+			std::memcpy(bytes.data() + cursor, &record, sizeof(record));
+			std::memcpy(bytes.data() + cursor + sizeof(record), entryPath.data(), entryPath.size());
+			cursor = static_cast<size_t>(AlignUp(cursor + sizeof(record) + entryPath.size(), 8));
+		}
+
+		header.fileSize = bytes.size();
+		std::memcpy(bytes.data(), &header, sizeof(header));
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				error = "can't create " + tempPath;
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				error = "write failed";
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			error = "can't replace " + path + ": " + ec.message();
+			return false;
+		}
+		return true;
+	}
+}
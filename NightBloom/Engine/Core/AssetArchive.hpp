@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+// AssetArchive.hpp
+//
+// Packed asset archive: many assets in one file, so a cold start opens and
+// maps a single file instead of probing and opening hundreds of loose ones.
+// The AssetPacker tool writes it; AssetManager mounts it at startup.
+//
+// Layout (little endian):
+//   Header     magic "NBPK", version, entry count, TOC size, data offset,
+//              file size (a truncated archive fails to mount)
+//   TOC        one record per entry, sorted by path:
+//                offset, size, stored size (u64), compression, path length
+//                (u32), path bytes, zero padding to 8 bytes
+//   Data       entries back to back, each starting on an ENTRY_ALIGNMENT
+//              boundary
+//
+// Entry paths are relative to the project root with '/' separators
+// ("Assets/Textures/grass.png", "Shaders/mesh.frag.spv"). The header and TOC
+// come first, so mounting reads one contiguous block. Entries are stored
+// uncompressed and handed out as views of the mapping (AssetFile), with no
+// copy; the per-entry compression field is there for codecs to be added,
+// and entries using one this build doesn't know fail to load.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Core/MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	// One asset's bytes: a loose file mapped on its own, or a view of its
+	// entry in an archive (the view keeps the archive mapped)
+	class AssetFile
+	{
+	public:
+		AssetFile() = default;
+
+		// Maps a loose file; false when it is missing or empty
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+		std::span<const uint8_t> GetSpan() const { return { m_Data, m_Size }; }
+
+	private:
+		friend class AssetArchive;
+
+		std::shared_ptr<const MappedFile> m_Mapping;
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+	};
+
+	enum class AssetCompression : uint32_t
+	{
+		None = 0
+	};
+
+	class AssetArchive
+	{
+	public:
+		static constexpr char MAGIC[4] = { 'N', 'B', 'P', 'K' };
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint64_t ENTRY_ALIGNMENT = 16;   // SPIR-V needs 4, staging copies like 16
+
+		struct Entry
+		{
+			uint64_t offset = 0;
+			uint64_t size = 0;
+			uint64_t storedSize = 0;
+			AssetCompression compression = AssetCompression::None;
+		};
+
+		// Maps the archive and reads its TOC; false with `error` set when it
+		// is missing or malformed
+		bool Open(const std::string& path, std::string& error);
+		void Close();
+
+		bool IsOpen() const { return m_Mapping != nullptr; }
+		const std::string& GetPath() const { return m_Path; }
+
+		bool Contains(const std::string& entryPath) const { return m_Entries.count(entryPath) != 0; }
+
+		// Not open when the archive has no such entry
+		AssetFile Find(const std::string& entryPath) const;
+
+		size_t GetEntryCount() const { return m_Entries.size(); }
+		std::vector<std::string> GetEntryPaths() const;
+
+	private:
+		std::string m_Path;
+		std::shared_ptr<const MappedFile> m_Mapping;
+		std::unordered_map<std::string, Entry> m_Entries;
+	};
+
+	// Builds an archive in memory and writes it in one go
+	class AssetArchiveWriter
+	{
+	public:
+		void Add(const std::string& entryPath, std::vector<uint8_t> data);
+
+		// Reads a loose file into the archive; false when it can't be read
+		bool AddFile(const std::string& entryPath, const std::string& filePath);
+
+		size_t GetEntryCount() const { return m_Entries.size(); }
+
+		// Writes to a temporary file renamed over `path`, so a reader never
+		// sees a half-written archive
+		bool Write(const std::string& path, std::string& error) const;
+
+	private:
+		std::unordered_map<std::string, std::vector<uint8_t>> m_Entries;
+	};
+}
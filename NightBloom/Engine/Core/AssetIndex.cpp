@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+// AssetIndex.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/AssetIndex.hpp"
+#include "Core/Logger/Logger.hpp"
+#include "Core/ThreadPlacement.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Nightbloom
+{
+	namespace
+	{
+		struct KindExtension
+		{
+			const char* extension;
+			AssetKind kind;
+		};
+
+		const KindExtension kExtensions[] = {
+			{ ".vert", AssetKind::Shader }, { ".frag", AssetKind::Shader }, { ".comp", AssetKind::Shader },
+			{ ".geom", AssetKind::Shader }, { ".tesc", AssetKind::Shader }, { ".tese", AssetKind::Shader },
+			{ ".task", AssetKind::Shader }, { ".mesh", AssetKind::Shader }, { ".glsl", AssetKind::Shader },
+			{ ".spv", AssetKind::Shader },
+			{ ".png", AssetKind::Texture }, { ".jpg", AssetKind::Texture }, { ".jpeg", AssetKind::Texture },
+			{ ".tga", AssetKind::Texture }, { ".bmp", AssetKind::Texture }, { ".hdr", AssetKind::Texture },
+			{ ".psd", AssetKind::Texture }, { ".gif", AssetKind::Texture }, { ".ktx2", AssetKind::Texture },
+			{ ".gltf", AssetKind::Model }, { ".glb", AssetKind::Model }, { ".obj", AssetKind::Model },
+			{ ".fbx", AssetKind::Model },
+		};
+
+		std::string ToLower(std::string text)
+		{
+			std::transform(text.begin(), text.end(), text.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return text;
+		}
+
+		void HashBytesInto(uint64_t& hash, const void* data, size_t size)
+		{
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash ^= bytes[i];
+				hash *= 0x100000001b3ull;
+			}
+		}
+
+		// Lists `directory` into folder `folderIndex` and recurses into its
+		// subfolders. Unreadable entries are skipped, not fatal.
+		void ScanFolder(const fs::path& directory, uint32_t folderIndex, AssetIndexSnapshot& snapshot)
+		{
+			std::vector<fs::path> subfolders;
+			std::vector<AssetEntry> files;
+
+			std::error_code ec;
+			fs::directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+			for (; !ec && it != fs::directory_iterator(); it.increment(ec))
+			{
+				const fs::directory_entry& item = *it;
+				std::error_code statusEc;
+				if (item.is_directory(statusEc))
+				{
+					subfolders.push_back(item.path());
+					continue;
+				}
+				if (!item.is_regular_file(statusEc))
+					continue;
+
+				AssetEntry entry;
+				entry.path = item.path().string();
+				entry.name = item.path().filename().string();
+				entry.lowerName = ToLower(entry.name);
+				entry.folder = folderIndex;
+				entry.kind = GetAssetKind(entry.name);
+				entry.size = item.file_size(statusEc);
+				entry.modified = static_cast<int64_t>(item.last_write_time(statusEc).time_since_epoch().count());
+				files.push_back(std::move(entry));
+			}
+
+			std::sort(files.begin(), files.end(),
+				[](const AssetEntry& a, const AssetEntry& b) { return a.lowerName < b.lowerName; });
+			for (AssetEntry& entry : files)
+			{
+				snapshot.folders[folderIndex].entries.push_back(static_cast<uint32_t>(snapshot.entries.size()));
+				snapshot.entries.push_back(std::move(entry));
+			}
+
+			std::sort(subfolders.begin(), subfolders.end(),
+				[](const fs::path& a, const fs::path& b) { return ToLower(a.filename().string()) < ToLower(b.filename().string()); });
+			for (const fs::path& subfolder : subfolders)
+			{
+				const uint32_t childIndex = static_cast<uint32_t>(snapshot.folders.size());
+				AssetFolder child;
+				child.path = subfolder.string();
+				child.name = subfolder.filename().string();
+				child.parent = folderIndex;
+				snapshot.folders.push_back(std::move(child));
+				snapshot.folders[folderIndex].folders.push_back(childIndex);
+				ScanFolder(subfolder, childIndex, snapshot);
+			}
+		}
+	}
+
+	const char* GetAssetKindName(AssetKind kind)
+	{
+		switch (kind)
+		{
+		case AssetKind::Shader:  return "Shader";
+		case AssetKind::Texture: return "Texture";
+		case AssetKind::Model:   return "Model";
+		default:                 return "File";
+		}
+	}
+
+	AssetKind GetAssetKind(const std::string& path)
+	{
+		const std::string extension = ToLower(fs::path(path).extension().string());
+		for (const KindExtension& known : kExtensions)
+		{
+			if (extension == known.extension)
+				return known.kind;
+		}
+		return AssetKind::Other;
+	}
+
+	uint32_t AssetIndexSnapshot::FindFolder(const std::string& path) const
+	{
+		for (uint32_t i = 0; i < folders.size(); ++i)
+		{
+			if (folders[i].path == path)
+				return i;
+		}
+		return AssetFolder::NO_PARENT;
+	}
+
+	AssetIndex::~AssetIndex()
+	{
+		Stop();
+	}
+
+	void AssetIndex::Start(std::vector<Root> roots, std::chrono::milliseconds interval)
+	{
+		if (IsRunning())
+			return;
+
+		m_Roots = std::move(roots);
+		m_Interval = interval;
+		m_Quit = false;
+		m_RescanRequested = true;
+		m_Thread = std::thread([this]() { ThreadLoop(); });
+	}
+
+	void AssetIndex::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Quit = true;
+		}
+		m_Wake.notify_all();
+		m_Thread.join();
+	}
+
+	void AssetIndex::RequestRescan()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_RescanRequested = true;
+		}
+		m_Wake.notify_all();
+	}
+
+	std::shared_ptr<const AssetIndexSnapshot> AssetIndex::GetSnapshot() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Snapshot;
+	}
+
+	AssetIndexSnapshot AssetIndex::Scan(const std::vector<Root>& roots)
+	{
+		AssetIndexSnapshot snapshot;
+		std::vector<std::string> scanned;
+
+		for (const Root& root : roots)
+		{
+			std::error_code ec;
+			if (root.path.empty() || !fs::is_directory(root.path, ec))
+				continue;
+
+			const std::string canonical = fs::weakly_canonical(root.path, ec).string();
+			if (std::find(scanned.begin(), scanned.end(), canonical) != scanned.end())
+				continue;
+			scanned.push_back(canonical);
+
+			const uint32_t folderIndex = static_cast<uint32_t>(snapshot.folders.size());
+			AssetFolder folder;
+			folder.path = root.path;
+			folder.name = root.name.empty() ? fs::path(root.path).filename().string() : root.name;
+			snapshot.folders.push_back(std::move(folder));
+			snapshot.roots.push_back(folderIndex);
+			ScanFolder(root.path, folderIndex, snapshot);
+		}
+
+		uint64_t signature = 0xcbf29ce484222325ull;
+		for (const AssetEntry& entry : snapshot.entries)
+		{
+			HashBytesInto(signature, entry.path.data(), entry.path.size());
+			HashBytesInto(signature, &entry.size, sizeof(entry.size));
+			HashBytesInto(signature, &entry.modified, sizeof(entry.modified));
+		}
+		// Empty folders count too
+		for (const AssetFolder& folder : snapshot.folders)
+			HashBytesInto(signature, folder.path.data(), folder.path.size());
+		snapshot.signature = signature;
+
+		return snapshot;
+	}
+
+	void AssetIndex::ThreadLoop()
+	{
+		ThreadPlacement::Apply(ThreadRole::Background);
+
+		// A restart carries on from the snapshot it left
+		uint64_t version = 0;
+		uint64_t lastSignature = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Snapshot)
+			{
+				version = m_Snapshot->version;
+				lastSignature = m_Snapshot->signature;
+			}
+		}
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait_for(lock, m_Interval, [this]() { return m_Quit || m_RescanRequested; });
+				if (m_Quit)
+					return;
+				m_RescanRequested = false;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			auto snapshot = std::make_shared<AssetIndexSnapshot>(Scan(m_Roots));
+			if (version > 0 && snapshot->signature == lastSignature)
+				continue;
+
+			lastSignature = snapshot->signature;
+			snapshot->version = ++version;
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - start).count();
+			LOG_DEBUG("Asset index v{}: {} files in {} folders ({} ms)",
+				snapshot->version, snapshot->entries.size(), snapshot->folders.size(), elapsed);
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Snapshot = std::move(snapshot);
+		}
+	}
+}
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+// AssetIndex.hpp
+//
+// Background index of the asset directories (the AssetManager's shader,
+// texture and model roots) for the editor's asset browser. A thread of its
+// own walks the roots and publishes the result as an immutable snapshot:
+// readers take a shared_ptr to the latest one and never wait on a scan.
+//
+// std::filesystem has no change notification, so the watcher polls: the
+// roots are rescanned every `interval`, and a new snapshot (with the next
+// version) is published only when some file was added, removed, resized or
+// touched. RequestRescan() cuts the wait short.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class AssetKind : uint8_t
+	{
+		Shader,
+		Texture,
+		Model,
+		Other
+	};
+
+	const char* GetAssetKindName(AssetKind kind);
+
+	// By extension, case-insensitive
+	AssetKind GetAssetKind(const std::string& path);
+
+	struct AssetEntry
+	{
+		std::string path;       // Full path, as the AssetManager resolves it
+		std::string name;       // File name
+		std::string lowerName;  // For search
+		uint32_t folder = 0;
+		AssetKind kind = AssetKind::Other;
+		uint64_t size = 0;
+		int64_t modified = 0;   // file_time_type ticks; only compared
+	};
+
+	struct AssetFolder
+	{
+		static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+		std::string path;
+		std::string name;
+		uint32_t parent = NO_PARENT;
+		std::vector<uint32_t> folders;  // Children, by name
+		std::vector<uint32_t> entries;  // Files, by name
+	};
+
+	struct AssetIndexSnapshot
+	{
+		uint64_t version = 0;
+		// One per root that exists, in root order, then their subfolders
+		std::vector<uint32_t> roots;
+		std::vector<AssetFolder> folders;
+		std::vector<AssetEntry> entries;
+		// Over every entry's path, size and time; equal means nothing changed
+		uint64_t signature = 0;
+
+		// NO_PARENT when no folder has that path
+		uint32_t FindFolder(const std::string& path) const;
+	};
+
+	class AssetIndex
+	{
+	public:
+		struct Root
+		{
+			std::string name;  // Shown instead of the directory's own name
+			std::string path;
+		};
+
+		AssetIndex() = default;
+		~AssetIndex();
+
+		AssetIndex(const AssetIndex&) = delete;
+		AssetIndex& operator=(const AssetIndex&) = delete;
+
+		// Starts the scanning thread; the first snapshot follows shortly.
+		// No-op while running.
+		void Start(std::vector<Root> roots, std::chrono::milliseconds interval = std::chrono::milliseconds(2000));
+		void Stop();
+
+		bool IsRunning() const { return m_Thread.joinable(); }
+
+		void RequestRescan();
+
+		// Null until the first scan finishes
+		std::shared_ptr<const AssetIndexSnapshot> GetSnapshot() const;
+
+		// The walk itself, on the calling thread. Roots that don't exist
+		// are left out; one listed twice is indexed once. Version is zero.
+		static AssetIndexSnapshot Scan(const std::vector<Root>& roots);
+
+	private:
+		void ThreadLoop();
+
+		std::vector<Root> m_Roots;
+		std::chrono::milliseconds m_Interval{ 2000 };
+		std::thread m_Thread;
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Wake;
+		bool m_Quit = false;
+		bool m_RescanRequested = false;
+		std::shared_ptr<const AssetIndexSnapshot> m_Snapshot;
+	};
+}
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+// AssetLoadQueue.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/AssetLoadQueue.hpp"
+#include "Core/Logger/Logger.hpp"
+#include "Core/CpuProfiler.hpp"
+#include "Core/ThreadPlacement.hpp"
+
+namespace Nightbloom
+{
+	AssetState AssetHandle::GetState() const
+	{
+		return m_State ? m_State->state.load(std::memory_order_acquire) : AssetState::Failed;
+	}
+
+	std::shared_future<AssetState> AssetHandle::GetFuture() const
+	{
+		return m_State ? m_State->future : std::shared_future<AssetState>();
+	}
+
+	void AssetHandle::Cancel() const
+	{
+		if (m_State)
+			Resolve(*m_State, AssetState::Cancelled);
+	}
+
+	bool AssetHandle::Resolve(State& state, AssetState result)
+	{
+		AssetState expected = AssetState::Loading;
+		if (!state.state.compare_exchange_strong(expected, result, std::memory_order_acq_rel))
+			return false;
+		state.promise.set_value(result);
+		return true;
+	}
+
+	AssetLoadQueue::~AssetLoadQueue()
+	{
+		Stop();
+	}
+
+	void AssetLoadQueue::Start(uint32_t threadCount)
+	{
+		if (IsRunning() || threadCount == 0)
+			return;
+
+		m_Quit = false;
+		for (uint32_t i = 0; i < threadCount; ++i)
+			m_Threads.emplace_back([this]() { ThreadLoop(); });
+
+		LOG_INFO("AssetLoadQueue started ({} threads)", threadCount);
+	}
+
+	void AssetLoadQueue::Stop()
+	{
+		if (IsRunning())
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_QueueMutex);
+				m_Quit = true;
+			}
+			m_QueueCv.notify_all();
+
+			for (std::thread& thread : m_Threads)
+			{
+				if (thread.joinable())
+					thread.join();
+			}
+			m_Threads.clear();
+		}
+
+		std::deque<Load> dropped;
+		{
+			std::lock_guard<std::mutex> lock(m_QueueMutex);
+			dropped.swap(m_Queued);
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_CompletedMutex);
+			for (Load& load : m_Completed)
+				dropped.push_back(std::move(load));
+			m_Completed.clear();
+		}
+
+		for (Load& load : dropped)
+			AssetHandle::Resolve(*load.state, AssetState::Cancelled);
+		m_PendingCount.fetch_sub(dropped.size(), std::memory_order_acq_rel);
+	}
+
+	AssetHandle AssetLoadQueue::Submit(PrepareFn prepare, FinishFn finish)
+	{
+		auto state = std::make_shared<AssetHandle::State>();
+		state->future = state->promise.get_future().share();
+
+		AssetHandle handle;
+		handle.m_State = state;
+
+		Load load{ std::move(state), std::move(prepare), std::move(finish) };
+		m_PendingCount.fetch_add(1, std::memory_order_acq_rel);
+
+		if (!IsRunning())
+		{
+			RunPrepare(load);
+			return handle;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_QueueMutex);
+			m_Queued.push_back(std::move(load));
+		}
+		m_QueueCv.notify_one();
+		return handle;
+	}
+
+	void AssetLoadQueue::ThreadLoop()
+	{
+		NB_PROFILE_THREAD("Asset Loader");
+		ThreadPlacement::Apply(ThreadRole::Background);
+		for (;;)
+		{
+			Load load;
+			{
+				std::unique_lock<std::mutex> lock(m_QueueMutex);
+				m_QueueCv.wait(lock, [this]() { return m_Quit || !m_Queued.empty(); });
+				if (m_Quit)
+					return;
+				load = std::move(m_Queued.front());
+				m_Queued.pop_front();
+			}
+			RunPrepare(load);
+		}
+	}
+
+	void AssetLoadQueue::RunPrepare(Load& load)
+	{
+		// Cancelled while queued: skip the work, the finish still drops it
+		if (load.prepare && load.state->state.load(std::memory_order_acquire) == AssetState::Loading)
+		{
+			NB_PROFILE_SCOPE("Asset Prepare");
+			load.prepare();
+		}
+		load.prepare = nullptr;
+
+		std::lock_guard<std::mutex> lock(m_CompletedMutex);
+		m_Completed.push_back(std::move(load));
+	}
+
+	uint32_t AssetLoadQueue::RunCompletions(uint32_t maxCount)
+	{
+		uint32_t finished = 0;
+		while (finished < maxCount)
+		{
+			Load load;
+			{
+				std::lock_guard<std::mutex> lock(m_CompletedMutex);
+				if (m_Completed.empty())
+					break;
+				load = std::move(m_Completed.front());
+				m_Completed.pop_front();
+			}
+
+			if (load.state->state.load(std::memory_order_acquire) == AssetState::Loading)
+			{
+				NB_PROFILE_SCOPE("Asset Finish");
+				const bool loaded = !load.finish || load.finish();
+				AssetHandle::Resolve(*load.state, loaded ? AssetState::Ready : AssetState::Failed);
+				++finished;
+			}
+			m_PendingCount.fetch_sub(1, std::memory_order_acq_rel);
+		}
+		return finished;
+	}
+}
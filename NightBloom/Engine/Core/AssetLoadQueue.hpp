@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+// AssetLoadQueue.hpp
+//
+// Two-stage background loading. Every load is a Prepare step - file reads,
+// parsing, decoding: anything that touches no GPU state - run on one of the
+// queue's own threads, and a Finish step run later by whichever thread calls
+// RunCompletions() (the main thread, once per frame), where the GPU objects
+// are created and completion callbacks fire. Finishes run in the order their
+// prepares completed, at most `maxCount` per call, so a burst of loads is
+// spread over frames instead of landing in one.
+//
+// The queue has its own threads rather than using the JobSystem: a frame
+// that Wait()s on job counters would pick up a queued multi-second decode
+// and stall on it.
+//
+// A load is tracked through its AssetHandle. Cancel() (main thread) drops
+// the Finish step; a Prepare already running completes and its result is
+// discarded. Until Start() is called, Submit() prepares inline.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class AssetState : uint8_t
+	{
+		Loading,
+		Ready,
+		Failed,
+		Cancelled
+	};
+
+	class AssetHandle
+	{
+	public:
+		AssetHandle() = default;
+
+		bool IsValid() const { return m_State != nullptr; }
+		AssetState GetState() const;
+		bool IsDone() const { return IsValid() && GetState() != AssetState::Loading; }
+		bool IsReady() const { return IsValid() && GetState() == AssetState::Ready; }
+
+		// Resolves on the thread running the Finish step; blocking on it
+		// there never returns (use the loader's Wait instead)
+		std::shared_future<AssetState> GetFuture() const;
+
+		// No-op once the load is done
+		void Cancel() const;
+
+	private:
+		friend class AssetLoadQueue;
+
+		struct State
+		{
+			std::atomic<AssetState> state{ AssetState::Loading };
+			std::promise<AssetState> promise;
+			std::shared_future<AssetState> future;
+		};
+
+		// First caller moves the state out of Loading and resolves the future
+		static bool Resolve(State& state, AssetState result);
+
+		std::shared_ptr<State> m_State;
+	};
+
+	class AssetLoadQueue
+	{
+	public:
+		using PrepareFn = std::function<void()>;
+		// Returns whether the asset loaded
+		using FinishFn = std::function<bool()>;
+
+		AssetLoadQueue() = default;
+		~AssetLoadQueue();
+
+		AssetLoadQueue(const AssetLoadQueue&) = delete;
+		AssetLoadQueue& operator=(const AssetLoadQueue&) = delete;
+
+		// Starts threadCount loader threads; no-op while running
+		void Start(uint32_t threadCount);
+
+		// Joins the threads once their current prepares are done; every load
+		// not finished yet is cancelled
+		void Stop();
+
+		bool IsRunning() const { return !m_Threads.empty(); }
+
+		AssetHandle Submit(PrepareFn prepare, FinishFn finish);
+
+		// Runs up to maxCount finishes whose prepares are done; returns how
+		// many ran (cancelled loads don't count)
+		uint32_t RunCompletions(uint32_t maxCount = UINT32_MAX);
+
+		// Loads the queue still holds; a cancelled one counts until the
+		// queue gets to it and drops it
+		size_t GetPendingCount() const { return m_PendingCount.load(std::memory_order_acquire); }
+
+	private:
+		struct Load
+		{
+			std::shared_ptr<AssetHandle::State> state;
+			PrepareFn prepare;
+			FinishFn finish;
+		};
+
+		void ThreadLoop();
+		void RunPrepare(Load& load);
+
+		std::vector<std::thread> m_Threads;
+
+		std::mutex m_QueueMutex;
+		std::condition_variable m_QueueCv;
+		std::deque<Load> m_Queued;
+		bool m_Quit = false;
+
+		std::mutex m_CompletedMutex;
+		std::deque<Load> m_Completed;
+
+		std::atomic<size_t> m_PendingCount{ 0 };
+	};
+}
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+// BenchmarkCompare.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/BenchmarkCompare.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		using json = nlohmann::json;
+
+		const char* const PERCENTILES[] = { "p50", "p95" };
+
+		// One timed series of a report: the frame, or a GPU scope
+		struct ReportSeries
+		{
+			std::string name;
+			const json* values = nullptr;
+		};
+
+		bool ParseReport(const std::string& text, const char* which, json& report, std::string& error)
+		{
+			report = json::parse(text, nullptr, false);
+			if (report.is_discarded() || !report.is_object() || !report.contains("benchmark") || !report.contains("frame"))
+			{
+				error = std::string("the ") + which + " isn't a benchmark report";
+				return false;
+			}
+			return true;
+		}
+
+		std::vector<ReportSeries> CollectSeries(const json& report)
+		{
+			std::vector<ReportSeries> series;
+			series.push_back({ "frame", &report["frame"] });
+			if (report.contains("gpu") && report["gpu"].is_array())
+			{
+				for (const json& scope : report["gpu"])
+				{
+					if (scope.value("samples", 0u) == 0)
+						continue;
+					series.push_back({ "gpu " + scope.value("queue", std::string()) + "/" + scope.value("scope", std::string()),
+						&scope });
+				}
+			}
+			return series;
+		}
+
+		const ReportSeries* Find(const std::vector<ReportSeries>& series, const std::string& name)
+		{
+			auto it = std::find_if(series.begin(), series.end(), [&](const ReportSeries& s) { return s.name == name; });
+			return it != series.end() ? &*it : nullptr;
+		}
+
+		BenchmarkVerdict Judge(float baseline, float current, float limit, float minDeltaMs)
+		{
+			const float delta = current - baseline;
+			if (std::abs(delta) <= minDeltaMs || std::abs(delta) <= limit * baseline)
+				return BenchmarkVerdict::Within;
+			return delta > 0.0f ? BenchmarkVerdict::Regressed : BenchmarkVerdict::Improved;
+		}
+
+		const char* VerdictText(BenchmarkVerdict verdict)
+		{
+			switch (verdict)
+			{
+			case BenchmarkVerdict::Improved:  return "improved";
+			case BenchmarkVerdict::Regressed: return "REGRESSED";
+			case BenchmarkVerdict::Added:     return "new";
+			case BenchmarkVerdict::Removed:   return "gone";
+			default:                          return "ok";
+			}
+		}
+	}
+
+	float BenchmarkMetric::GetChange() const
+	{
+		return baselineMs > 0.0f ? (currentMs - baselineMs) / baselineMs : 0.0f;
+	}
+
+	uint32_t BenchmarkComparison::Count(BenchmarkVerdict verdict) const
+	{
+		return static_cast<uint32_t>(std::count_if(metrics.begin(), metrics.end(),
+			[verdict](const BenchmarkMetric& metric) { return metric.verdict == verdict; }));
+	}
+
+	std::string BenchmarkComparison::BuildText() const
+	{
+		std::string out = "Benchmark '" + name + "' against its baseline\n";
+		if (baselineDevice != currentDevice)
+			out += "WARNING: baseline from '" + baselineDevice + "', this run on '" + currentDevice + "'\n";
+
+		size_t width = 6;
+		for (const BenchmarkMetric& metric : metrics)
+			width = std::max(width, metric.name.size());
+
+		char line[512];
+		std::snprintf(line, sizeof(line), "  %-*s %12s %12s %9s  %s\n",
+			static_cast<int>(width), "metric", "baseline ms", "current ms", "change", "verdict");
+		out += line;
+		for (const BenchmarkMetric& metric : metrics)
+		{
+			char change[32] = "";
+			if (metric.verdict != BenchmarkVerdict::Added && metric.verdict != BenchmarkVerdict::Removed)
+				std::snprintf(change, sizeof(change), "%+.1f%%", metric.GetChange() * 100.0f);
+
+			std::snprintf(line, sizeof(line), "  %-*s %12.3f %12.3f %9s  %s",
+				static_cast<int>(width), metric.name.c_str(), metric.baselineMs, metric.currentMs, change,
+				VerdictText(metric.verdict));
+			out += line;
+			if (metric.verdict == BenchmarkVerdict::Regressed)
+			{
+				std::snprintf(line, sizeof(line), " (limit +%.0f%%)", metric.limit * 100.0f);
+				out += line;
+			}
+			out += '\n';
+		}
+
+		std::snprintf(line, sizeof(line), "%u regressed, %u improved, %u within tolerance, %u new, %u gone\n",
+			Count(BenchmarkVerdict::Regressed), Count(BenchmarkVerdict::Improved), Count(BenchmarkVerdict::Within),
+			Count(BenchmarkVerdict::Added), Count(BenchmarkVerdict::Removed));
+		out += line;
+		return out;
+	}
+
+	bool CompareBenchmarkReports(const std::string& baselineJson, const std::string& currentJson,
+		const BenchmarkTolerance& tolerance, BenchmarkComparison& comparison, std::string& error)
+	{
+		json baseline, current;
+		if (!ParseReport(baselineJson, "baseline", baseline, error) || !ParseReport(currentJson, "report", current, error))
+			return false;
+
+		try
+		{
+			comparison = BenchmarkComparison{};
+			comparison.name = current["benchmark"].value("name", std::string());
+			const std::string baselineName = baseline["benchmark"].value("name", std::string());
+			if (baselineName != comparison.name)
+			{
+				error = "the baseline is of '" + baselineName + "', not '" + comparison.name + "'";
+				return false;
+			}
+			comparison.baselineDevice = baseline["benchmark"].value("device", std::string());
+			comparison.currentDevice = current["benchmark"].value("device", std::string());
+
+			const std::vector<ReportSeries> baselineSeries = CollectSeries(baseline);
+			const std::vector<ReportSeries> currentSeries = CollectSeries(current);
+
+			for (const ReportSeries& series : currentSeries)
+			{
+				const ReportSeries* before = Find(baselineSeries, series.name);
+				const float limit = series.name == "frame" ? tolerance.frame : tolerance.gpu;
+				for (const char* percentile : PERCENTILES)
+				{
+					BenchmarkMetric metric;
+					metric.name = series.name + " " + percentile;
+					metric.currentMs = series.values->value(percentile, 0.0f);
+					metric.limit = limit;
+					if (before)
+					{
+						metric.baselineMs = before->values->value(percentile, 0.0f);
+						metric.verdict = Judge(metric.baselineMs, metric.currentMs, limit, tolerance.minDeltaMs);
+					}
+					else
+					{
+						metric.verdict = BenchmarkVerdict::Added;
+					}
+					comparison.metrics.push_back(std::move(metric));
+				}
+			}
+
+			for (const ReportSeries& series : baselineSeries)
+			{
+				if (Find(currentSeries, series.name))
+					continue;
+				for (const char* percentile : PERCENTILES)
+				{
+					BenchmarkMetric metric;
+					metric.name = series.name + " " + percentile;
+					metric.baselineMs = series.values->value(percentile, 0.0f);
+					metric.verdict = BenchmarkVerdict::Removed;
+					comparison.metrics.push_back(std::move(metric));
+				}
+			}
+		}
+		catch (const json::exception& e)
+		{
+			error = e.what();
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// BenchmarkCompare.hpp
+//
+// Compares a NightbloomBench report (BenchmarkReport's JSON) with a baseline
+// report of the same benchmark, for the performance regression gate: the
+// frame time and every GPU scope, at p50 and p95, each against a tolerance
+// band around its baseline value. A metric regresses when it is slower by
+// more than the band AND by more than an absolute floor - sub-0.1 ms passes
+// would otherwise trip on noise alone. Getting faster by as much is listed
+// as an improvement (time to refresh the baseline) but never fails.
+//
+// Scopes only one side has are listed, not judged: a pass added or removed
+// is a change to review, not a regression. Baselines are per machine; a
+// report from another device is still compared, with a warning in the text.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct BenchmarkTolerance
+	{
+		float frame = 0.10f;        // fraction of the baseline
+		float gpu = 0.15f;
+		float minDeltaMs = 0.10f;   // smaller changes never regress
+	};
+
+	enum class BenchmarkVerdict : uint8_t
+	{
+		Within,
+		Improved,
+		Regressed,
+		Added,      // not in the baseline
+		Removed     // only in the baseline
+	};
+
+	struct BenchmarkMetric
+	{
+		std::string name;          // "frame p95", "gpu Graphics/Shadows p50"
+		float baselineMs = 0.0f;
+		float currentMs = 0.0f;
+		float limit = 0.0f;        // the band, as a fraction
+		BenchmarkVerdict verdict = BenchmarkVerdict::Within;
+
+		// (current - baseline) / baseline; 0 without a baseline
+		float GetChange() const;
+	};
+
+	struct BenchmarkComparison
+	{
+		std::string name;
+		std::string baselineDevice;
+		std::string currentDevice;
+		std::vector<BenchmarkMetric> metrics;   // frame first, then GPU scopes in the report's order
+
+		uint32_t Count(BenchmarkVerdict verdict) const;
+		bool HasRegressions() const { return Count(BenchmarkVerdict::Regressed) > 0; }
+
+		// A table of every metric, regressions marked, then a summary line
+		std::string BuildText() const;
+	};
+
+	// Both are report JSON texts. False (and `error`) when either doesn't
+	// parse or they are reports of differently named benchmarks.
+	bool CompareBenchmarkReports(const std::string& baselineJson, const std::string& currentJson,
+		const BenchmarkTolerance& tolerance, BenchmarkComparison& comparison, std::string& error);
+}
@@ -0,0 +1,322 @@
+//------------------------------------------------------------------------------
+// BenchmarkReport.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/BenchmarkReport.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Nearest rank, as GpuProfileHistory. `sorted` is non-empty.
+		float Percentile(const std::vector<float>& sorted, float p)
+		{
+			size_t rank = static_cast<size_t>(std::ceil(p * static_cast<float>(sorted.size())));
+			rank = std::clamp<size_t>(rank, 1, sorted.size());
+			return sorted[rank - 1];
+		}
+
+		void AppendFormat(std::string& out, const char* format, ...)
+		{
+			char buffer[256];
+			va_list args;
+			va_start(args, format);
+			int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+			va_end(args);
+			if (length > 0)
+				out.append(buffer, std::min<size_t>(static_cast<size_t>(length), sizeof(buffer) - 1));
+		}
+
+		void AppendEscaped(std::string& out, const std::string& text)
+		{
+			out += '"';
+			for (char c : text)
+			{
+				switch (c)
+				{
+				case '"':  out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				case '\t': out += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+						AppendFormat(out, "\\u%04x", static_cast<unsigned>(c));
+					else
+						out += c;
+				}
+			}
+			out += '"';
+		}
+
+		void AppendSeries(std::string& out, const BenchmarkSeries& series)
+		{
+			AppendFormat(out, "\"samples\":%u,\"min\":%.4f,\"avg\":%.4f,\"max\":%.4f,\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f",
+				series.samples, series.min, series.avg, series.max, series.p50, series.p95, series.p99);
+		}
+	}
+
+	BenchmarkSeries BenchmarkSeries::FromSamples(std::vector<float> samplesMs)
+	{
+		BenchmarkSeries series;
+		if (samplesMs.empty())
+			return series;
+
+		std::sort(samplesMs.begin(), samplesMs.end());
+		double sum = 0.0;
+		for (float ms : samplesMs)
+			sum += ms;
+
+		series.samples = static_cast<uint32_t>(samplesMs.size());
+		series.min = samplesMs.front();
+		series.max = samplesMs.back();
+		series.avg = static_cast<float>(sum / static_cast<double>(samplesMs.size()));
+		series.p50 = Percentile(samplesMs, 0.50f);
+		series.p95 = Percentile(samplesMs, 0.95f);
+		series.p99 = Percentile(samplesMs, 0.99f);
+		return series;
+	}
+
+	void BenchmarkReport::Clear()
+	{
+		m_FrameMs.clear();
+		m_CpuKeys.clear();
+		m_CpuKeyIds.clear();
+		m_LostCpuEvents = 0;
+		m_RenderKeys.clear();
+		m_RenderKeyIds.clear();
+	}
+
+	void BenchmarkReport::AddFrame(float frameMs, const CpuProfileCapture& cpu)
+	{
+		m_FrameMs.push_back(frameMs);
+
+		std::vector<double> frameSums(m_CpuKeys.size(), -1.0);
+		for (const CpuProfileThread& thread : cpu.threads)
+		{
+			m_LostCpuEvents += thread.lostEvents;
+
+			// Parents complete after their children: walk in start order,
+			// keeping the open ancestors on a stack. An ancestor that hadn't
+			// finished by the capture is left out of the path.
+			std::vector<const CpuProfileEvent*> events;
+			events.reserve(thread.events.size());
+			for (const CpuProfileEvent& event : thread.events)
+				events.push_back(&event);
+			std::stable_sort(events.begin(), events.end(), [](const CpuProfileEvent* a, const CpuProfileEvent* b)
+				{
+					return a->startNs != b->startNs ? a->startNs < b->startNs : a->depth < b->depth;
+				});
+
+			struct Open { uint32_t depth; std::string path; };
+			std::vector<Open> stack;
+			for (const CpuProfileEvent* event : events)
+			{
+				while (!stack.empty() && stack.back().depth >= event->depth)
+					stack.pop_back();
+
+				std::string path = stack.empty() ? std::string() : stack.back().path + "/";
+				path += event->name ? event->name : "?";
+
+				const std::string key = thread.name + "\n" + path;
+				auto [it, inserted] = m_CpuKeyIds.try_emplace(key, static_cast<uint32_t>(m_CpuKeys.size()));
+				if (inserted)
+				{
+					m_CpuKeys.push_back({ thread.name, path, {} });
+					frameSums.push_back(-1.0);
+				}
+
+				double& sum = frameSums[it->second];
+				sum = std::max(sum, 0.0) + static_cast<double>(event->endNs - event->startNs) * 1e-6;
+
+				stack.push_back({ event->depth, std::move(path) });
+			}
+		}
+
+		for (size_t id = 0; id < frameSums.size(); ++id)
+		{
+			if (frameSums[id] >= 0.0)
+				m_CpuKeys[id].samples.push_back(static_cast<float>(frameSums[id]));
+		}
+	}
+
+	void BenchmarkReport::AddRenderStats(const RenderFrameStats& stats)
+	{
+		auto add = [this](const std::string& pass, const RenderCounters& counters)
+		{
+			auto [it, inserted] = m_RenderKeyIds.try_emplace(pass, static_cast<uint32_t>(m_RenderKeys.size()));
+			if (inserted)
+				m_RenderKeys.push_back({ pass, {} });
+
+			RenderKey& key = m_RenderKeys[it->second];
+			for (uint32_t c = 0; c < RENDER_COUNTER_COUNT; ++c)
+				key.samples[c].push_back(static_cast<float>(counters[c]));
+		};
+
+		add("<Frame>", stats.totals);
+		for (const RenderPassStats& pass : stats.passes)
+			add(pass.name.c_str(), pass.counters);
+	}
+
+	std::vector<BenchmarkReport::RenderPass> BenchmarkReport::ComputeRenderStats() const
+	{
+		std::vector<RenderPass> stats;
+		stats.reserve(m_RenderKeys.size());
+		for (const RenderKey& key : m_RenderKeys)
+		{
+			RenderPass& pass = stats.emplace_back();
+			pass.pass = key.pass;
+			for (uint32_t c = 0; c < RENDER_COUNTER_COUNT; ++c)
+				pass.counters[c] = BenchmarkSeries::FromSamples(key.samples[c]);
+		}
+		return stats;
+	}
+
+	std::vector<BenchmarkReport::CpuScope> BenchmarkReport::ComputeCpuStats() const
+	{
+		std::vector<CpuScope> stats;
+		stats.reserve(m_CpuKeys.size());
+		for (const CpuKey& key : m_CpuKeys)
+			stats.push_back({ key.thread, key.path, BenchmarkSeries::FromSamples(key.samples) });
+		return stats;
+	}
+
+	std::vector<BenchmarkReport::GpuScope> BenchmarkReport::ComputeGpuStats(const GpuProfileHistory& gpu)
+	{
+		std::vector<GpuScope> stats;
+
+		// Whole-queue totals first, over the frames each queue had work in
+		for (uint32_t q = 0; q < static_cast<uint32_t>(GpuQueue::Count); ++q)
+		{
+			const GpuQueue queue = static_cast<GpuQueue>(q);
+			std::vector<float> samples;
+			for (uint32_t age = 0; age < gpu.GetFrameCount(); ++age)
+			{
+				const GpuFrameProfile& frame = gpu.GetFrame(age);
+				const bool ran = std::any_of(frame.spans.begin(), frame.spans.end(),
+					[queue](const GpuSpan& span) { return span.queue == queue; });
+				if (ran)
+					samples.push_back(frame.GetQueueMs(queue));
+			}
+			if (samples.empty())
+				continue;
+
+			GpuScope& total = stats.emplace_back();
+			total.path = std::string("<") + GetGpuQueueName(queue) + ">";
+			total.queue = queue;
+			total.ms = BenchmarkSeries::FromSamples(std::move(samples));
+		}
+
+		for (const GpuProfileHistory::ScopeStats& scope : gpu.ComputeStats())
+		{
+			GpuScope& entry = stats.emplace_back();
+			entry.path = scope.path;
+			entry.queue = scope.queue;
+			entry.depth = scope.depth;
+			entry.ms.samples = scope.samples;
+			entry.ms.min = scope.min;
+			entry.ms.avg = scope.avg;
+			entry.ms.max = scope.max;
+			entry.ms.p50 = scope.p50;
+			entry.ms.p95 = scope.p95;
+			entry.ms.p99 = scope.p99;
+		}
+		return stats;
+	}
+
+	std::string BenchmarkReport::BuildJson(const BenchmarkInfo& info, const GpuProfileHistory* gpu) const
+	{
+		std::string out = "{\n  \"benchmark\": {\"name\":";
+		AppendEscaped(out, info.name);
+		out += ",\"scene\":";
+		AppendEscaped(out, info.scene);
+		out += ",\"device\":";
+		AppendEscaped(out, info.device);
+		AppendFormat(out, ",\"width\":%u,\"height\":%u,\"frames\":%u,\"warmupFrames\":%u,\"timestep\":%.6f,\"lostCpuEvents\":%llu},\n",
+			info.width, info.height, GetFrameCount(), info.warmupFrames, info.timestep,
+			static_cast<unsigned long long>(m_LostCpuEvents));
+
+		out += "  \"frame\": {";
+		AppendSeries(out, GetFrameStats());
+		out += "},\n  \"cpu\": [";
+
+		bool first = true;
+		for (const CpuScope& scope : ComputeCpuStats())
+		{
+			out += first ? "\n    {\"thread\":" : ",\n    {\"thread\":";
+			first = false;
+			AppendEscaped(out, scope.thread);
+			out += ",\"scope\":";
+			AppendEscaped(out, scope.path);
+			out += ',';
+			AppendSeries(out, scope.ms);
+			out += '}';
+		}
+		out += first ? "],\n  \"gpu\": [" : "\n  ],\n  \"gpu\": [";
+
+		first = true;
+		if (gpu)
+		{
+			for (const GpuScope& scope : ComputeGpuStats(*gpu))
+			{
+				out += first ? "\n    {\"queue\":\"" : ",\n    {\"queue\":\"";
+				first = false;
+				out += GetGpuQueueName(scope.queue);
+				out += "\",\"scope\":";
+				AppendEscaped(out, scope.path);
+				AppendFormat(out, ",\"depth\":%u,", scope.depth);
+				AppendSeries(out, scope.ms);
+				out += '}';
+			}
+		}
+		out += first ? "],\n  \"render\": [" : "\n  ],\n  \"render\": [";
+
+		first = true;
+		for (const RenderPass& pass : ComputeRenderStats())
+		{
+			for (uint32_t c = 0; c < RENDER_COUNTER_COUNT; ++c)
+			{
+				out += first ? "\n    {\"pass\":" : ",\n    {\"pass\":";
+				first = false;
+				AppendEscaped(out, pass.pass);
+				out += ",\"counter\":\"";
+				out += GetRenderCounterName(static_cast<RenderCounter>(c));
+				out += "\",";
+				AppendSeries(out, pass.counters[c]);
+				out += '}';
+			}
+		}
+		out += first ? "]\n}\n" : "\n  ]\n}\n";
+		return out;
+	}
+
+	bool BenchmarkReport::WriteJson(const std::string& path, const BenchmarkInfo& info,
+		const GpuProfileHistory* gpu, std::string& error) const
+	{
+		const std::string json = BuildJson(info, gpu);
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			error = "can't create " + path;
+			return false;
+		}
+		file.write(json.data(), static_cast<std::streamsize>(json.size()));
+		if (!file)
+		{
+			error = "write failed";
+			return false;
+		}
+		return true;
+	}
+}
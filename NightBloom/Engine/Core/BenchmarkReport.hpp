@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+// BenchmarkReport.hpp
+//
+// What NightbloomBench measures over a run, and the JSON it writes.
+//
+// Each measured frame adds its wall time and a CpuProfiler capture of what
+// ran since the previous frame (captured and cleared once per frame, so a
+// "frame" here is one capture interval). CPU scopes are keyed by thread name
+// and scope path ("Main: Frame/Render Frame/EndFrame"); scopes with the same
+// key in one frame are summed, so job workers' many "Job" scopes give one
+// number per worker per frame. GPU numbers come from GpuProfileHistory,
+// which should hold exactly the measured frames. Render counts come from
+// RenderStats, one frame per AddRenderStats call, per pass and counter, with
+// the frame's totals as the "<Frame>" pass.
+//
+// Like GpuProfileHistory, frames a scope didn't run in aren't samples, and
+// percentiles are nearest-rank.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/CpuProfiler.hpp"
+#include "Engine/Renderer/GpuProfileHistory.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Percentiles of one series of millisecond samples
+	struct BenchmarkSeries
+	{
+		uint32_t samples = 0;
+		float min = 0.0f;
+		float avg = 0.0f;
+		float max = 0.0f;
+		float p50 = 0.0f;
+		float p95 = 0.0f;
+		float p99 = 0.0f;
+
+		static BenchmarkSeries FromSamples(std::vector<float> samplesMs);
+	};
+
+	// Describes the run in the report's header
+	struct BenchmarkInfo
+	{
+		std::string name = "benchmark";
+		std::string scene;
+		std::string device;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t warmupFrames = 0;
+		float timestep = 0.0f;     // seconds of simulated time per frame
+	};
+
+	class BenchmarkReport
+	{
+	public:
+		struct CpuScope
+		{
+			std::string thread;
+			std::string path;
+			BenchmarkSeries ms;
+		};
+
+		struct GpuScope
+		{
+			std::string path;
+			GpuQueue queue = GpuQueue::Graphics;
+			uint32_t depth = 0;
+			BenchmarkSeries ms;
+		};
+
+		struct RenderPass
+		{
+			std::string pass;
+			std::array<BenchmarkSeries, RENDER_COUNTER_COUNT> counters;
+		};
+
+		void Clear();
+
+		// One call per measured frame
+		void AddFrame(float frameMs, const CpuProfileCapture& cpu);
+		// One call per measured frame, RenderStats::GetLastFrame()
+		void AddRenderStats(const RenderFrameStats& stats);
+
+		uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_FrameMs.size()); }
+		BenchmarkSeries GetFrameStats() const { return BenchmarkSeries::FromSamples(m_FrameMs); }
+		// Events the profiler's rings overwrote before a capture: non-zero
+		// means the CPU numbers undercount
+		uint64_t GetLostCpuEvents() const { return m_LostCpuEvents; }
+
+		// In the order the keys were first seen
+		std::vector<CpuScope> ComputeCpuStats() const;
+		// Per scope path, and the queues' totals as "<Queue>" entries
+		static std::vector<GpuScope> ComputeGpuStats(const GpuProfileHistory& gpu);
+		// "<Frame>" first, then the passes in the order they were first seen
+		std::vector<RenderPass> ComputeRenderStats() const;
+
+		// The whole report; `gpu` may be null (no GPU timing on this device)
+		std::string BuildJson(const BenchmarkInfo& info, const GpuProfileHistory* gpu) const;
+		bool WriteJson(const std::string& path, const BenchmarkInfo& info,
+			const GpuProfileHistory* gpu, std::string& error) const;
+
+	private:
+		struct CpuKey
+		{
+			std::string thread;
+			std::string path;
+			std::vector<float> samples;   // one per frame the key ran in
+		};
+
+		struct RenderKey
+		{
+			std::string pass;
+			std::array<std::vector<float>, RENDER_COUNTER_COUNT> samples;   // one per frame the pass counted in
+		};
+
+		std::vector<float> m_FrameMs;
+		std::vector<CpuKey> m_CpuKeys;
+		std::unordered_map<std::string, uint32_t> m_CpuKeyIds;   // "thread\npath"
+		uint64_t m_LostCpuEvents = 0;
+		std::vector<RenderKey> m_RenderKeys;
+		std::unordered_map<std::string, uint32_t> m_RenderKeyIds;
+	};
+}
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+// CameraPath.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/CameraPath.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Uniform Catmull-Rom: passes through p1 at t = 0 and p2 at t = 1
+		glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t)
+		{
+			const float t2 = t * t;
+			const float t3 = t2 * t;
+			return 0.5f * ((2.0f * p1) +
+				(p2 - p0) * t +
+				(2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+				(3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+		}
+	}
+
+	void CameraPath::AddKey(const CameraKey& key)
+	{
+		auto it = std::lower_bound(m_Keys.begin(), m_Keys.end(), key.time,
+			[](const CameraKey& existing, float time) { return existing.time < time; });
+		if (it != m_Keys.end() && it->time == key.time)
+			*it = key;
+		else
+			m_Keys.insert(it, key);
+	}
+
+	float CameraPath::GetDuration() const
+	{
+		if (m_Keys.size() < 2)
+			return 0.0f;
+
+		float duration = m_Keys.back().time - m_Keys.front().time;
+		if (IsLooping())
+			duration += m_LoopTime;
+		return duration;
+	}
+
+	CameraPose CameraPath::Evaluate(float time) const
+	{
+		if (m_Keys.empty())
+			return CameraPose{};
+		if (m_Keys.size() == 1)
+			return LookAt(m_Keys[0].position, m_Keys[0].target);
+
+		const size_t count = m_Keys.size();
+		const bool loop = IsLooping();
+		const size_t segments = loop ? count : count - 1;
+		const float duration = GetDuration();
+
+		float t = time - m_Keys.front().time;
+		if (loop)
+		{
+			t = std::fmod(t, duration);
+			if (t < 0.0f)
+				t += duration;
+		}
+		else
+		{
+			t = std::clamp(t, 0.0f, duration);
+		}
+
+		// Key i's time from the first key; when looping, key `count` is the
+		// first key again at the end of the way back
+		auto keyTime = [&](size_t i)
+		{
+			return i < count ? m_Keys[i].time - m_Keys.front().time : duration;
+		};
+		// Neighbours past either end wrap when looping, otherwise repeat the end key
+		auto key = [&](ptrdiff_t i) -> const CameraKey&
+		{
+			const ptrdiff_t n = static_cast<ptrdiff_t>(count);
+			if (loop)
+				return m_Keys[static_cast<size_t>(((i % n) + n) % n)];
+			return m_Keys[static_cast<size_t>(std::clamp<ptrdiff_t>(i, 0, n - 1))];
+		};
+
+		size_t segment = 0;
+		while (segment + 1 < segments && keyTime(segment + 1) <= t)
+			++segment;
+
+		const float span = keyTime(segment + 1) - keyTime(segment);
+		const float u = span > 0.0f ? std::clamp((t - keyTime(segment)) / span, 0.0f, 1.0f) : 0.0f;
+
+		const ptrdiff_t s = static_cast<ptrdiff_t>(segment);
+		const glm::vec3 position = CatmullRom(key(s - 1).position, key(s).position,
+			key(s + 1).position, key(s + 2).position, u);
+		const glm::vec3 target = CatmullRom(key(s - 1).target, key(s).target,
+			key(s + 1).target, key(s + 2).target, u);
+		return LookAt(position, target);
+	}
+
+	CameraPose CameraPath::LookAt(const glm::vec3& position, const glm::vec3& target)
+	{
+		CameraPose pose;
+		pose.position = position;
+
+		const glm::vec3 offset = target - position;
+		const float length = glm::length(offset);
+		if (length <= 1e-6f)
+			return pose;
+
+		const glm::vec3 forward = offset / length;
+		pose.yaw = glm::degrees(std::atan2(forward.z, forward.x));
+		pose.pitch = glm::degrees(std::asin(std::clamp(forward.y, -1.0f, 1.0f)));
+		return pose;
+	}
+}
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+// CameraPath.hpp
+//
+// A scripted camera: keys of (time, position, look-at target), evaluated as
+// a Catmull-Rom spline through both so the motion has no corners at the
+// keys. Keys may be spaced unevenly in time; each segment is evaluated on
+// its own span. Before the first key and after the last the camera holds
+// still, unless the path loops, in which case the last key leads back into
+// the first over `loopTime` seconds.
+//
+// Evaluated at fixed time steps this gives the same views every run, which
+// is what NightbloomBench needs.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct CameraKey
+	{
+		float time = 0.0f;                         // seconds
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 target = glm::vec3(0.0f, 0.0f, -1.0f);
+	};
+
+	struct CameraPose
+	{
+		glm::vec3 position = glm::vec3(0.0f);
+		float yaw = -90.0f;    // degrees, as Camera::SetRotation takes them
+		float pitch = 0.0f;
+	};
+
+	class CameraPath
+	{
+	public:
+		// Keeps the keys sorted by time; a key at an existing time replaces it
+		void AddKey(const CameraKey& key);
+		void Clear() { m_Keys.clear(); }
+
+		// Looping: after the last key, travel back to the first in `loopTime`
+		// seconds and start over. loopTime <= 0 turns it off.
+		void SetLoop(float loopTime) { m_LoopTime = loopTime; }
+		bool IsLooping() const { return m_LoopTime > 0.0f && m_Keys.size() > 1; }
+
+		bool IsEmpty() const { return m_Keys.empty(); }
+		size_t GetKeyCount() const { return m_Keys.size(); }
+		const CameraKey& GetKey(size_t index) const { return m_Keys[index]; }
+
+		// First key to the last, plus the way back when looping
+		float GetDuration() const;
+
+		CameraPose Evaluate(float time) const;
+
+		// Yaw/pitch that look from `position` at `target` (Camera's convention:
+		// yaw 0 faces +X, -90 faces -Z)
+		static CameraPose LookAt(const glm::vec3& position, const glm::vec3& target);
+
+	private:
+		std::vector<CameraKey> m_Keys;
+		float m_LoopTime = 0.0f;
+	};
+}
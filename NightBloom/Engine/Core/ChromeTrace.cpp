@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+// ChromeTrace.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/ChromeTrace.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr int CPU_PID = 1;
+		constexpr int GPU_PID = 2;
+
+		void AppendFormat(std::string& out, const char* format, ...)
+		{
+			char buffer[256];
+			va_list args;
+			va_start(args, format);
+			int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+			va_end(args);
+			if (length > 0)
+				out.append(buffer, std::min<size_t>(static_cast<size_t>(length), sizeof(buffer) - 1));
+		}
+
+		void AppendEscaped(std::string& out, const char* text)
+		{
+			out += '"';
+			for (const char* c = text ? text : ""; *c; ++c)
+			{
+				switch (*c)
+				{
+				case '"':  out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				case '\t': out += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(*c) < 0x20)
+						AppendFormat(out, "\\u%04x", static_cast<unsigned>(*c));
+					else
+						out += *c;
+				}
+			}
+			out += '"';
+		}
+
+		class TraceBuilder
+		{
+		public:
+			explicit TraceBuilder(uint64_t baseNs) : m_BaseNs(baseNs)
+			{
+				m_Out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+			}
+
+			void Metadata(const char* kind, int pid, uint32_t tid, const char* name, uint32_t sortIndex)
+			{
+				Begin();
+				AppendFormat(m_Out, "{\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"name\":\"%s\",\"args\":{\"name\":",
+					pid, tid, kind);
+				AppendEscaped(m_Out, name);
+				m_Out += "}}";
+
+				const char* sortKind = (std::string_view(kind) == "process_name") ? "process_sort_index" : "thread_sort_index";
+				Begin();
+				AppendFormat(m_Out, "{\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"name\":\"%s\",\"args\":{\"sort_index\":%u}}",
+					pid, tid, sortKind, sortIndex);
+			}
+
+			// Microseconds since the trace's first event; subtracted as integers
+			// so absolute clock values don't cost precision
+			double ToUs(uint64_t ns) const
+			{
+				return static_cast<double>(ns - m_BaseNs) * 1e-3;
+			}
+
+			void Complete(const char* name, int pid, uint32_t tid, double startUs, double durationUs,
+				const char* argName = nullptr, uint64_t argValue = 0)
+			{
+				Begin();
+				m_Out += "{\"ph\":\"X\",\"name\":";
+				AppendEscaped(m_Out, name);
+				AppendFormat(m_Out, ",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+					pid, tid, startUs, std::max(durationUs, 0.0));
+				if (argName)
+					AppendFormat(m_Out, ",\"args\":{\"%s\":%llu}", argName, static_cast<unsigned long long>(argValue));
+				m_Out += '}';
+			}
+
+			std::string Finish()
+			{
+				m_Out += "\n]}\n";
+				return std::move(m_Out);
+			}
+
+		private:
+			void Begin()
+			{
+				if (!m_First)
+					m_Out += ",\n";
+				m_First = false;
+			}
+
+			uint64_t m_BaseNs;
+			std::string m_Out;
+			bool m_First = true;
+		};
+	}
+
+	std::string BuildChromeTrace(const CpuProfileCapture& cpu, const GpuProfileHistory* gpu)
+	{
+		// Earliest timestamp in the file becomes 0
+		uint64_t baseNs = cpu.captureNs;
+		for (const CpuProfileThread& thread : cpu.threads)
+		{
+			for (const CpuProfileEvent& event : thread.events)
+				baseNs = std::min(baseNs, event.startNs);
+		}
+		if (gpu)
+		{
+			for (uint32_t age = 0; age < gpu->GetFrameCount(); ++age)
+			{
+				for (uint64_t submitNs : gpu->GetFrame(age).cpuSubmitNs)
+				{
+					if (submitNs != 0)
+						baseNs = std::min(baseNs, submitNs);
+				}
+			}
+		}
+
+		TraceBuilder trace(baseNs);
+
+		trace.Metadata("process_name", CPU_PID, 0, "CPU", 0);
+		for (const CpuProfileThread& thread : cpu.threads)
+		{
+			trace.Metadata("thread_name", CPU_PID, thread.id, thread.name.c_str(), thread.id);
+			for (const CpuProfileEvent& event : thread.events)
+			{
+				trace.Complete(event.name, CPU_PID, thread.id, trace.ToUs(event.startNs),
+					static_cast<double>(event.endNs - event.startNs) * 1e-3);
+			}
+		}
+
+		if (gpu && gpu->GetFrameCount() > 0)
+		{
+			trace.Metadata("process_name", GPU_PID, 0, "GPU", 1);
+			for (uint32_t q = 0; q < static_cast<uint32_t>(GpuQueue::Count); ++q)
+				trace.Metadata("thread_name", GPU_PID, q, GetGpuQueueName(static_cast<GpuQueue>(q)), q);
+
+			// Oldest first, so each track reads left to right in the file too
+			for (uint32_t age = gpu->GetFrameCount(); age-- > 0;)
+			{
+				const GpuFrameProfile& frame = gpu->GetFrame(age);
+				for (const GpuSpan& span : frame.spans)
+				{
+					const uint32_t q = static_cast<uint32_t>(span.queue);
+					const uint64_t originNs = frame.cpuSubmitNs[q];
+					if (originNs == 0)
+						continue;
+
+					trace.Complete(span.name.c_str(), GPU_PID, q,
+						trace.ToUs(originNs) + span.startMs * 1e3,
+						static_cast<double>(span.ms) * 1e3, "frame", frame.frameNumber);
+				}
+			}
+		}
+
+		return trace.Finish();
+	}
+
+	bool WriteChromeTrace(const std::string& path, const CpuProfileCapture& cpu,
+		const GpuProfileHistory* gpu, std::string& error)
+	{
+		const std::string json = BuildChromeTrace(cpu, gpu);
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				error = "can't create " + tempPath;
+				return false;
+			}
+			file.write(json.data(), static_cast<std::streamsize>(json.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				error = "write failed";
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			error = "can't replace " + path + ": " + ec.message();
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,31 @@
+//------------------------------------------------------------------------------
+// ChromeTrace.hpp
+//
+// Writes a CpuProfiler capture, merged with the GPU profiler's history, as
+// Chrome trace event JSON - it opens in chrome://tracing and in Perfetto
+// (ui.perfetto.dev). One "CPU" process with a track per profiled thread
+// (render thread, job workers, asset loaders, ...) and one "GPU" process
+// with a track per queue, all on one clock:
+//
+//   CPU scopes    complete ("X") events at their CpuProfiler::Now() times
+//   GPU spans     placed at their queue's CPU submit time plus their offset
+//                 within the frame (GpuFrameProfile::cpuSubmitNs); frames
+//                 without a submit time are left out
+//
+// Times are microseconds from the earliest event in the file.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/CpuProfiler.hpp"
+#include "Engine/Renderer/GpuProfileHistory.hpp"
+#include <string>
+
+namespace Nightbloom
+{
+	// `gpu` may be null for a CPU-only trace
+	std::string BuildChromeTrace(const CpuProfileCapture& cpu, const GpuProfileHistory* gpu);
+
+	// Temporary file + rename, like the other writers
+	bool WriteChromeTrace(const std::string& path, const CpuProfileCapture& cpu,
+		const GpuProfileHistory* gpu, std::string& error);
+}
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+// CpuMemory.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/CpuMemory.hpp"
+#include <array>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr size_t CATEGORY_COUNT = static_cast<size_t>(CpuMemoryCategory::Count);
+
+		struct CategoryState
+		{
+			TrackedMemoryResource resource;
+			std::atomic<uint64_t> frameStart{ 0 };   // allocation count at the last BeginFrame
+			std::atomic<uint64_t> lastFrame{ 0 };
+		};
+
+		std::array<CategoryState, CATEGORY_COUNT>& GetStates()
+		{
+			// Leaked on purpose: containers in statics free into these at exit
+			static auto* states = new std::array<CategoryState, CATEGORY_COUNT>();
+			return *states;
+		}
+	}
+
+	const char* GetCpuMemoryCategoryName(CpuMemoryCategory category)
+	{
+		switch (category)
+		{
+		case CpuMemoryCategory::Scene:      return "Scene";
+		case CpuMemoryCategory::DrawList:   return "Draw list";
+		case CpuMemoryCategory::Mesh:       return "Meshes";
+		case CpuMemoryCategory::Image:      return "Images";
+		case CpuMemoryCategory::Serializer: return "Serializer";
+		default:                            return "?";
+		}
+	}
+
+	TrackedMemoryResource::TrackedMemoryResource(std::pmr::memory_resource* upstream)
+		: m_Upstream(upstream)
+	{
+	}
+
+	void TrackedMemoryResource::ResetPeak()
+	{
+		m_PeakBytes.store(m_LiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	void* TrackedMemoryResource::do_allocate(size_t bytes, size_t alignment)
+	{
+		void* ptr = m_Upstream->allocate(bytes, alignment);
+
+		m_Allocations.fetch_add(1, std::memory_order_relaxed);
+		const uint64_t live = m_LiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		uint64_t peak = m_PeakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !m_PeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+		return ptr;
+	}
+
+	void TrackedMemoryResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+	{
+		m_Upstream->deallocate(ptr, bytes, alignment);
+		m_Deallocations.fetch_add(1, std::memory_order_relaxed);
+		m_LiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+
+	TrackedMemoryResource& CpuMemory::GetResource(CpuMemoryCategory category)
+	{
+		return GetStates()[static_cast<size_t>(category)].resource;
+	}
+
+	CpuMemory::CategoryStats CpuMemory::GetCategoryStats(CpuMemoryCategory category)
+	{
+		const CategoryState& state = GetStates()[static_cast<size_t>(category)];
+
+		CategoryStats stats;
+		stats.liveBytes = state.resource.GetLiveBytes();
+		stats.peakBytes = state.resource.GetPeakBytes();
+		stats.totalAllocations = state.resource.GetAllocationCount();
+		stats.liveCount = stats.totalAllocations - state.resource.GetDeallocationCount();
+		stats.frameAllocations = state.lastFrame.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	uint64_t CpuMemory::GetLiveBytes()
+	{
+		uint64_t total = 0;
+		for (const CategoryState& state : GetStates())
+			total += state.resource.GetLiveBytes();
+		return total;
+	}
+
+	uint64_t CpuMemory::GetFrameAllocations()
+	{
+		uint64_t total = 0;
+		for (const CategoryState& state : GetStates())
+			total += state.lastFrame.load(std::memory_order_relaxed);
+		return total;
+	}
+
+	void CpuMemory::BeginFrame()
+	{
+		for (CategoryState& state : GetStates())
+		{
+			const uint64_t count = state.resource.GetAllocationCount();
+			state.lastFrame.store(count - state.frameStart.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			state.frameStart.store(count, std::memory_order_relaxed);
+		}
+	}
+
+	void CpuMemory::ResetPeaks()
+	{
+		for (CategoryState& state : GetStates())
+			state.resource.ResetPeak();
+	}
+}
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// CpuMemory.hpp
+//
+// Who owns the CPU heap. Each subsystem that holds bulk data draws it from a
+// std::pmr memory resource of its own, which counts live bytes, the peak and
+// every allocation before passing it upstream (new/delete unless the
+// resource was built over something else, an arena for instance):
+//
+//   TrackedVector<uint8_t, CpuMemoryCategory::Image> pixels;   // counted as Image
+//
+// TrackedAllocator is a stateless allocator naming the category, not the
+// resource, so a container keeps its category when copied - a plain
+// std::pmr::vector copy would fall back to the default resource.
+//
+// BeginFrame, called once per frame by the renderer, closes a frame's
+// allocation counts. The frame loop's budget is zero: anything counted there
+// in steady state is a container growing (or being rebuilt) every frame.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class CpuMemoryCategory : uint8_t
+	{
+		Scene,        // SceneNodes' transform, flag and bounds streams
+		DrawList,     // the per-frame arena behind the frame's draw list
+		Mesh,         // loaded vertices and indices (MeshData)
+		Image,        // decoded pixels (ImageData)
+		Serializer,   // JSON documents while a scene is read or written
+		Count
+	};
+
+	const char* GetCpuMemoryCategoryName(CpuMemoryCategory category);
+
+	// Counts what passes through it; thread-safe when upstream is
+	class TrackedMemoryResource final : public std::pmr::memory_resource
+	{
+	public:
+		explicit TrackedMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+		TrackedMemoryResource(const TrackedMemoryResource&) = delete;
+		TrackedMemoryResource& operator=(const TrackedMemoryResource&) = delete;
+
+		uint64_t GetLiveBytes() const { return m_LiveBytes.load(std::memory_order_relaxed); }
+		uint64_t GetPeakBytes() const { return m_PeakBytes.load(std::memory_order_relaxed); }
+		uint64_t GetAllocationCount() const { return m_Allocations.load(std::memory_order_relaxed); }
+		uint64_t GetDeallocationCount() const { return m_Deallocations.load(std::memory_order_relaxed); }
+
+		// Restarts the high-water mark from what's live now
+		void ResetPeak();
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		std::pmr::memory_resource* m_Upstream;
+		std::atomic<uint64_t> m_LiveBytes{ 0 };
+		std::atomic<uint64_t> m_PeakBytes{ 0 };
+		std::atomic<uint64_t> m_Allocations{ 0 };
+		std::atomic<uint64_t> m_Deallocations{ 0 };
+	};
+
+	class CpuMemory
+	{
+	public:
+		struct CategoryStats
+		{
+			uint64_t liveBytes = 0;
+			uint64_t liveCount = 0;
+			uint64_t peakBytes = 0;
+			uint64_t totalAllocations = 0;   // ever made
+			uint64_t frameAllocations = 0;   // between the last two BeginFrame calls
+		};
+
+		// The category's resource, over new/delete. Never destroyed, so
+		// statics may still free into it during exit.
+		static TrackedMemoryResource& GetResource(CpuMemoryCategory category);
+
+		static CategoryStats GetCategoryStats(CpuMemoryCategory category);
+		static uint64_t GetLiveBytes();
+		// Allocations over every category during the last whole frame
+		static uint64_t GetFrameAllocations();
+
+		// Render thread, once per frame
+		static void BeginFrame();
+		static void ResetPeaks();
+	};
+
+	// Stateless allocator drawing from a category's resource
+	template<typename T, CpuMemoryCategory Category>
+	class TrackedAllocator
+	{
+	public:
+		using value_type = T;
+
+		// The category is a non-type parameter, which allocator_traits can't rebind on its own
+		template<typename U>
+		struct rebind
+		{
+			using other = TrackedAllocator<U, Category>;
+		};
+
+		TrackedAllocator() = default;
+		template<typename U>
+		TrackedAllocator(const TrackedAllocator<U, Category>&) {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(CpuMemory::GetResource(Category).allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* ptr, size_t count)
+		{
+			CpuMemory::GetResource(Category).deallocate(ptr, count * sizeof(T), alignof(T));
+		}
+
+		template<typename U>
+		bool operator==(const TrackedAllocator<U, Category>&) const { return true; }
+	};
+
+	template<typename T, CpuMemoryCategory Category>
+	using TrackedVector = std::vector<T, TrackedAllocator<T, Category>>;
+}
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+// CpuProfiler.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/CpuProfiler.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// The ring this thread writes, and the profiler it belongs to (by id:
+		// a new profiler may reuse a destroyed one's address)
+		thread_local uint64_t t_Owner = 0;
+		thread_local void* t_Ring = nullptr;
+
+		std::atomic<uint64_t> s_NextProfilerId{ 1 };
+
+		thread_local uint32_t t_Depth = 0;
+
+		constexpr uint64_t RING_MASK = CpuProfiler::EVENTS_PER_THREAD - 1;
+		static_assert((CpuProfiler::EVENTS_PER_THREAD & RING_MASK) == 0, "EVENTS_PER_THREAD must be a power of two");
+	}
+
+	CpuProfiler::CpuProfiler()
+		: m_Id(s_NextProfilerId.fetch_add(1, std::memory_order_relaxed))
+	{
+	}
+
+	CpuProfiler& CpuProfiler::Get()
+	{
+		static CpuProfiler instance;
+		return instance;
+	}
+
+	uint64_t CpuProfiler::Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void CpuProfiler::SetThreadName(const std::string& name)
+	{
+		CpuProfiler& profiler = Get();
+		ThreadRing& ring = profiler.GetThreadRing();
+		std::lock_guard<std::mutex> lock(profiler.m_Mutex);
+		ring.name = name;
+	}
+
+	CpuProfiler::ThreadRing& CpuProfiler::GetThreadRing()
+	{
+		if (t_Owner == m_Id)
+			return *static_cast<ThreadRing*>(t_Ring);
+
+		auto ring = std::make_unique<ThreadRing>();
+		ring->slots = std::make_unique<Slot[]>(EVENTS_PER_THREAD);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		ring->id = static_cast<uint32_t>(m_Threads.size());
+		ring->name = "Thread " + std::to_string(ring->id);
+		t_Owner = m_Id;
+		t_Ring = ring.get();
+		m_Threads.push_back(std::move(ring));
+		return *m_Threads.back();
+	}
+
+	void CpuProfiler::Record(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth)
+	{
+		ThreadRing& ring = GetThreadRing();
+
+		// Announce the write before touching the slot, so a capture that
+		// read the slot meanwhile knows it may be torn
+		const uint64_t index = ring.written.load(std::memory_order_relaxed);
+		ring.begun.store(index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Slot& slot = ring.slots[index & RING_MASK];
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.startNs.store(startNs, std::memory_order_relaxed);
+		slot.endNs.store(endNs, std::memory_order_relaxed);
+		slot.depth.store(depth, std::memory_order_relaxed);
+
+		ring.written.store(index + 1, std::memory_order_release);
+	}
+
+	CpuProfileCapture CpuProfiler::Capture() const
+	{
+		CpuProfileCapture capture;
+		capture.captureNs = Now();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		capture.threads.reserve(m_Threads.size());
+		for (const std::unique_ptr<ThreadRing>& ring : m_Threads)
+		{
+			CpuProfileThread& thread = capture.threads.emplace_back();
+			thread.id = ring->id;
+			thread.name = ring->name;
+
+			const uint64_t written = ring->written.load(std::memory_order_acquire);
+			const uint64_t cleared = ring->clearedAt.load(std::memory_order_relaxed);
+			const uint64_t first = std::max(cleared, written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0);
+
+			std::vector<CpuProfileEvent> events;
+			events.reserve(written - first);
+			for (uint64_t i = first; i < written; ++i)
+			{
+				const Slot& slot = ring->slots[i & RING_MASK];
+				CpuProfileEvent event;
+				event.name = slot.name.load(std::memory_order_relaxed);
+				event.startNs = slot.startNs.load(std::memory_order_relaxed);
+				event.endNs = slot.endNs.load(std::memory_order_relaxed);
+				event.depth = slot.depth.load(std::memory_order_relaxed);
+				events.push_back(event);
+			}
+
+			// Slots the thread started rewriting while they were copied are
+			// dropped: everything below begun - capacity may be torn
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t begun = ring->begun.load(std::memory_order_relaxed);
+			const uint64_t valid = begun > EVENTS_PER_THREAD ? begun - EVENTS_PER_THREAD : 0;
+			const size_t skip = static_cast<size_t>(std::min<uint64_t>(valid > first ? valid - first : 0, events.size()));
+
+			thread.events.assign(events.begin() + static_cast<std::ptrdiff_t>(skip), events.end());
+			thread.lostEvents = std::max(first, valid) - cleared;
+		}
+		return capture;
+	}
+
+	void CpuProfiler::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (const std::unique_ptr<ThreadRing>& ring : m_Threads)
+			ring->clearedAt.store(ring->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+
+	CpuProfileScope::CpuProfileScope(const char* name)
+	{
+		if (!CpuProfiler::Get().IsEnabled())
+			return;
+
+		m_Name = name;
+		++t_Depth;
+		m_StartNs = CpuProfiler::Now();
+	}
+
+	CpuProfileScope::~CpuProfileScope()
+	{
+		if (!m_Name)
+			return;
+
+		const uint64_t endNs = CpuProfiler::Now();
+		--t_Depth;
+		CpuProfiler::Get().Record(m_Name, m_StartNs, endNs, t_Depth);
+	}
+}
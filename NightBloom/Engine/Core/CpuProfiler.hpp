@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+// CpuProfiler.hpp
+//
+// Instrumented CPU profiler. NB_PROFILE_SCOPE("Name") times the rest of the
+// enclosing block on the calling thread; NB_PROFILE_FUNCTION() uses the
+// function's name. Names must outlive the profiler (string literals) - only
+// the pointer is stored.
+//
+// Every thread that records gets its own ring of the newest
+// EVENTS_PER_THREAD scopes, written only by that thread: a scope costs two
+// clock reads and one slot, with no lock and no allocation (the ring is
+// allocated on the thread's first scope). Capture() copies the rings while
+// they are being written and drops any event overwritten during the copy,
+// so it never stalls the threads it samples.
+//
+// Threads are told apart by SetThreadName ("Main", "Job Worker 2", ...);
+// ChromeTrace.hpp turns a capture into a trace file with one timeline per
+// thread, merged with the GPU profiler's spans.
+//
+// Compiled out (the macros expand to nothing) with NB_PROFILE_ENABLED=0, the
+// NIGHTBLOOM_ENABLE_PROFILER CMake option.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef NB_PROFILE_ENABLED
+#define NB_PROFILE_ENABLED 1
+#endif
+
+namespace Nightbloom
+{
+	struct CpuProfileEvent
+	{
+		const char* name = nullptr;
+		uint64_t startNs = 0;   // CpuProfiler::Now() clock
+		uint64_t endNs = 0;
+		uint32_t depth = 0;     // open scopes around it on its thread
+	};
+
+	struct CpuProfileThread
+	{
+		uint32_t id = 0;        // in order of each thread's first scope
+		std::string name;
+		std::vector<CpuProfileEvent> events;   // in order of completion
+		uint64_t lostEvents = 0;               // overwritten before the capture
+	};
+
+	struct CpuProfileCapture
+	{
+		uint64_t captureNs = 0;
+		std::vector<CpuProfileThread> threads;
+	};
+
+	class CpuProfiler
+	{
+	public:
+		static constexpr uint32_t EVENTS_PER_THREAD = 8192;   // power of two, 256 KB per thread
+
+		static CpuProfiler& Get();
+
+		// Monotonic nanoseconds, the clock every event (and the GPU spans'
+		// CPU anchors) is measured on
+		static uint64_t Now();
+
+		// Names the calling thread's timeline
+		static void SetThreadName(const std::string& name);
+
+		void SetEnabled(bool enabled) { m_Enabled.store(enabled, std::memory_order_relaxed); }
+		bool IsEnabled() const { return m_Enabled.load(std::memory_order_relaxed); }
+
+		// Called by CpuProfileScope on the recording thread
+		void Record(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth);
+
+		// Copies every thread's ring; safe while threads keep recording
+		CpuProfileCapture Capture() const;
+
+		// Forget everything recorded so far (later captures start from here)
+		void Clear();
+
+		CpuProfiler();
+		CpuProfiler(const CpuProfiler&) = delete;
+		CpuProfiler& operator=(const CpuProfiler&) = delete;
+
+	private:
+		struct Slot
+		{
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<uint64_t> startNs{ 0 };
+			std::atomic<uint64_t> endNs{ 0 };
+			std::atomic<uint32_t> depth{ 0 };
+		};
+
+		// One per recording thread; kept after the thread exits so its
+		// events still show up in captures
+		struct ThreadRing
+		{
+			uint32_t id = 0;
+			std::string name;                     // guarded by m_Mutex
+			std::unique_ptr<Slot[]> slots;
+			std::atomic<uint64_t> begun{ 0 };     // writes started
+			std::atomic<uint64_t> written{ 0 };   // writes finished
+			std::atomic<uint64_t> clearedAt{ 0 }; // Clear(): ignore writes before this
+		};
+
+		ThreadRing& GetThreadRing();
+
+		const uint64_t m_Id;
+		std::atomic<bool> m_Enabled{ true };
+		mutable std::mutex m_Mutex;
+		std::vector<std::unique_ptr<ThreadRing>> m_Threads;
+	};
+
+	// RAII scope behind NB_PROFILE_SCOPE
+	class CpuProfileScope
+	{
+	public:
+		explicit CpuProfileScope(const char* name);
+		~CpuProfileScope();
+
+		CpuProfileScope(const CpuProfileScope&) = delete;
+		CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+
+	private:
+		const char* m_Name = nullptr;   // null when the profiler was disabled
+		uint64_t m_StartNs = 0;
+	};
+}
+
+#define NB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define NB_PROFILE_CONCAT(a, b) NB_PROFILE_CONCAT_IMPL(a, b)
+
+#if NB_PROFILE_ENABLED
+#define NB_PROFILE_SCOPE(name) ::Nightbloom::CpuProfileScope NB_PROFILE_CONCAT(_nb_profile_scope_, __LINE__)(name)
+#define NB_PROFILE_FUNCTION() NB_PROFILE_SCOPE(__func__)
+#define NB_PROFILE_THREAD(name) ::Nightbloom::CpuProfiler::SetThreadName(name)
+#else
+#define NB_PROFILE_SCOPE(name) ((void)0)
+#define NB_PROFILE_FUNCTION() ((void)0)
+#define NB_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -10,12 +10,23 @@
 #include "Logger/Logger.hpp"
 #include "Logger/ConsoleLogger.hpp"
 #include "Logger/FileLogger.hpp"
+#include "JobSystem.hpp"
+#include "StartupTimer.hpp"
+#include "ThreadPlacement.hpp"
 
 namespace Nightbloom
 {
     // This exists just so CMake has something to compile
     void EngineInit()
     {
+		// Time to first frame counts from here (StartupTimer.hpp)
+		StartupTimer::Get().Start(StartupTimer::Now());
+
+		// Before any thread starts, the log writer's included
+		ThreadPlacementSettings placement;
+		const bool placementValid = ThreadPlacement::SettingsFromEnvironment(placement);
+		ThreadPlacement::Configure(placement);
+
 		// Initialize the logger
         Logger& logger = Logger::Get();
 
@@ -28,6 +39,9 @@ namespace Nightbloom
 		// Set default log level
 		logger.SetLogLevel(LogLevel::Trace);
 
+		// Sinks are written from a background thread from here on
+		logger.EnableAsync();
+
 		LOG_INFO("Nightbloom Engine initialized successfully!");
 		LOG_INFO("Version {}.{}.{}",
 			NIGHTBLOOM_VERSION_MAJOR,
@@ -47,11 +61,19 @@ namespace Nightbloom
 #endif
 
 		LOG_INFO("Running on platform: {}", platformName);
+		if (!placementValid)
+			LOG_WARN("Ignoring malformed NIGHTBLOOM_THREAD_PLACEMENT (\"off\" or role=cores[:priority],...)");
+		LOG_INFO("CPU: {}", ThreadPlacement::Describe());
+
+		JobSystem::Get().Initialize();
+		StartupTimer::Get().Mark("Engine init", StartupTimer::Now());
     }
 
     void EngineShutdown()
 	{
 		LOG_INFO("Shutting down Nightbloom Engine...");
+		JobSystem::Get().Shutdown();
+		Logger::Get().DisableAsync();
 		Logger::Get().ClearSinks();
 	}
 }
\ No newline at end of file
@@ -1,22 +1,46 @@
 #include "FileUtils.hpp"
 
-#include <fstream>
+#include <filesystem>
+#include <stdexcept>
 
-std::vector<char> Nightbloom::FileUtils::ReadFileAsChars(const std::string& filePath)
+namespace
 {
-	std::ifstream file(filePath, std::ios::ate | std::ios::binary);
-
-	if (!file.is_open())
+	// One copy out of the mapping, no stream buffering in between
+	template <typename Container>
+	Container CopyMapped(const std::string& filePath)
 	{
-		throw std::runtime_error("Failed to open file: " + filePath);
-		//return std::vector<char>();
+		Nightbloom::MappedFile file;
+		if (!file.Open(filePath))
+		{
+			// Empty files don't map
+			if (std::filesystem::exists(filePath))
+				return Container();
+			throw std::runtime_error("Failed to open file: " + filePath);
+		}
+
+		const auto* data = reinterpret_cast<const typename Container::value_type*>(file.GetData());
+		return Container(data, data + file.GetSize());
 	}
+}
+
+Nightbloom::MappedFile Nightbloom::FileUtils::MapFile(const std::string& filePath)
+{
+	MappedFile file;
+	file.Open(filePath);
+	return file;
+}
 
-	size_t fileSize = static_cast<size_t>(file.tellg());
-	std::vector<char> buffer(fileSize);
-	file.seekg(0);
-	file.read(buffer.data(), fileSize);
-	file.close();
+std::string Nightbloom::FileUtils::ReadFile(const std::string& filePath)
+{
+	return CopyMapped<std::string>(filePath);
+}
 
-	return buffer;
+std::vector<uint8_t> Nightbloom::FileUtils::ReadFileAsBytes(const std::string& filePath)
+{
+	return CopyMapped<std::vector<uint8_t>>(filePath);
+}
+
+std::vector<char> Nightbloom::FileUtils::ReadFileAsChars(const std::string& filePath)
+{
+	return CopyMapped<std::vector<char>>(filePath);
 }
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "Core/MappedFile.hpp"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -12,6 +14,11 @@ namespace Nightbloom
 	class FileUtils
 	{
 	public:
+		// Maps the file instead of reading it: the span (GetSpan) can feed
+		// staging memory or Vulkan without a heap copy. Not open when the
+		// file is missing or empty.
+		static MappedFile MapFile(const std::string& filePath);
+
 		// Reads the entire file into a string
 		static std::string ReadFile(const std::string& filePath);
 
@@ -20,4 +27,4 @@ namespace Nightbloom
 
 		static std::vector<char> ReadFileAsChars(const std::string& filePath);
 	};
-}
\ No newline at end of file
+}
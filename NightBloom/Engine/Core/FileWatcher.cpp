@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+// FileWatcher.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/FileWatcher.hpp"
+#include "Core/Platform.hpp"
+#include "Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+#ifdef NIGHTBLOOM_PLATFORM_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Nightbloom
+{
+	namespace fs = std::filesystem;
+
+	void FileChangeCoalescer::Add(const std::string& path, Clock::time_point time)
+	{
+		m_LastEvent[path] = time;
+	}
+
+	size_t FileChangeCoalescer::TakeSettled(Clock::time_point now, Clock::duration settle, std::vector<std::string>& out)
+	{
+		const size_t first = out.size();
+		for (auto it = m_LastEvent.begin(); it != m_LastEvent.end();)
+		{
+			if (now - it->second >= settle)
+			{
+				out.push_back(it->first);
+				it = m_LastEvent.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		std::sort(out.begin() + first, out.end());
+		return out.size() - first;
+	}
+
+	std::string FileWatcher::NormalizePath(const fs::path& path)
+	{
+		std::error_code ec;
+		fs::path absolute = fs::absolute(path, ec);
+		std::string normal = (ec ? path : absolute).lexically_normal().generic_string();
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+		std::transform(normal.begin(), normal.end(), normal.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+#endif
+		return normal;
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		Stop();
+	}
+
+	bool FileWatcher::Watch(const std::string& directory)
+	{
+		std::error_code ec;
+		if (!fs::is_directory(directory, ec))
+		{
+			LOG_WARN("FileWatcher: '{}' is not a directory", directory);
+			return false;
+		}
+
+		fs::path root = fs::absolute(directory, ec).lexically_normal();
+		if (std::find(m_Directories.begin(), m_Directories.end(), root) == m_Directories.end())
+			m_Directories.push_back(std::move(root));
+		return true;
+	}
+
+	bool FileWatcher::Start()
+	{
+		if (IsRunning())
+			return true;
+		if (m_Directories.empty())
+			return false;
+
+		m_Quit = false;
+		m_Thread = std::thread([this]() { Run(); });
+		return true;
+	}
+
+	void FileWatcher::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		m_Quit = true;
+		m_Thread.join();
+	}
+
+	size_t FileWatcher::Poll(std::vector<std::string>& changed)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Coalescer.TakeSettled(FileChangeCoalescer::Clock::now(), m_Settle, changed);
+	}
+
+	void FileWatcher::Report(const fs::path& path)
+	{
+		const std::string normal = NormalizePath(path);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Coalescer.Add(normal, FileChangeCoalescer::Clock::now());
+	}
+
+	void FileWatcher::RunPolling()
+	{
+		// The first scan only records the baseline
+		std::unordered_map<std::string, fs::file_time_type> seen;
+		bool baseline = true;
+
+		while (!m_Quit)
+		{
+			for (const fs::path& root : m_Directories)
+			{
+				std::error_code ec;
+				for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+					!ec && it != end; it.increment(ec))
+				{
+					std::error_code fileEc;
+					if (!it->is_regular_file(fileEc))
+						continue;
+					const fs::file_time_type time = it->last_write_time(fileEc);
+					if (fileEc)
+						continue;
+
+					auto [entry, inserted] = seen.try_emplace(it->path().string(), time);
+					if (!inserted && entry->second != time)
+					{
+						entry->second = time;
+						Report(it->path());
+					}
+					else if (inserted && !baseline)
+					{
+						Report(it->path());
+					}
+				}
+			}
+			baseline = false;
+
+			for (auto slept = std::chrono::milliseconds(0); slept < POLL_INTERVAL && !m_Quit; slept += std::chrono::milliseconds(50))
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
+	}
+
+#if defined(NIGHTBLOOM_PLATFORM_WINDOWS)
+	void FileWatcher::Run()
+	{
+		struct Root
+		{
+			fs::path path;
+			HANDLE directory = INVALID_HANDLE_VALUE;
+			HANDLE event = nullptr;
+			OVERLAPPED overlapped{};
+			std::vector<DWORD> buffer = std::vector<DWORD>(16 * 1024);   // DWORD-aligned, as the API requires
+		};
+
+		constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+		auto issue = [](Root& root)
+		{
+			root.overlapped = {};
+			root.overlapped.hEvent = root.event;
+			ResetEvent(root.event);
+			return ReadDirectoryChangesW(root.directory, root.buffer.data(),
+				static_cast<DWORD>(root.buffer.size() * sizeof(DWORD)), TRUE, filter,
+				nullptr, &root.overlapped, nullptr) != 0;
+		};
+
+		// The OVERLAPPEDs must not move while a read is pending
+		std::vector<std::unique_ptr<Root>> roots;
+		std::vector<HANDLE> events;
+		for (const fs::path& path : m_Directories)
+		{
+			if (roots.size() == MAXIMUM_WAIT_OBJECTS)
+			{
+				LOG_WARN("FileWatcher: more than {} directories, '{}' is not watched", MAXIMUM_WAIT_OBJECTS, path.string());
+				continue;
+			}
+
+			auto root = std::make_unique<Root>();
+			root->path = path;
+			root->directory = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+				FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+				OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			root->event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+			if (root->directory == INVALID_HANDLE_VALUE || !root->event || !issue(*root))
+			{
+				LOG_WARN("FileWatcher: can't watch '{}' (error {})", path.string(), GetLastError());
+				if (root->directory != INVALID_HANDLE_VALUE) CloseHandle(root->directory);
+				if (root->event) CloseHandle(root->event);
+				continue;
+			}
+			events.push_back(root->event);
+			roots.push_back(std::move(root));
+		}
+
+		if (roots.empty())
+		{
+			LOG_WARN("FileWatcher: no change notifications, scanning for changes instead");
+			RunPolling();
+			return;
+		}
+
+		while (!m_Quit)
+		{
+			const DWORD wait = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, 100);
+			if (wait >= WAIT_OBJECT_0 + events.size())
+				continue;
+
+			Root& root = *roots[wait - WAIT_OBJECT_0];
+			DWORD bytes = 0;
+			if (GetOverlappedResult(root.directory, &root.overlapped, &bytes, FALSE) && bytes == 0)
+				LOG_WARN("FileWatcher: change buffer overflowed for '{}', some changes were missed", root.path.string());
+
+			const BYTE* cursor = reinterpret_cast<const BYTE*>(root.buffer.data());
+			while (bytes > 0)
+			{
+				const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+				if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+				{
+					const fs::path path = root.path / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+					std::error_code ec;
+					if (!fs::is_directory(path, ec))
+						Report(path);
+				}
+				if (info->NextEntryOffset == 0)
+					break;
+				cursor += info->NextEntryOffset;
+			}
+
+			if (!issue(root))
+				LOG_WARN("FileWatcher: lost the watch on '{}' (error {})", root.path.string(), GetLastError());
+		}
+
+		for (auto& root : roots)
+		{
+			DWORD bytes = 0;
+			CancelIoEx(root->directory, &root->overlapped);
+			GetOverlappedResult(root->directory, &root->overlapped, &bytes, TRUE);
+			CloseHandle(root->directory);
+			CloseHandle(root->event);
+		}
+	}
+
+#elif defined(NIGHTBLOOM_PLATFORM_LINUX)
+	void FileWatcher::Run()
+	{
+		const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0)
+		{
+			LOG_WARN("FileWatcher: inotify unavailable, scanning for changes instead");
+			RunPolling();
+			return;
+		}
+
+		// inotify isn't recursive: one watch per directory of each tree
+		constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+		std::unordered_map<int, fs::path> directories;
+		auto addTree = [&](const fs::path& root, bool reportFiles)
+		{
+			auto add = [&](const fs::path& directory)
+			{
+				const int wd = inotify_add_watch(fd, directory.c_str(), mask);
+				if (wd >= 0)
+					directories[wd] = directory;
+				else
+					LOG_WARN("FileWatcher: can't watch '{}'", directory.string());
+			};
+
+			add(root);
+			std::error_code ec;
+			for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+				!ec && it != end; it.increment(ec))
+			{
+				std::error_code entryEc;
+				if (it->is_directory(entryEc))
+					add(it->path());
+				else if (reportFiles)
+					Report(it->path());
+			}
+		};
+
+		for (const fs::path& root : m_Directories)
+			addTree(root, false);
+
+		alignas(inotify_event) char buffer[16 * 1024];
+		while (!m_Quit)
+		{
+			pollfd descriptor{ fd, POLLIN, 0 };
+			if (poll(&descriptor, 1, 100) <= 0)
+				continue;
+
+			const ssize_t length = read(fd, buffer, sizeof(buffer));
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				if (event->mask & IN_Q_OVERFLOW)
+					LOG_WARN("FileWatcher: change queue overflowed, some changes were missed");
+				if (event->mask & IN_IGNORED)
+				{
+					directories.erase(event->wd);
+					continue;
+				}
+
+				const auto it = directories.find(event->wd);
+				if (it == directories.end() || event->len == 0)
+					continue;
+
+				const fs::path path = it->second / event->name;
+				if (event->mask & IN_ISDIR)
+				{
+					// A directory copied or moved in: watch it, and what it already holds changed
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						addTree(path, true);
+				}
+				else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				{
+					Report(path);
+				}
+			}
+		}
+
+		close(fd);
+	}
+
+#else
+	void FileWatcher::Run()
+	{
+		RunPolling();
+	}
+#endif
+}
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// FileWatcher.hpp
+//
+// Watches directory trees for files written, created or renamed into them,
+// for asset hot reload. A background thread waits on the OS change
+// notifications (ReadDirectoryChangesW on Windows, inotify on Linux; a
+// modification-time scan every POLL_INTERVAL elsewhere or if inotify is
+// unavailable) and records the changed paths. Poll hands them to the caller
+// once they have been quiet for the settle time, so a file an exporter
+// writes in several chunks, or saves twice in a row, comes back once and
+// only after it is complete.
+//
+// Paths come back through NormalizePath (absolute, lexically normal, forward
+// slashes; lower case on Windows), so they compare equal to any other path
+// to the same file that went through it. Removals are not reported.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Debounces change events per path: a path is settled once no event for
+	// it arrived for the settle time
+	class FileChangeCoalescer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		void Add(const std::string& path, Clock::time_point time);
+
+		// Appends the settled paths to `out` (sorted) and forgets them;
+		// returns how many
+		size_t TakeSettled(Clock::time_point now, Clock::duration settle, std::vector<std::string>& out);
+
+		size_t GetPendingCount() const { return m_LastEvent.size(); }
+
+	private:
+		std::unordered_map<std::string, Clock::time_point> m_LastEvent;
+	};
+
+	class FileWatcher
+	{
+	public:
+		static constexpr std::chrono::milliseconds DEFAULT_SETTLE{ 200 };
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 500 };
+
+		static std::string NormalizePath(const std::filesystem::path& path);
+
+		FileWatcher() = default;
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		// Adds a directory tree; false if it isn't a directory. Takes effect
+		// on the next Start.
+		bool Watch(const std::string& directory);
+		const std::vector<std::filesystem::path>& GetDirectories() const { return m_Directories; }
+
+		// Starts the watcher thread; false with nothing to watch. No-op while
+		// running.
+		bool Start();
+		void Stop();
+		bool IsRunning() const { return m_Thread.joinable(); }
+
+		void SetSettleTime(std::chrono::milliseconds settle) { m_Settle = settle; }
+
+		// Any thread; appends files changed and settled since the last Poll
+		// and returns how many
+		size_t Poll(std::vector<std::string>& changed);
+
+	private:
+		void Run();
+		void RunPolling();
+		void Report(const std::filesystem::path& path);
+
+		std::vector<std::filesystem::path> m_Directories;
+		std::chrono::milliseconds m_Settle = DEFAULT_SETTLE;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Quit{ false };
+
+		std::mutex m_Mutex;
+		FileChangeCoalescer m_Coalescer;
+	};
+}
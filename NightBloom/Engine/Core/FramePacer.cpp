@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+// FramePacer.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/FramePacer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+// Windows 10 1803+; older SDKs lack the flag, older systems reject it
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// The oversleep margin never grows past this: a timer that late is
+		// better covered by the spin than trusted
+		constexpr double MAX_OVERSLEEP = 0.004;
+
+		double NowSeconds()
+		{
+			using Clock = std::chrono::steady_clock;
+			return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+		}
+	}
+
+	FramePacer::~FramePacer()
+	{
+#ifdef _WIN32
+		if (m_Timer)
+			CloseHandle(static_cast<HANDLE>(m_Timer));
+#endif
+	}
+
+	void FramePacer::SetSettings(const Settings& settings)
+	{
+		m_Settings = settings;
+		Reset();
+	}
+
+	void FramePacer::SetRefreshRate(float hz)
+	{
+		if (hz == m_RefreshRate)
+			return;
+		m_RefreshRate = hz;
+		if (m_Settings.refreshDivisor != 0)
+			Reset();
+	}
+
+	double FramePacer::GetTargetInterval() const
+	{
+		if (m_Settings.refreshDivisor != 0 && m_RefreshRate > 0.0f)
+			return static_cast<double>(m_Settings.refreshDivisor) / m_RefreshRate;
+		if (m_Settings.targetFps > 0.0f)
+			return 1.0 / m_Settings.targetFps;
+		return 0.0;
+	}
+
+	void FramePacer::Reset()
+	{
+		m_Deadline = 0.0;
+		m_LastWake = 0.0;
+		m_JitterMs = 0.0f;
+		m_WaitMs = 0.0f;
+	}
+
+	double FramePacer::NextDeadline(double now)
+	{
+		const double interval = GetTargetInterval();
+		if (interval <= 0.0)
+		{
+			m_Deadline = 0.0;
+			return now;
+		}
+
+		// Slightly late frames keep the schedule (the next one is shorter);
+		// a whole interval behind, it restarts from now
+		const double next = m_Deadline + interval;
+		m_Deadline = (m_Deadline == 0.0 || now > next + interval) ? now : next;
+		return m_Deadline;
+	}
+
+	void FramePacer::RecordWake(double woke)
+	{
+		const double interval = GetTargetInterval();
+		if (m_LastWake > 0.0 && interval > 0.0)
+		{
+			const float error = static_cast<float>(std::abs((woke - m_LastWake) - interval) * 1000.0);
+			m_JitterMs += (error - m_JitterMs) * 0.1f;
+		}
+		m_LastWake = woke;
+	}
+
+	void FramePacer::Wait()
+	{
+		if (!IsEnabled())
+			return;
+
+		const double start = NowSeconds();
+		const double deadline = NextDeadline(start);
+
+		// Sleep most of the way, leaving the spin margin for the timer's lateness
+		const double sleep = deadline - start - (m_Settings.spinMs / 1000.0 + m_Oversleep);
+		if (sleep > 0.0)
+		{
+			const double overshoot = SleepFor(sleep) - sleep;
+			m_Oversleep += (std::clamp(overshoot, 0.0, MAX_OVERSLEEP) - m_Oversleep) * 0.1;
+		}
+
+		double now = NowSeconds();
+		while (now < deadline)
+		{
+			std::this_thread::yield();
+			now = NowSeconds();
+		}
+
+		m_WaitMs = static_cast<float>((now - start) * 1000.0);
+		RecordWake(now);
+	}
+
+	double FramePacer::SleepFor(double seconds)
+	{
+		const double before = NowSeconds();
+#ifdef _WIN32
+		if (!m_TimerCreated)
+		{
+			m_TimerCreated = true;
+			m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+			if (!m_Timer)
+				m_Timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		}
+
+		LARGE_INTEGER due;
+		due.QuadPart = -static_cast<LONGLONG>(seconds * 1.0e7);  // relative, 100 ns units
+		if (m_Timer && SetWaitableTimer(static_cast<HANDLE>(m_Timer), &due, 0, nullptr, nullptr, FALSE))
+			WaitForSingleObject(static_cast<HANDLE>(m_Timer), INFINITE);
+		else
+			Sleep(static_cast<DWORD>(seconds * 1000.0));
+#elif defined(__linux__)
+		timespec remaining;
+		remaining.tv_sec = static_cast<time_t>(seconds);
+		remaining.tv_nsec = static_cast<long>((seconds - static_cast<double>(remaining.tv_sec)) * 1.0e9);
+		while (clock_nanosleep(CLOCK_MONOTONIC, 0, &remaining, &remaining) == EINTR)
+		{
+		}
+#else
+		std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+#endif
+		return NowSeconds() - before;
+	}
+}
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// FramePacer.hpp
+//
+// Frame limiter for the main loop. Each frame is given an absolute deadline
+// one target interval after the previous one, so waits that end a little
+// late don't accumulate drift; a frame that overruns by more than a whole
+// interval restarts the schedule instead of bursting to catch up.
+//
+// Waiting is a timer sleep followed by a short spin: a high-resolution
+// waitable timer on Win32, clock_nanosleep on Linux. The spin tail starts
+// early enough to absorb the timer's oversleep, which is measured and
+// adapted to, so most of the wait is spent asleep (the point for laptops on
+// battery) and the frame still ends within microseconds of its deadline.
+//
+// Times are seconds on any monotonic clock; the scheduling half is pure so
+// it can be unit tested.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class FramePacer
+	{
+	public:
+		struct Settings
+		{
+			// Frames per second to hold (0 = unlimited)
+			float targetFps = 0.0f;
+			// Non-zero: refresh rate / refreshDivisor instead of targetFps
+			// (1 = every refresh, 2 = every other), once the rate is known
+			uint32_t refreshDivisor = 0;
+			// Minimum spin before each deadline; the measured oversleep of
+			// the timer is added to it
+			float spinMs = 0.5f;
+		};
+
+		FramePacer() = default;
+		~FramePacer();
+
+		void SetSettings(const Settings& settings);
+		const Settings& GetSettings() const { return m_Settings; }
+
+		// Display refresh in Hz (0 = unknown), for refreshDivisor
+		void SetRefreshRate(float hz);
+		float GetRefreshRate() const { return m_RefreshRate; }
+
+		// Seconds each frame is held to, or 0 when unlimited
+		double GetTargetInterval() const;
+		bool IsEnabled() const { return GetTargetInterval() > 0.0; }
+
+		// End of a frame: blocks until the next deadline. No-op when unlimited.
+		void Wait();
+
+		// Advances the schedule for a frame ending at 'now' and returns when
+		// the next one may start (<= now: don't wait)
+		double NextDeadline(double now);
+
+		// A frame started at 'woke'; updates the jitter stats
+		void RecordWake(double woke);
+
+		// Smoothed |actual frame interval - target|, and time spent waiting
+		// per frame, in milliseconds
+		float GetJitterMs() const { return m_JitterMs; }
+		float GetWaitMs() const { return m_WaitMs; }
+		// Current spin margin (spinMs plus the learned timer oversleep)
+		float GetSpinMarginMs() const { return static_cast<float>((m_Settings.spinMs / 1000.0 + m_Oversleep) * 1000.0); }
+
+		// Restarts the schedule (after a pause, a minimized window, a setting change)
+		void Reset();
+
+	private:
+		// Timer sleep for about 'seconds'; returns the seconds actually slept
+		double SleepFor(double seconds);
+
+		Settings m_Settings;
+		float m_RefreshRate = 0.0f;
+
+		double m_Deadline = 0.0;       // 0 = no schedule yet
+		double m_LastWake = 0.0;
+		double m_Oversleep = 0.0;      // learned timer lateness, seconds
+		float m_JitterMs = 0.0f;
+		float m_WaitMs = 0.0f;
+
+		void* m_Timer = nullptr;       // Win32 waitable timer, created on first use
+		bool m_TimerCreated = false;
+
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+	};
+}
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+// FramePipeline.hpp
+//
+// The simulation / render handoff behind Application::SetFramePipelining.
+// Each frame the main thread calls Begin(): it takes the snapshot the last
+// simulation job published (none on the first frame), then starts the next
+// simulation on a job that fills another slot of the TripleBuffer and
+// publishes it. The main thread renders the snapshot it got meanwhile and
+// calls Wait() before touching anything the simulation may (OnFrameEnd,
+// main-thread tasks, the next frame's input).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/TripleBuffer.hpp"
+#include <cstdint>
+#include <utility>
+
+namespace Nightbloom
+{
+	template <typename T>
+	class FramePipeline
+	{
+	public:
+		explicit FramePipeline(JobSystem& jobs = JobSystem::Get()) : m_Jobs(jobs) {}
+		~FramePipeline() { Wait(); }
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline& operator=(const FramePipeline&) = delete;
+
+		// Starts simulate(T& next, uint64_t frameNumber) on a job and returns
+		// the snapshot to render this frame, or null before the first one.
+		// The previous simulation must be done (Wait).
+		template <typename Simulate>
+		const T* Begin(Simulate&& simulate)
+		{
+			const bool haveSnapshot = m_Snapshots.AcquireLatest();
+
+			T& next = m_Snapshots.GetWriteSlot();
+			const uint64_t frameNumber = ++m_SimulatedFrames;
+			m_Jobs.Run([this, &next, frameNumber, simulate = std::forward<Simulate>(simulate)]() mutable
+				{
+					simulate(next, frameNumber);
+					m_Snapshots.Publish();
+				}, &m_Done);
+
+			return haveSnapshot ? &m_Snapshots.GetReadSlot() : nullptr;
+		}
+
+		// Until the job Begin started has published
+		void Wait() { m_Jobs.Wait(m_Done); }
+		bool IsSimulating() const { return !m_Done.IsDone(); }
+
+		// Begin calls so far; the last simulation's frameNumber
+		uint64_t GetSimulatedFrames() const { return m_SimulatedFrames; }
+
+	private:
+		JobSystem& m_Jobs;
+		TripleBuffer<T> m_Snapshots;
+		JobCounter m_Done;
+		uint64_t m_SimulatedFrames = 0;
+	};
+}
@@ -0,0 +1,43 @@
+//------------------------------------------------------------------------------
+// IdleThrottle.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/IdleThrottle.hpp"
+
+namespace Nightbloom
+{
+	bool IdleThrottle::ShouldRunFrame(double now, bool animating)
+	{
+		if (!m_Settings.enabled || now - m_LastActivity < m_Settings.graceSeconds)
+			m_State = State::Interactive;
+		else
+			m_State = animating ? State::Animating : State::Idle;
+
+		float fps = 0.0f;
+		if (m_State == State::Animating)
+			fps = m_Settings.animatedFps;
+		else if (m_State == State::Idle)
+			fps = m_Settings.idleFps;
+
+		if (fps > 0.0f && now - m_LastFrame < 1.0 / fps)
+		{
+			++m_Skipped;
+			return false;
+		}
+
+		m_LastFrame = now;
+		m_Skipped = 0;
+		return true;
+	}
+
+	const char* GetIdleThrottleStateName(IdleThrottle::State state)
+	{
+		switch (state)
+		{
+		case IdleThrottle::State::Interactive: return "Interactive";
+		case IdleThrottle::State::Animating:   return "Animating";
+		case IdleThrottle::State::Idle:        return "Idle";
+		}
+		return "Unknown";
+	}
+}
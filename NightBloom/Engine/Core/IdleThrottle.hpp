@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+// IdleThrottle.hpp
+//
+// Decides, once per main-loop iteration, whether a tool (the editor) should
+// run a full frame or skip it. Three states:
+//
+//   Interactive  input, an edit or a moving camera within the last
+//                graceSeconds (temporal effects get to settle too): every
+//                iteration renders
+//   Animating    nothing touched, but something on screen moves by itself
+//                (fireflies, clouds, wind): capped at animatedFps
+//   Idle         nothing changes: idleFps, enough to pick up finished
+//                background loads and shader reloads
+//
+// Times are seconds on any monotonic clock.
+//------------------------------------------------------------------------------
+#pragma once
+
+namespace Nightbloom
+{
+	class IdleThrottle
+	{
+	public:
+		enum class State
+		{
+			Interactive,
+			Animating,
+			Idle
+		};
+
+		struct Settings
+		{
+			bool enabled = true;
+			float graceSeconds = 0.5f;
+			float animatedFps = 30.0f;
+			float idleFps = 4.0f;
+		};
+
+		void SetSettings(const Settings& settings) { m_Settings = settings; }
+		const Settings& GetSettings() const { return m_Settings; }
+		Settings& GetSettings() { return m_Settings; }
+
+		// Something the user did, or a change on screen that isn't an
+		// animation (camera still gliding, an edit applied)
+		void NotifyActivity(double now) { m_LastActivity = now; }
+
+		// True when this iteration should run a frame; `animating` is whether
+		// anything on screen moves by itself
+		bool ShouldRunFrame(double now, bool animating);
+
+		State GetState() const { return m_State; }
+		// Frames skipped since the last one that ran
+		unsigned GetSkippedFrames() const { return m_Skipped; }
+
+	private:
+		Settings m_Settings;
+		State m_State = State::Interactive;
+		double m_LastActivity = 0.0;
+		double m_LastFrame = -1.0e9;
+		unsigned m_Skipped = 0;
+	};
+
+	const char* GetIdleThrottleStateName(IdleThrottle::State state);
+}
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------
+// JobSystem.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/JobSystem.hpp"
+#include "Core/Logger/Logger.hpp"
+#include "Core/CpuProfiler.hpp"
+#include "Core/ThreadPlacement.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Which system's queue the current thread owns (workers only)
+		thread_local const JobSystem* t_Owner = nullptr;
+		thread_local uint32_t t_QueueIndex = 0;
+	}
+
+	JobSystem& JobSystem::Get()
+	{
+		static JobSystem instance;
+		return instance;
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	void JobSystem::Initialize(uint32_t workerCount)
+	{
+		if (IsRunning())
+			return;
+
+		if (workerCount == 0)
+			workerCount = ThreadPlacement::GetDefaultWorkerCount();
+
+		m_Quit = false;
+		m_Queues.clear();
+		for (uint32_t i = 0; i < workerCount + 1; ++i)
+			m_Queues.push_back(std::make_unique<WorkerQueue>());
+
+		for (uint32_t i = 0; i < workerCount; ++i)
+			m_Workers.emplace_back([this, queueIndex = i + 1]() { WorkerLoop(queueIndex); });
+
+		LOG_INFO("JobSystem initialized ({} workers)", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Quit = true;
+		}
+		m_WakeCv.notify_all();
+
+		// Workers drain the queues before they exit
+		for (std::thread& worker : m_Workers)
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+		m_Workers.clear();
+		m_Queues.clear();
+
+		LOG_INFO("JobSystem shut down");
+	}
+
+	void JobSystem::Run(Job job, JobCounter* counter)
+	{
+		if (counter)
+			counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+		Entry entry{ std::move(job), counter };
+		if (!IsRunning())
+		{
+			Execute(entry);
+			return;
+		}
+		Push(std::move(entry));
+	}
+
+	void JobSystem::RunAfter(JobCounter& dependency, Job job, JobCounter* counter)
+	{
+		if (counter)
+			counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+		{
+			// Finish() drains the continuations under this lock, so the job
+			// is either parked before that or sees the dependency done
+			std::lock_guard<std::mutex> lock(dependency.m_ContinuationMutex);
+			if (!dependency.IsDone())
+			{
+				dependency.m_Continuations.emplace_back(std::move(job), counter);
+				return;
+			}
+		}
+
+		Entry entry{ std::move(job), counter };
+		if (!IsRunning())
+			Execute(entry);
+		else
+			Push(std::move(entry));
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!TryRunOne())
+				std::this_thread::yield();
+		}
+
+		// The last Finish() may still be releasing the counter's lock; let it
+		// go before the caller is free to destroy the counter
+		std::lock_guard<std::mutex> lock(counter.m_ContinuationMutex);
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& fn)
+	{
+		if (count == 0)
+			return;
+
+		grain = std::max(grain, 1u);
+		const uint32_t chunkCount = (count + grain - 1) / grain;
+		if (!IsRunning() || chunkCount == 1)
+		{
+			fn(0, count);
+			return;
+		}
+
+		JobCounter done;
+		for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			const uint32_t begin = chunk * grain;
+			const uint32_t end = std::min(begin + grain, count);
+			Run([&fn, begin, end]() { fn(begin, end); }, &done);
+		}
+		Wait(done);
+	}
+
+	// =========================================================================
+	// Private helpers
+	// =========================================================================
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex)
+	{
+		t_Owner = this;
+		t_QueueIndex = queueIndex;
+		NB_PROFILE_THREAD("Job Worker " + std::to_string(queueIndex));
+		ThreadPlacement::Apply(ThreadRole::Worker);
+
+		for (;;)
+		{
+			if (TryRunOne())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_WakeCv.wait(lock, [this]() { return m_Quit || m_QueuedCount.load(std::memory_order_acquire) > 0; });
+			if (m_Quit && m_QueuedCount.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+
+	void JobSystem::Push(Entry entry)
+	{
+		WorkerQueue& queue = *m_Queues[CurrentQueueIndex()];
+		{
+			// Counted under the queue lock, like the pops, so the count never
+			// runs ahead of or behind what the queues actually hold
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.entries.push_back(std::move(entry));
+			m_QueuedCount.fetch_add(1, std::memory_order_release);
+		}
+
+		// Taking the sleep lock orders this against a worker that is just
+		// about to wait, so the wake-up can't be lost
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+		}
+		m_WakeCv.notify_one();
+	}
+
+	bool JobSystem::TryPop(uint32_t queueIndex, Entry& out)
+	{
+		WorkerQueue& queue = *m_Queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.entries.empty())
+			return false;
+
+		out = std::move(queue.entries.back());
+		queue.entries.pop_back();
+		m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool JobSystem::TrySteal(uint32_t thiefIndex, Entry& out)
+	{
+		const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+		for (uint32_t offset = 1; offset < queueCount; ++offset)
+		{
+			WorkerQueue& queue = *m_Queues[(thiefIndex + offset) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.entries.empty())
+				continue;
+
+			out = std::move(queue.entries.front());
+			queue.entries.pop_front();
+			m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	bool JobSystem::TryRunOne()
+	{
+		if (m_Queues.empty())
+			return false;
+
+		const uint32_t queueIndex = CurrentQueueIndex();
+		Entry entry;
+		if (!TryPop(queueIndex, entry) && !TrySteal(queueIndex, entry))
+			return false;
+
+		Execute(entry);
+		return true;
+	}
+
+	void JobSystem::Execute(Entry& entry)
+	{
+		if (entry.job)
+		{
+			NB_PROFILE_SCOPE("Job");
+			entry.job();
+		}
+		Finish(entry.counter);
+	}
+
+	void JobSystem::Finish(JobCounter* counter)
+	{
+		if (!counter)
+			return;
+
+		std::vector<std::pair<Job, JobCounter*>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_ContinuationMutex);
+			if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+			continuations.swap(counter->m_Continuations);
+		}
+
+		// `counter` may be gone from here on - a waiter has been released
+		for (auto& [job, continuationCounter] : continuations)
+		{
+			Entry entry{ std::move(job), continuationCounter };
+			if (!IsRunning())
+				Execute(entry);
+			else
+				Push(std::move(entry));
+		}
+	}
+
+	uint32_t JobSystem::CurrentQueueIndex() const
+	{
+		return (t_Owner == this) ? t_QueueIndex : 0;
+	}
+}
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+// JobSystem.hpp
+//
+// Engine-wide work-stealing job scheduler. One deque per worker thread plus
+// one shared by every thread that is not a worker (the main thread included):
+// a thread pushes and pops its own deque at the back (LIFO, cache-warm) and
+// steals from the front of the others (FIFO, oldest and usually largest work
+// first) when it runs dry.
+//
+// Completion is tracked with JobCounters: Run() bumps the counter and the job
+// drops it when it finishes. Wait() never blocks idle — the waiting thread
+// executes queued jobs until its counter reaches zero, which gives nested
+// waits inside jobs the same forward progress fibers would, without fiber
+// stacks or switching. RunAfter() expresses dependencies: the job is queued
+// only once another counter has drained.
+//
+// Until Initialize() is called (EngineInit does) every Run() executes
+// inline, so callers need no "is it running" checks.
+//
+// Usage:
+//   JobCounter done;
+//   JobSystem::Get().Run([]{ DecodeTexture(); }, &done);
+//   JobSystem::Get().ParallelFor(count, 64, [&](uint32_t begin, uint32_t end) { ... });
+//   JobSystem::Get().Wait(done);
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	using Job = std::function<void()>;
+
+	// Number of outstanding jobs; zero means done. Must outlive the jobs
+	// (and RunAfter continuations) that reference it.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+		uint32_t GetPending() const { return m_Pending.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> m_Pending{ 0 };
+		mutable std::mutex m_ContinuationMutex;
+		std::vector<std::pair<Job, JobCounter*>> m_Continuations;
+	};
+
+	class JobSystem
+	{
+	public:
+		static JobSystem& Get();
+
+		JobSystem() = default;
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// Starts workerCount threads (0 = one per processor the Worker placement
+		// allows, minus the calling thread; ThreadPlacement.hpp). Calling it
+		// again while running is a no-op.
+		void Initialize(uint32_t workerCount = 0);
+
+		// Finishes every queued job, then joins the workers
+		void Shutdown();
+
+		bool IsRunning() const { return !m_Workers.empty(); }
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+		// Threads that execute jobs: the workers plus a waiting caller
+		uint32_t GetConcurrency() const { return GetWorkerCount() + 1; }
+
+		// Queues `job`; `counter` (optional) counts it until it has run
+		void Run(Job job, JobCounter* counter = nullptr);
+
+		// Queues `job` once `dependency` is done (immediately if it already is)
+		void RunAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+		// Runs queued jobs on this thread until `counter` is done
+		void Wait(const JobCounter& counter);
+
+		// Calls fn(begin, end) over [0, count) in chunks of at most `grain`
+		// items, spread across all threads, and returns when every chunk has
+		// finished. The caller runs chunks too.
+		void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& fn);
+
+	private:
+		struct Entry
+		{
+			Job job;
+			JobCounter* counter = nullptr;
+		};
+
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque<Entry> entries;
+		};
+
+		void WorkerLoop(uint32_t queueIndex);
+		void Push(Entry entry);
+		bool TryPop(uint32_t queueIndex, Entry& out);
+		bool TrySteal(uint32_t thiefIndex, Entry& out);
+		bool TryRunOne();
+		void Execute(Entry& entry);
+		void Finish(JobCounter* counter);
+		uint32_t CurrentQueueIndex() const;
+
+		// Queue 0 is shared by non-worker threads; worker i owns queue i + 1
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+
+		std::atomic<uint32_t> m_QueuedCount{ 0 };
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeCv;
+		bool m_Quit = false;
+	};
+}
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+// LinearAllocator.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/LinearAllocator.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	LinearAllocator::LinearAllocator(size_t blockSize, std::pmr::memory_resource* upstream)
+		: m_Upstream(upstream)
+		, m_BlockSize(blockSize)
+	{
+	}
+
+	LinearAllocator::~LinearAllocator()
+	{
+		ReleaseBlocks();
+	}
+
+	void* LinearAllocator::Allocate(size_t size, size_t alignment)
+	{
+		if (m_Blocks.empty())
+		{
+			AddBlock(size + alignment);
+		}
+
+		Block* block = &m_Blocks.back();
+		size_t aligned = (block->offset + alignment - 1) & ~(alignment - 1);
+		if (aligned + size > block->size)
+		{
+			AddBlock(size + alignment);
+			block = &m_Blocks.back();
+			aligned = 0;
+		}
+
+		block->offset = aligned + size;
+		m_Used += size;
+		m_PeakUsed = std::max(m_PeakUsed, m_Used);
+		return block->data + aligned;
+	}
+
+	void LinearAllocator::Reset()
+	{
+		// Overflowed last frame: replace the chain with one block sized for the
+		// peak so the next frame fits without chaining.
+		if (m_Blocks.size() > 1)
+		{
+			size_t total = 0;
+			for (const auto& block : m_Blocks)
+				total += block.size;
+
+			ReleaseBlocks();
+			AddBlock(std::max(total, m_PeakUsed));
+		}
+
+		for (auto& block : m_Blocks)
+			block.offset = 0;
+
+		m_Used = 0;
+	}
+
+	size_t LinearAllocator::GetCapacity() const
+	{
+		size_t total = 0;
+		for (const auto& block : m_Blocks)
+			total += block.size;
+		return total;
+	}
+
+	void LinearAllocator::AddBlock(size_t minSize)
+	{
+		Block block;
+		block.size = std::max(m_BlockSize, minSize);
+		block.data = static_cast<std::byte*>(m_Upstream->allocate(block.size, alignof(std::max_align_t)));
+		m_Blocks.push_back(block);
+	}
+
+	void LinearAllocator::ReleaseBlocks()
+	{
+		for (const Block& block : m_Blocks)
+			m_Upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+		m_Blocks.clear();
+	}
+}
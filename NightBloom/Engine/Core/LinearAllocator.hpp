@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+// LinearAllocator.hpp
+//
+// Bump allocator for per-frame data, plus an std-compatible allocator adapter
+// so containers can draw from it. Its blocks come from a std::pmr resource,
+// so an arena can be counted against a CpuMemory category.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Hands out memory by bumping an offset; nothing is freed individually. Reset()
+	// releases everything at once. If a frame overflows the current block another
+	// is chained on, and on Reset the blocks are merged into one big enough for
+	// the whole frame, so steady state is a single block and no heap traffic.
+	// Not thread-safe.
+	class LinearAllocator
+	{
+	public:
+		explicit LinearAllocator(size_t blockSize = 256 * 1024,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+		~LinearAllocator();
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+		void Reset();
+
+		size_t GetUsed() const { return m_Used; }
+		size_t GetCapacity() const;
+
+	private:
+		struct Block
+		{
+			std::byte* data = nullptr;
+			size_t size = 0;
+			size_t offset = 0;
+		};
+
+		void AddBlock(size_t minSize);
+		void ReleaseBlocks();
+
+		std::pmr::memory_resource* m_Upstream = nullptr;
+		std::vector<Block> m_Blocks;
+		size_t m_BlockSize = 0;
+		size_t m_Used = 0;
+		size_t m_PeakUsed = 0;
+
+		LinearAllocator(const LinearAllocator&) = delete;
+		LinearAllocator& operator=(const LinearAllocator&) = delete;
+	};
+
+	// Allocator adapter. With a null arena it falls back to the global heap, so a
+	// container type can be used both arena-backed (per-frame) and standalone.
+	// deallocate() is a no-op for arena memory - it goes away on Reset().
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		ArenaAllocator() = default;
+		explicit ArenaAllocator(LinearAllocator* arena) : m_Arena(arena) {}
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : m_Arena(other.GetArena()) {}
+
+		T* allocate(size_t count)
+		{
+			if (m_Arena)
+				return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T)));
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, size_t count)
+		{
+			(void)count;
+			if (!m_Arena)
+				::operator delete(ptr);
+		}
+
+		LinearAllocator* GetArena() const { return m_Arena; }
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return m_Arena == other.GetArena(); }
+
+	private:
+		LinearAllocator* m_Arena = nullptr;
+	};
+}
@@ -35,8 +35,15 @@ namespace Nightbloom
 		if (!m_File.is_open())
 			return;
 
-		// Get timestamp
-		m_File << message << std::endl;
-		m_File.flush();
+		// Buffered; the logger flushes after each line (sync) or batch (async)
+		m_File << message << '\n';
+	}
+
+	void FileLogger::Flush()
+	{
+		std::lock_guard<std::mutex> lock(m_FileMutex);
+
+		if (m_File.is_open())
+			m_File.flush();
 	}
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ namespace Nightbloom
 
 		// ILogSink interface implementation
 		virtual void Write(LogLevel level, const std::string& message) override;
+		virtual void Flush() override;
 
 		bool IsOpen() const { return m_File.is_open(); }
 
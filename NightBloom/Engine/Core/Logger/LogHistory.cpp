@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+// LogHistory.cpp
+//
+// Bounded, interned log history with an incrementally kept filter index
+//------------------------------------------------------------------------------
+
+#include "Core/Logger/LogHistory.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		std::string ToLower(const std::string& text)
+		{
+			std::string lower = text;
+			std::transform(lower.begin(), lower.end(), lower.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return lower;
+		}
+
+		// lowerNeedle is already lower case
+		bool ContainsNoCase(const std::string& haystack, const std::string& lowerNeedle)
+		{
+			const auto it = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+				[](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+			return it != haystack.end();
+		}
+	}
+
+	LogHistory::LogHistory(size_t capacity)
+		: m_Entries(std::max<size_t>(capacity, 1))
+	{
+	}
+
+	void LogHistory::Append(const LogRecord& record)
+	{
+		if (GetCount() == m_Entries.size())
+		{
+			const LogEntry& oldest = At(m_First);
+			if (!m_Filtered.empty() && m_Filtered.front() == m_First)
+				m_Filtered.pop_front();
+			Release(oldest.message);
+			++m_First;
+		}
+
+		LogEntry& entry = m_Entries[m_Next % m_Entries.size()];
+		entry.level = record.level;
+		entry.thread = record.thread;
+		entry.time = record.time;
+		entry.message = Intern(record.message);
+
+		if (Passes(entry))
+			m_Filtered.push_back(m_Next);
+		++m_Next;
+	}
+
+	void LogHistory::Clear()
+	{
+		m_First = m_Next;
+		m_Cleared = m_Next;
+		m_Filtered.clear();
+		m_StringIds.clear();
+		m_Strings.clear();
+		m_FreeStrings.clear();
+	}
+
+	void LogHistory::SetFilter(const LogFilter& filter)
+	{
+		if (filter == m_Filter)
+			return;
+
+		m_Filter = filter;
+		m_FilterLower = ToLower(filter.text);
+		++m_FilterGeneration;
+
+		m_Filtered.clear();
+		for (uint64_t sequence = m_First; sequence < m_Next; ++sequence)
+		{
+			if (Passes(At(sequence)))
+				m_Filtered.push_back(sequence);
+		}
+	}
+
+	uint32_t LogHistory::Intern(const std::string& text)
+	{
+		const auto [it, inserted] = m_StringIds.try_emplace(text, 0u);
+		if (!inserted)
+		{
+			++m_Strings[it->second].references;
+			return it->second;
+		}
+
+		uint32_t id;
+		if (!m_FreeStrings.empty())
+		{
+			id = m_FreeStrings.back();
+			m_FreeStrings.pop_back();
+		}
+		else
+		{
+			id = static_cast<uint32_t>(m_Strings.size());
+			m_Strings.emplace_back();
+		}
+
+		it->second = id;
+		m_Strings[id] = InternedString{ &it->first, 1, 0, false };
+		return id;
+	}
+
+	void LogHistory::Release(uint32_t id)
+	{
+		InternedString& interned = m_Strings[id];
+		if (--interned.references > 0)
+			return;
+
+		m_StringIds.erase(m_StringIds.find(*interned.text));
+		interned = InternedString{};
+		m_FreeStrings.push_back(id);
+	}
+
+	bool LogHistory::Passes(const LogEntry& entry)
+	{
+		if ((m_Filter.levelMask & LogFilter::LevelBit(entry.level)) == 0)
+			return false;
+		if (m_FilterLower.empty())
+			return true;
+
+		InternedString& interned = m_Strings[entry.message];
+		if (interned.matchGeneration != m_FilterGeneration)
+		{
+			interned.matches = ContainsNoCase(*interned.text, m_FilterLower);
+			interned.matchGeneration = m_FilterGeneration;
+		}
+		return interned.matches;
+	}
+}
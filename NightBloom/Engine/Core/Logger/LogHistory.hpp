@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+// LogHistory.hpp
+//
+// The log records a viewer keeps (the editor console): a fixed-capacity ring
+// that drops its oldest entries when full, so a long session costs a bounded
+// amount of memory. Messages are interned - a line logged every frame is
+// stored once, however many entries point at it - and released with the last
+// entry that uses them.
+//
+// The entries passing a LogFilter are kept in an index that grows with each
+// Append and shrinks with each eviction; only a filter change rebuilds it.
+// A text match is computed once per distinct message and filter, not per
+// entry. Owned by one thread (the UI); LogRingSink hands records over.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "LogQueue.hpp"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct LogEntry
+	{
+		LogLevel level = LogLevel::Info;
+		uint32_t thread = 0;
+		uint32_t message = 0;   // LogHistory::GetText
+		std::chrono::system_clock::time_point time;
+	};
+
+	struct LogFilter
+	{
+		uint32_t levelMask = ~0u;   // bit per LogLevel (LevelBit)
+		std::string text;           // case-insensitive substring of the message; empty passes all
+
+		static uint32_t LevelBit(LogLevel level) { return 1u << static_cast<uint32_t>(level); }
+		bool operator==(const LogFilter& other) const = default;
+	};
+
+	class LogHistory
+	{
+	public:
+		explicit LogHistory(size_t capacity);
+
+		LogHistory(const LogHistory&) = delete;
+		LogHistory& operator=(const LogHistory&) = delete;
+
+		// Drops the oldest entry when full
+		void Append(const LogRecord& record);
+		void Clear();
+
+		// Rebuilds the index when the filter changed
+		void SetFilter(const LogFilter& filter);
+		const LogFilter& GetFilter() const { return m_Filter; }
+
+		size_t GetCapacity() const { return m_Entries.size(); }
+		size_t GetCount() const { return static_cast<size_t>(m_Next - m_First); }
+		// Entries appended since construction or Clear, evicted ones included
+		uint64_t GetAppendedCount() const { return m_Next - m_Cleared; }
+
+		// The entries passing the filter, oldest first
+		size_t GetFilteredCount() const { return m_Filtered.size(); }
+		const LogEntry& GetFiltered(size_t index) const { return At(m_Filtered[index]); }
+
+		const std::string& GetText(uint32_t id) const { return *m_Strings[id].text; }
+		// Distinct messages held
+		size_t GetInternedCount() const { return m_StringIds.size(); }
+
+	private:
+		struct InternedString
+		{
+			const std::string* text = nullptr;   // the key in m_StringIds
+			uint32_t references = 0;
+			uint32_t matchGeneration = 0;        // m_FilterGeneration the match was computed for
+			bool matches = false;
+		};
+
+		const LogEntry& At(uint64_t sequence) const { return m_Entries[sequence % m_Entries.size()]; }
+		uint32_t Intern(const std::string& text);
+		void Release(uint32_t id);
+		bool Passes(const LogEntry& entry);
+
+		std::vector<LogEntry> m_Entries;
+		uint64_t m_First = 0;     // sequence of the oldest entry held
+		uint64_t m_Next = 0;      // sequence the next Append gets
+		uint64_t m_Cleared = 0;   // m_Next at the last Clear
+
+		std::unordered_map<std::string, uint32_t> m_StringIds;
+		std::vector<InternedString> m_Strings;
+		std::vector<uint32_t> m_FreeStrings;
+
+		LogFilter m_Filter;
+		std::string m_FilterLower;
+		uint32_t m_FilterGeneration = 1;
+		std::deque<uint64_t> m_Filtered;   // sequences, ascending
+	};
+}
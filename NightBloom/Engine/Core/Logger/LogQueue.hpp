@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// LogQueue.hpp
+//
+// Bounded lock-free multi-producer / single-consumer queue of log records,
+// the hand-off between threads that log and the logger's writer thread.
+// A ring of cells, each with a sequence number saying whose turn it is:
+// producers claim a position with one CAS on the head and publish the cell
+// by bumping its sequence, the consumer pops cells in position order.
+// Neither side takes a lock; a full queue makes TryPush fail rather than
+// wait.
+//
+// Positions count up from 0 for the queue's lifetime and records pop in
+// position order, so a producer knows its record is gone once the consumer
+// has popped position + 1 records.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Nightbloom
+{
+	// One message as logged, the line around it formatted by the writer
+	struct LogRecord
+	{
+		LogLevel level = LogLevel::Info;
+		std::chrono::system_clock::time_point time;
+		uint32_t thread = 0;   // Logger::CurrentThreadIndex of the thread that logged it
+		std::string message;
+	};
+
+	class LogQueue
+	{
+	public:
+		// `capacity` is rounded up to a power of two
+		explicit LogQueue(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+
+			m_Capacity = size;
+			m_Mask = size - 1;
+			m_Cells = std::make_unique<Cell[]>(size);
+			for (size_t i = 0; i < size; ++i)
+			{
+				m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		LogQueue(const LogQueue&) = delete;
+		LogQueue& operator=(const LogQueue&) = delete;
+
+		// Any thread. False (record untouched) when the queue is full; else
+		// `position` is the record's place in the queue.
+		bool TryPush(LogRecord& record, uint64_t& position)
+		{
+			uint64_t pos = m_Head.load(std::memory_order_relaxed);
+			Cell* cell = nullptr;
+			for (;;)
+			{
+				cell = &m_Cells[pos & m_Mask];
+				const uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+				if (diff == 0)
+				{
+					if (m_Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+				{
+					return false;   // the consumer hasn't freed this cell yet
+				}
+				else
+				{
+					pos = m_Head.load(std::memory_order_relaxed);
+				}
+			}
+
+			cell->record = std::move(record);
+			cell->sequence.store(pos + 1, std::memory_order_release);
+			position = pos;
+			return true;
+		}
+
+		// Consumer thread only. False when the next record isn't published yet.
+		bool TryPop(LogRecord& record)
+		{
+			Cell& cell = m_Cells[m_Tail & m_Mask];
+			if (cell.sequence.load(std::memory_order_acquire) != m_Tail + 1)
+				return false;
+
+			record = std::move(cell.record);
+			cell.sequence.store(m_Tail + m_Capacity, std::memory_order_release);
+			++m_Tail;
+			return true;
+		}
+
+		// Positions claimed so far (published or about to be)
+		uint64_t GetPushCount() const { return m_Head.load(std::memory_order_acquire); }
+		// Consumer thread only: records popped so far
+		uint64_t GetPopCount() const { return m_Tail; }
+		size_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		struct Cell
+		{
+			std::atomic<uint64_t> sequence{ 0 };
+			LogRecord record;
+		};
+
+		std::unique_ptr<Cell[]> m_Cells;
+		size_t m_Capacity = 0;
+		uint64_t m_Mask = 0;
+
+		// Producers and the consumer on separate cache lines
+		alignas(64) std::atomic<uint64_t> m_Head{ 0 };
+		alignas(64) uint64_t m_Tail = 0;
+	};
+}
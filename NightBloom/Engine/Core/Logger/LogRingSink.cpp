@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------
+// LogRingSink.cpp
+//
+// Lock-free hand-off of log records to an in-process viewer
+//------------------------------------------------------------------------------
+
+#include "Core/Logger/LogRingSink.hpp"
+#include "Core/Logger/LogHistory.hpp"
+
+namespace Nightbloom
+{
+	LogRingSink::LogRingSink(size_t capacity)
+		: m_Queue(capacity)
+	{
+	}
+
+	void LogRingSink::Write(LogLevel level, const std::string& message)
+	{
+		LogRecord record;
+		record.level = level;
+		record.time = std::chrono::system_clock::now();
+		record.thread = Logger::CurrentThreadIndex();
+		record.message = message;
+		Push(record);
+	}
+
+	void LogRingSink::WriteRecord(const LogRecord& record, const std::string& /*line*/)
+	{
+		// The viewer lays out the fields itself
+		LogRecord copy = record;
+		Push(copy);
+	}
+
+	void LogRingSink::Push(LogRecord& record)
+	{
+		uint64_t position = 0;
+		if (!m_Queue.TryPush(record, position))
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	size_t LogRingSink::Drain(LogHistory& history, size_t maxRecords)
+	{
+		size_t drained = 0;
+		LogRecord record;
+		while (drained < maxRecords && m_Queue.TryPop(record))
+		{
+			history.Append(record);
+			++drained;
+		}
+		return drained;
+	}
+}
@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+// LogRingSink.hpp
+//
+// Log sink for in-process viewers (the editor console). Writes push the
+// record - level, time, thread and message - into a fixed-capacity lock-free
+// ring (a LogQueue) and return; a viewer thread drains it into its
+// LogHistory once a frame. A ring the viewer hasn't drained in time drops
+// new records rather than make the logging thread wait, and counts them.
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "Logger.hpp"
+#include "LogQueue.hpp"
+
+namespace Nightbloom
+{
+	class LogHistory;
+
+	class LogRingSink : public ILogSink
+	{
+	public:
+		explicit LogRingSink(size_t capacity = 16384);
+
+		// ILogSink interface implementation
+		virtual void Write(LogLevel level, const std::string& message) override;
+		virtual void WriteRecord(const LogRecord& record, const std::string& line) override;
+
+		// One viewer thread: moves what was written since into history
+		// (up to maxRecords); returns how many
+		size_t Drain(LogHistory& history, size_t maxRecords = SIZE_MAX);
+
+		uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+	private:
+		void Push(LogRecord& record);
+
+		LogQueue m_Queue;
+		std::atomic<uint64_t> m_Dropped{ 0 };
+	};
+}
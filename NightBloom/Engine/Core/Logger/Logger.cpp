@@ -6,12 +6,38 @@
 //------------------------------------------------------------------------------
 
 #include "Core/Logger/Logger.hpp"
+#include "Core/Logger/LogQueue.hpp"
+#include "Core/ThreadPlacement.hpp"
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <sstream>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		// Records the writer takes per pass: one sink lock and one flush each
+		constexpr size_t WRITER_BATCH = 256;
+		// How long an idle writer sleeps; lines below Error wake nobody
+		constexpr auto WRITER_IDLE_WAIT = std::chrono::milliseconds(20);
+
+		std::terminate_handler g_PreviousTerminate = nullptr;
+
+		std::atomic<uint32_t> g_NextThreadIndex{ 0 };
+
+		// Whatever was queued before the crash reaches the sinks first
+		// (synchronous logging has already written it)
+		void FlushOnTerminate()
+		{
+			if (Logger::Get().IsAsync())
+				Logger::Get().Flush();
+			if (g_PreviousTerminate)
+				g_PreviousTerminate();
+			std::abort();
+		}
+	}
+
 	Logger& Logger::Get()
 	{
 		static Logger instance;
@@ -25,10 +51,14 @@ namespace Nightbloom
 		// m_MinLogLevel = LogLevel::Trace
 	}
 
+	Logger::~Logger()
+	{
+		DisableAsync();
+	}
+
 	void Logger::SetLogLevel(LogLevel level)
 	{
-		std::lock_guard<std::mutex> lock(m_Mutex);
-		m_MinLogLevel = level;
+		s_MinLogLevel.store(level, std::memory_order_relaxed);
 	}
 
 	void Logger::AddSink(std::shared_ptr<ILogSink> sink)
@@ -43,21 +73,136 @@ namespace Nightbloom
 		m_Sinks.clear();
 	}
 
-	void Logger::Log(LogLevel level, const std::string& message)
+	void Logger::EnableAsync(size_t queueCapacity)
+	{
+		if (IsAsync())
+			return;
+
+		if (!m_Queue)
+		{
+			m_Queue = std::make_unique<LogQueue>(queueCapacity);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_StopWriter = false;
+			m_WriterRunning = true;
+		}
+		m_Writer = std::thread(&Logger::WriterLoop, this);
+		m_AsyncEnabled.store(true, std::memory_order_release);
+
+		static bool terminateHooked = false;
+		if (!terminateHooked)
+		{
+			g_PreviousTerminate = std::set_terminate(&FlushOnTerminate);
+			terminateHooked = true;
+		}
+	}
+
+	void Logger::DisableAsync()
+	{
+		if (!IsAsync())
+			return;
+
+		m_AsyncEnabled.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_StopWriter = true;
+		}
+		m_WakeCv.notify_one();
+		if (m_Writer.joinable())
+		{
+			m_Writer.join();
+		}
+
+		// Pushed while the writer was stopping; this thread is the consumer now
+		uint64_t written = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			LogRecord record;
+			while (m_Queue->TryPop(record))
+			{
+				WriteToSinks(record);
+				++written;
+			}
+			FlushSinks();
+		}
+
+		std::lock_guard<std::mutex> lock(m_WakeMutex);
+		m_WrittenCount += written;
+	}
+
+	void Logger::Flush()
+	{
+		if (IsAsync())
+		{
+			// The writer flushes the sinks after every batch
+			WaitUntilWritten(m_Queue->GetPushCount());
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		FlushSinks();
+	}
+
+	void Logger::Log(LogLevel level, std::string message)
 	{
-		if (level < m_MinLogLevel)
+		if (!IsEnabled(level))
 			return;
 
+		LogRecord record;
+		record.level = level;
+		record.time = std::chrono::system_clock::now();
+		record.thread = CurrentThreadIndex();
+		record.message = std::move(message);
+
+		if (IsAsync())
+		{
+			uint64_t position = 0;
+			bool queued = m_Queue->TryPush(record, position);
+			// Full: the writer is behind, so wait for it rather than drop
+			// lines. Async switched off meanwhile falls through to the sinks.
+			while (!queued && IsAsync())
+			{
+				m_WakeCv.notify_one();
+				std::this_thread::yield();
+				queued = m_Queue->TryPush(record, position);
+			}
+
+			if (queued)
+			{
+				// An error may be the last thing logged before a crash
+				if (level >= LogLevel::Error)
+				{
+					WaitUntilWritten(position + 1);
+				}
+				return;
+			}
+		}
+
+		// Send to all sinks
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		WriteToSinks(record);
+		FlushSinks();
+	}
+
+	uint32_t Logger::CurrentThreadIndex()
+	{
+		thread_local const uint32_t index = g_NextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+		return index;
+	}
+
+	std::string Logger::FormatLine(const LogRecord& record)
+	{
 		// Get timestamp
-		auto now = std::chrono::system_clock::now();
-		auto time_t = std::chrono::system_clock::to_time_t(now);
-		
+		auto time_t = std::chrono::system_clock::to_time_t(record.time);
+
 		std::stringstream ss;
 		ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
 		std::string timestamp = ss.str();
 
 		std::string levelStr;
-		switch (level)
+		switch (record.level)
 		{
 		case LogLevel::Trace: levelStr = "TRACE"; break;
 		case LogLevel::Debug: levelStr = "DEBUG"; break;
@@ -67,13 +212,91 @@ namespace Nightbloom
 		default: levelStr = "UNKNOWN"; break;
 		}
 
-		std::string fullMessage = std::format("[{}] [{}] {}", timestamp, levelStr, message);
+		return std::format("[{}] [{}] {}", timestamp, levelStr, record.message);
+	}
 
-		// Send to all sinks
-		std::lock_guard<std::mutex> lock(m_Mutex);
+	void Logger::WriteToSinks(const LogRecord& record)
+	{
+		const std::string fullMessage = FormatLine(record);
 		for (const auto& sink : m_Sinks)
 		{
-			sink->Write(level, fullMessage);
+			sink->WriteRecord(record, fullMessage);
 		}
 	}
-}
\ No newline at end of file
+
+	void ILogSink::WriteRecord(const LogRecord& record, const std::string& line)
+	{
+		Write(record.level, line);
+	}
+
+	void Logger::FlushSinks()
+	{
+		for (const auto& sink : m_Sinks)
+		{
+			sink->Flush();
+		}
+	}
+
+	void Logger::WriterLoop()
+	{
+		ThreadPlacement::Apply(ThreadRole::Background);
+
+		std::vector<LogRecord> batch;
+		batch.reserve(WRITER_BATCH);
+
+		for (;;)
+		{
+			LogRecord record;
+			while (batch.size() < WRITER_BATCH && m_Queue->TryPop(record))
+			{
+				batch.push_back(std::move(record));
+			}
+
+			if (!batch.empty())
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					for (const LogRecord& queued : batch)
+					{
+						WriteToSinks(queued);
+					}
+					FlushSinks();
+				}
+				{
+					std::lock_guard<std::mutex> lock(m_WakeMutex);
+					m_WrittenCount += batch.size();
+				}
+				m_WrittenCv.notify_all();
+				batch.clear();
+				continue;
+			}
+
+			// Empty: stop if asked to (everything queued is written), else
+			// sleep until woken or the next poll
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			if (m_StopWriter)
+				break;
+			m_WakeCv.wait_for(lock, WRITER_IDLE_WAIT);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_WriterRunning = false;
+		}
+		m_WrittenCv.notify_all();
+	}
+
+	void Logger::WaitUntilWritten(uint64_t writtenCount)
+	{
+		// The writer waiting on itself (a sink that logs, or a terminate
+		// raised while writing) would never wake
+		if (std::this_thread::get_id() == m_Writer.get_id())
+			return;
+
+		std::unique_lock<std::mutex> lock(m_WakeMutex);
+		m_WakeCv.notify_one();
+		m_WrittenCv.wait(lock, [this, writtenCount]() {
+			return m_WrittenCount >= writtenCount || !m_WriterRunning;
+		});
+	}
+}
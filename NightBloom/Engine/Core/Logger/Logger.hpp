@@ -7,12 +7,22 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
 #include <format>
 
+// Lowest level (a LogLevel value) the LOG_* macros compile in; calls below it
+// vanish, arguments included. Set by the NIGHTBLOOM_LOG_LEVEL CMake option.
+#ifndef NB_LOG_MIN_LEVEL
+#define NB_LOG_MIN_LEVEL 0
+#endif
+
 namespace Nightbloom
 {
 	enum class LogLevel
@@ -27,6 +37,8 @@ namespace Nightbloom
 	};
 
 	class ILogSink;
+	class LogQueue;
+	struct LogRecord;
 
 	// a singleton logger class that will handle logging messages
 	class Logger
@@ -38,21 +50,45 @@ namespace Nightbloom
 
 		// config
 		void SetLogLevel(LogLevel level);
+		// The runtime filter: one relaxed load, before anything is formatted
+		static bool IsEnabled(LogLevel level)
+		{
+			return level >= s_MinLogLevel.load(std::memory_order_relaxed);
+		}
 		void AddSink(std::shared_ptr<ILogSink> sink);
 		void ClearSinks();
 
+		// Async mode: Log() only stamps the message and queues it (lock-free);
+		// a writer thread formats the lines and writes them to the sinks in
+		// batches, flushing once per batch. Errors wait until they are
+		// written, and a std::terminate flushes, so the last lines before a
+		// crash reach the file. Enable and disable from the main thread,
+		// before other threads log / after they stop.
+		void EnableAsync(size_t queueCapacity = 8192);
+		void DisableAsync();   // writes what's queued, stops the thread
+		bool IsAsync() const { return m_AsyncEnabled.load(std::memory_order_acquire); }
+
+		// Blocks until everything logged so far is written and the sinks
+		// flushed
+		void Flush();
+
 		// Core Logging Function
-		void Log(LogLevel level, const std::string& message);
+		void Log(LogLevel level, std::string message);
 
-		//Formatted logging 
+		// A small number for the calling thread, in the order threads first
+		// ask (LogRecord::thread)
+		static uint32_t CurrentThreadIndex();
+
+		//Formatted logging; the format string is checked against the
+		// arguments at compile time
 		template<typename... Args>
-		void LogFormatted(LogLevel level, std::string_view format, Args&&... args)
+		void LogFormatted(LogLevel level, std::format_string<Args...> format, Args&&... args)
 		{
-			if (level < m_MinLogLevel)
+			if (!IsEnabled(level))
 				return;
 
-			std::string message = std::vformat(format, std::make_format_args(args...));
-			Log(level, message);
+			std::string message = std::vformat(format.get(), std::make_format_args(args...));
+			Log(level, std::move(message));
 		}
 
 		//template<typename... Args>
@@ -60,13 +96,33 @@ namespace Nightbloom
 
 	private:
 		Logger();
-		~Logger() = default;
+		~Logger();
 		Logger(const Logger&) = delete;
 		Logger& operator=(const Logger&) = delete;
 
-		LogLevel m_MinLogLevel = LogLevel::Trace;
+		static std::string FormatLine(const LogRecord& record);
+		// Under m_Mutex
+		void WriteToSinks(const LogRecord& record);
+		void FlushSinks();
+
+		void WriterLoop();
+		void WaitUntilWritten(uint64_t popCount);
+
+		static inline std::atomic<LogLevel> s_MinLogLevel{ LogLevel::Trace };
 		std::vector<std::shared_ptr<ILogSink>> m_Sinks;
-		std::mutex m_Mutex;
+		std::mutex m_Mutex;   // the sinks
+
+		// Async mode. The queue outlives the thread so a thread still
+		// logging as async is switched off pushes into something valid.
+		std::unique_ptr<LogQueue> m_Queue;
+		std::atomic<bool> m_AsyncEnabled{ false };
+		std::thread m_Writer;
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCv;      // work for the writer
+		std::condition_variable m_WrittenCv;   // a batch was written
+		uint64_t m_WrittenCount = 0;           // records, in queue order
+		bool m_StopWriter = false;
+		bool m_WriterRunning = false;
 	};
 
 	// sink interface for logging
@@ -75,15 +131,33 @@ namespace Nightbloom
 	public:
 		virtual ~ILogSink() = default;
 		virtual void Write(LogLevel level, const std::string& message) = 0;
+		// The record behind the line, for sinks that keep more than the text;
+		// the default writes the line
+		virtual void WriteRecord(const LogRecord& record, const std::string& line);
+		// After a batch of writes; sinks that buffer write out here
+		virtual void Flush() {}
 	};
 }
 
+// Below NB_LOG_MIN_LEVEL the call sits in a discarded `if constexpr`: still
+// type-checked, never evaluated. Otherwise the arguments are only evaluated
+// and formatted once the runtime level lets the message through.
+#define NB_LOG(level, ...) \
+	do \
+	{ \
+		if constexpr (static_cast<int>(level) >= NB_LOG_MIN_LEVEL) \
+		{ \
+			if (::Nightbloom::Logger::IsEnabled(level)) \
+				::Nightbloom::Logger::Get().LogFormatted(level, __VA_ARGS__); \
+		} \
+	} while (0)
+
 // Convenience macros for logging
-#define LOG_TRACE(...) ::Nightbloom::Logger::Get().LogFormatted(::Nightbloom::LogLevel::Trace, __VA_ARGS__)
-#define LOG_DEBUG(...) ::Nightbloom::Logger::Get().LogFormatted(::Nightbloom::LogLevel::Debug, __VA_ARGS__)
-#define LOG_INFO(...)  ::Nightbloom::Logger::Get().LogFormatted(::Nightbloom::LogLevel::Info, __VA_ARGS__)
-#define LOG_WARN(...)  ::Nightbloom::Logger::Get().LogFormatted(::Nightbloom::LogLevel::Warn, __VA_ARGS__)
-#define LOG_ERROR(...) ::Nightbloom::Logger::Get().LogFormatted(::Nightbloom::LogLevel::Error, __VA_ARGS__)
+#define LOG_TRACE(...) NB_LOG(::Nightbloom::LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...) NB_LOG(::Nightbloom::LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  NB_LOG(::Nightbloom::LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  NB_LOG(::Nightbloom::LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) NB_LOG(::Nightbloom::LogLevel::Error, __VA_ARGS__)
 
 // Overloads for simple strings (no formatting)
 //#define LOG_INFO_S(...) ::Nightbloom::Logger::Get().LogInfo(msg)
\ No newline at end of file
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+// MainThreadTaskQueue.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/MainThreadTaskQueue.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		double SteadyNowMs()
+		{
+			using namespace std::chrono;
+			return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+		}
+	}
+
+	void MainThreadTaskQueue::Post(Task task, TaskPriority priority, const void* owner)
+	{
+		if (!task)
+			return;
+
+		const size_t slot = std::min(static_cast<size_t>(priority), m_Tasks.size() - 1);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Tasks[slot].push_back({ std::move(task), owner });
+		++m_Pending;
+	}
+
+	size_t MainThreadTaskQueue::Cancel(const void* owner)
+	{
+		if (!owner)
+			return 0;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		size_t dropped = 0;
+		for (std::deque<Entry>& tasks : m_Tasks)
+		{
+			const auto end = std::remove_if(tasks.begin(), tasks.end(),
+				[owner](const Entry& entry) { return entry.owner == owner; });
+			dropped += static_cast<size_t>(tasks.end() - end);
+			tasks.erase(end, tasks.end());
+		}
+		m_Pending -= dropped;
+		return dropped;
+	}
+
+	bool MainThreadTaskQueue::Pop(Task& task)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (std::deque<Entry>& tasks : m_Tasks)
+		{
+			if (!tasks.empty())
+			{
+				task = std::move(tasks.front().task);
+				tasks.pop_front();
+				--m_Pending;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint32_t MainThreadTaskQueue::Run(float budgetMs, const ClockFn& clock)
+	{
+		const auto now = [&clock]() { return clock ? clock() : SteadyNowMs(); };
+		const double start = now();
+
+		// Popped one at a time, so a task may post to the queue it runs from
+		// and a High task posted mid-run goes ahead of the Normal ones left
+		uint32_t ran = 0;
+		Task task;
+		while ((ran == 0 || now() - start < budgetMs) && Pop(task))
+		{
+			task();
+			task = nullptr;
+			++ran;
+		}
+
+		m_LastRun.tasksRun = ran;
+		m_LastRun.budgetMs = budgetMs;
+		m_LastRun.spentMs = static_cast<float>(now() - start);
+		m_LastRun.remaining = GetPendingCount();
+		return ran;
+	}
+
+	uint32_t MainThreadTaskQueue::Flush()
+	{
+		uint32_t ran = 0;
+		Task task;
+		while (Pop(task))
+		{
+			task();
+			task = nullptr;
+			++ran;
+		}
+		return ran;
+	}
+
+	void MainThreadTaskQueue::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (std::deque<Entry>& tasks : m_Tasks)
+			tasks.clear();
+		m_Pending = 0;
+	}
+
+	float MainThreadTaskQueue::ComputeBudgetMs(float targetIntervalMs, float elapsedMs, const BudgetSettings& settings)
+	{
+		const float interval = targetIntervalMs > 0.0f ? targetIntervalMs : settings.defaultIntervalMs;
+		const float left = interval - elapsedMs - settings.headroomMs;
+		return std::clamp(left, settings.minMs, std::max(settings.minMs, settings.maxMs));
+	}
+
+	size_t MainThreadTaskQueue::GetPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Pending;
+	}
+}
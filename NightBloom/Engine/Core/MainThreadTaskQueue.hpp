@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// MainThreadTaskQueue.hpp
+//
+// Time-sliced work for the main thread: descriptor updates, resource swaps,
+// ImGui texture registration - anything that must run there but needn't run
+// this frame. Tasks are posted from any thread and run by Run(), once a
+// frame at its end, highest priority first and in posting order within a
+// priority, until the frame's budget is spent. A batch of hundreds posted
+// at once is spread over as many frames as it takes instead of landing in
+// one.
+//
+// The budget is what's left of the frame (ComputeBudgetMs): the target
+// interval less the time the frame has taken, less some headroom, clamped
+// to [minMs, maxMs]. The minimum keeps a queue moving on frames that
+// overran; the first task of a Run always runs, so one task longer than the
+// whole budget still gets through. A task is never split: a long one posts
+// its remainder as a new task.
+//
+// A task that captures an object (an editor panel) is posted with that
+// object as its owner, and the object cancels its tasks before it goes away.
+//
+// Times are milliseconds on any monotonic clock.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace Nightbloom
+{
+	enum class TaskPriority : uint8_t
+	{
+		High,     // visible this frame if it gets through (swaps, descriptor writes)
+		Normal,
+		Low,      // cosmetic or speculative (thumbnails, previews)
+		Count
+	};
+
+	class MainThreadTaskQueue
+	{
+	public:
+		using Task = std::function<void()>;
+		using ClockFn = std::function<double()>;   // now, in ms
+
+		struct BudgetSettings
+		{
+			float headroomMs = 1.0f;     // left for the pacer's spin and the next frame's start
+			float minMs = 0.5f;
+			float maxMs = 4.0f;
+			float defaultIntervalMs = 1000.0f / 60.0f;   // when the frame has no target
+		};
+
+		struct RunStats
+		{
+			uint32_t tasksRun = 0;
+			float budgetMs = 0.0f;
+			float spentMs = 0.0f;
+			size_t remaining = 0;
+		};
+
+		MainThreadTaskQueue() = default;
+
+		MainThreadTaskQueue(const MainThreadTaskQueue&) = delete;
+		MainThreadTaskQueue& operator=(const MainThreadTaskQueue&) = delete;
+
+		// Any thread. owner, when set, is what Cancel drops the task by.
+		void Post(Task task, TaskPriority priority = TaskPriority::Normal, const void* owner = nullptr);
+
+		// Any thread: drops owner's queued tasks unrun. Returns how many.
+		size_t Cancel(const void* owner);
+
+		// Main thread: runs tasks until budgetMs has passed on `clock`
+		// (steady_clock when empty). Returns how many ran.
+		uint32_t Run(float budgetMs, const ClockFn& clock = {});
+
+		// Main thread: everything queued, including what those tasks post
+		// (loading screens, shutdown)
+		uint32_t Flush();
+
+		// Drops every queued task unrun; for when what they'd touch is going away
+		void Clear();
+
+		// The budget a frame that has taken elapsedMs of its targetIntervalMs
+		// (0 = no target: settings.defaultIntervalMs) leaves for Run
+		static float ComputeBudgetMs(float targetIntervalMs, float elapsedMs, const BudgetSettings& settings);
+
+		size_t GetPendingCount() const;
+		const RunStats& GetLastRun() const { return m_LastRun; }
+
+	private:
+		// Pops the first task of the highest priority; false when empty
+		bool Pop(Task& task);
+
+		struct Entry
+		{
+			Task task;
+			const void* owner = nullptr;
+		};
+
+		mutable std::mutex m_Mutex;
+		std::array<std::deque<Entry>, static_cast<size_t>(TaskPriority::Count)> m_Tasks;
+		size_t m_Pending = 0;
+
+		RunStats m_LastRun;
+	};
+}
@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+// MappedFile.hpp
+//
+// Read-only memory mapping of a whole file. The OS pages the contents in on
+// first touch, so reading a large binary blob costs no copy into a heap
+// buffer and no parsing - cooked asset loads (MeshCache.hpp) are bound by
+// I/O alone, and SPIR-V or texture levels go from the mapping straight into
+// Vulkan or staging memory. The mapping is page aligned.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Nightbloom
+{
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Maps the file; false (and logs nothing) when it is missing or empty
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+		std::span<const uint8_t> GetSpan() const { return { m_Data, m_Size }; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+
+		// Platform handles (file descriptor / HANDLEs); -1 / null when closed
+		intptr_t m_File = -1;
+		intptr_t m_Mapping = 0;
+	};
+}
@@ -0,0 +1,486 @@
+//------------------------------------------------------------------------------
+// MetricsExporter.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/MetricsExporter.hpp"
+#include "Engine/Core/BenchmarkReport.hpp"
+#include "Engine/Core/Platform.hpp"
+#include "Engine/Core/ThreadPlacement.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr auto MIN_INTERVAL = std::chrono::milliseconds(100);
+
+		// One connected UDP socket; send() then needs no address
+		class UdpSender
+		{
+		public:
+			~UdpSender() { Close(); }
+
+			bool Open(const std::string& host, uint16_t port, std::string& error)
+			{
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+				WSADATA data;
+				if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+				{
+					error = "WSAStartup failed";
+					return false;
+				}
+				m_Started = true;
+#endif
+				addrinfo hints{};
+				hints.ai_family = AF_UNSPEC;
+				hints.ai_socktype = SOCK_DGRAM;
+				addrinfo* addresses = nullptr;
+				const std::string service = std::to_string(port);
+				if (getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0 || !addresses)
+				{
+					error = "can't resolve " + host;
+					Close();
+					return false;
+				}
+
+				for (addrinfo* a = addresses; a; a = a->ai_next)
+				{
+					m_Socket = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+					if (m_Socket == INVALID)
+						continue;
+					if (connect(m_Socket, a->ai_addr, static_cast<int>(a->ai_addrlen)) == 0)
+						break;
+					CloseSocket();
+				}
+				freeaddrinfo(addresses);
+
+				if (m_Socket == INVALID)
+				{
+					error = "can't open a UDP socket to " + host + ":" + service;
+					Close();
+					return false;
+				}
+				return true;
+			}
+
+			bool Send(const std::string& datagram)
+			{
+				return send(m_Socket, datagram.data(), static_cast<int>(datagram.size()), 0) ==
+					static_cast<int>(datagram.size());
+			}
+
+			void Close()
+			{
+				CloseSocket();
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+				if (m_Started)
+					WSACleanup();
+				m_Started = false;
+#endif
+			}
+
+		private:
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+			using Socket = SOCKET;
+			static constexpr Socket INVALID = INVALID_SOCKET;
+			bool m_Started = false;
+#else
+			using Socket = int;
+			static constexpr Socket INVALID = -1;
+#endif
+
+			void CloseSocket()
+			{
+				if (m_Socket == INVALID)
+					return;
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+				closesocket(m_Socket);
+#else
+				close(m_Socket);
+#endif
+				m_Socket = INVALID;
+			}
+
+			Socket m_Socket = INVALID;
+		};
+
+		// Every exported value, named as in both formats
+		template <typename Fn>
+		void ForEachValue(const MetricsSnapshot& s, Fn&& fn)
+		{
+			fn("frame.fps", s.fps);
+			fn("frame.p50", s.frameP50);
+			fn("frame.p95", s.frameP95);
+			fn("frame.p99", s.frameP99);
+			fn("frame.max", s.frameMax);
+			if (s.gpuP50 > 0.0f)
+			{
+				fn("gpu.p50", s.gpuP50);
+				fn("gpu.p95", s.gpuP95);
+			}
+			if (s.memoryBudget > 0)
+			{
+				fn("memory.usage_mb", static_cast<double>(s.memoryUsage) / (1024.0 * 1024.0));
+				fn("memory.budget_mb", static_cast<double>(s.memoryBudget) / (1024.0 * 1024.0));
+				fn("memory.budget_fraction", static_cast<double>(s.memoryUsage) / static_cast<double>(s.memoryBudget));
+			}
+			fn("upload.mb_per_s", s.uploadBytesPerSecond / (1024.0 * 1024.0));
+			for (const MetricsSnapshot::Pass& pass : s.passes)
+			{
+				const std::string name = "gpu.pass." + MetricsExporter::SanitizeName(pass.name);
+				fn(name + ".p50", pass.p50);
+				fn(name + ".p95", pass.p95);
+			}
+		}
+
+		std::string FormatValue(double value)
+		{
+			char text[32];
+			std::snprintf(text, sizeof(text), "%.4g", value);
+			return text;
+		}
+
+		const std::string& InstanceOrDefault(const std::string& instance)
+		{
+			static const std::string fallback = "default";
+			return instance.empty() ? fallback : instance;
+		}
+	}
+
+	MetricsExporter::~MetricsExporter()
+	{
+		Stop();
+	}
+
+	bool MetricsExporter::Start(const MetricsExportSettings& settings)
+	{
+		if (IsRunning())
+			return true;
+		if ((settings.csvPath.empty() && settings.statsdHost.empty()) || settings.interval < MIN_INTERVAL)
+			return false;
+
+		m_Settings = settings;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Quit = false;
+			m_Pending.clear();
+			m_LastError.clear();
+		}
+		m_Thread = std::thread([this]() { ThreadLoop(); });
+		return true;
+	}
+
+	void MetricsExporter::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Quit = true;
+		}
+		m_Wake.notify_all();
+		m_Thread.join();
+	}
+
+	void MetricsExporter::Record(const MetricsFrame& frame)
+	{
+		if (!IsRunning())
+			return;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Pending.push_back(frame);
+	}
+
+	std::string MetricsExporter::GetLastError() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_LastError;
+	}
+
+	void MetricsExporter::SetError(std::string error)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_LastError = std::move(error);
+	}
+
+	void MetricsExporter::ThreadLoop()
+	{
+		ThreadPlacement::Apply(ThreadRole::Background);
+
+		std::vector<MetricsFrame> frames;
+		auto intervalStart = std::chrono::steady_clock::now();
+		bool quit = false;
+		while (!quit)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait_for(lock, m_Settings.interval, [this]() { return m_Quit; });
+				quit = m_Quit;
+				// The buffers trade places, so both keep their capacity
+				frames.clear();
+				frames.swap(m_Pending);
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			const float seconds = std::chrono::duration<float>(now - intervalStart).count();
+			intervalStart = now;
+			Export(frames, seconds);
+		}
+	}
+
+	void MetricsExporter::Export(std::vector<MetricsFrame>& frames, float seconds)
+	{
+		if (frames.empty() || seconds <= 0.0f)
+			return;
+
+		const double time = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+		const MetricsSnapshot snapshot = Summarize(frames, seconds, time);
+		const std::string& instance = InstanceOrDefault(m_Settings.instance);
+		bool failed = false;
+
+		if (!m_Settings.csvPath.empty())
+		{
+			std::error_code ec;
+			const bool isNew = !std::filesystem::exists(m_Settings.csvPath, ec) ||
+				std::filesystem::file_size(m_Settings.csvPath, ec) == 0;
+			std::ofstream file(m_Settings.csvPath, std::ios::app);
+			if (isNew)
+				file << FormatCsvHeader();
+			file << FormatCsv(snapshot, instance);
+			if (!file)
+			{
+				SetError("can't write " + m_Settings.csvPath);
+				failed = true;
+			}
+		}
+
+		if (!m_Settings.statsdHost.empty())
+		{
+			// Opened per export: cheap next to the interval, and a host that
+			// comes up (or a DNS change) later is picked up
+			UdpSender sender;
+			std::string error;
+			if (!sender.Open(m_Settings.statsdHost, m_Settings.statsdPort, error))
+			{
+				SetError(error);
+				failed = true;
+			}
+			else
+			{
+				for (const std::string& datagram : FormatStatsd(snapshot, m_Settings.prefix, instance))
+				{
+					if (!sender.Send(datagram))
+					{
+						SetError("send to " + m_Settings.statsdHost + " failed");
+						failed = true;
+						break;
+					}
+				}
+			}
+		}
+
+		if (!failed)
+			SetError({});
+		m_ExportCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	MetricsSnapshot MetricsExporter::Summarize(const std::vector<MetricsFrame>& frames, float seconds, double time)
+	{
+		MetricsSnapshot snapshot;
+		snapshot.time = time;
+		snapshot.seconds = seconds;
+		snapshot.frames = static_cast<uint32_t>(frames.size());
+		if (frames.empty())
+			return snapshot;
+
+		std::vector<float> frameMs, gpuMs;
+		frameMs.reserve(frames.size());
+		std::vector<StringId> passNames;
+		std::vector<std::vector<float>> passMs;
+		uint64_t uploadBytes = 0;
+		for (const MetricsFrame& frame : frames)
+		{
+			frameMs.push_back(frame.frameMs);
+			if (frame.gpuMs > 0.0f)
+				gpuMs.push_back(frame.gpuMs);
+			uploadBytes += frame.uploadBytes;
+			if (frame.memoryBudget > 0)
+			{
+				snapshot.memoryUsage = frame.memoryUsage;
+				snapshot.memoryBudget = frame.memoryBudget;
+			}
+			for (const MetricsFrame::Pass& pass : frame.passes)
+			{
+				auto it = std::find(passNames.begin(), passNames.end(), pass.name);
+				if (it == passNames.end())
+				{
+					passNames.push_back(pass.name);
+					passMs.emplace_back();
+					it = passNames.end() - 1;
+				}
+				passMs[it - passNames.begin()].push_back(pass.ms);
+			}
+		}
+
+		const BenchmarkSeries frame = BenchmarkSeries::FromSamples(std::move(frameMs));
+		snapshot.fps = seconds > 0.0f ? static_cast<float>(frames.size()) / seconds : 0.0f;
+		snapshot.frameP50 = frame.p50;
+		snapshot.frameP95 = frame.p95;
+		snapshot.frameP99 = frame.p99;
+		snapshot.frameMax = frame.max;
+
+		const BenchmarkSeries gpu = BenchmarkSeries::FromSamples(std::move(gpuMs));
+		snapshot.gpuP50 = gpu.p50;
+		snapshot.gpuP95 = gpu.p95;
+
+		snapshot.uploadBytesPerSecond = seconds > 0.0f ? static_cast<float>(uploadBytes) / seconds : 0.0f;
+
+		snapshot.passes.reserve(passNames.size());
+		for (size_t i = 0; i < passNames.size(); ++i)
+		{
+			const BenchmarkSeries series = BenchmarkSeries::FromSamples(std::move(passMs[i]));
+			MetricsSnapshot::Pass& pass = snapshot.passes.emplace_back();
+			pass.name = passNames[i].GetText();
+			pass.samples = series.samples;
+			pass.p50 = series.p50;
+			pass.p95 = series.p95;
+		}
+		return snapshot;
+	}
+
+	std::string MetricsExporter::FormatCsvHeader()
+	{
+		return "time,instance,metric,value\n";
+	}
+
+	std::string MetricsExporter::FormatCsv(const MetricsSnapshot& snapshot, const std::string& instance)
+	{
+		char time[32];
+		std::snprintf(time, sizeof(time), "%.3f", snapshot.time);
+		const std::string prefix = std::string(time) + "," + SanitizeName(InstanceOrDefault(instance)) + ",";
+
+		std::string out;
+		ForEachValue(snapshot, [&](const std::string& name, double value)
+			{
+				out += prefix + name + "," + FormatValue(value) + "\n";
+			});
+		return out;
+	}
+
+	std::vector<std::string> MetricsExporter::FormatStatsd(const MetricsSnapshot& snapshot, const std::string& prefix,
+		const std::string& instance, size_t maxBytes)
+	{
+		// The prefix may hold dots of its own ("fleet.render")
+		std::string namePrefix = prefix.empty() ? std::string() : prefix + ".";
+		namePrefix += SanitizeName(InstanceOrDefault(instance)) + ".";
+
+		std::vector<std::string> datagrams;
+		std::string current;
+		ForEachValue(snapshot, [&](const std::string& name, double value)
+			{
+				const std::string line = namePrefix + name + ":" + FormatValue(value) + "|g";
+				if (!current.empty() && current.size() + 1 + line.size() > maxBytes)
+				{
+					datagrams.push_back(std::move(current));
+					current.clear();
+				}
+				if (!current.empty())
+					current += '\n';
+				current += line;
+			});
+		if (!current.empty())
+			datagrams.push_back(std::move(current));
+		return datagrams;
+	}
+
+	bool MetricsExporter::SettingsFromEnvironment(MetricsExportSettings& settings)
+	{
+		const auto read = [](const char* name) -> std::string
+		{
+			const char* value = std::getenv(name);
+			return value ? value : "";
+		};
+
+		settings.csvPath = read("NIGHTBLOOM_METRICS_CSV");
+		const std::string statsd = read("NIGHTBLOOM_METRICS_STATSD");
+		if (!statsd.empty() && !ParseEndpoint(statsd, settings.statsdHost, settings.statsdPort))
+			settings.statsdHost.clear();
+
+		const std::string interval = read("NIGHTBLOOM_METRICS_INTERVAL_MS");
+		if (!interval.empty())
+			settings.interval = std::chrono::milliseconds(std::strtol(interval.c_str(), nullptr, 10));
+		const std::string prefix = read("NIGHTBLOOM_METRICS_PREFIX");
+		if (!prefix.empty())
+			settings.prefix = prefix;
+		const std::string instance = read("NIGHTBLOOM_METRICS_INSTANCE");
+		if (!instance.empty())
+			settings.instance = instance;
+
+		return !settings.csvPath.empty() || !settings.statsdHost.empty();
+	}
+
+	bool MetricsExporter::ParseEndpoint(const std::string& endpoint, std::string& host, uint16_t& port)
+	{
+		size_t colon = std::string::npos;
+		if (!endpoint.empty() && endpoint.front() == '[')
+		{
+			const size_t close = endpoint.find(']');
+			if (close == std::string::npos)
+				return false;
+			host = endpoint.substr(1, close - 1);
+			if (close + 1 < endpoint.size())
+			{
+				if (endpoint[close + 1] != ':')
+					return false;
+				colon = close + 1;
+			}
+		}
+		else
+		{
+			// More than one colon is a bare IPv6 address, without a port
+			colon = endpoint.find(':');
+			if (colon != std::string::npos && endpoint.find(':', colon + 1) != std::string::npos)
+				colon = std::string::npos;
+			host = endpoint.substr(0, colon);
+		}
+
+		if (host.empty())
+			return false;
+		if (colon == std::string::npos)
+			return true;
+
+		char* end = nullptr;
+		const long value = std::strtol(endpoint.c_str() + colon + 1, &end, 10);
+		if (end == endpoint.c_str() + colon + 1 || *end != '\0' || value <= 0 || value > 65535)
+			return false;
+		port = static_cast<uint16_t>(value);
+		return true;
+	}
+
+	std::string MetricsExporter::SanitizeName(const std::string& name)
+	{
+		std::string out = name;
+		for (char& c : out)
+		{
+			const bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+				c == '_' || c == '-';
+			if (!keep)
+				c = '_';
+		}
+		return out;
+	}
+}
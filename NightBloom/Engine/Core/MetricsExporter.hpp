@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+// MetricsExporter.hpp
+//
+// Streams runtime metrics out of a running instance, for watching many of
+// them without attaching a profiler: frame-time percentiles, GPU pass times,
+// device memory against its budget and upload throughput. The render thread
+// hands over one small record per frame (Record, a lock and a few appends);
+// a thread of its own wakes every `interval`, reduces what came in since
+// its last wake to a MetricsSnapshot and writes it to the sinks configured:
+//
+//   CSV     one "time,instance,metric,value" row per metric, appended, so
+//           a file can be followed and passes coming and going need no new
+//           columns. The header is written when the file is new.
+//   StatsD  gauges over UDP ("<prefix>.<instance>.frame.p95:16.61|g"),
+//           several lines per datagram but none over MAX_DATAGRAM bytes.
+//           Fire and forget: nothing is sent back and a lost packet is a gap.
+//
+// Percentiles are nearest-rank over the frames of the interval (Benchmark-
+// Series); GPU passes are the top-level spans of the profiler's frames, each
+// read back frame counted once. An interval with no frames exports nothing.
+//
+// The Renderer owns one and starts it at initialization when the process
+// environment names a sink (SettingsFromEnvironment), so deployed instances
+// need no code or UI to report:
+//
+//   NIGHTBLOOM_METRICS_CSV=<path>  NIGHTBLOOM_METRICS_STATSD=<host>[:<port>]
+//   NIGHTBLOOM_METRICS_INTERVAL_MS  NIGHTBLOOM_METRICS_PREFIX
+//   NIGHTBLOOM_METRICS_INSTANCE
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/StringId.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct MetricsExportSettings
+	{
+		std::chrono::milliseconds interval{ 10000 };
+		std::string csvPath;              // empty: no CSV
+		std::string statsdHost;           // empty: no StatsD
+		uint16_t statsdPort = 8125;
+		std::string prefix = "nightbloom";
+		std::string instance;             // names this process in every metric; empty: "default"
+	};
+
+	// What the render thread records per frame
+	struct MetricsFrame
+	{
+		struct Pass
+		{
+			StringId name;
+			float ms = 0.0f;
+		};
+
+		float frameMs = 0.0f;
+		float gpuMs = 0.0f;                // the graphics queue's total, 0 when unknown
+		uint64_t uploadBytes = 0;
+		uint64_t memoryUsage = 0;          // device-local bytes in use, 0 when unknown
+		uint64_t memoryBudget = 0;
+		std::vector<Pass> passes;          // a GPU frame newly read back, else empty
+	};
+
+	struct MetricsSnapshot
+	{
+		struct Pass
+		{
+			std::string name;
+			uint32_t samples = 0;
+			float p50 = 0.0f;
+			float p95 = 0.0f;
+		};
+
+		double time = 0.0;                 // seconds since the epoch, at the end of the interval
+		float seconds = 0.0f;              // the interval's length
+		uint32_t frames = 0;
+		float fps = 0.0f;
+		float frameP50 = 0.0f;
+		float frameP95 = 0.0f;
+		float frameP99 = 0.0f;
+		float frameMax = 0.0f;
+		float gpuP50 = 0.0f;
+		float gpuP95 = 0.0f;
+		uint64_t memoryUsage = 0;          // the interval's last frame
+		uint64_t memoryBudget = 0;
+		float uploadBytesPerSecond = 0.0f;
+		std::vector<Pass> passes;          // in the order first seen
+	};
+
+	class MetricsExporter
+	{
+	public:
+		static constexpr size_t MAX_DATAGRAM = 1400;   // under a typical MTU
+
+		MetricsExporter() = default;
+		~MetricsExporter();
+
+		MetricsExporter(const MetricsExporter&) = delete;
+		MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+		// Starts the export thread. False (and nothing started) without a
+		// sink or with an interval under 100 ms; no-op while running.
+		bool Start(const MetricsExportSettings& settings);
+		// Exports what's pending, then joins the thread
+		void Stop();
+
+		bool IsRunning() const { return m_Thread.joinable(); }
+		const MetricsExportSettings& GetSettings() const { return m_Settings; }
+
+		// Render thread, once per frame; dropped while stopped
+		void Record(const MetricsFrame& frame);
+
+		uint64_t GetExportCount() const { return m_ExportCount.load(std::memory_order_relaxed); }
+		// The last sink failure, empty while everything works
+		std::string GetLastError() const;
+
+		// The reduction and the two formats, on the calling thread
+		static MetricsSnapshot Summarize(const std::vector<MetricsFrame>& frames, float seconds, double time);
+		static std::string FormatCsvHeader();
+		static std::string FormatCsv(const MetricsSnapshot& snapshot, const std::string& instance);
+		// Datagrams of whole lines, each at most maxBytes (one longer line goes alone)
+		static std::vector<std::string> FormatStatsd(const MetricsSnapshot& snapshot, const std::string& prefix,
+			const std::string& instance, size_t maxBytes = MAX_DATAGRAM);
+
+		// Reads the NIGHTBLOOM_METRICS_* variables over the defaults. False
+		// when they name no sink.
+		static bool SettingsFromEnvironment(MetricsExportSettings& settings);
+		// "host", "host:port" or "[v6 address]:port"; false on a bad port
+		static bool ParseEndpoint(const std::string& endpoint, std::string& host, uint16_t& port);
+
+		// "GBuffer Pass" -> "GBuffer_Pass": what StatsD names and CSV cells may hold
+		static std::string SanitizeName(const std::string& name);
+
+	private:
+		void ThreadLoop();
+		void Export(std::vector<MetricsFrame>& frames, float seconds);
+		void SetError(std::string error);
+
+		MetricsExportSettings m_Settings;
+		std::thread m_Thread;
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Wake;
+		bool m_Quit = false;
+		std::vector<MetricsFrame> m_Pending;
+		std::string m_LastError;
+
+		std::atomic<uint64_t> m_ExportCount{ 0 };
+	};
+}
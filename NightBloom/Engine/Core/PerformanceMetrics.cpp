@@ -1,5 +1,6 @@
 #include "Engine/Core/PerformanceMetrics.hpp"
 #include "Core/Logger/Logger.hpp"
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <sstream>
@@ -57,6 +58,22 @@ void Nightbloom::PerformanceMetrics::EndGPUWork()
 	m_GPUTime = duration.count() / 1000.0f;
 }
 
+void Nightbloom::PerformanceMetrics::RecordInputLatency(float ms, bool atDisplay)
+{
+	// Switching between measurement points restarts the average
+	if (atDisplay != m_InputLatencyAtDisplay || m_InputLatency <= 0.0f)
+	{
+		m_InputLatency = ms;
+		m_MaxInputLatency = ms;
+	}
+	else
+	{
+		m_InputLatency += (ms - m_InputLatency) * 0.1f;
+		m_MaxInputLatency = std::max(m_MaxInputLatency, ms);
+	}
+	m_InputLatencyAtDisplay = atDisplay;
+}
+
 void Nightbloom::PerformanceMetrics::UpdateMemoryStats(size_t allocated, size_t used)
 {
 	m_MemoryAllocated = allocated;
@@ -74,6 +91,11 @@ std::string Nightbloom::PerformanceMetrics::GetReport() const
 		<< "Max=" << m_MaxFrameTime << "ms\n";
 	ss << "Variance: " << m_FrameTimeVariance << "ms\n";
 	ss << "GPU Time: " << m_GPUTime << "ms\n";
+	ss << "Input Latency: " << m_InputLatency << "ms (Max=" << m_MaxInputLatency << "ms, "
+		<< (m_InputLatencyAtDisplay ? "at display" : "at present") << ")\n";
+	if (m_PacingTarget > 0.0f)
+		ss << "Frame Pacing: " << m_PacingTarget << "ms target, jitter " << m_PacingJitter << "ms, waited "
+			<< m_PacingWait << "ms\n";
 	ss << "Memory: " << (m_MemoryUsed / (1024.0 * 1024.0)) << "MB / "
 		<< (m_MemoryAllocated / (1024.0 * 1024.0)) << "MB\n";
 	ss << "Total Frames: " << m_FrameCount;
@@ -88,6 +110,11 @@ void Nightbloom::PerformanceMetrics::LogMetrics() const
 		m_AverageFrameTime, m_MinFrameTime, m_MaxFrameTime);
 	LOG_INFO("  Frame Variance: {:.2f}ms", m_FrameTimeVariance);
 	LOG_INFO("  GPU Time: {:.2f}ms", m_GPUTime);
+	LOG_INFO("  Input Latency: {:.2f}ms (Max: {:.2f}ms, {})",
+		m_InputLatency, m_MaxInputLatency, m_InputLatencyAtDisplay ? "at display" : "at present");
+	if (m_PacingTarget > 0.0f)
+		LOG_INFO("  Frame Pacing: {:.2f}ms target, jitter {:.3f}ms, waited {:.2f}ms",
+			m_PacingTarget, m_PacingJitter, m_PacingWait);
 	LOG_INFO("  Memory: {:.1f}MB / {:.1f}MB",
 		m_MemoryUsed / (1024.0 * 1024.0),
 		m_MemoryAllocated / (1024.0 * 1024.0));
@@ -103,6 +130,13 @@ void Nightbloom::PerformanceMetrics::Reset()
 	m_MaxFrameTime = 0.0f;
 	m_FrameTimeVariance = 0.0f;
 	m_GPUTime = 0.0f;
+	m_InputLatency = 0.0f;
+	m_MaxInputLatency = 0.0f;
+	m_InputLatencyAtDisplay = false;
+	m_LowLatencySleep = 0.0f;
+	m_PacingTarget = 0.0f;
+	m_PacingJitter = 0.0f;
+	m_PacingWait = 0.0f;
 	m_MemoryAllocated = 0;
 	m_MemoryUsed = 0;
 	m_FrameCount = 0;
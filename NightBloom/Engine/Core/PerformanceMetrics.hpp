@@ -38,6 +38,31 @@ namespace Nightbloom
 		void EndGPUWork();
 		float GetGPUTime() const { return m_GPUTime; }
 
+		// Input-to-present latency: earliest input event a frame consumed to
+		// that frame's present. "At display" when VK_KHR_present_wait timed
+		// the present itself, otherwise it ends when the present was queued.
+		void RecordInputLatency(float ms, bool atDisplay);
+		float GetInputLatency() const { return m_InputLatency; }         // smoothed
+		float GetMaxInputLatency() const { return m_MaxInputLatency; }
+		bool IsInputLatencyAtDisplay() const { return m_InputLatencyAtDisplay; }
+
+		// Low-latency mode: time slept before input sampling last frame
+		void SetLowLatencySleep(float ms) { m_LowLatencySleep = ms; }
+		float GetLowLatencySleep() const { return m_LowLatencySleep; }
+
+		// Frame limiter (FramePacer): target interval, smoothed error of the
+		// actual frame interval against it, and time waited last frame.
+		// A target of 0 means the limiter is off.
+		void SetFramePacing(float targetMs, float jitterMs, float waitMs)
+		{
+			m_PacingTarget = targetMs;
+			m_PacingJitter = jitterMs;
+			m_PacingWait = waitMs;
+		}
+		float GetPacingTarget() const { return m_PacingTarget; }
+		float GetPacingJitter() const { return m_PacingJitter; }
+		float GetPacingWait() const { return m_PacingWait; }
+
 		// Memory tracking (integrates with VMA)
 		void UpdateMemoryStats(size_t allocated, size_t used);
 		size_t GetMemoryAllocated() const { return m_MemoryAllocated; }
@@ -77,6 +102,17 @@ namespace Nightbloom
 		float m_FrameTimeVariance = 0.0f;
 		float m_GPUTime = 0.0f;
 
+		// Latency
+		float m_InputLatency = 0.0f;
+		float m_MaxInputLatency = 0.0f;
+		bool m_InputLatencyAtDisplay = false;
+		float m_LowLatencySleep = 0.0f;
+
+		// Frame pacing
+		float m_PacingTarget = 0.0f;
+		float m_PacingJitter = 0.0f;
+		float m_PacingWait = 0.0f;
+
 		// Memory
 		size_t m_MemoryAllocated = 0;
 		size_t m_MemoryUsed = 0;
@@ -6,13 +6,18 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/SceneBVH.hpp"
+#include "Engine/Core/SceneNodes.hpp"
 #include "Engine/Renderer/Model.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
 #include "Engine/Renderer/Light.hpp"
 #include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/LightCulling.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <memory>
@@ -34,98 +39,124 @@ namespace Nightbloom
 	};
 
 	//--------------------------------------------------------------------------
-	// SceneObject - Wrapper for anything that can exist in the scene
+	// SceneObject - Wrapper for anything that can exist in the scene. The
+	// per-frame data (world transform, bounds, visibility) lives in the owning
+	// Scene's SceneNodes; this is the editor-facing façade over its node.
 	//--------------------------------------------------------------------------
 	struct SceneObject
 	{
 		std::string name;
-		bool visible = true;
+
+		// Node in the owning Scene's SceneNodes (same index as in GetObjects()),
+		// set by Scene
+		SceneNodes* nodes = nullptr;
+		uint32_t    node = 0;
 
 		// Serialization metadata for primitives (meshDrawable-based objects). The
-		// transform + customData live in the MeshDrawable itself (read via its
-		// getters); these record what the drawable can't: which built-in geometry
-		// and which named texture to rebind on load.
+		// customData lives in the MeshDrawable itself (read via its getters);
+		// these record what the drawable can't: which built-in geometry and which
+		// named texture to rebind on load.
 		PrimitiveKind primitiveKind = PrimitiveKind::None;
 		std::string   primitiveTexture;   // ResourceManager texture name, e.g. "uv_checker"
 
-		// The actual renderable (we own the model, drawable is created from it)
-		std::unique_ptr<Model> model;
+		// The actual renderable. The Model is shared by every object placing
+		// the same file (ResourceManager's ModelCache); the object keeps only
+		// its own transform and drawable, whose default texture overrides the
+		// model's missing ones.
+		std::shared_ptr<Model> model;
 		std::unique_ptr<ModelDrawable> drawable;
 
 		// For obhects without a model
 		std::unique_ptr<MeshDrawable> meshDrawable;
 
+		// SceneStreamer cell the object was streamed in with (a WorldPartition
+		// cell index), -1 for objects that stay loaded. Not saved.
+		int32_t streamCell = -1;
+
 		// Track primitive state for UI sync
 		int textureIndex = 0;        // Which texture is assigned (for UI display)
 		PipelineType pipeline = PipelineType::Mesh;  // Which pipeline (for primitives)
 
-		// Composed primitive transform (cache). Authoritative source is the
-		// decomposed TRS below; DayNight also writes this directly for the moon.
-		glm::mat4 primitiveTransform = glm::mat4(1.0f);
-
-		// Decomposed transform for primitives (meshDrawable has no TRS of its own,
-		// unlike Model). The accessors below edit these and recompose into the
-		// drawable, so the Inspector can move/rotate/scale primitives exactly like
-		// models. Rotation is euler radians, matching Model.
-		glm::vec3 primitivePosition = glm::vec3(0.0f);
-		glm::vec3 primitiveRotation = glm::vec3(0.0f);
-		glm::vec3 primitiveScale    = glm::vec3(1.0f);
-
-		// Recompose primitiveTransform from the TRS and push it to the drawable.
-		// Same order as Model::Set* (T * R * S) so primitives and models behave
-		// identically in the editor.
-		void UpdatePrimitiveTransform()
+		// Composed local transform, the object's own for models and
+		// primitives alike (a shared Model's TRS is only where AddObject
+		// starts it). Authoritative source is the decomposed TRS below;
+		// SetLocalTransform writes it directly (the DayNight moon).
+		glm::mat4 localTransform = glm::mat4(1.0f);
+
+		// Decomposed local transform. The accessors below edit these and
+		// recompose into the node, so the Inspector moves/rotates/scales
+		// every object the same way. Rotation is euler radians, matching Model.
+		glm::vec3 localPosition = glm::vec3(0.0f);
+		glm::vec3 localRotation = glm::vec3(0.0f);
+		glm::vec3 localScale    = glm::vec3(1.0f);
+
+		// Recompose localTransform from the TRS and hand it to the node.
+		// Same order as Model::Set* (T * R * S).
+		void UpdateLocalTransform()
 		{
-			primitiveTransform =
-				glm::translate(glm::mat4(1.0f), primitivePosition) *
-				glm::mat4_cast(glm::quat(primitiveRotation)) *
-				glm::scale(glm::mat4(1.0f), primitiveScale);
-			if (meshDrawable) meshDrawable->SetTransform(primitiveTransform);
+			// T * R * S composed directly (no 4x4 products): the rotation's
+			// columns scaled, then the translation
+			const glm::mat3 rotation = glm::mat3_cast(glm::quat(localRotation));
+			localTransform = glm::mat4(
+				glm::vec4(rotation[0] * localScale.x, 0.0f),
+				glm::vec4(rotation[1] * localScale.y, 0.0f),
+				glm::vec4(rotation[2] * localScale.z, 0.0f),
+				glm::vec4(localPosition, 1.0f));
+			MarkTransformDirty();
 		}
 
-		// Convenience accessors for transform. Delegate to the Model for model-based
-		// objects; edit the primitive TRS (and recompose) for primitives.
-		glm::vec3 GetPosition() const
+		void SetLocalTransform(const glm::mat4& transform)
 		{
-			return model ? model->GetPosition() : primitivePosition;
+			localTransform = transform;
+			MarkTransformDirty();
 		}
 
-		glm::vec3 GetRotation() const
+		glm::mat4 GetLocalTransform() const { return localTransform; }
+
+		// Local composed with the parents'; current as of the last Scene::Update
+		glm::mat4 GetWorldTransform() const
 		{
-			return model ? model->GetRotation() : primitiveRotation;
+			return nodes ? nodes->GetWorld(node) : GetLocalTransform();
 		}
 
-		glm::vec3 GetScale() const
+		// Hand the local transform to the node, which pushes the new world
+		// transform to the drawable on the next Scene::Update. The setters
+		// below call this.
+		void MarkTransformDirty()
 		{
-			return model ? model->GetScale() : primitiveScale;
+			if (nodes) nodes->SetLocal(node, GetLocalTransform());
 		}
 
+		bool IsVisible() const { return !nodes || nodes->IsVisible(node); }
+		void SetVisible(bool visible) { if (nodes) nodes->SetVisible(node, visible); }
+
+		// Convenience accessors for transform: edit the TRS and recompose
+		glm::vec3 GetPosition() const { return localPosition; }
+		glm::vec3 GetRotation() const { return localRotation; }
+		glm::vec3 GetScale() const { return localScale; }
+
 		void SetPosition(const glm::vec3& pos)
 		{
-			if (model) { model->SetPosition(pos); return; }
-			primitivePosition = pos;
-			UpdatePrimitiveTransform();
+			localPosition = pos;
+			UpdateLocalTransform();
 		}
 
 		void SetRotation(const glm::vec3& rot)
 		{
-			if (model) { model->SetRotation(rot); return; }
-			primitiveRotation = rot;
-			UpdatePrimitiveTransform();
+			localRotation = rot;
+			UpdateLocalTransform();
 		}
 
 		void SetScale(const glm::vec3& scale)
 		{
-			if (model) { model->SetScale(scale); return; }
-			primitiveScale = scale;
-			UpdatePrimitiveTransform();
+			localScale = scale;
+			UpdateLocalTransform();
 		}
 
 		void SetScale(float uniform)
 		{
-			if (model) { model->SetScale(uniform); return; }
-			primitiveScale = glm::vec3(uniform);
-			UpdatePrimitiveTransform();
+			localScale = glm::vec3(uniform);
+			UpdateLocalTransform();
 		}
 
 		IDrawable* GetDrawable() const {
@@ -146,11 +177,21 @@ namespace Nightbloom
 	class Scene
 	{
 	public:
+		// Objects per job in Update/BuildDrawList's parallel-for; scenes this
+		// small or smaller run serially
+		static constexpr uint32_t PARALLEL_GRAIN = 128;
+
 		Scene() = default;
 		~Scene() = default;
 
-		// Add a model-based object to the scene
-		SceneObject* AddObject(const std::string& name, std::unique_ptr<Model> model, Texture* defaultTexture = nullptr)
+		// SceneObjects point back at m_Nodes, so a Scene stays where it was built
+		Scene(const Scene&) = delete;
+		Scene& operator=(const Scene&) = delete;
+
+		// Add a model-based object to the scene. The model may be shared with
+		// other objects (ResourceManager::GetModelCache); the object starts at
+		// the model's own transform and is moved independently from there.
+		SceneObject* AddObject(const std::string& name, std::shared_ptr<Model> model, Texture* defaultTexture = nullptr)
 		{
 			auto& obj = m_Objects.emplace_back();
 			obj.name = name;
@@ -159,17 +200,52 @@ namespace Nightbloom
 			if (obj.model)
 			{
 				obj.drawable = std::make_unique<ModelDrawable>(obj.model.get(), defaultTexture);
+				obj.localPosition = obj.model->GetPosition();
+				obj.localRotation = obj.model->GetRotation();
+				obj.localScale = obj.model->GetScale();
+				obj.localTransform = obj.model->GetTransform();
 			}
 
+			AttachNode(obj);
 			return &m_Objects.back();
 		}
 
+		// Picks up new bounds of a model added before it had finished loading
+		// (AsyncAssetLoader) on every object sharing it; the rest are left alone
+		void RefreshModelBounds(const Model* model)
+		{
+			for (SceneObject& obj : m_Objects)
+			{
+				if (!model || obj.model.get() != model)
+					continue;
+				m_Nodes.SetLocalBounds(obj.node, model->GetBoundsMin(), model->GetBoundsMax());
+				m_BvhDirty = true;
+			}
+		}
+
+		// After a hot reload swapped `model`'s contents (AsyncAssetLoader::
+		// ReloadModel): new bounds, and animation restarted, since the
+		// skeleton and clips may have changed
+		void RefreshReloadedModel(const Model* model)
+		{
+			RefreshModelBounds(model);
+			for (SceneObject& obj : m_Objects)
+			{
+				if (model && obj.drawable && obj.model.get() == model)
+					obj.drawable->SetModel(obj.model.get());
+			}
+		}
+
 		// Add a mesh drawable (for primitives like test cubes)
 		SceneObject* AddPrimitive(const std::string& name, std::unique_ptr<MeshDrawable> meshDrawable)
 		{
 			auto& obj = m_Objects.emplace_back();
 			obj.name = name;
 			obj.meshDrawable = std::move(meshDrawable);
+			if (obj.meshDrawable)
+				obj.localTransform = obj.meshDrawable->GetTransform();
+
+			AttachNode(obj);
 			return &m_Objects.back();
 		}
 
@@ -257,90 +333,263 @@ namespace Nightbloom
 			return index < m_Objects.size() ? &m_Objects[index] : nullptr;
 		}
 
+		// Parent an object under another (-1 = root). Its local transform is
+		// kept, now relative to the parent. Fails if that would make a cycle.
+		bool SetParent(size_t index, int parent)
+		{
+			if (index >= m_Objects.size() || parent >= static_cast<int>(m_Objects.size()))
+				return false;
+			if (!m_Nodes.SetParent(static_cast<uint32_t>(index),
+				parent < 0 ? SceneNodes::INVALID : static_cast<uint32_t>(parent)))
+				return false;
+			++m_StructureVersion;
+			return true;
+		}
+
+		// Bumped by every add, remove, reparent and rename of an object, so
+		// views derived from the hierarchy (the editor's outline) rebuild only
+		// when it changed. Editing SceneObject::name directly goes unnoticed.
+		uint64_t GetStructureVersion() const { return m_StructureVersion; }
+
+		void RenameObject(size_t index, const std::string& name)
+		{
+			if (index >= m_Objects.size() || m_Objects[index].name == name)
+				return;
+			m_Objects[index].name = name;
+			++m_StructureVersion;
+		}
+
+		int GetParent(size_t index) const
+		{
+			if (index >= m_Objects.size()) return -1;
+			const uint32_t parent = m_Nodes.GetParent(static_cast<uint32_t>(index));
+			return parent == SceneNodes::INVALID ? -1 : static_cast<int>(parent);
+		}
+
+		const SceneNodes& GetNodes() const { return m_Nodes; }
+		const SceneBVH& GetBVH() const { return m_Bvh; }
+
+		// Nearest visible object whose world box the ray enters (-1 = none).
+		// Only objects with bounds (models, bounded primitives) can be hit.
+		int Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX) const
+		{
+			if (m_BvhDirty) return -1;
+			const SceneBVH::RayHit hit = m_Bvh.Raycast(origin, direction, maxDistance,
+				[this](uint32_t object) { return m_Nodes.IsVisible(object); });
+			return hit.object == SceneBVH::INVALID ? -1 : static_cast<int>(hit.object);
+		}
+
+		// Objects with bounds touching the sphere, appended to out
+		void QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const
+		{
+			if (!m_BvhDirty) m_Bvh.QuerySphere(center, radius, out);
+		}
+
 		Light* GetLight(size_t index)
 		{
 			return index < m_Lights.size() ? &m_Lights[index] : nullptr;
 		}
 
 		// Build draw list from all visible objects.
-		// If a frustum is provided, model-based objects are culled against it
-		// using their world-space AABB. Primitive objects (MeshDrawable) have
-		// no bounds data yet and are always submitted.
-		void BuildDrawList(DrawList& drawList, const Frustum* frustum = nullptr) const
+		// If a frustum is provided, objects with bounds (models, and primitives
+		// whose MeshDrawable has local bounds) are culled against their
+		// world-space AABB, and the meshes of visible multi-mesh models each
+		// against their own (DrawList::SetCullFrustum). Objects without bounds
+		// are always submitted.
+		//
+		// auxFrusta adds secondary views (editor ortho viewports and the like)
+		// culled in the same BVH traversal: each command's auxViewMask gets
+		// bit v set when the object touches auxFrusta[v], so every view draws
+		// from this one list instead of building its own. At most
+		// SceneBVH::MAX_QUERY_VIEWS - 1 auxiliary views.
+		void BuildDrawList(DrawList& drawList, const Frustum* frustum = nullptr,
+			const Frustum* auxFrusta = nullptr, uint32_t auxCount = 0) const
 		{
 			m_LastObjectCount = 0;
 			m_LastCulledCount = 0;
 
-			for (const auto& obj : m_Objects)
+			// Camera-frustum cull. We do NOT drop culled objects from the list — they're
+			// still submitted (marked cameraVisible=false) so the shadow and reflection
+			// passes draw them. A caster behind/beside the camera still casts a shadow into
+			// view; dropping it here is what made off-screen objects' shadows vanish.
+			// The world AABB also rides along on the commands for the Renderer's
+			// Hi-Z occlusion test. Objects without bounds are never culled.
+			// Bounds and flags stream straight from the node arrays (world bounds
+			// are current as of the last Update); SceneObjects are only touched
+			// for the drawables actually emitted. The BVH rejects and accepts
+			// whole subtrees; objects added or removed since the last Update
+			// (tree not rebuilt yet) fall back to one batched pass.
+			const AABBBatch& worldBounds = m_Nodes.GetWorldBounds();
+			const SceneNodes::Array<uint8_t>& flags = m_Nodes.GetFlags();
+
+			// m_CullVisible holds a view bitmask per object: bit 0 the camera,
+			// bit v+1 auxFrusta[v]. A null camera frustum sees everything.
+			auxCount = std::min(auxCount, SceneBVH::MAX_QUERY_VIEWS - 1);
+			Frustum views[SceneBVH::MAX_QUERY_VIEWS];
+			uint32_t viewCount = 0;
+			if (frustum)
+				views[viewCount++] = *frustum;
+			for (uint32_t v = 0; v < auxCount; ++v)
+				views[viewCount++] = auxFrusta[v];
+			const uint8_t firstBit = frustum ? 1 : 2;   // bit of views[0]
+
+			m_CullVisible.assign(worldBounds.Size(), frustum ? 0 : 1);
+			if (viewCount > 0 && !m_BvhDirty)
 			{
-				if (!obj.visible) continue;
-
-				auto* drawable = obj.GetDrawable();
-				if (!drawable) continue;
-
-				m_LastObjectCount++;
-
-				// Camera-frustum cull. We do NOT drop culled objects from the list — they're
-				// still submitted (marked cameraVisible=false) so the shadow and reflection
-				// passes draw them. A caster behind/beside the camera still casts a shadow into
-				// view; dropping it here is what made off-screen objects' shadows vanish.
-				bool cameraVisible = true;
-				if (frustum && obj.model)
+				if (viewCount == 1 && frustum)
 				{
-					glm::vec3 worldCenter, worldExtents;
-					TransformAABB(
-						obj.model->GetBoundsMin(), obj.model->GetBoundsMax(),
-						obj.model->GetTransform(),
-						worldCenter, worldExtents);
-
-					if (!frustum->Intersects(worldCenter, worldExtents))
+					m_Bvh.QueryFrustum(*frustum, m_CullVisible.data());
+				}
+				else if (frustum)
+				{
+					m_Bvh.QueryFrusta(views, viewCount, m_CullVisible.data());
+				}
+				else
+				{
+					// QueryFrusta sets bit v for views[v]; with no camera
+					// view the aux bits start one higher
+					m_CullViewScratch.assign(worldBounds.Size(), 0);
+					m_Bvh.QueryFrusta(views, viewCount, m_CullViewScratch.data());
+					for (size_t i = 0; i < m_CullVisible.size(); ++i)
+						m_CullVisible[i] |= static_cast<uint8_t>(m_CullViewScratch[i] << 1);
+				}
+			}
+			else if (viewCount > 0)
+			{
+				m_CullViewScratch.resize(worldBounds.Size());
+				for (uint32_t v = 0; v < viewCount; ++v)
+				{
+					views[v].IntersectsBatch(worldBounds, m_CullViewScratch.data());
+					const uint8_t bit = static_cast<uint8_t>(firstBit << v);
+					for (size_t i = 0; i < m_CullViewScratch.size(); ++i)
 					{
-						m_LastCulledCount++;
-						cameraVisible = false;
+						if (m_CullViewScratch[i])
+							m_CullVisible[i] |= bit;
 					}
 				}
+			}
 
-				drawList.AddDrawable(drawable, cameraVisible);
+			drawList.SetCullFrustum(frustum);
+
+			const uint32_t count = static_cast<uint32_t>(flags.size());
+			JobSystem& jobs = JobSystem::Get();
+			if (!jobs.IsRunning() || count <= PARALLEL_GRAIN)
+			{
+				EmitRange(drawList, 0, count, m_LastObjectCount, m_LastCulledCount);
+				return;
+			}
+
+			// One list per chunk, appended in chunk order: the same command
+			// order the serial path produces, before the caller sorts
+			const uint32_t chunkCount = (count + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+			if (m_ChunkLists.size() < chunkCount)
+				m_ChunkLists.resize(chunkCount);
+			m_ChunkStats.assign(chunkCount, ChunkStats{});
+
+			jobs.ParallelFor(count, PARALLEL_GRAIN, [this, &drawList](uint32_t begin, uint32_t end)
+				{
+					const uint32_t chunk = begin / PARALLEL_GRAIN;
+					m_ChunkLists[chunk].Clear();
+					m_ChunkLists[chunk].SetLodView(drawList.GetLodView());
+					m_ChunkLists[chunk].SetCullFrustum(drawList.GetCullFrustum());
+					EmitRange(m_ChunkLists[chunk], begin, end, m_ChunkStats[chunk].objects, m_ChunkStats[chunk].culled);
+				});
+
+			for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				drawList.Append(m_ChunkLists[chunk]);
+				m_LastObjectCount += m_ChunkStats[chunk].objects;
+				m_LastCulledCount += m_ChunkStats[chunk].culled;
 			}
 		}
 
 		size_t GetLastObjectCount() const { return m_LastObjectCount; }
 		size_t GetLastCulledCount() const { return m_LastCulledCount; }
 
-		// Build GPU-ready lighting data from all enabled lights
-		SceneLightingData BuildLightingData() const
+		// Build GPU-ready lighting data from the enabled lights: directional
+		// first, then the point lights inside frustum (null = all) by
+		// importance to viewPos, up to MAX_LIGHTS (see LightCulling.hpp)
+		SceneLightingData BuildLightingData(const Frustum* frustum = nullptr,
+			const glm::vec3& viewPos = glm::vec3(0.0f)) const
 		{
 			SceneLightingData data;
-			int count = 0;
+			m_LastCulledLightCount = SelectLights(m_Lights, frustum, viewPos, m_SelectedLights);
 
-			for (const auto& light : m_Lights)
-			{
-				if (!light.enabled) continue;
-				if (count >= static_cast<int>(MAX_LIGHTS)) break;
-
-				data.lights[count] = light.ToGPUData();
-				count++;
-			}
+			const size_t count = std::min(m_SelectedLights.size(), static_cast<size_t>(MAX_LIGHTS));
+			for (size_t i = 0; i < count; ++i)
+				data.lights[i] = m_SelectedLights[i];
 
-			data.numLights = count;
+			data.numLights = static_cast<int>(count);
 			data.ambient = glm::vec4(m_AmbientColor, m_AmbientIntensity);
 
 			return data;
 		}
 
+		// Every enabled point light inside frustum (null = all), by
+		// importance and uncapped, for the renderer's light clusters
+		// (Renderer::SetPointLights). Reuses out's capacity.
+		void BuildPointLights(std::vector<LightData>& out, const Frustum* frustum = nullptr,
+			const glm::vec3& viewPos = glm::vec3(0.0f)) const
+		{
+			m_LastCulledLightCount = SelectLights(m_Lights, frustum, viewPos, out, true);
+		}
+
+		// Point lights the last Build* call culled against its frustum
+		size_t GetLastCulledLightCount() const { return m_LastCulledLightCount; }
+
 		void Update(float deltaTime)
 		{
-			for (auto& obj : m_Objects)
-			{
-				if (obj.drawable)
-				{
-					obj.drawable->Update(deltaTime);
-				}
-				if (obj.meshDrawable)
+			// Drawables animate independently of each other, so object ranges
+			// go to the job system (serially below PARALLEL_GRAIN objects)
+			JobSystem::Get().ParallelFor(static_cast<uint32_t>(m_Objects.size()), PARALLEL_GRAIN,
+				[this, deltaTime](uint32_t begin, uint32_t end)
 				{
-					obj.meshDrawable->Update(deltaTime);
-				}
+					for (uint32_t i = begin; i < end; ++i)
+					{
+						SceneObject& obj = m_Objects[i];
+						if (obj.drawable)
+						{
+							obj.drawable->Update(deltaTime);
+						}
+						if (obj.meshDrawable)
+						{
+							obj.meshDrawable->Update(deltaTime);
+						}
+					}
+				});
+
+			UpdateTransforms();
+		}
+
+		// Recompute the world transforms/bounds of moved nodes (and their
+		// children), push them to the drawables and refit the BVH (rebuilt
+		// instead after adds/removes). Update calls this; objects moved after
+		// it are drawn where they were until the next one.
+		void UpdateTransforms()
+		{
+			const uint32_t moved = m_Nodes.Update();
+			if (m_BvhDirty)
+			{
+				m_Bvh.Build(m_Nodes);
+				m_BvhDirty = false;
 			}
+			else if (moved > 0)
+			{
+				m_Bvh.Refit(m_Nodes, m_Nodes.GetUpdated());
+			}
+
+			const SceneNodes::Array<uint32_t>& updated = m_Nodes.GetUpdated();
+			JobSystem::Get().ParallelFor(static_cast<uint32_t>(updated.size()), PARALLEL_GRAIN,
+				[this, &updated](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; ++i)
+					{
+						SceneObject& obj = m_Objects[updated[i]];
+						const glm::mat4& world = m_Nodes.GetWorld(updated[i]);
+						if (obj.drawable) obj.drawable->SetTransform(world);
+						if (obj.meshDrawable) obj.meshDrawable->SetTransform(world);
+					}
+				});
 		}
 
 		// Remove object by index
@@ -349,6 +598,11 @@ namespace Nightbloom
 			if (index < m_Objects.size())
 			{
 				m_Objects.erase(m_Objects.begin() + index);
+				m_Nodes.Remove(static_cast<uint32_t>(index));
+				m_BvhDirty = true;
+				++m_StructureVersion;
+				for (size_t i = index; i < m_Objects.size(); ++i)
+					m_Objects[i].node = static_cast<uint32_t>(i);
 
 				// Adjust selection
 				if (m_SelectedIndex == static_cast<int>(index))
@@ -373,11 +627,65 @@ namespace Nightbloom
 		void Clear()
 		{
 			m_Objects.clear();
+			m_Nodes.Clear();
+			m_Bvh.Clear();
+			m_BvhDirty = false;
 			m_SelectedIndex = -1;
+			++m_StructureVersion;
 		}
 
 	private:
+		// BuildDrawList's emission over objects [begin, end); m_CullVisible
+		// must be filled. Touches nothing shared but the read-only node data,
+		// so disjoint ranges can run on different threads.
+		void EmitRange(DrawList& drawList, uint32_t begin, uint32_t end, size_t& objectCount, size_t& culledCount) const
+		{
+			const AABBBatch& worldBounds = m_Nodes.GetWorldBounds();
+			const SceneNodes::Array<uint8_t>& flags = m_Nodes.GetFlags();
+
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				if (!(flags[i] & SceneNodes::Visible)) continue;
+
+				auto* drawable = m_Objects[i].GetDrawable();
+				if (!drawable) continue;
+
+				objectCount++;
+
+				if (!(flags[i] & SceneNodes::HasBounds))
+				{
+					drawList.AddDrawable(drawable, true, nullptr);
+					continue;
+				}
+
+				DrawBounds bounds;
+				bounds.center = glm::vec3(worldBounds.cx[i], worldBounds.cy[i], worldBounds.cz[i]);
+				bounds.extents = glm::vec3(worldBounds.ex[i], worldBounds.ey[i], worldBounds.ez[i]);
+				const bool cameraVisible = (m_CullVisible[i] & 1) != 0;
+				if (!cameraVisible)
+					culledCount++;
+
+				drawList.AddDrawable(drawable, cameraVisible, &bounds, static_cast<uint8_t>(m_CullVisible[i] >> 1));
+			}
+		}
+
+		void AttachNode(SceneObject& obj)
+		{
+			obj.nodes = &m_Nodes;
+			obj.node = m_Nodes.Add(obj.GetLocalTransform());
+			if (obj.model)
+				m_Nodes.SetLocalBounds(obj.node, obj.model->GetBoundsMin(), obj.model->GetBoundsMax());
+			else if (obj.meshDrawable && obj.meshDrawable->HasLocalBounds())
+				m_Nodes.SetLocalBounds(obj.node, obj.meshDrawable->GetLocalBoundsMin(), obj.meshDrawable->GetLocalBoundsMax());
+			m_BvhDirty = true;
+			++m_StructureVersion;
+		}
+
 		std::vector<SceneObject> m_Objects;
+		SceneNodes m_Nodes;                          // parallel to m_Objects
+		SceneBVH m_Bvh;                              // over m_Nodes' world bounds
+		bool m_BvhDirty = false;                     // objects added/removed since the last build
+		uint64_t m_StructureVersion = 0;
 		std::vector<Light> m_Lights;
 		int m_SelectedIndex = -1;
 		int m_SelectedLightIndex = -1;
@@ -387,6 +695,19 @@ namespace Nightbloom
 		// Stats from the most recent BuildDrawList call (for debug display)
 		mutable size_t m_LastObjectCount = 0;
 		mutable size_t m_LastCulledCount = 0;
+		mutable size_t m_LastCulledLightCount = 0;
+		mutable std::vector<uint8_t> m_CullVisible;   // BuildDrawList scratch, view bits per object
+		mutable std::vector<uint8_t> m_CullViewScratch;
+
+		// Parallel BuildDrawList: a heap-backed list and counters per chunk
+		struct ChunkStats
+		{
+			size_t objects = 0;
+			size_t culled = 0;
+		};
+		mutable std::vector<DrawList> m_ChunkLists;
+		mutable std::vector<ChunkStats> m_ChunkStats;
+		mutable std::vector<LightData> m_SelectedLights;   // BuildLightingData scratch
 	};
 
 } // namespace Nightbloom
\ No newline at end of file
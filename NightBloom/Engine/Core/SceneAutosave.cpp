@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+// SceneAutosave.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/SceneAutosave.hpp"
+#include "Core/Logger/Logger.hpp"
+#include "Core/CpuProfiler.hpp"
+#include <filesystem>
+
+namespace Nightbloom
+{
+	std::string SceneAutosave::GetAutosavePath(const std::string& scenePath)
+	{
+		if (scenePath.empty())
+			return (std::filesystem::temp_directory_path() / "Nightbloom_Untitled.autosave.nbscene").string();
+
+		std::filesystem::path path(scenePath);
+		path.replace_extension(".autosave.nbscene");
+		return path.string();
+	}
+
+	SceneAutosave::~SceneAutosave()
+	{
+		Stop();
+	}
+
+	void SceneAutosave::Start()
+	{
+		if (IsRunning())
+			return;
+
+		m_Quit = false;
+		m_Thread = std::thread([this]() { ThreadLoop(); });
+	}
+
+	void SceneAutosave::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Quit = true;
+		}
+		m_Cv.notify_all();
+		m_Thread.join();
+	}
+
+	bool SceneAutosave::Tick(float deltaTime)
+	{
+		if (m_Interval <= 0.0f)
+			return false;
+
+		m_Elapsed += deltaTime;
+		if (m_Elapsed < m_Interval || IsBusy())
+			return false;
+
+		m_Elapsed = 0.0f;
+		return true;
+	}
+
+	void SceneAutosave::Submit(SceneFileData snapshot, const std::string& path)
+	{
+		Request request{ std::move(snapshot), path };
+		if (!IsRunning())
+		{
+			Write(request);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Pending = std::move(request);
+		}
+		m_Cv.notify_one();
+	}
+
+	void SceneAutosave::Flush()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_IdleCv.wait(lock, [this]() { return !m_Pending && !m_Writing; });
+	}
+
+	bool SceneAutosave::IsBusy() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Pending.has_value() || m_Writing;
+	}
+
+	void SceneAutosave::ThreadLoop()
+	{
+		NB_PROFILE_THREAD("Scene Autosave");
+		while (true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Cv.wait(lock, [this]() { return m_Quit || m_Pending; });
+
+				// A snapshot still queued at shutdown is written, not dropped
+				if (!m_Pending)
+					return;
+				request = std::move(*m_Pending);
+				m_Pending.reset();
+				m_Writing = true;
+			}
+
+			Write(request);
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Writing = false;
+			}
+			m_IdleCv.notify_all();
+		}
+	}
+
+	void SceneAutosave::Write(const Request& request)
+	{
+		NB_PROFILE_SCOPE("Autosave Write");
+		std::vector<uint8_t> bytes = EncodeSceneBinary(request.snapshot);
+		if (request.path == m_LastPath && bytes == m_LastBytes)
+		{
+			m_UnchangedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		std::string error;
+		if (!WriteSceneBytes(request.path, bytes, error))
+		{
+			m_FailureCount.fetch_add(1, std::memory_order_relaxed);
+			LOG_WARN("SceneAutosave: failed to write '{}': {}", request.path, error);
+			return;
+		}
+
+		LOG_INFO("SceneAutosave: saved '{}' ({} objects, {} KB)", request.path,
+			request.snapshot.objects.size(), bytes.size() / 1024);
+		m_WriteCount.fetch_add(1, std::memory_order_relaxed);
+		m_LastPath = request.path;
+		m_LastBytes = std::move(bytes);
+	}
+}
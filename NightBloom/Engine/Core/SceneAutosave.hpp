@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+// SceneAutosave.hpp
+//
+// Periodic scene autosave that keeps the main thread out of serialization.
+// The main thread only captures a SceneFileData snapshot (plain copies of
+// transforms, names and light settings - SceneSerializer::Capture) and hands
+// it over with Submit(); a background thread encodes it, compares the bytes
+// with the last file it wrote to that path, and writes only when something
+// changed (temporary file + rename, so a crash mid-write keeps the previous
+// autosave).
+//
+// Snapshots queue at most one deep: one submitted while an older one is
+// still waiting replaces it, so a slow disk never builds a backlog.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/SceneFile.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	class SceneAutosave
+	{
+	public:
+		static constexpr float DEFAULT_INTERVAL_SECONDS = 120.0f;
+
+		// "<scene>.autosave.nbscene" next to the scene; a fixed name in the
+		// temp directory for a scene never saved
+		static std::string GetAutosavePath(const std::string& scenePath);
+
+		SceneAutosave() = default;
+		~SceneAutosave();
+
+		SceneAutosave(const SceneAutosave&) = delete;
+		SceneAutosave& operator=(const SceneAutosave&) = delete;
+
+		// Starts the writer thread; no-op while running
+		void Start();
+
+		// Writes out a queued snapshot, then joins the thread
+		void Stop();
+
+		bool IsRunning() const { return m_Thread.joinable(); }
+
+		// 0 disables the timer; Submit still works
+		void SetInterval(float seconds) { m_Interval = seconds; }
+		float GetInterval() const { return m_Interval; }
+
+		// Advances the timer; true once per interval, when a snapshot is due.
+		// Stays false while the previous one is still being written.
+		bool Tick(float deltaTime);
+
+		// Queues `snapshot` to be written to `path` (binary). Without Start()
+		// it is written inline.
+		void Submit(SceneFileData snapshot, const std::string& path);
+
+		// Blocks until everything submitted so far has been handled
+		void Flush();
+
+		bool IsBusy() const;
+
+		uint32_t GetWriteCount() const { return m_WriteCount.load(std::memory_order_relaxed); }
+		uint32_t GetUnchangedCount() const { return m_UnchangedCount.load(std::memory_order_relaxed); }
+		uint32_t GetFailureCount() const { return m_FailureCount.load(std::memory_order_relaxed); }
+
+	private:
+		struct Request
+		{
+			SceneFileData snapshot;
+			std::string path;
+		};
+
+		void ThreadLoop();
+		void Write(const Request& request);
+
+		std::thread m_Thread;
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Cv;      // work queued / quit
+		std::condition_variable m_IdleCv;  // request handled
+		std::optional<Request> m_Pending;
+		bool m_Writing = false;
+		bool m_Quit = false;
+
+		// Writer thread only
+		std::string m_LastPath;
+		std::vector<uint8_t> m_LastBytes;
+
+		float m_Interval = DEFAULT_INTERVAL_SECONDS;
+		float m_Elapsed = 0.0f;
+
+		std::atomic<uint32_t> m_WriteCount{ 0 };
+		std::atomic<uint32_t> m_UnchangedCount{ 0 };
+		std::atomic<uint32_t> m_FailureCount{ 0 };
+	};
+}
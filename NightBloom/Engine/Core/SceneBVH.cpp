@@ -0,0 +1,462 @@
+//------------------------------------------------------------------------------
+// SceneBVH.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/SceneBVH.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Deep enough for any median-split tree of 2^32 objects
+		constexpr size_t MAX_DEPTH = 64;
+
+		float SurfaceArea(const glm::vec3& boxMin, const glm::vec3& boxMax)
+		{
+			const glm::vec3 d = boxMax - boxMin;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		bool Overlaps(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax)
+		{
+			return aMin.x <= bMax.x && aMax.x >= bMin.x &&
+				aMin.y <= bMax.y && aMax.y >= bMin.y &&
+				aMin.z <= bMax.z && aMax.z >= bMin.z;
+		}
+
+		bool TouchesSphere(const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::vec3& center, float radiusSq)
+		{
+			const glm::vec3 d = glm::clamp(center, boxMin, boxMax) - center;
+			return glm::dot(d, d) <= radiusSq;
+		}
+
+		// Slab test; entry distance clamped to 0 when the origin is inside
+		bool RayBox(const glm::vec3& origin, const glm::vec3& invDir, const glm::vec3& boxMin,
+			const glm::vec3& boxMax, float maxDistance, float& entry)
+		{
+			const glm::vec3 t0 = (boxMin - origin) * invDir;
+			const glm::vec3 t1 = (boxMax - origin) * invDir;
+			const glm::vec3 tNear = glm::min(t0, t1);
+			const glm::vec3 tFar = glm::max(t0, t1);
+			entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+			const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+			return entry <= exit;
+		}
+
+		glm::vec3 BoundsCenter(const AABBBatch& bounds, uint32_t object)
+		{
+			return glm::vec3(bounds.cx[object], bounds.cy[object], bounds.cz[object]);
+		}
+
+		glm::vec3 BoundsExtents(const AABBBatch& bounds, uint32_t object)
+		{
+			return glm::vec3(bounds.ex[object], bounds.ey[object], bounds.ez[object]);
+		}
+	}
+
+	void SceneBVH::Build(const SceneNodes& nodes)
+	{
+		Clear();
+
+		const AABBBatch& bounds = nodes.GetWorldBounds();
+		const SceneNodes::Array<uint8_t>& flags = nodes.GetFlags();
+		m_ObjectSlot.assign(nodes.Size(), INVALID);
+		for (uint32_t object = 0; object < nodes.Size(); ++object)
+		{
+			if (flags[object] & SceneNodes::HasBounds)
+				m_Items.push_back(object);
+		}
+		if (m_Items.empty())
+			return;
+
+		const uint32_t count = static_cast<uint32_t>(m_Items.size());
+		m_ItemMin.resize(count);
+		m_ItemMax.resize(count);
+		m_ItemLeaf.resize(count);
+		m_Nodes.reserve(2 * count / LEAF_SIZE + 1);
+		m_Nodes.push_back({});
+		m_Nodes[0].parent = INVALID;
+		BuildNode(bounds, 0, 0, count);
+
+		for (uint32_t slot = 0; slot < count; ++slot)
+			m_ObjectSlot[m_Items[slot]] = slot;
+
+		m_BuildCost = 0.0f;
+		for (const Node& node : m_Nodes)
+			m_BuildCost += SurfaceArea(node.min, node.max);
+		m_Cost = m_BuildCost;
+	}
+
+	void SceneBVH::BuildNode(const AABBBatch& bounds, uint32_t node, uint32_t first, uint32_t count)
+	{
+		glm::vec3 boxMin(FLT_MAX), boxMax(-FLT_MAX);
+		glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+		for (uint32_t slot = first; slot < first + count; ++slot)
+		{
+			const glm::vec3 center = BoundsCenter(bounds, m_Items[slot]);
+			const glm::vec3 extents = BoundsExtents(bounds, m_Items[slot]);
+			m_ItemMin[slot] = center - extents;
+			m_ItemMax[slot] = center + extents;
+			boxMin = glm::min(boxMin, m_ItemMin[slot]);
+			boxMax = glm::max(boxMax, m_ItemMax[slot]);
+			centroidMin = glm::min(centroidMin, center);
+			centroidMax = glm::max(centroidMax, center);
+		}
+
+		m_Nodes[node].min = boxMin;
+		m_Nodes[node].max = boxMax;
+		m_Nodes[node].first = first;
+		m_Nodes[node].count = count;
+		m_Nodes[node].left = 0;
+
+		if (count <= LEAF_SIZE)
+		{
+			for (uint32_t slot = first; slot < first + count; ++slot)
+				m_ItemLeaf[slot] = node;
+			return;
+		}
+
+		// Median on the longest centroid axis: balanced, so depth stays log2(n)
+		const glm::vec3 spread = centroidMax - centroidMin;
+		const int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+		const std::vector<float>& axisCenters = axis == 0 ? bounds.cx : (axis == 1 ? bounds.cy : bounds.cz);
+		const uint32_t half = count / 2;
+		std::nth_element(m_Items.begin() + first, m_Items.begin() + first + half, m_Items.begin() + first + count,
+			[&](uint32_t a, uint32_t b) { return axisCenters[a] < axisCenters[b]; });
+
+		const uint32_t left = static_cast<uint32_t>(m_Nodes.size());
+		m_Nodes[node].left = left;
+		m_Nodes.push_back({});
+		m_Nodes.push_back({});
+		m_Nodes[left].parent = node;
+		m_Nodes[left + 1].parent = node;
+		BuildNode(bounds, left, first, half);
+		BuildNode(bounds, left + 1, first + half, count - half);
+	}
+
+	bool SceneBVH::FitNode(uint32_t index)
+	{
+		Node& node = m_Nodes[index];
+		glm::vec3 boxMin(FLT_MAX), boxMax(-FLT_MAX);
+		if (node.left == 0)
+		{
+			for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+			{
+				boxMin = glm::min(boxMin, m_ItemMin[slot]);
+				boxMax = glm::max(boxMax, m_ItemMax[slot]);
+			}
+		}
+		else
+		{
+			const Node& a = m_Nodes[node.left];
+			const Node& b = m_Nodes[node.left + 1];
+			boxMin = glm::min(a.min, b.min);
+			boxMax = glm::max(a.max, b.max);
+		}
+
+		if (boxMin == node.min && boxMax == node.max)
+			return false;
+
+		m_Cost += SurfaceArea(boxMin, boxMax) - SurfaceArea(node.min, node.max);
+		node.min = boxMin;
+		node.max = boxMax;
+		return true;
+	}
+
+	bool SceneBVH::Refit(const SceneNodes& nodes, const SceneNodes::Array<uint32_t>& moved)
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		const AABBBatch& bounds = nodes.GetWorldBounds();
+		m_RefitLeaves.clear();
+		for (uint32_t object : moved)
+		{
+			const uint32_t slot = object < m_ObjectSlot.size() ? m_ObjectSlot[object] : INVALID;
+			if (slot == INVALID)
+				continue;
+
+			const glm::vec3 center = BoundsCenter(bounds, object);
+			const glm::vec3 extents = BoundsExtents(bounds, object);
+			m_ItemMin[slot] = center - extents;
+			m_ItemMax[slot] = center + extents;
+			m_RefitLeaves.push_back(m_ItemLeaf[slot]);
+		}
+
+		std::sort(m_RefitLeaves.begin(), m_RefitLeaves.end());
+		m_RefitLeaves.erase(std::unique(m_RefitLeaves.begin(), m_RefitLeaves.end()), m_RefitLeaves.end());
+
+		// Up from each leaf until a node comes out unchanged: its ancestors
+		// were already correct (or are fixed by another leaf's walk)
+		for (uint32_t node : m_RefitLeaves)
+		{
+			while (node != INVALID && FitNode(node))
+				node = m_Nodes[node].parent;
+		}
+
+		if (m_Cost > REBUILD_RATIO * m_BuildCost)
+		{
+			Build(nodes);
+			return true;
+		}
+		return false;
+	}
+
+	void SceneBVH::Clear()
+	{
+		m_Nodes.clear();
+		m_Items.clear();
+		m_ItemMin.clear();
+		m_ItemMax.clear();
+		m_ItemLeaf.clear();
+		m_ObjectSlot.clear();
+		m_BuildCost = 0.0f;
+		m_Cost = 0.0f;
+	}
+
+	void SceneBVH::QueryFrustum(const Frustum& frustum, uint8_t* visible) const
+	{
+		if (m_Nodes.empty())
+			return;
+
+		// Each entry carries the planes its parent still straddled
+		uint32_t stack[MAX_DEPTH * 2];
+		uint32_t masks[MAX_DEPTH * 2];
+		size_t top = 0;
+		stack[top] = 0;
+		masks[top++] = Frustum::ALL_PLANES;
+
+		while (top > 0)
+		{
+			--top;
+			const Node& node = m_Nodes[stack[top]];
+			uint32_t mask = masks[top];
+			const Frustum::Overlap overlap = frustum.Classify((node.min + node.max) * 0.5f, (node.max - node.min) * 0.5f, mask);
+			if (overlap == Frustum::Overlap::Outside)
+				continue;
+
+			if (overlap == Frustum::Overlap::Inside)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+					visible[m_Items[slot]] = 1;
+				continue;
+			}
+
+			if (node.left == 0)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+				{
+					uint32_t itemMask = mask;
+					if (frustum.Classify((m_ItemMin[slot] + m_ItemMax[slot]) * 0.5f,
+						(m_ItemMax[slot] - m_ItemMin[slot]) * 0.5f, itemMask) != Frustum::Overlap::Outside)
+					{
+						visible[m_Items[slot]] = 1;
+					}
+				}
+				continue;
+			}
+
+			stack[top] = node.left;
+			masks[top++] = mask;
+			stack[top] = node.left + 1;
+			masks[top++] = mask;
+		}
+	}
+
+	void SceneBVH::QueryFrusta(const Frustum* frusta, uint32_t viewCount, uint8_t* viewMasks) const
+	{
+		viewCount = std::min(viewCount, MAX_QUERY_VIEWS);
+		if (m_Nodes.empty() || viewCount == 0)
+			return;
+
+		// Each entry carries the views still straddling its parent and, per
+		// view, the planes they straddled
+		struct Entry
+		{
+			uint32_t node;
+			uint32_t active;
+			uint32_t planes[MAX_QUERY_VIEWS];
+		};
+		Entry stack[MAX_DEPTH * 2];
+		size_t top = 0;
+		stack[top].node = 0;
+		stack[top].active = (1u << viewCount) - 1;
+		for (uint32_t v = 0; v < viewCount; ++v)
+			stack[top].planes[v] = Frustum::ALL_PLANES;
+		++top;
+
+		while (top > 0)
+		{
+			Entry entry = stack[--top];
+			const Node& node = m_Nodes[entry.node];
+			const glm::vec3 center = (node.min + node.max) * 0.5f;
+			const glm::vec3 extents = (node.max - node.min) * 0.5f;
+
+			uint32_t accepted = 0;
+			for (uint32_t v = 0; v < viewCount; ++v)
+			{
+				if (!(entry.active & (1u << v)))
+					continue;
+				const Frustum::Overlap overlap = frusta[v].Classify(center, extents, entry.planes[v]);
+				if (overlap == Frustum::Overlap::Intersects)
+					continue;
+				entry.active &= ~(1u << v);
+				if (overlap == Frustum::Overlap::Inside)
+					accepted |= 1u << v;
+			}
+
+			if (accepted)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+					viewMasks[m_Items[slot]] |= static_cast<uint8_t>(accepted);
+			}
+			if (entry.active == 0)
+				continue;
+
+			if (node.left == 0)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+				{
+					const glm::vec3 itemCenter = (m_ItemMin[slot] + m_ItemMax[slot]) * 0.5f;
+					const glm::vec3 itemExtents = (m_ItemMax[slot] - m_ItemMin[slot]) * 0.5f;
+					uint8_t bits = 0;
+					for (uint32_t v = 0; v < viewCount; ++v)
+					{
+						uint32_t itemMask = entry.planes[v];
+						if ((entry.active & (1u << v)) &&
+							frusta[v].Classify(itemCenter, itemExtents, itemMask) != Frustum::Overlap::Outside)
+						{
+							bits |= static_cast<uint8_t>(1u << v);
+						}
+					}
+					viewMasks[m_Items[slot]] |= bits;
+				}
+				continue;
+			}
+
+			entry.node = node.left;
+			stack[top++] = entry;
+			entry.node = node.left + 1;
+			stack[top++] = entry;
+		}
+	}
+
+	void SceneBVH::QueryBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<uint32_t>& out) const
+	{
+		if (m_Nodes.empty())
+			return;
+
+		uint32_t stack[MAX_DEPTH * 2];
+		size_t top = 0;
+		stack[top++] = 0;
+		while (top > 0)
+		{
+			const Node& node = m_Nodes[stack[--top]];
+			if (!Overlaps(node.min, node.max, boxMin, boxMax))
+				continue;
+
+			if (node.left == 0)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+				{
+					if (Overlaps(m_ItemMin[slot], m_ItemMax[slot], boxMin, boxMax))
+						out.push_back(m_Items[slot]);
+				}
+				continue;
+			}
+			stack[top++] = node.left;
+			stack[top++] = node.left + 1;
+		}
+	}
+
+	void SceneBVH::QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const
+	{
+		if (m_Nodes.empty())
+			return;
+
+		const float radiusSq = radius * radius;
+		uint32_t stack[MAX_DEPTH * 2];
+		size_t top = 0;
+		stack[top++] = 0;
+		while (top > 0)
+		{
+			const Node& node = m_Nodes[stack[--top]];
+			if (!TouchesSphere(node.min, node.max, center, radiusSq))
+				continue;
+
+			if (node.left == 0)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+				{
+					if (TouchesSphere(m_ItemMin[slot], m_ItemMax[slot], center, radiusSq))
+						out.push_back(m_Items[slot]);
+				}
+				continue;
+			}
+			stack[top++] = node.left;
+			stack[top++] = node.left + 1;
+		}
+	}
+
+	SceneBVH::RayHit SceneBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+		const std::function<bool(uint32_t)>& filter) const
+	{
+		RayHit hit;
+		hit.distance = maxDistance;
+		if (m_Nodes.empty())
+			return hit;
+
+		const glm::vec3 invDir = 1.0f / direction;
+		uint32_t stack[MAX_DEPTH * 2];
+		size_t top = 0;
+		stack[top++] = 0;
+		while (top > 0)
+		{
+			const Node& node = m_Nodes[stack[--top]];
+			float entry;
+			if (!RayBox(origin, invDir, node.min, node.max, hit.distance, entry))
+				continue;
+
+			if (node.left == 0)
+			{
+				for (uint32_t slot = node.first; slot < node.first + node.count; ++slot)
+				{
+					const uint32_t object = m_Items[slot];
+					if (RayBox(origin, invDir, m_ItemMin[slot], m_ItemMax[slot], hit.distance, entry) &&
+						entry < hit.distance && (!filter || filter(object)))
+					{
+						hit.object = object;
+						hit.distance = entry;
+					}
+				}
+				continue;
+			}
+
+			// Nearer child on top, so its hits shrink the far one's range first
+			const Node& a = m_Nodes[node.left];
+			const Node& b = m_Nodes[node.left + 1];
+			float entryA, entryB;
+			const bool hitA = RayBox(origin, invDir, a.min, a.max, hit.distance, entryA);
+			const bool hitB = RayBox(origin, invDir, b.min, b.max, hit.distance, entryB);
+			if (hitA && hitB)
+			{
+				const bool aFirst = entryA <= entryB;
+				stack[top++] = aFirst ? node.left + 1 : node.left;
+				stack[top++] = aFirst ? node.left : node.left + 1;
+			}
+			else if (hitA)
+			{
+				stack[top++] = node.left;
+			}
+			else if (hitB)
+			{
+				stack[top++] = node.left + 1;
+			}
+		}
+
+		if (hit.object == INVALID)
+			hit.distance = FLT_MAX;
+		return hit;
+	}
+}
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+// SceneBVH.hpp
+//
+// Bounding volume hierarchy over the world bounds of a SceneNodes (nodes
+// without bounds are not indexed), for frustum culling with hierarchical
+// rejection, ray picking and box/sphere range queries.
+//
+// Built top-down by median split on the longest centroid axis, so every
+// subtree covers one contiguous range of the item arrays: a subtree wholly
+// inside a frustum is accepted without testing its objects. Moving objects
+// refit it — leaf bounds are recomputed and the change propagated up until a
+// parent stops growing or shrinking — and it is only rebuilt once refitting
+// has let the summed node surface area (the tree's traversal cost) grow past
+// REBUILD_RATIO times what the last build produced.
+//
+// Queries report object indices (SceneNodes / Scene::GetObjects order).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/SceneNodes.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include <glm/glm.hpp>
+#include <cfloat>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Nightbloom
+{
+	class SceneBVH
+	{
+	public:
+		static constexpr uint32_t INVALID = UINT32_MAX;
+		static constexpr uint32_t LEAF_SIZE = 4;
+		static constexpr float REBUILD_RATIO = 1.5f;
+
+		struct RayHit
+		{
+			uint32_t object = INVALID;
+			float distance = FLT_MAX;   // in units of the ray direction's length
+		};
+
+		void Build(const SceneNodes& nodes);
+
+		// Refits to the current world bounds of moved (SceneNodes::GetUpdated
+		// after the nodes' Update). nodes must hold the objects the tree was
+		// built over. Returns true if the tree degraded enough to be rebuilt.
+		bool Refit(const SceneNodes& nodes, const SceneNodes::Array<uint32_t>& moved);
+
+		void Clear();
+
+		size_t GetObjectCount() const { return m_Items.size(); }
+		size_t GetNodeCount() const { return m_Nodes.size(); }
+
+		// Sets visible[object] = 1 for every indexed object that touches
+		// frustum; other entries are left alone
+		void QueryFrustum(const Frustum& frustum, uint8_t* visible) const;
+
+		// Several views in one traversal: sets bit v of viewMasks[object] for
+		// every indexed object that touches frusta[v] (other bits and entries
+		// are left alone). A subtree is descended while any view still
+		// straddles it, and each view stops being tested below the node that
+		// rejects or wholly accepts it. Up to MAX_QUERY_VIEWS views.
+		static constexpr uint32_t MAX_QUERY_VIEWS = 8;
+		void QueryFrusta(const Frustum* frusta, uint32_t viewCount, uint8_t* viewMasks) const;
+
+		// Appends the indexed objects whose box touches the box / sphere
+		void QueryBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<uint32_t>& out) const;
+		void QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+		// Nearest object box the ray enters within maxDistance (a ray starting
+		// inside a box hits it at 0). Objects filter rejects are skipped.
+		RayHit Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX,
+			const std::function<bool(uint32_t)>& filter = {}) const;
+
+	private:
+		// 'left' is the first of two adjacent children, or 0 for a leaf (the
+		// root is node 0, so it is never anyone's child). [first, first+count)
+		// is the subtree's range of item slots.
+		struct Node
+		{
+			glm::vec3 min;
+			uint32_t left;
+			glm::vec3 max;
+			uint32_t first;
+			uint32_t count;
+			uint32_t parent;
+		};
+
+		void BuildNode(const AABBBatch& bounds, uint32_t node, uint32_t first, uint32_t count);
+		bool FitNode(uint32_t node);   // from its items or children; true if it changed
+
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t>  m_Items;        // object per slot
+		std::vector<glm::vec3> m_ItemMin;      // world box per slot
+		std::vector<glm::vec3> m_ItemMax;
+		std::vector<uint32_t>  m_ItemLeaf;     // leaf node per slot
+		std::vector<uint32_t>  m_ObjectSlot;   // slot per object, INVALID = not indexed
+		std::vector<uint32_t>  m_RefitLeaves;  // Refit scratch
+		float m_BuildCost = 0.0f;
+		float m_Cost = 0.0f;
+	};
+}
@@ -0,0 +1,720 @@
+//------------------------------------------------------------------------------
+// SceneFile.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/SceneFile.hpp"
+#include "Engine/Core/CpuMemory.hpp"
+#include "Engine/Core/MappedFile.hpp"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+	// Documents count their values, arrays and objects as Serializer memory
+	// (string contents stay on the global heap)
+	template<typename T>
+	using SerializerAllocator = TrackedAllocator<T, CpuMemoryCategory::Serializer>;
+	using json = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t,
+		double, SerializerAllocator>;
+
+	//--------------------------------------------------------------------------
+	// Binary layout. Every record is copied in and out whole, so the structs
+	// are the format: change one and bump SCENE_BINARY_VERSION.
+	//--------------------------------------------------------------------------
+	namespace
+	{
+		constexpr char SCENE_MAGIC[4] = { 'N', 'B', 'S', 'C' };
+
+		// A string in the table at the end of the file
+		struct StringRef
+		{
+			uint32_t offset;
+			uint32_t length;
+		};
+
+		struct BinaryHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t lightCount;
+			uint32_t objectCount;
+			uint32_t stringBytes;
+			StringRef name;
+			StringRef editorJson;
+			glm::vec3 cameraPosition;
+			float cameraYaw;
+			float cameraPitch;
+			float cameraFov;
+			float cameraNear;
+			glm::vec3 ambientColor;
+			float ambientIntensity;
+		};
+		static_assert(sizeof(BinaryHeader) == 80);
+
+		// BinaryLight::flags
+		constexpr uint32_t LIGHT_ENABLED = 1u << 0;
+		constexpr uint32_t LIGHT_CASTS_SHADOWS = 1u << 1;
+		constexpr uint32_t LIGHT_CACHE_FAR_CASCADES = 1u << 2;
+		constexpr uint32_t LIGHT_SINGLE_PASS_CASCADES = 1u << 3;
+		constexpr uint32_t LIGHT_FIXED_SPLITS = 1u << 4;  // !fitSplitsToDepth, so older files load the default
+
+		struct BinaryLight
+		{
+			StringRef name;
+			int32_t type;
+			uint32_t flags;
+			glm::vec3 color;
+			float intensity;
+			glm::vec3 direction;
+			glm::vec3 position;
+			float constant;
+			float linear;
+			float quadratic;
+			float radius;
+			float orthoSize;
+			float nearPlane;
+			float farPlane;
+			float bias;
+			float normalBias;
+			float shadowDistance;
+			float splitLambda;
+			float casterExtrude;
+			float cascadeBlend;
+			uint32_t nearCascadesPerFrame;
+			uint32_t farCascadeRefreshFrames;
+			float cacheLightAngleDeg;
+			float cachePadding;
+		};
+		static_assert(sizeof(BinaryLight) == 124);
+
+		struct BinaryObject
+		{
+			uint8_t kind;
+			uint8_t visible;
+			uint16_t reserved;
+			int32_t parent;
+			int32_t pipeline;
+			StringRef name;
+			StringRef source;
+			StringRef primitive;
+			StringRef texture;
+		};
+		static_assert(sizeof(BinaryObject) == 44);
+
+		// Kept apart from BinaryObject so a load reads them as one block
+		struct BinaryTransform
+		{
+			glm::vec3 position;
+			glm::vec3 rotation;
+			glm::vec3 scale;
+			glm::vec4 customData;
+		};
+		static_assert(sizeof(BinaryTransform) == 52);
+
+		// Deduplicating string table: instanced models share their source
+		class StringTable
+		{
+		public:
+			StringRef Add(const std::string& s)
+			{
+				auto it = m_Refs.find(s);
+				if (it != m_Refs.end())
+					return it->second;
+
+				const StringRef ref{ static_cast<uint32_t>(m_Bytes.size()), static_cast<uint32_t>(s.size()) };
+				m_Bytes.insert(m_Bytes.end(), s.begin(), s.end());
+				m_Refs.emplace(s, ref);
+				return ref;
+			}
+
+			const std::vector<char>& GetBytes() const { return m_Bytes; }
+
+		private:
+			std::vector<char> m_Bytes;
+			std::unordered_map<std::string, StringRef> m_Refs;
+		};
+
+		template<typename T>
+		void Append(std::vector<uint8_t>& bytes, const T* items, size_t count)
+		{
+			const auto* begin = reinterpret_cast<const uint8_t*>(items);
+			bytes.insert(bytes.end(), begin, begin + sizeof(T) * count);
+		}
+
+		//----------------------------------------------------------------------
+		// JSON helpers
+		//----------------------------------------------------------------------
+		json Vec3ToJson(const glm::vec3& v) { return json::array({ v.x, v.y, v.z }); }
+		json Vec4ToJson(const glm::vec4& v) { return json::array({ v.x, v.y, v.z, v.w }); }
+
+		glm::vec3 JsonToVec3(const json& a, const glm::vec3& def)
+		{
+			if (a.is_array() && a.size() == 3)
+				return { a[0].get<float>(), a[1].get<float>(), a[2].get<float>() };
+			return def;
+		}
+
+		glm::vec4 JsonToVec4(const json& a, const glm::vec4& def)
+		{
+			if (a.is_array() && a.size() == 4)
+				return { a[0].get<float>(), a[1].get<float>(), a[2].get<float>(), a[3].get<float>() };
+			return def;
+		}
+	}
+
+	bool IsSceneJsonPath(const std::string& path)
+	{
+		std::string ext = std::filesystem::path(path).extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return ext == ".json";
+	}
+
+	//--------------------------------------------------------------------------
+	// JSON
+	//--------------------------------------------------------------------------
+	std::string SceneToJson(const SceneFileData& data)
+	{
+		json j;
+		j["version"] = SCENE_JSON_VERSION;
+		j["name"] = data.name;
+
+		j["camera"] = {
+			{ "position", Vec3ToJson(data.camera.position) },
+			{ "yaw", data.camera.yaw },
+			{ "pitch", data.camera.pitch },
+			{ "fov", data.camera.fov },
+			{ "near", data.camera.nearPlane },
+		};
+
+		j["ambient"] = {
+			{ "color", Vec3ToJson(data.ambientColor) },
+			{ "intensity", data.ambientIntensity },
+		};
+
+		json lights = json::array();
+		for (const Light& l : data.lights)
+		{
+			const ShadowConfig& sc = l.shadowConfig;
+			lights.push_back({
+				{ "name", l.name },
+				{ "type", static_cast<int>(l.type) },
+				{ "enabled", l.enabled },
+				{ "color", Vec3ToJson(l.color) },
+				{ "intensity", l.intensity },
+				{ "direction", Vec3ToJson(l.direction) },
+				{ "position", Vec3ToJson(l.position) },
+				{ "constant", l.constant },
+				{ "linear", l.linear },
+				{ "quadratic", l.quadratic },
+				{ "radius", l.radius },
+				{ "shadow", {
+					{ "castsShadows", sc.castsShadows },
+					{ "orthoSize", sc.orthoSize },
+					{ "nearPlane", sc.nearPlane },
+					{ "farPlane", sc.farPlane },
+					{ "bias", sc.bias },
+					{ "normalBias", sc.normalBias },
+					{ "shadowDistance", sc.shadowDistance },
+					{ "splitLambda", sc.splitLambda },
+					{ "casterExtrude", sc.casterExtrude },
+					{ "cascadeBlend", sc.cascadeBlend },
+					{ "fitSplitsToDepth", sc.fitSplitsToDepth },
+					{ "cascadeResolutionScale", sc.cascadeResolutionScale },
+					{ "cacheFarCascades", sc.cacheFarCascades },
+					{ "nearCascadesPerFrame", sc.nearCascadesPerFrame },
+					{ "farCascadeRefreshFrames", sc.farCascadeRefreshFrames },
+					{ "cacheLightAngleDeg", sc.cacheLightAngleDeg },
+					{ "cachePadding", sc.cachePadding },
+					{ "singlePassCascades", sc.singlePassCascades },
+					{ "terrainCascades", sc.terrainCascades },
+				}},
+			});
+		}
+		j["lights"] = std::move(lights);
+
+		json objects = json::array();
+		for (const SceneFileObject& o : data.objects)
+		{
+			if (o.kind == SceneFileObject::Kind::Model)
+			{
+				objects.push_back({
+					{ "kind", "model" },
+					{ "name", o.name },
+					{ "visible", o.visible },
+					{ "source", o.source },
+					{ "position", Vec3ToJson(o.position) },
+					{ "rotation", Vec3ToJson(o.rotation) },  // euler radians
+					{ "scale", Vec3ToJson(o.scale) },
+				});
+			}
+			else
+			{
+				objects.push_back({
+					{ "kind", "primitive" },
+					{ "name", o.name },
+					{ "visible", o.visible },
+					{ "primitive", o.primitive },
+					{ "texture", o.texture },
+					{ "pipeline", o.pipeline },
+					{ "position", Vec3ToJson(o.position) },
+					{ "rotation", Vec3ToJson(o.rotation) },  // euler radians
+					{ "scale", Vec3ToJson(o.scale) },
+					{ "customData", Vec4ToJson(o.customData) },
+				});
+			}
+			if (o.parent >= 0)
+				objects.back()["parent"] = o.parent;
+		}
+		j["objects"] = std::move(objects);
+
+		// Stored as a real nested object so the file stays human-readable,
+		// not an escaped string
+		if (!data.editorJson.empty())
+		{
+			try { j["editor"] = json::parse(data.editorJson); }
+			catch (const std::exception&) {}
+		}
+
+		return j.dump(2);
+	}
+
+	bool SceneFromJson(const std::string& text, SceneFileData& data, std::string& error)
+	{
+		json j;
+		try
+		{
+			j = json::parse(text);
+		}
+		catch (const std::exception& e)
+		{
+			error = e.what();
+			return false;
+		}
+		if (!j.is_object())
+		{
+			error = "not a JSON object";
+			return false;
+		}
+
+		try
+		{
+			data.name = j.value("name", data.name);
+
+			if (j.contains("camera"))
+			{
+				const json& c = j["camera"];
+				SceneCameraState& camera = data.camera;
+				camera.position = JsonToVec3(c.value("position", json::array()), camera.position);
+				camera.yaw = c.value("yaw", camera.yaw);
+				camera.pitch = c.value("pitch", camera.pitch);
+				camera.fov = c.value("fov", camera.fov);
+				camera.nearPlane = c.value("near", camera.nearPlane);
+			}
+
+			if (j.contains("ambient"))
+			{
+				const json& a = j["ambient"];
+				data.ambientColor = JsonToVec3(a.value("color", json::array()), data.ambientColor);
+				data.ambientIntensity = a.value("intensity", data.ambientIntensity);
+			}
+
+			data.lights.clear();
+			for (const json& lj : j.value("lights", json::array()))
+			{
+				Light l;
+				l.name = lj.value("name", std::string("Light"));
+				l.type = static_cast<LightType>(lj.value("type", 0));
+				l.enabled = lj.value("enabled", true);
+				l.color = JsonToVec3(lj.value("color", json::array()), l.color);
+				l.intensity = lj.value("intensity", l.intensity);
+				l.direction = JsonToVec3(lj.value("direction", json::array()), l.direction);
+				l.position = JsonToVec3(lj.value("position", json::array()), l.position);
+				l.constant = lj.value("constant", l.constant);
+				l.linear = lj.value("linear", l.linear);
+				l.quadratic = lj.value("quadratic", l.quadratic);
+				l.radius = lj.value("radius", l.radius);
+				if (lj.contains("shadow"))
+				{
+					const json& s = lj["shadow"];
+					ShadowConfig& sc = l.shadowConfig;
+					sc.castsShadows = s.value("castsShadows", sc.castsShadows);
+					sc.orthoSize = s.value("orthoSize", sc.orthoSize);
+					sc.nearPlane = s.value("nearPlane", sc.nearPlane);
+					sc.farPlane = s.value("farPlane", sc.farPlane);
+					sc.bias = s.value("bias", sc.bias);
+					sc.normalBias = s.value("normalBias", sc.normalBias);
+					sc.shadowDistance = s.value("shadowDistance", sc.shadowDistance);
+					sc.splitLambda = s.value("splitLambda", sc.splitLambda);
+					sc.casterExtrude = s.value("casterExtrude", sc.casterExtrude);
+					sc.cascadeBlend = s.value("cascadeBlend", sc.cascadeBlend);
+					sc.fitSplitsToDepth = s.value("fitSplitsToDepth", sc.fitSplitsToDepth);
+					sc.cascadeResolutionScale = s.value("cascadeResolutionScale", sc.cascadeResolutionScale);
+					sc.cacheFarCascades = s.value("cacheFarCascades", sc.cacheFarCascades);
+					sc.nearCascadesPerFrame = s.value("nearCascadesPerFrame", sc.nearCascadesPerFrame);
+					sc.farCascadeRefreshFrames = s.value("farCascadeRefreshFrames", sc.farCascadeRefreshFrames);
+					sc.cacheLightAngleDeg = s.value("cacheLightAngleDeg", sc.cacheLightAngleDeg);
+					sc.cachePadding = s.value("cachePadding", sc.cachePadding);
+					sc.singlePassCascades = s.value("singlePassCascades", sc.singlePassCascades);
+					sc.terrainCascades = s.value("terrainCascades", sc.terrainCascades);
+				}
+				data.lights.push_back(std::move(l));
+			}
+
+			// Unknown kinds stay in as records the loader skips, so parent
+			// indices keep pointing at the right objects
+			data.objects.clear();
+			for (const json& oj : j.value("objects", json::array()))
+			{
+				SceneFileObject o;
+				const std::string kind = oj.value("kind", std::string());
+				o.kind = kind == "model" ? SceneFileObject::Kind::Model : SceneFileObject::Kind::Primitive;
+				o.name = oj.value("name", std::string("Object"));
+				o.visible = oj.value("visible", true);
+				o.parent = oj.value("parent", -1);
+				o.source = oj.value("source", std::string());
+				o.primitive = kind == "primitive" ? oj.value("primitive", std::string("None")) : std::string("None");
+				o.texture = oj.value("texture", std::string());
+				o.pipeline = oj.value("pipeline", o.pipeline);
+				o.position = JsonToVec3(oj.value("position", json::array()), o.position);
+				o.rotation = JsonToVec3(oj.value("rotation", json::array()), o.rotation);
+				o.scale = JsonToVec3(oj.value("scale", json::array()), o.scale);
+				o.customData = JsonToVec4(oj.value("customData", json::array()), o.customData);
+				data.objects.push_back(std::move(o));
+			}
+
+			data.editorJson = j.contains("editor") ? j["editor"].dump() : std::string();
+		}
+		catch (const std::exception& e)
+		{
+			error = e.what();
+			return false;
+		}
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	// Binary
+	//--------------------------------------------------------------------------
+	std::vector<uint8_t> EncodeSceneBinary(const SceneFileData& data)
+	{
+		StringTable strings;
+
+		BinaryHeader header{};
+		std::memcpy(header.magic, SCENE_MAGIC, sizeof(header.magic));
+		header.version = SCENE_BINARY_VERSION;
+		header.lightCount = static_cast<uint32_t>(data.lights.size());
+		header.objectCount = static_cast<uint32_t>(data.objects.size());
+		header.name = strings.Add(data.name);
+		header.editorJson = strings.Add(data.editorJson);
+		header.cameraPosition = data.camera.position;
+		header.cameraYaw = data.camera.yaw;
+		header.cameraPitch = data.camera.pitch;
+		header.cameraFov = data.camera.fov;
+		header.cameraNear = data.camera.nearPlane;
+		header.ambientColor = data.ambientColor;
+		header.ambientIntensity = data.ambientIntensity;
+
+		std::vector<BinaryLight> lights(data.lights.size());
+		for (size_t i = 0; i < data.lights.size(); ++i)
+		{
+			const Light& l = data.lights[i];
+			const ShadowConfig& sc = l.shadowConfig;
+			BinaryLight& b = lights[i];
+			b = {};
+			b.name = strings.Add(l.name);
+			b.type = static_cast<int32_t>(l.type);
+			b.flags = (l.enabled ? LIGHT_ENABLED : 0u) | (sc.castsShadows ? LIGHT_CASTS_SHADOWS : 0u) |
+				(sc.cacheFarCascades ? LIGHT_CACHE_FAR_CASCADES : 0u) | (sc.singlePassCascades ? LIGHT_SINGLE_PASS_CASCADES : 0u) |
+				(sc.fitSplitsToDepth ? 0u : LIGHT_FIXED_SPLITS);
+			b.color = l.color;
+			b.intensity = l.intensity;
+			b.direction = l.direction;
+			b.position = l.position;
+			b.constant = l.constant;
+			b.linear = l.linear;
+			b.quadratic = l.quadratic;
+			b.radius = l.radius;
+			b.orthoSize = sc.orthoSize;
+			b.nearPlane = sc.nearPlane;
+			b.farPlane = sc.farPlane;
+			b.bias = sc.bias;
+			b.normalBias = sc.normalBias;
+			b.shadowDistance = sc.shadowDistance;
+			b.splitLambda = sc.splitLambda;
+			b.casterExtrude = sc.casterExtrude;
+			b.cascadeBlend = sc.cascadeBlend;
+			b.nearCascadesPerFrame = sc.nearCascadesPerFrame;
+			b.farCascadeRefreshFrames = sc.farCascadeRefreshFrames;
+			b.cacheLightAngleDeg = sc.cacheLightAngleDeg;
+			b.cachePadding = sc.cachePadding;
+		}
+
+		std::vector<BinaryObject> objects(data.objects.size());
+		std::vector<BinaryTransform> transforms(data.objects.size());
+		for (size_t i = 0; i < data.objects.size(); ++i)
+		{
+			const SceneFileObject& o = data.objects[i];
+			BinaryObject& b = objects[i];
+			b = {};
+			b.kind = static_cast<uint8_t>(o.kind);
+			b.visible = o.visible ? 1 : 0;
+			b.parent = o.parent;
+			b.pipeline = o.pipeline;
+			b.name = strings.Add(o.name);
+			b.source = strings.Add(o.source);
+			b.primitive = strings.Add(o.primitive);
+			b.texture = strings.Add(o.texture);
+			transforms[i] = { o.position, o.rotation, o.scale, o.customData };
+		}
+		header.stringBytes = static_cast<uint32_t>(strings.GetBytes().size());
+
+		std::vector<uint8_t> bytes;
+		bytes.reserve(sizeof(header) + sizeof(BinaryLight) * lights.size() +
+			(sizeof(BinaryObject) + sizeof(BinaryTransform)) * objects.size() + header.stringBytes);
+		Append(bytes, &header, 1);
+		Append(bytes, lights.data(), lights.size());
+		Append(bytes, objects.data(), objects.size());
+		Append(bytes, transforms.data(), transforms.size());
+		Append(bytes, strings.GetBytes().data(), strings.GetBytes().size());
+		return bytes;
+	}
+
+	bool WriteSceneBytes(const std::string& path, const std::vector<uint8_t>& bytes, std::string& error)
+	{
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				error = "can't create " + tempPath;
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				error = "write failed";
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			error = "can't replace " + path + ": " + ec.message();
+			return false;
+		}
+		return true;
+	}
+
+	bool WriteSceneBinary(const std::string& path, const SceneFileData& data, std::string& error)
+	{
+		return WriteSceneBytes(path, EncodeSceneBinary(data), error);
+	}
+
+	bool ReadSceneBinary(const std::string& path, SceneFileData& data, std::string& error)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			error = "can't map the file";
+			return false;
+		}
+		const uint8_t* bytes = file.GetData();
+		const size_t size = file.GetSize();
+
+		BinaryHeader header;
+		if (size < sizeof(header))
+		{
+			error = "file too small";
+			return false;
+		}
+		std::memcpy(&header, bytes, sizeof(header));
+		if (std::memcmp(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC)) != 0)
+		{
+			error = "not a binary scene";
+			return false;
+		}
+		if (header.version != SCENE_BINARY_VERSION)
+		{
+			error = "unsupported version " + std::to_string(header.version);
+			return false;
+		}
+
+		const uint64_t expected = sizeof(header) + uint64_t(sizeof(BinaryLight)) * header.lightCount +
+			uint64_t(sizeof(BinaryObject) + sizeof(BinaryTransform)) * header.objectCount + header.stringBytes;
+		if (expected != size)
+		{
+			error = "size doesn't match the header (truncated?)";
+			return false;
+		}
+
+		size_t cursor = sizeof(header);
+		std::vector<BinaryLight> lights(header.lightCount);
+		std::memcpy(lights.data(), bytes + cursor, sizeof(BinaryLight) * lights.size());
+		cursor += sizeof(BinaryLight) * lights.size();
+
+		std::vector<BinaryObject> objects(header.objectCount);
+		std::memcpy(objects.data(), bytes + cursor, sizeof(BinaryObject) * objects.size());
+		cursor += sizeof(BinaryObject) * objects.size();
+
+		std::vector<BinaryTransform> transforms(header.objectCount);
+		std::memcpy(transforms.data(), bytes + cursor, sizeof(BinaryTransform) * transforms.size());
+		cursor += sizeof(BinaryTransform) * transforms.size();
+
+		const char* stringData = reinterpret_cast<const char*>(bytes + cursor);
+		bool stringsValid = true;
+		auto getString = [&](const StringRef& ref)
+		{
+			if (uint64_t(ref.offset) + ref.length > header.stringBytes)
+			{
+				stringsValid = false;
+				return std::string();
+			}
+			return std::string(stringData + ref.offset, ref.length);
+		};
+
+		SceneFileData result;
+		result.name = getString(header.name);
+		result.editorJson = getString(header.editorJson);
+		result.camera.position = header.cameraPosition;
+		result.camera.yaw = header.cameraYaw;
+		result.camera.pitch = header.cameraPitch;
+		result.camera.fov = header.cameraFov;
+		result.camera.nearPlane = header.cameraNear;
+		result.ambientColor = header.ambientColor;
+		result.ambientIntensity = header.ambientIntensity;
+
+		result.lights.resize(lights.size());
+		for (size_t i = 0; i < lights.size(); ++i)
+		{
+			const BinaryLight& b = lights[i];
+			Light& l = result.lights[i];
+			ShadowConfig& sc = l.shadowConfig;
+			l.name = getString(b.name);
+			l.type = static_cast<LightType>(b.type);
+			l.enabled = (b.flags & LIGHT_ENABLED) != 0;
+			l.color = b.color;
+			l.intensity = b.intensity;
+			l.direction = b.direction;
+			l.position = b.position;
+			l.constant = b.constant;
+			l.linear = b.linear;
+			l.quadratic = b.quadratic;
+			l.radius = b.radius;
+			sc.castsShadows = (b.flags & LIGHT_CASTS_SHADOWS) != 0;
+			sc.orthoSize = b.orthoSize;
+			sc.nearPlane = b.nearPlane;
+			sc.farPlane = b.farPlane;
+			sc.bias = b.bias;
+			sc.normalBias = b.normalBias;
+			sc.shadowDistance = b.shadowDistance;
+			sc.splitLambda = b.splitLambda;
+			sc.casterExtrude = b.casterExtrude;
+			sc.cascadeBlend = b.cascadeBlend;
+			sc.fitSplitsToDepth = (b.flags & LIGHT_FIXED_SPLITS) == 0;
+			sc.cacheFarCascades = (b.flags & LIGHT_CACHE_FAR_CASCADES) != 0;
+			sc.nearCascadesPerFrame = b.nearCascadesPerFrame;
+			sc.farCascadeRefreshFrames = b.farCascadeRefreshFrames;
+			sc.cacheLightAngleDeg = b.cacheLightAngleDeg;
+			sc.cachePadding = b.cachePadding;
+			sc.singlePassCascades = (b.flags & LIGHT_SINGLE_PASS_CASCADES) != 0;
+		}
+
+		result.objects.resize(objects.size());
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			const BinaryObject& b = objects[i];
+			const BinaryTransform& t = transforms[i];
+			SceneFileObject& o = result.objects[i];
+			if (b.kind > static_cast<uint8_t>(SceneFileObject::Kind::Primitive))
+			{
+				error = "object " + std::to_string(i) + " has an unknown kind";
+				return false;
+			}
+			o.kind = static_cast<SceneFileObject::Kind>(b.kind);
+			o.visible = b.visible != 0;
+			o.parent = b.parent;
+			o.pipeline = b.pipeline;
+			o.name = getString(b.name);
+			o.source = getString(b.source);
+			o.primitive = getString(b.primitive);
+			o.texture = getString(b.texture);
+			o.position = t.position;
+			o.rotation = t.rotation;
+			o.scale = t.scale;
+			o.customData = t.customData;
+		}
+
+		if (!stringsValid)
+		{
+			error = "string outside the string table";
+			return false;
+		}
+
+		data = std::move(result);
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	// Either encoding
+	//--------------------------------------------------------------------------
+	bool ReadSceneFile(const std::string& path, SceneFileData& data, std::string& error)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open())
+		{
+			error = "can't open the file";
+			return false;
+		}
+
+		char magic[sizeof(SCENE_MAGIC)] = {};
+		in.read(magic, sizeof(magic));
+		if (in.gcount() == sizeof(magic) && std::memcmp(magic, SCENE_MAGIC, sizeof(magic)) == 0)
+		{
+			in.close();
+			return ReadSceneBinary(path, data, error);
+		}
+
+		in.clear();
+		in.seekg(0);
+		std::ostringstream text;
+		text << in.rdbuf();
+		return SceneFromJson(text.str(), data, error);
+	}
+
+	bool WriteSceneFile(const std::string& path, const SceneFileData& data, std::string& error)
+	{
+		if (!IsSceneJsonPath(path))
+			return WriteSceneBinary(path, data, error);
+
+		std::ofstream out(path);
+		if (!out.is_open())
+		{
+			error = "can't open the file for writing";
+			return false;
+		}
+		out << SceneToJson(data);
+		if (!out)
+		{
+			error = "write failed";
+			return false;
+		}
+		return true;
+	}
+}
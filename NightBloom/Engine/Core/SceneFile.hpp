@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// SceneFile.hpp
+//
+// On-disk form of a scene, independent of the live Scene and the renderer:
+// what SceneSerializer writes out and rebuilds a Scene from. Two encodings:
+//
+//   Binary (default)  compact and memory-mapped on load. A fixed header
+//                     (camera, ambient, counts), then the lights, the object
+//                     records and the object transforms as flat arrays, then
+//                     one deduplicated string table (names, model sources).
+//                     Reading is a bounds check and a copy per array.
+//   JSON              the human-readable form, for diffs and hand edits.
+//
+// Reading detects the encoding from the file's first bytes, so JSON scenes
+// saved before the binary format existed still load whatever their
+// extension. Writing picks JSON for a ".json" path and binary otherwise.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Light.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Minimal camera pose carried alongside the scene. Kept as a POD (rather than
+	// the Camera class) so the engine's serializer doesn't depend on the free-fly
+	// Camera implementation — the editor maps its Camera to/from this.
+	struct SceneCameraState
+	{
+		glm::vec3 position = glm::vec3(0.0f);
+		float yaw = -90.0f;
+		float pitch = 0.0f;
+		float fov = 45.0f;        // vertical FOV, degrees
+		float nearPlane = 0.1f;   // infinite-far reverse-Z, so no far plane stored
+	};
+
+	struct SceneFileObject
+	{
+		enum class Kind : uint8_t
+		{
+			Model,
+			Primitive
+		};
+
+		Kind kind = Kind::Model;
+		std::string name = "Object";
+		bool visible = true;
+		int32_t parent = -1;           // index into SceneFileData::objects
+
+		std::string source;            // Model: glTF path
+		std::string primitive;         // Primitive: kind name ("TestCube", ...)
+		std::string texture;           // Primitive: resource texture name
+		int32_t pipeline = 1;          // Primitive: PipelineType (1 = Mesh)
+
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 rotation = glm::vec3(0.0f);   // euler radians
+		glm::vec3 scale = glm::vec3(1.0f);
+		glm::vec4 customData = glm::vec4(0.0f); // Primitive only
+	};
+
+	struct SceneFileData
+	{
+		std::string name = "Untitled";
+		SceneCameraState camera;
+		glm::vec3 ambientColor = glm::vec3(0.03f, 0.03f, 0.05f);
+		float ambientIntensity = 1.0f;
+		std::vector<Light> lights;
+		std::vector<SceneFileObject> objects;
+
+		// Opaque editor state as a JSON object string; empty when none
+		std::string editorJson;
+	};
+
+	// Scene-file schema version of each encoding. Bump when the layout
+	// changes in a way older loaders can't handle. A JSON file of another
+	// version loads best-effort; a binary one is rejected.
+	constexpr int SCENE_JSON_VERSION = 1;
+	constexpr uint32_t SCENE_BINARY_VERSION = 1;
+
+	// True for paths WriteSceneFile stores as JSON (".json", any case)
+	bool IsSceneJsonPath(const std::string& path);
+
+	// Fields missing from the JSON keep the values `data` already holds, so
+	// callers can seed it with defaults. False with `error` set on a parse
+	// error.
+	bool SceneFromJson(const std::string& text, SceneFileData& data, std::string& error);
+	std::string SceneToJson(const SceneFileData& data);
+
+	// The binary file's bytes
+	std::vector<uint8_t> EncodeSceneBinary(const SceneFileData& data);
+
+	// Write through a temporary file and a rename, so an interrupted save
+	// never leaves a truncated scene
+	bool WriteSceneBytes(const std::string& path, const std::vector<uint8_t>& bytes, std::string& error);
+	bool WriteSceneBinary(const std::string& path, const SceneFileData& data, std::string& error);
+	bool ReadSceneBinary(const std::string& path, SceneFileData& data, std::string& error);
+
+	// Either encoding, detected on read and chosen by extension on write
+	bool ReadSceneFile(const std::string& path, SceneFileData& data, std::string& error);
+	bool WriteSceneFile(const std::string& path, const SceneFileData& data, std::string& error);
+}
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+// SceneNodes.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/SceneNodes.hpp"
+#include "Math/SimdMath.hpp"
+
+namespace Nightbloom
+{
+	uint32_t SceneNodes::Add(const glm::mat4& local)
+	{
+		const uint32_t node = static_cast<uint32_t>(Size());
+		m_Local.push_back(local);
+		m_World.push_back(local);
+		m_Parent.push_back(INVALID);
+		m_Flags.push_back(Dirty | Visible);
+		m_BoundsMin.push_back(glm::vec3(0.0f));
+		m_BoundsMax.push_back(glm::vec3(0.0f));
+		m_WorldBounds.Add(glm::vec3(local[3]), glm::vec3(0.0f));
+
+		m_OrderDirty = true;
+		m_AnyDirty = true;
+		return node;
+	}
+
+	void SceneNodes::Remove(uint32_t node)
+	{
+		if (node >= Size())
+			return;
+
+		uint32_t newParent = m_Parent[node];
+		if (newParent != INVALID && newParent > node)
+			--newParent;
+
+		m_Local.erase(m_Local.begin() + node);
+		m_World.erase(m_World.begin() + node);
+		m_Parent.erase(m_Parent.begin() + node);
+		m_Flags.erase(m_Flags.begin() + node);
+		m_BoundsMin.erase(m_BoundsMin.begin() + node);
+		m_BoundsMax.erase(m_BoundsMax.begin() + node);
+		m_WorldBounds.Erase(node);
+
+		for (uint32_t i = 0; i < Size(); ++i)
+		{
+			if (m_Parent[i] == node)
+			{
+				m_Parent[i] = newParent;
+				m_Flags[i] |= Dirty;
+				m_AnyDirty = true;
+			}
+			else if (m_Parent[i] != INVALID && m_Parent[i] > node)
+			{
+				--m_Parent[i];
+			}
+		}
+
+		m_OrderDirty = true;
+	}
+
+	void SceneNodes::Clear()
+	{
+		m_Local.clear();
+		m_World.clear();
+		m_Parent.clear();
+		m_Flags.clear();
+		m_BoundsMin.clear();
+		m_BoundsMax.clear();
+		m_WorldBounds.Clear();
+		m_Order.clear();
+		m_Updated.clear();
+		m_OrderDirty = false;
+		m_AnyDirty = false;
+	}
+
+	void SceneNodes::SetLocal(uint32_t node, const glm::mat4& local)
+	{
+		m_Local[node] = local;
+		m_Flags[node] |= Dirty;
+		m_AnyDirty = true;
+	}
+
+	bool SceneNodes::SetParent(uint32_t node, uint32_t parent)
+	{
+		if (node >= Size() || (parent != INVALID && parent >= Size()))
+			return false;
+
+		// Walking up from the new parent must not reach node
+		for (uint32_t ancestor = parent; ancestor != INVALID; ancestor = m_Parent[ancestor])
+		{
+			if (ancestor == node)
+				return false;
+		}
+
+		if (m_Parent[node] != parent)
+		{
+			m_Parent[node] = parent;
+			m_Flags[node] |= Dirty;
+			m_OrderDirty = true;
+			m_AnyDirty = true;
+		}
+		return true;
+	}
+
+	void SceneNodes::SetLocalBounds(uint32_t node, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		m_BoundsMin[node] = boundsMin;
+		m_BoundsMax[node] = boundsMax;
+		m_Flags[node] |= HasBounds | Dirty;
+		m_AnyDirty = true;
+	}
+
+	void SceneNodes::SetVisible(uint32_t node, bool visible)
+	{
+		if (visible)
+			m_Flags[node] |= Visible;
+		else
+			m_Flags[node] &= static_cast<uint8_t>(~Visible);
+	}
+
+	uint32_t SceneNodes::Update()
+	{
+		m_Updated.clear();
+		if (m_OrderDirty)
+			RebuildOrder();
+		if (!m_AnyDirty)
+			return 0;
+
+		// m_Order has every parent ahead of its children, so a parent's Moved
+		// bit is final by the time its children look at it
+		for (uint32_t node : m_Order)
+		{
+			const uint32_t parent = m_Parent[node];
+			uint8_t& flags = m_Flags[node];
+			if (parent != INVALID && (m_Flags[parent] & Moved))
+				flags |= Dirty;
+			if (!(flags & Dirty))
+				continue;
+
+			m_World[node] = parent == INVALID ? m_Local[node] : Simd::Multiply(m_World[parent], m_Local[node]);
+			if (flags & HasBounds)
+			{
+				glm::vec3 center, extents;
+				Simd::TransformAABB(m_BoundsMin[node], m_BoundsMax[node], m_World[node], center, extents);
+				m_WorldBounds.Set(node, center, extents);
+			}
+
+			flags = static_cast<uint8_t>((flags & ~Dirty) | Moved);
+			m_Updated.push_back(node);
+		}
+
+		for (uint32_t node : m_Updated)
+			m_Flags[node] &= static_cast<uint8_t>(~Moved);
+
+		m_AnyDirty = false;
+		return static_cast<uint32_t>(m_Updated.size());
+	}
+
+	// Breadth-first from the roots over child lists bucketed by parent
+	// (a counting sort), so each hierarchy change costs O(n) once
+	void SceneNodes::RebuildOrder()
+	{
+		const uint32_t count = static_cast<uint32_t>(Size());
+
+		// Child counts, then running sums (each parent's range end), then a
+		// backwards fill that leaves m_ChildStart[p] at the range start
+		m_ChildStart.assign(count + 1, 0);
+		for (uint32_t node = 0; node < count; ++node)
+		{
+			if (m_Parent[node] != INVALID)
+				++m_ChildStart[m_Parent[node]];
+		}
+		uint32_t total = 0;
+		for (uint32_t node = 0; node < count; ++node)
+		{
+			total += m_ChildStart[node];
+			m_ChildStart[node] = total;
+		}
+		m_ChildStart[count] = total;
+
+		m_Children.resize(total);
+		for (uint32_t node = count; node-- > 0;)
+		{
+			if (m_Parent[node] != INVALID)
+				m_Children[--m_ChildStart[m_Parent[node]]] = node;
+		}
+
+		m_Order.clear();
+		m_Order.reserve(count);
+		for (uint32_t node = 0; node < count; ++node)
+		{
+			if (m_Parent[node] == INVALID)
+				m_Order.push_back(node);
+		}
+		for (size_t i = 0; i < m_Order.size(); ++i)
+		{
+			const uint32_t parent = m_Order[i];
+			for (uint32_t child = m_ChildStart[parent]; child < m_ChildStart[parent + 1]; ++child)
+				m_Order.push_back(m_Children[child]);
+		}
+
+		m_OrderDirty = false;
+	}
+}
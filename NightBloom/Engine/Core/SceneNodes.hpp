@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// SceneNodes.hpp
+//
+// Data-oriented core under Scene: one node per SceneObject (same index), kept
+// as parallel arrays — local and world matrices, parent index, a flags byte
+// and world-space bounds in an AABBBatch — so culling and draw emission walk
+// contiguous memory instead of chasing SceneObject -> Model pointers.
+//
+// Nodes form a hierarchy (world = parent world * local). SetLocal/SetParent
+// only mark a node dirty; Update() walks the nodes parents-first and
+// recomputes the dirty ones and everything beneath them, so a frame where
+// nothing moved costs one pass over the flag bytes. The nodes it touched
+// are listed in GetUpdated() for pushing to the drawables.
+//
+// The arrays are counted as CpuMemoryCategory::Scene.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/CpuMemory.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class SceneNodes
+	{
+	public:
+		static constexpr uint32_t INVALID = UINT32_MAX;
+
+		template<typename T>
+		using Array = TrackedVector<T, CpuMemoryCategory::Scene>;
+
+		enum Flags : uint8_t
+		{
+			Dirty     = 1 << 0,   // local changed since the last Update
+			Visible   = 1 << 1,
+			HasBounds = 1 << 2,   // world bounds mean something (unbounded primitives have none)
+			Moved     = 1 << 3    // Update scratch: world recomputed this pass
+		};
+
+		// New root node, dirty and visible; returns its index (== Size() - 1)
+		uint32_t Add(const glm::mat4& local = glm::mat4(1.0f));
+
+		// Erases a node; indices above it shift down by one. Its children are
+		// handed to its own parent, keeping their local transforms.
+		void Remove(uint32_t node);
+		void Clear();
+
+		size_t Size() const { return m_Local.size(); }
+
+		void SetLocal(uint32_t node, const glm::mat4& local);
+		const glm::mat4& GetLocal(uint32_t node) const { return m_Local[node]; }
+		const glm::mat4& GetWorld(uint32_t node) const { return m_World[node]; }
+
+		// INVALID makes node a root. Fails (returns false) if parent is out of
+		// range or is node itself or one of its descendants.
+		bool SetParent(uint32_t node, uint32_t parent);
+		uint32_t GetParent(uint32_t node) const { return m_Parent[node]; }
+
+		// Object-space box, transformed into GetWorldBounds() by Update
+		void SetLocalBounds(uint32_t node, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+		void SetVisible(uint32_t node, bool visible);
+		bool IsVisible(uint32_t node) const { return (m_Flags[node] & Visible) != 0; }
+
+		// Recomputes the world matrices and bounds of dirty nodes and their
+		// descendants; returns how many were recomputed
+		uint32_t Update();
+		const Array<uint32_t>& GetUpdated() const { return m_Updated; }
+
+		// Streams for culling/emission, indexed by node
+		const Array<uint8_t>& GetFlags() const { return m_Flags; }
+		const AABBBatch& GetWorldBounds() const { return m_WorldBounds; }
+
+	private:
+		void RebuildOrder();
+
+		Array<glm::mat4> m_Local;
+		Array<glm::mat4> m_World;
+		Array<uint32_t>  m_Parent;
+		Array<uint8_t>   m_Flags;
+		Array<glm::vec3> m_BoundsMin;   // object space
+		Array<glm::vec3> m_BoundsMax;
+		AABBBatch        m_WorldBounds;
+
+		Array<uint32_t> m_Order;        // parents before children
+		Array<uint32_t> m_ChildStart;   // RebuildOrder scratch
+		Array<uint32_t> m_Children;
+		Array<uint32_t> m_Updated;
+		bool m_OrderDirty = false;
+		bool m_AnyDirty = false;
+	};
+}
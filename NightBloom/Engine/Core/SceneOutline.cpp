@@ -0,0 +1,174 @@
+//------------------------------------------------------------------------------
+// SceneOutline.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/SceneOutline.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		std::string ToLower(const std::string& text)
+		{
+			std::string lower(text.size(), '\0');
+			std::transform(text.begin(), text.end(), lower.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return lower;
+		}
+	}
+
+	void SceneOutline::Rebuild(uint32_t count, const ParentFn& parent, const NameFn& name)
+	{
+		m_Parent.resize(count);
+		m_LowerNames.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t p = parent(i);
+			m_Parent[i] = (p < count && p != i) ? p : NONE;
+			m_LowerNames[i] = ToLower(name(i));
+		}
+		m_Expanded.resize(count, 1);
+
+		// Children grouped by parent, in index order (counting sort)
+		std::vector<uint32_t> childStart(static_cast<size_t>(count) + 1, 0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_Parent[i] != NONE)
+				++childStart[m_Parent[i] + 1];
+		}
+		for (uint32_t i = 0; i < count; ++i)
+			childStart[i + 1] += childStart[i];
+		std::vector<uint32_t> children(childStart[count]);
+		std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_Parent[i] != NONE)
+				children[fill[m_Parent[i]]++] = i;
+		}
+
+		// Preorder, roots in index order
+		m_Order.clear();
+		m_Order.reserve(count);
+		m_Depth.clear();
+		m_Depth.reserve(count);
+		m_Position.assign(count, NONE);
+		std::vector<std::pair<uint32_t, uint32_t>> stack;   // item, depth
+		for (uint32_t root = count; root-- > 0;)
+		{
+			if (m_Parent[root] == NONE)
+				stack.emplace_back(root, 0);
+		}
+		while (!stack.empty())
+		{
+			const auto [item, depth] = stack.back();
+			stack.pop_back();
+			m_Position[item] = static_cast<uint32_t>(m_Order.size());
+			m_Order.push_back(item);
+			m_Depth.push_back(depth);
+			for (uint32_t c = childStart[item + 1]; c-- > childStart[item];)
+				stack.emplace_back(children[c], depth + 1);
+		}
+
+		// Subtree sizes, children before parents
+		std::vector<uint32_t> size(count, 1);
+		for (size_t pos = m_Order.size(); pos-- > 0;)
+		{
+			const uint32_t item = m_Order[pos];
+			if (m_Parent[item] != NONE)
+				size[m_Parent[item]] += size[item];
+		}
+		m_SubtreeEnd.resize(m_Order.size());
+		for (size_t pos = 0; pos < m_Order.size(); ++pos)
+			m_SubtreeEnd[pos] = static_cast<uint32_t>(pos) + size[m_Order[pos]];
+
+		RebuildRows();
+
+		if (IsSearching())
+		{
+			m_Matches.clear();
+			m_SearchFromMatches = false;
+			m_SearchSource.clear();
+			m_SearchCursor = 0;
+		}
+	}
+
+	void SceneOutline::RebuildRows()
+	{
+		m_Rows.clear();
+		m_RowOf.assign(m_Position.size(), NONE);
+		for (size_t pos = 0; pos < m_Order.size();)
+		{
+			const uint32_t item = m_Order[pos];
+			const bool hasChildren = m_SubtreeEnd[pos] > pos + 1;
+			m_RowOf[item] = static_cast<uint32_t>(m_Rows.size());
+			m_Rows.push_back({ item, m_Depth[pos], hasChildren });
+			pos = (hasChildren && !m_Expanded[item]) ? m_SubtreeEnd[pos] : pos + 1;
+		}
+	}
+
+	void SceneOutline::SetExpanded(uint32_t item, bool expanded)
+	{
+		if (item >= m_Expanded.size() || (m_Expanded[item] != 0) == expanded)
+			return;
+		m_Expanded[item] = expanded ? 1 : 0;
+		RebuildRows();
+	}
+
+	void SceneOutline::Reveal(uint32_t item)
+	{
+		if (item >= m_Parent.size())
+			return;
+
+		bool changed = false;
+		for (uint32_t p = m_Parent[item]; p != NONE; p = m_Parent[p])
+		{
+			changed |= m_Expanded[p] == 0;
+			m_Expanded[p] = 1;
+		}
+		if (changed)
+			RebuildRows();
+	}
+
+	void SceneOutline::SetSearch(const std::string& text)
+	{
+		const std::string lower = ToLower(text);
+		if (lower == m_Search)
+			return;
+
+		// Longer text only narrows what the last complete search found
+		const bool refine = !m_Search.empty() && IsSearchComplete() &&
+			lower.find(m_Search) != std::string::npos;
+		if (refine)
+			m_SearchSource = m_Matches;
+		else
+			m_SearchSource.clear();
+		m_SearchFromMatches = refine;
+
+		m_Search = lower;
+		m_Matches.clear();
+		m_SearchCursor = 0;
+	}
+
+	bool SceneOutline::StepSearch(uint32_t budget)
+	{
+		if (!IsSearching())
+			return true;
+
+		const size_t end = std::min(GetSearchSourceSize(), m_SearchCursor + budget);
+		for (; m_SearchCursor < end; ++m_SearchCursor)
+		{
+			const uint32_t item = m_SearchFromMatches ? m_SearchSource[m_SearchCursor] : m_Order[m_SearchCursor];
+			if (m_LowerNames[item].find(m_Search) != std::string::npos)
+				m_Matches.push_back(item);
+		}
+		return IsSearchComplete();
+	}
+
+	float SceneOutline::GetSearchProgress() const
+	{
+		const size_t total = GetSearchSourceSize();
+		return total == 0 ? 1.0f : static_cast<float>(m_SearchCursor) / static_cast<float>(total);
+	}
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// SceneOutline.hpp
+//
+// The scene hierarchy flattened into rows for a clipped list: a preorder
+// walk of the parent links (siblings in index order), each row carrying its
+// depth, with collapsed subtrees skipped. Rebuild() is O(n) and meant to run
+// only when the scene's structure changes (Scene::GetStructureVersion);
+// expanding or collapsing re-walks the rows but touches no names.
+//
+// Search is a case-insensitive substring match over lower-cased copies of
+// the names taken at Rebuild. It runs in slices - StepSearch(budget) matches
+// at most `budget` more names - so a frame never pays for the whole scene,
+// and text that extends the previous (complete) search only re-checks the
+// previous matches.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	class SceneOutline
+	{
+	public:
+		static constexpr uint32_t NONE = UINT32_MAX;
+
+		// Parent of an item (NONE for a root) and its name
+		using ParentFn = std::function<uint32_t(uint32_t)>;
+		using NameFn = std::function<const std::string&(uint32_t)>;
+
+		struct Row
+		{
+			uint32_t item = NONE;
+			uint32_t depth = 0;
+			bool hasChildren = false;
+		};
+
+		// Items keep their expanded state across rebuilds (by index); new
+		// ones start expanded. A running search restarts.
+		void Rebuild(uint32_t count, const ParentFn& parent, const NameFn& name);
+
+		uint32_t GetItemCount() const { return static_cast<uint32_t>(m_Position.size()); }
+
+		const std::vector<Row>& GetRows() const { return m_Rows; }
+
+		// NONE while hidden under a collapsed ancestor
+		uint32_t FindRow(uint32_t item) const { return item < m_RowOf.size() ? m_RowOf[item] : NONE; }
+
+		bool IsExpanded(uint32_t item) const { return item < m_Expanded.size() && m_Expanded[item] != 0; }
+		void SetExpanded(uint32_t item, bool expanded);
+
+		// Expands every ancestor of item so it gets a row
+		void Reveal(uint32_t item);
+
+		// Empty text ends the search
+		void SetSearch(const std::string& text);
+		bool IsSearching() const { return !m_Search.empty(); }
+		bool IsSearchComplete() const { return m_SearchCursor >= GetSearchSourceSize(); }
+		float GetSearchProgress() const;
+
+		// Checks up to budget more names; true once the search is complete
+		bool StepSearch(uint32_t budget);
+
+		// Matching items so far, in row order
+		const std::vector<uint32_t>& GetMatches() const { return m_Matches; }
+
+	private:
+		void RebuildRows();
+		size_t GetSearchSourceSize() const { return m_SearchFromMatches ? m_SearchSource.size() : m_Order.size(); }
+
+		// Per position in the preorder walk
+		std::vector<uint32_t> m_Order;
+		std::vector<uint32_t> m_Depth;
+		std::vector<uint32_t> m_SubtreeEnd;   // Position just past the subtree
+
+		// Per item
+		std::vector<uint32_t> m_Position;
+		std::vector<uint32_t> m_Parent;
+		std::vector<uint8_t> m_Expanded;
+		std::vector<uint32_t> m_RowOf;
+		std::vector<std::string> m_LowerNames;
+
+		std::vector<Row> m_Rows;
+
+		std::string m_Search;
+		std::vector<uint32_t> m_Matches;
+		std::vector<uint32_t> m_SearchSource;  // Previous matches when refining
+		bool m_SearchFromMatches = false;
+		size_t m_SearchCursor = 0;
+	};
+}
@@ -6,42 +6,23 @@
 #include "Engine/Core/Scene.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/AsyncAssetLoader.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"  // complete type for VulkanTexture* -> Texture* upcast
+#include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 
 #include <nlohmann/json.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <fstream>
 
 namespace Nightbloom
 {
 	using json = nlohmann::json;
 
-	// Current scene-file schema version. Bump when the layout changes in a way
-	// older loaders can't handle; Load() checks it and warns on mismatch.
-	static constexpr int kSceneFileVersion = 1;
-
 	//--------------------------------------------------------------------------
-	// Small JSON helpers
+	// Helpers
 	//--------------------------------------------------------------------------
 	namespace
 	{
-		json Vec3ToJson(const glm::vec3& v) { return json::array({ v.x, v.y, v.z }); }
-
-		glm::vec3 JsonToVec3(const json& a, const glm::vec3& def)
-		{
-			if (a.is_array() && a.size() == 3)
-				return { a[0].get<float>(), a[1].get<float>(), a[2].get<float>() };
-			return def;
-		}
-
-		glm::vec4 JsonToVec4(const json& a, const glm::vec4& def)
-		{
-			if (a.is_array() && a.size() == 4)
-				return { a[0].get<float>(), a[1].get<float>(), a[2].get<float>(), a[3].get<float>() };
-			return def;
-		}
-
 		const char* PrimitiveKindToString(PrimitiveKind k)
 		{
 			switch (k)
@@ -61,21 +42,25 @@ namespace Nightbloom
 			return PrimitiveKind::None;
 		}
 
-		// Resolve a primitive kind to its engine-owned built-in buffers.
+		// Resolve a primitive kind to its engine-owned built-in buffers and the
+		// half size of its (origin-centered) bounds.
 		void GetPrimitiveBuffers(Renderer* r, PrimitiveKind k,
-			Buffer*& vb, Buffer*& ib, uint32_t& indexCount)
+			Buffer*& vb, Buffer*& ib, uint32_t& indexCount, glm::vec3& extents)
 		{
-			vb = nullptr; ib = nullptr; indexCount = 0;
+			vb = nullptr; ib = nullptr; indexCount = 0; extents = glm::vec3(0.0f);
 			switch (k)
 			{
 			case PrimitiveKind::TestCube:
 				vb = r->GetTestVertexBuffer();  ib = r->GetTestIndexBuffer();  indexCount = r->GetTestIndexCount();
+				extents = r->GetTestCubeExtents();
 				break;
 			case PrimitiveKind::GroundPlane:
 				vb = r->GetGroundPlaneVertexBuffer(); ib = r->GetGroundPlaneIndexBuffer(); indexCount = r->GetGroundPlaneIndexCount();
+				extents = r->GetGroundPlaneExtents();
 				break;
 			case PrimitiveKind::MoonSphere:
 				vb = r->GetMoonSphereVertexBuffer(); ib = r->GetMoonSphereIndexBuffer(); indexCount = r->GetMoonSphereIndexCount();
+				extents = r->GetMoonSphereExtents();
 				break;
 			default:
 				break;
@@ -84,119 +69,88 @@ namespace Nightbloom
 	}
 
 	//--------------------------------------------------------------------------
-	// Save
+	// Capture / Save
 	//--------------------------------------------------------------------------
-	bool SceneSerializer::Save(const Scene& scene, const SceneCameraState& camera,
-		const std::string& filepath, const std::string& sceneName,
-		const std::string& editorStateJson)
+	SceneFileData SceneSerializer::Capture(const Scene& scene, const SceneCameraState& camera,
+		const std::string& sceneName, const std::string& editorStateJson)
 	{
-		json j;
-		j["version"] = kSceneFileVersion;
-		j["name"] = sceneName;
-
-		j["camera"] = {
-			{ "position", Vec3ToJson(camera.position) },
-			{ "yaw", camera.yaw },
-			{ "pitch", camera.pitch },
-			{ "fov", camera.fov },
-			{ "near", camera.nearPlane },
-		};
-
-		j["ambient"] = {
-			{ "color", Vec3ToJson(scene.GetAmbientColor()) },
-			{ "intensity", scene.GetAmbientIntensity() },
-		};
+		SceneFileData data;
+		data.name = sceneName;
+		data.camera = camera;
+		data.ambientColor = scene.GetAmbientColor();
+		data.ambientIntensity = scene.GetAmbientIntensity();
+		data.lights = scene.GetLights();
 
-		// --- Lights ---
-		json lights = json::array();
-		for (const Light& l : scene.GetLights())
+		// --- Objects ---
+		// Parents are stored as indices into the saved array, which skips
+		// objects we can't rebuild — so number the saved ones first.
+		const auto& sceneObjects = scene.GetObjects();
+		std::vector<int> savedIndex(sceneObjects.size(), -1);
+		int savedCount = 0;
+		for (size_t i = 0; i < sceneObjects.size(); ++i)
 		{
-			const ShadowConfig& sc = l.shadowConfig;
-			lights.push_back({
-				{ "name", l.name },
-				{ "type", static_cast<int>(l.type) },
-				{ "enabled", l.enabled },
-				{ "color", Vec3ToJson(l.color) },
-				{ "intensity", l.intensity },
-				{ "direction", Vec3ToJson(l.direction) },
-				{ "position", Vec3ToJson(l.position) },
-				{ "constant", l.constant },
-				{ "linear", l.linear },
-				{ "quadratic", l.quadratic },
-				{ "radius", l.radius },
-				{ "shadow", {
-					{ "castsShadows", sc.castsShadows },
-					{ "orthoSize", sc.orthoSize },
-					{ "nearPlane", sc.nearPlane },
-					{ "farPlane", sc.farPlane },
-					{ "bias", sc.bias },
-					{ "normalBias", sc.normalBias },
-					{ "shadowDistance", sc.shadowDistance },
-					{ "splitLambda", sc.splitLambda },
-					{ "casterExtrude", sc.casterExtrude },
-					{ "cascadeBlend", sc.cascadeBlend },
-				}},
-			});
+			const SceneObject& obj = sceneObjects[i];
+			if (obj.model || (obj.meshDrawable && obj.primitiveKind != PrimitiveKind::None))
+				savedIndex[i] = savedCount++;
 		}
-		j["lights"] = std::move(lights);
 
-		// --- Objects ---
-		json objects = json::array();
-		for (const SceneObject& obj : scene.GetObjects())
+		data.objects.reserve(savedCount);
+		for (size_t i = 0; i < sceneObjects.size(); ++i)
 		{
+			// Objects with neither a model nor a reconstructable primitive kind are
+			// skipped — we can't rebuild them on load.
+			if (savedIndex[i] < 0)
+				continue;
+
+			const SceneObject& obj = sceneObjects[i];
+			SceneFileObject& o = data.objects.emplace_back();
+			o.name = obj.name;
+			o.visible = obj.IsVisible();
 			if (obj.model)
 			{
-				objects.push_back({
-					{ "kind", "model" },
-					{ "name", obj.name },
-					{ "visible", obj.visible },
-					{ "source", obj.model->GetSourcePath() },
-					{ "position", Vec3ToJson(obj.model->GetPosition()) },
-					{ "rotation", Vec3ToJson(obj.model->GetRotation()) },  // euler radians
-					{ "scale", Vec3ToJson(obj.model->GetScale()) },
-				});
+				o.kind = SceneFileObject::Kind::Model;
+				o.source = obj.model->GetSourcePath();
 			}
-			else if (obj.meshDrawable && obj.primitiveKind != PrimitiveKind::None)
+			else
 			{
-				objects.push_back({
-					{ "kind", "primitive" },
-					{ "name", obj.name },
-					{ "visible", obj.visible },
-					{ "primitive", PrimitiveKindToString(obj.primitiveKind) },
-					{ "texture", obj.primitiveTexture },
-					{ "pipeline", static_cast<int>(obj.pipeline) },
-					{ "position", Vec3ToJson(obj.primitivePosition) },
-					{ "rotation", Vec3ToJson(obj.primitiveRotation) },  // euler radians
-					{ "scale", Vec3ToJson(obj.primitiveScale) },
-					{ "customData", json::array({
-						obj.meshDrawable->GetCustomData().x, obj.meshDrawable->GetCustomData().y,
-						obj.meshDrawable->GetCustomData().z, obj.meshDrawable->GetCustomData().w }) },
-				});
+				o.kind = SceneFileObject::Kind::Primitive;
+				o.primitive = PrimitiveKindToString(obj.primitiveKind);
+				o.texture = obj.primitiveTexture;
+				o.pipeline = static_cast<int32_t>(obj.pipeline);
+				o.customData = obj.meshDrawable->GetCustomData();
 			}
-			// Objects with neither a model nor a reconstructable primitive kind are
-			// skipped — we can't rebuild them on load.
+			o.position = obj.localPosition;
+			o.rotation = obj.localRotation;
+			o.scale = obj.localScale;
+
+			const int parent = scene.GetParent(i);
+			if (parent >= 0 && savedIndex[parent] >= 0)
+				o.parent = savedIndex[parent];
 		}
-		j["objects"] = std::move(objects);
 
-		// Opaque editor state (panel settings). Stored as a real nested object so the
-		// file stays human-readable, not an escaped string.
+		// Opaque editor state (panel settings), checked here so a bad string
+		// doesn't end up in either encoding
 		if (!editorStateJson.empty())
 		{
-			try { j["editor"] = json::parse(editorStateJson); }
-			catch (const std::exception& e)
-			{
-				LOG_WARN("SceneSerializer: editor state was not valid JSON, omitting: {}", e.what());
-			}
+			if (json::accept(editorStateJson))
+				data.editorJson = editorStateJson;
+			else
+				LOG_WARN("SceneSerializer: editor state was not valid JSON, omitting");
 		}
+		return data;
+	}
 
-		std::ofstream out(filepath);
-		if (!out.is_open())
+	bool SceneSerializer::Save(const Scene& scene, const SceneCameraState& camera,
+		const std::string& filepath, const std::string& sceneName,
+		const std::string& editorStateJson)
+	{
+		const SceneFileData data = Capture(scene, camera, sceneName, editorStateJson);
+		std::string error;
+		if (!WriteSceneFile(filepath, data, error))
 		{
-			LOG_ERROR("SceneSerializer: failed to open '{}' for writing", filepath);
+			LOG_ERROR("SceneSerializer: failed to write '{}': {}", filepath, error);
 			return false;
 		}
-		out << j.dump(2);
-		out.close();
 
 		LOG_INFO("SceneSerializer: saved scene '{}' to '{}' ({} objects, {} lights)",
 			sceneName, filepath, scene.GetObjectCount(), scene.GetLightCount());
@@ -208,7 +162,7 @@ namespace Nightbloom
 	//--------------------------------------------------------------------------
 	bool SceneSerializer::Load(Scene& scene, SceneCameraState& camera,
 		const std::string& filepath, Renderer* renderer,
-		std::string* outEditorStateJson)
+		std::string* outEditorStateJson, AsyncAssetLoader* loader)
 	{
 		if (!renderer)
 		{
@@ -216,166 +170,227 @@ namespace Nightbloom
 			return false;
 		}
 
-		std::ifstream in(filepath);
-		if (!in.is_open())
-		{
-			LOG_ERROR("SceneSerializer: failed to open '{}' for reading", filepath);
-			return false;
-		}
+		// Missing JSON fields keep the camera and ambient the caller has
+		SceneFileData data;
+		data.camera = camera;
+		data.ambientColor = scene.GetAmbientColor();
+		data.ambientIntensity = scene.GetAmbientIntensity();
 
-		json j;
-		try
+		std::string error;
+		if (!ReadSceneFile(filepath, data, error))
 		{
-			in >> j;
-		}
-		catch (const std::exception& e)
-		{
-			LOG_ERROR("SceneSerializer: parse error in '{}': {}", filepath, e.what());
+			LOG_ERROR("SceneSerializer: failed to read '{}': {}", filepath, error);
 			return false;
 		}
 
-		int version = j.value("version", 0);
-		if (version != kSceneFileVersion)
-		{
-			LOG_WARN("SceneSerializer: scene file version {} != expected {} — loading best-effort",
-				version, kSceneFileVersion);
-		}
+		Build(scene, camera, data, renderer, loader);
+
+		if (outEditorStateJson)
+			*outEditorStateJson = data.editorJson.empty() ? std::string("{}") : data.editorJson;
+
+		LOG_INFO("SceneSerializer: loaded '{}' ({} objects, {} lights)",
+			filepath, scene.GetObjectCount(), scene.GetLightCount());
+		return true;
+	}
 
+	void SceneSerializer::Build(Scene& scene, SceneCameraState& camera, const SceneFileData& data,
+		Renderer* renderer, AsyncAssetLoader* loader)
+	{
 		// Fully reset the scene. Scene::Clear only clears objects, so drop lights too.
 		scene.Clear();
 		while (scene.GetLightCount() > 0)
 			scene.RemoveLight(scene.GetLightCount() - 1);
 
-		// --- Camera ---
-		if (j.contains("camera"))
-		{
-			const json& c = j["camera"];
-			camera.position = JsonToVec3(c.value("position", json::array()), camera.position);
-			camera.yaw = c.value("yaw", camera.yaw);
-			camera.pitch = c.value("pitch", camera.pitch);
-			camera.fov = c.value("fov", camera.fov);
-			camera.nearPlane = c.value("near", camera.nearPlane);
-		}
+		camera = data.camera;
+		scene.SetAmbient(data.ambientColor, data.ambientIntensity);
+
+		// --- Lights ---
+		for (const Light& light : data.lights)
+			*scene.AddLight(light.name, light.type) = light;
+
+		// --- Objects ---
+		ResourceManager* resources = renderer->GetResourceManager();
+		Texture* defaultTex = resources ? resources->GetTexture("default_white") : nullptr;
 
-		// --- Ambient ---
-		if (j.contains("ambient"))
+		// Scene index of each saved object (-1 = skipped) and its saved
+		// parent, for re-linking the hierarchy once everything is loaded
+		std::vector<int> loadedIndex;
+		std::vector<int> savedParent;
+
+		// Objects placing the same file share one Model through the cache; a
+		// file already loaded (still used elsewhere) isn't read again
+		ModelCache* modelCache = resources ? &resources->GetModelCache() : nullptr;
+
+		// Loading here: parse every distinct model file and decode every
+		// texture they use in parallel up front, then create all of it in
+		// one upload batch
+		std::vector<std::string> sources;
+		for (const SceneFileObject& o : data.objects)
 		{
-			const json& a = j["ambient"];
-			scene.SetAmbient(
-				JsonToVec3(a.value("color", json::array()), scene.GetAmbientColor()),
-				a.value("intensity", scene.GetAmbientIntensity()));
+			if (!loader && o.kind == SceneFileObject::Kind::Model && !o.source.empty() &&
+				!(modelCache && modelCache->Find(o.source)) &&
+				std::find(sources.begin(), sources.end(), o.source) == sources.end())
+				sources.push_back(o.source);
 		}
 
-		// --- Lights ---
-		for (const json& lj : j.value("lights", json::array()))
-		{
-			auto type = static_cast<LightType>(lj.value("type", 0));
-			Light* l = scene.AddLight(lj.value("name", std::string("Light")), type);
-			l->enabled = lj.value("enabled", true);
-			l->color = JsonToVec3(lj.value("color", json::array()), l->color);
-			l->intensity = lj.value("intensity", l->intensity);
-			l->direction = JsonToVec3(lj.value("direction", json::array()), l->direction);
-			l->position = JsonToVec3(lj.value("position", json::array()), l->position);
-			l->constant = lj.value("constant", l->constant);
-			l->linear = lj.value("linear", l->linear);
-			l->quadratic = lj.value("quadratic", l->quadratic);
-			l->radius = lj.value("radius", l->radius);
-			if (lj.contains("shadow"))
+		std::vector<std::unique_ptr<ModelData>> modelData(sources.size());
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(sources.size()), 1,
+			[&](uint32_t begin, uint32_t end)
 			{
-				const json& s = lj["shadow"];
-				ShadowConfig& sc = l->shadowConfig;
-				sc.castsShadows = s.value("castsShadows", sc.castsShadows);
-				sc.orthoSize = s.value("orthoSize", sc.orthoSize);
-				sc.nearPlane = s.value("nearPlane", sc.nearPlane);
-				sc.farPlane = s.value("farPlane", sc.farPlane);
-				sc.bias = s.value("bias", sc.bias);
-				sc.normalBias = s.value("normalBias", sc.normalBias);
-				sc.shadowDistance = s.value("shadowDistance", sc.shadowDistance);
-				sc.splitLambda = s.value("splitLambda", sc.splitLambda);
-				sc.casterExtrude = s.value("casterExtrude", sc.casterExtrude);
-				sc.cascadeBlend = s.value("cascadeBlend", sc.cascadeBlend);
-			}
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					GLTFLoader gltf;
+					modelData[i] = gltf.Load(sources[i]);
+				}
+			});
+
+		std::vector<std::string> texturePaths;
+		for (const auto& model : modelData)
+		{
+			if (!model)
+				continue;
+			for (std::string& path : Model::GetTexturePaths(*model))
+				texturePaths.push_back(std::move(path));
 		}
+		PreparedTextureMap preparedTextures;
+		if (resources)
+			preparedTextures = resources->PrepareTextures(texturePaths);
 
-		// --- Objects ---
-		ResourceManager* resources = renderer->GetResourceManager();
-		Texture* defaultTex = resources ? resources->GetTexture("default_white") : nullptr;
+		UploadBatchScope uploadBatch(resources ? resources->GetUploadManager() : nullptr);
 
-		for (const json& oj : j.value("objects", json::array()))
+		for (const SceneFileObject& object : data.objects)
 		{
-			const std::string kind = oj.value("kind", std::string());
-			const std::string name = oj.value("name", std::string("Object"));
-			const bool visible = oj.value("visible", true);
+			const std::string& name = object.name;
+			loadedIndex.push_back(-1);
+			savedParent.push_back(object.parent);
 
-			if (kind == "model")
+			if (object.kind == SceneFileObject::Kind::Model)
 			{
-				const std::string source = oj.value("source", std::string());
+				const std::string& source = object.source;
 				if (source.empty())
 				{
 					LOG_WARN("SceneSerializer: model object '{}' has no source path — skipped", name);
 					continue;
 				}
-				auto model = std::make_unique<Model>(name);
-				if (!model->LoadFromFile(source, resources, renderer->GetDescriptorManager()))
+				auto createModel = [&]() -> std::shared_ptr<Model>
+				{
+					auto model = std::make_shared<Model>(name);
+					if (loader)
+					{
+						// Every object sharing it picks up its bounds
+						Scene* target = &scene;
+						loader->LoadModel(*model, source, [target, name, source](Model& loaded, bool ok)
+							{
+								if (ok)
+									target->RefreshModelBounds(&loaded);
+								else
+									LOG_WARN("SceneSerializer: failed to load model '{}' from '{}' — left empty", name, source);
+							});
+						return model;
+					}
+
+					const size_t sourceIndex = std::find(sources.begin(), sources.end(), source) - sources.begin();
+					const ModelData* modelSource = sourceIndex < modelData.size() ? modelData[sourceIndex].get() : nullptr;
+					if (!modelSource || !model->LoadFromData(*modelSource, resources, renderer->GetDescriptorManager(), &preparedTextures))
+						return nullptr;
+					return model;
+				};
+				std::shared_ptr<Model> model = modelCache ? modelCache->Acquire(source, createModel) : createModel();
+				if (!model)
 				{
 					LOG_WARN("SceneSerializer: failed to load model '{}' from '{}' — skipped", name, source);
 					continue;
 				}
-				model->SetPosition(JsonToVec3(oj.value("position", json::array()), glm::vec3(0.0f)));
-				model->SetRotation(JsonToVec3(oj.value("rotation", json::array()), glm::vec3(0.0f)));
-				model->SetScale(JsonToVec3(oj.value("scale", json::array()), glm::vec3(1.0f)));
 				SceneObject* o = scene.AddObject(name, std::move(model), defaultTex);
-				if (o) o->visible = visible;
-			}
-			else if (kind == "primitive")
-			{
-				PrimitiveKind pk = PrimitiveKindFromString(oj.value("primitive", std::string("None")));
-				Buffer* vb = nullptr; Buffer* ib = nullptr; uint32_t indexCount = 0;
-				GetPrimitiveBuffers(renderer, pk, vb, ib, indexCount);
-				if (!vb || !ib || indexCount == 0)
-				{
-					LOG_WARN("SceneSerializer: primitive '{}' ({}) has no buffers — skipped",
-						name, oj.value("primitive", std::string("None")));
-					continue;
-				}
-				auto pipeline = static_cast<PipelineType>(oj.value("pipeline", static_cast<int>(PipelineType::Mesh)));
-				auto md = std::make_unique<MeshDrawable>(vb, ib, indexCount, pipeline);
-				md->SetCustomData(JsonToVec4(oj.value("customData", json::array()), glm::vec4(0.0f)));
-
-				const std::string texName = oj.value("texture", std::string());
-				if (resources && !texName.empty())
-				{
-					if (Texture* tex = resources->GetTexture(texName))
-						md->AddTexture(tex);
-				}
-
-				SceneObject* o = scene.AddPrimitive(name, std::move(md));
 				if (o)
 				{
-					o->pipeline = pipeline;
-					o->primitiveKind = pk;
-					o->primitiveTexture = texName;
-					o->visible = visible;
-					o->primitivePosition = JsonToVec3(oj.value("position", json::array()), glm::vec3(0.0f));
-					o->primitiveRotation = JsonToVec3(oj.value("rotation", json::array()), glm::vec3(0.0f));
-					o->primitiveScale = JsonToVec3(oj.value("scale", json::array()), glm::vec3(1.0f));
-					o->UpdatePrimitiveTransform();  // compose TRS -> drawable transform
+					o->SetVisible(object.visible);
+					o->localPosition = object.position;
+					o->localRotation = object.rotation;
+					o->localScale = object.scale;
+					o->UpdateLocalTransform();
+					loadedIndex.back() = static_cast<int>(scene.GetObjectCount()) - 1;
 				}
 			}
-			else
+			else if (AddPrimitive(scene, object, renderer))
 			{
-				LOG_WARN("SceneSerializer: unknown object kind '{}' — skipped", kind);
+				loadedIndex.back() = static_cast<int>(scene.GetObjectCount()) - 1;
 			}
 		}
 
+		for (size_t i = 0; i < loadedIndex.size(); ++i)
+		{
+			const int parent = savedParent[i];
+			if (loadedIndex[i] < 0 || parent < 0 || parent >= static_cast<int>(loadedIndex.size()) || loadedIndex[parent] < 0)
+				continue;
+			if (!scene.SetParent(static_cast<size_t>(loadedIndex[i]), loadedIndex[parent]))
+				LOG_WARN("SceneSerializer: object '{}' can't be parented (cycle) — left at the root",
+					scene.GetObject(loadedIndex[i])->name);
+		}
+
 		if (scene.GetObjectCount() > 0)
 			scene.Select(0);
+	}
 
-		if (outEditorStateJson)
-			*outEditorStateJson = j.contains("editor") ? j["editor"].dump() : std::string("{}");
+	SceneObject* SceneSerializer::AddPrimitive(Scene& scene, const SceneFileObject& object, Renderer* renderer)
+	{
+		PrimitiveKind pk = PrimitiveKindFromString(object.primitive);
+		Buffer* vb = nullptr; Buffer* ib = nullptr; uint32_t indexCount = 0;
+		glm::vec3 extents(0.0f);
+		GetPrimitiveBuffers(renderer, pk, vb, ib, indexCount, extents);
+		if (!vb || !ib || indexCount == 0)
+		{
+			LOG_WARN("SceneSerializer: primitive '{}' ({}) has no buffers — skipped",
+				object.name, object.primitive);
+			return nullptr;
+		}
+		auto pipeline = static_cast<PipelineType>(object.pipeline);
+		auto md = std::make_unique<MeshDrawable>(vb, ib, indexCount, pipeline);
+		md->SetCustomData(object.customData);
+		md->SetLocalBounds(-extents, extents);
 
-		LOG_INFO("SceneSerializer: loaded '{}' ({} objects, {} lights)",
-			filepath, scene.GetObjectCount(), scene.GetLightCount());
+		const std::string& texName = object.texture;
+		ResourceManager* resources = renderer->GetResourceManager();
+		if (resources && !texName.empty())
+		{
+			if (Texture* tex = resources->GetTexture(texName))
+				md->AddTexture(tex);
+		}
+
+		SceneObject* o = scene.AddPrimitive(object.name, std::move(md));
+		if (o)
+		{
+			o->pipeline = pipeline;
+			o->primitiveKind = pk;
+			o->primitiveTexture = texName;
+			o->SetVisible(object.visible);
+			o->localPosition = object.position;
+			o->localRotation = object.rotation;
+			o->localScale = object.scale;
+			o->UpdateLocalTransform();  // compose TRS -> drawable transform
+		}
+		return o;
+	}
+
+	//--------------------------------------------------------------------------
+	// Convert
+	//--------------------------------------------------------------------------
+	bool SceneSerializer::Convert(const std::string& inputPath, const std::string& outputPath)
+	{
+		SceneFileData data;
+		std::string error;
+		if (!ReadSceneFile(inputPath, data, error))
+		{
+			LOG_ERROR("SceneSerializer: failed to read '{}': {}", inputPath, error);
+			return false;
+		}
+		if (!WriteSceneFile(outputPath, data, error))
+		{
+			LOG_ERROR("SceneSerializer: failed to write '{}': {}", outputPath, error);
+			return false;
+		}
+
+		LOG_INFO("SceneSerializer: converted '{}' to '{}'", inputPath, outputPath);
 		return true;
 	}
 
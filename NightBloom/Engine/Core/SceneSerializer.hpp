@@ -2,39 +2,30 @@
 // SceneSerializer.hpp
 //
 // Saves/loads a Scene (objects, lights, ambient) plus a camera pose to/from a
-// JSON file. This is the persistence layer that makes "projects" possible — see
-// .claude/PACKAGING_ROADMAP.md (Milestone 0). Format is versioned so it can
-// evolve without breaking older files.
+// scene file. This is the persistence layer that makes "projects" possible — see
+// .claude/PACKAGING_ROADMAP.md (Milestone 0). The file is binary, or JSON for a
+// ".json" path (SceneFile.hpp); both are versioned so they can evolve without
+// breaking older files.
 //
 // Load reconstructs GPU-backed content (GLTF models, primitive geometry) through
 // the Renderer, so a valid, initialized Renderer must be passed to Load().
 //------------------------------------------------------------------------------
 #pragma once
 
-#include <glm/glm.hpp>
+#include "Engine/Core/SceneFile.hpp"
 #include <string>
 
 namespace Nightbloom
 {
 	class Scene;
+	struct SceneObject;
 	class Renderer;
-
-	// Minimal camera pose carried alongside the scene. Kept as a POD (rather than
-	// the Camera class) so the engine's serializer doesn't depend on the free-fly
-	// Camera implementation — the editor maps its Camera to/from this.
-	struct SceneCameraState
-	{
-		glm::vec3 position = glm::vec3(0.0f);
-		float yaw = -90.0f;
-		float pitch = 0.0f;
-		float fov = 45.0f;        // vertical FOV, degrees
-		float nearPlane = 0.1f;   // infinite-far reverse-Z, so no far plane stored
-	};
+	class AsyncAssetLoader;
 
 	class SceneSerializer
 	{
 	public:
-		// Serialize scene + camera to a JSON file. 'editorStateJson', if non-empty,
+		// Serialize scene + camera to a scene file. 'editorStateJson', if non-empty,
 		// must be a JSON object string; it's stored verbatim under the top-level
 		// "editor" key. This lets the editor persist panel state (e.g. the day/night
 		// cycle) without the engine serializer knowing anything about editor panels.
@@ -43,13 +34,37 @@ namespace Nightbloom
 			const std::string& filepath, const std::string& sceneName = "Untitled",
 			const std::string& editorStateJson = std::string());
 
-		// Load a JSON scene file. Clears 'scene' (objects AND lights), then rebuilds
+		// What Save writes, as a snapshot of plain data: cheap enough to take
+		// on the main thread and hand to another one (SceneAutosave)
+		static SceneFileData Capture(const Scene& scene, const SceneCameraState& camera,
+			const std::string& sceneName = "Untitled", const std::string& editorStateJson = std::string());
+
+		// Load a scene file (either encoding). Clears 'scene' (objects AND lights), then rebuilds
 		// it, reconstructing models/primitives via 'renderer'. Fills 'camera'. If
 		// 'outEditorStateJson' is non-null, receives the "editor" object as a JSON
 		// string ("{}" if absent). Returns false on IO/parse error.
+		//
+		// With 'loader', model objects are added right away with empty models
+		// that fill in as their loads finish (AsyncAssetLoader::Update), so
+		// Load returns without waiting on any model file.
 		static bool Load(Scene& scene, SceneCameraState& camera,
 			const std::string& filepath, Renderer* renderer,
-			std::string* outEditorStateJson = nullptr);
+			std::string* outEditorStateJson = nullptr,
+			AsyncAssetLoader* loader = nullptr);
+
+		// What Load does once the file is read: rebuilds 'scene' from 'data'
+		// and sets 'camera'. For scenes that never were a file (StressScene).
+		// 'renderer' must be valid.
+		static void Build(Scene& scene, SceneCameraState& camera, const SceneFileData& data,
+			Renderer* renderer, AsyncAssetLoader* loader = nullptr);
+
+		// Adds one saved primitive object (no parent) with the renderer's
+		// built-in geometry. Null, with a warning, for a kind it can't rebuild.
+		static SceneObject* AddPrimitive(Scene& scene, const SceneFileObject& object, Renderer* renderer);
+
+		// Rewrites a scene file in the encoding outputPath's extension picks
+		// (JSON export/import), without touching any Scene or GPU state
+		static bool Convert(const std::string& inputPath, const std::string& outputPath);
 	};
 
 } // namespace Nightbloom
@@ -0,0 +1,307 @@
+//------------------------------------------------------------------------------
+// SceneStreamer.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/SceneStreamer.hpp"
+#include "Engine/Core/Scene.hpp"
+#include "Engine/Core/SceneSerializer.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/AsyncAssetLoader.hpp"
+#include "Engine/Renderer/Vulkan/VulkanTexture.hpp"  // complete type for VulkanTexture* -> Texture* upcast
+#include "Engine/Core/Logger/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace Nightbloom
+{
+	bool SceneStreamer::Open(Scene& scene, SceneCameraState& camera, const std::string& filepath,
+		Renderer* renderer, const WorldPartitionSettings& settings)
+	{
+		if (!renderer)
+		{
+			LOG_ERROR("SceneStreamer::Open requires a valid renderer");
+			return false;
+		}
+
+		// Missing JSON fields keep the camera and ambient the caller has
+		SceneFileData data;
+		data.camera = camera;
+		data.ambientColor = scene.GetAmbientColor();
+		data.ambientIntensity = scene.GetAmbientIntensity();
+
+		std::string error;
+		if (!ReadSceneFile(filepath, data, error))
+		{
+			LOG_ERROR("SceneStreamer: failed to read '{}': {}", filepath, error);
+			return false;
+		}
+
+		scene.Clear();
+		while (scene.GetLightCount() > 0)
+			scene.RemoveLight(scene.GetLightCount() - 1);
+
+		camera = data.camera;
+		scene.SetAmbient(data.ambientColor, data.ambientIntensity);
+
+		m_Renderer = renderer;
+		m_Data = std::move(data);
+		m_Partition.Reset(settings);
+		m_Cells.clear();
+		m_SceneIndex.assign(m_Data.objects.size(), -1);
+		m_HasLastCamera = false;
+		m_Velocity = glm::vec3(0.0f);
+
+		auto cellContent = [this](uint32_t cell) -> CellContent&
+		{
+			if (cell >= m_Cells.size())
+				m_Cells.resize(cell + 1);
+			return m_Cells[cell];
+		};
+
+		// Directional lights light everything, wherever the camera is
+		for (uint32_t i = 0; i < m_Data.lights.size(); ++i)
+		{
+			const Light& light = m_Data.lights[i];
+			if (light.type == LightType::Directional)
+				*scene.AddLight(light.name, light.type) = light;
+			else
+				cellContent(m_Partition.AddContent(light.position, 0)).lights.push_back(i);
+		}
+
+		// Objects go with their hierarchy's root; a model file placed several
+		// times in one cell is loaded (and counted) once
+		std::vector<std::vector<std::string>> cellSources;
+		const size_t objectCount = m_Data.objects.size();
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			size_t root = i;
+			for (size_t steps = 0; steps < objectCount; ++steps)
+			{
+				const int32_t parent = m_Data.objects[root].parent;
+				if (parent < 0 || static_cast<size_t>(parent) >= objectCount)
+					break;
+				root = static_cast<size_t>(parent);
+			}
+
+			const SceneFileObject& object = m_Data.objects[i];
+			const glm::vec3& position = m_Data.objects[root].position;
+			const uint32_t cell = m_Partition.AddContent(position, OBJECT_BYTES);
+			cellContent(cell).objects.push_back(i);
+
+			if (object.kind != SceneFileObject::Kind::Model || object.source.empty())
+				continue;
+			if (cell >= cellSources.size())
+				cellSources.resize(cell + 1);
+			std::vector<std::string>& sources = cellSources[cell];
+			if (std::find(sources.begin(), sources.end(), object.source) != sources.end())
+				continue;
+			sources.push_back(object.source);
+
+			std::error_code ec;
+			const uintmax_t fileSize = std::filesystem::file_size(object.source, ec);
+			if (!ec)
+				m_Partition.AddContent(position, static_cast<uint64_t>(fileSize));
+		}
+		m_Cells.resize(m_Partition.GetCellCount());
+
+		if (!renderer->GetAssetLoader())
+			LOG_WARN("SceneStreamer: no asset loader, cells load their models on the main thread");
+
+		LOG_INFO("SceneStreamer: opened '{}' ({} objects, {} lights in {} cells of {} m)",
+			filepath, m_Data.objects.size(), m_Data.lights.size(), m_Partition.GetCellCount(),
+			m_Partition.GetSettings().cellSize);
+		return true;
+	}
+
+	void SceneStreamer::Close(Scene& scene)
+	{
+		if (!IsOpen())
+			return;
+
+		m_Partition.UnloadAll(m_Unloads);
+		for (uint32_t cell : m_Unloads)
+			UnloadCell(scene, cell);
+
+		m_Renderer = nullptr;
+		m_Data = SceneFileData{};
+		m_Partition.Reset(m_Partition.GetSettings());
+		m_Cells.clear();
+		m_SceneIndex.clear();
+	}
+
+	void SceneStreamer::Update(Scene& scene, const glm::vec3& cameraPosition, float deltaTime)
+	{
+		if (!IsOpen())
+			return;
+
+		if (m_HasLastCamera && deltaTime > 0.0f)
+		{
+			const glm::vec3 measured = (cameraPosition - m_LastCamera) / deltaTime;
+			const float blend = 1.0f - std::exp(-VELOCITY_RESPONSE * deltaTime);
+			m_Velocity += (measured - m_Velocity) * blend;
+		}
+		m_LastCamera = cameraPosition;
+		m_HasLastCamera = true;
+
+		for (uint32_t cell = 0; cell < m_Cells.size(); ++cell)
+		{
+			const CellContent& content = m_Cells[cell];
+			if (m_Partition.GetState(cell) == WorldCellState::Loading && content.load && content.load->pendingModels == 0)
+				m_Partition.MarkLoaded(cell);
+		}
+
+		m_Partition.Update(cameraPosition, m_Velocity, m_Loads, m_Unloads);
+
+		// Drops first, so their memory is on its way out before the loads
+		for (uint32_t cell : m_Unloads)
+			UnloadCell(scene, cell);
+		for (uint32_t cell : m_Loads)
+			LoadCell(scene, cell);
+	}
+
+	void SceneStreamer::LoadCell(Scene& scene, uint32_t cell)
+	{
+		CellContent& content = m_Cells[cell];
+		content.load = std::make_shared<CellLoad>();
+
+		for (uint32_t index : content.lights)
+		{
+			const Light& light = m_Data.lights[index];
+			Light* added = scene.AddLight(light.name, light.type);
+			*added = light;
+			added->streamCell = static_cast<int32_t>(cell);
+		}
+
+		ResourceManager* resources = m_Renderer->GetResourceManager();
+		AsyncAssetLoader* loader = m_Renderer->GetAssetLoader();
+		Texture* defaultTex = resources ? resources->GetTexture("default_white") : nullptr;
+		ModelCache* modelCache = resources ? &resources->GetModelCache() : nullptr;
+
+		for (uint32_t index : content.objects)
+		{
+			const SceneFileObject& object = m_Data.objects[index];
+			SceneObject* o = nullptr;
+
+			if (object.kind == SceneFileObject::Kind::Model)
+			{
+				const std::string& name = object.name;
+				const std::string& source = object.source;
+				if (source.empty())
+				{
+					LOG_WARN("SceneStreamer: model object '{}' has no source path — skipped", name);
+					continue;
+				}
+
+				auto createModel = [&]() -> std::shared_ptr<Model>
+				{
+					auto model = std::make_shared<Model>(name);
+					if (loader)
+					{
+						std::shared_ptr<CellLoad> load = content.load;
+						++load->pendingModels;
+						Scene* target = &scene;
+						loader->LoadModel(*model, source, [target, load, name, source](Model& loaded, bool ok)
+							{
+								--load->pendingModels;
+								if (ok)
+									target->RefreshModelBounds(&loaded);
+								else
+									LOG_WARN("SceneStreamer: failed to load model '{}' from '{}' — left empty", name, source);
+							});
+						return model;
+					}
+
+					if (!model->LoadFromFile(source, resources, m_Renderer->GetDescriptorManager()))
+						return nullptr;
+					return model;
+				};
+				std::shared_ptr<Model> model = modelCache ? modelCache->Acquire(source, createModel) : createModel();
+				if (!model)
+				{
+					LOG_WARN("SceneStreamer: failed to load model '{}' from '{}' — skipped", name, source);
+					continue;
+				}
+
+				o = scene.AddObject(name, std::move(model), defaultTex);
+				if (o)
+				{
+					o->SetVisible(object.visible);
+					o->localPosition = object.position;
+					o->localRotation = object.rotation;
+					o->localScale = object.scale;
+					o->UpdateLocalTransform();
+				}
+			}
+			else
+			{
+				o = SceneSerializer::AddPrimitive(scene, object, m_Renderer);
+			}
+
+			if (o)
+			{
+				o->streamCell = static_cast<int32_t>(cell);
+				m_SceneIndex[index] = static_cast<int>(scene.GetObjectCount()) - 1;
+			}
+		}
+
+		// A hierarchy is all in one cell, so every parent is in this batch
+		for (uint32_t index : content.objects)
+		{
+			const int32_t parent = m_Data.objects[index].parent;
+			const int child = m_SceneIndex[index];
+			if (child < 0 || parent < 0 || static_cast<size_t>(parent) >= m_SceneIndex.size() || m_SceneIndex[parent] < 0)
+				continue;
+			if (!scene.SetParent(static_cast<size_t>(child), m_SceneIndex[parent]))
+				LOG_WARN("SceneStreamer: object '{}' can't be parented (cycle) — left at the root",
+					scene.GetObject(child)->name);
+		}
+		for (uint32_t index : content.objects)
+			m_SceneIndex[index] = -1;
+
+		LOG_DEBUG("SceneStreamer: loading cell ({}, {}): {} objects, {} lights, {} models pending",
+			m_Partition.GetCoord(cell).x, m_Partition.GetCoord(cell).z,
+			content.objects.size(), content.lights.size(), content.load->pendingModels);
+	}
+
+	void SceneStreamer::UnloadCell(Scene& scene, uint32_t cell)
+	{
+		// Loads still in flight count down a load nobody checks any more
+		m_Cells[cell].load.reset();
+		const int32_t tag = static_cast<int32_t>(cell);
+
+		// Frames in flight may still draw these; they go once those finish
+		struct RetiredObject
+		{
+			std::shared_ptr<Model> model;
+			std::unique_ptr<ModelDrawable> drawable;
+			std::unique_ptr<MeshDrawable> meshDrawable;
+		};
+		auto retired = std::make_shared<std::vector<RetiredObject>>();
+
+		const std::vector<SceneObject>& objects = scene.GetObjects();
+		for (size_t i = objects.size(); i-- > 0;)
+		{
+			SceneObject& object = *scene.GetObject(i);
+			if (object.streamCell != tag)
+				continue;
+			retired->push_back({ std::move(object.model), std::move(object.drawable), std::move(object.meshDrawable) });
+			scene.RemoveObject(i);
+		}
+
+		for (size_t i = scene.GetLightCount(); i-- > 0;)
+		{
+			if (scene.GetLight(i)->streamCell == tag)
+				scene.RemoveLight(i);
+		}
+
+		ResourceManager* resources = m_Renderer->GetResourceManager();
+		if (resources && !retired->empty())
+			resources->Defer([retired]() { retired->clear(); });
+
+		LOG_DEBUG("SceneStreamer: unloaded cell ({}, {})", m_Partition.GetCoord(cell).x, m_Partition.GetCoord(cell).z);
+	}
+
+} // namespace Nightbloom
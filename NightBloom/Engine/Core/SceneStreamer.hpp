@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// SceneStreamer.hpp
+//
+// Loads a scene file cell by cell around the camera instead of all at once,
+// for exterior levels too large to keep in memory (WorldPartition.hpp decides
+// which cells). Open reads the file and keeps it as plain data; only the
+// scene-wide parts go into the Scene right away: ambient, the camera pose and
+// directional lights. Every object belongs to the cell under its hierarchy
+// root (so a hierarchy never straddles cells) and every point light to the
+// cell under it, and each Update adds the content of cells coming into range
+// and removes that of cells leaving it.
+//
+// Adding a cell costs the main thread little: primitives reuse the built-in
+// geometry, and model files are read, parsed and decoded on the renderer's
+// AsyncAssetLoader threads and uploaded a few per frame by its Update. The
+// cell counts as loaded once its models have. Removed objects' models and
+// drawables are released through ResourceManager::Defer, after the frames
+// still drawing them. A cell's memory estimate is the size of each model file
+// it places (once per file) plus OBJECT_BYTES per object.
+//
+// Terrain and grass stream on their own (TerrainDesc::streaming keeps a tile
+// window around the camera, and grass is scattered over the terrain); give
+// TerrainDesc::tileWorldSize the cell size to keep both on the same grid.
+//
+// Saving a streamed scene captures only the cells loaded at the time, so
+// levels are edited through SceneSerializer::Load and streamed at run time.
+//
+// Usage:
+//   SceneStreamer streamer;
+//   streamer.Open(scene, cameraState, "Assets/Scenes/Valley.nbscene", renderer, settings);
+//   // every frame, before scene.Update:
+//   streamer.Update(scene, camera.GetPosition(), deltaTime);
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/SceneFile.hpp"
+#include "Engine/Core/WorldPartition.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	class Scene;
+	class Renderer;
+
+	class SceneStreamer
+	{
+	public:
+		// Memory estimate per object on top of its model
+		static constexpr uint64_t OBJECT_BYTES = 1024;
+
+		// How quickly the camera velocity used for prefetch follows the
+		// camera, per second; smooths out frame-time jitter
+		static constexpr float VELOCITY_RESPONSE = 4.0f;
+
+		SceneStreamer() = default;
+		~SceneStreamer() = default;
+
+		// Clears `scene` (objects and lights) and sets it up for streaming
+		// from `filepath` (either encoding). Fills `camera`. Nothing streams
+		// in until the first Update. False on IO/parse error.
+		bool Open(Scene& scene, SceneCameraState& camera, const std::string& filepath,
+			Renderer* renderer, const WorldPartitionSettings& settings = {});
+
+		// Removes every streamed object and light; the rest of the scene stays
+		void Close(Scene& scene);
+
+		// Main thread, once per frame before Scene::Update
+		void Update(Scene& scene, const glm::vec3& cameraPosition, float deltaTime);
+
+		bool IsOpen() const { return m_Renderer != nullptr; }
+
+		// Radii, prefetch and budget; the cell size is fixed by Open
+		void SetSettings(const WorldPartitionSettings& settings) { m_Partition.SetSettings(settings); }
+		const WorldPartition& GetPartition() const { return m_Partition; }
+
+	private:
+		// Models of one cell load still in flight. Replaced on every load of
+		// the cell, so callbacks from a load the camera left behind count
+		// down a stale one.
+		struct CellLoad
+		{
+			uint32_t pendingModels = 0;
+		};
+
+		struct CellContent
+		{
+			std::vector<uint32_t> objects;       // SceneFileData::objects
+			std::vector<uint32_t> lights;        // SceneFileData::lights
+			std::shared_ptr<CellLoad> load;
+		};
+
+		void LoadCell(Scene& scene, uint32_t cell);
+		void UnloadCell(Scene& scene, uint32_t cell);
+
+		Renderer* m_Renderer = nullptr;
+		SceneFileData m_Data;
+		WorldPartition m_Partition;
+		std::vector<CellContent> m_Cells;        // parallel to the partition's cells
+
+		glm::vec3 m_LastCamera = glm::vec3(0.0f);
+		glm::vec3 m_Velocity = glm::vec3(0.0f);
+		bool m_HasLastCamera = false;
+
+		// Update scratch
+		std::vector<uint32_t> m_Loads;
+		std::vector<uint32_t> m_Unloads;
+		std::vector<int> m_SceneIndex;           // saved object -> scene index, LoadCell
+
+		SceneStreamer(const SceneStreamer&) = delete;
+		SceneStreamer& operator=(const SceneStreamer&) = delete;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+// SharedAssetCache.hpp
+//
+// Source path -> asset, for assets many scene objects can share (a prop
+// placed twenty times is one Model: one parse, one set of vertex/index
+// buffers and materials). The cache holds weak references only; the objects
+// using an asset keep it alive, and it is freed when the last one goes. A
+// later Acquire of the same path then loads it again.
+//
+// Paths are compared lexically normalized ("Assets/./a.gltf" and
+// "Assets/a.gltf" are the same asset), not resolved against the disk.
+// Main thread only, like the Scene that uses it.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+	template <typename T>
+	class SharedAssetCache
+	{
+	public:
+		SharedAssetCache() = default;
+		SharedAssetCache(const SharedAssetCache&) = delete;
+		SharedAssetCache& operator=(const SharedAssetCache&) = delete;
+
+		static std::string NormalizeKey(const std::string& path)
+		{
+			return std::filesystem::path(path).lexically_normal().generic_string();
+		}
+
+		// The live asset for `path`, or null
+		std::shared_ptr<T> Find(const std::string& path) const
+		{
+			auto it = m_Entries.find(NormalizeKey(path));
+			return it != m_Entries.end() ? it->second.lock() : nullptr;
+		}
+
+		// The live asset for `path`, else whatever create() returns. A null
+		// from create() (the load failed) is not remembered, so the next
+		// Acquire tries again.
+		template <typename CreateFn>
+		std::shared_ptr<T> Acquire(const std::string& path, CreateFn&& create)
+		{
+			const std::string key = NormalizeKey(path);
+			auto it = m_Entries.find(key);
+			if (it != m_Entries.end())
+			{
+				if (std::shared_ptr<T> existing = it->second.lock())
+				{
+					++m_Hits;
+					return existing;
+				}
+			}
+
+			++m_Misses;
+			std::shared_ptr<T> created = create();
+			if (created)
+				m_Entries[key] = created;
+			else if (it != m_Entries.end())
+				m_Entries.erase(it);
+			return created;
+		}
+
+		// fn(key, asset) for every live asset, keys as NormalizeKey gives them
+		template <typename Fn>
+		void ForEach(Fn&& fn) const
+		{
+			for (const auto& [key, entry] : m_Entries)
+			{
+				if (std::shared_ptr<T> asset = entry.lock())
+					fn(key, asset);
+			}
+		}
+
+		// Drops the entries of assets no one holds any more; returns how many
+		size_t Prune()
+		{
+			size_t removed = 0;
+			for (auto it = m_Entries.begin(); it != m_Entries.end();)
+			{
+				if (it->second.expired())
+				{
+					it = m_Entries.erase(it);
+					++removed;
+				}
+				else
+				{
+					++it;
+				}
+			}
+			return removed;
+		}
+
+		// Forgets every entry; assets in use stay alive with their users
+		void Clear() { m_Entries.clear(); }
+
+		size_t GetLiveCount() const
+		{
+			size_t live = 0;
+			for (const auto& [key, entry] : m_Entries)
+				live += entry.expired() ? 0 : 1;
+			return live;
+		}
+
+		uint64_t GetHitCount() const { return m_Hits; }
+		uint64_t GetMissCount() const { return m_Misses; }
+
+	private:
+		std::unordered_map<std::string, std::weak_ptr<T>> m_Entries;
+		uint64_t m_Hits = 0;
+		uint64_t m_Misses = 0;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+// SpscRing.hpp
+//
+// Bounded lock-free single-producer / single-consumer ring. One thread
+// pushes, one other thread pops; each side owns its index and only reads
+// the other's, so a push or pop is a load, a copy and a release store.
+// A full ring makes TryPush fail (and counts the drop) rather than wait:
+// the producer is usually a thread that must never block on the consumer.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace Nightbloom
+{
+	template<typename T>
+	class SpscRing
+	{
+	public:
+		// `capacity` is rounded up to a power of two
+		explicit SpscRing(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+
+			m_Capacity = size;
+			m_Mask = size - 1;
+			m_Slots = std::make_unique<T[]>(size);
+		}
+
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		// Producer thread only. False (and counted) when the ring is full.
+		bool TryPush(const T& value)
+		{
+			const uint64_t head = m_Head.load(std::memory_order_relaxed);
+			if (head - m_Tail.load(std::memory_order_acquire) == m_Capacity)
+			{
+				m_Dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			m_Slots[head & m_Mask] = value;
+			m_Head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer thread only. False when the ring is empty.
+		bool TryPop(T& value)
+		{
+			const uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+			if (tail == m_Head.load(std::memory_order_acquire))
+				return false;
+
+			value = m_Slots[tail & m_Mask];
+			m_Tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Approximate from any thread other than the two ends
+		size_t GetSize() const
+		{
+			return static_cast<size_t>(m_Head.load(std::memory_order_acquire) - m_Tail.load(std::memory_order_acquire));
+		}
+		size_t GetCapacity() const { return m_Capacity; }
+		uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+	private:
+		std::unique_ptr<T[]> m_Slots;
+		size_t m_Capacity = 0;
+		uint64_t m_Mask = 0;
+
+		// Producer and consumer indices on separate cache lines
+		alignas(64) std::atomic<uint64_t> m_Head{ 0 };
+		std::atomic<uint64_t> m_Dropped{ 0 };
+		alignas(64) std::atomic<uint64_t> m_Tail{ 0 };
+	};
+}
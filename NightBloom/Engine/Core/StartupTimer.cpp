@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+// StartupTimer.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/StartupTimer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Nightbloom
+{
+	StartupTimer& StartupTimer::Get()
+	{
+		static StartupTimer instance;
+		return instance;
+	}
+
+	double StartupTimer::Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void StartupTimer::Start(double now)
+	{
+		m_Phases.clear();
+		m_Start = now;
+		m_LastMark = now;
+		m_Running = true;
+		m_Finished = false;
+	}
+
+	void StartupTimer::Mark(const char* phase, double now, std::string detail)
+	{
+		if (!m_Running)
+			return;
+
+		Phase entry;
+		entry.name = phase;
+		entry.detail = std::move(detail);
+		entry.seconds = std::max(now - m_LastMark, 0.0);
+		m_Phases.push_back(std::move(entry));
+		m_LastMark = std::max(now, m_LastMark);
+	}
+
+	bool StartupTimer::Finish(double now)
+	{
+		if (!m_Running)
+			return false;
+
+		Mark("First frame", now);
+		m_Running = false;
+		m_Finished = true;
+		return true;
+	}
+
+	std::string StartupTimer::FormatReport() const
+	{
+		const double total = GetTotalSeconds();
+
+		char line[256];
+		std::snprintf(line, sizeof(line), "Startup: %.2f s to first frame", total);
+		std::string report = line;
+
+		for (const Phase& phase : m_Phases)
+		{
+			const double share = total > 0.0 ? 100.0 * phase.seconds / total : 0.0;
+			std::snprintf(line, sizeof(line), "\n  %-22s %9.1f ms %4.0f%%",
+				phase.name.c_str(), phase.seconds * 1000.0, share);
+			report += line;
+			if (!phase.detail.empty())
+				report += "  (" + phase.detail + ")";
+		}
+		return report;
+	}
+}
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+// StartupTimer.hpp
+//
+// Time to first frame, broken into phases. EngineInit starts it; each
+// startup step marks the end of its phase (timed from the previous mark),
+// and the first frame that runs finishes it and logs the report once:
+//
+//   StartupTimer::Get().Mark("Pipelines", StartupTimer::Now(), "61 on 16 threads");
+//
+// Marks before Start or after Finish are ignored, so code that also runs
+// later (a renderer rebuilt after startup) needs no checks. Times are
+// seconds on any monotonic clock.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	class StartupTimer
+	{
+	public:
+		struct Phase
+		{
+			std::string name;
+			std::string detail;   // e.g. how many pipelines, on how many threads
+			double seconds = 0.0;
+		};
+
+		static StartupTimer& Get();
+
+		// Seconds on the steady clock
+		static double Now();
+
+		void Start(double now);
+		void Mark(const char* phase, double now, std::string detail = {});
+
+		// The first frame ran: closes the last phase as "First frame".
+		// True only the first time after Start.
+		bool Finish(double now);
+
+		bool IsRunning() const { return m_Running; }
+		bool IsFinished() const { return m_Finished; }
+		double GetTotalSeconds() const { return m_LastMark - m_Start; }
+		const std::vector<Phase>& GetPhases() const { return m_Phases; }
+
+		// One line per phase with its share of the total
+		std::string FormatReport() const;
+
+	private:
+		std::vector<Phase> m_Phases;
+		double m_Start = 0.0;
+		double m_LastMark = 0.0;
+		bool m_Running = false;
+		bool m_Finished = false;
+	};
+}
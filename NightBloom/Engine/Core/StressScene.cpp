@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+// StressScene.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/StressScene.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr float TWO_PI = 6.2831853f;
+
+		// xorshift32 - the same sequence on every platform, unlike <random>'s
+		// distributions
+		class StressRandom
+		{
+		public:
+			explicit StressRandom(uint32_t seed) : m_State(seed ? seed : 1u) {}
+
+			uint32_t Next()
+			{
+				m_State ^= m_State << 13;
+				m_State ^= m_State >> 17;
+				m_State ^= m_State << 5;
+				return m_State;
+			}
+
+			// [lo, hi)
+			float Range(float lo, float hi)
+			{
+				return lo + (hi - lo) * static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+			}
+
+		private:
+			uint32_t m_State;
+		};
+
+		// Where object `index` goes, on the ground. Lights scatter over the
+		// same grid cells and clusters as the objects.
+		class Scatter
+		{
+		public:
+			Scatter(const StressSceneDesc& desc, float halfSize, const std::vector<glm::vec2>& clusters,
+				StressRandom& random)
+				: m_Desc(desc), m_HalfSize(halfSize), m_Clusters(clusters), m_Random(random)
+			{
+				m_GridSide = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(desc.objectCount)))));
+			}
+
+			glm::vec2 Place(uint32_t index)
+			{
+				switch (m_Desc.distribution)
+				{
+				case StressDistribution::Grid:
+				{
+					const float cell = 2.0f * m_HalfSize / static_cast<float>(m_GridSide);
+					return glm::vec2(-m_HalfSize + cell * (static_cast<float>(index % m_GridSide) + 0.5f),
+						-m_HalfSize + cell * (static_cast<float>(index / m_GridSide) + 0.5f));
+				}
+				case StressDistribution::Clustered:
+				{
+					// Two uniforms summed: dense at the centre, none past the radius
+					const glm::vec2 centre = m_Clusters[m_Random.Next() % m_Clusters.size()];
+					const float distance = 0.5f * m_Desc.clusterRadius * (m_Random.Range(0.0f, 1.0f) + m_Random.Range(0.0f, 1.0f));
+					const float angle = m_Random.Range(0.0f, TWO_PI);
+					const glm::vec2 p = centre + distance * glm::vec2(std::cos(angle), std::sin(angle));
+					return glm::clamp(p, glm::vec2(-m_HalfSize), glm::vec2(m_HalfSize));
+				}
+				case StressDistribution::Uniform:
+				default:
+					return glm::vec2(m_Random.Range(-m_HalfSize, m_HalfSize), m_Random.Range(-m_HalfSize, m_HalfSize));
+				}
+			}
+
+		private:
+			const StressSceneDesc& m_Desc;
+			float m_HalfSize;
+			const std::vector<glm::vec2>& m_Clusters;
+			StressRandom& m_Random;
+			uint32_t m_GridSide = 1;
+		};
+
+		const StressAsset& PickAsset(const std::vector<StressAsset>& assets, float totalWeight, StressRandom& random)
+		{
+			float pick = random.Range(0.0f, totalWeight);
+			for (const StressAsset& asset : assets)
+			{
+				if (asset.weight <= 0.0f)
+					continue;
+				if (pick < asset.weight)
+					return asset;
+				pick -= asset.weight;
+			}
+			// Rounding at the top of the range
+			for (auto it = assets.rbegin(); it != assets.rend(); ++it)
+			{
+				if (it->weight > 0.0f)
+					return *it;
+			}
+			return assets.back();
+		}
+	}
+
+	StressScene GenerateStressScene(const StressSceneDesc& desc)
+	{
+		StressScene scene;
+		scene.halfSize = 0.5f * std::sqrt(static_cast<float>(std::max(desc.objectCount, 1u)) * std::max(desc.areaPerObject, 0.01f));
+		const float halfSize = scene.halfSize;
+
+		SceneFileData& data = scene.data;
+		data.name = desc.name;
+		data.ambientColor = glm::vec3(0.4f, 0.45f, 0.55f);
+		data.ambientIntensity = 0.3f;
+
+		// From the +z edge, looking across to the centre
+		const glm::vec3 eye(0.0f, std::max(20.0f, 0.15f * halfSize), halfSize);
+		const glm::vec3 forward = glm::normalize(-eye);
+		data.camera.position = eye;
+		data.camera.yaw = glm::degrees(std::atan2(forward.z, forward.x));
+		data.camera.pitch = glm::degrees(std::asin(forward.y));
+		data.camera.fov = 60.0f;
+
+		// Separate streams, so more lights don't move the objects
+		StressRandom objectRandom(desc.seed);
+		StressRandom lightRandom(desc.seed ^ 0x9e3779b9u);
+		StressRandom clusterRandom(desc.seed ^ 0x85ebca6bu);
+
+		std::vector<glm::vec2> clusters(desc.distribution == StressDistribution::Clustered ? std::max(desc.clusterCount, 1u) : 0u);
+		for (glm::vec2& centre : clusters)
+			centre = glm::vec2(clusterRandom.Range(-halfSize, halfSize), clusterRandom.Range(-halfSize, halfSize));
+
+		std::vector<StressAsset> assets = desc.assets;
+		float totalWeight = 0.0f;
+		for (const StressAsset& asset : assets)
+			totalWeight += std::max(asset.weight, 0.0f);
+		if (totalWeight <= 0.0f)
+		{
+			assets.assign(1, StressAsset{});
+			totalWeight = 1.0f;
+		}
+
+		Scatter objectScatter(desc, halfSize, clusters, objectRandom);
+		data.objects.reserve(desc.objectCount);
+		char name[32];
+		for (uint32_t i = 0; i < desc.objectCount; ++i)
+		{
+			const StressAsset& asset = PickAsset(assets, totalWeight, objectRandom);
+			const glm::vec2 ground = objectScatter.Place(i);
+
+			SceneFileObject& object = data.objects.emplace_back();
+			std::snprintf(name, sizeof(name), "Stress_%06u", i);
+			object.name = name;
+			if (!asset.source.empty())
+			{
+				object.kind = SceneFileObject::Kind::Model;
+				object.source = asset.source;
+			}
+			else
+			{
+				object.kind = SceneFileObject::Kind::Primitive;
+				object.primitive = asset.primitive;
+				object.texture = asset.texture;
+			}
+			object.position = glm::vec3(ground.x, 0.0f, ground.y);
+			object.rotation = glm::vec3(0.0f, objectRandom.Range(0.0f, TWO_PI), 0.0f);
+			object.scale = glm::vec3(objectRandom.Range(asset.minScale, std::max(asset.minScale, asset.maxScale)));
+		}
+
+		if (desc.sun)
+		{
+			Light& sun = data.lights.emplace_back();
+			sun.name = "Sun";
+			sun.type = LightType::Directional;
+			sun.color = glm::vec3(1.0f, 0.95f, 0.85f);
+			sun.intensity = 3.0f;
+			sun.direction = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f));
+		}
+
+		Scatter lightScatter(desc, halfSize, clusters, lightRandom);
+		for (uint32_t i = 0; i < desc.pointLightCount; ++i)
+		{
+			// Spread over the grid, not along its first rows
+			const uint64_t cell = static_cast<uint64_t>(i) * std::max(desc.objectCount, 1u) / desc.pointLightCount;
+			const glm::vec2 ground = lightScatter.Place(static_cast<uint32_t>(cell));
+
+			Light& light = data.lights.emplace_back();
+			std::snprintf(name, sizeof(name), "StressLight_%04u", i);
+			light.name = name;
+			light.type = LightType::Point;
+			light.position = glm::vec3(ground.x, lightRandom.Range(1.0f, 6.0f), ground.y);
+			// Warm to cool, never dark
+			const float hue = lightRandom.Range(0.0f, 1.0f);
+			light.color = glm::mix(glm::vec3(1.0f, 0.6f, 0.3f), glm::vec3(0.4f, 0.7f, 1.0f), hue);
+			light.intensity = lightRandom.Range(2.0f, 6.0f);
+			light.radius = desc.lightRadius;
+		}
+
+		// Water: one plane per cell of a square grid, so they never overlap
+		if (desc.waterPlaneCount > 0)
+		{
+			const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(desc.waterPlaneCount))));
+			const float cell = 2.0f * halfSize / static_cast<float>(side);
+			for (uint32_t i = 0; i < desc.waterPlaneCount; ++i)
+			{
+				StressWaterPlane& plane = scene.waterPlanes.emplace_back();
+				plane.position = glm::vec3(-halfSize + cell * (static_cast<float>(i % side) + 0.5f), desc.waterY,
+					-halfSize + cell * (static_cast<float>(i / side) + 0.5f));
+				plane.size = std::min(desc.waterPlaneSize, cell);
+			}
+		}
+
+		scene.fireflyCount = desc.fireflyCount;
+		scene.fireflyCenter = glm::vec3(0.0f, 6.0f, 0.0f);
+		scene.fireflyExtents = glm::vec3(halfSize, 5.0f, halfSize);
+		return scene;
+	}
+}
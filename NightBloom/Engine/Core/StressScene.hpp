@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// StressScene.hpp
+//
+// Procedural scenes for scalability testing: thousands of objects, hundreds
+// of point lights, several water planes and a firefly swarm, laid out from a
+// seed so the same desc always gives the same scene on every platform.
+//
+// The objects and lights come out as SceneFileData, the form
+// SceneSerializer::Build turns into a live Scene and WriteSceneFile saves,
+// so a generated scene runs and is stored like any authored one. Water
+// planes and the swarm aren't scene content; they come out alongside it for
+// the caller's WaterSystem/FireflySystem (NightbloomBench's "stress" config).
+//
+//   Uniform    objects anywhere on the square
+//   Grid       one per cell of the smallest square grid that holds them
+//   Clustered  around clusterCount random centres, thinning out to
+//              clusterRadius, as towns and forests do
+//
+// The square is sized from `areaPerObject`, so density stays the same as
+// the count grows. Assets are picked by weight; with none, every object is
+// the built-in test cube.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/SceneFile.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class StressDistribution : uint8_t
+	{
+		Uniform,
+		Grid,
+		Clustered
+	};
+
+	// One entry of the asset mix: a glTF model, or a built-in primitive
+	// when `source` is empty
+	struct StressAsset
+	{
+		std::string source;                // glTF path
+		std::string primitive = "TestCube";
+		std::string texture = "uv_checker";
+		float weight = 1.0f;               // relative to the mix's total
+		float minScale = 1.0f;
+		float maxScale = 1.0f;
+	};
+
+	struct StressSceneDesc
+	{
+		std::string name = "Stress";
+		uint32_t seed = 1;
+
+		uint32_t objectCount = 1000;
+		StressDistribution distribution = StressDistribution::Uniform;
+		float areaPerObject = 25.0f;       // m^2, sets the square's size
+		uint32_t clusterCount = 16;        // Clustered only
+		float clusterRadius = 30.0f;
+		std::vector<StressAsset> assets;   // empty: test cubes
+
+		uint32_t pointLightCount = 0;      // scattered like the objects, 1-6 m up
+		float lightRadius = 15.0f;
+		bool sun = true;                   // a directional light first
+
+		uint32_t waterPlaneCount = 0;
+		float waterPlaneSize = 60.0f;
+		float waterY = 0.5f;               // shared: the renderer reflects in one plane
+
+		uint32_t fireflyCount = 0;         // one swarm over the whole square
+	};
+
+	struct StressWaterPlane
+	{
+		glm::vec3 position = glm::vec3(0.0f);   // WaterDesc::position; y is waterY
+		float size = 0.0f;                      // WaterDesc::worldSize
+	};
+
+	struct StressScene
+	{
+		SceneFileData data;
+		std::vector<StressWaterPlane> waterPlanes;
+		uint32_t fireflyCount = 0;
+		glm::vec3 fireflyCenter = glm::vec3(0.0f);
+		glm::vec3 fireflyExtents = glm::vec3(0.0f);
+		float halfSize = 0.0f;             // the square spans [-halfSize, halfSize] in x and z
+	};
+
+	StressScene GenerateStressScene(const StressSceneDesc& desc);
+}
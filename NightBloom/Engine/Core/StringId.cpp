@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+// StringId.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/StringId.hpp"
+#include "Core/Logger/Logger.hpp"
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Hash -> text. Nodes never move, so the texts' pointers stay valid
+		// as the table grows.
+		struct StringTable
+		{
+			std::shared_mutex mutex;
+			std::unordered_map<uint32_t, std::string> texts;
+		};
+
+		StringTable& GetTable()
+		{
+			static StringTable table;
+			return table;
+		}
+
+		uint32_t Intern(std::string_view text)
+		{
+			const uint32_t hash = HashString(text);
+			if (hash == 0)
+				return 0;
+
+			StringTable& table = GetTable();
+			{
+				std::shared_lock<std::shared_mutex> lock(table.mutex);
+				auto it = table.texts.find(hash);
+				if (it != table.texts.end())
+				{
+					if (it->second != text)
+						LOG_ERROR("StringId collision: \"{}\" and \"{}\" both hash to {:08x}", it->second, text, hash);
+					return hash;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> lock(table.mutex);
+			table.texts.try_emplace(hash, text);
+			return hash;
+		}
+	}
+
+	StringId::StringId(const char* text)
+		: m_Value(text ? Intern(text) : 0)
+	{
+	}
+
+	StringId::StringId(std::string_view text)
+		: m_Value(Intern(text))
+	{
+	}
+
+	const char* StringId::c_str() const
+	{
+		if (m_Value == 0)
+			return "";
+
+		StringTable& table = GetTable();
+		std::shared_lock<std::shared_mutex> lock(table.mutex);
+		auto it = table.texts.find(m_Value);
+		return it != table.texts.end() ? it->second.c_str() : "";
+	}
+
+	size_t GetInternedStringCount()
+	{
+		StringTable& table = GetTable();
+		std::shared_lock<std::shared_mutex> lock(table.mutex);
+		return table.texts.size();
+	}
+}
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// StringId.hpp
+//
+// Interned names as 32-bit ids: the FNV-1a hash of the text. Constructing a
+// StringId from text interns it - the first time a text is seen it's copied
+// into a global table, after that it's a hash and a shared-lock lookup, no
+// allocation - so GetText() can always give the text back. "Shadow"_sid
+// hashes a literal at compile time instead; it's the same id, and its text
+// is known once anything interned it (the resource it names was created
+// under it, the scope was begun with it).
+//
+// Meant for the names the engine looks things up by or tags things with
+// every frame - profiler scopes, render pass statistics, resource lookups -
+// where a std::string would be copied or built per use. Two texts with the
+// same hash are a collision: the table keeps the first and logs an error,
+// and both names then mean the same thing.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Nightbloom
+{
+	// 32-bit FNV-1a. The empty text hashes to 0, the invalid id.
+	constexpr uint32_t HashString(std::string_view text)
+	{
+		if (text.empty())
+			return 0;
+
+		uint32_t hash = 2166136261u;
+		for (char c : text)
+			hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+		return hash;
+	}
+
+	class StringId
+	{
+	public:
+		constexpr StringId() = default;
+
+		// Intern `text`; an empty or null text is the invalid id
+		StringId(const char* text);
+		StringId(std::string_view text);
+		StringId(const std::string& text) : StringId(std::string_view(text)) {}
+
+		// The id of a text without interning it (see _sid)
+		static constexpr StringId FromHash(uint32_t hash)
+		{
+			StringId id;
+			id.m_Value = hash;
+			return id;
+		}
+
+		constexpr uint32_t GetValue() const { return m_Value; }
+		constexpr bool IsValid() const { return m_Value != 0; }
+
+		// The interned text; "" for the invalid id or one never interned.
+		// Valid for the life of the program.
+		const char* c_str() const;
+		std::string_view GetText() const { return c_str(); }
+
+		friend constexpr bool operator==(StringId a, StringId b) { return a.m_Value == b.m_Value; }
+		friend constexpr bool operator!=(StringId a, StringId b) { return a.m_Value != b.m_Value; }
+		friend constexpr bool operator<(StringId a, StringId b) { return a.m_Value < b.m_Value; }
+
+	private:
+		uint32_t m_Value = 0;
+	};
+
+	// Texts interned so far
+	size_t GetInternedStringCount();
+
+	inline namespace StringIdLiterals
+	{
+		consteval StringId operator""_sid(const char* text, size_t length)
+		{
+			return StringId::FromHash(HashString(std::string_view(text, length)));
+		}
+	}
+}
+
+template<>
+struct std::hash<Nightbloom::StringId>
+{
+	size_t operator()(Nightbloom::StringId id) const noexcept { return id.GetValue(); }
+};
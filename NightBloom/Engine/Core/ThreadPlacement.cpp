@@ -0,0 +1,378 @@
+//------------------------------------------------------------------------------
+// ThreadPlacement.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/ThreadPlacement.hpp"
+#include "Engine/Core/Platform.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#ifndef NIGHTBLOOM_PLATFORM_WINDOWS
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Nightbloom
+{
+	namespace
+	{
+		std::mutex s_SettingsMutex;
+		ThreadPlacementSettings s_Settings;
+
+		std::string Trim(const std::string& text)
+		{
+			const size_t begin = text.find_first_not_of(" \t");
+			if (begin == std::string::npos)
+				return "";
+			const size_t end = text.find_last_not_of(" \t");
+			return text.substr(begin, end - begin + 1);
+		}
+
+		std::string ToLower(std::string text)
+		{
+			std::transform(text.begin(), text.end(), text.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return text;
+		}
+
+		bool ParseRole(const std::string& name, ThreadRole& role)
+		{
+			if (name == "frame" || name == "framecritical") role = ThreadRole::FrameCritical;
+			else if (name == "worker") role = ThreadRole::Worker;
+			else if (name == "background") role = ThreadRole::Background;
+			else return false;
+			return true;
+		}
+
+		bool ParseCores(const std::string& name, CoreSet& cores)
+		{
+			if (name == "any") cores = CoreSet::Any;
+			else if (name == "performance" || name == "p") cores = CoreSet::Performance;
+			else if (name == "efficiency" || name == "e") cores = CoreSet::Efficiency;
+			else return false;
+			return true;
+		}
+
+		bool ParsePriority(const std::string& name, ThreadPriority& priority)
+		{
+			if (name == "low") priority = ThreadPriority::Low;
+			else if (name == "normal") priority = ThreadPriority::Normal;
+			else if (name == "high") priority = ThreadPriority::High;
+			else return false;
+			return true;
+		}
+
+#ifndef NIGHTBLOOM_PLATFORM_WINDOWS
+		bool ReadFirstLine(const std::string& path, std::string& line)
+		{
+			std::ifstream file(path);
+			return file && std::getline(file, line);
+		}
+#endif
+	}
+
+	// =========================================================================
+	// CpuTopology
+	// =========================================================================
+
+	bool CpuTopology::IsHybrid() const
+	{
+		for (const Processor& processor : processors)
+		{
+			if (processor.efficiencyClass != processors.front().efficiencyClass)
+				return true;
+		}
+		return false;
+	}
+
+	std::vector<uint32_t> CpuTopology::Select(CoreSet cores) const
+	{
+		std::vector<uint32_t> ids;
+		if (cores == CoreSet::Any || !IsHybrid())
+			return ids;
+
+		const auto [slowest, fastest] = std::minmax_element(processors.begin(), processors.end(),
+			[](const Processor& a, const Processor& b) { return a.efficiencyClass < b.efficiencyClass; });
+		const uint8_t wanted = cores == CoreSet::Performance ? fastest->efficiencyClass : slowest->efficiencyClass;
+		for (const Processor& processor : processors)
+		{
+			if (processor.efficiencyClass == wanted)
+				ids.push_back(processor.id);
+		}
+		return ids;
+	}
+
+	uint32_t CpuTopology::Count(CoreSet cores) const
+	{
+		const std::vector<uint32_t> selected = Select(cores);
+		return static_cast<uint32_t>(selected.empty() ? processors.size() : selected.size());
+	}
+
+	const CpuTopology& CpuTopology::Get()
+	{
+		static const CpuTopology topology = Detect();
+		return topology;
+	}
+
+	CpuTopology CpuTopology::Detect()
+	{
+		CpuTopology topology;
+
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+		ULONG length = 0;
+		GetSystemCpuSetInformation(nullptr, 0, &length, GetCurrentProcess(), 0);
+		std::vector<uint8_t> buffer(length);
+		if (length > 0 && GetSystemCpuSetInformation(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(buffer.data()),
+			length, &length, GetCurrentProcess(), 0))
+		{
+			for (ULONG offset = 0; offset < length;)
+			{
+				const auto* info = reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(buffer.data() + offset);
+				if (info->Type == CpuSetInformation)
+				{
+					Processor processor;
+					processor.index = info->CpuSet.Group * 64u + info->CpuSet.LogicalProcessorIndex;
+					processor.id = info->CpuSet.Id;
+					processor.efficiencyClass = info->CpuSet.EfficiencyClass;
+					topology.processors.push_back(processor);
+				}
+				offset += info->Size;
+			}
+		}
+#else
+		std::vector<uint32_t> online;
+		std::string line;
+		if (!ReadFirstLine("/sys/devices/system/cpu/online", line) || !ParseCpuList(line, online))
+		{
+			online.clear();
+			for (uint32_t i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+				online.push_back(i);
+		}
+		for (uint32_t index : online)
+			topology.processors.push_back({ index, index, 0 });
+
+		// Intel hybrid parts list their P-cores under cpu_core (E-cores under
+		// cpu_atom); others rank cores by capacity
+		std::vector<uint32_t> performance;
+		if (ReadFirstLine("/sys/devices/cpu_core/cpus", line) && ParseCpuList(line, performance))
+		{
+			for (Processor& processor : topology.processors)
+				processor.efficiencyClass = std::find(performance.begin(), performance.end(), processor.index) != performance.end() ? 1 : 0;
+		}
+		else
+		{
+			std::vector<long> capacities;
+			for (const Processor& processor : topology.processors)
+			{
+				if (!ReadFirstLine(std::format("/sys/devices/system/cpu/cpu{}/cpu_capacity", processor.index), line))
+					break;
+				capacities.push_back(std::strtol(line.c_str(), nullptr, 10));
+			}
+			if (capacities.size() == topology.processors.size())
+			{
+				std::vector<long> ranks = capacities;
+				std::sort(ranks.begin(), ranks.end());
+				ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+				for (size_t i = 0; i < capacities.size(); ++i)
+					topology.processors[i].efficiencyClass = static_cast<uint8_t>(
+						std::lower_bound(ranks.begin(), ranks.end(), capacities[i]) - ranks.begin());
+			}
+		}
+#endif
+
+		if (topology.processors.empty())
+		{
+			for (uint32_t i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+				topology.processors.push_back({ i, i, 0 });
+		}
+		return topology;
+	}
+
+	bool CpuTopology::ParseCpuList(const std::string& text, std::vector<uint32_t>& out)
+	{
+		std::vector<uint32_t> indices;
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t comma = text.find(',', start);
+			if (comma == std::string::npos)
+				comma = text.size();
+			const std::string range = Trim(text.substr(start, comma - start));
+			start = comma + 1;
+			if (range.empty())
+			{
+				if (comma == text.size())
+					break;
+				return false;
+			}
+
+			const size_t dash = range.find('-');
+			char* end = nullptr;
+			const unsigned long first = std::strtoul(range.c_str(), &end, 10);
+			if (end == range.c_str() || (dash == std::string::npos ? *end != '\0' : end != range.c_str() + dash))
+				return false;
+			unsigned long last = first;
+			if (dash != std::string::npos)
+			{
+				const char* lastText = range.c_str() + dash + 1;
+				last = std::strtoul(lastText, &end, 10);
+				if (end == lastText || *end != '\0' || last < first)
+					return false;
+			}
+			for (unsigned long i = first; i <= last; ++i)
+				indices.push_back(static_cast<uint32_t>(i));
+		}
+
+		if (indices.empty())
+			return false;
+		out = std::move(indices);
+		return true;
+	}
+
+	// =========================================================================
+	// ThreadPlacement
+	// =========================================================================
+
+	void ThreadPlacement::Configure(const ThreadPlacementSettings& settings)
+	{
+		std::lock_guard<std::mutex> lock(s_SettingsMutex);
+		s_Settings = settings;
+	}
+
+	ThreadPlacementSettings ThreadPlacement::GetSettings()
+	{
+		std::lock_guard<std::mutex> lock(s_SettingsMutex);
+		return s_Settings;
+	}
+
+	bool ThreadPlacement::Apply(ThreadRole role)
+	{
+		const ThreadPlacementSettings settings = GetSettings();
+		if (!settings.enabled)
+			return true;
+
+		const ThreadPlacementRule& rule = settings.GetRule(role);
+		const std::vector<uint32_t> ids = CpuTopology::Get().Select(rule.cores);
+		bool placed = true;
+
+#ifdef NIGHTBLOOM_PLATFORM_WINDOWS
+		if (!ids.empty())
+		{
+			std::vector<ULONG> cpuSets(ids.begin(), ids.end());
+			placed = SetThreadSelectedCpuSets(GetCurrentThread(), cpuSets.data(), static_cast<ULONG>(cpuSets.size())) != FALSE;
+		}
+
+		int priority = THREAD_PRIORITY_NORMAL;
+		if (rule.priority == ThreadPriority::Low) priority = THREAD_PRIORITY_BELOW_NORMAL;
+		else if (rule.priority == ThreadPriority::High) priority = THREAD_PRIORITY_ABOVE_NORMAL;
+		placed = SetThreadPriority(GetCurrentThread(), priority) != FALSE && placed;
+#else
+		if (!ids.empty())
+		{
+			cpu_set_t mask;
+			CPU_ZERO(&mask);
+			for (uint32_t id : ids)
+			{
+				if (id < CPU_SETSIZE)
+					CPU_SET(id, &mask);
+			}
+			placed = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+		}
+
+		// Nice values are per thread on Linux. Going below 0 needs
+		// CAP_SYS_NICE; without it the thread just stays at normal.
+		const pid_t thread = static_cast<pid_t>(syscall(SYS_gettid));
+		if (rule.priority == ThreadPriority::Low)
+			placed = setpriority(PRIO_PROCESS, static_cast<id_t>(thread), 10) == 0 && placed;
+		else if (rule.priority == ThreadPriority::High)
+			setpriority(PRIO_PROCESS, static_cast<id_t>(thread), -5);
+#endif
+		return placed;
+	}
+
+	uint32_t ThreadPlacement::GetDefaultWorkerCount()
+	{
+		const ThreadPlacementSettings settings = GetSettings();
+		const CpuTopology& topology = CpuTopology::Get();
+		const uint32_t processors = settings.enabled
+			? topology.Count(settings.GetRule(ThreadRole::Worker).cores)
+			: static_cast<uint32_t>(topology.processors.size());
+		return std::max(processors, 2u) - 1;
+	}
+
+	bool ThreadPlacement::ParseSettings(const std::string& text, ThreadPlacementSettings& settings)
+	{
+		const std::string lowered = ToLower(Trim(text));
+		if (lowered.empty())
+			return true;
+
+		ThreadPlacementSettings parsed = settings;
+		if (lowered == "off" || lowered == "0" || lowered == "false")
+		{
+			parsed.enabled = false;
+			settings = parsed;
+			return true;
+		}
+		parsed.enabled = true;
+		if (lowered == "on" || lowered == "1" || lowered == "true")
+		{
+			settings = parsed;
+			return true;
+		}
+
+		// role=cores[:priority], comma separated
+		size_t start = 0;
+		while (start < lowered.size())
+		{
+			size_t comma = lowered.find(',', start);
+			if (comma == std::string::npos)
+				comma = lowered.size();
+			const std::string part = Trim(lowered.substr(start, comma - start));
+			start = comma + 1;
+
+			const size_t equals = part.find('=');
+			if (equals == std::string::npos)
+				return false;
+			ThreadRole role;
+			if (!ParseRole(Trim(part.substr(0, equals)), role))
+				return false;
+
+			ThreadPlacementRule& rule = parsed.rules[static_cast<size_t>(role)];
+			const std::string value = Trim(part.substr(equals + 1));
+			const size_t colon = value.find(':');
+			if (!ParseCores(Trim(value.substr(0, colon)), rule.cores))
+				return false;
+			if (colon != std::string::npos && !ParsePriority(Trim(value.substr(colon + 1)), rule.priority))
+				return false;
+		}
+
+		settings = parsed;
+		return true;
+	}
+
+	bool ThreadPlacement::SettingsFromEnvironment(ThreadPlacementSettings& settings)
+	{
+		const char* value = std::getenv("NIGHTBLOOM_THREAD_PLACEMENT");
+		return !value || ParseSettings(value, settings);
+	}
+
+	std::string ThreadPlacement::Describe()
+	{
+		const CpuTopology& topology = CpuTopology::Get();
+		const bool enabled = GetSettings().enabled;
+		if (!topology.IsHybrid())
+			return std::format("{} processors, one kind of core{}", topology.processors.size(),
+				enabled ? " (priorities only)" : ", placement off");
+
+		return std::format("{} performance + {} efficiency processors, placement {}",
+			topology.Count(CoreSet::Performance), topology.Count(CoreSet::Efficiency), enabled ? "on" : "off");
+	}
+}
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+// ThreadPlacement.hpp
+//
+// Where the engine's threads run on hybrid CPUs (performance plus
+// efficiency cores). Each thread names its role once, at the top of its
+// loop, and is pinned to a core set at a priority the settings give that
+// role:
+//
+//   FrameCritical  the main thread (simulation, recording, submit), the
+//                  command recording workers and the window/input threads:
+//                  performance cores, above normal priority
+//   Worker         JobSystem workers, which run the frame's parallel work:
+//                  performance cores, normal priority
+//   Background     asset decode, thumbnails, capture writers, the asset
+//                  index, metrics export and the log writer: efficiency
+//                  cores, below normal priority
+//
+// so a burst of loading can't push frame work onto slow cores. On a CPU with
+// one kind of core nothing is pinned and only priorities apply. Windows
+// pins through CPU sets (SetThreadSelectedCpuSets), which the scheduler
+// treats as a strong preference rather than a hard mask; Linux through the
+// thread's affinity, with Intel hybrid parts read from sysfs (cpu_core /
+// cpu_atom) and others from cpu_capacity. Raising priority on Linux needs
+// privileges and is skipped quietly without them.
+//
+// EngineInit reads NIGHTBLOOM_THREAD_PLACEMENT before any thread starts:
+// "off", or rules such as "background=any:normal,worker=performance:normal".
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class ThreadRole : uint8_t
+	{
+		FrameCritical,
+		Worker,
+		Background,
+		Count
+	};
+
+	enum class CoreSet : uint8_t
+	{
+		Any,
+		Performance,
+		Efficiency
+	};
+
+	enum class ThreadPriority : uint8_t
+	{
+		Low,
+		Normal,
+		High
+	};
+
+	struct ThreadPlacementRule
+	{
+		CoreSet cores = CoreSet::Any;
+		ThreadPriority priority = ThreadPriority::Normal;
+	};
+
+	struct ThreadPlacementSettings
+	{
+		bool enabled = true;
+		std::array<ThreadPlacementRule, static_cast<size_t>(ThreadRole::Count)> rules = { {
+			{ CoreSet::Performance, ThreadPriority::High },     // FrameCritical
+			{ CoreSet::Performance, ThreadPriority::Normal },   // Worker
+			{ CoreSet::Efficiency,  ThreadPriority::Low },      // Background
+		} };
+
+		const ThreadPlacementRule& GetRule(ThreadRole role) const { return rules[static_cast<size_t>(role)]; }
+	};
+
+	struct CpuTopology
+	{
+		struct Processor
+		{
+			uint32_t index = 0;            // logical processor number
+			uint32_t id = 0;               // what pinning takes: the CPU set id on Windows, else the index
+			uint8_t efficiencyClass = 0;   // higher is faster; equal everywhere on a uniform CPU
+		};
+
+		std::vector<Processor> processors;
+
+		bool IsHybrid() const;
+		// Processors in the set; empty when the set doesn't restrict anything
+		// (Any, or a CPU with one kind of core)
+		std::vector<uint32_t> Select(CoreSet cores) const;
+		uint32_t Count(CoreSet cores) const;
+
+		// The machine's processors, read once
+		static const CpuTopology& Get();
+		static CpuTopology Detect();
+
+		// "0-3,8,10-11" (sysfs cpu lists) -> indices; false if malformed
+		static bool ParseCpuList(const std::string& text, std::vector<uint32_t>& out);
+	};
+
+	class ThreadPlacement
+	{
+	public:
+		// Call before starting threads; those already running keep their place
+		static void Configure(const ThreadPlacementSettings& settings);
+		static ThreadPlacementSettings GetSettings();
+
+		// Places the calling thread by its role's rule. False when the OS
+		// refused (the thread then runs wherever it was).
+		static bool Apply(ThreadRole role);
+
+		// Workers worth starting: one per processor the Worker rule allows,
+		// minus the calling thread, at least one
+		static uint32_t GetDefaultWorkerCount();
+
+		// Parses NIGHTBLOOM_THREAD_PLACEMENT-style text over `settings`;
+		// false (and `settings` untouched) if any part is malformed
+		static bool ParseSettings(const std::string& text, ThreadPlacementSettings& settings);
+		// False when the variable is set but malformed
+		static bool SettingsFromEnvironment(ThreadPlacementSettings& settings);
+
+		// "8 performance + 16 efficiency processors, placement on"
+		static std::string Describe();
+	};
+}
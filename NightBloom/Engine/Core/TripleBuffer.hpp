@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+// TripleBuffer.hpp
+//
+// Lock-free single-producer / single-consumer handoff of a large value. Three
+// slots: the producer owns one, the consumer owns one, and the third sits in
+// the middle holding the newest published value. Publish() and
+// AcquireLatest() just swap a slot with the middle one, so neither side ever
+// waits for the other or copies the value - a slow consumer only skips
+// stale values, and the producer always has a slot to write into.
+//
+// Slots are reused, which lets them keep their allocations (draw lists and
+// the like) from frame to frame.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	template <typename T>
+	class TripleBuffer
+	{
+	public:
+		TripleBuffer() = default;
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		// Producer side: the slot to fill next. Its previous contents are
+		// whatever was last handed back by a swap, so callers reset it first.
+		T& GetWriteSlot() { return m_Slots[m_WriteIndex]; }
+
+		// Producer side: make the write slot the newest value
+		void Publish()
+		{
+			const uint32_t previous = m_Middle.exchange(m_WriteIndex | kFreshBit, std::memory_order_acq_rel);
+			m_WriteIndex = previous & kIndexMask;
+		}
+
+		// Consumer side: take the newest published value if there is one the
+		// consumer hasn't seen yet. Returns false (read slot unchanged) if not.
+		bool AcquireLatest()
+		{
+			if ((m_Middle.load(std::memory_order_relaxed) & kFreshBit) == 0)
+				return false;
+
+			const uint32_t previous = m_Middle.exchange(m_ReadIndex, std::memory_order_acq_rel);
+			m_ReadIndex = previous & kIndexMask;
+			return true;
+		}
+
+		// Consumer side: the value last acquired
+		const T& GetReadSlot() const { return m_Slots[m_ReadIndex]; }
+		T& GetReadSlot() { return m_Slots[m_ReadIndex]; }
+
+	private:
+		static constexpr uint32_t kIndexMask = 0x3u;
+		static constexpr uint32_t kFreshBit = 0x4u;
+
+		std::array<T, 3> m_Slots{};
+		uint32_t m_WriteIndex = 0;                 // producer only
+		uint32_t m_ReadIndex = 1;                  // consumer only
+		std::atomic<uint32_t> m_Middle{ 2 };       // index | kFreshBit
+	};
+}
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+// WorldPartition.cpp
+//------------------------------------------------------------------------------
+
+#include "Core/WorldPartition.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	void WorldPartition::Reset(const WorldPartitionSettings& settings)
+	{
+		m_Settings = settings;
+		m_Settings.cellSize = std::max(m_Settings.cellSize, 1e-3f);
+		m_Cells.clear();
+		m_CellIndex.clear();
+		m_Frame = 0;
+		m_ResidentBytes = 0;
+		m_LoadedCount = 0;
+		m_LoadingCount = 0;
+		m_OverBudgetCount = 0;
+	}
+
+	void WorldPartition::SetSettings(const WorldPartitionSettings& settings)
+	{
+		const float cellSize = m_Settings.cellSize;
+		m_Settings = settings;
+		m_Settings.cellSize = cellSize;
+	}
+
+	WorldCellCoord WorldPartition::CellOf(const glm::vec3& position) const
+	{
+		return { static_cast<int32_t>(std::floor(position.x / m_Settings.cellSize)),
+			static_cast<int32_t>(std::floor(position.z / m_Settings.cellSize)) };
+	}
+
+	uint32_t WorldPartition::AddContent(const glm::vec3& position, uint64_t bytes)
+	{
+		const WorldCellCoord coord = CellOf(position);
+		auto [it, inserted] = m_CellIndex.try_emplace(Key(coord), static_cast<uint32_t>(m_Cells.size()));
+		if (inserted)
+			m_Cells.push_back({ coord });
+
+		Cell& cell = m_Cells[it->second];
+		cell.bytes += bytes;
+		if (cell.state != WorldCellState::Unloaded)
+			m_ResidentBytes += bytes;
+		return it->second;
+	}
+
+	uint32_t WorldPartition::FindCell(const WorldCellCoord& coord) const
+	{
+		const auto it = m_CellIndex.find(Key(coord));
+		return it == m_CellIndex.end() ? INVALID : it->second;
+	}
+
+	float WorldPartition::DistanceTo(const Cell& cell, const glm::vec2& point) const
+	{
+		const glm::vec2 cellMin = glm::vec2(cell.coord.x, cell.coord.z) * m_Settings.cellSize;
+		const glm::vec2 cellMax = cellMin + m_Settings.cellSize;
+		return glm::length(glm::clamp(point, cellMin, cellMax) - point);
+	}
+
+	void WorldPartition::SetState(Cell& cell, WorldCellState state)
+	{
+		if (cell.state == state)
+			return;
+
+		if (cell.state == WorldCellState::Loading) --m_LoadingCount;
+		if (cell.state == WorldCellState::Loaded) --m_LoadedCount;
+		if (cell.state == WorldCellState::Unloaded) m_ResidentBytes += cell.bytes;
+
+		if (state == WorldCellState::Loading) ++m_LoadingCount;
+		if (state == WorldCellState::Loaded) ++m_LoadedCount;
+		if (state == WorldCellState::Unloaded) m_ResidentBytes -= cell.bytes;
+
+		cell.state = state;
+	}
+
+	void WorldPartition::Update(const glm::vec3& cameraPosition, const glm::vec3& cameraVelocity,
+		std::vector<uint32_t>& loads, std::vector<uint32_t>& unloads)
+	{
+		loads.clear();
+		unloads.clear();
+		m_OverBudgetCount = 0;
+		++m_Frame;
+
+		const glm::vec2 camera(cameraPosition.x, cameraPosition.z);
+		const glm::vec2 prefetch = camera + glm::vec2(cameraVelocity.x, cameraVelocity.z) * m_Settings.prefetchSeconds;
+		const float loadRadius = m_Settings.loadRadius;
+		const float unloadRadius = std::max(m_Settings.unloadRadius, loadRadius);
+
+		m_Wanted.clear();
+		m_Distance.resize(m_Cells.size());
+		for (uint32_t i = 0; i < m_Cells.size(); ++i)
+		{
+			Cell& cell = m_Cells[i];
+			m_Distance[i] = DistanceTo(cell, camera);
+			const float distance = std::min(m_Distance[i], DistanceTo(cell, prefetch));
+
+			if (distance <= loadRadius)
+			{
+				cell.lastWanted = m_Frame;
+				if (cell.state == WorldCellState::Unloaded)
+					m_Wanted.push_back(i);
+			}
+			else if (distance > unloadRadius && cell.state != WorldCellState::Unloaded)
+			{
+				SetState(cell, WorldCellState::Unloaded);
+				unloads.push_back(i);
+			}
+		}
+
+		std::sort(m_Wanted.begin(), m_Wanted.end(),
+			[this](uint32_t a, uint32_t b) { return m_Distance[a] < m_Distance[b]; });
+
+		for (size_t i = 0; i < m_Wanted.size(); ++i)
+		{
+			if (m_LoadingCount >= m_Settings.maxLoadsInFlight)
+				break;
+
+			Cell& cell = m_Cells[m_Wanted[i]];
+			if (!MakeRoom(cell.bytes, unloads))
+			{
+				// Nearest first: a farther cell that would fit doesn't jump the queue
+				m_OverBudgetCount = static_cast<uint32_t>(m_Wanted.size() - i);
+				break;
+			}
+
+			SetState(cell, WorldCellState::Loading);
+			loads.push_back(m_Wanted[i]);
+		}
+	}
+
+	bool WorldPartition::MakeRoom(uint64_t bytes, std::vector<uint32_t>& unloads)
+	{
+		const uint64_t budget = m_Settings.memoryBudget;
+		if (m_ResidentBytes + bytes <= budget)
+			return true;
+
+		m_Evictable.clear();
+		uint64_t evictable = 0;
+		for (uint32_t i = 0; i < m_Cells.size(); ++i)
+		{
+			const Cell& cell = m_Cells[i];
+			if (cell.state == WorldCellState::Loaded && cell.lastWanted < m_Frame)
+			{
+				m_Evictable.push_back(i);
+				evictable += cell.bytes;
+			}
+		}
+
+		// Evicting only pays off if it makes the whole load fit
+		if (m_ResidentBytes - evictable + bytes > budget)
+			return false;
+
+		std::sort(m_Evictable.begin(), m_Evictable.end(),
+			[this](uint32_t a, uint32_t b)
+			{
+				if (m_Cells[a].lastWanted != m_Cells[b].lastWanted)
+					return m_Cells[a].lastWanted < m_Cells[b].lastWanted;
+				return m_Distance[a] > m_Distance[b];
+			});
+
+		for (uint32_t index : m_Evictable)
+		{
+			if (m_ResidentBytes + bytes <= budget)
+				break;
+			SetState(m_Cells[index], WorldCellState::Unloaded);
+			unloads.push_back(index);
+		}
+		return true;
+	}
+
+	void WorldPartition::MarkLoaded(uint32_t cell)
+	{
+		if (cell < m_Cells.size() && m_Cells[cell].state == WorldCellState::Loading)
+			SetState(m_Cells[cell], WorldCellState::Loaded);
+	}
+
+	void WorldPartition::UnloadAll(std::vector<uint32_t>& unloads)
+	{
+		unloads.clear();
+		for (uint32_t i = 0; i < m_Cells.size(); ++i)
+		{
+			if (m_Cells[i].state == WorldCellState::Unloaded)
+				continue;
+			SetState(m_Cells[i], WorldCellState::Unloaded);
+			unloads.push_back(i);
+		}
+	}
+}
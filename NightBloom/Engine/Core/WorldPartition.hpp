@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+// WorldPartition.hpp
+//
+// Streaming policy for large levels: the ground plane (XZ) is cut into square
+// cells of cellSize world units, content is registered with the cell it
+// belongs to along with an estimate of the memory it takes once loaded, and
+// Update decides each frame which cells to load and which to drop. What
+// loading and dropping a cell means is the caller's business (SceneStreamer
+// adds and removes scene objects); this only tracks state and bytes.
+//
+// A cell is wanted while its square comes within loadRadius of the camera,
+// or of the prefetch point the camera reaches in prefetchSeconds at its
+// current velocity, so cells ahead of a moving camera start loading before
+// it gets there. A loaded cell is dropped once it is beyond unloadRadius of
+// both (the gap stops a camera on a cell border from thrashing it).
+//
+// Loads are issued nearest to the camera first, at most maxLoadsInFlight at
+// a time, and only while the bytes of loaded and loading cells stay within
+// memoryBudget: to make room, loaded cells that are no longer wanted go
+// first, least recently wanted first. Wanted cells are never evicted, so a
+// budget too small for the load radius leaves the farthest wanted cells
+// unloaded rather than cycling.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct WorldCellCoord
+	{
+		int32_t x = 0;
+		int32_t z = 0;
+
+		bool operator==(const WorldCellCoord&) const = default;
+	};
+
+	struct WorldPartitionSettings
+	{
+		float cellSize = 128.0f;
+		float loadRadius = 384.0f;
+		float unloadRadius = 512.0f;        // clamped to at least loadRadius
+		float prefetchSeconds = 2.0f;       // 0 disables prefetch
+		uint64_t memoryBudget = 1024ull << 20;
+		uint32_t maxLoadsInFlight = 4;
+	};
+
+	enum class WorldCellState : uint8_t
+	{
+		Unloaded,
+		Loading,
+		Loaded
+	};
+
+	class WorldPartition
+	{
+	public:
+		static constexpr uint32_t INVALID = UINT32_MAX;
+
+		WorldPartition() = default;
+		explicit WorldPartition(const WorldPartitionSettings& settings) { Reset(settings); }
+
+		// Forgets every cell
+		void Reset(const WorldPartitionSettings& settings);
+
+		// Settings take effect on the next Update; the cell size only through Reset
+		void SetSettings(const WorldPartitionSettings& settings);
+		const WorldPartitionSettings& GetSettings() const { return m_Settings; }
+
+		WorldCellCoord CellOf(const glm::vec3& position) const;
+
+		// Registers content of `bytes` in the cell holding `position` (created
+		// Unloaded on first use) and returns the cell's index. Indices are
+		// dense and stable until Reset.
+		uint32_t AddContent(const glm::vec3& position, uint64_t bytes);
+
+		// INVALID if nothing was registered there
+		uint32_t FindCell(const WorldCellCoord& coord) const;
+
+		// Decides this frame's work. Every cell in `loads` is now Loading and
+		// counts against the budget: the caller starts loading it and reports
+		// back with MarkLoaded. Every cell in `unloads` (Loaded, or Loading
+		// when the camera moved away before it finished) is now Unloaded: the
+		// caller drops its content or cancels its load. Loads are nearest
+		// first.
+		void Update(const glm::vec3& cameraPosition, const glm::vec3& cameraVelocity,
+			std::vector<uint32_t>& loads, std::vector<uint32_t>& unloads);
+
+		// A Loading cell finished; ignored for any other state
+		void MarkLoaded(uint32_t cell);
+
+		// Unloads every cell that isn't already (returned in `unloads`)
+		void UnloadAll(std::vector<uint32_t>& unloads);
+
+		size_t GetCellCount() const { return m_Cells.size(); }
+		WorldCellCoord GetCoord(uint32_t cell) const { return m_Cells[cell].coord; }
+		WorldCellState GetState(uint32_t cell) const { return m_Cells[cell].state; }
+		uint64_t GetBytes(uint32_t cell) const { return m_Cells[cell].bytes; }
+
+		// Loaded and Loading cells' bytes
+		uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+		uint32_t GetLoadedCount() const { return m_LoadedCount; }
+		uint32_t GetLoadingCount() const { return m_LoadingCount; }
+
+		// Wanted cells the last Update couldn't load within the budget
+		uint32_t GetOverBudgetCount() const { return m_OverBudgetCount; }
+
+	private:
+		struct Cell
+		{
+			WorldCellCoord coord;
+			uint64_t bytes = 0;
+			uint64_t lastWanted = 0;     // Update frame the cell was last wanted in
+			WorldCellState state = WorldCellState::Unloaded;
+		};
+
+		static uint64_t Key(const WorldCellCoord& coord)
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.z);
+		}
+
+		// Distance in XZ from `point` to the cell's square (0 inside it)
+		float DistanceTo(const Cell& cell, const glm::vec2& point) const;
+
+		void SetState(Cell& cell, WorldCellState state);
+
+		// Unloads not-wanted Loaded cells, least recently wanted first, until
+		// `bytes` more fit the budget. False if they can't be made to fit.
+		bool MakeRoom(uint64_t bytes, std::vector<uint32_t>& unloads);
+
+		WorldPartitionSettings m_Settings;
+		std::vector<Cell> m_Cells;
+		std::unordered_map<uint64_t, uint32_t> m_CellIndex;
+		uint64_t m_Frame = 0;
+
+		uint64_t m_ResidentBytes = 0;
+		uint32_t m_LoadedCount = 0;
+		uint32_t m_LoadingCount = 0;
+		uint32_t m_OverBudgetCount = 0;
+
+		// Update scratch
+		std::vector<uint32_t> m_Wanted;
+		std::vector<float> m_Distance;
+		std::vector<uint32_t> m_Evictable;
+	};
+}
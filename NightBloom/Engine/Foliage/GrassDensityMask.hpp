@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+// GrassDensityMask.hpp
+//
+// A painted multiplier on the grass density noise, over the terrain square in
+// heightmap uv (0..1 on both axes). 1 leaves the noise as it is, 0 clears the
+// ground; GrassScatter multiplies each candidate's noise sample by it before
+// the threshold test. An unpainted mask holds no texels and costs nothing.
+//
+// Paint returns the uv rect it changed, so GrassSystem only re-scatters the
+// patches under the brush.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Terrain/TerrainBrush.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class GrassDensityMask
+	{
+	public:
+		static constexpr uint32_t DEFAULT_RESOLUTION = 512;
+
+		// Every texel back to 1 at `resolution` per side
+		void Reset(uint32_t resolution = DEFAULT_RESOLUTION)
+		{
+			m_Resolution = std::max(resolution, 2u);
+			m_Values.assign(static_cast<size_t>(m_Resolution) * m_Resolution, 1.0f);
+		}
+
+		// Back to unpainted
+		void Clear()
+		{
+			m_Values.clear();
+			m_Resolution = 0;
+		}
+
+		bool IsEmpty() const { return m_Values.empty(); }
+		uint32_t GetResolution() const { return m_Resolution; }
+
+		// Bilinear, clamped to the edge; 1 when unpainted
+		float Sample(const glm::vec2& uv) const
+		{
+			if (m_Values.empty())
+				return 1.0f;
+
+			const float size = static_cast<float>(m_Resolution);
+			const glm::vec2 t = glm::clamp(uv * size - 0.5f, glm::vec2(0.0f), glm::vec2(size - 1.0f));
+			const int32_t x0 = static_cast<int32_t>(t.x);
+			const int32_t y0 = static_cast<int32_t>(t.y);
+			const int32_t x1 = std::min(x0 + 1, static_cast<int32_t>(m_Resolution) - 1);
+			const int32_t y1 = std::min(y0 + 1, static_cast<int32_t>(m_Resolution) - 1);
+			const float fx = t.x - static_cast<float>(x0);
+			const float fy = t.y - static_cast<float>(y0);
+
+			const float top = At(x0, y0) + (At(x1, y0) - At(x0, y0)) * fx;
+			const float bottom = At(x0, y1) + (At(x1, y1) - At(x0, y1)) * fx;
+			return top + (bottom - top) * fy;
+		}
+
+		// Moves the texels under a round brush (uv centre and radius, falloff as
+		// TerrainBrush's) `amount * weight` of the way to `target`. Resets an
+		// unpainted mask first. Returns false if no texel changed; otherwise
+		// outMin/outMax bound, in uv, everywhere Sample can now return
+		// something different.
+		bool Paint(const glm::vec2& uv, float uvRadius, float falloff, float target, float amount,
+			glm::vec2& outMin, glm::vec2& outMax)
+		{
+			if (uvRadius <= 0.0f || amount <= 0.0f)
+				return false;
+			if (m_Values.empty())
+				Reset();
+
+			const float size = static_cast<float>(m_Resolution);
+			const float radius = uvRadius * size;   // in texels
+			const glm::vec2 center = uv * size;
+			const int32_t x0 = std::max(static_cast<int32_t>(std::ceil(center.x - radius - 0.5f)), 0);
+			const int32_t y0 = std::max(static_cast<int32_t>(std::ceil(center.y - radius - 0.5f)), 0);
+			const int32_t x1 = std::min(static_cast<int32_t>(std::floor(center.x + radius - 0.5f)), static_cast<int32_t>(m_Resolution) - 1);
+			const int32_t y1 = std::min(static_cast<int32_t>(std::floor(center.y + radius - 0.5f)), static_cast<int32_t>(m_Resolution) - 1);
+
+			target = std::clamp(target, 0.0f, 1.0f);
+			bool changed = false;
+			for (int32_t y = y0; y <= y1; ++y)
+			{
+				for (int32_t x = x0; x <= x1; ++x)
+				{
+					const glm::vec2 offset = glm::vec2(static_cast<float>(x), static_cast<float>(y)) + 0.5f - center;
+					const float weight = TerrainBrushWeight(glm::length(offset), radius, falloff);
+					if (weight <= 0.0f)
+						continue;
+
+					float& value = At(x, y);
+					const float painted = value + (target - value) * std::min(amount * weight, 1.0f);
+					if (painted != value)
+					{
+						value = painted;
+						changed = true;
+					}
+				}
+			}
+			if (!changed)
+				return false;
+
+			// Sample blends a texel into everything within one texel of its centre
+			outMin = glm::vec2(static_cast<float>(x0 - 1), static_cast<float>(y0 - 1)) / size;
+			outMax = glm::vec2(static_cast<float>(x1 + 2), static_cast<float>(y1 + 2)) / size;
+			return true;
+		}
+
+	private:
+		float At(int32_t x, int32_t y) const { return m_Values[static_cast<size_t>(y) * m_Resolution + x]; }
+		float& At(int32_t x, int32_t y) { return m_Values[static_cast<size_t>(y) * m_Resolution + x]; }
+
+		std::vector<float> m_Values;
+		uint32_t m_Resolution = 0;
+	};
+}
@@ -0,0 +1,401 @@
+//------------------------------------------------------------------------------
+// GrassScatter.hpp
+//
+// CPU grass placement (GrassSystem's fallback when GrassGenerate.comp can't
+// run). The terrain square is split into patches; each patch scatters a
+// jittered candidate grid, keeps the candidates whose density noise clears
+// the threshold and sorts them by a random priority (see GrassSystem.hpp's
+// header comment for why).
+//
+// Every patch draws from its own std::mt19937 seeded from GrassDesc::seed and
+// the patch coordinates, so patches are independent: they are scattered on
+// all cores into per-worker buffers, then merged in patch order by a prefix
+// sum over their counts. The thread count never changes the result - one
+// thread and sixteen produce bit-identical instance and patch arrays.
+//
+// Blades are stored packed, 16 bytes each (GrassInstance): positions are
+// 24-bit fixed point across the terrain square, the rest 8 or 16 bits.
+//
+// That independence also lets GrassSystem re-scatter single patches
+// (ScatterPatchInstances) when a painted density mask changes under them:
+// a patch comes out exactly as a full Generate would have made it.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Foliage/GrassDensityMask.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Uploaded as-is to the patch buffer GrassCull.comp reads, so the field
+	// order matches its std430 struct (vec3 + uint pairs, 32 bytes).
+	struct GrassPatch
+	{
+		glm::vec3 center;
+		uint32_t  fullCount;   // total blades in this patch (priority-sorted)
+		glm::vec3 extents;
+		uint32_t  firstInstance;
+	};
+	static_assert(sizeof(GrassPatch) == 32, "GrassPatch must match GrassCull.comp's layout");
+
+	// One blade of the instance buffer, 16 bytes. GrassScatter::PackBlade
+	// writes it, GrassGenerate.comp packs and Grass.vert unpacks the same:
+	//   x = world x as 24-bit unorm across the terrain square | rotation, 8 bits of a turn
+	//   y = world z as 24-bit unorm                            | tint, 8-bit unorm over 0.5..1.5
+	//   z = scale as a half float | wind phase, 8 bits of a turn | unused
+	//   w = patch index (Grass.vert's GPU-culled LOD lookup)
+	// 24 bits keep a 2 km terrain at ~0.1 mm; no patch-relative origin is
+	// needed, so the vertex shader decodes with the terrain bounds it has.
+	using GrassInstance = glm::uvec4;
+	static_assert(sizeof(GrassInstance) == 16, "GrassInstance must match Grass.vert's layout");
+
+	// A blade before packing / after unpacking
+	struct GrassBlade
+	{
+		glm::vec2 worldXZ = glm::vec2(0.0f);
+		float     rotY = 0.0f;       // radians
+		float     scale = 0.0f;      // blade height, world units
+		float     tint = 1.0f;       // 1 +/- colorVariation, kept to 0.5..1.5
+		float     windPhase = 0.0f;  // radians
+		uint32_t  patchIndex = 0;
+	};
+
+	// The GrassDesc fields placement depends on
+	struct GrassScatterSettings
+	{
+		float     terrainWorldSize = 200.0f;
+		float     terrainHeightScale = 30.0f;
+		glm::vec3 terrainPosition = glm::vec3(0.0f);
+		float     patchSize = 25.0f;
+		float     candidateSpacing = 0.4f;
+		float     densityThreshold = 0.42f;
+		float     densityFrequency = 0.06f;
+		uint32_t  densityOctaves = 2;
+		float     bladeHeight = 0.6f;
+		float     heightJitter = 0.3f;
+		float     colorVariation = 0.15f;
+		uint32_t  seed = 1337;
+		const GrassDensityMask* densityMask = nullptr;   // not owned; null or empty = unpainted
+	};
+
+	class GrassScatter
+	{
+	public:
+		// Lightweight value-noise (not true Perlin — a hashed lattice
+		// bilinearly interpolated with a smoothstep easing curve). Good
+		// enough for a placement density field; doesn't need gradient
+		// continuity the way a real height/normal map would.
+		// grass_field.glsl carries a port of these three.
+		static float Hash2D(int x, int y, uint32_t seed)
+		{
+			uint32_t h = static_cast<uint32_t>(x) * 374761393u
+				+ static_cast<uint32_t>(y) * 668265263u
+				+ seed * 2147483647u;
+			h = (h ^ (h >> 13)) * 1274126177u;
+			h ^= (h >> 16);
+			return static_cast<float>(h & 0xFFFFFFu) / static_cast<float>(0xFFFFFFu);
+		}
+
+		static float SmoothNoise2D(float x, float y, uint32_t seed)
+		{
+			int x0 = static_cast<int>(std::floor(x));
+			int y0 = static_cast<int>(std::floor(y));
+			float tx = x - static_cast<float>(x0);
+			float ty = y - static_cast<float>(y0);
+			float sx = tx * tx * (3.0f - 2.0f * tx);
+			float sy = ty * ty * (3.0f - 2.0f * ty);
+
+			float n00 = Hash2D(x0, y0, seed);
+			float n10 = Hash2D(x0 + 1, y0, seed);
+			float n01 = Hash2D(x0, y0 + 1, seed);
+			float n11 = Hash2D(x0 + 1, y0 + 1, seed);
+
+			float nx0 = n00 + sx * (n10 - n00);
+			float nx1 = n01 + sx * (n11 - n01);
+			return nx0 + sy * (nx1 - nx0);
+		}
+
+		// Multi-octave sum, normalized back to 0..1.
+		static float Fbm2D(float x, float y, uint32_t seed, uint32_t octaves)
+		{
+			float value = 0.0f;
+			float amplitude = 0.5f;
+			float frequency = 1.0f;
+			float maxValue = 0.0f;
+			for (uint32_t i = 0; i < octaves; ++i)
+			{
+				value += SmoothNoise2D(x * frequency, y * frequency, seed + i * 101u) * amplitude;
+				maxValue += amplitude;
+				amplitude *= 0.5f;
+				frequency *= 2.0f;
+			}
+			return maxValue > 0.0f ? value / maxValue : 0.0f;
+		}
+
+		// Random stream seed of patch (px, pz)
+		static uint32_t PatchSeed(uint32_t seed, int px, int pz)
+		{
+			uint32_t h = seed ^ (static_cast<uint32_t>(px) * 0x9E3779B1u) ^ (static_cast<uint32_t>(pz) * 0x85EBCA77u);
+			h = (h ^ (h >> 16)) * 0x7FEB352Du;
+			h = (h ^ (h >> 15)) * 0x846CA68Bu;
+			return h ^ (h >> 16);
+		}
+
+		// Patches per side of the terrain square
+		static int PatchesPerSide(const GrassScatterSettings& settings)
+		{
+			return std::max(1, static_cast<int>(std::ceil(settings.terrainWorldSize / settings.patchSize)));
+		}
+
+		// The culling bounds of patch (px, pz), firstInstance and fullCount zero
+		static GrassPatch PatchBounds(const GrassScatterSettings& settings, int patchesPerSide, int px, int pz)
+		{
+			const float halfWorld = settings.terrainWorldSize * 0.5f;
+			const float actualPatchSize = settings.terrainWorldSize / static_cast<float>(patchesPerSide);
+			GrassPatch patch{};
+			patch.center = glm::vec3(
+				-halfWorld + (px + 0.5f) * actualPatchSize + settings.terrainPosition.x,
+				settings.terrainPosition.y + settings.terrainHeightScale * 0.5f,
+				-halfWorld + (pz + 0.5f) * actualPatchSize + settings.terrainPosition.z);
+			patch.extents = glm::vec3(
+				actualPatchSize * 0.5f,
+				settings.terrainHeightScale * 0.5f + settings.bladeHeight,
+				actualPatchSize * 0.5f);
+			return patch;
+		}
+
+		// Grid index (pz * patchesPerSide + px) of the patch centred at `center`
+		static int PatchCell(const GrassScatterSettings& settings, int patchesPerSide, const glm::vec3& center)
+		{
+			const float actualPatchSize = settings.terrainWorldSize / static_cast<float>(patchesPerSide);
+			const glm::vec2 local = glm::vec2(center.x - settings.terrainPosition.x, center.z - settings.terrainPosition.z)
+				+ settings.terrainWorldSize * 0.5f;
+			const int px = std::clamp(static_cast<int>(std::floor(local.x / actualPatchSize)), 0, patchesPerSide - 1);
+			const int pz = std::clamp(static_cast<int>(std::floor(local.y / actualPatchSize)), 0, patchesPerSide - 1);
+			return pz * patchesPerSide + px;
+		}
+
+		// Appends patch (px, pz)'s blades to `out`, packed and tagged with
+		// patchIndex, in the same order Generate gives them. Returns how many.
+		static uint32_t ScatterPatchInstances(const GrassScatterSettings& settings, int patchesPerSide, int px, int pz,
+			uint32_t patchIndex, std::vector<GrassInstance>& out)
+		{
+			std::vector<Candidate> candidates;
+			ScatterPatch(settings, patchesPerSide, px, pz, candidates);
+			out.reserve(out.size() + candidates.size());
+			for (Candidate& candidate : candidates)
+			{
+				candidate.blade.patchIndex = patchIndex;
+				out.push_back(PackBlade(candidate.blade, settings));
+			}
+			return static_cast<uint32_t>(candidates.size());
+		}
+
+		static GrassInstance PackBlade(const GrassBlade& blade, const GrassScatterSettings& settings)
+		{
+			const glm::vec2 unit = (blade.worldXZ - glm::vec2(settings.terrainPosition.x, settings.terrainPosition.z))
+				/ settings.terrainWorldSize + 0.5f;
+			return GrassInstance(
+				QuantizeUnorm(unit.x, 24) | (QuantizeTurn(blade.rotY) << 24),
+				QuantizeUnorm(unit.y, 24) | (QuantizeUnorm(blade.tint - 0.5f, 8) << 24),
+				static_cast<uint32_t>(glm::packHalf1x16(blade.scale)) | (QuantizeTurn(blade.windPhase) << 16),
+				blade.patchIndex);
+		}
+
+		static GrassBlade UnpackBlade(const GrassInstance& instance, const GrassScatterSettings& settings)
+		{
+			constexpr float kUnorm24 = 1.0f / 16777215.0f;
+			constexpr float kTurn = 6.2831853f / 256.0f;
+			GrassBlade blade;
+			blade.worldXZ = glm::vec2(settings.terrainPosition.x, settings.terrainPosition.z) + settings.terrainWorldSize *
+				(glm::vec2(static_cast<float>(instance.x & 0xFFFFFFu), static_cast<float>(instance.y & 0xFFFFFFu)) * kUnorm24 - 0.5f);
+			blade.rotY = static_cast<float>(instance.x >> 24) * kTurn;
+			blade.tint = 0.5f + static_cast<float>(instance.y >> 24) / 255.0f;
+			blade.scale = glm::unpackHalf1x16(static_cast<glm::uint16>(instance.z & 0xFFFFu));
+			blade.windPhase = static_cast<float>((instance.z >> 16) & 0xFFu) * kTurn;
+			blade.patchIndex = instance.w;
+			return blade;
+		}
+
+		// Replaces `instances` (one GrassInstance per blade) and
+		// `patches` (non-empty patches only, in grid order). At most
+		// maxInstances blades are kept: patches past the budget are cut
+		// short or dropped. threadCount 0 uses every hardware thread.
+		// Returns false if the budget truncated anything.
+		static bool Generate(const GrassScatterSettings& settings, uint32_t maxInstances, uint32_t threadCount,
+			std::vector<GrassInstance>& instances, std::vector<GrassPatch>& patches)
+		{
+			instances.clear();
+			patches.clear();
+
+			const int patchesPerSide = PatchesPerSide(settings);
+			const uint32_t patchCount = static_cast<uint32_t>(patchesPerSide * patchesPerSide);
+
+			if (threadCount == 0)
+				threadCount = std::max(1u, std::thread::hardware_concurrency());
+			threadCount = std::min(threadCount, patchCount);
+
+			// Scatter: workers pull patch indices from a shared counter and
+			// append each patch's sorted candidates to their own buffer
+			std::vector<std::vector<Candidate>> workerCandidates(threadCount);
+			std::vector<PatchSpan> spans(patchCount);
+			std::atomic<uint32_t> nextPatch{ 0 };
+
+			auto work = [&](uint32_t worker)
+			{
+				std::vector<Candidate>& out = workerCandidates[worker];
+				for (uint32_t index = nextPatch.fetch_add(1); index < patchCount; index = nextPatch.fetch_add(1))
+				{
+					PatchSpan& span = spans[index];
+					span.worker = worker;
+					span.offset = static_cast<uint32_t>(out.size());
+					ScatterPatch(settings, patchesPerSide,
+						static_cast<int>(index) % patchesPerSide, static_cast<int>(index) / patchesPerSide, out);
+					span.count = static_cast<uint32_t>(out.size()) - span.offset;
+				}
+			};
+
+			std::vector<std::thread> threads;
+			threads.reserve(threadCount - 1);
+			for (uint32_t worker = 1; worker < threadCount; ++worker)
+				threads.emplace_back(work, worker);
+			work(0);
+			for (std::thread& thread : threads)
+				thread.join();
+
+			// Merge in patch order: a running sum gives each patch its range
+			uint32_t total = 0;
+			for (const PatchSpan& span : spans)
+				total += std::min(span.count, maxInstances - total);
+			instances.resize(total);
+
+			bool complete = true;
+			uint32_t first = 0;
+			for (uint32_t index = 0; index < patchCount; ++index)
+			{
+				const PatchSpan& span = spans[index];
+				const uint32_t count = std::min(span.count, maxInstances - first);
+				if (count < span.count)
+					complete = false;
+				if (count == 0)
+					continue;
+
+				// The patch index is the blade's index into the patch table
+				// (Grass.vert looks up the GPU-culled LOD params with it)
+				const uint32_t patchIndex = static_cast<uint32_t>(patches.size());
+				const Candidate* source = workerCandidates[span.worker].data() + span.offset;
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					GrassBlade blade = source[i].blade;
+					blade.patchIndex = patchIndex;
+					instances[first + i] = PackBlade(blade, settings);
+				}
+
+				const int px = static_cast<int>(index) % patchesPerSide;
+				const int pz = static_cast<int>(index) / patchesPerSide;
+				GrassPatch& patch = patches.emplace_back(PatchBounds(settings, patchesPerSide, px, pz));
+				patch.firstInstance = first;
+				patch.fullCount = count;
+				first += count;
+			}
+			return complete;
+		}
+
+	private:
+		struct Candidate { GrassBlade blade; float priority; };
+
+		static uint32_t QuantizeUnorm(float value, uint32_t bits)
+		{
+			const float maxValue = static_cast<float>((1u << bits) - 1u);
+			return static_cast<uint32_t>(glm::clamp(value, 0.0f, 1.0f) * maxValue + 0.5f);
+		}
+
+		// An angle in 1/256ths of a turn, wrapped
+		static uint32_t QuantizeTurn(float radians)
+		{
+			return static_cast<uint32_t>(static_cast<int32_t>(std::floor(radians / 6.2831853f * 256.0f + 0.5f))) & 0xFFu;
+		}
+
+		// Where a patch's candidates landed in the per-worker buffers
+		struct PatchSpan
+		{
+			uint32_t worker = 0;
+			uint32_t offset = 0;
+			uint32_t count = 0;
+		};
+
+		static void ScatterPatch(const GrassScatterSettings& settings, int patchesPerSide, int px, int pz,
+			std::vector<Candidate>& out)
+		{
+			std::mt19937 rng(PatchSeed(settings.seed, px, pz));
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+			const float kTwoPi = 6.2831853f;
+			const float halfWorld = settings.terrainWorldSize * 0.5f;
+			const float actualPatchSize = settings.terrainWorldSize / static_cast<float>(patchesPerSide);
+			const float spacing = std::max(settings.candidateSpacing, 0.05f);
+			const float cellMinX = -halfWorld + px * actualPatchSize;
+			const float cellMinZ = -halfWorld + pz * actualPatchSize;
+			const int candidatesPerSide = std::max(1, static_cast<int>(actualPatchSize / spacing));
+
+			const size_t begin = out.size();
+			for (int gz = 0; gz < candidatesPerSide; ++gz)
+			{
+				for (int gx = 0; gx < candidatesPerSide; ++gx)
+				{
+					// Jitter each candidate within its grid cell so the
+					// regular spacing doesn't read as a visible grid.
+					float jitterX = (unit(rng) * 2.0f - 1.0f) * spacing * 0.5f;
+					float jitterZ = (unit(rng) * 2.0f - 1.0f) * spacing * 0.5f;
+					float worldX = cellMinX + (gx + 0.5f) * spacing + jitterX + settings.terrainPosition.x;
+					float worldZ = cellMinZ + (gz + 0.5f) * spacing + jitterZ + settings.terrainPosition.z;
+
+					float density = Fbm2D(worldX * settings.densityFrequency, worldZ * settings.densityFrequency,
+						settings.seed, settings.densityOctaves);
+					if (settings.densityMask)
+						density *= settings.densityMask->Sample(
+							(glm::vec2(worldX - settings.terrainPosition.x, worldZ - settings.terrainPosition.z))
+							/ settings.terrainWorldSize + 0.5f);
+
+					if (density <= settings.densityThreshold)
+						continue;
+
+					float rotY = unit(rng) * kTwoPi;
+					float heightJitterFactor = 1.0f + (unit(rng) * 2.0f - 1.0f) * settings.heightJitter;
+					float scale = settings.bladeHeight * heightJitterFactor;
+
+					float tintJitter = 1.0f + (unit(rng) * 2.0f - 1.0f) * settings.colorVariation;
+					float windPhase = unit(rng) * kTwoPi;
+
+					// Independent random priority (not spatial order) —
+					// taking a prefix of candidates sorted by this gives
+					// a spatially-representative random subsample for
+					// the distance LOD, not a grid-aliased "every Nth"
+					// pattern.
+					float priority = unit(rng);
+
+					Candidate c;
+					c.blade.worldXZ = glm::vec2(worldX, worldZ);
+					c.blade.rotY = rotY;
+					c.blade.scale = scale;
+					c.blade.tint = tintJitter;
+					c.blade.windPhase = windPhase;
+					c.priority = priority;
+					out.push_back(c);
+				}
+			}
+
+			// Stable, so equal priorities keep their grid order
+			std::stable_sort(out.begin() + begin, out.end(),
+				[](const Candidate& a, const Candidate& b) { return a.priority < b.priority; });
+		}
+	};
+}
@@ -5,72 +5,49 @@
 #include "Engine/Foliage/GrassSystem.hpp"
 #include "Engine/Foliage/BladeMesh.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/ShaderVariant.hpp"
+#include "Engine/Renderer/RenderDevice.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
 #include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
-#include <random>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 namespace Nightbloom
 {
 	namespace
 	{
-		// Lightweight CPU value-noise (not true Perlin — a hashed lattice
-		// bilinearly interpolated with a smoothstep easing curve). Good
-		// enough for a placement density field; doesn't need gradient
-		// continuity the way a real height/normal map would.
-		float Hash2D(int x, int y, uint32_t seed)
-		{
-			uint32_t h = static_cast<uint32_t>(x) * 374761393u
-				+ static_cast<uint32_t>(y) * 668265263u
-				+ seed * 2147483647u;
-			h = (h ^ (h >> 13)) * 1274126177u;
-			h ^= (h >> 16);
-			return static_cast<float>(h & 0xFFFFFFu) / static_cast<float>(0xFFFFFFu);
-		}
-
-		float SmoothNoise2D(float x, float y, uint32_t seed)
-		{
-			int x0 = static_cast<int>(std::floor(x));
-			int y0 = static_cast<int>(std::floor(y));
-			float tx = x - static_cast<float>(x0);
-			float ty = y - static_cast<float>(y0);
-			float sx = tx * tx * (3.0f - 2.0f * tx);
-			float sy = ty * ty * (3.0f - 2.0f * ty);
-
-			float n00 = Hash2D(x0, y0, seed);
-			float n10 = Hash2D(x0 + 1, y0, seed);
-			float n01 = Hash2D(x0, y0 + 1, seed);
-			float n11 = Hash2D(x0 + 1, y0 + 1, seed);
-
-			float nx0 = n00 + sx * (n10 - n00);
-			float nx1 = n01 + sx * (n11 - n01);
-			return nx0 + sy * (nx1 - nx0);
-		}
-
-		// Multi-octave sum, normalized back to 0..1.
-		float Fbm2D(float x, float y, uint32_t seed, uint32_t octaves)
-		{
-			float value = 0.0f;
-			float amplitude = 0.5f;
-			float frequency = 1.0f;
-			float maxValue = 0.0f;
-			for (uint32_t i = 0; i < octaves; ++i)
-			{
-				value += SmoothNoise2D(x * frequency, y * frequency, seed + i * 101u) * amplitude;
-				maxValue += amplitude;
-				amplitude *= 0.5f;
-				frequency *= 2.0f;
-			}
-			return maxValue > 0.0f ? value / maxValue : 0.0f;
+		float SmoothstepGuarded(float e0, float e1, float x)
+		{
+			float t = glm::clamp((x - e0) / glm::max(e1 - e0, 1e-4f), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
 		}
+
+		// Two blade-mesh LOD lists (high, low) per frame in flight
+		constexpr uint32_t kCullLodCount = 2;
+		constexpr uint32_t kCullFrameCount = MAX_FRAMES_IN_FLIGHT;
+
+		// GrassGenerate.comp passes (params.grid.w)
+		constexpr uint32_t kGeneratePassCount = 0;
+		constexpr uint32_t kGeneratePassAllocate = 1;
+		constexpr uint32_t kGeneratePassEmit = 2;
 	}
 
-	bool GrassSystem::Initialize(Renderer* renderer, uint32_t maxInstanceCount)
+	bool GrassSystem::Initialize(Renderer* renderer, uint32_t maxInstanceCount, uint32_t maxPatchCount)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Grass);
+
 		if (!renderer)
 		{
 			LOG_ERROR("GrassSystem::Initialize — null renderer");
@@ -88,24 +65,62 @@ namespace Nightbloom
 		}
 
 		m_MaxInstanceCount = maxInstanceCount;
-		VkDeviceSize bufferSize = static_cast<VkDeviceSize>(maxInstanceCount) * 2ull * sizeof(glm::vec4);
+		VkDeviceSize bufferSize = static_cast<VkDeviceSize>(maxInstanceCount) * sizeof(GrassInstance);
 
-		m_InstanceBuffer = m_Resources->CreateStorageBuffer("FoliageInstances", bufferSize, false);
+		// Painting rewrites patches of it between frames: written in place
+		// where the device allows, rather than staged
+		m_InstanceBuffer = m_Resources->CreateStorageBuffer("FoliageInstances", bufferSize, false, true);
 		if (!m_InstanceBuffer)
 		{
 			LOG_ERROR("GrassSystem: failed to create instance storage buffer");
 			return false;
 		}
 
-		m_StorageDescriptorSet = m_DescriptorManager->AllocateFoliageStorageSet();
-		if (m_StorageDescriptorSet == VK_NULL_HANDLE)
+		// Per-patch LOD params written by the cull pass. Always allocated —
+		// Grass.vert declares the binding even when only the CPU path runs.
+		m_MaxPatchCount = maxPatchCount;
+		m_PatchLodBuffer = m_Resources->CreateStorageBuffer("FoliagePatchLod", GetPatchLodBufferSize(), false);
+		if (!m_PatchLodBuffer)
 		{
-			LOG_ERROR("GrassSystem: failed to allocate foliage storage descriptor set");
+			LOG_ERROR("GrassSystem: failed to create patch LOD storage buffer");
 			return false;
 		}
-		m_DescriptorManager->UpdateFoliageStorageSet(m_StorageDescriptorSet, m_InstanceBuffer->GetBuffer(), bufferSize);
 
-		LOG_INFO("GrassSystem initialized (max {} instances)", maxInstanceCount);
+		// With push descriptors the draws carry the two buffers instead of a set
+		m_StorageBuffers[0] = { m_InstanceBuffer->GetBuffer(), 0, bufferSize };
+		m_StorageBuffers[1] = { m_PatchLodBuffer->GetBuffer(), 0, GetPatchLodBufferSize() };
+		if (!m_DescriptorManager->UsesPushDescriptors())
+		{
+			m_StorageDescriptorSet = m_DescriptorManager->AllocateFoliageStorageSet();
+			if (m_StorageDescriptorSet == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("GrassSystem: failed to allocate foliage storage descriptor set");
+				return false;
+			}
+			m_DescriptorManager->UpdateFoliageStorageSet(m_StorageDescriptorSet, m_InstanceBuffer->GetBuffer(), bufferSize,
+				m_PatchLodBuffer->GetBuffer(), GetPatchLodBufferSize());
+		}
+
+		RenderDevice* device = renderer->GetDevice();
+		// GrassCull.comp always binds the Hi-Z pyramid at set 1
+		m_GpuCullingSupported = device
+			&& device->SupportsFeature("draw_indirect_count")
+			&& device->SupportsFeature("multi_draw_indirect")
+			&& renderer->GetOcclusionCuller();
+
+		if (m_GpuCullingSupported && !CreateCullResources(maxPatchCount))
+		{
+			LOG_WARN("GrassSystem: GPU culling unavailable, using the CPU patch loop");
+			m_GpuCullingSupported = false;
+		}
+
+		m_GpuGenerationSupported = CreateGenerateResources(maxPatchCount);
+		if (!m_GpuGenerationSupported)
+			LOG_WARN("GrassSystem: GPU generation unavailable, scattering on the CPU");
+
+		LOG_INFO("GrassSystem initialized (max {} instances, GPU culling {}, GPU generation {})",
+			maxInstanceCount, m_GpuCullingSupported ? "on" : "unsupported",
+			m_GpuGenerationSupported ? "on" : "unsupported");
 		return true;
 	}
 
@@ -114,22 +129,48 @@ namespace Nightbloom
 	// =========================================================================
 	bool GrassSystem::Regenerate(const GrassDesc& desc)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Grass);
+
 		if (!m_Renderer)
 		{
 			LOG_ERROR("GrassSystem::Regenerate — not initialized");
 			return false;
 		}
 
-		m_Ready = false;
-		m_Renderer->WaitForIdle();
-
-		bool needsMesh = !m_MeshBuilt
+		const bool needsMesh = !m_MeshBuilt
 			|| desc.segments != m_CurrentDesc.segments
 			|| desc.bladeBaseHalfWidth != m_CurrentDesc.bladeBaseHalfWidth
 			|| desc.taperPower != m_CurrentDesc.taperPower
 			|| desc.minTipWidthFraction != m_CurrentDesc.minTipWidthFraction
 			|| desc.bendAmount != m_CurrentDesc.bendAmount;
 
+		// Everything GrassScatterSettings carries, plus the generator choice.
+		// The rest of GrassDesc is read at draw time.
+		const bool useGpu = m_GpuGenerationSupported && m_GpuGenerationEnabled && m_DensityMask.IsEmpty();
+		const bool needsScatter = !m_Ready
+			|| useGpu != m_GpuGenerationUsed
+			|| desc.patchSize != m_CurrentDesc.patchSize
+			|| desc.candidateSpacing != m_CurrentDesc.candidateSpacing
+			|| desc.densityThreshold != m_CurrentDesc.densityThreshold
+			|| desc.densityFrequency != m_CurrentDesc.densityFrequency
+			|| desc.densityOctaves != m_CurrentDesc.densityOctaves
+			|| desc.bladeHeight != m_CurrentDesc.bladeHeight
+			|| desc.heightJitter != m_CurrentDesc.heightJitter
+			|| desc.colorVariation != m_CurrentDesc.colorVariation
+			|| desc.seed != m_CurrentDesc.seed
+			|| desc.terrainPosition != m_CurrentDesc.terrainPosition
+			|| desc.terrainWorldSize != m_CurrentDesc.terrainWorldSize
+			|| desc.terrainHeightScale != m_CurrentDesc.terrainHeightScale;
+
+		if (!needsMesh && !needsScatter)
+		{
+			m_CurrentDesc = desc;
+			return true;
+		}
+
+		m_Ready = false;
+		WaitForFramesInFlight();
+
 		if (needsMesh)
 		{
 			if (!BuildBladeMesh(desc.segments, desc.bladeBaseHalfWidth, desc.taperPower, desc.minTipWidthFraction, desc.bendAmount))
@@ -139,22 +180,147 @@ namespace Nightbloom
 			}
 		}
 
-		GenerateInstances(desc);
+		if (needsScatter)
+		{
+			m_GpuGenerationUsed = useGpu;
+			if (!useGpu || !GenerateInstancesGpu(desc))
+				GenerateInstances(desc);
+
+			LOG_INFO("GrassSystem: regenerated ({} instances, {} patches)",
+				m_ActiveInstanceCount, m_Patches.size());
+		}
 
 		m_CurrentDesc = desc;
 		m_Ready = true;
+		return true;
+	}
 
-		LOG_INFO("GrassSystem: regenerated ({} instances, {} patches)",
-			m_ActiveInstanceCount, m_Patches.size());
+	bool GrassSystem::RegenerateRegion(const glm::vec2& worldMin, const glm::vec2& worldMax)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Grass);
+		m_LastUpdatedPatchCount = 0;
 
-		return true;
+		if (!m_Ready)
+			return false;
+
+		const GrassScatterSettings settings = BuildScatterSettings(m_CurrentDesc);
+		const int perSide = GrassScatter::PatchesPerSide(settings);
+		const float actualPatchSize = settings.terrainWorldSize / static_cast<float>(perSide);
+		const glm::vec2 origin = glm::vec2(settings.terrainPosition.x, settings.terrainPosition.z)
+			- settings.terrainWorldSize * 0.5f;
+
+		const glm::ivec2 first = glm::max(glm::ivec2(glm::floor((worldMin - origin) / actualPatchSize)), glm::ivec2(0));
+		const glm::ivec2 last = glm::min(glm::ivec2(glm::floor((worldMax - origin) / actualPatchSize)), glm::ivec2(perSide - 1));
+		if (first.x > last.x || first.y > last.y)
+			return false;
+
+		WaitForFramesInFlight();
+
+		// The GPU generator's random streams differ from GrassScatter's: a
+		// patch re-scattered on the CPU would change under the brush
+		if (m_GeneratedOnGpu || m_CellPatches.size() != static_cast<size_t>(perSide) * perSide)
+		{
+			m_GpuGenerationUsed = false;
+			GenerateInstances(m_CurrentDesc);
+			m_LastUpdatedPatchCount = static_cast<uint32_t>(m_Patches.size());
+			return true;
+		}
+
+		VulkanCommandPool* pool = m_Resources->GetTransferCommandPool();
+		std::vector<GrassInstance> blades;
+		for (int pz = first.y; pz <= last.y; ++pz)
+		{
+			for (int px = first.x; px <= last.x; ++px)
+			{
+				const size_t cell = static_cast<size_t>(pz) * perSide + px;
+				uint32_t patchIndex = m_CellPatches[cell];
+				const bool isNew = (patchIndex == NO_PATCH);
+				if (isNew)
+					patchIndex = static_cast<uint32_t>(m_Patches.size());
+
+				blades.clear();
+				const uint32_t count = GrassScatter::ScatterPatchInstances(settings, perSide, px, pz, patchIndex, blades);
+				if (isNew)
+				{
+					if (count == 0)
+						continue;
+					m_Patches.push_back(GrassScatter::PatchBounds(settings, perSide, px, pz));
+					m_PatchCapacity.push_back(0);
+					m_CellPatches[cell] = patchIndex;
+				}
+
+				// Outgrown its range: move it to the tail, with a little slack
+				// for the next dabs. No room left: rebuild and compact.
+				GrassPatch& patch = m_Patches[patchIndex];
+				if (count > m_PatchCapacity[patchIndex])
+				{
+					if (count > m_MaxInstanceCount - m_InstanceEnd)
+					{
+						GenerateInstances(m_CurrentDesc);
+						m_LastUpdatedPatchCount = static_cast<uint32_t>(m_Patches.size());
+						return true;
+					}
+					patch.firstInstance = m_InstanceEnd;
+					m_PatchCapacity[patchIndex] = std::min(count + count / 4, m_MaxInstanceCount - m_InstanceEnd);
+					m_InstanceEnd += m_PatchCapacity[patchIndex];
+				}
+				patch.fullCount = count;
+
+				if (count > 0)
+				{
+					m_InstanceBuffer->UploadData(blades.data(), count * sizeof(GrassInstance),
+						static_cast<size_t>(patch.firstInstance) * sizeof(GrassInstance), pool);
+				}
+				if (m_PatchBuffer && patchIndex < m_MaxPatchCount)
+				{
+					m_PatchBuffer->UploadData(&patch, sizeof(GrassPatch),
+						static_cast<size_t>(patchIndex) * sizeof(GrassPatch), pool);
+				}
+				++m_LastUpdatedPatchCount;
+			}
+		}
+
+		m_ActiveInstanceCount = 0;
+		for (const GrassPatch& patch : m_Patches)
+			m_ActiveInstanceCount += patch.fullCount;
+		return m_LastUpdatedPatchCount > 0;
 	}
 
-	// =========================================================================
+	bool GrassSystem::PaintDensity(const glm::vec2& center, float radius, float falloff, float target, float amount)
+	{
+		if (!m_Ready || m_CurrentDesc.terrainWorldSize <= 0.0f)
+			return false;
+
+		const float worldSize = m_CurrentDesc.terrainWorldSize;
+		const glm::vec2 terrainCenter(m_CurrentDesc.terrainPosition.x, m_CurrentDesc.terrainPosition.z);
+		glm::vec2 uvMin, uvMax;
+		if (!m_DensityMask.Paint((center - terrainCenter) / worldSize + 0.5f, radius / worldSize, falloff,
+			target, amount, uvMin, uvMax))
+		{
+			return false;
+		}
+		return RegenerateRegion(terrainCenter + (uvMin - 0.5f) * worldSize, terrainCenter + (uvMax - 0.5f) * worldSize);
+	}
+
+	void GrassSystem::ClearDensityMask()
+	{
+		if (m_DensityMask.IsEmpty())
+			return;
+		m_DensityMask.Clear();
+
+		// Back to the generator Regenerate would pick
+		if (m_Ready)
+		{
+			m_Ready = false;
+			Regenerate(m_CurrentDesc);
+		}
+	}
+
+		// =========================================================================
 	// SubmitDraw
 	// =========================================================================
 	void GrassSystem::SubmitDraw(DrawList& drawList, const Frustum& frustum, VkDescriptorSet terrainHeightmapSet,
-		const glm::vec3& cameraPosition) const
+		const glm::vec3& cameraPosition)
 	{
 		if (!m_Ready || !m_VertexBuffer || !m_IndexBuffer || m_IndexCount == 0)
 			return;
@@ -162,13 +328,21 @@ namespace Nightbloom
 		if (terrainHeightmapSet == VK_NULL_HANDLE)
 			return; // terrain not ready yet — nothing to sample height from
 
-		// Soft slope cutoff: full grass at/above slopeThresholdDeg+falloff,
-		// fully gone at/below slopeThresholdDeg-falloff, smoothstep between.
-		float halfFalloffRad = glm::radians(m_CurrentDesc.slopeFalloffDeg * 0.5f);
-		float thresholdRad = glm::radians(m_CurrentDesc.slopeThresholdDeg);
-		float slopeThresholdCos = std::cos(thresholdRad + halfFalloffRad);
-		float slopeFalloffCos = std::cos(thresholdRad - halfFalloffRad);
+		if (IsGpuCulling())
+			SubmitGpuDraws(drawList, frustum, terrainHeightmapSet, cameraPosition);
+		else
+			SubmitCpuDraws(drawList, frustum, terrainHeightmapSet, cameraPosition);
+	}
+
+	bool GrassSystem::IsGpuCulling() const
+	{
+		return m_GpuCullingSupported && m_GpuCullingEnabled
+			&& m_Patches.size() <= m_MaxPatchCount
+			&& m_Renderer->GetOcclusionCuller();
+	}
 
+	glm::mat4 GrassSystem::BuildTerrainBounds() const
+	{
 		// pc.model is unused as an actual transform (instance positions are
 		// already world-space) — repurposed to carry terrain-bounds data, the
 		// slope falloff bound, and the per-patch continuous-LOD fade params so
@@ -176,6 +350,7 @@ namespace Nightbloom
 		// See Grass.vert's header comment.
 		//   model[0] = (terrainWorldSize, terrainHeightScale, terrainPosX, terrainPosZ)  [constant]
 		//   model[1] = (slopeFalloffCos, firstInstance, drawCountF, fadeBand)            [per patch]
+		//   model[2] = (gpuCulled, patchLodBase, -, -)                                   [GPU path]
 		glm::mat4 terrainBounds(1.0f);
 		terrainBounds[0] = glm::vec4(
 			m_CurrentDesc.terrainWorldSize,
@@ -183,17 +358,57 @@ namespace Nightbloom
 			m_CurrentDesc.terrainPosition.x,
 			m_CurrentDesc.terrainPosition.z);
 
-		glm::vec4 windParams(
-			slopeThresholdCos,
-			m_CurrentDesc.windStrength,
-			m_CurrentDesc.windFrequency,
-			m_CurrentDesc.windSpeed);
+		// Soft slope cutoff: full grass at/above slopeThresholdDeg+falloff,
+		// fully gone at/below slopeThresholdDeg-falloff, smoothstep between.
+		float halfFalloffRad = glm::radians(m_CurrentDesc.slopeFalloffDeg * 0.5f);
+		float thresholdRad = glm::radians(m_CurrentDesc.slopeThresholdDeg);
+		terrainBounds[1] = glm::vec4(std::cos(thresholdRad - halfFalloffRad), 0.0f, 0.0f, 0.0f);
+		terrainBounds[2] = glm::vec4(0.0f);
+		return terrainBounds;
+	}
 
-		auto smoothstepf = [](float e0, float e1, float x) -> float
-		{
-			float t = glm::clamp((x - e0) / glm::max(e1 - e0, 1e-4f), 0.0f, 1.0f);
-			return t * t * (3.0f - 2.0f * t);
-		};
+	GrassFarFieldParams GrassSystem::BuildFarFieldParams() const
+	{
+		GrassFarFieldParams params;
+		if (!m_Ready || !m_CurrentDesc.farField)
+			return params;
+
+		// Same slope bounds as the blades (BuildTerrainBounds/BuildWindParams),
+		// and a fade range Terrain.frag's smoothstep can take as it is
+		float halfFalloffRad = glm::radians(m_CurrentDesc.slopeFalloffDeg * 0.5f);
+		float thresholdRad = glm::radians(m_CurrentDesc.slopeThresholdDeg);
+		params.lod = glm::vec4(
+			m_CurrentDesc.lodFullDistance,
+			std::max(m_CurrentDesc.lodFadeDistance, m_CurrentDesc.lodFullDistance + 1e-3f),
+			glm::clamp(m_CurrentDesc.farFieldStrength, 0.0f, 1.0f),
+			1.0f);
+		params.density = glm::vec4(
+			m_CurrentDesc.densityFrequency,
+			m_CurrentDesc.densityThreshold,
+			glm::uintBitsToFloat(m_CurrentDesc.seed),
+			static_cast<float>(m_CurrentDesc.densityOctaves));
+		params.slope = glm::vec4(
+			std::cos(thresholdRad + halfFalloffRad),
+			std::cos(thresholdRad - halfFalloffRad),
+			0.0f, 0.0f);
+		return params;
+	}
+
+	glm::vec4 GrassSystem::BuildWindParams() const
+	{
+		float halfFalloffRad = glm::radians(m_CurrentDesc.slopeFalloffDeg * 0.5f);
+		float thresholdRad = glm::radians(m_CurrentDesc.slopeThresholdDeg);
+		float slopeThresholdCos = std::cos(thresholdRad + halfFalloffRad);
+
+		return glm::vec4(slopeThresholdCos, m_CurrentDesc.windStrength, 0.0f, 0.0f);
+	}
+
+	void GrassSystem::SubmitCpuDraws(DrawList& drawList, const Frustum& frustum, VkDescriptorSet terrainHeightmapSet,
+		const glm::vec3& cameraPosition) const
+	{
+		glm::mat4 terrainBounds = BuildTerrainBounds();
+		const float slopeFalloffCos = terrainBounds[1].x;
+		const glm::vec4 windParams = BuildWindParams();
 
 		for (size_t i = 0; i < m_Patches.size(); ++i)
 		{
@@ -207,7 +422,7 @@ namespace Nightbloom
 			// lodFullDistance) to 0 (at lodFadeDistance). Beyond that the patch
 			// is skipped — but its blades are already cross-faded to nothing in
 			// Grass.vert, so the skip never pops.
-			float drawFrac = 1.0f - smoothstepf(m_CurrentDesc.lodFullDistance, m_CurrentDesc.lodFadeDistance, distance);
+			float drawFrac = 1.0f - SmoothstepGuarded(m_CurrentDesc.lodFullDistance, m_CurrentDesc.lodFadeDistance, distance);
 			if (drawFrac <= 0.0f) continue;
 
 			float drawCountF = drawFrac * static_cast<float>(patch.fullCount);
@@ -242,13 +457,147 @@ namespace Nightbloom
 			cmd.pushConstants.model = terrainBounds;
 			cmd.pushConstants.customData = windParams;
 
-			cmd.textureDescriptorSet = m_StorageDescriptorSet;
+			SetStorageBindings(cmd);
 			cmd.heightmapDescriptorSet = terrainHeightmapSet;
 
 			drawList.AddCommand(cmd);
 		}
 	}
 
+	void GrassSystem::SubmitGpuDraws(DrawList& drawList, const Frustum& frustum, VkDescriptorSet terrainHeightmapSet,
+		const glm::vec3& cameraPosition)
+	{
+		const uint32_t frameIndex = m_Renderer->GetCurrentFrameIndex();
+		const uint32_t patchCount = static_cast<uint32_t>(m_Patches.size());
+		if (patchCount == 0)
+			return;
+
+		GrassCullParams params;
+		for (uint32_t i = 0; i < 5; ++i)
+			params.planes[i] = frustum.planes[i];
+		params.cameraPos = glm::vec4(cameraPosition, 0.0f);
+		params.lod = glm::vec4(
+			m_CurrentDesc.lodFullDistance,
+			m_CurrentDesc.lodFadeDistance,
+			m_CurrentDesc.meshLodDistance,
+			glm::max(4.0f, m_CurrentDesc.lodFadeBandBlades));
+		params.counts = glm::uvec4(patchCount, m_IndexCount, m_IndexCountLow, frameIndex);
+		params.capacity = glm::uvec4(m_MaxPatchCount, 0u, 0u, 0u);
+
+		const OcclusionCuller* occlusion = m_Renderer->GetOcclusionCuller();
+		params.hizViewProj = occlusion->GetPyramidViewProjection();
+		params.hiz = occlusion->GetPyramidParams();
+
+		VulkanBuffer* paramsBuffer = m_CullParamsBuffers[frameIndex];
+		void* mapped = paramsBuffer->GetPersistentMappedPtr();
+		if (!mapped)
+			return;
+		memcpy(mapped, &params, sizeof(GrassCullParams));
+		paramsBuffer->Flush();
+		m_CullPending[frameIndex] = true;
+
+		glm::mat4 terrainBounds = BuildTerrainBounds();
+		terrainBounds[2] = glm::vec4(1.0f, static_cast<float>(frameIndex * m_MaxPatchCount), 0.0f, 0.0f);
+		const glm::vec4 windParams = BuildWindParams();
+
+		// One indirect-count draw per blade mesh LOD; GrassCull.comp fills
+		// the commands and counts for this frame before the scene pass.
+		for (uint32_t lod = 0; lod < kCullLodCount; ++lod)
+		{
+			const bool useLow = (lod == 1);
+			const uint32_t listIndex = frameIndex * kCullLodCount + lod;
+
+			DrawCommand cmd;
+			cmd.pipeline = PipelineType::Foliage;
+			cmd.vertexBuffer = useLow ? m_VertexBufferLow.get() : m_VertexBuffer.get();
+			cmd.indexBuffer  = useLow ? m_IndexBufferLow.get()  : m_IndexBuffer.get();
+			cmd.indexCount   = useLow ? m_IndexCountLow : m_IndexCount;
+
+			cmd.indirectBuffer = m_IndirectBuffer;
+			cmd.indirectOffset = listIndex * m_MaxPatchCount * sizeof(VkDrawIndexedIndirectCommand);
+			cmd.countBuffer = m_DrawCountBuffer;
+			cmd.countOffset = listIndex * sizeof(uint32_t);
+			cmd.maxDrawCount = patchCount;
+
+			cmd.hasPushConstants = true;
+			cmd.pushConstants.model = terrainBounds;
+			cmd.pushConstants.customData = windParams;
+
+			SetStorageBindings(cmd);
+			cmd.heightmapDescriptorSet = terrainHeightmapSet;
+
+			drawList.AddCommand(cmd);
+		}
+	}
+
+	// =========================================================================
+	// GPU cull pass
+	// =========================================================================
+	bool GrassSystem::DispatchCull(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex)
+	{
+		const OcclusionCuller* occlusion = m_Renderer->GetOcclusionCuller();
+		if (!m_CullPending[frameIndex] || !dispatcher || !occlusion || m_CullPipeline == VK_NULL_HANDLE)
+			return false;
+		m_CullPending[frameIndex] = false;
+
+		// Zero this frame's two counters, then make the clear visible to the atomics
+		const VkDeviceSize countOffset = frameIndex * kCullLodCount * sizeof(uint32_t);
+		vkCmdFillBuffer(cmd, m_DrawCountBuffer->GetBuffer(), countOffset, kCullLodCount * sizeof(uint32_t), 0);
+		dispatcher->QueueBufferBarrier(cmd, m_DrawCountBuffer->GetBuffer(), GetDrawCountBufferSize(),
+			VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+
+		dispatcher->BindPipeline(cmd, m_CullPipeline);
+		dispatcher->BindDescriptorSet(cmd, m_CullPipelineLayout, 0, m_CullDescriptorSets[frameIndex]);
+		dispatcher->BindDescriptorSet(cmd, m_CullPipelineLayout, 1, occlusion->GetPyramidSampleSet());
+
+		uint32_t groupCount = ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(m_Patches.size()), 64);
+		dispatcher->Dispatch(cmd, groupCount, 1, 1);
+		return true;
+	}
+
+	VkBuffer GrassSystem::GetIndirectBuffer() const
+	{
+		return m_IndirectBuffer ? m_IndirectBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkDeviceSize GrassSystem::GetIndirectBufferSize() const
+	{
+		return static_cast<VkDeviceSize>(kCullFrameCount) * kCullLodCount * m_MaxPatchCount * sizeof(VkDrawIndexedIndirectCommand);
+	}
+
+	VkBuffer GrassSystem::GetDrawCountBuffer() const
+	{
+		return m_DrawCountBuffer ? m_DrawCountBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkDeviceSize GrassSystem::GetDrawCountBufferSize() const
+	{
+		return static_cast<VkDeviceSize>(kCullFrameCount) * kCullLodCount * sizeof(uint32_t);
+	}
+
+	VkBuffer GrassSystem::GetPatchLodBuffer() const
+	{
+		return m_PatchLodBuffer ? m_PatchLodBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkDeviceSize GrassSystem::GetPatchLodBufferSize() const
+	{
+		return static_cast<VkDeviceSize>(kCullFrameCount) * m_MaxPatchCount * sizeof(glm::vec4);
+	}
+
+	void GrassSystem::SetStorageBindings(DrawCommand& cmd) const
+	{
+		if (m_StorageDescriptorSet != VK_NULL_HANDLE)
+		{
+			cmd.textureDescriptorSet = m_StorageDescriptorSet;
+			return;
+		}
+		static_assert(DrawCommand::MAX_PUSH_BUFFERS >= 2, "grass pushes two storage buffers");
+		cmd.pushBuffers[0] = m_StorageBuffers[0];
+		cmd.pushBuffers[1] = m_StorageBuffers[1];
+	}
+
 	// =========================================================================
 	// Shutdown
 	// =========================================================================
@@ -257,7 +606,31 @@ namespace Nightbloom
 		if (m_Renderer)
 		{
 			m_Renderer->WaitForIdle();
+			m_Renderer->SetGrassSystem(nullptr); // stop the cull dispatch before its pipeline goes away
+
+			VkDevice device = m_Renderer->GetVkDevice();
+			if (m_CullPipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_CullPipeline, nullptr);
+				m_CullPipeline = VK_NULL_HANDLE;
+			}
+			if (m_CullPipelineLayout != VK_NULL_HANDLE)
+			{
+				vkDestroyPipelineLayout(device, m_CullPipelineLayout, nullptr);
+				m_CullPipelineLayout = VK_NULL_HANDLE;
+			}
+			if (m_GeneratePipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_GeneratePipeline, nullptr);
+				m_GeneratePipeline = VK_NULL_HANDLE;
+			}
+			if (m_GeneratePipelineLayout != VK_NULL_HANDLE)
+			{
+				vkDestroyPipelineLayout(device, m_GeneratePipelineLayout, nullptr);
+				m_GeneratePipelineLayout = VK_NULL_HANDLE;
+			}
 		}
+		std::fill_n(m_CullPending, kCullFrameCount, false);
 
 		m_VertexBuffer.reset();
 		m_IndexBuffer.reset();
@@ -267,12 +640,17 @@ namespace Nightbloom
 		m_IndexCountLow = 0;
 		m_MeshBuilt = false;
 		m_Patches.clear();
+		m_PatchCapacity.clear();
+		m_CellPatches.clear();
+		m_DensityMask.Clear();
+		m_InstanceEnd = 0;
 		m_ActiveInstanceCount = 0;
 		m_Ready = false;
 
-		// m_InstanceBuffer is owned by ResourceManager's named buffer cache
-		// (same convention as FireflySystem's m_AgentBuffer) — not freed here.
-		// m_StorageDescriptorSet is reclaimed by the descriptor pool's bulk
+		// m_InstanceBuffer, the cull buffers and the patch readback buffer are owned by ResourceManager's
+		// named buffer cache (same convention as FireflySystem's m_AgentBuffer)
+		// — not freed here.
+		// m_StorageDescriptorSet and m_GenerateDescriptorSet are reclaimed by the descriptor pool's bulk
 		// reset at VulkanDescriptorManager::Cleanup().
 
 		LOG_INFO("GrassSystem shut down");
@@ -282,6 +660,152 @@ namespace Nightbloom
 	// Private helpers
 	// =========================================================================
 
+	bool GrassSystem::CreateCullResources(uint32_t maxPatchCount)
+	{
+		m_PatchBuffer = m_Resources->CreateStorageBuffer("FoliagePatches",
+			static_cast<size_t>(maxPatchCount) * sizeof(GrassPatch), false, true);
+		m_IndirectBuffer = m_Resources->CreateIndirectBuffer("FoliageIndirect", GetIndirectBufferSize());
+		m_DrawCountBuffer = m_Resources->CreateIndirectBuffer("FoliageDrawCounts", GetDrawCountBufferSize());
+		if (!m_PatchBuffer || !m_IndirectBuffer || !m_DrawCountBuffer)
+		{
+			LOG_ERROR("GrassSystem: failed to create cull buffers");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < kCullFrameCount; ++i)
+		{
+			m_CullParamsBuffers[i] = m_Resources->CreateUniformBuffer(
+				"FoliageCullParams_" + std::to_string(i), sizeof(GrassCullParams));
+			m_CullDescriptorSets[i] = m_DescriptorManager->AllocateFoliageCullSet();
+			if (!m_CullParamsBuffers[i] || m_CullDescriptorSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("GrassSystem: failed to create cull params {}", i);
+				return false;
+			}
+
+			VulkanDescriptorManager::FoliageCullBuffers buffers;
+			buffers.patches = m_PatchBuffer->GetBuffer();
+			buffers.patchesSize = static_cast<VkDeviceSize>(maxPatchCount) * sizeof(GrassPatch);
+			buffers.indirectDraws = m_IndirectBuffer->GetBuffer();
+			buffers.indirectDrawsSize = GetIndirectBufferSize();
+			buffers.drawCounts = m_DrawCountBuffer->GetBuffer();
+			buffers.drawCountsSize = GetDrawCountBufferSize();
+			buffers.patchLod = m_PatchLodBuffer->GetBuffer();
+			buffers.patchLodSize = GetPatchLodBufferSize();
+			buffers.params = m_CullParamsBuffers[i]->GetBuffer();
+			buffers.paramsSize = sizeof(GrassCullParams);
+			m_DescriptorManager->UpdateFoliageCullSet(m_CullDescriptorSets[i], buffers);
+		}
+
+		// Set 0 = patch/draw buffers, set 1 = Hi-Z pyramid (hiz_occlusion.glsl)
+		VkDescriptorSetLayout setLayouts[2] = {
+			m_DescriptorManager->GetFoliageCullSetLayout(),
+			m_DescriptorManager->GetHiZSampleSetLayout()
+		};
+		const std::string shader = SelectSubgroupShader("GrassCull.comp.spv",
+			m_Renderer->GetDevice()->SupportsFeature("subgroup_ops"));
+		return CreateComputePipeline(shader.c_str(), setLayouts, 2, 0, m_CullPipelineLayout, m_CullPipeline);
+	}
+
+	bool GrassSystem::CreateGenerateResources(uint32_t maxPatchCount)
+	{
+		// Shares the cull pass's patch buffer when that exists
+		const VkDeviceSize patchBytes = static_cast<VkDeviceSize>(maxPatchCount) * sizeof(GrassPatch);
+		if (!m_PatchBuffer)
+			m_PatchBuffer = m_Resources->CreateStorageBuffer("FoliagePatches", patchBytes, false, true);
+		m_PatchReadbackBuffer = m_Resources->CreateStorageBuffer("FoliagePatchReadback", patchBytes, true);
+		if (!m_PatchBuffer || !m_PatchReadbackBuffer)
+		{
+			LOG_ERROR("GrassSystem: failed to create generation buffers");
+			return false;
+		}
+
+		m_GenerateDescriptorSet = m_DescriptorManager->AllocateComputeStorageSet();
+		if (m_GenerateDescriptorSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("GrassSystem: failed to allocate generation descriptor set");
+			return false;
+		}
+		m_DescriptorManager->UpdateComputeStorageSet(m_GenerateDescriptorSet,
+			m_PatchBuffer->GetBuffer(), patchBytes,
+			m_InstanceBuffer->GetBuffer(), static_cast<VkDeviceSize>(m_MaxInstanceCount) * sizeof(GrassInstance));
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetComputeStorageSetLayout();
+		return CreateComputePipeline("GrassGenerate.comp.spv", &setLayout, 1, sizeof(GrassGenerateParams),
+			m_GeneratePipelineLayout, m_GeneratePipeline);
+	}
+
+	bool GrassSystem::CreateComputePipeline(const char* shaderFile, const VkDescriptorSetLayout* setLayouts,
+		uint32_t setLayoutCount, uint32_t pushConstantSize, VkPipelineLayout& layoutOut, VkPipeline& pipelineOut)
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderFile);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("GrassSystem: failed to load {}", shaderFile);
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("GrassSystem: failed to create shader module for {}", shaderFile);
+			return false;
+		}
+
+		VkPipelineShaderStageCreateInfo stageInfo{};
+		stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		stageInfo.module = shaderModule;
+		stageInfo.pName = "main";
+
+		VkPushConstantRange pushRange{};
+		pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushRange.offset = 0;
+		pushRange.size = pushConstantSize;
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = setLayoutCount;
+		layoutInfo.pSetLayouts = setLayouts;
+		layoutInfo.pushConstantRangeCount = (pushConstantSize > 0) ? 1 : 0;
+		layoutInfo.pPushConstantRanges = (pushConstantSize > 0) ? &pushRange : nullptr;
+
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layoutOut) != VK_SUCCESS)
+		{
+			LOG_ERROR("GrassSystem: failed to create pipeline layout for {}", shaderFile);
+			vkDestroyShaderModule(device, shaderModule, nullptr);
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = stageInfo;
+		pipelineInfo.layout = layoutOut;
+
+		VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipelineOut);
+
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("GrassSystem: failed to create compute pipeline for {}", shaderFile);
+			vkDestroyPipelineLayout(device, layoutOut, nullptr);
+			layoutOut = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, pipelineOut, shaderFile);
+
+		LOG_INFO("GrassSystem: compute pipeline created ({})", shaderFile);
+		return true;
+	}
+
 	bool GrassSystem::BuildBladeMesh(uint32_t segments, float baseHalfWidth, float taperPower, float minTipWidthFraction, float bendAmount)
 	{
 		// Cheap mesh-complexity LOD: a far/mid blade with very few segments. The
@@ -340,132 +864,204 @@ namespace Nightbloom
 		return true;
 	}
 
-	void GrassSystem::GenerateInstances(const GrassDesc& desc)
+	void GrassSystem::WaitForFramesInFlight()
 	{
-		m_Patches.clear();
-
-		std::vector<glm::vec4> instanceData;
-		instanceData.reserve(static_cast<size_t>(m_MaxInstanceCount) * 2);
-
-		std::mt19937 rng(desc.seed);
-		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
-
-		const float kTwoPi = 6.2831853f;
-		float halfWorld = desc.terrainWorldSize * 0.5f;
-		int patchCount = std::max(1, static_cast<int>(std::ceil(desc.terrainWorldSize / desc.patchSize)));
-		float actualPatchSize = desc.terrainWorldSize / static_cast<float>(patchCount);
-		float spacing = std::max(desc.candidateSpacing, 0.05f);
-
-		struct Candidate { glm::vec4 d0, d1; float priority; };
-		std::vector<Candidate> patchCandidates;
+		// The blade meshes, instances and patch table are rewritten in place,
+		// so frames still reading them must finish - a wait on the graphics
+		// queue's last submission (an async compute cull is always waited on
+		// by its frame's graphics submission), not a device idle
+		VulkanQueueTimeline* timeline = static_cast<VulkanDevice*>(m_Renderer->GetDevice())->GetGraphicsTimeline();
+		timeline->Wait(timeline->GetLastSubmittedValue());
+	}
 
-		bool truncated = false;
+	GrassScatterSettings GrassSystem::BuildScatterSettings(const GrassDesc& desc) const
+	{
+		GrassScatterSettings settings;
+		settings.terrainWorldSize = desc.terrainWorldSize;
+		settings.terrainHeightScale = desc.terrainHeightScale;
+		settings.terrainPosition = desc.terrainPosition;
+		settings.patchSize = desc.patchSize;
+		settings.candidateSpacing = desc.candidateSpacing;
+		settings.densityThreshold = desc.densityThreshold;
+		settings.densityFrequency = desc.densityFrequency;
+		settings.densityOctaves = desc.densityOctaves;
+		settings.bladeHeight = desc.bladeHeight;
+		settings.heightJitter = desc.heightJitter;
+		settings.colorVariation = desc.colorVariation;
+		settings.seed = desc.seed;
+		settings.densityMask = m_DensityMask.IsEmpty() ? nullptr : &m_DensityMask;
+		return settings;
+	}
 
-		for (int pz = 0; pz < patchCount; ++pz)
+	// After a full scatter every patch owns exactly its blades, packed from
+	// 0; the cell map is rebuilt from the patch centres
+	void GrassSystem::ResetPatchRanges(const GrassScatterSettings& settings)
+	{
+		const int patchesPerSide = GrassScatter::PatchesPerSide(settings);
+		m_PatchCapacity.resize(m_Patches.size());
+		m_CellPatches.assign(static_cast<size_t>(patchesPerSide) * patchesPerSide, NO_PATCH);
+		m_InstanceEnd = 0;
+		for (uint32_t i = 0; i < m_Patches.size(); ++i)
 		{
-			for (int px = 0; px < patchCount; ++px)
-			{
-				float cellMinX = -halfWorld + px * actualPatchSize;
-				float cellMinZ = -halfWorld + pz * actualPatchSize;
-				float cellCenterX = cellMinX + actualPatchSize * 0.5f;
-				float cellCenterZ = cellMinZ + actualPatchSize * 0.5f;
-
-				int candidatesPerSide = std::max(1, static_cast<int>(actualPatchSize / spacing));
+			const GrassPatch& patch = m_Patches[i];
+			m_PatchCapacity[i] = patch.fullCount;
+			m_InstanceEnd = std::max(m_InstanceEnd, patch.firstInstance + patch.fullCount);
+			m_CellPatches[GrassScatter::PatchCell(settings, patchesPerSide, patch.center)] = i;
+		}
+	}
 
-				patchCandidates.clear();
+	void GrassSystem::GenerateInstances(const GrassDesc& desc)
+	{
+		const GrassScatterSettings settings = BuildScatterSettings(desc);
 
-				for (int gz = 0; gz < candidatesPerSide; ++gz)
-				{
-					for (int gx = 0; gx < candidatesPerSide; ++gx)
-					{
-						// Jitter each candidate within its grid cell so the
-						// regular spacing doesn't read as a visible grid.
-						float jitterX = (unit(rng) * 2.0f - 1.0f) * spacing * 0.5f;
-						float jitterZ = (unit(rng) * 2.0f - 1.0f) * spacing * 0.5f;
-						float worldX = cellMinX + (gx + 0.5f) * spacing + jitterX + desc.terrainPosition.x;
-						float worldZ = cellMinZ + (gz + 0.5f) * spacing + jitterZ + desc.terrainPosition.z;
-
-						float density = Fbm2D(worldX * desc.densityFrequency, worldZ * desc.densityFrequency,
-							desc.seed, desc.densityOctaves);
-
-						if (density <= desc.densityThreshold)
-							continue;
-
-						float rotY = unit(rng) * kTwoPi;
-						float heightJitterFactor = 1.0f + (unit(rng) * 2.0f - 1.0f) * desc.heightJitter;
-						float scale = desc.bladeHeight * heightJitterFactor;
-
-						float tintJitter = 1.0f + (unit(rng) * 2.0f - 1.0f) * desc.colorVariation;
-						float windPhase = unit(rng) * kTwoPi;
-
-						// Independent random priority (not spatial order) —
-						// taking a prefix of candidates sorted by this gives
-						// a spatially-representative random subsample for
-						// the LOD tiers below, not a grid-aliased "every
-						// Nth" pattern.
-						float priority = unit(rng);
-
-						Candidate c;
-						c.d0 = glm::vec4(worldX, worldZ, rotY, scale);
-						c.d1 = glm::vec4(tintJitter, tintJitter, tintJitter, windPhase);
-						c.priority = priority;
-						patchCandidates.push_back(c);
-					}
-				}
+		std::vector<GrassInstance> instanceData;
+		if (!GrassScatter::Generate(settings, m_MaxInstanceCount, 0, instanceData, m_Patches))
+		{
+			LOG_WARN("GrassSystem: hit maxInstanceCount ({}) — increase it or reduce density",
+				m_MaxInstanceCount);
+		}
 
-				if (patchCandidates.empty())
-					continue;
+		m_ActiveInstanceCount = static_cast<uint32_t>(instanceData.size());
+		m_GeneratedOnGpu = false;
+		ResetPatchRanges(settings);
 
-				std::sort(patchCandidates.begin(), patchCandidates.end(),
-					[](const Candidate& a, const Candidate& b) { return a.priority < b.priority; });
+		if (!instanceData.empty() && m_InstanceBuffer)
+		{
+			m_InstanceBuffer->UploadData(
+				instanceData.data(),
+				instanceData.size() * sizeof(GrassInstance),
+				0,
+				m_Resources->GetTransferCommandPool());
+		}
 
-				uint32_t naturalTotal = static_cast<uint32_t>(patchCandidates.size());
-				uint32_t remainingBudget = m_MaxInstanceCount - static_cast<uint32_t>(instanceData.size() / 2);
-				uint32_t pushCount = std::min(naturalTotal, remainingBudget);
-				if (pushCount < naturalTotal)
-					truncated = true;
+		// Patch bounds for the GPU cull pass. A grid larger than the buffer
+		// just keeps this configuration on the CPU path (see IsGpuCulling).
+		if (m_PatchBuffer && !m_Patches.empty())
+		{
+			if (m_Patches.size() <= m_MaxPatchCount)
+			{
+				m_PatchBuffer->UploadData(
+					m_Patches.data(),
+					m_Patches.size() * sizeof(GrassPatch),
+					0,
+					m_Resources->GetTransferCommandPool());
+			}
+			else
+			{
+				LOG_WARN("GrassSystem: {} patches exceed the GPU cull capacity ({}) — culling on the CPU",
+					m_Patches.size(), m_MaxPatchCount);
+			}
+		}
+	}
 
-				if (pushCount == 0)
-					continue;
+	bool GrassSystem::GenerateInstancesGpu(const GrassDesc& desc)
+	{
+		ComputeDispatcher* dispatcher = m_Renderer->GetComputeDispatcher();
+		if (!dispatcher || m_GeneratePipeline == VK_NULL_HANDLE)
+			return false;
 
-				uint32_t patchFirst = static_cast<uint32_t>(instanceData.size() / 2);
-				for (uint32_t i = 0; i < pushCount; ++i)
-				{
-					instanceData.push_back(patchCandidates[i].d0);
-					instanceData.push_back(patchCandidates[i].d1);
-				}
+		// Same patch/candidate grid as GenerateInstances
+		const uint32_t patchesPerSide = static_cast<uint32_t>(
+			std::max(1, static_cast<int>(std::ceil(desc.terrainWorldSize / desc.patchSize))));
+		const uint32_t patchCount = patchesPerSide * patchesPerSide;
+		if (patchCount > m_MaxPatchCount)
+		{
+			LOG_WARN("GrassSystem: {} patches exceed the GPU patch capacity ({}) — generating on the CPU",
+				patchCount, m_MaxPatchCount);
+			return false;
+		}
 
-				GrassPatch patch;
-				patch.center = glm::vec3(
-					cellCenterX + desc.terrainPosition.x,
-					desc.terrainPosition.y + desc.terrainHeightScale * 0.5f,
-					cellCenterZ + desc.terrainPosition.z);
-				patch.extents = glm::vec3(
-					actualPatchSize * 0.5f,
-					desc.terrainHeightScale * 0.5f + desc.bladeHeight,
-					actualPatchSize * 0.5f);
-				patch.firstInstance = patchFirst;
-				patch.fullCount = pushCount;
-				m_Patches.push_back(patch);
-			}
+		const float actualPatchSize = desc.terrainWorldSize / static_cast<float>(patchesPerSide);
+		const float spacing = std::max(desc.candidateSpacing, 0.05f);
+		const uint32_t candidatesPerSide = static_cast<uint32_t>(std::max(1, static_cast<int>(actualPatchSize / spacing)));
+
+		// The visiting order permutes the next power of two above the candidate count
+		uint32_t orderBits = 0;
+		while ((1ull << orderBits) < static_cast<uint64_t>(candidatesPerSide) * candidatesPerSide)
+			++orderBits;
+
+		GrassGenerateParams params;
+		params.area = glm::vec4(-desc.terrainWorldSize * 0.5f, actualPatchSize, spacing, 0.0f);
+		params.terrain = glm::vec4(desc.terrainPosition, desc.terrainHeightScale);
+		params.blade = glm::vec4(desc.densityFrequency, desc.densityThreshold, desc.bladeHeight, desc.heightJitter);
+		params.variation = glm::vec4(desc.colorVariation, 0.0f, 0.0f, 0.0f);
+		params.grid = glm::uvec4(patchesPerSide, candidatesPerSide, orderBits, kGeneratePassCount);
+		params.config = glm::uvec4(desc.seed, desc.densityOctaves, m_MaxInstanceCount, patchCount);
+
+		const VkBuffer patchBuffer = m_PatchBuffer->GetBuffer();
+		const VkDeviceSize patchBytes = static_cast<VkDeviceSize>(patchCount) * sizeof(GrassPatch);
+		{
+			VulkanSingleTimeCommand cmd(static_cast<VulkanDevice*>(m_Renderer->GetDevice()), m_Resources->GetTransferCommandPool());
+			VkCommandBuffer commandBuffer = cmd.Begin();
+
+			dispatcher->BindPipeline(commandBuffer, m_GeneratePipeline);
+			dispatcher->BindDescriptorSet(commandBuffer, m_GeneratePipelineLayout, 0, m_GenerateDescriptorSet);
+
+			// Count survivors per patch, prefix-sum them into ranges, then fill the ranges
+			dispatcher->PushConstants(commandBuffer, m_GeneratePipelineLayout, &params, sizeof(GrassGenerateParams));
+			dispatcher->Dispatch(commandBuffer, patchCount, 1, 1);
+			dispatcher->ComputeToComputeGlobalBarrier(commandBuffer); // later passes rewrite the patch table
+
+			params.grid.w = kGeneratePassAllocate;
+			dispatcher->PushConstants(commandBuffer, m_GeneratePipelineLayout, &params, sizeof(GrassGenerateParams));
+			dispatcher->Dispatch(commandBuffer, 1, 1, 1);
+			dispatcher->ComputeToComputeGlobalBarrier(commandBuffer);
+
+			params.grid.w = kGeneratePassEmit;
+			dispatcher->PushConstants(commandBuffer, m_GeneratePipelineLayout, &params, sizeof(GrassGenerateParams));
+			dispatcher->Dispatch(commandBuffer, patchCount, 1, 1);
+
+			// Instances to the vertex shader, patch table back to the host for
+			// m_Patches: one batch, flushed before the copy
+			dispatcher->QueueBufferBarrier(commandBuffer, m_InstanceBuffer->GetBuffer(),
+				static_cast<VkDeviceSize>(m_MaxInstanceCount) * sizeof(GrassInstance),
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+				VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+			dispatcher->QueueBufferBarrier(commandBuffer, patchBuffer, patchBytes,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+				VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+			dispatcher->FlushBarriers(commandBuffer);
+			VkBufferCopy region{};
+			region.size = patchBytes;
+			vkCmdCopyBuffer(commandBuffer, patchBuffer, m_PatchReadbackBuffer->GetBuffer(), 1, &region);
+
+			VkMemoryBarrier hostBarrier{};
+			hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+				0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+			cmd.End(); // Submits and waits for the GPU to finish
 		}
 
-		if (truncated)
+		void* mapped = m_PatchReadbackBuffer->GetPersistentMappedPtr();
+		const bool mappedHere = (mapped == nullptr);
+		if (mappedHere)
+			mapped = m_PatchReadbackBuffer->Map();
+		if (!mapped)
 		{
-			LOG_WARN("GrassSystem: hit maxInstanceCount ({}) — increase it or reduce density",
-				m_MaxInstanceCount);
+			LOG_ERROR("GrassSystem: failed to map the patch readback buffer");
+			return false;
 		}
 
-		m_ActiveInstanceCount = static_cast<uint32_t>(instanceData.size() / 2);
+		m_Patches.resize(patchCount);
+		memcpy(m_Patches.data(), mapped, patchBytes);
+		if (mappedHere)
+			m_PatchReadbackBuffer->Unmap();
 
-		if (!instanceData.empty() && m_InstanceBuffer)
+		m_ActiveInstanceCount = 0;
+		for (const GrassPatch& patch : m_Patches)
+			m_ActiveInstanceCount += patch.fullCount;
+		m_GeneratedOnGpu = true;
+		ResetPatchRanges(BuildScatterSettings(desc));
+
+		if (m_ActiveInstanceCount >= m_MaxInstanceCount)
 		{
-			m_InstanceBuffer->UploadData(
-				instanceData.data(),
-				instanceData.size() * sizeof(glm::vec4),
-				0,
-				m_Resources->GetTransferCommandPool());
+			LOG_WARN("GrassSystem: hit maxInstanceCount ({}) — increase it or reduce density",
+				m_MaxInstanceCount);
 		}
+		return true;
 	}
 
 } // namespace Nightbloom
@@ -3,30 +3,47 @@
 //
 // Instanced grass blade rendering. A real tapered blade mesh (BladeMesh) is
 // uploaded once and drawn via instancing; per-instance world position,
-// rotation, scale, color tint, and wind phase live in a storage buffer.
+// rotation, scale, color tint, and wind phase live in a storage buffer,
+// packed to 16 bytes per blade (GrassInstance, see GrassScatter.hpp).
 //
 // Placement is a dense candidate grid (spacing = candidateSpacing) scattered
 // across the terrain's world bounds, where each candidate is kept or
-// dropped based on a multi-octave CPU noise sample (see GrassSystem.cpp's
-// Fbm2D) compared against densityThreshold — the same "sample a noise
-// field to decide what's here" trick the heightmap itself uses, just
-// CPU-side and binary instead of a continuous height. This produces patchy,
+// dropped based on a multi-octave value-noise sample (GrassSystem.cpp's
+// Fbm2D, ported as-is to GrassGenerate.comp) compared against
+// densityThreshold — the same "sample a noise field to decide what's here"
+// trick the heightmap itself uses, just binary instead of a continuous
+// height. This produces patchy,
 // organic-looking clusters for free, without an explicit "clump" object —
 // an earlier pass used discrete random clump centers with blades scattered
 // around each one, which read as a uniform grid of separate dots rather
-// than continuous-looking cover; replaced for that reason. A future
-// "authored placement" pass (if ever needed) would swap the noise sample
-// for a painted density mask texture — same per-candidate accept/reject
-// shape, no architecture change.
+// than continuous-looking cover; replaced for that reason. Authored
+// placement is a painted density mask that scales the noise sample (see
+// Incremental updates below) — same per-candidate accept/reject shape.
 //
-// Height/slope are sampled from the terrain heightmap in Grass.vert — there
-// is no CPU-side height query in this engine.
+// Height/slope are sampled from the terrain heightmap in Grass.vert, so
+// blades follow the surface that is drawn. TerrainSystem::SampleHeight is
+// the CPU-side equivalent, for work that needs heights before drawing.
+//
+// Generation runs on the GPU (GrassGenerate.comp) wherever the patch grid
+// fits the patch buffer: the shader scatters the candidates, applies the
+// density test and the random visiting order, and writes the instance buffer
+// and patch table in place; only the small patch table is read back (for the
+// CPU cull loop and the stats). GenerateInstances is the CPU fallback and
+// uses its own random streams (GrassScatter.hpp, spread over every core), so
+// the two paths give different fields for the same seed (SetGpuGeneration
+// switches).
 //
 // Instances are grouped into world-space grid patches at generation time
 // (sorted contiguously into the storage buffer, one firstInstance offset per
 // patch) so SubmitDraw can frustum-cull whole patches against the existing
 // Frustum::Intersects test and submit one DrawCommand per visible patch.
 //
+// GPU culling: where the device has drawIndirectCount, the same patch loop
+// runs in GrassCull.comp instead (dispatched from Renderer::RecordCommandBuffer)
+// and SubmitDraw only adds two indirect-count DrawCommands — one per blade
+// mesh LOD — so the CPU cost no longer scales with the patch count. The CPU
+// loop stays as the fallback and for A/B comparison (SetGpuCulling).
+//
 // Distance LOD (continuous, pop-free): each patch's candidates are shuffled by
 // an independent random priority (not spatial order — avoids grid/banding a
 // strided "every Nth" thinning would show) before being appended, so any
@@ -39,16 +56,42 @@
 // meshLodDistance. This replaced an earlier 3-hard-tier scheme whose threshold
 // crossings popped a chunk of blades in/out at once.
 //
+// Incremental updates: Regenerate only re-scatters when a placement field
+// changed (draw-only fields - wind, slope, LOD, far field - just take effect).
+// Painting the density mask (PaintDensity, GrassDensityMask.hpp) re-scatters
+// only the patches under the brush, on the CPU: each patch's blades are
+// rewritten in place when they still fit its range, or moved to the unused
+// tail of the instance buffer, with partial uploads of its blades and its
+// patch-table entry. Once the tail runs out the next edit rebuilds (and so
+// compacts) everything. Blade heights come from the heightmap in Grass.vert
+// and patch bounds span the whole height range, so sculpting the terrain
+// needs no grass update at all. The mask is CPU-side only: with one painted,
+// full regenerations scatter on the CPU too, and the far field (below)
+// doesn't see it.
+//
+// Far field: the blades end at lodFadeDistance, but the ground past them
+// keeps reading as grass. Terrain.frag evaluates the same density noise per
+// fragment and, on flat ground above the waterline, blends the terrain albedo
+// toward the blade colour (and its normal toward the blades' up-biased one)
+// by the share of blades the distance LOD has dropped there. Coverage reaches
+// the horizon at no vertex cost, so the blade budget can be pulled in close
+// to the camera. The parameters travel in the frame uniforms
+// (GrassFarFieldParams), which the Renderer fills from the GrassSystem it
+// was given.
+//
 // Usage:
 //   GrassSystem grass;
 //   grass.Initialize(renderer);
 //   grass.Regenerate(desc);                            // call whenever params change
+//   renderer->SetGrassSystem(&grass);                  // GPU cull pass dispatch
 //   grass.SubmitDraw(drawList, frustum, heightmapSet, cameraPosition); // call each frame
 //   grass.Shutdown();
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Foliage/GrassScatter.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
@@ -60,8 +103,41 @@ namespace Nightbloom
 	class Renderer;
 	class ResourceManager;
 	class VulkanDescriptorManager;
+	class ComputeDispatcher;
 	struct Frustum;
 
+	// Uploaded to the cull params UBO each frame - matches GrassCull.comp
+	struct GrassCullParams
+	{
+		glm::vec4  planes[5];    // Frustum::planes
+		glm::vec4  cameraPos = glm::vec4(0.0f);
+		glm::vec4  lod = glm::vec4(0.0f);        // lodFullDistance, lodFadeDistance, meshLodDistance, fadeBand
+		glm::uvec4 counts = glm::uvec4(0u);      // patchCount, indexCountHigh, indexCountLow, frameIndex
+		glm::uvec4 capacity = glm::uvec4(0u);    // maxPatches
+		glm::mat4  hizViewProj = glm::mat4(1.0f); // OcclusionCuller::GetPyramidViewProjection
+		glm::vec4  hiz = glm::vec4(0.0f);        // OcclusionCuller::GetPyramidParams (w = 0 skips the test)
+	};
+
+	// Push constants of GrassGenerate.comp (96 bytes)
+	struct GrassGenerateParams
+	{
+		glm::vec4  area = glm::vec4(0.0f);      // terrain min corner (local), patch size, candidate spacing, -
+		glm::vec4  terrain = glm::vec4(0.0f);   // terrainPosition, terrainHeightScale
+		glm::vec4  blade = glm::vec4(0.0f);     // densityFrequency, densityThreshold, bladeHeight, heightJitter
+		glm::vec4  variation = glm::vec4(0.0f); // colorVariation, -, -, -
+		glm::uvec4 grid = glm::uvec4(0u);       // patches per side, candidates per side, visiting-order bits, pass
+		glm::uvec4 config = glm::uvec4(0u);     // seed, densityOctaves, maxInstanceCount, patchCount
+	};
+
+	// Far-field grass params, copied into FrameUniformData's farGrass* fields
+	// each frame - matches FrameUBO in scene_common.glsl
+	struct GrassFarFieldParams
+	{
+		glm::vec4 lod = glm::vec4(0.0f);      // lodFullDistance, lodFadeDistance, farFieldStrength, enabled
+		glm::vec4 density = glm::vec4(0.0f);  // densityFrequency, densityThreshold, seed (uint bits), densityOctaves
+		glm::vec4 slope = glm::vec4(0.0f);    // slopeThresholdCos, slopeFalloffCos, -, -
+	};
+
 	struct GrassDesc
 	{
 		// Blade mesh shape (triggers a mesh rebuild if changed)
@@ -97,11 +173,10 @@ namespace Nightbloom
 		float    densityFrequency = 0.06f;  // world units per noise cycle (~1/frequency)
 		uint32_t densityOctaves = 2;
 
-		// Wind (blows along a fixed world +X direction in Grass.vert — a v1
-		// simplification, see that shader's header comment)
-		float windSpeed = 1.0f;
+		// How far the blades bend in the wind. The wind itself (direction,
+		// sway speed and frequency, gusts) is the renderer's wind field,
+		// shared with the water and the fireflies (Renderer::GetWindSettings).
 		float windStrength = 0.15f;
-		float windFrequency = 0.3f;
 
 		// Cliff avoidance — blades on slopes steeper than slopeThresholdDeg
 		// fade to zero scale over slopeFalloffDeg degrees in Grass.vert (a
@@ -148,15 +223,23 @@ namespace Nightbloom
 		// swapped blades are small enough that it isn't visible.
 		float meshLodDistance = 55.0f;
 
+		// Far field (see the header comment): past the blades, the terrain
+		// takes on their colour over the same density field, in proportion to
+		// the blades the distance LOD no longer draws. farFieldStrength is the
+		// blend on fully covered ground; below 1 some of the terrain texture
+		// shows through, as it does between real blades.
+		bool  farField = true;
+		float farFieldStrength = 0.85f;
+
 		// Per-instance color tint jitter, multiplicative around 1.0
 		float colorVariation = 0.15f;
 
 		uint32_t seed = 1337;
 
 		// Terrain world bounds — needed to scatter placement and to convert
-		// world XZ to heightmap UV in Grass.vert (no CPU height query exists,
-		// so this just describes where the heightmap texture maps in world
-		// space, the same convention TerrainSystem itself uses).
+		// world XZ to heightmap UV in Grass.vert (this just describes where
+		// the heightmap texture maps in world space, the same convention
+		// TerrainSystem itself uses).
 		glm::vec3 terrainPosition = glm::vec3(0.0f);
 		float     terrainWorldSize = 200.0f;
 		float     terrainHeightScale = 30.0f;
@@ -177,20 +260,47 @@ namespace Nightbloom
 		// up front, so Regenerate() never needs to reallocate the descriptor
 		// set (avoids the per-regenerate descriptor-set leak TerrainSystem's
 		// heightmap path has — see CLAUDE.md/ROADMAP.md notes on that).
+		// The default 400k blades take 6.4 MB at 16 bytes each.
 		//----------------------------------------------------------------------
-		bool Initialize(Renderer* renderer, uint32_t maxInstanceCount = 200000);
+		bool Initialize(Renderer* renderer, uint32_t maxInstanceCount = 400000, uint32_t maxPatchCount = 16384);
 
 		//----------------------------------------------------------------------
 		// Regenerate — rebuilds the blade mesh only if shape params changed,
-		// always re-scatters placement and re-uploads the instance buffer.
-		// Waits for device idle, same convention as TerrainSystem::Regenerate.
+		// and re-scatters placement into the instance buffer (on the GPU
+		// when IsGpuGenerationSupported, see the header comment) only if a
+		// placement param changed. Rewrites the buffers in place, so when it
+		// does either it first waits for the frames in flight to finish (not
+		// for the whole device to go idle).
 		//----------------------------------------------------------------------
 		bool Regenerate(const GrassDesc& desc);
 
+		//----------------------------------------------------------------------
+		// RegenerateRegion — re-scatters just the patches overlapping the
+		// world XZ rect [worldMin, worldMax] with the current desc, through
+		// partial uploads (see the header comment). Waits for the frames in
+		// flight like Regenerate. Returns false if nothing overlapped.
+		//----------------------------------------------------------------------
+		bool RegenerateRegion(const glm::vec2& worldMin, const glm::vec2& worldMax);
+
+		//----------------------------------------------------------------------
+		// PaintDensity — one dab of the density mask brush (world XZ centre
+		// and radius, falloff as TerrainBrush's): moves the mask `amount` of
+		// the way to `target` (0 = bare, 1 = the noise's full density), then
+		// re-scatters the patches it changed.
+		//----------------------------------------------------------------------
+		bool PaintDensity(const glm::vec2& center, float radius, float falloff, float target, float amount);
+		void ClearDensityMask();
+		bool HasDensityMask() const { return !m_DensityMask.IsEmpty(); }
+
+		// Patches the last RegenerateRegion/PaintDensity rewrote
+		uint32_t GetLastUpdatedPatchCount() const { return m_LastUpdatedPatchCount; }
+
 		//----------------------------------------------------------------------
 		// SubmitDraw — frustum-culls patches and adds one DrawCommand per
 		// visible patch to the frame draw list, picking a distance LOD tier
 		// (full/mid/far instance count) per patch. Call once per frame.
+		// With GPU culling active it instead uploads this frame's cull params
+		// and adds the two indirect draws DispatchCull fills in.
 		//
 		// terrainHeightmapSet is TerrainSystem's heightmap descriptor set
 		// (set 4) — GrassSystem has no heightmap of its own, it samples the
@@ -198,7 +308,36 @@ namespace Nightbloom
 		// must pass it through each frame.
 		//----------------------------------------------------------------------
 		void SubmitDraw(DrawList& drawList, const Frustum& frustum, VkDescriptorSet terrainHeightmapSet,
-			const glm::vec3& cameraPosition) const;
+			const glm::vec3& cameraPosition);
+
+		//----------------------------------------------------------------------
+		// DispatchCull — called by Renderer::RecordCommandBuffer before the
+		// render passes. Clears this frame's draw counters and runs the cull
+		// shader if SubmitDraw queued GPU draws this frame. Returns true if it
+		// dispatched; the Renderer's render graph places the compute->indirect
+		// and compute->vertex barriers on the buffers below.
+		//----------------------------------------------------------------------
+		bool DispatchCull(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
+
+		VkBuffer GetIndirectBuffer() const;
+		VkDeviceSize GetIndirectBufferSize() const;
+		VkBuffer GetDrawCountBuffer() const;
+		VkDeviceSize GetDrawCountBufferSize() const;
+		VkBuffer GetPatchLodBuffer() const;
+		VkDeviceSize GetPatchLodBufferSize() const;
+
+		// GPU culling is used when supported and enabled, and when the patch
+		// grid fits in maxPatchCount; otherwise the CPU loop runs.
+		bool IsGpuCullingSupported() const { return m_GpuCullingSupported; }
+		void SetGpuCulling(bool enabled) { m_GpuCullingEnabled = enabled; }
+		bool IsGpuCulling() const;
+
+		// GPU generation is used when supported and enabled, and when the
+		// patch grid fits in maxPatchCount; otherwise Regenerate scatters on
+		// the CPU. Takes effect on the next Regenerate.
+		bool IsGpuGenerationSupported() const { return m_GpuGenerationSupported; }
+		void SetGpuGeneration(bool enabled) { m_GpuGenerationEnabled = enabled; }
+		bool IsGpuGenerationEnabled() const { return m_GpuGenerationEnabled; }
 
 		//----------------------------------------------------------------------
 		// Shutdown — must be called before Renderer shuts down
@@ -210,17 +349,31 @@ namespace Nightbloom
 		uint32_t GetPatchCount() const { return static_cast<uint32_t>(m_Patches.size()); }
 		const GrassDesc& GetDesc() const { return m_CurrentDesc; }
 
-	private:
-		struct GrassPatch
-		{
-			glm::vec3 center;
-			glm::vec3 extents;
-			uint32_t  firstInstance;
-			uint32_t  fullCount;   // total blades in this patch (priority-sorted)
-		};
+		// This frame's far-field params (lod.w = 0 when off or not ready)
+		GrassFarFieldParams BuildFarFieldParams() const;
 
+	private:
 		bool BuildBladeMesh(uint32_t segments, float baseHalfWidth, float taperPower, float minTipWidthFraction, float bendAmount);
+		GrassScatterSettings BuildScatterSettings(const GrassDesc& desc) const;
 		void GenerateInstances(const GrassDesc& desc);
+		bool GenerateInstancesGpu(const GrassDesc& desc);
+		void ResetPatchRanges(const GrassScatterSettings& settings);
+		void WaitForFramesInFlight();
+		bool CreateCullResources(uint32_t maxPatchCount);
+		// Storage set 1 of a grass draw: pushed buffers, or the allocated set
+		void SetStorageBindings(DrawCommand& cmd) const;
+		bool CreateGenerateResources(uint32_t maxPatchCount);
+		bool CreateComputePipeline(const char* shaderFile, const VkDescriptorSetLayout* setLayouts,
+			uint32_t setLayoutCount, uint32_t pushConstantSize, VkPipelineLayout& layoutOut, VkPipeline& pipelineOut);
+
+		// Shared push-constant block for both paths (see Grass.vert)
+		glm::mat4 BuildTerrainBounds() const;
+		glm::vec4 BuildWindParams() const;
+
+		void SubmitCpuDraws(DrawList& drawList, const Frustum& frustum, VkDescriptorSet terrainHeightmapSet,
+			const glm::vec3& cameraPosition) const;
+		void SubmitGpuDraws(DrawList& drawList, const Frustum& frustum, VkDescriptorSet terrainHeightmapSet,
+			const glm::vec3& cameraPosition);
 
 		Renderer* m_Renderer = nullptr;
 		ResourceManager* m_Resources = nullptr;
@@ -242,12 +395,52 @@ namespace Nightbloom
 
 		// Per-instance storage buffer — sized once for m_MaxInstanceCount
 		VulkanBuffer* m_InstanceBuffer = nullptr; // owned by ResourceManager's named buffer cache
-		VkDescriptorSet m_StorageDescriptorSet = VK_NULL_HANDLE;
+		VkDescriptorSet m_StorageDescriptorSet = VK_NULL_HANDLE;   // null with push descriptors
+		VkDescriptorBufferInfo m_StorageBuffers[2] = {};             // instances, patch LOD
 		uint32_t m_MaxInstanceCount = 0;
 		uint32_t m_ActiveInstanceCount = 0;
 
 		std::vector<GrassPatch> m_Patches;
 
+		// Incremental updates. Each patch owns m_PatchCapacity[i] instances
+		// from its firstInstance (its blades plus any slack); everything from
+		// m_InstanceEnd up is unused. m_CellPatches maps a grid cell
+		// (pz * patchesPerSide + px) to its patch, or NO_PATCH.
+		static constexpr uint32_t NO_PATCH = ~0u;
+		GrassDensityMask m_DensityMask;
+		std::vector<uint32_t> m_PatchCapacity;
+		std::vector<uint32_t> m_CellPatches;
+		uint32_t m_InstanceEnd = 0;
+		uint32_t m_LastUpdatedPatchCount = 0;
+		bool m_GeneratedOnGpu = false;
+		bool m_GpuGenerationUsed = false;   // what the last scatter asked for
+
+		// GPU cull pass (GrassCull.comp). The indirect, count and patch-LOD
+		// buffers are single allocations split into per-frame regions; only
+		// the params UBO (and so the descriptor set) is double-buffered.
+		VulkanBuffer* m_PatchBuffer = nullptr;      // owned by ResourceManager
+		VulkanBuffer* m_IndirectBuffer = nullptr;   // owned by ResourceManager
+		VulkanBuffer* m_DrawCountBuffer = nullptr;  // owned by ResourceManager
+		VulkanBuffer* m_PatchLodBuffer = nullptr;   // owned by ResourceManager
+		VulkanBuffer* m_CullParamsBuffers[MAX_FRAMES_IN_FLIGHT] = {};
+		VkDescriptorSet m_CullDescriptorSets[MAX_FRAMES_IN_FLIGHT] = {};
+		VkPipeline       m_CullPipeline = VK_NULL_HANDLE;
+		VkPipelineLayout m_CullPipelineLayout = VK_NULL_HANDLE;
+		uint32_t m_MaxPatchCount = 0;
+		bool m_GpuCullingSupported = false;
+		bool m_GpuCullingEnabled = true;
+		bool m_CullPending[MAX_FRAMES_IN_FLIGHT] = {};
+
+		// GPU generation (GrassGenerate.comp). Writes m_InstanceBuffer and
+		// m_PatchBuffer; the patch table is copied back through the readback
+		// buffer so m_Patches stays valid for the CPU paths.
+		VulkanBuffer* m_PatchReadbackBuffer = nullptr; // owned by ResourceManager
+		VkDescriptorSet  m_GenerateDescriptorSet = VK_NULL_HANDLE;
+		VkPipeline       m_GeneratePipeline = VK_NULL_HANDLE;
+		VkPipelineLayout m_GeneratePipelineLayout = VK_NULL_HANDLE;
+		bool m_GpuGenerationSupported = false;
+		bool m_GpuGenerationEnabled = true;
+
 		GrassDesc m_CurrentDesc;
 		bool m_Ready = false;
 		bool m_MeshBuilt = false;
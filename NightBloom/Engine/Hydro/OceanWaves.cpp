@@ -0,0 +1,435 @@
+//------------------------------------------------------------------------------
+// OceanWaves.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Hydro/OceanWaves.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t OCEAN_LOCAL_SIZE = 8;      // OceanSpectrum.comp, OceanResolve.comp
+		constexpr uint32_t OCEAN_MIN_RESOLUTION = 64;
+		constexpr uint32_t OCEAN_MAX_RESOLUTION = 512; // OceanFFT.comp's shared line
+		constexpr const char* OCEAN_PARAMS_BUFFER = "OceanParams";
+
+		// Matches OceanPush in ocean.glsl
+		struct OceanPushConstants
+		{
+			glm::vec4 cascadeLengths;
+			glm::vec4 wind;      // direction xy, speed (m/s), amplitude
+			glm::vec4 params;    // time, choppiness, foam, shortest wavelength kept
+			glm::ivec4 grid;     // N, cascade count, FFT direction (0 = rows, 1 = columns), log2(N)
+		};
+		static_assert(sizeof(OceanPushConstants) == 64, "Must match ocean.glsl");
+
+		// Matches OceanParams in Water.vert/.frag (std140)
+		struct OceanParamsData
+		{
+			glm::vec4 cascadeLengths;
+			glm::vec4 vertexWeights;  // how much each cascade displaces the vertices
+			glm::ivec4 info;          // x = cascade count (0 = not simulating), y = N
+		};
+
+		uint32_t Log2(uint32_t value)
+		{
+			uint32_t log = 0;
+			while ((1u << (log + 1)) <= value) ++log;
+			return log;
+		}
+	}
+
+	bool OceanWaves::Initialize(Renderer* renderer)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Water);
+
+		if (!renderer)
+		{
+			LOG_ERROR("OceanWaves::Initialize — null renderer");
+			return false;
+		}
+
+		m_Renderer = renderer;
+		m_DescriptorManager = renderer->GetDescriptorManager();
+		ResourceManager* resources = renderer->GetResourceManager();
+		if (!m_DescriptorManager || !resources)
+		{
+			LOG_ERROR("OceanWaves::Initialize — renderer subsystems not ready");
+			return false;
+		}
+
+		m_ParamsBuffer = resources->CreateUniformBuffer(OCEAN_PARAMS_BUFFER, sizeof(OceanParamsData));
+		m_ComputeSet = m_DescriptorManager->AllocateOceanComputeSet();
+		m_SampleSet = m_DescriptorManager->AllocateOceanSampleSet();
+		if (!m_ParamsBuffer || m_ComputeSet == VK_NULL_HANDLE || m_SampleSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("OceanWaves: failed to create the params buffer or descriptor sets");
+			return false;
+		}
+
+		// Without the passes the maps stay placeholders (FFT mode unavailable)
+		m_CanSimulate = CreatePipelines();
+		if (!m_CanSimulate)
+		{
+			LOG_WARN("OceanWaves: failed to create compute pipelines - FFT waves disabled");
+		}
+
+		return true;
+	}
+
+	void OceanWaves::Shutdown()
+	{
+		if (!m_Renderer)
+			return;
+
+		DestroyImages();
+
+		VkDevice device = m_Renderer->GetVkDevice();
+		for (VkPipeline* pipeline : { &m_SpectrumPipeline, &m_FFTPipeline, &m_ResolvePipeline })
+		{
+			if (*pipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, *pipeline, nullptr);
+				*pipeline = VK_NULL_HANDLE;
+			}
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_ParamsBuffer)
+		{
+			if (ResourceManager* resources = m_Renderer->GetResourceManager())
+				resources->DestroyBuffer(OCEAN_PARAMS_BUFFER);
+			m_ParamsBuffer = nullptr;
+		}
+
+		m_Simulating = false;
+		m_CanSimulate = false;
+		m_Renderer = nullptr;
+	}
+
+	bool OceanWaves::Configure(const OceanWaveDesc& desc, bool simulate, float vertexSpacing)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Water);
+
+		if (!m_Renderer)
+			return false;
+
+		simulate = simulate && m_CanSimulate;
+
+		uint32_t resolution = 1;
+		uint32_t cascadeCount = 1;
+		if (simulate)
+		{
+			// Power of two within what the FFT's shared line holds
+			resolution = std::clamp(desc.resolution, OCEAN_MIN_RESOLUTION, OCEAN_MAX_RESOLUTION);
+			resolution = 1u << Log2(resolution);
+			cascadeCount = std::clamp(desc.cascadeCount, 1u, OCEAN_MAX_CASCADES);
+		}
+
+		const bool resize = !m_Displacement || resolution != m_Resolution || cascadeCount != m_CascadeCount;
+		if (resize)
+		{
+			DestroyImages();
+			if (!CreateImages(resolution, cascadeCount))
+			{
+				DestroyImages();
+				m_Simulating = false;
+				return false;
+			}
+		}
+
+		m_Simulating = simulate;
+		m_Resolution = resolution;
+		m_CascadeCount = cascadeCount;
+		m_CascadeLengths = glm::max(desc.cascadeLengths, glm::vec3(1.0f));
+
+		// A cascade only moves the vertices when the grid resolves it; finer
+		// ones (a patch under ~16 grid cells) are left to the fragment normals
+		OceanParamsData params{};
+		params.cascadeLengths = glm::vec4(m_CascadeLengths, 0.0f);
+		for (uint32_t c = 0; c < m_CascadeCount; ++c)
+		{
+			const float cells = m_CascadeLengths[c] / std::max(vertexSpacing, 0.001f);
+			params.vertexWeights[c] = std::clamp((cells - 8.0f) / 8.0f, 0.0f, 1.0f);
+		}
+		params.info = glm::ivec4(m_Simulating ? static_cast<int>(m_CascadeCount) : 0,
+			static_cast<int>(m_Resolution), 0, 0);
+		m_ParamsBuffer->Update(&params, sizeof(params));
+
+		if (m_Simulating)
+		{
+			LOG_INFO("OceanWaves configured ({} cascades of {}x{})", m_CascadeCount, m_Resolution, m_Resolution);
+		}
+		return true;
+	}
+
+	bool OceanWaves::CreateImages(uint32_t resolution, uint32_t cascadeCount)
+	{
+		auto* vkDevice = static_cast<VulkanDevice*>(m_Renderer->GetDevice());
+
+		TextureDesc texDesc{};
+		texDesc.width = resolution;
+		texDesc.height = resolution;
+		texDesc.depth = 1;
+		texDesc.mipLevels = 1;
+		texDesc.generateMips = false;
+		texDesc.force3D = false;
+
+		auto createMap = [&](const char* label, TextureFormat format, TextureUsage usage, uint32_t layers) -> VulkanTexture*
+		{
+			texDesc.format = format;
+			texDesc.usage = usage;
+			texDesc.arrayLayers = layers;
+			auto* tex = new VulkanTexture(vkDevice, m_Renderer->GetMemoryManager());
+			if (!tex->Initialize(texDesc))
+			{
+				LOG_ERROR("OceanWaves: failed to initialize the {} map ({}x{}x{})", label, resolution, resolution, layers);
+				delete tex;
+				return nullptr;
+			}
+			return tex;
+		};
+
+		// VulkanTexture only makes an array view for more than one layer, and
+		// the shaders read arrays, so a single cascade still gets two
+		const uint32_t mapLayers = std::max(cascadeCount, 2u);
+		m_Spectrum = createMap("spectrum", TextureFormat::RGBA32F, TextureUsage::Storage, cascadeCount * 2);
+		m_Displacement = createMap("displacement", TextureFormat::RGBA16F,
+			TextureUsage::Storage | TextureUsage::Sampled, mapLayers);
+		m_Derivatives = createMap("derivatives", TextureFormat::RGBA16F,
+			TextureUsage::Storage | TextureUsage::Sampled, mapLayers);
+		if (!m_Spectrum || !m_Displacement || !m_Derivatives)
+			return false;
+
+		// The maps sit in SHADER_READ_ONLY between frames (where the Water
+		// pipeline's set 3 expects them), so start them there
+		{
+			VulkanSingleTimeCommand cmd(vkDevice, m_Renderer->GetResourceManager()->GetTransferCommandPool());
+			VkCommandBuffer commandBuffer = cmd.Begin();
+
+			std::array<VkImageMemoryBarrier, 2> barriers{};
+			const VkImage images[] = { m_Displacement->GetImage(), m_Derivatives->GetImage() };
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				VkImageMemoryBarrier& barrier = barriers[i];
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = images[i];
+				barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				barrier.subresourceRange.levelCount = 1;
+				barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			}
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+				VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+			cmd.End();
+		}
+
+		// New sets rather than rewriting the current ones, which frames in
+		// flight may still have bound (to the old maps)
+		VkDescriptorSet computeSet = m_DescriptorManager->AllocateOceanComputeSet();
+		VkDescriptorSet sampleSet = m_DescriptorManager->AllocateOceanSampleSet();
+		if (computeSet == VK_NULL_HANDLE || sampleSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("OceanWaves: failed to allocate descriptor sets for the new maps");
+			m_DescriptorManager->FreeDescriptorSet(computeSet);
+			m_DescriptorManager->FreeDescriptorSet(sampleSet);
+			return false;
+		}
+
+		VulkanDescriptorManager::OceanWaveImages images{};
+		images.spectrumView = m_Spectrum->GetImageView();
+		images.displacementView = m_Displacement->GetImageView();
+		images.derivativesView = m_Derivatives->GetImageView();
+		images.sampler = m_Displacement->GetSampler();
+		images.paramsBuffer = m_ParamsBuffer->GetBuffer();
+		images.paramsSize = sizeof(OceanParamsData);
+		m_DescriptorManager->UpdateOceanComputeSet(computeSet, images);
+		m_DescriptorManager->UpdateOceanSampleSet(sampleSet, images);
+
+		ResourceManager* resources = m_Renderer->GetResourceManager();
+		resources->DeferFreeDescriptorSet(m_ComputeSet);
+		resources->DeferFreeDescriptorSet(m_SampleSet);
+		m_ComputeSet = computeSet;
+		m_SampleSet = sampleSet;
+		return true;
+	}
+
+	void OceanWaves::DestroyImages()
+	{
+		// Frames in flight may still sample the maps
+		ResourceManager* resources = m_Renderer ? m_Renderer->GetResourceManager() : nullptr;
+		for (VulkanTexture** tex : { &m_Spectrum, &m_Displacement, &m_Derivatives })
+		{
+			if (resources)
+				resources->DeferDestroy(*tex);
+			else
+				delete *tex;
+			*tex = nullptr;
+		}
+		m_Resolution = 0;
+		m_CascadeCount = 0;
+	}
+
+	VkImage OceanWaves::GetDisplacementImage() const
+	{
+		return m_Displacement ? m_Displacement->GetImage() : VK_NULL_HANDLE;
+	}
+
+	VkImage OceanWaves::GetDerivativesImage() const
+	{
+		return m_Derivatives ? m_Derivatives->GetImage() : VK_NULL_HANDLE;
+	}
+
+	bool OceanWaves::CreatePipelines()
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		VkPushConstantRange pushRange{};
+		pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushRange.offset = 0;
+		pushRange.size = sizeof(OceanPushConstants);
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetOceanComputeSetLayout();
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &setLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushRange;
+
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("OceanWaves: failed to create pipeline layout");
+			return false;
+		}
+
+		m_SpectrumPipeline = CreatePipeline("OceanSpectrum.comp.spv");
+		m_FFTPipeline = CreatePipeline("OceanFFT.comp.spv");
+		m_ResolvePipeline = CreatePipeline("OceanResolve.comp.spv");
+		return m_SpectrumPipeline != VK_NULL_HANDLE && m_FFTPipeline != VK_NULL_HANDLE &&
+			m_ResolvePipeline != VK_NULL_HANDLE;
+	}
+
+	VkPipeline OceanWaves::CreatePipeline(const char* shaderName)
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("OceanWaves: failed to load {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("OceanWaves: failed to create shader module for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("OceanWaves: failed to create compute pipeline for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, shaderName);
+		return pipeline;
+	}
+
+	void OceanWaves::Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const OceanWaveDesc& desc, float time)
+	{
+		if (!m_Simulating || !dispatcher || !m_Spectrum || m_PipelineLayout == VK_NULL_HANDLE)
+			return;
+
+		const float windAngle = glm::radians(desc.windAngle);
+
+		OceanPushConstants push{};
+		push.cascadeLengths = glm::vec4(m_CascadeLengths, 0.0f);
+		push.wind = glm::vec4(std::cos(windAngle), std::sin(windAngle), std::max(desc.windSpeed, 0.1f), desc.amplitude);
+		// Shortest wavelength kept: two texels of the finest cascade
+		const float finest = m_CascadeLengths[m_CascadeCount - 1];
+		push.params = glm::vec4(time, desc.choppiness, desc.foam, 2.0f * finest / static_cast<float>(m_Resolution));
+		push.grid = glm::ivec4(static_cast<int>(m_Resolution), static_cast<int>(m_CascadeCount), 0,
+			static_cast<int>(Log2(m_Resolution)));
+
+		// Every texel is rewritten each frame, so the old contents are dropped.
+		// On the async compute queue the maps were released to graphics last
+		// frame and never handed back, so they start from UNDEFINED there.
+		const VkImageLayout mapLayout = m_Renderer->IsAsyncComputeEnabled()
+			? VK_IMAGE_LAYOUT_UNDEFINED
+			: VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		dispatcher->TransitionImageForComputeWrite(cmd, m_Spectrum->GetImage(), VK_IMAGE_LAYOUT_UNDEFINED);
+		dispatcher->TransitionImageForComputeWrite(cmd, m_Displacement->GetImage(), mapLayout);
+		dispatcher->TransitionImageForComputeWrite(cmd, m_Derivatives->GetImage(), mapLayout);
+
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, m_ComputeSet);
+
+		const uint32_t groups = ComputeDispatcher::CalculateGroupCount(m_Resolution, OCEAN_LOCAL_SIZE);
+
+		// Spectrum at this time, one z slice per cascade
+		dispatcher->BindPipeline(cmd, m_SpectrumPipeline);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd, groups, groups, m_CascadeCount);
+
+		// Rows, then columns: one workgroup per line of every layer
+		dispatcher->BindPipeline(cmd, m_FFTPipeline);
+		for (int direction = 0; direction < 2; ++direction)
+		{
+			dispatcher->ComputeToComputeImageBarrier(cmd, m_Spectrum->GetImage());
+			push.grid.z = direction;
+			dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+			dispatcher->Dispatch(cmd, m_Resolution, m_CascadeCount * 2, 1);
+		}
+
+		dispatcher->ComputeToComputeImageBarrier(cmd, m_Spectrum->GetImage());
+		dispatcher->BindPipeline(cmd, m_ResolvePipeline);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd, groups, groups, m_CascadeCount);
+	}
+
+} // namespace Nightbloom
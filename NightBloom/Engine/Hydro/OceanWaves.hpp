@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// OceanWaves.hpp
+//
+// GPU FFT ocean (Tessendorf) for WaterSystem's FFT wave mode. Each cascade is
+// a square, tiling patch of cascadeLengths[c] world units simulated on an
+// N x N grid; the cascades split the spectrum into disjoint wavenumber bands
+// (long swell in the first, ripples in the last) so a few small FFTs cover
+// both near and far water without visible tiling. Per frame, three compute
+// passes:
+//   - OceanSpectrum.comp: the time-evolved complex spectrum of height,
+//     horizontal displacement and their derivatives, four real fields packed
+//     per complex lane (two layers per cascade)
+//   - OceanFFT.comp, twice: inverse FFT along the rows, then the columns,
+//     one workgroup per line in shared memory
+//   - OceanResolve.comp: the displacement map (x, height, z, foam from the
+//     Jacobian) and the derivative map (slopes + horizontal stretch) that
+//     Water.vert and Water.frag sample (set 3 of the Water pipeline)
+//
+// Nothing is uploaded per frame: the initial spectrum is a hash of the wave
+// index, so it is recomputed in the spectrum pass instead of stored, and the
+// wind/amplitude/choppiness ride in push constants. The passes run on the
+// async compute queue when there is one (Renderer::RecordAsyncComputePass).
+//
+// With simulation off (the water's Normals mode) the maps shrink to one
+// texel and are never written: set 3 stays valid and the shaders skip it
+// (OceanParams.info.x == 0).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class Renderer;
+	class ComputeDispatcher;
+	class VulkanBuffer;
+	class VulkanTexture;
+	class VulkanDescriptorManager;
+
+	constexpr uint32_t OCEAN_MAX_CASCADES = 3;
+
+	struct OceanWaveDesc
+	{
+		// Structural (changing these goes through WaterSystem::Regenerate)
+		uint32_t  resolution     = 256;  // FFT size per cascade: 64, 128, 256 or 512
+		uint32_t  cascadeCount   = 3;    // 1-3
+		glm::vec3 cascadeLengths = glm::vec3(250.0f, 37.0f, 7.0f);  // patch size per cascade, far to near (world units)
+
+		// Live (push constants)
+		float     windSpeed      = 10.0f;  // m/s; sets the dominant wavelength
+		float     windAngle      = 30.0f;  // degrees from +X
+		float     amplitude      = 1.0f;   // spectrum scale
+		float     choppiness     = 1.2f;   // horizontal displacement strength (sharper crests)
+		float     foam           = 0.8f;   // foam where the surface folds (Jacobian < 1)
+	};
+
+	class OceanWaves
+	{
+	public:
+		OceanWaves() = default;
+		~OceanWaves() = default;
+
+		OceanWaves(const OceanWaves&) = delete;
+		OceanWaves& operator=(const OceanWaves&) = delete;
+
+		bool Initialize(Renderer* renderer);
+		void Shutdown();
+
+		// (Re)creates the maps for desc's resolution and cascades, or one-texel
+		// placeholders with simulate off. vertexSpacing is the water grid's,
+		// which decides how much of each cascade moves the vertices (the rest
+		// only shades). Replaced maps and sets are released once the frames
+		// in flight are done with them.
+		bool Configure(const OceanWaveDesc& desc, bool simulate, float vertexSpacing);
+
+		// False when the compute passes failed to build (Configure then
+		// only makes placeholders)
+		bool CanSimulate() const { return m_CanSimulate; }
+		bool IsSimulating() const { return m_Simulating; }
+
+		// Records the three passes. desc supplies the live fields; the
+		// structural ones stay as configured. Leaves both maps in GENERAL
+		// with the writes done; the caller hands them to graphics (a barrier
+		// or a queue release to SHADER_READ_ONLY).
+		void Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const OceanWaveDesc& desc, float time);
+
+		VkImage GetDisplacementImage() const;
+		VkImage GetDerivativesImage() const;
+
+		// Water set 3 (VulkanDescriptorManager's ocean sample layout)
+		VkDescriptorSet GetSampleSet() const { return m_SampleSet; }
+
+	private:
+		bool CreatePipelines();
+		VkPipeline CreatePipeline(const char* shaderName);
+		bool CreateImages(uint32_t resolution, uint32_t cascadeCount);
+		void DestroyImages();
+
+		Renderer*                m_Renderer = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		// Spectrum: 2 layers per cascade (RGBA32F); displacement and
+		// derivatives: 1 layer per cascade (RGBA16F, sampled by Water)
+		VulkanTexture* m_Spectrum = nullptr;
+		VulkanTexture* m_Displacement = nullptr;
+		VulkanTexture* m_Derivatives = nullptr;
+		VulkanBuffer*  m_ParamsBuffer = nullptr;  // OceanParams, owned by ResourceManager
+
+		VkDescriptorSet m_ComputeSet = VK_NULL_HANDLE;
+		VkDescriptorSet m_SampleSet = VK_NULL_HANDLE;
+
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline       m_SpectrumPipeline = VK_NULL_HANDLE;
+		VkPipeline       m_FFTPipeline = VK_NULL_HANDLE;
+		VkPipeline       m_ResolvePipeline = VK_NULL_HANDLE;
+
+		uint32_t  m_Resolution = 0;
+		uint32_t  m_CascadeCount = 0;
+		glm::vec3 m_CascadeLengths = glm::vec3(0.0f);
+		bool      m_CanSimulate = false;
+		bool      m_Simulating = false;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// WaterLod.hpp
+//
+// The water plane's level-of-detail grid. The plane is covered by CDLOD
+// patches around the camera, selected by the terrain's quadtree
+// (TerrainQuadtree.hpp) over the water square with a flat height range. Every
+// patch is the same patchQuads x patchQuads grid drawn without a vertex buffer
+// (GridMesh.hpp), one instance each; the finest level's cells are at most
+// cellSize wide and each coarser level doubles them. The quadtree's nodes are
+// fixed, so the fine region moves with the camera in whole-patch steps, and
+// patches morph onto the next-coarser grid over the end of their range
+// (Water.vert) so those steps don't pop.
+//
+// The vertex count follows the camera's distance to the surface rather than
+// the plane's size: a plane 40x as wide only adds a handful of levels, each
+// one ring of patches around the finer ones.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Terrain/TerrainQuadtree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class WaterLod
+	{
+	public:
+		static constexpr uint32_t MIN_PATCH_QUADS = 4;
+		static constexpr uint32_t MAX_PATCH_QUADS = 128;
+
+		// Even, so a fully morphed patch lands exactly on the next-coarser grid
+		static uint32_t GetPatchQuads(uint32_t requested)
+		{
+			const uint32_t quads = std::clamp(requested, MIN_PATCH_QUADS, MAX_PATCH_QUADS);
+			return (quads + 1) & ~1u;
+		}
+
+		// Enough levels for the finest cells to be at most cellSize wide
+		static uint32_t GetLevelCount(float worldSize, uint32_t patchQuads, float cellSize)
+		{
+			const float leafSize = static_cast<float>(GetPatchQuads(patchQuads)) * std::max(cellSize, 1e-3f);
+			const float ratio = std::max(worldSize / leafSize, 1.0f);
+			const uint32_t levels = 1 + static_cast<uint32_t>(std::ceil(std::log2(ratio)));
+			return std::min(levels, TerrainQuadtree::MAX_LEVELS);
+		}
+
+		// Width of the finest level's cells (at most cellSize, unless the
+		// level count ran into TerrainQuadtree::MAX_LEVELS)
+		static float GetFinestCellSize(float worldSize, uint32_t patchQuads, float cellSize)
+		{
+			const uint32_t levels = GetLevelCount(worldSize, patchQuads, cellSize);
+			return worldSize / static_cast<float>(1u << (levels - 1)) / static_cast<float>(GetPatchQuads(patchQuads));
+		}
+
+		static TerrainQuadtreeSettings MakeQuadtreeSettings(float worldSize, uint32_t patchQuads, float cellSize,
+			float lodRangeScale)
+		{
+			TerrainQuadtreeSettings settings;
+			settings.worldSize = worldSize;
+			settings.heightScale = 0.0f;   // ranges are measured to the flat surface
+			settings.levels = GetLevelCount(worldSize, patchQuads, cellSize);
+			settings.lodRangeScale = lodRangeScale;
+			return settings;
+		}
+	};
+}
@@ -3,17 +3,22 @@
 //------------------------------------------------------------------------------
 
 #include "Engine/Hydro/WaterSystem.hpp"
-#include "Engine/Terrain/TerrainMesh.hpp"   // flat grid generator, reused for the water plane
+#include "Engine/Renderer/GridMesh.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 namespace Nightbloom
 {
 	bool WaterSystem::Initialize(Renderer* renderer)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Water);
+
 		if (!renderer)
 		{
 			LOG_ERROR("WaterSystem::Initialize — null renderer");
@@ -29,26 +34,56 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Without the wave maps the Water pipeline's set 3 has nothing to
+		// bind, but the plane still draws
+		m_WavesInitialized = m_Waves.Initialize(renderer);
+		if (!m_WavesInitialized)
+		{
+			LOG_WARN("WaterSystem: ocean waves unavailable");
+		}
+
 		LOG_INFO("WaterSystem initialized");
 		return true;
 	}
 
 	bool WaterSystem::Regenerate(const WaterDesc& desc)
 	{
-		m_Ready = false;
-		m_SkipNextDraw = true;
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Water);
 
-		m_Renderer->WaitForIdle();
+		// Frames in flight keep drawing the old mesh and wave maps, which
+		// are only released once they have finished
+		m_Ready = false;
 
-		bool needsMesh = !m_MeshBuilt
-			|| desc.resolution != m_CurrentDesc.resolution
-			|| desc.worldSize != m_CurrentDesc.worldSize;
+		const uint32_t patchQuads = WaterLod::GetPatchQuads(desc.patchQuads);
+		bool needsMesh = !m_MeshBuilt || patchQuads != m_GridQuads;
 
 		if (needsMesh)
 		{
-			if (!BuildPlaneMesh(desc.resolution, desc.worldSize))
+			if (!BuildPatchMesh(patchQuads))
+			{
+				LOG_ERROR("WaterSystem::Regenerate — failed to build patch mesh");
+				return false;
+			}
+		}
+
+		// The wave maps follow the mode and the ocean's structure; the
+		// finest grid spacing decides which cascades move the vertices
+		const OceanWaveDesc& ocean = desc.ocean;
+		const OceanWaveDesc& currentOcean = m_CurrentDesc.ocean;
+		bool needsWaves = m_WavesInitialized && (needsMesh
+			|| desc.worldSize != m_CurrentDesc.worldSize
+			|| desc.cellSize != m_CurrentDesc.cellSize
+			|| desc.waveMode != m_CurrentDesc.waveMode
+			|| ocean.resolution != currentOcean.resolution
+			|| ocean.cascadeCount != currentOcean.cascadeCount
+			|| ocean.cascadeLengths != currentOcean.cascadeLengths);
+
+		if (needsWaves)
+		{
+			const float spacing = WaterLod::GetFinestCellSize(desc.worldSize, patchQuads, desc.cellSize);
+			if (!m_Waves.Configure(ocean, desc.waveMode == WaterWaveMode::FFT, spacing))
 			{
-				LOG_ERROR("WaterSystem::Regenerate — failed to build plane mesh");
+				LOG_ERROR("WaterSystem::Regenerate — failed to create the ocean wave maps");
 				return false;
 			}
 		}
@@ -58,27 +93,30 @@ namespace Nightbloom
 		return true;
 	}
 
-	void WaterSystem::SubmitDraw(DrawList& drawList) const
+	void WaterSystem::SubmitDraw(DrawList& drawList, const Frustum* frustum) const
 	{
-		if (m_SkipNextDraw) { m_SkipNextDraw = false; return; }
-
-		if (!m_Ready || !m_VertexBuffer || !m_IndexBuffer || m_IndexCount == 0)
+		if (!m_Ready || !m_IndexBuffer || m_IndexCount == 0 || m_Patches.empty())
 			return;
 
 		DrawCommand cmd;
 		cmd.pipeline = PipelineType::Water;
-		cmd.vertexBuffer = m_VertexBuffer.get();
-		cmd.indexBuffer = m_IndexBuffer.get();
+		cmd.indexBuffer = m_IndexBuffer;
 		cmd.indexCount = m_IndexCount;
-		cmd.instanceCount = 1;
 
-		// The plane mesh is generated flat at Y=0; the model matrix lifts it to
-		// the water surface height and centres it.
+		// One instance per selected patch; Water.vert reads the records
+		// through the instance buffer
+		static_assert(sizeof(TerrainPatch) == sizeof(InstanceData), "TerrainPatch must fill one instance slot");
+		cmd.instanceCount = static_cast<uint32_t>(m_Patches.size());
+		cmd.instanceData = m_Patches.data();
+
+		// The patches are flat at Y=0 around the plane's centre; the model
+		// matrix lifts them to the water surface height and centres them.
 		glm::vec3 origin = m_CurrentDesc.position;
 		origin.y = m_CurrentDesc.waterY;
 
 		cmd.hasPushConstants = true;
 		cmd.pushConstants.model = glm::translate(glm::mat4(1.0f), origin);
+		cmd.pushConstants.gridQuads = m_GridQuads;
 		// customData = (waveAmplitude, waveSpeed, fresnelPower, alpha).
 		// Wave time itself comes from FrameUniforms.time.x (set 0).
 		cmd.pushConstants.customData = glm::vec4(
@@ -87,9 +125,37 @@ namespace Nightbloom
 			m_CurrentDesc.fresnelPower,
 			m_CurrentDesc.alpha);
 
+		// Set 3: the wave maps (placeholders outside FFT mode)
+		if (m_WavesInitialized)
+			cmd.textureDescriptorSet = m_Waves.GetSampleSet();
+
+		// The plane's bounds are flat (plus some crest height in FFT mode);
+		// the Renderer only reads them to decide whether the reflection is
+		// needed at all.
+		const float halfSize = m_CurrentDesc.worldSize * 0.5f;
+		const float waveHeight = m_Waves.IsSimulating() ? 4.0f * m_CurrentDesc.ocean.amplitude : 0.0f;
+		cmd.hasBounds = true;
+		cmd.bounds.center = origin;
+		cmd.bounds.extents = glm::vec3(halfSize, waveHeight, halfSize);
+		cmd.cameraVisible = !frustum || frustum->Intersects(cmd.bounds.center, cmd.bounds.extents);
+
 		drawList.AddCommand(cmd);
 	}
 
+	void WaterSystem::UpdateLOD(const glm::vec3& cameraPosition)
+	{
+		if (!m_Ready)
+			return;
+
+		const TerrainQuadtreeSettings settings = WaterLod::MakeQuadtreeSettings(
+			m_CurrentDesc.worldSize, m_GridQuads, m_CurrentDesc.cellSize, m_CurrentDesc.lodRangeScale);
+
+		// Water-local: centred on the plane, y = 0 at the surface
+		glm::vec3 origin = m_CurrentDesc.position;
+		origin.y = m_CurrentDesc.waterY;
+		m_Quadtree.Select(settings, cameraPosition - origin, m_Patches);
+	}
+
 	void WaterSystem::Shutdown()
 	{
 		if (m_Renderer)
@@ -101,53 +167,46 @@ namespace Nightbloom
 			m_Renderer->SetWaterSystem(nullptr);
 		}
 
-		m_VertexBuffer.reset();
-		m_IndexBuffer.reset();
+		m_Waves.Shutdown();
+		m_WavesInitialized = false;
+
+		m_IndexBuffer = nullptr;
 		m_IndexCount = 0;
+		m_GridQuads = 0;
+		m_Patches.clear();
 		m_MeshBuilt = false;
 		m_Ready = false;
 
 		LOG_INFO("WaterSystem shut down");
 	}
 
-	bool WaterSystem::BuildPlaneMesh(uint32_t resolution, float worldSize)
+	void WaterSystem::DispatchWaves(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, float time)
 	{
-		// A flat grid at Y=0 — identical to what the terrain mesh generator
-		// produces, so reuse it rather than duplicate the grid code. Resolution
-		// can stay low since the water surface is flat (waves are shader-side).
-		TerrainMeshData data = TerrainMesh::Generate(resolution, worldSize);
-
-		if (data.vertices.empty() || data.indices.empty())
-		{
-			LOG_ERROR("WaterSystem: mesh generation returned empty data");
-			return false;
-		}
-
-		VkDeviceSize vbSize = data.vertices.size() * sizeof(VertexPNT);
-		m_VertexBuffer = m_Resources->CreateVertexBufferUnique("water_vb", vbSize, false);
-		if (!m_VertexBuffer ||
-			!m_VertexBuffer->UploadData(data.vertices.data(), vbSize, 0, m_Resources->GetTransferCommandPool()))
-		{
-			LOG_ERROR("WaterSystem: failed to create/upload vertex buffer");
-			m_VertexBuffer.reset();
-			return false;
-		}
+		if (!IsSimulatingWaves())
+			return;
+		m_Waves.Dispatch(cmd, dispatcher, m_CurrentDesc.ocean, time);
+	}
 
-		VkDeviceSize ibSize = data.indices.size() * sizeof(uint32_t);
-		m_IndexBuffer = m_Resources->CreateIndexBufferUnique("water_ib", ibSize, false);
-		if (!m_IndexBuffer ||
-			!m_IndexBuffer->UploadData(data.indices.data(), ibSize, 0, m_Resources->GetTransferCommandPool()))
+	bool WaterSystem::BuildPatchMesh(uint32_t patchQuads)
+	{
+		// One diagonal direction, as the terrain's patches: a fully morphed
+		// patch then triangulates like the next-coarser level. The index
+		// buffer is shared and outlives this plane, so the old one needs no
+		// deferral.
+		Buffer* indexBuffer = m_Resources->GetGridIndexBuffer(patchQuads, false);
+		if (!indexBuffer)
 		{
-			LOG_ERROR("WaterSystem: failed to create/upload index buffer");
-			m_IndexBuffer.reset();
+			LOG_ERROR("WaterSystem: failed to create the grid index buffer");
 			return false;
 		}
 
-		m_IndexCount = data.indexCount();
+		m_IndexBuffer = indexBuffer;
+		m_IndexCount = GridMesh::GetIndexCount(patchQuads);
+		m_GridQuads = patchQuads;
 		m_MeshBuilt = true;
 
-		LOG_INFO("WaterSystem: plane mesh built ({} vertices, {} indices)",
-			data.vertexCount(), data.indexCount());
+		LOG_INFO("WaterSystem: patch grid ready ({} vertices, {} indices per patch)",
+			GridMesh::GetVertexCount(patchQuads), m_IndexCount);
 		return true;
 	}
 
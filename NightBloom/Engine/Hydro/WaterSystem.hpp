@@ -11,41 +11,92 @@
 //   water.Initialize(renderer);
 //   renderer->SetWaterSystem(&water);   // so the reflection pass knows waterY
 //   water.Regenerate(desc);             // when size/position changes
-//   water.SubmitDraw(drawList);         // each frame
+//   water.UpdateLOD(cameraPosition);    // each frame, then
+//   water.SubmitDraw(drawList, &frustum);
 //   water.Shutdown();                   // before Renderer::Shutdown
 //
-// v1 scope: planar reflection + Fresnel + sun specular + cheap animated
-// surface normals (no vertex displacement). Deep/shallow colors are currently
+// Waves come in two modes: Normals (cheap animated surface normals, no vertex
+// displacement) and FFT (OceanWaves: a GPU ocean simulation whose cascaded
+// displacement and slope maps Water.vert/.frag sample; the Renderer records
+// it each frame through DispatchWaves). Deep/shallow colors are currently
 // shader-side defaults; wave/Fresnel/alpha tunables ride in the push constant.
 // Refraction/depth-color and tunable colors are deferred follow-ups.
+//
+// The plane is drawn as a camera-centred LOD grid (WaterLod.hpp), so its
+// vertex cost stays flat as the plane grows to kilometres.
 //------------------------------------------------------------------------------
 #pragma once
 
 #include "Engine/Renderer/DrawCommandSystem.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Hydro/OceanWaves.hpp"
+#include "Engine/Hydro/WaterLod.hpp"
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 
 namespace Nightbloom
 {
 	class Renderer;
 	class ResourceManager;
+	class ComputeDispatcher;
+	struct Frustum;
+
+	// How the surface gets its reflection: Planar re-renders the opaque scene
+	// from the mirrored camera (exact, costs a second scene pass); ScreenSpace
+	// traces last frame's color and Hi-Z depth (ScreenSpaceReflections, much
+	// cheaper, nothing that is off screen gets reflected).
+	enum class WaterReflectionMode
+	{
+		Planar,
+		ScreenSpace
+	};
+
+	// Normals: scrolling sines tilt the shading normal of a flat plane.
+	// FFT: the OceanWaves simulation displaces the grid and shades its slopes
+	// (give the grid enough resolution for the displacement to show).
+	enum class WaterWaveMode
+	{
+		Normals,
+		FFT
+	};
 
 	struct WaterDesc
 	{
-		// Grid (a flat plane — waves are shader-side, so low resolution is fine)
-		uint32_t  resolution = 64;
-		float     worldSize  = 200.0f;
+		// LOD grid (WaterLod.hpp): patches of patchQuads^2 cells, the finest
+		// at most cellSize wide near the camera. Flat in Normals mode, so
+		// coarse cells are fine; FFT mode displaces the vertices of the
+		// cascades the finest cells resolve. lodRangeScale is read live.
+		uint32_t  patchQuads    = 32;
+		float     cellSize      = 0.5f;
+		float     lodRangeScale = 4.0f;   // finest level's range, in finest patch widths
+		float     worldSize     = 200.0f;
 
 		// Placement — world-space Y of the surface; position.xz centres the plane
 		float     waterY     = 8.0f;  // pools in the terrain's low areas by default
 		glm::vec3 position   = glm::vec3(0.0f);
 
+		// Waves. Changing the mode or ocean's structural fields goes through
+		// Regenerate; the rest of ocean is read live by DispatchWaves.
+		// FFT falls back to Normals when the compute passes are unavailable.
+		WaterWaveMode waveMode = WaterWaveMode::Normals;
+		OceanWaveDesc ocean;
+
 		// Surface tunables (packed into the draw push constant — see SubmitDraw)
-		float waveAmplitude = 0.04f;   // normal-perturbation strength (not vertex height)
-		float waveSpeed     = 0.6f;    // scroll speed of the animated normals
+		float waveAmplitude = 0.04f;   // Normals mode: normal-perturbation strength (not vertex height)
+		float waveSpeed     = 0.6f;    // Normals mode: scroll speed of the animated normals
 		float fresnelPower   = 5.0f;   // Schlick exponent: higher = reflective only at grazing angles
 		float alpha          = 0.85f;  // surface opacity
+
+		// Reflection (read by the Renderer each frame). ScreenSpace falls back
+		// to Planar when the renderer doesn't support it.
+		WaterReflectionMode reflectionMode = WaterReflectionMode::Planar;
+		float planarScale    = 0.5f;    // planar pass resolution as a fraction of the scene (0.25-1)
+		uint32_t reflectionInterval = 1;  // planar pass renders every Nth frame, reprojected between (1-4)
+		float planarMinSize  = 0.02f;   // props whose bounds cover less of the screen height are not reflected
+		bool  planarFoliage  = false;   // reflect the grass (one more instanced pass for little visible detail)
+		float ssrMaxDistance = 150.0f;  // world units a reflected ray is traced
+		float ssrThickness   = 1.5f;    // world units behind a surface that still count as a hit
 	};
 
 	class WaterSystem
@@ -60,18 +111,36 @@ namespace Nightbloom
 		// Initialize — call once after the Renderer is ready.
 		bool Initialize(Renderer* renderer);
 
-		// Regenerate — rebuilds the plane mesh if resolution/worldSize changed.
-		// Waits for device idle (same convention as TerrainSystem::Regenerate).
+		// Regenerate — rebuilds the patch grid if patchQuads changed and the
+		// wave maps if the grid spacing or wave layout did.
+		// The old mesh and wave maps are freed once the frames in flight are
+		// done with them (same convention as TerrainSystem::Regenerate).
 		bool Regenerate(const WaterDesc& desc);
 
 		// SubmitDraw — adds the water draw command to the frame draw list.
-		void SubmitDraw(DrawList& drawList) const;
+		// With a camera frustum the plane is culled against it (the command
+		// stays in the list, marked not camera-visible), which also lets the
+		// Renderer skip the reflection pass.
+		void SubmitDraw(DrawList& drawList, const Frustum* frustum = nullptr) const;
+
+		// UpdateLOD — selects the grid patches around the camera. Call each
+		// frame before SubmitDraw; nothing is drawn until it has run.
+		void UpdateLOD(const glm::vec3& cameraPosition);
+		uint32_t GetPatchCount() const { return static_cast<uint32_t>(m_Patches.size()); }
 
 		// Shutdown — must be called before Renderer shuts down.
 		void Shutdown();
 
 		bool IsReady() const { return m_Ready; }
 
+		// FFT mode: the Renderer records the simulation before the scene pass
+		// (on the async compute queue when it has one) and hands the maps to
+		// the graphics stages that sample them.
+		bool IsSimulatingWaves() const { return m_Ready && m_Waves.IsSimulating(); }
+		bool SupportsFFTWaves() const { return m_Waves.CanSimulate(); }
+		void DispatchWaves(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, float time);
+		const OceanWaves& GetWaves() const { return m_Waves; }
+
 		// The Renderer reads this to build the mirror matrix for the reflection
 		// pass (reflect the camera across plane y = GetWaterY()).
 		float GetWaterY() const { return m_CurrentDesc.waterY; }
@@ -80,19 +149,27 @@ namespace Nightbloom
 		const WaterDesc& GetDesc() const { return m_CurrentDesc; }
 
 	private:
-		bool BuildPlaneMesh(uint32_t resolution, float worldSize);
+		bool BuildPatchMesh(uint32_t patchQuads);
 
 		Renderer*        m_Renderer = nullptr;
 		ResourceManager* m_Resources = nullptr;
 
-		std::unique_ptr<VulkanBuffer> m_VertexBuffer;
-		std::unique_ptr<VulkanBuffer> m_IndexBuffer;
-		uint32_t                      m_IndexCount = 0;
+		// The patches have no vertex buffer: Water.vert places each vertex
+		// from gl_VertexIndex, and the index list is the ResourceManager's
+		// shared one for this grid size (GridMesh.hpp)
+		Buffer*  m_IndexBuffer = nullptr;
+		uint32_t m_IndexCount = 0;
+		uint32_t m_GridQuads = 0;
+
+		TerrainQuadtree           m_Quadtree;
+		std::vector<TerrainPatch> m_Patches;   // one instance each, water-local
+
+		OceanWaves m_Waves;
+		bool       m_WavesInitialized = false;
 
 		WaterDesc m_CurrentDesc;
 		bool      m_Ready = false;
 		bool      m_MeshBuilt = false;
-		mutable bool m_SkipNextDraw = false;
 	};
 
 } // namespace Nightbloom
@@ -67,12 +67,22 @@ namespace Nightbloom
         // Reset mouse wheel (it's an event-based axis)
         m_Axes[static_cast<size_t>(AxisCode::Mouse_Wheel)].value = 0.0f;
 
+        // Events pumped after this belong to the new frame
+        m_FrameInputTime = {};
+        m_RawMotionX = 0.0f;
+        m_RawMotionY = 0.0f;
+        m_RawMotionEvents = 0;
+
         // Process any queued events
         ProcessEventQueue();
     }
 
     void InputSystem::EndFrame()
     {
+        // Raw motion is drained as late as possible so the frame sees every
+        // report up to the moment it samples input
+        DrainRawEvents();
+
         // Calculate final axis deltas
         for (auto& axis : m_Axes)
         {
@@ -251,6 +261,17 @@ namespace Nightbloom
         LOG_TRACE("Mouse wheel: {}", delta);
     }
 
+    bool InputSystem::PushRawMouseMotion(int dx, int dy, std::chrono::steady_clock::time_point timestamp)
+    {
+        InputEvent event;
+        event.type = InputEvent::MouseMotion;
+        event.motion.dx = dx;
+        event.motion.dy = dy;
+        event.device = InputDevice::Mouse;
+        event.timestamp = timestamp;
+        return m_RawEvents.TryPush(event);
+    }
+
     //--------------------------------------------------------------------------
     // Gamepad input (placeholder for future implementation)
     //--------------------------------------------------------------------------
@@ -377,6 +398,15 @@ namespace Nightbloom
             std::swap(m_EventQueue, emptyQueue);
         }
 
+        // Motion made while unfocused doesn't carry over
+        InputEvent discarded;
+        while (m_RawEvents.TryPop(discarded))
+        {
+        }
+        m_RawMotionX = 0.0f;
+        m_RawMotionY = 0.0f;
+        m_RawMotionEvents = 0;
+
         LOG_TRACE("Input state cleared");
     }
 
@@ -499,9 +529,35 @@ namespace Nightbloom
 
     void InputSystem::QueueEvent(const InputEvent& event)
     {
-        m_EventQueue.push(event);
+        InputEvent stamped = event;
+        stamped.timestamp = m_EventTimestamp != std::chrono::steady_clock::time_point{}
+            ? m_EventTimestamp : std::chrono::steady_clock::now();
+        if (!HasFrameInput() || stamped.timestamp < m_FrameInputTime)
+            m_FrameInputTime = stamped.timestamp;
+
+        m_EventQueue.push(stamped);
 
         // Later we might want to limit queue size or process immediately
         // if (m_EventQueue.size() > MAX_EVENTS) { /* handle overflow */ }
     }
+
+    void InputSystem::DrainRawEvents()
+    {
+        // Every report since the last drain adds up: at 1-8 kHz a mouse
+        // sends several per frame, and the cursor delta only sees their
+        // (accelerated, clipped) end point
+        InputEvent event;
+        while (m_RawEvents.TryPop(event))
+        {
+            m_RawMotionX += static_cast<float>(event.motion.dx);
+            m_RawMotionY += static_cast<float>(event.motion.dy);
+            ++m_RawMotionEvents;
+
+            // The oldest report is when this frame's input really started
+            if (!HasFrameInput() || event.timestamp < m_FrameInputTime)
+                m_FrameInputTime = event.timestamp;
+
+            m_EventQueue.push(event);
+        }
+    }
 }
\ No newline at end of file
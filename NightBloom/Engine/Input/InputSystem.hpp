@@ -7,8 +7,11 @@
 
 #pragma once
 
+#include "Core/SpscRing.hpp"
+#include <atomic>
 #include <bitset>
 #include <array>
+#include <chrono>
 #include <queue>
 #include <functional>
 #include <unordered_map>
@@ -134,7 +137,8 @@ namespace Nightbloom
 			ButtonPressed,
 			ButtonReleased,
 			AxisMoved,
-			TextInput
+			TextInput,
+			MouseMotion     // relative raw-input counts, not a cursor position
 		};
 
 		Type type;
@@ -143,10 +147,13 @@ namespace Nightbloom
 			struct { InputCode code; } button;
 			struct { AxisCode axis; float value; float delta; } axis;
 			struct { unsigned int character; } text;
+			struct { int dx; int dy; } motion;
 		};
 
 		InputDevice device = InputDevice::Keyboard;
-		// float timestamp;  // For later
+		// When the platform layer received it (steady_clock is QueryPerformanceCounter
+		// on Windows, so raw-input events keep their sub-frame spacing)
+		std::chrono::steady_clock::time_point timestamp{};
 	};
 
 	class InputSystem
@@ -173,6 +180,20 @@ namespace Nightbloom
 		void OnMouseMove(int x, int y);
 		void OnMouseWheel(float delta);
 
+		// Receive time for the On* calls that follow, when the platform layer
+		// replays events another thread received (default: stamped on arrival)
+		void SetEventTimestamp(std::chrono::steady_clock::time_point timestamp) { m_EventTimestamp = timestamp; }
+
+		// Raw relative mouse motion from the platform's input thread (Win32:
+		// WM_INPUT on a dedicated thread). The only call that may come from
+		// another thread, and only from one: events go through a lock-free
+		// ring and are integrated into GetMouseMotionX/Y at EndFrame. False
+		// when the ring is full and the event was dropped.
+		bool PushRawMouseMotion(int dx, int dy, std::chrono::steady_clock::time_point timestamp);
+		// Set by the platform layer while raw mouse input is being delivered
+		void SetRawMouseActive(bool active) { m_RawMouseActive.store(active, std::memory_order_release); }
+		bool IsRawMouseActive() const { return m_RawMouseActive.load(std::memory_order_acquire); }
+
 		// Gamepad (for later implementation)
 		void OnGamepadConnected(int gamepadIndex);
 		void OnGamepadDisconnected(int gamepadIndex);
@@ -185,6 +206,11 @@ namespace Nightbloom
 		void BeginFrame();
 		void EndFrame();
 
+		// Arrival time of the first event since BeginFrame (a default time
+		// point if none). Feeds the renderer's input-to-present measurement.
+		std::chrono::steady_clock::time_point GetFrameInputTime() const { return m_FrameInputTime; }
+		bool HasFrameInput() const { return m_FrameInputTime != std::chrono::steady_clock::time_point{}; }
+
 		//----------------------------------------------------------------------
 		// Unified polling API
 		//----------------------------------------------------------------------
@@ -205,6 +231,16 @@ namespace Nightbloom
 		int GetMouseDeltaY() const { return static_cast<int>(GetAxisDelta(AxisCode::Mouse_Y)); }
 		float GetMouseWheel() const { return GetAxis(AxisCode::Mouse_Wheel); }
 
+		// Relative motion this frame, for camera look: the sum of every raw
+		// mouse report that arrived since the last frame (unaccelerated, not
+		// stopped by the screen edge) when raw input is active, otherwise the
+		// cursor delta
+		float GetMouseMotionX() const { return IsRawMouseActive() ? m_RawMotionX : GetAxisDelta(AxisCode::Mouse_X); }
+		float GetMouseMotionY() const { return IsRawMouseActive() ? m_RawMotionY : GetAxisDelta(AxisCode::Mouse_Y); }
+		// Raw reports integrated into this frame's motion, and lifetime drops
+		uint32_t GetRawMouseEventCount() const { return m_RawMotionEvents; }
+		uint64_t GetRawMouseDropCount() const { return m_RawEvents.GetDroppedCount(); }
+
 		// Device queries
 		bool IsDeviceConnected(InputDevice device) const;
 		bool IsAnyDown() const;
@@ -233,6 +269,7 @@ namespace Nightbloom
 		InputCode MouseButtonToInputCode(int button) const;
 		void ProcessEventQueue();
 		void QueueEvent(const InputEvent& event);
+		void DrainRawEvents();
 
 	private:
 		// Digital state (buttons/keys)
@@ -255,6 +292,17 @@ namespace Nightbloom
 
 		// Event queue for future event system
 		std::queue<InputEvent> m_EventQueue;
+		std::chrono::steady_clock::time_point m_FrameInputTime{};
+		std::chrono::steady_clock::time_point m_EventTimestamp{};
+
+		// Raw mouse motion: producer is the platform input thread, consumer
+		// the game thread. 4096 reports is half a second at 8 kHz.
+		static constexpr size_t RAW_EVENT_CAPACITY = 4096;
+		SpscRing<InputEvent> m_RawEvents{ RAW_EVENT_CAPACITY };
+		std::atomic<bool> m_RawMouseActive{ false };
+		float m_RawMotionX = 0.0f;
+		float m_RawMotionY = 0.0f;
+		uint32_t m_RawMotionEvents = 0;
 
 		// Shutdown flag
 		bool m_IsShuttingDown = false;
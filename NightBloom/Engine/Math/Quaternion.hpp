@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+// Quaternion.hpp
+//
+// SIMD quaternion kernels for animation blending on glm::quat, with the same
+// compile-time path selection as SimdMath.hpp (SSE2, NEON or scalar glm).
+// Normalized lerp rather than slerp: poses are blended per joint every frame
+// for every character, and for the small angles between neighbouring keys
+// and blended clips nlerp is indistinguishable and much cheaper.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Math/SimdMath.hpp"
+#include <glm/gtc/quaternion.hpp>
+
+namespace Nightbloom
+{
+	namespace Simd
+	{
+		// normalize(a + (b - a) * t), with b negated first when it is in the
+		// other hemisphere so the blend takes the short way round. a and b
+		// must be unit quaternions.
+		inline glm::quat Nlerp(const glm::quat& a, const glm::quat& b, float t)
+		{
+			glm::quat out;
+#if defined(NB_SIMD_SSE)
+			const __m128 qa = _mm_loadu_ps(&a[0]);
+			__m128 qb = _mm_loadu_ps(&b[0]);
+
+			// dot(a, b) in every lane
+			__m128 dot = _mm_mul_ps(qa, qb);
+			dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+			dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+			qb = _mm_xor_ps(qb, _mm_and_ps(dot, _mm_set1_ps(-0.0f)));
+
+			const __m128 blend = _mm_add_ps(qa, _mm_mul_ps(_mm_sub_ps(qb, qa), _mm_set1_ps(t)));
+			__m128 lengthSq = _mm_mul_ps(blend, blend);
+			lengthSq = _mm_add_ps(lengthSq, _mm_shuffle_ps(lengthSq, lengthSq, _MM_SHUFFLE(2, 3, 0, 1)));
+			lengthSq = _mm_add_ps(lengthSq, _mm_shuffle_ps(lengthSq, lengthSq, _MM_SHUFFLE(1, 0, 3, 2)));
+			_mm_storeu_ps(&out[0], _mm_div_ps(blend, _mm_sqrt_ps(lengthSq)));
+#elif defined(NB_SIMD_NEON)
+			const float32x4_t qa = vld1q_f32(&a[0]);
+			float32x4_t qb = vld1q_f32(&b[0]);
+			if (vaddvq_f32(vmulq_f32(qa, qb)) < 0.0f)
+				qb = vnegq_f32(qb);
+
+			const float32x4_t blend = vfmaq_n_f32(qa, vsubq_f32(qb, qa), t);
+			const float lengthSq = vaddvq_f32(vmulq_f32(blend, blend));
+			vst1q_f32(&out[0], vmulq_n_f32(blend, 1.0f / std::sqrt(lengthSq)));
+#else
+			const glm::quat target = glm::dot(a, b) < 0.0f ? -b : b;
+			out = glm::normalize(a + (target - a) * t);
+#endif
+			return out;
+		}
+	}
+}
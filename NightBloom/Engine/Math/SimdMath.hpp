@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+// SimdMath.hpp
+//
+// SIMD kernels for the per-object hot loops (draw list culling, shadow caster
+// culling, bounds transforms) on glm's column-major types. One path is picked
+// at compile time:
+//   NB_SIMD_AVX2  - x86 built with AVX2 (NIGHTBLOOM_ENABLE_AVX2): 8-wide batches
+//   NB_SIMD_SSE   - x86-64 baseline (SSE2)
+//   NB_SIMD_NEON  - ARM64
+//   otherwise scalar glm
+// NB_SIMD_WIDTH is the batch width the culling loops are padded to (see
+// AABBBatch in Frustum.hpp). The types' layout is left alone - no
+// GLM_FORCE_INTRINSICS, which would re-align vec3/vec4 under the std140
+// structs.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define NB_SIMD_AVX2 1
+#endif
+#if defined(NB_SIMD_AVX2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NB_SIMD_SSE 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define NB_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(NB_SIMD_AVX2)
+#define NB_SIMD_WIDTH 8
+#elif defined(NB_SIMD_SSE) || defined(NB_SIMD_NEON)
+#define NB_SIMD_WIDTH 4
+#else
+#define NB_SIMD_WIDTH 1
+#endif
+
+namespace Nightbloom
+{
+	namespace Simd
+	{
+		// a * b
+		inline glm::mat4 Multiply(const glm::mat4& a, const glm::mat4& b)
+		{
+			glm::mat4 out;
+#if defined(NB_SIMD_SSE)
+			const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+			const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+			const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+			const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+			for (int c = 0; c < 4; ++c)
+			{
+				__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[c][0]));
+				r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[c][1])));
+				r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[c][2])));
+				r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[c][3])));
+				_mm_storeu_ps(&out[c][0], r);
+			}
+#elif defined(NB_SIMD_NEON)
+			const float32x4_t a0 = vld1q_f32(&a[0][0]);
+			const float32x4_t a1 = vld1q_f32(&a[1][0]);
+			const float32x4_t a2 = vld1q_f32(&a[2][0]);
+			const float32x4_t a3 = vld1q_f32(&a[3][0]);
+			for (int c = 0; c < 4; ++c)
+			{
+				const float32x4_t col = vld1q_f32(&b[c][0]);
+				float32x4_t r = vmulq_laneq_f32(a0, col, 0);
+				r = vfmaq_laneq_f32(r, a1, col, 1);
+				r = vfmaq_laneq_f32(r, a2, col, 2);
+				r = vfmaq_laneq_f32(r, a3, col, 3);
+				vst1q_f32(&out[c][0], r);
+			}
+#else
+			out = a * b;
+#endif
+			return out;
+		}
+
+		// General 4x4 inverse (m must be invertible)
+		inline glm::mat4 Inverse(const glm::mat4& m)
+		{
+#if defined(NB_SIMD_SSE)
+			// 2x2 block inverse. The block formulas are for rows; a
+			// column-major matrix loaded as rows is m's transpose, and the
+			// rows this produces are the transpose's inverse - so storing
+			// them as columns gives m's inverse.
+#define NB_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define NB_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps(v, v, NB_SHUFFLE_MASK(x, y, z, w))
+#define NB_SHUFFLE(v1, v2, x, y, z, w) _mm_shuffle_ps(v1, v2, NB_SHUFFLE_MASK(x, y, z, w))
+			// Row-major 2x2 products packed as (m00, m01, m10, m11)
+			auto mat2Mul = [](__m128 v1, __m128 v2)          // A * B
+			{
+				return _mm_add_ps(_mm_mul_ps(v1, NB_SWIZZLE(v2, 0, 3, 0, 3)),
+					_mm_mul_ps(NB_SWIZZLE(v1, 1, 0, 3, 2), NB_SWIZZLE(v2, 2, 1, 2, 1)));
+			};
+			auto mat2AdjMul = [](__m128 v1, __m128 v2)       // adj(A) * B
+			{
+				return _mm_sub_ps(_mm_mul_ps(NB_SWIZZLE(v1, 3, 3, 0, 0), v2),
+					_mm_mul_ps(NB_SWIZZLE(v1, 1, 1, 2, 2), NB_SWIZZLE(v2, 2, 3, 0, 1)));
+			};
+			auto mat2MulAdj = [](__m128 v1, __m128 v2)       // A * adj(B)
+			{
+				return _mm_sub_ps(_mm_mul_ps(v1, NB_SWIZZLE(v2, 3, 0, 3, 0)),
+					_mm_mul_ps(NB_SWIZZLE(v1, 1, 0, 3, 2), NB_SWIZZLE(v2, 2, 1, 2, 1)));
+			};
+
+			const __m128 r0 = _mm_loadu_ps(&m[0][0]);
+			const __m128 r1 = _mm_loadu_ps(&m[1][0]);
+			const __m128 r2 = _mm_loadu_ps(&m[2][0]);
+			const __m128 r3 = _mm_loadu_ps(&m[3][0]);
+
+			// | A B |
+			// | C D |
+			const __m128 A = _mm_movelh_ps(r0, r1);
+			const __m128 B = _mm_movehl_ps(r1, r0);
+			const __m128 C = _mm_movelh_ps(r2, r3);
+			const __m128 D = _mm_movehl_ps(r3, r2);
+
+			// (|A|, |B|, |C|, |D|)
+			const __m128 detSub = _mm_sub_ps(
+				_mm_mul_ps(NB_SHUFFLE(r0, r2, 0, 2, 0, 2), NB_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+				_mm_mul_ps(NB_SHUFFLE(r0, r2, 1, 3, 1, 3), NB_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+			const __m128 detA = NB_SWIZZLE(detSub, 0, 0, 0, 0);
+			const __m128 detB = NB_SWIZZLE(detSub, 1, 1, 1, 1);
+			const __m128 detC = NB_SWIZZLE(detSub, 2, 2, 2, 2);
+			const __m128 detD = NB_SWIZZLE(detSub, 3, 3, 3, 3);
+
+			const __m128 DC = mat2AdjMul(D, C);
+			const __m128 AB = mat2AdjMul(A, B);
+			__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), mat2Mul(B, DC));
+			__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), mat2Mul(C, AB));
+			__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), mat2MulAdj(D, AB));
+			__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), mat2MulAdj(A, DC));
+
+			// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+			__m128 tr = _mm_mul_ps(AB, NB_SWIZZLE(DC, 0, 2, 1, 3));
+			tr = _mm_add_ps(tr, NB_SWIZZLE(tr, 2, 3, 0, 1));
+			tr = _mm_add_ps(tr, NB_SWIZZLE(tr, 1, 0, 3, 2));
+			const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+			const __m128 rcpDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+			X = _mm_mul_ps(X, rcpDet);
+			Y = _mm_mul_ps(Y, rcpDet);
+			Z = _mm_mul_ps(Z, rcpDet);
+			W = _mm_mul_ps(W, rcpDet);
+
+			glm::mat4 out;
+			_mm_storeu_ps(&out[0][0], NB_SHUFFLE(X, Y, 3, 1, 3, 1));
+			_mm_storeu_ps(&out[1][0], NB_SHUFFLE(X, Y, 2, 0, 2, 0));
+			_mm_storeu_ps(&out[2][0], NB_SHUFFLE(Z, W, 3, 1, 3, 1));
+			_mm_storeu_ps(&out[3][0], NB_SHUFFLE(Z, W, 2, 0, 2, 0));
+#undef NB_SHUFFLE
+#undef NB_SWIZZLE
+#undef NB_SHUFFLE_MASK
+			return out;
+#else
+			return glm::inverse(m);
+#endif
+		}
+
+		// World-space center/extents of a local AABB under transform: the
+		// center transformed, the extents through |rotation * scale|
+		inline void TransformAABB(const glm::vec3& localMin, const glm::vec3& localMax, const glm::mat4& transform,
+			glm::vec3& outCenter, glm::vec3& outExtents)
+		{
+			const glm::vec3 localCenter = (localMin + localMax) * 0.5f;
+			const glm::vec3 localExtents = (localMax - localMin) * 0.5f;
+#if defined(NB_SIMD_SSE)
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			const __m128 c0 = _mm_loadu_ps(&transform[0][0]);
+			const __m128 c1 = _mm_loadu_ps(&transform[1][0]);
+			const __m128 c2 = _mm_loadu_ps(&transform[2][0]);
+			const __m128 c3 = _mm_loadu_ps(&transform[3][0]);
+
+			__m128 center = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(localCenter.x)));
+			center = _mm_add_ps(center, _mm_mul_ps(c1, _mm_set1_ps(localCenter.y)));
+			center = _mm_add_ps(center, _mm_mul_ps(c2, _mm_set1_ps(localCenter.z)));
+
+			__m128 extents = _mm_mul_ps(_mm_andnot_ps(signMask, c0), _mm_set1_ps(localExtents.x));
+			extents = _mm_add_ps(extents, _mm_mul_ps(_mm_andnot_ps(signMask, c1), _mm_set1_ps(localExtents.y)));
+			extents = _mm_add_ps(extents, _mm_mul_ps(_mm_andnot_ps(signMask, c2), _mm_set1_ps(localExtents.z)));
+
+			alignas(16) float c[4], e[4];
+			_mm_store_ps(c, center);
+			_mm_store_ps(e, extents);
+			outCenter = glm::vec3(c[0], c[1], c[2]);
+			outExtents = glm::vec3(e[0], e[1], e[2]);
+#elif defined(NB_SIMD_NEON)
+			const float32x4_t c0 = vld1q_f32(&transform[0][0]);
+			const float32x4_t c1 = vld1q_f32(&transform[1][0]);
+			const float32x4_t c2 = vld1q_f32(&transform[2][0]);
+			float32x4_t center = vld1q_f32(&transform[3][0]);
+			center = vfmaq_n_f32(center, c0, localCenter.x);
+			center = vfmaq_n_f32(center, c1, localCenter.y);
+			center = vfmaq_n_f32(center, c2, localCenter.z);
+
+			float32x4_t extents = vmulq_n_f32(vabsq_f32(c0), localExtents.x);
+			extents = vfmaq_n_f32(extents, vabsq_f32(c1), localExtents.y);
+			extents = vfmaq_n_f32(extents, vabsq_f32(c2), localExtents.z);
+
+			float c[4], e[4];
+			vst1q_f32(c, center);
+			vst1q_f32(e, extents);
+			outCenter = glm::vec3(c[0], c[1], c[2]);
+			outExtents = glm::vec3(e[0], e[1], e[2]);
+#else
+			outCenter = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+			const glm::mat3 absRotScale(
+				glm::abs(glm::vec3(transform[0])),
+				glm::abs(glm::vec3(transform[1])),
+				glm::abs(glm::vec3(transform[2])));
+			outExtents = absRotScale * localExtents;
+#endif
+		}
+	}
+}
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+// Animation.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Animation.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/SimdMath.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		glm::quat ToQuat(const glm::vec4& value)
+		{
+			return glm::quat(value.w, value.x, value.y, value.z);
+		}
+
+		void ApplyChannel(const AnimationChannel& channel, float time, JointPose& pose)
+		{
+			const size_t keyCount = std::min(channel.times.size(), channel.values.size());
+			if (keyCount == 0)
+				return;
+
+			// Keys either side of time; outside the keys the end one holds
+			const auto end = channel.times.begin() + keyCount;
+			const size_t next = static_cast<size_t>(std::upper_bound(channel.times.begin(), end, time) - channel.times.begin());
+			size_t from = next == 0 ? 0 : next - 1;
+			size_t to = std::min(next, keyCount - 1);
+			float t = 0.0f;
+			if (from != to)
+			{
+				const float span = channel.times[to] - channel.times[from];
+				t = span > 0.0f ? (time - channel.times[from]) / span : 0.0f;
+				if (channel.interpolation == AnimationInterpolation::Step)
+					to = from;
+			}
+
+			const glm::vec4& a = channel.values[from];
+			const glm::vec4& b = channel.values[to];
+			switch (channel.path)
+			{
+			case AnimationPath::Translation:
+				pose.translation = glm::mix(glm::vec3(a), glm::vec3(b), t);
+				break;
+			case AnimationPath::Rotation:
+				pose.rotation = from == to ? glm::normalize(ToQuat(a)) : Simd::Nlerp(ToQuat(a), ToQuat(b), t);
+				break;
+			case AnimationPath::Scale:
+				pose.scale = glm::mix(glm::vec3(a), glm::vec3(b), t);
+				break;
+			}
+		}
+	}
+
+	VertexSkin PackVertexSkin(const glm::uvec4& joints, const glm::vec4& weights)
+	{
+		VertexSkin skin;
+		const glm::vec4 clamped = glm::max(weights, glm::vec4(0.0f));
+		const float sum = clamped.x + clamped.y + clamped.z + clamped.w;
+		const glm::vec4 normalized = sum > 0.0f ? clamped / sum : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+		for (int i = 0; i < 4; ++i)
+		{
+			skin.joints[i] = static_cast<uint16_t>(std::min(joints[i], 0xFFFFu));
+			skin.weights[i] = static_cast<uint16_t>(std::lround(normalized[i] * 65535.0f));
+		}
+		return skin;
+	}
+
+	glm::mat4 JointPose::ToMatrix() const
+	{
+		glm::mat4 m = glm::mat4_cast(rotation);
+		m[0] *= scale.x;
+		m[1] *= scale.y;
+		m[2] *= scale.z;
+		m[3] = glm::vec4(translation, 1.0f);
+		return m;
+	}
+
+	bool Skeleton::IsValid() const
+	{
+		const size_t count = parents.size();
+		if (restPose.size() != count || inverseBind.size() != count || (!names.empty() && names.size() != count))
+			return false;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (parents[i] >= static_cast<int32_t>(i) || parents[i] < -1)
+				return false;
+		}
+		return true;
+	}
+
+	void SampleAnimation(const AnimationClip& clip, const Skeleton& skeleton, float time, JointPose* outPose)
+	{
+		const uint32_t jointCount = skeleton.GetJointCount();
+		std::copy(skeleton.restPose.begin(), skeleton.restPose.begin() + jointCount, outPose);
+
+		time = std::clamp(time, 0.0f, clip.duration);
+		for (const AnimationChannel& channel : clip.channels)
+		{
+			if (channel.joint < jointCount)
+				ApplyChannel(channel, time, outPose[channel.joint]);
+		}
+	}
+
+	void BlendPoses(const JointPose* a, const JointPose* b, float weight, JointPose* out, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			out[i].translation = glm::mix(a[i].translation, b[i].translation, weight);
+			out[i].rotation = Simd::Nlerp(a[i].rotation, b[i].rotation, weight);
+			out[i].scale = glm::mix(a[i].scale, b[i].scale, weight);
+		}
+	}
+
+	void ComputeSkinMatrices(const Skeleton& skeleton, const JointPose* pose, glm::mat4* outSkin)
+	{
+		// Model-space joint transforms first (parents precede children),
+		// then the inverse bind matrices on top
+		const uint32_t jointCount = skeleton.GetJointCount();
+		for (uint32_t i = 0; i < jointCount; ++i)
+		{
+			const int32_t parent = skeleton.parents[i];
+			const glm::mat4& parentTransform = parent < 0 ? skeleton.rootTransform : outSkin[parent];
+			outSkin[i] = Simd::Multiply(parentTransform, pose[i].ToMatrix());
+		}
+		for (uint32_t i = 0; i < jointCount; ++i)
+			outSkin[i] = Simd::Multiply(outSkin[i], skeleton.inverseBind[i]);
+	}
+
+	void AnimationPlayer::Play(uint32_t clip, float fadeSeconds)
+	{
+		if (fadeSeconds > 0.0f && m_Clip != NO_CLIP)
+		{
+			m_FadeClip = m_Clip;
+			m_FadeTime = m_Time;
+			m_FadeDuration = fadeSeconds;
+			m_FadeElapsed = 0.0f;
+		}
+		else
+		{
+			m_FadeClip = NO_CLIP;
+		}
+		m_Clip = clip;
+		m_Time = 0.0f;
+	}
+
+	void AnimationPlayer::Stop()
+	{
+		m_Clip = NO_CLIP;
+		m_FadeClip = NO_CLIP;
+		m_Time = 0.0f;
+	}
+
+	float AnimationPlayer::AdvanceTime(float time, float deltaTime, const AnimationClip& clip) const
+	{
+		time += deltaTime * m_Speed;
+		if (clip.duration <= 0.0f)
+			return 0.0f;
+		if (!m_Looping)
+			return std::clamp(time, 0.0f, clip.duration);
+		time = std::fmod(time, clip.duration);
+		return time < 0.0f ? time + clip.duration : time;
+	}
+
+	void AnimationPlayer::Advance(float deltaTime, const std::vector<AnimationClip>& clips)
+	{
+		if (m_Clip >= clips.size())
+			return;
+		m_Time = AdvanceTime(m_Time, deltaTime, clips[m_Clip]);
+
+		if (m_FadeClip != NO_CLIP)
+		{
+			m_FadeElapsed += deltaTime;
+			if (m_FadeElapsed >= m_FadeDuration || m_FadeClip >= clips.size())
+				m_FadeClip = NO_CLIP;
+			else
+				m_FadeTime = AdvanceTime(m_FadeTime, deltaTime, clips[m_FadeClip]);
+		}
+	}
+
+	void AnimationPlayer::Evaluate(const Skeleton& skeleton, const std::vector<AnimationClip>& clips,
+		std::vector<JointPose>& outPose, std::vector<JointPose>& scratch) const
+	{
+		const uint32_t jointCount = skeleton.GetJointCount();
+		outPose.resize(jointCount);
+		if (m_Clip >= clips.size())
+		{
+			std::copy(skeleton.restPose.begin(), skeleton.restPose.begin() + jointCount, outPose.begin());
+			return;
+		}
+
+		SampleAnimation(clips[m_Clip], skeleton, m_Time, outPose.data());
+		if (m_FadeClip < clips.size())
+		{
+			scratch.resize(jointCount);
+			SampleAnimation(clips[m_FadeClip], skeleton, m_FadeTime, scratch.data());
+			BlendPoses(scratch.data(), outPose.data(), m_FadeElapsed / m_FadeDuration, outPose.data(), jointCount);
+		}
+	}
+}
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// Animation.hpp
+//
+// Skeletal animation for skinned glTF models: the skeleton and clips
+// GLTFLoader imports, keyframe sampling, pose blending and the skin matrices
+// the vertices are skinned with. Poses are evaluated on the CPU per drawable
+// (ModelDrawable::Update, spread over the job system by Scene::Update);
+// the vertices themselves are skinned on the GPU, once per frame, by
+// SkinningSystem.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Joint influences of one vertex, parallel to a skinned mesh's vertices:
+	// four skeleton joints and their weights as unorm16. Matches the tail of
+	// SkinVertex in Skinning.comp.
+	struct VertexSkin
+	{
+		uint16_t joints[4] = {};
+		uint16_t weights[4] = {};
+	};
+
+	// Quantizes up to four influences; the weights are renormalized to sum
+	// to one first (all-zero weights bind the vertex to joints.x)
+	VertexSkin PackVertexSkin(const glm::uvec4& joints, const glm::vec4& weights);
+
+	// Local transform of one joint relative to its parent
+	struct JointPose
+	{
+		glm::vec3 translation = glm::vec3(0.0f);
+		glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+
+		// T * R * S
+		glm::mat4 ToMatrix() const;
+	};
+
+	// Joints are ordered so every parent comes before its children, which
+	// lets poses be accumulated in one pass
+	struct Skeleton
+	{
+		std::vector<std::string> names;
+		std::vector<int32_t> parents;        // -1 for a root
+		std::vector<JointPose> restPose;     // what joints no channel animates keep
+		std::vector<glm::mat4> inverseBind;  // model space -> joint space at bind time
+		// Space the roots are placed in (the nodes above the skeleton)
+		glm::mat4 rootTransform = glm::mat4(1.0f);
+
+		uint32_t GetJointCount() const { return static_cast<uint32_t>(parents.size()); }
+		bool IsEmpty() const { return parents.empty(); }
+
+		// Arrays agree in size and every parent precedes its children
+		bool IsValid() const;
+	};
+
+	enum class AnimationPath : uint8_t { Translation, Rotation, Scale };
+	enum class AnimationInterpolation : uint8_t { Step, Linear };
+
+	// One animated property of one joint. values holds xyz (translation,
+	// scale) or a quaternion as (x, y, z, w) per key.
+	struct AnimationChannel
+	{
+		uint32_t joint = 0;
+		AnimationPath path = AnimationPath::Rotation;
+		AnimationInterpolation interpolation = AnimationInterpolation::Linear;
+		std::vector<float> times;      // ascending
+		std::vector<glm::vec4> values;
+	};
+
+	struct AnimationClip
+	{
+		std::string name;
+		float duration = 0.0f;   // last key time over all channels
+		std::vector<AnimationChannel> channels;
+	};
+
+	// Local pose at time (clamped to the clip): the rest pose with every
+	// channel applied. outPose has one entry per skeleton joint.
+	void SampleAnimation(const AnimationClip& clip, const Skeleton& skeleton, float time, JointPose* outPose);
+
+	// out = a weighted toward b (0 = a, 1 = b): translation and scale lerp,
+	// rotations Simd::Nlerp. out may alias a or b.
+	void BlendPoses(const JointPose* a, const JointPose* b, float weight, JointPose* out, uint32_t count);
+
+	// Skin matrix per joint: the joint's model-space transform under pose
+	// times its inverse bind matrix, taking a bind-pose vertex to its posed
+	// position. The rest pose of a consistent skeleton gives identities.
+	void ComputeSkinMatrices(const Skeleton& skeleton, const JointPose* pose, glm::mat4* outSkin);
+
+	// Plays one clip of a model at a time, cross-fading from the previous one
+	class AnimationPlayer
+	{
+	public:
+		static constexpr uint32_t NO_CLIP = UINT32_MAX;
+
+		// Starts clip from its beginning, fading out of the current one over
+		// fadeSeconds (0 cuts)
+		void Play(uint32_t clip, float fadeSeconds = 0.0f);
+		void Stop();
+
+		void SetSpeed(float speed) { m_Speed = speed; }
+		float GetSpeed() const { return m_Speed; }
+		// Looping clips wrap; others hold their last pose
+		void SetLooping(bool looping) { m_Looping = looping; }
+		bool IsLooping() const { return m_Looping; }
+
+		bool IsPlaying() const { return m_Clip != NO_CLIP; }
+		uint32_t GetClip() const { return m_Clip; }
+		float GetTime() const { return m_Time; }
+
+		void Advance(float deltaTime, const std::vector<AnimationClip>& clips);
+
+		// Current pose into outPose, resized to the joint count; scratch holds
+		// the fading clip's pose. The rest pose when nothing plays.
+		void Evaluate(const Skeleton& skeleton, const std::vector<AnimationClip>& clips,
+			std::vector<JointPose>& outPose, std::vector<JointPose>& scratch) const;
+
+	private:
+		float AdvanceTime(float time, float deltaTime, const AnimationClip& clip) const;
+
+		uint32_t m_Clip = NO_CLIP;
+		float m_Time = 0.0f;
+
+		uint32_t m_FadeClip = NO_CLIP;   // clip being faded out of
+		float m_FadeTime = 0.0f;
+		float m_FadeDuration = 0.0f;
+		float m_FadeElapsed = 0.0f;
+
+		float m_Speed = 1.0f;
+		bool m_Looping = true;
+	};
+}
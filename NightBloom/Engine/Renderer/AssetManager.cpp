@@ -6,7 +6,6 @@
 
 #include "Engine/Renderer/AssetManager.hpp"
 #include "Core/Logger/Logger.hpp"
-#include "Engine/Core/FileUtils.hpp"  
 #include <filesystem>
 #include <fstream>
 
@@ -38,6 +37,14 @@ namespace Nightbloom
 		m_TexturesPath = m_AssetsPath + "/Textures";
 		m_ModelsPath = m_AssetsPath + "/Models";
 
+		// A packed archive next to the executable (shipped builds) or at the
+		// root; loose files cover whatever it lacks
+		for (const std::string& archivePath : { basePathHint + "/" + ARCHIVE_FILE_NAME, m_RootPath + "/" + ARCHIVE_FILE_NAME })
+		{
+			if (std::filesystem::is_regular_file(archivePath) && MountArchive(archivePath))
+				break;
+		}
+
 		// For shaders, we need to check multiple possible locations
 		std::filesystem::path exePath(basePathHint);
 		LOG_INFO("exePath: {}", exePath.string());
@@ -94,7 +101,10 @@ namespace Nightbloom
 		{
 			// Use the executable's directory as the base
 			m_ShadersPath = exePath.parent_path().string() + "/Shaders";
-			LOG_WARN("No compiled shaders found, using default location: {}", m_ShadersPath);
+			if (HasArchive())
+				LOG_INFO("No loose compiled shaders, using the archive's");
+			else
+				LOG_WARN("No compiled shaders found, using default location: {}", m_ShadersPath);
 
 			// Create the directory if it doesn't exist
 			if (!std::filesystem::exists(m_ShadersPath))
@@ -152,6 +162,7 @@ namespace Nightbloom
 		m_ShadersPath.clear();
 		m_TexturesPath.clear();
 		m_ModelsPath.clear();
+		UnmountArchive();
 
 		m_Initialized = false;
 	}
@@ -183,14 +194,14 @@ namespace Nightbloom
 		}
 
 		// Check if it's already a full path
-		if (std::filesystem::exists(textureName))
+		if (AssetExists(textureName))
 		{
 			return textureName;
 		}
 
 		// Try in textures directory
 		std::string path = m_TexturesPath + "/" + textureName;
-		if (std::filesystem::exists(path))
+		if (AssetExists(path))
 		{
 			return path;
 		}
@@ -198,11 +209,12 @@ namespace Nightbloom
 		// Try with common extensions if no extension provided
 		if (textureName.find('.') == std::string::npos)
 		{
-			std::vector<std::string> extensions = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+			// .ktx2 last: a cooked file shipped without its source
+			std::vector<std::string> extensions = { ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".ktx2" };
 			for (const auto& ext : extensions)
 			{
 				std::string testPath = m_TexturesPath + "/" + textureName + ext;
-				if (std::filesystem::exists(testPath))
+				if (AssetExists(testPath))
 				{
 					return testPath;
 				}
@@ -223,7 +235,7 @@ namespace Nightbloom
 
 		std::string fullPath = m_ModelsPath + "/" + modelName;
 
-		if (!std::filesystem::exists(fullPath))
+		if (!AssetExists(fullPath))
 		{
 			LOG_WARN("Model not found: {}", fullPath);
 		}
@@ -242,7 +254,7 @@ namespace Nightbloom
 		return m_AssetsPath + "/" + relativePath;
 	}
 
-	std::vector<char> AssetManager::LoadShaderBinary(const std::string& shaderName) const
+	AssetFile AssetManager::LoadShaderBinary(const std::string& shaderName) const
 	{
 		std::string path = GetShaderPath(shaderName);
 
@@ -253,7 +265,7 @@ namespace Nightbloom
 		}
 
 		// Check if file exists
-		if (!std::filesystem::exists(path))
+		if (!AssetExists(path))
 		{
 			LOG_ERROR("Shader file not found: {}", path);
 			// Also log where we're looking for debugging
@@ -262,7 +274,88 @@ namespace Nightbloom
 		}
 
 		LOG_TRACE("Loading shader from: {}", path);
-		return FileUtils::ReadFileAsChars(path);
+		AssetFile file = OpenAsset(path);
+		if (!file.IsOpen() || file.GetSize() % sizeof(uint32_t) != 0)
+		{
+			LOG_ERROR("Shader file is empty or not SPIR-V: {}", path);
+			file.Close();
+		}
+		return file;
+	}
+
+	bool AssetManager::MountArchive(const std::string& path)
+	{
+		std::string error;
+		if (!m_Archive.Open(path, error))
+		{
+			LOG_WARN("Can't mount asset archive {}: {}", path, error);
+			return false;
+		}
+
+		LOG_INFO("Mounted asset archive {} ({} entries)", path, m_Archive.GetEntryCount());
+		return true;
+	}
+
+	void AssetManager::UnmountArchive()
+	{
+		m_Archive.Close();
+	}
+
+	std::string AssetManager::GetArchiveEntryPath(const std::string& fullPath) const
+	{
+		if (fullPath.empty())
+			return {};
+
+		// Shaders are packed by file name, wherever the build put them
+		const std::filesystem::path path = std::filesystem::path(fullPath).lexically_normal();
+		if (!m_ShadersPath.empty())
+		{
+			const std::filesystem::path relative = path.lexically_relative(std::filesystem::path(m_ShadersPath).lexically_normal());
+			if (!relative.empty() && *relative.begin() != "..")
+				return "Shaders/" + relative.generic_string();
+		}
+		if (!m_RootPath.empty())
+		{
+			const std::filesystem::path relative = path.lexically_relative(std::filesystem::path(m_RootPath).lexically_normal());
+			if (!relative.empty() && *relative.begin() != "..")
+				return relative.generic_string();
+		}
+		return {};
+	}
+
+	AssetFile AssetManager::OpenAsset(const std::string& fullPath) const
+	{
+		AssetFile file;
+		if (m_PreferLooseFiles || !HasArchive())
+		{
+			if (file.Open(fullPath) || !HasArchive())
+				return file;
+		}
+
+		const std::string entryPath = GetArchiveEntryPath(fullPath);
+		if (!entryPath.empty())
+		{
+			file = m_Archive.Find(entryPath);
+			if (file.IsOpen())
+				return file;
+		}
+
+		if (!m_PreferLooseFiles)
+			file.Open(fullPath);
+		return file;
+	}
+
+	bool AssetManager::IsInArchive(const std::string& fullPath) const
+	{
+		if (!HasArchive())
+			return false;
+		const std::string entryPath = GetArchiveEntryPath(fullPath);
+		return !entryPath.empty() && m_Archive.Contains(entryPath);
+	}
+
+	bool AssetManager::AssetExists(const std::string& fullPath) const
+	{
+		return IsInArchive(fullPath) || std::filesystem::exists(fullPath);
 	}
 
 	bool AssetManager::ValidateAssetPaths() const
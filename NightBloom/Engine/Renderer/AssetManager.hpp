@@ -10,6 +10,7 @@
 #include <vector>
 #include <unordered_map>
 #include <filesystem>
+#include "Engine/Core/AssetArchive.hpp"
 
 namespace Nightbloom
 {
@@ -32,8 +33,30 @@ namespace Nightbloom
 		std::string GetModelPath(const std::string& modelName) const;
 		std::string GetAssetPath(const std::string& relativePath) const;
 
-		// Shader loading helpers
-		std::vector<char> LoadShaderBinary(const std::string& shaderName) const;
+		// Shader loading helpers. The SPIR-V is mapped, not read: pass
+		// GetSpan()/GetData() straight to vkCreateShaderModule. Not open on
+		// failure.
+		AssetFile LoadShaderBinary(const std::string& shaderName) const;
+
+		// Packed archive (AssetArchive.hpp). Initialize mounts
+		// ARCHIVE_FILE_NAME from the executable's directory or the project
+		// root when there is one; its entries then stand in for the loose
+		// files under the root and the shader directory.
+		static constexpr const char* ARCHIVE_FILE_NAME = "Assets.nbpak";
+		bool MountArchive(const std::string& path);
+		void UnmountArchive();
+		bool HasArchive() const { return m_Archive.IsOpen(); }
+
+		// Loose files win over archive entries when both exist (editor
+		// builds, where assets change on disk); otherwise the archive does
+		void SetPreferLooseFiles(bool prefer) { m_PreferLooseFiles = prefer; }
+
+		// Maps an asset by the full path the Get*Path functions return, from
+		// the archive or the disk; not open when neither has it. Usable before
+		// Initialize (loose files only).
+		AssetFile OpenAsset(const std::string& fullPath) const;
+		bool IsInArchive(const std::string& fullPath) const;
+		bool AssetExists(const std::string& fullPath) const;
 
 		// Check if paths exist
 		bool ValidateAssetPaths() const;
@@ -54,12 +77,18 @@ namespace Nightbloom
 
 		bool FindProjectRoot(const std::string& executablePath);
 
+		// Archive entry path for a full path; empty when it lies outside the
+		// root and the shader directory
+		std::string GetArchiveEntryPath(const std::string& fullPath) const;
+
 	private:
 		std::string m_RootPath;
 		std::string m_AssetsPath;
 		std::string m_ShadersPath;
 		std::string m_TexturesPath;
 		std::string m_ModelsPath;
+		AssetArchive m_Archive;
+		bool m_PreferLooseFiles = false;
 		bool m_Initialized = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,323 @@
+//------------------------------------------------------------------------------
+// Atmosphere.hpp
+//
+// Physically based sky after Hillaire, "A Scalable and Production Ready Sky
+// and Atmosphere Rendering Technique" (2020). The atmosphere is a shell of
+// Rayleigh, Mie and ozone above a spherical planet; AtmosphereLuts bakes it
+// into four small textures with compute passes:
+//   transmittance   256x64   (r, mu) -> transmittance to the atmosphere edge
+//   multi-scatter    32x32   (r, sun zenith cos) -> isotropic multiple scattering
+//   sky-view        192x108  (view zenith, view azimuth from the sun) -> sky luminance
+//   aerial           32^3    camera froxels -> in-scattering (rgb), transmittance (a)
+// The first two depend only on the medium, the sky-view on the sun's
+// elevation and the camera's altitude, so they rebuild only when those move
+// past a threshold. The froxels follow the camera and rebuild every frame.
+// Everything is baked for a sun of illuminance 1; AtmosphereParamsData::sun.w
+// scales it at lookup.
+//
+// Distances are in kilometres. The world's y is altitude above the ground
+// (the camera sits at the top of the planet), kmPerUnit converts.
+//
+// atmosphere.glsl is a straight port of the maths below - keep the two in
+// sync.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	struct AtmosphereSettings
+	{
+		bool  enabled = true;
+
+		float planetRadius = 6360.0f;       // km
+		float atmosphereHeight = 100.0f;    // km above the ground
+
+		glm::vec3 rayleighScattering = glm::vec3(5.802e-3f, 13.558e-3f, 33.1e-3f);  // 1/km
+		float rayleighScaleHeight = 8.0f;   // km
+
+		float mieScattering = 3.996e-3f;    // 1/km
+		float mieAbsorption = 4.4e-3f;      // 1/km
+		float mieScaleHeight = 1.2f;        // km
+		float mieAnisotropy = 0.8f;
+
+		// Tent-shaped layer peaking at OZONE_CENTER_KM
+		glm::vec3 ozoneAbsorption = glm::vec3(0.650e-3f, 1.881e-3f, 0.085e-3f);  // 1/km
+
+		float groundAlbedo = 0.3f;
+		float sunIlluminance = 8.0f;        // scales the baked luminance into scene units
+
+		float kmPerUnit = 0.001f;           // world units are metres
+		float aerialPerspectiveScale = 8.0f;  // exaggerates the haze over a small world (0 = off)
+
+		float updateThresholdDeg = 0.25f;   // sun elevation change that rebuilds the sky-view
+	};
+
+	// The atmosphere as the shaders see it: the compute passes' push constants
+	// and FrameUniformData::atmosphere. Mirrors AtmosphereData in atmosphere.glsl.
+	struct AtmosphereParamsData
+	{
+		glm::vec4 radii = glm::vec4(0.0f);     // x = planet, y = top of the atmosphere, z = camera (km), w = Mie anisotropy
+		glm::vec4 rayleigh = glm::vec4(0.0f);  // rgb = scattering (1/km), w = scale height (km)
+		glm::vec4 mie = glm::vec4(0.0f);       // x = scattering, y = absorption (1/km), z = scale height (km), w = ground albedo
+		glm::vec4 ozone = glm::vec4(0.0f);     // rgb = absorption (1/km), w = km of haze per world unit (0 = no aerial perspective)
+		glm::vec4 sun = glm::vec4(0.0f);       // xyz = toward the sun, w = illuminance (0 = atmosphere off)
+	};
+	static_assert(sizeof(AtmosphereParamsData) == 80, "Must match AtmosphereData in atmosphere.glsl");
+
+	struct AtmosphereMedium
+	{
+		glm::vec3 rayleighScattering = glm::vec3(0.0f);
+		glm::vec3 mieScattering = glm::vec3(0.0f);
+		glm::vec3 scattering = glm::vec3(0.0f);
+		glm::vec3 extinction = glm::vec3(0.0f);
+	};
+
+	class Atmosphere
+	{
+	public:
+		static constexpr uint32_t TRANSMITTANCE_WIDTH = 256;
+		static constexpr uint32_t TRANSMITTANCE_HEIGHT = 64;
+		static constexpr uint32_t MULTI_SCATTERING_SIZE = 32;
+		static constexpr uint32_t SKY_VIEW_WIDTH = 192;
+		static constexpr uint32_t SKY_VIEW_HEIGHT = 108;
+		static constexpr uint32_t AERIAL_SIZE = 32;          // froxels across, down and deep
+
+		static constexpr float AERIAL_DEPTH_KM = 32.0f;      // far end of the last froxel slice
+		static constexpr float PLANET_RADIUS_OFFSET = 0.01f; // km; keeps samples off the ground
+		static constexpr float OZONE_CENTER_KM = 25.0f;
+		static constexpr float OZONE_HALF_WIDTH_KM = 15.0f;
+		static constexpr float SKY_VIEW_ALTITUDE_STEP_KM = 0.05f;  // camera climb that rebuilds the sky-view
+
+		// The camera's distance from the planet centre: its altitude kept
+		// inside the atmosphere
+		static float CameraRadius(const AtmosphereSettings& settings, float cameraY)
+		{
+			const float altitude = std::clamp(cameraY * settings.kmPerUnit, PLANET_RADIUS_OFFSET,
+				std::max(settings.atmosphereHeight - PLANET_RADIUS_OFFSET, PLANET_RADIUS_OFFSET));
+			return settings.planetRadius + altitude;
+		}
+
+		// All zero when disabled, so the shaders see sun.w == 0 and fall back
+		static AtmosphereParamsData BuildParams(const AtmosphereSettings& settings, const glm::vec3& towardSun,
+			float cameraY)
+		{
+			AtmosphereParamsData params;
+			if (!settings.enabled || settings.atmosphereHeight <= 0.0f)
+				return params;
+
+			const float length = glm::length(towardSun);
+			const glm::vec3 sun = length > 1e-6f ? towardSun / length : glm::vec3(0.0f, 1.0f, 0.0f);
+
+			params.radii = glm::vec4(settings.planetRadius, settings.planetRadius + settings.atmosphereHeight,
+				CameraRadius(settings, cameraY), settings.mieAnisotropy);
+			params.rayleigh = glm::vec4(settings.rayleighScattering, settings.rayleighScaleHeight);
+			params.mie = glm::vec4(settings.mieScattering, settings.mieAbsorption, settings.mieScaleHeight,
+				settings.groundAlbedo);
+			params.ozone = glm::vec4(settings.ozoneAbsorption,
+				settings.kmPerUnit * std::max(settings.aerialPerspectiveScale, 0.0f));
+			params.sun = glm::vec4(sun, std::max(settings.sunIlluminance, 1e-4f));
+			return params;
+		}
+
+		static AtmosphereMedium SampleMedium(const AtmosphereParamsData& params, float altitude)
+		{
+			const float rayleighDensity = std::exp(-altitude / params.rayleigh.w);
+			const float mieDensity = std::exp(-altitude / params.mie.z);
+			const float ozoneDensity = std::max(0.0f, 1.0f - std::abs(altitude - OZONE_CENTER_KM) / OZONE_HALF_WIDTH_KM);
+
+			AtmosphereMedium medium;
+			medium.rayleighScattering = glm::vec3(params.rayleigh) * rayleighDensity;
+			medium.mieScattering = glm::vec3(params.mie.x * mieDensity);
+			medium.scattering = medium.rayleighScattering + medium.mieScattering;
+			medium.extinction = medium.rayleighScattering + glm::vec3((params.mie.x + params.mie.y) * mieDensity) +
+				glm::vec3(params.ozone) * ozoneDensity;
+			return medium;
+		}
+
+		// Distance along the unit direction to the nearest hit of a sphere
+		// centred at the origin, 0 from inside it, -1 when it is behind or missed
+		static float RaySphereNearest(const glm::vec3& origin, const glm::vec3& direction, float radius)
+		{
+			const float b = glm::dot(origin, direction);
+			const float c = glm::dot(origin, origin) - radius * radius;
+			const float discriminant = b * b - c;
+			if (discriminant < 0.0f)
+				return -1.0f;
+
+			const float root = std::sqrt(discriminant);
+			const float t0 = -b - root;
+			const float t1 = -b + root;
+			if (t0 < 0.0f && t1 < 0.0f)
+				return -1.0f;
+			if (t0 < 0.0f)
+				return std::max(0.0f, t1);
+			return std::max(0.0f, t0);
+		}
+
+		// Transmittance from radius r along zenith cosine mu to the ground or
+		// the top of the atmosphere, whichever comes first. What the
+		// transmittance LUT holds at TransmittanceLutUv(r, mu).
+		static glm::vec3 Transmittance(const AtmosphereParamsData& params, float r, float mu, int steps = 40)
+		{
+			const glm::vec3 origin(0.0f, r, 0.0f);
+			const glm::vec3 direction(std::sqrt(std::max(0.0f, 1.0f - mu * mu)), mu, 0.0f);
+			const float tMax = DistanceToEdge(params, origin, direction);
+			if (tMax <= 0.0f)
+				return glm::vec3(1.0f);
+
+			const float dt = tMax / static_cast<float>(steps);
+			glm::vec3 opticalDepth(0.0f);
+			for (int i = 0; i < steps; i++)
+			{
+				const glm::vec3 p = origin + direction * ((static_cast<float>(i) + 0.5f) * dt);
+				opticalDepth += SampleMedium(params, glm::length(p) - params.radii.x).extinction * dt;
+			}
+			return glm::exp(-opticalDepth);
+		}
+
+		// Sunlight reaching radius r from a sun at zenith cosine mu: zero once
+		// the planet is in the way
+		static glm::vec3 SunTransmittance(const AtmosphereParamsData& params, float r, float mu)
+		{
+			const glm::vec3 origin(0.0f, r, 0.0f);
+			const glm::vec3 direction(std::sqrt(std::max(0.0f, 1.0f - mu * mu)), mu, 0.0f);
+			if (RaySphereNearest(origin, direction, params.radii.x) >= 0.0f)
+				return glm::vec3(0.0f);
+			return Transmittance(params, r, mu);
+		}
+
+		// Transmittance LUT parameterization (Bruneton 2017): x covers the
+		// distance to the top of the atmosphere, y the height via the distance
+		// to the horizon
+		static glm::vec2 TransmittanceLutUv(const AtmosphereParamsData& params, float r, float mu)
+		{
+			const float bottom = params.radii.x;
+			const float top = params.radii.y;
+			const float H = std::sqrt(std::max(0.0f, top * top - bottom * bottom));
+			const float rho = std::sqrt(std::max(0.0f, r * r - bottom * bottom));
+			const float discriminant = r * r * (mu * mu - 1.0f) + top * top;
+			const float d = std::max(0.0f, -r * mu + std::sqrt(std::max(0.0f, discriminant)));
+			const float dMin = top - r;
+			const float dMax = rho + H;
+			const float x = dMax > dMin ? (d - dMin) / (dMax - dMin) : 0.0f;
+			return glm::vec2(x, H > 0.0f ? rho / H : 0.0f);
+		}
+
+		static void TransmittanceLutRMu(const AtmosphereParamsData& params, const glm::vec2& uv, float& r, float& mu)
+		{
+			const float bottom = params.radii.x;
+			const float top = params.radii.y;
+			const float H = std::sqrt(std::max(0.0f, top * top - bottom * bottom));
+			const float rho = H * uv.y;
+			r = std::sqrt(rho * rho + bottom * bottom);
+
+			const float dMin = top - r;
+			const float dMax = rho + H;
+			const float d = dMin + uv.x * (dMax - dMin);
+			mu = d == 0.0f ? 1.0f : (H * H - rho * rho - d * d) / (2.0f * r * d);
+			mu = std::clamp(mu, -1.0f, 1.0f);
+		}
+
+		// Sky-view LUT parameterization (Hillaire 2020): v squeezes the
+		// rows toward the horizon, where the sky changes fastest, with the
+		// horizon itself at v = 0.5; u is the azimuth from the sun. Both are
+		// inset by half a texel so the edge texels' centres land on the ends.
+		static glm::vec2 SkyViewLutUv(const AtmosphereParamsData& params, float r, float viewZenithCos,
+			float lightViewCos)
+		{
+			const float horizonDistance = std::sqrt(std::max(0.0f, r * r - params.radii.x * params.radii.x));
+			const float beta = std::acos(std::clamp(horizonDistance / r, -1.0f, 1.0f));
+			const float zenithHorizonAngle = PI - beta;
+			const float viewZenithAngle = std::acos(std::clamp(viewZenithCos, -1.0f, 1.0f));
+
+			float v;
+			if (viewZenithAngle < zenithHorizonAngle)
+			{
+				const float coord = 1.0f - std::sqrt(std::max(0.0f, 1.0f - viewZenithAngle / zenithHorizonAngle));
+				v = coord * 0.5f;
+			}
+			else
+			{
+				const float coord = std::sqrt(std::max(0.0f, (viewZenithAngle - zenithHorizonAngle) / beta));
+				v = coord * 0.5f + 0.5f;
+			}
+			const float u = std::sqrt(std::clamp(-lightViewCos * 0.5f + 0.5f, 0.0f, 1.0f));
+			return glm::vec2(UnitToTexelUv(u, static_cast<float>(SKY_VIEW_WIDTH)),
+				UnitToTexelUv(v, static_cast<float>(SKY_VIEW_HEIGHT)));
+		}
+
+		static void SkyViewLutParams(const AtmosphereParamsData& params, float r, const glm::vec2& uv,
+			float& viewZenithCos, float& lightViewCos)
+		{
+			const float u = TexelUvToUnit(uv.x, static_cast<float>(SKY_VIEW_WIDTH));
+			const float v = TexelUvToUnit(uv.y, static_cast<float>(SKY_VIEW_HEIGHT));
+
+			const float horizonDistance = std::sqrt(std::max(0.0f, r * r - params.radii.x * params.radii.x));
+			const float beta = std::acos(std::clamp(horizonDistance / r, -1.0f, 1.0f));
+			const float zenithHorizonAngle = PI - beta;
+
+			if (v < 0.5f)
+			{
+				const float coord = 1.0f - 2.0f * v;
+				viewZenithCos = std::cos(zenithHorizonAngle * (1.0f - coord * coord));
+			}
+			else
+			{
+				const float coord = v * 2.0f - 1.0f;
+				viewZenithCos = std::cos(zenithHorizonAngle + beta * coord * coord);
+			}
+			lightViewCos = -(u * u * 2.0f - 1.0f);
+		}
+
+		// [0, 1] across a LUT axis <-> the uv of its first..last texel centre
+		static float UnitToTexelUv(float unit, float resolution)
+		{
+			return 0.5f / resolution + unit * (resolution - 1.0f) / resolution;
+		}
+
+		static float TexelUvToUnit(float uv, float resolution)
+		{
+			return (uv - 0.5f / resolution) * resolution / (resolution - 1.0f);
+		}
+
+		// The sky-view LUT holds the sky for one sun elevation and camera
+		// altitude; the sun's azimuth is a rotation at lookup
+		static bool SkyViewStale(const AtmosphereParamsData& baked, const AtmosphereParamsData& current,
+			float thresholdDeg)
+		{
+			const float bakedElevation = std::asin(std::clamp(baked.sun.y, -1.0f, 1.0f));
+			const float elevation = std::asin(std::clamp(current.sun.y, -1.0f, 1.0f));
+			if (std::abs(elevation - bakedElevation) > glm::radians(std::max(thresholdDeg, 0.0f)))
+				return true;
+			return std::abs(current.radii.z - baked.radii.z) > SKY_VIEW_ALTITUDE_STEP_KM;
+		}
+
+		// Whether the transmittance and multi-scattering LUTs need rebuilding
+		static bool MediumChanged(const AtmosphereParamsData& baked, const AtmosphereParamsData& current)
+		{
+			return baked.radii.x != current.radii.x || baked.radii.y != current.radii.y ||
+				baked.radii.w != current.radii.w || baked.rayleigh != current.rayleigh ||
+				baked.mie != current.mie || glm::vec3(baked.ozone) != glm::vec3(current.ozone);
+		}
+
+	private:
+		static constexpr float PI = 3.14159265358979f;
+
+		static float DistanceToEdge(const AtmosphereParamsData& params, const glm::vec3& origin,
+			const glm::vec3& direction)
+		{
+			const float tBottom = RaySphereNearest(origin, direction, params.radii.x);
+			const float tTop = RaySphereNearest(origin, direction, params.radii.y);
+			if (tBottom < 0.0f)
+				return tTop;
+			if (tTop < 0.0f)
+				return tBottom;
+			return std::min(tBottom, tTop);
+		}
+	};
+}
@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+// AuxiliaryView.hpp
+//
+// Secondary cameras rendered alongside the main one from the same frame's
+// draw list - the editor's orthographic top/side viewports. The app culls
+// once for every view (Scene::BuildDrawList's auxFrusta fills each
+// command's auxViewMask) and hands the cameras to Renderer::SetAuxiliaryViews;
+// each then gets its own color target, drawn with the frame's shadow maps,
+// wind, sky LUTs and clusters rather than computing any of them again.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	static constexpr uint32_t MAX_AUXILIARY_VIEWS = 3;
+
+	struct AuxiliaryView
+	{
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);   // Vulkan Y-flip and reverse-Z, like Camera's
+		glm::vec3 position = glm::vec3(0.0f);
+		// Requested target size; clamped to the reflection target's extent
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	// Orthographic projection in the main camera's conventions (Y flipped for
+	// Vulkan, near -> 1 and far -> 0), for AuxiliaryView::projection
+	inline glm::mat4 MakeOrthographicReverseZ(float halfWidth, float halfHeight, float nearPlane, float farPlane)
+	{
+		glm::mat4 projection(1.0f);
+		projection[0][0] = 1.0f / halfWidth;
+		projection[1][1] = -1.0f / halfHeight;
+		projection[2][2] = 1.0f / (farPlane - nearPlane);
+		projection[3][2] = farPlane / (farPlane - nearPlane);
+		return projection;
+	}
+}
@@ -20,6 +20,7 @@ namespace Nightbloom
 	{
 		m_Fov = fovDegrees;
 		m_NearPlane = nearPlane;
+		m_Aspect = aspect;
 		m_Projection = glm::perspective(glm::radians(fovDegrees), aspect, nearPlane, farPlane);
 		m_Projection[1][1] *= -1.0f;  // Vulkan Y-flip
 		m_UseReverseZ = false;
@@ -33,6 +34,7 @@ namespace Nightbloom
 
 		m_Fov = fovDegrees;
 		m_NearPlane = nearPlane;
+		m_Aspect = aspect;
 
 		float fovRad = glm::radians(fovDegrees);
 		float tanHalfFov = tan(fovRad / 2.0f);
@@ -66,6 +68,7 @@ namespace Nightbloom
 
 		m_Fov = fovDegrees;
 		m_NearPlane = nearPlane;
+		m_Aspect = aspect;
 
 		float fovRad = glm::radians(fovDegrees);
 		float tanHalfFov = tan(fovRad / 2.0f);
@@ -59,6 +59,7 @@ namespace Nightbloom
 		// omitted — the editor uses the infinite-far reverse-Z projection.
 		float GetFov() const { return m_Fov; }
 		float GetNearPlane() const { return m_NearPlane; }
+		float GetAspect() const { return m_Aspect; }
 
 		// Settings
 		float moveSpeed = 5.0f;
@@ -88,6 +89,7 @@ namespace Nightbloom
 		// Cached projection params (recorded by SetPerspective*), for serialization.
 		float m_Fov = 45.0f;
 		float m_NearPlane = 0.1f;
+		float m_Aspect = 0.0f;
 
 		// Input accumulation
 		glm::vec3 m_MovementInput = glm::vec3(0.0f);  // x=right, y=up, z=forward
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// CaptureImage.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/CaptureImage.hpp"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Narkowicz's ACES fit, as post_process.glsl
+		float AcesFilmic(float x)
+		{
+			const float a = 2.51f, b = 0.03f, c = 2.43f, d = 0.59f, e = 0.14f;
+			return std::clamp((x * (a * x + b)) / (x * (c * x + d) + e), 0.0f, 1.0f);
+		}
+
+		uint8_t LinearToSrgb8(float c)
+		{
+			c = std::clamp(c, 0.0f, 1.0f);
+			const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+			return static_cast<uint8_t>(s * 255.0f + 0.5f);
+		}
+
+		// Splits `size` into as few spans of at most `maxSpan` as possible,
+		// the remainder spread over the first spans
+		void SplitEvenly(uint32_t size, uint32_t maxSpan, std::vector<uint32_t>& starts, std::vector<uint32_t>& sizes)
+		{
+			const uint32_t count = (size + maxSpan - 1) / maxSpan;
+			const uint32_t base = size / count;
+			const uint32_t extra = size % count;
+			uint32_t start = 0;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const uint32_t span = base + (i < extra ? 1 : 0);
+				starts.push_back(start);
+				sizes.push_back(span);
+				start += span;
+			}
+		}
+	}
+
+	std::vector<CaptureTile> PlanCaptureTiles(uint32_t width, uint32_t height, uint32_t maxWidth, uint32_t maxHeight)
+	{
+		std::vector<CaptureTile> tiles;
+		if (width == 0 || height == 0 || maxWidth == 0 || maxHeight == 0)
+			return tiles;
+
+		std::vector<uint32_t> xs, widths, ys, heights;
+		SplitEvenly(width, maxWidth, xs, widths);
+		SplitEvenly(height, maxHeight, ys, heights);
+
+		tiles.reserve(xs.size() * ys.size());
+		for (size_t row = 0; row < ys.size(); ++row)
+		{
+			for (size_t column = 0; column < xs.size(); ++column)
+				tiles.push_back({ xs[column], ys[row], widths[column], heights[row] });
+		}
+		return tiles;
+	}
+
+	glm::mat4 MakeTileProjection(const glm::mat4& projection, uint32_t width, uint32_t height, const CaptureTile& tile)
+	{
+		// The tile's NDC rect (framebuffer y: -1 is the top row, which the
+		// projection's Y flip already accounts for), scaled and offset onto
+		// [-1, 1]. Applied after the projection, before the divide by w.
+		const float x0 = 2.0f * tile.x / width - 1.0f;
+		const float x1 = 2.0f * (tile.x + tile.width) / width - 1.0f;
+		const float y0 = 2.0f * tile.y / height - 1.0f;
+		const float y1 = 2.0f * (tile.y + tile.height) / height - 1.0f;
+		const float scaleX = 2.0f / (x1 - x0);
+		const float scaleY = 2.0f / (y1 - y0);
+
+		glm::mat4 crop(1.0f);
+		crop[0][0] = scaleX;
+		crop[1][1] = scaleY;
+		crop[3][0] = -0.5f * (x0 + x1) * scaleX;
+		crop[3][1] = -0.5f * (y0 + y1) * scaleY;
+		return crop * projection;
+	}
+
+	void CopyCaptureTile(const uint32_t* texels, const CaptureTile& tile, uint32_t* image, uint32_t imageWidth)
+	{
+		for (uint32_t row = 0; row < tile.height; ++row)
+		{
+			std::memcpy(image + static_cast<size_t>(tile.y + row) * imageWidth + tile.x,
+				texels + static_cast<size_t>(row) * tile.width,
+				tile.width * sizeof(uint32_t));
+		}
+	}
+
+	void ConvertCaptureToHalf(const uint32_t* texels, size_t count, uint16_t* rgb)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 color = glm::unpackF2x11_1x10(texels[i]);
+			rgb[i * 3 + 0] = glm::packHalf1x16(color.r);
+			rgb[i * 3 + 1] = glm::packHalf1x16(color.g);
+			rgb[i * 3 + 2] = glm::packHalf1x16(color.b);
+		}
+	}
+
+	void ConvertCaptureToSrgb8(const uint32_t* texels, size_t count, float exposure, bool tonemap, uint8_t* rgb)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 color = glm::unpackF2x11_1x10(texels[i]) * exposure;
+			for (int c = 0; c < 3; ++c)
+				rgb[i * 3 + c] = LinearToSrgb8(tonemap ? AcesFilmic(color[c]) : color[c]);
+		}
+	}
+}
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+// CaptureImage.hpp
+//
+// The CPU half of offscreen captures (see OffscreenCapture.hpp): splitting an
+// output image into tiles no larger than a render target, the projection
+// that renders one tile of a camera, and turning the read-back texels into
+// what ImageWriter encodes.
+//
+// Captured texels stay in the scene color target's packed B10G11R11 format
+// (4 bytes a pixel) until the image is complete, so assembling a tile is a
+// row copy; they are decoded once, at encode time - to half floats for EXR,
+// or through the post-process pass's exposure and ACES curve to sRGB for PNG.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct CaptureTile
+	{
+		uint32_t x = 0;        // top-left pixel in the output image
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	// Row-major tiles covering width x height, none larger than maxWidth x
+	// maxHeight; as few as possible, split evenly so no tile is a sliver
+	std::vector<CaptureTile> PlanCaptureTiles(uint32_t width, uint32_t height, uint32_t maxWidth, uint32_t maxHeight);
+
+	// `projection` (Vulkan conventions, as Camera builds it) narrowed to the
+	// tile's part of a width x height image: the tile's pixels fill the whole
+	// viewport. Depth is untouched.
+	glm::mat4 MakeTileProjection(const glm::mat4& projection, uint32_t width, uint32_t height, const CaptureTile& tile);
+
+	// Copies a tile's tightly packed texels into an image imageWidth texels wide
+	void CopyCaptureTile(const uint32_t* texels, const CaptureTile& tile, uint32_t* image, uint32_t imageWidth);
+
+	// Packed B10G11R11 texels to interleaved half-float RGB
+	void ConvertCaptureToHalf(const uint32_t* texels, size_t count, uint16_t* rgb);
+
+	// Packed B10G11R11 texels to 8-bit sRGB RGB: exposure, then the ACES
+	// curve (or a clamp with tonemap off) and the sRGB transfer, as the
+	// post-process pass does before its vignette
+	void ConvertCaptureToSrgb8(const uint32_t* texels, size_t count, float exposure, bool tonemap, uint8_t* rgb);
+}
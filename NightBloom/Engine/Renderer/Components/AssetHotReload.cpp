@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+// AssetHotReload.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/AssetHotReload.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/AsyncAssetLoader.hpp"
+#include "Engine/Renderer/Vulkan/VulkanPipelineAdapter.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/Model.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <memory>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		std::string LowerExtension(const std::string& path)
+		{
+			std::string extension = std::filesystem::path(path).extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return extension;
+		}
+	}
+
+	AssetHotReload::~AssetHotReload()
+	{
+		Shutdown();
+	}
+
+	bool AssetHotReload::Initialize(ResourceManager* resources, AsyncAssetLoader* loader, VulkanPipelineAdapter* pipelines)
+	{
+		if (!resources || !loader)
+		{
+			LOG_ERROR("AssetHotReload requires a resource manager and an asset loader");
+			return false;
+		}
+
+		m_Resources = resources;
+		m_Loader = loader;
+		m_Pipelines = pipelines;
+
+		const AssetManager& assets = AssetManager::Get();
+		for (const std::string& directory : { assets.GetTexturesPath(), assets.GetModelsPath(), assets.GetShadersPath() })
+		{
+			if (!directory.empty())
+				m_Watcher.Watch(directory);
+		}
+
+		if (!m_Watcher.Start())
+		{
+			LOG_WARN("AssetHotReload: no asset folder to watch");
+			return false;
+		}
+
+		LOG_INFO("AssetHotReload: watching {} asset folders", m_Watcher.GetDirectories().size());
+		return true;
+	}
+
+	void AssetHotReload::Shutdown()
+	{
+		m_Watcher.Stop();
+		m_Resources = nullptr;
+		m_Loader = nullptr;
+		m_Pipelines = nullptr;
+	}
+
+	void AssetHotReload::Update()
+	{
+		if (!m_Loader)
+			return;
+
+		m_Changed.clear();
+		if (m_Watcher.Poll(m_Changed) == 0)
+			return;
+
+		for (const std::string& changed : m_Changed)
+		{
+			const std::string extension = LowerExtension(changed);
+			if (extension == ".spv")
+			{
+				const uint32_t reloads = m_Pipelines ? m_Pipelines->ReloadPipelinesUsingShaderAsync(changed) : 0;
+				m_Stats.pipelines += reloads;
+				m_Stats.ignored += reloads == 0 ? 1 : 0;
+				if (reloads > 0)
+					LOG_INFO("AssetHotReload: {} changed, rebuilding {} pipeline(s)", changed, reloads);
+			}
+			else if (extension == ".gltf" || extension == ".glb")
+			{
+				ReloadModels(changed, false);
+			}
+			else if (extension == ".bin")
+			{
+				ReloadModels(changed, true);
+			}
+			else
+			{
+				ReloadTextures(changed);
+			}
+		}
+	}
+
+	void AssetHotReload::ReloadTextures(const std::string& changed)
+	{
+		const std::vector<std::string> paths = m_Resources->FindTexturePathsForFile(changed);
+		if (paths.empty())
+		{
+			++m_Stats.ignored;
+			return;
+		}
+
+		for (const std::string& path : paths)
+		{
+			LOG_INFO("AssetHotReload: {} changed, reloading texture {}", changed, path);
+			if (m_Loader->ReloadTexture(path).IsValid())
+				++m_Stats.textures;
+		}
+	}
+
+	void AssetHotReload::ReloadModels(const std::string& changed, bool companionFile)
+	{
+		// A .bin belongs to whichever .gltf files sit next to it
+		const std::filesystem::path changedDirectory = std::filesystem::path(changed).parent_path();
+		std::vector<std::shared_ptr<Model>> models;
+		m_Resources->GetModelCache().ForEach([&](const std::string& source, const std::shared_ptr<Model>& model)
+			{
+				const std::string path = FileWatcher::NormalizePath(source);
+				const bool matches = companionFile
+					? LowerExtension(path) == ".gltf" && std::filesystem::path(path).parent_path() == changedDirectory
+					: path == changed;
+				if (matches)
+					models.push_back(model);
+			});
+
+		if (models.empty())
+		{
+			++m_Stats.ignored;
+			return;
+		}
+
+		for (const std::shared_ptr<Model>& model : models)
+		{
+			// The load under way may have read the file before this change;
+			// the next save catches it
+			if (model->IsLoading())
+				continue;
+
+			LOG_INFO("AssetHotReload: {} changed, reloading model '{}'", changed, model->GetName());
+			if (m_Loader->ReloadModel(model, m_OnModelReloaded).IsValid())
+				++m_Stats.models;
+		}
+	}
+}
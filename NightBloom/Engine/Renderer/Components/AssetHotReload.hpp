@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// AssetHotReload.hpp
+//
+// Reloads assets when their files change on disk, without stalling the
+// frame. A FileWatcher covers the AssetManager's texture, model and shader
+// folders; Update, once per frame at the frame boundary, maps each settled
+// change to what was loaded from it and reloads only that:
+//
+//   - a texture image or its cooked .ktx2: the textures loaded from it,
+//     decoded on the AsyncAssetLoader's threads and swapped into the same
+//     VulkanTexture objects (ResourceManager::ReloadTexture)
+//   - a .gltf/.glb: the models of the ModelCache loaded from it, and a .bin
+//     the .gltf models next to it; parsed on the loader's threads and
+//     swapped into the same Model objects (AsyncAssetLoader::ReloadModel)
+//   - a .spv: the pipelines with a stage compiled from it, rebuilt on a
+//     worker and swapped in by ProcessPendingReloads
+//
+// Replaced images, meshes and pipelines go through deferred destruction, so
+// frames in flight finish with the old ones. The engine only loads SPIR-V:
+// a GLSL edit reloads once the shader compiler has written its .spv.
+// Systems that load their own compute shaders (ocean, SSR, the
+// temporal upscaler) and models loaded outside the ModelCache still need
+// their explicit reloads.
+//
+// Usage:
+//   renderer->SetAssetHotReload(true);
+//   renderer->GetAssetHotReload()->SetModelReloadedCallback(
+//       [&scene](Model& model, bool ok) { if (ok) scene.RefreshReloadedModel(&model); });
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/FileWatcher.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	class ResourceManager;
+	class AsyncAssetLoader;
+	class VulkanPipelineAdapter;
+	class Model;
+
+	class AssetHotReload
+	{
+	public:
+		using ModelReloadedCallback = std::function<void(Model& model, bool reloaded)>;
+
+		struct Stats
+		{
+			uint32_t textures = 0;     // reloads started, by kind
+			uint32_t models = 0;
+			uint32_t pipelines = 0;
+			uint32_t ignored = 0;      // changed files nothing was loaded from
+		};
+
+		AssetHotReload() = default;
+		~AssetHotReload();
+
+		// Starts watching; false if none of the folders could be watched
+		bool Initialize(ResourceManager* resources, AsyncAssetLoader* loader, VulkanPipelineAdapter* pipelines);
+		void Shutdown();
+
+		// Main thread, once per frame before the asset loader's Update
+		void Update();
+
+		// Called on the main thread as each model reload finishes; objects
+		// using the model need their bounds and animation refreshed
+		void SetModelReloadedCallback(ModelReloadedCallback callback) { m_OnModelReloaded = std::move(callback); }
+
+		const Stats& GetStats() const { return m_Stats; }
+
+	private:
+		void ReloadTextures(const std::string& changed);
+		void ReloadModels(const std::string& changed, bool companionFile);
+
+		ResourceManager* m_Resources = nullptr;
+		AsyncAssetLoader* m_Loader = nullptr;
+		VulkanPipelineAdapter* m_Pipelines = nullptr;
+		ModelReloadedCallback m_OnModelReloaded;
+
+		FileWatcher m_Watcher;
+		std::vector<std::string> m_Changed;    // Update scratch
+		Stats m_Stats;
+
+		AssetHotReload(const AssetHotReload&) = delete;
+		AssetHotReload& operator=(const AssetHotReload&) = delete;
+	};
+}
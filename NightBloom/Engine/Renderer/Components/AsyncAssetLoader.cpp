@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+// AsyncAssetLoader.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/AsyncAssetLoader.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Model.hpp"
+#include "Engine/Renderer/GLTFLoader.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <thread>
+
+namespace Nightbloom
+{
+	AsyncAssetLoader::~AsyncAssetLoader()
+	{
+		Shutdown();
+	}
+
+	bool AsyncAssetLoader::Initialize(ResourceManager* resources, VulkanDescriptorManager* descriptorManager,
+		uint32_t threadCount)
+	{
+		if (!resources)
+		{
+			LOG_ERROR("AsyncAssetLoader requires a resource manager");
+			return false;
+		}
+
+		m_Resources = resources;
+		m_DescriptorManager = descriptorManager;
+		m_Queue.Start(threadCount);
+		return true;
+	}
+
+	void AsyncAssetLoader::Shutdown()
+	{
+		m_Queue.Stop();
+		m_Resources = nullptr;
+		m_DescriptorManager = nullptr;
+	}
+
+	AssetHandle AsyncAssetLoader::LoadModel(Model& model, const std::string& filepath, ModelCallback onLoaded)
+	{
+		if (!m_Resources)
+		{
+			LOG_ERROR("AsyncAssetLoader is not initialized");
+			return {};
+		}
+
+		struct Job
+		{
+			std::unique_ptr<ModelData> data;
+			PreparedTextureMap textures;
+		};
+		auto job = std::make_shared<Job>();
+		const ResourceManager* resources = m_Resources;
+
+		AssetHandle handle = m_Queue.Submit(
+			[job, resources, filepath]()
+			{
+				GLTFLoader loader;
+				job->data = loader.Load(filepath);
+				if (!job->data)
+					return;
+
+				// One after another: the job system's threads belong to the
+				// frame
+				for (const std::string& path : Model::GetTexturePaths(*job->data))
+					job->textures.emplace(path, resources->PrepareTexture(path));
+			},
+			[this, job, &model, filepath, onLoaded = std::move(onLoaded)]()
+			{
+				bool loaded = false;
+				if (job->data)
+					loaded = model.LoadFromData(*job->data, m_Resources, m_DescriptorManager, &job->textures);
+				else
+					LOG_ERROR("Failed to load model from file: {}", filepath);
+
+				if (onLoaded)
+					onLoaded(model, loaded);
+				return loaded;
+			});
+
+		model.SetPendingLoad(handle, filepath);
+		return handle;
+	}
+
+	AssetHandle AsyncAssetLoader::LoadTexture(const std::string& name, const std::string& filepath,
+		TextureCallback onLoaded, bool allowStreaming)
+	{
+		if (!m_Resources)
+		{
+			LOG_ERROR("AsyncAssetLoader is not initialized");
+			return {};
+		}
+
+		auto prepared = std::make_shared<PreparedTexture>();
+		const ResourceManager* resources = m_Resources;
+		const bool exists = m_Resources->GetTexture(name) != nullptr;
+
+		return m_Queue.Submit(
+			[prepared, resources, filepath, exists]()
+			{
+				if (!exists)
+					*prepared = resources->PrepareTexture(filepath);
+			},
+			[this, prepared, name, allowStreaming, onLoaded = std::move(onLoaded)]()
+			{
+				VulkanTexture* texture = m_Resources->CreatePreparedTexture(name, *prepared, allowStreaming);
+				if (onLoaded)
+					onLoaded(texture);
+				return texture != nullptr;
+			});
+	}
+
+	AssetHandle AsyncAssetLoader::ReloadModel(const std::shared_ptr<Model>& model, ModelCallback onReloaded)
+	{
+		if (!model || model->GetSourcePath().empty())
+		{
+			LOG_WARN("AsyncAssetLoader: can't reload a model without a source file");
+			return {};
+		}
+
+		// Same name, so its material table entries overwrite the old ones
+		auto fresh = std::make_shared<Model>(model->GetName());
+		fresh->SetVertexFormat(model->GetVertexFormat());
+		std::weak_ptr<Model> target = model;
+		ResourceManager* resources = m_Resources;
+
+		return LoadModel(*fresh, model->GetSourcePath(),
+			[fresh, target, resources, onReloaded = std::move(onReloaded)](Model&, bool loaded) mutable
+			{
+				std::shared_ptr<Model> live = target.lock();
+				if (!live)
+					return;
+
+				if (loaded)
+				{
+					// Frames in flight may still draw the old meshes
+					live->SwapContents(*fresh);
+					resources->Defer([old = std::move(fresh)]() mutable { old.reset(); });
+					LOG_INFO("Reloaded model '{}' from {}", live->GetName(), live->GetSourcePath());
+				}
+				else
+				{
+					LOG_WARN("Reloading model '{}' failed, keeping the old one", live->GetName());
+				}
+
+				if (onReloaded)
+					onReloaded(*live, loaded);
+			});
+	}
+
+	AssetHandle AsyncAssetLoader::ReloadTexture(const std::string& filepath)
+	{
+		if (!m_Resources)
+		{
+			LOG_ERROR("AsyncAssetLoader is not initialized");
+			return {};
+		}
+
+		auto prepared = std::make_shared<PreparedTexture>();
+		const ResourceManager* resources = m_Resources;
+
+		return m_Queue.Submit(
+			[prepared, resources, filepath]()
+			{
+				*prepared = resources->PrepareTexture(filepath);
+			},
+			[this, prepared]()
+			{
+				const uint32_t reloaded = m_Resources->ReloadTexture(*prepared);
+				if (reloaded > 0)
+					LOG_INFO("Reloaded {} texture(s) from {}", reloaded, prepared->path);
+				return reloaded > 0;
+			});
+	}
+
+	void AsyncAssetLoader::Update(uint32_t maxCompletions)
+	{
+		m_Queue.RunCompletions(maxCompletions);
+	}
+
+	bool AsyncAssetLoader::Wait(const AssetHandle& handle)
+	{
+		if (!handle.IsValid())
+			return false;
+
+		while (!handle.IsDone())
+		{
+			if (m_Queue.RunCompletions() == 0)
+				std::this_thread::yield();
+		}
+		return handle.IsReady();
+	}
+
+	VulkanTexture* AsyncAssetLoader::GetTextureOrPlaceholder(const std::string& name) const
+	{
+		if (!m_Resources)
+			return nullptr;
+
+		VulkanTexture* texture = m_Resources->GetTexture(name);
+		return texture ? texture : m_Resources->GetTexture("default_white");
+	}
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// AsyncAssetLoader.hpp
+//
+// Background model and texture loading on an AssetLoadQueue. File reads,
+// glTF parsing and image decoding run on the loader's threads; Update(),
+// called once per frame on the main thread, creates the GPU objects of the
+// loads that are ready - each model's buffers and textures in one upload
+// batch - and fires their completion callbacks.
+//
+// Until then a loading model is empty (draws nothing) and a loading
+// texture's name resolves to GetTextureOrPlaceholder's fallback. A Model
+// loading into must stay where it is; destroying it cancels the load.
+//
+// Usage:
+//   auto model = std::make_shared<Model>();
+//   loader->LoadModel(*model, "Models/car.glb", [](Model& m, bool ok) { ... });
+//   scene.AddObject("Car", model);
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/AssetLoadQueue.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Nightbloom
+{
+	class ResourceManager;
+	class VulkanDescriptorManager;
+	class VulkanTexture;
+	class Model;
+
+	class AsyncAssetLoader
+	{
+	public:
+		static constexpr uint32_t DEFAULT_THREAD_COUNT = 2;
+
+		// Loads finished per Update; each one uploads a whole model or
+		// texture, so this bounds the main-thread cost of a frame
+		static constexpr uint32_t DEFAULT_COMPLETIONS_PER_FRAME = 2;
+
+		using ModelCallback = std::function<void(Model& model, bool loaded)>;
+		using TextureCallback = std::function<void(VulkanTexture* texture)>;   // null on failure
+
+		AsyncAssetLoader() = default;
+		~AsyncAssetLoader();
+
+		bool Initialize(ResourceManager* resources, VulkanDescriptorManager* descriptorManager,
+			uint32_t threadCount = DEFAULT_THREAD_COUNT);
+
+		// Cancels whatever is still loading; before the resource manager goes
+		void Shutdown();
+
+		// Fills `model` the way Model::LoadFromFile does
+		AssetHandle LoadModel(Model& model, const std::string& filepath, ModelCallback onLoaded = {});
+
+		// ResourceManager::LoadTexture in the background; an existing texture
+		// of that name completes on the next Update
+		AssetHandle LoadTexture(const std::string& name, const std::string& filepath,
+			TextureCallback onLoaded = {}, bool allowStreaming = true);
+
+		// Hot reload (AssetHotReload.hpp). ReloadModel reads the model's
+		// source file again into a new Model and, once that has loaded,
+		// swaps it into `model` (Model::SwapContents); the old contents go
+		// through ResourceManager::Defer. A failed load keeps the old
+		// contents, and a model released meanwhile is left alone (no
+		// callback). ReloadTexture re-reads `filepath` and rebuilds the
+		// textures loaded from it (ResourceManager::ReloadTexture).
+		AssetHandle ReloadModel(const std::shared_ptr<Model>& model, ModelCallback onReloaded = {});
+		AssetHandle ReloadTexture(const std::string& filepath);
+
+		// Main thread, once per frame
+		void Update(uint32_t maxCompletions = DEFAULT_COMPLETIONS_PER_FRAME);
+
+		// Main thread: finishes loads until `handle` is done. Returns whether
+		// it loaded.
+		bool Wait(const AssetHandle& handle);
+
+		// The texture called `name`, or the default white one while it loads
+		VulkanTexture* GetTextureOrPlaceholder(const std::string& name) const;
+
+		size_t GetPendingCount() const { return m_Queue.GetPendingCount(); }
+
+	private:
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+		AssetLoadQueue m_Queue;
+
+		AsyncAssetLoader(const AsyncAssetLoader&) = delete;
+		AsyncAssetLoader& operator=(const AsyncAssetLoader&) = delete;
+	};
+}
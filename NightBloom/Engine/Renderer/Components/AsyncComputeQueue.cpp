@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+// AsyncComputeQueue.cpp
+//------------------------------------------------------------------------------
+#include "Engine/Renderer/Components/AsyncComputeQueue.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	AsyncComputeQueue::AsyncComputeQueue() = default;
+	AsyncComputeQueue::~AsyncComputeQueue() { Cleanup(); }
+
+	bool AsyncComputeQueue::Initialize(VulkanDevice* device)
+	{
+		m_Device = device;
+		m_Available = false;
+
+		VulkanQueueTimeline* timeline = device->GetGraphicsTimeline();
+		if (!device->HasAsyncComputeQueue() || !timeline || !timeline->UsesTimelineSemaphore())
+		{
+			LOG_INFO("Async compute unavailable - compute work stays on the graphics queue");
+			return true;  // not fatal
+		}
+
+		m_QueueFamily = device->GetComputeQueueFamily();
+
+		m_CommandPool = std::make_unique<VulkanCommandPool>(device);
+		if (!m_CommandPool->Initialize(m_QueueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT))
+		{
+			LOG_ERROR("Failed to create async compute command pool");
+			Cleanup();
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_CommandBuffers[i] = m_CommandPool->AllocateCommandBuffer();
+
+			VkSemaphoreCreateInfo semaphoreInfo{};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			if (m_CommandBuffers[i] == VK_NULL_HANDLE ||
+				vkCreateSemaphore(device->GetDevice(), &semaphoreInfo, nullptr, &m_FinishedSemaphores[i]) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to create async compute frame {}", i);
+				Cleanup();
+				return false;
+			}
+		}
+
+		m_Available = true;
+		LOG_INFO("Async compute initialized on queue family {}", m_QueueFamily);
+		return true;
+	}
+
+	void AsyncComputeQueue::Cleanup()
+	{
+		if (!m_Device) return;
+
+		for (VkSemaphore& semaphore : m_FinishedSemaphores)
+		{
+			if (semaphore != VK_NULL_HANDLE)
+			{
+				vkDestroySemaphore(m_Device->GetDevice(), semaphore, nullptr);
+				semaphore = VK_NULL_HANDLE;
+			}
+		}
+
+		// Destroying the pool frees its command buffers
+		if (m_CommandPool)
+		{
+			m_CommandPool->Shutdown();
+			m_CommandPool.reset();
+		}
+		m_CommandBuffers.fill(VK_NULL_HANDLE);
+
+		m_Available = false;
+		m_Device = nullptr;
+	}
+
+	VkCommandBuffer AsyncComputeQueue::Begin(uint32_t frameIndex)
+	{
+		if (!m_Available || frameIndex >= MAX_FRAMES_IN_FLIGHT) return VK_NULL_HANDLE;
+
+		VkCommandBuffer cmd = m_CommandBuffers[frameIndex];
+		vkResetCommandBuffer(cmd, 0);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to begin async compute command buffer {}", frameIndex);
+			return VK_NULL_HANDLE;
+		}
+		return cmd;
+	}
+
+	bool AsyncComputeQueue::Submit(uint32_t frameIndex, uint64_t graphicsWaitValue)
+	{
+		if (!m_Available || frameIndex >= MAX_FRAMES_IN_FLIGHT) return false;
+
+		VkCommandBuffer cmd = m_CommandBuffers[frameIndex];
+		if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to record async compute command buffer {}", frameIndex);
+			return false;
+		}
+
+		VkSemaphore waitSemaphore = m_Device->GetGraphicsTimeline()->GetSemaphore();
+		// All commands, not just dispatches: the first barriers (layout
+		// transitions from UNDEFINED, with no source stage) must not start
+		// before graphics has stopped reading the images they discard
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		VkSemaphore signalSemaphore = m_FinishedSemaphores[frameIndex];
+		const uint64_t signalValue = 0;  // binary
+		const uint32_t waitCount = (graphicsWaitValue > 0) ? 1u : 0u;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = waitCount;
+		timelineInfo.pWaitSemaphoreValues = &graphicsWaitValue;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.waitSemaphoreCount = waitCount;
+		submitInfo.pWaitSemaphores = &waitSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStage;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &cmd;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &signalSemaphore;
+
+		const VkResult result = vkQueueSubmit(m_Device->GetComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Async compute submit failed: {}", static_cast<int>(result));
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+// AsyncComputeQueue.hpp
+//
+// Per-frame command buffers for the device's async compute queue (a family
+// with COMPUTE but no GRAPHICS), so compute work that doesn't depend on the
+// frame's rendering overlaps the passes ahead of its consumers instead of
+// being serialized with them in the graphics command buffer.
+//
+// Ordering, per frame slot:
+//   - Submit() waits for a graphics timeline value (the previous frame's
+//     last submission, which released the shared resources back to compute)
+//     and signals the slot's binary "finished" semaphore
+//   - the graphics submission that consumes the results waits on that
+//     semaphore (FrameSyncManager::SubmitCommandBuffer's extra wait)
+// The graphics frame wait that precedes re-recording a slot therefore also
+// covers its compute command buffer.
+//
+// Needs a dedicated compute family and timeline semaphores (the wait on the
+// graphics queue is a timeline value); IsAvailable() is false otherwise and
+// the Renderer records the same work into the graphics command buffer.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/FrameConfig.hpp"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <memory>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanCommandPool;
+
+	class AsyncComputeQueue
+	{
+	public:
+		AsyncComputeQueue();
+		~AsyncComputeQueue();
+
+		// Not fatal when unsupported: returns true with IsAvailable() false
+		bool Initialize(VulkanDevice* device);
+		void Cleanup();
+
+		bool IsAvailable() const { return m_Available; }
+
+		// Resets and begins the slot's command buffer
+		VkCommandBuffer Begin(uint32_t frameIndex);
+		// Ends and submits it after the graphics timeline reaches graphicsWaitValue
+		// (0 = no wait). False on failure; the finished semaphore is then unsignalled.
+		bool Submit(uint32_t frameIndex, uint64_t graphicsWaitValue);
+
+		VkSemaphore GetFinishedSemaphore(uint32_t frameIndex) const { return m_FinishedSemaphores[frameIndex]; }
+		uint32_t GetQueueFamily() const { return m_QueueFamily; }
+
+		// Compute-family pool for one-shot work (VulkanSingleTimeCommand)
+		VulkanCommandPool* GetCommandPool() const { return m_CommandPool.get(); }
+
+	private:
+		VulkanDevice* m_Device = nullptr;
+		bool m_Available = false;
+		uint32_t m_QueueFamily = 0;
+
+		std::unique_ptr<VulkanCommandPool> m_CommandPool;
+		std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> m_CommandBuffers{};
+		std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_FinishedSemaphores{};
+
+		AsyncComputeQueue(const AsyncComputeQueue&) = delete;
+		AsyncComputeQueue& operator=(const AsyncComputeQueue&) = delete;
+	};
+}
@@ -0,0 +1,359 @@
+//------------------------------------------------------------------------------
+// AtmosphereLuts.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/AtmosphereLuts.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t ATMOSPHERE_LOCAL_SIZE = 8;  // all four shaders, 8x8
+		constexpr VkFormat LUT_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+		constexpr const char* LUT_SHADERS[] = {
+			"AtmosphereTransmittance.comp.spv",
+			"AtmosphereMultiScatter.comp.spv",
+			"AtmosphereSkyView.comp.spv",
+			"AtmosphereAerial.comp.spv",
+		};
+
+		constexpr VkPipelineStageFlags ALL_READERS =
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+
+	bool AtmosphereLuts::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_DescriptorManager = descriptorManager;
+
+		// The atmosphere LUT set layout bakes this in as its immutable sampler
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(VulkanSamplerCache::LinearClamp());
+		if (m_Sampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("AtmosphereLuts: failed to create sampler");
+			return false;
+		}
+
+		m_LutSet = m_DescriptorManager->AllocateAtmosphereLutSet();
+		if (m_LutSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("AtmosphereLuts: failed to allocate descriptor set");
+			return false;
+		}
+
+		if (!CreateImage(TRANSMITTANCE, Atmosphere::TRANSMITTANCE_WIDTH, Atmosphere::TRANSMITTANCE_HEIGHT, 1,
+				"AtmosphereTransmittance") ||
+			!CreateImage(MULTI_SCATTERING, Atmosphere::MULTI_SCATTERING_SIZE, Atmosphere::MULTI_SCATTERING_SIZE, 1,
+				"AtmosphereMultiScatter") ||
+			!CreateImage(SKY_VIEW, Atmosphere::SKY_VIEW_WIDTH, Atmosphere::SKY_VIEW_HEIGHT, 1, "AtmosphereSkyView") ||
+			!CreateImage(AERIAL, Atmosphere::AERIAL_SIZE, Atmosphere::AERIAL_SIZE, Atmosphere::AERIAL_SIZE,
+				"AtmosphereAerial"))
+			return false;
+
+		m_DescriptorManager->UpdateAtmosphereLutSet(m_LutSet, m_Luts[TRANSMITTANCE].view,
+			m_Luts[MULTI_SCATTERING].view, m_Luts[SKY_VIEW].view, m_Luts[AERIAL].view, m_Sampler);
+
+		// Without the pipelines Prepare reports no atmosphere and the scene
+		// shaders fall back to the clear colour; the LUTs stay bound either way
+		if (!CreatePipelines())
+			LOG_WARN("AtmosphereLuts: no bake pipelines, the sky stays the clear colour");
+
+		m_DescriptorManager->UpdateAtmosphereBindings(m_Luts[SKY_VIEW].view, m_Luts[AERIAL].view, m_Sampler);
+
+		LOG_INFO("AtmosphereLuts initialized (sky-view {}x{}, aerial {}^3)",
+			Atmosphere::SKY_VIEW_WIDTH, Atmosphere::SKY_VIEW_HEIGHT, Atmosphere::AERIAL_SIZE);
+		return true;
+	}
+
+	void AtmosphereLuts::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		DestroyPipelines();
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		for (LutImage& lut : m_Luts)
+		{
+			if (lut.view != VK_NULL_HANDLE)
+				vkDestroyImageView(device, lut.view, nullptr);
+			if (lut.allocation)
+				m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(lut.allocation));
+			lut = LutImage{};
+		}
+		m_Sampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_MediumValid = false;
+		m_SkyViewValid = false;
+		m_Cleared = false;
+		m_Device = nullptr;
+	}
+
+	bool AtmosphereLuts::CreateImage(Lut lut, uint32_t width, uint32_t height, uint32_t depth, const char* name)
+	{
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = width;
+		imageInfo.height = height;
+		imageInfo.depth = depth;
+		imageInfo.format = LUT_FORMAT;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageInfo.category = GpuMemoryCategory::Effects;
+		imageInfo.debugName = name;
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("AtmosphereLuts: failed to create {}", name);
+			return false;
+		}
+		m_Luts[lut].allocation = allocation;
+		m_Luts[lut].image = allocation->image;
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_Luts[lut].image;
+		viewInfo.viewType = depth > 1 ? VK_IMAGE_VIEW_TYPE_3D : VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = LUT_FORMAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(m_Device->GetDevice(), &viewInfo, nullptr, &m_Luts[lut].view) != VK_SUCCESS)
+		{
+			LOG_ERROR("AtmosphereLuts: failed to create the {} view", name);
+			return false;
+		}
+		return true;
+	}
+
+	bool AtmosphereLuts::CreatePipelines()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(AtmosphereParamsData);
+
+		// set 0 = the LUTs, set 1 = the camera's uniform set (aerial only)
+		std::array<VkDescriptorSetLayout, 2> setLayouts = {
+			m_DescriptorManager->GetAtmosphereLutSetLayout(),
+			m_DescriptorManager->GetUniformSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		layoutInfo.pSetLayouts = setLayouts.data();
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("AtmosphereLuts: failed to create pipeline layout");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < LUT_COUNT; ++i)
+		{
+			auto shaderCode = AssetManager::Get().LoadShaderBinary(LUT_SHADERS[i]);
+			if (!shaderCode.IsOpen())
+			{
+				LOG_ERROR("AtmosphereLuts: failed to load {}", LUT_SHADERS[i]);
+				DestroyPipelines();
+				return false;
+			}
+
+			VkShaderModuleCreateInfo moduleInfo{};
+			moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			moduleInfo.codeSize = shaderCode.GetSize();
+			moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+			VkShaderModule shaderModule = VK_NULL_HANDLE;
+			if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+			{
+				LOG_ERROR("AtmosphereLuts: failed to create shader module for {}", LUT_SHADERS[i]);
+				DestroyPipelines();
+				return false;
+			}
+
+			VkComputePipelineCreateInfo pipelineInfo{};
+			pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+			pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+			pipelineInfo.stage.module = shaderModule;
+			pipelineInfo.stage.pName = "main";
+			pipelineInfo.layout = m_PipelineLayout;
+
+			VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr,
+				&m_Pipelines[i]);
+			vkDestroyShaderModule(device, shaderModule, nullptr);
+
+			if (result != VK_SUCCESS)
+			{
+				LOG_ERROR("AtmosphereLuts: failed to create compute pipeline for {}", LUT_SHADERS[i]);
+				m_Pipelines[i] = VK_NULL_HANDLE;
+				DestroyPipelines();
+				return false;
+			}
+			VulkanDebugMarkers::SetName(device, m_Pipelines[i], LUT_SHADERS[i]);
+		}
+		return true;
+	}
+
+	void AtmosphereLuts::DestroyPipelines()
+	{
+		// All or nothing, so CanBake can look at any one of them
+		for (VkPipeline& pipeline : m_Pipelines)
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(m_Device->GetDevice(), pipeline, nullptr);
+			pipeline = VK_NULL_HANDLE;
+		}
+	}
+
+	AtmosphereParamsData AtmosphereLuts::Prepare(const AtmosphereSettings& settings, const glm::vec3& towardSun,
+		float cameraY)
+	{
+		m_Params = Atmosphere::BuildParams(settings, towardSun, cameraY);
+		m_Active = m_Params.sun.w > 0.0f && CanBake() && m_Luts[AERIAL].image != VK_NULL_HANDLE;
+		if (!m_Active)
+		{
+			m_Params = AtmosphereParamsData{};
+			return m_Params;
+		}
+
+		m_RebuildMedium = !m_MediumValid || Atmosphere::MediumChanged(m_Baked, m_Params);
+		m_RebuildSkyView = m_RebuildMedium || !m_SkyViewValid ||
+			Atmosphere::SkyViewStale(m_Baked, m_Params, settings.updateThresholdDeg);
+		if (m_RebuildSkyView)
+			m_Baked = m_Params;
+
+		// The sky-view LUT's horizon mapping is for the altitude it was baked
+		// at; the froxels use the same so the haze meets the sky
+		m_Params.radii.z = m_Baked.radii.z;
+		return m_Params;
+	}
+
+	void AtmosphereLuts::Clear(VkCommandBuffer cmd)
+	{
+		VkClearColorValue black{};
+		for (LutImage& lut : m_Luts)
+		{
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = lut.initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = lut.image;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.levelCount = 1;
+			barrier.subresourceRange.layerCount = 1;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			vkCmdPipelineBarrier(cmd, ALL_READERS, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			vkCmdClearColorImage(cmd, lut.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &black, 1,
+				&barrier.subresourceRange);
+
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, ALL_READERS,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+			lut.initialized = true;
+		}
+	}
+
+	void AtmosphereLuts::Bake(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, Lut lut,
+		const AtmosphereParamsData& params, uint32_t width, uint32_t height, VkPipelineStageFlags readers)
+	{
+		LutImage& image = m_Luts[lut];
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = image.initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image.image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, ALL_READERS, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		dispatcher->BindPipeline(cmd, m_Pipelines[lut]);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &params, sizeof(params));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(width, ATMOSPHERE_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(height, ATMOSPHERE_LOCAL_SIZE));
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, readers,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		image.initialized = true;
+	}
+
+	void AtmosphereLuts::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet uniformSet)
+	{
+		if (m_Luts[AERIAL].image == VK_NULL_HANDLE)
+			return;
+
+		if (!m_Active || !dispatcher || uniformSet == VK_NULL_HANDLE)
+		{
+			// Already cleared since the last bake
+			if (!m_Cleared)
+				Clear(cmd);
+			m_Cleared = true;
+			m_MediumValid = false;
+			m_SkyViewValid = false;
+			return;
+		}
+
+		const std::vector<VkDescriptorSet> sets = { m_LutSet, uniformSet };
+		dispatcher->BindDescriptorSets(cmd, m_PipelineLayout, 0, sets);
+
+		// Each LUT feeds the next: transmittance -> multi-scattering -> the
+		// sky-view and the froxels, which the scene's fragment shaders read
+		if (m_RebuildMedium)
+		{
+			Bake(cmd, dispatcher, TRANSMITTANCE, m_Baked, Atmosphere::TRANSMITTANCE_WIDTH,
+				Atmosphere::TRANSMITTANCE_HEIGHT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+			Bake(cmd, dispatcher, MULTI_SCATTERING, m_Baked, Atmosphere::MULTI_SCATTERING_SIZE,
+				Atmosphere::MULTI_SCATTERING_SIZE, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+			m_MediumValid = true;
+		}
+		if (m_RebuildSkyView)
+		{
+			Bake(cmd, dispatcher, SKY_VIEW, m_Baked, Atmosphere::SKY_VIEW_WIDTH, Atmosphere::SKY_VIEW_HEIGHT,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+			m_SkyViewValid = true;
+		}
+		Bake(cmd, dispatcher, AERIAL, m_Params, Atmosphere::AERIAL_SIZE, Atmosphere::AERIAL_SIZE,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+		m_RebuildMedium = false;
+		m_RebuildSkyView = false;
+		m_Cleared = false;
+	}
+}
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+// AtmosphereLuts.hpp
+//
+// The atmosphere (Atmosphere.hpp) baked into four rgba16f LUTs by compute
+// passes, Hillaire-style:
+//   AtmosphereTransmittance.comp  -> transmittance      (medium changes only)
+//   AtmosphereMultiScatter.comp   -> multi-scattering   (medium changes only)
+//   AtmosphereSkyView.comp        -> sky-view           (sun elevation or camera
+//                                                        altitude past a threshold)
+//   AtmosphereAerial.comp         -> aerial perspective (every frame: froxels
+//                                                        follow the camera)
+// The sky-view LUT and the froxels are bound at set 0 bindings 3 and 4 of
+// every scene-pass uniform set, so the sky (Sky.frag), the water's
+// reflection of it and the terrain's haze are lookups (sky.glsl).
+// FrameUniformData::atmosphere is what Prepare returns.
+//
+// Disabled (or without compute), the LUTs are cleared once and sun.w is 0,
+// which the shaders read as "no atmosphere": the sky falls back to the clear
+// colour.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Atmosphere.hpp"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+
+	class AtmosphereLuts
+	{
+	public:
+		AtmosphereLuts() = default;
+		~AtmosphereLuts() = default;
+
+		// Also writes the sky-view LUT and the froxels into every
+		// uniform-layout set (bindings 3 and 4)
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager);
+		void Cleanup();
+
+		// While filling the frame's uniforms: picks which LUTs Record rebuilds
+		// and returns the parameters the shaders should see - all zero when
+		// the atmosphere is off or cannot be baked
+		AtmosphereParamsData Prepare(const AtmosphereSettings& settings, const glm::vec3& towardSun, float cameraY);
+
+		// Before the reflection and scene passes, outside any render pass.
+		// uniformSet is this frame's camera set (the froxels' view rays).
+		// Leaves the LUTs sampler-ready for fragment shaders.
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet uniformSet);
+
+		bool CanBake() const { return m_Pipelines[AERIAL] != VK_NULL_HANDLE; }
+
+		VkImage GetSkyViewImage() const { return m_Luts[SKY_VIEW].image; }
+		VkImage GetAerialImage() const { return m_Luts[AERIAL].image; }
+
+	private:
+		enum Lut : uint32_t { TRANSMITTANCE, MULTI_SCATTERING, SKY_VIEW, AERIAL, LUT_COUNT };
+
+		struct LutImage
+		{
+			VkImage image = VK_NULL_HANDLE;
+			void* allocation = nullptr;   // VulkanMemoryManager::ImageAllocation*
+			VkImageView view = VK_NULL_HANDLE;
+			bool initialized = false;     // out of UNDEFINED
+		};
+
+		bool CreateImage(Lut lut, uint32_t width, uint32_t height, uint32_t depth, const char* name);
+		bool CreatePipelines();
+		void DestroyPipelines();
+		void Clear(VkCommandBuffer cmd);
+		void Bake(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, Lut lut, const AtmosphereParamsData& params,
+			uint32_t width, uint32_t height, VkPipelineStageFlags readers);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		std::array<LutImage, LUT_COUNT> m_Luts{};
+		VkSampler m_Sampler = VK_NULL_HANDLE;  // linear, clamp to edge
+		VkDescriptorSet m_LutSet = VK_NULL_HANDLE;
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		std::array<VkPipeline, LUT_COUNT> m_Pipelines{};
+
+		AtmosphereParamsData m_Params;   // this frame's, as Prepare returned them
+		AtmosphereParamsData m_Baked;    // what the sky-view LUT was built for
+		bool m_Active = false;
+		bool m_MediumValid = false;      // transmittance and multi-scattering hold m_Baked's medium
+		bool m_SkyViewValid = false;
+		bool m_RebuildMedium = false;
+		bool m_RebuildSkyView = false;
+		bool m_Cleared = false;          // cleared since the last bake
+
+		AtmosphereLuts(const AtmosphereLuts&) = delete;
+		AtmosphereLuts& operator=(const AtmosphereLuts&) = delete;
+	};
+}
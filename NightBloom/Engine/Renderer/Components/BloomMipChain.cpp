@@ -0,0 +1,330 @@
+//------------------------------------------------------------------------------
+// BloomMipChain.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/BloomMipChain.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/RenderPassManager.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t BLOOM_LOCAL_SIZE = 8;  // bloom.glsl
+
+		// Matches BloomParams in bloom.glsl
+		struct BloomPushConstants
+		{
+			glm::ivec4 sizes;   // xy = source size, zw = target size
+			glm::vec4 params;
+		};
+		static_assert(sizeof(BloomPushConstants) == 32, "Must match bloom.glsl");
+		static_assert(BloomMipChain::MAX_MIPS == RenderPassManager::MAX_BLOOM_MIPS, "Chain sizes must agree");
+
+		// Soft knee width relative to the threshold
+		constexpr float KNEE_FRACTION = 0.5f;
+	}
+
+	bool BloomMipChain::Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager,
+		VkImageView sceneColorView, VkExtent2D sceneExtent,
+		VkImage chainImage, VkExtent2D chainExtent, uint32_t mipCount)
+	{
+		m_Device = device;
+		m_DescriptorManager = descriptorManager;
+
+		// The bloom mip set layout bakes this in as its immutable sampler
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(VulkanSamplerCache::LinearClamp());
+		if (m_Sampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("BloomMipChain: failed to create sampler");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_MIPS; ++i)
+		{
+			m_DownSets[i] = m_DescriptorManager->AllocateBloomMipSet();
+			m_UpSets[i] = m_DescriptorManager->AllocateBloomMipSet();
+			if (m_DownSets[i] == VK_NULL_HANDLE || m_UpSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("BloomMipChain: failed to allocate descriptor sets");
+				return false;
+			}
+		}
+		m_OutputSet = m_DescriptorManager->AllocatePostProcessInputSet();
+		if (m_OutputSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("BloomMipChain: failed to allocate output set");
+			return false;
+		}
+
+		if (!CreatePipelines())
+			return false;
+
+		if (!CreateViews(sceneColorView, sceneExtent, chainImage, chainExtent, mipCount))
+			return false;
+
+		LOG_INFO("BloomMipChain initialized ({}x{}, {} levels)", chainExtent.width, chainExtent.height, m_MipCount);
+		return true;
+	}
+
+	void BloomMipChain::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		DestroyViews();
+
+		VkPipeline pipelines[] = { m_PrefilterPipeline, m_DownsamplePipeline, m_UpsamplePipeline };
+		for (VkPipeline pipeline : pipelines)
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+		}
+		m_PrefilterPipeline = m_DownsamplePipeline = m_UpsamplePipeline = VK_NULL_HANDLE;
+
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		m_Sampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_Device = nullptr;
+	}
+
+	bool BloomMipChain::Resize(VkImageView sceneColorView, VkExtent2D sceneExtent,
+		VkImage chainImage, VkExtent2D chainExtent, uint32_t mipCount)
+	{
+		DestroyViews();
+		return CreateViews(sceneColorView, sceneExtent, chainImage, chainExtent, mipCount);
+	}
+
+	bool BloomMipChain::CreateViews(VkImageView sceneColorView, VkExtent2D sceneExtent,
+		VkImage chainImage, VkExtent2D chainExtent, uint32_t mipCount)
+	{
+		if (sceneColorView == VK_NULL_HANDLE || chainImage == VK_NULL_HANDLE || mipCount == 0)
+			return false;
+
+		VkDevice device = m_Device->GetDevice();
+		m_Image = chainImage;
+		m_SceneExtent = sceneExtent;
+		m_MipCount = std::min(mipCount, MAX_MIPS);
+
+		for (uint32_t mip = 0; mip < m_MipCount; ++mip)
+		{
+			m_MipExtents[mip] = { std::max(chainExtent.width >> mip, 1u), std::max(chainExtent.height >> mip, 1u) };
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = chainImage;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = RenderPassManager::BLOOM_FORMAT;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewInfo.subresourceRange.baseMipLevel = mip;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.layerCount = 1;
+			if (vkCreateImageView(device, &viewInfo, nullptr, &m_MipViews[mip]) != VK_SUCCESS)
+			{
+				LOG_ERROR("BloomMipChain: failed to create view for level {}", mip);
+				return false;
+			}
+		}
+
+		for (uint32_t mip = 0; mip < m_MipCount; ++mip)
+		{
+			if (mip == 0)
+			{
+				m_DescriptorManager->UpdateBloomMipSet(m_DownSets[0], sceneColorView,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_Sampler, m_MipViews[0]);
+			}
+			else
+			{
+				m_DescriptorManager->UpdateBloomMipSet(m_DownSets[mip], m_MipViews[mip - 1],
+					VK_IMAGE_LAYOUT_GENERAL, m_Sampler, m_MipViews[mip]);
+			}
+			if (mip + 1 < m_MipCount)
+			{
+				m_DescriptorManager->UpdateBloomMipSet(m_UpSets[mip], m_MipViews[mip + 1],
+					VK_IMAGE_LAYOUT_GENERAL, m_Sampler, m_MipViews[mip]);
+			}
+		}
+
+		m_DescriptorManager->UpdatePostProcessInputSet(m_OutputSet, m_MipViews[0], m_Sampler,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		return true;
+	}
+
+	void BloomMipChain::DestroyViews()
+	{
+		if (!m_Device)
+			return;
+
+		for (VkImageView& view : m_MipViews)
+		{
+			if (view != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(m_Device->GetDevice(), view, nullptr);
+				view = VK_NULL_HANDLE;
+			}
+		}
+		m_Image = VK_NULL_HANDLE;
+		m_MipCount = 0;
+	}
+
+	bool BloomMipChain::CreatePipelines()
+	{
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(BloomPushConstants);
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetBloomMipSetLayout();
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &setLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("BloomMipChain: failed to create pipeline layout");
+			return false;
+		}
+
+		m_PrefilterPipeline = CreatePipeline("BloomPrefilter.comp.spv");
+		m_DownsamplePipeline = CreatePipeline("BloomDownsample.comp.spv");
+		m_UpsamplePipeline = CreatePipeline("BloomUpsample.comp.spv");
+		return m_PrefilterPipeline != VK_NULL_HANDLE && m_DownsamplePipeline != VK_NULL_HANDLE &&
+			m_UpsamplePipeline != VK_NULL_HANDLE;
+	}
+
+	VkPipeline BloomMipChain::CreatePipeline(const char* shaderName)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("BloomMipChain: failed to load {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("BloomMipChain: failed to create shader module for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("BloomMipChain: failed to create compute pipeline for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, shaderName);
+		return pipeline;
+	}
+
+	void BloomMipChain::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, glm::vec2 uvScale, float threshold)
+	{
+		if (!dispatcher || m_PrefilterPipeline == VK_NULL_HANDLE || m_MipCount == 0)
+			return;
+
+		// The chain aliases the reflection target, which this frame's
+		// reflection pass wrote and its scene pass sampled; last frame's
+		// post-process pass also sampled the chain. Discard all of it.
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_Image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = m_MipCount;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		RenderStats::Get().Add(RenderCounter::Barriers);
+
+		auto dispatch = [&](VkDescriptorSet set, VkExtent2D source, uint32_t targetMip, glm::vec4 params)
+		{
+			const VkExtent2D target = m_MipExtents[targetMip];
+			BloomPushConstants push{};
+			push.sizes = glm::ivec4(static_cast<int>(source.width), static_cast<int>(source.height),
+				static_cast<int>(target.width), static_cast<int>(target.height));
+			push.params = params;
+
+			dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, set);
+			dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+			dispatcher->Dispatch(cmd,
+				ComputeDispatcher::CalculateGroupCount(target.width, BLOOM_LOCAL_SIZE),
+				ComputeDispatcher::CalculateGroupCount(target.height, BLOOM_LOCAL_SIZE));
+		};
+
+		// Scene -> mip 0
+		dispatcher->BindPipeline(cmd, m_PrefilterPipeline);
+		dispatch(m_DownSets[0], m_SceneExtent, 0,
+			glm::vec4(threshold, std::max(threshold * KNEE_FRACTION, 1e-3f), uvScale.x, uvScale.y));
+
+		// Down the chain
+		if (m_MipCount > 1)
+		{
+			dispatcher->BindPipeline(cmd, m_DownsamplePipeline);
+			for (uint32_t mip = 1; mip < m_MipCount; ++mip)
+			{
+				dispatcher->ComputeToComputeImageBarrier(cmd, m_Image);
+				dispatch(m_DownSets[mip], m_MipExtents[mip - 1], mip, glm::vec4(0.0f));
+			}
+
+			// Back up, accumulating; the last step averages the levels so the
+			// composite strength doesn't depend on the chain length
+			dispatcher->BindPipeline(cmd, m_UpsamplePipeline);
+			for (uint32_t mip = m_MipCount - 1; mip-- > 0;)
+			{
+				const float scale = (mip == 0) ? 1.0f / static_cast<float>(m_MipCount) : 1.0f;
+				dispatcher->ComputeToComputeImageBarrier(cmd, m_Image);
+				dispatch(m_UpSets[mip], m_MipExtents[mip + 1], mip, glm::vec4(1.0f, scale, 0.0f, 0.0f));
+			}
+		}
+
+		// Chain -> the post-process pass (fragment, or the compute post pass)
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		RenderStats::Get().Add(RenderCounter::Barriers);
+	}
+}
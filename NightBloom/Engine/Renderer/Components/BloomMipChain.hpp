@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+// BloomMipChain.hpp
+//
+// Bloom as a compute mip chain (BloomPrefilter/BloomDownsample/BloomUpsample
+// .comp). The HDR scene color is prefiltered (Karis average + soft
+// threshold) into mip 0 of a half-resolution chain, filtered down level by
+// level with the 13-tap downsample, then added back up level by level with
+// a 3x3 tent. Mip 0 ends up holding the sum of every level, which is what
+// the post-process pass composites: a wide, smooth glow whose cost is
+// dominated by the first two levels.
+//
+// The chain image belongs to RenderPassManager (it aliases the reflection
+// target); this owns its per-level views, the sets and the pipelines. Record
+// starts the chain from UNDEFINED, builds it in GENERAL and leaves it
+// SHADER_READ_ONLY.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+
+	class BloomMipChain
+	{
+	public:
+		static constexpr uint32_t MAX_MIPS = 6;   // RenderPassManager::MAX_BLOOM_MIPS
+
+		BloomMipChain() = default;
+		~BloomMipChain() = default;
+
+		// sceneColorView: RenderPassManager's single-sample scene color;
+		// chainImage/chainExtent/mipCount: its bloom chain
+		bool Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager,
+			VkImageView sceneColorView, VkExtent2D sceneExtent,
+			VkImage chainImage, VkExtent2D chainExtent, uint32_t mipCount);
+		void Cleanup();
+
+		// Swapchain resize: the scene targets and the chain were recreated.
+		// Caller has waited for the frames using the old views.
+		bool Resize(VkImageView sceneColorView, VkExtent2D sceneExtent,
+			VkImage chainImage, VkExtent2D chainExtent, uint32_t mipCount);
+
+		// After the scene pass. uvScale is the part of the scene target the
+		// frame was drawn into (dynamic resolution). Leaves mip 0 readable
+		// by fragment shaders (GetOutputSet).
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, glm::vec2 uvScale, float threshold);
+
+		// Post-process input set (VulkanDescriptorManager's post-process
+		// input layout) holding mip 0
+		VkDescriptorSet GetOutputSet() const { return m_OutputSet; }
+
+	private:
+		bool CreateViews(VkImageView sceneColorView, VkExtent2D sceneExtent,
+			VkImage chainImage, VkExtent2D chainExtent, uint32_t mipCount);
+		void DestroyViews();
+		bool CreatePipelines();
+		VkPipeline CreatePipeline(const char* shaderName);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		VkImage m_Image = VK_NULL_HANDLE;   // not owned
+		VkExtent2D m_SceneExtent = { 0, 0 };
+		std::array<VkExtent2D, MAX_MIPS> m_MipExtents{};
+		std::array<VkImageView, MAX_MIPS> m_MipViews{};
+		uint32_t m_MipCount = 0;
+
+		VkSampler m_Sampler = VK_NULL_HANDLE;   // linear, clamp
+
+		// Down set i writes mip i (reading the scene for i = 0, else mip
+		// i - 1); up set i writes mip i reading mip i + 1
+		std::array<VkDescriptorSet, MAX_MIPS> m_DownSets{};
+		std::array<VkDescriptorSet, MAX_MIPS> m_UpSets{};
+		VkDescriptorSet m_OutputSet = VK_NULL_HANDLE;
+
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_PrefilterPipeline = VK_NULL_HANDLE;
+		VkPipeline m_DownsamplePipeline = VK_NULL_HANDLE;
+		VkPipeline m_UpsamplePipeline = VK_NULL_HANDLE;
+	};
+}
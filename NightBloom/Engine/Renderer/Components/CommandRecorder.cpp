@@ -5,17 +5,120 @@
 //------------------------------------------------------------------------------
 
 #include "Renderer/Components/CommandRecorder.hpp"
+#include "Renderer/Components/SignatureHash.hpp"
 #include "Renderer/Vulkan/VulkanDevice.hpp"
 #include "Renderer/Vulkan/VulkanCommandPool.hpp"
 #include "Renderer/Vulkan/VulkanPipelineAdapter.hpp"
 #include "Renderer/Vulkan/VulkanBuffer.hpp"
 #include "Renderer/Vulkan/VulkanTexture.hpp"
+#include "Core/CpuProfiler.hpp"
+#include "Core/ThreadPlacement.hpp"
+#include "Renderer/RenderStats.hpp"
 #include "Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Renderer/DrawCommandSystem.hpp"
 #include "Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 namespace Nightbloom
 {
+	static_assert(sizeof(IndexedIndirectDraw) == sizeof(VkDrawIndexedIndirectCommand) &&
+		offsetof(IndexedIndirectDraw, firstInstance) == offsetof(VkDrawIndexedIndirectCommand, firstInstance),
+		"IndexedIndirectDraw must match VkDrawIndexedIndirectCommand");
+
+	// Small persistent thread group for command recording. Run() hands the same
+	// job to every worker plus the calling thread (slot 0) and blocks until all
+	// of them return; the job itself pulls task indices from a shared counter.
+	struct CommandRecorder::RecordWorkers
+	{
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable wakeCv;
+		std::condition_variable doneCv;
+		const std::function<void(uint32_t)>* job = nullptr;
+		uint64_t generation = 0;
+		uint32_t busy = 0;
+		bool quit = false;
+
+		void Start(uint32_t workerCount)
+		{
+			for (uint32_t i = 0; i < workerCount; ++i)
+			{
+				threads.emplace_back([this, slot = i + 1]() { Loop(slot); });
+			}
+		}
+
+		void Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				quit = true;
+			}
+			wakeCv.notify_all();
+			for (auto& thread : threads)
+			{
+				if (thread.joinable())
+					thread.join();
+			}
+			threads.clear();
+		}
+
+		void Run(const std::function<void(uint32_t)>& fn)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &fn;
+				busy = static_cast<uint32_t>(threads.size());
+				++generation;
+			}
+			wakeCv.notify_all();
+
+			fn(0);
+
+			std::unique_lock<std::mutex> lock(mutex);
+			doneCv.wait(lock, [this]() { return busy == 0; });
+			job = nullptr;
+		}
+
+	private:
+		void Loop(uint32_t slot)
+		{
+			NB_PROFILE_THREAD("Record Worker " + std::to_string(slot));
+			ThreadPlacement::Apply(ThreadRole::FrameCritical);
+			uint64_t seenGeneration = 0;
+			for (;;)
+			{
+				const std::function<void(uint32_t)>* current = nullptr;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wakeCv.wait(lock, [&]() { return quit || generation != seenGeneration; });
+					if (quit)
+						return;
+					seenGeneration = generation;
+					current = job;
+				}
+
+				{
+					NB_PROFILE_SCOPE("Record Commands");
+					(*current)(slot);
+				}
+
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--busy == 0)
+					doneCv.notify_one();
+			}
+		}
+	};
+
+	CommandRecorder::CommandRecorder() = default;
+	CommandRecorder::~CommandRecorder() = default;
+
 	bool CommandRecorder::Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager, uint32_t commandBufferCount)
 	{
 		m_Device = device;
@@ -36,18 +139,90 @@ namespace Nightbloom
 		// Allocate command buffers
 		m_CommandBuffers = m_CommandPool->AllocateCommandBuffers(commandBufferCount);
 
-		if (m_CommandBuffers.empty())
+		m_SplitCommandBuffers = m_CommandPool->AllocateCommandBuffers(commandBufferCount);
+
+		if (m_CommandBuffers.empty() || m_SplitCommandBuffers.empty())
 		{
 			LOG_ERROR("Failed to allocate command buffers");
 			return false;
 		}
 
-		LOG_INFO("Command recorder initialized with {} command buffers", commandBufferCount);
+		// One secondary pool per (frame, thread slot). The calling thread is slot 0;
+		// extra slots get a persistent worker each. A single-core machine simply
+		// records its secondaries on the calling thread.
+		uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		uint32_t slotCount = std::min(MAX_RECORD_THREADS, hardwareThreads);
+
+		m_SecondaryPools.resize(commandBufferCount);
+		for (auto& framePools : m_SecondaryPools)
+		{
+			framePools.resize(slotCount);
+			for (auto& slotPool : framePools)
+			{
+				slotPool.pool = std::make_unique<VulkanCommandPool>(device);
+				if (!slotPool.pool->Initialize(queueFamilies.graphicsFamily.value(),
+					VK_COMMAND_POOL_CREATE_TRANSIENT_BIT))
+				{
+					LOG_ERROR("Failed to create secondary command pool");
+					return false;
+				}
+			}
+		}
+
+		// Cached secondaries are re-recorded one at a time, so they need a pool
+		// that can reset single buffers
+		m_CachedSecondaryPool = std::make_unique<VulkanCommandPool>(device);
+		if (!m_CachedSecondaryPool->Initialize(queueFamilies.graphicsFamily.value(),
+			VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT))
+		{
+			LOG_ERROR("Failed to create cached secondary command pool");
+			return false;
+		}
+		m_CachedSecondaries.resize(commandBufferCount);
+
+		if (slotCount > 1)
+		{
+			m_Workers = std::make_unique<RecordWorkers>();
+			m_Workers->Start(slotCount - 1);
+		}
+		m_ParallelRecording = (slotCount > 1);
+
+		LOG_INFO("Command recorder initialized with {} command buffers, {} recording threads",
+			commandBufferCount, slotCount);
 		return true;
 	}
 
+	uint32_t CommandRecorder::GetRecordThreadCount() const
+	{
+		return m_SecondaryPools.empty() ? 0u : static_cast<uint32_t>(m_SecondaryPools[0].size());
+	}
+
 	void CommandRecorder::Cleanup()
 	{
+		if (m_Workers)
+		{
+			m_Workers->Stop();
+			m_Workers.reset();
+		}
+
+		// Destroying a pool frees the secondaries allocated from it.
+		for (auto& framePools : m_SecondaryPools)
+		{
+			for (auto& slotPool : framePools)
+			{
+				if (slotPool.pool)
+					slotPool.pool->Shutdown();
+			}
+		}
+		m_SecondaryPools.clear();
+
+		m_CachedSecondaries.clear();
+		if (m_CachedSecondaryPool)
+		{
+			m_CachedSecondaryPool->Shutdown();
+			m_CachedSecondaryPool.reset();
+		}
+
 		if (m_CommandPool)
 		{
 			// Free command buffers
@@ -56,6 +231,11 @@ namespace Nightbloom
 				m_CommandPool->FreeCommandBuffers(m_CommandBuffers);
 				m_CommandBuffers.clear();
 			}
+			if (!m_SplitCommandBuffers.empty())
+			{
+				m_CommandPool->FreeCommandBuffers(m_SplitCommandBuffers);
+				m_SplitCommandBuffers.clear();
+			}
 
 			// Destroy command pool
 			m_CommandPool->Shutdown();
@@ -90,6 +270,20 @@ namespace Nightbloom
 		// Reset tracking state
 		m_CurrentPipeline = VK_NULL_HANDLE;
 		m_CurrentPipelineLayout = VK_NULL_HANDLE;
+		m_CurrentVertexBuffer = VK_NULL_HANDLE;
+		m_CurrentIndexBuffer = VK_NULL_HANDLE;
+
+		// This frame's fence has been waited on, so its secondaries are no longer
+		// in flight - recycle them all at once.
+		if (bufferIndex < m_SecondaryPools.size())
+		{
+			for (auto& slotPool : m_SecondaryPools[bufferIndex])
+			{
+				slotPool.pool->Reset();
+				slotPool.used = 0;
+			}
+		}
+		m_CachedSecondaryStats = {};
 	}
 
 	void CommandRecorder::EndCommandBuffer(uint32_t bufferIndex)
@@ -108,6 +302,41 @@ namespace Nightbloom
 		}
 	}
 
+	VkCommandBuffer CommandRecorder::SplitCommandBuffer(uint32_t bufferIndex)
+	{
+		if (bufferIndex >= m_CommandBuffers.size() || bufferIndex >= m_SplitCommandBuffers.size())
+		{
+			LOG_ERROR("Invalid command buffer index: {}", bufferIndex);
+			return VK_NULL_HANDLE;
+		}
+
+		VkCommandBuffer head = m_CommandBuffers[bufferIndex];
+		if (vkEndCommandBuffer(head) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to record command buffer {}", bufferIndex);
+		}
+
+		// Both halves were submitted together last time this frame slot ran
+		// and have been waited on with it, so the spare is free to re-record
+		// (the pool has RESET_COMMAND_BUFFER, so begin resets it)
+		std::swap(m_CommandBuffers[bufferIndex], m_SplitCommandBuffers[bufferIndex]);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		if (vkBeginCommandBuffer(m_CommandBuffers[bufferIndex], &beginInfo) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to begin recording command buffer {}", bufferIndex);
+		}
+
+		// Bindings don't carry across command buffers
+		m_CurrentPipeline = VK_NULL_HANDLE;
+		m_CurrentPipelineLayout = VK_NULL_HANDLE;
+		m_CurrentVertexBuffer = VK_NULL_HANDLE;
+		m_CurrentIndexBuffer = VK_NULL_HANDLE;
+
+		return head;
+	}
+
 	void CommandRecorder::ResetCommandBuffer(uint32_t bufferIndex)
 	{
 		if (bufferIndex >= m_CommandBuffers.size())
@@ -121,7 +350,8 @@ namespace Nightbloom
 
 	void CommandRecorder::BeginRenderPass(uint32_t bufferIndex, VkRenderPass renderPass,
 		VkFramebuffer framebuffer, VkExtent2D extent,
-		const VkClearValue* clearValues, uint32_t clearValueCount)
+		const VkClearValue* clearValues, uint32_t clearValueCount,
+		VkSubpassContents contents)
 	{
 		if (bufferIndex >= m_CommandBuffers.size())
 		{
@@ -151,7 +381,17 @@ namespace Nightbloom
 			renderPassInfo.pClearValues = &defaultClear;
 		}
 
-		vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		vkCmdBeginRenderPass(cmd, &renderPassInfo, contents);
+
+		// Passes recorded outside the recorder (shadow, bloom) bind directly, so
+		// don't carry redundant-bind tracking across render pass boundaries.
+		StoreSerialContext(RecordContext{});
+
+		// Secondaries carry their own dynamic state
+		if (contents != VK_SUBPASS_CONTENTS_INLINE)
+		{
+			return;
+		}
 
 		// Set viewport to FULL extent
 		VkViewport viewport{};
@@ -181,6 +421,18 @@ namespace Nightbloom
 		vkCmdEndRenderPass(m_CommandBuffers[bufferIndex]);
 	}
 
+	void CommandRecorder::NextSubpass(uint32_t bufferIndex)
+	{
+		if (bufferIndex >= m_CommandBuffers.size())
+		{
+			LOG_ERROR("Invalid command buffer index: {}", bufferIndex);
+			return;
+		}
+
+		vkCmdNextSubpass(m_CommandBuffers[bufferIndex], VK_SUBPASS_CONTENTS_INLINE);
+		StoreSerialContext(RecordContext{});
+	}
+
 	void CommandRecorder::ExecuteDrawList(uint32_t bufferIndex, const DrawList& drawList,
 		VulkanPipelineAdapter* pipelineManager,
 		const glm::mat4& viewMatrix,
@@ -198,30 +450,142 @@ namespace Nightbloom
 			return;
 		}
 
-		// Process each draw command
-		for (const auto& cmd : drawList.GetCommands())
+		RecordContext ctx = SerialContext(bufferIndex);
+		if (HasDepthPrepass(drawList))
 		{
+			RecordDepthPrepassRange(ctx, drawList, 0, drawList.GetDepthPrepassOrder().size(), pipelineManager);
+			ctx.depthStage = DepthStage::Equal;
+		}
+		RecordDrawRange(ctx, drawList, 0, drawList.GetCommandCount(), pipelineManager);
+		ctx.depthStage = DepthStage::Off;
+		StoreSerialContext(ctx);
+	}
+
+	bool CommandRecorder::HasDepthPrepass(const DrawList& drawList) const
+	{
+		return m_DepthPrepass && !drawList.GetDepthPrepassOrder().empty();
+	}
+
+	void CommandRecorder::RecordDepthPrepassRange(RecordContext& ctx, const DrawList& drawList,
+		size_t begin, size_t end, VulkanPipelineAdapter* pipelineManager)
+	{
+		// Same GPU-written parameters as the color pass, so both passes
+		// rasterize exactly the same triangles. No multi-draw runs: the
+		// prepass order doesn't keep a run's commands adjacent.
+		DrawSources sources;
+		sources.occlusionDraws = m_OcclusionDrawBuffers[ctx.frameIndex % m_OcclusionDrawBuffers.size()];
+		const MeshletDrawBuffers& meshlets = m_MeshletDraws[ctx.frameIndex % m_MeshletDraws.size()];
+		sources.meshletDraws = meshlets.draws;
+		sources.meshletCounts = meshlets.counts;
+
+		const DrawIndexVector& order = drawList.GetDepthPrepassOrder();
+		ctx.depthStage = DepthStage::Prepass;
+		for (size_t i = begin; i < end; ++i)
+		{
+			RecordDrawCommand(ctx, drawList.GetCommand(order[i]), pipelineManager, VK_NULL_HANDLE, &sources);
+		}
+		ctx.depthStage = DepthStage::Off;
+	}
+
+	void CommandRecorder::RecordDrawRange(RecordContext& ctx, const DrawList& drawList,
+		size_t begin, size_t end, VulkanPipelineAdapter* pipelineManager)
+	{
+		const VkBuffer occlusionDraws = m_OcclusionDrawBuffers[ctx.frameIndex % m_OcclusionDrawBuffers.size()];
+		const IndirectDrawBuffer& indirect = m_IndirectDraws[ctx.frameIndex % m_IndirectDraws.size()];
+		const MeshletDrawBuffers& meshlets = m_MeshletDraws[ctx.frameIndex % m_MeshletDraws.size()];
+		const bool multiDraw = indirect.buffer != VK_NULL_HANDLE;
+		const size_t indirectEnd = std::min(end, static_cast<size_t>(indirect.drawCount));
+		const bool gpuCulled = occlusionDraws != VK_NULL_HANDLE || meshlets.draws != VK_NULL_HANDLE;
+		auto isVisible = [&drawList](size_t index) { return drawList.GetCommand(index).cameraVisible; };
+
+		// Walk in sorted order so same-pipeline/material/buffer draws are adjacent
+		for (size_t i = begin; i < end;)
+		{
+			const DrawCommand& cmd = drawList.GetCommand(i);
+
 			// Skip objects culled against the camera frustum. They remain in the list for the
 			// shadow/reflection passes (which ignore this flag); only the visible color pass
 			// honors it, so camera-frustum culling still saves main-pass work.
-			if (!cmd.cameraVisible)
+			// With OIT on, the transparent draws belong to the OIT pass instead.
+			if (!cmd.cameraVisible ||
+				(m_OrderIndependentTransparency && DrawList::IsOrderIndependentCandidate(cmd)))
+			{
+				++i;
 				continue;
+			}
 
-			ExecuteDrawCommand(bufferIndex, cmd, pipelineManager, viewMatrix, projectionMatrix);
+			// Compatible Mesh draws that follow go out with this one as a
+			// single multi-draw
+			size_t runEnd = i + 1;
+			if (multiDraw && i < indirectEnd)
+				runEnd = drawList.FindIndirectRun(i, indirectEnd, gpuCulled, isVisible);
+
+			DrawSources sources;
+			sources.occlusionDraws = occlusionDraws;
+			sources.indirectDraws = indirect.buffer;
+			sources.indirectIndex = static_cast<uint32_t>(i);
+			sources.drawCount = static_cast<uint32_t>(runEnd - i);
+			sources.meshletDraws = meshlets.draws;
+			sources.meshletCounts = meshlets.counts;
+			RecordDrawCommand(ctx, cmd, pipelineManager, VK_NULL_HANDLE, &sources);
+			i = runEnd;
 		}
 	}
 
+	void CommandRecorder::ExecuteTransparentDrawList(uint32_t bufferIndex, const DrawList& drawList,
+		VulkanPipelineAdapter* pipelineManager)
+	{
+		if (bufferIndex >= m_CommandBuffers.size() || !pipelineManager)
+		{
+			return;
+		}
+
+		// Few draws, and the blend makes their order irrelevant: serial, no
+		// multi-draw runs (only Mesh forms them)
+		RecordContext ctx = SerialContext(bufferIndex);
+		ctx.orderIndependent = true;
+		for (size_t i = 0; i < drawList.GetCommandCount(); ++i)
+		{
+			const DrawCommand& cmd = drawList.GetCommand(i);
+			if (DrawList::IsOrderIndependentCandidate(cmd))
+			{
+				RecordDrawCommand(ctx, cmd, pipelineManager, VK_NULL_HANDLE);
+			}
+		}
+		ctx.orderIndependent = false;
+		StoreSerialContext(ctx);
+	}
+
 	void CommandRecorder::ExecuteReflectionDrawList(uint32_t bufferIndex, const DrawList& drawList,
 		VulkanPipelineAdapter* pipelineManager, VkDescriptorSet reflectionUniformSet,
-		VkDescriptorSet cloudReflectionResultSet)
+		VkDescriptorSet cloudReflectionResultSet, const uint8_t* casters)
 	{
 		if (bufferIndex >= m_CommandBuffers.size() || !pipelineManager)
 		{
 			return;
 		}
 
-		for (const auto& cmd : drawList.GetCommands())
+		RecordContext ctx = SerialContext(bufferIndex);
+		RecordReflectionRange(ctx, drawList, 0, drawList.GetCommandCount(), pipelineManager,
+			reflectionUniformSet, cloudReflectionResultSet, casters);
+		StoreSerialContext(ctx);
+	}
+
+	void CommandRecorder::RecordReflectionRange(RecordContext& ctx, const DrawList& drawList,
+		size_t begin, size_t end, VulkanPipelineAdapter* pipelineManager,
+		VkDescriptorSet reflectionUniformSet, VkDescriptorSet cloudReflectionResultSet,
+		const uint8_t* casters)
+	{
+		ctx.reflection = m_ReflectionTwins;
+		for (size_t i = begin; i < end; ++i)
 		{
+			if (casters && !casters[i])
+			{
+				continue;
+			}
+
+			const DrawCommand& cmd = drawList.GetCommand(i);
+
 			// Clouds are composited into the reflection too, but only if the caller
 			// supplied the mirror-camera raymarch result set. We swap the command's
 			// set-0 source (textureDescriptorSet) to that reflection result so the
@@ -236,24 +600,25 @@ namespace Nightbloom
 				}
 				DrawCommand cloudCmd = cmd;
 				cloudCmd.textureDescriptorSet = cloudReflectionResultSet;
-				ExecuteDrawCommand(bufferIndex, cloudCmd, pipelineManager, glm::mat4(1.0f), glm::mat4(1.0f),
-					reflectionUniformSet);
+				RecordDrawCommand(ctx, cloudCmd, pipelineManager, reflectionUniformSet);
 				continue;
 			}
 
-			// Only opaque world geometry is otherwise reflected. Transparent/Water/
+			// Only opaque world geometry and the sky (the atmosphere's LUT, seen
+			// from the mirror camera) are otherwise reflected. Transparent/Water/
 			// Firefly are skipped (v1) — water can't reflect itself, and the rest
 			// are deferred follow-ups.
-			if (cmd.pipeline != PipelineType::Mesh &&
+			if (cmd.pipeline != PipelineType::Skybox &&
+				cmd.pipeline != PipelineType::Mesh &&
 				cmd.pipeline != PipelineType::Terrain &&
 				cmd.pipeline != PipelineType::Foliage)
 			{
 				continue;
 			}
 
-			ExecuteDrawCommand(bufferIndex, cmd, pipelineManager, glm::mat4(1.0f), glm::mat4(1.0f),
-				reflectionUniformSet);
+			RecordDrawCommand(ctx, cmd, pipelineManager, reflectionUniformSet);
 		}
+		ctx.reflection = false;
 	}
 
 	void CommandRecorder::ExecuteDrawCommand(uint32_t bufferIndex, const DrawCommand& cmd,
@@ -262,262 +627,597 @@ namespace Nightbloom
 		const glm::mat4& projectionMatrix,
 		VkDescriptorSet overrideUniformSet)
 	{
-		VkCommandBuffer commandBuffer = m_CommandBuffers[bufferIndex];
+		RecordContext ctx = SerialContext(bufferIndex);
+		RecordDrawCommand(ctx, cmd, pipelineManager, overrideUniformSet);
+		StoreSerialContext(ctx);
+	}
 
-		// Bind pipeline if needed ToDo: check if this can be a function
-		VkPipeline pipeline = pipelineManager->GetVulkanManager()->GetPipeline(cmd.pipeline);
-		VkPipelineLayout layout = pipelineManager->GetVulkanManager()->GetPipelineLayout(cmd.pipeline);
+	CommandRecorder::RecordContext CommandRecorder::SerialContext(uint32_t bufferIndex) const
+	{
+		RecordContext ctx;
+		ctx.commandBuffer = m_CommandBuffers[bufferIndex];
+		ctx.frameIndex = bufferIndex;
+		ctx.pipeline = m_CurrentPipeline;
+		ctx.pipelineLayout = m_CurrentPipelineLayout;
+		ctx.vertexBuffer = m_CurrentVertexBuffer;
+		ctx.indexBuffer = m_CurrentIndexBuffer;
+		return ctx;
+	}
 
-		if (pipeline != m_CurrentPipeline)
+	void CommandRecorder::StoreSerialContext(const RecordContext& ctx)
+	{
+		m_CurrentPipeline = ctx.pipeline;
+		m_CurrentPipelineLayout = ctx.pipelineLayout;
+		m_CurrentVertexBuffer = ctx.vertexBuffer;
+		m_CurrentIndexBuffer = ctx.indexBuffer;
+	}
+
+	void CommandRecorder::BindDrawSets(RecordContext& ctx, const DrawCommand& cmd,
+		VkDescriptorSet overrideUniformSet, bool bindlessDraw)
+	{
+		if (ctx.pipelineLayout == VK_NULL_HANDLE)
+			return;
+
+		VkCommandBuffer commandBuffer = ctx.commandBuffer;
+		const uint32_t bufferIndex = ctx.frameIndex;
+		RenderStats& stats = RenderStats::Get();
+
+		// Keyed by the base type: every twin shares its layout
+		const PipelineBindingLayout& bindings = GetPipelineBindings(cmd.pipeline);
+		const uint32_t setCount = bindings.GetSetCount();
+		for (uint32_t index = 0; index < setCount; ++index)
 		{
-			pipelineManager->GetVulkanManager()->BindPipeline(commandBuffer, cmd.pipeline);
-			m_CurrentPipeline = pipeline;
-			m_CurrentPipelineLayout = layout;
-		}
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			switch (bindings.sets[index])
+			{
+			case BindingSource::None:
+				break;
+
+			case BindingSource::Uniform:
+				// The reflection pass substitutes the mirror-flipped camera
+				if (m_DescriptorManager)
+				{
+					set = (overrideUniformSet != VK_NULL_HANDLE)
+						? overrideUniformSet
+						: m_DescriptorManager->GetUniformDescriptorSet(bufferIndex);
+				}
+				break;
+
+			case BindingSource::Texture:
+				// Bindless draws had the table bound with the pipeline
+				if (bindlessDraw || !m_DescriptorManager)
+					break;
+
+				if (cmd.pushBuffers[0].buffer != VK_NULL_HANDLE)
+				{
+					// A push set (Foliage's storage): written inline every draw,
+					// and whatever was bound here is gone
+					uint32_t pushCount = 0;
+					while (pushCount < DrawCommand::MAX_PUSH_BUFFERS && cmd.pushBuffers[pushCount].buffer != VK_NULL_HANDLE)
+						++pushCount;
+					m_DescriptorManager->PushStorageBuffers(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+						ctx.pipelineLayout, index, cmd.pushBuffers, pushCount);
+					stats.Add(RenderCounter::DescriptorBinds);
+					ctx.boundSets[index] = VK_NULL_HANDLE;
+				}
+				else if (cmd.textureDescriptorSet != VK_NULL_HANDLE)
+				{
+					set = cmd.textureDescriptorSet;
+				}
+				else if (!cmd.textures.IsEmpty())
+				{
+					// The texture's own pre-allocated set - no update during rendering
+					VulkanTexture* vkTexture = static_cast<VulkanTexture*>(cmd.textures[0]);
+					if (vkTexture && vkTexture->HasDescriptorSet())
+						set = vkTexture->GetDescriptorSet();
+					else
+						LOG_WARN("Texture has no descriptor set - texture may not have been properly initialized");
+				}
+				break;
+
+			case BindingSource::Lighting:
+				if (m_DescriptorManager)
+					set = m_DescriptorManager->GetLightingDescriptorSet(bufferIndex);
+				break;
 
-		bool pipelineUsesUniforms = (
-			cmd.pipeline == PipelineType::Mesh			||
-			cmd.pipeline == PipelineType::Transparent	||
-			cmd.pipeline == PipelineType::NodeGenerated ||
-			cmd.pipeline == PipelineType::Triangle		||
-			cmd.pipeline == PipelineType::Terrain		||
-			cmd.pipeline == PipelineType::Foliage		||
-			cmd.pipeline == PipelineType::Firefly		);
-			// Clouds excluded: the graphics composite pass only samples the
-			// low-res raymarch result (see below) - it needs no FrameUniforms
-			// at all, since the raymarch (and the camera math it needed)
-			// moved to CloudRaymarch.comp.
+			case BindingSource::Shadow:
+				if (m_DescriptorManager)
+					set = m_DescriptorManager->GetShadowDescriptorSet(bufferIndex);
+				break;
 
-		// Water also uses a set-0 uniform (the scene camera) — handled in the
-		// dedicated Water block below, not here, since its other sets differ.
-		if (cmd.pipeline == PipelineType::Water)
+			case BindingSource::Heightmap:
+				set = cmd.heightmapDescriptorSet;
+				break;
+
+			case BindingSource::Reflection:
+				set = m_ReflectionInputSet;
+				break;
+
+			case BindingSource::CommandSet:
+				set = cmd.textureDescriptorSet;
+				break;
+			}
+
+			// Sources that have nothing this frame leave the index alone
+			if (set == VK_NULL_HANDLE || set == ctx.boundSets[index])
+				continue;
+
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+				ctx.pipelineLayout, index, 1, &set, 0, nullptr);
+			stats.Add(RenderCounter::DescriptorBinds);
+			ctx.boundSets[index] = set;
+		}
+	}
+
+	void CommandRecorder::RecordDrawCommand(RecordContext& ctx, const DrawCommand& cmd,
+		VulkanPipelineAdapter* pipelineManager,
+		VkDescriptorSet overrideUniformSet,
+		const DrawSources* sources)
+	{
+		static const DrawSources direct;
+		const DrawSources& source = sources ? *sources : direct;
+
+		VkCommandBuffer commandBuffer = ctx.commandBuffer;
+		const uint32_t bufferIndex = ctx.frameIndex;
+		RenderStats& stats = RenderStats::Get();
+
+		// Bind pipeline if needed ToDo: check if this can be a function.
+		// Compressed-vertex meshes bind the packed twin of their pipeline,
+		// tessellated terrain the tessellated one; everything else below
+		// keys off the base type.
+		PipelineType boundType = ResolvePipelineVariant(cmd.pipeline, cmd.vertexFormat);
+		if (cmd.tessellated)
+			boundType = GetTessellatedPipeline(boundType);
+		if (ctx.depthStage == DepthStage::Prepass)
+			boundType = GetDepthPrepassPipeline(boundType);
+		else if (ctx.depthStage == DepthStage::Equal && DrawList::IsDepthPrepassCandidate(cmd))
+			boundType = GetDepthEqualPipeline(boundType);
+		else if (ctx.orderIndependent)
+			boundType = GetOitPipeline(boundType);
+		else if (ctx.reflection && GetReflectionPipeline(boundType) != PipelineType::Count)
+			boundType = GetReflectionPipeline(boundType);
+		VkPipeline pipeline = pipelineManager->GetVulkanManager()->GetPipeline(boundType);
+		VkPipelineLayout layout = pipelineManager->GetVulkanManager()->GetPipelineLayout(boundType);
+
+		const bool bindlessDraw = m_BindlessMeshPasses && m_DescriptorManager &&
+			(cmd.pipeline == PipelineType::Mesh || cmd.pipeline == PipelineType::Transparent);
+
+		if (pipeline != ctx.pipeline)
 		{
-			pipelineUsesUniforms = false;
+			pipelineManager->GetVulkanManager()->BindPipeline(commandBuffer, boundType);
+			stats.Add(RenderCounter::PipelineBinds);
+			ctx.pipeline = pipeline;
+			if (layout != ctx.pipelineLayout)
+			{
+				// Sets bound through another layout aren't guaranteed compatible
+				ctx.pipelineLayout = layout;
+				ctx.boundSets = {};
+			}
+
+			// One table for every draw of the pipeline; whatever bound set 1
+			// in between also changed the pipeline
+			if (bindlessDraw && layout != VK_NULL_HANDLE)
+			{
+				VkDescriptorSet bindlessSet = m_DescriptorManager->GetBindlessDescriptorSet();
+				if (ctx.boundSets[1] != bindlessSet)
+				{
+					vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+						layout, 1, 1, &bindlessSet, 0, nullptr);
+					stats.Add(RenderCounter::DescriptorBinds);
+					ctx.boundSets[1] = bindlessSet;
+				}
+			}
 		}
 
-		if (pipelineUsesUniforms && m_DescriptorManager && m_CurrentPipelineLayout != VK_NULL_HANDLE)
+		BindDrawSets(ctx, cmd, overrideUniformSet, bindlessDraw);
+
+		// Set push constants if needed
+		if (cmd.hasPushConstants && ctx.pipelineLayout != VK_NULL_HANDLE)
 		{
-			// The reflection pass substitutes the mirror-flipped camera at set 0.
-			VkDescriptorSet uniformSet = (overrideUniformSet != VK_NULL_HANDLE)
-				? overrideUniformSet
-				: m_DescriptorManager->GetUniformDescriptorSet(bufferIndex);
-			vkCmdBindDescriptorSets(
+			// Bindless draws carry their texture as a slot instead of a set
+			PushConstantData pushConstants = cmd.pushConstants;
+			if (bindlessDraw && !cmd.textures.IsEmpty())
+			{
+				VulkanTexture* vkTexture = static_cast<VulkanTexture*>(cmd.textures[0]);
+				if (vkTexture)
+					pushConstants.textureIndex = vkTexture->GetBindlessIndex();
+			}
+
+			// Push to both vertex and fragment stages
+			pipelineManager->GetVulkanManager()->PushConstants(
 				commandBuffer,
-				VK_PIPELINE_BIND_POINT_GRAPHICS,
-				m_CurrentPipelineLayout,
-				0,  // set 0 for uniforms
-				1,
-				&uniformSet,
-				0,
-				nullptr
+				cmd.pipeline,
+				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+				&pushConstants,
+				sizeof(PushConstantData)
 			);
+			stats.Add(RenderCounter::PushConstants);
 		}
 
-		// --- Bind cloud raymarch result (set 0 - Clouds' only descriptor set) ---
-		// Distinct from pipelineUsesTextures below: this is set 0 (the Clouds
-		// composite pipeline has no uniform set ahead of it), and the source
-		// is cmd.textureDescriptorSet (set by CloudSystem::SubmitDraw to its
-		// single, non-per-frame result descriptor set).
-		if (cmd.pipeline == PipelineType::Clouds && m_CurrentPipelineLayout != VK_NULL_HANDLE
-			&& cmd.textureDescriptorSet != VK_NULL_HANDLE)
+		// Bind vertex buffer (skipped when the sorted neighbour already bound it)
+		if (cmd.vertexBuffer)
 		{
-			vkCmdBindDescriptorSets(
-				commandBuffer,
-				VK_PIPELINE_BIND_POINT_GRAPHICS,
-				m_CurrentPipelineLayout,
-				0,  // set 0 - Clouds' only set
-				1,
-				&cmd.textureDescriptorSet,
-				0,
-				nullptr
-			);
+			VulkanBuffer* vkBuffer = static_cast<VulkanBuffer*>(cmd.vertexBuffer);
+			VkBuffer vertexBuffer = vkBuffer->GetBuffer();
+			if (vertexBuffer != ctx.vertexBuffer)
+			{
+				VkBuffer vertexBuffers[] = { vertexBuffer };
+				VkDeviceSize offsets[] = { 0 };
+				vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+				ctx.vertexBuffer = vertexBuffer;
+			}
 		}
 
-		// --- Bind texture descriptor set (set 1) ---
-		bool pipelineUsesTextures = (
-			cmd.pipeline == PipelineType::Mesh			||
-			cmd.pipeline == PipelineType::Transparent	||
-			cmd.pipeline == PipelineType::NodeGenerated ||
-			cmd.pipeline == PipelineType::Terrain		||
-			cmd.pipeline == PipelineType::Foliage		||
-			cmd.pipeline == PipelineType::Firefly		);
+		// Draw
+		if (cmd.indexBuffer && cmd.indexCount > 0)
+		{
+			// Indexed draw
+			VulkanBuffer* vkIndexBuffer = static_cast<VulkanBuffer*>(cmd.indexBuffer);
+			VkBuffer indexBuffer = vkIndexBuffer->GetBuffer();
+			if (indexBuffer != ctx.indexBuffer)
+			{
+				vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+				ctx.indexBuffer = indexBuffer;
+			}
+			if (cmd.indirectBuffer && cmd.countBuffer)
+			{
+				// GPU-culled: the count and every draw's parameters were
+				// written by a compute pass earlier in this command buffer
+				vkCmdDrawIndexedIndirectCount(commandBuffer,
+					static_cast<VulkanBuffer*>(cmd.indirectBuffer)->GetBuffer(), cmd.indirectOffset,
+					static_cast<VulkanBuffer*>(cmd.countBuffer)->GetBuffer(), cmd.countOffset,
+					cmd.maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+				stats.AddIndirectDraw();
+			}
+			else if (source.meshletDraws != VK_NULL_HANDLE && source.meshletCounts != VK_NULL_HANDLE &&
+				cmd.meshletJob != DrawCommand::NO_MESHLET_JOB)
+			{
+				// Meshlet-culled: one draw per surviving meshlet, counted by
+				// the job's counter
+				vkCmdDrawIndexedIndirectCount(commandBuffer, source.meshletDraws,
+					static_cast<VkDeviceSize>(cmd.meshletDrawBase) * sizeof(VkDrawIndexedIndirectCommand),
+					source.meshletCounts, static_cast<VkDeviceSize>(cmd.meshletJob) * sizeof(uint32_t),
+					cmd.meshletCount, sizeof(VkDrawIndexedIndirectCommand));
+				stats.AddIndirectDraw();
+			}
+			else if (source.occlusionDraws != VK_NULL_HANDLE && cmd.occlusionSlot != DrawCommand::NO_OCCLUSION_SLOT)
+			{
+				// Hi-Z tested: same parameters, instanceCount zeroed if hidden
+				vkCmdDrawIndexedIndirect(commandBuffer, source.occlusionDraws,
+					static_cast<VkDeviceSize>(cmd.occlusionSlot) * sizeof(VkDrawIndexedIndirectCommand),
+					source.drawCount, sizeof(VkDrawIndexedIndirectCommand));
+				stats.AddIndirectDraw();
+			}
+			else if (source.drawCount > 1 && source.indirectDraws != VK_NULL_HANDLE)
+			{
+				vkCmdDrawIndexedIndirect(commandBuffer, source.indirectDraws,
+					static_cast<VkDeviceSize>(source.indirectIndex) * sizeof(IndexedIndirectDraw),
+					source.drawCount, sizeof(IndexedIndirectDraw));
+				stats.AddIndirectDraw();
+			}
+			else
+			{
+				vkCmdDrawIndexed(commandBuffer, cmd.indexCount, cmd.instanceCount,
+					cmd.firstIndex, cmd.vertexOffset, cmd.firstInstance);
+				stats.AddDraw(cmd.indexCount, cmd.instanceCount);
+			}
+		}
+		else if (cmd.vertexCount > 0 && cmd.indirectBuffer)
+		{
+			// GPU-culled non-indexed draw: one VkDrawIndirectCommand at
+			// indirectOffset, written by a compute pass earlier in this
+			// command buffer (FireflySystem's cull)
+			vkCmdDrawIndirect(commandBuffer, static_cast<VulkanBuffer*>(cmd.indirectBuffer)->GetBuffer(),
+				cmd.indirectOffset, 1, sizeof(VkDrawIndirectCommand));
+			stats.AddIndirectDraw();
+		}
+		else if (cmd.vertexCount > 0)
+		{
+			// Non-indexed draw
+			vkCmdDraw(commandBuffer, cmd.vertexCount, cmd.instanceCount, 0, cmd.firstInstance);
+			stats.AddDraw(cmd.vertexCount, cmd.instanceCount);
+		}
+	}
 
-		if (pipelineUsesTextures && m_DescriptorManager && m_CurrentPipelineLayout != VK_NULL_HANDLE )
+	// =====================================================================
+	// Parallel secondary recording
+	// =====================================================================
+	VkCommandBuffer CommandRecorder::AcquireSecondary(uint32_t bufferIndex, uint32_t slot)
+	{
+		SecondaryPool& slotPool = m_SecondaryPools[bufferIndex][slot];
+		if (slotPool.used == slotPool.buffers.size())
 		{
-			if (cmd.textureDescriptorSet != VK_NULL_HANDLE)
+			VkCommandBuffer buffer = slotPool.pool->AllocateCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+			if (buffer == VK_NULL_HANDLE)
 			{
-				vkCmdBindDescriptorSets(
-					commandBuffer,
-					VK_PIPELINE_BIND_POINT_GRAPHICS,
-					m_CurrentPipelineLayout,
-					1,  // set 1 for textures
-					1,
-					&cmd.textureDescriptorSet,
-					0,
-					nullptr
-				);
+				return VK_NULL_HANDLE;
 			}
-			else if (!cmd.textures.empty())
+			slotPool.buffers.push_back(buffer);
+		}
+		return slotPool.buffers[slotPool.used++];
+	}
+
+	// Begins secondary inside pass's render pass, with its viewport and scissor set
+	bool CommandRecorder::BeginSecondary(VkCommandBuffer secondary, const SecondaryPassInfo& pass,
+		VkCommandBufferUsageFlags flags) const
+	{
+		VkCommandBufferInheritanceInfo inheritance{};
+		inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritance.renderPass = pass.renderPass;
+		inheritance.subpass = 0;
+		inheritance.framebuffer = pass.framebuffer;
+		inheritance.occlusionQueryEnable = m_InheritOcclusion ? VK_TRUE : VK_FALSE;
+		inheritance.queryFlags = m_InheritOcclusionFlags;
+		inheritance.pipelineStatistics = m_InheritPipelineStatistics;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | flags;
+		beginInfo.pInheritanceInfo = &inheritance;
+
+		if (vkBeginCommandBuffer(secondary, &beginInfo) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to begin secondary command buffer");
+			return false;
+		}
+
+		vkCmdSetViewport(secondary, 0, 1, &pass.viewport);
+		vkCmdSetScissor(secondary, 0, 1, &pass.scissor);
+		return true;
+	}
+
+	std::vector<VkCommandBuffer> CommandRecorder::RecordSecondaries(uint32_t bufferIndex,
+		const std::vector<SecondaryRecordTask>& tasks)
+	{
+		std::vector<VkCommandBuffer> secondaries(tasks.size(), VK_NULL_HANDLE);
+		if (bufferIndex >= m_SecondaryPools.size() || tasks.empty())
+		{
+			return secondaries;
+		}
+
+		std::atomic<uint32_t> nextTask{ 0 };
+		const uint32_t taskCount = static_cast<uint32_t>(tasks.size());
+		// Workers count into the pass the caller is recording
+		const uint32_t statsPass = RenderStats::GetCurrentPass();
+
+		std::function<void(uint32_t)> work = [&](uint32_t slot)
+		{
+			RenderStatsPassScope statsScope(statsPass);
+			for (uint32_t i = nextTask.fetch_add(1); i < taskCount; i = nextTask.fetch_add(1))
 			{
-				// Use the texture's own descriptor set instead of updating a shared one
-				VulkanTexture* vkTexture = static_cast<VulkanTexture*>(cmd.textures[0]);
+				const SecondaryRecordTask& task = tasks[i];
 
-				if (vkTexture && vkTexture->HasDescriptorSet())
+				VkCommandBuffer secondary = AcquireSecondary(bufferIndex, slot);
+				if (secondary == VK_NULL_HANDLE)
 				{
-					// Bind the texture's pre-allocated descriptor set - NO UPDATE during rendering!
-					VkDescriptorSet textureSet = vkTexture->GetDescriptorSet();
-					vkCmdBindDescriptorSets(
-						commandBuffer,
-						VK_PIPELINE_BIND_POINT_GRAPHICS,
-						m_CurrentPipelineLayout,
-						1,  // set 1 for textures
-						1,  // set count
-						&textureSet,
-						0,  // dynamic offset count
-						nullptr
-					);
+					LOG_ERROR("Failed to allocate secondary command buffer");
+					continue;
 				}
-				else
+
+				if (!BeginSecondary(secondary, task.pass, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT))
 				{
-					LOG_WARN("Texture has no descriptor set - texture may not have been properly initialized");
+					continue;
+				}
+
+				if (task.record)
+				{
+					task.record(secondary);
+				}
+
+				if (vkEndCommandBuffer(secondary) != VK_SUCCESS)
+				{
+					LOG_ERROR("Failed to record secondary command buffer");
+					continue;
 				}
+
+				secondaries[i] = secondary;
 			}
+		};
+
+		if (m_Workers && taskCount > 1)
+		{
+			m_Workers->Run(work);
+		}
+		else
+		{
+			work(0);
 		}
 
-		// --- Bind lighting descriptor set (set 2) ---
-		// Clouds excluded: the sun/lighting read now happens in
-		// CloudRaymarch.comp, not the graphics composite pass.
-		bool pipelineUsesLighting = (
-			cmd.pipeline == PipelineType::Mesh			||
-			cmd.pipeline == PipelineType::Transparent	||
-			cmd.pipeline == PipelineType::Terrain		||
-			cmd.pipeline == PipelineType::Foliage		);
+		return secondaries;
+	}
 
-		if (pipelineUsesLighting && m_DescriptorManager && m_CurrentPipelineLayout != VK_NULL_HANDLE)
+	VkCommandBuffer CommandRecorder::GetCachedSecondary(uint32_t bufferIndex, uint32_t cacheId,
+		uint64_t signature, const SecondaryRecordTask& task)
+	{
+		if (bufferIndex >= m_CachedSecondaries.size() || !m_CachedSecondaryPool)
 		{
-			VkDescriptorSet lightingSet = m_DescriptorManager->GetLightingDescriptorSet(bufferIndex);
-			vkCmdBindDescriptorSets(
-				commandBuffer,
-				VK_PIPELINE_BIND_POINT_GRAPHICS,
-				m_CurrentPipelineLayout,
-				2,  // set 2 for lighting
-				1,
-				&lightingSet,
-				0,
-				nullptr
-			);
+			return VK_NULL_HANDLE;
 		}
 
-		bool pipelineUsesShadowMap = (
-			cmd.pipeline == PipelineType::Mesh		||
-			cmd.pipeline == PipelineType::Terrain	||
-			cmd.pipeline == PipelineType::Foliage	);
+		// The secondary bakes in its inheritance and dynamic state too
+		SignatureHash hash(signature);
+		hash.Mix(task.pass.renderPass);
+		hash.Mix(task.pass.framebuffer);
+		hash.Mix(task.pass.viewport.x);
+		hash.Mix(task.pass.viewport.y);
+		hash.Mix(task.pass.viewport.width);
+		hash.Mix(task.pass.viewport.height);
+		hash.Mix(task.pass.viewport.minDepth);
+		hash.Mix(task.pass.viewport.maxDepth);
+		hash.Mix(task.pass.scissor.offset.x);
+		hash.Mix(task.pass.scissor.offset.y);
+		hash.Mix(task.pass.scissor.extent.width);
+		hash.Mix(task.pass.scissor.extent.height);
+		hash.Mix(m_InheritOcclusion);
+		hash.Mix(m_InheritOcclusionFlags);
+		hash.Mix(m_InheritPipelineStatistics);
+
+		CachedSecondary& cached = m_CachedSecondaries[bufferIndex][cacheId];
+		if (cached.recorded && cached.signature == hash.Get())
+		{
+			++m_CachedSecondaryStats.reused;
+			return cached.buffer;
+		}
 
-		if (pipelineUsesShadowMap && m_DescriptorManager && m_CurrentPipelineLayout != VK_NULL_HANDLE)
+		if (cached.buffer == VK_NULL_HANDLE)
 		{
-			VkDescriptorSet shadowSet = m_DescriptorManager->GetShadowDescriptorSet(bufferIndex);
-			if (shadowSet != VK_NULL_HANDLE)
+			cached.buffer = m_CachedSecondaryPool->AllocateCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+			if (cached.buffer == VK_NULL_HANDLE)
 			{
-				vkCmdBindDescriptorSets(
-					commandBuffer,
-					VK_PIPELINE_BIND_POINT_GRAPHICS,
-					m_CurrentPipelineLayout,
-					3,  // set 3 for shadow map
-					1,
-					&shadowSet,
-					0,
-					nullptr
-				);
+				LOG_ERROR("Failed to allocate cached secondary command buffer");
+				return VK_NULL_HANDLE;
 			}
 		}
 
-		bool pipelineUsesHeightmap = (
-			cmd.pipeline == PipelineType::Terrain	||
-			cmd.pipeline == PipelineType::Foliage	);
-
-		if (pipelineUsesHeightmap && cmd.heightmapDescriptorSet != VK_NULL_HANDLE
-			&& m_CurrentPipelineLayout != VK_NULL_HANDLE)
+		// The frame slot's fence has been waited on, so the buffer is idle;
+		// beginning it again resets it (the pool allows single resets)
+		cached.recorded = false;
+		if (!BeginSecondary(cached.buffer, task.pass, 0))
 		{
-			vkCmdBindDescriptorSets(
-				commandBuffer,
-				VK_PIPELINE_BIND_POINT_GRAPHICS,
-				m_CurrentPipelineLayout,
-				4,   // set 4
-				1,
-				&cmd.heightmapDescriptorSet,
-				0,
-				nullptr
-			);
+			return VK_NULL_HANDLE;
 		}
-
-		// --- Water descriptor sets (set 0 = scene uniform, set 1 = lighting,
-		//     set 2 = reflection target). Water's set layout differs from the
-		//     Mesh/Terrain convention (no texture set, lighting at set 1), so it
-		//     gets its own block rather than reusing the generic chain above. ---
-		if (cmd.pipeline == PipelineType::Water && m_DescriptorManager && m_CurrentPipelineLayout != VK_NULL_HANDLE)
+		if (task.record)
 		{
-			VkDescriptorSet uniformSet = m_DescriptorManager->GetUniformDescriptorSet(bufferIndex);
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-				m_CurrentPipelineLayout, 0, 1, &uniformSet, 0, nullptr);
+			task.record(cached.buffer);
+		}
+		if (vkEndCommandBuffer(cached.buffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to record cached secondary command buffer");
+			return VK_NULL_HANDLE;
+		}
 
-			VkDescriptorSet lightingSet = m_DescriptorManager->GetLightingDescriptorSet(bufferIndex);
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-				m_CurrentPipelineLayout, 1, 1, &lightingSet, 0, nullptr);
+		cached.signature = hash.Get();
+		cached.recorded = true;
+		++m_CachedSecondaryStats.recorded;
+		return cached.buffer;
+	}
 
-			if (m_ReflectionInputSet != VK_NULL_HANDLE)
-			{
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-					m_CurrentPipelineLayout, 2, 1, &m_ReflectionInputSet, 0, nullptr);
-			}
+	void CommandRecorder::InvalidateCachedSecondaries()
+	{
+		for (auto& frameCache : m_CachedSecondaries)
+		{
+			for (auto& [cacheId, cached] : frameCache)
+				cached.recorded = false;
 		}
+	}
 
-		// Set push constants if needed
-		if (cmd.hasPushConstants && m_CurrentPipelineLayout != VK_NULL_HANDLE)
+	void CommandRecorder::ExecuteSecondaries(uint32_t bufferIndex, const std::vector<VkCommandBuffer>& secondaries)
+	{
+		if (bufferIndex >= m_CommandBuffers.size())
 		{
-			// Push to both vertex and fragment stages
-			pipelineManager->GetVulkanManager()->PushConstants(
-				commandBuffer,
-				cmd.pipeline,
-				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				&cmd.pushConstants,  // Just use directly - no modification needed
-				sizeof(PushConstantData)
-			);
+			LOG_ERROR("Invalid command buffer index: {}", bufferIndex);
+			return;
 		}
 
-		// Bind vertex buffer
-		if (cmd.vertexBuffer)
+		std::vector<VkCommandBuffer> valid;
+		valid.reserve(secondaries.size());
+		for (VkCommandBuffer secondary : secondaries)
 		{
-			VulkanBuffer* vkBuffer = static_cast<VulkanBuffer*>(cmd.vertexBuffer);
-			VkBuffer vertexBuffers[] = { vkBuffer->GetBuffer() };
-			VkDeviceSize offsets[] = { 0 };
-			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+			if (secondary != VK_NULL_HANDLE)
+				valid.push_back(secondary);
 		}
 
-		// Execute pre-draw callback if provided
-		if (cmd.preDrawCallback)
+		if (!valid.empty())
 		{
-			cmd.preDrawCallback();
+			vkCmdExecuteCommands(m_CommandBuffers[bufferIndex],
+				static_cast<uint32_t>(valid.size()), valid.data());
 		}
+	}
 
-		// Draw
-		if (cmd.indexBuffer && cmd.indexCount > 0)
+	std::vector<SecondaryRecordTask> CommandRecorder::BuildChunkTasks(size_t commandCount,
+		const SecondaryPassInfo& pass,
+		const std::function<void(VkCommandBuffer, size_t, size_t)>& recordRange) const
+	{
+		// One contiguous chunk per recording thread, but never smaller than
+		// MIN_COMMANDS_PER_CHUNK. Always at least one chunk so the pass still
+		// records its (possibly empty) secondary.
+		size_t maxChunks = std::max<size_t>(1, GetRecordThreadCount());
+		size_t chunkCount = std::clamp<size_t>(commandCount / MIN_COMMANDS_PER_CHUNK, 1, maxChunks);
+		size_t chunkSize = (commandCount + chunkCount - 1) / chunkCount;
+
+		std::vector<SecondaryRecordTask> tasks;
+		tasks.reserve(chunkCount);
+		for (size_t begin = 0; begin < commandCount || tasks.empty(); begin += chunkSize)
 		{
-			// Indexed draw
-			VulkanBuffer* vkIndexBuffer = static_cast<VulkanBuffer*>(cmd.indexBuffer);
-			vkCmdBindIndexBuffer(commandBuffer, vkIndexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(commandBuffer, cmd.indexCount, cmd.instanceCount, 0, 0, cmd.firstInstance);
+			size_t end = std::min(commandCount, begin + chunkSize);
+			SecondaryRecordTask task;
+			task.pass = pass;
+			task.record = [&recordRange, begin, end](VkCommandBuffer secondary)
+			{
+				recordRange(secondary, begin, end);
+			};
+			tasks.push_back(std::move(task));
+
+			if (chunkSize == 0)
+				break;
 		}
-		else if (cmd.vertexCount > 0)
+		return tasks;
+	}
+
+	void CommandRecorder::ExecuteDrawListParallel(uint32_t bufferIndex, const DrawList& drawList,
+		VulkanPipelineAdapter* pipelineManager,
+		const glm::mat4& viewMatrix,
+		const glm::mat4& projectionMatrix,
+		const SecondaryPassInfo& pass)
+	{
+		if (bufferIndex >= m_CommandBuffers.size() || !pipelineManager)
 		{
-			// Non-indexed draw
-			vkCmdDraw(commandBuffer, cmd.vertexCount, cmd.instanceCount, 0, cmd.firstInstance);
+			return;
 		}
 
-		// Execute post-draw callback if provided
-		if (cmd.postDrawCallback)
+		const bool prepass = HasDepthPrepass(drawList);
+
+		std::function<void(VkCommandBuffer, size_t, size_t)> recordPrepassRange =
+			[&](VkCommandBuffer secondary, size_t begin, size_t end)
+		{
+			RecordContext ctx{ secondary, bufferIndex };
+			RecordDepthPrepassRange(ctx, drawList, begin, end, pipelineManager);
+		};
+
+		std::function<void(VkCommandBuffer, size_t, size_t)> recordRange =
+			[&](VkCommandBuffer secondary, size_t begin, size_t end)
+		{
+			RecordContext ctx{ secondary, bufferIndex };
+			ctx.depthStage = prepass ? DepthStage::Equal : DepthStage::Off;
+			RecordDrawRange(ctx, drawList, begin, end, pipelineManager);
+		};
+
+		// Prepass chunks go first in the same batch, so they record in
+		// parallel with the color chunks but execute ahead of them
+		std::vector<SecondaryRecordTask> tasks;
+		if (prepass)
+			tasks = BuildChunkTasks(drawList.GetDepthPrepassOrder().size(), pass, recordPrepassRange);
+		std::vector<SecondaryRecordTask> colorTasks = BuildChunkTasks(drawList.GetCommandCount(), pass, recordRange);
+		tasks.insert(tasks.end(), std::make_move_iterator(colorTasks.begin()), std::make_move_iterator(colorTasks.end()));
+		ExecuteSecondaries(bufferIndex, RecordSecondaries(bufferIndex, tasks));
+
+		// The primary recorded no binds of its own inside this pass
+		StoreSerialContext(RecordContext{});
+	}
+
+	void CommandRecorder::ExecuteReflectionDrawListParallel(uint32_t bufferIndex, const DrawList& drawList,
+		VulkanPipelineAdapter* pipelineManager,
+		VkDescriptorSet reflectionUniformSet,
+		VkDescriptorSet cloudReflectionResultSet,
+		const uint8_t* casters,
+		const SecondaryPassInfo& pass)
+	{
+		if (bufferIndex >= m_CommandBuffers.size() || !pipelineManager)
 		{
-			cmd.postDrawCallback();
+			return;
 		}
+
+		std::function<void(VkCommandBuffer, size_t, size_t)> recordRange =
+			[&](VkCommandBuffer secondary, size_t begin, size_t end)
+		{
+			RecordContext ctx{ secondary, bufferIndex };
+			RecordReflectionRange(ctx, drawList, begin, end, pipelineManager,
+				reflectionUniformSet, cloudReflectionResultSet, casters);
+		};
+
+		std::vector<SecondaryRecordTask> tasks = BuildChunkTasks(drawList.GetCommandCount(), pass, recordRange);
+		ExecuteSecondaries(bufferIndex, RecordSecondaries(bufferIndex, tasks));
+		StoreSerialContext(RecordContext{});
 	}
 
 	void CommandRecorder::BindPipelineIfChanged(uint32_t bufferIndex, VkPipeline pipeline)
@@ -525,6 +1225,7 @@ namespace Nightbloom
 		if (pipeline != m_CurrentPipeline)
 		{
 			vkCmdBindPipeline(m_CommandBuffers[bufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			RenderStats::Get().Add(RenderCounter::PipelineBinds);
 			m_CurrentPipeline = pipeline;
 		}
 	}
@@ -533,6 +1234,7 @@ namespace Nightbloom
 		const void* data, uint32_t size, VkShaderStageFlags stages)
 	{
 		vkCmdPushConstants(m_CommandBuffers[bufferIndex], layout, stages, 0, size, data);
+		RenderStats::Get().Add(RenderCounter::PushConstants);
 	}
 
 	void CommandRecorder::BindTextureDescriptorSet(uint32_t frameIndex, VkDescriptorSet set, VkPipelineLayout layout)
@@ -547,5 +1249,6 @@ namespace Nightbloom
 			0,  // dynamic offset count
 			nullptr
 		);
+		RenderStats::Get().Add(RenderCounter::DescriptorBinds);
 	}
 }
\ No newline at end of file
@@ -8,9 +8,14 @@
 
 #include <vulkan/vulkan.h>
 #include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"  // ADD THIS - Need full definition
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/PipelineBindings.hpp"
 #include <glm/glm.hpp>
 #include <vector>
+#include <array>
 #include <memory>
+#include <functional>
+#include <unordered_map>
 #include <cstdint>
 
 namespace Nightbloom
@@ -22,11 +27,35 @@ namespace Nightbloom
 	class DrawList;
 	struct DrawCommand;
 
+	// Inheritance + dynamic state for one secondary command buffer. Viewport and
+	// scissor are not inherited from the primary, so every secondary sets its own.
+	struct SecondaryPassInfo
+	{
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+		VkViewport viewport{};
+		VkRect2D scissor{};
+	};
+
+	// One unit of parallel recording: record() is called on a worker thread with
+	// an already-begun secondary command buffer inside pass's render pass.
+	struct SecondaryRecordTask
+	{
+		SecondaryPassInfo pass;
+		std::function<void(VkCommandBuffer)> record;
+	};
+
 	class CommandRecorder
 	{
 	public:
-		CommandRecorder() = default;
-		~CommandRecorder() = default;
+		// Upper bound on recording threads (the calling thread counts as one).
+		static constexpr uint32_t MAX_RECORD_THREADS = 4;
+		// Draw lists are only split into chunks of at least this many commands;
+		// below that the per-secondary overhead outweighs the parallelism.
+		static constexpr uint32_t MIN_COMMANDS_PER_CHUNK = 64;
+
+		CommandRecorder();
+		~CommandRecorder();
 
 		// Lifecycle
 		bool Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager, uint32_t commandBufferCount);
@@ -37,11 +66,72 @@ namespace Nightbloom
 		void EndCommandBuffer(uint32_t bufferIndex);
 		void ResetCommandBuffer(uint32_t bufferIndex);
 
-		// Render pass operations
+		// Ends the recorded head of this frame's primary and returns it for a
+		// separate submit; recording continues in a fresh primary, which
+		// GetCommandBuffer(bufferIndex) returns from now on. Lets the head of
+		// the frame start before a semaphore the rest has to wait on. The
+		// secondary pools are not reset - the frame is still the same one.
+		VkCommandBuffer SplitCommandBuffer(uint32_t bufferIndex);
+
+		// Render pass operations. With VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+		// no viewport/scissor is set on the primary (only vkCmdExecuteCommands may
+		// follow); the secondaries set their own.
 		void BeginRenderPass(uint32_t bufferIndex, VkRenderPass renderPass,
 			VkFramebuffer framebuffer, VkExtent2D extent,
-			const VkClearValue* clearValue, uint32_t clearValueCount);
+			const VkClearValue* clearValue, uint32_t clearValueCount,
+			VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 		void EndRenderPass(uint32_t bufferIndex);
+		// vkCmdNextSubpass (inline contents); binding tracking restarts
+		void NextSubpass(uint32_t bufferIndex);
+
+		// Parallel recording. When enabled, the Renderer records its heavy passes
+		// (scene, shadow cascades, reflection) into secondary command buffers on
+		// the worker threads and the primary only executes them.
+		void SetParallelRecording(bool enabled) { m_ParallelRecording = enabled; }
+		bool IsParallelRecording() const { return m_ParallelRecording; }
+
+		// Queries the secondaries may be executed under (GpuProfiler's
+		// pipeline statistics scopes). Needs the inheritedQueries feature.
+		void SetInheritedQueries(bool occlusion, VkQueryControlFlags occlusionFlags,
+			VkQueryPipelineStatisticFlags pipelineStatistics)
+		{
+			m_InheritOcclusion = occlusion;
+			m_InheritOcclusionFlags = occlusionFlags;
+			m_InheritPipelineStatistics = pipelineStatistics;
+		}
+		uint32_t GetRecordThreadCount() const;
+
+		// Records every task into its own secondary command buffer (allocated from
+		// the recording thread's pool for this frame) and returns them in task
+		// order. Tasks may run concurrently: record() must only touch state that
+		// is read-only for the duration of the call. Null entries mark failures.
+		std::vector<VkCommandBuffer> RecordSecondaries(uint32_t bufferIndex,
+			const std::vector<SecondaryRecordTask>& tasks);
+
+		// vkCmdExecuteCommands on the primary, in order, skipping null entries.
+		// Must be inside a render pass begun with SECONDARY_COMMAND_BUFFERS.
+		void ExecuteSecondaries(uint32_t bufferIndex, const std::vector<VkCommandBuffer>& secondaries);
+
+		// A secondary kept across frames for content that rarely changes (static
+		// shadow casters). It is re-recorded, on the calling thread, only when
+		// signature differs from the one it was last recorded with - so the
+		// signature must cover everything task.record() reads, handles included;
+		// the pass info and inherited queries are mixed in here - and otherwise
+		// returned as is. One buffer per (frame, cacheId): a re-record never
+		// touches a buffer the GPU may still be reading.
+		VkCommandBuffer GetCachedSecondary(uint32_t bufferIndex, uint32_t cacheId,
+			uint64_t signature, const SecondaryRecordTask& task);
+		// Forces every cached secondary to re-record on its next use. Call when
+		// something they reference may be destroyed and its handle reused.
+		void InvalidateCachedSecondaries();
+
+		// Cached secondaries replayed / re-recorded since the last BeginCommandBuffer
+		struct CachedSecondaryStats
+		{
+			uint32_t reused = 0;
+			uint32_t recorded = 0;
+		};
+		const CachedSecondaryStats& GetCachedSecondaryStats() const { return m_CachedSecondaryStats; }
 
 		// Draw operations
 		void ExecuteDrawList(uint32_t bufferIndex, const DrawList& drawList,
@@ -56,10 +146,30 @@ namespace Nightbloom
 		// set by the caller before this runs. If cloudReflectionResultSet is
 		// non-null, the Clouds composite is also replayed, sampling that set (the
 		// mirror-camera raymarch result) so clouds appear in the reflection.
+		// casters, when given, holds one byte per sorted command; commands whose
+		// byte is 0 are skipped (Renderer::CullReflectionCasters).
 		void ExecuteReflectionDrawList(uint32_t bufferIndex, const DrawList& drawList,
 			VulkanPipelineAdapter* pipelineManager,
 			VkDescriptorSet reflectionUniformSet,
-			VkDescriptorSet cloudReflectionResultSet = VK_NULL_HANDLE);
+			VkDescriptorSet cloudReflectionResultSet = VK_NULL_HANDLE,
+			const uint8_t* casters = nullptr);
+
+		// Secondary-buffer variants of the two list executors above. The list is
+		// split into contiguous chunks (order is preserved, so pipeline sorting and
+		// transparent blending order still hold), each recorded on a worker, then
+		// executed on the primary. Call between BeginRenderPass(...,
+		// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS) and EndRenderPass.
+		void ExecuteDrawListParallel(uint32_t bufferIndex, const DrawList& drawList,
+			VulkanPipelineAdapter* pipelineManager,
+			const glm::mat4& viewMatrix,
+			const glm::mat4& projectionMatrix,
+			const SecondaryPassInfo& pass);
+		void ExecuteReflectionDrawListParallel(uint32_t bufferIndex, const DrawList& drawList,
+			VulkanPipelineAdapter* pipelineManager,
+			VkDescriptorSet reflectionUniformSet,
+			VkDescriptorSet cloudReflectionResultSet,
+			const uint8_t* casters,
+			const SecondaryPassInfo& pass);
 
 		// Individual draw command execution. overrideUniformSet, when non-null,
 		// is bound at set 0 in place of the per-frame scene uniform set (used by
@@ -75,6 +185,59 @@ namespace Nightbloom
 		// draw. Not owned.
 		void SetReflectionInputSet(VkDescriptorSet set) { m_ReflectionInputSet = set; }
 
+		// OcclusionCuller's per-frame VkDrawIndexedIndirectCommand buffer. When
+		// set, the main color pass draws commands that have an occlusionSlot from
+		// it instead of directly. Null disables. Not owned.
+		void SetOcclusionDrawBuffer(uint32_t frameIndex, VkBuffer buffer) { m_OcclusionDrawBuffers[frameIndex % m_OcclusionDrawBuffers.size()] = buffer; }
+
+		// The Renderer's per-frame IndexedIndirectDraw buffer (one entry per
+		// sorted command, DrawList::WriteIndirectDraws) and how many entries it
+		// holds. When set, the main color pass issues each run of compatible
+		// Mesh draws as one vkCmdDrawIndexedIndirect - from the occlusion buffer
+		// if the run was Hi-Z tested, from this one otherwise. Null keeps one
+		// draw call per command; set only when the device has multiDrawIndirect.
+		void SetIndirectDrawBuffer(uint32_t frameIndex, VkBuffer buffer, uint32_t drawCount)
+		{
+			m_IndirectDraws[frameIndex % m_IndirectDraws.size()] = { buffer, drawCount };
+		}
+
+		// MeshletCuller's per-frame draw and counter buffers. When set, the
+		// main color pass draws commands that have a meshletJob as their
+		// surviving meshlets (vkCmdDrawIndexedIndirectCount). Not owned.
+		void SetMeshletDrawBuffers(uint32_t frameIndex, VkBuffer draws, VkBuffer counts)
+		{
+			m_MeshletDraws[frameIndex % m_MeshletDraws.size()] = { draws, counts };
+		}
+
+		// Depth prepass (Renderer::SetDepthPrepass). When on, ExecuteDrawList
+		// and ExecuteDrawListParallel first walk the list's
+		// GetDepthPrepassOrder with the depth-only pipeline twins, then draw
+		// those same commands with the EQUAL twins in the normal walk. The
+		// caller builds the order each frame and has created every twin.
+		void SetDepthPrepass(bool enabled) { m_DepthPrepass = enabled; }
+		bool IsDepthPrepass() const { return m_DepthPrepass; }
+
+		// Order-independent transparency (Renderer::
+		// SetOrderIndependentTransparency). When on, the color pass leaves out
+		// every draw with an OIT twin (DrawList::IsOrderIndependentCandidate);
+		// ExecuteTransparentDrawList records those with the twins bound, in
+		// the first subpass of the OIT pass. The caller has created every twin.
+		void SetOrderIndependentTransparency(bool enabled) { m_OrderIndependentTransparency = enabled; }
+		bool IsOrderIndependentTransparency() const { return m_OrderIndependentTransparency; }
+		void ExecuteTransparentDrawList(uint32_t bufferIndex, const DrawList& drawList,
+			VulkanPipelineAdapter* pipelineManager);
+
+		// Reflection twins (RenderPassManager::NeedsReflectionPipelines). When
+		// on, the reflection executors bind the GetReflectionPipeline twin of
+		// every draw, built for the reflection pass's own sample count. The
+		// caller has created every twin.
+		void SetReflectionTwins(bool enabled) { m_ReflectionTwins = enabled; }
+
+		// Mesh/Transparent were built against the descriptor manager's bindless
+		// table: bind it at set 1 once per pipeline switch and pass each
+		// draw's texture slot in the push constants instead of binding sets.
+		void SetBindlessMeshPasses(bool enabled) { m_BindlessMeshPasses = enabled; }
+
 		// Getters
 		VkCommandBuffer GetCommandBuffer(uint32_t index) const
 		{
@@ -82,19 +245,148 @@ namespace Nightbloom
 		}
 
 	private:
+		// Which twin a prepassed draw binds (GetDepthPrepassPipeline /
+		// GetDepthEqualPipeline); Off binds the pipeline as is
+		enum class DepthStage : uint8_t
+		{
+			Off,
+			Prepass,
+			Equal
+		};
+
+		// Binding state for one command buffer being recorded. The serial path
+		// keeps it in the members below; each parallel chunk owns its own so
+		// workers never share redundant-bind tracking.
+		struct RecordContext
+		{
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			uint32_t frameIndex = 0;
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+			VkBuffer vertexBuffer = VK_NULL_HANDLE;
+			VkBuffer indexBuffer = VK_NULL_HANDLE;
+			DepthStage depthStage = DepthStage::Off;
+			bool orderIndependent = false;  // bind GetOitPipeline twins
+			bool reflection = false;        // bind GetReflectionPipeline twins
+			// Set bound at each index since pipelineLayout last changed; a
+			// draw rebinds only the indices whose set differs
+			std::array<VkDescriptorSet, PipelineBindingLayout::MAX_SETS> boundSets{};
+		};
+
+		// Per-thread, per-frame secondary command buffers. A pool is only ever
+		// touched by its owning thread slot, and is reset wholesale when its frame
+		// begins again (after the wait on that frame slot).
+		struct SecondaryPool
+		{
+			std::unique_ptr<VulkanCommandPool> pool;
+			std::vector<VkCommandBuffer> buffers;
+			uint32_t used = 0;
+		};
+
+		// A secondary outliving its frame (GetCachedSecondary)
+		struct CachedSecondary
+		{
+			VkCommandBuffer buffer = VK_NULL_HANDLE;
+			uint64_t signature = 0;
+			bool recorded = false;
+		};
+
+		// Persistent recording threads (defined in the .cpp).
+		struct RecordWorkers;
+
+		// GPU-written draw parameters the main color pass reads instead of the
+		// command's own. drawCount > 1 draws a multi-draw run headed by the
+		// command: drawCount consecutive entries of occlusionDraws (from its
+		// slot) or of indirectDraws (from indirectIndex).
+		struct DrawSources
+		{
+			VkBuffer occlusionDraws = VK_NULL_HANDLE;
+			VkBuffer indirectDraws = VK_NULL_HANDLE;
+			uint32_t indirectIndex = 0;
+			uint32_t drawCount = 1;
+			VkBuffer meshletDraws = VK_NULL_HANDLE;
+			VkBuffer meshletCounts = VK_NULL_HANDLE;
+		};
+
+		// sources is null outside the main color pass
+		void RecordDrawCommand(RecordContext& ctx, const DrawCommand& cmd,
+			VulkanPipelineAdapter* pipelineManager,
+			VkDescriptorSet overrideUniformSet,
+			const DrawSources* sources = nullptr);
+		// Binds the sets GetPipelineBindings lists for the draw's base type
+		void BindDrawSets(RecordContext& ctx, const DrawCommand& cmd,
+			VkDescriptorSet overrideUniformSet, bool bindlessDraw);
+		// Ranges are in the draw list's sorted order (DrawList::GetCommand)
+		void RecordDrawRange(RecordContext& ctx, const DrawList& drawList,
+			size_t begin, size_t end, VulkanPipelineAdapter* pipelineManager);
+		// Range of positions in the list's GetDepthPrepassOrder
+		void RecordDepthPrepassRange(RecordContext& ctx, const DrawList& drawList,
+			size_t begin, size_t end, VulkanPipelineAdapter* pipelineManager);
+		bool HasDepthPrepass(const DrawList& drawList) const;
+		void RecordReflectionRange(RecordContext& ctx, const DrawList& drawList,
+			size_t begin, size_t end, VulkanPipelineAdapter* pipelineManager,
+			VkDescriptorSet reflectionUniformSet, VkDescriptorSet cloudReflectionResultSet,
+			const uint8_t* casters);
+		std::vector<SecondaryRecordTask> BuildChunkTasks(size_t commandCount, const SecondaryPassInfo& pass,
+			const std::function<void(VkCommandBuffer, size_t, size_t)>& recordRange) const;
+		VkCommandBuffer AcquireSecondary(uint32_t bufferIndex, uint32_t slot);
+		bool BeginSecondary(VkCommandBuffer secondary, const SecondaryPassInfo& pass, VkCommandBufferUsageFlags flags) const;
+		RecordContext SerialContext(uint32_t bufferIndex) const;
+		void StoreSerialContext(const RecordContext& ctx);
+
 		VulkanDevice* m_Device = nullptr;
 		VulkanDescriptorManager* m_DescriptorManager = nullptr;
 		std::unique_ptr<VulkanCommandPool> m_CommandPool;
 		std::vector<VkCommandBuffer> m_CommandBuffers;
+		std::vector<VkCommandBuffer> m_SplitCommandBuffers;  // swapped in by SplitCommandBuffer
 
 		// Track current state to minimize redundant binds
 		uint32_t m_CurrentBufferIndex = 0;
 		VkPipeline m_CurrentPipeline = VK_NULL_HANDLE;
 		VkPipelineLayout m_CurrentPipelineLayout = VK_NULL_HANDLE;
+		VkBuffer m_CurrentVertexBuffer = VK_NULL_HANDLE;
+		VkBuffer m_CurrentIndexBuffer = VK_NULL_HANDLE;
 
 		// Planar-reflection color target descriptor set (Water set 2). Not owned.
 		VkDescriptorSet m_ReflectionInputSet = VK_NULL_HANDLE;
 
+		// Hi-Z occlusion results per frame in flight. Not owned.
+		std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_OcclusionDrawBuffers{};
+
+		// CPU-written multi-draw parameters per frame in flight. Not owned.
+		struct IndirectDrawBuffer
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			uint32_t drawCount = 0;
+		};
+		std::array<IndirectDrawBuffer, MAX_FRAMES_IN_FLIGHT> m_IndirectDraws{};
+
+		// Per-meshlet culling results per frame in flight. Not owned.
+		struct MeshletDrawBuffers
+		{
+			VkBuffer draws = VK_NULL_HANDLE;
+			VkBuffer counts = VK_NULL_HANDLE;
+		};
+		std::array<MeshletDrawBuffers, MAX_FRAMES_IN_FLIGHT> m_MeshletDraws{};
+
+		bool m_BindlessMeshPasses = false;
+		bool m_DepthPrepass = false;
+		bool m_OrderIndependentTransparency = false;
+		bool m_ReflectionTwins = false;
+
+		// Parallel recording
+		bool m_ParallelRecording = false;
+		std::vector<std::vector<SecondaryPool>> m_SecondaryPools;  // [frame][thread slot]
+		std::unique_ptr<RecordWorkers> m_Workers;
+		bool m_InheritOcclusion = false;
+		VkQueryControlFlags m_InheritOcclusionFlags = 0;
+		VkQueryPipelineStatisticFlags m_InheritPipelineStatistics = 0;
+
+		// Cached secondaries: one resettable pool, only touched by the calling thread
+		std::unique_ptr<VulkanCommandPool> m_CachedSecondaryPool;
+		std::vector<std::unordered_map<uint32_t, CachedSecondary>> m_CachedSecondaries;  // [frame][cacheId]
+		CachedSecondaryStats m_CachedSecondaryStats;
+
 		// Helper methods
 		void BindPipelineIfChanged(uint32_t bufferIndex, VkPipeline pipeline);
 		void SetPushConstants(uint32_t bufferIndex, VkPipelineLayout layout,
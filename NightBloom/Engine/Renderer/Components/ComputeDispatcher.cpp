@@ -7,6 +7,8 @@
 #include "ComputeDispatcher.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
 #include "Engine/Renderer/Vulkan/VulkanPipeline.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 
 namespace Nightbloom
@@ -37,6 +39,10 @@ namespace Nightbloom
 
     void ComputeDispatcher::Cleanup()
     {
+        m_BatchCommandBuffer = VK_NULL_HANDLE;
+        m_MemoryBarriers.clear();
+        m_BufferBarriers.clear();
+        m_ImageBarriers.clear();
         m_Device = nullptr;
         m_PipelineManager = nullptr;
         LOG_INFO("ComputeDispatcher cleaned up");
@@ -61,7 +67,9 @@ namespace Nightbloom
 			return;
 		}
 
+		VulkanDebugMarkers::InsertPipelineLabel(cmd, pipeline);
 		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		RenderStats::Get().Add(RenderCounter::PipelineBinds);
 	}
 
 	void ComputeDispatcher::BindPipeline(VkCommandBuffer cmd, VkPipeline pipeline)
@@ -72,7 +80,9 @@ namespace Nightbloom
 			return;
 		}
 
+		VulkanDebugMarkers::InsertPipelineLabel(cmd, pipeline);
 		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		RenderStats::Get().Add(RenderCounter::PipelineBinds);
 	}
 
 	// =========================================================================
@@ -89,6 +99,7 @@ namespace Nightbloom
 
 		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
 			layout, setIndex, 1, &set, 0, nullptr);
+		RenderStats::Get().Add(RenderCounter::DescriptorBinds);
     }
 
     void ComputeDispatcher::BindDescriptorSets(VkCommandBuffer cmd, VkPipelineLayout layout, uint32_t firstSet, const std::vector<VkDescriptorSet>& sets)
@@ -103,6 +114,7 @@ namespace Nightbloom
 			layout, firstSet,
 			static_cast<uint32_t>(sets.size()),
 			sets.data(), 0, nullptr);
+		RenderStats::Get().Add(RenderCounter::DescriptorBinds, sets.size());
     }
 
 
@@ -119,6 +131,7 @@ namespace Nightbloom
 		}
 
 		vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_COMPUTE_BIT, offset, size, data);
+		RenderStats::Get().Add(RenderCounter::PushConstants);
     }
 
 	// =========================================================================
@@ -133,7 +146,9 @@ namespace Nightbloom
 			return;
 		}
 
+		FlushBarriers(cmd);
 		vkCmdDispatch(cmd, groupCountX, groupCountY, groupCountZ);
+		RenderStats::Get().Add(RenderCounter::Dispatches);
     }
 
     void ComputeDispatcher::DispatchIndirect(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize offset)
@@ -144,7 +159,9 @@ namespace Nightbloom
 			return;
 		}
 
+		FlushBarriers(cmd);
 		vkCmdDispatchIndirect(cmd, buffer, offset);
+		RenderStats::Get().Add(RenderCounter::Dispatches);
     }
 
     uint32_t ComputeDispatcher::CalculateGroupCount(uint32_t totalSize, uint32_t localSize)
@@ -153,6 +170,215 @@ namespace Nightbloom
 		return (totalSize + localSize - 1) / localSize;
     }
 
+	// =========================================================================
+	// Batched Barriers
+	// =========================================================================
+
+	void ComputeDispatcher::QueueBufferBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size,
+		VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+		VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess)
+	{
+		BeginBatch(cmd);
+
+		VkBufferMemoryBarrier2KHR barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+		barrier.srcStageMask = srcStage;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstStageMask = dstStage;
+		barrier.dstAccessMask = dstAccess;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = buffer;
+		barrier.offset = 0;
+		barrier.size = size;
+		m_BufferBarriers.push_back(barrier);
+	}
+
+	void ComputeDispatcher::QueueImageBarrier(VkCommandBuffer cmd, VkImage image,
+		VkImageLayout oldLayout, VkImageLayout newLayout,
+		VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+		VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess,
+		VkImageAspectFlags aspectMask)
+	{
+		BeginBatch(cmd);
+
+		VkImageMemoryBarrier2KHR barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+		barrier.srcStageMask = srcStage;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstStageMask = dstStage;
+		barrier.dstAccessMask = dstAccess;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = aspectMask;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+		m_ImageBarriers.push_back(barrier);
+	}
+
+	void ComputeDispatcher::QueueMemoryBarrier(VkCommandBuffer cmd,
+		VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+		VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess)
+	{
+		BeginBatch(cmd);
+
+		VkMemoryBarrier2KHR barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+		barrier.srcStageMask = srcStage;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstStageMask = dstStage;
+		barrier.dstAccessMask = dstAccess;
+		m_MemoryBarriers.push_back(barrier);
+	}
+
+	void ComputeDispatcher::FlushBarriers(VkCommandBuffer cmd)
+	{
+		if (cmd != m_BatchCommandBuffer ||
+			(m_MemoryBarriers.empty() && m_BufferBarriers.empty() && m_ImageBarriers.empty()))
+		{
+			return;
+		}
+
+		RenderStats::Get().Add(RenderCounter::Barriers,
+			m_MemoryBarriers.size() + m_BufferBarriers.size() + m_ImageBarriers.size());
+
+		if (m_Device && m_Device->IsSynchronization2Enabled())
+		{
+			VkDependencyInfoKHR dependency{};
+			dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+			dependency.memoryBarrierCount = static_cast<uint32_t>(m_MemoryBarriers.size());
+			dependency.pMemoryBarriers = m_MemoryBarriers.data();
+			dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferBarriers.size());
+			dependency.pBufferMemoryBarriers = m_BufferBarriers.data();
+			dependency.imageMemoryBarrierCount = static_cast<uint32_t>(m_ImageBarriers.size());
+			dependency.pImageMemoryBarriers = m_ImageBarriers.data();
+			m_Device->CmdPipelineBarrier2(cmd, dependency);
+		}
+		else
+		{
+			FlushBarriersLegacy(cmd);
+		}
+
+		m_MemoryBarriers.clear();
+		m_BufferBarriers.clear();
+		m_ImageBarriers.clear();
+		m_BatchCommandBuffer = VK_NULL_HANDLE;
+	}
+
+	void ComputeDispatcher::BeginBatch(VkCommandBuffer cmd)
+	{
+		if (m_BatchCommandBuffer != VK_NULL_HANDLE && m_BatchCommandBuffer != cmd)
+		{
+			// The other buffer is still recording, or this would be a
+			// use-after-end; either way its caller forgot to flush
+			LOG_WARN("ComputeDispatcher: flushing barriers left queued on another command buffer");
+			FlushBarriers(m_BatchCommandBuffer);
+		}
+		m_BatchCommandBuffer = cmd;
+	}
+
+	namespace
+	{
+		// The 1.0 stages a sync2 stage mask falls in. NONE becomes TOP_OF_PIPE
+		// as a source and BOTTOM_OF_PIPE as a destination.
+		VkPipelineStageFlags ToLegacyStages(VkPipelineStageFlags2KHR stages, bool source)
+		{
+			VkPipelineStageFlags legacy = static_cast<VkPipelineStageFlags>(stages & 0xFFFFFFFFull);
+			if (stages & (VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+				VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR))
+				legacy |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+			if (stages & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR))
+				legacy |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+			if (stages & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR)
+				legacy |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
+					VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT | VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT;
+			if (legacy == 0)
+				legacy = source ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			return legacy;
+		}
+
+		VkAccessFlags ToLegacyAccess(VkAccessFlags2KHR access)
+		{
+			VkAccessFlags legacy = static_cast<VkAccessFlags>(access & 0xFFFFFFFFull);
+			if (access & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR))
+				legacy |= VK_ACCESS_SHADER_READ_BIT;
+			if (access & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)
+				legacy |= VK_ACCESS_SHADER_WRITE_BIT;
+			return legacy;
+		}
+	}
+
+	// One vkCmdPipelineBarrier for the whole batch: its stage masks are the
+	// union of every barrier's, which can only widen the dependency
+	void ComputeDispatcher::FlushBarriersLegacy(VkCommandBuffer cmd)
+	{
+		VkPipelineStageFlags2KHR srcStages = 0;
+		VkPipelineStageFlags2KHR dstStages = 0;
+
+		std::vector<VkMemoryBarrier> memoryBarriers;
+		memoryBarriers.reserve(m_MemoryBarriers.size());
+		for (const VkMemoryBarrier2KHR& barrier : m_MemoryBarriers)
+		{
+			VkMemoryBarrier legacy{};
+			legacy.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			legacy.srcAccessMask = ToLegacyAccess(barrier.srcAccessMask);
+			legacy.dstAccessMask = ToLegacyAccess(barrier.dstAccessMask);
+			memoryBarriers.push_back(legacy);
+			srcStages |= barrier.srcStageMask;
+			dstStages |= barrier.dstStageMask;
+		}
+
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		bufferBarriers.reserve(m_BufferBarriers.size());
+		for (const VkBufferMemoryBarrier2KHR& barrier : m_BufferBarriers)
+		{
+			VkBufferMemoryBarrier legacy{};
+			legacy.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			legacy.srcAccessMask = ToLegacyAccess(barrier.srcAccessMask);
+			legacy.dstAccessMask = ToLegacyAccess(barrier.dstAccessMask);
+			legacy.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			legacy.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			legacy.buffer = barrier.buffer;
+			legacy.offset = barrier.offset;
+			legacy.size = barrier.size;
+			bufferBarriers.push_back(legacy);
+			srcStages |= barrier.srcStageMask;
+			dstStages |= barrier.dstStageMask;
+		}
+
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		imageBarriers.reserve(m_ImageBarriers.size());
+		for (const VkImageMemoryBarrier2KHR& barrier : m_ImageBarriers)
+		{
+			VkImageMemoryBarrier legacy{};
+			legacy.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			legacy.srcAccessMask = ToLegacyAccess(barrier.srcAccessMask);
+			legacy.dstAccessMask = ToLegacyAccess(barrier.dstAccessMask);
+			legacy.oldLayout = barrier.oldLayout;
+			legacy.newLayout = barrier.newLayout;
+			legacy.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+			legacy.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+			legacy.image = barrier.image;
+			legacy.subresourceRange = barrier.subresourceRange;
+			imageBarriers.push_back(legacy);
+			srcStages |= barrier.srcStageMask;
+			dstStages |= barrier.dstStageMask;
+		}
+
+		vkCmdPipelineBarrier(cmd,
+			ToLegacyStages(srcStages, true),
+			ToLegacyStages(dstStages, false),
+			0,
+			static_cast<uint32_t>(memoryBarriers.size()), memoryBarriers.data(),
+			static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+			static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+	}
+
 	// =========================================================================
 	// Buffer Memory Barriers
 	// =========================================================================
@@ -211,6 +437,15 @@ namespace Nightbloom
 			VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
     }
 
+    void ComputeDispatcher::TransferToComputeBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size)
+    {
+		InsertBufferBarrier(cmd, buffer, size,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
 	// =========================================================================
 	// Image Memory Barriers
 	// =========================================================================
@@ -239,6 +474,30 @@ namespace Nightbloom
 			aspectMask);
     }
 
+    void ComputeDispatcher::ComputeWriteToGraphicsAndComputeSampleBarrier(VkCommandBuffer cmd, VkImage image, VkImageAspectFlags aspectMask)
+    {
+		InsertImageBarrier(cmd, image,
+			VK_IMAGE_LAYOUT_GENERAL,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			aspectMask);
+    }
+
+    void ComputeDispatcher::ComputeWriteToComputeSampleBarrier(VkCommandBuffer cmd, VkImage image, VkImageAspectFlags aspectMask)
+    {
+		InsertImageBarrier(cmd, image,
+			VK_IMAGE_LAYOUT_GENERAL,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			aspectMask);
+    }
+
     void ComputeDispatcher::ComputeToComputeImageBarrier(VkCommandBuffer cmd, VkImage image, VkImageAspectFlags aspectMask)
     {
 		// Image stays in GENERAL layout for continued compute access
@@ -260,7 +519,8 @@ namespace Nightbloom
 
 		if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
 		{
-			srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			// Vertex too: displacement maps (the terrain heightmap) are read there
+			srcStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 			srcAccess = VK_ACCESS_SHADER_READ_BIT;
 		}
 		else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
@@ -307,95 +567,108 @@ namespace Nightbloom
     }
 
 
+	// =========================================================================
+	// Queue Family Ownership Transfers
+	// =========================================================================
+
+    void ComputeDispatcher::ReleaseBufferOwnership(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size,
+		uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess)
+    {
+		InsertBufferBarrier(cmd, buffer, size,
+			srcStage,
+			VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			srcAccess,
+			0,
+			srcFamily, dstFamily);
+    }
+
+    void ComputeDispatcher::AcquireBufferOwnership(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size,
+		uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+		InsertBufferBarrier(cmd, buffer, size,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			dstStage,
+			0,
+			dstAccess,
+			srcFamily, dstFamily);
+    }
+
+    void ComputeDispatcher::ReleaseImageOwnership(VkCommandBuffer cmd, VkImage image,
+		VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t srcFamily, uint32_t dstFamily,
+		VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkImageAspectFlags aspectMask)
+    {
+		InsertImageBarrier(cmd, image,
+			oldLayout,
+			newLayout,
+			srcStage,
+			VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			srcAccess,
+			0,
+			aspectMask,
+			srcFamily, dstFamily);
+    }
+
+    void ComputeDispatcher::AcquireImageOwnership(VkCommandBuffer cmd, VkImage image,
+		VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t srcFamily, uint32_t dstFamily,
+		VkPipelineStageFlags dstStage, VkAccessFlags dstAccess, VkImageAspectFlags aspectMask)
+    {
+		InsertImageBarrier(cmd, image,
+			oldLayout,
+			newLayout,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			dstStage,
+			0,
+			dstAccess,
+			aspectMask,
+			srcFamily, dstFamily);
+    }
+
 	// =========================================================================
 	// Global Memory Barriers
 	// =========================================================================
 
     void ComputeDispatcher::ComputeToGraphicsGlobalBarrier(VkCommandBuffer cmd)
     {
-		VkMemoryBarrier memoryBarrier{};
-		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-		memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT |
-			VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
-			VK_ACCESS_INDEX_READ_BIT |
-			VK_ACCESS_UNIFORM_READ_BIT;
-
-		vkCmdPipelineBarrier(cmd,
+		QueueMemoryBarrier(cmd,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
 			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
 			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
 			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-			0,
-			1, &memoryBarrier,
-			0, nullptr,
-			0, nullptr);
+			VK_ACCESS_SHADER_READ_BIT |
+			VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+			VK_ACCESS_INDEX_READ_BIT |
+			VK_ACCESS_UNIFORM_READ_BIT);
+		FlushBarriers(cmd);
     }
 
     void ComputeDispatcher::ComputeToComputeGlobalBarrier(VkCommandBuffer cmd)
     {
-		VkMemoryBarrier memoryBarrier{};
-		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-		memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-
-		vkCmdPipelineBarrier(cmd,
+		QueueMemoryBarrier(cmd,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT,
 			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			0,
-			1, &memoryBarrier,
-			0, nullptr,
-			0, nullptr);
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		FlushBarriers(cmd);
     }
 
 	// =========================================================================
 	// Private Helpers
 	// =========================================================================
 
-    void ComputeDispatcher::InsertBufferBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkAccessFlags srcAccess, VkAccessFlags dstAccess)
+    void ComputeDispatcher::InsertBufferBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size, VkPipelineStageFlags2KHR srcStage, VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR srcAccess, VkAccessFlags2KHR dstAccess, uint32_t srcFamily, uint32_t dstFamily)
     {
-		VkBufferMemoryBarrier bufferBarrier{};
-		bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-		bufferBarrier.srcAccessMask = srcAccess;
-		bufferBarrier.dstAccessMask = dstAccess;
-		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferBarrier.buffer = buffer;
-		bufferBarrier.offset = 0;
-		bufferBarrier.size = size;
-
-		vkCmdPipelineBarrier(cmd,
-			srcStage,
-			dstStage,
-			0,
-			0, nullptr,
-			1, &bufferBarrier,
-			0, nullptr);
-    }
-
-    void ComputeDispatcher::InsertImageBarrier(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkImageAspectFlags aspectMask)
-    {
-		VkImageMemoryBarrier imageBarrier{};
-		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		imageBarrier.srcAccessMask = srcAccess;
-		imageBarrier.dstAccessMask = dstAccess;
-		imageBarrier.oldLayout = oldLayout;
-		imageBarrier.newLayout = newLayout;
-		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageBarrier.image = image;
-		imageBarrier.subresourceRange.aspectMask = aspectMask;
-		imageBarrier.subresourceRange.baseMipLevel = 0;
-		imageBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-		imageBarrier.subresourceRange.baseArrayLayer = 0;
-		imageBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+		QueueBufferBarrier(cmd, buffer, size, srcStage, srcAccess, dstStage, dstAccess);
+		m_BufferBarriers.back().srcQueueFamilyIndex = srcFamily;
+		m_BufferBarriers.back().dstQueueFamilyIndex = dstFamily;
+		FlushBarriers(cmd);
+    }
 
-		vkCmdPipelineBarrier(cmd,
-			srcStage,
-			dstStage,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &imageBarrier);
+    void ComputeDispatcher::InsertImageBarrier(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags2KHR srcStage, VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR srcAccess, VkAccessFlags2KHR dstAccess, VkImageAspectFlags aspectMask, uint32_t srcFamily, uint32_t dstFamily)
+    {
+		QueueImageBarrier(cmd, image, oldLayout, newLayout, srcStage, srcAccess, dstStage, dstAccess, aspectMask);
+		m_ImageBarriers.back().srcQueueFamilyIndex = srcFamily;
+		m_ImageBarriers.back().dstQueueFamilyIndex = dstFamily;
+		FlushBarriers(cmd);
     }
 }
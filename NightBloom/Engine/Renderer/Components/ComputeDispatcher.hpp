@@ -29,6 +29,8 @@ namespace Nightbloom
 		// Pipeline Binding
 		// =====================================================================
 
+		// Each bind drops a debug marker with the pipeline's name
+		// (VulkanDebugMarkers), so captures tell the dispatches apart
 		void BindPipeline(VkCommandBuffer cmd, PipelineType type);
 		void BindPipeline(VkCommandBuffer cmd, VkPipeline pipeline);
 
@@ -65,7 +67,33 @@ namespace Nightbloom
 		static uint32_t CalculateGroupCount(uint32_t totalSize, uint32_t localSize);
 
 		// =====================================================================
-		// Buffer Memory Barriers
+		// Batched Barriers (VK_KHR_synchronization2)
+		// =====================================================================
+
+		// Queued barriers carry exact sync2 stage/access masks and go out
+		// together, as one vkCmdPipelineBarrier2, with the next Dispatch or
+		// DispatchIndirect on the same command buffer - or FlushBarriers, which
+		// must come before any other work that depends on them (draws, copies,
+		// fills, raw vkCmdPipelineBarrier). Without synchronization2 the batch
+		// is still one call: a legacy barrier with the masks widened to their
+		// 1.0 equivalents. The batch belongs to one recording thread.
+		void QueueBufferBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size,
+			VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+			VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess);
+		void QueueImageBarrier(VkCommandBuffer cmd, VkImage image,
+			VkImageLayout oldLayout, VkImageLayout newLayout,
+			VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+			VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess,
+			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+		void QueueMemoryBarrier(VkCommandBuffer cmd,
+			VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+			VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess);
+
+		// Records whatever is queued for cmd (nothing if the batch is empty)
+		void FlushBarriers(VkCommandBuffer cmd);
+
+		// =====================================================================
+		// Buffer Memory Barriers (recorded at once, with anything queued)
 		// =====================================================================
 
 		// After compute writes, before vertex shader reads (SSBO in vertex shader)
@@ -86,8 +114,12 @@ namespace Nightbloom
 		// After compute writes, before indirect draw/dispatch reads
 		void ComputeToIndirectBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size);
 
+		// After a transfer write (e.g. vkCmdFillBuffer clearing counters), before compute reads/atomics
+		void TransferToComputeBarrier(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size);
+
 		// =====================================================================
-		// Image Memory Barriers (for 3D textures, storage images, etc.)
+		// Image Memory Barriers (for 3D textures, storage images, etc.;
+		// recorded at once, with anything queued)
 		// =====================================================================
 
 		// After compute writes image, before graphics pipeline samples it
@@ -98,6 +130,16 @@ namespace Nightbloom
 		void ComputeWriteToFragmentSampleBarrier(VkCommandBuffer cmd, VkImage image,
 			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
 
+		// After compute writes image, before both the graphics pipeline and a
+		// later compute pass in the same submission sample it
+		void ComputeWriteToGraphicsAndComputeSampleBarrier(VkCommandBuffer cmd, VkImage image,
+			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+
+		// After compute writes image, before a later compute pass samples it
+		// (valid on a compute-only queue, unlike the graphics-stage variants)
+		void ComputeWriteToComputeSampleBarrier(VkCommandBuffer cmd, VkImage image,
+			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+
 		// Between compute passes that read/write the same image
 		void ComputeToComputeImageBarrier(VkCommandBuffer cmd, VkImage image,
 			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
@@ -111,6 +153,32 @@ namespace Nightbloom
 			VkImageLayout newLayout,
 			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
 
+		// =====================================================================
+		// Queue Family Ownership Transfers (graphics <-> async compute)
+		// =====================================================================
+
+		// Release goes on the queue giving the resource up, the matching
+		// acquire on the queue taking it; a semaphore must order the two
+		// submissions. Image layouts must be identical in both halves. Only
+		// the releasing side's src and the acquiring side's dst scopes apply.
+		void ReleaseBufferOwnership(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size,
+			uint32_t srcFamily, uint32_t dstFamily,
+			VkPipelineStageFlags srcStage, VkAccessFlags srcAccess);
+		void AcquireBufferOwnership(VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize size,
+			uint32_t srcFamily, uint32_t dstFamily,
+			VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+		void ReleaseImageOwnership(VkCommandBuffer cmd, VkImage image,
+			VkImageLayout oldLayout, VkImageLayout newLayout,
+			uint32_t srcFamily, uint32_t dstFamily,
+			VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+		void AcquireImageOwnership(VkCommandBuffer cmd, VkImage image,
+			VkImageLayout oldLayout, VkImageLayout newLayout,
+			uint32_t srcFamily, uint32_t dstFamily,
+			VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+			VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+
 		// =====================================================================
 		// Global Memory Barriers (when specific resources aren't tracked)
 		// =====================================================================
@@ -125,24 +193,38 @@ namespace Nightbloom
 			VulkanDevice* m_Device = nullptr;
 			VulkanPipelineManager* m_PipelineManager = nullptr;
 
-			// Helper for buffer memory barriers
+			// Barrier batch, all for m_BatchCommandBuffer
+			VkCommandBuffer m_BatchCommandBuffer = VK_NULL_HANDLE;
+			std::vector<VkMemoryBarrier2KHR> m_MemoryBarriers;
+			std::vector<VkBufferMemoryBarrier2KHR> m_BufferBarriers;
+			std::vector<VkImageMemoryBarrier2KHR> m_ImageBarriers;
+
+			// Starts a batch on cmd, flushing one left open on another buffer
+			void BeginBatch(VkCommandBuffer cmd);
+			void FlushBarriersLegacy(VkCommandBuffer cmd);
+
+			// Helper for buffer memory barriers: queues it and flushes the batch
 			void InsertBufferBarrier(VkCommandBuffer cmd,
 				VkBuffer buffer,
 				VkDeviceSize size,
-				VkPipelineStageFlags srcStage,
-				VkPipelineStageFlags dstStage,
-				VkAccessFlags srcAccess,
-				VkAccessFlags dstAccess);
-
-			// Helper for image memory barriers
+				VkPipelineStageFlags2KHR srcStage,
+				VkPipelineStageFlags2KHR dstStage,
+				VkAccessFlags2KHR srcAccess,
+				VkAccessFlags2KHR dstAccess,
+				uint32_t srcFamily = VK_QUEUE_FAMILY_IGNORED,
+				uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED);
+
+			// Helper for image memory barriers: queues it and flushes the batch
 			void InsertImageBarrier(VkCommandBuffer cmd,
 				VkImage image,
 				VkImageLayout oldLayout,
 				VkImageLayout newLayout,
-				VkPipelineStageFlags srcStage,
-				VkPipelineStageFlags dstStage,
-				VkAccessFlags srcAccess,
-				VkAccessFlags dstAccess,
-				VkImageAspectFlags aspectMask);
+				VkPipelineStageFlags2KHR srcStage,
+				VkPipelineStageFlags2KHR dstStage,
+				VkAccessFlags2KHR srcAccess,
+				VkAccessFlags2KHR dstAccess,
+				VkImageAspectFlags aspectMask,
+				uint32_t srcFamily = VK_QUEUE_FAMILY_IGNORED,
+				uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED);
 	};
 }
\ No newline at end of file
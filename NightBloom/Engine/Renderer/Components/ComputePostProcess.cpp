@@ -0,0 +1,261 @@
+//------------------------------------------------------------------------------
+// ComputePostProcess.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/ComputePostProcess.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <array>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t POST_LOCAL_SIZE = 16;  // PostProcess.comp
+		// sRGB-encoded by the shader: storage images can't be sRGB
+		constexpr VkFormat OUTPUT_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+		constexpr uint32_t MAX_PUSH_SIZE = 32;
+	}
+
+	bool ComputePostProcess::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager, VkExtent2D outputExtent)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_DescriptorManager = descriptorManager;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		m_PointSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_PointSampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ComputePostProcess: failed to create sampler");
+			return false;
+		}
+
+		m_StorageSet = m_DescriptorManager->AllocateComputeImageSet();
+		m_OutputSet = m_DescriptorManager->AllocatePostProcessInputSet();
+		if (m_StorageSet == VK_NULL_HANDLE || m_OutputSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ComputePostProcess: failed to allocate descriptor sets");
+			return false;
+		}
+
+		if (!CreatePipeline())
+			return false;
+
+		if (!CreateOutput(outputExtent))
+			return false;
+
+		LOG_INFO("ComputePostProcess initialized ({}x{})", m_OutputExtent.width, m_OutputExtent.height);
+		return true;
+	}
+
+	void ComputePostProcess::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		DestroyOutput();
+
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		m_PointSampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_Device = nullptr;
+	}
+
+	bool ComputePostProcess::Resize(VkExtent2D outputExtent)
+	{
+		DestroyOutput();
+		return CreateOutput(outputExtent);
+	}
+
+	bool ComputePostProcess::CreateOutput(VkExtent2D outputExtent)
+	{
+		if (outputExtent.width == 0 || outputExtent.height == 0)
+			return false;
+
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = outputExtent.width;
+		imageInfo.height = outputExtent.height;
+		imageInfo.format = OUTPUT_FORMAT;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.category = GpuMemoryCategory::RenderTarget;
+		imageInfo.debugName = "PostProcessOutput";
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("ComputePostProcess: failed to create {}x{} output", outputExtent.width, outputExtent.height);
+			return false;
+		}
+		m_OutputAllocation = allocation;
+		m_OutputImage = allocation->image;
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_OutputImage;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = OUTPUT_FORMAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(m_Device->GetDevice(), &viewInfo, nullptr, &m_OutputView) != VK_SUCCESS)
+		{
+			LOG_ERROR("ComputePostProcess: failed to create output view");
+			return false;
+		}
+
+		m_DescriptorManager->UpdateComputeImageSet(m_StorageSet, m_OutputView);
+		m_DescriptorManager->UpdatePostProcessInputSet(m_OutputSet, m_OutputView, m_PointSampler);
+
+		m_OutputExtent = outputExtent;
+		return true;
+	}
+
+	void ComputePostProcess::DestroyOutput()
+	{
+		if (!m_Device)
+			return;
+
+		if (m_OutputView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(m_Device->GetDevice(), m_OutputView, nullptr);
+			m_OutputView = VK_NULL_HANDLE;
+		}
+		if (m_OutputAllocation)
+		{
+			m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_OutputAllocation));
+			m_OutputAllocation = nullptr;
+		}
+		m_OutputImage = VK_NULL_HANDLE;
+		m_OutputExtent = { 0, 0 };
+	}
+
+	bool ComputePostProcess::CreatePipeline()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = MAX_PUSH_SIZE;
+
+		// Sets 0/1 are the fragment path's inputs, set 2 the output
+		std::array<VkDescriptorSetLayout, 3> setLayouts = {
+			m_DescriptorManager->GetPostProcessInputSetLayout(),
+			m_DescriptorManager->GetPostProcessInputSetLayout(),
+			m_DescriptorManager->GetComputeImageSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		layoutInfo.pSetLayouts = setLayouts.data();
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("ComputePostProcess: failed to create pipeline layout");
+			return false;
+		}
+
+		const char* shaderName = "PostProcess.comp.spv";
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("ComputePostProcess: failed to load {}", shaderName);
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("ComputePostProcess: failed to create shader module for {}", shaderName);
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("ComputePostProcess: failed to create compute pipeline for {}", shaderName);
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, shaderName);
+		return true;
+	}
+
+	void ComputePostProcess::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet sceneSet,
+		VkDescriptorSet bloomSet, const void* push, uint32_t pushSize)
+	{
+		if (!dispatcher || m_Pipeline == VK_NULL_HANDLE || m_OutputExtent.width == 0 || pushSize > MAX_PUSH_SIZE)
+			return;
+
+		// Last frame's copy pass read the output; its contents don't matter
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_OutputImage;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSets(cmd, m_PipelineLayout, 0, { sceneSet, bloomSet, m_StorageSet });
+		dispatcher->PushConstants(cmd, m_PipelineLayout, push, pushSize);
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(m_OutputExtent.width, POST_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(m_OutputExtent.height, POST_LOCAL_SIZE));
+
+		// Output -> the copy pass's fragment shader
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+}
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+// ComputePostProcess.hpp
+//
+// The post-process composite (FXAA, bloom composite, exposure, ACES,
+// vignette) as a single compute dispatch (PostProcess.comp) instead of the
+// full-screen PostProcess.frag draw. Each workgroup reads its scene color
+// and bloom texels into shared memory once and does every step from there,
+// then writes an 8-bit display-resolution storage image; the post-process
+// render pass only copies that into the swapchain (PostProcessCopy.frag)
+// and draws the UI over it.
+//
+// Binds the same input sets as the fragment path (the post-process input
+// layout is compute-visible), so temporal upscaling and bloom feed it
+// unchanged. Optional: Renderer::PostProcessSettings::computePost picks
+// the path per frame.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+
+	class ComputePostProcess
+	{
+	public:
+		ComputePostProcess() = default;
+		~ComputePostProcess() = default;
+
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager, VkExtent2D outputExtent);
+		void Cleanup();
+
+		// Swapchain resize. Caller has waited for the frames using the old output.
+		bool Resize(VkExtent2D outputExtent);
+
+		// sceneSet/bloomSet: post-process input sets (the same ones the
+		// fragment path binds at sets 0 and 1); push: the post-process push
+		// constants. Leaves the output readable by fragment shaders.
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet sceneSet,
+			VkDescriptorSet bloomSet, const void* push, uint32_t pushSize);
+
+		// Post-process input set over the output, for PostProcessCopy.frag
+		VkDescriptorSet GetOutputSet() const { return m_OutputSet; }
+
+	private:
+		bool CreateOutput(VkExtent2D outputExtent);
+		void DestroyOutput();
+		bool CreatePipeline();
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		VkImage m_OutputImage = VK_NULL_HANDLE;
+		void* m_OutputAllocation = nullptr;   // VulkanMemoryManager::ImageAllocation*
+		VkImageView m_OutputView = VK_NULL_HANDLE;
+		VkExtent2D m_OutputExtent = { 0, 0 };
+		VkSampler m_PointSampler = VK_NULL_HANDLE;
+
+		VkDescriptorSet m_StorageSet = VK_NULL_HANDLE;   // set 2: output as a storage image
+		VkDescriptorSet m_OutputSet = VK_NULL_HANDLE;    // output as a sampler (copy pass)
+
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+	};
+}
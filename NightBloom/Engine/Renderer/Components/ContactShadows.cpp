@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+// ContactShadows.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/ContactShadows.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <array>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t CONTACT_SHADOW_LOCAL_SIZE = 8;  // contact_shadow.glsl
+	}
+
+	bool ContactShadows::Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager,
+		VkImageView colorView, VkImageView depthView, VkSampleCountFlagBits depthSamples)
+	{
+		m_Device = device;
+		m_DescriptorManager = descriptorManager;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		m_PointSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_PointSampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ContactShadows: failed to create point sampler");
+			return false;
+		}
+
+		m_ColorSet = m_DescriptorManager->AllocateComputeImageSet();
+		m_DepthSet = m_DescriptorManager->AllocateCloudResultSet();
+		if (m_ColorSet == VK_NULL_HANDLE || m_DepthSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ContactShadows: failed to allocate descriptor sets");
+			return false;
+		}
+
+		if (!CreatePipeline(depthSamples))
+			return false;
+
+		Resize(colorView, depthView);
+		LOG_INFO("ContactShadows initialized ({}x depth)", static_cast<uint32_t>(depthSamples));
+		return true;
+	}
+
+	void ContactShadows::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		m_PointSampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_ColorSet = m_DepthSet = VK_NULL_HANDLE;
+		m_Device = nullptr;
+	}
+
+	void ContactShadows::Resize(VkImageView colorView, VkImageView depthView)
+	{
+		if (colorView == VK_NULL_HANDLE || depthView == VK_NULL_HANDLE)
+			return;
+
+		m_DescriptorManager->UpdateComputeImageSet(m_ColorSet, colorView);
+		m_DescriptorManager->UpdateCloudResultSet(m_DepthSet, depthView, m_PointSampler,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+	}
+
+	bool ContactShadows::CreatePipeline(VkSampleCountFlagBits depthSamples)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(ContactShadowData);
+
+		const std::array<VkDescriptorSetLayout, 3> setLayouts = {
+			m_DescriptorManager->GetUniformSetLayout(),
+			m_DescriptorManager->GetComputeImageSetLayout(),
+			m_DescriptorManager->GetCloudResultSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		layoutInfo.pSetLayouts = setLayouts.data();
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("ContactShadows: failed to create pipeline layout");
+			return false;
+		}
+
+		const char* shaderName = (depthSamples != VK_SAMPLE_COUNT_1_BIT)
+			? "ContactShadowMS.comp.spv" : "ContactShadow.comp.spv";
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("ContactShadows: failed to load {}", shaderName);
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("ContactShadows: failed to create shader module for {}", shaderName);
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("ContactShadows: failed to create compute pipeline for {}", shaderName);
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, shaderName);
+		return true;
+	}
+
+	void ContactShadows::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet uniformSet,
+		const ContactShadowData& data)
+	{
+		if (!dispatcher || m_Pipeline == VK_NULL_HANDLE || data.extents.x <= 0 || data.extents.y <= 0)
+			return;
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSets(cmd, m_PipelineLayout, 0, { uniformSet, m_ColorSet, m_DepthSet });
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &data, sizeof(data));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(data.extents.x), CONTACT_SHADOW_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(data.extents.y), CONTACT_SHADOW_LOCAL_SIZE));
+	}
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// ContactShadows.hpp
+//
+// Screen-space contact shadows (ContactShadow.comp, see ContactShadow.hpp)
+// on the GPU: one compute pass after the scene and transparency passes that
+// reads the (resolved) scene depth and darkens the scene color in place, as
+// a storage image. Needs RenderPassManager's scene color created with
+// storage usage (IsSceneColorStorage), which in turn needs the device to
+// support storage on its format.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/ContactShadow.hpp"
+#include <vulkan/vulkan.h>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+
+	class ContactShadows
+	{
+	public:
+		ContactShadows() = default;
+		~ContactShadows() = default;
+
+		// colorView/depthView are RenderPassManager's scene color and the
+		// depth the scene pass resolved to (depthSamples its sample count)
+		bool Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager, VkImageView colorView,
+			VkImageView depthView, VkSampleCountFlagBits depthSamples);
+		void Cleanup();
+
+		// Swapchain resize: the scene targets were recreated
+		void Resize(VkImageView colorView, VkImageView depthView);
+
+		// After the transparency pass, with the scene color in GENERAL and
+		// the depth readable by compute. uniformSet is this frame's camera set.
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet uniformSet,
+			const ContactShadowData& data);
+
+	private:
+		bool CreatePipeline(VkSampleCountFlagBits depthSamples);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		VkSampler m_PointSampler = VK_NULL_HANDLE;
+		VkDescriptorSet m_ColorSet = VK_NULL_HANDLE;   // storage image
+		VkDescriptorSet m_DepthSet = VK_NULL_HANDLE;   // sampled
+
+		// set 0 = FrameUBO, set 1 = scene color, set 2 = scene depth
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+
+		ContactShadows(const ContactShadows&) = delete;
+		ContactShadows& operator=(const ContactShadows&) = delete;
+	};
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// DynamicResolution.hpp
+//
+// Picks the scene render scale from the measured GPU frame time. GPU cost is
+// taken as proportional to pixel count (scale^2), so the scale that would
+// hit the budget is scale * sqrt(budget / smoothedMs); the controller moves
+// toward it with a dead band (no churn around the target) and per-frame step
+// limits - quick to drop when over budget, slow to climb back. The smoothed
+// time is rescaled with every change so the lag of the GPU timings (a frame
+// in flight or more) doesn't read as the old resolution's cost.
+//
+// The renderer keeps its targets at full size and draws the scene into the
+// top-left scale x extent rect; post-process upscales it (see
+// Renderer::SetDynamicResolution).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	struct DynamicResolutionSettings
+	{
+		bool enabled = false;
+		float targetFrameMs = 16.6f;  // GPU budget per frame
+		float minScale = 0.5f;        // per axis
+		float maxScale = 1.0f;
+		float headroom = 0.9f;        // aim below the budget so spikes don't miss it
+	};
+
+	class DynamicResolutionController
+	{
+	public:
+		// Relative scale changes smaller than this are ignored
+		static constexpr float DEAD_BAND = 0.03f;
+		static constexpr float MAX_STEP_DOWN = 0.1f;
+		static constexpr float MAX_STEP_UP = 0.02f;
+		static constexpr float GPU_TIME_SMOOTHING = 0.2f;
+
+		void SetSettings(const DynamicResolutionSettings& settings)
+		{
+			m_Settings = settings;
+			m_Settings.minScale = std::clamp(m_Settings.minScale, 0.1f, 1.0f);
+			m_Settings.maxScale = std::clamp(m_Settings.maxScale, m_Settings.minScale, 1.0f);
+			m_Scale = std::clamp(m_Scale, m_Settings.minScale, m_Settings.maxScale);
+		}
+		const DynamicResolutionSettings& GetSettings() const { return m_Settings; }
+
+		// Forget the timing history (resize, settings change)
+		void Reset() { m_SmoothedMs = 0.0f; }
+
+		// Call once per frame with the latest GPU frame time (0 = no
+		// measurement yet). Returns the scale for the frame about to be drawn.
+		float Update(float gpuFrameMs)
+		{
+			if (!m_Settings.enabled)
+			{
+				m_Scale = m_Settings.maxScale;
+				m_SmoothedMs = 0.0f;
+				return m_Scale;
+			}
+			if (gpuFrameMs <= 0.0f || m_Settings.targetFrameMs <= 0.0f)
+				return m_Scale;
+
+			m_SmoothedMs = (m_SmoothedMs > 0.0f)
+				? m_SmoothedMs + (gpuFrameMs - m_SmoothedMs) * GPU_TIME_SMOOTHING
+				: gpuFrameMs;
+
+			const float budget = m_Settings.targetFrameMs * std::clamp(m_Settings.headroom, 0.5f, 1.0f);
+			float ideal = m_Scale * std::sqrt(budget / m_SmoothedMs);
+			ideal = std::clamp(ideal, m_Settings.minScale, m_Settings.maxScale);
+
+			// The bounds themselves are always reachable
+			const bool atBound = ideal == m_Settings.minScale || ideal == m_Settings.maxScale;
+			if (ideal == m_Scale || (!atBound && std::abs(ideal - m_Scale) < m_Scale * DEAD_BAND))
+				return m_Scale;
+
+			const float next = std::clamp(ideal, m_Scale - MAX_STEP_DOWN, m_Scale + MAX_STEP_UP);
+			m_SmoothedMs *= (next * next) / (m_Scale * m_Scale);
+			m_Scale = next;
+			return m_Scale;
+		}
+
+		float GetScale() const { return m_Scale; }
+		float GetSmoothedGpuMs() const { return m_SmoothedMs; }
+
+	private:
+		DynamicResolutionSettings m_Settings;
+		float m_Scale = 1.0f;
+		float m_SmoothedMs = 0.0f;
+	};
+}
@@ -0,0 +1,361 @@
+//------------------------------------------------------------------------------
+// EnvironmentProbeCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/EnvironmentProbeCache.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <vector>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t PROBE_LOCAL_SIZE = 8;  // both shaders, 8x8 per face
+		constexpr VkFormat PROBE_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+		constexpr float FILTER_SAMPLE_COUNT = 64.0f;
+
+		// Matches FilterParams in EnvironmentFilter.comp
+		struct FilterPushConstants
+		{
+			glm::vec4 params;   // x = GGX alpha of the step, y = sample count
+		};
+
+		constexpr VkPipelineStageFlags2KHR PROBE_READERS =
+			VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+	}
+
+	bool EnvironmentProbeCache::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_DescriptorManager = descriptorManager;
+
+		// The filter reads one mip at a time; the consumers blend between them
+		m_SourceSampler = m_Device->GetSamplerCache()->GetSampler(VulkanSamplerCache::LinearClamp());
+		VkSamplerCreateInfo samplerInfo = VulkanSamplerCache::LinearClamp();
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		samplerInfo.maxLod = static_cast<float>(EnvironmentProbe::MIP_COUNT - 1);
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_Sampler == VK_NULL_HANDLE || m_SourceSampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create samplers");
+			return false;
+		}
+
+		if (!CreateImage())
+			return false;
+
+		for (uint32_t mip = 0; mip < EnvironmentProbe::MIP_COUNT; ++mip)
+		{
+			m_FaceSets[mip] = m_DescriptorManager->AllocateComputeImageSet();
+			m_SourceSets[mip] = m_DescriptorManager->AllocateCloudResultSet();
+			if (m_FaceSets[mip] == VK_NULL_HANDLE || m_SourceSets[mip] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("EnvironmentProbeCache: failed to allocate descriptor sets");
+				return false;
+			}
+			m_DescriptorManager->UpdateComputeImageSet(m_FaceSets[mip], m_FaceViews[mip]);
+			m_DescriptorManager->UpdateCloudResultSet(m_SourceSets[mip], m_SourceViews[mip], m_SourceSampler,
+				VK_IMAGE_LAYOUT_GENERAL);
+		}
+
+		// Without the pipelines the cube stays black; it is bound either way
+		if (!CreatePipelines())
+			LOG_WARN("EnvironmentProbeCache: no capture pipelines, reflections of the environment stay black");
+
+		m_DescriptorManager->UpdateEnvironmentProbeBinding(m_CubeView, m_Sampler);
+
+		LOG_INFO("EnvironmentProbeCache initialized ({}^2 x 6, {} mips)", EnvironmentProbe::SIZE,
+			EnvironmentProbe::MIP_COUNT);
+		return true;
+	}
+
+	void EnvironmentProbeCache::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		for (VkPipeline pipeline : { m_CapturePipeline, m_FilterPipeline })
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+		}
+		m_CapturePipeline = m_FilterPipeline = VK_NULL_HANDLE;
+		for (VkPipelineLayout layout : { m_CaptureLayout, m_FilterLayout })
+		{
+			if (layout != VK_NULL_HANDLE)
+				vkDestroyPipelineLayout(device, layout, nullptr);
+		}
+		m_CaptureLayout = m_FilterLayout = VK_NULL_HANDLE;
+
+		for (uint32_t mip = 0; mip < EnvironmentProbe::MIP_COUNT; ++mip)
+		{
+			if (m_FaceViews[mip] != VK_NULL_HANDLE)
+				vkDestroyImageView(device, m_FaceViews[mip], nullptr);
+			if (m_SourceViews[mip] != VK_NULL_HANDLE)
+				vkDestroyImageView(device, m_SourceViews[mip], nullptr);
+		}
+		m_FaceViews.fill(VK_NULL_HANDLE);
+		m_SourceViews.fill(VK_NULL_HANDLE);
+		if (m_CubeView != VK_NULL_HANDLE)
+			vkDestroyImageView(device, m_CubeView, nullptr);
+		m_CubeView = VK_NULL_HANDLE;
+		if (m_Allocation)
+			m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_Allocation));
+		m_Allocation = nullptr;
+		m_Image = VK_NULL_HANDLE;
+		m_Sampler = m_SourceSampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_Initialized = false;
+		m_Schedule.Invalidate();
+		m_Device = nullptr;
+	}
+
+	bool EnvironmentProbeCache::CreateImage()
+	{
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = EnvironmentProbe::SIZE;
+		imageInfo.height = EnvironmentProbe::SIZE;
+		imageInfo.mipLevels = EnvironmentProbe::MIP_COUNT;
+		imageInfo.arrayLayers = EnvironmentProbe::FACE_COUNT;
+		imageInfo.cubeCompatible = true;
+		imageInfo.format = PROBE_FORMAT;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageInfo.category = GpuMemoryCategory::Effects;
+		imageInfo.debugName = "EnvironmentProbe";
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create the cube");
+			return false;
+		}
+		m_Allocation = allocation;
+		m_Image = allocation->image;
+
+		auto createView = [this](VkImageViewType type, uint32_t baseMip, uint32_t mipCount, VkImageView& view)
+		{
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = m_Image;
+			viewInfo.viewType = type;
+			viewInfo.format = PROBE_FORMAT;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewInfo.subresourceRange.baseMipLevel = baseMip;
+			viewInfo.subresourceRange.levelCount = mipCount;
+			viewInfo.subresourceRange.layerCount = EnvironmentProbe::FACE_COUNT;
+			return vkCreateImageView(m_Device->GetDevice(), &viewInfo, nullptr, &view) == VK_SUCCESS;
+		};
+
+		if (!createView(VK_IMAGE_VIEW_TYPE_CUBE, 0, EnvironmentProbe::MIP_COUNT, m_CubeView))
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create the cube view");
+			return false;
+		}
+		for (uint32_t mip = 0; mip < EnvironmentProbe::MIP_COUNT; ++mip)
+		{
+			if (!createView(VK_IMAGE_VIEW_TYPE_2D_ARRAY, mip, 1, m_FaceViews[mip]) ||
+				!createView(VK_IMAGE_VIEW_TYPE_CUBE, mip, 1, m_SourceViews[mip]))
+			{
+				LOG_ERROR("EnvironmentProbeCache: failed to create the mip {} views", mip);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool EnvironmentProbeCache::CreatePipelines()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		range.size = sizeof(EnvironmentCaptureData);
+		std::array<VkDescriptorSetLayout, 2> captureSets = {
+			m_DescriptorManager->GetUniformSetLayout(),
+			m_DescriptorManager->GetComputeImageSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(captureSets.size());
+		layoutInfo.pSetLayouts = captureSets.data();
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_CaptureLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create the capture pipeline layout");
+			return false;
+		}
+
+		range.size = sizeof(FilterPushConstants);
+		std::array<VkDescriptorSetLayout, 2> filterSets = {
+			m_DescriptorManager->GetCloudResultSetLayout(),
+			m_DescriptorManager->GetComputeImageSetLayout()
+		};
+		layoutInfo.pSetLayouts = filterSets.data();
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_FilterLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create the filter pipeline layout");
+			return false;
+		}
+
+		m_CapturePipeline = CreatePipeline("EnvironmentCapture.comp.spv", m_CaptureLayout);
+		m_FilterPipeline = m_CapturePipeline != VK_NULL_HANDLE
+			? CreatePipeline("EnvironmentFilter.comp.spv", m_FilterLayout)
+			: VK_NULL_HANDLE;
+
+		// Both or neither, so CanCapture can look at the filter alone
+		if (m_FilterPipeline == VK_NULL_HANDLE && m_CapturePipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_CapturePipeline, nullptr);
+			m_CapturePipeline = VK_NULL_HANDLE;
+		}
+		return m_FilterPipeline != VK_NULL_HANDLE;
+	}
+
+	VkPipeline EnvironmentProbeCache::CreatePipeline(const char* shaderName, VkPipelineLayout layout)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to load {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create shader module for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = layout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("EnvironmentProbeCache: failed to create compute pipeline for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, shaderName);
+		return pipeline;
+	}
+
+	void EnvironmentProbeCache::Prepare(const EnvironmentProbeSettings& settings, const EnvironmentProbeInputs& inputs,
+		const EnvironmentCaptureData& capture)
+	{
+		m_Inputs = inputs;
+		m_Capture = capture;
+		m_Capture.ground = glm::vec4(settings.groundColor, 0.0f);
+		m_CaptureDue = CanCapture() && m_Schedule.IsDue(settings, inputs);
+	}
+
+	void EnvironmentProbeCache::Clear(VkCommandBuffer cmd)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = m_Initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_Image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = EnvironmentProbe::MIP_COUNT;
+		barrier.subresourceRange.layerCount = EnvironmentProbe::FACE_COUNT;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkClearColorValue black{};
+		vkCmdClearColorImage(cmd, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &black, 1, &barrier.subresourceRange);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		m_Initialized = true;
+	}
+
+	void EnvironmentProbeCache::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet uniformSet)
+	{
+		if (m_Image == VK_NULL_HANDLE)
+			return;
+
+		const bool capture = m_CaptureDue && dispatcher && uniformSet != VK_NULL_HANDLE;
+		m_Schedule.Advance(capture, m_Inputs);
+		m_CaptureDue = false;
+		if (!capture)
+		{
+			// Black until the first capture; never cleared again after it
+			if (!m_Initialized)
+				Clear(cmd);
+			return;
+		}
+
+		dispatcher->QueueImageBarrier(cmd, m_Image,
+			m_Initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_IMAGE_LAYOUT_GENERAL,
+			PROBE_READERS, 0,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+
+		const uint32_t groups = ComputeDispatcher::CalculateGroupCount(EnvironmentProbe::SIZE, PROBE_LOCAL_SIZE);
+		dispatcher->BindPipeline(cmd, m_CapturePipeline);
+		dispatcher->BindDescriptorSets(cmd, m_CaptureLayout, 0, { uniformSet, m_FaceSets[0] });
+		dispatcher->PushConstants(cmd, m_CaptureLayout, &m_Capture, sizeof(m_Capture));
+		dispatcher->Dispatch(cmd, groups, groups, EnvironmentProbe::FACE_COUNT);
+
+		// Each mip from the one above it, once that one is written
+		dispatcher->BindPipeline(cmd, m_FilterPipeline);
+		for (uint32_t mip = 1; mip < EnvironmentProbe::MIP_COUNT; ++mip)
+		{
+			dispatcher->QueueMemoryBarrier(cmd,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+
+			FilterPushConstants push{};
+			push.params = glm::vec4(EnvironmentProbe::FilterAlpha(mip), FILTER_SAMPLE_COUNT, 0.0f, 0.0f);
+			const uint32_t mipGroups = ComputeDispatcher::CalculateGroupCount(EnvironmentProbe::MipSize(mip),
+				PROBE_LOCAL_SIZE);
+			dispatcher->BindDescriptorSets(cmd, m_FilterLayout, 0, { m_SourceSets[mip - 1], m_FaceSets[mip] });
+			dispatcher->PushConstants(cmd, m_FilterLayout, &push, sizeof(push));
+			dispatcher->Dispatch(cmd, mipGroups, mipGroups, EnvironmentProbe::FACE_COUNT);
+		}
+
+		dispatcher->QueueImageBarrier(cmd, m_Image,
+			VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+			PROBE_READERS, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+		dispatcher->FlushBarriers(cmd);
+		m_Initialized = true;
+	}
+}
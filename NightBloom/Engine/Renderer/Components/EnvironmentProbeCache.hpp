@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+// EnvironmentProbeCache.hpp
+//
+// The environment probe (EnvironmentProbe.hpp) on the GPU: an rgba16f cube,
+// EnvironmentProbe::SIZE across with MIP_COUNT roughness mips, bound at set 0
+// binding 7 of every scene-pass uniform set (environment_probe.glsl). A
+// capture is two compute passes:
+//   EnvironmentCapture.comp -> mip 0: sky, the light's disc, clouds, far ground
+//   EnvironmentFilter.comp  -> mips 1.., each GGX-blurred from the one above
+// and only runs on the frames EnvironmentProbeSchedule picks; between them
+// the cube is reused as is.
+//
+// Without compute the cube is cleared to black once, so the consumers still
+// have something bound.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/EnvironmentProbe.hpp"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+
+	class EnvironmentProbeCache
+	{
+	public:
+		EnvironmentProbeCache() = default;
+		~EnvironmentProbeCache() = default;
+
+		// Also writes the cube into every uniform-layout set (binding 7)
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager);
+		void Cleanup();
+
+		// While filling the frame's uniforms: decides whether Record captures
+		void Prepare(const EnvironmentProbeSettings& settings, const EnvironmentProbeInputs& inputs,
+			const EnvironmentCaptureData& capture);
+
+		// Outside any render pass, once the cloud shadow map is readable.
+		// uniformSet is this frame's camera set (the probe sits at its
+		// camera). Leaves the cube sampler-ready for fragment and compute
+		// shaders.
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VkDescriptorSet uniformSet);
+
+		// Recapture on the next frame (scene or camera cut)
+		void Invalidate() { m_Schedule.Invalidate(); }
+
+		bool CanCapture() const { return m_FilterPipeline != VK_NULL_HANDLE; }
+		bool IsCaptureDue() const { return m_CaptureDue; }
+		uint32_t GetAge() const { return m_Schedule.GetAge(); }
+
+		VkImage GetImage() const { return m_Image; }
+
+	private:
+		bool CreateImage();
+		bool CreatePipelines();
+		VkPipeline CreatePipeline(const char* shaderName, VkPipelineLayout layout);
+		void Clear(VkCommandBuffer cmd);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		VkImage m_Image = VK_NULL_HANDLE;
+		void* m_Allocation = nullptr;   // VulkanMemoryManager::ImageAllocation*
+		VkImageView m_CubeView = VK_NULL_HANDLE;   // every mip, for the consumers
+		std::array<VkImageView, EnvironmentProbe::MIP_COUNT> m_FaceViews{};    // 2D array per mip, written
+		std::array<VkImageView, EnvironmentProbe::MIP_COUNT> m_SourceViews{};  // cube per mip, read by the next
+		bool m_Initialized = false;     // out of UNDEFINED
+		VkSampler m_Sampler = VK_NULL_HANDLE;        // trilinear, for the consumers
+		VkSampler m_SourceSampler = VK_NULL_HANDLE;  // bilinear, one mip
+
+		std::array<VkDescriptorSet, EnvironmentProbe::MIP_COUNT> m_FaceSets{};
+		std::array<VkDescriptorSet, EnvironmentProbe::MIP_COUNT> m_SourceSets{};
+
+		// Capture: set 0 = the frame uniform set, set 1 = mip 0.
+		// Filter: set 0 = the mip above, set 1 = the mip written.
+		VkPipelineLayout m_CaptureLayout = VK_NULL_HANDLE;
+		VkPipelineLayout m_FilterLayout = VK_NULL_HANDLE;
+		VkPipeline m_CapturePipeline = VK_NULL_HANDLE;
+		VkPipeline m_FilterPipeline = VK_NULL_HANDLE;
+
+		EnvironmentProbeSchedule m_Schedule;
+		EnvironmentProbeInputs m_Inputs;
+		EnvironmentCaptureData m_Capture;
+		bool m_CaptureDue = false;
+
+		EnvironmentProbeCache(const EnvironmentProbeCache&) = delete;
+		EnvironmentProbeCache& operator=(const EnvironmentProbeCache&) = delete;
+	};
+}
@@ -6,30 +6,62 @@
 
 #include "Engine/Renderer/Components/FrameSyncManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanSwapchain.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/PerformanceMetrics.hpp"
+#include <algorithm>
+#include <thread>
 
 namespace Nightbloom
 {
-	bool FrameSyncManager::Initialize(VkDevice device, uint32_t swapchainImageCount)
+	namespace
 	{
+		// A stuck compositor mustn't hang the frame loop
+		constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100'000'000;
+
+		// Kept between the predicted end of the frame and the refresh: a
+		// late frame costs a whole refresh period, an early one a millisecond
+		constexpr float LOW_LATENCY_MARGIN_MS = 1.5f;
+
+		float ToMs(std::chrono::steady_clock::duration duration)
+		{
+			return std::chrono::duration<float, std::milli>(duration).count();
+		}
+	}
+
+	bool FrameSyncManager::Initialize(VkDevice device, VulkanQueueTimeline* graphicsTimeline,
+		uint32_t swapchainImageCount, uint32_t framesInFlight)
+	{
+		if (!graphicsTimeline)
+		{
+			LOG_ERROR("Frame synchronization needs the graphics queue timeline");
+			return false;
+		}
+
+		m_Device = device;
+		m_Timeline = graphicsTimeline;
+		m_FramesInFlight = std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+		m_CurrentFrame = 0;
+		m_FrameValues.fill(0);
+
+		// Pacing history restarts with the new sync objects
+		m_FrameStart = {};
+		m_LastReference = {};
+		m_ReferenceCount = 0;
+		m_PendingPresentId = 0;
+
 		// Resize vectors to match requirements
-		m_ImageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		m_RenderFinishedSemaphores.resize(swapchainImageCount);
-		m_InFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-		m_ImagesInFlight.resize(swapchainImageCount, VK_NULL_HANDLE);
+		m_ImageAvailableSemaphores.resize(m_FramesInFlight, VK_NULL_HANDLE);
+		m_RenderFinishedSemaphores.resize(swapchainImageCount, VK_NULL_HANDLE);
+		m_ImageValues.assign(swapchainImageCount, 0);
 
 		VkSemaphoreCreateInfo semaphoreInfo{};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-		VkFenceCreateInfo fenceInfo{};
-		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;  // Start in signaled state
-
 		// Create synchronization objects for each frame in flight
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		for (size_t i = 0; i < m_FramesInFlight; i++)
 		{
-			if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_ImageAvailableSemaphores[i]) != VK_SUCCESS ||
-				vkCreateFence(device, &fenceInfo, nullptr, &m_InFlightFences[i]) != VK_SUCCESS)
+			if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_ImageAvailableSemaphores[i]) != VK_SUCCESS)
 			{
 				LOG_ERROR("Failed to create synchronization objects for frame {}", i);
 				Cleanup(device);  // Clean up any already created objects
@@ -48,8 +80,9 @@ namespace Nightbloom
 			}
 		}
 
-		LOG_INFO("Frame synchronization initialized ({} frames in flight, {} swapchain images)",
-			MAX_FRAMES_IN_FLIGHT, swapchainImageCount);
+		LOG_INFO("Frame synchronization initialized ({} frames in flight, {} swapchain images, {})",
+			m_FramesInFlight, swapchainImageCount,
+			m_Timeline->UsesTimelineSemaphore() ? "timeline semaphore" : "fence fallback");
 
 		return true;
 	}
@@ -75,46 +108,50 @@ namespace Nightbloom
 			}
 		}
 
-		// Destroy fences
-		for (auto& fence : m_InFlightFences)
-		{
-			if (fence != VK_NULL_HANDLE)
-			{
-				vkDestroyFence(device, fence, nullptr);
-				fence = VK_NULL_HANDLE;
-			}
-		}
-
 		// Clear vectors
 		m_ImageAvailableSemaphores.clear();
 		m_RenderFinishedSemaphores.clear();
-		m_InFlightFences.clear();
-		m_ImagesInFlight.clear();
+		m_ImageValues.clear();
+		m_FrameValues.fill(0);
 
 		LOG_INFO("Frame synchronization cleaned up");
 	}
 
-	bool FrameSyncManager::WaitForFrame(VkDevice device)
+	bool FrameSyncManager::SetSwapchainImageCount(uint32_t swapchainImageCount)
 	{
-		// Wait for the fence from MAX_FRAMES_IN_FLIGHT submissions ago
-		VkResult result = vkWaitForFences(
-			device,
-			1,
-			&m_InFlightFences[m_CurrentFrame],
-			VK_TRUE,     // Wait for all fences
-			UINT64_MAX   // No timeout
-		);
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-		if (result != VK_SUCCESS)
+		for (size_t i = m_RenderFinishedSemaphores.size(); i < swapchainImageCount; i++)
 		{
-			LOG_ERROR("Failed to wait for in-flight fence: {}", static_cast<int>(result));
+			VkSemaphore semaphore = VK_NULL_HANDLE;
+			if (vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to create render finished semaphore for image {}", i);
+				return false;
+			}
+			m_RenderFinishedSemaphores.push_back(semaphore);
+		}
+
+		// Values of the old images only make the first waits conservative
+		if (m_ImageValues.size() < m_RenderFinishedSemaphores.size())
+			m_ImageValues.resize(m_RenderFinishedSemaphores.size(), 0);
+		return true;
+	}
+
+	bool FrameSyncManager::WaitForFrame()
+	{
+		// Wait for this slot's submission from m_FramesInFlight frames ago
+		if (!m_Timeline->Wait(m_FrameValues[m_CurrentFrame]))
+		{
+			LOG_ERROR("Failed to wait for frame slot {}", m_CurrentFrame);
 			return false;
 		}
 
 		return true;
 	}
 
-	bool FrameSyncManager::AcquireNextImage(VkDevice device, VulkanSwapchain* swapchain, uint32_t& imageIndex)
+	bool FrameSyncManager::AcquireNextImage(VulkanSwapchain* swapchain, uint32_t& imageIndex)
 	{
 		bool result = swapchain->AcquireNextImage(
 			imageIndex,
@@ -127,40 +164,25 @@ namespace Nightbloom
 			return false;
 		}
 
-		// Check if a previous frame is using this image
-		if (m_ImagesInFlight[imageIndex] != VK_NULL_HANDLE)
+		// A previous frame from another slot may still be rendering to this image
+		if (imageIndex < m_ImageValues.size())
 		{
-			// We need to pass device as parameter or get it another way
-			// For now, just comment this out - it's a safety check
-			// TODO: Pass VkDevice as parameter to this function
-			//VkDevice device = swapchain->GetDevice();
-			vkWaitForFences(device, 1, &m_ImagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+			m_Timeline->Wait(m_ImageValues[imageIndex]);
 		}
 
-		// Mark the image as now being in use by this frame
-		m_ImagesInFlight[imageIndex] = m_InFlightFences[m_CurrentFrame];
-
 		return true;
 	}
 
-	void FrameSyncManager::ResetFence(VkDevice device)
-	{
-		vkResetFences(device, 1, &m_InFlightFences[m_CurrentFrame]);
-	}
-
-	bool FrameSyncManager::SubmitCommandBuffer(VkDevice device, VkQueue graphicsQueue,
-		VkCommandBuffer commandBuffer, uint32_t imageIndex)
+	bool FrameSyncManager::SubmitCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+		VkSemaphore extraWait, VkPipelineStageFlags extraWaitStage)
 	{
-		// Reset the fence before submission
-		ResetFence(device);
-
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-		// Wait on image available semaphore
-		VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame] };
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		submitInfo.waitSemaphoreCount = 1;
+		// Wait on image available semaphore (and the extra one, if any)
+		VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame], extraWait };
+		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, extraWaitStage };
+		submitInfo.waitSemaphoreCount = (extraWait != VK_NULL_HANDLE) ? 2u : 1u;
 		submitInfo.pWaitSemaphores = waitSemaphores;
 		submitInfo.pWaitDstStageMask = waitStages;
 
@@ -173,20 +195,40 @@ namespace Nightbloom
 		submitInfo.signalSemaphoreCount = 1;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
-		// Submit with fence for CPU-GPU sync
-		VkResult result = vkQueueSubmit(
-			graphicsQueue,
-			1,
-			&submitInfo,
-			m_InFlightFences[m_CurrentFrame]
-		);
-
-		if (result != VK_SUCCESS)
+		// The timeline signals the next value for CPU-GPU sync
+		const uint64_t value = m_Timeline->Submit(submitInfo);
+		if (value == 0)
 		{
-			LOG_ERROR("Failed to submit draw command buffer: {}", static_cast<int>(result));
+			LOG_ERROR("Failed to submit draw command buffer");
 			return false;
 		}
 
+		m_FrameValues[m_CurrentFrame] = value;
+		m_ImageValues[imageIndex] = value;
+
+		// CPU cost of a frame for the low-latency schedule (only frames that
+		// started in LowLatencyWait have a start time)
+		if (m_FrameStart != Clock::time_point{})
+		{
+			const float cpuMs = ToMs(Clock::now() - m_FrameStart);
+			m_CpuFrameMs = (m_CpuFrameMs > 0.0f) ? m_CpuFrameMs + (cpuMs - m_CpuFrameMs) * 0.1f : cpuMs;
+			m_FrameStart = {};
+		}
+		return true;
+	}
+
+	bool FrameSyncManager::SubmitEarlyCommandBuffer(VkCommandBuffer commandBuffer)
+	{
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		if (m_Timeline->Submit(submitInfo) == 0)
+		{
+			LOG_ERROR("Failed to submit early command buffer");
+			return false;
+		}
 		return true;
 	}
 
@@ -197,9 +239,103 @@ namespace Nightbloom
 			m_RenderFinishedSemaphores[imageIndex]
 		);
 
+		// Input-to-present. In low-latency mode with present wait the next
+		// LowLatencyWait sees this image reach the display and records it;
+		// otherwise the latency ends when the present was queued.
+		if (m_FrameInputTime != Clock::time_point{})
+		{
+			const uint64_t presentId = swapchain->GetLastPresentId();
+			if (m_LowLatency && result && presentId != 0)
+			{
+				m_PendingPresentId = presentId;
+				m_PendingInputTime = m_FrameInputTime;
+			}
+			else
+			{
+				PerformanceMetrics::Get().RecordInputLatency(ToMs(Clock::now() - m_FrameInputTime), false);
+			}
+			m_FrameInputTime = {};
+		}
+
 		// Advance to next frame regardless of present result
 		NextFrame();
 
 		return result;
 	}
-}
\ No newline at end of file
+
+	void FrameSyncManager::LowLatencyWait(VulkanSwapchain* swapchain, float gpuFrameMs)
+	{
+		m_SleepMs = 0.0f;
+
+		// Block on the GPU here, before input is read, instead of in BeginFrame
+		WaitForFrame();
+
+		if (swapchain->SupportsPresentWait())
+		{
+			const uint64_t presentId = swapchain->GetLastPresentId();
+			if (presentId != 0 && swapchain->WaitForPresent(presentId, PRESENT_WAIT_TIMEOUT_NS))
+			{
+				const Clock::time_point displayed = Clock::now();
+				RecordPacingReference(displayed);
+
+				if (presentId == m_PendingPresentId)
+				{
+					PerformanceMetrics::Get().RecordInputLatency(ToMs(displayed - m_PendingInputTime), true);
+					m_PendingPresentId = 0;
+				}
+			}
+		}
+		else
+		{
+			// No present timing: on a FIFO swapchain the GPU wait that just
+			// returned settles into the refresh cadence, so it stands in
+			RecordPacingReference(Clock::now());
+		}
+
+		// Start as late as the next refresh allows. Only FIFO has a refresh
+		// to aim for; MAILBOX/IMMEDIATE just keep the waits above.
+		const float refreshMs = EstimateRefreshMs();
+		if (swapchain->IsDisplayPaced() && refreshMs > 0.0f)
+		{
+			const float sinceReferenceMs = ToMs(Clock::now() - m_LastReference);
+			const float sleepMs = refreshMs - sinceReferenceMs - m_CpuFrameMs - gpuFrameMs - LOW_LATENCY_MARGIN_MS;
+			if (sleepMs > 0.0f)
+			{
+				m_SleepMs = std::min(sleepMs, refreshMs);
+				const Clock::time_point wake = Clock::now() +
+					std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(m_SleepMs));
+
+				// OS sleeps overshoot by up to a scheduler tick: sleep short, spin the rest
+				if (m_SleepMs > 2.0f)
+					std::this_thread::sleep_for(std::chrono::duration<float, std::milli>(m_SleepMs - 2.0f));
+				while (Clock::now() < wake)
+					std::this_thread::yield();
+			}
+		}
+
+		PerformanceMetrics::Get().SetLowLatencySleep(m_SleepMs);
+		m_FrameStart = Clock::now();
+	}
+
+	void FrameSyncManager::RecordPacingReference(Clock::time_point time)
+	{
+		if (m_LastReference != Clock::time_point{})
+		{
+			m_ReferenceIntervals[m_ReferenceCount % PACING_HISTORY] = ToMs(time - m_LastReference);
+			m_ReferenceCount++;
+		}
+		m_LastReference = time;
+	}
+
+	float FrameSyncManager::EstimateRefreshMs() const
+	{
+		// Median interval: a missed refresh (2x) or a hitch doesn't move it
+		const size_t count = std::min(m_ReferenceCount, PACING_HISTORY);
+		if (count < PACING_HISTORY / 2)
+			return 0.0f;
+
+		std::array<float, PACING_HISTORY> sorted = m_ReferenceIntervals;
+		std::nth_element(sorted.begin(), sorted.begin() + count / 2, sorted.begin() + count);
+		return sorted[count / 2];
+	}
+}
@@ -1,61 +1,124 @@
 //------------------------------------------------------------------------------
 // FrameSyncManager.hpp
 //
-// Manages frame synchronization primitives (semaphores, fences)
+// Manages frame synchronization primitives (semaphores, timeline values)
 // Handles frame pacing and swapchain image acquisition
+//
+// GPU completion is tracked on the graphics queue's VulkanQueueTimeline:
+// each frame slot remembers the value its last submission signalled, and
+// waiting for a slot (or for a swapchain image still in use) is a wait on
+// that value. The binary semaphores remain only for the swapchain, which
+// can't take timeline semaphores.
+//
+// Low-latency mode (LowLatencyWait, called just before input is sampled)
+// moves the frame's blocking to before input: it waits for the slot's GPU
+// work and, with VK_KHR_present_wait, for the previous image to reach the
+// display, then on a FIFO swapchain sleeps so that the estimated CPU + GPU
+// work ends just before the next refresh. Input-to-present latency is
+// reported to PerformanceMetrics either way.
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Renderer/FrameConfig.hpp"
 #include <vulkan/vulkan.h>
+#include <array>
+#include <chrono>
 #include <vector>
 #include <cstdint>
 
 namespace Nightbloom
 {
 	class VulkanSwapchain;
+	class VulkanQueueTimeline;
 
 	class FrameSyncManager
 	{
 	public:
-		static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
 		FrameSyncManager() = default;
 		~FrameSyncManager() = default;
 
-		// Lifecycle
-		bool Initialize(VkDevice device, uint32_t swapchainImageCount);
+		// Lifecycle. framesInFlight is clamped to [1, MAX_FRAMES_IN_FLIGHT].
+		bool Initialize(VkDevice device, VulkanQueueTimeline* graphicsTimeline,
+			uint32_t swapchainImageCount, uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
 		void Cleanup(VkDevice device);
 
+		// A recreated swapchain may have more images; their render-finished
+		// semaphores are added (existing ones are kept, they may be pending)
+		bool SetSwapchainImageCount(uint32_t swapchainImageCount);
+
 		// Frame management
-		bool WaitForFrame(VkDevice device);
-		bool AcquireNextImage(VkDevice device, VulkanSwapchain* swapchain, uint32_t& imageIndex);
-		void ResetFence(VkDevice device);
+		bool WaitForFrame();
+		bool AcquireNextImage(VulkanSwapchain* swapchain, uint32_t& imageIndex);
 
 		// Submission and Presentation
-		bool SubmitCommandBuffer(VkDevice device, VkQueue graphicsQueue, VkCommandBuffer commandBuffer, uint32_t imageIndex);
+		// extraWait (optional, binary) is waited on at extraWaitStage as well
+		// as the swapchain image: the async compute queue's finished semaphore.
+		bool SubmitCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+			VkSemaphore extraWait = VK_NULL_HANDLE, VkPipelineStageFlags extraWaitStage = 0);
+		// Work at the head of the frame that needs neither the swapchain image
+		// nor the compute queue (see CommandRecorder::SplitCommandBuffer);
+		// submitted ahead of SubmitCommandBuffer, whose value covers it.
+		bool SubmitEarlyCommandBuffer(VkCommandBuffer commandBuffer);
 		bool PresentImage(VulkanSwapchain* swapchain, VkQueue presentQueue, uint32_t imageIndex);
-		void NextFrame() { m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT; }
+		void NextFrame() { m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight; }
 
 		// Getters
 		uint32_t GetCurrentFrame() const { return m_CurrentFrame; }
+		uint32_t GetFramesInFlight() const { return m_FramesInFlight; }
 		VkSemaphore GetImageAvailableSemaphore() const { return m_ImageAvailableSemaphores[m_CurrentFrame]; }
 		VkSemaphore GetRenderFinishedSemaphore(uint32_t imageIndex) const { return m_RenderFinishedSemaphores[imageIndex]; }
-		VkFence GetInFlightFence() const { return m_InFlightFences[m_CurrentFrame]; }
+
+		// Timeline value the current slot's previous submission signalled
+		uint64_t GetFrameValue() const { return m_FrameValues[m_CurrentFrame]; }
+
+		// Low latency. gpuFrameMs is the last measured GPU time of a frame
+		// (GpuProfiler); the sleep is skipped on non-FIFO present modes.
+		void SetLowLatencyMode(bool enabled) { m_LowLatency = enabled; }
+		bool IsLowLatencyMode() const { return m_LowLatency; }
+		void LowLatencyWait(VulkanSwapchain* swapchain, float gpuFrameMs);
+		float GetLowLatencySleepMs() const { return m_SleepMs; }
+
+		// Earliest input event consumed by the frame being recorded (a
+		// default time point = none); measured against its present
+		void SetFrameInputTime(std::chrono::steady_clock::time_point time) { m_FrameInputTime = time; }
 
 	private:
+		using Clock = std::chrono::steady_clock;
+
+		void RecordPacingReference(Clock::time_point time);
+		float EstimateRefreshMs() const;
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		VulkanQueueTimeline* m_Timeline = nullptr;
+		uint32_t m_FramesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
 		uint32_t m_CurrentFrame = 0;
 
 		// Synchronization objects (per frame in flight)
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores;
-		std::vector<VkFence> m_InFlightFences;
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_FrameValues{};
 
 		// Per Swapchain Image
 		std::vector<VkSemaphore> m_RenderFinishedSemaphores;
-		std::vector<VkFence> m_ImagesInFlight;
+		std::vector<uint64_t> m_ImageValues;   // last submission that rendered to the image
+
+		// Low-latency pacing
+		bool m_LowLatency = false;
+		float m_SleepMs = 0.0f;
+		float m_CpuFrameMs = 0.0f;             // smoothed frame start -> submit
+		Clock::time_point m_FrameStart{};
+		Clock::time_point m_LastReference{};   // last present seen (or estimated) on screen
+		static constexpr size_t PACING_HISTORY = 16;
+		std::array<float, PACING_HISTORY> m_ReferenceIntervals{};
+		size_t m_ReferenceCount = 0;
+
+		// Input-to-present
+		Clock::time_point m_FrameInputTime{};
+		Clock::time_point m_PendingInputTime{};  // waiting for m_PendingPresentId to display
+		uint64_t m_PendingPresentId = 0;
 
 		// prevent copying
 		FrameSyncManager(const FrameSyncManager&) = delete;
 		FrameSyncManager& operator=(const FrameSyncManager&) = delete;
 
 	};
-}
\ No newline at end of file
+}
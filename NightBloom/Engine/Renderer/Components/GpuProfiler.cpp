@@ -3,10 +3,69 @@
 //------------------------------------------------------------------------------
 #include "Engine/Renderer/Components/GpuProfiler.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/CpuProfiler.hpp"
+#include <algorithm>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		uint32_t QueueSlot(GpuQueue queue)
+		{
+			return queue == GpuQueue::Compute ? 1u : 0u;
+		}
+
+		VkQueryPool CreatePool(VkDevice device, uint32_t queryCount,
+			VkQueryType type = VK_QUERY_TYPE_TIMESTAMP, VkQueryPipelineStatisticFlags statistics = 0)
+		{
+			VkQueryPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			poolInfo.queryType = type;
+			poolInfo.queryCount = queryCount;
+			poolInfo.pipelineStatistics = statistics;
+
+			VkQueryPool pool = VK_NULL_HANDLE;
+			if (vkCreateQueryPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+				return VK_NULL_HANDLE;
+			return pool;
+		}
+
+		// Queries per frame slot for pipeline statistics: GpuQuerySegments
+		// needs at most two segments per scope
+		constexpr uint32_t MAX_SEGMENTS = GpuProfiler::MAX_SPANS * 2;
+
+		uint32_t CountBits(VkQueryPipelineStatisticFlags flags)
+		{
+			uint32_t count = 0;
+			for (; flags != 0; flags &= flags - 1)
+				++count;
+			return count;
+		}
+
+		// Results come in bit order, one counter per enabled statistic
+		GpuPipelineStats DecodeStats(VkQueryPipelineStatisticFlags flags, const uint64_t* values)
+		{
+			GpuPipelineStats stats;
+			for (VkQueryPipelineStatisticFlags bit = 1; bit != 0 && bit <= flags; bit <<= 1)
+			{
+				if ((flags & bit) == 0) continue;
+				const uint64_t value = *values++;
+				switch (bit)
+				{
+				case VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT:   stats.vertexInvocations = value; break;
+				case VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT:        stats.clippingInvocations = value; break;
+				case VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT:         stats.clippingPrimitives = value; break;
+				case VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT: stats.fragmentInvocations = value; break;
+				case VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT:  stats.computeInvocations = value; break;
+				default: break;
+				}
+			}
+			return stats;
+		}
+	}
+
 	bool GpuProfiler::Initialize(VulkanDevice* device)
 	{
 		m_Device = device;
@@ -22,49 +81,128 @@ namespace Nightbloom
 		std::vector<VkQueueFamilyProperties> families(familyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(device->GetPhysicalDevice(), &familyCount, families.data());
 
-		uint32_t gfxFamily = device->GetGraphicsQueueFamily();
-		uint32_t validBits = (gfxFamily < familyCount) ? families[gfxFamily].timestampValidBits : 0;
+		m_FamilyValidBits.resize(familyCount);
+		for (uint32_t i = 0; i < familyCount; ++i)
+			m_FamilyValidBits[i] = families[i].timestampValidBits;
 
-		if (m_TimestampPeriod <= 0.0f || validBits == 0)
+		uint64_t graphicsMask = GetValidBitsMask(device->GetGraphicsQueueFamily());
+		if (m_TimestampPeriod <= 0.0f || graphicsMask == 0)
 		{
 			LOG_WARN("GpuProfiler: timestamp queries unsupported on graphics queue — profiling disabled");
 			m_Supported = false;
 			return true;  // not fatal
 		}
 
-		m_ValidBitsMask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1ull);
-
-		VkQueryPoolCreateInfo poolInfo{};
-		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
-		poolInfo.queryCount = MAX_SPANS * 2;  // begin + end per span
-
+		VkDevice vkDevice = device->GetDevice();
+		QueueState& graphics = m_Queues[QueueSlot(GpuQueue::Graphics)];
+		graphics.validBitsMask = graphicsMask;
 		for (uint32_t i = 0; i < MAX_FRAMES; ++i)
 		{
-			if (vkCreateQueryPool(device->GetDevice(), &poolInfo, nullptr, &m_Pools[i]) != VK_SUCCESS)
+			graphics.pools[i] = CreatePool(vkDevice, MAX_SPANS * 2);  // begin + end per span
+			if (graphics.pools[i] == VK_NULL_HANDLE)
 			{
 				LOG_ERROR("GpuProfiler: failed to create query pool {}", i);
 				m_Supported = false;
 				return false;
 			}
+			graphics.records[i].reserve(MAX_SPANS);
+		}
+		graphics.supported = true;
+
+		// Optional queues: profiling carries on without them
+		QueueState& compute = m_Queues[QueueSlot(GpuQueue::Compute)];
+		compute.validBitsMask = GetValidBitsMask(device->GetComputeQueueFamily());
+		if (device->HasAsyncComputeQueue() && compute.validBitsMask != 0)
+		{
+			compute.supported = true;
+			for (uint32_t i = 0; i < MAX_FRAMES; ++i)
+			{
+				compute.pools[i] = CreatePool(vkDevice, MAX_SPANS * 2);
+				compute.supported = compute.supported && compute.pools[i] != VK_NULL_HANDLE;
+			}
+			if (!compute.supported)
+				LOG_WARN("GpuProfiler: failed to create compute query pools - compute queue not timed");
+		}
+
+		// Pipeline statistics: optional, and only where secondary command
+		// buffers can inherit them (parallel recording runs inside scopes)
+		m_StatsSupported = device->SupportsFeature("pipeline_statistics_query") &&
+			device->SupportsFeature("inherited_queries");
+		if (m_StatsSupported)
+		{
+			m_OcclusionFlags = device->SupportsFeature("occlusion_query_precise") ? VK_QUERY_CONTROL_PRECISE_BIT : 0;
+
+			graphics.statsFlags = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+				VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+				VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+				VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+			// Compute counts need a compute-capable pool's queue family
+			uint32_t graphicsFamily = device->GetGraphicsQueueFamily();
+			if (graphicsFamily < familyCount && (families[graphicsFamily].queueFlags & VK_QUEUE_COMPUTE_BIT))
+				graphics.statsFlags |= VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+			compute.statsFlags = compute.supported ? VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT : 0;
+
+			for (uint32_t i = 0; i < MAX_FRAMES && m_StatsSupported; ++i)
+			{
+				graphics.statsPools[i] = CreatePool(vkDevice, MAX_SEGMENTS,
+					VK_QUERY_TYPE_PIPELINE_STATISTICS, graphics.statsFlags);
+				graphics.occlusionPools[i] = CreatePool(vkDevice, MAX_SEGMENTS, VK_QUERY_TYPE_OCCLUSION);
+				if (compute.statsFlags != 0)
+				{
+					compute.statsPools[i] = CreatePool(vkDevice, MAX_SEGMENTS,
+						VK_QUERY_TYPE_PIPELINE_STATISTICS, compute.statsFlags);
+				}
+				m_StatsSupported = graphics.statsPools[i] != VK_NULL_HANDLE &&
+					graphics.occlusionPools[i] != VK_NULL_HANDLE &&
+					(compute.statsFlags == 0 || compute.statsPools[i] != VK_NULL_HANDLE);
+			}
+			if (!m_StatsSupported)
+				LOG_WARN("GpuProfiler: failed to create pipeline statistics pools - statistics unavailable");
+		}
+
+		if (device->IsHostQueryResetEnabled())
+		{
+			m_TransferPool = CreatePool(vkDevice, MAX_TRANSFER_SPANS * 2);
+			if (m_TransferPool == VK_NULL_HANDLE)
+				LOG_WARN("GpuProfiler: failed to create transfer query pool - uploads not timed");
 		}
 
 		m_Supported = true;
-		LOG_INFO("GpuProfiler initialized (timestampPeriod {} ns/tick)", m_TimestampPeriod);
+		LOG_INFO("GpuProfiler initialized (timestampPeriod {} ns/tick, compute {}, transfer {}, pipeline statistics {})",
+			m_TimestampPeriod,
+			compute.supported ? "timed" : "not timed",
+			m_TransferPool != VK_NULL_HANDLE ? "timed" : "not timed",
+			m_StatsSupported ? "available" : "unavailable");
 		return true;
 	}
 
 	void GpuProfiler::Cleanup()
 	{
 		if (!m_Device) return;
-		for (uint32_t i = 0; i < MAX_FRAMES; ++i)
+		VkDevice device = m_Device->GetDevice();
+		for (QueueState& state : m_Queues)
 		{
-			if (m_Pools[i] != VK_NULL_HANDLE)
+			for (uint32_t i = 0; i < MAX_FRAMES; ++i)
 			{
-				vkDestroyQueryPool(m_Device->GetDevice(), m_Pools[i], nullptr);
-				m_Pools[i] = VK_NULL_HANDLE;
+				for (VkQueryPool* pool : { &state.pools[i], &state.statsPools[i], &state.occlusionPools[i] })
+				{
+					if (*pool != VK_NULL_HANDLE)
+					{
+						vkDestroyQueryPool(device, *pool, nullptr);
+						*pool = VK_NULL_HANDLE;
+					}
+				}
+				state.statsRecorded[i] = false;
 			}
+			state.supported = false;
+			state.statsFlags = 0;
 		}
+		if (m_TransferPool != VK_NULL_HANDLE)
+		{
+			vkDestroyQueryPool(device, m_TransferPool, nullptr);
+			m_TransferPool = VK_NULL_HANDLE;
+		}
+		m_StatsSupported = false;
 		m_Device = nullptr;
 	}
 
@@ -72,62 +210,377 @@ namespace Nightbloom
 	{
 		if (!m_Supported) return;
 		m_FrameIndex = frameIndex;
-		m_SpanCount = 0;
 
 		// Read back the results this slot recorded the previous time around. The
-		// fence for this frame slot was waited on before recording, so they're ready.
-		if (m_PoolValid[frameIndex] && m_PoolSpans[frameIndex] > 0)
-		{
-			uint32_t spans = m_PoolSpans[frameIndex];
-			uint32_t queryCount = spans * 2;
-			std::array<uint64_t, MAX_SPANS * 2> raw{};
+		// previous submission of this frame slot was waited on before recording, so they're ready.
+		GpuFrameProfile frame;
+		ReadQueue(GpuQueue::Graphics, frameIndex, frame);
+		const size_t graphicsSpans = frame.spans.size();
+		ReadQueue(GpuQueue::Compute, frameIndex, frame);
+		ReadTransfers(frame);
 
-			VkResult r = vkGetQueryPoolResults(
-				m_Device->GetDevice(), m_Pools[frameIndex],
-				0, queryCount,
-				queryCount * sizeof(uint64_t), raw.data(), sizeof(uint64_t),
-				VK_QUERY_RESULT_64_BIT);
-
-			if (r == VK_SUCCESS)
+		if (graphicsSpans > 0)
+		{
+			m_Results.clear();
+			for (size_t s = 0; s < graphicsSpans; ++s)
 			{
-				m_Results.clear();
-				for (uint32_t s = 0; s < spans; ++s)
-				{
-					uint64_t begin = raw[s * 2 + 0] & m_ValidBitsMask;
-					uint64_t end   = raw[s * 2 + 1] & m_ValidBitsMask;
-					float ms = (end > begin)
-						? static_cast<float>(end - begin) * m_TimestampPeriod * 1e-6f
-						: 0.0f;
-					m_Results.push_back({ m_PoolNames[frameIndex][s], ms });
-				}
+				if (frame.spans[s].parent == GpuSpan::NO_PARENT)
+					m_Results.push_back({ frame.spans[s].name, frame.spans[s].ms });
 			}
 		}
+		if (!frame.spans.empty())
+		{
+			frame.frameNumber = m_FrameNumber++;
+			m_History.Push(std::move(frame));
+		}
+
+		for (QueueState& state : m_Queues)
+		{
+			state.records[frameIndex].clear();
+			state.slotValid[frameIndex] = false;
+			state.submitNs[frameIndex] = 0;
+			state.statsRecorded[frameIndex] = false;
+			state.open = false;
+			state.stack.clear();
+		}
 
 		// Pools must be reset before reuse (timestamp queries can't be overwritten).
-		vkCmdResetQueryPool(cmd, m_Pools[frameIndex], 0, MAX_SPANS * 2);
+		BeginQueue(cmd, GpuQueue::Graphics);
 	}
 
 	void GpuProfiler::EndFrame(uint32_t frameIndex)
 	{
 		if (!m_Supported) return;
-		m_PoolValid[frameIndex] = (m_SpanCount > 0);
-		m_PoolSpans[frameIndex] = m_SpanCount;
-		for (uint32_t s = 0; s < m_SpanCount; ++s)
-			m_PoolNames[frameIndex][s] = m_Names[s];
+		for (uint32_t q = 0; q < FRAME_QUEUES; ++q)
+		{
+			QueueState& state = m_Queues[q];
+			if (!state.open) continue;
+
+			// An end timestamp never written would keep the whole slot unreadable
+			if (!state.stack.empty())
+			{
+				LOG_WARN("GpuProfiler: scope '{}' was never ended - dropping the frame's {} timings",
+					state.records[frameIndex][state.stack.back()].name.c_str(),
+					GetGpuQueueName(q == 0 ? GpuQueue::Graphics : GpuQueue::Compute));
+				state.slotValid[frameIndex] = false;
+			}
+			else
+			{
+				state.slotValid[frameIndex] = !state.records[frameIndex].empty();
+			}
+			state.open = false;
+			state.stack.clear();
+		}
+	}
+
+	void GpuProfiler::BeginQueue(VkCommandBuffer cmd, GpuQueue queue)
+	{
+		if (!m_Supported || queue == GpuQueue::Transfer) return;
+		QueueState& state = m_Queues[QueueSlot(queue)];
+		if (!state.supported) return;
+
+		vkCmdResetQueryPool(cmd, state.pools[m_FrameIndex], 0, MAX_SPANS * 2);
+		state.records[m_FrameIndex].clear();
+
+		const bool stats = m_StatsSupported && m_StatsEnabled && state.statsPools[m_FrameIndex] != VK_NULL_HANDLE;
+		state.statsRecorded[m_FrameIndex] = stats;
+		if (stats)
+		{
+			vkCmdResetQueryPool(cmd, state.statsPools[m_FrameIndex], 0, MAX_SEGMENTS);
+			if (state.occlusionPools[m_FrameIndex] != VK_NULL_HANDLE)
+				vkCmdResetQueryPool(cmd, state.occlusionPools[m_FrameIndex], 0, MAX_SEGMENTS);
+			state.segments[m_FrameIndex].Reset(MAX_SEGMENTS);
+		}
+		state.stack.clear();
+		state.open = true;
 	}
 
-	uint32_t GpuProfiler::BeginScope(VkCommandBuffer cmd, const char* name)
+	void GpuProfiler::DiscardQueue(uint32_t frameIndex, GpuQueue queue)
 	{
-		if (!m_Supported || m_SpanCount >= MAX_SPANS) return UINT32_MAX;
-		uint32_t idx = m_SpanCount++;
-		m_Names[idx] = name;
-		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_Pools[m_FrameIndex], idx * 2);
+		if (!m_Supported || queue == GpuQueue::Transfer) return;
+		QueueState& state = m_Queues[QueueSlot(queue)];
+		state.slotValid[frameIndex] = false;
+		state.records[frameIndex].clear();
+	}
+
+	void GpuProfiler::MarkSubmit(uint32_t frameIndex, GpuQueue queue)
+	{
+		if (!m_Supported || queue == GpuQueue::Transfer) return;
+		QueueState& state = m_Queues[QueueSlot(queue)];
+		if (state.submitNs[frameIndex] == 0)
+			state.submitNs[frameIndex] = CpuProfiler::Now();
+	}
+
+	uint32_t GpuProfiler::BeginScope(VkCommandBuffer cmd, StringId name, GpuQueue queue)
+	{
+		if (!m_Supported || queue == GpuQueue::Transfer) return UINT32_MAX;
+		QueueState& state = m_Queues[QueueSlot(queue)];
+		std::vector<SpanRecord>& records = state.records[m_FrameIndex];
+		if (!state.open || records.size() >= MAX_SPANS) return UINT32_MAX;
+
+		uint32_t idx = static_cast<uint32_t>(records.size());
+		SpanRecord& record = records.emplace_back();
+		record.name = name;
+		record.parent = state.stack.empty() ? GpuSpan::NO_PARENT : state.stack.back();
+		record.depth = static_cast<uint32_t>(state.stack.size());
+		state.stack.push_back(idx);
+
+		VulkanDebugMarkers::BeginLabel(cmd, name.c_str());
+		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, state.pools[m_FrameIndex], idx * 2);
+		if (state.statsRecorded[m_FrameIndex])
+			SwitchQueries(cmd, state, state.segments[m_FrameIndex].BeginScope(idx));
 		return idx;
 	}
 
-	void GpuProfiler::EndScope(VkCommandBuffer cmd, uint32_t scope)
+	void GpuProfiler::EndScope(VkCommandBuffer cmd, uint32_t scope, GpuQueue queue)
 	{
-		if (!m_Supported || scope == UINT32_MAX) return;
-		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_Pools[m_FrameIndex], scope * 2 + 1);
+		if (!m_Supported || scope == UINT32_MAX || queue == GpuQueue::Transfer) return;
+		QueueState& state = m_Queues[QueueSlot(queue)];
+		if (!state.open) return;
+
+		auto it = std::find(state.stack.begin(), state.stack.end(), scope);
+		if (it == state.stack.end()) return;  // already ended
+
+		// Children still open end with their parent, innermost first
+		while (state.stack.back() != scope)
+		{
+			WriteEnd(cmd, state, state.stack.back());
+			state.stack.pop_back();
+		}
+		WriteEnd(cmd, state, scope);
+		state.stack.pop_back();
+	}
+
+	uint32_t GpuProfiler::BeginTransferScope(VkCommandBuffer cmd, uint32_t queueFamily, StringId name)
+	{
+		if (!m_Supported || m_TransferPool == VK_NULL_HANDLE) return UINT32_MAX;
+
+		uint64_t validBitsMask = GetValidBitsMask(queueFamily);
+		if (validBitsMask == 0) return UINT32_MAX;
+
+		for (uint32_t i = 0; i < MAX_TRANSFER_SPANS; ++i)
+		{
+			TransferSpan& span = m_TransferSpans[i];
+			if (span.state != TransferSpan::State::Free) continue;
+
+			// Transfer queues can't reset query pools themselves
+			vkResetQueryPool(m_Device->GetDevice(), m_TransferPool, i * 2, 2);
+			span.state = TransferSpan::State::Recording;
+			span.name = name;
+			span.validBitsMask = validBitsMask;
+			VulkanDebugMarkers::BeginLabel(cmd, name.c_str());
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TransferPool, i * 2);
+			return i;
+		}
+		return UINT32_MAX;  // every span still waiting on the GPU
+	}
+
+	void GpuProfiler::EndTransferScope(VkCommandBuffer cmd, uint32_t scope)
+	{
+		if (scope >= MAX_TRANSFER_SPANS || m_TransferSpans[scope].state != TransferSpan::State::Recording) return;
+		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TransferPool, scope * 2 + 1);
+		VulkanDebugMarkers::EndLabel(cmd);
+		m_TransferSpans[scope].state = TransferSpan::State::Submitted;
+		m_TransferSpans[scope].submitNs = CpuProfiler::Now();
+	}
+
+	void GpuProfiler::CancelTransferScope(uint32_t scope)
+	{
+		if (scope >= MAX_TRANSFER_SPANS) return;
+		m_TransferSpans[scope].state = TransferSpan::State::Free;
+	}
+
+	float GpuProfiler::GetTotalMs() const
+	{
+		float total = 0.0f;
+		for (const Result& r : m_Results)
+			total += r.ms;
+		return total;
+	}
+
+	GpuProfiler::InheritedQueries GpuProfiler::GetInheritedQueries() const
+	{
+		InheritedQueries inherited;
+		if (!m_StatsSupported) return inherited;
+		inherited.occlusion = true;
+		inherited.occlusionFlags = m_OcclusionFlags;
+		inherited.pipelineStatistics = m_Queues[QueueSlot(GpuQueue::Graphics)].statsFlags;
+		return inherited;
+	}
+
+	bool GpuProfiler::IsQueueSupported(GpuQueue queue) const
+	{
+		if (!m_Supported) return false;
+		if (queue == GpuQueue::Transfer) return m_TransferPool != VK_NULL_HANDLE;
+		return m_Queues[QueueSlot(queue)].supported;
+	}
+
+	uint64_t GpuProfiler::GetValidBitsMask(uint32_t queueFamily) const
+	{
+		uint32_t validBits = (queueFamily < m_FamilyValidBits.size()) ? m_FamilyValidBits[queueFamily] : 0;
+		if (validBits == 0) return 0;
+		return (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1ull);
+	}
+
+	void GpuProfiler::ReadQueue(GpuQueue queue, uint32_t frameIndex, GpuFrameProfile& frame)
+	{
+		const QueueState& state = m_Queues[QueueSlot(queue)];
+		const std::vector<SpanRecord>& records = state.records[frameIndex];
+		if (!state.supported || !state.slotValid[frameIndex] || records.empty()) return;
+
+		uint32_t queryCount = static_cast<uint32_t>(records.size()) * 2;
+		m_ReadBuffer.resize(queryCount);
+		VkResult r = vkGetQueryPoolResults(
+			m_Device->GetDevice(), state.pools[frameIndex],
+			0, queryCount,
+			queryCount * sizeof(uint64_t), m_ReadBuffer.data(), sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT);
+		if (r != VK_SUCCESS) return;
+
+		// Start times count from the queue's first timestamp this frame
+		uint64_t origin = ~0ull;
+		for (size_t s = 0; s < records.size(); ++s)
+			origin = std::min(origin, m_ReadBuffer[s * 2] & state.validBitsMask);
+
+		const uint32_t base = static_cast<uint32_t>(frame.spans.size());
+		for (size_t s = 0; s < records.size(); ++s)
+		{
+			uint64_t begin = m_ReadBuffer[s * 2 + 0] & state.validBitsMask;
+			uint64_t end   = m_ReadBuffer[s * 2 + 1] & state.validBitsMask;
+
+			GpuSpan& span = frame.spans.emplace_back();
+			span.name = records[s].name;
+			span.parent = (records[s].parent == GpuSpan::NO_PARENT) ? GpuSpan::NO_PARENT : base + records[s].parent;
+			span.depth = records[s].depth;
+			span.queue = queue;
+			span.startMs = static_cast<double>(begin - origin) * m_TimestampPeriod * 1e-6;
+			span.ms = (end > begin)
+				? static_cast<float>(end - begin) * m_TimestampPeriod * 1e-6f
+				: 0.0f;
+		}
+		frame.cpuSubmitNs[static_cast<size_t>(queue)] = state.submitNs[frameIndex];
+
+		if (state.statsRecorded[frameIndex])
+			ReadPipelineStats(state, frameIndex, frame, base);
+	}
+
+	void GpuProfiler::ReadPipelineStats(const QueueState& state, uint32_t frameIndex, GpuFrameProfile& frame, uint32_t base)
+	{
+		const GpuQuerySegments& segments = state.segments[frameIndex];
+		const uint32_t segmentCount = segments.GetSegmentCount();
+		if (segmentCount == 0) return;
+
+		const uint32_t counters = CountBits(state.statsFlags);
+		m_ReadBuffer.resize(static_cast<size_t>(segmentCount) * counters);
+		VkResult r = vkGetQueryPoolResults(
+			m_Device->GetDevice(), state.statsPools[frameIndex],
+			0, segmentCount,
+			m_ReadBuffer.size() * sizeof(uint64_t), m_ReadBuffer.data(), counters * sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT);
+		if (r != VK_SUCCESS) return;
+
+		std::vector<GpuPipelineStats> values(segmentCount);
+		for (uint32_t s = 0; s < segmentCount; ++s)
+			values[s] = DecodeStats(state.statsFlags, &m_ReadBuffer[static_cast<size_t>(s) * counters]);
+
+		if (state.occlusionPools[frameIndex] != VK_NULL_HANDLE)
+		{
+			m_ReadBuffer.resize(segmentCount);
+			r = vkGetQueryPoolResults(
+				m_Device->GetDevice(), state.occlusionPools[frameIndex],
+				0, segmentCount,
+				segmentCount * sizeof(uint64_t), m_ReadBuffer.data(), sizeof(uint64_t),
+				VK_QUERY_RESULT_64_BIT);
+			if (r == VK_SUCCESS)
+			{
+				for (uint32_t s = 0; s < segmentCount; ++s)
+					values[s].samplesPassed = m_ReadBuffer[s];
+			}
+		}
+
+		const std::vector<SpanRecord>& records = state.records[frameIndex];
+		std::vector<uint32_t> parents(records.size());
+		for (size_t s = 0; s < records.size(); ++s)
+			parents[s] = records[s].parent;
+
+		const std::vector<GpuQuerySegments::Total> totals = segments.Resolve(values, parents);
+		for (size_t s = 0; s < totals.size(); ++s)
+		{
+			GpuSpan& span = frame.spans[base + s];
+			span.hasPipelineStats = totals[s].complete;
+			span.pipelineStats = totals[s].stats;
+		}
+	}
+
+	void GpuProfiler::ReadTransfers(GpuFrameProfile& frame)
+	{
+		if (m_TransferPool == VK_NULL_HANDLE) return;
+
+		struct Finished { uint32_t span; uint64_t begin; uint64_t end; };
+		std::vector<Finished> finished;
+		uint64_t origin = ~0ull;
+		uint64_t originSubmitNs = 0;   // submit time of the batch that began first
+
+		for (uint32_t i = 0; i < MAX_TRANSFER_SPANS; ++i)
+		{
+			TransferSpan& span = m_TransferSpans[i];
+			if (span.state != TransferSpan::State::Submitted) continue;
+
+			// Value + availability per query; not waited on, an unfinished
+			// batch is simply looked at again next frame
+			uint64_t data[4] = {};
+			VkResult r = vkGetQueryPoolResults(m_Device->GetDevice(), m_TransferPool,
+				i * 2, 2, sizeof(data), data, sizeof(uint64_t) * 2,
+				VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+			if ((r != VK_SUCCESS && r != VK_NOT_READY) || data[1] == 0 || data[3] == 0) continue;
+
+			Finished done{ i, data[0] & span.validBitsMask, data[2] & span.validBitsMask };
+			if (done.begin < origin)
+			{
+				origin = done.begin;
+				originSubmitNs = span.submitNs;
+			}
+			finished.push_back(done);
+		}
+
+		for (const Finished& done : finished)
+		{
+			TransferSpan& transfer = m_TransferSpans[done.span];
+
+			GpuSpan& span = frame.spans.emplace_back();
+			span.name = transfer.name;
+			span.queue = GpuQueue::Transfer;
+			span.startMs = static_cast<double>(done.begin - origin) * m_TimestampPeriod * 1e-6;
+			span.ms = (done.end > done.begin)
+				? static_cast<float>(done.end - done.begin) * m_TimestampPeriod * 1e-6f
+				: 0.0f;
+			transfer.state = TransferSpan::State::Free;
+		}
+		if (!finished.empty())
+			frame.cpuSubmitNs[static_cast<size_t>(GpuQueue::Transfer)] = originSubmitNs;
+	}
+
+	void GpuProfiler::WriteEnd(VkCommandBuffer cmd, QueueState& state, uint32_t scope)
+	{
+		if (state.statsRecorded[m_FrameIndex])
+			SwitchQueries(cmd, state, state.segments[m_FrameIndex].EndScope(scope));
+		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, state.pools[m_FrameIndex], scope * 2 + 1);
+		VulkanDebugMarkers::EndLabel(cmd);
+	}
+
+	void GpuProfiler::SwitchQueries(VkCommandBuffer cmd, QueueState& state, const GpuQuerySegments::Switch& change)
+	{
+		VkQueryPool stats = state.statsPools[m_FrameIndex];
+		VkQueryPool occlusion = state.occlusionPools[m_FrameIndex];
+		if (change.end != GpuQuerySegments::NONE)
+		{
+			vkCmdEndQuery(cmd, stats, change.end);
+			if (occlusion != VK_NULL_HANDLE) vkCmdEndQuery(cmd, occlusion, change.end);
+		}
+		if (change.begin != GpuQuerySegments::NONE)
+		{
+			vkCmdBeginQuery(cmd, stats, change.begin, 0);
+			if (occlusion != VK_NULL_HANDLE) vkCmdBeginQuery(cmd, occlusion, change.begin, m_OcclusionFlags);
+		}
 	}
 } // namespace Nightbloom
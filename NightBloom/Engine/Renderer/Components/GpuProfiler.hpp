@@ -5,21 +5,60 @@
 // TOP_OF_PIPE timestamp on begin and a BOTTOM_OF_PIPE timestamp on end; the
 // delta * timestampPeriod gives the GPU wall time for that span.
 //
-// Double-buffered by frame-in-flight: results are read back when a frame slot
-// comes around again (the fence for that slot has already been waited on in
-// Renderer::BeginFrame, so the timestamps are guaranteed available — no stall).
-// Results are therefore one full frame-in-flight cycle old, which is fine for
-// an on-screen overlay.
+// Scopes nest: one begun while another is open on the same queue becomes its
+// child, and ending a scope also ends any child still open. Up to MAX_SPANS
+// per queue per frame.
+//
+// Queues:
+//   Graphics  one query pool per frame in flight: results are read back when
+//             a frame slot comes around again (that slot's previous submission
+//             has already been waited on in Renderer::BeginFrame, so the
+//             timestamps are guaranteed available - no stall). Results are
+//             therefore one full frame-in-flight cycle old, which is fine for
+//             an on-screen overlay.
+//   Compute   the async compute command buffer of the same slot, opened with
+//             BeginQueue. The graphics submission waits for it, so the same
+//             frame wait covers it.
+//   Transfer  upload batches (VulkanUploadManager), which aren't tied to a
+//             frame: a small ring of spans, each reset on the host when begun
+//             (needs hostQueryReset) and collected by whichever frame first
+//             finds it finished.
+// A queue family without timestamp support just records nothing.
+//
+// Scope names are StringIds (Core/StringId.hpp): beginning a scope stores a
+// 32-bit id, nothing is copied or allocated per scope.
+//
+// Each scope recorded is also a VK_EXT_debug_utils label of the same name
+// (VulkanDebugMarkers.hpp), so external captures show the same hierarchy.
+// Scopes that aren't recorded (no timestamp support, span budget full) get
+// no label either.
+//
+// Every frame read back goes into a rolling GpuProfileHistory (flame graph
+// and min/avg/max/percentiles in the Debug panel).
+//
+// Pipeline statistics (opt-in, SetPipelineStatisticsEnabled): graphics and
+// compute scopes also count vertex, clipping, fragment and compute
+// invocations, and graphics scopes the samples passing depth (occlusion
+// query). Those queries can't nest, so they're split into segments at
+// child scopes (GpuQuerySegments.hpp). A scope with statistics must begin
+// and end outside render passes and in the same command buffer, which every
+// RenderGraph scope does; secondary command buffers inherit the queries
+// (CommandRecorder::SetInheritedQueries). Needs the pipelineStatisticsQuery
+// and inheritedQueries features.
 //
 // Usage per frame (inside the recorded command buffer):
-//   profiler.BeginFrame(cmd, frameIndex);          // reset + read previous results
+//   profiler.BeginFrame(cmd, frameIndex);          // read previous results + reset
 //   uint32_t s = profiler.BeginScope(cmd, "Shadow");
 //   ... record the pass ...
 //   profiler.EndScope(cmd, s);
-//   profiler.EndFrame(frameIndex);                 // latch span count/names
+//   profiler.EndFrame(frameIndex);                 // check every scope was ended
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Core/StringId.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/GpuProfileHistory.hpp"
+#include "Engine/Renderer/GpuQuerySegments.hpp"
 #include <vulkan/vulkan.h>
 #include <array>
 #include <string>
@@ -33,43 +72,130 @@ namespace Nightbloom
 	class GpuProfiler
 	{
 	public:
-		static constexpr uint32_t MAX_FRAMES = 2;
-		static constexpr uint32_t MAX_SPANS  = 16;  // per frame
+		static constexpr uint32_t MAX_FRAMES = MAX_FRAMES_IN_FLIGHT;
+		static constexpr uint32_t MAX_SPANS  = 512;  // per queue per frame
+		static constexpr uint32_t MAX_TRANSFER_SPANS = 64;  // in flight at once
 
 		bool Initialize(VulkanDevice* device);
 		void Cleanup();
 
 		// Start of command-buffer recording: read back this slot's previous results
-		// and reset its query pool. Must be called inside an open command buffer.
+		// and reset its graphics query pool. Must be called inside an open command buffer.
 		void BeginFrame(VkCommandBuffer cmd, uint32_t frameIndex);
-		// End of command-buffer recording: latch how many spans / which names were used.
+		// End of command-buffer recording. A slot left with open scopes is dropped.
 		void EndFrame(uint32_t frameIndex);
 
+		// Opens the compute queue for this frame's scopes: resets the slot's
+		// compute pool in `cmd`, the slot's async compute command buffer
+		void BeginQueue(VkCommandBuffer cmd, GpuQueue queue);
+		// Forget what the slot recorded on `queue` (its submission failed)
+		void DiscardQueue(uint32_t frameIndex, GpuQueue queue);
+		// Call right before the slot's first submission on `queue`: the CPU
+		// time its spans are placed at in a Chrome trace
+		void MarkSubmit(uint32_t frameIndex, GpuQueue queue);
+
 		// Returns a scope handle (or UINT32_MAX if the per-frame span budget is full /
-		// profiling unsupported). EndScope is a no-op for an invalid handle.
-		uint32_t BeginScope(VkCommandBuffer cmd, const char* name);
-		void EndScope(VkCommandBuffer cmd, uint32_t scope);
+		// the queue can't be timed). EndScope is a no-op for an invalid handle.
+		uint32_t BeginScope(VkCommandBuffer cmd, StringId name, GpuQueue queue = GpuQueue::Graphics);
+		void EndScope(VkCommandBuffer cmd, uint32_t scope, GpuQueue queue = GpuQueue::Graphics);
 
-		struct Result { std::string name; float ms; };
+		// One span around an upload batch's command buffer, recorded on
+		// `queueFamily`. Cancel it if the command buffer is never submitted.
+		uint32_t BeginTransferScope(VkCommandBuffer cmd, uint32_t queueFamily, StringId name);
+		void EndTransferScope(VkCommandBuffer cmd, uint32_t scope);
+		void CancelTransferScope(uint32_t scope);
+
+		// Top-level graphics scopes of the newest frame read back
+		struct Result { StringId name; float ms; };
 		const std::vector<Result>& GetResults() const { return m_Results; }
+		float GetTotalMs() const;   // sum of the spans above
 		bool IsSupported() const { return m_Supported; }
+		bool IsQueueSupported(GpuQueue queue) const;
+
+		// Takes effect from each queue's next BeginQueue
+		void SetPipelineStatisticsEnabled(bool enabled) { m_StatsEnabled = enabled; }
+		bool IsPipelineStatisticsEnabled() const { return m_StatsEnabled; }
+		bool IsPipelineStatisticsSupported() const { return m_StatsSupported; }
+
+		// What secondary command buffers executed inside a scope must inherit
+		struct InheritedQueries
+		{
+			bool occlusion = false;
+			VkQueryControlFlags occlusionFlags = 0;
+			VkQueryPipelineStatisticFlags pipelineStatistics = 0;
+		};
+		InheritedQueries GetInheritedQueries() const;
+
+		GpuProfileHistory& GetHistory() { return m_History; }
+		const GpuProfileHistory& GetHistory() const { return m_History; }
 
 	private:
+		struct SpanRecord
+		{
+			StringId name;
+			uint32_t parent = GpuSpan::NO_PARENT;
+			uint32_t depth = 0;
+		};
+
+		// Graphics and compute: per frame slot
+		struct QueueState
+		{
+			bool supported = false;
+			uint64_t validBitsMask = ~0ull;
+			VkQueryPool pools[MAX_FRAMES] = {};
+			std::array<std::vector<SpanRecord>, MAX_FRAMES> records{};
+			bool slotValid[MAX_FRAMES] = {};   // slot holds results worth reading
+			uint64_t submitNs[MAX_FRAMES] = {};  // CpuProfiler::Now() at MarkSubmit
+
+			bool open = false;                 // accepting scopes this frame
+			std::vector<uint32_t> stack;       // open scopes, innermost last
+
+			// Pipeline statistics: one query per segment
+			VkQueryPipelineStatisticFlags statsFlags = 0;
+			VkQueryPool statsPools[MAX_FRAMES] = {};
+			VkQueryPool occlusionPools[MAX_FRAMES] = {};  // graphics only
+			std::array<GpuQuerySegments, MAX_FRAMES> segments{};
+			bool statsRecorded[MAX_FRAMES] = {};
+		};
+
+		struct TransferSpan
+		{
+			enum class State : uint8_t { Free, Recording, Submitted };
+
+			State state = State::Free;
+			StringId name;
+			uint64_t validBitsMask = ~0ull;
+			uint64_t submitNs = 0;   // when the scope was ended, just before submission
+		};
+
+		static constexpr uint32_t FRAME_QUEUES = 2;   // Graphics, Compute
+
+		uint64_t GetValidBitsMask(uint32_t queueFamily) const;
+		void ReadQueue(GpuQueue queue, uint32_t frameIndex, GpuFrameProfile& frame);
+		void ReadTransfers(GpuFrameProfile& frame);
+		void ReadPipelineStats(const QueueState& state, uint32_t frameIndex, GpuFrameProfile& frame, uint32_t base);
+		void WriteEnd(VkCommandBuffer cmd, QueueState& state, uint32_t scope);
+		void SwitchQueries(VkCommandBuffer cmd, QueueState& state, const GpuQuerySegments::Switch& change);
+
 		VulkanDevice* m_Device = nullptr;
 		bool     m_Supported = false;
 		float    m_TimestampPeriod = 1.0f;       // nanoseconds per tick
-		uint64_t m_ValidBitsMask = ~0ull;
-
-		VkQueryPool m_Pools[MAX_FRAMES] = {};
+		std::vector<uint32_t> m_FamilyValidBits;
 
+		QueueState m_Queues[FRAME_QUEUES];
 		uint32_t m_FrameIndex = 0;               // slot currently being recorded
-		uint32_t m_SpanCount = 0;                // spans recorded so far this frame
-		std::array<std::string, MAX_SPANS> m_Names{};
 
-		bool     m_PoolValid[MAX_FRAMES] = {};   // slot holds results worth reading
-		uint32_t m_PoolSpans[MAX_FRAMES] = {};
-		std::array<std::array<std::string, MAX_SPANS>, MAX_FRAMES> m_PoolNames{};
+		VkQueryPool m_TransferPool = VK_NULL_HANDLE;
+		std::array<TransferSpan, MAX_TRANSFER_SPANS> m_TransferSpans{};
+
+		std::vector<uint64_t> m_ReadBuffer;
+
+		bool m_StatsSupported = false;
+		bool m_StatsEnabled = false;
+		VkQueryControlFlags m_OcclusionFlags = 0;  // PRECISE when supported
 
+		uint64_t m_FrameNumber = 0;
+		GpuProfileHistory m_History;
 		std::vector<Result> m_Results;
 
 		GpuProfiler(const GpuProfiler&) = delete;
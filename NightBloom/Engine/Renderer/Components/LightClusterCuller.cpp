@@ -0,0 +1,274 @@
+//------------------------------------------------------------------------------
+// LightClusterCuller.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/LightClusterCuller.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t CLUSTER_LOCAL_SIZE = 64;  // LightClusterGather.comp, LightClusterAssign.comp
+
+		constexpr VkDeviceSize HEADER_SIZE = 48;  // ClusterLightBuffer's header in light_clusters.glsl
+		static_assert(sizeof(LightData) == 48, "ClusterLight in light_clusters.glsl");
+
+		constexpr VkDeviceSize LIGHT_BUFFER_SIZE =
+			HEADER_SIZE + sizeof(LightData) * LightClusterCuller::MAX_LIGHTS;
+		// Counts, then MAX_LIGHTS_PER_CLUSTER indices per cluster
+		constexpr VkDeviceSize CLUSTER_BUFFER_SIZE = sizeof(uint32_t) *
+			LightClusterCuller::CLUSTER_COUNT * (1 + LightClusterCuller::MAX_LIGHTS_PER_CLUSTER);
+	}
+
+	bool LightClusterCuller::Initialize(VulkanDevice* device, ResourceManager* resources,
+		VulkanDescriptorManager* descriptorManager)
+	{
+		m_Device = device;
+		m_Resources = resources;
+		m_DescriptorManager = descriptorManager;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			const std::string suffix = std::to_string(i);
+			m_LightBuffers[i] = m_Resources->CreateStorageBuffer("ClusterLights_" + suffix, LIGHT_BUFFER_SIZE, true);
+			m_ClusterBuffers[i] = m_Resources->CreateStorageBuffer("LightClusters_" + suffix, CLUSTER_BUFFER_SIZE);
+			if (!m_LightBuffers[i] || !m_ClusterBuffers[i] || !m_LightBuffers[i]->GetPersistentMappedPtr())
+			{
+				LOG_ERROR("LightClusterCuller: failed to create light/cluster buffers");
+				return false;
+			}
+
+			m_DescriptorManager->UpdateLightingClusterBuffers(i,
+				m_LightBuffers[i]->GetBuffer(), LIGHT_BUFFER_SIZE,
+				m_ClusterBuffers[i]->GetBuffer(), CLUSTER_BUFFER_SIZE);
+
+			// Shading off until the first WriteLights
+			m_UploadedHeaders[i] = Header{};
+			m_LightBuffers[i]->Update(&m_UploadedHeaders[i], sizeof(Header));
+			m_UploadedVersions[i] = 0;
+		}
+
+		// Without the passes the shaders keep SceneLighting's point lights
+		m_CanCull = CreatePipelines();
+		if (!m_CanCull)
+		{
+			LOG_WARN("LightClusterCuller: failed to create compute pipelines - clustered lighting disabled");
+			return true;
+		}
+
+		LOG_INFO("LightClusterCuller initialized ({}x{}x{} clusters, {} lights max)",
+			CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z, MAX_LIGHTS);
+		return true;
+	}
+
+	void LightClusterCuller::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		VkPipeline pipelines[] = { m_GatherPipeline, m_AssignPipeline };
+		for (VkPipeline pipeline : pipelines)
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+		}
+		m_GatherPipeline = m_AssignPipeline = VK_NULL_HANDLE;
+
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			const std::string suffix = std::to_string(i);
+			if (m_LightBuffers[i]) m_Resources->DestroyBuffer("ClusterLights_" + suffix);
+			if (m_ClusterBuffers[i]) m_Resources->DestroyBuffer("LightClusters_" + suffix);
+			m_LightBuffers[i] = nullptr;
+			m_ClusterBuffers[i] = nullptr;
+		}
+
+		// The lighting sets go back with the descriptor manager's pool
+		m_Active.fill(false);
+		m_CanCull = false;
+		m_Device = nullptr;
+	}
+
+	void LightClusterCuller::WriteLights(uint32_t frameIndex, const std::vector<LightData>& pointLights,
+		const LightClusterFrame& frame)
+	{
+		VulkanBuffer* buffer = m_LightBuffers[frameIndex];
+		auto* mapped = static_cast<uint8_t*>(buffer ? buffer->GetPersistentMappedPtr() : nullptr);
+		if (!mapped)
+			return;
+
+		const bool active = m_CanCull && frame.enabled && frame.renderExtent.width > 0 && frame.renderExtent.height > 0;
+		const uint32_t requested = static_cast<uint32_t>(pointLights.size());
+		const uint32_t sceneCount = active ? std::min(requested, MAX_LIGHTS) : 0;
+		const uint32_t fireflyCount = active ? std::min(frame.fireflyCount, MAX_LIGHTS - sceneCount) : 0;
+
+		// slice = log(depth) * scale + bias puts near at 0 and far at CLUSTERS_Z
+		const float nearPlane = std::max(frame.nearPlane, 0.001f);
+		const float farDistance = std::max(frame.farDistance, nearPlane * 2.0f);
+		const float sliceScale = static_cast<float>(CLUSTERS_Z) / std::log(farDistance / nearPlane);
+
+		static_assert(sizeof(Header) == HEADER_SIZE, "Must match light_clusters.glsl");
+		Header header{};
+		header.counts = glm::uvec4(sceneCount, fireflyCount, sceneCount + fireflyCount, active ? 1u : 0u);
+		header.grid = glm::vec4(
+			static_cast<float>(CLUSTERS_X) / static_cast<float>(std::max(frame.renderExtent.width, 1u)),
+			static_cast<float>(CLUSTERS_Y) / static_cast<float>(std::max(frame.renderExtent.height, 1u)),
+			sliceScale, -std::log(nearPlane) * sliceScale);
+		header.params = glm::vec4(nearPlane, farDistance, frame.fireflyRadius, frame.fireflyIntensity);
+
+		// The header changes with the firefly count and the viewport, the
+		// scene's lights far less often
+		if (memcmp(&m_UploadedHeaders[frameIndex], &header, sizeof(header)) != 0)
+		{
+			memcpy(mapped, &header, sizeof(header));
+			buffer->Flush(0, sizeof(header));
+			m_UploadedHeaders[frameIndex] = header;
+		}
+
+		const bool lightsCurrent = frame.pointLightsVersion != 0 &&
+			m_UploadedVersions[frameIndex] == frame.pointLightsVersion &&
+			m_UploadedLightCounts[frameIndex] >= sceneCount;
+		if (sceneCount > 0 && !lightsCurrent)
+		{
+			memcpy(mapped + sizeof(header), pointLights.data(), sizeof(LightData) * sceneCount);
+			buffer->Flush(sizeof(header), sizeof(LightData) * sceneCount);
+			m_UploadedVersions[frameIndex] = frame.pointLightsVersion;
+			m_UploadedLightCounts[frameIndex] = sceneCount;
+		}
+
+		m_FireflyCounts[frameIndex] = fireflyCount;
+		m_Active[frameIndex] = active;
+		m_SceneLightCount = sceneCount;
+		m_FireflyLightCount = fireflyCount;
+		m_DroppedLightCount = active ? (requested - sceneCount) + (frame.fireflyCount - fireflyCount) : 0;
+	}
+
+	void LightClusterCuller::Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex,
+		VkDescriptorSet frameSet, VkDescriptorSet lightingSet, VkDescriptorSet fireflySet)
+	{
+		if (!m_Active[frameIndex] || !dispatcher)
+			return;
+
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, frameSet);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 2, lightingSet);
+
+		const uint32_t fireflyCount = m_FireflyCounts[frameIndex];
+		if (fireflyCount > 0 && fireflySet != VK_NULL_HANDLE)
+		{
+			dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 1, fireflySet);
+			dispatcher->BindPipeline(cmd, m_GatherPipeline);
+			dispatcher->Dispatch(cmd, ComputeDispatcher::CalculateGroupCount(fireflyCount, CLUSTER_LOCAL_SIZE));
+
+			// Firefly lights -> the assign pass
+			dispatcher->ComputeToComputeBarrier(cmd, m_LightBuffers[frameIndex]->GetBuffer(), LIGHT_BUFFER_SIZE);
+		}
+
+		dispatcher->BindPipeline(cmd, m_AssignPipeline);
+		dispatcher->Dispatch(cmd, ComputeDispatcher::CalculateGroupCount(CLUSTER_COUNT, CLUSTER_LOCAL_SIZE));
+	}
+
+	VkBuffer LightClusterCuller::GetLightBuffer(uint32_t frameIndex) const
+	{
+		return m_LightBuffers[frameIndex] ? m_LightBuffers[frameIndex]->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkBuffer LightClusterCuller::GetClusterBuffer(uint32_t frameIndex) const
+	{
+		return m_ClusterBuffers[frameIndex] ? m_ClusterBuffers[frameIndex]->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkDeviceSize LightClusterCuller::GetLightBufferSize() const
+	{
+		return LIGHT_BUFFER_SIZE;
+	}
+
+	VkDeviceSize LightClusterCuller::GetClusterBufferSize() const
+	{
+		return CLUSTER_BUFFER_SIZE;
+	}
+
+	bool LightClusterCuller::CreatePipelines()
+	{
+		std::array<VkDescriptorSetLayout, 3> setLayouts = {
+			m_DescriptorManager->GetUniformSetLayout(),
+			m_DescriptorManager->GetFireflyStorageSetLayout(),
+			m_DescriptorManager->GetLightingSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		layoutInfo.pSetLayouts = setLayouts.data();
+		if (vkCreatePipelineLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("LightClusterCuller: failed to create pipeline layout");
+			return false;
+		}
+
+		m_GatherPipeline = CreatePipeline("LightClusterGather.comp.spv");
+		m_AssignPipeline = CreatePipeline("LightClusterAssign.comp.spv");
+		return m_GatherPipeline != VK_NULL_HANDLE && m_AssignPipeline != VK_NULL_HANDLE;
+	}
+
+	VkPipeline LightClusterCuller::CreatePipeline(const char* shaderName)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("LightClusterCuller: failed to load {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("LightClusterCuller: failed to create shader module for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("LightClusterCuller: failed to create compute pipeline for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, shaderName);
+		return pipeline;
+	}
+}
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+// LightClusterCuller.hpp
+//
+// Clustered (froxel) point lights, so the lit passes shade only the lights
+// that reach each fragment instead of looping over SceneLighting's 16. The
+// render region's view frustum is split into CLUSTERS_X x Y screen tiles and
+// CLUSTERS_Z depth slices, spaced exponentially from the near plane to
+// farDistance (the last slice runs on to infinity). Per frame:
+//   - WriteLights (CPU): the scene's point lights, uncapped up to
+//     MAX_LIGHTS, and a header with the grid parameters into the frame's
+//     light buffer (host-visible)
+//   - Dispatch, before the scene pass:
+//       LightClusterGather.comp appends one light per firefly agent after
+//       the scene's lights (when fireflies are running)
+//       LightClusterAssign.comp builds every cluster's light list: one
+//       invocation per cluster, lights streamed through shared memory in
+//       batches, sphere vs the cluster's view-space AABB
+//
+// Both buffers are bindings 1 and 2 of the frame's lighting set (set 2 of
+// Mesh, Terrain and Grass; light_clusters.glsl), so no pipeline layout
+// changes. A cluster keeps at most MAX_LIGHTS_PER_CLUSTER lights, which
+// bounds the per-fragment cost however many lights there are; past that,
+// the lights later in the buffer are dropped (fireflies before scene lights).
+//
+// With clustering off or unavailable the header says so and the shaders fall
+// back to SceneLighting's point lights. The reflection pass always does: the
+// clusters are built for the main camera.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/Light.hpp"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanBuffer;
+	class VulkanDescriptorManager;
+	class ResourceManager;
+	class ComputeDispatcher;
+
+	// Per-frame inputs of WriteLights
+	struct LightClusterFrame
+	{
+		bool enabled = true;              // false: shaders use SceneLighting's point lights
+		uint64_t pointLightsVersion = 0;  // changes with the point lights (0 = always upload)
+		VkExtent2D renderExtent = { 0, 0 };
+		float nearPlane = 0.1f;
+		float farDistance = 500.0f;       // depth the slices are spread over
+		uint32_t fireflyCount = 0;        // agents to gather (0 = none)
+		float fireflyRadius = 4.0f;       // world units, at full brightness
+		float fireflyIntensity = 1.5f;
+	};
+
+	class LightClusterCuller
+	{
+	public:
+		// Must match light_clusters.glsl
+		static constexpr uint32_t CLUSTERS_X = 16;
+		static constexpr uint32_t CLUSTERS_Y = 9;
+		static constexpr uint32_t CLUSTERS_Z = 24;
+		static constexpr uint32_t CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+		static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+		static constexpr uint32_t MAX_LIGHTS = 4096;  // scene + firefly lights per frame
+
+		LightClusterCuller() = default;
+		~LightClusterCuller() = default;
+
+		// Creates the per-frame buffers and points the lighting sets'
+		// bindings 1-2 at them. Missing compute pipelines only disable
+		// clustering (CanCull false); the buffers are always there.
+		bool Initialize(VulkanDevice* device, ResourceManager* resources,
+			VulkanDescriptorManager* descriptorManager);
+		void Cleanup();
+
+		bool CanCull() const { return m_CanCull; }
+		// Whether the frame's WriteLights turned clustered shading on (then
+		// Dispatch must run before the scene pass)
+		bool IsActive(uint32_t frameIndex) const { return m_Active[frameIndex]; }
+
+		// CPU, every frame, before the command buffer is submitted. With
+		// clustering off or unavailable only the header is written. The
+		// frame's buffer is only written where it changed: the header when
+		// it differs, the lights when pointLightsVersion does.
+		void WriteLights(uint32_t frameIndex, const std::vector<LightData>& pointLights, const LightClusterFrame& frame);
+
+		// Before the scene pass, when IsActive. frameSet/lightingSet: the
+		// frame's uniform and lighting sets; fireflySet: the agent storage
+		// set, or VK_NULL_HANDLE (then WriteLights must have been given no
+		// fireflies). The caller makes the cluster buffer visible to
+		// fragment shaders.
+		void Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex,
+			VkDescriptorSet frameSet, VkDescriptorSet lightingSet, VkDescriptorSet fireflySet);
+
+		VkBuffer GetLightBuffer(uint32_t frameIndex) const;
+		VkBuffer GetClusterBuffer(uint32_t frameIndex) const;
+		VkDeviceSize GetLightBufferSize() const;
+		VkDeviceSize GetClusterBufferSize() const;
+
+		// Last WriteLights' counts (stats)
+		uint32_t GetSceneLightCount() const { return m_SceneLightCount; }
+		uint32_t GetFireflyLightCount() const { return m_FireflyLightCount; }
+		uint32_t GetDroppedLightCount() const { return m_DroppedLightCount; }
+
+	private:
+		// Matches the header of ClusterLightBuffer in light_clusters.glsl
+		struct Header
+		{
+			glm::uvec4 counts;  // scene point lights, firefly lights, total, clustered shading on
+			glm::vec4  grid;    // clusters per pixel (x, y), slice scale, slice bias
+			glm::vec4  params;  // near, far, firefly radius, firefly intensity
+		};
+
+		bool CreatePipelines();
+		VkPipeline CreatePipeline(const char* shaderName);
+
+		VulkanDevice* m_Device = nullptr;
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_LightBuffers{};    // host-visible, owned by ResourceManager
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_ClusterBuffers{};  // GPU-only, owned by ResourceManager
+
+		// Set 0 = frame uniforms, 1 = firefly agents, 2 = lighting
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_GatherPipeline = VK_NULL_HANDLE;
+		VkPipeline m_AssignPipeline = VK_NULL_HANDLE;
+
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_FireflyCounts{};
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_Active{};
+		// What each frame's light buffer holds (mapped memory isn't read back)
+		std::array<Header, MAX_FRAMES_IN_FLIGHT> m_UploadedHeaders{};
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_UploadedVersions{};
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_UploadedLightCounts{};
+		uint32_t m_SceneLightCount = 0;
+		uint32_t m_FireflyLightCount = 0;
+		uint32_t m_DroppedLightCount = 0;
+		bool m_CanCull = false;
+
+		LightClusterCuller(const LightClusterCuller&) = delete;
+		LightClusterCuller& operator=(const LightClusterCuller&) = delete;
+	};
+}
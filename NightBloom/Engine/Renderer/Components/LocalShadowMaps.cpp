@@ -0,0 +1,418 @@
+//------------------------------------------------------------------------------
+// LocalShadowMaps.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/LocalShadowMaps.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr VkFormat ATLAS_FORMAT = VK_FORMAT_D32_SFLOAT;
+	}
+
+	bool LocalShadowMaps::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, ResourceManager* resources)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_Resources = resources;
+
+		if (!CreateAtlas() || !CreateRenderPass())
+			return false;
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_RenderPass;
+		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.pAttachments = &m_View;
+		framebufferInfo.width = ATLAS_SIZE;
+		framebufferInfo.height = ATLAS_SIZE;
+		framebufferInfo.layers = 1;
+		if (vkCreateFramebuffer(m_Device->GetDevice(), &framebufferInfo, nullptr, &m_Framebuffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("LocalShadowMaps: failed to create the atlas framebuffer");
+			return false;
+		}
+
+		// Hardware 2x2 PCF; the shader keeps its taps inside the face's tile
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.maxAnisotropy = 1.0f;
+		samplerInfo.maxLod = 1.0f;
+		samplerInfo.compareEnable = VK_TRUE;
+		samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_Sampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("LocalShadowMaps: failed to create the atlas sampler");
+			return false;
+		}
+
+		LOG_INFO("LocalShadowMaps initialized ({0}x{0} atlas, {1} lights max)", ATLAS_SIZE, MAX_LOCAL_SHADOWS);
+		return true;
+	}
+
+	void LocalShadowMaps::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Framebuffer != VK_NULL_HANDLE)
+			vkDestroyFramebuffer(device, m_Framebuffer, nullptr);
+		if (m_RenderPass != VK_NULL_HANDLE)
+			vkDestroyRenderPass(device, m_RenderPass, nullptr);
+		if (m_View != VK_NULL_HANDLE)
+			vkDestroyImageView(device, m_View, nullptr);
+		m_MemoryManager->DestroyImage(m_Allocation);
+
+		m_Framebuffer = VK_NULL_HANDLE;
+		m_RenderPass = VK_NULL_HANDLE;
+		m_View = VK_NULL_HANDLE;
+		m_Image = VK_NULL_HANDLE;
+		m_Allocation = nullptr;
+		m_Sampler = VK_NULL_HANDLE;   // the sampler cache's
+		m_Device = nullptr;
+	}
+
+	void LocalShadowMaps::AssignLights(const std::vector<LightData>& pointLights, const LocalShadowSettings& settings,
+		const glm::mat4& view, const glm::mat4& proj, float viewportHeight, std::vector<LightData>& out)
+	{
+		// The bias only changes how the faces are read
+		LocalShadowSettings drawn = settings;
+		drawn.normalBias = m_Settings.normalBias;
+		if (m_HasSettings && !(drawn == m_Settings))
+			m_Atlas.Invalidate();
+		m_Settings = settings;
+		m_HasSettings = true;
+
+		const Frustum frustum = Frustum::ExtractFromMatrix(proj * view);
+		m_Requests.clear();
+		for (const LightData& light : pointLights)
+		{
+			if (!settings.enabled || !LocalShadowAtlas::WantsShadow(light))
+				continue;
+
+			const float diameter = LocalShadowAtlas::ScreenDiameter(glm::vec3(light.position), light.attenuation.w,
+				view, proj[1][1], viewportHeight, frustum);
+			m_Requests.push_back({ LocalShadowAtlas::LightKey(light), diameter * settings.tileScale });
+		}
+		m_Atlas.Assign(m_Requests, settings, m_RequestSlots);
+
+		out.resize(pointLights.size());
+		m_SlotLights = {};
+		size_t request = 0;
+		for (size_t i = 0; i < pointLights.size(); ++i)
+		{
+			const LightData& light = pointLights[i];
+			int32_t slot = -1;
+			if (settings.enabled && LocalShadowAtlas::WantsShadow(light))
+				slot = m_RequestSlots[request++];
+
+			out[i] = light.position.w > 0.5f ? LocalShadowAtlas::EncodeLight(light, slot) : light;
+			if (slot >= 0)
+				m_SlotLights[slot] = { glm::vec3(light.position), light.attenuation.w };
+		}
+	}
+
+	int32_t LocalShadowMaps::FindSlot(uint64_t key) const
+	{
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			const LocalShadowSlot& entry = m_Atlas.GetSlot(slot);
+			if (entry.active && entry.key == key)
+				return static_cast<int32_t>(slot);
+		}
+		return -1;
+	}
+
+	void LocalShadowMaps::FillUniforms(LocalShadowUniforms& out) const
+	{
+		std::vector<LightData> lights;
+		std::vector<int32_t> slots;
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			if (!m_Atlas.GetSlot(slot).active)
+				continue;
+
+			LightData light;
+			light.position = glm::vec4(m_SlotLights[slot].position, 1.0f);
+			light.attenuation.w = m_SlotLights[slot].radius;
+			lights.push_back(light);
+			slots.push_back(static_cast<int32_t>(slot));
+		}
+		m_Atlas.FillUniforms(lights, slots, m_Settings, out);
+	}
+
+	uint32_t LocalShadowMaps::GetShadowedLightCount() const
+	{
+		uint32_t count = 0;
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+			count += m_Atlas.GetSlot(slot).active ? 1u : 0u;
+		return count;
+	}
+
+	void LocalShadowMaps::BeginCasters()
+	{
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			// The light itself: a slot handed to another light starts over
+			m_Signatures[slot] = SignatureHash();
+			m_Signatures[slot].Mix(m_Atlas.GetSlot(slot).key);
+			m_Volatile[slot] = false;
+		}
+	}
+
+	void LocalShadowMaps::AddCaster(const DrawCommand& draw)
+	{
+		if (!draw.vertexBuffer || !draw.indexBuffer || draw.indexCount == 0 || draw.indirectBuffer)
+			return;
+
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			if (!m_Atlas.GetSlot(slot).active)
+				continue;
+			// Unbounded draws may be anywhere
+			const glm::vec4 sphere(m_SlotLights[slot].position, m_SlotLights[slot].radius);
+			if (draw.hasBounds && !LocalShadowAtlas::BoxTouchesSphere(draw.bounds.center, draw.bounds.extents, sphere))
+				continue;
+
+			// Skinned vertices move without anything here changing
+			if (draw.skinVertexCount > 0)
+				m_Volatile[slot] = true;
+
+			SignatureHash& hash = m_Signatures[slot];
+			hash.Mix(static_cast<VulkanBuffer*>(draw.vertexBuffer)->GetBuffer());
+			hash.Mix(static_cast<VulkanBuffer*>(draw.indexBuffer)->GetBuffer());
+			hash.Mix(draw.firstIndex);
+			hash.Mix(draw.indexCount);
+			hash.Mix(draw.vertexOffset);
+			hash.Mix(draw.vertexFormat);
+			hash.Mix(draw.instanceCount);
+			if (draw.instanceData)
+			{
+				const auto* instances = static_cast<const InstanceData*>(draw.instanceData);
+				for (uint32_t i = 0; i < draw.instanceCount; ++i)
+					hash.Mix(instances[i].model);
+			}
+			else if (draw.hasPushConstants)
+			{
+				hash.Mix(draw.pushConstants.model);
+			}
+		}
+	}
+
+	void LocalShadowMaps::EndCasters()
+	{
+		m_DirtyMask = 0;
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			const bool cache = m_Settings.cacheStatic && !m_Volatile[slot];
+			if (m_Atlas.NeedsRender(slot, m_Signatures[slot].Get(), cache))
+				m_DirtyMask |= 1u << slot;
+		}
+	}
+
+	void LocalShadowMaps::Record(VkCommandBuffer cmd, const FaceRecorder& recordFace)
+	{
+		m_LastRenderedFaces = 0;
+		if (m_DirtyMask == 0)
+			return;
+
+		VkRenderPassBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		beginInfo.renderPass = m_RenderPass;
+		beginInfo.framebuffer = m_Framebuffer;
+		beginInfo.renderArea.extent = { ATLAS_SIZE, ATLAS_SIZE };
+		vkCmdBeginRenderPass(cmd, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			if ((m_DirtyMask & (1u << slot)) == 0)
+				continue;
+
+			const LocalShadowSlot& entry = m_Atlas.GetSlot(slot);
+			const SlotLight& light = m_SlotLights[slot];
+			const glm::vec4 sphere(light.position, light.radius);
+			for (uint32_t face = 0; face < LOCAL_SHADOW_FACES; ++face)
+			{
+				const LocalShadowTile& tile = entry.faces[face];
+
+				VkViewport viewport{};
+				viewport.x = static_cast<float>(tile.x);
+				viewport.y = static_cast<float>(tile.y);
+				viewport.width = static_cast<float>(tile.size);
+				viewport.height = static_cast<float>(tile.size);
+				viewport.minDepth = 0.0f;
+				viewport.maxDepth = 1.0f;
+				vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+				VkRect2D scissor{};
+				scissor.offset = { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) };
+				scissor.extent = { tile.size, tile.size };
+				vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+				VkClearAttachment clear{};
+				clear.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+				clear.clearValue.depthStencil = { 1.0f, 0 };
+				VkClearRect clearRect{};
+				clearRect.rect = scissor;
+				clearRect.layerCount = 1;
+				vkCmdClearAttachments(cmd, 1, &clear, 1, &clearRect);
+
+				const glm::mat4 viewProj = LocalShadowAtlas::FaceViewProj(light.position, light.radius, face,
+					m_Settings.nearPlane);
+				recordFace(cmd, viewProj, Frustum::ExtractFromMatrix(viewProj), sphere);
+				++m_LastRenderedFaces;
+			}
+			m_Atlas.MarkRendered(slot, m_Signatures[slot].Get());
+		}
+
+		vkCmdEndRenderPass(cmd);
+		m_DirtyMask = 0;
+	}
+
+	bool LocalShadowMaps::CreateAtlas()
+	{
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = ATLAS_SIZE;
+		imageInfo.height = ATLAS_SIZE;
+		imageInfo.depth = 1;
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = ATLAS_FORMAT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT;   // the initial clear
+		imageInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.category = GpuMemoryCategory::Shadow;
+		imageInfo.debugName = "LocalShadowAtlas";
+
+		m_Allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!m_Allocation)
+		{
+			LOG_ERROR("LocalShadowMaps: failed to create the {0}x{0} atlas", ATLAS_SIZE);
+			return false;
+		}
+		m_Image = m_Allocation->image;
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_Image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = ATLAS_FORMAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(m_Device->GetDevice(), &viewInfo, nullptr, &m_View) != VK_SUCCESS)
+		{
+			LOG_ERROR("LocalShadowMaps: failed to create the atlas view");
+			return false;
+		}
+
+		// Cleared to the far plane and left readable: the scene samples it
+		// from the first frame, before any light has drawn into it
+		VulkanSingleTimeCommand single(m_Device, m_Resources->GetTransferCommandPool());
+		VkCommandBuffer cmd = single.Begin();
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_Image;
+		barrier.subresourceRange = viewInfo.subresourceRange;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkClearDepthStencilValue clear = { 1.0f, 0 };
+		vkCmdClearDepthStencilImage(cmd, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear, 1,
+			&viewInfo.subresourceRange);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		single.End();
+
+		return true;
+	}
+
+	bool LocalShadowMaps::CreateRenderPass()
+	{
+		// Loads what's there: only the dirty faces are cleared and redrawn
+		VkAttachmentDescription depthAttachment{};
+		depthAttachment.format = ATLAS_FORMAT;
+		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkAttachmentReference depthRef{};
+		depthRef.attachment = 0;
+		depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.pDepthStencilAttachment = &depthRef;
+
+		// The previous frame's lit passes read it; this frame's read it next
+		VkSubpassDependency dependencies[2]{};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = 1;
+		renderPassInfo.pAttachments = &depthAttachment;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = 2;
+		renderPassInfo.pDependencies = dependencies;
+
+		if (vkCreateRenderPass(m_Device->GetDevice(), &renderPassInfo, nullptr, &m_RenderPass) != VK_SUCCESS)
+		{
+			LOG_ERROR("LocalShadowMaps: failed to create the atlas render pass");
+			return false;
+		}
+		VulkanDebugMarkers::SetName(m_Device->GetDevice(), VK_OBJECT_TYPE_RENDER_PASS,
+			reinterpret_cast<uint64_t>(m_RenderPass), "LocalShadowAtlas");
+		return true;
+	}
+}
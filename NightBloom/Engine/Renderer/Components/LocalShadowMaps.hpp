@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// LocalShadowMaps.hpp
+//
+// The point light shadow atlas (LocalShadowAtlas.hpp) on the GPU: one D32
+// image at set 3 binding 2, always kept in SHADER_READ_ONLY_OPTIMAL, and a
+// depth-only render pass that loads it, so faces left alone keep their
+// depth from the frame that last drew them. Only faces whose casters
+// changed are redrawn; each is cleared and drawn with the viewport on its
+// tile.
+//
+// Per frame: AssignLights in BeginFrame (before the lighting and cluster
+// uploads, which carry the slots), then BeginCasters / AddCaster / EndCasters
+// over the draw list before it is batched, then Record if HasWork.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/LocalShadowAtlas.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class ResourceManager;
+	struct DrawCommand;
+
+	class LocalShadowMaps
+	{
+	public:
+		static constexpr uint32_t ATLAS_SIZE = 4096;
+
+		// Draws a face's casters: inside the render pass, viewport and
+		// scissor on the face's tile. faceViewProj goes in the push block.
+		using FaceRecorder = std::function<void(VkCommandBuffer cmd, const glm::mat4& faceViewProj,
+			const Frustum& faceFrustum, const glm::vec4& lightSphere)>;
+
+		LocalShadowMaps() = default;
+		~LocalShadowMaps() = default;
+
+		// Creates the atlas (cleared to the far plane) and its render pass
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, ResourceManager* resources);
+		void Cleanup();
+
+		// Picks the frame's shadowed lights from pointLights (those asking
+		// for one, LocalShadowAtlas::WantsShadow) and fills out with the
+		// lights as the shaders see them (EncodeLight). Settings that change
+		// how the faces render redraw every slot.
+		void AssignLights(const std::vector<LightData>& pointLights, const LocalShadowSettings& settings,
+			const glm::mat4& view, const glm::mat4& proj, float viewportHeight, std::vector<LightData>& out);
+		// The slot a light (by LocalShadowAtlas::LightKey) was given, or -1
+		int32_t FindSlot(uint64_t key) const;
+		void FillUniforms(LocalShadowUniforms& out) const;
+
+		// Before the draw list is batched: each slot hashes the casters that
+		// reach into its light's radius, and the ones whose hash changed are
+		// redrawn this frame
+		void BeginCasters();
+		void AddCaster(const DrawCommand& draw);
+		void EndCasters();
+		bool HasWork() const { return m_DirtyMask != 0; }
+
+		// Outside any render pass: redraws the dirty slots' faces
+		void Record(VkCommandBuffer cmd, const FaceRecorder& recordFace);
+
+		VkImage GetAtlasImage() const { return m_Image; }
+		VkImageView GetAtlasView() const { return m_View; }
+		VkSampler GetSampler() const { return m_Sampler; }
+		VkRenderPass GetRenderPass() const { return m_RenderPass; }
+		uint32_t GetShadowedLightCount() const;
+		uint32_t GetLastRenderedFaces() const { return m_LastRenderedFaces; }
+
+	private:
+		bool CreateAtlas();
+		bool CreateRenderPass();
+
+		struct SlotLight
+		{
+			glm::vec3 position = glm::vec3(0.0f);
+			float radius = 0.0f;
+		};
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		ResourceManager* m_Resources = nullptr;
+
+		VulkanMemoryManager::ImageAllocation* m_Allocation = nullptr;
+		VkImage m_Image = VK_NULL_HANDLE;
+		VkImageView m_View = VK_NULL_HANDLE;
+		VkSampler m_Sampler = VK_NULL_HANDLE;
+		VkRenderPass m_RenderPass = VK_NULL_HANDLE;
+		VkFramebuffer m_Framebuffer = VK_NULL_HANDLE;
+
+		LocalShadowAtlas m_Atlas{ ATLAS_SIZE };
+		LocalShadowSettings m_Settings;
+		bool m_HasSettings = false;
+		std::vector<LocalShadowRequest> m_Requests;   // scratch
+		std::vector<int32_t> m_RequestSlots;          // scratch
+		std::array<SlotLight, MAX_LOCAL_SHADOWS> m_SlotLights{};
+		std::array<SignatureHash, MAX_LOCAL_SHADOWS> m_Signatures{};
+		std::array<bool, MAX_LOCAL_SHADOWS> m_Volatile{};   // a caster changes every frame (skinned)
+		uint32_t m_DirtyMask = 0;
+		uint32_t m_LastRenderedFaces = 0;
+
+		LocalShadowMaps(const LocalShadowMaps&) = delete;
+		LocalShadowMaps& operator=(const LocalShadowMaps&) = delete;
+	};
+}
@@ -0,0 +1,315 @@
+//------------------------------------------------------------------------------
+// MeshletCuller.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/MeshletCuller.hpp"
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/ShaderVariant.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMeshArena.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <string>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Matches the JobBuffer header in MeshletCull.comp
+		struct MeshletCullHeader
+		{
+			glm::vec4 frustum[5];  // inward planes (Frustum::ExtractFromMatrix)
+		};
+
+		// Matches CullParams in MeshletCull.comp
+		struct MeshletCullPushConstants
+		{
+			glm::mat4 viewProj;  // matrix the pyramid was built with
+			glm::vec4 pyramid;
+			glm::uvec4 counts;
+		};
+		static_assert(sizeof(MeshletCullPushConstants) == 96, "Must match MeshletCull.comp");
+		static_assert(sizeof(MeshletCullJob) == 112, "Must match MeshletCull.comp");
+		static_assert(sizeof(MeshletCullHeader) == 80, "Must match MeshletCull.comp");
+
+		constexpr VkDeviceSize JOB_BUFFER_SIZE =
+			sizeof(MeshletCullHeader) + sizeof(MeshletCullJob) * MeshletCuller::MAX_MESHLET_JOBS;
+		constexpr VkDeviceSize DRAW_BUFFER_SIZE =
+			sizeof(VkDrawIndexedIndirectCommand) * MeshletCuller::MAX_MESHLET_DRAWS;
+		constexpr VkDeviceSize COUNT_BUFFER_SIZE = sizeof(uint32_t) * MeshletCuller::MAX_MESHLET_JOBS;
+	}
+
+	bool MeshletCuller::Initialize(VulkanDevice* device, ResourceManager* resources,
+		VulkanDescriptorManager* descriptorManager, VulkanMeshArena* meshArena, OcclusionCuller* occlusion)
+	{
+		m_Device = device;
+		m_Resources = resources;
+		m_DescriptorManager = descriptorManager;
+		m_MeshArena = meshArena;
+		m_Occlusion = occlusion;
+		if (!m_MeshArena || !m_Occlusion)
+			return false;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			const std::string suffix = std::to_string(i);
+			m_JobBuffers[i] = m_Resources->CreateStorageBuffer("MeshletJobs_" + suffix, JOB_BUFFER_SIZE, true);
+			m_DrawBuffers[i] = m_Resources->CreateIndirectBuffer("MeshletDraws_" + suffix, DRAW_BUFFER_SIZE);
+			m_CountBuffers[i] = m_Resources->CreateIndirectBuffer("MeshletDrawCounts_" + suffix, COUNT_BUFFER_SIZE);
+			if (!m_JobBuffers[i] || !m_DrawBuffers[i] || !m_CountBuffers[i])
+			{
+				LOG_ERROR("MeshletCuller: failed to create job/draw buffers");
+				return false;
+			}
+
+			// The job set's meshlet binding is filled in once a model has
+			// meshlets (WriteJobs)
+			m_JobSets[i] = m_DescriptorManager->AllocateComputeStorageSet();
+			m_DrawSets[i] = m_DescriptorManager->AllocateComputeStorageSet();
+			if (m_JobSets[i] == VK_NULL_HANDLE || m_DrawSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("MeshletCuller: failed to allocate descriptor sets");
+				return false;
+			}
+			m_DescriptorManager->UpdateComputeStorageSet(m_DrawSets[i],
+				m_DrawBuffers[i]->GetBuffer(), DRAW_BUFFER_SIZE,
+				m_CountBuffers[i]->GetBuffer(), COUNT_BUFFER_SIZE);
+		}
+
+		if (!CreatePipeline())
+			return false;
+
+		LOG_INFO("MeshletCuller initialized ({} jobs, {} meshlet draws per frame)", MAX_MESHLET_JOBS, MAX_MESHLET_DRAWS);
+		return true;
+	}
+
+	void MeshletCuller::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (m_Resources)
+			{
+				const std::string suffix = std::to_string(i);
+				if (m_JobBuffers[i])
+					m_Resources->DestroyBuffer("MeshletJobs_" + suffix);
+				if (m_DrawBuffers[i])
+					m_Resources->DestroyBuffer("MeshletDraws_" + suffix);
+				if (m_CountBuffers[i])
+					m_Resources->DestroyBuffer("MeshletDrawCounts_" + suffix);
+			}
+			m_JobBuffers[i] = nullptr;
+			m_DrawBuffers[i] = nullptr;
+			m_CountBuffers[i] = nullptr;
+			m_BoundMeshletBuffers[i] = VK_NULL_HANDLE;
+			m_JobCounts[i] = 0;
+		}
+
+		m_Device = nullptr;
+	}
+
+	bool MeshletCuller::CreatePipeline()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkDescriptorSetLayout setLayouts[3] = {
+			m_DescriptorManager->GetComputeStorageSetLayout(),
+			m_DescriptorManager->GetHiZSampleSetLayout(),
+			m_DescriptorManager->GetComputeStorageSetLayout()
+		};
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(MeshletCullPushConstants);
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 3;
+		layoutInfo.pSetLayouts = setLayouts;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("MeshletCuller: failed to create pipeline layout");
+			return false;
+		}
+
+		const std::string shaderName = SelectSubgroupShader("MeshletCull.comp.spv", m_Device->SupportsFeature("subgroup_ops"));
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("MeshletCuller: failed to load {}", shaderName);
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("MeshletCuller: failed to create shader module for {}", shaderName);
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("MeshletCuller: failed to create compute pipeline for {}", shaderName);
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, shaderName.c_str());
+		return true;
+	}
+
+	uint32_t MeshletCuller::WriteJobs(uint32_t frameIndex, DrawList& drawList, const glm::vec3& cameraPosition,
+		const glm::mat4& viewProj)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		m_JobCounts[frame] = 0;
+		m_LastJobCount = 0;
+		m_LastMeshletCount = 0;
+
+		Buffer* meshletBuffer = m_MeshArena ? m_MeshArena->GetMeshletBuffer() : nullptr;
+		auto* mapped = m_JobBuffers[frame] ? static_cast<uint8_t*>(m_JobBuffers[frame]->GetPersistentMappedPtr()) : nullptr;
+		if (!m_Enabled || !meshletBuffer || !mapped)
+		{
+			for (size_t i = 0; i < drawList.GetCommandCount(); ++i)
+				drawList.GetCommandMutable(i).meshletJob = DrawCommand::NO_MESHLET_JOB;
+			return 0;
+		}
+
+		// The first meshlet page only appears with the first model that has
+		// meshlets (and is recreated if an oversized one was released)
+		VulkanBuffer* vkMeshlets = static_cast<VulkanBuffer*>(meshletBuffer);
+		if (m_BoundMeshletBuffers[frame] != vkMeshlets->GetBuffer())
+		{
+			m_DescriptorManager->UpdateComputeStorageSet(m_JobSets[frame],
+				m_JobBuffers[frame]->GetBuffer(), JOB_BUFFER_SIZE,
+				vkMeshlets->GetBuffer(), vkMeshlets->GetSize());
+			m_BoundMeshletBuffers[frame] = vkMeshlets->GetBuffer();
+		}
+
+		auto* header = reinterpret_cast<MeshletCullHeader*>(mapped);
+		const Frustum frustum = Frustum::ExtractFromMatrix(viewProj);
+		std::copy(std::begin(frustum.planes), std::end(frustum.planes), header->frustum);
+		auto* jobs = reinterpret_cast<MeshletCullJob*>(mapped + sizeof(MeshletCullHeader));
+
+		uint32_t count = 0;
+		uint32_t drawBase = 0;
+		for (size_t i = 0; i < drawList.GetCommandCount(); ++i)
+		{
+			DrawCommand& cmd = drawList.GetCommandMutable(i);
+			cmd.meshletJob = DrawCommand::NO_MESHLET_JOB;
+
+			// One instance only: the job's camera and spheres use a single
+			// transform. Merged instances keep the whole-mesh path.
+			if (cmd.pipeline != PipelineType::Mesh || !cmd.cameraVisible || cmd.meshletCount == 0 ||
+				cmd.instanceCount != 1 || cmd.indirectBuffer || cmd.instanceData || !cmd.hasPushConstants)
+				continue;
+			if (count >= MAX_MESHLET_JOBS || drawBase + cmd.meshletCount > MAX_MESHLET_DRAWS)
+				continue;
+
+			// A mirroring transform flips the winding the cones were built for
+			const glm::mat4& model = cmd.pushConstants.model;
+			if (glm::determinant(glm::mat3(model)) <= 0.0f)
+				continue;
+
+			const float scale = std::max({ glm::length(glm::vec3(model[0])),
+				glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+			const glm::vec3 localCamera = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+
+			MeshletCullJob& job = jobs[count];
+			job.model = model;
+			job.camera = glm::vec4(localCamera, scale);
+			job.meshlets = glm::uvec4(cmd.firstMeshlet, cmd.meshletCount, drawBase, cmd.firstInstance);
+			job.range = glm::uvec4(cmd.firstIndex, static_cast<uint32_t>(cmd.vertexOffset), 0u, 0u);
+
+			cmd.meshletJob = count++;
+			cmd.meshletDrawBase = drawBase;
+			drawBase += cmd.meshletCount;
+		}
+
+		if (count > 0)
+			m_JobBuffers[frame]->Flush(0, sizeof(MeshletCullHeader) + sizeof(MeshletCullJob) * count);
+
+		m_JobCounts[frame] = count;
+		m_LastJobCount = count;
+		m_LastMeshletCount = drawBase;
+		return count;
+	}
+
+	bool MeshletCuller::Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		const uint32_t count = m_JobCounts[frame];
+		if (count == 0 || !dispatcher || m_Pipeline == VK_NULL_HANDLE)
+			return false;
+
+		// Zero this frame's counters, then make the clear visible to the atomics
+		const VkBuffer counts = m_CountBuffers[frame]->GetBuffer();
+		vkCmdFillBuffer(cmd, counts, 0, sizeof(uint32_t) * count, 0);
+		dispatcher->TransferToComputeBarrier(cmd, counts, COUNT_BUFFER_SIZE);
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, m_JobSets[frame]);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 1, m_Occlusion->GetPyramidSampleSet());
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 2, m_DrawSets[frame]);
+
+		MeshletCullPushConstants push{};
+		push.viewProj = m_Occlusion->GetPyramidViewProjection();
+		push.pyramid = m_Occlusion->GetPyramidParams();
+		push.counts = glm::uvec4(count, 0u, 0u, 0u);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+
+		// One workgroup per job
+		dispatcher->Dispatch(cmd, count);
+		return true;
+	}
+
+	VkBuffer MeshletCuller::GetDrawBuffer(uint32_t frameIndex) const
+	{
+		VulkanBuffer* buffer = m_DrawBuffers[frameIndex % MAX_FRAMES_IN_FLIGHT];
+		return buffer ? buffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkBuffer MeshletCuller::GetCountBuffer(uint32_t frameIndex) const
+	{
+		VulkanBuffer* buffer = m_CountBuffers[frameIndex % MAX_FRAMES_IN_FLIGHT];
+		return buffer ? buffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+}
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+// MeshletCuller.hpp
+//
+// Per-meshlet culling for dense model meshes (Meshlet.hpp). WriteJobs turns
+// every camera-visible, single-instance Mesh draw whose mesh has meshlets
+// into a job; Dispatch (MeshletCull.comp) runs one workgroup per job that
+// tests each meshlet's bounding sphere against the camera frustum, its
+// normal cone against the camera position and its sphere against
+// OcclusionCuller's Hi-Z pyramid, and appends a VkDrawIndexedIndirectCommand
+// for every survivor to the job's range of the draw buffer. The main color
+// pass then draws each job with vkCmdDrawIndexedIndirectCount (the job's
+// counter), so a half-hidden or half-turned-away mesh only rasterizes the
+// clusters that can be seen. Shadow and reflection passes keep the whole
+// mesh - the cone and pyramid only hold for the main camera.
+//
+// This is the compute path for meshlet culling: it needs drawIndirectCount
+// but no mesh shading, and keeps the regular vertex pipelines.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/FrameConfig.hpp"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanBuffer;
+	class VulkanDescriptorManager;
+	class VulkanMeshArena;
+	class ResourceManager;
+	class ComputeDispatcher;
+	class OcclusionCuller;
+	class DrawList;
+
+	// Matches MeshletJob in MeshletCull.comp (std430, 112 bytes)
+	struct MeshletCullJob
+	{
+		glm::mat4  model;     // vertex buffer space -> world (the draw's model matrix)
+		glm::vec4  camera;    // xyz = camera in vertex buffer space, w = model's largest axis scale
+		glm::uvec4 meshlets;  // firstMeshlet, meshletCount, drawBase, firstInstance
+		glm::uvec4 range;     // firstIndex, vertexOffset (int bits), unused
+	};
+
+	class MeshletCuller
+	{
+	public:
+		static constexpr uint32_t MAX_MESHLET_JOBS = 1024;        // per frame
+		static constexpr uint32_t MAX_MESHLET_DRAWS = 1u << 16;   // per frame, over all jobs
+
+		MeshletCuller() = default;
+		~MeshletCuller() = default;
+
+		// occlusion provides the Hi-Z pyramid and must outlive this
+		bool Initialize(VulkanDevice* device, ResourceManager* resources, VulkanDescriptorManager* descriptorManager,
+			VulkanMeshArena* meshArena, OcclusionCuller* occlusion);
+		void Cleanup();
+
+		// CPU side, once the frame's draw list is final (after instance
+		// batching) and before OcclusionCuller::WriteMeshCandidates, which
+		// leaves the commands given a job to this pass. Returns the job count.
+		uint32_t WriteJobs(uint32_t frameIndex, DrawList& drawList, const glm::vec3& cameraPosition,
+			const glm::mat4& viewProj);
+
+		// Compute pass, before the scene pass. Returns true if it dispatched.
+		bool Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
+
+		VkBuffer GetDrawBuffer(uint32_t frameIndex) const;
+		VkBuffer GetCountBuffer(uint32_t frameIndex) const;
+
+		void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		bool IsEnabled() const { return m_Enabled; }
+		uint32_t GetLastJobCount() const { return m_LastJobCount; }
+		uint32_t GetLastMeshletCount() const { return m_LastMeshletCount; }
+
+	private:
+		bool CreatePipeline();
+
+		VulkanDevice* m_Device = nullptr;
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+		VulkanMeshArena* m_MeshArena = nullptr;
+		OcclusionCuller* m_Occlusion = nullptr;
+
+		// Set 0 = jobs/meshlets, set 1 = pyramid, set 2 = draws/counts
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_JobBuffers{};    // host-visible, owned by ResourceManager
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_DrawBuffers{};   // GPU-only indirect, owned by ResourceManager
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_CountBuffers{};  // one counter per job
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_JobSets{};
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_DrawSets{};
+		std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_BoundMeshletBuffers{};  // what m_JobSets points at
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_JobCounts{};
+
+		bool m_Enabled = true;
+		uint32_t m_LastJobCount = 0;
+		uint32_t m_LastMeshletCount = 0;
+
+		MeshletCuller(const MeshletCuller&) = delete;
+		MeshletCuller& operator=(const MeshletCuller&) = delete;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+// MipGenerator.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/MipGenerator.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <vector>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t BLOCK_SIZE = 64;   // mip 0 texels per workgroup side, MipDownsample.comp
+
+		// Matches MipDownsampleParams in MipDownsample.comp
+		struct MipDownsamplePushConstants
+		{
+			int32_t width;
+			int32_t height;
+			int32_t mipCount;
+			int32_t groupCount;
+		};
+		static_assert(sizeof(MipDownsamplePushConstants) == 16, "Must match MipDownsample.comp");
+	}
+
+	MipGenerator::~MipGenerator()
+	{
+		Cleanup();
+	}
+
+	bool MipGenerator::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager)
+	{
+		m_Device = device;
+		m_DescriptorManager = descriptorManager;
+
+		// Host-visible so it can start at zero without an upload; it is only
+		// ever touched by one atomic per workgroup
+		const uint32_t zero = 0;
+		BufferDesc desc;
+		desc.usage = BufferUsage::Storage;
+		desc.memoryAccess = MemoryAccess::CpuToGpu;
+		desc.size = sizeof(uint32_t);
+		desc.initialData = &zero;
+		desc.initialDataSize = sizeof(zero);
+		desc.debugName = "MipGeneratorCounter";
+
+		m_CounterBuffer = new VulkanBuffer(m_Device, memoryManager);
+		if (!m_CounterBuffer->Initialize(desc))
+		{
+			LOG_ERROR("MipGenerator: failed to create the workgroup counter");
+			Cleanup();
+			return false;
+		}
+
+		if (!CreatePipeline())
+		{
+			Cleanup();
+			return false;
+		}
+
+		LOG_INFO("MipGenerator initialized");
+		return true;
+	}
+
+	void MipGenerator::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+
+		delete m_CounterBuffer;
+		m_CounterBuffer = nullptr;
+		m_Device = nullptr;
+	}
+
+	bool MipGenerator::CreatePipeline()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(MipDownsamplePushConstants);
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetMipDownsampleSetLayout();
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &setLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("MipGenerator: failed to create pipeline layout");
+			return false;
+		}
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary("MipDownsample.comp.spv");
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("MipGenerator: failed to load MipDownsample.comp.spv");
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("MipGenerator: failed to create shader module");
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("MipGenerator: failed to create compute pipeline");
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, "MipDownsample.comp.spv");
+		return true;
+	}
+
+	bool MipGenerator::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VulkanTexture* texture)
+	{
+		if (!dispatcher || !texture || m_Pipeline == VK_NULL_HANDLE)
+			return false;
+
+		const uint32_t mipCount = texture->GetMipLevels();
+		if (mipCount < 2)
+			return true;   // nothing below mip 0
+
+		if (texture->GetFormat() != TextureFormat::RGBA32F || texture->GetMipStorageView(0) == VK_NULL_HANDLE ||
+			texture->GetWidth() > MAX_SIZE || texture->GetHeight() > MAX_SIZE)
+		{
+			LOG_ERROR("MipGenerator: needs a mipped 2D RGBA32F storage texture of at most {0}x{0} (got {1}x{2})",
+				MAX_SIZE, texture->GetWidth(), texture->GetHeight());
+			return false;
+		}
+
+		VkDescriptorSet set = m_DescriptorManager->AllocateTransientSet(m_DescriptorManager->GetMipDownsampleSetLayout());
+		if (set == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("MipGenerator: failed to allocate descriptor set");
+			return false;
+		}
+
+		std::vector<VkImageView> mipViews;
+		for (uint32_t mip = 0; mip < mipCount; ++mip)
+			mipViews.push_back(texture->GetMipStorageView(mip));
+		m_DescriptorManager->UpdateMipDownsampleSet(set, mipViews, m_CounterBuffer->GetBuffer());
+
+		const uint32_t groupsX = ComputeDispatcher::CalculateGroupCount(texture->GetWidth(), BLOCK_SIZE);
+		const uint32_t groupsY = ComputeDispatcher::CalculateGroupCount(texture->GetHeight(), BLOCK_SIZE);
+
+		MipDownsamplePushConstants push{};
+		push.width = static_cast<int32_t>(texture->GetWidth());
+		push.height = static_cast<int32_t>(texture->GetHeight());
+		push.mipCount = static_cast<int32_t>(mipCount);
+		push.groupCount = static_cast<int32_t>(groupsX * groupsY);
+
+		// The previous dispatch's last group rearmed the counter
+		dispatcher->ComputeToComputeBarrier(cmd, m_CounterBuffer->GetBuffer(), VK_WHOLE_SIZE);
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, set);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd, groupsX, groupsY);
+		return true;
+	}
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// MipGenerator.hpp
+//
+// Fills a runtime-written texture's mip chain from mip 0 with one compute
+// dispatch (MipDownsample.comp) instead of a vkCmdBlitImage per level with
+// a barrier between each. For images produced on the GPU after load - the
+// noise previews - where there is no cooked chain to upload.
+//
+// Targets are 2D RGBA32F textures created with TextureUsage::Storage and
+// more than one mip level (VulkanTexture then has per-level storage
+// views), at most MAX_SIZE on a side.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class VulkanBuffer;
+	class VulkanTexture;
+	class ComputeDispatcher;
+
+	class MipGenerator
+	{
+	public:
+		// One workgroup reduces 64x64 texels by six levels, and the last
+		// group six more from there: 13 levels in all
+		static constexpr uint32_t MAX_SIZE = 4096;
+
+		MipGenerator() = default;
+		~MipGenerator();
+
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager);
+		void Cleanup();
+
+		// Records mips 1..N-1 of `texture` from mip 0. The whole image must be
+		// in GENERAL with mip 0's writes already made visible to compute
+		// (ComputeToComputeImageBarrier); it is left in GENERAL with the
+		// other levels written, for the caller's usual hand-off barrier.
+		bool Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VulkanTexture* texture);
+
+	private:
+		bool CreatePipeline();
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		// Finished-group counter; created zeroed, the last group rearms it
+		VulkanBuffer* m_CounterBuffer = nullptr;
+
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+	};
+}
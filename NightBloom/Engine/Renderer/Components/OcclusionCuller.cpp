@@ -0,0 +1,665 @@
+//------------------------------------------------------------------------------
+// OcclusionCuller.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t REDUCE_LOCAL_SIZE = 8;    // HiZReduce*.comp
+		constexpr uint32_t OCCLUSION_LOCAL_SIZE = 64; // MeshOcclusion.comp
+		constexpr uint32_t DEPTH_RANGE_LOCAL_SIZE = 16; // ShadowDepthRange.comp
+
+		// Matches ReduceParams in hiz_reduce.glsl
+		struct ReducePushConstants
+		{
+			glm::ivec4 sizes;  // xy = source, zw = target
+		};
+
+		// Matches OcclusionParams in MeshOcclusion.comp
+		struct MeshTestPushConstants
+		{
+			glm::mat4 viewProj;
+			glm::vec4 pyramid;
+			glm::uvec4 counts;
+		};
+		static_assert(sizeof(MeshTestPushConstants) == 96, "Must match MeshOcclusion.comp");
+		static_assert(sizeof(MeshOcclusionCandidate) == 64, "Must match MeshOcclusion.comp");
+
+		// Matches PushConstants in ShadowDepthRange.comp
+		struct DepthRangePushConstants
+		{
+			glm::ivec4 size;  // xy = built region of mip 0
+		};
+
+		// Matches DepthRangeBuffer in ShadowDepthRange.comp: float bits of
+		// the reverse-Z depths, reset to "nothing seen" before each dispatch
+		struct DepthRangeResult
+		{
+			uint32_t nearestBits = 0;
+			uint32_t farthestBits = 0xFFFFFFFFu;
+		};
+
+		constexpr VkDeviceSize CANDIDATE_BUFFER_SIZE =
+			sizeof(MeshOcclusionCandidate) * OcclusionCuller::MAX_OCCLUSION_DRAWS;
+		constexpr VkDeviceSize DRAW_BUFFER_SIZE =
+			sizeof(VkDrawIndexedIndirectCommand) * OcclusionCuller::MAX_OCCLUSION_DRAWS;
+	}
+
+	bool OcclusionCuller::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, ResourceManager* resources,
+		VulkanDescriptorManager* descriptorManager, VkImageView depthView, VkExtent2D depthExtent,
+		VkSampleCountFlagBits depthSamples)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_Resources = resources;
+		m_DescriptorManager = descriptorManager;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.minLod = 0.0f;
+		samplerInfo.maxLod = static_cast<float>(MAX_PYRAMID_MIPS);
+		m_PointSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_PointSampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create pyramid sampler");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_PYRAMID_MIPS; ++i)
+			m_ReduceSets[i] = m_DescriptorManager->AllocateHiZReduceSet();
+		m_SampleSet = m_DescriptorManager->AllocateHiZSampleSet();
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			const std::string suffix = std::to_string(i);
+			m_CandidateBuffers[i] = m_Resources->CreateStorageBuffer("OcclusionCandidates_" + suffix, CANDIDATE_BUFFER_SIZE, true);
+			m_DrawBuffers[i] = m_Resources->CreateIndirectBuffer("OcclusionDraws_" + suffix, DRAW_BUFFER_SIZE);
+			if (!m_CandidateBuffers[i] || !m_DrawBuffers[i])
+			{
+				LOG_ERROR("OcclusionCuller: failed to create candidate/draw buffers");
+				return false;
+			}
+
+			m_MeshTestSets[i] = m_DescriptorManager->AllocateComputeStorageSet();
+			m_DescriptorManager->UpdateComputeStorageSet(m_MeshTestSets[i],
+				m_CandidateBuffers[i]->GetBuffer(), CANDIDATE_BUFFER_SIZE,
+				m_DrawBuffers[i]->GetBuffer(), DRAW_BUFFER_SIZE);
+
+			m_DepthRangeBuffers[i] = m_Resources->CreateStorageBuffer("ShadowDepthRange_" + suffix, sizeof(DepthRangeResult), true);
+			auto* range = m_DepthRangeBuffers[i]
+				? static_cast<DepthRangeResult*>(m_DepthRangeBuffers[i]->GetPersistentMappedPtr()) : nullptr;
+			if (!range)
+			{
+				LOG_ERROR("OcclusionCuller: failed to create depth range buffers");
+				return false;
+			}
+			*range = DepthRangeResult{};
+			m_DepthRangeBuffers[i]->Flush(0, sizeof(DepthRangeResult));
+
+			m_DepthRangeSets[i] = m_DescriptorManager->AllocateComputeStorageSet();
+			if (m_DepthRangeSets[i] != VK_NULL_HANDLE)
+			{
+				m_DescriptorManager->UpdateComputeStorageSet(m_DepthRangeSets[i],
+					m_DepthRangeBuffers[i]->GetBuffer(), sizeof(DepthRangeResult));
+			}
+		}
+
+		for (VkDescriptorSet set : m_ReduceSets)
+		{
+			if (set == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("OcclusionCuller: failed to allocate reduce descriptor sets");
+				return false;
+			}
+		}
+		if (m_SampleSet == VK_NULL_HANDLE || m_MeshTestSets[0] == VK_NULL_HANDLE || m_MeshTestSets[1] == VK_NULL_HANDLE ||
+			m_DepthRangeSets[0] == VK_NULL_HANDLE || m_DepthRangeSets[1] == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("OcclusionCuller: failed to allocate descriptor sets");
+			return false;
+		}
+
+		if (!CreatePipelines(depthSamples))
+			return false;
+
+		if (!CreatePyramid(depthView, depthExtent))
+			return false;
+
+		LOG_INFO("OcclusionCuller initialized ({}x{} pyramid, {} mips)",
+			m_PyramidExtent.width, m_PyramidExtent.height, m_MipCount);
+		return true;
+	}
+
+	void OcclusionCuller::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		DestroyPyramid();
+
+		VkPipeline pipelines[] = { m_SeedPipeline, m_DownsamplePipeline, m_MeshTestPipeline, m_DepthRangePipeline };
+		for (VkPipeline pipeline : pipelines)
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+		}
+		m_SeedPipeline = m_DownsamplePipeline = m_MeshTestPipeline = m_DepthRangePipeline = VK_NULL_HANDLE;
+
+		if (m_ReduceLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_ReduceLayout, nullptr);
+			m_ReduceLayout = VK_NULL_HANDLE;
+		}
+		if (m_MeshTestLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_MeshTestLayout, nullptr);
+			m_MeshTestLayout = VK_NULL_HANDLE;
+		}
+		if (m_DepthRangeLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_DepthRangeLayout, nullptr);
+			m_DepthRangeLayout = VK_NULL_HANDLE;
+		}
+		m_PointSampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (m_Resources)
+			{
+				const std::string suffix = std::to_string(i);
+				if (m_CandidateBuffers[i])
+					m_Resources->DestroyBuffer("OcclusionCandidates_" + suffix);
+				if (m_DrawBuffers[i])
+					m_Resources->DestroyBuffer("OcclusionDraws_" + suffix);
+				if (m_DepthRangeBuffers[i])
+					m_Resources->DestroyBuffer("ShadowDepthRange_" + suffix);
+			}
+			m_CandidateBuffers[i] = nullptr;
+			m_DrawBuffers[i] = nullptr;
+			m_DepthRangeBuffers[i] = nullptr;
+			m_DepthRangeWritten[i] = false;
+		}
+
+		m_HasPyramid = false;
+		m_Device = nullptr;
+	}
+
+	bool OcclusionCuller::Resize(VkImageView depthView, VkExtent2D depthExtent)
+	{
+		DestroyPyramid();
+		return CreatePyramid(depthView, depthExtent);
+	}
+
+	bool OcclusionCuller::CreatePyramid(VkImageView depthView, VkExtent2D depthExtent)
+	{
+		m_HasPyramid = false;
+		if (depthView == VK_NULL_HANDLE || depthExtent.width == 0 || depthExtent.height == 0)
+			return false;
+
+		// Mip 0 is half the depth buffer (the seed pass already reduces 2x2)
+		m_PyramidExtent.width = std::max((depthExtent.width + 1) / 2, 1u);
+		m_PyramidExtent.height = std::max((depthExtent.height + 1) / 2, 1u);
+
+		uint32_t largest = std::max(m_PyramidExtent.width, m_PyramidExtent.height);
+		m_MipCount = 1;
+		while ((largest >> m_MipCount) > 0 && m_MipCount < MAX_PYRAMID_MIPS)
+			++m_MipCount;
+
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = m_PyramidExtent.width;
+		imageInfo.height = m_PyramidExtent.height;
+		imageInfo.mipLevels = m_MipCount;
+		imageInfo.arrayLayers = 2;
+		imageInfo.format = VK_FORMAT_R32_SFLOAT;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.category = GpuMemoryCategory::RenderTarget;
+		imageInfo.debugName = "HiZPyramid";
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create {}x{} pyramid", m_PyramidExtent.width, m_PyramidExtent.height);
+			return false;
+		}
+		m_PyramidAllocation = allocation;
+		m_PyramidImage = allocation->image;
+
+		VkDevice device = m_Device->GetDevice();
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_PyramidImage;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = VK_FORMAT_R32_SFLOAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = m_MipCount;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &m_PyramidView) != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create pyramid view");
+			return false;
+		}
+		viewInfo.subresourceRange.baseArrayLayer = 1;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &m_NearestView) != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create nearest-depth pyramid view");
+			return false;
+		}
+
+		for (uint32_t mip = 0; mip < m_MipCount; ++mip)
+		{
+			viewInfo.subresourceRange.baseMipLevel = mip;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.baseArrayLayer = 0;
+			if (vkCreateImageView(device, &viewInfo, nullptr, &m_MipViews[mip]) != VK_SUCCESS)
+			{
+				LOG_ERROR("OcclusionCuller: failed to create view for pyramid mip {}", mip);
+				return false;
+			}
+			viewInfo.subresourceRange.baseArrayLayer = 1;
+			if (vkCreateImageView(device, &viewInfo, nullptr, &m_NearestMipViews[mip]) != VK_SUCCESS)
+			{
+				LOG_ERROR("OcclusionCuller: failed to create nearest-depth view for pyramid mip {}", mip);
+				return false;
+			}
+		}
+
+		// The pyramid lives in GENERAL: written as a storage image, read with texelFetch
+		{
+			VulkanSingleTimeCommand cmd(m_Device, m_Resources->GetTransferCommandPool());
+			VkCommandBuffer commandBuffer = cmd.Begin();
+
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = m_PyramidImage;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.baseMipLevel = 0;
+			barrier.subresourceRange.levelCount = m_MipCount;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 2;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+			cmd.End();
+		}
+
+		// Reduce set 0 reads the scene depth (for both layers), set i reads
+		// mip i-1 of each layer
+		m_DescriptorManager->UpdateHiZReduceSet(m_ReduceSets[0], depthView, depthView,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, m_PointSampler, m_MipViews[0], m_NearestMipViews[0]);
+		for (uint32_t mip = 1; mip < m_MipCount; ++mip)
+		{
+			m_DescriptorManager->UpdateHiZReduceSet(m_ReduceSets[mip], m_MipViews[mip - 1], m_NearestMipViews[mip - 1],
+				VK_IMAGE_LAYOUT_GENERAL, m_PointSampler, m_MipViews[mip], m_NearestMipViews[mip]);
+		}
+		m_DescriptorManager->UpdateHiZSampleSet(m_SampleSet, m_PyramidView, m_NearestView, m_PointSampler);
+
+		m_DepthExtent = depthExtent;
+		return true;
+	}
+
+	void OcclusionCuller::DestroyPyramid()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		for (uint32_t mip = 0; mip < MAX_PYRAMID_MIPS; ++mip)
+		{
+			VkImageView* views[] = { &m_MipViews[mip], &m_NearestMipViews[mip] };
+			for (VkImageView* view : views)
+			{
+				if (*view != VK_NULL_HANDLE)
+				{
+					vkDestroyImageView(device, *view, nullptr);
+					*view = VK_NULL_HANDLE;
+				}
+			}
+		}
+		VkImageView* chainViews[] = { &m_PyramidView, &m_NearestView };
+		for (VkImageView* view : chainViews)
+		{
+			if (*view != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(device, *view, nullptr);
+				*view = VK_NULL_HANDLE;
+			}
+		}
+		if (m_PyramidAllocation)
+		{
+			m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_PyramidAllocation));
+			m_PyramidAllocation = nullptr;
+		}
+		m_PyramidImage = VK_NULL_HANDLE;
+		m_MipCount = 0;
+		m_HasPyramid = false;
+	}
+
+	bool OcclusionCuller::CreatePipelines(VkSampleCountFlagBits depthSamples)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange reduceRange{};
+		reduceRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		reduceRange.size = sizeof(ReducePushConstants);
+
+		VkDescriptorSetLayout reduceSetLayout = m_DescriptorManager->GetHiZReduceSetLayout();
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &reduceSetLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &reduceRange;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_ReduceLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create reduce pipeline layout");
+			return false;
+		}
+
+		// Set 0 = candidates/draws, set 1 = pyramid (hiz_occlusion.glsl)
+		VkDescriptorSetLayout testSetLayouts[2] = {
+			m_DescriptorManager->GetComputeStorageSetLayout(),
+			m_DescriptorManager->GetHiZSampleSetLayout()
+		};
+		VkPushConstantRange testRange{};
+		testRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		testRange.size = sizeof(MeshTestPushConstants);
+
+		layoutInfo.setLayoutCount = 2;
+		layoutInfo.pSetLayouts = testSetLayouts;
+		layoutInfo.pPushConstantRanges = &testRange;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_MeshTestLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create mesh test pipeline layout");
+			return false;
+		}
+
+		// Set 0 = result buffer, set 1 = pyramid
+		VkPushConstantRange rangeRange{};
+		rangeRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		rangeRange.size = sizeof(DepthRangePushConstants);
+
+		layoutInfo.pPushConstantRanges = &rangeRange;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_DepthRangeLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create depth range pipeline layout");
+			return false;
+		}
+
+		const char* seedShader = (depthSamples != VK_SAMPLE_COUNT_1_BIT) ? "HiZReduceMS.comp.spv" : "HiZReduce.comp.spv";
+		m_SeedPipeline = CreateComputePipeline(seedShader, m_ReduceLayout);
+		m_DownsamplePipeline = CreateComputePipeline("HiZReduce.comp.spv", m_ReduceLayout);
+		m_MeshTestPipeline = CreateComputePipeline("MeshOcclusion.comp.spv", m_MeshTestLayout);
+		m_DepthRangePipeline = CreateComputePipeline("ShadowDepthRange.comp.spv", m_DepthRangeLayout);
+
+		return m_SeedPipeline != VK_NULL_HANDLE &&
+			m_DownsamplePipeline != VK_NULL_HANDLE &&
+			m_MeshTestPipeline != VK_NULL_HANDLE &&
+			m_DepthRangePipeline != VK_NULL_HANDLE;
+	}
+
+	VkPipeline OcclusionCuller::CreateComputePipeline(const char* shaderName, VkPipelineLayout layout)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("OcclusionCuller: failed to load {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create shader module for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = layout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("OcclusionCuller: failed to create compute pipeline for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, shaderName);
+		return pipeline;
+	}
+
+	uint32_t OcclusionCuller::WriteMeshCandidates(uint32_t frameIndex, DrawList& drawList)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		m_CandidateCounts[frame] = 0;
+		if (!m_Enabled || !m_HasPyramid || !m_CandidateBuffers[frame])
+		{
+			m_LastCandidateCount = 0;
+			return 0;
+		}
+
+		auto* candidates = static_cast<MeshOcclusionCandidate*>(m_CandidateBuffers[frame]->GetPersistentMappedPtr());
+		if (!candidates)
+			return 0;
+
+		uint32_t count = 0;
+		for (size_t i = 0; i < drawList.GetCommandCount(); ++i)
+		{
+			DrawCommand& cmd = drawList.GetCommandMutable(i);
+			cmd.occlusionSlot = DrawCommand::NO_OCCLUSION_SLOT;
+
+			// Direct indexed Mesh draws only; GPU-driven draws cull themselves
+			if (cmd.pipeline != PipelineType::Mesh || !cmd.cameraVisible || !cmd.hasBounds ||
+				!cmd.indexBuffer || cmd.indexCount == 0 || cmd.instanceCount == 0 || cmd.indirectBuffer)
+				continue;
+			// Tested per meshlet by MeshletCuller instead
+			if (cmd.meshletJob != DrawCommand::NO_MESHLET_JOB)
+				continue;
+			if (count >= MAX_OCCLUSION_DRAWS)
+				break;
+
+			MeshOcclusionCandidate& candidate = candidates[count];
+			candidate.center = glm::vec4(cmd.bounds.center, 0.0f);
+			candidate.extents = glm::vec4(cmd.bounds.extents, 0.0f);
+			candidate.draw = glm::uvec4(cmd.indexCount, cmd.instanceCount, cmd.firstInstance, 0u);
+			candidate.range = glm::uvec4(cmd.firstIndex, static_cast<uint32_t>(cmd.vertexOffset), 0u, 0u);
+			cmd.occlusionSlot = count++;
+		}
+
+		if (count > 0)
+			m_CandidateBuffers[frame]->Flush(0, sizeof(MeshOcclusionCandidate) * count);
+
+		m_CandidateCounts[frame] = count;
+		m_LastCandidateCount = count;
+		return count;
+	}
+
+	bool OcclusionCuller::DispatchMeshTest(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		const uint32_t count = m_CandidateCounts[frame];
+		if (count == 0 || !dispatcher || m_MeshTestPipeline == VK_NULL_HANDLE)
+			return false;
+
+		dispatcher->BindPipeline(cmd, m_MeshTestPipeline);
+		dispatcher->BindDescriptorSet(cmd, m_MeshTestLayout, 0, m_MeshTestSets[frame]);
+		dispatcher->BindDescriptorSet(cmd, m_MeshTestLayout, 1, m_SampleSet);
+
+		MeshTestPushConstants push{};
+		push.viewProj = m_PyramidViewProj;
+		push.pyramid = GetPyramidParams();
+		push.counts = glm::uvec4(count, 0u, 0u, 0u);
+		dispatcher->PushConstants(cmd, m_MeshTestLayout, &push, sizeof(push));
+
+		dispatcher->Dispatch(cmd, ComputeDispatcher::CalculateGroupCount(count, OCCLUSION_LOCAL_SIZE));
+		return true;
+	}
+
+	void OcclusionCuller::BuildPyramid(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const glm::mat4& viewProj,
+		VkExtent2D renderExtent)
+	{
+		if (!dispatcher || m_MipCount == 0 || m_SeedPipeline == VK_NULL_HANDLE)
+			return;
+
+		// Last frame's cull tests read the pyramid we are about to overwrite
+		dispatcher->ComputeToComputeImageBarrier(cmd, m_PyramidImage);
+
+		// Only the part of the depth buffer the scene drew into; the mips
+		// shrink with it, so the tests' texel math needs nothing but the params
+		const VkExtent2D depthExtent = {
+			std::clamp(renderExtent.width, 1u, m_DepthExtent.width),
+			std::clamp(renderExtent.height, 1u, m_DepthExtent.height) };
+		m_BuiltExtent = {
+			std::min(std::max((depthExtent.width + 1) / 2, 1u), m_PyramidExtent.width),
+			std::min(std::max((depthExtent.height + 1) / 2, 1u), m_PyramidExtent.height) };
+
+		// The render pass's outgoing dependency already made the depth writes visible
+		glm::ivec2 source(static_cast<int>(depthExtent.width), static_cast<int>(depthExtent.height));
+		for (uint32_t mip = 0; mip < m_MipCount; ++mip)
+		{
+			glm::ivec2 target(
+				std::max(static_cast<int>(m_BuiltExtent.width >> mip), 1),
+				std::max(static_cast<int>(m_BuiltExtent.height >> mip), 1));
+
+			dispatcher->BindPipeline(cmd, mip == 0 ? m_SeedPipeline : m_DownsamplePipeline);
+			dispatcher->BindDescriptorSet(cmd, m_ReduceLayout, 0, m_ReduceSets[mip]);
+
+			ReducePushConstants push{ glm::ivec4(source, target) };
+			dispatcher->PushConstants(cmd, m_ReduceLayout, &push, sizeof(push));
+			dispatcher->Dispatch(cmd,
+				ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(target.x), REDUCE_LOCAL_SIZE),
+				ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(target.y), REDUCE_LOCAL_SIZE));
+
+			dispatcher->ComputeToComputeImageBarrier(cmd, m_PyramidImage);
+			source = target;
+		}
+
+		m_PyramidViewProj = viewProj;
+		m_HasPyramid = true;
+	}
+
+	void OcclusionCuller::DispatchDepthRange(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		if (!dispatcher || !m_HasPyramid || m_DepthRangePipeline == VK_NULL_HANDLE || !m_DepthRangeBuffers[frame])
+			return;
+
+		// BuildPyramid's last barrier already covers mip 0
+		dispatcher->BindPipeline(cmd, m_DepthRangePipeline);
+		dispatcher->BindDescriptorSet(cmd, m_DepthRangeLayout, 0, m_DepthRangeSets[frame]);
+		dispatcher->BindDescriptorSet(cmd, m_DepthRangeLayout, 1, m_SampleSet);
+
+		DepthRangePushConstants push{ glm::ivec4(
+			static_cast<int>(m_BuiltExtent.width), static_cast<int>(m_BuiltExtent.height), 0, 0) };
+		dispatcher->PushConstants(cmd, m_DepthRangeLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(m_BuiltExtent.width, DEPTH_RANGE_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(m_BuiltExtent.height, DEPTH_RANGE_LOCAL_SIZE));
+
+		// Make the result available to the host; the fence wait does the rest
+		VkBufferMemoryBarrier hostBarrier{};
+		hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		hostBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.buffer = m_DepthRangeBuffers[frame]->GetBuffer();
+		hostBarrier.offset = 0;
+		hostBarrier.size = sizeof(DepthRangeResult);
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+			0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+
+		m_DepthRangeWritten[frame] = true;
+	}
+
+	bool OcclusionCuller::ReadDepthRange(uint32_t frameIndex, float& nearestDepth, float& farthestDepth)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		nearestDepth = 0.0f;
+		farthestDepth = 0.0f;
+		VulkanBuffer* buffer = m_DepthRangeBuffers[frame];
+		auto* range = buffer ? static_cast<DepthRangeResult*>(buffer->GetPersistentMappedPtr()) : nullptr;
+		if (!range)
+			return false;
+
+		const bool written = m_DepthRangeWritten[frame];
+		if (written)
+		{
+			buffer->Invalidate(0, sizeof(DepthRangeResult));
+			const DepthRangeResult result = *range;
+			if (result.nearestBits != 0 && result.farthestBits != DepthRangeResult{}.farthestBits)
+			{
+				std::memcpy(&nearestDepth, &result.nearestBits, sizeof(float));
+				std::memcpy(&farthestDepth, &result.farthestBits, sizeof(float));
+			}
+
+			*range = DepthRangeResult{};
+			buffer->Flush(0, sizeof(DepthRangeResult));
+			m_DepthRangeWritten[frame] = false;
+		}
+		return written;
+	}
+
+	VkBuffer OcclusionCuller::GetMeshDrawBuffer(uint32_t frameIndex) const
+	{
+		VulkanBuffer* buffer = m_DrawBuffers[frameIndex % MAX_FRAMES_IN_FLIGHT];
+		return buffer ? buffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	glm::vec4 OcclusionCuller::GetPyramidParams() const
+	{
+		const bool active = m_Enabled && m_HasPyramid;
+		return glm::vec4(
+			static_cast<float>(m_BuiltExtent.width),
+			static_cast<float>(m_BuiltExtent.height),
+			static_cast<float>(m_MipCount),
+			active ? 1.0f : 0.0f);
+	}
+
+} // namespace Nightbloom
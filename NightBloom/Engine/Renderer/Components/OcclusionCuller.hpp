@@ -0,0 +1,199 @@
+//------------------------------------------------------------------------------
+// OcclusionCuller.hpp
+//
+// Hierarchical-Z occlusion culling. After the scene pass, BuildPyramid
+// reduces the scene depth buffer into a min-depth mip chain (reverse-Z, so
+// each texel holds the FARTHEST depth under it). On the next frame, before the
+// scene pass, cull shaders project an AABB with the matrix that pyramid was
+// built with, pick the mip where it covers at most 2x2 texels and compare its
+// nearest depth against them: if it is behind all four, it is hidden.
+//
+// Meshes: WriteMeshCandidates copies the bounds of every camera-visible Mesh
+// draw into a per-frame buffer and gives the command an occlusion slot;
+// DispatchMeshTest (MeshOcclusion.comp) writes one VkDrawIndexedIndirectCommand
+// per slot with instanceCount zeroed when hidden, and the main color pass draws
+// those slots indirectly. Shadow and reflection passes keep the direct draws.
+// Draws MeshletCuller took are tested per meshlet there and get no slot.
+// Grass patches run the same test inside GrassCull.comp (GetPyramidSampleSet).
+//
+// The pyramid is one frame old, so an object that is uncovered by camera or
+// occluder motion can pop in a frame late - the usual single-pass Hi-Z trade.
+// A camera cut or resize invalidates it (HasPyramid false => nothing culled).
+//
+// The pyramid image has a second layer with the NEAREST depth under each
+// texel (max in reverse-Z), built by the same reduce dispatches. Culling
+// never reads it; screen-space reflection tracing uses it to skip cells the
+// ray passes in front of (GetPyramidSampleSet binding 1).
+//
+// DispatchDepthRange reduces mip 0 of both layers to the nearest and
+// farthest non-sky depth in view (ShadowDepthRange.comp) into a per-frame
+// host-visible buffer; ReadDepthRange hands it to the shadow split fit
+// (ShadowDepthBounds) once that frame slot's fence has signalled.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/FrameConfig.hpp"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanBuffer;
+	class VulkanDescriptorManager;
+	class ResourceManager;
+	class ComputeDispatcher;
+	class DrawList;
+
+	// Matches MeshCandidate in MeshOcclusion.comp (std430, 64 bytes)
+	struct MeshOcclusionCandidate
+	{
+		glm::vec4  center;    // xyz = world AABB center
+		glm::vec4  extents;   // xyz = world AABB half-size
+		glm::uvec4 draw;      // indexCount, instanceCount, firstInstance, unused
+		glm::uvec4 range;     // firstIndex, vertexOffset (int bits), unused (arena meshes)
+	};
+
+	class OcclusionCuller
+	{
+	public:
+		static constexpr uint32_t MAX_OCCLUSION_DRAWS = 4096;  // per frame
+		static constexpr uint32_t MAX_PYRAMID_MIPS = 16;
+
+		OcclusionCuller() = default;
+		~OcclusionCuller() = default;
+
+		// depthView/depthSamples describe RenderPassManager's scene depth
+		// buffer; the pyramid's mip 0 is half its extent.
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, ResourceManager* resources,
+			VulkanDescriptorManager* descriptorManager, VkImageView depthView, VkExtent2D depthExtent,
+			VkSampleCountFlagBits depthSamples);
+		void Cleanup();
+
+		// Swapchain resize: the depth buffer was recreated. Caller has waited idle.
+		bool Resize(VkImageView depthView, VkExtent2D depthExtent);
+
+		// CPU side, once the frame's draw list is final (after instance
+		// batching). Returns the number of commands given an occlusion slot.
+		uint32_t WriteMeshCandidates(uint32_t frameIndex, DrawList& drawList);
+
+		// Compute pass, before the scene pass. Returns true if it dispatched;
+		// the caller then issues the compute->indirect barrier on
+		// GetMeshDrawBuffer(frameIndex).
+		bool DispatchMeshTest(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
+
+		// After the scene pass: reduce its depth into the pyramid. viewProj is
+		// the matrix the scene was drawn with (tests reproject with it) and
+		// renderExtent the top-left part of the depth buffer it covered
+		// (smaller than the buffer under dynamic resolution). The pyramid
+		// then only uses the matching part of each mip.
+		void BuildPyramid(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const glm::mat4& viewProj,
+			VkExtent2D renderExtent);
+
+		// After BuildPyramid, same pass: reduce the pyramid's mip 0 to the
+		// visible depth range for frameIndex's slot.
+		void DispatchDepthRange(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
+
+		// CPU side, after frameIndex's fence wait and before it is recorded
+		// again: the reverse-Z depth range DispatchDepthRange wrote into this
+		// slot, MAX_FRAMES_IN_FLIGHT frames ago. nearestDepth is 0 when only
+		// sky was drawn. Returns false if the slot holds no range; either way
+		// the slot is reset for this frame's dispatch.
+		bool ReadDepthRange(uint32_t frameIndex, float& nearestDepth, float& farthestDepth);
+
+		// Forget the current pyramid (camera cut) - nothing is culled until
+		// the next BuildPyramid, and no depth range is reported until one is
+		// reduced from it.
+		void Invalidate()
+		{
+			m_HasPyramid = false;
+			m_DepthRangeWritten.fill(false);
+		}
+
+		VkBuffer GetMeshDrawBuffer(uint32_t frameIndex) const;
+
+		// Pyramid access for other cull shaders (set layout:
+		// VulkanDescriptorManager::GetHiZSampleSetLayout). Params are
+		// (mip0 width, mip0 height, mip count, enabled 0/1), the width and
+		// height being the region last built, not the image size.
+		VkDescriptorSet GetPyramidSampleSet() const { return m_SampleSet; }
+		const glm::mat4& GetPyramidViewProjection() const { return m_PyramidViewProj; }
+		glm::vec4 GetPyramidParams() const;
+		bool HasPyramid() const { return m_HasPyramid; }
+
+		// Mip 0 image size and the region last built, for passes that keep
+		// data aligned with the pyramid (ScreenSpaceReflections). Unlike
+		// GetPyramidParams these ignore whether culling is enabled.
+		VkExtent2D GetPyramidExtent() const { return m_PyramidExtent; }
+		VkExtent2D GetBuiltExtent() const { return m_BuiltExtent; }
+		uint32_t GetMipCount() const { return m_MipCount; }
+
+		void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		bool IsEnabled() const { return m_Enabled; }
+		uint32_t GetLastCandidateCount() const { return m_LastCandidateCount; }
+
+	private:
+		bool CreatePyramid(VkImageView depthView, VkExtent2D depthExtent);
+		void DestroyPyramid();
+		bool CreatePipelines(VkSampleCountFlagBits depthSamples);
+		VkPipeline CreateComputePipeline(const char* shaderName, VkPipelineLayout layout);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		// Pyramid - R32_SFLOAT with a full mip chain and two layers
+		// (0 = farthest, 1 = nearest), always in GENERAL
+		VkImage m_PyramidImage = VK_NULL_HANDLE;
+		void* m_PyramidAllocation = nullptr;  // a VulkanMemoryManager::ImageAllocation*
+		VkImageView m_PyramidView = VK_NULL_HANDLE;                        // layer 0, all mips, for the tests
+		VkImageView m_NearestView = VK_NULL_HANDLE;                        // layer 1, all mips
+		std::array<VkImageView, MAX_PYRAMID_MIPS> m_MipViews{};            // layer 0, one per mip, for the build
+		std::array<VkImageView, MAX_PYRAMID_MIPS> m_NearestMipViews{};     // layer 1, one per mip
+		VkSampler m_PointSampler = VK_NULL_HANDLE;
+		VkExtent2D m_PyramidExtent = { 0, 0 };
+		VkExtent2D m_DepthExtent = { 0, 0 };
+		VkExtent2D m_BuiltExtent = { 0, 0 };  // mip 0 region the current pyramid covers
+		uint32_t m_MipCount = 0;
+
+		// Reduce set i writes mip i of both layers from the depth buffer
+		// (i == 0) or mip i-1.
+		// Allocated once for MAX_PYRAMID_MIPS and rewritten on resize.
+		std::array<VkDescriptorSet, MAX_PYRAMID_MIPS> m_ReduceSets{};
+		VkDescriptorSet m_SampleSet = VK_NULL_HANDLE;
+
+		// Seed reads the (possibly multisampled) depth buffer; downsample
+		// reads the previous mip. Both share the reduce layout.
+		VkPipelineLayout m_ReduceLayout = VK_NULL_HANDLE;
+		VkPipeline m_SeedPipeline = VK_NULL_HANDLE;
+		VkPipeline m_DownsamplePipeline = VK_NULL_HANDLE;
+
+		// Mesh test: set 0 = candidates/draws (compute storage layout), set 1 = pyramid
+		VkPipelineLayout m_MeshTestLayout = VK_NULL_HANDLE;
+		VkPipeline m_MeshTestPipeline = VK_NULL_HANDLE;
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_CandidateBuffers{};  // host-visible, owned by ResourceManager
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_DrawBuffers{};       // GPU-only indirect, owned by ResourceManager
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_MeshTestSets{};
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_CandidateCounts{};
+
+		// Depth range: set 0 = result buffer (compute storage layout), set 1 = pyramid
+		VkPipelineLayout m_DepthRangeLayout = VK_NULL_HANDLE;
+		VkPipeline m_DepthRangePipeline = VK_NULL_HANDLE;
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_DepthRangeBuffers{};  // host-visible, owned by ResourceManager
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_DepthRangeSets{};
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_DepthRangeWritten{};
+
+		glm::mat4 m_PyramidViewProj = glm::mat4(1.0f);
+		bool m_HasPyramid = false;
+		bool m_Enabled = true;
+		uint32_t m_LastCandidateCount = 0;
+
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,507 @@
+//------------------------------------------------------------------------------
+// RayTracedShadows.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/RayTracedShadows.hpp"
+#include "Engine/Renderer/Components/SignatureHash.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/Vertex.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace Nightbloom
+{
+	static_assert(sizeof(RayTracedShadowInstance) == sizeof(VkAccelerationStructureInstanceKHR),
+		"RayTracedShadowInstance must match VkAccelerationStructureInstanceKHR");
+
+	namespace
+	{
+		constexpr uint32_t INITIAL_TLAS_CAPACITY = 1024;
+		// A BLAS nothing has drawn for this many frames is dropped; a mesh
+		// freed and replaced by another in the same arena range goes with it
+		constexpr uint64_t BLAS_EVICT_FRAMES = 120;
+
+		VkDeviceAddress AlignAddress(VkDeviceAddress address, VkDeviceSize alignment)
+		{
+			return (address + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	size_t RayTracedShadows::BlasKeyHash::operator()(const BlasKey& key) const
+	{
+		SignatureHash hash;
+		hash.Mix(key.vertexBuffer);
+		hash.Mix(key.indexBuffer);
+		hash.Mix(key.firstIndex);
+		hash.Mix(key.indexCount);
+		hash.Mix(key.vertexOffset);
+		hash.Mix(key.format);
+		return static_cast<size_t>(hash.Get());
+	}
+
+	bool RayTracedShadows::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_DescriptorManager = descriptorManager;
+
+		if (!m_Device->SupportsFeature("ray_query"))
+		{
+			LOG_ERROR("RayTracedShadows: the device has no ray queries");
+			return false;
+		}
+
+		// Packed meshes keep their unorm16 positions; not every device builds from them
+		VkFormatProperties packedFormat{};
+		vkGetPhysicalDeviceFormatProperties(m_Device->GetPhysicalDevice(), VK_FORMAT_R16G16B16A16_UNORM, &packedFormat);
+		m_PackedVertices = (packedFormat.bufferFeatures & VK_FORMAT_FEATURE_ACCELERATION_STRUCTURE_VERTEX_BUFFER_BIT_KHR) != 0;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (!CreateTlas(i, INITIAL_TLAS_CAPACITY))
+				return false;
+		}
+
+		LOG_INFO("RayTracedShadows initialized{}", m_PackedVertices ? "" : " (packed meshes cast no traced shadow)");
+		return true;
+	}
+
+	void RayTracedShadows::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		for (auto& [key, blas] : m_Blases)
+		{
+			if (blas.structure != VK_NULL_HANDLE)
+				m_Device->DestroyAccelerationStructure(blas.structure);
+			m_MemoryManager->DestroyBuffer(blas.storage);
+		}
+		m_Blases.clear();
+		m_Casters.clear();
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			FrameTlas& tlas = m_Tlas[i];
+			if (tlas.structure != VK_NULL_HANDLE)
+				m_Device->DestroyAccelerationStructure(tlas.structure);
+			m_MemoryManager->DestroyBuffer(tlas.storage);
+			m_MemoryManager->DestroyBuffer(tlas.scratch);
+			m_MemoryManager->DestroyBuffer(tlas.instances);
+			tlas = FrameTlas{};
+
+			m_MemoryManager->DestroyBuffer(m_BlasScratch[i]);
+			m_BlasScratch[i] = nullptr;
+		}
+		m_Device = nullptr;
+	}
+
+	void RayTracedShadows::BeginFrame()
+	{
+		++m_FrameCounter;
+		m_Casters.clear();
+	}
+
+	void RayTracedShadows::AddCaster(const DrawCommand& draw)
+	{
+		// Skinned vertices change every frame; indirect draws' ranges are the GPU's
+		if (draw.skinVertexCount > 0 || draw.indirectBuffer || draw.indexCount == 0 ||
+			!draw.vertexBuffer || !draw.indexBuffer)
+		{
+			return;
+		}
+		if (draw.vertexFormat == VertexFormat::Packed && !m_PackedVertices)
+			return;
+
+		const auto* vertexBuffer = static_cast<const VulkanBuffer*>(draw.vertexBuffer);
+		const auto* indexBuffer = static_cast<const VulkanBuffer*>(draw.indexBuffer);
+		if (vertexBuffer->GetDeviceAddress() == 0 || indexBuffer->GetDeviceAddress() == 0)
+			return;   // not in the mesh arena's addressed pages
+
+		BlasKey key;
+		key.vertexBuffer = vertexBuffer->GetBuffer();
+		key.indexBuffer = indexBuffer->GetBuffer();
+		key.firstIndex = draw.firstIndex;
+		key.indexCount = draw.indexCount;
+		key.vertexOffset = draw.vertexOffset;
+		key.format = draw.vertexFormat;
+
+		auto [it, inserted] = m_Blases.try_emplace(key);
+		Blas& blas = it->second;
+		if (inserted)
+		{
+			const bool packed = draw.vertexFormat == VertexFormat::Packed;
+			blas.vertexFormat = packed ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
+			blas.vertexStride = packed ? sizeof(PackedVertex) : sizeof(VertexPNT);
+			blas.vertexAddress = vertexBuffer->GetDeviceAddress();
+			blas.indexAddress = indexBuffer->GetDeviceAddress();
+			// Every vertex the page holds: the indices may reach any of them
+			blas.maxVertex = static_cast<uint32_t>(std::max<VkDeviceSize>(vertexBuffer->GetSize() / blas.vertexStride, 1) - 1);
+			blas.primitiveCount = draw.indexCount / 3;
+			blas.firstIndex = draw.firstIndex;
+			blas.firstVertex = static_cast<uint32_t>(std::max(draw.vertexOffset, 0));
+		}
+		blas.lastUsedFrame = m_FrameCounter;
+
+		// Packed meshes' model matrices fold in the dequantization, so the
+		// BLAS stays in unorm space like the vertex buffer
+		const uint32_t count = draw.instanceData ? draw.instanceCount : 1;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const glm::mat4 model = draw.instanceData
+				? static_cast<const InstanceData*>(draw.instanceData)[i].model
+				: (draw.hasPushConstants ? draw.pushConstants.model : glm::mat4(1.0f));
+
+			Caster caster;
+			caster.blas = &blas;
+			RayTracedShadow::ToInstanceTransform(model, caster.instance.transform);
+			caster.instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR |
+				VK_GEOMETRY_INSTANCE_FORCE_OPAQUE_BIT_KHR;
+			m_Casters.push_back(caster);
+		}
+	}
+
+	void RayTracedShadows::PrepareFrame(uint32_t frameIndex)
+	{
+		const uint32_t casters = static_cast<uint32_t>(m_Casters.size());
+		uint32_t capacity = m_Tlas[frameIndex].capacity;
+		if (casters <= capacity)
+			return;
+
+		while (capacity < casters)
+			capacity *= 2;
+		if (!CreateTlas(frameIndex, capacity))
+			LOG_WARN("RayTracedShadows: failed to grow the TLAS to {} instances - the rest cast no shadow", capacity);
+	}
+
+	void RayTracedShadows::Record(VkCommandBuffer cmd, uint32_t frameIndex, const RayTracedShadowSettings& settings)
+	{
+		if (BuildBlases(cmd, frameIndex, settings.maxBlasBuildsPerFrame))
+		{
+			// The TLAS build reads the new BLASes
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+			barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+				VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+		EvictUnusedBlases();
+
+		FrameTlas& tlas = m_Tlas[frameIndex];
+		auto* instances = static_cast<RayTracedShadowInstance*>(tlas.instances->mappedData);
+		SignatureHash signature;
+		uint32_t written = 0;
+		for (const Caster& caster : m_Casters)
+		{
+			// Casters whose BLAS waits for a later frame are left out until then
+			if (caster.blas->address == 0 || written == tlas.capacity)
+				continue;
+
+			RayTracedShadowInstance& instance = instances[written++];
+			instance = caster.instance;
+			instance.blasAddress = caster.blas->address;
+			signature.Mix(caster.blas->address);
+		}
+		if (written > 0)
+			m_MemoryManager->FlushMemory(tlas.instances->allocation, 0, written * sizeof(RayTracedShadowInstance));
+
+		const TlasUpdate update = RayTracedShadow::PlanTlasUpdate(tlas.state, written, signature.Get(),
+			settings.refitsPerRebuild);
+
+		VkAccelerationStructureGeometryKHR geometry{};
+		geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+		geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+		geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+		geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+		geometry.geometry.instances.data.deviceAddress = tlas.instances->deviceAddress;
+
+		VkAccelerationStructureBuildGeometryInfoKHR build{};
+		build.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+		build.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+		build.flags = VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR |
+			VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+		build.mode = update == TlasUpdate::Refit
+			? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+		build.srcAccelerationStructure = update == TlasUpdate::Refit ? tlas.structure : VK_NULL_HANDLE;
+		build.dstAccelerationStructure = tlas.structure;
+		build.geometryCount = 1;
+		build.pGeometries = &geometry;
+		build.scratchData.deviceAddress = AlignAddress(tlas.scratch->deviceAddress,
+			m_Device->GetAccelerationStructureScratchAlignment());
+
+		VkAccelerationStructureBuildRangeInfoKHR range{};
+		range.primitiveCount = written;
+		const VkAccelerationStructureBuildRangeInfoKHR* ranges = &range;
+
+		VulkanDebugMarkers::BeginLabel(cmd, update == TlasUpdate::Refit ? "Refit TLAS" : "Build TLAS");
+		m_Device->CmdBuildAccelerationStructures(cmd, 1, &build, &ranges);
+		VulkanDebugMarkers::EndLabel(cmd);
+
+		// The lit passes trace it
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+		barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		tlas.state = RayTracedShadow::Advance(tlas.state, update, written, signature.Get());
+		m_LastInstanceCount = written;
+	}
+
+	bool RayTracedShadows::BuildBlases(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t maxBuilds)
+	{
+		std::vector<Blas*> pending;
+		for (const Caster& caster : m_Casters)
+		{
+			Blas* blas = caster.blas;
+			if (blas->structure != VK_NULL_HANDLE || pending.size() >= maxBuilds)
+				continue;
+			if (std::find(pending.begin(), pending.end(), blas) == pending.end())
+				pending.push_back(blas);
+		}
+		if (pending.empty())
+			return false;
+
+		std::vector<VkAccelerationStructureGeometryKHR> geometries(pending.size());
+		std::vector<VkAccelerationStructureBuildGeometryInfoKHR> builds(pending.size());
+		std::vector<VkAccelerationStructureBuildRangeInfoKHR> ranges(pending.size());
+		std::vector<VkDeviceSize> scratchOffsets(pending.size());
+
+		const VkDeviceSize scratchAlignment = m_Device->GetAccelerationStructureScratchAlignment();
+		VkDeviceSize scratchSize = 0;
+		size_t count = 0;
+		for (Blas* blas : pending)
+		{
+			VkAccelerationStructureGeometryKHR& geometry = geometries[count];
+			geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+			geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
+			geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+			VkAccelerationStructureGeometryTrianglesDataKHR& triangles = geometry.geometry.triangles;
+			triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
+			triangles.vertexFormat = blas->vertexFormat;
+			triangles.vertexData.deviceAddress = blas->vertexAddress;
+			triangles.vertexStride = blas->vertexStride;
+			triangles.maxVertex = blas->maxVertex;
+			triangles.indexType = VK_INDEX_TYPE_UINT32;
+			triangles.indexData.deviceAddress = blas->indexAddress;
+
+			VkAccelerationStructureBuildGeometryInfoKHR& build = builds[count];
+			build.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+			build.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+			build.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+			build.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+			build.geometryCount = 1;
+			build.pGeometries = &geometry;
+
+			VkAccelerationStructureBuildSizesInfoKHR sizes{};
+			sizes.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+			m_Device->GetAccelerationStructureBuildSizes(build, &blas->primitiveCount, &sizes);
+
+			blas->storage = CreateBuffer(sizes.accelerationStructureSize,
+				VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR, false, "RayTracedShadows_BLAS");
+			if (!blas->storage)
+				continue;
+
+			VkAccelerationStructureCreateInfoKHR createInfo{};
+			createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+			createInfo.buffer = blas->storage->buffer;
+			createInfo.size = sizes.accelerationStructureSize;
+			createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+			if (m_Device->CreateAccelerationStructure(createInfo, &blas->structure) != VK_SUCCESS)
+			{
+				LOG_ERROR("RayTracedShadows: failed to create a BLAS ({} triangles)", blas->primitiveCount);
+				m_MemoryManager->DestroyBuffer(blas->storage);
+				blas->storage = nullptr;
+				continue;
+			}
+			build.dstAccelerationStructure = blas->structure;
+
+			VkAccelerationStructureBuildRangeInfoKHR& range = ranges[count];
+			range.primitiveCount = blas->primitiveCount;
+			range.primitiveOffset = blas->firstIndex * sizeof(uint32_t);
+			range.firstVertex = blas->firstVertex;
+
+			scratchSize = AlignAddress(scratchSize, scratchAlignment);
+			scratchOffsets[count] = scratchSize;
+			scratchSize += sizes.buildScratchSize;
+			pending[count++] = blas;
+		}
+		if (count == 0)
+			return false;
+		if (!ReserveBlasScratch(frameIndex, scratchSize))
+		{
+			// Never recorded: drop them now and retry next frame
+			LOG_WARN("RayTracedShadows: no {} bytes of BLAS scratch", scratchSize);
+			for (size_t i = 0; i < count; ++i)
+			{
+				m_Device->DestroyAccelerationStructure(pending[i]->structure);
+				m_MemoryManager->DestroyBuffer(pending[i]->storage);
+				pending[i]->structure = VK_NULL_HANDLE;
+				pending[i]->storage = nullptr;
+			}
+			return false;
+		}
+
+		std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> rangePointers(count);
+		const VkDeviceAddress scratchBase = AlignAddress(m_BlasScratch[frameIndex]->deviceAddress, scratchAlignment);
+		for (size_t i = 0; i < count; ++i)
+		{
+			builds[i].scratchData.deviceAddress = scratchBase + scratchOffsets[i];
+			rangePointers[i] = &ranges[i];
+		}
+
+		VulkanDebugMarkers::BeginLabel(cmd, "Build BLASes");
+		m_Device->CmdBuildAccelerationStructures(cmd, static_cast<uint32_t>(count), builds.data(), rangePointers.data());
+		VulkanDebugMarkers::EndLabel(cmd);
+
+		for (size_t i = 0; i < count; ++i)
+			pending[i]->address = m_Device->GetAccelerationStructureDeviceAddress(pending[i]->structure);
+		return true;
+	}
+
+	void RayTracedShadows::EvictUnusedBlases()
+	{
+		for (auto it = m_Blases.begin(); it != m_Blases.end();)
+		{
+			if (it->second.lastUsedFrame + BLAS_EVICT_FRAMES < m_FrameCounter)
+			{
+				DeferDestroy(it->second.structure, it->second.storage);
+				it = m_Blases.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	bool RayTracedShadows::ReserveBlasScratch(uint32_t frameIndex, VkDeviceSize size)
+	{
+		const VkDeviceSize alignment = m_Device->GetAccelerationStructureScratchAlignment();
+		VulkanMemoryManager::BufferAllocation*& scratch = m_BlasScratch[frameIndex];
+		if (scratch && scratch->size >= size + alignment)
+			return true;
+
+		DeferDestroy(VK_NULL_HANDLE, scratch);
+		scratch = CreateBuffer(size + alignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false, "RayTracedShadows_BLASScratch");
+		return scratch != nullptr;
+	}
+
+	bool RayTracedShadows::CreateTlas(uint32_t frameIndex, uint32_t capacity)
+	{
+		// Built aside, so a failed growth leaves the frame its old TLAS
+		FrameTlas next;
+		auto destroyNext = [this, &next]()
+		{
+			if (next.structure != VK_NULL_HANDLE)
+				m_Device->DestroyAccelerationStructure(next.structure);
+			m_MemoryManager->DestroyBuffer(next.storage);
+			m_MemoryManager->DestroyBuffer(next.scratch);
+			m_MemoryManager->DestroyBuffer(next.instances);
+		};
+
+		next.instances = CreateBuffer(capacity * sizeof(RayTracedShadowInstance),
+			VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR, true, "RayTracedShadows_Instances");
+		if (!next.instances || !next.instances->mappedData)
+		{
+			LOG_ERROR("RayTracedShadows: failed to create a {}-instance buffer", capacity);
+			destroyNext();
+			return false;
+		}
+
+		VkAccelerationStructureGeometryKHR geometry{};
+		geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+		geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+		geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+
+		VkAccelerationStructureBuildGeometryInfoKHR build{};
+		build.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+		build.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+		build.flags = VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR |
+			VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+		build.geometryCount = 1;
+		build.pGeometries = &geometry;
+
+		VkAccelerationStructureBuildSizesInfoKHR sizes{};
+		sizes.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+		m_Device->GetAccelerationStructureBuildSizes(build, &capacity, &sizes);
+
+		next.storage = CreateBuffer(sizes.accelerationStructureSize,
+			VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR, false, "RayTracedShadows_TLAS");
+		next.scratch = CreateBuffer(std::max(sizes.buildScratchSize, sizes.updateScratchSize) +
+			m_Device->GetAccelerationStructureScratchAlignment(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false,
+			"RayTracedShadows_TLASScratch");
+		if (!next.storage || !next.scratch)
+		{
+			LOG_ERROR("RayTracedShadows: failed to allocate a {}-instance TLAS", capacity);
+			destroyNext();
+			return false;
+		}
+
+		VkAccelerationStructureCreateInfoKHR createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+		createInfo.buffer = next.storage->buffer;
+		createInfo.size = sizes.accelerationStructureSize;
+		createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+		if (m_Device->CreateAccelerationStructure(createInfo, &next.structure) != VK_SUCCESS)
+		{
+			LOG_ERROR("RayTracedShadows: failed to create the TLAS");
+			next.structure = VK_NULL_HANDLE;
+			destroyNext();
+			return false;
+		}
+		VulkanDebugMarkers::SetName(m_Device->GetDevice(), VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_KHR,
+			reinterpret_cast<uint64_t>(next.structure), "RayTracedShadows_TLAS");
+		next.capacity = capacity;
+
+		FrameTlas& tlas = m_Tlas[frameIndex];
+		DeferDestroy(tlas.structure, tlas.storage);
+		DeferDestroy(VK_NULL_HANDLE, tlas.scratch);
+		DeferDestroy(VK_NULL_HANDLE, tlas.instances);
+		tlas = next;
+
+		// Only this frame's recording has yet to use the set
+		m_DescriptorManager->UpdateShadowAccelerationStructure(frameIndex, tlas.structure);
+		LOG_INFO("RayTracedShadows: frame {} TLAS holds {} instances ({:.1f} KB)", frameIndex, capacity,
+			sizes.accelerationStructureSize / 1024.0);
+		return true;
+	}
+
+	VulkanMemoryManager::BufferAllocation* RayTracedShadows::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+		bool mappable, const char* name)
+	{
+		VulkanMemoryManager::BufferCreateInfo createInfo{};
+		createInfo.size = size;
+		createInfo.usage = usage;
+		createInfo.mappable = mappable;
+		createInfo.deviceAddress = true;
+		createInfo.category = GpuMemoryCategory::Shadow;
+		createInfo.debugName = name;
+		return m_MemoryManager->CreateBuffer(createInfo);
+	}
+
+	void RayTracedShadows::DeferDestroy(VkAccelerationStructureKHR structure, VulkanMemoryManager::BufferAllocation* buffer)
+	{
+		if (structure == VK_NULL_HANDLE && !buffer)
+			return;
+
+		VulkanDevice* device = m_Device;
+		VulkanMemoryManager* memoryManager = m_MemoryManager;
+		m_Device->GetDeletionQueue()->Defer([device, memoryManager, structure, buffer]()
+		{
+			if (structure != VK_NULL_HANDLE)
+				device->DestroyAccelerationStructure(structure);
+			memoryManager->DestroyBuffer(buffer);
+		});
+	}
+}
@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+// RayTracedShadows.hpp
+//
+// The acceleration structures the ray-query sun shadows trace (see
+// RayTracedShadow.hpp). A bottom-level structure per mesh range the frame's
+// casters draw - built the first frame it is drawn, a few per frame, and
+// dropped once nothing has drawn it for a while - and per frame in flight a
+// top-level structure over the casters' transforms, refit while the same
+// instances move and rebuilt when they change. Set 3 binding 1 of that
+// frame's shadow set points at it.
+//
+// Only mesh draws whose vertices live in the mesh arena (device addresses,
+// see VulkanMeshArena::AddPage) take part. Skinned and GPU-generated draws
+// don't: their geometry isn't known here, or changes every frame.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/RayTracedShadow.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/VertexPacking.hpp"
+#include <vulkan/vulkan.h>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanDescriptorManager;
+	struct DrawCommand;
+
+	class RayTracedShadows
+	{
+	public:
+		RayTracedShadows() = default;
+		~RayTracedShadows() = default;
+
+		// Needs SupportsFeature("ray_query"). Creates every frame's TLAS
+		// (empty) and writes it into the shadow sets.
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager);
+		void Cleanup();
+
+		// Before the frame's draws are batched: clears the caster list
+		void BeginFrame();
+		// A mesh draw that casts the sun's shadow (Renderer::IsShadowCaster);
+		// the ones it can't trace are skipped
+		void AddCaster(const DrawCommand& draw);
+		// Once the casters are in, before frameIndex's commands are recorded:
+		// grows its TLAS to hold them (rewriting its descriptor, which no
+		// recording may have bound yet)
+		void PrepareFrame(uint32_t frameIndex);
+
+		// Outside any render pass, before the lit passes: builds the new
+		// meshes' BLASes, then builds or refits frameIndex's TLAS over the
+		// casters and makes it visible to fragment shaders
+		void Record(VkCommandBuffer cmd, uint32_t frameIndex, const RayTracedShadowSettings& settings);
+
+		uint32_t GetInstanceCount() const { return m_LastInstanceCount; }
+		uint32_t GetBlasCount() const { return static_cast<uint32_t>(m_Blases.size()); }
+
+	private:
+		// One mesh range, as the draws address it
+		struct BlasKey
+		{
+			VkBuffer vertexBuffer = VK_NULL_HANDLE;
+			VkBuffer indexBuffer = VK_NULL_HANDLE;
+			uint32_t firstIndex = 0;
+			uint32_t indexCount = 0;
+			int32_t vertexOffset = 0;
+			VertexFormat format = VertexFormat::Standard;
+
+			bool operator==(const BlasKey& other) const
+			{
+				return vertexBuffer == other.vertexBuffer && indexBuffer == other.indexBuffer &&
+					firstIndex == other.firstIndex && indexCount == other.indexCount &&
+					vertexOffset == other.vertexOffset && format == other.format;
+			}
+		};
+
+		struct BlasKeyHash
+		{
+			size_t operator()(const BlasKey& key) const;
+		};
+
+		struct Blas
+		{
+			// Geometry, resolved when first drawn
+			VkFormat vertexFormat = VK_FORMAT_UNDEFINED;
+			VkDeviceSize vertexStride = 0;
+			VkDeviceAddress vertexAddress = 0;
+			VkDeviceAddress indexAddress = 0;
+			uint32_t maxVertex = 0;
+			uint32_t primitiveCount = 0;
+			uint32_t firstIndex = 0;
+			uint32_t firstVertex = 0;
+
+			VkAccelerationStructureKHR structure = VK_NULL_HANDLE;
+			VulkanMemoryManager::BufferAllocation* storage = nullptr;
+			VkDeviceAddress address = 0;     // 0 until built
+			uint64_t lastUsedFrame = 0;
+		};
+
+		struct Caster
+		{
+			Blas* blas = nullptr;
+			RayTracedShadowInstance instance;
+		};
+
+		// A TLAS and what it is built from, per frame in flight
+		struct FrameTlas
+		{
+			VkAccelerationStructureKHR structure = VK_NULL_HANDLE;
+			VulkanMemoryManager::BufferAllocation* storage = nullptr;
+			VulkanMemoryManager::BufferAllocation* scratch = nullptr;
+			VulkanMemoryManager::BufferAllocation* instances = nullptr;   // host-visible
+			uint32_t capacity = 0;
+			TlasState state;
+		};
+
+		bool CreateTlas(uint32_t frameIndex, uint32_t capacity);
+		// Up to maxBuilds of this frame's unbuilt BLASes; true if any were
+		bool BuildBlases(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t maxBuilds);
+		void EvictUnusedBlases();
+		// Grows frameIndex's BLAS scratch buffer to at least `size`
+		bool ReserveBlasScratch(uint32_t frameIndex, VkDeviceSize size);
+
+		VulkanMemoryManager::BufferAllocation* CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+			bool mappable, const char* name);
+		// Once the GPU is done with everything submitted so far
+		void DeferDestroy(VkAccelerationStructureKHR structure, VulkanMemoryManager::BufferAllocation* buffer);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+		bool m_PackedVertices = false;   // R16G16B16A16_UNORM vertex buffers can be built from
+
+		std::unordered_map<BlasKey, Blas, BlasKeyHash> m_Blases;
+		std::vector<Caster> m_Casters;   // this frame's, from AddCaster
+		uint64_t m_FrameCounter = 0;
+
+		FrameTlas m_Tlas[MAX_FRAMES_IN_FLIGHT];
+		VulkanMemoryManager::BufferAllocation* m_BlasScratch[MAX_FRAMES_IN_FLIGHT] = {};
+		uint32_t m_LastInstanceCount = 0;
+
+		RayTracedShadows(const RayTracedShadows&) = delete;
+		RayTracedShadows& operator=(const RayTracedShadows&) = delete;
+	};
+}
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// ReflectionSchedule.hpp
+//
+// Decides which frames re-render the planar reflection target
+// (WaterDesc::reflectionInterval) and keeps the lookup the water samples it
+// with. Between renders the target is reused: a point on the water plane is
+// its own mirror image, so projecting it with the camera the target was
+// rendered with still finds its reflected texel - the water reprojects the
+// old reflection onto the moving view. The target is re-rendered when:
+//   - it comes due: interval frames after the last render (1 = every frame),
+//   - the water plane moved (the old mirror no longer applies), or
+//   - it is invalidated (resize, target recreated, or a frame whose
+//     reflection pass was culled left it unwritten).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class ReflectionSchedule
+	{
+	public:
+		static constexpr uint32_t MAX_INTERVAL = 4;
+
+		void Invalidate() { m_Valid = false; }
+		bool IsValid() const { return m_Valid; }
+
+		// Whether this frame must render the target; call before Advance
+		bool IsDue(uint32_t interval, float waterY) const
+		{
+			interval = std::clamp(interval, 1u, MAX_INTERVAL);
+			return !m_Valid || m_Age + 1 >= interval || waterY != m_WaterY;
+		}
+
+		// Once per frame. rendered: the target is rendered this frame with
+		// lookup (BuildLookup), uvExtent being the region it covers; otherwise
+		// the last render's lookup stays.
+		void Advance(bool rendered, const glm::mat4& lookup, const glm::vec2& uvExtent, float waterY)
+		{
+			if (!rendered)
+			{
+				++m_Age;
+				return;
+			}
+			m_Valid = true;
+			m_Age = 0;
+			m_Lookup = lookup;
+			m_UVExtent = uvExtent;
+			m_WaterY = waterY;
+		}
+
+		const glm::mat4& GetLookup() const { return m_Lookup; }
+		const glm::vec2& GetUVExtent() const { return m_UVExtent; }
+		// Frames since the target was rendered
+		uint32_t GetAge() const { return m_Age; }
+
+		// World position -> reflection target uv, for a target rendered with
+		// viewProj into the bottom-left uvScale of the image through a
+		// negative-height viewport (Renderer::RecordReflectionPass): u =
+		// (x/w * 0.5 + 0.5) * s.x, v = 1 - (y/w * 0.5 + 0.5) * s.y. The
+		// result is homogeneous; the water divides xy by w.
+		static glm::mat4 BuildLookup(const glm::mat4& viewProj, const glm::vec2& uvScale)
+		{
+			glm::mat4 toUV(0.0f);
+			toUV[0][0] = 0.5f * uvScale.x;
+			toUV[1][1] = -0.5f * uvScale.y;
+			toUV[3][0] = 0.5f * uvScale.x;
+			toUV[3][1] = 1.0f - 0.5f * uvScale.y;
+			toUV[3][3] = 1.0f;
+			return toUV * viewProj;
+		}
+
+	private:
+		bool m_Valid = false;
+		uint32_t m_Age = 0;
+		float m_WaterY = 0.0f;
+		glm::mat4 m_Lookup = glm::mat4(1.0f);
+		glm::vec2 m_UVExtent = glm::vec2(1.0f);
+	};
+}
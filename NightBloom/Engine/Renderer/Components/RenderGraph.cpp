@@ -0,0 +1,454 @@
+//------------------------------------------------------------------------------
+// RenderGraph.cpp
+//------------------------------------------------------------------------------
+#include "Engine/Renderer/Components/RenderGraph.hpp"
+#include "Engine/Renderer/Components/GpuProfiler.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		struct AccessInfo
+		{
+			VkPipelineStageFlags stages;
+			VkAccessFlags access;
+			VkImageLayout layout;
+			bool write;
+		};
+
+		AccessInfo Describe(RGAccess access)
+		{
+			switch (access)
+			{
+			case RGAccess::ComputeRead:
+				return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_LAYOUT_GENERAL, false };
+			case RGAccess::ComputeWrite:
+				return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+					VK_IMAGE_LAYOUT_GENERAL, true };
+			case RGAccess::ComputeSample:
+				return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			case RGAccess::DepthSample:
+				return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false };
+			case RGAccess::VertexRead:
+				return { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			case RGAccess::FragmentRead:
+				return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			case RGAccess::IndirectRead:
+				return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+					VK_IMAGE_LAYOUT_UNDEFINED, false };
+			case RGAccess::FragmentSample:
+				return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			case RGAccess::GraphicsSample:
+				return { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+					VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+			case RGAccess::VertexInput:
+				return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+					VK_IMAGE_LAYOUT_UNDEFINED, false };
+			}
+			return { VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false };
+		}
+
+		bool SameScope(const char* a, const char* b)
+		{
+			if (a == b) return true;
+			return a && b && std::strcmp(a, b) == 0;
+		}
+	}
+
+	// =========================================================================
+	// Declaration
+	// =========================================================================
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(RGResource resource, RGAccess access)
+	{
+		return Add(resource, static_cast<uint8_t>(AccessKind::Read), access);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(RGResource resource, RGAccess access)
+	{
+		return Add(resource, static_cast<uint8_t>(AccessKind::Write), access);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::WriteManaged(RGResource resource, RGAccess leavesAs)
+	{
+		return Add(resource, static_cast<uint8_t>(AccessKind::Managed), leavesAs);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::RenderTarget(RGResource resource, VkImageLayout finalLayout,
+		VkPipelineStageFlags visibleStages)
+	{
+		return Add(resource, static_cast<uint8_t>(AccessKind::Target), RGAccess::FragmentSample,
+			finalLayout, visibleStages);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::SideEffect()
+	{
+		m_Graph->m_Passes[m_Pass].sideEffect = true;
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Add(RGResource resource, uint8_t kind, RGAccess access,
+		VkImageLayout finalLayout, VkPipelineStageFlags visibleStages)
+	{
+		if (resource == RG_INVALID || resource >= m_Graph->m_Resources.size())
+		{
+			return *this;
+		}
+
+		// Accesses are stored flat, so a pass can only be extended until the next AddPass
+		if (m_Pass + 1 != m_Graph->m_PassCount)
+		{
+			LOG_WARN("RenderGraph: access declared on pass '{}' after a later pass was added",
+				m_Graph->m_Passes[m_Pass].name);
+			return *this;
+		}
+
+		m_Graph->m_Accesses.push_back({ resource, static_cast<AccessKind>(kind), access, finalLayout, visibleStages });
+		m_Graph->m_Passes[m_Pass].accessCount++;
+		return *this;
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Resources.clear();
+		m_Accesses.clear();
+		m_PassCount = 0;
+	}
+
+	RGResource RenderGraph::ImportImage(VkImage image, VkImageLayout currentLayout, VkImageAspectFlags aspect)
+	{
+		if (image == VK_NULL_HANDLE) return RG_INVALID;
+
+		Resource resource;
+		resource.image = image;
+		resource.aspect = aspect;
+		resource.state.layout = currentLayout;
+		m_Resources.push_back(resource);
+		return static_cast<RGResource>(m_Resources.size() - 1);
+	}
+
+	RGResource RenderGraph::ImportBuffer(VkBuffer buffer, VkDeviceSize size)
+	{
+		if (buffer == VK_NULL_HANDLE) return RG_INVALID;
+
+		Resource resource;
+		resource.buffer = buffer;
+		resource.size = size;
+		m_Resources.push_back(resource);
+		return static_cast<RGResource>(m_Resources.size() - 1);
+	}
+
+	void RenderGraph::MarkOutput(RGResource resource)
+	{
+		if (resource < m_Resources.size())
+		{
+			m_Resources[resource].output = true;
+		}
+	}
+
+	RenderGraph::PassBuilder RenderGraph::AddPass(const char* name, const char* profileScope, ExecuteFn execute)
+	{
+		if (m_PassCount == m_Passes.size())
+		{
+			m_Passes.emplace_back();
+		}
+
+		Pass& pass = m_Passes[m_PassCount];
+		pass.name = name;
+		pass.profileScope = profileScope;
+		pass.execute = std::move(execute);
+		pass.firstAccess = static_cast<uint32_t>(m_Accesses.size());
+		pass.accessCount = 0;
+		pass.sideEffect = false;
+		pass.culled = false;
+		pass.barriers.srcStages = 0;
+		pass.barriers.dstStages = 0;
+		pass.barriers.images.clear();
+		pass.barriers.buffers.clear();
+
+		return PassBuilder(this, m_PassCount++);
+	}
+
+	// =========================================================================
+	// Compile
+	// =========================================================================
+
+	void RenderGraph::Compile()
+	{
+		CullPasses();
+
+		for (uint32_t p = 0; p < m_PassCount; ++p)
+		{
+			if (m_Passes[p].culled) continue;
+
+			BuildBarriers(p);
+
+			const Pass& pass = m_Passes[p];
+			for (uint32_t a = pass.firstAccess; a < pass.firstAccess + pass.accessCount; ++a)
+			{
+				Lifetime& lifetime = m_Resources[m_Accesses[a].resource].lifetime;
+				lifetime.firstPass = std::min(lifetime.firstPass, p);
+				lifetime.lastPass = std::max(lifetime.lastPass, p);
+			}
+		}
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		// Walk back from the outputs: a pass survives if it has a side effect
+		// or writes something a surviving later pass (or the frame's output)
+		// reads. Written resources stay needed, since a later write may only
+		// cover part of them.
+		m_Needed.assign(m_Resources.size(), false);
+		for (size_t r = 0; r < m_Resources.size(); ++r)
+		{
+			m_Needed[r] = m_Resources[r].output;
+		}
+
+		for (uint32_t p = m_PassCount; p-- > 0;)
+		{
+			Pass& pass = m_Passes[p];
+			const AccessDecl* begin = m_Accesses.data() + pass.firstAccess;
+			const AccessDecl* end = begin + pass.accessCount;
+
+			bool live = pass.sideEffect;
+			for (const AccessDecl* a = begin; a != end && !live; ++a)
+			{
+				live = a->kind != AccessKind::Read && m_Needed[a->resource];
+			}
+
+			pass.culled = !live;
+			if (!live) continue;
+
+			for (const AccessDecl* a = begin; a != end; ++a)
+			{
+				if (a->kind == AccessKind::Read) m_Needed[a->resource] = true;
+			}
+		}
+	}
+
+	void RenderGraph::BuildBarriers(uint32_t passIndex)
+	{
+		Pass& pass = m_Passes[passIndex];
+		PassBarriers& out = pass.barriers;
+
+		for (uint32_t a = pass.firstAccess; a < pass.firstAccess + pass.accessCount; ++a)
+		{
+			const AccessDecl& decl = m_Accesses[a];
+			Resource& resource = m_Resources[decl.resource];
+			ResourceState& state = resource.state;
+			const bool isImage = resource.image != VK_NULL_HANDLE;
+
+			if (decl.kind == AccessKind::Target)
+			{
+				// The render pass's own dependencies order it against earlier
+				// readers and make the write visible to visibleStages
+				const bool depth = (resource.aspect & VK_IMAGE_ASPECT_DEPTH_BIT) != 0;
+				state.layout = decl.finalLayout;
+				state.writeStages = depth
+					? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+					: VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+				state.writeAccess = depth
+					? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+					: VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				state.readStages = 0;
+				state.visibleStages = decl.visibleStages;
+				continue;
+			}
+
+			const AccessInfo info = Describe(decl.access);
+
+			if (decl.kind == AccessKind::Managed)
+			{
+				if (isImage && info.layout != VK_IMAGE_LAYOUT_UNDEFINED) state.layout = info.layout;
+				state.writeStages = info.write ? info.stages : 0;
+				state.writeAccess = info.write ? info.access : 0;
+				state.readStages = info.write ? 0 : info.stages;
+				state.visibleStages = info.stages;
+				continue;
+			}
+
+			const bool transition = isImage && info.layout != VK_IMAGE_LAYOUT_UNDEFINED && info.layout != state.layout;
+			VkPipelineStageFlags srcStages = 0;
+			bool needed = transition;
+
+			if (info.write)
+			{
+				// WAW against the last write, WAR against the reads since
+				srcStages = state.writeStages | state.readStages;
+				needed = needed || srcStages != 0;
+			}
+			else
+			{
+				// RAW, unless a barrier or render pass already made the write
+				// visible to these stages. A transition also waits for readers.
+				const bool unseen = state.writeStages != 0 && (info.stages & ~state.visibleStages) != 0;
+				needed = needed || unseen;
+				srcStages = state.writeStages | (transition ? state.readStages : 0);
+			}
+
+			if (needed)
+			{
+				out.srcStages |= srcStages ? srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+				out.dstStages |= info.stages;
+
+				if (isImage)
+				{
+					VkImageMemoryBarrier barrier{};
+					barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+					barrier.srcAccessMask = state.writeAccess;
+					barrier.dstAccessMask = info.access;
+					barrier.oldLayout = state.layout;
+					barrier.newLayout = transition ? info.layout : state.layout;
+					barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.image = resource.image;
+					barrier.subresourceRange = { resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+					out.images.push_back(barrier);
+				}
+				else
+				{
+					VkBufferMemoryBarrier barrier{};
+					barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+					barrier.srcAccessMask = state.writeAccess;
+					barrier.dstAccessMask = info.access;
+					barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.buffer = resource.buffer;
+					barrier.offset = 0;
+					barrier.size = resource.size;
+					out.buffers.push_back(barrier);
+				}
+			}
+
+			if (info.write)
+			{
+				state.writeStages = info.stages;
+				state.writeAccess = info.access;
+				state.readStages = 0;
+				state.visibleStages = info.stages;
+			}
+			else if (transition)
+			{
+				// The transition is now the last write; its own writes need no
+				// availability, the earlier write was made visible by it
+				state.writeStages = info.stages;
+				state.writeAccess = 0;
+				state.readStages = info.stages;
+				state.visibleStages = info.stages;
+			}
+			else
+			{
+				state.readStages |= info.stages;
+				if (needed) state.visibleStages |= info.stages;
+			}
+
+			if (transition) state.layout = info.layout;
+		}
+	}
+
+	// =========================================================================
+	// Execute
+	// =========================================================================
+
+	void RenderGraph::Execute(const CommandBufferFn& currentCommandBuffer, GpuProfiler* profiler)
+	{
+		const char* openScope = nullptr;
+		uint32_t scope = UINT32_MAX;
+		VkCommandBuffer scopeCmd = VK_NULL_HANDLE;
+
+		auto closeScope = [&]()
+		{
+			if (openScope && profiler) profiler->EndScope(scopeCmd, scope);
+			openScope = nullptr;
+			scope = UINT32_MAX;
+		};
+
+		for (uint32_t p = 0; p < m_PassCount; ++p)
+		{
+			Pass& pass = m_Passes[p];
+			if (pass.culled) continue;
+
+			// Before fetching the command buffer: the previous pass may have split it
+			if (!SameScope(openScope, pass.profileScope)) closeScope();
+			VkCommandBuffer cmd = currentCommandBuffer();
+
+			if (pass.profileScope && !openScope)
+			{
+				openScope = pass.profileScope;
+				scopeCmd = cmd;
+				scope = profiler ? profiler->BeginScope(cmd, pass.profileScope) : UINT32_MAX;
+			}
+
+			// The pass's counts, its barriers included
+			RenderStats& stats = RenderStats::Get();
+			RenderStatsPassScope statsScope(pass.name ? stats.RegisterPass(pass.name) : RenderStats::OTHER_PASS);
+
+			const PassBarriers& barriers = pass.barriers;
+			if (!barriers.IsEmpty())
+			{
+				stats.Add(RenderCounter::Barriers, barriers.buffers.size() + barriers.images.size());
+				vkCmdPipelineBarrier(cmd, barriers.srcStages, barriers.dstStages, 0,
+					0, nullptr,
+					static_cast<uint32_t>(barriers.buffers.size()), barriers.buffers.data(),
+					static_cast<uint32_t>(barriers.images.size()), barriers.images.data());
+			}
+
+			// Each pass in a scope gets a child span, unless it has the
+			// scope's own name
+			uint32_t passScope = UINT32_MAX;
+			if (profiler && openScope && pass.name && !SameScope(openScope, pass.name))
+				passScope = profiler->BeginScope(cmd, pass.name);
+
+			if (pass.execute) pass.execute(cmd);
+
+			// The pass may have split the command buffer; end in the current one
+			if (passScope != UINT32_MAX)
+				profiler->EndScope(currentCommandBuffer(), passScope);
+		}
+
+		closeScope();
+	}
+
+	// =========================================================================
+	// Queries
+	// =========================================================================
+
+	bool RenderGraph::IsPassCulled(RGPass pass) const
+	{
+		return pass >= m_PassCount || m_Passes[pass].culled;
+	}
+
+	uint32_t RenderGraph::GetCulledPassCount() const
+	{
+		uint32_t count = 0;
+		for (uint32_t p = 0; p < m_PassCount; ++p)
+		{
+			if (m_Passes[p].culled) ++count;
+		}
+		return count;
+	}
+
+	RenderGraph::Lifetime RenderGraph::GetLifetime(RGResource resource) const
+	{
+		return resource < m_Resources.size() ? m_Resources[resource].lifetime : Lifetime{};
+	}
+
+	bool RenderGraph::LifetimesOverlap(RGResource a, RGResource b) const
+	{
+		const Lifetime la = GetLifetime(a);
+		const Lifetime lb = GetLifetime(b);
+		if (!la.IsUsed() || !lb.IsUsed()) return false;
+		return la.firstPass <= lb.lastPass && lb.firstPass <= la.lastPass;
+	}
+}
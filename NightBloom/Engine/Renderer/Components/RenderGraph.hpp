@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+// RenderGraph.hpp
+//
+// Per-frame pass graph over the hand-built render passes. Each frame the
+// Renderer declares its passes in submission order along with the buffers
+// and images each one reads and writes; Compile() then
+//   - culls passes whose writes nothing downstream reads (the reflection
+//     pass when no water is drawn, and the cloud reflection raymarch that
+//     only feeds it),
+//   - derives the barriers between the surviving passes from the declared
+//     accesses, batched into one vkCmdPipelineBarrier per pass and skipped
+//     when an earlier barrier or render-pass dependency already covers the
+//     read,
+//   - records each resource's lifetime (first/last surviving pass), which
+//     is what non-overlapping transient targets can alias memory on.
+// Execute() records the barriers and runs the pass callbacks, opening one
+// GpuProfiler scope per run of passes that share a scope name, with a child
+// scope per pass.
+//
+// Resources are imported, never created: the graph owns no memory and
+// starts each frame with a resource in the layout the caller imports it
+// with. Attachments written inside a VkRenderPass are synchronized by that
+// pass's subpass dependencies, so they're declared with RenderTarget() and
+// only update the tracked state; the same goes for systems that place
+// their own barriers (WriteManaged). Hazards between frames stay with the
+// owning systems, as before.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Nightbloom
+{
+	class GpuProfiler;
+
+	// How a pass touches a resource: the pipeline stage, access mask and
+	// (for images) layout the graph synchronizes against
+	enum class RGAccess : uint8_t
+	{
+		ComputeRead,      // storage buffer/image read in a compute shader (GENERAL)
+		ComputeWrite,     // storage buffer/image write in a compute shader (GENERAL)
+		ComputeSample,    // sampled in a compute shader (SHADER_READ_ONLY)
+		DepthSample,      // depth sampled in a compute shader (DEPTH_STENCIL_READ_ONLY)
+		VertexRead,       // storage buffer read in a vertex shader
+		FragmentRead,     // storage buffer read in a fragment shader
+		IndirectRead,     // indirect draw arguments / draw count
+		FragmentSample,   // sampled in a fragment shader (SHADER_READ_ONLY)
+		GraphicsSample,   // sampled in vertex and fragment shaders (SHADER_READ_ONLY)
+		VertexInput       // bound as a vertex buffer
+	};
+
+	using RGResource = uint32_t;
+	using RGPass = uint32_t;
+	constexpr uint32_t RG_INVALID = UINT32_MAX;
+
+	class RenderGraph
+	{
+	public:
+		using ExecuteFn = std::function<void(VkCommandBuffer)>;
+		// The command buffer to record the next pass into (a pass may split it)
+		using CommandBufferFn = std::function<VkCommandBuffer()>;
+
+		// Declares one pass's accesses, chained straight after AddPass.
+		// Invalid resources (a null import) are ignored, so optional inputs
+		// can be declared unconditionally.
+		class PassBuilder
+		{
+		public:
+			PassBuilder& Read(RGResource resource, RGAccess access);
+			PassBuilder& Write(RGResource resource, RGAccess access);
+			// The pass synchronizes its own access and leaves the resource as
+			// if last touched with leavesAs (no barrier is placed before it)
+			PassBuilder& WriteManaged(RGResource resource, RGAccess leavesAs);
+			// Attachment of the pass's VkRenderPass: finalLayout is the
+			// attachment's final layout, visibleStages the dst stages of the
+			// render pass's outgoing dependency
+			PassBuilder& RenderTarget(RGResource resource, VkImageLayout finalLayout,
+				VkPipelineStageFlags visibleStages);
+			// Never culled (presents, readbacks, state kept for next frame)
+			PassBuilder& SideEffect();
+
+			RGPass GetHandle() const { return m_Pass; }
+
+		private:
+			friend class RenderGraph;
+			PassBuilder(RenderGraph* graph, RGPass pass) : m_Graph(graph), m_Pass(pass) {}
+			PassBuilder& Add(RGResource resource, uint8_t kind, RGAccess access,
+				VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED, VkPipelineStageFlags visibleStages = 0);
+
+			RenderGraph* m_Graph;
+			RGPass m_Pass;
+		};
+
+		struct Lifetime
+		{
+			uint32_t firstPass = UINT32_MAX;
+			uint32_t lastPass = 0;
+			bool IsUsed() const { return firstPass != UINT32_MAX; }
+		};
+
+		struct PassBarriers
+		{
+			VkPipelineStageFlags srcStages = 0;
+			VkPipelineStageFlags dstStages = 0;
+			std::vector<VkImageMemoryBarrier> images;
+			std::vector<VkBufferMemoryBarrier> buffers;
+			bool IsEmpty() const { return images.empty() && buffers.empty(); }
+		};
+
+		// Start a new frame's declaration (keeps the allocations)
+		void Reset();
+
+		// currentLayout is the layout the image is in when the frame starts;
+		// UNDEFINED if its contents don't matter
+		RGResource ImportImage(VkImage image, VkImageLayout currentLayout,
+			VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+		RGResource ImportBuffer(VkBuffer buffer, VkDeviceSize size = VK_WHOLE_SIZE);
+		// Read after the frame (next frame, presentation): keeps its writers alive
+		void MarkOutput(RGResource resource);
+
+		// profileScope: GpuProfiler span name; consecutive passes with the
+		// same name share a span, nullptr records none
+		PassBuilder AddPass(const char* name, const char* profileScope, ExecuteFn execute);
+
+		void Compile();
+		void Execute(const CommandBufferFn& currentCommandBuffer, GpuProfiler* profiler);
+
+		// Valid after Compile
+		bool IsPassCulled(RGPass pass) const;
+		uint32_t GetCulledPassCount() const;
+		const PassBarriers& GetPassBarriers(RGPass pass) const { return m_Passes[pass].barriers; }
+		Lifetime GetLifetime(RGResource resource) const;
+		// Whether two resources are ever live in the same pass (if not they
+		// can share memory)
+		bool LifetimesOverlap(RGResource a, RGResource b) const;
+
+	private:
+		enum class AccessKind : uint8_t { Read, Write, Managed, Target };
+
+		struct AccessDecl
+		{
+			RGResource resource;
+			AccessKind kind;
+			RGAccess access;
+			VkImageLayout finalLayout;
+			VkPipelineStageFlags visibleStages;
+		};
+
+		struct ResourceState
+		{
+			VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags writeStages = 0;     // last write this frame
+			VkAccessFlags writeAccess = 0;
+			VkPipelineStageFlags readStages = 0;      // reads since that write
+			VkPipelineStageFlags visibleStages = 0;   // stages the write is visible to
+		};
+
+		struct Resource
+		{
+			VkImage image = VK_NULL_HANDLE;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize size = 0;
+			VkImageAspectFlags aspect = 0;
+			ResourceState state;
+			Lifetime lifetime;
+			bool output = false;
+		};
+
+		struct Pass
+		{
+			const char* name = nullptr;
+			const char* profileScope = nullptr;
+			ExecuteFn execute;
+			uint32_t firstAccess = 0;
+			uint32_t accessCount = 0;
+			bool sideEffect = false;
+			bool culled = false;
+			PassBarriers barriers;
+		};
+
+		void CullPasses();
+		void BuildBarriers(uint32_t passIndex);
+
+		std::vector<Resource> m_Resources;
+		std::vector<Pass> m_Passes;
+		uint32_t m_PassCount = 0;   // m_Passes is kept across frames; entries past this are stale
+		std::vector<AccessDecl> m_Accesses;
+		std::vector<bool> m_Needed;
+	};
+}
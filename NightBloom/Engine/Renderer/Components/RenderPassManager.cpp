@@ -5,20 +5,32 @@
 //------------------------------------------------------------------------------
 
 #include "Engine/Renderer/Components/RenderPassManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanSwapchain.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include <array>
+#include <algorithm>
 
 namespace Nightbloom
 {
 	bool RenderPassManager::Initialize(VkDevice device, VulkanSwapchain* swapchain, VulkanMemoryManager* memoryManager,
-		VkSampleCountFlagBits sampleCount)
+		VulkanSamplerCache* samplerCache,
+		VkSampleCountFlagBits sampleCount, VkExtent2D shadingRateTexelSize, bool dynamicPostProcess,
+		VkSampleCountFlagBits reflectionSampleCount, VkResolveModeFlagBits depthResolveMode, bool sceneColorStorage)
 	{
 
 		m_MemoryManager = memoryManager;
+		m_PostProcessDynamic = dynamicPostProcess;
+		m_SamplerCache = samplerCache;
 		m_HasDepth = true;
 		m_SampleCount = sampleCount;
+		m_ReflectionSampleCount = std::min(reflectionSampleCount, sampleCount);
+		m_DepthResolveMode = (sampleCount != VK_SAMPLE_COUNT_1_BIT) ? depthResolveMode : VK_RESOLVE_MODE_NONE;
+		m_ShadingRateTexelSize = (shadingRateTexelSize.width != 0 && shadingRateTexelSize.height != 0)
+			? shadingRateTexelSize
+			: VkExtent2D{ 0, 0 };
 
 		// Offscreen scene-color target is a LINEAR HDR float format, NOT the swapchain's
 		// 8-bit sRGB format. This is the foundation for tonemapping/bloom: lighting can now
@@ -34,21 +46,31 @@ namespace Nightbloom
 		// near-universal on desktop but not spec-guaranteed), fall back to
 		// VK_FORMAT_R16G16B16A16_SFLOAT — same plumbing, just heavier. The reflection target
 		// shares this format, so render-pass compatibility with the shared scene pipelines holds.
-		m_SceneColorFormat = VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+		m_SceneColorFormat = SCENE_COLOR_FORMAT;
+		m_SceneColorStorage = sceneColorStorage;
+		m_SceneExtent = swapchain->GetExtent();   // until the Renderer sizes it to its scene viewport
 
 		// Create depth resources first (needed for render pass creation to know format)
 		if (m_HasDepth)
 		{
-			if (!CreateDepthResources(device, swapchain->GetExtent()))
+			if (!CreateDepthResources(device, m_SceneExtent))
 			{
 				LOG_ERROR("Failed to create depth resources");
 				return false;
 			}
 		}
 
-		if (!CreateSceneColorResources(device, m_SceneColorFormat, swapchain->GetExtent()))
+		if (!CreateShadingRateResources(device, m_SceneExtent))
+		{
+			LOG_ERROR("Failed to create shading-rate images");
+			DestroyDepthResources(device);
+			return false;
+		}
+
+		if (!CreateSceneColorResources(device, m_SceneColorFormat, m_SceneExtent))
 		{
 			LOG_ERROR("Failed to create scene color resources");
+			DestroyShadingRateResources(device);
 			DestroyDepthResources(device);
 			return false;
 		}
@@ -58,26 +80,28 @@ namespace Nightbloom
 		{
 			LOG_ERROR("Failed to create scene render pass");
 			DestroySceneColorResources(device);
+			DestroyShadingRateResources(device);
 			DestroyDepthResources(device);
 			return false;
 		}
 
-		if (!CreateSceneFramebuffer(device, swapchain->GetExtent()))
+		if (!CreateSceneFramebuffer(device, m_SceneExtent))
 		{
 			LOG_ERROR("Failed to create scene framebuffer");
 			Cleanup(device);
 			return false;
 		}
 
-		// Create the post-process render pass (samples scene-color, writes the swapchain image)
-		if (!CreatePostProcessRenderPass(device, swapchain->GetImageFormat()))
+		// Create the post-process render pass (samples scene-color, writes the
+		// swapchain image). Dynamic rendering needs neither it nor framebuffers.
+		if (!m_PostProcessDynamic && !CreatePostProcessRenderPass(device, swapchain->GetImageFormat()))
 		{
 			LOG_ERROR("Failed to create post-process render pass");
 			Cleanup(device);
 			return false;
 		}
 
-		if (!CreatePostProcessFramebuffers(device, swapchain))
+		if (!m_PostProcessDynamic && !CreatePostProcessFramebuffers(device, swapchain))
 		{
 			LOG_ERROR("Failed to create post-process framebuffers");
 			Cleanup(device);
@@ -85,7 +109,7 @@ namespace Nightbloom
 		}
 
 		// Reflection target (mirror-camera scene render, sampled by the water
-		// surface). Single-sample, sized to the swapchain for now.
+		// surface). Single-sample, sized to the scene targets.
 		if (!CreateReflectionRenderPass(device, m_SceneColorFormat))
 		{
 			LOG_ERROR("Failed to create reflection render pass");
@@ -93,45 +117,59 @@ namespace Nightbloom
 			return false;
 		}
 
-		if (!CreateReflectionResources(device, m_SceneColorFormat, swapchain->GetExtent()))
+		if (!CreateTransientTargets(m_SceneColorFormat, m_SceneExtent))
 		{
-			LOG_ERROR("Failed to create reflection resources");
+			LOG_ERROR("Failed to create transient render targets");
 			Cleanup(device);
 			return false;
 		}
 
-		if (!CreateReflectionFramebuffer(device, swapchain->GetExtent()))
+		if (!CreateReflectionResources(device, m_SceneColorFormat, m_SceneExtent))
 		{
-			LOG_ERROR("Failed to create reflection framebuffer");
+			LOG_ERROR("Failed to create reflection resources");
 			Cleanup(device);
 			return false;
 		}
 
-		// Bloom (half-res HDR ping-pong targets, sampled by the post-process composite).
-		if (!CreateBloomRenderPass(device, m_SceneColorFormat) ||
-			!CreateBloomResources(device, m_SceneColorFormat, swapchain->GetExtent()))
+		if (!CreateReflectionFramebuffer(device, m_SceneExtent))
 		{
-			LOG_ERROR("Failed to create bloom resources");
+			LOG_ERROR("Failed to create reflection framebuffer");
 			Cleanup(device);
 			return false;
 		}
 
-		LOG_INFO("Render pass manager initialized ({} post-process framebuffers, depth: {})",
-			m_PostProcessFramebuffers.size(), m_HasDepth);
+		// Order-independent transparency. Optional: without it the
+		// transparent draws stay in the scene pass.
+		if (!CreateOitRenderPass(device) || !CreateOitResources(device, m_SceneExtent))
+		{
+			LOG_WARN("Order-independent transparency pass unavailable");
+			DestroyOitResources(device);
+			if (m_OitRenderPass != VK_NULL_HANDLE)
+			{
+				vkDestroyRenderPass(device, m_OitRenderPass, nullptr);
+				m_OitRenderPass = VK_NULL_HANDLE;
+			}
+		}
+
+		LOG_INFO("Render pass manager initialized ({} post-process framebuffers{}, depth: {})",
+			m_PostProcessFramebuffers.size(), m_PostProcessDynamic ? ", dynamic rendering" : "", m_HasDepth);
 		return true;
 	}
 
 	void RenderPassManager::Cleanup(VkDevice device)
 	{
-		DestroyBloomResources(device);
-		if (m_BloomRenderPass != VK_NULL_HANDLE)
+		DestroyOitResources(device);
+
+		if (m_OitRenderPass != VK_NULL_HANDLE)
 		{
-			vkDestroyRenderPass(device, m_BloomRenderPass, nullptr);
-			m_BloomRenderPass = VK_NULL_HANDLE;
+			vkDestroyRenderPass(device, m_OitRenderPass, nullptr);
+			m_OitRenderPass = VK_NULL_HANDLE;
 		}
 
+		DestroyAuxiliaryTargets(device);
 		DestroyReflectionFramebuffer(device);
 		DestroyReflectionResources(device);
+		DestroyTransientTargets();
 
 		if (m_ReflectionRenderPass != VK_NULL_HANDLE)
 		{
@@ -149,6 +187,7 @@ namespace Nightbloom
 
 		DestroySceneFramebuffer(device);
 		DestroySceneColorResources(device);
+		DestroyShadingRateResources(device);
 		DestroyDepthResources(device);
 
 		if (m_SceneRenderPass != VK_NULL_HANDLE)
@@ -160,66 +199,133 @@ namespace Nightbloom
 		LOG_INFO("Render pass manager cleaned up");
 	}
 
-	bool RenderPassManager::RecreateFramebuffers(VkDevice device, VulkanSwapchain* swapchain)
+	bool RenderPassManager::RecreateFramebuffers(VkDevice device, VulkanSwapchain* swapchain, VkExtent2D sceneExtent)
 	{
 		LOG_INFO("Recreating framebuffers for swapchain resize");
 
 		DestroyPostProcessFramebuffers(device);
+		if (!RecreateSceneTargets(device, sceneExtent))
+			return false;
+
+		if (!m_PostProcessDynamic && !CreatePostProcessFramebuffers(device, swapchain))
+		{
+			LOG_ERROR("Failed to recreate post-process framebuffers");
+			return false;
+		}
+		return true;
+	}
+
+	bool RenderPassManager::RecreateSceneTargets(VkDevice device, VkExtent2D extent)
+	{
 		DestroySceneFramebuffer(device);
+		m_SceneExtent = extent;
 
 		if (m_HasDepth)
 		{
 			DestroyDepthResources(device);
-			if (!CreateDepthResources(device, swapchain->GetExtent()))
+			if (!CreateDepthResources(device, extent))
 			{
 				LOG_ERROR("Failed to recreate depth resources");
 				return false;
 			}
 		}
 
+		DestroyShadingRateResources(device);
+		if (!CreateShadingRateResources(device, extent))
+		{
+			LOG_ERROR("Failed to recreate shading-rate images");
+			return false;
+		}
+
 		DestroySceneColorResources(device);
-		if (!CreateSceneColorResources(device, m_SceneColorFormat, swapchain->GetExtent()))
+		if (!CreateSceneColorResources(device, m_SceneColorFormat, extent))
 		{
 			LOG_ERROR("Failed to recreate scene color resources");
 			return false;
 		}
 
-		if (!CreateSceneFramebuffer(device, swapchain->GetExtent()))
+		if (!CreateSceneFramebuffer(device, extent))
 		{
 			LOG_ERROR("Failed to recreate scene framebuffer");
 			return false;
 		}
 
-		if (!CreatePostProcessFramebuffers(device, swapchain))
+		// Over the new scene color and depth
+		if (m_OitRenderPass != VK_NULL_HANDLE)
 		{
-			LOG_ERROR("Failed to recreate post-process framebuffers");
-			return false;
+			DestroyOitResources(device);
+			if (!CreateOitResources(device, extent))
+			{
+				LOG_ERROR("Failed to recreate OIT targets");
+				return false;
+			}
 		}
 
-		// Reflection target is sized to the swapchain — recreate it too.
+		// The reflection target and bloom chain are sized to the scene and
+		// share memory — recreate both around a new aliased allocation. The
+		// Renderer must re-point BloomMipChain at the new chain afterward (see
+		// Renderer resize handling). Auxiliary view targets are recreated on
+		// their next use, against the new shading-rate image.
+		DestroyAuxiliaryTargets(device);
+		return RecreateReflectionTargets(device, extent);
+	}
+
+	bool RenderPassManager::SetReflectionPersistent(VkDevice device, bool persistent, VkExtent2D extent)
+	{
+		if (persistent == m_ReflectionPersistent)
+			return true;
+
+		m_ReflectionPersistent = persistent;
+		LOG_INFO("Reflection target {} the bloom chain's memory", persistent ? "no longer shares" : "shares");
+		return RecreateReflectionTargets(device, extent);
+	}
+
+	bool RenderPassManager::RecreateReflectionTargets(VkDevice device, VkExtent2D extent)
+	{
 		DestroyReflectionFramebuffer(device);
 		DestroyReflectionResources(device);
-		if (!CreateReflectionResources(device, m_SceneColorFormat, swapchain->GetExtent()))
+		DestroyTransientTargets();
+		if (!CreateTransientTargets(m_SceneColorFormat, extent))
+		{
+			LOG_ERROR("Failed to recreate transient render targets");
+			return false;
+		}
+		if (!CreateReflectionResources(device, m_SceneColorFormat, extent))
 		{
 			LOG_ERROR("Failed to recreate reflection resources");
 			return false;
 		}
-		if (!CreateReflectionFramebuffer(device, swapchain->GetExtent()))
+		if (!CreateReflectionFramebuffer(device, extent))
 		{
 			LOG_ERROR("Failed to recreate reflection framebuffer");
 			return false;
 		}
 
-		// Bloom targets are half the swapchain extent — recreate them too. The render pass is
-		// resolution-independent, so it's kept. The Renderer must re-point its bloom descriptor
-		// sets at the new image views afterward (see Renderer resize handling).
-		DestroyBloomResources(device);
-		if (!CreateBloomResources(device, m_SceneColorFormat, swapchain->GetExtent()))
+		return true;
+	}
+
+	bool RenderPassManager::RecreateSwapchainFramebuffers(VkDevice device, VulkanSwapchain* swapchain,
+		VulkanDeletionQueue* deletionQueue)
+	{
+		if (m_PostProcessDynamic)
+			return true;
+
+		std::vector<VkFramebuffer> oldFramebuffers = std::move(m_PostProcessFramebuffers);
+		m_PostProcessFramebuffers.clear();
+		deletionQueue->Defer([device, oldFramebuffers]()
+			{
+				for (VkFramebuffer framebuffer : oldFramebuffers)
+				{
+					if (framebuffer != VK_NULL_HANDLE)
+						vkDestroyFramebuffer(device, framebuffer, nullptr);
+				}
+			});
+
+		if (!CreatePostProcessFramebuffers(device, swapchain))
 		{
-			LOG_ERROR("Failed to recreate bloom resources");
+			LOG_ERROR("Failed to recreate post-process framebuffers");
 			return false;
 		}
-
 		return true;
 	}
 
@@ -230,6 +336,8 @@ namespace Nightbloom
 		// Attachment layout:
 		//   no MSAA  : [0]=color(sampled), [1]=depth
 		//   with MSAA: [0]=MS color, [1]=MS depth, [2]=resolve color(sampled)
+		//              [3]=resolve depth (with a depth resolve mode)
+		// plus the shading-rate image last when there is one (CreateRenderPass).
 		// The sampled target (what the post-process pass reads) is the color
 		// attachment without MSAA, or the resolve attachment with it — in both
 		// cases it carries SHADER_READ_ONLY final layout + STORE.
@@ -263,11 +371,12 @@ namespace Nightbloom
 			depthAttachment.format = VK_FORMAT_D32_SFLOAT;
 			depthAttachment.samples = m_SampleCount;
 			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // We don't need depth after rendering
+			// Stored and left read-only: the Hi-Z pyramid build samples it after the pass
+			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 			depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 			depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 			depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 
 			depthAttachmentRef.attachment = 1; // Second attachment
 			depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
@@ -296,6 +405,30 @@ namespace Nightbloom
 			attachments.push_back(resolveAttachment);
 		}
 
+		// Depth resolve (MSAA with a resolve mode) — the single-sample depth
+		// the temporal upscale samples. Only written by the resolve, so its
+		// prior contents are never loaded; the MS depth stays stored for the
+		// OIT pass and the Hi-Z build, which need every sample.
+		VkAttachmentReference depthResolveRef{};
+		const bool resolveDepth = msaa && hasDepth && m_DepthResolveMode != VK_RESOLVE_MODE_NONE;
+		if (resolveDepth)
+		{
+			VkAttachmentDescription depthResolveAttachment{};
+			depthResolveAttachment.format = m_DepthFormat;
+			depthResolveAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+			depthResolveAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			depthResolveAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			depthResolveAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			depthResolveAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			depthResolveAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			depthResolveAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+			depthResolveRef.attachment = static_cast<uint32_t>(attachments.size());
+			depthResolveRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+			attachments.push_back(depthResolveAttachment);
+		}
+
 		// Subpass description
 		VkSubpassDescription subpass{};
 		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
@@ -308,14 +441,16 @@ namespace Nightbloom
 		VkSubpassDependency dependencyIn{};
 		dependencyIn.srcSubpass = VK_SUBPASS_EXTERNAL;
 		dependencyIn.dstSubpass = 0;
-		dependencyIn.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		// Compute: the previous frame's temporal resolve read the color (and depth)
+		dependencyIn.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 		dependencyIn.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		dependencyIn.srcAccessMask = 0;
 		dependencyIn.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
 		if (hasDepth)
 		{
-			dependencyIn.srcStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+			// Compute: the previous frame's Hi-Z build read this depth buffer
+			dependencyIn.srcStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 			dependencyIn.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 			dependencyIn.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 		}
@@ -328,11 +463,20 @@ namespace Nightbloom
 		VkSubpassDependency dependencyOut{};
 		dependencyOut.srcSubpass = 0;
 		dependencyOut.dstSubpass = VK_SUBPASS_EXTERNAL;
+		// Compute reads the color too (TemporalUpscaler's resolve).
 		dependencyOut.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependencyOut.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencyOut.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 		dependencyOut.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 		dependencyOut.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
+		if (hasDepth)
+		{
+			// Depth writes visible to the Hi-Z build and the temporal resolve (compute)
+			dependencyOut.srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			dependencyOut.dstStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			dependencyOut.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		}
+
 		std::array<VkSubpassDependency, 2> dependencies = { dependencyIn, dependencyOut };
 
 		// Create render pass
@@ -345,14 +489,18 @@ namespace Nightbloom
 		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
 		renderPassInfo.pDependencies = dependencies.data();
 
-		if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_SceneRenderPass) != VK_SUCCESS)
+		// Depth resolves run in the color-attachment-output stage as color
+		// attachment writes, which dependencyOut already makes visible to compute
+		if (CreateRenderPass(device, renderPassInfo, &m_SceneRenderPass,
+			resolveDepth ? &depthResolveRef : nullptr, m_DepthResolveMode) != VK_SUCCESS)
 		{
 			LOG_ERROR("Failed to create scene render pass");
 			return false;
 		}
 
 		m_HasDepth = hasDepth;
-		LOG_INFO("Scene render pass created (depth: {})", hasDepth);
+		LOG_INFO("Scene render pass created (depth: {}, depth resolve: {}, shading-rate attachment: {})",
+			hasDepth, resolveDepth, HasShadingRateAttachment());
 		return true;
 	}
 
@@ -369,8 +517,12 @@ namespace Nightbloom
 		imageInfo.height = extent.height;
 		imageInfo.format = colorFormat;
 		imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		if (m_SceneColorStorage)
+			imageInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;  // ContactShadows darkens it in place
 		imageInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.category = GpuMemoryCategory::RenderTarget;
+		imageInfo.debugName = "SceneColor";
 
 		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
 		if (!allocation)
@@ -422,7 +574,8 @@ namespace Nightbloom
 		samplerInfo.minLod = 0.0f;
 		samplerInfo.maxLod = 0.0f;
 
-		if (vkCreateSampler(device, &samplerInfo, nullptr, &m_SceneColorSampler) != VK_SUCCESS)
+		m_SceneColorSampler = m_SamplerCache->GetSampler(samplerInfo);
+		if (m_SceneColorSampler == VK_NULL_HANDLE)
 		{
 			LOG_ERROR("Failed to create scene color sampler");
 			vkDestroyImageView(device, m_SceneColorImageView, nullptr);
@@ -442,8 +595,10 @@ namespace Nightbloom
 			msInfo.height = extent.height;
 			msInfo.format = colorFormat;
 			msInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-			msInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+			msInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
 			msInfo.samples = m_SampleCount;
+			msInfo.category = GpuMemoryCategory::RenderTarget;
+			msInfo.debugName = "SceneColorMSAA";
 
 			auto* msAlloc = m_MemoryManager->CreateImage(msInfo);
 			if (!msAlloc)
@@ -494,11 +649,7 @@ namespace Nightbloom
 			m_SceneColorMSImage = VK_NULL_HANDLE;
 		}
 
-		if (m_SceneColorSampler != VK_NULL_HANDLE)
-		{
-			vkDestroySampler(device, m_SceneColorSampler, nullptr);
-			m_SceneColorSampler = VK_NULL_HANDLE;
-		}
+		m_SceneColorSampler = VK_NULL_HANDLE;  // owned by the sampler cache
 
 		if (m_SceneColorImageView != VK_NULL_HANDLE)
 		{
@@ -520,6 +671,7 @@ namespace Nightbloom
 		// Attachment order must match CreateSceneRenderPass:
 		//   no MSAA  : [0]=color(sampled), [1]=depth
 		//   with MSAA: [0]=MS color, [1]=MS depth, [2]=resolve color(sampled)
+		//              [3]=resolve depth (with a depth resolve mode)
 		const bool msaa = (m_SampleCount != VK_SAMPLE_COUNT_1_BIT);
 
 		std::vector<VkImageView> attachments;
@@ -535,6 +687,17 @@ namespace Nightbloom
 			attachments.push_back(m_SceneColorImageView); // resolve target
 		}
 
+		if (m_HasDepth && HasDepthResolve())
+		{
+			attachments.push_back(m_DepthResolveImageView);
+		}
+
+		// Last, as CreateRenderPass appends it
+		if (HasShadingRateAttachment())
+		{
+			attachments.push_back(m_ShadingRateImageView);
+		}
+
 		VkFramebufferCreateInfo framebufferInfo{};
 		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		framebufferInfo.renderPass = m_SceneRenderPass;
@@ -563,6 +726,293 @@ namespace Nightbloom
 		}
 	}
 
+	bool RenderPassManager::CreateOitRenderPass(VkDevice device)
+	{
+		const bool msaa = (m_SampleCount != VK_SAMPLE_COUNT_1_BIT);
+		if (!m_HasDepth)
+		{
+			return false;
+		}
+
+		// Attachment layout:
+		//   [0]=accumulation, [1]=revealage (multisampled with MSAA)
+		//   [2]=scene depth, [3]=scene color (the sampled target)
+		//   with MSAA: [4]=accumulation resolve, [5]=revealage resolve
+		// No shading-rate attachment: the OIT twins are full-rate.
+		std::vector<VkAttachmentDescription> attachments;
+
+		// Both targets start cleared (nothing accumulated, everything
+		// revealed) and die with the pass. What subpass 1 reads ends in
+		// SHADER_READ_ONLY, the layout it was last used in.
+		auto target = [&](VkFormat format, VkSampleCountFlagBits samples, VkAttachmentLoadOp loadOp,
+			VkImageLayout finalLayout)
+		{
+			VkAttachmentDescription attachment{};
+			attachment.format = format;
+			attachment.samples = samples;
+			attachment.loadOp = loadOp;
+			attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			attachment.finalLayout = finalLayout;
+			attachments.push_back(attachment);
+		};
+		const VkImageLayout targetFinal = msaa
+			? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+			: VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		target(OIT_ACCUMULATION_FORMAT, m_SampleCount, VK_ATTACHMENT_LOAD_OP_CLEAR, targetFinal);
+		target(OIT_REVEALAGE_FORMAT, m_SampleCount, VK_ATTACHMENT_LOAD_OP_CLEAR, targetFinal);
+
+		// Scene depth: tested against, never written
+		VkAttachmentDescription depthAttachment{};
+		depthAttachment.format = m_DepthFormat;
+		depthAttachment.samples = m_SampleCount;
+		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+		attachments.push_back(depthAttachment);
+
+		// Scene color (single-sample; the resolve target under MSAA): the
+		// composite blends onto it
+		VkAttachmentDescription colorAttachment{};
+		colorAttachment.format = m_SceneColorFormat;
+		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		attachments.push_back(colorAttachment);
+
+		if (msaa)
+		{
+			target(OIT_ACCUMULATION_FORMAT, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			target(OIT_REVEALAGE_FORMAT, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+
+		// Subpass 0: accumulate
+		std::array<VkAttachmentReference, 2> accumulateRefs = { {
+			{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+			{ 1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL } } };
+		std::array<VkAttachmentReference, 2> resolveRefs = { {
+			{ 4, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+			{ 5, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL } } };
+		VkAttachmentReference depthRef = { 2, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL };
+
+		// Subpass 1: composite
+		const uint32_t readFirst = msaa ? 4u : 0u;
+		std::array<VkAttachmentReference, 2> inputRefs = { {
+			{ readFirst, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
+			{ readFirst + 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL } } };
+		VkAttachmentReference compositeRef = { 3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+		std::array<VkSubpassDescription, 2> subpasses{};
+		subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpasses[0].colorAttachmentCount = static_cast<uint32_t>(accumulateRefs.size());
+		subpasses[0].pColorAttachments = accumulateRefs.data();
+		subpasses[0].pResolveAttachments = msaa ? resolveRefs.data() : nullptr;
+		subpasses[0].pDepthStencilAttachment = &depthRef;
+
+		subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpasses[1].inputAttachmentCount = static_cast<uint32_t>(inputRefs.size());
+		subpasses[1].pInputAttachments = inputRefs.data();
+		subpasses[1].colorAttachmentCount = 1;
+		subpasses[1].pColorAttachments = &compositeRef;
+
+		std::array<VkSubpassDependency, 4> dependencies{};
+
+		// The scene pass's outgoing dependency only covers shader reads: wait
+		// for its depth and color writes here. Fragment shader: last frame's
+		// composite read the targets this subpass clears.
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+			VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+			VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+		// Scene color from the scene pass into the composite
+		dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].dstSubpass = 1;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+		// Accumulated (and resolved) targets into the composite's input
+		// attachments; each pixel only reads its own
+		dependencies[2].srcSubpass = 0;
+		dependencies[2].dstSubpass = 1;
+		dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[2].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[2].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+		dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+		// Same readers as after the scene pass: bloom, the temporal resolve
+		// and the post-process passes sample the composited scene color
+		dependencies[3].srcSubpass = 1;
+		dependencies[3].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[3].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[3].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		dependencies[3].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[3].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+		renderPassInfo.pSubpasses = subpasses.data();
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+
+		if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_OitRenderPass) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create OIT render pass");
+			return false;
+		}
+
+		LOG_INFO("OIT render pass created (attachments: {})", attachments.size());
+		return true;
+	}
+
+	bool RenderPassManager::CreateOitTarget(VkDevice device, VkFormat format, VkExtent2D extent,
+		VkSampleCountFlagBits samples, VkImageUsageFlags usage, const char* debugName, OitTarget& target)
+	{
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = extent.width;
+		imageInfo.height = extent.height;
+		imageInfo.format = format;
+		imageInfo.usage = usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		imageInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+		imageInfo.samples = samples;
+		imageInfo.category = GpuMemoryCategory::RenderTarget;
+		imageInfo.debugName = debugName;
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("Failed to create {} image", debugName);
+			return false;
+		}
+		target.allocation = allocation;
+		target.image = allocation->image;
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = target.image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = format;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		if (vkCreateImageView(device, &viewInfo, nullptr, &target.view) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create {} image view", debugName);
+			DestroyOitTarget(device, target);
+			return false;
+		}
+		return true;
+	}
+
+	void RenderPassManager::DestroyOitTarget(VkDevice device, OitTarget& target)
+	{
+		if (target.view != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, target.view, nullptr);
+		}
+		if (target.allocation && m_MemoryManager)
+		{
+			m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(target.allocation));
+		}
+		target = OitTarget{};
+	}
+
+	bool RenderPassManager::CreateOitResources(VkDevice device, VkExtent2D extent)
+	{
+		if (m_OitRenderPass == VK_NULL_HANDLE || !m_MemoryManager)
+		{
+			return false;
+		}
+
+		// The composite reads the single-sample pair; under MSAA they are
+		// the resolves of the multisampled pair subpass 0 renders into
+		const bool msaa = (m_SampleCount != VK_SAMPLE_COUNT_1_BIT);
+		const VkImageUsageFlags readUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+		bool created =
+			CreateOitTarget(device, OIT_ACCUMULATION_FORMAT, extent, VK_SAMPLE_COUNT_1_BIT, readUsage,
+				"OitAccumulation", m_OitAccumulation) &&
+			CreateOitTarget(device, OIT_REVEALAGE_FORMAT, extent, VK_SAMPLE_COUNT_1_BIT, readUsage,
+				"OitRevealage", m_OitRevealage);
+		if (created && msaa)
+		{
+			created =
+				CreateOitTarget(device, OIT_ACCUMULATION_FORMAT, extent, m_SampleCount,
+					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, "OitAccumulationMSAA", m_OitAccumulationMS) &&
+				CreateOitTarget(device, OIT_REVEALAGE_FORMAT, extent, m_SampleCount,
+					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, "OitRevealageMSAA", m_OitRevealageMS);
+		}
+		if (!created)
+		{
+			DestroyOitResources(device);
+			return false;
+		}
+
+		// Attachment order must match CreateOitRenderPass
+		std::vector<VkImageView> attachments;
+		attachments.push_back(msaa ? m_OitAccumulationMS.view : m_OitAccumulation.view);
+		attachments.push_back(msaa ? m_OitRevealageMS.view : m_OitRevealage.view);
+		attachments.push_back(m_DepthImageView);
+		attachments.push_back(m_SceneColorImageView);
+		if (msaa)
+		{
+			attachments.push_back(m_OitAccumulation.view);
+			attachments.push_back(m_OitRevealage.view);
+		}
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_OitRenderPass;
+		framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		framebufferInfo.pAttachments = attachments.data();
+		framebufferInfo.width = extent.width;
+		framebufferInfo.height = extent.height;
+		framebufferInfo.layers = 1;
+
+		if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_OitFramebuffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create OIT framebuffer");
+			DestroyOitResources(device);
+			return false;
+		}
+		return true;
+	}
+
+	void RenderPassManager::DestroyOitResources(VkDevice device)
+	{
+		if (m_OitFramebuffer != VK_NULL_HANDLE)
+		{
+			vkDestroyFramebuffer(device, m_OitFramebuffer, nullptr);
+			m_OitFramebuffer = VK_NULL_HANDLE;
+		}
+		DestroyOitTarget(device, m_OitAccumulationMS);
+		DestroyOitTarget(device, m_OitRevealageMS);
+		DestroyOitTarget(device, m_OitAccumulation);
+		DestroyOitTarget(device, m_OitRevealage);
+	}
+
 	bool RenderPassManager::CreatePostProcessRenderPass(VkDevice device, VkFormat colorFormat)
 	{
 		// Color only — the post-process composite/AA pass doesn't depth-test,
@@ -663,179 +1113,87 @@ namespace Nightbloom
 		m_PostProcessFramebuffers.clear();
 	}
 
-	bool RenderPassManager::CreateBloomRenderPass(VkDevice device, VkFormat colorFormat)
-	{
-		// Color-only, single-sample. Every bloom sub-pass (extract + both blurs) overwrites
-		// the whole target via a full-screen triangle, so loadOp = DONT_CARE. Final layout is
-		// SHADER_READ so the next sub-pass / the composite can sample it directly.
-		VkAttachmentDescription colorAttachment{};
-		colorAttachment.format = colorFormat;
-		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-		VkAttachmentReference colorRef{};
-		colorRef.attachment = 0;
-		colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-		VkSubpassDescription subpass{};
-		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpass.colorAttachmentCount = 1;
-		subpass.pColorAttachments = &colorRef;
-
-		// Order the sequential sub-passes that ping-pong A<->B: (0) a prior fragment-shader
-		// read of this image must complete before we write it again; (1) our color write must
-		// complete before the next pass (or the post-process composite) samples it.
-		VkSubpassDependency deps[2]{};
-		deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-		deps[0].dstSubpass = 0;
-		deps[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		deps[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-		deps[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		deps[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		deps[1].srcSubpass = 0;
-		deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-		deps[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		deps[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		deps[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		deps[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-		VkRenderPassCreateInfo rpInfo{};
-		rpInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		rpInfo.attachmentCount = 1;
-		rpInfo.pAttachments = &colorAttachment;
-		rpInfo.subpassCount = 1;
-		rpInfo.pSubpasses = &subpass;
-		rpInfo.dependencyCount = 2;
-		rpInfo.pDependencies = deps;
-
-		if (vkCreateRenderPass(device, &rpInfo, nullptr, &m_BloomRenderPass) != VK_SUCCESS)
-		{
-			LOG_ERROR("Failed to create bloom render pass");
-			return false;
-		}
-		LOG_INFO("Bloom render pass created");
-		return true;
-	}
-
-	bool RenderPassManager::CreateBloomResources(VkDevice device, VkFormat colorFormat, VkExtent2D fullExtent)
+	bool RenderPassManager::CreateTransientTargets(VkFormat colorFormat, VkExtent2D extent)
 	{
 		if (!m_MemoryManager)
 		{
-			LOG_ERROR("Memory manager not set - cannot create bloom resources");
+			LOG_ERROR("Memory manager not set - cannot create transient targets");
 			return false;
 		}
 
 		// Half resolution — cheaper and naturally softer; the blur spans fewer texels.
-		m_BloomExtent.width  = (fullExtent.width  > 1) ? fullExtent.width  / 2 : 1;
-		m_BloomExtent.height = (fullExtent.height > 1) ? fullExtent.height / 2 : 1;
-
-		auto createTarget = [&](VkImage& img, VkImageView& view, void*& alloc) -> bool
-		{
-			VulkanMemoryManager::ImageCreateInfo info{};
-			info.width = m_BloomExtent.width;
-			info.height = m_BloomExtent.height;
-			info.format = colorFormat;
-			info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-			info.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-			info.samples = VK_SAMPLE_COUNT_1_BIT;
-
-			auto* a = m_MemoryManager->CreateImage(info);
-			if (!a) return false;
-			alloc = a;
-			img = a->image;
-
-			VkImageViewCreateInfo vi{};
-			vi.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-			vi.image = img;
-			vi.viewType = VK_IMAGE_VIEW_TYPE_2D;
-			vi.format = colorFormat;
-			vi.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			vi.subresourceRange.baseMipLevel = 0;
-			vi.subresourceRange.levelCount = 1;
-			vi.subresourceRange.baseArrayLayer = 0;
-			vi.subresourceRange.layerCount = 1;
-			return vkCreateImageView(device, &vi, nullptr, &view) == VK_SUCCESS;
-		};
-
-		if (!createTarget(m_BloomImageA, m_BloomImageViewA, m_BloomAllocationA))
-		{
-			LOG_ERROR("Failed to create bloom target A");
-			return false;
-		}
-		if (!createTarget(m_BloomImageB, m_BloomImageViewB, m_BloomAllocationB))
-		{
-			LOG_ERROR("Failed to create bloom target B");
-			return false;
-		}
-
-		// Linear filtering (the blur and the composite upscale rely on it), clamp-to-edge
-		// so blur taps near the border don't wrap.
-		VkSamplerCreateInfo si{};
-		si.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-		si.magFilter = VK_FILTER_LINEAR;
-		si.minFilter = VK_FILTER_LINEAR;
-		si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-		si.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-		si.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-		si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-		si.maxLod = 0.0f;
-		if (vkCreateSampler(device, &si, nullptr, &m_BloomSampler) != VK_SUCCESS)
-		{
-			LOG_ERROR("Failed to create bloom sampler");
-			return false;
-		}
-
-		auto createFB = [&](VkImageView view, VkFramebuffer& fb) -> bool
-		{
-			VkFramebufferCreateInfo fi{};
-			fi.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			fi.renderPass = m_BloomRenderPass;
-			fi.attachmentCount = 1;
-			fi.pAttachments = &view;
-			fi.width = m_BloomExtent.width;
-			fi.height = m_BloomExtent.height;
-			fi.layers = 1;
-			return vkCreateFramebuffer(device, &fi, nullptr, &fb) == VK_SUCCESS;
-		};
-		if (!createFB(m_BloomImageViewA, m_BloomFramebufferA) ||
-			!createFB(m_BloomImageViewB, m_BloomFramebufferB))
+		m_BloomExtent.width  = (extent.width  > 1) ? extent.width  / 2 : 1;
+		m_BloomExtent.height = (extent.height > 1) ? extent.height / 2 : 1;
+
+		// Stop before the smallest mip drops under 8 texels; the wider
+		// passes below that only spread the same few texels around
+		const uint32_t shortSide = std::min(m_BloomExtent.width, m_BloomExtent.height);
+		m_BloomMipCount = 1;
+		while (m_BloomMipCount < MAX_BLOOM_MIPS && (shortSide >> m_BloomMipCount) >= 8)
+		{
+			++m_BloomMipCount;
+		}
+
+		VulkanMemoryManager::ImageCreateInfo reflection{};
+		reflection.width = extent.width;
+		reflection.height = extent.height;
+		reflection.format = colorFormat;
+		reflection.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		reflection.samples = VK_SAMPLE_COUNT_1_BIT;
+		reflection.category = GpuMemoryCategory::RenderTarget;
+		reflection.debugName = "ReflectionColor";
+
+		VulkanMemoryManager::ImageCreateInfo bloom{};
+		bloom.width = m_BloomExtent.width;
+		bloom.height = m_BloomExtent.height;
+		bloom.mipLevels = m_BloomMipCount;
+		bloom.format = BLOOM_FORMAT;
+		bloom.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		bloom.samples = VK_SAMPLE_COUNT_1_BIT;
+		bloom.category = GpuMemoryCategory::RenderTarget;
+		bloom.debugName = "Bloom";
+
+		// Phase 1: reflection pass -> scene pass. Phase 2: bloom -> post-process.
+		// A persistent reflection is read on later frames too, so it gets a
+		// phase's memory to itself alongside the chain.
+		m_TransientTargets = m_ReflectionPersistent
+			? m_MemoryManager->CreateAliasedImages({ { reflection, bloom } })
+			: m_MemoryManager->CreateAliasedImages({ { reflection }, { bloom } });
+		if (!m_TransientTargets)
 		{
-			LOG_ERROR("Failed to create bloom framebuffer(s)");
 			return false;
 		}
 
-		LOG_INFO("Bloom resources created: {}x{}", m_BloomExtent.width, m_BloomExtent.height);
+		m_ReflectionColorImage = m_TransientTargets->images[0];
+		m_BloomImage = m_TransientTargets->images[1];
 		return true;
 	}
 
-	void RenderPassManager::DestroyBloomResources(VkDevice device)
+	void RenderPassManager::DestroyTransientTargets()
 	{
-		if (m_BloomFramebufferA != VK_NULL_HANDLE) { vkDestroyFramebuffer(device, m_BloomFramebufferA, nullptr); m_BloomFramebufferA = VK_NULL_HANDLE; }
-		if (m_BloomFramebufferB != VK_NULL_HANDLE) { vkDestroyFramebuffer(device, m_BloomFramebufferB, nullptr); m_BloomFramebufferB = VK_NULL_HANDLE; }
-		if (m_BloomSampler != VK_NULL_HANDLE) { vkDestroySampler(device, m_BloomSampler, nullptr); m_BloomSampler = VK_NULL_HANDLE; }
-		if (m_BloomImageViewA != VK_NULL_HANDLE) { vkDestroyImageView(device, m_BloomImageViewA, nullptr); m_BloomImageViewA = VK_NULL_HANDLE; }
-		if (m_BloomImageViewB != VK_NULL_HANDLE) { vkDestroyImageView(device, m_BloomImageViewB, nullptr); m_BloomImageViewB = VK_NULL_HANDLE; }
-		if (m_BloomAllocationA && m_MemoryManager) { m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_BloomAllocationA)); m_BloomAllocationA = nullptr; m_BloomImageA = VK_NULL_HANDLE; }
-		if (m_BloomAllocationB && m_MemoryManager) { m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_BloomAllocationB)); m_BloomAllocationB = nullptr; m_BloomImageB = VK_NULL_HANDLE; }
+		if (m_TransientTargets && m_MemoryManager)
+		{
+			m_MemoryManager->DestroyAliasedImages(m_TransientTargets);
+		}
+		m_TransientTargets = nullptr;
+		m_ReflectionColorImage = VK_NULL_HANDLE;
+		m_BloomImage = VK_NULL_HANDLE;
+		m_BloomMipCount = 0;
 	}
 
 	bool RenderPassManager::CreateReflectionRenderPass(VkDevice device, VkFormat colorFormat)
 	{
-		// MUST match the scene render pass's attachment structure (formats +
-		// sample count) so the scene's Mesh/Terrain/Foliage pipelines are
-		// render-pass-compatible when reused here. Mirrors CreateSceneRenderPass:
+		// Mirrors the scene render pass's attachment structure (formats), so at
+		// the scene's sample count the scene's Mesh/Terrain/Foliage pipelines
+		// are render-pass-compatible here; at a lower count the Renderer binds
+		// the GetReflectionPipeline twins instead. Mirrors CreateSceneRenderPass:
 		//   no MSAA  : [0]=color(sampled), [1]=depth
 		//   with MSAA: [0]=MS color, [1]=MS depth, [2]=resolve color(sampled)
-		const bool msaa = (m_SampleCount != VK_SAMPLE_COUNT_1_BIT);
+		const bool msaa = (m_ReflectionSampleCount != VK_SAMPLE_COUNT_1_BIT);
 
 		VkAttachmentDescription colorAttachment{};
 		colorAttachment.format = colorFormat;
-		colorAttachment.samples = m_SampleCount;
+		colorAttachment.samples = m_ReflectionSampleCount;
 		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 		colorAttachment.storeOp = msaa ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
 		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -853,7 +1211,7 @@ namespace Nightbloom
 
 		VkAttachmentDescription depthAttachment{};
 		depthAttachment.format = m_DepthFormat;
-		depthAttachment.samples = m_SampleCount;
+		depthAttachment.samples = m_ReflectionSampleCount;
 		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -894,9 +1252,12 @@ namespace Nightbloom
 		VkSubpassDependency dependencyIn{};
 		dependencyIn.srcSubpass = VK_SUBPASS_EXTERNAL;
 		dependencyIn.dstSubpass = 0;
-		dependencyIn.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		// The color target aliases the bloom chain, which the previous
+		// frame's compute passes wrote and its post-process pass sampled
+		dependencyIn.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 		dependencyIn.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependencyIn.srcAccessMask = 0;
+		dependencyIn.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
 		dependencyIn.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
 		// The water surface (in the later scene pass) samples this color as a
@@ -920,13 +1281,13 @@ namespace Nightbloom
 		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
 		renderPassInfo.pDependencies = dependencies.data();
 
-		if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_ReflectionRenderPass) != VK_SUCCESS)
+		if (CreateRenderPass(device, renderPassInfo, &m_ReflectionRenderPass) != VK_SUCCESS)
 		{
 			LOG_ERROR("Failed to create reflection render pass");
 			return false;
 		}
 
-		LOG_INFO("Reflection render pass created (samples={})", static_cast<int>(m_SampleCount));
+		LOG_INFO("Reflection render pass created (samples={})", static_cast<int>(m_ReflectionSampleCount));
 		return true;
 	}
 
@@ -941,23 +1302,13 @@ namespace Nightbloom
 		m_ReflectionExtent = extent;
 
 		// Single-sample color target — the SAMPLED resolve target under MSAA,
-		// or the color attachment itself without MSAA.
-		VulkanMemoryManager::ImageCreateInfo colorInfo{};
-		colorInfo.width = extent.width;
-		colorInfo.height = extent.height;
-		colorInfo.format = colorFormat;
-		colorInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-		colorInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-		colorInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-
-		auto* colorAlloc = m_MemoryManager->CreateImage(colorInfo);
-		if (!colorAlloc)
+		// or the color attachment itself without MSAA. The image is aliased
+		// with the bloom chain (CreateTransientTargets).
+		if (m_ReflectionColorImage == VK_NULL_HANDLE)
 		{
-			LOG_ERROR("Failed to create reflection color image");
+			LOG_ERROR("Reflection color image not created - call CreateTransientTargets first");
 			return false;
 		}
-		m_ReflectionColorAllocation = colorAlloc;
-		m_ReflectionColorImage = colorAlloc->image;
 
 		VkImageViewCreateInfo colorView{};
 		colorView.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -995,7 +1346,8 @@ namespace Nightbloom
 		samplerInfo.minLod = 0.0f;
 		samplerInfo.maxLod = 0.0f;
 
-		if (vkCreateSampler(device, &samplerInfo, nullptr, &m_ReflectionColorSampler) != VK_SUCCESS)
+		m_ReflectionColorSampler = m_SamplerCache->GetSampler(samplerInfo);
+		if (m_ReflectionColorSampler == VK_NULL_HANDLE)
 		{
 			LOG_ERROR("Failed to create reflection color sampler");
 			DestroyReflectionResources(device);
@@ -1011,9 +1363,13 @@ namespace Nightbloom
 		depthInfo.arrayLayers = 1;
 		depthInfo.format = m_DepthFormat;
 		depthInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-		depthInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-		depthInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-		depthInfo.samples = m_SampleCount;
+		// Never stored or sampled: transient, lazily allocated where the device
+		// supports it (tiled GPUs keep it in tile memory)
+		depthInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		depthInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+		depthInfo.samples = m_ReflectionSampleCount;
+		depthInfo.category = GpuMemoryCategory::RenderTarget;
+		depthInfo.debugName = "ReflectionDepth";
 
 		auto* depthAlloc = m_MemoryManager->CreateImage(depthInfo);
 		if (!depthAlloc)
@@ -1045,15 +1401,17 @@ namespace Nightbloom
 
 		// Multisampled color attachment (rendered into, resolved into the
 		// single-sample color target above). Only needed with MSAA.
-		if (m_SampleCount != VK_SAMPLE_COUNT_1_BIT)
+		if (m_ReflectionSampleCount != VK_SAMPLE_COUNT_1_BIT)
 		{
 			VulkanMemoryManager::ImageCreateInfo msInfo{};
 			msInfo.width = extent.width;
 			msInfo.height = extent.height;
 			msInfo.format = colorFormat;
 			msInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-			msInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-			msInfo.samples = m_SampleCount;
+			msInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+			msInfo.samples = m_ReflectionSampleCount;
+			msInfo.category = GpuMemoryCategory::RenderTarget;
+			msInfo.debugName = "ReflectionColorMSAA";
 
 			auto* msAlloc = m_MemoryManager->CreateImage(msInfo);
 			if (!msAlloc)
@@ -1085,7 +1443,7 @@ namespace Nightbloom
 		}
 
 		LOG_INFO("Reflection target created: {}x{}, samples={}",
-			extent.width, extent.height, static_cast<int>(m_SampleCount));
+			extent.width, extent.height, static_cast<int>(m_ReflectionSampleCount));
 		return true;
 	}
 
@@ -1117,23 +1475,12 @@ namespace Nightbloom
 			m_ReflectionDepthImage = VK_NULL_HANDLE;
 		}
 
-		if (m_ReflectionColorSampler != VK_NULL_HANDLE)
-		{
-			vkDestroySampler(device, m_ReflectionColorSampler, nullptr);
-			m_ReflectionColorSampler = VK_NULL_HANDLE;
-		}
+		m_ReflectionColorSampler = VK_NULL_HANDLE;  // owned by the sampler cache
 		if (m_ReflectionColorImageView != VK_NULL_HANDLE)
 		{
 			vkDestroyImageView(device, m_ReflectionColorImageView, nullptr);
 			m_ReflectionColorImageView = VK_NULL_HANDLE;
 		}
-		if (m_ReflectionColorAllocation && m_MemoryManager)
-		{
-			m_MemoryManager->DestroyImage(
-				static_cast<VulkanMemoryManager::ImageAllocation*>(m_ReflectionColorAllocation));
-			m_ReflectionColorAllocation = nullptr;
-			m_ReflectionColorImage = VK_NULL_HANDLE;
-		}
 	}
 
 	bool RenderPassManager::CreateReflectionFramebuffer(VkDevice device, VkExtent2D extent)
@@ -1141,7 +1488,7 @@ namespace Nightbloom
 		// Attachment order must match CreateReflectionRenderPass:
 		//   no MSAA  : [0]=color(sampled), [1]=depth
 		//   with MSAA: [0]=MS color, [1]=MS depth, [2]=resolve color(sampled)
-		const bool msaa = (m_SampleCount != VK_SAMPLE_COUNT_1_BIT);
+		const bool msaa = (m_ReflectionSampleCount != VK_SAMPLE_COUNT_1_BIT);
 
 		std::vector<VkImageView> attachments;
 		attachments.push_back(msaa ? m_ReflectionColorMSImageView : m_ReflectionColorImageView);
@@ -1150,6 +1497,10 @@ namespace Nightbloom
 		{
 			attachments.push_back(m_ReflectionColorImageView); // resolve target
 		}
+		if (HasShadingRateAttachment())
+		{
+			attachments.push_back(m_ReflectionShadingRateImageView);
+		}
 
 		VkFramebufferCreateInfo framebufferInfo{};
 		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -1179,6 +1530,180 @@ namespace Nightbloom
 		}
 	}
 
+	bool RenderPassManager::EnsureAuxiliaryTarget(VkDevice device, uint32_t view, VkExtent2D extent,
+		VulkanDeletionQueue* deletionQueue)
+	{
+		if (view >= MAX_AUXILIARY_VIEWS || !SupportsAuxiliaryTargets() || !m_MemoryManager)
+			return false;
+
+		extent.width = std::clamp(extent.width, 1u, std::max(m_ReflectionExtent.width, 1u));
+		extent.height = std::clamp(extent.height, 1u, std::max(m_ReflectionExtent.height, 1u));
+
+		AuxiliaryTarget& target = m_AuxiliaryTargets[view];
+		if (target.framebuffer != VK_NULL_HANDLE && target.extent.width == extent.width &&
+			target.extent.height == extent.height)
+		{
+			return true;
+		}
+
+		// Frames in flight may still draw into or sample the old target
+		if (target.framebuffer != VK_NULL_HANDLE || target.colorAllocation)
+		{
+			if (deletionQueue)
+			{
+				VulkanMemoryManager* memoryManager = m_MemoryManager;
+				const AuxiliaryTarget old = target;
+				deletionQueue->Defer([device, memoryManager, old]()
+					{
+						vkDestroyFramebuffer(device, old.framebuffer, nullptr);
+						vkDestroyImageView(device, old.colorView, nullptr);
+						vkDestroyImageView(device, old.depthView, nullptr);
+						if (old.colorAllocation)
+							memoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(old.colorAllocation));
+						if (old.depthAllocation)
+							memoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(old.depthAllocation));
+					});
+				target = AuxiliaryTarget{};
+			}
+			else
+			{
+				DestroyAuxiliaryTarget(device, target);
+			}
+		}
+
+		return CreateAuxiliaryTarget(device, extent, target);
+	}
+
+	bool RenderPassManager::CreateAuxiliaryTarget(VkDevice device, VkExtent2D extent, AuxiliaryTarget& target)
+	{
+		target.extent = extent;
+
+		VulkanMemoryManager::ImageCreateInfo colorInfo{};
+		colorInfo.width = extent.width;
+		colorInfo.height = extent.height;
+		colorInfo.format = m_SceneColorFormat;
+		// Transfer source for Renderer::RequestAuxiliaryViewReadback
+		colorInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		colorInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+		colorInfo.category = GpuMemoryCategory::RenderTarget;
+		colorInfo.debugName = "AuxiliaryViewColor";
+
+		auto* colorAlloc = m_MemoryManager->CreateImage(colorInfo);
+		if (!colorAlloc)
+		{
+			LOG_ERROR("Failed to create auxiliary view color image");
+			DestroyAuxiliaryTarget(device, target);
+			return false;
+		}
+		target.colorAllocation = colorAlloc;
+		target.colorImage = colorAlloc->image;
+
+		// Same transient depth as the reflection target
+		VulkanMemoryManager::ImageCreateInfo depthInfo{};
+		depthInfo.width = extent.width;
+		depthInfo.height = extent.height;
+		depthInfo.format = m_DepthFormat;
+		depthInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		depthInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+		depthInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		depthInfo.category = GpuMemoryCategory::RenderTarget;
+		depthInfo.debugName = "AuxiliaryViewDepth";
+
+		auto* depthAlloc = m_MemoryManager->CreateImage(depthInfo);
+		if (!depthAlloc)
+		{
+			LOG_ERROR("Failed to create auxiliary view depth image");
+			DestroyAuxiliaryTarget(device, target);
+			return false;
+		}
+		target.depthAllocation = depthAlloc;
+		target.depthImage = depthAlloc->image;
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		viewInfo.image = target.colorImage;
+		viewInfo.format = m_SceneColorFormat;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &target.colorView) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create auxiliary view color image view");
+			DestroyAuxiliaryTarget(device, target);
+			return false;
+		}
+
+		viewInfo.image = target.depthImage;
+		viewInfo.format = m_DepthFormat;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &target.depthView) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create auxiliary view depth image view");
+			DestroyAuxiliaryTarget(device, target);
+			return false;
+		}
+
+		// Attachment order of the single-sample CreateReflectionRenderPass
+		std::vector<VkImageView> attachments = { target.colorView, target.depthView };
+		if (HasShadingRateAttachment())
+		{
+			attachments.push_back(m_ReflectionShadingRateImageView);
+		}
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_ReflectionRenderPass;
+		framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		framebufferInfo.pAttachments = attachments.data();
+		framebufferInfo.width = extent.width;
+		framebufferInfo.height = extent.height;
+		framebufferInfo.layers = 1;
+
+		if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &target.framebuffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create auxiliary view framebuffer");
+			DestroyAuxiliaryTarget(device, target);
+			return false;
+		}
+
+		LOG_INFO("Auxiliary view target created: {}x{}", extent.width, extent.height);
+		return true;
+	}
+
+	void RenderPassManager::DestroyAuxiliaryTarget(VkDevice device, AuxiliaryTarget& target)
+	{
+		if (target.framebuffer != VK_NULL_HANDLE)
+		{
+			vkDestroyFramebuffer(device, target.framebuffer, nullptr);
+		}
+		if (target.colorView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, target.colorView, nullptr);
+		}
+		if (target.depthView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, target.depthView, nullptr);
+		}
+		if (m_MemoryManager)
+		{
+			if (target.colorAllocation)
+				m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(target.colorAllocation));
+			if (target.depthAllocation)
+				m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(target.depthAllocation));
+		}
+		target = AuxiliaryTarget{};
+	}
+
+	void RenderPassManager::DestroyAuxiliaryTargets(VkDevice device)
+	{
+		for (AuxiliaryTarget& target : m_AuxiliaryTargets)
+		{
+			DestroyAuxiliaryTarget(device, target);
+		}
+	}
+
 	bool RenderPassManager::CreateDepthResources(VkDevice device, VkExtent2D extent)
 	{
 		if (!m_MemoryManager)
@@ -1195,11 +1720,13 @@ namespace Nightbloom
 		imageInfo.arrayLayers = 1;
 		imageInfo.format = m_DepthFormat;
 		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-		imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT; // sampled by the Hi-Z build
 		imageInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 		imageInfo.samples = m_SampleCount; // must match the scene color sample count
 
 		// Create the image through vma
+		imageInfo.category = GpuMemoryCategory::RenderTarget;
+		imageInfo.debugName = "SceneDepth";
 
 		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
 		if (!allocation)
@@ -1234,6 +1761,30 @@ namespace Nightbloom
 
 		LOG_INFO("Depth buffer created: {}x{}, format={}",
 			extent.width, extent.height, static_cast<int>(m_DepthFormat));
+
+		if (m_DepthResolveMode == VK_RESOLVE_MODE_NONE)
+			return true;
+
+		VulkanMemoryManager::ImageCreateInfo resolveInfo = imageInfo;
+		resolveInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		resolveInfo.debugName = "SceneDepthResolve";
+		auto* resolveAllocation = m_MemoryManager->CreateImage(resolveInfo);
+		if (!resolveAllocation)
+		{
+			LOG_ERROR("Failed to create depth resolve image");
+			DestroyDepthResources(device);
+			return false;
+		}
+		m_DepthResolveAllocation = resolveAllocation;
+		m_DepthResolveImage = resolveAllocation->image;
+
+		viewInfo.image = m_DepthResolveImage;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &m_DepthResolveImageView) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create depth resolve image view");
+			DestroyDepthResources(device);
+			return false;
+		}
 		return true;
 	}
 
@@ -1253,6 +1804,243 @@ namespace Nightbloom
 			m_DepthImage = VK_NULL_HANDLE;
 		}
 
+		if (m_DepthResolveImageView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, m_DepthResolveImageView, nullptr);
+			m_DepthResolveImageView = VK_NULL_HANDLE;
+		}
+
+		if (m_DepthResolveAllocation && m_MemoryManager)
+		{
+			m_MemoryManager->DestroyImage(
+				static_cast<VulkanMemoryManager::ImageAllocation*>(m_DepthResolveAllocation));
+			m_DepthResolveAllocation = nullptr;
+			m_DepthResolveImage = VK_NULL_HANDLE;
+		}
+
 		LOG_INFO("Depth resources destroyed");
 	}
+
+	bool RenderPassManager::CreateShadingRateResources(VkDevice device, VkExtent2D extent)
+	{
+		if (!HasShadingRateAttachment())
+			return true;
+		if (!m_MemoryManager)
+		{
+			LOG_ERROR("Memory manager not set - cannot create shading-rate images");
+			return false;
+		}
+
+		// One texel per tile, rounding up so partial tiles at the edges are covered
+		m_ShadingRateExtent.width = (extent.width + m_ShadingRateTexelSize.width - 1) / m_ShadingRateTexelSize.width;
+		m_ShadingRateExtent.height = (extent.height + m_ShadingRateTexelSize.height - 1) / m_ShadingRateTexelSize.height;
+
+		auto createImage = [&](VkImage& image, VkImageView& view, void*& allocation, const char* name)
+		{
+			VulkanMemoryManager::ImageCreateInfo imageInfo{};
+			imageInfo.width = m_ShadingRateExtent.width;
+			imageInfo.height = m_ShadingRateExtent.height;
+			imageInfo.format = VK_FORMAT_R8_UINT;
+			// Written by VariableRateShading's compute pass (or cleared), read as the attachment
+			imageInfo.usage = VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR | VK_IMAGE_USAGE_STORAGE_BIT |
+				VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+			imageInfo.category = GpuMemoryCategory::RenderTarget;
+			imageInfo.debugName = name;
+
+			auto* created = m_MemoryManager->CreateImage(imageInfo);
+			if (!created)
+			{
+				LOG_ERROR("Failed to create {}x{} {}", m_ShadingRateExtent.width, m_ShadingRateExtent.height, name);
+				return false;
+			}
+			allocation = created;
+			image = created->image;
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = VK_FORMAT_R8_UINT;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.layerCount = 1;
+			if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to create {} view", name);
+				return false;
+			}
+			return true;
+		};
+
+		if (!createImage(m_ShadingRateImage, m_ShadingRateImageView, m_ShadingRateAllocation, "SceneShadingRate") ||
+			!createImage(m_ReflectionShadingRateImage, m_ReflectionShadingRateImageView,
+				m_ReflectionShadingRateAllocation, "ReflectionShadingRate"))
+		{
+			DestroyShadingRateResources(device);
+			return false;
+		}
+
+		LOG_INFO("Shading-rate images created: {}x{} ({}x{} pixel tiles)",
+			m_ShadingRateExtent.width, m_ShadingRateExtent.height,
+			m_ShadingRateTexelSize.width, m_ShadingRateTexelSize.height);
+		return true;
+	}
+
+	void RenderPassManager::DestroyShadingRateResources(VkDevice device)
+	{
+		VkImageView* views[] = { &m_ShadingRateImageView, &m_ReflectionShadingRateImageView };
+		for (VkImageView* view : views)
+		{
+			if (*view != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(device, *view, nullptr);
+				*view = VK_NULL_HANDLE;
+			}
+		}
+		void** allocations[] = { &m_ShadingRateAllocation, &m_ReflectionShadingRateAllocation };
+		for (void** allocation : allocations)
+		{
+			if (*allocation && m_MemoryManager)
+			{
+				m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(*allocation));
+				*allocation = nullptr;
+			}
+		}
+		m_ShadingRateImage = m_ReflectionShadingRateImage = VK_NULL_HANDLE;
+		m_ShadingRateExtent = { 0, 0 };
+	}
+
+	VkResult RenderPassManager::CreateRenderPass(VkDevice device, const VkRenderPassCreateInfo& info,
+		VkRenderPass* renderPass, const VkAttachmentReference* depthResolve, VkResolveModeFlagBits depthResolveMode) const
+	{
+		const bool rate = HasShadingRateAttachment();
+		const bool resolveDepth = depthResolve && depthResolveMode != VK_RESOLVE_MODE_NONE;
+		if (!rate && !resolveDepth)
+			return vkCreateRenderPass(device, &info, nullptr, renderPass);
+
+		// The shading-rate attachment and depth resolves only exist in the
+		// version 2 structures, so the pass is restated in them, with the rate
+		// image appended. It is only read, in the layout VariableRateShading
+		// leaves it in.
+		std::vector<VkAttachmentDescription2> attachments(info.attachmentCount + (rate ? 1 : 0));
+		for (uint32_t i = 0; i < info.attachmentCount; ++i)
+		{
+			const VkAttachmentDescription& source = info.pAttachments[i];
+			VkAttachmentDescription2& attachment = attachments[i];
+			attachment.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2;
+			attachment.flags = source.flags;
+			attachment.format = source.format;
+			attachment.samples = source.samples;
+			attachment.loadOp = source.loadOp;
+			attachment.storeOp = source.storeOp;
+			attachment.stencilLoadOp = source.stencilLoadOp;
+			attachment.stencilStoreOp = source.stencilStoreOp;
+			attachment.initialLayout = source.initialLayout;
+			attachment.finalLayout = source.finalLayout;
+		}
+
+		if (rate)
+		{
+			VkAttachmentDescription2& rateAttachment = attachments.back();
+			rateAttachment.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2;
+			rateAttachment.format = VK_FORMAT_R8_UINT;
+			rateAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+			rateAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			rateAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			rateAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			rateAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			rateAttachment.initialLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+			rateAttachment.finalLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+		}
+
+		VkAttachmentReference2 rateReference{};
+		rateReference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2;
+		rateReference.attachment = info.attachmentCount;
+		rateReference.layout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+
+		VkFragmentShadingRateAttachmentInfoKHR rateInfo{};
+		rateInfo.sType = VK_STRUCTURE_TYPE_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR;
+		rateInfo.pFragmentShadingRateAttachment = &rateReference;
+		rateInfo.shadingRateAttachmentTexelSize = m_ShadingRateTexelSize;
+
+		auto convertReference = [](const VkAttachmentReference& source)
+		{
+			VkAttachmentReference2 reference{};
+			reference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2;
+			reference.attachment = source.attachment;
+			reference.layout = source.layout;
+			return reference;
+		};
+
+		// Depth resolve of subpass 0 (the passes using it have one subpass)
+		VkAttachmentReference2 depthResolveReference{};
+		VkSubpassDescriptionDepthStencilResolve depthResolveInfo{};
+		if (resolveDepth)
+		{
+			depthResolveReference = convertReference(*depthResolve);
+			depthResolveInfo.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_DEPTH_STENCIL_RESOLVE;
+			depthResolveInfo.pNext = rate ? &rateInfo : nullptr;
+			depthResolveInfo.depthResolveMode = depthResolveMode;
+			depthResolveInfo.stencilResolveMode = VK_RESOLVE_MODE_NONE;
+			depthResolveInfo.pDepthStencilResolveAttachment = &depthResolveReference;
+		}
+
+		// References are kept per subpass: color, resolve, depth
+		std::vector<std::vector<VkAttachmentReference2>> colorReferences(info.subpassCount);
+		std::vector<std::vector<VkAttachmentReference2>> resolveReferences(info.subpassCount);
+		std::vector<VkAttachmentReference2> depthReferences(info.subpassCount);
+		std::vector<VkSubpassDescription2> subpasses(info.subpassCount);
+		for (uint32_t i = 0; i < info.subpassCount; ++i)
+		{
+			const VkSubpassDescription& source = info.pSubpasses[i];
+			for (uint32_t c = 0; c < source.colorAttachmentCount; ++c)
+			{
+				colorReferences[i].push_back(convertReference(source.pColorAttachments[c]));
+				if (source.pResolveAttachments)
+					resolveReferences[i].push_back(convertReference(source.pResolveAttachments[c]));
+			}
+
+			VkSubpassDescription2& subpass = subpasses[i];
+			subpass.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2;
+			if (resolveDepth && i == 0)
+				subpass.pNext = &depthResolveInfo;
+			else if (rate)
+				subpass.pNext = &rateInfo;
+			subpass.flags = source.flags;
+			subpass.pipelineBindPoint = source.pipelineBindPoint;
+			subpass.colorAttachmentCount = source.colorAttachmentCount;
+			subpass.pColorAttachments = colorReferences[i].data();
+			subpass.pResolveAttachments = source.pResolveAttachments ? resolveReferences[i].data() : nullptr;
+			if (source.pDepthStencilAttachment)
+			{
+				depthReferences[i] = convertReference(*source.pDepthStencilAttachment);
+				subpass.pDepthStencilAttachment = &depthReferences[i];
+			}
+		}
+
+		std::vector<VkSubpassDependency2> dependencies(info.dependencyCount);
+		for (uint32_t i = 0; i < info.dependencyCount; ++i)
+		{
+			const VkSubpassDependency& source = info.pDependencies[i];
+			VkSubpassDependency2& dependency = dependencies[i];
+			dependency.sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2;
+			dependency.srcSubpass = source.srcSubpass;
+			dependency.dstSubpass = source.dstSubpass;
+			dependency.srcStageMask = source.srcStageMask;
+			dependency.dstStageMask = source.dstStageMask;
+			dependency.srcAccessMask = source.srcAccessMask;
+			dependency.dstAccessMask = source.dstAccessMask;
+			dependency.dependencyFlags = source.dependencyFlags;
+		}
+
+		VkRenderPassCreateInfo2 renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+		renderPassInfo.pSubpasses = subpasses.data();
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+		return vkCreateRenderPass2(device, &renderPassInfo, nullptr, renderPass);
+	}
 }
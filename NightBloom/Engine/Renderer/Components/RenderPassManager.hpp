@@ -11,7 +11,9 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Renderer/AuxiliaryView.hpp"
 #include <vulkan/vulkan.h>
+#include <array>
 #include <vector>
 #include <cstdint>
 
@@ -20,10 +22,15 @@ namespace Nightbloom
 	// Forward Declarations
 	class VulkanSwapchain;
 	class VulkanMemoryManager;
+	class VulkanDeletionQueue;
+	class VulkanSamplerCache;
 
 	class RenderPassManager
 	{
 	public:
+		// Offscreen scene color (and reflection) format; see Initialize
+		static constexpr VkFormat SCENE_COLOR_FORMAT = VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+
 		RenderPassManager() = default;
 		~RenderPassManager() = default;
 
@@ -34,62 +41,189 @@ namespace Nightbloom
 		// post-process pass samples). VK_SAMPLE_COUNT_1_BIT keeps the original
 		// non-MSAA path. The caller is expected to clamp this to what the device
 		// supports (see VulkanDevice::GetMaxUsableSampleCount).
+		//
+		// shadingRateTexelSize (VulkanDevice::GetShadingRateTexelSize) gives
+		// the scene and reflection passes a shading-rate attachment with that
+		// tile size; 0x0 leaves it out. See GetShadingRateImage.
+		//
+		// samplerCache (VulkanDevice::GetSamplerCache) hands out the scene
+		// color and reflection samplers, so resizes don't recreate them.
+		//
+		// dynamicPostProcess (VulkanDevice::SupportsFeature("dynamic_rendering"))
+		// renders the post-process pass straight into the swapchain image
+		// views: no post-process render pass or framebuffers at all.
+		//
+		// reflectionSampleCount is the reflection pass's own MSAA count,
+		// capped at sampleCount (the default keeps the scene's). Below it the
+		// reflection pass no longer accepts the scene pipelines; the caller
+		// builds GetReflectionPipeline twins (see GetReflectionSampleCount).
+		//
+		// depthResolveMode (one of VulkanDevice::GetSupportedDepthResolveModes)
+		// resolves the multisampled scene depth in-pass into a single-sample
+		// image (GetResolvedDepthImageView); NONE or no MSAA leaves it out.
+		//
+		// sceneColorStorage also lets compute write the scene color as a
+		// storage image (ContactShadows); only pass it when the device
+		// supports storage on SCENE_COLOR_FORMAT
+		// (VulkanDevice::SupportsStorageImageFormat).
 		bool Initialize(VkDevice device, VulkanSwapchain* swapchain, VulkanMemoryManager* memoryManager,
-			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT);
+			VulkanSamplerCache* samplerCache,
+			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT, VkExtent2D shadingRateTexelSize = { 0, 0 },
+			bool dynamicPostProcess = false,
+			VkSampleCountFlagBits reflectionSampleCount = VK_SAMPLE_COUNT_64_BIT,
+			VkResolveModeFlagBits depthResolveMode = VK_RESOLVE_MODE_NONE,
+			bool sceneColorStorage = false);
 		void Cleanup(VkDevice device);
 
-		// Recreate framebuffers when swapchain changes
-		bool RecreateFramebuffers(VkDevice device, VulkanSwapchain* swapchain);
+		// Recreate framebuffers when swapchain changes, with the scene
+		// targets at sceneExtent
+		bool RecreateFramebuffers(VkDevice device, VulkanSwapchain* swapchain, VkExtent2D sceneExtent);
+
+		// Scene targets only (depth, shading rate, scene color, OIT,
+		// reflection and bloom, auxiliary views) at a new size - the
+		// Renderer's scene viewport, which need not match the swapchain.
+		// Rebuilt in place: frames using the old ones must have finished, and
+		// the Renderer re-points everything that reads them, as after a
+		// resize.
+		bool RecreateSceneTargets(VkDevice device, VkExtent2D extent);
+		// Size of the scene targets (the swapchain's until RecreateSceneTargets)
+		VkExtent2D GetSceneExtent() const { return m_SceneExtent; }
+
+		// Swapchain recreated at the same extent (present mode change): only
+		// the post-process framebuffers over its images are rebuilt. The old
+		// ones go to the deletion queue, as frames in flight may still use them.
+		// Nothing to do with a dynamic post-process pass.
+		bool RecreateSwapchainFramebuffers(VkDevice device, VulkanSwapchain* swapchain, VulkanDeletionQueue* deletionQueue);
 
 		// Scene pass — all normal geometry renders here, into the offscreen
 		// scene-color texture (not the swapchain).
 		VkRenderPass GetSceneRenderPass() const { return m_SceneRenderPass; }
 		VkFramebuffer GetSceneFramebuffer() const { return m_SceneFramebuffer; }
+		VkImage GetSceneColorImage() const { return m_SceneColorImage; }
 		VkImageView GetSceneColorImageView() const { return m_SceneColorImageView; }
 		VkSampler GetSceneColorSampler() const { return m_SceneColorSampler; }
 
 		// Reflection pass — the scene re-rendered from a mirror-flipped camera
 		// (across the water plane) into a second offscreen color texture, sampled
-		// by the water surface. Single-sample (no MSAA), own depth. Same offscreen
-		// pattern as the scene-color target above.
+		// by the water surface. Own depth, own MSAA count (GetReflectionSampleCount).
+		// Same offscreen pattern as the scene-color target above.
 		VkRenderPass GetReflectionRenderPass() const { return m_ReflectionRenderPass; }
 		VkFramebuffer GetReflectionFramebuffer() const { return m_ReflectionFramebuffer; }
+		VkImage GetReflectionColorImage() const { return m_ReflectionColorImage; }
 		VkImageView GetReflectionColorImageView() const { return m_ReflectionColorImageView; }
 		VkSampler GetReflectionColorSampler() const { return m_ReflectionColorSampler; }
 		VkExtent2D GetReflectionExtent() const { return m_ReflectionExtent; }
+		VkFormat GetSceneColorFormat() const { return m_SceneColorFormat; }
+		bool IsSceneColorStorage() const { return m_SceneColorStorage; }
+		// Equal to GetSampleCount() when the reflection pass draws with the
+		// scene pipelines; lower when it needs the reflection twins
+		VkSampleCountFlagBits GetReflectionSampleCount() const { return m_ReflectionSampleCount; }
+		bool NeedsReflectionPipelines() const { return m_ReflectionSampleCount != m_SampleCount; }
+		// Persistent: the reflection target gets memory of its own instead of
+		// sharing the bloom chain's, so it survives to later frames (a
+		// reflection reused between renders, WaterDesc::reflectionInterval).
+		// Recreates both targets and the reflection framebuffer: frames using
+		// them must have finished, and the Renderer re-points BloomMipChain
+		// and the reflection sampler set afterward, as after a resize.
+		bool SetReflectionPersistent(VkDevice device, bool persistent, VkExtent2D extent);
+		bool IsReflectionPersistent() const { return m_ReflectionPersistent; }
+
+		// Auxiliary view targets (Renderer::SetAuxiliaryViews): the reflection
+		// render pass again, one sampled color + transient depth target per
+		// view. EnsureAuxiliaryTarget (re)creates view's target at 'extent',
+		// clamped to the reflection extent so the reflection's shading-rate
+		// image still covers it; replaced targets go to the deletion queue.
+		// Needs a single-sample reflection pass (the color attachment is then
+		// the sampled image); false otherwise. A resize drops every target.
+		bool SupportsAuxiliaryTargets() const { return m_ReflectionSampleCount == VK_SAMPLE_COUNT_1_BIT; }
+		bool EnsureAuxiliaryTarget(VkDevice device, uint32_t view, VkExtent2D extent, VulkanDeletionQueue* deletionQueue);
+		VkFramebuffer GetAuxiliaryFramebuffer(uint32_t view) const { return m_AuxiliaryTargets[view].framebuffer; }
+		VkImage GetAuxiliaryColorImage(uint32_t view) const { return m_AuxiliaryTargets[view].colorImage; }
+		VkImageView GetAuxiliaryColorImageView(uint32_t view) const { return m_AuxiliaryTargets[view].colorView; }
+		VkExtent2D GetAuxiliaryExtent(uint32_t view) const { return m_AuxiliaryTargets[view].extent; }
+
+		// Order-independent transparency pass (weighted blended OIT). Subpass 0
+		// draws the transparent twins into the accumulation (RGBA16F) and
+		// revealage (R16F) targets, depth-tested against the scene depth
+		// (read-only); subpass 1 reads both back as input attachments and
+		// blends the result over the scene color. Both targets live only
+		// inside the pass (transient, lazily allocated where the device has
+		// such memory); with MSAA they are multisampled and resolved for the
+		// composite. The scene attachments are loaded and left in the layouts
+		// the scene pass leaves them in. Null if it couldn't be created - OIT
+		// is optional. Recreated on resize.
+		static constexpr VkFormat OIT_ACCUMULATION_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+		static constexpr VkFormat OIT_REVEALAGE_FORMAT = VK_FORMAT_R16_SFLOAT;
+		VkRenderPass GetOitRenderPass() const { return m_OitRenderPass; }
+		VkFramebuffer GetOitFramebuffer() const { return m_OitFramebuffer; }
+		// What the composite subpass reads (the resolves under MSAA)
+		VkImageView GetOitAccumulationView() const { return m_OitAccumulation.view; }
+		VkImageView GetOitRevealageView() const { return m_OitRevealage.view; }
 
 		// Post-process pass — samples the scene-color texture and writes the
 		// actual swapchain image (one framebuffer per swapchain image, like
 		// the scene pass's framebuffers used to be before this offscreen split).
+		// When dynamic the render pass and framebuffers are VK_NULL_HANDLE and
+		// the pass begins on the swapchain image view (Renderer::RecordPostProcessPass).
+		bool IsPostProcessDynamic() const { return m_PostProcessDynamic; }
 		VkRenderPass GetPostProcessRenderPass() const { return m_PostProcessRenderPass; }
 		VkFramebuffer GetPostProcessFramebuffer(uint32_t index) const
 		{
 			return (index < m_PostProcessFramebuffers.size()) ? m_PostProcessFramebuffers[index] : VK_NULL_HANDLE;
 		}
 
-		// Bloom — two half-res HDR ping-pong targets sharing one color-only render pass.
-		// Pipeline: bright-extract (scene -> A), blur H (A -> B), blur V (B -> A); the
-		// post-process pass then composites A into the tonemap. See Renderer::RecordBloomPass.
-		VkRenderPass GetBloomRenderPass() const { return m_BloomRenderPass; }
-		VkFramebuffer GetBloomFramebufferA() const { return m_BloomFramebufferA; }
-		VkFramebuffer GetBloomFramebufferB() const { return m_BloomFramebufferB; }
-		VkImageView GetBloomImageViewA() const { return m_BloomImageViewA; }
-		VkImageView GetBloomImageViewB() const { return m_BloomImageViewB; }
-		VkSampler GetBloomSampler() const { return m_BloomSampler; }
+		// Bloom mip chain — half-res HDR, storage + sampled, built by BloomMipChain's
+		// compute passes; mip 0 is what the post-process pass composites. RGBA16F
+		// rather than the scene format: it's always usable as a storage image.
+		static constexpr VkFormat BLOOM_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+		static constexpr uint32_t MAX_BLOOM_MIPS = 6;
+		VkImage GetBloomImage() const { return m_BloomImage; }
 		VkExtent2D GetBloomExtent() const { return m_BloomExtent; }
+		uint32_t GetBloomMipCount() const { return m_BloomMipCount; }
 
 		bool HasDepthBuffer() const { return m_HasDepth; }
 
+		// Scene depth (reverse-Z, multisampled with MSAA). Left in
+		// DEPTH_STENCIL_READ_ONLY_OPTIMAL after the scene pass so the Hi-Z
+		// pyramid build can sample it. Recreated on resize.
+		VkImage GetDepthImage() const { return m_DepthImage; }
+		VkImageView GetDepthImageView() const { return m_DepthImageView; }
+
+		// Single-sample scene depth for consumers that want one value per
+		// pixel (the temporal upscale): the in-pass depth resolve when the
+		// scene pass has one, else the scene depth itself. Same layout as
+		// the scene depth after the pass; sample the view with
+		// GetResolvedDepthSampleCount's shader variant.
+		bool HasDepthResolve() const { return m_DepthResolveImage != VK_NULL_HANDLE; }
+		VkImage GetResolvedDepthImage() const { return HasDepthResolve() ? m_DepthResolveImage : m_DepthImage; }
+		VkImageView GetResolvedDepthImageView() const { return HasDepthResolve() ? m_DepthResolveImageView : m_DepthImageView; }
+		VkSampleCountFlagBits GetResolvedDepthSampleCount() const { return HasDepthResolve() ? VK_SAMPLE_COUNT_1_BIT : m_SampleCount; }
+
 		// MSAA sample count of the scene pass (1 = no MSAA). Scene-pass
 		// pipelines must be created with a matching rasterizationSamples.
 		VkSampleCountFlagBits GetSampleCount() const { return m_SampleCount; }
 
+		// Shading-rate attachments (VK_KHR_fragment_shading_rate): one r8ui
+		// texel per tile of the scene and reflection framebuffers, read by
+		// pipelines created with coarseShading. Both passes carry one so the
+		// shared pipelines stay render-pass compatible. VariableRateShading
+		// writes them; the passes expect them in
+		// FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL. Recreated on resize.
+		bool HasShadingRateAttachment() const { return m_ShadingRateTexelSize.width != 0; }
+		VkExtent2D GetShadingRateTexelSize() const { return m_ShadingRateTexelSize; }
+		VkExtent2D GetShadingRateExtent() const { return m_ShadingRateExtent; }
+		VkImage GetShadingRateImage() const { return m_ShadingRateImage; }
+		VkImageView GetShadingRateImageView() const { return m_ShadingRateImageView; }
+		VkImage GetReflectionShadingRateImage() const { return m_ReflectionShadingRateImage; }
+
 	private:
 		// Scene render pass (color into offscreen texture + optional depth)
 		VkRenderPass m_SceneRenderPass = VK_NULL_HANDLE;
 		VkFramebuffer m_SceneFramebuffer = VK_NULL_HANDLE;
 
 		VkSampleCountFlagBits m_SampleCount = VK_SAMPLE_COUNT_1_BIT;
+		VkSampleCountFlagBits m_ReflectionSampleCount = VK_SAMPLE_COUNT_1_BIT;
+		VkResolveModeFlagBits m_DepthResolveMode = VK_RESOLVE_MODE_NONE;  // NONE without MSAA
 
 		// Offscreen scene-color target — owned directly (raw Vulkan calls via
 		// VulkanMemoryManager), same style as the depth buffer below, not a
@@ -101,6 +235,8 @@ namespace Nightbloom
 		VkImageView m_SceneColorImageView = VK_NULL_HANDLE;
 		VkSampler m_SceneColorSampler = VK_NULL_HANDLE;
 		VkFormat m_SceneColorFormat = VK_FORMAT_UNDEFINED;
+		bool m_SceneColorStorage = false;
+		VkExtent2D m_SceneExtent = { 0, 0 };
 		void* m_SceneColorAllocation = nullptr; // a VulkanMemoryManager::ImageAllocation*
 
 		// Multisampled color attachment (only created when m_SampleCount > 1) —
@@ -110,19 +246,18 @@ namespace Nightbloom
 		void* m_SceneColorMSAllocation = nullptr;
 
 		// Reflection target — a second offscreen color target rendered with a
-		// mirror-flipped camera and sampled by the water surface. Its render
-		// pass MUST be format/sample-count compatible with the scene render pass
-		// because it reuses the scene's Mesh/Terrain/Foliage pipelines, so it
-		// mirrors the scene target's structure exactly (same MSAA count, depth,
-		// and an MSAA resolve target when MSAA is on). m_ReflectionColorImageView
-		// is the single-sample SAMPLED target (the resolve target under MSAA).
+		// mirror-flipped camera and sampled by the water surface. It mirrors the
+		// scene target's structure (formats, depth, an MSAA resolve target when
+		// multisampled) so that at the scene's sample count it stays compatible
+		// with the scene's Mesh/Terrain/Foliage pipelines; at a lower count it
+		// is drawn with the reflection twins. m_ReflectionColorImageView is the
+		// single-sample SAMPLED target (the resolve target under MSAA).
 		VkRenderPass m_ReflectionRenderPass = VK_NULL_HANDLE;
 		VkFramebuffer m_ReflectionFramebuffer = VK_NULL_HANDLE;
 		VkExtent2D m_ReflectionExtent = { 0, 0 };
-		VkImage m_ReflectionColorImage = VK_NULL_HANDLE;
+		VkImage m_ReflectionColorImage = VK_NULL_HANDLE;   // in m_TransientTargets
 		VkImageView m_ReflectionColorImageView = VK_NULL_HANDLE;
 		VkSampler m_ReflectionColorSampler = VK_NULL_HANDLE;
-		void* m_ReflectionColorAllocation = nullptr;
 		VkImage m_ReflectionColorMSImage = VK_NULL_HANDLE;       // multisampled (MSAA only)
 		VkImageView m_ReflectionColorMSImageView = VK_NULL_HANDLE;
 		void* m_ReflectionColorMSAllocation = nullptr;
@@ -130,31 +265,78 @@ namespace Nightbloom
 		VkImageView m_ReflectionDepthImageView = VK_NULL_HANDLE;
 		void* m_ReflectionDepthAllocation = nullptr;
 
+		// Auxiliary view targets (EnsureAuxiliaryTarget); sampled with
+		// m_ReflectionColorSampler
+		struct AuxiliaryTarget
+		{
+			VkExtent2D extent = { 0, 0 };
+			VkImage colorImage = VK_NULL_HANDLE;
+			VkImageView colorView = VK_NULL_HANDLE;
+			void* colorAllocation = nullptr;
+			VkImage depthImage = VK_NULL_HANDLE;
+			VkImageView depthView = VK_NULL_HANDLE;
+			void* depthAllocation = nullptr;
+			VkFramebuffer framebuffer = VK_NULL_HANDLE;
+		};
+		std::array<AuxiliaryTarget, MAX_AUXILIARY_VIEWS> m_AuxiliaryTargets{};
+
+		// OIT pass and its targets (the *MS pair only with MSAA)
+		struct OitTarget
+		{
+			VkImage image = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			void* allocation = nullptr;
+		};
+		VkRenderPass m_OitRenderPass = VK_NULL_HANDLE;
+		VkFramebuffer m_OitFramebuffer = VK_NULL_HANDLE;
+		OitTarget m_OitAccumulation;
+		OitTarget m_OitRevealage;
+		OitTarget m_OitAccumulationMS;
+		OitTarget m_OitRevealageMS;
+
 		// Post-process render pass (color only, writes the swapchain image)
+		bool m_PostProcessDynamic = false;
 		VkRenderPass m_PostProcessRenderPass = VK_NULL_HANDLE;
 		std::vector<VkFramebuffer> m_PostProcessFramebuffers;
 
-		// Bloom ping-pong targets — half-res, HDR (= m_SceneColorFormat), single-sample.
-		// One render pass (color-only, final layout SHADER_READ) reused for all three
-		// bloom sub-passes; A and B alternate as render target / sampled input.
-		VkRenderPass m_BloomRenderPass = VK_NULL_HANDLE;
+		// Bloom mip chain (views, sets and pipelines are BloomMipChain's)
 		VkExtent2D m_BloomExtent = { 0, 0 };
-		VkImage m_BloomImageA = VK_NULL_HANDLE;
-		VkImageView m_BloomImageViewA = VK_NULL_HANDLE;
-		void* m_BloomAllocationA = nullptr;
-		VkImage m_BloomImageB = VK_NULL_HANDLE;
-		VkImageView m_BloomImageViewB = VK_NULL_HANDLE;
-		void* m_BloomAllocationB = nullptr;
-		VkSampler m_BloomSampler = VK_NULL_HANDLE;
-		VkFramebuffer m_BloomFramebufferA = VK_NULL_HANDLE;
-		VkFramebuffer m_BloomFramebufferB = VK_NULL_HANDLE;
+		VkImage m_BloomImage = VK_NULL_HANDLE;   // in m_TransientTargets
+		uint32_t m_BloomMipCount = 0;
+
+		// The reflection color target and the bloom chain share memory: the
+		// reflection is dead once the scene pass has sampled it, before bloom
+		// starts (the Renderer checks this against the render graph's resource
+		// lifetimes). Every pass writing them starts from UNDEFINED, and the
+		// reflection pass's dependency and the chain's first barrier order the
+		// WAW/WAR hazards between them, including across frames. A persistent
+		// reflection (SetReflectionPersistent) is allocated beside the chain.
+		VulkanMemoryManager::AliasedImageGroup* m_TransientTargets = nullptr;
+		bool m_ReflectionPersistent = false;
 
 		bool m_HasDepth = false;
 		VkImage m_DepthImage = VK_NULL_HANDLE;
 		VkImageView m_DepthImageView = VK_NULL_HANDLE;
 		VkFormat m_DepthFormat = VK_FORMAT_D32_SFLOAT;
 
+		// Single-sample depth the scene pass resolves into (MSAA with a depth
+		// resolve mode only)
+		VkImage m_DepthResolveImage = VK_NULL_HANDLE;
+		VkImageView m_DepthResolveImageView = VK_NULL_HANDLE;
+		void* m_DepthResolveAllocation = nullptr;
+
+		// Shading-rate attachments (only with a non-zero texel size)
+		VkExtent2D m_ShadingRateTexelSize = { 0, 0 };
+		VkExtent2D m_ShadingRateExtent = { 0, 0 };
+		VkImage m_ShadingRateImage = VK_NULL_HANDLE;
+		VkImageView m_ShadingRateImageView = VK_NULL_HANDLE;
+		void* m_ShadingRateAllocation = nullptr;
+		VkImage m_ReflectionShadingRateImage = VK_NULL_HANDLE;
+		VkImageView m_ReflectionShadingRateImageView = VK_NULL_HANDLE;
+		void* m_ReflectionShadingRateAllocation = nullptr;
+
 		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanSamplerCache* m_SamplerCache = nullptr;  // scene color / reflection samplers (shared, not owned)
 		struct ImageAllocationHandle;
 		void* m_DepthAllocation = nullptr; // actually a vulkanmemorymanager image allocation
 
@@ -169,11 +351,12 @@ namespace Nightbloom
 		bool CreatePostProcessFramebuffers(VkDevice device, VulkanSwapchain* swapchain);
 		void DestroyPostProcessFramebuffers(VkDevice device);
 
-		// Bloom helpers. CreateBloomResources builds both images/views, the shared sampler,
-		// and both framebuffers at half of `extent`. The render pass is created once.
-		bool CreateBloomRenderPass(VkDevice device, VkFormat colorFormat);
-		bool CreateBloomResources(VkDevice device, VkFormat colorFormat, VkExtent2D fullExtent);
-		void DestroyBloomResources(VkDevice device);
+		// Creates the aliased images behind the reflection color target and the
+		// bloom chain; CreateReflectionResources only adds views
+		bool CreateTransientTargets(VkFormat colorFormat, VkExtent2D extent);
+		void DestroyTransientTargets();
+		// The transient targets with the reflection views and framebuffer over them
+		bool RecreateReflectionTargets(VkDevice device, VkExtent2D extent);
 
 		// Reflection target helpers (single-sample color + depth, sampled by water)
 		bool CreateReflectionRenderPass(VkDevice device, VkFormat colorFormat);
@@ -182,10 +365,34 @@ namespace Nightbloom
 		bool CreateReflectionFramebuffer(VkDevice device, VkExtent2D extent);
 		void DestroyReflectionFramebuffer(VkDevice device);
 
+		// Auxiliary target helpers
+		bool CreateAuxiliaryTarget(VkDevice device, VkExtent2D extent, AuxiliaryTarget& target);
+		void DestroyAuxiliaryTarget(VkDevice device, AuxiliaryTarget& target);
+		void DestroyAuxiliaryTargets(VkDevice device);
+
+		// OIT pass helpers. Failure leaves OIT unavailable, not the manager.
+		bool CreateOitRenderPass(VkDevice device);
+		bool CreateOitTarget(VkDevice device, VkFormat format, VkExtent2D extent, VkSampleCountFlagBits samples,
+			VkImageUsageFlags usage, const char* debugName, OitTarget& target);
+		void DestroyOitTarget(VkDevice device, OitTarget& target);
+		bool CreateOitResources(VkDevice device, VkExtent2D extent);
+		void DestroyOitResources(VkDevice device);
+
 		// Depth Buffer Helpers
 		bool CreateDepthResources(VkDevice device, VkExtent2D extent);
 		void DestroyDepthResources(VkDevice device);
 
+		// Shading-rate images for both passes, sized to cover 'extent'
+		bool CreateShadingRateResources(VkDevice device, VkExtent2D extent);
+		void DestroyShadingRateResources(VkDevice device);
+
+		// vkCreateRenderPass, or the same pass through vkCreateRenderPass2
+		// with the shading-rate attachment appended and/or subpass 0's depth
+		// resolved into 'depthResolve' with 'depthResolveMode'
+		VkResult CreateRenderPass(VkDevice device, const VkRenderPassCreateInfo& info, VkRenderPass* renderPass,
+			const VkAttachmentReference* depthResolve = nullptr,
+			VkResolveModeFlagBits depthResolveMode = VK_RESOLVE_MODE_NONE) const;
+
 		// Prevent copying
 		RenderPassManager(const RenderPassManager&) = delete;
 		RenderPassManager& operator=(const RenderPassManager&) = delete;
@@ -6,19 +6,52 @@
 
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanUploadManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/AssetManager.hpp" 
 #include "Engine/Renderer/TextureLoader.hpp"
+#include "Engine/Renderer/TextureCooker.hpp"
+#include "Engine/Renderer/Ktx2.hpp"
+#include "Engine/Core/AssetArchive.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/FileWatcher.hpp"
 #include "Engine/Renderer/Vertex.hpp"
+#include "Engine/Renderer/GridMesh.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/DrawStream.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <filesystem>
 #include <vector>
 #include <cmath>
+#include <limits>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		// A buffer is only ever asked for host-visible memory when the CPU
+		// rewrites it after creation (dynamic meshes, per-frame instance and
+		// indirect data), so those stay mapped instead of paying a map/unmap
+		// on every write; GPU-only buffers have nothing to map.
+		BufferDesc MakeBufferDesc(BufferUsage usage, const std::string& name, size_t size, bool hostVisible)
+		{
+			BufferDesc desc;
+			desc.usage = usage;
+			desc.memoryAccess = hostVisible ? MemoryAccess::CpuToGpu : MemoryAccess::GpuOnly;
+			desc.size = size;
+			desc.debugName = name;
+			desc.persistentMap = hostVisible;
+			return desc;
+		}
+	}
+
 	bool ResourceManager::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager)
 	{
 		m_Device = device;
@@ -36,23 +69,55 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Buffer/texture uploads are queued here rather than waiting on the
+		// graphics queue; without it they fall back to the blocking path
+		m_UploadManager = std::make_unique<VulkanUploadManager>(device, memoryManager);
+		if (m_UploadManager->Initialize())
+		{
+			m_MemoryManager->SetUploadManager(m_UploadManager.get());
+		}
+		else
+		{
+			LOG_WARN("Failed to initialize upload manager - uploads will block");
+			m_UploadManager.reset();
+		}
+
+		m_TextureStreamer = std::make_unique<TextureStreamer>(device, memoryManager, m_TransferCommandPool.get());
+		m_MeshArena = std::make_unique<VulkanMeshArena>(device, memoryManager);
+
 		LOG_INFO("Resource manager initialized");
 		return true;
 	}
 
 	void ResourceManager::Cleanup()
 	{
+		// Pending uploads still reference textures/buffers and pooled staging
+		if (m_UploadManager)
+		{
+			m_UploadManager->Shutdown();
+			if (m_MemoryManager)
+				m_MemoryManager->SetUploadManager(nullptr);
+			m_UploadManager.reset();
+		}
+		m_TextureStreamer.reset();
+		m_ModelCache.Clear();
+
 		// DestroyAllResources
 		DestroyAllTextures();
 		DestroyAllShaders();
 
 		// Destroy all buffers
-		for (auto& [name, buffer] : m_Buffers)
-		{
-			LOG_INFO("Destroying buffer: {}", name);
-			buffer.reset();  // VulkanBuffer destructor handles cleanup
-		}
-		m_Buffers.clear();
+		m_Buffers.ForEach([](BufferHandle, const NamedResource<VulkanBuffer>& buffer)
+			{
+				LOG_INFO("Destroying buffer: {}", buffer.name.c_str());
+			});
+		m_Buffers.Clear();  // VulkanBuffer destructor handles cleanup
+		m_BufferNames.clear();
+		m_GridIndexBuffers.clear();
+		m_MeshArena.reset();
+		m_MaterialBuffer = nullptr;
+		m_MaterialSlots.clear();
+		m_MaterialEntries.clear();
 
 		// Destroy command pool
 		if (m_TransferCommandPool)
@@ -70,38 +135,28 @@ namespace Nightbloom
 
 	VulkanBuffer* ResourceManager::CreateVertexBuffer(const std::string& name, size_t size, bool hostVisible)
 	{
-		BufferDesc desc;
-		desc.usage = BufferUsage::Vertex;
-		desc.memoryAccess = hostVisible ? MemoryAccess::CpuToGpu : MemoryAccess::GpuOnly;
-		desc.size = size;
-		desc.debugName = name;
+		BufferDesc desc = MakeBufferDesc(BufferUsage::Vertex, name, size, hostVisible);
+		desc.directWrite = size <= DIRECT_WRITE_MESH_BYTES;
 
 		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
 		if (!buffer->Initialize(desc))
 			return nullptr;
 
-		// Store and return
 		VulkanBuffer* ptr = buffer.get();
-		m_Buffers[name] = std::move(buffer);
-		return ptr;
+		return StoreBuffer(name, std::move(buffer)).IsValid() ? ptr : nullptr;
 	}
 
 	VulkanBuffer* ResourceManager::CreateIndexBuffer(const std::string& name, size_t size, bool hostVisible)
 	{
-		BufferDesc desc;
-		desc.usage = BufferUsage::Index;
-		desc.memoryAccess = hostVisible ? MemoryAccess::CpuToGpu : MemoryAccess::GpuOnly;
-		desc.size = size;
-		desc.debugName = name;
+		BufferDesc desc = MakeBufferDesc(BufferUsage::Index, name, size, hostVisible);
+		desc.directWrite = size <= DIRECT_WRITE_MESH_BYTES;
 
 		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
 		if (!buffer->Initialize(desc))
 			return nullptr;
 
-		// Store and return
 		VulkanBuffer* ptr = buffer.get();
-		m_Buffers[name] = std::move(buffer);
-		return ptr;
+		return StoreBuffer(name, std::move(buffer)).IsValid() ? ptr : nullptr;
 	}
 
 	VulkanBuffer* ResourceManager::CreateUniformBuffer(const std::string& name, size_t size)
@@ -118,15 +173,40 @@ namespace Nightbloom
 			return nullptr;
 
 		VulkanBuffer* ptr = buffer.get();
-		m_Buffers[name] = std::move(buffer);
-		return ptr;
+		return StoreBuffer(name, std::move(buffer)).IsValid() ? ptr : nullptr;
 	}
 
-	VulkanBuffer* ResourceManager::CreateStorageBuffer(const std::string& name, size_t size, bool hostVisible)
+	VulkanBuffer* ResourceManager::CreateStorageBuffer(const std::string& name, size_t size, bool hostVisible,
+		bool directWrite)
+	{
+		BufferDesc desc = MakeBufferDesc(BufferUsage::Storage, name, size, hostVisible);
+		desc.directWrite = directWrite;
+
+		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
+		if (!buffer->Initialize(desc))
+			return nullptr;
+
+		VulkanBuffer* ptr = buffer.get();
+		return StoreBuffer(name, std::move(buffer)).IsValid() ? ptr : nullptr;
+	}
+
+	VulkanBuffer* ResourceManager::CreateIndirectBuffer(const std::string& name, size_t size, bool hostVisible)
+	{
+		BufferDesc desc = MakeBufferDesc(BufferUsage::Indirect, name, size, hostVisible);
+
+		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
+		if (!buffer->Initialize(desc))
+			return nullptr;
+
+		VulkanBuffer* ptr = buffer.get();
+		return StoreBuffer(name, std::move(buffer)).IsValid() ? ptr : nullptr;
+	}
+
+	VulkanBuffer* ResourceManager::CreateComputeVertexBuffer(const std::string& name, size_t size)
 	{
 		BufferDesc desc;
-		desc.usage = BufferUsage::Storage;
-		desc.memoryAccess = hostVisible ? MemoryAccess::CpuToGpu : MemoryAccess::GpuOnly;
+		desc.usage = BufferUsage::ComputeVertex;
+		desc.memoryAccess = MemoryAccess::GpuOnly;
 		desc.size = size;
 		desc.debugName = name;
 
@@ -134,43 +214,90 @@ namespace Nightbloom
 		if (!buffer->Initialize(desc))
 			return nullptr;
 
-		// Store and return
 		VulkanBuffer* ptr = buffer.get();
-		m_Buffers[name] = std::move(buffer);
-		return ptr;
+		return StoreBuffer(name, std::move(buffer)).IsValid() ? ptr : nullptr;
 	}
 
-	VulkanBuffer* ResourceManager::GetBuffer(const std::string& name)
+	BufferHandle ResourceManager::StoreBuffer(const std::string& name, std::unique_ptr<VulkanBuffer> buffer)
 	{
-		auto it = m_Buffers.find(name);
-		if (it != m_Buffers.end())
+		const StringId id = name;
+		if (m_BufferNames.count(id))
+			DestroyBuffer(id);
+
+		const BufferHandle handle = m_Buffers.Insert({ std::move(buffer), id });
+		if (!handle.IsValid())
 		{
-			return it->second.get();
+			LOG_ERROR("Buffer registry is full, can't add '{}'", name);
+			return {};
 		}
-		return nullptr;
+		m_BufferNames[id] = handle;
+		return handle;
+	}
+
+	BufferHandle ResourceManager::FindBuffer(StringId name) const
+	{
+		auto it = m_BufferNames.find(name);
+		return it != m_BufferNames.end() ? it->second : BufferHandle{};
+	}
+
+	VulkanBuffer* ResourceManager::GetBuffer(BufferHandle handle) const
+	{
+		const NamedResource<VulkanBuffer>* entry = m_Buffers.Get(handle);
+		return entry ? entry->resource.get() : nullptr;
+	}
+
+	VulkanBuffer* ResourceManager::GetBuffer(StringId name)
+	{
+		return GetBuffer(FindBuffer(name));
 	}
 
-	void ResourceManager::DestroyBuffer(const std::string& name)
+	void ResourceManager::DestroyBuffer(BufferHandle handle)
 	{
-		auto it = m_Buffers.find(name);
-		if (it != m_Buffers.end())
+		NamedResource<VulkanBuffer> buffer = m_Buffers.Remove(handle);
+		if (!buffer.resource)
 		{
-			LOG_INFO("Destroying buffer: {}", name);
-			m_Buffers.erase(it);
+			LOG_WARN("Attempted to destroy a buffer through a stale handle");
+			return;
 		}
-		else
+
+		LOG_INFO("Destroying buffer: {}", buffer.name.c_str());
+		m_BufferNames.erase(buffer.name);
+		DeferDestroy(std::move(buffer.resource));
+	}
+
+	void ResourceManager::DestroyBuffer(StringId name)
+	{
+		const BufferHandle handle = FindBuffer(name);
+		if (!handle.IsValid())
 		{
-			LOG_WARN("Attempted to destroy non-existent buffer: {}", name);
+			LOG_WARN("Attempted to destroy non-existent buffer: {}", name.c_str());
+			return;
 		}
+		DestroyBuffer(handle);
+	}
+
+	void ResourceManager::Defer(std::function<void()> destroy)
+	{
+		VulkanDeletionQueue* deletionQueue = m_Device ? m_Device->GetDeletionQueue() : nullptr;
+		if (deletionQueue)
+			deletionQueue->Defer(std::move(destroy));
+		else
+			destroy();
+	}
+
+	void ResourceManager::DeferFreeDescriptorSet(VkDescriptorSet set)
+	{
+		if (set == VK_NULL_HANDLE || !m_DescriptorManager)
+			return;
+
+		VulkanDescriptorManager* descriptorManager = m_DescriptorManager;
+		Defer([descriptorManager, set]() { descriptorManager->FreeDescriptorSet(set); });
 	}
 
 	std::unique_ptr<VulkanBuffer> ResourceManager::CreateVertexBufferUnique(const std::string& name, size_t size, bool hostVisible)
 	{
-		BufferDesc desc;
-		desc.usage = BufferUsage::Vertex;
-		desc.memoryAccess = hostVisible ? MemoryAccess::CpuToGpu : MemoryAccess::GpuOnly;
-		desc.size = size;
-		desc.debugName = name;
+		BufferDesc desc = MakeBufferDesc(BufferUsage::Vertex, name, size, hostVisible);
+		desc.directWrite = size <= DIRECT_WRITE_MESH_BYTES;
 
 		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
 		if (!buffer->Initialize(desc))
@@ -181,11 +308,8 @@ namespace Nightbloom
 
 	std::unique_ptr<VulkanBuffer> ResourceManager::CreateIndexBufferUnique(const std::string& name, size_t size, bool hostVisible)
 	{
-		BufferDesc desc;
-		desc.usage = BufferUsage::Index;
-		desc.memoryAccess = hostVisible ? MemoryAccess::CpuToGpu : MemoryAccess::GpuOnly;
-		desc.size = size;
-		desc.debugName = name;
+		BufferDesc desc = MakeBufferDesc(BufferUsage::Index, name, size, hostVisible);
+		desc.directWrite = size <= DIRECT_WRITE_MESH_BYTES;
 
 		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
 		if (!buffer->Initialize(desc))
@@ -198,16 +322,15 @@ namespace Nightbloom
 		const std::string& filename)
 	{
 		// Check if already loaded
-		auto it = m_Shaders.find(name);
-		if (it != m_Shaders.end())
+		if (VulkanShader* existing = GetShader(name))
 		{
 			LOG_WARN("Shader '{}' already loaded, returning existing", name);
-			return it->second.get();
+			return existing;
 		}
 
 		// Load shader binary through AssetManager
 		auto shaderCode = AssetManager::Get().LoadShaderBinary(filename);
-		if (shaderCode.empty())
+		if (!shaderCode.IsOpen())
 		{
 			LOG_ERROR("Failed to load shader file: {}", filename);
 			return nullptr;
@@ -215,100 +338,151 @@ namespace Nightbloom
 
 		// Create VulkanShader
 		auto shader = std::make_unique<VulkanShader>(m_Device, stage);
-		if (!shader->CreateFromSpirV(shaderCode, "main"))
+		if (!shader->CreateFromSpirV(shaderCode.GetSpan(), "main"))
 		{
 			LOG_ERROR("Failed to create shader from SPIR-V: {}", filename);
 			return nullptr;
 		}
+		shader->SetSourcePath(filename);
 
 		VulkanShader* ptr = shader.get();
-		m_Shaders[name] = std::move(shader);
+		const StringId id = name;
+		const ShaderHandle handle = m_Shaders.Insert({ std::move(shader), id });
+		if (!handle.IsValid())
+		{
+			LOG_ERROR("Shader registry is full, can't add '{}'", name);
+			return nullptr;
+		}
+		m_ShaderNames[id] = handle;
 
 		LOG_INFO("Loaded shader '{}' from {}", name, filename);
 		return ptr;
 	}
 
-	VulkanShader* ResourceManager::GetShader(const std::string& name)
+	ShaderHandle ResourceManager::FindShader(StringId name) const
 	{
-		auto it = m_Shaders.find(name);
-		if (it != m_Shaders.end())
-		{
-			return it->second.get();
-		}
-		return nullptr;
+		auto it = m_ShaderNames.find(name);
+		return it != m_ShaderNames.end() ? it->second : ShaderHandle{};
+	}
+
+	VulkanShader* ResourceManager::GetShader(ShaderHandle handle) const
+	{
+		const NamedResource<VulkanShader>* entry = m_Shaders.Get(handle);
+		return entry ? entry->resource.get() : nullptr;
+	}
+
+	VulkanShader* ResourceManager::GetShader(StringId name)
+	{
+		return GetShader(FindShader(name));
 	}
 
-	void ResourceManager::DestroyShader(const std::string& name)
+	void ResourceManager::DestroyShader(StringId name)
 	{
-		auto it = m_Shaders.find(name);
-		if (it != m_Shaders.end())
+		auto it = m_ShaderNames.find(name);
+		if (it != m_ShaderNames.end())
 		{
-			LOG_INFO("Destroying shader: {}", name);
-			m_Shaders.erase(it);
+			LOG_INFO("Destroying shader: {}", name.c_str());
+			m_Shaders.Remove(it->second);
+			m_ShaderNames.erase(it);
 		}
 	}
 
 	void ResourceManager::DestroyAllShaders()
 	{
-		LOG_INFO("Destroying all {} shaders", m_Shaders.size());
-		m_Shaders.clear();
+		LOG_INFO("Destroying all {} shaders", m_Shaders.Size());
+		m_Shaders.Clear();
+		m_ShaderNames.clear();
 	}
 
-	VulkanTexture* ResourceManager::LoadTexture(const std::string& name, const std::string& filepath)
+	VulkanTexture* ResourceManager::LoadTexture(const std::string& name, const std::string& filepath, bool allowStreaming)
 	{
 		// Check if texture already exists
-		if (m_Textures.find(name) != m_Textures.end())
+		if (VulkanTexture* existing = GetTexture(name))
 		{
 			LOG_WARN("Texture '{}' already exists, returning existing texture", name);
-			return m_Textures[name].get();
+			return existing;
 		}
 
-		std::string fullPath;
+		if (VulkanTexture* existing = FindTextureByPath(filepath, allowStreaming))
+			return existing;
 
+		PreparedTexture prepared = PrepareTexture(filepath);
+		return CreatePreparedTexture(name, prepared, allowStreaming);
+	}
+
+	std::string ResourceManager::ResolveTexturePath(const std::string& filepath)
+	{
 		// Check if filepath is already absolute
 		std::filesystem::path p(filepath);
 		if (p.is_absolute())
 		{
-			fullPath = filepath;  // Use as-is
+			return filepath;  // Use as-is
 		}
-		else
+		return AssetManager::Get().GetTexturePath(filepath);  // Prepend base path
+	}
+
+	VulkanTexture* ResourceManager::FindTextureByPath(const std::string& filepath, bool allowStreaming)
+	{
+		auto it = m_TexturePaths.find(TexturePathKey(ResolveTexturePath(filepath), allowStreaming));
+		return it != m_TexturePaths.end() ? GetTexture(it->second) : nullptr;
+	}
+
+	PreparedTexture ResourceManager::PrepareTexture(const std::string& filepath) const
+	{
+		PreparedTexture prepared;
+		prepared.path = ResolveTexturePath(filepath);
+
+		// A cooked .ktx2 next to the source wins while it is up to date. The
+		// packer only archives current ones, so an archived entry counts as
+		// current unless a loose copy on disk says otherwise.
+		const std::string cookedPath = GetCookedTexturePath(prepared.path);
+		const bool archived = AssetManager::Get().IsInArchive(cookedPath) && !std::filesystem::exists(cookedPath);
+		if (archived || IsCookedTextureCurrent(prepared.path, cookedPath))
+		{
+			if (OpenCookedTexture(cookedPath, prepared.cooked, prepared.cookedImage))
+				return prepared;
+		}
+		else if (std::filesystem::exists(cookedPath))
 		{
-			fullPath = AssetManager::Get().GetTexturePath(filepath);  // Prepend base path
+			LOG_WARN("Cooked texture '{}' is older than its source, loading the source", cookedPath);
 		}
 
-		// Load image data
-		ImageData imageData = TextureLoader::LoadImageRGBA(fullPath);
-		if (imageData.pixels.empty())
+		prepared.image = TextureLoader::LoadImageRGBA(prepared.path);
+		if (prepared.image.pixels.empty())
 		{
-			LOG_ERROR("Failed to load texture file: {}", fullPath);
-			return nullptr;
+			LOG_ERROR("Failed to load texture file: {}", prepared.path);
 		}
+		return prepared;
+	}
 
-		// Create texture description
-		TextureDesc desc;
-		desc.width = imageData.width;
-		desc.height = imageData.height;
-		desc.format = imageData.channels == 4 ? TextureFormat::RGBA8 : TextureFormat::RGB8;
-		desc.mipLevels = 1; 
-		desc.generateMips = true;
-		desc.usage = TextureUsage::Sampled | TextureUsage::Transfer;
+	VulkanTexture* ResourceManager::CreatePreparedTexture(const std::string& name, PreparedTexture& prepared, bool allowStreaming)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture));
 
-		// Create VulkanTexture
-		auto texture = std::make_unique<VulkanTexture>(m_Device, m_MemoryManager);
-		if (!texture->Initialize(desc))
+		// Check if texture already exists
+		if (VulkanTexture* existing = GetTexture(name))
 		{
-			LOG_ERROR("Failed to create texture '{}'", name);
-			return nullptr;
+			LOG_WARN("Texture '{}' already exists, returning existing texture", name);
+			return existing;
 		}
 
-		// Upload image data
-		if (!texture->UploadData(imageData.pixels.data(), imageData.pixels.size(), m_TransferCommandPool.get()))
+		auto shared = m_TexturePaths.find(TexturePathKey(prepared.path, allowStreaming));
+		if (shared != m_TexturePaths.end())
 		{
-			LOG_ERROR("Failed to upload texture data for '{}'", name);
-			return nullptr;
+			if (const NamedResource<VulkanTexture>* existing = m_Textures.Get(shared->second))
+			{
+				LOG_INFO("Texture '{}' shares '{}' (same file)", name, existing->name);
+				return existing->resource.get();
+			}
 		}
 
-		if (m_DescriptorManager)
+		std::unique_ptr<VulkanTexture> texture = BuildPreparedTexture(name, prepared, allowStreaming);
+		if (!texture)
+			return nullptr;
+
+		// File textures are sampled by the mesh passes, so with the bindless
+		// table they only need a slot there - no descriptor set of their own
+		if (m_DescriptorManager && !texture->RegisterBindless(m_DescriptorManager))
 		{
 			if (!texture->CreateDescriptorSet(m_DescriptorManager))
 			{
@@ -318,21 +492,212 @@ namespace Nightbloom
 
 		// Store and return
 		VulkanTexture* ptr = texture.get();
-		m_Textures[name] = std::move(texture);
+		const TextureHandle handle = StoreTexture(name, std::move(texture));
+		if (!handle.IsValid())
+			return nullptr;
+		m_TexturePaths[TexturePathKey(prepared.path, allowStreaming)] = handle;
+		return ptr;
+	}
 
-		LOG_INFO("Loaded texture '{}' from {} ({}x{}, {} channels)",
-			name, filepath, imageData.width, imageData.height, imageData.channels);
+	std::unique_ptr<VulkanTexture> ResourceManager::BuildPreparedTexture(const std::string& name,
+		PreparedTexture& prepared, bool allowStreaming)
+	{
+		if (!prepared.IsValid())
+			return nullptr;
 
-		return ptr;
+		std::unique_ptr<VulkanTexture> texture;
+		if (prepared.cooked.IsOpen())
+		{
+			texture = CreateTextureFromKtx2(GetCookedTexturePath(prepared.path), prepared.cooked,
+				prepared.cookedImage, allowStreaming);
+
+			// The source is the fallback; only read it now that it's needed
+			if (!texture)
+				prepared.image = TextureLoader::LoadImageRGBA(prepared.path);
+		}
+
+		if (!texture)
+		{
+			const ImageData& imageData = prepared.image;
+			if (imageData.pixels.empty())
+			{
+				LOG_ERROR("Failed to load texture file: {}", prepared.path);
+				return nullptr;
+			}
+
+			// Create texture description
+			TextureDesc desc;
+			desc.width = imageData.width;
+			desc.height = imageData.height;
+			desc.format = imageData.channels == 4 ? TextureFormat::RGBA8 : TextureFormat::RGB8;
+			desc.mipLevels = 1;
+			desc.generateMips = true;
+			desc.usage = TextureUsage::Sampled | TextureUsage::Transfer;
+
+			// Create VulkanTexture
+			texture = std::make_unique<VulkanTexture>(m_Device, m_MemoryManager);
+			if (!texture->Initialize(desc))
+			{
+				LOG_ERROR("Failed to create texture '{}'", name);
+				return nullptr;
+			}
+
+			// Upload image data
+			if (!texture->UploadData(imageData.pixels.data(), imageData.pixels.size(), m_TransferCommandPool.get()))
+			{
+				LOG_ERROR("Failed to upload texture data for '{}'", name);
+				return nullptr;
+			}
+
+			LOG_INFO("Loaded texture '{}' from {} ({}x{}, {} channels)",
+				name, prepared.path, imageData.width, imageData.height, imageData.channels);
+		}
+		return texture;
+	}
+
+	std::vector<std::string> ResourceManager::FindTexturePathsForFile(const std::string& changedFile) const
+	{
+		const std::string changed = FileWatcher::NormalizePath(changedFile);
+		std::vector<std::string> paths;
+		for (const auto& [key, handle] : m_TexturePaths)
+		{
+			const std::string path = key.ends_with("|static") ? key.substr(0, key.size() - 7) : key;
+			if (std::find(paths.begin(), paths.end(), path) != paths.end())
+				continue;
+			if (FileWatcher::NormalizePath(path) == changed ||
+				FileWatcher::NormalizePath(GetCookedTexturePath(path)) == changed)
+			{
+				paths.push_back(path);
+			}
+		}
+		return paths;
+	}
+
+	uint32_t ResourceManager::ReloadTexture(PreparedTexture& prepared)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture));
+
+		uint32_t reloaded = 0;
+		std::vector<TextureStreamer::BindlessRemap> remaps;
+		for (bool allowStreaming : { true, false })
+		{
+			auto it = m_TexturePaths.find(TexturePathKey(prepared.path, allowStreaming));
+			const NamedResource<VulkanTexture>* entry = it != m_TexturePaths.end() ? m_Textures.Get(it->second) : nullptr;
+			if (!entry)
+				continue;
+
+			// Built whole: the streamer only tracks textures it created
+			VulkanTexture* texture = entry->resource.get();
+			std::unique_ptr<VulkanTexture> replacement = BuildPreparedTexture(entry->name.c_str(), prepared, false);
+			if (!replacement)
+			{
+				LOG_WARN("Reloading texture '{}' failed, keeping the old image", entry->name.c_str());
+				continue;
+			}
+
+			if (m_TextureStreamer)
+				m_TextureStreamer->Unregister(texture);
+			const uint32_t oldIndex = texture->GetBindlessIndex();
+			if (!texture->AdoptImage(*replacement, m_Device->GetDeletionQueue()))
+				continue;
+			if (texture->GetBindlessIndex() != oldIndex)
+				remaps.push_back({ oldIndex, texture->GetBindlessIndex() });
+			++reloaded;
+		}
+
+		RemapMaterialTextures(remaps);
+		return reloaded;
+	}
+
+	PreparedTextureMap ResourceManager::PrepareTextures(const std::vector<std::string>& filepaths) const
+	{
+		std::vector<std::string> pending;
+		for (const std::string& path : filepaths)
+		{
+			if (path.empty() || std::find(pending.begin(), pending.end(), path) != pending.end())
+				continue;
+			if (m_TexturePaths.count(TexturePathKey(ResolveTexturePath(path), true)))
+				continue;
+			pending.push_back(path);
+		}
+
+		// One file per job: decodes vary too much in size for larger chunks
+		std::vector<PreparedTexture> prepared(pending.size());
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(pending.size()), 1,
+			[&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+					prepared[i] = PrepareTexture(pending[i]);
+			});
+
+		PreparedTextureMap result;
+		for (size_t i = 0; i < pending.size(); ++i)
+			result.emplace(pending[i], std::move(prepared[i]));
+		return result;
+	}
+
+	bool ResourceManager::OpenCookedTexture(const std::string& path, AssetFile& file, Ktx2Image& image) const
+	{
+		file = AssetManager::Get().OpenAsset(path);
+		if (!file.IsOpen())
+			return false;
+
+		std::string error;
+		if (!ParseKtx2(file.GetData(), file.GetSize(), image, error))
+		{
+			LOG_WARN("Cannot use cooked texture '{}': {}", path, error);
+			file.Close();
+			return false;
+		}
+
+		const bool astc = image.format == TextureFormat::ASTC_4x4_RGBA;
+		const bool bc = image.format != TextureFormat::RGBA8 && !astc;
+		if ((bc && !m_Device->SupportsFeature("texture_compression_bc")) ||
+			(astc && !m_Device->SupportsFeature("texture_compression_astc")))
+		{
+			LOG_WARN("Device can't sample the format of '{}', loading the source instead", path);
+			file.Close();
+			return false;
+		}
+		return true;
+	}
+
+	std::unique_ptr<VulkanTexture> ResourceManager::CreateTextureFromKtx2(const std::string& path, AssetFile& file,
+		const Ktx2Image& image, bool allowStreaming)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture));
+
+		// Streamed textures start with just the mip tail; the rest follows
+		// once draws ask for it
+		const uint32_t baseMip = (allowStreaming && m_TextureStreamer) ? TextureStreamer::GetTailMip(image) : 0;
+		auto texture = TextureStreamer::CreateTexture(m_Device, m_MemoryManager, m_TransferCommandPool.get(),
+			file.GetData(), image, baseMip);
+		if (!texture)
+		{
+			LOG_WARN("Failed to create texture from cooked '{}'", path);
+			return nullptr;
+		}
+
+		uint64_t bytes = 0;
+		for (size_t level = baseMip; level < image.levels.size(); ++level)
+			bytes += image.levels[level].size;
+		LOG_INFO("Loaded cooked texture {} ({}x{}, {} mips, {} KB{})", path, image.width, image.height,
+			image.levels.size(), bytes / 1024, baseMip > 0 ? ", streamed" : "");
+
+		if (baseMip > 0)
+			m_TextureStreamer->Register(texture.get(), std::move(file), image);
+		return texture;
 	}
 
 	VulkanTexture* ResourceManager::CreateTexture(const std::string& name, const TextureDesc& desc)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture));
+
 		// Check if texture already exists
-		if (m_Textures.find(name) != m_Textures.end())
+		if (VulkanTexture* existing = GetTexture(name))
 		{
 			LOG_WARN("Texture '{}' already exists, returning existing texture", name);
-			return m_Textures[name].get();
+			return existing;
 		}
 
 		// Create VulkanTexture
@@ -345,7 +710,8 @@ namespace Nightbloom
 
 		// Store and return
 		VulkanTexture* ptr = texture.get();
-		m_Textures[name] = std::move(texture);
+		if (!StoreTexture(name, std::move(texture)).IsValid())
+			return nullptr;
 
 		LOG_INFO("Created texture '{}' ({}x{}, format: {})",
 			name, desc.width, desc.height, static_cast<int>(desc.format));
@@ -356,6 +722,8 @@ namespace Nightbloom
 	VulkanTexture* ResourceManager::CreateTextureFromMemory(const std::string& name, const void* data,
 		size_t size, const TextureDesc& desc)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture));
+
 		// Create the texture
 		VulkanTexture* texture = CreateTexture(name, desc);
 		if (!texture)
@@ -371,45 +739,91 @@ namespace Nightbloom
 			return nullptr;
 		}
 
+		// Engine textures may end up on any pipeline (primitives can switch
+		// to NodeGenerated), so they keep their own set next to the slot
 		if (m_DescriptorManager)
 		{
 			if (!texture->CreateDescriptorSet(m_DescriptorManager))
 			{
 				LOG_WARN("Failed to create descriptor set for texture '{}' - rendering may fail", name);
 			}
+			texture->RegisterBindless(m_DescriptorManager);
 		}
 
 		return texture;
 	}
 
-	VulkanTexture* ResourceManager::GetTexture(const std::string& name)
+	TextureHandle ResourceManager::StoreTexture(const std::string& name, std::unique_ptr<VulkanTexture> texture)
 	{
-		auto it = m_Textures.find(name);
-		if (it != m_Textures.end())
+		const StringId id = name;
+		const TextureHandle handle = m_Textures.Insert({ std::move(texture), id });
+		if (!handle.IsValid())
 		{
-			return it->second.get();
+			LOG_ERROR("Texture registry is full, can't add '{}'", name);
+			return {};
 		}
-		return nullptr;
+		m_TextureNames[id] = handle;
+		return handle;
+	}
+
+	TextureHandle ResourceManager::FindTexture(StringId name) const
+	{
+		auto it = m_TextureNames.find(name);
+		return it != m_TextureNames.end() ? it->second : TextureHandle{};
 	}
 
-	void ResourceManager::DestroyTexture(const std::string& name)
+	VulkanTexture* ResourceManager::GetTexture(TextureHandle handle) const
 	{
-		auto it = m_Textures.find(name);
-		if (it != m_Textures.end())
+		const NamedResource<VulkanTexture>* entry = m_Textures.Get(handle);
+		return entry ? entry->resource.get() : nullptr;
+	}
+
+	VulkanTexture* ResourceManager::GetTexture(StringId name)
+	{
+		return GetTexture(FindTexture(name));
+	}
+
+	void ResourceManager::DestroyTexture(TextureHandle handle)
+	{
+		NamedResource<VulkanTexture> texture = m_Textures.Remove(handle);
+		if (!texture.resource)
 		{
-			LOG_INFO("Destroying texture: {}", name);
-			m_Textures.erase(it);
+			LOG_WARN("Attempted to destroy a texture through a stale handle");
+			return;
 		}
-		else
+
+		LOG_INFO("Destroying texture: {}", texture.name.c_str());
+		if (m_TextureStreamer)
+			m_TextureStreamer->Unregister(texture.resource.get());
+		m_TextureNames.erase(texture.name);
+		std::erase_if(m_TexturePaths, [handle](const auto& entry) { return entry.second == handle; });
+		DeferDestroy(std::move(texture.resource));
+	}
+
+	void ResourceManager::DestroyTexture(StringId name)
+	{
+		const TextureHandle handle = FindTexture(name);
+		if (!handle.IsValid())
 		{
-			LOG_WARN("Attempted to destroy non-existent texture: {}", name);
+			LOG_WARN("Attempted to destroy non-existent texture: {}", name.c_str());
+			return;
 		}
+		DestroyTexture(handle);
 	}
 
 	void ResourceManager::DestroyAllTextures()
 	{
-		LOG_INFO("Destroying all {} textures", m_Textures.size());
-		m_Textures.clear();
+		LOG_INFO("Destroying all {} textures", m_Textures.Size());
+		if (m_TextureStreamer)
+		{
+			m_Textures.ForEach([this](TextureHandle, const NamedResource<VulkanTexture>& texture)
+				{
+					m_TextureStreamer->Unregister(texture.resource.get());
+				});
+		}
+		m_Textures.Clear();
+		m_TextureNames.clear();
+		m_TexturePaths.clear();
 	}
 
 	bool ResourceManager::CreateTestCube()
@@ -513,6 +927,7 @@ namespace Nightbloom
 		}
 
 		m_TestIndexCount = static_cast<uint32_t>(indices.size());
+		m_TestCubeExtents = glm::vec3(0.5f);
 
 		LOG_INFO("Created test cube with {} vertices and {} indices",
 			vertices.size(), indices.size());
@@ -521,22 +936,12 @@ namespace Nightbloom
 
 	Buffer* ResourceManager::GetTestVertexBuffer() const
 	{
-		auto it = m_Buffers.find("TestCubeVertices");
-		if (it != m_Buffers.end())
-		{
-			return static_cast<Buffer*>(it->second.get());
-		}
-		return nullptr;
+		return GetBuffer(FindBuffer("TestCubeVertices"));
 	}
 
 	Buffer* ResourceManager::GetTestIndexBuffer() const
 	{
-		auto it = m_Buffers.find("TestCubeIndices");
-		if (it != m_Buffers.end())
-		{
-			return static_cast<Buffer*>(it->second.get());
-		}
-		return nullptr;
+		return GetBuffer(FindBuffer("TestCubeIndices"));
 	}
 
 	bool ResourceManager::CreateGroundPlane(float size, float uvTile)
@@ -603,6 +1008,7 @@ namespace Nightbloom
 		}
 
 		m_GroundPlaneIndexCount = static_cast<uint32_t>(indices.size());
+		m_GroundPlaneExtents = glm::vec3(half, 0.0f, half);
 
 		LOG_INFO("Created ground plane: {}x{} units, UV tiling {}x{}",
 			size, size, uvTile, uvTile);
@@ -611,22 +1017,12 @@ namespace Nightbloom
 
 	Buffer* ResourceManager::GetGroundPlaneVertexBuffer() const
 	{
-		auto it = m_Buffers.find("GroundPlaneVertices");
-		if (it != m_Buffers.end())
-		{
-			return static_cast<Buffer*>(it->second.get());
-		}
-		return nullptr;
+		return GetBuffer(FindBuffer("GroundPlaneVertices"));
 	}
 
 	Buffer* ResourceManager::GetGroundPlaneIndexBuffer() const
 	{
-		auto it = m_Buffers.find("GroundPlaneIndices");
-		if (it != m_Buffers.end())
-		{
-			return static_cast<Buffer*>(it->second.get());
-		}
-		return nullptr;
+		return GetBuffer(FindBuffer("GroundPlaneIndices"));
 	}
 
 	bool ResourceManager::CreateMoonSphere(uint32_t rings, uint32_t sectors, float radius)
@@ -705,6 +1101,7 @@ namespace Nightbloom
 		}
 
 		m_MoonSphereIndexCount = static_cast<uint32_t>(indices.size());
+		m_MoonSphereExtents = glm::vec3(radius);
 		LOG_INFO("Created moon sphere: {} vertices, {} indices ({} rings x {} sectors)",
 			vertices.size(), indices.size(), rings, sectors);
 		return true;
@@ -712,14 +1109,151 @@ namespace Nightbloom
 
 	Buffer* ResourceManager::GetMoonSphereVertexBuffer() const
 	{
-		auto it = m_Buffers.find("MoonSphereVertices");
-		return (it != m_Buffers.end()) ? static_cast<Buffer*>(it->second.get()) : nullptr;
+		return GetBuffer(FindBuffer("MoonSphereVertices"));
 	}
 
 	Buffer* ResourceManager::GetMoonSphereIndexBuffer() const
 	{
-		auto it = m_Buffers.find("MoonSphereIndices");
-		return (it != m_Buffers.end()) ? static_cast<Buffer*>(it->second.get()) : nullptr;
+		return GetBuffer(FindBuffer("MoonSphereIndices"));
+	}
+
+	Buffer* ResourceManager::GetGridIndexBuffer(uint32_t quads, bool alternateDiagonals)
+	{
+		if (quads == 0)
+			return nullptr;
+
+		const uint64_t key = (static_cast<uint64_t>(quads) << 1) | (alternateDiagonals ? 1u : 0u);
+		auto it = m_GridIndexBuffers.find(key);
+		if (it != m_GridIndexBuffers.end())
+			return it->second.get();
+
+		const std::vector<uint32_t> indices = GridMesh::GenerateIndices(quads, alternateDiagonals);
+		const VkDeviceSize size = indices.size() * sizeof(uint32_t);
+		std::unique_ptr<VulkanBuffer> buffer = CreateIndexBufferUnique(
+			"GridIndices" + std::to_string(quads) + (alternateDiagonals ? "" : "_Aligned"), size, false);
+		if (!buffer || !buffer->UploadData(indices.data(), size, 0, m_TransferCommandPool.get()))
+		{
+			LOG_ERROR("Failed to create the index buffer of a {}x{} grid", quads, quads);
+			return nullptr;
+		}
+
+		LOG_INFO("Created {}x{} grid index buffer ({} indices)", quads, quads, indices.size());
+		return m_GridIndexBuffers.emplace(key, std::move(buffer)).first->second.get();
+	}
+
+	void ResourceManager::SetDescriptorManager(VulkanDescriptorManager* descriptorManager)
+	{
+		m_DescriptorManager = descriptorManager;
+		if (!m_DescriptorManager || !m_DescriptorManager->IsBindlessEnabled() || m_MaterialBuffer)
+			return;
+
+		const size_t tableBytes = VulkanDescriptorManager::MAX_BINDLESS_MATERIALS * sizeof(BindlessMaterialData);
+		m_MaterialBuffer = CreateStorageBuffer("BindlessMaterials", tableBytes, true);
+		if (!m_MaterialBuffer || !m_MaterialBuffer->GetPersistentMappedPtr())
+		{
+			LOG_ERROR("Failed to create bindless material table");
+			if (m_MaterialBuffer)
+				DestroyBuffer("BindlessMaterials");
+			m_MaterialBuffer = nullptr;
+			return;
+		}
+
+		m_DescriptorManager->UpdateBindlessMaterialBuffer(m_MaterialBuffer->GetBuffer(), tableBytes);
+	}
+
+	uint32_t ResourceManager::RegisterMaterial(const std::string& name, const Material& material)
+	{
+		if (!m_MaterialBuffer)
+			return BindlessIndexAllocator::INVALID_INDEX;
+
+		uint32_t slot = BindlessIndexAllocator::INVALID_INDEX;
+		auto it = m_MaterialSlots.find(name);
+		if (it != m_MaterialSlots.end())
+		{
+			slot = it->second;
+		}
+		else
+		{
+			if (m_MaterialSlots.size() >= VulkanDescriptorManager::MAX_BINDLESS_MATERIALS)
+			{
+				LOG_WARN("Bindless material table full, '{}' not registered", name);
+				return BindlessIndexAllocator::INVALID_INDEX;
+			}
+			slot = static_cast<uint32_t>(m_MaterialSlots.size());
+			m_MaterialSlots[name] = slot;
+			m_MaterialEntries.resize(slot + 1);
+		}
+
+		auto textureSlot = [](Texture* texture) {
+			VulkanTexture* vkTexture = static_cast<VulkanTexture*>(texture);
+			return vkTexture ? vkTexture->GetBindlessIndex() : BindlessIndexAllocator::INVALID_INDEX;
+		};
+
+		BindlessMaterialData data;
+		data.albedoColor = material.GetAlbedoColor();
+		data.albedoTexture = textureSlot(material.GetAlbedoTexture());
+		data.normalTexture = textureSlot(material.GetNormalTexture());
+		data.roughness = material.GetRoughness();
+		data.metallic = material.GetMetallic();
+
+		m_MaterialBuffer->Update(&data, sizeof(data), slot * sizeof(BindlessMaterialData));
+		m_MaterialEntries[slot] = { data, material.GetAlbedoTexture(), material.GetNormalTexture() };
+		return slot;
+	}
+
+	void ResourceManager::UpdateTextureStreaming(const DrawList& drawList, const LodView& view)
+	{
+		if (!m_TextureStreamer || m_TextureStreamer->GetStreamedCount() == 0)
+			return;
+
+		// A texture is assumed to span its draw's bounds once, so its
+		// footprint is the bounds' projected diameter
+		for (const DrawCommand& cmd : drawList.GetCommands())
+		{
+			if (!cmd.cameraVisible)
+				continue;
+
+			float pixels = std::numeric_limits<float>::max();
+			if (cmd.hasBounds && view.IsEnabled())
+			{
+				const float radius = glm::length(cmd.bounds.extents);
+				const float distance = std::max(glm::length(cmd.bounds.center - view.position) - radius, 0.0f);
+				pixels = 2.0f * radius * view.PixelsPerUnitAt(distance);
+			}
+
+			for (uint32_t i = 0; i < cmd.textures.GetCount(); ++i)
+				m_TextureStreamer->Request(cmd.textures[i], pixels);
+
+			const uint32_t materialIndex = cmd.hasPushConstants ? cmd.pushConstants.materialIndex : UINT32_MAX;
+			if (materialIndex < m_MaterialEntries.size())
+			{
+				m_TextureStreamer->Request(m_MaterialEntries[materialIndex].albedo, pixels);
+				m_TextureStreamer->Request(m_MaterialEntries[materialIndex].normal, pixels);
+			}
+		}
+
+		RemapMaterialTextures(m_TextureStreamer->Update());
+	}
+
+	void ResourceManager::RemapMaterialTextures(const std::vector<TextureStreamer::BindlessRemap>& remaps)
+	{
+		if (remaps.empty() || !m_MaterialBuffer)
+			return;
+
+		// Frames in flight keep the old slots until they are released, so
+		// entries can be rewritten in place
+		for (uint32_t slot = 0; slot < m_MaterialEntries.size(); ++slot)
+		{
+			BindlessMaterialData& data = m_MaterialEntries[slot].data;
+			bool changed = false;
+			for (const TextureStreamer::BindlessRemap& remap : remaps)
+			{
+				if (data.albedoTexture == remap.from) { data.albedoTexture = remap.to; changed = true; }
+				if (data.normalTexture == remap.from) { data.normalTexture = remap.to; changed = true; }
+			}
+			if (changed)
+				m_MaterialBuffer->Update(&data, sizeof(data), slot * sizeof(BindlessMaterialData));
+		}
 	}
 
 	bool ResourceManager::CreateDefaultTextures()
@@ -795,29 +1329,65 @@ namespace Nightbloom
 			}
 		}
 
-		LOG_INFO("Created {} default textures", m_Textures.size());
+		LOG_INFO("Created {} default textures", m_Textures.Size());
 		return true;
 	}
 	
-	size_t ResourceManager::GetTotalBufferMemory() const
+	void ResourceManager::GetDrawStreamResources(DrawStreamResources& resources) const
 	{
-		size_t total = 0;
-		for (const auto& [name, buffer] : m_Buffers)
+		m_Buffers.ForEach([&resources](BufferHandle, const NamedResource<VulkanBuffer>& buffer)
+			{
+				resources.Add(buffer.name, static_cast<const Buffer*>(buffer.resource.get()));
+			});
+		m_Textures.ForEach([&resources](TextureHandle, const NamedResource<VulkanTexture>& texture)
+			{
+				resources.Add(texture.name, static_cast<const Texture*>(texture.resource.get()));
+			});
+		if (m_MeshArena)
 		{
-			total += buffer->GetSize();
+			m_MeshArena->ForEachPage([&resources](const std::string& name, const VulkanBuffer* page)
+				{
+					resources.Add(name, static_cast<const Buffer*>(page));
+				});
 		}
+	}
+
+	size_t ResourceManager::GetTotalBufferMemory() const
+	{
+		size_t total = 0;
+		m_Buffers.ForEach([&total](BufferHandle, const NamedResource<VulkanBuffer>& buffer)
+			{
+				total += buffer.resource->GetSize();
+			});
 		return total;
 	}
 	
 	size_t ResourceManager::GetTotalTextureMemory() const
 	{
 		size_t total = 0;
-		for (const auto& [name, texture] : m_Textures)
-		{
-			// Estimate based on dimensions and format
-			uint32_t bytesPerPixel = 4; // Assume RGBA8 for now
-			total += texture->GetWidth() * texture->GetHeight() * bytesPerPixel;
-		}
+		m_Textures.ForEach([&total](TextureHandle, const NamedResource<VulkanTexture>& entry)
+			{
+				const VulkanTexture* texture = entry.resource.get();
+				// Estimate based on dimensions and format (mip 0 only)
+				const size_t texels = size_t(texture->GetWidth()) * texture->GetHeight();
+				switch (texture->GetFormat())
+				{
+				case TextureFormat::BC1_RGB:
+				case TextureFormat::BC1_RGBA:
+				case TextureFormat::BC4_R:
+					total += texels / 2;
+					break;
+				case TextureFormat::BC3_RGBA:
+				case TextureFormat::BC5_RG:
+				case TextureFormat::BC7_RGBA:
+				case TextureFormat::ASTC_4x4_RGBA:
+					total += texels;
+					break;
+				default:
+					total += texels * 4; // Assume RGBA8
+					break;
+				}
+			});
 		return total;
 	}
 } // namespace Nightbloom
\ No newline at end of file
@@ -7,24 +7,64 @@
 #pragma once
 
 #include <Vulkan/vulkan.h>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <string>
 #include <cstdint>
+#include <vector>
 
 // Full definitions
 #include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
 #include "Engine/Renderer/Vulkan/VulkanShader.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
+#include "Engine/Renderer/Vulkan/VulkanUploadManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMeshArena.hpp"
+#include "Engine/Renderer/Components/TextureStreamer.hpp"
+#include "Engine/Renderer/TextureLoader.hpp"
+#include "Engine/Renderer/ResourceHandle.hpp"
+#include "Engine/Core/SharedAssetCache.hpp"
+#include "Engine/Core/StringId.hpp"
 
 namespace Nightbloom
 {
 	// Forward Declarations
 	class VulkanDevice;
 	class VulkanMemoryManager;
-	class VulkanDescriptorManager;
 	class Buffer;
+	class Material;
+	class Model;
+	class DrawList;
+	class DrawStreamResources;
+	struct LodView;
+
+	// A texture file read ahead of creating the texture: the cooked KTX2
+	// when it is current and the device can sample it, the decoded source
+	// otherwise. Preparing touches no GPU state, so it can run on a loader
+	// thread (AsyncAssetLoader).
+	struct PreparedTexture
+	{
+		std::string path;       // resolved source path
+		AssetFile cooked;
+		Ktx2Image cookedImage;
+		ImageData image;
+
+		bool IsValid() const { return cooked.IsOpen() || !image.pixels.empty(); }
+	};
+	using PreparedTextureMap = std::unordered_map<std::string, PreparedTexture>;
+
+	struct BufferHandleTag;
+	struct TextureHandleTag;
+	struct ShaderHandleTag;
+	using BufferHandle = ResourceHandle<BufferHandleTag>;
+	using TextureHandle = ResourceHandle<TextureHandleTag>;
+	using ShaderHandle = ResourceHandle<ShaderHandleTag>;
+
+	// Source path -> the Model loaded from it, shared by every scene object
+	// placing it (SceneSerializer, the editor's Load Model)
+	using ModelCache = SharedAssetCache<Model>;
 
 	class ResourceManager
 	{
@@ -36,80 +76,260 @@ namespace Nightbloom
 		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager);
 		void Cleanup();
 
-		void SetDescriptorManager(VulkanDescriptorManager* descriptorManager) { m_DescriptorManager = descriptorManager; }
+		// Also creates the bindless material table when the descriptor
+		// manager has a bindless set
+		void SetDescriptorManager(VulkanDescriptorManager* descriptorManager);
 
-		// Buffer management
+		// Buffer management. Device-local vertex and index buffers up to
+		// DIRECT_WRITE_MESH_BYTES are written directly where the memory
+		// manager allows it (BufferDesc::directWrite), skipping the staging copy.
+		static constexpr size_t DIRECT_WRITE_MESH_BYTES = 256 * 1024;
 		VulkanBuffer* CreateVertexBuffer(const std::string& name, size_t size, bool hostVisible = false);
 		VulkanBuffer* CreateIndexBuffer(const std::string& name, size_t size, bool hostVisible = false);
 		VulkanBuffer* CreateUniformBuffer(const std::string& name, size_t size);
-		VulkanBuffer* CreateStorageBuffer(const std::string& name, size_t size, bool hostVisible = false);
+		// directWrite: it is rewritten from the CPU often (BufferDesc::directWrite)
+		VulkanBuffer* CreateStorageBuffer(const std::string& name, size_t size, bool hostVisible = false,
+			bool directWrite = false);
+		// Indirect-args buffer that compute can also write (storage). Host
+		// visible ones are persistently mapped for per-frame CPU writes.
+		VulkanBuffer* CreateIndirectBuffer(const std::string& name, size_t size, bool hostVisible = false);
+		// Device-local vertex buffer a compute pass writes (storage), such as
+		// SkinningSystem's skinned vertices. Never moved by defragmentation:
+		// descriptor sets hold it.
+		VulkanBuffer* CreateComputeVertexBuffer(const std::string& name, size_t size);
 
-		VulkanBuffer* GetBuffer(const std::string& name);
-		void DestroyBuffer(const std::string& name);
+		// Buffers, textures and shaders live in generational slot arrays
+		// (ResourceHandle.hpp). Look a name up once at load time and keep
+		// the handle: resolving it is an index and a generation check, and
+		// gives null once the resource is destroyed. The name overloads take
+		// a StringId: pass "name"_sid to skip hashing at run time.
+		BufferHandle FindBuffer(StringId name) const;
+		VulkanBuffer* GetBuffer(BufferHandle handle) const;
+		VulkanBuffer* GetBuffer(StringId name);
+		// Deferred like DeferDestroy: frames in flight may still read it
+		void DestroyBuffer(BufferHandle handle);
+		void DestroyBuffer(StringId name);
 
-		// Unique buffer creation (returns ownership for Mesh to hold)
+		// Unique buffer creation (returns ownership to the caller)
 		std::unique_ptr<VulkanBuffer> CreateVertexBufferUnique(const std::string& name, size_t size, bool hostVisible = false);
 		std::unique_ptr<VulkanBuffer> CreateIndexBufferUnique(const std::string& name, size_t size, bool hostVisible = false);
 
+		// Deferred destruction (VulkanDeletionQueue): released once every
+		// frame submitted so far has finished on the GPU, so a resource can
+		// be replaced at runtime without idling the device. Call before this
+		// frame's commands are recorded (update/UI code); with nothing in
+		// flight the resource goes right away.
+		void Defer(std::function<void()> destroy);
+		void DeferFreeDescriptorSet(VkDescriptorSet set);
+
+		template<typename T>
+		void DeferDestroy(T* resource)
+		{
+			if (resource)
+				Defer([resource]() { delete resource; });
+		}
+
+		template<typename T>
+		void DeferDestroy(std::unique_ptr<T> resource) { DeferDestroy(resource.release()); }
+
 		// Expose transfer command pool for uploads
 		VulkanCommandPool* GetTransferCommandPool() const { return m_TransferCommandPool.get(); }
 
+		// Non-blocking uploads (null if it failed to initialize). Wrap bulk
+		// loads in an UploadBatchScope to submit them together.
+		VulkanUploadManager* GetUploadManager() const { return m_UploadManager.get(); }
+
+		// Shared vertex/index buffers that model meshes sub-allocate from
+		VulkanMeshArena* GetMeshArena() const { return m_MeshArena.get(); }
+
 		// Shader management
 		VulkanShader* LoadShader(const std::string& name, ShaderStage stage,
 			const std::string& filename);
-		VulkanShader* GetShader(const std::string& name);
-		void DestroyShader(const std::string& name);
+		ShaderHandle FindShader(StringId name) const;
+		VulkanShader* GetShader(ShaderHandle handle) const;
+		VulkanShader* GetShader(StringId name);
+		void DestroyShader(StringId name);
 		void DestroyAllShaders();
 
-		VulkanTexture* LoadTexture(const std::string& name, const std::string& filepath);
+		// Cooked textures with mips above TextureStreamer::TAIL_SIZE stream
+		// their finer levels unless allowStreaming is off - needed when the
+		// texture's view is written into a descriptor set other than its own
+		VulkanTexture* LoadTexture(const std::string& name, const std::string& filepath, bool allowStreaming = true);
+
+		// LoadTexture in two halves. PrepareTexture only reads files and is
+		// safe to call from any thread; CreatePreparedTexture makes the GPU
+		// texture (main thread) and consumes `prepared`.
+		PreparedTexture PrepareTexture(const std::string& filepath) const;
+		VulkanTexture* CreatePreparedTexture(const std::string& name, PreparedTexture& prepared, bool allowStreaming = true);
+
+		// Prepares every distinct path not loaded yet, in parallel on the
+		// job system. Keyed by the paths as given.
+		PreparedTextureMap PrepareTextures(const std::vector<std::string>& filepaths) const;
+
+		// A file already loaded (under any name) is not loaded again: both
+		// halves above return the existing texture for its path
+		VulkanTexture* FindTextureByPath(const std::string& filepath, bool allowStreaming = true);
+
+		// Hot reload (AssetHotReload.hpp). FindTexturePathsForFile gives the
+		// resolved paths of loaded textures that `changedFile` - a source
+		// image or its cooked .ktx2 - feeds. ReloadTexture rebuilds every
+		// texture loaded from prepared.path and swaps the new image in
+		// (VulkanTexture::AdoptImage): handles, names and pointers stay
+		// valid, material table entries follow the new bindless slots and
+		// the old image goes once frames in flight are done with it. A
+		// reloaded texture stays fully resident instead of streaming.
+		// Returns how many textures changed.
+		std::vector<std::string> FindTexturePathsForFile(const std::string& changedFile) const;
+		uint32_t ReloadTexture(PreparedTexture& prepared);
 		VulkanTexture* CreateTexture(const std::string& name, const TextureDesc& desc);
 		VulkanTexture* CreateTextureFromMemory(const std::string& name, const void* data, size_t size, const TextureDesc& desc);
-		VulkanTexture* GetTexture(const std::string& name);
-		void DestroyTexture(const std::string& name);
+		TextureHandle FindTexture(StringId name) const;
+		VulkanTexture* GetTexture(TextureHandle handle) const;
+		VulkanTexture* GetTexture(StringId name);
+		// Deferred like DestroyBuffer
+		void DestroyTexture(TextureHandle handle);
+		void DestroyTexture(StringId name);
 		void DestroyAllTextures();
 
-		// Test Geometry (temporary - will be replaced with proper mesh loading)
+		// Test Geometry (temporary - will be replaced with proper mesh loading).
+		// Each primitive is centered on the origin; Get*Extents is the half
+		// size of its object-space AABB, for culling.
 		bool CreateTestCube();
 		Buffer* GetTestVertexBuffer() const;
 		Buffer* GetTestIndexBuffer() const;
 		uint32_t GetTestIndexCount() const { return m_TestIndexCount; }
+		const glm::vec3& GetTestCubeExtents() const { return m_TestCubeExtents; }
 
 		bool CreateGroundPlane(float size = 20.0f, float uvTile = 10.0f);
 		Buffer* GetGroundPlaneVertexBuffer() const;
 		Buffer* GetGroundPlaneIndexBuffer() const;
 		uint32_t GetGroundPlaneIndexCount() const { return m_GroundPlaneIndexCount; }
+		const glm::vec3& GetGroundPlaneExtents() const { return m_GroundPlaneExtents; }
 
 		// Moon sphere (emissive moon primitive — rendered via PipelineType::Mesh)
 		bool CreateMoonSphere(uint32_t rings = 32, uint32_t sectors = 64, float radius = 1.0f);
 		Buffer* GetMoonSphereVertexBuffer() const;
 		Buffer* GetMoonSphereIndexBuffer() const;
 		uint32_t GetMoonSphereIndexCount() const { return m_MoonSphereIndexCount; }
+		const glm::vec3& GetMoonSphereExtents() const { return m_MoonSphereExtents; }
 
 
+		// Index buffer of a quads x quads grid drawn without vertices
+		// (GridMesh.hpp). Built on first use for each size and kept until
+		// Cleanup, so grids switching resolution upload nothing. Null if
+		// the buffer couldn't be created.
+		Buffer* GetGridIndexBuffer(uint32_t quads, bool alternateDiagonals = true);
+
 		bool CreateDefaultTextures();
 
+		// Bindless material table. Slots are keyed by name like textures, so
+		// reloading a model rewrites its existing entries. Returns
+		// INVALID_INDEX without a table (or when it is full).
+		uint32_t RegisterMaterial(const std::string& name, const Material& material);
+
+		// Once per frame with the final draw list, before recording: requests
+		// each streamed texture's mips from its draws' screen size (draws
+		// without bounds, or without an enabled view, want full detail) and
+		// moves material table entries along with any bindless slots that
+		// changed
+		void UpdateTextureStreaming(const DrawList& drawList, const LodView& view);
+		TextureStreamer* GetTextureStreamer() const { return m_TextureStreamer.get(); }
+
+		// Weak references only: a Model lives as long as the objects using it
+		ModelCache& GetModelCache() { return m_ModelCache; }
+
+		// Every named buffer and texture and the mesh arena's pages, under
+		// their names, for capturing and replaying draw streams
+		void GetDrawStreamResources(DrawStreamResources& resources) const;
+
 		// Resource statistics
 		size_t GetTotalBufferMemory() const;
-		size_t GetBufferCount() const { return m_Buffers.size(); }
+		size_t GetBufferCount() const { return m_Buffers.Size(); }
 		size_t GetTotalTextureMemory() const;
-		size_t GetTextureCount() const { return m_Textures.size(); }
+		size_t GetTextureCount() const { return m_Textures.Size(); }
 
 	private:
+		template<typename T>
+		struct NamedResource
+		{
+			std::unique_ptr<T> resource;
+			StringId name;   // its key in the matching name map
+		};
+
+		// Register under `name`; null handle if the registry is full. A
+		// buffer created under a taken name replaces the old one.
+		BufferHandle StoreBuffer(const std::string& name, std::unique_ptr<VulkanBuffer> buffer);
+		TextureHandle StoreTexture(const std::string& name, std::unique_ptr<VulkanTexture> texture);
+
+		static std::string ResolveTexturePath(const std::string& filepath);
+		static std::string TexturePathKey(const std::string& resolvedPath, bool allowStreaming)
+		{
+			return allowStreaming ? resolvedPath : resolvedPath + "|static";
+		}
+
+		// The GPU texture for `prepared`, without a descriptor set or
+		// bindless slot; null if the file couldn't be used
+		std::unique_ptr<VulkanTexture> BuildPreparedTexture(const std::string& name, PreparedTexture& prepared,
+			bool allowStreaming);
+
+		// Rewrites material table entries that sample a moved bindless slot
+		void RemapMaterialTextures(const std::vector<TextureStreamer::BindlessRemap>& remaps);
+
+		// Maps and parses a cooked KTX2 (TextureCooker.hpp); false when the
+		// file can't be used here (format unsupported by the device,
+		// supercompressed, corrupt) so the caller falls back to the source
+		bool OpenCookedTexture(const std::string& path, AssetFile& file, Ktx2Image& image) const;
+
+		// Texture with the cooked image's stored mips; takes over `file`
+		// when the texture streams
+		std::unique_ptr<VulkanTexture> CreateTextureFromKtx2(const std::string& path, AssetFile& file,
+			const Ktx2Image& image, bool allowStreaming);
+
 		VulkanDevice* m_Device = nullptr;
 		VulkanMemoryManager* m_MemoryManager = nullptr;
 		VulkanDescriptorManager* m_DescriptorManager = nullptr;
 		std::unique_ptr<VulkanCommandPool> m_TransferCommandPool;  // For staging uploads
+		std::unique_ptr<VulkanUploadManager> m_UploadManager;
+		std::unique_ptr<TextureStreamer> m_TextureStreamer;
+		std::unique_ptr<VulkanMeshArena> m_MeshArena;
+		VulkanBuffer* m_MaterialBuffer = nullptr;  // owned by m_Buffers
+		std::unordered_map<std::string, uint32_t> m_MaterialSlots;
+
+		// What each material slot holds, so slots can be rewritten when a
+		// streamed texture's bindless index moves
+		struct MaterialEntry
+		{
+			BindlessMaterialData data;
+			Texture* albedo = nullptr;
+			Texture* normal = nullptr;
+		};
+		std::vector<MaterialEntry> m_MaterialEntries;
 
 		// Resource storage
-		std::unordered_map<std::string, std::unique_ptr<VulkanBuffer>> m_Buffers;
-		std::unordered_map<std::string, std::unique_ptr<VulkanShader>> m_Shaders;
-		std::unordered_map<std::string, std::unique_ptr<VulkanTexture>> m_Textures;
+		ResourcePool<NamedResource<VulkanBuffer>, BufferHandleTag> m_Buffers;
+		ResourcePool<NamedResource<VulkanShader>, ShaderHandleTag> m_Shaders;
+		ResourcePool<NamedResource<VulkanTexture>, TextureHandleTag> m_Textures;
+
+		// Load-time lookups by name
+		std::unordered_map<StringId, BufferHandle> m_BufferNames;
+		std::unordered_map<StringId, ShaderHandle> m_ShaderNames;
+		std::unordered_map<StringId, TextureHandle> m_TextureNames;
+		// Resolved file path -> the texture loaded from it; separate entries
+		// for streaming and non-streaming loads of one file
+		std::unordered_map<std::string, TextureHandle> m_TexturePaths;
+		ModelCache m_ModelCache;
 		// Future: std::vector<VkSampler> m_Samplers;
 
 		// Test resources (temporary)
 		uint32_t m_TestIndexCount = 0;
 		uint32_t m_GroundPlaneIndexCount = 0;
 		uint32_t m_MoonSphereIndexCount = 0;
+		glm::vec3 m_TestCubeExtents = glm::vec3(0.0f);
+		glm::vec3 m_GroundPlaneExtents = glm::vec3(0.0f);
+		glm::vec3 m_MoonSphereExtents = glm::vec3(0.0f);
+
+		// GetGridIndexBuffer's, keyed by quads << 1 | alternateDiagonals
+		std::unordered_map<uint64_t, std::unique_ptr<VulkanBuffer>> m_GridIndexBuffers;
 
 		// Prevent copying
 		ResourceManager(const ResourceManager&) = delete;
@@ -0,0 +1,368 @@
+//------------------------------------------------------------------------------
+// ScreenSpaceReflections.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/ScreenSpaceReflections.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <array>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t SSR_LOCAL_SIZE = 8;  // SSRHistory.comp, SSRTrace.comp
+		constexpr VkFormat SSR_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+		// Matches SSRParams in ssr.glsl
+		struct SSRPushConstants
+		{
+			glm::mat4 prevViewProj;
+			glm::vec4 pyramid;
+			glm::vec4 params;
+			glm::ivec4 extents;
+			glm::vec4 reserved;
+		};
+		static_assert(sizeof(SSRPushConstants) == 128, "Must match ssr.glsl");
+	}
+
+	bool ScreenSpaceReflections::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager, VkImageView sceneColorView,
+		VkExtent2D sceneExtent, VkExtent2D historyExtent)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_DescriptorManager = descriptorManager;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_Sampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ScreenSpaceReflections: failed to create sampler");
+			return false;
+		}
+
+		m_Set = m_DescriptorManager->AllocateScreenSpaceReflectionSet();
+		m_OutputSet = m_DescriptorManager->AllocateReflectionInputSet();
+		if (m_Set == VK_NULL_HANDLE || m_OutputSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ScreenSpaceReflections: failed to allocate descriptor sets");
+			return false;
+		}
+
+		if (!CreatePipelines())
+			return false;
+
+		if (!CreateImages(sceneColorView, sceneExtent, historyExtent))
+			return false;
+
+		LOG_INFO("ScreenSpaceReflections initialized ({}x{} output, {}x{} history)",
+			m_OutputExtent.width, m_OutputExtent.height, m_HistoryExtent.width, m_HistoryExtent.height);
+		return true;
+	}
+
+	void ScreenSpaceReflections::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		DestroyImages();
+
+		VkPipeline pipelines[] = { m_HistoryPipeline, m_TracePipeline };
+		for (VkPipeline pipeline : pipelines)
+		{
+			if (pipeline != VK_NULL_HANDLE)
+				vkDestroyPipeline(device, pipeline, nullptr);
+		}
+		m_HistoryPipeline = m_TracePipeline = VK_NULL_HANDLE;
+
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		m_Sampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_Device = nullptr;
+	}
+
+	bool ScreenSpaceReflections::Resize(VkImageView sceneColorView, VkExtent2D sceneExtent, VkExtent2D historyExtent)
+	{
+		DestroyImages();
+		return CreateImages(sceneColorView, sceneExtent, historyExtent);
+	}
+
+	bool ScreenSpaceReflections::CreateImages(VkImageView sceneColorView, VkExtent2D sceneExtent,
+		VkExtent2D historyExtent)
+	{
+		m_HistoryValid = false;
+		if (sceneColorView == VK_NULL_HANDLE || sceneExtent.width == 0 || sceneExtent.height == 0 ||
+			historyExtent.width == 0 || historyExtent.height == 0)
+			return false;
+
+		VkDevice device = m_Device->GetDevice();
+		auto createImage = [&](VkExtent2D extent, VkImage& image, void*& allocation, VkImageView& view, const char* name)
+		{
+			VulkanMemoryManager::ImageCreateInfo imageInfo{};
+			imageInfo.width = extent.width;
+			imageInfo.height = extent.height;
+			imageInfo.format = SSR_FORMAT;
+			imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+			imageInfo.category = GpuMemoryCategory::RenderTarget;
+			imageInfo.debugName = name;
+
+			auto* created = m_MemoryManager->CreateImage(imageInfo);
+			if (!created)
+			{
+				LOG_ERROR("ScreenSpaceReflections: failed to create {}x{} {}", extent.width, extent.height, name);
+				return false;
+			}
+			allocation = created;
+			image = created->image;
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = SSR_FORMAT;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.layerCount = 1;
+			if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+			{
+				LOG_ERROR("ScreenSpaceReflections: failed to create {} view", name);
+				return false;
+			}
+			return true;
+		};
+
+		if (!createImage(historyExtent, m_HistoryImage, m_HistoryAllocation, m_HistoryView, "history") ||
+			!createImage(sceneExtent, m_OutputImage, m_OutputAllocation, m_OutputView, "output"))
+			return false;
+
+		VulkanDescriptorManager::ScreenSpaceReflectionImages images{};
+		images.sceneColorView = sceneColorView;
+		images.historyView = m_HistoryView;
+		images.outputView = m_OutputView;
+		images.sampler = m_Sampler;
+		m_DescriptorManager->UpdateScreenSpaceReflectionSet(m_Set, images);
+		m_DescriptorManager->UpdateReflectionInputSet(m_OutputSet, m_OutputView, m_Sampler);
+
+		m_HistoryExtent = historyExtent;
+		m_OutputExtent = sceneExtent;
+		return true;
+	}
+
+	void ScreenSpaceReflections::DestroyImages()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		VkImageView* views[] = { &m_HistoryView, &m_OutputView };
+		for (VkImageView* view : views)
+		{
+			if (*view != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(device, *view, nullptr);
+				*view = VK_NULL_HANDLE;
+			}
+		}
+		void** allocations[] = { &m_HistoryAllocation, &m_OutputAllocation };
+		for (void** allocation : allocations)
+		{
+			if (*allocation)
+			{
+				m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(*allocation));
+				*allocation = nullptr;
+			}
+		}
+		m_HistoryImage = m_OutputImage = VK_NULL_HANDLE;
+		m_HistoryExtent = m_OutputExtent = { 0, 0 };
+		m_HistoryValid = false;
+	}
+
+	bool ScreenSpaceReflections::CreatePipelines()
+	{
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(SSRPushConstants);
+
+		std::array<VkDescriptorSetLayout, 3> setLayouts = {
+			m_DescriptorManager->GetUniformSetLayout(),
+			m_DescriptorManager->GetScreenSpaceReflectionSetLayout(),
+			m_DescriptorManager->GetHiZSampleSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		layoutInfo.pSetLayouts = setLayouts.data();
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("ScreenSpaceReflections: failed to create pipeline layout");
+			return false;
+		}
+
+		m_HistoryPipeline = CreatePipeline("SSRHistory.comp.spv");
+		m_TracePipeline = CreatePipeline("SSRTrace.comp.spv");
+		return m_HistoryPipeline != VK_NULL_HANDLE && m_TracePipeline != VK_NULL_HANDLE;
+	}
+
+	VkPipeline ScreenSpaceReflections::CreatePipeline(const char* shaderName)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("ScreenSpaceReflections: failed to load {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("ScreenSpaceReflections: failed to create shader module for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("ScreenSpaceReflections: failed to create compute pipeline for {}", shaderName);
+			return VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, shaderName);
+		return pipeline;
+	}
+
+	void ScreenSpaceReflections::RecordHistory(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
+		const OcclusionCuller& culler, VkExtent2D renderExtent)
+	{
+		if (!dispatcher || m_HistoryPipeline == VK_NULL_HANDLE || m_HistoryExtent.width == 0 || !culler.HasPyramid())
+			return;
+
+		const VkExtent2D built = culler.GetBuiltExtent();
+		if (built.width > m_HistoryExtent.width || built.height > m_HistoryExtent.height)
+			return;
+
+		// This frame's trace read the history; its first use also leaves UNDEFINED
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = m_HistoryValid ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_HistoryImage;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		SSRPushConstants push{};
+		push.pyramid = glm::vec4(static_cast<float>(built.width), static_cast<float>(built.height), 0.0f, 0.0f);
+		push.extents = glm::ivec4(
+			static_cast<int>(std::clamp(renderExtent.width, 1u, m_OutputExtent.width)),
+			static_cast<int>(std::clamp(renderExtent.height, 1u, m_OutputExtent.height)), 0, 0);
+
+		dispatcher->BindPipeline(cmd, m_HistoryPipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 1, m_Set);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(built.width, SSR_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(built.height, SSR_LOCAL_SIZE));
+
+		// -> next frame's trace
+		dispatcher->ComputeToComputeImageBarrier(cmd, m_HistoryImage);
+		m_HistoryValid = true;
+	}
+
+	void ScreenSpaceReflections::RecordTrace(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
+		const OcclusionCuller& culler, VkDescriptorSet frameSet, const ScreenSpaceReflectionTrace& trace)
+	{
+		if (!dispatcher || m_TracePipeline == VK_NULL_HANDLE || m_OutputExtent.width == 0)
+			return;
+
+		const VkExtent2D render = {
+			std::clamp(trace.renderExtent.width, 1u, m_OutputExtent.width),
+			std::clamp(trace.renderExtent.height, 1u, m_OutputExtent.height) };
+		const VkExtent2D built = culler.GetBuiltExtent();
+		const bool valid = m_HistoryValid && culler.HasPyramid();
+
+		// Last frame's water read the output; its contents don't matter
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_OutputImage;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		SSRPushConstants push{};
+		push.prevViewProj = culler.GetPyramidViewProjection();
+		push.pyramid = glm::vec4(static_cast<float>(built.width), static_cast<float>(built.height),
+			static_cast<float>(culler.GetMipCount()), valid ? 1.0f : 0.0f);
+		push.params = glm::vec4(trace.waterY, trace.nearPlane, trace.maxDistance, trace.thickness);
+		push.extents = glm::ivec4(static_cast<int>(render.width), static_cast<int>(render.height),
+			static_cast<int>(m_OutputExtent.width), static_cast<int>(m_OutputExtent.height));
+
+		dispatcher->BindPipeline(cmd, m_TracePipeline);
+		dispatcher->BindDescriptorSets(cmd, m_PipelineLayout, 0, { frameSet, m_Set, culler.GetPyramidSampleSet() });
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(render.width, SSR_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(render.height, SSR_LOCAL_SIZE));
+
+		// Output -> the water's fragment shader
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+}
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+// ScreenSpaceReflections.hpp
+//
+// Screen-space reflections for the water plane, the cheap alternative to the
+// planar reflection pass (which re-renders the opaque scene from the
+// mirrored camera). Two compute passes:
+//   - RecordHistory, after the scene pass and the Hi-Z build: a 2x2 box
+//     downsample of the scene color into a history image texel-aligned
+//     with OcclusionCuller's pyramid mip 0 (SSRHistory.comp).
+//   - RecordTrace, before the scene pass: per render pixel, reflect the
+//     camera ray off the water plane and march the reflected ray through
+//     the pyramid's nearest-depth layer, reading the hit color from the
+//     history (SSRTrace.comp). The output matches the planar reflection
+//     target (size and vertical flip), so Water.frag samples either one.
+//
+// Both inputs are one frame old: the trace reprojects through the matrix
+// they were rendered with, so a static scene reflects correctly under camera
+// motion, while moving objects reflect where they were a frame ago. Rays that
+// leave the screen or find nothing fall back to the environment probe (set
+// 0 binding 7, see EnvironmentProbeCache.hpp), so off-screen geometry is
+// missing from the reflection - the usual screen-space trade. Invalidate (camera cut, resize) makes
+// every pixel a miss until the next RecordHistory.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+	class OcclusionCuller;
+
+	// Per-frame inputs of RecordTrace besides the pyramid
+	struct ScreenSpaceReflectionTrace
+	{
+		float waterY = 0.0f;
+		float nearPlane = 0.1f;
+		float maxDistance = 150.0f;   // world units along the reflected ray
+		float thickness = 1.5f;       // how far behind a surface still counts as a hit (world units)
+		VkExtent2D renderExtent = { 0, 0 };
+	};
+
+	class ScreenSpaceReflections
+	{
+	public:
+		ScreenSpaceReflections() = default;
+		~ScreenSpaceReflections() = default;
+
+		// sceneColorView/sceneExtent: RenderPassManager's single-sample scene
+		// color (the output matches its size); historyExtent: the pyramid's
+		// mip 0 size (OcclusionCuller::GetPyramidExtent)
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager, VkImageView sceneColorView,
+			VkExtent2D sceneExtent, VkExtent2D historyExtent);
+		void Cleanup();
+
+		// Swapchain resize: the scene targets and the pyramid were recreated.
+		// Caller has waited idle.
+		bool Resize(VkImageView sceneColorView, VkExtent2D sceneExtent, VkExtent2D historyExtent);
+
+		// After OcclusionCuller::BuildPyramid, over the region it just built
+		void RecordHistory(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const OcclusionCuller& culler,
+			VkExtent2D renderExtent);
+
+		// Before the scene pass, after the environment probe's. frameSet: the
+		// frame uniform set. Leaves the output readable by fragment shaders.
+		void RecordTrace(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const OcclusionCuller& culler,
+			VkDescriptorSet frameSet, const ScreenSpaceReflectionTrace& trace);
+
+		// Forget the history - every pixel misses until the next RecordHistory
+		void Invalidate() { m_HistoryValid = false; }
+
+		// Reflection input set (VulkanDescriptorManager's reflection input
+		// layout) holding the output, for the Water pipeline's set 2
+		VkDescriptorSet GetOutputSet() const { return m_OutputSet; }
+		VkImage GetOutputImage() const { return m_OutputImage; }
+
+	private:
+		bool CreateImages(VkImageView sceneColorView, VkExtent2D sceneExtent, VkExtent2D historyExtent);
+		void DestroyImages();
+		bool CreatePipelines();
+		VkPipeline CreatePipeline(const char* shaderName);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		// Half-resolution scene color, always in GENERAL
+		VkImage m_HistoryImage = VK_NULL_HANDLE;
+		void* m_HistoryAllocation = nullptr;   // VulkanMemoryManager::ImageAllocation*
+		VkImageView m_HistoryView = VK_NULL_HANDLE;
+		VkExtent2D m_HistoryExtent = { 0, 0 };
+		bool m_HistoryValid = false;
+
+		// Reflection output, written in GENERAL and left SHADER_READ_ONLY
+		VkImage m_OutputImage = VK_NULL_HANDLE;
+		void* m_OutputAllocation = nullptr;    // VulkanMemoryManager::ImageAllocation*
+		VkImageView m_OutputView = VK_NULL_HANDLE;
+		VkExtent2D m_OutputExtent = { 0, 0 };
+
+		VkSampler m_Sampler = VK_NULL_HANDLE;  // linear, clamp
+
+		VkDescriptorSet m_Set = VK_NULL_HANDLE;          // set 1 of both passes
+		VkDescriptorSet m_OutputSet = VK_NULL_HANDLE;    // output for Water.frag
+
+		// Set 0 = frame uniforms, 1 = SSR images, 2 = Hi-Z pyramid
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_HistoryPipeline = VK_NULL_HANDLE;
+		VkPipeline m_TracePipeline = VK_NULL_HANDLE;
+
+		ScreenSpaceReflections(const ScreenSpaceReflections&) = delete;
+		ScreenSpaceReflections& operator=(const ScreenSpaceReflections&) = delete;
+	};
+}
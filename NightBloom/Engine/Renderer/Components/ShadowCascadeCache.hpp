@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+// ShadowCascadeCache.hpp
+//
+// Decides which shadow cascades refit their light matrix this frame. Near
+// cascades refit every frame. Far cascades keep the matrix they were last
+// fitted with — fitted with cachePadding extra radius — until:
+//   - the current slice's bounding sphere no longer fits in the padded one
+//     (refit immediately, or shadows would be missing at the edge),
+//   - the cache is invalidated (resize, toggle, terrain rebuilt), or
+//   - they come due: every farCascadeRefreshFrames, or once the light has
+//     turned past cacheLightAngleDeg. Due cascades refit one per frame,
+//     oldest first, so far cascades never all re-render on the same frame.
+//
+// A frozen cascade only re-renders its static casters when it refits; its
+// dynamic casters are still drawn every frame (see Renderer::RecordShadowPass).
+// A local static edit (terrain sculpting) re-renders only the static layers
+// of the cascades that can see it (CascadesTouching).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Light.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class ShadowCascadeCache
+	{
+	public:
+		void Invalidate()
+		{
+			for (CascadeState& state : m_States)
+				state.valid = false;
+		}
+
+		// Cascades at or past this index are cached (padded, frozen between refits)
+		static uint32_t FirstCachedCascade(const ShadowConfig& config)
+		{
+			if (!config.cacheFarCascades || config.farCascadeRefreshFrames <= 1)
+				return NUM_CASCADES;
+			return std::clamp(config.nearCascadesPerFrame, 1u, NUM_CASCADES);
+		}
+
+		// Call once per frame with each cascade's freshly computed slice sphere.
+		// Returns a bitmask of cascades to refit; the others keep their last
+		// matrices. Fit refreshed cascade c with radius * (1 + cachePadding) when
+		// c >= FirstCachedCascade(config).
+		uint32_t Update(const ShadowConfig& config, const glm::vec3& lightDir,
+			const glm::vec3 (&centers)[NUM_CASCADES], const float (&radii)[NUM_CASCADES])
+		{
+			const uint32_t firstCached = FirstCachedCascade(config);
+			const float padding = std::max(config.cachePadding, 0.0f);
+			const float minLightDot = std::cos(glm::radians(config.cacheLightAngleDeg));
+
+			uint32_t refresh = 0;
+			uint32_t oldestDue = NUM_CASCADES;
+			for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+			{
+				CascadeState& state = m_States[c];
+				++state.age;
+
+				if (c < firstCached || !state.valid)
+				{
+					refresh |= 1u << c;
+					continue;
+				}
+
+				// Slice must stay inside the sphere the cached matrix was fitted to; a
+				// much smaller slice is worth refitting too (wasted texel density)
+				const float fitted = state.radius * (1.0f + padding);
+				if (glm::length(centers[c] - state.center) + radii[c] > fitted ||
+					radii[c] < state.radius * (1.0f - padding))
+				{
+					refresh |= 1u << c;
+					continue;
+				}
+
+				const bool due = state.age >= config.farCascadeRefreshFrames ||
+					glm::dot(lightDir, state.lightDir) < minLightDot;
+				if (due && (oldestDue == NUM_CASCADES || state.age > m_States[oldestDue].age))
+					oldestDue = c;
+			}
+
+			// At most one scheduled refit per frame, unless one was forced anyway
+			if (oldestDue != NUM_CASCADES && (refresh >> firstCached) == 0)
+				refresh |= 1u << oldestDue;
+
+			for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+			{
+				if ((refresh & (1u << c)) == 0)
+					continue;
+
+				CascadeState& state = m_States[c];
+				state.valid = true;
+				state.age = 0;
+				state.center = centers[c];
+				state.radius = radii[c];
+				state.lightDir = lightDir;
+			}
+			return refresh;
+		}
+
+		// Cached cascades whose last fit can see the world box [boundsMin,
+		// boundsMax]: seen down the light, the box comes within the padded
+		// radius (depth along the light is not clipped). For edits to static
+		// geometry that should only re-render the cascades they touch.
+		uint32_t CascadesTouching(const ShadowConfig& config, const glm::vec3& boundsMin,
+			const glm::vec3& boundsMax) const
+		{
+			const float padding = std::max(config.cachePadding, 0.0f);
+			const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+			const glm::vec3 half = (boundsMax - boundsMin) * 0.5f;
+
+			uint32_t touching = 0;
+			for (uint32_t c = FirstCachedCascade(config); c < NUM_CASCADES; ++c)
+			{
+				const CascadeState& state = m_States[c];
+				if (!state.valid)
+					continue;
+
+				auto acrossLight = [&state](const glm::vec3& v)
+				{
+					return glm::length(v - glm::dot(v, state.lightDir) * state.lightDir);
+				};
+
+				// Widest the box gets across the light: its farthest corner
+				float boxRadius = 0.0f;
+				for (float sy : { -1.0f, 1.0f })
+					for (float sz : { -1.0f, 1.0f })
+						boxRadius = std::max(boxRadius, acrossLight(half * glm::vec3(1.0f, sy, sz)));
+
+				if (acrossLight(center - state.center) <= state.radius * (1.0f + padding) + boxRadius)
+					touching |= 1u << c;
+			}
+			return touching;
+		}
+
+	private:
+		struct CascadeState
+		{
+			bool valid = false;
+			uint32_t age = 0;              // frames since last refit
+			glm::vec3 center = glm::vec3(0.0f);
+			float radius = 0.0f;           // unpadded slice radius at the last refit
+			glm::vec3 lightDir = glm::vec3(0.0f, -1.0f, 0.0f);
+		};
+
+		CascadeState m_States[NUM_CASCADES];
+	};
+}
@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+// ShadowCascadeResolution.hpp
+//
+// Per-cascade shadow resolution (ShadowConfig::cascadeResolutionScale). The
+// cascades stay layers of one depth array - the layered pass fans casters
+// out with gl_Layer, so the layers can't differ in size - and a cascade
+// given fewer texels renders into the top-left texels x texels corner of
+// its layer. Its light projection is squeezed into that corner
+// (ShadowCascadeViewport), so the shaders sample it through the matrix
+// alone and the rasterised area drops with the square of the scale. The
+// array keeps the full resolution; the saving is fill, not memory.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	constexpr uint32_t SHADOW_CASCADE_MIN_TEXELS = 256;   // no cascade gets fewer per side
+	constexpr uint32_t SHADOW_CASCADE_TEXEL_ALIGN = 16;   // cascade sizes are multiples of this
+
+	// Texels per side cascade `scale` gets of a layerResolution layer
+	inline uint32_t ShadowCascadeTexels(uint32_t layerResolution, float scale)
+	{
+		const float wanted = static_cast<float>(layerResolution) * std::clamp(scale, 0.0f, 1.0f);
+		uint32_t texels = static_cast<uint32_t>(std::lround(wanted / SHADOW_CASCADE_TEXEL_ALIGN)) * SHADOW_CASCADE_TEXEL_ALIGN;
+		texels = std::max(texels, SHADOW_CASCADE_MIN_TEXELS);
+		return std::min(texels, layerResolution);
+	}
+
+	// Clip-space transform that squeezes a projection covering the whole layer
+	// into its top-left texels x texels (Vulkan: NDC -1 is the top row):
+	//   ndc' = ndc * s + (s - 1),  s = texels / layerResolution
+	// 0 texels (not fitted yet) leaves the whole layer.
+	inline glm::mat4 ShadowCascadeViewport(uint32_t texels, uint32_t layerResolution)
+	{
+		glm::mat4 viewport(1.0f);
+		if (texels == 0 || texels >= layerResolution)
+			return viewport;
+
+		const float s = static_cast<float>(texels) / static_cast<float>(layerResolution);
+		viewport[0][0] = s;
+		viewport[1][1] = s;
+		viewport[3][0] = s - 1.0f;
+		viewport[3][1] = s - 1.0f;
+		return viewport;
+	}
+}
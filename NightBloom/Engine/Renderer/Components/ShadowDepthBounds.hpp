@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// ShadowDepthBounds.hpp
+//
+// The view-depth range the shadow cascades are split over, tightened to the
+// geometry the camera actually sees (sample distribution shadow maps). The
+// Hi-Z pass reduces the scene depth to its nearest and farthest non-sky
+// depth (OcclusionCuller::DispatchDepthRange); the CPU reads that back once
+// the frame slot's fence has signalled, so the range is MAX_FRAMES_IN_FLIGHT
+// frames old. UpdateShadowMatrices then runs the PSSM splits over
+// [near, far] instead of [camera near, shadowDistance].
+//
+// To absorb the lag the measured range is padded, and each bound snaps to a
+// geometric grid (STEPS_PER_OCTAVE steps per doubling of distance). A bound
+// that must grow moves at once - geometry outside it would lose its shadow -
+// while one that could tighten waits until it has moved SHRINK_STEPS steps,
+// so small depth changes don't refit every cascade every frame.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	constexpr float SHADOW_DEPTH_BOUNDS_PADDING = 0.1f;           // fraction the measured range widens by each way
+	constexpr float SHADOW_DEPTH_BOUNDS_STEPS_PER_OCTAVE = 8.0f;  // grid the bounds snap to
+	constexpr int   SHADOW_DEPTH_BOUNDS_SHRINK_STEPS = 2;         // steps a bound must be able to tighten by before it does
+
+	// View distance of a depth from the infinite reverse-Z projection
+	// (Camera.cpp): depth = near / distance. Depth 0 (sky) is infinitely far.
+	inline float ShadowDepthToViewDistance(float depth, float cameraNear)
+	{
+		return depth > 0.0f ? cameraNear / depth : INFINITY;
+	}
+
+	class ShadowDepthBounds
+	{
+	public:
+		// Forget the range (the reduction stopped running); Resolve falls
+		// back to the full range until the next Update
+		void Reset() { m_Valid = false; }
+		bool IsValid() const { return m_Valid; }
+
+		// One reduction's result: the nearest and farthest reverse-Z depth of
+		// anything but sky. A nearest depth of 0 means only sky was drawn;
+		// the bounds then stay as they were.
+		void Update(float nearestDepth, float farthestDepth, float cameraNear)
+		{
+			if (nearestDepth <= 0.0f || farthestDepth <= 0.0f || cameraNear <= 0.0f)
+				return;
+
+			const float nearest = ShadowDepthToViewDistance(std::max(nearestDepth, farthestDepth), cameraNear);
+			const float farthest = ShadowDepthToViewDistance(std::min(nearestDepth, farthestDepth), cameraNear);
+			const int nearStep = Step(nearest / (1.0f + SHADOW_DEPTH_BOUNDS_PADDING), false);
+			const int farStep = Step(farthest * (1.0f + SHADOW_DEPTH_BOUNDS_PADDING), true);
+
+			if (!m_Valid)
+			{
+				m_NearStep = nearStep;
+				m_FarStep = farStep;
+				m_Valid = true;
+				return;
+			}
+			if (nearStep < m_NearStep || nearStep >= m_NearStep + SHADOW_DEPTH_BOUNDS_SHRINK_STEPS)
+				m_NearStep = nearStep;
+			if (farStep > m_FarStep || farStep <= m_FarStep - SHADOW_DEPTH_BOUNDS_SHRINK_STEPS)
+				m_FarStep = farStep;
+		}
+
+		// The range to split the cascades over, inside [cameraNear,
+		// shadowDistance]. Without a range, or when the visible geometry lies
+		// entirely past shadowDistance, that is the whole of it.
+		void Resolve(float cameraNear, float shadowDistance, float& outNear, float& outFar) const
+		{
+			outNear = cameraNear;
+			outFar = shadowDistance;
+			if (!m_Valid)
+				return;
+
+			const float farBound = std::min(Distance(m_FarStep), shadowDistance);
+			const float nearBound = std::max(Distance(m_NearStep), cameraNear);
+			if (farBound <= nearBound)
+				return;
+			outNear = nearBound;
+			outFar = farBound;
+		}
+
+		// Snapped bounds as stored, for diagnostics (0 when invalid)
+		float GetNear() const { return m_Valid ? Distance(m_NearStep) : 0.0f; }
+		float GetFar() const { return m_Valid ? Distance(m_FarStep) : 0.0f; }
+
+	private:
+		static int Step(float distance, bool roundUp)
+		{
+			const float steps = std::log2(std::max(distance, 1.0e-4f)) * SHADOW_DEPTH_BOUNDS_STEPS_PER_OCTAVE;
+			return static_cast<int>(roundUp ? std::ceil(steps) : std::floor(steps));
+		}
+
+		static float Distance(int step)
+		{
+			return std::exp2(static_cast<float>(step) / SHADOW_DEPTH_BOUNDS_STEPS_PER_OCTAVE);
+		}
+
+		int  m_NearStep = 0;
+		int  m_FarStep = 0;
+		bool m_Valid = false;
+	};
+}
@@ -6,9 +6,11 @@
 
 #include "Engine/Renderer/Components/ShadowMapManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include <initializer_list>
 
 namespace Nightbloom
 {
@@ -45,6 +47,13 @@ namespace Nightbloom
 			return false;
 		}
 
+		if (!CreateStaticCache())
+		{
+			LOG_ERROR("Failed to create static shadow cache");
+			DestroyResources();
+			return false;
+		}
+
 		// Create shadow sampler
 		if (!CreateShadowSampler())
 		{
@@ -107,6 +116,11 @@ namespace Nightbloom
 
 		// Keep render pass (format hasn't changed)
 		// Destroy per-cascade framebuffers, all views, and the texture
+		if (m_LayeredShadowFramebuffer != VK_NULL_HANDLE)
+		{
+			vkDestroyFramebuffer(device, m_LayeredShadowFramebuffer, nullptr);
+			m_LayeredShadowFramebuffer = VK_NULL_HANDLE;
+		}
 		for (uint32_t i = 0; i < NUM_CASCADES; ++i)
 		{
 			if (m_ShadowFramebuffers[i] != VK_NULL_HANDLE)
@@ -135,6 +149,8 @@ namespace Nightbloom
 			m_ShadowMapImage = VK_NULL_HANDLE;
 		}
 
+		DestroyStaticCache();
+
 		// Recreate texture and framebuffer
 		if (!CreateShadowMapTexture())
 		{
@@ -148,6 +164,12 @@ namespace Nightbloom
 			return false;
 		}
 
+		if (!CreateStaticCache())
+		{
+			LOG_ERROR("Failed to recreate static shadow cache");
+			return false;
+		}
+
 		// Update descriptor sets with new image view (array view, all cascades)
 		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
@@ -182,9 +204,12 @@ namespace Nightbloom
 		imageInfo.arrayLayers = NUM_CASCADES;  // one layer per cascade
 		imageInfo.format = m_Config.depthFormat;
 		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-		imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT;  // static-cache restore
 		imageInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.category = GpuMemoryCategory::Shadow;
+		imageInfo.debugName = "ShadowCascades";
 
 		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
 		if (!allocation)
@@ -197,8 +222,8 @@ namespace Nightbloom
 		m_ShadowMapImage = allocation->image;
 
 		// Array view used for sampling (sampler2DArrayShadow, set 3), spanning all cascades.
-		// All NUM_CASCADES layers are rendered every frame (RecordShadowPass loops over
-		// cascades), so every layer is in SHADER_READ_ONLY_OPTIMAL when sampled.
+		// Every layer goes through a shadow pass each frame (full, or static restore + dynamic
+		// casters — see RecordShadowPass), so every layer is in SHADER_READ_ONLY_OPTIMAL when sampled.
 		VkImageViewCreateInfo arrayViewInfo{};
 		arrayViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		arrayViewInfo.image = m_ShadowMapImage;
@@ -244,30 +269,7 @@ namespace Nightbloom
 
 	bool Nightbloom::ShadowMapManager::CreateShadowRenderPass()
 	{
-		// Depth-only attachment
-		VkAttachmentDescription depthAttachment{};
-		depthAttachment.format = m_Config.depthFormat;
-		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;  // We need to sample it later!
-		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;  // Ready for sampling
-
-		VkAttachmentReference depthAttachmentRef{};
-		depthAttachmentRef.attachment = 0;
-		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		// Subpass - depth only, no color attachments
-		VkSubpassDescription subpass{};
-		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpass.colorAttachmentCount = 0;
-		subpass.pColorAttachments = nullptr;
-		subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-		// Dependencies for layout transitions
-		std::array<VkSubpassDependency, 2> dependencies{};
+		VkSubpassDependency dependencies[2]{};
 
 		// Transition from whatever to depth write
 		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
@@ -287,23 +289,95 @@ namespace Nightbloom
 		dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 		dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
+		if (!CreateDepthRenderPass(VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, dependencies, m_ShadowRenderPass))
+		{
+			LOG_ERROR("Failed to create shadow render pass");
+			return false;
+		}
+
+		// Load variant: the layer was just filled by the static-cache copy
+		VkSubpassDependency loadDependencies[2] = { dependencies[0], dependencies[1] };
+		loadDependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		loadDependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		loadDependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		loadDependencies[0].dependencyFlags = 0;
+
+		if (!CreateDepthRenderPass(VK_ATTACHMENT_LOAD_OP_LOAD, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, loadDependencies, m_ShadowLoadRenderPass))
+		{
+			LOG_ERROR("Failed to create shadow load render pass");
+			return false;
+		}
+
+		// Static cache pass: ends ready to be copied from
+		VkSubpassDependency cacheDependencies[2] = { dependencies[0], dependencies[1] };
+		cacheDependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		cacheDependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		cacheDependencies[0].dependencyFlags = 0;
+		cacheDependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		cacheDependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		cacheDependencies[1].dependencyFlags = 0;
+
+		if (!CreateDepthRenderPass(VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, cacheDependencies, m_StaticCacheRenderPass))
+		{
+			LOG_ERROR("Failed to create static shadow cache render pass");
+			return false;
+		}
+
+		// Static cache load variant (layered path): keeps the layers that aren't redrawn
+		VkSubpassDependency cacheLoadDependencies[2] = { cacheDependencies[0], cacheDependencies[1] };
+		cacheLoadDependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		if (!CreateDepthRenderPass(VK_ATTACHMENT_LOAD_OP_LOAD, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, cacheLoadDependencies, m_StaticCacheLoadRenderPass))
+		{
+			LOG_ERROR("Failed to create static shadow cache load render pass");
+			return false;
+		}
+
+		LOG_INFO("Shadow render passes created");
+		return true;
+	}
+
+	bool Nightbloom::ShadowMapManager::CreateDepthRenderPass(VkAttachmentLoadOp loadOp, VkImageLayout initialLayout,
+		VkImageLayout finalLayout, const VkSubpassDependency (&dependencies)[2], VkRenderPass& outPass)
+	{
+		// Depth-only attachment
+		VkAttachmentDescription depthAttachment{};
+		depthAttachment.format = m_Config.depthFormat;
+		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		depthAttachment.loadOp = loadOp;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;  // We need to sample it later!
+		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.initialLayout = initialLayout;
+		depthAttachment.finalLayout = finalLayout;
+
+		VkAttachmentReference depthAttachmentRef{};
+		depthAttachmentRef.attachment = 0;
+		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		// Subpass - depth only, no color attachments
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 0;
+		subpass.pColorAttachments = nullptr;
+		subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
 		VkRenderPassCreateInfo renderPassInfo{};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 		renderPassInfo.attachmentCount = 1;
 		renderPassInfo.pAttachments = &depthAttachment;
 		renderPassInfo.subpassCount = 1;
 		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
-		renderPassInfo.pDependencies = dependencies.data();
-
-		if (vkCreateRenderPass(m_Device->GetDevice(), &renderPassInfo, nullptr, &m_ShadowRenderPass) != VK_SUCCESS)
-		{
-			LOG_ERROR("Failed to create shadow render pass");
-			return false;
-		}
+		renderPassInfo.dependencyCount = 2;
+		renderPassInfo.pDependencies = dependencies;
 
-		LOG_INFO("Shadow render pass created");
-		return true;
+		return vkCreateRenderPass(m_Device->GetDevice(), &renderPassInfo, nullptr, &outPass) == VK_SUCCESS;
 	}
 
 	bool Nightbloom::ShadowMapManager::CreateShadowFramebuffer()
@@ -327,10 +401,239 @@ namespace Nightbloom
 			}
 		}
 
+		// Layered framebuffer over the sampling array view, for the single-pass path
+		VkFramebufferCreateInfo layeredInfo{};
+		layeredInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		layeredInfo.renderPass = m_ShadowLoadRenderPass;
+		layeredInfo.attachmentCount = 1;
+		layeredInfo.pAttachments = &m_ShadowMapArrayView;
+		layeredInfo.width = m_Config.resolution;
+		layeredInfo.height = m_Config.resolution;
+		layeredInfo.layers = NUM_CASCADES;
+
+		if (vkCreateFramebuffer(m_Device->GetDevice(), &layeredInfo, nullptr, &m_LayeredShadowFramebuffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create layered shadow framebuffer");
+			return false;
+		}
+
 		LOG_INFO("Shadow framebuffers created: {} x {}x{}", NUM_CASCADES, m_Config.resolution, m_Config.resolution);
 		return true;
 	}
 
+	bool Nightbloom::ShadowMapManager::CreateStaticCache()
+	{
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = m_Config.resolution;
+		imageInfo.height = m_Config.resolution;
+		imageInfo.depth = 1;
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = NUM_CASCADES;
+		imageInfo.format = m_Config.depthFormat;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.category = GpuMemoryCategory::Shadow;
+		imageInfo.debugName = "ShadowStaticCache";
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("Failed to create static shadow cache image");
+			return false;
+		}
+
+		m_StaticCacheAllocation = allocation;
+		m_StaticCacheImage = allocation->image;
+
+		for (uint32_t i = 0; i < NUM_CASCADES; ++i)
+		{
+			VkImageViewCreateInfo layerViewInfo{};
+			layerViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			layerViewInfo.image = m_StaticCacheImage;
+			layerViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			layerViewInfo.format = m_Config.depthFormat;
+			layerViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+			layerViewInfo.subresourceRange.baseMipLevel = 0;
+			layerViewInfo.subresourceRange.levelCount = 1;
+			layerViewInfo.subresourceRange.baseArrayLayer = i;
+			layerViewInfo.subresourceRange.layerCount = 1;
+
+			if (vkCreateImageView(m_Device->GetDevice(), &layerViewInfo, nullptr, &m_StaticCacheLayerViews[i]) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to create static shadow cache view {}", i);
+				return false;
+			}
+
+			VkFramebufferCreateInfo framebufferInfo{};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = m_StaticCacheRenderPass;
+			framebufferInfo.attachmentCount = 1;
+			framebufferInfo.pAttachments = &m_StaticCacheLayerViews[i];
+			framebufferInfo.width = m_Config.resolution;
+			framebufferInfo.height = m_Config.resolution;
+			framebufferInfo.layers = 1;
+
+			if (vkCreateFramebuffer(m_Device->GetDevice(), &framebufferInfo, nullptr, &m_StaticCacheFramebuffers[i]) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to create static shadow cache framebuffer {}", i);
+				return false;
+			}
+		}
+
+		VkImageViewCreateInfo arrayViewInfo{};
+		arrayViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		arrayViewInfo.image = m_StaticCacheImage;
+		arrayViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+		arrayViewInfo.format = m_Config.depthFormat;
+		arrayViewInfo.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, NUM_CASCADES };
+
+		if (vkCreateImageView(m_Device->GetDevice(), &arrayViewInfo, nullptr, &m_StaticCacheArrayView) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create static shadow cache array view");
+			return false;
+		}
+
+		VkFramebufferCreateInfo layeredInfo{};
+		layeredInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		layeredInfo.renderPass = m_StaticCacheLoadRenderPass;
+		layeredInfo.attachmentCount = 1;
+		layeredInfo.pAttachments = &m_StaticCacheArrayView;
+		layeredInfo.width = m_Config.resolution;
+		layeredInfo.height = m_Config.resolution;
+		layeredInfo.layers = NUM_CASCADES;
+
+		if (vkCreateFramebuffer(m_Device->GetDevice(), &layeredInfo, nullptr, &m_LayeredStaticCacheFramebuffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create layered static shadow cache framebuffer");
+			return false;
+		}
+
+		LOG_INFO("Static shadow cache created: {}x{} x{} layers",
+			m_Config.resolution, m_Config.resolution, NUM_CASCADES);
+		return true;
+	}
+
+	void ShadowMapManager::DestroyStaticCache()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		for (uint32_t i = 0; i < NUM_CASCADES; ++i)
+		{
+			if (m_StaticCacheFramebuffers[i] != VK_NULL_HANDLE)
+			{
+				vkDestroyFramebuffer(device, m_StaticCacheFramebuffers[i], nullptr);
+				m_StaticCacheFramebuffers[i] = VK_NULL_HANDLE;
+			}
+			if (m_StaticCacheLayerViews[i] != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(device, m_StaticCacheLayerViews[i], nullptr);
+				m_StaticCacheLayerViews[i] = VK_NULL_HANDLE;
+			}
+		}
+
+		if (m_LayeredStaticCacheFramebuffer != VK_NULL_HANDLE)
+		{
+			vkDestroyFramebuffer(device, m_LayeredStaticCacheFramebuffer, nullptr);
+			m_LayeredStaticCacheFramebuffer = VK_NULL_HANDLE;
+		}
+		if (m_StaticCacheArrayView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, m_StaticCacheArrayView, nullptr);
+			m_StaticCacheArrayView = VK_NULL_HANDLE;
+		}
+
+		if (m_StaticCacheAllocation && m_MemoryManager)
+		{
+			m_MemoryManager->DestroyImage(
+				static_cast<VulkanMemoryManager::ImageAllocation*>(m_StaticCacheAllocation));
+			m_StaticCacheAllocation = nullptr;
+			m_StaticCacheImage = VK_NULL_HANDLE;
+		}
+	}
+
+	void ShadowMapManager::RecordRestoreStaticCascade(VkCommandBuffer cmd, uint32_t cascade) const
+	{
+		// Shadow layer: previous contents are fully overwritten, so UNDEFINED is fine and
+		// covers the first frame. Static layer: make the static pass's depth writes (this
+		// frame or an earlier one) visible to the copy.
+		VkImageMemoryBarrier barriers[2]{};
+		barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barriers[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[0].image = m_ShadowMapImage;
+		barriers[0].subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, cascade, 1 };
+
+		barriers[1] = barriers[0];
+		barriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barriers[1].image = m_StaticCacheImage;
+
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 2, barriers);
+
+		VkImageCopy region{};
+		region.srcSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, cascade, 1 };
+		region.dstSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, cascade, 1 };
+		region.extent = { m_Config.resolution, m_Config.resolution, 1 };
+
+		vkCmdCopyImage(cmd,
+			m_StaticCacheImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			m_ShadowMapImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			1, &region);
+		// GetShadowLoadRenderPass() picks the layer up from TRANSFER_DST
+	}
+
+	void ShadowMapManager::RecordDiscardShadowLayers(VkCommandBuffer cmd, uint32_t layerMask) const
+	{
+		RecordDiscardLayers(cmd, m_ShadowMapImage, layerMask, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	}
+
+	void ShadowMapManager::RecordDiscardStaticCacheLayers(VkCommandBuffer cmd, uint32_t layerMask) const
+	{
+		RecordDiscardLayers(cmd, m_StaticCacheImage, layerMask, VK_ACCESS_TRANSFER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+	}
+
+	void ShadowMapManager::RecordDiscardLayers(VkCommandBuffer cmd, VkImage image, uint32_t layerMask,
+		VkAccessFlags srcAccess, VkPipelineStageFlags srcStage, VkImageLayout newLayout) const
+	{
+		VkImageMemoryBarrier barriers[NUM_CASCADES]{};
+		uint32_t count = 0;
+		for (uint32_t layer = 0; layer < NUM_CASCADES; ++layer)
+		{
+			if ((layerMask & (1u << layer)) == 0)
+				continue;
+
+			VkImageMemoryBarrier& barrier = barriers[count++];
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = srcAccess;
+			barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;  // contents are about to be cleared
+			barrier.newLayout = newLayout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, layer, 1 };
+		}
+
+		if (count == 0)
+			return;
+
+		vkCmdPipelineBarrier(cmd, srcStage, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+			0, 0, nullptr, 0, nullptr, count, barriers);
+	}
+
 	bool Nightbloom::ShadowMapManager::CreateShadowSampler()
 	{
 		VkSamplerCreateInfo samplerInfo{};
@@ -361,7 +664,8 @@ namespace Nightbloom
 			samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 		}
 
-		if (vkCreateSampler(m_Device->GetDevice(), &samplerInfo, nullptr, &m_ShadowSampler) != VK_SUCCESS)
+		m_ShadowSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_ShadowSampler == VK_NULL_HANDLE)
 		{
 			LOG_ERROR("Failed to create shadow sampler");
 			return false;
@@ -426,11 +730,7 @@ namespace Nightbloom
 
 		// Descriptor sets are freed when pool is destroyed, no need to free individually
 
-		if (m_ShadowSampler != VK_NULL_HANDLE)
-		{
-			vkDestroySampler(device, m_ShadowSampler, nullptr);
-			m_ShadowSampler = VK_NULL_HANDLE;
-		}
+		m_ShadowSampler = VK_NULL_HANDLE;  // owned by the sampler cache
 
 		for (uint32_t i = 0; i < NUM_CASCADES; ++i)
 		{
@@ -446,10 +746,22 @@ namespace Nightbloom
 			}
 		}
 
-		if (m_ShadowRenderPass != VK_NULL_HANDLE)
+		DestroyStaticCache();
+
+		if (m_LayeredShadowFramebuffer != VK_NULL_HANDLE)
 		{
-			vkDestroyRenderPass(device, m_ShadowRenderPass, nullptr);
-			m_ShadowRenderPass = VK_NULL_HANDLE;
+			vkDestroyFramebuffer(device, m_LayeredShadowFramebuffer, nullptr);
+			m_LayeredShadowFramebuffer = VK_NULL_HANDLE;
+		}
+
+		for (VkRenderPass* pass : { &m_ShadowRenderPass, &m_ShadowLoadRenderPass,
+			&m_StaticCacheRenderPass, &m_StaticCacheLoadRenderPass })
+		{
+			if (*pass != VK_NULL_HANDLE)
+			{
+				vkDestroyRenderPass(device, *pass, nullptr);
+				*pass = VK_NULL_HANDLE;
+			}
 		}
 
 		if (m_ShadowMapArrayView != VK_NULL_HANDLE)
@@ -6,6 +6,8 @@
 // - Shadow render pass
 // - Shadow framebuffer
 // - Shadow sampler with comparison
+// - Static-caster cache: a second depth array holding terrain-only depth per
+//   cascade, copied into the shadow map before dynamic casters are drawn on top
 //------------------------------------------------------------------------------
 #pragma once
 
@@ -13,6 +15,7 @@
 #include <glm/glm.hpp>
 #include <cstdint>
 #include "Engine/Renderer/Light.hpp"  // canonical NUM_CASCADES
+#include "Engine/Renderer/FrameConfig.hpp"  // canonical MAX_FRAMES_IN_FLIGHT
 
 namespace Nightbloom
 {
@@ -55,6 +58,26 @@ namespace Nightbloom
 		VkFramebuffer GetShadowFramebuffer(uint32_t cascade = 0) const { return m_ShadowFramebuffers[cascade]; }
 		VkExtent2D GetShadowExtent() const { return { m_Config.resolution, m_Config.resolution }; }
 
+		// Static cache: the static pass clears and renders into a cache layer (left in
+		// TRANSFER_SRC); RecordRestoreStaticCascade copies it into the shadow layer, and
+		// the load pass then draws dynamic casters over it. The load pass is compatible
+		// with GetShadowFramebuffer().
+		VkRenderPass GetStaticCacheRenderPass() const { return m_StaticCacheRenderPass; }
+		VkFramebuffer GetStaticCacheFramebuffer(uint32_t cascade) const { return m_StaticCacheFramebuffers[cascade]; }
+		VkRenderPass GetShadowLoadRenderPass() const { return m_ShadowLoadRenderPass; }
+		void RecordRestoreStaticCascade(VkCommandBuffer cmd, uint32_t cascade) const;
+
+		// Layered (single-pass) rendering: framebuffers spanning every layer, used with
+		// the load passes (GetShadowLoadRenderPass / GetStaticCacheLoadRenderPass). Mixed
+		// per-layer layouts aren't allowed in one attachment, so layers that hold nothing
+		// worth keeping are first discarded into the pass's initial layout; the caller
+		// then clears them inside the pass (vkCmdClearAttachments).
+		VkFramebuffer GetLayeredShadowFramebuffer() const { return m_LayeredShadowFramebuffer; }
+		VkFramebuffer GetLayeredStaticCacheFramebuffer() const { return m_LayeredStaticCacheFramebuffer; }
+		VkRenderPass GetStaticCacheLoadRenderPass() const { return m_StaticCacheLoadRenderPass; }
+		void RecordDiscardShadowLayers(VkCommandBuffer cmd, uint32_t layerMask) const;       // -> TRANSFER_DST
+		void RecordDiscardStaticCacheLayers(VkCommandBuffer cmd, uint32_t layerMask) const;  // -> TRANSFER_SRC
+
 		VkImage GetShadowMapImage() const { return m_ShadowMapImage; }
 		// Sampling view spanning all cascade layers (sampler2DArrayShadow). Bound to set 3.
 		VkImageView GetShadowMapView() const { return m_ShadowMapArrayView; }
@@ -75,7 +98,13 @@ namespace Nightbloom
 	private:
 		bool CreateShadowMapTexture();
 		bool CreateShadowRenderPass();
+		bool CreateDepthRenderPass(VkAttachmentLoadOp loadOp, VkImageLayout initialLayout,
+			VkImageLayout finalLayout, const VkSubpassDependency (&dependencies)[2], VkRenderPass& outPass);
 		bool CreateShadowFramebuffer();
+		bool CreateStaticCache();
+		void DestroyStaticCache();
+		void RecordDiscardLayers(VkCommandBuffer cmd, VkImage image, uint32_t layerMask,
+			VkAccessFlags srcAccess, VkPipelineStageFlags srcStage, VkImageLayout newLayout) const;
 		bool CreateShadowSampler();
 		bool CreateDescriptorSets();
 
@@ -97,12 +126,25 @@ namespace Nightbloom
 		// Shadow render pass and per-cascade framebuffers
 		VkRenderPass m_ShadowRenderPass = VK_NULL_HANDLE;
 		VkFramebuffer m_ShadowFramebuffers[NUM_CASCADES] = {};
+		VkRenderPass m_ShadowLoadRenderPass = VK_NULL_HANDLE;    // LOAD variant over a restored static layer
+
+		// Static-caster cache (same size/format as the shadow map)
+		VkImage m_StaticCacheImage = VK_NULL_HANDLE;
+		void* m_StaticCacheAllocation = nullptr;
+		VkImageView m_StaticCacheLayerViews[NUM_CASCADES] = {};
+		VkFramebuffer m_StaticCacheFramebuffers[NUM_CASCADES] = {};
+		VkRenderPass m_StaticCacheRenderPass = VK_NULL_HANDLE;
+		VkRenderPass m_StaticCacheLoadRenderPass = VK_NULL_HANDLE;  // LOAD, TRANSFER_SRC in and out
+
+		// Layered framebuffers (all NUM_CASCADES layers)
+		VkImageView m_StaticCacheArrayView = VK_NULL_HANDLE;
+		VkFramebuffer m_LayeredShadowFramebuffer = VK_NULL_HANDLE;
+		VkFramebuffer m_LayeredStaticCacheFramebuffer = VK_NULL_HANDLE;
 
 		// Shadow sampler (with depth comparison for PCF)
 		VkSampler m_ShadowSampler = VK_NULL_HANDLE;
 
 		// Descriptor sets for shadow map sampling (one per frame in flight)
-		static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 		VkDescriptorSet m_ShadowDescriptorSets[MAX_FRAMES_IN_FLIGHT] = {};
 
 		// Prevent copying
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+// SignatureHash.hpp
+//
+// FNV-1a over the values some recorded work depends on. Two recordings that
+// would come out the same mix the same values in the same order, so a cache
+// compares the 64-bit result instead of the inputs (the static shadow cache,
+// the point light atlas, CommandRecorder's cached secondaries). Mix fields,
+// not whole structs: the padding in a struct is not guaranteed to be
+// deterministic.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Nightbloom
+{
+	class SignatureHash
+	{
+	public:
+		static constexpr uint64_t OFFSET_BASIS = 1469598103934665603ull;
+		static constexpr uint64_t PRIME = 1099511628211ull;
+
+		SignatureHash() = default;
+		explicit SignatureHash(uint64_t seed) : m_Hash(seed) {}
+
+		void MixBytes(const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				m_Hash ^= bytes[i];
+				m_Hash *= PRIME;
+			}
+		}
+
+		template<typename T>
+		void Mix(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "mix the fields of non-trivial types");
+			MixBytes(&value, sizeof(T));
+		}
+
+		uint64_t Get() const { return m_Hash; }
+
+	private:
+		uint64_t m_Hash = OFFSET_BASIS;
+	};
+}
@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+// SkinningSystem.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/SkinningSystem.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMeshArena.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/Vertex.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Matches SkinJob in Skinning.comp: sourceFirst, vertexCount,
+		// firstJoint, outputFirst
+		using SkinJob = glm::uvec4;
+
+		constexpr VkDeviceSize JOB_BUFFER_SIZE = sizeof(SkinJob) * SkinningSystem::MAX_SKIN_JOBS;
+		constexpr VkDeviceSize JOINT_BUFFER_SIZE = sizeof(glm::mat4) * SkinningSystem::MAX_SKIN_JOINTS;
+		constexpr VkDeviceSize OUTPUT_BUFFER_SIZE = sizeof(VertexPNT) * SkinningSystem::MAX_SKINNED_VERTICES;
+	}
+
+	bool SkinningSystem::Initialize(VulkanDevice* device, ResourceManager* resources,
+		VulkanDescriptorManager* descriptorManager, VulkanMeshArena* meshArena)
+	{
+		m_Device = device;
+		m_Resources = resources;
+		m_DescriptorManager = descriptorManager;
+		m_MeshArena = meshArena;
+		if (!m_MeshArena)
+			return false;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			// Jobs and joints are rewritten every frame
+			const std::string suffix = std::to_string(i);
+			m_JobBuffers[i] = m_Resources->CreateStorageBuffer("SkinJobs_" + suffix, JOB_BUFFER_SIZE, true, true);
+			m_JointBuffers[i] = m_Resources->CreateStorageBuffer("SkinJoints_" + suffix, JOINT_BUFFER_SIZE, true, true);
+			m_OutputBuffers[i] = m_Resources->CreateComputeVertexBuffer("SkinnedVertices_" + suffix, OUTPUT_BUFFER_SIZE);
+			if (!m_JobBuffers[i] || !m_JointBuffers[i] || !m_OutputBuffers[i])
+			{
+				LOG_ERROR("SkinningSystem: failed to create job/joint/output buffers");
+				return false;
+			}
+
+			// The vertex set's source binding is filled in once a skinned
+			// model has loaded (WriteJobs)
+			m_JobSets[i] = m_DescriptorManager->AllocateComputeStorageSet();
+			m_VertexSets[i] = m_DescriptorManager->AllocateComputeStorageSet();
+			if (m_JobSets[i] == VK_NULL_HANDLE || m_VertexSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("SkinningSystem: failed to allocate descriptor sets");
+				return false;
+			}
+			m_DescriptorManager->UpdateComputeStorageSet(m_JobSets[i],
+				m_JobBuffers[i]->GetBuffer(), JOB_BUFFER_SIZE,
+				m_JointBuffers[i]->GetBuffer(), JOINT_BUFFER_SIZE);
+		}
+
+		if (!CreatePipeline())
+			return false;
+
+		LOG_INFO("SkinningSystem initialized ({} vertices, {} joints per frame)", MAX_SKINNED_VERTICES, MAX_SKIN_JOINTS);
+		return true;
+	}
+
+	void SkinningSystem::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (m_Resources)
+			{
+				const std::string suffix = std::to_string(i);
+				if (m_JobBuffers[i])
+					m_Resources->DestroyBuffer("SkinJobs_" + suffix);
+				if (m_JointBuffers[i])
+					m_Resources->DestroyBuffer("SkinJoints_" + suffix);
+				if (m_OutputBuffers[i])
+					m_Resources->DestroyBuffer("SkinnedVertices_" + suffix);
+			}
+			m_JobBuffers[i] = nullptr;
+			m_JointBuffers[i] = nullptr;
+			m_OutputBuffers[i] = nullptr;
+			m_BoundSkinBuffers[i] = VK_NULL_HANDLE;
+			m_JobCounts[i] = 0;
+		}
+		m_Outputs.clear();
+
+		m_Device = nullptr;
+	}
+
+	bool SkinningSystem::CreatePipeline()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkDescriptorSetLayout setLayouts[2] = {
+			m_DescriptorManager->GetComputeStorageSetLayout(),
+			m_DescriptorManager->GetComputeStorageSetLayout()
+		};
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 2;
+		layoutInfo.pSetLayouts = setLayouts;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("SkinningSystem: failed to create pipeline layout");
+			return false;
+		}
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary("Skinning.comp.spv");
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("SkinningSystem: failed to load Skinning.comp.spv");
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("SkinningSystem: failed to create shader module");
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("SkinningSystem: failed to create compute pipeline");
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, "Skinning.comp.spv");
+		return true;
+	}
+
+	uint32_t SkinningSystem::WriteJobs(uint32_t frameIndex, DrawList& drawList)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		m_JobCounts[frame] = 0;
+		m_LastJobCount = 0;
+		m_LastVertexCount = 0;
+		m_Outputs.clear();
+
+		// Skinned draws left as they are keep the bind pose
+		Buffer* skinBuffer = m_MeshArena ? m_MeshArena->GetSkinBuffer() : nullptr;
+		const auto& joints = drawList.GetSkinJoints();
+		auto* jobs = m_JobBuffers[frame] ? static_cast<SkinJob*>(m_JobBuffers[frame]->GetPersistentMappedPtr()) : nullptr;
+		auto* jointData = m_JointBuffers[frame] ? m_JointBuffers[frame]->GetPersistentMappedPtr() : nullptr;
+		if (!m_Enabled || !skinBuffer || joints.empty() || !jobs || !jointData || m_Pipeline == VK_NULL_HANDLE)
+			return 0;
+
+		// The first skin page only appears with the first skinned model (and
+		// is recreated if an oversized one was released)
+		VulkanBuffer* vkSkin = static_cast<VulkanBuffer*>(skinBuffer);
+		if (m_BoundSkinBuffers[frame] != vkSkin->GetBuffer())
+		{
+			m_DescriptorManager->UpdateComputeStorageSet(m_VertexSets[frame],
+				vkSkin->GetBuffer(), vkSkin->GetSize(),
+				m_OutputBuffers[frame]->GetBuffer(), OUTPUT_BUFFER_SIZE);
+			m_BoundSkinBuffers[frame] = vkSkin->GetBuffer();
+		}
+
+		// Every drawable's matrices go up as one block; draws whose joints
+		// didn't fit stay in the bind pose
+		const uint32_t jointCount = static_cast<uint32_t>(std::min<size_t>(joints.size(), MAX_SKIN_JOINTS));
+		std::memcpy(jointData, joints.data(), sizeof(glm::mat4) * jointCount);
+
+		uint32_t count = 0;
+		uint32_t vertexCount = 0;
+		for (size_t i = 0; i < drawList.GetCommandCount(); ++i)
+		{
+			DrawCommand& cmd = drawList.GetCommandMutable(i);
+			if (cmd.skinJointCount == 0 || cmd.skinVertexCount == 0 || cmd.skinFirstJoint + cmd.skinJointCount > jointCount)
+				continue;
+
+			// Each LOD of one posed mesh, and any pass drawing it, reads the
+			// same skinned vertices
+			const uint64_t key = (static_cast<uint64_t>(cmd.skinFirstVertex) << 32) | cmd.skinFirstJoint;
+			auto [output, added] = m_Outputs.try_emplace(key, vertexCount);
+			if (added)
+			{
+				const uint32_t jobCount = (cmd.skinVertexCount + SKIN_GROUP_SIZE - 1) / SKIN_GROUP_SIZE;
+				if (vertexCount + cmd.skinVertexCount > MAX_SKINNED_VERTICES || count + jobCount > MAX_SKIN_JOBS)
+				{
+					m_Outputs.erase(output);
+					continue;
+				}
+
+				for (uint32_t j = 0; j < jobCount; ++j)
+				{
+					const uint32_t first = j * SKIN_GROUP_SIZE;
+					jobs[count++] = SkinJob(cmd.skinFirstVertex + first,
+						std::min(SKIN_GROUP_SIZE, cmd.skinVertexCount - first),
+						cmd.skinFirstJoint, vertexCount + first);
+				}
+				vertexCount += cmd.skinVertexCount;
+			}
+
+			cmd.vertexBuffer = m_OutputBuffers[frame];
+			cmd.vertexOffset = static_cast<int32_t>(output->second);
+		}
+
+		if (count > 0)
+		{
+			m_JobBuffers[frame]->Flush(0, sizeof(SkinJob) * count);
+			m_JointBuffers[frame]->Flush(0, sizeof(glm::mat4) * jointCount);
+		}
+
+		m_JobCounts[frame] = count;
+		m_LastJobCount = count;
+		m_LastVertexCount = vertexCount;
+		return count;
+	}
+
+	bool SkinningSystem::Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex)
+	{
+		const uint32_t frame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		const uint32_t count = m_JobCounts[frame];
+		if (count == 0 || !dispatcher || m_Pipeline == VK_NULL_HANDLE)
+			return false;
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, m_JobSets[frame]);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 1, m_VertexSets[frame]);
+
+		// One workgroup per job
+		dispatcher->Dispatch(cmd, count);
+		return true;
+	}
+
+	VkBuffer SkinningSystem::GetOutputBuffer(uint32_t frameIndex) const
+	{
+		VulkanBuffer* buffer = m_OutputBuffers[frameIndex % MAX_FRAMES_IN_FLIGHT];
+		return buffer ? buffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+}
@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+// SkinningSystem.hpp
+//
+// GPU skinning for animated models (Animation.hpp). WriteJobs collects the
+// frame's skinned draws (DrawCommand::skinJointCount > 0), uploads the skin
+// matrices their drawables posed, and splits every distinct mesh/pose pair
+// into 64-vertex jobs; Dispatch (Skinning.comp) skins each of those vertices
+// once into this frame's output buffer - full-precision VertexPNT, the
+// Standard vertex layout. WriteJobs points the draws' vertexBuffer and
+// vertexOffset at that output, so the main pass, every shadow cascade, the
+// reflection and the auxiliary views all draw the same skinned vertices
+// instead of each pass skinning them again in its vertex shader.
+//
+// Skinned draws this pass can't take (disabled, over a per-frame limit, or a
+// mesh whose skin is off the arena's first skin page) keep their bind-pose
+// vertices.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/FrameConfig.hpp"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanBuffer;
+	class VulkanDescriptorManager;
+	class VulkanMeshArena;
+	class ResourceManager;
+	class ComputeDispatcher;
+	class DrawList;
+
+	class SkinningSystem
+	{
+	public:
+		static constexpr uint32_t SKIN_GROUP_SIZE = 64;             // vertices per job, Skinning.comp's local size
+		static constexpr uint32_t MAX_SKINNED_VERTICES = 1u << 18;  // per frame, over all draws
+		static constexpr uint32_t MAX_SKIN_JOBS = 1u << 13;         // per frame
+		static constexpr uint32_t MAX_SKIN_JOINTS = 1u << 14;       // per frame, over all drawables
+
+		SkinningSystem() = default;
+		~SkinningSystem() = default;
+
+		bool Initialize(VulkanDevice* device, ResourceManager* resources, VulkanDescriptorManager* descriptorManager,
+			VulkanMeshArena* meshArena);
+		void Cleanup();
+
+		// CPU side, once the frame's draw list is final and before instance
+		// batching (rewritten draws no longer share a vertex range, so two
+		// poses of one mesh never merge). Returns the job count.
+		uint32_t WriteJobs(uint32_t frameIndex, DrawList& drawList);
+
+		// Compute pass, before every pass that draws. Returns true if it dispatched.
+		bool Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
+
+		VkBuffer GetOutputBuffer(uint32_t frameIndex) const;
+
+		void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		bool IsEnabled() const { return m_Enabled; }
+		uint32_t GetLastJobCount() const { return m_LastJobCount; }
+		uint32_t GetLastVertexCount() const { return m_LastVertexCount; }
+
+	private:
+		bool CreatePipeline();
+
+		VulkanDevice* m_Device = nullptr;
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+		VulkanMeshArena* m_MeshArena = nullptr;
+
+		// Set 0 = jobs/joints, set 1 = skin source/output
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_JobBuffers{};     // host-visible, owned by ResourceManager
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_JointBuffers{};   // host-visible skin matrices
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_OutputBuffers{};  // GPU-only skinned VertexPNT
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_JobSets{};
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_VertexSets{};
+		std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_BoundSkinBuffers{};  // what m_VertexSets points at
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_JobCounts{};
+
+		// (skinFirstVertex, skinFirstJoint) -> first output vertex, this frame
+		std::unordered_map<uint64_t, uint32_t> m_Outputs;
+
+		bool m_Enabled = true;
+		uint32_t m_LastJobCount = 0;
+		uint32_t m_LastVertexCount = 0;
+
+		SkinningSystem(const SkinningSystem&) = delete;
+		SkinningSystem& operator=(const SkinningSystem&) = delete;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,395 @@
+//------------------------------------------------------------------------------
+// TemporalUpscaler.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/TemporalUpscaler.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t RESOLVE_LOCAL_SIZE = 8;  // temporal_upscale.glsl
+		constexpr VkFormat HISTORY_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+		// Matches ResolveParams in temporal_upscale.glsl
+		struct ResolvePushConstants
+		{
+			glm::mat4 reprojection;  // current (unjittered) NDC + depth -> previous clip
+			glm::vec4 jitter;        // xy = sub-pixel jitter in render pixels
+			glm::ivec4 extents;      // xy = render extent, zw = output extent
+			glm::vec4 params;        // x = history valid
+		};
+		static_assert(sizeof(ResolvePushConstants) == 112, "Must match temporal_upscale.glsl");
+
+		float Halton(uint32_t index, uint32_t base)
+		{
+			float result = 0.0f;
+			float fraction = 1.0f;
+			while (index > 0)
+			{
+				fraction /= static_cast<float>(base);
+				result += fraction * static_cast<float>(index % base);
+				index /= base;
+			}
+			return result;
+		}
+	}
+
+	bool TemporalUpscaler::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, ResourceManager* resources,
+		VulkanDescriptorManager* descriptorManager, VkImageView colorView, VkImageView depthView,
+		VkSampleCountFlagBits depthSamples, VkExtent2D outputExtent)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_Resources = resources;
+		m_DescriptorManager = descriptorManager;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		m_PointSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_PointSampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("TemporalUpscaler: failed to create point sampler");
+			return false;
+		}
+
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		m_LinearSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_LinearSampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("TemporalUpscaler: failed to create linear sampler");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			m_ResolveSets[i] = m_DescriptorManager->AllocateTemporalResolveSet();
+			m_OutputSets[i] = m_DescriptorManager->AllocatePostProcessInputSet();
+			if (m_ResolveSets[i] == VK_NULL_HANDLE || m_OutputSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("TemporalUpscaler: failed to allocate descriptor sets");
+				return false;
+			}
+		}
+
+		if (!CreatePipeline(depthSamples))
+			return false;
+
+		if (!CreateHistory(colorView, depthView, outputExtent))
+			return false;
+
+		LOG_INFO("TemporalUpscaler initialized ({}x{} history)", m_OutputExtent.width, m_OutputExtent.height);
+		return true;
+	}
+
+	void TemporalUpscaler::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		DestroyHistory();
+
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		m_PointSampler = m_LinearSampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_HistoryValid = false;
+		m_Device = nullptr;
+	}
+
+	bool TemporalUpscaler::Resize(VkImageView colorView, VkImageView depthView, VkExtent2D outputExtent)
+	{
+		DestroyHistory();
+		return CreateHistory(colorView, depthView, outputExtent);
+	}
+
+	glm::vec2 TemporalUpscaler::GetJitter(uint64_t frameNumber)
+	{
+		// Halton(2, 3), skipping index 0 (which would be (0, 0) twice per cycle)
+		const uint32_t index = static_cast<uint32_t>(frameNumber % JITTER_PHASES) + 1;
+		return glm::vec2(Halton(index, 2) - 0.5f, Halton(index, 3) - 0.5f);
+	}
+
+	glm::mat4 TemporalUpscaler::GetJitterMatrix(glm::vec2 jitter, VkExtent2D renderExtent)
+	{
+		// Translate in NDC after the projection: independent of how the
+		// projection itself is built (reverse-Z, the Vulkan Y flip)
+		glm::mat4 translation(1.0f);
+		translation[3][0] = 2.0f * jitter.x / static_cast<float>(std::max(renderExtent.width, 1u));
+		translation[3][1] = 2.0f * jitter.y / static_cast<float>(std::max(renderExtent.height, 1u));
+		return translation;
+	}
+
+	void TemporalUpscaler::SetEnabled(bool enabled)
+	{
+		if (enabled && !m_Enabled)
+			m_HistoryValid = false;
+		m_Enabled = enabled;
+	}
+
+	bool TemporalUpscaler::CreateHistory(VkImageView colorView, VkImageView depthView, VkExtent2D outputExtent)
+	{
+		m_HistoryValid = false;
+		if (colorView == VK_NULL_HANDLE || depthView == VK_NULL_HANDLE || outputExtent.width == 0 || outputExtent.height == 0)
+			return false;
+
+		VkDevice device = m_Device->GetDevice();
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			VulkanMemoryManager::ImageCreateInfo imageInfo{};
+			imageInfo.width = outputExtent.width;
+			imageInfo.height = outputExtent.height;
+			imageInfo.format = HISTORY_FORMAT;
+			imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+			imageInfo.category = GpuMemoryCategory::RenderTarget;
+			imageInfo.debugName = "UpscalerHistory";
+
+			auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+			if (!allocation)
+			{
+				LOG_ERROR("TemporalUpscaler: failed to create {}x{} history", outputExtent.width, outputExtent.height);
+				return false;
+			}
+			m_HistoryAllocations[i] = allocation;
+			m_HistoryImages[i] = allocation->image;
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = m_HistoryImages[i];
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = HISTORY_FORMAT;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.layerCount = 1;
+			if (vkCreateImageView(device, &viewInfo, nullptr, &m_HistoryViews[i]) != VK_SUCCESS)
+			{
+				LOG_ERROR("TemporalUpscaler: failed to create history view");
+				return false;
+			}
+		}
+
+		// History lives in GENERAL: written as a storage image, sampled by
+		// the next resolve and by the post-process pass
+		{
+			VulkanSingleTimeCommand cmd(m_Device, m_Resources->GetTransferCommandPool());
+			VkCommandBuffer commandBuffer = cmd.Begin();
+
+			std::array<VkImageMemoryBarrier, 2> barriers{};
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				VkImageMemoryBarrier& barrier = barriers[i];
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+				barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = m_HistoryImages[i];
+				barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				barrier.subresourceRange.levelCount = 1;
+				barrier.subresourceRange.layerCount = 1;
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			}
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+			cmd.End();
+		}
+
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			VulkanDescriptorManager::TemporalResolveImages images;
+			images.colorView = colorView;
+			images.depthView = depthView;
+			images.historyView = m_HistoryViews[1 - i];
+			images.outputView = m_HistoryViews[i];
+			images.pointSampler = m_PointSampler;
+			images.linearSampler = m_LinearSampler;
+			m_DescriptorManager->UpdateTemporalResolveSet(m_ResolveSets[i], images);
+
+			m_DescriptorManager->UpdatePostProcessInputSet(m_OutputSets[i], m_HistoryViews[i], m_LinearSampler,
+				VK_IMAGE_LAYOUT_GENERAL);
+		}
+
+		m_OutputExtent = outputExtent;
+		m_Current = 0;
+		return true;
+	}
+
+	void TemporalUpscaler::DestroyHistory()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			if (m_HistoryViews[i] != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(device, m_HistoryViews[i], nullptr);
+				m_HistoryViews[i] = VK_NULL_HANDLE;
+			}
+			if (m_HistoryAllocations[i])
+			{
+				m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_HistoryAllocations[i]));
+				m_HistoryAllocations[i] = nullptr;
+			}
+			m_HistoryImages[i] = VK_NULL_HANDLE;
+		}
+		m_OutputExtent = { 0, 0 };
+		m_HistoryValid = false;
+	}
+
+	bool TemporalUpscaler::CreatePipeline(VkSampleCountFlagBits depthSamples)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(ResolvePushConstants);
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetTemporalResolveSetLayout();
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &setLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("TemporalUpscaler: failed to create pipeline layout");
+			return false;
+		}
+
+		const char* shaderName = (depthSamples != VK_SAMPLE_COUNT_1_BIT)
+			? "TemporalUpscaleMS.comp.spv" : "TemporalUpscale.comp.spv";
+		auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("TemporalUpscaler: failed to load {}", shaderName);
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("TemporalUpscaler: failed to create shader module for {}", shaderName);
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("TemporalUpscaler: failed to create compute pipeline for {}", shaderName);
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, shaderName);
+		return true;
+	}
+
+	void TemporalUpscaler::Resolve(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const glm::mat4& viewProj,
+		VkExtent2D renderExtent, glm::vec2 jitter)
+	{
+		if (!dispatcher || m_Pipeline == VK_NULL_HANDLE || m_OutputExtent.width == 0)
+			return;
+
+		const uint32_t target = 1 - m_Current;
+
+		// The history we read was written by last frame's resolve; the one we
+		// overwrite was read by the post-process pass two frames ago (and by
+		// last frame's resolve). Both images stay in GENERAL.
+		std::array<VkImageMemoryBarrier, 2> barriers{};
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			VkImageMemoryBarrier& barrier = barriers[i];
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = m_HistoryImages[i];
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.levelCount = 1;
+			barrier.subresourceRange.layerCount = 1;
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = (i == target) ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT;
+		}
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, m_ResolveSets[target]);
+
+		ResolvePushConstants push{};
+		push.reprojection = m_PrevViewProj * glm::inverse(viewProj);
+		push.jitter = glm::vec4(jitter, 0.0f, 0.0f);
+		push.extents = glm::ivec4(
+			static_cast<int>(std::min(renderExtent.width, m_OutputExtent.width)),
+			static_cast<int>(std::min(renderExtent.height, m_OutputExtent.height)),
+			static_cast<int>(m_OutputExtent.width),
+			static_cast<int>(m_OutputExtent.height));
+		push.params = glm::vec4(m_HistoryValid ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(m_OutputExtent.width, RESOLVE_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(m_OutputExtent.height, RESOLVE_LOCAL_SIZE));
+
+		// Output -> the post-process pass (fragment, or the compute post pass)
+		VkImageMemoryBarrier& output = barriers[target];
+		output.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		output.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &output);
+
+		m_Current = target;
+		m_PrevViewProj = viewProj;
+		m_HistoryValid = true;
+	}
+}
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+// TemporalUpscaler.hpp
+//
+// Temporal upscaling / anti-aliasing (TemporalUpscale.comp). The scene is
+// drawn with a sub-pixel jittered projection (GetJitterMatrix, a Halton
+// sequence in render-resolution pixels) at the dynamic-resolution extent;
+// Resolve then reconstructs a full-display-resolution image each frame from
+// the new samples and the previous output, reprojected through the scene
+// depth and last frame's view-projection. The previous output is clipped
+// to the new samples' neighbourhood, which rejects most stale history
+// (disocclusion, moving objects) without motion vectors.
+//
+// The output replaces the scene color as the post-process input (and FXAA,
+// which would only blur it). History lives in two GENERAL images that swap
+// every frame; a resize, camera cut or toggling it on resets the history.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class ResourceManager;
+	class ComputeDispatcher;
+
+	class TemporalUpscaler
+	{
+	public:
+		// Jitter sequence length; long enough to cover a 2x upscale per axis
+		static constexpr uint32_t JITTER_PHASES = 32;
+
+		TemporalUpscaler() = default;
+		~TemporalUpscaler() = default;
+
+		// colorView/depthView are RenderPassManager's scene color (single
+		// sample; the MSAA resolve) and depth buffer; outputExtent is the
+		// display size the history is kept at.
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, ResourceManager* resources,
+			VulkanDescriptorManager* descriptorManager, VkImageView colorView, VkImageView depthView,
+			VkSampleCountFlagBits depthSamples, VkExtent2D outputExtent);
+		void Cleanup();
+
+		// Swapchain resize: the scene targets were recreated. Caller has
+		// waited for the frames using the old history.
+		bool Resize(VkImageView colorView, VkImageView depthView, VkExtent2D outputExtent);
+
+		// Sub-pixel offset for frameNumber, in render-resolution pixels
+		// ((-0.5, 0.5) per axis), and the NDC translation that applies it
+		// to a projection: jittered = GetJitterMatrix(...) * projection.
+		static glm::vec2 GetJitter(uint64_t frameNumber);
+		static glm::mat4 GetJitterMatrix(glm::vec2 jitter, VkExtent2D renderExtent);
+
+		// After the scene pass. viewProj is the UNjittered matrix the frame
+		// was drawn with, renderExtent the part of the scene targets it
+		// covered, jitter the offset applied. Writes the output image and
+		// leaves it readable by fragment shaders (GetOutputSet).
+		void Resolve(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const glm::mat4& viewProj,
+			VkExtent2D renderExtent, glm::vec2 jitter);
+
+		// Post-process input set (VulkanDescriptorManager's post-process
+		// input layout) holding the output of the last Resolve
+		VkDescriptorSet GetOutputSet() const { return m_OutputSets[m_Current]; }
+
+		// Next Resolve ignores the history (camera cut, toggled on)
+		void ResetHistory() { m_HistoryValid = false; }
+
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const { return m_Enabled; }
+
+	private:
+		bool CreateHistory(VkImageView colorView, VkImageView depthView, VkExtent2D outputExtent);
+		void DestroyHistory();
+		bool CreatePipeline(VkSampleCountFlagBits depthSamples);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		// History ping-pong: Resolve writes [m_Current] from [1 - m_Current]
+		std::array<VkImage, 2> m_HistoryImages{};
+		std::array<void*, 2> m_HistoryAllocations{};  // VulkanMemoryManager::ImageAllocation*
+		std::array<VkImageView, 2> m_HistoryViews{};
+		VkExtent2D m_OutputExtent = { 0, 0 };
+		uint32_t m_Current = 0;
+
+		VkSampler m_PointSampler = VK_NULL_HANDLE;
+		VkSampler m_LinearSampler = VK_NULL_HANDLE;
+
+		// Resolve set i writes history i (reading history 1 - i); output set
+		// i exposes history i to the post-process pass
+		std::array<VkDescriptorSet, 2> m_ResolveSets{};
+		std::array<VkDescriptorSet, 2> m_OutputSets{};
+
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+
+		glm::mat4 m_PrevViewProj = glm::mat4(1.0f);
+		bool m_HistoryValid = false;
+		bool m_Enabled = false;
+	};
+}
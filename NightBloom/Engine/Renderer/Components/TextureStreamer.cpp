@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+// TextureStreamer.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/TextureStreamer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	TextureStreamer::TextureStreamer(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanCommandPool* commandPool, const TextureResidencySettings& settings)
+		: m_Device(device)
+		, m_MemoryManager(memoryManager)
+		, m_CommandPool(commandPool)
+		, m_Residency(settings)
+	{
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		// The owner shuts the upload manager down first, so pending
+		// replacements can go directly
+		m_Streamed.clear();
+		m_Handles.clear();
+	}
+
+	std::unique_ptr<VulkanTexture> TextureStreamer::CreateTexture(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanCommandPool* commandPool, const uint8_t* fileData, const Ktx2Image& image, uint32_t baseMip)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture));
+
+		if (baseMip >= image.levels.size())
+			return nullptr;
+
+		// The levels are contiguous in a cooked file (smallest first); stage
+		// the span the requested ones cover straight out of the mapping
+		uint64_t first = image.levels[baseMip].offset, last = 0;
+		for (size_t level = baseMip; level < image.levels.size(); ++level)
+		{
+			first = std::min(first, image.levels[level].offset);
+			last = std::max(last, image.levels[level].offset + image.levels[level].size);
+		}
+		std::vector<size_t> levelOffsets;
+		for (size_t level = baseMip; level < image.levels.size(); ++level)
+			levelOffsets.push_back(static_cast<size_t>(image.levels[level].offset - first));
+
+		TextureDesc desc;
+		desc.width = std::max(1u, image.width >> baseMip);
+		desc.height = std::max(1u, image.height >> baseMip);
+		desc.format = image.format;
+		desc.mipLevels = static_cast<uint32_t>(image.levels.size()) - baseMip;
+		desc.generateMips = false;
+		desc.usage = TextureUsage::Sampled;
+		// Streamed-in levels are the first to go under VRAM pressure; the
+		// resident tail is what every texture falls back on
+		desc.memoryPriority = baseMip < GetTailMip(image) ? GpuMemoryPriority::Low : GpuMemoryPriority::Default;
+
+		auto texture = std::make_unique<VulkanTexture>(device, memoryManager);
+		if (!texture->Initialize(desc) ||
+			!texture->UploadMipLevels(fileData + first, static_cast<size_t>(last - first), levelOffsets, commandPool))
+		{
+			return nullptr;
+		}
+		return texture;
+	}
+
+	uint32_t TextureStreamer::GetTailMip(const Ktx2Image& image)
+	{
+		const uint32_t lastMip = static_cast<uint32_t>(image.levels.size()) - 1;
+		uint32_t mip = 0;
+		while (mip < lastMip && std::max(image.width, image.height) >> mip > TAIL_SIZE)
+			++mip;
+		return mip;
+	}
+
+	void TextureStreamer::Register(VulkanTexture* texture, AssetFile file, const Ktx2Image& image)
+	{
+		if (!texture || IsStreamed(texture))
+			return;
+
+		std::vector<uint64_t> levelBytes;
+		for (const Ktx2Level& level : image.levels)
+			levelBytes.push_back(level.size);
+
+		const TextureResidency::Handle handle = m_Residency.Register(levelBytes, GetTailMip(image));
+		if (handle == TextureResidency::INVALID_HANDLE)
+			return;
+
+		auto streamed = std::make_unique<Streamed>();
+		streamed->texture = texture;
+		streamed->file = std::move(file);
+		streamed->image = image;
+
+		if (handle >= m_Streamed.size())
+			m_Streamed.resize(handle + 1);
+		m_Streamed[handle] = std::move(streamed);
+		m_Handles[texture] = handle;
+	}
+
+	void TextureStreamer::Unregister(const Texture* texture)
+	{
+		auto it = m_Handles.find(texture);
+		if (it == m_Handles.end())
+			return;
+
+		const TextureResidency::Handle handle = it->second;
+		DiscardReplacement(*m_Streamed[handle]);
+		m_Streamed[handle].reset();
+		m_Residency.Unregister(handle);
+		m_Handles.erase(it);
+	}
+
+	void TextureStreamer::DiscardReplacement(Streamed& streamed)
+	{
+		if (!streamed.replacement)
+			return;
+
+		// Its upload may still be running
+		VulkanTexture* replacement = streamed.replacement.release();
+		m_Device->GetDeletionQueue()->Defer([replacement]() { delete replacement; });
+	}
+
+	void TextureStreamer::Request(const Texture* texture, float screenPixels)
+	{
+		auto it = m_Handles.find(texture);
+		if (it == m_Handles.end())
+			return;
+
+		const Ktx2Image& image = m_Streamed[it->second]->image;
+		const uint32_t mip = ComputeRequestedMip(std::max(image.width, image.height), screenPixels,
+			static_cast<uint32_t>(image.levels.size()));
+		m_Residency.Request(it->second, mip, m_Frame);
+	}
+
+	uint64_t TextureStreamer::ComputeBudget() const
+	{
+		if (m_BudgetOverride > 0)
+			return m_BudgetOverride;
+
+		// Everything that isn't a streamed texture is taken as given;
+		// replacements being uploaded are already allocated
+		uint64_t streamedBytes = m_Residency.GetResidentBytes();
+		for (const auto& streamed : m_Streamed)
+		{
+			if (streamed && streamed->replacement)
+			{
+				const TextureResidency::Handle handle = m_Handles.at(streamed->texture);
+				streamedBytes += m_Residency.GetBytes(handle, m_Residency.GetPendingMip(handle));
+			}
+		}
+
+		const VulkanMemoryManager::HeapBudget heap = m_MemoryManager->GetDeviceBudget();
+		const uint64_t others = heap.usage > streamedBytes ? heap.usage - streamedBytes : 0;
+		const uint64_t target = static_cast<uint64_t>(double(heap.budget) * BUDGET_FRACTION);
+		return target > others ? target - others : 0;
+	}
+
+	std::vector<TextureStreamer::BindlessRemap> TextureStreamer::Update()
+	{
+		std::vector<BindlessRemap> remaps;
+		VulkanUploadManager* uploads = m_MemoryManager->GetUploadManager();
+		VulkanDeletionQueue* deletionQueue = m_Device->GetDeletionQueue();
+
+		// Finished replacements take over; the old images go once the frames
+		// already submitted are done with them
+		for (TextureResidency::Handle handle = 0; handle < m_Streamed.size(); ++handle)
+		{
+			Streamed* streamed = m_Streamed[handle].get();
+			if (!streamed || !streamed->replacement)
+				continue;
+			if (uploads && !uploads->IsComplete(streamed->token))
+				continue;
+
+			const uint32_t oldIndex = streamed->texture->GetBindlessIndex();
+			if (streamed->texture->AdoptImage(*streamed->replacement, deletionQueue))
+				m_Residency.Complete(handle);
+			else
+				m_Residency.Cancel(handle);
+			streamed->replacement.reset();
+
+			const uint32_t newIndex = streamed->texture->GetBindlessIndex();
+			if (oldIndex != BindlessIndexAllocator::INVALID_INDEX && newIndex != oldIndex)
+				remaps.push_back({ oldIndex, newIndex });
+		}
+
+		m_LastBudget = ComputeBudget();
+		const std::vector<TextureResidency::Change> changes = m_Residency.Update(m_LastBudget, m_Frame++);
+		if (changes.empty())
+			return remaps;
+
+		// Every replacement of this update goes out in one submission
+		std::vector<Streamed*> started;
+		{
+			UploadBatchScope batch(uploads);
+			for (const TextureResidency::Change& change : changes)
+			{
+				Streamed& streamed = *m_Streamed[change.handle];
+				streamed.replacement = CreateTexture(m_Device, m_MemoryManager, m_CommandPool,
+					streamed.file.GetData(), streamed.image, change.mip);
+				if (streamed.replacement)
+				{
+					started.push_back(&streamed);
+				}
+				else
+				{
+					LOG_WARN("TextureStreamer: failed to build mips {}+ of a {}x{} texture", change.mip,
+						streamed.image.width, streamed.image.height);
+					m_Residency.Cancel(change.handle);
+				}
+			}
+		}
+
+		const UploadToken token = uploads ? uploads->GetLastSubmittedToken() : 0;
+		for (Streamed* streamed : started)
+			streamed->token = token;
+		return remaps;
+	}
+}
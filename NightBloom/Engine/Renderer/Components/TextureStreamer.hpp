@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+// TextureStreamer.hpp
+//
+// Mip streaming for cooked (KTX2) textures under a VRAM budget. A streamed
+// texture is created holding only its mip tail (levels of TAIL_SIZE texels
+// or less) and its file stays mapped. Each frame the draws request the mip
+// their screen footprint needs; TextureResidency plans which textures gain
+// or drop levels within the budget, and a change is made by uploading a
+// replacement image with the new level range in the background. Once that
+// upload has completed, the texture adopts the replacement
+// (VulkanTexture::AdoptImage) and the old image is released after the frames
+// still sampling it. Nothing waits on the GPU, and a level that hasn't
+// arrived yet only means a blurrier texture for a few frames.
+//
+// Images hold a contiguous range r..N-1 of the cooked chain, so a smaller
+// image with fewer levels samples exactly like the full one with mips below
+// r clamped; GetWidth()/GetHeight() of a streamed texture report the resident
+// top level. The budget is the device-local heap budget VMA reports (the
+// driver's, with VK_EXT_memory_budget) less everything that isn't a streamed
+// texture, unless overridden with SetBudget.
+//
+// Only textures sampled through their own descriptor set or bindless slot
+// can stream: a set written elsewhere with their view would be left pointing
+// at a released image.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/TextureResidency.hpp"
+#include "Engine/Renderer/Ktx2.hpp"
+#include "Engine/Renderer/Vulkan/VulkanUploadManager.hpp"
+#include "Engine/Core/AssetArchive.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanCommandPool;
+	class VulkanTexture;
+	class Texture;
+
+	class TextureStreamer
+	{
+	public:
+		// Largest mip always resident (the tail)
+		static constexpr uint32_t TAIL_SIZE = 64;
+
+		// Share of the heap budget streaming plans against; the rest is
+		// headroom for allocations made between updates
+		static constexpr float BUDGET_FRACTION = 0.9f;
+
+		// A texture's bindless slot moved when it adopted a new image
+		struct BindlessRemap
+		{
+			uint32_t from;
+			uint32_t to;
+		};
+
+		TextureStreamer(VulkanDevice* device, VulkanMemoryManager* memoryManager, VulkanCommandPool* commandPool,
+			const TextureResidencySettings& settings = TextureResidencySettings{});
+		~TextureStreamer();
+
+		// Creates a texture holding `image`'s levels from baseMip on, read out
+		// of `fileData` (the mapped file it was parsed from). The upload is
+		// queued, not waited on.
+		static std::unique_ptr<VulkanTexture> CreateTexture(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanCommandPool* commandPool, const uint8_t* fileData, const Ktx2Image& image, uint32_t baseMip);
+
+		// First level of `image` at or below TAIL_SIZE; 0 when there is
+		// nothing above the tail to stream
+		static uint32_t GetTailMip(const Ktx2Image& image);
+
+		// Takes over `texture`, created by CreateTexture at GetTailMip(image),
+		// and the file its levels come from
+		void Register(VulkanTexture* texture, AssetFile file, const Ktx2Image& image);
+		void Unregister(const Texture* texture);
+		bool IsStreamed(const Texture* texture) const { return m_Handles.count(texture) != 0; }
+
+		// This frame's draws need `texture` (streamed or not) to cover
+		// screenPixels pixels along its larger side
+		void Request(const Texture* texture, float screenPixels);
+
+		// Once per frame, after the requests and before anything records
+		// draws: swaps in replacements whose uploads have finished, then
+		// starts this frame's planned changes. Returns the bindless slots that
+		// moved, for tables holding texture indices.
+		std::vector<BindlessRemap> Update();
+
+		// Bytes streamed textures may occupy; 0 derives it from the heap
+		// budget every update
+		void SetBudget(uint64_t bytes) { m_BudgetOverride = bytes; }
+		uint64_t GetLastBudget() const { return m_LastBudget; }
+
+		const TextureResidency& GetResidency() const { return m_Residency; }
+		size_t GetStreamedCount() const { return m_Handles.size(); }
+
+	private:
+		struct Streamed
+		{
+			VulkanTexture* texture = nullptr;
+			AssetFile file;
+			Ktx2Image image;
+			std::unique_ptr<VulkanTexture> replacement;   // being uploaded
+			UploadToken token = 0;
+		};
+
+		uint64_t ComputeBudget() const;
+		void DiscardReplacement(Streamed& streamed);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanCommandPool* m_CommandPool = nullptr;
+
+		TextureResidency m_Residency;
+		std::vector<std::unique_ptr<Streamed>> m_Streamed;   // by residency handle
+		std::unordered_map<const Texture*, TextureResidency::Handle> m_Handles;
+
+		uint64_t m_Frame = 0;
+		uint64_t m_BudgetOverride = 0;
+		uint64_t m_LastBudget = 0;
+
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+	};
+}
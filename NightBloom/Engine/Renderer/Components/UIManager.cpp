@@ -6,16 +6,44 @@
 
 #include "Engine/Renderer/Components/UIManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include <imgui.h>
+#include <imgui_internal.h>   // ImGuiContext::InputEventsQueue
 #include <imgui_impl_vulkan.h>
 #include <imgui_impl_win32.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace Nightbloom
 {
-	bool UIManager::Initialize(VulkanDevice* device, void* windowHandle,
-		VkRenderPass renderPass, uint32_t imageCount)
+	namespace
 	{
+		// ImGui's display space -> clip space (UIOverlay.vert)
+		struct UIPushConstants
+		{
+			float scale[2];
+			float translate[2];
+		};
+
+		double NowSeconds()
+		{
+			using Clock = std::chrono::steady_clock;
+			return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+		}
+	}
+
+	bool UIManager::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, void* windowHandle,
+		VkRenderPass renderPass, uint32_t imageCount, VkFormat colorFormat, VkExtent2D extent)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_ColorFormat = colorFormat;
+		m_Extent = extent;
+
 		// Create descriptor pool for ImGui
 		if (!CreateDescriptorPool(device->GetDevice()))
 		{
@@ -47,10 +75,20 @@ namespace Nightbloom
 		init_info.Device = device->GetDevice();
 		init_info.QueueFamily = device->GetGraphicsQueueFamily();
 		init_info.Queue = device->GetGraphicsQueue();
-		init_info.PipelineCache = VK_NULL_HANDLE;
+		init_info.PipelineCache = device->GetPipelineCache();
 		init_info.DescriptorPool = m_DescriptorPool;
 		init_info.RenderPass = renderPass;
 		init_info.Subpass = 0;
+		if (renderPass == VK_NULL_HANDLE)
+		{
+			// Rendered inside a vkCmdBeginRenderingKHR pass; the backend loads
+			// the KHR entry points for a 1.2 device
+			init_info.ApiVersion = VK_API_VERSION_1_2;
+			init_info.UseDynamicRendering = true;
+			init_info.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+			init_info.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+			init_info.PipelineRenderingCreateInfo.pColorAttachmentFormats = &colorFormat;
+		}
 		init_info.MinImageCount = 2;
 		init_info.ImageCount = imageCount;
 		init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
@@ -66,12 +104,51 @@ namespace Nightbloom
 		}
 
 		m_Initialized = true;
+
+		if (!CreatePipelines(renderPass))
+		{
+			LOG_ERROR("Failed to create the UI pipelines");
+			Cleanup(device->GetDevice());
+			return false;
+		}
+
 		LOG_INFO("UI manager initialized successfully");
 		return true;
 	}
 
 	void UIManager::Cleanup(VkDevice device)
 	{
+		DestroyCache();
+		if (m_CacheRenderPass != VK_NULL_HANDLE)
+		{
+			vkDestroyRenderPass(device, m_CacheRenderPass, nullptr);
+			m_CacheRenderPass = VK_NULL_HANDLE;
+		}
+		for (VkPipeline* pipeline : { &m_Pipeline, &m_CachePipeline, &m_CompositePipeline })
+		{
+			if (*pipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, *pipeline, nullptr);
+				*pipeline = VK_NULL_HANDLE;
+			}
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		if (m_TextureSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_TextureSetLayout, nullptr);
+			m_TextureSetLayout = VK_NULL_HANDLE;
+		}
+		for (FrameBuffer& buffer : m_FrameBuffers)
+		{
+			if (buffer.allocation && m_MemoryManager)
+				m_MemoryManager->DestroyBuffer(buffer.allocation);
+			buffer = FrameBuffer{};
+		}
+
 		if (m_Initialized)
 		{
 			ImGui_ImplVulkan_Shutdown();
@@ -91,29 +168,592 @@ namespace Nightbloom
 
 	void UIManager::BeginFrame()
 	{
+		m_FrameActive = false;
 		if (!m_Initialized) return;
 
+		// Input waiting for NewFrame, a widget held or a text field taking
+		// keys (its caret blinks) keep the UI live
+		const ImGuiIO& io = ImGui::GetIO();
+		const bool activity = ImGui::GetCurrentContext()->InputEventsQueue.Size > 0 ||
+			ImGui::IsAnyItemActive() || io.WantTextInput;
+		if (!m_Cache.ShouldRefresh(NowSeconds(), activity))
+			return;
+
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplWin32_NewFrame();
 		ImGui::NewFrame();
+		m_FrameActive = true;
 	}
 
 	void UIManager::EndFrame()
 	{
-		if (!m_Initialized) return;
+		if (!m_Initialized || !m_FrameActive) return;
 
 		ImGui::Render();
+
+		// Texture creates and updates (the font atlas growing) go through
+		// the backend's own upload; before any of this frame's recording
+		ImDrawData* drawData = ImGui::GetDrawData();
+		if (drawData && drawData->Textures)
+		{
+			for (ImTextureData* texture : *drawData->Textures)
+			{
+				if (texture->Status != ImTextureStatus_OK)
+					ImGui_ImplVulkan_UpdateTexture(texture);
+			}
+		}
+	}
+
+	void UIManager::SetSettings(const UIOverlaySettings& settings)
+	{
+		m_Cache.SetSettings(settings);
+		if (settings.cached && m_CacheImage == nullptr && m_Initialized && !CreateCache())
+		{
+			LOG_WARN("UI cache unavailable - drawing the UI every frame");
+			UIOverlaySettings uncached = settings;
+			uncached.cached = false;
+			m_Cache.SetSettings(uncached);
+		}
+	}
+
+	void UIManager::Resize(VkExtent2D extent)
+	{
+		m_Extent = extent;
+		m_Cache.Invalidate();
+		if (m_CacheImage == nullptr)
+			return;
+
+		DestroyCache();
+		if (!CreateCache())
+		{
+			LOG_WARN("UI cache unavailable after resize - drawing the UI every frame");
+			UIOverlaySettings uncached = m_Cache.GetSettings();
+			uncached.cached = false;
+			m_Cache.SetSettings(uncached);
+		}
+	}
+
+	bool UIManager::NeedsCacheRecord() const
+	{
+		return m_FrameActive && m_Cache.GetSettings().cached && m_CacheFramebuffer != VK_NULL_HANDLE;
+	}
+
+	void UIManager::RecordCache(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+	{
+		if (!NeedsCacheRecord())
+			return;
+
+		ImDrawData* drawData = ImGui::GetDrawData();
+		const bool hasDraws = drawData && drawData->TotalVtxCount > 0 && UploadDrawData(drawData, frameIndex);
+
+		// Cleared to transparent; the render pass leaves it shader-readable
+		VkClearValue clear{};
+		clear.color = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+		VkRenderPassBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		beginInfo.renderPass = m_CacheRenderPass;
+		beginInfo.framebuffer = m_CacheFramebuffer;
+		beginInfo.renderArea.extent = m_Extent;
+		beginInfo.clearValueCount = 1;
+		beginInfo.pClearValues = &clear;
+		vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		if (hasDraws)
+			RecordDrawData(commandBuffer, drawData, frameIndex, m_CachePipeline);
+		vkCmdEndRenderPass(commandBuffer);
+
+		m_CacheValid = true;
 	}
 
-	void UIManager::Render(VkCommandBuffer commandBuffer)
+	void UIManager::Render(VkCommandBuffer commandBuffer, uint32_t frameIndex)
 	{
 		if (!m_Initialized) return;
 
-		ImDrawData* draw_data = ImGui::GetDrawData();
-		if (draw_data)
+		if (m_Cache.GetSettings().cached)
+		{
+			if (!m_CacheValid || m_CompositePipeline == VK_NULL_HANDLE)
+				return;
+
+			VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(m_Extent.width), static_cast<float>(m_Extent.height), 0.0f, 1.0f };
+			VkRect2D scissor{ { 0, 0 }, m_Extent };
+			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_CompositePipeline);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout,
+				0, 1, &m_CacheSet, 0, nullptr);
+			vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+			return;
+		}
+
+		if (!m_FrameActive) return;
+		ImDrawData* drawData = ImGui::GetDrawData();
+		if (drawData && drawData->TotalVtxCount > 0 && UploadDrawData(drawData, frameIndex))
+			RecordDrawData(commandBuffer, drawData, frameIndex, m_Pipeline);
+	}
+
+	bool UIManager::UploadDrawData(ImDrawData* drawData, uint32_t frameIndex)
+	{
+		FrameBuffer& buffer = m_FrameBuffers[frameIndex % MAX_FRAMES_IN_FLIGHT];
+		const VkDeviceSize vertexBytes = static_cast<VkDeviceSize>(drawData->TotalVtxCount) * sizeof(ImDrawVert);
+		const VkDeviceSize indexOffset = (vertexBytes + 3) & ~VkDeviceSize(3);
+		const VkDeviceSize totalBytes = indexOffset + static_cast<VkDeviceSize>(drawData->TotalIdxCount) * sizeof(ImDrawIdx);
+
+		// Grown with headroom so a panel opening doesn't reallocate every frame;
+		// this frame's fence was waited on, so the old one is free
+		if (!buffer.allocation || buffer.allocation->size < totalBytes)
+		{
+			if (buffer.allocation)
+				m_MemoryManager->DestroyBuffer(buffer.allocation);
+
+			VulkanMemoryManager::BufferCreateInfo createInfo{};
+			createInfo.size = std::max<VkDeviceSize>(totalBytes + totalBytes / 2, 256 * 1024);
+			createInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+			createInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+			createInfo.mappable = true;
+			createInfo.category = GpuMemoryCategory::Renderer;
+			createInfo.debugName = "UIVertices";
+			buffer.allocation = m_MemoryManager->CreateBuffer(createInfo);
+			if (!buffer.allocation || !buffer.allocation->mappedData)
+			{
+				LOG_ERROR("Failed to create the {} KB UI vertex buffer", createInfo.size / 1024);
+				if (buffer.allocation)
+					m_MemoryManager->DestroyBuffer(buffer.allocation);
+				buffer = FrameBuffer{};
+				return false;
+			}
+		}
+
+		uint8_t* mapped = static_cast<uint8_t*>(buffer.allocation->mappedData);
+		ImDrawVert* vertices = reinterpret_cast<ImDrawVert*>(mapped);
+		ImDrawIdx* indices = reinterpret_cast<ImDrawIdx*>(mapped + indexOffset);
+		for (const ImDrawList* list : drawData->CmdLists)
+		{
+			std::memcpy(vertices, list->VtxBuffer.Data, list->VtxBuffer.Size * sizeof(ImDrawVert));
+			std::memcpy(indices, list->IdxBuffer.Data, list->IdxBuffer.Size * sizeof(ImDrawIdx));
+			vertices += list->VtxBuffer.Size;
+			indices += list->IdxBuffer.Size;
+		}
+		m_MemoryManager->FlushMemory(buffer.allocation->allocation, 0, totalBytes);
+		buffer.indexOffset = indexOffset;
+		return true;
+	}
+
+	// The same state and clipping as ImGui_ImplVulkan_RenderDrawData
+	void UIManager::RecordDrawData(VkCommandBuffer commandBuffer, ImDrawData* drawData, uint32_t frameIndex,
+		VkPipeline pipeline)
+	{
+		const float fbWidth = drawData->DisplaySize.x * drawData->FramebufferScale.x;
+		const float fbHeight = drawData->DisplaySize.y * drawData->FramebufferScale.y;
+		if (fbWidth <= 0.0f || fbHeight <= 0.0f || pipeline == VK_NULL_HANDLE)
+			return;
+
+		const FrameBuffer& buffer = m_FrameBuffers[frameIndex % MAX_FRAMES_IN_FLIGHT];
+		const VkDeviceSize vertexOffset = 0;
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &buffer.allocation->buffer, &vertexOffset);
+		vkCmdBindIndexBuffer(commandBuffer, buffer.allocation->buffer, buffer.indexOffset,
+			sizeof(ImDrawIdx) == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+
+		VkViewport viewport{ 0.0f, 0.0f, fbWidth, fbHeight, 0.0f, 1.0f };
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		UIPushConstants push{};
+		push.scale[0] = 2.0f / drawData->DisplaySize.x;
+		push.scale[1] = 2.0f / drawData->DisplaySize.y;
+		push.translate[0] = -1.0f - drawData->DisplayPos.x * push.scale[0];
+		push.translate[1] = -1.0f - drawData->DisplayPos.y * push.scale[1];
+		vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
+
+		const ImVec2 clipOffset = drawData->DisplayPos;
+		const ImVec2 clipScale = drawData->FramebufferScale;
+		VkDescriptorSet boundSet = VK_NULL_HANDLE;
+		uint32_t vertexBase = 0;
+		uint32_t indexBase = 0;
+		for (const ImDrawList* list : drawData->CmdLists)
+		{
+			for (const ImDrawCmd& command : list->CmdBuffer)
+			{
+				if (command.UserCallback != nullptr)
+				{
+					// No app callbacks draw into the UI; the reset marker is all
+					// ImGui itself emits
+					continue;
+				}
+
+				const float minX = std::max((command.ClipRect.x - clipOffset.x) * clipScale.x, 0.0f);
+				const float minY = std::max((command.ClipRect.y - clipOffset.y) * clipScale.y, 0.0f);
+				const float maxX = std::min((command.ClipRect.z - clipOffset.x) * clipScale.x, fbWidth);
+				const float maxY = std::min((command.ClipRect.w - clipOffset.y) * clipScale.y, fbHeight);
+				if (maxX <= minX || maxY <= minY)
+					continue;
+
+				VkRect2D scissor{};
+				scissor.offset = { static_cast<int32_t>(minX), static_cast<int32_t>(minY) };
+				scissor.extent = { static_cast<uint32_t>(maxX - minX), static_cast<uint32_t>(maxY - minY) };
+				vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+				VkDescriptorSet set = reinterpret_cast<VkDescriptorSet>(command.GetTexID());
+				if (set != boundSet)
+				{
+					vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout,
+						0, 1, &set, 0, nullptr);
+					boundSet = set;
+				}
+
+				vkCmdDrawIndexed(commandBuffer, command.ElemCount, 1, command.IdxOffset + indexBase,
+					static_cast<int32_t>(command.VtxOffset + vertexBase), 0);
+			}
+			vertexBase += static_cast<uint32_t>(list->VtxBuffer.Size);
+			indexBase += static_cast<uint32_t>(list->IdxBuffer.Size);
+		}
+	}
+
+	bool UIManager::CreatePipelines(VkRenderPass renderPass)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = 1;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+		setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		setLayoutInfo.bindingCount = 1;
+		setLayoutInfo.pBindings = &binding;
+		if (vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &m_TextureSetLayout) != VK_SUCCESS)
+			return false;
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		range.size = sizeof(UIPushConstants);
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &m_TextureSetLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+			return false;
+
+		// The cache: the post-process target's format, cleared, left for the
+		// composite to sample. The external dependencies order it after the
+		// previous frame's composite read and before this frame's.
+		VkAttachmentDescription attachment{};
+		attachment.format = m_ColorFormat;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkAttachmentReference colorRef{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorRef;
+
+		std::array<VkSubpassDependency, 2> dependencies{};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].srcAccessMask = 0;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = 1;
+		renderPassInfo.pAttachments = &attachment;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+		if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_CacheRenderPass) != VK_SUCCESS)
+			return false;
+
+		m_Pipeline = CreatePipeline("UIOverlay.vert.spv", "UIOverlay.frag.spv", true, false, renderPass);
+		if (m_Pipeline == VK_NULL_HANDLE)
+			return false;
+
+		// Without these the UI still draws, uncached
+		m_CachePipeline = CreatePipeline("UIOverlay.vert.spv", "UIOverlay.frag.spv", true, false, m_CacheRenderPass);
+		m_CompositePipeline = CreatePipeline("PostProcess.vert.spv", "UIComposite.frag.spv", false, true, renderPass);
+		if (m_CachePipeline == VK_NULL_HANDLE || m_CompositePipeline == VK_NULL_HANDLE)
+			LOG_WARN("UI cache pipelines unavailable - the UI is drawn every frame");
+		return true;
+	}
+
+	// renderPass VK_NULL_HANDLE: dynamic rendering into m_ColorFormat
+	VkPipeline UIManager::CreatePipeline(const char* vertexShader, const char* fragmentShader, bool imguiVertices,
+		bool premultiplied, VkRenderPass renderPass)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		std::array<VkShaderModule, 2> modules = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+		const std::array<const char*, 2> shaderNames = { vertexShader, fragmentShader };
+		for (size_t i = 0; i < modules.size(); ++i)
+		{
+			auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderNames[i]);
+			if (!shaderCode.IsOpen())
+			{
+				LOG_ERROR("UIManager: failed to load {}", shaderNames[i]);
+				break;
+			}
+
+			VkShaderModuleCreateInfo moduleInfo{};
+			moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			moduleInfo.codeSize = shaderCode.GetSize();
+			moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+			if (vkCreateShaderModule(device, &moduleInfo, nullptr, &modules[i]) != VK_SUCCESS)
+			{
+				LOG_ERROR("UIManager: failed to create shader module for {}", shaderNames[i]);
+				modules[i] = VK_NULL_HANDLE;
+				break;
+			}
+		}
+		if (modules[0] == VK_NULL_HANDLE || modules[1] == VK_NULL_HANDLE)
+		{
+			for (VkShaderModule module : modules)
+				if (module != VK_NULL_HANDLE)
+					vkDestroyShaderModule(device, module, nullptr);
+			return VK_NULL_HANDLE;
+		}
+
+		std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+		stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		stages[0].module = modules[0];
+		stages[0].pName = "main";
+		stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		stages[1].module = modules[1];
+		stages[1].pName = "main";
+
+		// ImDrawVert: pos, uv, RGBA8 color
+		VkVertexInputBindingDescription binding{ 0, sizeof(ImDrawVert), VK_VERTEX_INPUT_RATE_VERTEX };
+		const std::array<VkVertexInputAttributeDescription, 3> attributes = { {
+			{ 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(ImDrawVert, pos) },
+			{ 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(ImDrawVert, uv) },
+			{ 2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(ImDrawVert, col) } } };
+		VkPipelineVertexInputStateCreateInfo vertexInput{};
+		vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		if (imguiVertices)
+		{
+			vertexInput.vertexBindingDescriptionCount = 1;
+			vertexInput.pVertexBindingDescriptions = &binding;
+			vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size());
+			vertexInput.pVertexAttributeDescriptions = attributes.data();
+		}
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+		VkPipelineViewportStateCreateInfo viewportState{};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		VkPipelineRasterizationStateCreateInfo rasterizer{};
+		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterizer.cullMode = VK_CULL_MODE_NONE;
+		rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		rasterizer.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisampling{};
+		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineDepthStencilStateCreateInfo depthStencil{};
+		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+		// ImGui's blend; into the cleared cache it leaves premultiplied
+		// color, which the composite lays over with ONE
+		VkPipelineColorBlendAttachmentState blend{};
+		blend.blendEnable = VK_TRUE;
+		blend.srcColorBlendFactor = premultiplied ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_SRC_ALPHA;
+		blend.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blend.colorBlendOp = VK_BLEND_OP_ADD;
+		blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blend.alphaBlendOp = VK_BLEND_OP_ADD;
+		blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+			VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		VkPipelineColorBlendStateCreateInfo colorBlending{};
+		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlending.attachmentCount = 1;
+		colorBlending.pAttachments = &blend;
+
+		const std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkPipelineRenderingCreateInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachmentFormats = &m_ColorFormat;
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.pNext = renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+		pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+		pipelineInfo.pStages = stages.data();
+		pipelineInfo.pVertexInputState = &vertexInput;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterizer;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pDepthStencilState = &depthStencil;
+		pipelineInfo.pColorBlendState = &colorBlending;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = m_PipelineLayout;
+		pipelineInfo.renderPass = renderPass;
+		pipelineInfo.subpass = 0;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		if (vkCreateGraphicsPipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+		{
+			LOG_ERROR("UIManager: failed to create the {} / {} pipeline", vertexShader, fragmentShader);
+			pipeline = VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, pipeline, fragmentShader);
+		for (VkShaderModule module : modules)
+			vkDestroyShaderModule(device, module, nullptr);
+		return pipeline;
+	}
+
+	bool UIManager::CreateCache()
+	{
+		if (m_CachePipeline == VK_NULL_HANDLE || m_CompositePipeline == VK_NULL_HANDLE ||
+			m_Extent.width == 0 || m_Extent.height == 0)
+			return false;
+
+		VkDevice device = m_Device->GetDevice();
+
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = m_Extent.width;
+		imageInfo.height = m_Extent.height;
+		imageInfo.format = m_ColorFormat;
+		imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.category = GpuMemoryCategory::RenderTarget;
+		imageInfo.debugName = "UICache";
+		m_CacheImage = m_MemoryManager->CreateImage(imageInfo);
+		if (!m_CacheImage)
+		{
+			LOG_ERROR("UIManager: failed to create the {}x{} UI cache", m_Extent.width, m_Extent.height);
+			return false;
+		}
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_CacheImage->image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = m_ColorFormat;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &m_CacheView) != VK_SUCCESS)
+		{
+			LOG_ERROR("UIManager: failed to create the UI cache view");
+			DestroyCache();
+			return false;
+		}
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_CacheRenderPass;
+		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.pAttachments = &m_CacheView;
+		framebufferInfo.width = m_Extent.width;
+		framebufferInfo.height = m_Extent.height;
+		framebufferInfo.layers = 1;
+		if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_CacheFramebuffer) != VK_SUCCESS)
+		{
+			LOG_ERROR("UIManager: failed to create the UI cache framebuffer");
+			DestroyCache();
+			return false;
+		}
+
+		// Pixel for pixel: nearest
+		if (m_CacheSampler == VK_NULL_HANDLE)
+		{
+			VkSamplerCreateInfo samplerInfo{};
+			samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			samplerInfo.magFilter = VK_FILTER_NEAREST;
+			samplerInfo.minFilter = VK_FILTER_NEAREST;
+			samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+			samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			m_CacheSampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		}
+
+		if (m_CacheSet == VK_NULL_HANDLE)
+		{
+			VkDescriptorSetAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocInfo.descriptorPool = m_DescriptorPool;
+			allocInfo.descriptorSetCount = 1;
+			allocInfo.pSetLayouts = &m_TextureSetLayout;
+			if (vkAllocateDescriptorSets(device, &allocInfo, &m_CacheSet) != VK_SUCCESS)
+			{
+				LOG_ERROR("UIManager: failed to allocate the UI cache descriptor set");
+				m_CacheSet = VK_NULL_HANDLE;
+				DestroyCache();
+				return false;
+			}
+		}
+
+		VkDescriptorImageInfo imageDescriptor{ m_CacheSampler, m_CacheView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_CacheSet;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo = &imageDescriptor;
+		vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+
+		m_CacheValid = false;
+		m_Cache.Invalidate();
+		LOG_INFO("UI cache created ({}x{})", m_Extent.width, m_Extent.height);
+		return true;
+	}
+
+	// The descriptor set stays allocated (it goes with the pool) and is
+	// rewritten by the next CreateCache
+	void UIManager::DestroyCache()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_CacheFramebuffer != VK_NULL_HANDLE)
+		{
+			vkDestroyFramebuffer(device, m_CacheFramebuffer, nullptr);
+			m_CacheFramebuffer = VK_NULL_HANDLE;
+		}
+		if (m_CacheView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, m_CacheView, nullptr);
+			m_CacheView = VK_NULL_HANDLE;
+		}
+		if (m_CacheImage)
 		{
-			ImGui_ImplVulkan_RenderDrawData(draw_data, commandBuffer);
+			m_MemoryManager->DestroyImage(m_CacheImage);
+			m_CacheImage = nullptr;
 		}
+		m_CacheValid = false;
 	}
 
 	bool UIManager::CreateDescriptorPool(VkDevice device)
@@ -3,12 +3,27 @@
 //
 // Manages ImGui integration
 // Handles UI rendering and descriptor pool management
+//
+// ImGui's Vulkan backend creates and updates the textures (the font atlas,
+// ImGui_ImplVulkan_AddTexture images); the draw lists are recorded here, with
+// vertices and indices written into a persistently mapped buffer per frame in
+// flight instead of the backend's map/unmap every frame.
+//
+// With UIOverlaySettings::cached the UI is drawn into a texture of its own,
+// only on the frames UIOverlayCache rebuilds it, and composited over every
+// frame in the post-process pass.
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Renderer/UIOverlayCache.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
 #include <vulkan/vulkan.h>
+#include <array>
 #include <cstdint>
 
+struct ImDrawData;
+
 namespace Nightbloom
 {
 	// Forward declarations
@@ -20,30 +35,94 @@ namespace Nightbloom
 		UIManager() = default;
 		~UIManager() = default;
 
-		// Lifecycle
-		bool Initialize(VulkanDevice* device, void* windowHandle, VkRenderPass renderPass, uint32_t imageCount);
+		// Lifecycle. The UI is drawn in the post-process pass: renderPass, or
+		// with VK_NULL_HANDLE dynamic rendering into a colorFormat attachment.
+		// extent is the swapchain's.
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager, void* windowHandle,
+			VkRenderPass renderPass, uint32_t imageCount, VkFormat colorFormat, VkExtent2D extent);
 		void Cleanup(VkDevice device);
 
-		// Frame operations
+		// Frame operations. BeginFrame decides whether the UI is rebuilt this
+		// frame (always, uncached); only then is an ImGui frame open for the
+		// app to build into and does EndFrame render it.
 		void BeginFrame();
 		void EndFrame();
+		bool IsFrameActive() const { return m_FrameActive; }
+
+		// Cached, on a rebuilt frame: draws the UI into the cache texture.
+		// Outside any render pass, before the post-process pass.
+		bool NeedsCacheRecord() const;
+		void RecordCache(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+		// Inside the post-process pass: the UI's draws, or the cache laid
+		// over the frame
+		void Render(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+		// New swapchain size. Recreates the cache, so the frames still
+		// reading it must have finished.
+		void Resize(VkExtent2D extent);
 
-		// Render ImGui draw data to command buffer
-		void Render(VkCommandBuffer commandBuffer);
+		void SetSettings(const UIOverlaySettings& settings);
+		const UIOverlaySettings& GetSettings() const { return m_Cache.GetSettings(); }
+		// Something the UI shows changed without input: rebuild it next frame
+		void RequestRefresh() { m_Cache.Invalidate(); }
+		uint32_t GetReusedFrames() const { return m_Cache.GetReusedFrames(); }
 
 		// status
 		bool IsInitialized() const { return m_Initialized; }
-		
+
 	private:
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
 		VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
 		bool m_Initialized = false;
+		bool m_FrameActive = false;
+
+		UIOverlayCache m_Cache;
+		VkFormat m_ColorFormat = VK_FORMAT_UNDEFINED;
+		VkExtent2D m_Extent = { 0, 0 };
+
+		// One set layout for every texture the UI samples; identical to the
+		// backend's, so its descriptor sets bind with these pipelines
+		VkDescriptorSetLayout m_TextureSetLayout = VK_NULL_HANDLE;
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;            // post-process pass
+		VkPipeline m_CachePipeline = VK_NULL_HANDLE;       // cache render pass
+		VkPipeline m_CompositePipeline = VK_NULL_HANDLE;   // post-process pass
+
+		// The cache: created when caching is first turned on and kept (unused)
+		// if it is turned off again, until the next resize
+		VkRenderPass m_CacheRenderPass = VK_NULL_HANDLE;
+		VulkanMemoryManager::ImageAllocation* m_CacheImage = nullptr;
+		VkImageView m_CacheView = VK_NULL_HANDLE;
+		VkFramebuffer m_CacheFramebuffer = VK_NULL_HANDLE;
+		VkDescriptorSet m_CacheSet = VK_NULL_HANDLE;
+		VkSampler m_CacheSampler = VK_NULL_HANDLE;   // owned by the sampler cache
+		bool m_CacheValid = false;                   // drawn into since it was created
+
+		// Vertices then indices, persistently mapped; a frame's buffer is
+		// only touched after its fence, so growing it needs no wait
+		struct FrameBuffer
+		{
+			VulkanMemoryManager::BufferAllocation* allocation = nullptr;
+			VkDeviceSize indexOffset = 0;
+		};
+		std::array<FrameBuffer, MAX_FRAMES_IN_FLIGHT> m_FrameBuffers{};
 
 		// helper methods
 		bool CreateDescriptorPool(VkDevice device);
+		bool CreatePipelines(VkRenderPass renderPass);
+		VkPipeline CreatePipeline(const char* vertexShader, const char* fragmentShader, bool imguiVertices,
+			bool premultiplied, VkRenderPass renderPass);
+		bool CreateCache();
+		void DestroyCache();
+		bool UploadDrawData(ImDrawData* drawData, uint32_t frameIndex);
+		void RecordDrawData(VkCommandBuffer commandBuffer, ImDrawData* drawData, uint32_t frameIndex,
+			VkPipeline pipeline);
 
 		// prevent copying
 		UIManager(const UIManager&) = delete;
 		UIManager& operator=(const UIManager&) = delete;
 	};
 
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
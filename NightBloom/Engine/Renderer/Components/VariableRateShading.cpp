@@ -0,0 +1,284 @@
+//------------------------------------------------------------------------------
+// VariableRateShading.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/VariableRateShading.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t SHADING_RATE_LOCAL_SIZE = 8;  // ShadingRate.comp
+
+		// Matches PushConstants in ShadingRate.comp
+		struct ShadingRatePushConstants
+		{
+			glm::ivec4 tile;
+			glm::ivec4 pyramid;
+			glm::vec4 params;
+		};
+		static_assert(sizeof(ShadingRatePushConstants) == 48, "Must match ShadingRate.comp");
+
+		uint32_t Log2(uint32_t value)
+		{
+			uint32_t log = 0;
+			while (value > 1)
+			{
+				value >>= 1;
+				++log;
+			}
+			return log;
+		}
+	}
+
+	bool VariableRateShading::Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager,
+		VkExtent2D texelSize)
+	{
+		m_Device = device;
+		m_DescriptorManager = descriptorManager;
+		m_TexelSize = texelSize;
+
+		m_ImageSet = m_DescriptorManager->AllocateComputeImageSet();
+		if (m_ImageSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("VariableRateShading: failed to allocate descriptor set");
+			return false;
+		}
+
+		// Without the pipeline Record still keeps the images at 1x1, which
+		// the render passes need either way
+		if (!CreatePipeline())
+			LOG_WARN("VariableRateShading: no rate pipeline, shading stays at full rate");
+
+		LOG_INFO("VariableRateShading initialized ({}x{} tiles)", m_TexelSize.width, m_TexelSize.height);
+		return true;
+	}
+
+	void VariableRateShading::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+
+		// The images are RenderPassManager's; the set goes back with the
+		// descriptor manager's pool
+		m_SceneImage = m_ReflectionImage = VK_NULL_HANDLE;
+		m_Device = nullptr;
+	}
+
+	void VariableRateShading::Resize(VkImage sceneImage, VkImageView sceneView, VkExtent2D extent,
+		VkImage reflectionImage)
+	{
+		m_SceneImage = sceneImage;
+		m_ReflectionImage = reflectionImage;
+		m_Extent = extent;
+		m_SceneInitialized = false;
+		m_ReflectionInitialized = false;
+		m_LastActive = false;
+		m_DescriptorManager->UpdateComputeImageSet(m_ImageSet, sceneView);
+	}
+
+	bool VariableRateShading::CreatePipeline()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(ShadingRatePushConstants);
+
+		std::array<VkDescriptorSetLayout, 2> setLayouts = {
+			m_DescriptorManager->GetComputeImageSetLayout(),
+			m_DescriptorManager->GetHiZSampleSetLayout()
+		};
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		layoutInfo.pSetLayouts = setLayouts.data();
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("VariableRateShading: failed to create pipeline layout");
+			return false;
+		}
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary("ShadingRate.comp.spv");
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("VariableRateShading: failed to load ShadingRate.comp.spv");
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("VariableRateShading: failed to create shader module");
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr,
+			&m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("VariableRateShading: failed to create compute pipeline");
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, "ShadingRate.comp.spv");
+		return true;
+	}
+
+	void VariableRateShading::Clear(VkCommandBuffer cmd, VkImage image, bool initialized)
+	{
+		// Last frame's pass read it as the attachment
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = initialized ? VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		// 0 = 1x1
+		VkClearColorValue fullRate{};
+		vkCmdClearColorImage(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &fullRate, 1, &barrier.subresourceRange);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	void VariableRateShading::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const OcclusionCuller* culler,
+		const ShadingRateInputs& inputs)
+	{
+		if (m_SceneImage == VK_NULL_HANDLE || m_Extent.width == 0)
+			return;
+
+		// The reflection pass always shades at full rate
+		if (!m_ReflectionInitialized && m_ReflectionImage != VK_NULL_HANDLE)
+		{
+			Clear(cmd, m_ReflectionImage, false);
+			m_ReflectionInitialized = true;
+		}
+
+		// One pyramid texel per tile at mip log2(tile) - 1 (mip 0 is half
+		// the depth buffer); square tiles only
+		const uint32_t mip = Log2(m_TexelSize.width) - 1;
+		const bool pyramid = culler && culler->HasPyramid() && m_TexelSize.width == m_TexelSize.height &&
+			m_TexelSize.width >= 2 && mip < culler->GetMipCount();
+		const bool vignette = inputs.vignetteStrength > 0.0f && inputs.vignetteDarkening > 0.0f;
+		const bool active = inputs.enabled && dispatcher && culler && m_Pipeline != VK_NULL_HANDLE &&
+			(pyramid || vignette);
+
+		if (!active)
+		{
+			// Already all 1x1 since the last time it was built
+			if (!m_SceneInitialized || m_LastActive)
+				Clear(cmd, m_SceneImage, m_SceneInitialized);
+			m_SceneInitialized = true;
+			m_LastActive = false;
+			return;
+		}
+
+		const VkExtent2D tiles = {
+			std::clamp((inputs.renderExtent.width + m_TexelSize.width - 1) / m_TexelSize.width, 1u, m_Extent.width),
+			std::clamp((inputs.renderExtent.height + m_TexelSize.height - 1) / m_TexelSize.height, 1u, m_Extent.height) };
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = m_SceneInitialized
+			? VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR
+			: VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_SceneImage;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		ShadingRatePushConstants push{};
+		push.tile = glm::ivec4(static_cast<int>(tiles.width), static_cast<int>(tiles.height),
+			static_cast<int>(mip), pyramid ? 1 : 0);
+		if (pyramid)
+		{
+			const VkExtent2D built = culler->GetBuiltExtent();
+			push.pyramid = glm::ivec4(
+				static_cast<int>(std::max(built.width >> mip, 1u)),
+				static_cast<int>(std::max(built.height >> mip, 1u)), 0, 0);
+		}
+		push.params = glm::vec4(
+			inputs.nearPlane / std::max(inputs.coarseDistance, inputs.nearPlane),
+			vignette ? inputs.vignetteStrength : 0.0f,
+			inputs.vignetteDarkening, 0.0f);
+
+		// Set 1 is only read with a pyramid, but bound either way
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSets(cmd, m_PipelineLayout, 0, { m_ImageSet, culler->GetPyramidSampleSet() });
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(tiles.width, SHADING_RATE_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(tiles.height, SHADING_RATE_LOCAL_SIZE));
+
+		// -> this frame's scene pass
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		m_SceneInitialized = true;
+		m_LastActive = true;
+	}
+}
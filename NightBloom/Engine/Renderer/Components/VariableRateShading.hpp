@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// VariableRateShading.hpp
+//
+// Coarse shading for the outdoor scene through VK_KHR_fragment_shading_rate.
+// RenderPassManager gives the scene and reflection passes a shading-rate
+// attachment (one r8ui texel per tile); pipelines created with
+// PipelineConfig::coarseShading take their rate from it, the rest keep
+// shading every pixel. Record, before the scene pass, fills the scene's
+// image (ShadingRate.comp): 2x2 where a tile is all sky or farther than
+// coarseDistance - read from OcclusionCuller's nearest-depth pyramid layer
+// - or lies under a heavy vignette; 1x1 elsewhere. The reflection pass's
+// image stays 1x1.
+//
+// Terrain, grass and the cloud composite opt in: far grass and terrain are a
+// few pixels per blade or texel anyway, and the clouds are a low-frequency
+// upsample of a lower-resolution raymarch. Model meshes, water, particles and
+// the post-process composite (FXAA, tonemap) keep full rate.
+//
+// Like the Hi-Z tests, the depth is one frame old: the 3x3 tile dilation
+// covers ordinary camera motion, and without a pyramid (first frame, camera
+// cut, resize) every tile is 1x1. Disabled, the image is cleared to 1x1, so
+// the attachment costs nothing but its read.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+	class OcclusionCuller;
+
+	// Per-frame inputs of Record
+	struct ShadingRateInputs
+	{
+		bool enabled = true;
+		float nearPlane = 0.1f;
+		float coarseDistance = 120.0f;      // view distance beyond which a tile shades 2x2
+		float vignetteStrength = 0.0f;      // PostProcessSettings::vignetteStrength
+		float vignetteDarkening = 0.3f;     // tiles the vignette darkens at least this much shade 2x2
+		VkExtent2D renderExtent = { 0, 0 };
+	};
+
+	class VariableRateShading
+	{
+	public:
+		VariableRateShading() = default;
+		~VariableRateShading() = default;
+
+		// texelSize: RenderPassManager::GetShadingRateTexelSize. The images
+		// are RenderPassManager's and passed to Resize whenever recreated.
+		bool Initialize(VulkanDevice* device, VulkanDescriptorManager* descriptorManager, VkExtent2D texelSize);
+		void Cleanup();
+
+		// Swapchain resize (or first use): the shading-rate images were
+		// recreated. Both are reset to 1x1 by the next Record.
+		void Resize(VkImage sceneImage, VkImageView sceneView, VkExtent2D extent, VkImage reflectionImage);
+
+		// Before the scene and reflection passes, outside any render pass.
+		// Leaves both images in FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL.
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const OcclusionCuller* culler,
+			const ShadingRateInputs& inputs);
+
+		// Whether the last Record built the image (false: cleared to 1x1).
+		// The saving shows in the Scene GPU profiler scope.
+		bool WasActive() const { return m_LastActive; }
+
+	private:
+		bool CreatePipeline();
+		void Clear(VkCommandBuffer cmd, VkImage image, bool initialized);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+		VkExtent2D m_TexelSize = { 0, 0 };
+
+		VkImage m_SceneImage = VK_NULL_HANDLE;
+		VkImage m_ReflectionImage = VK_NULL_HANDLE;
+		VkExtent2D m_Extent = { 0, 0 };     // in tiles
+		bool m_SceneInitialized = false;    // out of UNDEFINED
+		bool m_ReflectionInitialized = false;
+
+		// Set 0 = rate image (compute image layout), set 1 = Hi-Z pyramid
+		VkDescriptorSet m_ImageSet = VK_NULL_HANDLE;
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+
+		bool m_LastActive = false;
+
+		VariableRateShading(const VariableRateShading&) = delete;
+		VariableRateShading& operator=(const VariableRateShading&) = delete;
+	};
+}
@@ -0,0 +1,303 @@
+//------------------------------------------------------------------------------
+// WindField.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Components/WindField.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t WIND_LOCAL_SIZE = 8;  // WindField.comp
+		constexpr VkFormat WIND_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+		// Matches PushConstants in WindField.comp
+		struct WindFieldPushConstants
+		{
+			glm::ivec4 origin;   // xy = first world cell, zw = the same mod the resolution
+			glm::vec4 wave;      // xy = direction, z = speed, w = frequency
+			glm::vec4 gust;      // x = strength, y = speed, z = spacing, w = width
+			glm::vec4 params;    // x = time, y = texel size
+		};
+		static_assert(sizeof(WindFieldPushConstants) == 64, "Must match WindField.comp");
+
+		constexpr VkPipelineStageFlags SAMPLING_STAGES =
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+
+	bool WindField::Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+		VulkanDescriptorManager* descriptorManager)
+	{
+		m_Device = device;
+		m_MemoryManager = memoryManager;
+		m_DescriptorManager = descriptorManager;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;  // toroidal window
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		if (m_Sampler == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("WindField: failed to create sampler");
+			return false;
+		}
+
+		m_ImageSet = m_DescriptorManager->AllocateComputeImageSet();
+		if (m_ImageSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("WindField: failed to allocate descriptor set");
+			return false;
+		}
+
+		if (!CreateImage())
+			return false;
+
+		// Without the pipeline Record keeps the texture cleared to still air,
+		// which the scene shaders bind either way
+		if (!CreatePipeline())
+			LOG_WARN("WindField: no bake pipeline, the wind stays still");
+
+		m_DescriptorManager->UpdateWindFieldBinding(m_ImageView, m_Sampler);
+
+		LOG_INFO("WindField initialized ({}x{})", Wind::FIELD_RESOLUTION, Wind::FIELD_RESOLUTION);
+		return true;
+	}
+
+	void WindField::Cleanup()
+	{
+		if (!m_Device)
+			return;
+
+		VkDevice device = m_Device->GetDevice();
+		if (m_Pipeline != VK_NULL_HANDLE)
+		{
+			vkDestroyPipeline(device, m_Pipeline, nullptr);
+			m_Pipeline = VK_NULL_HANDLE;
+		}
+		if (m_PipelineLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+			m_PipelineLayout = VK_NULL_HANDLE;
+		}
+		if (m_ImageView != VK_NULL_HANDLE)
+		{
+			vkDestroyImageView(device, m_ImageView, nullptr);
+			m_ImageView = VK_NULL_HANDLE;
+		}
+		if (m_ImageAllocation)
+		{
+			m_MemoryManager->DestroyImage(static_cast<VulkanMemoryManager::ImageAllocation*>(m_ImageAllocation));
+			m_ImageAllocation = nullptr;
+		}
+		m_Sampler = VK_NULL_HANDLE;  // owned by the sampler cache
+
+		m_Image = VK_NULL_HANDLE;
+		m_Initialized = false;
+		m_Device = nullptr;
+	}
+
+	bool WindField::CreateImage()
+	{
+		VulkanMemoryManager::ImageCreateInfo imageInfo{};
+		imageInfo.width = Wind::FIELD_RESOLUTION;
+		imageInfo.height = Wind::FIELD_RESOLUTION;
+		imageInfo.format = WIND_FORMAT;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageInfo.category = GpuMemoryCategory::Effects;
+		imageInfo.debugName = "WindField";
+
+		auto* allocation = m_MemoryManager->CreateImage(imageInfo);
+		if (!allocation)
+		{
+			LOG_ERROR("WindField: failed to create the field texture");
+			return false;
+		}
+		m_ImageAllocation = allocation;
+		m_Image = allocation->image;
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_Image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = WIND_FORMAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(m_Device->GetDevice(), &viewInfo, nullptr, &m_ImageView) != VK_SUCCESS)
+		{
+			LOG_ERROR("WindField: failed to create the field view");
+			return false;
+		}
+
+		m_DescriptorManager->UpdateComputeImageSet(m_ImageSet, m_ImageView);
+		return true;
+	}
+
+	bool WindField::CreatePipeline()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPushConstantRange range{};
+		range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		range.size = sizeof(WindFieldPushConstants);
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetComputeImageSetLayout();
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &setLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &range;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("WindField: failed to create pipeline layout");
+			return false;
+		}
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary("WindField.comp.spv");
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("WindField: failed to load WindField.comp.spv");
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("WindField: failed to create shader module");
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr,
+			&m_Pipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("WindField: failed to create compute pipeline");
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, "WindField.comp.spv");
+		return true;
+	}
+
+	void WindField::Clear(VkCommandBuffer cmd)
+	{
+		// Last frame's scene passes sampled it
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = m_Initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_Image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, SAMPLING_STAGES, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkClearColorValue still{};
+		vkCmdClearColorImage(cmd, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &still, 1, &barrier.subresourceRange);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, SAMPLING_STAGES,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	void WindField::Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const WindSettings& settings,
+		const glm::vec2& cameraXZ, float time)
+	{
+		if (m_Image == VK_NULL_HANDLE)
+			return;
+
+		const bool active = settings.enabled && settings.texelSize > 0.0f && dispatcher &&
+			m_Pipeline != VK_NULL_HANDLE;
+		if (!active)
+		{
+			// Already still since the last bake
+			if (!m_Still)
+				Clear(cmd);
+			m_Initialized = true;
+			m_Still = true;
+			return;
+		}
+
+		const glm::ivec2 origin = Wind::FieldOrigin(cameraXZ, settings.texelSize);
+		const uint32_t resolution = Wind::FIELD_RESOLUTION;
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = m_Initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = m_Image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, SAMPLING_STAGES, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		const glm::vec2 direction = Wind::Direction(settings);
+		WindFieldPushConstants push{};
+		const glm::ivec2 wrapped = (origin % static_cast<int>(resolution) + static_cast<int>(resolution)) %
+			static_cast<int>(resolution);
+		push.origin = glm::ivec4(origin, wrapped);
+		push.wave = glm::vec4(direction, settings.speed, settings.frequency);
+		push.gust = glm::vec4(settings.gustStrength, settings.gustSpeed, settings.gustSpacing, settings.gustWidth);
+		push.params = glm::vec4(time, settings.texelSize, 0.0f, 0.0f);
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, m_ImageSet);
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(push));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(resolution, WIND_LOCAL_SIZE),
+			ComputeDispatcher::CalculateGroupCount(resolution, WIND_LOCAL_SIZE));
+
+		// -> this frame's shadow, reflection and scene passes
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, SAMPLING_STAGES,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		m_Initialized = true;
+		m_Still = false;
+	}
+}
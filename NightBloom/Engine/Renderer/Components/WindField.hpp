@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+// WindField.hpp
+//
+// The scene's wind (Wind.hpp) baked into a 64x64 rgba16f texture around the
+// camera every frame by WindField.comp: rg = the sway phasor, b = the gust
+// push. It is bound at set 0 binding 2 of every scene-pass uniform set (the
+// camera's, each shadow cascade's and the reflection's), so grass and the
+// water ripples read the wind with one fetch (wind_field.glsl) and agree on
+// where a gust is. FrameUniformData::windField (Wind::FieldWindow) says where
+// the window sits.
+//
+// The texture is toroidal (see Wind.hpp): the camera moving changes which
+// world cells the texels hold, never the uv a world position samples. The
+// whole window is rebuilt each frame - 4096 texels of a few sines.
+// Disabled (or without compute), it is cleared to still air once and the
+// shaders skip the fetch.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/VFX/Wind.hpp"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanDescriptorManager;
+	class ComputeDispatcher;
+
+	class WindField
+	{
+	public:
+		WindField() = default;
+		~WindField() = default;
+
+		// Also writes the texture into every uniform-layout set (binding 2)
+		bool Initialize(VulkanDevice* device, VulkanMemoryManager* memoryManager,
+			VulkanDescriptorManager* descriptorManager);
+		void Cleanup();
+
+		// Before the shadow, reflection and scene passes, outside any render
+		// pass. Leaves the texture sampler-ready for vertex and fragment shaders.
+		void Record(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, const WindSettings& settings,
+			const glm::vec2& cameraXZ, float time);
+
+		// Whether Record bakes the wind (false: the texture stays still air,
+		// so FrameUniformData::windField.w must be 0)
+		bool CanBake() const { return m_Pipeline != VK_NULL_HANDLE; }
+
+		VkImage GetImage() const { return m_Image; }
+
+	private:
+		bool CreateImage();
+		bool CreatePipeline();
+		void Clear(VkCommandBuffer cmd);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		VkImage m_Image = VK_NULL_HANDLE;
+		void* m_ImageAllocation = nullptr;   // VulkanMemoryManager::ImageAllocation*
+		VkImageView m_ImageView = VK_NULL_HANDLE;
+		VkSampler m_Sampler = VK_NULL_HANDLE;  // linear, repeat
+		bool m_Initialized = false;            // out of UNDEFINED
+		bool m_Still = false;                  // cleared to still air since the last bake
+
+		VkDescriptorSet m_ImageSet = VK_NULL_HANDLE;  // storage image for the bake
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline m_Pipeline = VK_NULL_HANDLE;
+
+		WindField(const WindField&) = delete;
+		WindField& operator=(const WindField&) = delete;
+	};
+}
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+// ContactShadow.hpp
+//
+// Screen-space contact shadows: the short-range shadowing the cascades
+// can't afford - grass blades on each other and on the ground, small props,
+// creases - at a fixed cost per pixel however many instances are drawn.
+// After the scene pass the ContactShadows component marches a few world
+// units from every pixel toward lights[0] through this frame's depth
+// buffer; a depth sample in front of the ray (by less than `thickness`)
+// occludes it. The scene color is then darkened by the share of its light
+// that came straight from that light, estimated from the surface's normal
+// (rebuilt from depth) against the ambient - there is no G-buffer to take
+// the direct term out exactly.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	struct ContactShadowSettings
+	{
+		bool enabled = true;
+		float length = 0.75f;        // world units marched toward the light
+		float thickness = 0.2f;      // how far behind a depth sample the ray is still blocked (world units)
+		float strength = 0.8f;       // share of the direct light removed where fully blocked
+		float maxDistance = 60.0f;   // fades out by this far from the camera (world units)
+		uint32_t steps = 12;         // samples along the march
+	};
+
+	// ContactShadows' push constants; mirrors ContactShadowParams in contact_shadow.glsl
+	struct ContactShadowData
+	{
+		glm::vec4 light = glm::vec4(0.0f);     // xyz = toward the light in view space, w = march length
+		glm::vec4 params = glm::vec4(0.0f);    // x = thickness, y = strength, z = max distance, w = steps
+		glm::vec4 direct = glm::vec4(0.0f);    // rgb = the light's colour times intensity
+		glm::vec4 ambient = glm::vec4(0.0f);   // rgb = the scene's ambient light
+		glm::ivec4 extents = glm::ivec4(0);    // xy = render extent
+	};
+	static_assert(sizeof(ContactShadowData) == 80, "Must match ContactShadowParams in contact_shadow.glsl");
+
+	class ContactShadow
+	{
+	public:
+		static constexpr uint32_t MAX_STEPS = 32;
+
+		// Whether the pass would change anything: on, with a lit light to
+		// cast from
+		static bool IsActive(const ContactShadowSettings& settings, const glm::vec3& lightColor)
+		{
+			return settings.enabled && settings.strength > 0.0f && settings.length > 0.0f &&
+				glm::dot(lightColor, lightColor) > 0.0f;
+		}
+
+		// towardLight in world space; view is the camera the depth buffer
+		// was drawn with; renderExtent the part of the targets it covered
+		static ContactShadowData Build(const ContactShadowSettings& settings, const glm::mat4& view,
+			const glm::vec3& towardLight, const glm::vec3& lightColor, const glm::vec3& ambient,
+			glm::uvec2 renderExtent)
+		{
+			ContactShadowData data;
+			const float length = glm::length(towardLight);
+			const glm::vec3 world = length > 0.0f ? towardLight / length : glm::vec3(0.0f, 1.0f, 0.0f);
+			const glm::vec3 viewDir = glm::normalize(glm::vec3(view * glm::vec4(world, 0.0f)));
+			data.light = glm::vec4(viewDir, std::max(settings.length, 0.0f));
+			data.params = glm::vec4(std::max(settings.thickness, 0.0f), std::clamp(settings.strength, 0.0f, 1.0f),
+				std::max(settings.maxDistance, 0.0f),
+				static_cast<float>(std::clamp(settings.steps, 1u, MAX_STEPS)));
+			data.direct = glm::vec4(lightColor, 0.0f);
+			data.ambient = glm::vec4(ambient, 0.0f);
+			data.extents = glm::ivec4(static_cast<int>(renderExtent.x), static_cast<int>(renderExtent.y), 0, 0);
+			return data;
+		}
+	};
+}
@@ -0,0 +1,318 @@
+//------------------------------------------------------------------------------
+// DrawCommandSystem.cpp
+//
+// Draw list sort keys and the index radix sort
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Fibonacci hash of a handle/pointer down to `bits` bits. Only equality
+		// matters here (equal state lands adjacent after the sort).
+		uint64_t HashBits(uint64_t value, uint32_t bits)
+		{
+			if (value == 0)
+				return 0;
+			return (value * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+		}
+
+		uint64_t MaterialIdentity(const DrawCommand& cmd)
+		{
+			if (cmd.textureDescriptorSet != VK_NULL_HANDLE)
+				return reinterpret_cast<uint64_t>(cmd.textureDescriptorSet);
+			if (cmd.pushBuffers[0].buffer != VK_NULL_HANDLE)
+				return reinterpret_cast<uint64_t>(cmd.pushBuffers[0].buffer);
+			if (!cmd.textures.IsEmpty())
+				return reinterpret_cast<uint64_t>(cmd.textures[0]);
+			return reinterpret_cast<uint64_t>(cmd.heightmapDescriptorSet);
+		}
+
+		// Top bits of the IEEE-754 pattern of a non-negative float compare in the
+		// same order as the float itself, so they make a cheap log-scale bucket.
+		uint64_t DepthBucket(float distanceSq)
+		{
+			uint32_t bits = 0;
+			std::memcpy(&bits, &distanceSq, sizeof(bits));
+			return bits >> (32 - DrawSortKey::DEPTH_BITS);
+		}
+
+		// Everything bound or pushed for a draw apart from its transform
+		bool SameDrawState(const DrawCommand& a, const DrawCommand& b)
+		{
+			if (a.pipeline != b.pipeline || a.vertexBuffer != b.vertexBuffer || a.indexBuffer != b.indexBuffer ||
+				a.vertexFormat != b.vertexFormat)
+				return false;
+			if (a.textureDescriptorSet != b.textureDescriptorSet ||
+				a.heightmapDescriptorSet != b.heightmapDescriptorSet)
+				return false;
+			for (uint32_t i = 0; i < DrawCommand::MAX_PUSH_BUFFERS; ++i)
+			{
+				const VkDescriptorBufferInfo& pa = a.pushBuffers[i];
+				const VkDescriptorBufferInfo& pb = b.pushBuffers[i];
+				if (pa.buffer != pb.buffer || pa.offset != pb.offset || pa.range != pb.range)
+					return false;
+			}
+			if (a.textures.GetCount() != b.textures.GetCount())
+				return false;
+			for (uint32_t i = 0; i < a.textures.GetCount(); ++i)
+			{
+				if (a.textures[i] != b.textures[i])
+					return false;
+			}
+			return a.cameraVisible == b.cameraVisible && a.auxViewMask == b.auxViewMask &&
+				a.hasPushConstants == b.hasPushConstants &&
+				a.pushConstants.customData == b.pushConstants.customData &&
+				a.pushConstants.materialIndex == b.pushConstants.materialIndex;
+		}
+
+		// Everything but the transform has to match for two draws to become
+		// instances of one. Only Mesh merges, and Transparent under OIT:
+		// otherwise it must keep its back-to-front order per object.
+		bool CanInstanceTogether(const DrawCommand& a, const DrawCommand& b, bool orderIndependent)
+		{
+			const bool mergeable = a.pipeline == PipelineType::Mesh ||
+				(orderIndependent && a.pipeline == PipelineType::Transparent);
+			if (!mergeable || !SameDrawState(a, b))
+				return false;
+			return a.indexCount == b.indexCount && a.vertexCount == b.vertexCount &&
+				a.firstIndex == b.firstIndex && a.vertexOffset == b.vertexOffset;
+		}
+
+		void MergeBounds(DrawCommand& head, const DrawCommand& cmd)
+		{
+			if (!head.hasBounds || !cmd.hasBounds)
+			{
+				head.hasBounds = false;
+				return;
+			}
+			glm::vec3 minCorner = glm::min(head.bounds.center - head.bounds.extents, cmd.bounds.center - cmd.bounds.extents);
+			glm::vec3 maxCorner = glm::max(head.bounds.center + head.bounds.extents, cmd.bounds.center + cmd.bounds.extents);
+			head.bounds.center = (minCorner + maxCorner) * 0.5f;
+			head.bounds.extents = (maxCorner - minCorner) * 0.5f;
+		}
+	}
+
+	uint64_t DrawSortKey::Build(const DrawCommand& cmd, const glm::vec3& cameraPosition, bool useDepth,
+		bool orderIndependent)
+	{
+		const uint64_t pipeline = PipelineSlot(cmd.pipeline);
+		const uint64_t material = HashBits(
+			MaterialIdentity(cmd) ^ reinterpret_cast<uint64_t>(cmd.heightmapDescriptorSet), MATERIAL_BITS);
+		// Arena meshes share one buffer, so the range is what tells them apart
+		// (and keeps copies of one mesh adjacent for instancing)
+		const uint64_t geometry = reinterpret_cast<uint64_t>(cmd.vertexBuffer) ^
+			(static_cast<uint64_t>(static_cast<uint32_t>(cmd.vertexOffset)) << 32 | cmd.firstIndex);
+		const uint64_t vertexBuffer = HashBits(geometry, VERTEX_BUFFER_BITS);
+
+		uint64_t depth = 0;
+		if (useDepth && cmd.hasPushConstants)
+		{
+			glm::vec3 toObject = glm::vec3(cmd.pushConstants.model[3]) - cameraPosition;
+			depth = DepthBucket(glm::dot(toObject, toObject));
+		}
+
+		uint64_t key = pipeline << (64 - PIPELINE_BITS);
+		if (IsBackToFront(cmd.pipeline, orderIndependent))
+		{
+			const uint64_t farFirst = (~depth) & ((1ull << DEPTH_BITS) - 1);
+			key |= farFirst << (MATERIAL_BITS + VERTEX_BUFFER_BITS);
+			key |= material << VERTEX_BUFFER_BITS;
+			key |= vertexBuffer;
+		}
+		else
+		{
+			key |= material << (VERTEX_BUFFER_BITS + DEPTH_BITS);
+			key |= vertexBuffer << DEPTH_BITS;
+			key |= depth;
+		}
+		return key;
+	}
+
+	void DrawList::SortImpl(const glm::vec3& cameraPosition, bool useDepth)
+	{
+		m_PrepassOrder.clear();
+
+		const size_t count = m_Commands.size();
+		if (count < 2)
+			return;
+
+		m_SortKeys.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_Commands[i].sortKey = DrawSortKey::Build(m_Commands[i], cameraPosition, useDepth,
+				m_OrderIndependentTransparency);
+			m_SortKeys[i] = m_Commands[i].sortKey;
+		}
+
+		// LSD radix sort of the index list, one byte per pass. All eight
+		// histograms come from a single scan; a pass whose byte is identical
+		// across every key (common for the high material/depth bytes) is skipped.
+		std::array<std::array<uint32_t, 256>, 8> histograms{};
+		for (uint64_t key : m_SortKeys)
+		{
+			for (uint32_t pass = 0; pass < 8; ++pass)
+				++histograms[pass][(key >> (pass * 8)) & 0xFF];
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			m_Order[i] = static_cast<uint32_t>(i);
+		m_SortScratch.resize(count);
+
+		for (uint32_t pass = 0; pass < 8; ++pass)
+		{
+			auto& histogram = histograms[pass];
+			const uint32_t shift = pass * 8;
+
+			if (histogram[(m_SortKeys[0] >> shift) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram)
+			{
+				uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (uint32_t index : m_Order)
+				m_SortScratch[histogram[(m_SortKeys[index] >> shift) & 0xFF]++] = index;
+
+			m_Order.swap(m_SortScratch);
+		}
+	}
+
+	uint32_t DrawList::BuildInstanceBatches(InstanceData* instances, uint32_t capacity)
+	{
+		uint32_t written = 0;
+		size_t kept = 0;
+		bool warnedFull = false;
+		DrawCommand* batchHead = nullptr;
+
+		for (size_t i = 0; i < m_Order.size(); ++i)
+		{
+			const uint32_t index = m_Order[i];
+			DrawCommand& cmd = m_Commands[index];
+
+			if (!UsesInstanceBuffer(cmd.pipeline) && !cmd.instanceData)
+			{
+				m_Order[kept++] = index;
+				continue;
+			}
+
+			const uint32_t count = std::max(cmd.instanceCount, 1u);
+			if (!instances || written + count > capacity)
+			{
+				if (!warnedFull)
+				{
+					LOG_WARN("Instance buffer full ({} instances) - dropping remaining instanced draws", capacity);
+					warnedFull = true;
+				}
+				cmd.instanceCount = 0;
+				m_Order[kept++] = index;
+				batchHead = nullptr;
+				continue;
+			}
+
+			if (cmd.instanceData)
+			{
+				std::memcpy(instances + written, cmd.instanceData, count * sizeof(InstanceData));
+			}
+			else
+			{
+				for (uint32_t k = 0; k < count; ++k)
+					instances[written + k].model = cmd.pushConstants.model;
+			}
+
+			// Extend the current run: its instances are contiguous because
+			// nothing else has written to the buffer since the head did.
+			if (batchHead && count == 1 && !cmd.instanceData &&
+				CanInstanceTogether(*batchHead, cmd, m_OrderIndependentTransparency))
+			{
+				MergeBounds(*batchHead, cmd);
+				++batchHead->instanceCount;
+				++written;
+				continue;
+			}
+
+			cmd.firstInstance = written;
+			cmd.instanceCount = count;
+			written += count;
+			m_Order[kept++] = index;
+			batchHead = (count == 1 && !cmd.instanceData) ? &cmd : nullptr;
+		}
+
+		m_Order.resize(kept);
+		return written;
+	}
+
+	uint32_t DrawList::CountInstanceSlots() const
+	{
+		uint32_t slots = 0;
+		for (uint32_t index : m_Order)
+		{
+			const DrawCommand& cmd = m_Commands[index];
+			if (UsesInstanceBuffer(cmd.pipeline) || cmd.instanceData)
+				slots += std::max(cmd.instanceCount, 1u);
+		}
+		return slots;
+	}
+
+	uint32_t DrawList::WriteIndirectDraws(IndexedIndirectDraw* out, uint32_t capacity) const
+	{
+		const uint32_t count = static_cast<uint32_t>(std::min<size_t>(m_Order.size(), capacity));
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const DrawCommand& cmd = GetCommand(i);
+			IndexedIndirectDraw& draw = out[i];
+			if (cmd.indexBuffer && cmd.indexCount > 0)
+			{
+				draw.indexCount = cmd.indexCount;
+				draw.instanceCount = cmd.instanceCount;
+				draw.firstIndex = cmd.firstIndex;
+				draw.vertexOffset = cmd.vertexOffset;
+				draw.firstInstance = cmd.firstInstance;
+			}
+			else
+			{
+				draw = IndexedIndirectDraw{};
+			}
+		}
+		return count;
+	}
+
+	uint32_t DrawList::BuildDepthPrepassOrder()
+	{
+		m_PrepassOrder.clear();
+		for (size_t i = 0; i < m_Order.size(); ++i)
+		{
+			if (IsDepthPrepassCandidate(GetCommand(i)))
+				m_PrepassOrder.push_back(static_cast<uint32_t>(i));
+		}
+
+		// Pipeline (in enum order, so Mesh leads), then format, then the
+		// depth bucket the opaque sort key already carries. Stable, so a
+		// tie keeps the color pass's order.
+		auto prepassKey = [this](uint32_t position)
+		{
+			const DrawCommand& cmd = GetCommand(position);
+			return static_cast<uint64_t>(cmd.pipeline) << 40 |
+				static_cast<uint64_t>(cmd.vertexFormat) << 32 |
+				DrawSortKey::GetOpaqueDepth(cmd.sortKey);
+		};
+		std::stable_sort(m_PrepassOrder.begin(), m_PrepassOrder.end(),
+			[&prepassKey](uint32_t a, uint32_t b) { return prepassKey(a) < prepassKey(b); });
+
+		return static_cast<uint32_t>(m_PrepassOrder.size());
+	}
+
+	bool DrawList::CanDrawIndirectTogether(const DrawCommand& a, const DrawCommand& b)
+	{
+		return IsIndirectCandidate(a) && IsIndirectCandidate(b) && SameDrawState(a, b);
+	}
+}
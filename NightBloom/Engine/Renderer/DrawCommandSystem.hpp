@@ -8,16 +8,24 @@
 #pragma once
 
 #include "Engine/Renderer/PipelineInterface.hpp"
+#include "Engine/Renderer/Atmosphere.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Terrain/TerrainVirtualTexture.hpp"
+#include "Engine/Terrain/TerrainSunShadow.hpp"
 #include <glm/glm.hpp>
 #include <vector>
-#include <functional>
+#include <array>
 #include <variant>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 
 #include "Engine/Renderer/Model.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/LinearAllocator.hpp"
 
 namespace Nightbloom
 {
@@ -38,6 +46,15 @@ namespace Nightbloom
 	{
 		glm::mat4 model = glm::mat4(1.0f);
 		glm::vec4 customData = glm::vec4(0.0f);  // For shader-specific data, no longer time
+
+		// Bindless mesh passes only: slots in the texture array / material
+		// table. textureIndex is filled in at record time from textures[0].
+		uint32_t textureIndex = UINT32_MAX;
+		uint32_t materialIndex = UINT32_MAX;
+		// Grids drawn without a vertex buffer (GridMesh.hpp): cells per side,
+		// for pipelines whose customData has no room for it (Water)
+		uint32_t gridQuads = 0;
+		uint32_t padding = 0;
 	};
 
 	struct FrameUniformData
@@ -53,56 +70,214 @@ namespace Nightbloom
 		// declare these fields are unaffected (they just don't read them).
 		glm::mat4 invView;
 		glm::mat4 invProj;
+		// x = the fraction of the reflection target the planar reflection pass
+		// renders into, yz = the uv extent reflectionLookup may land in (the
+		// region it was rendered into), w reserved
+		glm::vec4 reflection = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+		// Far-field grass, read by Terrain.frag (GrassFarFieldParams, see
+		// GrassSystem.hpp); farGrassLod.w = 0 turns it off
+		glm::vec4 farGrassLod = glm::vec4(0.0f);
+		glm::vec4 farGrassDensity = glm::vec4(0.0f);
+		glm::vec4 farGrassSlope = glm::vec4(0.0f);
+		// The wind field texture (set 0 binding 2, see WindField.hpp):
+		// windField = Wind::FieldWindow, w = 0 for still air; windDirection.xy
+		// = the unit heading in xz
+		glm::vec4 windField = glm::vec4(0.0f);
+		glm::vec4 windDirection = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+		// The sky (set 0 bindings 3-4, see AtmosphereLuts.hpp): sun.w = 0 when
+		// there is no atmosphere; skyColor.rgb = the clear colour, the sky's
+		// floor at night and its stand-in without one
+		AtmosphereParamsData atmosphere;
+		glm::vec4 skyColor = glm::vec4(0.0f);
+		// The cloud shadow map (set 0 binding 5, see CloudSystem.hpp): xy =
+		// window min corner (world xz), z = side (0 = no cloud shadows), w =
+		// the top of the cloud layer
+		glm::vec4 cloudShadow = glm::vec4(0.0f);
+		// The terrain's virtual texture pages (set 4 bindings 2-3 of the
+		// terrain draw, see TerrainVirtualTexture.hpp); config.w = 0 without
+		// one
+		TerrainVirtualTextureData terrainVirtual;
+		// The terrain's sun shadow map (set 0 binding 6, see
+		// TerrainSunShadow.hpp); window.z = 0 without one
+		TerrainSunShadowData terrainShadow;
+		// World position -> the water's reflection target uv, from the camera
+		// it was last rendered with (ReflectionSchedule::BuildLookup), so a
+		// reflection kept from an earlier frame reprojects to this one
+		glm::mat4 reflectionLookup = glm::mat4(1.0f);
+	};
+
+	// Fixed-capacity texture list so DrawCommand stays POD (no per-command heap
+	// allocation). Only slot 0 is bound today; the rest are headroom.
+	struct DrawTextureSlots
+	{
+		static constexpr uint32_t CAPACITY = 4;
+
+		void Add(Texture* texture)
+		{
+			if (m_Count < CAPACITY)
+				m_Slots[m_Count++] = texture;
+			else
+				LOG_WARN("DrawTextureSlots: more than {} textures on one draw, extra ignored", CAPACITY);
+		}
+		void Clear() { m_Count = 0; }
+
+		bool IsEmpty() const { return m_Count == 0; }
+		uint32_t GetCount() const { return m_Count; }
+		Texture* operator[](uint32_t index) const { return m_Slots[index]; }
+
+	private:
+		std::array<Texture*, CAPACITY> m_Slots{};
+		uint32_t m_Count = 0;
+	};
+
+	// Per-instance data read by Mesh.vert / Shadow.vert at gl_InstanceIndex
+	// (set 0, binding 1). std430-compatible.
+	struct InstanceData
+	{
+		glm::mat4 model = glm::mat4(1.0f);
+	};
+
+	// One entry of the multi-draw indirect buffer; same layout as
+	// VkDrawIndexedIndirectCommand (checked in CommandRecorder.cpp).
+	struct IndexedIndirectDraw
+	{
+		uint32_t indexCount = 0;
+		uint32_t instanceCount = 0;
+		uint32_t firstIndex = 0;
+		int32_t vertexOffset = 0;
+		uint32_t firstInstance = 0;
+	};
+
+	// World-space AABB of a draw, for culling passes that run after the list
+	// is built (the Hi-Z occlusion test, see OcclusionCuller).
+	struct DrawBounds
+	{
+		glm::vec3 center = glm::vec3(0.0f);
+		glm::vec3 extents = glm::vec3(0.0f);
 	};
 
-	// A single draw command
+	// A single draw command. Trivially copyable: draw lists are bulk-copied and
+	// live in per-frame arena memory that is never destructed element-wise.
 	struct DrawCommand
 	{
 		PipelineType pipeline = PipelineType::Mesh;
 
-		// Vertex data
+		// Vertex data. A Packed vertexFormat draws with the pipeline's packed
+		// variant (ResolvePipelineVariant); pipeline keeps the base type.
+		// Model meshes share their buffers (VulkanMeshArena) and are picked
+		// out by firstIndex/vertexOffset, so consecutive draws rebind nothing.
 		Buffer* vertexBuffer = nullptr;
+		VertexFormat vertexFormat = VertexFormat::Standard;
+		// Draw with the pipeline's tessellated twin (GetTessellatedPipeline):
+		// the index buffer's triangles become 3-point patches. Only set for
+		// pipelines the renderer has one for; pipeline keeps the base type.
+		bool tessellated = false;
 		Buffer* indexBuffer = nullptr;
 		uint32_t indexCount = 0;
 		uint32_t vertexCount = 0;  // For non-indexed draws
+		uint32_t firstIndex = 0;
+		int32_t vertexOffset = 0;
 
 		// Instance data
 		uint32_t instanceCount = 1;
 		uint32_t firstInstance = 0;
 
+		// Optional pre-built instance records (instanceCount slots of
+		// sizeof(InstanceData) bytes), copied into the instance buffer by
+		// BuildInstanceBatches for any pipeline instead of repeating
+		// pushConstants.model - e.g. TerrainSystem's CDLOD patches. Must stay
+		// valid until the list is built; such draws never merge.
+		const void* instanceData = nullptr;
+
+		// GPU-generated draws. When indirectBuffer is set the indexed draw
+		// parameters are read from it (VkDrawIndexedIndirectCommand at
+		// indirectOffset) and the number of draws from countBuffer at
+		// countOffset, up to maxDrawCount - see GrassSystem's cull pass. A
+		// non-indexed draw (vertexCount) reads one VkDrawIndirectCommand at
+		// indirectOffset and needs no count - see FireflySystem's cull.
+		Buffer* indirectBuffer = nullptr;
+		Buffer* countBuffer = nullptr;
+		uint32_t indirectOffset = 0;
+		uint32_t countOffset = 0;
+		uint32_t maxDrawCount = 0;
+
 		// Camera-frustum visibility. Set false by Scene::BuildDrawList for objects culled
 		// against the CAMERA frustum. The main color pass skips these; the SHADOW and
 		// REFLECTION passes ignore the flag and still draw them, because a caster off-screen
 		// (behind/beside the camera) can still cast a shadow into view or appear in the water
-		// reflection. Culling shadow casters by the camera frustum is the classic CSM bug.
+		// reflection. Culling shadow casters by the camera frustum is the classic CSM bug;
+		// the shadow pass culls bounded draws against each cascade's own light volume instead.
 		bool cameraVisible = true;
 
+		// Auxiliary-view visibility (Renderer::SetAuxiliaryViews): bit v set
+		// when the draw touches auxiliary view v's frustum. Draws nobody
+		// culled keep every bit and appear in every view.
+		uint8_t auxViewMask = 0xFF;
+
+		// Optional world bounds (Scene fills them in for model objects). Only
+		// draws with bounds take part in occlusion culling; occlusionSlot is the
+		// draw's entry in the OcclusionCuller's per-frame indirect buffer, which
+		// the main color pass draws from instead of the direct parameters.
+		static constexpr uint32_t NO_OCCLUSION_SLOT = UINT32_MAX;
+		bool hasBounds = false;
+		DrawBounds bounds;
+		uint32_t occlusionSlot = NO_OCCLUSION_SLOT;
+
+		// Meshlets of the full-detail mesh (Mesh::GetFirstMeshlet, in the mesh
+		// arena's meshlet buffer). A draw that MeshletCuller takes gets a job:
+		// the main color pass then draws its surviving meshlets from
+		// meshletDrawBase on instead of the whole mesh, and it is left out of
+		// the whole-mesh occlusion test. Other passes draw the mesh as usual.
+		static constexpr uint32_t NO_MESHLET_JOB = UINT32_MAX;
+		uint32_t firstMeshlet = 0;
+		uint32_t meshletCount = 0;
+		uint32_t meshletJob = NO_MESHLET_JOB;
+		uint32_t meshletDrawBase = 0;
+
+		// Skinned draws: the mesh's skinning source (Mesh::GetSkinFirstVertex)
+		// and its joints' skin matrices in the list (DrawList::AddSkinJoints).
+		// SkinningSystem skins each distinct source and joint set once per
+		// frame and points vertexBuffer/vertexOffset at the result; without
+		// it the draw keeps the bind-pose vertices.
+		uint32_t skinFirstVertex = 0;
+		uint32_t skinVertexCount = 0;
+		uint32_t skinFirstJoint = 0;
+		uint32_t skinJointCount = 0;
+
 		// Push constants (optional)
 		bool hasPushConstants = false;
 		PushConstantData pushConstants;
 
-		// Textures (simplified for now - expand later)
-		std::vector<Texture*> textures;
+		// Textures (set 1 binds slot 0's own descriptor set)
+		DrawTextureSlots textures;
 
 		VkDescriptorSet heightmapDescriptorSet = VK_NULL_HANDLE;  // Set 4 — terrain only
-		VkDescriptorSet textureDescriptorSet = VK_NULL_HANDLE;  // Set 4 — terrain only
+		VkDescriptorSet textureDescriptorSet = VK_NULL_HANDLE;  // Set 4 for terrain, set 3 (wave maps) for water
 
-		// Custom render state overrides (optional)
-		std::function<void()> preDrawCallback = nullptr;  // Called before draw
-		std::function<void()> postDrawCallback = nullptr; // Called after draw
+		// Storage buffers pushed at bindings 0.. of the pipeline's storage set
+		// when that set is a push set (VulkanDescriptorManager::UsesPushDescriptors;
+		// Foliage only), in place of textureDescriptorSet. Unused entries stay null.
+		static constexpr uint32_t MAX_PUSH_BUFFERS = 2;
+		VkDescriptorBufferInfo pushBuffers[MAX_PUSH_BUFFERS] = {};
+
+		// Packed ordering key, filled in by DrawList::Sort (see DrawSortKey).
+		uint64_t sortKey = 0;
 	};
+	static_assert(std::is_trivially_copyable_v<DrawCommand>, "DrawCommand must stay POD");
 
 	// ============================================================================
 	// Drawable Interface - Objects that can be rendered
 	// ============================================================================
 
+	class DrawList;
+
 	class IDrawable
 	{
 	public:
 		virtual ~IDrawable() = default;
 
-		// Get draw commands for this object
-		virtual std::vector<DrawCommand> GetDrawCommands() const = 0;
+		// Write this object's draw commands straight into the list (DrawList::Emit)
+		virtual void EmitDrawCommands(DrawList& drawList) const = 0;
 
 		// Update any frame-dependent data
 		virtual void Update(float deltaTime) { (void)deltaTime; }
@@ -111,6 +286,418 @@ namespace Nightbloom
 		virtual bool IsVisible() const { return true; }
 	};
 
+	// ============================================================================
+	// Sort Keys
+	// ============================================================================
+
+	// 64-bit draw ordering key. Pipeline always occupies the top bits so the
+	// pass order implied by the PipelineType enum is unchanged (except the
+	// sky, which goes first: it paints the background the rest covers); the
+	// remaining bits group state inside a pipeline:
+	//
+	//   opaque:       [pipeline:6][material:24][vertexBuffer:18][depth:16]  (front-to-back)
+	//   transparent:  [pipeline:6][~depth:16][material:24][vertexBuffer:18] (back-to-front)
+	//
+	// With OIT on, transparent draws take the opaque layout: the blend no
+	// longer depends on their order.
+	//
+	// Material is a hash of whatever ends up at the texture set (explicit set,
+	// first texture, heightmap); a collision only costs a redundant bind.
+	// vertexBuffer hashes the buffer with firstIndex/vertexOffset, since arena
+	// meshes share their buffers.
+	struct DrawSortKey
+	{
+		static constexpr uint32_t PIPELINE_BITS = 6;
+		static constexpr uint32_t MATERIAL_BITS = 24;
+		static constexpr uint32_t VERTEX_BUFFER_BITS = 18;
+		static constexpr uint32_t DEPTH_BITS = 16;
+		static_assert(PIPELINE_BITS + MATERIAL_BITS + VERTEX_BUFFER_BITS + DEPTH_BITS == 64);
+		static_assert(static_cast<uint32_t>(PipelineType::Count) <= (1u << PIPELINE_BITS));
+
+		// orderIndependent: the list draws its transparents with weighted-
+		// blended OIT, so none of them need the back-to-front layout
+		static uint64_t Build(const DrawCommand& cmd, const glm::vec3& cameraPosition, bool useDepth,
+			bool orderIndependent = false);
+
+		// The pipeline's place in the pass: enum order, the sky first
+		static uint64_t PipelineSlot(PipelineType pipeline)
+		{
+			return pipeline == PipelineType::Skybox ? 0 : static_cast<uint64_t>(pipeline);
+		}
+
+		// Pipelines drawn back-to-front (blended over what is behind them),
+		// unless OIT makes the blend order-independent. Particle draws are
+		// whole emitters, sorted by their centre.
+		static bool IsBackToFront(PipelineType pipeline, bool orderIndependent = false)
+		{
+			return (pipeline == PipelineType::Transparent || pipeline == PipelineType::Particle) && !orderIndependent;
+		}
+
+		// Distance bucket of an opaque key (front-to-back, smaller is nearer)
+		static uint32_t GetOpaqueDepth(uint64_t key) { return static_cast<uint32_t>(key & ((1ull << DEPTH_BITS) - 1)); }
+	};
+
+	// ============================================================================
+	// LOD View - camera the drawables pick mesh LODs against
+	// ============================================================================
+
+	// A mesh LOD with geometric error e (object-space units) drawn at distance d
+	// is off by about e * pixelsPerUnit / d pixels; drawables take the coarsest
+	// level that stays within maxPixelError (see MeshLod.hpp). pixelsPerUnit is
+	// screenHeight / (2 tan(fovY / 2)); 0 disables LOD selection.
+	struct LodView
+	{
+		glm::vec3 position = glm::vec3(0.0f);
+		float pixelsPerUnit = 0.0f;
+		float maxPixelError = 1.0f;
+
+		bool IsEnabled() const { return pixelsPerUnit > 0.0f; }
+
+		// Pixels one world unit covers at distance (clamped so a camera
+		// inside the bounds gets full detail rather than a division by zero)
+		float PixelsPerUnitAt(float distance) const { return pixelsPerUnit / std::max(distance, 1e-3f); }
+
+		static LodView FromCamera(const glm::vec3& position, float fovYDegrees, float screenHeight, float maxPixelError = 1.0f)
+		{
+			LodView view;
+			view.position = position;
+			view.pixelsPerUnit = screenHeight / (2.0f * std::tan(glm::radians(fovYDegrees) * 0.5f));
+			view.maxPixelError = maxPixelError;
+			return view;
+		}
+	};
+
+	// ============================================================================
+	// Draw List - Accumulates draw commands for a frame
+	// ============================================================================
+
+	using DrawCommandVector = std::vector<DrawCommand, ArenaAllocator<DrawCommand>>;
+	using DrawIndexVector = std::vector<uint32_t, ArenaAllocator<uint32_t>>;
+	using SkinJointVector = std::vector<glm::mat4, ArenaAllocator<glm::mat4>>;
+
+	class DrawList
+	{
+	public:
+		DrawList() = default;
+
+		// Arena-backed list: all storage comes from `arena` (typically the
+		// Renderer's per-frame allocator) and must be released with
+		// ResetStorage() before that arena is reset.
+		explicit DrawList(LinearAllocator* arena)
+			: m_Commands(ArenaAllocator<DrawCommand>(arena))
+			, m_Order(ArenaAllocator<uint32_t>(arena))
+			, m_SortKeys(ArenaAllocator<uint64_t>(arena))
+			, m_SortScratch(ArenaAllocator<uint32_t>(arena))
+			, m_PrepassOrder(ArenaAllocator<uint32_t>(arena))
+			, m_SkinJoints(ArenaAllocator<glm::mat4>(arena))
+		{
+		}
+
+		// Append a default command in place and return it for the caller to
+		// fill in. The reference is invalidated by the next Emit/AddCommand.
+		DrawCommand& Emit()
+		{
+			m_Order.push_back(static_cast<uint32_t>(m_Commands.size()));
+			return m_Commands.emplace_back();
+		}
+
+		// Add a single draw command
+		void AddCommand(const DrawCommand& cmd)
+		{
+			PushCommand(cmd);
+		}
+
+		// Add commands from a drawable. cameraVisible=false keeps the commands in the list
+		// (so shadow/reflection passes still draw them) but flags them so the main color pass
+		// can skip them — used for objects culled against the camera frustum. bounds, when
+		// given, is the object's world AABB and is attached to every command it emits that
+		// has none of its own. auxViewMask is the same for the auxiliary views
+		// (DrawCommand::auxViewMask). Both only narrow what the drawable set per command,
+		// so a part it culled itself (IsPartVisible) stays culled.
+		void AddDrawable(const IDrawable* drawable, bool cameraVisible = true, const DrawBounds* bounds = nullptr,
+			uint8_t auxViewMask = 0xFF)
+		{
+			if (drawable && drawable->IsVisible())
+			{
+				size_t first = m_Commands.size();
+				m_TestParts = m_HasCullFrustum && cameraVisible;
+				drawable->EmitDrawCommands(*this);
+				m_TestParts = false;
+				for (size_t i = first; i < m_Commands.size(); ++i)
+				{
+					m_Commands[i].cameraVisible = m_Commands[i].cameraVisible && cameraVisible;
+					m_Commands[i].auxViewMask &= auxViewMask;
+					if (bounds && !m_Commands[i].hasBounds)
+					{
+						m_Commands[i].hasBounds = true;
+						m_Commands[i].bounds = *bounds;
+					}
+				}
+			}
+		}
+
+		// Camera frustum drawables cull their parts against while AddDrawable
+		// emits them (null = none). Scene::BuildDrawList sets it to its own
+		// frustum; kept by Clear/ResetStorage.
+		void SetCullFrustum(const Frustum* frustum)
+		{
+			m_HasCullFrustum = (frustum != nullptr);
+			if (frustum)
+				m_CullFrustum = *frustum;
+		}
+		const Frustum* GetCullFrustum() const { return m_HasCullFrustum ? &m_CullFrustum : nullptr; }
+
+		// Whether one part (world AABB) of the drawable AddDrawable is emitting
+		// is inside the cull frustum. True when there is nothing to test: no
+		// cull frustum, the whole object already culled, or called outside
+		// AddDrawable.
+		bool IsPartVisible(const glm::vec3& center, const glm::vec3& extents) const
+		{
+			return !m_TestParts || m_CullFrustum.Intersects(center, extents);
+		}
+
+		// Append another list's commands in its current order (for lists built
+		// in parallel chunks and merged before sorting)
+		void Append(const DrawList& other)
+		{
+			const uint32_t base = static_cast<uint32_t>(m_Commands.size());
+			const uint32_t jointBase = static_cast<uint32_t>(m_SkinJoints.size());
+			m_Commands.insert(m_Commands.end(), other.m_Commands.begin(), other.m_Commands.end());
+			for (uint32_t index : other.m_Order)
+				m_Order.push_back(base + index);
+
+			m_SkinJoints.insert(m_SkinJoints.end(), other.m_SkinJoints.begin(), other.m_SkinJoints.end());
+			if (jointBase > 0)
+			{
+				for (size_t i = base; i < m_Commands.size(); ++i)
+				{
+					if (m_Commands[i].skinJointCount > 0)
+						m_Commands[i].skinFirstJoint += jointBase;
+				}
+			}
+		}
+
+		// Copies a skinned drawable's skin matrices into the list and returns
+		// the first one's index for DrawCommand::skinFirstJoint. Copied, not
+		// referenced: the next simulation step poses the drawable again while
+		// this list renders (RenderSnapshot.hpp).
+		uint32_t AddSkinJoints(const glm::mat4* joints, uint32_t count)
+		{
+			const uint32_t first = static_cast<uint32_t>(m_SkinJoints.size());
+			m_SkinJoints.insert(m_SkinJoints.end(), joints, joints + count);
+			return first;
+		}
+		const SkinJointVector& GetSkinJoints() const { return m_SkinJoints; }
+
+		// Add a simple mesh with transform
+		void DrawMesh(Buffer* vertexBuffer, Buffer* indexBuffer, uint32_t indexCount,
+			PipelineType pipeline, const glm::mat4& transform)
+		{
+			DrawCommand cmd;
+			cmd.pipeline = pipeline;
+			cmd.vertexBuffer = vertexBuffer;
+			cmd.indexBuffer = indexBuffer;
+			cmd.indexCount = indexCount;
+			cmd.hasPushConstants = true;
+			cmd.pushConstants.model = transform;
+
+			// View and projection should be set elsewhere
+			PushCommand(cmd);
+		}
+
+		// Weighted-blended OIT (Renderer::SetOrderIndependentTransparency).
+		// Set before Sort; kept by Clear/ResetStorage. When on, Transparent
+		// draws sort like opaque ones (by material, no back-to-front order)
+		// and identical ones merge into instanced draws.
+		void SetOrderIndependentTransparency(bool enabled) { m_OrderIndependentTransparency = enabled; }
+		bool IsOrderIndependentTransparency() const { return m_OrderIndependentTransparency; }
+
+		// Camera for drawables' LOD selection. Set before emitting; kept by
+		// Clear/ResetStorage (default: LOD selection off, full detail).
+		void SetLodView(const LodView& view) { m_LodView = view; }
+		const LodView& GetLodView() const { return m_LodView; }
+
+		// Clear the list (keeps capacity)
+		void Clear()
+		{
+			m_Commands.clear();
+			m_Order.clear();
+			m_PrepassOrder.clear();
+			m_SkinJoints.clear();
+		}
+
+		// Drop all storage and rebind to `arena` (may be null for heap storage),
+		// reserving room for `reserveCount` commands up front. Called each frame
+		// before the arena is reset, so no pointers into it survive.
+		void ResetStorage(LinearAllocator* arena, size_t reserveCount = 0)
+		{
+			m_Commands = DrawCommandVector(ArenaAllocator<DrawCommand>(arena));
+			m_Order = DrawIndexVector(ArenaAllocator<uint32_t>(arena));
+			m_SortKeys = std::vector<uint64_t, ArenaAllocator<uint64_t>>(ArenaAllocator<uint64_t>(arena));
+			m_SortScratch = DrawIndexVector(ArenaAllocator<uint32_t>(arena));
+			m_PrepassOrder = DrawIndexVector(ArenaAllocator<uint32_t>(arena));
+			m_SkinJoints = SkinJointVector(ArenaAllocator<glm::mat4>(arena));
+			if (reserveCount > 0)
+			{
+				m_Commands.reserve(reserveCount);
+				m_Order.reserve(reserveCount);
+			}
+		}
+
+		// Get all commands, in submission order. Passes that care about draw
+		// order should walk GetCommand(i) instead.
+		const DrawCommandVector& GetCommands() const { return m_Commands; }
+
+		// Commands in sorted order (submission order until Sort is called)
+		size_t GetCommandCount() const { return m_Order.size(); }
+		const DrawCommand& GetCommand(size_t index) const { return m_Commands[m_Order[index]]; }
+		const DrawIndexVector& GetOrder() const { return m_Order; }
+
+		// Build each command's sort key and radix-sort the index list by it. Only
+		// the 4-byte indices move; the commands stay where they were submitted.
+		// The sort is stable, so equal keys keep submission order.
+		void Sort(const glm::vec3& cameraPosition) { SortImpl(cameraPosition, true); }
+
+		// Same ordering without the depth component (no camera available)
+		void SortByPipeline() { SortImpl(glm::vec3(0.0f), false); }
+
+		// Batching stage, run by the Renderer once the list is final (after
+		// Sort). Every command whose pipeline reads its transform from the
+		// instance buffer gets its model matrix written to `instances` and
+		// firstInstance pointed at it; runs of identical Mesh draws (same
+		// buffers, textures, custom data and visibility; Transparent too under
+		// OIT) collapse into the first command of the run as one instanced
+		// draw and drop out of the sorted order. Returns the number of instances written. Draws that do not fit
+		// in `capacity` are left with instanceCount = 0. A merged draw's bounds
+		// grow to cover every instance (or are dropped if any instance has none).
+		// Commands carrying their own instanceData are copied as-is.
+		uint32_t BuildInstanceBatches(InstanceData* instances, uint32_t capacity);
+
+		// Instance slots BuildInstanceBatches needs for the current list, so
+		// the caller can size the buffer first. Merging packs identical draws
+		// into adjacent slots but never saves one, so the count is exact.
+		uint32_t CountInstanceSlots() const;
+
+		// Multi-draw stage, run after BuildInstanceBatches: writes command i's
+		// indexed draw parameters (in sorted order) to out[i], so a run of
+		// adjacent commands is one contiguous range of the buffer. Commands
+		// that are not indexed get an empty entry. Returns the number written,
+		// at most `capacity`; runs must not reach past it.
+		uint32_t WriteIndirectDraws(IndexedIndirectDraw* out, uint32_t capacity) const;
+
+		// Sorted position one past the multi-draw run that starts at `begin`:
+		// the following commands before `end` that include(index) accepts and
+		// that CanDrawIndirectTogether with the first. With useOcclusionSlots
+		// the run also has to stay on consecutive occlusion slots (or on none),
+		// so it can be drawn straight from the OcclusionCuller's buffer, and
+		// draws with a meshlet job (drawn per meshlet) stay on their own.
+		template<typename Include>
+		size_t FindIndirectRun(size_t begin, size_t end, bool useOcclusionSlots, Include&& include) const
+		{
+			const DrawCommand& first = GetCommand(begin);
+			if (!IsIndirectCandidate(first))
+				return begin + 1;
+
+			size_t next = begin + 1;
+			for (; next < end; ++next)
+			{
+				if (!include(next))
+					break;
+				const DrawCommand& cmd = GetCommand(next);
+				if (!CanDrawIndirectTogether(first, cmd))
+					break;
+				if (useOcclusionSlots)
+				{
+					if (first.meshletJob != DrawCommand::NO_MESHLET_JOB || cmd.meshletJob != DrawCommand::NO_MESHLET_JOB)
+						break;
+					const bool firstTested = first.occlusionSlot != DrawCommand::NO_OCCLUSION_SLOT;
+					const uint32_t expected = firstTested
+						? first.occlusionSlot + static_cast<uint32_t>(next - begin)
+						: DrawCommand::NO_OCCLUSION_SLOT;
+					if (cmd.occlusionSlot != expected)
+						break;
+				}
+			}
+			return next;
+		}
+
+		// Indexed Mesh draws the CPU described itself; only these go into
+		// multi-draw runs
+		static bool IsIndirectCandidate(const DrawCommand& cmd)
+		{
+			return cmd.pipeline == PipelineType::Mesh && cmd.indexBuffer && cmd.indexCount > 0 &&
+				!cmd.indirectBuffer && !cmd.instanceData;
+		}
+
+		// Whether b can be drawn by a's multi-draw: everything bound or pushed
+		// matches, only the geometry range and the instances differ
+		static bool CanDrawIndirectTogether(const DrawCommand& a, const DrawCommand& b);
+
+		// Depth prepass stage, run last when the prepass is on: the sorted
+		// positions of the draws it covers (IsDepthPrepassCandidate), grouped
+		// by pipeline - meshes first, so they occlude the terrain and grass
+		// behind them - and front to back inside each group by the sort
+		// key's depth. Cleared by the next Sort. Returns the count.
+		uint32_t BuildDepthPrepassOrder();
+		const DrawIndexVector& GetDepthPrepassOrder() const { return m_PrepassOrder; }
+
+		// Camera-visible draws whose pipeline has a depth-only twin
+		// (GetDepthPrepassPipeline). Once prepassed, the color pass must draw
+		// every one of them with the EQUAL twin and the same geometry.
+		static bool IsDepthPrepassCandidate(const DrawCommand& cmd)
+		{
+			return cmd.cameraVisible &&
+				GetDepthPrepassPipeline(ResolvePipelineVariant(cmd.pipeline, cmd.vertexFormat)) != PipelineType::Count;
+		}
+
+		// Camera-visible draws whose pipeline has an OIT twin
+		// (GetOitPipeline): with OIT on they leave the color pass for the
+		// OIT pass.
+		static bool IsOrderIndependentCandidate(const DrawCommand& cmd)
+		{
+			return cmd.cameraVisible &&
+				GetOitPipeline(ResolvePipelineVariant(cmd.pipeline, cmd.vertexFormat)) != PipelineType::Count;
+		}
+
+		// Mutable access in sorted order, for the Renderer's post-build passes
+		// (occlusion slot assignment) that annotate commands in place.
+		DrawCommand& GetCommandMutable(size_t index) { return m_Commands[m_Order[index]]; }
+
+		// Pipelines whose vertex shader reads InstanceData instead of push.model
+		static bool UsesInstanceBuffer(PipelineType pipeline)
+		{
+			return pipeline == PipelineType::Mesh || pipeline == PipelineType::Transparent;
+		}
+
+	private:
+		void PushCommand(const DrawCommand& cmd)
+		{
+			m_Order.push_back(static_cast<uint32_t>(m_Commands.size()));
+			m_Commands.push_back(cmd);
+		}
+
+		void SortImpl(const glm::vec3& cameraPosition, bool useDepth);
+
+		DrawCommandVector m_Commands;
+		DrawIndexVector m_Order;
+
+		// Radix sort scratch
+		std::vector<uint64_t, ArenaAllocator<uint64_t>> m_SortKeys;
+		DrawIndexVector m_SortScratch;
+
+		// Sorted positions, see BuildDepthPrepassOrder
+		DrawIndexVector m_PrepassOrder;
+
+		// Skin matrices of the skinned draws, see AddSkinJoints
+		SkinJointVector m_SkinJoints;
+
+		LodView m_LodView;
+		bool m_OrderIndependentTransparency = false;
+		Frustum m_CullFrustum{};
+		bool m_HasCullFrustum = false;
+		bool m_TestParts = false;   // inside AddDrawable, for a camera-visible object
+	};
+
 	// ============================================================================
 	// Basic Drawable Implementations
 	// ============================================================================
@@ -124,9 +711,9 @@ namespace Nightbloom
 		{
 		}
 
-		std::vector<DrawCommand> GetDrawCommands() const override
+		void EmitDrawCommands(DrawList& drawList) const override
 		{
-			DrawCommand cmd;
+			DrawCommand& cmd = drawList.Emit();
 			cmd.pipeline = m_Pipeline;
 			cmd.vertexBuffer = m_VertexBuffer;
 			cmd.indexBuffer = m_IndexBuffer;
@@ -134,10 +721,22 @@ namespace Nightbloom
 			cmd.hasPushConstants = true;
 			cmd.pushConstants = m_PushConstants;
 
-			cmd.textures = m_Textures;
+			for (Texture* texture : m_Textures)
+				cmd.textures.Add(texture);
+		}
 
-			return { cmd };
+		// Object-space AABB of the geometry (the built-in primitives report
+		// theirs, see Renderer::GetTestCubeExtents). Scene culls the object
+		// by it once set.
+		void SetLocalBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+		{
+			m_BoundsMin = boundsMin;
+			m_BoundsMax = boundsMax;
+			m_HasBounds = true;
 		}
+		bool HasLocalBounds() const { return m_HasBounds; }
+		const glm::vec3& GetLocalBoundsMin() const { return m_BoundsMin; }
+		const glm::vec3& GetLocalBoundsMax() const { return m_BoundsMax; }
 
 		// Add texture management
 		void AddTexture(Texture* texture)
@@ -174,6 +773,9 @@ namespace Nightbloom
 		PipelineType m_Pipeline;
 		PushConstantData m_PushConstants;
 		std::vector<Texture*> m_Textures;
+		glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+		glm::vec3 m_BoundsMax = glm::vec3(0.0f);
+		bool m_HasBounds = false;
 	};
 
 	// Model drawable - renders all meshes in a model
@@ -182,85 +784,177 @@ namespace Nightbloom
 	public:
 	    ModelDrawable(Model* model, Texture* defaultTexture) : m_Model(model), m_DefaultTexture(defaultTexture) {}
 	
-	    std::vector<DrawCommand> GetDrawCommands() const override
-	    {
-	        std::vector<DrawCommand> opaqueCommands;
-			std::vector<DrawCommand> transparentCommands;
+		// Opaque meshes are emitted first, then transparent ones, so the list
+		// keeps that order even before it is sorted. A model of several meshes
+		// gives each draw its mesh's own world bounds and culls it on its own
+		// (DrawList::IsPartVisible), so a large model partly on screen only
+		// draws its visible parts in the color pass and the shadow and
+		// occlusion tests see the tighter boxes.
+		void EmitDrawCommands(DrawList& drawList) const override
+		{
+			if (!m_Model) return;
 
-	        if (!m_Model) return opaqueCommands;
-	
-	        for (const auto& mesh : m_Model->GetMeshes())
-	        {
-	            if (!mesh->IsValid()) continue;
-
-	            DrawCommand cmd;
-	            cmd.vertexBuffer = mesh->GetVertexBuffer();
-	            cmd.indexBuffer = mesh->GetIndexBuffer();
-	            cmd.indexCount = mesh->GetIndexCount();
-	            cmd.hasPushConstants = true;
-	            cmd.pushConstants.model = m_Model->GetTransform();
-	
-	            Material* mat = mesh->GetMaterial();
+			const glm::mat4& transform = m_HasTransform ? m_Transform : m_Model->GetTransform();
+			const bool perMeshBounds = m_Model->GetMeshCount() > 1;
 
-				bool isTransparent = (mesh->GetName() == "Glass");
-				// or check if material is alphamode blend?
+			// This frame's pose, shared by all of the model's skinned meshes
+			const bool skinned = m_Model->IsSkinned() && !m_SkinMatrices.empty() &&
+				m_SkinMatrices.size() == m_Model->GetSkeleton().GetJointCount();
+			const uint32_t skinFirstJoint = skinned
+				? drawList.AddSkinJoints(m_SkinMatrices.data(), static_cast<uint32_t>(m_SkinMatrices.size())) : 0;
 
-				Texture* textureToUse = nullptr;
-				if (mat && mat->HasAlbedoTexture())
-				{
-					textureToUse = mat->GetAlbedoTexture();
-				}
-				else if (m_DefaultTexture)
-				{
-					textureToUse = m_DefaultTexture;
-				}
+			for (int pass = 0; pass < 2; ++pass)
+			{
+				const bool emitTransparent = (pass == 1);
 
-				if (isTransparent)
+				for (const auto& mesh : m_Model->GetMeshes())
 				{
-					cmd.pipeline = PipelineType::Transparent;
+					if (!mesh->IsValid()) continue;
 
-					if (mat)
+					bool isTransparent = (mesh->GetName() == "Glass");
+					// or check if material is alphamode blend?
+					if (isTransparent != emitTransparent) continue;
+
+					const uint32_t lod = SelectLod(*mesh, transform, drawList.GetLodView());
+
+					DrawCommand& cmd = drawList.Emit();
+					if (perMeshBounds)
 					{
-						glm::vec4 glassColor = mat->GetAlbedoColor();
-						glassColor.a = 0.3f;  // Set transparency
-						cmd.pushConstants.customData = glassColor;
+						TransformAABB(mesh->GetBoundsMin(), mesh->GetBoundsMax(), transform,
+							cmd.bounds.center, cmd.bounds.extents);
+						cmd.hasBounds = true;
+						cmd.cameraVisible = drawList.IsPartVisible(cmd.bounds.center, cmd.bounds.extents);
 					}
-					else
+					cmd.vertexBuffer = mesh->GetVertexBuffer();
+					cmd.indexBuffer = mesh->GetLodIndexBuffer(lod);
+					cmd.indexCount = mesh->GetLodIndexCount(lod);
+					cmd.firstIndex = mesh->GetLodFirstIndex(lod);
+					cmd.vertexOffset = mesh->GetVertexOffset();
+					cmd.hasPushConstants = true;
+					// Quantized positions dequantize through the model matrix
+					cmd.vertexFormat = mesh->GetVertexFormat();
+					cmd.pushConstants.model = mesh->GetVertexFormat() == VertexFormat::Packed
+						? transform * mesh->GetDequantizeTransform() : transform;
+					// Meshlets cover the full-detail index list only
+					if (lod == 0)
+					{
+						cmd.firstMeshlet = mesh->GetFirstMeshlet();
+						cmd.meshletCount = mesh->GetMeshletCount();
+					}
+					if (skinned && mesh->GetSkinVertexCount() > 0)
 					{
-						cmd.pushConstants.customData = glm::vec4(0.9f, 0.95f, 1.0f, 0.3f);
+						cmd.skinFirstVertex = mesh->GetSkinFirstVertex();
+						cmd.skinVertexCount = mesh->GetSkinVertexCount();
+						cmd.skinFirstJoint = skinFirstJoint;
+						cmd.skinJointCount = static_cast<uint32_t>(m_SkinMatrices.size());
+					}
+
+					Material* mat = mesh->GetMaterial();
+
+					Texture* textureToUse = nullptr;
+					if (mat && mat->HasAlbedoTexture())
+					{
+						textureToUse = mat->GetAlbedoTexture();
+					}
+					else if (m_DefaultTexture)
+					{
+						textureToUse = m_DefaultTexture;
 					}
 
 					if (textureToUse)
-						cmd.textures.push_back(textureToUse);
+						cmd.textures.Add(textureToUse);
+					if (mat)
+						cmd.pushConstants.materialIndex = mat->GetBindlessIndex();
 
-					transparentCommands.push_back(cmd);
+					if (isTransparent)
+					{
+						cmd.pipeline = PipelineType::Transparent;
+
+						if (mat)
+						{
+							glm::vec4 glassColor = mat->GetAlbedoColor();
+							glassColor.a = 0.3f;  // Set transparency
+							cmd.pushConstants.customData = glassColor;
+						}
+						else
+						{
+							cmd.pushConstants.customData = glm::vec4(0.9f, 0.95f, 1.0f, 0.3f);
+						}
+					}
+					else
+					{
+						cmd.pipeline = PipelineType::Mesh;
+						cmd.pushConstants.customData = glm::vec4(0.0f);
+					}
 				}
-				else
-				{
-					cmd.pipeline = PipelineType::Mesh;
+			}
+		}
 
-					cmd.pushConstants.customData = glm::vec4(0.0f);
+		// Skinned models: advances the animation and poses the skeleton. A
+		// model's first clip starts on its own once it has loaded. Runs on a
+		// job (Scene::Update), one drawable per thread.
+		void Update(float deltaTime) override
+		{
+			if (!m_Model || !m_Model->IsSkinned())
+				return;
 
-					if (textureToUse)
-						cmd.textures.push_back(textureToUse);
+			const Skeleton& skeleton = m_Model->GetSkeleton();
+			const std::vector<AnimationClip>& clips = m_Model->GetAnimations();
+			if (!m_AutoPlayed && !clips.empty())
+			{
+				m_Player.Play(0);
+				m_AutoPlayed = true;
+			}
 
-					opaqueCommands.push_back(cmd);
-				}
-	        }
-	
-			opaqueCommands.insert(opaqueCommands.end(),
-				transparentCommands.begin(),
-				transparentCommands.end());
+			m_Player.Advance(deltaTime, clips);
+			m_Player.Evaluate(skeleton, clips, m_Pose, m_PoseScratch);
+			m_SkinMatrices.resize(skeleton.GetJointCount());
+			ComputeSkinMatrices(skeleton, m_Pose.data(), m_SkinMatrices.data());
+		}
 
-	        return opaqueCommands;
-	    }
-	
-	    void SetModel(Model* model) { m_Model = model; }
+	    void SetModel(Model* model)
+		{
+			m_Model = model;
+			m_Player = AnimationPlayer();
+			m_AutoPlayed = false;
+			m_SkinMatrices.clear();
+		}
 	    Model* GetModel() const { return m_Model; }
+
+		// Clip playback of a skinned model (clip indices into Model::GetAnimations)
+		AnimationPlayer& GetAnimationPlayer() { return m_Player; }
+		const AnimationPlayer& GetAnimationPlayer() const { return m_Player; }
+
+		// World transform to draw with instead of the Model's own (local) one.
+		// Scene sets it whenever the object's node moves.
+		void SetTransform(const glm::mat4& transform) { m_Transform = transform; m_HasTransform = true; }
 	
 	private:
+		// Screen-space error LOD pick: distance from the camera to the mesh's
+		// world bounding sphere, error scaled by the transform's largest axis
+		static uint32_t SelectLod(const Mesh& mesh, const glm::mat4& transform, const LodView& view)
+		{
+			if (!view.IsEnabled() || mesh.GetLodCount() <= 1)
+				return 0;
+
+			const float scale = std::max({ glm::length(glm::vec3(transform[0])),
+				glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+			const glm::vec3 center = glm::vec3(transform * glm::vec4(mesh.GetCenter(), 1.0f));
+			const float distance = glm::length(center - view.position) - glm::length(mesh.GetExtents()) * scale;
+			return mesh.SelectLod(view.PixelsPerUnitAt(distance) * scale, view.maxPixelError);
+		}
+
 	    Model* m_Model = nullptr;
 		Texture* m_DefaultTexture = nullptr;
+		glm::mat4 m_Transform = glm::mat4(1.0f);
+		bool m_HasTransform = false;
+
+		// Skinned models only
+		AnimationPlayer m_Player;
+		bool m_AutoPlayed = false;
+		std::vector<JointPose> m_Pose;
+		std::vector<JointPose> m_PoseScratch;
+		std::vector<glm::mat4> m_SkinMatrices;
 	};
 
 	// Debug shape drawable (for editor gizmos, etc.)
@@ -274,7 +968,7 @@ namespace Nightbloom
 		{
 		}
 
-		std::vector<DrawCommand> GetDrawCommands() const override;
+		void EmitDrawCommands(DrawList& drawList) const override;
 
 	private:
 		Shape m_Shape;
@@ -282,67 +976,4 @@ namespace Nightbloom
 		glm::mat4 m_Transform = glm::mat4(1.0f);
 	};
 
-	// ============================================================================
-	// Draw List - Accumulates draw commands for a frame
-	// ============================================================================
-
-	class DrawList
-	{
-	public:
-		DrawList() = default;
-
-		// Add a single draw command
-		void AddCommand(const DrawCommand& cmd)
-		{
-			m_Commands.push_back(cmd);
-		}
-
-		// Add commands from a drawable. cameraVisible=false keeps the commands in the list
-		// (so shadow/reflection passes still draw them) but flags them so the main color pass
-		// can skip them — used for objects culled against the camera frustum.
-		void AddDrawable(const IDrawable* drawable, bool cameraVisible = true)
-		{
-			if (drawable && drawable->IsVisible())
-			{
-				auto commands = drawable->GetDrawCommands();
-				for (auto& cmd : commands)
-					cmd.cameraVisible = cameraVisible;
-				m_Commands.insert(m_Commands.end(), commands.begin(), commands.end());
-			}
-		}
-
-		// Add a simple mesh with transform
-		void DrawMesh(Buffer* vertexBuffer, Buffer* indexBuffer, uint32_t indexCount,
-			PipelineType pipeline, const glm::mat4& transform)
-		{
-			DrawCommand cmd;
-			cmd.pipeline = pipeline;
-			cmd.vertexBuffer = vertexBuffer;
-			cmd.indexBuffer = indexBuffer;
-			cmd.indexCount = indexCount;
-			cmd.hasPushConstants = true;
-			cmd.pushConstants.model = transform;
-
-			// View and projection should be set elsewhere
-			m_Commands.push_back(cmd);
-		}
-
-		// Clear the list
-		void Clear() { m_Commands.clear(); }
-
-		// Get all commands
-		const std::vector<DrawCommand>& GetCommands() const { return m_Commands; }
-
-		// Sort commands by pipeline to minimize state changes
-		void SortByPipeline()
-		{
-			std::sort(m_Commands.begin(), m_Commands.end(),
-				[](const DrawCommand& a, const DrawCommand& b) {
-					return static_cast<int>(a.pipeline) < static_cast<int>(b.pipeline);
-				});
-		}
-
-	private:
-		std::vector<DrawCommand> m_Commands;
-	};
 }
\ No newline at end of file
@@ -0,0 +1,297 @@
+//------------------------------------------------------------------------------
+// DrawStream.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/DrawStream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr char STREAM_MAGIC[4] = { 'N', 'B', 'D', 'S' };
+		constexpr uint32_t STREAM_VERSION = 1;
+
+		struct StreamHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t drawStride;
+			uint32_t resourceCount;
+			uint64_t fileSize;
+		};
+
+		class StreamWriter
+		{
+		public:
+			template <typename T>
+			void Write(const T& value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+				m_Bytes.insert(m_Bytes.end(), bytes, bytes + sizeof(T));
+			}
+
+			void WriteString(std::string_view value)
+			{
+				Write(static_cast<uint32_t>(value.size()));
+				m_Bytes.insert(m_Bytes.end(), value.begin(), value.end());
+			}
+
+			template <typename T>
+			void WriteArray(const std::vector<T>& values)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				Write(static_cast<uint64_t>(values.size()));
+				const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+				m_Bytes.insert(m_Bytes.end(), bytes, bytes + values.size() * sizeof(T));
+			}
+
+			std::vector<uint8_t>& GetBytes() { return m_Bytes; }
+
+		private:
+			std::vector<uint8_t> m_Bytes;
+		};
+
+		// Every read is bounds-checked; the first overrun poisons the reader
+		class StreamReader
+		{
+		public:
+			StreamReader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+			template <typename T>
+			bool Read(T& value)
+			{
+				if (!Reserve(sizeof(T)))
+					return false;
+				std::memcpy(&value, m_Data + m_Offset, sizeof(T));
+				m_Offset += sizeof(T);
+				return true;
+			}
+
+			bool ReadString(std::string& value)
+			{
+				uint32_t length = 0;
+				if (!Read(length) || !Reserve(length))
+					return false;
+				value.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+				m_Offset += length;
+				return true;
+			}
+
+			template <typename T>
+			bool ReadArray(std::vector<T>& values)
+			{
+				uint64_t count = 0;
+				if (!Read(count) || count > (m_Size - m_Offset) / sizeof(T))
+					return m_Ok = false;
+				values.resize(static_cast<size_t>(count));
+				std::memcpy(values.data(), m_Data + m_Offset, values.size() * sizeof(T));
+				m_Offset += values.size() * sizeof(T);
+				return true;
+			}
+
+			bool IsOk() const { return m_Ok; }
+			bool IsAtEnd() const { return m_Offset == m_Size; }
+
+		private:
+			bool Reserve(size_t size)
+			{
+				if (!m_Ok || size > m_Size - m_Offset)
+					return m_Ok = false;
+				return true;
+			}
+
+			const uint8_t* m_Data;
+			size_t m_Size;
+			size_t m_Offset = 0;
+			bool m_Ok = true;
+		};
+
+		// Every index a draw holds points into the stream
+		bool IsValidDraw(const DrawStreamDraw& draw, const DrawStream& stream)
+		{
+			const auto validResource = [&](uint32_t index)
+			{
+				return index == DrawStreamDraw::NO_RESOURCE || index < stream.resources.size();
+			};
+			if (!validResource(draw.vertexBuffer) || !validResource(draw.indexBuffer) ||
+				draw.textureCount > DrawStreamDraw::MAX_TEXTURES)
+				return false;
+			for (uint32_t i = 0; i < draw.textureCount; ++i)
+			{
+				if (!validResource(draw.textures[i]))
+					return false;
+			}
+			return draw.firstInstanceRecord == DrawStreamDraw::NO_RESOURCE ||
+				(draw.firstInstanceRecord <= stream.instanceRecords.size() &&
+					draw.instanceCount <= stream.instanceRecords.size() - draw.firstInstanceRecord);
+		}
+	}
+
+	uint32_t DrawStream::AddResource(StringId name)
+	{
+		auto it = std::find(resources.begin(), resources.end(), name);
+		if (it != resources.end())
+			return static_cast<uint32_t>(it - resources.begin());
+		resources.push_back(name);
+		return static_cast<uint32_t>(resources.size() - 1);
+	}
+
+	void DrawStream::Clear()
+	{
+		*this = DrawStream{};
+	}
+
+	void DrawStreamResources::Add(StringId name, const void* resource)
+	{
+		if (!name.IsValid() || !resource)
+			return;
+
+		auto previous = m_Resources.find(name);
+		if (previous != m_Resources.end())
+			m_Names.erase(previous->second);
+		m_Resources[name] = resource;
+		m_Names[resource] = name;
+	}
+
+	void DrawStreamResources::Clear()
+	{
+		m_Names.clear();
+		m_Resources.clear();
+	}
+
+	StringId DrawStreamResources::FindName(const void* resource) const
+	{
+		auto it = m_Names.find(resource);
+		return it != m_Names.end() ? it->second : StringId();
+	}
+
+	const void* DrawStreamResources::Find(StringId name) const
+	{
+		auto it = m_Resources.find(name);
+		return it != m_Resources.end() ? it->second : nullptr;
+	}
+
+	bool WriteDrawStream(const std::string& path, const DrawStream& stream)
+	{
+		StreamWriter writer;
+
+		StreamHeader header{};
+		std::memcpy(header.magic, STREAM_MAGIC, sizeof(header.magic));
+		header.version = STREAM_VERSION;
+		header.drawStride = sizeof(DrawStreamDraw);
+		header.resourceCount = static_cast<uint32_t>(stream.resources.size());
+		writer.Write(header);
+
+		writer.Write(stream.view);
+		writer.Write(stream.projection);
+		writer.Write(stream.cameraPosition);
+		writer.Write(stream.time);
+		writer.Write(stream.sunDirection);
+		writer.Write(stream.shadowCenter);
+		writer.Write(stream.skippedDraws);
+
+		writer.WriteArray(stream.frameUniforms);
+		writer.WriteArray(stream.lighting);
+		writer.WriteArray(stream.shadowUniforms);
+		writer.WriteArray(stream.cascadeLightViewProj);
+
+		// By text: ids are only meaningful to the process that interned them
+		for (StringId name : stream.resources)
+			writer.WriteString(name.GetText());
+
+		writer.WriteArray(stream.draws);
+		writer.WriteArray(stream.instanceRecords);
+
+		// Size last, so a file cut short anywhere reads as corrupt
+		std::vector<uint8_t>& bytes = writer.GetBytes();
+		header.fileSize = bytes.size();
+		std::memcpy(bytes.data(), &header, sizeof(header));
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	bool ReadDrawStream(const std::string& path, DrawStream& stream)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return false;
+		const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		StreamReader reader(bytes.data(), bytes.size());
+		StreamHeader header{};
+		if (!reader.Read(header) ||
+			std::memcmp(header.magic, STREAM_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != STREAM_VERSION ||
+			header.drawStride != sizeof(DrawStreamDraw) ||
+			header.fileSize != bytes.size() ||
+			header.resourceCount > bytes.size())
+		{
+			return false;
+		}
+
+		DrawStream read;
+		reader.Read(read.view);
+		reader.Read(read.projection);
+		reader.Read(read.cameraPosition);
+		reader.Read(read.time);
+		reader.Read(read.sunDirection);
+		reader.Read(read.shadowCenter);
+		reader.Read(read.skippedDraws);
+
+		reader.ReadArray(read.frameUniforms);
+		reader.ReadArray(read.lighting);
+		reader.ReadArray(read.shadowUniforms);
+		reader.ReadArray(read.cascadeLightViewProj);
+
+		read.resources.reserve(header.resourceCount);
+		std::string name;
+		for (uint32_t i = 0; i < header.resourceCount && reader.ReadString(name); ++i)
+			read.resources.emplace_back(name);
+
+		reader.ReadArray(read.draws);
+		reader.ReadArray(read.instanceRecords);
+		if (!reader.IsOk() || !reader.IsAtEnd())
+			return false;
+
+		for (const DrawStreamDraw& draw : read.draws)
+		{
+			if (!IsValidDraw(draw, read))
+				return false;
+		}
+
+		stream = std::move(read);
+		return true;
+	}
+}
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// DrawStream.hpp
+//
+// One frame of renderer input, captured to a file so it can be submitted
+// again without the app that built it: the draw list, the camera, time and
+// lighting the app set, and the uniform blocks the renderer uploaded from
+// them (FrameUniformData, SceneLightingData, one FrameUniformData and light
+// view-projection per shadow cascade). Replaying a stream N times gives
+// per-pass GPU timings with no simulation, culling or list building in them
+// - for comparing drivers and shader changes (NightbloomBench --replay).
+//
+// Draws refer to buffers and textures by name, not pointer: a capture maps
+// each pointer through a DrawStreamResources registry (ResourceManager's
+// named resources and the mesh arena's pages) and a replay maps the names
+// back, so the replaying process must have loaded the same scene. Draws
+// whose resources have no name - descriptor sets and storage buffers a
+// system owns, GPU-written indirect arguments - can't be described and are
+// skipped at capture; draws whose names a replay can't find are dropped.
+// Both are counted. Instance records a draw carries (DrawCommand::
+// instanceData) are copied into the stream.
+//
+// The uniform blocks are kept as the bytes the capturing build uploaded.
+// A replay (Renderer::SetDrawStreamReplay) pins the lighting and shadow
+// blocks when their sizes still match its own, and rebuilds the frame block
+// from the pinned camera and time - the rest of it (wind, clouds, terrain
+// pages) follows systems that keep running. The conversion to and from
+// DrawCommand lives in Renderer, which knows the Vulkan side.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/StringId.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	// A DrawCommand with its pointers replaced by indices into
+	// DrawStream::resources and instanceRecords. Written as is.
+	struct DrawStreamDraw
+	{
+		static constexpr uint32_t NO_RESOURCE = UINT32_MAX;
+		static constexpr uint32_t MAX_TEXTURES = 4;   // DrawTextureSlots::CAPACITY
+
+		uint32_t pipeline = 0;          // PipelineType
+		uint32_t vertexFormat = 0;      // VertexFormat
+		uint32_t vertexBuffer = NO_RESOURCE;
+		uint32_t indexBuffer = NO_RESOURCE;
+		uint32_t indexCount = 0;
+		uint32_t vertexCount = 0;
+		uint32_t firstIndex = 0;
+		int32_t vertexOffset = 0;
+		uint32_t instanceCount = 1;
+		uint32_t firstInstance = 0;
+		// instanceCount records from here on, or NO_RESOURCE
+		uint32_t firstInstanceRecord = NO_RESOURCE;
+		uint32_t textureCount = 0;
+		uint32_t textures[MAX_TEXTURES] = { NO_RESOURCE, NO_RESOURCE, NO_RESOURCE, NO_RESOURCE };
+		uint32_t firstMeshlet = 0;
+		uint32_t meshletCount = 0;
+		uint32_t materialIndex = UINT32_MAX;
+
+		uint8_t tessellated = 0;
+		uint8_t cameraVisible = 1;
+		uint8_t auxViewMask = 0xFF;
+		uint8_t hasPushConstants = 0;
+		uint8_t hasBounds = 0;
+		uint8_t reserved[3] = {};
+
+		glm::vec3 boundsCenter = glm::vec3(0.0f);
+		glm::vec3 boundsExtents = glm::vec3(0.0f);
+		glm::mat4 model = glm::mat4(1.0f);
+		glm::vec4 customData = glm::vec4(0.0f);
+	};
+
+	struct DrawStream
+	{
+		// What the app set (Renderer::SetViewMatrix and friends)
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::vec3 cameraPosition = glm::vec3(0.0f);
+		float time = 0.0f;
+		glm::vec3 sunDirection = glm::vec3(0.0f);
+		glm::vec3 shadowCenter = glm::vec3(0.0f);
+
+		// What the renderer uploaded, as bytes
+		std::vector<uint8_t> frameUniforms;      // FrameUniformData
+		std::vector<uint8_t> lighting;           // SceneLightingData
+		std::vector<uint8_t> shadowUniforms;     // FrameUniformData per cascade
+		std::vector<glm::mat4> cascadeLightViewProj;
+
+		std::vector<StringId> resources;         // names draws refer to by index
+		std::vector<DrawStreamDraw> draws;       // in submission order
+		std::vector<glm::mat4> instanceRecords;  // InstanceData::model
+		uint32_t skippedDraws = 0;               // left out at capture
+
+		// Index of `name` in resources, added if new
+		uint32_t AddResource(StringId name);
+
+		void Clear();
+	};
+
+	// Both ways between resource pointers and the names a stream stores.
+	// Opaque pointers: Buffer* and Texture* live side by side.
+	class DrawStreamResources
+	{
+	public:
+		// A name taken twice keeps the later pointer
+		void Add(StringId name, const void* resource);
+		void Clear();
+
+		// Invalid id / null when unknown
+		StringId FindName(const void* resource) const;
+		const void* Find(StringId name) const;
+
+		size_t GetCount() const { return m_Names.size(); }
+
+	private:
+		std::unordered_map<const void*, StringId> m_Names;
+		std::unordered_map<StringId, const void*> m_Resources;
+	};
+
+	// Through a temporary file and a rename, like the mesh cache
+	bool WriteDrawStream(const std::string& path, const DrawStream& stream);
+
+	// False when the file is missing, from another format version or corrupt
+	bool ReadDrawStream(const std::string& path, DrawStream& stream);
+}
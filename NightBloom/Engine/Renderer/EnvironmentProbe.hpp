@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------
+// EnvironmentProbe.hpp
+//
+// A cached, low-resolution cube of everything far away - the sky, the sun,
+// the clouds and a stand-in for the distant terrain - that reflective
+// surfaces look up instead of evaluating the sky themselves. The
+// EnvironmentProbeCache component captures it around the camera every
+// updateInterval frames, or sooner when the sun turns or the light or sky
+// colour changes past a threshold (EnvironmentProbeSchedule), then
+// prefilters it into roughness mips: mip m holds the GGX lobe of roughness
+// m / (MIP_COUNT - 1), each mip blurred from the one above it.
+//
+// Consumers (environment_probe.glsl): Mesh.frag's glass and opaque
+// specular, the screen-space reflection's misses. Faces follow Vulkan's
+// cube layout (+X, -X, +Y, -Y, +Z, -Z, v down); cube_map.glsl's
+// CubeFaceDirection is a straight port of FaceDirection - keep the two in
+// sync.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	struct EnvironmentProbeSettings
+	{
+		uint32_t updateInterval = 30;      // frames between captures (1 = every frame)
+		float sunThresholdDeg = 1.0f;      // sun turn that recaptures early
+		float colorThreshold = 0.05f;      // relative light or sky colour change that recaptures early
+		glm::vec3 groundColor = glm::vec3(0.10f, 0.09f, 0.07f);  // albedo of the far terrain below the horizon
+	};
+
+	// What a capture depends on, compared against the last capture's
+	struct EnvironmentProbeInputs
+	{
+		glm::vec3 towardSun = glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::vec3 sunColor = glm::vec3(0.0f);    // lights[0] colour times intensity
+		glm::vec3 skyColor = glm::vec3(0.0f);    // the clear colour, the sky's floor
+	};
+
+	// EnvironmentCapture.comp's push constants; mirrors CaptureParams there
+	struct EnvironmentCaptureData
+	{
+		glm::vec4 sun = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);  // xyz = toward the sun
+		glm::vec4 sunColor = glm::vec4(0.0f);   // rgb = lights[0] colour times intensity
+		glm::vec4 ambient = glm::vec4(0.0f);    // rgb = the scene's ambient light
+		glm::vec4 ground = glm::vec4(0.0f);     // rgb = far terrain albedo
+		glm::vec4 clouds = glm::vec4(0.0f);     // x = layer bottom, y = layer top (world y), z = 1 with clouds
+	};
+	static_assert(sizeof(EnvironmentCaptureData) == 80, "Must match CaptureParams in EnvironmentCapture.comp");
+
+	class EnvironmentProbe
+	{
+	public:
+		static constexpr uint32_t SIZE = 64;        // mip 0 face side
+		static constexpr uint32_t MIP_COUNT = 5;    // 64 down to 4; mirrors ENVIRONMENT_PROBE_MIPS
+		static constexpr uint32_t FACE_COUNT = 6;
+
+		static uint32_t MipSize(uint32_t mip) { return std::max(SIZE >> mip, 1u); }
+
+		// Roughness the mip is prefiltered for
+		static float MipRoughness(uint32_t mip)
+		{
+			return static_cast<float>(std::min(mip, MIP_COUNT - 1)) / static_cast<float>(MIP_COUNT - 1);
+		}
+
+		// GGX alpha (roughness squared) of the lobe that blurs mip - 1 into
+		// mip. Lobes convolve roughly by adding their alpha squared, so the
+		// step only has to make up the difference.
+		static float FilterAlpha(uint32_t mip)
+		{
+			if (mip == 0)
+				return 0.0f;
+			const float r = MipRoughness(mip);
+			const float previous = MipRoughness(mip - 1);
+			const float a = r * r;
+			const float b = previous * previous;
+			return std::sqrt(std::max(a * a - b * b, 0.0f));
+		}
+
+		// Unit direction through uv ([0,1]^2, v down) of a face
+		static glm::vec3 FaceDirection(uint32_t face, const glm::vec2& uv)
+		{
+			const float s = uv.x * 2.0f - 1.0f;
+			const float t = uv.y * 2.0f - 1.0f;
+			glm::vec3 direction;
+			switch (face)
+			{
+			case 0:  direction = glm::vec3(1.0f, -t, -s); break;
+			case 1:  direction = glm::vec3(-1.0f, -t, s); break;
+			case 2:  direction = glm::vec3(s, 1.0f, t); break;
+			case 3:  direction = glm::vec3(s, -1.0f, -t); break;
+			case 4:  direction = glm::vec3(s, -t, 1.0f); break;
+			default: direction = glm::vec3(-s, -t, -1.0f); break;
+			}
+			return glm::normalize(direction);
+		}
+
+		// The inverse: the face a direction lands on and where
+		static uint32_t DirectionFace(const glm::vec3& direction, glm::vec2& uv)
+		{
+			const glm::vec3 a = glm::abs(direction);
+			uint32_t face;
+			float major, s, t;
+			if (a.x >= a.y && a.x >= a.z)
+			{
+				face = direction.x > 0.0f ? 0u : 1u;
+				major = a.x;
+				s = direction.x > 0.0f ? -direction.z : direction.z;
+				t = -direction.y;
+			}
+			else if (a.y >= a.z)
+			{
+				face = direction.y > 0.0f ? 2u : 3u;
+				major = a.y;
+				s = direction.x;
+				t = direction.y > 0.0f ? direction.z : -direction.z;
+			}
+			else
+			{
+				face = direction.z > 0.0f ? 4u : 5u;
+				major = a.z;
+				s = direction.z > 0.0f ? direction.x : -direction.x;
+				t = -direction.y;
+			}
+			uv = glm::vec2(s, t) / major * 0.5f + 0.5f;
+			return face;
+		}
+	};
+
+	// Decides which frames recapture the probe
+	class EnvironmentProbeSchedule
+	{
+	public:
+		static constexpr uint32_t MAX_INTERVAL = 600;
+
+		void Invalidate() { m_Valid = false; }
+		bool IsValid() const { return m_Valid; }
+
+		// Whether this frame must capture; call before Advance
+		bool IsDue(const EnvironmentProbeSettings& settings, const EnvironmentProbeInputs& inputs) const
+		{
+			if (!m_Valid)
+				return true;
+			const uint32_t interval = std::clamp(settings.updateInterval, 1u, MAX_INTERVAL);
+			if (m_Age + 1 >= interval)
+				return true;
+
+			const float cosThreshold = std::cos(glm::radians(std::max(settings.sunThresholdDeg, 0.0f)));
+			if (glm::dot(Normalize(inputs.towardSun), Normalize(m_Captured.towardSun)) < cosThreshold)
+				return true;
+			return ColorChanged(inputs.sunColor, m_Captured.sunColor, settings.colorThreshold) ||
+				ColorChanged(inputs.skyColor, m_Captured.skyColor, settings.colorThreshold);
+		}
+
+		// Once per frame; captured: the probe was captured with inputs
+		void Advance(bool captured, const EnvironmentProbeInputs& inputs)
+		{
+			if (!captured)
+			{
+				++m_Age;
+				return;
+			}
+			m_Valid = true;
+			m_Age = 0;
+			m_Captured = inputs;
+		}
+
+		// Frames since the last capture
+		uint32_t GetAge() const { return m_Age; }
+
+	private:
+		static glm::vec3 Normalize(const glm::vec3& v)
+		{
+			const float length = glm::length(v);
+			return length > 1e-6f ? v / length : glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+
+		// Past threshold relative to the brighter of the two, so a dim
+		// night sky still recaptures as it fades
+		static bool ColorChanged(const glm::vec3& a, const glm::vec3& b, float threshold)
+		{
+			const glm::vec3 difference = glm::abs(a - b);
+			const float scale = std::max({ a.r, a.g, a.b, b.r, b.g, b.b, 1e-3f });
+			return std::max({ difference.r, difference.g, difference.b }) > threshold * scale;
+		}
+
+		bool m_Valid = false;
+		uint32_t m_Age = 0;
+		EnvironmentProbeInputs m_Captured;
+	};
+}
@@ -0,0 +1,19 @@
+//------------------------------------------------------------------------------
+// FrameConfig.hpp
+//
+// Frames the CPU may record ahead of the GPU. The count is a runtime setting
+// (Renderer::SetFramesInFlight, 1 to MAX_FRAMES_IN_FLIGHT): 1 gives the
+// lowest latency, 3 the most CPU/GPU overlap. Per-frame resources (uniform
+// buffers, descriptor sets, query pools, ...) are always created for the
+// ceiling and frame indices cycle through [0, count), so changing the count
+// only rebuilds the frame sync objects.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+namespace Nightbloom
+{
+	static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+	static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+}
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// FrameUploadLayout.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/FrameUploadLayout.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	FrameUploadLayout::FrameUploadLayout(uint32_t regionCount, uint64_t regionSize, uint64_t alignment)
+		: m_RegionCount(std::max(regionCount, 1u))
+		, m_Alignment(std::max<uint64_t>(alignment, 1))
+	{
+		// Regions start aligned, so offsets aligned within one are aligned
+		// in the buffer too
+		m_RegionSize = AlignUp(regionSize);
+	}
+
+	uint64_t FrameUploadLayout::Reserve(const std::string& name, uint64_t size)
+	{
+		for (const Slot& slot : m_Slots)
+		{
+			if (slot.name == name && slot.size >= size)
+				return slot.offset;
+		}
+
+		// Reserved mid-frame, the slot goes past this frame's transient data
+		// (which may still be written). Other regions' transient data at that
+		// offset is from frames whose slot writes wait for their fence.
+		const uint64_t offset = AlignUp(std::max(m_ReservedBytes, m_LinearOffset));
+		if (size == 0 || offset + size > m_RegionSize)
+			return INVALID_OFFSET;
+
+		m_Slots.push_back({ name, offset, size });
+		m_ReservedBytes = offset + size;
+		m_LinearOffset = m_ReservedBytes;
+		m_PeakUsedBytes = std::max(m_PeakUsedBytes, m_LinearOffset);
+		return offset;
+	}
+
+	void FrameUploadLayout::BeginFrame(uint32_t regionIndex)
+	{
+		m_CurrentRegion = regionIndex % m_RegionCount;
+		m_LinearOffset = m_ReservedBytes;
+	}
+
+	uint64_t FrameUploadLayout::Allocate(uint64_t size)
+	{
+		const uint64_t offset = AlignUp(m_LinearOffset);
+		if (size == 0 || offset + size > m_RegionSize)
+			return INVALID_OFFSET;
+
+		m_LinearOffset = offset + size;
+		m_PeakUsedBytes = std::max(m_PeakUsedBytes, m_LinearOffset);
+		return GetRegionOffset(m_CurrentRegion) + offset;
+	}
+}
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+// FrameUploadLayout.hpp
+//
+// Offset bookkeeping for the per-frame upload buffer: one host-visible buffer
+// split into a region per frame in flight. Each region starts with the
+// persistent slots (frame, lighting, shadow and reflection uniforms, cloud
+// and firefly params) at the same offset in every region, so a slot's
+// descriptor is written once per frame and never again; the rest of the
+// region is a linear area for transient data, handed out by Allocate and
+// reset when the frame's region comes round again.
+//
+//   region 0: [slot][slot][slot]...[linear ->          ]
+//   region 1: [slot][slot][slot]...[linear ->          ]
+//
+// Slots are keyed by name so a system that shuts down and initializes again
+// gets its old slot back instead of growing the reserved area.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	// A persistent slot: the same offset in every frame's region
+	struct FrameUploadSlot
+	{
+		static constexpr uint64_t INVALID_OFFSET = ~0ull;
+
+		uint64_t offset = INVALID_OFFSET;   // within a region
+		uint64_t size = 0;
+
+		bool IsValid() const { return offset != INVALID_OFFSET; }
+	};
+
+	class FrameUploadLayout
+	{
+	public:
+		static constexpr uint64_t INVALID_OFFSET = FrameUploadSlot::INVALID_OFFSET;
+
+		// `alignment` is the device's minUniformBufferOffsetAlignment (a power
+		// of two); every slot and allocation starts on it
+		FrameUploadLayout(uint32_t regionCount, uint64_t regionSize, uint64_t alignment);
+
+		// Offset of a persistent slot within every region, INVALID_OFFSET when
+		// the region is full. Reserving a name again returns the same slot if
+		// it is big enough.
+		uint64_t Reserve(const std::string& name, uint64_t size);
+
+		// Starts `regionIndex`'s frame: its linear area is empty again
+		void BeginFrame(uint32_t regionIndex);
+
+		// Transient space in the current frame's region; the offset is from
+		// the start of the buffer. INVALID_OFFSET when the region is full.
+		uint64_t Allocate(uint64_t size);
+
+		uint64_t GetRegionOffset(uint32_t regionIndex) const { return static_cast<uint64_t>(regionIndex) * m_RegionSize; }
+		uint64_t GetRegionSize() const { return m_RegionSize; }
+		uint64_t GetBufferSize() const { return m_RegionSize * m_RegionCount; }
+		uint32_t GetRegionCount() const { return m_RegionCount; }
+		uint32_t GetCurrentRegion() const { return m_CurrentRegion; }
+
+		uint64_t GetReservedBytes() const { return m_ReservedBytes; }
+		// Reserved plus transient bytes in the current region - the range
+		// a per-frame flush has to cover
+		uint64_t GetUsedBytes() const { return m_LinearOffset; }
+		uint64_t GetPeakUsedBytes() const { return m_PeakUsedBytes; }
+
+	private:
+		struct Slot
+		{
+			std::string name;
+			uint64_t offset = 0;
+			uint64_t size = 0;
+		};
+
+		uint64_t AlignUp(uint64_t value) const { return (value + m_Alignment - 1) & ~(m_Alignment - 1); }
+
+		uint32_t m_RegionCount = 1;
+		uint64_t m_RegionSize = 0;
+		uint64_t m_Alignment = 1;
+
+		std::vector<Slot> m_Slots;
+		uint64_t m_ReservedBytes = 0;
+
+		uint32_t m_CurrentRegion = 0;
+		uint64_t m_LinearOffset = 0;    // within the current region
+		uint64_t m_PeakUsedBytes = 0;
+	};
+}
@@ -2,7 +2,8 @@
 // Frustum.hpp
 //
 // View frustum extraction and AABB intersection test, for culling scene
-// objects before they're added to the draw list.
+// objects before they're added to the draw list. IntersectsBatch tests an
+// AABBBatch (structure-of-arrays) NB_SIMD_WIDTH boxes at a time.
 //
 // Only 5 planes (left, right, top, bottom, near) — this engine uses an
 // infinite reverse-Z projection (see Camera::SetPerspectiveInfiniteReverseZ),
@@ -10,16 +11,67 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Math/SimdMath.hpp"
 #include <glm/glm.hpp>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace Nightbloom
 {
+	// Center/extents boxes as separate arrays, for Frustum::IntersectsBatch.
+	// The arrays are padded to a multiple of NB_SIMD_WIDTH with empty boxes
+	// at the origin; only the first Size() results mean anything.
+	struct AABBBatch
+	{
+		std::vector<float> cx, cy, cz;   // centers
+		std::vector<float> ex, ey, ez;   // extents
+
+		void Clear() { m_Count = 0; }
+		size_t Size() const { return m_Count; }
+
+		void Add(const glm::vec3& center, const glm::vec3& extents)
+		{
+			const size_t padded = (m_Count + NB_SIMD_WIDTH) / NB_SIMD_WIDTH * NB_SIMD_WIDTH;
+			if (cx.size() < padded)
+			{
+				for (std::vector<float>* array : { &cx, &cy, &cz, &ex, &ey, &ez })
+					array->resize(padded, 0.0f);
+			}
+			cx[m_Count] = center.x;  cy[m_Count] = center.y;  cz[m_Count] = center.z;
+			ex[m_Count] = extents.x; ey[m_Count] = extents.y; ez[m_Count] = extents.z;
+			++m_Count;
+		}
+
+		void Set(size_t index, const glm::vec3& center, const glm::vec3& extents)
+		{
+			cx[index] = center.x;  cy[index] = center.y;  cz[index] = center.z;
+			ex[index] = extents.x; ey[index] = extents.y; ez[index] = extents.z;
+		}
+
+		// Shifts the boxes after index down one; the padding stays intact
+		void Erase(size_t index)
+		{
+			for (std::vector<float>* array : { &cx, &cy, &cz, &ex, &ey, &ez })
+			{
+				array->erase(array->begin() + index);
+				array->push_back(0.0f);
+			}
+			--m_Count;
+		}
+
+	private:
+		size_t m_Count = 0;
+	};
+
 	struct Frustum
 	{
 		// xyz = plane normal (pointing inward), w = distance
 		glm::vec4 planes[5];
 
+		static constexpr uint32_t ALL_PLANES = (1u << 5) - 1;   // Classify's starting planeMask
+
 		static Frustum ExtractFromMatrix(const glm::mat4& viewProj)
 		{
 			Frustum f;
@@ -49,6 +101,29 @@ namespace Nightbloom
 			return f;
 		}
 
+		// Caster volume of an orthographic shadow cascade (Vulkan [0,1] depth): the
+		// four side planes plus the far plane, which lies beyond every receiver the
+		// cascade covers. The light-side near plane is left out — anything between
+		// it and the light can still shadow the cascade. planes[4] holds the far plane.
+		static Frustum ExtractShadowCasterVolume(const glm::mat4& lightViewProj)
+		{
+			Frustum f = ExtractFromMatrix(lightViewProj);
+
+			const glm::mat4& m = lightViewProj;
+			glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+			glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+			glm::vec4 farPlane = row3 - row2;
+
+			float length = glm::length(glm::vec3(farPlane));
+			if (length > 0.0001f)
+			{
+				farPlane /= length;
+			}
+			f.planes[4] = farPlane;
+
+			return f;
+		}
+
 		// Conservative AABB-vs-frustum test using center/extents.
 		// Returns false only if the box is fully outside at least one plane.
 		bool Intersects(const glm::vec3& worldCenter, const glm::vec3& worldExtents) const
@@ -68,6 +143,110 @@ namespace Nightbloom
 			}
 			return true;
 		}
+
+		// Intersects that also tells boxes wholly inside from ones crossing a
+		// plane, for hierarchies (SceneBVH): an Inside node's subtree needs no
+		// more tests. planeMask holds a bit per plane still to test; the bits
+		// of planes the box is inside are cleared, so children can skip them.
+		enum class Overlap { Outside, Intersects, Inside };
+		Overlap Classify(const glm::vec3& worldCenter, const glm::vec3& worldExtents, uint32_t& planeMask) const
+		{
+			for (uint32_t p = 0; p < 5; ++p)
+			{
+				if (!(planeMask & (1u << p)))
+					continue;
+
+				const glm::vec4& plane = planes[p];
+				float distance = glm::dot(glm::vec3(plane), worldCenter) + plane.w;
+				float projectedExtent =
+					worldExtents.x * std::abs(plane.x) +
+					worldExtents.y * std::abs(plane.y) +
+					worldExtents.z * std::abs(plane.z);
+
+				if (distance + projectedExtent < 0.0f)
+					return Overlap::Outside;
+				if (distance - projectedExtent >= 0.0f)
+					planeMask &= ~(1u << p);
+			}
+			return planeMask == 0 ? Overlap::Inside : Overlap::Intersects;
+		}
+
+		// Intersects for every box of the batch: visible[i] = 1 or 0.
+		// visible must hold boxes.Size() entries.
+		void IntersectsBatch(const AABBBatch& boxes, uint8_t* visible) const
+		{
+			const size_t count = boxes.Size();
+			size_t i = 0;
+#if defined(NB_SIMD_AVX2)
+			const __m256 signMask = _mm256_set1_ps(-0.0f);
+			for (; i < count; i += 8)
+			{
+				const __m256 cx = _mm256_loadu_ps(&boxes.cx[i]), cy = _mm256_loadu_ps(&boxes.cy[i]), cz = _mm256_loadu_ps(&boxes.cz[i]);
+				const __m256 ex = _mm256_loadu_ps(&boxes.ex[i]), ey = _mm256_loadu_ps(&boxes.ey[i]), ez = _mm256_loadu_ps(&boxes.ez[i]);
+				__m256 outside = _mm256_setzero_ps();
+				for (const auto& plane : planes)
+				{
+					const __m256 nx = _mm256_set1_ps(plane.x), ny = _mm256_set1_ps(plane.y), nz = _mm256_set1_ps(plane.z);
+					__m256 distance = _mm256_fmadd_ps(nx, cx, _mm256_fmadd_ps(ny, cy, _mm256_fmadd_ps(nz, cz, _mm256_set1_ps(plane.w))));
+					__m256 extent = _mm256_mul_ps(_mm256_andnot_ps(signMask, nx), ex);
+					extent = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, ny), ey, extent);
+					extent = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nz), ez, extent);
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, extent), _mm256_setzero_ps(), _CMP_LT_OQ));
+				}
+				const int outsideBits = _mm256_movemask_ps(outside);
+				for (size_t lane = 0; lane < 8 && i + lane < count; ++lane)
+					visible[i + lane] = ((outsideBits >> lane) & 1) ? 0 : 1;
+			}
+#elif defined(NB_SIMD_SSE)
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			for (; i < count; i += 4)
+			{
+				const __m128 cx = _mm_loadu_ps(&boxes.cx[i]), cy = _mm_loadu_ps(&boxes.cy[i]), cz = _mm_loadu_ps(&boxes.cz[i]);
+				const __m128 ex = _mm_loadu_ps(&boxes.ex[i]), ey = _mm_loadu_ps(&boxes.ey[i]), ez = _mm_loadu_ps(&boxes.ez[i]);
+				__m128 outside = _mm_setzero_ps();
+				for (const auto& plane : planes)
+				{
+					const __m128 nx = _mm_set1_ps(plane.x), ny = _mm_set1_ps(plane.y), nz = _mm_set1_ps(plane.z);
+					__m128 distance = _mm_add_ps(_mm_mul_ps(nx, cx), _mm_set1_ps(plane.w));
+					distance = _mm_add_ps(distance, _mm_mul_ps(ny, cy));
+					distance = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+					__m128 extent = _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex);
+					extent = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey));
+					extent = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+					outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, extent), _mm_setzero_ps()));
+				}
+				const int outsideBits = _mm_movemask_ps(outside);
+				for (size_t lane = 0; lane < 4 && i + lane < count; ++lane)
+					visible[i + lane] = ((outsideBits >> lane) & 1) ? 0 : 1;
+			}
+#elif defined(NB_SIMD_NEON)
+			for (; i < count; i += 4)
+			{
+				const float32x4_t cx = vld1q_f32(&boxes.cx[i]), cy = vld1q_f32(&boxes.cy[i]), cz = vld1q_f32(&boxes.cz[i]);
+				const float32x4_t ex = vld1q_f32(&boxes.ex[i]), ey = vld1q_f32(&boxes.ey[i]), ez = vld1q_f32(&boxes.ez[i]);
+				uint32x4_t outside = vdupq_n_u32(0);
+				for (const auto& plane : planes)
+				{
+					float32x4_t distance = vfmaq_n_f32(vdupq_n_f32(plane.w), cx, plane.x);
+					distance = vfmaq_n_f32(distance, cy, plane.y);
+					distance = vfmaq_n_f32(distance, cz, plane.z);
+					distance = vfmaq_n_f32(distance, ex, std::abs(plane.x));
+					distance = vfmaq_n_f32(distance, ey, std::abs(plane.y));
+					distance = vfmaq_n_f32(distance, ez, std::abs(plane.z));
+					outside = vorrq_u32(outside, vcltq_f32(distance, vdupq_n_f32(0.0f)));
+				}
+				uint32_t lanes[4];
+				vst1q_u32(lanes, outside);
+				for (size_t lane = 0; lane < 4 && i + lane < count; ++lane)
+					visible[i + lane] = lanes[lane] ? 0 : 1;
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				visible[i] = Intersects(glm::vec3(boxes.cx[i], boxes.cy[i], boxes.cz[i]),
+					glm::vec3(boxes.ex[i], boxes.ey[i], boxes.ez[i])) ? 1 : 0;
+			}
+		}
 	};
 
 	// Transforms a local-space AABB (min/max) into a world-space center/extents
@@ -78,17 +257,7 @@ namespace Nightbloom
 		const glm::mat4& transform,
 		glm::vec3& outCenter, glm::vec3& outExtents)
 	{
-		glm::vec3 localCenter = (localMin + localMax) * 0.5f;
-		glm::vec3 localExtents = (localMax - localMin) * 0.5f;
-
-		outCenter = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
-
-		glm::mat3 absRotScale(
-			glm::abs(glm::vec3(transform[0])),
-			glm::abs(glm::vec3(transform[1])),
-			glm::abs(glm::vec3(transform[2]))
-		);
-		outExtents = absRotScale * localExtents;
+		Simd::TransformAABB(localMin, localMax, transform, outCenter, outExtents);
 	}
 
 } // namespace Nightbloom
@@ -8,11 +8,63 @@
 #include "ThirdParty/cgltf/cgltf.h"
 
 #include "Engine/Renderer/GLTFLoader.hpp"
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include "Engine/Renderer/MeshCache.hpp"
+#include "Engine/Renderer/MeshoptDecoder.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/MappedFile.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <numeric>
+#include <unordered_map>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		std::string s_CookedCacheDirectory;
+
+		// A node's local transform as translation/rotation/scale
+		JointPose GetNodePose(const cgltf_node* node)
+		{
+			JointPose pose;
+			if (node->has_matrix)
+			{
+				const glm::mat4 m = glm::make_mat4(node->matrix);
+				pose.translation = glm::vec3(m[3]);
+				pose.scale = glm::vec3(glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2])));
+				pose.rotation = glm::normalize(glm::quat_cast(glm::mat3(
+					glm::vec3(m[0]) / pose.scale.x, glm::vec3(m[1]) / pose.scale.y, glm::vec3(m[2]) / pose.scale.z)));
+				return pose;
+			}
+			if (node->has_translation)
+				pose.translation = glm::make_vec3(node->translation);
+			if (node->has_rotation)
+				pose.rotation = glm::quat(node->rotation[3], node->rotation[0], node->rotation[1], node->rotation[2]);
+			if (node->has_scale)
+				pose.scale = glm::make_vec3(node->scale);
+			return pose;
+		}
+
+		std::unordered_map<const cgltf_node*, uint32_t> GetSkinJointIndices(const cgltf_skin* skin)
+		{
+			std::unordered_map<const cgltf_node*, uint32_t> indices;
+			for (size_t i = 0; i < skin->joints_count; ++i)
+				indices[skin->joints[i]] = static_cast<uint32_t>(i);
+			return indices;
+		}
+	}
+
+	void GLTFLoader::SetCookedCacheDirectory(const std::string& directory)
+	{
+		s_CookedCacheDirectory = directory;
+	}
+
 	std::unique_ptr<ModelData> GLTFLoader::Load(const std::string& filepath)
 	{
 		LOG_INFO("LoadinggLTF: {}", filepath);
@@ -23,6 +75,22 @@ namespace Nightbloom
 		{
 			m_BasePath += '/';
 		}
+
+		// A cooked copy of an unchanged source skips the import entirely
+		const auto loadStart = std::chrono::steady_clock::now();
+		const uint64_t sourceHash = HashSource(filepath);
+		const std::string cookedPath = sourceHash != 0
+			? GetCookedModelPath(s_CookedCacheDirectory, filepath, sourceHash) : std::string();
+		if (!cookedPath.empty())
+		{
+			if (auto cooked = ReadCookedModel(cookedPath, sourceHash, m_BasePath))
+			{
+				cooked->sourcePath = filepath;
+				const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart);
+				LOG_INFO("  Loaded cooked '{}' ({} meshes) in {:.1f} ms", cookedPath, cooked->meshes.size(), elapsed.count());
+				return cooked;
+			}
+		}
 	
 		// Parse the file
 		cgltf_options options = {};
@@ -46,6 +114,14 @@ namespace Nightbloom
 			return nullptr;
 		}
 
+		// Compressed views are expanded before any accessor reads them
+		if (!DecodeCompressedBufferViews(data))
+		{
+			LOG_ERROR("{}", m_LastError);
+			cgltf_free(data);
+			return nullptr;
+		}
+
 		// Create model data
 		auto modelData = std::make_unique<ModelData>();
 		modelData->name = std::filesystem::path(filepath).stem().string();
@@ -63,6 +139,29 @@ namespace Nightbloom
 		}
 		LOG_INFO("  Loaded {} materials", modelData->materials.size());
 
+		// Skeleton and animations of the first skin; meshes with joint
+		// influences are skinned against it
+		std::vector<uint32_t> jointRemap;
+		cgltf_skin* skin = data->skins_count > 0 ? &data->skins[0] : nullptr;
+		if (skin && ParseSkin(skin, modelData->skeleton, jointRemap))
+		{
+			if (data->skins_count > 1)
+				LOG_WARN("  {} skins, only the first is used", data->skins_count);
+			for (size_t i = 0; i < data->animations_count; ++i)
+			{
+				AnimationClip clip;
+				if (ParseAnimation(&data->animations[i], skin, jointRemap, clip))
+					modelData->animations.push_back(std::move(clip));
+			}
+			LOG_INFO("  Skeleton: {} joints, {} animations", modelData->skeleton.GetJointCount(),
+				modelData->animations.size());
+		}
+		else if (skin)
+		{
+			LOG_WARN("  Skin '{}' is unusable, meshes load unskinned", skin->name ? skin->name : "");
+			modelData->skeleton = Skeleton{};
+		}
+
 		for (size_t i = 0; i < data->meshes_count; ++i)
 		{
 			cgltf_mesh* gltfMesh = &data->meshes[i];
@@ -90,6 +189,8 @@ namespace Nightbloom
 				std::vector<glm::vec3> positions;
 				std::vector<glm::vec3> normals;
 				std::vector<glm::vec2> texCoords;
+				cgltf_accessor* jointsAccessor = nullptr;
+				cgltf_accessor* weightsAccessor = nullptr;
 
 				for (size_t a = 0; a < primitive->attributes_count; ++a)
 				{
@@ -109,6 +210,14 @@ namespace Nightbloom
 								ReadTexCoords(attr->data, data, texCoords);
 							}
 							break;
+						case cgltf_attribute_type_joints:
+							if (attr->index == 0)
+								jointsAccessor = attr->data;
+							break;
+						case cgltf_attribute_type_weights:
+							if (attr->index == 0)
+								weightsAccessor = attr->data;
+							break;
 						default:
 							//Ignore tangents, colors, etc. for now TODO: Implement loading for this.
 							break;
@@ -153,6 +262,15 @@ namespace Nightbloom
 					meshData.boundsMax = glm::max(meshData.boundsMax, vertex.position);
 				}
 
+				// Joint influences, when there is a skeleton to bind them to
+				if (modelData->IsSkinned() && jointsAccessor && weightsAccessor &&
+					(!ReadSkin(jointsAccessor, weightsAccessor, jointRemap, meshData.skin) ||
+						meshData.skin.size() != meshData.vertices.size()))
+				{
+					LOG_WARN("  Mesh '{}' has unreadable joint influences, loading it unskinned", meshData.name);
+					meshData.skin.clear();
+				}
+
 				// Read indives
 				if (primitive->indices)
 				{
@@ -168,6 +286,32 @@ namespace Nightbloom
 					}
 				}
 
+				OptimizeMesh(meshData);
+
+				// Room for the poses the bind-pose bounds don't cover
+				if (meshData.IsSkinned())
+				{
+					const glm::vec3 margin = (meshData.boundsMax - meshData.boundsMin) * SKINNED_BOUNDS_MARGIN;
+					meshData.boundsMin -= margin;
+					meshData.boundsMax += margin;
+				}
+
+				// LOD chain for screen-size selection at draw time. Levels share
+				// the optimised vertex order; their triangles get a cache pass.
+				GenerateMeshLods(&meshData.vertices.data()->position, meshData.vertices.size(), sizeof(VertexPNT),
+					meshData.indices.data(), meshData.indices.size(), meshData.lods);
+				for (MeshLodLevel& level : meshData.lods)
+					OptimizeVertexCache(level.indices.data(), level.indices.size(), meshData.vertices.size());
+
+				// Meshlets over the final full-detail order (the cache order
+				// keeps each one a compact patch). Not for skinned meshes:
+				// their bind-pose bounds and cones say nothing about a pose.
+				if (!meshData.vertices.empty() && !meshData.IsSkinned())
+				{
+					meshData.meshlets = BuildMeshlets(&meshData.vertices[0].position, meshData.vertices.size(),
+						sizeof(VertexPNT), meshData.indices.data(), meshData.indices.size());
+				}
+
 				if (primitive->material)
 				{
 					// Calculate index by pointer arithmetic
@@ -182,8 +326,9 @@ namespace Nightbloom
 				modelData->totalVertices += meshData.vertices.size();
 				modelData->totalIndices += meshData.indices.size();
 
-				LOG_INFO("  Mesh '{}': {} vertices, {} indices, materialIndex {}",
-					meshData.name, meshData.vertices.size(), meshData.indices.size(), meshData.materialIndex);
+				LOG_INFO("  Mesh '{}': {} vertices, {} indices, materialIndex {}, {} LODs, {} meshlets{}",
+					meshData.name, meshData.vertices.size(), meshData.indices.size(), meshData.materialIndex,
+					meshData.lods.size(), meshData.meshlets.size(), meshData.IsSkinned() ? ", skinned" : "");
 
 				modelData->meshes.push_back(std::move(meshData));
 			}
@@ -195,9 +340,93 @@ namespace Nightbloom
 			modelData->name, modelData->meshes.size(),
 			modelData->totalVertices, modelData->totalIndices);
 
+		// The cooked format has no skeleton or clips, so skinned models are
+		// imported every time
+		if (!cookedPath.empty() && !modelData->IsSkinned())
+		{
+			const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart);
+			if (WriteCookedModel(cookedPath, *modelData, sourceHash, m_BasePath))
+				LOG_INFO("  Imported in {:.1f} ms, cooked to '{}'", elapsed.count(), cookedPath);
+			else
+				LOG_WARN("  Failed to write cooked model '{}'", cookedPath);
+		}
+
 		return modelData;
 	}
 
+	uint64_t GLTFLoader::HashSource(const std::string& filepath)
+	{
+		MappedFile source;
+		if (!source.Open(filepath))
+			return 0;
+		uint64_t hash = HashBytes(source.GetData(), source.GetSize());
+
+		// .gltf keeps its geometry in separate .bin files. Parsing the JSON
+		// alone (no buffer loads) is cheap next to the import it may save.
+		cgltf_options options = {};
+		cgltf_data* data = nullptr;
+		if (cgltf_parse(&options, source.GetData(), source.GetSize(), &data) != cgltf_result_success)
+			return 0;
+
+		for (size_t i = 0; i < data->buffers_count && hash != 0; ++i)
+		{
+			const char* uri = data->buffers[i].uri;
+			if (!uri || std::strncmp(uri, "data:", 5) == 0)
+				continue;   // GLB chunk or embedded: already in the source bytes
+
+			std::string path = uri;
+			path.resize(cgltf_decode_uri(path.data()));
+
+			MappedFile buffer;
+			hash = buffer.Open(m_BasePath + path) ? HashBytes(buffer.GetData(), buffer.GetSize(), hash) : 0;
+		}
+
+		cgltf_free(data);
+		return hash;
+	}
+
+	void GLTFLoader::OptimizeMesh(MeshData& mesh)
+	{
+		if (mesh.indices.size() < 3 || mesh.vertices.empty())
+			return;
+
+		const size_t vertexCountBefore = mesh.vertices.size();
+		const VertexCacheStats cacheBefore = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+		const VertexFetchStats fetchBefore = AnalyzeVertexFetch(mesh.indices.data(), mesh.indices.size(),
+			mesh.vertices.size(), sizeof(VertexPNT));
+
+		if (!mesh.IsSkinned())
+		{
+			mesh.vertices.resize(RemoveDuplicateVertices(mesh.vertices.data(), mesh.vertices.size(), sizeof(VertexPNT),
+				mesh.indices.data(), mesh.indices.size()));
+		}
+		OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+		OptimizeOverdraw(mesh.indices.data(), mesh.indices.size(), &mesh.vertices.data()->position,
+			mesh.vertices.size(), sizeof(VertexPNT));
+		if (!mesh.IsSkinned())
+		{
+			mesh.vertices.resize(OptimizeVertexFetch(mesh.vertices.data(), mesh.vertices.size(), sizeof(VertexPNT),
+				mesh.indices.data(), mesh.indices.size()));
+		}
+
+		// Unreferenced vertices are gone, so the bounds may have shrunk
+		mesh.boundsMin = glm::vec3(FLT_MAX);
+		mesh.boundsMax = glm::vec3(-FLT_MAX);
+		for (const VertexPNT& vertex : mesh.vertices)
+		{
+			mesh.boundsMin = glm::min(mesh.boundsMin, vertex.position);
+			mesh.boundsMax = glm::max(mesh.boundsMax, vertex.position);
+		}
+
+		const VertexCacheStats cacheAfter = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+		const VertexFetchStats fetchAfter = AnalyzeVertexFetch(mesh.indices.data(), mesh.indices.size(),
+			mesh.vertices.size(), sizeof(VertexPNT));
+		LOG_INFO("    Optimized '{}': {} -> {} vertices, {} -> {} vertex shader runs (ACMR {:.2f} -> {:.2f}), "
+			"{} -> {} KB fetched",
+			mesh.name, vertexCountBefore, mesh.vertices.size(), cacheBefore.shadedVertices, cacheAfter.shadedVertices,
+			cacheBefore.acmr, cacheAfter.acmr, fetchBefore.bytesFetched / 1024, fetchAfter.bytesFetched / 1024);
+	}
+
 	bool GLTFLoader::ReadPositions(void* accessor, void* gltfData, std::vector<glm::vec3>& outPositions)
 	{
 		cgltf_accessor* acc = static_cast<cgltf_accessor*>(accessor);
@@ -258,7 +487,7 @@ namespace Nightbloom
 		return true;
 	}
 
-	bool GLTFLoader::ReadIndices(void* accessor, void* gltfData, std::vector<uint32_t>& outIndices)
+	bool GLTFLoader::ReadIndices(void* accessor, void* gltfData, TrackedVector<uint32_t, CpuMemoryCategory::Mesh>& outIndices)
 	{
 		cgltf_accessor* acc = static_cast<cgltf_accessor*>(accessor);
 
@@ -272,6 +501,159 @@ namespace Nightbloom
 		return true;
 	}
 
+	bool GLTFLoader::ReadSkin(void* jointsAccessor, void* weightsAccessor, const std::vector<uint32_t>& jointRemap,
+		TrackedVector<VertexSkin, CpuMemoryCategory::Mesh>& outSkin)
+	{
+		cgltf_accessor* joints = static_cast<cgltf_accessor*>(jointsAccessor);
+		cgltf_accessor* weights = static_cast<cgltf_accessor*>(weightsAccessor);
+
+		if (joints->type != cgltf_type_vec4 || weights->type != cgltf_type_vec4)
+		{
+			LOG_ERROR("Joint or weight accessor is not vec4");
+			return false;
+		}
+
+		const size_t count = std::min(joints->count, weights->count);
+		outSkin.resize(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			cgltf_uint skinJoints[4] = {};
+			glm::vec4 jointWeights(0.0f);
+			cgltf_accessor_read_uint(joints, i, skinJoints, 4);
+			cgltf_accessor_read_float(weights, i, &jointWeights.x, 4);
+
+			// Into the skeleton's joint order; a joint outside the skin
+			// loses its influence
+			glm::uvec4 remapped(0u);
+			for (int c = 0; c < 4; ++c)
+			{
+				if (skinJoints[c] < jointRemap.size())
+					remapped[c] = jointRemap[skinJoints[c]];
+				else
+					jointWeights[c] = 0.0f;
+			}
+			outSkin[i] = PackVertexSkin(remapped, jointWeights);
+		}
+
+		return true;
+	}
+
+	bool GLTFLoader::ParseSkin(void* gltfSkin, Skeleton& outSkeleton, std::vector<uint32_t>& outJointRemap)
+	{
+		cgltf_skin* skin = static_cast<cgltf_skin*>(gltfSkin);
+		const size_t jointCount = skin->joints_count;
+		if (jointCount == 0 || jointCount > 0xFFFF)   // VertexSkin's joints are 16-bit
+			return false;
+
+		// Depth in the node tree puts every parent ahead of its children
+		auto depthOf = [](const cgltf_node* node)
+		{
+			uint32_t depth = 0;
+			for (node = node->parent; node; node = node->parent)
+				++depth;
+			return depth;
+		};
+		std::vector<uint32_t> order(jointCount);
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+		{
+			return depthOf(skin->joints[a]) < depthOf(skin->joints[b]);
+		});
+		outJointRemap.assign(jointCount, 0);
+		for (uint32_t j = 0; j < jointCount; ++j)
+			outJointRemap[order[j]] = j;
+
+		const auto skinJoints = GetSkinJointIndices(skin);
+
+		outSkeleton = Skeleton{};
+		outSkeleton.names.resize(jointCount);
+		outSkeleton.parents.resize(jointCount, -1);
+		outSkeleton.restPose.resize(jointCount);
+		outSkeleton.inverseBind.resize(jointCount, glm::mat4(1.0f));
+
+		for (uint32_t j = 0; j < jointCount; ++j)
+		{
+			const cgltf_node* node = skin->joints[order[j]];
+			outSkeleton.names[j] = node->name ? node->name : "Joint " + std::to_string(j);
+			outSkeleton.restPose[j] = GetNodePose(node);
+			if (skin->inverse_bind_matrices)
+				cgltf_accessor_read_float(skin->inverse_bind_matrices, order[j], &outSkeleton.inverseBind[j][0][0], 16);
+
+			// Nearest ancestor that is a joint of this skin
+			for (const cgltf_node* up = node->parent; up; up = up->parent)
+			{
+				auto it = skinJoints.find(up);
+				if (it != skinJoints.end())
+				{
+					outSkeleton.parents[j] = static_cast<int32_t>(outJointRemap[it->second]);
+					break;
+				}
+			}
+
+			// The nodes above the (first) root place the skeleton
+			if (j == 0 && node->parent)
+				cgltf_node_transform_world(node->parent, &outSkeleton.rootTransform[0][0]);
+		}
+
+		return outSkeleton.IsValid();
+	}
+
+	bool GLTFLoader::ParseAnimation(void* gltfAnimation, void* gltfSkin, const std::vector<uint32_t>& jointRemap,
+		AnimationClip& outClip)
+	{
+		cgltf_animation* animation = static_cast<cgltf_animation*>(gltfAnimation);
+		const auto skinJoints = GetSkinJointIndices(static_cast<cgltf_skin*>(gltfSkin));
+
+		outClip.name = animation->name ? animation->name : "Animation";
+		for (size_t c = 0; c < animation->channels_count; ++c)
+		{
+			const cgltf_animation_channel& source = animation->channels[c];
+			const cgltf_animation_sampler* sampler = source.sampler;
+			if (!source.target_node || !sampler || !sampler->input || !sampler->output)
+				continue;
+
+			auto joint = skinJoints.find(source.target_node);
+			if (joint == skinJoints.end())
+				continue;
+
+			AnimationChannel channel;
+			channel.joint = jointRemap[joint->second];
+			switch (source.target_path)
+			{
+			case cgltf_animation_path_type_translation: channel.path = AnimationPath::Translation; break;
+			case cgltf_animation_path_type_rotation:    channel.path = AnimationPath::Rotation; break;
+			case cgltf_animation_path_type_scale:       channel.path = AnimationPath::Scale; break;
+			default: continue;   // morph target weights
+			}
+			channel.interpolation = sampler->interpolation == cgltf_interpolation_type_step
+				? AnimationInterpolation::Step : AnimationInterpolation::Linear;
+
+			// Cubic splines store (in-tangent, value, out-tangent) per key;
+			// only the values are kept, and interpolated linearly
+			const bool cubic = sampler->interpolation == cgltf_interpolation_type_cubic_spline;
+			const size_t stride = cubic ? 3 : 1;
+			const size_t components = channel.path == AnimationPath::Rotation ? 4 : 3;
+			const size_t keyCount = std::min(sampler->input->count, sampler->output->count / stride);
+			if (keyCount == 0)
+				continue;
+
+			channel.times.resize(keyCount);
+			channel.values.resize(keyCount, glm::vec4(0.0f));
+			for (size_t k = 0; k < keyCount; ++k)
+			{
+				cgltf_accessor_read_float(sampler->input, k, &channel.times[k], 1);
+				cgltf_accessor_read_float(sampler->output, k * stride + (cubic ? 1 : 0), &channel.values[k].x, components);
+			}
+
+			outClip.duration = std::max(outClip.duration, channel.times.back());
+			outClip.channels.push_back(std::move(channel));
+		}
+
+		LOG_INFO("    Animation '{}': {} channels, {:.2f} s", outClip.name, outClip.channels.size(), outClip.duration);
+		return !outClip.channels.empty();
+	}
+
 	bool GLTFLoader::ParseMaterial(void* gltfMaterial, void* gltfData, MaterialData& outMaterial)
 	{
 		cgltf_material* mat = static_cast<cgltf_material*>(gltfMaterial);
@@ -353,6 +735,95 @@ namespace Nightbloom
 		return true;
 	}
 
+	bool GLTFLoader::DecodeCompressedBufferViews(void* gltfData)
+	{
+		cgltf_data* data = static_cast<cgltf_data*>(gltfData);
+
+		for (size_t i = 0; i < data->extensions_required_count; ++i)
+		{
+			if (std::strcmp(data->extensions_required[i], "KHR_draco_mesh_compression") == 0)
+			{
+				m_LastError = "Draco-compressed glTF is not supported (re-export with EXT_meshopt_compression)";
+				return false;
+			}
+		}
+
+		// Allocated here with cgltf's allocator (cgltf_free releases view->data)...
+		std::vector<cgltf_buffer_view*> views;
+		size_t compressedBytes = 0;
+		size_t decodedBytes = 0;
+		for (size_t i = 0; i < data->buffer_views_count; ++i)
+		{
+			cgltf_buffer_view* view = &data->buffer_views[i];
+			if (!view->has_meshopt_compression || view->data)
+				continue;
+
+			const cgltf_meshopt_compression& compression = view->meshopt_compression;
+			if (!compression.buffer || !compression.buffer->data
+				|| compression.offset + compression.size > compression.buffer->size
+				|| compression.count * compression.stride > view->size)
+			{
+				m_LastError = "Invalid EXT_meshopt_compression buffer view " + std::to_string(i);
+				return false;
+			}
+
+			view->data = data->memory.alloc_func(data->memory.user_data, view->size);
+			if (!view->data)
+			{
+				m_LastError = "Out of memory decoding EXT_meshopt_compression";
+				return false;
+			}
+			views.push_back(view);
+			compressedBytes += compression.size;
+			decodedBytes += view->size;
+		}
+		if (views.empty())
+			return true;
+
+		// ...and decoded in parallel, one view per job
+		const auto decodeStart = std::chrono::steady_clock::now();
+		std::atomic<uint32_t> failed{ 0 };
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(views.size()), 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t v = begin; v < end; ++v)
+				{
+					const cgltf_meshopt_compression& compression = views[v]->meshopt_compression;
+					const uint8_t* source = static_cast<const uint8_t*>(compression.buffer->data) + compression.offset;
+
+					MeshoptMode mode = MeshoptMode::Attributes;
+					if (compression.mode == cgltf_meshopt_compression_mode_triangles)
+						mode = MeshoptMode::Triangles;
+					else if (compression.mode == cgltf_meshopt_compression_mode_indices)
+						mode = MeshoptMode::Indices;
+
+					MeshoptFilter filter = MeshoptFilter::None;
+					if (compression.filter == cgltf_meshopt_compression_filter_octahedral)
+						filter = MeshoptFilter::Octahedral;
+					else if (compression.filter == cgltf_meshopt_compression_filter_quaternion)
+						filter = MeshoptFilter::Quaternion;
+					else if (compression.filter == cgltf_meshopt_compression_filter_exponential)
+						filter = MeshoptFilter::Exponential;
+
+					if (!DecodeMeshoptBuffer(views[v]->data, compression.count, compression.stride,
+						source, compression.size, mode, filter))
+					{
+						failed.fetch_add(1, std::memory_order_relaxed);
+					}
+				}
+			});
+
+		if (failed.load() > 0)
+		{
+			m_LastError = "Failed to decode " + std::to_string(failed.load()) + " EXT_meshopt_compression buffer views";
+			return false;
+		}
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart);
+		LOG_INFO("  Decoded {} meshopt buffer views ({:.1f} KB -> {:.1f} KB) in {:.1f} ms", views.size(),
+			static_cast<double>(compressedBytes) / 1024.0, static_cast<double>(decodedBytes) / 1024.0, elapsed.count());
+		return true;
+	}
+
 	std::string GLTFLoader::ResolveTexturePath(void* gltfTexture, void* gltfData)
 	{
 		cgltf_texture* tex = static_cast<cgltf_texture*>(gltfTexture);
@@ -5,7 +5,11 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Core/CpuMemory.hpp"
 #include "Engine/Renderer/Vertex.hpp"
+#include "Engine/Renderer/MeshLod.hpp"
+#include "Engine/Renderer/Meshlet.hpp"
+#include "Engine/Renderer/Animation.hpp"
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
@@ -17,8 +21,23 @@ namespace Nightbloom
 	struct MeshData
 	{
 		std::string name;
-		std::vector<VertexPNT> vertices;
-		std::vector<uint32_t> indices;
+		TrackedVector<VertexPNT, CpuMemoryCategory::Mesh> vertices;
+		TrackedVector<uint32_t, CpuMemoryCategory::Mesh> indices;
+
+		// Simplified index lists over the same vertices, finest first
+		// (GenerateMeshLods; empty for small meshes)
+		std::vector<MeshLodLevel> lods;
+
+		// Clusters of the full index list, for per-meshlet culling
+		// (BuildMeshlets; empty for small and skinned meshes)
+		std::vector<Meshlet> meshlets;
+
+		// Joint influences parallel to vertices, indexing ModelData::skeleton
+		// (empty unless the mesh is skinned). Bounds of a skinned mesh are
+		// its bind pose's grown by SKINNED_BOUNDS_MARGIN, to leave room for
+		// the poses it is animated into.
+		TrackedVector<VertexSkin, CpuMemoryCategory::Mesh> skin;
+		bool IsSkinned() const { return !skin.empty(); }
 
 		// Bounding box for culling
 		glm::vec3 boundsMin = glm::vec3(FLT_MAX);
@@ -61,6 +80,14 @@ namespace Nightbloom
 		std::vector<MeshData> meshes;
 		std::vector<MaterialData> materials;
 
+		// The file's first skin and the animations that move its joints
+		// (empty skeleton for static models). Skinned models are never
+		// cooked (MeshCache.hpp).
+		Skeleton skeleton;
+		std::vector<AnimationClip> animations;
+
+		bool IsSkinned() const { return !skeleton.IsEmpty(); }
+
 		// Statistics
 		size_t totalVertices = 0;
 		size_t totalIndices = 0;
@@ -69,6 +96,10 @@ namespace Nightbloom
 	class GLTFLoader
 	{
 	public:
+		// Fraction of its extent a skinned mesh's bind-pose bounds grow by
+		// on every side
+		static constexpr float SKINNED_BOUNDS_MARGIN = 0.5f;
+
 		GLTFLoader() = default;
 		~GLTFLoader() = default;
 
@@ -79,6 +110,11 @@ namespace Nightbloom
 		// Get last error message
 		const std::string& GetLastError() const { return m_LastError; }
 
+		// Cooked mesh cache (MeshCache.hpp): Load maps a cooked copy from this
+		// directory when its source hash still matches, and cooks one after
+		// every full import. Empty (the default) keeps them next to the source.
+		static void SetCookedCacheDirectory(const std::string& directory);
+
 	private:
 		std::string m_LastError;
 		std::string m_BasePath;  // Directory containing the gltf file
@@ -87,11 +123,34 @@ namespace Nightbloom
 		bool ParseMesh(void* gltfMesh, void* gltfData, MeshData& outMesh);
 		bool ParseMaterial(void* gltfMaterial, void* gltfData, MaterialData& outMaterial);
 
+		// Expands EXT_meshopt_compression buffer views (MeshoptDecoder.hpp)
+		// into view->data, one job per view; fails on Draco-only files
+		bool DecodeCompressedBufferViews(void* gltfData);
+
+		// Hash of the file and any external buffers it references; 0 if one
+		// of them cannot be read (the load is then never cached)
+		uint64_t HashSource(const std::string& filepath);
+
+		// Import-time vertex dedup, cache/overdraw/fetch reordering (MeshOptimizer.hpp).
+		// Skinned meshes only get the index reordering: the skin stream
+		// would have to follow every vertex moved or merged.
+		void OptimizeMesh(MeshData& mesh);
+
+		// Skeleton of the first skin, with its joints sorted parents first.
+		// outJointRemap maps the skin's joint order (what JOINTS_0 indexes)
+		// to the skeleton's.
+		bool ParseSkin(void* gltfSkin, Skeleton& outSkeleton, std::vector<uint32_t>& outJointRemap);
+		// Channels that target a skeleton joint (morph weights are ignored)
+		bool ParseAnimation(void* gltfAnimation, void* gltfSkin, const std::vector<uint32_t>& jointRemap,
+			AnimationClip& outClip);
+
 		// Accessor helpers
 		bool ReadPositions(void* accessor, void* gltfData, std::vector<glm::vec3>& outPositions);
 		bool ReadNormals(void* accessor, void* gltfData, std::vector<glm::vec3>& outNormals);
 		bool ReadTexCoords(void* accessor, void* gltfData, std::vector<glm::vec2>& outTexCoords);
-		bool ReadIndices(void* accessor, void* gltfData, std::vector<uint32_t>& outIndices);
+		bool ReadIndices(void* accessor, void* gltfData, TrackedVector<uint32_t, CpuMemoryCategory::Mesh>& outIndices);
+		bool ReadSkin(void* jointsAccessor, void* weightsAccessor, const std::vector<uint32_t>& jointRemap,
+			TrackedVector<VertexSkin, CpuMemoryCategory::Mesh>& outSkin);
 
 		// Texture path resolution
 		std::string ResolveTexturePath(void* gltfTexture, void* gltfData);
@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+// GpuMemoryTracker.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		thread_local GpuMemoryCategory t_CurrentCategory = GpuMemoryCategory::Untagged;
+
+		std::string FormatBytes(uint64_t bytes)
+		{
+			char buffer[32];
+			if (bytes >= 1024ull * 1024ull)
+				std::snprintf(buffer, sizeof(buffer), "%.2f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+			else
+				std::snprintf(buffer, sizeof(buffer), "%.1f KB", static_cast<double>(bytes) / 1024.0);
+			return buffer;
+		}
+	}
+
+	const char* GetGpuMemoryCategoryName(GpuMemoryCategory category)
+	{
+		switch (category)
+		{
+		case GpuMemoryCategory::Untagged:     return "Untagged";
+		case GpuMemoryCategory::Renderer:     return "Renderer";
+		case GpuMemoryCategory::RenderTarget: return "Render targets";
+		case GpuMemoryCategory::Shadow:       return "Shadows";
+		case GpuMemoryCategory::Staging:      return "Staging";
+		case GpuMemoryCategory::Model:        return "Models";
+		case GpuMemoryCategory::Texture:      return "Textures";
+		case GpuMemoryCategory::Terrain:      return "Terrain";
+		case GpuMemoryCategory::Grass:        return "Grass";
+		case GpuMemoryCategory::Clouds:       return "Clouds";
+		case GpuMemoryCategory::Water:        return "Water";
+		case GpuMemoryCategory::Effects:      return "Effects";
+		default:                              return "?";
+		}
+	}
+
+	const char* GetGpuAllocationKindName(GpuAllocationKind kind)
+	{
+		switch (kind)
+		{
+		case GpuAllocationKind::Buffer:        return "buffer";
+		case GpuAllocationKind::Image:         return "image";
+		case GpuAllocationKind::AliasedImages: return "aliased images";
+		default:                               return "?";
+		}
+	}
+
+	GpuMemoryPriority ResolveGpuMemoryPriority(GpuMemoryPriority priority, GpuMemoryCategory category)
+	{
+		if (priority != GpuMemoryPriority::Default)
+			return priority;
+
+		switch (category)
+		{
+		case GpuMemoryCategory::Renderer:
+		case GpuMemoryCategory::RenderTarget:
+		case GpuMemoryCategory::Shadow:
+			return GpuMemoryPriority::High;
+		case GpuMemoryCategory::Staging:
+			return GpuMemoryPriority::Low;
+		default:
+			return GpuMemoryPriority::Normal;
+		}
+	}
+
+	float GetGpuMemoryPriorityValue(GpuMemoryPriority priority)
+	{
+		switch (priority)
+		{
+		case GpuMemoryPriority::Low:  return 0.0f;
+		case GpuMemoryPriority::High: return 1.0f;
+		default:                      return 0.5f;   // the Vulkan default
+		}
+	}
+
+	GpuMemoryScope::GpuMemoryScope(GpuMemoryCategory category)
+		: m_Previous(t_CurrentCategory)
+	{
+		t_CurrentCategory = category;
+	}
+
+	GpuMemoryScope::~GpuMemoryScope()
+	{
+		t_CurrentCategory = m_Previous;
+	}
+
+	GpuMemoryCategory GpuMemoryScope::GetCurrent()
+	{
+		return t_CurrentCategory;
+	}
+
+	GpuMemoryCategory GpuMemoryScope::GetCurrentOr(GpuMemoryCategory fallback)
+	{
+		return t_CurrentCategory != GpuMemoryCategory::Untagged ? t_CurrentCategory : fallback;
+	}
+
+	void GpuMemoryTracker::OnAllocate(uint64_t id, GpuAllocationKind kind, GpuMemoryCategory category,
+		uint64_t bytes, const char* name)
+	{
+		if (category >= GpuMemoryCategory::Count)
+			category = GpuMemoryCategory::Untagged;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto [it, inserted] = m_Live.try_emplace(id);
+		if (!inserted)
+		{
+			CategoryStats& old = m_Categories[static_cast<size_t>(it->second.category)];
+			old.liveBytes -= it->second.bytes;
+			--old.liveCount;
+		}
+
+		Allocation& allocation = it->second;
+		allocation.id = id;
+		allocation.kind = kind;
+		allocation.category = category;
+		allocation.bytes = bytes;
+		allocation.name = name ? name : "";
+
+		CategoryStats& stats = m_Categories[static_cast<size_t>(category)];
+		stats.liveBytes += bytes;
+		++stats.liveCount;
+		++stats.totalAllocations;
+		stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+	}
+
+	void GpuMemoryTracker::OnFree(uint64_t id)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = m_Live.find(id);
+		if (it == m_Live.end())
+			return;
+
+		CategoryStats& stats = m_Categories[static_cast<size_t>(it->second.category)];
+		stats.liveBytes -= it->second.bytes;
+		--stats.liveCount;
+		m_Live.erase(it);
+	}
+
+	void GpuMemoryTracker::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Live.clear();
+		m_Categories.fill({});
+	}
+
+	GpuMemoryTracker::CategoryStats GpuMemoryTracker::GetCategoryStats(GpuMemoryCategory category) const
+	{
+		if (category >= GpuMemoryCategory::Count)
+			return {};
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Categories[static_cast<size_t>(category)];
+	}
+
+	uint64_t GpuMemoryTracker::GetLiveBytes() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		uint64_t bytes = 0;
+		for (const CategoryStats& stats : m_Categories)
+			bytes += stats.liveBytes;
+		return bytes;
+	}
+
+	uint32_t GpuMemoryTracker::GetLiveCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return static_cast<uint32_t>(m_Live.size());
+	}
+
+	std::vector<GpuMemoryTracker::Allocation> GpuMemoryTracker::GetLiveAllocations(size_t maxCount) const
+	{
+		std::vector<Allocation> allocations;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			allocations.reserve(m_Live.size());
+			for (const auto& [id, allocation] : m_Live)
+				allocations.push_back(allocation);
+		}
+
+		// Ties by id so the order doesn't depend on the hash map's
+		std::sort(allocations.begin(), allocations.end(), [](const Allocation& a, const Allocation& b)
+			{
+				return a.bytes != b.bytes ? a.bytes > b.bytes : a.id < b.id;
+			});
+		if (maxCount > 0 && allocations.size() > maxCount)
+			allocations.resize(maxCount);
+		return allocations;
+	}
+
+	std::vector<std::string> GpuMemoryTracker::BuildLeakReport(size_t maxListed) const
+	{
+		std::vector<std::string> lines;
+		const std::vector<Allocation> live = GetLiveAllocations();
+		if (live.empty())
+			return lines;
+
+		uint64_t totalBytes = 0;
+		for (const Allocation& allocation : live)
+			totalBytes += allocation.bytes;
+		lines.push_back(std::to_string(live.size()) + " GPU allocations still alive (" + FormatBytes(totalBytes) + ")");
+
+		for (size_t c = 0; c < CATEGORY_COUNT; ++c)
+		{
+			const CategoryStats stats = GetCategoryStats(static_cast<GpuMemoryCategory>(c));
+			if (stats.liveCount == 0)
+				continue;
+			lines.push_back(std::string("  ") + GetGpuMemoryCategoryName(static_cast<GpuMemoryCategory>(c)) + ": "
+				+ std::to_string(stats.liveCount) + " (" + FormatBytes(stats.liveBytes) + ")");
+		}
+
+		const size_t listed = std::min(live.size(), maxListed);
+		for (size_t i = 0; i < listed; ++i)
+		{
+			const Allocation& allocation = live[i];
+			lines.push_back(std::string("    ") + FormatBytes(allocation.bytes) + " "
+				+ GetGpuAllocationKindName(allocation.kind) + " '"
+				+ (allocation.name.empty() ? "unnamed" : allocation.name) + "' ["
+				+ GetGpuMemoryCategoryName(allocation.category) + "]");
+		}
+		if (listed < live.size())
+			lines.push_back("    ... and " + std::to_string(live.size() - listed) + " more");
+		return lines;
+	}
+}
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// GpuMemoryTracker.hpp
+//
+// Who owns the GPU memory. VulkanMemoryManager reports every buffer, image
+// and aliased image group it creates or destroys here, tagged with a
+// category; the tracker keeps the live allocations, per-category totals and
+// peaks, and reports whatever is still alive at shutdown.
+//
+// A category comes from the create info when the allocation site knows it
+// (render targets, shadow maps, staging buffers), else from the innermost
+// GpuMemoryScope on the allocating thread:
+//
+//   GpuMemoryScope memoryScope(GpuMemoryCategory::Terrain);
+//   m_Heightmap = noiseGen->Generate(...);   // tagged Terrain
+//
+// Sizes are what VMA allocated for the resource (alignment included), not
+// the memory blocks behind it.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class GpuMemoryCategory : uint8_t
+	{
+		Untagged,       // no scope and no explicit category
+		Renderer,       // frame uniforms, instance and culling buffers
+		RenderTarget,   // attachments and full-screen intermediates
+		Shadow,
+		Staging,
+		Model,          // a model's meshes and textures
+		Texture,        // standalone and streamed textures
+		Terrain,
+		Grass,
+		Clouds,
+		Water,
+		Effects,        // fireflies and other particles
+		Count
+	};
+
+	const char* GetGpuMemoryCategoryName(GpuMemoryCategory category);
+
+	enum class GpuAllocationKind : uint8_t
+	{
+		Buffer,
+		Image,
+		AliasedImages
+	};
+
+	const char* GetGpuAllocationKindName(GpuAllocationKind kind);
+
+	// What the driver should keep in VRAM longest when it runs short
+	// (VK_EXT_memory_priority). Default follows the category: attachments,
+	// shadow maps and per-frame buffers High, staging Low, the rest Normal.
+	enum class GpuMemoryPriority : uint8_t
+	{
+		Default,
+		Low,            // evicted first: streamed mips that can be dropped
+		Normal,
+		High            // touched every frame: evicting it costs a frame spike
+	};
+
+	GpuMemoryPriority ResolveGpuMemoryPriority(GpuMemoryPriority priority, GpuMemoryCategory category);
+	// The VkMemoryPriorityAllocateInfoEXT value, 0..1
+	float GetGpuMemoryPriorityValue(GpuMemoryPriority priority);
+
+	// Tags the GPU allocations made on this thread while it's alive. Scopes
+	// nest; the innermost one wins.
+	class GpuMemoryScope
+	{
+	public:
+		explicit GpuMemoryScope(GpuMemoryCategory category);
+		~GpuMemoryScope();
+
+		GpuMemoryScope(const GpuMemoryScope&) = delete;
+		GpuMemoryScope& operator=(const GpuMemoryScope&) = delete;
+
+		static GpuMemoryCategory GetCurrent();
+		// The current category, or `fallback` outside any scope - for shared
+		// code (texture loading) whose callers may know better
+		static GpuMemoryCategory GetCurrentOr(GpuMemoryCategory fallback);
+
+	private:
+		GpuMemoryCategory m_Previous;
+	};
+
+	class GpuMemoryTracker
+	{
+	public:
+		struct Allocation
+		{
+			uint64_t id = 0;               // the allocation's address
+			GpuAllocationKind kind = GpuAllocationKind::Buffer;
+			GpuMemoryCategory category = GpuMemoryCategory::Untagged;
+			uint64_t bytes = 0;
+			std::string name;              // may be empty
+		};
+
+		struct CategoryStats
+		{
+			uint64_t liveBytes = 0;
+			uint32_t liveCount = 0;
+			uint64_t peakBytes = 0;
+			uint64_t totalAllocations = 0;   // ever made
+		};
+
+		// Thread-safe. Freeing an id that isn't live is ignored; allocating
+		// a live id replaces it.
+		void OnAllocate(uint64_t id, GpuAllocationKind kind, GpuMemoryCategory category,
+			uint64_t bytes, const char* name = nullptr);
+		void OnFree(uint64_t id);
+		void Clear();
+
+		CategoryStats GetCategoryStats(GpuMemoryCategory category) const;
+		uint64_t GetLiveBytes() const;
+		uint32_t GetLiveCount() const;
+
+		// Largest first; at most maxCount (0 = all)
+		std::vector<Allocation> GetLiveAllocations(size_t maxCount = 0) const;
+
+		// One line per category still holding memory, then the largest
+		// live allocations (up to maxListed). Empty when nothing is live.
+		std::vector<std::string> BuildLeakReport(size_t maxListed = 32) const;
+
+	private:
+		static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(GpuMemoryCategory::Count);
+
+		mutable std::mutex m_Mutex;
+		std::unordered_map<uint64_t, Allocation> m_Live;
+		std::array<CategoryStats, CATEGORY_COUNT> m_Categories{};
+	};
+}
@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+// GpuProfileHistory.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/GpuProfileHistory.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Nearest rank: the smallest sample with at least p of the samples at
+		// or below it. `sorted` is non-empty.
+		float Percentile(const std::vector<float>& sorted, float p)
+		{
+			size_t rank = static_cast<size_t>(std::ceil(p * static_cast<float>(sorted.size())));
+			rank = std::clamp<size_t>(rank, 1, sorted.size());
+			return sorted[rank - 1];
+		}
+	}
+
+	const char* GetGpuQueueName(GpuQueue queue)
+	{
+		switch (queue)
+		{
+		case GpuQueue::Graphics: return "Graphics";
+		case GpuQueue::Compute:  return "Compute";
+		case GpuQueue::Transfer: return "Transfer";
+		default:                 return "Unknown";
+		}
+	}
+
+	GpuPipelineStats& GpuPipelineStats::operator+=(const GpuPipelineStats& other)
+	{
+		vertexInvocations += other.vertexInvocations;
+		clippingInvocations += other.clippingInvocations;
+		clippingPrimitives += other.clippingPrimitives;
+		fragmentInvocations += other.fragmentInvocations;
+		computeInvocations += other.computeInvocations;
+		samplesPassed += other.samplesPassed;
+		return *this;
+	}
+
+	float GpuFrameProfile::GetQueueMs(GpuQueue queue) const
+	{
+		float total = 0.0f;
+		for (const GpuSpan& span : spans)
+		{
+			if (span.queue == queue && span.parent == GpuSpan::NO_PARENT)
+				total += span.ms;
+		}
+		return total;
+	}
+
+	double GpuFrameProfile::GetQueueEndMs(GpuQueue queue) const
+	{
+		double end = 0.0;
+		for (const GpuSpan& span : spans)
+		{
+			if (span.queue == queue)
+				end = std::max(end, span.startMs + span.ms);
+		}
+		return end;
+	}
+
+	std::string GpuFrameProfile::GetSpanPath(uint32_t span) const
+	{
+		if (span >= spans.size())
+			return {};
+
+		std::string path = spans[span].name.c_str();
+		for (uint32_t parent = spans[span].parent; parent < span && parent != GpuSpan::NO_PARENT;
+			parent = spans[parent].parent)
+		{
+			path = std::string(spans[parent].name.c_str()) + "/" + path;
+			span = parent;
+		}
+		return path;
+	}
+
+	GpuProfileHistory::GpuProfileHistory(uint32_t capacity)
+		: m_Capacity(std::max(capacity, 1u))
+	{
+	}
+
+	void GpuProfileHistory::Push(GpuFrameProfile frame)
+	{
+		Frame stored;
+
+		// Parents precede their children, so each path extends its parent's
+		std::vector<uint32_t> paths(frame.spans.size());
+		for (size_t i = 0; i < frame.spans.size(); ++i)
+		{
+			const GpuSpan& span = frame.spans[i];
+			const uint32_t id = InternPath(span.parent < i ? paths[span.parent] : GpuSpan::NO_PARENT, span);
+			paths[i] = id;
+			auto it = std::find_if(stored.samples.begin(), stored.samples.end(),
+				[id](const Sample& sample) { return sample.path == id; });
+			if (it == stored.samples.end())
+			{
+				stored.samples.push_back({ id, 0.0f, span.hasPipelineStats, {} });
+				it = stored.samples.end() - 1;
+			}
+			it->ms += span.ms;
+			// Summed only while every span of the path has statistics
+			it->hasPipelineStats = it->hasPipelineStats && span.hasPipelineStats;
+			it->pipelineStats += span.pipelineStats;
+		}
+
+		stored.profile = std::move(frame);
+		m_Frames.push_back(std::move(stored));
+		while (m_Frames.size() > m_Capacity)
+			m_Frames.pop_front();
+	}
+
+	void GpuProfileHistory::Clear()
+	{
+		m_Frames.clear();
+		m_Paths.clear();
+		m_PathIds.clear();
+	}
+
+	void GpuProfileHistory::SetCapacity(uint32_t capacity)
+	{
+		m_Capacity = std::max(capacity, 1u);
+		while (m_Frames.size() > m_Capacity)
+			m_Frames.pop_front();
+	}
+
+	const GpuFrameProfile& GpuProfileHistory::GetFrame(uint32_t age) const
+	{
+		return m_Frames[m_Frames.size() - 1 - age].profile;
+	}
+
+	std::vector<GpuProfileHistory::ScopeStats> GpuProfileHistory::ComputeStats() const
+	{
+		std::vector<std::vector<float>> series(m_Paths.size());
+		std::vector<uint32_t> pipelineSamples(m_Paths.size(), 0);
+		std::vector<GpuPipelineStats> pipelineSums(m_Paths.size());
+		for (const Frame& frame : m_Frames)
+		{
+			for (const Sample& sample : frame.samples)
+			{
+				series[sample.path].push_back(sample.ms);
+				if (sample.hasPipelineStats)
+				{
+					++pipelineSamples[sample.path];
+					pipelineSums[sample.path] += sample.pipelineStats;
+				}
+			}
+		}
+
+		std::vector<uint32_t> order;
+		for (uint32_t id = 0; id < series.size(); ++id)
+		{
+			if (!series[id].empty())
+				order.push_back(id);
+		}
+		std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+		{
+			return m_Paths[a].queue < m_Paths[b].queue;
+		});
+
+		std::vector<ScopeStats> stats;
+		stats.reserve(order.size());
+		for (uint32_t id : order)
+		{
+			std::vector<float>& samples = series[id];
+
+			ScopeStats entry;
+			entry.path = m_Paths[id].path;
+			entry.queue = m_Paths[id].queue;
+			entry.depth = m_Paths[id].depth;
+			entry.samples = static_cast<uint32_t>(samples.size());
+			entry.last = samples.back();
+
+			double sum = 0.0;
+			for (float ms : samples)
+				sum += ms;
+			entry.avg = static_cast<float>(sum / static_cast<double>(samples.size()));
+
+			std::sort(samples.begin(), samples.end());
+			entry.min = samples.front();
+			entry.max = samples.back();
+			entry.p50 = Percentile(samples, 0.50f);
+			entry.p95 = Percentile(samples, 0.95f);
+			entry.p99 = Percentile(samples, 0.99f);
+
+			entry.pipelineSamples = pipelineSamples[id];
+			if (entry.pipelineSamples > 0)
+			{
+				const GpuPipelineStats& sum = pipelineSums[id];
+				const uint64_t n = entry.pipelineSamples;
+				entry.avgPipelineStats.vertexInvocations = sum.vertexInvocations / n;
+				entry.avgPipelineStats.clippingInvocations = sum.clippingInvocations / n;
+				entry.avgPipelineStats.clippingPrimitives = sum.clippingPrimitives / n;
+				entry.avgPipelineStats.fragmentInvocations = sum.fragmentInvocations / n;
+				entry.avgPipelineStats.computeInvocations = sum.computeInvocations / n;
+				entry.avgPipelineStats.samplesPassed = sum.samplesPassed / n;
+			}
+			stats.push_back(std::move(entry));
+		}
+		return stats;
+	}
+
+	std::vector<GpuProfileHistory::ScopeComparison> GpuProfileHistory::CompareStats(
+		const std::vector<ScopeStats>& baseline, const std::vector<ScopeStats>& candidate)
+	{
+		std::vector<ScopeComparison> comparison;
+		for (const ScopeStats& a : baseline)
+		{
+			auto b = std::find_if(candidate.begin(), candidate.end(), [&a](const ScopeStats& entry)
+			{
+				return entry.path == a.path && entry.queue == a.queue;
+			});
+			if (b == candidate.end())
+				continue;
+
+			ScopeComparison entry;
+			entry.path = a.path;
+			entry.queue = a.queue;
+			entry.depth = a.depth;
+			entry.baselineAvg = a.avg;
+			entry.candidateAvg = b->avg;
+			entry.baselineP95 = a.p95;
+			entry.candidateP95 = b->p95;
+			comparison.push_back(std::move(entry));
+		}
+		return comparison;
+	}
+
+	uint32_t GpuProfileHistory::InternPath(uint32_t parent, const GpuSpan& span)
+	{
+		// The same path on two queues is two scopes. Path ids stay well
+		// below 2^24, NO_PARENT folds to 0xFFFFFF.
+		const uint64_t key = (static_cast<uint64_t>(parent & 0xFFFFFFu) << 40) |
+			(static_cast<uint64_t>(span.queue) << 32) | span.name.GetValue();
+		auto it = m_PathIds.find(key);
+		if (it != m_PathIds.end())
+			return it->second;
+
+		std::string path = span.name.c_str();
+		if (parent != GpuSpan::NO_PARENT)
+			path = m_Paths[parent].path + "/" + path;
+
+		const uint32_t id = static_cast<uint32_t>(m_Paths.size());
+		m_Paths.push_back({ std::move(path), span.queue, span.depth });
+		m_PathIds.emplace(key, id);
+		return id;
+	}
+}
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+// GpuProfileHistory.hpp
+//
+// What GpuProfiler reads back, kept for a rolling window of frames. A frame
+// is a flat list of spans; nesting is a parent index into the same list, so
+// a child always comes after its parent. Each queue (graphics, async
+// compute, transfer) has its own time origin: start times are relative to
+// the earliest span recorded on that queue in that frame, since timestamps
+// of different queues aren't guaranteed to share a clock.
+//
+// Statistics are per scope path ("Post/Bloom Down 2"): spans with the same
+// path in one frame are summed, and frames a scope didn't run in don't count
+// as samples. Percentiles are nearest-rank over the frames in the window.
+// Span names are StringIds, so pushing a frame builds a path's text only
+// the first time the path is seen.
+// Pipeline statistics, when recorded, are averaged over the frames that have
+// them.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/StringId.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class GpuQueue : uint8_t
+	{
+		Graphics,
+		Compute,
+		Transfer,
+		Count
+	};
+
+	const char* GetGpuQueueName(GpuQueue queue);
+
+	// Pipeline statistics and occlusion counts over a span, its children
+	// included. Counters a queue can't collect stay 0 (the compute queue
+	// only counts compute invocations).
+	struct GpuPipelineStats
+	{
+		uint64_t vertexInvocations = 0;
+		uint64_t clippingInvocations = 0;   // primitives reaching the clipper
+		uint64_t clippingPrimitives = 0;    // primitives leaving it (survived clipping)
+		uint64_t fragmentInvocations = 0;
+		uint64_t computeInvocations = 0;
+		uint64_t samplesPassed = 0;         // occlusion query: samples passing depth/stencil
+
+		GpuPipelineStats& operator+=(const GpuPipelineStats& other);
+	};
+
+	struct GpuSpan
+	{
+		static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+		StringId name;
+		uint32_t parent = NO_PARENT;   // index into GpuFrameProfile::spans
+		uint32_t depth = 0;            // 0 = top level
+		GpuQueue queue = GpuQueue::Graphics;
+		double startMs = 0.0;          // from the queue's first span this frame
+		float ms = 0.0f;
+
+		bool hasPipelineStats = false;  // GpuProfiler collected statistics for it
+		GpuPipelineStats pipelineStats;
+	};
+
+	struct GpuFrameProfile
+	{
+		uint64_t frameNumber = 0;
+		std::vector<GpuSpan> spans;
+
+		// CpuProfiler::Now() when each queue's work was submitted, 0 if
+		// unknown: where a trace puts the queue's time origin on the CPU
+		// timeline. The queue's start latency isn't measured, so the spans
+		// show up that much early.
+		uint64_t cpuSubmitNs[static_cast<size_t>(GpuQueue::Count)] = {};
+
+		// Sum of the queue's top-level spans
+		float GetQueueMs(GpuQueue queue) const;
+		// End of the queue's last span
+		double GetQueueEndMs(GpuQueue queue) const;
+		// "Parent/Child" names up to the top level
+		std::string GetSpanPath(uint32_t span) const;
+	};
+
+	class GpuProfileHistory
+	{
+	public:
+		static constexpr uint32_t DEFAULT_CAPACITY = 300;
+
+		explicit GpuProfileHistory(uint32_t capacity = DEFAULT_CAPACITY);
+
+		// Drops the oldest frame once the window is full
+		void Push(GpuFrameProfile frame);
+		void Clear();
+
+		void SetCapacity(uint32_t capacity);
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_Frames.size()); }
+
+		// age 0 is the newest frame; age < GetFrameCount()
+		const GpuFrameProfile& GetFrame(uint32_t age) const;
+
+		struct ScopeStats
+		{
+			std::string path;
+			GpuQueue queue = GpuQueue::Graphics;
+			uint32_t depth = 0;
+			uint32_t samples = 0;   // frames the scope ran in
+			float last = 0.0f;      // newest sample
+			float min = 0.0f;
+			float avg = 0.0f;
+			float max = 0.0f;
+			float p50 = 0.0f;
+			float p95 = 0.0f;
+			float p99 = 0.0f;
+
+			uint32_t pipelineSamples = 0;       // frames with pipeline statistics
+			GpuPipelineStats avgPipelineStats;  // per frame, over those
+		};
+
+		// One entry per scope path seen in the window: queue order, then in
+		// the order the scopes first appear
+		std::vector<ScopeStats> ComputeStats() const;
+
+		// Two ComputeStats() snapshots side by side, for A/B timing a
+		// setting (the Debug panel's fp16 shading comparison)
+		struct ScopeComparison
+		{
+			std::string path;
+			GpuQueue queue = GpuQueue::Graphics;
+			uint32_t depth = 0;
+			float baselineAvg = 0.0f;
+			float candidateAvg = 0.0f;
+			float baselineP95 = 0.0f;
+			float candidateP95 = 0.0f;
+
+			float GetDeltaMs() const { return candidateAvg - baselineAvg; }
+			// Of the baseline average: -0.25 = a quarter faster
+			float GetDeltaFraction() const { return baselineAvg > 0.0f ? GetDeltaMs() / baselineAvg : 0.0f; }
+		};
+
+		// Scopes in both snapshots (same path and queue), in baseline order
+		static std::vector<ScopeComparison> CompareStats(const std::vector<ScopeStats>& baseline,
+			const std::vector<ScopeStats>& candidate);
+
+	private:
+		struct PathInfo
+		{
+			std::string path;
+			GpuQueue queue = GpuQueue::Graphics;
+			uint32_t depth = 0;
+		};
+
+		struct Sample
+		{
+			uint32_t path;
+			float ms;
+			bool hasPipelineStats;
+			GpuPipelineStats pipelineStats;
+		};
+
+		struct Frame
+		{
+			GpuFrameProfile profile;
+			std::vector<Sample> samples;   // one per distinct path
+		};
+
+		// The path of `span` under the path `parent` (NO_PARENT at the top)
+		uint32_t InternPath(uint32_t parent, const GpuSpan& span);
+
+		uint32_t m_Capacity;
+		std::deque<Frame> m_Frames;   // oldest first
+
+		// Grows with every distinct path ever pushed; Clear() resets it
+		std::vector<PathInfo> m_Paths;
+		std::unordered_map<uint64_t, uint32_t> m_PathIds;   // parent path, queue, name
+	};
+}
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+// GpuQuerySegments.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/GpuQuerySegments.hpp"
+
+namespace Nightbloom
+{
+	void GpuQuerySegments::Reset(uint32_t maxSegments)
+	{
+		m_MaxSegments = maxSegments;
+		m_Open = NONE;
+		m_Stack.clear();
+		m_Owners.clear();
+		m_Incomplete.clear();
+	}
+
+	GpuQuerySegments::Switch GpuQuerySegments::BeginScope(uint32_t scope)
+	{
+		Switch change;
+		change.end = m_Open;
+		m_Stack.push_back(scope);
+		change.begin = Open(scope);
+		return change;
+	}
+
+	GpuQuerySegments::Switch GpuQuerySegments::EndScope(uint32_t scope)
+	{
+		Switch change;
+		if (m_Stack.empty() || m_Stack.back() != scope)
+			return change;
+
+		change.end = m_Open;
+		m_Stack.pop_back();
+		m_Open = NONE;
+		if (!m_Stack.empty())
+			change.begin = Open(m_Stack.back());
+		return change;
+	}
+
+	uint32_t GpuQuerySegments::Open(uint32_t scope)
+	{
+		if (m_Owners.size() >= m_MaxSegments)
+		{
+			m_Incomplete.push_back(scope);
+			m_Open = NONE;
+			return NONE;
+		}
+
+		m_Open = static_cast<uint32_t>(m_Owners.size());
+		m_Owners.push_back(scope);
+		return m_Open;
+	}
+
+	std::vector<GpuQuerySegments::Total> GpuQuerySegments::Resolve(const std::vector<GpuPipelineStats>& segments,
+		const std::vector<uint32_t>& parents) const
+	{
+		std::vector<Total> totals(parents.size());
+		for (size_t s = 0; s < m_Owners.size() && s < segments.size(); ++s)
+		{
+			if (m_Owners[s] < totals.size())
+				totals[m_Owners[s]].stats += segments[s];
+		}
+		for (uint32_t scope : m_Incomplete)
+		{
+			if (scope < totals.size())
+				totals[scope].complete = false;
+		}
+
+		// Children come after their parents: fold them in back to front
+		for (size_t s = totals.size(); s-- > 0;)
+		{
+			const uint32_t parent = parents[s];
+			if (parent >= s) continue;
+			totals[parent].stats += totals[s].stats;
+			totals[parent].complete = totals[parent].complete && totals[s].complete;
+		}
+		return totals;
+	}
+}
@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+// GpuQuerySegments.hpp
+//
+// Per-scope pipeline statistics / occlusion counts for GpuProfiler. Unlike
+// timestamps, those queries can't nest: only one query of a type may be
+// active in a command buffer. So a scope's counts are collected in
+// segments, one query each: beginning a child ends the parent's segment,
+// ending the child begins a new one for the parent. A scope's total is its
+// own segments plus its children's totals.
+//
+// Scopes are identified by their index in begin order (GpuProfiler's span
+// records), so a parent always has a lower index than its children. A scope
+// that ran out of segments (and its ancestors) is reported incomplete.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/GpuProfileHistory.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class GpuQuerySegments
+	{
+	public:
+		static constexpr uint32_t NONE = UINT32_MAX;
+
+		// The queries to end and then begin at a scope boundary
+		struct Switch
+		{
+			uint32_t end = NONE;
+			uint32_t begin = NONE;
+		};
+
+		struct Total
+		{
+			GpuPipelineStats stats;
+			bool complete = true;
+		};
+
+		// Forget the previous frame. 2 segments per scope is always enough.
+		void Reset(uint32_t maxSegments);
+
+		Switch BeginScope(uint32_t scope);
+		// `scope` must be the innermost open scope; anything else is ignored
+		Switch EndScope(uint32_t scope);
+
+		uint32_t GetSegmentCount() const { return static_cast<uint32_t>(m_Owners.size()); }
+
+		// `segments` holds one value per segment, `parents` one parent index
+		// per scope (GpuSpan::NO_PARENT for top level)
+		std::vector<Total> Resolve(const std::vector<GpuPipelineStats>& segments,
+			const std::vector<uint32_t>& parents) const;
+
+	private:
+		// Opens a segment for `scope`, or marks it incomplete when out of queries
+		uint32_t Open(uint32_t scope);
+
+		uint32_t m_MaxSegments = 0;
+		uint32_t m_Open = NONE;             // segment currently active
+		std::vector<uint32_t> m_Stack;      // open scopes, innermost last
+		std::vector<uint32_t> m_Owners;     // scope of each segment
+		std::vector<uint32_t> m_Incomplete; // scopes that missed a segment
+	};
+}
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+// GridMesh.hpp
+//
+// Regular grids drawn without a vertex buffer. A grid of `quads` x `quads`
+// cells has (quads + 1)^2 vertices numbered row by row; the vertex shader
+// turns gl_VertexIndex back into the vertex's [0,1]^2 position
+// (grid_vertex.glsl's GridVertexUV, GetVertexUV below) and places it from
+// there. Only the index list is real data, and it depends on nothing but
+// the grid size: ResourceManager::GetGridIndexBuffer builds one per size
+// and keeps it, so a grid changing resolution uploads nothing.
+//
+// Two CCW triangles per cell (seen from +Y, rows along +Z):
+//
+//  row+1:  tl --- tr
+//           |  \ |
+//  row:    bl --- br
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class GridMesh
+	{
+	public:
+		static uint32_t GetVertexCount(uint32_t quads) { return (quads + 1) * (quads + 1); }
+		static uint32_t GetIndexCount(uint32_t quads) { return quads * quads * 6; }
+
+		// Position of vertex `vertexIndex` across the grid, [0,1] on both axes
+		static glm::vec2 GetVertexUV(uint32_t vertexIndex, uint32_t quads)
+		{
+			const uint32_t resolution = quads + 1;
+			return glm::vec2(static_cast<float>(vertexIndex % resolution),
+				static_cast<float>(vertexIndex / resolution)) / static_cast<float>(quads);
+		}
+
+		// alternateDiagonals flips the cell diagonal in a checkerboard. Off
+		// for the CDLOD patch grid: with one diagonal direction a fully
+		// morphed patch triangulates exactly like the next-coarser level,
+		// so the level switch doesn't pop.
+		static std::vector<uint32_t> GenerateIndices(uint32_t quads, bool alternateDiagonals = true)
+		{
+			std::vector<uint32_t> indices;
+			indices.reserve(GetIndexCount(quads));
+
+			const uint32_t resolution = quads + 1;
+			for (uint32_t row = 0; row < quads; ++row)
+			{
+				for (uint32_t col = 0; col < quads; ++col)
+				{
+					const uint32_t bl = row * resolution + col;
+					const uint32_t br = bl + 1;
+					const uint32_t tl = bl + resolution;
+					const uint32_t tr = tl + 1;
+
+					if (alternateDiagonals && (row + col) % 2 == 0)
+					{
+						// Diagonal: br → tl
+						indices.insert(indices.end(), { bl, tl, br, br, tl, tr });
+					}
+					else
+					{
+						// Diagonal: bl → tr
+						indices.insert(indices.end(), { bl, tl, tr, bl, tr, br });
+					}
+				}
+			}
+			return indices;
+		}
+	};
+}
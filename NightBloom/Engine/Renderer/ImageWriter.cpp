@@ -0,0 +1,428 @@
+//------------------------------------------------------------------------------
+// ImageWriter.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/ImageWriter.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		//----------------------------------------------------------------------
+		// Byte helpers
+		//----------------------------------------------------------------------
+
+		void PutU32BE(std::vector<uint8_t>& out, uint32_t value)
+		{
+			out.push_back(static_cast<uint8_t>(value >> 24));
+			out.push_back(static_cast<uint8_t>(value >> 16));
+			out.push_back(static_cast<uint8_t>(value >> 8));
+			out.push_back(static_cast<uint8_t>(value));
+		}
+
+		template<typename T>
+		void PutLE(std::vector<uint8_t>& out, T value)
+		{
+			uint8_t bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));   // every target the engine builds for is little-endian
+			out.insert(out.end(), bytes, bytes + sizeof(T));
+		}
+
+		void PutString(std::vector<uint8_t>& out, const char* text)
+		{
+			out.insert(out.end(), text, text + std::strlen(text) + 1);
+		}
+
+		//----------------------------------------------------------------------
+		// Checksums
+		//----------------------------------------------------------------------
+
+		const std::array<uint32_t, 256>& Crc32Table()
+		{
+			static const std::array<uint32_t, 256> table = []()
+			{
+				std::array<uint32_t, 256> t{};
+				for (uint32_t n = 0; n < 256; ++n)
+				{
+					uint32_t c = n;
+					for (int k = 0; k < 8; ++k)
+						c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					t[n] = c;
+				}
+				return t;
+			}();
+			return table;
+		}
+
+		uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+		{
+			const auto& table = Crc32Table();
+			crc = ~crc;
+			for (size_t i = 0; i < size; ++i)
+				crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+			return ~crc;
+		}
+
+		uint32_t Adler32(const uint8_t* data, size_t size)
+		{
+			constexpr uint32_t MOD = 65521;
+			constexpr size_t BLOCK = 5552;   // largest run whose sums can't overflow 32 bits
+			uint32_t a = 1, b = 0;
+			while (size > 0)
+			{
+				const size_t run = std::min(size, BLOCK);
+				for (size_t i = 0; i < run; ++i)
+				{
+					a += data[i];
+					b += a;
+				}
+				a %= MOD;
+				b %= MOD;
+				data += run;
+				size -= run;
+			}
+			return (b << 16) | a;
+		}
+
+		//----------------------------------------------------------------------
+		// Deflate, one block with the fixed Huffman code (RFC 1951 3.2.6)
+		//----------------------------------------------------------------------
+
+		constexpr uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		constexpr uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		constexpr uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		constexpr uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		constexpr uint32_t WINDOW_SIZE = 32768;
+		constexpr uint32_t HASH_BITS = 15;
+		constexpr uint32_t MIN_MATCH = 3;
+		constexpr uint32_t MAX_MATCH = 258;
+		constexpr uint32_t MAX_CHAIN = 32;   // candidates tried per position
+
+		class BitWriter
+		{
+		public:
+			explicit BitWriter(std::vector<uint8_t>& out) : m_Out(out) {}
+
+			// Data fields go least significant bit first
+			void Write(uint32_t bits, uint32_t count)
+			{
+				m_Buffer |= bits << m_Count;
+				m_Count += count;
+				while (m_Count >= 8)
+				{
+					m_Out.push_back(static_cast<uint8_t>(m_Buffer));
+					m_Buffer >>= 8;
+					m_Count -= 8;
+				}
+			}
+
+			// Huffman codes go most significant bit first
+			void WriteCode(uint32_t code, uint32_t length)
+			{
+				uint32_t reversed = 0;
+				for (uint32_t i = 0; i < length; ++i)
+					reversed |= ((code >> i) & 1u) << (length - 1 - i);
+				Write(reversed, length);
+			}
+
+			void Finish()
+			{
+				if (m_Count > 0)
+					m_Out.push_back(static_cast<uint8_t>(m_Buffer));
+				m_Buffer = 0;
+				m_Count = 0;
+			}
+
+		private:
+			std::vector<uint8_t>& m_Out;
+			uint32_t m_Buffer = 0;
+			uint32_t m_Count = 0;
+		};
+
+		void WriteSymbol(BitWriter& bits, uint32_t symbol)
+		{
+			if (symbol < 144)      bits.WriteCode(0x30 + symbol, 8);
+			else if (symbol < 256) bits.WriteCode(0x190 + (symbol - 144), 9);
+			else if (symbol < 280) bits.WriteCode(symbol - 256, 7);
+			else                   bits.WriteCode(0xC0 + (symbol - 280), 8);
+		}
+
+		void WriteMatch(BitWriter& bits, uint32_t length, uint32_t distance)
+		{
+			uint32_t l = 28;
+			while (LENGTH_BASE[l] > length) --l;
+			WriteSymbol(bits, 257 + l);
+			bits.Write(length - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+
+			uint32_t d = 29;
+			while (DISTANCE_BASE[d] > distance) --d;
+			bits.WriteCode(d, 5);
+			bits.Write(distance - DISTANCE_BASE[d], DISTANCE_EXTRA[d]);
+		}
+
+		uint32_t Hash3(const uint8_t* p)
+		{
+			const uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+			return (v * 2654435761u) >> (32 - HASH_BITS);
+		}
+
+		// Greedy LZ77 over hash chains of 3-byte prefixes
+		void Deflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+		{
+			BitWriter bits(out);
+			bits.Write(1, 1);   // BFINAL
+			bits.Write(1, 2);   // BTYPE = fixed Huffman
+
+			std::vector<int32_t> head(size_t(1) << HASH_BITS, -1);
+			std::vector<int32_t> prev(WINDOW_SIZE, -1);
+			auto insert = [&](size_t pos)
+			{
+				const uint32_t h = Hash3(data + pos);
+				prev[pos & (WINDOW_SIZE - 1)] = head[h];
+				head[h] = static_cast<int32_t>(pos);
+			};
+
+			size_t pos = 0;
+			while (pos < size)
+			{
+				uint32_t bestLength = 0;
+				uint32_t bestDistance = 0;
+				if (pos + MIN_MATCH <= size)
+				{
+					const uint32_t maxLength = static_cast<uint32_t>(std::min<size_t>(MAX_MATCH, size - pos));
+					int32_t candidate = head[Hash3(data + pos)];
+					for (uint32_t chain = 0; chain < MAX_CHAIN && candidate >= 0; ++chain)
+					{
+						const size_t distance = pos - static_cast<size_t>(candidate);
+						if (distance > WINDOW_SIZE)
+							break;
+
+						const uint8_t* a = data + candidate;
+						const uint8_t* b = data + pos;
+						if (a[bestLength] == b[bestLength])
+						{
+							uint32_t length = 0;
+							while (length < maxLength && a[length] == b[length])
+								++length;
+							if (length > bestLength)
+							{
+								bestLength = length;
+								bestDistance = static_cast<uint32_t>(distance);
+								if (length == maxLength)
+									break;
+							}
+						}
+						candidate = prev[static_cast<size_t>(candidate) & (WINDOW_SIZE - 1)];
+					}
+				}
+
+				if (bestLength >= MIN_MATCH)
+				{
+					WriteMatch(bits, bestLength, bestDistance);
+					const size_t end = pos + bestLength;
+					for (; pos < end; ++pos)
+					{
+						if (pos + MIN_MATCH <= size)
+							insert(pos);
+					}
+				}
+				else
+				{
+					WriteSymbol(bits, data[pos]);
+					if (pos + MIN_MATCH <= size)
+						insert(pos);
+					++pos;
+				}
+			}
+
+			WriteSymbol(bits, 256);   // end of block
+			bits.Finish();
+		}
+
+		void PutPngChunk(std::vector<uint8_t>& out, const char type[4], const uint8_t* data, size_t size)
+		{
+			PutU32BE(out, static_cast<uint32_t>(size));
+			const size_t start = out.size();
+			out.insert(out.end(), type, type + 4);
+			if (size > 0)
+				out.insert(out.end(), data, data + size);
+			PutU32BE(out, Crc32(out.data() + start, out.size() - start));
+		}
+
+		uint8_t Paeth(uint8_t left, uint8_t up, uint8_t upLeft)
+		{
+			const int p = int(left) + int(up) - int(upLeft);
+			const int pa = std::abs(p - int(left));
+			const int pb = std::abs(p - int(up));
+			const int pc = std::abs(p - int(upLeft));
+			if (pa <= pb && pa <= pc) return left;
+			return pb <= pc ? up : upLeft;
+		}
+
+		//----------------------------------------------------------------------
+		// OpenEXR attributes
+		//----------------------------------------------------------------------
+
+		void PutExrAttribute(std::vector<uint8_t>& out, const char* name, const char* type, uint32_t size)
+		{
+			PutString(out, name);
+			PutString(out, type);
+			PutLE<int32_t>(out, static_cast<int32_t>(size));
+		}
+
+		void PutExrBox(std::vector<uint8_t>& out, const char* name, uint32_t width, uint32_t height)
+		{
+			PutExrAttribute(out, name, "box2i", 16);
+			PutLE<int32_t>(out, 0);
+			PutLE<int32_t>(out, 0);
+			PutLE<int32_t>(out, static_cast<int32_t>(width) - 1);
+			PutLE<int32_t>(out, static_cast<int32_t>(height) - 1);
+		}
+	}
+
+	std::vector<uint8_t> EncodePng(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels)
+	{
+		if (!pixels || width == 0 || height == 0 || (channels != 3 && channels != 4))
+			return {};
+
+		// Every row Paeth-filtered (filter type 4) behind its filter byte
+		const size_t stride = static_cast<size_t>(width) * channels;
+		std::vector<uint8_t> filtered((stride + 1) * height);
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			const uint8_t* row = pixels + y * stride;
+			const uint8_t* above = y > 0 ? row - stride : nullptr;
+			uint8_t* dst = filtered.data() + y * (stride + 1);
+			dst[0] = 4;
+			for (size_t i = 0; i < stride; ++i)
+			{
+				const uint8_t left = i >= channels ? row[i - channels] : 0;
+				const uint8_t up = above ? above[i] : 0;
+				const uint8_t upLeft = (above && i >= channels) ? above[i - channels] : 0;
+				dst[1 + i] = static_cast<uint8_t>(row[i] - Paeth(left, up, upLeft));
+			}
+		}
+
+		// zlib stream: header (deflate, 32K window, no dictionary), data, Adler-32
+		std::vector<uint8_t> zlib = { 0x78, 0x01 };
+		Deflate(filtered.data(), filtered.size(), zlib);
+		PutU32BE(zlib, Adler32(filtered.data(), filtered.size()));
+
+		std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+		std::vector<uint8_t> header;
+		PutU32BE(header, width);
+		PutU32BE(header, height);
+		header.push_back(8);                           // bit depth
+		header.push_back(channels == 4 ? 6 : 2);       // RGBA / RGB
+		header.push_back(0);                           // deflate
+		header.push_back(0);                           // adaptive filtering
+		header.push_back(0);                           // not interlaced
+		PutPngChunk(png, "IHDR", header.data(), header.size());
+		PutPngChunk(png, "IDAT", zlib.data(), zlib.size());
+		PutPngChunk(png, "IEND", nullptr, 0);
+		return png;
+	}
+
+	std::vector<uint8_t> EncodeExr(const uint16_t* rgb, uint32_t width, uint32_t height)
+	{
+		if (!rgb || width == 0 || height == 0)
+			return {};
+
+		std::vector<uint8_t> exr = { 0x76, 0x2F, 0x31, 0x01, 2, 0, 0, 0 };   // magic, version 2, scanline
+
+		// Channels in the file's (alphabetical) order; each is HALF, not
+		// perceptually linear, unsubsampled
+		static const char* CHANNELS[3] = { "B", "G", "R" };
+		PutExrAttribute(exr, "channels", "chlist", 3 * 18 + 1);
+		for (const char* channel : CHANNELS)
+		{
+			PutString(exr, channel);
+			PutLE<int32_t>(exr, 1);     // HALF
+			exr.insert(exr.end(), { 0, 0, 0, 0 });   // pLinear + reserved
+			PutLE<int32_t>(exr, 1);     // xSampling
+			PutLE<int32_t>(exr, 1);     // ySampling
+		}
+		exr.push_back(0);
+
+		PutExrAttribute(exr, "compression", "compression", 1);
+		exr.push_back(0);               // NO_COMPRESSION: one scanline per chunk
+		PutExrBox(exr, "dataWindow", width, height);
+		PutExrBox(exr, "displayWindow", width, height);
+		PutExrAttribute(exr, "lineOrder", "lineOrder", 1);
+		exr.push_back(0);               // INCREASING_Y
+		PutExrAttribute(exr, "pixelAspectRatio", "float", 4);
+		PutLE<float>(exr, 1.0f);
+		PutExrAttribute(exr, "screenWindowCenter", "v2f", 8);
+		PutLE<float>(exr, 0.0f);
+		PutLE<float>(exr, 0.0f);
+		PutExrAttribute(exr, "screenWindowWidth", "float", 4);
+		PutLE<float>(exr, 1.0f);
+		exr.push_back(0);               // end of header
+
+		// Line offset table, then each line: y, byte count, then its B, G and R runs
+		const size_t lineBytes = static_cast<size_t>(width) * 3 * sizeof(uint16_t);
+		const size_t tableStart = exr.size();
+		const size_t firstLine = tableStart + static_cast<size_t>(height) * sizeof(uint64_t);
+		exr.reserve(firstLine + height * (8 + lineBytes));
+		for (uint32_t y = 0; y < height; ++y)
+			PutLE<uint64_t>(exr, firstLine + y * (8 + lineBytes));
+
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			PutLE<int32_t>(exr, static_cast<int32_t>(y));
+			PutLE<int32_t>(exr, static_cast<int32_t>(lineBytes));
+			const uint16_t* row = rgb + static_cast<size_t>(y) * width * 3;
+			for (int channel = 2; channel >= 0; --channel)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+					PutLE<uint16_t>(exr, row[x * 3 + channel]);
+			}
+		}
+		return exr;
+	}
+
+	bool WriteImageFile(const std::string& path, const std::vector<uint8_t>& bytes)
+	{
+		if (bytes.empty())
+			return false;
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,32 @@
+//------------------------------------------------------------------------------
+// ImageWriter.hpp
+//
+// Encoders for the images the engine writes out (offscreen captures): PNG
+// for display-referred 8-bit stills and OpenEXR for linear HDR ones.
+//
+// PNG rows are Paeth-filtered and deflated with the fixed Huffman code over
+// a hash-chain LZ77 match finder - a few times slower than zlib's level 1
+// and a little larger, but no dependency. EXR is scanline, uncompressed,
+// half-float RGB: what every compositor reads, and as fast to write as the
+// disk allows.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	// `channels` is 3 (RGB) or 4 (RGBA); rows top to bottom, tightly packed.
+	// Empty on bad arguments.
+	std::vector<uint8_t> EncodePng(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels);
+
+	// Interleaved half-float RGB (glm::packHalf1x16), rows top to bottom.
+	// Empty on bad arguments.
+	std::vector<uint8_t> EncodeExr(const uint16_t* rgb, uint32_t width, uint32_t height);
+
+	// Writes through a temporary file and a rename, creating missing parent
+	// directories. False if any step fails.
+	bool WriteImageFile(const std::string& path, const std::vector<uint8_t>& bytes);
+}
@@ -0,0 +1,318 @@
+//------------------------------------------------------------------------------
+// Ktx2.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Ktx2.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		struct Ktx2Header
+		{
+			uint8_t identifier[12];
+			uint32_t vkFormat;
+			uint32_t typeSize;
+			uint32_t pixelWidth;
+			uint32_t pixelHeight;
+			uint32_t pixelDepth;
+			uint32_t layerCount;
+			uint32_t faceCount;
+			uint32_t levelCount;
+			uint32_t supercompressionScheme;
+			uint32_t dfdByteOffset;
+			uint32_t dfdByteLength;
+			uint32_t kvdByteOffset;
+			uint32_t kvdByteLength;
+			uint64_t sgdByteOffset;
+			uint64_t sgdByteLength;
+		};
+		static_assert(sizeof(Ktx2Header) == 80, "KTX2 header is 80 bytes");
+
+		struct Ktx2LevelIndex
+		{
+			uint64_t byteOffset;
+			uint64_t byteLength;
+			uint64_t uncompressedByteLength;
+		};
+
+		// Khronos Data Format descriptor values (KHR_DF_*)
+		constexpr uint8_t DF_MODEL_RGBSDA = 1;
+		constexpr uint8_t DF_MODEL_BC1A = 128;
+		constexpr uint8_t DF_MODEL_BC3 = 130;
+		constexpr uint8_t DF_MODEL_BC4 = 131;
+		constexpr uint8_t DF_MODEL_BC5 = 132;
+		constexpr uint8_t DF_MODEL_BC7 = 134;
+		constexpr uint8_t DF_MODEL_ASTC = 162;
+		constexpr uint8_t DF_PRIMARIES_BT709 = 1;
+		constexpr uint8_t DF_TRANSFER_LINEAR = 1;
+
+		struct DfdSample
+		{
+			uint16_t bitOffset;
+			uint8_t bitLength;
+			uint8_t channel;
+		};
+
+		struct FormatInfo
+		{
+			uint32_t vkFormat;
+			TextureFormat format;
+			uint32_t blockDim;     // 1 for plain texels, 4 for 4x4 blocks
+			uint32_t blockBytes;
+			uint8_t colorModel;
+			std::vector<DfdSample> samples;
+		};
+
+		const std::vector<FormatInfo>& GetFormats()
+		{
+			static const std::vector<FormatInfo> formats = {
+				{ Ktx2Format::RGBA8_UNORM, TextureFormat::RGBA8, 1, 4, DF_MODEL_RGBSDA, { { 0, 8, 0 }, { 8, 8, 1 }, { 16, 8, 2 }, { 24, 8, 15 } } },
+				{ Ktx2Format::BC1_RGB_UNORM, TextureFormat::BC1_RGB, 4, 8, DF_MODEL_BC1A, { { 0, 64, 0 } } },
+				{ Ktx2Format::BC1_RGBA_UNORM, TextureFormat::BC1_RGBA, 4, 8, DF_MODEL_BC1A, { { 0, 64, 0 }, { 0, 64, 15 } } },
+				{ Ktx2Format::BC3_UNORM, TextureFormat::BC3_RGBA, 4, 16, DF_MODEL_BC3, { { 0, 64, 15 }, { 64, 64, 0 } } },
+				{ Ktx2Format::BC4_UNORM, TextureFormat::BC4_R, 4, 8, DF_MODEL_BC4, { { 0, 64, 0 } } },
+				{ Ktx2Format::BC5_UNORM, TextureFormat::BC5_RG, 4, 16, DF_MODEL_BC5, { { 0, 64, 0 }, { 64, 64, 1 } } },
+				{ Ktx2Format::BC7_UNORM, TextureFormat::BC7_RGBA, 4, 16, DF_MODEL_BC7, { { 0, 128, 0 } } },
+				{ Ktx2Format::ASTC_4x4_UNORM, TextureFormat::ASTC_4x4_RGBA, 4, 16, DF_MODEL_ASTC, { { 0, 128, 0 } } },
+			};
+			return formats;
+		}
+
+		// The engine samples colour textures as UNORM (ResourceManager::
+		// LoadTexture), so the sRGB twins load as their UNORM format
+		uint32_t StripSrgb(uint32_t vkFormat)
+		{
+			switch (vkFormat)
+			{
+			case 43: return Ktx2Format::RGBA8_UNORM;
+			case 132: return Ktx2Format::BC1_RGB_UNORM;
+			case 134: return Ktx2Format::BC1_RGBA_UNORM;
+			case 138: return Ktx2Format::BC3_UNORM;
+			case 146: return Ktx2Format::BC7_UNORM;
+			case 158: return Ktx2Format::ASTC_4x4_UNORM;
+			default: return vkFormat;
+			}
+		}
+
+		const FormatInfo* FindFormat(uint32_t vkFormat)
+		{
+			for (const FormatInfo& info : GetFormats())
+				if (info.vkFormat == vkFormat)
+					return &info;
+			return nullptr;
+		}
+
+		const char* SupercompressionName(uint32_t scheme)
+		{
+			switch (scheme)
+			{
+			case 1: return "BasisLZ";
+			case 2: return "Zstandard";
+			case 3: return "ZLIB";
+			default: return "unknown";
+			}
+		}
+
+		size_t LevelSize(const FormatInfo& info, uint32_t width, uint32_t height)
+		{
+			const size_t blocksX = (width + info.blockDim - 1) / info.blockDim;
+			const size_t blocksY = (height + info.blockDim - 1) / info.blockDim;
+			return blocksX * blocksY * info.blockBytes;
+		}
+
+		// Level data alignment: lcm(texel block size, 4)
+		uint64_t LevelAlignment(const FormatInfo& info)
+		{
+			return info.blockBytes % 4 == 0 ? info.blockBytes : info.blockBytes * 4;
+		}
+
+		std::vector<uint32_t> BuildDfd(const FormatInfo& info)
+		{
+			const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(info.samples.size());
+			const uint32_t dim = info.blockDim - 1;
+
+			std::vector<uint32_t> words;
+			words.push_back(4 + blockSize);                  // dfdTotalSize
+			words.push_back(0);                              // vendorId / descriptorType: Khronos basic
+			words.push_back(2u | (blockSize << 16));         // versionNumber 1.3, descriptorBlockSize
+			words.push_back(info.colorModel | (DF_PRIMARIES_BT709 << 8) | (DF_TRANSFER_LINEAR << 16));
+			words.push_back(dim | (dim << 8));               // texelBlockDimension
+			words.push_back(info.blockBytes);                // bytesPlane0
+			words.push_back(0);
+			for (const DfdSample& sample : info.samples)
+			{
+				words.push_back(sample.bitOffset | (uint32_t(sample.bitLength - 1) << 16) | (uint32_t(sample.channel) << 24));
+				words.push_back(0);                          // samplePosition
+				words.push_back(0);                          // sampleLower
+				words.push_back(sample.bitLength >= 32 ? 0xFFFFFFFFu : (1u << sample.bitLength) - 1);
+			}
+			return words;
+		}
+	}
+
+	size_t GetKtx2LevelSize(uint32_t vkFormat, uint32_t width, uint32_t height)
+	{
+		const FormatInfo* info = FindFormat(StripSrgb(vkFormat));
+		return info ? LevelSize(*info, width, height) : 0;
+	}
+
+	bool ParseKtx2(const uint8_t* data, size_t size, Ktx2Image& out, std::string& error)
+	{
+		Ktx2Header header{};
+		if (!data || size < sizeof(header))
+		{
+			error = "file too small for a KTX2 header";
+			return false;
+		}
+		std::memcpy(&header, data, sizeof(header));
+
+		if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+		{
+			error = "not a KTX2 file";
+			return false;
+		}
+		if (header.supercompressionScheme != 0)
+		{
+			error = std::string(SupercompressionName(header.supercompressionScheme)) +
+				" supercompression needs a transcoder, which is not built in";
+			return false;
+		}
+		if (header.vkFormat == 0)
+		{
+			error = "VK_FORMAT_UNDEFINED payload (Basis Universal/UASTC) needs a transcoder, which is not built in";
+			return false;
+		}
+
+		const FormatInfo* info = FindFormat(StripSrgb(header.vkFormat));
+		if (!info)
+		{
+			error = "unsupported vkFormat " + std::to_string(header.vkFormat);
+			return false;
+		}
+		if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 ||
+			header.layerCount > 1 || header.faceCount != 1)
+		{
+			error = "only single 2D images are supported";
+			return false;
+		}
+
+		// levelCount 0 asks the loader to generate mips; treat it as one level
+		const uint32_t levelCount = std::max(header.levelCount, 1u);
+		uint32_t maxLevels = 1;
+		for (uint32_t extent = std::max(header.pixelWidth, header.pixelHeight); extent > 1; extent >>= 1)
+			++maxLevels;
+		if (levelCount > maxLevels)
+		{
+			error = "more mip levels than the extent allows";
+			return false;
+		}
+		if (sizeof(header) + size_t(levelCount) * sizeof(Ktx2LevelIndex) > size)
+		{
+			error = "truncated level index";
+			return false;
+		}
+
+		out = Ktx2Image{};
+		out.vkFormat = info->vkFormat;
+		out.format = info->format;
+		out.width = header.pixelWidth;
+		out.height = header.pixelHeight;
+		out.levels.resize(levelCount);
+
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			Ktx2LevelIndex index{};
+			std::memcpy(&index, data + sizeof(header) + level * sizeof(Ktx2LevelIndex), sizeof(index));
+
+			const uint32_t width = std::max(1u, header.pixelWidth >> level);
+			const uint32_t height = std::max(1u, header.pixelHeight >> level);
+			if (index.byteLength != LevelSize(*info, width, height) ||
+				index.byteOffset % LevelAlignment(*info) != 0 ||
+				index.byteOffset > size || index.byteLength > size - index.byteOffset)
+			{
+				error = "level " + std::to_string(level) + " is truncated or has the wrong size";
+				return false;
+			}
+			out.levels[level] = { index.byteOffset, index.byteLength };
+		}
+		return true;
+	}
+
+	bool WriteKtx2(const std::string& path, uint32_t vkFormat, uint32_t width, uint32_t height,
+		const std::vector<std::vector<uint8_t>>& levels)
+	{
+		const FormatInfo* info = FindFormat(vkFormat);
+		if (!info || levels.empty() || width == 0 || height == 0)
+			return false;
+		for (size_t level = 0; level < levels.size(); ++level)
+		{
+			const uint32_t w = std::max(1u, width >> level), h = std::max(1u, height >> level);
+			if (levels[level].size() != LevelSize(*info, w, h))
+				return false;
+		}
+
+		const std::vector<uint32_t> dfd = BuildDfd(*info);
+		const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+
+		Ktx2Header header{};
+		std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+		header.vkFormat = vkFormat;
+		header.typeSize = 1;
+		header.pixelWidth = width;
+		header.pixelHeight = height;
+		header.faceCount = 1;
+		header.levelCount = levelCount;
+		header.dfdByteOffset = static_cast<uint32_t>(sizeof(header) + levelCount * sizeof(Ktx2LevelIndex));
+		header.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+		std::vector<uint8_t> bytes(header.dfdByteOffset + header.dfdByteLength);
+		std::memcpy(bytes.data() + header.dfdByteOffset, dfd.data(), header.dfdByteLength);
+
+		// Smallest mip first, as the spec recommends for streaming
+		std::vector<Ktx2LevelIndex> index(levelCount);
+		const uint64_t alignment = LevelAlignment(*info);
+		for (uint32_t level = levelCount; level-- > 0;)
+		{
+			bytes.resize((bytes.size() + alignment - 1) / alignment * alignment);
+			index[level] = { bytes.size(), levels[level].size(), levels[level].size() };
+			bytes.insert(bytes.end(), levels[level].begin(), levels[level].end());
+		}
+
+		std::memcpy(bytes.data(), &header, sizeof(header));
+		std::memcpy(bytes.data() + sizeof(header), index.data(), index.size() * sizeof(Ktx2LevelIndex));
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+}
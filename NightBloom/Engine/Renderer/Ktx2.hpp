@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+// Ktx2.hpp
+//
+// Reader and writer for KTX2 (Khronos texture container) files holding
+// GPU-ready 2D textures with a precomputed mip chain. The loader maps the
+// file and uploads the level bytes as they are - no decode and no runtime
+// mip generation.
+//
+// Only what the engine can upload directly is accepted: a single 2D image
+// (no array layers, cube faces or depth), stored uncompressed at the
+// container level, in one of the formats listed in Ktx2.cpp. Supercompressed
+// files (BasisLZ, Zstandard, ZLIB) and UASTC payloads need a transcoder the
+// engine doesn't ship; they are rejected with an error naming the scheme, and
+// the caller falls back to the source image.
+//
+// Formats are carried as raw VkFormat values so the cooker can use this
+// without a device.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/RenderDevice.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	// VkFormat values used by the cooker and the loader
+	namespace Ktx2Format
+	{
+		constexpr uint32_t RGBA8_UNORM = 37;
+		constexpr uint32_t BC1_RGB_UNORM = 131;
+		constexpr uint32_t BC1_RGBA_UNORM = 133;
+		constexpr uint32_t BC3_UNORM = 137;
+		constexpr uint32_t BC4_UNORM = 139;
+		constexpr uint32_t BC5_UNORM = 141;
+		constexpr uint32_t BC7_UNORM = 145;
+		constexpr uint32_t ASTC_4x4_UNORM = 157;
+	}
+
+	struct Ktx2Level
+	{
+		uint64_t offset = 0;   // from the start of the file
+		uint64_t size = 0;
+	};
+
+	struct Ktx2Image
+	{
+		uint32_t vkFormat = 0;
+		TextureFormat format = TextureFormat::RGBA8;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<Ktx2Level> levels;   // mip 0 first
+	};
+
+	// Validates the header, level index and every level's size against the
+	// format. On failure returns false with a reason in error.
+	bool ParseKtx2(const uint8_t* data, size_t size, Ktx2Image& out, std::string& error);
+
+	// levels[i] is mip i, each the exact compressed size for its extent.
+	// Written through a temporary file and a rename.
+	bool WriteKtx2(const std::string& path, uint32_t vkFormat, uint32_t width, uint32_t height,
+		const std::vector<std::vector<uint8_t>>& levels);
+
+	// Byte size of one mip level of a supported format; 0 if unsupported
+	size_t GetKtx2LevelSize(uint32_t vkFormat, uint32_t width, uint32_t height);
+}
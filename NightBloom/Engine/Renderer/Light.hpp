@@ -6,11 +6,14 @@
 //
 // GPU Layout (std140):
 //   Set 2, Binding 0 = SceneLightingData UBO
+//   Set 2, Bindings 1-2 = clustered point lights (LightData array + cluster
+//   lists, see LightClusterCuller.hpp)
 //------------------------------------------------------------------------------
 #pragma once
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <array>
 #include <cstdint>
 #include <string>
 #include <cmath>
@@ -34,13 +37,15 @@ namespace Nightbloom
 	//              attenuation is unused
 	//
 	// Point:       position.xyz = world position
+	//              position.w      = 1, or 2 if it casts shadows; the renderer
+	//                                turns 2 into its shadow slot (LocalShadowAtlas.hpp)
 	//              attenuation.xyz = constant/linear/quadratic falloff
 	//              attenuation.w   = max radius (for culling / shader cutoff)
 	//--------------------------------------------------------------------------
 
 	struct LightData
 	{
-		glm::vec4 position = glm::vec4(0.0f, -1.0f, 0.0f, 0.0f);  // xyz = pos/dir, w = type (0=dir, 1=point)
+		glm::vec4 position = glm::vec4(0.0f, -1.0f, 0.0f, 0.0f);  // xyz = pos/dir, w = type (0=dir, >=1=point)
 		glm::vec4 color = glm::vec4(1.f); // rgb = color, a = intensity
 		glm::vec4 attenuation = glm::vec4(1.0f, 0.09f, 0.032f, 50.0f);// constant, linear, quadratic, radius
 	};
@@ -61,7 +66,7 @@ namespace Nightbloom
 		// are rewritten every frame by Renderer::UpdateShadowMatrices when shadows are on.)
 		glm::mat4 lightSpaceMatrix[NUM_CASCADES] = { glm::mat4(1.0f) };
 		glm::vec4 cascadeSplits = glm::vec4(0.0f);  // view-space FAR distance of each cascade (selection)
-		glm::vec4 cascadeRadii  = glm::vec4(1.0f);  // ortho half-size (world units) of each cascade (bias scaling)
+		glm::vec4 cascadeRadii  = glm::vec4(1.0f);  // ortho half-size (world units) of each cascade over a full layer (bias scaling)
 		glm::vec4 shadowParams = glm::vec4(0.005f, 0.02f, 0.0f, 1.0f);
 		// x = bias, y = normalBias, z = debug cascade tint (1=on), w = enabled (1/0)
 		glm::vec4 extraParams = glm::vec4(0.25f, 0.0f, 0.0f, 0.0f);
@@ -69,7 +74,7 @@ namespace Nightbloom
 	};
 
 	//--------------------------------------------------------------------------
-	// Scene lighting UBO - uploaded once per frame
+	// Scene lighting UBO - per frame in flight, re-uploaded when it changes
 	//
 	// This maps directly to a GLSL uniform block:
 	//
@@ -110,6 +115,26 @@ namespace Nightbloom
 		float splitLambda    = 0.85f;   // PSSM blend: 0 = uniform splits, 1 = logarithmic (higher = sharper near)
 		float casterExtrude  = 50.0f;   // Extra depth pulled toward the light so off-frustum occluders still cast
 		float cascadeBlend   = 0.25f;   // Cross-fade fraction between cascades (hides the boundary seam)
+		bool  fitSplitsToDepth = true;  // Split only the view depth range that holds geometry (ShadowDepthBounds.hpp)
+		// Fraction of the shadow resolution each cascade renders at (ShadowCascadeResolution.hpp)
+		std::array<float, NUM_CASCADES> cascadeResolutionScale = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		// --- Cascade caching (see ShadowCascadeCache.hpp) ---
+		bool     cacheFarCascades      = true;   // Far cascades keep their matrix + static depth between refreshes
+		uint32_t nearCascadesPerFrame  = 2;      // Cascades [0, n) refit and fully redraw every frame (min 1)
+		uint32_t farCascadeRefreshFrames = 8;    // Each far cascade refits at least this often (round-robin)
+		float    cacheLightAngleDeg    = 0.5f;   // Light turning further than this since a refresh makes it due
+		float    cachePadding          = 0.1f;   // Far-cascade ortho padding (fraction of radius) the camera may drift into
+
+		// Draw all cascades in one layered pass (gl_Layer fan-out) instead of one pass per
+		// cascade. Ignored when the device lacks SupportsFeature("shader_output_layer").
+		bool     singlePassCascades    = true;
+
+		// While the terrain's heightfield sun shadow is baked (TerrainSunShadow.hpp)
+		// the terrain casts into cascades [0, n) only; the map shadows the rest
+		uint32_t terrainCascades       = 1;
+
+		bool operator==(const ShadowConfig&) const = default;
 	};
 
 	//--------------------------------------------------------------------------
@@ -139,6 +164,10 @@ namespace Nightbloom
 		// Shadow configuration
 		ShadowConfig shadowConfig;
 
+		// SceneStreamer cell the light was streamed in with, -1 for lights
+		// that stay loaded. Not saved.
+		int32_t streamCell = -1;
+
 		//----------------------------------------------------------------------
 		// Pack into GPU-ready LightData
 		//----------------------------------------------------------------------
@@ -153,8 +182,8 @@ namespace Nightbloom
 			}
 			else // Point
 			{
-				// Position stored in xyz, w = 1 signals point
-				data.position = glm::vec4(position, 1.0f);
+				// Position stored in xyz, w = 1 signals point (2: asks for a shadow)
+				data.position = glm::vec4(position, shadowConfig.castsShadows ? 2.0f : 1.0f);
 			}
 
 			data.color = glm::vec4(color, intensity);
@@ -198,7 +227,8 @@ namespace Nightbloom
 			}
 			else
 			{
-				// Point lights would use perspective + cube map (not implemented)
+				// Point lights render six faces into the local shadow atlas instead
+				// (LocalShadowAtlas.hpp); there is no single matrix for them
 				return glm::mat4(1.0f);
 			}
 		}
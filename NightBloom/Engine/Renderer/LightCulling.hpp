@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// LightCulling.hpp
+//
+// CPU-side choice of the lights that go to the GPU each frame (Scene's
+// BuildLightingData / BuildPointLights). Directional lights always pass, in
+// scene order: lights[0] is the sun the shadow cascades follow. Point lights
+// whose sphere of influence misses the view frustum are dropped and the rest
+// ordered by importance, so when more are visible than a buffer holds the
+// tail that gets cut is the least noticeable.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Light.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Rough contribution of a point light as seen from viewPos: peak
+	// brightness, times radius^2 / distance^2. The distance is clamped to a
+	// tenth of the radius so the lights around the camera don't all tie.
+	inline float PointLightImportance(const Light& light, const glm::vec3& viewPos)
+	{
+		const float brightness = light.intensity * std::max({ light.color.r, light.color.g, light.color.b });
+		const glm::vec3 toLight = light.position - viewPos;
+		const float minDistance = std::max(light.radius * 0.1f, 0.01f);
+		const float distanceSq = std::max(glm::dot(toLight, toLight), minDistance * minDistance);
+		return brightness * light.radius * light.radius / distanceSq;
+	}
+
+	// The radius' bounding box against the frustum (conservative)
+	inline bool PointLightInFrustum(const Light& light, const Frustum& frustum)
+	{
+		return frustum.Intersects(light.position, glm::vec3(light.radius));
+	}
+
+	// Enabled lights in upload order: directional lights (scene order), then
+	// the point lights frustum doesn't cull (null = no culling) by descending
+	// importance. Point lights only with pointLightsOnly. Reuses out's
+	// capacity; returns how many point lights the frustum culled.
+	inline uint32_t SelectLights(const std::vector<Light>& lights, const Frustum* frustum,
+		const glm::vec3& viewPos, std::vector<LightData>& out, bool pointLightsOnly = false)
+	{
+		out.clear();
+
+		std::vector<std::pair<float, const Light*>> points;
+		points.reserve(lights.size());
+		uint32_t culled = 0;
+		for (const Light& light : lights)
+		{
+			if (!light.enabled)
+				continue;
+
+			if (light.type == LightType::Directional)
+			{
+				if (!pointLightsOnly)
+					out.push_back(light.ToGPUData());
+				continue;
+			}
+
+			if (frustum && !PointLightInFrustum(light, *frustum))
+			{
+				++culled;
+				continue;
+			}
+			points.emplace_back(PointLightImportance(light, viewPos), &light);
+		}
+
+		// Stable: equal lights keep scene order, so the cut doesn't flicker
+		std::stable_sort(points.begin(), points.end(),
+			[](const auto& a, const auto& b) { return a.first > b.first; });
+		for (const auto& point : points)
+			out.push_back(point.second->ToGPUData());
+
+		return culled;
+	}
+}
@@ -0,0 +1,569 @@
+//------------------------------------------------------------------------------
+// LocalShadowAtlas.hpp
+//
+// Point light shadows, rendered into one depth atlas beside the sun's
+// cascades. Each frame every point light that casts shadows
+// (ShadowConfig::castsShadows, which Light::ToGPUData marks with
+// position.w = POINT_SHADOW_REQUEST) is weighed by how large its sphere of
+// influence appears on screen. The MAX_LOCAL_SHADOWS largest get six square
+// tiles, one per cube face, sized to match: a light filling the view gets
+// maxTileSize texels a face, a distant one minTileSize. Tiles come from a
+// quadtree (buddy) allocator over the atlas, so every size is a power of two
+// and a small tile never strands the space of a larger one.
+//
+// A light keeps its slot, its tiles and what was rendered into them while
+// it stays selected at the same requested size and neither moves nor
+// changes radius. LocalShadowMaps redraws a slot only when the signature of
+// the casters inside the light's radius changes (a mesh moved, appeared or
+// went away), so a static light costs nothing after its first frame.
+//
+// The renderer tells the shaders which slot a light has through
+// position.w: SLOT_W_BASE + slot for a light with tiles, 1 (a plain point
+// light) for everything else, see EncodeLight.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Light.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/Components/SignatureHash.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace Nightbloom
+{
+	static constexpr uint32_t MAX_LOCAL_SHADOWS = 8;   // mirrored in shadows.glsl
+	static constexpr uint32_t LOCAL_SHADOW_FACES = 6;  // +X, -X, +Y, -Y, +Z, -Z
+
+	struct LocalShadowSettings
+	{
+		bool enabled = true;
+		uint32_t maxLights = MAX_LOCAL_SHADOWS;   // lights shadowed at once, the largest on screen first
+		uint32_t maxTileSize = 1024;     // texels per face for a light that fills the view
+		uint32_t minTileSize = 64;       // the smallest tile, and the allocator's granularity
+		float tileScale = 0.5f;          // face texels per pixel of the light's on-screen diameter
+		float nearPlane = 0.05f;         // casters closer to the light than this are clipped
+		float normalBias = 1.5f;         // receivers pushed along their normal, in texels
+		bool cacheStatic = true;         // redraw a light only when a caster in its range changes
+
+		bool operator==(const LocalShadowSettings&) const = default;
+	};
+
+	// Set 3 binding 3; std140, mirrors LocalShadowBlock in shadows.glsl
+	struct LocalShadowUniforms
+	{
+		glm::mat4 faceMatrices[MAX_LOCAL_SHADOWS * LOCAL_SHADOW_FACES];   // world -> atlas clip space
+		glm::vec4 faceRects[MAX_LOCAL_SHADOWS * LOCAL_SHADOW_FACES];      // the tile's uv, inset half a texel (min.xy, max.xy)
+		glm::vec4 lightParams[MAX_LOCAL_SHADOWS];   // x = texel size per unit of distance, y = normal bias (texels), w = 1 if live
+		glm::vec4 atlas = glm::vec4(0.0f);          // x = 1 / atlas size
+	};
+
+	struct LocalShadowTile
+	{
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t size = 0;
+
+		bool operator==(const LocalShadowTile&) const = default;
+	};
+
+	// One light that asks for a shadow this frame
+	struct LocalShadowRequest
+	{
+		uint64_t key = 0;                // LocalShadowAtlas::LightKey
+		float texels = 0.0f;             // face size it would like; 0 = off screen
+	};
+
+	struct LocalShadowSlot
+	{
+		bool active = false;
+		uint64_t key = 0;
+		uint32_t requestedSize = 0;      // what the light asked for (the tiles may be smaller)
+		std::array<LocalShadowTile, LOCAL_SHADOW_FACES> faces{};
+		bool rendered = false;
+		uint64_t renderedSignature = 0;  // of the casters drawn into the faces
+	};
+
+	class LocalShadowAtlas
+	{
+	public:
+		static constexpr float POINT_SHADOW_REQUEST = 2.0f;   // position.w from Light::ToGPUData
+		static constexpr float SLOT_W_BASE = 2.0f;            // position.w of a light in slot 0
+
+		// Identifies a light from frame to frame: its position and radius
+		static uint64_t LightKey(const LightData& light)
+		{
+			SignatureHash hash;
+			hash.Mix(light.position.x);
+			hash.Mix(light.position.y);
+			hash.Mix(light.position.z);
+			hash.Mix(light.attenuation.w);
+			return hash.Get();
+		}
+
+		static bool WantsShadow(const LightData& light)
+		{
+			return light.position.w > POINT_SHADOW_REQUEST - 0.5f;
+		}
+
+		// The light as the shaders see it: slot < 0 drops the shadow
+		static LightData EncodeLight(const LightData& light, int32_t slot)
+		{
+			LightData encoded = light;
+			encoded.position.w = slot >= 0 ? SLOT_W_BASE + static_cast<float>(slot) : 1.0f;
+			return encoded;
+		}
+
+		// Diameter in pixels the light's sphere covers on a view viewportHeight
+		// pixels high (focalY = proj[1][1]); 0 when the sphere is outside the
+		// frustum. Inside the sphere it covers the whole view.
+		static float ScreenDiameter(const glm::vec3& center, float radius, const glm::mat4& view, float focalY,
+			float viewportHeight, const Frustum& frustum)
+		{
+			for (const glm::vec4& plane : frustum.planes)
+			{
+				if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+					return 0.0f;
+			}
+
+			const glm::vec3 viewCenter = glm::vec3(view * glm::vec4(center, 1.0f));
+			const float distanceSq = glm::dot(viewCenter, viewCenter);
+			if (distanceSq <= radius * radius)
+				return viewportHeight;
+
+			const float diameter = viewportHeight * std::abs(focalY) * radius / std::sqrt(distanceSq - radius * radius);
+			return std::min(diameter, viewportHeight);
+		}
+
+		// Power-of-two face size for `texels`, within the settings. A light
+		// keeps its previous size until it wants a quarter less or two and a
+		// half times as much, so one hovering at a boundary doesn't flip (and
+		// redraw) every frame.
+		static uint32_t ChooseTileSize(float texels, uint32_t previousSize, const LocalShadowSettings& settings,
+			uint32_t atlasSize)
+		{
+			const uint32_t maxSize = std::max(FloorPow2(std::min(settings.maxTileSize, atlasSize / 4)), 1u);
+			const uint32_t minSize = std::min(std::max(FloorPow2(settings.minTileSize), 1u), maxSize);
+
+			if (previousSize >= minSize && previousSize <= maxSize &&
+				texels >= previousSize * 0.75f && texels < previousSize * 2.5f)
+			{
+				return previousSize;
+			}
+
+			const float clamped = std::clamp(texels, static_cast<float>(minSize), static_cast<float>(maxSize));
+			return std::clamp(FloorPow2(static_cast<uint32_t>(clamped)), minSize, maxSize);
+		}
+
+		// Whether a box (a draw's bounds) reaches into a light's sphere
+		static bool BoxTouchesSphere(const glm::vec3& boxCenter, const glm::vec3& boxExtents, const glm::vec4& sphere)
+		{
+			const glm::vec3 center(sphere);
+			const glm::vec3 offset = glm::clamp(center, boxCenter - boxExtents, boxCenter + boxExtents) - center;
+			return glm::dot(offset, offset) <= sphere.w * sphere.w;
+		}
+
+		// Which face of a light a point lies in, by the major axis of the
+		// direction from the light (as LocalLightShadow in shadows.glsl)
+		static uint32_t SelectFace(const glm::vec3& fromLight)
+		{
+			const glm::vec3 a = glm::abs(fromLight);
+			if (a.x >= a.y && a.x >= a.z)
+				return fromLight.x >= 0.0f ? 0u : 1u;
+			if (a.y >= a.z)
+				return fromLight.y >= 0.0f ? 2u : 3u;
+			return fromLight.z >= 0.0f ? 4u : 5u;
+		}
+
+		// A face's view-projection, Vulkan clip space (y down, depth 0..1) out
+		// to the light's radius. Rendered with the viewport on the face's tile.
+		static glm::mat4 FaceViewProj(const glm::vec3& position, float radius, uint32_t face, float nearPlane)
+		{
+			static const glm::vec3 directions[LOCAL_SHADOW_FACES] = {
+				{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+				{ 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+				{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+			static const glm::vec3 ups[LOCAL_SHADOW_FACES] = {
+				{ 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+				{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f },
+				{ 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+
+			const float nearDistance = std::max(nearPlane, 0.001f);
+			const float farDistance = std::max(radius, nearDistance * 2.0f);
+			glm::mat4 proj = glm::perspectiveRH_ZO(glm::half_pi<float>(), 1.0f, nearDistance, farDistance);
+			proj[1][1] *= -1.0f;
+			return proj * glm::lookAt(position, position + directions[face], ups[face]);
+		}
+
+		// Maps a face's clip space onto its tile of the atlas, for sampling
+		static glm::mat4 TileTransform(const LocalShadowTile& tile, uint32_t atlasSize)
+		{
+			const float atlas = static_cast<float>(atlasSize);
+			const float scale = static_cast<float>(tile.size) / atlas;
+			glm::mat4 transform(1.0f);
+			transform[0][0] = scale;
+			transform[1][1] = scale;
+			transform[3][0] = 2.0f * static_cast<float>(tile.x) / atlas + scale - 1.0f;
+			transform[3][1] = 2.0f * static_cast<float>(tile.y) / atlas + scale - 1.0f;
+			return transform;
+		}
+
+		// The tile's uv range, half a texel in so PCF taps clamped to it never
+		// read the neighbouring tile
+		static glm::vec4 TileRect(const LocalShadowTile& tile, uint32_t atlasSize)
+		{
+			const float atlas = static_cast<float>(atlasSize);
+			return glm::vec4(
+				(static_cast<float>(tile.x) + 0.5f) / atlas,
+				(static_cast<float>(tile.y) + 0.5f) / atlas,
+				(static_cast<float>(tile.x + tile.size) - 0.5f) / atlas,
+				(static_cast<float>(tile.y + tile.size) - 0.5f) / atlas);
+		}
+
+		explicit LocalShadowAtlas(uint32_t atlasSize = 4096) : m_AtlasSize(FloorPow2(std::max(atlasSize, 1u))) {}
+
+		uint32_t GetAtlasSize() const { return m_AtlasSize; }
+		const LocalShadowSlot& GetSlot(uint32_t slot) const { return m_Slots[slot]; }
+
+		// Hands out this frame's slots. outSlots[i] is requests[i]'s slot, or
+		// -1 when it gets no shadow (off screen, past maxLights or out of
+		// atlas space). Lights that keep their key and requested size keep
+		// their slot and tiles; the rest are placed largest first. A kept
+		// light shrunk to fit grows back to its requested size once there's
+		// room.
+		void Assign(const std::vector<LocalShadowRequest>& requests, const LocalShadowSettings& settings,
+			std::vector<int32_t>& outSlots)
+		{
+			outSlots.assign(requests.size(), -1);
+
+			const uint32_t minTile = std::min(std::max(FloorPow2(settings.minTileSize), 1u),
+				std::max(FloorPow2(std::min(settings.maxTileSize, m_AtlasSize / 4)), 1u));
+			if (minTile != m_MinTile)
+			{
+				// The tree's depth changes; nothing placed on the old one carries over
+				m_MinTile = minTile;
+				m_Slots = {};
+			}
+			ResetTree();
+
+			std::vector<uint32_t> order(requests.size());
+			std::iota(order.begin(), order.end(), 0u);
+			order.erase(std::remove_if(order.begin(), order.end(),
+				[&](uint32_t i) { return !(requests[i].texels > 0.0f); }), order.end());
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+			{
+				if (requests[a].texels != requests[b].texels)
+					return requests[a].texels > requests[b].texels;
+				return requests[a].key < requests[b].key;
+			});
+			order.resize(std::min<size_t>(order.size(), std::min(settings.maxLights, MAX_LOCAL_SHADOWS)));
+
+			// What each selected light wants, given what it had
+			std::vector<uint32_t> sizes(order.size());
+			std::vector<int32_t> previous(order.size(), -1);
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				const LocalShadowRequest& request = requests[order[i]];
+				uint32_t previousSize = 0;
+				for (uint32_t s = 0; s < MAX_LOCAL_SHADOWS; ++s)
+				{
+					if (m_Slots[s].active && m_Slots[s].key == request.key)
+					{
+						previous[i] = static_cast<int32_t>(s);
+						previousSize = m_Slots[s].requestedSize;
+					}
+				}
+				sizes[i] = ChooseTileSize(request.texels, previousSize, settings, m_AtlasSize);
+			}
+
+			// Unchanged lights first: their old tiles were disjoint, so they fit again
+			std::array<LocalShadowSlot, MAX_LOCAL_SHADOWS> next{};
+			std::vector<bool> placed(order.size(), false);
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				if (previous[i] < 0 || m_Slots[previous[i]].requestedSize != sizes[i])
+					continue;
+
+				const LocalShadowSlot& kept = m_Slots[previous[i]];
+				for (const LocalShadowTile& tile : kept.faces)
+					ReserveTile(tile);
+				next[previous[i]] = kept;
+				outSlots[order[i]] = previous[i];
+				placed[i] = true;
+			}
+
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				if (placed[i])
+					continue;
+
+				int32_t slot = (previous[i] >= 0 && !next[previous[i]].active) ? previous[i] : -1;
+				for (uint32_t s = 0; s < MAX_LOCAL_SHADOWS && slot < 0; ++s)
+				{
+					if (!next[s].active && !IsClaimed(previous, placed, s))
+						slot = static_cast<int32_t>(s);
+				}
+				if (slot < 0)
+					continue;
+
+				LocalShadowSlot entry;
+				entry.key = requests[order[i]].key;
+				entry.requestedSize = sizes[i];
+				for (uint32_t size = sizes[i]; size >= m_MinTile && !entry.active; size /= 2)
+					entry.active = AllocateFaces(size, entry.faces);
+				if (!entry.active)
+					continue;   // out of atlas space, even at the smallest size
+
+				next[slot] = entry;
+				outSlots[order[i]] = slot;
+			}
+
+			// Kept lights that were shrunk under atlas pressure take back what
+			// they asked for once the space is free again
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				if (outSlots[order[i]] < 0)
+					continue;
+
+				LocalShadowSlot& entry = next[outSlots[order[i]]];
+				const uint32_t current = entry.faces[0].size;
+				if (current >= entry.requestedSize)
+					continue;
+
+				const std::array<LocalShadowTile, LOCAL_SHADOW_FACES> shrunk = entry.faces;
+				for (const LocalShadowTile& tile : shrunk)
+					Release(tile);
+
+				bool grown = false;
+				for (uint32_t size = entry.requestedSize; size > current && !grown; size /= 2)
+					grown = AllocateFaces(size, entry.faces);
+				if (grown)
+				{
+					entry.rendered = false;
+					continue;
+				}
+
+				entry.faces = shrunk;
+				for (const LocalShadowTile& tile : shrunk)
+					ReserveTile(tile);
+			}
+
+			m_Slots = next;
+		}
+
+		// Whether the slot's faces must be drawn for casters hashing to signature
+		bool NeedsRender(uint32_t slot, uint64_t signature, bool cacheStatic) const
+		{
+			const LocalShadowSlot& entry = m_Slots[slot];
+			return entry.active && (!cacheStatic || !entry.rendered || entry.renderedSignature != signature);
+		}
+
+		void MarkRendered(uint32_t slot, uint64_t signature)
+		{
+			m_Slots[slot].rendered = true;
+			m_Slots[slot].renderedSignature = signature;
+		}
+
+		// Every slot draws again (the atlas was lost or the settings changed)
+		void Invalidate()
+		{
+			for (LocalShadowSlot& slot : m_Slots)
+				slot.rendered = false;
+		}
+
+		void FillUniforms(const std::vector<LightData>& lights, const std::vector<int32_t>& slots,
+			const LocalShadowSettings& settings, LocalShadowUniforms& out) const
+		{
+			out = LocalShadowUniforms{};
+			out.atlas.x = 1.0f / static_cast<float>(m_AtlasSize);
+			for (size_t i = 0; i < lights.size() && i < slots.size(); ++i)
+			{
+				if (slots[i] < 0)
+					continue;
+
+				const LightData& light = lights[i];
+				const LocalShadowSlot& slot = m_Slots[slots[i]];
+				for (uint32_t face = 0; face < LOCAL_SHADOW_FACES; ++face)
+				{
+					const uint32_t index = static_cast<uint32_t>(slots[i]) * LOCAL_SHADOW_FACES + face;
+					out.faceMatrices[index] = TileTransform(slot.faces[face], m_AtlasSize) *
+						FaceViewProj(glm::vec3(light.position), light.attenuation.w, face, settings.nearPlane);
+					out.faceRects[index] = TileRect(slot.faces[face], m_AtlasSize);
+				}
+				// A 90 degree face is 2 * distance wide
+				out.lightParams[slots[i]] = glm::vec4(2.0f / static_cast<float>(slot.faces[0].size),
+					settings.normalBias, 0.0f, 1.0f);
+			}
+		}
+
+	private:
+		enum class NodeState : uint8_t { Free, Split, Used };
+
+		static uint32_t FloorPow2(uint32_t value)
+		{
+			uint32_t result = 1;
+			while (result * 2 <= value && result * 2 != 0)
+				result *= 2;
+			return value == 0 ? 0 : result;
+		}
+
+		uint32_t LevelCount() const
+		{
+			uint32_t levels = 1;
+			for (uint32_t size = m_AtlasSize; size > m_MinTile; size /= 2)
+				++levels;
+			return levels;
+		}
+
+		void ResetTree()
+		{
+			const uint32_t levels = LevelCount();
+			m_Tree.resize(levels);
+			for (uint32_t level = 0; level < levels; ++level)
+				m_Tree[level].assign(static_cast<size_t>(1u << level) << level, NodeState::Free);
+		}
+
+		NodeState& Node(uint32_t level, uint32_t i, uint32_t j) { return m_Tree[level][(j << level) + i]; }
+
+		void Split(uint32_t level, uint32_t i, uint32_t j)
+		{
+			Node(level, i, j) = NodeState::Split;
+			for (uint32_t c = 0; c < 4; ++c)
+				Node(level + 1, i * 2 + (c & 1), j * 2 + (c >> 1)) = NodeState::Free;
+		}
+
+		uint32_t LevelOf(uint32_t size) const
+		{
+			uint32_t level = 0;
+			for (uint32_t s = m_AtlasSize; s > size; s /= 2)
+				++level;
+			return level;
+		}
+
+		// Marks exactly this tile used (its ancestors split); false if taken
+		bool ReserveTile(const LocalShadowTile& tile)
+		{
+			const uint32_t target = LevelOf(tile.size);
+			if (target >= m_Tree.size())
+				return false;
+			for (uint32_t level = 0; level <= target; ++level)
+			{
+				const uint32_t nodeSize = m_AtlasSize >> level;
+				const uint32_t i = tile.x / nodeSize;
+				const uint32_t j = tile.y / nodeSize;
+				NodeState& state = Node(level, i, j);
+				if (state == NodeState::Used)
+					return false;
+				if (level == target)
+				{
+					if (state != NodeState::Free)
+						return false;
+					state = NodeState::Used;
+					return true;
+				}
+				if (state == NodeState::Free)
+					Split(level, i, j);
+			}
+			return false;
+		}
+
+		// First fit, preferring space already split so whole free blocks
+		// stay whole for larger requests
+		bool Allocate(uint32_t level, uint32_t i, uint32_t j, uint32_t target, LocalShadowTile& out)
+		{
+			NodeState& state = Node(level, i, j);
+			if (state == NodeState::Used)
+				return false;
+			if (level == target)
+			{
+				if (state != NodeState::Free)
+					return false;
+				state = NodeState::Used;
+				out.size = m_AtlasSize >> level;
+				out.x = i * out.size;
+				out.y = j * out.size;
+				return true;
+			}
+
+			for (NodeState wanted : { NodeState::Split, NodeState::Free })
+			{
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					const uint32_t ci = i * 2 + (c & 1);
+					const uint32_t cj = j * 2 + (c >> 1);
+					if (state == NodeState::Split && Node(level + 1, ci, cj) != wanted)
+						continue;
+					if (state == NodeState::Free)
+						Split(level, i, j);
+					if (Allocate(level + 1, ci, cj, target, out))
+						return true;
+				}
+			}
+			return false;
+		}
+
+		void Release(const LocalShadowTile& tile)
+		{
+			uint32_t level = LevelOf(tile.size);
+			uint32_t i = tile.x / tile.size;
+			uint32_t j = tile.y / tile.size;
+			Node(level, i, j) = NodeState::Free;
+
+			// Merge back up while all four siblings are free
+			while (level > 0)
+			{
+				const uint32_t pi = i / 2;
+				const uint32_t pj = j / 2;
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					if (Node(level, pi * 2 + (c & 1), pj * 2 + (c >> 1)) != NodeState::Free)
+						return;
+				}
+				--level;
+				i = pi;
+				j = pj;
+				Node(level, i, j) = NodeState::Free;
+			}
+		}
+
+		// All six faces at `size`, or none
+		bool AllocateFaces(uint32_t size, std::array<LocalShadowTile, LOCAL_SHADOW_FACES>& faces)
+		{
+			const uint32_t target = LevelOf(size);
+			if (target >= m_Tree.size())
+				return false;
+			for (uint32_t face = 0; face < LOCAL_SHADOW_FACES; ++face)
+			{
+				if (!Allocate(0, 0, 0, target, faces[face]))
+				{
+					for (uint32_t undo = 0; undo < face; ++undo)
+						Release(faces[undo]);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// A slot an unchanged light still to be placed will keep
+		bool IsClaimed(const std::vector<int32_t>& previous, const std::vector<bool>& placed, uint32_t slot) const
+		{
+			for (size_t i = 0; i < previous.size(); ++i)
+			{
+				if (!placed[i] && previous[i] == static_cast<int32_t>(slot))
+					return true;
+			}
+			return false;
+		}
+
+		uint32_t m_AtlasSize = 4096;
+		uint32_t m_MinTile = 0;
+		std::array<LocalShadowSlot, MAX_LOCAL_SHADOWS> m_Slots{};
+		std::vector<std::vector<NodeState>> m_Tree;   // per level, row-major; level 0 is the whole atlas
+	};
+}
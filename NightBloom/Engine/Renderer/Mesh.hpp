@@ -1,14 +1,23 @@
 //------------------------------------------------------------------------------
 // Mesh.hpp
 //
-// GPU-resident mesh data (vertex buffer + index buffer)
+// GPU-resident mesh data: a range of the shared vertex buffer for its vertex
+// format and ranges of the shared index buffer, one for the full mesh and one
+// per simplified LOD over the same vertices (see MeshLod.hpp), plus the full
+// mesh's meshlets (Meshlet.hpp) when it has any, and a skinned mesh's
+// skinning source. All live in VulkanMeshArena; draws select the mesh with
+// vertexOffset/firstIndex.
 //------------------------------------------------------------------------------
 #pragma once
 
 #include "Engine/Renderer/RenderDevice.hpp"  // For Buffer base class
+#include "Engine/Renderer/MeshLod.hpp"
+#include "Engine/Renderer/VertexPacking.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMeshArena.hpp"
 #include <glm/glm.hpp>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace Nightbloom
 {
@@ -21,7 +30,7 @@ namespace Nightbloom
 		Mesh(const std::string& name) : m_Name(name) {}
 		~Mesh() = default;
 
-		// Mesh cannot be copied (owns GPU resources)
+		// Mesh cannot be copied (owns its arena ranges)
 		Mesh(const Mesh&) = delete;
 		Mesh& operator=(const Mesh&) = delete;
 
@@ -31,10 +40,8 @@ namespace Nightbloom
 
 		// Getters
 		const std::string& GetName() const { return m_Name; }
-		Buffer* GetVertexBuffer() const { return m_VertexBuffer.get(); }
-		Buffer* GetIndexBuffer() const { return m_IndexBuffer.get(); }
-		uint32_t GetIndexCount() const { return m_IndexCount; }
-		uint32_t GetVertexCount() const { return m_VertexCount; }
+		uint32_t GetIndexCount() const { return GetLodIndexCount(0); }
+		uint32_t GetVertexCount() const { return m_Geometry.GetVertices().count; }
 		Material* GetMaterial() const { return m_Material; }
 
 		// Bounds
@@ -43,28 +50,93 @@ namespace Nightbloom
 		glm::vec3 GetCenter() const { return (m_BoundsMin + m_BoundsMax) * 0.5f; }
 		glm::vec3 GetExtents() const { return (m_BoundsMax - m_BoundsMin) * 0.5f; }
 
+		// Vertex buffer layout. Packed vertices store positions quantized over
+		// the bounds; GetDequantizeTransform maps them back to object space.
+		VertexFormat GetVertexFormat() const { return m_Geometry.GetVertexFormat(); }
+		glm::mat4 GetDequantizeTransform() const { return m_Quantization.GetDequantizeTransform(); }
+
+		// Shared buffers; draw with GetVertexOffset as vertexOffset and the
+		// level's GetLodFirstIndex as firstIndex
+		Buffer* GetVertexBuffer() const { return m_Geometry.GetVertices().buffer; }
+		int32_t GetVertexOffset() const { return static_cast<int32_t>(m_Geometry.GetVertices().first); }
+
+		// LODs. Level 0 is the full mesh; coarser levels share the vertices.
+		uint32_t GetLodCount() const { return static_cast<uint32_t>(m_LodErrors.size()); }
+		Buffer* GetLodIndexBuffer(uint32_t lod) const { return IndexList(lod).buffer; }
+		uint32_t GetLodFirstIndex(uint32_t lod) const { return IndexList(lod).first; }
+		uint32_t GetLodIndexCount(uint32_t lod) const { return IndexList(lod).count; }
+		float GetLodError(uint32_t lod) const { return m_LodErrors[lod]; }
+
+		// Coarsest level within maxPixelError when one object-space unit
+		// covers pixelsPerUnit pixels
+		uint32_t SelectLod(float pixelsPerUnit, float maxPixelError) const
+		{
+			return SelectMeshLod(m_LodErrors.data(), GetLodCount(), pixelsPerUnit, maxPixelError);
+		}
+
+		// Meshlets of level 0, in VulkanMeshArena::GetMeshletBuffer. Bounds
+		// are in vertex-buffer space (quantized for Packed meshes). Only
+		// meshlets on the arena's first meshlet page can be culled, so a mesh
+		// whose meshlets landed elsewhere reports none and is drawn whole.
+		uint32_t GetFirstMeshlet() const { return MeshletRange().first; }
+		uint32_t GetMeshletCount() const { return MeshletRange().count; }
+
+		// Skinning source of a skinned mesh, in VulkanMeshArena::GetSkinBuffer
+		// and parallel to its vertices. Like meshlets, only the arena's first
+		// skin page is read, so a mesh whose skin landed elsewhere reports
+		// none and draws in its bind pose.
+		uint32_t GetSkinFirstVertex() const { return SkinRange().first; }
+		uint32_t GetSkinVertexCount() const { return SkinRange().count; }
+
 		// Setters
 		void SetName(const std::string& name) { m_Name = name; }
-		void SetVertexBuffer(std::unique_ptr<Buffer> buffer) { m_VertexBuffer = std::move(buffer); }
-		void SetIndexBuffer(std::unique_ptr<Buffer> buffer) { m_IndexBuffer = std::move(buffer); }
-		void SetIndexCount(uint32_t count) { m_IndexCount = count; }
-		void SetVertexCount(uint32_t count) { m_VertexCount = count; }
 		void SetMaterial(Material* material) { m_Material = material; }
 		void SetBounds(const glm::vec3& min, const glm::vec3& max) { m_BoundsMin = min; m_BoundsMax = max; }
 
+		// Vertices and index lists in the arena (VulkanMeshArena::Allocate and
+		// AppendIndices). lodErrors has one entry per index list after the
+		// first, error ascending (see MeshLodLevel).
+		void SetGeometry(MeshArenaAllocation geometry, const VertexQuantization& quantization,
+			const std::vector<float>& lodErrors)
+		{
+			m_Geometry = std::move(geometry);
+			m_Quantization = quantization;
+			m_LodErrors.assign(1, 0.0f);
+			m_LodErrors.insert(m_LodErrors.end(), lodErrors.begin(), lodErrors.end());
+		}
+
 		// Validity check
-		bool IsValid() const { return m_VertexBuffer != nullptr && m_IndexCount > 0; }
+		bool IsValid() const { return m_Geometry.IsValid() && GetIndexCount() > 0; }
 
 	private:
+		const MeshBufferRange& IndexList(uint32_t lod) const
+		{
+			static const MeshBufferRange empty;
+			return lod < m_Geometry.GetIndexListCount() ? m_Geometry.GetIndices(lod) : empty;
+		}
+
+		const MeshBufferRange& MeshletRange() const
+		{
+			static const MeshBufferRange empty;
+			const MeshBufferRange& meshlets = m_Geometry.GetMeshlets();
+			return meshlets.IsValid() && meshlets.page == 0 ? meshlets : empty;
+		}
+
+		const MeshBufferRange& SkinRange() const
+		{
+			static const MeshBufferRange empty;
+			const MeshBufferRange& skin = m_Geometry.GetSkin();
+			return skin.IsValid() && skin.page == 0 ? skin : empty;
+		}
+
 		std::string m_Name;
 
-		// GPU resources (owned)
-		std::unique_ptr<Buffer> m_VertexBuffer;
-		std::unique_ptr<Buffer> m_IndexBuffer;
+		// GPU ranges (owned, returned to the arena on destruction)
+		MeshArenaAllocation m_Geometry;
+		VertexQuantization m_Quantization;
 
-		// Counts
-		uint32_t m_IndexCount = 0;
-		uint32_t m_VertexCount = 0;
+		// One entry per level including 0
+		std::vector<float> m_LodErrors = { 0.0f };
 
 		// Material (non-owning - Model or ResourceManager owns materials)
 		Material* m_Material = nullptr;
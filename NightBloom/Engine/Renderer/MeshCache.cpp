@@ -0,0 +1,344 @@
+//------------------------------------------------------------------------------
+// MeshCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/MeshCache.hpp"
+#include "Engine/Core/MappedFile.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr char COOKED_MAGIC[4] = { 'N', 'B', 'M', 'C' };
+		constexpr uint32_t COOKED_VERSION = 3;   // 3: skinned models are no longer cooked
+		constexpr size_t BLOB_ALIGNMENT = 16;
+
+		struct CookedHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint64_t sourceHash;
+			uint32_t vertexStride;
+			uint32_t meshCount;
+			uint32_t materialCount;
+			uint32_t reserved;
+			uint64_t fileSize;
+		};
+
+		class CookedWriter
+		{
+		public:
+			template <typename T>
+			void Write(const T& value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+				m_Bytes.insert(m_Bytes.end(), bytes, bytes + sizeof(T));
+			}
+
+			void WriteString(const std::string& value)
+			{
+				Write(static_cast<uint32_t>(value.size()));
+				m_Bytes.insert(m_Bytes.end(), value.begin(), value.end());
+			}
+
+			// Count, padding to BLOB_ALIGNMENT, then the raw elements
+			template <typename T, typename Allocator>
+			void WriteBlob(const std::vector<T, Allocator>& values)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				Write(static_cast<uint64_t>(values.size()));
+				m_Bytes.resize((m_Bytes.size() + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1));
+				const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+				m_Bytes.insert(m_Bytes.end(), bytes, bytes + values.size() * sizeof(T));
+			}
+
+			std::vector<uint8_t>& GetBytes() { return m_Bytes; }
+
+		private:
+			std::vector<uint8_t> m_Bytes;
+		};
+
+		// Every read is bounds-checked; the first overrun poisons the reader
+		class CookedReader
+		{
+		public:
+			CookedReader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+			template <typename T>
+			bool Read(T& value)
+			{
+				if (!Reserve(sizeof(T)))
+					return false;
+				std::memcpy(&value, m_Data + m_Offset, sizeof(T));
+				m_Offset += sizeof(T);
+				return true;
+			}
+
+			bool ReadString(std::string& value)
+			{
+				uint32_t length = 0;
+				if (!Read(length) || !Reserve(length))
+					return false;
+				value.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+				m_Offset += length;
+				return true;
+			}
+
+			template <typename T, typename Allocator>
+			bool ReadBlob(std::vector<T, Allocator>& values)
+			{
+				uint64_t count = 0;
+				if (!Read(count))
+					return false;
+				const size_t aligned = (m_Offset + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+				if (aligned > m_Size || count > (m_Size - aligned) / sizeof(T))
+					return m_Ok = false;
+				m_Offset = aligned;
+				values.resize(static_cast<size_t>(count));
+				std::memcpy(values.data(), m_Data + m_Offset, values.size() * sizeof(T));
+				m_Offset += values.size() * sizeof(T);
+				return true;
+			}
+
+			bool IsOk() const { return m_Ok; }
+			void Fail() { m_Ok = false; }
+
+		private:
+			bool Reserve(size_t size)
+			{
+				if (!m_Ok || size > m_Size - m_Offset)
+					return m_Ok = false;
+				return true;
+			}
+
+			const uint8_t* m_Data;
+			size_t m_Size;
+			size_t m_Offset = 0;
+			bool m_Ok = true;
+		};
+
+		std::string StripBase(const std::string& path, const std::string& basePath)
+		{
+			if (!basePath.empty() && path.compare(0, basePath.size(), basePath) == 0)
+				return path.substr(basePath.size());
+			return path;
+		}
+
+		std::string AddBase(const std::string& path, const std::string& basePath)
+		{
+			if (path.empty() || std::filesystem::path(path).is_absolute())
+				return path;
+			return basePath + path;
+		}
+	}
+
+	uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+	{
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		uint64_t hash = seed;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	std::string GetCookedModelPath(const std::string& cacheDirectory, const std::string& sourcePath,
+		uint64_t sourceHash)
+	{
+		if (cacheDirectory.empty())
+			return sourcePath + ".nbmesh";
+
+		char hash[17];
+		std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(sourceHash));
+		const std::string fileName = std::filesystem::path(sourcePath).stem().string() + "_" + hash + ".nbmesh";
+		return (std::filesystem::path(cacheDirectory) / fileName).string();
+	}
+
+	bool WriteCookedModel(const std::string& path, const ModelData& model, uint64_t sourceHash,
+		const std::string& basePath)
+	{
+		CookedWriter writer;
+
+		CookedHeader header{};
+		std::memcpy(header.magic, COOKED_MAGIC, sizeof(header.magic));
+		header.version = COOKED_VERSION;
+		header.sourceHash = sourceHash;
+		header.vertexStride = sizeof(VertexPNT);
+		header.meshCount = static_cast<uint32_t>(model.meshes.size());
+		header.materialCount = static_cast<uint32_t>(model.materials.size());
+		writer.Write(header);
+		writer.WriteString(model.name);
+
+		for (const MaterialData& material : model.materials)
+		{
+			writer.WriteString(material.name);
+			writer.Write(material.baseColorFactor);
+			writer.Write(material.metallicFactor);
+			writer.Write(material.roughnessFactor);
+			writer.WriteString(StripBase(material.baseColorTexturePath, basePath));
+			writer.WriteString(StripBase(material.metallicRoughnessTexturePath, basePath));
+			writer.WriteString(StripBase(material.normalTexturePath, basePath));
+			writer.WriteString(StripBase(material.emissiveTexturePath, basePath));
+			writer.Write(material.emissiveFactor);
+			writer.Write(static_cast<uint8_t>(material.doubleSided));
+			writer.Write(static_cast<uint8_t>(material.alphaMode));
+			writer.Write(material.alphaCutoff);
+		}
+
+		for (const MeshData& mesh : model.meshes)
+		{
+			writer.WriteString(mesh.name);
+			writer.Write(mesh.materialIndex);
+			writer.Write(mesh.boundsMin);
+			writer.Write(mesh.boundsMax);
+			writer.WriteBlob(mesh.vertices);
+			writer.WriteBlob(mesh.indices);
+			writer.Write(static_cast<uint32_t>(mesh.lods.size()));
+			for (const MeshLodLevel& level : mesh.lods)
+			{
+				writer.Write(level.error);
+				writer.WriteBlob(level.indices);
+			}
+			writer.WriteBlob(mesh.meshlets);
+		}
+
+		// Size last, so a file cut short anywhere reads as corrupt
+		std::vector<uint8_t>& bytes = writer.GetBytes();
+		header.fileSize = bytes.size();
+		std::memcpy(bytes.data(), &header, sizeof(header));
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	std::unique_ptr<ModelData> ReadCookedModel(const std::string& path, uint64_t sourceHash,
+		const std::string& basePath)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+			return nullptr;
+
+		CookedReader reader(file.GetData(), file.GetSize());
+		CookedHeader header{};
+		if (!reader.Read(header) ||
+			std::memcmp(header.magic, COOKED_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != COOKED_VERSION ||
+			header.sourceHash != sourceHash ||
+			header.vertexStride != sizeof(VertexPNT) ||
+			header.fileSize != file.GetSize() ||
+			header.meshCount > file.GetSize() || header.materialCount > file.GetSize())
+		{
+			return nullptr;
+		}
+
+		auto model = std::make_unique<ModelData>();
+		reader.ReadString(model->name);
+
+		model->materials.resize(header.materialCount);
+		for (MaterialData& material : model->materials)
+		{
+			uint8_t doubleSided = 0, alphaMode = 0;
+			reader.ReadString(material.name);
+			reader.Read(material.baseColorFactor);
+			reader.Read(material.metallicFactor);
+			reader.Read(material.roughnessFactor);
+			reader.ReadString(material.baseColorTexturePath);
+			reader.ReadString(material.metallicRoughnessTexturePath);
+			reader.ReadString(material.normalTexturePath);
+			reader.ReadString(material.emissiveTexturePath);
+			reader.Read(material.emissiveFactor);
+			reader.Read(doubleSided);
+			reader.Read(alphaMode);
+			reader.Read(material.alphaCutoff);
+
+			material.doubleSided = doubleSided != 0;
+			material.alphaMode = static_cast<MaterialData::AlphaMode>(alphaMode);
+			material.baseColorTexturePath = AddBase(material.baseColorTexturePath, basePath);
+			material.metallicRoughnessTexturePath = AddBase(material.metallicRoughnessTexturePath, basePath);
+			material.normalTexturePath = AddBase(material.normalTexturePath, basePath);
+			material.emissiveTexturePath = AddBase(material.emissiveTexturePath, basePath);
+		}
+
+		model->meshes.resize(header.meshCount);
+		for (MeshData& mesh : model->meshes)
+		{
+			uint32_t lodCount = 0;
+			reader.ReadString(mesh.name);
+			reader.Read(mesh.materialIndex);
+			reader.Read(mesh.boundsMin);
+			reader.Read(mesh.boundsMax);
+			reader.ReadBlob(mesh.vertices);
+			reader.ReadBlob(mesh.indices);
+			reader.Read(lodCount);
+			if (!reader.IsOk() || lodCount > file.GetSize())
+			{
+				reader.Fail();
+				break;
+			}
+
+			mesh.lods.resize(lodCount);
+			for (MeshLodLevel& level : mesh.lods)
+			{
+				reader.Read(level.error);
+				reader.ReadBlob(level.indices);
+			}
+			reader.ReadBlob(mesh.meshlets);
+
+			// Meshlets are drawn straight from the index list; one reaching
+			// past it would read another mesh's indices
+			for (const Meshlet& meshlet : mesh.meshlets)
+			{
+				if (meshlet.firstIndex > mesh.indices.size() ||
+					meshlet.indexCount > mesh.indices.size() - meshlet.firstIndex)
+				{
+					reader.Fail();
+					break;
+				}
+			}
+
+			model->totalVertices += mesh.vertices.size();
+			model->totalIndices += mesh.indices.size();
+		}
+
+		if (!reader.IsOk())
+		{
+			LOG_WARN("Cooked model '{}' is corrupt, ignoring it", path);
+			return nullptr;
+		}
+		return model;
+	}
+}
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+// MeshCache.hpp
+//
+// Cooked binary form of an imported glTF model: the ModelData GLTFLoader
+// produces (after vertex conversion, optimisation and LOD generation),
+// written once and memory-mapped on later loads. Vertex, index and LOD
+// blobs are stored 16-byte aligned in their in-memory layout, so reading
+// one back is a bounds check and a copy - no parsing or conversion.
+//
+// A cooked file carries the hash of the source it was built from
+// (GLTFLoader hashes the .gltf/.glb and its external buffers) plus the
+// format version and vertex stride; any mismatch makes it a miss and the
+// model is imported and re-cooked.
+//
+// Skinned models are never cooked (the format has no skeleton or clips);
+// GLTFLoader imports them every time.
+//
+// Texture paths are stored relative to the source's directory, so a cooked
+// file stays valid when the asset folder moves.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/GLTFLoader.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Nightbloom
+{
+	// FNV-1a 64, chainable through seed
+	uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+
+	// <cacheDirectory>/<source stem>_<hash>.nbmesh, or next to the source
+	// (<source>.nbmesh) when cacheDirectory is empty
+	std::string GetCookedModelPath(const std::string& cacheDirectory, const std::string& sourcePath,
+		uint64_t sourceHash);
+
+	// Writes through a temporary file and a rename, so an interrupted write
+	// never leaves a truncated cache entry. basePath is the source's directory
+	// (with trailing separator), stripped from texture paths.
+	bool WriteCookedModel(const std::string& path, const ModelData& model, uint64_t sourceHash,
+		const std::string& basePath);
+
+	// nullptr when the file is missing, stale (hash/version/stride) or corrupt
+	std::unique_ptr<ModelData> ReadCookedModel(const std::string& path, uint64_t sourceHash,
+		const std::string& basePath);
+}
@@ -0,0 +1,301 @@
+//------------------------------------------------------------------------------
+// MeshLod.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/MeshLod.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Weighted sum of squared distances to a set of planes, as the
+		// symmetric 4x4 matrix of Garland-Heckbert: Q(p) = p'Ap + 2b.p + c.
+		// weight is the total plane weight, so Q(p) / weight is a mean.
+		struct Quadric
+		{
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+			double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+			double c = 0.0;
+			double weight = 0.0;
+
+			void AddPlane(const glm::dvec3& n, double d, double w)
+			{
+				a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+				a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+				b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+				c += w * d * d;
+				weight += w;
+			}
+
+			void Add(const Quadric& q)
+			{
+				a00 += q.a00; a01 += q.a01; a02 += q.a02;
+				a11 += q.a11; a12 += q.a12; a22 += q.a22;
+				b0 += q.b0; b1 += q.b1; b2 += q.b2;
+				c += q.c;
+				weight += q.weight;
+			}
+
+			double Evaluate(const glm::vec3& p) const
+			{
+				const double x = p.x, y = p.y, z = p.z;
+				return a00 * x * x + a11 * y * y + a22 * z * z +
+					2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+					2.0 * (b0 * x + b1 * y + b2 * z) + c;
+			}
+		};
+
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			double cost;
+		};
+
+		struct PositionHash
+		{
+			size_t operator()(const glm::vec3& p) const
+			{
+				uint32_t bits[3];
+				std::memcpy(bits, &p, sizeof(bits));
+				return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+			}
+		};
+
+		uint64_t EdgeKey(uint32_t a, uint32_t b)
+		{
+			if (a > b) std::swap(a, b);
+			return (static_cast<uint64_t>(a) << 32) | b;
+		}
+
+		// Moving 'from' onto 'to' must not turn any surviving triangle around
+		// 'from' over (or near enough that rounding might). remap holds this pass's earlier collapses.
+		bool KeepsOrientation(const Collapse& collapse, const std::vector<uint32_t>& indices,
+			const uint32_t* triangles, uint32_t triangleCount,
+			const std::vector<uint32_t>& remap, const std::vector<glm::vec3>& positions)
+		{
+			for (uint32_t i = 0; i < triangleCount; ++i)
+			{
+				const uint32_t t = triangles[i] * 3;
+				uint32_t v[3] = { remap[indices[t]], remap[indices[t + 1]], remap[indices[t + 2]] };
+				if (v[0] == v[1] || v[1] == v[2] || v[2] == v[0]) continue;   // already gone
+				if (v[0] == collapse.to || v[1] == collapse.to || v[2] == collapse.to) continue;   // goes with this collapse
+
+				const glm::vec3 before = glm::cross(positions[v[1]] - positions[v[0]], positions[v[2]] - positions[v[0]]);
+				for (uint32_t& vertex : v)
+				{
+					if (vertex == collapse.from)
+						vertex = collapse.to;
+				}
+				const glm::vec3 after = glm::cross(positions[v[1]] - positions[v[0]], positions[v[2]] - positions[v[0]]);
+				// Allow bending, not folding: the normal may turn by up to ~75 degrees
+				if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after))
+					return false;
+			}
+			return true;
+		}
+	}
+
+	std::vector<uint32_t> SimplifyMesh(const glm::vec3* positions, size_t vertexCount, size_t positionStride,
+		const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float* outError)
+	{
+		std::vector<uint32_t> result(indices, indices + indexCount);
+		if (outError)
+			*outError = 0.0f;
+		if (targetIndexCount >= indexCount || vertexCount == 0)
+			return result;
+
+		std::vector<glm::vec3> position(vertexCount);
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(positions);
+		for (size_t v = 0; v < vertexCount; ++v)
+			std::memcpy(&position[v], bytes + v * positionStride, sizeof(glm::vec3));
+
+		// Weld vertices by position (+0.0f folds -0 into 0 for the hash). A
+		// position shared by several vertices is a UV/normal seam: lock them all.
+		std::vector<uint32_t> weld(vertexCount);
+		std::vector<uint8_t> locked(vertexCount, 0);
+		{
+			std::unordered_map<glm::vec3, uint32_t, PositionHash> firstAt;
+			firstAt.reserve(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; ++v)
+			{
+				auto [it, inserted] = firstAt.emplace(position[v] + glm::vec3(0.0f), v);
+				weld[v] = it->second;
+				if (!inserted)
+					locked[v] = locked[it->second] = 1;
+			}
+		}
+
+		// Open borders: welded edges only one triangle uses
+		{
+			std::unordered_map<uint64_t, uint32_t> edgeUse;
+			edgeUse.reserve(result.size());
+			for (size_t t = 0; t < result.size(); t += 3)
+			{
+				for (size_t e = 0; e < 3; ++e)
+					++edgeUse[EdgeKey(weld[result[t + e]], weld[result[t + (e + 1) % 3]])];
+			}
+			for (size_t t = 0; t < result.size(); t += 3)
+			{
+				for (size_t e = 0; e < 3; ++e)
+				{
+					const uint32_t a = result[t + e], b = result[t + (e + 1) % 3];
+					if (edgeUse[EdgeKey(weld[a], weld[b])] == 1)
+						locked[a] = locked[b] = 1;
+				}
+			}
+		}
+
+		// Area-weighted plane quadrics, accumulated per welded position so
+		// both sides of a seam agree. Costs are normalised by the weight: the
+		// area-weighted mean squared distance from the merged planes.
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t t = 0; t < result.size(); t += 3)
+		{
+			const glm::dvec3 p0(position[result[t]]), p1(position[result[t + 1]]), p2(position[result[t + 2]]);
+			glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+			const double length = glm::length(n);
+			if (length <= 0.0) continue;
+			n /= length;
+			const double d = -glm::dot(n, p0);
+			for (size_t k = 0; k < 3; ++k)
+				quadrics[weld[result[t + k]]].AddPlane(n, d, length * 0.5);
+		}
+
+		const size_t targetTriangles = targetIndexCount / 3;
+		size_t triangleCount = result.size() / 3;
+		double maxCost = 0.0;
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint8_t> touched(vertexCount);
+		std::vector<Collapse> candidates;
+
+		// Each pass collapses the cheapest edges whose ends no earlier collapse
+		// of the pass touched, so adjacency and quadrics stay valid within it
+		while (triangleCount > targetTriangles)
+		{
+			// Triangles around each vertex
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+			for (uint32_t index : result)
+				++adjacencyOffsets[index + 1];
+			std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+			adjacency.resize(result.size());
+			{
+				std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < result.size(); ++i)
+					adjacency[cursor[result[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			candidates.clear();
+			for (size_t t = 0; t < result.size(); t += 3)
+			{
+				for (size_t e = 0; e < 3; ++e)
+				{
+					const uint32_t a = result[t + e], b = result[t + (e + 1) % 3];
+					for (const auto& [from, to] : { std::pair(a, b), std::pair(b, a) })
+					{
+						if (locked[from]) continue;
+						const Quadric& qFrom = quadrics[weld[from]];
+						const Quadric& qTo = quadrics[weld[to]];
+						const double weight = qFrom.weight + qTo.weight;
+						if (weight <= 0.0) continue;
+						const double cost = (qFrom.Evaluate(position[to]) + qTo.Evaluate(position[to])) / weight;
+						candidates.push_back({ from, to, std::max(cost, 0.0) });
+					}
+				}
+			}
+			std::sort(candidates.begin(), candidates.end(),
+				[](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+			std::iota(remap.begin(), remap.end(), 0u);
+			std::fill(touched.begin(), touched.end(), uint8_t(0));
+
+			// A collapse usually removes two triangles; pacing the pass to what
+			// is still needed leaves the expensive edges for after the rewrite
+			size_t budget = (triangleCount - targetTriangles + 1) / 2 + 1;
+			size_t collapsed = 0;
+			for (const Collapse& collapse : candidates)
+			{
+				if (collapsed == budget || triangleCount <= targetTriangles) break;
+				if (touched[collapse.from] || touched[collapse.to]) continue;
+
+				const uint32_t* around = adjacency.data() + adjacencyOffsets[collapse.from];
+				const uint32_t aroundCount = adjacencyOffsets[collapse.from + 1] - adjacencyOffsets[collapse.from];
+				if (!KeepsOrientation(collapse, result, around, aroundCount, remap, position))
+					continue;
+
+				size_t removed = 0;
+				for (uint32_t i = 0; i < aroundCount; ++i)
+				{
+					const uint32_t t = around[i] * 3;
+					const uint32_t v0 = remap[result[t]], v1 = remap[result[t + 1]], v2 = remap[result[t + 2]];
+					if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+					if (v0 == collapse.to || v1 == collapse.to || v2 == collapse.to)
+						++removed;
+				}
+
+				remap[collapse.from] = collapse.to;
+				touched[collapse.from] = touched[collapse.to] = 1;
+				quadrics[weld[collapse.to]].Add(quadrics[weld[collapse.from]]);
+				triangleCount -= removed;
+				maxCost = std::max(maxCost, collapse.cost);
+				++collapsed;
+			}
+
+			if (collapsed == 0)
+				break;   // everything left is locked or would flip
+
+			size_t write = 0;
+			for (size_t t = 0; t < result.size(); t += 3)
+			{
+				const uint32_t v0 = remap[result[t]], v1 = remap[result[t + 1]], v2 = remap[result[t + 2]];
+				if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+				result[write++] = v0;
+				result[write++] = v1;
+				result[write++] = v2;
+			}
+			result.resize(write);
+			triangleCount = write / 3;
+		}
+
+		if (outError)
+			*outError = static_cast<float>(std::sqrt(maxCost));
+		return result;
+	}
+
+	void GenerateMeshLods(const glm::vec3* positions, size_t vertexCount, size_t positionStride,
+		const uint32_t* indices, size_t indexCount, std::vector<MeshLodLevel>& outLevels,
+		const MeshLodSettings& settings)
+	{
+		const uint32_t* source = indices;
+		size_t sourceCount = indexCount;
+		float error = 0.0f;
+
+		for (uint32_t level = 1; level < settings.maxLevels; ++level)
+		{
+			const size_t sourceTriangles = sourceCount / 3;
+			if (sourceTriangles < settings.minTriangles)
+				break;
+
+			const size_t target = static_cast<size_t>(static_cast<float>(sourceTriangles) * settings.reduction) * 3;
+			float levelError = 0.0f;
+			std::vector<uint32_t> lod = SimplifyMesh(positions, vertexCount, positionStride,
+				source, sourceCount, target, &levelError);
+			if (lod.empty() || static_cast<float>(lod.size()) > static_cast<float>(sourceCount) * settings.minReduction)
+				break;
+
+			// Each level is simplified from the last, so errors add up
+			error += levelError;
+			outLevels.push_back({ std::move(lod), error });
+			source = outLevels.back().indices.data();
+			sourceCount = outLevels.back().indices.size();
+		}
+	}
+}
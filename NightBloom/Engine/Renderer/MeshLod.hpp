@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// MeshLod.hpp
+//
+// Level-of-detail chains for imported meshes. SimplifyMesh is a quadric error
+// metric (Garland-Heckbert) half-edge collapser: every vertex accumulates the
+// planes of the triangles around it, and the cheapest edge v->u - where the
+// cost is v's and u's combined squared distance from those planes at u - is
+// collapsed first, in passes, until the triangle target is reached. Vertices
+// only ever move onto existing vertices, so a LOD is just a shorter index list
+// over the original vertex buffer.
+//
+// Vertices on an open border or a UV/normal seam (several vertices sharing one
+// position) are locked: other vertices collapse onto them but they never move,
+// so LODs keep their silhouette edges and never tear at seams. Collapses that
+// would flip a triangle are rejected.
+//
+// Each level carries its geometric error (object-space units, roughly the
+// furthest the surface moved); SelectMeshLod turns that into a screen-space
+// error at draw time and picks the coarsest level under the pixel budget.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	// One coarser index list over a mesh's vertices
+	struct MeshLodLevel
+	{
+		std::vector<uint32_t> indices;
+		float error = 0.0f;   // object-space distance, cumulative from the full mesh
+	};
+
+	struct MeshLodSettings
+	{
+		uint32_t maxLevels = 4;          // Including the full-detail mesh
+		float    reduction = 0.5f;       // Each level targets this fraction of the previous one's triangles
+		float    minReduction = 0.8f;    // Stop once a level keeps more than this fraction (simplification stalled)
+		uint32_t minTriangles = 64;      // Meshes or levels below this are not simplified further
+	};
+
+	// Simplifies the triangle list toward targetIndexCount indices (a multiple
+	// of 3). positions are read with a byte stride so vertex structs can be
+	// passed directly. Returns the new index list; outError, if given, receives
+	// the largest collapse error as an object-space distance.
+	std::vector<uint32_t> SimplifyMesh(const glm::vec3* positions, size_t vertexCount, size_t positionStride,
+		const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float* outError = nullptr);
+
+	// Builds levels 1.. of a mesh's chain (level 0 being the mesh itself), each
+	// simplified from the previous one. Appends nothing for small meshes.
+	void GenerateMeshLods(const glm::vec3* positions, size_t vertexCount, size_t positionStride,
+		const uint32_t* indices, size_t indexCount, std::vector<MeshLodLevel>& outLevels,
+		const MeshLodSettings& settings = MeshLodSettings{});
+
+	// Coarsest level whose projected error stays within maxPixelError.
+	// errors[0] is the full mesh (0) and errors ascend; pixelsPerUnit is how
+	// many pixels one object-space unit covers at the mesh's distance.
+	inline uint32_t SelectMeshLod(const float* errors, uint32_t levelCount, float pixelsPerUnit, float maxPixelError)
+	{
+		uint32_t lod = 0;
+		while (lod + 1 < levelCount && errors[lod + 1] * pixelsPerUnit <= maxPixelError)
+			++lod;
+		return lod;
+	}
+}
@@ -0,0 +1,455 @@
+//------------------------------------------------------------------------------
+// MeshOptimizer.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+		// Forsyth's constants, as published
+		constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+		constexpr float CACHE_DECAY_POWER = 1.5f;
+		constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+		constexpr float VALENCE_BOOST_SCALE = 2.0f;
+		constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+		// Overdraw clusters: FIFO size used to find cold triangles, and the
+		// smallest soft-split cluster
+		constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+		constexpr uint32_t MIN_CLUSTER_TRIANGLES = 16;
+
+		constexpr size_t FETCH_LINE_SIZE = 64;
+		constexpr uint32_t FETCH_CACHE_LINES = 64;
+
+		float VertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+		{
+			if (remainingTriangles == 0)
+				return -1.0f;
+
+			float score = 0.0f;
+			if (cachePosition >= 0)
+			{
+				// The last triangle's vertices score flat so its successor
+				// does not just reuse the same edge over and over
+				if (cachePosition < 3)
+					score = LAST_TRIANGLE_SCORE;
+				else
+					score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3),
+						CACHE_DECAY_POWER);
+			}
+			// Vertices with few triangles left are finished off first
+			return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+		}
+
+		// FIFO cache simulation with per-vertex timestamps: a vertex is
+		// resident while fewer than cacheSize misses happened since its own.
+		// Reset() empties it without touching the timestamps.
+		class FifoCache
+		{
+		public:
+			FifoCache(size_t vertexCount, uint32_t cacheSize)
+				: m_Timestamps(vertexCount, 0), m_CacheSize(cacheSize), m_Time(cacheSize + 1) {}
+
+			bool Access(uint32_t vertex)
+			{
+				if (m_Time - m_Timestamps[vertex] > m_CacheSize)
+				{
+					m_Timestamps[vertex] = m_Time++;
+					return true;
+				}
+				return false;
+			}
+
+			uint32_t AccessTriangle(const uint32_t* triangle)
+			{
+				return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+			}
+
+			void Reset() { m_Time += m_CacheSize + 1; }
+
+		private:
+			std::vector<uint32_t> m_Timestamps;
+			uint32_t m_CacheSize;
+			uint32_t m_Time;
+		};
+
+		struct VertexHasher
+		{
+			const uint8_t* data;
+			size_t stride;
+
+			size_t operator()(uint32_t vertex) const
+			{
+				// FNV-1a
+				const uint8_t* bytes = data + vertex * stride;
+				uint64_t hash = 14695981039346656037ull;
+				for (size_t i = 0; i < stride; ++i)
+					hash = (hash ^ bytes[i]) * 1099511628211ull;
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		struct VertexEqual
+		{
+			const uint8_t* data;
+			size_t stride;
+
+			bool operator()(uint32_t a, uint32_t b) const
+			{
+				return std::memcmp(data + a * stride, data + b * stride, stride) == 0;
+			}
+		};
+	}
+
+	VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+		uint32_t cacheSize)
+	{
+		VertexCacheStats stats;
+		if (indexCount < 3 || vertexCount == 0)
+			return stats;
+
+		FifoCache cache(vertexCount, cacheSize);
+		std::vector<uint8_t> referenced(vertexCount, 0);
+		uint32_t uniqueVertices = 0;
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			stats.shadedVertices += cache.Access(indices[i]);
+			if (!referenced[indices[i]])
+			{
+				referenced[indices[i]] = 1;
+				++uniqueVertices;
+			}
+		}
+
+		stats.acmr = static_cast<float>(stats.shadedVertices) / static_cast<float>(indexCount / 3);
+		stats.atvr = static_cast<float>(stats.shadedVertices) / static_cast<float>(uniqueVertices);
+		return stats;
+	}
+
+	VertexFetchStats AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+		size_t vertexStride)
+	{
+		VertexFetchStats stats;
+		if (indexCount == 0 || vertexCount == 0)
+			return stats;
+
+		const size_t lineCount = (vertexCount * vertexStride + FETCH_LINE_SIZE - 1) / FETCH_LINE_SIZE;
+		FifoCache cache(lineCount, FETCH_CACHE_LINES);
+		std::vector<uint8_t> referenced(vertexCount, 0);
+		size_t uniqueVertices = 0;
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			const size_t begin = indices[i] * vertexStride;
+			for (size_t line = begin / FETCH_LINE_SIZE; line <= (begin + vertexStride - 1) / FETCH_LINE_SIZE; ++line)
+			{
+				if (cache.Access(static_cast<uint32_t>(line)))
+					stats.bytesFetched += FETCH_LINE_SIZE;
+			}
+			if (!referenced[indices[i]])
+			{
+				referenced[indices[i]] = 1;
+				++uniqueVertices;
+			}
+		}
+
+		stats.overfetch = static_cast<float>(stats.bytesFetched) / static_cast<float>(uniqueVertices * vertexStride);
+		return stats;
+	}
+
+	size_t RemoveDuplicateVertices(void* vertices, size_t vertexCount, size_t vertexStride,
+		uint32_t* indices, size_t indexCount)
+	{
+		uint8_t* bytes = static_cast<uint8_t*>(vertices);
+
+		// Remap first, then compact: the map's keys point into the unmoved data
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint8_t> first(vertexCount, 0);
+		uint32_t uniqueCount = 0;
+		{
+			std::unordered_map<uint32_t, uint32_t, VertexHasher, VertexEqual> unique(vertexCount,
+				VertexHasher{ bytes, vertexStride }, VertexEqual{ bytes, vertexStride });
+			for (uint32_t v = 0; v < vertexCount; ++v)
+			{
+				auto [it, inserted] = unique.emplace(v, uniqueCount);
+				remap[v] = it->second;
+				if (inserted)
+				{
+					first[v] = 1;
+					++uniqueCount;
+				}
+			}
+		}
+
+		// First occurrences keep their relative order and only move down
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			if (first[v] && remap[v] != v)
+				std::memmove(bytes + remap[v] * vertexStride, bytes + v * vertexStride, vertexStride);
+		}
+		for (size_t i = 0; i < indexCount; ++i)
+			indices[i] = remap[indices[i]];
+
+		return uniqueCount;
+	}
+
+	void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount)
+	{
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount < 2 || vertexCount == 0)
+			return;
+
+		// Triangles around each vertex; a vertex's unemitted triangles are kept
+		// at the front of its range, remaining[v] long
+		std::vector<uint32_t> remaining(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			++remaining[indices[i]];
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		std::partial_sum(remaining.begin(), remaining.end(), offsets.begin() + 1);
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		{
+			std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; ++i)
+				adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		std::vector<int32_t> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount);
+		for (size_t v = 0; v < vertexCount; ++v)
+			vertexScore[v] = VertexScore(-1, remaining[v]);
+
+		std::vector<float> triangleScore(triangleCount);
+		uint32_t best = 0;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+			if (triangleScore[t] > triangleScore[best])
+				best = static_cast<uint32_t>(t);
+		}
+
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		std::vector<uint32_t> output;
+		output.reserve(triangleCount * 3);
+		uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+		uint32_t nextCache[FORSYTH_CACHE_SIZE + 3];
+		size_t cacheCount = 0;
+		size_t scanCursor = 0;
+
+		for (size_t count = 0; count < triangleCount; ++count)
+		{
+			// Nothing in the cache has triangles left: take the next in input order
+			if (best == INVALID_INDEX)
+			{
+				while (emitted[scanCursor]) ++scanCursor;
+				best = static_cast<uint32_t>(scanCursor);
+			}
+
+			const uint32_t* triangle = indices + best * 3;
+			emitted[best] = 1;
+			output.insert(output.end(), triangle, triangle + 3);
+
+			// Drop the triangle from its vertices' remaining lists (once per
+			// occurrence, so degenerate triangles come out right too)
+			for (size_t k = 0; k < 3; ++k)
+			{
+				const uint32_t v = triangle[k];
+				uint32_t* begin = adjacency.data() + offsets[v];
+				uint32_t* end = begin + remaining[v];
+				uint32_t* found = std::find(begin, end, best);
+				std::swap(*found, *(end - 1));
+				--remaining[v];
+			}
+
+			// LRU: the triangle's vertices move to the front
+			size_t nextCount = 0;
+			for (size_t k = 0; k < 3; ++k)
+			{
+				if (std::find(nextCache, nextCache + nextCount, triangle[k]) == nextCache + nextCount)
+					nextCache[nextCount++] = triangle[k];
+			}
+			for (size_t c = 0; c < cacheCount; ++c)
+			{
+				const uint32_t v = cache[c];
+				if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+					nextCache[nextCount++] = v;
+			}
+
+			// Rescore everything that moved, including what fell out the back
+			for (size_t c = 0; c < nextCount; ++c)
+			{
+				const uint32_t v = nextCache[c];
+				cachePosition[v] = c < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(c) : -1;
+				const float score = VertexScore(cachePosition[v], remaining[v]);
+				const float delta = score - vertexScore[v];
+				vertexScore[v] = score;
+				for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+					triangleScore[adjacency[a]] += delta;
+			}
+
+			cacheCount = std::min<size_t>(nextCount, FORSYTH_CACHE_SIZE);
+			std::copy(nextCache, nextCache + cacheCount, cache);
+
+			best = INVALID_INDEX;
+			float bestScore = -1.0f;
+			for (size_t c = 0; c < cacheCount; ++c)
+			{
+				const uint32_t v = cache[c];
+				for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+				{
+					if (triangleScore[adjacency[a]] > bestScore)
+					{
+						bestScore = triangleScore[adjacency[a]];
+						best = adjacency[a];
+					}
+				}
+			}
+		}
+
+		std::copy(output.begin(), output.end(), indices);
+	}
+
+	void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions,
+		size_t vertexCount, size_t positionStride, float threshold)
+	{
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount < 2 || vertexCount == 0)
+			return;
+
+		auto position = [positions, positionStride](uint32_t v)
+		{
+			glm::vec3 p;
+			std::memcpy(&p, reinterpret_cast<const uint8_t*>(positions) + v * positionStride, sizeof(p));
+			return p;
+		};
+
+		// Hard boundaries: triangles the cache reaches cold, where a cluster
+		// can start without costing anything
+		std::vector<uint32_t> hard;
+		{
+			FifoCache cache(vertexCount, OVERDRAW_CACHE_SIZE);
+			for (uint32_t t = 0; t < triangleCount; ++t)
+			{
+				if (cache.AccessTriangle(indices + t * 3) == 3 || t == 0)
+					hard.push_back(t);
+			}
+			hard.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		// Soft boundaries: split a hard cluster further wherever the piece so
+		// far, from a cold cache, stays within threshold of the cluster's own
+		// miss ratio - more, smaller clusters sort better
+		std::vector<uint32_t> clusters;
+		{
+			FifoCache cache(vertexCount, OVERDRAW_CACHE_SIZE);
+			for (size_t h = 0; h + 1 < hard.size(); ++h)
+			{
+				const uint32_t begin = hard[h], end = hard[h + 1];
+				cache.Reset();
+				uint32_t clusterMisses = 0;
+				for (uint32_t t = begin; t < end; ++t)
+					clusterMisses += cache.AccessTriangle(indices + t * 3);
+				const float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+				clusters.push_back(begin);
+				cache.Reset();
+				uint32_t start = begin, misses = 0;
+				for (uint32_t t = begin; t + 1 < end; ++t)
+				{
+					misses += cache.AccessTriangle(indices + t * 3);
+					const uint32_t count = t + 1 - start;
+					if (count >= MIN_CLUSTER_TRIANGLES && static_cast<float>(misses) <= limit * static_cast<float>(count))
+					{
+						clusters.push_back(t + 1);
+						cache.Reset();
+						start = t + 1;
+						misses = 0;
+					}
+				}
+			}
+			clusters.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		// Outward-facing clusters first: the further a cluster sits out along
+		// its own normal from the mesh centre, the less likely anything of the
+		// same mesh covers it
+		const size_t clusterCount = clusters.size() - 1;
+		std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+		std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+		for (size_t c = 0; c < clusterCount; ++c)
+		{
+			float area = 0.0f;
+			for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t)
+			{
+				const glm::vec3 p0 = position(indices[t * 3]), p1 = position(indices[t * 3 + 1]), p2 = position(indices[t * 3 + 2]);
+				const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);   // length = 2 x area
+				const float triangleArea = glm::length(normal) * 0.5f;
+				clusterCentroid[c] += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				clusterNormal[c] += normal;
+				area += triangleArea;
+			}
+			meshCentroid += clusterCentroid[c];
+			meshArea += area;
+			clusterCentroid[c] = area > 0.0f ? clusterCentroid[c] / area : position(indices[clusters[c] * 3]);
+		}
+		if (meshArea > 0.0f)
+			meshCentroid /= meshArea;
+
+		std::vector<float> sortKey(clusterCount);
+		for (size_t c = 0; c < clusterCount; ++c)
+		{
+			const float length = glm::length(clusterNormal[c]);
+			sortKey[c] = length > 0.0f ? glm::dot(clusterCentroid[c] - meshCentroid, clusterNormal[c] / length) : 0.0f;
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(),
+			[&sortKey](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+		std::vector<uint32_t> sorted;
+		sorted.reserve(triangleCount * 3);
+		for (uint32_t c : order)
+			sorted.insert(sorted.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+
+		// Keep the cache order if the clusters cost more than promised
+		const float before = AnalyzeVertexCache(indices, triangleCount * 3, vertexCount, OVERDRAW_CACHE_SIZE).acmr;
+		const float after = AnalyzeVertexCache(sorted.data(), sorted.size(), vertexCount, OVERDRAW_CACHE_SIZE).acmr;
+		if (after <= before * threshold)
+			std::copy(sorted.begin(), sorted.end(), indices);
+	}
+
+	size_t OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexStride,
+		uint32_t* indices, size_t indexCount)
+	{
+		uint8_t* bytes = static_cast<uint8_t*>(vertices);
+
+		std::vector<uint32_t> remap(vertexCount, INVALID_INDEX);
+		uint32_t next = 0;
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			uint32_t& slot = remap[indices[i]];
+			if (slot == INVALID_INDEX)
+				slot = next++;
+			indices[i] = slot;
+		}
+
+		const std::vector<uint8_t> source(bytes, bytes + vertexCount * vertexStride);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			if (remap[v] != INVALID_INDEX)
+				std::memcpy(bytes + remap[v] * vertexStride, source.data() + v * vertexStride, vertexStride);
+		}
+		return next;
+	}
+}
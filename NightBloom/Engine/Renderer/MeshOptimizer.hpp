@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// MeshOptimizer.hpp
+//
+// Import-time reordering of indexed triangle meshes, run by GLTFLoader on
+// every primitive before upload. In pipeline order:
+//
+//   RemoveDuplicateVertices  bitwise-identical vertices (glTF exporters split
+//                            per face or per primitive) become one
+//   OptimizeVertexCache      Forsyth's linear-speed triangle order: each
+//                            triangle scores its vertices' position in a
+//                            simulated LRU post-transform cache and their
+//                            remaining valence; the best neighbour goes next
+//   OptimizeOverdraw         Sander et al.: cut that order into clusters at
+//                            cache-cold triangles and draw the outward-facing
+//                            clusters first, unless that costs more than
+//                            threshold x the cache efficiency
+//   OptimizeVertexFetch      vertices renumbered by first use, so the vertex
+//                            fetch walks memory forward; unreferenced ones go
+//
+// Vertices are handled as opaque strided bytes (positions by pointer and
+// stride), so any vertex struct works. AnalyzeVertexCache/Fetch simulate the
+// caches so the gain can be measured (and logged) on real assets.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	struct VertexCacheStats
+	{
+		uint32_t shadedVertices = 0;   // Vertex shader invocations (cache misses)
+		float acmr = 0.0f;             // Misses per triangle (0.5 ideal on a grid, 3 worst)
+		float atvr = 0.0f;             // Misses per referenced vertex (1 ideal)
+	};
+
+	struct VertexFetchStats
+	{
+		uint32_t bytesFetched = 0;     // Cache lines loaded x line size
+		float overfetch = 0.0f;        // bytesFetched / size of the referenced vertices (1 ideal)
+	};
+
+	// FIFO post-transform cache simulation (the common hardware model)
+	VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+		uint32_t cacheSize = 16);
+
+	// Small LRU cache of 64-byte lines over the vertex buffer
+	VertexFetchStats AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+		size_t vertexStride);
+
+	// Merges bitwise-identical vertices in place and rewrites indices. Returns
+	// the new vertex count; the tail past it is garbage.
+	size_t RemoveDuplicateVertices(void* vertices, size_t vertexCount, size_t vertexStride,
+		uint32_t* indices, size_t indexCount);
+
+	// Reorders triangles (in place) for the post-transform cache
+	void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// Reorders already cache-optimised triangles (in place) to cut overdraw,
+	// letting the cache miss ratio grow by at most threshold
+	void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions,
+		size_t vertexCount, size_t positionStride, float threshold = 1.05f);
+
+	// Renumbers vertices (in place) in order of first use and drops the
+	// unreferenced ones. Returns the new vertex count.
+	size_t OptimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexStride,
+		uint32_t* indices, size_t indexCount);
+}
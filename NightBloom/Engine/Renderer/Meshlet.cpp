@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// Meshlet.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Meshlet.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		const glm::vec3& PositionAt(const glm::vec3* positions, size_t stride, uint32_t index)
+		{
+			return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const uint8_t*>(positions) + index * stride);
+		}
+
+		// Cones whose normals spread this far from the axis are not worth testing
+		constexpr float MIN_CONE_DOT = 0.1f;
+	}
+
+	void ComputeMeshletBounds(const glm::vec3* positions, size_t positionStride, const uint32_t* indices,
+		Meshlet& meshlet)
+	{
+		const uint32_t* tri = indices + meshlet.firstIndex;
+		const uint32_t triangleCount = meshlet.indexCount / 3;
+
+		// Sphere around the box of the corners: cheap, and within a few
+		// percent of the minimal one for the compact patches the scan makes
+		glm::vec3 minCorner(FLT_MAX), maxCorner(-FLT_MAX);
+		for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+		{
+			const glm::vec3& p = PositionAt(positions, positionStride, tri[i]);
+			minCorner = glm::min(minCorner, p);
+			maxCorner = glm::max(maxCorner, p);
+		}
+		meshlet.center = (minCorner + maxCorner) * 0.5f;
+		float radiusSq = 0.0f;
+		for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+		{
+			const glm::vec3 d = PositionAt(positions, positionStride, tri[i]) - meshlet.center;
+			radiusSq = std::max(radiusSq, glm::dot(d, d));
+		}
+		meshlet.radius = std::sqrt(radiusSq);
+
+		// Cone around the mean of the unit face normals (counter-clockwise
+		// front faces); degenerate triangles face nowhere and are skipped
+		std::vector<glm::vec3> normals;
+		normals.reserve(triangleCount);
+		glm::vec3 axis(0.0f);
+		for (uint32_t t = 0; t < triangleCount; ++t)
+		{
+			const glm::vec3& a = PositionAt(positions, positionStride, tri[t * 3 + 0]);
+			const glm::vec3& b = PositionAt(positions, positionStride, tri[t * 3 + 1]);
+			const glm::vec3& c = PositionAt(positions, positionStride, tri[t * 3 + 2]);
+			const glm::vec3 n = glm::cross(b - a, c - a);
+			const float length = glm::length(n);
+			if (length > 0.0f)
+			{
+				normals.push_back(n / length);
+				axis += normals.back();
+			}
+		}
+
+		meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+		meshlet.coneCutoff = 1.0f;
+		const float axisLength = glm::length(axis);
+		if (normals.empty() || axisLength <= 0.0f)
+			return;
+		axis /= axisLength;
+
+		float minDot = 1.0f;
+		for (const glm::vec3& n : normals)
+			minDot = std::min(minDot, glm::dot(n, axis));
+		if (minDot <= MIN_CONE_DOT)
+			return;
+
+		meshlet.coneAxis = axis;
+		meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+
+	std::vector<Meshlet> BuildMeshlets(const glm::vec3* positions, size_t vertexCount, size_t positionStride,
+		const uint32_t* indices, size_t indexCount, const MeshletSettings& settings)
+	{
+		std::vector<Meshlet> meshlets;
+		const size_t triangleCount = indexCount / 3;
+		if (!positions || !indices || triangleCount < settings.minTriangles ||
+			settings.maxVertices < 3 || settings.maxTriangles == 0)
+			return meshlets;
+
+		// Which meshlet last used each vertex, to count distinct vertices
+		std::vector<uint32_t> lastUse(vertexCount, UINT32_MAX);
+
+		Meshlet current;
+		uint32_t currentId = 0;
+		auto finish = [&]()
+		{
+			ComputeMeshletBounds(positions, positionStride, indices, current);
+			meshlets.push_back(current);
+			current = Meshlet{};
+			current.firstIndex = static_cast<uint32_t>(meshlets.back().firstIndex + meshlets.back().indexCount);
+			++currentId;
+		};
+
+		auto countNewVertices = [&](const uint32_t* tri)
+		{
+			uint32_t count = 0;
+			for (int k = 0; k < 3; ++k)
+			{
+				const bool repeat = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+				if (!repeat && lastUse[tri[k]] != currentId)
+					++count;
+			}
+			return count;
+		};
+
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t* tri = indices + t * 3;
+			uint32_t newVertices = countNewVertices(tri);
+			if (current.vertexCount + newVertices > settings.maxVertices ||
+				current.indexCount / 3 + 1 > settings.maxTriangles)
+			{
+				finish();
+				newVertices = countNewVertices(tri);
+			}
+
+			for (int k = 0; k < 3; ++k)
+				lastUse[tri[k]] = currentId;
+			current.vertexCount += newVertices;
+			current.indexCount += 3;
+		}
+		if (current.indexCount > 0)
+			finish();
+
+		return meshlets;
+	}
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// Meshlet.hpp
+//
+// Meshlets (clusters) for dense imported meshes: runs of consecutive
+// triangles touching at most maxVertices distinct vertices, each with a
+// bounding sphere and a normal cone. BuildMeshlets scans the index list in
+// its existing order - GLTFLoader has already ordered it for the vertex
+// cache, so neighbouring triangles are close - and starts a new meshlet when
+// either limit would be exceeded. Every meshlet is therefore a contiguous
+// slice of the mesh's own index list, drawn with firstIndex/indexCount like
+// a whole mesh, and no extra index data is needed.
+//
+// The normal cone bounds the meshlet's triangle normals; when the camera
+// sees every one of them from behind the whole meshlet is back-facing
+// (MeshletBackfacing, mirrored by MeshletCull.comp). Cones wider than about
+// 84 degrees (coneCutoff >= 1) are never culled.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Also the GPU layout (std430: vec4, vec4, uvec4) of MeshletCull.comp's
+	// meshlet buffer. Bounds are in the space of the positions it was built
+	// or rebounded with.
+	struct Meshlet
+	{
+		glm::vec3 center = glm::vec3(0.0f);
+		float radius = 0.0f;
+		glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+		float coneCutoff = 1.0f;      // sin of the cone's half angle; >= 1 never culls
+		uint32_t firstIndex = 0;      // relative to the mesh's index list
+		uint32_t indexCount = 0;
+		uint32_t vertexCount = 0;
+		uint32_t reserved = 0;
+	};
+	static_assert(sizeof(Meshlet) == 48 && std::is_trivially_copyable_v<Meshlet>, "Meshlet is uploaded as-is");
+
+	struct MeshletSettings
+	{
+		uint32_t maxVertices = 64;
+		uint32_t maxTriangles = 124;
+		uint32_t minTriangles = 1024;   // Smaller meshes are culled whole; meshlets would not pay off
+	};
+
+	// Splits the triangle list into meshlets, in order, and bounds each one.
+	// Returns nothing for meshes below settings.minTriangles.
+	std::vector<Meshlet> BuildMeshlets(const glm::vec3* positions, size_t vertexCount, size_t positionStride,
+		const uint32_t* indices, size_t indexCount, const MeshletSettings& settings = MeshletSettings{});
+
+	// Recomputes meshlet's sphere and cone from its triangles - for when the
+	// positions it is drawn with live in another space (quantized vertices)
+	void ComputeMeshletBounds(const glm::vec3* positions, size_t positionStride, const uint32_t* indices,
+		Meshlet& meshlet);
+
+	// True if every triangle of the meshlet faces away from cameraPosition
+	// (same space as the bounds)
+	inline bool MeshletBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition)
+	{
+		if (meshlet.coneCutoff >= 1.0f)
+			return false;
+		const glm::vec3 toCenter = meshlet.center - cameraPosition;
+		return glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius;
+	}
+}
@@ -0,0 +1,463 @@
+//------------------------------------------------------------------------------
+// MeshoptDecoder.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/MeshoptDecoder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint8_t VERTEX_HEADER = 0xa0;
+		constexpr uint8_t INDEX_HEADER = 0xe0;
+		constexpr uint8_t SEQUENCE_HEADER = 0xd0;
+
+		constexpr size_t BYTE_GROUP_SIZE = 16;
+		constexpr size_t VERTEX_BLOCK_BYTES = 8192;
+		constexpr size_t VERTEX_BLOCK_MAX_SIZE = 256;
+		constexpr size_t TAIL_MAX_SIZE = 32;   // the first vertex, zero-padded to at least this
+		constexpr size_t MAX_STRIDE = 256;
+
+		// Vertices per block: as many as fit 8 KB, a multiple of the group size
+		size_t GetVertexBlockSize(size_t stride)
+		{
+			const size_t size = (VERTEX_BLOCK_BYTES / stride) & ~(BYTE_GROUP_SIZE - 1);
+			return std::min(size, VERTEX_BLOCK_MAX_SIZE);
+		}
+
+		uint8_t Unzigzag8(uint8_t v)
+		{
+			return static_cast<uint8_t>(-(v & 1) ^ (v >> 1));
+		}
+
+		// One group of 16 values at 2^bitsLog2 bits each (0: all zero). At 2
+		// and 4 bits the all-ones value is an escape for a whole byte that
+		// follows the packed ones. High bits first.
+		bool DecodeBytesGroup(const uint8_t*& data, const uint8_t* end, uint8_t* out, int bitsLog2)
+		{
+			if (bitsLog2 == 0)
+			{
+				std::memset(out, 0, BYTE_GROUP_SIZE);
+				return true;
+			}
+			if (bitsLog2 == 3)
+			{
+				if (static_cast<size_t>(end - data) < BYTE_GROUP_SIZE)
+					return false;
+				std::memcpy(out, data, BYTE_GROUP_SIZE);
+				data += BYTE_GROUP_SIZE;
+				return true;
+			}
+
+			const int bits = 1 << bitsLog2;
+			const size_t packedBytes = BYTE_GROUP_SIZE * bits / 8;
+			if (static_cast<size_t>(end - data) < packedBytes)
+				return false;
+
+			const uint8_t escape = static_cast<uint8_t>((1 << bits) - 1);
+			const uint8_t* packed = data;
+			const uint8_t* extra = data + packedBytes;
+			for (size_t i = 0; i < BYTE_GROUP_SIZE; ++i)
+			{
+				const size_t bit = i * bits;
+				const uint8_t value = static_cast<uint8_t>((packed[bit / 8] >> (8 - bits - bit % 8)) & escape);
+				if (value == escape)
+				{
+					if (extra == end)
+						return false;
+					out[i] = *extra++;
+				}
+				else
+				{
+					out[i] = value;
+				}
+			}
+			data = extra;
+			return true;
+		}
+
+		// `size` (a multiple of 16) values: 2-bit modes for each group, low bits first, then the groups
+		bool DecodeBytes(const uint8_t*& data, const uint8_t* end, uint8_t* out, size_t size)
+		{
+			const size_t groups = size / BYTE_GROUP_SIZE;
+			const size_t headerSize = (groups + 3) / 4;
+			if (static_cast<size_t>(end - data) < headerSize)
+				return false;
+
+			const uint8_t* header = data;
+			data += headerSize;
+			for (size_t group = 0; group < groups; ++group)
+			{
+				const int bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+				if (!DecodeBytesGroup(data, end, out + group * BYTE_GROUP_SIZE, bitsLog2))
+					return false;
+			}
+			return true;
+		}
+
+		// Little-endian base-128, at most 5 bytes
+		bool DecodeVByte(const uint8_t*& data, const uint8_t* end, uint32_t& out)
+		{
+			out = 0;
+			for (uint32_t shift = 0; shift < 35; shift += 7)
+			{
+				if (data == end)
+					return false;
+				const uint8_t group = *data++;
+				out |= static_cast<uint32_t>(group & 127) << shift;
+				if (group < 128)
+					return true;
+			}
+			return false;
+		}
+
+		bool DecodeIndex(const uint8_t*& data, const uint8_t* end, uint32_t& last)
+		{
+			uint32_t v = 0;
+			if (!DecodeVByte(data, end, v))
+				return false;
+			last += (v >> 1) ^ (0u - (v & 1));
+			return true;
+		}
+
+		void WriteIndex(void* destination, size_t i, size_t indexSize, uint32_t index)
+		{
+			if (indexSize == 2)
+				static_cast<uint16_t*>(destination)[i] = static_cast<uint16_t>(index);
+			else
+				static_cast<uint32_t*>(destination)[i] = index;
+		}
+
+		int RoundToInt(float v)
+		{
+			return static_cast<int>(v + (v >= 0.0f ? 0.5f : -0.5f));
+		}
+
+		template <typename T>
+		void DecodeOctahedral(T* data, size_t count)
+		{
+			const float maxValue = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+			for (size_t i = 0; i < count; ++i)
+			{
+				// z was stored as the octahedral scale (1 in the same units)
+				float x = static_cast<float>(data[i * 4 + 0]);
+				float y = static_cast<float>(data[i * 4 + 1]);
+				const float z = static_cast<float>(data[i * 4 + 2]) - std::fabs(x) - std::fabs(y);
+
+				// Unfold the lower hemisphere
+				const float t = std::min(z, 0.0f);
+				x += x >= 0.0f ? t : -t;
+				y += y >= 0.0f ? t : -t;
+
+				const float length = std::sqrt(x * x + y * y + z * z);
+				const float scale = length > 0.0f ? maxValue / length : 0.0f;
+				data[i * 4 + 0] = static_cast<T>(RoundToInt(x * scale));
+				data[i * 4 + 1] = static_cast<T>(RoundToInt(y * scale));
+				data[i * 4 + 2] = static_cast<T>(RoundToInt(z * scale));
+			}
+		}
+
+		void DecodeQuaternion(int16_t* data, size_t count)
+		{
+			const float scale = 1.0f / std::sqrt(2.0f);
+			for (size_t i = 0; i < count; ++i)
+			{
+				// The fourth component holds the dropped component's index in
+				// its low 2 bits and the encoding's range in the rest
+				const int16_t packed = data[i * 4 + 3];
+				const float componentScale = scale / static_cast<float>(packed | 3);
+
+				const float x = static_cast<float>(data[i * 4 + 0]) * componentScale;
+				const float y = static_cast<float>(data[i * 4 + 1]) * componentScale;
+				const float z = static_cast<float>(data[i * 4 + 2]) * componentScale;
+				const float w = std::sqrt(std::max(1.0f - x * x - y * y - z * z, 0.0f));
+
+				const int dropped = packed & 3;
+				data[i * 4 + ((dropped + 1) & 3)] = static_cast<int16_t>(RoundToInt(x * 32767.0f));
+				data[i * 4 + ((dropped + 2) & 3)] = static_cast<int16_t>(RoundToInt(y * 32767.0f));
+				data[i * 4 + ((dropped + 3) & 3)] = static_cast<int16_t>(RoundToInt(z * 32767.0f));
+				data[i * 4 + dropped] = static_cast<int16_t>(RoundToInt(w * 32767.0f));
+			}
+		}
+
+		void DecodeExponential(uint32_t* data, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const int32_t mantissa = static_cast<int32_t>(data[i] << 8) >> 8;
+				const int32_t exponent = static_cast<int32_t>(data[i]) >> 24;
+				const float value = std::ldexp(static_cast<float>(mantissa), exponent);
+				std::memcpy(&data[i], &value, sizeof(value));
+			}
+		}
+
+		bool IsFilterStrideValid(MeshoptFilter filter, size_t stride)
+		{
+			switch (filter)
+			{
+			case MeshoptFilter::None:        return true;
+			case MeshoptFilter::Octahedral:  return stride == 4 || stride == 8;
+			case MeshoptFilter::Quaternion:  return stride == 8;
+			case MeshoptFilter::Exponential: return stride % 4 == 0;
+			default:                         return false;
+			}
+		}
+	}
+
+	bool DecodeMeshoptVertexBuffer(void* destination, size_t count, size_t stride,
+		const uint8_t* source, size_t sourceSize)
+	{
+		if (stride == 0 || stride > MAX_STRIDE || stride % 4 != 0)
+			return false;
+
+		const size_t tailSize = std::max(stride, TAIL_MAX_SIZE);
+		if (sourceSize < 1 + tailSize || (source[0] & 0xf0) != VERTEX_HEADER || (source[0] & 0x0f) > 0)
+			return false;
+
+		const uint8_t* data = source + 1;
+		const uint8_t* end = source + sourceSize - tailSize;
+
+		// Deltas of the first vertex are against itself, stored at the very end
+		uint8_t lastVertex[MAX_STRIDE];
+		std::memcpy(lastVertex, source + sourceSize - stride, stride);
+
+		const size_t blockSize = GetVertexBlockSize(stride);
+		uint8_t buffer[VERTEX_BLOCK_MAX_SIZE];
+		uint8_t* out = static_cast<uint8_t*>(destination);
+		for (size_t first = 0; first < count; first += blockSize)
+		{
+			const size_t blockCount = std::min(blockSize, count - first);
+			const size_t alignedCount = (blockCount + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+
+			for (size_t k = 0; k < stride; ++k)
+			{
+				if (!DecodeBytes(data, end, buffer, alignedCount))
+					return false;
+
+				uint8_t previous = lastVertex[k];
+				for (size_t i = 0; i < blockCount; ++i)
+				{
+					previous = static_cast<uint8_t>(Unzigzag8(buffer[i]) + previous);
+					out[(first + i) * stride + k] = previous;
+				}
+				lastVertex[k] = previous;
+			}
+		}
+		return data == end;
+	}
+
+	bool DecodeMeshoptIndexBuffer(void* destination, size_t count, size_t indexSize,
+		const uint8_t* source, size_t sourceSize)
+	{
+		constexpr size_t CODEAUX_TABLE_SIZE = 16;
+		if (count % 3 != 0 || (indexSize != 2 && indexSize != 4))
+			return false;
+		if (sourceSize < 1 + count / 3 + CODEAUX_TABLE_SIZE || (source[0] & 0xf0) != INDEX_HEADER)
+			return false;
+		const int version = source[0] & 0x0f;
+		if (version > 1)
+			return false;
+
+		uint32_t edgeFifo[16][2];
+		uint32_t vertexFifo[16];
+		std::memset(edgeFifo, 0xff, sizeof(edgeFifo));
+		std::memset(vertexFifo, 0xff, sizeof(vertexFifo));
+		size_t edgeOffset = 0;
+		size_t vertexOffset = 0;
+		auto pushEdge = [&](uint32_t a, uint32_t b)
+			{
+				edgeFifo[edgeOffset][0] = a;
+				edgeFifo[edgeOffset][1] = b;
+				edgeOffset = (edgeOffset + 1) & 15;
+			};
+		auto pushVertex = [&](uint32_t v, bool advance = true)
+			{
+				vertexFifo[vertexOffset] = v;
+				vertexOffset = (vertexOffset + (advance ? 1 : 0)) & 15;
+			};
+
+		uint32_t next = 0;   // the next never-seen vertex
+		uint32_t last = 0;   // base of delta-coded free indices
+		const int fecMax = version >= 1 ? 13 : 15;
+
+		const uint8_t* code = source + 1;
+		const uint8_t* data = code + count / 3;
+		const uint8_t* end = source + sourceSize - CODEAUX_TABLE_SIZE;
+		const uint8_t* codeauxTable = end;
+
+		for (size_t i = 0; i < count; i += 3)
+		{
+			const uint8_t codetri = *code++;
+			uint32_t a, b, c;
+
+			if (codetri < 0xf0)
+			{
+				// Edge from the FIFO plus one vertex: new, from the FIFO, or free
+				const int fe = codetri >> 4;
+				a = edgeFifo[(edgeOffset - 1 - fe) & 15][0];
+				b = edgeFifo[(edgeOffset - 1 - fe) & 15][1];
+
+				const int fec = codetri & 15;
+				if (fec < fecMax)
+				{
+					c = fec == 0 ? next++ : vertexFifo[(vertexOffset - 1 - fec) & 15];
+					pushVertex(c, fec == 0);
+				}
+				else
+				{
+					// 13 and 14 step the last free index by -1 and +1
+					if (fec != 15)
+						last += fec == 13 ? 0xffffffffu : 1u;
+					else if (!DecodeIndex(data, end, last))
+						return false;
+					c = last;
+					pushVertex(c);
+				}
+
+				pushEdge(c, b);
+				pushEdge(a, c);
+			}
+			else
+			{
+				// Three vertices: a is new (0xf0..0xfe) or free (0xff); b and c
+				// new, from the FIFO, or (0xfe/0xff only) free
+				int fea, feb, fec;
+				if (codetri < 0xfe)
+				{
+					fea = 0;
+					feb = codeauxTable[codetri & 15] >> 4;
+					fec = codeauxTable[codetri & 15] & 15;
+				}
+				else
+				{
+					if (data == end)
+						return false;
+					const uint8_t codeaux = *data++;
+					if (codeaux == 0)
+						next = 0;   // restart marker
+
+					fea = codetri == 0xfe ? 0 : 15;
+					feb = codeaux >> 4;
+					fec = codeaux & 15;
+				}
+
+				a = fea == 0 ? next++ : 0;
+				b = feb == 0 ? next++ : vertexFifo[(vertexOffset - feb) & 15];
+				c = fec == 0 ? next++ : vertexFifo[(vertexOffset - fec) & 15];
+
+				const bool freeAllowed = codetri >= 0xfe;
+				if (fea == 15)
+				{
+					if (!DecodeIndex(data, end, last))
+						return false;
+					a = last;
+				}
+				if (freeAllowed && feb == 15)
+				{
+					if (!DecodeIndex(data, end, last))
+						return false;
+					b = last;
+				}
+				if (freeAllowed && fec == 15)
+				{
+					if (!DecodeIndex(data, end, last))
+						return false;
+					c = last;
+				}
+
+				pushVertex(a);
+				pushVertex(b, feb == 0 || (freeAllowed && feb == 15));
+				pushVertex(c, fec == 0 || (freeAllowed && fec == 15));
+
+				pushEdge(b, a);
+				pushEdge(c, b);
+				pushEdge(a, c);
+			}
+
+			if (data > end)
+				return false;
+
+			WriteIndex(destination, i + 0, indexSize, a);
+			WriteIndex(destination, i + 1, indexSize, b);
+			WriteIndex(destination, i + 2, indexSize, c);
+		}
+		return data == end;
+	}
+
+	bool DecodeMeshoptIndexSequence(void* destination, size_t count, size_t indexSize,
+		const uint8_t* source, size_t sourceSize)
+	{
+		constexpr size_t TAIL_SIZE = 4;
+		if (indexSize != 2 && indexSize != 4)
+			return false;
+		if (sourceSize < 1 + count + TAIL_SIZE || (source[0] & 0xf0) != SEQUENCE_HEADER || (source[0] & 0x0f) > 1)
+			return false;
+
+		const uint8_t* data = source + 1;
+		const uint8_t* end = source + sourceSize - TAIL_SIZE;
+
+		// The low bit picks which base the delta is against
+		uint32_t last[2] = { 0, 0 };
+		for (size_t i = 0; i < count; ++i)
+		{
+			uint32_t v = 0;
+			if (!DecodeVByte(data, end, v))
+				return false;
+
+			const uint32_t base = v & 1;
+			v >>= 1;
+			last[base] += (v >> 1) ^ (0u - (v & 1));
+			WriteIndex(destination, i, indexSize, last[base]);
+		}
+		return data == end;
+	}
+
+	void ApplyMeshoptFilter(void* data, size_t count, size_t stride, MeshoptFilter filter)
+	{
+		switch (filter)
+		{
+		case MeshoptFilter::Octahedral:
+			if (stride == 4)
+				DecodeOctahedral(static_cast<int8_t*>(data), count);
+			else
+				DecodeOctahedral(static_cast<int16_t*>(data), count);
+			break;
+		case MeshoptFilter::Quaternion:
+			DecodeQuaternion(static_cast<int16_t*>(data), count);
+			break;
+		case MeshoptFilter::Exponential:
+			DecodeExponential(static_cast<uint32_t*>(data), count * stride / 4);
+			break;
+		default:
+			break;
+		}
+	}
+
+	bool DecodeMeshoptBuffer(void* destination, size_t count, size_t stride,
+		const uint8_t* source, size_t sourceSize, MeshoptMode mode, MeshoptFilter filter)
+	{
+		switch (mode)
+		{
+		case MeshoptMode::Attributes:
+			if (!IsFilterStrideValid(filter, stride)
+				|| !DecodeMeshoptVertexBuffer(destination, count, stride, source, sourceSize))
+			{
+				return false;
+			}
+			ApplyMeshoptFilter(destination, count, stride, filter);
+			return true;
+		case MeshoptMode::Triangles:
+			return filter == MeshoptFilter::None
+				&& DecodeMeshoptIndexBuffer(destination, count, stride, source, sourceSize);
+		case MeshoptMode::Indices:
+			return filter == MeshoptFilter::None
+				&& DecodeMeshoptIndexSequence(destination, count, stride, source, sourceSize);
+		default:
+			return false;
+		}
+	}
+}
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// MeshoptDecoder.hpp
+//
+// Decoder for EXT_meshopt_compression buffer views, which GLTFLoader expands
+// in place of the compressed bytes before it reads any accessor. The three
+// bitstreams of the extension:
+//
+//   Attributes  vertex codec (header 0xa0): per block of vertices, each byte
+//               column is delta-coded against the previous vertex, zigzagged
+//               and packed 0/2/4/8 bits per value in groups of 16
+//   Triangles   index codec (0xe0/0xe1): triangles coded against a 16-entry
+//               edge FIFO and vertex FIFO, free indices as varint deltas
+//   Indices     index sequence (0xd1): each index a varint delta against one
+//               of two running bases
+//
+// then the optional filter over the decoded attributes (octahedral normals,
+// quaternions, shared-exponent floats). Every stream is bounds checked:
+// truncated or corrupt input fails the decode instead of reading past it.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	enum class MeshoptMode : uint8_t
+	{
+		Attributes,
+		Triangles,
+		Indices
+	};
+
+	enum class MeshoptFilter : uint8_t
+	{
+		None,
+		Octahedral,    // 4 x int8 or 4 x int16: xy octahedral, z rebuilt
+		Quaternion,    // 4 x int16: three components, the largest rebuilt
+		Exponential    // int32s: 24-bit mantissa, 8-bit exponent, to float
+	};
+
+	// Decodes `count` elements of `stride` bytes into `destination`
+	// (count * stride bytes). Triangles and Indices take a stride of 2 or 4
+	// and no filter. Returns false if the stream is malformed; destination
+	// is then partly written.
+	bool DecodeMeshoptBuffer(void* destination, size_t count, size_t stride,
+		const uint8_t* source, size_t sourceSize, MeshoptMode mode, MeshoptFilter filter);
+
+	// The steps DecodeMeshoptBuffer runs, for tests
+	bool DecodeMeshoptVertexBuffer(void* destination, size_t count, size_t stride,
+		const uint8_t* source, size_t sourceSize);
+	bool DecodeMeshoptIndexBuffer(void* destination, size_t count, size_t indexSize,
+		const uint8_t* source, size_t sourceSize);
+	bool DecodeMeshoptIndexSequence(void* destination, size_t count, size_t indexSize,
+		const uint8_t* source, size_t sourceSize);
+	void ApplyMeshoptFilter(void* data, size_t count, size_t stride, MeshoptFilter filter);
+}
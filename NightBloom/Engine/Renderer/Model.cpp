@@ -5,12 +5,17 @@
 //------------------------------------------------------------------------------
 
 #include "Engine/Renderer/Model.hpp"
+#include "Engine/Renderer/Vertex.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanUploadManager.hpp"
+#include "Engine/Renderer/Meshlet.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>        // For glm::quat
@@ -32,18 +37,43 @@ namespace Nightbloom
 			return false;
 		}
 
-		return LoadFromData(*modelData, resourceManager, descriptorManager);
+		if (!resourceManager)
+		{
+			LOG_ERROR("ResourceManager is null");
+			return false;
+		}
+
+		PreparedTextureMap textures = resourceManager->PrepareTextures(GetTexturePaths(*modelData));
+		return LoadFromData(*modelData, resourceManager, descriptorManager, &textures);
+	}
+
+	std::vector<std::string> Model::GetTexturePaths(const ModelData& data)
+	{
+		std::vector<std::string> paths;
+		for (const MaterialData& material : data.materials)
+		{
+			for (const std::string* path : { &material.baseColorTexturePath, &material.normalTexturePath })
+			{
+				if (!path->empty() && std::find(paths.begin(), paths.end(), *path) == paths.end())
+					paths.push_back(*path);
+			}
+		}
+		return paths;
 	}
 
 	bool Model::LoadFromData(const ModelData& data,
 		ResourceManager* resourceManager,
-		VulkanDescriptorManager* descriptorManager)
+		VulkanDescriptorManager* descriptorManager,
+		PreparedTextureMap* preparedTextures)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Model);
+
 		if (!resourceManager)
 		{
 			LOG_ERROR("ResourceManager is null");
 			return false;
 		}
+		VulkanMeshArena* meshArena = resourceManager->GetMeshArena();
 
 		m_Name = data.name;
 		m_SourcePath = data.sourcePath;
@@ -51,6 +81,22 @@ namespace Nightbloom
 		LOG_INFO("Loading model '{}' with {} meshes and {} materials",
 			m_Name, data.meshes.size(), data.materials.size());
 
+		// Every texture and mesh buffer of the model goes out in one submission
+		UploadBatchScope uploadBatch(resourceManager->GetUploadManager());
+
+		auto loadTexture = [&](const std::string& texName, const std::string& path) -> VulkanTexture*
+		{
+			if (preparedTextures)
+			{
+				// A streamed texture takes the mapped file, so a second
+				// material using the same path reads it again
+				auto it = preparedTextures->find(path);
+				if (it != preparedTextures->end() && it->second.IsValid())
+					return resourceManager->CreatePreparedTexture(texName, it->second);
+			}
+			return resourceManager->LoadTexture(texName, path);
+		};
+
 		// Load materials first
 		m_Materials.reserve(data.materials.size());
 		for (size_t i = 0; i < data.materials.size(); ++i)
@@ -67,12 +113,13 @@ namespace Nightbloom
 			if (!matData.baseColorTexturePath.empty())
 			{
 				std::string texName = m_Name + "_albedo_" + std::to_string(i);
-				VulkanTexture* texture = resourceManager->LoadTexture(texName, matData.baseColorTexturePath);
+				VulkanTexture* texture = loadTexture(texName, matData.baseColorTexturePath);
 
 				if (texture)
 				{
-					// Create descriptor set for the texture
-					if (descriptorManager && !texture->HasDescriptorSet())
+					// Create descriptor set for the texture (LoadTexture already
+					// gave it a bindless slot when the table exists)
+					if (descriptorManager && !texture->HasDescriptorSet() && !texture->HasBindlessIndex())
 					{
 						texture->CreateDescriptorSet(descriptorManager);
 					}
@@ -89,11 +136,11 @@ namespace Nightbloom
 			if (!matData.normalTexturePath.empty())
 			{
 				std::string texName = m_Name + "_normal_" + std::to_string(i);
-				VulkanTexture* texture = resourceManager->LoadTexture(texName, matData.normalTexturePath);
+				VulkanTexture* texture = loadTexture(texName, matData.normalTexturePath);
 
 				if (texture)
 				{
-					if (descriptorManager && !texture->HasDescriptorSet())
+					if (descriptorManager && !texture->HasDescriptorSet() && !texture->HasBindlessIndex())
 					{
 						texture->CreateDescriptorSet(descriptorManager);
 					}
@@ -101,6 +148,9 @@ namespace Nightbloom
 				}
 			}
 
+			material->SetBindlessIndex(
+				resourceManager->RegisterMaterial(m_Name + "_material_" + std::to_string(i), *material));
+
 			m_Materials.push_back(std::move(material));
 		}
 
@@ -111,48 +161,80 @@ namespace Nightbloom
 			const auto& meshData = data.meshes[i];
 			auto mesh = std::make_unique<Mesh>(meshData.name);
 
-			// Create vertex buffer
-			std::string vbName = m_Name + "_vb_" + std::to_string(i);
-			VkDeviceSize vbSize = meshData.vertices.size() * sizeof(VertexPNT);
-
-			auto vertexBuffer = resourceManager->CreateVertexBufferUnique(vbName, vbSize, false);
-			if (!vertexBuffer)
+			// Packed meshes quantize positions over their own bounds. Skinned
+			// ones stay Standard: SkinningSystem writes full-precision VertexPNT.
+			const void* vertexData = meshData.vertices.data();
+			std::vector<PackedVertex> packedVertices;
+			VertexQuantization quantization;
+			if (m_VertexFormat == VertexFormat::Packed && !meshData.vertices.empty() && !meshData.IsSkinned())
 			{
-				LOG_ERROR("Failed to create vertex buffer for mesh '{}'", meshData.name);
-				continue;
+				quantization = ComputeVertexQuantization(meshData.boundsMin, meshData.boundsMax);
+				packedVertices.resize(meshData.vertices.size());
+				const VertexPNT* source = meshData.vertices.data();
+				PackVertices(&source->position, &source->normal, &source->texCoord, sizeof(VertexPNT),
+					meshData.vertices.size(), quantization, packedVertices.data());
+				vertexData = packedVertices.data();
 			}
 
-			// Upload vertex data
-			if (!vertexBuffer->UploadData(meshData.vertices.data(), vbSize, 0,
-				resourceManager->GetTransferCommandPool()))
+			// Vertices and indices go into the shared arena buffers
+			const VertexFormat format = packedVertices.empty() ? VertexFormat::Standard : VertexFormat::Packed;
+			MeshArenaAllocation geometry = meshArena->Allocate(format,
+				vertexData, static_cast<uint32_t>(meshData.vertices.size()),
+				meshData.indices.data(), static_cast<uint32_t>(meshData.indices.size()),
+				resourceManager->GetTransferCommandPool());
+			if (!geometry.IsValid())
 			{
-				LOG_ERROR("Failed to upload vertex data for mesh '{}'", meshData.name);
+				LOG_ERROR("Failed to upload geometry for mesh '{}'", meshData.name);
 				continue;
 			}
 
-			// Create index buffer
-			std::string ibName = m_Name + "_ib_" + std::to_string(i);
-			VkDeviceSize ibSize = meshData.indices.size() * sizeof(uint32_t);
+			// Simplified levels: more index lists over the same vertices. A
+			// failed one ends the chain, since levels must stay in ascending
+			// error order.
+			std::vector<float> lodErrors;
+			for (size_t lod = 0; lod < meshData.lods.size(); ++lod)
+			{
+				const MeshLodLevel& level = meshData.lods[lod];
+				if (!meshArena->AppendIndices(geometry, level.indices.data(),
+					static_cast<uint32_t>(level.indices.size()), resourceManager->GetTransferCommandPool()))
+				{
+					LOG_WARN("Failed to upload LOD {} for mesh '{}'", lod + 1, meshData.name);
+					break;
+				}
+				lodErrors.push_back(level.error);
+			}
 
-			auto indexBuffer = resourceManager->CreateIndexBufferUnique(ibName, ibSize, false);
-			if (!indexBuffer)
+			// Meshlets are culled against the positions the vertex buffer
+			// holds, so packed meshes re-bound them in quantized space
+			if (!meshData.meshlets.empty())
 			{
-				LOG_ERROR("Failed to create index buffer for mesh '{}'", meshData.name);
-				continue;
+				std::vector<Meshlet> meshlets = meshData.meshlets;
+				if (format == VertexFormat::Packed)
+				{
+					std::vector<glm::vec3> quantized(meshData.vertices.size());
+					for (size_t v = 0; v < quantized.size(); ++v)
+						quantized[v] = (meshData.vertices[v].position - quantization.offset) / quantization.scale;
+					for (Meshlet& meshlet : meshlets)
+						ComputeMeshletBounds(quantized.data(), sizeof(glm::vec3), meshData.indices.data(), meshlet);
+				}
+				if (!meshArena->SetMeshlets(geometry, meshlets.data(), static_cast<uint32_t>(meshlets.size()),
+					resourceManager->GetTransferCommandPool()))
+					LOG_WARN("Failed to upload meshlets for mesh '{}'", meshData.name);
 			}
 
-			// Upload index data
-			if (!indexBuffer->UploadData(meshData.indices.data(), ibSize, 0,
-				resourceManager->GetTransferCommandPool()))
+			// Skinning source; the bind-pose vertices above are what the mesh
+			// draws with until (or without) a skinning pass
+			if (meshData.IsSkinned())
 			{
-				LOG_ERROR("Failed to upload index data for mesh '{}'", meshData.name);
-				continue;
+				std::vector<SkinnedVertex> skinned(meshData.vertices.size());
+				for (size_t v = 0; v < skinned.size(); ++v)
+					skinned[v] = { meshData.vertices[v], meshData.skin[v] };
+				if (!meshArena->SetSkin(geometry, skinned.data(), static_cast<uint32_t>(skinned.size()),
+					resourceManager->GetTransferCommandPool()))
+					LOG_WARN("Failed to upload skin for mesh '{}'", meshData.name);
 			}
 
-			mesh->SetVertexBuffer(std::move(vertexBuffer));
-			mesh->SetIndexBuffer(std::move(indexBuffer));
-			mesh->SetVertexCount(static_cast<uint32_t>(meshData.vertices.size()));
-			mesh->SetIndexCount(static_cast<uint32_t>(meshData.indices.size()));
+			mesh->SetGeometry(std::move(geometry), quantization, lodErrors);
 			mesh->SetBounds(meshData.boundsMin, meshData.boundsMax);
 
 			// Assign material
@@ -170,6 +252,9 @@ namespace Nightbloom
 			m_Meshes.push_back(std::move(mesh));
 		}
 
+		m_Skeleton = data.skeleton;
+		m_Animations = data.animations;
+
 		CalculateBounds();
 
 		LOG_INFO("Model '{}' loaded: {} meshes, {} total vertices, {} total indices",
@@ -207,6 +292,18 @@ namespace Nightbloom
 		SetScale(glm::vec3(uniformScale));
 	}
 
+	void Model::SwapContents(Model& other)
+	{
+		std::swap(m_Meshes, other.m_Meshes);
+		std::swap(m_Materials, other.m_Materials);
+		std::swap(m_Skeleton, other.m_Skeleton);
+		std::swap(m_Animations, other.m_Animations);
+		std::swap(m_TotalVertices, other.m_TotalVertices);
+		std::swap(m_TotalIndices, other.m_TotalIndices);
+		CalculateBounds();
+		other.CalculateBounds();
+	}
+
 	void Model::CalculateBounds()
 	{
 		if (m_Meshes.empty())
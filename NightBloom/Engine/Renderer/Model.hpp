@@ -8,23 +8,27 @@
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Renderer/GLTFLoader.hpp"
+#include "Engine/Core/AssetLoadQueue.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace Nightbloom
 {
 	class ResourceManager;
 	class VulkanDescriptorManager;
+	struct PreparedTexture;
 
 	class Model
 	{
 	public:
 		Model() = default;
 		Model(const std::string& name) : m_Name(name) {}
-		~Model() = default;
+		// A load still in flight into this model is cancelled
+		~Model() { m_PendingLoad.Cancel(); }
 
 		// Model cannot be copied
 		Model(const Model&) = delete;
@@ -34,15 +38,43 @@ namespace Nightbloom
 		Model(Model&&) = default;
 		Model& operator=(Model&&) = default;
 
-		// Load from file (uses GLTFLoader internally)
+		// Load from file (uses GLTFLoader internally). The material textures
+		// are decoded in parallel on the job system first.
 		bool LoadFromFile(const std::string& filepath,
 			ResourceManager* resourceManager,
 			VulkanDescriptorManager* descriptorManager);
 
-		// Load from already-parsed ModelData
+		// Load from already-parsed ModelData. Material textures found in
+		// preparedTextures (keyed by their path in `data`) are created from
+		// it instead of being read here.
 		bool LoadFromData(const ModelData& data,
 			ResourceManager* resourceManager,
-			VulkanDescriptorManager* descriptorManager);
+			VulkanDescriptorManager* descriptorManager,
+			std::unordered_map<std::string, PreparedTexture>* preparedTextures = nullptr);
+
+		// Distinct texture paths the materials of `data` reference
+		static std::vector<std::string> GetTexturePaths(const ModelData& data);
+
+		// Set by AsyncAssetLoader::LoadModel; the model is empty until the
+		// load is done
+		void SetPendingLoad(const AssetHandle& handle, const std::string& sourcePath)
+		{
+			m_PendingLoad = handle;
+			m_SourcePath = sourcePath;
+		}
+		bool IsLoading() const { return m_PendingLoad.IsValid() && !m_PendingLoad.IsDone(); }
+
+		// Hot reload: trades meshes, materials, skeleton and animations with
+		// `other` (a fresh load of the same file), leaving it the old ones to
+		// release once frames in flight are done with them. Name, source
+		// path, transform and vertex format stay.
+		void SwapContents(Model& other);
+
+		// Vertex layout used by the next load. Packed (the default) halves
+		// vertex memory and fetch bandwidth (VertexPacking.hpp); Standard
+		// keeps full-precision VertexPNT.
+		void SetVertexFormat(VertexFormat format) { m_VertexFormat = format; }
+		VertexFormat GetVertexFormat() const { return m_VertexFormat; }
 
 		// Getters
 		const std::string& GetName() const { return m_Name; }
@@ -52,6 +84,12 @@ namespace Nightbloom
 		size_t GetMeshCount() const { return m_Meshes.size(); }
 		Mesh* GetMesh(size_t index) const { return index < m_Meshes.size() ? m_Meshes[index].get() : nullptr; }
 
+		// Skeleton and clips of a skinned model (empty otherwise); the
+		// meshes with GetSkinVertexCount() > 0 are bound to it
+		const Skeleton& GetSkeleton() const { return m_Skeleton; }
+		const std::vector<AnimationClip>& GetAnimations() const { return m_Animations; }
+		bool IsSkinned() const { return !m_Skeleton.IsEmpty(); }
+
 		const std::vector<std::unique_ptr<Material>>& GetMaterials() const { return m_Materials; }
 		size_t GetMaterialCount() const { return m_Materials.size(); }
 		Material* GetMaterial(size_t index) const { return index < m_Materials.size() ? m_Materials[index].get() : nullptr; }
@@ -87,6 +125,9 @@ namespace Nightbloom
 		std::vector<std::unique_ptr<Mesh>> m_Meshes;
 		std::vector<std::unique_ptr<Material>> m_Materials;
 
+		Skeleton m_Skeleton;
+		std::vector<AnimationClip> m_Animations;
+
 		// Transform
 		glm::mat4 m_Transform = glm::mat4(1.0f);
 		glm::vec3 m_Position = glm::vec3(0.0f);
@@ -100,6 +141,10 @@ namespace Nightbloom
 		// Statistics
 		size_t m_TotalVertices = 0;
 		size_t m_TotalIndices = 0;
+
+		VertexFormat m_VertexFormat = VertexFormat::Packed;
+
+		AssetHandle m_PendingLoad;
 	};
 
 } // namespace Nightbloom
\ No newline at end of file
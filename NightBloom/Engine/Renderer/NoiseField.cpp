@@ -0,0 +1,326 @@
+//------------------------------------------------------------------------------
+// NoiseField.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/NoiseField.hpp"
+#include "Engine/Math/SimdMath.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// =====================================================================
+		// Lanes - eight floats, one per point of a Sample8 batch. The noise
+		// below is written once against float and Lanes alike.
+		// =====================================================================
+		struct Lanes
+		{
+#if defined(NB_SIMD_AVX2)
+			__m256 v;
+			Lanes() = default;
+			Lanes(float s) : v(_mm256_set1_ps(s)) {}
+#elif defined(NB_SIMD_SSE)
+			__m128 lo, hi;
+			Lanes() = default;
+			Lanes(float s) : lo(_mm_set1_ps(s)), hi(lo) {}
+#elif defined(NB_SIMD_NEON)
+			float32x4_t lo, hi;
+			Lanes() = default;
+			Lanes(float s) : lo(vdupq_n_f32(s)), hi(lo) {}
+#else
+			float v[8];
+			Lanes() = default;
+			Lanes(float s) { std::fill(v, v + 8, s); }
+#endif
+		};
+
+#if defined(NB_SIMD_AVX2)
+#define NB_LANES_BINARY(name, avx, sse, neon) \
+		inline Lanes name(const Lanes& a, const Lanes& b) { Lanes r; r.v = avx(a.v, b.v); return r; }
+#define NB_LANES_UNARY(name, avx, sse, neon, scalar) \
+		inline Lanes name(const Lanes& a) { Lanes r; r.v = avx(a.v); return r; }
+#elif defined(NB_SIMD_SSE)
+#define NB_LANES_BINARY(name, avx, sse, neon) \
+		inline Lanes name(const Lanes& a, const Lanes& b) { Lanes r; r.lo = sse(a.lo, b.lo); r.hi = sse(a.hi, b.hi); return r; }
+#define NB_LANES_UNARY(name, avx, sse, neon, scalar) \
+		inline Lanes name(const Lanes& a) { Lanes r; r.lo = sse(a.lo); r.hi = sse(a.hi); return r; }
+#elif defined(NB_SIMD_NEON)
+#define NB_LANES_BINARY(name, avx, sse, neon) \
+		inline Lanes name(const Lanes& a, const Lanes& b) { Lanes r; r.lo = neon(a.lo, b.lo); r.hi = neon(a.hi, b.hi); return r; }
+#define NB_LANES_UNARY(name, avx, sse, neon, scalar) \
+		inline Lanes name(const Lanes& a) { Lanes r; r.lo = neon(a.lo); r.hi = neon(a.hi); return r; }
+#endif
+
+#if defined(NB_SIMD_SSE) && !defined(NB_SIMD_AVX2)
+		// SSE2 has no round instruction: truncate, then step down where
+		// that rounded up (negatives). Exact below 2^31.
+		inline __m128 FloorSse2(__m128 x)
+		{
+			const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+			return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+		}
+#endif
+
+#if defined(NB_SIMD_AVX2) || defined(NB_SIMD_SSE) || defined(NB_SIMD_NEON)
+		NB_LANES_BINARY(operator+, _mm256_add_ps, _mm_add_ps, vaddq_f32)
+		NB_LANES_BINARY(operator-, _mm256_sub_ps, _mm_sub_ps, vsubq_f32)
+		NB_LANES_BINARY(operator*, _mm256_mul_ps, _mm_mul_ps, vmulq_f32)
+		NB_LANES_BINARY(operator/, _mm256_div_ps, _mm_div_ps, vdivq_f32)
+		NB_LANES_BINARY(Min, _mm256_min_ps, _mm_min_ps, vminq_f32)
+		NB_LANES_BINARY(Max, _mm256_max_ps, _mm_max_ps, vmaxq_f32)
+		NB_LANES_UNARY(Floor, _mm256_floor_ps, FloorSse2, vrndmq_f32, std::floor)
+		NB_LANES_UNARY(Sqrt, _mm256_sqrt_ps, _mm_sqrt_ps, vsqrtq_f32, std::sqrt)
+#undef NB_LANES_BINARY
+#undef NB_LANES_UNARY
+
+		inline Lanes LoadLanes(const float* values)
+		{
+			Lanes r;
+#if defined(NB_SIMD_AVX2)
+			r.v = _mm256_loadu_ps(values);
+#elif defined(NB_SIMD_SSE)
+			r.lo = _mm_loadu_ps(values);
+			r.hi = _mm_loadu_ps(values + 4);
+#else
+			r.lo = vld1q_f32(values);
+			r.hi = vld1q_f32(values + 4);
+#endif
+			return r;
+		}
+
+		inline void StoreLanes(const Lanes& lanes, float* out)
+		{
+#if defined(NB_SIMD_AVX2)
+			_mm256_storeu_ps(out, lanes.v);
+#elif defined(NB_SIMD_SSE)
+			_mm_storeu_ps(out, lanes.lo);
+			_mm_storeu_ps(out + 4, lanes.hi);
+#else
+			vst1q_f32(out, lanes.lo);
+			vst1q_f32(out + 4, lanes.hi);
+#endif
+		}
+#else
+		template<typename Op>
+		inline Lanes PerLane(const Lanes& a, const Lanes& b, Op op)
+		{
+			Lanes r;
+			for (int i = 0; i < 8; ++i)
+				r.v[i] = op(a.v[i], b.v[i]);
+			return r;
+		}
+
+		inline Lanes operator+(const Lanes& a, const Lanes& b) { return PerLane(a, b, [](float x, float y) { return x + y; }); }
+		inline Lanes operator-(const Lanes& a, const Lanes& b) { return PerLane(a, b, [](float x, float y) { return x - y; }); }
+		inline Lanes operator*(const Lanes& a, const Lanes& b) { return PerLane(a, b, [](float x, float y) { return x * y; }); }
+		inline Lanes operator/(const Lanes& a, const Lanes& b) { return PerLane(a, b, [](float x, float y) { return x / y; }); }
+		inline Lanes Min(const Lanes& a, const Lanes& b) { return PerLane(a, b, [](float x, float y) { return std::min(x, y); }); }
+		inline Lanes Max(const Lanes& a, const Lanes& b) { return PerLane(a, b, [](float x, float y) { return std::max(x, y); }); }
+		inline Lanes Floor(const Lanes& a) { return PerLane(a, a, [](float x, float) { return std::floor(x); }); }
+		inline Lanes Sqrt(const Lanes& a) { return PerLane(a, a, [](float x, float) { return std::sqrt(x); }); }
+
+		inline Lanes LoadLanes(const float* values)
+		{
+			Lanes r;
+			std::copy(values, values + 8, r.v);
+			return r;
+		}
+
+		inline void StoreLanes(const Lanes& lanes, float* out)
+		{
+			std::copy(lanes.v, lanes.v + 8, out);
+		}
+#endif
+
+		// The float counterparts, so the noise reads the same for both
+		inline float Min(float a, float b) { return std::min(a, b); }
+		inline float Max(float a, float b) { return std::max(a, b); }
+		inline float Floor(float a) { return std::floor(a); }
+		inline float Sqrt(float a) { return std::sqrt(a); }
+
+		// =====================================================================
+		// The shader functions, in GLSL's evaluation order
+		// =====================================================================
+		template<typename T>
+		struct Vec3T
+		{
+			T x, y, z;
+		};
+
+		template<typename T> T Fract(const T& v) { return v - Floor(v); }
+		template<typename T> T Mod(const T& v, const T& period) { return v - period * Floor(v / period); }
+		template<typename T> T Clamp(const T& v, const T& lo, const T& hi) { return Min(Max(v, lo), hi); }
+		template<typename T> T Mix(const T& a, const T& b, const T& t) { return a * (T(1.0f) - t) + b * t; }
+
+		// hash33: fract(p * k); p += dot(p, p.yxz + 33.33); fract((p.xxy + p.yxx) * p.zyx)
+		template<typename T>
+		Vec3T<T> Hash(Vec3T<T> p)
+		{
+			p.x = Fract(p.x * T(0.1031f));
+			p.y = Fract(p.y * T(0.1030f));
+			p.z = Fract(p.z * T(0.0973f));
+			const T d = p.x * (p.y + T(33.33f)) + p.y * (p.x + T(33.33f)) + p.z * (p.z + T(33.33f));
+			p.x = p.x + d;
+			p.y = p.y + d;
+			p.z = p.z + d;
+			return { Fract((p.x + p.y) * p.z), Fract((p.x + p.x) * p.y), Fract((p.y + p.x) * p.x) };
+		}
+
+		template<typename T>
+		T Perlin(const Vec3T<T>& p, const T& period)
+		{
+			const Vec3T<T> i{ Floor(p.x), Floor(p.y), Floor(p.z) };
+			const Vec3T<T> f{ p.x - i.x, p.y - i.y, p.z - i.z };
+
+			// Quintic fade, f * f * f * (f * (f * 6 - 15) + 10)
+			auto fade = [](const T& t) { return t * t * t * (t * (t * T(6.0f) - T(15.0f)) + T(10.0f)); };
+			const Vec3T<T> u{ fade(f.x), fade(f.y), fade(f.z) };
+
+			// Corner c = x + 2y + 4z: n000, n100, n010, n110, n001, ...
+			T n[8];
+			for (int c = 0; c < 8; ++c)
+			{
+				const float ox = static_cast<float>(c & 1);
+				const float oy = static_cast<float>((c >> 1) & 1);
+				const float oz = static_cast<float>((c >> 2) & 1);
+				const Vec3T<T> g = Hash(Vec3T<T>{ Mod(i.x + T(ox), period), Mod(i.y + T(oy), period), Mod(i.z + T(oz), period) });
+				n[c] = (g.x * T(2.0f) - T(1.0f)) * (f.x - T(ox))
+					+ (g.y * T(2.0f) - T(1.0f)) * (f.y - T(oy))
+					+ (g.z * T(2.0f) - T(1.0f)) * (f.z - T(oz));
+			}
+
+			return Mix(
+				Mix(Mix(n[0], n[1], u.x), Mix(n[2], n[3], u.x), u.y),
+				Mix(Mix(n[4], n[5], u.x), Mix(n[6], n[7], u.x), u.y),
+				u.z);
+		}
+
+		// Distance to the nearest feature point of the 3x3x3 cells around p;
+		// the hash takes the wrapped cell, the distance the unwrapped one
+		template<typename T>
+		T Worley(const Vec3T<T>& p, const T& period)
+		{
+			const Vec3T<T> i{ Floor(p.x), Floor(p.y), Floor(p.z) };
+			T minDist(1e10f);
+			for (int z = -1; z <= 1; ++z)
+			for (int y = -1; y <= 1; ++y)
+			for (int x = -1; x <= 1; ++x)
+			{
+				const Vec3T<T> cell{ i.x + T(static_cast<float>(x)), i.y + T(static_cast<float>(y)), i.z + T(static_cast<float>(z)) };
+				const Vec3T<T> h = Hash(Vec3T<T>{ Mod(cell.x, period), Mod(cell.y, period), Mod(cell.z, period) });
+				const T dx = (cell.x + h.x) - p.x;
+				const T dy = (cell.y + h.y) - p.y;
+				const T dz = (cell.z + h.z) - p.z;
+				minDist = Min(minDist, Sqrt(dx * dx + dy * dy + dz * dz));
+			}
+			return Clamp(minDist, T(0.0f), T(1.0f));
+		}
+
+		template<typename T>
+		Vec3T<T> Scale(const Vec3T<T>& p, float s)
+		{
+			return { p.x * T(s), p.y * T(s), p.z * T(s) };
+		}
+	}
+
+	NoiseField::NoiseField(const NoiseTextureDesc& desc, float periodScale)
+		: m_Type(desc.noiseType)
+		, m_Octaves(std::max(desc.octaves, 1u))   // the shaders divide by the amplitude sum
+		, m_Frequency(desc.frequency)
+		, m_Persistence(desc.persistence)
+		, m_Lacunarity(desc.lacunarity)
+		, m_PeriodScale(periodScale)
+	{
+		const float seed = static_cast<float>(desc.seed);
+		m_SeedOffset = Hash33(glm::vec3(seed * 1.0f, seed * 1.3f, seed * 0.7f));
+	}
+
+	glm::vec3 NoiseField::Hash33(const glm::vec3& p)
+	{
+		const Vec3T<float> h = Hash(Vec3T<float>{ p.x, p.y, p.z });
+		return glm::vec3(h.x, h.y, h.z);
+	}
+
+	template<typename T>
+	T NoiseField::Evaluate(const T& x, const T& y, const T& z) const
+	{
+		const Vec3T<T> p{ x, y, z };
+
+		// fbm_perlin: each octave's lattice repeats every `freq` cells
+		auto fbmPerlin = [&]()
+		{
+			T value(0.0f);
+			float amp = 0.5f;
+			float totalAmp = 0.0f;
+			float freq = m_Frequency;
+			for (uint32_t i = 0; i < m_Octaves; ++i)
+			{
+				value = value + T(amp) * Perlin(Scale(p, freq), T(freq * m_PeriodScale));
+				totalAmp += amp;
+				freq *= m_Lacunarity;
+				amp *= m_Persistence;
+			}
+			return (value / T(totalAmp)) * T(0.5f) + T(0.5f);
+		};
+
+		if (m_Type == NoiseType::Worley)
+		{
+			T value(0.0f);
+			float amp = 0.5f;
+			float totalAmp = 0.0f;
+			float freq = m_Frequency;
+			for (uint32_t i = 0; i < m_Octaves; ++i)
+			{
+				value = value + T(amp) * (T(1.0f) - Worley(Scale(p, freq), T(freq * m_PeriodScale)));
+				totalAmp += amp;
+				freq *= m_Lacunarity;
+				amp *= m_Persistence;
+			}
+			return Clamp(value / T(totalAmp), T(0.0f), T(1.0f));
+		}
+
+		if (m_Type == NoiseType::PerlinWorley)
+		{
+			// remap(perlin, worley * 0.5, 1, 0, 1): Worley erodes the Perlin base
+			const T perlinValue = fbmPerlin();
+			const float worleyFreq = m_Frequency * 2.0f;
+			const T worleyValue = T(1.0f) - Worley(Scale(p, worleyFreq), T(worleyFreq * m_PeriodScale));
+			const T lo = worleyValue * T(0.5f);
+			return T(0.0f) + Clamp((perlinValue - lo) / Max(T(1.0f) - lo, T(1e-6f)), T(0.0f), T(1.0f)) * T(1.0f);
+		}
+
+		// Perlin, and the shaders' fallback for unknown types
+		return fbmPerlin();
+	}
+
+	float NoiseField::Sample(const glm::vec3& p) const
+	{
+		return Evaluate<float>(p.x, p.y, p.z);
+	}
+
+	void NoiseField::Sample8(const float* x, const float* y, const float* z, float* out) const
+	{
+		StoreLanes(Evaluate<Lanes>(LoadLanes(x), LoadLanes(y), LoadLanes(z)), out);
+	}
+
+	void NoiseField::SampleUVs(const float* u, const float* v, float* out, size_t count) const
+	{
+		float x[BATCH], y[BATCH], z[BATCH], result[BATCH];
+		std::fill(z, z + BATCH, 0.5f + m_SeedOffset.z);
+		for (size_t first = 0; first < count; first += BATCH)
+		{
+			// The tail is padded with its last point rather than run scalar
+			const size_t n = std::min<size_t>(BATCH, count - first);
+			for (size_t i = 0; i < BATCH; ++i)
+			{
+				const size_t src = first + std::min(i, n - 1);
+				x[i] = u[src] + m_SeedOffset.x;
+				y[i] = v[src] + m_SeedOffset.y;
+			}
+			Sample8(x, y, z, result);
+			std::copy(result, result + n, out + first);
+		}
+	}
+}
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+// NoiseField.hpp
+//
+// The noise NoiseTextureGenerator's shaders write (noise.comp, noise2D.comp),
+// evaluated on the CPU: Perlin, Worley and Perlin-Worley FBM with the same
+// hash, lattice wrap and remaps, so a CPU query lands on the texel value the
+// GPU produced (to float rounding; the GPU may fuse multiply-adds). Only the
+// R channel - NoiseChannelLayout::CloudShape's extra octaves aren't here.
+//
+// Sample8 evaluates eight points per call: one AVX2 register, or two SSE2 or
+// NEON ones (NB_SIMD_* in SimdMath.hpp), scalar otherwise. It runs the same
+// operations in the same order as Sample, so without FMA contraction the two
+// agree exactly.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/NoiseTextureDesc.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class NoiseField
+	{
+	public:
+		static constexpr uint32_t BATCH = 8;
+
+		NoiseField() = default;
+
+		// desc's noise type, FBM parameters and seed; its size and format
+		// don't matter here. periodScale is NoiseRegion::periodScale.
+		explicit NoiseField(const NoiseTextureDesc& desc, float periodScale = 1.0f);
+
+		// Noise-space point of a texture uvw: uvw plus the seed's offset.
+		// Flat noise (noise2D.comp) sits at w = 0.5.
+		glm::vec3 ToNoiseSpace(const glm::vec3& uvw) const { return uvw + m_SeedOffset; }
+
+		// Noise at noise-space points, [0, 1]
+		float Sample(const glm::vec3& p) const;
+		void Sample8(const float* x, const float* y, const float* z, float* out) const;
+
+		// Flat noise at texture uv (a region's window of it for tiles);
+		// SampleUVs does `count` points in batches of eight
+		float SampleUV(float u, float v) const { return Sample(ToNoiseSpace(glm::vec3(u, v, 0.5f))); }
+		void SampleUVs(const float* u, const float* v, float* out, size_t count) const;
+
+		// The hash the shaders and this share, [0, 1)^3
+		static glm::vec3 Hash33(const glm::vec3& p);
+
+	private:
+		template<typename T>
+		T Evaluate(const T& x, const T& y, const T& z) const;
+
+		NoiseType m_Type = NoiseType::Perlin;
+		uint32_t m_Octaves = 4;
+		float m_Frequency = 4.0f;
+		float m_Persistence = 0.5f;
+		float m_Lacunarity = 2.0f;
+		float m_PeriodScale = 1.0f;
+		glm::vec3 m_SeedOffset = glm::vec3(0.0f);
+	};
+}
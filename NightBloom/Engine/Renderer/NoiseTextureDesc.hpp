@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// NoiseTextureDesc.hpp
+//
+// What NoiseTextureGenerator produces: noise type, size, FBM parameters and
+// the stored format (see NoiseVolumePacking.hpp for the low-precision ones).
+// Split from the generator so the cache key (NoiseVolumeCache) can be
+// computed and tested without Vulkan.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Nightbloom
+{
+	// =========================================================================
+	// NoiseType
+	// =========================================================================
+	enum class NoiseType
+	{
+		Perlin = 0,    // FBM Perlin noise,          output [0, 1]
+		Worley = 1,    // Inverted FBM Worley,        output [0, 1]  (bright = cell centers)
+		PerlinWorley = 2,   // Perlin base eroded by Worley — primary cloud shape channel
+
+
+	};
+
+	// =========================================================================
+	// NoiseTextureFormat
+	// How the texels are stored. RGBA32F is what the compute shaders write;
+	// the others are packed from it on the CPU after generation, trading a
+	// one-off readback for 4-32x less memory and bandwidth per fetch.
+	// =========================================================================
+	enum class NoiseTextureFormat
+	{
+		RGBA32F = 0,   // 16 bytes/texel, as generated (storage-capable)
+		R8 = 1,        // 1 byte/texel, R only
+		RG8 = 2,       // 2 bytes/texel, R and G
+		RGBA8 = 3,     // 4 bytes/texel, all four channels
+		BC4 = 4,       // 0.5 bytes/texel, R only; R8 on devices without BC
+	};
+
+	// =========================================================================
+	// NoiseChannelLayout
+	// What the channels hold. Single writes (v, v, v, 1). CloudShape keeps
+	// the noise in R and adds inverted single-octave Worley at 2x, 4x and 8x
+	// the base frequency in G, B and A (Schneider's packed cloud shape): the
+	// raymarch erodes R by their FBM (cloud_density.glsl), so one RGBA8 fetch
+	// carries four noise octaves. Formats with fewer channels drop the rest.
+	// 3D volumes only: flat (depth = 1) noise ignores the layout.
+	// =========================================================================
+	enum class NoiseChannelLayout
+	{
+		Single = 0,
+		CloudShape = 1,
+	};
+
+	// =========================================================================
+	// NoiseTextureDesc
+	// =========================================================================
+	struct NoiseTextureDesc
+	{
+		uint32_t  width = 128;
+		uint32_t  height = 128;
+		uint32_t  depth = 128;            // Must be >= 1. Use 1 for "flat" 3D (samples as 2D at z=0.5)
+
+		NoiseType noiseType = NoiseType::Perlin;
+
+		uint32_t  octaves = 4;              // Number of FBM octaves
+		float     frequency = 4.0f;           // Base frequency (tiles across the texture this many times)
+		float     persistence = 0.5f;           // Amplitude multiplier per octave (< 1 = each octave quieter)
+		float     lacunarity = 2.0f;           // Frequency multiplier per octave (> 1 = finer detail per octave)
+		uint32_t  seed = 42;             // Random seed — different seeds shift the noise field
+
+		// Full mip chain. RGBA32F: 2D only (depth = 1), from one MipGenerator
+		// dispatch. Packed formats: any depth, box filtered on the CPU.
+		bool      generateMips = false;
+
+		NoiseTextureFormat format = NoiseTextureFormat::RGBA32F;
+		NoiseChannelLayout channels = NoiseChannelLayout::Single;
+
+		std::string debugName = "NoiseTexture";
+	};
+}
@@ -3,19 +3,47 @@
 //------------------------------------------------------------------------------
 
 #include "Engine/Renderer/NoiseTextureGenerator.hpp"
+#include "Engine/Renderer/NoiseVolumeCache.hpp"
+#include "Engine/Renderer/NoiseVolumePacking.hpp"
 
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanUploadManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/MipGenerator.hpp"
 #include "Engine/Renderer/RenderDevice.hpp"       // TextureDesc, TextureFormat, TextureUsage
 #include "Engine/Renderer/AssetManager.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include <algorithm>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		// The texels depend on the desc alone; which family owns the image
+		// doesn't, so it splits the in-memory key but not the disk one
+		uint64_t GetCacheKey(uint64_t descHash, NoiseConsumer consumer)
+		{
+			return consumer == NoiseConsumer::Compute ? ~descHash : descHash;
+		}
+
+		bool BeginOneShot(VkCommandBuffer cmd)
+		{
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			return cmd != VK_NULL_HANDLE && vkBeginCommandBuffer(cmd, &beginInfo) == VK_SUCCESS;
+		}
+	}
+
 	NoiseTextureGenerator::NoiseTextureGenerator() = default;
 	NoiseTextureGenerator::~NoiseTextureGenerator() { Cleanup(); }
 
@@ -36,17 +64,33 @@ namespace Nightbloom
 		m_CommandPool = commandPool;
 		m_DescriptorManager = descriptorManager;
 
-		if (!CreateNoisePipeline())
+		// The two kernels build independently: the flat one on a job worker
+		bool built2D = false;
+		JobCounter done;
+		JobSystem::Get().Run([&]() { built2D = CreateNoisePipeline2D(); }, &done);
+		const bool built3D = CreateNoisePipeline();
+		JobSystem::Get().Wait(done);
+
+		if (!built3D || !built2D)
 		{
 			LOG_ERROR("NoiseTextureGenerator: failed to create compute pipeline");
 			return false;
 		}
-		if (!CreateNoisePipeline2D())
+
+		m_MipGenerator = std::make_unique<MipGenerator>();
+		if (!m_MipGenerator->Initialize(device, memoryManager, descriptorManager))
 		{
-			LOG_ERROR("NoiseTextureGenerator: failed to create compute pipeline");
-			return false;
+			LOG_WARN("NoiseTextureGenerator: no mip generator, noise textures stay single-level");
+			m_MipGenerator.reset();
 		}
 
+		// BC4 needs the feature and, for volumes, 3D support of the format
+		VkImageFormatProperties bc4Properties{};
+		m_Bc4VolumesSupported = device->SupportsFeature("texture_compression_bc") &&
+			vkGetPhysicalDeviceImageFormatProperties(device->GetPhysicalDevice(), VK_FORMAT_BC4_UNORM_BLOCK,
+				VK_IMAGE_TYPE_3D, VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, 0, &bc4Properties) == VK_SUCCESS;
+
 		m_Initialized = true;
 		LOG_INFO("NoiseTextureGenerator initialized");
 		return true;
@@ -62,6 +106,20 @@ namespace Nightbloom
 
 		VkDevice device = m_Device->GetDevice();
 
+		for (auto& [handle, job] : m_Jobs)
+		{
+			job.cached = nullptr;   // the whole cache goes below
+			DestroyJob(job);
+		}
+		m_Jobs.clear();
+
+		for (const auto& [key, entry] : m_Cache)
+		{
+			if (entry.references > 0)
+				LOG_WARN("NoiseTextureGenerator: cached noise texture still referenced at cleanup");
+		}
+		m_Cache.clear();
+
 		if (m_Pipeline != VK_NULL_HANDLE)
 		{
 			vkDestroyPipeline(device, m_Pipeline, nullptr);
@@ -82,6 +140,7 @@ namespace Nightbloom
 			vkDestroyPipelineLayout(device, m_PipelineLayout2D, nullptr);
 			m_PipelineLayout2D = VK_NULL_HANDLE;
 		}
+		m_MipGenerator.reset();
 
 		m_Initialized = false;
 		LOG_INFO("NoiseTextureGenerator cleaned up");
@@ -91,19 +150,155 @@ namespace Nightbloom
 	// Generate
 	// =========================================================================
 
-	VulkanTexture* NoiseTextureGenerator::Generate(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher)
+	VulkanTexture* NoiseTextureGenerator::Generate(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+		NoiseConsumer consumer)
+	{
+		return GenerateTexture(desc, dispatcher, consumer, nullptr);
+	}
+
+	std::vector<VulkanTexture*> NoiseTextureGenerator::GenerateMany(const std::vector<NoiseTextureDesc>& descs,
+		ComputeDispatcher* dispatcher, NoiseConsumer consumer)
+	{
+		std::vector<BatchVolume> volumes(descs.size());
+		for (size_t i = 0; i < descs.size(); ++i)
+			volumes[i].desc = descs[i];
+		GenerateBatch(volumes, dispatcher, consumer);
+
+		std::vector<VulkanTexture*> textures;
+		textures.reserve(volumes.size());
+		for (const BatchVolume& volume : volumes)
+			textures.push_back(volume.texture);
+		return textures;
+	}
+
+	VulkanTexture* NoiseTextureGenerator::GenerateTexture(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+		NoiseConsumer consumer, std::vector<float>* readback)
+	{
+		std::vector<BatchVolume> volumes(1);
+		volumes[0].desc = desc;
+		volumes[0].readback = readback;
+		GenerateBatch(volumes, dispatcher, consumer);
+		return volumes[0].texture;
+	}
+
+	void NoiseTextureGenerator::GenerateBatch(std::vector<BatchVolume>& volumes, ComputeDispatcher* dispatcher,
+		NoiseConsumer consumer)
 	{
 		if (!m_Initialized)
 		{
 			LOG_ERROR("NoiseTextureGenerator::Generate called before Initialize()");
-			return nullptr;
+			return;
+		}
+
+		bool anyPrepared = false;
+		for (BatchVolume& volume : volumes)
+			anyPrepared |= PrepareVolume(volume);
+		if (!anyPrepared)
+			return;
+
+		// ------------------------------------------------------------------
+		// Record every volume into one single-time command, on the async
+		// compute queue when there is one: one submit and one wait for the
+		// batch. The volumes are independent, so their dispatches overlap
+		// up to each one's own barriers.
+		// ------------------------------------------------------------------
+		{
+			VulkanSingleTimeCommand cmd(m_Device, m_ComputeCommandPool ? m_ComputeCommandPool : m_CommandPool);
+			VkCommandBuffer commandBuffer = cmd.Begin();
+			for (BatchVolume& volume : volumes)
+			{
+				if (volume.texture)
+				{
+					RecordGeneration(commandBuffer, dispatcher, volume.texture, volume.storageSet, volume.desc,
+						volume.mipLevels, consumer, volume.readbackBuffer.get());
+				}
+			}
+			cmd.End(); // Submits and waits for the GPU to finish
+		}
+
+		bool anyHandOff = false;
+		for (BatchVolume& volume : volumes)
+		{
+			if (!volume.texture)
+				continue;
+
+			if (volume.readbackBuffer && volume.readback)
+			{
+				// The noise shaders write (v, v, v, 1): keep R only
+				const float* texels = static_cast<const float*>(volume.readbackBuffer->GetPersistentMappedPtr());
+				const size_t count = size_t(volume.desc.width) * volume.desc.height * volume.desc.depth;
+				volume.readback->resize(count);
+				for (size_t i = 0; i < count; ++i)
+					(*volume.readback)[i] = texels[i * 4];
+			}
+
+			// The generated image was only the packing's source. End waited,
+			// so nothing still uses it.
+			if (volume.desc.format != NoiseTextureFormat::RGBA32F)
+			{
+				VulkanTexture* packedTexture = CreatePackedTexture(volume.desc,
+					static_cast<const float*>(volume.readbackBuffer->GetPersistentMappedPtr()), dispatcher, consumer);
+				delete volume.texture;
+				volume.texture = packedTexture;
+				volume.packed = true;
+				continue;
+			}
+			anyHandOff = true;
+		}
+
+		// The releases have completed (End waited), so the acquires need no
+		// semaphore; one graphics submission takes the whole batch
+		if (anyHandOff && IsHandOff(consumer))
+		{
+			VulkanSingleTimeCommand cmd(m_Device, m_CommandPool);
+			VkCommandBuffer commandBuffer = cmd.Begin();
+			for (BatchVolume& volume : volumes)
+			{
+				if (volume.texture && !volume.packed)
+					RecordHandOffAcquire(commandBuffer, dispatcher, volume.texture);
+			}
+			cmd.End();
+		}
+
+		for (BatchVolume& volume : volumes)
+		{
+			if (!volume.texture || volume.packed)
+				continue;
+
+			// The compute barriers bypassed VulkanTexture::TransitionLayout,
+			// so update the tracked layout manually to avoid stale state
+			volume.texture->SetCurrentLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+			// COMBINED_IMAGE_SAMPLER set so the texture can be bound for
+			// sampling in the main pass
+			if (!volume.texture->CreateDescriptorSet(m_DescriptorManager))
+			{
+				LOG_WARN("NoiseTextureGenerator: CreateDescriptorSet failed for '{}'",
+					volume.desc.debugName);
+				// Not fatal — callers can still bind the texture manually
+			}
+
+			LOG_INFO("Noise texture '{}' generated successfully ({}x{}x{}, {} mips)",
+				volume.desc.debugName, volume.desc.width, volume.desc.height, volume.desc.depth, volume.mipLevels);
 		}
 
+		if (volumes.size() > 1)
+			LOG_INFO("Generated {} noise textures in one submission", volumes.size());
+	}
+
+	// The output texture, its readback buffer and its storage set; false
+	// (and no texture) if any of them can't be made
+	bool NoiseTextureGenerator::PrepareVolume(BatchVolume& volume)
+	{
+		volume.desc = ResolveFormat(volume.desc);
+		const NoiseTextureDesc& desc = volume.desc;
+		const bool packed = desc.format != NoiseTextureFormat::RGBA32F;
+
 		if (desc.width == 0 || desc.height == 0 || desc.depth == 0)
 		{
 			LOG_ERROR("NoiseTextureGenerator: invalid dimensions {}x{}x{}",
 				desc.width, desc.height, desc.depth);
-			return nullptr;
+			return false;
 		}
 
 		LOG_INFO("Generating {} noise texture: {}x{}x{}, octaves={}, freq={:.2f}",
@@ -115,119 +310,842 @@ namespace Nightbloom
 		//    The generator always produces 3D textures.
 		//    depth = 1 results in a "flat" 3D texture (sample at z = 0.5).
 		// ------------------------------------------------------------------
-		auto* texture = new VulkanTexture(m_Device, m_MemoryManager);
+		bool is2D = (desc.depth == 1);
+
+		// The whole chain below mip 0 comes from one MipGenerator dispatch
+		// (packed formats build theirs on the CPU)
+		volume.mipLevels = 1;
+		if (desc.generateMips && is2D && !packed && m_MipGenerator &&
+			desc.width <= MipGenerator::MAX_SIZE && desc.height <= MipGenerator::MAX_SIZE)
+		{
+			for (uint32_t size = std::max(desc.width, desc.height); size > 1; size >>= 1)
+				++volume.mipLevels;
+		}
+
+		std::unique_ptr<VulkanTexture> texture(CreateTexture(desc.width, desc.height, desc.depth, volume.mipLevels));
+		if (!texture)
+			return false;
+
+		// Host-visible copy target for the disk cache and the packing (RGBA32F, mip 0)
+		const VkDeviceSize readbackSize = VkDeviceSize(desc.width) * desc.height * desc.depth * 4 * sizeof(float);
+		if (volume.readback || packed)
+		{
+			BufferDesc bufferDesc;
+			bufferDesc.usage = BufferUsage::Storage;   // includes TRANSFER_DST
+			bufferDesc.memoryAccess = MemoryAccess::GpuToCpu;
+			bufferDesc.size = static_cast<size_t>(readbackSize);
+			bufferDesc.persistentMap = true;
+			bufferDesc.debugName = desc.debugName + "Readback";
+
+			volume.readbackBuffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
+			if (!volume.readbackBuffer->Initialize(bufferDesc) || !volume.readbackBuffer->GetPersistentMappedPtr())
+			{
+				volume.readbackBuffer.reset();
+				if (packed)
+				{
+					LOG_ERROR("NoiseTextureGenerator: no readback buffer to pack '{}' from", desc.debugName);
+					return false;
+				}
+				LOG_WARN("NoiseTextureGenerator: no readback buffer for '{}', it won't be cached on disk",
+					desc.debugName);
+			}
+		}
+
+		// ------------------------------------------------------------------
+		// 2. Allocate a storage image descriptor set for the compute write.
+		//    This is a temporary descriptor used only during generation, so
+		//    it comes from the transient pools and goes back with the frame.
+		//    We update it with the image view in GENERAL layout (storage write).
+		// ------------------------------------------------------------------
+		volume.storageSet = m_DescriptorManager->AllocateTransientSet(
+			m_DescriptorManager->GetComputeImageSetLayout());
+		if (volume.storageSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("NoiseTextureGenerator: failed to allocate storage image descriptor set");
+			return false;
+		}
+
+		m_DescriptorManager->UpdateComputeImageSet(volume.storageSet, texture->GetStorageImageView());
+		volume.texture = texture.release();
+		return true;
+	}
+
+	NoiseTextureDesc NoiseTextureGenerator::ResolveFormat(const NoiseTextureDesc& desc) const
+	{
+		NoiseTextureDesc resolved = desc;
+		if (resolved.format == NoiseTextureFormat::BC4 && !m_Bc4VolumesSupported)
+		{
+			LOG_WARN("NoiseTextureGenerator: BC4 volumes unsupported, '{}' is stored as R8", desc.debugName);
+			resolved.format = NoiseTextureFormat::R8;
+		}
+		return resolved;
+	}
+
+	VulkanTexture* NoiseTextureGenerator::CreatePackedTexture(const NoiseTextureDesc& desc, const float* rgba,
+		ComputeDispatcher* dispatcher, NoiseConsumer consumer)
+	{
+		const PackedNoiseVolume volume = PackNoiseVolume(desc, rgba);
+		if (volume.data.empty())
+			return nullptr;
 
 		TextureDesc texDesc{};
 		texDesc.width = desc.width;
 		texDesc.height = desc.height;
 		texDesc.depth = desc.depth;
-		texDesc.mipLevels = 1;
+		texDesc.mipLevels = static_cast<uint32_t>(volume.levelOffsets.size());
 		texDesc.arrayLayers = 1;
-		texDesc.format = TextureFormat::RGBA32F;
-		texDesc.usage = TextureUsage::Storage | TextureUsage::Sampled;
+		switch (desc.format)
+		{
+		case NoiseTextureFormat::R8:  texDesc.format = TextureFormat::R8; break;
+		case NoiseTextureFormat::RG8: texDesc.format = TextureFormat::RG8; break;
+		case NoiseTextureFormat::BC4: texDesc.format = TextureFormat::BC4_R; break;
+		default:                      texDesc.format = TextureFormat::RGBA8; break;
+		}
+		texDesc.usage = TextureUsage::Sampled;
 		texDesc.generateMips = false;
+		texDesc.force3D = (desc.depth != 1);
 
-		bool is2D = (desc.depth == 1);
-
-		texDesc.force3D = !is2D;  // Only force 3D for actual 3D textures
-
+		auto* texture = new VulkanTexture(m_Device, m_MemoryManager);
 		if (!texture->Initialize(texDesc))
 		{
-			LOG_ERROR("NoiseTextureGenerator: failed to initialize texture");
+			LOG_ERROR("NoiseTextureGenerator: failed to create the {} texture for '{}'",
+				GetNoiseFormatName(desc.format), desc.debugName);
 			delete texture;
 			return nullptr;
 		}
 
-		// ------------------------------------------------------------------
-		// 2. Allocate a storage image descriptor set for the compute write.
-		//    This is a temporary descriptor used only during generation.
-		//    We update it with the image view in GENERAL layout (storage write).
-		// ------------------------------------------------------------------
-		VkDescriptorSet storageSet = m_DescriptorManager->AllocateComputeImageSet();
-		if (storageSet == VK_NULL_HANDLE)
+		// Ends in SHADER_READ_ONLY on the graphics family
+		if (!texture->UploadMipLevels(volume.data.data(), volume.data.size(), volume.levelOffsets, m_CommandPool))
 		{
-			LOG_ERROR("NoiseTextureGenerator: failed to allocate storage image descriptor set");
+			LOG_ERROR("NoiseTextureGenerator: upload of packed noise '{}' failed", desc.debugName);
 			delete texture;
 			return nullptr;
 		}
 
-		m_DescriptorManager->UpdateComputeImageSet(storageSet, texture->GetStorageImageView());
+		FinishUploadedTexture(texture, desc, dispatcher, consumer);
 
-		// ------------------------------------------------------------------
-		// 3. Build push constants
-		// ------------------------------------------------------------------
-		NoisePushConstants pc{};
-		pc.width = desc.width;
-		pc.height = desc.height;
-		pc.depth = desc.depth;
-		pc.seed = desc.seed;
-		pc.octaves = desc.octaves;
-		pc.frequency = desc.frequency;
-		pc.persistence = desc.persistence;
-		pc.lacunarity = desc.lacunarity;
-		pc.noiseType = static_cast<uint32_t>(desc.noiseType);
+		LOG_INFO("Noise texture '{}' packed as {} ({} mips, {:.2f} MB, {:.2f} MB as RGBA32F)",
+			desc.debugName, GetNoiseFormatName(desc.format), texDesc.mipLevels,
+			static_cast<float>(volume.data.size()) / (1024.0f * 1024.0f),
+			static_cast<float>(GetNoiseLevelBytes(NoiseTextureFormat::RGBA32F, desc.width, desc.height, desc.depth)) / (1024.0f * 1024.0f));
+		return texture;
+	}
 
-		// ------------------------------------------------------------------
-		// 4. Record and submit the compute pass via a single-time command
-		// ------------------------------------------------------------------
+	void NoiseTextureGenerator::FinishUploadedTexture(VulkanTexture* texture, const NoiseTextureDesc& desc,
+		ComputeDispatcher* dispatcher, NoiseConsumer consumer)
+	{
+		// Async compute consumers need the image on their own family
+		const uint32_t graphicsFamily = m_CommandPool->GetQueueFamilyIndex();
+		const uint32_t computeFamily = m_ComputeCommandPool ? m_ComputeCommandPool->GetQueueFamilyIndex() : graphicsFamily;
+		if (consumer == NoiseConsumer::Compute && computeFamily != graphicsFamily && dispatcher)
 		{
-			VulkanSingleTimeCommand cmd(m_Device, m_CommandPool);
-			VkCommandBuffer commandBuffer = cmd.Begin();
+			if (VulkanUploadManager* uploads = m_MemoryManager->GetUploadManager())
+			{
+				uploads->Flush();
+				uploads->WaitAll();
+			}
+
+			{
+				VulkanSingleTimeCommand cmd(m_Device, m_CommandPool);
+				dispatcher->ReleaseImageOwnership(cmd.Begin(), texture->GetImage(),
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					graphicsFamily, computeFamily,
+					VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0);
+				cmd.End();
+			}
+			{
+				VulkanSingleTimeCommand cmd(m_Device, m_ComputeCommandPool);
+				dispatcher->AcquireImageOwnership(cmd.Begin(), texture->GetImage(),
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					graphicsFamily, computeFamily,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+				cmd.End();
+			}
+		}
+
+		texture->SetCurrentLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		if (!texture->CreateDescriptorSet(m_DescriptorManager))
+		{
+			LOG_WARN("NoiseTextureGenerator: CreateDescriptorSet failed for '{}'", desc.debugName);
+		}
+	}
 
-			// UNDEFINED → GENERAL (layout required for storage image writes)
-			dispatcher->TransitionImageForComputeWrite(commandBuffer, texture->GetImage(), VK_IMAGE_LAYOUT_UNDEFINED);
+	bool NoiseTextureGenerator::IsHandOff(NoiseConsumer consumer) const
+	{
+		return m_ComputeCommandPool && consumer == NoiseConsumer::Graphics &&
+			m_ComputeCommandPool->GetQueueFamilyIndex() != m_CommandPool->GetQueueFamilyIndex();
+	}
 
-			VkPipeline activePipeline = is2D ? m_Pipeline2D : m_Pipeline;
-			VkPipelineLayout activeLayout = is2D ? m_PipelineLayout2D : m_PipelineLayout;
+	// Everything from the layout change to the final barrier, for the queue
+	// that owns `cmd` (compute when a compute pool is set)
+	void NoiseTextureGenerator::RecordGeneration(VkCommandBuffer commandBuffer, ComputeDispatcher* dispatcher,
+		VulkanTexture* texture, VkDescriptorSet storageSet, const NoiseTextureDesc& desc, uint32_t mipLevels,
+		NoiseConsumer consumer, VulkanBuffer* readbackBuffer)
+	{
+		const bool is2D = (desc.depth == 1);
+		const NoisePushConstants pc = BuildPushConstants(desc);
 
-			// Bind our noise compute pipeline
-			dispatcher->BindPipeline(commandBuffer, activePipeline);
+		// UNDEFINED → GENERAL (layout required for storage image writes)
+		dispatcher->TransitionImageForComputeWrite(commandBuffer, texture->GetImage(), VK_IMAGE_LAYOUT_UNDEFINED);
 
-			// Bind the storage image at set 0
-			dispatcher->BindDescriptorSet(commandBuffer, activeLayout, 0, storageSet);
+		VkPipeline activePipeline = is2D ? m_Pipeline2D : m_Pipeline;
+		VkPipelineLayout activeLayout = is2D ? m_PipelineLayout2D : m_PipelineLayout;
 
-			// Push generation parameters
-			dispatcher->PushConstants(commandBuffer, activeLayout, &pc, sizeof(NoisePushConstants));
+		// Bind our noise compute pipeline
+		dispatcher->BindPipeline(commandBuffer, activePipeline);
 
-			// Dispatch: local workgroup size is 8x8x8 (matches noise.comp)
-			uint32_t gx = ComputeDispatcher::CalculateGroupCount(desc.width, 8);
-			uint32_t gy = ComputeDispatcher::CalculateGroupCount(desc.height, 8);
-			uint32_t gz = is2D ? 1 : ComputeDispatcher::CalculateGroupCount(desc.depth, 8);
-			dispatcher->Dispatch(commandBuffer, gx, gy, gz);
+		// Bind the storage image at set 0
+		dispatcher->BindDescriptorSet(commandBuffer, activeLayout, 0, storageSet);
+
+		// Push generation parameters
+		dispatcher->PushConstants(commandBuffer, activeLayout, &pc, sizeof(NoisePushConstants));
+
+		// Dispatch: 8x8x4 groups for noise.comp, 16x16 for noise2D.comp
+		const uint32_t groupXY = is2D ? GROUP_SIZE_2D : GROUP_SIZE_3D_XY;
+		uint32_t gx = ComputeDispatcher::CalculateGroupCount(desc.width, groupXY);
+		uint32_t gy = ComputeDispatcher::CalculateGroupCount(desc.height, groupXY);
+		uint32_t gz = is2D ? 1 : ComputeDispatcher::CalculateGroupCount(desc.depth, GROUP_SIZE_3D_Z);
+		dispatcher->Dispatch(commandBuffer, gx, gy, gz);
+
+		if (mipLevels > 1)
+		{
+			dispatcher->ComputeToComputeImageBarrier(commandBuffer, texture->GetImage());
+			m_MipGenerator->Record(commandBuffer, dispatcher, texture);
+		}
 
-			// GENERAL → SHADER_READ_ONLY_OPTIMAL so the texture is ready to sample
+		// Copy mip 0 out while the image is still in GENERAL. Raw barriers
+		// with transfer/compute stages only, so this is valid on either queue.
+		if (readbackBuffer)
+		{
+			VkImageMemoryBarrier toCopy{};
+			toCopy.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			toCopy.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			toCopy.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			toCopy.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+			toCopy.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			toCopy.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			toCopy.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			toCopy.image = texture->GetImage();
+			toCopy.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &toCopy);
+
+			VkBufferImageCopy region{};
+			region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+			region.imageExtent = { desc.width, desc.height, desc.depth };
+			vkCmdCopyImageToBuffer(commandBuffer, texture->GetImage(), VK_IMAGE_LAYOUT_GENERAL,
+				readbackBuffer->GetBuffer(), 1, &region);
+
+			VkBufferMemoryBarrier hostBarrier{};
+			hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+			hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			hostBarrier.buffer = readbackBuffer->GetBuffer();
+			hostBarrier.offset = 0;
+			hostBarrier.size = VK_WHOLE_SIZE;
+
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+				0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+
+			// The final barriers below start at the compute stage; chain the copy into it
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 0, nullptr, 0, nullptr, 0, nullptr);
+		}
+
+		// GENERAL → SHADER_READ_ONLY_OPTIMAL so the texture is ready to sample.
+		// A compute queue can't name graphics stages: hand the texture to
+		// the graphics family instead (RecordHandOffAcquire), or keep it here
+		// for compute consumers.
+		if (IsHandOff(consumer))
+		{
+			dispatcher->ReleaseImageOwnership(commandBuffer, texture->GetImage(),
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				m_ComputeCommandPool->GetQueueFamilyIndex(), m_CommandPool->GetQueueFamilyIndex(),
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+		}
+		else if (consumer == NoiseConsumer::Compute)
+		{
+			dispatcher->ComputeWriteToComputeSampleBarrier(commandBuffer, texture->GetImage());
+		}
+		else
+		{
 			dispatcher->ComputeWriteToFragmentSampleBarrier(
 				commandBuffer,
 				texture->GetImage());
+		}
+	}
 
-			cmd.End(); // Submits and waits for the GPU to finish
+	// Graphics-side half of a compute → graphics hand-off, once the release has run
+	void NoiseTextureGenerator::RecordHandOffAcquire(VkCommandBuffer commandBuffer, ComputeDispatcher* dispatcher,
+		VulkanTexture* texture)
+	{
+		// Vertex too: displacement maps (the terrain heightmap) are read there
+		dispatcher->AcquireImageOwnership(commandBuffer, texture->GetImage(),
+			VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			m_ComputeCommandPool->GetQueueFamilyIndex(), m_CommandPool->GetQueueFamilyIndex(),
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			VK_ACCESS_SHADER_READ_BIT);
+	}
+
+	// =========================================================================
+	// Cached generation
+	// =========================================================================
+
+	VulkanTexture* NoiseTextureGenerator::Acquire(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+		NoiseConsumer consumer)
+	{
+		return AcquireMany({ desc }, dispatcher, consumer)[0];
+	}
+
+	std::vector<VulkanTexture*> NoiseTextureGenerator::AcquireMany(const std::vector<NoiseTextureDesc>& descs,
+		ComputeDispatcher* dispatcher, NoiseConsumer consumer)
+	{
+		std::vector<VulkanTexture*> textures(descs.size(), nullptr);
+		if (!m_Initialized)
+		{
+			LOG_ERROR("NoiseTextureGenerator::Acquire called before Initialize()");
+			return textures;
 		}
 
-		// ------------------------------------------------------------------
-	   // 5. Update the texture's tracked layout.
-	   //    The compute barriers above bypassed VulkanTexture::TransitionLayout,
-	   //    so we update the tracked layout manually to avoid stale state.
-	   // ------------------------------------------------------------------
-		texture->SetCurrentLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		// Cache and disk hits first; the misses are generated as one batch
+		std::vector<BatchVolume> volumes;
+		std::vector<size_t> volumeSlots;
+		std::vector<std::vector<float>> values;
+		values.reserve(descs.size());   // volumes point into it
+		for (size_t i = 0; i < descs.size(); ++i)
+		{
+			const NoiseTextureDesc& desc = descs[i];
+			const uint64_t key = HashNoiseTextureDesc(desc);
+			const uint64_t cacheKey = GetCacheKey(key, consumer);
+
+			auto it = m_Cache.find(cacheKey);
+			if (it != m_Cache.end())
+			{
+				++it->second.references;
+				it->second.lastUse = ++m_CacheClock;
+				LOG_INFO("Noise texture '{}' reused from cache", desc.debugName);
+				textures[i] = it->second.texture.get();
+				continue;
+			}
+
+			// Asked for twice in this batch: the first one generates it
+			auto earlier = std::find_if(volumeSlots.begin(), volumeSlots.end(),
+				[&](size_t slot) { return GetCacheKey(HashNoiseTextureDesc(descs[slot]), consumer) == cacheKey; });
+			if (earlier != volumeSlots.end())
+				continue;
+
+			VulkanTexture* texture = IsDiskCacheable(desc) ? LoadFromDisk(desc, key, dispatcher, consumer) : nullptr;
+			if (texture)
+			{
+				AddToCache(cacheKey, texture);
+				textures[i] = texture;
+				continue;
+			}
+
+			BatchVolume& volume = volumes.emplace_back();
+			volume.desc = desc;
+			if (IsDiskCacheable(desc))
+				volume.readback = &values.emplace_back();
+			volumeSlots.push_back(i);
+		}
 
-		// ------------------------------------------------------------------
-		// 6. Create the COMBINED_IMAGE_SAMPLER descriptor set so the texture
-		//    can be bound for sampling in the main pass.
-		// ------------------------------------------------------------------
+		if (!volumes.empty())
+			GenerateBatch(volumes, dispatcher, consumer);
+
+		for (size_t v = 0; v < volumes.size(); ++v)
+		{
+			const NoiseTextureDesc& desc = descs[volumeSlots[v]];
+			VulkanTexture* texture = volumes[v].texture;
+			if (!texture)
+				continue;
+
+			const uint64_t key = HashNoiseTextureDesc(desc);
+			if (volumes[v].readback && !volumes[v].readback->empty())
+			{
+				const std::string path = GetNoiseVolumePath(m_DiskCacheDirectory, key);
+				if (WriteNoiseVolume(path, key, desc.width, desc.height, desc.depth, *volumes[v].readback))
+					LOG_INFO("Noise volume '{}' stored in {}", desc.debugName, path);
+				else
+					LOG_WARN("NoiseTextureGenerator: could not store noise volume '{}' in {}", desc.debugName, path);
+			}
+			AddToCache(GetCacheKey(key, consumer), texture);
+			textures[volumeSlots[v]] = texture;
+		}
+
+		// Repeats within the batch share what the first one made
+		for (size_t i = 0; i < descs.size(); ++i)
+		{
+			if (textures[i])
+				continue;
+			auto it = m_Cache.find(GetCacheKey(HashNoiseTextureDesc(descs[i]), consumer));
+			if (it != m_Cache.end() && std::find(volumeSlots.begin(), volumeSlots.end(), i) == volumeSlots.end())
+			{
+				++it->second.references;
+				textures[i] = it->second.texture.get();
+			}
+		}
+
+		TrimCache();
+		return textures;
+	}
+
+	bool NoiseTextureGenerator::IsDiskCacheable(const NoiseTextureDesc& desc) const
+	{
+		return !m_DiskCacheDirectory.empty() && desc.channels == NoiseChannelLayout::Single &&
+			!(desc.generateMips && desc.depth == 1 && desc.format == NoiseTextureFormat::RGBA32F);
+	}
+
+	void NoiseTextureGenerator::AddToCache(uint64_t cacheKey, VulkanTexture* texture)
+	{
+		CachedNoise& entry = m_Cache[cacheKey];
+		entry.texture.reset(texture);
+		entry.references = 1;
+		entry.lastUse = ++m_CacheClock;
+	}
+
+	void NoiseTextureGenerator::Release(VulkanTexture* texture)
+	{
+		if (!texture)
+			return;
+
+		for (auto& [key, entry] : m_Cache)
+		{
+			if (entry.texture.get() != texture)
+				continue;
+
+			if (entry.references > 0)
+				--entry.references;
+			TrimCache();
+			return;
+		}
+
+		LOG_WARN("NoiseTextureGenerator::Release: texture was not acquired from this generator");
+	}
+
+	VulkanTexture* NoiseTextureGenerator::LoadFromDisk(const NoiseTextureDesc& desc, uint64_t key,
+		ComputeDispatcher* dispatcher, NoiseConsumer consumer)
+	{
+		const std::string path = GetNoiseVolumePath(m_DiskCacheDirectory, key);
+
+		std::vector<float> values;
+		if (!ReadNoiseVolume(path, key, desc.width, desc.height, desc.depth, values))
+			return nullptr;
+
+		// Rebuild what the shaders write: (v, v, v, 1)
+		std::vector<float> texels(values.size() * 4);
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			texels[i * 4 + 0] = values[i];
+			texels[i * 4 + 1] = values[i];
+			texels[i * 4 + 2] = values[i];
+			texels[i * 4 + 3] = 1.0f;
+		}
+
+		const NoiseTextureDesc resolved = ResolveFormat(desc);
+		if (resolved.format != NoiseTextureFormat::RGBA32F)
+		{
+			VulkanTexture* packedTexture = CreatePackedTexture(resolved, texels.data(), dispatcher, consumer);
+			if (packedTexture)
+				LOG_INFO("Noise texture '{}' loaded from {}", desc.debugName, path);
+			return packedTexture;
+		}
+
+		VulkanTexture* texture = CreateTexture(desc.width, desc.height, desc.depth);
+		if (!texture)
+			return nullptr;
+
+		// Ends in SHADER_READ_ONLY on the graphics family
+		if (!texture->UploadData(texels.data(), texels.size() * sizeof(float), m_CommandPool))
+		{
+			LOG_WARN("NoiseTextureGenerator: upload of cached volume '{}' failed, regenerating", desc.debugName);
+			delete texture;
+			return nullptr;
+		}
+
+		FinishUploadedTexture(texture, desc, dispatcher, consumer);
+
+		LOG_INFO("Noise texture '{}' loaded from {}", desc.debugName, path);
+		return texture;
+	}
+
+	// Drop the least recently used unreferenced textures past the limit
+	void NoiseTextureGenerator::TrimCache()
+	{
+		for (;;)
+		{
+			size_t unused = 0;
+			auto oldest = m_Cache.end();
+			for (auto it = m_Cache.begin(); it != m_Cache.end(); ++it)
+			{
+				if (it->second.references > 0)
+					continue;
+				++unused;
+				if (oldest == m_Cache.end() || it->second.lastUse < oldest->second.lastUse)
+					oldest = it;
+			}
+
+			if (unused <= MAX_UNUSED_CACHED)
+				return;
+
+			// Released textures can still be bound by frames in flight
+			VulkanTexture* evicted = oldest->second.texture.release();
+			m_Cache.erase(oldest);
+			if (VulkanDeletionQueue* deletionQueue = m_Device->GetDeletionQueue())
+				deletionQueue->Defer([evicted]() { delete evicted; });
+			else
+				delete evicted;
+		}
+	}
+
+	// =========================================================================
+	// Async generation
+	// =========================================================================
+
+	NoiseJob NoiseTextureGenerator::AcquireAsync(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+		NoiseConsumer consumer)
+	{
+		if (!m_Initialized || !dispatcher)
+		{
+			LOG_ERROR("NoiseTextureGenerator::AcquireAsync called before Initialize() or without a dispatcher");
+			return 0;
+		}
+
+		if (desc.width == 0 || desc.height == 0 || desc.depth == 0)
+		{
+			LOG_ERROR("NoiseTextureGenerator: invalid dimensions {}x{}x{}",
+				desc.width, desc.height, desc.depth);
+			return 0;
+		}
+
+		PendingJob job;
+		job.desc = desc;
+		job.consumer = consumer;
+		job.dispatcher = dispatcher;
+		job.cacheKey = GetCacheKey(HashNoiseTextureDesc(desc), consumer);
+
+		if (m_Cache.count(job.cacheKey) != 0 || (desc.generateMips && desc.depth == 1) ||
+			desc.format != NoiseTextureFormat::RGBA32F)
+		{
+			job.cached = Acquire(desc, dispatcher, consumer);
+			if (!job.cached)
+				return 0;
+		}
+		else if (!SubmitJob(job))
+		{
+			LOG_ERROR("NoiseTextureGenerator: failed to submit background generation of '{}'", desc.debugName);
+			DestroyJob(job);
+			return 0;
+		}
+
+		const NoiseJob handle = m_NextJob++;
+		m_Jobs.emplace(handle, std::move(job));
+		return handle;
+	}
+
+	bool NoiseTextureGenerator::SubmitJob(PendingJob& job)
+	{
+		const NoiseTextureDesc& desc = job.desc;
+		LOG_INFO("Generating {} noise texture in the background: {}x{}x{}, octaves={}",
+			desc.debugName, desc.width, desc.height, desc.depth, desc.octaves);
+
+		job.texture.reset(CreateTexture(desc.width, desc.height, desc.depth));
+		if (!job.texture)
+			return false;
+
+		// Generate's transient set would go back to its pool with the frame,
+		// possibly before this dispatch has run
+		job.storageSet = m_DescriptorManager->AllocateComputeImageSet();
+		if (job.storageSet == VK_NULL_HANDLE)
+			return false;
+		m_DescriptorManager->UpdateComputeImageSet(job.storageSet, job.texture->GetStorageImageView());
+
+		job.generatePool = m_ComputeCommandPool ? m_ComputeCommandPool : m_CommandPool;
+		job.generateCmd = job.generatePool->AllocateCommandBuffer();
+		if (!BeginOneShot(job.generateCmd))
+			return false;
+		RecordGeneration(job.generateCmd, job.dispatcher, job.texture.get(), job.storageSet, desc, 1, job.consumer, nullptr);
+		if (vkEndCommandBuffer(job.generateCmd) != VK_SUCCESS)
+			return false;
+
+		VkSubmitInfo submit{};
+		submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit.commandBufferCount = 1;
+		submit.pCommandBuffers = &job.generateCmd;
+
+		if (!m_ComputeCommandPool)
+		{
+			job.graphicsValue = m_Device->GetGraphicsTimeline()->Submit(submit);
+			return job.graphicsValue != 0;
+		}
+
+		// There is no compute timeline; a fence per job is polled instead
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(m_Device->GetDevice(), &fenceInfo, nullptr, &job.computeFence) != VK_SUCCESS)
+		{
+			job.computeFence = VK_NULL_HANDLE;
+			return false;
+		}
+
+		VkQueue queue = m_Device->GetQueueForFamily(m_ComputeCommandPool->GetQueueFamilyIndex());
+		if (vkQueueSubmit(queue, 1, &submit, job.computeFence) != VK_SUCCESS)
+		{
+			// Never submitted, so DestroyJob mustn't wait on it
+			vkDestroyFence(m_Device->GetDevice(), job.computeFence, nullptr);
+			job.computeFence = VK_NULL_HANDLE;
+			return false;
+		}
+		return true;
+	}
+
+	NoiseJobState NoiseTextureGenerator::PollJob(NoiseJob handle, VulkanTexture*& outTexture)
+	{
+		outTexture = nullptr;
+
+		auto it = m_Jobs.find(handle);
+		if (it == m_Jobs.end())
+			return NoiseJobState::Failed;
+		PendingJob& job = it->second;
+
+		if (job.cached)
+		{
+			outTexture = job.cached;
+			m_Jobs.erase(it);
+			return NoiseJobState::Ready;
+		}
+
+		if (job.computeFence != VK_NULL_HANDLE)
+		{
+			const VkResult status = vkGetFenceStatus(m_Device->GetDevice(), job.computeFence);
+			if (status == VK_NOT_READY)
+				return NoiseJobState::Pending;
+
+			vkDestroyFence(m_Device->GetDevice(), job.computeFence, nullptr);
+			job.computeFence = VK_NULL_HANDLE;
+			job.failed = (status != VK_SUCCESS);
+
+			// The release has run, so the acquire needs no semaphore
+			if (!job.failed && IsHandOff(job.consumer))
+			{
+				job.acquireCmd = m_CommandPool->AllocateCommandBuffer();
+				job.failed = !BeginOneShot(job.acquireCmd);
+				if (!job.failed)
+				{
+					RecordHandOffAcquire(job.acquireCmd, job.dispatcher, job.texture.get());
+					vkEndCommandBuffer(job.acquireCmd);
+
+					VkSubmitInfo submit{};
+					submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+					submit.commandBufferCount = 1;
+					submit.pCommandBuffers = &job.acquireCmd;
+					job.graphicsValue = m_Device->GetGraphicsTimeline()->Submit(submit);
+					job.failed = (job.graphicsValue == 0);
+				}
+			}
+		}
+
+		if (job.failed)
+		{
+			LOG_ERROR("NoiseTextureGenerator: background generation of '{}' failed", job.desc.debugName);
+			DestroyJob(job);
+			m_Jobs.erase(it);
+			return NoiseJobState::Failed;
+		}
+
+		if (!m_Device->GetGraphicsTimeline()->IsComplete(job.graphicsValue))
+			return NoiseJobState::Pending;
+
+		VulkanTexture* texture = job.texture.release();
+		texture->SetCurrentLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 		if (!texture->CreateDescriptorSet(m_DescriptorManager))
 		{
-			LOG_WARN("NoiseTextureGenerator: CreateDescriptorSet failed for '{}'",
-				desc.debugName);
-			// Not fatal — callers can still bind the texture manually
+			LOG_WARN("NoiseTextureGenerator: CreateDescriptorSet failed for '{}'", job.desc.debugName);
+		}
+
+		// A blocking Acquire may have made the same texture meanwhile
+		auto cached = m_Cache.find(job.cacheKey);
+		if (cached != m_Cache.end())
+		{
+			delete texture;
+			texture = cached->second.texture.get();
+			++cached->second.references;
+			cached->second.lastUse = ++m_CacheClock;
+		}
+		else
+		{
+			CachedNoise& entry = m_Cache[job.cacheKey];
+			entry.texture.reset(texture);
+			entry.references = 1;
+			entry.lastUse = ++m_CacheClock;
+		}
+
+		LOG_INFO("Noise texture '{}' generated in the background ({}x{}x{})",
+			job.desc.debugName, job.desc.width, job.desc.height, job.desc.depth);
+
+		DestroyJob(job);
+		m_Jobs.erase(it);
+		TrimCache();
+
+		outTexture = texture;
+		return NoiseJobState::Ready;
+	}
+
+	void NoiseTextureGenerator::CancelJob(NoiseJob handle)
+	{
+		auto it = m_Jobs.find(handle);
+		if (it == m_Jobs.end())
+			return;
+
+		DestroyJob(it->second);
+		m_Jobs.erase(it);
+	}
+
+	// Waits for whatever of the job is still on the GPU, then frees it
+	void NoiseTextureGenerator::DestroyJob(PendingJob& job)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		if (job.computeFence != VK_NULL_HANDLE)
+		{
+			vkWaitForFences(device, 1, &job.computeFence, VK_TRUE, UINT64_MAX);
+			vkDestroyFence(device, job.computeFence, nullptr);
+			job.computeFence = VK_NULL_HANDLE;
+		}
+		if (job.graphicsValue != 0)
+		{
+			m_Device->GetGraphicsTimeline()->Wait(job.graphicsValue);
+			job.graphicsValue = 0;
+		}
+
+		if (job.generateCmd != VK_NULL_HANDLE)
+		{
+			job.generatePool->FreeCommandBuffer(job.generateCmd);
+			job.generateCmd = VK_NULL_HANDLE;
+		}
+		if (job.acquireCmd != VK_NULL_HANDLE)
+		{
+			m_CommandPool->FreeCommandBuffer(job.acquireCmd);
+			job.acquireCmd = VK_NULL_HANDLE;
+		}
+		if (job.storageSet != VK_NULL_HANDLE)
+		{
+			m_DescriptorManager->FreeDescriptorSet(job.storageSet);
+			job.storageSet = VK_NULL_HANDLE;
 		}
 
-		// storageSet was only needed for the compute dispatch above — free it now
-		// instead of leaking it until the pool resets on shutdown.
-		m_DescriptorManager->FreeDescriptorSet(storageSet);
+		job.texture.reset();
+		if (job.cached)
+		{
+			Release(job.cached);
+			job.cached = nullptr;
+		}
+	}
 
-		LOG_INFO("Noise texture '{}' generated successfully ({}x{}x{})",
-			desc.debugName, desc.width, desc.height, desc.depth);
+	// =========================================================================
+	// Region generation
+	// =========================================================================
+
+	VulkanTexture* NoiseTextureGenerator::CreateRegionTarget(uint32_t width, uint32_t height, const std::string& debugName,
+		bool sparse)
+	{
+		if (!m_Initialized || width == 0 || height == 0)
+		{
+			LOG_ERROR("NoiseTextureGenerator: cannot create region target '{}' ({}x{})", debugName, width, height);
+			return nullptr;
+		}
 
+		VulkanTexture* texture = CreateTexture(width, height, 1, 1, sparse);
+		if (texture)
+		{
+			LOG_INFO("Noise region target '{}' created ({}x{}{})", debugName, width, height,
+				texture->GetSparsePages() ? ", sparse" : "");
+		}
+		return texture;
+	}
+
+	bool NoiseTextureGenerator::RecordRegion(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VulkanTexture* target,
+		const NoiseTextureDesc& desc, const NoiseRegion& region)
+	{
+		if (!m_Initialized || !dispatcher || !target || region.width == 0 || region.height == 0)
+			return false;
+
+		VkDescriptorSet storageSet = m_DescriptorManager->AllocateTransientSet(
+			m_DescriptorManager->GetComputeImageSetLayout());
+		if (storageSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("NoiseTextureGenerator: failed to allocate storage image descriptor set");
+			return false;
+		}
+		m_DescriptorManager->UpdateComputeImageSet(storageSet, target->GetStorageImageView());
+
+		NoisePushConstants pc = BuildPushConstants(desc);
+		pc.width = region.width;
+		pc.height = region.height;
+		pc.depth = 1;
+		pc.originX = region.originX;
+		pc.originY = region.originY;
+		pc.uvOffsetX = region.uvOffsetX;
+		pc.uvOffsetY = region.uvOffsetY;
+		pc.uvScale = region.uvScale;
+		pc.periodScale = region.periodScale;
+
+		dispatcher->BindPipeline(cmd, m_Pipeline2D);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout2D, 0, storageSet);
+		dispatcher->PushConstants(cmd, m_PipelineLayout2D, &pc, sizeof(NoisePushConstants));
+		dispatcher->Dispatch(cmd,
+			ComputeDispatcher::CalculateGroupCount(region.width, GROUP_SIZE_2D),
+			ComputeDispatcher::CalculateGroupCount(region.height, GROUP_SIZE_2D),
+			1);
+		return true;
+	}
+
+	NoiseTextureGenerator::NoisePushConstants NoiseTextureGenerator::BuildPushConstants(const NoiseTextureDesc& desc)
+	{
+		NoisePushConstants pc{};
+		pc.width = desc.width;
+		pc.height = desc.height;
+		pc.depth = desc.depth;
+		pc.seed = desc.seed;
+		pc.octaves = desc.octaves;
+		pc.frequency = desc.frequency;
+		pc.persistence = desc.persistence;
+		pc.lacunarity = desc.lacunarity;
+		pc.noiseType = static_cast<uint32_t>(desc.noiseType);
+		pc.channelLayout = static_cast<uint32_t>(desc.channels);
+		return pc;
+	}
+
+	// Output texture: Storage | Sampled, RGBA32F. depth = 1 gives a true 2D
+	// image (sampler2D-compatible); anything deeper is forced 3D.
+	VulkanTexture* NoiseTextureGenerator::CreateTexture(uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels,
+		bool sparse)
+	{
+		auto* texture = new VulkanTexture(m_Device, m_MemoryManager);
+
+		TextureDesc texDesc{};
+		texDesc.width = width;
+		texDesc.height = height;
+		texDesc.depth = depth;
+		texDesc.mipLevels = mipLevels;
+		texDesc.arrayLayers = 1;
+		texDesc.format = TextureFormat::RGBA32F;
+		texDesc.usage = TextureUsage::Storage | TextureUsage::Sampled | TextureUsage::Transfer;  // Transfer: CPU readback
+		texDesc.generateMips = false;
+		texDesc.force3D = (depth != 1);  // Only force 3D for actual 3D textures
+		texDesc.sparse = sparse;
+
+		if (!texture->Initialize(texDesc))
+		{
+			LOG_ERROR("NoiseTextureGenerator: failed to initialize texture");
+			delete texture;
+			return nullptr;
+		}
 		return texture;
 	}
 
@@ -242,7 +1160,7 @@ namespace Nightbloom
 		// Load compiled SPIR-V
 		auto& assetManager = AssetManager::Get();
 		auto shaderCode = assetManager.LoadShaderBinary("noise.comp.spv");
-		if (shaderCode.empty())
+		if (!shaderCode.IsOpen())
 		{
 			LOG_ERROR("NoiseTextureGenerator: failed to load noise.comp.spv");
 			return false;
@@ -251,8 +1169,8 @@ namespace Nightbloom
 		// Create shader module
 		VkShaderModuleCreateInfo moduleInfo{};
 		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		moduleInfo.codeSize = shaderCode.size();
-		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
 
 		VkShaderModule shaderModule = VK_NULL_HANDLE;
 		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
@@ -297,7 +1215,7 @@ namespace Nightbloom
 
 		VkResult result = vkCreateComputePipelines(
 			device,
-			VK_NULL_HANDLE,
+			m_Device->GetPipelineCache(),
 			1,
 			&pipelineInfo,
 			nullptr,
@@ -313,6 +1231,7 @@ namespace Nightbloom
 			m_PipelineLayout = VK_NULL_HANDLE;
 			return false;
 		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, "noise.comp.spv");
 
 		LOG_INFO("NoiseTextureGenerator: noise compute pipeline created");
 		return true;
@@ -325,7 +1244,7 @@ namespace Nightbloom
 		// Load compiled SPIR-V
 		auto& assetManager = AssetManager::Get();
 		auto shaderCode = assetManager.LoadShaderBinary("noise2d.comp.spv");
-		if (shaderCode.empty())
+		if (!shaderCode.IsOpen())
 		{
 			LOG_ERROR("NoiseTextureGenerator: failed to load noise.comp.spv");
 			return false;
@@ -334,8 +1253,8 @@ namespace Nightbloom
 		// Create shader module
 		VkShaderModuleCreateInfo moduleInfo{};
 		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		moduleInfo.codeSize = shaderCode.size();
-		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
 
 		VkShaderModule shaderModule = VK_NULL_HANDLE;
 		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
@@ -380,7 +1299,7 @@ namespace Nightbloom
 
 		VkResult result = vkCreateComputePipelines(
 			device,
-			VK_NULL_HANDLE,
+			m_Device->GetPipelineCache(),
 			1,
 			&pipelineInfo,
 			nullptr,
@@ -396,6 +1315,7 @@ namespace Nightbloom
 			m_PipelineLayout2D = VK_NULL_HANDLE;
 			return false;
 		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline2D, "noise2d.comp.spv");
 
 		LOG_INFO("NoiseTextureGenerator: noise compute pipeline created");
 		return true;
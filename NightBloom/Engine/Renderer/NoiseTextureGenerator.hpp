@@ -20,11 +20,37 @@
 //
 //   VulkanTexture* cloudShape = gen.Generate(desc, dispatcher);
 //   // cloudShape is sampler-ready; caller owns and must delete it on shutdown
+//
+// With SetComputeCommandPool the dispatch runs on the async compute queue
+// instead of the graphics queue; see NoiseConsumer for who owns the result.
+//
+// Acquire/Release is the cached form of Generate: the generator keeps the
+// texture, keyed by a hash of the desc, and hands the same one to every
+// caller asking for identical noise. With SetDiskCacheDirectory the volumes
+// are also saved, so the next run loads them instead of dispatching.
+//
+// GenerateMany and AcquireMany take several descs at once and record every
+// volume that needs generating into one command buffer with one submit and
+// one wait, rather than a blocking round trip each (the clouds' shape and
+// detail noise).
+//
+// AcquireAsync is Acquire without the wait: it submits the generation and
+// returns a job to poll once per frame, so editors can keep drawing the old
+// texture until the new one is done and swap at a frame boundary.
+//
+// Formats other than RGBA32F (NoiseTextureDesc::format) are generated as
+// RGBA32F, read back and packed on the CPU (NoiseVolumePacking.hpp) into a
+// sampled-only texture with its full mip chain. BC4 falls back to R8 where
+// the device can't sample BC4 volumes.
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Renderer/NoiseTextureDesc.hpp"
 #include <vulkan/vulkan.h>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace Nightbloom
 {
@@ -34,37 +60,52 @@ namespace Nightbloom
 	class VulkanDescriptorManager;
 	class ComputeDispatcher;
 	class VulkanTexture;
+	class VulkanBuffer;
+	class MipGenerator;
 
 	// =========================================================================
-	// NoiseType
+	// NoiseConsumer
+	// The queue family that samples a generated texture. Only matters when
+	// generation runs on the async compute queue: Graphics textures are then
+	// handed over to the graphics family, Compute ones (read by async
+	// dispatches, e.g. the cloud raymarch) stay on the compute family.
 	// =========================================================================
-	enum class NoiseType
+	enum class NoiseConsumer
 	{
-		Perlin = 0,    // FBM Perlin noise,          output [0, 1]
-		Worley = 1,    // Inverted FBM Worley,        output [0, 1]  (bright = cell centers)
-		PerlinWorley = 2,   // Perlin base eroded by Worley — primary cloud shape channel
+		Graphics,
+		Compute
+	};
 
+	// =========================================================================
+	// NoiseJob
+	// A generation submitted by AcquireAsync; 0 is never a valid job.
+	// =========================================================================
+	using NoiseJob = uint64_t;
 
+	enum class NoiseJobState
+	{
+		Pending,
+		Ready,
+		Failed
 	};
 
 	// =========================================================================
-	// NoiseTextureDesc
+	// NoiseRegion
+	// A rectangle of an existing 2D noise texture, filled with a window of an
+	// unbounded noise field. This is how streamed terrain tiles are written:
+	// neighbouring regions with adjacent uv windows join seamlessly.
 	// =========================================================================
-	struct NoiseTextureDesc
+	struct NoiseRegion
 	{
-		uint32_t  width = 128;
-		uint32_t  height = 128;
-		uint32_t  depth = 128;            // Must be >= 1. Use 1 for "flat" 3D (samples as 2D at z=0.5)
-
-		NoiseType noiseType = NoiseType::Perlin;
-
-		uint32_t  octaves = 4;              // Number of FBM octaves
-		float     frequency = 4.0f;           // Base frequency (tiles across the texture this many times)
-		float     persistence = 0.5f;           // Amplitude multiplier per octave (< 1 = each octave quieter)
-		float     lacunarity = 2.0f;           // Frequency multiplier per octave (> 1 = finer detail per octave)
-		uint32_t  seed = 42;             // Random seed — different seeds shift the noise field
+		uint32_t originX = 0;       // First texel written
+		uint32_t originY = 0;
+		uint32_t width = 0;         // Texels written
+		uint32_t height = 0;
 
-		std::string debugName = "NoiseTexture";
+		float uvOffsetX = 0.0f;     // Noise-space uv at the region's first texel edge
+		float uvOffsetY = 0.0f;
+		float uvScale = 1.0f;       // Noise-space uv spanned by width (and height) texels
+		float periodScale = 1.0f;   // Wrap period multiplier — raise it so far-apart regions don't repeat
 	};
 
 	// =========================================================================
@@ -84,7 +125,68 @@ namespace Nightbloom
 		// The caller takes ownership of the returned texture and is responsible
 		// for deleting it at shutdown (or whenever the texture is no longer needed).
 		// Returns nullptr if generation fails.
-		VulkanTexture* Generate(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher);
+		VulkanTexture* Generate(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+			NoiseConsumer consumer = NoiseConsumer::Graphics);
+
+		// Generate for each desc, as one submission. An entry is null where
+		// that volume failed; the others are still returned.
+		std::vector<VulkanTexture*> GenerateMany(const std::vector<NoiseTextureDesc>& descs,
+			ComputeDispatcher* dispatcher, NoiseConsumer consumer = NoiseConsumer::Graphics);
+
+		// Like Generate, but an identical desc (and consumer) returns the
+		// texture made earlier. The generator owns it: hand it back with
+		// Release, never delete it. Released textures stay cached, up to
+		// MAX_UNUSED_CACHED of them, until Cleanup; evicted ones go through
+		// the device's deletion queue, so frames in flight may still use them.
+		VulkanTexture* Acquire(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+			NoiseConsumer consumer = NoiseConsumer::Graphics);
+		void Release(VulkanTexture* texture);
+
+		// Acquire for each desc; the ones not in either cache are generated
+		// as one submission. Release every non-null entry.
+		std::vector<VulkanTexture*> AcquireMany(const std::vector<NoiseTextureDesc>& descs,
+			ComputeDispatcher* dispatcher, NoiseConsumer consumer = NoiseConsumer::Graphics);
+
+		// Where Acquire loads and stores generated volumes; empty (the
+		// default) disables the disk cache. Mipped RGBA32F textures and
+		// NoiseChannelLayout::CloudShape ones aren't stored.
+		void SetDiskCacheDirectory(const std::string& directory) { m_DiskCacheDirectory = directory; }
+		size_t GetCachedTextureCount() const { return m_Cache.size(); }
+
+		// Acquire without blocking: records the dispatch and submits it (to
+		// the async compute queue when there is one) without waiting. A cache
+		// hit is Ready at the first poll. Only the in-memory cache is used,
+		// and mipped 2D noise falls back to Acquire, since the mip pass's
+		// descriptor sets only live for a frame; so do packed formats, which
+		// are finished on the CPU. Returns 0 on failure.
+		NoiseJob AcquireAsync(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+			NoiseConsumer consumer = NoiseConsumer::Graphics);
+
+		// Never waits. Ready: outTexture is the acquired texture (Release it
+		// like any other) and the job is finished. Failed or unknown job:
+		// outTexture is null and the job is finished.
+		NoiseJobState PollJob(NoiseJob job, VulkanTexture*& outTexture);
+
+		// Drops a job that is no longer wanted, waiting for its GPU work
+		void CancelJob(NoiseJob job);
+		size_t GetPendingJobCount() const { return m_Jobs.size(); }
+
+		// Run Generate on this compute-family pool (AsyncComputeQueue's) rather
+		// than the graphics pool given to Initialize. Null reverts to graphics.
+		void SetComputeCommandPool(VulkanCommandPool* computePool) { m_ComputeCommandPool = computePool; }
+
+		// Allocate an empty 2D noise texture (Storage | Sampled, layout still
+		// UNDEFINED) for RecordRegion to fill piece by piece. Same ownership
+		// rules as Generate. `sparse` asks for a partially resident image
+		// (TextureDesc::sparse): regions are only kept where pages are committed.
+		VulkanTexture* CreateRegionTarget(uint32_t width, uint32_t height, const std::string& debugName,
+			bool sparse = false);
+
+		// Record one region fill into `cmd` — no submit, no wait and no
+		// barriers, so it can ride along in a frame's compute pass. `target`
+		// must already be in GENERAL layout; desc's size fields are ignored.
+		bool RecordRegion(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, VulkanTexture* target,
+			const NoiseTextureDesc& desc, const NoiseRegion& region);
 
 	private:
 		// ------------------------------------------------------------------
@@ -101,8 +203,101 @@ namespace Nightbloom
 			float    persistence;
 			float    lacunarity;
 			uint32_t noiseType;   // Maps to NoiseType enum value
+
+			// Region fields, read by noise2D.comp only
+			uint32_t originX = 0;
+			uint32_t originY = 0;
+			float    uvOffsetX = 0.0f;
+			float    uvOffsetY = 0.0f;
+			float    uvScale = 1.0f;
+			float    periodScale = 1.0f;
+
+			uint32_t channelLayout = 0;   // NoiseChannelLayout, read by noise.comp only
+		};
+
+		struct CachedNoise
+		{
+			std::unique_ptr<VulkanTexture> texture;
+			uint32_t references = 0;
+			uint64_t lastUse = 0;
+		};
+
+		static constexpr size_t MAX_UNUSED_CACHED = 4;
+
+		// Workgroup sizes of noise.comp (3D) and noise2D.comp
+		static constexpr uint32_t GROUP_SIZE_3D_XY = 8;
+		static constexpr uint32_t GROUP_SIZE_3D_Z = 4;
+		static constexpr uint32_t GROUP_SIZE_2D = 16;
+
+		// One volume of a GenerateBatch: the desc in, the texture out
+		struct BatchVolume
+		{
+			NoiseTextureDesc desc;                    // resolved by PrepareVolume
+			std::vector<float>* readback = nullptr;   // mip 0's R channel, for the disk cache
+			VulkanTexture* texture = nullptr;         // null if this volume failed
+			bool packed = false;                      // texture is CreatePackedTexture's
+
+			std::unique_ptr<VulkanBuffer> readbackBuffer;
+			VkDescriptorSet storageSet = VK_NULL_HANDLE;
+			uint32_t mipLevels = 1;
+		};
+
+		// One AcquireAsync submission. The dispatch runs on the compute queue
+		// behind computeFence, or on the graphics queue at graphicsValue of
+		// its timeline; a hand-off adds a graphics acquire at graphicsValue
+		// once the fence has signalled.
+		struct PendingJob
+		{
+			NoiseTextureDesc desc;
+			NoiseConsumer consumer = NoiseConsumer::Graphics;
+			ComputeDispatcher* dispatcher = nullptr;  // records the hand-off acquire at poll time
+			uint64_t cacheKey = 0;
+			VulkanTexture* cached = nullptr;          // cache hit: already referenced
+
+			std::unique_ptr<VulkanTexture> texture;
+			VkDescriptorSet storageSet = VK_NULL_HANDLE;
+			VulkanCommandPool* generatePool = nullptr;
+			VkCommandBuffer generateCmd = VK_NULL_HANDLE;
+			VkCommandBuffer acquireCmd = VK_NULL_HANDLE;
+			VkFence computeFence = VK_NULL_HANDLE;
+			uint64_t graphicsValue = 0;
+			bool failed = false;
 		};
 
+		// Generate's body; with `readback` set, mip 0's R channel is copied
+		// out in the same submission (for the disk cache)
+		VulkanTexture* GenerateTexture(const NoiseTextureDesc& desc, ComputeDispatcher* dispatcher,
+			NoiseConsumer consumer, std::vector<float>* readback);
+		// Every volume recorded into one command buffer, submitted and
+		// waited on once; GenerateTexture is a batch of one
+		void GenerateBatch(std::vector<BatchVolume>& volumes, ComputeDispatcher* dispatcher, NoiseConsumer consumer);
+		bool PrepareVolume(BatchVolume& volume);
+		bool IsDiskCacheable(const NoiseTextureDesc& desc) const;
+		void AddToCache(uint64_t cacheKey, VulkanTexture* texture);
+		// desc with the format this device can hold (BC4 -> R8 without BC4 volumes)
+		NoiseTextureDesc ResolveFormat(const NoiseTextureDesc& desc) const;
+		// rgba is mip 0 as the shaders write it; packs it into desc.format
+		VulkanTexture* CreatePackedTexture(const NoiseTextureDesc& desc, const float* rgba,
+			ComputeDispatcher* dispatcher, NoiseConsumer consumer);
+		// After an upload on the graphics queue: hands the texture to the
+		// compute family for Compute consumers and makes it bindable
+		void FinishUploadedTexture(VulkanTexture* texture, const NoiseTextureDesc& desc,
+			ComputeDispatcher* dispatcher, NoiseConsumer consumer);
+		VulkanTexture* LoadFromDisk(const NoiseTextureDesc& desc, uint64_t key, ComputeDispatcher* dispatcher,
+			NoiseConsumer consumer);
+		void TrimCache();
+		bool IsHandOff(NoiseConsumer consumer) const;
+		void RecordGeneration(VkCommandBuffer commandBuffer, ComputeDispatcher* dispatcher, VulkanTexture* texture,
+			VkDescriptorSet storageSet, const NoiseTextureDesc& desc, uint32_t mipLevels, NoiseConsumer consumer,
+			VulkanBuffer* readbackBuffer);
+		void RecordHandOffAcquire(VkCommandBuffer commandBuffer, ComputeDispatcher* dispatcher, VulkanTexture* texture);
+		bool SubmitJob(PendingJob& job);
+		void DestroyJob(PendingJob& job);
+
+		static NoisePushConstants BuildPushConstants(const NoiseTextureDesc& desc);
+		VulkanTexture* CreateTexture(uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels = 1,
+			bool sparse = false);
+
 		bool CreateNoisePipeline();
 
 		bool CreateNoisePipeline2D();
@@ -110,6 +305,7 @@ namespace Nightbloom
 		VulkanDevice* m_Device = nullptr;
 		VulkanMemoryManager* m_MemoryManager = nullptr;
 		VulkanCommandPool* m_CommandPool = nullptr;
+		VulkanCommandPool* m_ComputeCommandPool = nullptr;  // optional, see SetComputeCommandPool
 		VulkanDescriptorManager* m_DescriptorManager = nullptr;
 
 		// The noise pipeline is owned directly by the generator, not through
@@ -121,6 +317,18 @@ namespace Nightbloom
 		VkPipeline       m_Pipeline2D = VK_NULL_HANDLE;
 		VkPipelineLayout m_PipelineLayout2D = VK_NULL_HANDLE;
 
+		// Optional: without it generateMips is ignored
+		std::unique_ptr<MipGenerator> m_MipGenerator;
+
+		// Acquire's textures by desc hash (see NoiseVolumeCache.hpp)
+		std::unordered_map<uint64_t, CachedNoise> m_Cache;
+		uint64_t m_CacheClock = 0;
+		std::string m_DiskCacheDirectory;
+
+		std::unordered_map<NoiseJob, PendingJob> m_Jobs;
+		NoiseJob m_NextJob = 1;
+
+		bool m_Bc4VolumesSupported = false;
 		bool m_Initialized = false;
 	};
 }
\ No newline at end of file
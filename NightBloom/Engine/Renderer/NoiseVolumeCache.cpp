@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+// NoiseVolumeCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/NoiseVolumeCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr char VOLUME_MAGIC[4] = { 'N', 'B', 'N', 'Z' };
+		constexpr uint32_t VOLUME_VERSION = 1;
+
+		struct VolumeHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint64_t key;
+			uint32_t width;
+			uint32_t height;
+			uint32_t depth;
+			uint32_t reserved;
+		};
+
+		// FNV-1a 64, field by field so struct padding never leaks in
+		template<typename T>
+		void HashValue(uint64_t& hash, const T& value)
+		{
+			const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+			for (size_t i = 0; i < sizeof(T); ++i)
+			{
+				hash ^= bytes[i];
+				hash *= 0x100000001b3ull;
+			}
+		}
+
+		size_t TexelCount(uint32_t width, uint32_t height, uint32_t depth)
+		{
+			return static_cast<size_t>(width) * height * depth;
+		}
+	}
+
+	uint64_t HashNoiseTextureDesc(const NoiseTextureDesc& desc)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		HashValue(hash, VOLUME_VERSION);
+		HashValue(hash, desc.width);
+		HashValue(hash, desc.height);
+		HashValue(hash, desc.depth);
+		HashValue(hash, static_cast<uint32_t>(desc.noiseType));
+		HashValue(hash, desc.octaves);
+		HashValue(hash, desc.frequency);
+		HashValue(hash, desc.persistence);
+		HashValue(hash, desc.lacunarity);
+		HashValue(hash, desc.seed);
+		HashValue(hash, static_cast<uint8_t>(desc.generateMips ? 1 : 0));
+		HashValue(hash, static_cast<uint32_t>(desc.format));
+		HashValue(hash, static_cast<uint32_t>(desc.channels));
+		return hash;
+	}
+
+	std::string GetNoiseVolumePath(const std::string& cacheDirectory, uint64_t key)
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "noise_%016llx.nbnoise", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(cacheDirectory) / name).string();
+	}
+
+	bool WriteNoiseVolume(const std::string& path, uint64_t key,
+		uint32_t width, uint32_t height, uint32_t depth, const std::vector<float>& values)
+	{
+		if (values.size() != TexelCount(width, height, depth) || values.empty())
+			return false;
+
+		VolumeHeader header{};
+		std::memcpy(header.magic, VOLUME_MAGIC, sizeof(header.magic));
+		header.version = VOLUME_VERSION;
+		header.key = key;
+		header.width = width;
+		header.height = height;
+		header.depth = depth;
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(values.data()),
+				static_cast<std::streamsize>(values.size() * sizeof(float)));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	bool ReadNoiseVolume(const std::string& path, uint64_t key,
+		uint32_t width, uint32_t height, uint32_t depth, std::vector<float>& outValues)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		VolumeHeader header{};
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, VOLUME_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != VOLUME_VERSION ||
+			header.key != key ||
+			header.width != width || header.height != height || header.depth != depth)
+		{
+			return false;
+		}
+
+		outValues.resize(TexelCount(width, height, depth));
+		if (!file.read(reinterpret_cast<char*>(outValues.data()),
+			static_cast<std::streamsize>(outValues.size() * sizeof(float))))
+		{
+			outValues.clear();
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+// NoiseVolumeCache.hpp
+//
+// Content addressing for generated noise: HashNoiseTextureDesc covers every
+// field that changes the texels (not debugName), so two identical
+// descriptors share one texture (NoiseTextureGenerator::Acquire) and one
+// on-disk volume.
+//
+// On disk a volume is a header plus one float per texel - the noise shaders
+// write (v, v, v, 1), so the other channels are rebuilt on load (and packed
+// formats re-packed). NoiseChannelLayout::CloudShape volumes carry four
+// distinct channels and aren't stored. The header repeats the key and the
+// extent; any mismatch reads as a miss.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/NoiseTextureDesc.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	uint64_t HashNoiseTextureDesc(const NoiseTextureDesc& desc);
+
+	// <cacheDirectory>/noise_<16 hex digits>.nbnoise
+	std::string GetNoiseVolumePath(const std::string& cacheDirectory, uint64_t key);
+
+	// Writes through a temporary file and a rename, like the cooked mesh
+	// cache. values holds width * height * depth floats.
+	bool WriteNoiseVolume(const std::string& path, uint64_t key,
+		uint32_t width, uint32_t height, uint32_t depth, const std::vector<float>& values);
+
+	// False when the file is missing, for another key or extent, or short
+	bool ReadNoiseVolume(const std::string& path, uint64_t key,
+		uint32_t width, uint32_t height, uint32_t depth, std::vector<float>& outValues);
+}
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+// NoiseVolumePacking.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/NoiseVolumePacking.hpp"
+#include "Engine/Renderer/TextureCompression.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		uint32_t LevelSize(uint32_t size, uint32_t level)
+		{
+			return std::max(1u, size >> level);
+		}
+
+		// One level of `channels` floats per texel
+		struct FloatLevel
+		{
+			std::vector<float> texels;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t depth = 0;
+		};
+
+		// 2x2x2 box filter; an odd or unit axis reuses its last texel
+		FloatLevel Downsample(const FloatLevel& src, uint32_t channels)
+		{
+			FloatLevel dst;
+			dst.width = std::max(1u, src.width / 2);
+			dst.height = std::max(1u, src.height / 2);
+			dst.depth = std::max(1u, src.depth / 2);
+			dst.texels.resize(size_t(dst.width) * dst.height * dst.depth * channels);
+
+			auto at = [&](uint32_t x, uint32_t y, uint32_t z, uint32_t c)
+			{
+				x = std::min(x, src.width - 1);
+				y = std::min(y, src.height - 1);
+				z = std::min(z, src.depth - 1);
+				return src.texels[((size_t(z) * src.height + y) * src.width + x) * channels + c];
+			};
+
+			for (uint32_t z = 0; z < dst.depth; ++z)
+			{
+				for (uint32_t y = 0; y < dst.height; ++y)
+				{
+					for (uint32_t x = 0; x < dst.width; ++x)
+					{
+						float* out = &dst.texels[((size_t(z) * dst.height + y) * dst.width + x) * channels];
+						for (uint32_t c = 0; c < channels; ++c)
+						{
+							float sum = 0.0f;
+							for (uint32_t i = 0; i < 8; ++i)
+								sum += at(x * 2 + (i & 1), y * 2 + ((i >> 1) & 1), z * 2 + (i >> 2), c);
+							out[c] = sum * 0.125f;
+						}
+					}
+				}
+			}
+			return dst;
+		}
+
+		uint8_t ToUnorm8(float value)
+		{
+			return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+		}
+
+		void AppendLevel(const FloatLevel& level, NoiseTextureFormat format, uint32_t channels,
+			std::vector<uint8_t>& out)
+		{
+			const size_t texelCount = size_t(level.width) * level.height * level.depth;
+			if (format != NoiseTextureFormat::BC4)
+			{
+				for (size_t i = 0; i < texelCount * channels; ++i)
+					out.push_back(ToUnorm8(level.texels[i]));
+				return;
+			}
+
+			// Slice by slice: a 3D BC image is 4x4x1 blocks, slices tightly packed
+			const size_t sliceTexels = size_t(level.width) * level.height;
+			std::vector<uint8_t> slice(sliceTexels * 4, 255);
+			for (uint32_t z = 0; z < level.depth; ++z)
+			{
+				for (size_t i = 0; i < sliceTexels; ++i)
+					slice[i * 4] = ToUnorm8(level.texels[z * sliceTexels + i]);
+				const std::vector<uint8_t> blocks = CompressImage(BlockFormat::BC4, slice.data(), level.width, level.height);
+				out.insert(out.end(), blocks.begin(), blocks.end());
+			}
+		}
+	}
+
+	uint32_t GetNoiseFormatChannels(NoiseTextureFormat format)
+	{
+		switch (format)
+		{
+		case NoiseTextureFormat::R8:
+		case NoiseTextureFormat::BC4:   return 1;
+		case NoiseTextureFormat::RG8:   return 2;
+		case NoiseTextureFormat::RGBA8:
+		case NoiseTextureFormat::RGBA32F:
+		default:                        return 4;
+		}
+	}
+
+	float GetNoiseBytesPerTexel(NoiseTextureFormat format)
+	{
+		switch (format)
+		{
+		case NoiseTextureFormat::R8:    return 1.0f;
+		case NoiseTextureFormat::RG8:   return 2.0f;
+		case NoiseTextureFormat::RGBA8: return 4.0f;
+		case NoiseTextureFormat::BC4:   return 0.5f;
+		case NoiseTextureFormat::RGBA32F:
+		default:                        return 16.0f;
+		}
+	}
+
+	const char* GetNoiseFormatName(NoiseTextureFormat format)
+	{
+		switch (format)
+		{
+		case NoiseTextureFormat::R8:    return "R8";
+		case NoiseTextureFormat::RG8:   return "RG8";
+		case NoiseTextureFormat::RGBA8: return "RGBA8";
+		case NoiseTextureFormat::BC4:   return "BC4";
+		case NoiseTextureFormat::RGBA32F:
+		default:                        return "RGBA32F";
+		}
+	}
+
+	uint32_t GetNoiseMipCount(const NoiseTextureDesc& desc)
+	{
+		if (!desc.generateMips || (desc.format == NoiseTextureFormat::RGBA32F && desc.depth != 1))
+			return 1;
+
+		uint32_t levels = 1;
+		for (uint32_t size = std::max({ desc.width, desc.height, desc.depth }); size > 1; size >>= 1)
+			++levels;
+		return levels;
+	}
+
+	size_t GetNoiseLevelBytes(NoiseTextureFormat format, uint32_t width, uint32_t height, uint32_t depth)
+	{
+		if (format == NoiseTextureFormat::BC4)
+			return GetCompressedSize(BlockFormat::BC4, width, height) * depth;
+
+		const size_t texels = size_t(width) * height * depth;
+		return format == NoiseTextureFormat::RGBA32F
+			? texels * 4 * sizeof(float)
+			: texels * GetNoiseFormatChannels(format);
+	}
+
+	size_t GetNoiseTextureBytes(const NoiseTextureDesc& desc)
+	{
+		size_t bytes = 0;
+		const uint32_t levels = GetNoiseMipCount(desc);
+		for (uint32_t level = 0; level < levels; ++level)
+		{
+			bytes += GetNoiseLevelBytes(desc.format, LevelSize(desc.width, level),
+				LevelSize(desc.height, level), LevelSize(desc.depth, level));
+		}
+		return bytes;
+	}
+
+	PackedNoiseVolume PackNoiseVolume(const NoiseTextureDesc& desc, const float* rgba)
+	{
+		PackedNoiseVolume packed;
+		if (!rgba || desc.format == NoiseTextureFormat::RGBA32F ||
+			desc.width == 0 || desc.height == 0 || desc.depth == 0)
+		{
+			return packed;
+		}
+
+		const uint32_t channels = GetNoiseFormatChannels(desc.format);
+		const uint32_t levels = GetNoiseMipCount(desc);
+
+		// Mip 0: the channels the format keeps. Filtering happens before
+		// quantisation so every level rounds once.
+		FloatLevel level;
+		level.width = desc.width;
+		level.height = desc.height;
+		level.depth = desc.depth;
+		const size_t texelCount = size_t(desc.width) * desc.height * desc.depth;
+		level.texels.resize(texelCount * channels);
+		for (size_t i = 0; i < texelCount; ++i)
+		{
+			for (uint32_t c = 0; c < channels; ++c)
+				level.texels[i * channels + c] = rgba[i * 4 + c];
+		}
+
+		packed.data.reserve(GetNoiseTextureBytes(desc));
+		for (uint32_t l = 0; l < levels; ++l)
+		{
+			if (l > 0)
+				level = Downsample(level, channels);
+			packed.levelOffsets.push_back(packed.data.size());
+			AppendLevel(level, desc.format, channels, packed.data);
+		}
+		return packed;
+	}
+}
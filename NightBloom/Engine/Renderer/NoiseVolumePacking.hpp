@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+// NoiseVolumePacking.hpp
+//
+// The low-precision noise formats (NoiseTextureFormat other than RGBA32F).
+// The generator's shaders write RGBA32F; PackNoiseVolume turns that into the
+// stored format on the CPU: the mip chain (2x2x2 box filter, so 3D volumes
+// get mips too), then UNORM8 quantisation, then for BC4 one BC4 block per
+// 4x4 texels of every slice (TextureCompression.hpp). The result is laid
+// out the way VulkanTexture::UploadMipLevels takes it.
+//
+// The size functions are what the debug UI reports: a 128^3 cloud volume is
+// 32 MB as RGBA32F, 8 MB as RGBA8 and 1 MB as BC4, before mips.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/NoiseTextureDesc.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	// 1, 2 or 4
+	uint32_t GetNoiseFormatChannels(NoiseTextureFormat format);
+
+	// As stored; BC4 is 8 bytes per 4x4 block
+	float GetNoiseBytesPerTexel(NoiseTextureFormat format);
+
+	const char* GetNoiseFormatName(NoiseTextureFormat format);
+
+	// Levels desc asks for: 1 without generateMips, else down to 1x1x1.
+	// RGBA32F has no 3D chain (the mip generator is 2D only).
+	uint32_t GetNoiseMipCount(const NoiseTextureDesc& desc);
+
+	// One level; BC4 rounds each slice up to whole blocks
+	size_t GetNoiseLevelBytes(NoiseTextureFormat format, uint32_t width, uint32_t height, uint32_t depth);
+
+	// Every level of the texture desc describes
+	size_t GetNoiseTextureBytes(const NoiseTextureDesc& desc);
+
+	struct PackedNoiseVolume
+	{
+		std::vector<uint8_t> data;         // every level, tightly packed
+		std::vector<size_t> levelOffsets;  // where each level starts in data
+	};
+
+	// rgba holds desc.width * desc.height * desc.depth RGBA32F texels, x
+	// fastest. desc.format must not be RGBA32F (empty result otherwise).
+	PackedNoiseVolume PackNoiseVolume(const NoiseTextureDesc& desc, const float* rgba);
+}
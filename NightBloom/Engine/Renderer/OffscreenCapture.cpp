@@ -0,0 +1,366 @@
+//------------------------------------------------------------------------------
+// OffscreenCapture.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/OffscreenCapture.hpp"
+#include "Engine/Renderer/ImageWriter.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/ThreadPlacement.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	OffscreenCapture::~OffscreenCapture()
+	{
+		Shutdown();
+	}
+
+	bool OffscreenCapture::Initialize(Renderer* renderer, const CaptureSettings& settings)
+	{
+		if (!renderer || !renderer->SupportsAuxiliaryViews())
+		{
+			LOG_ERROR("OffscreenCapture: needs auxiliary views (a single-sample reflection pass)");
+			return false;
+		}
+		if (renderer->GetAuxiliaryViewFormat() != VK_FORMAT_B10G11R11_UFLOAT_PACK32)
+		{
+			LOG_ERROR("OffscreenCapture: unsupported auxiliary view format {}", static_cast<int>(renderer->GetAuxiliaryViewFormat()));
+			return false;
+		}
+
+		const VkExtent2D maxExtent = renderer->GetAuxiliaryViewMaxExtent();
+		m_Tiles = PlanCaptureTiles(settings.width, settings.height, maxExtent.width, maxExtent.height);
+		if (m_Tiles.empty())
+		{
+			LOG_ERROR("OffscreenCapture: can't tile {}x{} into {}x{}", settings.width, settings.height,
+				maxExtent.width, maxExtent.height);
+			return false;
+		}
+
+		m_Renderer = renderer;
+		m_Settings = settings;
+		m_InFlight.assign(renderer->GetFramesInFlight(), {});
+
+		// Every tile the frames in flight can hold, plus a frame's worth for
+		// the writers to work through while the GPU fills the rest
+		const uint32_t slotCount = settings.readbackSlots > 0
+			? std::max(settings.readbackSlots, MAX_AUXILIARY_VIEWS)
+			: MAX_AUXILIARY_VIEWS * (renderer->GetFramesInFlight() + 1);
+		const size_t slotSize = static_cast<size_t>(m_Tiles[0].width) * m_Tiles[0].height * sizeof(uint32_t);
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(renderer->GetDevice());
+		for (uint32_t i = 0; i < slotCount; ++i)
+		{
+			BufferDesc desc;
+			desc.usage = BufferUsage::Storage;
+			desc.memoryAccess = MemoryAccess::GpuToCpu;
+			desc.size = slotSize;
+			desc.persistentMap = true;
+			desc.debugName = "CaptureReadback" + std::to_string(i);
+
+			auto buffer = std::make_unique<VulkanBuffer>(vkDevice, renderer->GetMemoryManager());
+			if (!buffer->Initialize(desc) || !buffer->GetPersistentMappedPtr())
+			{
+				LOG_ERROR("OffscreenCapture: failed to create readback buffer {}", i);
+				Shutdown();
+				return false;
+			}
+			m_Slots.push_back(std::move(buffer));
+			m_FreeSlots.push_back(i);
+		}
+
+		uint32_t writerCount = settings.writerThreads;
+		if (writerCount == 0)
+			writerCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+		// One image assembling, one encoding per writer
+		m_MaxOpenImages = writerCount + 1;
+		m_Stopping = false;
+		for (uint32_t i = 0; i < writerCount; ++i)
+			m_Writers.emplace_back(&OffscreenCapture::WriterLoop, this);
+
+		LOG_INFO("OffscreenCapture: {}x{} {} in {} tile(s) of up to {}x{}, {} readback slots, {} writer(s)",
+			settings.width, settings.height, settings.format == CaptureFormat::Png ? "PNG" : "EXR",
+			m_Tiles.size(), maxExtent.width, maxExtent.height, slotCount, writerCount);
+		return true;
+	}
+
+	void OffscreenCapture::Shutdown()
+	{
+		if (!m_Renderer)
+			return;
+
+		// Whatever the GPU was still copying lands; the writers finish the
+		// images it completes
+		m_Renderer->WaitForIdle();
+		for (uint32_t frame = 0; frame < m_InFlight.size(); ++frame)
+			RetireFrame(frame);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+		m_WorkReady.notify_all();
+		for (std::thread& writer : m_Writers)
+			writer.join();
+		m_Writers.clear();
+
+		const uint32_t unfinished = static_cast<uint32_t>(m_Shots.size()) + m_OpenImages;
+		if (unfinished > 0)
+			LOG_WARN("OffscreenCapture: {} shot(s) not finished", unfinished);
+
+		m_Shots.clear();
+		m_Current.reset();
+		m_Retry.clear();
+		m_PreparedCount = 0;
+		m_InFlight.clear();
+		m_WriteQueue.clear();
+		m_FreeSlots.clear();
+		m_OpenImages = 0;
+		m_Slots.clear();
+		m_Tiles.clear();
+		m_Renderer = nullptr;
+	}
+
+	void OffscreenCapture::AddShot(const CaptureShot& shot)
+	{
+		m_Shots.push_back(shot);
+	}
+
+	//--------------------------------------------------------------------------
+	// Render thread
+	//--------------------------------------------------------------------------
+
+	uint32_t OffscreenCapture::PrepareFrame(AuxiliaryView* views)
+	{
+		m_PreparedCount = 0;
+		if (!m_Renderer)
+			return 0;
+
+		m_PreparedFrame = m_Renderer->GetCurrentFrameIndex();
+		if (m_PreparedFrame >= m_InFlight.size())
+			m_InFlight.resize(m_PreparedFrame + 1);
+		RetireFrame(m_PreparedFrame);
+		// Frame indices past a lowered frames-in-flight count won't come
+		// round again; BeginFrame has drained the device since
+		for (uint32_t frame = m_Renderer->GetFramesInFlight(); frame < m_InFlight.size(); ++frame)
+			RetireFrame(frame);
+
+		// Nothing left on the GPU and the writers own every slot or open
+		// image: wait for them rather than draw frames that capture nothing
+		const bool gpuIdle = std::all_of(m_InFlight.begin(), m_InFlight.end(),
+			[](const std::vector<TileJob>& jobs) { return jobs.empty(); });
+		if (gpuIdle && HasTilesToDraw())
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			const bool needsImage = m_Current == nullptr && m_Retry.empty();
+			m_WriterIdle.wait(lock, [&]
+			{
+				return !m_FreeSlots.empty() && (!needsImage || m_OpenImages < m_MaxOpenImages);
+			});
+		}
+
+		TileJob job;
+		while (m_PreparedCount < MAX_AUXILIARY_VIEWS && TakeNextTile(job))
+		{
+			const CaptureShot& shot = job.image->shot;
+			AuxiliaryView& view = views[m_PreparedCount];
+			view.view = shot.view;
+			view.projection = MakeTileProjection(shot.projection, m_Settings.width, m_Settings.height, job.tile);
+			view.position = shot.position;
+			view.width = job.tile.width;
+			view.height = job.tile.height;
+			m_Prepared[m_PreparedCount++] = std::move(job);
+		}
+		return m_PreparedCount;
+	}
+
+	// The next tile of this frame's shot, with a free slot; a new shot only
+	// starts on a frame of its own
+	bool OffscreenCapture::TakeNextTile(TileJob& job)
+	{
+		const Image* frameImage = m_PreparedCount > 0 ? m_Prepared[0].image.get() : nullptr;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_FreeSlots.empty())
+			return false;
+
+		if (!m_Retry.empty())
+		{
+			if (frameImage && m_Retry.front().image.get() != frameImage)
+				return false;
+			job = std::move(m_Retry.front());
+			m_Retry.pop_front();
+		}
+		else
+		{
+			if (!m_Current)
+			{
+				if (frameImage || m_Shots.empty() || m_OpenImages >= m_MaxOpenImages)
+					return false;
+				StartShot();
+			}
+			job.image = m_Current;
+			job.tile = m_Tiles[m_NextTile++];
+			if (m_NextTile == m_Tiles.size())
+				m_Current.reset();
+		}
+
+		job.slot = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+		return true;
+	}
+
+	// Under m_Mutex
+	void OffscreenCapture::StartShot()
+	{
+		m_Current = std::make_shared<Image>();
+		m_Current->shot = std::move(m_Shots.front());
+		m_Shots.pop_front();
+		m_Current->texels.resize(static_cast<size_t>(m_Settings.width) * m_Settings.height);
+		m_Current->tilesLeft = static_cast<uint32_t>(m_Tiles.size());
+		m_NextTile = 0;
+		++m_OpenImages;
+	}
+
+	void OffscreenCapture::SubmitFrame()
+	{
+		if (!m_Renderer)
+			return;
+
+		const uint32_t drawn = m_Renderer->GetAuxiliaryViewCount();
+		for (uint32_t view = 0; view < m_PreparedCount; ++view)
+		{
+			TileJob& job = m_Prepared[view];
+			const VkExtent2D extent = m_Renderer->GetAuxiliaryViewExtent(view);
+			if (view < drawn && extent.width == job.tile.width && extent.height == job.tile.height)
+			{
+				m_Renderer->RequestAuxiliaryViewReadback(view, m_Slots[job.slot]->GetBuffer());
+				m_InFlight[m_PreparedFrame].push_back(std::move(job));
+				continue;
+			}
+
+			// Target creation failed or the views were turned off this frame
+			ReleaseSlot(job.slot);
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Retry.push_back(std::move(job));
+		}
+		m_PreparedCount = 0;
+	}
+
+	// The frame's copies are complete (its fence was waited on): hand them
+	// to the writers
+	void OffscreenCapture::RetireFrame(uint32_t frameIndex)
+	{
+		if (frameIndex >= m_InFlight.size() || m_InFlight[frameIndex].empty())
+			return;
+
+		for (const TileJob& job : m_InFlight[frameIndex])
+			m_Slots[job.slot]->Invalidate();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (TileJob& job : m_InFlight[frameIndex])
+				m_WriteQueue.push_back(std::move(job));
+		}
+		m_InFlight[frameIndex].clear();
+		m_WorkReady.notify_all();
+	}
+
+	bool OffscreenCapture::IsFinished() const
+	{
+		if (HasTilesToDraw() || m_PreparedCount > 0)
+			return false;
+		for (const std::vector<TileJob>& jobs : m_InFlight)
+		{
+			if (!jobs.empty())
+				return false;
+		}
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_WriteQueue.empty() && m_BusyWriters == 0 && m_OpenImages == 0;
+	}
+
+	//--------------------------------------------------------------------------
+	// Writer threads
+	//--------------------------------------------------------------------------
+
+	void OffscreenCapture::WriterLoop()
+	{
+		ThreadPlacement::Apply(ThreadRole::Background);
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		for (;;)
+		{
+			m_WorkReady.wait(lock, [this] { return m_Stopping || !m_WriteQueue.empty(); });
+			if (m_WriteQueue.empty())
+				return;   // stopping, and drained
+
+			TileJob job = std::move(m_WriteQueue.front());
+			m_WriteQueue.pop_front();
+			++m_BusyWriters;
+			lock.unlock();
+
+			FinishTile(job);
+			job.image.reset();
+
+			lock.lock();
+			--m_BusyWriters;
+			m_WriterIdle.notify_all();
+		}
+	}
+
+	void OffscreenCapture::FinishTile(const TileJob& job)
+	{
+		Image& image = *job.image;
+		const void* texels = m_Slots[job.slot]->GetPersistentMappedPtr();
+		CopyCaptureTile(static_cast<const uint32_t*>(texels), job.tile, image.texels.data(), m_Settings.width);
+		ReleaseSlot(job.slot);
+
+		if (image.tilesLeft.fetch_sub(1) != 1)
+			return;
+
+		// Last tile in: this thread encodes
+		WriteImage(image);
+		std::vector<uint32_t>().swap(image.texels);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		--m_OpenImages;
+	}
+
+	void OffscreenCapture::WriteImage(Image& image)
+	{
+		const size_t count = image.texels.size();
+		std::vector<uint8_t> bytes;
+		if (m_Settings.format == CaptureFormat::Png)
+		{
+			std::vector<uint8_t> rgb(count * 3);
+			ConvertCaptureToSrgb8(image.texels.data(), count, m_Settings.exposure, m_Settings.tonemap, rgb.data());
+			bytes = EncodePng(rgb.data(), m_Settings.width, m_Settings.height, 3);
+		}
+		else
+		{
+			std::vector<uint16_t> rgb(count * 3);
+			ConvertCaptureToHalf(image.texels.data(), count, rgb.data());
+			bytes = EncodeExr(rgb.data(), m_Settings.width, m_Settings.height);
+		}
+
+		if (bytes.empty() || !WriteImageFile(image.shot.path, bytes))
+		{
+			LOG_ERROR("OffscreenCapture: failed to write {}", image.shot.path);
+			++m_Failed;
+			return;
+		}
+		LOG_INFO("OffscreenCapture: wrote {}", image.shot.path);
+		++m_Written;
+	}
+
+	void OffscreenCapture::ReleaseSlot(uint32_t slot)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_FreeSlots.push_back(slot);
+		}
+		m_WriterIdle.notify_all();
+	}
+}
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+// OffscreenCapture.hpp
+//
+// Batch stills and image sequences at any resolution, drawn as auxiliary
+// views (see AuxiliaryView.hpp) of the running frame loop. Each queued shot
+// is split into tiles no larger than an auxiliary target (CaptureImage.hpp);
+// every frame takes up to MAX_AUXILIARY_VIEWS of them, narrows the shot's
+// projection to each, and has the renderer copy each target into a
+// readback buffer right after drawing it.
+//
+// Nothing waits on the GPU. The readback buffers are a ring of host-cached
+// slots; a frame's slots are only read once its frame slot comes round
+// again (BeginFrame has waited on that fence), so as many frames stay in
+// flight as the renderer allows. Writer threads copy each tile into its
+// image, and the one that lands an image's last tile converts, encodes and
+// writes it - GPU and disk overlap, and encoding several images at once
+// uses the cores the render thread doesn't.
+//
+// Usage, once per frame between BeginFrame and FinalizeFrame:
+//   uint32_t count = capture.PrepareFrame(views);
+//   // cull with the views' frusta, then
+//   renderer->SetAuxiliaryViews(views, count);
+//   capture.SubmitFrame();
+// until IsFinished(). A frame draws tiles of one shot only, so the main
+// camera can follow it (shadows and LOD are selected for that view).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/AuxiliaryView.hpp"
+#include "Engine/Renderer/CaptureImage.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Nightbloom
+{
+	class Renderer;
+	class VulkanBuffer;
+
+	enum class CaptureFormat
+	{
+		Png,    // 8-bit sRGB, tonemapped like the post-process pass
+		Exr     // linear half-float HDR
+	};
+
+	struct CaptureSettings
+	{
+		uint32_t width = 3840;
+		uint32_t height = 2160;
+		CaptureFormat format = CaptureFormat::Png;
+		float exposure = 1.0f;         // PNG only
+		bool tonemap = true;           // PNG only: ACES, else a clamp
+		uint32_t readbackSlots = 0;    // 0: enough for every frame in flight plus one
+		uint32_t writerThreads = 0;    // 0: half the hardware threads, 1 to 4
+	};
+
+	struct CaptureShot
+	{
+		glm::mat4 view = glm::mat4(1.0f);
+		// Of the whole image (aspect width / height), as Camera builds it
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::vec3 position = glm::vec3(0.0f);
+		std::string path;
+	};
+
+	class OffscreenCapture
+	{
+	public:
+		OffscreenCapture() = default;
+		~OffscreenCapture();
+
+		// False when the renderer has no auxiliary views or their format
+		// isn't the packed B10G11R11 CaptureImage reads
+		bool Initialize(Renderer* renderer, const CaptureSettings& settings);
+
+		// Waits for the GPU and the writers; shots not fully drawn are dropped
+		void Shutdown();
+
+		// Drawn in the order added
+		void AddShot(const CaptureShot& shot);
+
+		// Hands the readbacks of the frame slot BeginFrame just waited on to
+		// the writers, then fills `views` (MAX_AUXILIARY_VIEWS of them) with
+		// the next tiles. Returns how many; 0 when the writers are behind.
+		uint32_t PrepareFrame(AuxiliaryView* views);
+
+		// After Renderer::SetAuxiliaryViews: requests the prepared tiles'
+		// readbacks. Tiles the renderer didn't take are drawn again later.
+		void SubmitFrame();
+
+		// Queued shots or tiles still to draw. The caller adds the next shot
+		// of a sequence only once this is false, and holds time still until
+		// then, so every tile of a shot sees the same frame.
+		bool HasTilesToDraw() const { return !m_Shots.empty() || m_Current != nullptr || !m_Retry.empty(); }
+
+		// Every shot added so far drawn and written (or failed)
+		bool IsFinished() const;
+
+		uint32_t GetWrittenCount() const { return m_Written.load(); }
+		uint32_t GetFailedCount() const { return m_Failed.load(); }
+		size_t GetTileCount() const { return m_Tiles.size(); }
+
+	private:
+		struct Image
+		{
+			CaptureShot shot;
+			std::vector<uint32_t> texels;     // packed B10G11R11, width x height
+			std::atomic<uint32_t> tilesLeft{ 0 };
+		};
+
+		struct TileJob
+		{
+			std::shared_ptr<Image> image;
+			CaptureTile tile;
+			uint32_t slot = 0;
+		};
+
+		bool TakeNextTile(TileJob& job);
+		void StartShot();
+		void RetireFrame(uint32_t frameIndex);
+		void WriterLoop();
+		void FinishTile(const TileJob& job);
+		void WriteImage(Image& image);
+		void ReleaseSlot(uint32_t slot);
+
+		Renderer* m_Renderer = nullptr;
+		CaptureSettings m_Settings;
+		std::vector<CaptureTile> m_Tiles;          // the same plan for every shot
+
+		// Render thread only
+		std::deque<CaptureShot> m_Shots;           // not started
+		std::shared_ptr<Image> m_Current;          // tiles left to hand out
+		size_t m_NextTile = 0;
+		std::deque<TileJob> m_Retry;               // handed out but not drawn
+		std::array<TileJob, MAX_AUXILIARY_VIEWS> m_Prepared;
+		uint32_t m_PreparedCount = 0;
+		uint32_t m_PreparedFrame = 0;
+		std::vector<std::vector<TileJob>> m_InFlight;   // by frame index
+
+		std::vector<std::unique_ptr<VulkanBuffer>> m_Slots;
+
+		// Shared with the writers
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_WorkReady;
+		std::condition_variable m_WriterIdle;
+		std::vector<uint32_t> m_FreeSlots;
+		std::deque<TileJob> m_WriteQueue;
+		uint32_t m_OpenImages = 0;                 // started, not yet written
+		uint32_t m_MaxOpenImages = 1;
+		uint32_t m_BusyWriters = 0;
+		bool m_Stopping = false;
+		std::vector<std::thread> m_Writers;
+
+		std::atomic<uint32_t> m_Written{ 0 };
+		std::atomic<uint32_t> m_Failed{ 0 };
+
+		OffscreenCapture(const OffscreenCapture&) = delete;
+		OffscreenCapture& operator=(const OffscreenCapture&) = delete;
+	};
+}
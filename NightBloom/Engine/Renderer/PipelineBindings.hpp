@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// PipelineBindings.hpp
+//
+// Which descriptor set each pipeline type expects at each set index, as a
+// table built at compile time. PipelineBindingTraits<type> describes one
+// type's layout; GetPipelineBindings looks it up. The command recorder walks
+// the slots of a draw's base type instead of asking every type "do you use
+// uniforms / textures / lighting ..." per draw, and rebinds only the slots
+// whose set changed since the last draw on the same layout.
+//
+// A type without a specialization binds nothing from here (shadow, compute,
+// post-process and composite pipelines bind their own sets). Twins (packed,
+// depth, OIT, reflection, tessellated) share their base type's layout, and
+// draws keep the base type, so only base types are listed.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/PipelineInterface.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace Nightbloom
+{
+	// Where the set bound at a slot comes from
+	enum class BindingSource : uint8_t
+	{
+		None,
+		Uniform,      // the frame's FrameUniforms (or the reflection pass's mirrored camera)
+		Texture,      // the draw's material: push buffers, its own set, or its first texture's
+		Lighting,     // the frame's lights
+		Shadow,       // the frame's shadow cascades, when shadows are on
+		Heightmap,    // DrawCommand::heightmapDescriptorSet, when set
+		Reflection,   // the planar reflection target, when the pass runs
+		CommandSet    // DrawCommand::textureDescriptorSet as is, when set
+	};
+
+	struct PipelineBindingLayout
+	{
+		static constexpr uint32_t MAX_SETS = 5;
+
+		std::array<BindingSource, MAX_SETS> sets{};
+
+		// Sets used, up to and including the highest non-None slot
+		constexpr uint32_t GetSetCount() const
+		{
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < MAX_SETS; ++i)
+			{
+				if (sets[i] != BindingSource::None)
+					count = i + 1;
+			}
+			return count;
+		}
+
+		constexpr bool Uses(BindingSource source) const
+		{
+			for (BindingSource set : sets)
+			{
+				if (set == source)
+					return true;
+			}
+			return false;
+		}
+	};
+
+	template<PipelineType Type>
+	struct PipelineBindingTraits
+	{
+		static constexpr PipelineBindingLayout layout{};
+	};
+
+	namespace BindingLayouts
+	{
+		using S = BindingSource;
+
+		inline constexpr PipelineBindingLayout UniformOnly{ { S::Uniform } };
+		inline constexpr PipelineBindingLayout Textured{ { S::Uniform, S::Texture } };
+		inline constexpr PipelineBindingLayout Lit{ { S::Uniform, S::Texture, S::Lighting } };
+		inline constexpr PipelineBindingLayout Shadowed{ { S::Uniform, S::Texture, S::Lighting, S::Shadow } };
+		inline constexpr PipelineBindingLayout Heightmapped{ { S::Uniform, S::Texture, S::Lighting, S::Shadow, S::Heightmap } };
+	}
+
+	template<> struct PipelineBindingTraits<PipelineType::Triangle>      { static constexpr PipelineBindingLayout layout = BindingLayouts::UniformOnly; };
+	template<> struct PipelineBindingTraits<PipelineType::Skybox>        { static constexpr PipelineBindingLayout layout = BindingLayouts::UniformOnly; };
+	template<> struct PipelineBindingTraits<PipelineType::NodeGenerated> { static constexpr PipelineBindingLayout layout = BindingLayouts::Textured; };
+	template<> struct PipelineBindingTraits<PipelineType::Firefly>       { static constexpr PipelineBindingLayout layout = BindingLayouts::Textured; };
+	template<> struct PipelineBindingTraits<PipelineType::FireflyPoint>  { static constexpr PipelineBindingLayout layout = BindingLayouts::Textured; };
+	template<> struct PipelineBindingTraits<PipelineType::Particle>      { static constexpr PipelineBindingLayout layout = BindingLayouts::Textured; };
+	template<> struct PipelineBindingTraits<PipelineType::Transparent>   { static constexpr PipelineBindingLayout layout = BindingLayouts::Lit; };
+	template<> struct PipelineBindingTraits<PipelineType::Mesh>          { static constexpr PipelineBindingLayout layout = BindingLayouts::Shadowed; };
+	template<> struct PipelineBindingTraits<PipelineType::Terrain>       { static constexpr PipelineBindingLayout layout = BindingLayouts::Heightmapped; };
+	template<> struct PipelineBindingTraits<PipelineType::Foliage>       { static constexpr PipelineBindingLayout layout = BindingLayouts::Heightmapped; };
+
+	// The composite pass only samples the raymarch result (CloudSystem's
+	// single set), with no FrameUniforms ahead of it
+	template<> struct PipelineBindingTraits<PipelineType::Clouds>
+	{
+		static constexpr PipelineBindingLayout layout{ { BindingSource::CommandSet } };
+	};
+
+	// No texture set and lighting at 1; set 3 holds the plane's wave maps
+	// (WaterSystem::SubmitDraw)
+	template<> struct PipelineBindingTraits<PipelineType::Water>
+	{
+		static constexpr PipelineBindingLayout layout{ {
+			BindingSource::Uniform, BindingSource::Lighting, BindingSource::Reflection, BindingSource::CommandSet } };
+	};
+
+	namespace Detail
+	{
+		template<size_t... I>
+		constexpr auto MakePipelineBindingTable(std::index_sequence<I...>)
+		{
+			return std::array<PipelineBindingLayout, sizeof...(I)>{
+				PipelineBindingTraits<static_cast<PipelineType>(I)>::layout... };
+		}
+
+		inline constexpr auto PipelineBindingTable =
+			MakePipelineBindingTable(std::make_index_sequence<static_cast<size_t>(PipelineType::Count)>{});
+
+		inline constexpr PipelineBindingLayout NoBindings{};
+	}
+
+	constexpr const PipelineBindingLayout& GetPipelineBindings(PipelineType type)
+	{
+		const size_t index = static_cast<size_t>(type);
+		return index < Detail::PipelineBindingTable.size() ? Detail::PipelineBindingTable[index] : Detail::NoBindings;
+	}
+}
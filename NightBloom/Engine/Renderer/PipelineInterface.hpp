@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Renderer/VertexPacking.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -18,7 +19,8 @@ namespace Nightbloom
 		TriangleStrip,
 		LineList,
 		LineStrip,
-		PointList
+		PointList,
+		PatchList     // tessellation input; PipelineConfig::patchControlPoints per patch
 	};
 
 	enum class PolygonMode
@@ -130,15 +132,151 @@ namespace Nightbloom
 		                // normal depth test occludes it correctly; before Firefly so fireflies
 		                // composite on top of clouds, not the reverse.
 		Firefly,        // Instanced billboard quads, additive blend, agent data from a storage buffer
-
-		Bloom,          // Full-screen bloom sub-pass (bright-extract / separable blur), recorded
-		                // directly by Renderer::RecordBloomPass like PostProcess — never appears in
-		                // a draw list, so the CommandRecorder draw chains don't reference it. One
-		                // pipeline, run 3x with a push-constant mode (extract / blur H / blur V).
+		FireflyPoint,   // Firefly's distant agents as single points, same sets and blend
+		Particle,       // ParticleSystem emitters: instanced billboards, premultiplied blend,
+		                // particles and alive lists from a storage buffer (set 1)
+
+		ShadowLayered,        // Shadow / TerrainShadow variants that draw every cascade in one
+		TerrainShadowLayered, // layered pass: instances fan out to cascades via gl_Layer. Only
+		                      // created with SupportsFeature("shader_output_layer").
+
+		PostProcessCopy,      // Full-screen copy of the compute post pass's output into the
+		                      // swapchain (post-process render pass, before the UI). Set 0 =
+		                      // post-process input.
+
+		MeshPacked,           // Mesh / Transparent / Shadow / ShadowLayered built for
+		TransparentPacked,    // VertexFormat::Packed meshes (VertexPNTPacked input,
+		ShadowPacked,         // MeshPacked.vert). Draws keep the base type; the
+		ShadowLayeredPacked,  // recorder binds ResolvePipelineVariant(type, format).
+
+		MeshDepth,            // Depth-only twins of Mesh / MeshPacked / Terrain / Foliage
+		MeshPackedDepth,      // for the optional depth prepass (Renderer::SetDepthPrepass):
+		TerrainDepth,         // same vertex shader and layout as the base type, Shadow.frag,
+		FoliageDepth,         // color writes masked off.
+
+		MeshEqual,            // The same four with an EQUAL depth test and no depth write,
+		MeshPackedEqual,      // bound by the color pass after the prepass so every pixel
+		TerrainEqual,         // is shaded once. The recorder picks both twins from the
+		FoliageEqual,         // bound type (GetDepthPrepassPipeline / GetDepthEqualPipeline).
+
+		TransparentOit,       // Twins of Transparent / TransparentPacked / Water / Firefly /
+		TransparentPackedOit, // FireflyPoint / Particle for the order-independent transparency
+		WaterOit,             // pass (Renderer::SetOrderIndependentTransparency): same vertex
+		FireflyOit,           // stage and sets, fragment shader built with NB_OIT_ACCUMULATE,
+		FireflyPointOit,      // writing the accumulation + revealage targets (GetOitPipeline).
+		ParticleOit,
+		OitComposite,         // Full-screen resolve of those targets over the scene color, the
+		                      // OIT pass's second subpass. Set 0 = the two input attachments.
+
+		SkyboxReflection,     // Twins of what the planar reflection pass draws, built for the
+		MeshReflection,       // reflection render pass when it runs at a lower MSAA count than
+		MeshPackedReflection, // the scene pass (RenderPassManager::GetReflectionSampleCount).
+		TerrainReflection,    // Same shaders, sets and state as the base type; only created,
+		FoliageReflection,    // and bound (GetReflectionPipeline), when the counts differ.
+		CloudsReflection,
+
+		TerrainTessellated,      // Terrain drawn from a coarse grid that TerrainTess.tesc splits
+		TerrainTessellatedDepth, // by screen-space edge length (TerrainDesc::tessellation), with
+		TerrainTessellatedEqual, // its depth prepass twins. Draws keep Terrain and set
+		                         // DrawCommand::tessellated; the recorder binds
+		                         // GetTessellatedPipeline. Only created with
+		                         // SupportsFeature("tessellation").
+
+		LocalShadow,          // Point light shadow faces (LocalShadowMaps): Shadow's state in
+		LocalShadowPacked,    // the same render pass, face view-projection in the push block.
 
 		Count
 	};
 
+	// The pipeline a draw of the given type binds for its vertex format.
+	// Types without a packed variant are unchanged.
+	inline PipelineType ResolvePipelineVariant(PipelineType type, VertexFormat format)
+	{
+		if (format != VertexFormat::Packed)
+			return type;
+
+		switch (type)
+		{
+		case PipelineType::Mesh:          return PipelineType::MeshPacked;
+		case PipelineType::Transparent:   return PipelineType::TransparentPacked;
+		case PipelineType::Shadow:        return PipelineType::ShadowPacked;
+		case PipelineType::ShadowLayered: return PipelineType::ShadowLayeredPacked;
+		case PipelineType::LocalShadow:   return PipelineType::LocalShadowPacked;
+		default:                          return type;
+		}
+	}
+
+	// The pipeline a draw asking for tessellation binds (after
+	// ResolvePipelineVariant). Types without a tessellated variant are unchanged.
+	inline PipelineType GetTessellatedPipeline(PipelineType type)
+	{
+		return type == PipelineType::Terrain ? PipelineType::TerrainTessellated : type;
+	}
+
+	// Depth-only twin of a bound scene pipeline (after ResolvePipelineVariant),
+	// or Count if the depth prepass doesn't cover it
+	inline PipelineType GetDepthPrepassPipeline(PipelineType bound)
+	{
+		switch (bound)
+		{
+		case PipelineType::Mesh:       return PipelineType::MeshDepth;
+		case PipelineType::MeshPacked: return PipelineType::MeshPackedDepth;
+		case PipelineType::Terrain:    return PipelineType::TerrainDepth;
+		case PipelineType::TerrainTessellated: return PipelineType::TerrainTessellatedDepth;
+		case PipelineType::Foliage:    return PipelineType::FoliageDepth;
+		default:                       return PipelineType::Count;
+		}
+	}
+
+	// What the color pass binds for a prepassed draw: the EQUAL twin, so only
+	// the fragments that won the prepass are shaded. Types the prepass
+	// doesn't cover are unchanged.
+	inline PipelineType GetDepthEqualPipeline(PipelineType bound)
+	{
+		switch (bound)
+		{
+		case PipelineType::Mesh:       return PipelineType::MeshEqual;
+		case PipelineType::MeshPacked: return PipelineType::MeshPackedEqual;
+		case PipelineType::Terrain:    return PipelineType::TerrainEqual;
+		case PipelineType::TerrainTessellated: return PipelineType::TerrainTessellatedEqual;
+		case PipelineType::Foliage:    return PipelineType::FoliageEqual;
+		default:                       return bound;
+		}
+	}
+
+	// Accumulation twin of a bound transparent pipeline (after
+	// ResolvePipelineVariant), or Count if OIT doesn't cover it
+	inline PipelineType GetOitPipeline(PipelineType bound)
+	{
+		switch (bound)
+		{
+		case PipelineType::Transparent:       return PipelineType::TransparentOit;
+		case PipelineType::TransparentPacked: return PipelineType::TransparentPackedOit;
+		case PipelineType::Water:             return PipelineType::WaterOit;
+		case PipelineType::Firefly:           return PipelineType::FireflyOit;
+		case PipelineType::FireflyPoint:      return PipelineType::FireflyPointOit;
+		case PipelineType::Particle:          return PipelineType::ParticleOit;
+		default:                              return PipelineType::Count;
+		}
+	}
+
+	// Reflection-pass twin of a bound scene pipeline (after
+	// ResolvePipelineVariant), or Count if the reflection pass doesn't draw it
+	inline PipelineType GetReflectionPipeline(PipelineType bound)
+	{
+		switch (bound)
+		{
+		case PipelineType::Skybox:     return PipelineType::SkyboxReflection;
+		case PipelineType::Mesh:       return PipelineType::MeshReflection;
+		case PipelineType::MeshPacked: return PipelineType::MeshPackedReflection;
+		case PipelineType::Terrain:    return PipelineType::TerrainReflection;
+		case PipelineType::TerrainTessellated: return PipelineType::TerrainReflection;  // the coarse grid, untessellated
+		case PipelineType::Foliage:    return PipelineType::FoliageReflection;
+		case PipelineType::Clouds:     return PipelineType::CloudsReflection;
+		default:                       return PipelineType::Count;
+		}
+	}
+
 	class Shader;
 
 	// Generic pipeline configuration
@@ -147,6 +285,13 @@ namespace Nightbloom
 		// Option 1: Shader objects (preferred when available)
 		Shader* vertexShader = nullptr;   // NEW
 		Shader* fragmentShader = nullptr; // NEW
+		// fp16 build of fragmentShader, used by variants with
+		// ShaderFeature::HalfPrecision (null: those use fragmentShader)
+		Shader* fragmentShaderHalf = nullptr;
+		// Ray-query build of fragmentShader, used by variants with
+		// ShaderFeature::RayQueryShadow (null: those variants fail to build
+		// and the pipeline keeps sampling the cascades)
+		Shader* fragmentShaderRayQuery = nullptr;
 
 		// Shader paths
 		std::string vertexShaderPath;
@@ -154,8 +299,15 @@ namespace Nightbloom
 		std::string geometryShaderPath;  // Optional
 		std::string computeShaderPath;   // For compute pipelines
 
+		// Tessellation (optional, both or neither): needs PatchList topology
+		// and SupportsFeature("tessellation")
+		std::string tessControlShaderPath;
+		std::string tessEvalShaderPath;
+		uint32_t patchControlPoints = 3;
+
 		// Vertex input
 		bool useVertexInput = false;
+		VertexFormat vertexFormat = VertexFormat::Standard;
 
 		// Primitive assembly
 		PrimitiveTopology topology = PrimitiveTopology::TriangleList;
@@ -188,18 +340,25 @@ namespace Nightbloom
 
 		// Replace descriptorSetCount with more specific flags
 		bool useTextures = false;        // Pipeline uses texture sampling
+		bool useBindlessTextures = false;  // With useTextures: set 1 is the bindless texture/material table instead of a per-draw texture set
 		bool useUniformBuffer = false;   // Pipeline uses uniform buffers
 		bool useLighting = false;	// Pipeline uses scene lighting UBO (set 2)
 		bool useShadowMap = false;  // Pipeline samples shadow map (set 3)
 		bool useHeightmap = false;  // Pipeline samples heightmap in vertex stage (set 4)
 		bool useFireflyStorage = false;  // Pipeline reads the firefly agent storage buffer (vertex+compute stages)
+		bool useParticleStorage = false;  // Pipeline reads the particle pool and alive lists (vertex+compute stages)
 		bool useFoliageStorage = false;  // Pipeline reads the foliage instance storage buffer (vertex stage only)
 		bool useCloudResult = false;  // Pipeline samples the low-res cloud raymarch result (fragment stage) - the graphics Clouds composite pass's only texture input
 		bool usePostProcessInput = false;  // Pipeline samples the scene-color texture (fragment stage) - the PostProcess/FXAA pass's only texture input
 		bool useReflectionInput = false;  // Pipeline samples the planar-reflection target (fragment stage) - the Water pass; lands last so it's set 2 (after uniform=0, lighting=1)
-		bool useBloomInput = false;  // PostProcess composite samples the bloom result as a SECOND single-sampler set (lands at set 1, after usePostProcessInput's set 0). Reuses the post-process input layout shape.
+		bool useOceanWaves = false;  // Pipeline samples the FFT ocean displacement/derivative maps (vertex+fragment) - the Water pass; pushed after useReflectionInput, so set 3
+		bool useOitInput = false;  // OitComposite reads the accumulation + revealage targets as input attachments (set 0)
+		bool useBloomInput = false;  // PostProcess composite samples the bloom chain (BloomMipChain's output set) as a SECOND single-sampler set (lands at set 1, after usePostProcessInput's set 0). Reuses the post-process input layout shape.
 
 		bool hasColorAttachment = true;  // False for depth-only passes (shadow)
+		bool colorWriteEnable = true;    // False keeps the attachment but masks every write (depth prepass inside the scene pass)
+		bool oitAccumulate = false;      // Two color attachments with the weighted-blended OIT blends (accumulation: One/One, revealage: Zero/OneMinusSrcColor); overrides blendEnable
+		bool coarseShading = false;      // Shade at the scene pass's shading-rate attachment (VariableRateShading); only where the device supports it
 
 		// Optional: custom render pass name (backend will resolve)
 		std::string renderPassName;  // Empty = use default
@@ -228,6 +387,9 @@ namespace Nightbloom
 		// Hot reload
 		virtual bool ReloadPipeline(PipelineType type) = 0;
 		virtual bool ReloadAllPipelines() = 0;
+		// Compile in the background; the renderer swaps them in at a frame boundary
+		virtual bool ReloadAllPipelinesAsync() = 0;
+		virtual bool HasPendingReloads() const = 0;
 
 		// Usage (command buffer operations are backend-specific and handled internally)
 		virtual void SetActivePipeline(PipelineType type) = 0;
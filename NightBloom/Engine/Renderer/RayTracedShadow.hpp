@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+// RayTracedShadow.hpp
+//
+// Sun shadows traced with VK_KHR_ray_query instead of rendered into the
+// cascades: the lit fragment shaders' ray-query builds (ShaderFeature::
+// RayQueryShadow) send one ray per pixel toward lights[0] through a top-level
+// acceleration structure of the frame's mesh draws, so the cost follows the
+// pixel count rather than the caster count and the cascade pass is skipped.
+// The RayTracedShadows component keeps a bottom-level structure per mesh
+// range (built once, the first frames it is drawn) and refits the top level
+// from the draws' transforms every frame, rebuilding it when the set of
+// instances changes or after refitsPerRebuild refits. The terrain stays the
+// heightfield TerrainSunShadow already marches; it is not in the TLAS.
+//
+// QuadShared traces half the rays - the diagonal pair of each 2x2 quad -
+// and every pixel of the quad takes the pair's average; denoise averages
+// full-rate rays over the quad the same way. Both read the neighbours
+// through fine derivatives, so they need what the cascades' receiver-plane
+// bias already does: SampleShadow called in quad-uniform control flow.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	enum class RayTracedShadowRate : uint32_t
+	{
+		Full,         // one ray per pixel
+		QuadShared    // one ray per two pixels, shared over the 2x2 quad
+	};
+
+	struct RayTracedShadowSettings
+	{
+		bool enabled = false;            // used where the device has ray queries (SupportsFeature("ray_query"))
+		RayTracedShadowRate rate = RayTracedShadowRate::Full;
+		bool denoise = false;            // average full-rate rays over each 2x2 quad (QuadShared always does)
+		float sunAngularRadiusDeg = 0.27f;   // cone the rays are jittered over; 0 = hard shadows
+		float maxDistance = 400.0f;      // ray length (world units); casters farther away don't shadow
+		float originOffset = 0.05f;      // ray start lifted along the surface normal (world units)
+		uint32_t refitsPerRebuild = 60;  // TLAS refits before a full rebuild restores its quality
+		uint32_t maxBlasBuildsPerFrame = 32;   // new meshes past this wait a frame (and cast no shadow)
+	};
+
+	// One TLAS entry; same layout as VkAccelerationStructureInstanceKHR
+	// (checked in RayTracedShadows.cpp)
+	struct RayTracedShadowInstance
+	{
+		float transform[3][4] = {};      // row-major 3x4 object-to-world
+		uint32_t customIndex : 24;
+		uint32_t mask : 8;
+		uint32_t sbtRecordOffset : 24;
+		uint32_t flags : 8;
+		uint64_t blasAddress = 0;
+
+		RayTracedShadowInstance() : customIndex(0), mask(0xFF), sbtRecordOffset(0), flags(0) {}
+	};
+	static_assert(sizeof(RayTracedShadowInstance) == 64, "Must match VkAccelerationStructureInstanceKHR");
+
+	enum class TlasUpdate
+	{
+		Build,   // from scratch
+		Refit    // same instances, moved (update mode)
+	};
+
+	// What a frame slot's TLAS was last built from
+	struct TlasState
+	{
+		bool built = false;
+		uint32_t instanceCount = 0;
+		uint64_t signature = 0;          // the instances' BLASes in order (RayTracedShadows hashes them)
+		uint32_t refits = 0;             // since the last full build
+	};
+
+	class RayTracedShadow
+	{
+	public:
+		// extraParams.y of ShadowData; mirrors the RAY_SHADOW_* modes in shadows.glsl
+		static constexpr float MODE_OFF = 0.0f;
+		static constexpr float MODE_PIXEL = 1.0f;
+		static constexpr float MODE_PIXEL_DENOISED = 2.0f;
+		static constexpr float MODE_QUAD_SHARED = 3.0f;
+
+		// extraParams.yzw while the ray-query builds are bound: y = mode,
+		// z = tan of the sun's angular radius, w = ray length
+		static glm::vec3 BuildParams(const RayTracedShadowSettings& settings)
+		{
+			float mode = MODE_PIXEL;
+			if (settings.rate == RayTracedShadowRate::QuadShared)
+				mode = MODE_QUAD_SHARED;
+			else if (settings.denoise)
+				mode = MODE_PIXEL_DENOISED;
+
+			const float radius = std::clamp(settings.sunAngularRadiusDeg, 0.0f, 10.0f);
+			return glm::vec3(mode, std::tan(glm::radians(radius)), std::max(settings.maxDistance, 0.0f));
+		}
+
+		// The 3x4 rows of an object-to-world matrix (its bottom row is
+		// dropped; a model transform's is always 0,0,0,1)
+		static void ToInstanceTransform(const glm::mat4& model, float out[3][4])
+		{
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 4; ++column)
+					out[row][column] = model[column][row];   // glm is column-major
+			}
+		}
+
+		// Refit only what a refit can take: the same number of instances
+		// over the same BLASes in the same order, and not too many refits in
+		// a row (each one loosens the tree around what moved)
+		static TlasUpdate PlanTlasUpdate(const TlasState& last, uint32_t instanceCount, uint64_t signature,
+			uint32_t refitsPerRebuild)
+		{
+			if (!last.built || last.instanceCount != instanceCount || last.signature != signature)
+				return TlasUpdate::Build;
+			if (last.refits >= refitsPerRebuild)
+				return TlasUpdate::Build;
+			return TlasUpdate::Refit;
+		}
+
+		// The state after applying `update`
+		static TlasState Advance(const TlasState& last, TlasUpdate update, uint32_t instanceCount, uint64_t signature)
+		{
+			TlasState next;
+			next.built = true;
+			next.instanceCount = instanceCount;
+			next.signature = signature;
+			next.refits = update == TlasUpdate::Refit ? last.refits + 1 : 0;
+			return next;
+		}
+	};
+}
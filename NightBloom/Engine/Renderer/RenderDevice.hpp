@@ -13,6 +13,7 @@
 
 // Use the pipeline interface for shared enums
 #include "Engine/Renderer/PipelineInterface.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
 
 namespace Nightbloom
 {
@@ -33,7 +34,8 @@ namespace Nightbloom
 		Uniform,        // Uniform/constant buffer
 		Storage,        // Storage buffer (compute)
 		Staging,        // CPU->GPU transfer
-		Indirect        // Indirect draw commands
+		Indirect,       // Indirect draw commands
+		ComputeVertex   // Vertex data written by a compute pass
 	};
 
 	// New: Explicit memory access patterns
@@ -69,11 +71,14 @@ namespace Nightbloom
 		Depth32F,
 		Depth16,
 
-		// Compressed formats (future)
+		// Block-compressed formats (4x4 texel blocks, loaded from KTX2)
 		BC1_RGB,
 		BC1_RGBA,
 		BC3_RGBA,
-		BC7_RGBA
+		BC7_RGBA,
+		BC4_R,
+		BC5_RG,
+		ASTC_4x4_RGBA
 	};
 
 	enum class TextureUsage
@@ -108,6 +113,10 @@ namespace Nightbloom
 		const void* initialData = nullptr;
 		size_t initialDataSize = 0;
 		bool persistentMap = false;  // Keep mapped (for uniforms)
+		bool deviceAddress = false;  // GPU pointer (acceleration structure inputs), where the device has them
+		// Rewritten from the CPU often: device-local memory the CPU writes
+		// into directly where there is some (resizable BAR), else as usual
+		bool directWrite = false;
 		std::string debugName;
 	};
 
@@ -126,6 +135,13 @@ namespace Nightbloom
 		bool isDepthStencil = false;
 		bool generateMips = false;
 		bool force3D = false;
+		// Which textures the driver evicts first under VRAM pressure
+		// (Low for streamed mips); Default follows the allocation's category
+		GpuMemoryPriority memoryPriority = GpuMemoryPriority::Default;
+		// Partially resident where the device allows it: memory only behind
+		// the pages the owner commits (VulkanTexture::GetSparsePages), and
+		// nothing at first. Else (or for unsupported formats) allocated whole.
+		bool sparse = false;
 	};
 
 	struct ShaderDesc
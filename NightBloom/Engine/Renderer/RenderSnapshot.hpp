@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// RenderSnapshot.hpp
+//
+// Everything the render side needs to draw one frame, captured by the
+// simulation side once its update is done. With frame pipelining enabled
+// (Application::SetFramePipelining) the simulation builds frame N+1's
+// snapshot on a job while the main thread records and submits frame N from
+// the previous one, so a snapshot must not point at anything the next
+// simulation step mutates or frees. Draw commands already carry their
+// transforms by value; the GPU buffers they reference must stay alive (scene
+// loads go through WaitForIdle anyway).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/Light.hpp"
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct RenderSnapshot
+	{
+		// Heap-backed (not the Renderer's frame arena, which is reset while
+		// the snapshot is still pending), reused across frames
+		DrawList drawList;
+
+		SceneLightingData lighting;
+		bool hasLighting = false;   // leave the renderer's lighting alone if unset
+		std::vector<LightData> pointLights;   // with hasLighting: all of them (empty = lighting's own)
+
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+		float deltaTime = 0.0f;
+		uint64_t frameNumber = 0;
+		std::chrono::steady_clock::time_point inputTime{};  // InputSystem::GetFrameInputTime of the simulated frame
+
+		// Keeps the draw list's and point lights' capacity
+		void Reset()
+		{
+			drawList.Clear();
+			lighting = SceneLightingData{};
+			hasLighting = false;
+			pointLights.clear();
+			view = glm::mat4(1.0f);
+			projection = glm::mat4(1.0f);
+			cameraPosition = glm::vec3(0.0f);
+			deltaTime = 0.0f;
+			frameNumber = 0;
+			inputTime = {};
+		}
+	};
+}
@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+// RenderStats.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/RenderStats.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// The block this thread writes, and the RenderStats it belongs to (by
+		// id: a new instance may reuse a destroyed one's address)
+		thread_local uint64_t t_Owner = 0;
+		thread_local void* t_Counters = nullptr;
+
+		thread_local uint32_t t_Pass = RenderStats::OTHER_PASS;
+
+		std::atomic<uint64_t> s_NextStatsId{ 1 };
+
+		constexpr size_t SLOT_COUNT = static_cast<size_t>(RenderStats::MAX_PASSES) * RENDER_COUNTER_COUNT;
+
+		const char* const COUNTER_NAMES[] = {
+			"Draw Calls", "Indirect Draws", "Instances", "Indices", "Dispatches",
+			"Pipeline Binds", "Descriptor Binds", "Push Constants", "Barriers", "Upload Bytes"
+		};
+		static_assert(std::size(COUNTER_NAMES) == RENDER_COUNTER_COUNT, "one name per counter");
+	}
+
+	const char* GetRenderCounterName(RenderCounter counter)
+	{
+		const uint32_t index = static_cast<uint32_t>(counter);
+		return index < RENDER_COUNTER_COUNT ? COUNTER_NAMES[index] : "?";
+	}
+
+	const RenderPassStats* RenderFrameStats::FindPass(StringId name) const
+	{
+		for (const RenderPassStats& pass : passes)
+		{
+			if (pass.name == name)
+				return &pass;
+		}
+		return nullptr;
+	}
+
+	RenderStats::RenderStats()
+		: m_Id(s_NextStatsId.fetch_add(1, std::memory_order_relaxed))
+	{
+		m_PassNames.reserve(MAX_PASSES);
+		m_PassNames.push_back("Other");
+		m_PreviousSums.assign(SLOT_COUNT, 0);
+	}
+
+	RenderStats& RenderStats::Get()
+	{
+		static RenderStats instance;
+		return instance;
+	}
+
+	uint32_t RenderStats::RegisterPass(StringId name)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = std::find(m_PassNames.begin(), m_PassNames.end(), name);
+		if (it != m_PassNames.end())
+			return static_cast<uint32_t>(it - m_PassNames.begin());
+		if (m_PassNames.size() >= MAX_PASSES)
+			return OTHER_PASS;
+
+		m_PassNames.push_back(name);
+		return static_cast<uint32_t>(m_PassNames.size() - 1);
+	}
+
+	StringId RenderStats::GetPassName(uint32_t pass) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_PassNames[pass < m_PassNames.size() ? pass : OTHER_PASS];
+	}
+
+	uint32_t RenderStats::GetCurrentPass()
+	{
+		return t_Pass;
+	}
+
+	RenderStats::ThreadCounters& RenderStats::GetThreadCounters()
+	{
+		if (t_Owner == m_Id)
+			return *static_cast<ThreadCounters*>(t_Counters);
+
+		auto counters = std::make_unique<ThreadCounters>();
+		counters->values = std::make_unique<std::atomic<uint64_t>[]>(SLOT_COUNT);
+		for (size_t i = 0; i < SLOT_COUNT; ++i)
+			counters->values[i].store(0, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		t_Owner = m_Id;
+		t_Counters = counters.get();
+		m_Threads.push_back(std::move(counters));
+		return *m_Threads.back();
+	}
+
+	void RenderStats::Add(RenderCounter counter, uint64_t amount)
+	{
+		if (!IsEnabled())
+			return;
+
+		// Only this thread writes the slot: no read-modify-write needed
+		std::atomic<uint64_t>& slot = GetThreadCounters().values[
+			static_cast<size_t>(t_Pass) * RENDER_COUNTER_COUNT + static_cast<uint32_t>(counter)];
+		slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	void RenderStats::AddDraw(uint32_t indexCount, uint32_t instanceCount)
+	{
+		Add(RenderCounter::DrawCalls);
+		Add(RenderCounter::Instances, instanceCount);
+		Add(RenderCounter::Indices, static_cast<uint64_t>(indexCount) * instanceCount);
+	}
+
+	void RenderStats::AddIndirectDraw()
+	{
+		Add(RenderCounter::DrawCalls);
+		Add(RenderCounter::IndirectDraws);
+	}
+
+	void RenderStats::EndFrame()
+	{
+		m_Sums.assign(SLOT_COUNT, 0);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (const std::unique_ptr<ThreadCounters>& thread : m_Threads)
+			{
+				for (size_t i = 0; i < SLOT_COUNT; ++i)
+					m_Sums[i] += thread->values[i].load(std::memory_order_relaxed);
+			}
+			m_FrameNames.assign(m_PassNames.begin(), m_PassNames.end());
+		}
+
+		// A full history hands its oldest frame's storage to the new one
+		RenderFrameStats frame;
+		if (m_History.size() >= m_HistoryCapacity)
+		{
+			frame = std::move(m_History.front());
+			m_History.pop_front();
+			frame.passes.clear();
+			frame.totals = {};
+		}
+		frame.frame = m_FrameCount++;
+		for (uint32_t pass = 0; pass < m_FrameNames.size(); ++pass)
+		{
+			RenderPassStats stats;
+			stats.name = m_FrameNames[pass];
+			bool counted = false;
+			for (uint32_t c = 0; c < RENDER_COUNTER_COUNT; ++c)
+			{
+				const size_t slot = static_cast<size_t>(pass) * RENDER_COUNTER_COUNT + c;
+				stats.counters[c] = m_Sums[slot] - m_PreviousSums[slot];
+				frame.totals[c] += stats.counters[c];
+				counted |= stats.counters[c] != 0;
+			}
+			if (counted)
+				frame.passes.push_back(stats);
+		}
+		std::swap(m_PreviousSums, m_Sums);
+
+		m_LastFrame = frame;
+		m_History.push_back(std::move(frame));
+		while (m_History.size() > m_HistoryCapacity)
+			m_History.pop_front();
+	}
+
+	void RenderStats::SetHistoryCapacity(uint32_t frames)
+	{
+		m_HistoryCapacity = std::max(1u, frames);
+		while (m_History.size() > m_HistoryCapacity)
+			m_History.pop_front();
+	}
+
+	std::vector<float> RenderStats::GetSeries(RenderCounter counter, uint32_t pass) const
+	{
+		const StringId name = pass == UINT32_MAX ? StringId() : GetPassName(pass);
+
+		std::vector<float> series;
+		series.reserve(m_History.size());
+		for (const RenderFrameStats& frame : m_History)
+		{
+			uint64_t value = frame.Get(counter);
+			if (name.IsValid())
+			{
+				const RenderPassStats* stats = frame.FindPass(name);
+				value = stats ? stats->Get(counter) : 0;
+			}
+			series.push_back(static_cast<float>(value));
+		}
+		return series;
+	}
+
+	RenderStatsPassScope::RenderStatsPassScope(uint32_t pass)
+		: m_Previous(t_Pass)
+	{
+		t_Pass = pass < RenderStats::MAX_PASSES ? pass : RenderStats::OTHER_PASS;
+	}
+
+	RenderStatsPassScope::~RenderStatsPassScope()
+	{
+		t_Pass = m_Previous;
+	}
+}
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+// RenderStats.hpp
+//
+// Per-frame, per-pass counts of what the CPU recorded: draw calls, instances,
+// indices, dispatches, pipeline and descriptor binds, push-constant updates,
+// barriers and uploaded bytes. The recording code counts where it issues the
+// vkCmd; RenderGraph::Execute opens a RenderStatsPassScope per pass, so the
+// counts land in the pass being recorded, and CommandRecorder hands the pass
+// on to the workers recording its secondaries. Anything outside a pass (the
+// uploads before the graph runs) lands in "Other".
+//
+// Like CpuProfiler, every counting thread gets its own block of counters,
+// written only by that thread: a count is a relaxed load and store, with no
+// lock and no read-modify-write. The blocks only ever grow; EndFrame() sums
+// them and diffs against the previous sums, so nothing is reset across
+// threads. Call it once per frame after the frame's recording is done.
+//
+// Indices are the CPU-known ones summed over instances (a non-indexed draw
+// counts its vertices), so Indices / 3 is the triangles of a triangle list.
+// Draws whose parameters a compute pass writes (Hi-Z, meshlets, GPU culling)
+// count as calls and IndirectDraws only. A cached secondary replayed as is
+// counts nothing - its commands were counted the frame it was recorded.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/StringId.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class RenderCounter : uint8_t
+	{
+		DrawCalls,
+		IndirectDraws,     // of DrawCalls, those with GPU-written parameters
+		Instances,
+		Indices,
+		Dispatches,
+		PipelineBinds,
+		DescriptorBinds,   // sets bound (or pushed), not vkCmdBindDescriptorSets calls
+		PushConstants,
+		Barriers,          // memory/buffer/image barriers, not vkCmdPipelineBarrier calls
+		UploadBytes,
+		Count
+	};
+
+	constexpr uint32_t RENDER_COUNTER_COUNT = static_cast<uint32_t>(RenderCounter::Count);
+
+	const char* GetRenderCounterName(RenderCounter counter);
+
+	using RenderCounters = std::array<uint64_t, RENDER_COUNTER_COUNT>;
+
+	struct RenderPassStats
+	{
+		StringId name;
+		RenderCounters counters{};
+
+		uint64_t Get(RenderCounter counter) const { return counters[static_cast<uint32_t>(counter)]; }
+	};
+
+	struct RenderFrameStats
+	{
+		uint64_t frame = 0;                   // EndFrame() calls before this one
+		std::vector<RenderPassStats> passes;  // passes that counted anything, in registration order
+		RenderCounters totals{};
+
+		uint64_t Get(RenderCounter counter) const { return totals[static_cast<uint32_t>(counter)]; }
+		// Null when the pass counted nothing this frame
+		const RenderPassStats* FindPass(StringId name) const;
+	};
+
+	class RenderStats
+	{
+	public:
+		static constexpr uint32_t MAX_PASSES = 64;        // later names count as "Other"
+		static constexpr uint32_t OTHER_PASS = 0;
+		static constexpr uint32_t DEFAULT_HISTORY = 240;  // frames
+
+		static RenderStats& Get();
+
+		void SetEnabled(bool enabled) { m_Enabled.store(enabled, std::memory_order_relaxed); }
+		bool IsEnabled() const { return m_Enabled.load(std::memory_order_relaxed); }
+
+		// The slot counts under `name` go to; the same name always gets the
+		// same slot. Takes a lock: look it up once per pass, not per count.
+		uint32_t RegisterPass(StringId name);
+
+		// The calling thread's current pass (RenderStatsPassScope)
+		static uint32_t GetCurrentPass();
+
+		// Counts into the calling thread's current pass
+		void Add(RenderCounter counter, uint64_t amount = 1);
+		void AddDraw(uint32_t indexCount, uint32_t instanceCount);
+		void AddIndirectDraw();
+
+		// Closes the frame: everything counted since the last call becomes
+		// GetLastFrame() and joins the history
+		void EndFrame();
+
+		const RenderFrameStats& GetLastFrame() const { return m_LastFrame; }
+
+		// Oldest first
+		const std::deque<RenderFrameStats>& GetHistory() const { return m_History; }
+		uint32_t GetHistoryCapacity() const { return m_HistoryCapacity; }
+		void SetHistoryCapacity(uint32_t frames);
+		void ClearHistory() { m_History.clear(); }
+
+		// One value per history frame, oldest first; pass is a RegisterPass
+		// slot or UINT32_MAX for the frame totals. For graphs.
+		std::vector<float> GetSeries(RenderCounter counter, uint32_t pass = UINT32_MAX) const;
+
+		StringId GetPassName(uint32_t pass) const;
+
+		RenderStats();
+		RenderStats(const RenderStats&) = delete;
+		RenderStats& operator=(const RenderStats&) = delete;
+
+	private:
+		// One per counting thread, kept after the thread exits so its counts
+		// still add up
+		struct ThreadCounters
+		{
+			std::unique_ptr<std::atomic<uint64_t>[]> values;   // [pass][counter]
+		};
+
+		ThreadCounters& GetThreadCounters();
+
+		const uint64_t m_Id;
+		std::atomic<bool> m_Enabled{ true };
+
+		mutable std::mutex m_Mutex;
+		std::vector<std::unique_ptr<ThreadCounters>> m_Threads;
+		std::vector<StringId> m_PassNames;      // guarded by m_Mutex
+
+		// Main thread (EndFrame and the readers)
+		std::vector<uint64_t> m_PreviousSums;   // [pass][counter] as of the last EndFrame
+		std::vector<uint64_t> m_Sums;           // EndFrame's scratch, kept for its capacity
+		std::vector<StringId> m_FrameNames;
+		RenderFrameStats m_LastFrame;
+		std::deque<RenderFrameStats> m_History;
+		uint32_t m_HistoryCapacity = DEFAULT_HISTORY;
+		uint64_t m_FrameCount = 0;
+	};
+
+	// Counts on this thread go to `pass` until the scope ends
+	class RenderStatsPassScope
+	{
+	public:
+		explicit RenderStatsPassScope(uint32_t pass);
+		~RenderStatsPassScope();
+
+		RenderStatsPassScope(const RenderStatsPassScope&) = delete;
+		RenderStatsPassScope& operator=(const RenderStatsPassScope&) = delete;
+
+	private:
+		uint32_t m_Previous = RenderStats::OTHER_PASS;
+	};
+}
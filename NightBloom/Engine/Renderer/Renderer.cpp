@@ -7,9 +7,16 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/RenderDevice.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/DrawStream.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/GLTFLoader.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
 #include "Engine/Renderer/Vulkan/VulkanSwapchain.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanFrameUploadBuffer.hpp"
 #include "Engine/Renderer/Vulkan/VulkanPipelineAdapter.hpp"
 #include "Engine/Renderer/Vulkan/VulkanShader.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
@@ -18,24 +25,56 @@
 #include "Engine/Renderer/Components/FrameSyncManager.hpp"
 #include "Engine/Renderer/Components/RenderPassManager.hpp"
 #include "Engine/Renderer/Components/CommandRecorder.hpp"
+#include "Engine/Renderer/Components/SignatureHash.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Components/AsyncAssetLoader.hpp"
+#include "Engine/Renderer/Components/AssetHotReload.hpp"
 #include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/AsyncComputeQueue.hpp"
+#include "Engine/Renderer/Components/RenderGraph.hpp"
 #include "Engine/Renderer/NoiseTextureGenerator.hpp"
 #include "Engine/VFX/FireflySystem.hpp"
+#include "Engine/VFX/ParticleSystem.hpp"
 #include "Engine/VFX/CloudSystem.hpp"
 #include "Engine/Hydro/WaterSystem.hpp"
+#include "Engine/Foliage/GrassSystem.hpp"
+#include "Engine/Terrain/TerrainSystem.hpp"
 #include "Engine/Renderer/Components/ShadowMapManager.hpp"
 #include "Engine/Renderer/Components/GpuProfiler.hpp"
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
+#include "Engine/Renderer/Components/MeshletCuller.hpp"
+#include "Engine/Renderer/Components/SkinningSystem.hpp"
+#include "Engine/Core/CpuProfiler.hpp"
+#include "Engine/Renderer/Components/TemporalUpscaler.hpp"
+#include "Engine/Renderer/Components/ContactShadows.hpp"
+#include "Engine/Renderer/Components/RayTracedShadows.hpp"
+#include "Engine/Renderer/Components/LocalShadowMaps.hpp"
+#include "Engine/Renderer/Components/BloomMipChain.hpp"
+#include "Engine/Renderer/Components/ComputePostProcess.hpp"
+#include "Engine/Renderer/Components/ScreenSpaceReflections.hpp"
+#include "Engine/Renderer/Components/LightClusterCuller.hpp"
+#include "Engine/Renderer/Components/VariableRateShading.hpp"
+#include "Engine/Renderer/Components/WindField.hpp"
+#include "Engine/Renderer/Components/AtmosphereLuts.hpp"
+#include "Engine/Renderer/Components/EnvironmentProbeCache.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Components/UIManager.hpp"
 #include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include "Engine/Core/PerformanceMetrics.hpp"
+#include "Engine/Core/StartupTimer.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include <algorithm>
 #include <filesystem>
 
 
 namespace Nightbloom
 {
+	// Per frame in flight: the uniform slots (about 3 KB plus the lighting
+	// UBO), the cloud and firefly params, and room for transient uploads
+	static constexpr VkDeviceSize FRAME_UPLOAD_REGION_SIZE = 256 * 1024;
+
 	Renderer::Renderer()
 	{
 		LOG_INFO("Renderer created");
@@ -52,6 +91,8 @@ namespace Nightbloom
 
 	bool Renderer::Initialize(void* windowHandle, uint32_t width, uint32_t height)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Renderer);
+
 		LOG_INFO("=== Initializing Renderer ===");
 		LOG_INFO("Window: {}x{}", width, height);
 
@@ -76,8 +117,10 @@ namespace Nightbloom
 			LOG_ERROR("Failed to initialize components");
 			return false;
 		}
+		StartupTimer::Get().Mark("Renderer core", StartupTimer::Now());
 
-		// Initialize pipelines
+		// Initialize pipelines. They compile across the job workers until
+		// FinishPipelineCreation below; nothing binds one before that.
 		if (!InitializePipelines())
 		{
 			LOG_ERROR("Failed to initialize pipelines");
@@ -98,7 +141,113 @@ namespace Nightbloom
 			m_ComputeEnabled = false;
 		}
 
+		if (!FinishPipelineCreation())
+		{
+			LOG_ERROR("Failed to create pipelines");
+			return false;
+		}
+
+		// Hi-Z occlusion culling (optional - everything is drawn without it)
+		if (!InitializeOcclusionCulling())
+		{
+			LOG_WARN("Failed to initialize occlusion culling - continuing without it");
+			if (m_OcclusionCuller)
+			{
+				m_OcclusionCuller->Cleanup();
+				m_OcclusionCuller.reset();
+			}
+		}
+
+		// Per-meshlet culling (optional - meshes are drawn whole without it)
+		if (m_OcclusionCuller && !InitializeMeshletCulling())
+		{
+			LOG_WARN("Failed to initialize meshlet culling - continuing without it");
+			if (m_MeshletCuller)
+			{
+				m_MeshletCuller->Cleanup();
+				m_MeshletCuller.reset();
+			}
+		}
+
+		// Compute skinning (optional - skinned models draw in their bind pose without it)
+		if (!InitializeSkinning())
+		{
+			LOG_WARN("Failed to initialize skinning - animated models will not move");
+			if (m_SkinningSystem)
+			{
+				m_SkinningSystem->Cleanup();
+				m_SkinningSystem.reset();
+			}
+		}
+
+		// Temporal upscaler (optional - post-process reads the scene color without it)
+		if (!InitializeTemporalUpscaling())
+		{
+			LOG_WARN("Failed to initialize temporal upscaling - continuing without it");
+			if (m_TemporalUpscaler)
+			{
+				m_TemporalUpscaler->Cleanup();
+				m_TemporalUpscaler.reset();
+			}
+		}
+
+		// Contact shadows (optional - the scene keeps only the cascades' shadows without them)
+		if (!InitializeContactShadows())
+		{
+			LOG_WARN("Contact shadows unavailable - continuing without them");
+			if (m_ContactShadows)
+			{
+				m_ContactShadows->Cleanup();
+				m_ContactShadows.reset();
+			}
+		}
+
+		// Ray-traced sun shadows (optional - the cascades stay the only sun shadows without them)
+		if (!InitializeRayTracedShadows())
+		{
+			if (m_RayTracedShadows)
+			{
+				LOG_WARN("Failed to initialize ray-traced shadows - continuing with cascaded shadows only");
+				m_RayTracedShadows->Cleanup();
+				m_RayTracedShadows.reset();
+			}
+		}
+
+		// Bloom mip chain (optional - post-process composites no bloom without it)
+		if (!InitializeBloom())
+		{
+			LOG_WARN("Failed to initialize bloom - continuing without it");
+			if (m_BloomChain)
+			{
+				m_BloomChain->Cleanup();
+				m_BloomChain.reset();
+			}
+		}
+
+		// Compute post pass (optional - the full-screen post-process draw is always there)
+		if (!InitializeComputePostProcess())
+		{
+			LOG_WARN("Failed to initialize the compute post pass - continuing without it");
+			if (m_ComputePost)
+			{
+				m_ComputePost->Cleanup();
+				m_ComputePost.reset();
+			}
+		}
+
+		// Screen-space water reflections (optional - the water keeps the planar reflection)
+		if (!InitializeScreenSpaceReflections())
+		{
+			LOG_WARN("Failed to initialize screen-space reflections - continuing with planar reflection only");
+			if (m_SSR)
+			{
+				m_SSR->Cleanup();
+				m_SSR.reset();
+			}
+		}
+
 		m_Initialized = true;
+		StartupTimer::Get().Mark("Renderer components", StartupTimer::Now());
 
 		// End initialization timing
 		PerformanceMetrics::Get().EndFrame();
@@ -112,6 +261,16 @@ namespace Nightbloom
 		LOG_INFO("=== Renderer Initialization Complete ===");
 		PerformanceMetrics::Get().LogMetrics();
 
+		MetricsExportSettings metricsSettings;
+		if (MetricsExporter::SettingsFromEnvironment(metricsSettings))
+		{
+			if (m_MetricsExporter.Start(metricsSettings))
+				LOG_INFO("Exporting metrics every {} ms (CSV '{}', StatsD '{}:{}')", metricsSettings.interval.count(),
+					metricsSettings.csvPath, metricsSettings.statsdHost, metricsSettings.statsdPort);
+			else
+				LOG_WARN("NIGHTBLOOM_METRICS_INTERVAL_MS must be at least 100 - metrics export off");
+		}
+
 		return true;
 	}
 
@@ -125,22 +284,135 @@ namespace Nightbloom
 
 		LOG_INFO("=== Shutting down Renderer ===");
 
+		// Flushes the last interval
+		m_MetricsExporter.Stop();
+
+		// No load may finish, and no queued task run, into resources that
+		// are going away
+		m_HotReload.reset();
+		if (m_AssetLoader)
+		{
+			m_AssetLoader->Shutdown();
+			m_AssetLoader.reset();
+		}
+		m_MainThreadTasks.Clear();
+
 		// Wait for device to be idle
 		if (m_Device)
 		{
 			m_Device->WaitForIdle();
 		}
 
+		// Retired swapchains must go before the surface they were created on
+		if (VulkanDeletionQueue* deletionQueue = static_cast<VulkanDevice*>(m_Device.get())->GetDeletionQueue())
+		{
+			deletionQueue->Flush();
+		}
+
 		// Log final performance metrics
 		PerformanceMetrics::Get().LogMetrics();
 
 		// Cleanup components in reverse order of initialization
 		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
+		if (m_SSR)
+		{
+			m_SSR->Cleanup();
+			m_SSR.reset();
+		}
+
+		if (m_VariableRateShading)
+		{
+			m_VariableRateShading->Cleanup();
+			m_VariableRateShading.reset();
+		}
+
+		if (m_WindField)
+		{
+			m_WindField->Cleanup();
+			m_WindField.reset();
+		}
+
+		if (m_AtmosphereLuts)
+		{
+			m_AtmosphereLuts->Cleanup();
+			m_AtmosphereLuts.reset();
+		}
+
+		if (m_EnvironmentProbe)
+		{
+			m_EnvironmentProbe->Cleanup();
+			m_EnvironmentProbe.reset();
+		}
+
+		if (m_LightClusters)
+		{
+			m_LightClusters->Cleanup();
+			m_LightClusters.reset();
+		}
+
+		if (m_LocalShadows)
+		{
+			m_LocalShadows->Cleanup();
+			m_LocalShadows.reset();
+		}
+
+		if (m_ComputePost)
+		{
+			m_ComputePost->Cleanup();
+			m_ComputePost.reset();
+		}
+
+		if (m_BloomChain)
+		{
+			m_BloomChain->Cleanup();
+			m_BloomChain.reset();
+		}
+
+		if (m_TemporalUpscaler)
+		{
+			m_TemporalUpscaler->Cleanup();
+			m_TemporalUpscaler.reset();
+		}
+
+		if (m_ContactShadows)
+		{
+			m_ContactShadows->Cleanup();
+			m_ContactShadows.reset();
+		}
+
+		if (m_RayTracedShadows)
+		{
+			m_RayTracedShadows->Cleanup();
+			m_RayTracedShadows.reset();
+		}
+
+		if (m_MeshletCuller)
+		{
+			m_MeshletCuller->Cleanup();
+			m_MeshletCuller.reset();
+		}
+
+		if (m_SkinningSystem)
+		{
+			m_SkinningSystem->Cleanup();
+			m_SkinningSystem.reset();
+		}
+
+		if (m_OcclusionCuller)
+		{
+			m_OcclusionCuller->Cleanup();
+			m_OcclusionCuller.reset();
+		}
+
 		CleanupCompute();
 
 		if (m_GpuProfiler)
 		{
+			if (VulkanUploadManager* uploads = m_Resources ? m_Resources->GetUploadManager() : nullptr)
+			{
+				uploads->SetProfiler(nullptr);
+			}
 			m_GpuProfiler->Cleanup();
 			m_GpuProfiler.reset();
 		}
@@ -173,6 +445,12 @@ namespace Nightbloom
 			m_Resources.reset();
 		}
 
+		if (m_FrameUploads)
+		{
+			m_FrameUploads->Cleanup();
+			m_FrameUploads.reset();
+		}
+
 		if (m_DescriptorManager)
 		{
 			m_DescriptorManager->Cleanup();
@@ -198,7 +476,7 @@ namespace Nightbloom
 		// Log final memory stats
 		if (m_MemoryManager)
 		{
-			m_MemoryManager->DestroyStagingPool();
+			m_MemoryManager->DestroyStagingRing();
 
 			LOG_INFO("=== Final Memory Statistics ===");
 			m_MemoryManager->LogMemoryStats();
@@ -211,6 +489,12 @@ namespace Nightbloom
 		}
 
 		m_MemoryManager.reset();
+
+		// Persist the pipeline cache for the next run
+		if (m_Device)
+		{
+			static_cast<VulkanDevice*>(m_Device.get())->ShutdownPipelineCache();
+		}
 		m_Device.reset();
 
 		// Clean up AssetManager
@@ -222,6 +506,7 @@ namespace Nightbloom
 
 	void Renderer::BeginFrame()
 	{
+		NB_PROFILE_SCOPE("Renderer::BeginFrame");
 		m_FrameValid = false;
 
 		if (!m_Initialized)
@@ -230,20 +515,119 @@ namespace Nightbloom
 			return;
 		}
 
-		// Start frame timing
+		// Start frame timing; closes the last frame's CPU allocation counts
 		PerformanceMetrics::Get().BeginFrame();
+		CpuMemory::BeginFrame();
 
 		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
+		// Frame boundary: rebuild the sync objects for a new frames-in-flight count
+		if (m_PendingFramesInFlight != 0)
+		{
+			const uint32_t count = m_PendingFramesInFlight;
+			m_PendingFramesInFlight = 0;
+			ApplyFramesInFlight(count);
+		}
+
+		// Frame boundary: swap to a new present mode (same extent, so only
+		// the swapchain and its framebuffers are rebuilt)
+		if (m_PresentModeChangePending)
+		{
+			m_PresentModeChangePending = false;
+			HandleSwapchainResize();
+		}
+
+		// Frame boundary: the scene targets follow the scene viewport once
+		// its size has settled
+		{
+			const VkExtent2D surface = m_Swapchain->GetExtent();
+			const VkExtent2D sceneExtent = m_RenderPasses->GetSceneExtent();
+			if (m_SceneViewport.Update(glm::uvec2(surface.width, surface.height),
+				glm::uvec2(sceneExtent.width, sceneExtent.height)))
+			{
+				const glm::uvec2 target = m_SceneViewport.GetTargetExtent();
+				ResizeSceneTargets({ target.x, target.y });
+			}
+		}
+
+		// Frame boundary: a reflection reused on later frames needs memory
+		// the bloom chain doesn't overwrite
+		const bool reflectionPersistent = GetReflectionInterval() > 1;
+		if (reflectionPersistent != m_RenderPasses->IsReflectionPersistent())
+		{
+			ApplyReflectionPersistence(reflectionPersistent);
+		}
+
 		// Wait for previous frame
-		if (!m_FrameSync->WaitForFrame(vkDevice->GetDevice()))
+		if (!m_FrameSync->WaitForFrame())
 		{
 			LOG_ERROR("Failed to wait for frame");
 			return;
 		}
 
+		// Frame boundary: swap in hot-reloaded pipelines, destroy the ones
+		// they replaced once no frame in flight can be using them
+		if (m_PipelineAdapter)
+		{
+			// Feature toggles select pipeline variants; a variant not built yet
+			// compiles in the background and the current one stays bound
+			ShaderVariantKey variant = 0;
+			if (m_ShadowPcf)
+				variant |= ToVariantBit(ShaderFeature::ShadowPcf);
+			if (m_DebugCascadeTint)
+				variant |= ToVariantBit(ShaderFeature::CascadeDebug);
+			if (m_PostProcessSettings.aaEnabled)
+				variant |= ToVariantBit(ShaderFeature::Fxaa);
+			if (m_PostProcessSettings.tonemapEnabled)
+				variant |= ToVariantBit(ShaderFeature::Tonemap);
+			if (m_HalfPrecisionShading && IsHalfPrecisionSupported())
+				variant |= ToVariantBit(ShaderFeature::HalfPrecision);
+			if (m_RayTracedShadows && m_RayTracedShadowSettings.enabled && m_ShadowEnabled)
+				variant |= ToVariantBit(ShaderFeature::RayQueryShadow);
+			m_PipelineAdapter->SetShaderVariant(variant);
+
+			// Cached secondaries may still name the retired pipelines
+			if (m_PipelineAdapter->ProcessPendingReloads(m_FrameSync->GetFramesInFlight()))
+				m_Commands->InvalidateCachedSecondaries();
+		}
+
+		// The cascades stop rendering only once every lit pipeline traces
+		// instead; switching back, what they cached is long out of date
+		const bool rayTracedShadow = IsRayTracedShadowActive();
+		if (rayTracedShadow != m_RayTracedShadowActive)
+		{
+			m_RayTracedShadowActive = rayTracedShadow;
+			if (!rayTracedShadow)
+				InvalidateShadowCache();
+		}
+
+		// Upload batches finished by now give their staging memory back
+		if (VulkanUploadManager* uploads = m_Resources->GetUploadManager())
+		{
+			uploads->RetireCompleted();
+		}
+
+		StepGpuDefragmentation();
+
+		// Retired swapchains/framebuffers no frame in flight can still use
+		vkDevice->GetDeletionQueue()->Collect();
+
+		// This slot's transient descriptor sets are no longer referenced
+		m_DescriptorManager->ResetTransientSets(m_FrameSync->GetCurrentFrame());
+
+		// Background loads that are ready get their GPU objects, so they can
+		// be drawn from this frame on; edited files start reloading first
+		if (m_HotReload)
+		{
+			m_HotReload->Update();
+		}
+		if (m_AssetLoader)
+		{
+			m_AssetLoader->Update();
+		}
+
 		// Acquire next image
-		if (!m_FrameSync->AcquireNextImage(vkDevice->GetDevice(), m_Swapchain.get(), m_CurrentImageIndex))
+		if (!m_FrameSync->AcquireNextImage(m_Swapchain.get(), m_CurrentImageIndex))
 		{
 			LOG_WARN("Failed to acquire image - swapchain may need recreation");
 			HandleSwapchainResize();
@@ -254,16 +638,106 @@ namespace Nightbloom
 		static auto startTime = std::chrono::high_resolution_clock::now();
 		auto currentTime = std::chrono::high_resolution_clock::now();
 		float newTotalTime = std::chrono::duration<float>(currentTime - startTime).count();
+		if (m_FixedTimestep > 0.0f)
+			newTotalTime = m_TotalTime + m_FixedTimestep;
 		m_LastDeltaTime = newTotalTime - m_TotalTime;
 		m_TotalTime = newTotalTime;
 
+		// A replayed frame overrides whatever the app set (SetDrawStreamReplay)
+		if (m_DrawStreamReplay)
+			ApplyDrawStreamInputs();
+
 		uint32_t frameIndex = m_FrameSync->GetCurrentFrame();
 
+		// This frame's region of the upload buffer is free again (its fence
+		// was waited on above); the uniforms below and the cloud params are
+		// written into it and flushed together at the end
+		m_FrameUploads->BeginFrame(frameIndex);
+
+		// The sky's LUTs for this frame's sun (see AtmosphereLuts.hpp); all
+		// zero - the clear colour - without compute
+		const glm::vec3 towardLight = -glm::vec3(m_CurrentLightingData.lights[0].position);
+		const glm::vec3 towardSun = glm::dot(m_SunDirection, m_SunDirection) > 0.0f ? m_SunDirection : towardLight;
+		m_CurrentFrameData.atmosphere = (m_AtmosphereLuts && m_ComputeDispatcher)
+			? m_AtmosphereLuts->Prepare(m_AtmosphereSettings, towardSun, m_CameraPosition.y)
+			: AtmosphereParamsData{};
+		m_CurrentFrameData.skyColor = glm::vec4(glm::vec3(m_ClearColor), 0.0f);
+
 		if (m_CloudSystem)
 		{
+			// The clouds may march on the async compute queue, away from the
+			// LUTs: they take the light's transmittance through the air to
+			// the middle of their layer instead
+			glm::vec3 sunTint(1.0f);
+			const AtmosphereParamsData& atmosphere = m_CurrentFrameData.atmosphere;
+			const float lightLength = glm::length(towardLight);
+			if (atmosphere.sun.w > 0.0f && lightLength > 0.0f)
+			{
+				const CloudDesc& clouds = m_CloudSystem->GetDesc();
+				const float layerY = 0.5f * (clouds.layerMinY + clouds.layerMaxY);
+				sunTint = Atmosphere::SunTransmittance(atmosphere,
+					Atmosphere::CameraRadius(m_AtmosphereSettings, layerY), towardLight.y / lightLength);
+			}
+			m_CloudSystem->SetSunTint(sunTint);
 			m_CloudSystem->UpdateParams(frameIndex, m_LastDeltaTime);
 		}
 
+		// The cloud shadow map's window; zero (no cloud shadows) unless the
+		// clouds will bake it this frame
+		const bool cloudShadows = m_CloudSystem && m_ComputeDispatcher && m_CloudSystem->IsReady() &&
+			m_CloudSystem->GetRaymarchResultImage() != VK_NULL_HANDLE && m_CloudSystem->GetShadowWindow().z > 0.0f;
+		m_CurrentFrameData.cloudShadow = cloudShadows ? m_CloudSystem->GetShadowWindow() : glm::vec4(0.0f);
+		UpdateCloudShadowBinding(frameIndex, cloudShadows);
+
+		// The terrain's sun shadow map's window; zero unless the terrain has
+		// one baked, or bakes it in this frame's compute pass
+		// The environment probe recaptures when it comes due or the sky
+		// moved on (see EnvironmentProbe.hpp); the clouds go in from their
+		// shadow map, so only when it is baked
+		if (m_EnvironmentProbe && m_ComputeDispatcher)
+		{
+			const LightData& light = m_CurrentLightingData.lights[0];
+			const float lightLength = glm::length(towardLight);
+
+			EnvironmentProbeInputs inputs;
+			inputs.towardSun = towardSun;
+			inputs.sunColor = glm::vec3(light.color) * light.color.a;
+			inputs.skyColor = glm::vec3(m_ClearColor);
+
+			EnvironmentCaptureData capture;
+			capture.sun = glm::vec4(lightLength > 0.0f ? towardLight / lightLength : glm::vec3(0.0f, 1.0f, 0.0f), 0.0f);
+			capture.sunColor = glm::vec4(inputs.sunColor, 0.0f);
+			capture.ambient = glm::vec4(glm::vec3(m_CurrentLightingData.ambient) * m_CurrentLightingData.ambient.a, 0.0f);
+			if (cloudShadows)
+			{
+				const CloudDesc& clouds = m_CloudSystem->GetDesc();
+				capture.clouds = glm::vec4(clouds.layerMinY, clouds.layerMaxY, 1.0f, 0.0f);
+			}
+			m_EnvironmentProbe->Prepare(m_EnvironmentProbeSettings, inputs, capture);
+		}
+
+		const TerrainSunShadowData terrainShadow = (m_TerrainSystem && m_ComputeDispatcher && m_ShadowEnabled)
+			? m_TerrainSystem->PrepareSunShadow(towardLight) : TerrainSunShadowData{};
+		m_CurrentFrameData.terrainShadow = terrainShadow;
+		UpdateTerrainShadowBinding(frameIndex, terrainShadow.window.z > 0.0f);
+
+		// With the map on, the terrain leaves the far cascades (see
+		// CullShadowCasters); their cached terrain depth goes either way
+		if ((terrainShadow.window.z > 0.0f) != m_TerrainSunShadowActive)
+		{
+			m_TerrainSunShadowActive = terrainShadow.window.z > 0.0f;
+			InvalidateShadowCache();
+		}
+
+		// The visible depth range the Hi-Z pass measured when this frame slot
+		// last ran; the shadow splits tighten to it
+		float nearestDepth = 0.0f;
+		float farthestDepth = 0.0f;
+		if (m_OcclusionCuller && m_OcclusionCuller->ReadDepthRange(frameIndex, nearestDepth, farthestDepth))
+			m_ShadowDepthBounds.Update(nearestDepth, farthestDepth, m_ProjectionMatrix[3][2]);
+		else
+			m_ShadowDepthBounds.Reset();
+
 		// =====================================================================
 		// FIX: Compute shadow matrices FIRST so m_ShadowFrameData is populated
 		// before we upload it to the GPU buffer below.
@@ -271,6 +745,18 @@ namespace Nightbloom
 		// always contained stale data from the previous frame (or zeros).
 		// =====================================================================
 		UpdateShadowMatrices();
+		if (m_DrawStreamReplay)
+			ApplyDrawStreamShadows();
+
+		// extraParams.yzw switch the ray-query builds from the cascades to the
+		// TLAS (RayTracedShadow.hpp); while tracing, the cascades' unused
+		// normal bias carries the ray's origin offset
+		ShadowData& shadowData = m_CurrentLightingData.shadowData;
+		const glm::vec3 rayParams = m_RayTracedShadowActive
+			? RayTracedShadow::BuildParams(m_RayTracedShadowSettings) : glm::vec3(0.0f);
+		shadowData.extraParams = glm::vec4(shadowData.extraParams.x, rayParams);
+		if (m_RayTracedShadowActive)
+			shadowData.shadowParams.y = m_RayTracedShadowSettings.originOffset;
 
 		// Water level fed to shaders via the reserved time.yz slots: time.y =
 		// water surface Y, time.z = water-enabled flag. Grass.vert reads these to
@@ -279,42 +765,149 @@ namespace Nightbloom
 		const float waterLevel = m_WaterSystem ? m_WaterSystem->GetWaterY() : 0.0f;
 		const float waterEnabled = m_WaterSystem ? 1.0f : 0.0f;
 
+		// Scene extent for this frame; the jitter below is in its pixels
+		UpdateRenderExtent();
+
+		// Temporal upscaling: only the scene pass draws jittered. Culling,
+		// Hi-Z, shadow fitting and the reflection keep m_ProjectionMatrix.
+		glm::mat4 sceneProjection = m_ProjectionMatrix;
+		m_FrameJitter = glm::vec2(0.0f);
+		if (m_TemporalUpscaler && m_TemporalUpscaler->IsEnabled())
+		{
+			m_FrameJitter = TemporalUpscaler::GetJitter(m_TemporalJitterIndex++);
+			sceneProjection = TemporalUpscaler::GetJitterMatrix(m_FrameJitter, m_RenderExtent) * m_ProjectionMatrix;
+		}
+
 		// Update camera uniform buffer (set 0 in main pass)
 		m_CurrentFrameData.view = m_ViewMatrix;
-		m_CurrentFrameData.proj = m_ProjectionMatrix;
+		m_CurrentFrameData.proj = sceneProjection;
 		m_CurrentFrameData.time.x = m_TotalTime;
 		m_CurrentFrameData.time.y = waterLevel;
 		m_CurrentFrameData.time.z = waterEnabled;
 		m_CurrentFrameData.time.w = 0.0f;  // main pass: no reflection below-water clip
 		m_CurrentFrameData.cameraPos = glm::vec4(m_CameraPosition, 1.0f);
 		m_CurrentFrameData.invView = glm::inverse(m_ViewMatrix);
-		m_CurrentFrameData.invProj = glm::inverse(m_ProjectionMatrix);
+		m_CurrentFrameData.invProj = glm::inverse(sceneProjection);
+		m_CurrentFrameData.reflection.x = GetPlanarReflectionScale();
+
+		// The reflection the water samples: rendered this frame, or kept from
+		// an earlier one and reprojected (see ReflectionSchedule.hpp). The
+		// planar pass draws with the unjittered projection; screen-space
+		// reflections are traced from this frame's jittered scene.
+		const glm::vec2 sceneUVScale = GetSceneUVScale();
+		if (IsScreenSpaceReflectionActive())
+		{
+			m_ReflectionDue = true;
+			m_ReflectionSchedule.Invalidate();   // the planar target isn't kept up meanwhile
+			m_CurrentFrameData.reflectionLookup = ReflectionSchedule::BuildLookup(sceneProjection * m_ViewMatrix, sceneUVScale);
+			m_CurrentFrameData.reflection.y = sceneUVScale.x;
+			m_CurrentFrameData.reflection.z = sceneUVScale.y;
+		}
+		else
+		{
+			const uint32_t interval = m_RenderPasses->IsReflectionPersistent() ? GetReflectionInterval() : 1;
+			const glm::vec2 planarUVScale = sceneUVScale * m_CurrentFrameData.reflection.x;
+			m_ReflectionDue = m_ReflectionSchedule.IsDue(interval, waterLevel);
+			m_ReflectionSchedule.Advance(m_ReflectionDue,
+				ReflectionSchedule::BuildLookup(m_ProjectionMatrix * m_ViewMatrix, planarUVScale), planarUVScale, waterLevel);
+			m_CurrentFrameData.reflectionLookup = m_ReflectionSchedule.GetLookup();
+			m_CurrentFrameData.reflection.y = m_ReflectionSchedule.GetUVExtent().x;
+			m_CurrentFrameData.reflection.z = m_ReflectionSchedule.GetUVExtent().y;
+		}
+
+		// Far-field grass for Terrain.frag (see GrassSystem.hpp); off without grass
+		const GrassFarFieldParams farGrass = m_GrassSystem ? m_GrassSystem->BuildFarFieldParams() : GrassFarFieldParams{};
+		m_CurrentFrameData.farGrassLod = farGrass.lod;
+		m_CurrentFrameData.farGrassDensity = farGrass.density;
+		m_CurrentFrameData.farGrassSlope = farGrass.slope;
+
+		// The terrain's virtual texture windows (see TerrainVirtualTexture.hpp)
+		m_CurrentFrameData.terrainVirtual = m_TerrainSystem ? m_TerrainSystem->GetVirtualTextureData() : TerrainVirtualTextureData{};
+
+		// The wind field's window (see WindField.hpp); still air when it isn't baked
+		const glm::vec2 cameraXZ(m_CameraPosition.x, m_CameraPosition.z);
+		const bool windBaked = m_WindField && m_WindField->CanBake() && m_ComputeDispatcher;
+		m_CurrentFrameData.windField = windBaked ? Wind::FieldWindow(m_WindSettings, cameraXZ) : glm::vec4(0.0f);
+		m_CurrentFrameData.windDirection = glm::vec4(Wind::Direction(m_WindSettings), 0.0f, 0.0f);
+
+		// The fireflies take the wind at their swarm's centre (they may run on
+		// the async compute queue, away from the field texture)
+		if (m_FireflySystem)
+		{
+			const glm::vec3 swarm = glm::vec3(m_FireflySystem->GetParams().boundsCenter);
+			const WindSample wind = Wind::Evaluate(m_WindSettings, glm::vec2(swarm.x, swarm.z), m_TotalTime);
+			m_FireflySystem->SetWind(m_WindSettings.enabled
+				? Wind::Direction(m_WindSettings) * Wind::Push(wind) : glm::vec2(0.0f));
+		}
+
+		// The particles take it at the camera, where the weather is seen
+		if (m_ParticleSystem)
+		{
+			const WindSample wind = Wind::Evaluate(m_WindSettings, cameraXZ, m_TotalTime);
+			m_ParticleSystem->SetWind(m_WindSettings.enabled
+				? Wind::Direction(m_WindSettings) * Wind::Push(wind) : glm::vec2(0.0f));
+		}
 
-		void* mapped = m_FrameUniforms[frameIndex]->GetPersistentMappedPtr();
+		void* mapped = m_FrameUploads->GetMapped(frameIndex, m_FrameUniformSlot);
 		if (mapped)
 		{
 			memcpy(mapped, &m_CurrentFrameData, sizeof(FrameUniformData));
-			m_FrameUniforms[frameIndex]->Flush();
 		}
 
-		// Upload shadow uniform buffers (set 0 in shadow pass - each cascade's light view/proj)
+		// Upload shadow uniforms (set 0 in shadow pass - each cascade's light view/proj)
 		// Now happens AFTER UpdateShadowMatrices has populated m_ShadowFrameData
 		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
 		{
-			void* shadowMapped = m_ShadowUniforms[frameIndex][c]->GetPersistentMappedPtr();
+			m_ShadowFrameData[c].windField = m_CurrentFrameData.windField;
+			m_ShadowFrameData[c].windDirection = m_CurrentFrameData.windDirection;
+			m_ShadowFrameData[c].atmosphere = m_CurrentFrameData.atmosphere;
+			m_ShadowFrameData[c].skyColor = m_CurrentFrameData.skyColor;
+			m_ShadowFrameData[c].cloudShadow = m_CurrentFrameData.cloudShadow;
+			void* shadowMapped = m_FrameUploads->GetMapped(frameIndex, m_ShadowUniformSlots[c]);
 			if (shadowMapped)
 			{
 				memcpy(shadowMapped, &m_ShadowFrameData[c], sizeof(FrameUniformData));
-				m_ShadowUniforms[frameIndex][c]->Flush();
 			}
 		}
 
-		// Upload lighting UBO (set 2)
-		void* lightMapped = m_LightingUniforms[frameIndex]->GetPersistentMappedPtr();
-		if (lightMapped)
+		void* layeredMapped = m_FrameUploads->GetMapped(frameIndex, m_ShadowLayeredUniformSlot);
+		if (layeredMapped)
+		{
+			memcpy(layeredMapped, m_CascadeLightVP.data(), sizeof(glm::mat4) * NUM_CASCADES);
+		}
+
+		// Point light shadow slots, which the lighting and cluster uploads
+		// below carry in position.w. Without the atlas every light goes out
+		// as a plain point light.
+		UpdateLocalShadowLights(frameIndex);
+
+		// Upload lighting UBO (set 2) - only when it differs from what this
+		// frame's slot holds, so static lighting (and a camera that doesn't
+		// move the cascades) leaves the slot alone
+		void* lightMapped = m_FrameUploads->GetMapped(frameIndex, m_LightingUniformSlot);
+		if (lightMapped && (!m_LightingUploaded[frameIndex] ||
+			memcmp(&m_UploadedLighting[frameIndex], &m_ShadedLightingData, sizeof(SceneLightingData)) != 0))
+		{
+			memcpy(lightMapped, &m_ShadedLightingData, sizeof(SceneLightingData));
+			m_UploadedLighting[frameIndex] = m_ShadedLightingData;
+			m_LightingUploaded[frameIndex] = true;
+		}
+
+		// Clustered point lights (set 2, bindings 1-2); culled on the GPU in
+		// the "Light Clusters" pass
+		if (m_LightClusters)
 		{
-			memcpy(lightMapped, &m_CurrentLightingData, sizeof(SceneLightingData));
-			m_LightingUniforms[frameIndex]->Flush();
+			LightClusterFrame clusterFrame;
+			clusterFrame.enabled = m_ClusteredLighting.enabled && m_ComputeDispatcher;
+			clusterFrame.pointLightsVersion = m_ShadedPointLightsVersion;
+			clusterFrame.renderExtent = m_RenderExtent;
+			clusterFrame.nearPlane = m_ProjectionMatrix[3][2];
+			clusterFrame.farDistance = m_ClusteredLighting.farDistance;
+			clusterFrame.fireflyCount = (m_ClusteredLighting.fireflyLights && m_FireflySystem && m_FireflySystem->IsReady())
+				? m_FireflySystem->GetAgentCount() : 0;
+			clusterFrame.fireflyRadius = m_ClusteredLighting.fireflyRadius;
+			clusterFrame.fireflyIntensity = m_ClusteredLighting.fireflyIntensity;
+			m_LightClusters->WriteLights(frameIndex, m_ShadedPointLights, clusterFrame);
 		}
 
 		// Upload reflection UBO (set 0 in the reflection pass). The camera is
@@ -345,17 +938,37 @@ namespace Nightbloom
 			m_ReflectionFrameData.cameraPos = glm::vec4(mirroredCam, 1.0f);
 			m_ReflectionFrameData.invView = glm::inverse(m_ReflectionFrameData.view);
 			m_ReflectionFrameData.invProj = glm::inverse(m_ReflectionFrameData.proj);
-
-			void* reflMapped = m_ReflectionUniforms[frameIndex]->GetPersistentMappedPtr();
+			m_ReflectionFrameData.reflection.x = m_CurrentFrameData.reflection.x;
+			m_ReflectionFrameData.farGrassLod = m_CurrentFrameData.farGrassLod;
+			m_ReflectionFrameData.farGrassDensity = m_CurrentFrameData.farGrassDensity;
+			m_ReflectionFrameData.farGrassSlope = m_CurrentFrameData.farGrassSlope;
+			m_ReflectionFrameData.windField = m_CurrentFrameData.windField;
+			m_ReflectionFrameData.windDirection = m_CurrentFrameData.windDirection;
+			m_ReflectionFrameData.atmosphere = m_CurrentFrameData.atmosphere;
+			m_ReflectionFrameData.skyColor = m_CurrentFrameData.skyColor;
+			m_ReflectionFrameData.cloudShadow = m_CurrentFrameData.cloudShadow;
+			m_ReflectionFrameData.terrainVirtual = m_CurrentFrameData.terrainVirtual;
+			m_ReflectionFrameData.terrainShadow = m_CurrentFrameData.terrainShadow;
+
+			void* reflMapped = m_FrameUploads->GetMapped(frameIndex, m_ReflectionUniformSlot);
 			if (reflMapped)
 			{
 				memcpy(reflMapped, &m_ReflectionFrameData, sizeof(FrameUniformData));
-				m_ReflectionUniforms[frameIndex]->Flush();
 			}
 		}
 
-		// Clear draw list for new frame
-		m_FrameDrawList.Clear();
+		// One flush for every uniform written above
+		m_FrameUploads->Flush();
+
+		// Recycle the per-frame arena. The draw list drops its arena storage
+		// first, then reserves last frame's count so it grows at most once.
+		size_t lastCommandCount = m_FrameDrawList.GetCommands().size();
+		m_FrameDrawList.ResetStorage(nullptr);
+		m_FrameArena.Reset();
+		m_FrameDrawList.ResetStorage(&m_FrameArena, lastCommandCount);
+
+		// Before the app submits: the mode changes how transparents sort
+		m_FrameDrawList.SetOrderIndependentTransparency(m_OrderIndependentTransparency);
 
 		// Start GPU timing
 		PerformanceMetrics::Get().BeginGPUWork();
@@ -369,18 +982,68 @@ namespace Nightbloom
 		m_FrameValid = true;
 	}
 
+	void Renderer::UpdateCloudShadowBinding(uint32_t frameIndex, bool clouds)
+	{
+		VulkanTexture* texture = clouds ? m_CloudSystem->GetShadowMap() : m_Resources->GetTexture("default_black"_sid);
+		if (!texture || m_CloudShadowBound[frameIndex] == texture->GetImageView()) return;
+
+		m_DescriptorManager->UpdateCloudShadowBinding(frameIndex, texture->GetImageView(), texture->GetSampler());
+		m_CloudShadowBound[frameIndex] = texture->GetImageView();
+	}
+
+	void Renderer::UpdateTerrainShadowBinding(uint32_t frameIndex, bool terrain)
+	{
+		VulkanTexture* texture = terrain ? m_TerrainSystem->GetSunShadowMap() : m_Resources->GetTexture("default_black"_sid);
+		if (!texture || m_TerrainShadowBound[frameIndex] == texture->GetImageView()) return;
+
+		m_DescriptorManager->UpdateTerrainShadowBinding(frameIndex, texture->GetImageView(), texture->GetSampler());
+		m_TerrainShadowBound[frameIndex] = texture->GetImageView();
+	}
+
 	void Renderer::EndFrame()
 	{
 		if (!m_Initialized) return;
+		NB_PROFILE_SCOPE("Renderer::EndFrame");
 
 		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 		uint32_t frameIndex = m_FrameSync->GetCurrentFrame();
 
+		// Async compute frame: the head (graphics-side compute, shadows) goes
+		// first, then the compute queue's work, and the rest of the frame
+		// waits for both the swapchain image and the compute results. Compute
+		// waits for the previous frame's last submission (which released the
+		// agent buffer back to it), so it overlaps this frame's head.
+		if (m_GpuProfiler) m_GpuProfiler->MarkSubmit(frameIndex, GpuQueue::Graphics);
+
+		VkSemaphore computeFinished = VK_NULL_HANDLE;
+		if (m_AsyncComputeFrame)
+		{
+			VulkanQueueTimeline* timeline = vkDevice->GetGraphicsTimeline();
+			uint64_t computeWaitValue = timeline->GetLastSubmittedValue();
+
+			if (m_FrameHeadCommandBuffer != VK_NULL_HANDLE &&
+				m_FrameSync->SubmitEarlyCommandBuffer(m_FrameHeadCommandBuffer) &&
+				m_AsyncComputeWaitsOnHead)
+			{
+				computeWaitValue = timeline->GetLastSubmittedValue();
+			}
+
+			if (m_GpuProfiler) m_GpuProfiler->MarkSubmit(frameIndex, GpuQueue::Compute);
+			if (m_AsyncCompute->Submit(frameIndex, computeWaitValue))
+			{
+				computeFinished = m_AsyncCompute->GetFinishedSemaphore(frameIndex);
+			}
+			else
+			{
+				LOG_ERROR("Failed to submit async compute work");
+				if (m_GpuProfiler) m_GpuProfiler->DiscardQueue(frameIndex, GpuQueue::Compute);
+			}
+		}
+
 		// Submit command buffer
 		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
-		if (!m_FrameSync->SubmitCommandBuffer(vkDevice->GetDevice(),
-			vkDevice->GetGraphicsQueue(),
-			cmd, m_CurrentImageIndex))
+		if (!m_FrameSync->SubmitCommandBuffer(cmd, m_CurrentImageIndex, computeFinished,
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT))
 		{
 			LOG_ERROR("Failed to submit command buffer");
 		}
@@ -388,6 +1051,9 @@ namespace Nightbloom
 		// End GPU timing
 		PerformanceMetrics::Get().EndGPUWork();
 
+		// Everything for this frame has been recorded
+		RenderStats::Get().EndFrame();
+
 		// Present
 		if (!m_FrameSync->PresentImage(m_Swapchain.get(),
 			vkDevice->GetPresentQueue(),
@@ -397,16 +1063,6 @@ namespace Nightbloom
 			HandleSwapchainResize();
 		}
 
-		static int gcCounter = 0;
-		if (++gcCounter >= 300)
-		{
-			if (auto* pool = m_MemoryManager->GetStagingPool())
-			{
-				pool->GarbageCollect();
-			}
-			gcCounter = 0;
-		}
-
 		// Update memory stats periodically (every 60 frames)
 		static int frameCounter = 0;
 		if (++frameCounter % 60 == 0)
@@ -416,10 +1072,17 @@ namespace Nightbloom
 				memStats.totalAllocatedBytes,
 				memStats.totalUsedBytes
 			);
+			if (m_MetricsExporter.IsRunning())
+			{
+				const VulkanMemoryManager::HeapBudget budget = m_MemoryManager->GetDeviceBudget();
+				m_MetricsMemoryUsage = budget.usage;
+				m_MetricsMemoryBudget = budget.budget;
+			}
 		}
 
 		// End frame timing
 		PerformanceMetrics::Get().EndFrame();
+		RecordExportedMetrics();
 
 		// Log metrics every second
 		static int logCounter = 0;
@@ -430,9 +1093,99 @@ namespace Nightbloom
 		}
 	}
 
+	void Renderer::RecordExportedMetrics()
+	{
+		if (!m_MetricsExporter.IsRunning())
+			return;
+
+		MetricsFrame frame;
+		frame.frameMs = PerformanceMetrics::Get().GetFrameTime();
+		frame.uploadBytes = RenderStats::Get().GetLastFrame().Get(RenderCounter::UploadBytes);
+		frame.memoryUsage = m_MetricsMemoryUsage;
+		frame.memoryBudget = m_MetricsMemoryBudget;
+
+		// GPU times arrive frames late; a frame not yet read back repeats
+		// the last one, which is sent only once
+		if (m_GpuProfiler && m_GpuProfiler->IsSupported() && m_GpuProfiler->GetHistory().GetFrameCount() > 0)
+		{
+			const GpuFrameProfile& gpu = m_GpuProfiler->GetHistory().GetFrame(0);
+			if (gpu.frameNumber != m_MetricsGpuFrame)
+			{
+				m_MetricsGpuFrame = gpu.frameNumber;
+				frame.gpuMs = gpu.GetQueueMs(GpuQueue::Graphics);
+				for (const GpuSpan& span : gpu.spans)
+				{
+					if (span.depth == 0)
+						frame.passes.push_back({ span.name, span.ms });
+				}
+			}
+		}
+		m_MetricsExporter.Record(frame);
+	}
+
+	bool Renderer::EnsureDrawBufferCapacity(uint32_t frameIndex, uint32_t instances, uint32_t draws)
+	{
+		// Half as much again on top of what was asked, so a scene that keeps
+		// growing doesn't reallocate every frame
+		auto grow = [](uint32_t current, uint32_t needed)
+		{
+			return std::max({ needed, current + current / 2, INITIAL_DRAW_INSTANCES });
+		};
+
+		bool ok = true;
+		if (!m_InstanceBuffers[frameIndex] || instances > m_InstanceCapacity[frameIndex])
+		{
+			const uint32_t capacity = grow(m_InstanceCapacity[frameIndex], instances);
+			const size_t bytes = size_t(capacity) * sizeof(InstanceData);
+			// Rewritten every frame: from VRAM rather than over the bus where
+			// the device has host-visible VRAM. Re-using the name hands the
+			// old buffer to the deletion queue.
+			VulkanBuffer* buffer = m_Resources->CreateStorageBuffer(
+				"InstanceData_" + std::to_string(frameIndex), bytes, true, true);
+			if (buffer && buffer->GetPersistentMappedPtr())
+			{
+				if (m_InstanceCapacity[frameIndex] > 0)
+					LOG_INFO("Instance buffer {} grown to {} instances", frameIndex, capacity);
+				m_InstanceBuffers[frameIndex] = buffer;
+				m_InstanceCapacity[frameIndex] = capacity;
+				// Set 0 binding 1 in the scene, shadow and reflection passes.
+				// This frame's sets are idle: its fence was waited in BeginFrame.
+				m_DescriptorManager->UpdateInstanceBinding(frameIndex, buffer->GetBuffer(), bytes);
+			}
+			else
+			{
+				LOG_ERROR("Failed to create instance buffer for frame {} ({} instances)", frameIndex, capacity);
+				ok = false;
+			}
+		}
+
+		// Multi-draw parameters. Without multiDrawIndirect every draw stays a
+		// call of its own and these are never created (decided at startup).
+		const bool indirect = m_IndirectDrawBuffers[frameIndex] ||
+			(!m_Initialized && m_Device->SupportsFeature("multi_draw_indirect"));
+		if (indirect && (!m_IndirectDrawBuffers[frameIndex] || draws > m_IndirectDrawCapacity[frameIndex]))
+		{
+			const uint32_t capacity = grow(m_IndirectDrawCapacity[frameIndex], draws);
+			VulkanBuffer* buffer = m_Resources->CreateIndirectBuffer("IndirectDraws_" + std::to_string(frameIndex),
+				size_t(capacity) * sizeof(IndexedIndirectDraw), true);
+			if (buffer && buffer->GetPersistentMappedPtr())
+			{
+				m_IndirectDrawBuffers[frameIndex] = buffer;
+				m_IndirectDrawCapacity[frameIndex] = capacity;
+			}
+			else
+			{
+				LOG_ERROR("Failed to create indirect draw buffer for frame {} ({} draws)", frameIndex, capacity);
+				ok = false;
+			}
+		}
+		return ok;
+	}
+
 	void Renderer::FinalizeFrame()
 	{
 		if (!m_Initialized) return;
+		NB_PROFILE_SCOPE("Renderer::FinalizeFrame");
 
 		// Finalize ImGui
 		if (m_UI)
@@ -440,17 +1193,153 @@ namespace Nightbloom
 			m_UI->EndFrame();
 		}
 
-		// Record command buffer with all draw commands
 		uint32_t frameIndex = m_FrameSync->GetCurrentFrame();
-		RecordCommandBuffer(frameIndex, m_CurrentImageIndex);
-	}
 
-	void Renderer::SubmitDrawList(const DrawList& drawList)
-	{
-		m_FrameDrawList = drawList;
-	}
+		// Before batching: the list still holds what the app submitted
+		if (!m_DrawStreamCapturePath.empty())
+			CaptureDrawStream();
 
-	void Renderer::Clear(float r, float g, float b, float a)
+		// Skinned draws move onto this frame's skinned vertices first, so two
+		// poses of one mesh never look identical to the batching below
+		if (m_SkinningSystem)
+			m_SkinningSystem->WriteJobs(frameIndex, m_FrameDrawList);
+
+		// The traced sun shadow's casters, from the draws' own transforms
+		// before batching merges them
+		if (m_RayTracedShadowActive)
+		{
+			m_RayTracedShadows->BeginFrame();
+			for (uint32_t i = 0; i < m_FrameDrawList.GetCommandCount(); ++i)
+			{
+				const DrawCommand& draw = m_FrameDrawList.GetCommand(i);
+				if (draw.pipeline == PipelineType::Mesh && IsShadowCaster(draw))
+					m_RayTracedShadows->AddCaster(draw);
+			}
+			m_RayTracedShadows->PrepareFrame(frameIndex);
+		}
+
+		// Which point light shadows have casters that changed; the rest keep
+		// what the atlas holds
+		if (m_LocalShadows)
+		{
+			m_LocalShadows->BeginCasters();
+			for (uint32_t i = 0; i < m_FrameDrawList.GetCommandCount(); ++i)
+			{
+				const DrawCommand& draw = m_FrameDrawList.GetCommand(i);
+				if (draw.pipeline == PipelineType::Mesh && IsShadowCaster(draw))
+					m_LocalShadows->AddCaster(draw);
+			}
+			m_LocalShadows->EndCasters();
+		}
+
+		// Write per-instance transforms and merge identical mesh draws. Runs
+		// once the list is final so every pass records the same batches.
+		// The buffers grow first so no draw is dropped for want of a slot.
+		const uint32_t instanceSlots = m_FrameDrawList.CountInstanceSlots();
+		EnsureDrawBufferCapacity(frameIndex, instanceSlots,
+			static_cast<uint32_t>(m_FrameDrawList.GetCommandCount()));
+		VulkanBuffer* instanceBuffer = m_InstanceBuffers[frameIndex];
+		InstanceData* instances = instanceBuffer
+			? static_cast<InstanceData*>(instanceBuffer->GetPersistentMappedPtr())
+			: nullptr;
+		uint32_t instanceCount = m_FrameDrawList.BuildInstanceBatches(instances, m_InstanceCapacity[frameIndex]);
+		if (instanceCount > 0)
+		{
+			instanceBuffer->Flush(0, instanceCount * sizeof(InstanceData));
+			RenderStats::Get().Add(RenderCounter::UploadBytes, instanceCount * sizeof(InstanceData));
+		}
+		m_LastInstanceCount = instanceCount;
+		m_LastDroppedInstances = instanceSlots > instanceCount ? instanceSlots - instanceCount : 0;
+
+		// Every command's draw parameters, for the multi-draw runs. Written in
+		// the same (final) order the passes walk.
+		m_IndirectDrawCount = 0;
+		if (VulkanBuffer* indirectBuffer = m_IndirectDrawBuffers[frameIndex])
+		{
+			auto* draws = static_cast<IndexedIndirectDraw*>(indirectBuffer->GetPersistentMappedPtr());
+			m_IndirectDrawCount = m_FrameDrawList.WriteIndirectDraws(draws, m_IndirectDrawCapacity[frameIndex]);
+			if (m_IndirectDrawCount > 0)
+			{
+				indirectBuffer->Flush(0, m_IndirectDrawCount * sizeof(IndexedIndirectDraw));
+				RenderStats::Get().Add(RenderCounter::UploadBytes, m_IndirectDrawCount * sizeof(IndexedIndirectDraw));
+			}
+			m_Commands->SetIndirectDrawBuffer(frameIndex, indirectBuffer->GetBuffer(), m_IndirectDrawCount);
+		}
+
+		// Meshlet jobs take their draws out of the whole-mesh occlusion test,
+		// so they are assigned first
+		if (m_MeshletCuller)
+		{
+			uint32_t jobs = m_MeshletCuller->WriteJobs(frameIndex, m_FrameDrawList, m_CameraPosition,
+				m_ProjectionMatrix * m_ViewMatrix);
+			m_Commands->SetMeshletDrawBuffers(frameIndex,
+				jobs > 0 ? m_MeshletCuller->GetDrawBuffer(frameIndex) : VK_NULL_HANDLE,
+				jobs > 0 ? m_MeshletCuller->GetCountBuffer(frameIndex) : VK_NULL_HANDLE);
+		}
+
+		// Occlusion slots index the final (batched) commands, so this goes last
+		if (m_OcclusionCuller)
+		{
+			uint32_t candidates = m_OcclusionCuller->WriteMeshCandidates(frameIndex, m_FrameDrawList);
+			m_Commands->SetOcclusionDrawBuffer(frameIndex,
+				candidates > 0 ? m_OcclusionCuller->GetMeshDrawBuffer(frameIndex) : VK_NULL_HANDLE);
+		}
+
+		// Prepass order last: it walks the final commands front to back
+		if (m_DepthPrepass)
+		{
+			m_FrameDrawList.BuildDepthPrepassOrder();
+		}
+		m_Commands->SetDepthPrepass(m_DepthPrepass);
+		m_Commands->SetOrderIndependentTransparency(m_OrderIndependentTransparency);
+
+		// Streamed textures: this frame's draws request their mips, and
+		// finished uploads swap in before recording picks up the new images.
+		// Without a view from the app, LOD is judged at output resolution.
+		LodView streamingView = m_FrameDrawList.GetLodView();
+		if (!streamingView.IsEnabled())
+		{
+			streamingView.position = m_CameraPosition;
+			streamingView.pixelsPerUnit = 0.5f * m_RenderPasses->GetSceneExtent().height * std::abs(m_ProjectionMatrix[1][1]);
+		}
+		m_Resources->UpdateTextureStreaming(m_FrameDrawList, streamingView);
+
+		// Auxiliary view cameras and masks, over the final commands
+		UploadAuxiliaryViews(frameIndex);
+
+		// Record command buffer with all draw commands
+		RecordCommandBuffer(frameIndex, m_CurrentImageIndex);
+		m_AuxiliaryReadbacks.fill(VK_NULL_HANDLE);
+	}
+
+	void Renderer::SubmitDrawList(const DrawList& drawList)
+	{
+		// Built in place via GetFrameDrawList() - nothing to copy
+		if (&drawList == &m_FrameDrawList)
+			return;
+
+		m_FrameDrawList = drawList;
+	}
+
+	void Renderer::SubmitSkyDraw(DrawList& drawList) const
+	{
+		if (!m_AtmosphereLuts || !m_AtmosphereSettings.enabled || !m_PipelineAdapter ||
+			!m_PipelineAdapter->GetPipeline(PipelineType::Skybox))
+			return;
+
+		// No vertex/index buffer - Clouds.vert generates the triangle; Sky.frag
+		// reads only set 0, which CommandRecorder binds for Skybox
+		DrawCommand cmd;
+		cmd.pipeline = PipelineType::Skybox;
+		cmd.vertexBuffer = nullptr;
+		cmd.indexBuffer = nullptr;
+		cmd.vertexCount = 3;
+		cmd.instanceCount = 1;
+		cmd.hasPushConstants = false;
+		drawList.AddCommand(cmd);
+	}
+
+	void Renderer::Clear(float r, float g, float b, float a)
 	{
 		m_ClearColor = glm::vec4(r, g, b, a);
 	}
@@ -473,6 +1362,12 @@ namespace Nightbloom
 		return m_Resources->GetTestIndexCount();
 	}
 
+	glm::vec3 Renderer::GetTestCubeExtents() const
+	{
+		if (!m_Resources) return glm::vec3(0.0f);
+		return m_Resources->GetTestCubeExtents();
+	}
+
 	Buffer* Renderer::GetMoonSphereVertexBuffer() const
 	{
 		if (!m_Resources) return nullptr;
@@ -491,6 +1386,12 @@ namespace Nightbloom
 		return m_Resources->GetMoonSphereIndexCount();
 	}
 
+	glm::vec3 Renderer::GetMoonSphereExtents() const
+	{
+		if (!m_Resources) return glm::vec3(0.0f);
+		return m_Resources->GetMoonSphereExtents();
+	}
+
 	Buffer* Renderer::GetGroundPlaneVertexBuffer() const
 	{
 		if (!m_Resources) return nullptr;
@@ -509,6 +1410,12 @@ namespace Nightbloom
 		return m_Resources->GetGroundPlaneIndexCount();
 	}
 
+	glm::vec3 Renderer::GetGroundPlaneExtents() const
+	{
+		if (!m_Resources) return glm::vec3(0.0f);
+		return m_Resources->GetGroundPlaneExtents();
+	}
+
 	void Renderer::TestShaderClass()
 	{
 		// Load a shader file
@@ -519,7 +1426,7 @@ namespace Nightbloom
 		// Create a VulkanShader
 		VulkanShader testShader(vkDevice, ShaderStage::Vertex);
 
-		if (testShader.CreateFromSpirV(shaderCode))
+		if (testShader.CreateFromSpirV(shaderCode.GetSpan()))
 		{
 			LOG_INFO("Test shader created successfully!");
 
@@ -545,8 +1452,10 @@ namespace Nightbloom
 			return;
 		}
 
-		// Wait for GPU to finish
-		m_Device->WaitForIdle();
+		// The last frame's dispatch must have landed (the graphics queue's
+		// last submission, not a device idle)
+		VulkanQueueTimeline* timeline = static_cast<VulkanDevice*>(m_Device.get())->GetGraphicsTimeline();
+		timeline->Wait(timeline->GetLastSubmittedValue());
 
 		// Capture current time for verification (matches what was used in last dispatch)
 		float capturedTime = m_TotalTime;
@@ -640,22 +1549,25 @@ namespace Nightbloom
 	{
 		if (!m_NoiseGenerator) return false;
 
-		m_Device->WaitForIdle();
-
-		if (m_NoisePreview)
-		{
-			delete m_NoisePreview;
-			m_NoisePreview = nullptr;
-		}
+		// Earlier frames may still be drawing the old preview in the UI
+		ReleaseNoisePreview();
 
-		// Force depth=1 so it gets a 2D image view (ImGui-displayable)
+		// Force depth=1 so it gets a 2D image view (ImGui-displayable); mipped
+		// so it doesn't alias when the panel is narrower than the texture
 		NoiseTextureDesc previewDesc = desc;
 		previewDesc.depth = 1;
+		previewDesc.generateMips = true;
 
 		m_NoisePreview = m_NoiseGenerator->Generate(previewDesc, m_ComputeDispatcher.get());
 		return m_NoisePreview != nullptr;
 	}
 
+	void Renderer::ReleaseNoisePreview()
+	{
+		m_Resources->DeferDestroy(m_NoisePreview);
+		m_NoisePreview = nullptr;
+	}
+
 	bool Renderer::LoadShaders()
 	{
 		LOG_INFO("=== Loading Shaders ===");
@@ -679,11 +1591,22 @@ namespace Nightbloom
 			LOG_WARN("Failed to load mesh vertex shader - continuing without mesh pipeline");
 		}
 
+		if (!m_Resources->LoadShader("mesh_packed_vert", ShaderStage::Vertex, "MeshPacked.vert"))
+		{
+			LOG_WARN("Failed to load packed mesh vertex shader - compressed meshes will not draw");
+		}
+
 		if (!m_Resources->LoadShader("mesh_frag", ShaderStage::Fragment, "Mesh.frag"))
 		{
 			LOG_WARN("Failed to load mesh fragment shader - continuing without mesh pipeline");
 		}
 
+		if (m_DescriptorManager->IsBindlessEnabled() &&
+			!m_Resources->LoadShader("mesh_bindless_frag", ShaderStage::Fragment, "MeshBindless.frag"))
+		{
+			LOG_WARN("Failed to load bindless mesh fragment shader - mesh passes will use per-texture sets");
+		}
+
 		
 		if (!m_Resources->LoadShader("terrain_vert", ShaderStage::Vertex, "Terrain.vert"))
 		{
@@ -715,6 +1638,18 @@ namespace Nightbloom
 			LOG_WARN("Failed to load firefly fragment shader - continuing without firefly pipeline");
 		}
 
+		if (!m_Resources->LoadShader("firefly_point_vert", ShaderStage::Vertex, "FireflyPoint.vert") ||
+			!m_Resources->LoadShader("firefly_point_frag", ShaderStage::Fragment, "FireflyPoint.frag"))
+		{
+			LOG_WARN("Failed to load firefly point shaders - distant fireflies stay billboards");
+		}
+
+		if (!m_Resources->LoadShader("particle_vert", ShaderStage::Vertex, "Particle.vert") ||
+			!m_Resources->LoadShader("particle_frag", ShaderStage::Fragment, "Particle.frag"))
+		{
+			LOG_WARN("Failed to load particle shaders - continuing without particle pipeline");
+		}
+
 		if (!m_Resources->LoadShader("clouds_vert", ShaderStage::Vertex, "Clouds.vert"))
 		{
 			LOG_WARN("Failed to load clouds vertex shader - continuing without clouds pipeline");
@@ -725,6 +1660,11 @@ namespace Nightbloom
 			LOG_WARN("Failed to load clouds fragment shader - continuing without clouds pipeline");
 		}
 
+		if (!m_Resources->LoadShader("sky_frag", ShaderStage::Fragment, "Sky.frag"))
+		{
+			LOG_WARN("Failed to load sky fragment shader - continuing without sky pipeline");
+		}
+
 		if (!m_Resources->LoadShader("postprocess_vert", ShaderStage::Vertex, "PostProcess.vert"))
 		{
 			LOG_ERROR("Failed to load post-process vertex shader");
@@ -737,11 +1677,35 @@ namespace Nightbloom
 			return false;
 		}
 
-		// Bloom reuses the post-process full-screen-triangle vertex shader.
-		if (!m_Resources->LoadShader("bloom_frag", ShaderStage::Fragment, "Bloom.frag"))
+		// fp16 builds for the HalfPrecision variants (ShaderVariant.hpp); a
+		// pipeline without one keeps its fp32 module in those variants
+		if (m_Device->SupportsFeature("shader_float16"))
 		{
-			LOG_ERROR("Failed to load bloom fragment shader");
-			return false;
+			if (!m_Resources->LoadShader("grass_frag_fp16", ShaderStage::Fragment, GetShaderBuildName("Grass.frag", ShaderBuild::HalfPrecision)) ||
+				!m_Resources->LoadShader("postprocess_frag_fp16", ShaderStage::Fragment, GetShaderBuildName("PostProcess.frag", ShaderBuild::HalfPrecision)))
+			{
+				LOG_WARN("Failed to load fp16 shader builds - those passes shade in fp32");
+			}
+		}
+
+		// Ray-query builds for the RayQueryShadow variants; without one a
+		// lit pipeline's variant fails to build and the cascades stay on
+		if (m_Device->SupportsFeature("ray_query"))
+		{
+			const bool bindlessFrag = !m_Resources->GetShader("mesh_bindless_frag") ||
+				m_Resources->LoadShader("mesh_bindless_frag_rayquery", ShaderStage::Fragment, GetShaderBuildName("MeshBindless.frag", ShaderBuild::RayQuery));
+			if (!bindlessFrag ||
+				!m_Resources->LoadShader("mesh_frag_rayquery", ShaderStage::Fragment, GetShaderBuildName("Mesh.frag", ShaderBuild::RayQuery)) ||
+				!m_Resources->LoadShader("terrain_frag_rayquery", ShaderStage::Fragment, GetShaderBuildName("Terrain.frag", ShaderBuild::RayQuery)) ||
+				!m_Resources->LoadShader("grass_frag_rayquery", ShaderStage::Fragment, GetShaderBuildName("Grass.frag", ShaderBuild::RayQuery)))
+			{
+				LOG_WARN("Failed to load ray-query shader builds - sun shadows stay cascaded");
+			}
+		}
+
+		if (!m_Resources->LoadShader("postprocess_copy_frag", ShaderStage::Fragment, "PostProcessCopy.frag"))
+		{
+			LOG_WARN("Failed to load post-process copy shader - continuing without the compute post pass");
 		}
 
 
@@ -764,6 +1728,205 @@ namespace Nightbloom
 		return static_cast<VulkanDevice*>(m_Device.get())->GetDevice();
 	}
 
+	VkPipelineCache Renderer::GetPipelineCache() const
+	{
+		return static_cast<VulkanDevice*>(m_Device.get())->GetPipelineCache();
+	}
+
+	uint32_t Renderer::GetCurrentFrameIndex() const
+	{
+		return m_FrameSync ? m_FrameSync->GetCurrentFrame() : 0;
+	}
+
+	void Renderer::SetFramesInFlight(uint32_t count)
+	{
+		count = std::clamp(count, 1u, MAX_FRAMES_IN_FLIGHT);
+		if (!m_FrameSync)
+		{
+			m_FramesInFlight = count;
+			return;
+		}
+		m_PendingFramesInFlight = (count != m_FrameSync->GetFramesInFlight()) ? count : 0;
+	}
+
+	uint32_t Renderer::GetFramesInFlight() const
+	{
+		if (m_PendingFramesInFlight != 0)
+			return m_PendingFramesInFlight;
+		return m_FrameSync ? m_FrameSync->GetFramesInFlight() : m_FramesInFlight;
+	}
+
+	void Renderer::SetPresentMode(VkPresentModeKHR mode)
+	{
+		if (!m_Swapchain || mode == m_Swapchain->GetRequestedPresentMode())
+			return;
+		m_Swapchain->SetPresentMode(mode);
+		m_PresentModeChangePending = true;
+	}
+
+	VkPresentModeKHR Renderer::GetPresentMode() const
+	{
+		return m_Swapchain ? m_Swapchain->GetPresentMode() : VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	const std::vector<VkPresentModeKHR>& Renderer::GetSupportedPresentModes() const
+	{
+		static const std::vector<VkPresentModeKHR> s_FifoOnly = { VK_PRESENT_MODE_FIFO_KHR };
+		return m_Swapchain ? m_Swapchain->GetSupportedPresentModes() : s_FifoOnly;
+	}
+
+	void Renderer::SetLowLatencyMode(bool enabled)
+	{
+		if (m_FrameSync)
+		{
+			m_FrameSync->SetLowLatencyMode(enabled);
+			LOG_INFO("Low-latency mode: {}", enabled ? "on" : "off");
+		}
+	}
+
+	bool Renderer::IsLowLatencyMode() const
+	{
+		return m_FrameSync && m_FrameSync->IsLowLatencyMode();
+	}
+
+	void Renderer::WaitForLowLatencyStart()
+	{
+		if (!m_Initialized || !m_FrameSync->IsLowLatencyMode())
+			return;
+
+		// Last frame's GPU time; one frame-in-flight cycle old, close enough for a schedule
+		const float gpuMs = (m_GpuProfiler && m_GpuProfiler->IsSupported()) ? m_GpuProfiler->GetTotalMs() : 0.0f;
+		m_FrameSync->LowLatencyWait(m_Swapchain.get(), gpuMs);
+	}
+
+	void Renderer::SetFrameInputTime(std::chrono::steady_clock::time_point time)
+	{
+		if (m_FrameSync)
+			m_FrameSync->SetFrameInputTime(time);
+	}
+
+	bool Renderer::SupportsPresentWait() const
+	{
+		return m_Swapchain && m_Swapchain->SupportsPresentWait();
+	}
+
+	void Renderer::SetDynamicResolution(const DynamicResolutionSettings& settings)
+	{
+		const DynamicResolutionSettings& current = m_DynamicResolution.GetSettings();
+		if (settings.enabled != current.enabled)
+			LOG_INFO("Dynamic resolution: {}", settings.enabled ? "on" : "off");
+
+		m_DynamicResolution.SetSettings(settings);
+		m_DynamicResolution.Reset();
+	}
+
+	void Renderer::UpdateRenderExtent()
+	{
+		// Latest GPU time read back (a frame-in-flight cycle old or more); the
+		// controller allows for that lag
+		const float gpuMs = (m_GpuProfiler && m_GpuProfiler->IsSupported()) ? m_GpuProfiler->GetTotalMs() : 0.0f;
+		const float scale = m_DynamicResolution.Update(gpuMs);
+
+		const VkExtent2D full = m_RenderPasses->GetSceneExtent();
+		m_RenderExtent.width = std::clamp(static_cast<uint32_t>(std::lround(full.width * scale)), 1u, full.width);
+		m_RenderExtent.height = std::clamp(static_cast<uint32_t>(std::lround(full.height * scale)), 1u, full.height);
+	}
+
+	glm::vec2 Renderer::GetSceneUVScale() const
+	{
+		const VkExtent2D full = m_RenderPasses->GetSceneExtent();
+		if (full.width == 0 || full.height == 0 || m_RenderExtent.width == 0)
+			return glm::vec2(1.0f);
+		return glm::vec2(
+			static_cast<float>(m_RenderExtent.width) / static_cast<float>(full.width),
+			static_cast<float>(m_RenderExtent.height) / static_cast<float>(full.height));
+	}
+
+	void Renderer::SetTemporalUpscaling(bool enabled)
+	{
+		if (!m_TemporalUpscaler)
+		{
+			if (enabled)
+				LOG_WARN("Temporal upscaling unavailable on this device");
+			return;
+		}
+		if (enabled != m_TemporalUpscaler->IsEnabled())
+			LOG_INFO("Temporal upscaling: {}", enabled ? "on" : "off");
+		m_TemporalUpscaler->SetEnabled(enabled);
+	}
+
+	bool Renderer::IsTemporalUpscaling() const
+	{
+		return m_TemporalUpscaler && m_TemporalUpscaler->IsEnabled();
+	}
+
+	void Renderer::ResetTemporalHistory()
+	{
+		if (m_TemporalUpscaler)
+			m_TemporalUpscaler->ResetHistory();
+	}
+
+	bool Renderer::ApplyFramesInFlight(uint32_t count)
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		const uint32_t imageCount = static_cast<uint32_t>(m_Swapchain->GetImages().size());
+
+		// Nothing may still be using the old semaphores
+		m_Device->WaitForIdle();
+		m_FrameSync->Cleanup(vkDevice->GetDevice());
+
+		if (!m_FrameSync->Initialize(vkDevice->GetDevice(), vkDevice->GetGraphicsTimeline(), imageCount, count))
+		{
+			LOG_ERROR("Failed to switch to {} frames in flight, keeping {}", count, m_FramesInFlight);
+			m_FrameSync->Cleanup(vkDevice->GetDevice());
+			return m_FrameSync->Initialize(vkDevice->GetDevice(), vkDevice->GetGraphicsTimeline(), imageCount, m_FramesInFlight);
+		}
+
+		m_FramesInFlight = count;
+		LOG_INFO("Frames in flight: {}", count);
+		return true;
+	}
+
+	bool Renderer::IsGpuDefragmenting() const
+	{
+		return m_GpuDefragRequested || (m_MemoryManager && m_MemoryManager->IsDefragmenting());
+	}
+
+	void Renderer::StepGpuDefragmentation()
+	{
+		if (!m_MemoryManager || (!m_GpuDefragRequested && !m_MemoryManager->IsDefragmenting()))
+			return;
+
+		// Bounded so a pass is a short hitch, not a long one
+		constexpr VkDeviceSize MAX_BYTES_PER_PASS = 32ull * 1024 * 1024;
+		constexpr uint32_t MAX_MOVES_PER_PASS = 64;
+
+		if (m_GpuDefragRequested)
+		{
+			m_GpuDefragRequested = false;
+			if (!m_MemoryManager->BeginDefragmentation(MAX_BYTES_PER_PASS, MAX_MOVES_PER_PASS))
+				return;
+		}
+
+		// Nothing may use a buffer while it moves: open upload batches are
+		// submitted (they name the old handles) and every queue drains
+		if (VulkanUploadManager* uploads = m_Resources->GetUploadManager())
+		{
+			uploads->Flush();
+			uploads->WaitAll();
+		}
+		WaitForIdle();
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		{
+			VulkanSingleTimeCommand cmd(vkDevice, m_Resources->GetTransferCommandPool());
+			m_MemoryManager->RecordDefragmentationPass(cmd.Begin());
+			cmd.End();
+		}
+
+		m_MemoryManager->EndDefragmentationPass();
+	}
+
 	void Renderer::TogglePipeline()
 	{
 		if (!m_PipelineAdapter)
@@ -772,9 +1935,6 @@ namespace Nightbloom
 			return;
 		}
 
-		// Wait for device to be idle
-		m_Device->WaitForIdle();
-
 		// Toggle between Triangle and Mesh pipelines
 		if (m_CurrentPipeline == PipelineType::Triangle)
 		{
@@ -803,18 +1963,38 @@ namespace Nightbloom
 			return;
 		}
 
-		LOG_INFO("Reloading all shaders...");
+		// No WaitForIdle: pipelines compile on worker threads while the
+		// current ones keep rendering, and BeginFrame swaps them in
+		LOG_INFO("Reloading all shaders in the background...");
 
-		m_Device->WaitForIdle();
+		if (!m_PipelineAdapter->ReloadAllPipelinesAsync())
+		{
+			LOG_ERROR("Failed to start shader reload");
+		}
+	}
 
-		if (m_PipelineAdapter->ReloadAllPipelines())
+	bool Renderer::SetAssetHotReload(bool enabled)
+	{
+		if (!enabled)
 		{
-			LOG_INFO("Shaders reloaded successfully");
+			m_HotReload.reset();
+			return true;
 		}
-		else
+		if (m_HotReload)
+			return true;
+		if (!m_AssetLoader)
+		{
+			LOG_WARN("Asset hot reload needs the async asset loader");
+			return false;
+		}
+
+		m_HotReload = std::make_unique<AssetHotReload>();
+		if (!m_HotReload->Initialize(m_Resources.get(), m_AssetLoader.get(), m_PipelineAdapter.get()))
 		{
-			LOG_ERROR("Failed to reload shaders");
+			m_HotReload.reset();
+			return false;
 		}
+		return true;
 	}
 
 	bool Renderer::InitializeCore()
@@ -838,6 +2018,13 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Pipeline cache next to the working directory; running without it
+		// only costs startup time
+		static_cast<VulkanDevice*>(m_Device.get())->InitializePipelineCache((execPath / "PipelineCache").string());
+
+		// Cooked glTF imports (MeshCache.hpp) go beside it
+		GLTFLoader::SetCookedCacheDirectory((execPath / "MeshCache").string());
+
 		// Display device capabilities
 		LOG_INFO("=== Device Capabilities ===");
 		LOG_INFO("Min Uniform Buffer Alignment: {} bytes",
@@ -873,7 +2060,8 @@ namespace Nightbloom
 
 		// Initialize frame synchronization
 		m_FrameSync = std::make_unique<FrameSyncManager>();
-		if (!m_FrameSync->Initialize(vkDevice->GetDevice(), m_Swapchain->GetImages().size()))
+		if (!m_FrameSync->Initialize(vkDevice->GetDevice(), vkDevice->GetGraphicsTimeline(),
+			static_cast<uint32_t>(m_Swapchain->GetImages().size()), m_FramesInFlight))
 		{
 			LOG_ERROR("Failed to initialize frame synchronization");
 			return false;
@@ -886,13 +2074,36 @@ namespace Nightbloom
 		// bandwidth/resolve cost. Bump the cap to VK_SAMPLE_COUNT_4_BIT here if
 		// you want maximum edge quality and can spare the fill cost.
 		VkSampleCountFlagBits sceneSamples = vkDevice->GetMaxUsableSampleCount(VK_SAMPLE_COUNT_2_BIT);
+		// The reflection is rippled by the water normal before anyone sees it,
+		// so its edges don't need MSAA: single-sample saves the MS targets and
+		// the resolve (the pass then binds its own pipeline twins).
+		const VkSampleCountFlagBits reflectionSamples = VK_SAMPLE_COUNT_1_BIT;
+		// MAX keeps each pixel's nearest sample (reverse-Z), which is what the
+		// temporal upscale's reprojection wants; without the resolve it reads
+		// the MS depth itself (TemporalUpscaleMS).
+		const VkResolveModeFlagBits depthResolve =
+			(vkDevice->GetSupportedDepthResolveModes() & VK_RESOLVE_MODE_MAX_BIT)
+			? VK_RESOLVE_MODE_MAX_BIT : VK_RESOLVE_MODE_NONE;
+		// With fragment shading rate the scene and reflection passes carry a
+		// rate attachment ({0, 0} without: plain passes). With dynamic
+		// rendering the post-process pass has no framebuffers to rebuild.
 		m_RenderPasses = std::make_unique<RenderPassManager>();
-		if (!m_RenderPasses->Initialize(vkDevice->GetDevice(), m_Swapchain.get(), m_MemoryManager.get(), sceneSamples))
+		if (!m_RenderPasses->Initialize(vkDevice->GetDevice(), m_Swapchain.get(), m_MemoryManager.get(),
+			vkDevice->GetSamplerCache(), sceneSamples,
+			vkDevice->GetShadingRateTexelSize(),
+			vkDevice->SupportsFeature("dynamic_rendering"),
+			reflectionSamples, depthResolve,
+			vkDevice->SupportsStorageImageFormat(RenderPassManager::SCENE_COLOR_FORMAT)))
 		{
 			LOG_ERROR("Failed to initialize render passes");
 			return false;
 		}
-		LOG_INFO("Scene pass MSAA: {}x", static_cast<int>(sceneSamples));
+		LOG_INFO("Scene pass MSAA: {}x (reflection {}x, depth resolve: {})", static_cast<int>(sceneSamples),
+			static_cast<int>(m_RenderPasses->GetReflectionSampleCount()), m_RenderPasses->HasDepthResolve());
+
+		// No region yet: the scene fills the window its targets were made for
+		m_SceneViewport.Update(glm::uvec2(m_Swapchain->GetExtent().width, m_Swapchain->GetExtent().height),
+			glm::uvec2(m_RenderPasses->GetSceneExtent().width, m_RenderPasses->GetSceneExtent().height));
 
 		// Initialize resources
 		m_Resources = std::make_unique<ResourceManager>();
@@ -913,51 +2124,84 @@ namespace Nightbloom
 		// TODO: consider changing this to be part of the initialize function for resourcemanager
 		m_Resources->SetDescriptorManager(m_DescriptorManager.get());
 
-		// Create uniform buffers for each frame in flight
-		LOG_INFO("Creating frame uniform buffers");
-		for (uint32_t i = 0; i < 2; ++i)  // 2 = MAX_FRAMES_IN_FLIGHT
+		// Per-frame uniforms: one slot each in the frame upload buffer, at
+		// the same offset in every frame's region, so each descriptor set
+		// points at its frame's copy once and is never rewritten
+		LOG_INFO("Creating frame upload buffer");
+		m_FrameUploads = std::make_unique<VulkanFrameUploadBuffer>();
+		if (!m_FrameUploads->Initialize(m_MemoryManager.get(), FRAME_UPLOAD_REGION_SIZE,
+			m_Device->GetMinUniformBufferAlignment()))
 		{
-			std::string bufferName = "FrameUniform_" + std::to_string(i);
-			m_FrameUniforms[i] = m_Resources->CreateUniformBuffer(
-				bufferName,
-				sizeof(FrameUniformData)
-			);
+			LOG_ERROR("Failed to create frame upload buffer");
+			return false;
+		}
+		const VkBuffer uploadBuffer = m_FrameUploads->GetBuffer();
 
-			if (!m_FrameUniforms[i])
-			{
-				LOG_ERROR("Failed to create uniform buffer for frame {}", i);
-				return false;
-			}
+		m_FrameUniformSlot = m_FrameUploads->Reserve("FrameUniform", sizeof(FrameUniformData));
+		m_LightingUniformSlot = m_FrameUploads->Reserve("LightingUniform", sizeof(SceneLightingData));
+		if (!m_FrameUniformSlot.IsValid() || !m_LightingUniformSlot.IsValid())
+			return false;
 
-			// Update descriptor set with this buffer
-			m_DescriptorManager->UpdateUniformSet(i,
-				m_FrameUniforms[i]->GetBuffer(),
-				sizeof(FrameUniformData));
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_DescriptorManager->UpdateUniformSet(i, uploadBuffer,
+				sizeof(FrameUniformData), m_FrameUploads->GetOffset(i, m_FrameUniformSlot));
+			m_DescriptorManager->UpdateLightingSet(i, uploadBuffer,
+				sizeof(SceneLightingData), m_FrameUploads->GetOffset(i, m_LightingUniformSlot));
+		}
+		LOG_INFO("Frame and lighting uniforms created");
+
+		// Clustered point lights - bindings 1-2 of the lighting sets, which
+		// every lit pipeline binds, so the buffers must exist either way
+		m_LightClusters = std::make_unique<LightClusterCuller>();
+		if (!m_LightClusters->Initialize(static_cast<VulkanDevice*>(m_Device.get()), m_Resources.get(),
+			m_DescriptorManager.get()))
+		{
+			LOG_ERROR("Failed to create light cluster buffers");
+			return false;
 		}
-		LOG_INFO("Frame uniform buffers created");
 
-		// Create lighting uniform buffers for each frame in flight
-		LOG_INFO("Creating lighting uniform buffers");
-		for (uint32_t i = 0; i < 2; ++i)
+		// The wind field - binding 2 of every uniform set, which grass and
+		// water bind, so the texture must exist either way
+		m_WindField = std::make_unique<WindField>();
+		if (!m_WindField->Initialize(vkDevice, m_MemoryManager.get(), m_DescriptorManager.get()))
 		{
-			std::string bufferName = "LightingUniform_" + std::to_string(i);
-			m_LightingUniforms[i] = m_Resources->CreateUniformBuffer(
-				bufferName,
-				sizeof(SceneLightingData)
-			);
+			LOG_ERROR("Failed to create wind field");
+			return false;
+		}
+
+		// The atmosphere LUTs - bindings 3 and 4 of every uniform set, which
+		// the sky and terrain bind, so they must exist either way
+		m_AtmosphereLuts = std::make_unique<AtmosphereLuts>();
+		if (!m_AtmosphereLuts->Initialize(vkDevice, m_MemoryManager.get(), m_DescriptorManager.get()))
+		{
+			LOG_ERROR("Failed to create atmosphere LUTs");
+			return false;
+		}
+
+		// The environment probe - binding 7 of every uniform set, which the
+		// meshes bind, so it must exist either way
+		m_EnvironmentProbe = std::make_unique<EnvironmentProbeCache>();
+		if (!m_EnvironmentProbe->Initialize(vkDevice, m_MemoryManager.get(), m_DescriptorManager.get()))
+		{
+			LOG_ERROR("Failed to create environment probe");
+			return false;
+		}
 
-			if (!m_LightingUniforms[i])
+		// The render passes' shading-rate attachments must leave UNDEFINED
+		// before their first use, so this exists whenever they do
+		if (m_RenderPasses->HasShadingRateAttachment())
+		{
+			m_VariableRateShading = std::make_unique<VariableRateShading>();
+			if (!m_VariableRateShading->Initialize(vkDevice, m_DescriptorManager.get(),
+				m_RenderPasses->GetShadingRateTexelSize()))
 			{
-				LOG_ERROR("Failed to create lighting uniform buffer for frame {}", i);
+				LOG_ERROR("Failed to initialize variable rate shading");
 				return false;
 			}
-
-			// Update descriptor set with this buffer
-			m_DescriptorManager->UpdateLightingSet(i,
-				m_LightingUniforms[i]->GetBuffer(),
-				sizeof(SceneLightingData));
+			m_VariableRateShading->Resize(m_RenderPasses->GetShadingRateImage(), m_RenderPasses->GetShadingRateImageView(),
+				m_RenderPasses->GetShadingRateExtent(), m_RenderPasses->GetReflectionShadingRateImage());
 		}
-		LOG_INFO("Lighting uniform buffers created");
 
 		// =================================================================
 		// FIX: Create shadow uniform buffers AND point the shadow uniform
@@ -965,50 +2209,90 @@ namespace Nightbloom
 		// view/proj instead of the camera's.
 		// =================================================================
 		LOG_INFO("Creating shadow uniform buffers");
-		for (uint32_t i = 0; i < 2; ++i)
+		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+		{
+			m_ShadowUniformSlots[c] = m_FrameUploads->Reserve("ShadowUniform_c" + std::to_string(c), sizeof(FrameUniformData));
+			if (!m_ShadowUniformSlots[c].IsValid())
+				return false;
+		}
+		m_ShadowLayeredUniformSlot = m_FrameUploads->Reserve("ShadowLayeredUniform", sizeof(glm::mat4) * NUM_CASCADES);
+		if (!m_ShadowLayeredUniformSlot.IsValid())
+			return false;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
+			// Point the shadow uniform descriptor sets at the cascades' slots
 			for (uint32_t c = 0; c < NUM_CASCADES; ++c)
 			{
-				std::string bufferName = "ShadowUniform_f" + std::to_string(i) + "_c" + std::to_string(c);
-				m_ShadowUniforms[i][c] = m_Resources->CreateUniformBuffer(
-					bufferName, sizeof(FrameUniformData));
-
-				if (!m_ShadowUniforms[i][c])
-				{
-					LOG_ERROR("Failed to create shadow uniform buffer for frame {} cascade {}", i, c);
-					return false;
-				}
-
-				// Point the shadow uniform descriptor set at this buffer
-				m_DescriptorManager->UpdateShadowUniformSet(i, c,
-					m_ShadowUniforms[i][c]->GetBuffer(),
-					sizeof(FrameUniformData));
+				m_DescriptorManager->UpdateShadowUniformSet(i, c, uploadBuffer,
+					sizeof(FrameUniformData), m_FrameUploads->GetOffset(i, m_ShadowUniformSlots[c]));
 			}
+
+			m_DescriptorManager->UpdateShadowLayeredUniformSet(i, uploadBuffer,
+				sizeof(glm::mat4) * NUM_CASCADES, m_FrameUploads->GetOffset(i, m_ShadowLayeredUniformSlot));
 		}
 		LOG_INFO("Shadow uniform buffers created");
 
+		// The point light shadow atlas - bindings 2-3 of the shadow sets,
+		// which every lit pipeline binds, so it must exist either way
+		m_LocalShadows = std::make_unique<LocalShadowMaps>();
+		m_LocalShadowUniformSlot = m_FrameUploads->Reserve("LocalShadowUniform", sizeof(LocalShadowUniforms));
+		if (!m_LocalShadowUniformSlot.IsValid() ||
+			!m_LocalShadows->Initialize(vkDevice, m_MemoryManager.get(), m_Resources.get()))
+		{
+			LOG_ERROR("Failed to create the local shadow atlas");
+			return false;
+		}
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_DescriptorManager->UpdateLocalShadowSet(i, m_LocalShadows->GetAtlasView(), m_LocalShadows->GetSampler(),
+				uploadBuffer, sizeof(LocalShadowUniforms), m_FrameUploads->GetOffset(i, m_LocalShadowUniformSlot));
+		}
+
 		// =================================================================
 		// Reflection uniform buffers (set 0 in the planar-reflection pass —
 		// the mirror-flipped camera's view/proj). Same pattern as shadow.
 		// =================================================================
 		LOG_INFO("Creating reflection uniform buffers");
-		for (uint32_t i = 0; i < 2; ++i)
+		m_ReflectionUniformSlot = m_FrameUploads->Reserve("ReflectionUniform", sizeof(FrameUniformData));
+		if (!m_ReflectionUniformSlot.IsValid())
+			return false;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
-			std::string bufferName = "ReflectionUniform_" + std::to_string(i);
-			m_ReflectionUniforms[i] = m_Resources->CreateUniformBuffer(
-				bufferName, sizeof(FrameUniformData));
+			m_DescriptorManager->UpdateReflectionUniformSet(i, uploadBuffer,
+				sizeof(FrameUniformData), m_FrameUploads->GetOffset(i, m_ReflectionUniformSlot));
+		}
+		LOG_INFO("Reflection uniform buffers created");
 
-			if (!m_ReflectionUniforms[i])
-			{
-				LOG_ERROR("Failed to create reflection uniform buffer for frame {}", i);
+		// Auxiliary view uniforms (set 0 in the auxiliary view passes), one
+		// slot per view
+		for (uint32_t view = 0; view < MAX_AUXILIARY_VIEWS; ++view)
+		{
+			m_AuxiliaryUniformSlots[view] = m_FrameUploads->Reserve("AuxiliaryViewUniform" + std::to_string(view),
+				sizeof(FrameUniformData));
+			if (!m_AuxiliaryUniformSlots[view].IsValid())
 				return false;
+
+			for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+			{
+				m_DescriptorManager->UpdateAuxiliaryUniformSet(i, view, uploadBuffer,
+					sizeof(FrameUniformData), m_FrameUploads->GetOffset(i, m_AuxiliaryUniformSlots[view]));
 			}
+		}
 
-			m_DescriptorManager->UpdateReflectionUniformSet(i,
-				m_ReflectionUniforms[i]->GetBuffer(),
-				sizeof(FrameUniformData));
+		// =================================================================
+		// Instance buffers (set 0 binding 1 in the scene, shadow and
+		// reflection passes) and multi-draw parameters. Filled by
+		// BuildInstanceBatches / WriteIndirectDraws each frame.
+		// =================================================================
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (!EnsureDrawBufferCapacity(i, INITIAL_DRAW_INSTANCES, INITIAL_DRAW_INSTANCES))
+				return false;
 		}
-		LOG_INFO("Reflection uniform buffers created");
+		LOG_INFO("Draw buffers created ({} instances per frame, multi-draw {})", INITIAL_DRAW_INSTANCES,
+			m_IndirectDrawBuffers[0] ? "on" : "off");
 
 		// Create test geometry
 		if (!m_Resources->CreateTestCube())
@@ -1035,10 +2319,25 @@ namespace Nightbloom
 			LOG_WARN("Failed to create default textures");
 		}
 
+		// Binding 5 (the cloud shadow map) holds default_black until clouds
+		// bake one, binding 6 (the terrain's sun shadow map) until the terrain does
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			UpdateCloudShadowBinding(i, false);
+			UpdateTerrainShadowBinding(i, false);
+		}
+
+		m_AssetLoader = std::make_unique<AsyncAssetLoader>();
+		if (!m_AssetLoader->Initialize(m_Resources.get(), m_DescriptorManager.get()))
+		{
+			LOG_WARN("Failed to initialize async asset loader");
+			m_AssetLoader.reset();
+		}
+
 
 		// Initialize command recorder
 		m_Commands = std::make_unique<CommandRecorder>();
-		if (!m_Commands->Initialize(vkDevice, m_DescriptorManager.get(), FrameSyncManager::MAX_FRAMES_IN_FLIGHT))
+		if (!m_Commands->Initialize(vkDevice, m_DescriptorManager.get(), MAX_FRAMES_IN_FLIGHT))
 		{
 			LOG_ERROR("Failed to initialize command recorder");
 			return false;
@@ -1047,17 +2346,33 @@ namespace Nightbloom
 		// GPU profiler (timestamp queries). Non-fatal if unsupported.
 		m_GpuProfiler = std::make_unique<GpuProfiler>();
 		m_GpuProfiler->Initialize(vkDevice);
+		if (m_GpuProfiler->IsPipelineStatisticsSupported())
+		{
+			const GpuProfiler::InheritedQueries inherited = m_GpuProfiler->GetInheritedQueries();
+			m_Commands->SetInheritedQueries(inherited.occlusion, inherited.occlusionFlags, inherited.pipelineStatistics);
+		}
+		if (VulkanUploadManager* uploads = m_Resources->GetUploadManager())
+		{
+			uploads->SetProfiler(m_GpuProfiler.get());
+		}
+
+		// Per-frame pass graph (no GPU objects of its own)
+		m_RenderGraph = std::make_unique<RenderGraph>();
 
 		// Initialize UI (optional) — targets the post-process render pass,
 		// not the scene one: UI now draws after the AA composite, directly
 		// onto the swapchain target, so panel text doesn't get blurred by
-		// the filter. ImGui's Vulkan backend builds its own pipeline against
-		// whatever render pass it's given here, so this must match wherever
-		// m_UI->Render() actually gets called (see RecordPostProcessPass).
+		// the filter. UIManager builds its pipelines against whatever render
+		// pass it's given here, so this must match wherever m_UI->Render()
+		// actually gets called (see RecordPostProcessPass). A dynamic
+		// post-process pass has no render pass: the UI pipelines are built
+		// against the swapchain format.
 		m_UI = std::make_unique<UIManager>();
-		if (!m_UI->Initialize(vkDevice, m_WindowHandle,
+		if (!m_UI->Initialize(vkDevice, m_MemoryManager.get(), m_WindowHandle,
 			m_RenderPasses->GetPostProcessRenderPass(),
-			m_Swapchain->GetImageCount()))
+			m_Swapchain->GetImageCount(),
+			m_Swapchain->GetImageFormat(),
+			m_Swapchain->GetExtent()))
 		{
 			LOG_WARN("Failed to initialize UI manager - continuing without UI");
 			m_UI.reset();
@@ -1076,7 +2391,8 @@ namespace Nightbloom
 		if (!m_PipelineAdapter->Initialize(vkDevice->GetDevice(),
 			m_RenderPasses->GetSceneRenderPass(),
 			m_Swapchain->GetExtent(),
-			m_DescriptorManager.get()))
+			m_DescriptorManager.get(),
+			vkDevice->GetPipelineCache()))
 		{
 			LOG_ERROR("Failed to initialize pipeline adapter");
 			return false;
@@ -1086,6 +2402,12 @@ namespace Nightbloom
 		// count (the shadow/post-process passes stay single-sample — handled
 		// per-type inside the adapter). Must be set before any pipeline is created.
 		m_PipelineAdapter->SetSampleCount(m_RenderPasses->GetSampleCount());
+		if (m_RenderPasses->NeedsReflectionPipelines())
+		{
+			m_PipelineAdapter->SetReflectionRenderPass(m_RenderPasses->GetReflectionRenderPass(),
+				m_RenderPasses->GetReflectionSampleCount());
+		}
+		m_Commands->SetReflectionTwins(m_RenderPasses->NeedsReflectionPipelines());
 
 		// LOAD SHADERS FIRST!
 		if (!LoadShaders())
@@ -1093,6 +2415,14 @@ namespace Nightbloom
 			LOG_ERROR("Failed to load shaders");
 			return false;
 		}
+		StartupTimer::Get().Mark("Shaders", StartupTimer::Now());
+
+		// Every CreatePipeline from here to FinishPipelineCreation queues its
+		// build on the job workers (they share the device's pipeline cache,
+		// which is internally synchronized) and reports success up front;
+		// FinishPipelineCreation takes back what a failed build promised
+		m_PipelineCreationStart = StartupTimer::Now();
+		m_PipelineAdapter->BeginParallelCreation();
 
 		// ---- Triangle pipeline -------------------------------------------------------
 		// Create triangle pipeline using shader objects
@@ -1119,17 +2449,29 @@ namespace Nightbloom
 			LOG_INFO("Triangle pipeline created successfully");
 		}
 
+		// Mesh and Transparent read set 1 as the bindless table when the device
+		// supports it (MeshBindless.frag), otherwise a per-draw texture set
+		VulkanShader* bindlessMeshFrag = m_DescriptorManager->IsBindlessEnabled()
+			? m_Resources->GetShader("mesh_bindless_frag") : nullptr;
+		m_BindlessMeshPasses = (bindlessMeshFrag != nullptr);
+		m_Commands->SetBindlessMeshPasses(m_BindlessMeshPasses);
+
+		// The depth prepass needs the twins of all four opaque scene
+		// pipelines: a prepassed draw must find its EQUAL twin in the color pass
+		bool depthPrepassTwins = true;
+
 		// ---- Mesh pipeline -------------------------------------------------------
 		// Create mesh pipeline using shader objects (if shaders loaded)
 		{
 			VulkanShader* vertShader = m_Resources->GetShader("mesh_vert");
-			VulkanShader* fragShader = m_Resources->GetShader("mesh_frag");
+			VulkanShader* fragShader = m_BindlessMeshPasses ? bindlessMeshFrag : m_Resources->GetShader("mesh_frag");
 
 			if (vertShader && fragShader)
 			{
 				PipelineConfig config;
 				config.vertexShader = vertShader;
 				config.fragmentShader = fragShader;
+				config.fragmentShaderRayQuery = m_Resources->GetShader(m_BindlessMeshPasses ? "mesh_bindless_frag_rayquery" : "mesh_frag_rayquery");
 				config.useVertexInput = true;
 				config.topology = PrimitiveTopology::TriangleList;
 				config.polygonMode = PolygonMode::Fill;
@@ -1142,25 +2484,53 @@ namespace Nightbloom
 				config.pushConstantStages = ShaderStage::VertexFragment;
 				config.useUniformBuffer = true;
 				config.useTextures = true;
+				config.useBindlessTextures = m_BindlessMeshPasses;
 				config.useLighting = true;
 				config.useShadowMap = true;
 
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::Mesh, config))
 				{
 					LOG_INFO("Mesh pipeline created successfully");
+					depthPrepassTwins &= CreateDepthPrepassTwins(PipelineType::Mesh, config);
+					CreateReflectionTwin(PipelineType::Mesh, config);
 				}
 				else
 				{
 					LOG_WARN("Failed to create mesh pipeline");
+					depthPrepassTwins = false;
+				}
+
+				// Same pipeline over compressed vertices (VertexPacking.hpp)
+				config.vertexShader = m_Resources->GetShader("mesh_packed_vert");
+				config.vertexFormat = VertexFormat::Packed;
+				if (!config.vertexShader || !m_PipelineAdapter->CreatePipeline(PipelineType::MeshPacked, config))
+				{
+					LOG_WARN("Failed to create packed mesh pipeline");
+					depthPrepassTwins = false;
+				}
+				else
+				{
+					depthPrepassTwins &= CreateDepthPrepassTwins(PipelineType::MeshPacked, config);
+					CreateReflectionTwin(PipelineType::MeshPacked, config);
 				}
 			}
+			else
+			{
+				depthPrepassTwins = false;
+			}
 		}
 
+		// Order-independent transparency needs an accumulating twin of every
+		// pipeline that draws in the transparency pass, in its render pass
+		VkRenderPass oitRenderPass = m_RenderPasses->GetOitRenderPass();
+		m_PipelineAdapter->SetOitRenderPass(oitRenderPass);
+		bool oitTwins = (oitRenderPass != VK_NULL_HANDLE);
+
 		// ---- Transparent pipeline -------------------------------------------------------
 		{
 			PipelineConfig transparentConfig;
 			transparentConfig.vertexShaderPath = "Mesh.vert";
-			transparentConfig.fragmentShaderPath = "Mesh.frag";  // Same shader for now
+			transparentConfig.fragmentShaderPath = m_BindlessMeshPasses ? "MeshBindless.frag" : "Mesh.frag";  // Same shader for now
 			transparentConfig.useVertexInput = true;
 			transparentConfig.topology = PrimitiveTopology::TriangleList;
 			transparentConfig.polygonMode = PolygonMode::Fill;
@@ -1178,6 +2548,7 @@ namespace Nightbloom
 
 			transparentConfig.useUniformBuffer = true;
 			transparentConfig.useTextures = true;
+			transparentConfig.useBindlessTextures = m_BindlessMeshPasses;
 			transparentConfig.useLighting = true;
 			transparentConfig.pushConstantSize = sizeof(PushConstantData);
 			transparentConfig.pushConstantStages = ShaderStage::VertexFragment;
@@ -1187,6 +2558,18 @@ namespace Nightbloom
 			{
 				LOG_ERROR("Failed to create Transparent pipeline");
 			}
+
+			const char* oitFrag = m_BindlessMeshPasses ? "MeshBindlessOit.frag" : "MeshOit.frag";
+			oitTwins = oitTwins && CreateOitTwin(PipelineType::Transparent, transparentConfig, oitFrag);
+
+			transparentConfig.vertexShaderPath = "MeshPacked.vert";
+			transparentConfig.vertexFormat = VertexFormat::Packed;
+			if (!m_PipelineAdapter->CreatePipeline(PipelineType::TransparentPacked, transparentConfig))
+			{
+				LOG_ERROR("Failed to create packed Transparent pipeline");
+			}
+
+			oitTwins = oitTwins && CreateOitTwin(PipelineType::TransparentPacked, transparentConfig, oitFrag);
 		}
 
 		// ---- Terrain pipeline -------------------------------------------------------
@@ -1199,7 +2582,10 @@ namespace Nightbloom
 				PipelineConfig terrainConfig;
 				terrainConfig.vertexShader = terrainVert;
 				terrainConfig.fragmentShader = terrainFrag;
-				terrainConfig.useVertexInput = true;
+				terrainConfig.fragmentShaderRayQuery = m_Resources->GetShader("terrain_frag_rayquery");
+				// Index-only patch grid: the vertex shader places each vertex
+				// from gl_VertexIndex (grid_vertex.glsl)
+				terrainConfig.useVertexInput = false;
 				terrainConfig.topology = PrimitiveTopology::TriangleList;
 				terrainConfig.polygonMode = PolygonMode::Fill;
 				terrainConfig.cullMode = CullMode::Back;
@@ -1221,18 +2607,47 @@ namespace Nightbloom
 				terrainConfig.useShadowMap = true;
 				terrainConfig.useHeightmap = true;   // <-- new flag (set 4)
 
+				// Far terrain may shade per 2x2 (VariableRateShading)
+				terrainConfig.coarseShading = m_RenderPasses->HasShadingRateAttachment();
+
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::Terrain, terrainConfig))
 				{
 					LOG_INFO("Terrain pipeline created successfully");
+					depthPrepassTwins &= CreateDepthPrepassTwins(PipelineType::Terrain, terrainConfig);
+					CreateReflectionTwin(PipelineType::Terrain, terrainConfig);
+
+					// Tessellated twin (TerrainDesc::tessellation): same sets and
+					// fragment shader; TerrainTess.vert places the coarse grid as
+					// Terrain.vert does and the tessellation stages refine it.
+					// Its own depth prepass twins, since EQUAL needs the prepass
+					// to have drawn the same triangles.
+					if (m_Device->SupportsFeature("tessellation"))
+					{
+						PipelineConfig tessConfig = terrainConfig;
+						tessConfig.vertexShader = nullptr;
+						tessConfig.vertexShaderPath = "TerrainTess.vert";
+						tessConfig.tessControlShaderPath = "TerrainTess.tesc";
+						tessConfig.tessEvalShaderPath = "TerrainTess.tese";
+						tessConfig.topology = PrimitiveTopology::PatchList;
+						tessConfig.patchControlPoints = 3;
+
+						m_TerrainTessellationSupported =
+							m_PipelineAdapter->CreatePipeline(PipelineType::TerrainTessellated, tessConfig) &&
+							(!depthPrepassTwins || CreateDepthPrepassTwins(PipelineType::TerrainTessellated, tessConfig));
+						if (!m_TerrainTessellationSupported)
+							LOG_WARN("Failed to create tessellated terrain pipeline - terrain draws its full patch grid");
+					}
 				}
 				else
 				{
 					LOG_WARN("Failed to create terrain pipeline � terrain will not render");
+					depthPrepassTwins = false;
 				}
 			}
 			else
 			{
 				LOG_WARN("Terrain shaders not found - skipping terrain pipeline");
+				depthPrepassTwins = false;
 			}
 		}
 
@@ -1246,6 +2661,8 @@ namespace Nightbloom
 				PipelineConfig grassConfig;
 				grassConfig.vertexShader = grassVert;
 				grassConfig.fragmentShader = grassFrag;
+				grassConfig.fragmentShaderHalf = m_Resources->GetShader("grass_frag_fp16");
+				grassConfig.fragmentShaderRayQuery = m_Resources->GetShader("grass_frag_rayquery");
 
 				// Real blade mesh (VertexPNT-shaped), instanced via gl_InstanceIndex
 				// reading the foliage storage buffer - not procedural like Firefly.
@@ -1262,7 +2679,7 @@ namespace Nightbloom
 				grassConfig.depthWriteEnable = true;
 				grassConfig.depthCompareOp = CompareOp::GreaterOrEqual;
 
-				// customData = (slopeThreshold, heightScale, worldSize, windStrength)
+				// customData = (slopeThresholdCos, windStrength, -, -); see Grass.vert
 				grassConfig.pushConstantSize = sizeof(PushConstantData);
 				grassConfig.pushConstantStages = ShaderStage::VertexFragment;
 
@@ -1276,21 +2693,34 @@ namespace Nightbloom
 				grassConfig.useShadowMap = true;
 				grassConfig.useHeightmap = true;
 
+				// Far blades may shade per 2x2 (VariableRateShading)
+				grassConfig.coarseShading = m_RenderPasses->HasShadingRateAttachment();
+
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::Foliage, grassConfig))
 				{
 					LOG_INFO("Foliage pipeline created successfully");
+					depthPrepassTwins &= CreateDepthPrepassTwins(PipelineType::Foliage, grassConfig);
+					CreateReflectionTwin(PipelineType::Foliage, grassConfig);
 				}
 				else
 				{
 					LOG_WARN("Failed to create foliage pipeline - grass will not render");
+					depthPrepassTwins = false;
 				}
 			}
 			else
 			{
 				LOG_WARN("Grass shaders not found - skipping foliage pipeline");
+				depthPrepassTwins = false;
 			}
 		}
 
+		m_DepthPrepassSupported = depthPrepassTwins;
+		if (!m_DepthPrepassSupported)
+		{
+			LOG_WARN("Depth prepass unavailable - not every opaque pipeline has its depth/EQUAL twins");
+		}
+
 		// ---- Clouds pipeline --------------------------------------------------------
 		{
 			VulkanShader* cloudsVert = m_Resources->GetShader("clouds_vert");
@@ -1329,9 +2759,14 @@ namespace Nightbloom
 				// the low-res result and composites it).
 				cloudsConfig.useCloudResult = true;
 
+				// The composite upsamples a low-res result: sky tiles shade
+				// per 2x2 (VariableRateShading)
+				cloudsConfig.coarseShading = m_RenderPasses->HasShadingRateAttachment();
+
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::Clouds, cloudsConfig))
 				{
 					LOG_INFO("Clouds pipeline created successfully");
+					CreateReflectionTwin(PipelineType::Clouds, cloudsConfig);
 				}
 				else
 				{
@@ -1344,6 +2779,53 @@ namespace Nightbloom
 			}
 		}
 
+		// ---- Sky pipeline -----------------------------------------------------------
+		{
+			// Clouds.vert's full-screen triangle at the far plane; Sky.frag
+			// looks the atmosphere's sky-view LUT up per pixel
+			VulkanShader* skyVert = m_Resources->GetShader("clouds_vert");
+			VulkanShader* skyFrag = m_Resources->GetShader("sky_frag");
+
+			if (skyVert && skyFrag)
+			{
+				PipelineConfig skyConfig;
+				skyConfig.vertexShader = skyVert;
+				skyConfig.fragmentShader = skyFrag;
+				skyConfig.useVertexInput = false;
+				skyConfig.topology = PrimitiveTopology::TriangleList;
+				skyConfig.polygonMode = PolygonMode::Fill;
+				skyConfig.cullMode = CullMode::None;
+				skyConfig.frontFace = FrontFace::CounterClockwise;
+
+				// Drawn first (DrawSortKey), so it only covers what the depth
+				// prepass, when on, left at the far plane; writes no depth
+				skyConfig.depthTestEnable = true;
+				skyConfig.depthWriteEnable = false;
+				skyConfig.depthCompareOp = CompareOp::GreaterOrEqual;
+				skyConfig.blendEnable = false;
+
+				// Set 0 only: the frame's atmosphere and the sky-view LUT
+				skyConfig.useUniformBuffer = true;
+
+				// A smooth gradient: sky tiles shade per 2x2 (VariableRateShading)
+				skyConfig.coarseShading = m_RenderPasses->HasShadingRateAttachment();
+
+				if (m_PipelineAdapter->CreatePipeline(PipelineType::Skybox, skyConfig))
+				{
+					LOG_INFO("Sky pipeline created successfully");
+					CreateReflectionTwin(PipelineType::Skybox, skyConfig);
+				}
+				else
+				{
+					LOG_WARN("Failed to create sky pipeline - the sky stays the clear colour");
+				}
+			}
+			else
+			{
+				LOG_WARN("Sky shaders not found - skipping sky pipeline");
+			}
+		}
+
 		// ---- Water pipeline ---------------------------------------------------------
 		{
 			VulkanShader* waterVert = m_Resources->GetShader("water_vert");
@@ -1355,9 +2837,9 @@ namespace Nightbloom
 				waterConfig.vertexShader = waterVert;
 				waterConfig.fragmentShader = waterFrag;
 
-				// Flat VertexPNT plane (reuses the terrain grid generator). Same
-				// CCW winding as the terrain mesh, so standard back-face cull.
-				waterConfig.useVertexInput = true;
+				// Index-only grid placed from gl_VertexIndex, like the terrain
+				// patches. Same CCW winding, so standard back-face cull.
+				waterConfig.useVertexInput = false;
 				waterConfig.topology = PrimitiveTopology::TriangleList;
 				waterConfig.polygonMode = PolygonMode::Fill;
 				waterConfig.cullMode = CullMode::Back;
@@ -1379,17 +2861,20 @@ namespace Nightbloom
 				waterConfig.pushConstantStages = ShaderStage::VertexFragment;
 
 				// Descriptor sets: 0=uniform (scene camera), 1=lighting (sun for
-				// Fresnel/specular), 2=reflection target. useReflectionInput is
-				// pushed last in the adapter's layout chain so, with only these
-				// three flags set, it lands at set 2 — see Water.frag's
-				// layout(set=N) decls and CommandRecorder's Water binding block.
+				// Fresnel/specular), 2=reflection target, 3=FFT wave maps.
+				// useReflectionInput and useOceanWaves are pushed last in the
+				// adapter's layout chain so, with only these flags set, they
+				// land at sets 2 and 3 — see Water.vert/.frag's layout(set=N)
+				// decls and CommandRecorder's Water binding block.
 				waterConfig.useUniformBuffer = true;
 				waterConfig.useLighting = true;
 				waterConfig.useReflectionInput = true;
+				waterConfig.useOceanWaves = true;
 
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::Water, waterConfig))
 				{
 					LOG_INFO("Water pipeline created successfully");
+					oitTwins = oitTwins && CreateOitTwin(PipelineType::Water, waterConfig, "WaterOit.frag");
 				}
 				else
 				{
@@ -1439,11 +2924,36 @@ namespace Nightbloom
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::Firefly, fireflyConfig))
 				{
 					LOG_INFO("Firefly pipeline created successfully");
+					oitTwins = oitTwins && CreateOitTwin(PipelineType::Firefly, fireflyConfig, "FireflyOit.frag");
 				}
 				else
 				{
 					LOG_WARN("Failed to create firefly pipeline - fireflies will not render");
 				}
+
+				// Distant fireflies as single points (FireflySystem's draw cull),
+				// same state; customData.x = the render target height, for
+				// gl_PointSize. Only worth it when points can be wider than a pixel.
+				VulkanShader* pointVert = m_Resources->GetShader("firefly_point_vert");
+				VulkanShader* pointFrag = m_Resources->GetShader("firefly_point_frag");
+				if (pointVert && pointFrag && m_Device->SupportsFeature("large_points"))
+				{
+					PipelineConfig pointConfig = fireflyConfig;
+					pointConfig.vertexShader = pointVert;
+					pointConfig.fragmentShader = pointFrag;
+					pointConfig.topology = PrimitiveTopology::PointList;
+					pointConfig.pushConstantSize = sizeof(PushConstantData);
+					pointConfig.pushConstantStages = ShaderStage::VertexFragment;
+
+					if (m_PipelineAdapter->CreatePipeline(PipelineType::FireflyPoint, pointConfig))
+					{
+						oitTwins = oitTwins && CreateOitTwin(PipelineType::FireflyPoint, pointConfig, "FireflyPointOit.frag");
+					}
+					else
+					{
+						LOG_WARN("Failed to create firefly point pipeline - distant fireflies stay billboards");
+					}
+				}
 			}
 			else
 			{
@@ -1451,6 +2961,100 @@ namespace Nightbloom
 			}
 		}
 
+		// ---- Particle pipeline ------------------------------------------------------
+		// ParticleSystem's emitters, one draw each. Premultiplied blend, so
+		// the shader picks additive (alpha 0) or translucent per emitter.
+		{
+			VulkanShader* particleVert = m_Resources->GetShader("particle_vert");
+			VulkanShader* particleFrag = m_Resources->GetShader("particle_frag");
+
+			if (particleVert && particleFrag)
+			{
+				PipelineConfig particleConfig;
+				particleConfig.vertexShader = particleVert;
+				particleConfig.fragmentShader = particleFrag;
+
+				// No vertex/index buffer - Particle.vert builds the billboards
+				particleConfig.useVertexInput = false;
+				particleConfig.topology = PrimitiveTopology::TriangleList;
+				particleConfig.polygonMode = PolygonMode::Fill;
+				particleConfig.cullMode = CullMode::None;
+				particleConfig.frontFace = FrontFace::CounterClockwise;
+
+				particleConfig.depthTestEnable = true;
+				particleConfig.depthWriteEnable = false;
+				particleConfig.depthCompareOp = CompareOp::GreaterOrEqual;
+
+				particleConfig.blendEnable = true;
+				particleConfig.srcColorBlendFactor = BlendFactor::One;
+				particleConfig.dstColorBlendFactor = BlendFactor::OneMinusSrcAlpha;
+
+				// Colors, sizes and the emitter's slice per draw
+				particleConfig.pushConstantSize = sizeof(PushConstantData);
+				particleConfig.pushConstantStages = ShaderStage::VertexFragment;
+
+				// Descriptor sets: 0=uniform (camera), 1=particle pool storage
+				particleConfig.useUniformBuffer = true;
+				particleConfig.useParticleStorage = true;
+
+				if (m_PipelineAdapter->CreatePipeline(PipelineType::Particle, particleConfig))
+				{
+					LOG_INFO("Particle pipeline created successfully");
+					oitTwins = oitTwins && CreateOitTwin(PipelineType::Particle, particleConfig, "ParticleOit.frag");
+				}
+				else
+				{
+					LOG_WARN("Failed to create particle pipeline - particles will not render");
+				}
+			}
+			else
+			{
+				LOG_WARN("Particle shaders not found - skipping particle pipeline");
+			}
+		}
+
+		// ---- OitComposite pipeline (OIT pass, subpass 1) -----------------------------
+		// PostProcess.vert's full-screen triangle over the scene color,
+		// resolving the accumulation/revealage pair read as input attachments
+		// (set 0). Blends the average transparent color in by its coverage.
+		if (oitTwins)
+		{
+			PipelineConfig compositeConfig;
+			compositeConfig.vertexShader = m_Resources->GetShader("postprocess_vert");
+			compositeConfig.fragmentShaderPath = "OitComposite.frag";
+			compositeConfig.useVertexInput = false;
+			compositeConfig.topology = PrimitiveTopology::TriangleList;
+			compositeConfig.polygonMode = PolygonMode::Fill;
+			compositeConfig.cullMode = CullMode::None;
+			compositeConfig.frontFace = FrontFace::CounterClockwise;
+			compositeConfig.depthTestEnable = false;
+			compositeConfig.depthWriteEnable = false;
+			compositeConfig.blendEnable = true;
+			compositeConfig.srcColorBlendFactor = BlendFactor::SrcAlpha;
+			compositeConfig.dstColorBlendFactor = BlendFactor::OneMinusSrcAlpha;
+			compositeConfig.useOitInput = true;
+
+			oitTwins = compositeConfig.vertexShader &&
+				m_PipelineAdapter->CreatePipeline(PipelineType::OitComposite, compositeConfig);
+			if (oitTwins)
+			{
+				// Re-pointed in HandleSwapchainResize with the OIT targets
+				m_OitInputSet = m_DescriptorManager->AllocateOitInputSet();
+				oitTwins = (m_OitInputSet != VK_NULL_HANDLE);
+			}
+			if (oitTwins)
+			{
+				m_DescriptorManager->UpdateOitInputSet(m_OitInputSet,
+					m_RenderPasses->GetOitAccumulationView(), m_RenderPasses->GetOitRevealageView());
+			}
+		}
+
+		m_OitSupported = oitTwins;
+		if (!m_OitSupported)
+		{
+			LOG_WARN("Order-independent transparency unavailable - missing its render pass, composite or a pipeline twin");
+		}
+
 		// ---- PostProcess pipeline (FXAA composite) -----------------------------------
 		// Targets a dedicated render pass (writes the actual swapchain image,
 		// not the offscreen scene-color texture every other pipeline above
@@ -1464,10 +3068,13 @@ namespace Nightbloom
 			if (postProcessVert && postProcessFrag)
 			{
 				m_PipelineAdapter->SetPostProcessRenderPass(m_RenderPasses->GetPostProcessRenderPass());
+				if (m_RenderPasses->IsPostProcessDynamic())
+					m_PipelineAdapter->SetPostProcessRenderingFormat(m_Swapchain->GetImageFormat());
 
 				PipelineConfig postProcessConfig;
 				postProcessConfig.vertexShader = postProcessVert;
 				postProcessConfig.fragmentShader = postProcessFrag;
+				postProcessConfig.fragmentShaderHalf = m_Resources->GetShader("postprocess_frag_fp16");
 
 				// No vertex/index buffer - PostProcess.vert generates the
 				// full-screen triangle procedurally from gl_VertexIndex.
@@ -1484,15 +3091,16 @@ namespace Nightbloom
 				postProcessConfig.depthWriteEnable = false;
 				postProcessConfig.blendEnable = false;
 
-				// Descriptor sets: 0 = scene-color sampler, 1 = bloom result sampler.
+				// Descriptor sets: 0 = scene-color sampler, 1 = bloom chain (mip 0).
 				postProcessConfig.usePostProcessInput = true;
 				postProcessConfig.useBloomInput = true;
 
-				// Tone-mapping / grading params (Debug Panel). 20 bytes: (int aaEnabled,
-				// int tonemapEnabled, float exposure, float vignetteStrength, float bloomIntensity).
+				// Tone-mapping / grading params (Debug Panel). 28 bytes: (int aaEnabled,
+				// int tonemapEnabled, float exposure, float vignetteStrength, float bloomIntensity,
+				// float uvScaleX, float uvScaleY).
 				// This pass is recorded directly (see RecordPostProcessPass), independent of
 				// CommandRecorder's shared PushConstantData, so the size is local to it.
-				postProcessConfig.pushConstantSize = 5 * sizeof(float);  // 5x 4-byte = 20 bytes
+				postProcessConfig.pushConstantSize = 7 * sizeof(float);  // 7x 4-byte = 28 bytes
 				postProcessConfig.pushConstantStages = ShaderStage::Fragment;
 
 				if (m_PipelineAdapter->CreatePipeline(PipelineType::PostProcess, postProcessConfig))
@@ -1524,56 +3132,36 @@ namespace Nightbloom
 			}
 		}
 
-		// ---- Bloom pipeline (bright-extract + separable blur) -------------------------
+		// ---- PostProcessCopy pipeline (compute post pass output -> swapchain) --------
+		// Same render pass and full-screen triangle as PostProcess; set 0 is
+		// ComputePostProcess's output, no push constants.
 		{
-			VulkanShader* bloomVert = m_Resources->GetShader("postprocess_vert");  // shared full-screen triangle
-			VulkanShader* bloomFrag = m_Resources->GetShader("bloom_frag");
-			if (bloomVert && bloomFrag)
-			{
-				m_PipelineAdapter->SetBloomRenderPass(m_RenderPasses->GetBloomRenderPass());
-
-				PipelineConfig bloomConfig;
-				bloomConfig.vertexShader = bloomVert;
-				bloomConfig.fragmentShader = bloomFrag;
-				bloomConfig.useVertexInput = false;
-				bloomConfig.topology = PrimitiveTopology::TriangleList;
-				bloomConfig.polygonMode = PolygonMode::Fill;
-				bloomConfig.cullMode = CullMode::None;
-				bloomConfig.frontFace = FrontFace::CounterClockwise;
-				bloomConfig.depthTestEnable = false;
-				bloomConfig.depthWriteEnable = false;
-				bloomConfig.blendEnable = false;
-				bloomConfig.usePostProcessInput = true;   // set 0 = single input sampler (scene or a bloom target)
-				// push: vec2 direction + float threshold + int mode = 16 bytes
-				bloomConfig.pushConstantSize = 4 * sizeof(float);
-				bloomConfig.pushConstantStages = ShaderStage::Fragment;
+			VulkanShader* postProcessVert = m_Resources->GetShader("postprocess_vert");
+			VulkanShader* copyFrag = m_Resources->GetShader("postprocess_copy_frag");
 
-				if (!m_PipelineAdapter->CreatePipeline(PipelineType::Bloom, bloomConfig))
+			if (postProcessVert && copyFrag)
+			{
+				PipelineConfig copyConfig;
+				copyConfig.vertexShader = postProcessVert;
+				copyConfig.fragmentShader = copyFrag;
+				copyConfig.useVertexInput = false;
+				copyConfig.topology = PrimitiveTopology::TriangleList;
+				copyConfig.polygonMode = PolygonMode::Fill;
+				copyConfig.cullMode = CullMode::None;
+				copyConfig.frontFace = FrontFace::CounterClockwise;
+				copyConfig.depthTestEnable = false;
+				copyConfig.depthWriteEnable = false;
+				copyConfig.blendEnable = false;
+				copyConfig.usePostProcessInput = true;
+
+				if (m_PipelineAdapter->CreatePipeline(PipelineType::PostProcessCopy, copyConfig))
 				{
-					LOG_ERROR("Failed to create bloom pipeline");
-					return false;
+					LOG_INFO("PostProcessCopy pipeline created successfully");
 				}
-				LOG_INFO("Bloom pipeline created successfully");
-
-				// Two sampler sets (single-sampler shape, reused from the post-process input
-				// layout): A -> bloom target A, B -> bloom target B. A also serves as set 1 of
-				// the post-process composite. Re-pointed in HandleSwapchainResize.
-				m_BloomSetA = m_DescriptorManager->AllocatePostProcessInputSet();
-				m_BloomSetB = m_DescriptorManager->AllocatePostProcessInputSet();
-				if (m_BloomSetA == VK_NULL_HANDLE || m_BloomSetB == VK_NULL_HANDLE)
+				else
 				{
-					LOG_ERROR("Failed to allocate bloom descriptor sets");
-					return false;
+					LOG_WARN("Failed to create post-process copy pipeline - continuing without the compute post pass");
 				}
-				m_DescriptorManager->UpdatePostProcessInputSet(m_BloomSetA,
-					m_RenderPasses->GetBloomImageViewA(), m_RenderPasses->GetBloomSampler());
-				m_DescriptorManager->UpdatePostProcessInputSet(m_BloomSetB,
-					m_RenderPasses->GetBloomImageViewB(), m_RenderPasses->GetBloomSampler());
-			}
-			else
-			{
-				LOG_ERROR("Bloom shaders not found");
-				return false;
 			}
 		}
 
@@ -1595,6 +3183,153 @@ namespace Nightbloom
 		return true;
 	}
 
+	bool Renderer::CreateDepthPrepassTwins(PipelineType type, const PipelineConfig& config)
+	{
+		// Both twins keep the base type's vertex shader, so the prepass and
+		// the color pass compute bit-identical depth (the vertex shaders
+		// declare gl_Position invariant) and EQUAL passes exactly where the
+		// prepass won. The Shadow/TerrainShadow vertex shaders can't be used
+		// for this: they transform in a different order and would not match.
+		// Same layouts too, so the recorder binds the same sets either way.
+		PipelineConfig depthConfig = config;
+		depthConfig.fragmentShader = nullptr;
+		depthConfig.fragmentShaderPath = "Shadow.frag";
+		depthConfig.colorWriteEnable = false;
+
+		if (!m_PipelineAdapter->CreatePipeline(GetDepthPrepassPipeline(type), depthConfig))
+		{
+			LOG_WARN("Failed to create depth prepass twin of pipeline {}", static_cast<int>(type));
+			return false;
+		}
+
+		PipelineConfig equalConfig = config;
+		equalConfig.depthCompareOp = CompareOp::Equal;
+		equalConfig.depthWriteEnable = false;  // already written by the prepass
+
+		if (!m_PipelineAdapter->CreatePipeline(GetDepthEqualPipeline(type), equalConfig))
+		{
+			LOG_WARN("Failed to create EQUAL depth twin of pipeline {}", static_cast<int>(type));
+			return false;
+		}
+		return true;
+	}
+
+	bool Renderer::CreateOitTwin(PipelineType type, const PipelineConfig& config, const char* fragmentShaderPath)
+	{
+		// Same vertex shader and layouts as the blended pipeline, so the
+		// recorder binds the same sets; only the outputs and blending differ
+		// (oit.glsl). The pass has no depth writes and no shading rate image.
+		PipelineConfig oitConfig = config;
+		oitConfig.fragmentShader = nullptr;
+		oitConfig.fragmentShaderPath = fragmentShaderPath;
+		oitConfig.oitAccumulate = true;
+		oitConfig.blendEnable = false;
+		oitConfig.depthWriteEnable = false;
+		oitConfig.coarseShading = false;
+
+		if (!m_PipelineAdapter->CreatePipeline(GetOitPipeline(type), oitConfig))
+		{
+			LOG_WARN("Failed to create OIT twin of pipeline {}", static_cast<int>(type));
+			return false;
+		}
+		return true;
+	}
+
+	bool Renderer::CreateReflectionTwin(PipelineType type, const PipelineConfig& config)
+	{
+		if (!m_RenderPasses->NeedsReflectionPipelines())
+			return true;
+
+		// Identical pipeline; the adapter builds it against the reflection
+		// pass at that pass's sample count
+		if (!m_PipelineAdapter->CreatePipeline(GetReflectionPipeline(type), config))
+		{
+			LOG_WARN("Failed to create reflection twin of pipeline {} - it won't appear in the reflection",
+				static_cast<int>(type));
+			return false;
+		}
+		return true;
+	}
+
+	bool Renderer::FinishPipelineCreation()
+	{
+		const VulkanPipelineManager::ParallelCreationResult result = m_PipelineAdapter->FinishParallelCreation();
+
+		const double seconds = StartupTimer::Now() - m_PipelineCreationStart;
+		const uint32_t threads = JobSystem::Get().GetConcurrency();
+		LOG_INFO("Created {} pipelines on {} threads in {:.1f} ms", result.built, threads, seconds * 1000.0);
+		StartupTimer::Get().Mark("Pipelines", StartupTimer::Now(),
+			std::to_string(result.built) + " on " + std::to_string(threads) + " threads");
+
+		if (result.failed.empty())
+			return true;
+
+		auto failed = [&](PipelineType type)
+		{
+			return std::find(result.failed.begin(), result.failed.end(), type) != result.failed.end();
+		};
+		auto twinsFailed = [&](PipelineType type)
+		{
+			return failed(type) || failed(GetDepthPrepassPipeline(type)) || failed(GetDepthEqualPipeline(type));
+		};
+
+		if (failed(PipelineType::PostProcess))
+		{
+			LOG_ERROR("Failed to create post-process pipeline - nothing will reach the screen");
+			return false;
+		}
+
+		if (m_DepthPrepassSupported)
+		{
+			for (PipelineType type : { PipelineType::Mesh, PipelineType::MeshPacked, PipelineType::Terrain, PipelineType::Foliage })
+				m_DepthPrepassSupported = m_DepthPrepassSupported && !twinsFailed(type);
+			if (!m_DepthPrepassSupported)
+				LOG_WARN("Depth prepass unavailable - not every opaque pipeline has its depth/EQUAL twins");
+		}
+
+		if (m_TerrainTessellationSupported && twinsFailed(PipelineType::TerrainTessellated))
+		{
+			m_TerrainTessellationSupported = false;
+			LOG_WARN("Failed to create tessellated terrain pipeline - terrain draws its full patch grid");
+		}
+
+		if (m_OitSupported)
+		{
+			m_OitSupported = !failed(PipelineType::OitComposite);
+			for (PipelineType type : { PipelineType::Transparent, PipelineType::TransparentPacked, PipelineType::Water,
+				PipelineType::Firefly, PipelineType::FireflyPoint, PipelineType::Particle })
+			{
+				m_OitSupported = m_OitSupported && !failed(GetOitPipeline(type));
+			}
+			if (!m_OitSupported)
+				LOG_WARN("Order-independent transparency unavailable - missing its render pass, composite or a pipeline twin");
+		}
+
+		if (m_ShadowEnabled && failed(PipelineType::Shadow))
+		{
+			LOG_WARN("Failed to initialize shadow mapping - continuing without shadows");
+			m_ShadowEnabled = false;
+		}
+		if (m_LayeredShadowsSupported && (failed(PipelineType::ShadowLayered) || failed(PipelineType::ShadowLayeredPacked)
+			|| failed(PipelineType::TerrainShadowLayered)))
+		{
+			m_LayeredShadowsSupported = false;
+			LOG_INFO("Single-pass cascaded shadows: unsupported");
+		}
+		if (m_LocalShadowPipelinesReady && (failed(PipelineType::LocalShadow) || failed(PipelineType::LocalShadowPacked)))
+		{
+			m_LocalShadowPipelinesReady = false;
+			LOG_WARN("Point light shadows unavailable - failed to create the local shadow pipelines");
+		}
+
+		if (m_ComputeEnabled && failed(PipelineType::Compute))
+		{
+			LOG_WARN("Failed to initialize compute - continuing without compute support");
+			m_ComputeEnabled = false;
+		}
+		return true;
+	}
+
 	bool Renderer::InitializeCompute()
 	{
 		LOG_INFO("=== Initializing Compute Support ===");
@@ -1691,6 +3426,14 @@ namespace Nightbloom
 			m_ComputeTestOutputBuffer->GetBuffer(), bufferSize
 		);
 
+		// Async compute queue (optional - falls back to the graphics queue)
+		m_AsyncCompute = std::make_unique<AsyncComputeQueue>();
+		if (!m_AsyncCompute->Initialize(vkDevice))
+		{
+			LOG_WARN("Failed to initialize async compute - compute stays on the graphics queue");
+			m_AsyncCompute.reset();
+		}
+
 		// Initialize noise texture generator
 		m_NoiseGenerator = std::make_unique<NoiseTextureGenerator>();
 		if (!m_NoiseGenerator->Initialize(
@@ -1703,120 +3446,331 @@ namespace Nightbloom
 		}
 		else
 		{
-			// Sanity check: generate a small test noise texture
-			NoiseTextureDesc testDesc;
-			testDesc.width = 64;
-			testDesc.height = 64;
-			testDesc.depth = 64;
-			testDesc.noiseType = NoiseType::Perlin;
-			testDesc.octaves = 4;
-			testDesc.frequency = 4.0f;
-			testDesc.debugName = "TestNoise";
-
-			m_TestNoise = m_NoiseGenerator->Generate(testDesc, m_ComputeDispatcher.get());
-			if (!m_TestNoise)
+			if (IsAsyncComputeEnabled())
 			{
-				LOG_WARN("Test noise generation failed");
+				m_NoiseGenerator->SetComputeCommandPool(m_AsyncCompute->GetCommandPool());
 			}
+
+			// Next to PipelineCache/MeshCache: cloud volumes load instead of regenerating
+			m_NoiseGenerator->SetDiskCacheDirectory((std::filesystem::current_path() / "NoiseCache").string());
 		}
 
-		// Generate initial 2D preview for the editor panel
-		NoiseTextureDesc previewDesc;
-		previewDesc.width = 256;
-		previewDesc.height = 256;
-		previewDesc.depth = 1;
-		previewDesc.noiseType = NoiseType::Perlin;
-		previewDesc.octaves = 4;
-		previewDesc.frequency = 4.0f;
-		previewDesc.debugName = "NoisePreview";
-		m_NoisePreview = m_NoiseGenerator->Generate(previewDesc, m_ComputeDispatcher.get());
+		// No noise is generated up front: the preview waits for the Noise
+		// Debug panel (RegenerateNoisePreview), cloud volumes for CloudSystem
 
 		m_ComputeEnabled = true;
 		LOG_INFO("Compute support initialized successfully");
 		return true;
 	}
 
-	bool Renderer::InitializeShadowMapping()
+	bool Renderer::InitializeOcclusionCulling()
 	{
-		LOG_INFO("=== Initializing Shadow Mapping ===");
+		if (!m_ComputeDispatcher || !m_RenderPasses->HasDepthBuffer())
+		{
+			return false;
+		}
 
 		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
-		// Create shadow map manager
-		m_ShadowManager = std::make_unique<ShadowMapManager>();
-
-		ShadowMapConfig shadowMapConfig;  // Renamed from shadowConfig to avoid shadowing
-		shadowMapConfig.resolution = 4096;
-		shadowMapConfig.depthFormat = VK_FORMAT_D32_SFLOAT;
-		shadowMapConfig.depthBiasConstant = 1.0f;
-		shadowMapConfig.depthBiasSlope = 1.5f;
-		shadowMapConfig.enablePCF = true;
+		m_OcclusionCuller = std::make_unique<OcclusionCuller>();
+		return m_OcclusionCuller->Initialize(vkDevice, m_MemoryManager.get(), m_Resources.get(),
+			m_DescriptorManager.get(), m_RenderPasses->GetDepthImageView(), m_RenderPasses->GetSceneExtent(),
+			m_RenderPasses->GetSampleCount());
+	}
 
-		if (!m_ShadowManager->Initialize(vkDevice, m_MemoryManager.get(),
-			m_DescriptorManager.get(), shadowMapConfig))
+	bool Renderer::InitializeMeshletCulling()
+	{
+		// Each job's draw count is only known on the GPU
+		if (!m_OcclusionCuller || !m_Device->SupportsFeature("draw_indirect_count"))
 		{
-			LOG_ERROR("Failed to initialize shadow map manager");
 			return false;
 		}
 
-		for (uint32_t i = 0; i < FrameSyncManager::MAX_FRAMES_IN_FLIGHT; ++i)
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+
+		m_MeshletCuller = std::make_unique<MeshletCuller>();
+		return m_MeshletCuller->Initialize(vkDevice, m_Resources.get(), m_DescriptorManager.get(),
+			m_Resources->GetMeshArena(), m_OcclusionCuller.get());
+	}
+
+	bool Renderer::InitializeSkinning()
+	{
+		if (!m_ComputeDispatcher)
 		{
-			m_DescriptorManager->UpdateShadowSet(
-				i,
-				m_ShadowManager->GetShadowMapView(),
-				m_ShadowManager->GetShadowSampler()
-			);
+			return false;
 		}
-		LOG_INFO("Updated descriptor manager shadow sets with shadow map");
 
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
-		// Set shadow render pass for pipeline adapter
-		m_PipelineAdapter->SetShadowRenderPass(m_ShadowManager->GetShadowRenderPass());
+		m_SkinningSystem = std::make_unique<SkinningSystem>();
+		return m_SkinningSystem->Initialize(vkDevice, m_Resources.get(), m_DescriptorManager.get(),
+			m_Resources->GetMeshArena());
+	}
 
-		// Create shadow pipeline
+	bool Renderer::InitializeTemporalUpscaling()
+	{
+		if (!m_ComputeDispatcher || !m_RenderPasses->HasDepthBuffer())
 		{
-			PipelineConfig shadowPipelineConfig;  // Renamed to avoid shadowing outer variable
-			shadowPipelineConfig.vertexShaderPath = "Shadow.vert";
-			shadowPipelineConfig.fragmentShaderPath = "Shadow.frag";
-			shadowPipelineConfig.useVertexInput = true;
-			shadowPipelineConfig.topology = PrimitiveTopology::TriangleList;
-			shadowPipelineConfig.polygonMode = PolygonMode::Fill;
+			return false;
+		}
 
-			// MUST STAY CullMode::Back. Front-face culling is the textbook acne fix
-			// (store back-face depth so lit front faces never self-shadow), but in THIS
-			// engine it caused a drastic FPS drop (confirmed 2026-06-26, ~1500fps -> tanked)
-			// and was reverted. Acne here is a BIAS-TUNING problem, not a culling one —
-			// use the Lighting panel Bias / Normal Bias sliders instead.
-			shadowPipelineConfig.cullMode = CullMode::Back;
-			shadowPipelineConfig.frontFace = FrontFace::CounterClockwise;
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
-			// Standard depth test (not reverse-Z for shadow maps)
-			shadowPipelineConfig.depthTestEnable = true;
-			shadowPipelineConfig.depthWriteEnable = true;
-			shadowPipelineConfig.depthCompareOp = CompareOp::LessOrEqual;
+		m_TemporalUpscaler = std::make_unique<TemporalUpscaler>();
+		return m_TemporalUpscaler->Initialize(vkDevice, m_MemoryManager.get(), m_Resources.get(),
+			m_DescriptorManager.get(), m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetResolvedDepthImageView(),
+			m_RenderPasses->GetResolvedDepthSampleCount(), m_RenderPasses->GetSceneExtent());
+	}
 
-			// Enable depth bias to reduce shadow acne
-			shadowPipelineConfig.depthBiasEnable = true;
-			shadowPipelineConfig.depthBiasConstant = m_ShadowManager->GetDepthBiasConstant();
-			shadowPipelineConfig.depthBiasSlope = m_ShadowManager->GetDepthBiasSlope();
+	bool Renderer::InitializeContactShadows()
+	{
+		if (!m_ComputeDispatcher || !m_RenderPasses->HasDepthBuffer() || !m_RenderPasses->IsSceneColorStorage())
+		{
+			return false;
+		}
 
-			// Shadow pass uses only uniform buffer (for view/proj)
-			shadowPipelineConfig.useUniformBuffer = true;
-			shadowPipelineConfig.useTextures = false;
-			shadowPipelineConfig.useLighting = false;
-			shadowPipelineConfig.useShadowMap = false;
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
-			// No color attachment for shadow pass
-			shadowPipelineConfig.hasColorAttachment = false;
+		m_ContactShadows = std::make_unique<ContactShadows>();
+		return m_ContactShadows->Initialize(vkDevice, m_DescriptorManager.get(), m_RenderPasses->GetSceneColorImageView(),
+			m_RenderPasses->GetResolvedDepthImageView(), m_RenderPasses->GetResolvedDepthSampleCount());
+	}
 
-			shadowPipelineConfig.pushConstantSize = sizeof(PushConstantData);
-			shadowPipelineConfig.pushConstantStages = ShaderStage::Vertex;
+	bool Renderer::IsRayTracedShadowActive() const
+	{
+		return m_RayTracedShadows && m_RayTracedShadowSettings.enabled && m_ShadowEnabled && m_PipelineAdapter &&
+			m_PipelineAdapter->IsFeatureBound(ToVariantBit(ShaderFeature::RayQueryShadow));
+	}
+
+	void Renderer::GetRayTracedShadowStats(uint32_t& instances, uint32_t& blases) const
+	{
+		instances = m_RayTracedShadowActive ? m_RayTracedShadows->GetInstanceCount() : 0;
+		blases = m_RayTracedShadows ? m_RayTracedShadows->GetBlasCount() : 0;
+	}
+
+	bool Renderer::InitializeRayTracedShadows()
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		if (!vkDevice->SupportsFeature("ray_query"))
+		{
+			return false;
+		}
+
+		m_RayTracedShadows = std::make_unique<RayTracedShadows>();
+		return m_RayTracedShadows->Initialize(vkDevice, m_MemoryManager.get(), m_DescriptorManager.get());
+	}
+
+	void Renderer::GetLocalShadowStats(uint32_t& lights, uint32_t& renderedFaces) const
+	{
+		lights = m_LocalShadows ? m_LocalShadows->GetShadowedLightCount() : 0;
+		renderedFaces = m_LocalShadows ? m_LocalShadows->GetLastRenderedFaces() : 0;
+	}
+
+	void Renderer::UpdateLocalShadowLights(uint32_t frameIndex)
+	{
+		if (m_LocalShadows)
+		{
+			LocalShadowSettings settings = m_LocalShadowSettings;
+			settings.enabled = settings.enabled && m_ShadowEnabled && m_LocalShadowPipelinesReady;
+			m_LocalShadows->AssignLights(m_PointLights, settings, m_ViewMatrix, m_ProjectionMatrix,
+				static_cast<float>(m_RenderExtent.height), m_ShadedPointScratch);
+		}
+		else
+		{
+			m_ShadedPointScratch.resize(m_PointLights.size());
+			for (size_t i = 0; i < m_PointLights.size(); ++i)
+				m_ShadedPointScratch[i] = m_PointLights[i].position.w > 0.5f
+					? LocalShadowAtlas::EncodeLight(m_PointLights[i], -1) : m_PointLights[i];
+		}
+
+		if (m_ShadedPointScratch.size() != m_ShadedPointLights.size() ||
+			memcmp(m_ShadedPointScratch.data(), m_ShadedPointLights.data(), m_ShadedPointScratch.size() * sizeof(LightData)) != 0)
+		{
+			m_ShadedPointLights.swap(m_ShadedPointScratch);
+			++m_ShadedPointLightsVersion;
+		}
+
+		// SceneLighting's copies of the same lights
+		m_ShadedLightingData = m_CurrentLightingData;
+		const int count = std::clamp(m_ShadedLightingData.numLights, 0, static_cast<int>(MAX_LIGHTS));
+		for (int i = 0; i < count; ++i)
+		{
+			LightData& light = m_ShadedLightingData.lights[i];
+			if (light.position.w < 0.5f)
+				continue;
+			const int32_t slot = m_LocalShadows ? m_LocalShadows->FindSlot(LocalShadowAtlas::LightKey(light)) : -1;
+			light = LocalShadowAtlas::EncodeLight(light, slot);
+		}
+
+		void* mapped = m_FrameUploads->GetMapped(frameIndex, m_LocalShadowUniformSlot);
+		if (mapped && m_LocalShadows)
+		{
+			LocalShadowUniforms uniforms;
+			m_LocalShadows->FillUniforms(uniforms);
+			memcpy(mapped, &uniforms, sizeof(LocalShadowUniforms));
+		}
+	}
+
+	bool Renderer::InitializeBloom()
+	{
+		if (!m_ComputeDispatcher)
+		{
+			return false;
+		}
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+
+		m_BloomChain = std::make_unique<BloomMipChain>();
+		return m_BloomChain->Initialize(vkDevice, m_DescriptorManager.get(),
+			m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetSceneExtent(),
+			m_RenderPasses->GetBloomImage(), m_RenderPasses->GetBloomExtent(), m_RenderPasses->GetBloomMipCount());
+	}
+
+	bool Renderer::InitializeComputePostProcess()
+	{
+		// The copy pipeline is what puts the result on screen
+		if (!m_ComputeDispatcher ||
+			m_PipelineAdapter->GetVulkanManager()->GetPipeline(PipelineType::PostProcessCopy) == VK_NULL_HANDLE)
+		{
+			return false;
+		}
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+
+		m_ComputePost = std::make_unique<ComputePostProcess>();
+		return m_ComputePost->Initialize(vkDevice, m_MemoryManager.get(), m_DescriptorManager.get(),
+			m_RenderPasses->GetSceneExtent());
+	}
+
+	bool Renderer::InitializeScreenSpaceReflections()
+	{
+		// Traces the Hi-Z pyramid's nearest-depth layer
+		if (!m_ComputeDispatcher || !m_OcclusionCuller)
+		{
+			return false;
+		}
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+
+		m_SSR = std::make_unique<ScreenSpaceReflections>();
+		return m_SSR->Initialize(vkDevice, m_MemoryManager.get(), m_DescriptorManager.get(),
+			m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetSceneExtent(),
+			m_OcclusionCuller->GetPyramidExtent());
+	}
+
+	bool Renderer::InitializeShadowMapping()
+	{
+		LOG_INFO("=== Initializing Shadow Mapping ===");
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+
+		// Create shadow map manager
+		m_ShadowManager = std::make_unique<ShadowMapManager>();
+
+		ShadowMapConfig shadowMapConfig;  // Renamed from shadowConfig to avoid shadowing
+		shadowMapConfig.resolution = 4096;
+		shadowMapConfig.depthFormat = VK_FORMAT_D32_SFLOAT;
+		shadowMapConfig.depthBiasConstant = 1.0f;
+		shadowMapConfig.depthBiasSlope = 1.5f;
+		shadowMapConfig.enablePCF = true;
+
+		if (!m_ShadowManager->Initialize(vkDevice, m_MemoryManager.get(),
+			m_DescriptorManager.get(), shadowMapConfig))
+		{
+			LOG_ERROR("Failed to initialize shadow map manager");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_DescriptorManager->UpdateShadowSet(
+				i,
+				m_ShadowManager->GetShadowMapView(),
+				m_ShadowManager->GetShadowSampler()
+			);
+		}
+		LOG_INFO("Updated descriptor manager shadow sets with shadow map");
+
+
+		// Set shadow render pass for pipeline adapter
+		m_PipelineAdapter->SetShadowRenderPass(m_ShadowManager->GetShadowRenderPass());
+
+		// Create shadow pipeline
+		{
+			PipelineConfig shadowPipelineConfig;  // Renamed to avoid shadowing outer variable
+			shadowPipelineConfig.vertexShaderPath = "Shadow.vert";
+			shadowPipelineConfig.fragmentShaderPath = "Shadow.frag";
+			shadowPipelineConfig.useVertexInput = true;
+			shadowPipelineConfig.topology = PrimitiveTopology::TriangleList;
+			shadowPipelineConfig.polygonMode = PolygonMode::Fill;
+
+			// MUST STAY CullMode::Back. Front-face culling is the textbook acne fix
+			// (store back-face depth so lit front faces never self-shadow), but in THIS
+			// engine it caused a drastic FPS drop (confirmed 2026-06-26, ~1500fps -> tanked)
+			// and was reverted. Acne here is a BIAS-TUNING problem, not a culling one —
+			// use the Lighting panel Bias / Normal Bias sliders instead.
+			shadowPipelineConfig.cullMode = CullMode::Back;
+			shadowPipelineConfig.frontFace = FrontFace::CounterClockwise;
+
+			// Standard depth test (not reverse-Z for shadow maps)
+			shadowPipelineConfig.depthTestEnable = true;
+			shadowPipelineConfig.depthWriteEnable = true;
+			shadowPipelineConfig.depthCompareOp = CompareOp::LessOrEqual;
+
+			// Enable depth bias to reduce shadow acne
+			shadowPipelineConfig.depthBiasEnable = true;
+			shadowPipelineConfig.depthBiasConstant = m_ShadowManager->GetDepthBiasConstant();
+			shadowPipelineConfig.depthBiasSlope = m_ShadowManager->GetDepthBiasSlope();
+
+			// Shadow pass uses only uniform buffer (for view/proj)
+			shadowPipelineConfig.useUniformBuffer = true;
+			shadowPipelineConfig.useTextures = false;
+			shadowPipelineConfig.useLighting = false;
+			shadowPipelineConfig.useShadowMap = false;
+
+			// No color attachment for shadow pass
+			shadowPipelineConfig.hasColorAttachment = false;
+
+			shadowPipelineConfig.pushConstantSize = sizeof(PushConstantData);
+			shadowPipelineConfig.pushConstantStages = ShaderStage::Vertex;
 
 			if (!m_PipelineAdapter->CreatePipeline(PipelineType::Shadow, shadowPipelineConfig))
 			{
 				LOG_ERROR("Failed to create shadow pipeline");
 				return false;
 			}
+
+			// Single-pass cascades: same state, gl_Layer fan-out in the vertex stage
+			if (m_Device->SupportsFeature("shader_output_layer"))
+			{
+				PipelineConfig layeredConfig = shadowPipelineConfig;
+				layeredConfig.vertexShaderPath = "ShadowLayered.vert";
+				m_LayeredShadowsSupported = m_PipelineAdapter->CreatePipeline(PipelineType::ShadowLayered, layeredConfig);
+			}
+
+			// Compressed-vertex twins. The shadow shaders only read the position,
+			// which the vertex fetch unpacks, so they are shared unchanged.
+			shadowPipelineConfig.vertexFormat = VertexFormat::Packed;
+			if (!m_PipelineAdapter->CreatePipeline(PipelineType::ShadowPacked, shadowPipelineConfig))
+			{
+				LOG_ERROR("Failed to create packed shadow pipeline");
+			}
+			if (m_LayeredShadowsSupported)
+			{
+				PipelineConfig layeredConfig = shadowPipelineConfig;
+				layeredConfig.vertexShaderPath = "ShadowLayered.vert";
+				m_LayeredShadowsSupported = m_PipelineAdapter->CreatePipeline(PipelineType::ShadowLayeredPacked, layeredConfig);
+			}
+
+			// Point light faces: the same state, drawn into the local atlas,
+			// whose render pass is compatible with the cascades'
+			PipelineConfig localConfig = shadowPipelineConfig;
+			localConfig.vertexShaderPath = "LocalShadow.vert";
+			localConfig.vertexFormat = VertexFormat::Standard;
+			m_LocalShadowPipelinesReady = m_PipelineAdapter->CreatePipeline(PipelineType::LocalShadow, localConfig);
+			localConfig.vertexFormat = VertexFormat::Packed;
+			m_LocalShadowPipelinesReady = m_LocalShadowPipelinesReady &&
+				m_PipelineAdapter->CreatePipeline(PipelineType::LocalShadowPacked, localConfig);
 		}
 
 		// Terrain Shadow Pipeline
@@ -1824,7 +3778,7 @@ namespace Nightbloom
 			PipelineConfig terrainShadowConfig;
 			terrainShadowConfig.vertexShaderPath = "TerrainShadow.vert";
 			terrainShadowConfig.fragmentShaderPath = "Shadow.frag";  // reuse existing
-			terrainShadowConfig.useVertexInput = true;
+			terrainShadowConfig.useVertexInput = false;   // index-only grid, as Terrain
 			terrainShadowConfig.topology = PrimitiveTopology::TriangleList;
 			terrainShadowConfig.polygonMode = PolygonMode::Fill;
 			terrainShadowConfig.cullMode = CullMode::None;
@@ -1843,336 +3797,2144 @@ namespace Nightbloom
 
 			if (m_PipelineAdapter->CreatePipeline(PipelineType::TerrainShadow, terrainShadowConfig))
 				LOG_INFO("Terrain shadow pipeline created");
+
+			if (m_LayeredShadowsSupported)
+			{
+				PipelineConfig layeredConfig = terrainShadowConfig;
+				layeredConfig.vertexShaderPath = "TerrainShadowLayered.vert";
+				m_LayeredShadowsSupported = m_PipelineAdapter->CreatePipeline(PipelineType::TerrainShadowLayered, layeredConfig);
+			}
+			LOG_INFO("Single-pass cascaded shadows: {}", m_LayeredShadowsSupported ? "available" : "unsupported");
 		}
 
 		LOG_INFO("Shadow mapping initialized successfully");
 		return true;
 	}
 
+	void Renderer::SetParallelRecording(bool enabled)
+	{
+		if (m_Commands)
+			m_Commands->SetParallelRecording(enabled);
+	}
+
+	bool Renderer::IsParallelRecording() const
+	{
+		return m_Commands && m_Commands->IsParallelRecording();
+	}
+
+	bool Renderer::IsHalfPrecisionSupported() const
+	{
+		return m_Device && m_Device->SupportsFeature("shader_float16");
+	}
+
+	void Renderer::GetCachedSecondaryStats(uint32_t& reused, uint32_t& recorded) const
+	{
+		reused = m_Commands ? m_Commands->GetCachedSecondaryStats().reused : 0;
+		recorded = m_Commands ? m_Commands->GetCachedSecondaryStats().recorded : 0;
+	}
+
 	void Renderer::RecordCommandBuffer(uint32_t frameIndex, uint32_t imageIndex)
 	{
+		NB_PROFILE_SCOPE("Record Command Buffer");
 		// Reset and begin command buffer
 		m_Commands->ResetCommandBuffer(frameIndex);
 		m_Commands->BeginCommandBuffer(frameIndex);
 
-		VkCommandBuffer profCmd = m_Commands->GetCommandBuffer(frameIndex);
-		if (m_GpuProfiler) m_GpuProfiler->BeginFrame(profCmd, frameIndex);
+		if (m_GpuProfiler) m_GpuProfiler->BeginFrame(m_Commands->GetCommandBuffer(frameIndex), frameIndex);
+
+		// Every pass is declared up front with what it reads and writes; the
+		// graph then drops passes nothing consumes and places the barriers
+		// between the rest (see RenderGraph.hpp). Systems that synchronize
+		// their own dispatches are declared with WriteManaged, render passes'
+		// attachments with RenderTarget (their subpass dependencies cover them).
+		RenderGraph& graph = *m_RenderGraph;
+		graph.Reset();
+
+		const bool compute = m_ComputeDispatcher != nullptr;
+		const bool fireflies = compute && m_FireflySystem && m_FireflySystem->IsReady();
+		const bool particles = compute && m_ParticleSystem && m_ParticleSystem->IsReady() && m_ParticleSystem->HasEmitters();
+		const bool clouds = compute && m_CloudSystem && m_CloudSystem->IsReady();
+		const bool oceanWaves = compute && m_WaterSystem && m_WaterSystem->IsSimulatingWaves();
+		const bool asyncCompute = IsAsyncComputeEnabled() && (fireflies || clouds || oceanWaves);
+		const bool bloom = compute && m_BloomChain && m_PostProcessSettings.bloomIntensity > 0.0f;
+		const bool computePost = IsComputePostActive();
+		const bool ssr = IsScreenSpaceReflectionActive();
+		const bool lightClusters = compute && m_LightClusters && m_LightClusters->IsActive(frameIndex);
+
+		// The water surface is the reflection's only reader. With OIT on,
+		// the transparency pass only runs when it has something to draw.
+		bool waterVisible = false;
+		bool transparentsVisible = false;
+		for (size_t i = 0; i < m_FrameDrawList.GetCommandCount() && !(waterVisible && transparentsVisible); ++i)
+		{
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			waterVisible |= drawCmd.pipeline == PipelineType::Water && drawCmd.cameraVisible;
+			transparentsVisible |= m_OrderIndependentTransparency && DrawList::IsOrderIndependentCandidate(drawCmd);
+		}
+
+		const VkImageLayout readOnly = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		const VkPipelineStageFlags fragment = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		const VkPipelineStageFlags fragmentAndCompute = fragment | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		// The terrain shaders sample its surface map, never the heightmap itself
+		const RGResource terrainSurface = (m_TerrainSystem && m_TerrainSystem->GetSurfaceMap())
+			? graph.ImportImage(m_TerrainSystem->GetSurfaceMap()->GetImage(), readOnly)
+			: RG_INVALID;
+		// Terrain.frag blends its layers by the material map baked alongside
+		const RGResource terrainMaterial = (m_TerrainSystem && m_TerrainSystem->GetMaterialMap())
+			? graph.ImportImage(m_TerrainSystem->GetMaterialMap()->GetImage(), readOnly)
+			: RG_INVALID;
+		// Where it has pages, Terrain.frag reads its shading from the virtual texture
+		const RGResource terrainVirtualAlbedo = (m_TerrainSystem && m_TerrainSystem->GetVirtualAlbedo())
+			? graph.ImportImage(m_TerrainSystem->GetVirtualAlbedo()->GetImage(), readOnly)
+			: RG_INVALID;
+		const RGResource terrainVirtualNormal = (m_TerrainSystem && m_TerrainSystem->GetVirtualNormal())
+			? graph.ImportImage(m_TerrainSystem->GetVirtualNormal()->GetImage(), readOnly)
+			: RG_INVALID;
+		// Every lit pass's sunlight reads the terrain's sun shadow map
+		const RGResource terrainShadow = (m_TerrainSystem && m_CurrentFrameData.terrainShadow.window.z > 0.0f)
+			? graph.ImportImage(m_TerrainSystem->GetSunShadowMap()->GetImage(), readOnly)
+			: RG_INVALID;
+		// Grass and the water ripples sample the wind field
+		const RGResource wind = m_WindField
+			? graph.ImportImage(m_WindField->GetImage(), readOnly)
+			: RG_INVALID;
+		// The sky and the water's reflection of it sample the sky-view LUT,
+		// the terrain the aerial-perspective froxels
+		const RGResource skyView = m_AtmosphereLuts
+			? graph.ImportImage(m_AtmosphereLuts->GetSkyViewImage(), readOnly)
+			: RG_INVALID;
+		const RGResource aerialPerspective = m_AtmosphereLuts
+			? graph.ImportImage(m_AtmosphereLuts->GetAerialImage(), readOnly)
+			: RG_INVALID;
+		// Set 0 binding 7 of every scene-pass set; rewritten only on the
+		// frames its pass captures (see EnvironmentProbeCache.hpp)
+		const RGResource environmentProbe = m_EnvironmentProbe
+			? graph.ImportImage(m_EnvironmentProbe->GetImage(), readOnly)
+			: RG_INVALID;
+		const RGResource meshDraws = m_OcclusionCuller
+			? graph.ImportBuffer(m_OcclusionCuller->GetMeshDrawBuffer(frameIndex))
+			: RG_INVALID;
+		// Bound as a vertex buffer by every pass that draws a skinned model
+		const RGResource skinnedVertices = compute && m_SkinningSystem
+			? graph.ImportBuffer(m_SkinningSystem->GetOutputBuffer(frameIndex))
+			: RG_INVALID;
+		RGResource meshletDraws = RG_INVALID, meshletCounts = RG_INVALID;
+		if (compute && m_MeshletCuller)
+		{
+			meshletDraws = graph.ImportBuffer(m_MeshletCuller->GetDrawBuffer(frameIndex));
+			meshletCounts = graph.ImportBuffer(m_MeshletCuller->GetCountBuffer(frameIndex));
+		}
+		const RGResource agents = fireflies
+			? graph.ImportBuffer(m_FireflySystem->GetAgentBuffer(), m_FireflySystem->GetAgentBufferSize())
+			: RG_INVALID;
+		RGResource fireflyVisible = RG_INVALID, fireflyDrawArgs = RG_INVALID;
+		if (fireflies && m_FireflySystem->IsCulling())
+		{
+			fireflyVisible = graph.ImportBuffer(m_FireflySystem->GetVisibleBuffer(), m_FireflySystem->GetVisibleBufferSize());
+			fireflyDrawArgs = graph.ImportBuffer(m_FireflySystem->GetDrawArgsBuffer(), m_FireflySystem->GetDrawArgsBufferSize());
+		}
+		RGResource particlePool = RG_INVALID, particleAlive = RG_INVALID, particleCounters = RG_INVALID, particleArgs = RG_INVALID;
+		if (particles)
+		{
+			particlePool = graph.ImportBuffer(m_ParticleSystem->GetParticleBuffer(), m_ParticleSystem->GetParticleBufferSize());
+			particleAlive = graph.ImportBuffer(m_ParticleSystem->GetAliveBuffer(), m_ParticleSystem->GetAliveBufferSize());
+			particleCounters = graph.ImportBuffer(m_ParticleSystem->GetCounterBuffer(), m_ParticleSystem->GetCounterBufferSize());
+			particleArgs = graph.ImportBuffer(m_ParticleSystem->GetArgsBuffer(), m_ParticleSystem->GetArgsBufferSize());
+		}
+		const RGResource clusterLights = lightClusters
+			? graph.ImportBuffer(m_LightClusters->GetLightBuffer(frameIndex), m_LightClusters->GetLightBufferSize())
+			: RG_INVALID;
+		const RGResource clusterLists = lightClusters
+			? graph.ImportBuffer(m_LightClusters->GetClusterBuffer(frameIndex), m_LightClusters->GetClusterBufferSize())
+			: RG_INVALID;
+		RGResource grassIndirect = RG_INVALID, grassCount = RG_INVALID, grassLod = RG_INVALID;
+		if (compute && m_GrassSystem)
+		{
+			grassIndirect = graph.ImportBuffer(m_GrassSystem->GetIndirectBuffer(), m_GrassSystem->GetIndirectBufferSize());
+			grassCount = graph.ImportBuffer(m_GrassSystem->GetDrawCountBuffer(), m_GrassSystem->GetDrawCountBufferSize());
+			grassLod = graph.ImportBuffer(m_GrassSystem->GetPatchLodBuffer(), m_GrassSystem->GetPatchLodBufferSize());
+		}
+		const RGResource cloudResult = clouds
+			? graph.ImportImage(m_CloudSystem->GetRaymarchResultImage(), readOnly)
+			: RG_INVALID;
+		const RGResource cloudComposite = clouds
+			? graph.ImportImage(m_CloudSystem->GetCompositeImage(), readOnly)
+			: RG_INVALID;
+		const RGResource cloudReflection = (clouds && m_WaterSystem)
+			? graph.ImportImage(m_CloudSystem->GetReflectionResultImage(), readOnly)
+			: RG_INVALID;
+		const RGResource cloudShadow = (clouds && m_CurrentFrameData.cloudShadow.z > 0.0f)
+			? graph.ImportImage(m_CloudSystem->GetShadowMapImage(), readOnly)
+			: RG_INVALID;
+		const RGResource oceanDisplacement = oceanWaves
+			? graph.ImportImage(m_WaterSystem->GetWaves().GetDisplacementImage(), readOnly)
+			: RG_INVALID;
+		const RGResource oceanDerivatives = oceanWaves
+			? graph.ImportImage(m_WaterSystem->GetWaves().GetDerivativesImage(), readOnly)
+			: RG_INVALID;
+		const RGResource shadowMap = (m_ShadowEnabled && m_ShadowManager)
+			? graph.ImportImage(m_ShadowManager->GetShadowMapImage(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_ASPECT_DEPTH_BIT)
+			: RG_INVALID;
+		// Always readable: its render pass loads it and leaves it that way
+		const RGResource localShadowAtlas = m_LocalShadows
+			? graph.ImportImage(m_LocalShadows->GetAtlasImage(), readOnly, VK_IMAGE_ASPECT_DEPTH_BIT)
+			: RG_INVALID;
+		// Kept from the frame that last rendered it when this one doesn't
+		const RGResource reflection = m_WaterSystem
+			? graph.ImportImage(m_RenderPasses->GetReflectionColorImage(), m_ReflectionDue ? VK_IMAGE_LAYOUT_UNDEFINED : readOnly)
+			: RG_INVALID;
+		const RGResource ssrReflection = ssr
+			? graph.ImportImage(m_SSR->GetOutputImage(), VK_IMAGE_LAYOUT_UNDEFINED)
+			: RG_INVALID;
+		const RGResource sceneColor = graph.ImportImage(m_RenderPasses->GetSceneColorImage(), VK_IMAGE_LAYOUT_UNDEFINED);
+		const RGResource sceneDepth = m_RenderPasses->HasDepthBuffer()
+			? graph.ImportImage(m_RenderPasses->GetDepthImage(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_ASPECT_DEPTH_BIT)
+			: RG_INVALID;
+		// The scene pass's single-sample depth resolve, or the depth itself
+		const RGResource resolvedDepth = m_RenderPasses->HasDepthResolve()
+			? graph.ImportImage(m_RenderPasses->GetResolvedDepthImage(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_ASPECT_DEPTH_BIT)
+			: sceneDepth;
+		const RGResource bloomChain = bloom
+			? graph.ImportImage(m_RenderPasses->GetBloomImage(), VK_IMAGE_LAYOUT_UNDEFINED)
+			: RG_INVALID;
+
+		// =========================================================================
+		// COMPUTE PASSES - run BEFORE any render passes (outside render pass)
+		// =========================================================================
+		if (compute && m_TerrainSystem)
+		{
+			graph.AddPass("Terrain Tiles", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				// Each map's hand-off is queued and goes out in one batch with the
+				// next pass's own barriers (or the flush before the readback)
+				ComputeDispatcher* dispatcher = m_ComputeDispatcher.get();
+				auto queueSampled = [dispatcher, cmd](VkImage image, VkPipelineStageFlags2KHR readers)
+				{
+					dispatcher->QueueImageBarrier(cmd, image,
+						VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+						VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+						readers, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+				};
+
+				// Compute too: the virtual texture pages below are rendered from both maps
+				const VkPipelineStageFlags2KHR mapReaders = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR |
+					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+				if (m_TerrainSystem->DispatchHeightmapUpdate(cmd, dispatcher))
+				{
+					queueSampled(m_TerrainSystem->GetSurfaceMap()->GetImage(), mapReaders);
+					queueSampled(m_TerrainSystem->GetMaterialMap()->GetImage(), mapReaders);
+				}
+
+				if (m_TerrainSystem->DispatchVirtualPages(cmd, dispatcher))
+				{
+					queueSampled(m_TerrainSystem->GetVirtualAlbedo()->GetImage(), VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR);
+					queueSampled(m_TerrainSystem->GetVirtualNormal()->GetImage(), VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR);
+				}
+
+				// After the surface map is rebuilt: a changed terrain rebakes it
+				if (m_TerrainSystem->DispatchSunShadow(cmd, dispatcher))
+				{
+					queueSampled(m_TerrainSystem->GetSunShadowMap()->GetImage(), VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR);
+				}
+				dispatcher->FlushBarriers(cmd);
+
+				// Does its own barriers; leaves the heightmap sampler-ready
+				m_TerrainSystem->RecordHeightmapReadback(cmd, frameIndex);
+			})
+				.WriteManaged(terrainSurface, RGAccess::GraphicsSample)
+				.WriteManaged(terrainMaterial, RGAccess::FragmentSample)
+				.WriteManaged(terrainVirtualAlbedo, RGAccess::FragmentSample)
+				.WriteManaged(terrainVirtualNormal, RGAccess::FragmentSample)
+				.WriteManaged(terrainShadow, RGAccess::FragmentSample)
+				.SideEffect();   // CPU height readback
+		}
+
+		if (compute && m_OcclusionCuller)
+		{
+			graph.AddPass("Mesh Occlusion", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_OcclusionCuller->DispatchMeshTest(cmd, m_ComputeDispatcher.get(), frameIndex);
+			})
+				.Write(meshDraws, RGAccess::ComputeWrite);
+		}
+
+		if (compute && m_MeshletCuller)
+		{
+			graph.AddPass("Meshlet Cull", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_MeshletCuller->Dispatch(cmd, m_ComputeDispatcher.get(), frameIndex);
+			})
+				.Write(meshletDraws, RGAccess::ComputeWrite)
+				.Write(meshletCounts, RGAccess::ComputeWrite);
+		}
+
+		// Once per frame, ahead of the shadow cascades, reflection, auxiliary
+		// views and scene pass, which all draw the result
+		if (compute && m_SkinningSystem)
+		{
+			graph.AddPass("Skinning", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_SkinningSystem->Dispatch(cmd, m_ComputeDispatcher.get(), frameIndex);
+			})
+				.Write(skinnedVertices, RGAccess::ComputeWrite);
+		}
+
+		if (compute && m_ComputeEnabled)
+		{
+			graph.AddPass("Compute Test", "Compute", [this](VkCommandBuffer cmd) { RecordComputeTestPass(cmd); })
+				.SideEffect();
+		}
+
+		// Bakes the wind around the camera; without compute (or disabled) it
+		// clears the field to still air once, so it runs either way
+		if (m_WindField)
+		{
+			graph.AddPass("Wind", "Compute", [this](VkCommandBuffer cmd)
+			{
+				m_WindField->Record(cmd, m_ComputeDispatcher.get(), m_WindSettings,
+					glm::vec2(m_CameraPosition.x, m_CameraPosition.z), m_TotalTime);
+			})
+				.WriteManaged(wind, RGAccess::GraphicsSample);
+		}
+
+		// Rebuilds whichever atmosphere LUTs the sun and camera invalidated
+		// (the froxels every frame); clears them once when off
+		if (m_AtmosphereLuts)
+		{
+			graph.AddPass("Atmosphere", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_AtmosphereLuts->Record(cmd, m_ComputeDispatcher.get(),
+					m_DescriptorManager->GetUniformDescriptorSet(frameIndex));
+			})
+				.WriteManaged(skyView, RGAccess::FragmentSample)
+				.WriteManaged(aerialPerspective, RGAccess::FragmentSample);
+		}
+
+		// Fireflies, clouds and the ocean waves go to the async compute queue
+		// when there is one (RecordAsyncComputePass); their results are
+		// acquired after the shadow pass
+		if (fireflies && !asyncCompute)
+		{
+			graph.AddPass("Fireflies", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_FireflySystem->DispatchCompute(cmd, m_ComputeDispatcher.get(), frameIndex, m_LastDeltaTime);
+			})
+				.Write(agents, RGAccess::ComputeWrite);
+		}
+
+		if (compute && m_GrassSystem)
+		{
+			graph.AddPass("Grass Cull", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_GrassSystem->DispatchCull(cmd, m_ComputeDispatcher.get(), frameIndex);
+			})
+				.Write(grassIndirect, RGAccess::ComputeWrite)
+				.Write(grassCount, RGAccess::ComputeWrite)
+				.Write(grassLod, RGAccess::ComputeWrite);
+		}
+
+		if (clouds && !asyncCompute)
+		{
+			graph.AddPass("Clouds", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_CloudSystem->DispatchRaymarch(cmd, m_ComputeDispatcher.get(), frameIndex);
+			})
+				.WriteManaged(cloudResult, RGAccess::ComputeWrite)
+				.WriteManaged(cloudShadow, RGAccess::ComputeSample);
+
+			// Second raymarch from the mirror-flipped reflection camera, composited
+			// into the water reflection target by RecordReflectionPass. Culled
+			// along with the reflection pass when no water is in view.
+			graph.AddPass("Cloud Reflection", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_CloudSystem->DispatchReflectionRaymarch(cmd, m_ComputeDispatcher.get(), frameIndex,
+					m_DescriptorManager->GetReflectionUniformDescriptorSet(frameIndex));
+			})
+				.Read(cloudShadow, RGAccess::ComputeSample)
+				.WriteManaged(cloudReflection, RGAccess::ComputeWrite);
+		}
+
+		// FFT ocean (WaterSystem's FFT wave mode). Culled with the scene's read
+		// when no water is in view.
+		if (oceanWaves && !asyncCompute)
+		{
+			graph.AddPass("Ocean Waves", "Compute", [this](VkCommandBuffer cmd)
+			{
+				m_WaterSystem->DispatchWaves(cmd, m_ComputeDispatcher.get(), m_TotalTime);
+			})
+				.WriteManaged(oceanDisplacement, RGAccess::ComputeWrite)
+				.WriteManaged(oceanDerivatives, RGAccess::ComputeWrite);
+		}
 
 		// =========================================================================
-		// COMPUTE PASS - Runs BEFORE any render passes (outside render pass)
+		// LOCAL SHADOW PASS - the point light faces whose casters changed
 		// =========================================================================
-		if ((m_ComputeEnabled || m_FireflySystem) && m_ComputeDispatcher)
+		if (localShadowAtlas != RG_INVALID && m_LocalShadows->HasWork())
 		{
-			uint32_t s = m_GpuProfiler ? m_GpuProfiler->BeginScope(profCmd, "Compute") : UINT32_MAX;
-			RecordComputePass(frameIndex);
-			if (m_GpuProfiler) m_GpuProfiler->EndScope(profCmd, s);
+			graph.AddPass("Local Shadows", "Shadow (Local)", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_LocalShadows->Record(cmd, [this, frameIndex](VkCommandBuffer faceCmd, const glm::mat4& faceViewProj,
+					const Frustum& faceFrustum, const glm::vec4& lightSphere)
+				{
+					RecordLocalShadowCasters(faceCmd, frameIndex, faceViewProj, faceFrustum, lightSphere);
+				});
+			})
+				.Read(skinnedVertices, RGAccess::VertexInput)
+				.RenderTarget(localShadowAtlas, readOnly, fragment);
 		}
 
 		// =========================================================================
 		// SHADOW PASS
 		// =========================================================================
-		if (m_ShadowEnabled && m_ShadowManager)
+		if (shadowMap != RG_INVALID && m_RayTracedShadowActive)
+		{
+			// The lit passes trace this frame's casters instead; the map is
+			// left as it is, and only bound
+			graph.AddPass("Ray Traced Shadows", "Shadow (RT)", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_RayTracedShadows->Record(cmd, frameIndex, m_RayTracedShadowSettings);
+			})
+				.SideEffect();   // the TLAS is bound outside the graph
+		}
+		else if (shadowMap != RG_INVALID)
 		{
-			uint32_t s = m_GpuProfiler ? m_GpuProfiler->BeginScope(profCmd, "Shadow (CSM)") : UINT32_MAX;
-			RecordShadowPass(frameIndex);
-			if (m_GpuProfiler) m_GpuProfiler->EndScope(profCmd, s);
+			graph.AddPass("Shadow", "Shadow (CSM)", [this, frameIndex](VkCommandBuffer) { RecordShadowPass(frameIndex); })
+				.Read(skinnedVertices, RGAccess::VertexInput)
+				.Read(terrainSurface, RGAccess::GraphicsSample)
+				.Read(wind, RGAccess::GraphicsSample)
+				.RenderTarget(shadowMap, readOnly, fragment);
 		}
 
 		// =========================================================================
-		// REFLECTION PASS - re-render opaque geometry from the mirror-flipped
-		// camera into the reflection target, which the water surface samples in
-		// the scene pass below. Only runs when a WaterSystem is registered.
+		// ASYNC COMPUTE HANDOFF - everything from here on may read the async
+		// compute results, so the frame's command buffer is split here: the
+		// head is submitted first and the compute submission signals the rest.
 		// =========================================================================
-		if (m_WaterSystem)
+		if (asyncCompute)
 		{
-			uint32_t s = m_GpuProfiler ? m_GpuProfiler->BeginScope(profCmd, "Reflection") : UINT32_MAX;
-			RecordReflectionPass(frameIndex);
-			if (m_GpuProfiler) m_GpuProfiler->EndScope(profCmd, s);
+			graph.AddPass("Async Compute Acquire", nullptr, [this, frameIndex](VkCommandBuffer)
+			{
+				if (!m_AsyncComputeFrame) return;
+				m_FrameHeadCommandBuffer = m_Commands->SplitCommandBuffer(frameIndex);
+				AcquireAsyncComputeResults(m_Commands->GetCommandBuffer(frameIndex), m_AsyncComputeReleased);
+			})
+				.WriteManaged(agents, RGAccess::VertexRead)
+				.WriteManaged(cloudResult, RGAccess::ComputeSample)
+				.WriteManaged(cloudReflection, RGAccess::FragmentSample)
+				.WriteManaged(cloudShadow, RGAccess::FragmentSample)
+				.WriteManaged(oceanDisplacement, RGAccess::GraphicsSample)
+				.WriteManaged(oceanDerivatives, RGAccess::GraphicsSample)
+				.SideEffect();
 		}
 
 		// =========================================================================
-		// SCENE PASS - all normal geometry, into the offscreen scene-color
-		// texture (not the swapchain) so the post-process pass can sample it.
+		// CLOUD UPSAMPLE - the main raymarch result to full resolution for the
+		// composite (CloudSystem::DispatchUpsample). On the graphics queue
+		// even with async compute, after the acquire.
 		// =========================================================================
-		// Build clear values array
-		// Index 0: Color attachment - clear to background color
-		// Index 1: Depth attachment - clear to 0.0 for reverse-Z (near=1.0, far=0.0)
-		// With MSAA the scene pass has a third (resolve) attachment; its clear
-		// value is unused (LOAD_OP_DONT_CARE) but the count must cover it.
-		std::array<VkClearValue, 3> clearValues{};
-		clearValues[0].color = { {m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a} };
-		clearValues[1].depthStencil = { 0.0f, 0 };  // depth = 0.0 (far plane in reverse-Z), stencil = 0
-		uint32_t clearValueCount = (m_RenderPasses->GetSampleCount() != VK_SAMPLE_COUNT_1_BIT) ? 3u : 2u;
+		if (clouds)
+		{
+			graph.AddPass("Cloud Upsample", "Compute", [this](VkCommandBuffer cmd)
+			{
+				m_CloudSystem->DispatchUpsample(cmd, m_ComputeDispatcher.get());
+			})
+				.Read(cloudResult, RGAccess::ComputeSample)
+				.WriteManaged(cloudComposite, RGAccess::ComputeWrite);
+		}
 
-		uint32_t sceneScope = m_GpuProfiler ? m_GpuProfiler->BeginScope(profCmd, "Scene") : UINT32_MAX;
+		// =========================================================================
+		// ENVIRONMENT PROBE - the far field around the camera, prefiltered
+		// by roughness, on the frames EnvironmentProbeSchedule picks; a
+		// no-op otherwise (see EnvironmentProbeCache.hpp). After the acquire,
+		// as the capture reads the cloud shadow map.
+		// =========================================================================
+		if (environmentProbe != RG_INVALID)
+		{
+			graph.AddPass("Environment Probe", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_EnvironmentProbe->Record(cmd, m_ComputeDispatcher.get(),
+					m_DescriptorManager->GetUniformDescriptorSet(frameIndex));
+			})
+				.Read(skyView, RGAccess::ComputeSample)
+				.Read(cloudShadow, RGAccess::ComputeSample)
+				.WriteManaged(environmentProbe, RGAccess::FragmentSample);
+		}
 
-		m_Commands->BeginRenderPass(frameIndex,
-			m_RenderPasses->GetSceneRenderPass(),
-			m_RenderPasses->GetSceneFramebuffer(),
-			m_Swapchain->GetExtent(),
-			clearValues.data(),
-			clearValueCount);
+		// =========================================================================
+		// FIREFLY CULL - this frame's visible fireflies and their two indirect
+		// draws (see FireflySystem.hpp). On the graphics queue even with async
+		// compute, after the acquire, so only the agents change hands.
+		// =========================================================================
+		if (fireflyDrawArgs != RG_INVALID)
+		{
+			graph.AddPass("Firefly Cull", "Compute", [this](VkCommandBuffer cmd)
+			{
+				m_FireflySystem->DispatchCull(cmd, m_ComputeDispatcher.get(),
+					m_ProjectionMatrix * m_ViewMatrix, m_CameraPosition);
+			})
+				.Read(agents, RGAccess::ComputeRead)
+				.Write(fireflyVisible, RGAccess::ComputeWrite)
+				.Write(fireflyDrawArgs, RGAccess::ComputeWrite);
+		}
+
+		// =========================================================================
+		// PARTICLES - emit, update and compact every emitter's particles and
+		// write their indirect draws (see ParticleSystem.hpp). Graphics queue.
+		// =========================================================================
+		if (particles)
+		{
+			graph.AddPass("Particles", "Compute", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_ParticleSystem->Dispatch(cmd, m_ComputeDispatcher.get(), frameIndex, m_LastDeltaTime, m_CameraPosition);
+			})
+				.Write(particlePool, RGAccess::ComputeWrite)
+				.Write(particleAlive, RGAccess::ComputeWrite)
+				.Write(particleCounters, RGAccess::ComputeWrite)
+				.Write(particleArgs, RGAccess::ComputeWrite);
+		}
+
+		// =========================================================================
+		// LIGHT CLUSTERS - the fireflies' point lights and every cluster's
+		// light list for this frame's camera (see LightClusterCuller.hpp).
+		// After the acquire, as it reads this frame's agents.
+		// =========================================================================
+		if (lightClusters)
+		{
+			graph.AddPass("Light Clusters", "Light Clusters", [this, frameIndex, fireflies](VkCommandBuffer cmd)
+			{
+				m_LightClusters->Dispatch(cmd, m_ComputeDispatcher.get(), frameIndex,
+					m_DescriptorManager->GetUniformDescriptorSet(frameIndex),
+					m_DescriptorManager->GetLightingDescriptorSet(frameIndex),
+					fireflies ? m_FireflySystem->GetStorageDescriptorSet() : VK_NULL_HANDLE);
+			})
+				.Read(agents, RGAccess::ComputeRead)
+				.Write(clusterLights, RGAccess::ComputeWrite)
+				.Write(clusterLists, RGAccess::ComputeWrite);
+		}
+
+		// =========================================================================
+		// SHADING RATE - the scene pass's rate image from last frame's Hi-Z
+		// pyramid and the vignette (see VariableRateShading.hpp). Runs even
+		// without compute or disabled: the reflection and scene passes read
+		// their rate images either way, which it then keeps at 1x1.
+		// =========================================================================
+		if (m_VariableRateShading)
+		{
+			graph.AddPass("Shading Rate", "Shading Rate", [this](VkCommandBuffer cmd)
+			{
+				ShadingRateInputs inputs{};
+				inputs.enabled = m_VariableRateShadingSettings.enabled;
+				inputs.nearPlane = m_ProjectionMatrix[3][2];
+				inputs.coarseDistance = m_VariableRateShadingSettings.coarseDistance;
+				inputs.vignetteStrength = m_PostProcessSettings.vignetteStrength;
+				inputs.vignetteDarkening = m_VariableRateShadingSettings.vignetteDarkening;
+				inputs.renderExtent = m_RenderExtent;
+				m_VariableRateShading->Record(cmd, m_ComputeDispatcher.get(), m_OcclusionCuller.get(), inputs);
+			})
+				.SideEffect();   // the rate images are read by the render passes, outside the graph
+		}
+
+		// =========================================================================
+		// REFLECTION PASS - re-render opaque geometry from the mirror-flipped
+		// camera into the reflection target, which the water surface samples in
+		// the scene pass below. Culled unless a water draw is in view; left out
+		// on the frames that reuse an earlier reflection (and with it the
+		// cloud raymarch only it reads).
+		// =========================================================================
+		RGPass reflectionPass = RG_INVALID;
+		if (reflection != RG_INVALID && m_ReflectionDue)
+		{
+			reflectionPass = graph.AddPass("Reflection", "Reflection",
+				[this, frameIndex](VkCommandBuffer) { RecordReflectionPass(frameIndex); })
+				.Read(skinnedVertices, RGAccess::VertexInput)
+				.Read(terrainSurface, RGAccess::GraphicsSample)
+				.Read(terrainMaterial, RGAccess::FragmentSample)
+				.Read(terrainVirtualAlbedo, RGAccess::FragmentSample)
+				.Read(terrainVirtualNormal, RGAccess::FragmentSample)
+				.Read(wind, RGAccess::GraphicsSample)
+				.Read(skyView, RGAccess::FragmentSample)
+				.Read(aerialPerspective, RGAccess::FragmentSample)
+				.Read(cloudShadow, RGAccess::FragmentSample)
+				.Read(terrainShadow, RGAccess::FragmentSample)
+				.Read(cloudReflection, RGAccess::FragmentSample)
+				.Read(environmentProbe, RGAccess::FragmentSample)
+				.Read(localShadowAtlas, RGAccess::FragmentSample)
+				.Read(clusterLights, RGAccess::FragmentRead)   // header only: the reflection shades SceneLighting's lights
+				.RenderTarget(reflection, readOnly, fragment)
+				.GetHandle();
+		}
+
+		// =========================================================================
+		// AUXILIARY VIEWS - the app's secondary cameras (SetAuxiliaryViews),
+		// each drawn from this frame's list into its own target with the
+		// shadow maps, sky LUTs and wind computed for the main view. The UI
+		// samples the targets in the post-process pass.
+		// =========================================================================
+		std::array<RGResource, MAX_AUXILIARY_VIEWS> auxiliaryTargets;
+		auxiliaryTargets.fill(RG_INVALID);
+		for (uint32_t view = 0; view < m_AuxiliaryViewCount; ++view)
+		{
+			const VkImage image = m_RenderPasses->GetAuxiliaryColorImage(view);
+			if (image == VK_NULL_HANDLE)
+				continue;
+
+			auxiliaryTargets[view] = graph.ImportImage(image, VK_IMAGE_LAYOUT_UNDEFINED);
+			const VkBuffer readback = m_AuxiliaryReadbacks[view];
+			RenderGraph::PassBuilder pass = graph.AddPass("Auxiliary View", "Auxiliary Views",
+				[this, frameIndex, view, readback](VkCommandBuffer cmd)
+			{
+				RecordAuxiliaryViewPass(frameIndex, view);
+				// Leaves the target as the render pass does
+				if (readback != VK_NULL_HANDLE)
+					RecordAuxiliaryViewReadback(cmd, view, readback);
+			})
+				.Read(skinnedVertices, RGAccess::VertexInput)
+				.Read(terrainSurface, RGAccess::GraphicsSample)
+				.Read(terrainMaterial, RGAccess::FragmentSample)
+				.Read(terrainVirtualAlbedo, RGAccess::FragmentSample)
+				.Read(terrainVirtualNormal, RGAccess::FragmentSample)
+				.Read(wind, RGAccess::GraphicsSample)
+				.Read(skyView, RGAccess::FragmentSample)
+				.Read(aerialPerspective, RGAccess::FragmentSample)
+				.Read(cloudShadow, RGAccess::FragmentSample)
+				.Read(terrainShadow, RGAccess::FragmentSample)
+				.Read(shadowMap, RGAccess::FragmentSample)
+				.Read(localShadowAtlas, RGAccess::FragmentSample)
+				.Read(environmentProbe, RGAccess::FragmentSample)
+				.Read(clusterLights, RGAccess::FragmentRead)   // header only, as in the reflection
+				.RenderTarget(auxiliaryTargets[view], readOnly, fragment);
+			if (readback != VK_NULL_HANDLE)
+				pass.SideEffect();
+		}
+
+		// =========================================================================
+		// SCREEN-SPACE REFLECTION - the cheap alternative to the pass above
+		// (WaterReflectionMode::ScreenSpace): trace last frame's color and Hi-Z
+		// depth into an image the water samples in place of the reflection
+		// target, which then has no reader and is culled. Culled itself unless a
+		// water draw is in view.
+		// =========================================================================
+		if (ssr)
+		{
+			graph.AddPass("SSR", "SSR", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				ScreenSpaceReflectionTrace trace{};
+				const WaterDesc& water = m_WaterSystem->GetDesc();
+				trace.waterY = water.waterY;
+				trace.nearPlane = m_ProjectionMatrix[3][2];
+				trace.maxDistance = water.ssrMaxDistance;
+				trace.thickness = water.ssrThickness;
+				trace.renderExtent = m_RenderExtent;
+				m_SSR->RecordTrace(cmd, m_ComputeDispatcher.get(), *m_OcclusionCuller,
+					m_DescriptorManager->GetUniformDescriptorSet(frameIndex), trace);
+			})
+				.Read(environmentProbe, RGAccess::ComputeSample)
+				.WriteManaged(ssrReflection, RGAccess::FragmentSample);
+		}
+
+		// =========================================================================
+		// SCENE PASS - all normal geometry, into the offscreen scene-color
+		// texture (not the swapchain) so the post-process pass can sample it.
+		// =========================================================================
+		graph.AddPass("Scene", "Scene", [this, frameIndex](VkCommandBuffer) { RecordScenePass(frameIndex); })
+			.Read(skinnedVertices, RGAccess::VertexInput)
+			.Read(terrainSurface, RGAccess::GraphicsSample)
+			.Read(terrainMaterial, RGAccess::FragmentSample)
+			.Read(terrainVirtualAlbedo, RGAccess::FragmentSample)
+			.Read(terrainVirtualNormal, RGAccess::FragmentSample)
+			.Read(wind, RGAccess::GraphicsSample)
+			.Read(skyView, RGAccess::FragmentSample)
+			.Read(aerialPerspective, RGAccess::FragmentSample)
+			.Read(cloudShadow, RGAccess::FragmentSample)
+			.Read(terrainShadow, RGAccess::FragmentSample)
+			.Read(meshDraws, RGAccess::IndirectRead)
+			.Read(meshletDraws, RGAccess::IndirectRead)
+			.Read(meshletCounts, RGAccess::IndirectRead)
+			.Read(agents, RGAccess::VertexRead)
+			.Read(fireflyVisible, RGAccess::VertexRead)
+			.Read(fireflyDrawArgs, RGAccess::IndirectRead)
+			.Read(particlePool, RGAccess::VertexRead)
+			.Read(particleAlive, RGAccess::VertexRead)
+			.Read(particleCounters, RGAccess::VertexRead)
+			.Read(particleArgs, RGAccess::IndirectRead)
+			.Read(grassIndirect, RGAccess::IndirectRead)
+			.Read(grassCount, RGAccess::IndirectRead)
+			.Read(grassLod, RGAccess::VertexRead)
+			.Read(cloudComposite, RGAccess::FragmentSample)
+			.Read(shadowMap, RGAccess::FragmentSample)
+			.Read(localShadowAtlas, RGAccess::FragmentSample)
+			.Read(environmentProbe, RGAccess::FragmentSample)
+			.Read(clusterLights, RGAccess::FragmentRead)
+			.Read(clusterLists, RGAccess::FragmentRead)
+			.Read(waterVisible ? (ssr ? ssrReflection : reflection) : RG_INVALID, RGAccess::FragmentSample)
+			.Read(waterVisible ? oceanDisplacement : RG_INVALID, RGAccess::GraphicsSample)
+			.Read(waterVisible ? oceanDerivatives : RG_INVALID, RGAccess::GraphicsSample)
+			.RenderTarget(sceneColor, readOnly, fragmentAndCompute)
+			.RenderTarget(sceneDepth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, fragmentAndCompute)
+			.RenderTarget(resolvedDepth != sceneDepth ? resolvedDepth : RG_INVALID,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, fragmentAndCompute);
+
+		// =========================================================================
+		// TRANSPARENCY - with order-independent transparency on, the glass,
+		// water and fireflies the scene pass skipped: accumulated unsorted
+		// against the scene depth, then composited over the scene color in the
+		// same render pass, so bloom, TAA and post see them like before.
+		// =========================================================================
+		if (transparentsVisible)
+		{
+			graph.AddPass("Transparency", "Transparency", [this, frameIndex](VkCommandBuffer) { RecordTransparencyPass(frameIndex); })
+				.Read(skinnedVertices, RGAccess::VertexInput)
+				.Read(wind, RGAccess::GraphicsSample)
+				.Read(agents, RGAccess::VertexRead)
+				.Read(fireflyVisible, RGAccess::VertexRead)
+				.Read(fireflyDrawArgs, RGAccess::IndirectRead)
+				.Read(particlePool, RGAccess::VertexRead)
+				.Read(particleAlive, RGAccess::VertexRead)
+				.Read(particleCounters, RGAccess::VertexRead)
+				.Read(particleArgs, RGAccess::IndirectRead)
+				.Read(shadowMap, RGAccess::FragmentSample)
+				.Read(localShadowAtlas, RGAccess::FragmentSample)
+				.Read(environmentProbe, RGAccess::FragmentSample)
+				.Read(clusterLights, RGAccess::FragmentRead)
+				.Read(clusterLists, RGAccess::FragmentRead)
+				.Read(waterVisible ? (ssr ? ssrReflection : reflection) : RG_INVALID, RGAccess::FragmentSample)
+				.Read(waterVisible ? oceanDisplacement : RG_INVALID, RGAccess::GraphicsSample)
+				.Read(waterVisible ? oceanDerivatives : RG_INVALID, RGAccess::GraphicsSample)
+				.RenderTarget(sceneColor, readOnly, fragmentAndCompute)
+				.RenderTarget(sceneDepth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, fragmentAndCompute);
+		}
+
+		// =========================================================================
+		// CONTACT SHADOWS - march every pixel a short way toward lights[0]
+		// through the depth and darken what the march finds blocked. After
+		// the transparency pass, which (with MSAA) resolves the scene color
+		// again; glass and water write no depth, so what lies under them is
+		// shadowed as if they weren't there.
+		// =========================================================================
+		const LightData& contactLight = m_CurrentLightingData.lights[0];
+		const glm::vec3 contactLightColor = glm::vec3(contactLight.color) * contactLight.color.a;
+		if (compute && m_ContactShadows && m_ShadowEnabled &&
+			ContactShadow::IsActive(m_ContactShadowSettings, contactLightColor))
+		{
+			const ContactShadowData contactData = ContactShadow::Build(m_ContactShadowSettings, m_ViewMatrix,
+				-glm::vec3(contactLight.position), contactLightColor,
+				glm::vec3(m_CurrentLightingData.ambient) * m_CurrentLightingData.ambient.a,
+				glm::uvec2(m_RenderExtent.width, m_RenderExtent.height));
+			graph.AddPass("Contact Shadows", "Contact Shadows", [this, frameIndex, contactData](VkCommandBuffer cmd)
+			{
+				m_ContactShadows->Record(cmd, m_ComputeDispatcher.get(),
+					m_DescriptorManager->GetUniformDescriptorSet(frameIndex), contactData);
+			})
+				.Read(resolvedDepth, RGAccess::DepthSample)
+				.Write(sceneColor, RGAccess::ComputeWrite);
+		}
+
+		// =========================================================================
+		// HI-Z PYRAMID - reduce this frame's scene depth for next frame's
+		// occlusion tests (meshes in the compute passes, grass in GrassCull),
+		// and to the depth range the shadow splits fit to.
+		// =========================================================================
+		if (compute && m_OcclusionCuller)
+		{
+			graph.AddPass("Hi-Z", "Hi-Z", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_OcclusionCuller->BuildPyramid(cmd, m_ComputeDispatcher.get(), m_ProjectionMatrix * m_ViewMatrix,
+					m_RenderExtent);
+				m_OcclusionCuller->DispatchDepthRange(cmd, m_ComputeDispatcher.get(), frameIndex);
+			})
+				.Read(sceneDepth, RGAccess::DepthSample)
+				.SideEffect();   // the pyramid is next frame's input
+
+			// Color to go with the pyramid for next frame's reflection trace.
+			// Kept up to date while the mode is on, even with no water in view.
+			if (ssr)
+			{
+				graph.AddPass("SSR History", "SSR", [this](VkCommandBuffer cmd)
+				{
+					m_SSR->RecordHistory(cmd, m_ComputeDispatcher.get(), *m_OcclusionCuller, m_RenderExtent);
+				})
+					.Read(sceneColor, RGAccess::ComputeSample)
+					.SideEffect();   // the history is next frame's input
+			}
+		}
+		// A history that skipped frames no longer lines up with the pyramid
+		if (m_SSR && !ssr)
+			m_SSR->Invalidate();
+
+		// =========================================================================
+		// BLOOM - prefilter the HDR scene color into the half-res mip chain, then
+		// filter it down and back up (BloomMipChain); the post-process composite
+		// adds mip 0 back. Skipped when bloomIntensity is 0.
+		// =========================================================================
+		if (bloom)
+		{
+			graph.AddPass("Bloom", "Bloom", [this](VkCommandBuffer cmd)
+			{
+				m_BloomChain->Record(cmd, m_ComputeDispatcher.get(), GetSceneUVScale(),
+					m_PostProcessSettings.bloomThreshold);
+			})
+				.Read(sceneColor, RGAccess::ComputeSample)
+				.WriteManaged(bloomChain, RGAccess::FragmentSample);
+		}
+
+		// =========================================================================
+		// TEMPORAL UPSCALE - display-resolution reconstruction from this frame's
+		// jittered samples and the reprojected history; post-process reads it
+		// instead of the scene color.
+		// =========================================================================
+		if (IsTemporalUpscaling() && compute)
+		{
+			graph.AddPass("Temporal Upscale", "Temporal Upscale", [this](VkCommandBuffer cmd)
+			{
+				m_TemporalUpscaler->Resolve(cmd, m_ComputeDispatcher.get(), m_ProjectionMatrix * m_ViewMatrix,
+					m_RenderExtent, m_FrameJitter);
+			})
+				.Read(sceneColor, RGAccess::ComputeSample)
+				.Read(resolvedDepth, RGAccess::DepthSample)
+				.SideEffect();   // output and history are its own (left fragment-readable)
+		}
+
+		// =========================================================================
+		// COMPUTE POST - the post-process composite as one dispatch
+		// (ComputePostProcess); the post-process pass below then only copies
+		// its output to the swapchain.
+		// =========================================================================
+		if (computePost)
+		{
+			graph.AddPass("Compute Post", "PostProcess", [this, bloom](VkCommandBuffer cmd)
+			{
+				const bool temporal = IsTemporalUpscaling();
+				const PostProcessPushConstants push = BuildPostProcessPush(temporal, bloom);
+				m_ComputePost->Record(cmd, m_ComputeDispatcher.get(),
+					temporal ? m_TemporalUpscaler->GetOutputSet() : m_PostProcessInputSet,
+					bloom ? m_BloomChain->GetOutputSet() : m_PostProcessInputSet,
+					&push, sizeof(push));
+			})
+				.Read(sceneColor, RGAccess::ComputeSample)
+				.Read(bloomChain, RGAccess::ComputeSample)
+				.SideEffect();   // output is its own (left fragment-readable)
+		}
+
+		// The cached UI, redrawn only on the frames it is rebuilt; the
+		// post-process pass lays it over the frame
+		if (m_UI && m_UI->NeedsCacheRecord())
+		{
+			graph.AddPass("UI Cache", "UICache", [this, frameIndex](VkCommandBuffer cmd)
+			{
+				m_UI->RecordCache(cmd, frameIndex);
+			})
+				.SideEffect();   // its own target, left fragment-readable
+		}
+
+		// =========================================================================
+		// POST-PROCESS PASS - samples the scene-color texture, runs FXAA, and
+		// writes the actual swapchain image. UI renders after this, directly
+		// on the swapchain target, so it isn't blurred by the AA filter.
+		// =========================================================================
+		{
+			RenderGraph::PassBuilder postProcess = graph.AddPass("PostProcess", "PostProcess+UI",
+				[this, frameIndex, imageIndex](VkCommandBuffer) { RecordPostProcessPass(frameIndex, imageIndex); });
+			if (!computePost)
+			{
+				postProcess
+					.Read(sceneColor, RGAccess::FragmentSample)
+					.Read(bloomChain, RGAccess::FragmentSample);
+			}
+			for (RGResource target : auxiliaryTargets)
+				postProcess.Read(target, RGAccess::FragmentSample);   // shown by the UI
+			postProcess.SideEffect();   // presents
+		}
+
+		// Hand the agent buffer back for the next frame's dispatch
+		if (asyncCompute)
+		{
+			graph.AddPass("Async Compute Release", nullptr, [this](VkCommandBuffer cmd)
+			{
+				if (m_AsyncComputeFrame) ReleaseAsyncComputeResources(cmd, m_AsyncComputeReleased);
+			})
+				.SideEffect();
+		}
+
+		graph.Compile();
+
+		// A due reflection whose pass was culled (no water in view) left the
+		// target unwritten; render it the next time the water shows
+		if (m_ReflectionDue && graph.IsPassCulled(reflectionPass))
+		{
+			m_ReflectionSchedule.Invalidate();
+		}
+
+		// The reflection target shares memory with the bloom chain unless it
+		// is kept across frames (RenderPassManager::CreateTransientTargets)
+		if (!m_TransientAliasingBroken && !m_RenderPasses->IsReflectionPersistent() &&
+			graph.LifetimesOverlap(reflection, bloomChain))
+		{
+			LOG_ERROR("Reflection target is live during bloom but aliases its memory - the frame will be corrupted");
+			m_TransientAliasingBroken = true;
+		}
+
+		// =========================================================================
+		// ASYNC COMPUTE - fireflies, clouds and ocean waves on the compute
+		// queue. Submitted in EndFrame between the head of this command buffer
+		// (up to the shadow pass) and the rest, which consumes the results.
+		// =========================================================================
+		m_FrameHeadCommandBuffer = VK_NULL_HANDLE;
+		m_AsyncComputeReleased = {};
+		m_AsyncComputeFrame = asyncCompute &&
+			RecordAsyncComputePass(frameIndex, m_AsyncComputeReleased, !graph.IsPassCulled(reflectionPass));
+
+		// Water samples whichever reflection was produced this frame
+		m_Commands->SetReflectionInputSet(ssr ? m_SSR->GetOutputSet() : m_ReflectionInputSet);
+
+		graph.Execute([this, frameIndex]() { return m_Commands->GetCommandBuffer(frameIndex); }, m_GpuProfiler.get());
+
+		if (m_GpuProfiler) m_GpuProfiler->EndFrame(frameIndex);
+
+		m_Commands->EndCommandBuffer(frameIndex);
+	}
+
+	void Renderer::RecordScenePass(uint32_t frameIndex)
+	{
+		// Build clear values array
+		// Index 0: Color attachment - clear to background color
+		// Index 1: Depth attachment - clear to 0.0 for reverse-Z (near=1.0, far=0.0)
+		// With MSAA the scene pass has a third (resolve) attachment; its clear
+		// value is unused (LOAD_OP_DONT_CARE) but the count must cover it.
+		std::array<VkClearValue, 3> clearValues{};
+		clearValues[0].color = { {m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a} };
+		clearValues[1].depthStencil = { 0.0f, 0 };  // depth = 0.0 (far plane in reverse-Z), stencil = 0
+		uint32_t clearValueCount = (m_RenderPasses->GetSampleCount() != VK_SAMPLE_COUNT_1_BIT) ? 3u : 2u;
+
+		const bool parallel = m_Commands->IsParallelRecording();
+		VkExtent2D sceneExtent = m_RenderExtent;
+
+		m_Commands->BeginRenderPass(frameIndex,
+			m_RenderPasses->GetSceneRenderPass(),
+			m_RenderPasses->GetSceneFramebuffer(),
+			sceneExtent,
+			clearValues.data(),
+			clearValueCount,
+			parallel ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+		// Execute draw list
+		if (parallel)
+		{
+			// Chunks of the draw list are recorded into secondaries on the worker
+			// threads; the primary only executes them (in list order).
+			SecondaryPassInfo pass;
+			pass.renderPass = m_RenderPasses->GetSceneRenderPass();
+			pass.framebuffer = m_RenderPasses->GetSceneFramebuffer();
+			pass.viewport = { 0.0f, 0.0f,
+				static_cast<float>(sceneExtent.width), static_cast<float>(sceneExtent.height), 0.0f, 1.0f };
+			pass.scissor = { { 0, 0 }, sceneExtent };
+
+			m_Commands->ExecuteDrawListParallel(frameIndex, m_FrameDrawList,
+				m_PipelineAdapter.get(),
+				m_ViewMatrix, m_ProjectionMatrix, pass);
+		}
+		else if (m_FrameDrawList.GetCommandCount() > 0)
+		{
+			m_Commands->ExecuteDrawList(frameIndex, m_FrameDrawList,
+				m_PipelineAdapter.get(),
+				m_ViewMatrix, m_ProjectionMatrix);
+		}
+
+		m_Commands->EndRenderPass(frameIndex);
+	}
+
+	void Renderer::RecordTransparencyPass(uint32_t frameIndex)
+	{
+		// Index 0: accumulation - clear to 0 (nothing summed yet)
+		// Index 1: revealage - clear to 1 (fully revealed)
+		// Index 2/3: scene depth and color, loaded; with MSAA 4/5 are the
+		// accumulation/revealage resolves. Unused, but the count must cover them.
+		std::array<VkClearValue, 6> clearValues{};
+		clearValues[0].color = { {0.0f, 0.0f, 0.0f, 0.0f} };
+		clearValues[1].color = { {1.0f, 1.0f, 1.0f, 1.0f} };
+		uint32_t clearValueCount = (m_RenderPasses->GetSampleCount() != VK_SAMPLE_COUNT_1_BIT) ? 6u : 4u;
+
+		m_Commands->BeginRenderPass(frameIndex,
+			m_RenderPasses->GetOitRenderPass(),
+			m_RenderPasses->GetOitFramebuffer(),
+			m_RenderExtent,
+			clearValues.data(),
+			clearValueCount,
+			VK_SUBPASS_CONTENTS_INLINE);
+
+		// Subpass 0: every transparent, in list order (the order doesn't matter)
+		m_Commands->ExecuteTransparentDrawList(frameIndex, m_FrameDrawList, m_PipelineAdapter.get());
+
+		// Subpass 1: resolve the pair over the scene color
+		m_Commands->NextSubpass(frameIndex);
+
+		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+		m_PipelineAdapter->BindPipeline(cmd, PipelineType::OitComposite);
+		VkPipelineLayout layout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::OitComposite);
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+			0, 1, &m_OitInputSet, 0, nullptr);
+		vkCmdDraw(cmd, 3, 1, 0, 0);
+
+		RenderStats& stats = RenderStats::Get();
+		stats.Add(RenderCounter::PipelineBinds);
+		stats.Add(RenderCounter::DescriptorBinds);
+		stats.AddDraw(3, 1);
+
+		m_Commands->EndRenderPass(frameIndex);
+	}
+
+	void Renderer::RecordComputeTestPass(VkCommandBuffer cmd)
+	{
+		// Get compute pipeline and layout
+		VkPipeline computePipeline = m_PipelineAdapter->GetVulkanManager()->GetPipeline(PipelineType::Compute);
+		VkPipelineLayout computeLayout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::Compute);
+
+		if (computePipeline == VK_NULL_HANDLE || computeLayout == VK_NULL_HANDLE)
+		{
+			LOG_WARN("Compute pipeline or layout is null");
+			return;
+		}
+
+		// Bind compute pipeline
+		m_ComputeDispatcher->BindPipeline(cmd, computePipeline);
+
+		// Bind descriptor set with our storage buffers
+		m_ComputeDispatcher->BindDescriptorSet(cmd, computeLayout, 0, m_ComputeTestDescriptorSet);
+
+		// Set push constants with current time
+		ComputePushConstants pushData;
+		pushData.dataSize = COMPUTE_TEST_ELEMENT_COUNT;
+		pushData.time = m_TotalTime;  // Use the renderer's time value
+
+		m_ComputeDispatcher->PushConstants(cmd, computeLayout, &pushData, sizeof(pushData));
+
+		// Dispatch compute work
+		// With local_size_x = 64, we need 1 workgroup for 64 elements
+		uint32_t groupCountX = ComputeDispatcher::CalculateGroupCount(COMPUTE_TEST_ELEMENT_COUNT, 64);
+		m_ComputeDispatcher->Dispatch(cmd, groupCountX, 1, 1);
+
+		// Barrier: ensure compute writes are visible before any graphics work
+		m_ComputeDispatcher->ComputeToGraphicsGlobalBarrier(cmd);
+	}
+
+	bool Renderer::RecordAsyncComputePass(uint32_t frameIndex, AsyncComputeRelease& released, bool cloudReflection)
+	{
+		const bool fireflies = m_FireflySystem && m_FireflySystem->IsReady();
+		const bool clouds = m_CloudSystem && m_CloudSystem->IsReady();
+		const bool oceanWaves = m_WaterSystem && m_WaterSystem->IsSimulatingWaves();
+		if (!fireflies && !clouds && !oceanWaves)
+		{
+			return false;
+		}
+
+		VkCommandBuffer cmd = m_AsyncCompute->Begin(frameIndex);
+		if (cmd == VK_NULL_HANDLE)
+		{
+			return false;
+		}
+
+		// Timed on the compute queue's own timeline (GpuProfiler)
+		auto beginScope = [&](const char* name)
+		{
+			return m_GpuProfiler ? m_GpuProfiler->BeginScope(cmd, name, GpuQueue::Compute) : UINT32_MAX;
+		};
+		auto endScope = [&](uint32_t scope)
+		{
+			if (m_GpuProfiler) m_GpuProfiler->EndScope(cmd, scope, GpuQueue::Compute);
+		};
+		if (m_GpuProfiler) m_GpuProfiler->BeginQueue(cmd, GpuQueue::Compute);
+		const uint32_t frameScope = beginScope("Async Compute");
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		const uint32_t graphicsFamily = vkDevice->GetGraphicsQueueFamily();
+		const uint32_t computeFamily = m_AsyncCompute->GetQueueFamily();
+		m_AsyncComputeWaitsOnHead = false;
+
+		if (fireflies)
+		{
+			VkBuffer agents = m_FireflySystem->GetAgentBuffer();
+			VkDeviceSize agentBytes = m_FireflySystem->GetAgentBufferSize();
+
+			// Not handed over by the last frame: the buffer is fresh from its
+			// upload, so graphics still owns it. Release it at the head of this
+			// frame, which the compute submission then has to wait for.
+			if (m_AgentBufferReleasedToCompute != agents)
+			{
+				m_ComputeDispatcher->ReleaseBufferOwnership(m_Commands->GetCommandBuffer(frameIndex),
+					agents, agentBytes, graphicsFamily, computeFamily,
+					VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT);
+				m_AsyncComputeWaitsOnHead = true;
+			}
+			m_ComputeDispatcher->AcquireBufferOwnership(cmd, agents, agentBytes, graphicsFamily, computeFamily,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+			m_AgentBufferReleasedToCompute = VK_NULL_HANDLE;
+
+			const uint32_t scope = beginScope("Fireflies");
+			m_FireflySystem->DispatchCompute(cmd, m_ComputeDispatcher.get(), frameIndex, m_LastDeltaTime);
+			endScope(scope);
+
+			m_ComputeDispatcher->ReleaseBufferOwnership(cmd, agents, agentBytes, computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+			released.agentBuffer = agents;
+			released.agentBufferSize = agentBytes;
+		}
+
+		// The result images need no transfer back: each dispatch rewrites
+		// every pixel, so they start from UNDEFINED on this queue
+		auto releaseResult = [&](VkImage image)
+		{
+			m_ComputeDispatcher->ReleaseImageOwnership(cmd, image,
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+			return image;
+		};
+
+		if (oceanWaves)
+		{
+			const uint32_t scope = beginScope("Ocean Waves");
+			m_WaterSystem->DispatchWaves(cmd, m_ComputeDispatcher.get(), m_TotalTime);
+			endScope(scope);
+			released.oceanDisplacement = releaseResult(m_WaterSystem->GetWaves().GetDisplacementImage());
+			released.oceanDerivatives = releaseResult(m_WaterSystem->GetWaves().GetDerivativesImage());
+		}
+
+		if (clouds)
+		{
+			const uint32_t cloudScope = beginScope("Clouds");
+			m_CloudSystem->DispatchRaymarch(cmd, m_ComputeDispatcher.get(), frameIndex);
+			if (VkImage result = m_CloudSystem->GetRaymarchResultImage())
+			{
+				released.cloudResult = releaseResult(result);
+			}
+			// Baked by DispatchRaymarch and already sampler-ready
+			if (m_CurrentFrameData.cloudShadow.z > 0.0f)
+			{
+				released.cloudShadowMap = m_CloudSystem->GetShadowMapImage();
+				m_ComputeDispatcher->ReleaseImageOwnership(cmd, released.cloudShadowMap,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					computeFamily, graphicsFamily,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+			}
+
+			if (cloudReflection)
+			{
+				const uint32_t scope = beginScope("Cloud Reflection");
+				m_CloudSystem->DispatchReflectionRaymarch(cmd, m_ComputeDispatcher.get(), frameIndex,
+					m_DescriptorManager->GetReflectionUniformDescriptorSet(frameIndex));
+				endScope(scope);
+				if (VkImage result = m_CloudSystem->GetReflectionResultImage())
+				{
+					released.cloudReflectionResult = releaseResult(result);
+				}
+			}
+			endScope(cloudScope);
+		}
+
+		endScope(frameScope);
+		return true;
+	}
+
+	void Renderer::AcquireAsyncComputeResults(VkCommandBuffer cmd, const AsyncComputeRelease& released)
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		const uint32_t graphicsFamily = vkDevice->GetGraphicsQueueFamily();
+		const uint32_t computeFamily = m_AsyncCompute->GetQueueFamily();
+
+		// Same dst stages as the compute->graphics barriers these replace; the
+		// agents are also read by the light cluster gather (compute)
+		if (released.agentBuffer != VK_NULL_HANDLE)
+		{
+			m_ComputeDispatcher->AcquireBufferOwnership(cmd, released.agentBuffer, released.agentBufferSize,
+				computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		}
+
+		// The main result is read by the upsample, the reflection's by its composite
+		if (released.cloudResult != VK_NULL_HANDLE)
+		{
+			m_ComputeDispatcher->AcquireImageOwnership(cmd, released.cloudResult,
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		}
+		if (released.cloudReflectionResult != VK_NULL_HANDLE)
+		{
+			m_ComputeDispatcher->AcquireImageOwnership(cmd, released.cloudReflectionResult,
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		}
+
+		if (released.cloudShadowMap != VK_NULL_HANDLE)
+		{
+			m_ComputeDispatcher->AcquireImageOwnership(cmd, released.cloudShadowMap,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		}
+
+		// The wave displacement is read by Water.vert
+		for (VkImage image : { released.oceanDisplacement, released.oceanDerivatives })
+		{
+			if (image == VK_NULL_HANDLE) continue;
+			m_ComputeDispatcher->AcquireImageOwnership(cmd, image,
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				computeFamily, graphicsFamily,
+				VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+		}
+	}
+
+	void Renderer::ReleaseAsyncComputeResources(VkCommandBuffer cmd, const AsyncComputeRelease& released)
+	{
+		// Only the agent buffer carries state into the next frame's dispatch
+		if (released.agentBuffer == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		m_ComputeDispatcher->ReleaseBufferOwnership(cmd, released.agentBuffer, released.agentBufferSize,
+			vkDevice->GetGraphicsQueueFamily(), m_AsyncCompute->GetQueueFamily(),
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0);
+		m_AgentBufferReleasedToCompute = released.agentBuffer;
+	}
+
+	bool Renderer::IsAsyncComputeEnabled() const
+	{
+		return m_AsyncCompute && m_AsyncCompute->IsAvailable();
+	}
+
+	// =====================================================================
+	// FIX: RecordShadowPass no longer touches the camera uniforms.
+	//
+	// The old version wrote light matrices into the camera UBO, recorded
+	// GPU commands, then restored camera data � all CPU-side. But the GPU
+	// doesn't execute until submit, so by that time the buffer always
+	// contained camera data for BOTH passes.
+	//
+	// Now the shadow pass has its own dedicated UBO (m_ShadowUniformSlots),
+	// uploaded once in BeginFrame, and binds its own descriptor set here.
+	// =====================================================================
+	void Renderer::RecordShadowPass(uint32_t frameIndex)
+	{
+		if (!m_ShadowEnabled || !m_ShadowManager)
+		{
+			return;
+		}
+
+		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+
+		VkExtent2D shadowExtent = m_ShadowManager->GetShadowExtent();
+
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(shadowExtent.width);
+		viewport.height = static_cast<float>(shadowExtent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+
+		VkRect2D scissor{};
+		scissor.offset = { 0, 0 };
+		scissor.extent = shadowExtent;
+
+		VkClearValue depthClear{};
+		depthClear.depthStencil = { 1.0f, 0 };  // Standard depth (not reverse-Z)
+
+		// Every cascade renders into its own array layer, with its own framebuffer and
+		// set-0 UBO (that cascade's light VP). Near cascades redraw everything. Cached far
+		// cascades keep their static (terrain) depth in the static cache, re-rendered only
+		// when the cascade refits or the terrain changes, and each frame restore it and
+		// draw just the dynamic casters over it.
+		CullShadowCasters();
+
+		const uint64_t staticSignature = ComputeStaticCasterSignature();
+		if (staticSignature != m_StaticCasterSignature)
+		{
+			m_StaticCasterSignature = staticSignature;
+			m_StaticShadowDirtyMask = ~0u;
+		}
+
+		if (m_LayeredShadowsSupported && m_ShadowConfig.singlePassCascades)
+		{
+			RecordShadowPassLayered(frameIndex, viewport, scissor);
+			return;
+		}
+
+		struct ShadowStep
+		{
+			uint32_t cascade;
+			VkRenderPass renderPass;
+			VkFramebuffer framebuffer;
+			ShadowCasterFilter filter;
+			bool restoreStatic;  // copy the static cache layer in before the pass
+			bool replayStatic;   // execute the cascade's cached static secondary first
+		};
+		std::vector<ShadowStep> steps;
+		steps.reserve(NUM_CASCADES * 2);
+
+		// Near cascades draw the terrain every frame; with command caching it is
+		// replayed from a secondary kept across frames and only the dynamic
+		// casters are recorded
+		const bool cacheStatic = m_StaticCommandCaching;
+		const uint32_t firstCached = ShadowCascadeCache::FirstCachedCascade(m_ShadowConfig);
+		for (uint32_t cascade = 0; cascade < NUM_CASCADES; ++cascade)
+		{
+			VkFramebuffer framebuffer = m_ShadowManager->GetShadowFramebuffer(cascade);
+			if (cascade < firstCached)
+			{
+				steps.push_back({ cascade, m_ShadowManager->GetShadowRenderPass(), framebuffer,
+					cacheStatic ? ShadowCasterFilter::DynamicOnly : ShadowCasterFilter::All, false, cacheStatic });
+				continue;
+			}
+
+			if (m_StaticShadowDirtyMask & (1u << cascade))
+			{
+				steps.push_back({ cascade, m_ShadowManager->GetStaticCacheRenderPass(),
+					m_ShadowManager->GetStaticCacheFramebuffer(cascade), ShadowCasterFilter::StaticOnly, false, false });
+			}
+			steps.push_back({ cascade, m_ShadowManager->GetShadowLoadRenderPass(), framebuffer,
+				ShadowCasterFilter::DynamicOnly, true, false });
+		}
+		m_StaticShadowDirtyMask = 0;
+
+		const bool parallel = m_Commands->IsParallelRecording();
+		// A replayed secondary means the pass takes secondaries only
+		const bool secondaries = parallel || cacheStatic;
+
+		// A cascade at a reduced resolution only fills the top-left corner of its
+		// layer (ShadowCascadeResolution.hpp); the rest stays cleared
+		auto cascadeScissor = [&](uint32_t cascade)
+		{
+			const uint32_t texels = m_CascadeTexels[cascade] > 0
+				? std::min(m_CascadeTexels[cascade], shadowExtent.width) : shadowExtent.width;
+			return VkRect2D{ { 0, 0 }, { texels, std::min(texels, shadowExtent.height) } };
+		};
+
+		// Passes are independent, so in parallel mode each one is recorded into its
+		// own secondary up front; the loop below then only begins/executes/ends on
+		// the primary. Without parallel recording they are recorded one at a
+		// time on this thread.
+		std::vector<VkCommandBuffer> stepSecondaries;
+		std::vector<VkCommandBuffer> staticSecondaries(steps.size(), VK_NULL_HANDLE);
+		if (secondaries)
+		{
+			std::vector<SecondaryRecordTask> tasks(steps.size());
+			for (size_t i = 0; i < steps.size(); ++i)
+			{
+				const ShadowStep step = steps[i];
+				tasks[i].pass.renderPass = step.renderPass;
+				tasks[i].pass.framebuffer = step.framebuffer;
+				tasks[i].pass.viewport = viewport;
+				tasks[i].pass.scissor = cascadeScissor(step.cascade);
+				tasks[i].record = [this, frameIndex, step](VkCommandBuffer secondary)
+				{
+					RecordShadowCasters(secondary, frameIndex, step.cascade, step.filter);
+				};
+
+				if (step.replayStatic)
+				{
+					SecondaryRecordTask staticTask;
+					staticTask.pass = tasks[i].pass;
+					staticTask.record = [this, frameIndex, step](VkCommandBuffer secondary)
+					{
+						RecordShadowCasters(secondary, frameIndex, step.cascade, ShadowCasterFilter::StaticOnly);
+					};
+					staticSecondaries[i] = m_Commands->GetCachedSecondary(frameIndex,
+						CACHED_SHADOW_CASCADE_ID + step.cascade,
+						ComputeStaticShadowRecordSignature(frameIndex, 1u << step.cascade, false), staticTask);
+				}
+			}
+
+			if (parallel)
+			{
+				stepSecondaries = m_Commands->RecordSecondaries(frameIndex, tasks);
+			}
+			else
+			{
+				stepSecondaries.resize(tasks.size(), VK_NULL_HANDLE);
+				for (size_t i = 0; i < tasks.size(); ++i)
+					stepSecondaries[i] = m_Commands->RecordSecondaries(frameIndex, { tasks[i] })[0];
+			}
+		}
+
+		// A profiler scope per cascade, so its timing and pipeline
+		// statistics show up under "Shadow (CSM)"
+		static const StringId cascadeScopes[] = { "Cascade 0", "Cascade 1", "Cascade 2", "Cascade 3" };
+		static const StringId staticScopes[] = { "Cascade 0 Static", "Cascade 1 Static", "Cascade 2 Static", "Cascade 3 Static" };
+		static_assert(std::size(cascadeScopes) == NUM_CASCADES, "one scope name per cascade");
+
+		for (size_t i = 0; i < steps.size(); ++i)
+		{
+			const ShadowStep& step = steps[i];
+			const bool staticPass = step.filter == ShadowCasterFilter::StaticOnly;
+			const uint32_t scope = m_GpuProfiler
+				? m_GpuProfiler->BeginScope(cmd, staticPass ? staticScopes[step.cascade] : cascadeScopes[step.cascade])
+				: UINT32_MAX;
+			if (step.restoreStatic)
+			{
+				m_ShadowManager->RecordRestoreStaticCascade(cmd, step.cascade);
+			}
+
+			VkRenderPassBeginInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = step.renderPass;
+			renderPassInfo.framebuffer = step.framebuffer;
+			renderPassInfo.renderArea.offset = { 0, 0 };
+			renderPassInfo.renderArea.extent = shadowExtent;
+			renderPassInfo.clearValueCount = 1;  // ignored by the load pass
+			renderPassInfo.pClearValues = &depthClear;
+
+			if (secondaries)
+			{
+				vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+				m_Commands->ExecuteSecondaries(frameIndex, { staticSecondaries[i], stepSecondaries[i] });
+				vkCmdEndRenderPass(cmd);
+			}
+			else
+			{
+				vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+				const VkRect2D stepScissor = cascadeScissor(step.cascade);
+				vkCmdSetViewport(cmd, 0, 1, &viewport);
+				vkCmdSetScissor(cmd, 0, 1, &stepScissor);
+
+				RecordShadowCasters(cmd, frameIndex, step.cascade, step.filter);
+
+				vkCmdEndRenderPass(cmd);
+			}
+
+			if (m_GpuProfiler) m_GpuProfiler->EndScope(cmd, scope);
+		}
+		// No UBO restore needed � each pass has its own dedicated buffer
+	}
+
+	bool Renderer::IsShadowCaster(const DrawCommand& drawCmd)
+	{
+		// Only opaque WORLD geometry casts shadows. Whitelist Mesh + Terrain and
+		// skip everything else. In particular the Water plane (PipelineType::Water)
+		// was being drawn here — a big flat caster that painted a spurious shadow
+		// on the terrain and, because a horizontal plane's shadow-map coverage
+		// swings hard with the light angle, spiked the shadow cost across the
+		// day/night cycle. Foliage/Clouds/Firefly/Transparent are excluded too.
+		if (drawCmd.pipeline != PipelineType::Mesh &&
+			drawCmd.pipeline != PipelineType::Terrain)
+		{
+			return false;
+		}
+
+		// Skip emissive light-source discs (moon/sun): customData.w >= 2.0 flags
+		// an unlit emissive surface (see Mesh.frag). A celestial light source
+		// shouldn't cast shadows, and because it tracks the light its shadow-map
+		// overdraw would otherwise vary with time of day.
+		if (drawCmd.hasPushConstants && drawCmd.pushConstants.customData.w >= 2.0f)
+		{
+			return false;
+		}
+
+		// Skip if no vertex buffer; terrain has none, its patch grid is
+		// placed from gl_VertexIndex
+		return drawCmd.vertexBuffer != nullptr || drawCmd.pipeline == PipelineType::Terrain;
+	}
+
+	// Single-pass variant of RecordShadowPass: the same per-cascade work (full redraw
+	// for near cascades; static restore + dynamic casters for cached far ones) but
+	// every cascade in one layered pass, each draw recorded once and instanced across
+	// the cascades it reaches. Recorded inline: there is a single pass to fill -
+	// unless the static terrain is replayed from a cached secondary.
+	void Renderer::RecordShadowPassLayered(uint32_t frameIndex, const VkViewport& viewport, const VkRect2D& scissor)
+	{
+		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+		const VkExtent2D shadowExtent = m_ShadowManager->GetShadowExtent();
+
+		constexpr uint32_t ALL_CASCADES = (1u << NUM_CASCADES) - 1;
+		const uint32_t firstCached = ShadowCascadeCache::FirstCachedCascade(m_ShadowConfig);
+		const uint32_t nearCascades = (1u << firstCached) - 1;
+		const uint32_t farCascades = ALL_CASCADES & ~nearCascades;
+		const uint32_t staticDirty = m_StaticShadowDirtyMask & farCascades;
+		m_StaticShadowDirtyMask = 0;
+
+		// Clears the given layers of the bound layered depth attachment
+		auto clearLayers = [shadowExtent](VkCommandBuffer cmd, uint32_t layerMask)
+		{
+			VkClearAttachment clear{};
+			clear.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+			clear.clearValue.depthStencil = { 1.0f, 0 };  // Standard depth (not reverse-Z)
+
+			VkClearRect rects[NUM_CASCADES]{};
+			uint32_t count = 0;
+			for (uint32_t layer = 0; layer < NUM_CASCADES; ++layer)
+			{
+				if (layerMask & (1u << layer))
+					rects[count++] = { { { 0, 0 }, shadowExtent }, layer, 1 };
+			}
+			if (count > 0)
+				vkCmdClearAttachments(cmd, 1, &clear, count, rects);
+		};
+
+		auto beginPass = [&](VkRenderPass renderPass, VkFramebuffer framebuffer, VkSubpassContents contents)
+		{
+			VkRenderPassBeginInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = renderPass;
+			renderPassInfo.framebuffer = framebuffer;
+			renderPassInfo.renderArea.offset = { 0, 0 };
+			renderPassInfo.renderArea.extent = shadowExtent;
+			vkCmdBeginRenderPass(cmd, &renderPassInfo, contents);
+			if (contents == VK_SUBPASS_CONTENTS_INLINE)
+			{
+				vkCmdSetViewport(cmd, 0, 1, &viewport);
+				vkCmdSetScissor(cmd, 0, 1, &scissor);
+			}
+		};
+
+		// Static cache: redraw terrain into the far layers that need it. The rest of the
+		// cache is kept; layers holding nothing (near cascades, stale far ones) are
+		// discarded so the whole attachment enters the pass in one layout.
+		if (staticDirty)
+		{
+			m_ShadowManager->RecordDiscardStaticCacheLayers(cmd, staticDirty | nearCascades);
+			beginPass(m_ShadowManager->GetStaticCacheLoadRenderPass(), m_ShadowManager->GetLayeredStaticCacheFramebuffer(),
+				VK_SUBPASS_CONTENTS_INLINE);
+			clearLayers(cmd, staticDirty);
+			RecordLayeredShadowCasters(cmd, frameIndex, staticDirty, 0);
+			vkCmdEndRenderPass(cmd);
+		}
+
+		for (uint32_t cascade = firstCached; cascade < NUM_CASCADES; ++cascade)
+		{
+			m_ShadowManager->RecordRestoreStaticCascade(cmd, cascade);
+		}
+		m_ShadowManager->RecordDiscardShadowLayers(cmd, nearCascades);
+
+		if (!m_StaticCommandCaching)
+		{
+			beginPass(m_ShadowManager->GetShadowLoadRenderPass(), m_ShadowManager->GetLayeredShadowFramebuffer(),
+				VK_SUBPASS_CONTENTS_INLINE);
+			clearLayers(cmd, nearCascades);
+			RecordLayeredShadowCasters(cmd, frameIndex, nearCascades, ALL_CASCADES);
+			vkCmdEndRenderPass(cmd);
+			return;
+		}
+
+		// With command caching the near layers' clear and terrain are replayed
+		// from a secondary kept across frames; only the dynamic casters are
+		// recorded (on this thread - there is one pass)
+		SecondaryPassInfo pass;
+		pass.renderPass = m_ShadowManager->GetShadowLoadRenderPass();
+		pass.framebuffer = m_ShadowManager->GetLayeredShadowFramebuffer();
+		pass.viewport = viewport;
+		pass.scissor = scissor;
+
+		SecondaryRecordTask staticTask{ pass, [this, frameIndex, nearCascades, clearLayers](VkCommandBuffer secondary)
+		{
+			clearLayers(secondary, nearCascades);
+			RecordLayeredShadowCasters(secondary, frameIndex, nearCascades, 0);
+		} };
+		SecondaryRecordTask dynamicTask{ pass, [this, frameIndex](VkCommandBuffer secondary)
+		{
+			RecordLayeredShadowCasters(secondary, frameIndex, 0, ALL_CASCADES);
+		} };
+
+		VkCommandBuffer staticSecondary = m_Commands->GetCachedSecondary(frameIndex, CACHED_SHADOW_LAYERED_ID,
+			ComputeStaticShadowRecordSignature(frameIndex, nearCascades, true), staticTask);
+		VkCommandBuffer dynamicSecondary = m_Commands->RecordSecondaries(frameIndex, { dynamicTask })[0];
+
+		beginPass(pass.renderPass, pass.framebuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		m_Commands->ExecuteSecondaries(frameIndex, { staticSecondary, dynamicSecondary });
+		vkCmdEndRenderPass(cmd);
+	}
+
+	// Draws each shadow caster once, fanned out to the cascades in its mask
+	// (terrainCascades for terrain, dynamicCascades for the rest, both narrowed by
+	// CullShadowCasters). See ShadowLayered.vert for the instance -> layer mapping.
+	void Renderer::RecordLayeredShadowCasters(VkCommandBuffer cmd, uint32_t frameIndex,
+		uint32_t terrainCascades, uint32_t dynamicCascades)
+	{
+		// Push block of the layered shaders: PushConstantData with its trailing
+		// words reused for the cascade fan-out
+		struct LayeredShadowPush
+		{
+			glm::mat4 model;
+			glm::vec4 customData;
+			uint32_t firstInstance;
+			uint32_t instanceCount;
+			uint32_t cascadeList;   // 2 bits per target cascade
+			uint32_t cascadeCount;
+		};
+		static_assert(sizeof(LayeredShadowPush) == sizeof(PushConstantData));
+		static_assert(NUM_CASCADES <= 4, "cascadeList packs cascade indices in 2 bits");
+
+		VulkanPipelineManager* pipelines = m_PipelineAdapter->GetVulkanManager();
+		RenderStats& stats = RenderStats::Get();
+		VkDescriptorSet cascadeSet = m_DescriptorManager->GetShadowLayeredUniformDescriptorSet(frameIndex);
+		PipelineType boundPipeline = PipelineType::Count;
+		// Model meshes share arena buffers, so most draws keep these bound
+		VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+		VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+
+		for (size_t i = 0; i < m_FrameDrawList.GetCommandCount(); ++i)
+		{
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			if (!IsShadowCaster(drawCmd))
+				continue;
+
+			const bool isTerrain = (drawCmd.pipeline == PipelineType::Terrain);
+			uint32_t targets = isTerrain ? terrainCascades : dynamicCascades;
+			if (i < m_ShadowCasterCascades.size())
+				targets &= m_ShadowCasterCascades[i];
+			if (targets == 0)
+				continue;
+
+			if (isTerrain && drawCmd.heightmapDescriptorSet == VK_NULL_HANDLE)
+			{
+				LOG_WARN("TerrainShadow: heightmapDescriptorSet is null, skipping draw");
+				continue;
+			}
+
+			const PipelineType type = isTerrain ? PipelineType::TerrainShadowLayered
+				: ResolvePipelineVariant(PipelineType::ShadowLayered, drawCmd.vertexFormat);
+			VkPipelineLayout layout = pipelines->GetPipelineLayout(type);
+			if (type != boundPipeline)
+			{
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines->GetPipeline(type));
+				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+					layout, 0, 1, &cascadeSet, 0, nullptr);
+				stats.Add(RenderCounter::PipelineBinds);
+				stats.Add(RenderCounter::DescriptorBinds);
+				boundPipeline = type;
+			}
+			if (isTerrain)
+			{
+				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+					layout, 1, 1, &drawCmd.heightmapDescriptorSet, 0, nullptr);
+				stats.Add(RenderCounter::DescriptorBinds);
+			}
+
+			LayeredShadowPush push{};
+			if (drawCmd.hasPushConstants)
+			{
+				push.model = drawCmd.pushConstants.model;
+				push.customData = drawCmd.pushConstants.customData;
+			}
+			push.firstInstance = drawCmd.firstInstance;
+			push.instanceCount = drawCmd.instanceCount;
+			for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+			{
+				if (targets & (1u << c))
+					push.cascadeList |= c << (2u * push.cascadeCount++);
+			}
+			vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push), &push);
+			stats.Add(RenderCounter::PushConstants);
+
+			if (drawCmd.vertexBuffer)
+			{
+				VkBuffer vertexBuffer = static_cast<VulkanBuffer*>(drawCmd.vertexBuffer)->GetBuffer();
+				if (vertexBuffer != boundVertexBuffer)
+				{
+					VkDeviceSize offset = 0;
+					vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
+					boundVertexBuffer = vertexBuffer;
+				}
+			}
+
+			const uint32_t instances = drawCmd.instanceCount * push.cascadeCount;
+			if (drawCmd.indexBuffer && drawCmd.indexCount > 0)
+			{
+				VkBuffer indexBuffer = static_cast<VulkanBuffer*>(drawCmd.indexBuffer)->GetBuffer();
+				if (indexBuffer != boundIndexBuffer)
+				{
+					vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+					boundIndexBuffer = indexBuffer;
+				}
+				vkCmdDrawIndexed(cmd, drawCmd.indexCount, instances,
+					drawCmd.firstIndex, drawCmd.vertexOffset, drawCmd.firstInstance);
+				stats.AddDraw(drawCmd.indexCount, instances);
+			}
+			else if (drawCmd.vertexCount > 0)
+			{
+				vkCmdDraw(cmd, drawCmd.vertexCount, instances, 0, drawCmd.firstInstance);
+				stats.AddDraw(drawCmd.vertexCount, instances);
+			}
+		}
+	}
 
-		// Execute draw list
-		if (!m_FrameDrawList.GetCommands().empty())
+	// Tests each bounded draw against every cascade's caster volume, built from the
+	// light VP the cascade is rendered with this frame (frozen far cascades included).
+	// Deliberately ignores cameraVisible: off-screen casters still shadow the view.
+	// Unbounded draws (terrain, procedural geometry) go to every cascade.
+	void Renderer::CullShadowCasters()
+	{
+		Frustum volumes[NUM_CASCADES];
+		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
 		{
-			m_Commands->ExecuteDrawList(frameIndex, m_FrameDrawList,
-				m_PipelineAdapter.get(),
-				m_ViewMatrix, m_ProjectionMatrix);
+			// Without the squeeze into the cascade's corner of the layer
+			const glm::mat4 viewport = ShadowCascadeViewport(m_CascadeTexels[c], m_ShadowManager->GetConfig().resolution);
+			volumes[c] = Frustum::ExtractShadowCasterVolume(glm::inverse(viewport) * m_CascadeLightVP[c]);
 		}
 
-		m_Commands->EndRenderPass(frameIndex);
-		if (m_GpuProfiler) m_GpuProfiler->EndScope(profCmd, sceneScope);
+		constexpr uint8_t ALL_CASCADES = (1u << NUM_CASCADES) - 1;
+		const size_t count = m_FrameDrawList.GetCommandCount();
+		m_ShadowCasterCascades.assign(count, ALL_CASCADES);
 
-		// =========================================================================
-		// BLOOM PASS - bright-extract + separable blur of the HDR scene color into
-		// the half-res bloom targets, which the post-process composite adds back.
-		// Runs every frame (cost is small); strength is the bloomIntensity param.
-		// =========================================================================
+		m_ShadowCullBounds.Clear();
+		m_ShadowCullCommands.clear();
+		for (size_t i = 0; i < count; ++i)
 		{
-			uint32_t bloomScope = m_GpuProfiler ? m_GpuProfiler->BeginScope(profCmd, "Bloom") : UINT32_MAX;
-			RecordBloomPass(frameIndex);
-			if (m_GpuProfiler) m_GpuProfiler->EndScope(profCmd, bloomScope);
-		}
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			if (!drawCmd.hasBounds)
+				continue;
 
-		// =========================================================================
-		// POST-PROCESS PASS - samples the scene-color texture, runs FXAA, and
-		// writes the actual swapchain image. UI renders after this, directly
-		// on the swapchain target, so it isn't blurred by the AA filter.
-		// =========================================================================
-		uint32_t ppScope = m_GpuProfiler ? m_GpuProfiler->BeginScope(profCmd, "PostProcess+UI") : UINT32_MAX;
-		RecordPostProcessPass(frameIndex, imageIndex);
-		if (m_GpuProfiler) m_GpuProfiler->EndScope(profCmd, ppScope);
+			m_ShadowCullBounds.Add(drawCmd.bounds.center, drawCmd.bounds.extents);
+			m_ShadowCullCommands.push_back(static_cast<uint32_t>(i));
+			m_ShadowCasterCascades[i] = 0;
+		}
 
-		if (m_GpuProfiler) m_GpuProfiler->EndFrame(frameIndex);
+		m_ShadowCullVisible.resize(m_ShadowCullBounds.Size());
+		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+		{
+			volumes[c].IntersectsBatch(m_ShadowCullBounds, m_ShadowCullVisible.data());
+			for (size_t b = 0; b < m_ShadowCullCommands.size(); ++b)
+			{
+				if (m_ShadowCullVisible[b])
+					m_ShadowCasterCascades[m_ShadowCullCommands[b]] |= static_cast<uint8_t>(1u << c);
+			}
+		}
 
-		m_Commands->EndCommandBuffer(frameIndex);
+		// The terrain's sun shadow map shadows everything past the cascades the
+		// terrain still casts into (TerrainSunShadow.hpp), by far the largest caster
+		if (m_TerrainSunShadowActive)
+		{
+			const uint32_t terrainCascades = std::min(m_ShadowConfig.terrainCascades, NUM_CASCADES);
+			const uint8_t terrainMask = static_cast<uint8_t>((1u << terrainCascades) - 1);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (m_FrameDrawList.GetCommand(i).pipeline == PipelineType::Terrain)
+					m_ShadowCasterCascades[i] &= terrainMask;
+			}
+		}
 	}
 
-	void Renderer::RecordComputePass(uint32_t frameIndex)
+	// Per-draw visibility for the planar reflection pass. Bounded draws are
+	// tested against the mirrored camera's frustum (the main pass's
+	// cameraVisible is the wrong camera), and dropped when they sit wholly
+	// below the water plane (the reflection shaders clip that anyway) or, for
+	// props, when they cover less than WaterDesc::planarMinSize of the screen
+	// height - a blurred, rippled reflection loses them regardless. Foliage
+	// is left out unless WaterDesc::planarFoliage asks for it. Unbounded draws
+	// (terrain patches, clouds) are kept.
+	void Renderer::CullReflectionCasters()
 	{
-		if (!m_ComputeDispatcher)
-		{
+		const size_t count = m_FrameDrawList.GetCommandCount();
+		m_ReflectionCasters.assign(count, 1);
+		if (!m_WaterSystem)
 			return;
-		}
 
-		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+		const WaterDesc& desc = m_WaterSystem->GetDesc();
+		const float waterY = m_WaterSystem->GetWaterY();
+		const Frustum frustum = Frustum::ExtractFromMatrix(m_ProjectionMatrix * m_ReflectionFrameData.view);
+		const glm::vec3 mirroredCam = glm::vec3(m_ReflectionFrameData.cameraPos);
+		// Projected radius over distance is a fraction of the half-height in
+		// NDC, i.e. the bounds' diameter as a fraction of the screen height
+		const float focal = m_ProjectionMatrix[1][1];
 
-		if (m_ComputeEnabled)
+		for (size_t i = 0; i < count; ++i)
 		{
-			// Get compute pipeline and layout
-			VkPipeline computePipeline = m_PipelineAdapter->GetVulkanManager()->GetPipeline(PipelineType::Compute);
-			VkPipelineLayout computeLayout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::Compute);
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			if (drawCmd.pipeline == PipelineType::Foliage)
+			{
+				m_ReflectionCasters[i] = desc.planarFoliage ? 1 : 0;
+				continue;
+			}
+			if (!drawCmd.hasBounds)
+				continue;
 
-			if (computePipeline == VK_NULL_HANDLE || computeLayout == VK_NULL_HANDLE)
+			const glm::vec3& center = drawCmd.bounds.center;
+			const glm::vec3& extents = drawCmd.bounds.extents;
+			if (center.y + extents.y < waterY || !frustum.Intersects(center, extents))
 			{
-				LOG_WARN("Compute pipeline or layout is null");
+				m_ReflectionCasters[i] = 0;
+				continue;
 			}
-			else
+
+			if (drawCmd.pipeline != PipelineType::Terrain)
 			{
-				// Bind compute pipeline
-				m_ComputeDispatcher->BindPipeline(cmd, computePipeline);
+				const float radius = glm::length(extents);
+				const float distance = glm::length(center - mirroredCam);
+				if (distance > radius && radius * focal < desc.planarMinSize * distance)
+					m_ReflectionCasters[i] = 0;
+			}
+		}
+	}
+
+	uint32_t Renderer::GetEnvironmentProbeAge() const
+	{
+		return m_EnvironmentProbe ? m_EnvironmentProbe->GetAge() : 0;
+	}
 
-				// Bind descriptor set with our storage buffers
-				m_ComputeDispatcher->BindDescriptorSet(cmd, computeLayout, 0, m_ComputeTestDescriptorSet);
+	float Renderer::GetPlanarReflectionScale() const
+	{
+		if (!m_WaterSystem || IsScreenSpaceReflectionActive())
+			return 1.0f;
+		return glm::clamp(m_WaterSystem->GetDesc().planarScale, 0.25f, 1.0f);
+	}
 
-				// Set push constants with current time
-				ComputePushConstants pushData;
-				pushData.dataSize = COMPUTE_TEST_ELEMENT_COUNT;
-				pushData.time = m_TotalTime;  // Use the renderer's time value
+	uint32_t Renderer::GetReflectionInterval() const
+	{
+		if (!m_WaterSystem || IsScreenSpaceReflectionActive())
+			return 1;
+		return std::clamp(m_WaterSystem->GetDesc().reflectionInterval, 1u, ReflectionSchedule::MAX_INTERVAL);
+	}
 
-				m_ComputeDispatcher->PushConstants(cmd, computeLayout, &pushData, sizeof(pushData));
+	bool Renderer::ApplyReflectionPersistence(bool persistent)
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
-				// Dispatch compute work
-				// With local_size_x = 64, we need 1 workgroup for 64 elements
-				uint32_t groupCountX = ComputeDispatcher::CalculateGroupCount(COMPUTE_TEST_ELEMENT_COUNT, 64);
-				m_ComputeDispatcher->Dispatch(cmd, groupCountX, 1, 1);
+		// Both targets are rebuilt in place, so frames still using them must
+		// finish first (as for a resize)
+		VulkanQueueTimeline* timeline = vkDevice->GetGraphicsTimeline();
+		timeline->Wait(timeline->GetLastSubmittedValue());
+		m_ReflectionSchedule.Invalidate();
 
-				// Barrier: ensure compute writes are visible before any graphics work
-				m_ComputeDispatcher->ComputeToGraphicsGlobalBarrier(cmd);
-			}
+		if (!m_RenderPasses->SetReflectionPersistent(vkDevice->GetDevice(), persistent, m_RenderPasses->GetSceneExtent()))
+		{
+			LOG_ERROR("Failed to recreate the reflection target");
+			return false;
 		}
 
-		if (m_FireflySystem)
+		if (m_BloomChain &&
+			!m_BloomChain->Resize(m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetSceneExtent(),
+				m_RenderPasses->GetBloomImage(), m_RenderPasses->GetBloomExtent(), m_RenderPasses->GetBloomMipCount()))
 		{
-			m_FireflySystem->DispatchCompute(cmd, m_ComputeDispatcher.get(), frameIndex, m_LastDeltaTime);
-
-			m_ComputeDispatcher->ComputeToVertexShaderBarrier(
-				cmd, m_FireflySystem->GetAgentBuffer(), m_FireflySystem->GetAgentBufferSize());
+			LOG_WARN("Failed to re-point the bloom chain - disabling bloom");
+			m_BloomChain->Cleanup();
+			m_BloomChain.reset();
 		}
 
-		if (m_CloudSystem)
+		if (m_ReflectionInputSet != VK_NULL_HANDLE)
 		{
-			m_CloudSystem->DispatchRaymarch(cmd, m_ComputeDispatcher.get(), frameIndex);
-
-			m_ComputeDispatcher->ComputeWriteToFragmentSampleBarrier(
-				cmd, m_CloudSystem->GetRaymarchResultImage());
+			m_DescriptorManager->UpdateReflectionInputSet(m_ReflectionInputSet,
+				m_RenderPasses->GetReflectionColorImageView(), m_RenderPasses->GetReflectionColorSampler());
+		}
+		return true;
+	}
 
-			// Second raymarch from the mirror-flipped reflection camera, composited
-			// into the water reflection target by RecordReflectionPass. Only worth
-			// doing when water is present to reflect it.
-			if (m_WaterSystem)
-			{
-				m_CloudSystem->DispatchReflectionRaymarch(cmd, m_ComputeDispatcher.get(), frameIndex,
-					m_DescriptorManager->GetReflectionUniformDescriptorSet(frameIndex));
+	void Renderer::InvalidateShadowCache()
+	{
+		m_ShadowCascadeCache.Invalidate();
+		m_StaticShadowDirtyMask = ~0u;
+		// What the static casters' cached secondaries reference may be gone
+		if (m_Commands)
+			m_Commands->InvalidateCachedSecondaries();
+	}
 
-				m_ComputeDispatcher->ComputeWriteToFragmentSampleBarrier(
-					cmd, m_CloudSystem->GetReflectionResultImage());
-			}
-		}
+	void Renderer::InvalidateShadowRegion(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		m_StaticShadowDirtyMask |= m_ShadowCascadeCache.CascadesTouching(m_ShadowConfig, boundsMin, boundsMax);
 	}
 
-	// =====================================================================
-	// FIX: RecordShadowPass no longer touches m_FrameUniforms.
-	//
-	// The old version wrote light matrices into the camera UBO, recorded
-	// GPU commands, then restored camera data � all CPU-side. But the GPU
-	// doesn't execute until submit, so by that time the buffer always
-	// contained camera data for BOTH passes.
-	//
-	// Now the shadow pass has its own dedicated UBO (m_ShadowUniforms),
-	// uploaded once in BeginFrame, and binds its own descriptor set here.
-	// =====================================================================
-	void Renderer::RecordShadowPass(uint32_t frameIndex)
+	// Changes whenever the static casters drawn into the static cache would: terrain
+	// mesh swaps, heightmap set, transform. In-place edits that keep every handle
+	// still need InvalidateShadowCache(). The terrain's CDLOD patch selection is left
+	// out on purpose: it shifts as the camera moves, and a far cascade drawn from a
+	// slightly older selection is only stale until its next scheduled refit.
+	uint64_t Renderer::ComputeStaticCasterSignature() const
 	{
-		if (!m_ShadowEnabled || !m_ShadowManager)
+		SignatureHash hash;
+		for (size_t i = 0; i < m_FrameDrawList.GetCommandCount(); ++i)
 		{
-			return;
-		}
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			if (drawCmd.pipeline != PipelineType::Terrain)
+				continue;
 
-		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+			hash.Mix(drawCmd.vertexBuffer);
+			hash.Mix(drawCmd.indexBuffer);
+			hash.Mix(drawCmd.indexCount);
+			hash.Mix(drawCmd.heightmapDescriptorSet);
+			if (drawCmd.hasPushConstants)
+				hash.Mix(drawCmd.pushConstants.model);
+		}
+		return hash.Get();
+	}
 
-		VkExtent2D shadowExtent = m_ShadowManager->GetShadowExtent();
+	// Everything recording the static (terrain) casters into cascadeMask reads -
+	// draw parameters, buffers, descriptor sets, pipelines, cascade culling - so
+	// the cached secondary holding them is replayed only while a fresh recording
+	// would come out the same. Unlike ComputeStaticCasterSignature this covers
+	// the CDLOD patch range: it changes while the camera moves, and a replay
+	// must draw exactly this frame's patches.
+	uint64_t Renderer::ComputeStaticShadowRecordSignature(uint32_t frameIndex, uint32_t cascadeMask, bool layered) const
+	{
+		VulkanPipelineManager* pipelines = m_PipelineAdapter->GetVulkanManager();
 
-		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(shadowExtent.width);
-		viewport.height = static_cast<float>(shadowExtent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
+		SignatureHash hash;
+		hash.Mix(cascadeMask);
+		hash.Mix(layered);
+		if (layered)
+		{
+			hash.Mix(pipelines->GetPipeline(PipelineType::TerrainShadowLayered));
+			hash.Mix(m_DescriptorManager->GetShadowLayeredUniformDescriptorSet(frameIndex));
+		}
+		else
+		{
+			// RecordShadowCasters binds Shadow up front
+			hash.Mix(pipelines->GetPipeline(PipelineType::Shadow));
+			hash.Mix(pipelines->GetPipeline(PipelineType::TerrainShadow));
+			for (uint32_t cascade = 0; cascade < NUM_CASCADES; ++cascade)
+			{
+				if (cascadeMask & (1u << cascade))
+					hash.Mix(m_DescriptorManager->GetShadowUniformDescriptorSet(frameIndex, cascade));
+			}
+		}
+		// The sets keep their handles when EnsureDrawBufferCapacity grows the
+		// buffers behind set 0 binding 1, so the buffers count themselves
+		if (m_InstanceBuffers[frameIndex])
+			hash.Mix(m_InstanceBuffers[frameIndex]->GetBuffer());
+		if (m_IndirectDrawBuffers[frameIndex])
+			hash.Mix(m_IndirectDrawBuffers[frameIndex]->GetBuffer());
+
+		for (size_t i = 0; i < m_FrameDrawList.GetCommandCount(); ++i)
+		{
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			if (drawCmd.pipeline != PipelineType::Terrain || !IsShadowCaster(drawCmd))
+				continue;
+
+			uint32_t targets = cascadeMask;
+			if (i < m_ShadowCasterCascades.size())
+				targets &= m_ShadowCasterCascades[i];
+			if (targets == 0)
+				continue;
+
+			hash.Mix(targets);
+			if (drawCmd.vertexBuffer)
+				hash.Mix(static_cast<VulkanBuffer*>(drawCmd.vertexBuffer)->GetBuffer());
+			if (drawCmd.indexBuffer)
+				hash.Mix(static_cast<VulkanBuffer*>(drawCmd.indexBuffer)->GetBuffer());
+			hash.Mix(drawCmd.indexCount);
+			hash.Mix(drawCmd.firstIndex);
+			hash.Mix(drawCmd.vertexOffset);
+			hash.Mix(drawCmd.vertexCount);
+			hash.Mix(drawCmd.instanceCount);
+			hash.Mix(drawCmd.firstInstance);
+			hash.Mix(drawCmd.heightmapDescriptorSet);
+			hash.Mix(drawCmd.hasPushConstants);
+			if (drawCmd.hasPushConstants)
+				hash.Mix(drawCmd.pushConstants);
+		}
+		return hash.Get();
+	}
 
-		VkRect2D scissor{};
-		scissor.offset = { 0, 0 };
-		scissor.extent = shadowExtent;
+	// Records one cascade's shadow casters into cmd, which must already be inside
+	// that cascade's shadow render pass with viewport/scissor set. Only reads
+	// renderer state, so it is safe to call from the recording workers.
+	void Renderer::RecordShadowCasters(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t cascade,
+		ShadowCasterFilter filter)
+	{
+		// Bind shadow pipeline
+		m_PipelineAdapter->BindPipeline(cmd, PipelineType::Shadow);
+		RenderStats& stats = RenderStats::Get();
+		stats.Add(RenderCounter::PipelineBinds);
 
-		VkClearValue depthClear{};
-		depthClear.depthStencil = { 1.0f, 0 };  // Standard depth (not reverse-Z)
+		// This cascade's light view/proj (set 0)
+		VkDescriptorSet shadowUniformSet = m_DescriptorManager->GetShadowUniformDescriptorSet(frameIndex, cascade);
+		VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+		VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
 
-		// STEP 3: render every cascade into its own array layer. Each cascade has its own
-		// framebuffer (one array layer) and its own set-0 UBO (that cascade's light VP).
-		// This is ~NUM_CASCADES x the depth-pass draws — watch FPS; per-cascade culling is
-		// the step-5 mitigation if it stings.
-		for (uint32_t cascade = 0; cascade < NUM_CASCADES; ++cascade)
+		auto castsIntoCascade = [&](size_t index)
 		{
-			VkRenderPassBeginInfo renderPassInfo{};
-			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-			renderPassInfo.renderPass = m_ShadowManager->GetShadowRenderPass();
-			renderPassInfo.framebuffer = m_ShadowManager->GetShadowFramebuffer(cascade);
-			renderPassInfo.renderArea.offset = { 0, 0 };
-			renderPassInfo.renderArea.extent = shadowExtent;
-			renderPassInfo.clearValueCount = 1;
-			renderPassInfo.pClearValues = &depthClear;
-
-			vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(index);
+			if (!IsShadowCaster(drawCmd))
+				return false;
 
-			vkCmdSetViewport(cmd, 0, 1, &viewport);
-			vkCmdSetScissor(cmd, 0, 1, &scissor);
+			// Outside this cascade's caster volume (see CullShadowCasters)
+			if (index < m_ShadowCasterCascades.size() &&
+				(m_ShadowCasterCascades[index] & (1u << cascade)) == 0)
+				return false;
 
-			// Bind shadow pipeline
-			m_PipelineAdapter->BindPipeline(cmd, PipelineType::Shadow);
+			bool isTerrain = (drawCmd.pipeline == PipelineType::Terrain);
+			return !((filter == ShadowCasterFilter::StaticOnly && !isTerrain) ||
+				(filter == ShadowCasterFilter::DynamicOnly && isTerrain));
+		};
 
-			// This cascade's light view/proj (set 0)
-			VkDescriptorSet shadowUniformSet = m_DescriptorManager->GetShadowUniformDescriptorSet(frameIndex, cascade);
+		// Multi-draw runs come out of this frame's indirect buffer (see
+		// FinalizeFrame), which covers the first m_IndirectDrawCount commands
+		VkBuffer indirectDraws = m_IndirectDrawBuffers[frameIndex]
+			? m_IndirectDrawBuffers[frameIndex]->GetBuffer() : VK_NULL_HANDLE;
+		const size_t indirectEnd = std::min(m_FrameDrawList.GetCommandCount(), static_cast<size_t>(m_IndirectDrawCount));
 
-			// Render all shadow-casting geometry from the draw list
-			for (const auto& drawCmd : m_FrameDrawList.GetCommands())
+		// Render all shadow-casting geometry from the draw list. Walk the
+		// sorted order: draws merged into an instanced batch are not in it.
+		for (size_t i = 0; i < m_FrameDrawList.GetCommandCount();)
+		{
+			const size_t first = i++;
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(first);
+			if (!castsIntoCascade(first))
+			{
+				continue;
+			}
+			bool isTerrain = (drawCmd.pipeline == PipelineType::Terrain);
+
+			// Shadow.vert only reads the instance transform, so every Mesh
+			// caster on the same buffers joins one multi-draw whatever its
+			// material
+			uint32_t drawCount = 1;
+			uint64_t runInstances = drawCmd.instanceCount;
+			uint64_t runIndices = static_cast<uint64_t>(drawCmd.indexCount) * drawCmd.instanceCount;
+			if (indirectDraws != VK_NULL_HANDLE && first < indirectEnd && DrawList::IsIndirectCandidate(drawCmd))
 			{
-				// Only opaque WORLD geometry casts shadows. Whitelist Mesh + Terrain and
-				// skip everything else. In particular the Water plane (PipelineType::Water)
-				// was being drawn here — a big flat caster that painted a spurious shadow
-				// on the terrain and, because a horizontal plane's shadow-map coverage
-				// swings hard with the light angle, spiked the shadow cost across the
-				// day/night cycle. Foliage/Clouds/Firefly/Transparent are excluded too.
-				if (drawCmd.pipeline != PipelineType::Mesh &&
-					drawCmd.pipeline != PipelineType::Terrain)
+				while (i < indirectEnd && castsIntoCascade(i))
 				{
-					continue;
+					const DrawCommand& next = m_FrameDrawList.GetCommand(i);
+					if (!DrawList::IsIndirectCandidate(next) || next.vertexBuffer != drawCmd.vertexBuffer ||
+						next.indexBuffer != drawCmd.indexBuffer || next.vertexFormat != drawCmd.vertexFormat)
+						break;
+					++i;
+					++drawCount;
+					runInstances += next.instanceCount;
+					runIndices += static_cast<uint64_t>(next.indexCount) * next.instanceCount;
 				}
+			}
 
-				// Skip emissive light-source discs (moon/sun): customData.w >= 2.0 flags
-				// an unlit emissive surface (see Mesh.frag). A celestial light source
-				// shouldn't cast shadows, and because it tracks the light its shadow-map
-				// overdraw would otherwise vary with time of day.
-				if (drawCmd.hasPushConstants && drawCmd.pushConstants.customData.w >= 2.0f)
-				{
-					continue;
-				}
+			// Bind appropriate shadow pipeline (packed-vertex meshes use their twin)
+			const PipelineType shadowType = isTerrain ? PipelineType::TerrainShadow
+				: ResolvePipelineVariant(PipelineType::Shadow, drawCmd.vertexFormat);
+			VkPipeline shadowPipeline = m_PipelineAdapter->GetVulkanManager()->GetPipeline(shadowType);
+			VkPipelineLayout shadowLayout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(shadowType);
 
-				// Skip if no vertex buffer
-				if (!drawCmd.vertexBuffer)
+			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipeline);
+
+			// Bind this cascade's shadow uniform (set 0) - same for both
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+				shadowLayout, 0, 1, &shadowUniformSet, 0, nullptr);
+			stats.Add(RenderCounter::PipelineBinds);
+			stats.Add(RenderCounter::DescriptorBinds);
+
+			// For terrain: also bind heightmap at set 1
+			if (isTerrain)
+			{
+				if (drawCmd.heightmapDescriptorSet == VK_NULL_HANDLE)
 				{
+					LOG_WARN("TerrainShadow: heightmapDescriptorSet is null, skipping draw");
 					continue;
 				}
 
-				bool isTerrain = (drawCmd.pipeline == PipelineType::Terrain);
-
-				// Bind appropriate shadow pipeline
-				VkPipeline shadowPipeline = isTerrain
-					? m_PipelineAdapter->GetVulkanManager()->GetPipeline(PipelineType::TerrainShadow)
-					: m_PipelineAdapter->GetVulkanManager()->GetPipeline(PipelineType::Shadow);
-				VkPipelineLayout shadowLayout = isTerrain
-					? m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::TerrainShadow)
-					: m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::Shadow);
-
-				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipeline);
-
-				// Bind this cascade's shadow uniform (set 0) - same for both
 				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-					shadowLayout, 0, 1, &shadowUniformSet, 0, nullptr);
+					shadowLayout, 1, 1, &drawCmd.heightmapDescriptorSet, 0, nullptr);
+				stats.Add(RenderCounter::DescriptorBinds);
+			}
 
-				// For terrain: also bind heightmap at set 1
-				if (isTerrain)
-				{
-					if (drawCmd.heightmapDescriptorSet == VK_NULL_HANDLE)
-					{
-						LOG_WARN("TerrainShadow: heightmapDescriptorSet is null, skipping draw");
-						continue;
-					}
+			// Set push constants (model matrix)
+			if (drawCmd.hasPushConstants)
+			{
+				vkCmdPushConstants(cmd, shadowLayout, VK_SHADER_STAGE_VERTEX_BIT,
+					0, sizeof(PushConstantData), &drawCmd.pushConstants);
+				stats.Add(RenderCounter::PushConstants);
+			}
 
-					vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-						shadowLayout, 1, 1, &drawCmd.heightmapDescriptorSet, 0, nullptr);
+			// Bind vertex buffer (arena-backed meshes share it; pipeline
+			// binds leave vertex/index bindings alone). Terrain has none.
+			if (drawCmd.vertexBuffer)
+			{
+				VkBuffer vertexBuffer = static_cast<VulkanBuffer*>(drawCmd.vertexBuffer)->GetBuffer();
+				if (vertexBuffer != boundVertexBuffer)
+				{
+					VkDeviceSize offset = 0;
+					vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
+					boundVertexBuffer = vertexBuffer;
 				}
+			}
 
-				// Set push constants (model matrix)
-				if (drawCmd.hasPushConstants)
+			// Draw
+			if (drawCmd.indexBuffer && drawCmd.indexCount > 0)
+			{
+				VkBuffer indexBuffer = static_cast<VulkanBuffer*>(drawCmd.indexBuffer)->GetBuffer();
+				if (indexBuffer != boundIndexBuffer)
 				{
-					vkCmdPushConstants(cmd, shadowLayout, VK_SHADER_STAGE_VERTEX_BIT,
-						0, sizeof(PushConstantData), &drawCmd.pushConstants);
+					vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+					boundIndexBuffer = indexBuffer;
 				}
-
-				// Bind vertex buffer
-				VulkanBuffer* vkBuffer = static_cast<VulkanBuffer*>(drawCmd.vertexBuffer);
-				VkBuffer vertexBuffers[] = { vkBuffer->GetBuffer() };
-				VkDeviceSize offsets[] = { 0 };
-				vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-
-				// Draw
-				if (drawCmd.indexBuffer && drawCmd.indexCount > 0)
+				if (drawCount > 1)
 				{
-					VulkanBuffer* vkIndexBuffer = static_cast<VulkanBuffer*>(drawCmd.indexBuffer);
-					vkCmdBindIndexBuffer(cmd, vkIndexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
-					vkCmdDrawIndexed(cmd, drawCmd.indexCount, drawCmd.instanceCount, 0, 0, drawCmd.firstInstance);
+					vkCmdDrawIndexedIndirect(cmd, indirectDraws, first * sizeof(IndexedIndirectDraw),
+						drawCount, sizeof(IndexedIndirectDraw));
+					// CPU-written parameters: a multi-draw, not a GPU-driven one
+					stats.Add(RenderCounter::DrawCalls);
+					stats.Add(RenderCounter::Instances, runInstances);
+					stats.Add(RenderCounter::Indices, runIndices);
 				}
-				else if (drawCmd.vertexCount > 0)
+				else
 				{
-					vkCmdDraw(cmd, drawCmd.vertexCount, drawCmd.instanceCount, 0, drawCmd.firstInstance);
+					vkCmdDrawIndexed(cmd, drawCmd.indexCount, drawCmd.instanceCount,
+						drawCmd.firstIndex, drawCmd.vertexOffset, drawCmd.firstInstance);
+					stats.AddDraw(drawCmd.indexCount, drawCmd.instanceCount);
 				}
 			}
+			else if (drawCmd.vertexCount > 0)
+			{
+				vkCmdDraw(cmd, drawCmd.vertexCount, drawCmd.instanceCount, 0, drawCmd.firstInstance);
+				stats.AddDraw(drawCmd.vertexCount, drawCmd.instanceCount);
+			}
+		}
+	}
 
-			vkCmdEndRenderPass(cmd);
+	void Renderer::RecordLocalShadowCasters(VkCommandBuffer cmd, uint32_t frameIndex, const glm::mat4& faceViewProj,
+		const Frustum& faceFrustum, const glm::vec4& lightSphere)
+	{
+		RenderStats& stats = RenderStats::Get();
+
+		// Instance transforms (set 0, binding 1); the face's view-projection
+		// replaces the model matrix in the push block
+		VkDescriptorSet uniformSet = m_DescriptorManager->GetUniformDescriptorSet(frameIndex);
+		PushConstantData push;
+		push.model = faceViewProj;
+
+		PipelineType boundType = PipelineType::Count;
+		VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+		VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+
+		// The batched list, as the cascades draw it; bounds are the batches'
+		for (size_t i = 0; i < m_FrameDrawList.GetCommandCount(); ++i)
+		{
+			const DrawCommand& drawCmd = m_FrameDrawList.GetCommand(i);
+			if (drawCmd.pipeline != PipelineType::Mesh || !IsShadowCaster(drawCmd) || drawCmd.indirectBuffer ||
+				!drawCmd.indexBuffer || drawCmd.indexCount == 0)
+				continue;
+			if (drawCmd.hasBounds && (!faceFrustum.Intersects(drawCmd.bounds.center, drawCmd.bounds.extents) ||
+				!LocalShadowAtlas::BoxTouchesSphere(drawCmd.bounds.center, drawCmd.bounds.extents, lightSphere)))
+				continue;
+
+			const PipelineType type = ResolvePipelineVariant(PipelineType::LocalShadow, drawCmd.vertexFormat);
+			VkPipelineLayout layout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(type);
+			if (type != boundType)
+			{
+				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineAdapter->GetVulkanManager()->GetPipeline(type));
+				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &uniformSet, 0, nullptr);
+				vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantData), &push);
+				stats.Add(RenderCounter::PipelineBinds);
+				stats.Add(RenderCounter::DescriptorBinds);
+				stats.Add(RenderCounter::PushConstants);
+				boundType = type;
+			}
+
+			VkBuffer vertexBuffer = static_cast<VulkanBuffer*>(drawCmd.vertexBuffer)->GetBuffer();
+			if (vertexBuffer != boundVertexBuffer)
+			{
+				VkDeviceSize offset = 0;
+				vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
+				boundVertexBuffer = vertexBuffer;
+			}
+			VkBuffer indexBuffer = static_cast<VulkanBuffer*>(drawCmd.indexBuffer)->GetBuffer();
+			if (indexBuffer != boundIndexBuffer)
+			{
+				vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+				boundIndexBuffer = indexBuffer;
+			}
+
+			vkCmdDrawIndexed(cmd, drawCmd.indexCount, drawCmd.instanceCount,
+				drawCmd.firstIndex, drawCmd.vertexOffset, drawCmd.firstInstance);
+			stats.AddDraw(drawCmd.indexCount, drawCmd.instanceCount);
 		}
-		// No UBO restore needed � each pass has its own dedicated buffer
 	}
 
 	// =====================================================================
@@ -2192,116 +5954,279 @@ namespace Nightbloom
 			return;
 		}
 
-		VkExtent2D extent = m_RenderPasses->GetReflectionExtent();
-		if (extent.width == 0 || extent.height == 0)
+		VkExtent2D extent = m_RenderPasses->GetReflectionExtent();
+		if (extent.width == 0 || extent.height == 0)
+		{
+			return;
+		}
+
+		// Clear color (sky/background behind the reflected geometry) + depth.
+		// With MSAA the pass has a third (resolve) attachment whose clear value
+		// is unused but must be covered by the count.
+		std::array<VkClearValue, 3> clearValues{};
+		clearValues[0].color = { {m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a} };
+		clearValues[1].depthStencil = { 0.0f, 0 };  // reverse-Z far plane
+		uint32_t clearValueCount = (m_RenderPasses->GetSampleCount() != VK_SAMPLE_COUNT_1_BIT) ? 3u : 2u;
+
+		CullReflectionCasters();
+
+		const bool parallel = m_Commands->IsParallelRecording();
+
+		m_Commands->BeginRenderPass(frameIndex,
+			m_RenderPasses->GetReflectionRenderPass(),
+			m_RenderPasses->GetReflectionFramebuffer(),
+			extent,
+			clearValues.data(),
+			clearValueCount,
+			parallel ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+		// Negative-height viewport flips rasterized winding to cancel the mirror
+		// matrix's winding flip — so the scene pipelines' back-face culling stays
+		// correct without dedicated reflected-winding pipeline variants. The image
+		// is stored vertically flipped as a side effect; the water shader samples
+		// with v -> 1 - v to compensate.
+		// At a dynamic-resolution scale the viewport shrinks toward the
+		// BOTTOM-left instead (the flip's origin stays at the full height), so
+		// that same v -> 1 - v still lands on the right texel without the
+		// water shader knowing the scale. The planar resolution fraction
+		// shrinks it the same way; that one the water shader does know
+		// (FrameUniformData::reflection.x) and scales its lookup by.
+		const glm::vec2 scale = GetSceneUVScale() * GetPlanarReflectionScale();
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = static_cast<float>(extent.height);
+		viewport.width = static_cast<float>(extent.width) * scale.x;
+		viewport.height = -static_cast<float>(extent.height) * scale.y;
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		if (!parallel)
+		{
+			VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+			vkCmdSetViewport(cmd, 0, 1, &viewport);
+		}
+
+		VkDescriptorSet reflectionUniformSet = m_DescriptorManager->GetReflectionUniformDescriptorSet(frameIndex);
+		// Hand the mirror-camera cloud raymarch result to the recorder so it also
+		// composites clouds into the reflection (only ready when a cloud system is
+		// registered; null otherwise skips clouds in the reflection).
+		VkDescriptorSet cloudReflectionSet = (m_CloudSystem && m_CloudSystem->IsReady())
+			? m_CloudSystem->GetReflectionResultSet()
+			: VK_NULL_HANDLE;
+		if (parallel)
+		{
+			SecondaryPassInfo pass;
+			pass.renderPass = m_RenderPasses->GetReflectionRenderPass();
+			pass.framebuffer = m_RenderPasses->GetReflectionFramebuffer();
+			pass.viewport = viewport;
+			pass.scissor = { { 0, 0 }, extent };
+			m_Commands->ExecuteReflectionDrawListParallel(frameIndex, m_FrameDrawList,
+				m_PipelineAdapter.get(), reflectionUniformSet, cloudReflectionSet,
+				m_ReflectionCasters.data(), pass);
+		}
+		else
+		{
+			m_Commands->ExecuteReflectionDrawList(frameIndex, m_FrameDrawList,
+				m_PipelineAdapter.get(), reflectionUniformSet, cloudReflectionSet,
+				m_ReflectionCasters.data());
+		}
+
+		m_Commands->EndRenderPass(frameIndex);
+	}
+
+	bool Renderer::SupportsAuxiliaryViews() const
+	{
+		return m_RenderPasses && m_RenderPasses->SupportsAuxiliaryTargets();
+	}
+
+	void Renderer::SetAuxiliaryViews(const AuxiliaryView* views, uint32_t count)
+	{
+		m_AuxiliaryReadbacks.fill(VK_NULL_HANDLE);
+		count = std::min(count, MAX_AUXILIARY_VIEWS);
+		if (!SupportsAuxiliaryViews())
+			count = 0;
+
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		uint32_t ready = 0;
+		for (uint32_t view = 0; view < count; ++view)
+		{
+			const AuxiliaryView& desc = views[view];
+			if (desc.width == 0 || desc.height == 0)
+				break;
+			if (!m_RenderPasses->EnsureAuxiliaryTarget(vkDevice->GetDevice(), view,
+				{ desc.width, desc.height }, vkDevice->GetDeletionQueue()))
+			{
+				break;
+			}
+			m_AuxiliaryViews[view] = desc;
+			ready = view + 1;
+		}
+		m_AuxiliaryViewCount = ready;
+	}
+
+	VkImageView Renderer::GetAuxiliaryViewImageView(uint32_t view) const
+	{
+		return (m_RenderPasses && view < MAX_AUXILIARY_VIEWS) ? m_RenderPasses->GetAuxiliaryColorImageView(view) : VK_NULL_HANDLE;
+	}
+
+	VkSampler Renderer::GetAuxiliaryViewSampler() const
+	{
+		return m_RenderPasses ? m_RenderPasses->GetReflectionColorSampler() : VK_NULL_HANDLE;
+	}
+
+	VkExtent2D Renderer::GetAuxiliaryViewMaxExtent() const
+	{
+		return m_RenderPasses ? m_RenderPasses->GetReflectionExtent() : VkExtent2D{ 0, 0 };
+	}
+
+	VkExtent2D Renderer::GetAuxiliaryViewExtent(uint32_t view) const
+	{
+		return (m_RenderPasses && view < MAX_AUXILIARY_VIEWS) ? m_RenderPasses->GetAuxiliaryExtent(view) : VkExtent2D{ 0, 0 };
+	}
+
+	VkFormat Renderer::GetAuxiliaryViewFormat() const
+	{
+		return m_RenderPasses ? m_RenderPasses->GetSceneColorFormat() : VK_FORMAT_UNDEFINED;
+	}
+
+	void Renderer::RequestAuxiliaryViewReadback(uint32_t view, VkBuffer buffer)
+	{
+		if (view < m_AuxiliaryViewCount)
+			m_AuxiliaryReadbacks[view] = buffer;
+	}
+
+	// Per view: the main frame's uniforms with the view's camera swapped in,
+	// and which of the final commands it draws. time.w = 2 marks a secondary
+	// camera to the shaders - no clusters or aerial froxels (both built for
+	// the main camera), but no below-water clip either (scene_common.glsl).
+	void Renderer::UploadAuxiliaryViews(uint32_t frameIndex)
+	{
+		const size_t count = m_FrameDrawList.GetCommandCount();
+		for (uint32_t view = 0; view < m_AuxiliaryViewCount; ++view)
+		{
+			const AuxiliaryView& desc = m_AuxiliaryViews[view];
+			FrameUniformData data = m_CurrentFrameData;
+			data.view = desc.view;
+			data.proj = desc.projection;
+			data.invView = glm::inverse(desc.view);
+			data.invProj = glm::inverse(desc.projection);
+			data.cameraPos = glm::vec4(desc.position, 1.0f);
+			data.time.w = 2.0f;
+			data.reflection.x = 1.0f;
+
+			if (void* mapped = m_FrameUploads->GetMapped(frameIndex, m_AuxiliaryUniformSlots[view]))
+			{
+				memcpy(mapped, &data, sizeof(FrameUniformData));
+				m_FrameUploads->Flush(frameIndex, m_AuxiliaryUniformSlots[view]);
+			}
+
+			std::vector<uint8_t>& casters = m_AuxiliaryCasters[view];
+			casters.resize(count);
+			const uint8_t bit = static_cast<uint8_t>(1u << view);
+			for (size_t i = 0; i < count; ++i)
+				casters[i] = (m_FrameDrawList.GetCommand(i).auxViewMask & bit) ? 1 : 0;
+		}
+	}
+
+	// =====================================================================
+	// RecordAuxiliaryViewPass — one auxiliary camera, recorded like the
+	// planar reflection (same render pass, draw filter and executor) but
+	// unmirrored, so it keeps the pass's full-extent viewport. Clouds
+	// are left out: their raymarch result is per camera and the main
+	// view's does not line up with another projection.
+	// =====================================================================
+	void Renderer::RecordAuxiliaryViewPass(uint32_t frameIndex, uint32_t view)
+	{
+		const VkExtent2D extent = m_RenderPasses->GetAuxiliaryExtent(view);
+		const VkFramebuffer framebuffer = m_RenderPasses->GetAuxiliaryFramebuffer(view);
+		if (framebuffer == VK_NULL_HANDLE || extent.width == 0 || extent.height == 0)
 		{
 			return;
 		}
 
-		// Clear color (sky/background behind the reflected geometry) + depth.
-		// With MSAA the pass has a third (resolve) attachment whose clear value
-		// is unused but must be covered by the count.
-		std::array<VkClearValue, 3> clearValues{};
+		std::array<VkClearValue, 2> clearValues{};
 		clearValues[0].color = { {m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a} };
 		clearValues[1].depthStencil = { 0.0f, 0 };  // reverse-Z far plane
-		uint32_t clearValueCount = (m_RenderPasses->GetSampleCount() != VK_SAMPLE_COUNT_1_BIT) ? 3u : 2u;
+
+		const bool parallel = m_Commands->IsParallelRecording();
 
 		m_Commands->BeginRenderPass(frameIndex,
 			m_RenderPasses->GetReflectionRenderPass(),
-			m_RenderPasses->GetReflectionFramebuffer(),
+			framebuffer,
 			extent,
 			clearValues.data(),
-			clearValueCount);
-
-		// Negative-height viewport flips rasterized winding to cancel the mirror
-		// matrix's winding flip — so the scene pipelines' back-face culling stays
-		// correct without dedicated reflected-winding pipeline variants. The image
-		// is stored vertically flipped as a side effect; the water shader samples
-		// with v -> 1 - v to compensate.
-		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
-		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = static_cast<float>(extent.height);
-		viewport.width = static_cast<float>(extent.width);
-		viewport.height = -static_cast<float>(extent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-		VkDescriptorSet reflectionUniformSet = m_DescriptorManager->GetReflectionUniformDescriptorSet(frameIndex);
-		// Hand the mirror-camera cloud raymarch result to the recorder so it also
-		// composites clouds into the reflection (only ready when a cloud system is
-		// registered; null otherwise skips clouds in the reflection).
-		VkDescriptorSet cloudReflectionSet = (m_CloudSystem && m_CloudSystem->IsReady())
-			? m_CloudSystem->GetReflectionResultSet()
-			: VK_NULL_HANDLE;
-		m_Commands->ExecuteReflectionDrawList(frameIndex, m_FrameDrawList,
-			m_PipelineAdapter.get(), reflectionUniformSet, cloudReflectionSet);
+			static_cast<uint32_t>(clearValues.size()),
+			parallel ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+		VkDescriptorSet uniformSet = m_DescriptorManager->GetAuxiliaryUniformDescriptorSet(frameIndex, view);
+		const uint8_t* casters = m_AuxiliaryCasters[view].data();
+		if (parallel)
+		{
+			// BeginRenderPass's full-extent viewport, which inline recording gets
+			SecondaryPassInfo pass;
+			pass.renderPass = m_RenderPasses->GetReflectionRenderPass();
+			pass.framebuffer = framebuffer;
+			pass.viewport = { 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+			pass.scissor = { { 0, 0 }, extent };
+			m_Commands->ExecuteReflectionDrawListParallel(frameIndex, m_FrameDrawList,
+				m_PipelineAdapter.get(), uniformSet, VK_NULL_HANDLE, casters, pass);
+		}
+		else
+		{
+			m_Commands->ExecuteReflectionDrawList(frameIndex, m_FrameDrawList,
+				m_PipelineAdapter.get(), uniformSet, VK_NULL_HANDLE, casters);
+		}
 
 		m_Commands->EndRenderPass(frameIndex);
 	}
 
-	// =====================================================================
-	// RecordBloomPass — bright-extract the HDR scene color into half-res
-	// target A, then a separable Gaussian blur (A->B horizontal, B->A
-	// vertical). The post-process composite then adds target A back into the
-	// scene before tonemapping. One pipeline (PipelineType::Bloom) run three
-	// times with a push-constant mode, recorded directly like the other
-	// fixed full-screen passes. The bloom render pass's two subpass
-	// dependencies serialize the A<->B ping-pong.
-	// =====================================================================
-	void Renderer::RecordBloomPass(uint32_t frameIndex)
+	// Right after the view's render pass, in the layout it left the target
+	// (shader-read-only, visible to fragment shaders): copy out, make the
+	// copy host-visible, and hand the target back as it was found
+	void Renderer::RecordAuxiliaryViewReadback(VkCommandBuffer cmd, uint32_t view, VkBuffer buffer)
 	{
-		if (!m_RenderPasses || m_PostProcessInputSet == VK_NULL_HANDLE) return;
-
-		VkExtent2D extent = m_RenderPasses->GetBloomExtent();
-		if (extent.width == 0 || extent.height == 0) return;
-
-		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
-		VkPipelineLayout layout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::Bloom);
-
-		VkViewport viewport{};
-		viewport.x = 0.0f; viewport.y = 0.0f;
-		viewport.width = static_cast<float>(extent.width);
-		viewport.height = static_cast<float>(extent.height);
-		viewport.minDepth = 0.0f; viewport.maxDepth = 1.0f;
-
-		VkRect2D scissor{};
-		scissor.offset = { 0, 0 };
-		scissor.extent = extent;
-
-		// Matches PushConstants in Bloom.frag: vec2 direction, float threshold, int mode.
-		struct BloomPush { float dirX; float dirY; float threshold; int mode; };
-
-		auto runPass = [&](VkFramebuffer fb, VkDescriptorSet inputSet, const BloomPush& p)
-		{
-			VkRenderPassBeginInfo rp{};
-			rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-			rp.renderPass = m_RenderPasses->GetBloomRenderPass();
-			rp.framebuffer = fb;
-			rp.renderArea.offset = { 0, 0 };
-			rp.renderArea.extent = extent;
-			rp.clearValueCount = 0;   // loadOp = DONT_CARE; the full-screen triangle overwrites all
-			rp.pClearValues = nullptr;
-
-			vkCmdBeginRenderPass(cmd, &rp, VK_SUBPASS_CONTENTS_INLINE);
-			vkCmdSetViewport(cmd, 0, 1, &viewport);
-			vkCmdSetScissor(cmd, 0, 1, &scissor);
-			m_PipelineAdapter->BindPipeline(cmd, PipelineType::Bloom);
-			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &inputSet, 0, nullptr);
-			vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(BloomPush), &p);
-			vkCmdDraw(cmd, 3, 1, 0, 0);
-			vkCmdEndRenderPass(cmd);
-		};
-
-		const float threshold = m_PostProcessSettings.bloomThreshold;
-
-		// 1) Bright extract + downsample: scene color -> A
-		runPass(m_RenderPasses->GetBloomFramebufferA(), m_PostProcessInputSet, BloomPush{ 0.0f, 0.0f, threshold, 0 });
-		// 2) Horizontal blur: A -> B
-		runPass(m_RenderPasses->GetBloomFramebufferB(), m_BloomSetA, BloomPush{ 1.0f, 0.0f, threshold, 1 });
-		// 3) Vertical blur: B -> A  (A is then sampled by the post-process composite)
-		runPass(m_RenderPasses->GetBloomFramebufferA(), m_BloomSetB, BloomPush{ 0.0f, 1.0f, threshold, 1 });
+		const VkImage image = m_RenderPasses->GetAuxiliaryColorImage(view);
+		const VkExtent2D extent = m_RenderPasses->GetAuxiliaryExtent(view);
+
+		VkImageMemoryBarrier toTransfer{};
+		toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		toTransfer.srcAccessMask = 0;   // chained to the render pass's outgoing dependency
+		toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		toTransfer.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toTransfer.image = image;
+		toTransfer.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+		VkBufferImageCopy region{};
+		region.bufferRowLength = 0;    // tightly packed
+		region.bufferImageHeight = 0;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { extent.width, extent.height, 1 };
+		vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+		// Make the copy available to the host; the fence wait does the rest
+		VkBufferMemoryBarrier hostBarrier{};
+		hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.buffer = buffer;
+		hostBarrier.offset = 0;
+		hostBarrier.size = VK_WHOLE_SIZE;
+
+		VkImageMemoryBarrier toShaderRead = toTransfer;
+		toShaderRead.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		toShaderRead.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		toShaderRead.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		toShaderRead.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 1, &hostBarrier, 1, &toShaderRead);
 	}
 
 	// =====================================================================
@@ -2309,79 +6234,448 @@ namespace Nightbloom
 	// the scene pass, runs FXAA, and writes the swapchain image. A single
 	// fixed full-screen draw, not a DrawList entry, so this is recorded
 	// directly here rather than through CommandRecorder's per-pipeline-type
-	// binding lists — same precedent as RecordShadowPass/RecordComputePass.
+	// binding lists — same precedent as RecordShadowPass/RecordComputeTestPass.
 	// UI renders last, in this same pass, directly on the swapchain target.
 	// =====================================================================
 	void Renderer::RecordPostProcessPass(uint32_t frameIndex, uint32_t imageIndex)
 	{
 		VkCommandBuffer cmd = m_Commands->GetCommandBuffer(frameIndex);
+		const bool dynamicRendering = m_RenderPasses->IsPostProcessDynamic();
+		RenderStats& stats = RenderStats::Get();
+
+		if (dynamicRendering)
+		{
+			BeginPostProcessRendering(cmd, imageIndex);
+		}
+		else
+		{
+			VkClearValue clearValue{};
+			clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
 
-		VkClearValue clearValue{};
-		clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+			VkRenderPassBeginInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = m_RenderPasses->GetPostProcessRenderPass();
+			renderPassInfo.framebuffer = m_RenderPasses->GetPostProcessFramebuffer(imageIndex);
+			renderPassInfo.renderArea.offset = { 0, 0 };
+			renderPassInfo.renderArea.extent = m_Swapchain->GetExtent();
+			renderPassInfo.clearValueCount = 1;
+			renderPassInfo.pClearValues = &clearValue;
 
-		VkRenderPassBeginInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = m_RenderPasses->GetPostProcessRenderPass();
-		renderPassInfo.framebuffer = m_RenderPasses->GetPostProcessFramebuffer(imageIndex);
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = m_Swapchain->GetExtent();
-		renderPassInfo.clearValueCount = 1;
-		renderPassInfo.pClearValues = &clearValue;
+			vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		}
 
-		vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		// The scene fills the scene viewport's rect; with a smaller one the
+		// rest of the image (DONT_CARE on load) is cleared for the UI
+		const VkExtent2D extent = m_Swapchain->GetExtent();
+		const SceneViewportRect& rect = m_SceneViewport.GetRect();
+		if (rect.x != 0 || rect.y != 0 || rect.width != extent.width || rect.height != extent.height)
+		{
+			VkClearAttachment clearAttachment{};
+			clearAttachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			clearAttachment.colorAttachment = 0;
+			clearAttachment.clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+			VkClearRect clearRect{};
+			clearRect.rect = { { 0, 0 }, extent };
+			clearRect.layerCount = 1;
+			vkCmdClearAttachments(cmd, 1, &clearAttachment, 1, &clearRect);
+		}
 
-		VkExtent2D extent = m_Swapchain->GetExtent();
 		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(extent.width);
-		viewport.height = static_cast<float>(extent.height);
+		viewport.x = static_cast<float>(rect.x);
+		viewport.y = static_cast<float>(rect.y);
+		viewport.width = static_cast<float>(rect.width);
+		viewport.height = static_cast<float>(rect.height);
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
 		vkCmdSetViewport(cmd, 0, 1, &viewport);
 
 		VkRect2D scissor{};
-		scissor.offset = { 0, 0 };
-		scissor.extent = extent;
+		scissor.offset = { rect.x, rect.y };
+		scissor.extent = { rect.width, rect.height };
 		vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-		if (m_PostProcessInputSet != VK_NULL_HANDLE && m_BloomSetA != VK_NULL_HANDLE)
+		if (IsComputePostActive())
+		{
+			// Composited by the compute post pass already
+			m_PipelineAdapter->BindPipeline(cmd, PipelineType::PostProcessCopy);
+
+			VkPipelineLayout layout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::PostProcessCopy);
+			VkDescriptorSet outputSet = m_ComputePost->GetOutputSet();
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+				0, 1, &outputSet, 0, nullptr);
+
+			vkCmdDraw(cmd, 3, 1, 0, 0);
+
+			stats.Add(RenderCounter::PipelineBinds);
+			stats.Add(RenderCounter::DescriptorBinds);
+			stats.AddDraw(3, 1);
+		}
+		else if (m_PostProcessInputSet != VK_NULL_HANDLE)
 		{
 			m_PipelineAdapter->BindPipeline(cmd, PipelineType::PostProcess);
 
 			VkPipelineLayout layout = m_PipelineAdapter->GetVulkanManager()->GetPipelineLayout(PipelineType::PostProcess);
-			// set 0 = scene color, set 1 = bloom result (target A, after blur V).
-			VkDescriptorSet sets[2] = { m_PostProcessInputSet, m_BloomSetA };
+			// set 0 = scene color (or the temporal upscaler's output), set 1 =
+			// bloom chain mip 0. Without bloom set 1 is any valid sampler set
+			// (the scene color again) and the intensity is pushed as 0.
+			const bool temporal = IsTemporalUpscaling();
+			const bool bloom = m_ComputeDispatcher && m_BloomChain && m_PostProcessSettings.bloomIntensity > 0.0f;
+			VkDescriptorSet sets[2] = {
+				temporal ? m_TemporalUpscaler->GetOutputSet() : m_PostProcessInputSet,
+				bloom ? m_BloomChain->GetOutputSet() : m_PostProcessInputSet };
 			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
 				0, 2, sets, 0, nullptr);
 
-			// Must match PushConstants in PostProcess.frag (std430 scalar layout):
-			// (int aaEnabled, int tonemapEnabled, float exposure, float vignetteStrength, float bloomIntensity).
-			struct PostProcessPush
-			{
-				int   aaEnabled;
-				int   tonemapEnabled;
-				float exposure;
-				float vignetteStrength;
-				float bloomIntensity;
-			} push;
-			push.aaEnabled        = m_PostProcessSettings.aaEnabled ? 1 : 0;
-			push.tonemapEnabled   = m_PostProcessSettings.tonemapEnabled ? 1 : 0;
-			push.exposure         = m_PostProcessSettings.exposure;
-			push.vignetteStrength = m_PostProcessSettings.vignetteStrength;
-			push.bloomIntensity   = m_PostProcessSettings.bloomIntensity;
+			const PostProcessPushConstants push = BuildPostProcessPush(temporal, bloom);
 			vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push), &push);
 
 			vkCmdDraw(cmd, 3, 1, 0, 0);
+
+			stats.Add(RenderCounter::PipelineBinds);
+			stats.Add(RenderCounter::DescriptorBinds, 2);
+			stats.Add(RenderCounter::PushConstants);
+			stats.AddDraw(3, 1);
 		}
 
-		// Render UI on top — after AA, directly on the swapchain target.
+		// Render UI on top — after AA, directly on the swapchain target (or
+		// the cached UI laid over it)
 		if (m_UI)
 		{
-			m_UI->Render(cmd);
+			m_UI->Render(cmd, frameIndex);
 		}
 
-		vkCmdEndRenderPass(cmd);
+		if (dynamicRendering)
+			EndPostProcessRendering(cmd, imageIndex);
+		else
+			vkCmdEndRenderPass(cmd);
+	}
+
+	// The dynamic-rendering form of the post-process render pass: the same
+	// attachment (DONT_CARE load, store) on the swapchain image view, with
+	// the pass's UNDEFINED -> PRESENT_SRC transition and external dependency
+	// as explicit barriers
+	void Renderer::BeginPostProcessRendering(VkCommandBuffer cmd, uint32_t imageIndex)
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+
+		VkImageMemoryBarrier toAttachment{};
+		toAttachment.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		toAttachment.srcAccessMask = 0;
+		toAttachment.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		toAttachment.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		toAttachment.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		toAttachment.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toAttachment.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toAttachment.image = m_Swapchain->GetImages()[imageIndex];
+		toAttachment.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		// Same stage as the acquire semaphore wait, so the write can't start
+		// before the presentation engine has released the image
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &toAttachment);
+		RenderStats::Get().Add(RenderCounter::Barriers);
+
+		VkRenderingAttachmentInfoKHR colorAttachment{};
+		colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		colorAttachment.imageView = m_Swapchain->GetImageViews()[imageIndex];
+		colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+		VkRenderingInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea = { { 0, 0 }, m_Swapchain->GetExtent() };
+		renderingInfo.layerCount = 1;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachments = &colorAttachment;
+		vkDevice->CmdBeginRendering(cmd, renderingInfo);
+	}
+
+	void Renderer::EndPostProcessRendering(VkCommandBuffer cmd, uint32_t imageIndex)
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		vkDevice->CmdEndRendering(cmd);
+
+		VkImageMemoryBarrier toPresent{};
+		toPresent.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		toPresent.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		toPresent.dstAccessMask = 0;
+		toPresent.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		toPresent.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toPresent.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toPresent.image = m_Swapchain->GetImages()[imageIndex];
+		toPresent.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &toPresent);
+		RenderStats::Get().Add(RenderCounter::Barriers);
+	}
+
+	Renderer::PostProcessPushConstants Renderer::BuildPostProcessPush(bool temporal, bool bloom) const
+	{
+		PostProcessPushConstants push;
+		push.aaEnabled        = (m_PostProcessSettings.aaEnabled && !temporal) ? 1 : 0;
+		push.tonemapEnabled   = m_PostProcessSettings.tonemapEnabled ? 1 : 0;
+		push.exposure         = m_PostProcessSettings.exposure;
+		push.vignetteStrength = m_PostProcessSettings.vignetteStrength;
+		push.bloomIntensity   = bloom ? m_PostProcessSettings.bloomIntensity : 0.0f;
+		// Dynamic resolution: upscale the rendered rect (the temporal output
+		// is already at display resolution)
+		const glm::vec2 uvScale = temporal ? glm::vec2(1.0f) : GetSceneUVScale();
+		push.uvScaleX         = uvScale.x;
+		push.uvScaleY         = uvScale.y;
+		return push;
+	}
+
+	bool Renderer::IsComputePostActive() const
+	{
+		return m_PostProcessSettings.computePost && m_ComputeDispatcher && m_ComputePost &&
+			m_PostProcessInputSet != VK_NULL_HANDLE;
+	}
+
+	bool Renderer::IsScreenSpaceReflectionActive() const
+	{
+		return m_WaterSystem && m_SSR && m_OcclusionCuller && m_ComputeDispatcher &&
+			m_WaterSystem->GetDesc().reflectionMode == WaterReflectionMode::ScreenSpace;
+	}
+
+	void Renderer::SetLightingData(const SceneLightingData& data)
+	{
+		m_CurrentLightingData = data;
+
+		m_LightingPointScratch.clear();
+		for (int i = 0; i < data.numLights && i < static_cast<int>(MAX_LIGHTS); ++i)
+		{
+			if (data.lights[i].position.w > 0.5f)
+				m_LightingPointScratch.push_back(data.lights[i]);
+		}
+		SetPointLights(m_LightingPointScratch);
+	}
+
+	void Renderer::SetDrawStreamReplay(const DrawStream* stream)
+	{
+		m_DrawStreamReplay = stream;
+		m_DrawStreamUniformsMatch = stream &&
+			stream->lighting.size() == sizeof(SceneLightingData) &&
+			stream->shadowUniforms.size() == sizeof(FrameUniformData) * NUM_CASCADES &&
+			stream->cascadeLightViewProj.size() == NUM_CASCADES;
+		if (stream && !m_DrawStreamUniformsMatch)
+			LOG_WARN("Draw stream's uniform blocks don't match this build; replaying its camera and draws only");
+		InvalidateShadowCache();
+	}
+
+	void Renderer::ApplyDrawStreamInputs()
+	{
+		const DrawStream& stream = *m_DrawStreamReplay;
+		m_ViewMatrix = stream.view;
+		m_ProjectionMatrix = stream.projection;
+		m_CameraPosition = stream.cameraPosition;
+		m_SunDirection = stream.sunDirection;
+		m_ShadowCenter = stream.shadowCenter;
+		// Time stands still at the captured frame's
+		m_TotalTime = stream.time;
+		m_LastDeltaTime = 0.0f;
+
+		if (m_DrawStreamUniformsMatch)
+		{
+			SceneLightingData lighting;
+			memcpy(&lighting, stream.lighting.data(), sizeof(SceneLightingData));
+			SetLightingData(lighting);
+		}
+	}
+
+	void Renderer::ApplyDrawStreamShadows()
+	{
+		if (!m_DrawStreamUniformsMatch)
+			return;
+
+		// The cascades as captured, not as this frame's cache state would fit them
+		const DrawStream& stream = *m_DrawStreamReplay;
+		memcpy(m_ShadowFrameData.data(), stream.shadowUniforms.data(), sizeof(FrameUniformData) * NUM_CASCADES);
+		std::copy(stream.cascadeLightViewProj.begin(), stream.cascadeLightViewProj.end(), m_CascadeLightVP.begin());
+
+		SceneLightingData lighting;
+		memcpy(&lighting, stream.lighting.data(), sizeof(SceneLightingData));
+		m_CurrentLightingData.shadowData = lighting.shadowData;
+	}
+
+	void Renderer::CaptureDrawStream()
+	{
+		static_assert(DrawStreamDraw::MAX_TEXTURES == DrawTextureSlots::CAPACITY, "one index per texture slot");
+		static_assert(sizeof(InstanceData) == sizeof(glm::mat4), "instance records are stored as their model matrix");
+
+		const std::string path = std::move(m_DrawStreamCapturePath);
+		m_DrawStreamCapturePath.clear();
+
+		DrawStreamResources resources;
+		m_Resources->GetDrawStreamResources(resources);
+
+		DrawStream stream;
+		stream.view = m_ViewMatrix;
+		stream.projection = m_ProjectionMatrix;
+		stream.cameraPosition = m_CameraPosition;
+		stream.time = m_TotalTime;
+		stream.sunDirection = m_SunDirection;
+		stream.shadowCenter = m_ShadowCenter;
+
+		const auto* frameBytes = reinterpret_cast<const uint8_t*>(&m_CurrentFrameData);
+		stream.frameUniforms.assign(frameBytes, frameBytes + sizeof(FrameUniformData));
+		const auto* lightingBytes = reinterpret_cast<const uint8_t*>(&m_CurrentLightingData);
+		stream.lighting.assign(lightingBytes, lightingBytes + sizeof(SceneLightingData));
+		const auto* shadowBytes = reinterpret_cast<const uint8_t*>(m_ShadowFrameData.data());
+		stream.shadowUniforms.assign(shadowBytes, shadowBytes + sizeof(FrameUniformData) * NUM_CASCADES);
+		stream.cascadeLightViewProj.assign(m_CascadeLightVP.begin(), m_CascadeLightVP.end());
+
+		// A null pointer is no resource; one without a name can't be captured
+		const auto resolve = [&](const void* resource, uint32_t& index)
+		{
+			index = DrawStreamDraw::NO_RESOURCE;
+			if (!resource)
+				return true;
+			const StringId name = resources.FindName(resource);
+			if (!name.IsValid())
+				return false;
+			index = stream.AddResource(name);
+			return true;
+		};
+
+		for (const DrawCommand& cmd : m_FrameDrawList.GetCommands())
+		{
+			// System-owned descriptor sets and buffers, and GPU-written arguments
+			if (cmd.indirectBuffer || cmd.heightmapDescriptorSet != VK_NULL_HANDLE ||
+				cmd.textureDescriptorSet != VK_NULL_HANDLE || cmd.pushBuffers[0].buffer != VK_NULL_HANDLE)
+			{
+				++stream.skippedDraws;
+				continue;
+			}
+
+			DrawStreamDraw draw;
+			bool resolved = resolve(cmd.vertexBuffer, draw.vertexBuffer) && resolve(cmd.indexBuffer, draw.indexBuffer);
+			draw.textureCount = cmd.textures.GetCount();
+			for (uint32_t i = 0; i < draw.textureCount && resolved; ++i)
+				resolved = resolve(cmd.textures[i], draw.textures[i]);
+			if (!resolved)
+			{
+				++stream.skippedDraws;
+				continue;
+			}
+
+			draw.pipeline = static_cast<uint32_t>(cmd.pipeline);
+			draw.vertexFormat = static_cast<uint32_t>(cmd.vertexFormat);
+			draw.indexCount = cmd.indexCount;
+			draw.vertexCount = cmd.vertexCount;
+			draw.firstIndex = cmd.firstIndex;
+			draw.vertexOffset = cmd.vertexOffset;
+			draw.instanceCount = cmd.instanceCount;
+			draw.firstInstance = cmd.firstInstance;
+			draw.firstMeshlet = cmd.firstMeshlet;
+			draw.meshletCount = cmd.meshletCount;
+			draw.materialIndex = cmd.pushConstants.materialIndex;
+			draw.tessellated = cmd.tessellated;
+			draw.cameraVisible = cmd.cameraVisible;
+			draw.auxViewMask = cmd.auxViewMask;
+			draw.hasPushConstants = cmd.hasPushConstants;
+			draw.hasBounds = cmd.hasBounds;
+			draw.boundsCenter = cmd.bounds.center;
+			draw.boundsExtents = cmd.bounds.extents;
+			draw.model = cmd.pushConstants.model;
+			draw.customData = cmd.pushConstants.customData;
+
+			if (cmd.instanceData)
+			{
+				const auto* records = static_cast<const InstanceData*>(cmd.instanceData);
+				draw.firstInstanceRecord = static_cast<uint32_t>(stream.instanceRecords.size());
+				for (uint32_t i = 0; i < cmd.instanceCount; ++i)
+					stream.instanceRecords.push_back(records[i].model);
+			}
+			stream.draws.push_back(draw);
+		}
+
+		if (!WriteDrawStream(path, stream))
+		{
+			LOG_ERROR("Failed to write draw stream {}", path);
+			return;
+		}
+		LOG_INFO("Captured draw stream: {} draws ({} skipped), {} resources -> {}",
+			stream.draws.size(), stream.skippedDraws, stream.resources.size(), path);
+	}
+
+	uint32_t Renderer::BuildDrawStreamList(const DrawStream& stream, DrawList& drawList)
+	{
+		DrawStreamResources resources;
+		m_Resources->GetDrawStreamResources(resources);
+
+		// A resource the stream names but this process never loaded drops the draw
+		const auto find = [&](uint32_t index, const void*& resource)
+		{
+			resource = nullptr;
+			if (index == DrawStreamDraw::NO_RESOURCE)
+				return true;
+			resource = resources.Find(stream.resources[index]);
+			return resource != nullptr;
+		};
+
+		uint32_t dropped = 0;
+		for (const DrawStreamDraw& draw : stream.draws)
+		{
+			const void* vertexBuffer = nullptr;
+			const void* indexBuffer = nullptr;
+			const void* textures[DrawStreamDraw::MAX_TEXTURES] = {};
+			bool resolved = find(draw.vertexBuffer, vertexBuffer) && find(draw.indexBuffer, indexBuffer);
+			for (uint32_t i = 0; i < draw.textureCount && resolved; ++i)
+				resolved = find(draw.textures[i], textures[i]);
+			if (!resolved)
+			{
+				++dropped;
+				continue;
+			}
+
+			DrawCommand& cmd = drawList.Emit();
+			cmd.pipeline = static_cast<PipelineType>(draw.pipeline);
+			cmd.vertexFormat = static_cast<VertexFormat>(draw.vertexFormat);
+			cmd.vertexBuffer = static_cast<Buffer*>(const_cast<void*>(vertexBuffer));
+			cmd.indexBuffer = static_cast<Buffer*>(const_cast<void*>(indexBuffer));
+			for (uint32_t i = 0; i < draw.textureCount; ++i)
+				cmd.textures.Add(static_cast<Texture*>(const_cast<void*>(textures[i])));
+			cmd.indexCount = draw.indexCount;
+			cmd.vertexCount = draw.vertexCount;
+			cmd.firstIndex = draw.firstIndex;
+			cmd.vertexOffset = draw.vertexOffset;
+			cmd.instanceCount = draw.instanceCount;
+			cmd.firstInstance = draw.firstInstance;
+			cmd.firstMeshlet = draw.firstMeshlet;
+			cmd.meshletCount = draw.meshletCount;
+			cmd.tessellated = draw.tessellated != 0;
+			cmd.cameraVisible = draw.cameraVisible != 0;
+			cmd.auxViewMask = draw.auxViewMask;
+			cmd.hasPushConstants = draw.hasPushConstants != 0;
+			cmd.pushConstants.model = draw.model;
+			cmd.pushConstants.customData = draw.customData;
+			cmd.pushConstants.materialIndex = draw.materialIndex;
+			cmd.hasBounds = draw.hasBounds != 0;
+			cmd.bounds.center = draw.boundsCenter;
+			cmd.bounds.extents = draw.boundsExtents;
+			if (draw.firstInstanceRecord != DrawStreamDraw::NO_RESOURCE)
+				cmd.instanceData = &stream.instanceRecords[draw.firstInstanceRecord];
+		}
+		return dropped;
+	}
+
+	void Renderer::SetPointLights(const std::vector<LightData>& lights)
+	{
+		// Bumping the version makes the light cluster buffers re-upload
+		if (lights.size() == m_PointLights.size() &&
+			(lights.empty() || memcmp(lights.data(), m_PointLights.data(), sizeof(LightData) * lights.size()) == 0))
+			return;
+
+		m_PointLights = lights;
+		++m_PointLightsVersion;
+	}
+
+	bool Renderer::SupportsClusteredLighting() const
+	{
+		return m_ComputeDispatcher && m_LightClusters && m_LightClusters->CanCull();
 	}
 
 	bool Renderer::HandleSwapchainResize()
@@ -2390,9 +6684,6 @@ namespace Nightbloom
 
 		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
 
-		// Wait for device to be idle
-		m_Device->WaitForIdle();
-
 		// Get ACTUAL current size from the swapchain/surface, not stored values
 		VkSurfaceCapabilitiesKHR caps;
 		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
@@ -2414,6 +6705,24 @@ namespace Nightbloom
 
 		LOG_INFO("Recreating swapchain with width: {}, height: {}", newWidth, newHeight);
 
+		// Same extent (present mode change, SUBOPTIMAL after a monitor move):
+		// only the swapchain and the framebuffers over its images change, and
+		// the old ones are destroyed once the frames in flight are done
+		const VkExtent2D oldExtent = m_Swapchain->GetExtent();
+		const bool sizeChanged = (newWidth != oldExtent.width || newHeight != oldExtent.height);
+
+		// The size-dependent targets below are rebuilt in place and their
+		// descriptor sets rewritten, so frames still using them must finish -
+		// a wait on the graphics queue's last submission, not a device idle
+		if (sizeChanged)
+		{
+			VulkanQueueTimeline* timeline = vkDevice->GetGraphicsTimeline();
+			timeline->Wait(timeline->GetLastSubmittedValue());
+
+			// GPU times measured at the old size no longer predict the new one
+			m_DynamicResolution.Reset();
+		}
+
 		// Update stored dimensions
 		m_Width = newWidth;
 		m_Height = newHeight;
@@ -2425,14 +6734,140 @@ namespace Nightbloom
 			return false;
 		}
 
+		if (!m_FrameSync->SetSwapchainImageCount(m_Swapchain->GetImageCount()))
+		{
+			LOG_ERROR("Failed to create per-image sync objects");
+			return false;
+		}
+
+		if (sizeChanged && m_UI)
+			m_UI->Resize(m_Swapchain->GetExtent());
+
+		// The scene targets follow the scene viewport on the new surface at
+		// once; a region that keeps its size keeps them
+		const VkExtent2D sceneExtent = m_RenderPasses->GetSceneExtent();
+		const bool sceneChanged = sizeChanged && m_SceneViewport.Update(glm::uvec2(newWidth, newHeight),
+			glm::uvec2(sceneExtent.width, sceneExtent.height), true);
+
+		if (!sceneChanged)
+		{
+			if (!m_RenderPasses->RecreateSwapchainFramebuffers(vkDevice->GetDevice(), m_Swapchain.get(),
+				vkDevice->GetDeletionQueue()))
+			{
+				LOG_ERROR("Failed to recreate post-process framebuffers");
+				return false;
+			}
+
+			LOG_INFO("Swapchain recreated ({}), render targets kept",
+				VulkanSwapchain::GetPresentModeName(m_Swapchain->GetPresentMode()));
+			return true;
+		}
+
 		// Recreate framebuffers (also recreates the offscreen scene-color
 		// texture the post-process pass samples — its view/sampler handles
 		// change, so the descriptor set pointing at them must be re-updated)
-		if (!m_RenderPasses->RecreateFramebuffers(vkDevice->GetDevice(), m_Swapchain.get()))
+		const glm::uvec2 target = m_SceneViewport.GetTargetExtent();
+		if (!m_RenderPasses->RecreateFramebuffers(vkDevice->GetDevice(), m_Swapchain.get(), { target.x, target.y }))
 		{
 			LOG_ERROR("Failed to recreate framebuffers");
 			return false;
 		}
+		RebindSceneTargets();
+
+		LOG_INFO("Swapchain resize handled successfully");
+		return true;
+	}
+
+	bool Renderer::ResizeSceneTargets(VkExtent2D extent)
+	{
+		VulkanDevice* vkDevice = static_cast<VulkanDevice*>(m_Device.get());
+		LOG_INFO("Resizing scene targets to {}x{}", extent.width, extent.height);
+
+		// Rebuilt in place with their descriptor sets rewritten, as for a
+		// window resize: a wait on the graphics queue's last submission
+		VulkanQueueTimeline* timeline = vkDevice->GetGraphicsTimeline();
+		timeline->Wait(timeline->GetLastSubmittedValue());
+		m_DynamicResolution.Reset();
+
+		if (!m_RenderPasses->RecreateSceneTargets(vkDevice->GetDevice(), extent))
+		{
+			LOG_ERROR("Failed to resize the scene targets");
+			return false;
+		}
+		RebindSceneTargets();
+		return true;
+	}
+
+	void Renderer::SetUIOverlaySettings(const UIOverlaySettings& settings)
+	{
+		if (m_UI)
+			m_UI->SetSettings(settings);
+	}
+
+	UIOverlaySettings Renderer::GetUIOverlaySettings() const
+	{
+		return m_UI ? m_UI->GetSettings() : UIOverlaySettings{};
+	}
+
+	bool Renderer::IsUIFrame() const
+	{
+		return m_UI && m_UI->IsFrameActive();
+	}
+
+	void Renderer::RequestUIRefresh()
+	{
+		if (m_UI)
+			m_UI->RequestRefresh();
+	}
+
+	uint32_t Renderer::GetUIReusedFrames() const
+	{
+		return m_UI ? m_UI->GetReusedFrames() : 0;
+	}
+
+	VkExtent2D Renderer::GetSceneExtent() const
+	{
+		return m_RenderPasses ? m_RenderPasses->GetSceneExtent() : VkExtent2D{ m_Width, m_Height };
+	}
+
+	void Renderer::RebindSceneTargets()
+	{
+		const VkExtent2D sceneExtent = m_RenderPasses->GetSceneExtent();
+
+		// The depth buffer the Hi-Z pyramid reduces was recreated at the new size
+		if (m_OcclusionCuller &&
+			!m_OcclusionCuller->Resize(m_RenderPasses->GetDepthImageView(), sceneExtent))
+		{
+			LOG_WARN("Failed to resize the Hi-Z pyramid - disabling occlusion culling");
+			if (m_MeshletCuller)
+			{
+				m_MeshletCuller->Cleanup();
+				m_MeshletCuller.reset();
+			}
+			m_OcclusionCuller->Cleanup();
+			m_OcclusionCuller.reset();
+		}
+
+		// ...as were the shading-rate images
+		if (m_VariableRateShading)
+		{
+			m_VariableRateShading->Resize(m_RenderPasses->GetShadingRateImage(), m_RenderPasses->GetShadingRateImageView(),
+				m_RenderPasses->GetShadingRateExtent(), m_RenderPasses->GetReflectionShadingRateImage());
+		}
+
+		// ...as were the scene color and depth the temporal upscaler reads
+		if (m_TemporalUpscaler &&
+			!m_TemporalUpscaler->Resize(m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetResolvedDepthImageView(),
+				sceneExtent))
+		{
+			LOG_WARN("Failed to resize the temporal upscaler history - disabling temporal upscaling");
+			m_TemporalUpscaler->Cleanup();
+			m_TemporalUpscaler.reset();
+		}
+		if (m_ContactShadows)
+		{
+			m_ContactShadows->Resize(m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetResolvedDepthImageView());
+		}
 
 		if (m_PostProcessInputSet != VK_NULL_HANDLE)
 		{
@@ -2440,13 +6875,40 @@ namespace Nightbloom
 				m_RenderPasses->GetSceneColorImageView(), m_RenderPasses->GetSceneColorSampler());
 		}
 
-		// Bloom targets were recreated at the new half-extent — re-point their sampler sets.
-		if (m_BloomSetA != VK_NULL_HANDLE)
-			m_DescriptorManager->UpdatePostProcessInputSet(m_BloomSetA,
-				m_RenderPasses->GetBloomImageViewA(), m_RenderPasses->GetBloomSampler());
-		if (m_BloomSetB != VK_NULL_HANDLE)
-			m_DescriptorManager->UpdatePostProcessInputSet(m_BloomSetB,
-				m_RenderPasses->GetBloomImageViewB(), m_RenderPasses->GetBloomSampler());
+		// The OIT targets were recreated with the scene color
+		if (m_OitInputSet != VK_NULL_HANDLE)
+		{
+			m_DescriptorManager->UpdateOitInputSet(m_OitInputSet,
+				m_RenderPasses->GetOitAccumulationView(), m_RenderPasses->GetOitRevealageView());
+		}
+
+		// The bloom chain was recreated at the new half-extent (possibly with a
+		// different level count)
+		if (m_BloomChain &&
+			!m_BloomChain->Resize(m_RenderPasses->GetSceneColorImageView(), sceneExtent,
+				m_RenderPasses->GetBloomImage(), m_RenderPasses->GetBloomExtent(), m_RenderPasses->GetBloomMipCount()))
+		{
+			LOG_WARN("Failed to resize the bloom chain - disabling bloom");
+			m_BloomChain->Cleanup();
+			m_BloomChain.reset();
+		}
+
+		if (m_ComputePost && !m_ComputePost->Resize(sceneExtent))
+		{
+			LOG_WARN("Failed to resize the compute post output - disabling the compute post pass");
+			m_ComputePost->Cleanup();
+			m_ComputePost.reset();
+		}
+
+		// The reflection output matches the scene targets, the history the pyramid
+		if (m_SSR && (!m_OcclusionCuller ||
+			!m_SSR->Resize(m_RenderPasses->GetSceneColorImageView(), sceneExtent,
+				m_OcclusionCuller->GetPyramidExtent())))
+		{
+			LOG_WARN("Failed to resize the screen-space reflection targets - using planar reflection only");
+			m_SSR->Cleanup();
+			m_SSR.reset();
+		}
 
 		// Reflection target was recreated too — re-point the water's sampler set.
 		if (m_ReflectionInputSet != VK_NULL_HANDLE)
@@ -2454,17 +6916,13 @@ namespace Nightbloom
 			m_DescriptorManager->UpdateReflectionInputSet(m_ReflectionInputSet,
 				m_RenderPasses->GetReflectionColorImageView(), m_RenderPasses->GetReflectionColorSampler());
 		}
+		m_ReflectionSchedule.Invalidate();
 
 		// Recreate the cloud raymarch result image at the new scaled resolution
 		if (m_CloudSystem)
 		{
-			m_CloudSystem->ResizeResultImage(newWidth, newHeight);
+			m_CloudSystem->ResizeResultImage(sceneExtent.width, sceneExtent.height);
 		}
-
-		// TODO: Update pipeline viewport/scissor if needed
-
-		LOG_INFO("Swapchain resize handled successfully");
-		return true;
 	}
 
 	void Renderer::CleanupCompute()
@@ -2481,11 +6939,14 @@ namespace Nightbloom
 			m_NoiseGenerator.reset();
 		}
 
-		if (m_TestNoise)
+		if (m_AsyncCompute)
 		{
-			delete m_TestNoise;
-			m_TestNoise = nullptr;
+			m_AsyncCompute->Cleanup();
+			m_AsyncCompute.reset();
 		}
+		m_AsyncComputeFrame = false;
+		m_FrameHeadCommandBuffer = VK_NULL_HANDLE;
+		m_AgentBufferReleasedToCompute = VK_NULL_HANDLE;
 
 		if (m_ComputeDispatcher)
 		{
@@ -2521,13 +6982,14 @@ namespace Nightbloom
 
 		// Resize only refreshed ShadowMapManager's own descriptor copies; repoint the
 		// descriptor-manager sets the main pass actually binds at the recreated array view.
-		for (uint32_t i = 0; i < FrameSyncManager::MAX_FRAMES_IN_FLIGHT; ++i)
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_DescriptorManager->UpdateShadowSet(
 				i,
 				m_ShadowManager->GetShadowMapView(),
 				m_ShadowManager->GetShadowSampler());
 		}
+		InvalidateShadowCache();  // the static cache was recreated empty
 		LOG_INFO("Shadow map resolution set to {}x{}", resolution, resolution);
 	}
 
@@ -2541,6 +7003,7 @@ namespace Nightbloom
 		if (!m_ShadowEnabled || m_CurrentLightingData.numLights == 0)
 		{
 			m_CurrentLightingData.shadowData.shadowParams.w = 0.0f;
+			InvalidateShadowCache();
 			return;
 		}
 
@@ -2549,6 +7012,7 @@ namespace Nightbloom
 		if (primaryLight.position.w > 0.5f)
 		{
 			m_CurrentLightingData.shadowData.shadowParams.w = 0.0f;
+			InvalidateShadowCache();
 			return;
 		}
 
@@ -2557,7 +7021,7 @@ namespace Nightbloom
 		const float shadowDist = m_ShadowConfig.shadowDistance;
 		const float lambda     = m_ShadowConfig.splitLambda;
 		const float extrude    = m_ShadowConfig.casterExtrude;
-		const float resolution = static_cast<float>(m_ShadowManager->GetConfig().resolution);
+		const uint32_t layerTexels = m_ShadowManager->GetConfig().resolution;
 
 		// Light basis: position.xyz = direction the light is SHINING (e.g. (0,-1,0) = down).
 		glm::vec3 lightDir = glm::normalize(glm::vec3(primaryLight.position));
@@ -2581,20 +7045,31 @@ namespace Nightbloom
 
 		m_ShadowCenter = camPos;  // keep member meaningful for diagnostics
 
-		// --- Practical (PSSM) split distances over [camNear, shadowDist], view-space ---
+		// --- Practical (PSSM) split distances, view-space ---
+		// Over [camNear, shadowDist], or just the part of it that held geometry
+		// a few frames ago (ShadowDepthBounds) - no resolution on empty depth.
+		float splitNear = camNear;
+		float splitDist = shadowDist;
+		if (m_ShadowConfig.fitSplitsToDepth)
+			m_ShadowDepthBounds.Resolve(camNear, shadowDist, splitNear, splitDist);
+
 		float splitFar[NUM_CASCADES];
-		float ratio = shadowDist / camNear;
+		float ratio = splitDist / splitNear;
 		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
 		{
 			float p = static_cast<float>(c + 1) / static_cast<float>(NUM_CASCADES);
-			float logSplit = camNear * std::pow(ratio, p);
-			float uniSplit = camNear + (shadowDist - camNear) * p;
+			float logSplit = splitNear * std::pow(ratio, p);
+			float uniSplit = splitNear + (splitDist - splitNear) * p;
 			splitFar[c] = lambda * logSplit + (1.0f - lambda) * uniSplit;
 		}
 
+		// Slice bounding spheres first: the cascade cache decides from them which
+		// cascades refit this frame.
+		glm::vec3 sliceCenter[NUM_CASCADES];
+		float sliceRadius[NUM_CASCADES];
 		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
 		{
-			float sliceNear = (c == 0) ? camNear : splitFar[c - 1];
+			float sliceNear = (c == 0) ? splitNear : splitFar[c - 1];
 			float sliceFar  = splitFar[c];
 
 			// 8 world-space corners of this frustum slice.
@@ -2623,47 +7098,79 @@ namespace Nightbloom
 				radius = std::max(radius, glm::length(corners[i] - center));
 			radius = std::ceil(radius * 16.0f) / 16.0f;
 
-			// Light view aimed at the sphere centre, pulled back so off-frustum occluders
-			// toward the light still cast (casterExtrude = pancaking margin).
-			glm::vec3 eye = center - lightDir * (radius + extrude);
-			glm::mat4 lightView = glm::lookAt(eye, center, upRef);
-
-			float zFar = 2.0f * radius + extrude;
-			glm::mat4 lightProj = glm::ortho(-radius, radius, -radius, radius, 0.0f, zFar);
-			lightProj[1][1] *= -1.0f;                              // Vulkan Y-flip
-			lightProj[2][2] *= 0.5f;                               // GL [-1,1] -> VK [0,1] depth
-			lightProj[3][2] = lightProj[3][2] * 0.5f + 0.5f;
-
-			// Texel-snap in NDC: round the projected world origin to the shadow-map grid so
-			// the sampled texels don't crawl as the camera translates.
-			glm::mat4 shadowMatrix = lightProj * lightView;
-			glm::vec2 origin  = glm::vec2(shadowMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)) * (resolution * 0.5f);
-			glm::vec2 rounded = glm::round(origin);
-			glm::vec2 offset  = (rounded - origin) * (2.0f / resolution);
-			lightProj[3][0] += offset.x;
-			lightProj[3][1] += offset.y;
-
-			glm::mat4 lightVP = lightProj * lightView;
-
-			m_CurrentLightingData.shadowData.lightSpaceMatrix[c] = lightVP;
-			m_CurrentLightingData.shadowData.cascadeSplits[c] = sliceFar;  // view-depth split (shader selection)
-			m_CurrentLightingData.shadowData.cascadeRadii[c]  = radius;    // ortho half-size (shader bias scaling)
-
-			m_ShadowFrameData[c].view = lightView;
-			m_ShadowFrameData[c].proj = lightProj;
+			sliceCenter[c] = center;
+			sliceRadius[c] = radius;
+		}
+
+		m_ShadowRefitMask = m_ShadowCascadeCache.Update(m_ShadowConfig, lightDir, sliceCenter, sliceRadius);
+		m_StaticShadowDirtyMask |= m_ShadowRefitMask;
+		const uint32_t firstCached = ShadowCascadeCache::FirstCachedCascade(m_ShadowConfig);
+
+		for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+		{
+			// Splits always follow the current camera; a frozen cascade's padded
+			// sphere still covers its current slice (see ShadowCascadeCache)
+			m_CurrentLightingData.shadowData.cascadeSplits[c] = splitFar[c];  // view-depth split (shader selection)
 			m_ShadowFrameData[c].time = glm::vec4(m_TotalTime, 0.0f, 0.0f, 0.0f);
-			m_ShadowFrameData[c].cameraPos = glm::vec4(eye, 1.0f);
 
-			if (c == 0)
+			if (m_ShadowRefitMask & (1u << c))
 			{
-				// Base bias expressed in cascade 0's NDC depth range; the shader scales it per
-				// cascade by cascadeRadii ratio (coarser far cascades need proportionally more).
-				float ndcBias = (zFar > 0.0f) ? (bias / zFar) : bias;
-				m_CurrentLightingData.shadowData.shadowParams = glm::vec4(
-					ndcBias, normalBias, m_DebugCascadeTint ? 1.0f : 0.0f, 1.0f);
-				m_CurrentLightingData.shadowData.extraParams = glm::vec4(
-					m_ShadowConfig.cascadeBlend, 0.0f, 0.0f, 0.0f);
+				const glm::vec3 center = sliceCenter[c];
+				float radius = sliceRadius[c];
+				if (c >= firstCached)
+					radius = std::ceil(radius * (1.0f + m_ShadowConfig.cachePadding) * 16.0f) / 16.0f;
+
+				// Light view aimed at the sphere centre, pulled back so off-frustum occluders
+				// toward the light still cast (casterExtrude = pancaking margin).
+				glm::vec3 eye = center - lightDir * (radius + extrude);
+				glm::mat4 lightView = glm::lookAt(eye, center, upRef);
+
+				float zFar = 2.0f * radius + extrude;
+				glm::mat4 lightProj = glm::ortho(-radius, radius, -radius, radius, 0.0f, zFar);
+				lightProj[1][1] *= -1.0f;                              // Vulkan Y-flip
+				lightProj[2][2] *= 0.5f;                               // GL [-1,1] -> VK [0,1] depth
+				lightProj[3][2] = lightProj[3][2] * 0.5f + 0.5f;
+
+				// Texel-snap in NDC: round the projected world origin to the shadow-map grid so
+				// the sampled texels don't crawl as the camera translates. The grid is the
+				// cascade's own resolution; the squeeze into its corner of the layer comes after.
+				const uint32_t texels = ShadowCascadeTexels(layerTexels, m_ShadowConfig.cascadeResolutionScale[c]);
+				const float resolution = static_cast<float>(texels);
+				glm::mat4 shadowMatrix = lightProj * lightView;
+				glm::vec2 origin  = glm::vec2(shadowMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)) * (resolution * 0.5f);
+				glm::vec2 rounded = glm::round(origin);
+				glm::vec2 offset  = (rounded - origin) * (2.0f / resolution);
+				lightProj[3][0] += offset.x;
+				lightProj[3][1] += offset.y;
+				lightProj = ShadowCascadeViewport(texels, layerTexels) * lightProj;
+
+				m_CascadeLightVP[c] = lightProj * lightView;
+				m_CascadeFitRadius[c] = radius;
+				m_CascadeTexels[c] = texels;
+
+				m_ShadowFrameData[c].view = lightView;
+				m_ShadowFrameData[c].proj = lightProj;
+				m_ShadowFrameData[c].cameraPos = glm::vec4(eye, 1.0f);
+
+				if (c == 0)
+				{
+					// Base bias expressed in cascade 0's NDC depth range; the shader scales it per
+					// cascade by cascadeRadii ratio (coarser far cascades need proportionally more).
+					// Cascade 0 is never cached, so this is refreshed every frame.
+					float ndcBias = (zFar > 0.0f) ? (bias / zFar) : bias;
+					m_CurrentLightingData.shadowData.shadowParams = glm::vec4(
+						ndcBias, normalBias, m_DebugCascadeTint ? 1.0f : 0.0f, 1.0f);
+					m_CurrentLightingData.shadowData.extraParams = glm::vec4(
+						m_ShadowConfig.cascadeBlend, 0.0f, 0.0f, 0.0f);
+				}
 			}
+
+			m_CurrentLightingData.shadowData.lightSpaceMatrix[c] = m_CascadeLightVP[c];
+			// Ortho half-size over a whole layer, so the shader's bias scaling follows
+			// the texel size of cascades that use only part of theirs
+			const float layerFraction = m_CascadeTexels[c] > 0
+				? static_cast<float>(m_CascadeTexels[c]) / static_cast<float>(layerTexels) : 1.0f;
+			m_CurrentLightingData.shadowData.cascadeRadii[c] = m_CascadeFitRadius[c] / layerFraction;
 		}
 	}
 
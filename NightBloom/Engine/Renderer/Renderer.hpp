@@ -6,12 +6,35 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Core/CpuMemory.hpp"
+#include "Engine/Core/MetricsExporter.hpp"
+#include "Engine/Core/MainThreadTaskQueue.hpp"
 #include "Engine/Renderer/Vulkan/VulkanCommon.hpp"
 #include "Engine/Renderer/PipelineInterface.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
 #include "Engine/Renderer/Light.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/AuxiliaryView.hpp"
+#include "Engine/Renderer/FrameUploadLayout.hpp"
+#include "Engine/Renderer/Components/ShadowCascadeCache.hpp"
+#include "Engine/Renderer/Components/ReflectionSchedule.hpp"
+#include "Engine/Renderer/Components/ShadowDepthBounds.hpp"
+#include "Engine/Renderer/Components/ShadowCascadeResolution.hpp"
+#include "Engine/Renderer/Components/DynamicResolution.hpp"
+#include "Engine/Renderer/Atmosphere.hpp"
+#include "Engine/Renderer/EnvironmentProbe.hpp"
+#include "Engine/Renderer/ContactShadow.hpp"
+#include "Engine/Renderer/RayTracedShadow.hpp"
+#include "Engine/Renderer/SceneViewport.hpp"
+#include "Engine/Renderer/UIOverlayCache.hpp"
+#include "Engine/Renderer/LocalShadowAtlas.hpp"
+#include "Engine/VFX/Wind.hpp"
 #include <array>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <cstdint>
 
@@ -21,6 +44,7 @@ namespace Nightbloom
 	class RenderDevice;
 	class VulkanSwapchain;
 	class VulkanMemoryManager;
+	class VulkanFrameUploadBuffer;
 	class VulkanPipelineAdapter;
 	class Buffer;
 	class UniformBuffer;
@@ -34,15 +58,38 @@ namespace Nightbloom
 	class CommandRecorder;
 	class ResourceManager;
 	class VulkanDescriptorManager;
+	class AsyncAssetLoader;
+	class AssetHotReload;
 	class UIManager;
 	class ComputeDispatcher;
+	class AsyncComputeQueue;
+	class RenderGraph;
 	class NoiseTextureGenerator;
 	struct NoiseTextureDesc;
 	class ShadowMapManager;
 	class GpuProfiler;
 	class FireflySystem;
+	class ParticleSystem;
 	class CloudSystem;
+	class GrassSystem;
+	class OcclusionCuller;
+	class MeshletCuller;
+	class SkinningSystem;
+	class TemporalUpscaler;
+	class BloomMipChain;
+	class ComputePostProcess;
+	class ScreenSpaceReflections;
+	class LightClusterCuller;
+	class VariableRateShading;
+	class WindField;
+	class AtmosphereLuts;
+	class EnvironmentProbeCache;
+	class ContactShadows;
+	class RayTracedShadows;
+	class LocalShadowMaps;
 	class WaterSystem;
+	class TerrainSystem;
+	struct DrawStream;
 
 	//texture include?
 	class VulkanTexture;
@@ -62,12 +109,39 @@ namespace Nightbloom
 		void EndFrame();
 		void FinalizeFrame();  // Prepare and record commands
 
-		// Drawing interface
+		// Drawing interface. GetFrameDrawList() is the list recorded this frame;
+		// it lives in the per-frame arena and is reset in BeginFrame, so build
+		// into it directly to avoid the copy SubmitDrawList makes of other lists.
 		void SubmitDrawList(const DrawList& drawList);
+		DrawList& GetFrameDrawList() { return m_FrameDrawList; }
 		void SetViewMatrix(const glm::mat4& view) { m_ViewMatrix = view; }
 		void SetProjectionMatrix(const glm::mat4& proj) { m_ProjectionMatrix = proj; }
+		// The camera as set (unjittered; see SetTemporalUpscaling)
+		const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
+		const glm::mat4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
 		void SetCameraPosition(const glm::vec3& pos) { m_CameraPosition = pos; }
-		void SetLightingData(const SceneLightingData& data) { m_CurrentLightingData = data; }
+		glm::vec3 GetCameraPosition() const { return m_CameraPosition; }
+		// Also takes the data's point lights as the clustered ones; follow with
+		// SetPointLights for more than fit in SceneLightingData. Uploaded to
+		// each frame's buffer only when it changes.
+		void SetLightingData(const SceneLightingData& data);
+		// Every enabled point light (Scene::BuildPointLights), not capped at
+		// MAX_LIGHTS; shaded through the light clusters when they're active.
+		// Copied (and re-uploaded) only when it differs from the last call.
+		void SetPointLights(const std::vector<LightData>& lights);
+
+		// Draw streams (DrawStream.hpp). A requested capture is taken from the
+		// next frame's list and uniforms, in FinalizeFrame, and written to path.
+		void RequestDrawStreamCapture(const std::string& path) { m_DrawStreamCapturePath = path; }
+		bool IsDrawStreamCapturePending() const { return !m_DrawStreamCapturePath.empty(); }
+		// Pins every frame to a captured one: the camera, time, sun and
+		// lighting the app set are replaced by the stream's, and the shadow
+		// cascades by the matrices it uploaded. Null unpins. The stream must
+		// outlive the pin.
+		void SetDrawStreamReplay(const DrawStream* stream);
+		// Appends the stream's draws, resolving their names against the
+		// loaded resources; returns how many were dropped as unresolved
+		uint32_t BuildDrawStreamList(const DrawStream& stream, DrawList& drawList);
 
 		// Clear screen (for when draw list is empty)
 		void Clear(float r = 0.0f, float g = 0.0f, float b = 0.0f, float a = 1.0f);
@@ -76,14 +150,17 @@ namespace Nightbloom
 		Buffer* GetTestVertexBuffer() const;
 		Buffer* GetTestIndexBuffer() const;
 		uint32_t GetTestIndexCount() const;
+		glm::vec3 GetTestCubeExtents() const;
 
 		Buffer* GetGroundPlaneVertexBuffer() const;
 		Buffer* GetGroundPlaneIndexBuffer() const;
 		uint32_t GetGroundPlaneIndexCount() const;
+		glm::vec3 GetGroundPlaneExtents() const;
 
 		Buffer* GetMoonSphereVertexBuffer() const;
 		Buffer* GetMoonSphereIndexBuffer() const;
 		uint32_t GetMoonSphereIndexCount() const;
+		glm::vec3 GetMoonSphereExtents() const;
 
 		void TestShaderClass();
 
@@ -93,42 +170,157 @@ namespace Nightbloom
 		// Noise access
 		VulkanTexture* GetNoisePreview() const { return m_NoisePreview; }
 		bool RegenerateNoisePreview(const NoiseTextureDesc& desc);
+		void ReleaseNoisePreview(); // once nothing displays it
 		NoiseTextureGenerator* GetNoiseGenerator() const { return m_NoiseGenerator.get(); }
 		ComputeDispatcher* GetComputeDispatcher() const { return m_ComputeDispatcher.get(); }
 
+		// Firefly simulation, the cloud raymarches and noise generation run on
+		// the device's async compute queue (see AsyncComputeQueue.hpp), so they
+		// overlap the shadow pass. Decided at initialization; false when the
+		// device has no separate compute family or timeline semaphores.
+		bool IsAsyncComputeEnabled() const;
+
 		bool LoadShaders();
 
 		// System access
 		RenderDevice* GetDevice() const { return m_Device.get(); }
 		VkDevice GetVkDevice() const; // raw Vulkan device handle, for systems building their own pipelines (e.g. FireflySystem)
+		VkPipelineCache GetPipelineCache() const; // shared cache those pipelines should be created with
 		VulkanMemoryManager* GetMemoryManager() const { return m_MemoryManager.get(); } // for systems constructing their own VulkanTexture directly (e.g. CloudSystem's resizable result image)
+		VulkanFrameUploadBuffer* GetFrameUploads() const { return m_FrameUploads.get(); } // per-frame uniform slots and transient upload space
 		IPipelineManager* GetPipelineManager() const { return (IPipelineManager*)(m_PipelineAdapter.get()); };
 		ResourceManager* GetResourceManager() const { return m_Resources.get(); }
+		// Background model/texture loads; finished ones are created in BeginFrame
+		AsyncAssetLoader* GetAssetLoader() const { return m_AssetLoader.get(); }
+		// Main-thread work that can wait a frame (descriptor updates, resource
+		// swaps, UI texture registration); the Application runs it at the end
+		// of each frame within what's left of the frame time
+		MainThreadTaskQueue& GetMainThreadTasks() { return m_MainThreadTasks; }
 		VulkanDescriptorManager* GetDescriptorManager() { return m_DescriptorManager.get(); }
 		uint32_t GetWidth() const { return m_Width; }
 		uint32_t GetHeight() const { return m_Height; }
 
+		// The part of the window the scene is shown in (see SceneViewport.hpp;
+		// window pixels, empty = all of it). The scene-sized targets follow
+		// it at resolutionScale once it settles, rebuilt at a frame boundary
+		// after the frames in flight finish - no device idle. Post-process
+		// draws into GetSceneViewportRect and leaves the rest of the window
+		// cleared for the UI.
+		void SetSceneViewportRegion(const SceneViewportRect& region) { m_SceneViewport.SetRegion(region); }
+		const SceneViewportRect& GetSceneViewportRect() const { return m_SceneViewport.GetRect(); }
+		void SetSceneViewportSettings(const SceneViewportSettings& settings) { m_SceneViewport.SetSettings(settings); }
+		const SceneViewportSettings& GetSceneViewportSettings() const { return m_SceneViewport.GetSettings(); }
+		// Size of the scene targets (the window's without a region)
+		VkExtent2D GetSceneExtent() const;
+
 		// FireflySystem dispatches its compute simulation here every frame,
-		// before the main render pass, via RecordComputePass(). Not owned —
+		// before the main render pass (a compute pass of the frame's render
+		// graph, see RecordCommandBuffer). Not owned —
 		// caller (e.g. FireflyPanel) manages its lifetime.
 		void SetFireflySystem(FireflySystem* system) { m_FireflySystem = system; }
 
+		// ParticleSystem simulates its emitters here every frame, a compute
+		// pass of the frame's render graph on the graphics queue. Not owned —
+		// caller (ParticlePanel) manages its lifetime.
+		void SetParticleSystem(ParticleSystem* system) { m_ParticleSystem = system; }
+
 		// CloudSystem's per-frame params UBO is updated here every frame
 		// (BeginFrame already knows the current frame index and delta time
 		// for the other per-frame UBOs). Not owned — caller (CloudPanel)
-		// manages its lifetime.
-		void SetCloudSystem(CloudSystem* system) { m_CloudSystem = system; }
+		// manages its lifetime. Its shadow map is bound at set 0 binding 5.
+		void SetCloudSystem(CloudSystem* system) { m_CloudSystem = system; m_CloudShadowBound.fill(VK_NULL_HANDLE); }
+		CloudSystem* GetCloudSystem() const { return m_CloudSystem; }
 
 		// WaterSystem registers here so the reflection pass can mirror the camera
 		// across the water plane's Y and re-render the scene into the reflection
 		// target each frame. Setting null disables the reflection pass. Not owned
 		// — caller (WaterEditorPanel) manages its lifetime.
-		void SetWaterSystem(WaterSystem* system) { m_WaterSystem = system; }
+		void SetWaterSystem(WaterSystem* system) { m_WaterSystem = system; m_ReflectionSchedule.Invalidate(); }
+
+		// GrassSystem's GPU cull pass is dispatched ahead of the scene pass
+		// (RecordCommandBuffer) so its indirect draws are ready for it. Not owned —
+		// caller (GrassPanel) manages its lifetime.
+		void SetGrassSystem(GrassSystem* system) { m_GrassSystem = system; }
+
+		// Streamed terrain tiles are generated (and heightmaps copied back for
+		// CPU height queries) by the frame's first compute pass, ahead of every
+		// pass that samples the heightmap. Not owned — caller
+		// (TerrainPanel) manages its lifetime.
+		void SetTerrainSystem(TerrainSystem* system) { m_TerrainSystem = system; m_TerrainShadowBound.fill(VK_NULL_HANDLE); }
+
+		// Hi-Z occlusion (null if compute or the depth buffer is unavailable).
+		// Other cull passes bind its pyramid; see OcclusionCuller.hpp.
+		OcclusionCuller* GetOcclusionCuller() const { return m_OcclusionCuller.get(); }
+
+		// Per-meshlet culling of dense meshes (null without Hi-Z or
+		// drawIndirectCount); see MeshletCuller.hpp.
+		MeshletCuller* GetMeshletCuller() const { return m_MeshletCuller.get(); }
+
+		// Compute skinning of animated models (null without compute: they
+		// draw in their bind pose); see SkinningSystem.hpp.
+		SkinningSystem* GetSkinningSystem() const { return m_SkinningSystem.get(); }
+
+		// Frame-in-flight slot being built (valid between BeginFrame and EndFrame)
+		uint32_t GetCurrentFrameIndex() const;
+
+		// How many frames the CPU may record ahead of the GPU, 1 to
+		// MAX_FRAMES_IN_FLIGHT (see FrameConfig.hpp). A change made while
+		// running takes effect at the start of the next BeginFrame, after a
+		// device wait; frame indices then restart at 0.
+		void SetFramesInFlight(uint32_t count);
+		uint32_t GetFramesInFlight() const;
+
+		// Swapchain present mode: FIFO (V-Sync), FIFO_RELAXED, MAILBOX or
+		// IMMEDIATE; unsupported modes fall back (see VulkanSwapchain). Applied
+		// at the next BeginFrame by recreating only the swapchain and the
+		// framebuffers over its images, without a device wait.
+		void SetPresentMode(VkPresentModeKHR mode);
+		VkPresentModeKHR GetPresentMode() const;
+		const std::vector<VkPresentModeKHR>& GetSupportedPresentModes() const;
+
+		// Fixed timestep: when > 0, every frame advances the shader time (and
+		// what clouds/fireflies simulate) by exactly this many seconds instead
+		// of the wall-clock delta, so a replay renders the same frames
+		void SetFixedTimestep(float seconds) { m_FixedTimestep = seconds; }
+		float GetFixedTimestep() const { return m_FixedTimestep; }
+
+		// Low-latency mode (see FrameSyncManager::LowLatencyWait). The app
+		// calls WaitForLowLatencyStart() right before sampling input, a no-op
+		// while the mode is off. SetFrameInputTime passes the earliest input
+		// the next recorded frame consumed, for the input-to-present metric.
+		void SetLowLatencyMode(bool enabled);
+		bool IsLowLatencyMode() const;
+		void WaitForLowLatencyStart();
+		void SetFrameInputTime(std::chrono::steady_clock::time_point time);
+		bool SupportsPresentWait() const;
+
+		// Dynamic resolution (see DynamicResolution.hpp). The scene and
+		// reflection passes draw into the top-left GetRenderExtent() rect of
+		// their full-size targets and post-process upscales it, so a scale
+		// change costs nothing; the Hi-Z pyramid follows the same rect.
+		void SetDynamicResolution(const DynamicResolutionSettings& settings);
+		const DynamicResolutionSettings& GetDynamicResolution() const { return m_DynamicResolution.GetSettings(); }
+		float GetRenderScale() const { return m_DynamicResolution.GetScale(); }
+		VkExtent2D GetRenderExtent() const { return m_RenderExtent; }
+
+		// Temporal upscaling (see TemporalUpscaler.hpp): jittered scene,
+		// display-resolution reconstruction before post-process; replaces
+		// FXAA while on. Reset the history on camera cuts.
+		void SetTemporalUpscaling(bool enabled);
+		bool IsTemporalUpscaling() const;
+		bool SupportsTemporalUpscaling() const { return m_TemporalUpscaler != nullptr; }
+		void ResetTemporalHistory();
 
 		// Pipeline operations (temporary - for testing)
 		void TogglePipeline();
 		void ReloadShaders();
 
+		// Reloads textures, models and shaders as their files change
+		// (AssetHotReload.hpp), at the frame boundary. Off by default - the
+		// editor turns it on. False if watching couldn't start.
+		bool SetAssetHotReload(bool enabled);
+		AssetHotReload* GetAssetHotReload() const { return m_HotReload.get(); }
+
 		// Shadow controls
 		bool IsShadowEnabled() const { return m_ShadowEnabled; }
 		// Post-process / tone-mapping controls. The scene renders into a linear HDR target;
@@ -142,6 +334,7 @@ namespace Nightbloom
 			float vignetteStrength = 0.25f;  // 0 = off
 			float bloomIntensity   = 0.8f;   // additive bloom strength (0 = off)
 			float bloomThreshold   = 0.8f;   // luma above this blooms (lower = more of the scene glows)
+			bool  computePost      = false;  // one compute dispatch instead of the full-screen draw (SupportsComputePostProcess)
 		};
 		PostProcessSettings& GetPostProcessSettings() { return m_PostProcessSettings; }
 		const PostProcessSettings& GetPostProcessSettings() const { return m_PostProcessSettings; }
@@ -149,22 +342,224 @@ namespace Nightbloom
 		// Back-compat wrappers for the existing AA toggle.
 		bool IsPostProcessAAEnabled() const { return m_PostProcessSettings.aaEnabled; }
 		void SetPostProcessAAEnabled(bool enabled) { m_PostProcessSettings.aaEnabled = enabled; }
-		void SetShadowEnabled(bool enabled) { m_ShadowEnabled = enabled; }
+		// Compute post pass (see ComputePostProcess.hpp); needs compute support
+		bool SupportsComputePostProcess() const { return m_ComputePost != nullptr; }
+
+		// Screen-space water reflections (see ScreenSpaceReflections.hpp),
+		// picked per frame by WaterDesc::reflectionMode; needs compute and
+		// the Hi-Z pyramid
+		bool SupportsScreenSpaceReflections() const { return m_SSR != nullptr; }
+
+		// Secondary cameras drawn from this frame's draw list into their own
+		// targets (see AuxiliaryView.hpp), sharing its shadow maps, sky and
+		// wind. Call after the list's auxViewMask bits are filled and before
+		// FinalizeFrame; count 0 turns them off. Needs a single-sample
+		// reflection pass, whose render pass they reuse.
+		void SetAuxiliaryViews(const AuxiliaryView* views, uint32_t count);
+		uint32_t GetAuxiliaryViewCount() const { return m_AuxiliaryViewCount; }
+		bool SupportsAuxiliaryViews() const;
+		// View's color target (linear HDR, shader-read-only once drawn); the
+		// handle changes when the view is resized
+		VkImageView GetAuxiliaryViewImageView(uint32_t view) const;
+		VkSampler GetAuxiliaryViewSampler() const;
+		// The largest target a view can have (the reflection target's
+		// extent), the size view's target has, and the targets' texel format
+		VkExtent2D GetAuxiliaryViewMaxExtent() const;
+		VkExtent2D GetAuxiliaryViewExtent(uint32_t view) const;
+		VkFormat GetAuxiliaryViewFormat() const;
+		// Copies view's target into buffer (tightly packed rows, at least
+		// width x height texels) right after it is drawn. This frame only;
+		// SetAuxiliaryViews drops earlier requests. The texels are there once
+		// this frame slot comes round again - the next BeginFrame with the
+		// same GetCurrentFrameIndex() has waited for them (OffscreenCapture).
+		void RequestAuxiliaryViewReadback(uint32_t view, VkBuffer buffer);
+
+		// Clustered point lights (see LightClusterCuller.hpp); off or
+		// unsupported, the lit passes loop over SceneLighting's point lights
+		struct ClusteredLightingSettings
+		{
+			bool  enabled          = true;
+			bool  fireflyLights    = true;    // every firefly agent lights its surroundings
+			float fireflyRadius    = 4.0f;    // world units, at full brightness
+			float fireflyIntensity = 1.5f;
+			float farDistance      = 500.0f;  // view depth the cluster slices span
+		};
+		ClusteredLightingSettings& GetClusteredLightingSettings() { return m_ClusteredLighting; }
+		const ClusteredLightingSettings& GetClusteredLightingSettings() const { return m_ClusteredLighting; }
+		bool SupportsClusteredLighting() const;
+		LightClusterCuller* GetLightClusterCuller() const { return m_LightClusters.get(); }
+
+		// Coarse shading of terrain, grass and the cloud composite (see
+		// VariableRateShading.hpp); needs VK_KHR_fragment_shading_rate
+		struct VariableRateShadingSettings
+		{
+			bool  enabled           = true;
+			float coarseDistance    = 120.0f;  // view distance beyond which tiles shade 2x2
+			float vignetteDarkening = 0.3f;    // tiles the vignette darkens at least this much shade 2x2
+		};
+		VariableRateShadingSettings& GetVariableRateShadingSettings() { return m_VariableRateShadingSettings; }
+		const VariableRateShadingSettings& GetVariableRateShadingSettings() const { return m_VariableRateShadingSettings; }
+		bool SupportsVariableRateShading() const { return m_VariableRateShading != nullptr; }
+
+		// The scene's wind (see Wind.hpp): baked around the camera each frame
+		// for grass and the water ripples, evaluated on the CPU for the fireflies
+		WindSettings& GetWindSettings() { return m_WindSettings; }
+		const WindSettings& GetWindSettings() const { return m_WindSettings; }
+
+		// The sky (see Atmosphere.hpp): LUTs rebuilt when the sun moves past
+		// updateThresholdDeg, looked up by the sky draw, the water's
+		// reflection of it and the terrain's aerial perspective
+		AtmosphereSettings& GetAtmosphereSettings() { return m_AtmosphereSettings; }
+		const AtmosphereSettings& GetAtmosphereSettings() const { return m_AtmosphereSettings; }
+		// Toward the sun; zero follows lights[0] (a day/night cycle that lights
+		// the scene with the moon at night passes the real sun here)
+		void SetSunDirection(const glm::vec3& towardSun) { m_SunDirection = towardSun; }
+		// The far field's reflection (see EnvironmentProbe.hpp): recaptured
+		// every updateInterval frames or when the sun or the light turns,
+		// sampled by the meshes and the screen-space reflection's misses
+		EnvironmentProbeSettings& GetEnvironmentProbeSettings() { return m_EnvironmentProbeSettings; }
+		const EnvironmentProbeSettings& GetEnvironmentProbeSettings() const { return m_EnvironmentProbeSettings; }
+		// Frames since the probe was last captured
+		uint32_t GetEnvironmentProbeAge() const;
+		// Short-range shadows from lights[0] (see ContactShadow.hpp), marched
+		// through the depth buffer after the scene pass; grass and small
+		// props shadow themselves and the ground without the cascades.
+		// Needs compute and a scene color compute can write
+		// (SupportsContactShadows).
+		ContactShadowSettings& GetContactShadowSettings() { return m_ContactShadowSettings; }
+		const ContactShadowSettings& GetContactShadowSettings() const { return m_ContactShadowSettings; }
+		bool SupportsContactShadows() const { return m_ContactShadows != nullptr; }
+		// Sun shadows traced with ray queries instead of the cascades (see
+		// RayTracedShadow.hpp). Needs SupportsFeature("ray_query")
+		// (SupportsRayTracedShadows); until the lit pipelines' ray-query
+		// builds are bound the cascades stay on (IsRayTracedShadowActive).
+		RayTracedShadowSettings& GetRayTracedShadowSettings() { return m_RayTracedShadowSettings; }
+		const RayTracedShadowSettings& GetRayTracedShadowSettings() const { return m_RayTracedShadowSettings; }
+		bool SupportsRayTracedShadows() const { return m_RayTracedShadows != nullptr; }
+		bool IsRayTracedShadowActive() const;
+		// Instances in the last TLAS built, and BLASes kept; 0 while inactive
+		void GetRayTracedShadowStats(uint32_t& instances, uint32_t& blases) const;
+		// Point light shadows (see LocalShadowAtlas.hpp) for the lights whose
+		// ShadowConfig::castsShadows is set, tiles sized by their size on
+		// screen; a light redraws only when a caster in its radius changes.
+		LocalShadowSettings& GetLocalShadowSettings() { return m_LocalShadowSettings; }
+		const LocalShadowSettings& GetLocalShadowSettings() const { return m_LocalShadowSettings; }
+		bool SupportsLocalShadows() const { return m_LocalShadows && m_LocalShadowPipelinesReady; }
+		// Lights holding tiles, and the faces the last frame redrew
+		void GetLocalShadowStats(uint32_t& lights, uint32_t& renderedFaces) const;
+		// The full-screen sky, drawn first in the scene and reflection passes.
+		// Call while building the frame's draw list, like the VFX systems'.
+		void SubmitSkyDraw(DrawList& drawList) const;
+		void SetShadowEnabled(bool enabled)
+		{
+			if (enabled != m_ShadowEnabled) InvalidateShadowCache();
+			m_ShadowEnabled = enabled;
+		}
 		void SetShadowCenter(const glm::vec3& center) { m_ShadowCenter = center; }
-		void SetShadowConfig(const ShadowConfig& config) { m_ShadowConfig = config; }
+		// The editor re-applies the light's config every frame; only a real change drops the cache
+		void SetShadowConfig(const ShadowConfig& config)
+		{
+			if (!(config == m_ShadowConfig))
+				InvalidateShadowCache();
+			m_ShadowConfig = config;
+		}
+		// Far cascades cache their static (terrain) depth between refits; call when
+		// static geometry changes in place (TerrainSystem::Regenerate does).
+		void InvalidateShadowCache();
+		// A local in-place edit (terrain sculpting): re-renders the static layer of
+		// only the cached cascades that can see the world box, keeping their fit.
+		void InvalidateShadowRegion(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
 		const ShadowConfig& GetShadowConfig() const { return m_ShadowConfig; }
 		// Debug: tint surfaces by which shadow cascade they sample (CSM diagnostic).
 		void SetDebugCascadeTint(bool enabled) { m_DebugCascadeTint = enabled; }
 		bool GetDebugCascadeTint() const { return m_DebugCascadeTint; }
+		// 3x3 PCF shadow filtering; off samples one compare tap. Switches the
+		// lit pipelines to another specialization-constant variant.
+		void SetShadowPcf(bool enabled) { m_ShadowPcf = enabled; }
+		bool GetShadowPcf() const { return m_ShadowPcf; }
+		// fp16 arithmetic in the fragment shaders that have an fp16 build
+		// (grass, post-process composite); needs shaderFloat16. Switches those
+		// pipelines to their HalfPrecision variants.
+		void SetHalfPrecisionShading(bool enabled) { m_HalfPrecisionShading = enabled; }
+		bool GetHalfPrecisionShading() const { return m_HalfPrecisionShading; }
+		bool IsHalfPrecisionSupported() const;
+
+		// Record the scene, shadow and reflection passes into secondary command
+		// buffers on worker threads (on by default when more than one core exists).
+		void SetParallelRecording(bool enabled);
+		bool IsParallelRecording() const;
+
+		// UI overlay (UIOverlayCache.hpp). Cached, the UI is drawn into a
+		// texture only on the frames it is rebuilt and laid over every frame.
+		// The app builds its UI only when IsUIFrame(): no ImGui frame is open
+		// on the others. RequestUIRefresh rebuilds it next frame.
+		void SetUIOverlaySettings(const UIOverlaySettings& settings);
+		UIOverlaySettings GetUIOverlaySettings() const;
+		bool IsUIFrame() const;
+		void RequestUIRefresh();
+		uint32_t GetUIReusedFrames() const;
+
+		// Static command caching: the terrain's shadow draws are replayed from
+		// secondary command buffers kept across frames, re-recorded only when
+		// what they draw or bind changes (CommandRecorder::GetCachedSecondary).
+		void SetStaticCommandCaching(bool enabled) { m_StaticCommandCaching = enabled; }
+		bool IsStaticCommandCaching() const { return m_StaticCommandCaching; }
+		// Cached secondaries replayed / re-recorded this frame
+		void GetCachedSecondaryStats(uint32_t& reused, uint32_t& recorded) const;
+
+		// Depth prepass: the camera-visible Mesh/Terrain/Foliage draws lay
+		// down depth first, front to back, with depth-only pipelines, and
+		// the color pass then shades them with an EQUAL depth test - a pixel
+		// covered by many grass blades is shaded once. Pays off when the
+		// scene is fragment bound; off by default. Unsupported if any of the
+		// depth or EQUAL pipeline twins failed to build.
+		void SetDepthPrepass(bool enabled) { m_DepthPrepass = enabled && m_DepthPrepassSupported; }
+		bool IsDepthPrepass() const { return m_DepthPrepass; }
+		bool SupportsDepthPrepass() const { return m_DepthPrepassSupported; }
+
+		// Weighted-blended order-independent transparency: glass, water and
+		// fireflies leave the scene pass for their own pass after it, which
+		// accumulates them unsorted and composites the result over the scene
+		// color before bloom/TAA/post. Off by default. Unsupported without
+		// the OIT render pass, the composite or any of the OIT twins.
+		void SetOrderIndependentTransparency(bool enabled) { m_OrderIndependentTransparency = enabled && m_OitSupported; }
+		bool IsOrderIndependentTransparency() const { return m_OrderIndependentTransparency; }
+		bool SupportsOrderIndependentTransparency() const { return m_OitSupported; }
+
+		// Tessellated terrain (TerrainDesc::tessellation): the
+		// TerrainTessellated pipeline, and its depth prepass twins when the
+		// prepass is supported. Unsupported without the device's tessellation
+		// shaders or if any of them failed to build.
+		bool SupportsTerrainTessellation() const { return m_TerrainTessellationSupported; }
+
+		// Mesh/Transparent instances written to the instance buffer last frame,
+		// and the draw calls they were batched into.
+		uint32_t GetInstanceCount() const { return m_LastInstanceCount; }
+		// Instances last frame left undrawn for want of a slot: zero unless
+		// the instance buffer failed to grow to the frame's need.
+		uint32_t GetDroppedInstanceCount() const { return m_LastDroppedInstances; }
+		size_t GetBatchedDrawCount() const { return m_FrameDrawList.GetCommandCount(); }
 
 		// Per-pass GPU timings (timestamp queries). May be null if unsupported.
 		GpuProfiler* GetGpuProfiler() const { return m_GpuProfiler.get(); }
 
+		// Runtime metrics export (MetricsExporter.hpp): fed every frame while
+		// running. Started at initialization from NIGHTBLOOM_METRICS_*, or by
+		// the app; stopped at shutdown.
+		MetricsExporter& GetMetricsExporter() { return m_MetricsExporter; }
+
 		// Shadow map resolution (per cascade layer). Resizes the array texture + repoints
 		// the bound descriptor sets. Waits for GPU idle internally — call outside a frame.
 		void     SetShadowResolution(uint32_t resolution);
 		uint32_t GetShadowResolution() const;
 
+		// Compacts GPU memory (device-local vertex and index buffers) over the
+		// next frames, one bounded pass at the start of each. Every pass waits
+		// for the GPU to go idle, so it's for the editor's idle moments, not
+		// gameplay.
+		void RequestGpuDefragmentation() { m_GpuDefragRequested = true; }
+		bool IsGpuDefragmenting() const;
+
 		// Status
 		bool IsInitialized() const { return m_Initialized; }
 		bool IsFrameValid() const { return m_FrameValid; }
@@ -183,45 +578,158 @@ namespace Nightbloom
 		std::unique_ptr<VulkanSwapchain> m_Swapchain;
 		std::unique_ptr<VulkanMemoryManager> m_MemoryManager;
 		std::unique_ptr<VulkanPipelineAdapter> m_PipelineAdapter;
+		// Every per-frame uniform below lives in here, one region per frame
+		// in flight, flushed once at the end of BeginFrame
+		std::unique_ptr<VulkanFrameUploadBuffer> m_FrameUploads;
 
 		// Component managers (owned by Renderer)
 		std::unique_ptr<FrameSyncManager> m_FrameSync;
 		std::unique_ptr<RenderPassManager> m_RenderPasses;
 		std::unique_ptr<CommandRecorder> m_Commands;
 		std::unique_ptr<ResourceManager> m_Resources;
+		std::unique_ptr<AsyncAssetLoader> m_AssetLoader;
+		std::unique_ptr<AssetHotReload> m_HotReload;    // null while off
+		MainThreadTaskQueue m_MainThreadTasks;
 		std::unique_ptr<VulkanDescriptorManager> m_DescriptorManager;
 		std::unique_ptr<UIManager> m_UI;
 		std::unique_ptr<ComputeDispatcher> m_ComputeDispatcher;
+		std::unique_ptr<AsyncComputeQueue> m_AsyncCompute;
+		std::unique_ptr<RenderGraph> m_RenderGraph;   // rebuilt every RecordCommandBuffer
+		bool m_TransientAliasingBroken = false;      // logged once
+		// Which frames re-render the planar reflection and the lookup the
+		// water reprojects it with (WaterDesc::reflectionInterval)
+		ReflectionSchedule m_ReflectionSchedule;
+		bool m_ReflectionDue = true;   // this frame renders the reflection
 		std::unique_ptr<NoiseTextureGenerator> m_NoiseGenerator;
 		std::unique_ptr<ShadowMapManager> m_ShadowManager;
 		std::unique_ptr<GpuProfiler> m_GpuProfiler;
-
-		// Frame state
-		DrawList m_FrameDrawList;
+		std::unique_ptr<OcclusionCuller> m_OcclusionCuller;
+		std::unique_ptr<MeshletCuller> m_MeshletCuller;      // null without Hi-Z or drawIndirectCount
+		std::unique_ptr<SkinningSystem> m_SkinningSystem;    // null without compute
+		std::unique_ptr<TemporalUpscaler> m_TemporalUpscaler;
+		std::unique_ptr<BloomMipChain> m_BloomChain;   // null without compute: no bloom
+		std::unique_ptr<ComputePostProcess> m_ComputePost;   // null without compute
+		std::unique_ptr<ScreenSpaceReflections> m_SSR;       // null without compute or Hi-Z
+		std::unique_ptr<LightClusterCuller> m_LightClusters;
+		ClusteredLightingSettings m_ClusteredLighting;
+		std::unique_ptr<VariableRateShading> m_VariableRateShading;  // null without fragment shading rate
+		VariableRateShadingSettings m_VariableRateShadingSettings;
+		std::unique_ptr<WindField> m_WindField;
+		WindSettings m_WindSettings;
+		std::unique_ptr<AtmosphereLuts> m_AtmosphereLuts;
+		AtmosphereSettings m_AtmosphereSettings;
+		glm::vec3 m_SunDirection = glm::vec3(0.0f);
+		std::unique_ptr<EnvironmentProbeCache> m_EnvironmentProbe;
+		EnvironmentProbeSettings m_EnvironmentProbeSettings;
+		std::unique_ptr<ContactShadows> m_ContactShadows;   // null without compute or a storage scene color
+		ContactShadowSettings m_ContactShadowSettings;
+		std::unique_ptr<RayTracedShadows> m_RayTracedShadows;   // null without ray queries
+		RayTracedShadowSettings m_RayTracedShadowSettings;
+		bool m_RayTracedShadowActive = false;   // this frame's, set in BeginFrame
+		std::unique_ptr<LocalShadowMaps> m_LocalShadows;
+		LocalShadowSettings m_LocalShadowSettings;
+		bool m_LocalShadowPipelinesReady = false;   // LocalShadow pipelines exist
+
+		// Frame state. The arena backs m_FrameDrawList's storage and is reset
+		// each BeginFrame (recording for the previous frame is done by then).
+		// Its blocks are counted as CpuMemoryCategory::DrawList.
+		LinearAllocator m_FrameArena{ 1024 * 1024, &CpuMemory::GetResource(CpuMemoryCategory::DrawList) };
+		DrawList m_FrameDrawList{ &m_FrameArena };
 		glm::mat4 m_ViewMatrix = glm::mat4(1.0f);
 		glm::mat4 m_ProjectionMatrix = glm::mat4(1.0f);
 		glm::vec3 m_CameraPosition = glm::vec3(0.0f);
 		uint32_t m_CurrentImageIndex = 0;
 		glm::vec4 m_ClearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
-		// Camera uniform buffers (set 0 in main pass)
-		std::array<VulkanBuffer*, 2> m_FrameUniforms{};  // 2 = MAX_FRAMES_IN_FLIGHT
+		// Camera uniforms (set 0 in main pass)
+		FrameUploadSlot m_FrameUniformSlot;
 		FrameUniformData m_CurrentFrameData;
 
-		// Lighting uniform buffers (set 2)
-		std::array<VulkanBuffer*, 2> m_LightingUniforms{};
+		// Lighting uniforms (set 2)
+		FrameUploadSlot m_LightingUniformSlot;
 		SceneLightingData m_CurrentLightingData;
-
-		// Shadow uniform buffers (set 0 in shadow pass - light's view/proj).
-		// Per frame in flight, per cascade: [frame][cascade].
-		std::array<std::array<VulkanBuffer*, NUM_CASCADES>, 2> m_ShadowUniforms{};
+		// What each frame's lighting slot holds, to skip unchanged uploads
+		std::array<SceneLightingData, MAX_FRAMES_IN_FLIGHT> m_UploadedLighting{};
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_LightingUploaded{};
+		std::vector<LightData> m_PointLights;   // clustered point lights (SetPointLights)
+		uint64_t m_PointLightsVersion = 1;      // bumped when m_PointLights changes
+		std::vector<LightData> m_LightingPointScratch;   // SetLightingData's point lights
+		// What the shaders get: shadowed point lights carry their atlas slot
+		// in position.w (LocalShadowMaps::AssignLights)
+		SceneLightingData m_ShadedLightingData;
+		std::vector<LightData> m_ShadedPointLights;
+		uint64_t m_ShadedPointLightsVersion = 1;
+		std::vector<LightData> m_ShadedPointScratch;
+		FrameUploadSlot m_LocalShadowUniformSlot;
+
+		// Shadow uniforms (set 0 in shadow pass - light's view/proj), per cascade
+		std::array<FrameUploadSlot, NUM_CASCADES> m_ShadowUniformSlots{};
 		std::array<FrameUniformData, NUM_CASCADES> m_ShadowFrameData{};
-
-		// Reflection uniform buffers (set 0 in the planar-reflection pass - the
-		// mirror-flipped camera's view/proj). Same double-buffered pattern as the
-		// shadow UBO above.
-		std::array<VulkanBuffer*, 2> m_ReflectionUniforms{};
+		// Layered path: every cascade's light VP in one UBO
+		FrameUploadSlot m_ShadowLayeredUniformSlot;
+		bool m_LayeredShadowsSupported = false;  // ShadowLayered pipelines exist
+
+		// Cascade caching: which cascades refit this frame, the matrices frozen
+		// cascades keep, and which static-cache layers need re-rendering.
+		ShadowCascadeCache m_ShadowCascadeCache;
+		uint32_t m_ShadowRefitMask = ~0u;
+		uint32_t m_StaticShadowDirtyMask = ~0u;
+		uint64_t m_StaticCasterSignature = 0;
+		// Cached static shadow secondaries (SetStaticCommandCaching), by
+		// CommandRecorder cache id: one per cascade, then the layered pass
+		bool m_StaticCommandCaching = true;
+		static constexpr uint32_t CACHED_SHADOW_CASCADE_ID = 0;  // + cascade
+		static constexpr uint32_t CACHED_SHADOW_LAYERED_ID = NUM_CASCADES;
+		// Visible depth range the splits follow (ShadowConfig::fitSplitsToDepth),
+		// read back from the Hi-Z pass
+		ShadowDepthBounds m_ShadowDepthBounds;
+		// The terrain's sun shadow map stands in for it past ShadowConfig::terrainCascades
+		bool m_TerrainSunShadowActive = false;
+		std::array<glm::mat4, NUM_CASCADES> m_CascadeLightVP{};
+		std::array<float, NUM_CASCADES> m_CascadeFitRadius{};
+		// Texels per side each cascade was fitted at (its layer's top-left corner)
+		std::array<uint32_t, NUM_CASCADES> m_CascadeTexels{};
+		// Per sorted draw: bit c set if the draw's bounds reach cascade c's caster
+		// volume. Rebuilt at the start of RecordShadowPass, read by the workers.
+		std::vector<uint8_t> m_ShadowCasterCascades;
+		AABBBatch m_ShadowCullBounds;               // CullShadowCasters scratch: bounded draws
+		std::vector<uint32_t> m_ShadowCullCommands;  // their draw list indices
+		std::vector<uint8_t> m_ShadowCullVisible;
+
+		// Reflection uniforms (set 0 in the planar-reflection pass - the
+		// mirror-flipped camera's view/proj). Same pattern as the shadow UBO
+		// above.
+		FrameUploadSlot m_ReflectionUniformSlot;
 		FrameUniformData m_ReflectionFrameData;
+		// Per sorted draw: 1 if the planar reflection pass draws it (see
+		// CullReflectionCasters). Rebuilt at the start of RecordReflectionPass.
+		std::vector<uint8_t> m_ReflectionCasters;
+
+		// Auxiliary views (SetAuxiliaryViews): cameras, their uniforms (set 0
+		// in their passes) and per sorted draw whether the view draws it, from
+		// DrawCommand::auxViewMask. Written in FinalizeFrame.
+		std::array<AuxiliaryView, MAX_AUXILIARY_VIEWS> m_AuxiliaryViews{};
+		uint32_t m_AuxiliaryViewCount = 0;
+		std::array<FrameUploadSlot, MAX_AUXILIARY_VIEWS> m_AuxiliaryUniformSlots{};
+		std::array<std::vector<uint8_t>, MAX_AUXILIARY_VIEWS> m_AuxiliaryCasters;
+		std::array<VkBuffer, MAX_AUXILIARY_VIEWS> m_AuxiliaryReadbacks{};   // this frame's requests
+
+		// Per-frame instance transforms for batched Mesh/Transparent draws.
+		// Start at INITIAL_DRAW_INSTANCES and grow in FinalizeFrame
+		// (EnsureDrawBufferCapacity) when a frame needs more; never shrink.
+		static constexpr uint32_t INITIAL_DRAW_INSTANCES = 16384;
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_InstanceBuffers{};
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_InstanceCapacity{};
+		uint32_t m_LastInstanceCount = 0;
+		uint32_t m_LastDroppedInstances = 0;
+
+		// Per-frame multi-draw parameters, one IndexedIndirectDraw per sorted
+		// command (DrawList::WriteIndirectDraws). Only created when the device
+		// has multiDrawIndirect; the main pass and the shadow cascades draw
+		// runs of Mesh commands from it.
+		std::array<VulkanBuffer*, MAX_FRAMES_IN_FLIGHT> m_IndirectDrawBuffers{};
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_IndirectDrawCapacity{};
+		uint32_t m_IndirectDrawCount = 0;
 
 		// Reflection target sampler descriptor set (Water set 2). Allocated once
 		// in InitializePipelines; re-pointed in HandleSwapchainResize since the
@@ -233,12 +741,25 @@ namespace Nightbloom
 		// re-updated in HandleSwapchainResize since the texture is recreated then.
 		VkDescriptorSet m_PostProcessInputSet = VK_NULL_HANDLE;
 
-		// Bloom sampler sets (same single-sampler shape as the post-process input).
-		// A points at the bloom A target, B at B. Used as the input set for the bloom
-		// sub-passes and, for A, as set 1 of the post-process composite. Re-pointed on
-		// swapchain resize since the bloom targets are recreated then.
-		VkDescriptorSet m_BloomSetA = VK_NULL_HANDLE;
-		VkDescriptorSet m_BloomSetB = VK_NULL_HANDLE;
+		// Mesh/Transparent sample through the bindless table (see InitializePipelines)
+		bool m_BindlessMeshPasses = false;
+
+		// Depth prepass (SetDepthPrepass); supported once every twin exists
+		bool m_DepthPrepass = false;
+		bool m_DepthPrepassSupported = false;
+
+		// Order-independent transparency (SetOrderIndependentTransparency).
+		// m_OitInputSet reads the OIT pass's accumulation/revealage as input
+		// attachments; re-pointed in HandleSwapchainResize.
+		bool m_OrderIndependentTransparency = false;
+		bool m_OitSupported = false;
+		VkDescriptorSet m_OitInputSet = VK_NULL_HANDLE;
+
+		// TerrainTessellated and its prepass twins exist (SupportsTerrainTessellation)
+		bool m_TerrainTessellationSupported = false;
+
+		// When InitializePipelines started the parallel batch (StartupTimer::Now)
+		double m_PipelineCreationStart = 0.0;
 
 		//Compute support
 		bool m_ComputeEnabled = false;
@@ -254,23 +775,57 @@ namespace Nightbloom
 			float time;
 		};
 
-		// Noise Generator test texture
-		VulkanTexture* m_TestNoise = nullptr;
+		// Noise Debug panel's texture, made on its first Generate
 		VulkanTexture* m_NoisePreview = nullptr;  // 2D (depth=1), displayable in ImGui
 
 		// Shadow state
 		bool m_ShadowEnabled = true;
 		bool m_DebugCascadeTint = false;  // CSM cascade visualization (set 0=red,1=green,2=blue)
+		bool m_ShadowPcf = true;
+		bool m_HalfPrecisionShading = true;  // used where IsHalfPrecisionSupported
 		PostProcessSettings m_PostProcessSettings;
 		glm::vec3 m_ShadowCenter = glm::vec3(0.0f);
 		ShadowConfig m_ShadowConfig;
 
 		float m_TotalTime = 0.0f;  // Track time for shaders
 		float m_LastDeltaTime = 0.0f;  // Frame-to-frame delta, for systems like FireflySystem
+		float m_FixedTimestep = 0.0f;  // > 0 replaces the wall-clock delta (SetFixedTimestep)
 
 		FireflySystem* m_FireflySystem = nullptr; // not owned
+		ParticleSystem* m_ParticleSystem = nullptr; // not owned
 		CloudSystem* m_CloudSystem = nullptr; // not owned
+		// What each frame slot's binding 5 holds (the cloud shadow map or
+		// default_black), rewritten only when it changes
+		std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> m_CloudShadowBound{};
+		// Likewise binding 6 (the terrain's sun shadow map or default_black)
+		std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> m_TerrainShadowBound{};
 		WaterSystem* m_WaterSystem = nullptr; // not owned
+		GrassSystem* m_GrassSystem = nullptr; // not owned
+		TerrainSystem* m_TerrainSystem = nullptr; // not owned
+
+		// Async compute, per recorded frame: whether the compute queue has work,
+		// the graphics work ahead of its consumers (split off the frame's
+		// command buffer and submitted first), and whether the compute
+		// submission has to wait for that head rather than the previous frame.
+		bool m_AsyncComputeFrame = false;
+		bool m_AsyncComputeWaitsOnHead = false;
+		VkCommandBuffer m_FrameHeadCommandBuffer = VK_NULL_HANDLE;
+		// Agent buffer the last graphics submission released to the compute
+		// family; anything else still belongs to graphics
+		VkBuffer m_AgentBufferReleasedToCompute = VK_NULL_HANDLE;
+
+		// What an async compute pass handed to the graphics family
+		struct AsyncComputeRelease
+		{
+			VkBuffer agentBuffer = VK_NULL_HANDLE;
+			VkDeviceSize agentBufferSize = 0;
+			VkImage cloudResult = VK_NULL_HANDLE;
+			VkImage cloudReflectionResult = VK_NULL_HANDLE;
+			VkImage cloudShadowMap = VK_NULL_HANDLE;      // already sampler-ready
+			VkImage oceanDisplacement = VK_NULL_HANDLE;   // sampled from the vertex stage too
+			VkImage oceanDerivatives = VK_NULL_HANDLE;
+		};
+		AsyncComputeRelease m_AsyncComputeReleased;   // this frame's, for the graph's acquire/release passes
 
 		// Testing state (temporary)
 		PipelineType m_CurrentPipeline = PipelineType::Mesh;
@@ -282,22 +837,153 @@ namespace Nightbloom
 		void* m_WindowHandle = nullptr;
 		bool m_FrameValid = false;
 
+		// Frames in flight: current setting, and a change waiting for the
+		// next frame boundary (0 = none)
+		uint32_t m_FramesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+		uint32_t m_PendingFramesInFlight = 0;
+		bool m_PresentModeChangePending = false;
+		bool m_GpuDefragRequested = false;
+
+		// Draw streams: a pending capture's path, and the stream frames are
+		// pinned to (its uniform blocks ignored when their sizes don't match)
+		std::string m_DrawStreamCapturePath;
+		const DrawStream* m_DrawStreamReplay = nullptr;
+		bool m_DrawStreamUniformsMatch = false;
+
+		// Metrics export: the last GPU frame handed over (each is sent once)
+		// and the device budget, refreshed with PerformanceMetrics' memory
+		MetricsExporter m_MetricsExporter;
+		uint64_t m_MetricsGpuFrame = UINT64_MAX;
+		uint64_t m_MetricsMemoryUsage = 0;
+		uint64_t m_MetricsMemoryBudget = 0;
+
+		// Dynamic resolution: extent the scene is drawn at this frame
+		DynamicResolutionController m_DynamicResolution;
+		SceneViewport m_SceneViewport;
+		VkExtent2D m_RenderExtent = { 0, 0 };
+
+		// Temporal upscaling: this frame's jitter and the sequence position
+		glm::vec2 m_FrameJitter = glm::vec2(0.0f);
+		uint64_t m_TemporalJitterIndex = 0;
+
 		// Private initialization helpers
 		bool InitializeCore();
 		bool InitializeComponents();
 		bool InitializePipelines();
+		// Depth-only and EQUAL twins of one scene pipeline, from its config
+		bool CreateDepthPrepassTwins(PipelineType type, const PipelineConfig& config);
+		// The OIT pass's accumulating twin of a transparent pipeline
+		bool CreateOitTwin(PipelineType type, const PipelineConfig& config, const char* fragmentShaderPath);
+		// The reflection pass's twin of a scene pipeline, when it runs at its
+		// own sample count (no-op success otherwise)
+		bool CreateReflectionTwin(PipelineType type, const PipelineConfig& config);
 		bool InitializeCompute();
+		// Gathers the pipelines InitializePipelines, InitializeShadowMapping
+		// and InitializeCompute queued across the job workers, and turns off
+		// what a failed build leaves without its pipelines. False only when
+		// nothing could reach the screen.
+		bool FinishPipelineCreation();
+		bool InitializeOcclusionCulling();
+		bool InitializeMeshletCulling();
+		bool InitializeSkinning();
+		bool InitializeTemporalUpscaling();
+		bool InitializeContactShadows();
+		bool InitializeRayTracedShadows();
+		bool InitializeBloom();
+		bool InitializeComputePostProcess();
+		bool InitializeScreenSpaceReflections();
 		bool InitializeShadowMapping();
 
 		// Helper methods
+		// Grows frameIndex's instance and indirect draw buffers to hold
+		// `instances` slots and `draws` commands (creating them the first
+		// time); a replaced buffer is freed once the GPU is done with it
+		bool EnsureDrawBufferCapacity(uint32_t frameIndex, uint32_t instances, uint32_t draws);
 		void RecordCommandBuffer(uint32_t frameIndex, uint32_t imageIndex);
-		void RecordComputePass(uint32_t frameIndex);
+		void RecordScenePass(uint32_t frameIndex);
+		// Transparents accumulated unsorted, then composited over the scene
+		// color (SetOrderIndependentTransparency)
+		void RecordTransparencyPass(uint32_t frameIndex);
+		void RecordComputeTestPass(VkCommandBuffer cmd);
+		bool RecordAsyncComputePass(uint32_t frameIndex, AsyncComputeRelease& released, bool cloudReflection);
+		void AcquireAsyncComputeResults(VkCommandBuffer cmd, const AsyncComputeRelease& released);
+		void ReleaseAsyncComputeResources(VkCommandBuffer cmd, const AsyncComputeRelease& released);
 		void RecordShadowPass(uint32_t frameIndex);
+		// Terrain is static (cached per far cascade); every other caster is dynamic
+		enum class ShadowCasterFilter { All, StaticOnly, DynamicOnly };
+		void RecordShadowCasters(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t cascade,
+			ShadowCasterFilter filter = ShadowCasterFilter::All);
+		void RecordShadowPassLayered(uint32_t frameIndex, const VkViewport& viewport, const VkRect2D& scissor);
+		void RecordLayeredShadowCasters(VkCommandBuffer cmd, uint32_t frameIndex,
+			uint32_t terrainCascades, uint32_t dynamicCascades);
+		static bool IsShadowCaster(const DrawCommand& drawCmd);
+		// Picks this frame's shadowed point lights and fills the m_Shaded*
+		// lights and the atlas uniforms from them
+		void UpdateLocalShadowLights(uint32_t frameIndex);
+		// One point light face: the batched casters inside its frustum and radius
+		void RecordLocalShadowCasters(VkCommandBuffer cmd, uint32_t frameIndex, const glm::mat4& faceViewProj,
+			const Frustum& faceFrustum, const glm::vec4& lightSphere);
+		uint64_t ComputeStaticCasterSignature() const;
+		uint64_t ComputeStaticShadowRecordSignature(uint32_t frameIndex, uint32_t cascadeMask, bool layered) const;
+		void CullShadowCasters();
+		void CullReflectionCasters();
+		// Fraction of the reflection target the planar pass renders into (1
+		// when screen-space reflections replace it)
+		float GetPlanarReflectionScale() const;
+		// The water's planar reflection interval (1 with screen-space
+		// reflections or no water); above 1 needs a persistent target
+		uint32_t GetReflectionInterval() const;
+		// Frame boundary: give the reflection target its own memory or put it
+		// back in the bloom chain's, re-pointing what samples either
+		bool ApplyReflectionPersistence(bool persistent);
 		void RecordReflectionPass(uint32_t frameIndex);
-		void RecordBloomPass(uint32_t frameIndex);   // bright-extract + separable blur into the bloom targets
+		void UploadAuxiliaryViews(uint32_t frameIndex);
+		void RecordAuxiliaryViewPass(uint32_t frameIndex, uint32_t view);
+		void RecordAuxiliaryViewReadback(VkCommandBuffer cmd, uint32_t view, VkBuffer buffer);
 		void RecordPostProcessPass(uint32_t frameIndex, uint32_t imageIndex);
+		// Dynamic rendering (RenderPassManager::IsPostProcessDynamic): begin/end
+		// on the swapchain image view, with its layout transitions
+		void BeginPostProcessRendering(VkCommandBuffer cmd, uint32_t imageIndex);
+		void EndPostProcessRendering(VkCommandBuffer cmd, uint32_t imageIndex);
+		// Must match PushConstants in post_process.glsl (std430 scalar layout)
+		struct PostProcessPushConstants
+		{
+			int   aaEnabled;
+			int   tonemapEnabled;
+			float exposure;
+			float vignetteStrength;
+			float bloomIntensity;
+			float uvScaleX;
+			float uvScaleY;
+		};
+		PostProcessPushConstants BuildPostProcessPush(bool temporal, bool bloom) const;
+		bool IsComputePostActive() const;
+		// The water wants screen-space reflections and they are available
+		bool IsScreenSpaceReflectionActive() const;
 		void UpdateShadowMatrices();
+		// SetDrawStreamReplay's pin: the inputs before the uniforms are
+		// built, the cascades after UpdateShadowMatrices
+		void ApplyDrawStreamInputs();
+		void ApplyDrawStreamShadows();
+		void CaptureDrawStream();
+		// The frame just presented, to the metrics exporter
+		void RecordExportedMetrics();
+		// Points frameIndex's binding 5 at the cloud shadow map, or at
+		// default_black (no cloud shadows)
+		void UpdateCloudShadowBinding(uint32_t frameIndex, bool clouds);
+		// Points frameIndex's binding 6 at the terrain's sun shadow map, or at
+		// default_black (no terrain shadow map)
+		void UpdateTerrainShadowBinding(uint32_t frameIndex, bool terrain);
+		void UpdateRenderExtent();
+		glm::vec2 GetSceneUVScale() const;  // m_RenderExtent / full extent
 		bool HandleSwapchainResize();
+		// Rebuilds the scene targets at extent (the scene viewport moved on)
+		bool ResizeSceneTargets(VkExtent2D extent);
+		// Re-points everything that reads the scene targets after they were
+		// recreated (what can't follow is turned off)
+		void RebindSceneTargets();
+		bool ApplyFramesInFlight(uint32_t count);
+		void StepGpuDefragmentation();
 
 		void CleanupCompute();
 
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+// ResourceHandle.hpp
+//
+// Generational handles into dense slot arrays. A handle is 32 bits: the
+// slot index in the low 20, the slot's generation in the high 12. Removing
+// a resource bumps its slot's generation, so a handle kept past the
+// resource's destruction stops resolving (Get returns null) instead of
+// aliasing whatever is created in the slot next. Resolving is an index and
+// a compare; names stay with the owner for load-time lookup and logging.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Tag is only there to keep handles of different resource types apart
+	template<typename Tag>
+	struct ResourceHandle
+	{
+		static constexpr uint32_t INDEX_BITS = 20;
+		static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+		uint32_t value = 0;   // 0 = null: generations start at 1
+
+		static constexpr ResourceHandle Make(uint32_t index, uint32_t generation)
+		{
+			return ResourceHandle{ (generation << INDEX_BITS) | (index & INDEX_MASK) };
+		}
+
+		constexpr uint32_t GetIndex() const { return value & INDEX_MASK; }
+		constexpr uint32_t GetGeneration() const { return value >> INDEX_BITS; }
+		constexpr bool IsValid() const { return value != 0; }
+
+		constexpr bool operator==(const ResourceHandle&) const = default;
+	};
+
+	template<typename T, typename Tag>
+	class ResourcePool
+	{
+	public:
+		using Handle = ResourceHandle<Tag>;
+
+		// Null handle once all 2^20 slots are in use
+		Handle Insert(T value)
+		{
+			uint32_t index = 0;
+			if (!m_FreeSlots.empty())
+			{
+				index = m_FreeSlots.back();
+				m_FreeSlots.pop_back();
+			}
+			else
+			{
+				if (m_Slots.size() > Handle::INDEX_MASK)
+					return {};
+				index = static_cast<uint32_t>(m_Slots.size());
+				m_Slots.emplace_back();
+			}
+
+			Slot& slot = m_Slots[index];
+			slot.value = std::move(value);
+			slot.occupied = true;
+			++m_Count;
+			return Handle::Make(index, slot.generation);
+		}
+
+		bool Contains(Handle handle) const
+		{
+			const uint32_t index = handle.GetIndex();
+			return handle.IsValid() && index < m_Slots.size() && m_Slots[index].occupied &&
+				m_Slots[index].generation == handle.GetGeneration();
+		}
+
+		// Null for a null or stale handle
+		T* Get(Handle handle) { return Contains(handle) ? &m_Slots[handle.GetIndex()].value : nullptr; }
+		const T* Get(Handle handle) const { return Contains(handle) ? &m_Slots[handle.GetIndex()].value : nullptr; }
+
+		// Moves the value out and frees its slot; T{} for a null or stale handle
+		T Remove(Handle handle)
+		{
+			if (!Contains(handle))
+				return T{};
+
+			Slot& slot = m_Slots[handle.GetIndex()];
+			T value = std::move(slot.value);
+			slot.value = T{};
+			slot.occupied = false;
+			--m_Count;
+
+			// A slot whose generation would wrap is retired instead of reused,
+			// so no handle to it can ever resolve again
+			if (slot.generation < Handle::MAX_GENERATION)
+			{
+				++slot.generation;
+				m_FreeSlots.push_back(handle.GetIndex());
+			}
+			return value;
+		}
+
+		// Removes everything; handles from before stay stale
+		void Clear()
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); ++i)
+			{
+				if (m_Slots[i].occupied)
+					Remove(Handle::Make(i, m_Slots[i].generation));
+			}
+		}
+
+		// fn(Handle, T&) for each live entry, in slot order
+		template<typename Fn>
+		void ForEach(Fn&& fn)
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); ++i)
+			{
+				if (m_Slots[i].occupied)
+					fn(Handle::Make(i, m_Slots[i].generation), m_Slots[i].value);
+			}
+		}
+
+		template<typename Fn>
+		void ForEach(Fn&& fn) const
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); ++i)
+			{
+				if (m_Slots[i].occupied)
+					fn(Handle::Make(i, m_Slots[i].generation), m_Slots[i].value);
+			}
+		}
+
+		size_t Size() const { return m_Count; }
+		bool IsEmpty() const { return m_Count == 0; }
+
+	private:
+		struct Slot
+		{
+			T value{};
+			uint32_t generation = 1;
+			bool occupied = false;
+		};
+
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		size_t m_Count = 0;
+	};
+}
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// SceneViewport.hpp
+//
+// Where on the window the 3D scene is shown and how big its targets are.
+// The app names a region of the surface (the editor's viewport panel; empty
+// is the whole window); the scene, depth, OIT, bloom, reflection and cloud
+// targets are sized to that region times resolutionScale, and post-process
+// draws the result into the region alone. Pixels the UI covers are never
+// shaded.
+//
+// A region that keeps changing (a dock splitter being dragged) would rebuild
+// the targets every frame; a new size is only adopted once it has held for
+// settleFrames, and the old targets are stretched over the region meanwhile.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	// Surface pixels, origin top-left
+	struct SceneViewportRect
+	{
+		int32_t x = 0;
+		int32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		bool IsEmpty() const { return width == 0 || height == 0; }
+		bool operator==(const SceneViewportRect& other) const
+		{
+			return x == other.x && y == other.y && width == other.width && height == other.height;
+		}
+		bool operator!=(const SceneViewportRect& other) const { return !(*this == other); }
+	};
+
+	struct SceneViewportSettings
+	{
+		float resolutionScale = 1.0f;  // scene target pixels per region pixel, per axis
+		uint32_t settleFrames = 4;     // frames a new size holds before the targets follow
+	};
+
+	class SceneViewport
+	{
+	public:
+		static constexpr float MIN_SCALE = 0.25f;
+		static constexpr float MAX_SCALE = 2.0f;
+
+		void SetSettings(const SceneViewportSettings& settings)
+		{
+			m_Settings = settings;
+			m_Settings.resolutionScale = std::clamp(m_Settings.resolutionScale, MIN_SCALE, MAX_SCALE);
+		}
+		const SceneViewportSettings& GetSettings() const { return m_Settings; }
+
+		// Empty: the whole surface
+		void SetRegion(const SceneViewportRect& region) { m_Region = region; }
+		const SceneViewportRect& GetRegion() const { return m_Region; }
+
+		// The region within the surface; the whole surface when it is empty
+		// or entirely outside
+		static SceneViewportRect Clamp(const SceneViewportRect& region, glm::uvec2 surface)
+		{
+			const SceneViewportRect whole{ 0, 0, surface.x, surface.y };
+			if (region.IsEmpty())
+				return whole;
+
+			const int64_t x0 = std::max<int64_t>(region.x, 0);
+			const int64_t y0 = std::max<int64_t>(region.y, 0);
+			const int64_t x1 = std::min<int64_t>(static_cast<int64_t>(region.x) + region.width, surface.x);
+			const int64_t y1 = std::min<int64_t>(static_cast<int64_t>(region.y) + region.height, surface.y);
+			if (x1 <= x0 || y1 <= y0)
+				return whole;
+			return SceneViewportRect{ static_cast<int32_t>(x0), static_cast<int32_t>(y0),
+				static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0) };
+		}
+
+		// Target size for a region size at a scale (at least 1x1)
+		static glm::uvec2 TargetExtent(glm::uvec2 regionSize, float scale)
+		{
+			scale = std::clamp(scale, MIN_SCALE, MAX_SCALE);
+			return glm::uvec2(
+				std::max(1u, static_cast<uint32_t>(std::lround(regionSize.x * scale))),
+				std::max(1u, static_cast<uint32_t>(std::lround(regionSize.y * scale))));
+		}
+
+		// Once per frame, before recording. current is the size the targets
+		// have now. Returns true when they should be rebuilt at
+		// GetTargetExtent(); immediate skips the settling (a window resize
+		// rebuilds everything anyway).
+		bool Update(glm::uvec2 surface, glm::uvec2 current, bool immediate = false)
+		{
+			m_Rect = Clamp(m_Region, surface);
+			const glm::uvec2 desired = TargetExtent(glm::uvec2(m_Rect.width, m_Rect.height), m_Settings.resolutionScale);
+			if (surface.x == 0 || surface.y == 0 || desired == current)
+			{
+				m_PendingFrames = 0;
+				m_Target = current;
+				return false;
+			}
+
+			if (desired != m_Target)
+			{
+				m_Target = desired;
+				m_PendingFrames = 0;
+			}
+			++m_PendingFrames;
+			if (!immediate && m_PendingFrames < std::max(m_Settings.settleFrames, 1u))
+				return false;
+
+			m_PendingFrames = 0;
+			return true;
+		}
+
+		// This frame's region on the surface (as of the last Update)
+		const SceneViewportRect& GetRect() const { return m_Rect; }
+		// Size the targets should have (as of the last Update)
+		glm::uvec2 GetTargetExtent() const { return m_Target; }
+
+	private:
+		SceneViewportSettings m_Settings;
+		SceneViewportRect m_Region;
+		SceneViewportRect m_Rect;
+		glm::uvec2 m_Target = glm::uvec2(0);
+		uint32_t m_PendingFrames = 0;
+	};
+}
@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+// ShaderBuildCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/ShaderBuildCache.hpp"
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+
+		// FNV-1a 64, chainable through seed (MeshCache has the same one, but
+		// pulls in the Vulkan vertex formats)
+		uint64_t HashBytes(const void* data, size_t size, uint64_t seed = FNV_OFFSET)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				seed ^= bytes[i];
+				seed *= 0x100000001b3ull;
+			}
+			return seed;
+		}
+
+		bool ReadFromDisk(const std::filesystem::path& path, std::string& out)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+				return false;
+
+			std::stringstream buffer;
+			buffer << file.rdbuf();
+			out = buffer.str();
+			return true;
+		}
+
+		uint64_t HashString(std::string_view text, uint64_t seed)
+		{
+			// Length first, so "ab"+"c" and "a"+"bc" differ
+			const uint64_t size = text.size();
+			seed = HashBytes(&size, sizeof(size), seed);
+			return HashBytes(text.data(), text.size(), seed);
+		}
+
+		// Comments blanked out (newlines kept), so directives inside them vanish
+		std::string StripComments(std::string_view source)
+		{
+			std::string out(source);
+			size_t i = 0;
+			while (i < out.size())
+			{
+				if (out[i] == '/' && i + 1 < out.size() && out[i + 1] == '/')
+				{
+					while (i < out.size() && out[i] != '\n')
+						out[i++] = ' ';
+				}
+				else if (out[i] == '/' && i + 1 < out.size() && out[i + 1] == '*')
+				{
+					out[i++] = ' ';
+					out[i++] = ' ';
+					while (i < out.size() && !(out[i] == '*' && i + 1 < out.size() && out[i + 1] == '/'))
+					{
+						if (out[i] != '\n')
+							out[i] = ' ';
+						++i;
+					}
+					if (i < out.size())
+					{
+						out[i++] = ' ';
+						out[i++] = ' ';
+					}
+				}
+				else
+				{
+					++i;
+				}
+			}
+			return out;
+		}
+	}
+
+	ShaderBuildCache::ShaderBuildCache(std::vector<std::filesystem::path> includeDirs, ReadFileFn readFile)
+		: m_IncludeDirs(std::move(includeDirs))
+		, m_ReadFile(readFile ? std::move(readFile) : ReadFileFn(&ReadFromDisk))
+	{
+	}
+
+	void ShaderBuildCache::BeginScan()
+	{
+		m_Files.clear();
+	}
+
+	bool ShaderBuildCache::ComputeKey(const std::filesystem::path& shader, const std::string& options,
+		ShaderBuildKey& out, std::string& error)
+	{
+		out = ShaderBuildKey{};
+		uint64_t hash = HashString(options, FNV_OFFSET);
+
+		// Depth-first in directive order, each file once (include guards make
+		// a second inclusion empty, and a cycle would never end)
+		struct Pending
+		{
+			std::filesystem::path path;
+			std::string name;   // as written in the directive
+		};
+		std::vector<Pending> stack;
+		stack.push_back({ shader.lexically_normal(), shader.filename().string() });
+		std::unordered_set<std::string> visited;
+
+		while (!stack.empty())
+		{
+			Pending current = std::move(stack.back());
+			stack.pop_back();
+			if (!visited.insert(KeyOf(current.path)).second)
+				continue;
+
+			const FileEntry& entry = ReadEntry(current.path);
+			if (!entry.found)
+			{
+				error = "cannot read " + current.path.string();
+				return false;
+			}
+
+			// Names rather than full paths, so the key survives moving the tree
+			hash = HashString(current.name, hash);
+			hash = HashBytes(&entry.hash, sizeof(entry.hash), hash);
+			out.files.push_back(current.path);
+
+			// Reversed, so the first directive is visited first
+			for (auto it = entry.includes.rbegin(); it != entry.includes.rend(); ++it)
+			{
+				std::filesystem::path resolved;
+				if (!ResolveInclude(*it, current.path, resolved))
+				{
+					error = current.path.filename().string() + ": cannot find include \"" + *it + "\"";
+					return false;
+				}
+				stack.push_back({ resolved, *it });
+			}
+		}
+
+		out.hash = hash;
+		return true;
+	}
+
+	void ShaderBuildCache::MarkBuilt(const std::filesystem::path& shader, const ShaderBuildKey& key)
+	{
+		BuiltShader& built = m_Built[KeyOf(shader)];
+		built.hash = key.hash;
+		built.files = key.files;
+	}
+
+	bool ShaderBuildCache::IsUpToDate(const std::filesystem::path& shader, const ShaderBuildKey& key) const
+	{
+		auto it = m_Built.find(KeyOf(shader));
+		return it != m_Built.end() && it->second.hash == key.hash;
+	}
+
+	std::vector<std::filesystem::path> ShaderBuildCache::GetDependents(const std::filesystem::path& file) const
+	{
+		const std::string target = KeyOf(file);
+		std::vector<std::filesystem::path> dependents;
+		for (const auto& [shader, built] : m_Built)
+		{
+			for (const std::filesystem::path& dependency : built.files)
+			{
+				if (KeyOf(dependency) == target)
+				{
+					dependents.emplace_back(shader);
+					break;
+				}
+			}
+		}
+		return dependents;
+	}
+
+	bool ShaderBuildCache::LoadManifest(const std::filesystem::path& path)
+	{
+		std::ifstream file(path);
+		if (!file.is_open())
+			return false;
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			const size_t space = line.find(' ');
+			if (space == std::string::npos || space == 0)
+				continue;
+
+			BuiltShader built;
+			try
+			{
+				built.hash = std::stoull(line.substr(0, space), nullptr, 16);
+			}
+			catch (const std::exception&)
+			{
+				continue;
+			}
+			// Dependencies aren't stored; the next scan recomputes them
+			m_Built[line.substr(space + 1)] = std::move(built);
+		}
+		return true;
+	}
+
+	bool ShaderBuildCache::SaveManifest(const std::filesystem::path& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		char hex[17];
+		for (const auto& [shader, built] : m_Built)
+		{
+			std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(built.hash));
+			file << hex << ' ' << shader << '\n';
+		}
+		return static_cast<bool>(file);
+	}
+
+	std::filesystem::path ShaderBuildCache::GetCachedSpirvPath(const std::filesystem::path& cacheDir,
+		const std::filesystem::path& shader, uint64_t hash)
+	{
+		char hex[17];
+		std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+		return cacheDir / (shader.filename().string() + "-" + hex + ".spv");
+	}
+
+	std::vector<std::string> ShaderBuildCache::ParseIncludes(std::string_view source)
+	{
+		const std::string text = StripComments(source);
+		std::vector<std::string> includes;
+
+		size_t lineStart = 0;
+		while (lineStart < text.size())
+		{
+			size_t lineEnd = text.find('\n', lineStart);
+			if (lineEnd == std::string::npos)
+				lineEnd = text.size();
+
+			std::string_view line(text.data() + lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1;
+
+			auto skipSpace = [&line]() {
+				while (!line.empty() && (line.front() == ' ' || line.front() == '\t'))
+					line.remove_prefix(1);
+			};
+
+			skipSpace();
+			if (line.empty() || line.front() != '#')
+				continue;
+			line.remove_prefix(1);
+			skipSpace();
+			if (line.substr(0, 7) != "include")
+				continue;
+			line.remove_prefix(7);
+			skipSpace();
+			if (line.empty() || (line.front() != '"' && line.front() != '<'))
+				continue;
+
+			const char close = line.front() == '"' ? '"' : '>';
+			line.remove_prefix(1);
+			const size_t end = line.find(close);
+			if (end == std::string_view::npos || end == 0)
+				continue;
+			includes.emplace_back(line.substr(0, end));
+		}
+		return includes;
+	}
+
+	const ShaderBuildCache::FileEntry& ShaderBuildCache::ReadEntry(const std::filesystem::path& file)
+	{
+		const std::string key = KeyOf(file);
+		auto it = m_Files.find(key);
+		if (it != m_Files.end())
+			return it->second;
+
+		FileEntry entry;
+		std::string source;
+		if (m_ReadFile(file, source))
+		{
+			entry.found = true;
+			entry.hash = HashBytes(source.data(), source.size());
+			entry.includes = ParseIncludes(source);
+		}
+		return m_Files.emplace(key, std::move(entry)).first->second;
+	}
+
+	bool ShaderBuildCache::ResolveInclude(const std::string& name, const std::filesystem::path& includer,
+		std::filesystem::path& out)
+	{
+		// Next to the including file first, then the include directories in order
+		std::filesystem::path candidate = (includer.parent_path() / name).lexically_normal();
+		if (ReadEntry(candidate).found)
+		{
+			out = candidate;
+			return true;
+		}
+
+		for (const std::filesystem::path& dir : m_IncludeDirs)
+		{
+			candidate = (dir / name).lexically_normal();
+			if (ReadEntry(candidate).found)
+			{
+				out = candidate;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::string ShaderBuildCache::KeyOf(const std::filesystem::path& path)
+	{
+		return path.lexically_normal().generic_string();
+	}
+}
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+// ShaderBuildCache.hpp
+//
+// Decides which GLSL shaders need compiling. A shader's build key is a hash
+// over its source, the source of every file it #includes (followed
+// transitively: a name resolves next to the including file first, then in
+// the include directories) and the compile options. Equal keys mean equal
+// SPIR-V, so:
+//
+//   - a shader whose key matches the one it was last built with is skipped,
+//     and editing an include rebuilds exactly the shaders that reach it
+//   - compiled SPIR-V is stored content-addressed (<name>-<key>.spv), so
+//     undoing an edit, or another shader config, is a copy, not a compile
+//
+// File contents are read once per scan (BeginScan() starts one), so shaders
+// sharing scene_common.glsl don't re-read it. Not thread-safe: scan from one
+// thread and hand the dirty list to the compile workers.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct ShaderBuildKey
+	{
+		uint64_t hash = 0;
+		// The shader first, then every file it includes (resolved, normalized)
+		std::vector<std::filesystem::path> files;
+	};
+
+	class ShaderBuildCache
+	{
+	public:
+		// Reads a whole file; false when it doesn't exist or can't be read
+		using ReadFileFn = std::function<bool(const std::filesystem::path&, std::string&)>;
+
+		// readFile defaults to reading from disk
+		explicit ShaderBuildCache(std::vector<std::filesystem::path> includeDirs, ReadFileFn readFile = {});
+
+		// Forgets the file contents read by the previous scan
+		void BeginScan();
+
+		// Key of `shader` built with `options` (stage, optimisation, target
+		// environment: anything that changes the output). False, with
+		// `error` set, when the shader or one of its includes can't be read.
+		bool ComputeKey(const std::filesystem::path& shader, const std::string& options,
+			ShaderBuildKey& out, std::string& error);
+
+		// Records that `shader`'s output is now the one built for `key`
+		void MarkBuilt(const std::filesystem::path& shader, const ShaderBuildKey& key);
+		bool IsUpToDate(const std::filesystem::path& shader, const ShaderBuildKey& key) const;
+
+		// Built shaders whose last key depended on `file` (itself included)
+		std::vector<std::filesystem::path> GetDependents(const std::filesystem::path& file) const;
+
+		// "<hash> <shader>" lines, so a new session knows what is already built
+		bool LoadManifest(const std::filesystem::path& path);
+		bool SaveManifest(const std::filesystem::path& path) const;
+
+		// <cacheDir>/<shader file name>-<16 hex digits>.spv
+		static std::filesystem::path GetCachedSpirvPath(const std::filesystem::path& cacheDir,
+			const std::filesystem::path& shader, uint64_t hash);
+
+		// Names in `#include "x"` / `#include <x>` directives, in source
+		// order; directives inside comments are ignored
+		static std::vector<std::string> ParseIncludes(std::string_view source);
+
+	private:
+		struct FileEntry
+		{
+			bool found = false;
+			uint64_t hash = 0;
+			std::vector<std::string> includes;
+		};
+
+		struct BuiltShader
+		{
+			uint64_t hash = 0;
+			std::vector<std::filesystem::path> files;
+		};
+
+		const FileEntry& ReadEntry(const std::filesystem::path& file);
+		bool ResolveInclude(const std::string& name, const std::filesystem::path& includer,
+			std::filesystem::path& out);
+
+		static std::string KeyOf(const std::filesystem::path& path);
+
+		std::vector<std::filesystem::path> m_IncludeDirs;
+		ReadFileFn m_ReadFile;
+
+		// This scan's file contents, by normalized path
+		std::unordered_map<std::string, FileEntry> m_Files;
+		// Last successful build per shader, by normalized path
+		std::unordered_map<std::string, BuiltShader> m_Built;
+	};
+}
@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+// ShaderVariant.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/ShaderVariant.hpp"
+
+namespace Nightbloom
+{
+	ShaderVariantKey GetShaderFeatureMask(PipelineType type)
+	{
+		constexpr ShaderVariantKey lit =
+			ToVariantBit(ShaderFeature::ShadowPcf) | ToVariantBit(ShaderFeature::CascadeDebug) |
+			ToVariantBit(ShaderFeature::RayQueryShadow);
+		constexpr ShaderVariantKey post =
+			ToVariantBit(ShaderFeature::Fxaa) | ToVariantBit(ShaderFeature::Tonemap);
+		constexpr ShaderVariantKey half = ToVariantBit(ShaderFeature::HalfPrecision);
+
+		switch (type)
+		{
+		// Fragment shaders that include shadows.glsl
+		case PipelineType::Mesh:
+		case PipelineType::Transparent:
+		case PipelineType::MeshPacked:
+		case PipelineType::TransparentPacked:
+		case PipelineType::TransparentOit:
+		case PipelineType::TransparentPackedOit:
+		case PipelineType::Terrain:
+		case PipelineType::MeshEqual:
+		case PipelineType::MeshPackedEqual:
+		case PipelineType::TerrainEqual:
+		case PipelineType::MeshReflection:
+		case PipelineType::MeshPackedReflection:
+		case PipelineType::TerrainReflection:
+		case PipelineType::TerrainTessellated:
+		case PipelineType::TerrainTessellatedEqual:
+			return lit;
+
+		// Grass.frag also has an fp16 build
+		case PipelineType::Foliage:
+		case PipelineType::FoliageEqual:
+		case PipelineType::FoliageReflection:
+			return lit | half;
+
+		// The full-screen composite; the compute one (ComputePostProcess)
+		// builds its own pipeline and keeps the push-constant toggles
+		case PipelineType::PostProcess:
+			return post | half;
+
+		default:
+			return 0;
+		}
+	}
+
+	SpecializationData BuildSpecialization(ShaderVariantKey key, ShaderVariantKey mask)
+	{
+		SpecializationData data;
+		for (uint32_t bit = 0; bit < static_cast<uint32_t>(ShaderFeature::Count); ++bit)
+		{
+			if ((mask & ~MODULE_SHADER_FEATURES & (1u << bit)) == 0)
+				continue;
+
+			SpecializationData::Entry entry;
+			entry.constantId = bit;
+			entry.offset = static_cast<uint32_t>(data.values.size() * sizeof(uint32_t));
+			entry.size = sizeof(uint32_t);   // a GLSL bool constant is a VkBool32
+			data.entries.push_back(entry);
+			data.values.push_back((key & (1u << bit)) != 0 ? 1u : 0u);
+		}
+		return data;
+	}
+
+	namespace
+	{
+		const char* GetShaderBuildSuffix(ShaderBuild build)
+		{
+			switch (build)
+			{
+			case ShaderBuild::HalfPrecision: return ".fp16";
+			case ShaderBuild::SubgroupOps:   return ".subgroup";
+			case ShaderBuild::RayQuery:      return ".rayquery";
+			default:                         return "";
+			}
+		}
+
+		bool EndsWith(const std::string& text, const std::string& suffix)
+		{
+			return text.size() >= suffix.size() &&
+				text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+		}
+	}
+
+	const char* GetShaderBuildDefine(ShaderBuild build)
+	{
+		switch (build)
+		{
+		case ShaderBuild::HalfPrecision: return "NB_HALF_PRECISION";
+		case ShaderBuild::SubgroupOps:   return "NB_SUBGROUP_OPS";
+		case ShaderBuild::RayQuery:      return "NB_RAY_QUERY";
+		default:                         return "";
+		}
+	}
+
+	std::string GetShaderBuildName(const std::string& shader, ShaderBuild build)
+	{
+		const std::string extension = ".spv";
+		if (!EndsWith(shader, extension))
+			return shader + GetShaderBuildSuffix(build);
+		return shader.substr(0, shader.size() - extension.size()) + GetShaderBuildSuffix(build) + extension;
+	}
+
+	bool HasShaderBuild(const std::string& shader, ShaderBuild build)
+	{
+		const std::string source = EndsWith(shader, ".spv") ? shader.substr(0, shader.size() - 4) : shader;
+		const size_t slash = source.find_last_of("/\\");
+		const std::string file = slash == std::string::npos ? source : source.substr(slash + 1);
+
+		// Keep in step with the lists in Editor/CMakeLists.txt
+		switch (build)
+		{
+		// Fragment-bound passes where fp16 keeps enough precision: colour
+		// and lighting terms, not positions or depths. Matches the masks above.
+		case ShaderBuild::HalfPrecision:
+			return file == "Grass.frag" || file == "PostProcess.frag";
+
+		// Compaction (ballot-aggregated appends) and the grid's histogram
+		// and prefix sum
+		case ShaderBuild::SubgroupOps:
+			return file == "GrassCull.comp" || file == "FireflyCull.comp" ||
+				file == "MeshletCull.comp" || file == "FireflyGrid.comp";
+
+		// Every fragment shader that includes shadows.glsl. Grass has no
+		// fp16 ray-query build: with both features on it shades in fp32.
+		case ShaderBuild::RayQuery:
+			return file == "Mesh.frag" || file == "MeshBindless.frag" || file == "MeshOit.frag" ||
+				file == "MeshBindlessOit.frag" || file == "Terrain.frag" || file == "Grass.frag";
+
+		default:
+			return false;
+		}
+	}
+
+	std::string SelectSubgroupShader(const std::string& shader, bool subgroupOps)
+	{
+		if (!subgroupOps || !HasShaderBuild(shader, ShaderBuild::SubgroupOps))
+			return shader;
+		return GetShaderBuildName(shader, ShaderBuild::SubgroupOps);
+	}
+
+	const char* GetShaderFeatureName(ShaderFeature feature)
+	{
+		switch (feature)
+		{
+		case ShaderFeature::ShadowPcf:    return "ShadowPcf";
+		case ShaderFeature::CascadeDebug: return "CascadeDebug";
+		case ShaderFeature::Fxaa:         return "Fxaa";
+		case ShaderFeature::Tonemap:      return "Tonemap";
+		case ShaderFeature::HalfPrecision: return "HalfPrecision";
+		case ShaderFeature::RayQueryShadow: return "RayQueryShadow";
+		default:                          return "Unknown";
+		}
+	}
+
+	std::string DescribeShaderVariant(ShaderVariantKey key)
+	{
+		std::string text;
+		for (uint32_t bit = 0; bit < static_cast<uint32_t>(ShaderFeature::Count); ++bit)
+		{
+			if ((key & (1u << bit)) == 0)
+				continue;
+			if (!text.empty())
+				text += '+';
+			text += GetShaderFeatureName(static_cast<ShaderFeature>(1u << bit));
+		}
+		return text.empty() ? "none" : text;
+	}
+}
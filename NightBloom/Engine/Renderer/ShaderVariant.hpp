@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+// ShaderVariant.hpp
+//
+// Feature toggles baked into pipelines as specialization constants instead
+// of being tested at runtime in the uber-shaders. Bit i of a
+// ShaderVariantKey is `layout(constant_id = i)` in shader_features.glsl, so
+// a pipeline built with a feature off has that branch folded away by the
+// driver's compiler.
+//
+// Each pipeline type reads only some features (GetShaderFeatureMask): its
+// variants are keyed by those bits alone, so toggling FXAA never builds new
+// Mesh pipelines.
+//
+// HalfPrecision is the exception: fp16 arithmetic needs the Float16
+// capability in the module itself, so it can't be a constant. It selects a
+// second fragment module (ShaderBuild::HalfPrecision, half_precision.glsl)
+// and is only set when the device has shaderFloat16. RayQueryShadow is the
+// same kind of feature: the ray-query shadow lookup (RayTracedShadow.hpp)
+// needs the RayQueryKHR capability, so the lit shaders have a ".rayquery"
+// build, bound only where the device has ray queries.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/PipelineInterface.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class ShaderFeature : uint32_t
+	{
+		ShadowPcf    = 1u << 0,   // 3x3 PCF shadow lookup (off: one compare tap)
+		CascadeDebug = 1u << 1,   // tint lit surfaces by shadow cascade
+		Fxaa         = 1u << 2,   // edge-aware AA in the post-process composite
+		Tonemap      = 1u << 3,   // ACES filmic tonemap (off: clamp)
+		HalfPrecision = 1u << 4,  // fp16 fragment module (not a specialization constant)
+		RayQueryShadow = 1u << 5, // sun shadow traced, not sampled from the cascades (module too)
+
+		Count = 6
+	};
+
+	using ShaderVariantKey = uint32_t;
+
+	constexpr ShaderVariantKey ToVariantBit(ShaderFeature feature)
+	{
+		return static_cast<ShaderVariantKey>(feature);
+	}
+
+	// The renderer's defaults: what a pipeline is built with before anything
+	// is toggled (and what the GLSL constants default to)
+	constexpr ShaderVariantKey DEFAULT_SHADER_VARIANT =
+		ToVariantBit(ShaderFeature::ShadowPcf) | ToVariantBit(ShaderFeature::Fxaa) |
+		ToVariantBit(ShaderFeature::Tonemap);
+
+	// Features the shaders of `type` read; 0 = the type has no variants
+	ShaderVariantKey GetShaderFeatureMask(PipelineType type);
+
+	// Features that pick a shader module rather than a constant
+	constexpr ShaderVariantKey MODULE_SHADER_FEATURES =
+		ToVariantBit(ShaderFeature::HalfPrecision) | ToVariantBit(ShaderFeature::RayQueryShadow);
+
+	// Constant data for one variant: a 32-bit bool per feature in `mask`
+	// (module features skipped), laid out for VkSpecializationInfo
+	struct SpecializationData
+	{
+		struct Entry
+		{
+			uint32_t constantId = 0;
+			uint32_t offset = 0;
+			uint32_t size = 0;
+		};
+
+		std::vector<Entry> entries;
+		std::vector<uint32_t> values;
+
+		bool IsEmpty() const { return entries.empty(); }
+	};
+
+	SpecializationData BuildSpecialization(ShaderVariantKey key, ShaderVariantKey mask);
+
+	// Second builds of a shader source, compiled again with a define, for
+	// what needs a capability in the module itself rather than a constant.
+	// Loaded as "<name>.<suffix>.spv" beside "<name>.spv".
+	enum class ShaderBuild : uint32_t
+	{
+		HalfPrecision,   // NB_HALF_PRECISION -> ".fp16" (ShaderFeature::HalfPrecision)
+		SubgroupOps,     // NB_SUBGROUP_OPS -> ".subgroup" (subgroup_ops.glsl)
+		RayQuery,        // NB_RAY_QUERY -> ".rayquery" (ShaderFeature::RayQueryShadow)
+
+		Count
+	};
+
+	const char* GetShaderBuildDefine(ShaderBuild build);
+	// "Grass.frag" -> "Grass.frag.fp16",
+	// "Shaders/Grass.frag.spv" -> "Shaders/Grass.frag.fp16.spv"
+	std::string GetShaderBuildName(const std::string& shader, ShaderBuild build);
+	// Whether the source ("Grass.frag", or its "Grass.frag.spv") has that
+	// build; the shader builds compile those a second time with the define
+	bool HasShaderBuild(const std::string& shader, ShaderBuild build);
+	// A compute shader's subgroup build when the device has the operations
+	// (SupportsFeature("subgroup_ops")) and the shader has one, else `shader`
+	std::string SelectSubgroupShader(const std::string& shader, bool subgroupOps);
+
+	const char* GetShaderFeatureName(ShaderFeature feature);
+	// "ShadowPcf+Tonemap", or "none"
+	std::string DescribeShaderVariant(ShaderVariantKey key);
+}
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+// SparsePageTable.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/SparsePageTable.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		uint32_t DivideRoundUp(uint32_t value, uint32_t divisor)
+		{
+			return (value + divisor - 1) / divisor;
+		}
+	}
+
+	void SparsePageTable::Reset(uint32_t width, uint32_t height, uint32_t depth,
+		uint32_t pageWidth, uint32_t pageHeight, uint32_t pageDepth)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_Depth = std::max(depth, 1u);
+		m_PageWidth = std::max(pageWidth, 1u);
+		m_PageHeight = std::max(pageHeight, 1u);
+		m_PageDepth = std::max(pageDepth, 1u);
+		m_PagesX = DivideRoundUp(m_Width, m_PageWidth);
+		m_PagesY = DivideRoundUp(m_Height, m_PageHeight);
+		m_PagesZ = DivideRoundUp(m_Depth, m_PageDepth);
+
+		const size_t count = static_cast<size_t>(m_PagesX) * m_PagesY * m_PagesZ;
+		m_Resident.assign(count, false);
+		m_Requested.assign(count, false);
+		m_ResidentCount = 0;
+	}
+
+	void SparsePageTable::Request(const Box& texels)
+	{
+		if (texels.x >= m_Width || texels.y >= m_Height || texels.z >= m_Depth
+			|| texels.width == 0 || texels.height == 0 || texels.depth == 0)
+		{
+			return;
+		}
+
+		const uint32_t lastX = std::min(texels.x + texels.width, m_Width) - 1;
+		const uint32_t lastY = std::min(texels.y + texels.height, m_Height) - 1;
+		const uint32_t lastZ = std::min(texels.z + texels.depth, m_Depth) - 1;
+		for (uint32_t z = texels.z / m_PageDepth; z <= lastZ / m_PageDepth; ++z)
+			for (uint32_t y = texels.y / m_PageHeight; y <= lastY / m_PageHeight; ++y)
+				for (uint32_t x = texels.x / m_PageWidth; x <= lastX / m_PageWidth; ++x)
+					m_Requested[(static_cast<size_t>(z) * m_PagesY + y) * m_PagesX + x] = true;
+	}
+
+	void SparsePageTable::RequestAll()
+	{
+		std::fill(m_Requested.begin(), m_Requested.end(), true);
+	}
+
+	void SparsePageTable::Commit(std::vector<uint32_t>& bind, std::vector<uint32_t>& release)
+	{
+		bind.clear();
+		release.clear();
+		for (uint32_t page = 0; page < GetPageCount(); ++page)
+		{
+			if (m_Requested[page] && !m_Resident[page])
+				bind.push_back(page);
+			else if (!m_Requested[page] && m_Resident[page])
+				release.push_back(page);
+		}
+
+		m_Resident.swap(m_Requested);
+		std::fill(m_Requested.begin(), m_Requested.end(), false);
+		m_ResidentCount = static_cast<uint32_t>(std::count(m_Resident.begin(), m_Resident.end(), true));
+	}
+
+	void SparsePageTable::MarkUnbound(uint32_t page)
+	{
+		if (IsResident(page))
+		{
+			m_Resident[page] = false;
+			--m_ResidentCount;
+		}
+	}
+
+	SparsePageTable::Box SparsePageTable::GetPageBox(uint32_t page) const
+	{
+		Box box;
+		if (page >= GetPageCount())
+			return box;
+
+		const uint32_t x = page % m_PagesX;
+		const uint32_t y = (page / m_PagesX) % m_PagesY;
+		const uint32_t z = page / (m_PagesX * m_PagesY);
+		box.x = x * m_PageWidth;
+		box.y = y * m_PageHeight;
+		box.z = z * m_PageDepth;
+		box.width = std::min(m_PageWidth, m_Width - box.x);
+		box.height = std::min(m_PageHeight, m_Height - box.y);
+		box.depth = std::min(m_PageDepth, m_Depth - box.z);
+		return box;
+	}
+}
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// SparsePageTable.hpp
+//
+// Which pages of a partially resident (sparse) image have memory behind
+// them. The image's first mip is cut into pages of the device's sparse block
+// size. Each frame the owner requests the texel boxes it is about to write
+// or sample, and Commit returns the pages to bind (requested, not resident)
+// and to release (resident, not requested this time). Whatever was not
+// requested loses its contents.
+//
+// VulkanMemoryManager::CommitSparseResidency applies a commit on the GPU;
+// VulkanTexture::GetSparsePages hands out a sparse texture's table.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class SparsePageTable
+	{
+	public:
+		// Texel offset and size; a page's box is clipped to the image edge
+		struct Box
+		{
+			uint32_t x = 0, y = 0, z = 0;
+			uint32_t width = 0, height = 0, depth = 1;
+		};
+
+		SparsePageTable() = default;
+
+		// Nothing resident or requested afterwards
+		void Reset(uint32_t width, uint32_t height, uint32_t depth,
+			uint32_t pageWidth, uint32_t pageHeight, uint32_t pageDepth);
+
+		// Every page overlapping `texels` (clipped to the image) stays or becomes resident
+		void Request(const Box& texels);
+		void RequestAll();
+
+		// Requested pages that aren't resident go to `bind`, resident ones
+		// that weren't requested to `release` (both sorted, replacing their
+		// contents). The requested set becomes the resident one, and the
+		// requests start over.
+		void Commit(std::vector<uint32_t>& bind, std::vector<uint32_t>& release);
+		// A committed page that could not be bound (no memory): not
+		// resident, so the next commit binds it again if still requested
+		void MarkUnbound(uint32_t page);
+
+		bool IsResident(uint32_t page) const { return page < m_Resident.size() && m_Resident[page]; }
+		Box GetPageBox(uint32_t page) const;
+
+		uint32_t GetPageCount() const { return static_cast<uint32_t>(m_Resident.size()); }
+		uint32_t GetResidentCount() const { return m_ResidentCount; }
+		uint32_t GetPagesX() const { return m_PagesX; }
+		uint32_t GetPagesY() const { return m_PagesY; }
+		uint32_t GetPagesZ() const { return m_PagesZ; }
+
+	private:
+		uint32_t m_Width = 0, m_Height = 0, m_Depth = 0;
+		uint32_t m_PageWidth = 1, m_PageHeight = 1, m_PageDepth = 1;
+		uint32_t m_PagesX = 0, m_PagesY = 0, m_PagesZ = 0;
+
+		std::vector<bool> m_Resident;
+		std::vector<bool> m_Requested;
+		uint32_t m_ResidentCount = 0;
+	};
+}
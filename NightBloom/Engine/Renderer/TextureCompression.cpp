@@ -0,0 +1,686 @@
+//------------------------------------------------------------------------------
+// TextureCompression.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/TextureCompression.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		using Texels = std::array<uint8_t, 64>;   // 4x4 RGBA8
+
+		constexpr std::array<int, 16> BC7_WEIGHTS4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// Edge blocks clamp, so the padding texels repeat real ones and don't
+		// pull the endpoints away from the visible part
+		void FetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, Texels& out)
+		{
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				const uint32_t sy = std::min(by * 4 + y, height - 1);
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					const uint32_t sx = std::min(bx * 4 + x, width - 1);
+					std::memcpy(&out[(y * 4 + x) * 4], rgba + (size_t(sy) * width + sx) * 4, 4);
+				}
+			}
+		}
+
+		void StoreBlock(uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, const Texels& in)
+		{
+			for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+				for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+					std::memcpy(rgba + (size_t(by * 4 + y) * width + bx * 4 + x) * 4, &in[(y * 4 + x) * 4], 4);
+		}
+
+		// Principal axis of the block's colours (first `channels` components)
+		// by power iteration on the covariance matrix
+		void PrincipalAxis(const Texels& texels, int channels, float mean[4], float axis[4])
+		{
+			for (int c = 0; c < 4; ++c)
+				mean[c] = 0.0f;
+			for (int i = 0; i < 16; ++i)
+				for (int c = 0; c < channels; ++c)
+					mean[c] += texels[i * 4 + c] / 16.0f;
+
+			float cov[4][4] = {};
+			for (int i = 0; i < 16; ++i)
+			{
+				float d[4] = {};
+				for (int c = 0; c < channels; ++c)
+					d[c] = texels[i * 4 + c] - mean[c];
+				for (int r = 0; r < channels; ++r)
+					for (int c = 0; c < channels; ++c)
+						cov[r][c] += d[r] * d[c];
+			}
+
+			for (int c = 0; c < 4; ++c)
+				axis[c] = c < channels ? 1.0f : 0.0f;
+			for (int iteration = 0; iteration < 8; ++iteration)
+			{
+				float next[4] = {};
+				for (int r = 0; r < channels; ++r)
+					for (int c = 0; c < channels; ++c)
+						next[r] += cov[r][c] * axis[c];
+
+				float length = 0.0f;
+				for (int c = 0; c < channels; ++c)
+					length = std::max(length, std::abs(next[c]));
+				if (length < 1e-6f)
+					break;   // flat block: any axis will do
+				for (int c = 0; c < channels; ++c)
+					axis[c] = next[c] / length;
+			}
+
+			// Unit length, so projections are distances along the axis
+			float length = 0.0f;
+			for (int c = 0; c < channels; ++c)
+				length += axis[c] * axis[c];
+			length = std::sqrt(length);
+			for (int c = 0; c < channels; ++c)
+				axis[c] /= length;
+		}
+
+		// Least-squares endpoints for fixed interpolation weights t_i in [0,1]
+		bool SolveEndpoints(const Texels& texels, int channels, const float* weights, float e0[4], float e1[4])
+		{
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			float ax[4] = {}, bx[4] = {};
+			for (int i = 0; i < 16; ++i)
+			{
+				const float b = weights[i];
+				const float a = 1.0f - b;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				for (int c = 0; c < channels; ++c)
+				{
+					ax[c] += a * texels[i * 4 + c];
+					bx[c] += b * texels[i * 4 + c];
+				}
+			}
+
+			const float det = aa * bb - ab * ab;
+			if (std::abs(det) < 1e-6f)
+				return false;
+			for (int c = 0; c < channels; ++c)
+			{
+				e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+				e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+			}
+			return true;
+		}
+
+		// --- BC1 -------------------------------------------------------------
+
+		uint16_t To565(const float c[4])
+		{
+			const int r = static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f);
+			const int g = static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f);
+			const int b = static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f);
+			return static_cast<uint16_t>((std::clamp(r, 0, 31) << 11) | (std::clamp(g, 0, 63) << 5) | std::clamp(b, 0, 31));
+		}
+
+		void From565(uint16_t c, int out[3])
+		{
+			const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+			out[0] = (r << 3) | (r >> 2);
+			out[1] = (g << 2) | (g >> 4);
+			out[2] = (b << 3) | (b >> 2);
+		}
+
+		void BC1Palette(uint16_t c0, uint16_t c1, int palette[4][3])
+		{
+			From565(c0, palette[0]);
+			From565(c1, palette[1]);
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+		}
+
+		// Picks indices for fixed endpoints; returns the squared error
+		int BC1Indices(const Texels& texels, uint16_t c0, uint16_t c1, uint8_t indices[16])
+		{
+			int palette[4][3];
+			BC1Palette(c0, c1, palette);
+
+			int total = 0;
+			for (int i = 0; i < 16; ++i)
+			{
+				int best = std::numeric_limits<int>::max();
+				for (int p = 0; p < 4; ++p)
+				{
+					int error = 0;
+					for (int c = 0; c < 3; ++c)
+					{
+						const int d = texels[i * 4 + c] - palette[p][c];
+						error += d * d;
+					}
+					if (error < best)
+					{
+						best = error;
+						indices[i] = static_cast<uint8_t>(p);
+					}
+				}
+				total += best;
+			}
+			return total;
+		}
+
+		void EncodeBC1(const Texels& texels, uint8_t* out)
+		{
+			float mean[4], axis[4];
+			PrincipalAxis(texels, 3, mean, axis);
+
+			float tMin = std::numeric_limits<float>::max(), tMax = -tMin;
+			for (int i = 0; i < 16; ++i)
+			{
+				float t = 0.0f;
+				for (int c = 0; c < 3; ++c)
+					t += (texels[i * 4 + c] - mean[c]) * axis[c];
+				tMin = std::min(tMin, t);
+				tMax = std::max(tMax, t);
+			}
+
+			float e0[4] = {}, e1[4] = {};
+			for (int c = 0; c < 3; ++c)
+			{
+				e0[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+				e1[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+			}
+
+			uint16_t c0 = To565(e0), c1 = To565(e1);
+			uint8_t indices[16];
+			int error = BC1Indices(texels, c0, c1, indices);
+
+			// One least-squares pass over the chosen indices
+			static constexpr float WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+			float weights[16];
+			for (int i = 0; i < 16; ++i)
+				weights[i] = WEIGHTS[indices[i]];
+			if (SolveEndpoints(texels, 3, weights, e0, e1))
+			{
+				const uint16_t r0 = To565(e0), r1 = To565(e1);
+				uint8_t refined[16];
+				const int refinedError = BC1Indices(texels, r0, r1, refined);
+				if (refinedError < error)
+				{
+					c0 = r0;
+					c1 = r1;
+					error = refinedError;
+					std::memcpy(indices, refined, sizeof(indices));
+				}
+			}
+
+			// c0 > c1 selects the opaque four-colour mode; swapping the
+			// endpoints mirrors the palette (0<->1, 2<->3)
+			if (c0 < c1)
+			{
+				std::swap(c0, c1);
+				for (uint8_t& index : indices)
+					index ^= 1;
+			}
+			else if (c0 == c1)
+			{
+				std::memset(indices, 0, sizeof(indices));
+			}
+
+			uint32_t bits = 0;
+			for (int i = 0; i < 16; ++i)
+				bits |= uint32_t(indices[i]) << (i * 2);
+			std::memcpy(out, &c0, 2);
+			std::memcpy(out + 2, &c1, 2);
+			std::memcpy(out + 4, &bits, 4);
+		}
+
+		void DecodeBC1(const uint8_t* in, Texels& texels)
+		{
+			uint16_t c0, c1;
+			uint32_t bits;
+			std::memcpy(&c0, in, 2);
+			std::memcpy(&c1, in + 2, 2);
+			std::memcpy(&bits, in + 4, 4);
+
+			int palette[4][3];
+			BC1Palette(c0, c1, palette);
+			const bool opaque = c0 > c1;
+			if (!opaque)
+			{
+				// Three-colour mode: midpoint and transparent black
+				for (int c = 0; c < 3; ++c)
+				{
+					palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+					palette[3][c] = 0;
+				}
+			}
+
+			for (int i = 0; i < 16; ++i)
+			{
+				const uint32_t index = (bits >> (i * 2)) & 3;
+				for (int c = 0; c < 3; ++c)
+					texels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+				texels[i * 4 + 3] = (!opaque && index == 3) ? 0 : 255;
+			}
+		}
+
+		// --- BC4 / BC5 -------------------------------------------------------
+
+		void BC4Palette(int r0, int r1, int palette[8])
+		{
+			palette[0] = r0;
+			palette[1] = r1;
+			if (r0 > r1)
+			{
+				for (int i = 2; i < 8; ++i)
+					palette[i] = ((8 - i) * r0 + (i - 1) * r1) / 7;
+			}
+			else
+			{
+				for (int i = 2; i < 6; ++i)
+					palette[i] = ((6 - i) * r0 + (i - 1) * r1) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		void EncodeBC4(const Texels& texels, int channel, uint8_t* out)
+		{
+			int lo = 255, hi = 0;
+			for (int i = 0; i < 16; ++i)
+			{
+				lo = std::min<int>(lo, texels[i * 4 + channel]);
+				hi = std::max<int>(hi, texels[i * 4 + channel]);
+			}
+
+			// hi > lo selects the eight-level mode; a flat block is all index 0
+			int palette[8];
+			BC4Palette(hi, lo, palette);
+
+			uint64_t bits = 0;
+			if (hi != lo)
+			{
+				for (int i = 0; i < 16; ++i)
+				{
+					const int value = texels[i * 4 + channel];
+					int bestIndex = 0, best = std::numeric_limits<int>::max();
+					for (int p = 0; p < 8; ++p)
+					{
+						const int error = std::abs(value - palette[p]);
+						if (error < best)
+						{
+							best = error;
+							bestIndex = p;
+						}
+					}
+					bits |= uint64_t(bestIndex) << (i * 3);
+				}
+			}
+
+			out[0] = static_cast<uint8_t>(hi);
+			out[1] = static_cast<uint8_t>(lo);
+			for (int b = 0; b < 6; ++b)
+				out[2 + b] = static_cast<uint8_t>(bits >> (b * 8));
+		}
+
+		void DecodeBC4(const uint8_t* in, int channel, Texels& texels)
+		{
+			int palette[8];
+			BC4Palette(in[0], in[1], palette);
+
+			uint64_t bits = 0;
+			for (int b = 0; b < 6; ++b)
+				bits |= uint64_t(in[2 + b]) << (b * 8);
+			for (int i = 0; i < 16; ++i)
+				texels[i * 4 + channel] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+		}
+
+		// --- BC7 (mode 6) ----------------------------------------------------
+
+		struct BitWriter
+		{
+			uint8_t* out;
+			uint32_t position = 0;
+
+			void Write(uint32_t value, uint32_t count)
+			{
+				for (uint32_t i = 0; i < count; ++i, ++position)
+					if (value & (1u << i))
+						out[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+			}
+		};
+
+		struct BitReader
+		{
+			const uint8_t* in;
+			uint32_t position = 0;
+
+			uint32_t Read(uint32_t count)
+			{
+				uint32_t value = 0;
+				for (uint32_t i = 0; i < count; ++i, ++position)
+					value |= uint32_t((in[position >> 3] >> (position & 7)) & 1) << i;
+				return value;
+			}
+		};
+
+		// 7-bit colour plus a shared p-bit per endpoint
+		struct Mode6Endpoint
+		{
+			uint8_t color[4];
+			uint8_t pbit;
+
+			int Expand(int c) const { return (color[c] << 1) | pbit; }
+		};
+
+		Mode6Endpoint QuantizeMode6(const float value[4], uint8_t pbit)
+		{
+			Mode6Endpoint endpoint{};
+			endpoint.pbit = pbit;
+			for (int c = 0; c < 4; ++c)
+				endpoint.color[c] = static_cast<uint8_t>(std::clamp(static_cast<int>((value[c] - pbit) / 2.0f + 0.5f), 0, 127));
+			return endpoint;
+		}
+
+		int Mode6Interpolate(int e0, int e1, int index)
+		{
+			return ((64 - BC7_WEIGHTS4[index]) * e0 + BC7_WEIGHTS4[index] * e1 + 32) >> 6;
+		}
+
+		int Mode6Indices(const Texels& texels, const Mode6Endpoint& e0, const Mode6Endpoint& e1, uint8_t indices[16])
+		{
+			int palette[16][4];
+			for (int p = 0; p < 16; ++p)
+				for (int c = 0; c < 4; ++c)
+					palette[p][c] = Mode6Interpolate(e0.Expand(c), e1.Expand(c), p);
+
+			int total = 0;
+			for (int i = 0; i < 16; ++i)
+			{
+				int best = std::numeric_limits<int>::max();
+				for (int p = 0; p < 16; ++p)
+				{
+					int error = 0;
+					for (int c = 0; c < 4; ++c)
+					{
+						const int d = texels[i * 4 + c] - palette[p][c];
+						error += d * d;
+					}
+					if (error < best)
+					{
+						best = error;
+						indices[i] = static_cast<uint8_t>(p);
+					}
+				}
+				total += best;
+			}
+			return total;
+		}
+
+		// Quantises both endpoints under each of the four p-bit pairs and
+		// keeps the pair (and indices) with the lowest block error
+		int QuantizeMode6Pair(const Texels& texels, const float f0[4], const float f1[4],
+			Mode6Endpoint& e0, Mode6Endpoint& e1, uint8_t indices[16])
+		{
+			int bestError = std::numeric_limits<int>::max();
+			for (uint8_t pbits = 0; pbits < 4; ++pbits)
+			{
+				const Mode6Endpoint q0 = QuantizeMode6(f0, pbits & 1), q1 = QuantizeMode6(f1, pbits >> 1);
+				uint8_t candidate[16];
+				const int error = Mode6Indices(texels, q0, q1, candidate);
+				if (error < bestError)
+				{
+					bestError = error;
+					e0 = q0;
+					e1 = q1;
+					std::memcpy(indices, candidate, sizeof(candidate));
+				}
+			}
+			return bestError;
+		}
+
+		void EncodeBC7(const Texels& texels, uint8_t* out)
+		{
+			float mean[4], axis[4];
+			PrincipalAxis(texels, 4, mean, axis);
+
+			float tMin = std::numeric_limits<float>::max(), tMax = -tMin;
+			for (int i = 0; i < 16; ++i)
+			{
+				float t = 0.0f;
+				for (int c = 0; c < 4; ++c)
+					t += (texels[i * 4 + c] - mean[c]) * axis[c];
+				tMin = std::min(tMin, t);
+				tMax = std::max(tMax, t);
+			}
+
+			float f0[4], f1[4];
+			for (int c = 0; c < 4; ++c)
+			{
+				f0[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+				f1[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+			}
+
+			Mode6Endpoint e0{}, e1{};
+			uint8_t indices[16];
+			int error = QuantizeMode6Pair(texels, f0, f1, e0, e1, indices);
+
+			// Least-squares refinement; stops as soon as it stops helping
+			for (int iteration = 0; iteration < 2 && error > 0; ++iteration)
+			{
+				float weights[16];
+				for (int i = 0; i < 16; ++i)
+					weights[i] = BC7_WEIGHTS4[indices[i]] / 64.0f;
+				if (!SolveEndpoints(texels, 4, weights, f0, f1))
+					break;
+
+				Mode6Endpoint r0{}, r1{};
+				uint8_t refined[16];
+				const int refinedError = QuantizeMode6Pair(texels, f0, f1, r0, r1, refined);
+				if (refinedError >= error)
+					break;
+				e0 = r0;
+				e1 = r1;
+				error = refinedError;
+				std::memcpy(indices, refined, sizeof(indices));
+			}
+
+			// The anchor (texel 0) index is stored without its top bit; the
+			// weight table is symmetric, so swapping endpoints flips it to 15-i
+			if (indices[0] >= 8)
+			{
+				std::swap(e0, e1);
+				for (uint8_t& index : indices)
+					index = static_cast<uint8_t>(15 - index);
+			}
+
+			std::memset(out, 0, 16);
+			BitWriter writer{ out };
+			writer.Write(1u << 6, 7);   // mode 6
+			for (int c = 0; c < 4; ++c)
+			{
+				writer.Write(e0.color[c], 7);
+				writer.Write(e1.color[c], 7);
+			}
+			writer.Write(e0.pbit, 1);
+			writer.Write(e1.pbit, 1);
+			writer.Write(indices[0], 3);
+			for (int i = 1; i < 16; ++i)
+				writer.Write(indices[i], 4);
+		}
+
+		void DecodeBC7(const uint8_t* in, Texels& texels)
+		{
+			if ((in[0] & 0x7F) != 0x40)
+			{
+				texels.fill(0);   // not mode 6
+				return;
+			}
+
+			BitReader reader{ in, 7 };
+			Mode6Endpoint e0{}, e1{};
+			for (int c = 0; c < 4; ++c)
+			{
+				e0.color[c] = static_cast<uint8_t>(reader.Read(7));
+				e1.color[c] = static_cast<uint8_t>(reader.Read(7));
+			}
+			e0.pbit = static_cast<uint8_t>(reader.Read(1));
+			e1.pbit = static_cast<uint8_t>(reader.Read(1));
+
+			for (int i = 0; i < 16; ++i)
+			{
+				const int index = static_cast<int>(reader.Read(i == 0 ? 3 : 4));
+				for (int c = 0; c < 4; ++c)
+					texels[i * 4 + c] = static_cast<uint8_t>(Mode6Interpolate(e0.Expand(c), e1.Expand(c), index));
+			}
+		}
+	}
+
+	uint32_t GetBlockBytes(BlockFormat format)
+	{
+		return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8u : 16u;
+	}
+
+	size_t GetCompressedSize(BlockFormat format, uint32_t width, uint32_t height)
+	{
+		return size_t((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(format);
+	}
+
+	std::vector<uint8_t> CompressImage(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height)
+	{
+		std::vector<uint8_t> blocks(GetCompressedSize(format, width, height));
+		if (!rgba || width == 0 || height == 0)
+			return blocks;
+
+		const uint32_t blockBytes = GetBlockBytes(format);
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		Texels texels;
+		uint8_t* out = blocks.data();
+		for (uint32_t by = 0; by < blocksY; ++by)
+		{
+			for (uint32_t bx = 0; bx < blocksX; ++bx, out += blockBytes)
+			{
+				FetchBlock(rgba, width, height, bx, by, texels);
+				switch (format)
+				{
+				case BlockFormat::BC1: EncodeBC1(texels, out); break;
+				case BlockFormat::BC4: EncodeBC4(texels, 0, out); break;
+				case BlockFormat::BC5:
+					EncodeBC4(texels, 0, out);
+					EncodeBC4(texels, 1, out + 8);
+					break;
+				case BlockFormat::BC7: EncodeBC7(texels, out); break;
+				}
+			}
+		}
+		return blocks;
+	}
+
+	std::vector<uint8_t> DecompressImage(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height)
+	{
+		std::vector<uint8_t> rgba(size_t(width) * height * 4);
+		if (!blocks || rgba.empty())
+			return rgba;
+
+		const uint32_t blockBytes = GetBlockBytes(format);
+		const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+		Texels texels;
+		const uint8_t* in = blocks;
+		for (uint32_t by = 0; by < blocksY; ++by)
+		{
+			for (uint32_t bx = 0; bx < blocksX; ++bx, in += blockBytes)
+			{
+				switch (format)
+				{
+				case BlockFormat::BC1:
+					DecodeBC1(in, texels);
+					break;
+				case BlockFormat::BC4:
+					DecodeBC4(in, 0, texels);
+					for (int i = 0; i < 16; ++i)
+					{
+						texels[i * 4 + 1] = texels[i * 4 + 2] = texels[i * 4];
+						texels[i * 4 + 3] = 255;
+					}
+					break;
+				case BlockFormat::BC5:
+					DecodeBC4(in, 0, texels);
+					DecodeBC4(in + 8, 1, texels);
+					for (int i = 0; i < 16; ++i)
+					{
+						texels[i * 4 + 2] = 0;
+						texels[i * 4 + 3] = 255;
+					}
+					break;
+				case BlockFormat::BC7:
+					DecodeBC7(in, texels);
+					break;
+				}
+				StoreBlock(rgba.data(), width, height, bx, by, texels);
+			}
+		}
+		return rgba;
+	}
+
+	std::vector<ImageData> BuildMipChain(const ImageData& base, bool normalMap)
+	{
+		std::vector<ImageData> levels;
+		if (base.pixels.empty() || base.width == 0 || base.height == 0)
+			return levels;
+
+		levels.push_back(base);
+		while (levels.back().width > 1 || levels.back().height > 1)
+		{
+			const ImageData& src = levels.back();
+			ImageData dst;
+			dst.width = std::max(1u, src.width / 2);
+			dst.height = std::max(1u, src.height / 2);
+			dst.channels = 4;
+			dst.pixelSize = 4;
+			dst.pixels.resize(size_t(dst.width) * dst.height * 4);
+
+			for (uint32_t y = 0; y < dst.height; ++y)
+			{
+				const uint32_t y0 = std::min(y * 2, src.height - 1), y1 = std::min(y * 2 + 1, src.height - 1);
+				for (uint32_t x = 0; x < dst.width; ++x)
+				{
+					const uint32_t x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+					const uint8_t* taps[4] = {
+						&src.pixels[(size_t(y0) * src.width + x0) * 4], &src.pixels[(size_t(y0) * src.width + x1) * 4],
+						&src.pixels[(size_t(y1) * src.width + x0) * 4], &src.pixels[(size_t(y1) * src.width + x1) * 4] };
+
+					float sum[4] = {};
+					for (const uint8_t* tap : taps)
+						for (int c = 0; c < 4; ++c)
+							sum[c] += normalMap && c < 3 ? tap[c] / 127.5f - 1.0f : float(tap[c]);
+
+					uint8_t* out = &dst.pixels[(size_t(y) * dst.width + x) * 4];
+					if (normalMap)
+					{
+						const float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+						for (int c = 0; c < 3; ++c)
+						{
+							const float n = length > 1e-6f ? sum[c] / length : (c == 2 ? 1.0f : 0.0f);
+							out[c] = static_cast<uint8_t>(std::clamp((n + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f));
+						}
+					}
+					else
+					{
+						for (int c = 0; c < 3; ++c)
+							out[c] = static_cast<uint8_t>((sum[c] + 2.0f) / 4.0f);
+					}
+					out[3] = static_cast<uint8_t>((sum[3] + 2.0f) / 4.0f);
+				}
+			}
+			levels.push_back(std::move(dst));
+		}
+		return levels;
+	}
+}
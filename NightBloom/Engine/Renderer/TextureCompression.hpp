@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+// TextureCompression.hpp
+//
+// CPU block compression for the offline texture cooker (TextureCooker.hpp).
+// Every format works on 4x4 texel blocks:
+//   BC1  8 bytes  RGB, 565 endpoints + 2-bit indices (opaque mode only)
+//   BC4  8 bytes  one channel, 8-bit endpoints + 3-bit indices
+//   BC5 16 bytes  two BC4 blocks (R, G) - tangent-space normal XY
+//   BC7 16 bytes  RGBA, always mode 6 (one subset, 7.7.7.7 endpoints with a
+//                 p-bit each, 4-bit indices)
+// Mode 6 alone is well short of what a full BC7 search reaches, but it is
+// close on smooth albedo and orders of magnitude faster. The decoders cover
+// exactly what the encoders emit (BC7: mode 6 only).
+//
+// Also builds the box-filtered mip chain the cooker stores alongside.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/TextureLoader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	enum class BlockFormat : uint8_t
+	{
+		BC1,
+		BC4,
+		BC5,
+		BC7
+	};
+
+	// 8 or 16
+	uint32_t GetBlockBytes(BlockFormat format);
+
+	// Bytes for a width x height image; partial edge blocks round up
+	size_t GetCompressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+	// rgba is tightly packed RGBA8. Edge blocks repeat the last row/column.
+	std::vector<uint8_t> CompressImage(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height);
+
+	// Back to RGBA8 (BC4: R replicated to RGB; BC5: B = 0). Channels a
+	// format doesn't store come back as 255 alpha.
+	std::vector<uint8_t> DecompressImage(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height);
+
+	// Level 0 is a copy of base (which must be RGBA8); each further level
+	// halves both sides (down to 1x1) with a 2x2 box filter. For normal maps
+	// the averaged vectors are renormalised, so lower mips stay unit length.
+	std::vector<ImageData> BuildMipChain(const ImageData& base, bool normalMap);
+}
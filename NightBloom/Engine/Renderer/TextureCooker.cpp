@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+// TextureCooker.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/TextureCooker.hpp"
+#include "Engine/Renderer/Ktx2.hpp"
+#include "Engine/Renderer/TextureCompression.hpp"
+#include "Engine/Renderer/TextureLoader.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		std::string ToLower(std::string value)
+		{
+			std::transform(value.begin(), value.end(), value.begin(),
+				[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return value;
+		}
+
+		bool IsSourceImage(const std::filesystem::path& path)
+		{
+			const std::string extension = ToLower(path.extension().string());
+			return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+				extension == ".tga" || extension == ".bmp";
+		}
+	}
+
+	TextureKind GuessTextureKind(const std::string& sourcePath)
+	{
+		const std::string name = ToLower(std::filesystem::path(sourcePath).stem().string());
+		return name.find("normal") != std::string::npos ? TextureKind::Normal : TextureKind::Albedo;
+	}
+
+	std::string GetCookedTexturePath(const std::string& sourcePath)
+	{
+		return std::filesystem::path(sourcePath).replace_extension(".ktx2").string();
+	}
+
+	bool IsCookedTextureCurrent(const std::string& sourcePath, const std::string& cookedPath)
+	{
+		std::error_code ec;
+		const auto cookedTime = std::filesystem::last_write_time(cookedPath, ec);
+		if (ec)
+			return false;
+		const auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+		return ec || sourceTime <= cookedTime;   // no source: the cooked file is all there is
+	}
+
+	bool CookTexture(const std::string& sourcePath, const std::string& cookedPath, TextureKind kind)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		ImageData image = TextureLoader::LoadImageRGBA(sourcePath);
+		if (image.pixels.empty() || image.isHDR)
+		{
+			LOG_ERROR("Cannot cook '{}': {}", sourcePath, image.isHDR ? "HDR sources are not supported" : "failed to load");
+			return false;
+		}
+
+		const BlockFormat blockFormat = kind == TextureKind::Normal ? BlockFormat::BC5 : BlockFormat::BC7;
+		const uint32_t vkFormat = kind == TextureKind::Normal ? Ktx2Format::BC5_UNORM : Ktx2Format::BC7_UNORM;
+
+		std::vector<std::vector<uint8_t>> levels;
+		for (const ImageData& mip : BuildMipChain(image, kind == TextureKind::Normal))
+			levels.push_back(CompressImage(blockFormat, mip.pixels.data(), mip.width, mip.height));
+
+		if (!WriteKtx2(cookedPath, vkFormat, image.width, image.height, levels))
+		{
+			LOG_ERROR("Failed to write cooked texture '{}'", cookedPath);
+			return false;
+		}
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start);
+		LOG_INFO("Cooked '{}' -> {} ({}x{}, {} mips, {:.1f} ms)", sourcePath,
+			kind == TextureKind::Normal ? "BC5" : "BC7", image.width, image.height, levels.size(), elapsed.count());
+		return true;
+	}
+
+	TextureCookStats CookTextureDirectory(const std::string& directory, bool force)
+	{
+		TextureCookStats stats;
+
+		std::error_code ec;
+		for (auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+			!ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+		{
+			if (!it->is_regular_file() || !IsSourceImage(it->path()))
+				continue;
+
+			const std::string source = it->path().string();
+			const std::string cooked = GetCookedTexturePath(source);
+			if (!force && IsCookedTextureCurrent(source, cooked))
+			{
+				++stats.upToDate;
+				continue;
+			}
+
+			if (CookTexture(source, cooked, GuessTextureKind(source)))
+				++stats.cooked;
+			else
+				++stats.failed;
+		}
+
+		if (ec)
+			LOG_ERROR("Failed to scan '{}' for textures: {}", directory, ec.message());
+		return stats;
+	}
+}
@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+// TextureCooker.hpp
+//
+// Offline conversion of PNG/JPG/TGA/BMP sources into GPU-ready KTX2 files
+// (Ktx2.hpp) with a full precomputed mip chain:
+//   Albedo  BC7, 1 byte per texel (RGBA8 is 4)
+//   Normal  BC5, tangent-space XY; Z is reconstructed when sampled
+// The cooked file sits next to its source with a .ktx2 extension, which is
+// where ResourceManager::LoadTexture looks first.
+//
+// Driven by the NightbloomTextureCooker tool (Tools/TextureCooker) as an
+// asset build step; the engine itself never cooks at runtime.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Nightbloom
+{
+	enum class TextureKind : uint8_t
+	{
+		Albedo,
+		Normal
+	};
+
+	// Normal when the file name contains "normal" (any case), else Albedo
+	TextureKind GuessTextureKind(const std::string& sourcePath);
+
+	// <source without extension>.ktx2
+	std::string GetCookedTexturePath(const std::string& sourcePath);
+
+	// True when the cooked file exists and is at least as new as the source
+	bool IsCookedTextureCurrent(const std::string& sourcePath, const std::string& cookedPath);
+
+	bool CookTexture(const std::string& sourcePath, const std::string& cookedPath, TextureKind kind);
+
+	struct TextureCookStats
+	{
+		uint32_t cooked = 0;
+		uint32_t upToDate = 0;
+		uint32_t failed = 0;
+	};
+
+	// Cooks every source image under directory (recursively) whose .ktx2 is
+	// missing or older than it; force re-cooks everything
+	TextureCookStats CookTextureDirectory(const std::string& directory, bool force = false);
+}
@@ -5,6 +5,8 @@
 //------------------------------------------------------------------------------
 
 #include "Engine/Renderer/TextureLoader.hpp"
+#include "Engine/Renderer/TextureCompression.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -22,10 +24,21 @@ namespace Nightbloom
 		int width, height, channels;
 		int desiredChannels = forceRGBA ? STBI_rgb_alpha : STBI_default;
 
+		// stb decodes straight out of the mapping (the archive's or the
+		// file's): one open, no stdio copy
+		const AssetFile file = AssetManager::Get().OpenAsset(filepath);
+		if (!file.IsOpen() || file.GetSize() > static_cast<size_t>(INT32_MAX))
+		{
+			LOG_ERROR("Failed to load image: {} - can't map the file", filepath);
+			return data;
+		}
+		const stbi_uc* bytes = file.GetData();
+		const int size = static_cast<int>(file.GetSize());
+
 		// Check if HDR
-		if (stbi_is_hdr(filepath.c_str()))
+		if (stbi_is_hdr_from_memory(bytes, size))
 		{
-			float* pixels = stbi_loadf(filepath.c_str(), &width, &height, &channels, desiredChannels);
+			float* pixels = stbi_loadf_from_memory(bytes, size, &width, &height, &channels, desiredChannels);
 			if (pixels)
 			{
 				data.isHDR = true;
@@ -50,7 +63,7 @@ namespace Nightbloom
 		else
 		{
 			// Load LDR image
-			unsigned char* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, desiredChannels);
+			unsigned char* pixels = stbi_load_from_memory(bytes, size, &width, &height, &channels, desiredChannels);
 			if (pixels)
 			{
 				data.isHDR = false;
@@ -87,16 +100,21 @@ namespace Nightbloom
 
 	bool TextureLoader::GenerateMipmaps(ImageData& data)
 	{
-		// Simple box filter mipmap generation
-		// This is a basic implementation - could be improved with better filtering
-		if (data.pixels.empty() || data.isHDR)
+		if (data.pixels.empty() || data.isHDR || data.pixelSize != 4)
 		{
-			LOG_WARN("Cannot generate mipmaps for empty or HDR image");
+			LOG_WARN("Cannot generate mipmaps for empty, HDR or non-RGBA8 image");
 			return false;
 		}
+		if (!data.mipOffsets.empty())
+			return true;   // already has its chain
 
-		// For now, just return true - implement actual mipmap generation later
-		LOG_WARN("Mipmap generation not yet implemented");
+		std::vector<ImageData> levels = BuildMipChain(data, false);
+		for (size_t mip = 1; mip < levels.size(); ++mip)
+		{
+			data.mipOffsets.push_back(data.pixels.size());
+			data.pixels.insert(data.pixels.end(), levels[mip].pixels.begin(), levels[mip].pixels.end());
+		}
+		data.mipOffsets.insert(data.mipOffsets.begin(), 0);
 		return true;
 	}
 
@@ -5,6 +5,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "Engine/Core/CpuMemory.hpp"
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -13,12 +14,17 @@ namespace Nightbloom
 {
 	struct ImageData
 	{
-		std::vector<uint8_t> pixels;
+		TrackedVector<uint8_t, CpuMemoryCategory::Image> pixels;
 		uint32_t width = 0;
 		uint32_t height = 0;
 		uint32_t channels = 0;
 		bool isHDR = false;
 		size_t pixelSize = 0; // bytes per pixel
+
+		// Set by TextureLoader::GenerateMipmaps: pixels then holds every level,
+		// tightly packed, and mip i starts at mipOffsets[i] (the layout
+		// VulkanTexture::UploadMipLevels takes). Empty until then.
+		std::vector<size_t> mipOffsets;
 	};
 
 	class TextureLoader
@@ -31,6 +37,8 @@ namespace Nightbloom
 		static void FreeImage(ImageData& data);
 
 		// Utility functions
+		// Appends the full box-filtered chain (BuildMipChain) below mip 0;
+		// RGBA8 only
 		static bool GenerateMipmaps(ImageData& data);
 		static void FlipVertical(ImageData& data);
 
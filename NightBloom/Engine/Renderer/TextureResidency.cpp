@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+// TextureResidency.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/TextureResidency.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	TextureResidency::Handle TextureResidency::Register(const std::vector<uint64_t>& levelBytes, uint32_t tailMip)
+	{
+		if (levelBytes.empty())
+			return INVALID_HANDLE;
+
+		Handle handle;
+		if (!m_FreeHandles.empty())
+		{
+			handle = m_FreeHandles.back();
+			m_FreeHandles.pop_back();
+		}
+		else
+		{
+			handle = static_cast<Handle>(m_Entries.size());
+			m_Entries.emplace_back();
+		}
+
+		Entry& entry = m_Entries[handle];
+		entry = Entry{};
+		entry.levelBytes = levelBytes;
+		entry.tailMip = std::min(tailMip, static_cast<uint32_t>(levelBytes.size() - 1));
+		entry.residentMip = entry.tailMip;
+		entry.registered = true;
+
+		m_ResidentBytes += GetBytes(handle, entry.residentMip);
+		return handle;
+	}
+
+	void TextureResidency::Unregister(Handle handle)
+	{
+		if (!IsRegistered(handle))
+			return;
+
+		Entry& entry = m_Entries[handle];
+		m_ResidentBytes -= GetBytes(handle, entry.residentMip);
+		if (entry.pendingMip != NO_MIP)
+			--m_PendingCount;
+
+		entry = Entry{};
+		m_FreeHandles.push_back(handle);
+	}
+
+	void TextureResidency::Request(Handle handle, uint32_t mip, uint64_t frame)
+	{
+		if (!IsRegistered(handle))
+			return;
+
+		Entry& entry = m_Entries[handle];
+		if (entry.requestedMip == NO_MIP || entry.lastRequestFrame != frame)
+			entry.requestedMip = mip;
+		else
+			entry.requestedMip = std::min(entry.requestedMip, mip);
+		entry.lastRequestFrame = frame;
+	}
+
+	uint32_t TextureResidency::GetWantedMip(Handle handle, uint64_t frame) const
+	{
+		const Entry& entry = m_Entries[handle];
+		if (entry.requestedMip == NO_MIP || frame - entry.lastRequestFrame > m_Settings.requestTimeoutFrames)
+			return entry.tailMip;
+		return std::min(entry.requestedMip, entry.tailMip);
+	}
+
+	uint64_t TextureResidency::GetBytes(Handle handle, uint32_t mip) const
+	{
+		const Entry& entry = m_Entries[handle];
+		uint64_t bytes = 0;
+		for (size_t level = mip; level < entry.levelBytes.size(); ++level)
+			bytes += entry.levelBytes[level];
+		return bytes;
+	}
+
+	uint64_t TextureResidency::SettledBytes(const Entry& entry) const
+	{
+		const Handle handle = static_cast<Handle>(&entry - m_Entries.data());
+		return GetBytes(handle, entry.pendingMip != NO_MIP ? entry.pendingMip : entry.residentMip);
+	}
+
+	std::vector<TextureResidency::Change> TextureResidency::Update(uint64_t budget, uint64_t frame)
+	{
+		std::vector<Change> changes;
+		uint64_t settled = 0;
+		std::vector<Handle> idle;   // registered, no change in flight
+		for (Handle handle = 0; handle < m_Entries.size(); ++handle)
+		{
+			const Entry& entry = m_Entries[handle];
+			if (!entry.registered)
+				continue;
+			settled += SettledBytes(entry);
+			if (entry.pendingMip == NO_MIP)
+				idle.push_back(handle);
+		}
+
+		auto start = [&](Handle handle, uint32_t mip)
+		{
+			Entry& entry = m_Entries[handle];
+			settled = settled - GetBytes(handle, entry.residentMip) + GetBytes(handle, mip);
+			entry.pendingMip = mip;
+			++m_PendingCount;
+			changes.push_back({ handle, mip });
+		};
+		auto full = [&]() { return changes.size() >= m_Settings.maxChangesPerUpdate; };
+
+		// Least recently requested first
+		std::stable_sort(idle.begin(), idle.end(), [&](Handle a, Handle b)
+			{ return m_Entries[a].lastRequestFrame < m_Entries[b].lastRequestFrame; });
+
+		// Over budget: drop cached levels nobody wants any more...
+		for (Handle handle : idle)
+		{
+			if (settled <= budget || full())
+				break;
+			const uint32_t wanted = GetWantedMip(handle, frame);
+			if (m_Entries[handle].residentMip < wanted)
+				start(handle, wanted);
+		}
+
+		// ...then the finest level of textures still in use
+		for (Handle handle : idle)
+		{
+			if (settled <= budget || full())
+				break;
+			const Entry& entry = m_Entries[handle];
+			if (entry.pendingMip == NO_MIP && entry.residentMip < entry.tailMip)
+				start(handle, entry.residentMip + 1);
+		}
+
+		if (settled > budget)
+			return changes;
+
+		// Stream in, most-starved first (most recently requested on ties)
+		std::vector<Handle> starved;
+		for (Handle handle : idle)
+		{
+			if (m_Entries[handle].pendingMip == NO_MIP && GetWantedMip(handle, frame) < m_Entries[handle].residentMip)
+				starved.push_back(handle);
+		}
+		std::stable_sort(starved.begin(), starved.end(), [&](Handle a, Handle b)
+			{
+				const uint32_t gapA = m_Entries[a].residentMip - GetWantedMip(a, frame);
+				const uint32_t gapB = m_Entries[b].residentMip - GetWantedMip(b, frame);
+				if (gapA != gapB)
+					return gapA > gapB;
+				return m_Entries[a].lastRequestFrame > m_Entries[b].lastRequestFrame;
+			});
+
+		uint64_t uploadBytes = 0;
+		for (Handle handle : starved)
+		{
+			if (full())
+				break;
+
+			// Finest level toward the request that still fits
+			const Entry& entry = m_Entries[handle];
+			const uint64_t current = GetBytes(handle, entry.residentMip);
+			uint32_t mip = GetWantedMip(handle, frame);
+			while (mip < entry.residentMip && settled - current + GetBytes(handle, mip) > budget)
+				++mip;
+			if (mip == entry.residentMip)
+				continue;
+
+			// The whole replacement chain is uploaded, not just the new levels
+			const uint64_t cost = GetBytes(handle, mip);
+			if (uploadBytes > 0 && uploadBytes + cost > m_Settings.maxUploadBytesPerUpdate)
+				continue;
+			uploadBytes += cost;
+			start(handle, mip);
+		}
+
+		return changes;
+	}
+
+	void TextureResidency::Complete(Handle handle)
+	{
+		if (!IsRegistered(handle) || m_Entries[handle].pendingMip == NO_MIP)
+			return;
+
+		Entry& entry = m_Entries[handle];
+		m_ResidentBytes = m_ResidentBytes - GetBytes(handle, entry.residentMip) + GetBytes(handle, entry.pendingMip);
+		entry.residentMip = entry.pendingMip;
+		entry.pendingMip = NO_MIP;
+		--m_PendingCount;
+	}
+
+	void TextureResidency::Cancel(Handle handle)
+	{
+		if (!IsRegistered(handle) || m_Entries[handle].pendingMip == NO_MIP)
+			return;
+
+		m_Entries[handle].pendingMip = NO_MIP;
+		--m_PendingCount;
+	}
+}
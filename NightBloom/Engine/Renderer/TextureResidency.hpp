@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+// TextureResidency.hpp
+//
+// Mip residency bookkeeping for streamed textures (see TextureStreamer).
+// A streamed texture always keeps its mip tail - the levels at or below a
+// small size - resident, and holds a contiguous run of finer levels above it:
+// "resident mip" r means mips r..N-1 are in memory. Every frame the draws
+// request the finest mip they can actually resolve; Update turns those
+// requests into residency changes that fit a byte budget:
+//
+//  - Levels finer than a texture wants are kept as a cache while there is
+//    room, and are the first thing dropped (least recently requested first)
+//    once the budget is exceeded. If that is not enough, textures still in
+//    use lose their finest level, oldest request first.
+//  - Textures that want finer levels get them, most-starved first, as far
+//    toward the request as the remaining budget allows. At most
+//    maxChangesPerUpdate changes and maxUploadBytesPerUpdate bytes are
+//    started per update so streaming never hitches a frame.
+//  - A texture that has not been requested for requestTimeoutFrames falls
+//    back to wanting only its tail.
+//
+// A change is in flight until Complete (or Cancel); the texture gets no new
+// change meanwhile. Byte counts are the caller's (levelBytes), so they can
+// be compressed sizes.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct TextureResidencySettings
+	{
+		uint32_t maxChangesPerUpdate = 4;
+		uint64_t maxUploadBytesPerUpdate = 32ull * 1024 * 1024;   // the first change of an update is always allowed
+		uint64_t requestTimeoutFrames = 120;
+	};
+
+	// Finest mip worth having for a texture whose largest side is textureSize
+	// texels when it covers screenPixels pixels: mip m has textureSize >> m
+	// texels, so the first level at least as large as the footprint. bias > 0
+	// trades sharpness for memory. Nothing visible gets the coarsest level.
+	inline uint32_t ComputeRequestedMip(uint32_t textureSize, float screenPixels, uint32_t mipCount, float bias = 0.0f)
+	{
+		if (mipCount == 0)
+			return 0;
+		if (!(screenPixels > 0.0f))
+			return mipCount - 1;
+		const float mip = std::floor(std::log2(float(textureSize) / screenPixels) + bias);
+		if (mip <= 0.0f)
+			return 0;
+		return mip >= float(mipCount - 1) ? mipCount - 1 : static_cast<uint32_t>(mip);
+	}
+
+	class TextureResidency
+	{
+	public:
+		using Handle = uint32_t;
+		static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+		static constexpr uint32_t NO_MIP = UINT32_MAX;
+
+		// New resident mip to build for a texture
+		struct Change
+		{
+			Handle handle = INVALID_HANDLE;
+			uint32_t mip = 0;
+		};
+
+		explicit TextureResidency(const TextureResidencySettings& settings = TextureResidencySettings{})
+			: m_Settings(settings) {}
+
+		// levelBytes[i] is mip i's size. Starts with tailMip..N-1 resident.
+		Handle Register(const std::vector<uint64_t>& levelBytes, uint32_t tailMip);
+		void Unregister(Handle handle);
+
+		// The finest request of a frame wins
+		void Request(Handle handle, uint32_t mip, uint64_t frame);
+
+		// Plans this frame's changes against `budget` bytes of resident
+		// streamed levels (in-flight changes counted at their new size)
+		std::vector<Change> Update(uint64_t budget, uint64_t frame);
+
+		// The in-flight change was applied / abandoned
+		void Complete(Handle handle);
+		void Cancel(Handle handle);
+
+		uint32_t GetResidentMip(Handle handle) const { return m_Entries[handle].residentMip; }
+		uint32_t GetPendingMip(Handle handle) const { return m_Entries[handle].pendingMip; }
+		uint32_t GetWantedMip(Handle handle, uint64_t frame) const;
+		bool IsRegistered(Handle handle) const { return handle < m_Entries.size() && m_Entries[handle].registered; }
+
+		// Bytes of mips `mip`..N-1
+		uint64_t GetBytes(Handle handle, uint32_t mip) const;
+
+		// Sum over textures of their resident levels, the images of in-flight
+		// changes not included
+		uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+		size_t GetPendingCount() const { return m_PendingCount; }
+
+	private:
+		struct Entry
+		{
+			std::vector<uint64_t> levelBytes;
+			uint32_t tailMip = 0;
+			uint32_t residentMip = 0;
+			uint32_t pendingMip = NO_MIP;
+			uint32_t requestedMip = NO_MIP;
+			uint64_t lastRequestFrame = 0;
+			bool registered = false;
+		};
+
+		// Size once the texture's in-flight change (if any) lands
+		uint64_t SettledBytes(const Entry& entry) const;
+
+		TextureResidencySettings m_Settings;
+		std::vector<Entry> m_Entries;
+		std::vector<Handle> m_FreeHandles;
+		uint64_t m_ResidentBytes = 0;
+		size_t m_PendingCount = 0;
+	};
+}
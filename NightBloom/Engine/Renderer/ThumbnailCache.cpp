@@ -0,0 +1,485 @@
+//------------------------------------------------------------------------------
+// ThumbnailCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/ThumbnailCache.hpp"
+#include "Engine/Core/ThreadPlacement.hpp"
+#include "ThirdParty/stb/stb_image.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr char THUMBNAIL_MAGIC[4] = { 'N', 'B', 'T', 'H' };
+		constexpr uint32_t THUMBNAIL_VERSION = 1;
+		constexpr size_t THUMBNAIL_BYTES = static_cast<size_t>(ThumbnailCache::THUMBNAIL_SIZE) *
+			ThumbnailCache::THUMBNAIL_SIZE * 4;
+
+		struct ThumbnailHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint64_t key;
+			uint32_t size;
+			uint32_t reserved;
+		};
+
+		// FNV-1a 64, field by field so struct padding never leaks in
+		void HashInto(uint64_t& hash, const void* data, size_t size)
+		{
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash ^= bytes[i];
+				hash *= 0x100000001b3ull;
+			}
+		}
+	}
+
+	ThumbnailCache::ThumbnailCache(std::string cacheDirectory, uint32_t pageCount, DecodeFn decode)
+		: m_CacheDirectory(std::move(cacheDirectory))
+		, m_Decode(decode ? std::move(decode) : DecodeFn(&ThumbnailCache::DecodeImage))
+	{
+		pageCount = std::max(pageCount, 1u);
+		m_Pages.assign(pageCount, std::vector<uint8_t>(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE * 4, 0));
+		m_PageRevisions.assign(pageCount, 0);
+		m_Slots.resize(static_cast<size_t>(pageCount) * CELLS_PER_PAGE);
+
+		// Popped from the back: fill page 0 first
+		m_FreeSlots.reserve(m_Slots.size());
+		for (size_t i = m_Slots.size(); i-- > 0;)
+			m_FreeSlots.push_back(static_cast<uint32_t>(i));
+	}
+
+	ThumbnailCache::~ThumbnailCache()
+	{
+		Stop();
+	}
+
+	void ThumbnailCache::Start(uint32_t threadCount)
+	{
+		if (IsRunning() || threadCount == 0)
+			return;
+
+		m_Quit = false;
+		for (uint32_t i = 0; i < threadCount; ++i)
+			m_Threads.emplace_back([this]() { ThreadLoop(); });
+	}
+
+	void ThumbnailCache::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_QueueMutex);
+			m_Quit = true;
+		}
+		m_QueueCv.notify_all();
+		for (std::thread& thread : m_Threads)
+			thread.join();
+		m_Threads.clear();
+	}
+
+	ThumbnailCache::Status ThumbnailCache::Request(const std::string& path, uint64_t size, int64_t modified, Cell& outCell)
+	{
+		const uint64_t key = MakeKey(path, size, modified);
+		Item& item = m_Items[path];
+		if (item.key != key)
+		{
+			// New, or the file changed: a queued job for the old key is
+			// dropped by Update, its result by the key check. A slot held is
+			// overwritten in place.
+			item.key = key;
+			item.state = ItemState::Idle;
+		}
+		item.lastRequested = m_Frame;
+
+		switch (item.state)
+		{
+		case ItemState::Ready:
+			m_Slots[item.slot].lastUsed = m_Frame;
+			outCell = GetCell(item.slot);
+			return Status::Ready;
+		case ItemState::Failed:
+			return Status::Failed;
+		case ItemState::Idle:
+			m_NewJobs.push_back({ path, key, m_Frame });
+			item.state = ItemState::Queued;
+			return Status::Pending;
+		default:
+			return Status::Pending;
+		}
+	}
+
+	void ThumbnailCache::Update()
+	{
+		std::vector<Result> results = std::move(m_Unplaced);
+		m_Unplaced.clear();
+		{
+			std::lock_guard<std::mutex> lock(m_ResultMutex);
+			for (Result& result : m_Results)
+				results.push_back(std::move(result));
+			m_Results.clear();
+		}
+
+		for (Result& result : results)
+		{
+			auto it = m_Items.find(result.path);
+			if (it == m_Items.end() || it->second.key != result.key ||
+				it->second.state == ItemState::Ready || it->second.state == ItemState::Failed)
+			{
+				continue;
+			}
+
+			Item& item = it->second;
+			if (!result.ok)
+				item.state = ItemState::Failed;
+			else if (!Place(item, result.path, result.pixels))
+				m_Unplaced.push_back(std::move(result)); // Every cell was drawn last frame
+		}
+
+		// Re-prioritise by the requests made since the last Update, then
+		// open the next frame
+		bool added = false;
+		{
+			std::lock_guard<std::mutex> lock(m_QueueMutex);
+			for (size_t i = 0; i < m_Queue.size();)
+			{
+				Job& job = m_Queue[i];
+				auto it = m_Items.find(job.path);
+				const bool current = it != m_Items.end() && it->second.key == job.key &&
+					it->second.state == ItemState::Queued;
+				if (current && m_Frame - it->second.lastRequested <= STALE_FRAMES)
+				{
+					job.priority = it->second.lastRequested;
+					++i;
+					continue;
+				}
+
+				if (current)
+					it->second.state = ItemState::Idle;
+				job = std::move(m_Queue.back());
+				m_Queue.pop_back();
+			}
+
+			added = !m_NewJobs.empty();
+			for (Job& job : m_NewJobs)
+				m_Queue.push_back(std::move(job));
+			m_NewJobs.clear();
+		}
+		if (added)
+			m_QueueCv.notify_all();
+
+		++m_Frame;
+	}
+
+	size_t ThumbnailCache::GetQueuedCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		return m_Queue.size() + m_NewJobs.size();
+	}
+
+	void ThumbnailCache::ThreadLoop()
+	{
+		ThreadPlacement::Apply(ThreadRole::Background);
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(m_QueueMutex);
+				m_QueueCv.wait(lock, [this]() { return m_Quit || !m_Queue.empty(); });
+				if (m_Quit)
+					return;
+
+				// Most recently requested first; the queue only holds what was
+				// on screen in the last STALE_FRAMES, so the scan is short
+				auto best = std::max_element(m_Queue.begin(), m_Queue.end(),
+					[](const Job& a, const Job& b) { return a.priority < b.priority; });
+				job = std::move(*best);
+				*best = std::move(m_Queue.back());
+				m_Queue.pop_back();
+			}
+
+			Result result = Produce(job);
+			std::lock_guard<std::mutex> lock(m_ResultMutex);
+			m_Results.push_back(std::move(result));
+		}
+	}
+
+	ThumbnailCache::Result ThumbnailCache::Produce(const Job& job)
+	{
+		Result result;
+		result.path = job.path;
+		result.key = job.key;
+
+		const std::string cachePath = m_CacheDirectory.empty() ? std::string() :
+			GetThumbnailPath(m_CacheDirectory, job.key);
+		if (!cachePath.empty() && ReadThumbnail(cachePath, job.key, result.pixels))
+		{
+			m_DiskHits.fetch_add(1, std::memory_order_relaxed);
+			result.ok = true;
+			return result;
+		}
+
+		std::vector<uint8_t> pixels;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		if (!m_Decode(job.path, pixels, width, height) ||
+			pixels.size() < static_cast<size_t>(width) * height * 4)
+		{
+			return result;
+		}
+
+		Downscale(pixels.data(), width, height, result.pixels);
+		if (!cachePath.empty())
+			WriteThumbnail(cachePath, job.key, result.pixels);
+		m_Generated.fetch_add(1, std::memory_order_relaxed);
+		result.ok = true;
+		return result;
+	}
+
+	uint32_t ThumbnailCache::AllocateSlot()
+	{
+		if (!m_FreeSlots.empty())
+		{
+			const uint32_t slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+			return slot;
+		}
+
+		// Least recently drawn, skipping what the last frame drew
+		uint32_t victim = NO_SLOT;
+		for (uint32_t i = 0; i < m_Slots.size(); ++i)
+		{
+			const Slot& slot = m_Slots[i];
+			if (slot.lastUsed + 1 >= m_Frame)
+				continue;
+			if (victim == NO_SLOT || slot.lastUsed < m_Slots[victim].lastUsed)
+				victim = i;
+		}
+		if (victim == NO_SLOT)
+			return NO_SLOT;
+
+		auto it = m_Items.find(m_Slots[victim].path);
+		if (it != m_Items.end())
+		{
+			it->second.slot = NO_SLOT;
+			if (it->second.state == ItemState::Ready)
+				it->second.state = ItemState::Idle;
+		}
+		return victim;
+	}
+
+	bool ThumbnailCache::Place(Item& item, const std::string& path, const std::vector<uint8_t>& pixels)
+	{
+		if (pixels.size() != THUMBNAIL_BYTES)
+		{
+			item.state = ItemState::Failed;
+			return true;
+		}
+
+		if (item.slot == NO_SLOT)
+		{
+			item.slot = AllocateSlot();
+			if (item.slot == NO_SLOT)
+				return false;
+		}
+
+		Slot& slot = m_Slots[item.slot];
+		slot.path = path;
+		slot.lastUsed = m_Frame;
+		slot.used = true;
+
+		const uint32_t page = item.slot / CELLS_PER_PAGE;
+		const uint32_t local = item.slot % CELLS_PER_PAGE;
+		const size_t x = static_cast<size_t>(local % CELLS_PER_ROW) * THUMBNAIL_SIZE;
+		const size_t y = static_cast<size_t>(local / CELLS_PER_ROW) * THUMBNAIL_SIZE;
+		const size_t rowBytes = static_cast<size_t>(THUMBNAIL_SIZE) * 4;
+		uint8_t* dst = m_Pages[page].data() + (y * PAGE_SIZE + x) * 4;
+		for (uint32_t row = 0; row < THUMBNAIL_SIZE; ++row)
+			std::memcpy(dst + row * static_cast<size_t>(PAGE_SIZE) * 4, pixels.data() + row * rowBytes, rowBytes);
+
+		++m_PageRevisions[page];
+		item.state = ItemState::Ready;
+		return true;
+	}
+
+	ThumbnailCache::Cell ThumbnailCache::GetCell(uint32_t slot) const
+	{
+		const uint32_t local = slot % CELLS_PER_PAGE;
+		const float scale = static_cast<float>(THUMBNAIL_SIZE) / PAGE_SIZE;
+
+		Cell cell;
+		cell.page = slot / CELLS_PER_PAGE;
+		cell.u0 = static_cast<float>(local % CELLS_PER_ROW) * scale;
+		cell.v0 = static_cast<float>(local / CELLS_PER_ROW) * scale;
+		cell.u1 = cell.u0 + scale;
+		cell.v1 = cell.v0 + scale;
+		return cell;
+	}
+
+	uint64_t ThumbnailCache::MakeKey(const std::string& path, uint64_t size, int64_t modified)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		HashInto(hash, &THUMBNAIL_VERSION, sizeof(THUMBNAIL_VERSION));
+		HashInto(hash, &THUMBNAIL_SIZE, sizeof(THUMBNAIL_SIZE));
+		HashInto(hash, path.data(), path.size());
+		HashInto(hash, &size, sizeof(size));
+		HashInto(hash, &modified, sizeof(modified));
+		return hash;
+	}
+
+	std::string ThumbnailCache::GetThumbnailPath(const std::string& cacheDirectory, uint64_t key)
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "thumb_%016llx.nbthumb", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(cacheDirectory) / name).string();
+	}
+
+	bool ThumbnailCache::WriteThumbnail(const std::string& path, uint64_t key, const std::vector<uint8_t>& pixels)
+	{
+		if (pixels.size() != THUMBNAIL_BYTES)
+			return false;
+
+		ThumbnailHeader header{};
+		std::memcpy(header.magic, THUMBNAIL_MAGIC, sizeof(header.magic));
+		header.version = THUMBNAIL_VERSION;
+		header.key = key;
+		header.size = THUMBNAIL_SIZE;
+
+		std::error_code ec;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, ec);
+
+		// Two workers may write the same entry; each through its own file
+		const std::string tempPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+			if (!file)
+			{
+				file.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	bool ThumbnailCache::ReadThumbnail(const std::string& path, uint64_t key, std::vector<uint8_t>& outPixels)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		ThumbnailHeader header{};
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, THUMBNAIL_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != THUMBNAIL_VERSION ||
+			header.key != key ||
+			header.size != THUMBNAIL_SIZE)
+		{
+			return false;
+		}
+
+		outPixels.resize(THUMBNAIL_BYTES);
+		if (!file.read(reinterpret_cast<char*>(outPixels.data()), static_cast<std::streamsize>(outPixels.size())))
+		{
+			outPixels.clear();
+			return false;
+		}
+		return true;
+	}
+
+	void ThumbnailCache::Downscale(const uint8_t* pixels, uint32_t width, uint32_t height, std::vector<uint8_t>& outPixels)
+	{
+		outPixels.assign(THUMBNAIL_BYTES, 0);
+		if (!pixels || width == 0 || height == 0)
+			return;
+
+		// Fit the longer side
+		uint32_t targetWidth = THUMBNAIL_SIZE;
+		uint32_t targetHeight = THUMBNAIL_SIZE;
+		if (width >= height)
+			targetHeight = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(THUMBNAIL_SIZE) * height / width));
+		else
+			targetWidth = std::max(1u, static_cast<uint32_t>(static_cast<uint64_t>(THUMBNAIL_SIZE) * width / height));
+		const uint32_t offsetX = (THUMBNAIL_SIZE - targetWidth) / 2;
+		const uint32_t offsetY = (THUMBNAIL_SIZE - targetHeight) / 2;
+
+		for (uint32_t ty = 0; ty < targetHeight; ++ty)
+		{
+			const uint64_t y0 = static_cast<uint64_t>(ty) * height / targetHeight;
+			const uint64_t y1 = std::max(y0 + 1, static_cast<uint64_t>(ty + 1) * height / targetHeight);
+			for (uint32_t tx = 0; tx < targetWidth; ++tx)
+			{
+				const uint64_t x0 = static_cast<uint64_t>(tx) * width / targetWidth;
+				const uint64_t x1 = std::max(x0 + 1, static_cast<uint64_t>(tx + 1) * width / targetWidth);
+
+				uint64_t sum[4] = {};
+				for (uint64_t y = y0; y < y1; ++y)
+				{
+					const uint8_t* src = pixels + (y * width + x0) * 4;
+					for (uint64_t x = x0; x < x1; ++x, src += 4)
+					{
+						sum[0] += src[0];
+						sum[1] += src[1];
+						sum[2] += src[2];
+						sum[3] += src[3];
+					}
+				}
+
+				const uint64_t count = (y1 - y0) * (x1 - x0);
+				uint8_t* dst = outPixels.data() + ((static_cast<size_t>(offsetY) + ty) * THUMBNAIL_SIZE + offsetX + tx) * 4;
+				for (int c = 0; c < 4; ++c)
+					dst[c] = static_cast<uint8_t>((sum[c] + count / 2) / count);
+			}
+		}
+	}
+
+	bool ThumbnailCache::DecodeImage(const std::string& path, std::vector<uint8_t>& outPixels,
+		uint32_t& outWidth, uint32_t& outHeight)
+	{
+		// Read rather than TextureLoader::LoadImageRGBA, which logs every load
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+		const std::streamoff size = file.tellg();
+		if (size <= 0 || size > INT32_MAX)
+			return false;
+
+		std::vector<stbi_uc> bytes(static_cast<size_t>(size));
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(bytes.data()), size))
+			return false;
+
+		// HDR files come back tone mapped to LDR
+		int width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = stbi_load_from_memory(bytes.data(), static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha);
+		if (!pixels)
+			return false;
+
+		outWidth = static_cast<uint32_t>(width);
+		outHeight = static_cast<uint32_t>(height);
+		outPixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(pixels);
+		return true;
+	}
+}
@@ -0,0 +1,181 @@
+//------------------------------------------------------------------------------
+// ThumbnailCache.hpp
+//
+// Asset browser thumbnails: 64x64 RGBA8 cells packed into 1024x1024 CPU
+// atlas pages. The caller requests a thumbnail every frame it is on screen;
+// the cache's own threads produce it - from the disk cache when an entry
+// for that file's path, size and time exists, otherwise by decoding and
+// box-filtering the image (then writing the entry) - and Update() copies
+// finished ones into a page and bumps that page's revision, which is the
+// caller's cue to re-upload it.
+//
+// Its own threads rather than the JobSystem for the reason AssetLoadQueue
+// gives: a frame that waits on job counters must never pick up a decode.
+//
+// Workers take the most recently requested thumbnail first, so what is on
+// screen now comes before what was scrolled past; a request not repeated
+// for STALE_FRAMES is dropped before it starts. When every cell is taken,
+// the one least recently drawn is reused.
+//
+// On disk a thumbnail is a header (key and size) plus the RGBA8 texels,
+// named <cacheDirectory>/thumb_<16 hex digits>.nbthumb.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Nightbloom
+{
+	class ThumbnailCache
+	{
+	public:
+		static constexpr uint32_t THUMBNAIL_SIZE = 64;
+		static constexpr uint32_t PAGE_SIZE = 1024;
+		static constexpr uint32_t CELLS_PER_ROW = PAGE_SIZE / THUMBNAIL_SIZE;
+		static constexpr uint32_t CELLS_PER_PAGE = CELLS_PER_ROW * CELLS_PER_ROW;
+		static constexpr uint64_t STALE_FRAMES = 8;
+
+		// Reads an image file into tightly packed RGBA8; false when it can't
+		using DecodeFn = std::function<bool(const std::string& path, std::vector<uint8_t>& outPixels,
+			uint32_t& outWidth, uint32_t& outHeight)>;
+
+		enum class Status : uint8_t
+		{
+			Pending,
+			Ready,
+			Failed
+		};
+
+		struct Cell
+		{
+			uint32_t page = 0;
+			float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+		};
+
+		// An empty cacheDirectory disables the disk cache; a null decode
+		// uses stb_image
+		explicit ThumbnailCache(std::string cacheDirectory, uint32_t pageCount = 4, DecodeFn decode = {});
+		~ThumbnailCache();
+
+		ThumbnailCache(const ThumbnailCache&) = delete;
+		ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+		// Until Start() requests are queued but nothing produces them
+		void Start(uint32_t threadCount = 2);
+		void Stop();
+
+		bool IsRunning() const { return !m_Threads.empty(); }
+
+		// Main thread. Ready fills outCell; a changed size or time makes a
+		// ready thumbnail pending again.
+		Status Request(const std::string& path, uint64_t size, int64_t modified, Cell& outCell);
+
+		// Main thread, once per frame before the requests: places finished
+		// thumbnails, reorders the queue by the last frame's requests and
+		// drops stale ones
+		void Update();
+
+		uint32_t GetPageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+		const std::vector<uint8_t>& GetPagePixels(uint32_t page) const { return m_Pages[page]; }
+		uint64_t GetPageRevision(uint32_t page) const { return m_PageRevisions[page]; }
+
+		size_t GetQueuedCount() const;
+		uint64_t GetDiskHitCount() const { return m_DiskHits.load(std::memory_order_relaxed); }
+		uint64_t GetGeneratedCount() const { return m_Generated.load(std::memory_order_relaxed); }
+
+		static uint64_t MakeKey(const std::string& path, uint64_t size, int64_t modified);
+		static std::string GetThumbnailPath(const std::string& cacheDirectory, uint64_t key);
+		// Writes through a temporary file and a rename, like the other caches
+		static bool WriteThumbnail(const std::string& path, uint64_t key, const std::vector<uint8_t>& pixels);
+		// False when missing, for another key or size, or short
+		static bool ReadThumbnail(const std::string& path, uint64_t key, std::vector<uint8_t>& outPixels);
+
+		// Box-filters (or, for small images, repeats) an RGBA8 image into a
+		// THUMBNAIL_SIZE square, aspect kept and centred on transparent black
+		static void Downscale(const uint8_t* pixels, uint32_t width, uint32_t height, std::vector<uint8_t>& outPixels);
+
+		static bool DecodeImage(const std::string& path, std::vector<uint8_t>& outPixels,
+			uint32_t& outWidth, uint32_t& outHeight);
+
+	private:
+		static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+		enum class ItemState : uint8_t
+		{
+			Idle,    // Not queued: new, dropped as stale or evicted
+			Queued,
+			Ready,
+			Failed
+		};
+
+		struct Item
+		{
+			uint64_t key = 0;
+			ItemState state = ItemState::Idle;
+			uint32_t slot = NO_SLOT;
+			uint64_t lastRequested = 0;
+		};
+
+		struct Slot
+		{
+			std::string path;
+			uint64_t lastUsed = 0;
+			bool used = false;
+		};
+
+		struct Job
+		{
+			std::string path;
+			uint64_t key = 0;
+			uint64_t priority = 0;
+		};
+
+		struct Result
+		{
+			std::string path;
+			uint64_t key = 0;
+			bool ok = false;
+			std::vector<uint8_t> pixels;
+		};
+
+		void ThreadLoop();
+		Result Produce(const Job& job);
+		uint32_t AllocateSlot();
+		bool Place(Item& item, const std::string& path, const std::vector<uint8_t>& pixels);
+		Cell GetCell(uint32_t slot) const;
+
+		std::string m_CacheDirectory;
+		DecodeFn m_Decode;
+
+		// Main thread
+		std::unordered_map<std::string, Item> m_Items;
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		std::vector<std::vector<uint8_t>> m_Pages;
+		std::vector<uint64_t> m_PageRevisions;
+		std::vector<Job> m_NewJobs;
+		std::vector<Result> m_Unplaced;
+		uint64_t m_Frame = 0;
+
+		// Shared with the workers
+		std::vector<std::thread> m_Threads;
+		mutable std::mutex m_QueueMutex;
+		std::condition_variable m_QueueCv;
+		std::vector<Job> m_Queue;
+		bool m_Quit = false;
+
+		std::mutex m_ResultMutex;
+		std::vector<Result> m_Results;
+
+		std::atomic<uint64_t> m_DiskHits{ 0 };
+		std::atomic<uint64_t> m_Generated{ 0 };
+	};
+}
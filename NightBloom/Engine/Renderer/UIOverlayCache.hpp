@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// UIOverlayCache.hpp
+//
+// Decides, once per frame, whether the UI is rebuilt (ImGui NewFrame, the
+// app's panels, ImGui::Render and its draws) or last frame's is reused.
+// Uncached, it is rebuilt every frame and drawn straight onto the swapchain.
+// Cached, UIManager draws it into a texture of its own that post-process
+// composites every frame, and it is only rebuilt:
+//
+//   - for graceFrames frames after input arrives or while a widget is held
+//     (ImGui needs a frame or two to settle what a click or a key opened)
+//   - after Invalidate (a resize, a setting change, the app asking)
+//   - otherwise at refreshRate, for text that changes by itself (timings,
+//     progress); 0 waits for input
+//
+// Times are seconds on any monotonic clock.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	struct UIOverlaySettings
+	{
+		bool cached = false;
+		float refreshRate = 10.0f;   // rebuilds per second with nothing happening
+		uint32_t graceFrames = 3;    // rebuilt frames after any input
+	};
+
+	class UIOverlayCache
+	{
+	public:
+		void SetSettings(const UIOverlaySettings& settings)
+		{
+			m_Settings = settings;
+			m_Settings.refreshRate = std::max(m_Settings.refreshRate, 0.0f);
+			Invalidate();
+		}
+		const UIOverlaySettings& GetSettings() const { return m_Settings; }
+
+		// The cached UI is stale: rebuild it on the next frame
+		void Invalidate() { m_Invalid = true; }
+
+		// True when this frame rebuilds the UI; `activity` is pending input
+		// or a widget being held
+		bool ShouldRefresh(double now, bool activity)
+		{
+			if (activity)
+				m_GraceLeft = std::max(m_Settings.graceFrames, 1u);
+
+			bool refresh = !m_Settings.cached || m_Invalid || m_GraceLeft > 0;
+			if (!refresh && m_Settings.refreshRate > 0.0f)
+				refresh = now - m_LastRefresh >= 1.0 / m_Settings.refreshRate;
+
+			if (m_GraceLeft > 0)
+				--m_GraceLeft;
+			if (!refresh)
+			{
+				++m_Reused;
+				return false;
+			}
+
+			m_Invalid = false;
+			m_LastRefresh = now;
+			m_LastReused = m_Reused;
+			m_Reused = 0;
+			return true;
+		}
+
+		// Frames the previous build was shown for after its own (what a
+		// rebuilt UI can report about the cache)
+		uint32_t GetReusedFrames() const { return m_LastReused; }
+
+	private:
+		UIOverlaySettings m_Settings;
+		bool m_Invalid = true;
+		uint32_t m_GraceLeft = 0;
+		double m_LastRefresh = 0.0;
+		uint32_t m_Reused = 0;
+		uint32_t m_LastReused = 0;
+	};
+}
@@ -1,6 +1,8 @@
 // Vertex.hpp
 #pragma once
 
+#include "Engine/Renderer/VertexPacking.hpp"
+#include "Engine/Renderer/Animation.hpp"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include <array>
@@ -94,6 +96,56 @@ namespace Nightbloom
 		}
 	};
 
+	// Bind-pose vertex plus its joint influences: what SkinningSystem reads
+	// from VulkanMeshArena's skin pool (SkinVertex in Skinning.comp). Never
+	// bound as a vertex buffer.
+	struct SkinnedVertex
+	{
+		VertexPNT vertex;
+		VertexSkin skin;
+	};
+	static_assert(sizeof(SkinnedVertex) == 48, "Skinning.comp reads 12 floats per vertex");
+
+	// Compressed VertexPNT, 16 bytes instead of 32 (see VertexPacking.hpp).
+	// Same locations, so the shaders only differ in decoding the normal.
+	struct VertexPNTPacked : PackedVertex
+	{
+		static VkVertexInputBindingDescription GetBindingDescription()
+		{
+			VkVertexInputBindingDescription bindingDesc{};
+			bindingDesc.binding = 0;
+			bindingDesc.stride = sizeof(PackedVertex);
+			bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+			return bindingDesc;
+		}
+
+		static std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescriptions()
+		{
+			std::array<VkVertexInputAttributeDescription, 3> attributeDesc{};
+
+			// Quantized position at location 0 (dequant is in the model matrix)
+			attributeDesc[0].binding = 0;
+			attributeDesc[0].location = 0;
+			attributeDesc[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+			attributeDesc[0].offset = offsetof(PackedVertex, position);
+
+			// Octahedral normal at location 1
+			attributeDesc[1].binding = 0;
+			attributeDesc[1].location = 1;
+			attributeDesc[1].format = VK_FORMAT_R16G16_SNORM;
+			attributeDesc[1].offset = offsetof(PackedVertex, normal);
+
+			// Half-float texCoord at location 2
+			attributeDesc[2].binding = 0;
+			attributeDesc[2].location = 2;
+			attributeDesc[2].format = VK_FORMAT_R16G16_SFLOAT;
+			attributeDesc[2].offset = offsetof(PackedVertex, texCoord);
+
+			return attributeDesc;
+		}
+	};
+	static_assert(sizeof(VertexPNTPacked) == sizeof(PackedVertex));
+
 	// Full PBR vertex format (for future use)
 	struct VertexPNTT
 	{
@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+// VertexPacking.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/VertexPacking.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// No axis of the dequant scale drops below 1/16 of the largest
+		constexpr float kMinAxisRatio = 1.0f / 16.0f;
+
+		uint16_t ToUnorm16(float value)
+		{
+			return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+		}
+
+		int16_t ToSnorm16(float value)
+		{
+			return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+		}
+
+		float FromSnorm16(int16_t value)
+		{
+			// -32768 and -32767 both map to -1 (Vulkan SNORM rule)
+			return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+		}
+
+		template <typename T>
+		const T& Strided(const T* base, size_t stride, size_t index)
+		{
+			return *reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(base) + index * stride);
+		}
+	}
+
+	glm::mat4 VertexQuantization::GetDequantizeTransform() const
+	{
+		glm::mat4 transform(1.0f);
+		transform[0][0] = scale.x;
+		transform[1][1] = scale.y;
+		transform[2][2] = scale.z;
+		transform[3] = glm::vec4(offset, 1.0f);
+		return transform;
+	}
+
+	VertexQuantization ComputeVertexQuantization(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		VertexQuantization quantization;
+		const glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+		const float largest = std::max({ extent.x, extent.y, extent.z, 1e-6f });
+		quantization.scale = glm::max(extent, glm::vec3(largest * kMinAxisRatio));
+		// Centre the flat axes' widened range on the data
+		quantization.offset = (boundsMin + boundsMax) * 0.5f - quantization.scale * 0.5f;
+		return quantization;
+	}
+
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		const uint32_t sign = (bits >> 16) & 0x8000u;
+		const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+		if (magnitude >= 0x7F800000u)   // inf / NaN
+			return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+		if (magnitude >= 0x477FF000u)   // rounds past the largest half
+			return static_cast<uint16_t>(sign | 0x7C00u);
+		if (magnitude < 0x38800000u)    // half subnormal or zero
+		{
+			if (magnitude < 0x33000000u)
+				return static_cast<uint16_t>(sign);
+			const uint32_t mantissa = (magnitude & 0x007FFFFFu) | 0x00800000u;
+			const uint32_t shift = 126u - (magnitude >> 23);
+			uint32_t half = mantissa >> shift;
+			const uint32_t rest = mantissa & ((1u << shift) - 1u);
+			const uint32_t halfway = 1u << (shift - 1u);
+			if (rest > halfway || (rest == halfway && (half & 1u)))
+				++half;
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		// Normal: rebias the exponent, round the mantissa to nearest even
+		uint32_t half = ((magnitude - 0x38000000u) >> 13);
+		const uint32_t rest = magnitude & 0x1FFFu;
+		if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+			++half;
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	float HalfToFloat(uint16_t value)
+	{
+		const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+		const uint32_t exponent = (value >> 10) & 0x1Fu;
+		const uint32_t mantissa = value & 0x3FFu;
+
+		uint32_t bits;
+		if (exponent == 0x1Fu)
+		{
+			bits = sign | 0x7F800000u | (mantissa << 13);
+		}
+		else if (exponent != 0)
+		{
+			bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+		}
+		else
+		{
+			const float subnormal = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+			return sign ? -subnormal : subnormal;
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	glm::vec2 OctEncode(const glm::vec3& normal)
+	{
+		const glm::vec3 n = normal / std::max(std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z), 1e-20f);
+		glm::vec2 encoded(n.x, n.y);
+		if (n.z < 0.0f)
+		{
+			// Fold the lower hemisphere over the diagonals
+			encoded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) *
+				glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+		}
+		return encoded;
+	}
+
+	glm::vec3 OctDecode(const glm::vec2& encoded)
+	{
+		glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+		const float fold = std::max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -fold : fold;
+		n.y += n.y >= 0.0f ? -fold : fold;
+		return glm::normalize(n);
+	}
+
+	void PackVertices(const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords,
+		size_t stride, size_t count, const VertexQuantization& quantization, PackedVertex* outVertices)
+	{
+		const glm::vec3 inverseScale = 1.0f / quantization.scale;
+		for (size_t v = 0; v < count; ++v)
+		{
+			PackedVertex& out = outVertices[v];
+
+			const glm::vec3 unit = (Strided(positions, stride, v) - quantization.offset) * inverseScale;
+			out.position[0] = ToUnorm16(unit.x);
+			out.position[1] = ToUnorm16(unit.y);
+			out.position[2] = ToUnorm16(unit.z);
+			out.position[3] = 0;
+
+			// Pre-scaled so the inverse-transpose of the dequant undoes it
+			glm::vec3 normal = Strided(normals, stride, v) * quantization.scale;
+			const float length = glm::length(normal);
+			normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+			const glm::vec2 octahedral = OctEncode(normal);
+			out.normal[0] = ToSnorm16(octahedral.x);
+			out.normal[1] = ToSnorm16(octahedral.y);
+
+			const glm::vec2& uv = Strided(texCoords, stride, v);
+			out.texCoord[0] = FloatToHalf(uv.x);
+			out.texCoord[1] = FloatToHalf(uv.y);
+		}
+	}
+
+	glm::vec3 UnpackPosition(const PackedVertex& vertex, const VertexQuantization& quantization)
+	{
+		const glm::vec3 unit(vertex.position[0] / 65535.0f, vertex.position[1] / 65535.0f, vertex.position[2] / 65535.0f);
+		return quantization.offset + unit * quantization.scale;
+	}
+
+	glm::vec3 UnpackNormal(const PackedVertex& vertex, const VertexQuantization& quantization)
+	{
+		const glm::vec3 scaled = OctDecode(glm::vec2(FromSnorm16(vertex.normal[0]), FromSnorm16(vertex.normal[1])));
+		return glm::normalize(scaled / quantization.scale);
+	}
+
+	glm::vec2 UnpackTexCoord(const PackedVertex& vertex)
+	{
+		return glm::vec2(HalfToFloat(vertex.texCoord[0]), HalfToFloat(vertex.texCoord[1]));
+	}
+}
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+// VertexPacking.hpp
+//
+// Compressed mesh vertices: VertexPNT (32 bytes) packed into 16.
+//
+//   position  R16G16B16A16_UNORM   quantized over the mesh bounds; the
+//                                  dequant transform (bounds offset * extent
+//                                  scale) is folded into the draw's model
+//                                  matrix, so the shader reads it unchanged
+//   normal    R16G16_SNORM         octahedral encoding of the unit normal
+//   texCoord  R16G16_SFLOAT        half floats
+//
+// Because the dequant scale is non-uniform, normals are stored pre-multiplied
+// by it: the shader's inverse-transpose normal matrix of (model * dequant)
+// then undoes the scale and lands on the true world normal.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	// Vertex buffer layout of a mesh (and of the pipeline variant it needs)
+	enum class VertexFormat : uint8_t
+	{
+		Standard,   // VertexPNT
+		Packed      // PackedVertex
+	};
+
+	struct PackedVertex
+	{
+		uint16_t position[4];   // xyz unorm over the bounds, w unused
+		int16_t normal[2];      // snorm octahedral
+		uint16_t texCoord[2];   // half floats
+	};
+	static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+	// Maps unorm16 positions back to object space
+	struct VertexQuantization
+	{
+		glm::vec3 offset = glm::vec3(0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+
+		// translate(offset) * scale(scale)
+		glm::mat4 GetDequantizeTransform() const;
+	};
+
+	// Quantization over a bounding box. Flat axes get a minimum extent
+	// relative to the largest one, which keeps the dequant matrix invertible
+	// and bounds how much it can amplify the normal encoding error.
+	VertexQuantization ComputeVertexQuantization(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	// Unit vector <-> [-1, 1]^2 octahedral coordinates
+	glm::vec2 OctEncode(const glm::vec3& normal);
+	glm::vec3 OctDecode(const glm::vec2& encoded);
+
+	// Packs count vertices read through strided pointers (e.g. the fields of
+	// a VertexPNT array with stride sizeof(VertexPNT))
+	void PackVertices(const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords,
+		size_t stride, size_t count, const VertexQuantization& quantization, PackedVertex* outVertices);
+
+	// Inverses, as the GPU reads them (for tests and tools)
+	glm::vec3 UnpackPosition(const PackedVertex& vertex, const VertexQuantization& quantization);
+	glm::vec3 UnpackNormal(const PackedVertex& vertex, const VertexQuantization& quantization);
+	glm::vec2 UnpackTexCoord(const PackedVertex& vertex);
+}
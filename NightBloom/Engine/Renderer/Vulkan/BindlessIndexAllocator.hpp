@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+// BindlessIndexAllocator.hpp
+//
+// Slot bookkeeping for the bindless texture array and material table. Slots
+// come out in ascending order until the capacity is reached; released slots
+// are handed out again (most recently released first) before the high-water
+// mark grows.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class BindlessIndexAllocator
+	{
+	public:
+		static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+		BindlessIndexAllocator() = default;
+		explicit BindlessIndexAllocator(uint32_t capacity) : m_Capacity(capacity) {}
+
+		void Reset(uint32_t capacity)
+		{
+			m_Capacity = capacity;
+			m_HighWater = 0;
+			m_FreeList.clear();
+		}
+
+		// INVALID_INDEX once every slot is taken
+		uint32_t Allocate()
+		{
+			if (!m_FreeList.empty())
+			{
+				const uint32_t index = m_FreeList.back();
+				m_FreeList.pop_back();
+				return index;
+			}
+			if (m_HighWater >= m_Capacity)
+				return INVALID_INDEX;
+			return m_HighWater++;
+		}
+
+		// Out-of-range indices (including INVALID_INDEX) are ignored
+		void Release(uint32_t index)
+		{
+			if (index < m_HighWater)
+				m_FreeList.push_back(index);
+		}
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_HighWater - static_cast<uint32_t>(m_FreeList.size()); }
+
+	private:
+		uint32_t m_Capacity = 0;
+		uint32_t m_HighWater = 0;
+		std::vector<uint32_t> m_FreeList;
+	};
+}
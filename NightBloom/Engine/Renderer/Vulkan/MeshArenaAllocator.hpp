@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// MeshArenaAllocator.hpp
+//
+// Range bookkeeping for one VulkanMeshArena page. Offsets and counts are in
+// elements (vertices or indices), which is what vkCmdDrawIndexed's
+// vertexOffset/firstIndex take, so no byte alignment is involved. The free list is kept sorted by offset;
+// Allocate takes the smallest range that fits (best fit, so large holes
+// stay whole for large meshes) and Free merges with both neighbours.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace Nightbloom
+{
+	class MeshArenaAllocator
+	{
+	public:
+		static constexpr uint32_t INVALID_OFFSET = ~0u;
+
+		MeshArenaAllocator() = default;
+		explicit MeshArenaAllocator(uint32_t capacity) { Reset(capacity); }
+
+		void Reset(uint32_t capacity)
+		{
+			m_Capacity = capacity;
+			m_Used = 0;
+			m_Free.clear();
+			if (capacity > 0)
+				m_Free.push_back({ 0, capacity });
+		}
+
+		// Returns the first element, or INVALID_OFFSET if no free range fits
+		uint32_t Allocate(uint32_t count)
+		{
+			if (count == 0)
+				return INVALID_OFFSET;
+
+			size_t best = m_Free.size();
+			for (size_t i = 0; i < m_Free.size(); ++i)
+			{
+				if (m_Free[i].count >= count && (best == m_Free.size() || m_Free[i].count < m_Free[best].count))
+				{
+					best = i;
+					if (m_Free[i].count == count)
+						break;
+				}
+			}
+			if (best == m_Free.size())
+				return INVALID_OFFSET;
+
+			const uint32_t offset = m_Free[best].offset;
+			if (m_Free[best].count == count)
+			{
+				m_Free.erase(m_Free.begin() + best);
+			}
+			else
+			{
+				m_Free[best].offset += count;
+				m_Free[best].count -= count;
+			}
+			m_Used += count;
+			return offset;
+		}
+
+		// offset/count must be exactly what an earlier Allocate handed out
+		void Free(uint32_t offset, uint32_t count)
+		{
+			if (count == 0 || offset == INVALID_OFFSET)
+				return;
+
+			auto next = std::lower_bound(m_Free.begin(), m_Free.end(), offset,
+				[](const Range& range, uint32_t value) { return range.offset < value; });
+
+			const bool joinsPrevious = next != m_Free.begin() && std::prev(next)->offset + std::prev(next)->count == offset;
+			const bool joinsNext = next != m_Free.end() && offset + count == next->offset;
+
+			if (joinsPrevious && joinsNext)
+			{
+				std::prev(next)->count += count + next->count;
+				m_Free.erase(next);
+			}
+			else if (joinsPrevious)
+			{
+				std::prev(next)->count += count;
+			}
+			else if (joinsNext)
+			{
+				next->offset = offset;
+				next->count += count;
+			}
+			else
+			{
+				m_Free.insert(next, { offset, count });
+			}
+			m_Used -= count;
+		}
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_Used; }
+		bool IsEmpty() const { return m_Used == 0; }
+		// Number of holes; 1 on an empty page
+		size_t GetFreeRangeCount() const { return m_Free.size(); }
+		uint32_t GetLargestFreeRange() const
+		{
+			uint32_t largest = 0;
+			for (const Range& range : m_Free)
+				largest = std::max(largest, range.count);
+			return largest;
+		}
+
+	private:
+		struct Range
+		{
+			uint32_t offset = 0;
+			uint32_t count = 0;
+		};
+
+		uint32_t m_Capacity = 0;
+		uint32_t m_Used = 0;
+		std::vector<Range> m_Free;   // sorted by offset, never adjacent
+	};
+}
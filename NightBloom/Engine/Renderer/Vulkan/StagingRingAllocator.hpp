@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+// StagingRingAllocator.hpp
+//
+// Offset bookkeeping for VulkanStagingRing. Head and tail are monotonic byte
+// positions (physical offset = position % capacity); an allocation never
+// straddles the end of the buffer, the remainder is skipped instead. Space is
+// given back in allocation order by releasing up to a position previously
+// read from GetHead().
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	class StagingRingAllocator
+	{
+	public:
+		static constexpr uint64_t INVALID_OFFSET = ~0ull;
+
+		StagingRingAllocator() = default;
+		explicit StagingRingAllocator(uint64_t capacity) : m_Capacity(capacity) {}
+
+		void Reset(uint64_t capacity)
+		{
+			m_Capacity = capacity;
+			m_Head = 0;
+			m_Tail = 0;
+		}
+
+		// alignment must be a power of two that divides the capacity. Returns
+		// the physical offset, or INVALID_OFFSET if there is no room right now.
+		uint64_t Allocate(uint64_t size, uint64_t alignment)
+		{
+			if (size == 0 || size > m_Capacity)
+				return INVALID_OFFSET;
+
+			const uint64_t base = m_Head - (m_Head % m_Capacity);
+			uint64_t offset = (m_Head - base + alignment - 1) & ~(alignment - 1);
+			if (offset + size > m_Capacity)
+			{
+				// Wrap: the rest of this lap is lost until it's released
+				if (base + m_Capacity + size - m_Tail > m_Capacity)
+					return INVALID_OFFSET;
+				m_Head = base + m_Capacity + size;
+				return 0;
+			}
+
+			if (base + offset + size - m_Tail > m_Capacity)
+				return INVALID_OFFSET;
+			m_Head = base + offset + size;
+			return offset;
+		}
+
+		// Everything allocated before 'position' (a GetHead() value) is free
+		void Release(uint64_t position)
+		{
+			m_Tail = std::max(m_Tail, std::min(position, m_Head));
+		}
+		void ReleaseAll() { m_Tail = m_Head; }
+
+		uint64_t GetHead() const { return m_Head; }
+		uint64_t GetCapacity() const { return m_Capacity; }
+		uint64_t GetUsed() const { return m_Head - m_Tail; }
+
+	private:
+		uint64_t m_Capacity = 0;
+		uint64_t m_Head = 0;  // next free position
+		uint64_t m_Tail = 0;  // oldest position still in use
+	};
+}
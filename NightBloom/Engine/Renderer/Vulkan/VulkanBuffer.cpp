@@ -7,6 +7,7 @@
 #include "VulkanBuffer.hpp"
 #include "VulkanDevice.hpp"
 #include "VulkanCommandPool.hpp"
+#include "VulkanUploadManager.hpp"
 #include "Core/Logger/Logger.hpp"
 #include <cstring>
 
@@ -50,6 +51,8 @@ namespace Nightbloom
 		m_Size = desc.size;
 		m_Usage = desc.usage;
 		m_MemoryAccess = desc.memoryAccess;
+		m_DeviceAddress = desc.deviceAddress;
+		m_DirectWrite = desc.directWrite;
 		m_DebugName = desc.debugName.empty() ? "UnnamedBuffer" : desc.debugName;
 
 		// Determine if host visible based on memory access
@@ -128,12 +131,32 @@ namespace Nightbloom
 		createInfo.usage = vkUsage;
 		createInfo.memoryUsage = vmaUsage;
 		createInfo.mappable = m_IsHostVisible;
+		createInfo.hostRead = m_MemoryAccess == MemoryAccess::GpuToCpu || m_MemoryAccess == MemoryAccess::CpuCached;
+		createInfo.debugName = m_DebugName.c_str();
+		// Staging is staging whoever asked for it; the rest is tagged by
+		// the caller's GpuMemoryScope
+		if (m_Usage == BufferUsage::Staging)
+			createInfo.category = GpuMemoryCategory::Staging;
+		// Device-local vertex and index buffers are bound through GetBuffer()
+		// at every draw, so defragmentation can move them
+		createInfo.movable = !m_IsHostVisible &&
+			(m_Usage == BufferUsage::Vertex || m_Usage == BufferUsage::Index);
+
+		createInfo.deviceAddress = m_DeviceAddress;
+		// Addressed geometry can feed acceleration structure builds
+		if (m_DeviceAddress && m_Device->SupportsFeature("ray_query") &&
+			(m_Usage == BufferUsage::Vertex || m_Usage == BufferUsage::Index))
+		{
+			createInfo.usage |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+		}
+		createInfo.directWrite = m_DirectWrite;
 
 		// Add flags for persistent mapping
 		if (persistentMap && m_IsHostVisible)
 		{
 			createInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
-			createInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+			if (!createInfo.hostRead)
+				createInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
 		}
 
 		// Create the buffer through VMA
@@ -150,6 +173,15 @@ namespace Nightbloom
 			m_PersistentMapped = m_Allocation->mappedData;
 		}
 
+		// A GpuOnly buffer that got host-visible VRAM: UploadData and Update
+		// write straight into it instead of staging
+		if (!m_IsHostVisible && m_Allocation->mappedData)
+		{
+			m_IsHostVisible = true;
+			m_PersistentMapped = m_Allocation->mappedData;
+			LOG_TRACE("Buffer '{}' is written directly", m_DebugName);
+		}
+
 		return true;
 	}
 
@@ -231,6 +263,16 @@ namespace Nightbloom
 		//LOG_TRACE("Flushed buffer '{}' at offset {}, size {}", m_DebugName, offset, flushSize);
 	}
 
+	void VulkanBuffer::Invalidate(size_t offset, size_t size)
+	{
+		if (!m_IsHostVisible)
+			return;
+
+		// Make GPU writes (a readback copy) visible to CPU reads
+		VkDeviceSize invalidateSize = (size == 0) ? VK_WHOLE_SIZE : size;
+		m_MemoryManager->InvalidateMemory(m_Allocation->allocation, offset, invalidateSize);
+	}
+
 	bool VulkanBuffer::Update(const void* data, size_t size, size_t offset)
 	{
 		// Validate parameters
@@ -289,6 +331,13 @@ namespace Nightbloom
 			return Update(data, size, offset);
 		}
 
+		// Queued on the upload manager: no wait, and batched with any other
+		// uploads inside an UploadBatchScope
+		if (VulkanUploadManager* uploads = m_MemoryManager->GetUploadManager())
+		{
+			return uploads->UploadBuffer(m_Allocation->buffer, data, size, offset);
+		}
+
 		// For device-local buffers, we need staging
 		if (!cmdPool)
 		{
@@ -296,47 +345,36 @@ namespace Nightbloom
 			return false;
 		}
 
-		// Get staging pool from memory manager
-		StagingBufferPool* pool = m_MemoryManager->GetStagingPool();
-		if (!pool)
+		// Blocking fallback (no upload manager): one-off staging buffer
+		VulkanBuffer stagingBuffer(m_Device, m_MemoryManager);
+		BufferDesc stagingDesc;
+		stagingDesc.usage = BufferUsage::Staging;
+		stagingDesc.memoryAccess = MemoryAccess::CpuToGpu;
+		stagingDesc.size = size;
+		stagingDesc.debugName = m_DebugName + "_Staging";
+
+		if (!stagingBuffer.Initialize(stagingDesc) || !stagingBuffer.Update(data, size, 0))
 		{
-			LOG_ERROR("No staging buffer pool available");
+			LOG_ERROR("Failed to stage {} bytes for buffer '{}'", size, m_DebugName);
 			return false;
 		}
 
-		// Use pool for staging
-		bool success = pool->WithStagingBuffer(size,
-			[&](VulkanBuffer* stagingBuffer) {
-				// Upload data to staging
-				if (!stagingBuffer->Update(data, size, 0))
-				{
-					LOG_ERROR("Failed to update staging buffer");
-					return false;
-				}
-
-				// Record copy command
-				VulkanSingleTimeCommand cmd(m_Device, cmdPool);
-				VkCommandBuffer commandBuffer = cmd.Begin();
+		// Record copy command
+		VulkanSingleTimeCommand cmd(m_Device, cmdPool);
+		VkCommandBuffer commandBuffer = cmd.Begin();
 
-				VkBufferCopy copyRegion = {};
-				copyRegion.srcOffset = 0;
-				copyRegion.dstOffset = offset;
-				copyRegion.size = size;
+		VkBufferCopy copyRegion = {};
+		copyRegion.srcOffset = 0;
+		copyRegion.dstOffset = offset;
+		copyRegion.size = size;
 
-				vkCmdCopyBuffer(commandBuffer, stagingBuffer->GetBuffer(),
-					m_Allocation->buffer, 1, &copyRegion);
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer.GetBuffer(),
+			m_Allocation->buffer, 1, &copyRegion);
 
-				cmd.End();
+		cmd.End();
 
-				return true;
-			});
-
-		if (success)
-		{
-			LOG_TRACE("Uploaded {} bytes using pooled staging buffer", size);
-		}
-
-		return success;
+		LOG_TRACE("Uploaded {} bytes using temporary staging buffer", size);
+		return true;
 	}
 
 	VkBufferUsageFlags VulkanBuffer::GetVulkanUsageFlags(BufferUsage usage)
@@ -359,7 +397,11 @@ namespace Nightbloom
 			return VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
 		case BufferUsage::Indirect:
-			return VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			// Storage too: indirect args are normally written by a compute pass
+			return VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+		case BufferUsage::ComputeVertex:
+			return VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
 		//case BufferUsage::Query:
 		//	return VK_BUFFER_USAGE_TRANSFER_DST_BIT;
@@ -36,6 +36,8 @@ namespace Nightbloom
 		void* Map(size_t offset = 0, size_t size = 0) override;
 		void Unmap() override;
 		void Flush(size_t offset = 0, size_t size = 0) override;
+		// Before reading what the GPU wrote into a GpuToCpu/CpuCached buffer
+		void Invalidate(size_t offset = 0, size_t size = 0);
 
 		bool Update(const void* data, size_t size, size_t offset = 0) override;
 
@@ -47,6 +49,10 @@ namespace Nightbloom
 		// Vulkan Specific
 		VkBuffer GetBuffer() const { return m_Allocation ? m_Allocation->buffer : VK_NULL_HANDLE; }
 		VulkanMemoryManager::BufferAllocation* GetAllocation() const { return m_Allocation; }
+		// GPU pointer to the buffer, for the geometry of acceleration
+		// structure builds (RayTracedShadows). 0 unless created with
+		// BufferDesc::deviceAddress on a device that supports it.
+		VkDeviceAddress GetDeviceAddress() const { return m_Allocation ? m_Allocation->deviceAddress : 0; }
 
 	private:
 		//----------------------------------------------------------------------
@@ -71,6 +77,8 @@ namespace Nightbloom
 		BufferUsage m_Usage = BufferUsage::Vertex;
 		MemoryAccess m_MemoryAccess = MemoryAccess::GpuOnly;
 		bool m_IsHostVisible = false;
+		bool m_DeviceAddress = false;
+		bool m_DirectWrite = false;
 		std::string m_DebugName;
 
 		void* m_MappedData = nullptr;           // Current mapped pointer
@@ -160,8 +160,24 @@ namespace Nightbloom
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &m_CommandBuffer;
 
-		vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(m_Device->GetGraphicsQueue());
+		// Submit to the pool's own family (a compute-family pool can't record
+		// for the graphics queue). Wait on this submission only, not on
+		// everything else the queue holds (frames in flight, queued uploads)
+		VkQueue queue = m_Device->GetQueueForFamily(m_CommandPool->GetQueueFamilyIndex());
+		VkFence fence = VK_NULL_HANDLE;
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(m_Device->GetDevice(), &fenceInfo, nullptr, &fence) == VK_SUCCESS)
+		{
+			vkQueueSubmit(queue, 1, &submitInfo, fence);
+			vkWaitForFences(m_Device->GetDevice(), 1, &fence, VK_TRUE, UINT64_MAX);
+			vkDestroyFence(m_Device->GetDevice(), fence, nullptr);
+		}
+		else
+		{
+			vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+			vkQueueWaitIdle(queue);
+		}
 
 		m_CommandPool->FreeCommandBuffer(m_CommandBuffer);
 		m_CommandBuffer = VK_NULL_HANDLE;
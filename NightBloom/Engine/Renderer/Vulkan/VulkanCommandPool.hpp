@@ -35,6 +35,7 @@ namespace Nightbloom
 
 		// Getters
 		VkCommandPool GetPool() const { return m_CommandPool; }
+		uint32_t GetQueueFamilyIndex() const { return m_QueueFamilyIndex; }
 
 	private:
 		VulkanDevice* m_Device = nullptr;
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// VulkanDebugMarkers.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+#if NB_GPU_MARKERS_ENABLED
+	namespace
+	{
+		// Pipeline names for InsertPipelineLabel. Pipelines are created on
+		// job threads (CloudSystem), so it is locked. Entries outlive their
+		// pipelines until the handle is reused and named again.
+		std::mutex s_PipelineNamesMutex;
+		std::unordered_map<uint64_t, std::string> s_PipelineNames;
+
+		VkDebugUtilsLabelEXT MakeLabel(const char* name)
+		{
+			VkDebugUtilsLabelEXT label{};
+			label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+			label.pLabelName = name ? name : "";
+			return label;
+		}
+	}
+
+	void VulkanDebugMarkers::Load(VkInstance instance)
+	{
+		// Instance-level: the loader dispatches them to whichever layer
+		// (a capture tool's) or driver implements them
+		s_CmdBeginLabel = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+			vkGetInstanceProcAddr(instance, "vkCmdBeginDebugUtilsLabelEXT"));
+		s_CmdEndLabel = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+			vkGetInstanceProcAddr(instance, "vkCmdEndDebugUtilsLabelEXT"));
+		s_CmdInsertLabel = reinterpret_cast<PFN_vkCmdInsertDebugUtilsLabelEXT>(
+			vkGetInstanceProcAddr(instance, "vkCmdInsertDebugUtilsLabelEXT"));
+		s_SetObjectName = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(
+			vkGetInstanceProcAddr(instance, "vkSetDebugUtilsObjectNameEXT"));
+
+		// Labels come in pairs: all or nothing
+		if (!s_CmdBeginLabel || !s_CmdEndLabel)
+		{
+			s_CmdBeginLabel = nullptr;
+			s_CmdEndLabel = nullptr;
+		}
+	}
+
+	void VulkanDebugMarkers::Unload()
+	{
+		s_CmdBeginLabel = nullptr;
+		s_CmdEndLabel = nullptr;
+		s_CmdInsertLabel = nullptr;
+		s_SetObjectName = nullptr;
+
+		std::lock_guard<std::mutex> lock(s_PipelineNamesMutex);
+		s_PipelineNames.clear();
+	}
+
+	void VulkanDebugMarkers::BeginLabelImpl(VkCommandBuffer cmd, const char* name)
+	{
+		const VkDebugUtilsLabelEXT label = MakeLabel(name);
+		s_CmdBeginLabel(cmd, &label);
+	}
+
+	void VulkanDebugMarkers::InsertLabelImpl(VkCommandBuffer cmd, const char* name)
+	{
+		const VkDebugUtilsLabelEXT label = MakeLabel(name);
+		s_CmdInsertLabel(cmd, &label);
+	}
+
+	void VulkanDebugMarkers::SetNameImpl(VkDevice device, VkObjectType type, uint64_t handle, const char* name)
+	{
+		if (handle == 0 || !name || !*name)
+			return;
+
+		VkDebugUtilsObjectNameInfoEXT info{};
+		info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+		info.objectType = type;
+		info.objectHandle = handle;
+		info.pObjectName = name;
+		s_SetObjectName(device, &info);
+	}
+
+	void VulkanDebugMarkers::SetPipelineNameImpl(VkDevice device, VkPipeline pipeline, const char* name)
+	{
+		if (pipeline == VK_NULL_HANDLE || !name || !*name)
+			return;
+
+		const uint64_t handle = reinterpret_cast<uint64_t>(pipeline);
+		SetNameImpl(device, VK_OBJECT_TYPE_PIPELINE, handle, name);
+
+		std::lock_guard<std::mutex> lock(s_PipelineNamesMutex);
+		s_PipelineNames[handle] = name;
+	}
+
+	void VulkanDebugMarkers::InsertPipelineLabelImpl(VkCommandBuffer cmd, VkPipeline pipeline)
+	{
+		std::lock_guard<std::mutex> lock(s_PipelineNamesMutex);
+		auto it = s_PipelineNames.find(reinterpret_cast<uint64_t>(pipeline));
+		if (it != s_PipelineNames.end())
+			InsertLabelImpl(cmd, it->second.c_str());
+	}
+#else
+	void VulkanDebugMarkers::Load(VkInstance) {}
+	void VulkanDebugMarkers::Unload() {}
+#endif
+}
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// VulkanDebugMarkers.hpp
+//
+// VK_EXT_debug_utils labels and object names for external GPU tools
+// (RenderDoc, Nsight, RGP), so captures show passes and named resources
+// instead of bare handles.
+//
+//   GpuProfiler       every scope it records opens a label of the same name,
+//                     so RenderGraph passes, shadow cascades and the async
+//                     compute scopes become regions in the capture
+//   ComputeDispatcher marks each pipeline it binds with the pipeline's name
+//   creation sites    name their pipelines (SetName); VulkanMemoryManager
+//                     names every buffer and image it allocates, and the VMA
+//                     allocation behind it
+//
+// VulkanDevice enables the instance extension whenever the loader offers
+// it and calls Load once the device exists. Until then, or when the
+// extension is missing, each call is a single null check. Built with
+// NB_GPU_MARKERS_ENABLED=0 (the NIGHTBLOOM_ENABLE_GPU_MARKERS CMake option)
+// they compile to nothing.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+#ifndef NB_GPU_MARKERS_ENABLED
+#define NB_GPU_MARKERS_ENABLED 1
+#endif
+
+namespace Nightbloom
+{
+	class VulkanDebugMarkers
+	{
+	public:
+		// Entry points from an instance created with VK_EXT_debug_utils
+		static void Load(VkInstance instance);
+		// Before the device is destroyed
+		static void Unload();
+
+		static bool IsEnabled()
+		{
+#if NB_GPU_MARKERS_ENABLED
+			return s_SetObjectName != nullptr;
+#else
+			return false;
+#endif
+		}
+
+		// Labels nest per queue; a label may end in a later primary command
+		// buffer of the same queue than the one it began in
+		static void BeginLabel(VkCommandBuffer cmd, const char* name)
+		{
+#if NB_GPU_MARKERS_ENABLED
+			if (s_CmdBeginLabel) BeginLabelImpl(cmd, name);
+#endif
+		}
+
+		static void EndLabel(VkCommandBuffer cmd)
+		{
+#if NB_GPU_MARKERS_ENABLED
+			if (s_CmdEndLabel) s_CmdEndLabel(cmd);
+#endif
+		}
+
+		static void InsertLabel(VkCommandBuffer cmd, const char* name)
+		{
+#if NB_GPU_MARKERS_ENABLED
+			if (s_CmdInsertLabel) InsertLabelImpl(cmd, name);
+#endif
+		}
+
+		// Names a pipeline; also remembered for InsertPipelineLabel
+		static void SetName(VkDevice device, VkPipeline pipeline, const char* name)
+		{
+#if NB_GPU_MARKERS_ENABLED
+			if (s_SetObjectName) SetPipelineNameImpl(device, pipeline, name);
+#endif
+		}
+
+		static void SetName(VkDevice device, VkObjectType type, uint64_t handle, const char* name)
+		{
+#if NB_GPU_MARKERS_ENABLED
+			if (s_SetObjectName) SetNameImpl(device, type, handle, name);
+#endif
+		}
+
+		// A marker carrying the name `pipeline` was given (nothing if none)
+		static void InsertPipelineLabel(VkCommandBuffer cmd, VkPipeline pipeline)
+		{
+#if NB_GPU_MARKERS_ENABLED
+			if (s_CmdInsertLabel) InsertPipelineLabelImpl(cmd, pipeline);
+#endif
+		}
+
+	private:
+#if NB_GPU_MARKERS_ENABLED
+		static void BeginLabelImpl(VkCommandBuffer cmd, const char* name);
+		static void InsertLabelImpl(VkCommandBuffer cmd, const char* name);
+		static void SetNameImpl(VkDevice device, VkObjectType type, uint64_t handle, const char* name);
+		static void SetPipelineNameImpl(VkDevice device, VkPipeline pipeline, const char* name);
+		static void InsertPipelineLabelImpl(VkCommandBuffer cmd, VkPipeline pipeline);
+
+		static inline PFN_vkCmdBeginDebugUtilsLabelEXT s_CmdBeginLabel = nullptr;
+		static inline PFN_vkCmdEndDebugUtilsLabelEXT s_CmdEndLabel = nullptr;
+		static inline PFN_vkCmdInsertDebugUtilsLabelEXT s_CmdInsertLabel = nullptr;
+		static inline PFN_vkSetDebugUtilsObjectNameEXT s_SetObjectName = nullptr;
+#endif
+	};
+}
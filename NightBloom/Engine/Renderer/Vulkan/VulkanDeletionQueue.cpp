@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+// VulkanDeletionQueue.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+
+namespace Nightbloom
+{
+	void VulkanDeletionQueue::Defer(std::function<void()> destroy)
+	{
+		// Nothing in flight (or no timeline): the object is already unused
+		const uint64_t value = m_Timeline ? m_Timeline->GetLastSubmittedValue() : 0;
+		if (value == 0 || m_Timeline->IsComplete(value))
+		{
+			destroy();
+			return;
+		}
+		m_Entries.push_back({ value, std::move(destroy) });
+	}
+
+	void VulkanDeletionQueue::Collect()
+	{
+		if (m_Entries.empty())
+			return;
+
+		const uint64_t completed = m_Timeline->GetCompletedValue();
+		while (!m_Entries.empty() && m_Entries.front().value <= completed)
+		{
+			// Pop first: a callback may defer more work
+			std::function<void()> destroy = std::move(m_Entries.front().destroy);
+			m_Entries.pop_front();
+			destroy();
+		}
+	}
+
+	void VulkanDeletionQueue::Flush()
+	{
+		while (!m_Entries.empty())
+		{
+			std::function<void()> destroy = std::move(m_Entries.front().destroy);
+			m_Entries.pop_front();
+			destroy();
+		}
+	}
+}
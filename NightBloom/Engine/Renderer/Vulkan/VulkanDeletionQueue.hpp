@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+// VulkanDeletionQueue.hpp
+//
+// Destruction deferred until the GPU is done with an object. Defer() tags
+// the callback with the graphics timeline's last submitted value; Collect()
+// (once per frame) runs every callback whose value has completed, in the
+// order they were deferred. Lets the swapchain and the framebuffers over
+// its images be replaced while earlier frames are still in flight, instead
+// of idling the device first.
+//
+// Not thread-safe: used from the render thread like the timeline it reads.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace Nightbloom
+{
+	class VulkanQueueTimeline;
+
+	class VulkanDeletionQueue
+	{
+	public:
+		VulkanDeletionQueue() = default;
+		~VulkanDeletionQueue() = default;
+
+		void Initialize(VulkanQueueTimeline* timeline) { m_Timeline = timeline; }
+
+		// Runs `destroy` once everything submitted so far has finished
+		void Defer(std::function<void()> destroy);
+
+		// Runs the callbacks whose work has completed
+		void Collect();
+
+		// Runs every callback; the caller must have idled the device
+		void Flush();
+
+		size_t GetPendingCount() const { return m_Entries.size(); }
+
+	private:
+		struct Entry
+		{
+			uint64_t value = 0;
+			std::function<void()> destroy;
+		};
+
+		VulkanQueueTimeline* m_Timeline = nullptr;
+		std::deque<Entry> m_Entries;   // non-decreasing values
+
+		VulkanDeletionQueue(const VulkanDeletionQueue&) = delete;
+		VulkanDeletionQueue& operator=(const VulkanDeletionQueue&) = delete;
+	};
+}
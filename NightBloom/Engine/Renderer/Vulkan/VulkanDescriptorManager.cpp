@@ -1,8 +1,10 @@
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
 
 namespace Nightbloom
 {
@@ -19,9 +21,10 @@ namespace Nightbloom
 	bool VulkanDescriptorManager::Initialize()
 	{
 		LOG_INFO("Initializing VulkanDescriptorManager");
+		m_UsePushDescriptors = m_Device->SupportsFeature("push_descriptor");
 
 		// Create descriptor pool
-		std::array<VkDescriptorPoolSize, 4> poolSizes{};
+		std::array<VkDescriptorPoolSize, 6> poolSizes{};
 		poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		poolSizes[0].descriptorCount = MAX_DESCRIPTOR_SETS;
 		poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -30,10 +33,15 @@ namespace Nightbloom
 		poolSizes[2].descriptorCount = MAX_DESCRIPTOR_SETS;
 		poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
 		poolSizes[3].descriptorCount = MAX_DESCRIPTOR_SETS;
+		poolSizes[4].type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;  // OIT composite only
+		poolSizes[4].descriptorCount = 8;
+		poolSizes[5].type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;  // traced sun shadows only
+		poolSizes[5].descriptorCount = MAX_FRAMES_IN_FLIGHT * 2;
+		const uint32_t poolSizeCount = m_Device->SupportsFeature("ray_query") ? 6u : 5u;
 
 		VkDescriptorPoolCreateInfo poolInfo{};
 		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.poolSizeCount = poolSizeCount;
 		poolInfo.pPoolSizes = poolSizes.data();
 		poolInfo.maxSets = MAX_DESCRIPTOR_SETS;
 		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
@@ -134,6 +142,13 @@ namespace Nightbloom
 					return false;
 				}
 			}
+
+			m_ShadowLayeredUniformDescriptorSets[i] = AllocateShadowUniformSet(i);
+			if (m_ShadowLayeredUniformDescriptorSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("Failed to allocate layered shadow uniform descriptor set for frame {}", i);
+				return false;
+			}
 		}
 
 		// Allocate reflection UNIFORM descriptor sets (set 0 in the planar
@@ -147,6 +162,16 @@ namespace Nightbloom
 				LOG_ERROR("Failed to allocate reflection uniform descriptor set for frame {}", i);
 				return false;
 			}
+
+			for (uint32_t view = 0; view < MAX_AUXILIARY_VIEWS; ++view)
+			{
+				m_AuxiliaryUniformDescriptorSets[i][view] = AllocateReflectionUniformSet(i);
+				if (m_AuxiliaryUniformDescriptorSets[i][view] == VK_NULL_HANDLE)
+				{
+					LOG_ERROR("Failed to allocate auxiliary view {} uniform descriptor set for frame {}", view, i);
+					return false;
+				}
+			}
 		}
 
 		// Create compute storage layout
@@ -188,6 +213,13 @@ namespace Nightbloom
 			return false;
 		}
 
+		m_FireflyGridSetLayout = CreateFireflyGridSetLayout();
+		if (m_FireflyGridSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create firefly grid descriptor set layout");
+			return false;
+		}
+
 		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_FireflyParamsDescriptorSets[i] = AllocateFireflyParamsSet(i);
@@ -198,6 +230,25 @@ namespace Nightbloom
 			}
 		}
 
+		// Create particle storage + emitter set layouts
+		m_ParticleStorageSetLayout = CreateParticleStorageSetLayout();
+		m_ParticleParamsSetLayout = CreateParticleParamsSetLayout();
+		if (m_ParticleStorageSetLayout == VK_NULL_HANDLE || m_ParticleParamsSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create particle descriptor set layouts");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_ParticleParamsDescriptorSets[i] = AllocateParticleParamsSet(i);
+			if (m_ParticleParamsDescriptorSets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("Failed to allocate particle emitter descriptor set for frame {}", i);
+				return false;
+			}
+		}
+
 		// Create cloud set layout + per-frame sets
 		m_CloudSetLayout = CreateCloudSetLayout();
 		if (m_CloudSetLayout == VK_NULL_HANDLE)
@@ -223,6 +274,13 @@ namespace Nightbloom
 			return false;
 		}
 
+		m_CloudHistorySetLayout = CreateCloudHistorySetLayout();
+		if (m_CloudHistorySetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create cloud history descriptor set layout");
+			return false;
+		}
+
 		// Create foliage storage set layout
 		m_FoliageStorageSetLayout = CreateFoliageStorageSetLayout();
 		if (m_FoliageStorageSetLayout == VK_NULL_HANDLE)
@@ -231,6 +289,23 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Create foliage cull (compute) set layout
+		m_FoliageCullSetLayout = CreateFoliageCullSetLayout();
+		if (m_FoliageCullSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create foliage cull descriptor set layout");
+			return false;
+		}
+
+		// Create Hi-Z pyramid layouts (reduce: sampled source + storage target; sample: pyramid for cull shaders)
+		m_HiZReduceSetLayout = CreateHiZReduceSetLayout();
+		m_HiZSampleSetLayout = CreateHiZSampleSetLayout();
+		if (m_HiZReduceSetLayout == VK_NULL_HANDLE || m_HiZSampleSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create Hi-Z descriptor set layouts");
+			return false;
+		}
+
 		// Create post-process input set layout
 		m_PostProcessInputSetLayout = CreatePostProcessInputSetLayout();
 		if (m_PostProcessInputSetLayout == VK_NULL_HANDLE)
@@ -239,6 +314,14 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Create OIT input set layout (the OIT composite subpass)
+		m_OitInputSetLayout = CreateOitInputSetLayout();
+		if (m_OitInputSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create OIT input descriptor set layout");
+			return false;
+		}
+
 		// Create reflection input set layout (water samples the reflection target)
 		m_ReflectionInputSetLayout = CreateReflectionInputSetLayout();
 		if (m_ReflectionInputSetLayout == VK_NULL_HANDLE)
@@ -247,6 +330,62 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Create temporal resolve set layout (TemporalUpscaler's compute pass)
+		m_TemporalResolveSetLayout = CreateTemporalResolveSetLayout();
+		if (m_TemporalResolveSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create temporal resolve descriptor set layout");
+			return false;
+		}
+
+		// Create screen-space reflection set layout (ScreenSpaceReflections)
+		m_ScreenSpaceReflectionSetLayout = CreateScreenSpaceReflectionSetLayout();
+		if (m_ScreenSpaceReflectionSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create screen-space reflection descriptor set layout");
+			return false;
+		}
+
+		// Create ocean wave set layouts (OceanWaves' compute passes, Water set 3)
+		m_OceanComputeSetLayout = CreateOceanComputeSetLayout();
+		m_OceanSampleSetLayout = CreateOceanSampleSetLayout();
+		if (m_OceanComputeSetLayout == VK_NULL_HANDLE || m_OceanSampleSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create ocean wave descriptor set layouts");
+			return false;
+		}
+
+		// Create bloom mip set layout (BloomMipChain's compute steps)
+		m_BloomMipSetLayout = CreateBloomMipSetLayout();
+		if (m_BloomMipSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create bloom mip descriptor set layout");
+			return false;
+		}
+
+		// Create mip downsample set layout (MipGenerator)
+		m_MipDownsampleSetLayout = CreateMipDownsampleSetLayout();
+		if (m_MipDownsampleSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create mip downsample descriptor set layout");
+			return false;
+		}
+
+		// Create atmosphere LUT set layout (AtmosphereLuts)
+		m_AtmosphereLutSetLayout = CreateAtmosphereLutSetLayout();
+		if (m_AtmosphereLutSetLayout == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to create atmosphere LUT descriptor set layout");
+			return false;
+		}
+
+		// Optional: without it the mesh passes bind per-texture sets
+		if (m_Device->SupportsFeature("descriptor_indexing") && !InitializeBindless())
+		{
+			LOG_WARN("Bindless descriptor table unavailable, using per-texture descriptor sets");
+			CleanupBindless();
+		}
+
 		LOG_INFO("VulkanDescriptorManager initialized successfully");
 		return true;
 	}
@@ -259,6 +398,207 @@ namespace Nightbloom
 		vkFreeDescriptorSets(m_Device->GetDevice(), m_DescriptorPool, 1, &set);
 	}
 
+	// =====================================================================
+	// Content-keyed set cache
+	// =====================================================================
+
+	size_t VulkanDescriptorManager::HashSetContents(VkDescriptorSetLayout layout,
+		const std::vector<DescriptorWrite>& writes)
+	{
+		// Same mixing as boost::hash_combine
+		size_t hash = 0;
+		auto combine = [&hash](uint64_t value) {
+			hash ^= std::hash<uint64_t>{}(value) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+		};
+
+		combine(reinterpret_cast<uint64_t>(layout));
+		for (const DescriptorWrite& write : writes)
+		{
+			combine((static_cast<uint64_t>(write.binding) << 32) | static_cast<uint32_t>(write.type));
+			combine(reinterpret_cast<uint64_t>(write.imageView));
+			combine(reinterpret_cast<uint64_t>(write.sampler));
+			combine(static_cast<uint64_t>(write.imageLayout));
+			combine(reinterpret_cast<uint64_t>(write.buffer));
+			combine(write.offset);
+			combine(write.range);
+		}
+		return hash;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AcquireCachedSet(VkDescriptorSetLayout layout,
+		const std::vector<DescriptorWrite>& writes)
+	{
+		if (layout == VK_NULL_HANDLE || !m_Device)
+			return VK_NULL_HANDLE;
+
+		const size_t hash = HashSetContents(layout, writes);
+		auto range = m_SetCache.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second.layout == layout && it->second.writes == writes)
+			{
+				++it->second.refCount;
+				return it->second.set;
+			}
+		}
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &layout;
+
+		VkDescriptorSet set = VK_NULL_HANDLE;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate cached descriptor set");
+			return VK_NULL_HANDLE;
+		}
+
+		std::vector<VkDescriptorImageInfo> imageInfos(writes.size());
+		std::vector<VkDescriptorBufferInfo> bufferInfos(writes.size());
+		std::vector<VkWriteDescriptorSet> vkWrites(writes.size());
+		for (size_t i = 0; i < writes.size(); ++i)
+		{
+			const DescriptorWrite& write = writes[i];
+
+			VkWriteDescriptorSet& vkWrite = vkWrites[i];
+			vkWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			vkWrite.dstSet = set;
+			vkWrite.dstBinding = write.binding;
+			vkWrite.dstArrayElement = 0;
+			vkWrite.descriptorType = write.type;
+			vkWrite.descriptorCount = 1;
+
+			if (write.buffer != VK_NULL_HANDLE)
+			{
+				bufferInfos[i] = { write.buffer, write.offset, write.range };
+				vkWrite.pBufferInfo = &bufferInfos[i];
+			}
+			else
+			{
+				imageInfos[i] = { write.sampler, write.imageView, write.imageLayout };
+				vkWrite.pImageInfo = &imageInfos[i];
+			}
+		}
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(vkWrites.size()), vkWrites.data(), 0, nullptr);
+
+		CachedSet entry;
+		entry.layout = layout;
+		entry.writes = writes;
+		entry.set = set;
+		entry.refCount = 1;
+		m_SetCache.emplace(hash, std::move(entry));
+		m_CachedSetHashes[set] = hash;
+		return set;
+	}
+
+	void VulkanDescriptorManager::ReleaseCachedSet(VkDescriptorSet set)
+	{
+		auto hashIt = m_CachedSetHashes.find(set);
+		if (hashIt == m_CachedSetHashes.end())
+			return;
+
+		auto range = m_SetCache.equal_range(hashIt->second);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second.set != set)
+				continue;
+
+			if (--it->second.refCount == 0)
+			{
+				FreeDescriptorSet(set);
+				m_SetCache.erase(it);
+				m_CachedSetHashes.erase(hashIt);
+			}
+			return;
+		}
+	}
+
+	// =====================================================================
+	// Transient sets (per-frame pools, reset in bulk)
+	// =====================================================================
+
+	VkDescriptorPool VulkanDescriptorManager::CreateTransientPool()
+	{
+		std::array<VkDescriptorPoolSize, 4> poolSizes{};
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSizes[0].descriptorCount = TRANSIENT_POOL_SETS * 4;
+		poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		poolSizes[1].descriptorCount = TRANSIENT_POOL_SETS * 2;
+		poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[2].descriptorCount = TRANSIENT_POOL_SETS * 4;
+		poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		poolSizes[3].descriptorCount = TRANSIENT_POOL_SETS;
+
+		// No FREE_DESCRIPTOR_SET bit: sets only ever go back via
+		// vkResetDescriptorPool, which keeps allocation a pointer bump
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = TRANSIENT_POOL_SETS;
+
+		VkDescriptorPool pool = VK_NULL_HANDLE;
+		if (vkCreateDescriptorPool(m_Device->GetDevice(), &poolInfo, nullptr, &pool) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create transient descriptor pool");
+			return VK_NULL_HANDLE;
+		}
+		return pool;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateTransientSet(VkDescriptorSetLayout layout)
+	{
+		if (layout == VK_NULL_HANDLE || !m_Device)
+			return VK_NULL_HANDLE;
+
+		std::vector<VkDescriptorPool>& pools = m_TransientPools[m_TransientFrame];
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &layout;
+
+		// Full pools are skipped for the rest of the frame. A set that doesn't
+		// fit even a brand-new pool is a bug in the pool sizes, not pressure.
+		for (;;)
+		{
+			bool freshPool = false;
+			if (m_TransientPoolIndex == pools.size())
+			{
+				VkDescriptorPool pool = CreateTransientPool();
+				if (pool == VK_NULL_HANDLE)
+					return VK_NULL_HANDLE;
+				pools.push_back(pool);
+				freshPool = true;
+			}
+
+			allocInfo.descriptorPool = pools[m_TransientPoolIndex];
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			VkResult result = vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set);
+			if (result == VK_SUCCESS)
+				return set;
+
+			const bool poolFull = (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL);
+			if (!poolFull || freshPool)
+				break;
+			++m_TransientPoolIndex;
+		}
+
+		LOG_ERROR("Failed to allocate transient descriptor set");
+		return VK_NULL_HANDLE;
+	}
+
+	void VulkanDescriptorManager::ResetTransientSets(uint32_t frameIndex)
+	{
+		m_TransientFrame = frameIndex % MAX_FRAMES_IN_FLIGHT;
+		m_TransientPoolIndex = 0;
+
+		for (VkDescriptorPool pool : m_TransientPools[m_TransientFrame])
+			vkResetDescriptorPool(m_Device->GetDevice(), pool, 0);
+	}
+
 	void VulkanDescriptorManager::Cleanup()
 	{
 		VkDevice device = m_Device ? m_Device->GetDevice() : VK_NULL_HANDLE;
@@ -270,6 +610,8 @@ namespace Nightbloom
 		{
 			vkResetDescriptorPool(m_Device->GetDevice(), m_DescriptorPool, 0);
 		}
+		m_SetCache.clear();
+		m_CachedSetHashes.clear();
 
 		if (m_TextureSetLayout != VK_NULL_HANDLE)
 		{
@@ -313,6 +655,12 @@ namespace Nightbloom
 			m_HeightmapSetLayout = VK_NULL_HANDLE;
 		}
 
+		if (m_FireflyGridSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_FireflyGridSetLayout, nullptr);
+			m_FireflyGridSetLayout = VK_NULL_HANDLE;
+		}
+
 		if (m_FireflyStorageSetLayout != VK_NULL_HANDLE)
 		{
 			vkDestroyDescriptorSetLayout(device, m_FireflyStorageSetLayout, nullptr);
@@ -325,6 +673,18 @@ namespace Nightbloom
 			m_FireflyParamsSetLayout = VK_NULL_HANDLE;
 		}
 
+		if (m_ParticleStorageSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_ParticleStorageSetLayout, nullptr);
+			m_ParticleStorageSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_ParticleParamsSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_ParticleParamsSetLayout, nullptr);
+			m_ParticleParamsSetLayout = VK_NULL_HANDLE;
+		}
+
 		if (m_CloudSetLayout != VK_NULL_HANDLE)
 		{
 			vkDestroyDescriptorSetLayout(device, m_CloudSetLayout, nullptr);
@@ -337,29 +697,111 @@ namespace Nightbloom
 			m_CloudResultSetLayout = VK_NULL_HANDLE;
 		}
 
+		if (m_CloudHistorySetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_CloudHistorySetLayout, nullptr);
+			m_CloudHistorySetLayout = VK_NULL_HANDLE;
+		}
+
 		if (m_FoliageStorageSetLayout != VK_NULL_HANDLE)
 		{
 			vkDestroyDescriptorSetLayout(device, m_FoliageStorageSetLayout, nullptr);
 			m_FoliageStorageSetLayout = VK_NULL_HANDLE;
 		}
 
+		if (m_FoliageCullSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_FoliageCullSetLayout, nullptr);
+			m_FoliageCullSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_HiZReduceSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_HiZReduceSetLayout, nullptr);
+			m_HiZReduceSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_HiZSampleSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_HiZSampleSetLayout, nullptr);
+			m_HiZSampleSetLayout = VK_NULL_HANDLE;
+		}
+
 		if (m_PostProcessInputSetLayout != VK_NULL_HANDLE)
 		{
 			vkDestroyDescriptorSetLayout(device, m_PostProcessInputSetLayout, nullptr);
 			m_PostProcessInputSetLayout = VK_NULL_HANDLE;
 		}
 
+		if (m_OitInputSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_OitInputSetLayout, nullptr);
+			m_OitInputSetLayout = VK_NULL_HANDLE;
+		}
+
 		if (m_ReflectionInputSetLayout != VK_NULL_HANDLE)
 		{
 			vkDestroyDescriptorSetLayout(device, m_ReflectionInputSetLayout, nullptr);
 			m_ReflectionInputSetLayout = VK_NULL_HANDLE;
 		}
 
+		if (m_TemporalResolveSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_TemporalResolveSetLayout, nullptr);
+			m_TemporalResolveSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_ScreenSpaceReflectionSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_ScreenSpaceReflectionSetLayout, nullptr);
+			m_ScreenSpaceReflectionSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_OceanComputeSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_OceanComputeSetLayout, nullptr);
+			m_OceanComputeSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_OceanSampleSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_OceanSampleSetLayout, nullptr);
+			m_OceanSampleSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_BloomMipSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_BloomMipSetLayout, nullptr);
+			m_BloomMipSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_MipDownsampleSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_MipDownsampleSetLayout, nullptr);
+			m_MipDownsampleSetLayout = VK_NULL_HANDLE;
+		}
+
+		if (m_AtmosphereLutSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_AtmosphereLutSetLayout, nullptr);
+			m_AtmosphereLutSetLayout = VK_NULL_HANDLE;
+		}
+
 		if (m_DescriptorPool != VK_NULL_HANDLE)
 		{
 			vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
 			m_DescriptorPool = VK_NULL_HANDLE;
 		}
+
+		for (std::vector<VkDescriptorPool>& pools : m_TransientPools)
+		{
+			for (VkDescriptorPool pool : pools)
+				vkDestroyDescriptorPool(device, pool, nullptr);
+			pools.clear();
+		}
+		m_TransientPoolIndex = 0;
+
+		CleanupBindless();
 	}
 
 	VkDescriptorSetLayout VulkanDescriptorManager::CreateTextureSetLayout()
@@ -372,7 +814,8 @@ namespace Nightbloom
 			bindings[i].descriptorCount = 1;
 			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 			bindings[i].pImmutableSamplers = nullptr;
-			bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			// Compute: TerrainVirtualPage.comp blends the terrain's layers
+			bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
 		}
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
@@ -400,11 +843,63 @@ namespace Nightbloom
 		// pipelines are unaffected by widening this (they just don't use
 		// the extra visibility).
 		uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+		// TerrainTess.tese projects the vertices it creates
+		if (m_Device->SupportsFeature("tessellation"))
+			uboBinding.stageFlags |= VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+
+		// Per-instance model matrices for batched mesh draws (Mesh.vert and
+		// Shadow.vert index it with gl_InstanceIndex). Lives here so the camera,
+		// shadow and reflection passes all see it through their own set 0.
+		VkDescriptorSetLayoutBinding instanceBinding{};
+		instanceBinding.binding = 1;
+		instanceBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		instanceBinding.descriptorCount = 1;
+		instanceBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+		// The wind field (WindField) - grass sways with it, the water ripples
+		// with its gusts, in every pass that draws them
+		VkDescriptorSetLayoutBinding windBinding{};
+		windBinding.binding = 2;
+		windBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		windBinding.descriptorCount = 1;
+		windBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		// The atmosphere (AtmosphereLuts) - the sky-view LUT the sky and the
+		// water's reflection look up (3), the aerial-perspective froxels the
+		// terrain fades into (4). COMPUTE: the environment probe's capture
+		// looks the sky up too.
+		VkDescriptorSetLayoutBinding skyViewBinding{};
+		skyViewBinding.binding = 3;
+		skyViewBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		skyViewBinding.descriptorCount = 1;
+		skyViewBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutBinding aerialBinding = skyViewBinding;
+		aerialBinding.binding = 4;
+
+		// The clouds' shadow map (CloudSystem) - the lit passes' sunlight and
+		// the cloud raymarch's self-shadowing read it
+		VkDescriptorSetLayoutBinding cloudShadowBinding = skyViewBinding;
+		cloudShadowBinding.binding = 5;
+		cloudShadowBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		// The terrain's sun shadow map (TerrainSystem) - the lit passes'
+		// sunlight past the cascades the terrain casts into
+		VkDescriptorSetLayoutBinding terrainShadowBinding = skyViewBinding;
+		terrainShadowBinding.binding = 6;
+
+		// The environment probe (EnvironmentProbeCache) - the meshes'
+		// reflections and the screen-space reflection's misses
+		VkDescriptorSetLayoutBinding environmentBinding = cloudShadowBinding;
+		environmentBinding.binding = 7;
+
+		std::array<VkDescriptorSetLayoutBinding, 8> bindings = { uboBinding, instanceBinding, windBinding,
+			skyViewBinding, aerialBinding, cloudShadowBinding, terrainShadowBinding, environmentBinding };
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &uboBinding;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
@@ -417,18 +912,28 @@ namespace Nightbloom
 
 	VkDescriptorSetLayout VulkanDescriptorManager::CreateLightingSetLayout()
 	{
-		VkDescriptorSetLayoutBinding lightingBinding{};
-		lightingBinding.binding = 0;
-		lightingBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		lightingBinding.descriptorCount = 1;
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		bindings[0].descriptorCount = 1;
 		// COMPUTE included so CloudRaymarch.comp can read the sun light -
 		// existing graphics pipelines are unaffected by widening this.
-		lightingBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
+		// Clustered point lights and the per-cluster lists, written by the
+		// light cluster passes (compute) and read by the lit fragment shaders
+		for (uint32_t i = 1; i < 3; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+		}
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &lightingBinding;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
@@ -449,10 +954,26 @@ namespace Nightbloom
 		shadowBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 		shadowBinding.pImmutableSamplers = nullptr;
 
+		// Bindings 2 and 3: the point light shadow atlas and its face
+		// matrices (LocalShadowMaps)
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings = { shadowBinding, shadowBinding, {}, {} };
+		bindings[1].binding = 2;
+		bindings[2].binding = 3;
+		bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		bindings[2].descriptorCount = 1;
+		bindings[2].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		// Binding 1: the sun's TLAS, traced by the lit shaders' ray-query
+		// builds (RayTracedShadows). Builds without it never read it.
+		bindings[3].binding = 1;
+		bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+		bindings[3].descriptorCount = 1;
+		bindings[3].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &shadowBinding;
+		layoutInfo.bindingCount = m_Device->SupportsFeature("ray_query") ? 4u : 3u;
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
@@ -587,11 +1108,11 @@ namespace Nightbloom
 		return descriptorSet;
 	}
 
-	void VulkanDescriptorManager::UpdateUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size)
+	void VulkanDescriptorManager::UpdateUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
+		bufferInfo.offset = offset;
 		bufferInfo.range = size;
 
 		VkWriteDescriptorSet descriptorWrite{};
@@ -628,11 +1149,11 @@ namespace Nightbloom
 		return descriptorSet;
 	}
 
-	void VulkanDescriptorManager::UpdateLightingSet(uint32_t frameIndex, VkBuffer buffer, size_t size)
+	void VulkanDescriptorManager::UpdateLightingSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
+		bufferInfo.offset = offset;
 		bufferInfo.range = size;
 
 		VkWriteDescriptorSet descriptorWrite{};
@@ -647,6 +1168,29 @@ namespace Nightbloom
 		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
 	}
 
+	void VulkanDescriptorManager::UpdateLightingClusterBuffers(uint32_t frameIndex, VkBuffer lightBuffer,
+		VkDeviceSize lightSize, VkBuffer clusterBuffer, VkDeviceSize clusterSize)
+	{
+		if (lightBuffer == VK_NULL_HANDLE || clusterBuffer == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorBufferInfo, 2> bufferInfos{};
+		bufferInfos[0] = { lightBuffer, 0, lightSize };
+		bufferInfos[1] = { clusterBuffer, 0, clusterSize };
+
+		std::array<VkWriteDescriptorSet, 2> writes{};
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = m_LightingDescriptorSets[frameIndex];
+			writes[i].dstBinding = i + 1;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
 	// =====================================================================
 	// Shadow map sampler sets (set 3 in main pass)
 	// =====================================================================
@@ -688,21 +1232,72 @@ namespace Nightbloom
 		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
 	}
 
-	// =====================================================================
-	// Shadow UNIFORM sets (set 0 in shadow pass - light's view/proj)
-	// Uses the same layout as the camera uniform, just a different buffer
-	// =====================================================================
-
-	VkDescriptorSet VulkanDescriptorManager::AllocateShadowUniformSet(uint32_t frameIndex)
+	void VulkanDescriptorManager::UpdateLocalShadowSet(uint32_t frameIndex, VkImageView atlasView, VkSampler atlasSampler,
+		VkBuffer uniformBuffer, size_t size, VkDeviceSize offset)
 	{
-		VkDescriptorSetAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		allocInfo.descriptorPool = m_DescriptorPool;
-		allocInfo.descriptorSetCount = 1;
-		allocInfo.pSetLayouts = &m_UniformSetLayout;  // Same layout as camera uniform
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.sampler = atlasSampler;
+		imageInfo.imageView = atlasView;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-		VkDescriptorSet descriptorSet;
-		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &descriptorSet) != VK_SUCCESS)
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = uniformBuffer;
+		bufferInfo.offset = offset;
+		bufferInfo.range = size;
+
+		std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[0].dstSet = m_ShadowDescriptorSets[frameIndex];
+		descriptorWrites[0].dstBinding = 2;
+		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[0].descriptorCount = 1;
+		descriptorWrites[0].pImageInfo = &imageInfo;
+
+		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[1].dstSet = m_ShadowDescriptorSets[frameIndex];
+		descriptorWrites[1].dstBinding = 3;
+		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		descriptorWrites[1].descriptorCount = 1;
+		descriptorWrites[1].pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(descriptorWrites.size()),
+			descriptorWrites.data(), 0, nullptr);
+	}
+
+	void VulkanDescriptorManager::UpdateShadowAccelerationStructure(uint32_t frameIndex, VkAccelerationStructureKHR tlas)
+	{
+		VkWriteDescriptorSetAccelerationStructureKHR structureInfo{};
+		structureInfo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
+		structureInfo.accelerationStructureCount = 1;
+		structureInfo.pAccelerationStructures = &tlas;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.pNext = &structureInfo;
+		descriptorWrite.dstSet = m_ShadowDescriptorSets[frameIndex];
+		descriptorWrite.dstBinding = 1;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+		descriptorWrite.descriptorCount = 1;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+	}
+
+	// =====================================================================
+	// Shadow UNIFORM sets (set 0 in shadow pass - light's view/proj)
+	// Uses the same layout as the camera uniform, just a different buffer
+	// =====================================================================
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateShadowUniformSet(uint32_t frameIndex)
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_UniformSetLayout;  // Same layout as camera uniform
+
+		VkDescriptorSet descriptorSet;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &descriptorSet) != VK_SUCCESS)
 		{
 			LOG_ERROR("Failed to allocate shadow uniform descriptor set for frame {}", frameIndex);
 			return VK_NULL_HANDLE;
@@ -711,11 +1306,11 @@ namespace Nightbloom
 		return descriptorSet;
 	}
 
-	void VulkanDescriptorManager::UpdateShadowUniformSet(uint32_t frameIndex, uint32_t cascade, VkBuffer buffer, size_t size)
+	void VulkanDescriptorManager::UpdateShadowUniformSet(uint32_t frameIndex, uint32_t cascade, VkBuffer buffer, size_t size, VkDeviceSize offset)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
+		bufferInfo.offset = offset;
 		bufferInfo.range = size;
 
 		VkWriteDescriptorSet descriptorWrite{};
@@ -730,6 +1325,25 @@ namespace Nightbloom
 		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
 	}
 
+	void VulkanDescriptorManager::UpdateShadowLayeredUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset)
+	{
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = offset;
+		bufferInfo.range = size;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = m_ShadowLayeredUniformDescriptorSets[frameIndex];
+		descriptorWrite.dstBinding = 0;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+	}
+
 	VkDescriptorSet VulkanDescriptorManager::AllocateReflectionUniformSet(uint32_t frameIndex)
 	{
 		VkDescriptorSetAllocateInfo allocInfo{};
@@ -748,11 +1362,11 @@ namespace Nightbloom
 		return descriptorSet;
 	}
 
-	void VulkanDescriptorManager::UpdateReflectionUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size)
+	void VulkanDescriptorManager::UpdateReflectionUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
+		bufferInfo.offset = offset;
 		bufferInfo.range = size;
 
 		VkWriteDescriptorSet descriptorWrite{};
@@ -767,6 +1381,135 @@ namespace Nightbloom
 		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
 	}
 
+	void VulkanDescriptorManager::UpdateAuxiliaryUniformSet(uint32_t frameIndex, uint32_t view, VkBuffer buffer, size_t size, VkDeviceSize offset)
+	{
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = offset;
+		bufferInfo.range = size;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = m_AuxiliaryUniformDescriptorSets[frameIndex][view];
+		descriptorWrite.dstBinding = 0;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+	}
+
+	void VulkanDescriptorManager::UpdateInstanceBinding(uint32_t frameIndex, VkBuffer buffer, size_t size)
+	{
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = size;
+
+		// Every set allocated from the uniform layout for this frame
+		std::vector<VkDescriptorSet> sets;
+		sets.push_back(m_UniformDescriptorSets[frameIndex]);
+		for (VkDescriptorSet set : m_ShadowUniformDescriptorSets[frameIndex])
+			sets.push_back(set);
+		sets.push_back(m_ShadowLayeredUniformDescriptorSets[frameIndex]);
+		sets.push_back(m_ReflectionUniformDescriptorSets[frameIndex]);
+		for (VkDescriptorSet set : m_AuxiliaryUniformDescriptorSets[frameIndex])
+			sets.push_back(set);
+
+		std::vector<VkWriteDescriptorSet> writes;
+		for (VkDescriptorSet set : sets)
+		{
+			if (set == VK_NULL_HANDLE)
+				continue;
+
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = set;
+			descriptorWrite.dstBinding = 1;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pBufferInfo = &bufferInfo;
+			writes.push_back(descriptorWrite);
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	void VulkanDescriptorManager::UpdateWindFieldBinding(VkImageView imageView, VkSampler sampler)
+	{
+		UpdateUniformSamplerBinding(2, imageView, sampler);
+	}
+
+	void VulkanDescriptorManager::UpdateAtmosphereBindings(VkImageView skyViewView, VkImageView aerialView,
+		VkSampler sampler)
+	{
+		UpdateUniformSamplerBinding(3, skyViewView, sampler);
+		UpdateUniformSamplerBinding(4, aerialView, sampler);
+	}
+
+	void VulkanDescriptorManager::UpdateCloudShadowBinding(uint32_t frameIndex, VkImageView imageView,
+		VkSampler sampler)
+	{
+		UpdateUniformSamplerBinding(5, imageView, sampler, frameIndex);
+	}
+
+	void VulkanDescriptorManager::UpdateTerrainShadowBinding(uint32_t frameIndex, VkImageView imageView,
+		VkSampler sampler)
+	{
+		UpdateUniformSamplerBinding(6, imageView, sampler, frameIndex);
+	}
+
+	void VulkanDescriptorManager::UpdateEnvironmentProbeBinding(VkImageView cubeView, VkSampler sampler)
+	{
+		UpdateUniformSamplerBinding(7, cubeView, sampler);
+	}
+
+	void VulkanDescriptorManager::UpdateUniformSamplerBinding(uint32_t binding, VkImageView imageView,
+		VkSampler sampler, uint32_t frameIndex)
+	{
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = imageView;
+		imageInfo.sampler = sampler;
+
+		// Every set allocated from the uniform layout, in every frame (or
+		// just the one)
+		std::vector<VkDescriptorSet> sets;
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (frameIndex != ALL_FRAMES && i != frameIndex)
+				continue;
+			sets.push_back(m_UniformDescriptorSets[i]);
+			for (VkDescriptorSet set : m_ShadowUniformDescriptorSets[i])
+				sets.push_back(set);
+			sets.push_back(m_ShadowLayeredUniformDescriptorSets[i]);
+			sets.push_back(m_ReflectionUniformDescriptorSets[i]);
+			for (VkDescriptorSet set : m_AuxiliaryUniformDescriptorSets[i])
+				sets.push_back(set);
+		}
+
+		std::vector<VkWriteDescriptorSet> writes;
+		for (VkDescriptorSet set : sets)
+		{
+			if (set == VK_NULL_HANDLE)
+				continue;
+
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = set;
+			descriptorWrite.dstBinding = binding;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pImageInfo = &imageInfo;
+			writes.push_back(descriptorWrite);
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
 	VkDescriptorSet VulkanDescriptorManager::AllocateComputeStorageSet()
 	{
 		if (m_ComputeStorageSetLayout == VK_NULL_HANDLE)
@@ -935,18 +1678,35 @@ namespace Nightbloom
 	VkDescriptorSetLayout VulkanDescriptorManager::CreateHeightmapSetLayout()
 	{
 		// Combined image sampler accessible from the VERTEX stage
-		// (unlike the texture set which is fragment-only)
-		VkDescriptorSetLayoutBinding binding{};
-		binding.binding = 0;
-		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		binding.descriptorCount = 1;
-		binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;   // <-- key difference
-		binding.pImmutableSamplers = nullptr;
+		// (unlike the texture set, which has no vertex stage), and from
+		// compute, where TerrainSurface.comp reads the heightmap through it
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;   // <-- key difference
+		bindings[0].pImmutableSamplers = nullptr;
+		// TerrainTess.tese displaces the vertices it creates
+		if (m_Device->SupportsFeature("tessellation"))
+			bindings[0].stageFlags |= VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+
+		// The terrain's baked material weights, for Terrain.frag and
+		// TerrainVirtualPage.comp, then its virtual texture's albedo and
+		// normal pages, for Terrain.frag (left unwritten by sets nothing
+		// draws with)
+		for (uint32_t i = 1; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		}
+		bindings[1].stageFlags |= VK_SHADER_STAGE_COMPUTE_BIT;
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &binding;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
@@ -976,44 +1736,56 @@ namespace Nightbloom
 		return set;
 	}
 
-	void VulkanDescriptorManager::UpdateHeightmapSet(VkDescriptorSet set, VulkanTexture* texture)
+	void VulkanDescriptorManager::UpdateHeightmapSet(VkDescriptorSet set, VulkanTexture* texture, VulkanTexture* materialMap,
+		VulkanTexture* virtualAlbedo, VulkanTexture* virtualNormal)
 	{
 		if (set == VK_NULL_HANDLE || !texture) return;
 
-		VkDescriptorImageInfo imageInfo{};
-		imageInfo.sampler = texture->GetSampler();
-		imageInfo.imageView = texture->GetImageView();
-		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		// Bindings in order, up to the first one not given
+		const std::array<VulkanTexture*, 4> textures = { texture, materialMap, virtualAlbedo, virtualNormal };
+		std::array<VkDescriptorImageInfo, 4> imageInfos{};
+		std::array<VkWriteDescriptorSet, 4> writes{};
+		uint32_t count = 0;
+		for (; count < textures.size() && textures[count]; ++count)
+		{
+			imageInfos[count].sampler = textures[count]->GetSampler();
+			imageInfos[count].imageView = textures[count]->GetImageView();
+			imageInfos[count].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = set;
-		write.dstBinding = 0;
-		write.dstArrayElement = 0;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		write.descriptorCount = 1;
-		write.pImageInfo = &imageInfo;
+			writes[count].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[count].dstSet = set;
+			writes[count].dstBinding = count;
+			writes[count].dstArrayElement = 0;
+			writes[count].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[count].descriptorCount = 1;
+			writes[count].pImageInfo = &imageInfos[count];
+		}
 
-		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+		vkUpdateDescriptorSets(m_Device->GetDevice(), count, writes.data(), 0, nullptr);
 	}
 
 	// =====================================================================
-	// Firefly agent storage buffer (vertex+compute visible, single set)
+	// Firefly agent storage buffer (vertex+compute visible, single set),
+	// plus the draw cull's visible-index lists and indirect arguments
 	// =====================================================================
 
 	VkDescriptorSetLayout VulkanDescriptorManager::CreateFireflyStorageSetLayout()
 	{
-		VkDescriptorSetLayoutBinding binding{};
-		binding.binding = 0;
-		binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		binding.descriptorCount = 1;
-		binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
-		binding.pImmutableSamplers = nullptr;
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[i].pImmutableSamplers = nullptr;
+		}
+		bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;   // draw arguments: FireflyCull.comp only
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &binding;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
@@ -1043,25 +1815,106 @@ namespace Nightbloom
 		return set;
 	}
 
-	void VulkanDescriptorManager::UpdateFireflyStorageSet(VkDescriptorSet set, VkBuffer buffer, VkDeviceSize size)
+	void VulkanDescriptorManager::UpdateFireflyStorageSet(VkDescriptorSet set, VkBuffer agentBuffer, VkDeviceSize agentSize,
+		VkBuffer visibleBuffer, VkDeviceSize visibleSize, VkBuffer drawArgsBuffer, VkDeviceSize drawArgsSize)
 	{
-		if (set == VK_NULL_HANDLE || buffer == VK_NULL_HANDLE) return;
+		if (set == VK_NULL_HANDLE || agentBuffer == VK_NULL_HANDLE ||
+			visibleBuffer == VK_NULL_HANDLE || drawArgsBuffer == VK_NULL_HANDLE) return;
 
-		VkDescriptorBufferInfo bufferInfo{};
-		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
-		bufferInfo.range = size;
+		std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+		bufferInfos[0] = { agentBuffer, 0, agentSize };
+		bufferInfos[1] = { visibleBuffer, 0, visibleSize };
+		bufferInfos[2] = { drawArgsBuffer, 0, drawArgsSize };
 
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = set;
-		write.dstBinding = 0;
-		write.dstArrayElement = 0;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		write.descriptorCount = 1;
-		write.pBufferInfo = &bufferInfo;
+		std::array<VkWriteDescriptorSet, 3> writes{};
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
 
-		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Firefly neighbour grid (compute-only, single set): cell starts,
+	// per-agent cell/rank, cell-sorted position+velocity copy
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateFireflyGridSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[i].pImmutableSamplers = nullptr;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create firefly grid descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created firefly grid (compute) descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateFireflyGridSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_FireflyGridSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate firefly grid descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateFireflyGridSet(VkDescriptorSet set, VkBuffer cellBuffer, VkDeviceSize cellSize,
+		VkBuffer rankBuffer, VkDeviceSize rankSize, VkBuffer sortedBuffer, VkDeviceSize sortedSize)
+	{
+		if (set == VK_NULL_HANDLE || cellBuffer == VK_NULL_HANDLE ||
+			rankBuffer == VK_NULL_HANDLE || sortedBuffer == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+		bufferInfos[0] = { cellBuffer, 0, cellSize };
+		bufferInfos[1] = { rankBuffer, 0, rankSize };
+		bufferInfos[2] = { sortedBuffer, 0, sortedSize };
+
+		std::array<VkWriteDescriptorSet, 3> writes{};
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
 	}
 
 	// =====================================================================
@@ -1111,11 +1964,11 @@ namespace Nightbloom
 		return set;
 	}
 
-	void VulkanDescriptorManager::UpdateFireflyParamsSet(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size)
+	void VulkanDescriptorManager::UpdateFireflyParamsSet(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
+		bufferInfo.offset = offset;
 		bufferInfo.range = size;
 
 		VkWriteDescriptorSet write{};
@@ -1131,31 +1984,177 @@ namespace Nightbloom
 	}
 
 	// =====================================================================
-	// Cloud set (set 1 in Clouds pass): shape sampler, detail sampler, params UBO
+	// Particle pool storage (vertex+compute visible, single set)
 	// =====================================================================
 
-	VkDescriptorSetLayout VulkanDescriptorManager::CreateCloudSetLayout()
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateParticleStorageSetLayout()
 	{
-		// Consumed by CloudRaymarch.comp (the raymarch moved to a low-res
-		// compute pass for performance - see .claude/ROADMAP.md Phase 1.4).
-		// The graphics composite pass no longer needs shape/detail/params at
-		// all; it only samples the small raymarch result via CloudResultSetLayout.
-		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
-
-		bindings[0].binding = 0;
-		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		bindings[0].descriptorCount = 1;
-		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-
-		bindings[1].binding = 1;
-		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		bindings[1].descriptorCount = 1;
-		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-
-		bindings[2].binding = 2;
-		bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		bindings[2].descriptorCount = 1;
-		bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[i].pImmutableSamplers = nullptr;
+		}
+		bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;   // dead list
+		bindings[4].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;   // draw + dispatch arguments
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create particle storage descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created particle storage (vertex+compute) descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateParticleStorageSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_ParticleStorageSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate particle storage descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateParticleStorageSet(VkDescriptorSet set, VkBuffer particleBuffer, VkDeviceSize particleSize,
+		VkBuffer aliveBuffer, VkDeviceSize aliveSize, VkBuffer deadBuffer, VkDeviceSize deadSize,
+		VkBuffer counterBuffer, VkDeviceSize counterSize, VkBuffer argsBuffer, VkDeviceSize argsSize)
+	{
+		if (set == VK_NULL_HANDLE || particleBuffer == VK_NULL_HANDLE || aliveBuffer == VK_NULL_HANDLE ||
+			deadBuffer == VK_NULL_HANDLE || counterBuffer == VK_NULL_HANDLE || argsBuffer == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorBufferInfo, 5> bufferInfos{};
+		bufferInfos[0] = { particleBuffer, 0, particleSize };
+		bufferInfos[1] = { aliveBuffer, 0, aliveSize };
+		bufferInfos[2] = { deadBuffer, 0, deadSize };
+		bufferInfos[3] = { counterBuffer, 0, counterSize };
+		bufferInfos[4] = { argsBuffer, 0, argsSize };
+
+		std::array<VkWriteDescriptorSet, 5> writes{};
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Particle emitter UBO (compute-only, double-buffered)
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateParticleParamsSetLayout()
+	{
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		binding.descriptorCount = 1;
+		binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		binding.pImmutableSamplers = nullptr;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &binding;
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create particle emitter descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created particle emitter (compute) descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateParticleParamsSet(uint32_t frameIndex)
+	{
+		(void)frameIndex;
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_ParticleParamsSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate particle emitter descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateParticleParamsSet(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset)
+	{
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = offset;
+		bufferInfo.range = size;
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_ParticleParamsDescriptorSets[frameIndex];
+		write.dstBinding = 0;
+		write.dstArrayElement = 0;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		write.descriptorCount = 1;
+		write.pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+	}
+
+	// =====================================================================
+	// Cloud set (set 1 in Clouds pass): shape sampler, detail sampler, params UBO
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateCloudSetLayout()
+	{
+		// Consumed by CloudRaymarch.comp (the raymarch moved to a low-res
+		// compute pass for performance - see .claude/ROADMAP.md Phase 1.4).
+		// The graphics composite pass no longer needs shape/detail/params at
+		// all; it only samples the small raymarch result via CloudResultSetLayout.
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		bindings[2].binding = 2;
+		bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		bindings[2].descriptorCount = 1;
+		bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -1223,11 +2222,11 @@ namespace Nightbloom
 		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
 	}
 
-	void VulkanDescriptorManager::UpdateCloudParamsBinding(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size)
+	void VulkanDescriptorManager::UpdateCloudParamsBinding(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset)
 	{
 		VkDescriptorBufferInfo bufferInfo{};
 		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
+		bufferInfo.offset = offset;
 		bufferInfo.range = size;
 
 		VkWriteDescriptorSet write{};
@@ -1242,7 +2241,8 @@ namespace Nightbloom
 	}
 
 	// =====================================================================
-	// Cloud result sampler (set 1 in the graphics Clouds composite pass)
+	// Cloud result sampler (set 1 in the graphics Clouds composite pass,
+	// set 3 in the screen-space reflection trace)
 	// =====================================================================
 
 	VkDescriptorSetLayout VulkanDescriptorManager::CreateCloudResultSetLayout()
@@ -1251,7 +2251,7 @@ namespace Nightbloom
 		binding.binding = 0;
 		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		binding.descriptorCount = 1;
-		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -1288,12 +2288,20 @@ namespace Nightbloom
 
 	void VulkanDescriptorManager::UpdateCloudResultSet(VkDescriptorSet set, VulkanTexture* resultTexture)
 	{
-		if (set == VK_NULL_HANDLE || !resultTexture) return;
+		if (!resultTexture) return;
+		UpdateCloudResultSet(set, resultTexture->GetImageView(), resultTexture->GetSampler(),
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
+	void VulkanDescriptorManager::UpdateCloudResultSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler,
+		VkImageLayout imageLayout)
+	{
+		if (set == VK_NULL_HANDLE || imageView == VK_NULL_HANDLE) return;
 
 		VkDescriptorImageInfo imageInfo{};
-		imageInfo.sampler = resultTexture->GetSampler();
-		imageInfo.imageView = resultTexture->GetImageView();
-		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.sampler = sampler;
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = imageLayout;
 
 		VkWriteDescriptorSet write{};
 		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1307,194 +2315,1106 @@ namespace Nightbloom
 	}
 
 	// =====================================================================
-	// Foliage instance storage buffer (vertex-only visible, single set,
-	// one-shot generated like Terrain's heightmap — no compute dispatch)
+	// Cloud history (set 4 in CloudRaymarch.comp) — 0 = previous frame's
+	// reconstruction (sampled), 1 = this frame's (storage). Both images
+	// stay in GENERAL.
 	// =====================================================================
 
-	VkDescriptorSetLayout VulkanDescriptorManager::CreateFoliageStorageSetLayout()
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateCloudHistorySetLayout()
 	{
-		VkDescriptorSetLayoutBinding binding{};
-		binding.binding = 0;
-		binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		binding.descriptorCount = 1;
-		binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-		binding.pImmutableSamplers = nullptr;
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &binding;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
 		{
-			LOG_ERROR("Failed to create foliage storage descriptor set layout");
+			LOG_ERROR("Failed to create cloud history descriptor set layout");
 			return VK_NULL_HANDLE;
 		}
 
-		LOG_INFO("Created foliage storage (vertex-only) descriptor set layout");
+		LOG_INFO("Created cloud history descriptor set layout");
 		return layout;
 	}
 
-	VkDescriptorSet VulkanDescriptorManager::AllocateFoliageStorageSet()
+	VkDescriptorSet VulkanDescriptorManager::AllocateCloudHistorySet()
 	{
 		VkDescriptorSetAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocInfo.descriptorPool = m_DescriptorPool;
 		allocInfo.descriptorSetCount = 1;
-		allocInfo.pSetLayouts = &m_FoliageStorageSetLayout;
+		allocInfo.pSetLayouts = &m_CloudHistorySetLayout;
 
 		VkDescriptorSet set;
 		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
 		{
-			LOG_ERROR("Failed to allocate foliage storage descriptor set");
+			LOG_ERROR("Failed to allocate cloud history descriptor set");
 			return VK_NULL_HANDLE;
 		}
 		return set;
 	}
 
-	void VulkanDescriptorManager::UpdateFoliageStorageSet(VkDescriptorSet set, VkBuffer buffer, VkDeviceSize size)
+	void VulkanDescriptorManager::UpdateCloudHistorySet(VkDescriptorSet set, VulkanTexture* previous, VulkanTexture* next)
 	{
-		if (set == VK_NULL_HANDLE || buffer == VK_NULL_HANDLE) return;
+		if (set == VK_NULL_HANDLE || !previous || !next) return;
 
-		VkDescriptorBufferInfo bufferInfo{};
-		bufferInfo.buffer = buffer;
-		bufferInfo.offset = 0;
-		bufferInfo.range = size;
+		std::array<VkDescriptorImageInfo, 2> infos{};
+		infos[0] = { previous->GetSampler(), previous->GetImageView(), VK_IMAGE_LAYOUT_GENERAL };
+		infos[1] = { VK_NULL_HANDLE, next->GetStorageImageView(), VK_IMAGE_LAYOUT_GENERAL };
 
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = set;
-		write.dstBinding = 0;
-		write.dstArrayElement = 0;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		write.descriptorCount = 1;
-		write.pBufferInfo = &bufferInfo;
+		std::array<VkWriteDescriptorSet, 2> writes{};
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = (i == 0) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
 
-		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
 	}
 
 	// =====================================================================
-	// Post-process input (set 0 in the PostProcess/FXAA pass)
+	// Foliage instance storage buffer (vertex-only visible, single set,
+	// one-shot generated like Terrain's heightmap — no compute dispatch)
 	// =====================================================================
 
-	VkDescriptorSetLayout VulkanDescriptorManager::CreatePostProcessInputSetLayout()
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateFoliageStorageSetLayout()
 	{
-		VkDescriptorSetLayoutBinding binding{};
-		binding.binding = 0;
-		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		binding.descriptorCount = 1;
-		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-		binding.pImmutableSamplers = nullptr;
+		// binding 0 = blade instances, binding 1 = per-patch LOD params written
+		// by the GPU cull pass (read only on the indirect-draw path)
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+			bindings[i].pImmutableSamplers = nullptr;
+		}
 
+		// Graphics-only, so it can be a push set: the grass draws push their
+		// buffers, nothing else binds it
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &binding;
+		layoutInfo.flags = m_UsePushDescriptors ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
 		{
-			LOG_ERROR("Failed to create post-process input descriptor set layout");
+			LOG_ERROR("Failed to create foliage storage descriptor set layout");
 			return VK_NULL_HANDLE;
 		}
 
-		LOG_INFO("Created post-process input descriptor set layout");
+		LOG_INFO("Created foliage storage (vertex-only{}) descriptor set layout", m_UsePushDescriptors ? ", push" : "");
 		return layout;
 	}
 
-	VkDescriptorSet VulkanDescriptorManager::AllocatePostProcessInputSet()
+	VkDescriptorSet VulkanDescriptorManager::AllocateFoliageStorageSet()
 	{
+		if (m_UsePushDescriptors)
+		{
+			LOG_ERROR("Foliage storage is a push set; push its buffers instead of allocating one");
+			return VK_NULL_HANDLE;
+		}
+
 		VkDescriptorSetAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocInfo.descriptorPool = m_DescriptorPool;
 		allocInfo.descriptorSetCount = 1;
-		allocInfo.pSetLayouts = &m_PostProcessInputSetLayout;
+		allocInfo.pSetLayouts = &m_FoliageStorageSetLayout;
 
 		VkDescriptorSet set;
 		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
 		{
-			LOG_ERROR("Failed to allocate post-process input descriptor set");
+			LOG_ERROR("Failed to allocate foliage storage descriptor set");
 			return VK_NULL_HANDLE;
 		}
 		return set;
 	}
 
-	void VulkanDescriptorManager::UpdatePostProcessInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler)
+	void VulkanDescriptorManager::UpdateFoliageStorageSet(VkDescriptorSet set, VkBuffer buffer, VkDeviceSize size,
+		VkBuffer patchLodBuffer, VkDeviceSize patchLodSize)
 	{
-		if (set == VK_NULL_HANDLE || imageView == VK_NULL_HANDLE) return;
+		if (set == VK_NULL_HANDLE || buffer == VK_NULL_HANDLE || patchLodBuffer == VK_NULL_HANDLE) return;
 
-		VkDescriptorImageInfo imageInfo{};
-		imageInfo.sampler = sampler;
-		imageInfo.imageView = imageView;
-		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		std::array<VkDescriptorBufferInfo, 2> bufferInfos{};
+		bufferInfos[0] = { buffer, 0, size };
+		bufferInfos[1] = { patchLodBuffer, 0, patchLodSize };
 
-		VkWriteDescriptorSet write{};
-		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write.dstSet = set;
-		write.dstBinding = 0;
-		write.dstArrayElement = 0;
-		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		write.descriptorCount = 1;
-		write.pImageInfo = &imageInfo;
+		std::array<VkWriteDescriptorSet, 2> writes{};
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
 
-		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	void VulkanDescriptorManager::PushStorageBuffers(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint,
+		VkPipelineLayout pipelineLayout, uint32_t set, const VkDescriptorBufferInfo* buffers, uint32_t count) const
+	{
+		if (!m_UsePushDescriptors || count == 0) return;
+
+		std::array<VkWriteDescriptorSet, 8> writes{};
+		count = std::min(count, static_cast<uint32_t>(writes.size()));
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = VK_NULL_HANDLE;   // ignored for push descriptors
+			writes[i].dstBinding = i;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &buffers[i];
+		}
+
+		m_Device->CmdPushDescriptorSet(cmd, bindPoint, pipelineLayout, set, count, writes.data());
 	}
 
 	// =====================================================================
-	// Reflection input (set 2 in the Water pass) — the planar-reflection
-	// color target. Same single-sampler shape as the post-process input.
+	// Foliage cull (set 0 of GrassSystem's cull compute pipeline): patch
+	// bounds in, indirect draws / draw counts / per-patch LOD out, plus the
+	// frame's cull params UBO. One set per frame in flight (the UBO differs).
 	// =====================================================================
 
-	VkDescriptorSetLayout VulkanDescriptorManager::CreateReflectionInputSetLayout()
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateFoliageCullSetLayout()
 	{
-		VkDescriptorSetLayoutBinding binding{};
-		binding.binding = 0;
-		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		binding.descriptorCount = 1;
-		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-		binding.pImmutableSamplers = nullptr;
+		std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = (i == 4)
+				? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+				: VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[i].pImmutableSamplers = nullptr;
+		}
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = 1;
-		layoutInfo.pBindings = &binding;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
 
 		VkDescriptorSetLayout layout;
 		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
 		{
-			LOG_ERROR("Failed to create reflection input descriptor set layout");
+			LOG_ERROR("Failed to create foliage cull descriptor set layout");
 			return VK_NULL_HANDLE;
 		}
 
-		LOG_INFO("Created reflection input descriptor set layout");
+		LOG_INFO("Created foliage cull (compute) descriptor set layout");
 		return layout;
 	}
 
-	VkDescriptorSet VulkanDescriptorManager::AllocateReflectionInputSet()
+	VkDescriptorSet VulkanDescriptorManager::AllocateFoliageCullSet()
 	{
 		VkDescriptorSetAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocInfo.descriptorPool = m_DescriptorPool;
 		allocInfo.descriptorSetCount = 1;
-		allocInfo.pSetLayouts = &m_ReflectionInputSetLayout;
+		allocInfo.pSetLayouts = &m_FoliageCullSetLayout;
 
 		VkDescriptorSet set;
 		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
 		{
-			LOG_ERROR("Failed to allocate reflection input descriptor set");
+			LOG_ERROR("Failed to allocate foliage cull descriptor set");
 			return VK_NULL_HANDLE;
 		}
 		return set;
 	}
 
-	void VulkanDescriptorManager::UpdateReflectionInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler)
+	void VulkanDescriptorManager::UpdateFoliageCullSet(VkDescriptorSet set, const FoliageCullBuffers& buffers)
 	{
-		if (set == VK_NULL_HANDLE || imageView == VK_NULL_HANDLE) return;
+		if (set == VK_NULL_HANDLE) return;
 
-		VkDescriptorImageInfo imageInfo{};
-		imageInfo.sampler = sampler;
-		imageInfo.imageView = imageView;
+		std::array<VkDescriptorBufferInfo, 5> bufferInfos{};
+		bufferInfos[0] = { buffers.patches, 0, buffers.patchesSize };
+		bufferInfos[1] = { buffers.indirectDraws, 0, buffers.indirectDrawsSize };
+		bufferInfos[2] = { buffers.drawCounts, 0, buffers.drawCountsSize };
+		bufferInfos[3] = { buffers.patchLod, 0, buffers.patchLodSize };
+		bufferInfos[4] = { buffers.params, 0, buffers.paramsSize };
+
+		std::array<VkWriteDescriptorSet, 5> writes{};
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorType = (i == 4)
+				? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+				: VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].descriptorCount = 1;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Hi-Z pyramid. Reduce set: one per mip step, binding 0 = source (scene
+	// depth or the previous mip) as a combined sampler, binding 1 = the mip
+	// being written as a storage image. Sample set: the whole pyramid for the
+	// occlusion tests. Everything but the depth source stays in GENERAL.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateHiZReduceSetLayout()
+	{
+		// 0/1 = farthest source/target, 2/3 = nearest source/target
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = (i % 2 == 0) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create Hi-Z reduce descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created Hi-Z reduce descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateHiZReduceSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_HiZReduceSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate Hi-Z reduce descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateHiZReduceSet(VkDescriptorSet set, VkImageView sourceView,
+		VkImageView nearestSourceView, VkImageLayout sourceLayout, VkSampler sampler,
+		VkImageView targetView, VkImageView nearestTargetView)
+	{
+		if (set == VK_NULL_HANDLE || sourceView == VK_NULL_HANDLE || nearestSourceView == VK_NULL_HANDLE ||
+			targetView == VK_NULL_HANDLE || nearestTargetView == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 4> infos{};
+		infos[0].imageView = sourceView;
+		infos[0].imageLayout = sourceLayout;
+		infos[0].sampler = sampler;
+		infos[1].imageView = targetView;
+		infos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		infos[1].sampler = VK_NULL_HANDLE;
+		infos[2].imageView = nearestSourceView;
+		infos[2].imageLayout = sourceLayout;
+		infos[2].sampler = sampler;
+		infos[3].imageView = nearestTargetView;
+		infos[3].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		infos[3].sampler = VK_NULL_HANDLE;
+
+		std::array<VkWriteDescriptorSet, 4> writes{};
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = (i % 2 == 0) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateHiZSampleSetLayout()
+	{
+		// 0 = farthest-depth chain (occlusion tests), 1 = nearest (SSR)
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[i].pImmutableSamplers = nullptr;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create Hi-Z sample descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created Hi-Z sample descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateHiZSampleSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_HiZSampleSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate Hi-Z sample descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateHiZSampleSet(VkDescriptorSet set, VkImageView pyramidView,
+		VkImageView nearestView, VkSampler sampler)
+	{
+		if (set == VK_NULL_HANDLE || pyramidView == VK_NULL_HANDLE || nearestView == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 2> infos{};
+		infos[0].imageView = pyramidView;
+		infos[0].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		infos[0].sampler = sampler;
+		infos[1].imageView = nearestView;
+		infos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		infos[1].sampler = sampler;
+
+		std::array<VkWriteDescriptorSet, 2> writes{};
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Post-process input (set 0 in the PostProcess/FXAA pass). Compute-
+	// visible too: the compute post pass binds the same sets.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreatePostProcessInputSetLayout()
+	{
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = 1;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+		binding.pImmutableSamplers = nullptr;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &binding;
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create post-process input descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created post-process input descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocatePostProcessInputSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_PostProcessInputSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate post-process input descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdatePostProcessInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler,
+		VkImageLayout imageLayout)
+	{
+		if (set == VK_NULL_HANDLE || imageView == VK_NULL_HANDLE) return;
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.sampler = sampler;
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = imageLayout;
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = set;
+		write.dstBinding = 0;
+		write.dstArrayElement = 0;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.descriptorCount = 1;
+		write.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+	}
+
+	// =====================================================================
+	// OIT input (set 0 of the OIT composite subpass). Binding 0 = the
+	// accumulation target, 1 = revealage, both input attachments read at the
+	// composite's own pixel; no sampler.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateOitInputSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create OIT input descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateOitInputSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_OitInputSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate OIT input descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateOitInputSet(VkDescriptorSet set, VkImageView accumulation, VkImageView revealage)
+	{
+		if (set == VK_NULL_HANDLE || accumulation == VK_NULL_HANDLE || revealage == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 2> imageInfos{};
+		imageInfos[0].imageView = accumulation;
+		imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfos[1].imageView = revealage;
+		imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		std::array<VkWriteDescriptorSet, 2> writes{};
+		for (uint32_t i = 0; i < writes.size(); ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &imageInfos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Temporal resolve (TemporalUpscaler). Binding 0 = scene color, 1 = scene
+	// depth (multisampled with MSAA), 2 = the previous output (history), all
+	// combined samplers; 3 = this frame's output as a storage image. The two
+	// history images swap roles every frame, so the upscaler keeps one set
+	// per direction. History images stay in GENERAL.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateTemporalResolveSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		bindings[3].binding = 3;
+		bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[3].descriptorCount = 1;
+		bindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create temporal resolve descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created temporal resolve descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateTemporalResolveSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_TemporalResolveSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate temporal resolve descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateTemporalResolveSet(VkDescriptorSet set, const TemporalResolveImages& images)
+	{
+		if (set == VK_NULL_HANDLE || images.colorView == VK_NULL_HANDLE || images.depthView == VK_NULL_HANDLE ||
+			images.historyView == VK_NULL_HANDLE || images.outputView == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 4> infos{};
+		infos[0] = { images.pointSampler, images.colorView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		infos[1] = { images.pointSampler, images.depthView, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL };
+		infos[2] = { images.linearSampler, images.historyView, VK_IMAGE_LAYOUT_GENERAL };
+		infos[3] = { VK_NULL_HANDLE, images.outputView, VK_IMAGE_LAYOUT_GENERAL };
+
+		std::array<VkWriteDescriptorSet, 4> writes{};
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = (i < 3) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Screen-space reflections (ScreenSpaceReflections). Binding 0 = scene
+	// color (SHADER_READ_ONLY), 1 = the color history as a sampler; 2 = the
+	// history and 3 = the reflection output as storage images. The history
+	// stays in GENERAL; the output is GENERAL while it is written.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateScreenSpaceReflectionSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = (i < 2) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create screen-space reflection descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created screen-space reflection descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateScreenSpaceReflectionSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_ScreenSpaceReflectionSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate screen-space reflection descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateScreenSpaceReflectionSet(VkDescriptorSet set,
+		const ScreenSpaceReflectionImages& images)
+	{
+		if (set == VK_NULL_HANDLE || images.sceneColorView == VK_NULL_HANDLE ||
+			images.historyView == VK_NULL_HANDLE || images.outputView == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 4> infos{};
+		infos[0] = { images.sampler, images.sceneColorView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		infos[1] = { images.sampler, images.historyView, VK_IMAGE_LAYOUT_GENERAL };
+		infos[2] = { VK_NULL_HANDLE, images.historyView, VK_IMAGE_LAYOUT_GENERAL };
+		infos[3] = { VK_NULL_HANDLE, images.outputView, VK_IMAGE_LAYOUT_GENERAL };
+
+		std::array<VkWriteDescriptorSet, 4> writes{};
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = (i < 2) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// FFT ocean waves (OceanWaves). Compute set: 0 = the complex wave
+	// spectrum, 1 = displacement, 2 = derivatives, all storage image arrays
+	// (one layer per cascade, two for the spectrum) kept in GENERAL while
+	// the passes run. Sample set (Water set 3): 0 = displacement and 1 =
+	// derivatives as samplers, 2 = the cascade params UBO.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateOceanComputeSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create ocean compute descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created ocean compute descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateOceanSampleSetLayout()
+	{
+		// Displacement is read by Water.vert, derivatives and the params by both
+		const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = (i < 2) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = stages;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create ocean sample descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created ocean sample descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateOceanComputeSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_OceanComputeSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate ocean compute descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateOceanSampleSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_OceanSampleSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate ocean sample descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateOceanComputeSet(VkDescriptorSet set, const OceanWaveImages& images)
+	{
+		if (set == VK_NULL_HANDLE || images.spectrumView == VK_NULL_HANDLE ||
+			images.displacementView == VK_NULL_HANDLE || images.derivativesView == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 3> infos{};
+		infos[0] = { VK_NULL_HANDLE, images.spectrumView, VK_IMAGE_LAYOUT_GENERAL };
+		infos[1] = { VK_NULL_HANDLE, images.displacementView, VK_IMAGE_LAYOUT_GENERAL };
+		infos[2] = { VK_NULL_HANDLE, images.derivativesView, VK_IMAGE_LAYOUT_GENERAL };
+
+		std::array<VkWriteDescriptorSet, 3> writes{};
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	void VulkanDescriptorManager::UpdateOceanSampleSet(VkDescriptorSet set, const OceanWaveImages& images)
+	{
+		if (set == VK_NULL_HANDLE || images.displacementView == VK_NULL_HANDLE ||
+			images.derivativesView == VK_NULL_HANDLE || images.paramsBuffer == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 2> imageInfos{};
+		imageInfos[0] = { images.sampler, images.displacementView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		imageInfos[1] = { images.sampler, images.derivativesView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = images.paramsBuffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = images.paramsSize;
+
+		std::array<VkWriteDescriptorSet, 3> writes{};
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorCount = 1;
+		}
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[0].pImageInfo = &imageInfos[0];
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[1].pImageInfo = &imageInfos[1];
+		writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		writes[2].pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Bloom mip chain (BloomMipChain). One set per step: binding 0 = the
+	// level read (scene color for the prefilter, otherwise a chain mip) as a
+	// combined sampler, binding 1 = the mip written as a storage image. The
+	// chain stays in GENERAL while it is built.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateBloomMipSetLayout()
+	{
+		// Every level is read through BloomMipChain's linear clamp sampler:
+		// immutable, so the per-step writes only carry the view
+		const VkSampler linearClamp = m_Device->GetSamplerCache()->GetSampler(VulkanSamplerCache::LinearClamp());
+
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[0].pImmutableSamplers = &linearClamp;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create bloom mip descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created bloom mip descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateBloomMipSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_BloomMipSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate bloom mip descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateBloomMipSet(VkDescriptorSet set, VkImageView sourceView,
+		VkImageLayout sourceLayout, VkSampler sampler, VkImageView targetView)
+	{
+		if (set == VK_NULL_HANDLE || sourceView == VK_NULL_HANDLE || targetView == VK_NULL_HANDLE) return;
+
+		VkDescriptorImageInfo sourceInfo{};
+		sourceInfo.imageView = sourceView;
+		sourceInfo.imageLayout = sourceLayout;
+		sourceInfo.sampler = sampler;
+
+		VkDescriptorImageInfo targetInfo{};
+		targetInfo.imageView = targetView;
+		targetInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		targetInfo.sampler = VK_NULL_HANDLE;
+
+		std::array<VkWriteDescriptorSet, 2> writes{};
+		writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[0].dstSet = set;
+		writes[0].dstBinding = 0;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[0].descriptorCount = 1;
+		writes[0].pImageInfo = &sourceInfo;
+		writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[1].dstSet = set;
+		writes[1].dstBinding = 1;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		writes[1].descriptorCount = 1;
+		writes[1].pImageInfo = &targetInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Single-pass mip generation (MipGenerator). Binding 0 = mip 0 read as
+	// a storage image, binding 1 = the written levels, binding 2 = the
+	// counter the last workgroup is found with. Everything stays in GENERAL.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateMipDownsampleSetLayout()
+	{
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[1].descriptorCount = MAX_MIP_DOWNSAMPLE_OUTPUTS;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[2].binding = 2;
+		bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[2].descriptorCount = 1;
+		bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create mip downsample descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created mip downsample descriptor set layout");
+		return layout;
+	}
+
+	void VulkanDescriptorManager::UpdateMipDownsampleSet(VkDescriptorSet set, const std::vector<VkImageView>& mipViews,
+		VkBuffer counterBuffer)
+	{
+		if (set == VK_NULL_HANDLE || mipViews.size() < 2 || counterBuffer == VK_NULL_HANDLE) return;
+
+		VkDescriptorImageInfo sourceInfo{};
+		sourceInfo.imageView = mipViews[0];
+		sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		// Every array element must be valid; unused ones repeat the last level
+		std::array<VkDescriptorImageInfo, MAX_MIP_DOWNSAMPLE_OUTPUTS> targetInfos{};
+		for (uint32_t i = 0; i < MAX_MIP_DOWNSAMPLE_OUTPUTS; ++i)
+		{
+			const size_t mip = std::min<size_t>(i + 1, mipViews.size() - 1);
+			targetInfos[i].imageView = mipViews[mip];
+			targetInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		}
+
+		VkDescriptorBufferInfo counterInfo{};
+		counterInfo.buffer = counterBuffer;
+		counterInfo.offset = 0;
+		counterInfo.range = VK_WHOLE_SIZE;
+
+		std::array<VkWriteDescriptorSet, 3> writes{};
+		writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[0].dstSet = set;
+		writes[0].dstBinding = 0;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		writes[0].descriptorCount = 1;
+		writes[0].pImageInfo = &sourceInfo;
+		writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[1].dstSet = set;
+		writes[1].dstBinding = 1;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		writes[1].descriptorCount = MAX_MIP_DOWNSAMPLE_OUTPUTS;
+		writes[1].pImageInfo = targetInfos.data();
+		writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[2].dstSet = set;
+		writes[2].dstBinding = 2;
+		writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[2].descriptorCount = 1;
+		writes[2].pBufferInfo = &counterInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	// =====================================================================
+	// Reflection input (set 2 in the Water pass) — the planar-reflection
+	// color target. Same single-sampler shape as the post-process input.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateReflectionInputSetLayout()
+	{
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = 1;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		binding.pImmutableSamplers = nullptr;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &binding;
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create reflection input descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created reflection input descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateReflectionInputSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_ReflectionInputSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate reflection input descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateReflectionInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler)
+	{
+		if (set == VK_NULL_HANDLE || imageView == VK_NULL_HANDLE) return;
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.sampler = sampler;
+		imageInfo.imageView = imageView;
 		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 		VkWriteDescriptorSet write{};
@@ -1508,4 +3428,282 @@ namespace Nightbloom
 
 		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
 	}
-}
\ No newline at end of file
+
+	// =====================================================================
+	// Bindless table (set 1 in the Mesh/Transparent passes) — every sampled
+	// texture in one array plus the material table, see the header.
+	// =====================================================================
+
+	bool VulkanDescriptorManager::InitializeBindless()
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		VkPhysicalDeviceVulkan12Properties properties12{};
+		properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &properties12;
+		vkGetPhysicalDeviceProperties2(m_Device->GetPhysicalDevice(), &properties2);
+
+		// Fragment-only, so the per-stage limits bind; leave headroom for the
+		// frame/lighting/shadow samplers of the same pipeline
+		uint32_t textureCount = std::min({ MAX_BINDLESS_TEXTURES,
+			properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+			properties12.maxPerStageDescriptorUpdateAfterBindSamplers,
+			properties12.maxDescriptorSetUpdateAfterBindSampledImages });
+		textureCount = textureCount > 16 ? textureCount - 16 : 0;
+		if (textureCount == 0)
+		{
+			LOG_WARN("Device allows no update-after-bind sampled images");
+			return false;
+		}
+
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = textureCount;
+		bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		// The material buffer is written once, before the table is first
+		// bound. Partially bound so a failed material table only leaves
+		// materialIndex invalid instead of the whole set unusable.
+		std::array<VkDescriptorBindingFlags, 2> bindingFlags = {
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+		};
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+		flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+		flagsInfo.pBindingFlags = bindingFlags.data();
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.pNext = &flagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_BindlessSetLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create bindless descriptor set layout");
+			m_BindlessSetLayout = VK_NULL_HANDLE;
+			return false;
+		}
+
+		std::array<VkDescriptorPoolSize, 2> poolSizes{};
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSizes[0].descriptorCount = textureCount;
+		poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[1].descriptorCount = 1;
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = 1;
+
+		if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_BindlessPool) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create bindless descriptor pool");
+			m_BindlessPool = VK_NULL_HANDLE;
+			return false;
+		}
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_BindlessPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_BindlessSetLayout;
+
+		VkDescriptorSet set = VK_NULL_HANDLE;
+		if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate bindless descriptor set");
+			return false;
+		}
+
+		m_BindlessSet = set;
+		m_BindlessTextureSlots.Reset(textureCount);
+		LOG_INFO("Bindless descriptor table: {} texture slots", textureCount);
+		return true;
+	}
+
+	void VulkanDescriptorManager::CleanupBindless()
+	{
+		VkDevice device = m_Device ? m_Device->GetDevice() : VK_NULL_HANDLE;
+		if (device == VK_NULL_HANDLE) return;
+
+		if (m_BindlessPool != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorPool(device, m_BindlessPool, nullptr);
+			m_BindlessPool = VK_NULL_HANDLE;
+		}
+		m_BindlessSet = VK_NULL_HANDLE;
+
+		if (m_BindlessSetLayout != VK_NULL_HANDLE)
+		{
+			vkDestroyDescriptorSetLayout(device, m_BindlessSetLayout, nullptr);
+			m_BindlessSetLayout = VK_NULL_HANDLE;
+		}
+
+		m_BindlessTextureSlots.Reset(0);
+	}
+
+	uint32_t VulkanDescriptorManager::RegisterBindlessTexture(VulkanTexture* texture)
+	{
+		if (!texture || m_BindlessSet == VK_NULL_HANDLE)
+			return BindlessIndexAllocator::INVALID_INDEX;
+
+		const uint32_t index = m_BindlessTextureSlots.Allocate();
+		if (index == BindlessIndexAllocator::INVALID_INDEX)
+		{
+			LOG_WARN("Bindless texture table full ({} slots)", m_BindlessTextureSlots.GetCapacity());
+			return index;
+		}
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = texture->GetImageView();
+		imageInfo.sampler = texture->GetSampler();
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_BindlessSet;
+		write.dstBinding = 0;
+		write.dstArrayElement = index;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.descriptorCount = 1;
+		write.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+		return index;
+	}
+
+	void VulkanDescriptorManager::ReleaseBindlessTexture(uint32_t index)
+	{
+		// The stale descriptor stays until the slot is reused; partially
+		// bound, so nothing validates it while no draw indexes it
+		m_BindlessTextureSlots.Release(index);
+	}
+
+	void VulkanDescriptorManager::UpdateBindlessMaterialBuffer(VkBuffer buffer, VkDeviceSize size)
+	{
+		if (m_BindlessSet == VK_NULL_HANDLE || buffer == VK_NULL_HANDLE)
+			return;
+
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = buffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = size;
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_BindlessSet;
+		write.dstBinding = 1;
+		write.dstArrayElement = 0;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		write.descriptorCount = 1;
+		write.pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), 1, &write, 0, nullptr);
+	}
+
+	// =====================================================================
+	// Atmosphere LUTs (AtmosphereLuts' compute passes, set 0). The
+	// transmittance and multi-scattering LUTs are sampled by the later
+	// passes while each pass writes its own LUT as a storage image.
+	// =====================================================================
+
+	VkDescriptorSetLayout VulkanDescriptorManager::CreateAtmosphereLutSetLayout()
+	{
+		// The sampled LUTs always go through AtmosphereLuts' linear clamp
+		// sampler, baked in as immutable
+		const VkSampler linearClamp = m_Device->GetSamplerCache()->GetSampler(VulkanSamplerCache::LinearClamp());
+
+		std::array<VkDescriptorSetLayoutBinding, 6> bindings{};
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = i < 2 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[i].pImmutableSamplers = i < 2 ? &linearClamp : nullptr;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(m_Device->GetDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create atmosphere LUT descriptor set layout");
+			return VK_NULL_HANDLE;
+		}
+
+		LOG_INFO("Created atmosphere LUT descriptor set layout");
+		return layout;
+	}
+
+	VkDescriptorSet VulkanDescriptorManager::AllocateAtmosphereLutSet()
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_AtmosphereLutSetLayout;
+
+		VkDescriptorSet set;
+		if (vkAllocateDescriptorSets(m_Device->GetDevice(), &allocInfo, &set) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate atmosphere LUT descriptor set");
+			return VK_NULL_HANDLE;
+		}
+		return set;
+	}
+
+	void VulkanDescriptorManager::UpdateAtmosphereLutSet(VkDescriptorSet set, VkImageView transmittanceView,
+		VkImageView multiScatteringView, VkImageView skyViewView, VkImageView aerialView, VkSampler sampler)
+	{
+		if (set == VK_NULL_HANDLE || transmittanceView == VK_NULL_HANDLE || multiScatteringView == VK_NULL_HANDLE ||
+			skyViewView == VK_NULL_HANDLE || aerialView == VK_NULL_HANDLE) return;
+
+		std::array<VkDescriptorImageInfo, 6> infos{};
+		infos[0].imageView = transmittanceView;
+		infos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		infos[0].sampler = sampler;
+		infos[1].imageView = multiScatteringView;
+		infos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		infos[1].sampler = sampler;
+		const std::array<VkImageView, 4> storageViews = { transmittanceView, multiScatteringView, skyViewView, aerialView };
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			infos[2 + i].imageView = storageViews[i];
+			infos[2 + i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+			infos[2 + i].sampler = VK_NULL_HANDLE;
+		}
+
+		std::array<VkWriteDescriptorSet, 6> writes{};
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = set;
+			writes[i].dstBinding = i;
+			writes[i].descriptorType = i < 2 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[i].descriptorCount = 1;
+			writes[i].pImageInfo = &infos[i];
+		}
+
+		vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+}
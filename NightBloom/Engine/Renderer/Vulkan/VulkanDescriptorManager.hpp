@@ -6,6 +6,10 @@
 #include <array>
 #include <unordered_map>
 #include "Engine/Renderer/Light.hpp"  // canonical NUM_CASCADES
+#include "Engine/Renderer/FrameConfig.hpp"  // canonical MAX_FRAMES_IN_FLIGHT
+#include "Engine/Renderer/AuxiliaryView.hpp"  // MAX_AUXILIARY_VIEWS
+#include "Engine/Renderer/Vulkan/BindlessIndexAllocator.hpp"
+#include <glm/glm.hpp>
 
 namespace Nightbloom
 {
@@ -13,19 +17,66 @@ namespace Nightbloom
 	class VulkanTexture;
 	class VulkanBuffer;
 
+	// One entry of the bindless material table (set 1 binding 1 in the
+	// bindless mesh passes). std430-compatible; texture fields are slots in
+	// the bindless texture array.
+	struct BindlessMaterialData
+	{
+		glm::vec4 albedoColor = glm::vec4(1.0f);
+		uint32_t albedoTexture = BindlessIndexAllocator::INVALID_INDEX;
+		uint32_t normalTexture = BindlessIndexAllocator::INVALID_INDEX;
+		float roughness = 0.5f;
+		float metallic = 0.0f;
+	};
+	static_assert(sizeof(BindlessMaterialData) == 32, "BindlessMaterialData must match the std430 layout in bindless.glsl");
+
 	class VulkanDescriptorManager
 	{
 	public:
-		static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 		static constexpr uint32_t MAX_DESCRIPTOR_SETS = 1000;
+		static constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;  // clamped to the device's update-after-bind limits
+		static constexpr uint32_t MAX_BINDLESS_MATERIALS = 1024;
 
 		VulkanDescriptorManager(VulkanDevice* device);
 		~VulkanDescriptorManager();
 
 		bool Initialize();
+		// Destroys the long-lived pool the Allocate*Set functions below draw
+		// from, and every set still in it. Components only drop their set
+		// handles in their own Cleanup; they needn't free them one by one.
 		void Cleanup();
 		void FreeDescriptorSet(VkDescriptorSet set);
 
+		// --- Transient sets: allocated from the current frame slot's pools and
+		//     released in bulk by ResetTransientSets once that slot's fence has
+		//     been waited on, i.e. valid for as many frames as are in flight. Never
+		//     freed individually. The pools grow instead of running out.
+		//     Persistent sets (anything rewritten in place, e.g. on resize)
+		//     stay in the long-lived pool above.
+		VkDescriptorSet AllocateTransientSet(VkDescriptorSetLayout layout);
+		void ResetTransientSets(uint32_t frameIndex);
+
+		// --- Content-keyed set cache: requests for the same layout + binding
+		//     contents share one set, written once. Reference counted; give
+		//     sets back with ReleaseCachedSet, never FreeDescriptorSet. Only for
+		//     sets that are never rewritten after creation.
+		struct DescriptorWrite
+		{
+			uint32_t binding = 0;
+			VkDescriptorType type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			VkImageView imageView = VK_NULL_HANDLE;
+			VkSampler sampler = VK_NULL_HANDLE;
+			VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			VkDeviceSize range = VK_WHOLE_SIZE;
+
+			bool operator==(const DescriptorWrite&) const = default;
+		};
+		VkDescriptorSet AcquireCachedSet(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes);
+		void ReleaseCachedSet(VkDescriptorSet set);
+		size_t GetCachedSetCount() const { return m_CachedSetHashes.size(); }
+
 		// Layout creation
 		VkDescriptorSetLayout CreateTextureSetLayout();
 		VkDescriptorSetLayout CreateUniformSetLayout();
@@ -42,36 +93,83 @@ namespace Nightbloom
 
 		// --- Frame uniform (set 0 in main pass) ---
 		VkDescriptorSet AllocateUniformSet(uint32_t frameIndex);
-		void UpdateUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size);
+		void UpdateUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset = 0);
 		VkDescriptorSetLayout GetUniformSetLayout() const { return m_UniformSetLayout; }
 		VkDescriptorSet GetUniformDescriptorSet(uint32_t frameIndex) { return m_UniformDescriptorSets[frameIndex]; }
 
 		// --- Lighting UBO (set 2 in main pass) ---
+		// Binding 0 = SceneLightingData; bindings 1-2 = the clustered point
+		// lights and per-cluster light lists (LightClusterCuller)
 		VkDescriptorSet AllocateLightingSet(uint32_t frameIndex);
-		void UpdateLightingSet(uint32_t frameIndex, VkBuffer buffer, size_t size);
+		void UpdateLightingSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset = 0);
+		void UpdateLightingClusterBuffers(uint32_t frameIndex, VkBuffer lightBuffer, VkDeviceSize lightSize,
+			VkBuffer clusterBuffer, VkDeviceSize clusterSize);
 		VkDescriptorSetLayout GetLightingSetLayout() const { return m_LightingSetLayout; }
 		VkDescriptorSet GetLightingDescriptorSet(uint32_t frameIndex) { return m_LightingDescriptorSets[frameIndex]; }
 
 		// --- Shadow map sampler (set 3 in main pass) ---
 		VkDescriptorSet AllocateShadowSet(uint32_t frameIndex);
 		void UpdateShadowSet(uint32_t frameIndex, VkImageView shadowMapView, VkSampler shadowSampler);
+		// Bindings 2 and 3: the point light shadow atlas and its LocalShadowUniforms
+		void UpdateLocalShadowSet(uint32_t frameIndex, VkImageView atlasView, VkSampler atlasSampler,
+			VkBuffer uniformBuffer, size_t size, VkDeviceSize offset = 0);
+		// Binding 1 (ray_query devices): the TLAS the traced sun shadows query
+		void UpdateShadowAccelerationStructure(uint32_t frameIndex, VkAccelerationStructureKHR tlas);
 		VkDescriptorSetLayout GetShadowSetLayout() const { return m_ShadowSetLayout; }
 		VkDescriptorSet GetShadowDescriptorSet(uint32_t frameIndex) { return m_ShadowDescriptorSets[frameIndex]; }
 
 		// --- Shadow pass uniform (set 0 in shadow pass) ---
 		//     Same layout as camera uniform, but points at the light's UBO
 		VkDescriptorSet AllocateShadowUniformSet(uint32_t frameIndex);
-		void UpdateShadowUniformSet(uint32_t frameIndex, uint32_t cascade, VkBuffer buffer, size_t size);
+		void UpdateShadowUniformSet(uint32_t frameIndex, uint32_t cascade, VkBuffer buffer, size_t size, VkDeviceSize offset = 0);
 		VkDescriptorSet GetShadowUniformDescriptorSet(uint32_t frameIndex, uint32_t cascade) { return m_ShadowUniformDescriptorSets[frameIndex][cascade]; }
+		// Layered shadow pass: binding 0 holds every cascade's light VP (ShadowLayered.vert)
+		void UpdateShadowLayeredUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset = 0);
+		VkDescriptorSet GetShadowLayeredUniformDescriptorSet(uint32_t frameIndex) { return m_ShadowLayeredUniformDescriptorSets[frameIndex]; }
 
 		// --- Reflection pass uniform (set 0 in the planar-reflection pass) ---
 		//     Same layout as the camera uniform, but points at a UBO holding the
 		//     mirror-flipped camera's view/proj. Exactly mirrors the shadow
 		//     uniform pattern above.
 		VkDescriptorSet AllocateReflectionUniformSet(uint32_t frameIndex);
-		void UpdateReflectionUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size);
+		void UpdateReflectionUniformSet(uint32_t frameIndex, VkBuffer buffer, size_t size, VkDeviceSize offset = 0);
 		VkDescriptorSet GetReflectionUniformDescriptorSet(uint32_t frameIndex) { return m_ReflectionUniformDescriptorSets[frameIndex]; }
 
+		// --- Auxiliary view uniforms (set 0 in Renderer's auxiliary view passes) ---
+		//     One camera-layout set per view per frame, allocated with the
+		//     reflection sets above.
+		void UpdateAuxiliaryUniformSet(uint32_t frameIndex, uint32_t view, VkBuffer buffer, size_t size, VkDeviceSize offset = 0);
+		VkDescriptorSet GetAuxiliaryUniformDescriptorSet(uint32_t frameIndex, uint32_t view) { return m_AuxiliaryUniformDescriptorSets[frameIndex][view]; }
+
+		// --- Instance buffer (binding 1 of every uniform-layout set) ---
+		//     Writes the frame's instance storage buffer into the camera,
+		//     shadow-cascade and reflection uniform sets at once.
+		void UpdateInstanceBinding(uint32_t frameIndex, VkBuffer buffer, size_t size);
+
+		// --- Wind field (binding 2 of every uniform-layout set) ---
+		//     One texture for every frame: WindField rebuilds it in place.
+		void UpdateWindFieldBinding(VkImageView imageView, VkSampler sampler);
+
+		// --- Atmosphere (bindings 3 and 4 of every uniform-layout set) ---
+		//     The sky-view LUT and the aerial-perspective froxels, rebuilt in
+		//     place by AtmosphereLuts.
+		void UpdateAtmosphereBindings(VkImageView skyViewView, VkImageView aerialView, VkSampler sampler);
+
+		// --- Cloud shadow map (binding 5 of every uniform-layout set) ---
+		//     Per frame: the clouds come and go, so each frame slot is
+		//     rebound once its previous use has finished.
+		void UpdateCloudShadowBinding(uint32_t frameIndex, VkImageView imageView, VkSampler sampler);
+
+		// --- Terrain sun shadow map (binding 6 of every uniform-layout set) ---
+		//     Per frame, like the cloud shadow map: the terrain's map is
+		//     recreated when its heightmap changes size.
+		void UpdateTerrainShadowBinding(uint32_t frameIndex, VkImageView imageView, VkSampler sampler);
+
+		// --- Environment probe (binding 7 of every uniform-layout set) ---
+		//     One cube for every frame: EnvironmentProbeCache recaptures it
+		//     in place.
+		void UpdateEnvironmentProbeBinding(VkImageView cubeView, VkSampler sampler);
+
 		// --- Compute storage buffers ---
 		VkDescriptorSet AllocateComputeStorageSet();
 		void UpdateComputeStorageSet(VkDescriptorSet set, VkBuffer inputBuffer, VkDeviceSize inputSize,
@@ -89,22 +187,55 @@ namespace Nightbloom
 		// --- Heightmap sampler (set 4 in terrain pass — vertex-stage visible) ---
 		VkDescriptorSetLayout CreateHeightmapSetLayout();
 		VkDescriptorSet AllocateHeightmapSet();
-		void UpdateHeightmapSet(VkDescriptorSet set, VulkanTexture* texture);
+		// materialMap: binding 1, the terrain's baked material weights (fragment
+		// and compute); virtualAlbedo / virtualNormal: bindings 2-3, its
+		// virtual texture pages (fragment stage)
+		void UpdateHeightmapSet(VkDescriptorSet set, VulkanTexture* texture, VulkanTexture* materialMap = nullptr,
+			VulkanTexture* virtualAlbedo = nullptr, VulkanTexture* virtualNormal = nullptr);
 		VkDescriptorSetLayout GetHeightmapSetLayout() const { return m_HeightmapSetLayout; }
 
 		// --- Firefly agent storage buffer (vertex+compute visible, single set, not per-frame) ---
+		// Bindings: agents, visible-index lists, draw arguments (compute only)
 		VkDescriptorSetLayout CreateFireflyStorageSetLayout();
 		VkDescriptorSet AllocateFireflyStorageSet();
-		void UpdateFireflyStorageSet(VkDescriptorSet set, VkBuffer buffer, VkDeviceSize size);
+		void UpdateFireflyStorageSet(VkDescriptorSet set, VkBuffer agentBuffer, VkDeviceSize agentSize,
+			VkBuffer visibleBuffer, VkDeviceSize visibleSize, VkBuffer drawArgsBuffer, VkDeviceSize drawArgsSize);
 		VkDescriptorSetLayout GetFireflyStorageSetLayout() const { return m_FireflyStorageSetLayout; }
 
 		// --- Firefly params UBO (compute-only, double-buffered like Lighting/Uniform) ---
 		VkDescriptorSetLayout CreateFireflyParamsSetLayout();
 		VkDescriptorSet AllocateFireflyParamsSet(uint32_t frameIndex);
-		void UpdateFireflyParamsSet(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size);
+		void UpdateFireflyParamsSet(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset = 0);
 		VkDescriptorSetLayout GetFireflyParamsSetLayout() const { return m_FireflyParamsSetLayout; }
 		VkDescriptorSet GetFireflyParamsDescriptorSet(uint32_t frameIndex) { return m_FireflyParamsDescriptorSets[frameIndex]; }
 
+		// --- Firefly neighbour grid (compute set 2 in the firefly passes):
+		//     per-cell start offsets (0), per-agent cell + rank (1), and the
+		//     cell-sorted position/velocity copy (2). Single set, not per-frame.
+		VkDescriptorSetLayout CreateFireflyGridSetLayout();
+		VkDescriptorSet AllocateFireflyGridSet();
+		void UpdateFireflyGridSet(VkDescriptorSet set, VkBuffer cellBuffer, VkDeviceSize cellSize,
+			VkBuffer rankBuffer, VkDeviceSize rankSize, VkBuffer sortedBuffer, VkDeviceSize sortedSize);
+		VkDescriptorSetLayout GetFireflyGridSetLayout() const { return m_FireflyGridSetLayout; }
+
+		// --- Particle pool storage (ParticleSystem, single set, not per-frame):
+		//     particles (0), alive lists (1), dead list (2), per-emitter
+		//     counters (3), draw + dispatch arguments (4). The draws read
+		//     0, 1 and 3; the rest is compute only. ---
+		VkDescriptorSetLayout CreateParticleStorageSetLayout();
+		VkDescriptorSet AllocateParticleStorageSet();
+		void UpdateParticleStorageSet(VkDescriptorSet set, VkBuffer particleBuffer, VkDeviceSize particleSize,
+			VkBuffer aliveBuffer, VkDeviceSize aliveSize, VkBuffer deadBuffer, VkDeviceSize deadSize,
+			VkBuffer counterBuffer, VkDeviceSize counterSize, VkBuffer argsBuffer, VkDeviceSize argsSize);
+		VkDescriptorSetLayout GetParticleStorageSetLayout() const { return m_ParticleStorageSetLayout; }
+
+		// --- Particle emitter UBO (compute-only, double-buffered like the firefly params) ---
+		VkDescriptorSetLayout CreateParticleParamsSetLayout();
+		VkDescriptorSet AllocateParticleParamsSet(uint32_t frameIndex);
+		void UpdateParticleParamsSet(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset = 0);
+		VkDescriptorSetLayout GetParticleParamsSetLayout() const { return m_ParticleParamsSetLayout; }
+		VkDescriptorSet GetParticleParamsDescriptorSet(uint32_t frameIndex) { return m_ParticleParamsDescriptorSets[frameIndex]; }
+
 		// --- Cloud set (compute set 0 in CloudRaymarch.comp): shape sampler
 		//     (0), detail sampler (1), params UBO (2). Double-buffered per
 		//     frame since binding 2 (the UBO) differs per frame, even though
@@ -112,39 +243,109 @@ namespace Nightbloom
 		VkDescriptorSetLayout CreateCloudSetLayout();
 		VkDescriptorSet AllocateCloudSet(uint32_t frameIndex);
 		void UpdateCloudTextureBindings(uint32_t frameIndex, VulkanTexture* shapeTexture, VulkanTexture* detailTexture);
-		void UpdateCloudParamsBinding(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size);
+		void UpdateCloudParamsBinding(uint32_t frameIndex, VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset = 0);
 		VkDescriptorSetLayout GetCloudSetLayout() const { return m_CloudSetLayout; }
 		VkDescriptorSet GetCloudDescriptorSet(uint32_t frameIndex) { return m_CloudDescriptorSets[frameIndex]; }
 
 		// --- Foliage instance storage buffer (vertex-only visible, single
-		//     set, not per-frame — one-shot generated like Terrain's heightmap,
-		//     no compute dispatch involved) ---
+		//     set, not per-frame — one-shot generated like Terrain's heightmap).
+		//     Binding 1 is the per-patch LOD buffer the cull pass writes.
+		//     A push layout when UsesPushDescriptors(): no set is allocated,
+		//     the draws carry the buffers (DrawCommand::pushBuffers). ---
 		VkDescriptorSetLayout CreateFoliageStorageSetLayout();
 		VkDescriptorSet AllocateFoliageStorageSet();
-		void UpdateFoliageStorageSet(VkDescriptorSet set, VkBuffer buffer, VkDeviceSize size);
+		void UpdateFoliageStorageSet(VkDescriptorSet set, VkBuffer buffer, VkDeviceSize size,
+			VkBuffer patchLodBuffer, VkDeviceSize patchLodSize);
 		VkDescriptorSetLayout GetFoliageStorageSetLayout() const { return m_FoliageStorageSetLayout; }
 
+		// --- Push descriptors (VK_KHR_push_descriptor). Small graphics-only
+		//     sets whose layouts are push layouts are written into the
+		//     command buffer at record time instead of being allocated and
+		//     updated. False without the extension; those sets are then
+		//     ordinary ones. ---
+		bool UsesPushDescriptors() const { return m_UsePushDescriptors; }
+		// Pushes buffers[0..count) as storage buffers at bindings 0..count of
+		// `set`, whose layout in pipelineLayout must be a push layout
+		void PushStorageBuffers(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout,
+			uint32_t set, const VkDescriptorBufferInfo* buffers, uint32_t count) const;
+
+		// --- Foliage GPU cull (set 0 of GrassSystem's cull compute pipeline,
+		//     caller allocates one per frame in flight) ---
+		struct FoliageCullBuffers
+		{
+			VkBuffer patches = VK_NULL_HANDLE;        VkDeviceSize patchesSize = 0;
+			VkBuffer indirectDraws = VK_NULL_HANDLE;  VkDeviceSize indirectDrawsSize = 0;
+			VkBuffer drawCounts = VK_NULL_HANDLE;     VkDeviceSize drawCountsSize = 0;
+			VkBuffer patchLod = VK_NULL_HANDLE;       VkDeviceSize patchLodSize = 0;
+			VkBuffer params = VK_NULL_HANDLE;         VkDeviceSize paramsSize = 0;
+		};
+		VkDescriptorSetLayout CreateFoliageCullSetLayout();
+		VkDescriptorSet AllocateFoliageCullSet();
+		void UpdateFoliageCullSet(VkDescriptorSet set, const FoliageCullBuffers& buffers);
+		VkDescriptorSetLayout GetFoliageCullSetLayout() const { return m_FoliageCullSetLayout; }
+
+		// --- Hi-Z pyramid (OcclusionCuller). The reduce set feeds one mip
+		//     step of the build (farthest-depth source sampler at 0 and
+		//     target storage image at 1, nearest-depth ones at 2 and 3); the
+		//     sample set exposes both chains to compute shaders (farthest at
+		//     0, nearest at 1). Both are allocated once and rewritten in
+		//     place on resize. ---
+		VkDescriptorSetLayout CreateHiZReduceSetLayout();
+		VkDescriptorSet AllocateHiZReduceSet();
+		void UpdateHiZReduceSet(VkDescriptorSet set, VkImageView sourceView, VkImageView nearestSourceView,
+			VkImageLayout sourceLayout, VkSampler sampler, VkImageView targetView, VkImageView nearestTargetView);
+		VkDescriptorSetLayout GetHiZReduceSetLayout() const { return m_HiZReduceSetLayout; }
+
+		VkDescriptorSetLayout CreateHiZSampleSetLayout();
+		VkDescriptorSet AllocateHiZSampleSet();
+		void UpdateHiZSampleSet(VkDescriptorSet set, VkImageView pyramidView, VkImageView nearestView, VkSampler sampler);
+		VkDescriptorSetLayout GetHiZSampleSetLayout() const { return m_HiZSampleSetLayout; }
+
 		// --- Cloud result sampler (set 1 in the graphics Clouds pass): the
 		//     low-res raymarch output, sampled (with hardware bilinear
 		//     upscale) by the simplified composite fragment shader. Single
 		//     set, not per-frame — recreated whenever the result image is
-		//     recreated (resize or resolution-scale change).
+		//     recreated (resize or resolution-scale change). Compute-visible
+		//     too: the screen-space reflection trace reads the reflection
+		//     raymarch for its misses (the raw-view overload points a set at
+		//     another image when there are no clouds).
 		VkDescriptorSetLayout CreateCloudResultSetLayout();
 		VkDescriptorSet AllocateCloudResultSet();
 		void UpdateCloudResultSet(VkDescriptorSet set, VulkanTexture* resultTexture);
+		void UpdateCloudResultSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout);
 		VkDescriptorSetLayout GetCloudResultSetLayout() const { return m_CloudResultSetLayout; }
 
+		// --- Cloud history (set 4 in CloudRaymarch.comp): last frame's
+		//     reconstructed clouds as a sampler (0, GENERAL) and this frame's
+		//     as a storage image (1). The two history images swap roles every
+		//     frame, so CloudSystem keeps one set per direction; rewritten
+		//     with the result images (resize or resolution-scale change).
+		VkDescriptorSetLayout CreateCloudHistorySetLayout();
+		VkDescriptorSet AllocateCloudHistorySet();
+		void UpdateCloudHistorySet(VkDescriptorSet set, VulkanTexture* previous, VulkanTexture* next);
+		VkDescriptorSetLayout GetCloudHistorySetLayout() const { return m_CloudHistorySetLayout; }
+
 		// --- Post-process input (set 0 in the PostProcess/FXAA pass): the
 		//     scene-color texture the scene pass rendered into. Single set,
 		//     not per-frame — recreated whenever RenderPassManager recreates
 		//     the scene-color texture (resize). Takes a raw view+sampler
 		//     (not a VulkanTexture*) since RenderPassManager owns that
-		//     texture directly, the same way it owns the depth buffer.
+		//     texture directly, the same way it owns the depth buffer. Also
+		//     sets 0/1 of the compute post pass (ComputePostProcess).
 		VkDescriptorSetLayout CreatePostProcessInputSetLayout();
 		VkDescriptorSet AllocatePostProcessInputSet();
-		void UpdatePostProcessInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler);
+		void UpdatePostProcessInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler,
+			VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 		VkDescriptorSetLayout GetPostProcessInputSetLayout() const { return m_PostProcessInputSetLayout; }
 
+		// --- OIT input (set 0 of the OIT composite subpass): the
+		//     accumulation (0) and revealage (1) targets as input attachments,
+		//     read in SHADER_READ_ONLY. Single set, recreated with the targets.
+		VkDescriptorSetLayout CreateOitInputSetLayout();
+		VkDescriptorSet AllocateOitInputSet();
+		void UpdateOitInputSet(VkDescriptorSet set, VkImageView accumulation, VkImageView revealage);
+		VkDescriptorSetLayout GetOitInputSetLayout() const { return m_OitInputSetLayout; }
+
 		// --- Reflection input (the planar-reflection color target, sampled by
 		//     the water surface). Single combined-image-sampler, fragment-only —
 		//     identical shape to the post-process input set, just a different
@@ -155,7 +356,133 @@ namespace Nightbloom
 		void UpdateReflectionInputSet(VkDescriptorSet set, VkImageView imageView, VkSampler sampler);
 		VkDescriptorSetLayout GetReflectionInputSetLayout() const { return m_ReflectionInputSetLayout; }
 
+		// --- Temporal resolve (set 0 of TemporalUpscaler's compute pass):
+		//     scene color (0), scene depth (1) and the previous output (2) as
+		//     samplers, this frame's output as a storage image (3). Allocated
+		//     once per history direction and rewritten on resize. ---
+		struct TemporalResolveImages
+		{
+			VkImageView colorView = VK_NULL_HANDLE;
+			VkImageView depthView = VK_NULL_HANDLE;
+			VkImageView historyView = VK_NULL_HANDLE;
+			VkImageView outputView = VK_NULL_HANDLE;
+			VkSampler pointSampler = VK_NULL_HANDLE;   // color + depth (texelFetch)
+			VkSampler linearSampler = VK_NULL_HANDLE;  // history (filtered reprojection)
+		};
+		VkDescriptorSetLayout CreateTemporalResolveSetLayout();
+		VkDescriptorSet AllocateTemporalResolveSet();
+		void UpdateTemporalResolveSet(VkDescriptorSet set, const TemporalResolveImages& images);
+		VkDescriptorSetLayout GetTemporalResolveSetLayout() const { return m_TemporalResolveSetLayout; }
+
+		// --- Screen-space reflections (set 1 of ScreenSpaceReflections'
+		//     passes): scene color (0) and the half-resolution color history
+		//     (1) as samplers, the history (2) and the reflection output (3)
+		//     as storage images. Single set, rewritten on resize. ---
+		struct ScreenSpaceReflectionImages
+		{
+			VkImageView sceneColorView = VK_NULL_HANDLE;
+			VkImageView historyView = VK_NULL_HANDLE;
+			VkImageView outputView = VK_NULL_HANDLE;
+			VkSampler sampler = VK_NULL_HANDLE;   // linear, clamp
+		};
+		VkDescriptorSetLayout CreateScreenSpaceReflectionSetLayout();
+		VkDescriptorSet AllocateScreenSpaceReflectionSet();
+		void UpdateScreenSpaceReflectionSet(VkDescriptorSet set, const ScreenSpaceReflectionImages& images);
+		VkDescriptorSetLayout GetScreenSpaceReflectionSetLayout() const { return m_ScreenSpaceReflectionSetLayout; }
+
+		// --- FFT ocean waves (OceanWaves). The compute set holds the wave
+		//     spectrum (0), displacement (1) and derivative (2) maps as
+		//     storage images, shared by the spectrum, FFT and resolve passes.
+		//     The sample set is set 3 of the Water pipeline: displacement (0)
+		//     and derivatives (1) as samplers plus the cascade params UBO (2).
+		//     One of each per water plane, rewritten when it is regenerated. ---
+		struct OceanWaveImages
+		{
+			VkImageView spectrumView = VK_NULL_HANDLE;
+			VkImageView displacementView = VK_NULL_HANDLE;
+			VkImageView derivativesView = VK_NULL_HANDLE;
+			VkSampler sampler = VK_NULL_HANDLE;   // linear, repeat
+			VkBuffer paramsBuffer = VK_NULL_HANDLE;
+			VkDeviceSize paramsSize = 0;
+		};
+		VkDescriptorSetLayout CreateOceanComputeSetLayout();
+		VkDescriptorSetLayout CreateOceanSampleSetLayout();
+		VkDescriptorSet AllocateOceanComputeSet();
+		VkDescriptorSet AllocateOceanSampleSet();
+		void UpdateOceanComputeSet(VkDescriptorSet set, const OceanWaveImages& images);
+		void UpdateOceanSampleSet(VkDescriptorSet set, const OceanWaveImages& images);
+		VkDescriptorSetLayout GetOceanComputeSetLayout() const { return m_OceanComputeSetLayout; }
+		VkDescriptorSetLayout GetOceanSampleSetLayout() const { return m_OceanSampleSetLayout; }
+
+		// --- Bloom mip chain (BloomMipChain): one set per step, the level
+		//     read as a sampler (0) and the level written as a storage image
+		//     (1). Same shape as the Hi-Z reduce set. Allocated once and
+		//     rewritten in place on resize. Binding 0 has the cached
+		//     VulkanSamplerCache::LinearClamp() as its immutable sampler;
+		//     `sampler` is ignored. ---
+		VkDescriptorSetLayout CreateBloomMipSetLayout();
+		VkDescriptorSet AllocateBloomMipSet();
+		void UpdateBloomMipSet(VkDescriptorSet set, VkImageView sourceView, VkImageLayout sourceLayout,
+			VkSampler sampler, VkImageView targetView);
+		VkDescriptorSetLayout GetBloomMipSetLayout() const { return m_BloomMipSetLayout; }
+
+		// --- Single-pass mip generation (MipGenerator): mip 0 as a storage
+		//     image (0), the levels written (1, an array of
+		//     MAX_MIP_DOWNSAMPLE_OUTPUTS single-level views) and the
+		//     workgroup counter buffer (2). Transient, one per dispatch. ---
+		static constexpr uint32_t MAX_MIP_DOWNSAMPLE_OUTPUTS = 12;
+		VkDescriptorSetLayout CreateMipDownsampleSetLayout();
+		// mipViews[0] is mip 0; the array slots past the last level repeat it
+		void UpdateMipDownsampleSet(VkDescriptorSet set, const std::vector<VkImageView>& mipViews,
+			VkBuffer counterBuffer);
+		VkDescriptorSetLayout GetMipDownsampleSetLayout() const { return m_MipDownsampleSetLayout; }
+
+		// --- Atmosphere LUTs (AtmosphereLuts' compute passes): the
+		//     transmittance (0) and multi-scattering (1) LUTs sampled, then all
+		//     four LUTs as storage images - transmittance (2), multi-scattering
+		//     (3), sky-view (4), aerial perspective (5, 3D). One set, written
+		//     once. The sampled pair uses the immutable LinearClamp() sampler
+		//     (`sampler` is ignored). ---
+		VkDescriptorSetLayout CreateAtmosphereLutSetLayout();
+		VkDescriptorSet AllocateAtmosphereLutSet();
+		void UpdateAtmosphereLutSet(VkDescriptorSet set, VkImageView transmittanceView, VkImageView multiScatteringView,
+			VkImageView skyViewView, VkImageView aerialView, VkSampler sampler);
+		VkDescriptorSetLayout GetAtmosphereLutSetLayout() const { return m_AtmosphereLutSetLayout; }
+
+		// --- Bindless table (set 1 in the Mesh/Transparent passes when the
+		//     device has descriptor indexing): a partially bound, update-after-
+		//     bind array of combined image samplers (0) plus the material
+		//     storage buffer (1). One set for the whole scene, bound once per
+		//     pipeline layout; draws select entries through PushConstantData.
+		//     Slots are written while frames are in flight, which is only
+		//     legal because no pending frame reads a slot that is not yet
+		//     registered (or whose texture has already been destroyed).
+		bool IsBindlessEnabled() const { return m_BindlessSet != VK_NULL_HANDLE; }
+		VkDescriptorSetLayout GetBindlessSetLayout() const { return m_BindlessSetLayout; }
+		VkDescriptorSet GetBindlessDescriptorSet() const { return m_BindlessSet; }
+		uint32_t RegisterBindlessTexture(VulkanTexture* texture);
+		void ReleaseBindlessTexture(uint32_t index);
+		void UpdateBindlessMaterialBuffer(VkBuffer buffer, VkDeviceSize size);
+
 	private:
+		bool InitializeBindless();
+		void CleanupBindless();
+		VkDescriptorPool CreateTransientPool();
+		// Writes one combined image sampler into every uniform-layout set of
+		// frameIndex, or of every frame
+		static constexpr uint32_t ALL_FRAMES = UINT32_MAX;
+		void UpdateUniformSamplerBinding(uint32_t binding, VkImageView imageView, VkSampler sampler,
+			uint32_t frameIndex = ALL_FRAMES);
+
+		struct CachedSet
+		{
+			VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+			std::vector<DescriptorWrite> writes;
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			uint32_t refCount = 0;
+		};
+		static size_t HashSetContents(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes);
+
 		VulkanDevice* m_Device = nullptr;
 		VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
 
@@ -169,11 +496,45 @@ namespace Nightbloom
 		VkDescriptorSetLayout m_HeightmapSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSetLayout m_FireflyStorageSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSetLayout m_FireflyParamsSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_FireflyGridSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_ParticleStorageSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_ParticleParamsSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSetLayout m_CloudSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSetLayout m_CloudResultSetLayout = VK_NULL_HANDLE;
-		VkDescriptorSetLayout m_FoliageStorageSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_CloudHistorySetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_FoliageStorageSetLayout = VK_NULL_HANDLE;   // push layout if m_UsePushDescriptors
+		bool m_UsePushDescriptors = false;
+		VkDescriptorSetLayout m_FoliageCullSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_HiZReduceSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_HiZSampleSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSetLayout m_PostProcessInputSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_OitInputSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSetLayout m_ReflectionInputSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_TemporalResolveSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_ScreenSpaceReflectionSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_OceanComputeSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_OceanSampleSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_BloomMipSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_MipDownsampleSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_AtmosphereLutSetLayout = VK_NULL_HANDLE;
+
+		// Set cache: content hash -> entries (collisions compared in full),
+		// plus the reverse lookup ReleaseCachedSet needs
+		std::unordered_multimap<size_t, CachedSet> m_SetCache;
+		std::unordered_map<VkDescriptorSet, size_t> m_CachedSetHashes;
+
+		// Transient pools per frame in flight; m_TransientPoolIndex is the
+		// first pool of the current slot that may still have room
+		static constexpr uint32_t TRANSIENT_POOL_SETS = 64;
+		std::array<std::vector<VkDescriptorPool>, MAX_FRAMES_IN_FLIGHT> m_TransientPools;
+		uint32_t m_TransientFrame = 0;
+		size_t m_TransientPoolIndex = 0;
+
+		// Bindless table, in its own update-after-bind pool
+		VkDescriptorPool m_BindlessPool = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_BindlessSetLayout = VK_NULL_HANDLE;
+		VkDescriptorSet m_BindlessSet = VK_NULL_HANDLE;
+		BindlessIndexAllocator m_BindlessTextureSlots;
 
 		// Per-frame descriptor sets
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_TextureDescriptorSets{};
@@ -181,8 +542,11 @@ namespace Nightbloom
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_LightingDescriptorSets{};
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_ShadowDescriptorSets{};
 		std::array<std::array<VkDescriptorSet, NUM_CASCADES>, MAX_FRAMES_IN_FLIGHT> m_ShadowUniformDescriptorSets{};
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_ShadowLayeredUniformDescriptorSets{};
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_ReflectionUniformDescriptorSets{};
+		std::array<std::array<VkDescriptorSet, MAX_AUXILIARY_VIEWS>, MAX_FRAMES_IN_FLIGHT> m_AuxiliaryUniformDescriptorSets{};
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_FireflyParamsDescriptorSets{};
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_ParticleParamsDescriptorSets{};
 		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_CloudDescriptorSets{};
 	};
 }
\ No newline at end of file
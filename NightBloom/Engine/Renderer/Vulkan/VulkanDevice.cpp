@@ -7,9 +7,16 @@
 
 #include "Core/Platform.hpp"  
 #include "VulkanDevice.hpp"
+#include "VulkanPipelineCache.hpp"
+#include "VulkanQueueTimeline.hpp"
+#include "VulkanDeletionQueue.hpp"
+#include "VulkanSamplerCache.hpp"
+#include "VulkanDebugMarkers.hpp"
 #include "Core/Logger/Logger.hpp"
 #include "Core/Assert.hpp"
+#include <algorithm>
 #include <set>
+#include <cstring>
 
 namespace Nightbloom
 {
@@ -65,6 +72,12 @@ namespace Nightbloom
 		}
 		LOG_INFO("Logical device created");
 
+		if (m_DebugUtilsEnabled)
+		{
+			VulkanDebugMarkers::Load(m_Instance);
+			LOG_INFO("GPU debug labels and object names: {}", VulkanDebugMarkers::IsEnabled() ? "on" : "unavailable");
+		}
+
 		LOG_INFO("=== Vulkan Device Initialized Successfully ===");
 
 		return true;
@@ -75,6 +88,29 @@ namespace Nightbloom
 		LOG_INFO("Shutting down Vulkan device... ");
 
 		//Destroy in reverse order of creation
+		ShutdownPipelineCache();
+
+		if (m_DeletionQueue)
+		{
+			WaitForIdle();
+			m_DeletionQueue->Flush();
+			m_DeletionQueue.reset();
+		}
+
+		if (m_SamplerCache)
+		{
+			m_SamplerCache->Cleanup();
+			m_SamplerCache.reset();
+		}
+
+		if (m_GraphicsTimeline)
+		{
+			m_GraphicsTimeline->Cleanup();
+			m_GraphicsTimeline.reset();
+		}
+
+		VulkanDebugMarkers::Unload();
+
 		if (m_Device != VK_NULL_HANDLE)
 		{
 			vkDestroyDevice(m_Device, nullptr);
@@ -102,6 +138,33 @@ namespace Nightbloom
 		LOG_INFO("Vulkan device shutdown complete");
 	}
 
+	bool VulkanDevice::InitializePipelineCache(const std::string& directory)
+	{
+		m_PipelineCache = std::make_unique<VulkanPipelineCache>();
+		if (!m_PipelineCache->Initialize(m_Device, m_PhysicalDevice, directory))
+		{
+			LOG_WARN("Creating pipelines without a pipeline cache");
+			m_PipelineCache.reset();
+			return false;
+		}
+		return true;
+	}
+
+	void VulkanDevice::ShutdownPipelineCache()
+	{
+		// Cleanup writes it back to disk
+		if (m_PipelineCache)
+		{
+			m_PipelineCache->Cleanup();
+			m_PipelineCache.reset();
+		}
+	}
+
+	VkPipelineCache VulkanDevice::GetPipelineCache() const
+	{
+		return m_PipelineCache ? m_PipelineCache->GetHandle() : VK_NULL_HANDLE;
+	}
+
 	Buffer* VulkanDevice::CreateBuffer(const BufferDesc& desc)
 	{
 		UNUSED(desc);
@@ -190,6 +253,11 @@ namespace Nightbloom
 		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
 		createInfo.pApplicationInfo = &appInfo;
 
+		// Debug utils for the validation messenger, and for labels and object
+		// names (VulkanDebugMarkers) whenever the loader offers them
+		m_DebugUtilsEnabled = m_EnableValidationLayers
+			|| (NB_GPU_MARKERS_ENABLED && IsInstanceExtensionAvailable(VK_EXT_DEBUG_UTILS_EXTENSION_NAME));
+
 		// Get required extensions (window system integration + debug)
 		auto extensions = GetRequiredExtensions();
 		createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
@@ -321,15 +389,29 @@ namespace Nightbloom
 			m_QueueFamilies.graphicsFamily.value(),
 			m_QueueFamilies.presentFamily.value()
 		};
+		if (m_QueueFamilies.transferFamily.has_value())
+		{
+			uniqueQueueFamilies.insert(m_QueueFamilies.transferFamily.value());
+		}
+
+		if (m_QueueFamilies.computeFamily.has_value())
+		{
+			uniqueQueueFamilies.insert(m_QueueFamilies.computeFamily.value());
+		}
 
-		float queuePriority = 1.0f; // Priority of the queue, 1.0 is highest
+		const float queuePriorities[2] = { 1.0f, 1.0f }; // Priority of the queue, 1.0 is highest
 		for (uint32_t queueFamily : uniqueQueueFamilies)
 		{
+			// One queue per family, except when async compute takes a second
+			// queue of the transfer family
+			const bool sharedCompute = m_QueueFamilies.computeFamily == queueFamily
+				&& m_QueueFamilies.computeQueueIndex > 0;
+
 			VkDeviceQueueCreateInfo queueCreateInfo{};
 			queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 			queueCreateInfo.queueFamilyIndex = queueFamily;
-			queueCreateInfo.queueCount = 1; // We only need one queue per family for now
-			queueCreateInfo.pQueuePriorities = &queuePriority; // Set priority
+			queueCreateInfo.queueCount = sharedCompute ? 2 : 1;
+			queueCreateInfo.pQueuePriorities = queuePriorities; // Set priority
 
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
@@ -343,18 +425,347 @@ namespace Nightbloom
 		if (supported.samplerAnisotropy) {
 			deviceFeatures.samplerAnisotropy = VK_TRUE;   // ? enable it
 		}
-		// Later we might want: geometryShader, tessellationShader, etc.
+		// Multi-draw indirect + draw-indirect-count let compute passes build
+		// the draw list on the GPU (GrassSystem's cull pass). Optional: callers
+		// check SupportsFeature("draw_indirect_count") and fall back to CPU draws.
+		if (supported.multiDrawIndirect) {
+			deviceFeatures.multiDrawIndirect = VK_TRUE;
+		}
+		// Block-compressed sampling for cooked KTX2 textures. Optional: the
+		// loader checks SupportsFeature("texture_compression_bc"/"_astc") and
+		// falls back to the source image.
+		if (supported.textureCompressionBC) {
+			deviceFeatures.textureCompressionBC = VK_TRUE;
+		}
+		if (supported.textureCompressionASTC_LDR) {
+			deviceFeatures.textureCompressionASTC_LDR = VK_TRUE;
+		}
+		// Per-scope pipeline statistics and exact occlusion counts in
+		// GpuProfiler. Optional: it checks SupportsFeature("pipeline_statistics_query")
+		// and "inherited_queries" (scopes wrap secondary command buffers).
+		if (supported.pipelineStatisticsQuery && supported.inheritedQueries) {
+			deviceFeatures.pipelineStatisticsQuery = VK_TRUE;
+			deviceFeatures.inheritedQueries = VK_TRUE;
+		}
+		if (supported.occlusionQueryPrecise) {
+			deviceFeatures.occlusionQueryPrecise = VK_TRUE;
+		}
+		// r8ui storage images: the shading-rate image is written by a compute
+		// pass (VariableRateShading), so attachment shading rates need it too
+		if (supported.shaderStorageImageExtendedFormats) {
+			deviceFeatures.shaderStorageImageExtendedFormats = VK_TRUE;
+		}
+		// Point sprites wider than a pixel for distant fireflies. Optional:
+		// without SupportsFeature("large_points") they stay billboards.
+		if (supported.largePoints) {
+			deviceFeatures.largePoints = VK_TRUE;
+		}
+		// Tessellated terrain. Optional: without SupportsFeature("tessellation")
+		// the terrain draws its full patch grid.
+		if (supported.tessellationShader) {
+			deviceFeatures.tessellationShader = VK_TRUE;
+		}
+		// Partially resident images whose pages are bound on the graphics
+		// queue (VulkanMemoryManager::CreateSparseImage), for the streamed
+		// terrain's tile maps. Optional: SupportsFeature("sparse_residency_2d")
+		// and "_3d"; without them those images are allocated whole.
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &familyCount, families.data());
+		const bool sparseQueue = (families[m_QueueFamilies.graphicsFamily.value()].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
+		if (supported.sparseBinding && sparseQueue
+			&& (supported.sparseResidencyImage2D || supported.sparseResidencyImage3D)) {
+			deviceFeatures.sparseBinding = VK_TRUE;
+			deviceFeatures.sparseResidencyImage2D = supported.sparseResidencyImage2D;
+			deviceFeatures.sparseResidencyImage3D = supported.sparseResidencyImage3D;
+		}
+
+		VkPhysicalDeviceProperties deviceProperties{};
+		vkGetPhysicalDeviceProperties(m_PhysicalDevice, &deviceProperties);
+
+		VkPhysicalDevicePresentWaitFeaturesKHR supportedPresentWait{};
+		supportedPresentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+		VkPhysicalDevicePresentIdFeaturesKHR supportedPresentId{};
+		supportedPresentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+		supportedPresentId.pNext = &supportedPresentWait;
+
+		// The present feature structs may only be queried when their extensions exist
+		const bool presentWaitExtensions =
+			IsDeviceExtensionAvailable(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+			IsDeviceExtensionAvailable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+		VkPhysicalDeviceVulkan12Features supported12{};
+		supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		if (presentWaitExtensions) {
+			supported12.pNext = &supportedPresentId;
+		}
+		VkPhysicalDeviceFragmentShadingRateFeaturesKHR supportedShadingRate{};
+		supportedShadingRate.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+		const bool shadingRateExtension = IsDeviceExtensionAvailable(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+		if (shadingRateExtension) {
+			supportedShadingRate.pNext = supported12.pNext;
+			supported12.pNext = &supportedShadingRate;
+		}
+		VkPhysicalDeviceDynamicRenderingFeaturesKHR supportedDynamicRendering{};
+		supportedDynamicRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+		const bool dynamicRenderingExtension = IsDeviceExtensionAvailable(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+		if (dynamicRenderingExtension) {
+			supportedDynamicRendering.pNext = supported12.pNext;
+			supported12.pNext = &supportedDynamicRendering;
+		}
+		VkPhysicalDeviceSynchronization2FeaturesKHR supportedSync2{};
+		supportedSync2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+		const bool sync2Extension = IsDeviceExtensionAvailable(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		if (sync2Extension) {
+			supportedSync2.pNext = supported12.pNext;
+			supported12.pNext = &supportedSync2;
+		}
+		VkPhysicalDeviceMemoryPriorityFeaturesEXT supportedMemoryPriority{};
+		supportedMemoryPriority.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+		const bool memoryPriorityExtension = IsDeviceExtensionAvailable(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+		if (memoryPriorityExtension) {
+			supportedMemoryPriority.pNext = supported12.pNext;
+			supported12.pNext = &supportedMemoryPriority;
+		}
+		VkPhysicalDevicePageableDeviceLocalMemoryFeaturesEXT supportedPageableMemory{};
+		supportedPageableMemory.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+		const bool pageableMemoryExtension = memoryPriorityExtension &&
+			IsDeviceExtensionAvailable(VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME);
+		if (pageableMemoryExtension) {
+			supportedPageableMemory.pNext = supported12.pNext;
+			supported12.pNext = &supportedPageableMemory;
+		}
+		VkPhysicalDeviceAccelerationStructureFeaturesKHR supportedAccelerationStructure{};
+		supportedAccelerationStructure.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
+		VkPhysicalDeviceRayQueryFeaturesKHR supportedRayQuery{};
+		supportedRayQuery.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR;
+		const bool rayQueryExtensions =
+			IsDeviceExtensionAvailable(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) &&
+			IsDeviceExtensionAvailable(VK_KHR_RAY_QUERY_EXTENSION_NAME) &&
+			IsDeviceExtensionAvailable(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
+		if (rayQueryExtensions) {
+			supportedRayQuery.pNext = supported12.pNext;
+			supportedAccelerationStructure.pNext = &supportedRayQuery;
+			supported12.pNext = &supportedAccelerationStructure;
+		}
+		VkPhysicalDeviceVulkan11Features supported11{};
+		supported11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+		supported11.pNext = supported12.pNext;
+		supported12.pNext = &supported11;
+		if (deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+			VkPhysicalDeviceFeatures2 supported2{};
+			supported2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			supported2.pNext = &supported12;
+			vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supported2);
+		}
+
+		VkPhysicalDeviceVulkan12Features features12{};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		features12.drawIndirectCount = supported12.drawIndirectCount;
+		features12.timelineSemaphore = supported12.timelineSemaphore;
+		features12.hostQueryReset = supported12.hostQueryReset;
+		// GPU pointers to buffers (VulkanBuffer::GetDeviceAddress), for
+		// the inputs and scratch of acceleration structure builds
+		features12.bufferDeviceAddress = supported12.bufferDeviceAddress;
+		// fp16 arithmetic in shaders, for the HalfPrecision fragment variants
+		// (ShaderVariant.hpp); 16-bit storage lets buffers hold fp16 data too
+		features12.shaderFloat16 = supported12.shaderFloat16;
+		VkPhysicalDeviceVulkan11Features features11{};
+		features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+		features11.storageBuffer16BitAccess = supported11.storageBuffer16BitAccess;
+		features11.uniformAndStorageBuffer16BitAccess = supported11.uniformAndStorageBuffer16BitAccess;
+
+		// Descriptor indexing backs the bindless texture/material table (see
+		// VulkanDescriptorManager::InitializeBindless). All-or-nothing: without
+		// every piece the mesh passes keep their per-texture sets.
+		const bool descriptorIndexing =
+			supported12.runtimeDescriptorArray &&
+			supported12.descriptorBindingPartiallyBound &&
+			supported12.descriptorBindingSampledImageUpdateAfterBind &&
+			supported12.descriptorBindingUpdateUnusedWhilePending &&
+			supported12.shaderSampledImageArrayNonUniformIndexing;
+		if (descriptorIndexing) {
+			features12.descriptorIndexing = supported12.descriptorIndexing;
+			features12.runtimeDescriptorArray = VK_TRUE;
+			features12.descriptorBindingPartiallyBound = VK_TRUE;
+			features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		}
+
+		// Optional: gl_Layer from the vertex stage, so all shadow cascades can be
+		// drawn in one layered pass (Renderer::RecordShadowPassLayered)
+		std::vector<const char*> extensions = m_DeviceExtensions;
+		const bool outputLayer = IsDeviceExtensionAvailable(VK_EXT_SHADER_VIEWPORT_INDEX_LAYER_EXTENSION_NAME);
+		if (outputLayer) {
+			extensions.push_back(VK_EXT_SHADER_VIEWPORT_INDEX_LAYER_EXTENSION_NAME);
+		}
+
+		// Optional: present ids + vkWaitForPresentKHR, so the low-latency mode
+		// can wait for the previous image to reach the display before sampling
+		// input (FrameSyncManager::LowLatencyWait). Needs both extensions.
+		VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+		presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+		VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+		presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+		presentIdFeatures.pNext = &presentWaitFeatures;
+
+		const bool presentWait = presentWaitExtensions &&
+			(deviceProperties.apiVersion >= VK_API_VERSION_1_2) &&
+			supportedPresentId.presentId && supportedPresentWait.presentWait;
+		if (presentWait) {
+			presentIdFeatures.presentId = VK_TRUE;
+			presentWaitFeatures.presentWait = VK_TRUE;
+			features12.pNext = &presentIdFeatures;
+			extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+			extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+		}
+
+		// Optional: a per-pass shading-rate attachment, so terrain, grass and
+		// the cloud composite shade far and sky tiles at 2x2
+		// (VariableRateShading). Pipeline rates come with the attachment
+		// feature; the image is r8ui, written by compute and read as the
+		// attachment, so the format has to support both.
+		VkPhysicalDeviceFragmentShadingRateFeaturesKHR shadingRateFeatures{};
+		shadingRateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+		VkPhysicalDeviceFragmentShadingRatePropertiesKHR shadingRateProperties{};
+		shadingRateProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR;
+
+		bool shadingRate = shadingRateExtension &&
+			(deviceProperties.apiVersion >= VK_API_VERSION_1_2) &&
+			supportedShadingRate.pipelineFragmentShadingRate && supportedShadingRate.attachmentFragmentShadingRate &&
+			deviceFeatures.shaderStorageImageExtendedFormats;
+		if (shadingRate) {
+			VkFormatProperties rateFormat{};
+			vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, VK_FORMAT_R8_UINT, &rateFormat);
+			const VkFormatFeatureFlags needed =
+				VK_FORMAT_FEATURE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR | VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+			shadingRate = (rateFormat.optimalTilingFeatures & needed) == needed;
+		}
+		if (shadingRate) {
+			VkPhysicalDeviceProperties2 properties2{};
+			properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties2.pNext = &shadingRateProperties;
+			vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties2);
+
+			shadingRateFeatures.pipelineFragmentShadingRate = VK_TRUE;
+			shadingRateFeatures.attachmentFragmentShadingRate = VK_TRUE;
+			shadingRateFeatures.pNext = features12.pNext;
+			features12.pNext = &shadingRateFeatures;
+			extensions.push_back(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+		}
+
+		// Optional: render passes begun on image views (vkCmdBeginRenderingKHR)
+		// with pipelines built against attachment formats, so the post-process
+		// pass has no per-swapchain-image framebuffers to rebuild on resize or
+		// present-mode change (RenderPassManager::IsPostProcessDynamic). Its
+		// dependencies (create_renderpass2, depth_stencil_resolve) are core 1.2.
+		VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+		dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+		bool dynamicRendering = dynamicRenderingExtension &&
+			(deviceProperties.apiVersion >= VK_API_VERSION_1_2) &&
+			supportedDynamicRendering.dynamicRendering;
+		if (dynamicRendering) {
+			dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+			dynamicRenderingFeatures.pNext = features12.pNext;
+			features12.pNext = &dynamicRenderingFeatures;
+			extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+		}
+
+		// Optional: vkCmdPipelineBarrier2KHR, so the compute passes' barriers
+		// carry exact stage/access masks (storage vs sampled reads, copy vs
+		// clear) and queue up into one call (ComputeDispatcher::QueueBufferBarrier)
+		VkPhysicalDeviceSynchronization2FeaturesKHR sync2Features{};
+		sync2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+		bool sync2 = sync2Extension &&
+			(deviceProperties.apiVersion >= VK_API_VERSION_1_2) &&
+			supportedSync2.synchronization2;
+		if (sync2) {
+			sync2Features.synchronization2 = VK_TRUE;
+			sync2Features.pNext = features12.pNext;
+			features12.pNext = &sync2Features;
+			extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		}
+
+		// Optional: descriptors written straight into the command buffer for
+		// small graphics-only sets, no set allocated (VulkanDescriptorManager::UsesPushDescriptors)
+		bool pushDescriptor = IsDeviceExtensionAvailable(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+		if (pushDescriptor) {
+			extensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+		}
+
+		// Optional: per-heap budgets from the driver, which VMA reports and
+		// the texture streamer evicts against (VulkanMemoryManager::GetDeviceBudget)
+		const bool memoryBudget = IsDeviceExtensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		if (memoryBudget) {
+			extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+
+		// Optional: a priority on each VkDeviceMemory, so under VRAM pressure
+		// the driver moves cold textures to system memory before render
+		// targets and shadow maps (VulkanMemoryManager, GpuMemoryPriority).
+		// Pageable device-local memory lets it do so on drivers that would
+		// otherwise only fail the allocation or demote whatever came last.
+		VkPhysicalDeviceMemoryPriorityFeaturesEXT memoryPriorityFeatures{};
+		memoryPriorityFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+		const bool memoryPriority = memoryPriorityExtension &&
+			(deviceProperties.apiVersion >= VK_API_VERSION_1_2) &&
+			supportedMemoryPriority.memoryPriority;
+		if (memoryPriority) {
+			memoryPriorityFeatures.memoryPriority = VK_TRUE;
+			memoryPriorityFeatures.pNext = features12.pNext;
+			features12.pNext = &memoryPriorityFeatures;
+			extensions.push_back(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+		}
+		VkPhysicalDevicePageableDeviceLocalMemoryFeaturesEXT pageableMemoryFeatures{};
+		pageableMemoryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+		const bool pageableMemory = memoryPriority && pageableMemoryExtension &&
+			supportedPageableMemory.pageableDeviceLocalMemory;
+		if (pageableMemory) {
+			pageableMemoryFeatures.pageableDeviceLocalMemory = VK_TRUE;
+			pageableMemoryFeatures.pNext = features12.pNext;
+			features12.pNext = &pageableMemoryFeatures;
+			extensions.push_back(VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME);
+		}
+
+		// Optional: acceleration structures traced from fragment shaders, so
+		// the sun's shadow can be a ray per pixel instead of the cascades
+		// (RayTracedShadows). Builds read the mesh buffers by device address.
+		VkPhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructureFeatures{};
+		accelerationStructureFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
+		VkPhysicalDeviceRayQueryFeaturesKHR rayQueryFeatures{};
+		rayQueryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR;
+		bool rayQuery = rayQueryExtensions &&
+			(deviceProperties.apiVersion >= VK_API_VERSION_1_2) &&
+			supported12.bufferDeviceAddress &&
+			supportedAccelerationStructure.accelerationStructure && supportedRayQuery.rayQuery;
+		if (rayQuery) {
+			accelerationStructureFeatures.accelerationStructure = VK_TRUE;
+			rayQueryFeatures.rayQuery = VK_TRUE;
+			rayQueryFeatures.pNext = features12.pNext;
+			accelerationStructureFeatures.pNext = &rayQueryFeatures;
+			features12.pNext = &accelerationStructureFeatures;
+			extensions.push_back(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
+			extensions.push_back(VK_KHR_RAY_QUERY_EXTENSION_NAME);
+			extensions.push_back(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
+		}
 
 		// Create the logical device
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		if (deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+			features11.pNext = features12.pNext;
+			features12.pNext = &features11;
+			createInfo.pNext = &features12;
+		}
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 		createInfo.pEnabledFeatures = &deviceFeatures;
 
 		// Enable device extensions (swapchain support)
-		createInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
-		createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+		createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+		createInfo.ppEnabledExtensionNames = extensions.data();
 
 		// Validation layers 
 		if (m_EnableValidationLayers) {
@@ -372,14 +783,171 @@ namespace Nightbloom
 		}
 
 		m_EnabledFeatures = deviceFeatures;
+		m_DrawIndirectCountEnabled = (createInfo.pNext != nullptr) && features12.drawIndirectCount == VK_TRUE;
+		LOG_INFO("Draw indirect count: {}", m_DrawIndirectCountEnabled ? "enabled" : "unsupported");
+		m_DescriptorIndexingEnabled = (createInfo.pNext != nullptr) && descriptorIndexing;
+		LOG_INFO("Descriptor indexing: {}", m_DescriptorIndexingEnabled ? "enabled" : "unsupported");
+		m_ShaderOutputLayerEnabled = outputLayer;
+		LOG_INFO("Vertex gl_Layer output: {}", m_ShaderOutputLayerEnabled ? "enabled" : "unsupported");
+		m_TimelineSemaphoreEnabled = (createInfo.pNext != nullptr) && features12.timelineSemaphore == VK_TRUE;
+		LOG_INFO("Timeline semaphores: {}", m_TimelineSemaphoreEnabled ? "enabled" : "unsupported (fence fallback)");
+		// Page binds are ordered against the frames through the graphics timeline
+		m_SparseResidencyEnabled = deviceFeatures.sparseBinding == VK_TRUE && m_TimelineSemaphoreEnabled;
+		if (m_SparseResidencyEnabled)
+			LOG_INFO("Sparse residency: 2D {}, 3D {}{}", deviceFeatures.sparseResidencyImage2D ? "yes" : "no",
+				deviceFeatures.sparseResidencyImage3D ? "yes" : "no",
+				deviceProperties.sparseProperties.residencyNonResidentStrict ? " (unbound reads are zero)" : "");
+		else
+			LOG_INFO("Sparse residency: unsupported (images allocated whole)");
+		m_HostQueryResetEnabled = (createInfo.pNext != nullptr) && features12.hostQueryReset == VK_TRUE;
+		LOG_INFO("Host query reset: {}", m_HostQueryResetEnabled ? "enabled" : "unsupported (no transfer-queue timings)");
+		m_BufferDeviceAddressEnabled = (createInfo.pNext != nullptr) && features12.bufferDeviceAddress == VK_TRUE;
+		LOG_INFO("Buffer device address: {}", m_BufferDeviceAddressEnabled ? "enabled" : "unsupported (descriptors only)");
+		m_ShaderFloat16Enabled = (createInfo.pNext != nullptr) && features12.shaderFloat16 == VK_TRUE;
+		m_Storage16BitEnabled = (createInfo.pNext != nullptr) && features11.storageBuffer16BitAccess == VK_TRUE;
+		LOG_INFO("Shader float16: {}, 16-bit storage: {}", m_ShaderFloat16Enabled ? "enabled" : "unsupported (fp32 shading)",
+			m_Storage16BitEnabled ? "enabled" : "unsupported");
+
+		// Subgroup size and the operations compute shaders may use; the
+		// culling and compaction kernels pick their subgroup build (ShaderBuild::
+		// SubgroupOps) when ballot and arithmetic are both there.
+		if (deviceProperties.apiVersion >= VK_API_VERSION_1_1) {
+			VkPhysicalDeviceSubgroupProperties subgroupProperties{};
+			subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+			VkPhysicalDeviceProperties2 properties2{};
+			properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties2.pNext = &subgroupProperties;
+			vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties2);
+
+			m_SubgroupSize = subgroupProperties.subgroupSize;
+			if (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT)
+				m_SubgroupOperations = subgroupProperties.supportedOperations;
+		}
+		LOG_INFO("Subgroups: size {}, compute ops 0x{:x}{}", m_SubgroupSize, m_SubgroupOperations,
+			SupportsFeature("subgroup_ops") ? "" : " (atomic fallbacks)");
+		m_PresentWaitEnabled = presentWait;
+		LOG_INFO("Present wait: {}", m_PresentWaitEnabled ? "enabled" : "unsupported (estimated pacing)");
+		m_MemoryBudgetEnabled = memoryBudget;
+		LOG_INFO("Memory budget: {}", m_MemoryBudgetEnabled ? "enabled" : "unsupported (heap size estimate)");
+		m_MemoryPriorityEnabled = memoryPriority;
+		m_PageableMemoryEnabled = pageableMemory;
+		LOG_INFO("Memory priority: {}{}", m_MemoryPriorityEnabled ? "enabled" : "unsupported (driver picks what to evict)",
+			m_PageableMemoryEnabled ? ", pageable device-local memory" : "");
+		m_FragmentShadingRateEnabled = shadingRate;
+		if (m_FragmentShadingRateEnabled)
+		{
+			// 16x16 tiles where the device allows it (power-of-two sizes only)
+			const VkExtent2D minTexel = shadingRateProperties.minFragmentShadingRateAttachmentTexelSize;
+			const VkExtent2D maxTexel = shadingRateProperties.maxFragmentShadingRateAttachmentTexelSize;
+			m_ShadingRateTexelSize.width = std::clamp(16u, minTexel.width, maxTexel.width);
+			m_ShadingRateTexelSize.height = std::clamp(16u, minTexel.height, maxTexel.height);
+			LOG_INFO("Fragment shading rate: enabled ({}x{} attachment texels)",
+				m_ShadingRateTexelSize.width, m_ShadingRateTexelSize.height);
+		}
+		else
+		{
+			LOG_INFO("Fragment shading rate: unsupported (full-rate shading)");
+		}
+
+		if (dynamicRendering)
+		{
+			m_CmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkCmdBeginRenderingKHR"));
+			m_CmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkCmdEndRenderingKHR"));
+			dynamicRendering = m_CmdBeginRendering && m_CmdEndRendering;
+		}
+		m_DynamicRenderingEnabled = dynamicRendering;
+		LOG_INFO("Dynamic rendering: {}", m_DynamicRenderingEnabled ? "enabled" : "unsupported (render pass objects)");
+
+		if (sync2)
+		{
+			m_CmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+				vkGetDeviceProcAddr(m_Device, "vkCmdPipelineBarrier2KHR"));
+			sync2 = m_CmdPipelineBarrier2 != nullptr;
+		}
+		m_Synchronization2Enabled = sync2;
+		LOG_INFO("Synchronization2: {}", m_Synchronization2Enabled ? "enabled" : "unsupported (legacy barriers)");
+
+		if (pushDescriptor)
+		{
+			m_CmdPushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkCmdPushDescriptorSetKHR"));
+			pushDescriptor = m_CmdPushDescriptorSet != nullptr;
+		}
+		m_PushDescriptorEnabled = pushDescriptor;
+		LOG_INFO("Push descriptors: {}", m_PushDescriptorEnabled ? "enabled" : "unsupported (allocated sets)");
+
+		if (rayQuery)
+		{
+			m_CreateAccelerationStructure = reinterpret_cast<PFN_vkCreateAccelerationStructureKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkCreateAccelerationStructureKHR"));
+			m_DestroyAccelerationStructure = reinterpret_cast<PFN_vkDestroyAccelerationStructureKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkDestroyAccelerationStructureKHR"));
+			m_GetAccelerationStructureBuildSizes = reinterpret_cast<PFN_vkGetAccelerationStructureBuildSizesKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkGetAccelerationStructureBuildSizesKHR"));
+			m_CmdBuildAccelerationStructures = reinterpret_cast<PFN_vkCmdBuildAccelerationStructuresKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkCmdBuildAccelerationStructuresKHR"));
+			m_GetAccelerationStructureDeviceAddress = reinterpret_cast<PFN_vkGetAccelerationStructureDeviceAddressKHR>(
+				vkGetDeviceProcAddr(m_Device, "vkGetAccelerationStructureDeviceAddressKHR"));
+			rayQuery = m_CreateAccelerationStructure && m_DestroyAccelerationStructure &&
+				m_GetAccelerationStructureBuildSizes && m_CmdBuildAccelerationStructures &&
+				m_GetAccelerationStructureDeviceAddress;
+		}
+		if (rayQuery)
+		{
+			VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties{};
+			accelerationStructureProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+			VkPhysicalDeviceProperties2 properties2{};
+			properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties2.pNext = &accelerationStructureProperties;
+			vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties2);
+			m_AccelerationStructureScratchAlignment =
+				std::max(accelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment, 1u);
+		}
+		m_RayQueryEnabled = rayQuery;
+		LOG_INFO("Ray query: {}", m_RayQueryEnabled ? "enabled" : "unsupported (cascaded sun shadows only)");
 
 		// Get queue handles
 		vkGetDeviceQueue(m_Device, m_QueueFamilies.graphicsFamily.value(), 0, &m_GraphicsQueue);
 		vkGetDeviceQueue(m_Device, m_QueueFamilies.presentFamily.value(), 0, &m_PresentQueue);
+		if (m_QueueFamilies.transferFamily.has_value())
+		{
+			vkGetDeviceQueue(m_Device, m_QueueFamilies.transferFamily.value(), 0, &m_TransferQueue);
+		}
+		if (m_QueueFamilies.computeFamily.has_value())
+		{
+			vkGetDeviceQueue(m_Device, m_QueueFamilies.computeFamily.value(),
+				m_QueueFamilies.computeQueueIndex, &m_ComputeQueue);
+		}
+
+		m_GraphicsTimeline = std::make_unique<VulkanQueueTimeline>();
+		m_GraphicsTimeline->Initialize(m_Device, m_GraphicsQueue, m_TimelineSemaphoreEnabled);
+		m_DeletionQueue = std::make_unique<VulkanDeletionQueue>();
+		m_DeletionQueue->Initialize(m_GraphicsTimeline.get());
+		m_SamplerCache = std::make_unique<VulkanSamplerCache>();
+		m_SamplerCache->Initialize(m_Device);
 
 		LOG_INFO("Logical device created successfully");
 		LOG_INFO("Graphics queue family index: {}", m_QueueFamilies.graphicsFamily.value());
 		LOG_INFO("Present queue family index: {}", m_QueueFamilies.presentFamily.value());
+		if (m_QueueFamilies.transferFamily.has_value())
+		{
+			LOG_INFO("Transfer queue family index: {} (dedicated)", m_QueueFamilies.transferFamily.value());
+		}
+		else
+		{
+			LOG_INFO("No dedicated transfer queue family - uploads use the graphics queue");
+		}
+		if (m_QueueFamilies.computeFamily.has_value())
+		{
+			LOG_INFO("Compute queue family index: {} (async, queue {})",
+				m_QueueFamilies.computeFamily.value(), m_QueueFamilies.computeQueueIndex);
+		}
+		else
+		{
+			LOG_INFO("No async compute queue family - compute runs on the graphics queue");
+		}
 
 		return true;
 	}
@@ -413,6 +981,17 @@ namespace Nightbloom
 		return true;
 	}
 
+	bool VulkanDevice::IsInstanceExtensionAvailable(const char* name) const
+	{
+		uint32_t count = 0;
+		vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+		std::vector<VkExtensionProperties> extensions(count);
+		vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data());
+
+		return std::any_of(extensions.begin(), extensions.end(),
+			[name](const VkExtensionProperties& extension) { return strcmp(extension.extensionName, name) == 0; });
+	}
+
 	std::vector<const char*> VulkanDevice::GetRequiredExtensions() const
 	{
 		std::vector<const char*> extensions;
@@ -430,7 +1009,7 @@ namespace Nightbloom
 #endif
 
 		//Debug extensions
-		if (m_EnableValidationLayers) {
+		if (m_DebugUtilsEnabled) {
 			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 		}
 
@@ -493,9 +1072,55 @@ namespace Nightbloom
 			i++;
 		}
 
+		// Dedicated transfer family: TRANSFER without GRAPHICS. Prefer one
+		// without COMPUTE as well (the DMA engine on discrete GPUs).
+		for (uint32_t family = 0; family < queueFamilyCount; ++family)
+		{
+			const VkQueueFlags flags = queueFamilies[family].queueFlags;
+			if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT))
+				continue;
+
+			if (!(flags & VK_QUEUE_COMPUTE_BIT)) {
+				indices.transferFamily = family;
+				break;
+			}
+			if (!indices.transferFamily.has_value()) {
+				indices.transferFamily = family;
+			}
+		}
+
+		// Async compute family: COMPUTE without GRAPHICS. Prefer one the
+		// transfer queue isn't using; sharing it needs a second queue there,
+		// since uploads and compute submit independently.
+		for (uint32_t family = 0; family < queueFamilyCount; ++family)
+		{
+			const VkQueueFamilyProperties& props = queueFamilies[family];
+			if (!(props.queueFlags & VK_QUEUE_COMPUTE_BIT) || (props.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+				continue;
+
+			if (indices.transferFamily != family) {
+				indices.computeFamily = family;
+				indices.computeQueueIndex = 0;
+				break;
+			}
+			if (!indices.computeFamily.has_value() && props.queueCount >= 2) {
+				indices.computeFamily = family;
+				indices.computeQueueIndex = 1;
+			}
+		}
+
 		return indices;
 	}
 
+	VkQueue VulkanDevice::GetQueueForFamily(uint32_t queueFamily) const
+	{
+		if (m_ComputeQueue != VK_NULL_HANDLE && m_QueueFamilies.computeFamily == queueFamily)
+			return m_ComputeQueue;
+		if (m_TransferQueue != VK_NULL_HANDLE && m_QueueFamilies.transferFamily == queueFamily)
+			return m_TransferQueue;
+		return m_GraphicsQueue;
+	}
+
 	bool VulkanDevice::CheckDeviceExtensionSupport(VkPhysicalDevice device) const
 	{
 		uint32_t extensionCount;
@@ -514,6 +1139,22 @@ namespace Nightbloom
 		return requiredExtensions.empty();
  	}
 
+	bool VulkanDevice::IsDeviceExtensionAvailable(const char* name) const
+	{
+		uint32_t extensionCount;
+		vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, nullptr);
+
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+		for (const auto& extension : availableExtensions)
+		{
+			if (std::strcmp(extension.extensionName, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
 	bool VulkanDevice::IsSamplerAnisotrpyEnabled() const
 	{
 		return m_EnabledFeatures.samplerAnisotropy == VK_TRUE;
@@ -586,6 +1227,89 @@ namespace Nightbloom
 		else if (feature == "sampler_anisotropy") {
 			return m_EnabledFeatures.samplerAnisotropy == VK_TRUE;
 		}
+		else if (feature == "multi_draw_indirect") {
+			return m_EnabledFeatures.multiDrawIndirect == VK_TRUE;
+		}
+		else if (feature == "texture_compression_bc") {
+			return m_EnabledFeatures.textureCompressionBC == VK_TRUE;
+		}
+		else if (feature == "texture_compression_astc") {
+			return m_EnabledFeatures.textureCompressionASTC_LDR == VK_TRUE;
+		}
+		else if (feature == "draw_indirect_count") {
+			return m_DrawIndirectCountEnabled;
+		}
+		else if (feature == "descriptor_indexing") {
+			return m_DescriptorIndexingEnabled;
+		}
+		else if (feature == "shader_output_layer") {
+			return m_ShaderOutputLayerEnabled;
+		}
+		else if (feature == "timeline_semaphore") {
+			return m_TimelineSemaphoreEnabled;
+		}
+		else if (feature == "host_query_reset") {
+			return m_HostQueryResetEnabled;
+		}
+		else if (feature == "pipeline_statistics_query") {
+			return m_EnabledFeatures.pipelineStatisticsQuery == VK_TRUE;
+		}
+		else if (feature == "inherited_queries") {
+			return m_EnabledFeatures.inheritedQueries == VK_TRUE;
+		}
+		else if (feature == "occlusion_query_precise") {
+			return m_EnabledFeatures.occlusionQueryPrecise == VK_TRUE;
+		}
+		else if (feature == "large_points") {
+			return m_EnabledFeatures.largePoints == VK_TRUE;
+		}
+		else if (feature == "present_wait") {
+			return m_PresentWaitEnabled;
+		}
+		else if (feature == "memory_budget") {
+			return m_MemoryBudgetEnabled;
+		}
+		else if (feature == "sparse_residency_2d") {
+			return m_SparseResidencyEnabled && m_EnabledFeatures.sparseResidencyImage2D == VK_TRUE;
+		}
+		else if (feature == "sparse_residency_3d") {
+			return m_SparseResidencyEnabled && m_EnabledFeatures.sparseResidencyImage3D == VK_TRUE;
+		}
+		else if (feature == "memory_priority") {
+			return m_MemoryPriorityEnabled;
+		}
+		else if (feature == "pageable_device_local_memory") {
+			return m_PageableMemoryEnabled;
+		}
+		else if (feature == "fragment_shading_rate") {
+			return m_FragmentShadingRateEnabled;
+		}
+		else if (feature == "dynamic_rendering") {
+			return m_DynamicRenderingEnabled;
+		}
+		else if (feature == "synchronization2") {
+			return m_Synchronization2Enabled;
+		}
+		else if (feature == "push_descriptor") {
+			return m_PushDescriptorEnabled;
+		}
+		else if (feature == "ray_query") {
+			return m_RayQueryEnabled;
+		}
+		else if (feature == "buffer_device_address") {
+			return m_BufferDeviceAddressEnabled;
+		}
+		else if (feature == "shader_float16") {
+			return m_ShaderFloat16Enabled;
+		}
+		else if (feature == "storage_16bit") {
+			return m_Storage16BitEnabled;
+		}
+		else if (feature == "subgroup_ops") {
+			const VkSubgroupFeatureFlags needed = VK_SUBGROUP_FEATURE_BASIC_BIT |
+				VK_SUBGROUP_FEATURE_BALLOT_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+			return (m_SubgroupOperations & needed) == needed;
+		}
 
 		return false;
 	}
@@ -618,4 +1342,30 @@ namespace Nightbloom
 		}
 		return VK_SAMPLE_COUNT_1_BIT;
 	}
-}
\ No newline at end of file
+
+	VkResolveModeFlags VulkanDevice::GetSupportedDepthResolveModes() const
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+		if (properties.apiVersion < VK_API_VERSION_1_2)
+			return 0;
+
+		VkPhysicalDeviceDepthStencilResolveProperties resolveProperties{};
+		resolveProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEPTH_STENCIL_RESOLVE_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &resolveProperties;
+		vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties2);
+		return resolveProperties.supportedDepthResolveModes;
+	}
+
+	bool VulkanDevice::SupportsStorageImageFormat(VkFormat format) const
+	{
+		if (m_EnabledFeatures.shaderStorageImageExtendedFormats != VK_TRUE)
+			return false;
+
+		VkFormatProperties properties{};
+		vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &properties);
+		return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+	}
+}
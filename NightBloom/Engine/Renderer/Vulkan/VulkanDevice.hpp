@@ -14,6 +14,10 @@
 namespace Nightbloom
 {
 	class VulkanSwapchain;
+	class VulkanPipelineCache;
+	class VulkanQueueTimeline;
+	class VulkanDeletionQueue;
+	class VulkanSamplerCache;
 
 	class VulkanDevice : public RenderDevice
 	{
@@ -60,6 +64,16 @@ namespace Nightbloom
 		// safe MSAA level for the offscreen scene pass.
 		VkSampleCountFlagBits GetMaxUsableSampleCount(VkSampleCountFlagBits maxCap = VK_SAMPLE_COUNT_8_BIT) const;
 
+		// Depth resolve modes a render pass can use to resolve a multisampled
+		// depth attachment in-pass (VK_KHR_depth_stencil_resolve, core 1.2);
+		// 0 on a 1.1 device. SAMPLE_ZERO is always in the set when it isn't 0.
+		VkResolveModeFlags GetSupportedDepthResolveModes() const;
+
+		// Whether compute can read and write 'format' as a storage image
+		// with optimal tiling. Formats outside the guaranteed set (e.g. the
+		// scene color's B10G11R11) also need shaderStorageImageExtendedFormats.
+		bool SupportsStorageImageFormat(VkFormat format) const;
+
 		// Getters for Vulkan-specific properties
 		VkInstance GetInstance() const { return m_Instance; }
 		VkPhysicalDevice GetPhysicalDevice() const { return m_PhysicalDevice; }
@@ -69,11 +83,126 @@ namespace Nightbloom
 		uint32_t GetGraphicsQueueFamily() const { return m_QueueFamilies.graphicsFamily.value_or(0); }
 		uint32_t GetPresentQueueFamily() const { return m_QueueFamilies.presentFamily.value_or(0); }
 
+		// Dedicated transfer queue (a family with TRANSFER but no GRAPHICS, so
+		// its copies can overlap rendering). Without one these return the
+		// graphics queue/family and HasDedicatedTransferQueue() is false.
+		VkQueue GetTransferQueue() const { return m_TransferQueue != VK_NULL_HANDLE ? m_TransferQueue : m_GraphicsQueue; }
+		uint32_t GetTransferQueueFamily() const { return m_QueueFamilies.transferFamily.value_or(GetGraphicsQueueFamily()); }
+		bool HasDedicatedTransferQueue() const { return m_TransferQueue != VK_NULL_HANDLE; }
+
+		// Async compute queue (a family with COMPUTE but no GRAPHICS, so its
+		// dispatches can overlap rendering). Same fallback as the transfer
+		// queue: without one these return the graphics queue/family.
+		VkQueue GetComputeQueue() const { return m_ComputeQueue != VK_NULL_HANDLE ? m_ComputeQueue : m_GraphicsQueue; }
+		uint32_t GetComputeQueueFamily() const { return m_QueueFamilies.computeFamily.value_or(GetGraphicsQueueFamily()); }
+		bool HasAsyncComputeQueue() const { return m_ComputeQueue != VK_NULL_HANDLE; }
+
+		// The queue this device created for 'queueFamily' (graphics, transfer
+		// or compute); the graphics queue for any other family.
+		VkQueue GetQueueForFamily(uint32_t queueFamily) const;
+
+		// Completion timeline of the graphics queue. Frame submissions and
+		// upload batches both go through it, so "has this finished" is one
+		// value comparison (see VulkanQueueTimeline).
+		VulkanQueueTimeline* GetGraphicsTimeline() const { return m_GraphicsTimeline.get(); }
+
+		// Destruction deferred until the graphics timeline passes the frames
+		// that may still use an object (see VulkanDeletionQueue). Collected
+		// once per frame by the Renderer.
+		VulkanDeletionQueue* GetDeletionQueue() const { return m_DeletionQueue.get(); }
+
+		// Shared, immutable samplers keyed by their description (see
+		// VulkanSamplerCache). Alive from device creation to Shutdown;
+		// callers never destroy the samplers they get from it.
+		VulkanSamplerCache* GetSamplerCache() const { return m_SamplerCache.get(); }
+
+		// VK_KHR_dynamic_rendering (SupportsFeature("dynamic_rendering")):
+		// render straight into image views, no VkRenderPass/VkFramebuffer.
+		// Only valid with the feature enabled.
+		void CmdBeginRendering(VkCommandBuffer cmd, const VkRenderingInfoKHR& info) const { m_CmdBeginRendering(cmd, &info); }
+		void CmdEndRendering(VkCommandBuffer cmd) const { m_CmdEndRendering(cmd); }
+
+		// VK_KHR_synchronization2 (SupportsFeature("synchronization2")):
+		// barriers with 64-bit stage/access masks, one dependency per call.
+		// Only valid with the feature enabled; see ComputeDispatcher's batch.
+		bool IsSynchronization2Enabled() const { return m_Synchronization2Enabled; }
+		void CmdPipelineBarrier2(VkCommandBuffer cmd, const VkDependencyInfoKHR& info) const { m_CmdPipelineBarrier2(cmd, &info); }
+
+		// Vulkan 1.2 bufferDeviceAddress (SupportsFeature("buffer_device_address")):
+		// buffers created with BufferDesc::deviceAddress have a GPU pointer
+		bool IsBufferDeviceAddressEnabled() const { return m_BufferDeviceAddressEnabled; }
+
+		// Vulkan 1.2 shaderFloat16 (SupportsFeature("shader_float16")): fp16
+		// arithmetic, which the HalfPrecision shader variants need. 16-bit
+		// storage (SupportsFeature("storage_16bit")) is reported separately;
+		// the fp16 variants keep 32-bit buffers and interfaces.
+		bool IsShaderFloat16Enabled() const { return m_ShaderFloat16Enabled; }
+		bool IsStorage16BitEnabled() const { return m_Storage16BitEnabled; }
+
+		// Subgroup size and the VK_SUBGROUP_FEATURE_* bits compute shaders may
+		// use (0 before Vulkan 1.1). SupportsFeature("subgroup_ops") wants
+		// basic, ballot and arithmetic: what the subgroup kernel builds use.
+		uint32_t GetSubgroupSize() const { return m_SubgroupSize; }
+		VkSubgroupFeatureFlags GetSubgroupOperations() const { return m_SubgroupOperations; }
+
+		// VK_KHR_push_descriptor (SupportsFeature("push_descriptor")): writes
+		// a push set's descriptors into the command buffer. Only valid with
+		// the feature enabled; see VulkanDescriptorManager::UsesPushDescriptors.
+		bool IsPushDescriptorEnabled() const { return m_PushDescriptorEnabled; }
+		void CmdPushDescriptorSet(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout,
+			uint32_t set, uint32_t writeCount, const VkWriteDescriptorSet* writes) const
+		{
+			m_CmdPushDescriptorSet(cmd, bindPoint, layout, set, writeCount, writes);
+		}
+
+		// VK_KHR_acceleration_structure + VK_KHR_ray_query (SupportsFeature("ray_query")):
+		// acceleration structures built on the graphics queue and traced from
+		// fragment shaders. Only valid with the feature enabled; see RayTracedShadows.
+		bool IsRayQueryEnabled() const { return m_RayQueryEnabled; }
+		VkDeviceSize GetAccelerationStructureScratchAlignment() const { return m_AccelerationStructureScratchAlignment; }
+		VkResult CreateAccelerationStructure(const VkAccelerationStructureCreateInfoKHR& info,
+			VkAccelerationStructureKHR* structure) const
+		{
+			return m_CreateAccelerationStructure(m_Device, &info, nullptr, structure);
+		}
+		void DestroyAccelerationStructure(VkAccelerationStructureKHR structure) const
+		{
+			m_DestroyAccelerationStructure(m_Device, structure, nullptr);
+		}
+		void GetAccelerationStructureBuildSizes(const VkAccelerationStructureBuildGeometryInfoKHR& info,
+			const uint32_t* maxPrimitiveCounts, VkAccelerationStructureBuildSizesInfoKHR* sizes) const
+		{
+			m_GetAccelerationStructureBuildSizes(m_Device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+				&info, maxPrimitiveCounts, sizes);
+		}
+		void CmdBuildAccelerationStructures(VkCommandBuffer cmd, uint32_t count,
+			const VkAccelerationStructureBuildGeometryInfoKHR* infos,
+			const VkAccelerationStructureBuildRangeInfoKHR* const* ranges) const
+		{
+			m_CmdBuildAccelerationStructures(cmd, count, infos, ranges);
+		}
+		VkDeviceAddress GetAccelerationStructureDeviceAddress(VkAccelerationStructureKHR structure) const
+		{
+			VkAccelerationStructureDeviceAddressInfoKHR info{};
+			info.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
+			info.accelerationStructure = structure;
+			return m_GetAccelerationStructureDeviceAddress(m_Device, &info);
+		}
+
+		// Shared by every pipeline creation (VK_NULL_HANDLE if it couldn't be
+		// created). Loaded from / saved to 'directory' across runs.
+		bool InitializePipelineCache(const std::string& directory);
+		void ShutdownPipelineCache();
+		VkPipelineCache GetPipelineCache() const;
+
 		// Queue family indices, needed by swapchain and other components
 		struct QueueFamilyIndices
 		{
 			std::optional<uint32_t> graphicsFamily;
 			std::optional<uint32_t> presentFamily;
+			std::optional<uint32_t> transferFamily;  // optional, see GetTransferQueue
+			std::optional<uint32_t> computeFamily;   // optional, see GetComputeQueue
+			uint32_t computeQueueIndex = 0;          // 1 when it shares the transfer family
 
 			bool IsComplete() const
 			{
@@ -85,6 +214,11 @@ namespace Nightbloom
 
 		// EnabledFeatures
 		bool IsSamplerAnisotrpyEnabled() const;
+		// vkResetQueryPool from the host (GpuProfiler's transfer-queue spans)
+		bool IsHostQueryResetEnabled() const { return m_HostQueryResetEnabled; }
+		// Tile size of a shading-rate attachment (VK_KHR_fragment_shading_rate,
+		// SupportsFeature("fragment_shading_rate")); 0x0 without it
+		VkExtent2D GetShadingRateTexelSize() const { return m_ShadingRateTexelSize; }
 
 	private:
 		// Step 1: Create Vulkan instance
@@ -102,9 +236,11 @@ namespace Nightbloom
 		// Helper functions
 		bool CheckValidationLayerSupport() const;
 		std::vector<const char*> GetRequiredExtensions() const;
+		bool IsInstanceExtensionAvailable(const char* name) const;
 		bool IsDeviceSuitable(VkPhysicalDevice device) const;
 		QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device) const;
 		bool CheckDeviceExtensionSupport(VkPhysicalDevice device) const;
+		bool IsDeviceExtensionAvailable(const char* name) const;
 
 		// Debug messenger callback
 		static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
@@ -121,12 +257,19 @@ namespace Nightbloom
 		// Core Vulkan objects
 		VkInstance m_Instance = VK_NULL_HANDLE;
 		VkDebugUtilsMessengerEXT m_DebugMessenger = VK_NULL_HANDLE;
+		bool m_DebugUtilsEnabled = false;  // VK_EXT_debug_utils on the instance (messenger, VulkanDebugMarkers)
 		VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
 		VkDevice m_Device = VK_NULL_HANDLE;
 
 		// Queues
 		VkQueue m_GraphicsQueue = VK_NULL_HANDLE;
 		VkQueue m_PresentQueue = VK_NULL_HANDLE;
+		VkQueue m_TransferQueue = VK_NULL_HANDLE;  // null when there is no dedicated family
+		VkQueue m_ComputeQueue = VK_NULL_HANDLE;   // null when there is no async compute family
+		std::unique_ptr<VulkanPipelineCache> m_PipelineCache;
+		std::unique_ptr<VulkanQueueTimeline> m_GraphicsTimeline;
+		std::unique_ptr<VulkanDeletionQueue> m_DeletionQueue;
+		std::unique_ptr<VulkanSamplerCache> m_SamplerCache;
 		QueueFamilyIndices m_QueueFamilies;
 
 		// Surface (created by the swapchain, but device needs to know about it)
@@ -150,6 +293,37 @@ namespace Nightbloom
 #endif
 
 		VkPhysicalDeviceFeatures m_EnabledFeatures{};
+		bool m_DrawIndirectCountEnabled = false; // Vulkan 1.2 feature, see CreateLogicalDevice
+		bool m_DescriptorIndexingEnabled = false; // Vulkan 1.2 features for the bindless table
+		bool m_ShaderOutputLayerEnabled = false;  // VK_EXT_shader_viewport_index_layer (layered shadows)
+		bool m_TimelineSemaphoreEnabled = false;  // Vulkan 1.2 feature, backs m_GraphicsTimeline
+		bool m_HostQueryResetEnabled = false;     // Vulkan 1.2 feature, see IsHostQueryResetEnabled
+		bool m_BufferDeviceAddressEnabled = false; // Vulkan 1.2 feature, see IsBufferDeviceAddressEnabled
+		bool m_ShaderFloat16Enabled = false;      // Vulkan 1.2 feature, selects the fp16 shader variants
+		bool m_Storage16BitEnabled = false;       // Vulkan 1.1 storageBuffer16BitAccess
+		uint32_t m_SubgroupSize = 0;              // VkPhysicalDeviceSubgroupProperties
+		VkSubgroupFeatureFlags m_SubgroupOperations = 0; // ... supported in the compute stage
+		bool m_PresentWaitEnabled = false;        // VK_KHR_present_id + VK_KHR_present_wait (low-latency pacing)
+		bool m_MemoryBudgetEnabled = false;       // VK_EXT_memory_budget (VMA heap budgets)
+		bool m_SparseResidencyEnabled = false;    // sparseBinding on the graphics queue, with timeline semaphores
+		bool m_MemoryPriorityEnabled = false;     // VK_EXT_memory_priority (VMA allocation priorities)
+		bool m_PageableMemoryEnabled = false;     // VK_EXT_pageable_device_local_memory
+		bool m_FragmentShadingRateEnabled = false; // VK_KHR_fragment_shading_rate (pipeline + attachment rates)
+		VkExtent2D m_ShadingRateTexelSize = { 0, 0 };
+		bool m_DynamicRenderingEnabled = false;   // VK_KHR_dynamic_rendering (post-process pass, UI)
+		PFN_vkCmdBeginRenderingKHR m_CmdBeginRendering = nullptr;
+		PFN_vkCmdEndRenderingKHR m_CmdEndRendering = nullptr;
+		bool m_Synchronization2Enabled = false;   // VK_KHR_synchronization2 (batched compute barriers)
+		PFN_vkCmdPipelineBarrier2KHR m_CmdPipelineBarrier2 = nullptr;
+		bool m_PushDescriptorEnabled = false;     // VK_KHR_push_descriptor (per-draw foliage storage)
+		PFN_vkCmdPushDescriptorSetKHR m_CmdPushDescriptorSet = nullptr;
+		bool m_RayQueryEnabled = false;           // VK_KHR_acceleration_structure + VK_KHR_ray_query (traced sun shadows)
+		VkDeviceSize m_AccelerationStructureScratchAlignment = 1;
+		PFN_vkCreateAccelerationStructureKHR m_CreateAccelerationStructure = nullptr;
+		PFN_vkDestroyAccelerationStructureKHR m_DestroyAccelerationStructure = nullptr;
+		PFN_vkGetAccelerationStructureBuildSizesKHR m_GetAccelerationStructureBuildSizes = nullptr;
+		PFN_vkCmdBuildAccelerationStructuresKHR m_CmdBuildAccelerationStructures = nullptr;
+		PFN_vkGetAccelerationStructureDeviceAddressKHR m_GetAccelerationStructureDeviceAddress = nullptr;
 
 		void* m_WindowHandle = nullptr; // Handle to the window for presentation
 		uint32_t m_Width = 0;
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+// VulkanFrameUploadBuffer.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanFrameUploadBuffer.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	VulkanFrameUploadBuffer::~VulkanFrameUploadBuffer()
+	{
+		Cleanup();
+	}
+
+	bool VulkanFrameUploadBuffer::Initialize(VulkanMemoryManager* memoryManager, VkDeviceSize regionSize, VkDeviceSize alignment)
+	{
+		if (!memoryManager)
+		{
+			LOG_ERROR("VulkanFrameUploadBuffer::Initialize — null memory manager");
+			return false;
+		}
+
+		m_MemoryManager = memoryManager;
+		m_Layout = std::make_unique<FrameUploadLayout>(MAX_FRAMES_IN_FLIGHT, regionSize, alignment);
+
+		VulkanMemoryManager::BufferCreateInfo createInfo{};
+		createInfo.size = m_Layout->GetBufferSize();
+		createInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		createInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+		createInfo.mappable = true;
+		// Read by every draw: in VRAM where the CPU can write it there
+		createInfo.directWrite = true;
+		createInfo.category = GpuMemoryCategory::Renderer;
+		createInfo.debugName = "FrameUploadBuffer";
+
+		m_Allocation = m_MemoryManager->CreateBuffer(createInfo);
+		if (!m_Allocation || !m_Allocation->mappedData)
+		{
+			LOG_ERROR("Failed to create the {} KB frame upload buffer", createInfo.size / 1024);
+			Cleanup();
+			return false;
+		}
+
+		m_Mapped = static_cast<uint8_t*>(m_Allocation->mappedData);
+		LOG_INFO("Frame upload buffer: {} regions of {} KB", m_Layout->GetRegionCount(), m_Layout->GetRegionSize() / 1024);
+		return true;
+	}
+
+	void VulkanFrameUploadBuffer::Cleanup()
+	{
+		if (m_Allocation && m_MemoryManager)
+		{
+			m_MemoryManager->DestroyBuffer(m_Allocation);
+		}
+		m_Allocation = nullptr;
+		m_Mapped = nullptr;
+	}
+
+	FrameUploadSlot VulkanFrameUploadBuffer::Reserve(const std::string& name, VkDeviceSize size)
+	{
+		FrameUploadSlot slot;
+		if (!m_Layout)
+			return slot;
+
+		slot.offset = m_Layout->Reserve(name, size);
+		slot.size = size;
+		if (!slot.IsValid())
+		{
+			LOG_ERROR("Frame upload buffer full: no room for '{}' ({} bytes, {} of {} reserved)",
+				name, size, m_Layout->GetReservedBytes(), m_Layout->GetRegionSize());
+		}
+		return slot;
+	}
+
+	void VulkanFrameUploadBuffer::BeginFrame(uint32_t frameIndex)
+	{
+		if (m_Layout)
+			m_Layout->BeginFrame(frameIndex);
+	}
+
+	VulkanFrameUploadBuffer::Allocation VulkanFrameUploadBuffer::Allocate(VkDeviceSize size)
+	{
+		Allocation allocation;
+		if (!m_Mapped)
+			return allocation;
+
+		const uint64_t offset = m_Layout->Allocate(size);
+		if (offset == FrameUploadLayout::INVALID_OFFSET)
+		{
+			LOG_WARN("Frame upload buffer: region full, {} byte allocation dropped", size);
+			return allocation;
+		}
+
+		allocation.buffer = m_Allocation->buffer;
+		allocation.offset = offset;
+		allocation.mapped = m_Mapped + offset;
+		return allocation;
+	}
+
+	VkDeviceSize VulkanFrameUploadBuffer::GetOffset(uint32_t frameIndex, const FrameUploadSlot& slot) const
+	{
+		return m_Layout->GetRegionOffset(frameIndex) + slot.offset;
+	}
+
+	void* VulkanFrameUploadBuffer::GetMapped(uint32_t frameIndex, const FrameUploadSlot& slot) const
+	{
+		if (!m_Mapped || !slot.IsValid())
+			return nullptr;
+		return m_Mapped + GetOffset(frameIndex, slot);
+	}
+
+	void VulkanFrameUploadBuffer::Flush()
+	{
+		if (!m_Allocation || m_Layout->GetUsedBytes() == 0)
+			return;
+
+		m_MemoryManager->FlushMemory(m_Allocation->allocation,
+			m_Layout->GetRegionOffset(m_Layout->GetCurrentRegion()), m_Layout->GetUsedBytes());
+		RenderStats::Get().Add(RenderCounter::UploadBytes, m_Layout->GetUsedBytes());
+	}
+
+	void VulkanFrameUploadBuffer::Flush(uint32_t frameIndex, const FrameUploadSlot& slot)
+	{
+		if (!m_Allocation || !slot.IsValid())
+			return;
+
+		m_MemoryManager->FlushMemory(m_Allocation->allocation, GetOffset(frameIndex, slot), slot.size);
+		RenderStats::Get().Add(RenderCounter::UploadBytes, slot.size);
+	}
+}
@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+// VulkanFrameUploadBuffer.hpp
+//
+// One persistently mapped, host-visible buffer for everything the CPU writes
+// every frame: the frame, lighting, shadow and reflection uniforms, the cloud
+// and firefly params, and any transient per-frame data. Replaces a small
+// VkBuffer + VMA allocation per uniform per frame in flight with a single
+// allocation and one flush per frame; FrameUploadLayout decides the offsets.
+//
+// Persistent slots (Reserve) sit at the same offset in every frame's region,
+// so their descriptors point at buffer + GetOffset(frame, slot) and are
+// written once. Transient data (Allocate) is valid for the current frame
+// only; bind it with a dynamic offset or a per-frame descriptor.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/FrameUploadLayout.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Nightbloom
+{
+	class VulkanFrameUploadBuffer
+	{
+	public:
+		struct Allocation
+		{
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;      // from the start of the buffer
+			void* mapped = nullptr;       // null when the region is full
+		};
+
+		VulkanFrameUploadBuffer() = default;
+		~VulkanFrameUploadBuffer();
+
+		// `regionSize` bytes per frame in flight, aligned to `alignment`
+		// (minUniformBufferOffsetAlignment)
+		bool Initialize(VulkanMemoryManager* memoryManager, VkDeviceSize regionSize, VkDeviceSize alignment);
+		void Cleanup();
+
+		// A slot for data written every frame. Reserving a name again (a
+		// system initialized twice) returns the same slot.
+		FrameUploadSlot Reserve(const std::string& name, VkDeviceSize size);
+
+		// Start of a frame, after its fence: resets the frame's transient data
+		void BeginFrame(uint32_t frameIndex);
+		Allocation Allocate(VkDeviceSize size);
+
+		VkBuffer GetBuffer() const { return m_Allocation ? m_Allocation->buffer : VK_NULL_HANDLE; }
+		VkDeviceSize GetOffset(uint32_t frameIndex, const FrameUploadSlot& slot) const;
+		void* GetMapped(uint32_t frameIndex, const FrameUploadSlot& slot) const;
+
+		// Flushes everything written to the current frame's region. Once per
+		// frame, before submit; data written later (while recording) flushes
+		// its own slot.
+		void Flush();
+		void Flush(uint32_t frameIndex, const FrameUploadSlot& slot);
+
+		const FrameUploadLayout& GetLayout() const { return *m_Layout; }
+
+	private:
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		VulkanMemoryManager::BufferAllocation* m_Allocation = nullptr;
+		uint8_t* m_Mapped = nullptr;
+		std::unique_ptr<FrameUploadLayout> m_Layout;
+
+		VulkanFrameUploadBuffer(const VulkanFrameUploadBuffer&) = delete;
+		VulkanFrameUploadBuffer& operator=(const VulkanFrameUploadBuffer&) = delete;
+	};
+}
@@ -9,11 +9,56 @@
 #include "VulkanMemoryManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Core/Logger/Logger.hpp"
 #include <algorithm>
+#include <cstdint>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		VkImageCreateInfo ToVkImageCreateInfo(const VulkanMemoryManager::ImageCreateInfo& createInfo)
+		{
+			VkImageCreateInfo imageInfo = {};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = (createInfo.depth > 1 || createInfo.force3D)
+				? VK_IMAGE_TYPE_3D
+				: VK_IMAGE_TYPE_2D;
+			imageInfo.extent.width = createInfo.width;
+			imageInfo.extent.height = createInfo.height;
+			imageInfo.extent.depth = createInfo.depth;
+			imageInfo.mipLevels = createInfo.mipLevels;
+			imageInfo.arrayLayers = createInfo.arrayLayers;
+			imageInfo.format = createInfo.format;
+			imageInfo.tiling = createInfo.tiling;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageInfo.usage = createInfo.usage;
+			imageInfo.samples = createInfo.samples;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			if (createInfo.force3D && createInfo.depth == 1)
+			{
+				imageInfo.flags |= VK_IMAGE_CREATE_2D_VIEW_COMPATIBLE_BIT_EXT;
+			}
+			if (createInfo.cubeCompatible)
+			{
+				imageInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+			}
+			return imageInfo;
+		}
+
+		GpuMemoryCategory ResolveCategory(GpuMemoryCategory category)
+		{
+			return category != GpuMemoryCategory::Untagged ? category : GpuMemoryScope::GetCurrent();
+		}
+
+		uint64_t TrackerId(const void* allocation)
+		{
+			return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(allocation));
+		}
+	}
+
 	VulkanMemoryManager::VulkanMemoryManager(VulkanDevice* device)
 		: m_Device(device)
 	{
@@ -42,8 +87,18 @@ namespace Nightbloom
 		allocatorInfo.instance = m_Device->GetInstance();
 		allocatorInfo.pVulkanFunctions = &vulkanFunctions;
 
-		// Enable memory budget tracking
-		allocatorInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		// Driver-reported budgets when VK_EXT_memory_budget is on; without it
+		// VMA estimates them from the heap sizes
+		if (m_Device->SupportsFeature("memory_budget"))
+			allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		// Memory behind device-address buffers needs the matching allocate flag
+		if (m_Device->SupportsFeature("buffer_device_address"))
+			allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+		// Priorities on every VkDeviceMemory VMA allocates (1.0 render
+		// targets .. 0.0 streamed mips), which the driver evicts by
+		m_MemoryPriorityEnabled = m_Device->SupportsFeature("memory_priority");
+		if (m_MemoryPriorityEnabled)
+			allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
 
 		// Create the allocator
 		VkResult result = vmaCreateAllocator(&allocatorInfo, &m_Allocator);
@@ -53,8 +108,32 @@ namespace Nightbloom
 			return false;
 		}
 
-		m_StagingPool = std::make_unique<StagingBufferPool>(m_Device, this);
-		LOG_INFO("Created staging buffer pool");
+		// Resizable BAR exposes all of VRAM as device-local host-visible; the
+		// legacy window is 256 MB, too small to spend on anything but what
+		// VMA already puts there. A UMA device's memory is all of it.
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+		const VkMemoryPropertyFlags directWriteFlags =
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		VkDeviceSize directWriteHeap = 0;
+		for (uint32_t i = 0; i < memoryProperties->memoryTypeCount; ++i)
+		{
+			const VkMemoryType& type = memoryProperties->memoryTypes[i];
+			if ((type.propertyFlags & directWriteFlags) == directWriteFlags)
+				directWriteHeap = std::max(directWriteHeap, memoryProperties->memoryHeaps[type.heapIndex].size);
+		}
+		m_DirectWriteAvailable = directWriteHeap > 256ull * 1024 * 1024;
+		if (m_DirectWriteAvailable)
+			LOG_INFO("Direct device-local writes: {} MB host-visible VRAM", directWriteHeap / (1024 * 1024));
+		else
+			LOG_INFO("Direct device-local writes unavailable: device-local buffers are staged");
+
+		m_StagingRing = std::make_unique<VulkanStagingRing>(m_Device, this);
+		if (!m_StagingRing->Initialize())
+		{
+			LOG_WARN("Uploads will stage through dedicated buffers");
+			m_StagingRing.reset();
+		}
 
 		LOG_INFO("VMA initialized successfully");
 		LogMemoryStats();
@@ -72,6 +151,14 @@ namespace Nightbloom
 		// Log final memory stats before cleanup
 		LogMemoryStats();
 
+		CancelDefragmentation();
+
+		// Whatever is still tracked was never destroyed by its owner
+		for (const std::string& line : m_Tracker.BuildLeakReport())
+		{
+			LOG_WARN("GPU leak: {}", line);
+		}
+
 		// Destroy all tracked allocations
 		if (!m_BufferAllocations.empty())
 		{
@@ -85,6 +172,20 @@ namespace Nightbloom
 			m_ImageAllocations.clear();
 		}
 
+		if (!m_AliasedGroups.empty())
+		{
+			LOG_WARN("Destroying {} remaining aliased image groups", m_AliasedGroups.size());
+			while (!m_AliasedGroups.empty())
+			{
+				DestroyAliasedImages(m_AliasedGroups.back().get());
+			}
+		}
+
+		for (auto& [memoryType, pool] : m_LowPriorityPools)
+		{
+			vmaDestroyPool(m_Allocator, pool);
+		}
+		m_LowPriorityPools.clear();
 
 		// Destroy the allocator
 		vmaDestroyAllocator(m_Allocator);
@@ -93,13 +194,12 @@ namespace Nightbloom
 		LOG_INFO("VMA shutdown complete");
 	}
 
-	void VulkanMemoryManager::DestroyStagingPool()
+	void VulkanMemoryManager::DestroyStagingRing()
 	{
-		//Destroy StagingPool
-		if (m_StagingPool)
+		if (m_StagingRing)
 		{
-			m_StagingPool->Cleanup();
-			m_StagingPool.reset();
+			m_StagingRing->Cleanup();
+			m_StagingRing.reset();
 		}
 	}
 
@@ -114,18 +214,62 @@ namespace Nightbloom
 		bufferInfo.usage = createInfo.usage;
 		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+		// A moved buffer's contents are copied to its replacement. A buffer
+		// with a device address never moves: shaders may hold its address.
+		const bool deviceAddress = createInfo.deviceAddress && m_Device->SupportsFeature("buffer_device_address");
+		const bool directWrite = createInfo.directWrite && m_DirectWriteAvailable && !createInfo.hostRead;
+		const bool movable = createInfo.movable && !deviceAddress && !directWrite;
+		if (movable)
+		{
+			bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		}
+		if (deviceAddress)
+		{
+			bufferInfo.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+		}
+		allocation->size = bufferInfo.size;
+		allocation->usage = bufferInfo.usage;
+
 		// Setup allocation info
 		VmaAllocationCreateInfo allocInfo = {};
 		allocInfo.usage = createInfo.memoryUsage;
 		allocInfo.flags = createInfo.flags;
+		// Defragmentation only moves allocations that point back at their buffer
+		if (movable && !createInfo.mappable)
+		{
+			allocInfo.pUserData = allocation.get();
+		}
 
 		// Add host access flag if mappable
 		if (createInfo.mappable)
 		{
-			allocInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+			allocInfo.flags |= createInfo.hostRead
+				? VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+				: VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
 			allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;  // Keep persistently mapped
 		}
 
+		// Device-local first. Unmappable buffers may still land in memory
+		// the CPU can't see (the heap is full): VMA then leaves them unmapped
+		// and the caller stages as before.
+		if (directWrite)
+		{
+			allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+			allocInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+			if (!createInfo.mappable)
+				allocInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT;
+		}
+
+		// Small buffers share VMA's blocks, where a priority can't apply;
+		// large per-frame ones get memory of their own to keep resident
+		if (m_MemoryPriorityEnabled)
+		{
+			const GpuMemoryPriority priority = ResolveGpuMemoryPriority(createInfo.priority, ResolveCategory(createInfo.category));
+			allocInfo.priority = GetGpuMemoryPriorityValue(priority);
+			if (priority == GpuMemoryPriority::High && !movable && createInfo.size >= PRIORITY_DEDICATED_BYTES)
+				allocInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+		}
+
 		// Create buffer
 		VkResult result = vmaCreateBuffer(
 			m_Allocator,
@@ -147,10 +291,29 @@ namespace Nightbloom
 		{
 			allocation->mappedData = allocation->allocationInfo.pMappedData;
 		}
+		else if (directWrite)
+		{
+			VkMemoryPropertyFlags properties = 0;
+			vmaGetAllocationMemoryProperties(m_Allocator, allocation->allocation, &properties);
+			if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+				allocation->mappedData = allocation->allocationInfo.pMappedData;
+		}
+
+		if (deviceAddress)
+		{
+			VkBufferDeviceAddressInfo addressInfo = {};
+			addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+			addressInfo.buffer = allocation->buffer;
+			allocation->deviceAddress = vkGetBufferDeviceAddress(m_Device->GetDevice(), &addressInfo);
+		}
 
 		// Track the allocation
 		BufferAllocation* rawPtr = allocation.get();
 		m_BufferAllocations.push_back(std::move(allocation));
+		m_Tracker.OnAllocate(TrackerId(rawPtr), GpuAllocationKind::Buffer, ResolveCategory(createInfo.category),
+			rawPtr->allocationInfo.size, createInfo.debugName);
+		NameAllocation(VK_OBJECT_TYPE_BUFFER, reinterpret_cast<uint64_t>(rawPtr->buffer), rawPtr->allocation,
+			createInfo.debugName);
 
 		LOG_TRACE("Created buffer: size={} bytes, usage=0x{:X}", createInfo.size, createInfo.usage);
 
@@ -172,40 +335,210 @@ namespace Nightbloom
 		{
 			// VMA will handle unmapping if needed
 			vmaDestroyBuffer(m_Allocator, (*it)->buffer, (*it)->allocation);
+			m_Tracker.OnFree(TrackerId(allocation));
 			m_BufferAllocations.erase(it);
 			LOG_TRACE("Destroyed buffer allocation");
 		}
 	}
 
+	bool VulkanMemoryManager::BeginDefragmentation(VkDeviceSize maxBytesPerPass, uint32_t maxAllocationsPerPass)
+	{
+		if (m_DefragContext != VK_NULL_HANDLE)
+			return true;
+
+		VmaDefragmentationInfo defragInfo = {};
+		defragInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+		defragInfo.maxBytesPerPass = maxBytesPerPass;
+		defragInfo.maxAllocationsPerPass = maxAllocationsPerPass;
+
+		VkResult result = vmaBeginDefragmentation(m_Allocator, &defragInfo, &m_DefragContext);
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to begin GPU memory defragmentation: {}", static_cast<int>(result));
+			m_DefragContext = VK_NULL_HANDLE;
+			return false;
+		}
+
+		m_DefragStats = {};
+		LOG_INFO("GPU memory defragmentation started");
+		return true;
+	}
+
+	bool VulkanMemoryManager::RecordDefragmentationPass(VkCommandBuffer commandBuffer)
+	{
+		if (m_DefragContext == VK_NULL_HANDLE || m_DefragPassOpen)
+			return false;
+
+		m_DefragPass = {};
+		m_DefragMoves.clear();
+
+		// VK_SUCCESS: nothing left to move
+		VkResult result = vmaBeginDefragmentationPass(m_Allocator, m_DefragContext, &m_DefragPass);
+		if (result != VK_INCOMPLETE)
+		{
+			if (result != VK_SUCCESS)
+				LOG_ERROR("GPU memory defragmentation pass failed: {}", static_cast<int>(result));
+			return false;
+		}
+		m_DefragPassOpen = true;
+		m_DefragStats.passes++;
+
+		VkDevice device = m_Device->GetDevice();
+		for (uint32_t i = 0; i < m_DefragPass.moveCount; ++i)
+		{
+			VmaDefragmentationMove& move = m_DefragPass.pMoves[i];
+
+			VmaAllocationInfo srcInfo = {};
+			vmaGetAllocationInfo(m_Allocator, move.srcAllocation, &srcInfo);
+			BufferAllocation* buffer = static_cast<BufferAllocation*>(srcInfo.pUserData);
+			if (!buffer)
+			{
+				// Images and buffers referenced from descriptor sets stay put
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+				continue;
+			}
+
+			VkBufferCreateInfo bufferInfo = {};
+			bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferInfo.size = buffer->size;
+			bufferInfo.usage = buffer->usage;
+			bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VkBuffer newBuffer = VK_NULL_HANDLE;
+			if (vkCreateBuffer(device, &bufferInfo, nullptr, &newBuffer) != VK_SUCCESS ||
+				vmaBindBufferMemory(m_Allocator, move.dstTmpAllocation, newBuffer) != VK_SUCCESS)
+			{
+				if (newBuffer != VK_NULL_HANDLE)
+					vkDestroyBuffer(device, newBuffer, nullptr);
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+				continue;
+			}
+
+			m_DefragMoves.push_back({ buffer, newBuffer });
+		}
+
+		if (m_DefragMoves.empty())
+			return false;
+
+		// Whatever last wrote the buffers is done before they are read, and
+		// the copies are done before the new buffers are drawn from
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		for (const DefragMove& move : m_DefragMoves)
+		{
+			VkBufferCopy region = {};
+			region.size = move.buffer->size;
+			vkCmdCopyBuffer(commandBuffer, move.buffer->buffer, move.newBuffer, 1, &region);
+		}
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		return true;
+	}
+
+	bool VulkanMemoryManager::EndDefragmentationPass()
+	{
+		if (m_DefragContext == VK_NULL_HANDLE)
+			return true;
+
+		if (!m_DefragPassOpen)
+		{
+			// The last RecordDefragmentationPass found nothing left to move
+			FinishDefragmentation();
+			return true;
+		}
+
+		// The copies have completed: the old buffers go, the new ones take
+		// their place (VulkanBuffer::GetBuffer reads it at the next bind)
+		VkDevice device = m_Device->GetDevice();
+		for (const DefragMove& move : m_DefragMoves)
+		{
+			vkDestroyBuffer(device, move.buffer->buffer, nullptr);
+			move.buffer->buffer = move.newBuffer;
+		}
+
+		VkResult result = vmaEndDefragmentationPass(m_Allocator, m_DefragContext, &m_DefragPass);
+		m_DefragPassOpen = false;
+
+		// The allocations now point at their new memory
+		for (const DefragMove& move : m_DefragMoves)
+		{
+			vmaGetAllocationInfo(m_Allocator, move.buffer->allocation, &move.buffer->allocationInfo);
+		}
+		m_DefragMoves.clear();
+
+		if (result == VK_SUCCESS)
+		{
+			FinishDefragmentation();
+			return true;
+		}
+		return false;
+	}
+
+	void VulkanMemoryManager::CancelDefragmentation()
+	{
+		if (m_DefragContext == VK_NULL_HANDLE)
+			return;
+
+		// A pass recorded but never submitted: its new buffers are dropped and
+		// every move of it is undone
+		if (m_DefragPassOpen)
+		{
+			for (uint32_t i = 0; i < m_DefragPass.moveCount; ++i)
+			{
+				m_DefragPass.pMoves[i].operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+			}
+			for (const DefragMove& move : m_DefragMoves)
+			{
+				vkDestroyBuffer(m_Device->GetDevice(), move.newBuffer, nullptr);
+			}
+			vmaEndDefragmentationPass(m_Allocator, m_DefragContext, &m_DefragPass);
+			m_DefragMoves.clear();
+			m_DefragPassOpen = false;
+		}
+
+		FinishDefragmentation();
+	}
+
+	void VulkanMemoryManager::FinishDefragmentation()
+	{
+		VmaDefragmentationStats stats = {};
+		vmaEndDefragmentation(m_Allocator, m_DefragContext, &stats);
+		m_DefragContext = VK_NULL_HANDLE;
+
+		m_DefragStats.bytesMoved = stats.bytesMoved;
+		m_DefragStats.bytesFreed = stats.bytesFreed;
+		m_DefragStats.allocationsMoved = stats.allocationsMoved;
+		m_DefragStats.deviceMemoryBlocksFreed = stats.deviceMemoryBlocksFreed;
+
+		LOG_INFO("GPU memory defragmentation finished: {} allocations ({} KB) moved, {} KB and {} memory blocks freed in {} passes",
+			m_DefragStats.allocationsMoved, m_DefragStats.bytesMoved / 1024,
+			m_DefragStats.bytesFreed / 1024, m_DefragStats.deviceMemoryBlocksFreed, m_DefragStats.passes);
+	}
+
 	VulkanMemoryManager::ImageAllocation* VulkanMemoryManager::CreateImage(const ImageCreateInfo& createInfo)
 	{
 		auto allocation = std::make_unique<ImageAllocation>();
 
 		// Setup image creation info
-		VkImageCreateInfo imageInfo = {};
-		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-		imageInfo.imageType = (createInfo.depth > 1 || createInfo.force3D)
-			? VK_IMAGE_TYPE_3D
-			: VK_IMAGE_TYPE_2D;
-		imageInfo.extent.width = createInfo.width;
-		imageInfo.extent.height = createInfo.height;
-		imageInfo.extent.depth = createInfo.depth;
-		imageInfo.mipLevels = createInfo.mipLevels;
-		imageInfo.arrayLayers = createInfo.arrayLayers;
-		imageInfo.format = createInfo.format;
-		imageInfo.tiling = createInfo.tiling;
-		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		imageInfo.usage = createInfo.usage;
-		imageInfo.samples = createInfo.samples;
-		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-		if (createInfo.force3D && createInfo.depth == 1)
-		{
-			imageInfo.flags |= VK_IMAGE_CREATE_2D_VIEW_COMPATIBLE_BIT_EXT;
-		}
+		VkImageCreateInfo imageInfo = ToVkImageCreateInfo(createInfo);
 
 		// Setup allocation info
 		VmaAllocationCreateInfo allocInfo = {};
 		allocInfo.usage = createInfo.memoryUsage;
+		if (m_MemoryPriorityEnabled)
+		{
+			ApplyImagePriority(allocInfo, imageInfo,
+				ResolveGpuMemoryPriority(createInfo.priority, ResolveCategory(createInfo.category)));
+		}
 
 		// Create image
 		VkResult result = vmaCreateImage(
@@ -217,6 +550,23 @@ namespace Nightbloom
 			&allocation->allocationInfo
 		);
 
+		// A low-priority pool that can't grow: wherever VMA would have put it
+		if (result != VK_SUCCESS && allocInfo.pool != VK_NULL_HANDLE)
+		{
+			allocInfo.pool = VK_NULL_HANDLE;
+			result = vmaCreateImage(m_Allocator, &imageInfo, &allocInfo,
+				&allocation->image, &allocation->allocation, &allocation->allocationInfo);
+		}
+
+		// No lazily allocated memory type: an ordinary device-local image
+		if (result != VK_SUCCESS && createInfo.memoryUsage == VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED)
+		{
+			allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+			allocInfo.pool = VK_NULL_HANDLE;
+			result = vmaCreateImage(m_Allocator, &imageInfo, &allocInfo,
+				&allocation->image, &allocation->allocation, &allocation->allocationInfo);
+		}
+
 		if (result != VK_SUCCESS)
 		{
 			LOG_ERROR("Failed to create image through VMA: {}", static_cast<int>(result));
@@ -226,6 +576,10 @@ namespace Nightbloom
 		// Track the allocation
 		ImageAllocation* rawPtr = allocation.get();
 		m_ImageAllocations.push_back(std::move(allocation));
+		m_Tracker.OnAllocate(TrackerId(rawPtr), GpuAllocationKind::Image, ResolveCategory(createInfo.category),
+			rawPtr->allocationInfo.size, createInfo.debugName);
+		NameAllocation(VK_OBJECT_TYPE_IMAGE, reinterpret_cast<uint64_t>(rawPtr->image), rawPtr->allocation,
+			createInfo.debugName);
 
 		LOG_TRACE("Created image: {}x{}x{}, format={}, mips={}",
 			createInfo.width, createInfo.height, createInfo.depth,
@@ -234,6 +588,45 @@ namespace Nightbloom
 		return rawPtr;
 	}
 
+	void VulkanMemoryManager::ApplyImagePriority(VmaAllocationCreateInfo& allocInfo, const VkImageCreateInfo& imageInfo,
+		GpuMemoryPriority priority)
+	{
+		allocInfo.priority = GetGpuMemoryPriorityValue(priority);
+		if (priority == GpuMemoryPriority::High)
+		{
+			allocInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+			return;
+		}
+		if (priority != GpuMemoryPriority::Low)
+			return;
+
+		// One pool per memory type, made the first time a Low image needs it
+		uint32_t memoryType = 0;
+		if (vmaFindMemoryTypeIndexForImageInfo(m_Allocator, &imageInfo, &allocInfo, &memoryType) != VK_SUCCESS)
+			return;
+
+		auto it = m_LowPriorityPools.find(memoryType);
+		if (it == m_LowPriorityPools.end())
+		{
+			VmaPoolCreateInfo poolInfo = {};
+			poolInfo.memoryTypeIndex = memoryType;
+			poolInfo.priority = GetGpuMemoryPriorityValue(GpuMemoryPriority::Low);
+
+			VmaPool pool = VK_NULL_HANDLE;
+			if (vmaCreatePool(m_Allocator, &poolInfo, &pool) != VK_SUCCESS)
+			{
+				LOG_WARN("Failed to create the low-priority pool for memory type {}", memoryType);
+				pool = VK_NULL_HANDLE;
+			}
+			else
+			{
+				vmaSetPoolName(m_Allocator, pool, "LowPriority");
+			}
+			it = m_LowPriorityPools.emplace(memoryType, pool).first;
+		}
+		allocInfo.pool = it->second;
+	}
+
 	void VulkanMemoryManager::DestroyImage(ImageAllocation* allocation)
 	{
 		if (!allocation)
@@ -247,12 +640,397 @@ namespace Nightbloom
 
 		if (it != m_ImageAllocations.end())
 		{
-			vmaDestroyImage(m_Allocator, (*it)->image, (*it)->allocation);
+			if (SparseImage* sparse = (*it)->sparse.get())
+			{
+				// Deferred like any image: no bind or frame still uses the pages
+				vkDestroyImage(m_Device->GetDevice(), (*it)->image, nullptr);
+				for (VmaAllocation& page : sparse->memory)
+				{
+					if (page != VK_NULL_HANDLE)
+						sparse->released.push_back({ page, 0 });
+				}
+				ReclaimSparsePages(*sparse, UINT64_MAX);
+				if (sparse->mipTail != VK_NULL_HANDLE)
+					vmaFreeMemory(m_Allocator, sparse->mipTail);
+			}
+			else
+			{
+				vmaDestroyImage(m_Allocator, (*it)->image, (*it)->allocation);
+			}
+			m_Tracker.OnFree(TrackerId(allocation));
 			m_ImageAllocations.erase(it);
 			LOG_TRACE("Destroyed image allocation");
 		}
 	}
 
+	bool VulkanMemoryManager::IsSparseResidencyAvailable(bool volume) const
+	{
+		return m_Device->SupportsFeature(volume ? "sparse_residency_3d" : "sparse_residency_2d");
+	}
+
+	VulkanMemoryManager::ImageAllocation* VulkanMemoryManager::CreateSparseImage(const ImageCreateInfo& createInfo)
+	{
+		VkImageCreateInfo imageInfo = ToVkImageCreateInfo(createInfo);
+		const bool volume = imageInfo.imageType == VK_IMAGE_TYPE_3D;
+		if (!IsSparseResidencyAvailable(volume) || createInfo.arrayLayers != 1 || createInfo.cubeCompatible
+			|| createInfo.memoryUsage == VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED)
+		{
+			return nullptr;
+		}
+
+		// The format has to have a standard page shape for this use
+		uint32_t formatCount = 0;
+		vkGetPhysicalDeviceSparseImageFormatProperties(m_Device->GetPhysicalDevice(), imageInfo.format,
+			imageInfo.imageType, imageInfo.samples, imageInfo.usage, imageInfo.tiling, &formatCount, nullptr);
+		if (formatCount == 0)
+			return nullptr;
+
+		imageInfo.flags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+		VkDevice device = m_Device->GetDevice();
+		auto allocation = std::make_unique<ImageAllocation>();
+		if (vkCreateImage(device, &imageInfo, nullptr, &allocation->image) != VK_SUCCESS)
+		{
+			LOG_WARN("Failed to create sparse image '{}'", createInfo.debugName ? createInfo.debugName : "");
+			return nullptr;
+		}
+
+		uint32_t requirementCount = 0;
+		vkGetImageSparseMemoryRequirements(device, allocation->image, &requirementCount, nullptr);
+		std::vector<VkSparseImageMemoryRequirements> requirements(requirementCount);
+		vkGetImageSparseMemoryRequirements(device, allocation->image, &requirementCount, requirements.data());
+
+		// One color (or depth) aspect, no metadata, and mip 0 outside the
+		// mip tail with nothing sparse between them
+		const VkSparseImageMemoryRequirements* color = requirements.size() == 1 ? &requirements[0] : nullptr;
+		if (!color || (color->formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT)
+			|| color->imageMipTailFirstLod == 0 || (createInfo.mipLevels > 1 && color->imageMipTailFirstLod > 1))
+		{
+			vkDestroyImage(device, allocation->image, nullptr);
+			return nullptr;
+		}
+
+		auto sparse = std::make_unique<SparseImage>();
+		sparse->aspect = color->formatProperties.aspectMask;
+		vkGetImageMemoryRequirements(device, allocation->image, &sparse->pageRequirements);
+		sparse->pageRequirements.size = sparse->pageRequirements.alignment;
+		const VkExtent3D granularity = color->formatProperties.imageGranularity;
+		sparse->pages.Reset(createInfo.width, createInfo.height, createInfo.depth,
+			granularity.width, granularity.height, granularity.depth);
+		sparse->memory.assign(sparse->pages.GetPageCount(), VK_NULL_HANDLE);
+		sparse->category = ResolveCategory(createInfo.category);
+		sparse->debugName = createInfo.debugName ? createInfo.debugName : "";
+
+		VmaAllocationCreateInfo memoryInfo = {};
+		memoryInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+		// The mip tail is small and always resident
+		if (createInfo.mipLevels > color->imageMipTailFirstLod)
+		{
+			VkMemoryRequirements tailRequirements = sparse->pageRequirements;
+			tailRequirements.size = color->imageMipTailSize;
+			VmaAllocationInfo tailInfo = {};
+			if (vmaAllocateMemory(m_Allocator, &tailRequirements, &memoryInfo, &sparse->mipTail, &tailInfo) != VK_SUCCESS)
+			{
+				LOG_WARN("Failed to allocate the mip tail of sparse image '{}'", sparse->debugName);
+				vkDestroyImage(device, allocation->image, nullptr);
+				return nullptr;
+			}
+			sparse->mipTailSize = color->imageMipTailSize;
+
+			VkSparseMemoryBind tailBind = {};
+			tailBind.resourceOffset = color->imageMipTailOffset;
+			tailBind.size = color->imageMipTailSize;
+			tailBind.memory = tailInfo.deviceMemory;
+			tailBind.memoryOffset = tailInfo.offset;
+
+			VkSparseImageOpaqueMemoryBindInfo opaqueBind = {};
+			opaqueBind.image = allocation->image;
+			opaqueBind.bindCount = 1;
+			opaqueBind.pBinds = &tailBind;
+
+			VkBindSparseInfo bindInfo = {};
+			bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+			bindInfo.imageOpaqueBindCount = 1;
+			bindInfo.pImageOpaqueBinds = &opaqueBind;
+			if (m_Device->GetGraphicsTimeline()->BindSparse(bindInfo) == 0)
+			{
+				vmaFreeMemory(m_Allocator, sparse->mipTail);
+				vkDestroyImage(device, allocation->image, nullptr);
+				return nullptr;
+			}
+		}
+
+		allocation->sparse = std::move(sparse);
+		ImageAllocation* rawPtr = allocation.get();
+		m_ImageAllocations.push_back(std::move(allocation));
+		m_Tracker.OnAllocate(TrackerId(rawPtr), GpuAllocationKind::Image, rawPtr->sparse->category,
+			rawPtr->sparse->mipTailSize, createInfo.debugName);
+		NameAllocation(VK_OBJECT_TYPE_IMAGE, reinterpret_cast<uint64_t>(rawPtr->image), rawPtr->sparse->mipTail,
+			createInfo.debugName);
+
+		LOG_INFO("Sparse image '{}': {}x{}x{} in {} pages of {}x{}x{} ({} KB each)",
+			rawPtr->sparse->debugName, createInfo.width, createInfo.height, createInfo.depth,
+			rawPtr->sparse->pages.GetPageCount(), granularity.width, granularity.height, granularity.depth,
+			rawPtr->sparse->pageRequirements.size / 1024);
+		return rawPtr;
+	}
+
+	bool VulkanMemoryManager::CommitSparseResidency(ImageAllocation* allocation, VulkanQueueTimeline* timeline)
+	{
+		SparseImage* sparse = allocation ? allocation->sparse.get() : nullptr;
+		if (!sparse || !timeline)
+			return false;
+
+		ReclaimSparsePages(*sparse, timeline->GetCompletedValue());
+
+		sparse->pages.Commit(m_SparseBind, m_SparseRelease);
+		if (m_SparseBind.empty() && m_SparseRelease.empty())
+			return true;
+
+		std::vector<VkSparseImageMemoryBind> binds;
+		binds.reserve(m_SparseBind.size() + m_SparseRelease.size());
+		auto addBind = [&](uint32_t page, VkDeviceMemory memory, VkDeviceSize memoryOffset)
+		{
+			const SparsePageTable::Box box = sparse->pages.GetPageBox(page);
+			VkSparseImageMemoryBind bind = {};
+			bind.subresource.aspectMask = sparse->aspect;
+			bind.offset = { static_cast<int32_t>(box.x), static_cast<int32_t>(box.y), static_cast<int32_t>(box.z) };
+			bind.extent = { box.width, box.height, box.depth };
+			bind.memory = memory;
+			bind.memoryOffset = memoryOffset;
+			binds.push_back(bind);
+		};
+
+		// Out of memory leaves the rest unbound; the next commit tries again
+		VmaAllocationCreateInfo memoryInfo = {};
+		memoryInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		std::vector<uint32_t> bound;
+		for (uint32_t page : m_SparseBind)
+		{
+			VmaAllocationInfo info = {};
+			if (vmaAllocateMemory(m_Allocator, &sparse->pageRequirements, &memoryInfo, &sparse->memory[page], &info) != VK_SUCCESS)
+			{
+				sparse->pages.MarkUnbound(page);
+				continue;
+			}
+			addBind(page, info.deviceMemory, info.offset);
+			bound.push_back(page);
+		}
+		if (bound.size() < m_SparseBind.size())
+		{
+			LOG_WARN("Sparse image '{}': no memory for {} of {} pages", sparse->debugName,
+				m_SparseBind.size() - bound.size(), m_SparseBind.size());
+		}
+
+		for (uint32_t page : m_SparseRelease)
+			addBind(page, VK_NULL_HANDLE, 0);
+
+		if (binds.empty())
+			return false;
+
+		VkSparseImageMemoryBindInfo imageBind = {};
+		imageBind.image = allocation->image;
+		imageBind.bindCount = static_cast<uint32_t>(binds.size());
+		imageBind.pBinds = binds.data();
+
+		VkBindSparseInfo bindInfo = {};
+		bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+		bindInfo.imageBindCount = 1;
+		bindInfo.pImageBinds = &imageBind;
+
+		const uint64_t value = timeline->BindSparse(bindInfo);
+		if (value == 0)
+		{
+			// Nothing changed on the GPU: the new pages go, the old ones stay bound
+			for (uint32_t page : bound)
+			{
+				vmaFreeMemory(m_Allocator, sparse->memory[page]);
+				sparse->memory[page] = VK_NULL_HANDLE;
+				sparse->pages.MarkUnbound(page);
+			}
+			return false;
+		}
+
+		for (uint32_t page : m_SparseRelease)
+		{
+			sparse->released.push_back({ sparse->memory[page], value });
+			sparse->memory[page] = VK_NULL_HANDLE;
+		}
+
+		m_Tracker.OnAllocate(TrackerId(allocation), GpuAllocationKind::Image, sparse->category,
+			GetSparseResidentBytes(*sparse), sparse->debugName.c_str());
+		return true;
+	}
+
+	void VulkanMemoryManager::ReclaimSparsePages(SparseImage& sparse, uint64_t completedValue)
+	{
+		auto done = std::remove_if(sparse.released.begin(), sparse.released.end(),
+			[this, completedValue](const SparseImage::Released& released)
+			{
+				if (released.bindValue > completedValue)
+					return false;
+				vmaFreeMemory(m_Allocator, released.memory);
+				return true;
+			});
+		sparse.released.erase(done, sparse.released.end());
+	}
+
+	uint64_t VulkanMemoryManager::GetSparseResidentBytes(const SparseImage& sparse) const
+	{
+		return sparse.mipTailSize + static_cast<uint64_t>(sparse.pages.GetResidentCount()) * sparse.pageRequirements.size;
+	}
+
+	VulkanMemoryManager::AliasedImageGroup* VulkanMemoryManager::CreateAliasedImages(
+		const std::vector<std::vector<ImageCreateInfo>>& phases)
+	{
+		VkDevice device = m_Device->GetDevice();
+		auto group = std::make_unique<AliasedImageGroup>();
+		std::vector<VkDeviceSize> offsets;
+
+		VkMemoryRequirements combined = {};
+		combined.alignment = 1;
+		combined.memoryTypeBits = ~0u;
+
+		auto destroyImages = [&]()
+		{
+			for (VkImage image : group->images)
+			{
+				vkDestroyImage(device, image, nullptr);
+			}
+		};
+
+		for (const std::vector<ImageCreateInfo>& phase : phases)
+		{
+			VkDeviceSize offset = 0;
+			for (const ImageCreateInfo& createInfo : phase)
+			{
+				VkImageCreateInfo imageInfo = ToVkImageCreateInfo(createInfo);
+				VkImage image = VK_NULL_HANDLE;
+				if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+				{
+					LOG_ERROR("Failed to create aliased image {}x{}", createInfo.width, createInfo.height);
+					destroyImages();
+					return nullptr;
+				}
+				group->images.push_back(image);
+
+				VkMemoryRequirements requirements;
+				vkGetImageMemoryRequirements(device, image, &requirements);
+
+				offset = (offset + requirements.alignment - 1) / requirements.alignment * requirements.alignment;
+				offsets.push_back(offset);
+				offset += requirements.size;
+
+				combined.alignment = std::max(combined.alignment, requirements.alignment);
+				combined.memoryTypeBits &= requirements.memoryTypeBits;
+				group->savedBytes += requirements.size;
+			}
+			combined.size = std::max(combined.size, offset);
+		}
+
+		if (group->images.empty() || combined.memoryTypeBits == 0)
+		{
+			LOG_ERROR("Aliased images have no memory type in common");
+			destroyImages();
+			return nullptr;
+		}
+
+		const ImageCreateInfo* first = nullptr;
+		for (const std::vector<ImageCreateInfo>& phase : phases)
+		{
+			if (!first && !phase.empty())
+				first = &phase.front();
+		}
+
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		if (m_MemoryPriorityEnabled)
+		{
+			// Render targets: their own memory, kept resident
+			const GpuMemoryPriority priority = ResolveGpuMemoryPriority(first->priority, ResolveCategory(first->category));
+			allocInfo.priority = GetGpuMemoryPriorityValue(priority);
+			if (priority == GpuMemoryPriority::High)
+				allocInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+		}
+		VkResult result = vmaAllocateMemory(m_Allocator, &combined, &allocInfo, &group->allocation, nullptr);
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to allocate aliased image memory: {}", static_cast<int>(result));
+			destroyImages();
+			return nullptr;
+		}
+
+		for (size_t i = 0; i < group->images.size(); ++i)
+		{
+			result = vmaBindImageMemory2(m_Allocator, group->allocation, offsets[i], group->images[i], nullptr);
+			if (result != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to bind aliased image {}: {}", i, static_cast<int>(result));
+				destroyImages();
+				vmaFreeMemory(m_Allocator, group->allocation);
+				return nullptr;
+			}
+		}
+
+		group->size = combined.size;
+		group->savedBytes -= combined.size;
+		LOG_INFO("Aliased {} images into {} KB ({} KB saved)",
+			group->images.size(), combined.size / 1024, group->savedBytes / 1024);
+
+		AliasedImageGroup* rawPtr = group.get();
+		m_AliasedGroups.push_back(std::move(group));
+
+		m_Tracker.OnAllocate(TrackerId(rawPtr), GpuAllocationKind::AliasedImages,
+			ResolveCategory(first->category), combined.size, first->debugName);
+
+		// Each image by its own name; the shared memory by the first
+		size_t imageIndex = 0;
+		for (const std::vector<ImageCreateInfo>& phase : phases)
+		{
+			for (const ImageCreateInfo& createInfo : phase)
+			{
+				const VmaAllocation memory = imageIndex == 0 ? rawPtr->allocation : VK_NULL_HANDLE;
+				NameAllocation(VK_OBJECT_TYPE_IMAGE, reinterpret_cast<uint64_t>(rawPtr->images[imageIndex++]),
+					memory, createInfo.debugName);
+			}
+		}
+		return rawPtr;
+	}
+
+	void VulkanMemoryManager::NameAllocation(VkObjectType type, uint64_t handle, VmaAllocation allocation,
+		const char* debugName)
+	{
+		if (!debugName || !*debugName)
+			return;
+
+		// VMA's name shows in its JSON dump; the object's in capture tools
+		if (allocation != VK_NULL_HANDLE)
+			vmaSetAllocationName(m_Allocator, allocation, debugName);
+		VulkanDebugMarkers::SetName(m_Device->GetDevice(), type, handle, debugName);
+	}
+
+	void VulkanMemoryManager::DestroyAliasedImages(AliasedImageGroup* group)
+	{
+		if (!group)
+			return;
+
+		auto it = std::find_if(m_AliasedGroups.begin(), m_AliasedGroups.end(),
+			[group](const std::unique_ptr<AliasedImageGroup>& ptr) {
+				return ptr.get() == group;
+			});
+
+		if (it != m_AliasedGroups.end())
+		{
+			for (VkImage image : (*it)->images)
+			{
+				vkDestroyImage(m_Device->GetDevice(), image, nullptr);
+			}
+			vmaFreeMemory(m_Allocator, (*it)->allocation);
+			m_Tracker.OnFree(TrackerId(group));
+			m_AliasedGroups.erase(it);
+		}
+	}
+
 	void* VulkanMemoryManager::MapMemory(VmaAllocation allocation)
 	{
 		void* mappedData = nullptr;
@@ -277,6 +1055,11 @@ namespace Nightbloom
 		vmaFlushAllocation(m_Allocator, allocation, offset, size);
 	}
 
+	void VulkanMemoryManager::InvalidateMemory(VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size)
+	{
+		vmaInvalidateAllocation(m_Allocator, allocation, offset, size);
+	}
+
 	VulkanMemoryManager::MemoryStats VulkanMemoryManager::GetMemoryStats() const
 	{
 		MemoryStats stats = {};
@@ -289,12 +1072,13 @@ namespace Nightbloom
 		stats.totalUsedBytes = vmaStats.total.statistics.allocationBytes;
 		stats.allocationCount = vmaStats.total.statistics.allocationCount;
 
-		// Get budget info
-		VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+		// Get budget info (only the device's heaps are filled in)
+		VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
 		vmaGetHeapBudgets(m_Allocator, budgets);
 
-		// Sum up device local memory (usually heap 0)
-		for (uint32_t i = 0; i < VK_MAX_MEMORY_HEAPS; ++i)
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+		for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i)
 		{
 			stats.totalDeviceMemory += budgets[i].budget;
 			stats.usedDeviceMemory += budgets[i].usage;
@@ -303,6 +1087,52 @@ namespace Nightbloom
 		return stats;
 	}
 
+	VulkanMemoryManager::HeapBudget VulkanMemoryManager::GetDeviceBudget() const
+	{
+		HeapBudget result = {};
+		if (!m_Allocator)
+			return result;
+
+		VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+		vmaGetHeapBudgets(m_Allocator, budgets);
+
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+		for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i)
+		{
+			if (!(memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+				continue;
+			result.budget += budgets[i].budget;
+			result.usage += budgets[i].usage;
+		}
+		return result;
+	}
+
+	std::vector<VulkanMemoryManager::HeapInfo> VulkanMemoryManager::GetHeapInfos() const
+	{
+		std::vector<HeapInfo> heaps;
+		if (!m_Allocator)
+			return heaps;
+
+		VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+		vmaGetHeapBudgets(m_Allocator, budgets);
+
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+		heaps.reserve(memoryProperties->memoryHeapCount);
+		for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i)
+		{
+			HeapInfo& heap = heaps.emplace_back();
+			heap.size = memoryProperties->memoryHeaps[i].size;
+			heap.budget = budgets[i].budget;
+			heap.usage = budgets[i].usage;
+			heap.blockBytes = budgets[i].statistics.blockBytes;
+			heap.allocationBytes = budgets[i].statistics.allocationBytes;
+			heap.deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+		}
+		return heaps;
+	}
+
 	void VulkanMemoryManager::LogMemoryStats() const
 	{
 		auto stats = GetMemoryStats();
@@ -317,5 +1147,31 @@ namespace Nightbloom
 			stats.totalDeviceMemory / (1024.0 * 1024.0));
 		LOG_INFO("  Tracked Buffers: {}", m_BufferAllocations.size());
 		LOG_INFO("  Tracked Images: {}", m_ImageAllocations.size());
+
+		for (uint32_t c = 0; c < static_cast<uint32_t>(GpuMemoryCategory::Count); ++c)
+		{
+			const GpuMemoryCategory category = static_cast<GpuMemoryCategory>(c);
+			const GpuMemoryTracker::CategoryStats categoryStats = m_Tracker.GetCategoryStats(category);
+			if (categoryStats.liveCount == 0)
+				continue;
+			LOG_INFO("  {}: {:.2f} MB in {} allocations (peak {:.2f} MB)",
+				GetGpuMemoryCategoryName(category),
+				categoryStats.liveBytes / (1024.0 * 1024.0), categoryStats.liveCount,
+				categoryStats.peakBytes / (1024.0 * 1024.0));
+		}
+	}
+
+	void VulkanMemoryManager::LogLiveAllocations(size_t maxListed) const
+	{
+		const std::vector<std::string> lines = m_Tracker.BuildLeakReport(maxListed);
+		if (lines.empty())
+		{
+			LOG_INFO("No live GPU allocations");
+			return;
+		}
+		for (const std::string& line : lines)
+		{
+			LOG_INFO("{}", line);
+		}
 	}
 }
\ No newline at end of file
@@ -8,7 +8,9 @@
 #pragma once
 
 #include "Engine/Renderer/Vulkan/VulkanCommon.hpp"
-#include "Engine/Renderer/Vulkan/VulkanStagingBufferPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanStagingRing.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Renderer/SparsePageTable.hpp"
 
 // VMA Configuration
 
@@ -17,10 +19,15 @@
 
 #include "ThirdParty/VMA/vk_mem_alloc.h"
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace Nightbloom
 {
 	class VulkanDevice;
+	class VulkanUploadManager;
+	class VulkanQueueTimeline;
 
 	// Forward declarations for out allocation types
 	struct BufferAllocation;
@@ -36,7 +43,7 @@ namespace Nightbloom
 		// Initialize VMA
 		bool Initialize();
 		void Shutdown();
-		void DestroyStagingPool();
+		void DestroyStagingRing();
 
 		// Buffer Allocation
 		struct BufferCreateInfo
@@ -46,6 +53,36 @@ namespace Nightbloom
 			VmaMemoryUsage memoryUsage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO;
 			VmaAllocationCreateFlags flags = 0;
 			bool mappable = false; // if true, adds host_access flag
+			// Mapped for the CPU to read what the GPU wrote (readback): cached
+			// host memory instead of write-combined, which reads slowly
+			bool hostRead = false;
+
+			// Untagged: the allocating thread's GpuMemoryScope
+			GpuMemoryCategory category = GpuMemoryCategory::Untagged;
+			const char* debugName = nullptr;
+			// Residency under VRAM pressure; Default follows the category.
+			// Only High buffers of PRIORITY_DEDICATED_BYTES or more that
+			// aren't movable get memory of their own for it to apply to.
+			GpuMemoryPriority priority = GpuMemoryPriority::Default;
+
+			// Defragmentation may move it to a new VkBuffer. Only for buffers
+			// that are never mapped and whose handle is read back through
+			// BufferAllocation::buffer each time it is recorded (vertex and
+			// index buffers) - never one written into a descriptor set.
+			bool movable = false;
+
+			// Also give it a GPU pointer (BufferAllocation::deviceAddress), as
+			// acceleration structure builds read their inputs through. Ignored
+			// without SupportsFeature("buffer_device_address"); never movable.
+			bool deviceAddress = false;
+
+			// Frequently rewritten from the CPU: place it in device-local
+			// memory the CPU can write straight into (resizable BAR, or a
+			// UMA device) when IsDirectWriteAvailable. Mappable buffers then
+			// come from that memory rather than system memory; unmappable ones
+			// are mapped too when it could be had (mappedData set) and left
+			// device-local for the caller to stage into otherwise. Never movable.
+			bool directWrite = false;
 		};
 
 		struct BufferAllocation
@@ -54,6 +91,12 @@ namespace Nightbloom
 			VmaAllocation allocation = VK_NULL_HANDLE;
 			VmaAllocationInfo allocationInfo = {};
 			void* mappedData = nullptr;  // Only valid if persistently mapped
+
+			// What the buffer was created with, to recreate it when it moves
+			VkDeviceSize size = 0;
+			VkBufferUsageFlags usage = 0;
+
+			VkDeviceAddress deviceAddress = 0;  // 0 unless created with one
 		};
 
 		BufferAllocation* CreateBuffer(const BufferCreateInfo& createInfo);
@@ -75,22 +118,120 @@ namespace Nightbloom
 			VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
 
 			bool force3D = false;
+			// Six layers per cube, sampled through a cube view
+			bool cubeCompatible = false;
+
+			// Untagged: the allocating thread's GpuMemoryScope
+			GpuMemoryCategory category = GpuMemoryCategory::Untagged;
+			const char* debugName = nullptr;
+			// Residency under VRAM pressure; Default follows the category.
+			// High images get memory of their own, Low ones share a
+			// low-priority pool.
+			GpuMemoryPriority priority = GpuMemoryPriority::Default;
+		};
+
+		// A partially resident image's pages and the memory behind them.
+		// Only mip 0 is paged; smaller mips sit in the mip tail, bound whole
+		// when the image is created.
+		struct SparseImage
+		{
+			SparsePageTable pages;
+			VkImageAspectFlags aspect = 0;
+			VkMemoryRequirements pageRequirements = {};   // one page
+			std::vector<VmaAllocation> memory;            // per page, null while unbound
+			VmaAllocation mipTail = VK_NULL_HANDLE;
+			VkDeviceSize mipTailSize = 0;
+
+			// Unbound pages' memory and the bind that unbound it; freed once
+			// that bind has completed
+			struct Released
+			{
+				VmaAllocation memory = VK_NULL_HANDLE;
+				uint64_t bindValue = 0;
+			};
+			std::vector<Released> released;
+
+			GpuMemoryCategory category = GpuMemoryCategory::Untagged;
+			std::string debugName;
 		};
 
 		struct ImageAllocation
 		{
 			VkImage image = VK_NULL_HANDLE;
-			VmaAllocation allocation = VK_NULL_HANDLE;
+			VmaAllocation allocation = VK_NULL_HANDLE;   // null for a sparse image
 			VmaAllocationInfo allocationInfo = {};
+			std::unique_ptr<SparseImage> sparse;         // set for a sparse image
 		};
 
+		// memoryUsage VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED (transient
+		// attachments that never leave tile memory) falls back to device
+		// memory where the device has no lazily allocated type (desktop)
 		ImageAllocation* CreateImage(const ImageCreateInfo& createInfo);
 		void DestroyImage(ImageAllocation* allocation);
 
+		// A partially resident image with no page bound yet (a one-layer
+		// 2D, or 3D, image with one mip or only the mip tail after it).
+		// Request pages through allocation->sparse->pages, then commit.
+		// Null where the device or format can't, for the caller to fall
+		// back on CreateImage. Destroyed through DestroyImage.
+		bool IsSparseResidencyAvailable(bool volume) const;
+		ImageAllocation* CreateSparseImage(const ImageCreateInfo& createInfo);
+		// Binds the pages requested since the last commit and unbinds the
+		// rest, on `timeline`'s queue (the graphics queue); later submits
+		// there wait for it. Pages that could not get memory stay unbound.
+		bool CommitSparseResidency(ImageAllocation* allocation, VulkanQueueTimeline* timeline);
+
+		// Render targets whose lifetimes within a frame never overlap can share
+		// memory. Each phase's images are bound back to back in ONE allocation,
+		// every phase starting at offset 0, so images of different phases
+		// alias. Contents don't survive another phase's use: the images must
+		// start from UNDEFINED every frame, and the passes using them must be
+		// ordered against the other phase's (as for any WAW/WAR hazard). The
+		// group is tracked under the first image's category and name.
+		struct AliasedImageGroup
+		{
+			std::vector<VkImage> images;   // phases flattened, in the order given
+			VmaAllocation allocation = VK_NULL_HANDLE;
+			VkDeviceSize size = 0;
+			VkDeviceSize savedBytes = 0;   // versus one allocation per image
+		};
+
+		AliasedImageGroup* CreateAliasedImages(const std::vector<std::vector<ImageCreateInfo>>& phases);
+		void DestroyAliasedImages(AliasedImageGroup* group);
+
+		// Incremental defragmentation (VMA's vmaBeginDefragmentation). Only
+		// movable buffers are moved; every other allocation stays put. Call
+		// RecordDefragmentationPass once per step with a command buffer, submit
+		// it and wait for it with nothing else in flight, then call
+		// EndDefragmentationPass, which switches the moved buffers over. Repeat
+		// (one step a frame) until EndDefragmentationPass reports it is done.
+		struct DefragmentationStats
+		{
+			uint64_t bytesMoved = 0;
+			uint64_t bytesFreed = 0;
+			uint32_t allocationsMoved = 0;
+			uint32_t deviceMemoryBlocksFreed = 0;
+			uint32_t passes = 0;
+		};
+
+		// 0 for no per-pass limit
+		bool BeginDefragmentation(VkDeviceSize maxBytesPerPass, uint32_t maxAllocationsPerPass);
+		bool IsDefragmenting() const { return m_DefragContext != VK_NULL_HANDLE; }
+		// Records this pass's copies; false when there was nothing to copy
+		bool RecordDefragmentationPass(VkCommandBuffer commandBuffer);
+		// After the pass's copies completed; true when defragmentation finished
+		bool EndDefragmentationPass();
+		// Stops after the last completed pass (moves already made stay)
+		void CancelDefragmentation();
+		// The last finished or cancelled run
+		const DefragmentationStats& GetDefragmentationStats() const { return m_DefragStats; }
+
 		// Memory operations
 		void* MapMemory(VmaAllocation allocation);
 		void UnmapMemory(VmaAllocation allocation);
 		void FlushMemory(VmaAllocation allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+		// Makes GPU writes visible to host reads (a no-op on coherent memory)
+		void InvalidateMemory(VmaAllocation allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
 
 		// Statistics and debugging
 		struct MemoryStats
@@ -103,12 +244,59 @@ namespace Nightbloom
 		};
 
 		MemoryStats GetMemoryStats() const;
+
+		// Device-local heaps only: what this process may use (the driver's
+		// figure with VK_EXT_memory_budget, else VMA's estimate) and uses now,
+		// other processes' allocations excluded
+		struct HeapBudget
+		{
+			uint64_t budget;
+			uint64_t usage;
+		};
+		HeapBudget GetDeviceBudget() const;
+
+		// Every memory heap, from vmaGetHeapBudgets
+		struct HeapInfo
+		{
+			uint64_t size;              // the heap's capacity
+			uint64_t budget;
+			uint64_t usage;             // this process's, all allocators
+			uint64_t blockBytes;        // VMA's memory blocks in this heap
+			uint64_t allocationBytes;   // VMA's allocations inside them
+			bool deviceLocal;
+		};
+		std::vector<HeapInfo> GetHeapInfos() const;
+
+		// Device-local host-visible memory beyond the legacy 256 MB BAR
+		// window, found at Initialize: what BufferCreateInfo::directWrite
+		// allocates from
+		bool IsDirectWriteAvailable() const { return m_DirectWriteAvailable; }
+
+		// VK_EXT_memory_priority is on: create infos' priorities reach the
+		// driver. VMA applies a priority only to a dedicated allocation or a
+		// pool's blocks, so High allocations get dedicated memory and Low
+		// images a pool per memory type; the rest share VMA's blocks at the
+		// default priority.
+		bool IsMemoryPriorityEnabled() const { return m_MemoryPriorityEnabled; }
+		static constexpr VkDeviceSize PRIORITY_DEDICATED_BYTES = 1024 * 1024;
+
+		// Per-category accounting of everything created here
+		const GpuMemoryTracker& GetTracker() const { return m_Tracker; }
+
 		void LogMemoryStats() const;
+		// What's still allocated, by category and largest first
+		void LogLiveAllocations(size_t maxListed = 32) const;
 
 		// Get the allocator for advanced usage
 		VmaAllocator GetAllocator() const { return m_Allocator; }
 
-		StagingBufferPool* GetStagingPool() { return m_StagingPool.get(); }
+		// Shared upload staging (null if it couldn't be created)
+		VulkanStagingRing* GetStagingRing() { return m_StagingRing.get(); }
+
+		// Owned by ResourceManager; VulkanBuffer/VulkanTexture::UploadData go
+		// through it when set.
+		void SetUploadManager(VulkanUploadManager* uploads) { m_UploadManager = uploads; }
+		VulkanUploadManager* GetUploadManager() const { return m_UploadManager; }
 
 	private:
 		VulkanDevice* m_Device = nullptr;
@@ -117,6 +305,36 @@ namespace Nightbloom
 		// Track allocations for cleanup and debugging
 		std::vector<std::unique_ptr<BufferAllocation>> m_BufferAllocations;
 		std::vector<std::unique_ptr<ImageAllocation>> m_ImageAllocations;
-		std::unique_ptr<StagingBufferPool> m_StagingPool;
+		std::vector<std::unique_ptr<AliasedImageGroup>> m_AliasedGroups;
+		std::unique_ptr<VulkanStagingRing> m_StagingRing;
+		GpuMemoryTracker m_Tracker;
+		VulkanUploadManager* m_UploadManager = nullptr;  // not owned
+		bool m_DirectWriteAvailable = false;
+		bool m_MemoryPriorityEnabled = false;
+		std::unordered_map<uint32_t, VmaPool> m_LowPriorityPools;   // by memory type index
+		std::vector<uint32_t> m_SparseBind, m_SparseRelease;        // CommitSparseResidency scratch
+
+		void FinishDefragmentation();
+		// Frees released sparse pages whose unbinding has completed
+		void ReclaimSparsePages(SparseImage& sparse, uint64_t completedValue);
+		uint64_t GetSparseResidentBytes(const SparseImage& sparse) const;
+		// Sets allocInfo's priority, and its dedicated flag or pool, for an image
+		void ApplyImagePriority(VmaAllocationCreateInfo& allocInfo, const VkImageCreateInfo& imageInfo,
+			GpuMemoryPriority priority);
+		// Gives the object and its VMA allocation (if any) the debug name
+		void NameAllocation(VkObjectType type, uint64_t handle, VmaAllocation allocation, const char* debugName);
+
+		// A buffer being moved in the open pass, and the buffer replacing it
+		struct DefragMove
+		{
+			BufferAllocation* buffer;
+			VkBuffer newBuffer;
+		};
+
+		VmaDefragmentationContext m_DefragContext = VK_NULL_HANDLE;
+		VmaDefragmentationPassMoveInfo m_DefragPass = {};
+		bool m_DefragPassOpen = false;
+		std::vector<DefragMove> m_DefragMoves;
+		DefragmentationStats m_DefragStats;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+// VulkanMeshArena.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanMeshArena.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
+#include "Engine/Renderer/Vertex.hpp"
+#include "Engine/Renderer/Meshlet.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <string>
+
+namespace Nightbloom
+{
+	MeshArenaAllocation& MeshArenaAllocation::operator=(MeshArenaAllocation&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Release();
+			m_Arena = std::exchange(other.m_Arena, nullptr);
+			m_Format = other.m_Format;
+			m_Vertices = std::exchange(other.m_Vertices, {});
+			m_IndexLists = std::move(other.m_IndexLists);
+			other.m_IndexLists.clear();
+			m_Meshlets = std::exchange(other.m_Meshlets, {});
+			m_Skin = std::exchange(other.m_Skin, {});
+		}
+		return *this;
+	}
+
+	void MeshArenaAllocation::Release()
+	{
+		if (m_Arena)
+			m_Arena->Free(*this);
+		m_Arena = nullptr;
+		m_Vertices = {};
+		m_IndexLists.clear();
+		m_Meshlets = {};
+		m_Skin = {};
+	}
+
+	VulkanMeshArena::VulkanMeshArena(VulkanDevice* device, VulkanMemoryManager* memoryManager)
+		: m_Device(device), m_MemoryManager(memoryManager)
+	{
+		m_VertexPools[static_cast<size_t>(VertexFormat::Standard)] =
+			{ "MeshArena_Vertices", BufferUsage::Vertex, sizeof(VertexPNT), DEFAULT_VERTEX_PAGE_SIZE, {} };
+		m_VertexPools[static_cast<size_t>(VertexFormat::Packed)] =
+			{ "MeshArena_PackedVertices", BufferUsage::Vertex, sizeof(PackedVertex), DEFAULT_VERTEX_PAGE_SIZE, {} };
+		m_IndexPool = { "MeshArena_Indices", BufferUsage::Index, sizeof(uint32_t), DEFAULT_INDEX_PAGE_SIZE, {} };
+		m_MeshletPool = { "MeshArena_Meshlets", BufferUsage::Storage, sizeof(Meshlet), DEFAULT_MESHLET_PAGE_SIZE, {} };
+		m_SkinPool = { "MeshArena_Skins", BufferUsage::Storage, sizeof(SkinnedVertex), DEFAULT_SKIN_PAGE_SIZE, {} };
+	}
+
+	VulkanMeshArena::~VulkanMeshArena()
+	{
+		Cleanup();
+	}
+
+	void VulkanMeshArena::Cleanup()
+	{
+		auto clear = [](Pool& pool)
+		{
+			for (const Page& page : pool.pages)
+			{
+				if (page.buffer && !page.ranges.IsEmpty())
+					LOG_WARN("Destroying {} page with {} elements still allocated", pool.name, page.ranges.GetUsed());
+			}
+			pool.pages.clear();
+		};
+
+		for (Pool& pool : m_VertexPools)
+			clear(pool);
+		clear(m_IndexPool);
+		clear(m_MeshletPool);
+		clear(m_SkinPool);
+	}
+
+	MeshArenaAllocation VulkanMeshArena::Allocate(VertexFormat format, const void* vertices, uint32_t vertexCount,
+		const uint32_t* indices, uint32_t indexCount, VulkanCommandPool* cmdPool)
+	{
+		MeshArenaAllocation allocation;
+		if (!vertices || vertexCount == 0 || !indices || indexCount == 0)
+			return allocation;
+
+		allocation.m_Arena = this;
+		allocation.m_Format = format;
+		allocation.m_Vertices = AllocateRange(GetVertexPool(format), vertices, vertexCount, cmdPool);
+		if (!allocation.m_Vertices.IsValid() || !AppendIndices(allocation, indices, indexCount, cmdPool))
+		{
+			// Nothing can be drawing from it yet
+			FreeRange(GetVertexPool(format), allocation.m_Vertices);
+			allocation.m_Arena = nullptr;
+			allocation.m_Vertices = {};
+		}
+		return allocation;
+	}
+
+	bool VulkanMeshArena::AppendIndices(MeshArenaAllocation& allocation, const uint32_t* indices, uint32_t indexCount,
+		VulkanCommandPool* cmdPool)
+	{
+		if (allocation.m_Arena != this || !indices || indexCount == 0)
+			return false;
+
+		const MeshBufferRange range = AllocateRange(m_IndexPool, indices, indexCount, cmdPool);
+		if (!range.IsValid())
+			return false;
+
+		allocation.m_IndexLists.push_back(range);
+		return true;
+	}
+
+	bool VulkanMeshArena::SetMeshlets(MeshArenaAllocation& allocation, const Meshlet* meshlets, uint32_t count,
+		VulkanCommandPool* cmdPool)
+	{
+		if (allocation.m_Arena != this || allocation.m_Meshlets.IsValid() || !meshlets || count == 0)
+			return false;
+
+		allocation.m_Meshlets = AllocateRange(m_MeshletPool, meshlets, count, cmdPool);
+		return allocation.m_Meshlets.IsValid();
+	}
+
+	Buffer* VulkanMeshArena::GetMeshletBuffer() const
+	{
+		return m_MeshletPool.pages.empty() ? nullptr : m_MeshletPool.pages[0].buffer.get();
+	}
+
+	bool VulkanMeshArena::SetSkin(MeshArenaAllocation& allocation, const SkinnedVertex* vertices, uint32_t count,
+		VulkanCommandPool* cmdPool)
+	{
+		if (allocation.m_Arena != this || allocation.m_Skin.IsValid() || !vertices || count == 0)
+			return false;
+
+		allocation.m_Skin = AllocateRange(m_SkinPool, vertices, count, cmdPool);
+		return allocation.m_Skin.IsValid();
+	}
+
+	Buffer* VulkanMeshArena::GetSkinBuffer() const
+	{
+		return m_SkinPool.pages.empty() ? nullptr : m_SkinPool.pages[0].buffer.get();
+	}
+
+	MeshBufferRange VulkanMeshArena::AllocateRange(Pool& pool, const void* data, uint32_t count, VulkanCommandPool* cmdPool)
+	{
+		MeshBufferRange range;
+
+		// First page with room; a new one only when none has
+		uint32_t page = static_cast<uint32_t>(pool.pages.size());
+		uint32_t first = MeshArenaAllocator::INVALID_OFFSET;
+		for (uint32_t i = 0; i < pool.pages.size() && first == MeshArenaAllocator::INVALID_OFFSET; ++i)
+		{
+			if (pool.pages[i].buffer)
+			{
+				first = pool.pages[i].ranges.Allocate(count);
+				page = i;
+			}
+		}
+		if (first == MeshArenaAllocator::INVALID_OFFSET)
+		{
+			if (!AddPage(pool, std::max(pool.pageSize, count), page))
+				return range;
+			first = pool.pages[page].ranges.Allocate(count);
+		}
+
+		VulkanBuffer* buffer = pool.pages[page].buffer.get();
+		const size_t stride = pool.stride;
+		if (!buffer->UploadData(data, count * stride, first * stride, cmdPool))
+		{
+			LOG_ERROR("Failed to upload {} elements to {} page {}", count, pool.name, page);
+			pool.pages[page].ranges.Free(first, count);
+			return range;
+		}
+
+		range.buffer = buffer;
+		range.page = page;
+		range.first = first;
+		range.count = count;
+		return range;
+	}
+
+	bool VulkanMeshArena::AddPage(Pool& pool, uint32_t capacity, uint32_t& outPage)
+	{
+		// Shared by every model, so charged to models as a whole
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Model);
+
+		// Reuse the slot of a released oversized page, so ranges keep their indices
+		uint32_t page = static_cast<uint32_t>(pool.pages.size());
+		for (uint32_t i = 0; i < pool.pages.size(); ++i)
+		{
+			if (!pool.pages[i].buffer)
+			{
+				page = i;
+				break;
+			}
+		}
+
+		BufferDesc desc;
+		desc.usage = pool.usage;
+		desc.memoryAccess = MemoryAccess::GpuOnly;
+		desc.size = static_cast<size_t>(capacity) * pool.stride;
+		desc.debugName = std::string(pool.name) + "_" + std::to_string(page);
+		// Acceleration structure builds read the pages by address
+		// (RayTracedShadows), which also keeps them in place on defragmentation
+		desc.deviceAddress = m_Device->SupportsFeature("ray_query");
+
+		auto buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
+		if (!buffer->Initialize(desc))
+		{
+			LOG_ERROR("Failed to create {:.1f} MB {} page", desc.size / (1024.0 * 1024.0), pool.name);
+			return false;
+		}
+
+		if (page == pool.pages.size())
+			pool.pages.emplace_back();
+		pool.pages[page].buffer = std::move(buffer);
+		pool.pages[page].ranges.Reset(capacity);
+
+		LOG_INFO("Created {:.1f} MB {} page {}", desc.size / (1024.0 * 1024.0), pool.name, page);
+		outPage = page;
+		return true;
+	}
+
+	void VulkanMeshArena::FreeRange(Pool& pool, const MeshBufferRange& range)
+	{
+		if (!range.IsValid() || range.page >= pool.pages.size())
+			return;
+
+		Page& page = pool.pages[range.page];
+		page.ranges.Free(range.first, range.count);
+
+		// A page sized for one big mesh goes with it; regular pages stay for
+		// the next load
+		if (page.ranges.IsEmpty() && page.ranges.GetCapacity() > pool.pageSize)
+		{
+			page.buffer.reset();
+			page.ranges.Reset(0);
+		}
+	}
+
+	void VulkanMeshArena::Free(MeshArenaAllocation& allocation)
+	{
+		auto release = [this, format = allocation.m_Format, vertices = allocation.m_Vertices,
+			indexLists = std::move(allocation.m_IndexLists), meshlets = allocation.m_Meshlets,
+			skin = allocation.m_Skin]()
+		{
+			FreeRange(GetVertexPool(format), vertices);
+			for (const MeshBufferRange& indices : indexLists)
+				FreeRange(m_IndexPool, indices);
+			FreeRange(m_MeshletPool, meshlets);
+			FreeRange(m_SkinPool, skin);
+		};
+
+		VulkanDeletionQueue* deletionQueue = m_Device ? m_Device->GetDeletionQueue() : nullptr;
+		if (deletionQueue)
+			deletionQueue->Defer(std::move(release));
+		else
+			release();
+	}
+
+	uint32_t VulkanMeshArena::GetPageCount() const
+	{
+		uint32_t count = 0;
+		ForEachPool([&count](const Pool& pool)
+		{
+			for (const Page& page : pool.pages)
+				count += page.buffer ? 1 : 0;
+		});
+		return count;
+	}
+
+	VkDeviceSize VulkanMeshArena::GetReservedBytes() const
+	{
+		VkDeviceSize bytes = 0;
+		ForEachPool([&bytes](const Pool& pool)
+		{
+			for (const Page& page : pool.pages)
+				bytes += static_cast<VkDeviceSize>(page.ranges.GetCapacity()) * pool.stride;
+		});
+		return bytes;
+	}
+
+	VkDeviceSize VulkanMeshArena::GetUsedBytes() const
+	{
+		VkDeviceSize bytes = 0;
+		ForEachPool([&bytes](const Pool& pool)
+		{
+			for (const Page& page : pool.pages)
+				bytes += static_cast<VkDeviceSize>(page.ranges.GetUsed()) * pool.stride;
+		});
+		return bytes;
+	}
+}
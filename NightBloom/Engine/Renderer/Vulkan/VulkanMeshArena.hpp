@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+// VulkanMeshArena.hpp
+//
+// Shared vertex and index buffers that model meshes sub-allocate from,
+// instead of two small VMA allocations (plus one per LOD) per mesh. There is
+// one vertex pool per VertexFormat, since a vertex buffer binding has one
+// stride, and one index pool (uint32). Each pool is a list of pages - a
+// device-local VulkanBuffer with a MeshArenaAllocator free list - and a new
+// page is only added when no existing one has room, so in practice every
+// mesh of a format shares one vertex and one index buffer. Draws then keep
+// those bound (CommandRecorder skips redundant binds) and select the mesh
+// with vertexOffset/firstIndex, which is also what an indirect draw needs.
+//
+// A third pool holds the meshes' meshlets (Meshlet.hpp) for MeshletCuller,
+// as a storage buffer. The cull pass binds page 0 only; meshlets that end
+// up on another page (page 0 full) are simply not culled per meshlet.
+// Skinned meshes likewise keep their skinning source (SkinnedVertex) in a
+// storage pool SkinningSystem reads page 0 of; off page 0 they draw in
+// their bind pose.
+//
+// Freed ranges go back on the deletion queue: frames in flight may still
+// draw from them. Main thread only, like the deletion queue and uploads.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Vulkan/MeshArenaAllocator.hpp"
+#include "Engine/Renderer/RenderDevice.hpp"
+#include "Engine/Renderer/VertexPacking.hpp"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanBuffer;
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanCommandPool;
+	class VulkanMeshArena;
+	struct Meshlet;
+	struct SkinnedVertex;
+
+	// A slice of one arena page. first/count are in elements: first is the
+	// draw's vertexOffset for vertices, its firstIndex for indices and the
+	// first meshlet in the page for meshlets.
+	struct MeshBufferRange
+	{
+		Buffer* buffer = nullptr;
+		uint32_t page = 0;
+		uint32_t first = 0;
+		uint32_t count = 0;
+
+		bool IsValid() const { return buffer != nullptr; }
+	};
+
+	// One mesh's vertices and index lists (the full mesh, then each LOD over
+	// the same vertices), plus the full mesh's meshlets and skinning source
+	// if it has them.
+	// Move-only; destroying it hands the ranges back.
+	class MeshArenaAllocation
+	{
+	public:
+		MeshArenaAllocation() = default;
+		~MeshArenaAllocation() { Release(); }
+
+		MeshArenaAllocation(MeshArenaAllocation&& other) noexcept { *this = std::move(other); }
+		MeshArenaAllocation& operator=(MeshArenaAllocation&& other) noexcept;
+
+		MeshArenaAllocation(const MeshArenaAllocation&) = delete;
+		MeshArenaAllocation& operator=(const MeshArenaAllocation&) = delete;
+
+		void Release();
+
+		bool IsValid() const { return m_Vertices.IsValid() && !m_IndexLists.empty(); }
+		VertexFormat GetVertexFormat() const { return m_Format; }
+		const MeshBufferRange& GetVertices() const { return m_Vertices; }
+		uint32_t GetIndexListCount() const { return static_cast<uint32_t>(m_IndexLists.size()); }
+		const MeshBufferRange& GetIndices(uint32_t list) const { return m_IndexLists[list]; }
+		const MeshBufferRange& GetMeshlets() const { return m_Meshlets; }
+		const MeshBufferRange& GetSkin() const { return m_Skin; }
+
+	private:
+		friend class VulkanMeshArena;
+
+		VulkanMeshArena* m_Arena = nullptr;
+		VertexFormat m_Format = VertexFormat::Standard;
+		MeshBufferRange m_Vertices;
+		std::vector<MeshBufferRange> m_IndexLists;
+		MeshBufferRange m_Meshlets;
+		MeshBufferRange m_Skin;
+	};
+
+	class VulkanMeshArena
+	{
+	public:
+		// Elements per page; a mesh bigger than that gets a page of its own
+		static constexpr uint32_t DEFAULT_VERTEX_PAGE_SIZE = 1u << 20;
+		static constexpr uint32_t DEFAULT_INDEX_PAGE_SIZE = 1u << 22;
+		static constexpr uint32_t DEFAULT_MESHLET_PAGE_SIZE = 1u << 16;
+		static constexpr uint32_t DEFAULT_SKIN_PAGE_SIZE = 1u << 18;
+
+		VulkanMeshArena(VulkanDevice* device, VulkanMemoryManager* memoryManager);
+		~VulkanMeshArena();
+
+		// Every allocation must have been released (and the deletion queue
+		// flushed) first
+		void Cleanup();
+
+		// Sub-allocates and uploads the vertices and the full index list.
+		// Invalid allocation on failure.
+		MeshArenaAllocation Allocate(VertexFormat format, const void* vertices, uint32_t vertexCount,
+			const uint32_t* indices, uint32_t indexCount, VulkanCommandPool* cmdPool);
+
+		// Adds another index list over the allocation's vertices (a LOD)
+		bool AppendIndices(MeshArenaAllocation& allocation, const uint32_t* indices, uint32_t indexCount,
+			VulkanCommandPool* cmdPool);
+
+		// Uploads the full mesh's meshlets (firstIndex relative to index list
+		// 0). One set per allocation.
+		bool SetMeshlets(MeshArenaAllocation& allocation, const Meshlet* meshlets, uint32_t count,
+			VulkanCommandPool* cmdPool);
+
+		// The meshlet page MeshletCuller reads (null until the first meshlets)
+		Buffer* GetMeshletBuffer() const;
+
+		// Uploads a skinned mesh's SkinnedVertex array, parallel to its
+		// vertices. One set per allocation.
+		bool SetSkin(MeshArenaAllocation& allocation, const SkinnedVertex* vertices, uint32_t count,
+			VulkanCommandPool* cmdPool);
+
+		// The skin page SkinningSystem reads (null until the first skinned mesh)
+		Buffer* GetSkinBuffer() const;
+
+		// fn(name, VulkanBuffer*) for every live page, named like its debug name:
+		// the pool's and the page number ("MeshArena_Indices_0")
+		template<typename Fn>
+		void ForEachPage(Fn&& fn) const
+		{
+			ForEachPool([&fn](const Pool& pool)
+			{
+				for (size_t i = 0; i < pool.pages.size(); ++i)
+				{
+					if (pool.pages[i].buffer)
+						fn(std::string(pool.name) + "_" + std::to_string(i), pool.pages[i].buffer.get());
+				}
+			});
+		}
+
+		uint32_t GetPageCount() const;
+		VkDeviceSize GetReservedBytes() const;
+		VkDeviceSize GetUsedBytes() const;
+
+	private:
+		friend class MeshArenaAllocation;
+
+		struct Page
+		{
+			std::unique_ptr<VulkanBuffer> buffer;   // null once an oversized page is released
+			MeshArenaAllocator ranges;
+		};
+
+		struct Pool
+		{
+			const char* name = "";
+			BufferUsage usage = BufferUsage::Vertex;
+			uint32_t stride = 0;
+			uint32_t pageSize = 0;
+			std::vector<Page> pages;
+		};
+
+		MeshBufferRange AllocateRange(Pool& pool, const void* data, uint32_t count, VulkanCommandPool* cmdPool);
+		bool AddPage(Pool& pool, uint32_t capacity, uint32_t& outPage);
+		void FreeRange(Pool& pool, const MeshBufferRange& range);
+
+		// Deferred until frames in flight are done with the ranges
+		void Free(MeshArenaAllocation& allocation);
+
+		Pool& GetVertexPool(VertexFormat format) { return m_VertexPools[static_cast<size_t>(format)]; }
+
+		template<typename Fn>
+		void ForEachPool(Fn&& fn) const
+		{
+			for (const Pool& pool : m_VertexPools)
+				fn(pool);
+			fn(m_IndexPool);
+			fn(m_MeshletPool);
+			fn(m_SkinPool);
+		}
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		Pool m_VertexPools[2];   // indexed by VertexFormat
+		Pool m_IndexPool;
+		Pool m_MeshletPool;
+		Pool m_SkinPool;
+
+		VulkanMeshArena(const VulkanMeshArena&) = delete;
+		VulkanMeshArena& operator=(const VulkanMeshArena&) = delete;
+	};
+}
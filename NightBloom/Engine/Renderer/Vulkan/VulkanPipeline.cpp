@@ -1,14 +1,44 @@
 #include "Engine/Renderer/Vulkan/VulkanPipeline.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Core/FileWatcher.hpp"
 #include "Engine/Renderer/Vertex.hpp"
+#include <array>
+#include <chrono>
 
 namespace Nightbloom
 {
-	bool VulkanPipelineManager::Initialize(VkDevice device, VkRenderPass defaultRenderPass, VkExtent2D extent) {
+	namespace
+	{
+		// The same constants go to every stage; a stage that doesn't declare
+		// one ignores its entry
+		void FillSpecializationInfo(const SpecializationData& data,
+			std::vector<VkSpecializationMapEntry>& entries, VkSpecializationInfo& info)
+		{
+			entries.clear();
+			for (const SpecializationData::Entry& entry : data.entries) {
+				VkSpecializationMapEntry mapEntry{};
+				mapEntry.constantID = entry.constantId;
+				mapEntry.offset = entry.offset;
+				mapEntry.size = entry.size;
+				entries.push_back(mapEntry);
+			}
+
+			info = {};
+			info.mapEntryCount = static_cast<uint32_t>(entries.size());
+			info.pMapEntries = entries.data();
+			info.dataSize = data.values.size() * sizeof(uint32_t);
+			info.pData = data.values.data();
+		}
+	}
+
+	bool VulkanPipelineManager::Initialize(VkDevice device, VkRenderPass defaultRenderPass, VkExtent2D extent,
+		VkPipelineCache pipelineCache) {
 		m_Device = device;
 		m_DefaultRenderPass = defaultRenderPass;
 		m_Extent = extent;
+		m_PipelineCache = pipelineCache;
 
 		// Set up pipeline names for debugging
 		m_PipelineNames[PipelineType::Triangle] = "Triangle";
@@ -20,6 +50,29 @@ namespace Nightbloom
 		m_PipelineNames[PipelineType::PostProcess] = "PostProcess";
 		m_PipelineNames[PipelineType::Compute] = "Compute";
 		m_PipelineNames[PipelineType::NodeGenerated] = "NodeGenerated";   // ADD THIS LINE
+		m_PipelineNames[PipelineType::MeshPacked] = "MeshPacked";
+		m_PipelineNames[PipelineType::TransparentPacked] = "TransparentPacked";
+		m_PipelineNames[PipelineType::ShadowPacked] = "ShadowPacked";
+		m_PipelineNames[PipelineType::ShadowLayeredPacked] = "ShadowLayeredPacked";
+		m_PipelineNames[PipelineType::MeshDepth] = "MeshDepth";
+		m_PipelineNames[PipelineType::MeshPackedDepth] = "MeshPackedDepth";
+		m_PipelineNames[PipelineType::TerrainDepth] = "TerrainDepth";
+		m_PipelineNames[PipelineType::FoliageDepth] = "FoliageDepth";
+		m_PipelineNames[PipelineType::MeshEqual] = "MeshEqual";
+		m_PipelineNames[PipelineType::MeshPackedEqual] = "MeshPackedEqual";
+		m_PipelineNames[PipelineType::TerrainEqual] = "TerrainEqual";
+		m_PipelineNames[PipelineType::FoliageEqual] = "FoliageEqual";
+		m_PipelineNames[PipelineType::SkyboxReflection] = "SkyboxReflection";
+		m_PipelineNames[PipelineType::MeshReflection] = "MeshReflection";
+		m_PipelineNames[PipelineType::MeshPackedReflection] = "MeshPackedReflection";
+		m_PipelineNames[PipelineType::TerrainReflection] = "TerrainReflection";
+		m_PipelineNames[PipelineType::FoliageReflection] = "FoliageReflection";
+		m_PipelineNames[PipelineType::CloudsReflection] = "CloudsReflection";
+		m_PipelineNames[PipelineType::TerrainTessellated] = "TerrainTessellated";
+		m_PipelineNames[PipelineType::TerrainTessellatedDepth] = "TerrainTessellatedDepth";
+		m_PipelineNames[PipelineType::TerrainTessellatedEqual] = "TerrainTessellatedEqual";
+		m_PipelineNames[PipelineType::LocalShadow] = "LocalShadow";
+		m_PipelineNames[PipelineType::LocalShadowPacked] = "LocalShadowPacked";
 
 
 		LOG_INFO("VulkanPipelineManager initialized");
@@ -33,35 +86,381 @@ namespace Nightbloom
 			return false;
 		}
 
-		// Destroy existing pipeline if it exists
+		// An async reload still compiling would otherwise land on top of this
+		if (m_PendingReloads[index].result.valid()) {
+			m_PendingReloads[index].superseded = true;
+		}
+
+		// Built as the variant that is active now
+		VulkanPipelineConfig variantConfig = config;
+		variantConfig.variantMask = GetShaderFeatureMask(type);
+		variantConfig.variant = m_VariantKey & variantConfig.variantMask;
+
+		if (m_ParallelCreation) {
+			QueuedCreate& queued = m_QueuedCreates.emplace_back();
+			queued.type = type;
+			JobSystem::Get().Run([this, &queued, variantConfig]() { queued.built = BuildPipeline(variantConfig); },
+				&m_QueuedCreatesDone);
+			return true;
+		}
+
+		Pipeline built = BuildPipeline(variantConfig);
+		if (!built.isValid) {
+			LOG_ERROR("Failed to create {} pipeline", m_PipelineNames[type].c_str());
+			return false;
+		}
+
+		// Frames in flight may still use the existing one
 		if (m_Pipelines[index].isValid) {
-			DestroyPipeline(m_Pipelines[index]);
+			RetirePipeline(m_Pipelines[index]);
+		}
+		RetireVariants(index);
+
+		m_Pipelines[index] = std::move(built);
+		VulkanDebugMarkers::SetName(m_Device, m_Pipelines[index].pipeline, m_PipelineNames[type].c_str());
+		LOG_INFO("Created {} pipeline", m_PipelineNames[type].c_str());
+		return true;
+	}
+
+	VulkanPipelineManager::ParallelCreationResult VulkanPipelineManager::FinishParallelCreation() {
+		ParallelCreationResult result;
+		if (!m_ParallelCreation) {
+			return result;
 		}
 
-		// Store config for hot reload
-		m_Pipelines[index].config = config;
+		// The waiting thread compiles queued pipelines too
+		JobSystem::Get().Wait(m_QueuedCreatesDone);
+		m_ParallelCreation = false;
+
+		for (QueuedCreate& queued : m_QueuedCreates) {
+			const size_t index = static_cast<size_t>(queued.type);
+			if (!queued.built.isValid) {
+				LOG_ERROR("Failed to create {} pipeline", m_PipelineNames[queued.type].c_str());
+				result.failed.push_back(queued.type);
+				continue;
+			}
+
+			// Created twice in one batch: the later call wins, as it would serially
+			if (m_Pipelines[index].isValid) {
+				RetirePipeline(m_Pipelines[index]);
+			}
+			RetireVariants(index);
+
+			m_Pipelines[index] = std::move(queued.built);
+			VulkanDebugMarkers::SetName(m_Device, m_Pipelines[index].pipeline, m_PipelineNames[queued.type].c_str());
+			++result.built;
+			LOG_INFO("Created {} pipeline", m_PipelineNames[queued.type].c_str());
+		}
+		m_QueuedCreates.clear();
+		return result;
+	}
+
+	VulkanPipelineManager::Pipeline VulkanPipelineManager::BuildPipeline(const VulkanPipelineConfig& config) const {
+		// Safe on a worker thread: only reads the device, the shared
+		// (internally synchronized) pipeline cache and shader files
+		Pipeline built;
+		built.config = config;
 
-		// Create appropriate pipeline type
 		bool success = false;
 		if (!config.computeShaderPath.empty()) {
-			success = CreateComputePipeline(config, m_Pipelines[index]);
+			success = CreateComputePipeline(config, built);
 		}
 		else {
-			success = CreateGraphicsPipeline(config, m_Pipelines[index]);
+			success = CreateGraphicsPipeline(config, built);
 		}
 
-		if (success) {
-			m_Pipelines[index].isValid = true;
-			LOG_INFO("Created {} pipeline", m_PipelineNames[type]);
+		if (!success) {
+			DestroyPipeline(built);
 		}
-		else {
-			LOG_ERROR("Failed to create {} pipeline", m_PipelineNames[type]);
+		built.isValid = success;
+		return built;
+	}
+
+	void VulkanPipelineManager::RetirePipeline(Pipeline& pipeline) {
+		RetiredPipeline retired;
+		retired.pipeline = pipeline.pipeline;
+		retired.layout = pipeline.layout;
+		retired.retiredFrame = m_FrameCounter;
+		m_RetiredPipelines.push_back(retired);
+
+		pipeline.pipeline = VK_NULL_HANDLE;
+		pipeline.layout = VK_NULL_HANDLE;
+		pipeline.isValid = false;
+	}
+
+	void VulkanPipelineManager::LaunchReload(size_t index) {
+		PendingReload& pending = m_PendingReloads[index];
+		pending.restart = false;
+		pending.superseded = false;
+		// Rebuilt as the variant active now; the others are dropped on swap
+		VulkanPipelineConfig config = m_Pipelines[index].config;
+		config.variant = GetWantedVariant(index);
+		pending.result = std::async(std::launch::async,
+			[this, config]() { return BuildPipeline(config); });
+	}
+
+	bool VulkanPipelineManager::ReloadPipelineAsync(PipelineType type) {
+		size_t index = static_cast<size_t>(type);
+		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
+			LOG_ERROR("Attempting to reload invalid pipeline: {}", m_PipelineNames[type].c_str());
+			return false;
 		}
 
+		// The build in progress may predate the latest shader save
+		if (m_PendingReloads[index].result.valid()) {
+			m_PendingReloads[index].restart = true;
+			return true;
+		}
+
+		LOG_INFO("Compiling {} pipeline in the background", m_PipelineNames[type].c_str());
+		LaunchReload(index);
+		return true;
+	}
+
+	bool VulkanPipelineManager::ReloadAllPipelinesAsync() {
+		bool success = true;
+		for (size_t i = 0; i < m_Pipelines.size(); ++i) {
+			if (m_Pipelines[i].isValid) {
+				success &= ReloadPipelineAsync(static_cast<PipelineType>(i));
+			}
+		}
 		return success;
 	}
 
-	bool VulkanPipelineManager::CreateGraphicsPipeline(const VulkanPipelineConfig& config, Pipeline& pipeline) {
+	uint32_t VulkanPipelineManager::ReloadPipelinesUsingShaderAsync(const std::string& shaderFile) {
+		const AssetManager& assetManager = AssetManager::Get();
+		const std::string changed = FileWatcher::NormalizePath(shaderFile);
+		auto uses = [&](const std::string& stage) {
+			return !stage.empty() && FileWatcher::NormalizePath(assetManager.GetShaderPath(stage)) == changed;
+		};
+
+		uint32_t reloads = 0;
+		for (size_t i = 0; i < m_Pipelines.size(); ++i) {
+			const VulkanPipelineConfig& config = m_Pipelines[i].config;
+			if (!m_Pipelines[i].isValid) {
+				continue;
+			}
+			if (uses(config.vertexShaderPath) || uses(config.fragmentShaderPath) || uses(config.geometryShaderPath) ||
+				uses(config.computeShaderPath) || uses(config.tessControlShaderPath) || uses(config.tessEvalShaderPath)) {
+				reloads += ReloadPipelineAsync(static_cast<PipelineType>(i)) ? 1 : 0;
+			}
+		}
+		return reloads;
+	}
+
+	bool VulkanPipelineManager::ProcessPendingReloads(uint32_t framesInFlight) {
+		++m_FrameCounter;
+		bool swapped = false;
+
+		for (size_t i = 0; i < m_PendingReloads.size(); ++i) {
+			PendingReload& pending = m_PendingReloads[i];
+			if (!pending.result.valid() ||
+				pending.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				continue;
+			}
+
+			PipelineType type = static_cast<PipelineType>(i);
+			Pipeline built = pending.result.get();
+
+			// Never bound, so these can go right away
+			if (pending.superseded || pending.restart || !built.isValid) {
+				DestroyPipeline(built);
+
+				if (pending.superseded) {
+					pending.superseded = false;
+					pending.restart = false;
+				}
+				else if (pending.restart) {
+					if (m_Pipelines[i].isValid) {
+						LaunchReload(i);
+					}
+				}
+				else {
+					LOG_ERROR("Failed to reload {} pipeline - keeping the current one", m_PipelineNames[type].c_str());
+				}
+				continue;
+			}
+
+			RetirePipeline(m_Pipelines[i]);
+			RetireVariants(i);
+			m_Pipelines[i] = std::move(built);
+			VulkanDebugMarkers::SetName(m_Device, m_Pipelines[i].pipeline, m_PipelineNames[type].c_str());
+			swapped = true;
+			LOG_INFO("Reloaded {} pipeline", m_PipelineNames[type].c_str());
+
+			// The key may have changed while it compiled
+			RequestVariant(i);
+		}
+
+		swapped |= ProcessPendingVariants();
+
+		// Every frame that could have bound a retired pipeline has had its
+		// fence waited on by now
+		for (size_t i = 0; i < m_RetiredPipelines.size();) {
+			RetiredPipeline& retired = m_RetiredPipelines[i];
+			if (m_FrameCounter < retired.retiredFrame + framesInFlight) {
+				++i;
+				continue;
+			}
+			if (retired.pipeline != VK_NULL_HANDLE) vkDestroyPipeline(m_Device, retired.pipeline, nullptr);
+			if (retired.layout != VK_NULL_HANDLE) vkDestroyPipelineLayout(m_Device, retired.layout, nullptr);
+			m_RetiredPipelines[i] = m_RetiredPipelines.back();
+			m_RetiredPipelines.pop_back();
+		}
+
+		return swapped;
+	}
+
+	bool VulkanPipelineManager::HasPendingReloads() const {
+		for (const PendingReload& pending : m_PendingReloads) {
+			if (pending.result.valid()) {
+				return true;
+			}
+		}
+		return !m_PendingVariants.empty();
+	}
+
+	bool VulkanPipelineManager::SetShaderVariant(ShaderVariantKey key) {
+		if (key == m_VariantKey) {
+			return false;
+		}
+
+		std::array<VkPipeline, static_cast<size_t>(PipelineType::Count)> before{};
+		for (size_t i = 0; i < m_Pipelines.size(); ++i) {
+			before[i] = GetPipeline(static_cast<PipelineType>(i));
+		}
+
+		LOG_INFO("Shader variant: {}", DescribeShaderVariant(key));
+		m_VariantKey = key;
+
+		bool changed = false;
+		for (size_t i = 0; i < m_Pipelines.size(); ++i) {
+			RequestVariant(i);
+			changed |= GetPipeline(static_cast<PipelineType>(i)) != before[i];
+		}
+		return changed;
+	}
+
+	uint32_t VulkanPipelineManager::GetCachedVariantCount() const {
+		size_t count = 0;
+		for (const auto& variants : m_Variants) {
+			count += variants.size();
+		}
+		return static_cast<uint32_t>(count);
+	}
+
+	bool VulkanPipelineManager::IsFeatureBound(ShaderVariantKey features) const {
+		for (size_t i = 0; i < m_Pipelines.size(); ++i) {
+			if (!m_Pipelines[i].isValid || (m_Pipelines[i].config.variantMask & features) != features) {
+				continue;
+			}
+			const Pipeline* bound = ResolvePipeline(static_cast<PipelineType>(i));
+			if (!bound || (bound->config.variant & features) != features) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	ShaderVariantKey VulkanPipelineManager::GetWantedVariant(size_t index) const {
+		return m_VariantKey & m_Pipelines[index].config.variantMask;
+	}
+
+	const VulkanPipelineManager::Pipeline* VulkanPipelineManager::ResolvePipeline(PipelineType type) const {
+		size_t index = static_cast<size_t>(type);
+		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
+			return nullptr;
+		}
+
+		const Pipeline& base = m_Pipelines[index];
+		const ShaderVariantKey wanted = GetWantedVariant(index);
+		if (wanted != base.config.variant) {
+			auto it = m_Variants[index].find(wanted);
+			if (it != m_Variants[index].end()) {
+				return &it->second;
+			}
+		}
+		// Also while the wanted variant is still compiling
+		return &base;
+	}
+
+	void VulkanPipelineManager::RequestVariant(size_t index) {
+		const Pipeline& base = m_Pipelines[index];
+		if (!base.isValid || base.config.variantMask == 0) {
+			return;
+		}
+
+		const ShaderVariantKey wanted = GetWantedVariant(index);
+		if (wanted == base.config.variant || m_Variants[index].count(wanted) != 0) {
+			return;
+		}
+
+		const uint64_t generation = m_VariantGenerations[index];
+		for (const PendingVariant& pending : m_PendingVariants) {
+			if (pending.index == index && pending.key == wanted && pending.generation == generation) {
+				return;
+			}
+		}
+
+		LOG_INFO("Compiling {} pipeline variant {} in the background",
+			m_PipelineNames[static_cast<PipelineType>(index)].c_str(), DescribeShaderVariant(wanted));
+
+		VulkanPipelineConfig config = base.config;
+		config.variant = wanted;
+
+		PendingVariant pending;
+		pending.index = index;
+		pending.key = wanted;
+		pending.generation = generation;
+		pending.result = std::async(std::launch::async,
+			[this, config]() { return BuildPipeline(config); });
+		m_PendingVariants.push_back(std::move(pending));
+	}
+
+	void VulkanPipelineManager::RetireVariants(size_t index) {
+		for (auto& [key, variant] : m_Variants[index]) {
+			RetirePipeline(variant);
+		}
+		m_Variants[index].clear();
+		++m_VariantGenerations[index];
+	}
+
+	bool VulkanPipelineManager::ProcessPendingVariants() {
+		bool swapped = false;
+		for (size_t i = 0; i < m_PendingVariants.size();) {
+			PendingVariant& pending = m_PendingVariants[i];
+			if (pending.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++i;
+				continue;
+			}
+
+			const PipelineType type = static_cast<PipelineType>(pending.index);
+			Pipeline built = pending.result.get();
+			const bool current = pending.generation == m_VariantGenerations[pending.index] &&
+				m_Pipelines[pending.index].isValid;
+
+			if (built.isValid && current) {
+				swapped |= pending.key == GetWantedVariant(pending.index);
+				LOG_INFO("Built {} pipeline variant {}", m_PipelineNames[type].c_str(), DescribeShaderVariant(pending.key));
+				VulkanDebugMarkers::SetName(m_Device, built.pipeline, m_PipelineNames[type].c_str());
+				m_Variants[pending.index][pending.key] = std::move(built);
+			}
+			else {
+				// Never bound, so it can go right away
+				if (!built.isValid) {
+					LOG_ERROR("Failed to build {} pipeline variant {}", m_PipelineNames[type].c_str(),
+						DescribeShaderVariant(pending.key));
+				}
+				DestroyPipeline(built);
+			}
+
+			m_PendingVariants[i] = std::move(m_PendingVariants.back());
+			m_PendingVariants.pop_back();
+		}
+		return swapped;
+	}
+
+	bool VulkanPipelineManager::CreateGraphicsPipeline(const VulkanPipelineConfig& config, Pipeline& pipeline) const {
 		
 		// Shader stages vector
 		std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
@@ -85,13 +484,13 @@ namespace Nightbloom
 			auto& assetManager = AssetManager::Get();
 			auto vertShaderCode = assetManager.LoadShaderBinary(config.vertexShaderPath);
 
-			if (vertShaderCode.empty())
+			if (!vertShaderCode.IsOpen())
 			{
 				LOG_ERROR("Failed to load vertex shader: {}", config.vertexShaderPath);
 				return false;
 			}
 
-			vertShaderModule = CreateShaderModule(vertShaderCode);
+			vertShaderModule = CreateShaderModule(vertShaderCode.GetSpan());
 			ownsVertModule = true;
 
 			VkPipelineShaderStageCreateInfo vertStageInfo{};
@@ -110,26 +509,45 @@ namespace Nightbloom
 		}
 
 		// FRAGMENT SHADER
+		// RayQueryShadow variants need the ray-query build: the other one
+		// would sample cascades that are no longer rendered, so no fallback
+		const bool rayQuery = (config.variant & ToVariantBit(ShaderFeature::RayQueryShadow)) != 0;
 		if (config.fragmentShader != nullptr)
 		{
-			// Use the provided shader object
-			shaderStages.push_back(config.fragmentShader->GetStageInfo());
-			LOG_TRACE("Using fragment shader object");
+			// Use the provided shader object; HalfPrecision variants take the
+			// fp16 build when there is one
+			const bool half = (config.variant & ToVariantBit(ShaderFeature::HalfPrecision)) != 0;
+			VulkanShader* fragmentShader = (half && config.fragmentShaderHalf) ? config.fragmentShaderHalf : config.fragmentShader;
+			if (rayQuery)
+			{
+				if (!config.fragmentShaderRayQuery)
+				{
+					LOG_ERROR("No ray-query build of fragment shader {}", config.fragmentShader->GetSourcePath());
+					if (ownsVertModule) vkDestroyShaderModule(m_Device, vertShaderModule, nullptr);
+					return false;
+				}
+				fragmentShader = config.fragmentShaderRayQuery;
+			}
+			shaderStages.push_back(fragmentShader->GetStageInfo());
+			LOG_TRACE("Using fragment shader object{}", fragmentShader == config.fragmentShaderHalf ? " (fp16)" :
+				fragmentShader == config.fragmentShaderRayQuery ? " (ray query)" : "");
 		}
 		else if (!config.fragmentShaderPath.empty())
 		{
 			// Load from path (old way)
+			const std::string fragmentPath = rayQuery
+				? GetShaderBuildName(config.fragmentShaderPath, ShaderBuild::RayQuery) : config.fragmentShaderPath;
 			auto& assetManager = AssetManager::Get();
-			auto fragShaderCode = assetManager.LoadShaderBinary(config.fragmentShaderPath);
+			auto fragShaderCode = assetManager.LoadShaderBinary(fragmentPath);
 
-			if (fragShaderCode.empty())
+			if (!fragShaderCode.IsOpen())
 			{
-				LOG_ERROR("Failed to load fragment shader: {}", config.fragmentShaderPath);
+				LOG_ERROR("Failed to load fragment shader: {}", fragmentPath);
 				if (ownsVertModule) vkDestroyShaderModule(m_Device, vertShaderModule, nullptr);
 				return false;
 			}
 
-			fragShaderModule = CreateShaderModule(fragShaderCode);
+			fragShaderModule = CreateShaderModule(fragShaderCode.GetSpan());
 			ownsFragModule = true;
 
 			VkPipelineShaderStageCreateInfo fragStageInfo{};
@@ -139,7 +557,7 @@ namespace Nightbloom
 			fragStageInfo.pName = "main";
 			shaderStages.push_back(fragStageInfo);
 
-			LOG_TRACE("Loaded fragment shader from path: {}", config.fragmentShaderPath);
+			LOG_TRACE("Loaded fragment shader from path: {}", fragmentPath);
 		}
 		else
 		{
@@ -148,6 +566,54 @@ namespace Nightbloom
 			return false;
 		}
 
+		// TESSELLATION SHADERS (optional, always loaded from paths)
+		VkShaderModule tescShaderModule = VK_NULL_HANDLE;
+		VkShaderModule teseShaderModule = VK_NULL_HANDLE;
+		if (config.UsesTessellation())
+		{
+			auto& assetManager = AssetManager::Get();
+			auto tescCode = assetManager.LoadShaderBinary(config.tessControlShaderPath);
+			auto teseCode = assetManager.LoadShaderBinary(config.tessEvalShaderPath);
+
+			if (!tescCode.IsOpen() || !teseCode.IsOpen())
+			{
+				LOG_ERROR("Failed to load tessellation shaders: {} / {}",
+					config.tessControlShaderPath, config.tessEvalShaderPath);
+				if (ownsVertModule) vkDestroyShaderModule(m_Device, vertShaderModule, nullptr);
+				if (ownsFragModule) vkDestroyShaderModule(m_Device, fragShaderModule, nullptr);
+				return false;
+			}
+
+			tescShaderModule = CreateShaderModule(tescCode.GetSpan());
+			teseShaderModule = CreateShaderModule(teseCode.GetSpan());
+
+			VkPipelineShaderStageCreateInfo tescStageInfo{};
+			tescStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			tescStageInfo.stage = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+			tescStageInfo.module = tescShaderModule;
+			tescStageInfo.pName = "main";
+			shaderStages.push_back(tescStageInfo);
+
+			VkPipelineShaderStageCreateInfo teseStageInfo = tescStageInfo;
+			teseStageInfo.stage = VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+			teseStageInfo.module = teseShaderModule;
+			shaderStages.push_back(teseStageInfo);
+
+			LOG_TRACE("Loaded tessellation shaders from paths: {} / {}",
+				config.tessControlShaderPath, config.tessEvalShaderPath);
+		}
+
+		// Feature variant
+		const SpecializationData specialization = BuildSpecialization(config.variant, config.variantMask);
+		std::vector<VkSpecializationMapEntry> specializationEntries;
+		VkSpecializationInfo specializationInfo{};
+		if (!specialization.IsEmpty()) {
+			FillSpecializationInfo(specialization, specializationEntries, specializationInfo);
+			for (VkPipelineShaderStageCreateInfo& stage : shaderStages) {
+				stage.pSpecializationInfo = &specializationInfo;
+			}
+		}
+
 		// Vertex input
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -156,7 +622,17 @@ namespace Nightbloom
 		VkVertexInputBindingDescription bindingDescription{};
 		std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
 
-		if (config.useVertexInput) {
+		if (config.useVertexInput && config.vertexFormat == VertexFormat::Packed) {
+			bindingDescription = VertexPNTPacked::GetBindingDescription();
+			const auto packedAttributes = VertexPNTPacked::GetAttributeDescriptions();
+			attributeDescriptions.assign(packedAttributes.begin(), packedAttributes.end());
+
+			vertexInputInfo.vertexBindingDescriptionCount = 1;
+			vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+			vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+			vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+		}
+		else if (config.useVertexInput) {
 			// Vertex binding description (one vertex buffer binding at index 0)
 			bindingDescription.binding = 0;
 			bindingDescription.stride = sizeof(VertexPCU);  // Assuming you have a Vertex struct
@@ -206,6 +682,17 @@ namespace Nightbloom
 		inputAssembly.topology = config.topology;
 		inputAssembly.primitiveRestartEnable = VK_FALSE;
 
+		// Tessellation: the patch size, and the domain origin GLSL assumes,
+		// so the evaluation shader's cw/ccw mean what they do there
+		VkPipelineTessellationDomainOriginStateCreateInfo domainOrigin{};
+		domainOrigin.sType = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_DOMAIN_ORIGIN_STATE_CREATE_INFO;
+		domainOrigin.domainOrigin = VK_TESSELLATION_DOMAIN_ORIGIN_LOWER_LEFT;
+
+		VkPipelineTessellationStateCreateInfo tessellation{};
+		tessellation.sType = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
+		tessellation.pNext = &domainOrigin;
+		tessellation.patchControlPoints = config.patchControlPoints;
+
 		// Rasterizer
 		VkPipelineRasterizationStateCreateInfo rasterizer{};
 		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -237,8 +724,9 @@ namespace Nightbloom
 
 		// Color blending
 		VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-			VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		colorBlendAttachment.colorWriteMask = config.colorWriteEnable
+			? (VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT)
+			: 0;
 
 		colorBlendAttachment.blendEnable = config.blendEnable;
 		if (config.blendEnable) {
@@ -254,7 +742,39 @@ namespace Nightbloom
 		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
 		colorBlending.logicOpEnable = VK_FALSE;
 		
-		if (config.hasColorAttachment)
+		// OIT accumulation: premultiplied color and weight summed into the
+		// accumulation target; the revealage target multiplies by (1 - alpha)
+		// per layer, so neither depends on the order the layers arrive in
+		std::array<VkPipelineColorBlendAttachmentState, 2> oitBlendAttachments{};
+		if (config.oitAccumulate)
+		{
+			VkPipelineColorBlendAttachmentState& accum = oitBlendAttachments[0];
+			accum.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+			accum.blendEnable = VK_TRUE;
+			accum.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+			accum.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+			accum.colorBlendOp = VK_BLEND_OP_ADD;
+			accum.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			accum.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			accum.alphaBlendOp = VK_BLEND_OP_ADD;
+
+			VkPipelineColorBlendAttachmentState& revealage = oitBlendAttachments[1];
+			revealage.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+			revealage.blendEnable = VK_TRUE;
+			revealage.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+			revealage.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+			revealage.colorBlendOp = VK_BLEND_OP_ADD;
+			revealage.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+			revealage.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			revealage.alphaBlendOp = VK_BLEND_OP_ADD;
+		}
+
+		if (config.oitAccumulate)
+		{
+			colorBlending.attachmentCount = static_cast<uint32_t>(oitBlendAttachments.size());
+			colorBlending.pAttachments = oitBlendAttachments.data();
+		}
+		else if (config.hasColorAttachment)
 		{
 			colorBlending.attachmentCount = 1;
 			colorBlending.pAttachments = &colorBlendAttachment;
@@ -303,6 +823,8 @@ namespace Nightbloom
 			LOG_ERROR("Failed to create pipeline layout");
 			vkDestroyShaderModule(m_Device, vertShaderModule, nullptr);
 			vkDestroyShaderModule(m_Device, fragShaderModule, nullptr);
+			vkDestroyShaderModule(m_Device, tescShaderModule, nullptr);
+			vkDestroyShaderModule(m_Device, teseShaderModule, nullptr);
 			return false;
 		}
 
@@ -313,6 +835,7 @@ namespace Nightbloom
 		pipelineInfo.pStages = shaderStages.data();
 		pipelineInfo.pVertexInputState = &vertexInputInfo;
 		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pTessellationState = config.UsesTessellation() ? &tessellation : nullptr;
 		pipelineInfo.pViewportState = &viewportState;
 		pipelineInfo.pRasterizationState = &rasterizer;
 		pipelineInfo.pMultisampleState = &multisampling;
@@ -321,19 +844,45 @@ namespace Nightbloom
 		pipelineInfo.pDynamicState = &dynamicState;
 		pipelineInfo.layout = pipeline.layout;
 		pipelineInfo.renderPass = config.renderPass ? config.renderPass : m_DefaultRenderPass;
-		pipelineInfo.subpass = 0;
+		pipelineInfo.subpass = config.subpass;
+
+		// Full rate unless the attachment asks for coarser; without this the
+		// pipeline keeps 1x1 and ignores the attachment
+		VkPipelineFragmentShadingRateStateCreateInfoKHR shadingRate{};
+		shadingRate.sType = VK_STRUCTURE_TYPE_PIPELINE_FRAGMENT_SHADING_RATE_STATE_CREATE_INFO_KHR;
+		shadingRate.fragmentSize = { 1, 1 };
+		shadingRate.combinerOps[0] = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR;
+		shadingRate.combinerOps[1] = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_REPLACE_KHR;
+		if (config.attachmentShadingRate)
+			pipelineInfo.pNext = &shadingRate;
+
+		// Dynamic rendering: attachment formats replace the render pass
+		VkPipelineRenderingCreateInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+		if (config.UsesDynamicRendering())
+		{
+			renderingInfo.colorAttachmentCount = static_cast<uint32_t>(config.renderingColorFormats.size());
+			renderingInfo.pColorAttachmentFormats = config.renderingColorFormats.data();
+			renderingInfo.depthAttachmentFormat = config.renderingDepthFormat;
+			renderingInfo.pNext = pipelineInfo.pNext;
+			pipelineInfo.pNext = &renderingInfo;
+			pipelineInfo.renderPass = VK_NULL_HANDLE;
+			pipelineInfo.subpass = 0;
+		}
 
-		VkResult result = vkCreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1,
+		VkResult result = vkCreateGraphicsPipelines(m_Device, m_PipelineCache, 1,
 			&pipelineInfo, nullptr, &pipeline.pipeline);
 
 		// At the end, clean up only the modules we created
 		if (ownsVertModule) vkDestroyShaderModule(m_Device, vertShaderModule, nullptr);
 		if (ownsFragModule) vkDestroyShaderModule(m_Device, fragShaderModule, nullptr);
+		vkDestroyShaderModule(m_Device, tescShaderModule, nullptr);
+		vkDestroyShaderModule(m_Device, teseShaderModule, nullptr);
 
 		return result == VK_SUCCESS;
 	}
 
-	bool VulkanPipelineManager::CreateComputePipeline(const VulkanPipelineConfig& config, Pipeline& outPipeline)
+	bool VulkanPipelineManager::CreateComputePipeline(const VulkanPipelineConfig& config, Pipeline& outPipeline) const
 	{
 		// Validate we have a compute shader
 		if (config.computeShader == nullptr && config.computeShaderPath.empty())
@@ -359,13 +908,13 @@ namespace Nightbloom
 			auto& assetManager = AssetManager::Get();
 			auto computeShaderCode = assetManager.LoadShaderBinary(config.computeShaderPath);
 
-			if (computeShaderCode.empty())
+			if (!computeShaderCode.IsOpen())
 			{
 				LOG_ERROR("Failed to load compute shader: {}", config.computeShaderPath);
 				return false;
 			}
 
-			computeShaderModule = CreateShaderModule(computeShaderCode);
+			computeShaderModule = CreateShaderModule(computeShaderCode.GetSpan());
 			if (computeShaderModule == VK_NULL_HANDLE)
 			{
 				LOG_ERROR("Failed to create compute shader module");
@@ -381,6 +930,15 @@ namespace Nightbloom
 			LOG_TRACE("Loaded compute shader from path: {}", config.computeShaderPath);
 		}
 
+		const SpecializationData specialization = BuildSpecialization(config.variant, config.variantMask);
+		std::vector<VkSpecializationMapEntry> specializationEntries;
+		VkSpecializationInfo specializationInfo{};
+		if (!specialization.IsEmpty())
+		{
+			FillSpecializationInfo(specialization, specializationEntries, specializationInfo);
+			shaderStageInfo.pSpecializationInfo = &specializationInfo;
+		}
+
 		// Push constants
 		VkPushConstantRange pushConstantRange{};
 		if (config.pushConstantSize > 0)
@@ -415,7 +973,7 @@ namespace Nightbloom
 
 		VkResult result = vkCreateComputePipelines(
 			m_Device,
-			VK_NULL_HANDLE,  // Pipeline cache (could add later for faster loading)
+			m_PipelineCache,
 			1,
 			&pipelineInfo,
 			nullptr,
@@ -441,39 +999,70 @@ namespace Nightbloom
 
 	//TODO: rename to bind graphics pipeline
 	void VulkanPipelineManager::BindPipeline(VkCommandBuffer cmd, PipelineType type) {
-		size_t index = static_cast<size_t>(type);
-		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
-			LOG_ERROR("Attempting to bind invalid pipeline: {}", m_PipelineNames[type]);
+		const Pipeline* pipeline = ResolvePipeline(type);
+		if (!pipeline) {
+			LOG_ERROR("Attempting to bind invalid pipeline: {}", m_PipelineNames[type].c_str());
 			return;
 		}
 
-		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipelines[index].pipeline);
+		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline);
 	}
 
 	void VulkanPipelineManager::BindComputePipeline(VkCommandBuffer cmd, PipelineType type)
 	{
-		size_t index = static_cast<size_t>(type);
-		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid)
+		const Pipeline* pipeline = ResolvePipeline(type);
+		if (!pipeline)
 		{
-			LOG_ERROR("Attempting to bind invalid compute pipeline: {}", m_PipelineNames[type]);
+			LOG_ERROR("Attempting to bind invalid compute pipeline: {}", m_PipelineNames[type].c_str());
 			return;
 		}
 
-		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipelines[index].pipeline);
+		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
 	}
 
 	void VulkanPipelineManager::PushConstants(VkCommandBuffer cmd, PipelineType type,
 		VkShaderStageFlags stages, const void* data, uint32_t size) {
-		size_t index = static_cast<size_t>(type);
-		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
+		const Pipeline* pipeline = ResolvePipeline(type);
+		if (!pipeline) {
 			LOG_ERROR("Attempting to push constants to invalid pipeline");
 			return;
 		}
 
-		vkCmdPushConstants(cmd, m_Pipelines[index].layout, stages, 0, size, data);
+		vkCmdPushConstants(cmd, pipeline->layout, stages, 0, size, data);
 	}
 
 	void VulkanPipelineManager::Cleanup() {
+		// A startup batch abandoned part way still has workers writing into it
+		FinishParallelCreation();
+
+		// Let background builds finish; their results were never bound
+		for (PendingReload& pending : m_PendingReloads) {
+			if (pending.result.valid()) {
+				Pipeline built = pending.result.get();
+				DestroyPipeline(built);
+			}
+		}
+
+		for (PendingVariant& pending : m_PendingVariants) {
+			Pipeline built = pending.result.get();
+			DestroyPipeline(built);
+		}
+		m_PendingVariants.clear();
+
+		// Callers wait idle before cleanup, so retired pipelines and cached
+		// variants can go too
+		for (auto& variants : m_Variants) {
+			for (auto& [key, variant] : variants) {
+				DestroyPipeline(variant);
+			}
+			variants.clear();
+		}
+		for (const RetiredPipeline& retired : m_RetiredPipelines) {
+			if (retired.pipeline != VK_NULL_HANDLE) vkDestroyPipeline(m_Device, retired.pipeline, nullptr);
+			if (retired.layout != VK_NULL_HANDLE) vkDestroyPipelineLayout(m_Device, retired.layout, nullptr);
+		}
+		m_RetiredPipelines.clear();
+
 		for (auto& pipeline : m_Pipelines) {
 			DestroyPipeline(pipeline);
 		}
@@ -482,7 +1071,7 @@ namespace Nightbloom
 		LOG_INFO("VulkanPipelineManager cleaned up");
 	}
 
-	VkShaderModule VulkanPipelineManager::CreateShaderModule(const std::vector<char>& code) {
+	VkShaderModule VulkanPipelineManager::CreateShaderModule(std::span<const uint8_t> code) const {
 		VkShaderModuleCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 		createInfo.codeSize = code.size();
@@ -500,11 +1089,11 @@ namespace Nightbloom
 	bool VulkanPipelineManager::ReloadPipeline(PipelineType type) {
 		size_t index = static_cast<size_t>(type);
 		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
-			LOG_ERROR("Attempting to reload invalid pipeline: {}", m_PipelineNames[type]);
+			LOG_ERROR("Attempting to reload invalid pipeline: {}", m_PipelineNames[type].c_str());
 			return false;
 		}
 
-		LOG_INFO("Reloading {} pipeline", m_PipelineNames[type]);
+		LOG_INFO("Reloading {} pipeline", m_PipelineNames[type].c_str());
 		return CreatePipeline(type, m_Pipelines[index].config);
 	}
 
@@ -512,14 +1101,14 @@ namespace Nightbloom
 		bool success = true;
 		for (size_t i = 0; i < m_Pipelines.size(); ++i) {
 			if (m_Pipelines[i].isValid) {
-				LOG_INFO("Reloading {} pipeline", m_PipelineNames[static_cast<PipelineType>(i)]);
+				LOG_INFO("Reloading {} pipeline", m_PipelineNames[static_cast<PipelineType>(i)].c_str());
 				success &= ReloadPipeline(static_cast<PipelineType>(i));
 			}
 		}
 		return success;
 	}
 
-	void VulkanPipelineManager::DestroyPipeline(Pipeline& pipeline) {
+	void VulkanPipelineManager::DestroyPipeline(Pipeline& pipeline) const {
 		if (pipeline.pipeline != VK_NULL_HANDLE) {
 			vkDestroyPipeline(m_Device, pipeline.pipeline, nullptr);
 			pipeline.pipeline = VK_NULL_HANDLE;
@@ -533,20 +1122,20 @@ namespace Nightbloom
 	}
 
 	VkPipeline VulkanPipelineManager::GetPipeline(PipelineType type) const {
-		size_t index = static_cast<size_t>(type);
-		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
-			//LOG_ERROR("Attempting to get invalid pipeline: {}", m_PipelineNames[type]);
+		const Pipeline* pipeline = ResolvePipeline(type);
+		if (!pipeline) {
+			//LOG_ERROR("Attempting to get invalid pipeline: {}", m_PipelineNames[type].c_str());
 			return VK_NULL_HANDLE;
 		}
-		return m_Pipelines[index].pipeline;
+		return pipeline->pipeline;
 	}
 
 	VkPipelineLayout VulkanPipelineManager::GetPipelineLayout(PipelineType type) const {
-		size_t index = static_cast<size_t>(type);
-		if (index >= m_Pipelines.size() || !m_Pipelines[index].isValid) {
-			//LOG_ERROR("Attempting to get layout of invalid pipeline: {}", m_PipelineNames[type]);
+		const Pipeline* pipeline = ResolvePipeline(type);
+		if (!pipeline) {
+			//LOG_ERROR("Attempting to get layout of invalid pipeline: {}", m_PipelineNames[type].c_str());
 			return VK_NULL_HANDLE;
 		}
-		return m_Pipelines[index].layout;
+		return pipeline->layout;
 	}
 }
\ No newline at end of file
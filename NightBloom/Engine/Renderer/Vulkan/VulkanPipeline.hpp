@@ -6,13 +6,20 @@
 
 #pragma once
 
+#include "Engine/Renderer/VertexPacking.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringId.hpp"
 #include <vulkan/vulkan.h>
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <memory>
 #include <array>
+#include <future>
+#include <span>
 #include "Engine/Renderer/PipelineInterface.hpp"  // For PipelineType enum
+#include "Engine/Renderer/ShaderVariant.hpp"
 #include "Engine/Renderer/Vulkan/VulkanShader.hpp"
 
 namespace Nightbloom
@@ -23,6 +30,8 @@ namespace Nightbloom
 	{
 		VulkanShader* vertexShader = nullptr;   // NEW: Option to use shader object
 		VulkanShader* fragmentShader = nullptr; // NEW: Option to use shader object
+		VulkanShader* fragmentShaderHalf = nullptr; // fp16 build, for HalfPrecision variants
+		VulkanShader* fragmentShaderRayQuery = nullptr; // ray-query build, for RayQueryShadow variants
 		VulkanShader* computeShader = nullptr;
 
 		std::string vertexShaderPath;
@@ -30,8 +39,15 @@ namespace Nightbloom
 		std::string geometryShaderPath; // Optional
 		std::string computeShaderPath; // For compute pipelines
 
+		// Tessellation stages (both or neither) and the patch size; the
+		// topology must then be VK_PRIMITIVE_TOPOLOGY_PATCH_LIST
+		std::string tessControlShaderPath;
+		std::string tessEvalShaderPath;
+		uint32_t patchControlPoints = 3;
+
 		// Vertex input (define this properly later)
 		bool useVertexInput = false; // false for hardcoded vertices
+		VertexFormat vertexFormat = VertexFormat::Standard; // Packed: VertexPNTPacked attributes
 
 		// Render state 
 		VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
@@ -53,6 +69,11 @@ namespace Nightbloom
 		VkBlendFactor srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
 		VkBlendFactor dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
 
+		// Weighted-blended OIT accumulation: two color attachments (the
+		// accumulation and revealage targets) with their fixed blends
+		// instead of the single one above
+		bool oitAccumulate = false;
+
 		// Push constants
 		uint32_t pushConstantSize = 0;  // 0 means no push constants
 		VkShaderStageFlags pushConstantStages = VK_SHADER_STAGE_VERTEX_BIT;
@@ -62,14 +83,46 @@ namespace Nightbloom
 
 		// Optional: render pass override (if different from default)
 		VkRenderPass renderPass = VK_NULL_HANDLE;
+		uint32_t subpass = 0;
+
+		// Dynamic rendering (VK_KHR_dynamic_rendering): with any attachment
+		// format set the pipeline is built against these formats instead of
+		// a render pass (renderPass/subpass are ignored) and is drawn between
+		// VulkanDevice::CmdBeginRendering/CmdEndRendering
+		std::vector<VkFormat> renderingColorFormats;
+		VkFormat renderingDepthFormat = VK_FORMAT_UNDEFINED;
+		bool UsesTessellation() const
+		{
+			return !tessControlShaderPath.empty() && !tessEvalShaderPath.empty();
+		}
+
+		bool UsesDynamicRendering() const
+		{
+			return !renderingColorFormats.empty() || renderingDepthFormat != VK_FORMAT_UNDEFINED;
+		}
 
 		// NEW: Color attachment configuration (false for depth-only passes)
 		bool hasColorAttachment = true;
+		// False leaves the color attachment in place but writes nothing to
+		// it (a depth prepass recorded inside the scene render pass)
+		bool colorWriteEnable = true;
+
+		// Take the fragment shading rate from the render pass's shading-rate
+		// attachment (combiner REPLACE over a 1x1 pipeline rate). Needs
+		// VK_KHR_fragment_shading_rate; without it leave this false.
+		bool attachmentShadingRate = false;
 
 		// MSAA — must match the sample count of the render pass this pipeline
 		// targets. Scene-pass pipelines get the scene MSAA count; the
 		// post-process and shadow passes stay single-sample.
 		VkSampleCountFlagBits rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		// Feature variant (ShaderVariant.hpp): the features in variantMask
+		// are passed to every stage as specialization constants, on or off
+		// per `variant`. CreatePipeline fills both from the pipeline type
+		// and the active variant key.
+		ShaderVariantKey variant = 0;
+		ShaderVariantKey variantMask = 0;
 	};
 
 	class VulkanPipelineManager
@@ -78,12 +131,29 @@ namespace Nightbloom
 		VulkanPipelineManager() = default;
 		~VulkanPipelineManager() { Cleanup(); }
 
-		// Initialize with device and default render pass
-		bool Initialize(VkDevice device, VkRenderPass defaultRenderPass, VkExtent2D extent);
+		// Initialize with device and default render pass. pipelineCache is
+		// VulkanDevice's shared cache (may be VK_NULL_HANDLE).
+		bool Initialize(VkDevice device, VkRenderPass defaultRenderPass, VkExtent2D extent,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE);
 
 		// Create a pipeline with given configuration
 		bool CreatePipeline(PipelineType type, const VulkanPipelineConfig& config);
 
+		// Startup: between Begin and FinishParallelCreation, CreatePipeline
+		// queues the build on the job system and returns true without
+		// waiting (false only for a bad type), so every pipeline compiles at
+		// once against the shared cache. Finish waits for them and installs
+		// them in call order. A failed build was reported as created, so the
+		// caller rechecks whatever it decided from that.
+		struct ParallelCreationResult
+		{
+			uint32_t built = 0;
+			std::vector<PipelineType> failed;
+		};
+		void BeginParallelCreation() { m_ParallelCreation = true; }
+		ParallelCreationResult FinishParallelCreation();
+		bool IsCreatingInParallel() const { return m_ParallelCreation; }
+
 		VkPipeline GetPipeline(PipelineType type) const;
 		VkPipelineLayout GetPipelineLayout(PipelineType type) const;
 
@@ -103,6 +173,36 @@ namespace Nightbloom
 		// Hot reload all pipelines (for window resize, etc.)
 		bool ReloadAllPipelines();
 
+		// Editor hot reload without the hitch: the pipeline is rebuilt on a
+		// worker thread while the current one keeps rendering. Reloading a
+		// type that is already compiling restarts it once the first finishes.
+		bool ReloadPipelineAsync(PipelineType type);
+		bool ReloadAllPipelinesAsync();
+
+		// Asset hot reload: ReloadPipelineAsync for every pipeline with a
+		// stage loaded from the SPIR-V file at `shaderFile`. Returns how many
+		// started.
+		uint32_t ReloadPipelinesUsingShaderAsync(const std::string& shaderFile);
+
+		// Once per frame, after the frame fence wait: swaps finished reloads
+		// in (a failed build keeps the current pipeline) and destroys
+		// replaced pipelines once 'framesInFlight' frames have gone by.
+		// Returns true if any pipeline handle changed.
+		bool ProcessPendingReloads(uint32_t framesInFlight);
+		bool HasPendingReloads() const;
+
+		// Selects the feature variant every pipeline binds (each type masked
+		// to the features it reads). A variant not built yet compiles in the
+		// background like a reload - the current pipeline keeps rendering
+		// until ProcessPendingReloads swaps it in - and stays cached per key,
+		// so toggling back is free. Returns true if a bound handle changed.
+		bool SetShaderVariant(ShaderVariantKey key);
+		ShaderVariantKey GetShaderVariant() const { return m_VariantKey; }
+		uint32_t GetCachedVariantCount() const;
+		// Whether every pipeline that reads `features` binds a build with them
+		// on now (false while one is still compiling or failed to build)
+		bool IsFeatureBound(ShaderVariantKey features) const;
+
 		void Cleanup();
 
 	private:
@@ -114,20 +214,79 @@ namespace Nightbloom
 			bool isValid = false;
 		};
 
+		struct PendingReload
+		{
+			std::future<Pipeline> result;
+			bool restart = false;     // reloaded again while compiling
+			bool superseded = false;  // CreatePipeline replaced it meanwhile
+		};
+
+		// A variant compiling on a worker; dropped when it lands if the base
+		// pipeline was rebuilt meanwhile (generation moved on)
+		struct PendingVariant
+		{
+			size_t index = 0;
+			ShaderVariantKey key = 0;
+			uint64_t generation = 0;
+			std::future<Pipeline> result;
+		};
+
+		// A CreatePipeline call compiling under BeginParallelCreation
+		struct QueuedCreate
+		{
+			PipelineType type = PipelineType::Count;
+			Pipeline built;
+		};
+
+		struct RetiredPipeline
+		{
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			VkPipelineLayout layout = VK_NULL_HANDLE;
+			uint64_t retiredFrame = 0;
+		};
+
 		// Helper functions
-		VkShaderModule CreateShaderModule(const std::vector<char>& code);
-		bool CreateGraphicsPipeline(const VulkanPipelineConfig& config, Pipeline& outPipeline);
-		bool CreateComputePipeline(const VulkanPipelineConfig& config, Pipeline& outPipeline);
-		void DestroyPipeline(Pipeline& pipeline);
+		Pipeline BuildPipeline(const VulkanPipelineConfig& config) const;
+		void LaunchReload(size_t index);
+		void RetirePipeline(Pipeline& pipeline);
+		VkShaderModule CreateShaderModule(std::span<const uint8_t> code) const;
+		bool CreateGraphicsPipeline(const VulkanPipelineConfig& config, Pipeline& outPipeline) const;
+		bool CreateComputePipeline(const VulkanPipelineConfig& config, Pipeline& outPipeline) const;
+		void DestroyPipeline(Pipeline& pipeline) const;
+
+		// What GetPipeline / BindPipeline use for `type`: the cached variant
+		// for the active key, else the base pipeline (nullptr if invalid)
+		const Pipeline* ResolvePipeline(PipelineType type) const;
+		ShaderVariantKey GetWantedVariant(size_t index) const;
+		void RequestVariant(size_t index);
+		void RetireVariants(size_t index);
+		bool ProcessPendingVariants();
 
 		// Device references
 		VkDevice m_Device = VK_NULL_HANDLE;
 		VkRenderPass m_DefaultRenderPass = VK_NULL_HANDLE;
+		VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;  // not owned
 		VkExtent2D m_Extent = {}; // Default extent, can be updated
 		
 		std::array<Pipeline, static_cast<size_t>(PipelineType::Count)> m_Pipelines;
 
+		// Async reload state (main thread only; workers just build a Pipeline)
+		std::array<PendingReload, static_cast<size_t>(PipelineType::Count)> m_PendingReloads;
+		std::vector<RetiredPipeline> m_RetiredPipelines;
+		uint64_t m_FrameCounter = 0;
+
+		// Feature variants besides the base pipeline, per type and key
+		ShaderVariantKey m_VariantKey = DEFAULT_SHADER_VARIANT;
+		std::array<std::unordered_map<ShaderVariantKey, Pipeline>, static_cast<size_t>(PipelineType::Count)> m_Variants;
+		std::array<uint64_t, static_cast<size_t>(PipelineType::Count)> m_VariantGenerations{};
+		std::vector<PendingVariant> m_PendingVariants;
+
+		// Startup batch; a deque so the workers' entries never move
+		bool m_ParallelCreation = false;
+		std::deque<QueuedCreate> m_QueuedCreates;
+		JobCounter m_QueuedCreatesDone;
+
 		// For debugging
-		std::unordered_map<PipelineType, std::string> m_PipelineNames;
+		std::unordered_map<PipelineType, StringId> m_PipelineNames;
 	};
 }
\ No newline at end of file
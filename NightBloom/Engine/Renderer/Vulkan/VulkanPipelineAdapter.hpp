@@ -30,6 +30,7 @@ namespace Nightbloom
 			case PrimitiveTopology::LineList:      return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
 			case PrimitiveTopology::LineStrip:     return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
 			case PrimitiveTopology::PointList:     return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+			case PrimitiveTopology::PatchList:     return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
 			default: return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 			}
 		}
@@ -135,6 +136,13 @@ namespace Nightbloom
 		VkPipeline GetVkPipeline() const { return m_Pipeline; }
 		VkPipelineLayout GetVkLayout() const { return m_Layout; }
 
+		// After a hot reload swapped the handles underneath
+		void SetHandles(VkPipeline pipeline, VkPipelineLayout layout)
+		{
+			m_Pipeline = pipeline;
+			m_Layout = layout;
+		}
+
 	private:
 		PipelineType m_Type;
 		VkPipeline m_Pipeline;
@@ -148,13 +156,14 @@ namespace Nightbloom
 		VulkanPipelineAdapter() = default;
 		~VulkanPipelineAdapter() override = default;
 
-		bool Initialize(VkDevice device, VkRenderPass renderPass, VkExtent2D extent, VulkanDescriptorManager* descriptorManager)
+		bool Initialize(VkDevice device, VkRenderPass renderPass, VkExtent2D extent, VulkanDescriptorManager* descriptorManager,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE)
 		{
 			m_VulkanManager = std::make_unique<VulkanPipelineManager>();
 			m_DescriptorManager = descriptorManager;
 			m_DefaultRenderPass = renderPass;
 
-			return m_VulkanManager->Initialize(device, renderPass, extent);
+			return m_VulkanManager->Initialize(device, renderPass, extent, pipelineCache);
 		}
 
 		void SetShadowRenderPass(VkRenderPass shadowRenderPass)
@@ -167,9 +176,30 @@ namespace Nightbloom
 			m_PostProcessRenderPass = postProcessRenderPass;
 		}
 
-		void SetBloomRenderPass(VkRenderPass bloomRenderPass)
+		// Dynamic rendering: the post-process pipelines are built against the
+		// swapchain format instead of SetPostProcessRenderPass's pass
+		// (RenderPassManager::IsPostProcessDynamic). VK_FORMAT_UNDEFINED
+		// keeps the render pass.
+		void SetPostProcessRenderingFormat(VkFormat colorFormat)
+		{
+			m_PostProcessRenderingFormat = colorFormat;
+		}
+
+		// Order-independent transparency pass (RenderPassManager::
+		// GetOitRenderPass): the accumulation twins draw in its subpass 0,
+		// OitComposite in subpass 1
+		void SetOitRenderPass(VkRenderPass oitRenderPass)
 		{
-			m_BloomRenderPass = bloomRenderPass;
+			m_OitRenderPass = oitRenderPass;
+		}
+
+		// Reflection pass when it runs below the scene's sample count
+		// (RenderPassManager::NeedsReflectionPipelines): the GetReflectionPipeline
+		// twins are built against it at its own count
+		void SetReflectionRenderPass(VkRenderPass reflectionRenderPass, VkSampleCountFlagBits sampleCount)
+		{
+			m_ReflectionRenderPass = reflectionRenderPass;
+			m_ReflectionSampleCount = sampleCount;
 		}
 
 		// MSAA sample count of the offscreen scene pass — applied to every
@@ -195,12 +225,24 @@ namespace Nightbloom
 			{
 				vkConfig.fragmentShader = dynamic_cast<VulkanShader*>(config.fragmentShader);
 			}
+			if (config.fragmentShaderHalf)
+			{
+				vkConfig.fragmentShaderHalf = dynamic_cast<VulkanShader*>(config.fragmentShaderHalf);
+			}
+			if (config.fragmentShaderRayQuery)
+			{
+				vkConfig.fragmentShaderRayQuery = dynamic_cast<VulkanShader*>(config.fragmentShaderRayQuery);
+			}
 
 			vkConfig.vertexShaderPath = config.vertexShaderPath;
 			vkConfig.fragmentShaderPath = config.fragmentShaderPath;
 			vkConfig.geometryShaderPath = config.geometryShaderPath;
 			vkConfig.computeShaderPath = config.computeShaderPath;
+			vkConfig.tessControlShaderPath = config.tessControlShaderPath;
+			vkConfig.tessEvalShaderPath = config.tessEvalShaderPath;
+			vkConfig.patchControlPoints = config.patchControlPoints;
 			vkConfig.useVertexInput = config.useVertexInput;
+			vkConfig.vertexFormat = config.vertexFormat;
 
 			// Convert enums
 			vkConfig.topology = VulkanEnumConverter::ToVkTopology(config.topology);
@@ -222,31 +264,61 @@ namespace Nightbloom
 			vkConfig.depthBiasClamp = config.depthBiasClamp;
 
 			vkConfig.hasColorAttachment = config.hasColorAttachment;
-
-			if ((type == PipelineType::Shadow || type == PipelineType::TerrainShadow) && m_ShadowRenderPass != VK_NULL_HANDLE)
+			vkConfig.colorWriteEnable = config.colorWriteEnable;
+			vkConfig.oitAccumulate = config.oitAccumulate;
+
+			const bool shadowPass =
+				type == PipelineType::Shadow || type == PipelineType::TerrainShadow ||
+				type == PipelineType::ShadowLayered || type == PipelineType::TerrainShadowLayered ||
+				type == PipelineType::ShadowPacked || type == PipelineType::ShadowLayeredPacked ||
+				type == PipelineType::LocalShadow || type == PipelineType::LocalShadowPacked;
+			if (shadowPass && m_ShadowRenderPass != VK_NULL_HANDLE)
 			{
 				vkConfig.renderPass = m_ShadowRenderPass;
 			}
 
-			if (type == PipelineType::PostProcess && m_PostProcessRenderPass != VK_NULL_HANDLE)
+			const bool postProcessPass = type == PipelineType::PostProcess || type == PipelineType::PostProcessCopy;
+			if (postProcessPass && m_PostProcessRenderingFormat != VK_FORMAT_UNDEFINED)
+			{
+				vkConfig.renderingColorFormats = { m_PostProcessRenderingFormat };
+			}
+			else if (postProcessPass && m_PostProcessRenderPass != VK_NULL_HANDLE)
 			{
 				vkConfig.renderPass = m_PostProcessRenderPass;
 			}
 
-			if (type == PipelineType::Bloom && m_BloomRenderPass != VK_NULL_HANDLE)
+			const bool oitPass =
+				type == PipelineType::TransparentOit || type == PipelineType::TransparentPackedOit || type == PipelineType::WaterOit ||
+				type == PipelineType::FireflyOit || type == PipelineType::FireflyPointOit || type == PipelineType::ParticleOit ||
+				type == PipelineType::OitComposite;
+			if (oitPass && m_OitRenderPass != VK_NULL_HANDLE)
+			{
+				vkConfig.renderPass = m_OitRenderPass;
+				vkConfig.subpass = type == PipelineType::OitComposite ? 1 : 0;
+			}
+
+			const bool reflectionPass =
+				type == PipelineType::SkyboxReflection || type == PipelineType::MeshReflection ||
+				type == PipelineType::MeshPackedReflection || type == PipelineType::TerrainReflection ||
+				type == PipelineType::FoliageReflection || type == PipelineType::CloudsReflection;
+			if (reflectionPass && m_ReflectionRenderPass != VK_NULL_HANDLE)
 			{
-				vkConfig.renderPass = m_BloomRenderPass;
+				vkConfig.renderPass = m_ReflectionRenderPass;
 			}
 
 			// MSAA sample count: scene-pass pipelines match the scene render
-			// pass; the shadow, post-process and bloom passes are single-sample.
+			// pass; the shadow and post-process passes are single-sample, and
+			// so is the OIT composite (it writes the resolved scene color).
 			const bool singleSamplePass =
-				type == PipelineType::Shadow ||
-				type == PipelineType::TerrainShadow ||
-				type == PipelineType::PostProcess ||
-				type == PipelineType::Bloom ||
+				shadowPass ||
+				postProcessPass ||
+				type == PipelineType::OitComposite ||
 				type == PipelineType::Compute;
-			vkConfig.rasterizationSamples = singleSamplePass ? VK_SAMPLE_COUNT_1_BIT : m_SampleCount;
+			vkConfig.rasterizationSamples = singleSamplePass ? VK_SAMPLE_COUNT_1_BIT
+				: reflectionPass ? m_ReflectionSampleCount
+				: m_SampleCount;
+			// Only the scene and reflection passes carry a shading-rate attachment
+			vkConfig.attachmentShadingRate = config.coarseShading && !singleSamplePass && !oitPass;
 
 			if (config.useUniformBuffer && m_DescriptorManager)
 			{
@@ -257,7 +329,9 @@ namespace Nightbloom
 			// NEW: Handle descriptor set layouts based on config flags
 			if (config.useTextures && m_DescriptorManager)
 			{
-				VkDescriptorSetLayout textureLayout = m_DescriptorManager->GetTextureSetLayout();
+				VkDescriptorSetLayout textureLayout = config.useBindlessTextures
+					? m_DescriptorManager->GetBindlessSetLayout()
+					: m_DescriptorManager->GetTextureSetLayout();
 				vkConfig.descriptorSetLayouts.push_back(textureLayout);
 			}
 
@@ -267,6 +341,12 @@ namespace Nightbloom
 				vkConfig.descriptorSetLayouts.push_back(fireflyStorageLayout);  // becomes set 1 (Firefly has no texture set)
 			}
 
+			if (config.useParticleStorage && m_DescriptorManager)
+			{
+				VkDescriptorSetLayout particleStorageLayout = m_DescriptorManager->GetParticleStorageSetLayout();
+				vkConfig.descriptorSetLayouts.push_back(particleStorageLayout);  // set 1, as the firefly storage
+			}
+
 			// Foliage has no texture set either, so this also lands at set 1.
 			// NOTE: set index here is positional (depends on which other
 			// useX flags are set above) — Grass.vert/.frag's layout(set=N)
@@ -297,7 +377,15 @@ namespace Nightbloom
 				vkConfig.descriptorSetLayouts.push_back(postProcessInputLayout);
 			}
 
-			// Bloom result as a SECOND single-sampler set for the post-process composite. Pushed
+			// The OIT composite's only set: accumulation + revealage as input
+			// attachments of its subpass
+			if (config.useOitInput && m_DescriptorManager)
+			{
+				VkDescriptorSetLayout oitInputLayout = m_DescriptorManager->GetOitInputSetLayout();
+				vkConfig.descriptorSetLayouts.push_back(oitInputLayout);
+			}
+
+			// Bloom chain as a SECOND single-sampler set for the post-process composite. Pushed
 			// right after usePostProcessInput so it lands at set 1 (scene = set 0, bloom = set 1).
 			// Reuses the post-process input layout shape (one combined image sampler, fragment).
 			if (config.useBloomInput && m_DescriptorManager)
@@ -333,6 +421,13 @@ namespace Nightbloom
 				vkConfig.descriptorSetLayouts.push_back(reflectionLayout);
 			}
 
+			// Right after the reflection input: Water's set 3 (see Water.vert)
+			if (config.useOceanWaves && m_DescriptorManager)
+			{
+				VkDescriptorSetLayout oceanLayout = m_DescriptorManager->GetOceanSampleSetLayout();
+				vkConfig.descriptorSetLayouts.push_back(oceanLayout);
+			}
+
 			LOG_INFO("Creating pipeline with {} descriptor set layouts", vkConfig.descriptorSetLayouts.size());
 			for (size_t i = 0; i < vkConfig.descriptorSetLayouts.size(); ++i)
 			{
@@ -375,6 +470,60 @@ namespace Nightbloom
 			return m_VulkanManager->ReloadAllPipelines();
 		}
 
+		bool ReloadAllPipelinesAsync() override
+		{
+			return m_VulkanManager->ReloadAllPipelinesAsync();
+		}
+
+		// Asset hot reload (VulkanPipelineManager::ReloadPipelinesUsingShaderAsync)
+		uint32_t ReloadPipelinesUsingShaderAsync(const std::string& shaderFile)
+		{
+			return m_VulkanManager->ReloadPipelinesUsingShaderAsync(shaderFile);
+		}
+
+		bool HasPendingReloads() const override
+		{
+			return m_VulkanManager->HasPendingReloads();
+		}
+
+		// Startup batch (VulkanPipelineManager::BeginParallelCreation): the
+		// wrappers CreatePipeline made get their handles once it finishes,
+		// and the failed types lose theirs
+		void BeginParallelCreation()
+		{
+			m_VulkanManager->BeginParallelCreation();
+		}
+
+		VulkanPipelineManager::ParallelCreationResult FinishParallelCreation()
+		{
+			VulkanPipelineManager::ParallelCreationResult result = m_VulkanManager->FinishParallelCreation();
+			for (PipelineType type : result.failed)
+			{
+				if (m_VulkanManager->GetPipeline(type) == VK_NULL_HANDLE)
+					m_Pipelines.erase(type);
+			}
+			RefreshHandles();
+			return result;
+		}
+
+		// Frame boundary hook for async reloads (see VulkanPipelineManager).
+		// True when pipelines were swapped.
+		bool ProcessPendingReloads(uint32_t framesInFlight)
+		{
+			if (!m_VulkanManager->ProcessPendingReloads(framesInFlight))
+				return false;
+			RefreshHandles();
+			return true;
+		}
+
+		// Selects the feature variant every pipeline binds from now on
+		void SetShaderVariant(ShaderVariantKey key)
+		{
+			if (m_VulkanManager->SetShaderVariant(key))
+				RefreshHandles();
+		}
+		bool IsFeatureBound(ShaderVariantKey features) const { return m_VulkanManager->IsFeatureBound(features); }
+
 		void SetActivePipeline(PipelineType type) override
 		{
 			m_ActivePipeline = type;
@@ -404,11 +553,23 @@ namespace Nightbloom
 		VulkanPipelineManager* GetVulkanManager() { return m_VulkanManager.get(); }
 
 	private:
+		// The wrappers cache handles; re-read them after a swap
+		void RefreshHandles()
+		{
+			for (auto& [type, pipeline] : m_Pipelines)
+			{
+				pipeline->SetHandles(m_VulkanManager->GetPipeline(type), m_VulkanManager->GetPipelineLayout(type));
+			}
+		}
+
 		VulkanDescriptorManager* m_DescriptorManager = nullptr;
 		VkRenderPass m_DefaultRenderPass = VK_NULL_HANDLE;
 		VkRenderPass m_ShadowRenderPass = VK_NULL_HANDLE;
 		VkRenderPass m_PostProcessRenderPass = VK_NULL_HANDLE;
-		VkRenderPass m_BloomRenderPass = VK_NULL_HANDLE;
+		VkFormat m_PostProcessRenderingFormat = VK_FORMAT_UNDEFINED;
+		VkRenderPass m_OitRenderPass = VK_NULL_HANDLE;
+		VkRenderPass m_ReflectionRenderPass = VK_NULL_HANDLE;
+		VkSampleCountFlagBits m_ReflectionSampleCount = VK_SAMPLE_COUNT_1_BIT;
 		VkSampleCountFlagBits m_SampleCount = VK_SAMPLE_COUNT_1_BIT;
 
 
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// VulkanPipelineCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanPipelineCache.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Nightbloom
+{
+	VulkanPipelineCache::~VulkanPipelineCache()
+	{
+		Cleanup();
+	}
+
+	bool VulkanPipelineCache::Initialize(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& directory)
+	{
+		m_Device = device;
+		m_Directory = directory;
+		vkGetPhysicalDeviceProperties(physicalDevice, &m_Properties);
+
+		char uuid[2 * VK_UUID_SIZE + 1] = {};
+		for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+		{
+			std::snprintf(uuid + 2 * i, 3, "%02x", m_Properties.pipelineCacheUUID[i]);
+		}
+
+		char fileName[128];
+		std::snprintf(fileName, sizeof(fileName), "pipeline_cache_%04x_%04x_%08x_%s.bin",
+			m_Properties.vendorID, m_Properties.deviceID, m_Properties.driverVersion, uuid);
+		m_FilePath = (std::filesystem::path(directory) / fileName).string();
+
+		std::vector<char> data;
+		std::ifstream file(m_FilePath, std::ios::binary | std::ios::ate);
+		if (file.is_open())
+		{
+			data.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(data.data(), data.size());
+			if (!file || !IsCompatible(data))
+			{
+				LOG_WARN("Ignoring unusable pipeline cache '{}'", m_FilePath);
+				data.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		createInfo.initialDataSize = data.size();
+		createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+		VkResult result = vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_Cache);
+		if (result != VK_SUCCESS && !data.empty())
+		{
+			// The driver rejected the blob despite the header matching
+			LOG_WARN("Driver rejected pipeline cache '{}', starting empty", m_FilePath);
+			data.clear();
+			createInfo.initialDataSize = 0;
+			createInfo.pInitialData = nullptr;
+			result = vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_Cache);
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create pipeline cache");
+			m_Cache = VK_NULL_HANDLE;
+			return false;
+		}
+
+		if (data.empty())
+			LOG_INFO("Created empty pipeline cache ({})", m_FilePath);
+		else
+			LOG_INFO("Loaded pipeline cache: {} KB from {}", data.size() / 1024, m_FilePath);
+		return true;
+	}
+
+	bool VulkanPipelineCache::IsCompatible(const std::vector<char>& data) const
+	{
+		// VkPipelineCacheHeaderVersionOne: headerSize, headerVersion,
+		// vendorID, deviceID, pipelineCacheUUID
+		constexpr size_t HEADER_SIZE = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+		if (data.size() < HEADER_SIZE)
+			return false;
+
+		uint32_t header[4];
+		std::memcpy(header, data.data(), sizeof(header));
+		if (header[0] < HEADER_SIZE || header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+			return false;
+		if (header[2] != m_Properties.vendorID || header[3] != m_Properties.deviceID)
+			return false;
+
+		return std::memcmp(data.data() + sizeof(header), m_Properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+
+	bool VulkanPipelineCache::Save() const
+	{
+		if (m_Cache == VK_NULL_HANDLE)
+			return false;
+
+		size_t size = 0;
+		if (vkGetPipelineCacheData(m_Device, m_Cache, &size, nullptr) != VK_SUCCESS || size == 0)
+			return false;
+
+		std::vector<char> data(size);
+		if (vkGetPipelineCacheData(m_Device, m_Cache, &size, data.data()) != VK_SUCCESS)
+		{
+			LOG_WARN("Failed to read back pipeline cache data");
+			return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(m_Directory, ec);
+
+		// Write next to the target and rename, so a crash mid-write can't
+		// leave a truncated cache behind
+		const std::string tempPath = m_FilePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open() || !file.write(data.data(), size))
+			{
+				LOG_WARN("Failed to write pipeline cache '{}'", tempPath);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, m_FilePath, ec);
+		if (ec)
+		{
+			LOG_WARN("Failed to replace pipeline cache '{}': {}", m_FilePath, ec.message());
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		LOG_INFO("Saved pipeline cache: {} KB to {}", size / 1024, m_FilePath);
+		return true;
+	}
+
+	void VulkanPipelineCache::Cleanup()
+	{
+		if (m_Cache == VK_NULL_HANDLE)
+			return;
+
+		Save();
+		vkDestroyPipelineCache(m_Device, m_Cache, nullptr);
+		m_Cache = VK_NULL_HANDLE;
+	}
+}
@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+// VulkanPipelineCache.hpp
+//
+// Engine-wide VkPipelineCache persisted between runs. The file name is keyed
+// by vendor/device ID, driver version and pipelineCacheUUID, so a driver
+// update or a different GPU starts from an empty cache instead of handing the
+// driver stale data; the blob's own header is checked as well before use.
+// Owned by VulkanDevice (GetPipelineCache); every pipeline creation passes it.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanPipelineCache
+	{
+	public:
+		VulkanPipelineCache() = default;
+		~VulkanPipelineCache();
+
+		// Loads <directory>/<key>.bin if present and compatible, otherwise
+		// starts empty. The directory is created on Save.
+		bool Initialize(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& directory);
+
+		// Writes the current contents back to disk
+		bool Save() const;
+
+		// Save, then destroy the cache
+		void Cleanup();
+
+		VkPipelineCache GetHandle() const { return m_Cache; }
+		const std::string& GetFilePath() const { return m_FilePath; }
+
+	private:
+		bool IsCompatible(const std::vector<char>& data) const;
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		VkPhysicalDeviceProperties m_Properties{};
+		VkPipelineCache m_Cache = VK_NULL_HANDLE;
+		std::string m_Directory;
+		std::string m_FilePath;
+
+		VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+		VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+	};
+}
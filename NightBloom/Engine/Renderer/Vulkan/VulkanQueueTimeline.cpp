@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+// VulkanQueueTimeline.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+
+namespace Nightbloom
+{
+	bool VulkanQueueTimeline::Initialize(VkDevice device, VkQueue queue, bool useTimelineSemaphore)
+	{
+		m_Device = device;
+		m_Queue = queue;
+		m_LastSubmitted = 0;
+		m_LastCompleted = 0;
+		m_LastBind = 0;
+
+		if (!useTimelineSemaphore)
+			return true;
+
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if (vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &m_Semaphore) != VK_SUCCESS)
+		{
+			LOG_WARN("Failed to create timeline semaphore - falling back to fences");
+			m_Semaphore = VK_NULL_HANDLE;
+		}
+		return true;
+	}
+
+	void VulkanQueueTimeline::Cleanup()
+	{
+		if (m_Device == VK_NULL_HANDLE)
+			return;
+
+		if (m_Semaphore != VK_NULL_HANDLE)
+		{
+			vkDestroySemaphore(m_Device, m_Semaphore, nullptr);
+			m_Semaphore = VK_NULL_HANDLE;
+		}
+
+		for (const PendingFence& pending : m_PendingFences)
+			vkDestroyFence(m_Device, pending.fence, nullptr);
+		for (VkFence fence : m_FreeFences)
+			vkDestroyFence(m_Device, fence, nullptr);
+		m_PendingFences.clear();
+		m_FreeFences.clear();
+
+		m_Device = VK_NULL_HANDLE;
+		m_Queue = VK_NULL_HANDLE;
+	}
+
+	uint64_t VulkanQueueTimeline::Submit(const VkSubmitInfo& submit)
+	{
+		const uint64_t value = m_LastSubmitted + 1;
+
+		if (m_Semaphore != VK_NULL_HANDLE)
+		{
+			// Append our semaphore to the caller's signal list; binary
+			// semaphores take a (ignored) value of 0
+			m_SignalSemaphores.assign(submit.pSignalSemaphores, submit.pSignalSemaphores + submit.signalSemaphoreCount);
+			m_SignalSemaphores.push_back(m_Semaphore);
+			m_SignalValues.assign(submit.signalSemaphoreCount, 0);
+			m_SignalValues.push_back(value);
+
+			VkTimelineSemaphoreSubmitInfo timelineInfo{};
+			timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+			timelineInfo.pNext = submit.pNext;
+			timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(m_SignalValues.size());
+			timelineInfo.pSignalSemaphoreValues = m_SignalValues.data();
+
+			VkSubmitInfo extended = submit;
+			extended.pNext = &timelineInfo;
+			extended.signalSemaphoreCount = static_cast<uint32_t>(m_SignalSemaphores.size());
+			extended.pSignalSemaphores = m_SignalSemaphores.data();
+
+			// Sparse binds still pending: nothing in this batch may touch
+			// their pages before they land
+			if (m_LastBind != 0 && !IsComplete(m_LastBind))
+			{
+				m_WaitSemaphores.assign(submit.pWaitSemaphores, submit.pWaitSemaphores + submit.waitSemaphoreCount);
+				m_WaitStages.assign(submit.pWaitDstStageMask, submit.pWaitDstStageMask + submit.waitSemaphoreCount);
+				m_WaitValues.assign(submit.waitSemaphoreCount, 0);
+				m_WaitSemaphores.push_back(m_Semaphore);
+				m_WaitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+				m_WaitValues.push_back(m_LastBind);
+
+				timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(m_WaitValues.size());
+				timelineInfo.pWaitSemaphoreValues = m_WaitValues.data();
+				extended.waitSemaphoreCount = static_cast<uint32_t>(m_WaitSemaphores.size());
+				extended.pWaitSemaphores = m_WaitSemaphores.data();
+				extended.pWaitDstStageMask = m_WaitStages.data();
+			}
+
+			const VkResult result = vkQueueSubmit(m_Queue, 1, &extended, VK_NULL_HANDLE);
+			if (result != VK_SUCCESS)
+			{
+				LOG_ERROR("Queue submit failed: {}", static_cast<int>(result));
+				return 0;
+			}
+		}
+		else
+		{
+			VkFence fence = AcquireFence();
+			if (fence == VK_NULL_HANDLE)
+				return 0;
+
+			const VkResult result = vkQueueSubmit(m_Queue, 1, &submit, fence);
+			if (result != VK_SUCCESS)
+			{
+				LOG_ERROR("Queue submit failed: {}", static_cast<int>(result));
+				m_FreeFences.push_back(fence);
+				return 0;
+			}
+			m_PendingFences.push_back({ fence, value });
+		}
+
+		m_LastSubmitted = value;
+		return value;
+	}
+
+	uint64_t VulkanQueueTimeline::BindSparse(const VkBindSparseInfo& bind)
+	{
+		if (m_Semaphore == VK_NULL_HANDLE)
+			return 0;
+
+		const uint64_t waitValue = m_LastSubmitted;
+		const uint64_t value = m_LastSubmitted + 1;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.pNext = bind.pNext;
+		timelineInfo.waitSemaphoreValueCount = 1;
+		timelineInfo.pWaitSemaphoreValues = &waitValue;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &value;
+
+		VkBindSparseInfo extended = bind;
+		extended.pNext = &timelineInfo;
+		extended.waitSemaphoreCount = 1;
+		extended.pWaitSemaphores = &m_Semaphore;
+		extended.signalSemaphoreCount = 1;
+		extended.pSignalSemaphores = &m_Semaphore;
+
+		const VkResult result = vkQueueBindSparse(m_Queue, 1, &extended, VK_NULL_HANDLE);
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Sparse bind failed: {}", static_cast<int>(result));
+			return 0;
+		}
+
+		m_LastSubmitted = value;
+		m_LastBind = value;
+		return value;
+	}
+
+	uint64_t VulkanQueueTimeline::GetCompletedValue()
+	{
+		if (m_Semaphore != VK_NULL_HANDLE)
+		{
+			uint64_t value = 0;
+			if (vkGetSemaphoreCounterValue(m_Device, m_Semaphore, &value) == VK_SUCCESS)
+				m_LastCompleted = value;
+			return m_LastCompleted;
+		}
+
+		// Fences signal in submission order on one queue
+		while (!m_PendingFences.empty() && vkGetFenceStatus(m_Device, m_PendingFences.front().fence) == VK_SUCCESS)
+		{
+			PendingFence& oldest = m_PendingFences.front();
+			m_LastCompleted = oldest.value;
+			vkResetFences(m_Device, 1, &oldest.fence);
+			m_FreeFences.push_back(oldest.fence);
+			m_PendingFences.pop_front();
+		}
+		return m_LastCompleted;
+	}
+
+	bool VulkanQueueTimeline::Wait(uint64_t value, uint64_t timeout)
+	{
+		if (value <= m_LastCompleted)
+			return true;
+
+		if (m_Semaphore != VK_NULL_HANDLE)
+		{
+			VkSemaphoreWaitInfo waitInfo{};
+			waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+			waitInfo.semaphoreCount = 1;
+			waitInfo.pSemaphores = &m_Semaphore;
+			waitInfo.pValues = &value;
+
+			const VkResult result = vkWaitSemaphores(m_Device, &waitInfo, timeout);
+			if (result != VK_SUCCESS)
+			{
+				if (result != VK_TIMEOUT)
+					LOG_ERROR("Failed to wait for timeline value {}: {}", value, static_cast<int>(result));
+				return false;
+			}
+			m_LastCompleted = std::max(m_LastCompleted, value);
+			return true;
+		}
+
+		for (const PendingFence& pending : m_PendingFences)
+		{
+			if (pending.value < value)
+				continue;
+
+			const VkResult result = vkWaitForFences(m_Device, 1, &pending.fence, VK_TRUE, timeout);
+			if (result != VK_SUCCESS)
+			{
+				if (result != VK_TIMEOUT)
+					LOG_ERROR("Failed to wait for submission {}: {}", value, static_cast<int>(result));
+				return false;
+			}
+			break;
+		}
+
+		GetCompletedValue();
+		return value <= m_LastCompleted;
+	}
+
+	VkFence VulkanQueueTimeline::AcquireFence()
+	{
+		if (!m_FreeFences.empty())
+		{
+			VkFence fence = m_FreeFences.back();
+			m_FreeFences.pop_back();
+			return fence;
+		}
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		VkFence fence = VK_NULL_HANDLE;
+		if (vkCreateFence(m_Device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create submission fence");
+			return VK_NULL_HANDLE;
+		}
+		return fence;
+	}
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// VulkanQueueTimeline.hpp
+//
+// Completion tracking for one queue as a single monotonically increasing
+// value. Every Submit() signals the next value; "is this work done" and
+// "wait for this work" become a comparison and a wait on a number instead of
+// a fence per submission that the caller has to create, reset and destroy.
+//
+// Backed by one timeline semaphore (Vulkan 1.2 core / VK_KHR_timeline_
+// semaphore) when the device enables it. Otherwise each submission gets a
+// pooled fence and completion is polled in submission order, which gives
+// callers the same value-based interface.
+//
+// Not thread-safe: like the queue it wraps, submissions must be serialized.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanQueueTimeline
+	{
+	public:
+		VulkanQueueTimeline() = default;
+		~VulkanQueueTimeline() = default;
+
+		bool Initialize(VkDevice device, VkQueue queue, bool useTimelineSemaphore);
+		void Cleanup();
+
+		bool UsesTimelineSemaphore() const { return m_Semaphore != VK_NULL_HANDLE; }
+
+		// Submits `submit` to the queue, additionally signalling the next
+		// value, and returns that value (0 on failure). Any semaphores the
+		// submit already waits on / signals must be binary.
+		uint64_t Submit(const VkSubmitInfo& submit);
+
+		// Sparse binds (vkQueueBindSparse) with `bind`'s buffer and image
+		// binds, which must carry no semaphores of their own. They wait for
+		// everything submitted so far, so pages released here are no longer
+		// read, and the submits after them wait for the binds, which are
+		// otherwise unordered against command buffers. Returns the value
+		// signalled (0 on failure, and always on the fence path).
+		uint64_t BindSparse(const VkBindSparseInfo& bind);
+
+		// Highest value whose work has finished on the GPU
+		uint64_t GetCompletedValue();
+		bool IsComplete(uint64_t value) { return value <= m_LastCompleted || value <= GetCompletedValue(); }
+
+		// Blocks until `value` has completed. 0 is always complete.
+		bool Wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+
+		uint64_t GetLastSubmittedValue() const { return m_LastSubmitted; }
+
+		// The timeline semaphore itself (null on the fence path), so that
+		// submissions to other queues can wait for a value of this one
+		VkSemaphore GetSemaphore() const { return m_Semaphore; }
+
+	private:
+		struct PendingFence
+		{
+			VkFence fence = VK_NULL_HANDLE;
+			uint64_t value = 0;
+		};
+
+		VkFence AcquireFence();
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		VkQueue m_Queue = VK_NULL_HANDLE;
+		VkSemaphore m_Semaphore = VK_NULL_HANDLE;   // timeline; null on the fence path
+		uint64_t m_LastSubmitted = 0;
+		uint64_t m_LastCompleted = 0;
+		uint64_t m_LastBind = 0;      // the latest BindSparse, waited on until it completes
+
+		// Fence path only
+		std::deque<PendingFence> m_PendingFences;
+		std::vector<VkFence> m_FreeFences;
+
+		// Scratch for extending a submit's wait and signal lists
+		std::vector<VkSemaphore> m_SignalSemaphores;
+		std::vector<uint64_t> m_SignalValues;
+		std::vector<VkSemaphore> m_WaitSemaphores;
+		std::vector<uint64_t> m_WaitValues;
+		std::vector<VkPipelineStageFlags> m_WaitStages;
+
+		VulkanQueueTimeline(const VulkanQueueTimeline&) = delete;
+		VulkanQueueTimeline& operator=(const VulkanQueueTimeline&) = delete;
+	};
+}
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+// VulkanSamplerCache.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	VulkanSamplerCache::~VulkanSamplerCache()
+	{
+		Cleanup();
+	}
+
+	void VulkanSamplerCache::Cleanup()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Device != VK_NULL_HANDLE)
+		{
+			for (auto& [key, sampler] : m_Samplers)
+			{
+				vkDestroySampler(m_Device, sampler, nullptr);
+			}
+		}
+		if (!m_Samplers.empty())
+		{
+			LOG_INFO("Sampler cache destroyed {} shared samplers", m_Samplers.size());
+		}
+		m_Samplers.clear();
+	}
+
+	VkSampler VulkanSamplerCache::GetSampler(const VkSamplerCreateInfo& info)
+	{
+		const SamplerKey key = SamplerKey::FromCreateInfo(info);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Samplers.find(key);
+		if (it != m_Samplers.end())
+		{
+			return it->second;
+		}
+
+		// Created from the normalized key, so the handle matches every
+		// description that maps to it
+		const VkSamplerCreateInfo createInfo = key.ToCreateInfo();
+		VkSampler sampler = VK_NULL_HANDLE;
+		if (vkCreateSampler(m_Device, &createInfo, nullptr, &sampler) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create cached sampler");
+			return VK_NULL_HANDLE;
+		}
+
+		m_Samplers.emplace(key, sampler);
+		return sampler;
+	}
+
+	size_t VulkanSamplerCache::GetSamplerCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Samplers.size();
+	}
+}
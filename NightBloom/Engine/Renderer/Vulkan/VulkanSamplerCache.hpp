@@ -0,0 +1,196 @@
+//------------------------------------------------------------------------------
+// VulkanSamplerCache.hpp
+//
+// Device-wide VkSampler cache. Samplers are immutable and only differ by
+// their create info, so every texture and render-pass component asks for
+// one by description and gets the shared handle: a few samplers in total
+// instead of one per texture (maxSamplerAllocationCount is often 4000), and
+// no vkCreateSampler on the texture load path after the first. Owned by
+// VulkanDevice (GetSamplerCache); samplers live until the device shuts down,
+// so callers never destroy what they get.
+//
+// Descriptor set layouts whose sampler never changes bake the same cached
+// handle in as an immutable sampler (see LinearClamp).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace Nightbloom
+{
+	// The fields of a VkSamplerCreateInfo that affect sampling, normalized so
+	// that descriptions sampling the same way compare equal: maxAnisotropy
+	// only counts with anisotropy on, compareOp only with compare on, the
+	// border color only with a CLAMP_TO_BORDER address mode. pNext chains
+	// (YCbCr conversion, reduction modes) are not part of the key.
+	struct SamplerKey
+	{
+		VkSamplerCreateFlags flags = 0;
+		VkFilter magFilter = VK_FILTER_NEAREST;
+		VkFilter minFilter = VK_FILTER_NEAREST;
+		VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		VkSamplerAddressMode addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		VkSamplerAddressMode addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		VkSamplerAddressMode addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		float mipLodBias = 0.0f;
+		VkBool32 anisotropyEnable = VK_FALSE;
+		float maxAnisotropy = 1.0f;
+		VkBool32 compareEnable = VK_FALSE;
+		VkCompareOp compareOp = VK_COMPARE_OP_NEVER;
+		float minLod = 0.0f;
+		float maxLod = 0.0f;
+		VkBorderColor borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+		VkBool32 unnormalizedCoordinates = VK_FALSE;
+
+		static SamplerKey FromCreateInfo(const VkSamplerCreateInfo& info)
+		{
+			SamplerKey key;
+			key.flags = info.flags;
+			key.magFilter = info.magFilter;
+			key.minFilter = info.minFilter;
+			key.mipmapMode = info.mipmapMode;
+			key.addressModeU = info.addressModeU;
+			key.addressModeV = info.addressModeV;
+			key.addressModeW = info.addressModeW;
+			key.mipLodBias = info.mipLodBias;
+			key.anisotropyEnable = info.anisotropyEnable ? VK_TRUE : VK_FALSE;
+			key.maxAnisotropy = info.anisotropyEnable ? info.maxAnisotropy : 1.0f;
+			key.compareEnable = info.compareEnable ? VK_TRUE : VK_FALSE;
+			key.compareOp = info.compareEnable ? info.compareOp : VK_COMPARE_OP_NEVER;
+			key.minLod = info.minLod;
+			key.maxLod = info.maxLod;
+			const bool border =
+				info.addressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+				info.addressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+				info.addressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+			key.borderColor = border ? info.borderColor : VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+			key.unnormalizedCoordinates = info.unnormalizedCoordinates ? VK_TRUE : VK_FALSE;
+			return key;
+		}
+
+		VkSamplerCreateInfo ToCreateInfo() const
+		{
+			VkSamplerCreateInfo info{};
+			info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			info.flags = flags;
+			info.magFilter = magFilter;
+			info.minFilter = minFilter;
+			info.mipmapMode = mipmapMode;
+			info.addressModeU = addressModeU;
+			info.addressModeV = addressModeV;
+			info.addressModeW = addressModeW;
+			info.mipLodBias = mipLodBias;
+			info.anisotropyEnable = anisotropyEnable;
+			info.maxAnisotropy = maxAnisotropy;
+			info.compareEnable = compareEnable;
+			info.compareOp = compareOp;
+			info.minLod = minLod;
+			info.maxLod = maxLod;
+			info.borderColor = borderColor;
+			info.unnormalizedCoordinates = unnormalizedCoordinates;
+			return info;
+		}
+
+		bool operator==(const SamplerKey& other) const
+		{
+			return flags == other.flags && magFilter == other.magFilter && minFilter == other.minFilter &&
+				mipmapMode == other.mipmapMode && addressModeU == other.addressModeU &&
+				addressModeV == other.addressModeV && addressModeW == other.addressModeW &&
+				mipLodBias == other.mipLodBias && anisotropyEnable == other.anisotropyEnable &&
+				maxAnisotropy == other.maxAnisotropy && compareEnable == other.compareEnable &&
+				compareOp == other.compareOp && minLod == other.minLod && maxLod == other.maxLod &&
+				borderColor == other.borderColor && unnormalizedCoordinates == other.unnormalizedCoordinates;
+		}
+		bool operator!=(const SamplerKey& other) const { return !(*this == other); }
+	};
+
+	struct SamplerKeyHash
+	{
+		size_t operator()(const SamplerKey& key) const
+		{
+			// FNV-1a over the fields (floats by value bits, so -0/+0 differ:
+			// at worst a duplicate sampler, never a wrong one)
+			uint64_t hash = 14695981039346656037ull;
+			auto mix = [&hash](uint32_t value)
+			{
+				for (int i = 0; i < 4; ++i)
+				{
+					hash ^= (value >> (i * 8)) & 0xffu;
+					hash *= 1099511628211ull;
+				}
+			};
+			auto bits = [](float value)
+			{
+				uint32_t out;
+				static_assert(sizeof(out) == sizeof(value));
+				std::memcpy(&out, &value, sizeof(out));
+				return out;
+			};
+			mix(key.flags);
+			mix(static_cast<uint32_t>(key.magFilter));
+			mix(static_cast<uint32_t>(key.minFilter));
+			mix(static_cast<uint32_t>(key.mipmapMode));
+			mix(static_cast<uint32_t>(key.addressModeU));
+			mix(static_cast<uint32_t>(key.addressModeV));
+			mix(static_cast<uint32_t>(key.addressModeW));
+			mix(bits(key.mipLodBias));
+			mix(key.anisotropyEnable);
+			mix(bits(key.maxAnisotropy));
+			mix(key.compareEnable);
+			mix(static_cast<uint32_t>(key.compareOp));
+			mix(bits(key.minLod));
+			mix(bits(key.maxLod));
+			mix(static_cast<uint32_t>(key.borderColor));
+			mix(key.unnormalizedCoordinates);
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	class VulkanSamplerCache
+	{
+	public:
+		VulkanSamplerCache() = default;
+		~VulkanSamplerCache();
+
+		void Initialize(VkDevice device) { m_Device = device; }
+
+		// Destroys every sampler; nothing may still use them
+		void Cleanup();
+
+		// The shared sampler for `info` (created on first request), or
+		// VK_NULL_HANDLE if creation failed. Thread-safe.
+		VkSampler GetSampler(const VkSamplerCreateInfo& info);
+		VkSampler GetSampler(const SamplerKey& key) { return GetSampler(key.ToCreateInfo()); }
+
+		size_t GetSamplerCount() const;
+
+		// Bilinear, clamp to edge, a single mip: the render-target sampler
+		// most compute passes read through. Layouts that only ever see it
+		// (bloom chain, atmosphere LUTs) use it as an immutable sampler.
+		static VkSamplerCreateInfo LinearClamp()
+		{
+			VkSamplerCreateInfo info{};
+			info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			info.magFilter = VK_FILTER_LINEAR;
+			info.minFilter = VK_FILTER_LINEAR;
+			info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+			info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			return info;
+		}
+
+	private:
+		VkDevice m_Device = VK_NULL_HANDLE;
+		mutable std::mutex m_Mutex;
+		std::unordered_map<SamplerKey, VkSampler, SamplerKeyHash> m_Samplers;
+
+		VulkanSamplerCache(const VulkanSamplerCache&) = delete;
+		VulkanSamplerCache& operator=(const VulkanSamplerCache&) = delete;
+	};
+}
@@ -26,7 +26,7 @@ namespace Nightbloom
 		}
 	}
 
-	bool VulkanShader::CreateFromSpirV(const std::vector<char>& spirvCode, const std::string& entryPoint)
+	bool VulkanShader::CreateFromSpirV(std::span<const uint8_t> spirvCode, const std::string& entryPoint)
 	{
 		if (spirvCode.empty())
 		{
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <span>
 #include "Engine/Renderer/RenderDevice.hpp"
 
 namespace Nightbloom
@@ -31,7 +32,8 @@ namespace Nightbloom
 		const std::string& GetSourcePath() const override { return m_SourcePath; }
 
 
-		bool CreateFromSpirV(const std::vector<char>& spirvCode, const std::string& entryPoint = "main");
+		// spirvCode must be 4-byte aligned (a mapped file is)
+		bool CreateFromSpirV(std::span<const uint8_t> spirvCode, const std::string& entryPoint = "main");
 		VkShaderModule GetModule() const { return m_ShaderModule; }
 		VkPipelineShaderStageCreateInfo GetStageInfo() const;
 		void SetSourcePath(const std::string& path) { m_SourcePath = path; }
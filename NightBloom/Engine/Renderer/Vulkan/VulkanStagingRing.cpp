@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+// VulkanStagingRing.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/Vulkan/VulkanStagingRing.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+
+namespace Nightbloom
+{
+	VulkanStagingRing::VulkanStagingRing(VulkanDevice* device, VulkanMemoryManager* memoryManager)
+		: m_Device(device), m_MemoryManager(memoryManager)
+	{
+	}
+
+	VulkanStagingRing::~VulkanStagingRing()
+	{
+		Cleanup();
+	}
+
+	bool VulkanStagingRing::Initialize(VkDeviceSize capacity)
+	{
+		m_Buffer = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
+
+		BufferDesc desc;
+		desc.usage = BufferUsage::Staging;
+		desc.memoryAccess = MemoryAccess::CpuToGpu;
+		desc.size = capacity;
+		desc.persistentMap = true;
+		desc.debugName = "StagingRing";
+
+		if (!m_Buffer->Initialize(desc) || !m_Buffer->GetPersistentMappedPtr())
+		{
+			LOG_ERROR("Failed to create {:.1f} MB staging ring", capacity / (1024.0 * 1024.0));
+			m_Buffer.reset();
+			return false;
+		}
+
+		m_Allocator.Reset(capacity);
+		LOG_INFO("Created {:.1f} MB staging ring", capacity / (1024.0 * 1024.0));
+		return true;
+	}
+
+	void VulkanStagingRing::Cleanup()
+	{
+		if (!m_Buffer)
+			return;
+
+		if (m_Allocator.GetUsed() > 0)
+			LOG_WARN("Destroying staging ring with {} bytes still in flight", m_Allocator.GetUsed());
+
+		m_Buffer.reset();
+		m_Allocator.Reset(0);
+	}
+
+	bool VulkanStagingRing::Write(const void* data, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset)
+	{
+		if (!m_Buffer || size > GetMaxAllocation())
+			return false;
+
+		const uint64_t offset = m_Allocator.Allocate(size, alignment);
+		if (offset == StagingRingAllocator::INVALID_OFFSET)
+			return false;
+
+		// Persistently mapped: Update is a memcpy plus a flush for
+		// non-coherent memory
+		if (!m_Buffer->Update(data, size, offset))
+			return false;
+
+		outOffset = offset;
+		return true;
+	}
+
+	VkBuffer VulkanStagingRing::GetBuffer() const
+	{
+		return m_Buffer ? m_Buffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+}
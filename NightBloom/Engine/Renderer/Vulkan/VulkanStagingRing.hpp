@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+// VulkanStagingRing.hpp
+//
+// One large, persistently mapped staging buffer that uploads sub-allocate
+// from, replacing a pool of whole per-upload buffers. VulkanUploadManager
+// allocates from it while recording a batch and, on submit, remembers the
+// ring head; when the graphics timeline passes that batch (RetireCompleted,
+// polled each frame after FrameSyncManager's wait) everything up to the head
+// is released. Batches retire in submission order, so the ring stays FIFO.
+//
+// Uploads over GetMaxAllocation() don't fit and get dedicated buffers from
+// the caller. Main thread only, like the upload manager.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/Vulkan/StagingRingAllocator.hpp"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanBuffer;
+
+	class VulkanStagingRing
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_CAPACITY = 32 * 1024 * 1024;
+
+		VulkanStagingRing(VulkanDevice* device, VulkanMemoryManager* memoryManager);
+		~VulkanStagingRing();
+
+		bool Initialize(VkDeviceSize capacity = DEFAULT_CAPACITY);
+		void Cleanup();
+
+		// Copies 'data' into the ring. False if it is too big or the ring is
+		// full until older batches retire.
+		bool Write(const void* data, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset);
+
+		// Head position to hand back to Release once the work reading
+		// everything written so far has completed
+		uint64_t GetHead() const { return m_Allocator.GetHead(); }
+		void Release(uint64_t position) { m_Allocator.Release(position); }
+		void ReleaseAll() { m_Allocator.ReleaseAll(); }
+
+		VkBuffer GetBuffer() const;
+		VkDeviceSize GetCapacity() const { return m_Allocator.GetCapacity(); }
+		VkDeviceSize GetUsed() const { return m_Allocator.GetUsed(); }
+		// A quarter of the ring, so one big texture can't starve the rest
+		VkDeviceSize GetMaxAllocation() const { return m_Allocator.GetCapacity() / 4; }
+
+	private:
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		std::unique_ptr<VulkanBuffer> m_Buffer;
+		StagingRingAllocator m_Allocator;
+
+		VulkanStagingRing(const VulkanStagingRing&) = delete;
+		VulkanStagingRing& operator=(const VulkanStagingRing&) = delete;
+	};
+}
@@ -6,6 +6,7 @@
 
 #include "VulkanDevice.hpp"
 #include "VulkanSwapchain.hpp"
+#include "VulkanDeletionQueue.hpp"
 #include "Core/Logger/Logger.hpp"
 #include <algorithm>
 #include <limits>
@@ -76,6 +77,14 @@ namespace Nightbloom
 		}
 		LOG_INFO("Image views created successfully");
 
+		// Device-level entry point; the loader doesn't export it on every SDK
+		if (m_Device->SupportsFeature("present_wait"))
+		{
+			m_WaitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+				vkGetDeviceProcAddr(m_Device->GetDevice(), "vkWaitForPresentKHR"));
+		}
+		LOG_INFO("Present wait: {}", m_WaitForPresent ? "available" : "unavailable");
+
 		m_Initialized = true;
 		LOG_INFO("VulkanSwapchain initialized successfully");
 		return true;
@@ -129,14 +138,16 @@ namespace Nightbloom
 		return true;
 	}
 
-	bool VulkanSwapchain::CreateSwapChain()
+	bool VulkanSwapchain::CreateSwapChain(VkSwapchainKHR oldSwapchain)
 	{
 		// Query swapchain support details
 		auto swapChainSupport = QuerySwapChainSupport(m_Device->GetPhysicalDevice());
+		m_SupportedPresentModes = swapChainSupport.presentModes;
 
 		// choose settings
 		VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.formats);
 		VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapChainSupport.presentModes);
+		m_PresentMode = presentMode;
 		VkExtent2D extent = ChooseSwapExtent(swapChainSupport.capabilities);
 		uint32_t imageCount = ChooseImageCount(swapChainSupport.capabilities);
 
@@ -144,7 +155,7 @@ namespace Nightbloom
 		LOG_INFO("Swapchain configuration:");
 		//LOG_INFO("  Format: {}", surfaceFormat.format);
 		//LOG_INFO("  Color Space: {}", surfaceFormat.colorSpace);
-		//LOG_INFO("  Present Mode: {}", presentMode);
+		LOG_INFO("  Present Mode: {}", GetPresentModeName(presentMode));
 		LOG_INFO("  Extent: {}x{}", extent.width, extent.height);
 		LOG_INFO("  Image Count: {}", imageCount);
 
@@ -184,7 +195,7 @@ namespace Nightbloom
 		createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR; // Opaque composite alpha
 		createInfo.presentMode = presentMode; // Chosen present mode
 		createInfo.clipped = VK_TRUE; // Don't render pixels behind other windows
-		createInfo.oldSwapchain = VK_NULL_HANDLE; // No previous swapchain/ used when recreating
+		createInfo.oldSwapchain = oldSwapchain; // lets the driver hand the old images over when recreating
 
 		VkResult result = vkCreateSwapchainKHR(
 			m_Device->GetDevice(),
@@ -195,6 +206,7 @@ namespace Nightbloom
 
 		if (result != VK_SUCCESS) {
 			//LOG_ERROR("Failed to create swapchain: {}", result);
+			m_Swapchain = VK_NULL_HANDLE;
 			return false;
 		}
 
@@ -295,14 +307,26 @@ namespace Nightbloom
 		m_Width = width;
 		m_Height = height;
 
-		// Wait for device to be idle before recreating swapchain
-		m_Device->WaitForIdle();
+		// Frames still in flight may render to or present the old images, so
+		// the old swapchain and its views go to the deletion queue. It's
+		// retired by the create call below even if that fails.
+		VkSwapchainKHR oldSwapchain = m_Swapchain;
+		std::vector<VkImageView> oldImageViews = std::move(m_SwapchainImageViews);
+		m_SwapchainImageViews.clear();
+		m_SwapchainImages.clear();
 
-		// Cleanup old swapchain resources
-		CleanupSwapchain();
+		const bool created = CreateSwapChain(oldSwapchain);
 
-		// Recreate swapchain 
-		if (!CreateSwapChain())
+		VkDevice device = m_Device->GetDevice();
+		m_Device->GetDeletionQueue()->Defer([device, oldSwapchain, oldImageViews]()
+			{
+				for (VkImageView view : oldImageViews)
+					vkDestroyImageView(device, view, nullptr);
+				if (oldSwapchain != VK_NULL_HANDLE)
+					vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+			});
+
+		if (!created)
 		{
 			LOG_ERROR("Failed to recreate swapchain");
 			return false;
@@ -317,6 +341,9 @@ namespace Nightbloom
 
 		LOG_INFO("Swapchain recreated successfully with {} images", m_SwapchainImages.size());
 
+		// Ids presented to the retired swapchain can't be waited on
+		m_LastPresentId = 0;
+
 		m_OutOfDate = false; // Reset out-of-date flag
 		return true;
 	}
@@ -360,8 +387,23 @@ namespace Nightbloom
 		presentInfo.pImageIndices = &imageIndex;
 		presentInfo.pResults = nullptr; // Optional
 
+		// Tag the present so WaitForPresent can tell when it reaches the display
+		VkPresentIdKHR presentId = {};
+		const uint64_t id = m_PresentIdCounter + 1;
+		if (m_WaitForPresent) {
+			presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+			presentId.swapchainCount = 1;
+			presentId.pPresentIds = &id;
+			presentInfo.pNext = &presentId;
+		}
+
 		VkResult result = vkQueuePresentKHR(m_Device->GetPresentQueue(), &presentInfo);
 
+		if (m_WaitForPresent && (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)) {
+			m_PresentIdCounter = id;
+			m_LastPresentId = id;
+		}
+
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
 		{
 			m_OutOfDate = true;
@@ -375,6 +417,19 @@ namespace Nightbloom
 		return true;
 	}
 
+	bool VulkanSwapchain::WaitForPresent(uint64_t presentId, uint64_t timeoutNs)
+	{
+		if (!m_WaitForPresent || presentId == 0 || m_Swapchain == VK_NULL_HANDLE)
+			return false;
+
+		VkResult result = m_WaitForPresent(m_Device->GetDevice(), m_Swapchain, presentId, timeoutNs);
+		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+			m_OutOfDate = true;
+			return false;
+		}
+		return result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+	}
+
 	VkDevice VulkanSwapchain::GetDevice() const
 	{
 		return static_cast<VkDevice>(m_Device->GetDevice());
@@ -422,35 +477,46 @@ namespace Nightbloom
 
 	VkPresentModeKHR VulkanSwapchain::ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
 	{
-		if (!m_EnableVSync)
-		{
-			// Prefer triple buffering without V-Sync
-			for (const auto& availablePresentMode : availablePresentModes)
+		auto isAvailable = [&](VkPresentModeKHR mode)
 			{
-				
-				if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
-				{
-					LOG_INFO("Using Mailbox present mode (triple buffering, no vsync)");
-					return availablePresentMode;
-				}
-			}
+				return std::find(availablePresentModes.begin(), availablePresentModes.end(), mode) != availablePresentModes.end();
+			};
+
+		// Requested mode first, then the closest one with the same V-Sync behaviour
+		VkPresentModeKHR candidates[2] = { m_RequestedPresentMode, m_RequestedPresentMode };
+		if (m_RequestedPresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+			candidates[1] = VK_PRESENT_MODE_IMMEDIATE_KHR;
+		else if (m_RequestedPresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+			candidates[1] = VK_PRESENT_MODE_MAILBOX_KHR;
 
-			// Try immediate mode (no vsync)
-			for (const auto& availablePresentMode : availablePresentModes)
+		for (VkPresentModeKHR mode : candidates)
+		{
+			if (isAvailable(mode))
 			{
-				if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
-				{
-					LOG_INFO("Using Immediate present mode (no vsync)");
-					return availablePresentMode;
-				}
+				if (mode != m_RequestedPresentMode)
+					LOG_INFO("{} present mode unsupported, using {}", GetPresentModeName(m_RequestedPresentMode), GetPresentModeName(mode));
+				return mode;
 			}
 		}
 
-		// Fallback to FIFO mode (V-Sync)
-		LOG_INFO("Using FIFO present mode (V-Sync)");
+		// FIFO (V-Sync) is the one mode every implementation supports
+		if (m_RequestedPresentMode != VK_PRESENT_MODE_FIFO_KHR)
+			LOG_INFO("{} present mode unsupported, using FIFO (V-Sync)", GetPresentModeName(m_RequestedPresentMode));
 		return VK_PRESENT_MODE_FIFO_KHR;
 	}
 
+	const char* VulkanSwapchain::GetPresentModeName(VkPresentModeKHR mode)
+	{
+		switch (mode)
+		{
+		case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO";
+		case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO Relaxed";
+		case VK_PRESENT_MODE_MAILBOX_KHR:      return "Mailbox";
+		case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "Immediate";
+		default:                               return "Unknown";
+		}
+	}
+
 	VkExtent2D VulkanSwapchain::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities)
 	{
 		// If vulkan tells us the extent, use it
@@ -21,9 +21,19 @@ namespace Nightbloom
 		bool Initialize(void* windowHandle, uint32_t width, uint32_t height);
 		void Shutdown();
 
-		// Recreate swapchain (for window resize)
+		// Recreate swapchain (window resize, present mode change). Passes the
+		// current swapchain as oldSwapchain and hands it, with its image
+		// views, to the device's deletion queue rather than idling the device.
 		bool RecreateSwapchain(uint32_t width, uint32_t height);
 
+		// Present mode the next (re)creation asks for. Unsupported modes fall
+		// back: FIFO_RELAXED -> FIFO, MAILBOX <-> IMMEDIATE -> FIFO (FIFO is
+		// always supported).
+		void SetPresentMode(VkPresentModeKHR mode) { m_RequestedPresentMode = mode; }
+		VkPresentModeKHR GetRequestedPresentMode() const { return m_RequestedPresentMode; }
+		const std::vector<VkPresentModeKHR>& GetSupportedPresentModes() const { return m_SupportedPresentModes; }
+		static const char* GetPresentModeName(VkPresentModeKHR mode);
+
 		// Frame operations
 		bool AcquireNextImage(uint32_t& imageIndex, VkSemaphore signalSemaphore = VK_NULL_HANDLE);
 		bool Present(uint32_t imageIndex, VkSemaphore waitSemaphore = VK_NULL_HANDLE);
@@ -42,6 +52,19 @@ namespace Nightbloom
 		// Check if swapchain needs to be recreated
 		bool IsOutOfDate() const { return m_OutOfDate; }
 
+		// FIFO modes hold each image until a vblank, so frame starts can be
+		// scheduled against the refresh; MAILBOX/IMMEDIATE never block
+		VkPresentModeKHR GetPresentMode() const { return m_PresentMode; }
+		bool IsDisplayPaced() const { return m_PresentMode == VK_PRESENT_MODE_FIFO_KHR || m_PresentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR; }
+
+		// VK_KHR_present_wait: with the device feature every Present() is
+		// tagged with an increasing id, and WaitForPresent blocks until that
+		// image has actually been shown. GetLastPresentId() is 0 before the
+		// first present (and after a recreate) or without the feature.
+		bool SupportsPresentWait() const { return m_WaitForPresent != nullptr; }
+		uint64_t GetLastPresentId() const { return m_LastPresentId; }
+		bool WaitForPresent(uint64_t presentId, uint64_t timeoutNs);
+
 	private:
 		// Helper structs
 		struct SwapChainSupportDetails
@@ -53,7 +76,7 @@ namespace Nightbloom
 
 		// Creation steps
 		bool CreateSurface();
-		bool CreateSwapChain();
+		bool CreateSwapChain(VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 		bool CreateImageViews();
 		void CleanupSwapchain();
 
@@ -86,9 +109,16 @@ namespace Nightbloom
 		// state
 		bool m_Initialized = false;
 		bool m_OutOfDate = false;
+		VkPresentModeKHR m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+		// present timing (VK_KHR_present_wait)
+		PFN_vkWaitForPresentKHR m_WaitForPresent = nullptr;
+		uint64_t m_PresentIdCounter = 0;  // ids only grow, even across recreation
+		uint64_t m_LastPresentId = 0;
 
 		// Configuation
-		bool m_EnableVSync = false; // Toggle V-Sync
+		VkPresentModeKHR m_RequestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR; // no V-Sync, no tearing
+		std::vector<VkPresentModeKHR> m_SupportedPresentModes;
 		uint32_t m_DesiredImageCount = 3;  // Triple buffering preferred
 	};
 }
@@ -6,11 +6,15 @@
 
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanSamplerCache.hpp"
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanUploadManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDeletionQueue.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace Nightbloom
@@ -36,6 +40,8 @@ namespace Nightbloom
 		m_Usage = desc.usage;
 		m_GenerateMips = desc.generateMips;
 		m_Force3D = desc.force3D;
+		m_MemoryPriority = desc.memoryPriority;
+		m_Sparse = desc.sparse;
 
 		// Calculate mip levels if generating mips
 		if (m_GenerateMips)
@@ -78,6 +84,56 @@ namespace Nightbloom
 	}
 
 	bool VulkanTexture::UploadData(const void* data, size_t size, VulkanCommandPool* cmdPool)
+	{
+		// If you can sanity-check byte size vs image extent, do it here (optional):
+		// const size_t expected = size_t(m_Width) * m_Height * m_Depth * BytesPerPixel(m_Format) * m_ArrayLayers;
+		// if (size < expected) { LOG_WARN("UploadData: provided size < expected image size"); }
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = m_ArrayLayers;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { m_Width, m_Height, m_Depth };
+
+		return UploadRegions(data, size, { region }, cmdPool);
+	}
+
+	bool VulkanTexture::UploadMipLevels(const void* data, size_t size, const std::vector<size_t>& levelOffsets,
+		VulkanCommandPool* cmdPool)
+	{
+		if (levelOffsets.size() != m_MipLevels || m_GenerateMips)
+		{
+			LOG_ERROR("UploadMipLevels: {} levels supplied for a texture with {} (generateMips {})",
+				levelOffsets.size(), m_MipLevels, m_GenerateMips);
+			return false;
+		}
+
+		// Extents are in texels; a block-compressed mip smaller than its
+		// block is still copied as the whole (partial) block
+		std::vector<VkBufferImageCopy> regions(levelOffsets.size());
+		for (uint32_t level = 0; level < regions.size(); ++level)
+		{
+			VkBufferImageCopy& region = regions[level];
+			region.bufferOffset = levelOffsets[level];
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = level;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = m_ArrayLayers;
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { std::max(1u, m_Width >> level), std::max(1u, m_Height >> level),
+				std::max(1u, m_Depth >> level) };
+		}
+
+		return UploadRegions(data, size, regions, cmdPool);
+	}
+
+	bool VulkanTexture::UploadRegions(const void* data, size_t size, const std::vector<VkBufferImageCopy>& regions,
+		VulkanCommandPool* cmdPool)
 	{
 		if (!data || size == 0 || !cmdPool || !m_ImageAllocation)
 		{
@@ -85,77 +141,31 @@ namespace Nightbloom
 			return false;
 		}
 
-		// If you can sanity-check byte size vs image extent, do it here (optional):
-		// const size_t expected = size_t(m_Width) * m_Height * m_Depth * BytesPerPixel(m_Format) * m_ArrayLayers;
-		// if (size < expected) { LOG_WARN("UploadData: provided size < expected image size"); }
-
-		// Try to use the shared staging pool first
-		if (m_MemoryManager)
+		// Queued on the upload manager. The copy may run on the transfer
+		// queue; mips and the final layout are done on the graphics queue.
+		if (VulkanUploadManager* uploads = m_MemoryManager ? m_MemoryManager->GetUploadManager() : nullptr)
 		{
-			StagingBufferPool* pool = m_MemoryManager->GetStagingPool();
-			if (pool)
-			{
-				const bool success = pool->WithStagingBuffer(size,
-					[&](VulkanBuffer* stagingBuffer) -> bool
-					{
-						// Upload CPU data into the pooled staging buffer
-						if (!stagingBuffer->Update(data, size, /*dstOffset*/ 0))
-						{
-							LOG_ERROR("Failed to update pooled staging buffer");
-							return false;
-						}
-
-						// Record copy into the texture
-						VulkanSingleTimeCommand cmd(m_Device, cmdPool);
-						VkCommandBuffer commandBuffer = cmd.Begin();
-
-						// Transition to transfer dst
-						TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-						VkBufferImageCopy region{};
-						region.bufferOffset = 0;
-						region.bufferRowLength = 0;      // tightly packed
-						region.bufferImageHeight = 0;    // tightly packed
-						region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-						region.imageSubresource.mipLevel = 0;
-						region.imageSubresource.baseArrayLayer = 0;
-						region.imageSubresource.layerCount = m_ArrayLayers;
-						region.imageOffset = { 0, 0, 0 };
-						region.imageExtent = { m_Width, m_Height, m_Depth };
-
-						vkCmdCopyBufferToImage(
-							commandBuffer,
-							stagingBuffer->GetBuffer(),
-							m_ImageAllocation->image,
-							VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-							1,
-							&region
-						);
-
-						//Generate mipmaps if requested
-						if (m_GenerateMips && m_MipLevels > 1)
-						{
-							GenerateMipmaps(commandBuffer);
-						}
-						else
-						{
-							// Transition to shader-read
-							TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-						}
-
-						cmd.End();
-						return true;
-					});
-
-				return success;
-			}
-			else
+			// UploadImage moves the whole image to TRANSFER_DST before the
+			// callback runs (immediately, when no batch is open)
+			const VkImageLayout previousLayout = m_CurrentLayout;
+			m_CurrentLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+			if (!uploads->UploadImage(m_ImageAllocation->image, data, size, regions, m_MipLevels, m_ArrayLayers,
+				[this](VkCommandBuffer commandBuffer)
+				{
+					if (m_GenerateMips && m_MipLevels > 1)
+						GenerateMipmaps(commandBuffer);
+					else
+						TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+				}))
 			{
-				LOG_WARN("No staging pool available, falling back to temporary staging buffer");
+				m_CurrentLayout = previousLayout;
+				return false;
 			}
+			return true;
 		}
 
-		// ---- Fallback path: create a one-off staging buffer with VMA (your existing code) ----
+		// Blocking fallback (no upload manager): one-off staging buffer
 		VulkanBuffer stagingBuffer(m_Device, m_MemoryManager);
 		BufferDesc stagingDesc;
 		stagingDesc.usage = BufferUsage::Staging;
@@ -180,24 +190,13 @@ namespace Nightbloom
 
 		TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = m_ArrayLayers;
-		region.imageOffset = { 0, 0, 0 };
-		region.imageExtent = { m_Width, m_Height, m_Depth };
-
 		vkCmdCopyBufferToImage(
 			commandBuffer,
 			stagingBuffer.GetBuffer(),
 			m_ImageAllocation->image,
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			1,
-			&region
+			static_cast<uint32_t>(regions.size()),
+			regions.data()
 		);
 
 		if (m_GenerateMips && m_MipLevels > 1)
@@ -234,21 +233,123 @@ namespace Nightbloom
 			return true;  // Already created, that's fine
 		}
 
-		// Allocate a dedicated descriptor set for this texture
-		m_DescriptorSet = descriptorManager->AllocateTextureDescriptorSet();
+		// Through the set cache: anything else asking for this view + sampler
+		// gets the same set instead of a new allocation and write
+		VulkanDescriptorManager::DescriptorWrite write;
+		write.binding = 0;
+		write.imageView = m_ImageView;
+		write.sampler = m_Sampler;
+
+		m_DescriptorSet = descriptorManager->AcquireCachedSet(descriptorManager->GetTextureSetLayout(), { write });
 		if (m_DescriptorSet == VK_NULL_HANDLE)
 		{
 			LOG_ERROR("Failed to allocate descriptor set for texture");
 			return false;
 		}
 
-		m_DescriptorManager = descriptorManager;  // remembered so Cleanup() can free the set
+		m_DescriptorManager = descriptorManager;  // remembered so Cleanup() can release the set
 
 		LOG_INFO("CreateDescriptorSet: texture {}x{}x{} force3D={} → set={:p}",
 			m_Width, m_Height, m_Depth, m_Force3D, (void*)m_DescriptorSet);
 
-		descriptorManager->UpdateTextureSet(m_DescriptorSet, this);
+		return true;
+	}
+
+	bool VulkanTexture::RegisterBindless(VulkanDescriptorManager* descriptorManager)
+	{
+		if (!descriptorManager || !descriptorManager->IsBindlessEnabled())
+			return false;
+		if (m_BindlessIndex != BindlessIndexAllocator::INVALID_INDEX)
+			return true;
 
+		if (!m_ImageView || !m_Sampler)
+		{
+			LOG_ERROR("Cannot register bindless texture: texture not fully initialized");
+			return false;
+		}
+
+		m_BindlessIndex = descriptorManager->RegisterBindlessTexture(this);
+		if (m_BindlessIndex == BindlessIndexAllocator::INVALID_INDEX)
+			return false;
+
+		m_DescriptorManager = descriptorManager;
+		return true;
+	}
+
+	bool VulkanTexture::AdoptImage(VulkanTexture& replacement, VulkanDeletionQueue* deletionQueue)
+	{
+		if (!deletionQueue || !replacement.m_ImageAllocation || replacement.m_DescriptorManager)
+		{
+			LOG_ERROR("AdoptImage: replacement must be initialized, without a descriptor set or bindless slot");
+			return false;
+		}
+
+		// Everything the old image was reachable through, released once no
+		// frame submitted so far can sample it
+		VkDevice device = m_Device->GetDevice();
+		VulkanMemoryManager* memoryManager = m_MemoryManager;
+		VulkanDescriptorManager* descriptorManager = m_DescriptorManager;
+		VulkanMemoryManager::ImageAllocation* oldAllocation = m_ImageAllocation;
+		VkImageView oldView = m_ImageView;
+		VkImageView oldStorageView = m_StorageImageView;
+		std::vector<VkImageView> oldMipViews = std::move(m_MipViews);
+		VkDescriptorSet oldSet = m_DescriptorSet;
+		uint32_t oldBindlessIndex = m_BindlessIndex;
+
+		deletionQueue->Defer([=]()
+			{
+				if (descriptorManager)
+				{
+					if (oldSet != VK_NULL_HANDLE)
+						descriptorManager->ReleaseCachedSet(oldSet);
+					descriptorManager->ReleaseBindlessTexture(oldBindlessIndex);
+				}
+				if (oldStorageView != VK_NULL_HANDLE)
+					vkDestroyImageView(device, oldStorageView, nullptr);
+				for (VkImageView view : oldMipViews)
+					vkDestroyImageView(device, view, nullptr);
+				if (oldView != VK_NULL_HANDLE)
+					vkDestroyImageView(device, oldView, nullptr);
+				if (oldAllocation)
+					memoryManager->DestroyImage(oldAllocation);
+			});
+
+		m_ImageAllocation = replacement.m_ImageAllocation;
+		m_ImageView = replacement.m_ImageView;
+		m_StorageImageView = replacement.m_StorageImageView;
+		m_MipViews = std::move(replacement.m_MipViews);
+		m_Sampler = replacement.m_Sampler;
+		m_CurrentLayout = replacement.m_CurrentLayout;
+		m_Width = replacement.m_Width;
+		m_Height = replacement.m_Height;
+		m_Depth = replacement.m_Depth;
+		m_MipLevels = replacement.m_MipLevels;
+		m_ArrayLayers = replacement.m_ArrayLayers;
+		m_Format = replacement.m_Format;
+		m_Usage = replacement.m_Usage;
+		m_GenerateMips = replacement.m_GenerateMips;
+		m_Force3D = replacement.m_Force3D;
+		m_MemoryPriority = replacement.m_MemoryPriority;
+		m_Sparse = replacement.m_Sparse;
+
+		replacement.m_ImageAllocation = nullptr;
+		replacement.m_ImageView = VK_NULL_HANDLE;
+		replacement.m_StorageImageView = VK_NULL_HANDLE;
+		replacement.m_MipViews.clear();
+		replacement.m_Sampler = VK_NULL_HANDLE;
+
+		m_DescriptorSet = VK_NULL_HANDLE;
+		m_BindlessIndex = BindlessIndexAllocator::INVALID_INDEX;
+		m_DescriptorManager = nullptr;
+		if (!descriptorManager)
+			return true;
+
+		// The image has changed either way; failing here only leaves the
+		// texture without a way to be sampled, like a failed load
+		if (oldBindlessIndex != BindlessIndexAllocator::INVALID_INDEX && !RegisterBindless(descriptorManager))
+			LOG_ERROR("AdoptImage: no bindless slot for the new image");
+		if (oldSet != VK_NULL_HANDLE && !CreateDescriptorSet(descriptorManager))
+			LOG_ERROR("AdoptImage: no descriptor set for the new image");
 		return true;
 	}
 
@@ -286,6 +387,23 @@ namespace Nightbloom
 			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 			destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 		}
+		else if (m_CurrentLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+			newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+		{
+			// Earlier frames may still be sampling it (terrain reads in the vertex stage)
+			barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			sourceStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+		else if (m_CurrentLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL &&
+			newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			barrier.srcAccessMask = 0;  // reads only, nothing to make available
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			destinationStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		}
 		else
 		{
 			LOG_WARN("Unsupported layout transition from {} to {}",
@@ -305,23 +423,69 @@ namespace Nightbloom
 		m_CurrentLayout = newLayout;
 	}
 
+	void VulkanTexture::RecordReadback(VkCommandBuffer cmd, VkBuffer buffer)
+	{
+		if (m_CurrentLayout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL || buffer == VK_NULL_HANDLE)
+		{
+			LOG_WARN("VulkanTexture::RecordReadback: texture not sampler-ready (layout {})",
+				static_cast<int>(m_CurrentLayout));
+			return;
+		}
+
+		TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;    // tightly packed
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { m_Width, m_Height, m_Depth };
+
+		vkCmdCopyImageToBuffer(cmd, m_ImageAllocation->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			buffer, 1, &region);
+
+		// Make the copy available to the host; the fence wait does the rest
+		VkBufferMemoryBarrier hostBarrier{};
+		hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.buffer = buffer;
+		hostBarrier.offset = 0;
+		hostBarrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+			0,
+			0, nullptr,
+			1, &hostBarrier,
+			0, nullptr);
+
+		TransitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
 	void VulkanTexture::Cleanup()
 	{
 		VkDevice device = m_Device ? m_Device->GetDevice() : VK_NULL_HANDLE;
 		if (device == VK_NULL_HANDLE) return;
 
-		if (m_DescriptorSet != VK_NULL_HANDLE && m_DescriptorManager)
+		if (m_DescriptorManager)
 		{
-			m_DescriptorManager->FreeDescriptorSet(m_DescriptorSet);
-			m_DescriptorSet = VK_NULL_HANDLE;
+			if (m_DescriptorSet != VK_NULL_HANDLE)
+				m_DescriptorManager->ReleaseCachedSet(m_DescriptorSet);
+			m_DescriptorManager->ReleaseBindlessTexture(m_BindlessIndex);
 			m_DescriptorManager = nullptr;
 		}
+		m_DescriptorSet = VK_NULL_HANDLE;
+		m_BindlessIndex = BindlessIndexAllocator::INVALID_INDEX;
 
-		if (m_Sampler != VK_NULL_HANDLE)
-		{
-			vkDestroySampler(device, m_Sampler, nullptr);
-			m_Sampler = VK_NULL_HANDLE;
-		}
+		// Shared through the device's sampler cache, which owns it
+		m_Sampler = VK_NULL_HANDLE;
 
 		if (m_StorageImageView != VK_NULL_HANDLE)
 		{
@@ -329,6 +493,10 @@ namespace Nightbloom
 			m_StorageImageView = VK_NULL_HANDLE;
 		}
 
+		for (VkImageView view : m_MipViews)
+			vkDestroyImageView(device, view, nullptr);
+		m_MipViews.clear();
+
 		if (m_ImageView != VK_NULL_HANDLE)
 		{
 			vkDestroyImageView(device, m_ImageView, nullptr);
@@ -357,6 +525,7 @@ namespace Nightbloom
 		imageInfo.memoryUsage = VMA_MEMORY_USAGE_AUTO;
 
 		imageInfo.force3D = m_Force3D;
+		imageInfo.priority = m_MemoryPriority;
 
 		// Set usage flags
 		if (static_cast<int>(m_Usage) & static_cast<int>(TextureUsage::Sampled))
@@ -371,15 +540,24 @@ namespace Nightbloom
 		// Always allow transfers for uploads
 		imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-		if (m_GenerateMips && m_MipLevels > 1)
+		if ((m_GenerateMips && m_MipLevels > 1)
+			|| (static_cast<int>(m_Usage) & static_cast<int>(TextureUsage::Transfer)))
 		{
 			imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 		}
 
-		m_ImageAllocation = m_MemoryManager->CreateImage(imageInfo);
+		if (m_Sparse)
+			m_ImageAllocation = m_MemoryManager->CreateSparseImage(imageInfo);
+		if (!m_ImageAllocation)
+			m_ImageAllocation = m_MemoryManager->CreateImage(imageInfo);
 		return m_ImageAllocation != nullptr;
 	}
 
+	bool VulkanTexture::CommitSparsePages()
+	{
+		return m_MemoryManager->CommitSparseResidency(m_ImageAllocation, m_Device->GetGraphicsTimeline());
+	}
+
 	bool VulkanTexture::CreateImageView()
 	{
 		if (!m_ImageAllocation) return false;
@@ -416,6 +594,24 @@ namespace Nightbloom
 			}
 		}
 
+		const bool storage = static_cast<int>(m_Usage) & static_cast<int>(TextureUsage::Storage);
+		if (storage && m_MipLevels > 1 && !m_Force3D && m_Depth == 1 && m_ArrayLayers == 1)
+		{
+			VkImageViewCreateInfo mipViewInfo = viewInfo;
+			mipViewInfo.subresourceRange.levelCount = 1;
+			for (uint32_t mip = 0; mip < m_MipLevels; ++mip)
+			{
+				mipViewInfo.subresourceRange.baseMipLevel = mip;
+				VkImageView view = VK_NULL_HANDLE;
+				if (vkCreateImageView(m_Device->GetDevice(), &mipViewInfo, nullptr, &view) != VK_SUCCESS)
+				{
+					LOG_ERROR("Failed to create storage view for mip {}", mip);
+					return false;
+				}
+				m_MipViews.push_back(view);
+			}
+		}
+
 		return true;
 	}
 
@@ -452,15 +648,13 @@ namespace Nightbloom
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0;
-		samplerInfo.maxLod = (m_MipLevels > 0) ? float(m_MipLevels - 1) : 0.0f;
-		// test this samplerInfo.maxLod = static_cast<float>(m_MipLevels); 
+		// No per-texture clamp: the image view already limits sampling to
+		// this texture's mips (and a streamed texture's resident ones), so
+		// every texture maps to the same cached sampler
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-		if (vkCreateSampler(m_Device->GetDevice(), &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS)
-		{
-			return false;
-		}
-
-		return true;
+		m_Sampler = m_Device->GetSamplerCache()->GetSampler(samplerInfo);
+		return m_Sampler != VK_NULL_HANDLE;
 	}
 
 	void VulkanTexture::GenerateMipmaps(VkCommandBuffer cmd)
@@ -620,6 +814,14 @@ namespace Nightbloom
 		case TextureFormat::Depth32F: return VK_FORMAT_D32_SFLOAT;
 		case TextureFormat::Depth16: return VK_FORMAT_D16_UNORM;
 
+		case TextureFormat::BC1_RGB: return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case TextureFormat::BC1_RGBA: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case TextureFormat::BC3_RGBA: return VK_FORMAT_BC3_UNORM_BLOCK;
+		case TextureFormat::BC7_RGBA: return VK_FORMAT_BC7_UNORM_BLOCK;
+		case TextureFormat::BC4_R: return VK_FORMAT_BC4_UNORM_BLOCK;
+		case TextureFormat::BC5_RG: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case TextureFormat::ASTC_4x4_RGBA: return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+
 		default:
 			LOG_WARN("Unknown texture format, defaulting to RGBA8");
 			return VK_FORMAT_R8G8B8A8_UNORM;
@@ -7,6 +7,8 @@
 #include "Engine/Renderer/RenderDevice.hpp"
 #include <vulkan/vulkan.h>
 #include "Engine/Renderer/Vulkan/VulkanMemoryManager.hpp"
+#include "Engine/Renderer/Vulkan/BindlessIndexAllocator.hpp"
+#include <vector>
 
 namespace Nightbloom
 {
@@ -14,6 +16,7 @@ namespace Nightbloom
 	class VulkanMemoryManager;
 	class VulkanCommandPool;
 	class VulkanDescriptorManager;
+	class VulkanDeletionQueue;
 
 	class VulkanTexture : public Texture
 	{
@@ -25,8 +28,29 @@ namespace Nightbloom
 
 		bool UploadData(const void* data, size_t, VulkanCommandPool* cmdPool);
 
+		// Uploads a precomputed mip chain (e.g. block-compressed KTX2 levels,
+		// or a packed noise volume - 3D levels halve their depth too):
+		// levelOffsets[i] is where mip i starts in data, tightly packed. The
+		// texture must have been created with that many mip levels and
+		// generateMips off.
+		bool UploadMipLevels(const void* data, size_t size, const std::vector<size_t>& levelOffsets,
+			VulkanCommandPool* cmdPool);
+
 		bool CreateDescriptorSet(VulkanDescriptorManager* descriptorManager);
 
+		// Takes a slot in the bindless texture array (no-op without one, or
+		// if this texture already has a slot)
+		bool RegisterBindless(VulkanDescriptorManager* descriptorManager);
+
+		// Swaps in `replacement`'s image, views and sampler (a streamed
+		// texture changing its resident mips, see TextureStreamer), leaving
+		// `replacement` empty. Frames in flight may still sample the old
+		// image: it, its descriptor set and its bindless slot are released
+		// through `deletionQueue`, and this texture gets a new set / slot if
+		// it had them - GetBindlessIndex() changes. `replacement` must not
+		// have a set or slot of its own; false (nothing changed) otherwise.
+		bool AdoptImage(VulkanTexture& replacement, VulkanDeletionQueue* deletionQueue);
+
 		// Texture interface implementation
 		uint32_t GetWidth() const override { return m_Width; }
 		uint32_t GetHeight() const override { return m_Height; }
@@ -42,15 +66,43 @@ namespace Nightbloom
 		VkImageLayout GetCurrentLayout() const { return m_CurrentLayout; }
 		VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
 
-		// Returns 3D view for compute writes, falls back to m_ImageView for true 3D textures
+		// Returns 3D view for compute writes, falls back to m_ImageView for true 3D textures.
+		// Mipped storage textures write through their mip 0 view: a storage
+		// image descriptor may only cover one level.
 		VkImageView GetStorageImageView() const {
-			return m_StorageImageView != VK_NULL_HANDLE ? m_StorageImageView : m_ImageView;
+			if (m_StorageImageView != VK_NULL_HANDLE) return m_StorageImageView;
+			return m_MipViews.empty() ? m_ImageView : m_MipViews[0];
+		}
+
+		// Single-level 2D view of `mip` for storage writes (MipGenerator).
+		// Only mipped 2D textures with TextureUsage::Storage have these.
+		VkImageView GetMipStorageView(uint32_t mip) const {
+			return mip < m_MipViews.size() ? m_MipViews[mip] : VK_NULL_HANDLE;
 		}
 
 		bool HasDescriptorSet() const { return m_DescriptorSet != VK_NULL_HANDLE; }
 
+		uint32_t GetBindlessIndex() const { return m_BindlessIndex; }
+		bool HasBindlessIndex() const { return m_BindlessIndex != BindlessIndexAllocator::INVALID_INDEX; }
+
 		void TransitionLayout(VkCommandBuffer cmd, VkImageLayout newLayout);
 
+		// Records a copy of mip 0 / layer 0 into `buffer` (tightly packed,
+		// needs TRANSFER_DST usage) that the host may read once this command
+		// buffer's fence has signalled. The texture must be sampler-ready
+		// (SHADER_READ_ONLY_OPTIMAL) and created with TextureUsage::Transfer;
+		// it is left sampler-ready again.
+		void RecordReadback(VkCommandBuffer cmd, VkBuffer buffer);
+
+		// A sparse texture's pages (null when it was allocated whole): request
+		// the texels about to be written or sampled each frame, then
+		// CommitSparsePages, before recording anything that touches them.
+		// Pages not requested lose their contents.
+		SparsePageTable* GetSparsePages() const {
+			return m_ImageAllocation && m_ImageAllocation->sparse ? &m_ImageAllocation->sparse->pages : nullptr;
+		}
+		bool CommitSparsePages();
+
 		// Allow external code (e.g. compute barriers) to update the tracked layout
 		// after performing transitions outside of TransitionLayout()
 		void SetCurrentLayout(VkImageLayout layout) { m_CurrentLayout = layout; }
@@ -61,6 +113,8 @@ namespace Nightbloom
 		bool CreateImageView();
 		bool CreateSampler();
 		void GenerateMipmaps(VkCommandBuffer cmd);
+		bool UploadRegions(const void* data, size_t size, const std::vector<VkBufferImageCopy>& regions,
+			VulkanCommandPool* cmdPool);
 		static uint32_t CalculateMipLevels(uint32_t width, uint32_t heights);
 
 		VkFormat ConvertToVkFormat(TextureFormat format);
@@ -77,9 +131,11 @@ namespace Nightbloom
 		VkSampler m_Sampler = VK_NULL_HANDLE;
 		VkImageLayout m_CurrentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		VkDescriptorSet m_DescriptorSet = VK_NULL_HANDLE;
-		VulkanDescriptorManager* m_DescriptorManager = nullptr;  // set by CreateDescriptorSet, used to free m_DescriptorSet on cleanup
+		uint32_t m_BindlessIndex = BindlessIndexAllocator::INVALID_INDEX;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;  // set by CreateDescriptorSet/RegisterBindless, used to free both on cleanup
 
 		VkImageView m_StorageImageView = VK_NULL_HANDLE;  // 3D view for compute (only when force3D && depth==1)
+		std::vector<VkImageView> m_MipViews;               // per-level views (mipped 2D storage textures only)
 
 		// Properties
 		uint32_t m_Width = 0;
@@ -91,5 +147,7 @@ namespace Nightbloom
 		TextureUsage m_Usage = TextureUsage::Sampled;
 		bool m_GenerateMips = false;
 		bool m_Force3D = false;
+		GpuMemoryPriority m_MemoryPriority = GpuMemoryPriority::Default;
+		bool m_Sparse = false;
 	};
 } // namespace Nightbloom
\ No newline at end of file
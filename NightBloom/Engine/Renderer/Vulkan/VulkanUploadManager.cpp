@@ -0,0 +1,533 @@
+//------------------------------------------------------------------------------
+// VulkanUploadManager.cpp
+//------------------------------------------------------------------------------
+
+#include "VulkanUploadManager.hpp"
+#include "VulkanDevice.hpp"
+#include "VulkanMemoryManager.hpp"
+#include "VulkanBuffer.hpp"
+#include "VulkanCommandPool.hpp"
+#include "VulkanQueueTimeline.hpp"
+#include "Engine/Renderer/Components/GpuProfiler.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include "Core/Logger/Logger.hpp"
+#include "Core/CpuProfiler.hpp"
+#include <limits>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Covers the texel size of every TextureFormat and the 4-byte
+		// bufferOffset rule of vkCmdCopyBufferToImage
+		constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+		VkCommandBuffer BeginOneTime(VulkanCommandPool* pool)
+		{
+			VkCommandBuffer cmd = pool->AllocateCommandBuffer();
+			if (cmd == VK_NULL_HANDLE)
+				return VK_NULL_HANDLE;
+
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			vkBeginCommandBuffer(cmd, &beginInfo);
+			return cmd;
+		}
+	}
+
+	VulkanUploadManager::VulkanUploadManager(VulkanDevice* device, VulkanMemoryManager* memoryManager)
+		: m_Device(device), m_MemoryManager(memoryManager)
+	{
+	}
+
+	VulkanUploadManager::~VulkanUploadManager()
+	{
+		Shutdown();
+	}
+
+	bool VulkanUploadManager::Initialize()
+	{
+		m_Dedicated = m_Device->HasDedicatedTransferQueue();
+		m_TransferFamily = m_Device->GetTransferQueueFamily();
+		m_GraphicsFamily = m_Device->GetGraphicsQueueFamily();
+
+		m_GraphicsPool = std::make_unique<VulkanCommandPool>(m_Device);
+		if (!m_GraphicsPool->Initialize(m_GraphicsFamily, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT))
+		{
+			LOG_ERROR("Failed to create upload command pool");
+			return false;
+		}
+
+		if (m_Dedicated)
+		{
+			m_TransferPool = std::make_unique<VulkanCommandPool>(m_Device);
+			if (!m_TransferPool->Initialize(m_TransferFamily, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT))
+			{
+				LOG_WARN("Failed to create transfer-queue command pool - uploading on the graphics queue");
+				m_TransferPool.reset();
+				m_Dedicated = false;
+			}
+		}
+
+		LOG_INFO("Upload manager initialized ({})",
+			m_Dedicated ? "dedicated transfer queue" : "graphics queue");
+		return true;
+	}
+
+	void VulkanUploadManager::Shutdown()
+	{
+		if (!m_GraphicsPool)
+			return;
+
+		Flush();
+		WaitAll();
+		RetireCompleted();
+
+		if (m_OpenBatch)
+		{
+			CancelProfileScope(*m_OpenBatch);
+			DestroyBatch(*m_OpenBatch);
+			m_OpenBatch.reset();
+		}
+
+		m_TransferPool.reset();
+		m_GraphicsPool.reset();
+	}
+
+	bool VulkanUploadManager::EnsureOpenBatch()
+	{
+		if (m_OpenBatch)
+			return true;
+
+		// Opportunistic: free finished staging before allocating more
+		RetireCompleted();
+
+		auto batch = std::make_unique<Batch>();
+		batch->graphicsCmd = BeginOneTime(m_GraphicsPool.get());
+		if (batch->graphicsCmd == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("Failed to allocate upload command buffer");
+			return false;
+		}
+
+		if (m_Dedicated)
+		{
+			batch->transferCmd = BeginOneTime(m_TransferPool.get());
+
+			VkSemaphoreCreateInfo semaphoreInfo{};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			if (batch->transferCmd == VK_NULL_HANDLE ||
+				vkCreateSemaphore(m_Device->GetDevice(), &semaphoreInfo, nullptr, &batch->transferDone) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to begin transfer-queue upload batch");
+				DestroyBatch(*batch);
+				return false;
+			}
+		}
+
+		if (m_Profiler)
+		{
+			batch->profileScope = m_Profiler->BeginTransferScope(
+				m_Dedicated ? batch->transferCmd : batch->graphicsCmd,
+				m_Dedicated ? m_TransferFamily : m_GraphicsFamily, "Upload Batch");
+		}
+
+		m_OpenBatch = std::move(batch);
+		return true;
+	}
+
+	void VulkanUploadManager::SetProfiler(GpuProfiler* profiler)
+	{
+		if (profiler == m_Profiler)
+			return;
+
+		// Spans of the current profiler's pool must be finished before it
+		// can go away
+		if (m_Profiler)
+		{
+			Flush();
+			WaitAll();
+
+			// An open batch with nothing queued yet already wrote its begin
+			// timestamp; drop it, the next upload opens a fresh one
+			if (m_OpenBatch)
+			{
+				CancelProfileScope(*m_OpenBatch);
+				DestroyBatch(*m_OpenBatch);
+				m_OpenBatch.reset();
+			}
+		}
+		m_Profiler = profiler;
+	}
+
+	void VulkanUploadManager::CancelProfileScope(Batch& batch)
+	{
+		if (m_Profiler)
+			m_Profiler->CancelTransferScope(batch.profileScope);
+		batch.profileScope = UINT32_MAX;
+	}
+
+	VkCommandBuffer VulkanUploadManager::CopyCommandBuffer() const
+	{
+		return m_Dedicated ? m_OpenBatch->transferCmd : m_OpenBatch->graphicsCmd;
+	}
+
+	bool VulkanUploadManager::Stage(const void* data, VkDeviceSize size, VkBuffer& outBuffer, VkDeviceSize& outOffset)
+	{
+		VulkanStagingRing* ring = m_MemoryManager->GetStagingRing();
+		if (ring && size <= ring->GetMaxAllocation())
+		{
+			VkDeviceSize offset = 0;
+			bool written = ring->Write(data, size, STAGING_ALIGNMENT, offset);
+			if (!written)
+			{
+				// Ring full: submit what this batch staged so far, then wait
+				// on the oldest batches until enough of it comes back
+				if (m_OpenBatch->usesRing)
+				{
+					Flush();
+					if (!EnsureOpenBatch())
+						return false;
+				}
+				while (!written && !m_InFlight.empty())
+				{
+					Wait(m_InFlight.front().token);
+					written = ring->Write(data, size, STAGING_ALIGNMENT, offset);
+				}
+			}
+
+			if (written)
+			{
+				m_OpenBatch->usesRing = true;
+				outBuffer = ring->GetBuffer();
+				outOffset = offset;
+				return true;
+			}
+		}
+
+		// Oversized (or no ring): a buffer of its own, freed with the batch
+		auto staging = std::make_unique<VulkanBuffer>(m_Device, m_MemoryManager);
+
+		BufferDesc desc;
+		desc.usage = BufferUsage::Staging;
+		desc.memoryAccess = MemoryAccess::CpuToGpu;
+		desc.size = size;
+		desc.debugName = "UploadStaging";
+		if (!staging->Initialize(desc) || !staging->Update(data, size, 0))
+		{
+			LOG_ERROR("Failed to stage {} byte upload", size);
+			return false;
+		}
+
+		outBuffer = staging->GetBuffer();
+		outOffset = 0;
+		m_OpenBatch->dedicatedStaging.push_back(std::move(staging));
+		return true;
+	}
+
+	bool VulkanUploadManager::UploadBuffer(VkBuffer dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+	{
+		if (dst == VK_NULL_HANDLE || !data || size == 0 || !EnsureOpenBatch())
+			return false;
+
+		VkBuffer stagingBuffer = VK_NULL_HANDLE;
+		VkDeviceSize stagingOffset = 0;
+		if (!Stage(data, size, stagingBuffer, stagingOffset))
+			return false;
+		RenderStats::Get().Add(RenderCounter::UploadBytes, size);
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = stagingOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(CopyCommandBuffer(), stagingBuffer, dst, 1, &copyRegion);
+
+		if (m_Dedicated)
+		{
+			// Release half of the queue family ownership transfer; Flush
+			// records the matching acquire on the graphics queue
+			VkBufferMemoryBarrier release{};
+			release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			release.dstAccessMask = 0;
+			release.srcQueueFamilyIndex = m_TransferFamily;
+			release.dstQueueFamilyIndex = m_GraphicsFamily;
+			release.buffer = dst;
+			release.offset = dstOffset;
+			release.size = size;
+			m_OpenBatch->bufferAcquires.push_back(release);
+		}
+
+		m_OpenBatch->hasWork = true;
+		FlushIfUnbatched();
+		return true;
+	}
+
+	bool VulkanUploadManager::UploadImage(VkImage dst, const void* data, VkDeviceSize size,
+		const VkBufferImageCopy& region, uint32_t mipLevels, uint32_t arrayLayers,
+		std::function<void(VkCommandBuffer)> finishOnGraphics)
+	{
+		return UploadImage(dst, data, size, std::vector<VkBufferImageCopy>{ region }, mipLevels, arrayLayers,
+			std::move(finishOnGraphics));
+	}
+
+	bool VulkanUploadManager::UploadImage(VkImage dst, const void* data, VkDeviceSize size,
+		const std::vector<VkBufferImageCopy>& regions, uint32_t mipLevels, uint32_t arrayLayers,
+		std::function<void(VkCommandBuffer)> finishOnGraphics)
+	{
+		if (dst == VK_NULL_HANDLE || !data || size == 0 || regions.empty() || !EnsureOpenBatch())
+			return false;
+
+		VkBuffer stagingBuffer = VK_NULL_HANDLE;
+		VkDeviceSize stagingOffset = 0;
+		if (!Stage(data, size, stagingBuffer, stagingOffset))
+			return false;
+		RenderStats::Get().Add(RenderCounter::UploadBytes, size);
+
+		VkCommandBuffer cmd = CopyCommandBuffer();
+
+		VkImageMemoryBarrier toTransfer{};
+		toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		toTransfer.image = dst;
+		toTransfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		toTransfer.subresourceRange.baseMipLevel = 0;
+		toTransfer.subresourceRange.levelCount = mipLevels;
+		toTransfer.subresourceRange.baseArrayLayer = 0;
+		toTransfer.subresourceRange.layerCount = arrayLayers;
+		toTransfer.srcAccessMask = 0;
+		toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+		std::vector<VkBufferImageCopy> stagedRegions = regions;
+		for (VkBufferImageCopy& stagedRegion : stagedRegions)
+			stagedRegion.bufferOffset += stagingOffset;
+		vkCmdCopyBufferToImage(cmd, stagingBuffer, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(stagedRegions.size()), stagedRegions.data());
+
+		if (m_Dedicated)
+		{
+			// Ownership moves without a layout change; finishOnGraphics does the rest
+			VkImageMemoryBarrier release = toTransfer;
+			release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			release.dstAccessMask = 0;
+			release.srcQueueFamilyIndex = m_TransferFamily;
+			release.dstQueueFamilyIndex = m_GraphicsFamily;
+			m_OpenBatch->imageAcquires.push_back(release);
+		}
+
+		if (finishOnGraphics)
+			m_OpenBatch->graphicsWork.push_back(std::move(finishOnGraphics));
+
+		m_OpenBatch->hasWork = true;
+		FlushIfUnbatched();
+		return true;
+	}
+
+	void VulkanUploadManager::BeginBatch()
+	{
+		++m_BatchDepth;
+	}
+
+	UploadToken VulkanUploadManager::EndBatch()
+	{
+		if (m_BatchDepth == 0)
+		{
+			LOG_WARN("VulkanUploadManager::EndBatch without BeginBatch");
+			return m_LastSubmitted;
+		}
+		if (--m_BatchDepth > 0)
+			return m_LastSubmitted;
+		return Flush();
+	}
+
+	void VulkanUploadManager::FlushIfUnbatched()
+	{
+		if (m_BatchDepth == 0)
+			Flush();
+	}
+
+	UploadToken VulkanUploadManager::Flush()
+	{
+		if (!m_OpenBatch || !m_OpenBatch->hasWork)
+			return m_LastSubmitted;
+
+		NB_PROFILE_SCOPE("Upload Flush");
+		Batch& batch = *m_OpenBatch;
+		VkDevice device = m_Device->GetDevice();
+
+		if (m_Dedicated)
+		{
+			// Release everything at once at the end of the transfer work
+			vkCmdPipelineBarrier(batch.transferCmd,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+				0, nullptr,
+				static_cast<uint32_t>(batch.bufferAcquires.size()), batch.bufferAcquires.data(),
+				static_cast<uint32_t>(batch.imageAcquires.size()), batch.imageAcquires.data());
+			if (m_Profiler)
+				m_Profiler->EndTransferScope(batch.transferCmd, batch.profileScope);
+			vkEndCommandBuffer(batch.transferCmd);
+
+			VkSubmitInfo transferSubmit{};
+			transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			transferSubmit.commandBufferCount = 1;
+			transferSubmit.pCommandBuffers = &batch.transferCmd;
+			transferSubmit.signalSemaphoreCount = 1;
+			transferSubmit.pSignalSemaphores = &batch.transferDone;
+			if (vkQueueSubmit(m_Device->GetTransferQueue(), 1, &transferSubmit, VK_NULL_HANDLE) != VK_SUCCESS)
+			{
+				LOG_ERROR("Failed to submit upload batch to the transfer queue");
+				CancelProfileScope(batch);
+				DestroyBatch(batch);
+				m_OpenBatch.reset();
+				return m_LastSubmitted;
+			}
+
+			// Acquire: same barriers, with the access on the graphics side
+			for (VkBufferMemoryBarrier& barrier : batch.bufferAcquires)
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+			}
+			for (VkImageMemoryBarrier& barrier : batch.imageAcquires)
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+			}
+			vkCmdPipelineBarrier(batch.graphicsCmd,
+				VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+				0, nullptr,
+				static_cast<uint32_t>(batch.bufferAcquires.size()), batch.bufferAcquires.data(),
+				static_cast<uint32_t>(batch.imageAcquires.size()), batch.imageAcquires.data());
+		}
+
+		for (auto& work : batch.graphicsWork)
+			work(batch.graphicsCmd);
+
+		// Buffer copies become visible to whatever the next frames do with them
+		VkMemoryBarrier visible{};
+		visible.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		visible.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		visible.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		vkCmdPipelineBarrier(batch.graphicsCmd,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+			1, &visible, 0, nullptr, 0, nullptr);
+		if (m_Profiler && !m_Dedicated)
+			m_Profiler->EndTransferScope(batch.graphicsCmd, batch.profileScope);
+		vkEndCommandBuffer(batch.graphicsCmd);
+
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		VkSubmitInfo graphicsSubmit{};
+		graphicsSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		graphicsSubmit.commandBufferCount = 1;
+		graphicsSubmit.pCommandBuffers = &batch.graphicsCmd;
+		if (m_Dedicated)
+		{
+			graphicsSubmit.waitSemaphoreCount = 1;
+			graphicsSubmit.pWaitSemaphores = &batch.transferDone;
+			graphicsSubmit.pWaitDstStageMask = &waitStage;
+		}
+
+		batch.timelineValue = m_Device->GetGraphicsTimeline()->Submit(graphicsSubmit);
+		if (batch.timelineValue == 0)
+		{
+			LOG_ERROR("Failed to submit upload batch");
+			// The transfer half may already be queued; don't free what it reads
+			vkDeviceWaitIdle(device);
+			CancelProfileScope(batch);
+			DestroyBatch(batch);
+			m_OpenBatch.reset();
+			return m_LastSubmitted;
+		}
+
+		batch.token = m_NextToken++;
+		m_LastSubmitted = batch.token;
+		if (VulkanStagingRing* ring = m_MemoryManager->GetStagingRing(); ring && batch.usesRing)
+			batch.ringEnd = ring->GetHead();
+		// Recorded work is done with; drop the callbacks' captures now
+		batch.graphicsWork.clear();
+		batch.bufferAcquires.clear();
+		batch.imageAcquires.clear();
+
+		m_InFlight.push_back(std::move(batch));
+		m_OpenBatch.reset();
+		return m_LastSubmitted;
+	}
+
+	bool VulkanUploadManager::IsComplete(UploadToken token)
+	{
+		if (token <= m_LastCompleted)
+			return true;
+		RetireCompleted();
+		return token <= m_LastCompleted;
+	}
+
+	void VulkanUploadManager::Wait(UploadToken token)
+	{
+		if (token <= m_LastCompleted)
+			return;
+
+		// Batches complete in submission order: waiting for this one's value
+		// covers everything before it
+		for (const Batch& batch : m_InFlight)
+		{
+			if (batch.token >= token)
+			{
+				m_Device->GetGraphicsTimeline()->Wait(batch.timelineValue);
+				break;
+			}
+		}
+		RetireCompleted();
+	}
+
+	void VulkanUploadManager::RetireCompleted()
+	{
+		if (m_InFlight.empty())
+			return;
+
+		const uint64_t completed = m_Device->GetGraphicsTimeline()->GetCompletedValue();
+		while (!m_InFlight.empty() && m_InFlight.front().timelineValue <= completed)
+		{
+			Retire(m_InFlight.front());
+			m_InFlight.pop_front();
+		}
+	}
+
+	void VulkanUploadManager::Retire(Batch& batch)
+	{
+		// Only completed batches give ring space back: batches retire in
+		// submission order, so everything before ringEnd is done with
+		if (batch.usesRing)
+		{
+			if (VulkanStagingRing* ring = m_MemoryManager->GetStagingRing())
+				ring->Release(batch.ringEnd);
+		}
+
+		m_LastCompleted = batch.token;
+		DestroyBatch(batch);
+	}
+
+	void VulkanUploadManager::DestroyBatch(Batch& batch)
+	{
+		VkDevice device = m_Device->GetDevice();
+
+		batch.dedicatedStaging.clear();
+
+		if (batch.graphicsCmd != VK_NULL_HANDLE)
+			m_GraphicsPool->FreeCommandBuffer(batch.graphicsCmd);
+		if (batch.transferCmd != VK_NULL_HANDLE && m_TransferPool)
+			m_TransferPool->FreeCommandBuffer(batch.transferCmd);
+		if (batch.transferDone != VK_NULL_HANDLE)
+			vkDestroySemaphore(device, batch.transferDone, nullptr);
+
+		batch.graphicsCmd = VK_NULL_HANDLE;
+		batch.transferCmd = VK_NULL_HANDLE;
+		batch.transferDone = VK_NULL_HANDLE;
+	}
+}
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+// VulkanUploadManager.hpp
+//
+// Batched, non-blocking host->device uploads. Copies are recorded into an
+// open batch (staged immediately, so the caller's memory can go away) and
+// submitted together by Flush/EndBatch, which returns an UploadToken instead
+// of waiting. With a dedicated transfer queue the copies run there, then the
+// resources are released to the graphics family and acquired by a small
+// graphics submission that waits on the transfer one; later frame submissions
+// are ordered after that acquire, so no per-resource sync is needed to draw.
+// Without one, the whole batch is a single graphics-queue submission.
+//
+// Staging comes from the memory manager's VulkanStagingRing and is released
+// once the graphics timeline passes the batch's value (RetireCompleted, once
+// per frame); uploads too
+// big for the ring get a dedicated buffer owned by the batch. Not thread-safe:
+// uploads are issued from the main thread.
+//
+// Re-uploading into a resource the GPU may still be reading is the caller's
+// problem, as before (the systems that regenerate data wait idle first).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Nightbloom
+{
+	class VulkanDevice;
+	class VulkanMemoryManager;
+	class VulkanBuffer;
+	class VulkanCommandPool;
+	class GpuProfiler;
+
+	// Monotonic per-submission id. 0 means "nothing was submitted".
+	using UploadToken = uint64_t;
+
+	class VulkanUploadManager
+	{
+	public:
+		VulkanUploadManager(VulkanDevice* device, VulkanMemoryManager* memoryManager);
+		~VulkanUploadManager();
+
+		bool Initialize();
+		void Shutdown();  // waits for every pending batch
+
+		// Queue a copy into a device-local buffer.
+		bool UploadBuffer(VkBuffer dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+		// Queue a copy into mip 0 of an image. The whole image is moved to
+		// TRANSFER_DST_OPTIMAL for the copy (prior contents are discarded).
+		// finishOnGraphics then runs on the graphics queue with the image
+		// still in TRANSFER_DST_OPTIMAL, for blits (mip generation) and the
+		// final layout transition, which the transfer queue can't do.
+		bool UploadImage(VkImage dst, const void* data, VkDeviceSize size, const VkBufferImageCopy& region,
+			uint32_t mipLevels, uint32_t arrayLayers, std::function<void(VkCommandBuffer)> finishOnGraphics);
+
+		// Same, with several regions copied out of one staged blob (e.g. a
+		// precomputed mip chain). Region bufferOffsets are relative to data.
+		bool UploadImage(VkImage dst, const void* data, VkDeviceSize size, const std::vector<VkBufferImageCopy>& regions,
+			uint32_t mipLevels, uint32_t arrayLayers, std::function<void(VkCommandBuffer)> finishOnGraphics);
+
+		// Group uploads into one submission; nests. Uploads outside a batch
+		// are flushed (not waited on) immediately.
+		void BeginBatch();
+		UploadToken EndBatch();
+
+		// Submit whatever is queued. Returns its token (or the last token if
+		// nothing was queued).
+		UploadToken Flush();
+
+		bool IsComplete(UploadToken token);
+		void Wait(UploadToken token);
+		void WaitAll() { Wait(m_LastSubmitted); }
+
+		// Free the staging memory of every batch the GPU has finished.
+		void RetireCompleted();
+
+		bool HasDedicatedTransferQueue() const { return m_Dedicated; }
+		UploadToken GetLastSubmittedToken() const { return m_LastSubmitted; }
+
+		// Times each batch's copies as a transfer-queue span; nullptr stops.
+		// Waits for the batches the previous profiler is timing.
+		void SetProfiler(GpuProfiler* profiler);
+
+	private:
+		struct Batch
+		{
+			UploadToken token = 0;
+			VkCommandBuffer transferCmd = VK_NULL_HANDLE;  // dedicated path only
+			VkCommandBuffer graphicsCmd = VK_NULL_HANDLE;
+			VkSemaphore transferDone = VK_NULL_HANDLE;     // dedicated path only
+			uint64_t timelineValue = 0;                    // graphics timeline, set on submit
+			std::vector<std::unique_ptr<VulkanBuffer>> dedicatedStaging;  // oversized uploads
+			uint64_t ringEnd = 0;   // staging ring head at submit
+			bool usesRing = false;
+			std::vector<VkBufferMemoryBarrier> bufferAcquires;
+			std::vector<VkImageMemoryBarrier> imageAcquires;
+			std::vector<std::function<void(VkCommandBuffer)>> graphicsWork;
+			bool hasWork = false;
+			uint32_t profileScope = UINT32_MAX;  // GpuProfiler transfer span
+		};
+
+		bool EnsureOpenBatch();
+		bool Stage(const void* data, VkDeviceSize size, VkBuffer& outBuffer, VkDeviceSize& outOffset);
+		VkCommandBuffer CopyCommandBuffer() const;
+		void Retire(Batch& batch);
+		void DestroyBatch(Batch& batch);
+		void FlushIfUnbatched();
+		void CancelProfileScope(Batch& batch);
+
+		VulkanDevice* m_Device = nullptr;
+		VulkanMemoryManager* m_MemoryManager = nullptr;
+		std::unique_ptr<VulkanCommandPool> m_TransferPool;  // dedicated path only
+		std::unique_ptr<VulkanCommandPool> m_GraphicsPool;
+		GpuProfiler* m_Profiler = nullptr;
+		bool m_Dedicated = false;
+		uint32_t m_TransferFamily = 0;
+		uint32_t m_GraphicsFamily = 0;
+
+		std::unique_ptr<Batch> m_OpenBatch;
+		std::deque<Batch> m_InFlight;  // in submission order
+		uint32_t m_BatchDepth = 0;
+		UploadToken m_NextToken = 1;
+		UploadToken m_LastSubmitted = 0;
+		UploadToken m_LastCompleted = 0;
+
+		VulkanUploadManager(const VulkanUploadManager&) = delete;
+		VulkanUploadManager& operator=(const VulkanUploadManager&) = delete;
+	};
+
+	// RAII BeginBatch/EndBatch, e.g. around loading every mesh of a model
+	class UploadBatchScope
+	{
+	public:
+		explicit UploadBatchScope(VulkanUploadManager* uploads) : m_Uploads(uploads)
+		{
+			if (m_Uploads) m_Uploads->BeginBatch();
+		}
+		~UploadBatchScope()
+		{
+			if (m_Uploads) m_Uploads->EndBatch();
+		}
+
+		UploadBatchScope(const UploadBatchScope&) = delete;
+		UploadBatchScope& operator=(const UploadBatchScope&) = delete;
+
+	private:
+		VulkanUploadManager* m_Uploads = nullptr;
+	};
+}
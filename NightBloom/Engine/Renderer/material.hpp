@@ -10,6 +10,7 @@
 #include "Engine/Renderer/RenderDevice.hpp"  // For Texture base class
 #include <glm/glm.hpp>
 #include <string>
+#include <cstdint>
 
 namespace Nightbloom
 {
@@ -29,6 +30,7 @@ namespace Nightbloom
 		float GetMetallic() const { return m_Metallic; }
 		PipelineType GetPipeline() const { return m_Pipeline; }
 		bool IsDoubleSided() const { return m_DoubleSided; }
+		uint32_t GetBindlessIndex() const { return m_BindlessIndex; }
 
 		// Setters
 		void SetName(const std::string& name) { m_Name = name; }
@@ -39,6 +41,7 @@ namespace Nightbloom
 		void SetMetallic(float metallic) { m_Metallic = metallic; }
 		void SetPipeline(PipelineType pipeline) { m_Pipeline = pipeline; }
 		void SetDoubleSided(bool doubleSided) { m_DoubleSided = doubleSided; }
+		void SetBindlessIndex(uint32_t index) { m_BindlessIndex = index; }
 
 		// Check if material has a texture
 		bool HasAlbedoTexture() const { return m_AlbedoTexture != nullptr; }
@@ -60,6 +63,9 @@ namespace Nightbloom
 		// Rendering properties
 		PipelineType m_Pipeline = PipelineType::Mesh;
 		bool m_DoubleSided = false;
+
+		// Slot in the renderer's bindless material table (UINT32_MAX = none)
+		uint32_t m_BindlessIndex = UINT32_MAX;
 	};
 
 } // namespace Nightbloom
\ No newline at end of file
@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+// TerrainBrush.hpp
+//
+// Sculpting brushes for the single-heightmap terrain. A brush dab only
+// touches the heightmap texels under it: TerrainSystem::Sculpt turns it into
+// a TerrainBrushStroke (texel space, this frame's amount) which is applied on
+// the GPU by TerrainSculpt.comp and to the CPU height field by
+// ApplyTerrainBrush below - the same arithmetic, so CPU height queries stay
+// on the sculpted surface without reading the heightmap back.
+//
+// Heights stay in the heightmap's normalised [0, 1], so the terrain's height
+// range (and every bound derived from it - quadtree patches, grass patches)
+// still holds after sculpting.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	// Matches the mode constants in TerrainSculpt.comp
+	enum class TerrainBrushMode : uint32_t
+	{
+		Raise = 0,
+		Lower,
+		Smooth,    // towards the 3x3 average
+		Flatten    // towards targetHeight
+	};
+
+	struct TerrainBrush
+	{
+		TerrainBrushMode mode = TerrainBrushMode::Raise;
+		glm::vec2 center = glm::vec2(0.0f);   // world x, z
+		float radius = 10.0f;                 // world units
+		float falloff = 0.5f;                 // outer share of the radius that fades to nothing
+		// Raise / Lower: normalised height per second at the centre.
+		// Smooth / Flatten: share of the way to the target per second.
+		float strength = 0.1f;
+		float targetHeight = 0.5f;            // Flatten, normalised
+	};
+
+	// Heightmap texels (x, y, width, height); empty when the brush misses
+	struct TerrainTexelRect
+	{
+		int32_t x = 0;
+		int32_t y = 0;
+		int32_t width = 0;
+		int32_t height = 0;
+
+		bool IsEmpty() const { return width <= 0 || height <= 0; }
+
+		// Grown by `texels` on every side, clamped to the map
+		TerrainTexelRect Expanded(int32_t texels, uint32_t mapWidth, uint32_t mapHeight) const
+		{
+			const int32_t x0 = std::max(x - texels, 0);
+			const int32_t y0 = std::max(y - texels, 0);
+			const int32_t x1 = std::min(x + width + texels, static_cast<int32_t>(mapWidth));
+			const int32_t y1 = std::min(y + height + texels, static_cast<int32_t>(mapHeight));
+			return { x0, y0, x1 - x0, y1 - y0 };
+		}
+	};
+
+	// One frame's dab in heightmap texel space
+	struct TerrainBrushStroke
+	{
+		TerrainBrushMode mode = TerrainBrushMode::Raise;
+		glm::vec2 centerTexel = glm::vec2(0.0f);   // continuous: texel i's centre is at i + 0.5
+		glm::vec2 texelWorldSize = glm::vec2(1.0f);
+		float radius = 0.0f;                       // world units
+		float falloff = 0.5f;
+		float amount = 0.0f;                       // strength * deltaTime
+		float targetHeight = 0.5f;
+		TerrainTexelRect rect;                     // texels it can change
+	};
+
+	// 1 inside the solid core, easing to 0 at the rim
+	inline float TerrainBrushWeight(float distance, float radius, float falloff)
+	{
+		if (radius <= 0.0f || distance >= radius)
+			return 0.0f;
+		const float inner = radius * (1.0f - std::clamp(falloff, 0.0f, 1.0f));
+		if (distance <= inner)
+			return 1.0f;
+		const float t = (radius - distance) / (radius - inner);
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	// The stroke `brush` makes over `deltaTime` on a width x height heightmap
+	// covering worldSize around terrainCenter (TerrainHeightField's mapping)
+	inline TerrainBrushStroke MakeTerrainBrushStroke(const TerrainBrush& brush, float deltaTime,
+		uint32_t width, uint32_t height, const glm::vec3& terrainCenter, float worldSize)
+	{
+		TerrainBrushStroke stroke;
+		if (width == 0 || height == 0 || worldSize <= 0.0f || brush.radius <= 0.0f)
+			return stroke;
+
+		const glm::vec2 size(static_cast<float>(width), static_cast<float>(height));
+		const glm::vec2 uv = (brush.center - glm::vec2(terrainCenter.x, terrainCenter.z)) / worldSize + 0.5f;
+
+		stroke.mode = brush.mode;
+		stroke.centerTexel = uv * size;
+		stroke.texelWorldSize = glm::vec2(worldSize) / size;
+		stroke.radius = brush.radius;
+		stroke.falloff = brush.falloff;
+		stroke.amount = std::max(brush.strength, 0.0f) * std::max(deltaTime, 0.0f);
+		stroke.targetHeight = std::clamp(brush.targetHeight, 0.0f, 1.0f);
+
+		// Texels whose centres fall inside the radius
+		const glm::vec2 radiusTexels = glm::vec2(brush.radius) / stroke.texelWorldSize;
+		const glm::vec2 lo = glm::ceil(stroke.centerTexel - radiusTexels - 0.5f);
+		const glm::vec2 hi = glm::floor(stroke.centerTexel + radiusTexels - 0.5f);
+		const int32_t x0 = static_cast<int32_t>(std::max(lo.x, 0.0f));
+		const int32_t y0 = static_cast<int32_t>(std::max(lo.y, 0.0f));
+		const int32_t x1 = static_cast<int32_t>(std::min(hi.x + 1.0f, size.x));
+		const int32_t y1 = static_cast<int32_t>(std::min(hi.y + 1.0f, size.y));
+		if (x1 > x0 && y1 > y0)
+			stroke.rect = { x0, y0, x1 - x0, y1 - y0 };
+		return stroke;
+	}
+
+	// Applies `stroke` to the R channel of `texels` (width x height, `stride`
+	// floats apart) in place. Smooth reads the heights as they were before
+	// the stroke, as the shader does from the surface map.
+	inline void ApplyTerrainBrush(float* texels, uint32_t width, uint32_t height, uint32_t stride,
+		const TerrainBrushStroke& stroke)
+	{
+		if (stroke.rect.IsEmpty() || stroke.amount <= 0.0f)
+			return;
+
+		auto at = [&](int32_t x, int32_t y) -> float&
+		{
+			return texels[(static_cast<size_t>(y) * width + x) * stride];
+		};
+
+		// Smooth's source: the rect plus its one-texel border, before any writes
+		const TerrainTexelRect border = stroke.rect.Expanded(1, width, height);
+		std::vector<float> before;
+		if (stroke.mode == TerrainBrushMode::Smooth)
+		{
+			before.reserve(static_cast<size_t>(border.width) * border.height);
+			for (int32_t y = border.y; y < border.y + border.height; ++y)
+				for (int32_t x = border.x; x < border.x + border.width; ++x)
+					before.push_back(at(x, y));
+		}
+		auto original = [&](int32_t x, int32_t y)
+		{
+			x = std::clamp(x, 0, static_cast<int32_t>(width) - 1);
+			y = std::clamp(y, 0, static_cast<int32_t>(height) - 1);
+			return before[static_cast<size_t>(y - border.y) * border.width + (x - border.x)];
+		};
+
+		for (int32_t y = stroke.rect.y; y < stroke.rect.y + stroke.rect.height; ++y)
+		{
+			for (int32_t x = stroke.rect.x; x < stroke.rect.x + stroke.rect.width; ++x)
+			{
+				const glm::vec2 offset = (glm::vec2(static_cast<float>(x), static_cast<float>(y)) + 0.5f
+					- stroke.centerTexel) * stroke.texelWorldSize;
+				const float weight = TerrainBrushWeight(glm::length(offset), stroke.radius, stroke.falloff);
+				if (weight <= 0.0f)
+					continue;
+
+				float& h = at(x, y);
+				const float blend = std::min(stroke.amount * weight, 1.0f);
+				switch (stroke.mode)
+				{
+				case TerrainBrushMode::Raise:
+					h += stroke.amount * weight;
+					break;
+				case TerrainBrushMode::Lower:
+					h -= stroke.amount * weight;
+					break;
+				case TerrainBrushMode::Smooth:
+				{
+					float sum = 0.0f;
+					for (int32_t dy = -1; dy <= 1; ++dy)
+						for (int32_t dx = -1; dx <= 1; ++dx)
+							sum += original(x + dx, y + dy);
+					h += (sum / 9.0f - h) * blend;
+					break;
+				}
+				case TerrainBrushMode::Flatten:
+					h += (stroke.targetHeight - h) * blend;
+					break;
+				}
+				h = std::clamp(h, 0.0f, 1.0f);
+			}
+		}
+	}
+}
@@ -0,0 +1,273 @@
+//------------------------------------------------------------------------------
+// TerrainHeightField.hpp
+//
+// CPU copy of the terrain heightmap for placement, snapping and physics
+// queries. Sampling mirrors what the terrain shaders do on the GPU — same uv
+// mapping and edge clamp (terrain_cdlod.glsl), bilinear filtering with the
+// heightmap sampler's REPEAT addressing, and Terrain.vert's finite-difference
+// normal — so CPU answers land on the surface that is actually drawn (up to
+// the LOD mesh's own interpolation).
+//
+// Sculpting (TerrainBrush.hpp) edits it in place alongside the GPU
+// heightmap, so it never needs reading back again.
+//
+// Positions are world space.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Terrain/TerrainBrush.hpp"
+#include <glm/glm.hpp>
+#include <immintrin.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	class TerrainHeightField
+	{
+	public:
+		// Takes the R channel of `width` x `height` texels spaced `stride`
+		// floats apart (4 for the RGBA32F heightmap readback)
+		void Assign(const float* texels, uint32_t width, uint32_t height, uint32_t stride)
+		{
+			m_Width = width;
+			m_Height = height;
+			m_Heights.resize(static_cast<size_t>(width) * height);
+			for (size_t i = 0; i < m_Heights.size(); ++i)
+			{
+				m_Heights[i] = texels[i * stride];
+			}
+		}
+
+		// Where the heightmap sits in the world — TerrainDesc's position,
+		// worldSize and heightScale
+		void SetPlacement(const glm::vec3& center, float worldSize, float heightScale)
+		{
+			m_Center = center;
+			m_WorldSize = worldSize;
+			m_HeightScale = heightScale;
+		}
+
+		void Clear()
+		{
+			m_Heights.clear();
+			m_Width = m_Height = 0;
+		}
+
+		bool IsValid() const { return m_Width > 1 && m_Height > 1 && m_WorldSize > 0.0f; }
+
+		// World-space surface height at (x, z). Outside the terrain this is
+		// the clamped edge height, as the shaders would produce.
+		float SampleHeight(float x, float z) const
+		{
+			return m_Center.y + SampleUV(ToU(x), ToV(z)) * m_HeightScale;
+		}
+
+		// World-space unit normal at (x, z)
+		glm::vec3 SampleNormal(float x, float z) const
+		{
+			// Terrain.vert: central differences two heightmap texels either side
+			const float sampleStep = 2.0f / static_cast<float>(m_Width - 1);
+			const float u = ToU(x);
+			const float v = ToV(z);
+
+			const float hL = SampleUV(u - sampleStep, v);
+			const float hR = SampleUV(u + sampleStep, v);
+			const float hD = SampleUV(u, v - sampleStep);
+			const float hU = SampleUV(u, v + sampleStep);
+
+			const float worldStep = 2.0f * sampleStep * m_WorldSize;
+			return glm::normalize(glm::vec3(
+				(hL - hR) * m_HeightScale,
+				worldStep,
+				(hD - hU) * m_HeightScale));
+		}
+
+		// SampleHeight for `count` points, four at a time with SSE; matches
+		// the scalar result
+		void SampleHeights(const float* x, const float* z, float* outHeights, size_t count) const
+		{
+			const __m128 invSize = _mm_set1_ps(1.0f / m_WorldSize);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 centerX = _mm_set1_ps(m_Center.x);
+			const __m128 centerZ = _mm_set1_ps(m_Center.z);
+			const __m128 uvMin = _mm_set1_ps(UV_CLAMP_MIN);
+			const __m128 uvMax = _mm_set1_ps(UV_CLAMP_MAX);
+			const __m128 width = _mm_set1_ps(static_cast<float>(m_Width));
+			const __m128 height = _mm_set1_ps(static_cast<float>(m_Height));
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 baseY = _mm_set1_ps(m_Center.y);
+			const __m128 scaleY = _mm_set1_ps(m_HeightScale);
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 u = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(x + i), centerX), invSize), half);
+				__m128 v = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(z + i), centerZ), invSize), half);
+				u = _mm_min_ps(_mm_max_ps(u, uvMin), uvMax);
+				v = _mm_min_ps(_mm_max_ps(v, uvMin), uvMax);
+
+				// Texel space, shifted by +1 so it is positive and truncation
+				// is floor (texel centres sit at +0.5)
+				const __m128 tx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(u, width), half), one);
+				const __m128 ty = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(v, height), half), one);
+				const __m128i ix = _mm_cvttps_epi32(tx);
+				const __m128i iy = _mm_cvttps_epi32(ty);
+				const __m128 fx = _mm_sub_ps(tx, _mm_cvtepi32_ps(ix));
+				const __m128 fy = _mm_sub_ps(ty, _mm_cvtepi32_ps(iy));
+
+				alignas(16) int32_t cx[4], cy[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(cx), ix);
+				_mm_store_si128(reinterpret_cast<__m128i*>(cy), iy);
+
+				// No gather in SSE: fetch the four corners per lane
+				alignas(16) float h00[4], h10[4], h01[4], h11[4];
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					const int32_t x0 = cx[lane] - 1;
+					const int32_t y0 = cy[lane] - 1;
+					h00[lane] = Texel(x0, y0);
+					h10[lane] = Texel(x0 + 1, y0);
+					h01[lane] = Texel(x0, y0 + 1);
+					h11[lane] = Texel(x0 + 1, y0 + 1);
+				}
+
+				const __m128 top = Lerp(_mm_load_ps(h00), _mm_load_ps(h10), fx);
+				const __m128 bottom = Lerp(_mm_load_ps(h01), _mm_load_ps(h11), fx);
+				const __m128 h = Lerp(top, bottom, fy);
+				_mm_storeu_ps(outHeights + i, _mm_add_ps(baseY, _mm_mul_ps(h, scaleY)));
+			}
+
+			for (; i < count; ++i)
+			{
+				outHeights[i] = SampleHeight(x[i], z[i]);
+			}
+		}
+
+		// The stroke TerrainSculpt.comp applies to the heightmap
+		void ApplyBrush(const TerrainBrushStroke& stroke)
+		{
+			if (IsValid())
+				ApplyTerrainBrush(m_Heights.data(), m_Width, m_Height, 1, stroke);
+		}
+
+		// Distance along `direction` (unit length) to where the ray first
+		// meets the surface, within maxDistance. Marches half a texel at a
+		// time through the terrain's box, then bisects the crossing.
+		bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& outDistance) const
+		{
+			if (!IsValid())
+				return false;
+
+			// Slab test against the box the surface lives in
+			const glm::vec3 boxMin(m_Center.x - 0.5f * m_WorldSize, m_Center.y, m_Center.z - 0.5f * m_WorldSize);
+			const glm::vec3 boxMax(m_Center.x + 0.5f * m_WorldSize, m_Center.y + m_HeightScale, m_Center.z + 0.5f * m_WorldSize);
+			float tEnter = 0.0f;
+			float tExit = maxDistance;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (std::abs(direction[axis]) < 1e-8f)
+				{
+					if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+						return false;
+					continue;
+				}
+				float t0 = (boxMin[axis] - origin[axis]) / direction[axis];
+				float t1 = (boxMax[axis] - origin[axis]) / direction[axis];
+				if (t0 > t1) std::swap(t0, t1);
+				tEnter = std::max(tEnter, t0);
+				tExit = std::min(tExit, t1);
+			}
+			if (tEnter > tExit)
+				return false;
+
+			auto above = [&](float t)
+			{
+				const glm::vec3 p = origin + direction * t;
+				return p.y - SampleHeight(p.x, p.z);
+			};
+
+			if (above(tEnter) <= 0.0f)
+			{
+				outDistance = tEnter;
+				return true;
+			}
+
+			const float step = 0.5f * m_WorldSize / static_cast<float>(std::max(m_Width, m_Height));
+			float prev = tEnter;
+			while (prev < tExit)
+			{
+				const float t = std::min(prev + step, tExit);
+				if (above(t) <= 0.0f)
+				{
+					float lo = prev;
+					float hi = t;
+					for (int i = 0; i < 16; ++i)
+					{
+						const float mid = 0.5f * (lo + hi);
+						(above(mid) > 0.0f ? lo : hi) = mid;
+					}
+					outDistance = hi;
+					return true;
+				}
+				prev = t;
+			}
+			return false;
+		}
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+
+	private:
+		// TerrainHeight's clamp in terrain_cdlod.glsl (single-heightmap window)
+		static constexpr float UV_CLAMP_MIN = 0.001f;
+		static constexpr float UV_CLAMP_MAX = 0.999f;
+
+		float ToU(float x) const { return (x - m_Center.x) * (1.0f / m_WorldSize) + 0.5f; }
+		float ToV(float z) const { return (z - m_Center.z) * (1.0f / m_WorldSize) + 0.5f; }
+
+		// Normalised height at heightmap uv, filtered like the GPU sampler
+		float SampleUV(float u, float v) const
+		{
+			u = std::clamp(u, UV_CLAMP_MIN, UV_CLAMP_MAX);
+			v = std::clamp(v, UV_CLAMP_MIN, UV_CLAMP_MAX);
+
+			const float tx = u * static_cast<float>(m_Width) - 0.5f + 1.0f;
+			const float ty = v * static_cast<float>(m_Height) - 0.5f + 1.0f;
+			const int32_t ix = static_cast<int32_t>(tx);
+			const int32_t iy = static_cast<int32_t>(ty);
+			const float fx = tx - static_cast<float>(ix);
+			const float fy = ty - static_cast<float>(iy);
+
+			const int32_t x0 = ix - 1;
+			const int32_t y0 = iy - 1;
+			const float top = Texel(x0, y0) + (Texel(x0 + 1, y0) - Texel(x0, y0)) * fx;
+			const float bottom = Texel(x0, y0 + 1) + (Texel(x0 + 1, y0 + 1) - Texel(x0, y0 + 1)) * fx;
+			return top + (bottom - top) * fy;
+		}
+
+		// REPEAT addressing; x, y are never more than one texel outside
+		float Texel(int32_t x, int32_t y) const
+		{
+			const int32_t w = static_cast<int32_t>(m_Width);
+			const int32_t h = static_cast<int32_t>(m_Height);
+			x = (x < 0) ? x + w : (x >= w ? x - w : x);
+			y = (y < 0) ? y + h : (y >= h ? y - h : y);
+			return m_Heights[static_cast<size_t>(y) * m_Width + x];
+		}
+
+		static __m128 Lerp(__m128 a, __m128 b, __m128 t)
+		{
+			return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+		}
+
+		std::vector<float> m_Heights;
+		uint32_t  m_Width = 0;
+		uint32_t  m_Height = 0;
+		glm::vec3 m_Center = glm::vec3(0.0f);
+		float     m_WorldSize = 200.0f;
+		float     m_HeightScale = 30.0f;
+	};
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// TerrainMaterial.hpp
+//
+// Terrain material weights: how much grass, dirt and rock cover a point,
+// from its height and slope. TerrainSurface.comp bakes them into the
+// material map (one texel per heightmap texel) whenever it rebuilds the
+// surface map. Terrain.frag then fetches them once and samples only the
+// layers that carry weight. TerrainMaterialWeights is the CPU twin of the
+// bake; the two must stay in step.
+//
+// The weights are sharpened, so most of the terrain is a single layer.
+// Weights below TERRAIN_MATERIAL_MIN_WEIGHT are dropped (and the rest
+// renormalised), so those texels bake to exactly one layer and Terrain.frag
+// takes one texture sample there instead of three.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	enum class TerrainMaterialLayer : uint32_t
+	{
+		Grass = 0,
+		Dirt,
+		Rock
+	};
+
+	// Below this a layer is too faint to show, so it is baked as zero
+	constexpr float TERRAIN_MATERIAL_MIN_WEIGHT = 0.02f;
+
+	// Breakup noise (three octaves of grass_field.glsl's Fbm2D over world xz):
+	// world units per noise cell, its seed, and how far it shifts the grass /
+	// dirt boundary
+	constexpr float TERRAIN_MATERIAL_BREAKUP_CELL = 24.0f;
+	constexpr uint32_t TERRAIN_MATERIAL_BREAKUP_SEED = 7919;
+	constexpr float TERRAIN_MATERIAL_BREAKUP_STRENGTH = 0.15f;
+
+	// Grass, dirt and rock weights, summing to 1. normalizedHeight is the
+	// height over the terrain's height range [0,1], normalY the surface
+	// normal's y, and breakup a [0,1] noise value (0.5 = no shift).
+	inline glm::vec3 TerrainMaterialWeights(float normalizedHeight, float normalY, float breakup)
+	{
+		const auto smoothstep = [](float edge0, float edge1, float x)
+		{
+			const float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
+		};
+
+		const float h = std::clamp(normalizedHeight, 0.0f, 1.0f);
+		const float slope = std::clamp((1.0f - normalY) * 1.5f, 0.0f, 1.0f);
+		const float shift = (breakup - 0.5f) * TERRAIN_MATERIAL_BREAKUP_STRENGTH;
+
+		glm::vec3 w(
+			(1.0f - slope) * smoothstep(0.0f, 0.5f, 1.0f - h) + shift,
+			smoothstep(0.2f, 0.5f, h) * (1.0f - slope) - shift * 0.5f,
+			smoothstep(0.2f, 0.6f, slope) + smoothstep(0.6f, 1.0f, h));
+
+		// Sharpen (clamped first: the breakup can push a factor below zero)
+		for (int i = 0; i < 3; ++i)
+			w[i] = std::pow(std::max(w[i], 0.0f), 3.5f);
+
+		float total = w.x + w.y + w.z;
+		if (total <= 0.0f)
+			return glm::vec3(1.0f, 0.0f, 0.0f);
+		w /= total;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			if (w[i] < TERRAIN_MATERIAL_MIN_WEIGHT)
+				w[i] = 0.0f;
+		}
+		total = w.x + w.y + w.z;
+		return w / total;
+	}
+
+	// The layer with the largest weight (the first one on a tie)
+	inline TerrainMaterialLayer TerrainDominantLayer(const glm::vec3& weights)
+	{
+		if (weights.x >= weights.y && weights.x >= weights.z)
+			return TerrainMaterialLayer::Grass;
+		return weights.y >= weights.z ? TerrainMaterialLayer::Dirt : TerrainMaterialLayer::Rock;
+	}
+
+	// Layers Terrain.frag samples for these weights
+	inline uint32_t TerrainMaterialLayerCount(const glm::vec3& weights)
+	{
+		return (weights.x > 0.0f ? 1u : 0u) + (weights.y > 0.0f ? 1u : 0u) + (weights.z > 0.0f ? 1u : 0u);
+	}
+}
@@ -1,21 +1,21 @@
 //------------------------------------------------------------------------------
 // TerrainMesh.hpp
 //
-// Generates a flat NxN grid of VertexPNT vertices (Y = 0).
-// The vertex shader (Terrain.vert) displaces Y at runtime by sampling
-// the heightmap texture — so this mesh never needs to be rebuilt.
+// Generates a flat NxN grid of VertexPNT vertices (Y = 0) on the CPU.
+// The terrain and water no longer draw it: they pull the same grid from
+// gl_VertexIndex with a shared index buffer (GridMesh.hpp). Kept for tools
+// and benchmarks that want the vertices themselves.
 //
 // The grid spans [-halfSize, +halfSize] in X and Z.
-// UV [0,1] maps linearly across the grid — the vertex shader uses these
-// to sample the heightmap.
+// UV [0,1] maps linearly across the grid.
 //
 // Usage:
 //   TerrainMeshData data = TerrainMesh::Generate(128, 200.0f);
-//   // Upload data.vertices and data.indices to GPU buffers
 //------------------------------------------------------------------------------
 #pragma once
 
 #include "Engine/Renderer/Vertex.hpp"
+#include "Engine/Renderer/GridMesh.hpp"
 #include <vector>
 #include <cstdint>
 
@@ -41,86 +41,33 @@ namespace Nightbloom
 		//               Must be >= 2.
 		// worldSize   - total world-space width/depth of the patch (e.g. 200.0)
 		//
-		// Returns a flat grid ready for GPU upload. The vertex shader will
-		// displace Y using the heightmap texture at render time.
+		// alternateDiagonals - flip the quad diagonal in a checkerboard
+		//               (GridMesh::GenerateIndices).
 		//----------------------------------------------------------------------
-		static TerrainMeshData Generate(uint32_t resolution, float worldSize)
+		static TerrainMeshData Generate(uint32_t resolution, float worldSize, bool alternateDiagonals = true)
 		{
 			if (resolution < 2) resolution = 2;
+			const uint32_t quads = resolution - 1;
 
 			TerrainMeshData data;
-			data.vertices.reserve(resolution * resolution);
-			data.indices.reserve((resolution - 1) * (resolution - 1) * 6);
+			data.vertices.reserve(GridMesh::GetVertexCount(quads));
 
 			const float halfSize = worldSize * 0.5f;
-			const float step = worldSize / static_cast<float>(resolution - 1);
-			const float uvStep = 1.0f / static_cast<float>(resolution - 1);
 
-			// ----------------------------------------------------------------
-			// Vertices — flat grid, Y = 0
-			// Normal is up; the vertex shader overwrites this via finite diff
-			// ----------------------------------------------------------------
-
-			for (uint32_t row = 0; row < resolution; ++row)
+			// Normal is up; the terrain shaders compute their own
+			for (uint32_t i = 0; i < GridMesh::GetVertexCount(quads); ++i)
 			{
-				for (uint32_t col = 0; col < resolution; ++col)
-				{
-					VertexPNT v{};
-					v.position	= glm::vec3(
-						-halfSize + col * step,
-						0.0f,
-						-halfSize + row * step
-					);
-					v.normal = glm::vec3(0.0f, 1.0f, 0.0f); // placeholder
-					v.texCoord = glm::vec2(col * uvStep, row * uvStep);
-
-					data.vertices.push_back(v);
-				}
-			}
-
-			// ----------------------------------------------------------------
-			// Indices — two triangles per quad, CCW winding
-			//
-			//  row+1:  tl --- tr
-			//           |  \ |
-			//  row:    bl --- br
-			//
-			// ----------------------------------------------------------------
-			for (uint32_t row = 0; row < resolution - 1; ++row)
-			{
-				for (uint32_t col = 0; col < resolution - 1; ++col)
-				{
-					uint32_t bl = row * resolution + col;
-					uint32_t br = row * resolution + col + 1;
-					uint32_t tl = (row + 1) * resolution + col;
-					uint32_t tr = (row + 1) * resolution + col + 1;
-
-					if ((row + col) % 2 == 0)
-					{
-						// Diagonal: bl → tr
-						data.indices.push_back(bl);
-						data.indices.push_back(tl);
-						data.indices.push_back(br);
-
-						data.indices.push_back(br);
-						data.indices.push_back(tl);
-						data.indices.push_back(tr);
-					}
-					else
-					{
-						// Diagonal: br → tl  (opposite direction)
-						data.indices.push_back(bl);
-						data.indices.push_back(tl);
-						data.indices.push_back(tr);
+				const glm::vec2 uv = GridMesh::GetVertexUV(i, quads);
 
-						data.indices.push_back(bl);
-						data.indices.push_back(tr);
-						data.indices.push_back(br);
-					}
-				}
+				VertexPNT v{};
+				v.position = glm::vec3(-halfSize + uv.x * worldSize, 0.0f, -halfSize + uv.y * worldSize);
+				v.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+				v.texCoord = uv;
+				data.vertices.push_back(v);
 			}
 
+			data.indices = GridMesh::GenerateIndices(quads, alternateDiagonals);
 			return data;
 		}
 	};
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
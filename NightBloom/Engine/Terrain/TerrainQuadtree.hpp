@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+// TerrainQuadtree.hpp
+//
+// CDLOD patch selection (continuous distance-dependent level of detail). The
+// terrain square is a quadtree whose nodes all render with one shared grid
+// mesh scaled to the node. Each LOD level owns a distance range that doubles
+// per level; a node is split while the camera sphere of the next-finer range
+// touches it. Over the last part of its range a level morphs its odd grid
+// vertices onto the next-coarser grid (done in Terrain.vert), so neighbouring
+// levels meet without cracks and switching levels never pops.
+//
+// All positions are terrain-local: the terrain is centred on the origin in
+// XZ, y = 0 is the bottom of the height range.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	// One selected node. Laid out for Terrain.vert's patch buffer (std430,
+	// one 64-byte instance slot each - see terrain_cdlod.glsl).
+	struct TerrainPatch
+	{
+		glm::vec4 offsetSize = glm::vec4(0.0f);  // xy = node min corner (XZ), z = edge length, w = LOD level
+		glm::vec4 morphRange = glm::vec4(0.0f);  // x = morph start, y = morph end (distance from lodCamera)
+		glm::vec4 lodCamera = glm::vec4(0.0f);   // xyz = point the ranges are measured from
+		glm::vec4 heightmapWindow = glm::vec4(0.0f, 0.0f, 1.0f, 0.001f);  // xy = heightmap uv at the terrain min corner, z = uv span, w = edge inset
+	};
+
+	struct TerrainQuadtreeSettings
+	{
+		float    worldSize = 200.0f;       // Root node edge length
+		float    heightScale = 30.0f;      // Node bounds span y in [0, heightScale]
+		uint32_t levels = 4;               // LOD count; leaves are worldSize / 2^(levels-1)
+		float    lodRangeScale = 4.0f;     // Finest level's range, in leaf edge lengths
+		float    morphStartRatio = 0.66f;  // Where in a level's range band morphing starts
+	};
+
+	class TerrainQuadtree
+	{
+	public:
+		static constexpr uint32_t MAX_LEVELS = 16;
+
+		// Replaces `patches` with a crack-free cover of the whole terrain
+		// for a camera at `camera`. Never empty: the root alone is the
+		// coarsest possible cover.
+		void Select(const TerrainQuadtreeSettings& settings, const glm::vec3& camera,
+			std::vector<TerrainPatch>& patches)
+		{
+			patches.clear();
+
+			m_Settings = settings;
+			m_Settings.levels = std::clamp(settings.levels, 1u, MAX_LEVELS);
+			m_Camera = camera;
+
+			const uint32_t top = m_Settings.levels - 1;
+			const float leafSize = m_Settings.worldSize / static_cast<float>(1u << top);
+			for (uint32_t level = 0; level < m_Settings.levels; ++level)
+			{
+				m_Ranges[level] = leafSize * m_Settings.lodRangeScale * static_cast<float>(1u << level);
+			}
+
+			const float half = m_Settings.worldSize * 0.5f;
+			SelectNode(glm::vec2(-half), m_Settings.worldSize, top, patches);
+		}
+
+		// Distance up to which `level` is drawn (valid after Select)
+		float GetRange(uint32_t level) const { return m_Ranges[std::min(level, MAX_LEVELS - 1)]; }
+
+	private:
+		// False (and nothing emitted) if the node is outside its level's
+		// range - the parent then covers that area itself
+		bool SelectNode(const glm::vec2& min, float size, uint32_t level, std::vector<TerrainPatch>& patches)
+		{
+			const bool isRoot = (level == m_Settings.levels - 1);
+			if (!isRoot && !IntersectsRange(min, size, m_Ranges[level]))
+				return false;
+
+			if (level == 0 || !IntersectsRange(min, size, m_Ranges[level - 1]))
+			{
+				Emit(min, size, level, patches);
+				return true;
+			}
+
+			// Children that fall outside the finer range are still drawn as
+			// child-sized patches at that finer level: every vertex is past
+			// its morph end there, so they collapse onto this level's grid.
+			const float childSize = size * 0.5f;
+			for (uint32_t child = 0; child < 4; ++child)
+			{
+				const glm::vec2 childMin = min + glm::vec2(
+					(child & 1u) ? childSize : 0.0f,
+					(child & 2u) ? childSize : 0.0f);
+
+				if (!SelectNode(childMin, childSize, level - 1, patches))
+					Emit(childMin, childSize, level - 1, patches);
+			}
+			return true;
+		}
+
+		bool IntersectsRange(const glm::vec2& min, float size, float range) const
+		{
+			const glm::vec3 boxMin(min.x, 0.0f, min.y);
+			const glm::vec3 boxMax(min.x + size, m_Settings.heightScale, min.y + size);
+			const glm::vec3 closest = glm::clamp(m_Camera, boxMin, boxMax);
+			const glm::vec3 delta = closest - m_Camera;
+			return glm::dot(delta, delta) <= range * range;
+		}
+
+		void Emit(const glm::vec2& min, float size, uint32_t level, std::vector<TerrainPatch>& patches) const
+		{
+			TerrainPatch& patch = patches.emplace_back();
+			patch.offsetSize = glm::vec4(min.x, min.y, size, static_cast<float>(level));
+			patch.lodCamera = glm::vec4(m_Camera, 0.0f);
+
+			if (level == m_Settings.levels - 1)
+			{
+				// Nothing coarser to morph towards
+				patch.morphRange = glm::vec4(1e30f, 2e30f, 0.0f, 0.0f);
+			}
+			else
+			{
+				const float bandStart = (level == 0) ? 0.0f : m_Ranges[level - 1];
+				const float end = m_Ranges[level];
+				const float start = bandStart + (end - bandStart) * m_Settings.morphStartRatio;
+				patch.morphRange = glm::vec4(start, end, 0.0f, 0.0f);
+			}
+		}
+
+		TerrainQuadtreeSettings m_Settings;
+		glm::vec3 m_Camera = glm::vec3(0.0f);
+		float m_Ranges[MAX_LEVELS] = {};
+	};
+}
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+// TerrainSunShadow.hpp
+//
+// The terrain's own shadow from the sun, traced through the heightfield
+// instead of rasterised into every shadow cascade. TerrainSunShadow.comp
+// marches each surface map texel toward the light and stores the shadow
+// height there: the lowest world height a point above that texel must
+// reach to see the light past the terrain,
+//   max(h(p), max over steps t of h(p + t*dir) - t*drop).
+// Any receiver - the terrain itself, grass, meshes standing on it - is then
+// lit where it sits above that height (terrain_shadow.glsl, sampled by
+// shadows.glsl's SampleShadow), so the terrain can drop out of all but the
+// nearest cascades (ShadowConfig::terrainCascades).
+//
+// The map is baked only when the light has turned past
+// TERRAIN_SUN_SHADOW_REBAKE_DEG since the last bake or the terrain under it
+// changed. TerrainSunShadowMarchFor, TerrainSunShadowHeight and
+// TerrainSunShadowVisibility are the shader's CPU twins and must stay in
+// step with TerrainSunShadow.comp and terrain_shadow.glsl.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	constexpr float TERRAIN_SUN_SHADOW_MIN_ELEVATION = 0.05f;    // lower lights march as if this high (y of the unit light)
+	constexpr float TERRAIN_SUN_SHADOW_REBAKE_DEG = 0.25f;       // light turn that makes the map due again
+	constexpr float TERRAIN_SUN_SHADOW_BIAS_TEXELS = 1.0f;       // receiver lift, in texel widths of height
+	constexpr float TERRAIN_SUN_SHADOW_PENUMBRA_TEXELS = 2.0f;   // height over which the shadow fades in
+
+	// Frame UBO block (FrameUniformData::terrainShadow); must match
+	// TerrainShadowData in scene_common.glsl
+	struct TerrainSunShadowData
+	{
+		glm::vec4 window = glm::vec4(0.0f);   // xy = min corner (world xz), z = side (0 = off)
+		glm::vec4 params = glm::vec4(0.0f);   // x = bias, y = penumbra (world height)
+	};
+	static_assert(sizeof(TerrainSunShadowData) == 32, "Must match TerrainShadowData in scene_common.glsl");
+
+	// One bake's march, in surface map texels
+	struct TerrainSunShadowMarch
+	{
+		glm::vec2 step = glm::vec2(0.0f);   // texels per step, one along the major axis
+		float     drop = 0.0f;              // world height the ray sinks per step, walking away from the light
+		uint32_t  steps = 0;                // 0: the light is overhead, nothing shadows
+	};
+
+	// The light as the bake uses it: unit, and no lower than the minimum
+	// elevation
+	inline glm::vec3 TerrainSunShadowLight(const glm::vec3& towardLight)
+	{
+		const glm::vec3 light = glm::normalize(towardLight);
+		return glm::normalize(glm::vec3(light.x, std::max(light.y, TERRAIN_SUN_SHADOW_MIN_ELEVATION), light.z));
+	}
+
+	// The march toward `light` (TerrainSunShadowLight) over a map of
+	// mapTexels per side, texelWorldSize apart, whose heights span
+	// heightRange: long enough for the ray to climb out of the range, and
+	// never past the map
+	inline TerrainSunShadowMarch TerrainSunShadowMarchFor(const glm::vec3& light, float texelWorldSize,
+		uint32_t mapTexels, float heightRange)
+	{
+		TerrainSunShadowMarch march;
+		const float horizontal = std::sqrt(light.x * light.x + light.z * light.z);
+		if (horizontal < 1.0e-4f || texelWorldSize <= 0.0f)
+			return march;
+
+		const glm::vec2 dir = glm::vec2(light.x, light.z) / horizontal;
+		march.step = dir / std::max(std::abs(dir.x), std::abs(dir.y));
+		march.drop = glm::length(march.step) * texelWorldSize * light.y / horizontal;
+		const float climb = std::ceil(std::max(heightRange, 0.0f) / march.drop);
+		march.steps = static_cast<uint32_t>(std::min(climb, static_cast<float>(mapTexels)));
+		return march;
+	}
+
+	// The shadow height at `texel` (texel-centre coordinates) of a
+	// size.x x size.y map; heightAt(glm::vec2 texel) returns the bilinear
+	// world height there. maxHeight is the top of the height range: once the
+	// ray is below the best occluder by more than any texel can rise, the
+	// march stops.
+	template<typename HeightAt>
+	float TerrainSunShadowHeight(const HeightAt& heightAt, const glm::vec2& texel, const glm::ivec2& size,
+		const TerrainSunShadowMarch& march, float maxHeight)
+	{
+		float shadow = heightAt(texel);
+		const glm::vec2 last = glm::vec2(size) - 1.0f;
+		glm::vec2 p = texel;
+		for (uint32_t i = 1; i <= march.steps; ++i)
+		{
+			const float sunk = march.drop * static_cast<float>(i);
+			if (maxHeight - sunk <= shadow)
+				break;
+
+			p += march.step;
+			if (p.x < 0.0f || p.y < 0.0f || p.x > last.x || p.y > last.y)
+				break;
+			shadow = std::max(shadow, heightAt(p) - sunk);
+		}
+		return shadow;
+	}
+
+	// Lit fraction of a receiver at world height receiverY over a texel
+	// whose shadow height is shadowHeight
+	inline float TerrainSunShadowVisibility(float receiverY, float shadowHeight, const TerrainSunShadowData& data)
+	{
+		return std::clamp((receiverY + data.params.x - shadowHeight) / std::max(data.params.y, 1.0e-4f), 0.0f, 1.0f);
+	}
+
+	// Whether the map is due: never baked, invalidated (the terrain
+	// changed), or baked for a light that has since turned too far
+	class TerrainSunShadowState
+	{
+	public:
+		void Invalidate() { m_Valid = false; }
+		bool IsValid() const { return m_Valid; }
+
+		// Returns true when the map must be baked for `towardLight`, and
+		// takes it as the light the map now holds
+		bool Update(const glm::vec3& towardLight)
+		{
+			const glm::vec3 light = TerrainSunShadowLight(towardLight);
+			if (m_Valid && glm::dot(light, m_Light) >= std::cos(glm::radians(TERRAIN_SUN_SHADOW_REBAKE_DEG)))
+				return false;
+			m_Light = light;
+			m_Valid = true;
+			return true;
+		}
+
+		// The light the map was (or is about to be) baked for
+		const glm::vec3& GetLight() const { return m_Light; }
+
+	private:
+		glm::vec3 m_Light = glm::vec3(0.0f, 1.0f, 0.0f);
+		bool      m_Valid = false;
+	};
+}
@@ -3,22 +3,75 @@
 //------------------------------------------------------------------------------
 
 #include "Engine/Terrain/TerrainSystem.hpp"
-#include "Engine/Terrain/TerrainMesh.hpp"
+#include "Engine/Renderer/GridMesh.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanCommandPool.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Engine/Renderer/NoiseTextureGenerator.hpp"
+#include "Engine/Renderer/NoiseVolumeCache.hpp"
 #include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
 
 namespace Nightbloom
 {
+    namespace
+    {
+        // Must match the push constants in TerrainSurface.comp
+        struct SurfacePushConstants
+        {
+            glm::ivec4 region;   // xy = first texel written, zw = texels written
+            glm::ivec4 target;   // xy = texture size, z = wrap
+            glm::ivec4 world;    // xy = world texel of region.xy minus region.xy
+            glm::vec4  material; // xy = terrain-local xz of world texel 0's corner, z = texel size (world), w = slope scale
+        };
+
+        constexpr uint32_t SURFACE_LOCAL_SIZE = 8;
+
+        // Must match the push constants in TerrainSculpt.comp
+        struct SculptPushConstants
+        {
+            glm::ivec4 region;   // xy = first texel written, zw = texels written
+            glm::vec4  brush;    // xy = centre (continuous texels), z = radius (world), w = falloff
+            glm::vec4  params;   // x = amount, y = target height, zw = texel size (world)
+            glm::uvec4 mode;     // x = TerrainBrushMode, or SCULPT_MODE_COPY
+        };
+
+        constexpr uint32_t SCULPT_MODE_COPY = 4;
+
+        // Must match the push constants in TerrainVirtualPage.comp
+        struct VirtualPagePushConstants
+        {
+            glm::ivec4 page;      // xy = page (world xz / page world size), zw = slot
+            glm::ivec4 level;     // x = level (array layer), y = page texels
+            glm::vec4  placement; // x = page world size, y = texel world size
+            glm::vec4  surface;   // xy = surface map uv of world xz (0, 0), z = uv per world unit, w = slope scale
+        };
+
+        // Must match the push constants in TerrainSunShadow.comp
+        struct SunShadowPushConstants
+        {
+            glm::ivec4 target;   // xy = map size, z = steps
+            glm::vec4  march;    // xy = texels per step, z = world height sunk per step, w = top of the height range (world)
+            glm::vec4  height;   // x = heightScale, y = world height of the range's bottom
+        };
+    }
+
     bool TerrainSystem::Initialize(Renderer* renderer)
     {
+        GpuMemoryScope memoryScope(GpuMemoryCategory::Terrain);
+
         if (!renderer)
         {
             LOG_ERROR("TerrainSystem::Initialize — null renderer");
@@ -48,17 +101,62 @@ namespace Nightbloom
             LOG_WARN("TerrainSystem: no default_white texture — albedo will be unbound");
         }
 
+        // The surface and sculpt passes write a heightmap-sized storage image
+        // (set 0) from a sampled heightmap-layout texture (set 1); the surface
+        // pass writes the material map too (set 2)
+        const VkDescriptorSetLayout storageLayout = m_DescriptorManager->GetComputeImageSetLayout();
+        const VkDescriptorSetLayout heightmapLayout = m_DescriptorManager->GetHeightmapSetLayout();
+        if (!CreateComputePipeline("TerrainSurface.comp.spv", sizeof(SurfacePushConstants),
+            { storageLayout, heightmapLayout, storageLayout }, m_SurfacePipelineLayout, m_SurfacePipeline))
+        {
+            LOG_ERROR("TerrainSystem::Initialize — failed to create the surface map pipeline");
+            return false;
+        }
+
+        // Without it the terrain still draws; Sculpt just refuses
+        if (!CreateComputePipeline("TerrainSculpt.comp.spv", sizeof(SculptPushConstants),
+            { storageLayout, heightmapLayout }, m_SculptPipelineLayout, m_SculptPipeline))
+        {
+            LOG_WARN("TerrainSystem: no sculpt pipeline — sculpting disabled");
+        }
+
+        // Every heightmap set samples the page arrays, so they must exist
+        if (!CreateVirtualTexture())
+        {
+            LOG_ERROR("TerrainSystem::Initialize — failed to create the virtual texture");
+            return false;
+        }
+
         InitializeTerrainMaterials();
 
+        // Renders the pages into the arrays (sets 0, 1) from the surface and
+        // material maps (set 2) and the layers (set 3). Without it (or the
+        // layers) Terrain.frag blends the layers itself everywhere.
+        if (!CreateComputePipeline("TerrainVirtualPage.comp.spv", sizeof(VirtualPagePushConstants),
+            { storageLayout, storageLayout, heightmapLayout, m_DescriptorManager->GetTextureSetLayout() },
+            m_VirtualPipelineLayout, m_VirtualPipeline))
+        {
+            LOG_WARN("TerrainSystem: no virtual texture pipeline — terrain layers blended per pixel");
+        }
+
+        // Bakes the sun shadow map (set 0) from the surface map (set 1).
+        // Without it the terrain casts into every shadow cascade as before.
+        if (!CreateComputePipeline("TerrainSunShadow.comp.spv", sizeof(SunShadowPushConstants),
+            { storageLayout, heightmapLayout }, m_SunShadowPipelineLayout, m_SunShadowPipeline))
+        {
+            LOG_WARN("TerrainSystem: no sun shadow pipeline — terrain shadows from the cascades only");
+        }
+
         LOG_INFO("TerrainSystem initialized");
         return true;
     }
 
     bool TerrainSystem::InitializeTerrainMaterials()
     {
-        m_GrassTexture = m_Resources->LoadTexture( "GrassAlbedo", "Grass/GrassAlbedo");
-        m_DirtTexture = m_Resources->LoadTexture( "DirtAlbedo", "Dirt/DirtAlbedo");
-        m_RockTexture = m_Resources->LoadTexture( "RockAlbedo", "Rock/RockAlbedo");
+        // Not streamed: m_TerrainTextureSet holds their views directly
+        m_GrassTexture = m_Resources->LoadTexture( "GrassAlbedo", "Grass/GrassAlbedo", false);
+        m_DirtTexture = m_Resources->LoadTexture( "DirtAlbedo", "Dirt/DirtAlbedo", false);
+        m_RockTexture = m_Resources->LoadTexture( "RockAlbedo", "Rock/RockAlbedo", false);
 
         if (!m_GrassTexture || !m_DirtTexture || !m_RockTexture)
         {
@@ -96,39 +194,52 @@ namespace Nightbloom
     // =========================================================================
     bool TerrainSystem::Regenerate(const TerrainDesc& desc)
     {
-        m_Ready = false;
-        m_SkipNextDraw = true;
-
-        // Wait for any in-flight frames to finish before touching GPU resources
-        m_Renderer->WaitForIdle();
+        GpuMemoryScope memoryScope(GpuMemoryCategory::Terrain);
 
-        // ---- Rebuild grid mesh if resolution or size changed ----------------
-        bool needsMesh = !m_MeshBuilt
-            || desc.resolution != m_CurrentDesc.resolution
-            || desc.worldSize != m_CurrentDesc.worldSize;
-
-        if (needsMesh)
-        {
-            if (!BuildGridMesh(desc.resolution, desc.worldSize))
-            {
-                LOG_ERROR("TerrainSystem::Regenerate — failed to build grid mesh");
-                return false;
-            }
-        }
+        // This desc supersedes anything still generating in the background
+        CancelHeightmapJob();
 
         // ---- Regenerate heightmap, but only if noise params actually changed
-        // (e.g. an LOD-driven resolution change has no effect on the noise
-        // texture — regenerating it would be a wasted compute dispatch)
-        bool needsHeightmap = !m_Heightmap
-            || desc.noise.width != m_CurrentDesc.noise.width
-            || desc.noise.height != m_CurrentDesc.noise.height
-            || desc.noise.noiseType != m_CurrentDesc.noise.noiseType
+        // (grid, LOD and transform settings are consumed by UpdateLOD and the
+        // draw's push constants — regenerating for them would be a wasted
+        // compute dispatch and a device stall)
+        const bool noiseChanged =
+            desc.noise.noiseType != m_CurrentDesc.noise.noiseType
             || desc.noise.octaves != m_CurrentDesc.noise.octaves
             || desc.noise.frequency != m_CurrentDesc.noise.frequency
             || desc.noise.persistence != m_CurrentDesc.noise.persistence
             || desc.noise.lacunarity != m_CurrentDesc.noise.lacunarity
             || desc.noise.seed != m_CurrentDesc.noise.seed;
 
+        // Streaming only recreates its texture when the slot layout changes;
+        // new noise just re-streams the tiles (see the tile reset below)
+        bool needsHeightmap = false;
+        if (desc.streaming)
+        {
+            needsHeightmap = !m_Heightmap || !m_CurrentDesc.streaming
+                || desc.tileResolution != m_CurrentDesc.tileResolution
+                || desc.streamRadius != m_CurrentDesc.streamRadius;
+        }
+        else
+        {
+            needsHeightmap = !m_Heightmap || m_CurrentDesc.streaming || noiseChanged
+                || desc.noise.width != m_CurrentDesc.noise.width
+                || desc.noise.height != m_CurrentDesc.noise.height;
+        }
+
+        // Frames in flight keep drawing with the old heightmap and set:
+        // DestroyHeightmap only frees them once those frames have finished
+        if (needsHeightmap || m_MeshQuads == 0)
+            m_Ready = false;
+
+        // ---- Shared patch grid: rebuilt only when tessellation changes it ----
+        const uint32_t patchQuads = PatchQuadsFor(desc);
+        if (m_MeshQuads != patchQuads && !BuildPatchMesh(patchQuads))
+        {
+            LOG_ERROR("TerrainSystem::Regenerate — failed to build patch mesh");
+            return false;
+        }
+
         if (needsHeightmap)
         {
             DestroyHeightmap();
@@ -142,89 +253,966 @@ namespace Nightbloom
                 return false;
             }
 
-            // Force depth=1 — we need a true 2D texture that the vertex shader
-            // can sample with sampler2D (3D textures are not valid here)
-            NoiseTextureDesc noiseDesc = desc.noise;
-            noiseDesc.depth = 1;
-            noiseDesc.debugName = "TerrainHeightmap";
-
-            m_Heightmap = noiseGen->Generate(noiseDesc, dispatch);
-            if (!m_Heightmap)
+            if (desc.streaming)
             {
-                LOG_ERROR("TerrainSystem::Regenerate — noise generation failed");
-                return false;
+                if (!CreateStreamingHeightmap(desc))
+                    return false;
+            }
+            else
+            {
+                // Force depth=1 — we need a true 2D texture that the vertex shader
+                // can sample with sampler2D (3D textures are not valid here)
+                NoiseTextureDesc noiseDesc = desc.noise;
+                noiseDesc.depth = 1;
+                noiseDesc.debugName = "TerrainHeightmap";
+
+                // Shared through the generator's cache, so regenerating with
+                // unchanged noise settings reuses it
+                m_Heightmap = noiseGen->Acquire(noiseDesc, dispatch);
+                m_HeightmapCached = (m_Heightmap != nullptr);
+                if (!m_Heightmap)
+                {
+                    LOG_ERROR("TerrainSystem::Regenerate — noise generation failed");
+                    return false;
+                }
+                m_HeightmapLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+                // CPU copy follows in the next frame's compute pass; until it
+                // lands HasHeightData() is false rather than stale
+                m_ReadbackState = ReadbackState::Requested;
             }
 
-            // ---- Allocate / update heightmap descriptor set ----------------
-            // We allocate a fresh set each time. Old set is reclaimed by the pool
-            // on the next pool reset (or on Shutdown via vkResetDescriptorPool).
-            m_HeightmapDescriptorSet = m_DescriptorManager->AllocateHeightmapSet();
-            if (m_HeightmapDescriptorSet == VK_NULL_HANDLE)
+            // ---- Surface and material maps, and the set sampling them -------
+            // Fresh ones each time: the old ones may still be in use by frames
+            // in flight, and DestroyHeightmap has queued them to be freed
+            if (!CreateSurfaceMap(m_Heightmap, m_SurfaceMap, m_MaterialMap, m_HeightmapDescriptorSet))
             {
-                LOG_ERROR("TerrainSystem::Regenerate — failed to allocate heightmap descriptor set");
+                LOG_ERROR("TerrainSystem::Regenerate — failed to create the surface map");
                 return false;
             }
 
-            m_DescriptorManager->UpdateHeightmapSet(m_HeightmapDescriptorSet, m_Heightmap);
+            // Streamed tiles add their own regions as they land
+            if (!desc.streaming)
+            {
+                m_SurfaceRegions.push_back({ glm::ivec4(0, 0,
+                    static_cast<int>(m_Heightmap->GetWidth()), static_cast<int>(m_Heightmap->GetHeight())) });
+            }
 
             LOG_INFO("TerrainSystem: heightmap regenerated ({}x{}, scale={:.1f})",
-                noiseDesc.width, noiseDesc.height, desc.heightScale);
+                m_Heightmap->GetWidth(), m_Heightmap->GetHeight(), desc.heightScale);
+        }
+
+        // Tiles hold noise sampled at their world position: anything that
+        // changes either invalidates all of them. UpdateLOD streams the
+        // window back in (in one go, since it starts out empty).
+        if (desc.streaming && (needsHeightmap || noiseChanged
+            || desc.worldSize != m_CurrentDesc.worldSize
+            || desc.tileWorldSize != m_CurrentDesc.tileWorldSize))
+        {
+            m_TileCache.Reset(desc.streamRadius);
+            m_PendingTiles.clear();
         }
 
+        // The baked material weights follow the slope, which the height scale
+        // and the texel size set; m_CurrentDesc is what the next pass bakes with
+        const bool rebakeMaterial = !needsHeightmap
+            && (desc.heightScale != m_CurrentDesc.heightScale
+                || desc.worldSize != m_CurrentDesc.worldSize
+                || desc.tileWorldSize != m_CurrentDesc.tileWorldSize);
+
+        // Every page shows the old terrain (a streamed window's new tiles
+        // re-render the pages they land under instead)
+        if (needsHeightmap || noiseChanged
+            || desc.heightScale != m_CurrentDesc.heightScale
+            || desc.worldSize != m_CurrentDesc.worldSize
+            || desc.tileWorldSize != m_CurrentDesc.tileWorldSize
+            || desc.position != m_CurrentDesc.position)
+        {
+            ResetVirtualTexture();
+        }
+
+        // Transform and height scale apply to the CPU copy without a readback
+        m_HeightField.SetPlacement(desc.position, desc.worldSize, desc.heightScale);
+        if (desc.streaming)
+            m_StreamingNoise = NoiseField(desc.noise, TILE_NOISE_PERIOD_SCALE);
+
+        // Far shadow cascades cache terrain depth; the heightmap set above is
+        // rewritten in place, so the renderer can't notice on its own. The sun
+        // shadow map holds world heights, which every change here moves.
+        m_Renderer->InvalidateShadowCache();
+        m_SunShadowDirty = true;
+
         m_CurrentDesc = desc;
         m_Ready = true;
 
+        if (rebakeMaterial)
+            RebakeMaterialMap();
+
+        return true;
+    }
+
+    // =========================================================================
+    // Background regeneration
+    // =========================================================================
+    bool TerrainSystem::CanRegenerateInBackground(const TerrainDesc& desc) const
+    {
+        return m_Ready && m_Heightmap && m_HeightmapCached
+            && !desc.streaming && !m_CurrentDesc.streaming
+            && HashNoiseTextureDesc(desc.noise) != HashNoiseTextureDesc(m_CurrentDesc.noise);
+    }
+
+    bool TerrainSystem::RequestRegenerate(const TerrainDesc& desc)
+    {
+        if (!CanRegenerateInBackground(desc))
+            return Regenerate(desc);
+
+        // Started by the next UpdateLOD, once a running job is done
+        m_QueuedDesc = desc;
         return true;
     }
 
+    // Called at the start of UpdateLOD, before the frame that draws the
+    // terrain is recorded: frames in flight keep the old heightmap and
+    // descriptor set, which are only freed once they have finished
+    void TerrainSystem::UpdateHeightmapJob()
+    {
+        NoiseTextureGenerator* noiseGen = m_Renderer->GetNoiseGenerator();
+        if (!noiseGen)
+            return;
+
+        if (m_HeightmapJob != 0)
+        {
+            // Swapping would free the readback buffer a frame is still copying into
+            if (m_ReadbackState == ReadbackState::InFlight)
+                return;
+
+            VulkanTexture* heightmap = nullptr;
+            const NoiseJobState state = noiseGen->PollJob(m_HeightmapJob, heightmap);
+            if (state == NoiseJobState::Pending)
+                return;
+            m_HeightmapJob = 0;
+
+            VulkanTexture* surface = nullptr;
+            VulkanTexture* material = nullptr;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            if (!heightmap || !CreateSurfaceMap(heightmap, surface, material, set))
+            {
+                LOG_ERROR("TerrainSystem: background heightmap generation failed, keeping the current heightmap");
+                noiseGen->Release(heightmap);
+            }
+            else
+            {
+                DestroyHeightmap();
+                m_Heightmap = heightmap;
+                m_HeightmapCached = true;
+                m_HeightmapDescriptorSet = set;
+                m_HeightmapLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                m_SurfaceMap = surface;
+                m_MaterialMap = material;
+                m_SurfaceRegions.push_back({ glm::ivec4(0, 0,
+                    static_cast<int>(heightmap->GetWidth()), static_cast<int>(heightmap->GetHeight())) });
+                m_ReadbackState = ReadbackState::Requested;
+
+                m_HeightField.SetPlacement(m_JobDesc.position, m_JobDesc.worldSize, m_JobDesc.heightScale);
+                m_Renderer->InvalidateShadowCache();
+                ResetVirtualTexture();
+                m_SunShadowDirty = true;
+                m_CurrentDesc = m_JobDesc;
+
+                LOG_INFO("TerrainSystem: background heightmap swapped in ({}x{})",
+                    m_Heightmap->GetWidth(), m_Heightmap->GetHeight());
+            }
+        }
+
+        if (m_QueuedDesc)
+        {
+            const TerrainDesc desc = *m_QueuedDesc;
+            m_QueuedDesc.reset();
+
+            // Scrubbed back to the noise already shown: nothing to generate
+            if (!CanRegenerateInBackground(desc))
+            {
+                Regenerate(desc);
+                return;
+            }
+
+            NoiseTextureDesc noiseDesc = desc.noise;
+            noiseDesc.depth = 1;
+            noiseDesc.debugName = "TerrainHeightmap";
+            m_HeightmapJob = noiseGen->AcquireAsync(noiseDesc, m_Renderer->GetComputeDispatcher());
+            if (m_HeightmapJob == 0)
+            {
+                LOG_WARN("TerrainSystem: background heightmap generation unavailable, regenerating in place");
+                Regenerate(desc);
+                return;
+            }
+            m_JobDesc = desc;
+        }
+    }
+
+    void TerrainSystem::CancelHeightmapJob()
+    {
+        // Without a generator its Cleanup has already dropped the job
+        if (NoiseTextureGenerator* noiseGen = m_Renderer ? m_Renderer->GetNoiseGenerator() : nullptr)
+            noiseGen->CancelJob(m_HeightmapJob);
+        m_HeightmapJob = 0;
+        m_QueuedDesc.reset();
+    }
+
     // =========================================================================
     // UpdateLOD
     // =========================================================================
-    void TerrainSystem::UpdateLOD(const glm::vec3& cameraPosition, uint32_t baseResolution)
+    void TerrainSystem::UpdateLOD(const glm::vec3& cameraPosition)
     {
         if (!m_Ready) return;
 
-        float distance = glm::length(cameraPosition - m_CurrentDesc.position);
-        uint32_t targetResolution = SelectLODResolution(distance, baseResolution, m_CurrentDesc.worldSize);
+        UpdateHeightmapJob();
+        if (!m_Ready) return;
+
+        // Virtual texture pages around the camera, rendered by the same
+        // frame's compute pass before anything samples them
+        if (m_VirtualPipeline != VK_NULL_HANDLE && m_TerrainTextureSet != VK_NULL_HANDLE)
+        {
+            m_VirtualTexture.Update(glm::vec2(cameraPosition.x, cameraPosition.z), TERRAIN_VIRTUAL_PAGES_PER_FRAME,
+                m_VirtualRequests);
+            m_PendingPages.insert(m_PendingPages.end(), m_VirtualRequests.begin(), m_VirtualRequests.end());
+        }
+
+        // A background swap takes the rest of its desc along, tessellation included
+        const uint32_t patchQuads = PatchQuadsFor(m_CurrentDesc);
+        if (m_MeshQuads != patchQuads && !BuildPatchMesh(patchQuads))
+        {
+            LOG_ERROR("TerrainSystem::UpdateLOD — failed to rebuild patch mesh");
+            m_Ready = false;
+            return;
+        }
+
+        TerrainQuadtreeSettings settings;
+        settings.worldSize = m_CurrentDesc.worldSize;
+        settings.heightScale = m_CurrentDesc.heightScale;
+        settings.levels = ComputeLODLevels(GetFinestResolution());
+        settings.lodRangeScale = m_CurrentDesc.lodRangeScale;
+
+        m_WindowCenter = m_CurrentDesc.position;
+        glm::vec4 heightmapWindow(0.0f, 0.0f, 1.0f, 0.001f);
+
+        if (m_CurrentDesc.streaming)
+        {
+            const float tileSize = m_CurrentDesc.tileWorldSize;
+            const glm::vec3 relative = cameraPosition - m_CurrentDesc.position;
+            const TerrainTileCoord cameraTile{
+                static_cast<int32_t>(std::floor(relative.x / tileSize)),
+                static_cast<int32_t>(std::floor(relative.z / tileSize)) };
+
+            // A fresh window is filled in one frame (nothing to draw until
+            // then); after that the budget only has to keep up with walking
+            const uint32_t windowTiles = (2 * m_TileCache.GetRadius() + 1) * (2 * m_TileCache.GetRadius() + 1);
+            const uint32_t budget = m_TileCache.HasWindow() ? m_CurrentDesc.tilesPerFrame : windowTiles;
+
+            m_TileCache.Update(cameraTile, budget, m_TileRequests);
+            m_PendingTiles.insert(m_PendingTiles.end(), m_TileRequests.begin(), m_TileRequests.end());
+
+            if (m_Heightmap && m_Heightmap->GetSparsePages())
+                CommitTilePages(cameraTile);
+
+            if (!m_TileCache.HasWindow())
+            {
+                m_Patches.clear();
+                return;
+            }
+
+            // The quadtree covers the drawn window; the heightmap is sampled
+            // from the window's first slot onwards and wraps (REPEAT sampler)
+            const TerrainTileCoord center = m_TileCache.GetCenter();
+            const int32_t radius = static_cast<int32_t>(m_TileCache.GetRadius());
+            const float slots = static_cast<float>(m_TileCache.GetSlotsPerSide());
+            const float windowTilesPerSide = static_cast<float>(2 * radius + 1);
+
+            settings.worldSize = windowTilesPerSide * tileSize;
+            m_WindowCenter += glm::vec3(
+                (static_cast<float>(center.x) + 0.5f) * tileSize, 0.0f,
+                (static_cast<float>(center.z) + 0.5f) * tileSize);
+
+            heightmapWindow = glm::vec4(
+                static_cast<float>(m_TileCache.SlotOf(center.x - radius)) / slots,
+                static_cast<float>(m_TileCache.SlotOf(center.z - radius)) / slots,
+                windowTilesPerSide / slots,
+                0.5f / (slots * static_cast<float>(m_CurrentDesc.tileResolution)));
+        }
+
+        // The quadtree works in terrain-local space (centred, y = 0 at the
+        // bottom of the height range), the same space Terrain.vert builds in
+        m_Quadtree.Select(settings, cameraPosition - m_WindowCenter, m_Patches);
+        for (TerrainPatch& patch : m_Patches)
+        {
+            patch.heightmapWindow = heightmapWindow;
+        }
+    }
+
+    // =========================================================================
+    // DispatchHeightmapUpdate
+    // =========================================================================
+    bool TerrainSystem::DispatchHeightmapUpdate(VkCommandBuffer cmd, ComputeDispatcher* dispatcher)
+    {
+        NoiseTextureGenerator* noiseGen = m_Renderer->GetNoiseGenerator();
+        if (!m_Heightmap || !m_SurfaceMap || !noiseGen)
+        {
+            m_PendingTiles.clear();
+            m_SurfaceRegions.clear();
+            return false;
+        }
+
+        if (!m_PendingTiles.empty() && m_CurrentDesc.streaming)
+        {
+            // Also orders this frame's writes after last frame's surface pass,
+            // which finished before last frame's vertex stage
+            dispatcher->TransitionImageForComputeWrite(cmd, m_Heightmap->GetImage(), m_HeightmapLayout);
+
+            // One noise uv unit spans worldSize world units, as it does for the
+            // single-patch terrain; a tile is one window of that unbounded field
+            const float tileUV = m_CurrentDesc.tileWorldSize / m_CurrentDesc.worldSize;
+            for (const TerrainTileRequest& request : m_PendingTiles)
+            {
+                NoiseRegion region;
+                region.originX = request.slotX * m_CurrentDesc.tileResolution;
+                region.originY = request.slotZ * m_CurrentDesc.tileResolution;
+                region.width = m_CurrentDesc.tileResolution;
+                region.height = m_CurrentDesc.tileResolution;
+                region.uvOffsetX = static_cast<float>(request.tile.x) * tileUV;
+                region.uvOffsetY = static_cast<float>(request.tile.z) * tileUV;
+                region.uvScale = tileUV;
+                region.periodScale = TILE_NOISE_PERIOD_SCALE;
+
+                noiseGen->RecordRegion(cmd, dispatcher, m_Heightmap, m_CurrentDesc.noise, region);
+
+                // Plus a texel all round: the neighbours' edge gradients read this tile
+                const int resolution = static_cast<int>(m_CurrentDesc.tileResolution);
+                m_SurfaceRegions.push_back({
+                    glm::ivec4(
+                        static_cast<int>(region.originX) - 1, static_cast<int>(region.originY) - 1,
+                        static_cast<int>(region.width) + 2, static_cast<int>(region.height) + 2),
+                    glm::ivec2(
+                        (request.tile.x - static_cast<int>(request.slotX)) * resolution,
+                        (request.tile.z - static_cast<int>(request.slotZ)) * resolution) });
+            }
+
+            // Only the surface pass below samples the heightmap now
+            dispatcher->ComputeWriteToComputeSampleBarrier(cmd, m_Heightmap->GetImage());
+            m_HeightmapLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            m_Heightmap->SetCurrentLayout(m_HeightmapLayout);
+        }
+        m_PendingTiles.clear();
+
+        // One stroke per frame, once the surface map (Smooth's source) and
+        // the CPU copy (edited alongside) are both current
+        if (!m_PendingStrokes.empty() && m_SurfaceRegions.empty() && m_ReadbackState == ReadbackState::Idle)
+            RecordSculptStroke(cmd, dispatcher);
+
+        if (m_SurfaceRegions.empty())
+            return false;
+
+        // Also orders this frame's writes after last frame's vertex and fragment reads
+        dispatcher->TransitionImageForComputeWrite(cmd, m_SurfaceMap->GetImage(), m_SurfaceLayout);
+        dispatcher->TransitionImageForComputeWrite(cmd, m_MaterialMap->GetImage(), m_SurfaceLayout);
+        RecordSurfaceRegions(cmd, dispatcher);
+        m_SurfaceRegions.clear();
+
+        // A sculpted rect shadows texels anywhere down-light of it
+        m_SunShadowDirty = true;
+
+        // The renderer's ComputeWriteTo*SampleBarrier finishes the trip back
+        m_SurfaceLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_SurfaceMap->SetCurrentLayout(m_SurfaceLayout);
+        m_MaterialMap->SetCurrentLayout(m_SurfaceLayout);
+        return true;
+    }
+
+    void TerrainSystem::RecordSurfaceRegions(VkCommandBuffer cmd, ComputeDispatcher* dispatcher)
+    {
+        VkDescriptorSet targetSet = m_DescriptorManager->AllocateTransientSet(
+            m_DescriptorManager->GetComputeImageSetLayout());
+        VkDescriptorSet sourceSet = m_DescriptorManager->AllocateTransientSet(
+            m_DescriptorManager->GetHeightmapSetLayout());
+        VkDescriptorSet materialSet = m_DescriptorManager->AllocateTransientSet(
+            m_DescriptorManager->GetComputeImageSetLayout());
+        if (targetSet == VK_NULL_HANDLE || sourceSet == VK_NULL_HANDLE || materialSet == VK_NULL_HANDLE)
+        {
+            LOG_ERROR("TerrainSystem: failed to allocate the surface map descriptor sets");
+            return;
+        }
+        m_DescriptorManager->UpdateComputeImageSet(targetSet, m_SurfaceMap->GetStorageImageView());
+        m_DescriptorManager->UpdateHeightmapSet(sourceSet, m_Heightmap);
+        m_DescriptorManager->UpdateComputeImageSet(materialSet, m_MaterialMap->GetStorageImageView());
+
+        dispatcher->BindPipeline(cmd, m_SurfacePipeline);
+        dispatcher->BindDescriptorSet(cmd, m_SurfacePipelineLayout, 0, targetSet);
+        dispatcher->BindDescriptorSet(cmd, m_SurfacePipelineLayout, 1, sourceSet);
+        dispatcher->BindDescriptorSet(cmd, m_SurfacePipelineLayout, 2, materialSet);
+
+        // The slope scale is Terrain.vert's (height units per world unit,
+        // per unit of gradient along the texture's uv)
+        const float width = static_cast<float>(m_SurfaceMap->GetWidth());
+        const glm::vec3 placement = GetSurfacePlacement();
+        const float texelWorldSize = placement.z;
+
+        SurfacePushConstants pc{};
+        pc.target = glm::ivec4(static_cast<int>(m_SurfaceMap->GetWidth()), static_cast<int>(m_SurfaceMap->GetHeight()),
+            m_CurrentDesc.streaming ? 1 : 0, 0);
+        pc.material = glm::vec4(placement.x, placement.y, texelWorldSize,
+            m_CurrentDesc.heightScale / (texelWorldSize * width));
+        for (const SurfaceRegion& region : m_SurfaceRegions)
+        {
+            pc.region = region.texels;
+            pc.world = glm::ivec4(region.worldOffset, 0, 0);
+            dispatcher->PushConstants(cmd, m_SurfacePipelineLayout, &pc, sizeof(pc));
+            dispatcher->Dispatch(cmd,
+                ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(region.texels.z), SURFACE_LOCAL_SIZE),
+                ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(region.texels.w), SURFACE_LOCAL_SIZE),
+                1);
+
+            // The virtual texture pages showing these texels render again
+            const glm::vec2 first = glm::vec2(m_CurrentDesc.position.x, m_CurrentDesc.position.z)
+                + glm::vec2(placement.x, placement.y)
+                + glm::vec2(region.texels.x + region.worldOffset.x, region.texels.y + region.worldOffset.y) * texelWorldSize;
+            const glm::vec2 size = glm::vec2(region.texels.z, region.texels.w) * texelWorldSize;
+            m_VirtualTexture.CollectResident(first, first + size, m_PendingPages);
+        }
+    }
+
+    // Terrain-local xz of the corner of the surface map's world texel 0, and
+    // the world size of a texel. A streamed terrain's tile (0,0) starts at
+    // its position; a single heightmap is centred on it.
+    glm::vec3 TerrainSystem::GetSurfacePlacement() const
+    {
+        if (m_CurrentDesc.streaming)
+            return glm::vec3(0.0f, 0.0f, m_CurrentDesc.tileWorldSize / static_cast<float>(m_CurrentDesc.tileResolution));
+
+        const float originOffset = -0.5f * m_CurrentDesc.worldSize;
+        return glm::vec3(originOffset, originOffset, m_CurrentDesc.worldSize / static_cast<float>(m_SurfaceMap->GetWidth()));
+    }
+
+    // Every texel the material map covers, for new bake settings: the whole
+    // single heightmap, or each resident tile of a streamed window
+    void TerrainSystem::RebakeMaterialMap()
+    {
+        if (!m_Heightmap || !m_SurfaceMap)
+            return;
+
+        if (!m_CurrentDesc.streaming)
+        {
+            m_SurfaceRegions.push_back({ glm::ivec4(0, 0,
+                static_cast<int>(m_Heightmap->GetWidth()), static_cast<int>(m_Heightmap->GetHeight())) });
+            return;
+        }
+
+        if (!m_TileCache.HasWindow())
+            return;
+
+        const TerrainTileCoord center = m_TileCache.GetCenter();
+        const int32_t radius = static_cast<int32_t>(m_TileCache.GetRadius());
+        const int resolution = static_cast<int>(m_CurrentDesc.tileResolution);
+        for (int32_t z = center.z - radius; z <= center.z + radius; ++z)
+        {
+            for (int32_t x = center.x - radius; x <= center.x + radius; ++x)
+            {
+                const int slotX = static_cast<int>(m_TileCache.SlotOf(x));
+                const int slotZ = static_cast<int>(m_TileCache.SlotOf(z));
+                m_SurfaceRegions.push_back({
+                    glm::ivec4(slotX * resolution, slotZ * resolution, resolution, resolution),
+                    glm::ivec2((x - slotX) * resolution, (z - slotZ) * resolution) });
+            }
+        }
+    }
+
+    // =========================================================================
+    // Virtual texture
+    // =========================================================================
+    bool TerrainSystem::DispatchVirtualPages(VkCommandBuffer cmd, ComputeDispatcher* dispatcher)
+    {
+        m_VirtualPagesRendered = 0;
+        if (m_PendingPages.empty())
+            return false;
+
+        if (!m_SurfaceMap || m_HeightmapDescriptorSet == VK_NULL_HANDLE || m_VirtualPipeline == VK_NULL_HANDLE
+            || m_TerrainTextureSet == VK_NULL_HANDLE)
+        {
+            m_PendingPages.clear();
+            return false;
+        }
+
+        // A page can be both new and under an edit
+        auto key = [](const TerrainVirtualPageRequest& request)
+        {
+            return std::make_tuple(request.level, request.page.tile.z, request.page.tile.x);
+        };
+        std::sort(m_PendingPages.begin(), m_PendingPages.end(),
+            [&key](const TerrainVirtualPageRequest& a, const TerrainVirtualPageRequest& b) { return key(a) < key(b); });
+        m_PendingPages.erase(std::unique(m_PendingPages.begin(), m_PendingPages.end(),
+            [&key](const TerrainVirtualPageRequest& a, const TerrainVirtualPageRequest& b) { return key(a) == key(b); }),
+            m_PendingPages.end());
+
+        VkDescriptorSet albedoSet = m_DescriptorManager->AllocateTransientSet(m_DescriptorManager->GetComputeImageSetLayout());
+        VkDescriptorSet normalSet = m_DescriptorManager->AllocateTransientSet(m_DescriptorManager->GetComputeImageSetLayout());
+        if (albedoSet == VK_NULL_HANDLE || normalSet == VK_NULL_HANDLE)
+        {
+            LOG_ERROR("TerrainSystem: failed to allocate the virtual texture descriptor sets");
+            m_PendingPages.clear();
+            return false;
+        }
+        m_DescriptorManager->UpdateComputeImageSet(albedoSet, m_VirtualAlbedo->GetStorageImageView());
+        m_DescriptorManager->UpdateComputeImageSet(normalSet, m_VirtualNormal->GetStorageImageView());
+
+        // Also orders these writes after last frame's fragment reads; the
+        // pages not written keep their contents
+        dispatcher->TransitionImageForComputeWrite(cmd, m_VirtualAlbedo->GetImage(), m_VirtualLayout);
+        dispatcher->TransitionImageForComputeWrite(cmd, m_VirtualNormal->GetImage(), m_VirtualLayout);
+
+        // Set 2 samples the surface and material maps, as the terrain draws do
+        dispatcher->BindPipeline(cmd, m_VirtualPipeline);
+        dispatcher->BindDescriptorSet(cmd, m_VirtualPipelineLayout, 0, albedoSet);
+        dispatcher->BindDescriptorSet(cmd, m_VirtualPipelineLayout, 1, normalSet);
+        dispatcher->BindDescriptorSet(cmd, m_VirtualPipelineLayout, 2, m_HeightmapDescriptorSet);
+        dispatcher->BindDescriptorSet(cmd, m_VirtualPipelineLayout, 3, m_TerrainTextureSet);
+
+        // World xz to surface map uv (a streamed map wraps: REPEAT sampler)
+        const glm::vec3 placement = GetSurfacePlacement();
+        const float uvPerWorld = 1.0f / (placement.z * static_cast<float>(m_SurfaceMap->GetWidth()));
+        const glm::vec2 origin = glm::vec2(m_CurrentDesc.position.x, m_CurrentDesc.position.z)
+            + glm::vec2(placement.x, placement.y);
+
+        VirtualPagePushConstants pc{};
+        pc.surface = glm::vec4(-origin * uvPerWorld, uvPerWorld, m_CurrentDesc.heightScale * uvPerWorld);
+        const uint32_t groups = ComputeDispatcher::CalculateGroupCount(TERRAIN_VIRTUAL_PAGE_TEXELS, SURFACE_LOCAL_SIZE);
+        for (const TerrainVirtualPageRequest& request : m_PendingPages)
+        {
+            pc.page = glm::ivec4(request.page.tile.x, request.page.tile.z, request.page.slotX, request.page.slotZ);
+            pc.level = glm::ivec4(static_cast<int>(request.level), static_cast<int>(TERRAIN_VIRTUAL_PAGE_TEXELS), 0, 0);
+            pc.placement = glm::vec4(TerrainVirtualPageWorldSize(request.level), TerrainVirtualTexelWorldSize(request.level),
+                0.0f, 0.0f);
+            dispatcher->PushConstants(cmd, m_VirtualPipelineLayout, &pc, sizeof(pc));
+            dispatcher->Dispatch(cmd, groups, groups, 1);
+        }
+        m_VirtualPagesRendered = static_cast<uint32_t>(m_PendingPages.size());
+        m_PendingPages.clear();
+
+        // The renderer's ComputeWriteToFragmentSampleBarrier finishes the trip back
+        m_VirtualLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_VirtualAlbedo->SetCurrentLayout(m_VirtualLayout);
+        m_VirtualNormal->SetCurrentLayout(m_VirtualLayout);
+        return true;
+    }
+
+    TerrainVirtualTextureData TerrainSystem::GetVirtualTextureData() const
+    {
+        if (!m_Ready || m_VirtualPipeline == VK_NULL_HANDLE || m_TerrainTextureSet == VK_NULL_HANDLE)
+            return TerrainVirtualTextureData{};
+        return m_VirtualTexture.BuildData();
+    }
+
+    void TerrainSystem::ResetVirtualTexture()
+    {
+        m_VirtualTexture.Reset();
+        m_PendingPages.clear();
+    }
+
+    // =========================================================================
+    // Sun shadow
+    // =========================================================================
+    TerrainSunShadowData TerrainSystem::PrepareSunShadow(const glm::vec3& towardLight)
+    {
+        m_SunShadowPending = false;
+        if (!m_Ready || m_CurrentDesc.streaming || !m_SurfaceMap || m_SunShadowPipeline == VK_NULL_HANDLE
+            || glm::dot(towardLight, towardLight) <= 0.0f)
+            return TerrainSunShadowData{};
+
+        // A regeneration may have changed the surface map's size
+        if (!m_SunShadowMap || m_SunShadowMap->GetWidth() != m_SurfaceMap->GetWidth()
+            || m_SunShadowMap->GetHeight() != m_SurfaceMap->GetHeight())
+        {
+            if (!CreateSunShadowMap())
+                return TerrainSunShadowData{};
+            m_SunShadowState.Invalidate();
+        }
+
+        m_SunShadowPending = m_SunShadowState.Update(towardLight);
+        if (!m_SunShadowPending && !m_SunShadowDirty && m_SunShadowLayout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+            return TerrainSunShadowData{};   // never baked (a failed dispatch)
+
+        // The map spans the terrain's square, texel centres as the surface map's
+        const float side = m_CurrentDesc.worldSize;
+        const float texelWorldSize = GetSurfacePlacement().z;
+        TerrainSunShadowData data;
+        data.window = glm::vec4(m_CurrentDesc.position.x - 0.5f * side, m_CurrentDesc.position.z - 0.5f * side, side, 0.0f);
+        data.params = glm::vec4(texelWorldSize * TERRAIN_SUN_SHADOW_BIAS_TEXELS,
+            texelWorldSize * TERRAIN_SUN_SHADOW_PENUMBRA_TEXELS, 0.0f, 0.0f);
+        return data;
+    }
 
-        if (targetResolution != m_CurrentDesc.resolution)
+    bool TerrainSystem::DispatchSunShadow(VkCommandBuffer cmd, ComputeDispatcher* dispatcher)
+    {
+        if (!m_SunShadowPending && !m_SunShadowDirty)
+            return false;
+
+        // A map PrepareSunShadow hasn't resized yet waits for next frame
+        if (!m_SunShadowMap || !m_SurfaceMap || m_HeightmapDescriptorSet == VK_NULL_HANDLE
+            || m_CurrentDesc.streaming || m_SunShadowMap->GetWidth() != m_SurfaceMap->GetWidth()
+            || m_SunShadowMap->GetHeight() != m_SurfaceMap->GetHeight())
+        {
+            m_SunShadowPending = false;
+            return false;
+        }
+
+        VkDescriptorSet targetSet = m_DescriptorManager->AllocateTransientSet(
+            m_DescriptorManager->GetComputeImageSetLayout());
+        if (targetSet == VK_NULL_HANDLE)
         {
-            TerrainDesc desc = m_CurrentDesc;
-            desc.resolution = targetResolution;
-            Regenerate(desc);
+            LOG_ERROR("TerrainSystem: failed to allocate the sun shadow descriptor set");
+            m_SunShadowPending = false;
+            m_SunShadowDirty = true;
+            return false;
         }
+        m_DescriptorManager->UpdateComputeImageSet(targetSet, m_SunShadowMap->GetStorageImageView());
+
+        // Also orders this bake after last frame's fragment reads
+        dispatcher->TransitionImageForComputeWrite(cmd, m_SunShadowMap->GetImage(), m_SunShadowLayout);
+
+        // Set 1 samples the surface map, as the terrain draws do
+        dispatcher->BindPipeline(cmd, m_SunShadowPipeline);
+        dispatcher->BindDescriptorSet(cmd, m_SunShadowPipelineLayout, 0, targetSet);
+        dispatcher->BindDescriptorSet(cmd, m_SunShadowPipelineLayout, 1, m_HeightmapDescriptorSet);
+
+        const uint32_t width = m_SunShadowMap->GetWidth();
+        const uint32_t height = m_SunShadowMap->GetHeight();
+        const float bottom = m_CurrentDesc.position.y;
+        const TerrainSunShadowMarch march = TerrainSunShadowMarchFor(m_SunShadowState.GetLight(),
+            GetSurfacePlacement().z, std::max(width, height), m_CurrentDesc.heightScale);
+
+        SunShadowPushConstants pc{};
+        pc.target = glm::ivec4(static_cast<int>(width), static_cast<int>(height), static_cast<int>(march.steps), 0);
+        pc.march = glm::vec4(march.step, march.drop, bottom + m_CurrentDesc.heightScale);
+        pc.height = glm::vec4(m_CurrentDesc.heightScale, bottom, 0.0f, 0.0f);
+        dispatcher->PushConstants(cmd, m_SunShadowPipelineLayout, &pc, sizeof(pc));
+        dispatcher->Dispatch(cmd,
+            ComputeDispatcher::CalculateGroupCount(width, SURFACE_LOCAL_SIZE),
+            ComputeDispatcher::CalculateGroupCount(height, SURFACE_LOCAL_SIZE),
+            1);
+
+        m_SunShadowPending = false;
+        m_SunShadowDirty = false;
+        ++m_SunShadowBakes;
+
+        // The renderer's ComputeWriteToFragmentSampleBarrier finishes the trip back
+        m_SunShadowLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_SunShadowMap->SetCurrentLayout(m_SunShadowLayout);
+        return true;
     }
 
-    uint32_t TerrainSystem::SelectLODResolution(float distance, uint32_t baseResolution, float worldSize) const
+    // =========================================================================
+    // Sculpting
+    // =========================================================================
+    bool TerrainSystem::Sculpt(const TerrainBrush& brush, float deltaTime)
     {
-        uint32_t tier1Res = std::max(baseResolution / 2u, 32u);
-        uint32_t tier2Res = std::max(baseResolution / 4u, 32u);
-        uint32_t tier3Res = 32u;
+        if (!m_Ready || !m_Heightmap || !CanSculpt() || m_SculptPipeline == VK_NULL_HANDLE)
+            return false;
 
-        float b1 = worldSize * 1.0f;
-        float b2 = worldSize * 2.0f;
-        float b3 = worldSize * 4.0f;
+        TerrainBrushStroke stroke = MakeTerrainBrushStroke(brush, deltaTime,
+            m_Heightmap->GetWidth(), m_Heightmap->GetHeight(), m_CurrentDesc.position, m_CurrentDesc.worldSize);
+        if (stroke.rect.IsEmpty() || stroke.amount <= 0.0f)
+            return false;
+
+        // The generated heightmap belongs to the noise generator's cache;
+        // the first stroke copies it into one of our own
+        if (m_HeightmapCached && !m_SculptTarget)
+        {
+            m_SculptTarget = m_Renderer->GetNoiseGenerator()->CreateRegionTarget(
+                m_Heightmap->GetWidth(), m_Heightmap->GetHeight(), "TerrainSculptHeightmap");
+            if (!m_SculptTarget)
+            {
+                LOG_ERROR("TerrainSystem: failed to create the sculpt heightmap");
+                return false;
+            }
+        }
 
-        // Hysteresis: widen the boundary in the direction that keeps us in
-        // our current tier, so hovering near a threshold doesn't flicker.
-        const float kHysteresis = 0.15f;
-        bool inTier0 = (m_CurrentDesc.resolution == baseResolution);
-        bool inTier1 = !inTier0 && (m_CurrentDesc.resolution == tier1Res);
-        bool inTier2 = !inTier0 && !inTier1 && (m_CurrentDesc.resolution == tier2Res);
+        m_PendingStrokes.push_back(stroke);
+        return true;
+    }
 
-        auto adjust = [kHysteresis](float boundary, bool currentlyCloser)
+    void TerrainSystem::RecordSculptStroke(VkCommandBuffer cmd, ComputeDispatcher* dispatcher)
+    {
+        auto bindTarget = [&](VulkanTexture* heightmap)
         {
-            return currentlyCloser ? boundary * (1.0f + kHysteresis) : boundary * (1.0f - kHysteresis);
+            VkDescriptorSet targetSet = m_DescriptorManager->AllocateTransientSet(m_DescriptorManager->GetComputeImageSetLayout());
+            if (targetSet == VK_NULL_HANDLE)
+                return false;
+            m_DescriptorManager->UpdateComputeImageSet(targetSet, heightmap->GetStorageImageView());
+            dispatcher->BindDescriptorSet(cmd, m_SculptPipelineLayout, 0, targetSet);
+            return true;
         };
 
-        float adjB1 = adjust(b1, inTier0);
-        float adjB2 = adjust(b2, inTier0 || inTier1);
-        float adjB3 = adjust(b3, inTier0 || inTier1 || inTier2);
+        const TerrainBrushStroke stroke = m_PendingStrokes.front();
+        m_PendingStrokes.erase(m_PendingStrokes.begin());
+
+        // Set 1 samples the surface map, as the terrain draws do
+        dispatcher->BindPipeline(cmd, m_SculptPipeline);
+        dispatcher->BindDescriptorSet(cmd, m_SculptPipelineLayout, 1, m_HeightmapDescriptorSet);
+
+        const uint32_t width = m_Heightmap->GetWidth();
+        const uint32_t height = m_Heightmap->GetHeight();
+
+        if (m_SculptTarget)
+        {
+            dispatcher->TransitionImageForComputeWrite(cmd, m_SculptTarget->GetImage(), VK_IMAGE_LAYOUT_UNDEFINED);
+            if (!bindTarget(m_SculptTarget))
+            {
+                LOG_ERROR("TerrainSystem: failed to allocate the sculpt descriptor set");
+                return;
+            }
+
+            SculptPushConstants copy{};
+            copy.region = glm::ivec4(0, 0, static_cast<int>(width), static_cast<int>(height));
+            copy.mode = glm::uvec4(SCULPT_MODE_COPY, 0u, 0u, 0u);
+            dispatcher->PushConstants(cmd, m_SculptPipelineLayout, &copy, sizeof(copy));
+            dispatcher->Dispatch(cmd,
+                ComputeDispatcher::CalculateGroupCount(width, SURFACE_LOCAL_SIZE),
+                ComputeDispatcher::CalculateGroupCount(height, SURFACE_LOCAL_SIZE),
+                1);
+            dispatcher->ComputeToComputeImageBarrier(cmd, m_SculptTarget->GetImage());
+
+            // The generator defers its own evictions past the frames in flight
+            m_Renderer->GetNoiseGenerator()->Release(m_Heightmap);
+            m_Heightmap = m_SculptTarget;
+            m_HeightmapCached = false;
+            m_HeightmapLayout = VK_IMAGE_LAYOUT_GENERAL;
+            m_SculptTarget = nullptr;
+        }
+        else
+        {
+            dispatcher->TransitionImageForComputeWrite(cmd, m_Heightmap->GetImage(), m_HeightmapLayout);
+            if (!bindTarget(m_Heightmap))
+            {
+                LOG_ERROR("TerrainSystem: failed to allocate the sculpt descriptor set");
+                return;
+            }
+        }
+
+        SculptPushConstants pc{};
+        pc.region = glm::ivec4(stroke.rect.x, stroke.rect.y, stroke.rect.width, stroke.rect.height);
+        pc.brush = glm::vec4(stroke.centerTexel, stroke.radius, stroke.falloff);
+        pc.params = glm::vec4(stroke.amount, stroke.targetHeight, stroke.texelWorldSize);
+        pc.mode = glm::uvec4(static_cast<uint32_t>(stroke.mode), 0u, 0u, 0u);
+        dispatcher->PushConstants(cmd, m_SculptPipelineLayout, &pc, sizeof(pc));
+        dispatcher->Dispatch(cmd,
+            ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(stroke.rect.width), SURFACE_LOCAL_SIZE),
+            ComputeDispatcher::CalculateGroupCount(static_cast<uint32_t>(stroke.rect.height), SURFACE_LOCAL_SIZE),
+            1);
+
+        // Only the surface pass below samples the heightmap now
+        dispatcher->ComputeWriteToComputeSampleBarrier(cmd, m_Heightmap->GetImage());
+        m_HeightmapLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_Heightmap->SetCurrentLayout(m_HeightmapLayout);
+
+        m_HeightField.ApplyBrush(stroke);
+        m_Sculpted = true;
+
+        // Plus a texel all round: the neighbours' gradients read the stroke
+        const TerrainTexelRect dirty = stroke.rect.Expanded(1, width, height);
+        m_SurfaceRegions.push_back({ glm::ivec4(dirty.x, dirty.y, dirty.width, dirty.height) });
+
+        // The far cascades' cached terrain depth, where it can see the rect
+        const glm::vec2 worldMin = (glm::vec2(static_cast<float>(dirty.x), static_cast<float>(dirty.y))
+            / glm::vec2(static_cast<float>(width), static_cast<float>(height)) - 0.5f) * m_CurrentDesc.worldSize;
+        const glm::vec2 worldSize = glm::vec2(static_cast<float>(dirty.width), static_cast<float>(dirty.height))
+            * stroke.texelWorldSize;
+        const glm::vec3& origin = m_CurrentDesc.position;
+        m_Renderer->InvalidateShadowRegion(
+            glm::vec3(origin.x + worldMin.x, origin.y, origin.z + worldMin.y),
+            glm::vec3(origin.x + worldMin.x + worldSize.x, origin.y + m_CurrentDesc.heightScale,
+                origin.z + worldMin.y + worldSize.y));
+    }
+
+    // =========================================================================
+    // CPU height queries
+    // =========================================================================
+    // A streamed tile's texel centre at world x lies at noise uv
+    // (x - position.x) / worldSize (DispatchHeightmapUpdate's regions), so the
+    // noise there is the texel's height; between texels it is the noise
+    // itself rather than the GPU's bilinear blend of it.
+    float TerrainSystem::SampleHeight(float x, float z) const
+    {
+        if (!m_CurrentDesc.streaming)
+            return m_HeightField.SampleHeight(x, z);
+
+        const float invSize = 1.0f / m_CurrentDesc.worldSize;
+        const float noise = m_StreamingNoise.SampleUV(
+            (x - m_CurrentDesc.position.x) * invSize, (z - m_CurrentDesc.position.z) * invSize);
+        return m_CurrentDesc.position.y + noise * m_CurrentDesc.heightScale;
+    }
+
+    glm::vec3 TerrainSystem::SampleNormal(float x, float z) const
+    {
+        if (!m_CurrentDesc.streaming)
+            return m_HeightField.SampleNormal(x, z);
+
+        // As TerrainHeightField: central differences two tile texels either side
+        const float step = 2.0f * m_CurrentDesc.tileWorldSize / static_cast<float>(m_CurrentDesc.tileResolution);
+        const float hL = SampleHeight(x - step, z);
+        const float hR = SampleHeight(x + step, z);
+        const float hD = SampleHeight(x, z - step);
+        const float hU = SampleHeight(x, z + step);
+        return glm::normalize(glm::vec3(hL - hR, 2.0f * step, hD - hU));
+    }
+
+    void TerrainSystem::SampleHeights(const float* x, const float* z, float* outHeights, size_t count) const
+    {
+        if (!m_CurrentDesc.streaming)
+        {
+            m_HeightField.SampleHeights(x, z, outHeights, count);
+            return;
+        }
+
+        const float invSize = 1.0f / m_CurrentDesc.worldSize;
+        float u[NoiseField::BATCH];
+        float v[NoiseField::BATCH];
+        for (size_t first = 0; first < count; first += NoiseField::BATCH)
+        {
+            const size_t n = std::min<size_t>(NoiseField::BATCH, count - first);
+            for (size_t i = 0; i < n; ++i)
+            {
+                u[i] = (x[first + i] - m_CurrentDesc.position.x) * invSize;
+                v[i] = (z[first + i] - m_CurrentDesc.position.z) * invSize;
+            }
+            m_StreamingNoise.SampleUVs(u, v, outHeights + first, n);
+            for (size_t i = 0; i < n; ++i)
+                outHeights[first + i] = m_CurrentDesc.position.y + outHeights[first + i] * m_CurrentDesc.heightScale;
+        }
+    }
+
+    bool TerrainSystem::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+        glm::vec3& outHit) const
+    {
+        float distance = 0.0f;
+        if (!HasHeightData() || m_CurrentDesc.streaming || !m_HeightField.Raycast(origin, direction, maxDistance, distance))
+            return false;
+        outHit = origin + direction * distance;
+        return true;
+    }
+
+    // =========================================================================
+    // Heightmap readback
+    // =========================================================================
+    void TerrainSystem::RecordHeightmapReadback(VkCommandBuffer cmd, uint32_t frameIndex)
+    {
+        GpuMemoryScope memoryScope(GpuMemoryCategory::Terrain);
+
+        if (m_ReadbackState == ReadbackState::InFlight)
+        {
+            // BeginFrame waited on this slot's submission before we got here.
+            // A frames-in-flight change waits idle and restarts the indices,
+            // so a slot that no longer exists has finished too.
+            if (frameIndex == m_ReadbackFrameIndex || m_ReadbackFrameIndex >= m_Renderer->GetFramesInFlight())
+                FinishHeightmapReadback();
+            return;
+        }
+
+        if (m_ReadbackState != ReadbackState::Requested)
+            return;
+
+        if (!m_Heightmap || m_CurrentDesc.streaming)
+        {
+            m_ReadbackState = ReadbackState::Idle;
+            return;
+        }
+
+        // RGBA32F — the copy can't drop channels, Assign keeps only R
+        const size_t size = static_cast<size_t>(m_Heightmap->GetWidth()) * m_Heightmap->GetHeight() * 4 * sizeof(float);
+        m_ReadbackBuffer = m_Resources->CreateStorageBuffer("TerrainHeightmapReadback", size, true);
+        if (!m_ReadbackBuffer)
+        {
+            LOG_WARN("TerrainSystem: failed to create heightmap readback buffer — no CPU height queries");
+            m_ReadbackState = ReadbackState::Idle;
+            return;
+        }
+
+        m_Heightmap->RecordReadback(cmd, m_ReadbackBuffer->GetBuffer());
+        m_ReadbackFrameIndex = frameIndex;
+        m_ReadbackState = ReadbackState::InFlight;
+    }
+
+    void TerrainSystem::FinishHeightmapReadback()
+    {
+        void* mapped = m_ReadbackBuffer->GetPersistentMappedPtr();
+        const bool mappedHere = (mapped == nullptr);
+        if (mappedHere)
+            mapped = m_ReadbackBuffer->Map();
+
+        if (mapped)
+        {
+            m_HeightField.Assign(static_cast<const float*>(mapped),
+                m_Heightmap->GetWidth(), m_Heightmap->GetHeight(), 4);
+            LOG_INFO("TerrainSystem: heightmap read back for CPU queries ({}x{})",
+                m_HeightField.GetWidth(), m_HeightField.GetHeight());
+        }
+        else
+        {
+            LOG_WARN("TerrainSystem: failed to map heightmap readback buffer");
+        }
+
+        if (mappedHere && mapped)
+            m_ReadbackBuffer->Unmap();
+
+        DestroyReadbackBuffer();
+    }
+
+    void TerrainSystem::DestroyReadbackBuffer()
+    {
+        if (m_ReadbackBuffer)
+        {
+            m_Resources->DestroyBuffer("TerrainHeightmapReadback");
+            m_ReadbackBuffer = nullptr;
+        }
+        m_ReadbackState = ReadbackState::Idle;
+    }
+
+    uint32_t TerrainSystem::GetResidentTileCount() const
+    {
+        if (!IsStreaming() || !m_TileCache.HasWindow()) return 0;
+        const uint32_t side = 2 * m_TileCache.GetRadius() + 1;
+        return side * side;
+    }
+
+    // Heightmap texels per side across everything the quadtree covers
+    uint32_t TerrainSystem::GetFinestResolution() const
+    {
+        if (m_CurrentDesc.streaming)
+            return m_CurrentDesc.tileResolution * (2 * m_CurrentDesc.streamRadius + 1);
+        return m_CurrentDesc.resolution;
+    }
+
+    bool TerrainSystem::IsTessellated() const
+    {
+        return m_CurrentDesc.tessellation && m_Renderer && m_Renderer->SupportsTerrainTessellation();
+    }
+
+    // The full grid, or the coarse one desc tessellates
+    uint32_t TerrainSystem::PatchQuadsFor(const TerrainDesc& desc) const
+    {
+        if (!desc.tessellation || !m_Renderer->SupportsTerrainTessellation())
+            return PATCH_QUADS;
+        return TerrainTessellationBaseQuads(desc.tessellationBaseQuads, PATCH_QUADS);
+    }
 
-        if (distance < adjB1) return baseResolution;
-        if (distance < adjB2) return tier1Res;
-        if (distance < adjB3) return tier2Res;
-        return tier3Res;
+    // Enough levels that the finest one reaches `resolution` vertices per
+    // side across the whole terrain
+    uint32_t TerrainSystem::ComputeLODLevels(uint32_t resolution)
+    {
+        uint32_t levels = 1;
+        uint32_t quads = PATCH_QUADS;
+        while (quads + 1 < resolution && levels < TerrainQuadtree::MAX_LEVELS)
+        {
+            quads *= 2;
+            ++levels;
+        }
+        return levels;
     }
 
     // =========================================================================
@@ -232,30 +1220,42 @@ namespace Nightbloom
     // =========================================================================
     void TerrainSystem::SubmitDraw(DrawList& drawList) const
     {
-        if (m_SkipNextDraw) { m_SkipNextDraw = false; return; }
-
-        if (!m_Ready || !m_VertexBuffer || !m_IndexBuffer || m_IndexCount == 0)
+        // m_Patches stays empty while a streamed window is still filling
+        if (!m_Ready || !m_IndexBuffer || m_IndexCount == 0 || m_Patches.empty())
             return;
 
+        // No vertex buffer: the shaders pull the grid from gl_VertexIndex
         DrawCommand cmd;
         cmd.pipeline = PipelineType::Terrain;
-        cmd.vertexBuffer = m_VertexBuffer.get();
-        cmd.indexBuffer = m_IndexBuffer.get();
+        cmd.indexBuffer = m_IndexBuffer;
         cmd.indexCount = m_IndexCount;
-        cmd.instanceCount = 1;
 
-        // Push constants: model matrix, heightScale, texelSize
-        float texelSize = 1.0f / static_cast<float>(m_CurrentDesc.resolution - 1);
-        float gridTexelSize = 1.0f / static_cast<float>(m_CurrentDesc.resolution - 1);
-        float heightmapTexelSize = 1.0f / static_cast<float>(m_CurrentDesc.noise.width - 1);
+        // One instance per selected patch; Terrain.vert reads the records
+        // through the instance buffer
+        static_assert(sizeof(TerrainPatch) == sizeof(InstanceData), "TerrainPatch must fill one instance slot");
+        cmd.instanceCount = static_cast<uint32_t>(m_Patches.size());
+        cmd.instanceData = m_Patches.data();
+
+        // Tessellated: the coarse grid's triangles go out as patches
+        cmd.tessellated = IsTessellated();
+
+        // Push constants: model matrix, heightScale, patch grid spacing
+        float texelSize = 1.0f / static_cast<float>(m_MeshQuads);
+        float worldSize = m_CurrentDesc.worldSize;
+        if (m_CurrentDesc.streaming)
+            worldSize = static_cast<float>(2 * m_TileCache.GetRadius() + 1) * m_CurrentDesc.tileWorldSize;
 
+        // Translation only: Terrain.vert uses its surface normals as world
+        // normals, with no per-vertex normal matrix
         cmd.hasPushConstants = true;
-        cmd.pushConstants.model = glm::translate(glm::mat4(1.0f), m_CurrentDesc.position);
+        cmd.pushConstants.model = glm::translate(glm::mat4(1.0f), m_WindowCenter);
+        // w: TerrainTess.tesc's edge factor scale (unused untessellated)
+        const float viewportHeight = static_cast<float>(m_Renderer->GetRenderExtent().height);
         cmd.pushConstants.customData = glm::vec4(
             m_CurrentDesc.heightScale,
             texelSize,
-            m_CurrentDesc.worldSize,
-            heightmapTexelSize
+            worldSize,
+            cmd.tessellated ? TerrainTessScreenScale(viewportHeight, m_CurrentDesc.tessellationEdgePixels) : 0.0f
         );
 
         // Albedo texture (set 1) — use default white if available
@@ -264,7 +1264,7 @@ namespace Nightbloom
         //    cmd.textures.push_back(m_AlbedoTexture);
         //}
 
-        // Heightmap descriptor set (set 4)
+        // Surface map descriptor set (set 4)
         cmd.heightmapDescriptorSet = m_HeightmapDescriptorSet;
         cmd.textureDescriptorSet = m_TerrainTextureSet;
 
@@ -279,17 +1279,69 @@ namespace Nightbloom
     {
         if (m_Renderer)
         {
+            m_Renderer->SetTerrainSystem(nullptr); // no tile dispatches into a freed heightmap
             m_Renderer->WaitForIdle();
         }
 
+        CancelHeightmapJob();
         DestroyHeightmap();
 
-        m_VertexBuffer.reset();
-        m_IndexBuffer.reset();
+        m_IndexBuffer = nullptr;
         m_IndexCount = 0;
-        m_MeshBuilt = false;
+        m_MeshQuads = 0;
+        m_Patches.clear();
+        m_TileRequests.clear();
+        m_PendingTiles.clear();
+        m_TileCache = TerrainTileCache();
+        ResetVirtualTexture();
+        m_VirtualRequests.clear();
         m_Ready = false;
 
+        if (m_VirtualAlbedo)
+            m_Resources->DeferDestroy(m_VirtualAlbedo);
+        if (m_VirtualNormal)
+            m_Resources->DeferDestroy(m_VirtualNormal);
+        m_VirtualAlbedo = nullptr;
+        m_VirtualNormal = nullptr;
+        m_VirtualLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (m_SunShadowMap)
+            m_Resources->DeferDestroy(m_SunShadowMap);
+        m_SunShadowMap = nullptr;
+        m_SunShadowLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        m_SunShadowState.Invalidate();
+        m_SunShadowPending = false;
+        m_SunShadowDirty = false;
+
+        if (m_Renderer)
+        {
+            VkDevice device = m_Renderer->GetVkDevice();
+            if (m_SurfacePipeline != VK_NULL_HANDLE)
+                vkDestroyPipeline(device, m_SurfacePipeline, nullptr);
+            if (m_SurfacePipelineLayout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(device, m_SurfacePipelineLayout, nullptr);
+            if (m_SculptPipeline != VK_NULL_HANDLE)
+                vkDestroyPipeline(device, m_SculptPipeline, nullptr);
+            if (m_SculptPipelineLayout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(device, m_SculptPipelineLayout, nullptr);
+            if (m_VirtualPipeline != VK_NULL_HANDLE)
+                vkDestroyPipeline(device, m_VirtualPipeline, nullptr);
+            if (m_VirtualPipelineLayout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(device, m_VirtualPipelineLayout, nullptr);
+            if (m_SunShadowPipeline != VK_NULL_HANDLE)
+                vkDestroyPipeline(device, m_SunShadowPipeline, nullptr);
+            if (m_SunShadowPipelineLayout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(device, m_SunShadowPipelineLayout, nullptr);
+        }
+        m_SurfacePipeline = VK_NULL_HANDLE;
+        m_SurfacePipelineLayout = VK_NULL_HANDLE;
+        m_SculptPipeline = VK_NULL_HANDLE;
+        m_SculptPipelineLayout = VK_NULL_HANDLE;
+        m_VirtualPipeline = VK_NULL_HANDLE;
+        m_VirtualPipelineLayout = VK_NULL_HANDLE;
+        m_SunShadowPipeline = VK_NULL_HANDLE;
+        m_SunShadowPipelineLayout = VK_NULL_HANDLE;
+
         LOG_INFO("TerrainSystem shut down");
     }
 
@@ -297,76 +1349,329 @@ namespace Nightbloom
     // Private helpers
     // =========================================================================
 
-    bool TerrainSystem::BuildGridMesh(uint32_t resolution, float worldSize)
+    bool TerrainSystem::BuildPatchMesh(uint32_t quads)
+    {
+        // Terrain.vert places gl_VertexIndex within the unit patch itself
+        // (grid_vertex.glsl); only the index list is shared. Cached per size,
+        // so switching back and forth costs nothing and frames in flight
+        // keep a valid buffer.
+        m_IndexBuffer = m_Resources->GetGridIndexBuffer(quads, false);
+        if (!m_IndexBuffer)
+        {
+            m_IndexCount = 0;
+            m_MeshQuads = 0;
+            LOG_ERROR("TerrainSystem: no index buffer for a {}x{} patch grid", quads, quads);
+            return false;
+        }
+
+        m_IndexCount = GridMesh::GetIndexCount(quads);
+        m_MeshQuads = quads;
+        LOG_INFO("TerrainSystem: {}x{} patch grid ({} indices)", quads, quads, m_IndexCount);
+        return true;
+    }
+
+    // One texture for the whole window plus a spare row/column of slots;
+    // tiles are filled in later by DispatchHeightmapUpdate
+    bool TerrainSystem::CreateStreamingHeightmap(const TerrainDesc& desc)
+    {
+        if (desc.tileResolution == 0 || desc.tileWorldSize <= 0.0f || desc.worldSize <= 0.0f)
+        {
+            LOG_ERROR("TerrainSystem: invalid streaming settings");
+            return false;
+        }
+
+        const uint32_t slots = 2 * desc.streamRadius + 2;
+        const uint32_t size = slots * desc.tileResolution;
+
+        // Partially resident where the device allows it (CommitTilePages)
+        m_Heightmap = m_Renderer->GetNoiseGenerator()->CreateRegionTarget(size, size, "TerrainTileHeightmap", true);
+        if (!m_Heightmap)
+        {
+            LOG_ERROR("TerrainSystem: failed to create streaming heightmap ({}x{})", size, size);
+            return false;
+        }
+        m_HeightmapLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        LOG_INFO("TerrainSystem: streaming {}x{} tiles of {} texels ({:.1f} MB {}heightmap)",
+            2 * desc.streamRadius + 1, 2 * desc.streamRadius + 1, desc.tileResolution,
+            static_cast<double>(size) * size * 16.0 / (1024.0 * 1024.0),
+            m_Heightmap->GetSparsePages() ? "sparse " : "");
+        return true;
+    }
+
+    // A partially resident tile heightmap keeps memory only behind the slots
+    // the cache still uses (the drawn window and the step being filled), and
+    // gives the others back as the camera moves on. The surface and material
+    // maps follow the heightmap's slots.
+    void TerrainSystem::CommitTilePages(const TerrainTileCoord& cameraTile)
+    {
+        m_TileCache.EvictUnused(cameraTile);
+
+        // Requested for a window Update has already stepped past
+        m_PendingTiles.erase(std::remove_if(m_PendingTiles.begin(), m_PendingTiles.end(),
+            [this](const TerrainTileRequest& request) { return !m_TileCache.IsResident(request.tile); }),
+            m_PendingTiles.end());
+
+        const uint32_t resolution = m_CurrentDesc.tileResolution;
+        const uint32_t slots = m_TileCache.GetSlotsPerSide();
+        for (VulkanTexture* texture : { m_Heightmap, m_SurfaceMap, m_MaterialMap })
+        {
+            SparsePageTable* pages = texture ? texture->GetSparsePages() : nullptr;
+            if (!pages)
+                continue;
+
+            for (uint32_t slotZ = 0; slotZ < slots; ++slotZ)
+                for (uint32_t slotX = 0; slotX < slots; ++slotX)
+                    if (m_TileCache.IsSlotInUse(slotX, slotZ))
+                        pages->Request({ slotX * resolution, slotZ * resolution, 0, resolution, resolution, 1 });
+
+            if (!texture->CommitSparsePages())
+                LOG_WARN("TerrainSystem: failed to commit streamed tile pages");
+        }
+    }
+
+    void TerrainSystem::DestroyHeightmap()
     {
-        LOG_INFO("TerrainSystem: building {}x{} grid (worldSize={:.1f})",
-            resolution, resolution, worldSize);
+        // Everything below is released once the frames in flight are done
+        // with it. An in-flight readback copy keeps its buffer until then;
+        // its data belongs to the old heightmap either way.
+        DestroyReadbackBuffer();
+        m_HeightField.Clear();
+
+        // A streamed heightmap is owned by this system (not ResourceManager);
+        // a generated one goes back to the noise generator's cache, which
+        // defers its own evictions and has already freed it if the
+        // generator is gone
+        if (m_Heightmap && m_HeightmapCached)
+        {
+            if (NoiseTextureGenerator* noiseGen = m_Renderer ? m_Renderer->GetNoiseGenerator() : nullptr)
+                noiseGen->Release(m_Heightmap);
+        }
+        else if (m_Heightmap)
+        {
+            m_Resources->DeferDestroy(m_Heightmap);
+        }
+        m_Heightmap = nullptr;
+        m_HeightmapCached = false;
+
+        // Strokes were meant for the old heights
+        if (m_SculptTarget)
+            m_Resources->DeferDestroy(m_SculptTarget);
+        m_SculptTarget = nullptr;
+        m_PendingStrokes.clear();
+        m_Sculpted = false;
+
+        if (m_SurfaceMap)
+            m_Resources->DeferDestroy(m_SurfaceMap);
+        if (m_MaterialMap)
+            m_Resources->DeferDestroy(m_MaterialMap);
+        m_SurfaceMap = nullptr;
+        m_MaterialMap = nullptr;
+        m_SurfaceLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        m_SurfaceRegions.clear();
+
+        m_Resources->DeferFreeDescriptorSet(m_HeightmapDescriptorSet);
+        m_HeightmapDescriptorSet = VK_NULL_HANDLE;
+    }
 
-        TerrainMeshData data = TerrainMesh::Generate(resolution, worldSize);
+    // Surface and material maps the size of the heightmap, filled by
+    // DispatchHeightmapUpdate; outSet samples both. Nothing is handed out on
+    // failure.
+    bool TerrainSystem::CreateSurfaceMap(VulkanTexture* heightmap, VulkanTexture*& outSurface, VulkanTexture*& outMaterial,
+        VkDescriptorSet& outSet)
+    {
+        NoiseTextureGenerator* noiseGen = m_Renderer->GetNoiseGenerator();
+        if (!noiseGen)
+            return false;
 
-        if (data.vertices.empty() || data.indices.empty())
+        // Partially resident along with a sparse tile heightmap
+        const bool sparse = heightmap->GetSparsePages() != nullptr;
+        VulkanTexture* surface = noiseGen->CreateRegionTarget(heightmap->GetWidth(), heightmap->GetHeight(), "TerrainSurfaceMap", sparse);
+        VulkanTexture* material = noiseGen->CreateRegionTarget(heightmap->GetWidth(), heightmap->GetHeight(), "TerrainMaterialMap", sparse);
+        VkDescriptorSet set = (surface && material) ? m_DescriptorManager->AllocateHeightmapSet() : VK_NULL_HANDLE;
+        if (set == VK_NULL_HANDLE)
         {
-            LOG_ERROR("TerrainSystem: TerrainMesh::Generate returned empty data");
+            // Never recorded into
+            delete surface;
+            delete material;
             return false;
         }
+        m_DescriptorManager->UpdateHeightmapSet(set, surface, material, m_VirtualAlbedo, m_VirtualNormal);
 
-        // ---- Vertex buffer --------------------------------------------------
-        VkDeviceSize vbSize = data.vertices.size() * sizeof(VertexPNT);
-        m_VertexBuffer = m_Resources->CreateVertexBufferUnique("terrain_vb", vbSize, false);
-        if (!m_VertexBuffer)
+        outSurface = surface;
+        outMaterial = material;
+        outSet = set;
+        return true;
+    }
+
+    // One of the terrain's compute passes, with setLayouts as sets 0.. and
+    // a compute push constant range of pushConstantSize
+    bool TerrainSystem::CreateComputePipeline(const char* shaderName, uint32_t pushConstantSize,
+        const std::vector<VkDescriptorSetLayout>& setLayouts, VkPipelineLayout& outLayout, VkPipeline& outPipeline)
+    {
+        VkDevice device = m_Renderer->GetVkDevice();
+
+        auto shaderCode = AssetManager::Get().LoadShaderBinary(shaderName);
+        if (!shaderCode.IsOpen())
         {
-            LOG_ERROR("TerrainSystem: failed to create vertex buffer");
+            LOG_ERROR("TerrainSystem: failed to load {}", shaderName);
             return false;
         }
 
-        if (!m_VertexBuffer->UploadData(
-            data.vertices.data(), vbSize, 0,
-            m_Resources->GetTransferCommandPool()))
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = shaderCode.GetSize();
+        moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+        VkShaderModule shaderModule = VK_NULL_HANDLE;
+        if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
         {
-            LOG_ERROR("TerrainSystem: failed to upload vertex data");
-            m_VertexBuffer.reset();
+            LOG_ERROR("TerrainSystem: failed to create the {} shader module", shaderName);
             return false;
         }
 
-        // ---- Index buffer ---------------------------------------------------
-        VkDeviceSize ibSize = data.indices.size() * sizeof(uint32_t);
-        m_IndexBuffer = m_Resources->CreateIndexBufferUnique("terrain_ib", ibSize, false);
-        if (!m_IndexBuffer)
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushRange.offset = 0;
+        pushRange.size = pushConstantSize;
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+        layoutInfo.pSetLayouts = setLayouts.data();
+        layoutInfo.pushConstantRangeCount = 1;
+        layoutInfo.pPushConstantRanges = &pushRange;
+
+        if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &outLayout) != VK_SUCCESS)
+        {
+            LOG_ERROR("TerrainSystem: failed to create the {} pipeline layout", shaderName);
+            vkDestroyShaderModule(device, shaderModule, nullptr);
+            return false;
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = shaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = outLayout;
+
+        VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo,
+            nullptr, &outPipeline);
+        vkDestroyShaderModule(device, shaderModule, nullptr);
+
+        if (result != VK_SUCCESS)
         {
-            LOG_ERROR("TerrainSystem: failed to create index buffer");
+            LOG_ERROR("TerrainSystem: failed to create the {} pipeline", shaderName);
+            vkDestroyPipelineLayout(device, outLayout, nullptr);
+            outLayout = VK_NULL_HANDLE;
             return false;
         }
+        VulkanDebugMarkers::SetName(device, outPipeline, shaderName);
+        return true;
+    }
+
+    // Two RGBA8 arrays, a layer per clipmap level, in every heightmap set;
+    // left sampler-ready, since Terrain.frag binds them before any page is
+    // rendered
+    bool TerrainSystem::CreateVirtualTexture()
+    {
+        auto* vkDevice = static_cast<VulkanDevice*>(m_Renderer->GetDevice());
+
+        TextureDesc texDesc{};
+        texDesc.width = TerrainVirtualLayerTexels();
+        texDesc.height = TerrainVirtualLayerTexels();
+        texDesc.arrayLayers = TERRAIN_VIRTUAL_LEVELS;
+        texDesc.format = TextureFormat::RGBA8;
+        texDesc.usage = TextureUsage::Storage | TextureUsage::Sampled;
+
+        auto createArray = [&](const char* label) -> VulkanTexture*
+        {
+            auto* texture = new VulkanTexture(vkDevice, m_Renderer->GetMemoryManager());
+            if (!texture->Initialize(texDesc))
+            {
+                LOG_ERROR("TerrainSystem: failed to initialize the virtual texture's {} pages", label);
+                delete texture;
+                return nullptr;
+            }
+            return texture;
+        };
 
-        if (!m_IndexBuffer->UploadData(
-            data.indices.data(), ibSize, 0,
-            m_Resources->GetTransferCommandPool()))
+        m_VirtualAlbedo = createArray("albedo");
+        m_VirtualNormal = createArray("normal");
+        if (!m_VirtualAlbedo || !m_VirtualNormal)
         {
-            LOG_ERROR("TerrainSystem: failed to upload index data");
-            m_IndexBuffer.reset();
+            delete m_VirtualAlbedo;
+            delete m_VirtualNormal;
+            m_VirtualAlbedo = nullptr;
+            m_VirtualNormal = nullptr;
             return false;
         }
 
-        m_IndexCount = data.indexCount();
-        m_MeshBuilt = true;
+        {
+            VulkanSingleTimeCommand cmd(vkDevice, m_Resources->GetTransferCommandPool());
+            VkCommandBuffer commandBuffer = cmd.Begin();
 
-        LOG_INFO("TerrainSystem: grid mesh built ({} vertices, {} indices)",
-            data.vertexCount(), data.indexCount());
+            std::array<VkImageMemoryBarrier, 2> barriers{};
+            const VkImage images[] = { m_VirtualAlbedo->GetImage(), m_VirtualNormal->GetImage() };
+            for (uint32_t i = 0; i < 2; ++i)
+            {
+                VkImageMemoryBarrier& barrier = barriers[i];
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = images[i];
+                barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                barrier.subresourceRange.levelCount = 1;
+                barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            }
 
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+            cmd.End();
+        }
+        m_VirtualLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_VirtualAlbedo->SetCurrentLayout(m_VirtualLayout);
+        m_VirtualNormal->SetCurrentLayout(m_VirtualLayout);
+
+        const double layerTexels = static_cast<double>(TerrainVirtualLayerTexels());
+        LOG_INFO("TerrainSystem: virtual texture of {} levels, {}x{} texels each ({:.1f} MB)",
+            TERRAIN_VIRTUAL_LEVELS, TerrainVirtualLayerTexels(), TerrainVirtualLayerTexels(),
+            layerTexels * layerTexels * TERRAIN_VIRTUAL_LEVELS * 8.0 / (1024.0 * 1024.0));
         return true;
     }
 
-    void TerrainSystem::DestroyHeightmap()
+    // An R32F map the surface map's size, replacing the current one (frames
+    // in flight may still sample it); left undefined until the first bake
+    bool TerrainSystem::CreateSunShadowMap()
     {
-        // The heightmap texture is owned by this system (not ResourceManager)
-        if (m_Heightmap)
+        GpuMemoryScope memoryScope(GpuMemoryCategory::Terrain);
+
+        if (m_SunShadowMap)
+            m_Resources->DeferDestroy(m_SunShadowMap);
+        m_SunShadowMap = nullptr;
+        m_SunShadowLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        TextureDesc texDesc{};
+        texDesc.width = m_SurfaceMap->GetWidth();
+        texDesc.height = m_SurfaceMap->GetHeight();
+        texDesc.format = TextureFormat::R32F;
+        texDesc.usage = TextureUsage::Storage | TextureUsage::Sampled;
+
+        auto* texture = new VulkanTexture(static_cast<VulkanDevice*>(m_Renderer->GetDevice()), m_Renderer->GetMemoryManager());
+        if (!texture->Initialize(texDesc))
         {
-            delete m_Heightmap;
-            m_Heightmap = nullptr;
+            LOG_ERROR("TerrainSystem: failed to initialize the sun shadow map");
+            delete texture;
+            return false;
         }
-        // The descriptor set is reclaimed by the pool — no explicit free needed
-        // (pool was created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
-        // so it could be freed, but we match the pattern used by NoiseTextureGenerator)
-        m_HeightmapDescriptorSet = VK_NULL_HANDLE;
+        m_SunShadowMap = texture;
+        return true;
     }
 
-} // namespace Nightbloom
\ No newline at end of file
+} // namespace Nightbloom
@@ -1,38 +1,122 @@
 //------------------------------------------------------------------------------
 // TerrainSystem.hpp
 //
-// Manages the terrain: heightmap generation, grid mesh, descriptor set,
-// and draw command submission. Designed to be owned by EditorApp or
-// the application layer — not by Renderer directly.
+// Manages the terrain: heightmap generation, CDLOD patch selection,
+// descriptor set, and draw command submission. Designed to be owned by
+// EditorApp or the application layer — not by Renderer directly.
+//
+// Rendering: one small grid is shared by every patch the quadtree selects
+// (TerrainQuadtree.hpp). It has no vertex buffer, only the ResourceManager's
+// shared index list for its size (GridMesh.hpp). The patches go out as
+// instances of a single draw, and Terrain.vert places each vertex from
+// gl_VertexIndex, then scales, displaces and morphs it per patch, so camera
+// movement never rebuilds a mesh or stalls the GPU.
+//
+// Streaming (TerrainDesc::streaming): for worlds too large for one heightmap,
+// the world becomes an unbounded grid of tiles. The (2r+1)^2 tiles around the
+// camera are generated a few per frame in the renderer's compute pass into a
+// fixed-size toroidal heightmap (TerrainTileCache.hpp), and the quadtree
+// covers just that window, so memory stays bounded however far you travel.
+// Where the device supports sparse residency the heightmap and its surface
+// and material maps are partially resident: only the slots holding the drawn
+// window and the step being filled have memory behind them.
+//
+// Surface map: the shaders never sample the heightmap directly. Whenever it
+// changes (a regeneration, a background swap, freshly streamed tiles) the
+// renderer's terrain compute pass rebuilds the affected part of a same-sized
+// surface map (TerrainSurface.comp) holding the height and its gradient, so
+// Terrain.vert and Grass.vert get height, normal and slope from one fetch
+// instead of five. The heightmap descriptor set points at the surface map.
+//
+// Material map: the same pass bakes grass / dirt / rock weights from each
+// texel's height and slope (TerrainMaterial.hpp) into a second same-sized
+// map, bound next to the surface map for Terrain.frag. The fragment shader
+// fetches its weights once and samples only the layers that carry weight,
+// which over most of the terrain is one. A new height scale or world size
+// rebakes it.
+//
+// Virtual texture: on top of that, the blended albedo and the per-texel
+// normal are rendered into clipmap pages around the camera
+// (TerrainVirtualTexture.hpp, TerrainVirtualPage.comp) by the same compute
+// pass, a few per frame as the camera walks. The pages are kept until the
+// camera leaves them or the terrain under them changes: a regeneration
+// drops them all, a sculpted rect or a streamed tile re-renders the ones it
+// touches. Every pass that draws the terrain (main, reflection) then takes
+// its shading from one lookup; past the pages Terrain.frag blends the layers
+// itself.
+//
+// Sun shadow (single heightmap): the terrain shadows itself and everything
+// on it through a shadow height map traced from the surface map toward the
+// light (TerrainSunShadow.hpp, TerrainSunShadow.comp) instead of through
+// every shadow cascade, so the renderer draws it into the nearest ones only.
+// The same compute pass rebakes it when the light has turned far enough or
+// the terrain under it changed; otherwise it is kept.
+//
+// Sculpting (single heightmap): Sculpt queues a brush dab (TerrainBrush.hpp)
+// that the terrain compute pass applies to just the texels under it
+// (TerrainSculpt.comp), rebuilding the surface map over the same rect. The
+// CPU height field is edited in step instead of being read back, and only
+// the far shadow cascades reaching the rect re-render their terrain; grass
+// and water need no notice (grass patches span the whole height range,
+// which sculpted heights never leave). A heightmap shared through the noise
+// generator's cache is first copied into one the terrain owns.
+//
+// Tessellation (TerrainDesc::tessellation): the patches are drawn from a
+// coarse grid instead, which the TerrainTessellated pipeline splits by
+// screen-space edge length down to heightmap texels and displaces from the
+// surface map (TerrainTessellation.hpp), so the vertex work follows the
+// camera instead of the grid. Shadow casters and a separate reflection twin
+// draw the coarse grid as it is. Falls back to the full grid when the
+// renderer can't tessellate.
+//
+// Height queries: after each (single-heightmap) regeneration the heightmap is
+// copied back to the CPU asynchronously — recorded into a frame's compute
+// pass and picked up once that frame's fence has signalled — so placement and
+// physics code can call SampleHeight / SampleNormal without a GPU round trip.
 //
 // Usage:
 //   TerrainSystem terrain;
 //   terrain.Initialize(renderer);
+//   renderer->SetTerrainSystem(&terrain); // runs its compute pass
 //   terrain.Regenerate(desc);          // call whenever noise params change
+//   terrain.Sculpt(brush, deltaTime);  // each frame the brush is held
+//   terrain.UpdateLOD(cameraPosition); // call each frame
 //   terrain.SubmitDraw(drawList);      // call each frame
 //   terrain.Shutdown();
 //------------------------------------------------------------------------------
 #pragma once
 
 #include "Engine/Renderer/NoiseTextureGenerator.hpp"
+#include "Engine/Renderer/NoiseField.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Terrain/TerrainQuadtree.hpp"
+#include "Engine/Terrain/TerrainTileCache.hpp"
+#include "Engine/Terrain/TerrainHeightField.hpp"
+#include "Engine/Terrain/TerrainBrush.hpp"
+#include "Engine/Terrain/TerrainTessellation.hpp"
+#include "Engine/Terrain/TerrainVirtualTexture.hpp"
+#include "Engine/Terrain/TerrainSunShadow.hpp"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace Nightbloom
 {
 	class Renderer;
 	class ResourceManager;
 	class VulkanDescriptorManager;
+	class ComputeDispatcher;
 
 	struct TerrainDesc
 	{
         // Grid settings
-        uint32_t resolution = 256;    // vertices per side
-        float    worldSize = 200.0f; // world-space extent of the patch
+        uint32_t resolution = 256;    // vertices per side at the finest LOD (whole-terrain equivalent)
+        float    worldSize = 200.0f; // world-space extent of the terrain
+        float    lodRangeScale = 4.0f; // finest LOD's view range in leaf-patch sizes (see TerrainQuadtree)
 
         // Heightmap noise settings
         NoiseTextureDesc noise;       // passed directly to NoiseTextureGenerator
@@ -41,7 +125,25 @@ namespace Nightbloom
         float heightScale = 30.0f;    // world-space max height (Y displacement)
 
         // Transform
-        glm::vec3 position = glm::vec3(0.0f); // centre of the terrain patch
+        glm::vec3 position = glm::vec3(0.0f); // centre of the terrain patch (streaming: origin of tile 0,0)
+
+        // Streaming — tiles generated around the camera instead of one
+        // heightmap. worldSize then only sets the noise scale (world units per
+        // noise uv unit, so features match the single-patch look), and
+        // resolution / noise.width / noise.height are unused.
+        bool     streaming = false;
+        float    tileWorldSize = 256.0f; // world-space edge of one tile
+        uint32_t tileResolution = 128;   // heightmap texels per tile side
+        uint32_t streamRadius = 3;       // tiles kept on each side of the camera's tile
+        uint32_t tilesPerFrame = 2;      // generation budget while walking (a fresh window fills at once)
+
+        // Tessellation — patches drawn from a tessellationBaseQuads grid that
+        // is split near the camera until its edges cover about
+        // tessellationEdgePixels on screen (never past a heightmap texel).
+        // Needs Renderer::SupportsTerrainTessellation; the full grid otherwise.
+        bool     tessellation = false;
+        uint32_t tessellationBaseQuads = 8;
+        float    tessellationEdgePixels = 8.0f;
 	};
 
     class TerrainSystem
@@ -61,19 +163,109 @@ namespace Nightbloom
 
         //----------------------------------------------------------------------
         // Regenerate — safe to call every frame if params changed.
-        // Waits for device idle. Rebuilds the grid mesh if resolution/worldSize
-        // changed; only regenerates the heightmap if noise params changed.
+        // Builds a new heightmap only when it has to be regenerated (noise
+        // params changed; when streaming, only when the tile slot layout
+        // changes — new noise just re-streams the tiles). The old one is
+        // freed once the frames in flight are done with it, so this never
+        // waits for the device to go idle.
+        // Grid and LOD settings are picked up by the next UpdateLOD without
+        // touching the GPU.
         //----------------------------------------------------------------------
         bool Regenerate(const TerrainDesc& desc);
 
         //----------------------------------------------------------------------
-        // UpdateLOD — call once per frame before SubmitDraw. Picks a grid
-        // resolution tier based on distance from cameraPosition to the
-        // terrain's center, never exceeding baseResolution (the user-selected
-        // "near" resolution). Triggers a mesh-only Regenerate() if the tier
-        // changes (heightmap is left untouched — see Regenerate()).
+        // RequestRegenerate — Regenerate for live editing. When the single
+        // heightmap's noise changes (CanRegenerateInBackground), the new one
+        // is generated in the background while the current one stays bound,
+        // and UpdateLOD swaps it in along with the rest of desc. Requests
+        // made meanwhile collapse into the latest. Anything else goes
+        // straight to Regenerate.
         //----------------------------------------------------------------------
-        void UpdateLOD(const glm::vec3& cameraPosition, uint32_t baseResolution);
+        bool RequestRegenerate(const TerrainDesc& desc);
+        bool CanRegenerateInBackground(const TerrainDesc& desc) const;
+        bool IsRegenerating() const { return m_HeightmapJob != 0 || m_QueuedDesc.has_value(); }
+
+        //----------------------------------------------------------------------
+        // UpdateLOD — call once per frame before SubmitDraw. Re-selects the
+        // quadtree patches for cameraPosition (CPU only, no GPU work).
+        //----------------------------------------------------------------------
+        void UpdateLOD(const glm::vec3& cameraPosition);
+
+        //----------------------------------------------------------------------
+        // DispatchHeightmapUpdate — called by the Renderer's terrain compute
+        // pass. Records the tile fills UpdateLOD asked for, then rebuilds the
+        // surface map wherever the heightmap changed; returns false if there
+        // was nothing to do. The caller inserts
+        // ComputeWriteToGraphicsSampleBarrier on GetSurfaceMap()'s image when
+        // it returns true.
+        //----------------------------------------------------------------------
+        bool DispatchHeightmapUpdate(VkCommandBuffer cmd, ComputeDispatcher* dispatcher);
+
+        //----------------------------------------------------------------------
+        // DispatchVirtualPages — called by the Renderer's terrain compute pass
+        // once DispatchHeightmapUpdate's maps are ready to sample. Renders the
+        // virtual texture pages UpdateLOD asked for and those the rebuilt
+        // surface regions lie under; returns false if there were none. The
+        // caller inserts ComputeWriteToFragmentSampleBarrier on
+        // GetVirtualAlbedo()'s and GetVirtualNormal()'s images when it
+        // returns true.
+        //----------------------------------------------------------------------
+        bool DispatchVirtualPages(VkCommandBuffer cmd, ComputeDispatcher* dispatcher);
+
+        //----------------------------------------------------------------------
+        // PrepareSunShadow — called by the Renderer each frame before it
+        // writes its uniforms, with the direction toward the light. Decides
+        // whether this frame's compute pass rebakes the sun shadow map and
+        // returns the Frame UBO's block for it; off (all zero) while
+        // streaming, or with nothing baked or about to be.
+        //----------------------------------------------------------------------
+        TerrainSunShadowData PrepareSunShadow(const glm::vec3& towardLight);
+
+        //----------------------------------------------------------------------
+        // DispatchSunShadow — called by the Renderer's terrain compute pass
+        // after DispatchHeightmapUpdate. Bakes the sun shadow map if
+        // PrepareSunShadow asked for it or the surface map has changed since;
+        // returns false if it didn't. The caller inserts
+        // ComputeWriteToFragmentSampleBarrier on GetSunShadowMap()'s image
+        // when it returns true.
+        //----------------------------------------------------------------------
+        bool DispatchSunShadow(VkCommandBuffer cmd, ComputeDispatcher* dispatcher);
+
+        //----------------------------------------------------------------------
+        // RecordHeightmapReadback — called by the Renderer's terrain compute pass.
+        // Starts the CPU copy of a freshly generated heightmap, and finishes
+        // it the next time the same frame slot comes round (its fence has
+        // been waited on by then, so the copy is complete).
+        //----------------------------------------------------------------------
+        void RecordHeightmapReadback(VkCommandBuffer cmd, uint32_t frameIndex);
+
+        //----------------------------------------------------------------------
+        // CPU height queries (world space). Valid once HasHeightData() — a
+        // couple of frames after each regeneration. While streaming there is
+        // no CPU copy of the tiles: the queries evaluate the tiles' noise
+        // directly (NoiseField.hpp), anywhere in the unbounded world, valid
+        // at once. SampleHeights does that eight points at a time.
+        //----------------------------------------------------------------------
+        bool HasHeightData() const { return m_Ready && (m_CurrentDesc.streaming || m_HeightField.IsValid()); }
+        float SampleHeight(float x, float z) const;
+        glm::vec3 SampleNormal(float x, float z) const;
+        void SampleHeights(const float* x, const float* z, float* outHeights, size_t count) const;
+
+        //----------------------------------------------------------------------
+        // Sculpt — one frame's dab of `brush` over deltaTime, applied by the
+        // next terrain compute pass. Strokes land one per frame (Smooth reads
+        // the surface map the previous one rebuilt), so call it once per
+        // frame while the brush is held. Needs the single heightmap and its
+        // CPU copy (CanSculpt); new noise regenerates over the sculpted
+        // heights, other edits keep them.
+        //----------------------------------------------------------------------
+        bool Sculpt(const TerrainBrush& brush, float deltaTime);
+        bool CanSculpt() const { return HasHeightData() && !m_CurrentDesc.streaming; }
+        bool IsSculpted() const { return m_Sculpted; }
+
+        // First hit of a world-space ray with the CPU height field, e.g. to
+        // place the brush under the mouse. Single heightmap only.
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, glm::vec3& outHit) const;
 
         //----------------------------------------------------------------------
         // SubmitDraw — add the terrain draw command to the frame draw list.
@@ -88,32 +280,160 @@ namespace Nightbloom
         void Shutdown();
 
         bool IsReady() const { return m_Ready; }
+        bool IsStreaming() const { return m_Ready && m_CurrentDesc.streaming; }
 
         // Read-back for editor display
         VulkanTexture* GetHeightmap() const { return m_Heightmap; }
+        VulkanTexture* GetSurfaceMap() const { return m_SurfaceMap; }
+        VulkanTexture* GetMaterialMap() const { return m_MaterialMap; }
+        VulkanTexture* GetVirtualAlbedo() const { return m_VirtualAlbedo; }
+        VulkanTexture* GetVirtualNormal() const { return m_VirtualNormal; }
+        VulkanTexture* GetSunShadowMap() const { return m_SunShadowMap; }
         const TerrainDesc& GetDesc() const { return m_CurrentDesc; }
+        uint32_t GetPatchCount() const { return static_cast<uint32_t>(m_Patches.size()); }
+        uint32_t GetLODLevels() const { return ComputeLODLevels(GetFinestResolution()); }
+        uint32_t GetResidentTileCount() const;
+        uint32_t GetVirtualResidentLevels() const { return m_VirtualTexture.GetResidentLevelCount(); }
+        uint32_t GetVirtualPagesRendered() const { return m_VirtualPagesRendered; }
+        uint32_t GetSunShadowBakes() const { return m_SunShadowBakes; }
+
+        // The Frame UBO's virtual texture block for Terrain.frag; off (all
+        // zero) when no pages can be rendered
+        TerrainVirtualTextureData GetVirtualTextureData() const;
 
-        // For GrassSystem — it samples the same heightmap Terrain.vert does
-        // (no CPU height query exists, so this is how foliage placement
-        // shares terrain height/slope data; see GrassSystem::SubmitDraw).
+        // Quads per side of the shared patch grid. Even, so every odd vertex
+        // has an even neighbour to morph onto. A tessellated terrain draws a
+        // coarser one (GetPatchQuads).
+        static constexpr uint32_t PATCH_QUADS = 32;
+        uint32_t GetPatchQuads() const { return m_MeshQuads; }
+
+        // TerrainDesc::tessellation asked for and the renderer can do it
+        bool IsTessellated() const;
+
+        // For GrassSystem — it samples the same surface map Terrain.vert does,
+        // so blades sit on the drawn surface; see GrassSystem::SubmitDraw.
+        // While streaming it holds the toroidal tile window instead, which
+        // GrassSystem's terrain-spanning uv mapping can't address.
         VkDescriptorSet GetHeightmapDescriptorSet() const { return m_HeightmapDescriptorSet; }
 
     private:
-        bool BuildGridMesh(uint32_t resolution, float worldSize);
-        uint32_t SelectLODResolution(float distance, uint32_t baseResolution, float worldSize) const;
+        // Noise wrap period multiplier for tiles (NoiseRegion::periodScale):
+        // the field repeats every 4096 noise uv units instead of every one
+        static constexpr float TILE_NOISE_PERIOD_SCALE = 4096.0f;
+
+        bool BuildPatchMesh(uint32_t quads);
+        uint32_t PatchQuadsFor(const TerrainDesc& desc) const;
+        static uint32_t ComputeLODLevels(uint32_t resolution);
+        uint32_t GetFinestResolution() const;
+        bool CreateStreamingHeightmap(const TerrainDesc& desc);
+        void CommitTilePages(const TerrainTileCoord& cameraTile);
+        void FinishHeightmapReadback();
+        void DestroyReadbackBuffer();
         void DestroyHeightmap();
+        void UpdateHeightmapJob();
+        void CancelHeightmapJob();
+        bool CreateComputePipeline(const char* shaderName, uint32_t pushConstantSize,
+            const std::vector<VkDescriptorSetLayout>& setLayouts, VkPipelineLayout& outLayout, VkPipeline& outPipeline);
+        bool CreateSurfaceMap(VulkanTexture* heightmap, VulkanTexture*& outSurface, VulkanTexture*& outMaterial,
+            VkDescriptorSet& outSet);
+        void RebakeMaterialMap();
+        glm::vec3 GetSurfacePlacement() const;
+        bool CreateVirtualTexture();
+        void ResetVirtualTexture();
+        bool CreateSunShadowMap();
+        void RecordSurfaceRegions(VkCommandBuffer cmd, ComputeDispatcher* dispatcher);
+        void RecordSculptStroke(VkCommandBuffer cmd, ComputeDispatcher* dispatcher);
 
         Renderer* m_Renderer = nullptr;
         ResourceManager* m_Resources = nullptr;
         VulkanDescriptorManager* m_DescriptorManager = nullptr;
 
-        // GPU resources
-        std::unique_ptr<VulkanBuffer> m_VertexBuffer;
-        std::unique_ptr<VulkanBuffer> m_IndexBuffer;
-        uint32_t                      m_IndexCount = 0;
+        // The patch grid: no vertices, the shared index buffer of its size
+        // (ResourceManager::GetGridIndexBuffer, owned there)
+        Buffer*  m_IndexBuffer = nullptr;
+        uint32_t m_IndexCount = 0;
+
+        // Current quadtree selection, handed to the renderer as instance data
+        TerrainQuadtree           m_Quadtree;
+        std::vector<TerrainPatch> m_Patches;
 
         VulkanTexture* m_Heightmap = nullptr;
-        VkDescriptorSet  m_HeightmapDescriptorSet = VK_NULL_HANDLE;
+        bool           m_HeightmapCached = false;  // from NoiseTextureGenerator::Acquire, so Release, not delete
+
+        // RequestRegenerate's background heightmap (see UpdateHeightmapJob)
+        NoiseJob                   m_HeightmapJob = 0;
+        TerrainDesc                m_JobDesc;
+        std::optional<TerrainDesc> m_QueuedDesc;
+        VkDescriptorSet  m_HeightmapDescriptorSet = VK_NULL_HANDLE;  // samples m_SurfaceMap, m_MaterialMap, the virtual pages
+
+        // A texel rect (x, y, width, height) of the surface and material maps
+        // still to rebuild; streamed ones may start a texel outside and wrap.
+        // worldOffset turns its texels into world texels (a streamed tile's
+        // position in the world; zero for the single heightmap).
+        struct SurfaceRegion
+        {
+            glm::ivec4 texels;
+            glm::ivec2 worldOffset = glm::ivec2(0);
+        };
+
+        // Height + gradient built from m_Heightmap, and the material weights
+        // baked alongside (both owned by this system, in m_SurfaceLayout)
+        VulkanTexture*             m_SurfaceMap = nullptr;
+        VulkanTexture*             m_MaterialMap = nullptr;
+        VkImageLayout              m_SurfaceLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        std::vector<SurfaceRegion> m_SurfaceRegions;
+        VkPipelineLayout           m_SurfacePipelineLayout = VK_NULL_HANDLE;
+        VkPipeline                 m_SurfacePipeline = VK_NULL_HANDLE;
+
+        // Virtual texture: the page bookkeeping, the pages waiting for the
+        // compute pass (UpdateLOD's and the edited ones), and the two page
+        // arrays (owned by this system, in m_VirtualLayout)
+        TerrainVirtualTexture                  m_VirtualTexture;
+        std::vector<TerrainVirtualPageRequest> m_VirtualRequests;
+        std::vector<TerrainVirtualPageRequest> m_PendingPages;
+        VulkanTexture*                         m_VirtualAlbedo = nullptr;
+        VulkanTexture*                         m_VirtualNormal = nullptr;
+        VkImageLayout                          m_VirtualLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineLayout                       m_VirtualPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline                             m_VirtualPipeline = VK_NULL_HANDLE;
+        uint32_t                               m_VirtualPagesRendered = 0;
+
+        // Sun shadow: the light the map holds, whether this frame's pass
+        // bakes it (PrepareSunShadow asked, or the terrain changed), and the
+        // map itself (the surface map's size, owned by this system)
+        TerrainSunShadowState m_SunShadowState;
+        bool                  m_SunShadowPending = false;
+        bool                  m_SunShadowDirty = false;
+        VulkanTexture*        m_SunShadowMap = nullptr;
+        VkImageLayout         m_SunShadowLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineLayout      m_SunShadowPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline            m_SunShadowPipeline = VK_NULL_HANDLE;
+        uint32_t              m_SunShadowBakes = 0;
+
+        // Sculpting: strokes waiting for the compute pass, and the owned
+        // heightmap a cached one is copied into on the first of them
+        std::vector<TerrainBrushStroke> m_PendingStrokes;
+        VulkanTexture*          m_SculptTarget = nullptr;
+        bool                    m_Sculpted = false;
+        VkPipelineLayout        m_SculptPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline              m_SculptPipeline = VK_NULL_HANDLE;
+
+        // Streaming state. Requests are issued by UpdateLOD and written by
+        // the same frame's compute pass, before anything samples them.
+        TerrainTileCache                m_TileCache;
+        std::vector<TerrainTileRequest> m_TileRequests;
+        std::vector<TerrainTileRequest> m_PendingTiles;
+        VkImageLayout                   m_HeightmapLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        glm::vec3                       m_WindowCenter = glm::vec3(0.0f); // terrain-local origin, world space
+
+        // CPU heightmap copy and its in-flight readback (host-visible buffer
+        // owned by ResourceManager, destroyed once consumed)
+        enum class ReadbackState { Idle, Requested, InFlight };
+        TerrainHeightField m_HeightField;
+        NoiseField         m_StreamingNoise; // the tiles' noise, for CPU queries while streaming
+        ReadbackState      m_ReadbackState = ReadbackState::Idle;
+        VulkanBuffer*      m_ReadbackBuffer = nullptr;
+        uint32_t           m_ReadbackFrameIndex = 0;
 
         // Albedo placeholder — default white texture (from ResourceManager)
         VulkanTexture* m_AlbedoTexture = nullptr;
@@ -126,8 +446,7 @@ namespace Nightbloom
 
         TerrainDesc m_CurrentDesc;
         bool        m_Ready = false;
-        bool        m_MeshBuilt = false;
-        mutable bool m_SkipNextDraw = false;
+        uint32_t    m_MeshQuads = 0;   // of the built patch grid; 0 until built
     };
 
 } // Nightbloom
\ No newline at end of file
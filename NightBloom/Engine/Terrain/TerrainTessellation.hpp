@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// TerrainTessellation.hpp
+//
+// Tessellated terrain (TerrainDesc::tessellation). Every CDLOD patch is drawn
+// from a coarse grid, and TerrainTess.tesc splits each grid edge until its
+// pieces cover about targetEdgePixels on screen, but never finer than a
+// heightmap texel: past that there is no more detail to displace.
+// TerrainTess.tese then puts the new vertices on the surface map.
+//
+// An edge's factor depends only on its two end points. The triangles on
+// either side of it (in this patch or the next) therefore split it the same
+// way, and no cracks open. TerrainEdgeTessFactor is the CPU twin of the
+// control shader's; the two must stay in step.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	// maxTessellationGenerationLevel is at least 64 on every device
+	constexpr float TERRAIN_MAX_TESS_FACTOR = 64.0f;
+
+	// Quads per side of the coarse grid. It must be even, because CDLOD morphs
+	// odd vertices onto even ones. It is at least 2 and at most the grid
+	// drawn without tessellation.
+	inline uint32_t TerrainTessellationBaseQuads(uint32_t requested, uint32_t fullQuads)
+	{
+		const uint32_t quads = std::clamp(requested, 2u, std::max(fullQuads, 2u));
+		return quads & ~1u;
+	}
+
+	// Screen pixels per unit of projected size, per target edge length:
+	// viewportHeight / (2 * targetEdgePixels). TerrainTess.vert's customData.w.
+	inline float TerrainTessScreenScale(float viewportHeight, float targetEdgePixels)
+	{
+		return 0.5f * std::max(viewportHeight, 0.0f) / std::max(targetEdgePixels, 1.0f);
+	}
+
+	// Segments to split the edge a-b into. a and b are positions relative to
+	// the camera. projScaleY is the projection's [1][1]. texelWorldSize is one
+	// heightmap texel in world units (0 means no cap).
+	inline float TerrainEdgeTessFactor(const glm::vec3& a, const glm::vec3& b,
+		float projScaleY, float screenScale, float texelWorldSize)
+	{
+		// Measured around the edge's midpoint rather than along the view
+		// axis, so the factor stays the same when only the camera turns
+		const float length = glm::distance(a, b);
+		const float distance = std::max(glm::length(0.5f * (a + b)), 0.001f);
+		float factor = length * projScaleY * screenScale / distance;
+		if (texelWorldSize > 0.0f)
+			factor = std::min(factor, length / texelWorldSize);
+		return std::clamp(factor, 1.0f, TERRAIN_MAX_TESS_FACTOR);
+	}
+}
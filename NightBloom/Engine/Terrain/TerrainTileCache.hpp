@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------
+// TerrainTileCache.hpp
+//
+// Residency bookkeeping for streaming terrain. The world is an unbounded grid
+// of square tiles; the cache keeps the (2r+1)^2 tiles around a centre tile
+// drawable, stored toroidally in a fixed slots-per-side^2 heightmap (tile x
+// lives in slot x mod slotsPerSide), so memory never grows and tile data
+// never moves once written.
+//
+// slotsPerSide is 2r+2: the spare row/column is where the next window step
+// is generated while the current window keeps drawing. The centre only
+// advances one tile per axis per step, and only once the whole next window is
+// resident, so a tile that is still being drawn is never overwritten. A jump
+// with no overlap left restarts from an empty window instead.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct TerrainTileCoord
+	{
+		int32_t x = 0;
+		int32_t z = 0;
+
+		bool operator==(const TerrainTileCoord&) const = default;
+	};
+
+	// A tile to generate into its slot this frame
+	struct TerrainTileRequest
+	{
+		TerrainTileCoord tile;
+		uint32_t slotX = 0;
+		uint32_t slotZ = 0;
+	};
+
+	class TerrainTileCache
+	{
+	public:
+		TerrainTileCache() = default;
+		explicit TerrainTileCache(uint32_t radius) { Reset(radius); }
+
+		// Forget every tile; the next Update starts a fresh window
+		void Reset(uint32_t radius)
+		{
+			m_Radius = radius;
+			m_SlotsPerSide = 2 * radius + 2;
+			m_Slots.assign(static_cast<size_t>(m_SlotsPerSide) * m_SlotsPerSide, Slot{});
+			m_HasCenter = false;
+		}
+
+		// Moves the window towards `desired` and returns (in `requests`) the
+		// tiles that have to be generated for it, nearest to `desired` first,
+		// at most `budget` of them. Requested tiles count as resident right
+		// away: the caller must write every one of them before it next draws
+		// with GetCenter()'s window.
+		void Update(const TerrainTileCoord& desired, uint32_t budget, std::vector<TerrainTileRequest>& requests)
+		{
+			requests.clear();
+			if (m_Slots.empty())
+				return;
+
+			if (!m_HasCenter || Distance(desired, m_Center) > static_cast<int32_t>(2 * m_Radius))
+			{
+				std::fill(m_Slots.begin(), m_Slots.end(), Slot{});
+				m_Center = desired;
+				m_HasCenter = true;
+			}
+
+			for (;;)
+			{
+				const bool centerResident = IsWindowResident(m_Center);
+				if (centerResident && m_Center == desired)
+					return;
+
+				TerrainTileCoord target = m_Center;
+				if (centerResident)
+				{
+					target.x += std::clamp(desired.x - m_Center.x, -1, 1);
+					target.z += std::clamp(desired.z - m_Center.z, -1, 1);
+				}
+
+				if (!RequestMissing(target, desired, budget, requests))
+					return;  // out of budget, continue next frame
+
+				m_Center = target;
+			}
+		}
+
+		// Centre of the window that is safe to draw (valid once HasWindow())
+		TerrainTileCoord GetCenter() const { return m_Center; }
+
+		// True when the window around GetCenter() is fully resident
+		bool HasWindow() const { return m_HasCenter && IsWindowResident(m_Center); }
+
+		bool IsResident(const TerrainTileCoord& tile) const
+		{
+			const Slot& slot = m_Slots[SlotIndex(tile)];
+			return slot.valid && slot.tile == tile;
+		}
+
+		// Forgets the tiles outside both the drawn window and the one Update
+		// is filling towards `desired`, so a partially resident heightmap can
+		// give up their slots' memory. Walking back regenerates them.
+		void EvictUnused(const TerrainTileCoord& desired)
+		{
+			if (!m_HasCenter)
+				return;
+
+			TerrainTileCoord target = m_Center;
+			if (IsWindowResident(m_Center))
+			{
+				target.x += std::clamp(desired.x - m_Center.x, -1, 1);
+				target.z += std::clamp(desired.z - m_Center.z, -1, 1);
+			}
+
+			const int32_t r = static_cast<int32_t>(m_Radius);
+			for (Slot& slot : m_Slots)
+			{
+				if (slot.valid && Distance(slot.tile, m_Center) > r && Distance(slot.tile, target) > r)
+					slot.valid = false;
+			}
+		}
+
+		// Whether a slot holds a tile (resident, or requested and about to be)
+		bool IsSlotInUse(uint32_t slotX, uint32_t slotZ) const
+		{
+			return m_Slots[static_cast<size_t>(slotZ) * m_SlotsPerSide + slotX].valid;
+		}
+
+		uint32_t GetRadius() const { return m_Radius; }
+		uint32_t GetSlotsPerSide() const { return m_SlotsPerSide; }
+
+		// Slot column/row of a tile along one axis
+		uint32_t SlotOf(int32_t coordinate) const
+		{
+			const int32_t size = static_cast<int32_t>(m_SlotsPerSide);
+			return static_cast<uint32_t>(((coordinate % size) + size) % size);
+		}
+
+	private:
+		struct Slot
+		{
+			TerrainTileCoord tile;
+			bool valid = false;
+		};
+
+		static int32_t Distance(const TerrainTileCoord& a, const TerrainTileCoord& b)
+		{
+			return std::max(std::abs(a.x - b.x), std::abs(a.z - b.z));
+		}
+
+		size_t SlotIndex(const TerrainTileCoord& tile) const
+		{
+			return static_cast<size_t>(SlotOf(tile.z)) * m_SlotsPerSide + SlotOf(tile.x);
+		}
+
+		bool IsWindowResident(const TerrainTileCoord& center) const
+		{
+			const int32_t r = static_cast<int32_t>(m_Radius);
+			for (int32_t z = center.z - r; z <= center.z + r; ++z)
+				for (int32_t x = center.x - r; x <= center.x + r; ++x)
+					if (!IsResident({ x, z }))
+						return false;
+			return true;
+		}
+
+		// Requests the window's missing tiles within budget; true if none remain
+		bool RequestMissing(const TerrainTileCoord& center, const TerrainTileCoord& desired,
+			uint32_t& budget, std::vector<TerrainTileRequest>& requests)
+		{
+			m_Missing.clear();
+			const int32_t r = static_cast<int32_t>(m_Radius);
+			for (int32_t z = center.z - r; z <= center.z + r; ++z)
+				for (int32_t x = center.x - r; x <= center.x + r; ++x)
+					if (!IsResident({ x, z }))
+						m_Missing.push_back({ x, z });
+
+			std::sort(m_Missing.begin(), m_Missing.end(),
+				[&desired](const TerrainTileCoord& a, const TerrainTileCoord& b)
+				{
+					const int64_t ax = a.x - desired.x, az = a.z - desired.z;
+					const int64_t bx = b.x - desired.x, bz = b.z - desired.z;
+					return ax * ax + az * az < bx * bx + bz * bz;
+				});
+
+			size_t issued = 0;
+			for (; issued < m_Missing.size() && budget > 0; ++issued, --budget)
+			{
+				const TerrainTileCoord& tile = m_Missing[issued];
+				Slot& slot = m_Slots[SlotIndex(tile)];
+				slot.tile = tile;   // evicts whatever lived here
+				slot.valid = true;
+				requests.push_back({ tile, SlotOf(tile.x), SlotOf(tile.z) });
+			}
+			return issued == m_Missing.size();
+		}
+
+		uint32_t m_Radius = 0;
+		uint32_t m_SlotsPerSide = 0;
+		std::vector<Slot> m_Slots;
+		std::vector<TerrainTileCoord> m_Missing;
+
+		bool m_HasCenter = false;
+		TerrainTileCoord m_Center;
+	};
+}
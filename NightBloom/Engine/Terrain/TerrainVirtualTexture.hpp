@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+// TerrainVirtualTexture.hpp
+//
+// Page bookkeeping for the terrain's runtime virtual texture. The terrain's
+// final shading inputs (the blended layer albedo and the surface normal) are
+// rendered once into square world-space pages, then reused by every frame
+// and every pass that draws the terrain (main, reflection) until the camera
+// moves away or the terrain under them changes. Terrain.frag takes a single
+// lookup there, however many material layers the page render blends.
+//
+// The pages form a clipmap: TERRAIN_VIRTUAL_LEVELS levels, each a
+// TerrainTileCache window of (2r+1)^2 pages around the camera, with the
+// page's world size doubling per level. Level l lives in layer l of two
+// texture arrays (albedo, normal), toroidally like the streamed heightmap,
+// so a page never moves once rendered. Terrain.frag picks the finest level
+// whose texels are no smaller than the pixel's footprint and whose window
+// holds the point (TerrainVirtualLevelFor, TerrainVirtualTexture::Covers are
+// its CPU twins and must stay in step); past the coarsest window it falls
+// back to blending the layers itself.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Terrain/TerrainTileCache.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Nightbloom
+{
+	constexpr uint32_t TERRAIN_VIRTUAL_LEVELS = 6;
+	constexpr uint32_t TERRAIN_VIRTUAL_PAGE_TEXELS = 128;   // per page side
+	constexpr uint32_t TERRAIN_VIRTUAL_RADIUS = 3;          // pages kept on each side of the camera's
+	constexpr float    TERRAIN_VIRTUAL_PAGE_WORLD_SIZE = 2.0f;   // the finest level's page edge
+	constexpr uint32_t TERRAIN_VIRTUAL_PAGES_PER_FRAME = 16;     // while walking (a fresh window fills at once)
+
+	// Frame UBO block (FrameUniformData::terrainVirtual); must match
+	// TerrainVirtualData in scene_common.glsl
+	struct TerrainVirtualTextureData
+	{
+		glm::vec4 config = glm::vec4(0.0f);   // x = finest page world size, y = page texels, z = radius, w = levels (0 = none)
+		std::array<glm::ivec4, TERRAIN_VIRTUAL_LEVELS> levels{};   // xy = window centre page, z = 1 once resident
+	};
+	static_assert(sizeof(TerrainVirtualTextureData) == 16 * (1 + TERRAIN_VIRTUAL_LEVELS),
+		"Must match TerrainVirtualData in scene_common.glsl");
+
+	// A page to render into its slot of a level's layer
+	struct TerrainVirtualPageRequest
+	{
+		uint32_t level = 0;
+		TerrainTileRequest page;   // page coordinates (world xz / page world size) and slot
+	};
+
+	inline float TerrainVirtualPageWorldSize(uint32_t level)
+	{
+		return TERRAIN_VIRTUAL_PAGE_WORLD_SIZE * static_cast<float>(1u << level);
+	}
+
+	inline float TerrainVirtualTexelWorldSize(uint32_t level)
+	{
+		return TerrainVirtualPageWorldSize(level) / static_cast<float>(TERRAIN_VIRTUAL_PAGE_TEXELS);
+	}
+
+	// Texels per side of one level's layer: every slot, the spare row included
+	constexpr uint32_t TerrainVirtualLayerTexels()
+	{
+		return (2 * TERRAIN_VIRTUAL_RADIUS + 2) * TERRAIN_VIRTUAL_PAGE_TEXELS;
+	}
+
+	// The finest level whose texels cover footprint world units; a level past
+	// the last one when none do
+	inline uint32_t TerrainVirtualLevelFor(float footprint)
+	{
+		const float ratio = footprint / TerrainVirtualTexelWorldSize(0);
+		if (ratio <= 1.0f)
+			return 0;
+		const float level = std::ceil(std::log2(ratio));
+		return level >= static_cast<float>(TERRAIN_VIRTUAL_LEVELS) ? TERRAIN_VIRTUAL_LEVELS : static_cast<uint32_t>(level);
+	}
+
+	class TerrainVirtualTexture
+	{
+	public:
+		TerrainVirtualTexture() { Reset(); }
+
+		// Forget every page (the terrain under all of them changed); the next
+		// Update refills each level's window at once
+		void Reset()
+		{
+			for (TerrainTileCache& level : m_Levels)
+				level.Reset(TERRAIN_VIRTUAL_RADIUS);
+		}
+
+		static TerrainTileCoord PageOf(const glm::vec2& worldXZ, uint32_t level)
+		{
+			const float size = TerrainVirtualPageWorldSize(level);
+			return { static_cast<int32_t>(std::floor(worldXZ.x / size)), static_cast<int32_t>(std::floor(worldXZ.y / size)) };
+		}
+
+		// Moves every level's window towards the camera and returns (in
+		// `requests`) the pages to render, at most `budget` of them between
+		// the levels that already have a window, finest first. A level
+		// without one takes its whole window at once.
+		void Update(const glm::vec2& cameraXZ, uint32_t budget, std::vector<TerrainVirtualPageRequest>& requests)
+		{
+			requests.clear();
+			constexpr uint32_t windowPages = (2 * TERRAIN_VIRTUAL_RADIUS + 1) * (2 * TERRAIN_VIRTUAL_RADIUS + 1);
+			for (uint32_t level = 0; level < TERRAIN_VIRTUAL_LEVELS; ++level)
+			{
+				TerrainTileCache& cache = m_Levels[level];
+				const bool fresh = !cache.HasWindow();
+				cache.Update(PageOf(cameraXZ, level), fresh ? windowPages : budget, m_Pages);
+				for (const TerrainTileRequest& page : m_Pages)
+					requests.push_back({ level, page });
+				if (!fresh)
+					budget -= static_cast<uint32_t>(m_Pages.size());
+			}
+		}
+
+		// Resident pages overlapping the world rect [min, max], to render
+		// again after the terrain under them changed (appended to `requests`)
+		void CollectResident(const glm::vec2& min, const glm::vec2& max, std::vector<TerrainVirtualPageRequest>& requests) const
+		{
+			const int32_t reach = static_cast<int32_t>(TERRAIN_VIRTUAL_RADIUS) + 1;
+			for (uint32_t level = 0; level < TERRAIN_VIRTUAL_LEVELS; ++level)
+			{
+				// Only pages near the window can be resident; a rect covering
+				// the whole terrain mustn't walk all of its coarse pages
+				const TerrainTileCache& cache = m_Levels[level];
+				const TerrainTileCoord center = cache.GetCenter();
+				const TerrainTileCoord first = PageOf(min, level);
+				const TerrainTileCoord last = PageOf(max, level);
+				for (int32_t z = std::max(first.z, center.z - reach); z <= std::min(last.z, center.z + reach); ++z)
+				{
+					for (int32_t x = std::max(first.x, center.x - reach); x <= std::min(last.x, center.x + reach); ++x)
+					{
+						if (cache.IsResident({ x, z }))
+							requests.push_back({ level, { { x, z }, cache.SlotOf(x), cache.SlotOf(z) } });
+					}
+				}
+			}
+		}
+
+		// Whether Terrain.frag can sample `level` at worldXZ: its window is
+		// resident and holds the point a texel in from its edge, so the
+		// bilinear taps stay inside it
+		bool Covers(uint32_t level, const glm::vec2& worldXZ) const
+		{
+			const TerrainTileCache& cache = m_Levels[level];
+			if (!cache.HasWindow())
+				return false;
+
+			const glm::vec2 page = worldXZ / TerrainVirtualPageWorldSize(level)
+				- glm::vec2(static_cast<float>(cache.GetCenter().x), static_cast<float>(cache.GetCenter().z));
+			const float radius = static_cast<float>(TERRAIN_VIRTUAL_RADIUS);
+			const float margin = 1.0f / static_cast<float>(TERRAIN_VIRTUAL_PAGE_TEXELS);
+			return page.x >= -radius + margin && page.y >= -radius + margin
+				&& page.x <= radius + 1.0f - margin && page.y <= radius + 1.0f - margin;
+		}
+
+		TerrainVirtualTextureData BuildData() const
+		{
+			TerrainVirtualTextureData data;
+			data.config = glm::vec4(TERRAIN_VIRTUAL_PAGE_WORLD_SIZE, static_cast<float>(TERRAIN_VIRTUAL_PAGE_TEXELS),
+				static_cast<float>(TERRAIN_VIRTUAL_RADIUS), static_cast<float>(TERRAIN_VIRTUAL_LEVELS));
+			for (uint32_t level = 0; level < TERRAIN_VIRTUAL_LEVELS; ++level)
+			{
+				const TerrainTileCache& cache = m_Levels[level];
+				data.levels[level] = glm::ivec4(cache.GetCenter().x, cache.GetCenter().z, cache.HasWindow() ? 1 : 0, 0);
+			}
+			return data;
+		}
+
+		uint32_t GetResidentLevelCount() const
+		{
+			uint32_t count = 0;
+			for (const TerrainTileCache& level : m_Levels)
+				count += level.HasWindow() ? 1u : 0u;
+			return count;
+		}
+
+	private:
+		std::array<TerrainTileCache, TERRAIN_VIRTUAL_LEVELS> m_Levels;
+		std::vector<TerrainTileRequest> m_Pages;
+	};
+}
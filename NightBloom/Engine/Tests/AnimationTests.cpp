@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+// AnimationTests.cpp
+//
+// Unit tests for keyframe sampling, pose blending, skin matrices and the
+// SIMD quaternion blend
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Animation.hpp"
+#include "../Math/Quaternion.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+namespace
+{
+	void ExpectNear(const glm::mat4& a, const glm::mat4& b, float tolerance)
+	{
+		for (int c = 0; c < 4; ++c)
+			for (int r = 0; r < 4; ++r)
+				EXPECT_NEAR(a[c][r], b[c][r], tolerance) << "column " << c << ", row " << r;
+	}
+
+	// Same rotation (q and -q are the same one)
+	void ExpectSameRotation(const glm::quat& a, const glm::quat& b, float tolerance)
+	{
+		EXPECT_NEAR(std::abs(glm::dot(a, b)), 1.0f, tolerance);
+	}
+
+	// Root at the origin with a child one unit up
+	Skeleton MakeTwoJointSkeleton()
+	{
+		Skeleton skeleton;
+		skeleton.names = { "root", "child" };
+		skeleton.parents = { -1, 0 };
+		skeleton.restPose.resize(2);
+		skeleton.restPose[1].translation = glm::vec3(0.0f, 1.0f, 0.0f);
+		skeleton.inverseBind = { glm::mat4(1.0f), glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, 0.0f)) };
+		return skeleton;
+	}
+
+	// Root turns a quarter around Y over one second, child moves 2 up
+	AnimationClip MakeClip()
+	{
+		AnimationClip clip;
+		clip.name = "turn";
+		clip.duration = 1.0f;
+
+		AnimationChannel rotation;
+		rotation.joint = 0;
+		rotation.path = AnimationPath::Rotation;
+		rotation.times = { 0.0f, 1.0f };
+		const glm::quat quarter = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		rotation.values = { glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(quarter.x, quarter.y, quarter.z, quarter.w) };
+		clip.channels.push_back(rotation);
+
+		AnimationChannel translation;
+		translation.joint = 1;
+		translation.path = AnimationPath::Translation;
+		translation.times = { 0.0f, 1.0f };
+		translation.values = { glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(0.0f, 3.0f, 0.0f, 0.0f) };
+		clip.channels.push_back(translation);
+		return clip;
+	}
+}
+
+TEST(AnimationTest, NlerpTakesTheShortWayAndStaysUnit)
+{
+	const glm::quat a = glm::angleAxis(glm::radians(10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::quat b = glm::angleAxis(glm::radians(50.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	const glm::quat half = Simd::Nlerp(a, b, 0.5f);
+	EXPECT_NEAR(glm::length(half), 1.0f, 1e-5f);
+	ExpectSameRotation(half, glm::angleAxis(glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f)), 1e-5f);
+
+	// -b is the same rotation in the other hemisphere: still the short way
+	ExpectSameRotation(Simd::Nlerp(a, -b, 0.5f), half, 1e-5f);
+	ExpectSameRotation(Simd::Nlerp(a, b, 0.0f), a, 1e-6f);
+	ExpectSameRotation(Simd::Nlerp(a, b, 1.0f), b, 1e-6f);
+}
+
+TEST(AnimationTest, NlerpMatchesScalarReference)
+{
+	const glm::quat a = glm::normalize(glm::quat(0.9f, 0.1f, -0.3f, 0.2f));
+	const glm::quat b = glm::normalize(glm::quat(-0.4f, 0.5f, 0.6f, -0.1f));
+	for (float t : { 0.1f, 0.35f, 0.8f })
+	{
+		const glm::quat target = glm::dot(a, b) < 0.0f ? -b : b;
+		const glm::quat expected = glm::normalize(a + (target - a) * t);
+		const glm::quat actual = Simd::Nlerp(a, b, t);
+		for (int i = 0; i < 4; ++i)
+			EXPECT_NEAR(actual[i], expected[i], 1e-5f) << "t " << t << ", component " << i;
+	}
+}
+
+TEST(AnimationTest, SampleInterpolatesAndClampsToTheClip)
+{
+	const Skeleton skeleton = MakeTwoJointSkeleton();
+	const AnimationClip clip = MakeClip();
+	JointPose pose[2];
+
+	SampleAnimation(clip, skeleton, 0.5f, pose);
+	EXPECT_NEAR(pose[1].translation.y, 2.0f, 1e-5f);
+	ExpectSameRotation(pose[0].rotation, glm::angleAxis(glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f)), 1e-5f);
+
+	SampleAnimation(clip, skeleton, 5.0f, pose);
+	EXPECT_NEAR(pose[1].translation.y, 3.0f, 1e-5f);
+	SampleAnimation(clip, skeleton, -1.0f, pose);
+	EXPECT_NEAR(pose[1].translation.y, 1.0f, 1e-5f);
+}
+
+TEST(AnimationTest, StepChannelsHoldTheEarlierKey)
+{
+	const Skeleton skeleton = MakeTwoJointSkeleton();
+	AnimationClip clip = MakeClip();
+	clip.channels[1].interpolation = AnimationInterpolation::Step;
+	JointPose pose[2];
+
+	SampleAnimation(clip, skeleton, 0.9f, pose);
+	EXPECT_FLOAT_EQ(pose[1].translation.y, 1.0f);
+	SampleAnimation(clip, skeleton, 1.0f, pose);
+	EXPECT_FLOAT_EQ(pose[1].translation.y, 3.0f);
+}
+
+TEST(AnimationTest, UnanimatedJointsKeepTheirRestPose)
+{
+	Skeleton skeleton = MakeTwoJointSkeleton();
+	skeleton.restPose[1].scale = glm::vec3(2.0f);
+	AnimationClip clip = MakeClip();
+	clip.channels.pop_back();
+	JointPose pose[2];
+
+	SampleAnimation(clip, skeleton, 0.5f, pose);
+	EXPECT_EQ(pose[1].translation, glm::vec3(0.0f, 1.0f, 0.0f));
+	EXPECT_EQ(pose[1].scale, glm::vec3(2.0f));
+}
+
+TEST(AnimationTest, BlendMixesEveryComponent)
+{
+	JointPose a, b, out;
+	b.translation = glm::vec3(4.0f, 0.0f, 0.0f);
+	b.rotation = glm::angleAxis(glm::radians(60.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+	b.scale = glm::vec3(3.0f);
+
+	BlendPoses(&a, &b, 0.25f, &out, 1);
+	EXPECT_NEAR(out.translation.x, 1.0f, 1e-5f);
+	EXPECT_NEAR(out.scale.y, 1.5f, 1e-5f);
+	EXPECT_NEAR(glm::length(out.rotation), 1.0f, 1e-5f);
+	EXPECT_NEAR(glm::degrees(glm::angle(out.rotation)), 15.0f, 0.5f);
+}
+
+TEST(AnimationTest, RestPoseSkinsToIdentity)
+{
+	const Skeleton skeleton = MakeTwoJointSkeleton();
+	glm::mat4 skin[2];
+	ComputeSkinMatrices(skeleton, skeleton.restPose.data(), skin);
+	ExpectNear(skin[0], glm::mat4(1.0f), 1e-6f);
+	ExpectNear(skin[1], glm::mat4(1.0f), 1e-6f);
+}
+
+TEST(AnimationTest, ChildFollowsItsParent)
+{
+	const Skeleton skeleton = MakeTwoJointSkeleton();
+	const AnimationClip clip = MakeClip();
+	JointPose pose[2];
+	glm::mat4 skin[2];
+
+	// Root turned a quarter about Y, child stretched to y = 3: a vertex bound
+	// to the child at its bind position (0, 1, 1) ends up at (1, 3, 0)
+	SampleAnimation(clip, skeleton, 1.0f, pose);
+	ComputeSkinMatrices(skeleton, pose, skin);
+	const glm::vec3 moved = glm::vec3(skin[1] * glm::vec4(0.0f, 1.0f, 1.0f, 1.0f));
+	EXPECT_NEAR(moved.x, 1.0f, 1e-5f);
+	EXPECT_NEAR(moved.y, 3.0f, 1e-5f);
+	EXPECT_NEAR(moved.z, 0.0f, 1e-5f);
+}
+
+TEST(AnimationTest, SkeletonRequiresParentsFirst)
+{
+	Skeleton skeleton = MakeTwoJointSkeleton();
+	EXPECT_TRUE(skeleton.IsValid());
+	skeleton.parents = { 1, -1 };
+	EXPECT_FALSE(skeleton.IsValid());
+	skeleton.parents = { -1, 0 };
+	skeleton.inverseBind.pop_back();
+	EXPECT_FALSE(skeleton.IsValid());
+}
+
+TEST(AnimationTest, PackedSkinWeightsAreNormalized)
+{
+	const VertexSkin skin = PackVertexSkin(glm::uvec4(3, 7, 0, 0), glm::vec4(2.0f, 2.0f, 0.0f, 0.0f));
+	EXPECT_EQ(skin.joints[0], 3);
+	EXPECT_EQ(skin.joints[1], 7);
+	EXPECT_NEAR(skin.weights[0], 32768, 1);
+	EXPECT_NEAR(skin.weights[1], 32768, 1);
+	EXPECT_EQ(skin.weights[2], 0);
+
+	const VertexSkin unweighted = PackVertexSkin(glm::uvec4(5, 0, 0, 0), glm::vec4(0.0f));
+	EXPECT_EQ(unweighted.weights[0], 65535);
+}
+
+TEST(AnimationTest, PlayerLoopsAndCrossFades)
+{
+	const Skeleton skeleton = MakeTwoJointSkeleton();
+	std::vector<AnimationClip> clips = { MakeClip(), MakeClip() };
+	clips[1].channels[1].values = { glm::vec4(0.0f, 10.0f, 0.0f, 0.0f), glm::vec4(0.0f, 10.0f, 0.0f, 0.0f) };
+
+	AnimationPlayer player;
+	std::vector<JointPose> pose, scratch;
+	player.Evaluate(skeleton, clips, pose, scratch);
+	ASSERT_EQ(pose.size(), 2u);
+	EXPECT_EQ(pose[1].translation.y, 1.0f);   // rest pose while stopped
+
+	player.Play(0);
+	player.Advance(1.25f, clips);
+	EXPECT_NEAR(player.GetTime(), 0.25f, 1e-5f);
+
+	// Half way through a one-second fade: clip 0 at 0.75 (y = 2.5) and clip 1 (y = 10) mixed evenly
+	player.Play(1, 1.0f);
+	player.Advance(0.5f, clips);
+	player.Evaluate(skeleton, clips, pose, scratch);
+	EXPECT_NEAR(pose[1].translation.y, 6.25f, 1e-4f);
+
+	player.Advance(0.6f, clips);
+	player.Evaluate(skeleton, clips, pose, scratch);
+	EXPECT_NEAR(pose[1].translation.y, 10.0f, 1e-4f);
+
+	player.SetLooping(false);
+	player.Advance(5.0f, clips);
+	EXPECT_FLOAT_EQ(player.GetTime(), 1.0f);
+}
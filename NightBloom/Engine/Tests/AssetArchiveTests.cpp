@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+// AssetArchiveTests.cpp
+//
+// Unit tests for the packed asset archive
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/AssetArchive.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace Nightbloom;
+
+namespace
+{
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	std::vector<uint8_t> Bytes(const std::string& text)
+	{
+		return std::vector<uint8_t>(text.begin(), text.end());
+	}
+
+	std::string Text(const AssetFile& file)
+	{
+		return std::string(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+	}
+
+	std::vector<char> ReadAll(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void WriteAll(const std::string& path, const std::vector<char>& bytes)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	std::string WriteSample(const char* name)
+	{
+		AssetArchiveWriter writer;
+		writer.Add("Shaders/mesh.vert.spv", Bytes("SPIRV-VERT"));
+		writer.Add("Assets/Textures/grass.png", Bytes("not really a png"));
+		writer.Add("Assets/a", Bytes("x"));
+
+		const std::string path = TempPath(name);
+		std::string error;
+		EXPECT_TRUE(writer.Write(path, error)) << error;
+		return path;
+	}
+}
+
+TEST(AssetArchive, RoundTripsEntries)
+{
+	const std::string path = WriteSample("nb_archive_roundtrip.nbpak");
+
+	AssetArchive archive;
+	std::string error;
+	ASSERT_TRUE(archive.Open(path, error)) << error;
+	EXPECT_EQ(archive.GetEntryCount(), 3u);
+	EXPECT_EQ(archive.GetEntryPaths(),
+		(std::vector<std::string>{ "Assets/Textures/grass.png", "Assets/a", "Shaders/mesh.vert.spv" }));
+
+	EXPECT_TRUE(archive.Contains("Assets/a"));
+	EXPECT_EQ(Text(archive.Find("Shaders/mesh.vert.spv")), "SPIRV-VERT");
+	EXPECT_EQ(Text(archive.Find("Assets/Textures/grass.png")), "not really a png");
+	EXPECT_EQ(Text(archive.Find("Assets/a")), "x");
+
+	archive.Close();
+	std::filesystem::remove(path);
+}
+
+TEST(AssetArchive, MissingEntryIsNotOpen)
+{
+	const std::string path = WriteSample("nb_archive_missing.nbpak");
+
+	AssetArchive archive;
+	std::string error;
+	ASSERT_TRUE(archive.Open(path, error)) << error;
+	EXPECT_FALSE(archive.Contains("Assets/b"));
+	EXPECT_FALSE(archive.Find("Assets/b").IsOpen());
+
+	archive.Close();
+	std::filesystem::remove(path);
+}
+
+TEST(AssetArchive, EntriesAreAligned)
+{
+	const std::string path = WriteSample("nb_archive_aligned.nbpak");
+
+	AssetArchive archive;
+	std::string error;
+	ASSERT_TRUE(archive.Open(path, error)) << error;
+	for (const std::string& entryPath : archive.GetEntryPaths())
+	{
+		const AssetFile file = archive.Find(entryPath);
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(file.GetData()) % AssetArchive::ENTRY_ALIGNMENT, 0u) << entryPath;
+	}
+
+	archive.Close();
+	std::filesystem::remove(path);
+}
+
+TEST(AssetArchive, ViewOutlivesArchive)
+{
+	const std::string path = WriteSample("nb_archive_view.nbpak");
+
+	AssetFile file;
+	{
+		AssetArchive archive;
+		std::string error;
+		ASSERT_TRUE(archive.Open(path, error)) << error;
+		file = archive.Find("Shaders/mesh.vert.spv");
+	}
+	EXPECT_EQ(Text(file), "SPIRV-VERT");
+
+	file.Close();
+	std::filesystem::remove(path);
+}
+
+TEST(AssetArchive, RejectsTruncatedFile)
+{
+	const std::string path = WriteSample("nb_archive_truncated.nbpak");
+	std::vector<char> bytes = ReadAll(path);
+	bytes.resize(bytes.size() - 1);
+	WriteAll(path, bytes);
+
+	AssetArchive archive;
+	std::string error;
+	EXPECT_FALSE(archive.Open(path, error));
+	EXPECT_FALSE(archive.IsOpen());
+	EXPECT_FALSE(error.empty());
+
+	std::filesystem::remove(path);
+}
+
+TEST(AssetArchive, RejectsBadMagicAndOutOfRangeEntries)
+{
+	const std::string path = WriteSample("nb_archive_corrupt.nbpak");
+	const std::vector<char> original = ReadAll(path);
+
+	std::vector<char> bytes = original;
+	bytes[0] = 'X';
+	WriteAll(path, bytes);
+	AssetArchive archive;
+	std::string error;
+	EXPECT_FALSE(archive.Open(path, error));
+
+	// First TOC record's offset, right after the 32-byte header
+	bytes = original;
+	const uint64_t offset = UINT64_MAX - 4;
+	std::memcpy(bytes.data() + 32, &offset, sizeof(offset));
+	WriteAll(path, bytes);
+	EXPECT_FALSE(archive.Open(path, error));
+
+	std::filesystem::remove(path);
+}
+
+TEST(AssetArchive, MissingArchiveFails)
+{
+	AssetArchive archive;
+	std::string error;
+	EXPECT_FALSE(archive.Open(TempPath("nb_archive_does_not_exist.nbpak"), error));
+	EXPECT_FALSE(error.empty());
+}
+
+TEST(AssetFile, MapsLooseFile)
+{
+	const std::string path = TempPath("nb_assetfile_loose.bin");
+	WriteAll(path, { 'a', 'b', 'c' });
+
+	AssetFile file;
+	ASSERT_TRUE(file.Open(path));
+	EXPECT_EQ(Text(file), "abc");
+	EXPECT_EQ(file.GetSpan().size(), 3u);
+
+	file.Close();
+	EXPECT_FALSE(file.IsOpen());
+	std::filesystem::remove(path);
+	EXPECT_FALSE(file.Open(path));
+}
@@ -0,0 +1,308 @@
+//------------------------------------------------------------------------------
+// AssetIndexTests.cpp
+//
+// Unit tests for the asset browser's background index and thumbnail cache
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/AssetIndex.hpp"
+#include "../Renderer/ThumbnailCache.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace Nightbloom;
+namespace fs = std::filesystem;
+
+namespace
+{
+	fs::path MakeTempTree(const char* name)
+	{
+		const fs::path root = fs::temp_directory_path() / name;
+		fs::remove_all(root);
+		fs::create_directories(root);
+		return root;
+	}
+
+	void WriteFile(const fs::path& path, const std::string& contents)
+	{
+		fs::create_directories(path.parent_path());
+		std::ofstream(path, std::ios::binary) << contents;
+	}
+
+	std::vector<std::string> EntryNames(const AssetIndexSnapshot& snapshot, uint32_t folder)
+	{
+		std::vector<std::string> names;
+		for (uint32_t entry : snapshot.folders[folder].entries)
+			names.push_back(snapshot.entries[entry].name);
+		return names;
+	}
+
+	// Solid-colour images, sized by the name: "<w>x<h>"
+	bool FakeDecode(const std::string& path, std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height)
+	{
+		const std::string name = fs::path(path).filename().string();
+		if (std::sscanf(name.c_str(), "%ux%u", &width, &height) != 2)
+			return false;
+		pixels.assign(static_cast<size_t>(width) * height * 4, 200);
+		return true;
+	}
+
+	// Runs frames (Update, then the requests) until every path is ready
+	bool PumpUntilReady(ThumbnailCache& cache, const std::vector<std::string>& paths,
+		std::vector<ThumbnailCache::Cell>* outCells = nullptr)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (std::chrono::steady_clock::now() < deadline)
+		{
+			cache.Update();
+			bool all = true;
+			if (outCells)
+				outCells->assign(paths.size(), {});
+			for (size_t i = 0; i < paths.size(); ++i)
+			{
+				ThumbnailCache::Cell cell;
+				all &= cache.Request(paths[i], 1, 1, cell) == ThumbnailCache::Status::Ready;
+				if (outCells)
+					(*outCells)[i] = cell;
+			}
+			if (all)
+				return true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return false;
+	}
+}
+
+TEST(AssetIndexTest, ScanBuildsASortedFolderTree)
+{
+	const fs::path root = MakeTempTree("nb_asset_index_scan");
+	WriteFile(root / "textures" / "b.png", "b");
+	WriteFile(root / "textures" / "A.PNG", "a");
+	WriteFile(root / "textures" / "sub" / "c.ktx2", "c");
+	WriteFile(root / "shaders" / "mesh.frag", "f");
+	WriteFile(root / "shaders" / "notes.txt", "t");
+
+	const AssetIndexSnapshot snapshot = AssetIndex::Scan({
+		{ "Textures", (root / "textures").string() },
+		{ "Shaders", (root / "shaders").string() },
+		{ "Missing", (root / "models").string() },
+		{ "Again", (root / "textures").string() } });
+
+	ASSERT_EQ(snapshot.roots.size(), 2u);
+	const AssetFolder& textures = snapshot.folders[snapshot.roots[0]];
+	EXPECT_EQ(textures.name, "Textures");
+	EXPECT_EQ(EntryNames(snapshot, snapshot.roots[0]), (std::vector<std::string>{ "A.PNG", "b.png" }));
+	ASSERT_EQ(textures.folders.size(), 1u);
+	EXPECT_EQ(snapshot.folders[textures.folders[0]].parent, snapshot.roots[0]);
+	EXPECT_EQ(EntryNames(snapshot, textures.folders[0]), (std::vector<std::string>{ "c.ktx2" }));
+
+	EXPECT_EQ(snapshot.entries[snapshot.folders[snapshot.roots[0]].entries[0]].kind, AssetKind::Texture);
+	const std::vector<uint32_t>& shaders = snapshot.folders[snapshot.roots[1]].entries;
+	ASSERT_EQ(shaders.size(), 2u);
+	EXPECT_EQ(snapshot.entries[shaders[0]].kind, AssetKind::Shader);
+	EXPECT_EQ(snapshot.entries[shaders[1]].kind, AssetKind::Other);
+	EXPECT_EQ(snapshot.FindFolder((root / "shaders").string()), snapshot.roots[1]);
+
+	fs::remove_all(root);
+}
+
+TEST(AssetIndexTest, SignatureFollowsFileChanges)
+{
+	const fs::path root = MakeTempTree("nb_asset_index_signature");
+	WriteFile(root / "a.png", "a");
+	const std::vector<AssetIndex::Root> roots = { { "Root", root.string() } };
+
+	const uint64_t before = AssetIndex::Scan(roots).signature;
+	EXPECT_EQ(AssetIndex::Scan(roots).signature, before);
+
+	WriteFile(root / "a.png", "longer");
+	const uint64_t resized = AssetIndex::Scan(roots).signature;
+	EXPECT_NE(resized, before);
+
+	fs::create_directories(root / "empty");
+	EXPECT_NE(AssetIndex::Scan(roots).signature, resized);
+
+	fs::remove_all(root);
+}
+
+TEST(AssetIndexTest, WatcherPublishesOnlyChanges)
+{
+	const fs::path root = MakeTempTree("nb_asset_index_watch");
+	WriteFile(root / "a.png", "a");
+
+	AssetIndex index;
+	index.Start({ { "Root", root.string() } }, std::chrono::milliseconds(5));
+
+	auto waitForVersion = [&](uint64_t version)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (std::chrono::steady_clock::now() < deadline)
+		{
+			auto snapshot = index.GetSnapshot();
+			if (snapshot && snapshot->version >= version)
+				return snapshot;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return std::shared_ptr<const AssetIndexSnapshot>();
+	};
+
+	auto first = waitForVersion(1);
+	ASSERT_TRUE(first);
+	EXPECT_EQ(first->entries.size(), 1u);
+
+	// Several polls over an unchanged tree publish nothing new
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_EQ(index.GetSnapshot()->version, 1u);
+
+	WriteFile(root / "b.png", "b");
+	index.RequestRescan();
+	auto second = waitForVersion(2);
+	ASSERT_TRUE(second);
+	EXPECT_EQ(second->entries.size(), 2u);
+	// The first snapshot is untouched
+	EXPECT_EQ(first->entries.size(), 1u);
+
+	index.Stop();
+	fs::remove_all(root);
+}
+
+TEST(ThumbnailCacheTest, DownscaleKeepsAspectOnTransparentBlack)
+{
+	constexpr uint32_t SIZE = ThumbnailCache::THUMBNAIL_SIZE;
+	std::vector<uint8_t> wide(256 * 128 * 4, 255);
+	std::vector<uint8_t> thumbnail;
+	ThumbnailCache::Downscale(wide.data(), 256, 128, thumbnail);
+	ASSERT_EQ(thumbnail.size(), SIZE * SIZE * 4u);
+
+	auto alphaAt = [&](uint32_t x, uint32_t y) { return thumbnail[(y * SIZE + x) * 4 + 3]; };
+	EXPECT_EQ(alphaAt(0, 0), 0);
+	EXPECT_EQ(alphaAt(0, SIZE / 4 - 1), 0);
+	EXPECT_EQ(alphaAt(0, SIZE / 4), 255);
+	EXPECT_EQ(alphaAt(SIZE - 1, SIZE * 3 / 4 - 1), 255);
+	EXPECT_EQ(alphaAt(SIZE - 1, SIZE * 3 / 4), 0);
+
+	// A 2x2 checker averages to grey over 2x2 boxes
+	std::vector<uint8_t> checker(128 * 128 * 4);
+	for (uint32_t y = 0; y < 128; ++y)
+		for (uint32_t x = 0; x < 128; ++x)
+			for (int c = 0; c < 4; ++c)
+				checker[(y * 128 + x) * 4 + c] = ((x + y) & 1) ? 255 : 0;
+	ThumbnailCache::Downscale(checker.data(), 128, 128, thumbnail);
+	EXPECT_EQ(thumbnail[0], 128);
+	EXPECT_EQ(thumbnail[(SIZE * SIZE - 1) * 4], 128);
+}
+
+TEST(ThumbnailCacheTest, RoundTripsAThumbnailOnDisk)
+{
+	const fs::path dir = MakeTempTree("nb_thumbnail_disk");
+	const uint64_t key = ThumbnailCache::MakeKey("a.png", 10, 20);
+	EXPECT_NE(key, ThumbnailCache::MakeKey("a.png", 10, 21));
+	EXPECT_NE(key, ThumbnailCache::MakeKey("a.png", 11, 20));
+
+	std::vector<uint8_t> pixels(ThumbnailCache::THUMBNAIL_SIZE * ThumbnailCache::THUMBNAIL_SIZE * 4);
+	for (size_t i = 0; i < pixels.size(); ++i)
+		pixels[i] = static_cast<uint8_t>(i * 7);
+
+	const std::string path = ThumbnailCache::GetThumbnailPath(dir.string(), key);
+	ASSERT_TRUE(ThumbnailCache::WriteThumbnail(path, key, pixels));
+
+	std::vector<uint8_t> loaded;
+	ASSERT_TRUE(ThumbnailCache::ReadThumbnail(path, key, loaded));
+	EXPECT_EQ(loaded, pixels);
+	EXPECT_FALSE(ThumbnailCache::ReadThumbnail(path, key + 1, loaded));
+	EXPECT_FALSE(ThumbnailCache::ReadThumbnail(path + "x", key, loaded));
+
+	fs::remove_all(dir);
+}
+
+TEST(ThumbnailCacheTest, ProducesIntoAtlasCellsAndReusesTheDiskCache)
+{
+	const fs::path dir = MakeTempTree("nb_thumbnail_produce");
+	const std::vector<std::string> paths = { "64x64", "32x16", "8x8" };
+	std::vector<ThumbnailCache::Cell> cells;
+
+	{
+		ThumbnailCache cache(dir.string(), 1, FakeDecode);
+		cache.Start(2);
+		ASSERT_TRUE(PumpUntilReady(cache, paths, &cells));
+		EXPECT_EQ(cache.GetGeneratedCount(), 3u);
+		EXPECT_GT(cache.GetPageRevision(0), 0u);
+
+		// Distinct cells of the one page
+		for (size_t i = 0; i < cells.size(); ++i)
+		{
+			EXPECT_EQ(cells[i].page, 0u);
+			EXPECT_FLOAT_EQ(cells[i].u1 - cells[i].u0, 64.0f / 1024.0f);
+			for (size_t j = i + 1; j < cells.size(); ++j)
+				EXPECT_FALSE(cells[i].u0 == cells[j].u0 && cells[i].v0 == cells[j].v0);
+		}
+
+		ThumbnailCache::Cell cell;
+		cache.Update();
+		EXPECT_EQ(cache.Request("not an image", 1, 1, cell), ThumbnailCache::Status::Pending);
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		ThumbnailCache::Status status = ThumbnailCache::Status::Pending;
+		while (status == ThumbnailCache::Status::Pending && std::chrono::steady_clock::now() < deadline)
+		{
+			cache.Update();
+			status = cache.Request("not an image", 1, 1, cell);
+		}
+		EXPECT_EQ(status, ThumbnailCache::Status::Failed);
+	}
+
+	// A second cache (the next editor session) reads them back
+	ThumbnailCache cache(dir.string(), 1, FakeDecode);
+	cache.Start(1);
+	ASSERT_TRUE(PumpUntilReady(cache, paths));
+	EXPECT_EQ(cache.GetDiskHitCount(), 3u);
+	EXPECT_EQ(cache.GetGeneratedCount(), 0u);
+
+	fs::remove_all(dir);
+}
+
+TEST(ThumbnailCacheTest, DropsStaleRequestsBeforeTheyRun)
+{
+	ThumbnailCache cache("", 1, FakeDecode);
+	ThumbnailCache::Cell cell;
+	cache.Update();
+	cache.Request("16x16", 1, 1, cell);
+	cache.Update();
+	EXPECT_EQ(cache.GetQueuedCount(), 1u);
+
+	for (uint64_t i = 0; i <= ThumbnailCache::STALE_FRAMES; ++i)
+		cache.Update();
+	EXPECT_EQ(cache.GetQueuedCount(), 0u);
+
+	// Requested again, it is queued again and produced
+	cache.Start(1);
+	ASSERT_TRUE(PumpUntilReady(cache, { "16x16" }));
+}
+
+TEST(ThumbnailCacheTest, EvictsTheLeastRecentlyDrawnWhenFull)
+{
+	ThumbnailCache cache("", 1, FakeDecode);
+	cache.Start(2);
+
+	std::vector<std::string> paths;
+	for (uint32_t i = 0; i < ThumbnailCache::CELLS_PER_PAGE; ++i)
+		paths.push_back("4x4_" + std::to_string(i));
+	std::vector<ThumbnailCache::Cell> cells;
+	ASSERT_TRUE(PumpUntilReady(cache, paths, &cells));
+	const ThumbnailCache::Cell firstCell = cells[0];
+
+	// Stop drawing the first for a few frames
+	std::vector<std::string> rest(paths.begin() + 1, paths.end());
+	for (int frame = 0; frame < 3; ++frame)
+		ASSERT_TRUE(PumpUntilReady(cache, rest));
+
+	rest.push_back("8x8_new");
+	ASSERT_TRUE(PumpUntilReady(cache, rest, &cells));
+	EXPECT_EQ(cells.back().u0, firstCell.u0);
+	EXPECT_EQ(cells.back().v0, firstCell.v0);
+
+	ThumbnailCache::Cell cell;
+	EXPECT_EQ(cache.Request(paths[0], 1, 1, cell), ThumbnailCache::Status::Pending);
+}
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+// AssetLoadQueueTests.cpp
+//
+// Unit tests for the two-stage background asset load queue
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/AssetLoadQueue.hpp"
+#include <chrono>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Runs completions until `handle` is done (or a generous timeout)
+	void Drain(AssetLoadQueue& queue, const AssetHandle& handle)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!handle.IsDone() && std::chrono::steady_clock::now() < deadline)
+		{
+			if (queue.RunCompletions() == 0)
+				std::this_thread::yield();
+		}
+	}
+}
+
+TEST(AssetLoadQueue, PreparesInlineBeforeStartAndFinishesOnCompletion)
+{
+	AssetLoadQueue queue;
+	bool prepared = false, finished = false;
+	AssetHandle handle = queue.Submit([&]() { prepared = true; }, [&]() { finished = true; return true; });
+
+	EXPECT_TRUE(prepared);
+	EXPECT_FALSE(finished);
+	EXPECT_EQ(handle.GetState(), AssetState::Loading);
+	EXPECT_EQ(queue.GetPendingCount(), 1u);
+
+	EXPECT_EQ(queue.RunCompletions(), 1u);
+	EXPECT_TRUE(finished);
+	EXPECT_TRUE(handle.IsReady());
+	EXPECT_EQ(handle.GetFuture().get(), AssetState::Ready);
+	EXPECT_EQ(queue.GetPendingCount(), 0u);
+}
+
+TEST(AssetLoadQueue, PreparesOffTheCallingThreadAndFinishesOnIt)
+{
+	AssetLoadQueue queue;
+	queue.Start(2);
+
+	const std::thread::id caller = std::this_thread::get_id();
+	std::thread::id prepareThread, finishThread;
+	AssetHandle handle = queue.Submit(
+		[&]() { prepareThread = std::this_thread::get_id(); },
+		[&]() { finishThread = std::this_thread::get_id(); return true; });
+
+	Drain(queue, handle);
+	ASSERT_TRUE(handle.IsReady());
+	EXPECT_NE(prepareThread, caller);
+	EXPECT_EQ(finishThread, caller);
+}
+
+TEST(AssetLoadQueue, FailedFinishFailsTheHandle)
+{
+	AssetLoadQueue queue;
+	AssetHandle handle = queue.Submit(nullptr, []() { return false; });
+	queue.RunCompletions();
+	EXPECT_EQ(handle.GetState(), AssetState::Failed);
+	EXPECT_TRUE(handle.IsDone());
+}
+
+TEST(AssetLoadQueue, CancelledLoadsNeverFinish)
+{
+	AssetLoadQueue queue;
+	bool finished = false;
+	AssetHandle handle = queue.Submit(nullptr, [&]() { finished = true; return true; });
+	handle.Cancel();
+
+	EXPECT_EQ(queue.RunCompletions(), 0u);
+	EXPECT_FALSE(finished);
+	EXPECT_EQ(handle.GetState(), AssetState::Cancelled);
+	EXPECT_EQ(queue.GetPendingCount(), 0u);
+
+	// Cancelling a finished load changes nothing
+	AssetHandle done = queue.Submit(nullptr, []() { return true; });
+	queue.RunCompletions();
+	done.Cancel();
+	EXPECT_TRUE(done.IsReady());
+}
+
+TEST(AssetLoadQueue, CompletionsAreCappedPerCall)
+{
+	AssetLoadQueue queue;
+	int finished = 0;
+	for (int i = 0; i < 5; ++i)
+		queue.Submit(nullptr, [&]() { ++finished; return true; });
+
+	EXPECT_EQ(queue.RunCompletions(2), 2u);
+	EXPECT_EQ(finished, 2);
+	EXPECT_EQ(queue.RunCompletions(), 3u);
+	EXPECT_EQ(finished, 5);
+}
+
+TEST(AssetLoadQueue, StopCancelsUnfinishedLoads)
+{
+	AssetLoadQueue queue;
+	queue.Start(1);
+
+	std::vector<AssetHandle> handles;
+	for (int i = 0; i < 8; ++i)
+		handles.push_back(queue.Submit([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); },
+			[]() { return true; }));
+
+	queue.Stop();
+	EXPECT_FALSE(queue.IsRunning());
+	EXPECT_EQ(queue.GetPendingCount(), 0u);
+	for (const AssetHandle& handle : handles)
+		EXPECT_EQ(handle.GetState(), AssetState::Cancelled);
+}
+
+TEST(AssetLoadQueue, DefaultHandleIsInvalid)
+{
+	AssetHandle handle;
+	EXPECT_FALSE(handle.IsValid());
+	EXPECT_FALSE(handle.IsDone());
+	EXPECT_FALSE(handle.IsReady());
+	handle.Cancel();
+}
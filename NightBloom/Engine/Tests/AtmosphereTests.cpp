@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// AtmosphereTests.cpp
+//
+// Unit tests for the atmosphere's LUT parameterizations, transmittance and
+// rebuild thresholds
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Atmosphere.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	AtmosphereParamsData DefaultParams(const glm::vec3& towardSun = glm::vec3(0.0f, 1.0f, 0.0f), float cameraY = 2.0f)
+	{
+		return Atmosphere::BuildParams(AtmosphereSettings{}, towardSun, cameraY);
+	}
+}
+
+TEST(AtmosphereTest, DisabledAtmosphereHasNoSun)
+{
+	AtmosphereSettings settings;
+	settings.enabled = false;
+	const AtmosphereParamsData params = Atmosphere::BuildParams(settings, glm::vec3(0.3f, 0.8f, 0.1f), 5.0f);
+	EXPECT_EQ(params.sun.w, 0.0f);
+	EXPECT_EQ(params.radii, glm::vec4(0.0f));
+}
+
+TEST(AtmosphereTest, CameraStaysInsideTheAtmosphere)
+{
+	const AtmosphereSettings settings;
+	EXPECT_GT(Atmosphere::CameraRadius(settings, -500.0f), settings.planetRadius);
+	EXPECT_LT(Atmosphere::CameraRadius(settings, 1e9f), settings.planetRadius + settings.atmosphereHeight);
+	EXPECT_NEAR(Atmosphere::CameraRadius(settings, 2000.0f), settings.planetRadius + 2.0f, 1e-3f);
+}
+
+TEST(AtmosphereTest, TransmittanceLutRoundTrips)
+{
+	const AtmosphereParamsData params = DefaultParams();
+	for (float altitude : { 0.5f, 10.0f, 60.0f })
+	{
+		for (float mu : { -0.05f, 0.0f, 0.2f, 0.7f, 1.0f })
+		{
+			const float r = params.radii.x + altitude;
+			const glm::vec2 uv = Atmosphere::TransmittanceLutUv(params, r, mu);
+			float rBack = 0.0f, muBack = 0.0f;
+			Atmosphere::TransmittanceLutRMu(params, uv, rBack, muBack);
+			EXPECT_NEAR(rBack, r, 1e-2f) << altitude << " " << mu;
+			EXPECT_NEAR(muBack, mu, 2e-3f) << altitude << " " << mu;
+		}
+	}
+}
+
+TEST(AtmosphereTest, SkyViewLutRoundTrips)
+{
+	const AtmosphereParamsData params = DefaultParams();
+	const float r = params.radii.z;
+	for (float viewZenithCos : { -0.8f, -0.01f, 0.0f, 0.05f, 0.5f, 0.99f })
+	{
+		for (float lightViewCos : { -1.0f, -0.3f, 0.4f, 1.0f })
+		{
+			const glm::vec2 uv = Atmosphere::SkyViewLutUv(params, r, viewZenithCos, lightViewCos);
+			EXPECT_GT(uv.x, 0.0f);
+			EXPECT_LT(uv.x, 1.0f);
+			float zenithBack = 0.0f, lightBack = 0.0f;
+			Atmosphere::SkyViewLutParams(params, r, uv, zenithBack, lightBack);
+			EXPECT_NEAR(zenithBack, viewZenithCos, 2e-3f) << viewZenithCos << " " << lightViewCos;
+			EXPECT_NEAR(lightBack, lightViewCos, 2e-3f) << viewZenithCos << " " << lightViewCos;
+		}
+	}
+}
+
+TEST(AtmosphereTest, SkyViewHorizonSitsMidTexture)
+{
+	const AtmosphereParamsData params = DefaultParams();
+	const float r = params.radii.z;
+	const float horizonCos = -std::sqrt(r * r - params.radii.x * params.radii.x) / r;
+	const glm::vec2 uv = Atmosphere::SkyViewLutUv(params, r, horizonCos, 1.0f);
+	EXPECT_NEAR(uv.y, 0.5f, 1e-3f);
+}
+
+TEST(AtmosphereTest, LowSunIsRedder)
+{
+	const AtmosphereParamsData params = DefaultParams();
+	const float r = params.radii.z;
+	const glm::vec3 overhead = Atmosphere::SunTransmittance(params, r, 1.0f);
+	const glm::vec3 low = Atmosphere::SunTransmittance(params, r, 0.05f);
+
+	// Rayleigh takes blue first, and more of everything through more air
+	EXPECT_GT(overhead.r, overhead.b);
+	EXPECT_GT(low.r, low.b);
+	EXPECT_LT(low.r, overhead.r);
+	EXPECT_LT(low.b / low.r, overhead.b / overhead.r);
+	EXPECT_GT(overhead.g, 0.8f);
+}
+
+TEST(AtmosphereTest, SunBelowTheHorizonIsShadowed)
+{
+	const AtmosphereParamsData params = DefaultParams();
+	EXPECT_EQ(Atmosphere::SunTransmittance(params, params.radii.z, -0.2f), glm::vec3(0.0f));
+}
+
+TEST(AtmosphereTest, SkyViewRebuildsPastTheThreshold)
+{
+	const AtmosphereSettings settings;
+	const float elevation = glm::radians(20.0f);
+	const AtmosphereParamsData baked = DefaultParams(glm::vec3(std::cos(elevation), std::sin(elevation), 0.0f));
+
+	// Swinging round in azimuth alone keeps the LUT
+	const AtmosphereParamsData turned = DefaultParams(glm::vec3(0.0f, std::sin(elevation), std::cos(elevation)));
+	EXPECT_FALSE(Atmosphere::SkyViewStale(baked, turned, settings.updateThresholdDeg));
+
+	const float nudged = elevation + glm::radians(settings.updateThresholdDeg * 0.5f);
+	const AtmosphereParamsData small = DefaultParams(glm::vec3(std::cos(nudged), std::sin(nudged), 0.0f));
+	EXPECT_FALSE(Atmosphere::SkyViewStale(baked, small, settings.updateThresholdDeg));
+
+	const float moved = elevation + glm::radians(settings.updateThresholdDeg * 2.0f);
+	const AtmosphereParamsData large = DefaultParams(glm::vec3(std::cos(moved), std::sin(moved), 0.0f));
+	EXPECT_TRUE(Atmosphere::SkyViewStale(baked, large, settings.updateThresholdDeg));
+
+	// So does the camera climbing
+	const AtmosphereParamsData climbed = DefaultParams(glm::vec3(std::cos(elevation), std::sin(elevation), 0.0f), 500.0f);
+	EXPECT_TRUE(Atmosphere::SkyViewStale(baked, climbed, settings.updateThresholdDeg));
+}
+
+TEST(AtmosphereTest, MediumChangeIgnoresSunAndCamera)
+{
+	const AtmosphereParamsData baked = DefaultParams();
+	EXPECT_FALSE(Atmosphere::MediumChanged(baked, DefaultParams(glm::vec3(1.0f, 0.2f, 0.0f), 300.0f)));
+
+	AtmosphereSettings hazy;
+	hazy.mieScattering *= 4.0f;
+	EXPECT_TRUE(Atmosphere::MediumChanged(baked, Atmosphere::BuildParams(hazy, glm::vec3(0.0f, 1.0f, 0.0f), 2.0f)));
+}
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// BenchmarkCompareTests.cpp
+//
+// Unit tests for comparing benchmark reports against a baseline
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/BenchmarkCompare.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	std::string Report(const char* name, float frameP50, float frameP95, const char* gpu, const char* device = "GPU A")
+	{
+		char text[1024];
+		std::snprintf(text, sizeof(text),
+			R"({"benchmark": {"name": "%s", "device": "%s"},)"
+			R"( "frame": {"samples": 100, "p50": %f, "p95": %f},)"
+			R"( "gpu": [%s]})",
+			name, device, frameP50, frameP95, gpu);
+		return text;
+	}
+
+	const BenchmarkMetric* Find(const BenchmarkComparison& comparison, const std::string& name)
+	{
+		for (const BenchmarkMetric& metric : comparison.metrics)
+		{
+			if (metric.name == name)
+				return &metric;
+		}
+		return nullptr;
+	}
+
+	const char* SHADOWS = R"({"queue": "Graphics", "scope": "Shadows", "samples": 100, "p50": 2.0, "p95": 3.0})";
+}
+
+TEST(BenchmarkCompare, JudgesEachPercentileAgainstItsBand)
+{
+	const std::string baseline = Report("bench", 10.0f, 12.0f, SHADOWS);
+	// frame p50 +5% (within 10%), p95 +25% (regressed); shadows p50 -50% (improved)
+	const std::string current = Report("bench", 10.5f, 15.0f,
+		R"({"queue": "Graphics", "scope": "Shadows", "samples": 100, "p50": 1.0, "p95": 3.2})");
+
+	BenchmarkComparison comparison;
+	std::string error;
+	ASSERT_TRUE(CompareBenchmarkReports(baseline, current, BenchmarkTolerance{}, comparison, error)) << error;
+	ASSERT_EQ(comparison.metrics.size(), 4u);
+	EXPECT_EQ(comparison.metrics[0].name, "frame p50");
+	EXPECT_EQ(Find(comparison, "frame p50")->verdict, BenchmarkVerdict::Within);
+	EXPECT_EQ(Find(comparison, "frame p95")->verdict, BenchmarkVerdict::Regressed);
+	EXPECT_NEAR(Find(comparison, "frame p95")->GetChange(), 0.25f, 1e-5f);
+	EXPECT_EQ(Find(comparison, "gpu Graphics/Shadows p50")->verdict, BenchmarkVerdict::Improved);
+	EXPECT_EQ(Find(comparison, "gpu Graphics/Shadows p95")->verdict, BenchmarkVerdict::Within);
+	EXPECT_TRUE(comparison.HasRegressions());
+
+	const std::string text = comparison.BuildText();
+	EXPECT_NE(text.find("REGRESSED (limit +10%)"), std::string::npos);
+	EXPECT_NE(text.find("1 regressed, 1 improved, 2 within tolerance"), std::string::npos);
+	EXPECT_EQ(text.find("WARNING"), std::string::npos);
+}
+
+TEST(BenchmarkCompare, SmallAbsoluteChangesNeverRegress)
+{
+	// A 0.05 ms pass doubling is +100%, but under the 0.1 ms floor
+	const std::string baseline = Report("bench", 10.0f, 12.0f,
+		R"({"queue": "Graphics", "scope": "Fireflies", "samples": 100, "p50": 0.05, "p95": 0.05})");
+	const std::string current = Report("bench", 10.0f, 12.0f,
+		R"({"queue": "Graphics", "scope": "Fireflies", "samples": 100, "p50": 0.10, "p95": 0.10})");
+
+	BenchmarkComparison comparison;
+	std::string error;
+	ASSERT_TRUE(CompareBenchmarkReports(baseline, current, BenchmarkTolerance{}, comparison, error));
+	EXPECT_FALSE(comparison.HasRegressions());
+
+	BenchmarkTolerance strict;
+	strict.minDeltaMs = 0.0f;
+	ASSERT_TRUE(CompareBenchmarkReports(baseline, current, strict, comparison, error));
+	EXPECT_EQ(comparison.Count(BenchmarkVerdict::Regressed), 2u);
+}
+
+TEST(BenchmarkCompare, ListsScopesOnlyOneSideHas)
+{
+	const std::string baseline = Report("bench", 10.0f, 12.0f, SHADOWS);
+	const std::string current = Report("bench", 10.0f, 12.0f,
+		R"({"queue": "Graphics", "scope": "Clouds", "samples": 100, "p50": 4.0, "p95": 5.0},)"
+		R"({"queue": "Graphics", "scope": "Unused", "samples": 0, "p50": 0.0, "p95": 0.0})", "GPU B");
+
+	BenchmarkComparison comparison;
+	std::string error;
+	ASSERT_TRUE(CompareBenchmarkReports(baseline, current, BenchmarkTolerance{}, comparison, error));
+	EXPECT_EQ(Find(comparison, "gpu Graphics/Clouds p95")->verdict, BenchmarkVerdict::Added);
+	EXPECT_EQ(Find(comparison, "gpu Graphics/Shadows p50")->verdict, BenchmarkVerdict::Removed);
+	EXPECT_EQ(Find(comparison, "gpu Graphics/Unused p50"), nullptr);
+	EXPECT_FALSE(comparison.HasRegressions());
+	EXPECT_NE(comparison.BuildText().find("WARNING: baseline from 'GPU A', this run on 'GPU B'"), std::string::npos);
+}
+
+TEST(BenchmarkCompare, RejectsMismatchedOrMalformedReports)
+{
+	BenchmarkComparison comparison;
+	std::string error;
+	EXPECT_FALSE(CompareBenchmarkReports(Report("a", 1, 1, ""), Report("b", 1, 1, ""), BenchmarkTolerance{},
+		comparison, error));
+	EXPECT_NE(error.find("'a'"), std::string::npos);
+
+	EXPECT_FALSE(CompareBenchmarkReports("{ not json", Report("a", 1, 1, ""), BenchmarkTolerance{}, comparison, error));
+	EXPECT_FALSE(CompareBenchmarkReports(Report("a", 1, 1, ""), "[]", BenchmarkTolerance{}, comparison, error));
+}
@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+// BenchmarkReportTests.cpp
+//
+// Unit tests for NightbloomBench's frame-time percentiles and JSON report
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/BenchmarkReport.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	CpuProfileThread Thread(const char* name, std::vector<CpuProfileEvent> events)
+	{
+		CpuProfileThread thread;
+		thread.name = name;
+		thread.events = std::move(events);
+		return thread;
+	}
+
+	CpuProfileEvent Event(const char* name, uint64_t startMs, uint64_t endMs, uint32_t depth)
+	{
+		CpuProfileEvent event;
+		event.name = name;
+		event.startNs = startMs * 1000000;
+		event.endNs = endMs * 1000000;
+		event.depth = depth;
+		return event;
+	}
+
+	const BenchmarkReport::CpuScope* FindCpu(const std::vector<BenchmarkReport::CpuScope>& stats,
+		const std::string& thread, const std::string& path)
+	{
+		for (const auto& entry : stats)
+		{
+			if (entry.thread == thread && entry.path == path)
+				return &entry;
+		}
+		return nullptr;
+	}
+}
+
+TEST(BenchmarkReport, SeriesUsesNearestRankPercentiles)
+{
+	std::vector<float> samples;
+	for (int i = 100; i >= 1; --i)
+		samples.push_back(static_cast<float>(i));
+
+	BenchmarkSeries series = BenchmarkSeries::FromSamples(samples);
+	EXPECT_EQ(series.samples, 100u);
+	EXPECT_FLOAT_EQ(series.min, 1.0f);
+	EXPECT_FLOAT_EQ(series.max, 100.0f);
+	EXPECT_FLOAT_EQ(series.avg, 50.5f);
+	EXPECT_FLOAT_EQ(series.p50, 50.0f);
+	EXPECT_FLOAT_EQ(series.p95, 95.0f);
+	EXPECT_FLOAT_EQ(series.p99, 99.0f);
+
+	EXPECT_EQ(BenchmarkSeries::FromSamples({}).samples, 0u);
+}
+
+TEST(BenchmarkReport, NestsCpuScopesAndSumsRepeatsPerFrame)
+{
+	BenchmarkReport report;
+
+	// Children complete (and so are recorded) before their parents
+	CpuProfileCapture frame;
+	frame.threads.push_back(Thread("Main", {
+		Event("Update", 0, 2, 1),
+		Event("Render", 2, 5, 1),
+		Event("Frame", 0, 6, 0) }));
+	frame.threads.push_back(Thread("Job Worker 0", {
+		Event("Job", 1, 2, 0),
+		Event("Job", 3, 5, 0) }));
+	report.AddFrame(6.0f, frame);
+
+	CpuProfileCapture second;
+	second.threads.push_back(Thread("Main", {
+		Event("Update", 10, 14, 1),
+		Event("Frame", 10, 18, 0) }));
+	report.AddFrame(8.0f, second);
+
+	const auto stats = report.ComputeCpuStats();
+	const auto* frameScope = FindCpu(stats, "Main", "Frame");
+	const auto* update = FindCpu(stats, "Main", "Frame/Update");
+	const auto* render = FindCpu(stats, "Main", "Frame/Render");
+	const auto* job = FindCpu(stats, "Job Worker 0", "Job");
+	ASSERT_TRUE(frameScope && update && render && job);
+
+	EXPECT_EQ(frameScope->ms.samples, 2u);
+	EXPECT_FLOAT_EQ(frameScope->ms.max, 8.0f);
+	EXPECT_FLOAT_EQ(update->ms.min, 2.0f);
+	EXPECT_FLOAT_EQ(update->ms.max, 4.0f);
+	// Didn't run in the second frame: one sample, not a zero
+	EXPECT_EQ(render->ms.samples, 1u);
+	EXPECT_EQ(job->ms.samples, 1u);
+	EXPECT_FLOAT_EQ(job->ms.avg, 3.0f);
+
+	EXPECT_EQ(report.GetFrameCount(), 2u);
+	EXPECT_FLOAT_EQ(report.GetFrameStats().avg, 7.0f);
+}
+
+TEST(BenchmarkReport, GpuStatsIncludeQueueTotalsAndJsonHasEverySection)
+{
+	GpuProfileHistory history;
+	for (uint64_t n = 1; n <= 4; ++n)
+	{
+		GpuFrameProfile frame;
+		frame.frameNumber = n;
+		GpuSpan shadows;
+		shadows.name = "Shadows";
+		shadows.ms = 1.0f;
+		GpuSpan cascade;
+		cascade.name = "Cascade \"0\"";
+		cascade.parent = 0;
+		cascade.depth = 1;
+		cascade.ms = 0.5f;
+		GpuSpan post;
+		post.name = "Post";
+		post.ms = static_cast<float>(n);
+		frame.spans = { shadows, cascade, post };
+		history.Push(std::move(frame));
+	}
+
+	const auto gpu = BenchmarkReport::ComputeGpuStats(history);
+	ASSERT_GE(gpu.size(), 4u);
+	EXPECT_EQ(gpu[0].path, "<Graphics>");
+	EXPECT_EQ(gpu[0].ms.samples, 4u);
+	EXPECT_FLOAT_EQ(gpu[0].ms.max, 5.0f);   // Shadows + Post; the cascade is inside Shadows
+	EXPECT_EQ(gpu[1].path, "Shadows");
+
+	BenchmarkReport report;
+	CpuProfileCapture cpu;
+	cpu.threads.push_back(Thread("Main", { Event("Frame", 0, 4, 0) }));
+	report.AddFrame(4.0f, cpu);
+
+	BenchmarkInfo info;
+	info.name = "flythrough";
+	info.timestep = 1.0f / 60.0f;
+	const std::string json = report.BuildJson(info, &history);
+	EXPECT_NE(json.find("\"name\":\"flythrough\""), std::string::npos);
+	EXPECT_NE(json.find("\"frame\": {\"samples\":1"), std::string::npos);
+	EXPECT_NE(json.find("\"scope\":\"Frame\""), std::string::npos);
+	EXPECT_NE(json.find("\"scope\":\"Shadows/Cascade \\\"0\\\"\""), std::string::npos);
+	EXPECT_NE(json.find("\"queue\":\"Graphics\""), std::string::npos);
+
+	// No GPU timing: an empty list, still valid JSON
+	const std::string cpuOnly = report.BuildJson(info, nullptr);
+	EXPECT_NE(cpuOnly.find("\"gpu\": []"), std::string::npos);
+}
+
+TEST(BenchmarkReport, RenderStatsArePerPassAndCounter)
+{
+	BenchmarkReport report;
+	for (uint64_t n = 1; n <= 3; ++n)
+	{
+		RenderFrameStats frame;
+		RenderPassStats shadow;
+		shadow.name = "Shadow";
+		shadow.counters[static_cast<uint32_t>(RenderCounter::DrawCalls)] = n * 10;
+		frame.totals = shadow.counters;
+		// Bloom only ran in the last frame
+		if (n == 3)
+		{
+			RenderPassStats bloom;
+			bloom.name = "Bloom";
+			bloom.counters[static_cast<uint32_t>(RenderCounter::Dispatches)] = 8;
+			frame.passes.push_back(bloom);
+		}
+		frame.passes.push_back(shadow);
+		report.AddRenderStats(frame);
+	}
+
+	const auto stats = report.ComputeRenderStats();
+	ASSERT_EQ(stats.size(), 3u);
+	EXPECT_EQ(stats[0].pass, "<Frame>");
+	EXPECT_EQ(stats[1].pass, "Shadow");
+	const BenchmarkSeries& draws = stats[1].counters[static_cast<uint32_t>(RenderCounter::DrawCalls)];
+	EXPECT_EQ(draws.samples, 3u);
+	EXPECT_FLOAT_EQ(draws.avg, 20.0f);
+	EXPECT_EQ(stats[2].counters[static_cast<uint32_t>(RenderCounter::Dispatches)].samples, 1u);
+
+	const std::string json = report.BuildJson(BenchmarkInfo{}, nullptr);
+	EXPECT_NE(json.find("\"render\": [\n    {\"pass\":\"<Frame>\",\"counter\":\"Draw Calls\""), std::string::npos);
+	EXPECT_NE(json.find("{\"pass\":\"Bloom\",\"counter\":\"Dispatches\",\"samples\":1"), std::string::npos);
+}
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+// BindlessIndexAllocatorTests.cpp
+//
+// Unit tests for bindless slot allocation
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Vulkan/BindlessIndexAllocator.hpp"
+
+using namespace Nightbloom;
+
+TEST(BindlessIndexAllocatorTest, HandsOutAscendingSlotsUntilFull)
+{
+	BindlessIndexAllocator slots(3);
+
+	EXPECT_EQ(slots.Allocate(), 0u);
+	EXPECT_EQ(slots.Allocate(), 1u);
+	EXPECT_EQ(slots.Allocate(), 2u);
+	EXPECT_EQ(slots.Allocate(), BindlessIndexAllocator::INVALID_INDEX);
+	EXPECT_EQ(slots.GetUsed(), 3u);
+}
+
+TEST(BindlessIndexAllocatorTest, ReusesReleasedSlotsFirst)
+{
+	BindlessIndexAllocator slots(8);
+
+	slots.Allocate();
+	const uint32_t second = slots.Allocate();
+	slots.Allocate();
+
+	slots.Release(second);
+	EXPECT_EQ(slots.GetUsed(), 2u);
+	EXPECT_EQ(slots.Allocate(), second);
+	EXPECT_EQ(slots.Allocate(), 3u);
+}
+
+TEST(BindlessIndexAllocatorTest, ReleasedSlotMakesRoomWhenFull)
+{
+	BindlessIndexAllocator slots(2);
+
+	slots.Allocate();
+	slots.Allocate();
+	ASSERT_EQ(slots.Allocate(), BindlessIndexAllocator::INVALID_INDEX);
+
+	slots.Release(0);
+	EXPECT_EQ(slots.Allocate(), 0u);
+}
+
+TEST(BindlessIndexAllocatorTest, IgnoresSlotsThatWereNeverAllocated)
+{
+	BindlessIndexAllocator slots(4);
+
+	slots.Allocate();
+	slots.Release(BindlessIndexAllocator::INVALID_INDEX);
+	slots.Release(3);
+	EXPECT_EQ(slots.GetUsed(), 1u);
+	EXPECT_EQ(slots.Allocate(), 1u);
+
+	slots.Reset(4);
+	EXPECT_EQ(slots.GetUsed(), 0u);
+	EXPECT_EQ(slots.Allocate(), 0u);
+}
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// CameraPathTests.cpp
+//
+// Unit tests for the scripted camera spline NightbloomBench flies through
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/CameraPath.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	CameraKey Key(float time, glm::vec3 position, glm::vec3 target)
+	{
+		CameraKey key;
+		key.time = time;
+		key.position = position;
+		key.target = target;
+		return key;
+	}
+
+	void ExpectNear(const glm::vec3& actual, const glm::vec3& expected, float tolerance = 1e-4f)
+	{
+		EXPECT_NEAR(actual.x, expected.x, tolerance);
+		EXPECT_NEAR(actual.y, expected.y, tolerance);
+		EXPECT_NEAR(actual.z, expected.z, tolerance);
+	}
+}
+
+TEST(CameraPath, LookAtMatchesCameraConventions)
+{
+	CameraPose pose = CameraPath::LookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+	EXPECT_NEAR(pose.yaw, -90.0f, 1e-3f);
+	EXPECT_NEAR(pose.pitch, 0.0f, 1e-3f);
+
+	pose = CameraPath::LookAt(glm::vec3(0.0f), glm::vec3(1.0f, 1.0f, 0.0f));
+	EXPECT_NEAR(pose.yaw, 0.0f, 1e-3f);
+	EXPECT_NEAR(pose.pitch, 45.0f, 1e-3f);
+}
+
+TEST(CameraPath, PassesThroughKeysAndHoldsAtTheEnds)
+{
+	CameraPath path;
+	// Added out of order on purpose
+	path.AddKey(Key(2.0f, glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(10.0f, 0.0f, -1.0f)));
+	path.AddKey(Key(0.0f, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)));
+	path.AddKey(Key(5.0f, glm::vec3(10.0f, 0.0f, 10.0f), glm::vec3(11.0f, 0.0f, 10.0f)));
+
+	ASSERT_EQ(path.GetKeyCount(), 3u);
+	EXPECT_FLOAT_EQ(path.GetDuration(), 5.0f);
+
+	ExpectNear(path.Evaluate(0.0f).position, glm::vec3(0.0f));
+	ExpectNear(path.Evaluate(2.0f).position, glm::vec3(10.0f, 0.0f, 0.0f));
+	ExpectNear(path.Evaluate(5.0f).position, glm::vec3(10.0f, 0.0f, 10.0f));
+	ExpectNear(path.Evaluate(-1.0f).position, glm::vec3(0.0f));
+	ExpectNear(path.Evaluate(9.0f).position, glm::vec3(10.0f, 0.0f, 10.0f));
+	EXPECT_NEAR(path.Evaluate(9.0f).yaw, 0.0f, 1e-3f);
+
+	// Halfway along a straight segment with straight neighbours
+	CameraPath line;
+	line.AddKey(Key(0.0f, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f)));
+	line.AddKey(Key(1.0f, glm::vec3(4.0f, 0.0f, 0.0f), glm::vec3(4.0f, 0.0f, -1.0f)));
+	ExpectNear(line.Evaluate(0.5f).position, glm::vec3(2.0f, 0.0f, 0.0f));
+}
+
+TEST(CameraPath, LoopsBackToTheFirstKey)
+{
+	CameraPath path;
+	path.AddKey(Key(0.0f, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f)));
+	path.AddKey(Key(1.0f, glm::vec3(4.0f, 0.0f, 0.0f), glm::vec3(4.0f, 0.0f, -1.0f)));
+	path.SetLoop(1.0f);
+
+	ASSERT_TRUE(path.IsLooping());
+	EXPECT_FLOAT_EQ(path.GetDuration(), 2.0f);
+	ExpectNear(path.Evaluate(2.0f).position, glm::vec3(0.0f));
+	ExpectNear(path.Evaluate(3.0f).position, glm::vec3(4.0f, 0.0f, 0.0f));
+
+	// Same time, same view: the runs are reproducible
+	const CameraPose a = path.Evaluate(1.37f);
+	const CameraPose b = path.Evaluate(3.37f);
+	ExpectNear(a.position, b.position, 1e-3f);
+	EXPECT_NEAR(a.yaw, b.yaw, 1e-2f);
+}
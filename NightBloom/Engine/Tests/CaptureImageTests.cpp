@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+// CaptureImageTests.cpp
+//
+// Unit tests for offscreen capture tiling and texel conversion
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/CaptureImage.hpp"
+#include "../Renderer/AuxiliaryView.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+#include <cmath>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Camera::SetPerspectiveInfiniteReverseZ's matrix
+	glm::mat4 MakePerspective(float fovDeg, float aspect, float nearPlane)
+	{
+		const float f = 1.0f / std::tan(glm::radians(fovDeg) * 0.5f);
+		glm::mat4 projection(0.0f);
+		projection[0][0] = f / aspect;
+		projection[1][1] = -f;
+		projection[2][3] = -1.0f;
+		projection[3][2] = nearPlane;
+		return projection;
+	}
+
+	// Framebuffer pixel a view-space point lands on
+	glm::vec2 ToPixel(const glm::mat4& projection, const glm::vec3& point, uint32_t width, uint32_t height)
+	{
+		const glm::vec4 clip = projection * glm::vec4(point, 1.0f);
+		const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		return glm::vec2((ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height);
+	}
+}
+
+TEST(CaptureImage, TilesCoverTheImageOnce)
+{
+	const uint32_t width = 7680, height = 4320;
+	const std::vector<CaptureTile> tiles = PlanCaptureTiles(width, height, 2048, 2048);
+	ASSERT_EQ(tiles.size(), 4u * 3u);
+
+	std::vector<uint8_t> covered(static_cast<size_t>(width / 16) * (height / 16), 0);
+	for (const CaptureTile& tile : tiles)
+	{
+		EXPECT_LE(tile.width, 2048u);
+		EXPECT_LE(tile.height, 2048u);
+		EXPECT_LE(tile.x + tile.width, width);
+		EXPECT_LE(tile.y + tile.height, height);
+		// Even split: no sliver tiles
+		EXPECT_EQ(tile.width, width / 4);
+		EXPECT_EQ(tile.height, height / 3);
+		for (uint32_t y = tile.y; y < tile.y + tile.height; y += 16)
+			for (uint32_t x = tile.x; x < tile.x + tile.width; x += 16)
+				++covered[(y / 16) * (width / 16) + x / 16];
+	}
+	for (uint8_t count : covered)
+		EXPECT_EQ(count, 1);
+
+	// Row-major
+	EXPECT_EQ(tiles[1].x, tiles[0].width);
+	EXPECT_EQ(tiles[4].y, tiles[0].height);
+}
+
+TEST(CaptureImage, UnevenSizesSpreadTheRemainder)
+{
+	const std::vector<CaptureTile> tiles = PlanCaptureTiles(1001, 10, 500, 64);
+	ASSERT_EQ(tiles.size(), 3u);
+	EXPECT_EQ(tiles[0].width, 334u);
+	EXPECT_EQ(tiles[1].width, 334u);
+	EXPECT_EQ(tiles[2].width, 333u);
+	EXPECT_EQ(tiles[2].x + tiles[2].width, 1001u);
+
+	EXPECT_EQ(PlanCaptureTiles(640, 480, 1024, 1024).size(), 1u);
+	EXPECT_TRUE(PlanCaptureTiles(0, 480, 1024, 1024).empty());
+}
+
+TEST(CaptureImage, TileProjectionMatchesTheFullImage)
+{
+	const uint32_t width = 1200, height = 800;
+	const glm::mat4 full = MakePerspective(60.0f, 1.5f, 0.1f);
+	const std::vector<CaptureTile> tiles = PlanCaptureTiles(width, height, 500, 500);
+
+	const glm::vec3 points[] = { { -3.0f, 2.0f, -10.0f }, { 0.4f, -0.2f, -2.0f }, { 5.0f, -3.0f, -12.0f } };
+	for (const glm::vec3& point : points)
+	{
+		const glm::vec2 pixel = ToPixel(full, point, width, height);
+		for (const CaptureTile& tile : tiles)
+		{
+			if (pixel.x < tile.x || pixel.x >= tile.x + tile.width || pixel.y < tile.y || pixel.y >= tile.y + tile.height)
+				continue;
+
+			// Same pixel, relative to the tile
+			const glm::mat4 projection = MakeTileProjection(full, width, height, tile);
+			const glm::vec2 tilePixel = ToPixel(projection, point, tile.width, tile.height);
+			EXPECT_NEAR(tilePixel.x + tile.x, pixel.x, 1e-2f);
+			EXPECT_NEAR(tilePixel.y + tile.y, pixel.y, 1e-2f);
+
+			// Depth is untouched
+			const glm::vec4 a = full * glm::vec4(point, 1.0f);
+			const glm::vec4 b = projection * glm::vec4(point, 1.0f);
+			EXPECT_NEAR(a.z / a.w, b.z / b.w, 1e-6f);
+		}
+	}
+}
+
+TEST(CaptureImage, TileProjectionWorksForOrthographic)
+{
+	const glm::mat4 full = MakeOrthographicReverseZ(20.0f, 10.0f, 1.0f, 100.0f);
+	const CaptureTile tile{ 300, 0, 100, 100 };
+	const glm::mat4 projection = MakeTileProjection(full, 400, 200, tile);
+
+	// The image's top-right corner is the tile's
+	const glm::vec2 pixel = ToPixel(projection, glm::vec3(20.0f, 10.0f, -5.0f), tile.width, tile.height);
+	EXPECT_NEAR(pixel.x, 100.0f, 1e-3f);
+	EXPECT_NEAR(pixel.y, 0.0f, 1e-3f);
+}
+
+TEST(CaptureImage, CopiesTilesIntoPlace)
+{
+	const uint32_t imageWidth = 6;
+	std::vector<uint32_t> image(imageWidth * 4, 0);
+	const CaptureTile tile{ 2, 1, 3, 2 };
+	const uint32_t texels[6] = { 1, 2, 3, 4, 5, 6 };
+	CopyCaptureTile(texels, tile, image.data(), imageWidth);
+
+	EXPECT_EQ(image[1 * imageWidth + 2], 1u);
+	EXPECT_EQ(image[1 * imageWidth + 4], 3u);
+	EXPECT_EQ(image[2 * imageWidth + 2], 4u);
+	EXPECT_EQ(image[2 * imageWidth + 4], 6u);
+	EXPECT_EQ(image[1 * imageWidth + 5], 0u);
+	EXPECT_EQ(image[3 * imageWidth + 2], 0u);
+}
+
+TEST(CaptureImage, ConvertsPackedTexels)
+{
+	const uint32_t texels[2] = {
+		glm::packF2x11_1x10(glm::vec3(0.25f, 1.0f, 4.0f)),
+		glm::packF2x11_1x10(glm::vec3(0.18f, 0.18f, 0.18f)),
+	};
+
+	uint16_t half[6];
+	ConvertCaptureToHalf(texels, 2, half);
+	EXPECT_FLOAT_EQ(glm::unpackHalf1x16(half[0]), 0.25f);
+	EXPECT_FLOAT_EQ(glm::unpackHalf1x16(half[1]), 1.0f);
+	EXPECT_FLOAT_EQ(glm::unpackHalf1x16(half[2]), 4.0f);
+
+	uint8_t srgb[6];
+	ConvertCaptureToSrgb8(texels, 2, 1.0f, false, srgb);
+	EXPECT_NEAR(srgb[0], 137, 1);
+	EXPECT_EQ(srgb[1], 255);
+	EXPECT_EQ(srgb[2], 255);   // clamped
+	EXPECT_NEAR(srgb[3], 118, 1);   // 18% grey in sRGB
+
+	// ACES keeps HDR highlights below white and lifts mid grey a little
+	ConvertCaptureToSrgb8(texels, 2, 1.0f, true, srgb);
+	EXPECT_LT(srgb[1], 255);
+	EXPECT_GT(srgb[2], srgb[1]);
+	EXPECT_GT(srgb[3], 118);
+}
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+// ContactShadowTests.cpp
+//
+// Unit tests for the contact shadow pass's parameters
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/ContactShadow.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+TEST(ContactShadowTest, LightDirectionIsTakenToViewSpace)
+{
+	// Camera at the origin looking down -x: world +y stays up, world -x
+	// becomes view -z
+	const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const ContactShadowData data = ContactShadow::Build(ContactShadowSettings{}, view,
+		glm::vec3(-3.0f, 3.0f, 0.0f), glm::vec3(1.0f), glm::vec3(0.1f), glm::uvec2(1280, 720));
+
+	const float s = std::sqrt(0.5f);
+	EXPECT_NEAR(data.light.x, 0.0f, 1e-5f);
+	EXPECT_NEAR(data.light.y, s, 1e-5f);
+	EXPECT_NEAR(data.light.z, -s, 1e-5f);
+	EXPECT_FLOAT_EQ(data.light.w, ContactShadowSettings{}.length);
+	EXPECT_EQ(data.extents.x, 1280);
+	EXPECT_EQ(data.extents.y, 720);
+}
+
+TEST(ContactShadowTest, ParametersAreClamped)
+{
+	ContactShadowSettings settings;
+	settings.steps = 1000;
+	settings.strength = 3.0f;
+	settings.thickness = -1.0f;
+	ContactShadowData data = ContactShadow::Build(settings, glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(1.0f), glm::vec3(0.0f), glm::uvec2(1, 1));
+	EXPECT_FLOAT_EQ(data.params.w, static_cast<float>(ContactShadow::MAX_STEPS));
+	EXPECT_FLOAT_EQ(data.params.y, 1.0f);
+	EXPECT_FLOAT_EQ(data.params.x, 0.0f);
+
+	settings.steps = 0;
+	data = ContactShadow::Build(settings, glm::mat4(1.0f), glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f),
+		glm::uvec2(1, 1));
+	EXPECT_FLOAT_EQ(data.params.w, 1.0f);
+	EXPECT_FLOAT_EQ(data.light.y, 1.0f);   // no light direction: straight up
+}
+
+TEST(ContactShadowTest, InactiveWithoutLightOrStrength)
+{
+	ContactShadowSettings settings;
+	EXPECT_TRUE(ContactShadow::IsActive(settings, glm::vec3(1.0f, 0.9f, 0.8f)));
+	EXPECT_FALSE(ContactShadow::IsActive(settings, glm::vec3(0.0f)));
+
+	settings.strength = 0.0f;
+	EXPECT_FALSE(ContactShadow::IsActive(settings, glm::vec3(1.0f)));
+	settings = ContactShadowSettings{};
+	settings.enabled = false;
+	EXPECT_FALSE(ContactShadow::IsActive(settings, glm::vec3(1.0f)));
+}
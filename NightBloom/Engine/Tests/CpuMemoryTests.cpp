@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// CpuMemoryTests.cpp
+//
+// Unit tests for the per-subsystem CPU memory resources and frame counts
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/CpuMemory.hpp"
+#include "../Core/LinearAllocator.hpp"
+
+using namespace Nightbloom;
+
+TEST(CpuMemoryTest, ResourceCountsLiveBytesAndPeak)
+{
+	TrackedMemoryResource resource;
+	void* a = resource.allocate(1000, 8);
+	void* b = resource.allocate(24, 8);
+	EXPECT_EQ(resource.GetLiveBytes(), 1024u);
+	EXPECT_EQ(resource.GetAllocationCount(), 2u);
+
+	resource.deallocate(a, 1000, 8);
+	EXPECT_EQ(resource.GetLiveBytes(), 24u);
+	EXPECT_EQ(resource.GetPeakBytes(), 1024u);
+	EXPECT_EQ(resource.GetDeallocationCount(), 1u);
+
+	resource.ResetPeak();
+	EXPECT_EQ(resource.GetPeakBytes(), 24u);
+	resource.deallocate(b, 24, 8);
+	EXPECT_EQ(resource.GetLiveBytes(), 0u);
+}
+
+TEST(CpuMemoryTest, ResourcePassesAllocationsUpstream)
+{
+	TrackedMemoryResource upstream;
+	TrackedMemoryResource resource(&upstream);
+	void* ptr = resource.allocate(64, 16);
+	EXPECT_EQ(upstream.GetLiveBytes(), 64u);
+	resource.deallocate(ptr, 64, 16);
+	EXPECT_EQ(upstream.GetLiveBytes(), 0u);
+	EXPECT_EQ(upstream.GetAllocationCount(), 1u);
+}
+
+TEST(CpuMemoryTest, ContainersKeepTheirCategoryWhenCopied)
+{
+	const CpuMemory::CategoryStats before = CpuMemory::GetCategoryStats(CpuMemoryCategory::Image);
+	{
+		TrackedVector<uint8_t, CpuMemoryCategory::Image> pixels(4096);
+		const TrackedVector<uint8_t, CpuMemoryCategory::Image> copy = pixels;
+		EXPECT_EQ(CpuMemory::GetCategoryStats(CpuMemoryCategory::Image).liveBytes, before.liveBytes + 8192);
+	}
+	const CpuMemory::CategoryStats after = CpuMemory::GetCategoryStats(CpuMemoryCategory::Image);
+	EXPECT_EQ(after.liveBytes, before.liveBytes);
+	EXPECT_EQ(after.totalAllocations, before.totalAllocations + 2);
+	EXPECT_GE(after.peakBytes, 8192u);
+}
+
+TEST(CpuMemoryTest, BeginFrameReportsTheLastFramesAllocations)
+{
+	CpuMemory::BeginFrame();
+	{
+		TrackedVector<int, CpuMemoryCategory::Mesh> values;
+		values.reserve(16);
+		values.reserve(64);
+	}
+	CpuMemory::BeginFrame();
+	EXPECT_EQ(CpuMemory::GetCategoryStats(CpuMemoryCategory::Mesh).frameAllocations, 2u);
+	EXPECT_EQ(CpuMemory::GetFrameAllocations(), 2u);
+
+	// A steady frame: storage already there is reused
+	TrackedVector<int, CpuMemoryCategory::Mesh> reused(64);
+	CpuMemory::BeginFrame();
+	reused.clear();
+	reused.resize(64);
+	CpuMemory::BeginFrame();
+	EXPECT_EQ(CpuMemory::GetFrameAllocations(), 0u);
+}
+
+TEST(CpuMemoryTest, ArenaBlocksComeFromItsUpstream)
+{
+	TrackedMemoryResource upstream;
+	{
+		LinearAllocator arena(256, &upstream);
+		arena.Allocate(200);
+		arena.Allocate(200);   // overflows into a second block
+		EXPECT_EQ(upstream.GetAllocationCount(), 2u);
+
+		arena.Reset();         // merged into one
+		EXPECT_EQ(upstream.GetAllocationCount(), 3u);
+		EXPECT_EQ(upstream.GetLiveBytes(), arena.GetCapacity());
+
+		arena.Allocate(300);   // fits: steady state allocates nothing
+		arena.Reset();
+		EXPECT_EQ(upstream.GetAllocationCount(), 3u);
+	}
+	EXPECT_EQ(upstream.GetLiveBytes(), 0u);
+}
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+// CpuProfilerTests.cpp
+//
+// Unit tests for the per-thread CPU scope profiler and the Chrome trace
+// export that merges it with GPU spans
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/CpuProfiler.hpp"
+#include "../Core/ChromeTrace.hpp"
+#include <atomic>
+#include <thread>
+
+using namespace Nightbloom;
+
+namespace
+{
+	const CpuProfileThread* FindThread(const CpuProfileCapture& capture, const std::string& name)
+	{
+		for (const CpuProfileThread& thread : capture.threads)
+		{
+			if (thread.name == name)
+				return &thread;
+		}
+		return nullptr;
+	}
+}
+
+TEST(CpuProfiler, RecordsOnTheCallingThreadsTimeline)
+{
+	CpuProfiler profiler;
+	profiler.Record("Update", 100, 250, 0);
+	profiler.Record("Render", 300, 400, 0);
+
+	CpuProfileCapture capture = profiler.Capture();
+	ASSERT_EQ(capture.threads.size(), 1u);
+	ASSERT_EQ(capture.threads[0].events.size(), 2u);
+	EXPECT_STREQ(capture.threads[0].events[0].name, "Update");
+	EXPECT_EQ(capture.threads[0].events[0].startNs, 100u);
+	EXPECT_EQ(capture.threads[0].events[1].endNs, 400u);
+	EXPECT_EQ(capture.threads[0].lostEvents, 0u);
+}
+
+TEST(CpuProfiler, KeepsTheNewestEventsWhenTheRingWraps)
+{
+	CpuProfiler profiler;
+	const uint64_t total = CpuProfiler::EVENTS_PER_THREAD + 10;
+	for (uint64_t i = 0; i < total; ++i)
+		profiler.Record("Tick", i, i + 1, 0);
+
+	CpuProfileCapture capture = profiler.Capture();
+	const auto& events = capture.threads[0].events;
+	ASSERT_EQ(events.size(), CpuProfiler::EVENTS_PER_THREAD);
+	EXPECT_EQ(events.front().startNs, 10u);
+	EXPECT_EQ(events.back().startNs, total - 1);
+	EXPECT_EQ(capture.threads[0].lostEvents, 10u);
+}
+
+TEST(CpuProfiler, ClearForgetsEarlierEvents)
+{
+	CpuProfiler profiler;
+	profiler.Record("Old", 1, 2, 0);
+	profiler.Clear();
+	profiler.Record("New", 3, 4, 0);
+
+	CpuProfileCapture capture = profiler.Capture();
+	ASSERT_EQ(capture.threads[0].events.size(), 1u);
+	EXPECT_STREQ(capture.threads[0].events[0].name, "New");
+	EXPECT_EQ(capture.threads[0].lostEvents, 0u);
+}
+
+TEST(CpuProfiler, EachThreadGetsItsOwnTimeline)
+{
+	CpuProfiler profiler;
+	auto work = [&profiler]()
+	{
+		for (uint64_t i = 0; i < 100; ++i)
+			profiler.Record("Job", i, i + 1, 0);
+	};
+	std::thread a(work);
+	std::thread b(work);
+	a.join();
+	b.join();
+
+	CpuProfileCapture capture = profiler.Capture();
+	ASSERT_EQ(capture.threads.size(), 2u);
+	EXPECT_NE(capture.threads[0].id, capture.threads[1].id);
+	EXPECT_EQ(capture.threads[0].events.size(), 100u);
+	EXPECT_EQ(capture.threads[1].events.size(), 100u);
+}
+
+TEST(CpuProfiler, CaptureWhileRecordingNeverReturnsTornEvents)
+{
+	CpuProfiler profiler;
+	std::atomic<bool> stop{ false };
+	std::thread writer([&]()
+	{
+		for (uint64_t i = 1; !stop.load(std::memory_order_relaxed); ++i)
+			profiler.Record("Spin", i, i * 2, static_cast<uint32_t>(i & 7));
+	});
+
+	for (int c = 0; c < 50; ++c)
+	{
+		CpuProfileCapture capture = profiler.Capture();
+		for (const CpuProfileThread& thread : capture.threads)
+		{
+			for (const CpuProfileEvent& event : thread.events)
+			{
+				ASSERT_EQ(event.endNs, event.startNs * 2);
+				ASSERT_EQ(event.depth, static_cast<uint32_t>(event.startNs & 7));
+			}
+		}
+	}
+
+	stop = true;
+	writer.join();
+}
+
+TEST(CpuProfiler, ScopesNestOnANamedThread)
+{
+	std::thread worker([]()
+	{
+		NB_PROFILE_THREAD("Scope Test Worker");
+		NB_PROFILE_SCOPE("Outer");
+		{
+			NB_PROFILE_SCOPE("Inner");
+		}
+	});
+	worker.join();
+
+	CpuProfileCapture capture = CpuProfiler::Get().Capture();
+	const CpuProfileThread* thread = FindThread(capture, "Scope Test Worker");
+	ASSERT_NE(thread, nullptr);
+	ASSERT_EQ(thread->events.size(), 2u);
+
+	const CpuProfileEvent& inner = thread->events[0];
+	const CpuProfileEvent& outer = thread->events[1];
+	EXPECT_STREQ(inner.name, "Inner");
+	EXPECT_EQ(inner.depth, 1u);
+	EXPECT_STREQ(outer.name, "Outer");
+	EXPECT_EQ(outer.depth, 0u);
+	EXPECT_LE(outer.startNs, inner.startNs);
+	EXPECT_GE(outer.endNs, inner.endNs);
+}
+
+TEST(CpuProfiler, ChromeTraceMergesGpuSpansOntoTheCpuClock)
+{
+	CpuProfileCapture cpu;
+	cpu.captureNs = 50'000;
+	CpuProfileThread& thread = cpu.threads.emplace_back();
+	thread.id = 0;
+	thread.name = "Main \"render\"";
+	thread.events.push_back({ "Frame", 10'000, 30'000, 0 });
+
+	GpuProfileHistory gpu;
+	GpuFrameProfile frame;
+	frame.frameNumber = 7;
+	frame.cpuSubmitNs[static_cast<size_t>(GpuQueue::Graphics)] = 20'000;
+	GpuSpan span;
+	span.name = "Scene";
+	span.startMs = 0.002;   // 2 us after submit
+	span.ms = 0.005f;
+	frame.spans.push_back(span);
+	span.queue = GpuQueue::Compute;   // no compute submit time: left out
+	frame.spans.push_back(span);
+	gpu.Push(frame);
+
+	const std::string json = BuildChromeTrace(cpu, &gpu);
+	EXPECT_EQ(json.rfind("{\"displayTimeUnit\"", 0), 0u);
+	EXPECT_NE(json.find("\"thread_name\""), std::string::npos);
+	EXPECT_NE(json.find("Main \\\"render\\\""), std::string::npos);
+	EXPECT_NE(json.find("\"name\":\"Frame\",\"pid\":1,\"tid\":0,\"ts\":0.000,\"dur\":20.000"), std::string::npos);
+	EXPECT_NE(json.find("\"name\":\"Scene\",\"pid\":2,\"tid\":0,\"ts\":12.000,\"dur\":5.000,\"args\":{\"frame\":7}"),
+		std::string::npos);
+	EXPECT_EQ(json.find("\"pid\":2,\"tid\":1,\"ts\""), std::string::npos);
+
+	const std::string cpuOnly = BuildChromeTrace(cpu, nullptr);
+	EXPECT_EQ(cpuOnly.find("\"pid\":2"), std::string::npos);
+}
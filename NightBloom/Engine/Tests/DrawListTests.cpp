@@ -0,0 +1,612 @@
+//------------------------------------------------------------------------------
+// DrawListTests.cpp
+//
+// Unit tests for draw list sort keys and ordering
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/DrawCommandSystem.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	DrawCommand MakeCommand(PipelineType pipeline, float z, Buffer* vb = nullptr)
+	{
+		DrawCommand cmd;
+		cmd.pipeline = pipeline;
+		cmd.vertexBuffer = vb;
+		cmd.hasPushConstants = true;
+		cmd.pushConstants.model = glm::mat4(1.0f);
+		cmd.pushConstants.model[3] = glm::vec4(0.0f, 0.0f, z, 1.0f);
+		return cmd;
+	}
+
+	// Everything with x >= 0 (the other planes accept all)
+	Frustum MakeHalfSpaceFrustum()
+	{
+		Frustum frustum;
+		for (glm::vec4& plane : frustum.planes)
+			plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		frustum.planes[0] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+		return frustum;
+	}
+
+	// Emits one draw per box, each culled on its own like ModelDrawable's meshes
+	class PartsDrawable : public IDrawable
+	{
+	public:
+		std::vector<glm::vec3> centers;
+
+		void EmitDrawCommands(DrawList& drawList) const override
+		{
+			for (const glm::vec3& center : centers)
+			{
+				DrawCommand& cmd = drawList.Emit();
+				cmd.hasBounds = true;
+				cmd.bounds.center = center;
+				cmd.bounds.extents = glm::vec3(0.5f);
+				cmd.cameraVisible = drawList.IsPartVisible(cmd.bounds.center, cmd.bounds.extents);
+			}
+		}
+	};
+}
+
+TEST(DrawListTest, SortGroupsByPipelineInEnumOrder)
+{
+	DrawList list;
+	list.AddCommand(MakeCommand(PipelineType::Water, 1.0f));
+	list.AddCommand(MakeCommand(PipelineType::Mesh, 1.0f));
+	list.AddCommand(MakeCommand(PipelineType::Terrain, 1.0f));
+	list.AddCommand(MakeCommand(PipelineType::Mesh, 2.0f));
+
+	list.Sort(glm::vec3(0.0f));
+
+	ASSERT_EQ(list.GetCommandCount(), 4u);
+	EXPECT_EQ(list.GetCommand(0).pipeline, PipelineType::Mesh);
+	EXPECT_EQ(list.GetCommand(1).pipeline, PipelineType::Mesh);
+	EXPECT_EQ(list.GetCommand(2).pipeline, PipelineType::Terrain);
+	EXPECT_EQ(list.GetCommand(3).pipeline, PipelineType::Water);
+}
+
+TEST(DrawListTest, SkySortsFirst)
+{
+	DrawList list;
+	list.AddCommand(MakeCommand(PipelineType::Mesh, 1.0f));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 1.0f));
+	DrawCommand sky;
+	sky.pipeline = PipelineType::Skybox;
+	sky.vertexCount = 3;
+	list.AddCommand(sky);
+
+	list.Sort(glm::vec3(0.0f));
+
+	ASSERT_EQ(list.GetCommandCount(), 3u);
+	EXPECT_EQ(list.GetCommand(0).pipeline, PipelineType::Skybox);
+	EXPECT_EQ(list.GetCommand(1).pipeline, PipelineType::Mesh);
+	EXPECT_EQ(list.GetCommand(2).pipeline, PipelineType::Transparent);
+}
+
+TEST(DrawListTest, OpaqueFrontToBackTransparentBackToFront)
+{
+	DrawList list;
+	list.AddCommand(MakeCommand(PipelineType::Mesh, 50.0f));
+	list.AddCommand(MakeCommand(PipelineType::Mesh, 5.0f));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 5.0f));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 50.0f));
+
+	list.Sort(glm::vec3(0.0f));
+
+	EXPECT_FLOAT_EQ(list.GetCommand(0).pushConstants.model[3].z, 5.0f);
+	EXPECT_FLOAT_EQ(list.GetCommand(1).pushConstants.model[3].z, 50.0f);
+	EXPECT_FLOAT_EQ(list.GetCommand(2).pushConstants.model[3].z, 50.0f);
+	EXPECT_FLOAT_EQ(list.GetCommand(3).pushConstants.model[3].z, 5.0f);
+}
+
+TEST(DrawListTest, ParticleEmittersBackToFrontUnlessOit)
+{
+	EXPECT_TRUE(DrawSortKey::IsBackToFront(PipelineType::Particle));
+	EXPECT_FALSE(DrawSortKey::IsBackToFront(PipelineType::Particle, true));
+	EXPECT_FALSE(DrawSortKey::IsBackToFront(PipelineType::Firefly));
+
+	DrawList list;
+	list.AddCommand(MakeCommand(PipelineType::Particle, 5.0f));
+	list.AddCommand(MakeCommand(PipelineType::Particle, 50.0f));
+	list.AddCommand(MakeCommand(PipelineType::Particle, 20.0f));
+
+	list.Sort(glm::vec3(0.0f));
+
+	ASSERT_EQ(list.GetCommandCount(), 3u);
+	EXPECT_FLOAT_EQ(list.GetCommand(0).pushConstants.model[3].z, 50.0f);
+	EXPECT_FLOAT_EQ(list.GetCommand(1).pushConstants.model[3].z, 20.0f);
+	EXPECT_FLOAT_EQ(list.GetCommand(2).pushConstants.model[3].z, 5.0f);
+}
+
+TEST(DrawListTest, SortKeepsCommandsInPlaceAndIsStable)
+{
+	DrawList list;
+	for (int i = 0; i < 8; ++i)
+		list.AddCommand(MakeCommand(PipelineType::Mesh, 10.0f));
+
+	list.SortByPipeline();
+
+	// Equal keys keep submission order; only the index list is permuted.
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		EXPECT_EQ(list.GetOrder()[i], i);
+		EXPECT_EQ(&list.GetCommand(i), &list.GetCommands()[i]);
+	}
+}
+
+TEST(DrawListTest, AppendKeepsEachChunksOrder)
+{
+	DrawList merged;
+	merged.AddCommand(MakeCommand(PipelineType::Mesh, 1.0f));
+
+	DrawList chunk;
+	chunk.AddCommand(MakeCommand(PipelineType::Water, 2.0f));
+	chunk.AddCommand(MakeCommand(PipelineType::Mesh, 3.0f));
+	merged.Append(chunk);
+
+	ASSERT_EQ(merged.GetCommandCount(), 3u);
+	for (uint32_t i = 0; i < 3; ++i)
+		EXPECT_FLOAT_EQ(merged.GetCommand(i).pushConstants.model[3].z, static_cast<float>(i + 1));
+
+	merged.Sort(glm::vec3(0.0f));
+	EXPECT_EQ(merged.GetCommand(2).pipeline, PipelineType::Water);
+}
+
+TEST(DrawListTest, AppendRebasesSkinJoints)
+{
+	const glm::mat4 joints[2] = { glm::mat4(1.0f), glm::mat4(2.0f) };
+
+	DrawList merged;
+	DrawCommand first = MakeCommand(PipelineType::Mesh, 1.0f);
+	first.skinFirstJoint = merged.AddSkinJoints(joints, 2);
+	first.skinJointCount = 2;
+	merged.AddCommand(first);
+
+	DrawList chunk;
+	chunk.AddCommand(MakeCommand(PipelineType::Mesh, 2.0f));   // unskinned
+	DrawCommand skinned = MakeCommand(PipelineType::Mesh, 3.0f);
+	skinned.skinFirstJoint = chunk.AddSkinJoints(&joints[1], 1);
+	skinned.skinJointCount = 1;
+	chunk.AddCommand(skinned);
+	merged.Append(chunk);
+
+	ASSERT_EQ(merged.GetSkinJoints().size(), 3u);
+	EXPECT_EQ(merged.GetCommand(0).skinFirstJoint, 0u);
+	EXPECT_EQ(merged.GetCommand(1).skinFirstJoint, 0u);
+	EXPECT_EQ(merged.GetCommand(2).skinFirstJoint, 2u);
+	EXPECT_EQ(merged.GetSkinJoints()[merged.GetCommand(2).skinFirstJoint], joints[1]);
+
+	merged.Clear();
+	EXPECT_TRUE(merged.GetSkinJoints().empty());
+}
+
+TEST(DrawListTest, ArenaBackedListSurvivesFrameReset)
+{
+	LinearAllocator arena(1024);
+	DrawList list(&arena);
+
+	// Enough commands to overflow the first block and chain another
+	for (int i = 0; i < 64; ++i)
+		list.Emit().indexCount = static_cast<uint32_t>(i);
+	EXPECT_GT(arena.GetUsed(), 0u);
+
+	size_t lastCount = list.GetCommandCount();
+	list.ResetStorage(nullptr);
+	arena.Reset();
+	list.ResetStorage(&arena, lastCount);
+
+	EXPECT_EQ(list.GetCommandCount(), 0u);
+	// The merged block now holds a full frame without chaining again
+	size_t capacity = arena.GetCapacity();
+	for (int i = 0; i < 64; ++i)
+		list.Emit().indexCount = static_cast<uint32_t>(i);
+	EXPECT_EQ(arena.GetCapacity(), capacity);
+	EXPECT_EQ(list.GetCommand(63).indexCount, 63u);
+}
+
+TEST(DrawListTest, IdenticalMeshesBatchIntoOneInstancedDraw)
+{
+	Buffer* sharedVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+	Buffer* otherVb = reinterpret_cast<Buffer*>(uintptr_t(0x2000));
+
+	DrawList list;
+	for (int i = 0; i < 3; ++i)
+		list.AddCommand(MakeCommand(PipelineType::Mesh, 1.0f + i, sharedVb));
+	list.AddCommand(MakeCommand(PipelineType::Mesh, 4.0f, otherVb));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 5.0f, sharedVb));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 6.0f, sharedVb));
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 16> instances{};
+	const uint32_t slots = list.CountInstanceSlots();
+	uint32_t written = list.BuildInstanceBatches(instances.data(), 16);
+	EXPECT_EQ(slots, written);
+
+	// Every instance-fed command wrote its transform; only the shared-buffer
+	// meshes merged. Transparent draws stay separate for blending order.
+	EXPECT_EQ(written, 6u);
+	ASSERT_EQ(list.GetCommandCount(), 4u);
+
+	uint32_t batchedInstances = 0;
+	for (uint32_t i = 0; i < list.GetCommandCount(); ++i)
+	{
+		const DrawCommand& cmd = list.GetCommand(i);
+		if (cmd.vertexBuffer == sharedVb && cmd.pipeline == PipelineType::Mesh)
+		{
+			EXPECT_EQ(cmd.instanceCount, 3u);
+			for (uint32_t k = 0; k < 3; ++k)
+				EXPECT_FLOAT_EQ(instances[cmd.firstInstance + k].model[3].z, 1.0f + k);
+		}
+		else
+		{
+			EXPECT_EQ(cmd.instanceCount, 1u);
+			EXPECT_FLOAT_EQ(instances[cmd.firstInstance].model[3].z, cmd.pushConstants.model[3].z);
+		}
+		batchedInstances += cmd.instanceCount;
+	}
+	EXPECT_EQ(batchedInstances, written);
+}
+
+TEST(DrawListTest, ArenaMeshesInOneBufferOnlyBatchWithTheSameRange)
+{
+	Buffer* arenaVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	DrawList list;
+	for (int i = 0; i < 4; ++i)
+	{
+		// Two meshes sub-allocated from one shared buffer, two copies each
+		DrawCommand cmd = MakeCommand(PipelineType::Mesh, 1.0f + i, arenaVb);
+		cmd.indexBuffer = arenaVb;
+		cmd.indexCount = 36;
+		cmd.firstIndex = (i % 2) * 36;
+		cmd.vertexOffset = (i % 2) * 24;
+		list.AddCommand(cmd);
+	}
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 8> instances{};
+	EXPECT_EQ(list.BuildInstanceBatches(instances.data(), 8), 4u);
+	ASSERT_EQ(list.GetCommandCount(), 2u);
+	EXPECT_NE(list.GetCommand(0).firstIndex, list.GetCommand(1).firstIndex);
+	EXPECT_EQ(list.GetCommand(0).instanceCount, 2u);
+	EXPECT_EQ(list.GetCommand(1).instanceCount, 2u);
+}
+
+TEST(DrawListTest, ArenaMeshesFormOneIndirectRun)
+{
+	Buffer* arenaVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	DrawList list;
+	for (int i = 0; i < 3; ++i)
+	{
+		DrawCommand cmd = MakeCommand(PipelineType::Mesh, 1.0f + i, arenaVb);
+		cmd.indexBuffer = arenaVb;
+		cmd.indexCount = 36 + i;
+		cmd.firstIndex = i * 100;
+		cmd.vertexOffset = i * 50;
+		list.AddCommand(cmd);
+	}
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 8> instances{};
+	list.BuildInstanceBatches(instances.data(), 8);
+	ASSERT_EQ(list.GetCommandCount(), 3u);
+
+	std::array<IndexedIndirectDraw, 8> draws{};
+	EXPECT_EQ(list.WriteIndirectDraws(draws.data(), 8), 3u);
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const DrawCommand& cmd = list.GetCommand(i);
+		EXPECT_EQ(draws[i].indexCount, cmd.indexCount);
+		EXPECT_EQ(draws[i].firstIndex, cmd.firstIndex);
+		EXPECT_EQ(draws[i].vertexOffset, cmd.vertexOffset);
+		EXPECT_EQ(draws[i].firstInstance, cmd.firstInstance);
+		EXPECT_EQ(draws[i].instanceCount, 1u);
+	}
+
+	auto all = [](size_t) { return true; };
+	EXPECT_EQ(list.FindIndirectRun(0, 3, false, all), 3u);
+	EXPECT_EQ(list.FindIndirectRun(0, 2, false, all), 2u);
+	EXPECT_EQ(list.FindIndirectRun(0, 3, false, [](size_t index) { return index != 2; }), 2u);
+}
+
+TEST(DrawListTest, IndirectRunsSplitOnStateAndOcclusionSlots)
+{
+	Buffer* arenaVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	DrawList list;
+	for (int i = 0; i < 4; ++i)
+	{
+		DrawCommand cmd = MakeCommand(PipelineType::Mesh, 1.0f + i, arenaVb);
+		cmd.indexBuffer = arenaVb;
+		cmd.indexCount = 36;
+		cmd.firstIndex = i * 36;
+		list.AddCommand(cmd);
+	}
+	list.Sort(glm::vec3(0.0f));
+
+	auto all = [](size_t) { return true; };
+	for (uint32_t i = 0; i < 4; ++i)
+		list.GetCommandMutable(i).occlusionSlot = i;
+	EXPECT_EQ(list.FindIndirectRun(0, 4, true, all), 4u);
+
+	// A gap in the slots ends the run there when drawing from the culler's buffer
+	list.GetCommandMutable(2).occlusionSlot = 7;
+	EXPECT_EQ(list.FindIndirectRun(0, 4, true, all), 2u);
+	EXPECT_EQ(list.FindIndirectRun(0, 4, false, all), 4u);
+
+	// Different push-constant material: a separate bucket
+	list.GetCommandMutable(1).pushConstants.materialIndex = 3;
+	EXPECT_EQ(list.FindIndirectRun(0, 4, false, all), 1u);
+
+	// Only Mesh draws go indirect
+	DrawCommand transparent = MakeCommand(PipelineType::Transparent, 1.0f, arenaVb);
+	transparent.indexBuffer = arenaVb;
+	transparent.indexCount = 36;
+	EXPECT_FALSE(DrawList::CanDrawIndirectTogether(transparent, transparent));
+}
+
+TEST(DrawListTest, MeshletJobsDrawOnTheirOwnInTheMainPass)
+{
+	Buffer* arenaVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	DrawList list;
+	for (int i = 0; i < 4; ++i)
+	{
+		DrawCommand cmd = MakeCommand(PipelineType::Mesh, 1.0f + i, arenaVb);
+		cmd.indexBuffer = arenaVb;
+		cmd.indexCount = 36;
+		cmd.firstIndex = i * 36;
+		list.AddCommand(cmd);
+	}
+	list.Sort(glm::vec3(0.0f));
+	list.GetCommandMutable(2).meshletJob = 0;
+
+	auto all = [](size_t) { return true; };
+	EXPECT_EQ(list.FindIndirectRun(0, 4, true, all), 2u);
+	EXPECT_EQ(list.FindIndirectRun(2, 4, true, all), 3u);
+	EXPECT_EQ(list.FindIndirectRun(3, 4, true, all), 4u);
+
+	// Passes that draw whole meshes keep them in the run
+	EXPECT_EQ(list.FindIndirectRun(0, 4, false, all), 4u);
+}
+
+TEST(DrawListTest, InstanceOverflowDropsDrawsInsteadOfOverrunning)
+{
+	DrawList list;
+	for (int i = 0; i < 4; ++i)
+		list.AddCommand(MakeCommand(PipelineType::Transparent, 1.0f + i));
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 2> instances{};
+	EXPECT_EQ(list.BuildInstanceBatches(instances.data(), 2), 2u);
+
+	uint32_t dropped = 0;
+	for (uint32_t i = 0; i < list.GetCommandCount(); ++i)
+		dropped += list.GetCommand(i).instanceCount == 0 ? 1 : 0;
+	EXPECT_EQ(dropped, 2u);
+}
+
+TEST(DrawListTest, BatchBoundsCoverEveryInstance)
+{
+	Buffer* sharedVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	DrawList list;
+	for (int i = 0; i < 3; ++i)
+	{
+		DrawCommand cmd = MakeCommand(PipelineType::Mesh, 1.0f + i, sharedVb);
+		cmd.hasBounds = true;
+		cmd.bounds.center = glm::vec3(0.0f, 0.0f, 1.0f + i * 10.0f);
+		cmd.bounds.extents = glm::vec3(1.0f);
+		list.AddCommand(cmd);
+	}
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 16> instances{};
+	list.BuildInstanceBatches(instances.data(), 16);
+
+	ASSERT_EQ(list.GetCommandCount(), 1u);
+	const DrawCommand& batch = list.GetCommand(0);
+	ASSERT_TRUE(batch.hasBounds);
+	EXPECT_FLOAT_EQ(batch.bounds.center.z - batch.bounds.extents.z, 0.0f);
+	EXPECT_FLOAT_EQ(batch.bounds.center.z + batch.bounds.extents.z, 22.0f);
+	EXPECT_FLOAT_EQ(batch.bounds.extents.x, 1.0f);
+}
+
+TEST(DrawListTest, BatchWithoutBoundsOnOneInstanceHasNone)
+{
+	Buffer* sharedVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	DrawList list;
+	for (int i = 0; i < 2; ++i)
+	{
+		DrawCommand cmd = MakeCommand(PipelineType::Mesh, 1.0f + i, sharedVb);
+		cmd.hasBounds = (i == 0);
+		list.AddCommand(cmd);
+	}
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 16> instances{};
+	list.BuildInstanceBatches(instances.data(), 16);
+
+	// An unbounded instance could be anywhere, so the batch is never culled
+	ASSERT_EQ(list.GetCommandCount(), 1u);
+	EXPECT_FALSE(list.GetCommand(0).hasBounds);
+}
+
+TEST(DrawListTest, PrebuiltInstanceDataIsCopiedAndNeverMerged)
+{
+	Buffer* sharedVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+
+	std::array<InstanceData, 3> records{};
+	for (int i = 0; i < 3; ++i)
+		records[i].model[3] = glm::vec4(0.0f, 0.0f, 10.0f + i, 1.0f);
+
+	DrawList list;
+	DrawCommand terrain = MakeCommand(PipelineType::Terrain, 0.0f, sharedVb);
+	terrain.instanceCount = 3;
+	terrain.instanceData = records.data();
+	list.AddCommand(terrain);
+	list.AddCommand(MakeCommand(PipelineType::Terrain, 1.0f, sharedVb));
+	list.Sort(glm::vec3(0.0f));
+
+	std::array<InstanceData, 16> instances{};
+	EXPECT_EQ(list.BuildInstanceBatches(instances.data(), 16), 3u);
+
+	// The plain Terrain draw doesn't use the instance buffer at all
+	ASSERT_EQ(list.GetCommandCount(), 2u);
+	for (uint32_t i = 0; i < list.GetCommandCount(); ++i)
+	{
+		const DrawCommand& cmd = list.GetCommand(i);
+		if (!cmd.instanceData)
+			continue;
+		EXPECT_EQ(cmd.instanceCount, 3u);
+		for (uint32_t k = 0; k < 3; ++k)
+			EXPECT_FLOAT_EQ(instances[cmd.firstInstance + k].model[3].z, 10.0f + k);
+	}
+}
+
+TEST(DrawListTest, DepthPrepassTakesVisibleOpaqueDrawsFrontToBack)
+{
+	// Different materials, so the color pass order isn't front-to-back
+	Texture* near = reinterpret_cast<Texture*>(uintptr_t(0x2000));
+	Texture* far = reinterpret_cast<Texture*>(uintptr_t(0x3000));
+
+	DrawList list;
+	list.AddCommand(MakeCommand(PipelineType::Foliage, 1.0f));
+	DrawCommand farMesh = MakeCommand(PipelineType::Mesh, 80.0f);
+	farMesh.textures.Add(far);
+	list.AddCommand(farMesh);
+	DrawCommand nearMesh = MakeCommand(PipelineType::Mesh, 3.0f);
+	nearMesh.textures.Add(near);
+	list.AddCommand(nearMesh);
+	DrawCommand hidden = MakeCommand(PipelineType::Mesh, 1.0f);
+	hidden.cameraVisible = false;
+	list.AddCommand(hidden);
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 2.0f));
+	list.AddCommand(MakeCommand(PipelineType::Terrain, 40.0f));
+	list.Sort(glm::vec3(0.0f));
+
+	ASSERT_EQ(list.BuildDepthPrepassOrder(), 4u);
+	const DrawIndexVector& order = list.GetDepthPrepassOrder();
+	EXPECT_EQ(list.GetCommand(order[0]).pipeline, PipelineType::Mesh);
+	EXPECT_FLOAT_EQ(list.GetCommand(order[0]).pushConstants.model[3].z, 3.0f);
+	EXPECT_FLOAT_EQ(list.GetCommand(order[1]).pushConstants.model[3].z, 80.0f);
+	EXPECT_EQ(list.GetCommand(order[2]).pipeline, PipelineType::Terrain);
+	EXPECT_EQ(list.GetCommand(order[3]).pipeline, PipelineType::Foliage);
+
+	// The next frame's sort starts over
+	list.Sort(glm::vec3(0.0f));
+	EXPECT_TRUE(list.GetDepthPrepassOrder().empty());
+}
+
+TEST(DrawListTest, DepthPrepassTwinsCoverOnlyOpaqueScenePipelines)
+{
+	EXPECT_EQ(GetDepthPrepassPipeline(PipelineType::MeshPacked), PipelineType::MeshPackedDepth);
+	EXPECT_EQ(GetDepthEqualPipeline(PipelineType::Foliage), PipelineType::FoliageEqual);
+	EXPECT_EQ(GetDepthPrepassPipeline(PipelineType::Transparent), PipelineType::Count);
+	EXPECT_EQ(GetDepthEqualPipeline(PipelineType::Water), PipelineType::Water);
+}
+
+TEST(DrawListTest, OitTransparentsSortByStateAndBatch)
+{
+	Buffer* sharedVb = reinterpret_cast<Buffer*>(uintptr_t(0x1000));
+	Buffer* otherVb = reinterpret_cast<Buffer*>(uintptr_t(0x2000));
+
+	DrawList list;
+	list.SetOrderIndependentTransparency(true);
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 5.0f, sharedVb));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 50.0f, otherVb));
+	list.AddCommand(MakeCommand(PipelineType::Transparent, 6.0f, sharedVb));
+	list.Sort(glm::vec3(0.0f));
+
+	// No back-to-front order: copies of one mesh end up adjacent and merge
+	std::array<InstanceData, 16> instances{};
+	EXPECT_EQ(list.BuildInstanceBatches(instances.data(), 16), 3u);
+	ASSERT_EQ(list.GetCommandCount(), 2u);
+	for (uint32_t i = 0; i < list.GetCommandCount(); ++i)
+	{
+		const DrawCommand& cmd = list.GetCommand(i);
+		EXPECT_EQ(cmd.instanceCount, cmd.vertexBuffer == sharedVb ? 2u : 1u);
+	}
+
+	// Kept across frames
+	list.ResetStorage(nullptr);
+	EXPECT_TRUE(list.IsOrderIndependentTransparency());
+}
+
+TEST(DrawListTest, OitTwinsCoverTransparentWaterAndFireflies)
+{
+	EXPECT_EQ(GetOitPipeline(PipelineType::Transparent), PipelineType::TransparentOit);
+	EXPECT_EQ(GetOitPipeline(ResolvePipelineVariant(PipelineType::Transparent, VertexFormat::Packed)),
+		PipelineType::TransparentPackedOit);
+	EXPECT_EQ(GetOitPipeline(PipelineType::Water), PipelineType::WaterOit);
+	EXPECT_EQ(GetOitPipeline(PipelineType::Firefly), PipelineType::FireflyOit);
+	EXPECT_EQ(GetOitPipeline(PipelineType::FireflyPoint), PipelineType::FireflyPointOit);
+	EXPECT_EQ(GetOitPipeline(PipelineType::Particle), PipelineType::ParticleOit);
+	EXPECT_EQ(GetOitPipeline(PipelineType::Mesh), PipelineType::Count);
+
+	DrawCommand water = MakeCommand(PipelineType::Water, 1.0f);
+	EXPECT_TRUE(DrawList::IsOrderIndependentCandidate(water));
+	water.cameraVisible = false;
+	EXPECT_FALSE(DrawList::IsOrderIndependentCandidate(water));
+	EXPECT_FALSE(DrawList::IsOrderIndependentCandidate(MakeCommand(PipelineType::Clouds, 1.0f)));
+}
+
+TEST(DrawListTest, ReflectionTwinsCoverWhatThePlanarPassDraws)
+{
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Mesh), PipelineType::MeshReflection);
+	EXPECT_EQ(GetReflectionPipeline(ResolvePipelineVariant(PipelineType::Mesh, VertexFormat::Packed)),
+		PipelineType::MeshPackedReflection);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Terrain), PipelineType::TerrainReflection);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::TerrainTessellated), PipelineType::TerrainReflection);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Foliage), PipelineType::FoliageReflection);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Skybox), PipelineType::SkyboxReflection);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Clouds), PipelineType::CloudsReflection);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Water), PipelineType::Count);
+	EXPECT_EQ(GetReflectionPipeline(PipelineType::Transparent), PipelineType::Count);
+}
+
+TEST(DrawListTest, TessellatedTerrainResolvesToItsOwnPipelines)
+{
+	EXPECT_EQ(GetTessellatedPipeline(PipelineType::Terrain), PipelineType::TerrainTessellated);
+	EXPECT_EQ(GetTessellatedPipeline(PipelineType::TerrainShadow), PipelineType::TerrainShadow);
+	EXPECT_EQ(GetDepthPrepassPipeline(PipelineType::TerrainTessellated), PipelineType::TerrainTessellatedDepth);
+	EXPECT_EQ(GetDepthEqualPipeline(PipelineType::TerrainTessellated), PipelineType::TerrainTessellatedEqual);
+}
+
+TEST(DrawListTest, DrawablesCullTheirPartsAgainstTheCullFrustum)
+{
+	PartsDrawable parts;
+	parts.centers = { glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(-2.0f, 0.0f, 0.0f) };
+	DrawBounds objectBounds;
+	objectBounds.extents = glm::vec3(3.0f);
+
+	DrawList list;
+	const Frustum frustum = MakeHalfSpaceFrustum();
+	list.SetCullFrustum(&frustum);
+	list.AddDrawable(&parts, true, &objectBounds, 0x3);
+
+	ASSERT_EQ(list.GetCommandCount(), 2u);
+	EXPECT_TRUE(list.GetCommand(0).cameraVisible);
+	EXPECT_FALSE(list.GetCommand(1).cameraVisible);
+	// The parts keep their own bounds over the object's
+	EXPECT_EQ(list.GetCommand(1).bounds.center, glm::vec3(-2.0f, 0.0f, 0.0f));
+	EXPECT_EQ(list.GetCommand(0).auxViewMask, 0x3);
+
+	// A culled object culls every part; no frustum culls none
+	list.Clear();
+	list.AddDrawable(&parts, false, &objectBounds);
+	EXPECT_FALSE(list.GetCommand(0).cameraVisible);
+	EXPECT_FALSE(list.GetCommand(1).cameraVisible);
+
+	list.Clear();
+	list.SetCullFrustum(nullptr);
+	list.AddDrawable(&parts, true, &objectBounds);
+	EXPECT_TRUE(list.GetCommand(1).cameraVisible);
+	EXPECT_TRUE(list.IsPartVisible(glm::vec3(-9.0f), glm::vec3(0.0f)));
+}
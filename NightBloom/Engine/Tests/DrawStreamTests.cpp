@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// DrawStreamTests.cpp
+//
+// Unit tests for captured draw streams
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/DrawStream.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace Nightbloom;
+
+namespace
+{
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	DrawStream MakeStream()
+	{
+		DrawStream stream;
+		stream.view = glm::mat4(2.0f);
+		stream.cameraPosition = glm::vec3(1.0f, 2.0f, 3.0f);
+		stream.time = 4.5f;
+		stream.frameUniforms.assign(64, 7);
+		stream.lighting.assign(32, 9);
+		stream.cascadeLightViewProj.assign(4, glm::mat4(3.0f));
+		stream.skippedDraws = 2;
+
+		DrawStreamDraw draw;
+		draw.vertexBuffer = stream.AddResource("arena/vertex/0");
+		draw.indexBuffer = stream.AddResource("arena/index/0");
+		draw.textures[0] = stream.AddResource("bark");
+		draw.textureCount = 1;
+		draw.indexCount = 36;
+		draw.instanceCount = 2;
+		draw.firstInstanceRecord = 0;
+		stream.instanceRecords = { glm::mat4(1.0f), glm::mat4(5.0f) };
+		stream.draws.push_back(draw);
+		return stream;
+	}
+}
+
+TEST(DrawStreamTest, RoundTripsThroughAFile)
+{
+	const std::string path = TempPath("nightbloom_roundtrip.nbdraw");
+	const DrawStream written = MakeStream();
+	ASSERT_TRUE(WriteDrawStream(path, written));
+
+	DrawStream read;
+	ASSERT_TRUE(ReadDrawStream(path, read));
+	EXPECT_EQ(read.view, written.view);
+	EXPECT_EQ(read.cameraPosition, written.cameraPosition);
+	EXPECT_EQ(read.time, written.time);
+	EXPECT_EQ(read.frameUniforms, written.frameUniforms);
+	EXPECT_EQ(read.lighting, written.lighting);
+	EXPECT_EQ(read.cascadeLightViewProj.size(), 4u);
+	EXPECT_EQ(read.skippedDraws, 2u);
+	EXPECT_EQ(read.resources, written.resources);
+	EXPECT_STREQ(read.resources[2].c_str(), "bark");
+	ASSERT_EQ(read.draws.size(), 1u);
+	EXPECT_EQ(std::memcmp(&read.draws[0], &written.draws[0], sizeof(DrawStreamDraw)), 0);
+	EXPECT_EQ(read.instanceRecords, written.instanceRecords);
+
+	std::filesystem::remove(path);
+}
+
+TEST(DrawStreamTest, RejectsTruncatedAndOutOfRangeStreams)
+{
+	const std::string path = TempPath("nightbloom_bad.nbdraw");
+	DrawStream stream = MakeStream();
+	ASSERT_TRUE(WriteDrawStream(path, stream));
+
+	const auto size = std::filesystem::file_size(path);
+	std::filesystem::resize_file(path, size - 1);
+	DrawStream read;
+	EXPECT_FALSE(ReadDrawStream(path, read));
+	EXPECT_FALSE(ReadDrawStream(TempPath("nightbloom_missing.nbdraw"), read));
+
+	// Asks for more instance records than the stream holds
+	stream.draws[0].instanceCount = 3;
+	ASSERT_TRUE(WriteDrawStream(path, stream));
+	EXPECT_FALSE(ReadDrawStream(path, read));
+
+	std::filesystem::remove(path);
+}
+
+TEST(DrawStreamTest, ResourcesMapBothWays)
+{
+	int vertices = 0, texture = 0, replacement = 0;
+	DrawStreamResources resources;
+	resources.Add("vertices", &vertices);
+	resources.Add("bark", &texture);
+	EXPECT_EQ(resources.FindName(&vertices), "vertices"_sid);
+	EXPECT_EQ(resources.Find("bark"_sid), &texture);
+	EXPECT_FALSE(resources.FindName(&replacement).IsValid());
+	EXPECT_EQ(resources.Find("missing"_sid), nullptr);
+
+	// A name taken again points at the new resource only
+	resources.Add("bark", &replacement);
+	EXPECT_EQ(resources.Find("bark"_sid), &replacement);
+	EXPECT_FALSE(resources.FindName(&texture).IsValid());
+	EXPECT_EQ(resources.GetCount(), 2u);
+
+	DrawStream stream;
+	EXPECT_EQ(stream.AddResource("a"), 0u);
+	EXPECT_EQ(stream.AddResource("b"), 1u);
+	EXPECT_EQ(stream.AddResource("a"), 0u);
+}
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+// DynamicResolutionTests.cpp
+//
+// Unit tests for the GPU-time-driven render scale controller
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/DynamicResolution.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	DynamicResolutionSettings EnabledSettings()
+	{
+		DynamicResolutionSettings settings;
+		settings.enabled = true;
+		settings.targetFrameMs = 10.0f;
+		settings.minScale = 0.5f;
+		settings.maxScale = 1.0f;
+		settings.headroom = 0.9f;
+		return settings;
+	}
+
+	// GPU time that scales with pixel count: fullResMs at scale 1
+	float RunFrames(DynamicResolutionController& controller, float fullResMs, int frames)
+	{
+		float scale = controller.GetScale();
+		for (int i = 0; i < frames; ++i)
+			scale = controller.Update(fullResMs * scale * scale);
+		return scale;
+	}
+}
+
+TEST(DynamicResolutionTest, DisabledStaysAtMaxScale)
+{
+	DynamicResolutionController controller;
+	DynamicResolutionSettings settings = EnabledSettings();
+	settings.enabled = false;
+	settings.maxScale = 0.8f;
+	controller.SetSettings(settings);
+
+	EXPECT_FLOAT_EQ(controller.Update(40.0f), 0.8f);
+	EXPECT_FLOAT_EQ(controller.Update(40.0f), 0.8f);
+}
+
+TEST(DynamicResolutionTest, OverBudgetSettlesNearTheBudget)
+{
+	DynamicResolutionController controller;
+	controller.SetSettings(EnabledSettings());
+
+	// 16 ms at full res against a 9 ms budget -> scale ~0.75
+	const float scale = RunFrames(controller, 16.0f, 200);
+	const float gpuMs = 16.0f * scale * scale;
+	EXPECT_LT(scale, 1.0f);
+	EXPECT_GT(gpuMs, 9.0f * 0.9f);
+	EXPECT_LT(gpuMs, 10.0f);
+}
+
+TEST(DynamicResolutionTest, DropsFasterThanItClimbs)
+{
+	DynamicResolutionController controller;
+	controller.SetSettings(EnabledSettings());
+
+	EXPECT_NEAR(controller.Update(40.0f), 1.0f - DynamicResolutionController::MAX_STEP_DOWN, 1e-5f);
+
+	const float low = RunFrames(controller, 40.0f, 100);
+	EXPECT_FLOAT_EQ(low, 0.5f);  // clamped at minScale
+	EXPECT_NEAR(controller.Update(1.0f), low + DynamicResolutionController::MAX_STEP_UP, 1e-5f);
+}
+
+TEST(DynamicResolutionTest, UnderBudgetReturnsToMaxScale)
+{
+	DynamicResolutionController controller;
+	controller.SetSettings(EnabledSettings());
+	RunFrames(controller, 40.0f, 100);
+
+	EXPECT_FLOAT_EQ(RunFrames(controller, 4.0f, 200), 1.0f);
+}
+
+TEST(DynamicResolutionTest, SmallErrorsInsideTheDeadBandAreIgnored)
+{
+	DynamicResolutionController controller;
+	controller.SetSettings(EnabledSettings());
+
+	// 9.3 ms vs a 9 ms budget is under 2% off in scale
+	for (int i = 0; i < 20; ++i)
+		EXPECT_FLOAT_EQ(controller.Update(9.3f), 1.0f);
+}
+
+TEST(DynamicResolutionTest, NoMeasurementKeepsTheScale)
+{
+	DynamicResolutionController controller;
+	controller.SetSettings(EnabledSettings());
+	RunFrames(controller, 40.0f, 3);
+
+	const float scale = controller.GetScale();
+	EXPECT_FLOAT_EQ(controller.Update(0.0f), scale);
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// EnvironmentProbeTests.cpp
+//
+// Unit tests for the environment probe's cube layout, roughness mips and
+// capture scheduling
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/EnvironmentProbe.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	void ExpectVec3Near(const glm::vec3& actual, const glm::vec3& expected, float tolerance = 1e-5f)
+	{
+		EXPECT_NEAR(actual.x, expected.x, tolerance);
+		EXPECT_NEAR(actual.y, expected.y, tolerance);
+		EXPECT_NEAR(actual.z, expected.z, tolerance);
+	}
+
+	EnvironmentProbeInputs MakeInputs(const glm::vec3& towardSun)
+	{
+		EnvironmentProbeInputs inputs;
+		inputs.towardSun = towardSun;
+		inputs.sunColor = glm::vec3(1.0f, 0.9f, 0.8f);
+		inputs.skyColor = glm::vec3(0.2f, 0.3f, 0.5f);
+		return inputs;
+	}
+}
+
+TEST(EnvironmentProbeTest, FaceCentresFollowVulkanCubeOrder)
+{
+	const glm::vec2 centre(0.5f);
+	ExpectVec3Near(EnvironmentProbe::FaceDirection(0, centre), glm::vec3(1.0f, 0.0f, 0.0f));
+	ExpectVec3Near(EnvironmentProbe::FaceDirection(1, centre), glm::vec3(-1.0f, 0.0f, 0.0f));
+	ExpectVec3Near(EnvironmentProbe::FaceDirection(2, centre), glm::vec3(0.0f, 1.0f, 0.0f));
+	ExpectVec3Near(EnvironmentProbe::FaceDirection(3, centre), glm::vec3(0.0f, -1.0f, 0.0f));
+	ExpectVec3Near(EnvironmentProbe::FaceDirection(4, centre), glm::vec3(0.0f, 0.0f, 1.0f));
+	ExpectVec3Near(EnvironmentProbe::FaceDirection(5, centre), glm::vec3(0.0f, 0.0f, -1.0f));
+
+	// v runs down the side faces
+	EXPECT_LT(EnvironmentProbe::FaceDirection(4, glm::vec2(0.5f, 0.9f)).y, 0.0f);
+}
+
+TEST(EnvironmentProbeTest, DirectionFaceInvertsFaceDirection)
+{
+	for (uint32_t face = 0; face < EnvironmentProbe::FACE_COUNT; ++face)
+	{
+		for (const glm::vec2 uv : { glm::vec2(0.1f, 0.2f), glm::vec2(0.5f), glm::vec2(0.85f, 0.6f) })
+		{
+			glm::vec2 found;
+			EXPECT_EQ(EnvironmentProbe::DirectionFace(EnvironmentProbe::FaceDirection(face, uv), found), face);
+			EXPECT_NEAR(found.x, uv.x, 1e-5f);
+			EXPECT_NEAR(found.y, uv.y, 1e-5f);
+		}
+	}
+}
+
+TEST(EnvironmentProbeTest, FilterStepsAddUpToEachMipsLobe)
+{
+	EXPECT_EQ(EnvironmentProbe::MipSize(0), EnvironmentProbe::SIZE);
+	EXPECT_EQ(EnvironmentProbe::MipSize(EnvironmentProbe::MIP_COUNT - 1), 4u);
+	EXPECT_FLOAT_EQ(EnvironmentProbe::MipRoughness(0), 0.0f);
+	EXPECT_FLOAT_EQ(EnvironmentProbe::MipRoughness(EnvironmentProbe::MIP_COUNT - 1), 1.0f);
+	EXPECT_FLOAT_EQ(EnvironmentProbe::FilterAlpha(0), 0.0f);
+
+	// Summing the steps' alpha squared lands on the mip's own lobe
+	float alphaSquared = 0.0f;
+	for (uint32_t mip = 1; mip < EnvironmentProbe::MIP_COUNT; ++mip)
+	{
+		const float step = EnvironmentProbe::FilterAlpha(mip);
+		EXPECT_GT(step, 0.0f);
+		alphaSquared += step * step;
+		const float r = EnvironmentProbe::MipRoughness(mip);
+		EXPECT_NEAR(std::sqrt(alphaSquared), r * r, 1e-5f);
+	}
+}
+
+TEST(EnvironmentProbeTest, CapturesOnIntervalAndOnChange)
+{
+	EnvironmentProbeSettings settings;
+	settings.updateInterval = 4;
+	EnvironmentProbeSchedule schedule;
+	const EnvironmentProbeInputs inputs = MakeInputs(glm::vec3(0.0f, 1.0f, 1.0f));
+
+	EXPECT_TRUE(schedule.IsDue(settings, inputs));   // never captured
+	schedule.Advance(true, inputs);
+	for (int frame = 0; frame < 3; ++frame)
+	{
+		EXPECT_FALSE(schedule.IsDue(settings, inputs)) << frame;
+		schedule.Advance(false, inputs);
+	}
+	EXPECT_TRUE(schedule.IsDue(settings, inputs));
+	schedule.Advance(true, inputs);
+	EXPECT_EQ(schedule.GetAge(), 0u);
+
+	// The sun turning past the threshold, or a colour shift, comes early
+	EnvironmentProbeInputs turned = MakeInputs(glm::vec3(0.0f, 1.0f, 1.1f));
+	EXPECT_TRUE(schedule.IsDue(settings, turned));
+	EnvironmentProbeInputs nudged = MakeInputs(glm::vec3(0.0f, 1.0f, 1.001f));
+	EXPECT_FALSE(schedule.IsDue(settings, nudged));
+
+	EnvironmentProbeInputs dimmed = inputs;
+	dimmed.sunColor *= 0.9f;
+	EXPECT_TRUE(schedule.IsDue(settings, dimmed));
+	EnvironmentProbeInputs tinted = inputs;
+	tinted.skyColor.b += 0.01f;
+	EXPECT_FALSE(schedule.IsDue(settings, tinted));
+
+	schedule.Invalidate();
+	EXPECT_TRUE(schedule.IsDue(settings, inputs));
+}
+
+TEST(EnvironmentProbeTest, IntervalOneCapturesEveryFrame)
+{
+	EnvironmentProbeSettings settings;
+	settings.updateInterval = 0;   // clamped to 1
+	EnvironmentProbeSchedule schedule;
+	const EnvironmentProbeInputs inputs = MakeInputs(glm::vec3(0.3f, 0.8f, 0.1f));
+	for (int frame = 0; frame < 4; ++frame)
+	{
+		EXPECT_TRUE(schedule.IsDue(settings, inputs));
+		schedule.Advance(true, inputs);
+	}
+}
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+// FileWatcherTests.cpp
+//
+// Unit tests for change debouncing and the directory watcher
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/FileWatcher.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace Nightbloom;
+using namespace std::chrono_literals;
+
+namespace
+{
+	using Clock = FileChangeCoalescer::Clock;
+
+	void WriteFile(const std::filesystem::path& path, const char* text)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << text;
+	}
+
+	// Polls until something settles or `timeout` passes
+	std::vector<std::string> WaitForChanges(FileWatcher& watcher, std::chrono::milliseconds timeout)
+	{
+		std::vector<std::string> changed;
+		for (auto waited = 0ms; waited < timeout && changed.empty(); waited += 20ms)
+		{
+			std::this_thread::sleep_for(20ms);
+			watcher.Poll(changed);
+		}
+		return changed;
+	}
+}
+
+TEST(FileChangeCoalescer, HoldsPathsUntilTheySettle)
+{
+	FileChangeCoalescer coalescer;
+	const Clock::time_point start = Clock::now();
+
+	coalescer.Add("a.png", start);
+	coalescer.Add("b.png", start + 50ms);
+
+	std::vector<std::string> settled;
+	EXPECT_EQ(coalescer.TakeSettled(start + 90ms, 100ms, settled), 0u);
+
+	EXPECT_EQ(coalescer.TakeSettled(start + 120ms, 100ms, settled), 1u);
+	ASSERT_EQ(settled.size(), 1u);
+	EXPECT_EQ(settled[0], "a.png");
+	EXPECT_EQ(coalescer.GetPendingCount(), 1u);
+}
+
+TEST(FileChangeCoalescer, RepeatedEventsRestartTheWaitAndReportOnce)
+{
+	FileChangeCoalescer coalescer;
+	const Clock::time_point start = Clock::now();
+
+	coalescer.Add("mesh.bin", start);
+	coalescer.Add("mesh.bin", start + 80ms);
+	coalescer.Add("mesh.bin", start + 160ms);
+
+	std::vector<std::string> settled;
+	EXPECT_EQ(coalescer.TakeSettled(start + 200ms, 100ms, settled), 0u);
+	EXPECT_EQ(coalescer.TakeSettled(start + 260ms, 100ms, settled), 1u);
+	EXPECT_EQ(coalescer.TakeSettled(start + 1000ms, 100ms, settled), 0u);
+	EXPECT_EQ(settled.size(), 1u);
+}
+
+TEST(FileChangeCoalescer, AppendsSortedAfterExistingEntries)
+{
+	FileChangeCoalescer coalescer;
+	const Clock::time_point start = Clock::now();
+	coalescer.Add("c", start);
+	coalescer.Add("a", start);
+	coalescer.Add("b", start);
+
+	std::vector<std::string> settled = { "z" };
+	EXPECT_EQ(coalescer.TakeSettled(start + 1s, 0ms, settled), 3u);
+	EXPECT_EQ(settled, (std::vector<std::string>{ "z", "a", "b", "c" }));
+}
+
+TEST(FileWatcher, NormalizesEquivalentPaths)
+{
+	const std::filesystem::path dir = std::filesystem::temp_directory_path();
+	EXPECT_EQ(FileWatcher::NormalizePath(dir / "sub" / ".." / "file.png"),
+		FileWatcher::NormalizePath(dir / "file.png"));
+	EXPECT_EQ(FileWatcher::NormalizePath(dir / "file.png").find('\\'), std::string::npos);
+}
+
+TEST(FileWatcher, RejectsMissingDirectories)
+{
+	FileWatcher watcher;
+	EXPECT_FALSE(watcher.Watch((std::filesystem::temp_directory_path() / "nb_watcher_missing_dir").string()));
+	EXPECT_FALSE(watcher.Start());
+}
+
+TEST(FileWatcher, ReportsFilesWrittenInNestedDirectories)
+{
+	const std::filesystem::path root = std::filesystem::temp_directory_path() / "nb_watcher_test";
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "Textures");
+	WriteFile(root / "Textures" / "old.png", "old");
+
+	FileWatcher watcher;
+	watcher.SetSettleTime(50ms);
+	ASSERT_TRUE(watcher.Watch(root.string()));
+	ASSERT_TRUE(watcher.Start());
+
+	// Let the watcher register (or the polling fallback take its baseline)
+	std::this_thread::sleep_for(FileWatcher::POLL_INTERVAL + 100ms);
+	std::vector<std::string> changed;
+	watcher.Poll(changed);
+	EXPECT_TRUE(changed.empty());
+
+	WriteFile(root / "Textures" / "old.png", "new contents");
+	changed = WaitForChanges(watcher, 5000ms);
+	ASSERT_EQ(changed.size(), 1u);
+	EXPECT_EQ(changed[0], FileWatcher::NormalizePath(root / "Textures" / "old.png"));
+
+	watcher.Stop();
+	EXPECT_FALSE(watcher.IsRunning());
+	std::filesystem::remove_all(root);
+}
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// FramePacerTests.cpp
+//
+// Unit tests for the main loop's frame limiter schedule
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/FramePacer.hpp"
+
+using namespace Nightbloom;
+
+TEST(FramePacerTest, UnlimitedNeverWaits)
+{
+	FramePacer pacer;
+	EXPECT_FALSE(pacer.IsEnabled());
+	EXPECT_DOUBLE_EQ(pacer.NextDeadline(5.0), 5.0);
+	EXPECT_DOUBLE_EQ(pacer.NextDeadline(5.001), 5.001);
+}
+
+TEST(FramePacerTest, DeadlinesAdvanceByTheIntervalWithoutDrift)
+{
+	FramePacer pacer;
+	FramePacer::Settings settings;
+	settings.targetFps = 100.0f;
+	pacer.SetSettings(settings);
+	EXPECT_DOUBLE_EQ(pacer.GetTargetInterval(), 0.01);
+
+	// The first frame starts the schedule
+	EXPECT_DOUBLE_EQ(pacer.NextDeadline(1.0), 1.0);
+	// Early frames wait for the next slot...
+	EXPECT_NEAR(pacer.NextDeadline(1.004), 1.01, 1e-9);
+	// ...and one that woke late keeps the schedule: the next is shorter
+	EXPECT_NEAR(pacer.NextDeadline(1.0115), 1.02, 1e-9);
+	EXPECT_NEAR(pacer.NextDeadline(1.0205), 1.03, 1e-9);
+}
+
+TEST(FramePacerTest, LongStallRestartsTheSchedule)
+{
+	FramePacer pacer;
+	FramePacer::Settings settings;
+	settings.targetFps = 100.0f;
+	pacer.SetSettings(settings);
+
+	pacer.NextDeadline(1.0);
+	pacer.NextDeadline(1.005);   // deadline 1.01
+	// Three intervals late: no burst of catch-up frames
+	EXPECT_DOUBLE_EQ(pacer.NextDeadline(1.05), 1.05);
+	EXPECT_NEAR(pacer.NextDeadline(1.052), 1.06, 1e-9);
+}
+
+TEST(FramePacerTest, RefreshDivisorNeedsTheRefreshRate)
+{
+	FramePacer pacer;
+	FramePacer::Settings settings;
+	settings.targetFps = 30.0f;
+	settings.refreshDivisor = 2;
+	pacer.SetSettings(settings);
+
+	// Unknown refresh: falls back to targetFps
+	EXPECT_NEAR(pacer.GetTargetInterval(), 1.0 / 30.0, 1e-9);
+	pacer.SetRefreshRate(144.0f);
+	EXPECT_NEAR(pacer.GetTargetInterval(), 2.0 / 144.0, 1e-9);
+}
+
+TEST(FramePacerTest, JitterMeasuresIntervalError)
+{
+	FramePacer pacer;
+	FramePacer::Settings settings;
+	settings.targetFps = 100.0f;
+	pacer.SetSettings(settings);
+
+	double t = 1.0;
+	for (int i = 0; i < 100; ++i, t += 0.01)
+		pacer.RecordWake(t);
+	EXPECT_LT(pacer.GetJitterMs(), 0.01f);
+
+	// Alternating 8 / 12 ms frames: 2 ms off each time
+	for (int i = 0; i < 200; ++i)
+	{
+		t += (i % 2) ? 0.012 : 0.008;
+		pacer.RecordWake(t);
+	}
+	EXPECT_NEAR(pacer.GetJitterMs(), 2.0f, 0.05f);
+}
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+// FramePipelineTests.cpp
+//
+// Unit tests for the pipelined simulation / render snapshot handoff
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/FramePipeline.hpp"
+#include <atomic>
+#include <vector>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct Snapshot
+	{
+		uint64_t frameNumber = 0;
+		std::vector<uint32_t> draws;
+	};
+}
+
+TEST(FramePipelineTest, FirstFrameHasNothingToRender)
+{
+	JobSystem jobs;
+	FramePipeline<Snapshot> pipeline(jobs);
+
+	const Snapshot* snapshot = pipeline.Begin([](Snapshot& next, uint64_t frameNumber) { next.frameNumber = frameNumber; });
+	EXPECT_EQ(snapshot, nullptr);
+	pipeline.Wait();
+	EXPECT_FALSE(pipeline.IsSimulating());
+	EXPECT_EQ(pipeline.GetSimulatedFrames(), 1u);
+}
+
+TEST(FramePipelineTest, RendersWhatThePreviousFrameSimulated)
+{
+	JobSystem jobs;
+	jobs.Initialize(2);
+	FramePipeline<Snapshot> pipeline(jobs);
+
+	for (uint64_t frame = 1; frame <= 50; ++frame)
+	{
+		const Snapshot* snapshot = pipeline.Begin([](Snapshot& next, uint64_t frameNumber)
+			{
+				next.frameNumber = frameNumber;
+				next.draws.assign(static_cast<size_t>(frameNumber), static_cast<uint32_t>(frameNumber));
+			});
+
+		if (frame == 1)
+		{
+			EXPECT_EQ(snapshot, nullptr);
+		}
+		else
+		{
+			ASSERT_NE(snapshot, nullptr);
+			EXPECT_EQ(snapshot->frameNumber, frame - 1);
+			ASSERT_EQ(snapshot->draws.size(), static_cast<size_t>(frame - 1));
+			for (uint32_t draw : snapshot->draws)
+				EXPECT_EQ(draw, static_cast<uint32_t>(frame - 1));
+		}
+		pipeline.Wait();
+	}
+	jobs.Shutdown();
+}
+
+TEST(FramePipelineTest, SimulationNeverWritesTheRenderedSnapshot)
+{
+	JobSystem jobs;
+	jobs.Initialize(2);
+	FramePipeline<Snapshot> pipeline(jobs);
+
+	const Snapshot* rendering = nullptr;
+	std::atomic<bool> overlapped{ false };
+	for (int frame = 0; frame < 20; ++frame)
+	{
+		const Snapshot* previous = rendering;
+		rendering = pipeline.Begin([&overlapped, previous](Snapshot& next, uint64_t frameNumber)
+			{
+				if (&next == previous)
+					overlapped = true;
+				next.frameNumber = frameNumber;
+			});
+		if (rendering)
+		{
+			// What this frame renders stays put while the next one simulates
+			const uint64_t seen = rendering->frameNumber;
+			pipeline.Wait();
+			EXPECT_EQ(rendering->frameNumber, seen);
+		}
+		else
+		{
+			pipeline.Wait();
+		}
+	}
+	EXPECT_FALSE(overlapped.load());
+	jobs.Shutdown();
+}
+
+TEST(FramePipelineTest, WaitFinishesTheSimulationBeforeReturning)
+{
+	JobSystem jobs;
+	jobs.Initialize(1);
+	FramePipeline<Snapshot> pipeline(jobs);
+
+	// Stands in for app state OnFrameEnd reads after the frame
+	uint64_t simulatedState = 0;
+	for (uint64_t frame = 1; frame <= 10; ++frame)
+	{
+		pipeline.Begin([&simulatedState](Snapshot& next, uint64_t frameNumber)
+			{
+				simulatedState = frameNumber;
+				next.frameNumber = frameNumber;
+			});
+		pipeline.Wait();
+		EXPECT_FALSE(pipeline.IsSimulating());
+		EXPECT_EQ(simulatedState, frame);
+	}
+	jobs.Shutdown();
+}
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+// FrameUploadLayoutTests.cpp
+//
+// Unit tests for the per-frame upload buffer's slot and linear offsets
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/FrameUploadLayout.hpp"
+
+using namespace Nightbloom;
+
+TEST(FrameUploadLayoutTest, SlotsAreAlignedAndSharedByEveryRegion)
+{
+	FrameUploadLayout layout(3, 4096, 256);
+	EXPECT_EQ(layout.GetBufferSize(), 3u * 4096u);
+
+	const uint64_t frame = layout.Reserve("Frame", 400);
+	const uint64_t lighting = layout.Reserve("Lighting", 100);
+	EXPECT_EQ(frame, 0u);
+	EXPECT_EQ(lighting, 512u);
+	EXPECT_EQ(layout.GetReservedBytes(), 612u);
+
+	// Same name, fits: the old slot
+	EXPECT_EQ(layout.Reserve("Lighting", 64), lighting);
+	// Same name, bigger: a new slot
+	EXPECT_EQ(layout.Reserve("Lighting", 200), 768u);
+
+	EXPECT_EQ(layout.GetRegionOffset(2) + lighting, 2u * 4096u + 512u);
+}
+
+TEST(FrameUploadLayoutTest, LinearAllocationsFollowSlotsAndResetPerFrame)
+{
+	FrameUploadLayout layout(2, 4096, 256);
+	layout.Reserve("Frame", 300);
+
+	layout.BeginFrame(1);
+	const uint64_t a = layout.Allocate(100);
+	const uint64_t b = layout.Allocate(100);
+	EXPECT_EQ(a, 4096u + 512u);
+	EXPECT_EQ(b, 4096u + 768u);
+	EXPECT_EQ(layout.GetUsedBytes(), 868u);
+
+	layout.BeginFrame(0);
+	EXPECT_EQ(layout.GetUsedBytes(), 300u);
+	EXPECT_EQ(layout.Allocate(100), 512u);
+	EXPECT_EQ(layout.GetPeakUsedBytes(), 868u);
+}
+
+TEST(FrameUploadLayoutTest, FullRegionReturnsInvalid)
+{
+	FrameUploadLayout layout(2, 1000, 256);
+	EXPECT_EQ(layout.GetRegionSize(), 1024u);
+
+	layout.BeginFrame(0);
+	EXPECT_NE(layout.Allocate(512), FrameUploadLayout::INVALID_OFFSET);
+	EXPECT_EQ(layout.Allocate(600), FrameUploadLayout::INVALID_OFFSET);
+	EXPECT_NE(layout.Allocate(512), FrameUploadLayout::INVALID_OFFSET);
+	EXPECT_EQ(layout.Allocate(1), FrameUploadLayout::INVALID_OFFSET);
+	EXPECT_EQ(layout.Reserve("TooBig", 2048), FrameUploadLayout::INVALID_OFFSET);
+}
+
+TEST(FrameUploadLayoutTest, SlotReservedMidFrameDoesNotOverlapTransientData)
+{
+	FrameUploadLayout layout(2, 4096, 256);
+	layout.BeginFrame(0);
+	const uint64_t transient = layout.Allocate(600);
+	EXPECT_EQ(transient, 0u);
+
+	// The slot goes after it, and later allocations after the slot
+	const uint64_t slot = layout.Reserve("Clouds", 64);
+	EXPECT_EQ(slot, 768u);
+	EXPECT_EQ(layout.Allocate(64), 1024u);
+
+	layout.BeginFrame(1);
+	EXPECT_EQ(layout.GetUsedBytes(), 832u);
+	EXPECT_EQ(layout.Allocate(64), 4096u + 1024u);
+}
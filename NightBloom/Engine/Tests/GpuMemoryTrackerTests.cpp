@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+// GpuMemoryTrackerTests.cpp
+//
+// Unit tests for GPU allocation tagging and leak reports
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/GpuMemoryTracker.hpp"
+#include <thread>
+
+using namespace Nightbloom;
+
+TEST(GpuMemoryTrackerTest, CategoryTotalsFollowAllocationsAndFrees)
+{
+	GpuMemoryTracker tracker;
+	tracker.OnAllocate(1, GpuAllocationKind::Image, GpuMemoryCategory::Terrain, 4096, "Heightmap");
+	tracker.OnAllocate(2, GpuAllocationKind::Buffer, GpuMemoryCategory::Terrain, 1024);
+	tracker.OnAllocate(3, GpuAllocationKind::Buffer, GpuMemoryCategory::Grass, 512);
+
+	GpuMemoryTracker::CategoryStats terrain = tracker.GetCategoryStats(GpuMemoryCategory::Terrain);
+	EXPECT_EQ(terrain.liveBytes, 5120u);
+	EXPECT_EQ(terrain.liveCount, 2u);
+	EXPECT_EQ(tracker.GetLiveBytes(), 5632u);
+	EXPECT_EQ(tracker.GetLiveCount(), 3u);
+
+	tracker.OnFree(1);
+	tracker.OnFree(1);    // already freed: ignored
+	tracker.OnFree(99);   // never allocated: ignored
+
+	terrain = tracker.GetCategoryStats(GpuMemoryCategory::Terrain);
+	EXPECT_EQ(terrain.liveBytes, 1024u);
+	EXPECT_EQ(terrain.liveCount, 1u);
+	EXPECT_EQ(terrain.peakBytes, 5120u);
+	EXPECT_EQ(terrain.totalAllocations, 2u);
+	EXPECT_EQ(tracker.GetCategoryStats(GpuMemoryCategory::Grass).liveBytes, 512u);
+}
+
+TEST(GpuMemoryTrackerTest, ReusedIdReplacesTheOldAllocation)
+{
+	GpuMemoryTracker tracker;
+	tracker.OnAllocate(7, GpuAllocationKind::Buffer, GpuMemoryCategory::Clouds, 100);
+	tracker.OnAllocate(7, GpuAllocationKind::Buffer, GpuMemoryCategory::Water, 300);
+
+	EXPECT_EQ(tracker.GetCategoryStats(GpuMemoryCategory::Clouds).liveCount, 0u);
+	EXPECT_EQ(tracker.GetCategoryStats(GpuMemoryCategory::Water).liveBytes, 300u);
+	EXPECT_EQ(tracker.GetLiveCount(), 1u);
+}
+
+TEST(GpuMemoryTrackerTest, ScopesNestAndArePerThread)
+{
+	EXPECT_EQ(GpuMemoryScope::GetCurrent(), GpuMemoryCategory::Untagged);
+	EXPECT_EQ(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture), GpuMemoryCategory::Texture);
+	{
+		GpuMemoryScope model(GpuMemoryCategory::Model);
+		EXPECT_EQ(GpuMemoryScope::GetCurrentOr(GpuMemoryCategory::Texture), GpuMemoryCategory::Model);
+		{
+			GpuMemoryScope terrain(GpuMemoryCategory::Terrain);
+			EXPECT_EQ(GpuMemoryScope::GetCurrent(), GpuMemoryCategory::Terrain);
+
+			GpuMemoryCategory other = GpuMemoryCategory::Count;
+			std::thread([&other]() { other = GpuMemoryScope::GetCurrent(); }).join();
+			EXPECT_EQ(other, GpuMemoryCategory::Untagged);
+		}
+		EXPECT_EQ(GpuMemoryScope::GetCurrent(), GpuMemoryCategory::Model);
+	}
+	EXPECT_EQ(GpuMemoryScope::GetCurrent(), GpuMemoryCategory::Untagged);
+}
+
+TEST(GpuMemoryTrackerTest, LeakReportListsLargestFirst)
+{
+	GpuMemoryTracker tracker;
+	EXPECT_TRUE(tracker.BuildLeakReport().empty());
+
+	tracker.OnAllocate(1, GpuAllocationKind::Buffer, GpuMemoryCategory::Staging, 2048, "UploadStaging");
+	tracker.OnAllocate(2, GpuAllocationKind::Image, GpuMemoryCategory::RenderTarget, 4u * 1024u * 1024u, "SceneColor");
+	tracker.OnAllocate(3, GpuAllocationKind::Buffer, GpuMemoryCategory::Staging, 1024);
+
+	const std::vector<GpuMemoryTracker::Allocation> live = tracker.GetLiveAllocations();
+	ASSERT_EQ(live.size(), 3u);
+	EXPECT_EQ(live[0].name, "SceneColor");
+	EXPECT_EQ(live[1].id, 1u);
+	EXPECT_EQ(live[2].id, 3u);
+	EXPECT_EQ(tracker.GetLiveAllocations(1).size(), 1u);
+
+	// Header, two categories, then two of the three allocations
+	const std::vector<std::string> report = tracker.BuildLeakReport(2);
+	ASSERT_EQ(report.size(), 6u);
+	EXPECT_NE(report[0].find("3 GPU allocations"), std::string::npos);
+	EXPECT_NE(report[1].find("Render targets: 1"), std::string::npos);
+	EXPECT_NE(report[2].find("Staging: 2"), std::string::npos);
+	EXPECT_NE(report[3].find("'SceneColor'"), std::string::npos);
+	EXPECT_NE(report[4].find("'UploadStaging'"), std::string::npos);
+	EXPECT_NE(report[5].find("1 more"), std::string::npos);
+}
+
+TEST(GpuMemoryTrackerTest, DefaultPriorityFollowsTheCategory)
+{
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Default, GpuMemoryCategory::RenderTarget), GpuMemoryPriority::High);
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Default, GpuMemoryCategory::Shadow), GpuMemoryPriority::High);
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Default, GpuMemoryCategory::Renderer), GpuMemoryPriority::High);
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Default, GpuMemoryCategory::Staging), GpuMemoryPriority::Low);
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Default, GpuMemoryCategory::Texture), GpuMemoryPriority::Normal);
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Default, GpuMemoryCategory::Untagged), GpuMemoryPriority::Normal);
+
+	// An explicit priority wins over the category
+	EXPECT_EQ(ResolveGpuMemoryPriority(GpuMemoryPriority::Low, GpuMemoryCategory::RenderTarget), GpuMemoryPriority::Low);
+
+	EXPECT_LT(GetGpuMemoryPriorityValue(GpuMemoryPriority::Low), GetGpuMemoryPriorityValue(GpuMemoryPriority::Normal));
+	EXPECT_LT(GetGpuMemoryPriorityValue(GpuMemoryPriority::Normal), GetGpuMemoryPriorityValue(GpuMemoryPriority::High));
+	EXPECT_FLOAT_EQ(GetGpuMemoryPriorityValue(GpuMemoryPriority::Default), 0.5f);
+}
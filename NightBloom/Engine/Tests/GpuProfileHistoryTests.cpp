@@ -0,0 +1,222 @@
+//------------------------------------------------------------------------------
+// GpuProfileHistoryTests.cpp
+//
+// Unit tests for the GPU profiler's rolling span history and scope statistics
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/GpuProfileHistory.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	GpuSpan Span(const char* name, uint32_t parent, uint32_t depth, float ms,
+		double startMs = 0.0, GpuQueue queue = GpuQueue::Graphics)
+	{
+		GpuSpan span;
+		span.name = name;
+		span.parent = parent;
+		span.depth = depth;
+		span.queue = queue;
+		span.startMs = startMs;
+		span.ms = ms;
+		return span;
+	}
+
+	const GpuProfileHistory::ScopeStats* FindStats(const std::vector<GpuProfileHistory::ScopeStats>& stats,
+		const std::string& path, GpuQueue queue = GpuQueue::Graphics)
+	{
+		for (const auto& entry : stats)
+		{
+			if (entry.path == path && entry.queue == queue)
+				return &entry;
+		}
+		return nullptr;
+	}
+}
+
+TEST(GpuProfileHistory, SpanPathsFollowParents)
+{
+	GpuFrameProfile frame;
+	frame.spans.push_back(Span("Post", GpuSpan::NO_PARENT, 0, 2.0f));
+	frame.spans.push_back(Span("Bloom", 0, 1, 1.0f));
+	frame.spans.push_back(Span("Down 2", 1, 2, 0.25f));
+
+	EXPECT_EQ(frame.GetSpanPath(0), "Post");
+	EXPECT_EQ(frame.GetSpanPath(2), "Post/Bloom/Down 2");
+	EXPECT_EQ(frame.GetSpanPath(7), "");
+	EXPECT_FLOAT_EQ(frame.GetQueueMs(GpuQueue::Graphics), 2.0f);   // top level only
+}
+
+TEST(GpuProfileHistory, QueueTotalsAndExtentsAreSeparate)
+{
+	GpuFrameProfile frame;
+	frame.spans.push_back(Span("Scene", GpuSpan::NO_PARENT, 0, 3.0f, 0.0));
+	frame.spans.push_back(Span("Post", GpuSpan::NO_PARENT, 0, 1.0f, 3.5));
+	frame.spans.push_back(Span("Clouds", GpuSpan::NO_PARENT, 0, 2.0f, 0.5, GpuQueue::Compute));
+
+	EXPECT_FLOAT_EQ(frame.GetQueueMs(GpuQueue::Graphics), 4.0f);
+	EXPECT_FLOAT_EQ(frame.GetQueueMs(GpuQueue::Compute), 2.0f);
+	EXPECT_FLOAT_EQ(frame.GetQueueMs(GpuQueue::Transfer), 0.0f);
+	EXPECT_DOUBLE_EQ(frame.GetQueueEndMs(GpuQueue::Graphics), 4.5);
+	EXPECT_DOUBLE_EQ(frame.GetQueueEndMs(GpuQueue::Compute), 2.5);
+}
+
+TEST(GpuProfileHistory, KeepsOnlyTheNewestFrames)
+{
+	GpuProfileHistory history(3);
+	for (uint64_t i = 0; i < 5; ++i)
+	{
+		GpuFrameProfile frame;
+		frame.frameNumber = i;
+		history.Push(std::move(frame));
+	}
+
+	ASSERT_EQ(history.GetFrameCount(), 3u);
+	EXPECT_EQ(history.GetFrame(0).frameNumber, 4u);
+	EXPECT_EQ(history.GetFrame(2).frameNumber, 2u);
+
+	history.SetCapacity(1);
+	ASSERT_EQ(history.GetFrameCount(), 1u);
+	EXPECT_EQ(history.GetFrame(0).frameNumber, 4u);
+}
+
+TEST(GpuProfileHistory, StatsCoverTheWindow)
+{
+	GpuProfileHistory history(100);
+	for (int i = 1; i <= 100; ++i)
+	{
+		GpuFrameProfile frame;
+		frame.spans.push_back(Span("Scene", GpuSpan::NO_PARENT, 0, static_cast<float>(i)));
+		history.Push(std::move(frame));
+	}
+
+	auto stats = history.ComputeStats();
+	ASSERT_EQ(stats.size(), 1u);
+	const auto& scene = stats[0];
+	EXPECT_EQ(scene.samples, 100u);
+	EXPECT_FLOAT_EQ(scene.last, 100.0f);
+	EXPECT_FLOAT_EQ(scene.min, 1.0f);
+	EXPECT_FLOAT_EQ(scene.max, 100.0f);
+	EXPECT_FLOAT_EQ(scene.avg, 50.5f);
+	EXPECT_FLOAT_EQ(scene.p50, 50.0f);
+	EXPECT_FLOAT_EQ(scene.p95, 95.0f);
+	EXPECT_FLOAT_EQ(scene.p99, 99.0f);
+
+	// One more frame pushes the 1 ms sample out
+	GpuFrameProfile frame;
+	frame.spans.push_back(Span("Scene", GpuSpan::NO_PARENT, 0, 50.0f));
+	history.Push(std::move(frame));
+	EXPECT_FLOAT_EQ(history.ComputeStats()[0].min, 2.0f);
+}
+
+TEST(GpuProfileHistory, RepeatedPathsSumAndAbsentFramesDontCount)
+{
+	GpuProfileHistory history;
+
+	GpuFrameProfile first;
+	first.spans.push_back(Span("Shadow", GpuSpan::NO_PARENT, 0, 3.0f));
+	first.spans.push_back(Span("Cascade", 0, 1, 1.0f));
+	first.spans.push_back(Span("Cascade", 0, 1, 1.5f));
+	history.Push(std::move(first));
+
+	GpuFrameProfile second;
+	second.spans.push_back(Span("Scene", GpuSpan::NO_PARENT, 0, 4.0f));
+	history.Push(std::move(second));
+
+	auto stats = history.ComputeStats();
+	const auto* cascade = FindStats(stats, "Shadow/Cascade");
+	ASSERT_NE(cascade, nullptr);
+	EXPECT_EQ(cascade->samples, 1u);
+	EXPECT_EQ(cascade->depth, 1u);
+	EXPECT_FLOAT_EQ(cascade->max, 2.5f);
+
+	const auto* scene = FindStats(stats, "Scene");
+	ASSERT_NE(scene, nullptr);
+	EXPECT_EQ(scene->samples, 1u);
+}
+
+TEST(GpuProfileHistory, QueuesKeepSeparateStatsInQueueOrder)
+{
+	GpuProfileHistory history;
+
+	GpuFrameProfile frame;
+	frame.spans.push_back(Span("Upload batch", GpuSpan::NO_PARENT, 0, 0.5f, 0.0, GpuQueue::Transfer));
+	frame.spans.push_back(Span("Work", GpuSpan::NO_PARENT, 0, 2.0f, 0.0, GpuQueue::Compute));
+	frame.spans.push_back(Span("Work", GpuSpan::NO_PARENT, 0, 1.0f));
+	history.Push(std::move(frame));
+
+	auto stats = history.ComputeStats();
+	ASSERT_EQ(stats.size(), 3u);
+	EXPECT_EQ(stats[0].queue, GpuQueue::Graphics);
+	EXPECT_FLOAT_EQ(stats[0].avg, 1.0f);
+	EXPECT_EQ(stats[1].queue, GpuQueue::Compute);
+	EXPECT_FLOAT_EQ(stats[1].avg, 2.0f);
+	EXPECT_EQ(stats[2].queue, GpuQueue::Transfer);
+
+	history.Clear();
+	EXPECT_EQ(history.GetFrameCount(), 0u);
+	EXPECT_TRUE(history.ComputeStats().empty());
+}
+
+TEST(GpuProfileHistory, AveragesPipelineStatsOverFramesThatHaveThem)
+{
+	GpuProfileHistory history;
+
+	GpuFrameProfile first;
+	GpuSpan grass = Span("Grass", GpuSpan::NO_PARENT, 0, 1.0f);
+	grass.hasPipelineStats = true;
+	grass.pipelineStats.vertexInvocations = 1000;
+	grass.pipelineStats.fragmentInvocations = 400;
+	first.spans.push_back(grass);
+	history.Push(std::move(first));
+
+	GpuFrameProfile second;
+	grass.pipelineStats.vertexInvocations = 3000;
+	grass.pipelineStats.fragmentInvocations = 600;
+	second.spans.push_back(grass);
+	history.Push(std::move(second));
+
+	GpuFrameProfile third;   // statistics turned off
+	third.spans.push_back(Span("Grass", GpuSpan::NO_PARENT, 0, 1.0f));
+	history.Push(std::move(third));
+
+	auto stats = history.ComputeStats();
+	const auto* entry = FindStats(stats, "Grass");
+	ASSERT_NE(entry, nullptr);
+	EXPECT_EQ(entry->samples, 3u);
+	EXPECT_EQ(entry->pipelineSamples, 2u);
+	EXPECT_EQ(entry->avgPipelineStats.vertexInvocations, 2000u);
+	EXPECT_EQ(entry->avgPipelineStats.fragmentInvocations, 500u);
+}
+
+TEST(GpuProfileHistory, ComparesScopesInBothSnapshots)
+{
+	GpuProfileHistory history;
+	GpuFrameProfile before;
+	before.spans.push_back(Span("Scene", GpuSpan::NO_PARENT, 0, 4.0f));
+	before.spans.push_back(Span("Post", GpuSpan::NO_PARENT, 0, 1.0f));
+	before.spans.push_back(Span("Bloom", GpuSpan::NO_PARENT, 0, 0.5f));
+	history.Push(std::move(before));
+	const auto baseline = history.ComputeStats();
+
+	history.Clear();
+	GpuFrameProfile after;
+	after.spans.push_back(Span("Post", GpuSpan::NO_PARENT, 0, 0.75f));
+	after.spans.push_back(Span("Scene", GpuSpan::NO_PARENT, 0, 5.0f));
+	after.spans.push_back(Span("Bloom", GpuSpan::NO_PARENT, 0, 0.5f, 0.0, GpuQueue::Compute));
+	history.Push(std::move(after));
+	const auto candidate = history.ComputeStats();
+
+	// Bloom moved queues: not the same scope
+	const auto comparison = GpuProfileHistory::CompareStats(baseline, candidate);
+	ASSERT_EQ(comparison.size(), 2u);
+	EXPECT_EQ(comparison[0].path, "Scene");
+	EXPECT_FLOAT_EQ(comparison[0].GetDeltaMs(), 1.0f);
+	EXPECT_FLOAT_EQ(comparison[0].GetDeltaFraction(), 0.25f);
+	EXPECT_EQ(comparison[1].path, "Post");
+	EXPECT_FLOAT_EQ(comparison[1].GetDeltaFraction(), -0.25f);
+
+	EXPECT_TRUE(GpuProfileHistory::CompareStats(baseline, {}).empty());
+}
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// GpuQuerySegmentsTests.cpp
+//
+// Unit tests for splitting nested profiler scopes into non-overlapping
+// pipeline statistics queries
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/GpuQuerySegments.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	constexpr uint32_t NONE = GpuQuerySegments::NONE;
+
+	GpuPipelineStats Fragments(uint64_t count)
+	{
+		GpuPipelineStats stats;
+		stats.fragmentInvocations = count;
+		return stats;
+	}
+}
+
+TEST(GpuQuerySegments, ChildrenSplitTheParentsQuery)
+{
+	GpuQuerySegments segments;
+	segments.Reset(16);
+
+	auto a = segments.BeginScope(0);        // Post
+	EXPECT_EQ(a.end, NONE);
+	EXPECT_EQ(a.begin, 0u);
+
+	auto b = segments.BeginScope(1);        // Post/Bloom
+	EXPECT_EQ(b.end, 0u);
+	EXPECT_EQ(b.begin, 1u);
+
+	auto c = segments.EndScope(1);
+	EXPECT_EQ(c.end, 1u);
+	EXPECT_EQ(c.begin, 2u);                 // Post resumes
+
+	auto d = segments.EndScope(0);
+	EXPECT_EQ(d.end, 2u);
+	EXPECT_EQ(d.begin, NONE);
+	EXPECT_EQ(segments.GetSegmentCount(), 3u);
+
+	auto totals = segments.Resolve({ Fragments(10), Fragments(100), Fragments(5) }, { GpuSpan::NO_PARENT, 0 });
+	ASSERT_EQ(totals.size(), 2u);
+	EXPECT_EQ(totals[0].stats.fragmentInvocations, 115u);
+	EXPECT_EQ(totals[1].stats.fragmentInvocations, 100u);
+	EXPECT_TRUE(totals[0].complete);
+}
+
+TEST(GpuQuerySegments, OnlyTheInnermostScopeMayEnd)
+{
+	GpuQuerySegments segments;
+	segments.Reset(16);
+	segments.BeginScope(0);
+	segments.BeginScope(1);
+
+	auto ignored = segments.EndScope(0);
+	EXPECT_EQ(ignored.end, NONE);
+	EXPECT_EQ(ignored.begin, NONE);
+
+	EXPECT_EQ(segments.EndScope(1).end, 1u);
+	EXPECT_EQ(segments.EndScope(0).end, 2u);
+}
+
+TEST(GpuQuerySegments, RunningOutOfQueriesMarksScopesIncomplete)
+{
+	GpuQuerySegments segments;
+	segments.Reset(2);
+
+	segments.BeginScope(0);                 // segment 0
+	segments.BeginScope(1);                 // segment 1
+	auto resume = segments.EndScope(1);     // no segment left for scope 0
+	EXPECT_EQ(resume.end, 1u);
+	EXPECT_EQ(resume.begin, NONE);
+	EXPECT_EQ(segments.EndScope(0).end, NONE);
+
+	segments.BeginScope(2);                 // a later top-level scope gets nothing
+	EXPECT_EQ(segments.EndScope(2).end, NONE);
+
+	auto totals = segments.Resolve({ Fragments(1), Fragments(2) },
+		{ GpuSpan::NO_PARENT, 0, GpuSpan::NO_PARENT });
+	EXPECT_FALSE(totals[0].complete);
+	EXPECT_TRUE(totals[1].complete);
+	EXPECT_FALSE(totals[2].complete);
+	EXPECT_EQ(totals[0].stats.fragmentInvocations, 3u);
+}
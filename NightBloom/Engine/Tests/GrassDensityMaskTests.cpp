@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// GrassDensityMaskTests.cpp
+//
+// Unit tests for the painted grass density mask
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Foliage/GrassDensityMask.hpp"
+
+using namespace Nightbloom;
+
+TEST(GrassDensityMaskTest, UnpaintedMaskIsOneEverywhere)
+{
+	GrassDensityMask mask;
+	EXPECT_TRUE(mask.IsEmpty());
+	EXPECT_FLOAT_EQ(mask.Sample(glm::vec2(0.3f, 0.9f)), 1.0f);
+
+	mask.Reset(16);
+	EXPECT_FALSE(mask.IsEmpty());
+	EXPECT_FLOAT_EQ(mask.Sample(glm::vec2(-1.0f, 2.0f)), 1.0f);
+}
+
+TEST(GrassDensityMaskTest, PaintMovesTowardsTheTargetUnderTheBrush)
+{
+	GrassDensityMask mask;
+	glm::vec2 dirtyMin, dirtyMax;
+	// Radius 4 texels of a 64 mask, solid core of 2
+	ASSERT_TRUE(mask.Paint(glm::vec2(0.5f), 4.0f / 64.0f, 0.5f, 0.0f, 0.5f, dirtyMin, dirtyMax));
+	EXPECT_EQ(mask.GetResolution(), GrassDensityMask::DEFAULT_RESOLUTION);
+
+	GrassDensityMask small;
+	small.Reset(64);
+	ASSERT_TRUE(small.Paint(glm::vec2(0.5f), 4.0f / 64.0f, 0.5f, 0.0f, 0.5f, dirtyMin, dirtyMax));
+
+	// Texel (31, 31)'s centre: full weight, half way to 0
+	EXPECT_NEAR(small.Sample(glm::vec2(31.5f, 31.5f) / 64.0f), 0.5f, 1e-6f);
+	EXPECT_FLOAT_EQ(small.Sample(glm::vec2(10.5f, 31.5f) / 64.0f), 1.0f);
+
+	// The dirty rect covers the brush plus the bilinear footprint
+	EXPECT_LE(dirtyMin.x, 27.0f / 64.0f);
+	EXPECT_GE(dirtyMax.x, 37.0f / 64.0f);
+	EXPECT_LE(dirtyMin.y, 27.0f / 64.0f);
+	EXPECT_GE(dirtyMax.y, 37.0f / 64.0f);
+}
+
+TEST(GrassDensityMaskTest, PaintThatChangesNothingReportsNothing)
+{
+	GrassDensityMask mask;
+	mask.Reset(32);
+	glm::vec2 dirtyMin, dirtyMax;
+	// Already at the target
+	EXPECT_FALSE(mask.Paint(glm::vec2(0.5f), 0.1f, 0.5f, 1.0f, 1.0f, dirtyMin, dirtyMax));
+	// No strength, or off the square
+	EXPECT_FALSE(mask.Paint(glm::vec2(0.5f), 0.1f, 0.5f, 0.0f, 0.0f, dirtyMin, dirtyMax));
+	EXPECT_FALSE(mask.Paint(glm::vec2(3.0f), 0.1f, 0.5f, 0.0f, 1.0f, dirtyMin, dirtyMax));
+
+	mask.Clear();
+	EXPECT_TRUE(mask.IsEmpty());
+}
@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+// GrassScatterTests.cpp
+//
+// Unit tests for CPU grass placement
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Foliage/GrassScatter.hpp"
+#include <cstring>
+
+using namespace Nightbloom;
+
+namespace
+{
+	GrassScatterSettings SmallField()
+	{
+		GrassScatterSettings settings;
+		settings.terrainWorldSize = 60.0f;
+		settings.patchSize = 10.0f;
+		settings.candidateSpacing = 0.5f;
+		settings.terrainPosition = glm::vec3(5.0f, 2.0f, -3.0f);
+		return settings;
+	}
+
+	template <typename T>
+	bool BitwiseEqual(const std::vector<T>& a, const std::vector<T>& b)
+	{
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+	}
+}
+
+TEST(GrassScatterTest, ThreadCountDoesNotChangeTheResult)
+{
+	const GrassScatterSettings settings = SmallField();
+
+	std::vector<GrassInstance> serialInstances, parallelInstances;
+	std::vector<GrassPatch> serialPatches, parallelPatches;
+	GrassScatter::Generate(settings, 1000000, 1, serialInstances, serialPatches);
+	ASSERT_FALSE(serialInstances.empty());
+
+	for (uint32_t threads : { 2u, 3u, 8u })
+	{
+		GrassScatter::Generate(settings, 1000000, threads, parallelInstances, parallelPatches);
+		EXPECT_TRUE(BitwiseEqual(serialInstances, parallelInstances)) << threads << " threads";
+		EXPECT_TRUE(BitwiseEqual(serialPatches, parallelPatches)) << threads << " threads";
+	}
+}
+
+TEST(GrassScatterTest, PatchesTileTheInstanceRangeInGridOrder)
+{
+	std::vector<GrassInstance> instances;
+	std::vector<GrassPatch> patches;
+	const GrassScatterSettings settings = SmallField();
+	ASSERT_TRUE(GrassScatter::Generate(settings, 1000000, 4, instances, patches));
+
+	uint32_t next = 0;
+	for (size_t p = 0; p < patches.size(); ++p)
+	{
+		const GrassPatch& patch = patches[p];
+		EXPECT_EQ(patch.firstInstance, next);
+		EXPECT_GT(patch.fullCount, 0u);
+		if (p > 0)
+		{
+			// Row-major: z, then x, never goes backwards
+			const GrassPatch& prev = patches[p - 1];
+			EXPECT_TRUE(patch.center.z > prev.center.z || (patch.center.z == prev.center.z && patch.center.x > prev.center.x));
+		}
+
+		for (uint32_t i = patch.firstInstance; i < patch.firstInstance + patch.fullCount; ++i)
+		{
+			const GrassBlade blade = GrassScatter::UnpackBlade(instances[i], settings);
+			EXPECT_LE(std::abs(blade.worldXZ.x - patch.center.x), patch.extents.x + 1e-3f);
+			EXPECT_LE(std::abs(blade.worldXZ.y - patch.center.z), patch.extents.z + 1e-3f);
+			EXPECT_EQ(blade.patchIndex, static_cast<uint32_t>(p));
+		}
+		next += patch.fullCount;
+	}
+	EXPECT_EQ(static_cast<size_t>(next), instances.size());
+}
+
+TEST(GrassScatterTest, BudgetKeepsTheLeadingPrefix)
+{
+	const GrassScatterSettings settings = SmallField();
+
+	std::vector<GrassInstance> full, capped;
+	std::vector<GrassPatch> fullPatches, cappedPatches;
+	GrassScatter::Generate(settings, 1000000, 4, full, fullPatches);
+	const uint32_t budget = static_cast<uint32_t>(full.size() / 2);
+
+	EXPECT_FALSE(GrassScatter::Generate(settings, budget, 4, capped, cappedPatches));
+	ASSERT_EQ(capped.size(), static_cast<size_t>(budget));
+	EXPECT_EQ(std::memcmp(capped.data(), full.data(), capped.size() * sizeof(GrassInstance)), 0);
+	EXPECT_LT(cappedPatches.size(), fullPatches.size());
+}
+
+TEST(GrassScatterTest, PatchSeedsAreDistinctAndDependOnTheSeed)
+{
+	EXPECT_NE(GrassScatter::PatchSeed(1337, 1, 0), GrassScatter::PatchSeed(1337, 0, 1));
+	EXPECT_NE(GrassScatter::PatchSeed(1337, 2, 3), GrassScatter::PatchSeed(1338, 2, 3));
+	EXPECT_EQ(GrassScatter::PatchSeed(7, -4, 9), GrassScatter::PatchSeed(7, -4, 9));
+}
+
+TEST(GrassScatterTest, PackedBladesRoundTripWithinTheirPrecision)
+{
+	const GrassScatterSettings settings = SmallField();
+
+	GrassBlade blade;
+	blade.worldXZ = glm::vec2(-21.37f, 18.5f);
+	blade.rotY = 4.1f;
+	blade.scale = 0.71f;
+	blade.tint = 1.13f;
+	blade.windPhase = 0.2f;
+	blade.patchIndex = 4321;
+
+	const GrassBlade unpacked = GrassScatter::UnpackBlade(GrassScatter::PackBlade(blade, settings), settings);
+	const float turn = 6.2831853f / 256.0f;
+	// Sub-millimetre: a step of 60 m / 2^24 plus float rounding
+	EXPECT_NEAR(unpacked.worldXZ.x, blade.worldXZ.x, 1e-4f);
+	EXPECT_NEAR(unpacked.worldXZ.y, blade.worldXZ.y, 1e-4f);
+	EXPECT_NEAR(unpacked.rotY, blade.rotY, turn * 0.5f);
+	EXPECT_NEAR(unpacked.scale, blade.scale, 1e-3f);
+	EXPECT_NEAR(unpacked.tint, blade.tint, 0.5f / 255.0f + 1e-6f);
+	EXPECT_NEAR(unpacked.windPhase, blade.windPhase, turn * 0.5f);
+	EXPECT_EQ(unpacked.patchIndex, blade.patchIndex);
+
+	// A full turn wraps to zero rather than overflowing into the position bits
+	blade.rotY = 6.2831853f;
+	const GrassInstance wrapped = GrassScatter::PackBlade(blade, settings);
+	EXPECT_EQ(wrapped.x >> 24, 0u);
+}
+
+TEST(GrassScatterTest, SinglePatchMatchesTheFullScatter)
+{
+	const GrassScatterSettings settings = SmallField();
+	std::vector<GrassInstance> instances;
+	std::vector<GrassPatch> patches;
+	ASSERT_TRUE(GrassScatter::Generate(settings, 1000000, 4, instances, patches));
+
+	const int perSide = GrassScatter::PatchesPerSide(settings);
+	for (uint32_t p = 0; p < patches.size(); p += 7)
+	{
+		const GrassPatch& patch = patches[p];
+		const int cell = GrassScatter::PatchCell(settings, perSide, patch.center);
+
+		std::vector<GrassInstance> single;
+		ASSERT_EQ(GrassScatter::ScatterPatchInstances(settings, perSide, cell % perSide, cell / perSide, p, single),
+			patch.fullCount);
+		EXPECT_EQ(std::memcmp(single.data(), instances.data() + patch.firstInstance,
+			single.size() * sizeof(GrassInstance)), 0) << "patch " << p;
+
+		const GrassPatch bounds = GrassScatter::PatchBounds(settings, perSide, cell % perSide, cell / perSide);
+		EXPECT_EQ(bounds.center, patch.center);
+		EXPECT_EQ(bounds.extents, patch.extents);
+	}
+}
+
+TEST(GrassScatterTest, DensityMaskThinsOnlyWhereItIsPainted)
+{
+	GrassScatterSettings settings = SmallField();
+	std::vector<GrassInstance> before, after;
+	std::vector<GrassPatch> beforePatches, afterPatches;
+	GrassScatter::Generate(settings, 1000000, 4, before, beforePatches);
+
+	// Clear the -x half of the square
+	GrassDensityMask mask;
+	mask.Reset(64);
+	glm::vec2 dirtyMin, dirtyMax;
+	for (int y = 0; y < 64; ++y)
+		mask.Paint(glm::vec2(0.0f, (y + 0.5f) / 64.0f), 0.5f, 0.0f, 0.0f, 1.0f, dirtyMin, dirtyMax);
+	settings.densityMask = &mask;
+	GrassScatter::Generate(settings, 1000000, 4, after, afterPatches);
+
+	EXPECT_LT(after.size(), before.size());
+	for (const GrassInstance& instance : after)
+	{
+		const GrassBlade blade = GrassScatter::UnpackBlade(instance, settings);
+		EXPECT_GT(blade.worldXZ.x, settings.terrainPosition.x - 1.0f);
+	}
+
+	// The untouched +x edge patches come out the same
+	const GrassPatch& lastBefore = beforePatches.back();
+	const GrassPatch& lastAfter = afterPatches.back();
+	ASSERT_EQ(lastBefore.fullCount, lastAfter.fullCount);
+	EXPECT_EQ(lastBefore.center, lastAfter.center);
+}
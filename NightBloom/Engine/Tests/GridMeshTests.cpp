@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+// GridMeshTests.cpp
+//
+// Unit tests for the vertex-buffer-less grid's vertex decoding and indices
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/GridMesh.hpp"
+#include "../Terrain/TerrainMesh.hpp"
+
+using namespace Nightbloom;
+
+TEST(GridMeshTest, VertexIndexDecodesRowByRow)
+{
+	const uint32_t quads = 4;
+	EXPECT_EQ(GridMesh::GetVertexCount(quads), 25u);
+	EXPECT_EQ(GridMesh::GetIndexCount(quads), 96u);
+
+	EXPECT_EQ(GridMesh::GetVertexUV(0, quads), glm::vec2(0.0f, 0.0f));
+	EXPECT_EQ(GridMesh::GetVertexUV(4, quads), glm::vec2(1.0f, 0.0f));
+	EXPECT_EQ(GridMesh::GetVertexUV(5, quads), glm::vec2(0.0f, 0.25f));
+	EXPECT_EQ(GridMesh::GetVertexUV(24, quads), glm::vec2(1.0f, 1.0f));
+}
+
+TEST(GridMeshTest, IndicesStayInsideTheGrid)
+{
+	for (bool alternate : { true, false })
+	{
+		const std::vector<uint32_t> indices = GridMesh::GenerateIndices(7, alternate);
+		ASSERT_EQ(indices.size(), GridMesh::GetIndexCount(7));
+		for (uint32_t index : indices)
+			EXPECT_LT(index, GridMesh::GetVertexCount(7));
+	}
+}
+
+TEST(GridMeshTest, TrianglesFaceUp)
+{
+	// CCW seen from +Y with rows along +Z: the cross of the edges points up
+	const uint32_t quads = 3;
+	const std::vector<uint32_t> indices = GridMesh::GenerateIndices(quads);
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const glm::vec2 a = GridMesh::GetVertexUV(indices[i], quads);
+		const glm::vec2 b = GridMesh::GetVertexUV(indices[i + 1], quads);
+		const glm::vec2 c = GridMesh::GetVertexUV(indices[i + 2], quads);
+		const glm::vec3 e0(b.x - a.x, 0.0f, b.y - a.y);
+		const glm::vec3 e1(c.x - a.x, 0.0f, c.y - a.y);
+		EXPECT_GT(glm::cross(e0, e1).y, 0.0f) << "triangle " << i / 3;
+	}
+}
+
+TEST(GridMeshTest, MatchesTheCpuTerrainMesh)
+{
+	const TerrainMeshData data = TerrainMesh::Generate(9, 100.0f, false);
+	const uint32_t quads = 8;
+
+	EXPECT_EQ(data.indices, GridMesh::GenerateIndices(quads, false));
+	ASSERT_EQ(data.vertexCount(), GridMesh::GetVertexCount(quads));
+	for (uint32_t i = 0; i < data.vertexCount(); ++i)
+		EXPECT_EQ(data.vertices[i].texCoord, GridMesh::GetVertexUV(i, quads)) << i;
+}
@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+// IdleThrottleTests.cpp
+//
+// Unit tests for the editor's render-on-demand frame throttle
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/IdleThrottle.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Frames run over `seconds`, polled every millisecond
+	int CountFrames(IdleThrottle& throttle, double start, double seconds, bool animating)
+	{
+		int frames = 0;
+		for (double t = start; t < start + seconds; t += 0.001)
+		{
+			if (throttle.ShouldRunFrame(t, animating))
+				++frames;
+		}
+		return frames;
+	}
+}
+
+TEST(IdleThrottleTest, RunsEveryIterationWithinGraceOfActivity)
+{
+	IdleThrottle throttle;
+	throttle.NotifyActivity(10.0);
+
+	EXPECT_TRUE(throttle.ShouldRunFrame(10.001, false));
+	EXPECT_TRUE(throttle.ShouldRunFrame(10.002, false));
+	EXPECT_TRUE(throttle.ShouldRunFrame(10.4, false));
+	EXPECT_EQ(throttle.GetState(), IdleThrottle::State::Interactive);
+}
+
+TEST(IdleThrottleTest, DropsToAnimatedAndIdleRates)
+{
+	IdleThrottle throttle;
+	throttle.NotifyActivity(0.0);
+
+	// Past the grace period: ~30 fps while animating, ~4 fps when static
+	const int animated = CountFrames(throttle, 1.0, 1.0, true);
+	EXPECT_EQ(throttle.GetState(), IdleThrottle::State::Animating);
+	EXPECT_GE(animated, 29);
+	EXPECT_LE(animated, 31);
+
+	const int idle = CountFrames(throttle, 2.0, 1.0, false);
+	EXPECT_EQ(throttle.GetState(), IdleThrottle::State::Idle);
+	EXPECT_GE(idle, 3);
+	EXPECT_LE(idle, 5);
+	EXPECT_GT(throttle.GetSkippedFrames(), 0u);
+}
+
+TEST(IdleThrottleTest, ActivityWakesImmediately)
+{
+	IdleThrottle throttle;
+	throttle.NotifyActivity(0.0);
+	EXPECT_TRUE(throttle.ShouldRunFrame(5.0, false));
+	EXPECT_FALSE(throttle.ShouldRunFrame(5.01, false));
+
+	throttle.NotifyActivity(5.02);
+	EXPECT_TRUE(throttle.ShouldRunFrame(5.02, false));
+	EXPECT_EQ(throttle.GetState(), IdleThrottle::State::Interactive);
+}
+
+TEST(IdleThrottleTest, DisabledNeverSkips)
+{
+	IdleThrottle throttle;
+	throttle.GetSettings().enabled = false;
+	EXPECT_EQ(CountFrames(throttle, 100.0, 0.1, false), 100);
+}
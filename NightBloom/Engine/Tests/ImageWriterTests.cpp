@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+// ImageWriterTests.cpp
+//
+// Unit tests for the PNG and OpenEXR encoders behind offscreen captures
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/ImageWriter.hpp"
+#include "ThirdParty/stb/stb_image.h"
+#include <glm/gtc/packing.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Smooth gradients with repeated bands and some noise: exercises both
+	// literals and long back-references
+	std::vector<uint8_t> MakePixels(uint32_t width, uint32_t height, uint32_t channels)
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * channels);
+		uint32_t seed = 12345;
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				uint8_t* p = &pixels[(static_cast<size_t>(y) * width + x) * channels];
+				p[0] = static_cast<uint8_t>(x * 3);
+				p[1] = static_cast<uint8_t>((y / 8) * 40);
+				p[2] = static_cast<uint8_t>((x + y) % 7 == 0 ? seed >> 24 : 128);
+				if (channels == 4)
+					p[3] = static_cast<uint8_t>(255 - x);
+			}
+		}
+		return pixels;
+	}
+
+	template<typename T>
+	T ReadLE(const std::vector<uint8_t>& bytes, size_t offset)
+	{
+		T value;
+		std::memcpy(&value, bytes.data() + offset, sizeof(T));
+		return value;
+	}
+
+	// Offset just past the attribute `name`'s header (its value), or 0
+	size_t FindExrAttribute(const std::vector<uint8_t>& exr, const char* name)
+	{
+		size_t pos = 8;
+		while (pos < exr.size() && exr[pos] != 0)
+		{
+			const std::string attribute(reinterpret_cast<const char*>(&exr[pos]));
+			pos += attribute.size() + 1;
+			const std::string type(reinterpret_cast<const char*>(&exr[pos]));
+			pos += type.size() + 1;
+			const int32_t size = ReadLE<int32_t>(exr, pos);
+			pos += 4;
+			if (attribute == name)
+				return pos;
+			pos += size;
+		}
+		return 0;
+	}
+
+	size_t ExrHeaderEnd(const std::vector<uint8_t>& exr)
+	{
+		size_t pos = 8;
+		while (exr[pos] != 0)
+		{
+			pos += std::strlen(reinterpret_cast<const char*>(&exr[pos])) + 1;
+			pos += std::strlen(reinterpret_cast<const char*>(&exr[pos])) + 1;
+			pos += 4 + ReadLE<int32_t>(exr, pos);
+		}
+		return pos + 1;
+	}
+}
+
+TEST(ImageWriter, PngRoundTripsRgb)
+{
+	const uint32_t width = 97, height = 61;
+	const std::vector<uint8_t> pixels = MakePixels(width, height, 3);
+
+	const std::vector<uint8_t> png = EncodePng(pixels.data(), width, height, 3);
+	ASSERT_FALSE(png.empty());
+	EXPECT_LT(png.size(), pixels.size());   // the bands compress
+
+	int w = 0, h = 0, channels = 0;
+	stbi_uc* decoded = stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &w, &h, &channels, 3);
+	ASSERT_NE(decoded, nullptr) << stbi_failure_reason();
+	EXPECT_EQ(w, static_cast<int>(width));
+	EXPECT_EQ(h, static_cast<int>(height));
+	EXPECT_EQ(channels, 3);
+	EXPECT_EQ(std::memcmp(decoded, pixels.data(), pixels.size()), 0);
+	stbi_image_free(decoded);
+}
+
+TEST(ImageWriter, PngRoundTripsRgbaAcrossTheWindow)
+{
+	// Rows wider than the 32K deflate window, so matches hit its edge
+	const uint32_t width = 9000, height = 6;
+	const std::vector<uint8_t> pixels = MakePixels(width, height, 4);
+
+	const std::vector<uint8_t> png = EncodePng(pixels.data(), width, height, 4);
+	ASSERT_FALSE(png.empty());
+
+	int w = 0, h = 0, channels = 0;
+	stbi_uc* decoded = stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &w, &h, &channels, 4);
+	ASSERT_NE(decoded, nullptr) << stbi_failure_reason();
+	EXPECT_EQ(channels, 4);
+	EXPECT_EQ(std::memcmp(decoded, pixels.data(), pixels.size()), 0);
+	stbi_image_free(decoded);
+}
+
+TEST(ImageWriter, PngRejectsBadArguments)
+{
+	const uint8_t pixel[4] = {};
+	EXPECT_TRUE(EncodePng(pixel, 1, 1, 2).empty());
+	EXPECT_TRUE(EncodePng(pixel, 0, 1, 3).empty());
+	EXPECT_TRUE(EncodePng(nullptr, 1, 1, 3).empty());
+}
+
+TEST(ImageWriter, ExrStoresHalfScanlines)
+{
+	const uint32_t width = 5, height = 3;
+	std::vector<uint16_t> rgb(width * height * 3);
+	for (uint32_t i = 0; i < width * height; ++i)
+	{
+		rgb[i * 3 + 0] = glm::packHalf1x16(static_cast<float>(i));
+		rgb[i * 3 + 1] = glm::packHalf1x16(0.5f);
+		rgb[i * 3 + 2] = glm::packHalf1x16(100.0f + i);
+	}
+
+	const std::vector<uint8_t> exr = EncodeExr(rgb.data(), width, height);
+	ASSERT_GT(exr.size(), 8u);
+	EXPECT_EQ(ReadLE<uint32_t>(exr, 0), 20000630u);
+	EXPECT_EQ(exr[4], 2);
+
+	const size_t dataWindow = FindExrAttribute(exr, "dataWindow");
+	ASSERT_NE(dataWindow, 0u);
+	EXPECT_EQ(ReadLE<int32_t>(exr, dataWindow + 8), static_cast<int32_t>(width - 1));
+	EXPECT_EQ(ReadLE<int32_t>(exr, dataWindow + 12), static_cast<int32_t>(height - 1));
+	const size_t compression = FindExrAttribute(exr, "compression");
+	ASSERT_NE(compression, 0u);
+	EXPECT_EQ(exr[compression], 0);
+
+	// Second line through the offset table: y, size, then B, G, R runs
+	const size_t table = ExrHeaderEnd(exr);
+	const size_t line = static_cast<size_t>(ReadLE<uint64_t>(exr, table + 8));
+	EXPECT_EQ(ReadLE<int32_t>(exr, line), 1);
+	EXPECT_EQ(ReadLE<int32_t>(exr, line + 4), static_cast<int32_t>(width * 3 * 2));
+	const size_t blue = line + 8;
+	const size_t red = blue + 2 * width * 2;
+	EXPECT_FLOAT_EQ(glm::unpackHalf1x16(ReadLE<uint16_t>(exr, blue + 2 * 2)), 100.0f + width + 2);
+	EXPECT_FLOAT_EQ(glm::unpackHalf1x16(ReadLE<uint16_t>(exr, red + 2 * 2)), static_cast<float>(width + 2));
+
+	const size_t lastLine = static_cast<size_t>(ReadLE<uint64_t>(exr, table + 16));
+	EXPECT_EQ(lastLine + 8 + width * 3 * 2, exr.size());
+}
+
+TEST(ImageWriter, WritesThroughMissingDirectories)
+{
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "nb_image_writer_test";
+	std::filesystem::remove_all(dir);
+	const std::string path = (dir / "shots" / "frame.png").string();
+
+	const std::vector<uint8_t> bytes = { 1, 2, 3, 4 };
+	ASSERT_TRUE(WriteImageFile(path, bytes));
+
+	std::ifstream file(path, std::ios::binary);
+	const std::vector<uint8_t> read((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	EXPECT_EQ(read, bytes);
+	EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+	file.close();
+	std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// JobSystemTests.cpp
+//
+// Unit tests for the work-stealing job scheduler
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/JobSystem.hpp"
+#include <numeric>
+
+using namespace Nightbloom;
+
+TEST(JobSystemTest, RunsInlineBeforeInitialize)
+{
+	JobSystem jobs;
+	JobCounter done;
+	int value = 0;
+
+	jobs.Run([&value]() { value = 42; }, &done);
+	EXPECT_EQ(value, 42);
+	EXPECT_TRUE(done.IsDone());
+}
+
+TEST(JobSystemTest, WaitCoversEveryJobOnTheCounter)
+{
+	JobSystem jobs;
+	jobs.Initialize(3);
+
+	std::atomic<uint32_t> ran{ 0 };
+	JobCounter done;
+	for (uint32_t i = 0; i < 1000; ++i)
+		jobs.Run([&ran]() { ran.fetch_add(1); }, &done);
+
+	jobs.Wait(done);
+	EXPECT_EQ(ran.load(), 1000u);
+	EXPECT_EQ(done.GetPending(), 0u);
+}
+
+TEST(JobSystemTest, NestedJobsAndWaitsMakeProgress)
+{
+	JobSystem jobs;
+	jobs.Initialize(2);
+
+	// More waiting parents than workers: only helping-while-waiting keeps
+	// this from deadlocking
+	std::atomic<uint32_t> leaves{ 0 };
+	JobCounter parents;
+	for (uint32_t p = 0; p < 16; ++p)
+	{
+		jobs.Run([&jobs, &leaves]()
+			{
+				JobCounter children;
+				for (uint32_t c = 0; c < 16; ++c)
+					jobs.Run([&leaves]() { leaves.fetch_add(1); }, &children);
+				jobs.Wait(children);
+			}, &parents);
+	}
+
+	jobs.Wait(parents);
+	EXPECT_EQ(leaves.load(), 256u);
+}
+
+TEST(JobSystemTest, RunAfterWaitsForItsDependency)
+{
+	JobSystem jobs;
+	jobs.Initialize(3);
+
+	std::atomic<uint32_t> stageOne{ 0 };
+	std::atomic<uint32_t> seenByStageTwo{ 0 };
+	JobCounter first, second;
+
+	for (uint32_t i = 0; i < 64; ++i)
+		jobs.Run([&stageOne]() { stageOne.fetch_add(1); }, &first);
+	jobs.RunAfter(first, [&]() { seenByStageTwo = stageOne.load(); }, &second);
+
+	jobs.Wait(second);
+	EXPECT_EQ(seenByStageTwo.load(), 64u);
+
+	// Already-drained dependency: runs straight away
+	bool ranLate = false;
+	JobCounter late;
+	jobs.RunAfter(first, [&ranLate]() { ranLate = true; }, &late);
+	jobs.Wait(late);
+	EXPECT_TRUE(ranLate);
+}
+
+TEST(JobSystemTest, ParallelForCoversTheRangeOnce)
+{
+	JobSystem jobs;
+	jobs.Initialize(3);
+
+	std::vector<uint32_t> hits(10007, 0);
+	jobs.ParallelFor(static_cast<uint32_t>(hits.size()), 64, [&hits](uint32_t begin, uint32_t end)
+		{
+			EXPECT_LE(end - begin, 64u);
+			for (uint32_t i = begin; i < end; ++i)
+				++hits[i];
+		});
+
+	EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0u), hits.size());
+	EXPECT_EQ(*std::min_element(hits.begin(), hits.end()), 1u);
+}
+
+TEST(JobSystemTest, ShutdownFinishesQueuedWork)
+{
+	std::atomic<uint32_t> ran{ 0 };
+	{
+		JobSystem jobs;
+		jobs.Initialize(2);
+		for (uint32_t i = 0; i < 200; ++i)
+			jobs.Run([&ran]() { ran.fetch_add(1); });
+		jobs.Shutdown();
+		EXPECT_FALSE(jobs.IsRunning());
+	}
+	EXPECT_EQ(ran.load(), 200u);
+}
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+// LightCullingTests.cpp
+//
+// Unit tests for the CPU-side light selection (frustum cull + importance sort)
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/LightCulling.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+namespace
+{
+	Light MakePoint(const glm::vec3& position, float intensity, float radius = 10.0f)
+	{
+		Light light;
+		light.type = LightType::Point;
+		light.position = position;
+		light.intensity = intensity;
+		light.radius = radius;
+		return light;
+	}
+
+	Light MakeSun()
+	{
+		Light light;
+		light.type = LightType::Directional;
+		light.direction = glm::vec3(0.0f, -1.0f, 0.0f);
+		return light;
+	}
+
+	// Camera at the origin looking down -Z
+	Frustum ForwardFrustum()
+	{
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+		return Frustum::ExtractFromMatrix(proj * view);
+	}
+}
+
+TEST(LightCulling, DirectionalLightsComeFirstInSceneOrder)
+{
+	std::vector<Light> lights = { MakePoint(glm::vec3(0.0f, 0.0f, -5.0f), 1.0f), MakeSun() };
+	lights[1].intensity = 2.0f;
+
+	std::vector<LightData> out;
+	SelectLights(lights, nullptr, glm::vec3(0.0f), out);
+
+	ASSERT_EQ(out.size(), 2u);
+	EXPECT_EQ(out[0].position.w, 0.0f);   // directional
+	EXPECT_EQ(out[0].color.a, 2.0f);
+	EXPECT_EQ(out[1].position.w, 1.0f);
+}
+
+TEST(LightCulling, PointLightsOutsideTheFrustumAreCulled)
+{
+	std::vector<Light> lights = {
+		MakePoint(glm::vec3(0.0f, 0.0f, -20.0f), 1.0f),   // ahead
+		MakePoint(glm::vec3(0.0f, 0.0f, 50.0f), 1.0f),    // far behind
+		MakePoint(glm::vec3(0.0f, 0.0f, 5.0f), 1.0f),     // behind, radius reaches into view
+	};
+
+	std::vector<LightData> out;
+	const Frustum frustum = ForwardFrustum();
+	const uint32_t culled = SelectLights(lights, &frustum, glm::vec3(0.0f), out);
+
+	EXPECT_EQ(culled, 1u);
+	ASSERT_EQ(out.size(), 2u);
+	for (const LightData& light : out)
+		EXPECT_NE(light.position.z, 50.0f);
+}
+
+TEST(LightCulling, PointLightsSortByImportance)
+{
+	std::vector<Light> lights = {
+		MakePoint(glm::vec3(0.0f, 0.0f, -40.0f), 1.0f),   // far
+		MakePoint(glm::vec3(0.0f, 0.0f, -5.0f), 1.0f),    // near
+		MakePoint(glm::vec3(0.0f, 0.0f, -40.0f), 8.0f),   // far but bright
+	};
+
+	std::vector<LightData> out;
+	SelectLights(lights, nullptr, glm::vec3(0.0f), out);
+
+	ASSERT_EQ(out.size(), 3u);
+	EXPECT_EQ(out[0].position.z, -5.0f);
+	EXPECT_EQ(out[1].color.a, 8.0f);
+	EXPECT_EQ(out[2].color.a, 1.0f);
+	EXPECT_EQ(out[2].position.z, -40.0f);
+}
+
+TEST(LightCulling, DisabledLightsAndPointOnlySelection)
+{
+	std::vector<Light> lights = { MakeSun(), MakePoint(glm::vec3(1.0f), 1.0f), MakePoint(glm::vec3(2.0f), 1.0f) };
+	lights[2].enabled = false;
+
+	std::vector<LightData> out;
+	SelectLights(lights, nullptr, glm::vec3(0.0f), out, true);
+
+	ASSERT_EQ(out.size(), 1u);
+	EXPECT_EQ(out[0].position, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+}
@@ -0,0 +1,323 @@
+//------------------------------------------------------------------------------
+// LocalShadowAtlasTests.cpp
+//
+// Unit tests for the point light shadow atlas: tile allocation, slot
+// retention, static caching and the face projections
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/LocalShadowAtlas.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+namespace
+{
+	LightData MakePointLight(const glm::vec3& position, float radius, bool shadowed = true)
+	{
+		LightData light;
+		light.position = glm::vec4(position, shadowed ? LocalShadowAtlas::POINT_SHADOW_REQUEST : 1.0f);
+		light.attenuation.w = radius;
+		return light;
+	}
+
+	bool Overlaps(const LocalShadowTile& a, const LocalShadowTile& b)
+	{
+		return a.x < b.x + b.size && b.x < a.x + a.size &&
+			a.y < b.y + b.size && b.y < a.y + a.size;
+	}
+
+	std::vector<LocalShadowTile> ActiveTiles(const LocalShadowAtlas& atlas)
+	{
+		std::vector<LocalShadowTile> tiles;
+		for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		{
+			const LocalShadowSlot& entry = atlas.GetSlot(slot);
+			if (entry.active)
+				tiles.insert(tiles.end(), entry.faces.begin(), entry.faces.end());
+		}
+		return tiles;
+	}
+}
+
+TEST(LocalShadowAtlasTest, EncodesTheSlotInPositionW)
+{
+	const LightData plain = MakePointLight(glm::vec3(1.0f), 5.0f, false);
+	const LightData shadowed = MakePointLight(glm::vec3(1.0f), 5.0f);
+	EXPECT_FALSE(LocalShadowAtlas::WantsShadow(plain));
+	EXPECT_TRUE(LocalShadowAtlas::WantsShadow(shadowed));
+
+	EXPECT_FLOAT_EQ(LocalShadowAtlas::EncodeLight(shadowed, 3).position.w, 5.0f);
+	EXPECT_FLOAT_EQ(LocalShadowAtlas::EncodeLight(shadowed, -1).position.w, 1.0f);
+	EXPECT_EQ(LocalShadowAtlas::LightKey(plain), LocalShadowAtlas::LightKey(shadowed));
+	EXPECT_NE(LocalShadowAtlas::LightKey(shadowed), LocalShadowAtlas::LightKey(MakePointLight(glm::vec3(1.0f), 6.0f)));
+}
+
+TEST(LocalShadowAtlasTest, LightDataAsksForAShadowWhenItCastsOne)
+{
+	Light light;
+	light.type = LightType::Point;
+	EXPECT_FLOAT_EQ(light.ToGPUData().position.w, 1.0f);
+	light.shadowConfig.castsShadows = true;
+	EXPECT_TRUE(LocalShadowAtlas::WantsShadow(light.ToGPUData()));
+}
+
+TEST(LocalShadowAtlasTest, TileSizeIsAClampedPowerOfTwoWithHysteresis)
+{
+	LocalShadowSettings settings;
+	settings.minTileSize = 64;
+	settings.maxTileSize = 1024;
+
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(300.0f, 0, settings, 4096), 256u);
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(5000.0f, 0, settings, 4096), 1024u);
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(10.0f, 0, settings, 4096), 64u);
+	// No face larger than a quarter of the atlas
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(5000.0f, 0, settings, 2048), 512u);
+
+	// A light at 256 stays there until it wants under 192 or 640 and more
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(200.0f, 256, settings, 4096), 256u);
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(600.0f, 256, settings, 4096), 256u);
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(150.0f, 256, settings, 4096), 128u);
+	EXPECT_EQ(LocalShadowAtlas::ChooseTileSize(700.0f, 256, settings, 4096), 512u);
+}
+
+TEST(LocalShadowAtlasTest, ScreenDiameterGrowsAsTheLightNears)
+{
+	const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 1000.0f);
+	const Frustum frustum = Frustum::ExtractFromMatrix(proj * view);
+
+	const float farDiameter = LocalShadowAtlas::ScreenDiameter(glm::vec3(0.0f, 0.0f, -100.0f), 5.0f, view,
+		proj[1][1], 1080.0f, frustum);
+	const float nearDiameter = LocalShadowAtlas::ScreenDiameter(glm::vec3(0.0f, 0.0f, -20.0f), 5.0f, view,
+		proj[1][1], 1080.0f, frustum);
+	EXPECT_GT(farDiameter, 0.0f);
+	EXPECT_GT(nearDiameter, farDiameter * 4.0f);
+
+	// Inside the sphere, and behind the camera
+	EXPECT_FLOAT_EQ(LocalShadowAtlas::ScreenDiameter(glm::vec3(0.0f, 0.0f, -2.0f), 5.0f, view,
+		proj[1][1], 1080.0f, frustum), 1080.0f);
+	EXPECT_FLOAT_EQ(LocalShadowAtlas::ScreenDiameter(glm::vec3(0.0f, 0.0f, 50.0f), 5.0f, view,
+		proj[1][1], 1080.0f, frustum), 0.0f);
+}
+
+TEST(LocalShadowAtlasTest, AssignsDisjointTilesLargestFirst)
+{
+	LocalShadowAtlas atlas(4096);
+	LocalShadowSettings settings;
+	settings.maxLights = 8;
+
+	std::vector<LocalShadowRequest> requests;
+	for (uint32_t i = 0; i < 10; ++i)
+		requests.push_back({ 100u + i, 100.0f * static_cast<float>(i + 1) });
+	std::vector<int32_t> slots;
+	atlas.Assign(requests, settings, slots);
+
+	// The two smallest lose out to the cap
+	EXPECT_EQ(slots[0], -1);
+	EXPECT_EQ(slots[1], -1);
+	for (uint32_t i = 2; i < 10; ++i)
+	{
+		ASSERT_GE(slots[i], 0);
+		const LocalShadowSlot& entry = atlas.GetSlot(slots[i]);
+		EXPECT_EQ(entry.key, requests[i].key);
+		for (const LocalShadowTile& tile : entry.faces)
+		{
+			EXPECT_LE(tile.x + tile.size, 4096u);
+			EXPECT_LE(tile.y + tile.size, 4096u);
+		}
+	}
+
+	const std::vector<LocalShadowTile> tiles = ActiveTiles(atlas);
+	ASSERT_EQ(tiles.size(), 8u * LOCAL_SHADOW_FACES);
+	for (size_t a = 0; a < tiles.size(); ++a)
+	{
+		for (size_t b = a + 1; b < tiles.size(); ++b)
+			EXPECT_FALSE(Overlaps(tiles[a], tiles[b])) << a << " " << b;
+	}
+
+	// Off screen lights get nothing
+	requests[9].texels = 0.0f;
+	atlas.Assign(requests, settings, slots);
+	EXPECT_EQ(slots[9], -1);
+}
+
+TEST(LocalShadowAtlasTest, LightsKeepTheirTilesAcrossFrames)
+{
+	LocalShadowAtlas atlas(4096);
+	LocalShadowSettings settings;
+
+	std::vector<LocalShadowRequest> requests = { { 1, 900.0f }, { 2, 300.0f }, { 3, 100.0f } };
+	std::vector<int32_t> slots;
+	atlas.Assign(requests, settings, slots);
+	const LocalShadowSlot kept = atlas.GetSlot(slots[1]);
+	const int32_t keptSlot = slots[1];
+
+	// Light 1 goes away and light 2 drifts within its hysteresis band
+	requests = { { 2, 320.0f }, { 3, 100.0f } };
+	atlas.Assign(requests, settings, slots);
+	EXPECT_EQ(slots[0], keptSlot);
+	EXPECT_EQ(atlas.GetSlot(slots[0]).faces, kept.faces);
+}
+
+TEST(LocalShadowAtlasTest, FullAtlasDegradesToSmallerTiles)
+{
+	LocalShadowAtlas atlas(1024);
+	LocalShadowSettings settings;
+	settings.minTileSize = 64;
+
+	// Six 256 faces fill 6/16 of the atlas: two lights fit, the third shrinks
+	std::vector<LocalShadowRequest> requests = { { 1, 256.0f }, { 2, 256.0f }, { 3, 256.0f } };
+	std::vector<int32_t> slots;
+	atlas.Assign(requests, settings, slots);
+	ASSERT_GE(slots[0], 0);
+	ASSERT_GE(slots[1], 0);
+	ASSERT_GE(slots[2], 0);
+	EXPECT_EQ(atlas.GetSlot(slots[0]).faces[0].size, 256u);
+	EXPECT_EQ(atlas.GetSlot(slots[1]).faces[0].size, 256u);
+	EXPECT_EQ(atlas.GetSlot(slots[2]).faces[0].size, 128u);
+
+	const std::vector<LocalShadowTile> tiles = ActiveTiles(atlas);
+	for (size_t a = 0; a < tiles.size(); ++a)
+	{
+		for (size_t b = a + 1; b < tiles.size(); ++b)
+			EXPECT_FALSE(Overlaps(tiles[a], tiles[b]));
+	}
+}
+
+TEST(LocalShadowAtlasTest, ShrunkLightsGrowBackWhenSpaceFrees)
+{
+	LocalShadowAtlas atlas(1024);
+	LocalShadowSettings settings;
+	settings.minTileSize = 64;
+
+	std::vector<LocalShadowRequest> requests = { { 1, 256.0f }, { 2, 256.0f }, { 3, 256.0f } };
+	std::vector<int32_t> slots;
+	atlas.Assign(requests, settings, slots);
+	ASSERT_GE(slots[2], 0);
+	const int32_t shrunkSlot = slots[2];
+	ASSERT_EQ(atlas.GetSlot(shrunkSlot).faces[0].size, 128u);
+	atlas.MarkRendered(static_cast<uint32_t>(shrunkSlot), 7);
+
+	// Still no room: the shrunk light keeps its tiles and what was drawn
+	const LocalShadowSlot before = atlas.GetSlot(shrunkSlot);
+	atlas.Assign(requests, settings, slots);
+	EXPECT_EQ(slots[2], shrunkSlot);
+	EXPECT_EQ(atlas.GetSlot(shrunkSlot).faces, before.faces);
+	EXPECT_FALSE(atlas.NeedsRender(static_cast<uint32_t>(shrunkSlot), 7, true));
+
+	// Light 1 goes away and light 3 takes its size back, to be drawn again
+	requests = { { 2, 256.0f }, { 3, 256.0f } };
+	atlas.Assign(requests, settings, slots);
+	EXPECT_EQ(slots[1], shrunkSlot);
+	EXPECT_EQ(atlas.GetSlot(shrunkSlot).faces[0].size, 256u);
+	EXPECT_TRUE(atlas.NeedsRender(static_cast<uint32_t>(shrunkSlot), 7, true));
+
+	const std::vector<LocalShadowTile> tiles = ActiveTiles(atlas);
+	for (size_t a = 0; a < tiles.size(); ++a)
+	{
+		for (size_t b = a + 1; b < tiles.size(); ++b)
+			EXPECT_FALSE(Overlaps(tiles[a], tiles[b]));
+	}
+}
+
+TEST(LocalShadowAtlasTest, StaticLightsRenderOnceUntilTheirCastersChange)
+{
+	LocalShadowAtlas atlas(4096);
+	LocalShadowSettings settings;
+	std::vector<LocalShadowRequest> requests = { { 7, 256.0f } };
+	std::vector<int32_t> slots;
+	atlas.Assign(requests, settings, slots);
+	const uint32_t slot = static_cast<uint32_t>(slots[0]);
+
+	EXPECT_TRUE(atlas.NeedsRender(slot, 42, true));
+	atlas.MarkRendered(slot, 42);
+	EXPECT_FALSE(atlas.NeedsRender(slot, 42, true));
+	EXPECT_TRUE(atlas.NeedsRender(slot, 43, true));   // a caster moved
+	EXPECT_TRUE(atlas.NeedsRender(slot, 42, false));  // caching off
+
+	// Kept across frames, and drawn again once invalidated
+	atlas.Assign(requests, settings, slots);
+	EXPECT_FALSE(atlas.NeedsRender(slot, 42, true));
+	atlas.Invalidate();
+	EXPECT_TRUE(atlas.NeedsRender(slot, 42, true));
+
+	// A slot that changes size starts over
+	atlas.MarkRendered(slot, 42);
+	requests[0].texels = 1024.0f;
+	atlas.Assign(requests, settings, slots);
+	EXPECT_TRUE(atlas.NeedsRender(static_cast<uint32_t>(slots[0]), 42, true));
+}
+
+TEST(LocalShadowAtlasTest, FacesCoverEveryDirection)
+{
+	EXPECT_EQ(LocalShadowAtlas::SelectFace(glm::vec3(2.0f, 1.0f, -1.0f)), 0u);
+	EXPECT_EQ(LocalShadowAtlas::SelectFace(glm::vec3(-2.0f, 1.0f, 1.0f)), 1u);
+	EXPECT_EQ(LocalShadowAtlas::SelectFace(glm::vec3(0.5f, 3.0f, 1.0f)), 2u);
+	EXPECT_EQ(LocalShadowAtlas::SelectFace(glm::vec3(0.5f, -3.0f, 1.0f)), 3u);
+	EXPECT_EQ(LocalShadowAtlas::SelectFace(glm::vec3(0.5f, 1.0f, 4.0f)), 4u);
+	EXPECT_EQ(LocalShadowAtlas::SelectFace(glm::vec3(0.5f, 1.0f, -4.0f)), 5u);
+
+	// A point lands inside its own face's clip volume, depth growing with distance
+	const glm::vec3 light(1.0f, 2.0f, 3.0f);
+	const glm::vec3 offsets[] = { { 3.0f, 1.0f, -1.0f }, { -3.0f, 0.5f, 1.0f }, { 1.0f, 3.0f, 0.5f },
+		{ -1.0f, -3.0f, 0.5f }, { 0.5f, 1.0f, 3.0f }, { 0.5f, -1.0f, -3.0f } };
+	for (const glm::vec3& offset : offsets)
+	{
+		const uint32_t face = LocalShadowAtlas::SelectFace(offset);
+		const glm::mat4 viewProj = LocalShadowAtlas::FaceViewProj(light, 10.0f, face, 0.05f);
+		const glm::vec4 nearClip = viewProj * glm::vec4(light + offset, 1.0f);
+		const glm::vec4 farClip = viewProj * glm::vec4(light + offset * 2.0f, 1.0f);
+		const glm::vec3 ndc = glm::vec3(nearClip) / nearClip.w;
+		EXPECT_GT(nearClip.w, 0.0f) << face;
+		EXPECT_LE(std::abs(ndc.x), 1.0f) << face;
+		EXPECT_LE(std::abs(ndc.y), 1.0f) << face;
+		EXPECT_GT(ndc.z, 0.0f) << face;
+		EXPECT_LT(ndc.z, farClip.z / farClip.w) << face;
+	}
+}
+
+TEST(LocalShadowAtlasTest, TileTransformMapsClipSpaceOntoTheTile)
+{
+	const LocalShadowTile tile{ 1024, 512, 256 };
+	const glm::mat4 transform = LocalShadowAtlas::TileTransform(tile, 4096);
+
+	// Clip corners land on the tile's corners in atlas uv
+	const glm::vec4 low = transform * glm::vec4(-1.0f, -1.0f, 0.5f, 1.0f);
+	const glm::vec4 high = transform * glm::vec4(1.0f, 1.0f, 0.5f, 1.0f);
+	EXPECT_FLOAT_EQ(low.x * 0.5f + 0.5f, 1024.0f / 4096.0f);
+	EXPECT_FLOAT_EQ(low.y * 0.5f + 0.5f, 512.0f / 4096.0f);
+	EXPECT_FLOAT_EQ(high.x * 0.5f + 0.5f, 1280.0f / 4096.0f);
+	EXPECT_FLOAT_EQ(high.y * 0.5f + 0.5f, 768.0f / 4096.0f);
+	EXPECT_FLOAT_EQ(low.z, 0.5f);
+
+	const glm::vec4 rect = LocalShadowAtlas::TileRect(tile, 4096);
+	EXPECT_FLOAT_EQ(rect.x, 1024.5f / 4096.0f);
+	EXPECT_FLOAT_EQ(rect.w, 767.5f / 4096.0f);
+}
+
+TEST(LocalShadowAtlasTest, BoxesTouchTheSphereTheyReachInto)
+{
+	const glm::vec4 sphere(0.0f, 0.0f, 0.0f, 5.0f);
+	EXPECT_TRUE(LocalShadowAtlas::BoxTouchesSphere(glm::vec3(6.0f, 0.0f, 0.0f), glm::vec3(1.5f), sphere));
+	EXPECT_FALSE(LocalShadowAtlas::BoxTouchesSphere(glm::vec3(8.0f, 0.0f, 0.0f), glm::vec3(1.5f), sphere));
+	// The corner of a box diagonal to the light
+	EXPECT_FALSE(LocalShadowAtlas::BoxTouchesSphere(glm::vec3(5.0f, 5.0f, 0.0f), glm::vec3(1.0f), sphere));
+}
+
+TEST(LocalShadowAtlasTest, UniformsCarryTheLiveSlots)
+{
+	LocalShadowAtlas atlas(4096);
+	LocalShadowSettings settings;
+	std::vector<LocalShadowRequest> requests = { { LocalShadowAtlas::LightKey(MakePointLight(glm::vec3(4.0f), 10.0f)), 512.0f } };
+	std::vector<int32_t> slots;
+	atlas.Assign(requests, settings, slots);
+
+	LocalShadowUniforms uniforms;
+	atlas.FillUniforms({ MakePointLight(glm::vec3(4.0f), 10.0f) }, slots, settings, uniforms);
+	EXPECT_FLOAT_EQ(uniforms.atlas.x, 1.0f / 4096.0f);
+	for (uint32_t slot = 0; slot < MAX_LOCAL_SHADOWS; ++slot)
+		EXPECT_FLOAT_EQ(uniforms.lightParams[slot].w, static_cast<int32_t>(slot) == slots[0] ? 1.0f : 0.0f);
+	EXPECT_FLOAT_EQ(uniforms.lightParams[slots[0]].x, 2.0f / 512.0f);
+	EXPECT_FLOAT_EQ(uniforms.lightParams[slots[0]].y, settings.normalBias);
+}
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+// LogHistoryTests.cpp
+//
+// Unit tests for the console's log history and the ring sink feeding it
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/Logger/LogHistory.hpp"
+#include "../Core/Logger/LogRingSink.hpp"
+#include <string>
+
+using namespace Nightbloom;
+
+namespace
+{
+	LogRecord MakeRecord(const std::string& message, LogLevel level = LogLevel::Info)
+	{
+		LogRecord record;
+		record.level = level;
+		record.message = message;
+		return record;
+	}
+
+	std::vector<std::string> FilteredTexts(const LogHistory& history)
+	{
+		std::vector<std::string> texts;
+		for (size_t i = 0; i < history.GetFilteredCount(); ++i)
+			texts.push_back(history.GetText(history.GetFiltered(i).message));
+		return texts;
+	}
+}
+
+TEST(LogHistoryTest, DropsTheOldestWhenFull)
+{
+	LogHistory history(3);
+	for (int i = 0; i < 5; ++i)
+		history.Append(MakeRecord(std::to_string(i)));
+
+	EXPECT_EQ(history.GetCount(), 3u);
+	EXPECT_EQ(history.GetAppendedCount(), 5u);
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "2", "3", "4" }));
+	EXPECT_EQ(history.GetInternedCount(), 3u);
+}
+
+TEST(LogHistoryTest, InternsRepeatedMessagesUntilTheLastIsEvicted)
+{
+	LogHistory history(4);
+	history.Append(MakeRecord("frame"));
+	history.Append(MakeRecord("frame"));
+	history.Append(MakeRecord("other"));
+	EXPECT_EQ(history.GetInternedCount(), 2u);
+	EXPECT_EQ(history.GetFiltered(0).message, history.GetFiltered(1).message);
+
+	// Evicts both "frame" entries
+	history.Append(MakeRecord("a"));
+	history.Append(MakeRecord("b"));
+	history.Append(MakeRecord("c"));
+	EXPECT_EQ(history.GetInternedCount(), 4u);
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "other", "a", "b", "c" }));
+
+	// A freed id is reused
+	history.Append(MakeRecord("frame"));
+	EXPECT_EQ(history.GetText(history.GetFiltered(3).message), "frame");
+}
+
+TEST(LogHistoryTest, FiltersByLevelAndText)
+{
+	LogHistory history(16);
+	history.Append(MakeRecord("Loading Terrain", LogLevel::Info));
+	history.Append(MakeRecord("terrain tile missing", LogLevel::Warn));
+	history.Append(MakeRecord("Swapchain resized", LogLevel::Info));
+	history.Append(MakeRecord("Device lost", LogLevel::Error));
+
+	LogFilter filter;
+	filter.text = "TERRAIN";
+	history.SetFilter(filter);
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "Loading Terrain", "terrain tile missing" }));
+
+	filter.levelMask = LogFilter::LevelBit(LogLevel::Warn) | LogFilter::LevelBit(LogLevel::Error);
+	history.SetFilter(filter);
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "terrain tile missing" }));
+
+	filter.text.clear();
+	history.SetFilter(filter);
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "terrain tile missing", "Device lost" }));
+}
+
+// Appending and evicting under a filter gives the index a rebuild would
+TEST(LogHistoryTest, IncrementalIndexMatchesARebuild)
+{
+	LogFilter filter;
+	filter.text = "7";
+	filter.levelMask = ~LogFilter::LevelBit(LogLevel::Trace);
+
+	LogHistory incremental(50);
+	incremental.SetFilter(filter);
+	LogHistory rebuilt(50);
+	for (int i = 0; i < 400; ++i)
+	{
+		const LogRecord record = MakeRecord("line " + std::to_string(i % 90), (i % 3 == 0) ? LogLevel::Trace : LogLevel::Info);
+		incremental.Append(record);
+		rebuilt.Append(record);
+	}
+	rebuilt.SetFilter(filter);
+
+	EXPECT_GT(incremental.GetFilteredCount(), 0u);
+	EXPECT_EQ(FilteredTexts(incremental), FilteredTexts(rebuilt));
+}
+
+TEST(LogHistoryTest, ClearEmptiesEverything)
+{
+	LogHistory history(8);
+	history.Append(MakeRecord("x"));
+	history.Append(MakeRecord("y"));
+	history.Clear();
+	EXPECT_EQ(history.GetCount(), 0u);
+	EXPECT_EQ(history.GetFilteredCount(), 0u);
+	EXPECT_EQ(history.GetInternedCount(), 0u);
+	EXPECT_EQ(history.GetAppendedCount(), 0u);
+
+	history.Append(MakeRecord("z"));
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "z" }));
+}
+
+TEST(LogRingSinkTest, DrainsInOrderAndCountsDrops)
+{
+	LogRingSink sink(4);
+	for (int i = 0; i < 6; ++i)
+	{
+		LogRecord record = MakeRecord(std::to_string(i), LogLevel::Warn);
+		record.thread = 3;
+		sink.WriteRecord(record, "formatted line");
+	}
+	EXPECT_EQ(sink.GetDroppedCount(), 2u);
+
+	LogHistory history(16);
+	EXPECT_EQ(sink.Drain(history), 4u);
+	EXPECT_EQ(FilteredTexts(history), (std::vector<std::string>{ "0", "1", "2", "3" }));
+	EXPECT_EQ(history.GetFiltered(0).level, LogLevel::Warn);
+	EXPECT_EQ(history.GetFiltered(0).thread, 3u);
+
+	sink.Write(LogLevel::Error, "direct");
+	EXPECT_EQ(sink.Drain(history), 1u);
+	EXPECT_EQ(history.GetText(history.GetFiltered(4).message), "direct");
+}
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// LogQueueTests.cpp
+//
+// Unit tests for the logger's lock-free MPSC record queue
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/Logger/LogQueue.hpp"
+#include <thread>
+#include <vector>
+
+using namespace Nightbloom;
+
+namespace
+{
+	LogRecord MakeRecord(const std::string& message)
+	{
+		LogRecord record;
+		record.message = message;
+		return record;
+	}
+}
+
+TEST(LogQueueTest, PopsInPushOrderAndReportsPositions)
+{
+	LogQueue queue(4);
+	EXPECT_EQ(queue.GetCapacity(), 4u);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		LogRecord record = MakeRecord(std::to_string(i));
+		uint64_t position = 0;
+		ASSERT_TRUE(queue.TryPush(record, position));
+		EXPECT_EQ(position, static_cast<uint64_t>(i));
+	}
+	EXPECT_EQ(queue.GetPushCount(), 3u);
+
+	LogRecord out;
+	for (int i = 0; i < 3; ++i)
+	{
+		ASSERT_TRUE(queue.TryPop(out));
+		EXPECT_EQ(out.message, std::to_string(i));
+	}
+	EXPECT_FALSE(queue.TryPop(out));
+	EXPECT_EQ(queue.GetPopCount(), 3u);
+}
+
+TEST(LogQueueTest, FullQueueRefusesUntilPopped)
+{
+	LogQueue queue(3);   // rounds up to 4
+	uint64_t position = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		LogRecord record = MakeRecord("x");
+		ASSERT_TRUE(queue.TryPush(record, position));
+	}
+
+	LogRecord extra = MakeRecord("extra");
+	EXPECT_FALSE(queue.TryPush(extra, position));
+	EXPECT_EQ(extra.message, "extra");   // untouched, can be retried
+
+	LogRecord out;
+	ASSERT_TRUE(queue.TryPop(out));
+	EXPECT_TRUE(queue.TryPush(extra, position));
+	EXPECT_EQ(position, 4u);
+}
+
+TEST(LogQueueTest, ConcurrentProducersLoseNothing)
+{
+	constexpr int PRODUCERS = 4;
+	constexpr int PER_PRODUCER = 5000;
+	LogQueue queue(256);
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p < PRODUCERS; ++p)
+	{
+		producers.emplace_back([&queue, p]() {
+			for (int i = 0; i < PER_PRODUCER; ++i)
+			{
+				LogRecord record = MakeRecord(std::to_string(p) + ":" + std::to_string(i));
+				uint64_t position = 0;
+				while (!queue.TryPush(record, position))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	// Each producer's records arrive in its own order
+	std::vector<int> next(PRODUCERS, 0);
+	int received = 0;
+	LogRecord out;
+	while (received < PRODUCERS * PER_PRODUCER)
+	{
+		if (!queue.TryPop(out))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		const size_t colon = out.message.find(':');
+		const int producer = std::stoi(out.message.substr(0, colon));
+		const int index = std::stoi(out.message.substr(colon + 1));
+		EXPECT_EQ(index, next[producer]);
+		next[producer] = index + 1;
+		++received;
+	}
+
+	for (std::thread& producer : producers)
+		producer.join();
+	EXPECT_FALSE(queue.TryPop(out));
+}
@@ -74,6 +74,22 @@ namespace Nightbloom
 		EXPECT_EQ(m_TestSink->m_MessageCount, 2);
 	}
 
+	TEST_F(LoggerTest, FilteredLevelsSkipArgumentEvaluation)
+	{
+		Logger::Get().SetLogLevel(LogLevel::Warn);
+
+		int evaluated = 0;
+		auto expensive = [&evaluated]() { return ++evaluated; };
+
+		LOG_INFO("Filtered {}", expensive());
+		EXPECT_EQ(evaluated, 0);
+		EXPECT_EQ(m_TestSink->m_MessageCount, 0);
+
+		LOG_WARN("Logged {}", expensive());
+		EXPECT_EQ(evaluated, 1);
+		EXPECT_EQ(m_TestSink->m_MessageCount, 1);
+	}
+
 	TEST_F(LoggerTest, Formatting)
 	{
 		int value = 42;
@@ -84,4 +100,29 @@ namespace Nightbloom
 		EXPECT_TRUE(m_TestSink->m_LastMessage.find("Value: 42") != std::string::npos);
 		EXPECT_TRUE(m_TestSink->m_LastMessage.find("Pi: 3.14") != std::string::npos);
 	}
+
+	TEST_F(LoggerTest, AsyncWritesEverythingByFlush)
+	{
+		Logger::Get().EnableAsync(64);
+		EXPECT_TRUE(Logger::Get().IsAsync());
+
+		// More than the queue holds: producers wait, nothing is dropped
+		for (int i = 0; i < 500; ++i)
+		{
+			LOG_TRACE("Async {}", i);
+		}
+		Logger::Get().Flush();
+		EXPECT_EQ(m_TestSink->m_MessageCount, 500);
+		EXPECT_TRUE(m_TestSink->m_LastMessage.find("Async 499") != std::string::npos);
+
+		// Errors are written before LOG_ERROR returns
+		LOG_ERROR("Async failure");
+		EXPECT_EQ(m_TestSink->m_LastLevel, LogLevel::Error);
+		EXPECT_EQ(m_TestSink->m_MessageCount, 501);
+
+		LOG_INFO("Queued at shutdown");
+		Logger::Get().DisableAsync();
+		EXPECT_FALSE(Logger::Get().IsAsync());
+		EXPECT_EQ(m_TestSink->m_MessageCount, 502);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+// MainThreadTaskQueueTests.cpp
+//
+// Unit tests for the frame-budgeted main-thread task queue
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/MainThreadTaskQueue.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// A clock that only moves when a task says so
+	struct FakeClock
+	{
+		double now = 100.0;
+		MainThreadTaskQueue::ClockFn Fn() { return [this]() { return now; }; }
+	};
+}
+
+TEST(MainThreadTaskQueueTest, RunsByPriorityThenInPostingOrder)
+{
+	MainThreadTaskQueue queue;
+	std::string order;
+	queue.Post([&]() { order += "n1 "; });
+	queue.Post([&]() { order += "l1 "; }, TaskPriority::Low);
+	queue.Post([&]() { order += "h1 "; }, TaskPriority::High);
+	queue.Post([&]() { order += "n2 "; });
+	queue.Post([&]() { order += "h2 "; }, TaskPriority::High);
+
+	EXPECT_EQ(queue.GetPendingCount(), 5u);
+	EXPECT_EQ(queue.Flush(), 5u);
+	EXPECT_EQ(order, "h1 h2 n1 n2 l1 ");
+	EXPECT_EQ(queue.GetPendingCount(), 0u);
+}
+
+TEST(MainThreadTaskQueueTest, StopsOnceTheBudgetIsSpent)
+{
+	MainThreadTaskQueue queue;
+	FakeClock clock;
+	int ran = 0;
+	for (int i = 0; i < 10; ++i)
+		queue.Post([&]() { clock.now += 1.0; ++ran; });
+
+	// 1 ms each: 3 fit in 3 ms, the rest wait for later frames
+	EXPECT_EQ(queue.Run(3.0f, clock.Fn()), 3u);
+	EXPECT_EQ(queue.GetLastRun().tasksRun, 3u);
+	EXPECT_FLOAT_EQ(queue.GetLastRun().spentMs, 3.0f);
+	EXPECT_EQ(queue.GetLastRun().remaining, 7u);
+
+	EXPECT_EQ(queue.Run(3.0f, clock.Fn()), 3u);
+	EXPECT_EQ(queue.Run(3.0f, clock.Fn()), 3u);
+	EXPECT_EQ(queue.Run(3.0f, clock.Fn()), 1u);
+	EXPECT_EQ(ran, 10);
+	EXPECT_EQ(queue.Run(3.0f, clock.Fn()), 0u);
+}
+
+TEST(MainThreadTaskQueueTest, AlwaysRunsOneTaskEvenOverBudget)
+{
+	MainThreadTaskQueue queue;
+	FakeClock clock;
+	queue.Post([&]() { clock.now += 10.0; });
+	queue.Post([&]() { clock.now += 10.0; });
+
+	EXPECT_EQ(queue.Run(0.0f, clock.Fn()), 1u);
+	EXPECT_EQ(queue.Run(5.0f, clock.Fn()), 1u);
+	EXPECT_EQ(queue.GetPendingCount(), 0u);
+}
+
+TEST(MainThreadTaskQueueTest, TasksCanPostMoreWork)
+{
+	MainThreadTaskQueue queue;
+	FakeClock clock;
+	int slices = 0;
+	// A long job that re-posts its remainder a slice at a time
+	std::function<void()> slice = [&]()
+		{
+			clock.now += 2.0;
+			if (++slices < 5)
+				queue.Post(slice);
+		};
+	queue.Post(slice);
+
+	EXPECT_EQ(queue.Run(4.0f, clock.Fn()), 2u);
+	EXPECT_EQ(queue.GetPendingCount(), 1u);
+	queue.Flush();
+	EXPECT_EQ(slices, 5);
+}
+
+TEST(MainThreadTaskQueueTest, HighPriorityPostedMidRunGoesNext)
+{
+	MainThreadTaskQueue queue;
+	std::string order;
+	queue.Post([&]()
+		{
+			order += "a ";
+			queue.Post([&]() { order += "urgent "; }, TaskPriority::High);
+		});
+	queue.Post([&]() { order += "b "; });
+
+	queue.Flush();
+	EXPECT_EQ(order, "a urgent b ");
+}
+
+TEST(MainThreadTaskQueueTest, ClearDropsEverything)
+{
+	MainThreadTaskQueue queue;
+	bool ran = false;
+	queue.Post([&]() { ran = true; }, TaskPriority::High);
+	queue.Post([&]() { ran = true; }, TaskPriority::Low);
+	queue.Post(nullptr);   // ignored
+	EXPECT_EQ(queue.GetPendingCount(), 2u);
+
+	queue.Clear();
+	EXPECT_EQ(queue.GetPendingCount(), 0u);
+	EXPECT_EQ(queue.Flush(), 0u);
+	EXPECT_FALSE(ran);
+}
+
+TEST(MainThreadTaskQueueTest, CancelDropsOnlyThatOwnersTasks)
+{
+	MainThreadTaskQueue queue;
+	int panel = 0;
+	int other = 0;
+	std::string order;
+	queue.Post([&]() { order += "panel "; }, TaskPriority::Low, &panel);
+	queue.Post([&]() { order += "other "; }, TaskPriority::Low, &other);
+	queue.Post([&]() { order += "unowned "; });
+	queue.Post([&]() { order += "panel "; }, TaskPriority::High, &panel);
+
+	EXPECT_EQ(queue.Cancel(&panel), 2u);
+	EXPECT_EQ(queue.Cancel(nullptr), 0u);
+	EXPECT_EQ(queue.GetPendingCount(), 2u);
+	queue.Flush();
+	EXPECT_EQ(order, "unowned other ");
+}
+
+TEST(MainThreadTaskQueueTest, PostsFromOtherThreads)
+{
+	MainThreadTaskQueue queue;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&queue]()
+			{
+				for (int i = 0; i < 250; ++i)
+					queue.Post([]() {});
+			});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	EXPECT_EQ(queue.GetPendingCount(), 1000u);
+	EXPECT_EQ(queue.Flush(), 1000u);
+}
+
+TEST(MainThreadTaskQueueTest, BudgetIsWhatIsLeftOfTheFrame)
+{
+	MainThreadTaskQueue::BudgetSettings settings;
+	settings.headroomMs = 1.0f;
+	settings.minMs = 0.5f;
+	settings.maxMs = 4.0f;
+	settings.defaultIntervalMs = 16.0f;
+
+	// 16.6 ms frame, 13 ms used: 2.6 ms left after headroom
+	EXPECT_NEAR(MainThreadTaskQueue::ComputeBudgetMs(16.6f, 13.0f, settings), 2.6f, 1e-4f);
+	// Plenty left: capped
+	EXPECT_FLOAT_EQ(MainThreadTaskQueue::ComputeBudgetMs(33.3f, 5.0f, settings), 4.0f);
+	// Overran: the floor keeps the queue moving
+	EXPECT_FLOAT_EQ(MainThreadTaskQueue::ComputeBudgetMs(16.6f, 20.0f, settings), 0.5f);
+	// No target: the default interval
+	EXPECT_NEAR(MainThreadTaskQueue::ComputeBudgetMs(0.0f, 13.0f, settings), 2.0f, 1e-4f);
+}
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+// MeshArenaAllocatorTests.cpp
+//
+// Unit tests for the shared mesh buffer's free-list sub-allocation
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Vulkan/MeshArenaAllocator.hpp"
+
+using namespace Nightbloom;
+
+TEST(MeshArenaAllocatorTest, AllocatesBackToBack)
+{
+	MeshArenaAllocator arena(100);
+
+	EXPECT_EQ(arena.Allocate(10), 0u);
+	EXPECT_EQ(arena.Allocate(30), 10u);
+	EXPECT_EQ(arena.Allocate(60), 40u);
+	EXPECT_EQ(arena.GetUsed(), 100u);
+	EXPECT_EQ(arena.Allocate(1), MeshArenaAllocator::INVALID_OFFSET);
+	EXPECT_EQ(arena.Allocate(0), MeshArenaAllocator::INVALID_OFFSET);
+}
+
+TEST(MeshArenaAllocatorTest, FreeCoalescesWithBothNeighbours)
+{
+	MeshArenaAllocator arena(100);
+	const uint32_t a = arena.Allocate(20);
+	const uint32_t b = arena.Allocate(20);
+	const uint32_t c = arena.Allocate(20);
+	arena.Allocate(40);
+
+	arena.Free(a, 20);
+	arena.Free(c, 20);
+	EXPECT_EQ(arena.GetFreeRangeCount(), 2u);
+	EXPECT_EQ(arena.GetLargestFreeRange(), 20u);
+
+	arena.Free(b, 20);
+	EXPECT_EQ(arena.GetFreeRangeCount(), 1u);
+	EXPECT_EQ(arena.GetLargestFreeRange(), 60u);
+	EXPECT_EQ(arena.Allocate(60), 0u);
+}
+
+TEST(MeshArenaAllocatorTest, BestFitKeepsLargeHolesWhole)
+{
+	MeshArenaAllocator arena(100);
+	const uint32_t small = arena.Allocate(10);
+	arena.Allocate(10);
+	const uint32_t large = arena.Allocate(50);
+	arena.Allocate(30);
+
+	arena.Free(large, 50);
+	arena.Free(small, 10);
+
+	// The 10-element hole takes the small mesh; the 50 stays for a big one
+	EXPECT_EQ(arena.Allocate(8), small);
+	EXPECT_EQ(arena.Allocate(50), large);
+}
+
+TEST(MeshArenaAllocatorTest, EmptiesBackToOneRange)
+{
+	MeshArenaAllocator arena(64);
+	uint32_t offsets[8];
+	for (uint32_t i = 0; i < 8; ++i)
+		offsets[i] = arena.Allocate(8);
+
+	for (uint32_t i : { 3u, 0u, 7u, 5u, 1u, 6u, 2u, 4u })
+		arena.Free(offsets[i], 8);
+
+	EXPECT_TRUE(arena.IsEmpty());
+	EXPECT_EQ(arena.GetFreeRangeCount(), 1u);
+	EXPECT_EQ(arena.GetLargestFreeRange(), 64u);
+}
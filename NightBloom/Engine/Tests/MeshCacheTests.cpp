@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+// MeshCacheTests.cpp
+//
+// Unit tests for the cooked binary mesh cache
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/MeshCache.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace Nightbloom;
+
+namespace
+{
+	ModelData MakeModel()
+	{
+		ModelData model;
+		model.name = "Crate";
+
+		MaterialData material;
+		material.name = "Wood";
+		material.baseColorFactor = glm::vec4(0.5f, 0.25f, 1.0f, 1.0f);
+		material.baseColorTexturePath = "/assets/crate/textures/wood.png";
+		material.alphaMode = MaterialData::AlphaMode::Mask;
+		material.doubleSided = true;
+		model.materials.push_back(material);
+
+		MeshData mesh;
+		mesh.name = "Box";
+		mesh.materialIndex = 0;
+		for (int i = 0; i < 5; ++i)
+		{
+			const float f = static_cast<float>(i);
+			mesh.vertices.push_back({ glm::vec3(f, -f, 2.0f * f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(f * 0.25f, 1.0f) });
+			mesh.boundsMin = glm::min(mesh.boundsMin, mesh.vertices.back().position);
+			mesh.boundsMax = glm::max(mesh.boundsMax, mesh.vertices.back().position);
+		}
+		mesh.indices = { 0, 1, 2, 2, 3, 4, 0, 2, 4 };
+		mesh.lods.push_back({ { 0, 2, 4 }, 0.125f });
+		Meshlet meshlet;
+		meshlet.center = glm::vec3(2.0f, -2.0f, 4.0f);
+		meshlet.radius = 5.0f;
+		meshlet.indexCount = 9;
+		meshlet.vertexCount = 5;
+		mesh.meshlets.push_back(meshlet);
+		model.meshes.push_back(mesh);
+		model.meshes.push_back(MeshData{ "Empty" });
+		return model;
+	}
+
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+}
+
+TEST(MeshCache, RoundTripsModelData)
+{
+	const std::string path = TempPath("nb_meshcache_roundtrip.nbmesh");
+	const ModelData model = MakeModel();
+	ASSERT_TRUE(WriteCookedModel(path, model, 42, "/assets/crate/"));
+
+	// Texture paths follow the source's directory, not the one it was cooked in
+	auto cooked = ReadCookedModel(path, 42, "/moved/crate/");
+	ASSERT_NE(cooked, nullptr);
+	EXPECT_EQ(cooked->name, "Crate");
+	ASSERT_EQ(cooked->materials.size(), 1u);
+	EXPECT_EQ(cooked->materials[0].baseColorTexturePath, "/moved/crate/textures/wood.png");
+	EXPECT_TRUE(cooked->materials[0].normalTexturePath.empty());
+	EXPECT_EQ(cooked->materials[0].alphaMode, MaterialData::AlphaMode::Mask);
+	EXPECT_TRUE(cooked->materials[0].doubleSided);
+	EXPECT_EQ(cooked->materials[0].baseColorFactor, model.materials[0].baseColorFactor);
+
+	ASSERT_EQ(cooked->meshes.size(), 2u);
+	const MeshData& mesh = cooked->meshes[0];
+	EXPECT_EQ(mesh.name, "Box");
+	EXPECT_EQ(mesh.materialIndex, 0);
+	EXPECT_EQ(mesh.boundsMin, model.meshes[0].boundsMin);
+	EXPECT_EQ(mesh.boundsMax, model.meshes[0].boundsMax);
+	ASSERT_EQ(mesh.vertices.size(), 5u);
+	EXPECT_EQ(0, std::memcmp(mesh.vertices.data(), model.meshes[0].vertices.data(), 5 * sizeof(VertexPNT)));
+	EXPECT_EQ(mesh.indices, model.meshes[0].indices);
+	ASSERT_EQ(mesh.lods.size(), 1u);
+	EXPECT_EQ(mesh.lods[0].indices, model.meshes[0].lods[0].indices);
+	EXPECT_EQ(mesh.lods[0].error, 0.125f);
+	ASSERT_EQ(mesh.meshlets.size(), 1u);
+	EXPECT_EQ(0, std::memcmp(mesh.meshlets.data(), model.meshes[0].meshlets.data(), sizeof(Meshlet)));
+	EXPECT_TRUE(cooked->meshes[1].vertices.empty());
+	EXPECT_EQ(cooked->totalVertices, 5u);
+	EXPECT_EQ(cooked->totalIndices, 9u);
+
+	std::filesystem::remove(path);
+}
+
+TEST(MeshCache, RejectsStaleAndTruncatedFiles)
+{
+	const std::string path = TempPath("nb_meshcache_stale.nbmesh");
+	ASSERT_TRUE(WriteCookedModel(path, MakeModel(), 7, ""));
+
+	EXPECT_EQ(ReadCookedModel(path, 8, ""), nullptr);   // source changed
+	EXPECT_NE(ReadCookedModel(path, 7, ""), nullptr);
+
+	const auto size = std::filesystem::file_size(path);
+	std::filesystem::resize_file(path, size - 4);
+	EXPECT_EQ(ReadCookedModel(path, 7, ""), nullptr);
+
+	EXPECT_EQ(ReadCookedModel(TempPath("nb_meshcache_missing.nbmesh"), 7, ""), nullptr);
+	std::filesystem::remove(path);
+}
+
+TEST(MeshCache, RejectsMeshletsOutsideTheIndexList)
+{
+	const std::string path = TempPath("nb_meshcache_meshlets.nbmesh");
+	ModelData model = MakeModel();
+	model.meshes[0].meshlets[0].firstIndex = 3;   // 3 + 9 > 9 indices
+	ASSERT_TRUE(WriteCookedModel(path, model, 7, ""));
+
+	EXPECT_EQ(ReadCookedModel(path, 7, ""), nullptr);
+	std::filesystem::remove(path);
+}
+
+TEST(MeshCache, CookedPathIsKeyedBySourceHash)
+{
+	const std::string a = GetCookedModelPath("cache", "assets/ToyCar.glb", 0x1234);
+	const std::string b = GetCookedModelPath("cache", "assets/ToyCar.glb", 0x5678);
+	EXPECT_NE(a, b);
+	EXPECT_EQ(std::filesystem::path(a).filename().string(), "ToyCar_0000000000001234.nbmesh");
+	EXPECT_EQ(GetCookedModelPath("", "assets/ToyCar.glb", 0x1234), "assets/ToyCar.glb.nbmesh");
+}
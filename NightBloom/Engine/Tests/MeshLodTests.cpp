@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+// MeshLodTests.cpp
+//
+// Unit tests for quadric mesh simplification, LOD chains and LOD selection
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/MeshLod.hpp"
+#include <set>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<uint32_t> indices;
+	};
+
+	// Closed unit sphere: rings x segments, longitude wraps onto shared vertices
+	TestMesh Sphere(uint32_t rings, uint32_t segments)
+	{
+		TestMesh mesh;
+		mesh.positions.push_back(glm::vec3(0.0f, 1.0f, 0.0f));
+		for (uint32_t r = 1; r < rings; ++r)
+		{
+			const float theta = 3.14159265f * static_cast<float>(r) / static_cast<float>(rings);
+			for (uint32_t s = 0; s < segments; ++s)
+			{
+				const float phi = 6.2831853f * static_cast<float>(s) / static_cast<float>(segments);
+				mesh.positions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+			}
+		}
+		const uint32_t south = static_cast<uint32_t>(mesh.positions.size());
+		mesh.positions.push_back(glm::vec3(0.0f, -1.0f, 0.0f));
+
+		auto ring = [segments](uint32_t r, uint32_t s) { return 1 + (r - 1) * segments + s % segments; };
+		for (uint32_t s = 0; s < segments; ++s)
+		{
+			mesh.indices.insert(mesh.indices.end(), { 0u, ring(1, s + 1), ring(1, s) });
+			mesh.indices.insert(mesh.indices.end(), { south, ring(rings - 1, s), ring(rings - 1, s + 1) });
+		}
+		for (uint32_t r = 1; r + 1 < rings; ++r)
+		{
+			for (uint32_t s = 0; s < segments; ++s)
+			{
+				mesh.indices.insert(mesh.indices.end(), { ring(r, s), ring(r, s + 1), ring(r + 1, s) });
+				mesh.indices.insert(mesh.indices.end(), { ring(r, s + 1), ring(r + 1, s + 1), ring(r + 1, s) });
+			}
+		}
+		return mesh;
+	}
+
+	// Flat size x size quad grid on y = 0, open on all four sides
+	TestMesh Grid(uint32_t size)
+	{
+		TestMesh mesh;
+		for (uint32_t z = 0; z <= size; ++z)
+			for (uint32_t x = 0; x <= size; ++x)
+				mesh.positions.push_back(glm::vec3(static_cast<float>(x), 0.0f, static_cast<float>(z)));
+
+		for (uint32_t z = 0; z < size; ++z)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				const uint32_t i = z * (size + 1) + x;
+				mesh.indices.insert(mesh.indices.end(), { i, i + size + 1, i + 1 });
+				mesh.indices.insert(mesh.indices.end(), { i + 1, i + size + 1, i + size + 2 });
+			}
+		}
+		return mesh;
+	}
+
+	std::vector<uint32_t> Simplify(const TestMesh& mesh, size_t targetIndexCount, float* error)
+	{
+		return SimplifyMesh(mesh.positions.data(), mesh.positions.size(), sizeof(glm::vec3),
+			mesh.indices.data(), mesh.indices.size(), targetIndexCount, error);
+	}
+}
+
+TEST(MeshLod, SimplifiedSphereKeepsShapeAndWinding)
+{
+	const TestMesh sphere = Sphere(32, 64);
+	float error = -1.0f;
+	const std::vector<uint32_t> lod = Simplify(sphere, sphere.indices.size() / 4 / 3 * 3, &error);
+
+	ASSERT_EQ(lod.size() % 3, 0u);
+	EXPECT_LE(lod.size(), sphere.indices.size() / 4 + 6);
+	EXPECT_GT(lod.size(), sphere.indices.size() / 8);
+	EXPECT_GT(error, 0.0f);
+	EXPECT_LT(error, 0.1f);
+
+	// Every triangle still faces outward (the test sphere winds outward)
+	for (size_t t = 0; t < lod.size(); t += 3)
+	{
+		ASSERT_LT(lod[t], sphere.positions.size());
+		const glm::vec3 a = sphere.positions[lod[t]], b = sphere.positions[lod[t + 1]], c = sphere.positions[lod[t + 2]];
+		EXPECT_GT(glm::dot(glm::cross(b - a, c - a), a + b + c), 0.0f) << "triangle " << t / 3;
+	}
+}
+
+TEST(MeshLod, FlatGridCollapsesWithoutErrorAndKeepsBorder)
+{
+	const TestMesh grid = Grid(16);
+	float error = -1.0f;
+	const std::vector<uint32_t> lod = Simplify(grid, grid.indices.size() / 8 / 3 * 3, &error);
+
+	EXPECT_LT(lod.size(), grid.indices.size() / 4);
+	EXPECT_FLOAT_EQ(error, 0.0f);
+
+	// Border vertices are locked, so the outline survives
+	const std::set<uint32_t> used(lod.begin(), lod.end());
+	for (uint32_t i = 0; i <= 16; ++i)
+	{
+		EXPECT_TRUE(used.count(i)) << "bottom edge " << i;
+		EXPECT_TRUE(used.count(16 * 17 + i)) << "top edge " << i;
+	}
+}
+
+TEST(MeshLod, ChainShrinksWithAscendingError)
+{
+	const TestMesh sphere = Sphere(24, 48);
+	std::vector<MeshLodLevel> levels;
+	GenerateMeshLods(sphere.positions.data(), sphere.positions.size(), sizeof(glm::vec3), sphere.indices.data(), sphere.indices.size(), levels);
+
+	ASSERT_EQ(levels.size(), 3u);
+	size_t previousCount = sphere.indices.size();
+	float previousError = 0.0f;
+	for (const MeshLodLevel& level : levels)
+	{
+		EXPECT_LE(level.indices.size(), previousCount * 6 / 10);
+		EXPECT_GE(level.error, previousError);
+		previousCount = level.indices.size();
+		previousError = level.error;
+	}
+
+	// Too small to bother with
+	std::vector<MeshLodLevel> none;
+	const TestMesh tiny = Grid(4);
+	GenerateMeshLods(tiny.positions.data(), tiny.positions.size(), sizeof(glm::vec3), tiny.indices.data(), tiny.indices.size(), none);
+	EXPECT_TRUE(none.empty());
+}
+
+TEST(MeshLod, SelectionCoarsensWithDistance)
+{
+	const float errors[] = { 0.0f, 0.01f, 0.05f, 0.2f };
+	const float pixelsPerUnitAtOne = 1000.0f;   // e.g. 1080p at ~57 degrees vertical FOV
+
+	EXPECT_EQ(SelectMeshLod(errors, 4, pixelsPerUnitAtOne / 1.0f, 1.0f), 0u);
+	EXPECT_EQ(SelectMeshLod(errors, 4, pixelsPerUnitAtOne / 20.0f, 1.0f), 1u);
+	EXPECT_EQ(SelectMeshLod(errors, 4, pixelsPerUnitAtOne / 100.0f, 1.0f), 2u);
+	EXPECT_EQ(SelectMeshLod(errors, 4, pixelsPerUnitAtOne / 1000.0f, 1.0f), 3u);
+	EXPECT_EQ(SelectMeshLod(errors, 1, 0.0f, 1.0f), 0u);
+}
@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+// MeshOptimizerTests.cpp
+//
+// Unit tests for import-time vertex cache, overdraw and fetch optimisation
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/MeshOptimizer.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec2 uv;
+	};
+
+	// size x size quad grid, triangles shuffled (the worst case for the cache)
+	void ShuffledGrid(uint32_t size, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		for (uint32_t z = 0; z <= size; ++z)
+			for (uint32_t x = 0; x <= size; ++x)
+				vertices.push_back({ glm::vec3(static_cast<float>(x), 0.0f, static_cast<float>(z)), glm::vec2(0.0f) });
+
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (uint32_t z = 0; z < size; ++z)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				const uint32_t i = z * (size + 1) + x;
+				triangles.push_back({ i, i + size + 1, i + 1 });
+				triangles.push_back({ i + 1, i + size + 1, i + size + 2 });
+			}
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(7));
+		for (const auto& triangle : triangles)
+			indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+
+	// Triangles as sorted position triples, to compare meshes across reindexing
+	std::vector<std::array<float, 9>> TriangleSet(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		std::vector<std::array<float, 9>> set;
+		for (size_t t = 0; t < indices.size(); t += 3)
+		{
+			std::array<float, 9> triangle;
+			for (size_t k = 0; k < 3; ++k)
+			{
+				const glm::vec3& p = vertices[indices[t + k]].position;
+				triangle[k * 3] = p.x; triangle[k * 3 + 1] = p.y; triangle[k * 3 + 2] = p.z;
+			}
+			set.push_back(triangle);
+		}
+		std::sort(set.begin(), set.end());
+		return set;
+	}
+}
+
+TEST(MeshOptimizer, DuplicateVerticesMerge)
+{
+	// Unindexed quad grid: every triangle corner its own vertex
+	std::vector<Vertex> grid;
+	std::vector<uint32_t> gridIndices;
+	ShuffledGrid(8, grid, gridIndices);
+
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	for (uint32_t index : gridIndices)
+	{
+		indices.push_back(static_cast<uint32_t>(vertices.size()));
+		vertices.push_back(grid[index]);
+	}
+	const auto expected = TriangleSet(vertices, indices);
+
+	const size_t count = RemoveDuplicateVertices(vertices.data(), vertices.size(), sizeof(Vertex), indices.data(), indices.size());
+	EXPECT_EQ(count, 9u * 9u);
+	vertices.resize(count);
+	EXPECT_EQ(TriangleSet(vertices, indices), expected);
+}
+
+TEST(MeshOptimizer, VertexCacheOrderCutsShading)
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	ShuffledGrid(48, vertices, indices);
+	const auto expected = TriangleSet(vertices, indices);
+
+	const VertexCacheStats before = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	const VertexCacheStats after = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	EXPECT_GT(before.acmr, 2.5f);
+	EXPECT_LT(after.acmr, 0.85f);
+	EXPECT_LT(after.shadedVertices, before.shadedVertices / 3);
+	EXPECT_EQ(TriangleSet(vertices, indices), expected);
+}
+
+TEST(MeshOptimizer, OverdrawOrderStaysWithinCacheThreshold)
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	ShuffledGrid(48, vertices, indices);
+	// Fold the grid into a ridge so clusters face different ways
+	for (Vertex& v : vertices)
+		v.position.y = 24.0f - std::abs(v.position.x - 24.0f);
+	const auto expected = TriangleSet(vertices, indices);
+
+	OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	const float cached = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()).acmr;
+	OptimizeOverdraw(indices.data(), indices.size(), &vertices.data()->position, vertices.size(), sizeof(Vertex), 1.05f);
+
+	EXPECT_LE(AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()).acmr, cached * 1.05f + 1e-4f);
+	EXPECT_EQ(TriangleSet(vertices, indices), expected);
+}
+
+TEST(MeshOptimizer, FetchOrderFollowsFirstUse)
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	ShuffledGrid(32, vertices, indices);
+	vertices.push_back({ glm::vec3(-1.0f), glm::vec2(0.0f) });   // unreferenced
+	OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	// Scatter the vertex buffer the way exporters leave it
+	std::vector<uint32_t> permutation(vertices.size());
+	std::iota(permutation.begin(), permutation.end(), 0u);
+	std::shuffle(permutation.begin(), permutation.end(), std::mt19937(11));
+	std::vector<Vertex> scattered(vertices.size());
+	for (size_t v = 0; v < vertices.size(); ++v)
+		scattered[permutation[v]] = vertices[v];
+	vertices = scattered;
+	for (uint32_t& index : indices)
+		index = permutation[index];
+	const auto expected = TriangleSet(vertices, indices);
+	const float overfetchBefore = AnalyzeVertexFetch(indices.data(), indices.size(), vertices.size(), sizeof(Vertex)).overfetch;
+
+	const size_t count = OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(Vertex), indices.data(), indices.size());
+	EXPECT_EQ(count, 33u * 33u);
+	vertices.resize(count);
+	EXPECT_EQ(TriangleSet(vertices, indices), expected);
+
+	uint32_t next = 0;
+	for (uint32_t index : indices)
+	{
+		ASSERT_LE(index, next);
+		if (index == next) ++next;
+	}
+	const float overfetchAfter = AnalyzeVertexFetch(indices.data(), indices.size(), vertices.size(), sizeof(Vertex)).overfetch;
+	EXPECT_LT(overfetchAfter, overfetchBefore * 0.5f);
+	EXPECT_LT(overfetchAfter, 2.0f);
+}
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+// MeshletTests.cpp
+//
+// Unit tests for meshlet building, bounds and normal-cone culling
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Meshlet.hpp"
+#include <cmath>
+#include <set>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<uint32_t> indices;
+	};
+
+	// size x size quads on the XZ plane, facing +Y (counter-clockwise from above)
+	TestMesh Grid(uint32_t size)
+	{
+		TestMesh mesh;
+		for (uint32_t z = 0; z <= size; ++z)
+			for (uint32_t x = 0; x <= size; ++x)
+				mesh.positions.push_back(glm::vec3(static_cast<float>(x), 0.0f, static_cast<float>(z)));
+
+		auto at = [size](uint32_t x, uint32_t z) { return z * (size + 1) + x; };
+		for (uint32_t z = 0; z < size; ++z)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				mesh.indices.insert(mesh.indices.end(), { at(x, z), at(x, z + 1), at(x + 1, z) });
+				mesh.indices.insert(mesh.indices.end(), { at(x + 1, z), at(x, z + 1), at(x + 1, z + 1) });
+			}
+		}
+		return mesh;
+	}
+
+	// Closed unit sphere with outward counter-clockwise faces
+	TestMesh Sphere(uint32_t rings, uint32_t segments)
+	{
+		TestMesh mesh;
+		for (uint32_t r = 0; r <= rings; ++r)
+		{
+			const float theta = 3.14159265f * static_cast<float>(r) / static_cast<float>(rings);
+			for (uint32_t s = 0; s <= segments; ++s)
+			{
+				const float phi = 6.2831853f * static_cast<float>(s) / static_cast<float>(segments);
+				mesh.positions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+			}
+		}
+
+		auto at = [segments](uint32_t r, uint32_t s) { return r * (segments + 1) + s; };
+		for (uint32_t r = 0; r < rings; ++r)
+		{
+			for (uint32_t s = 0; s < segments; ++s)
+			{
+				mesh.indices.insert(mesh.indices.end(), { at(r, s), at(r, s + 1), at(r + 1, s) });
+				mesh.indices.insert(mesh.indices.end(), { at(r, s + 1), at(r + 1, s + 1), at(r + 1, s) });
+			}
+		}
+		return mesh;
+	}
+
+	bool TriangleBackfacing(const TestMesh& mesh, const uint32_t* tri, const glm::vec3& camera)
+	{
+		const glm::vec3& a = mesh.positions[tri[0]];
+		const glm::vec3 n = glm::cross(mesh.positions[tri[1]] - a, mesh.positions[tri[2]] - a);
+		return glm::dot(n, a - camera) >= 0.0f;
+	}
+}
+
+TEST(MeshletTest, CoversTheIndexListInOrderWithinLimits)
+{
+	const TestMesh grid = Grid(40);
+	MeshletSettings settings;
+	const std::vector<Meshlet> meshlets = BuildMeshlets(grid.positions.data(), grid.positions.size(), sizeof(glm::vec3),
+		grid.indices.data(), grid.indices.size(), settings);
+	ASSERT_GT(meshlets.size(), 1u);
+
+	uint32_t next = 0;
+	for (const Meshlet& meshlet : meshlets)
+	{
+		EXPECT_EQ(meshlet.firstIndex, next);
+		EXPECT_EQ(meshlet.indexCount % 3, 0u);
+		EXPECT_LE(meshlet.indexCount / 3, settings.maxTriangles);
+
+		std::set<uint32_t> vertices(grid.indices.begin() + meshlet.firstIndex,
+			grid.indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+		EXPECT_EQ(meshlet.vertexCount, vertices.size());
+		EXPECT_LE(meshlet.vertexCount, settings.maxVertices);
+		next += meshlet.indexCount;
+	}
+	EXPECT_EQ(next, grid.indices.size());
+}
+
+TEST(MeshletTest, SmallMeshesGetNoMeshlets)
+{
+	const TestMesh grid = Grid(8);
+	EXPECT_TRUE(BuildMeshlets(grid.positions.data(), grid.positions.size(), sizeof(glm::vec3),
+		grid.indices.data(), grid.indices.size()).empty());
+}
+
+TEST(MeshletTest, SphereBoundsContainEveryVertex)
+{
+	const TestMesh sphere = Sphere(32, 64);
+	const std::vector<Meshlet> meshlets = BuildMeshlets(sphere.positions.data(), sphere.positions.size(),
+		sizeof(glm::vec3), sphere.indices.data(), sphere.indices.size());
+	ASSERT_FALSE(meshlets.empty());
+
+	for (const Meshlet& meshlet : meshlets)
+	{
+		for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+		{
+			const glm::vec3& p = sphere.positions[sphere.indices[meshlet.firstIndex + i]];
+			EXPECT_LE(glm::length(p - meshlet.center), meshlet.radius * 1.0001f + 1e-6f);
+		}
+	}
+}
+
+TEST(MeshletTest, FlatPatchIsCulledFromBehindOnly)
+{
+	const TestMesh grid = Grid(40);
+	const std::vector<Meshlet> meshlets = BuildMeshlets(grid.positions.data(), grid.positions.size(), sizeof(glm::vec3),
+		grid.indices.data(), grid.indices.size());
+	ASSERT_FALSE(meshlets.empty());
+
+	for (const Meshlet& meshlet : meshlets)
+	{
+		EXPECT_NEAR(meshlet.coneAxis.y, 1.0f, 1e-5f);
+		EXPECT_LT(meshlet.coneCutoff, 1.0f);
+		EXPECT_TRUE(MeshletBackfacing(meshlet, meshlet.center - glm::vec3(0.0f, 50.0f, 0.0f)));
+		EXPECT_FALSE(MeshletBackfacing(meshlet, meshlet.center + glm::vec3(0.0f, 50.0f, 0.0f)));
+	}
+}
+
+TEST(MeshletTest, ConeCullingIsConservative)
+{
+	const TestMesh sphere = Sphere(32, 64);
+	const std::vector<Meshlet> meshlets = BuildMeshlets(sphere.positions.data(), sphere.positions.size(),
+		sizeof(glm::vec3), sphere.indices.data(), sphere.indices.size());
+	ASSERT_FALSE(meshlets.empty());
+
+	const glm::vec3 cameras[] = { glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(3.0f, 2.0f, -1.5f), glm::vec3(0.0f, -8.0f, 0.0f) };
+	for (const glm::vec3& camera : cameras)
+	{
+		uint32_t culled = 0;
+		for (const Meshlet& meshlet : meshlets)
+		{
+			if (!MeshletBackfacing(meshlet, camera))
+				continue;
+			++culled;
+			for (uint32_t t = 0; t < meshlet.indexCount; t += 3)
+				EXPECT_TRUE(TriangleBackfacing(sphere, &sphere.indices[meshlet.firstIndex + t], camera));
+		}
+		// The far side of the sphere faces away; ring-order strips have wide
+		// cones, but the ones near the far pole are still caught
+		EXPECT_GT(culled, 0u);
+	}
+}
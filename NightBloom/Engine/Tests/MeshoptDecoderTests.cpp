@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+// MeshoptDecoderTests.cpp
+//
+// Unit tests for EXT_meshopt_compression decoding, on hand-assembled streams
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/MeshoptDecoder.hpp"
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace Nightbloom;
+
+TEST(MeshoptDecoderTest, VertexStreamUndoesDeltasAndEscapes)
+{
+	// Two 4-byte vertices, {1,2,3,4} then {3,2,1,4}
+	std::vector<uint8_t> stream = { 0xa0 };
+	// Byte 0: deltas 0, +2 (zigzag 4) at 4 bits per value
+	stream.insert(stream.end(), { 0x02, 0x04, 0, 0, 0, 0, 0, 0, 0 });
+	// Byte 1: no change, an all-zero group with no data
+	stream.insert(stream.end(), { 0x00 });
+	// Byte 2: deltas 0, -2 (zigzag 3) at 2 bits, where 3 escapes to a full byte
+	stream.insert(stream.end(), { 0x01, 0x30, 0, 0, 0, 0x03 });
+	// Byte 3: no change
+	stream.insert(stream.end(), { 0x00 });
+	// Tail: the first vertex, padded to 32 bytes
+	stream.insert(stream.end(), 28, 0);
+	stream.insert(stream.end(), { 1, 2, 3, 4 });
+
+	std::array<uint8_t, 8> vertices{};
+	ASSERT_TRUE(DecodeMeshoptBuffer(vertices.data(), 2, 4, stream.data(), stream.size(),
+		MeshoptMode::Attributes, MeshoptFilter::None));
+	EXPECT_EQ(vertices, (std::array<uint8_t, 8>{ 1, 2, 3, 4, 3, 2, 1, 4 }));
+
+	// Truncated: the escape byte is missing
+	std::vector<uint8_t> truncated(stream.begin(), stream.begin() + 16);
+	truncated.insert(truncated.end(), stream.end() - 32, stream.end());
+	EXPECT_FALSE(DecodeMeshoptBuffer(vertices.data(), 2, 4, truncated.data(), truncated.size(),
+		MeshoptMode::Attributes, MeshoptFilter::None));
+}
+
+TEST(MeshoptDecoderTest, TriangleStreamFollowsTheFifos)
+{
+	const std::vector<uint8_t> stream = {
+		0xe1,
+		// Codes: three new vertices (table entry 0), the last edge reversed
+		// plus a new vertex, then three free indices
+		0xf0, 0x10, 0xff,
+		// Data: codeaux for 0xff, then free indices 7, 8, 9 as zigzag deltas
+		0xff, 0x0e, 0x02, 0x02,
+		// Codeaux table
+		0x00, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+	std::array<uint32_t, 9> indices{};
+	ASSERT_TRUE(DecodeMeshoptBuffer(indices.data(), 9, 4, stream.data(), stream.size(),
+		MeshoptMode::Triangles, MeshoptFilter::None));
+	EXPECT_EQ(indices, (std::array<uint32_t, 9>{ 0, 1, 2, 2, 1, 3, 7, 8, 9 }));
+
+	std::array<uint16_t, 9> shortIndices{};
+	ASSERT_TRUE(DecodeMeshoptBuffer(shortIndices.data(), 9, 2, stream.data(), stream.size(),
+		MeshoptMode::Triangles, MeshoptFilter::None));
+	EXPECT_EQ(shortIndices[5], 3);
+
+	// Not a whole number of triangles
+	EXPECT_FALSE(DecodeMeshoptBuffer(indices.data(), 8, 4, stream.data(), stream.size(),
+		MeshoptMode::Triangles, MeshoptFilter::None));
+}
+
+TEST(MeshoptDecoderTest, IndexSequenceKeepsTwoBases)
+{
+	const std::vector<uint8_t> stream = {
+		0xd1,
+		// +0, +1, +1 and +3 against base 0, then +300 against base 1 (two-byte varint)
+		0x00, 0x04, 0x04, 0x0c, 0xb1, 0x09,
+		0, 0, 0, 0 };
+
+	std::array<uint32_t, 5> indices{};
+	ASSERT_TRUE(DecodeMeshoptBuffer(indices.data(), 5, 4, stream.data(), stream.size(),
+		MeshoptMode::Indices, MeshoptFilter::None));
+	EXPECT_EQ(indices, (std::array<uint32_t, 5>{ 0, 1, 2, 5, 300 }));
+
+	// Asking for more indices than the stream holds
+	std::array<uint32_t, 6> more{};
+	EXPECT_FALSE(DecodeMeshoptBuffer(more.data(), 6, 4, stream.data(), stream.size(),
+		MeshoptMode::Indices, MeshoptFilter::None));
+}
+
+TEST(MeshoptDecoderTest, FiltersRebuildNormalsAndFloats)
+{
+	// Octahedral: +x, and +z (xy zero, z holds the scale)
+	std::array<int8_t, 8> normals = { 127, 0, 127, 5, 0, 0, 127, 7 };
+	ApplyMeshoptFilter(normals.data(), 2, 4, MeshoptFilter::Octahedral);
+	EXPECT_EQ(normals, (std::array<int8_t, 8>{ 127, 0, 0, 5, 0, 0, 127, 7 }));
+
+	// Exponential: 3 * 2^-1
+	uint32_t packed = 0xff000003u;
+	ApplyMeshoptFilter(&packed, 1, 4, MeshoptFilter::Exponential);
+	float value = 0.0f;
+	std::memcpy(&value, &packed, sizeof(value));
+	EXPECT_FLOAT_EQ(value, 1.5f);
+
+	// Quaternion: identity with w dropped (index 3), x, y, z all zero
+	std::array<int16_t, 4> rotation = { 0, 0, 0, static_cast<int16_t>((0x7ff << 2) | 3) };
+	ApplyMeshoptFilter(rotation.data(), 1, 8, MeshoptFilter::Quaternion);
+	EXPECT_EQ(rotation, (std::array<int16_t, 4>{ 0, 0, 0, 32767 }));
+}
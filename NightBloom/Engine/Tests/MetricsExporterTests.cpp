@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// MetricsExporterTests.cpp
+//
+// Unit tests for the runtime metrics exporter
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/MetricsExporter.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace Nightbloom;
+
+namespace
+{
+	MetricsFrame Frame(float frameMs, std::vector<MetricsFrame::Pass> passes = {})
+	{
+		MetricsFrame frame;
+		frame.frameMs = frameMs;
+		frame.gpuMs = frameMs * 0.5f;
+		frame.uploadBytes = 1024 * 1024;
+		frame.memoryUsage = 512ull << 20;
+		frame.memoryBudget = 2048ull << 20;
+		frame.passes = std::move(passes);
+		return frame;
+	}
+}
+
+TEST(MetricsExporter, SummarizesAnInterval)
+{
+	std::vector<MetricsFrame> frames;
+	for (int i = 1; i <= 100; ++i)
+		frames.push_back(Frame(static_cast<float>(i), i % 2 ? std::vector<MetricsFrame::Pass>{ { "Shadows", 2.0f } }
+			: std::vector<MetricsFrame::Pass>{}));
+	frames.back().passes.push_back({ "Clouds", 4.0f });
+
+	const MetricsSnapshot s = MetricsExporter::Summarize(frames, 2.0f, 1000.0);
+	EXPECT_EQ(s.frames, 100u);
+	EXPECT_FLOAT_EQ(s.fps, 50.0f);
+	EXPECT_FLOAT_EQ(s.frameP50, 50.0f);
+	EXPECT_FLOAT_EQ(s.frameP95, 95.0f);
+	EXPECT_FLOAT_EQ(s.frameMax, 100.0f);
+	EXPECT_FLOAT_EQ(s.gpuP95, 47.5f);
+	EXPECT_EQ(s.memoryBudget, 2048ull << 20);
+	EXPECT_FLOAT_EQ(s.uploadBytesPerSecond, 50.0f * 1024 * 1024);
+	ASSERT_EQ(s.passes.size(), 2u);
+	EXPECT_EQ(s.passes[0].name, "Shadows");
+	EXPECT_EQ(s.passes[0].samples, 50u);
+	EXPECT_EQ(s.passes[1].name, "Clouds");
+	EXPECT_FLOAT_EQ(s.passes[1].p95, 4.0f);
+
+	EXPECT_EQ(MetricsExporter::Summarize({}, 1.0f, 0.0).frames, 0u);
+}
+
+TEST(MetricsExporter, FormatsCsvRowsAndStatsdGauges)
+{
+	const MetricsSnapshot s = MetricsExporter::Summarize({ Frame(16.0f, { { "GBuffer Pass", 3.0f } }) }, 1.0f, 12.5);
+
+	const std::string csv = MetricsExporter::FormatCsv(s, "node 7");
+	EXPECT_EQ(csv.rfind("12.500,node_7,frame.fps,1\n", 0), 0u);
+	EXPECT_NE(csv.find("12.500,node_7,memory.budget_fraction,0.25\n"), std::string::npos);
+	EXPECT_NE(csv.find("12.500,node_7,gpu.pass.GBuffer_Pass.p95,3\n"), std::string::npos);
+
+	const std::vector<std::string> one = MetricsExporter::FormatStatsd(s, "fleet.render", "", 4096);
+	ASSERT_EQ(one.size(), 1u);
+	EXPECT_EQ(one[0].rfind("fleet.render.default.frame.fps:1|g\n", 0), 0u);
+	EXPECT_NE(one[0].find("fleet.render.default.frame.p95:16|g"), std::string::npos);
+
+	// Small datagrams split at line ends
+	const std::vector<std::string> many = MetricsExporter::FormatStatsd(s, "nb", "a", 64);
+	EXPECT_GT(many.size(), 1u);
+	size_t lines = 0;
+	for (const std::string& datagram : many)
+	{
+		EXPECT_LE(datagram.size(), 64u);
+		EXPECT_NE(datagram.back(), '\n');
+		lines += std::count(datagram.begin(), datagram.end(), '\n') + 1;
+	}
+	EXPECT_EQ(lines, static_cast<size_t>(std::count(one[0].begin(), one[0].end(), '\n') + 1));
+}
+
+TEST(MetricsExporter, AppendsToACsvFileFromItsThread)
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "nightbloom_metrics.csv").string();
+	std::filesystem::remove(path);
+
+	MetricsExporter exporter;
+	MetricsExportSettings settings;
+	EXPECT_FALSE(exporter.Start(settings));   // no sink
+	settings.csvPath = path;
+	settings.interval = std::chrono::milliseconds(50);
+	EXPECT_FALSE(exporter.Start(settings));   // too short
+	settings.interval = std::chrono::milliseconds(100);
+	ASSERT_TRUE(exporter.Start(settings));
+
+	exporter.Record(Frame(10.0f));
+	exporter.Record(Frame(20.0f));
+	exporter.Stop();   // exports what's pending
+	EXPECT_GE(exporter.GetExportCount(), 1u);
+	EXPECT_TRUE(exporter.GetLastError().empty());
+	exporter.Record(Frame(30.0f));   // stopped: dropped
+
+	std::ifstream file(path);
+	std::stringstream text;
+	text << file.rdbuf();
+	EXPECT_EQ(text.str().rfind(MetricsExporter::FormatCsvHeader(), 0), 0u);
+	EXPECT_NE(text.str().find(",default,frame.max,20\n"), std::string::npos);
+
+	std::filesystem::remove(path);
+}
+
+TEST(MetricsExporter, ParsesStatsdEndpoints)
+{
+	std::string host;
+	uint16_t port = 8125;
+	ASSERT_TRUE(MetricsExporter::ParseEndpoint("metrics.local", host, port));
+	EXPECT_EQ(host, "metrics.local");
+	EXPECT_EQ(port, 8125);
+	ASSERT_TRUE(MetricsExporter::ParseEndpoint("10.0.0.2:9125", host, port));
+	EXPECT_EQ(host, "10.0.0.2");
+	EXPECT_EQ(port, 9125);
+	ASSERT_TRUE(MetricsExporter::ParseEndpoint("[::1]:8200", host, port));
+	EXPECT_EQ(host, "::1");
+	EXPECT_EQ(port, 8200);
+	ASSERT_TRUE(MetricsExporter::ParseEndpoint("fe80::1", host, port));
+	EXPECT_EQ(host, "fe80::1");
+
+	EXPECT_FALSE(MetricsExporter::ParseEndpoint("host:0", host, port));
+	EXPECT_FALSE(MetricsExporter::ParseEndpoint("host:70000", host, port));
+	EXPECT_FALSE(MetricsExporter::ParseEndpoint("host:12x", host, port));
+	EXPECT_FALSE(MetricsExporter::ParseEndpoint(":8125", host, port));
+	EXPECT_FALSE(MetricsExporter::ParseEndpoint("[::1", host, port));
+}
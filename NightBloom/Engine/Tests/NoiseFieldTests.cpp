@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// NoiseFieldTests.cpp
+//
+// Unit tests for the CPU noise field (the generator shaders' FBM)
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/NoiseField.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace Nightbloom;
+
+namespace
+{
+	NoiseTextureDesc MakeDesc(NoiseType type, uint32_t seed = 42)
+	{
+		NoiseTextureDesc desc;
+		desc.noiseType = type;
+		desc.seed = seed;
+		return desc;
+	}
+
+	const NoiseType kTypes[] = { NoiseType::Perlin, NoiseType::Worley, NoiseType::PerlinWorley };
+
+	// Points spread over a few lattice cells, negatives included
+	void MakePoints(std::vector<float>& x, std::vector<float>& y, std::vector<float>& z, size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float t = static_cast<float>(i);
+			x[i] = std::sin(t * 1.7f) * 1.3f;
+			y[i] = std::cos(t * 0.9f) * 0.8f + 0.2f;
+			z[i] = std::fmod(t * 0.137f, 1.0f) - 0.4f;
+		}
+	}
+}
+
+// Same operations in the same order (NoiseField.cpp is built without FMA
+// contraction), so the batch and the scalar path agree to the bit
+TEST(NoiseFieldTest, Sample8MatchesSample)
+{
+	std::vector<float> x, y, z;
+	MakePoints(x, y, z, 64);
+
+	for (NoiseType type : kTypes)
+	{
+		const NoiseField field(MakeDesc(type));
+		for (size_t first = 0; first < x.size(); first += NoiseField::BATCH)
+		{
+			float out[NoiseField::BATCH];
+			field.Sample8(&x[first], &y[first], &z[first], out);
+			for (size_t i = 0; i < NoiseField::BATCH; ++i)
+			{
+				const float expected = field.Sample(glm::vec3(x[first + i], y[first + i], z[first + i]));
+				EXPECT_FLOAT_EQ(out[i], expected) << "type " << static_cast<int>(type) << " point " << first + i;
+			}
+		}
+	}
+}
+
+TEST(NoiseFieldTest, ValuesStayInUnitRange)
+{
+	std::vector<float> x, y, z;
+	MakePoints(x, y, z, 256);
+
+	for (NoiseType type : kTypes)
+	{
+		const NoiseField field(MakeDesc(type));
+		float minValue = 1.0f;
+		float maxValue = 0.0f;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			const float value = field.Sample(glm::vec3(x[i], y[i], z[i]));
+			minValue = std::min(minValue, value);
+			maxValue = std::max(maxValue, value);
+		}
+		EXPECT_GE(minValue, 0.0f);
+		EXPECT_LE(maxValue, 1.0f);
+		EXPECT_LT(minValue, maxValue) << "type " << static_cast<int>(type) << " is flat";
+	}
+}
+
+// An integer frequency wraps the lattice at uv 1, like the tiling textures
+TEST(NoiseFieldTest, TilesEveryUnitInNoiseSpace)
+{
+	for (NoiseType type : kTypes)
+	{
+		const NoiseField field(MakeDesc(type));
+		for (float t : { 0.1f, 0.37f, 0.82f })
+		{
+			const glm::vec3 p(t, 1.0f - t, 0.5f * t);
+			EXPECT_NEAR(field.Sample(p), field.Sample(p + glm::vec3(1.0f, 0.0f, 0.0f)), 1e-4f);
+			EXPECT_NEAR(field.Sample(p), field.Sample(p + glm::vec3(0.0f, 1.0f, 1.0f)), 1e-4f);
+		}
+	}
+}
+
+TEST(NoiseFieldTest, SeedMovesTheField)
+{
+	const NoiseField a(MakeDesc(NoiseType::Perlin, 1));
+	const NoiseField b(MakeDesc(NoiseType::Perlin, 2));
+	const glm::vec3 offsetA = a.ToNoiseSpace(glm::vec3(0.0f));
+	const glm::vec3 offsetB = b.ToNoiseSpace(glm::vec3(0.0f));
+	EXPECT_NE(offsetA, offsetB);
+	EXPECT_EQ(offsetA, NoiseField::Hash33(glm::vec3(1.0f, 1.3f, 0.7f)));
+
+	int differing = 0;
+	for (int i = 0; i < 16; ++i)
+	{
+		const float u = static_cast<float>(i) / 16.0f;
+		if (std::abs(a.SampleUV(u, 0.3f) - b.SampleUV(u, 0.3f)) > 1e-3f)
+			++differing;
+	}
+	EXPECT_GT(differing, 8);
+}
+
+// Eleven points: one full batch and a padded tail
+TEST(NoiseFieldTest, SampleUVsMatchesSampleUV)
+{
+	const NoiseField field(MakeDesc(NoiseType::PerlinWorley, 7));
+	std::vector<float> u(11), v(11), out(11, -1.0f);
+	for (size_t i = 0; i < u.size(); ++i)
+	{
+		u[i] = 0.09f * static_cast<float>(i) - 0.3f;
+		v[i] = 0.5f - 0.04f * static_cast<float>(i);
+	}
+
+	field.SampleUVs(u.data(), v.data(), out.data(), out.size());
+	for (size_t i = 0; i < out.size(); ++i)
+		EXPECT_FLOAT_EQ(out[i], field.SampleUV(u[i], v[i])) << "point " << i;
+}
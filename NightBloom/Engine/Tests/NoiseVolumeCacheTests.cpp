@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// NoiseVolumeCacheTests.cpp
+//
+// Unit tests for noise descriptor keys and the on-disk volume format
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/NoiseVolumeCache.hpp"
+#include <filesystem>
+
+using namespace Nightbloom;
+
+namespace
+{
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+}
+
+TEST(NoiseVolumeCacheTest, KeyCoversGenerationParametersOnly)
+{
+	NoiseTextureDesc a;
+	a.debugName = "CloudShape";
+	NoiseTextureDesc b = a;
+	b.debugName = "SomethingElse";
+	EXPECT_EQ(HashNoiseTextureDesc(a), HashNoiseTextureDesc(b));
+
+	b.seed = a.seed + 1;
+	EXPECT_NE(HashNoiseTextureDesc(a), HashNoiseTextureDesc(b));
+
+	b = a;
+	b.frequency = 4.5f;
+	EXPECT_NE(HashNoiseTextureDesc(a), HashNoiseTextureDesc(b));
+
+	b = a;
+	b.noiseType = NoiseType::Worley;
+	EXPECT_NE(HashNoiseTextureDesc(a), HashNoiseTextureDesc(b));
+}
+
+TEST(NoiseVolumeCacheTest, RoundTripsAVolume)
+{
+	const std::string path = TempPath("nb_noise_roundtrip.nbnoise");
+	std::vector<float> values(4 * 3 * 2);
+	for (size_t i = 0; i < values.size(); ++i)
+		values[i] = static_cast<float>(i) * 0.25f;
+
+	ASSERT_TRUE(WriteNoiseVolume(path, 0x1234u, 4, 3, 2, values));
+
+	std::vector<float> loaded;
+	ASSERT_TRUE(ReadNoiseVolume(path, 0x1234u, 4, 3, 2, loaded));
+	EXPECT_EQ(loaded, values);
+
+	// Another key or extent is a miss
+	EXPECT_FALSE(ReadNoiseVolume(path, 0x1235u, 4, 3, 2, loaded));
+	EXPECT_FALSE(ReadNoiseVolume(path, 0x1234u, 4, 3, 3, loaded));
+
+	std::filesystem::remove(path);
+}
+
+TEST(NoiseVolumeCacheTest, RejectsShortFilesAndWrongSizes)
+{
+	const std::string path = TempPath("nb_noise_short.nbnoise");
+	std::vector<float> values(8, 1.0f);
+	EXPECT_FALSE(WriteNoiseVolume(path, 1, 4, 4, 4, values));   // 64 texels expected
+
+	ASSERT_TRUE(WriteNoiseVolume(path, 1, 2, 2, 2, values));
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(float));
+
+	std::vector<float> loaded;
+	EXPECT_FALSE(ReadNoiseVolume(path, 1, 2, 2, 2, loaded));
+	EXPECT_FALSE(ReadNoiseVolume(TempPath("nb_noise_missing.nbnoise"), 1, 2, 2, 2, loaded));
+
+	std::filesystem::remove(path);
+}
+
+TEST(NoiseVolumeCacheTest, PathCarriesTheKey)
+{
+	const std::filesystem::path path = GetNoiseVolumePath("Cache", 0xabcdull);
+	EXPECT_EQ(path.generic_string(), "Cache/noise_000000000000abcd.nbnoise");
+}
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+// NoiseVolumePackingTests.cpp
+//
+// Unit tests for the low-precision noise formats: sizes, mip chains and the
+// packed texels
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/NoiseVolumePacking.hpp"
+#include "../Renderer/NoiseVolumeCache.hpp"
+#include "../Renderer/TextureCompression.hpp"
+#include <cmath>
+
+using namespace Nightbloom;
+
+namespace
+{
+	NoiseTextureDesc MakeDesc(uint32_t size, NoiseTextureFormat format, bool mips)
+	{
+		NoiseTextureDesc desc;
+		desc.width = desc.height = desc.depth = size;
+		desc.format = format;
+		desc.generateMips = mips;
+		return desc;
+	}
+
+	// What the shaders would write: smooth, distinct per channel
+	std::vector<float> MakeVolume(uint32_t size)
+	{
+		std::vector<float> rgba(size_t(size) * size * size * 4);
+		for (uint32_t z = 0; z < size; ++z)
+			for (uint32_t y = 0; y < size; ++y)
+				for (uint32_t x = 0; x < size; ++x)
+				{
+					float* t = &rgba[((size_t(z) * size + y) * size + x) * 4];
+					t[0] = 0.5f + 0.5f * std::sin(x * 0.2f + y * 0.1f + z * 0.15f);
+					t[1] = float(x) / float(size - 1);
+					t[2] = float(y) / float(size - 1);
+					t[3] = float(z) / float(size - 1);
+				}
+		return rgba;
+	}
+}
+
+TEST(NoiseVolumePackingTest, SizesMatchTheFormats)
+{
+	// The default 128^3 cloud volume
+	EXPECT_EQ(GetNoiseTextureBytes(MakeDesc(128, NoiseTextureFormat::RGBA32F, false)), 32u * 1024 * 1024);
+	EXPECT_EQ(GetNoiseTextureBytes(MakeDesc(128, NoiseTextureFormat::RGBA8, false)), 8u * 1024 * 1024);
+	EXPECT_EQ(GetNoiseTextureBytes(MakeDesc(128, NoiseTextureFormat::R8, false)), 2u * 1024 * 1024);
+	EXPECT_EQ(GetNoiseTextureBytes(MakeDesc(128, NoiseTextureFormat::BC4, false)), 1u * 1024 * 1024);
+
+	// BC4 rounds each slice up to whole blocks
+	EXPECT_EQ(GetNoiseLevelBytes(NoiseTextureFormat::BC4, 2, 2, 3), 3u * 8u);
+	EXPECT_FLOAT_EQ(GetNoiseBytesPerTexel(NoiseTextureFormat::RG8), 2.0f);
+}
+
+TEST(NoiseVolumePackingTest, MipChainsCoverEveryAxis)
+{
+	EXPECT_EQ(GetNoiseMipCount(MakeDesc(32, NoiseTextureFormat::R8, false)), 1u);
+	EXPECT_EQ(GetNoiseMipCount(MakeDesc(32, NoiseTextureFormat::R8, true)), 6u);
+
+	// RGBA32F volumes have no 3D chain; 2D ones do
+	EXPECT_EQ(GetNoiseMipCount(MakeDesc(32, NoiseTextureFormat::RGBA32F, true)), 1u);
+	NoiseTextureDesc flat = MakeDesc(32, NoiseTextureFormat::RGBA32F, true);
+	flat.depth = 1;
+	EXPECT_EQ(GetNoiseMipCount(flat), 6u);
+
+	// The longest axis decides
+	NoiseTextureDesc slab = MakeDesc(8, NoiseTextureFormat::RGBA8, true);
+	slab.depth = 32;
+	EXPECT_EQ(GetNoiseMipCount(slab), 6u);
+}
+
+TEST(NoiseVolumePackingTest, PacksEveryLevelAtItsOffset)
+{
+	const uint32_t size = 16;
+	const std::vector<float> volume = MakeVolume(size);
+
+	for (NoiseTextureFormat format : { NoiseTextureFormat::R8, NoiseTextureFormat::RG8,
+		NoiseTextureFormat::RGBA8, NoiseTextureFormat::BC4 })
+	{
+		const NoiseTextureDesc desc = MakeDesc(size, format, true);
+		const PackedNoiseVolume packed = PackNoiseVolume(desc, volume.data());
+
+		ASSERT_EQ(packed.levelOffsets.size(), GetNoiseMipCount(desc));
+		EXPECT_EQ(packed.data.size(), GetNoiseTextureBytes(desc));
+		EXPECT_EQ(packed.levelOffsets[0], 0u);
+		for (size_t l = 1; l < packed.levelOffsets.size(); ++l)
+		{
+			const uint32_t prev = std::max(1u, size >> (l - 1));
+			EXPECT_EQ(packed.levelOffsets[l] - packed.levelOffsets[l - 1], GetNoiseLevelBytes(format, prev, prev, prev));
+		}
+	}
+
+	// RGBA32F is never packed
+	EXPECT_TRUE(PackNoiseVolume(MakeDesc(size, NoiseTextureFormat::RGBA32F, false), volume.data()).data.empty());
+}
+
+TEST(NoiseVolumePackingTest, QuantisesAndFiltersTheChannelsKept)
+{
+	const uint32_t size = 8;
+	const std::vector<float> volume = MakeVolume(size);
+
+	const NoiseTextureDesc desc = MakeDesc(size, NoiseTextureFormat::RGBA8, true);
+	const PackedNoiseVolume packed = PackNoiseVolume(desc, volume.data());
+
+	// Mip 0 is the source rounded to 8 bits, channel for channel
+	for (size_t i = 0; i < volume.size(); ++i)
+		EXPECT_NEAR(packed.data[i] / 255.0f, volume[i], 0.5f / 255.0f + 1e-6f);
+
+	// The last level is the mean of the volume: G ramps 0..1 along x
+	const uint8_t* last = &packed.data[packed.levelOffsets.back()];
+	EXPECT_NEAR(last[1] / 255.0f, 0.5f, 1.0f / 255.0f);
+	EXPECT_NEAR(last[3] / 255.0f, 0.5f, 1.0f / 255.0f);
+}
+
+TEST(NoiseVolumePackingTest, Bc4SlicesDecodeCloseToR8)
+{
+	const uint32_t size = 16;
+	const std::vector<float> volume = MakeVolume(size);
+
+	const PackedNoiseVolume r8 = PackNoiseVolume(MakeDesc(size, NoiseTextureFormat::R8, false), volume.data());
+	const PackedNoiseVolume bc4 = PackNoiseVolume(MakeDesc(size, NoiseTextureFormat::BC4, false), volume.data());
+
+	// Every slice is its own row of blocks
+	const size_t sliceBytes = GetCompressedSize(BlockFormat::BC4, size, size);
+	double squaredError = 0.0;
+	for (uint32_t z = 0; z < size; ++z)
+	{
+		const std::vector<uint8_t> decoded = DecompressImage(BlockFormat::BC4, &bc4.data[z * sliceBytes], size, size);
+		for (size_t i = 0; i < size_t(size) * size; ++i)
+		{
+			const double d = double(decoded[i * 4]) - double(r8.data[z * size * size + i]);
+			squaredError += d * d;
+		}
+	}
+	const double mse = squaredError / double(r8.data.size());
+	EXPECT_GT(10.0 * std::log10(255.0 * 255.0 / std::max(mse, 1e-9)), 38.0);
+}
+
+TEST(NoiseVolumePackingTest, FormatAndLayoutSplitTheCacheKey)
+{
+	NoiseTextureDesc a;
+	NoiseTextureDesc b = a;
+	b.format = NoiseTextureFormat::BC4;
+	EXPECT_NE(HashNoiseTextureDesc(a), HashNoiseTextureDesc(b));
+
+	b = a;
+	b.channels = NoiseChannelLayout::CloudShape;
+	EXPECT_NE(HashNoiseTextureDesc(a), HashNoiseTextureDesc(b));
+}
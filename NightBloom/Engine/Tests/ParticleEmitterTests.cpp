@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// ParticleEmitterTests.cpp
+//
+// Unit tests for the particle pool split, spawn accumulation and the
+// emitter records the simulation reads
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../VFX/ParticleEmitter.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	ParticleEmitterDesc MakeEmitter(uint32_t capacity)
+	{
+		ParticleEmitterDesc desc;
+		desc.capacity = capacity;
+		return desc;
+	}
+}
+
+TEST(ParticleEmitterTest, RangesAreContiguousInEmitterOrder)
+{
+	const std::vector<ParticleEmitterDesc> emitters = { MakeEmitter(100), MakeEmitter(250), MakeEmitter(50) };
+	const std::vector<ParticleRange> ranges = PlanParticleRanges(emitters, 1000);
+
+	ASSERT_EQ(ranges.size(), 3u);
+	EXPECT_EQ(ranges[0].base, 0u);
+	EXPECT_EQ(ranges[0].capacity, 100u);
+	EXPECT_EQ(ranges[1].base, 100u);
+	EXPECT_EQ(ranges[1].capacity, 250u);
+	EXPECT_EQ(ranges[2].base, 350u);
+	EXPECT_EQ(ranges[2].capacity, 50u);
+}
+
+TEST(ParticleEmitterTest, EmittersPastThePoolGetWhatIsLeft)
+{
+	const std::vector<ParticleEmitterDesc> emitters = { MakeEmitter(600), MakeEmitter(600), MakeEmitter(600) };
+	const std::vector<ParticleRange> ranges = PlanParticleRanges(emitters, 1000);
+
+	ASSERT_EQ(ranges.size(), 3u);
+	EXPECT_EQ(ranges[0].capacity, 600u);
+	EXPECT_EQ(ranges[1].base, 600u);
+	EXPECT_EQ(ranges[1].capacity, 400u);
+	EXPECT_EQ(ranges[2].base, 1000u);
+	EXPECT_EQ(ranges[2].capacity, 0u);
+}
+
+TEST(ParticleEmitterTest, SpawnsCarryTheFraction)
+{
+	float accumulator = 0.0f;
+	uint32_t total = 0;
+	for (int frame = 0; frame < 60; ++frame)
+		total += AccumulateSpawns(accumulator, 25.0f, 1.0f / 60.0f, 1000);
+
+	// 25 per second over one second, none lost to rounding
+	EXPECT_NEAR(static_cast<float>(total), 25.0f, 1.0f);
+	EXPECT_GE(accumulator, 0.0f);
+	EXPECT_LT(accumulator, 1.0f);
+}
+
+TEST(ParticleEmitterTest, SpawnsAreCappedAndTheExcessDropped)
+{
+	float accumulator = 0.0f;
+	EXPECT_EQ(AccumulateSpawns(accumulator, 100000.0f, 0.1f, 500), 500u);
+	EXPECT_EQ(accumulator, 0.0f);
+
+	// A hitch isn't paid back on the next frame
+	EXPECT_EQ(AccumulateSpawns(accumulator, 100.0f, 0.05f, 500), 5u);
+
+	// Negative rates and time spawn nothing
+	accumulator = 0.0f;
+	EXPECT_EQ(AccumulateSpawns(accumulator, -10.0f, 1.0f, 500), 0u);
+	EXPECT_EQ(AccumulateSpawns(accumulator, 10.0f, -1.0f, 500), 0u);
+}
+
+TEST(ParticleEmitterTest, PackFollowsTheCameraAndClampsSpawns)
+{
+	ParticleEmitterDesc desc = ParticleEmitterDesc::Rain();
+	const ParticleRange range = { 128, 64 };
+	const glm::vec3 camera(10.0f, 2.0f, -4.0f);
+
+	const ParticleEmitterGpu gpu = PackParticleEmitter(desc, range, 1000, camera);
+	EXPECT_EQ(glm::vec3(gpu.center), camera + desc.center);
+	EXPECT_EQ(gpu.range.x, 128u);
+	EXPECT_EQ(gpu.range.y, 64u);
+	EXPECT_EQ(gpu.range.z, 64u);
+	EXPECT_FLOAT_EQ(gpu.extents.w, desc.windInfluence);
+
+	desc.followCamera = false;
+	EXPECT_EQ(glm::vec3(PackParticleEmitter(desc, range, 0, camera).center), desc.center);
+}
+
+TEST(ParticleEmitterTest, PackKeepsRangesOrdered)
+{
+	ParticleEmitterDesc desc;
+	desc.lifetimeMin = 0.0f;
+	desc.lifetimeMax = -1.0f;
+	desc.sizeMin = 0.2f;
+	desc.sizeMax = 0.1f;
+	desc.drag = -3.0f;
+
+	const ParticleEmitterGpu gpu = PackParticleEmitter(desc, { 0, 16 }, 4, glm::vec3(0.0f));
+	EXPECT_GT(gpu.velocityMin.w, 0.0f);
+	EXPECT_GE(gpu.velocityMax.w, gpu.velocityMin.w);
+	EXPECT_GE(gpu.motion.w, gpu.motion.z);
+	EXPECT_EQ(gpu.center.w, 0.0f);
+}
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+// PipelineBindingsTests.cpp
+//
+// Unit tests for the compile-time per-pipeline descriptor set table
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/PipelineBindings.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	using S = BindingSource;
+
+	// The table is usable in constant expressions
+	static_assert(GetPipelineBindings(PipelineType::Terrain).GetSetCount() == 5);
+	static_assert(GetPipelineBindings(PipelineType::Clouds).sets[0] == S::CommandSet);
+	static_assert(GetPipelineBindings(PipelineType::Shadow).GetSetCount() == 0);
+}
+
+TEST(PipelineBindingsTest, LitTypesFollowTheMeshConvention)
+{
+	const PipelineBindingLayout& mesh = GetPipelineBindings(PipelineType::Mesh);
+	EXPECT_EQ(mesh.sets, (std::array<S, 5>{ S::Uniform, S::Texture, S::Lighting, S::Shadow, S::None }));
+	EXPECT_EQ(mesh.GetSetCount(), 4u);
+
+	const PipelineBindingLayout& transparent = GetPipelineBindings(PipelineType::Transparent);
+	EXPECT_EQ(transparent.GetSetCount(), 3u);
+	EXPECT_FALSE(transparent.Uses(S::Shadow));
+
+	for (PipelineType type : { PipelineType::Terrain, PipelineType::Foliage })
+	{
+		const PipelineBindingLayout& layout = GetPipelineBindings(type);
+		EXPECT_EQ(layout.sets[3], S::Shadow);
+		EXPECT_EQ(layout.sets[4], S::Heightmap);
+	}
+}
+
+TEST(PipelineBindingsTest, WaterAndCloudsKeepTheirOwnLayouts)
+{
+	const PipelineBindingLayout& water = GetPipelineBindings(PipelineType::Water);
+	EXPECT_EQ(water.sets, (std::array<S, 5>{ S::Uniform, S::Lighting, S::Reflection, S::CommandSet, S::None }));
+	EXPECT_FALSE(water.Uses(S::Texture));
+
+	const PipelineBindingLayout& clouds = GetPipelineBindings(PipelineType::Clouds);
+	EXPECT_EQ(clouds.GetSetCount(), 1u);
+	EXPECT_FALSE(clouds.Uses(S::Uniform));
+}
+
+TEST(PipelineBindingsTest, UnlistedTypesBindNothing)
+{
+	for (PipelineType type : { PipelineType::Shadow, PipelineType::Compute, PipelineType::PostProcessCopy,
+		PipelineType::OitComposite, PipelineType::Count })
+	{
+		EXPECT_EQ(GetPipelineBindings(type).GetSetCount(), 0u) << static_cast<int>(type);
+	}
+
+	for (PipelineType type : { PipelineType::Triangle, PipelineType::Skybox })
+		EXPECT_EQ(GetPipelineBindings(type).GetSetCount(), 1u);
+	for (PipelineType type : { PipelineType::NodeGenerated, PipelineType::Firefly,
+		PipelineType::FireflyPoint, PipelineType::Particle })
+		EXPECT_EQ(GetPipelineBindings(type).GetSetCount(), 2u);
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// RayTracedShadowTests.cpp
+//
+// Unit tests for the ray-query sun shadow's parameters and TLAS planning
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/RayTracedShadow.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+TEST(RayTracedShadowTest, ParamsPickTheModeAndCone)
+{
+	RayTracedShadowSettings settings;
+	settings.sunAngularRadiusDeg = 0.0f;
+	settings.maxDistance = 250.0f;
+	glm::vec3 params = RayTracedShadow::BuildParams(settings);
+	EXPECT_EQ(params.x, RayTracedShadow::MODE_PIXEL);
+	EXPECT_FLOAT_EQ(params.y, 0.0f);
+	EXPECT_FLOAT_EQ(params.z, 250.0f);
+
+	settings.denoise = true;
+	EXPECT_EQ(RayTracedShadow::BuildParams(settings).x, RayTracedShadow::MODE_PIXEL_DENOISED);
+
+	// Sharing the quad's rays always denoises
+	settings.rate = RayTracedShadowRate::QuadShared;
+	settings.denoise = false;
+	settings.sunAngularRadiusDeg = 45.0f;   // clamped to 10
+	settings.maxDistance = -1.0f;
+	params = RayTracedShadow::BuildParams(settings);
+	EXPECT_EQ(params.x, RayTracedShadow::MODE_QUAD_SHARED);
+	EXPECT_NEAR(params.y, std::tan(glm::radians(10.0f)), 1e-6f);
+	EXPECT_FLOAT_EQ(params.z, 0.0f);
+}
+
+TEST(RayTracedShadowTest, InstanceTransformIsTheTopThreeRows)
+{
+	const glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f)),
+		glm::vec3(2.0f, 3.0f, 4.0f));
+
+	RayTracedShadowInstance instance;
+	RayTracedShadow::ToInstanceTransform(model, instance.transform);
+	EXPECT_FLOAT_EQ(instance.transform[0][0], 2.0f);
+	EXPECT_FLOAT_EQ(instance.transform[1][1], 3.0f);
+	EXPECT_FLOAT_EQ(instance.transform[2][2], 4.0f);
+	EXPECT_FLOAT_EQ(instance.transform[0][3], 1.0f);
+	EXPECT_FLOAT_EQ(instance.transform[1][3], 2.0f);
+	EXPECT_FLOAT_EQ(instance.transform[2][3], 3.0f);
+	EXPECT_FLOAT_EQ(instance.transform[0][1], 0.0f);
+
+	// Transforms a point the way the matrix does
+	const glm::vec4 point(0.5f, -1.0f, 2.0f, 1.0f);
+	const glm::vec4 expected = model * point;
+	for (int row = 0; row < 3; ++row)
+	{
+		const float x = instance.transform[row][0] * point.x + instance.transform[row][1] * point.y +
+			instance.transform[row][2] * point.z + instance.transform[row][3];
+		EXPECT_FLOAT_EQ(x, expected[row]);
+	}
+
+	EXPECT_EQ(instance.mask, 0xFFu);
+	EXPECT_EQ(instance.customIndex, 0u);
+}
+
+TEST(RayTracedShadowTest, RefitsOnlyTheSameInstances)
+{
+	TlasState state;
+	EXPECT_EQ(RayTracedShadow::PlanTlasUpdate(state, 10, 1, 4), TlasUpdate::Build);
+	state = RayTracedShadow::Advance(state, TlasUpdate::Build, 10, 1);
+	EXPECT_EQ(state.refits, 0u);
+
+	EXPECT_EQ(RayTracedShadow::PlanTlasUpdate(state, 10, 1, 4), TlasUpdate::Refit);
+	// An instance more or fewer, or another mesh in a slot
+	EXPECT_EQ(RayTracedShadow::PlanTlasUpdate(state, 11, 1, 4), TlasUpdate::Build);
+	EXPECT_EQ(RayTracedShadow::PlanTlasUpdate(state, 10, 2, 4), TlasUpdate::Build);
+}
+
+TEST(RayTracedShadowTest, RebuildsAfterTooManyRefits)
+{
+	TlasState state = RayTracedShadow::Advance(TlasState{}, TlasUpdate::Build, 5, 7);
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(RayTracedShadow::PlanTlasUpdate(state, 5, 7, 3), TlasUpdate::Refit);
+		state = RayTracedShadow::Advance(state, TlasUpdate::Refit, 5, 7);
+	}
+	EXPECT_EQ(state.refits, 3u);
+	EXPECT_EQ(RayTracedShadow::PlanTlasUpdate(state, 5, 7, 3), TlasUpdate::Build);
+	state = RayTracedShadow::Advance(state, TlasUpdate::Build, 5, 7);
+	EXPECT_EQ(state.refits, 0u);
+
+	// 0 refits per rebuild: every frame builds
+	EXPECT_EQ(RayTracedShadow::PlanTlasUpdate(state, 5, 7, 0), TlasUpdate::Build);
+}
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// ReflectionScheduleTests.cpp
+//
+// Unit tests for planar reflection update scheduling and its reprojection
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/ReflectionSchedule.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+namespace
+{
+	glm::mat4 MakeViewProj(const glm::vec3& eye, const glm::vec3& target)
+	{
+		return glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) *
+			glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	glm::vec2 Lookup(const glm::mat4& lookup, const glm::vec3& world)
+	{
+		const glm::vec4 r = lookup * glm::vec4(world, 1.0f);
+		return glm::vec2(r) / r.w;
+	}
+
+	// Where the reflection pass's negative-height viewport (bottom-left
+	// uvScale of the target) puts clip-space position clip, in target uv
+	glm::vec2 ViewportUV(const glm::vec4& clip, const glm::vec2& uvScale)
+	{
+		const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		return glm::vec2((ndc.x * 0.5f + 0.5f) * uvScale.x, 1.0f - (ndc.y * 0.5f + 0.5f) * uvScale.y);
+	}
+}
+
+TEST(ReflectionScheduleTest, IntervalOneRendersEveryFrame)
+{
+	ReflectionSchedule schedule;
+	for (int frame = 0; frame < 5; ++frame)
+	{
+		ASSERT_TRUE(schedule.IsDue(1, 0.0f));
+		schedule.Advance(true, glm::mat4(1.0f), glm::vec2(1.0f), 0.0f);
+	}
+}
+
+TEST(ReflectionScheduleTest, RendersEveryNthFrame)
+{
+	ReflectionSchedule schedule;
+	int rendered = 0;
+	for (int frame = 0; frame < 12; ++frame)
+	{
+		const bool due = schedule.IsDue(3, 0.0f);
+		EXPECT_EQ(due, frame % 3 == 0) << "frame " << frame;
+		rendered += due ? 1 : 0;
+		schedule.Advance(due, glm::mat4(1.0f), glm::vec2(1.0f), 0.0f);
+	}
+	EXPECT_EQ(rendered, 4);
+}
+
+TEST(ReflectionScheduleTest, IntervalIsClamped)
+{
+	ReflectionSchedule schedule;
+	schedule.Advance(true, glm::mat4(1.0f), glm::vec2(1.0f), 0.0f);
+	EXPECT_TRUE(schedule.IsDue(0, 0.0f));
+
+	for (uint32_t frame = 1; frame < ReflectionSchedule::MAX_INTERVAL; ++frame)
+	{
+		EXPECT_FALSE(schedule.IsDue(100, 0.0f));
+		schedule.Advance(false, glm::mat4(1.0f), glm::vec2(1.0f), 0.0f);
+	}
+	EXPECT_TRUE(schedule.IsDue(100, 0.0f));
+}
+
+TEST(ReflectionScheduleTest, InvalidateAndWaterMoveForceARender)
+{
+	ReflectionSchedule schedule;
+	EXPECT_TRUE(schedule.IsDue(4, 0.0f));   // nothing rendered yet
+	schedule.Advance(true, glm::mat4(1.0f), glm::vec2(0.5f), 0.0f);
+	EXPECT_FALSE(schedule.IsDue(4, 0.0f));
+	EXPECT_TRUE(schedule.IsDue(4, 0.25f));
+
+	schedule.Invalidate();
+	EXPECT_TRUE(schedule.IsDue(4, 0.0f));
+}
+
+TEST(ReflectionScheduleTest, ReuseKeepsTheRenderedLookup)
+{
+	ReflectionSchedule schedule;
+	const glm::mat4 rendered = ReflectionSchedule::BuildLookup(MakeViewProj(glm::vec3(0, 5, 10), glm::vec3(0)), glm::vec2(0.5f));
+	schedule.Advance(true, rendered, glm::vec2(0.5f, 0.75f), 0.0f);
+	schedule.Advance(false, glm::mat4(2.0f), glm::vec2(1.0f), 0.0f);
+
+	EXPECT_EQ(schedule.GetLookup(), rendered);
+	EXPECT_EQ(schedule.GetUVExtent(), glm::vec2(0.5f, 0.75f));
+	EXPECT_EQ(schedule.GetAge(), 1u);
+}
+
+TEST(ReflectionScheduleTest, LookupMatchesTheFlippedViewport)
+{
+	const glm::mat4 viewProj = MakeViewProj(glm::vec3(3, 8, 12), glm::vec3(0, 0, -4));
+	const glm::vec2 uvScale(0.5f, 0.375f);
+	const glm::mat4 lookup = ReflectionSchedule::BuildLookup(viewProj, uvScale);
+
+	for (const glm::vec3& p : { glm::vec3(0.0f), glm::vec3(2.0f, 0.0f, -6.0f), glm::vec3(-3.0f, 1.0f, 1.0f) })
+	{
+		const glm::vec2 expected = ViewportUV(viewProj * glm::vec4(p, 1.0f), uvScale);
+		const glm::vec2 uv = Lookup(lookup, p);
+		EXPECT_NEAR(uv.x, expected.x, 1e-5f);
+		EXPECT_NEAR(uv.y, expected.y, 1e-5f);
+	}
+}
+
+// The reflection pass draws with the mirrored view; water-plane points land
+// where the unmirrored camera projects them, which is what the lookup uses
+TEST(ReflectionScheduleTest, PlanePointsReprojectThroughTheMirror)
+{
+	const float waterY = 1.5f;
+	glm::mat4 mirror(1.0f);
+	mirror[1][1] = -1.0f;
+	mirror[3][1] = 2.0f * waterY;
+
+	const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+	const glm::mat4 view = glm::lookAt(glm::vec3(4, 9, 14), glm::vec3(0, waterY, 0), glm::vec3(0, 1, 0));
+	const glm::vec2 uvScale(0.5f);
+	const glm::mat4 lookup = ReflectionSchedule::BuildLookup(proj * view, uvScale);
+
+	for (const glm::vec3& p : { glm::vec3(0.0f, waterY, 0.0f), glm::vec3(-5.0f, waterY, -8.0f), glm::vec3(6.0f, waterY, 3.0f) })
+	{
+		const glm::vec2 drawn = ViewportUV(proj * view * mirror * glm::vec4(p, 1.0f), uvScale);
+		const glm::vec2 uv = Lookup(lookup, p);
+		EXPECT_NEAR(uv.x, drawn.x, 1e-5f);
+		EXPECT_NEAR(uv.y, drawn.y, 1e-5f);
+	}
+}
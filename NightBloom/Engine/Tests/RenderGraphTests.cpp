@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+// RenderGraphTests.cpp
+//
+// Unit tests for render graph pass culling, barrier derivation and resource
+// lifetimes (Compile only; nothing is recorded)
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/RenderGraph.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Never dereferenced: the graph only compares and copies handles
+	template<typename T>
+	T FakeHandle(uint64_t value)
+	{
+		return (T)(uintptr_t)value;
+	}
+
+	const RenderGraph::ExecuteFn kNoop = [](VkCommandBuffer) {};
+}
+
+TEST(RenderGraphTest, CullsPassesWithoutConsumers)
+{
+	RenderGraph graph;
+	RGResource cloudReflection = graph.ImportImage(FakeHandle<VkImage>(1), VK_IMAGE_LAYOUT_UNDEFINED);
+	RGResource reflection = graph.ImportImage(FakeHandle<VkImage>(2), VK_IMAGE_LAYOUT_UNDEFINED);
+	RGResource sceneColor = graph.ImportImage(FakeHandle<VkImage>(3), VK_IMAGE_LAYOUT_UNDEFINED);
+	graph.MarkOutput(sceneColor);
+
+	RGPass clouds = graph.AddPass("Cloud Reflection", nullptr, kNoop)
+		.Write(cloudReflection, RGAccess::ComputeWrite).GetHandle();
+	RGPass reflect = graph.AddPass("Reflection", nullptr, kNoop)
+		.Read(cloudReflection, RGAccess::FragmentSample)
+		.RenderTarget(reflection, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+		.GetHandle();
+	// No water drawn: the scene doesn't read the reflection
+	RGPass scene = graph.AddPass("Scene", nullptr, kNoop)
+		.RenderTarget(sceneColor, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+		.GetHandle();
+	graph.Compile();
+
+	EXPECT_TRUE(graph.IsPassCulled(clouds));
+	EXPECT_TRUE(graph.IsPassCulled(reflect));
+	EXPECT_FALSE(graph.IsPassCulled(scene));
+	EXPECT_EQ(graph.GetCulledPassCount(), 2u);
+	EXPECT_FALSE(graph.GetLifetime(reflection).IsUsed());
+}
+
+TEST(RenderGraphTest, SideEffectPassesSurvive)
+{
+	RenderGraph graph;
+	RGResource readback = graph.ImportBuffer(FakeHandle<VkBuffer>(1), 256);
+	RGPass pass = graph.AddPass("Readback", nullptr, kNoop)
+		.Write(readback, RGAccess::ComputeWrite).SideEffect().GetHandle();
+	graph.Compile();
+
+	EXPECT_FALSE(graph.IsPassCulled(pass));
+}
+
+TEST(RenderGraphTest, ComputeWriteThenFragmentSampleTransitionsOnce)
+{
+	RenderGraph graph;
+	VkImage clouds = FakeHandle<VkImage>(7);
+	RGResource result = graph.ImportImage(clouds, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	RGResource sceneColor = graph.ImportImage(FakeHandle<VkImage>(8), VK_IMAGE_LAYOUT_UNDEFINED);
+	graph.MarkOutput(sceneColor);
+
+	RGPass raymarch = graph.AddPass("Clouds", nullptr, kNoop)
+		.WriteManaged(result, RGAccess::ComputeWrite).GetHandle();
+	RGPass reflect = graph.AddPass("Reflection", nullptr, kNoop)
+		.Read(result, RGAccess::FragmentSample).SideEffect().GetHandle();
+	RGPass scene = graph.AddPass("Scene", nullptr, kNoop)
+		.Read(result, RGAccess::FragmentSample)
+		.RenderTarget(sceneColor, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+		.GetHandle();
+	graph.Compile();
+
+	EXPECT_TRUE(graph.GetPassBarriers(raymarch).IsEmpty());
+
+	const RenderGraph::PassBarriers& barriers = graph.GetPassBarriers(reflect);
+	ASSERT_EQ(barriers.images.size(), 1u);
+	EXPECT_EQ(barriers.images[0].image, clouds);
+	EXPECT_EQ(barriers.images[0].oldLayout, VK_IMAGE_LAYOUT_GENERAL);
+	EXPECT_EQ(barriers.images[0].newLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	EXPECT_EQ(barriers.srcStages, static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT));
+	EXPECT_EQ(barriers.dstStages, static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT));
+
+	// Already visible to fragment shaders in the right layout
+	EXPECT_TRUE(graph.GetPassBarriers(scene).IsEmpty());
+}
+
+TEST(RenderGraphTest, RenderPassDependencyCoversListedStagesOnly)
+{
+	RenderGraph graph;
+	RGResource depth = graph.ImportImage(FakeHandle<VkImage>(1), VK_IMAGE_LAYOUT_UNDEFINED,
+		VK_IMAGE_ASPECT_DEPTH_BIT);
+
+	graph.AddPass("Scene", nullptr, kNoop)
+		.RenderTarget(depth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	RGPass hiz = graph.AddPass("Hi-Z", nullptr, kNoop)
+		.Read(depth, RGAccess::DepthSample).SideEffect().GetHandle();
+	graph.Compile();
+
+	EXPECT_TRUE(graph.GetPassBarriers(hiz).IsEmpty());
+}
+
+TEST(RenderGraphTest, ComputeWriteToIndirectReadBarriersBuffer)
+{
+	RenderGraph graph;
+	VkBuffer indirect = FakeHandle<VkBuffer>(3);
+	RGResource args = graph.ImportBuffer(indirect, 64);
+
+	RGPass cull = graph.AddPass("Grass Cull", "Compute", kNoop)
+		.Write(args, RGAccess::ComputeWrite).GetHandle();
+	RGPass draw = graph.AddPass("Scene", "Scene", kNoop)
+		.Read(args, RGAccess::IndirectRead).SideEffect().GetHandle();
+	graph.Compile();
+
+	EXPECT_FALSE(graph.IsPassCulled(cull));
+	EXPECT_TRUE(graph.GetPassBarriers(cull).IsEmpty());
+
+	const RenderGraph::PassBarriers& barriers = graph.GetPassBarriers(draw);
+	ASSERT_EQ(barriers.buffers.size(), 1u);
+	EXPECT_EQ(barriers.buffers[0].buffer, indirect);
+	EXPECT_EQ(barriers.buffers[0].size, 64u);
+	EXPECT_EQ(barriers.buffers[0].dstAccessMask, static_cast<VkAccessFlags>(VK_ACCESS_INDIRECT_COMMAND_READ_BIT));
+	EXPECT_EQ(barriers.dstStages, static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT));
+}
+
+TEST(RenderGraphTest, ComputeWriteToVertexInputBarriersOnce)
+{
+	RenderGraph graph;
+	VkBuffer skinned = FakeHandle<VkBuffer>(5);
+	RGResource vertices = graph.ImportBuffer(skinned, 256);
+
+	graph.AddPass("Skinning", "Compute", kNoop)
+		.Write(vertices, RGAccess::ComputeWrite);
+	RGPass shadow = graph.AddPass("Shadow", "Shadow", kNoop)
+		.Read(vertices, RGAccess::VertexInput).SideEffect().GetHandle();
+	RGPass scene = graph.AddPass("Scene", "Scene", kNoop)
+		.Read(vertices, RGAccess::VertexInput).SideEffect().GetHandle();
+	graph.Compile();
+
+	// The first reader waits on the compute write; the second reads after a read
+	const RenderGraph::PassBarriers& barriers = graph.GetPassBarriers(shadow);
+	ASSERT_EQ(barriers.buffers.size(), 1u);
+	EXPECT_EQ(barriers.buffers[0].buffer, skinned);
+	EXPECT_EQ(barriers.buffers[0].dstAccessMask, static_cast<VkAccessFlags>(VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT));
+	EXPECT_EQ(barriers.dstStages, static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT));
+	EXPECT_TRUE(graph.GetPassBarriers(scene).IsEmpty());
+}
+
+TEST(RenderGraphTest, ComputeWriteToFragmentReadBarriersBuffer)
+{
+	RenderGraph graph;
+	VkBuffer clusters = FakeHandle<VkBuffer>(4);
+	RGResource lists = graph.ImportBuffer(clusters, 1024);
+
+	graph.AddPass("Light Clusters", "Compute", kNoop)
+		.Write(lists, RGAccess::ComputeWrite);
+	RGPass scene = graph.AddPass("Scene", "Scene", kNoop)
+		.Read(lists, RGAccess::FragmentRead).SideEffect().GetHandle();
+	RGPass reflect = graph.AddPass("Reflection", "Reflection", kNoop)
+		.Read(lists, RGAccess::FragmentRead).SideEffect().GetHandle();
+	graph.Compile();
+
+	const RenderGraph::PassBarriers& barriers = graph.GetPassBarriers(scene);
+	ASSERT_EQ(barriers.buffers.size(), 1u);
+	EXPECT_EQ(barriers.buffers[0].buffer, clusters);
+	EXPECT_EQ(barriers.buffers[0].dstAccessMask, static_cast<VkAccessFlags>(VK_ACCESS_SHADER_READ_BIT));
+	EXPECT_EQ(barriers.srcStages, static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT));
+	EXPECT_EQ(barriers.dstStages, static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT));
+
+	// Already visible to fragment shaders
+	EXPECT_TRUE(graph.GetPassBarriers(reflect).IsEmpty());
+}
+
+TEST(RenderGraphTest, LifetimesSpanFirstToLastUse)
+{
+	RenderGraph graph;
+	RGResource a = graph.ImportImage(FakeHandle<VkImage>(1), VK_IMAGE_LAYOUT_UNDEFINED);
+	RGResource b = graph.ImportImage(FakeHandle<VkImage>(2), VK_IMAGE_LAYOUT_UNDEFINED);
+	RGResource c = graph.ImportImage(FakeHandle<VkImage>(3), VK_IMAGE_LAYOUT_UNDEFINED);
+	graph.MarkOutput(c);
+
+	const VkImageLayout readOnly = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	const VkPipelineStageFlags fragment = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	graph.AddPass("0", nullptr, kNoop).RenderTarget(a, readOnly, fragment);
+	graph.AddPass("1", nullptr, kNoop).Read(a, RGAccess::FragmentSample).RenderTarget(b, readOnly, fragment);
+	graph.AddPass("2", nullptr, kNoop).Read(b, RGAccess::FragmentSample).RenderTarget(c, readOnly, fragment);
+	graph.Compile();
+
+	EXPECT_EQ(graph.GetLifetime(a).firstPass, 0u);
+	EXPECT_EQ(graph.GetLifetime(a).lastPass, 1u);
+	EXPECT_TRUE(graph.LifetimesOverlap(a, b));
+	EXPECT_FALSE(graph.LifetimesOverlap(a, c));
+}
+
+TEST(RenderGraphTest, ResetStartsAFreshFrame)
+{
+	RenderGraph graph;
+	RGResource image = graph.ImportImage(FakeHandle<VkImage>(1), VK_IMAGE_LAYOUT_UNDEFINED);
+	graph.AddPass("Unused", nullptr, kNoop).Write(image, RGAccess::ComputeWrite);
+	graph.Compile();
+	EXPECT_EQ(graph.GetCulledPassCount(), 1u);
+
+	graph.Reset();
+	graph.AddPass("Present", nullptr, kNoop).SideEffect();
+	graph.Compile();
+	EXPECT_EQ(graph.GetCulledPassCount(), 0u);
+	EXPECT_FALSE(graph.GetLifetime(image).IsUsed());
+}
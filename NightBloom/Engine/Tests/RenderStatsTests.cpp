@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+// RenderStatsTests.cpp
+//
+// Unit tests for the per-pass render counters and their per-frame deltas
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/RenderStats.hpp"
+#include <thread>
+
+using namespace Nightbloom;
+
+TEST(RenderStats, CountsGoToTheCurrentPassAndFramesAreDeltas)
+{
+	RenderStats stats;
+	const uint32_t shadow = stats.RegisterPass("Shadow");
+	const uint32_t scene = stats.RegisterPass("Scene");
+	EXPECT_EQ(stats.RegisterPass("Shadow"), shadow);
+	EXPECT_NE(shadow, scene);
+
+	stats.Add(RenderCounter::UploadBytes, 256);   // outside any pass
+	{
+		RenderStatsPassScope pass(shadow);
+		stats.AddDraw(300, 2);
+		stats.Add(RenderCounter::PipelineBinds);
+		{
+			RenderStatsPassScope nested(scene);
+			stats.AddIndirectDraw();
+		}
+		stats.Add(RenderCounter::DescriptorBinds, 3);
+	}
+	stats.EndFrame();
+
+	const RenderFrameStats& first = stats.GetLastFrame();
+	EXPECT_EQ(first.frame, 0u);
+	ASSERT_EQ(first.passes.size(), 3u);
+	EXPECT_EQ(first.passes[0].name, "Other");
+	EXPECT_EQ(first.passes[0].Get(RenderCounter::UploadBytes), 256u);
+
+	const RenderPassStats* shadowStats = first.FindPass("Shadow");
+	ASSERT_NE(shadowStats, nullptr);
+	EXPECT_EQ(shadowStats->Get(RenderCounter::DrawCalls), 1u);
+	EXPECT_EQ(shadowStats->Get(RenderCounter::Instances), 2u);
+	EXPECT_EQ(shadowStats->Get(RenderCounter::Indices), 600u);
+	EXPECT_EQ(shadowStats->Get(RenderCounter::DescriptorBinds), 3u);
+	EXPECT_EQ(first.FindPass("Scene")->Get(RenderCounter::IndirectDraws), 1u);
+	EXPECT_EQ(first.Get(RenderCounter::DrawCalls), 2u);
+
+	// Only what was counted since
+	{
+		RenderStatsPassScope pass(scene);
+		stats.AddDraw(3, 1);
+	}
+	stats.EndFrame();
+	const RenderFrameStats& second = stats.GetLastFrame();
+	ASSERT_EQ(second.passes.size(), 1u);
+	EXPECT_EQ(second.passes[0].name, "Scene");
+	EXPECT_EQ(second.Get(RenderCounter::DrawCalls), 1u);
+	EXPECT_EQ(second.FindPass("Shadow"), nullptr);
+
+	EXPECT_EQ(stats.GetSeries(RenderCounter::DrawCalls), (std::vector<float>{ 2.0f, 1.0f }));
+	EXPECT_EQ(stats.GetSeries(RenderCounter::DrawCalls, shadow), (std::vector<float>{ 1.0f, 0.0f }));
+}
+
+TEST(RenderStats, SumsEveryThreadAndKeepsABoundedHistory)
+{
+	RenderStats stats;
+	stats.SetHistoryCapacity(2);
+	const uint32_t scene = stats.RegisterPass("Scene");
+
+	// Workers count into the pass they're handed, as CommandRecorder does
+	for (uint32_t frame = 0; frame < 3; ++frame)
+	{
+		std::vector<std::thread> workers;
+		for (uint32_t t = 0; t < 4; ++t)
+		{
+			workers.emplace_back([&stats, scene]()
+			{
+				RenderStatsPassScope pass(scene);
+				for (uint32_t i = 0; i < 1000; ++i)
+					stats.AddDraw(6, 1);
+			});
+		}
+		for (std::thread& worker : workers)
+			worker.join();
+		stats.EndFrame();
+	}
+
+	EXPECT_EQ(stats.GetLastFrame().frame, 2u);
+	EXPECT_EQ(stats.GetLastFrame().FindPass("Scene")->Get(RenderCounter::DrawCalls), 4000u);
+	EXPECT_EQ(stats.GetLastFrame().Get(RenderCounter::Indices), 24000u);
+	EXPECT_EQ(stats.GetHistory().size(), 2u);
+
+	stats.SetEnabled(false);
+	stats.AddDraw(6, 1);
+	stats.EndFrame();
+	EXPECT_EQ(stats.GetLastFrame().Get(RenderCounter::DrawCalls), 0u);
+}
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+// ResourceHandleTests.cpp
+//
+// Unit tests for generational resource handles and their slot pool
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/ResourceHandle.hpp"
+#include <memory>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct TestTag;
+	using TestHandle = ResourceHandle<TestTag>;
+	using TestPool = ResourcePool<std::unique_ptr<int>, TestTag>;
+}
+
+TEST(ResourceHandleTest, PacksIndexAndGeneration)
+{
+	const TestHandle handle = TestHandle::Make(12345, 7);
+	EXPECT_EQ(handle.GetIndex(), 12345u);
+	EXPECT_EQ(handle.GetGeneration(), 7u);
+	EXPECT_TRUE(handle.IsValid());
+
+	EXPECT_FALSE(TestHandle{}.IsValid());
+	EXPECT_EQ(TestHandle::Make(TestHandle::INDEX_MASK, TestHandle::MAX_GENERATION).value, 0xFFFFFFFFu);
+}
+
+TEST(ResourceHandleTest, ResolvesLiveEntries)
+{
+	TestPool pool;
+	const TestHandle a = pool.Insert(std::make_unique<int>(1));
+	const TestHandle b = pool.Insert(std::make_unique<int>(2));
+
+	ASSERT_TRUE(a.IsValid());
+	ASSERT_NE(a, b);
+	EXPECT_EQ(**pool.Get(a), 1);
+	EXPECT_EQ(**pool.Get(b), 2);
+	EXPECT_EQ(pool.Size(), 2u);
+	EXPECT_EQ(pool.Get(TestHandle{}), nullptr);
+}
+
+TEST(ResourceHandleTest, StaleHandleDoesNotAliasTheReusedSlot)
+{
+	TestPool pool;
+	const TestHandle old = pool.Insert(std::make_unique<int>(1));
+
+	std::unique_ptr<int> removed = pool.Remove(old);
+	ASSERT_TRUE(removed);
+	EXPECT_EQ(*removed, 1);
+	EXPECT_EQ(pool.Get(old), nullptr);
+	EXPECT_FALSE(pool.Remove(old));
+
+	const TestHandle reused = pool.Insert(std::make_unique<int>(2));
+	EXPECT_EQ(reused.GetIndex(), old.GetIndex());
+	EXPECT_NE(reused.GetGeneration(), old.GetGeneration());
+	EXPECT_EQ(pool.Get(old), nullptr);
+	EXPECT_EQ(**pool.Get(reused), 2);
+}
+
+TEST(ResourceHandleTest, RetiresSlotsWhoseGenerationWouldWrap)
+{
+	TestPool pool;
+	TestHandle handle = pool.Insert(std::make_unique<int>(0));
+	const uint32_t index = handle.GetIndex();
+
+	for (uint32_t i = 1; i < TestHandle::MAX_GENERATION; ++i)
+	{
+		pool.Remove(handle);
+		handle = pool.Insert(std::make_unique<int>(0));
+		ASSERT_EQ(handle.GetIndex(), index);
+	}
+	EXPECT_EQ(handle.GetGeneration(), TestHandle::MAX_GENERATION);
+
+	pool.Remove(handle);
+	const TestHandle next = pool.Insert(std::make_unique<int>(0));
+	EXPECT_NE(next.GetIndex(), index);
+}
+
+TEST(ResourceHandleTest, ClearLeavesEveryHandleStale)
+{
+	TestPool pool;
+	const TestHandle a = pool.Insert(std::make_unique<int>(1));
+	const TestHandle b = pool.Insert(std::make_unique<int>(2));
+
+	int visited = 0;
+	pool.ForEach([&](TestHandle, std::unique_ptr<int>& value) { visited += *value; });
+	EXPECT_EQ(visited, 3);
+
+	pool.Clear();
+	EXPECT_TRUE(pool.IsEmpty());
+	EXPECT_EQ(pool.Get(a), nullptr);
+	EXPECT_EQ(pool.Get(b), nullptr);
+
+	const TestHandle c = pool.Insert(std::make_unique<int>(3));
+	EXPECT_NE(c, a);
+	EXPECT_NE(c, b);
+}
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+// SamplerKeyTests.cpp
+//
+// Unit tests for the sampler cache's key normalization
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Vulkan/VulkanSamplerCache.hpp"
+
+using namespace Nightbloom;
+
+TEST(SamplerKeyTest, IgnoresFieldsThatDoNotAffectSampling)
+{
+	VkSamplerCreateInfo a = VulkanSamplerCache::LinearClamp();
+	VkSamplerCreateInfo b = a;
+	b.maxAnisotropy = 16.0f;                       // anisotropy off
+	b.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;     // compare off
+	b.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;  // no CLAMP_TO_BORDER
+
+	const SamplerKey keyA = SamplerKey::FromCreateInfo(a);
+	const SamplerKey keyB = SamplerKey::FromCreateInfo(b);
+	EXPECT_EQ(keyA, keyB);
+	EXPECT_EQ(SamplerKeyHash{}(keyA), SamplerKeyHash{}(keyB));
+}
+
+TEST(SamplerKeyTest, DistinguishesFieldsThatAffectSampling)
+{
+	const VkSamplerCreateInfo base = VulkanSamplerCache::LinearClamp();
+	const SamplerKey baseKey = SamplerKey::FromCreateInfo(base);
+
+	VkSamplerCreateInfo point = base;
+	point.magFilter = point.minFilter = VK_FILTER_NEAREST;
+	EXPECT_NE(SamplerKey::FromCreateInfo(point), baseKey);
+
+	VkSamplerCreateInfo mipped = base;
+	mipped.maxLod = VK_LOD_CLAMP_NONE;
+	EXPECT_NE(SamplerKey::FromCreateInfo(mipped), baseKey);
+
+	VkSamplerCreateInfo shadow = base;
+	shadow.addressModeU = shadow.addressModeV = shadow.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+	shadow.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+	VkSamplerCreateInfo blackBorder = shadow;
+	blackBorder.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+	EXPECT_NE(SamplerKey::FromCreateInfo(shadow), SamplerKey::FromCreateInfo(blackBorder));
+
+	VkSamplerCreateInfo pcf = shadow;
+	pcf.compareEnable = VK_TRUE;
+	pcf.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+	EXPECT_NE(SamplerKey::FromCreateInfo(pcf), SamplerKey::FromCreateInfo(shadow));
+}
+
+TEST(SamplerKeyTest, RoundTripsThroughCreateInfo)
+{
+	VkSamplerCreateInfo info = VulkanSamplerCache::LinearClamp();
+	info.anisotropyEnable = VK_TRUE;
+	info.maxAnisotropy = 8.0f;
+	info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	info.maxLod = VK_LOD_CLAMP_NONE;
+
+	const SamplerKey key = SamplerKey::FromCreateInfo(info);
+	const VkSamplerCreateInfo rebuilt = key.ToCreateInfo();
+	EXPECT_EQ(rebuilt.sType, VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO);
+	EXPECT_EQ(rebuilt.pNext, nullptr);
+	EXPECT_EQ(SamplerKey::FromCreateInfo(rebuilt), key);
+	EXPECT_FLOAT_EQ(rebuilt.maxAnisotropy, 8.0f);
+}
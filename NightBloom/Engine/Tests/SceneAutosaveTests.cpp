@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+// SceneAutosaveTests.cpp
+//
+// Unit tests for the background scene autosave
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SceneAutosave.hpp"
+#include <filesystem>
+
+using namespace Nightbloom;
+
+namespace
+{
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	SceneFileData MakeScene(size_t objectCount)
+	{
+		SceneFileData data;
+		data.name = "Autosaved";
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			SceneFileObject object;
+			object.name = "Rock" + std::to_string(i);
+			object.source = "Assets/Models/Rock.gltf";
+			object.position = glm::vec3(float(i), 0.0f, 0.0f);
+			data.objects.push_back(object);
+		}
+		return data;
+	}
+}
+
+TEST(SceneAutosave, WritesInBackgroundAndSkipsUnchanged)
+{
+	const std::string path = TempPath("nb_autosave_bg.nbscene");
+	std::filesystem::remove(path);
+
+	SceneAutosave autosave;
+	autosave.Start();
+	autosave.Submit(MakeScene(50), path);
+	autosave.Flush();
+	EXPECT_EQ(autosave.GetWriteCount(), 1u);
+	EXPECT_FALSE(autosave.IsBusy());
+
+	SceneFileData loaded;
+	std::string error;
+	ASSERT_TRUE(ReadSceneFile(path, loaded, error)) << error;
+	EXPECT_EQ(loaded.objects.size(), 50u);
+
+	// Same content again: nothing written
+	autosave.Submit(MakeScene(50), path);
+	autosave.Flush();
+	EXPECT_EQ(autosave.GetWriteCount(), 1u);
+	EXPECT_EQ(autosave.GetUnchangedCount(), 1u);
+
+	// One object moved: written
+	SceneFileData moved = MakeScene(50);
+	moved.objects[7].position.y = 3.0f;
+	autosave.Submit(moved, path);
+	autosave.Stop();
+	EXPECT_EQ(autosave.GetWriteCount(), 2u);
+	ASSERT_TRUE(ReadSceneFile(path, loaded, error)) << error;
+	EXPECT_EQ(loaded.objects[7].position.y, 3.0f);
+
+	std::filesystem::remove(path);
+}
+
+TEST(SceneAutosave, StopWritesQueuedSnapshot)
+{
+	const std::string path = TempPath("nb_autosave_stop.nbscene");
+	std::filesystem::remove(path);
+
+	SceneAutosave autosave;
+	autosave.Start();
+	for (size_t i = 1; i <= 5; ++i)
+		autosave.Submit(MakeScene(i), path);
+	autosave.Stop();
+
+	// Newer snapshots replace queued ones; the last always lands
+	SceneFileData loaded;
+	std::string error;
+	ASSERT_TRUE(ReadSceneFile(path, loaded, error)) << error;
+	EXPECT_EQ(loaded.objects.size(), 5u);
+	EXPECT_GE(autosave.GetWriteCount(), 1u);
+	EXPECT_LE(autosave.GetWriteCount(), 5u);
+
+	std::filesystem::remove(path);
+}
+
+TEST(SceneAutosave, WritesInlineWhenNotStarted)
+{
+	const std::string path = TempPath("nb_autosave_inline.nbscene");
+	SceneAutosave autosave;
+	autosave.Submit(MakeScene(2), path);
+	EXPECT_EQ(autosave.GetWriteCount(), 1u);
+	EXPECT_TRUE(std::filesystem::exists(path));
+	std::filesystem::remove(path);
+}
+
+TEST(SceneAutosave, TickFiresOncePerInterval)
+{
+	SceneAutosave autosave;
+	autosave.SetInterval(1.0f);
+	EXPECT_FALSE(autosave.Tick(0.5f));
+	EXPECT_TRUE(autosave.Tick(0.6f));
+	EXPECT_FALSE(autosave.Tick(0.5f));
+	EXPECT_TRUE(autosave.Tick(0.5f));
+
+	autosave.SetInterval(0.0f);
+	EXPECT_FALSE(autosave.Tick(100.0f));
+}
+
+TEST(SceneAutosave, AutosavePathSitsNextToScene)
+{
+	EXPECT_EQ(std::filesystem::path(SceneAutosave::GetAutosavePath("/projects/forest.nbscene")).filename().string(),
+		"forest.autosave.nbscene");
+	EXPECT_FALSE(SceneAutosave::GetAutosavePath("").empty());
+}
@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+// SceneBVHTests.cpp
+//
+// Unit tests for the scene BVH queries against brute force, and refitting
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SceneBVH.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// count unit boxes scattered through a 200m cube, every 7th without bounds
+	void Scatter(SceneNodes& nodes, size_t count, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint32_t node = nodes.Add(glm::translate(glm::mat4(1.0f),
+				glm::vec3(position(rng), position(rng), position(rng))));
+			if (i % 7 != 0)
+				nodes.SetLocalBounds(node, glm::vec3(-1.0f), glm::vec3(1.0f));
+		}
+		nodes.Update();
+	}
+
+	bool Bounded(const SceneNodes& nodes, uint32_t object)
+	{
+		return (nodes.GetFlags()[object] & SceneNodes::HasBounds) != 0;
+	}
+
+	glm::vec3 Center(const SceneNodes& nodes, uint32_t object)
+	{
+		const AABBBatch& b = nodes.GetWorldBounds();
+		return glm::vec3(b.cx[object], b.cy[object], b.cz[object]);
+	}
+
+	Frustum SomeFrustum()
+	{
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 proj = glm::perspective(glm::radians(50.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+		return Frustum::ExtractFromMatrix(proj * view);
+	}
+
+	std::vector<uint32_t> BruteForceBox(const SceneNodes& nodes, const glm::vec3& boxMin, const glm::vec3& boxMax)
+	{
+		std::vector<uint32_t> result;
+		for (uint32_t i = 0; i < nodes.Size(); ++i)
+		{
+			const glm::vec3 c = Center(nodes, i);
+			if (Bounded(nodes, i) && glm::all(glm::lessThanEqual(c - 1.0f, boxMax)) &&
+				glm::all(glm::greaterThanEqual(c + 1.0f, boxMin)))
+			{
+				result.push_back(i);
+			}
+		}
+		return result;
+	}
+}
+
+TEST(SceneBVH, FrustumQueryMatchesBruteForce)
+{
+	SceneNodes nodes;
+	Scatter(nodes, 2000, 3);
+	SceneBVH bvh;
+	bvh.Build(nodes);
+	EXPECT_EQ(bvh.GetObjectCount(), 2000u - (2000u + 6) / 7);
+
+	const Frustum frustum = SomeFrustum();
+	std::vector<uint8_t> visible(nodes.Size(), 0);
+	bvh.QueryFrustum(frustum, visible.data());
+
+	size_t visibleCount = 0;
+	for (uint32_t i = 0; i < nodes.Size(); ++i)
+	{
+		const bool expected = Bounded(nodes, i) && frustum.Intersects(Center(nodes, i), glm::vec3(1.0f));
+		EXPECT_EQ(visible[i] != 0, expected) << "object " << i;
+		visibleCount += visible[i];
+	}
+	EXPECT_GT(visibleCount, 0u);
+	EXPECT_LT(visibleCount, bvh.GetObjectCount());
+}
+
+TEST(SceneBVH, MultiFrustumQueryMatchesSingleQueries)
+{
+	SceneNodes nodes;
+	Scatter(nodes, 2000, 4);
+	SceneBVH bvh;
+	bvh.Build(nodes);
+
+	// A perspective view plus top and side orthographic views
+	const glm::mat4 ortho = glm::ortho(-40.0f, 40.0f, -25.0f, 25.0f, 0.1f, 500.0f);
+	const Frustum frusta[3] = {
+		SomeFrustum(),
+		Frustum::ExtractFromMatrix(ortho * glm::lookAt(glm::vec3(0.0f, 200.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f))),
+		Frustum::ExtractFromMatrix(ortho * glm::lookAt(glm::vec3(200.0f, 0.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)))
+	};
+
+	std::vector<uint8_t> masks(nodes.Size(), 0);
+	bvh.QueryFrusta(frusta, 3, masks.data());
+
+	for (uint32_t v = 0; v < 3; ++v)
+	{
+		std::vector<uint8_t> visible(nodes.Size(), 0);
+		bvh.QueryFrustum(frusta[v], visible.data());
+		size_t visibleCount = 0;
+		for (uint32_t i = 0; i < nodes.Size(); ++i)
+		{
+			EXPECT_EQ((masks[i] >> v) & 1u, visible[i]) << "view " << v << " object " << i;
+			visibleCount += visible[i];
+		}
+		EXPECT_GT(visibleCount, 0u);
+	}
+}
+
+TEST(SceneBVH, RangeQueriesMatchBruteForce)
+{
+	SceneNodes nodes;
+	Scatter(nodes, 1000, 5);
+	SceneBVH bvh;
+	bvh.Build(nodes);
+
+	const glm::vec3 boxMin(-30.0f, -50.0f, -10.0f), boxMax(20.0f, 0.0f, 40.0f);
+	std::vector<uint32_t> found;
+	bvh.QueryBox(boxMin, boxMax, found);
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(found, BruteForceBox(nodes, boxMin, boxMax));
+	EXPECT_FALSE(found.empty());
+
+	found.clear();
+	bvh.QuerySphere(glm::vec3(10.0f), 35.0f, found);
+	for (uint32_t object : found)
+		EXPECT_LE(glm::length(glm::clamp(glm::vec3(10.0f), Center(nodes, object) - 1.0f, Center(nodes, object) + 1.0f) - glm::vec3(10.0f)), 35.0f);
+	// The sphere's box holds everything the sphere touches
+	EXPECT_LE(found.size(), BruteForceBox(nodes, glm::vec3(-25.0f), glm::vec3(45.0f)).size());
+}
+
+TEST(SceneBVH, RaycastFindsNearestAcceptedBox)
+{
+	SceneNodes nodes;
+	for (float z : { -10.0f, -20.0f, -30.0f })
+	{
+		const uint32_t node = nodes.Add(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, z)));
+		nodes.SetLocalBounds(node, glm::vec3(-1.0f), glm::vec3(1.0f));
+	}
+	nodes.Update();
+	SceneBVH bvh;
+	bvh.Build(nodes);
+
+	SceneBVH::RayHit hit = bvh.Raycast(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+	EXPECT_EQ(hit.object, 0u);
+	EXPECT_FLOAT_EQ(hit.distance, 9.0f);
+
+	hit = bvh.Raycast(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), FLT_MAX,
+		[](uint32_t object) { return object != 0; });
+	EXPECT_EQ(hit.object, 1u);
+
+	hit = bvh.Raycast(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 5.0f);
+	EXPECT_EQ(hit.object, SceneBVH::INVALID);
+	hit = bvh.Raycast(glm::vec3(5.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+	EXPECT_EQ(hit.object, SceneBVH::INVALID);
+}
+
+TEST(SceneBVH, RefitFollowsMovedObjects)
+{
+	SceneNodes nodes;
+	Scatter(nodes, 500, 9);
+	SceneBVH bvh;
+	bvh.Build(nodes);
+
+	// A few small moves: refit, no rebuild
+	for (uint32_t object : { 1u, 2u, 3u })
+		nodes.SetLocal(object, glm::translate(nodes.GetLocal(object), glm::vec3(0.5f)));
+	nodes.Update();
+	EXPECT_FALSE(bvh.Refit(nodes, nodes.GetUpdated()));
+
+	// Move one far away; queries must see it there
+	nodes.SetLocal(1, glm::translate(glm::mat4(1.0f), glm::vec3(500.0f, 0.0f, 0.0f)));
+	nodes.Update();
+	bvh.Refit(nodes, nodes.GetUpdated());
+
+	std::vector<uint32_t> found;
+	bvh.QueryBox(glm::vec3(490.0f, -10.0f, -10.0f), glm::vec3(510.0f, 10.0f, 10.0f), found);
+	ASSERT_EQ(found.size(), 1u);
+	EXPECT_EQ(found[0], 1u);
+
+	// Everything swapped around degrades the tree past the rebuild ratio
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	for (uint32_t object = 0; object < nodes.Size(); ++object)
+		nodes.SetLocal(object, glm::translate(glm::mat4(1.0f), glm::vec3(position(rng), position(rng), position(rng))));
+	nodes.Update();
+	EXPECT_TRUE(bvh.Refit(nodes, nodes.GetUpdated()));
+
+	found.clear();
+	bvh.QueryBox(glm::vec3(-20.0f), glm::vec3(20.0f), found);
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(found, BruteForceBox(nodes, glm::vec3(-20.0f), glm::vec3(20.0f)));
+}
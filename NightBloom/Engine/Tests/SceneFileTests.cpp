@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+// SceneFileTests.cpp
+//
+// Unit tests for the binary and JSON scene file encodings
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SceneFile.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace Nightbloom;
+
+namespace
+{
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	SceneFileData MakeScene()
+	{
+		SceneFileData data;
+		data.name = "Forest";
+		data.camera.position = glm::vec3(1.0f, 2.0f, 3.0f);
+		data.camera.yaw = 12.5f;
+		data.camera.fov = 60.0f;
+		data.ambientColor = glm::vec3(0.1f, 0.2f, 0.3f);
+		data.ambientIntensity = 0.5f;
+		data.editorJson = R"({"dayNight":{"time":0.25}})";
+
+		Light sun;
+		sun.name = "Sun";
+		sun.direction = glm::vec3(0.0f, -1.0f, 0.5f);
+		sun.shadowConfig.castsShadows = true;
+		sun.shadowConfig.cacheFarCascades = false;
+		sun.shadowConfig.nearCascadesPerFrame = 3;
+		sun.shadowConfig.fitSplitsToDepth = false;
+		data.lights.push_back(sun);
+
+		Light lamp;
+		lamp.name = "Lamp";
+		lamp.type = LightType::Point;
+		lamp.enabled = false;
+		lamp.radius = 7.0f;
+		data.lights.push_back(lamp);
+
+		for (int i = 0; i < 3; ++i)
+		{
+			SceneFileObject tree;
+			tree.name = "Tree" + std::to_string(i);
+			tree.source = "Assets/Models/Tree/Tree.gltf";
+			tree.position = glm::vec3(float(i), 0.0f, -float(i));
+			tree.rotation = glm::vec3(0.0f, 0.5f * float(i), 0.0f);
+			tree.scale = glm::vec3(1.0f + float(i));
+			tree.parent = i > 0 ? 0 : -1;
+			data.objects.push_back(tree);
+		}
+
+		SceneFileObject ground;
+		ground.kind = SceneFileObject::Kind::Primitive;
+		ground.name = "Ground";
+		ground.visible = false;
+		ground.primitive = "GroundPlane";
+		ground.texture = "grass";
+		ground.pipeline = 2;
+		ground.customData = glm::vec4(1.0f, 2.0f, 3.0f, 4.0f);
+		data.objects.push_back(ground);
+		return data;
+	}
+
+	void ExpectSameScene(const SceneFileData& a, const SceneFileData& b)
+	{
+		EXPECT_EQ(a.name, b.name);
+		EXPECT_EQ(a.camera.position, b.camera.position);
+		EXPECT_EQ(a.camera.yaw, b.camera.yaw);
+		EXPECT_EQ(a.camera.fov, b.camera.fov);
+		EXPECT_EQ(a.ambientColor, b.ambientColor);
+		EXPECT_EQ(a.ambientIntensity, b.ambientIntensity);
+
+		ASSERT_EQ(a.lights.size(), b.lights.size());
+		for (size_t i = 0; i < a.lights.size(); ++i)
+		{
+			EXPECT_EQ(a.lights[i].name, b.lights[i].name);
+			EXPECT_EQ(a.lights[i].type, b.lights[i].type);
+			EXPECT_EQ(a.lights[i].enabled, b.lights[i].enabled);
+			EXPECT_EQ(a.lights[i].direction, b.lights[i].direction);
+			EXPECT_EQ(a.lights[i].radius, b.lights[i].radius);
+			EXPECT_TRUE(a.lights[i].shadowConfig == b.lights[i].shadowConfig);
+		}
+
+		ASSERT_EQ(a.objects.size(), b.objects.size());
+		for (size_t i = 0; i < a.objects.size(); ++i)
+		{
+			const SceneFileObject& x = a.objects[i];
+			const SceneFileObject& y = b.objects[i];
+			EXPECT_EQ(x.kind, y.kind);
+			EXPECT_EQ(x.name, y.name);
+			EXPECT_EQ(x.visible, y.visible);
+			EXPECT_EQ(x.parent, y.parent);
+			EXPECT_EQ(x.position, y.position);
+			EXPECT_EQ(x.rotation, y.rotation);
+			EXPECT_EQ(x.scale, y.scale);
+			if (x.kind == SceneFileObject::Kind::Model)
+			{
+				EXPECT_EQ(x.source, y.source);
+			}
+			else
+			{
+				EXPECT_EQ(x.primitive, y.primitive);
+				EXPECT_EQ(x.texture, y.texture);
+				EXPECT_EQ(x.pipeline, y.pipeline);
+				EXPECT_EQ(x.customData, y.customData);
+			}
+		}
+	}
+}
+
+TEST(SceneFile, BinaryRoundTrip)
+{
+	const std::string path = TempPath("nb_scene_roundtrip.nbscene");
+	const SceneFileData scene = MakeScene();
+
+	std::string error;
+	ASSERT_TRUE(WriteSceneFile(path, scene, error)) << error;
+
+	SceneFileData loaded;
+	ASSERT_TRUE(ReadSceneFile(path, loaded, error)) << error;
+	ExpectSameScene(scene, loaded);
+	EXPECT_EQ(loaded.editorJson, scene.editorJson);
+
+	std::filesystem::remove(path);
+}
+
+TEST(SceneFile, JsonRoundTrip)
+{
+	const std::string path = TempPath("nb_scene_roundtrip.json");
+	const SceneFileData scene = MakeScene();
+
+	std::string error;
+	ASSERT_TRUE(WriteSceneFile(path, scene, error)) << error;
+
+	std::ifstream in(path);
+	std::string firstChar(1, static_cast<char>(in.get()));
+	EXPECT_EQ(firstChar, "{");
+	in.close();
+
+	SceneFileData loaded;
+	ASSERT_TRUE(ReadSceneFile(path, loaded, error)) << error;
+	ExpectSameScene(scene, loaded);
+
+	std::filesystem::remove(path);
+}
+
+TEST(SceneFile, BinarySharesRepeatedStrings)
+{
+	SceneFileData one = MakeScene();
+	SceneFileData many = one;
+	for (int i = 0; i < 100; ++i)
+	{
+		SceneFileObject tree = one.objects[0];
+		tree.name = "T";
+		many.objects.push_back(tree);
+	}
+
+	const std::string path = TempPath("nb_scene_strings.nbscene");
+	std::string error;
+	ASSERT_TRUE(WriteSceneBinary(path, one, error)) << error;
+	const auto oneSize = std::filesystem::file_size(path);
+	ASSERT_TRUE(WriteSceneBinary(path, many, error)) << error;
+	const auto manySize = std::filesystem::file_size(path);
+
+	// Each extra object costs its fixed records only; name and source are shared
+	EXPECT_LE(manySize - oneSize, 100u * 96u + 1u);
+	std::filesystem::remove(path);
+}
+
+TEST(SceneFile, JsonMissingFieldsKeepDefaults)
+{
+	SceneFileData data;
+	data.camera.fov = 70.0f;
+	data.ambientIntensity = 0.25f;
+
+	std::string error;
+	ASSERT_TRUE(SceneFromJson(R"({"version":1,"objects":[{"kind":"primitive","primitive":"TestCube"}]})", data, error)) << error;
+	EXPECT_EQ(data.camera.fov, 70.0f);
+	EXPECT_EQ(data.ambientIntensity, 0.25f);
+	ASSERT_EQ(data.objects.size(), 1u);
+	EXPECT_EQ(data.objects[0].primitive, "TestCube");
+	EXPECT_EQ(data.objects[0].pipeline, 1);
+	EXPECT_EQ(data.objects[0].scale, glm::vec3(1.0f));
+	EXPECT_TRUE(data.editorJson.empty());
+}
+
+TEST(SceneFile, RejectsBadInput)
+{
+	SceneFileData data;
+	std::string error;
+	EXPECT_FALSE(SceneFromJson("{ not json", data, error));
+	EXPECT_FALSE(error.empty());
+
+	const std::string path = TempPath("nb_scene_truncated.nbscene");
+	ASSERT_TRUE(WriteSceneBinary(path, MakeScene(), error)) << error;
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+	EXPECT_FALSE(ReadSceneFile(path, data, error));
+
+	EXPECT_FALSE(ReadSceneFile(TempPath("nb_scene_missing.nbscene"), data, error));
+	std::filesystem::remove(path);
+}
+
+TEST(SceneFile, PicksEncodingByExtension)
+{
+	EXPECT_TRUE(IsSceneJsonPath("a/b/scene.json"));
+	EXPECT_TRUE(IsSceneJsonPath("scene.JSON"));
+	EXPECT_FALSE(IsSceneJsonPath("scene.nbscene"));
+	EXPECT_FALSE(IsSceneJsonPath("json"));
+}
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// SceneNodesTests.cpp
+//
+// Unit tests for the scene's transform hierarchy and dirty propagation
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SceneNodes.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Nightbloom;
+
+namespace
+{
+	glm::mat4 Translation(float x, float y, float z)
+	{
+		return glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
+	}
+
+	glm::vec3 WorldPosition(const SceneNodes& nodes, uint32_t node)
+	{
+		return glm::vec3(nodes.GetWorld(node)[3]);
+	}
+}
+
+TEST(SceneNodes, ChildWorldFollowsParent)
+{
+	SceneNodes nodes;
+	const uint32_t child = nodes.Add(Translation(1.0f, 0.0f, 0.0f));   // added first: order is not index order
+	const uint32_t parent = nodes.Add(Translation(0.0f, 5.0f, 0.0f));
+	ASSERT_TRUE(nodes.SetParent(child, parent));
+
+	EXPECT_EQ(nodes.Update(), 2u);
+	EXPECT_EQ(WorldPosition(nodes, child), glm::vec3(1.0f, 5.0f, 0.0f));
+
+	nodes.SetLocal(parent, Translation(0.0f, 0.0f, 3.0f));
+	EXPECT_EQ(nodes.Update(), 2u);
+	EXPECT_EQ(WorldPosition(nodes, child), glm::vec3(1.0f, 0.0f, 3.0f));
+}
+
+TEST(SceneNodes, OnlyMovedSubtreesRecompute)
+{
+	SceneNodes nodes;
+	const uint32_t a = nodes.Add();
+	const uint32_t b = nodes.Add();
+	const uint32_t bChild = nodes.Add();
+	nodes.SetParent(bChild, b);
+	nodes.Update();
+
+	EXPECT_EQ(nodes.Update(), 0u);
+
+	nodes.SetLocal(bChild, Translation(2.0f, 0.0f, 0.0f));
+	EXPECT_EQ(nodes.Update(), 1u);
+	ASSERT_EQ(nodes.GetUpdated().size(), 1u);
+	EXPECT_EQ(nodes.GetUpdated()[0], bChild);
+
+	nodes.SetLocal(b, Translation(0.0f, 1.0f, 0.0f));
+	EXPECT_EQ(nodes.Update(), 2u);
+	EXPECT_EQ(WorldPosition(nodes, a), glm::vec3(0.0f));
+	EXPECT_EQ(WorldPosition(nodes, bChild), glm::vec3(2.0f, 1.0f, 0.0f));
+}
+
+TEST(SceneNodes, SetParentRejectsCycles)
+{
+	SceneNodes nodes;
+	const uint32_t root = nodes.Add();
+	const uint32_t mid = nodes.Add();
+	const uint32_t leaf = nodes.Add();
+	ASSERT_TRUE(nodes.SetParent(mid, root));
+	ASSERT_TRUE(nodes.SetParent(leaf, mid));
+
+	EXPECT_FALSE(nodes.SetParent(root, leaf));
+	EXPECT_FALSE(nodes.SetParent(mid, mid));
+	EXPECT_FALSE(nodes.SetParent(leaf, 7u));
+	EXPECT_EQ(nodes.GetParent(root), SceneNodes::INVALID);
+}
+
+TEST(SceneNodes, RemoveReparentsChildrenAndShiftsIndices)
+{
+	SceneNodes nodes;
+	const uint32_t root = nodes.Add(Translation(10.0f, 0.0f, 0.0f));
+	const uint32_t mid = nodes.Add(Translation(0.0f, 10.0f, 0.0f));
+	const uint32_t leaf = nodes.Add(Translation(0.0f, 0.0f, 10.0f));
+	nodes.SetParent(mid, root);
+	nodes.SetParent(leaf, mid);
+	nodes.Update();
+
+	nodes.Remove(mid);
+	ASSERT_EQ(nodes.Size(), 2u);
+	EXPECT_EQ(nodes.GetParent(1), root);   // leaf, now at index 1
+	nodes.Update();
+	EXPECT_EQ(WorldPosition(nodes, 1), glm::vec3(10.0f, 0.0f, 10.0f));
+	EXPECT_EQ(nodes.GetWorldBounds().Size(), 2u);
+}
+
+TEST(SceneNodes, WorldBoundsAndFlags)
+{
+	SceneNodes nodes;
+	const uint32_t parent = nodes.Add(glm::scale(Translation(0.0f, 2.0f, 0.0f), glm::vec3(2.0f)));
+	const uint32_t boxed = nodes.Add(Translation(1.0f, 0.0f, 0.0f));
+	nodes.SetParent(boxed, parent);
+	nodes.SetLocalBounds(boxed, glm::vec3(-1.0f), glm::vec3(1.0f));
+	nodes.SetVisible(parent, false);
+	nodes.Update();
+
+	const AABBBatch& bounds = nodes.GetWorldBounds();
+	EXPECT_FLOAT_EQ(bounds.cx[boxed], 2.0f);
+	EXPECT_FLOAT_EQ(bounds.cy[boxed], 2.0f);
+	EXPECT_FLOAT_EQ(bounds.ex[boxed], 2.0f);
+
+	EXPECT_FALSE(nodes.IsVisible(parent));
+	EXPECT_TRUE(nodes.IsVisible(boxed));
+	EXPECT_EQ(nodes.GetFlags()[parent] & SceneNodes::HasBounds, 0);
+	EXPECT_NE(nodes.GetFlags()[boxed] & SceneNodes::HasBounds, 0);
+	EXPECT_EQ(nodes.GetFlags()[boxed] & SceneNodes::Dirty, 0);
+}
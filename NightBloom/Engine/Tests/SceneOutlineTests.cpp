@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// SceneOutlineTests.cpp
+//
+// Unit tests for the hierarchy panel's flattened rows and sliced search
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SceneOutline.hpp"
+#include <string>
+#include <vector>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct Tree
+	{
+		std::vector<uint32_t> parents;
+		std::vector<std::string> names;
+
+		void Build(SceneOutline& outline) const
+		{
+			outline.Rebuild(static_cast<uint32_t>(parents.size()),
+				[this](uint32_t i) { return parents[i]; },
+				[this](uint32_t i) -> const std::string& { return names[i]; });
+		}
+	};
+
+	constexpr uint32_t ROOT = SceneOutline::NONE;
+
+	// 0 Forest
+	//   2 Oak
+	//     4 Branch
+	//   3 Pine
+	// 1 House
+	//   5 Door
+	Tree MakeTree()
+	{
+		return { { ROOT, ROOT, 0, 0, 2, 1 }, { "Forest", "House", "Oak", "Pine", "Branch", "Door" } };
+	}
+
+	std::vector<uint32_t> RowItems(const SceneOutline& outline)
+	{
+		std::vector<uint32_t> items;
+		for (const SceneOutline::Row& row : outline.GetRows())
+			items.push_back(row.item);
+		return items;
+	}
+}
+
+TEST(SceneOutlineTest, FlattensInPreorderWithDepths)
+{
+	SceneOutline outline;
+	MakeTree().Build(outline);
+
+	EXPECT_EQ(RowItems(outline), (std::vector<uint32_t>{ 0, 2, 4, 3, 1, 5 }));
+	const auto& rows = outline.GetRows();
+	EXPECT_EQ(rows[0].depth, 0u);
+	EXPECT_EQ(rows[1].depth, 1u);
+	EXPECT_EQ(rows[2].depth, 2u);
+	EXPECT_TRUE(rows[1].hasChildren);
+	EXPECT_FALSE(rows[3].hasChildren);
+	EXPECT_EQ(outline.FindRow(1), 4u);
+}
+
+TEST(SceneOutlineTest, CollapsingHidesTheSubtreeAndRevealReopensIt)
+{
+	SceneOutline outline;
+	const Tree tree = MakeTree();
+	tree.Build(outline);
+
+	outline.SetExpanded(0, false);
+	EXPECT_EQ(RowItems(outline), (std::vector<uint32_t>{ 0, 1, 5 }));
+	EXPECT_EQ(outline.FindRow(4), SceneOutline::NONE);
+
+	// Kept across a rebuild
+	tree.Build(outline);
+	EXPECT_FALSE(outline.IsExpanded(0));
+	EXPECT_EQ(outline.GetRows().size(), 3u);
+
+	outline.SetExpanded(2, false);
+	outline.Reveal(4);
+	EXPECT_TRUE(outline.IsExpanded(0));
+	EXPECT_TRUE(outline.IsExpanded(2));
+	EXPECT_EQ(outline.FindRow(4), 2u);
+}
+
+TEST(SceneOutlineTest, SearchRunsInSlicesAndRefines)
+{
+	Tree tree;
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		tree.parents.push_back(ROOT);
+		tree.names.push_back("Rock" + std::to_string(i));
+	}
+	SceneOutline outline;
+	tree.Build(outline);
+
+	outline.SetSearch("ROCK1");
+	EXPECT_FALSE(outline.StepSearch(100));
+	EXPECT_FLOAT_EQ(outline.GetSearchProgress(), 0.1f);
+	while (!outline.StepSearch(100)) {}
+	// Rock1, Rock10-19, Rock100-199
+	EXPECT_EQ(outline.GetMatches().size(), 111u);
+
+	outline.SetSearch("rock12");
+	EXPECT_TRUE(outline.StepSearch(111));
+	EXPECT_EQ(outline.GetMatches(), (std::vector<uint32_t>{ 12, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129 }));
+
+	// Not an extension: searches everything again
+	outline.SetSearch("rock99");
+	EXPECT_FALSE(outline.StepSearch(111));
+	while (!outline.StepSearch(1000)) {}
+	EXPECT_EQ(outline.GetMatches().size(), 11u);
+
+	outline.SetSearch("");
+	EXPECT_FALSE(outline.IsSearching());
+}
+
+TEST(SceneOutlineTest, RebuildRestartsASearchOverTheNewNames)
+{
+	Tree tree = MakeTree();
+	SceneOutline outline;
+	tree.Build(outline);
+
+	outline.SetSearch("o");
+	while (!outline.StepSearch(2)) {}
+	EXPECT_EQ(outline.GetMatches(), (std::vector<uint32_t>{ 0, 2, 1, 5 }));
+
+	tree.names[3] = "Pole";
+	tree.Build(outline);
+	EXPECT_TRUE(outline.GetMatches().empty());
+	while (!outline.StepSearch(2)) {}
+	EXPECT_EQ(outline.GetMatches(), (std::vector<uint32_t>{ 0, 2, 3, 1, 5 }));
+}
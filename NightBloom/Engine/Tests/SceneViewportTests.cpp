@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// SceneViewportTests.cpp
+//
+// Unit tests for the scene viewport's region and target sizing
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/SceneViewport.hpp"
+
+using namespace Nightbloom;
+
+TEST(SceneViewportTest, RegionIsClampedToTheSurface)
+{
+	const glm::uvec2 surface(1920, 1080);
+
+	SceneViewportRect whole = SceneViewport::Clamp(SceneViewportRect{}, surface);
+	EXPECT_EQ(whole, (SceneViewportRect{ 0, 0, 1920, 1080 }));
+
+	SceneViewportRect inside = SceneViewport::Clamp(SceneViewportRect{ 300, 40, 1200, 800 }, surface);
+	EXPECT_EQ(inside, (SceneViewportRect{ 300, 40, 1200, 800 }));
+
+	SceneViewportRect overhang = SceneViewport::Clamp(SceneViewportRect{ -100, 900, 600, 400 }, surface);
+	EXPECT_EQ(overhang, (SceneViewportRect{ 0, 900, 500, 180 }));
+
+	// Entirely off the surface (a panel dragged to another monitor)
+	SceneViewportRect outside = SceneViewport::Clamp(SceneViewportRect{ 2500, 0, 400, 300 }, surface);
+	EXPECT_EQ(outside, whole);
+}
+
+TEST(SceneViewportTest, TargetsFollowTheScale)
+{
+	EXPECT_EQ(SceneViewport::TargetExtent(glm::uvec2(1200, 800), 1.0f), glm::uvec2(1200, 800));
+	EXPECT_EQ(SceneViewport::TargetExtent(glm::uvec2(1200, 800), 0.5f), glm::uvec2(600, 400));
+	EXPECT_EQ(SceneViewport::TargetExtent(glm::uvec2(1200, 800), 10.0f), glm::uvec2(2400, 1600));
+	EXPECT_EQ(SceneViewport::TargetExtent(glm::uvec2(1, 1), 0.25f), glm::uvec2(1, 1));
+}
+
+TEST(SceneViewportTest, NewSizeWaitsToSettle)
+{
+	SceneViewport viewport;
+	SceneViewportSettings settings;
+	settings.settleFrames = 3;
+	viewport.SetSettings(settings);
+
+	const glm::uvec2 surface(1920, 1080);
+	glm::uvec2 current(1920, 1080);
+	EXPECT_FALSE(viewport.Update(surface, current));
+
+	// Dragged every frame: never rebuilt
+	for (uint32_t i = 0; i < 5; ++i)
+	{
+		viewport.SetRegion(SceneViewportRect{ 0, 0, 1000 + i, 700 });
+		EXPECT_FALSE(viewport.Update(surface, current));
+	}
+	EXPECT_EQ(viewport.GetRect().width, 1004u);
+
+	// Then held
+	EXPECT_FALSE(viewport.Update(surface, current));
+	EXPECT_TRUE(viewport.Update(surface, current));
+	EXPECT_EQ(viewport.GetTargetExtent(), glm::uvec2(1004, 700));
+	current = viewport.GetTargetExtent();
+	EXPECT_FALSE(viewport.Update(surface, current));
+
+	// A window resize doesn't wait
+	viewport.SetRegion(SceneViewportRect{});
+	EXPECT_TRUE(viewport.Update(glm::uvec2(1280, 720), current, true));
+	EXPECT_EQ(viewport.GetTargetExtent(), glm::uvec2(1280, 720));
+}
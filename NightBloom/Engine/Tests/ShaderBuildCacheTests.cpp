@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+// ShaderBuildCacheTests.cpp
+//
+// Unit tests for shader include scanning and build keys
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/ShaderBuildCache.hpp"
+#include <algorithm>
+#include <map>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// In-memory shader tree: Shaders/*.vert|frag plus Shaders/Include/*.glsl
+	struct FakeTree
+	{
+		std::map<std::string, std::string> files;
+		int reads = 0;
+
+		ShaderBuildCache MakeCache()
+		{
+			return ShaderBuildCache({ "Shaders/Include" },
+				[this](const std::filesystem::path& path, std::string& out) {
+					auto it = files.find(path.generic_string());
+					if (it == files.end())
+						return false;
+					++reads;
+					out = it->second;
+					return true;
+				});
+		}
+	};
+
+	FakeTree MakeSceneTree()
+	{
+		FakeTree tree;
+		tree.files["Shaders/Include/scene_common.glsl"] = "layout(set = 0) uniform Scene { mat4 view; };\n";
+		tree.files["Shaders/Include/shadows.glsl"] = "#include \"scene_common.glsl\"\nfloat Shadow() { return 1.0; }\n";
+		tree.files["Shaders/Mesh.frag"] = "#version 450\n#include \"shadows.glsl\"\nvoid main() {}\n";
+		tree.files["Shaders/Mesh.vert"] = "#version 450\n#include \"scene_common.glsl\"\nvoid main() {}\n";
+		tree.files["Shaders/Firefly.frag"] = "#version 450\nvoid main() {}\n";
+		return tree;
+	}
+
+	ShaderBuildKey Key(ShaderBuildCache& cache, const char* shader, const std::string& options = "")
+	{
+		ShaderBuildKey key;
+		std::string error;
+		EXPECT_TRUE(cache.ComputeKey(shader, options, key, error)) << error;
+		return key;
+	}
+}
+
+TEST(ShaderBuildCacheTest, ParsesIncludeDirectivesOutsideComments)
+{
+	const char* source =
+		"#version 450\n"
+		"#include \"scene_common.glsl\"\n"
+		"  #  include <shadows.glsl>\n"
+		"// #include \"commented.glsl\"\n"
+		"/* #include \"block.glsl\"\n"
+		"   #include \"still_block.glsl\" */\n"
+		"#include_next \"nope.glsl\"\n"
+		"#define INCLUDE 1\n";
+
+	const std::vector<std::string> includes = ShaderBuildCache::ParseIncludes(source);
+	ASSERT_EQ(includes.size(), 2u);
+	EXPECT_EQ(includes[0], "scene_common.glsl");
+	EXPECT_EQ(includes[1], "shadows.glsl");
+}
+
+TEST(ShaderBuildCacheTest, KeyCoversTransitiveIncludes)
+{
+	FakeTree tree = MakeSceneTree();
+	ShaderBuildCache cache = tree.MakeCache();
+
+	const ShaderBuildKey key = Key(cache, "Shaders/Mesh.frag");
+	ASSERT_EQ(key.files.size(), 3u);
+	EXPECT_EQ(key.files[0].generic_string(), "Shaders/Mesh.frag");
+	EXPECT_EQ(key.files[1].generic_string(), "Shaders/Include/shadows.glsl");
+	EXPECT_EQ(key.files[2].generic_string(), "Shaders/Include/scene_common.glsl");
+
+	// A change two includes deep is a different key
+	tree.files["Shaders/Include/scene_common.glsl"] += "// edited\n";
+	cache.BeginScan();
+	EXPECT_NE(Key(cache, "Shaders/Mesh.frag").hash, key.hash);
+
+	// So are different options
+	cache.BeginScan();
+	EXPECT_NE(Key(cache, "Shaders/Mesh.frag", "-O").hash, Key(cache, "Shaders/Mesh.frag").hash);
+}
+
+TEST(ShaderBuildCacheTest, EditingAnIncludeDirtiesOnlyItsDependents)
+{
+	FakeTree tree = MakeSceneTree();
+	ShaderBuildCache cache = tree.MakeCache();
+	const char* shaders[] = { "Shaders/Mesh.frag", "Shaders/Mesh.vert", "Shaders/Firefly.frag" };
+
+	for (const char* shader : shaders)
+		cache.MarkBuilt(shader, Key(cache, shader));
+
+	// Each file read once per scan, however many shaders share it
+	EXPECT_EQ(tree.reads, 5);
+
+	tree.files["Shaders/Include/shadows.glsl"] += "float Pcf() { return 1.0; }\n";
+	cache.BeginScan();
+
+	EXPECT_FALSE(cache.IsUpToDate("Shaders/Mesh.frag", Key(cache, "Shaders/Mesh.frag")));
+	EXPECT_TRUE(cache.IsUpToDate("Shaders/Mesh.vert", Key(cache, "Shaders/Mesh.vert")));
+	EXPECT_TRUE(cache.IsUpToDate("Shaders/Firefly.frag", Key(cache, "Shaders/Firefly.frag")));
+
+	std::vector<std::filesystem::path> dependents = cache.GetDependents("Shaders/Include/scene_common.glsl");
+	std::sort(dependents.begin(), dependents.end());
+	ASSERT_EQ(dependents.size(), 2u);
+	EXPECT_EQ(dependents[0].generic_string(), "Shaders/Mesh.frag");
+	EXPECT_EQ(dependents[1].generic_string(), "Shaders/Mesh.vert");
+}
+
+TEST(ShaderBuildCacheTest, MissingIncludeAndCyclesAreHandled)
+{
+	FakeTree tree;
+	tree.files["Shaders/Include/a.glsl"] = "#include \"b.glsl\"\n";
+	tree.files["Shaders/Include/b.glsl"] = "#include \"a.glsl\"\n";
+	tree.files["Shaders/Cycle.comp"] = "#include \"a.glsl\"\n";
+	tree.files["Shaders/Broken.comp"] = "#include \"missing.glsl\"\n";
+	ShaderBuildCache cache = tree.MakeCache();
+
+	EXPECT_EQ(Key(cache, "Shaders/Cycle.comp").files.size(), 3u);
+
+	ShaderBuildKey key;
+	std::string error;
+	EXPECT_FALSE(cache.ComputeKey("Shaders/Broken.comp", "", key, error));
+	EXPECT_NE(error.find("missing.glsl"), std::string::npos);
+}
+
+TEST(ShaderBuildCacheTest, CachedSpirvPathIsContentAddressed)
+{
+	const std::filesystem::path path =
+		ShaderBuildCache::GetCachedSpirvPath("Cache", "Shaders/Mesh.frag", 0x1234abcdull);
+	EXPECT_EQ(path.generic_string(), "Cache/Mesh.frag-000000001234abcd.spv");
+}
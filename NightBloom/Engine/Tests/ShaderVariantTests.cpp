@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+// ShaderVariantTests.cpp
+//
+// Unit tests for shader feature masks and specialization constant layout
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/ShaderVariant.hpp"
+
+using namespace Nightbloom;
+
+TEST(ShaderVariantTest, MasksOnlyTheFeaturesATypeReads)
+{
+	const ShaderVariantKey lit = GetShaderFeatureMask(PipelineType::Mesh);
+	EXPECT_NE(lit & ToVariantBit(ShaderFeature::ShadowPcf), 0u);
+	EXPECT_NE(lit & ToVariantBit(ShaderFeature::CascadeDebug), 0u);
+	EXPECT_EQ(lit & ToVariantBit(ShaderFeature::Fxaa), 0u);
+
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::Terrain), lit);
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::PostProcess) & ~ToVariantBit(ShaderFeature::HalfPrecision),
+		ToVariantBit(ShaderFeature::Fxaa) | ToVariantBit(ShaderFeature::Tonemap));
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::Shadow), 0u);
+	// The EQUAL twins shade like their base type; the depth-only ones don't shade
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::FoliageEqual), GetShaderFeatureMask(PipelineType::Foliage));
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::MeshDepth), 0u);
+
+	// Toggling FXAA leaves the Mesh variant key unchanged
+	const ShaderVariantKey withoutFxaa = DEFAULT_SHADER_VARIANT & ~ToVariantBit(ShaderFeature::Fxaa);
+	EXPECT_EQ(DEFAULT_SHADER_VARIANT & lit, withoutFxaa & lit);
+}
+
+TEST(ShaderVariantTest, SpecializationHasOneBoolPerMaskedFeature)
+{
+	const ShaderVariantKey mask = GetShaderFeatureMask(PipelineType::PostProcess);
+	const SpecializationData data = BuildSpecialization(ToVariantBit(ShaderFeature::Tonemap), mask);
+
+	ASSERT_EQ(data.entries.size(), 2u);
+	ASSERT_EQ(data.values.size(), 2u);
+
+	EXPECT_EQ(data.entries[0].constantId, 2u);   // Fxaa
+	EXPECT_EQ(data.entries[0].offset, 0u);
+	EXPECT_EQ(data.entries[0].size, 4u);
+	EXPECT_EQ(data.values[0], 0u);
+
+	EXPECT_EQ(data.entries[1].constantId, 3u);   // Tonemap
+	EXPECT_EQ(data.entries[1].offset, 4u);
+	EXPECT_EQ(data.values[1], 1u);
+
+	EXPECT_TRUE(BuildSpecialization(DEFAULT_SHADER_VARIANT, 0).IsEmpty());
+}
+
+TEST(ShaderVariantTest, DescribesKeys)
+{
+	EXPECT_EQ(DescribeShaderVariant(0), "none");
+	EXPECT_EQ(DescribeShaderVariant(DEFAULT_SHADER_VARIANT), "ShadowPcf+Fxaa+Tonemap");
+}
+
+TEST(ShaderVariantTest, HalfPrecisionPicksAModuleNotAConstant)
+{
+	const ShaderVariantKey half = ToVariantBit(ShaderFeature::HalfPrecision);
+	EXPECT_NE(GetShaderFeatureMask(PipelineType::Foliage) & half, 0u);
+	EXPECT_NE(GetShaderFeatureMask(PipelineType::PostProcess) & half, 0u);
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::Mesh) & half, 0u);
+	EXPECT_EQ(DEFAULT_SHADER_VARIANT & half, 0u);
+
+	// No specialization constant for it
+	const SpecializationData data = BuildSpecialization(half, half);
+	EXPECT_TRUE(data.IsEmpty());
+	EXPECT_EQ(BuildSpecialization(half, GetShaderFeatureMask(PipelineType::PostProcess)).entries.size(), 2u);
+
+	EXPECT_EQ(GetShaderBuildName("Grass.frag", ShaderBuild::HalfPrecision), "Grass.frag.fp16");
+	EXPECT_EQ(GetShaderBuildName("Shaders/PostProcess.frag.spv", ShaderBuild::HalfPrecision), "Shaders/PostProcess.frag.fp16.spv");
+	EXPECT_TRUE(HasShaderBuild("Grass.frag", ShaderBuild::HalfPrecision));
+	EXPECT_FALSE(HasShaderBuild("Mesh.frag", ShaderBuild::HalfPrecision));
+	EXPECT_EQ(DescribeShaderVariant(half), "HalfPrecision");
+}
+
+TEST(ShaderVariantTest, SubgroupBuildsOnlyForTheKernelsThatHaveOne)
+{
+	EXPECT_STREQ(GetShaderBuildDefine(ShaderBuild::SubgroupOps), "NB_SUBGROUP_OPS");
+	EXPECT_STREQ(GetShaderBuildDefine(ShaderBuild::HalfPrecision), "NB_HALF_PRECISION");
+
+	EXPECT_TRUE(HasShaderBuild("GrassCull.comp", ShaderBuild::SubgroupOps));
+	EXPECT_TRUE(HasShaderBuild("Shaders\\FireflyGrid.comp.spv", ShaderBuild::SubgroupOps));
+	EXPECT_FALSE(HasShaderBuild("FireflyUpdate.comp", ShaderBuild::SubgroupOps));
+	EXPECT_FALSE(HasShaderBuild("Grass.frag", ShaderBuild::SubgroupOps));
+
+	EXPECT_EQ(SelectSubgroupShader("MeshletCull.comp.spv", true), "MeshletCull.comp.subgroup.spv");
+	EXPECT_EQ(SelectSubgroupShader("MeshletCull.comp.spv", false), "MeshletCull.comp.spv");
+	EXPECT_EQ(SelectSubgroupShader("FireflyUpdate.comp.spv", true), "FireflyUpdate.comp.spv");
+}
+
+TEST(ShaderVariantTest, RayQueryShadowIsALitModuleFeature)
+{
+	const ShaderVariantKey rayQuery = ToVariantBit(ShaderFeature::RayQueryShadow);
+	EXPECT_NE(GetShaderFeatureMask(PipelineType::Mesh) & rayQuery, 0u);
+	EXPECT_NE(GetShaderFeatureMask(PipelineType::Foliage) & rayQuery, 0u);
+	EXPECT_NE(GetShaderFeatureMask(PipelineType::TerrainEqual) & rayQuery, 0u);
+	// The OIT twins shade with MeshOit.frag, which samples the sun's shadow too
+	EXPECT_NE(GetShaderFeatureMask(PipelineType::TransparentOit) & rayQuery, 0u);
+	EXPECT_EQ(GetShaderFeatureMask(PipelineType::PostProcess) & rayQuery, 0u);
+	EXPECT_EQ(DEFAULT_SHADER_VARIANT & rayQuery, 0u);
+
+	// Picks a module: the lit types keep two constants
+	EXPECT_EQ(BuildSpecialization(rayQuery, GetShaderFeatureMask(PipelineType::Mesh)).entries.size(), 2u);
+
+	EXPECT_STREQ(GetShaderBuildDefine(ShaderBuild::RayQuery), "NB_RAY_QUERY");
+	EXPECT_EQ(GetShaderBuildName("Shaders/MeshOit.frag.spv", ShaderBuild::RayQuery), "Shaders/MeshOit.frag.rayquery.spv");
+	EXPECT_TRUE(HasShaderBuild("MeshBindless.frag", ShaderBuild::RayQuery));
+	EXPECT_TRUE(HasShaderBuild("Terrain.frag.spv", ShaderBuild::RayQuery));
+	EXPECT_FALSE(HasShaderBuild("Water.frag", ShaderBuild::RayQuery));
+	EXPECT_EQ(DescribeShaderVariant(rayQuery | ToVariantBit(ShaderFeature::ShadowPcf)), "ShadowPcf+RayQueryShadow");
+}
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// ShadowCascadeCacheTests.cpp
+//
+// Unit tests for per-cascade shadow refit scheduling
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/ShadowCascadeCache.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	constexpr uint32_t ALL_CASCADES = (1u << NUM_CASCADES) - 1;
+
+	struct Slices
+	{
+		glm::vec3 centers[NUM_CASCADES];
+		float radii[NUM_CASCADES];
+
+		Slices()
+		{
+			for (uint32_t c = 0; c < NUM_CASCADES; ++c)
+			{
+				centers[c] = glm::vec3(0.0f, 0.0f, -10.0f * (c + 1));
+				radii[c] = 10.0f * (c + 1);
+			}
+		}
+	};
+
+	ShadowConfig CachingConfig()
+	{
+		ShadowConfig config;
+		config.cacheFarCascades = true;
+		config.nearCascadesPerFrame = 2;
+		config.farCascadeRefreshFrames = 4;
+		config.cacheLightAngleDeg = 1.0f;
+		config.cachePadding = 0.1f;
+		return config;
+	}
+
+	const glm::vec3 kDown(0.0f, -1.0f, 0.0f);
+}
+
+TEST(ShadowCascadeCacheTest, FirstFrameRefitsEverything)
+{
+	ShadowCascadeCache cache;
+	Slices slices;
+
+	EXPECT_EQ(cache.Update(CachingConfig(), kDown, slices.centers, slices.radii), ALL_CASCADES);
+	EXPECT_EQ(cache.Update(CachingConfig(), kDown, slices.centers, slices.radii), 0b0011u);
+}
+
+TEST(ShadowCascadeCacheTest, DisabledCachingRefitsEveryFrame)
+{
+	ShadowConfig config = CachingConfig();
+	config.cacheFarCascades = false;
+	EXPECT_EQ(ShadowCascadeCache::FirstCachedCascade(config), NUM_CASCADES);
+
+	ShadowCascadeCache cache;
+	Slices slices;
+	cache.Update(config, kDown, slices.centers, slices.radii);
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), ALL_CASCADES);
+}
+
+TEST(ShadowCascadeCacheTest, FarCascadesRefitRoundRobin)
+{
+	ShadowCascadeCache cache;
+	Slices slices;
+	const ShadowConfig config = CachingConfig();
+
+	cache.Update(config, kDown, slices.centers, slices.radii);
+	for (int frame = 1; frame < 4; ++frame)
+		EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), 0b0011u);
+
+	// Both far cascades are due on frame 4; only one refits per frame
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), 0b0111u);
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), 0b1011u);
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), 0b0011u);
+}
+
+TEST(ShadowCascadeCacheTest, DriftInsidePaddingKeepsTheCache)
+{
+	ShadowCascadeCache cache;
+	Slices slices;
+	const ShadowConfig config = CachingConfig();
+	cache.Update(config, kDown, slices.centers, slices.radii);
+
+	// Cascade 2 (radius 30) may drift 3 units before leaving its padded sphere
+	slices.centers[2].x += 2.5f;
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), 0b0011u);
+
+	slices.centers[2].x += 1.0f;
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), 0b0111u);
+}
+
+TEST(ShadowCascadeCacheTest, LightTurnMakesCascadesDue)
+{
+	ShadowCascadeCache cache;
+	Slices slices;
+	const ShadowConfig config = CachingConfig();
+	cache.Update(config, kDown, slices.centers, slices.radii);
+
+	const glm::vec3 turned = glm::normalize(glm::vec3(0.05f, -1.0f, 0.0f));  // ~2.9 degrees
+	EXPECT_EQ(cache.Update(config, turned, slices.centers, slices.radii), 0b0111u);
+	EXPECT_EQ(cache.Update(config, turned, slices.centers, slices.radii), 0b1011u);
+	EXPECT_EQ(cache.Update(config, turned, slices.centers, slices.radii), 0b0011u);
+}
+
+TEST(ShadowCascadeCacheTest, InvalidateRefitsEverything)
+{
+	ShadowCascadeCache cache;
+	Slices slices;
+	const ShadowConfig config = CachingConfig();
+	cache.Update(config, kDown, slices.centers, slices.radii);
+	cache.Update(config, kDown, slices.centers, slices.radii);
+
+	cache.Invalidate();
+	EXPECT_EQ(cache.Update(config, kDown, slices.centers, slices.radii), ALL_CASCADES);
+}
+
+TEST(ShadowCascadeCacheTest, RegionTouchesOnlyCachedCascadesThatSeeIt)
+{
+	ShadowCascadeCache cache;
+	Slices slices;
+	const ShadowConfig config = CachingConfig();
+	const glm::vec3 boxMin(-1.0f, -50.0f, -71.0f);
+	const glm::vec3 boxMax(1.0f, 50.0f, -69.0f);
+
+	// Nothing fitted yet: nothing cached to re-render
+	EXPECT_EQ(cache.CascadesTouching(config, boxMin, boxMax), 0u);
+
+	cache.Update(config, kDown, slices.centers, slices.radii);
+
+	// 40 units across the light from cascade 2 (padded radius 33), 30 from
+	// cascade 3 (44); height along the light doesn't matter
+	EXPECT_EQ(cache.CascadesTouching(config, boxMin, boxMax), 0b1000u);
+
+	// Far outside every cascade
+	EXPECT_EQ(cache.CascadesTouching(config, glm::vec3(500.0f, 0.0f, 0.0f), glm::vec3(501.0f, 1.0f, 1.0f)), 0u);
+}
@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+// ShadowCascadeResolutionTests.cpp
+//
+// Unit tests for per-cascade shadow resolution: texel counts and the
+// projection squeeze into a layer's corner
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/ShadowCascadeResolution.hpp"
+
+using namespace Nightbloom;
+
+TEST(ShadowCascadeResolutionTest, TexelsFollowTheScale)
+{
+	EXPECT_EQ(ShadowCascadeTexels(2048, 1.0f), 2048u);
+	EXPECT_EQ(ShadowCascadeTexels(2048, 0.5f), 1024u);
+	EXPECT_EQ(ShadowCascadeTexels(2048, 0.25f), 512u);
+
+	// Aligned, clamped to the layer and to the minimum
+	EXPECT_EQ(ShadowCascadeTexels(2048, 0.3f) % SHADOW_CASCADE_TEXEL_ALIGN, 0u);
+	EXPECT_EQ(ShadowCascadeTexels(2048, 4.0f), 2048u);
+	EXPECT_EQ(ShadowCascadeTexels(2048, 0.0f), SHADOW_CASCADE_MIN_TEXELS);
+	EXPECT_EQ(ShadowCascadeTexels(128, 1.0f), 128u);
+}
+
+TEST(ShadowCascadeResolutionTest, FullScaleLeavesTheProjectionAlone)
+{
+	const glm::mat4 viewport = ShadowCascadeViewport(2048, 2048);
+	for (int c = 0; c < 4; ++c)
+		for (int r = 0; r < 4; ++r)
+			EXPECT_FLOAT_EQ(viewport[c][r], c == r ? 1.0f : 0.0f);
+}
+
+TEST(ShadowCascadeResolutionTest, SqueezesIntoTheTopLeftCorner)
+{
+	const glm::mat4 viewport = ShadowCascadeViewport(512, 2048);
+
+	// The layer's NDC corners land on the corner's
+	const glm::vec4 topLeft = viewport * glm::vec4(-1.0f, -1.0f, 0.5f, 1.0f);
+	const glm::vec4 bottomRight = viewport * glm::vec4(1.0f, 1.0f, 0.5f, 1.0f);
+	EXPECT_FLOAT_EQ(topLeft.x, -1.0f);
+	EXPECT_FLOAT_EQ(topLeft.y, -1.0f);
+	EXPECT_FLOAT_EQ(bottomRight.x, -0.5f);
+	EXPECT_FLOAT_EQ(bottomRight.y, -0.5f);
+	EXPECT_FLOAT_EQ(bottomRight.z, 0.5f);
+
+	// As texture coordinates: [0, texels / layer]
+	EXPECT_FLOAT_EQ(bottomRight.x * 0.5f + 0.5f, 0.25f);
+
+	// Homogeneous: holds for any w
+	const glm::vec4 scaled = viewport * glm::vec4(2.0f, 2.0f, 1.0f, 2.0f);
+	EXPECT_FLOAT_EQ(scaled.x / scaled.w, -0.5f);
+}
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+// ShadowDepthBoundsTests.cpp
+//
+// Unit tests for the depth range the shadow cascades are split over
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/ShadowDepthBounds.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	constexpr float CAMERA_NEAR = 0.1f;
+
+	// Reverse-Z depth of a view distance
+	float DepthAt(float distance)
+	{
+		return CAMERA_NEAR / distance;
+	}
+}
+
+TEST(ShadowDepthBoundsTest, DepthToViewDistance)
+{
+	EXPECT_FLOAT_EQ(ShadowDepthToViewDistance(1.0f, CAMERA_NEAR), CAMERA_NEAR);
+	EXPECT_FLOAT_EQ(ShadowDepthToViewDistance(DepthAt(40.0f), CAMERA_NEAR), 40.0f);
+	EXPECT_TRUE(std::isinf(ShadowDepthToViewDistance(0.0f, CAMERA_NEAR)));
+}
+
+TEST(ShadowDepthBoundsTest, FullRangeWithoutAMeasurement)
+{
+	ShadowDepthBounds bounds;
+	float nearBound = 0.0f, farBound = 0.0f;
+	bounds.Resolve(CAMERA_NEAR, 200.0f, nearBound, farBound);
+	EXPECT_FLOAT_EQ(nearBound, CAMERA_NEAR);
+	EXPECT_FLOAT_EQ(farBound, 200.0f);
+
+	// Only sky: still nothing to tighten to
+	bounds.Update(0.0f, 0.0f, CAMERA_NEAR);
+	EXPECT_FALSE(bounds.IsValid());
+}
+
+TEST(ShadowDepthBoundsTest, PaddedRangeCoversTheMeasuredOne)
+{
+	ShadowDepthBounds bounds;
+	bounds.Update(DepthAt(5.0f), DepthAt(40.0f), CAMERA_NEAR);
+	ASSERT_TRUE(bounds.IsValid());
+
+	float nearBound = 0.0f, farBound = 0.0f;
+	bounds.Resolve(CAMERA_NEAR, 200.0f, nearBound, farBound);
+	EXPECT_LE(nearBound, 5.0f / (1.0f + SHADOW_DEPTH_BOUNDS_PADDING));
+	EXPECT_GE(farBound, 40.0f * (1.0f + SHADOW_DEPTH_BOUNDS_PADDING));
+
+	// No more than one grid step wider than the padding asks
+	const float step = std::exp2(1.0f / SHADOW_DEPTH_BOUNDS_STEPS_PER_OCTAVE);
+	EXPECT_GT(nearBound * step, 5.0f / (1.0f + SHADOW_DEPTH_BOUNDS_PADDING));
+	EXPECT_LT(farBound / step, 40.0f * (1.0f + SHADOW_DEPTH_BOUNDS_PADDING));
+}
+
+TEST(ShadowDepthBoundsTest, GrowsAtOnceAndShrinksLazily)
+{
+	ShadowDepthBounds bounds;
+	bounds.Update(DepthAt(5.0f), DepthAt(40.0f), CAMERA_NEAR);
+	const float farBefore = bounds.GetFar();
+	const float nearBefore = bounds.GetNear();
+
+	// A little nearer geometry leaves the far bound, however it rounds
+	bounds.Update(DepthAt(5.0f), DepthAt(39.0f), CAMERA_NEAR);
+	EXPECT_FLOAT_EQ(bounds.GetFar(), farBefore);
+
+	// Anything past the bound takes it along immediately
+	bounds.Update(DepthAt(5.0f), DepthAt(60.0f), CAMERA_NEAR);
+	EXPECT_GE(bounds.GetFar(), 60.0f * (1.0f + SHADOW_DEPTH_BOUNDS_PADDING));
+	bounds.Update(DepthAt(2.0f), DepthAt(60.0f), CAMERA_NEAR);
+	EXPECT_LE(bounds.GetNear(), 2.0f / (1.0f + SHADOW_DEPTH_BOUNDS_PADDING));
+
+	// A large retreat tightens again
+	bounds.Update(DepthAt(5.0f), DepthAt(40.0f), CAMERA_NEAR);
+	EXPECT_FLOAT_EQ(bounds.GetFar(), farBefore);
+	EXPECT_FLOAT_EQ(bounds.GetNear(), nearBefore);
+}
+
+TEST(ShadowDepthBoundsTest, ResolveStaysInsideTheShadowDistance)
+{
+	ShadowDepthBounds bounds;
+	bounds.Update(DepthAt(10.0f), DepthAt(500.0f), CAMERA_NEAR);
+
+	float nearBound = 0.0f, farBound = 0.0f;
+	bounds.Resolve(CAMERA_NEAR, 200.0f, nearBound, farBound);
+	EXPECT_LT(nearBound, 10.0f);
+	EXPECT_FLOAT_EQ(farBound, 200.0f);
+
+	// Everything visible lies past the shadow distance: the full range
+	bounds.Reset();
+	bounds.Update(DepthAt(300.0f), DepthAt(500.0f), CAMERA_NEAR);
+	bounds.Resolve(CAMERA_NEAR, 200.0f, nearBound, farBound);
+	EXPECT_FLOAT_EQ(nearBound, CAMERA_NEAR);
+	EXPECT_FLOAT_EQ(farBound, 200.0f);
+}
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// SharedAssetCacheTests.cpp
+//
+// Unit tests for the path-keyed cache that lets scene objects share assets
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SharedAssetCache.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct FakeAsset
+	{
+		int id = 0;
+	};
+}
+
+TEST(SharedAssetCacheTest, SecondAcquireSharesTheFirst)
+{
+	SharedAssetCache<FakeAsset> cache;
+	int creates = 0;
+	auto create = [&]() { ++creates; return std::make_shared<FakeAsset>(FakeAsset{ creates }); };
+
+	std::shared_ptr<FakeAsset> a = cache.Acquire("Assets/Models/Car.gltf", create);
+	std::shared_ptr<FakeAsset> b = cache.Acquire("Assets/Models/Car.gltf", create);
+
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(creates, 1);
+	EXPECT_EQ(cache.GetHitCount(), 1u);
+	EXPECT_EQ(cache.GetMissCount(), 1u);
+	EXPECT_EQ(cache.GetLiveCount(), 1u);
+}
+
+TEST(SharedAssetCacheTest, PathsAreComparedNormalized)
+{
+	SharedAssetCache<FakeAsset> cache;
+	auto create = []() { return std::make_shared<FakeAsset>(); };
+
+	std::shared_ptr<FakeAsset> a = cache.Acquire("Assets/Models/./Car.gltf", create);
+	std::shared_ptr<FakeAsset> b = cache.Acquire("Assets/Textures/../Models/Car.gltf", create);
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(cache.Find("Assets/Models/Car.gltf"), a);
+	EXPECT_EQ(cache.Find("Assets/Models/Bus.gltf"), nullptr);
+}
+
+TEST(SharedAssetCacheTest, CacheDoesNotKeepAssetsAlive)
+{
+	SharedAssetCache<FakeAsset> cache;
+	int creates = 0;
+	auto create = [&]() { ++creates; return std::make_shared<FakeAsset>(); };
+
+	std::weak_ptr<FakeAsset> watch;
+	{
+		std::shared_ptr<FakeAsset> a = cache.Acquire("a.gltf", create);
+		watch = a;
+	}
+	EXPECT_TRUE(watch.expired());
+	EXPECT_EQ(cache.Find("a.gltf"), nullptr);
+	EXPECT_EQ(cache.GetLiveCount(), 0u);
+
+	// Loaded again once no one holds it
+	std::shared_ptr<FakeAsset> again = cache.Acquire("a.gltf", create);
+	EXPECT_NE(again, nullptr);
+	EXPECT_EQ(creates, 2);
+}
+
+TEST(SharedAssetCacheTest, FailedCreatesAreNotRemembered)
+{
+	SharedAssetCache<FakeAsset> cache;
+	EXPECT_EQ(cache.Acquire("missing.gltf", []() { return std::shared_ptr<FakeAsset>(); }), nullptr);
+
+	std::shared_ptr<FakeAsset> later = cache.Acquire("missing.gltf", []() { return std::make_shared<FakeAsset>(); });
+	EXPECT_NE(later, nullptr);
+	EXPECT_EQ(cache.GetMissCount(), 2u);
+}
+
+TEST(SharedAssetCacheTest, PruneDropsExpiredEntries)
+{
+	SharedAssetCache<FakeAsset> cache;
+	auto create = []() { return std::make_shared<FakeAsset>(); };
+
+	std::shared_ptr<FakeAsset> kept = cache.Acquire("kept.gltf", create);
+	cache.Acquire("dropped.gltf", create);
+
+	EXPECT_EQ(cache.Prune(), 1u);
+	EXPECT_EQ(cache.Find("kept.gltf"), kept);
+
+	cache.Clear();
+	EXPECT_EQ(cache.Find("kept.gltf"), nullptr);
+	EXPECT_EQ(kept.use_count(), 1);
+}
+
+TEST(SharedAssetCacheTest, ForEachVisitsOnlyLiveAssets)
+{
+	SharedAssetCache<FakeAsset> cache;
+	auto create = []() { return std::make_shared<FakeAsset>(); };
+
+	std::shared_ptr<FakeAsset> kept = cache.Acquire("Models/./kept.gltf", create);
+	cache.Acquire("dropped.gltf", create);
+
+	std::vector<std::string> keys;
+	cache.ForEach([&](const std::string& key, const std::shared_ptr<FakeAsset>& asset)
+		{
+			keys.push_back(key);
+			EXPECT_EQ(asset, kept);
+		});
+	EXPECT_EQ(keys, (std::vector<std::string>{ "Models/kept.gltf" }));
+}
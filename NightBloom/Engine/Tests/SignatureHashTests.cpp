@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+// SignatureHashTests.cpp
+//
+// Unit tests for the signatures cached recordings are keyed by
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Components/SignatureHash.hpp"
+
+using namespace Nightbloom;
+
+TEST(SignatureHashTest, MixesEveryByte)
+{
+	SignatureHash empty, zero, one;
+	zero.Mix(uint32_t{ 0 });
+	one.Mix(uint32_t{ 1u << 24 });
+	EXPECT_EQ(empty.Get(), SignatureHash::OFFSET_BASIS);
+	EXPECT_NE(zero.Get(), empty.Get());
+	EXPECT_NE(zero.Get(), one.Get());
+}
+
+TEST(SignatureHashTest, SameInputsSameSignature)
+{
+	SignatureHash a, b;
+	a.Mix(uint32_t{ 42 });
+	a.Mix(3.5f);
+	b.Mix(uint32_t{ 42 });
+	b.Mix(3.5f);
+	EXPECT_EQ(a.Get(), b.Get());
+
+	// Seeding with one signature chains it into another
+	SignatureHash chained(a.Get());
+	chained.Mix(uint64_t{ 7 });
+	EXPECT_NE(chained.Get(), a.Get());
+}
+
+TEST(SignatureHashTest, OrderAndValuesMatter)
+{
+	SignatureHash a, b, c;
+	a.Mix(uint32_t{ 1 });
+	a.Mix(uint32_t{ 2 });
+	b.Mix(uint32_t{ 2 });
+	b.Mix(uint32_t{ 1 });
+	c.Mix(uint32_t{ 1 });
+	c.Mix(uint32_t{ 3 });
+	EXPECT_NE(a.Get(), b.Get());
+	EXPECT_NE(a.Get(), c.Get());
+}
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+// SimdMathTests.cpp
+//
+// Unit tests for the SIMD math kernels against their scalar glm equivalents
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Math/SimdMath.hpp"
+#include "../Renderer/Frustum.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+using namespace Nightbloom;
+
+namespace
+{
+	void ExpectNear(const glm::mat4& a, const glm::mat4& b, float tolerance)
+	{
+		for (int c = 0; c < 4; ++c)
+			for (int r = 0; r < 4; ++r)
+				EXPECT_NEAR(a[c][r], b[c][r], tolerance) << "column " << c << ", row " << r;
+	}
+
+	glm::mat4 SomeTransform()
+	{
+		glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(3.0f, -2.0f, 7.5f));
+		m = glm::rotate(m, 0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, -0.5f)));
+		return glm::scale(m, glm::vec3(2.0f, 0.5f, 1.5f));
+	}
+
+	Frustum SomeFrustum()
+	{
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+		return Frustum::ExtractFromMatrix(proj * view);
+	}
+}
+
+TEST(SimdMath, MultiplyMatchesGlm)
+{
+	glm::mat4 view = glm::lookAt(glm::vec3(4.0f, 3.0f, -2.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 proj = glm::perspective(glm::radians(70.0f), 1.5f, 0.1f, 100.0f);
+	ExpectNear(Simd::Multiply(proj, view), proj * view, 1e-5f);
+	ExpectNear(Simd::Multiply(SomeTransform(), view), SomeTransform() * view, 1e-5f);
+}
+
+TEST(SimdMath, InverseMatchesGlm)
+{
+	const glm::mat4 transform = SomeTransform();
+	ExpectNear(Simd::Inverse(transform), glm::inverse(transform), 1e-4f);
+
+	glm::mat4 proj = glm::perspective(glm::radians(70.0f), 1.5f, 0.1f, 100.0f);
+	ExpectNear(Simd::Inverse(proj), glm::inverse(proj), 1e-4f);
+	ExpectNear(Simd::Multiply(proj, Simd::Inverse(proj)), glm::mat4(1.0f), 1e-4f);
+}
+
+TEST(SimdMath, TransformAABBMatchesScalar)
+{
+	const glm::mat4 transform = SomeTransform();
+	const glm::vec3 localMin(-1.0f, -0.5f, -2.0f), localMax(3.0f, 1.0f, 0.5f);
+
+	glm::vec3 center, extents;
+	Simd::TransformAABB(localMin, localMax, transform, center, extents);
+
+	const glm::vec3 expectedCenter = glm::vec3(transform * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+	const glm::mat3 absRotScale(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])),
+		glm::abs(glm::vec3(transform[2])));
+	const glm::vec3 expectedExtents = absRotScale * ((localMax - localMin) * 0.5f);
+	for (int i = 0; i < 3; ++i)
+	{
+		EXPECT_NEAR(center[i], expectedCenter[i], 1e-5f);
+		EXPECT_NEAR(extents[i], expectedExtents[i], 1e-5f);
+	}
+}
+
+TEST(SimdMath, IntersectsBatchMatchesIntersects)
+{
+	const Frustum frustum = SomeFrustum();
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+	// Not a multiple of any batch width
+	AABBBatch boxes;
+	std::vector<glm::vec3> centers, extents;
+	for (int i = 0; i < 1001; ++i)
+	{
+		centers.emplace_back(position(rng), position(rng) * 0.2f, position(rng));
+		extents.emplace_back(size(rng), size(rng), size(rng));
+		boxes.Add(centers.back(), extents.back());
+	}
+	ASSERT_EQ(boxes.Size(), 1001u);
+
+	std::vector<uint8_t> visible(boxes.Size(), 2);
+	frustum.IntersectsBatch(boxes, visible.data());
+
+	size_t visibleCount = 0;
+	for (size_t i = 0; i < boxes.Size(); ++i)
+	{
+		EXPECT_EQ(visible[i] != 0, frustum.Intersects(centers[i], extents[i])) << "box " << i;
+		visibleCount += visible[i];
+	}
+	// Both outcomes are exercised
+	EXPECT_GT(visibleCount, 0u);
+	EXPECT_LT(visibleCount, boxes.Size());
+}
+
+TEST(SimdMath, AABBBatchClearKeepsCapacity)
+{
+	AABBBatch boxes;
+	boxes.Add(glm::vec3(1.0f), glm::vec3(1.0f));
+	boxes.Add(glm::vec3(2.0f), glm::vec3(1.0f));
+	const size_t capacity = boxes.cx.size();
+
+	boxes.Clear();
+	EXPECT_EQ(boxes.Size(), 0u);
+	boxes.Add(glm::vec3(3.0f), glm::vec3(0.5f));
+	EXPECT_EQ(boxes.Size(), 1u);
+	EXPECT_EQ(boxes.cx.size(), capacity);
+	EXPECT_EQ(boxes.cx[0], 3.0f);
+}
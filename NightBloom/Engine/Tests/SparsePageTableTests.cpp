@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+// SparsePageTableTests.cpp
+//
+// Unit tests for sparse image page residency
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/SparsePageTable.hpp"
+
+using namespace Nightbloom;
+
+TEST(SparsePageTableTest, RequestsCoverEveryOverlappedPage)
+{
+	SparsePageTable table;
+	table.Reset(512, 256, 1, 128, 128, 1);
+	EXPECT_EQ(table.GetPagesX(), 4u);
+	EXPECT_EQ(table.GetPagesY(), 2u);
+	EXPECT_EQ(table.GetPageCount(), 8u);
+
+	// Straddles pages 1 and 2 of the first row and the same of the second
+	table.Request({ 200, 100, 0, 100, 50, 1 });
+
+	std::vector<uint32_t> bind, release;
+	table.Commit(bind, release);
+	EXPECT_EQ(bind, (std::vector<uint32_t>{ 1, 2, 5, 6 }));
+	EXPECT_TRUE(release.empty());
+	EXPECT_EQ(table.GetResidentCount(), 4u);
+	EXPECT_TRUE(table.IsResident(5));
+	EXPECT_FALSE(table.IsResident(0));
+
+	// A bind that failed is retried by the next commit still asking for it
+	table.MarkUnbound(5);
+	EXPECT_EQ(table.GetResidentCount(), 3u);
+	table.Request({ 200, 100, 0, 100, 50, 1 });
+	table.Commit(bind, release);
+	EXPECT_EQ(bind, (std::vector<uint32_t>{ 5 }));
+	EXPECT_TRUE(release.empty());
+}
+
+TEST(SparsePageTableTest, UnrequestedPagesAreReleasedOnTheNextCommit)
+{
+	SparsePageTable table;
+	table.Reset(256, 256, 1, 128, 128, 1);
+	std::vector<uint32_t> bind, release;
+
+	table.RequestAll();
+	table.Commit(bind, release);
+	EXPECT_EQ(bind.size(), 4u);
+
+	// Still wanted pages bind nothing new
+	table.Request({ 0, 0, 0, 128, 128, 1 });
+	table.Commit(bind, release);
+	EXPECT_TRUE(bind.empty());
+	EXPECT_EQ(release, (std::vector<uint32_t>{ 1, 2, 3 }));
+	EXPECT_EQ(table.GetResidentCount(), 1u);
+
+	// Nothing requested: everything goes
+	table.Commit(bind, release);
+	EXPECT_EQ(release, (std::vector<uint32_t>{ 0 }));
+	EXPECT_EQ(table.GetResidentCount(), 0u);
+}
+
+TEST(SparsePageTableTest, EdgePagesAreClippedAndOutsideRequestsIgnored)
+{
+	SparsePageTable table;
+	table.Reset(300, 100, 40, 128, 64, 32);
+	EXPECT_EQ(table.GetPagesX(), 3u);
+	EXPECT_EQ(table.GetPagesY(), 2u);
+	EXPECT_EQ(table.GetPagesZ(), 2u);
+
+	const SparsePageTable::Box last = table.GetPageBox(table.GetPageCount() - 1);
+	EXPECT_EQ(last.x, 256u);
+	EXPECT_EQ(last.width, 44u);
+	EXPECT_EQ(last.y, 64u);
+	EXPECT_EQ(last.height, 36u);
+	EXPECT_EQ(last.z, 32u);
+	EXPECT_EQ(last.depth, 8u);
+
+	table.Request({ 300, 0, 0, 10, 10, 1 });
+	table.Request({ 0, 0, 0, 0, 10, 1 });
+	std::vector<uint32_t> bind, release;
+	table.Commit(bind, release);
+	EXPECT_TRUE(bind.empty());
+
+	// Past the edge is clipped, not dropped
+	table.Request({ 290, 90, 39, 100, 100, 100 });
+	table.Commit(bind, release);
+	EXPECT_EQ(bind, (std::vector<uint32_t>{ table.GetPageCount() - 1 }));
+}
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+// SpscRingTests.cpp
+//
+// Unit tests for the lock-free single-producer / single-consumer ring
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/SpscRing.hpp"
+#include <thread>
+
+using namespace Nightbloom;
+
+TEST(SpscRingTest, RoundsCapacityUpToPowerOfTwo)
+{
+	SpscRing<int> ring(5);
+	EXPECT_EQ(ring.GetCapacity(), 8u);
+	SpscRing<int> tiny(0);
+	EXPECT_EQ(tiny.GetCapacity(), 2u);
+}
+
+TEST(SpscRingTest, PopsInPushOrderAndFailsWhenFullOrEmpty)
+{
+	SpscRing<int> ring(4);
+	int out = -1;
+	EXPECT_FALSE(ring.TryPop(out));
+
+	for (int i = 0; i < 4; ++i)
+		ASSERT_TRUE(ring.TryPush(i));
+	EXPECT_FALSE(ring.TryPush(99));
+	EXPECT_EQ(ring.GetDroppedCount(), 1u);
+	EXPECT_EQ(ring.GetSize(), 4u);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		ASSERT_TRUE(ring.TryPop(out));
+		EXPECT_EQ(out, i);
+	}
+	EXPECT_FALSE(ring.TryPop(out));
+
+	// Wraps around the end of the slot array
+	for (int i = 10; i < 13; ++i)
+		ASSERT_TRUE(ring.TryPush(i));
+	for (int i = 10; i < 13; ++i)
+	{
+		ASSERT_TRUE(ring.TryPop(out));
+		EXPECT_EQ(out, i);
+	}
+}
+
+TEST(SpscRingTest, HandsEveryValueAcrossThreadsInOrder)
+{
+	constexpr int COUNT = 200000;
+	SpscRing<int> ring(64);
+
+	std::thread producer([&ring]()
+	{
+		for (int i = 0; i < COUNT; ++i)
+		{
+			while (!ring.TryPush(i))
+				std::this_thread::yield();
+		}
+	});
+
+	int expected = 0;
+	int value = 0;
+	while (expected < COUNT)
+	{
+		if (ring.TryPop(value))
+		{
+			ASSERT_EQ(value, expected);
+			++expected;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	EXPECT_FALSE(ring.TryPop(value));
+}
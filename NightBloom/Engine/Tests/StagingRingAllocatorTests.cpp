@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// StagingRingAllocatorTests.cpp
+//
+// Unit tests for the staging ring's offset bookkeeping
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/Vulkan/StagingRingAllocator.hpp"
+
+using namespace Nightbloom;
+
+TEST(StagingRingAllocatorTest, AllocationsAreAlignedAndSequential)
+{
+	StagingRingAllocator ring(1024);
+
+	EXPECT_EQ(ring.Allocate(10, 16), 0u);
+	EXPECT_EQ(ring.Allocate(10, 16), 16u);
+	EXPECT_EQ(ring.Allocate(4, 4), 28u);
+	EXPECT_EQ(ring.GetUsed(), 32u);
+}
+
+TEST(StagingRingAllocatorTest, RejectsEmptyAndOversizedRequests)
+{
+	StagingRingAllocator ring(256);
+
+	EXPECT_EQ(ring.Allocate(0, 16), StagingRingAllocator::INVALID_OFFSET);
+	EXPECT_EQ(ring.Allocate(257, 16), StagingRingAllocator::INVALID_OFFSET);
+	EXPECT_EQ(ring.GetUsed(), 0u);
+}
+
+TEST(StagingRingAllocatorTest, FullRingFailsUntilReleased)
+{
+	StagingRingAllocator ring(256);
+
+	EXPECT_EQ(ring.Allocate(128, 16), 0u);
+	const uint64_t firstBatchEnd = ring.GetHead();
+	EXPECT_EQ(ring.Allocate(128, 16), 128u);
+
+	EXPECT_EQ(ring.Allocate(16, 16), StagingRingAllocator::INVALID_OFFSET);
+
+	ring.Release(firstBatchEnd);
+	EXPECT_EQ(ring.GetUsed(), 128u);
+	EXPECT_EQ(ring.Allocate(16, 16), 0u);
+}
+
+TEST(StagingRingAllocatorTest, WrapSkipsTheEndOfTheBuffer)
+{
+	StagingRingAllocator ring(256);
+
+	ring.Allocate(160, 16);
+	ring.Release(ring.GetHead());
+
+	// 128 bytes don't fit in the 96 left before the end, so it wraps to 0
+	// and the tail of the lap counts as used until released
+	EXPECT_EQ(ring.Allocate(128, 16), 0u);
+	EXPECT_EQ(ring.GetUsed(), 96u + 128u);
+	EXPECT_EQ(ring.Allocate(64, 16), StagingRingAllocator::INVALID_OFFSET);
+
+	ring.ReleaseAll();
+	EXPECT_EQ(ring.Allocate(64, 16), 128u);
+}
+
+TEST(StagingRingAllocatorTest, WrapWaitsForTheStartOfTheBuffer)
+{
+	StagingRingAllocator ring(256);
+
+	ring.Allocate(64, 16);
+	const uint64_t oldest = ring.GetHead();
+	ring.Allocate(128, 16);
+
+	// Needs wrapping into [0, 96), which the first allocation still holds
+	EXPECT_EQ(ring.Allocate(96, 16), StagingRingAllocator::INVALID_OFFSET);
+
+	ring.Release(oldest);
+	EXPECT_EQ(ring.Allocate(64, 16), 192u);  // still fits before the end
+	EXPECT_EQ(ring.Allocate(64, 16), 0u);    // wraps into the released space
+}
+
+TEST(StagingRingAllocatorTest, ReleaseNeverMovesBackwardsOrPastTheHead)
+{
+	StagingRingAllocator ring(256);
+
+	ring.Allocate(64, 16);
+	const uint64_t early = ring.GetHead();
+	ring.Allocate(64, 16);
+
+	ring.Release(ring.GetHead());
+	ring.Release(early);
+	EXPECT_EQ(ring.GetUsed(), 0u);
+
+	ring.Release(ring.GetHead() + 1000);
+	EXPECT_EQ(ring.GetUsed(), 0u);
+	EXPECT_EQ(ring.Allocate(64, 16), 128u);
+}
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+// StartupTimerTests.cpp
+//
+// Unit tests for the time-to-first-frame phase report
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/StartupTimer.hpp"
+
+using namespace Nightbloom;
+
+TEST(StartupTimerTest, PhasesAreTimedFromThePreviousMark)
+{
+	StartupTimer timer;
+	timer.Start(10.0);
+	timer.Mark("Window", 10.25);
+	timer.Mark("Pipelines", 11.0, "61 on 16 threads");
+	ASSERT_TRUE(timer.Finish(11.5));
+
+	const auto& phases = timer.GetPhases();
+	ASSERT_EQ(phases.size(), 3u);
+	EXPECT_EQ(phases[0].name, "Window");
+	EXPECT_DOUBLE_EQ(phases[0].seconds, 0.25);
+	EXPECT_DOUBLE_EQ(phases[1].seconds, 0.75);
+	EXPECT_EQ(phases[1].detail, "61 on 16 threads");
+	EXPECT_EQ(phases[2].name, "First frame");
+	EXPECT_DOUBLE_EQ(phases[2].seconds, 0.5);
+	EXPECT_DOUBLE_EQ(timer.GetTotalSeconds(), 1.5);
+}
+
+TEST(StartupTimerTest, IgnoresMarksOutsideStartup)
+{
+	StartupTimer timer;
+	timer.Mark("Too early", 1.0);
+	EXPECT_FALSE(timer.Finish(2.0));
+	EXPECT_TRUE(timer.GetPhases().empty());
+
+	timer.Start(5.0);
+	EXPECT_TRUE(timer.Finish(6.0));
+	EXPECT_TRUE(timer.IsFinished());
+
+	// A renderer rebuilt later marks again; the report stays the startup one
+	timer.Mark("Pipelines", 9.0);
+	EXPECT_FALSE(timer.Finish(10.0));
+	EXPECT_EQ(timer.GetPhases().size(), 1u);
+	EXPECT_DOUBLE_EQ(timer.GetTotalSeconds(), 1.0);
+}
+
+TEST(StartupTimerTest, ReportListsEveryPhaseWithItsShare)
+{
+	StartupTimer timer;
+	timer.Start(0.0);
+	timer.Mark("Shaders", 0.5);
+	timer.Mark("Pipelines", 2.0, "61 on 16 threads");
+	timer.Finish(2.0);
+
+	const std::string report = timer.FormatReport();
+	EXPECT_NE(report.find("2.00 s to first frame"), std::string::npos);
+	EXPECT_NE(report.find("Shaders"), std::string::npos);
+	EXPECT_NE(report.find("500.0 ms"), std::string::npos);
+	EXPECT_NE(report.find("75%"), std::string::npos);
+	EXPECT_NE(report.find("(61 on 16 threads)"), std::string::npos);
+	EXPECT_NE(report.find("First frame"), std::string::npos);
+}
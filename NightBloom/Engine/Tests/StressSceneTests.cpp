@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+// StressSceneTests.cpp
+//
+// Unit tests for the procedural stress-scene generator
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/StressScene.hpp"
+#include <cmath>
+#include <set>
+
+using namespace Nightbloom;
+
+TEST(StressSceneTest, SameSeedSameScene)
+{
+	StressSceneDesc desc;
+	desc.objectCount = 500;
+	desc.pointLightCount = 40;
+	desc.distribution = StressDistribution::Clustered;
+
+	const StressScene a = GenerateStressScene(desc);
+	const StressScene b = GenerateStressScene(desc);
+	ASSERT_EQ(a.data.objects.size(), 500u);
+	ASSERT_EQ(a.data.lights.size(), 41u);   // the sun first
+	EXPECT_EQ(a.data.lights[0].type, LightType::Directional);
+	EXPECT_EQ(SceneToJson(a.data), SceneToJson(b.data));
+
+	desc.seed = 2;
+	EXPECT_NE(SceneToJson(GenerateStressScene(desc).data), SceneToJson(a.data));
+}
+
+TEST(StressSceneTest, LightsDoNotMoveTheObjects)
+{
+	StressSceneDesc desc;
+	desc.objectCount = 200;
+	const StressScene without = GenerateStressScene(desc);
+	desc.pointLightCount = 100;
+	const StressScene with = GenerateStressScene(desc);
+
+	for (size_t i = 0; i < desc.objectCount; ++i)
+		EXPECT_EQ(without.data.objects[i].position, with.data.objects[i].position);
+}
+
+TEST(StressSceneTest, EveryDistributionStaysOnTheSquare)
+{
+	for (StressDistribution distribution : { StressDistribution::Uniform, StressDistribution::Grid, StressDistribution::Clustered })
+	{
+		StressSceneDesc desc;
+		desc.objectCount = 1000;
+		desc.pointLightCount = 64;
+		desc.distribution = distribution;
+		const StressScene scene = GenerateStressScene(desc);
+
+		// 1000 objects at 25 m^2 each
+		EXPECT_NEAR(scene.halfSize, 0.5f * std::sqrt(25000.0f), 1e-3f);
+		for (const SceneFileObject& object : scene.data.objects)
+		{
+			EXPECT_LE(std::abs(object.position.x), scene.halfSize);
+			EXPECT_LE(std::abs(object.position.z), scene.halfSize);
+		}
+		for (const Light& light : scene.data.lights)
+		{
+			if (light.type == LightType::Point)
+			{
+				EXPECT_LE(std::abs(light.position.x), scene.halfSize);
+				EXPECT_LE(std::abs(light.position.z), scene.halfSize);
+			}
+		}
+	}
+}
+
+TEST(StressSceneTest, GridGivesEachObjectItsOwnCell)
+{
+	StressSceneDesc desc;
+	desc.objectCount = 100;
+	desc.distribution = StressDistribution::Grid;
+	const StressScene scene = GenerateStressScene(desc);
+
+	std::set<std::pair<float, float>> cells;
+	for (const SceneFileObject& object : scene.data.objects)
+		cells.insert({ object.position.x, object.position.z });
+	EXPECT_EQ(cells.size(), 100u);
+}
+
+TEST(StressSceneTest, AssetMixFollowsTheWeights)
+{
+	StressSceneDesc desc;
+	desc.objectCount = 4000;
+	StressAsset car;
+	car.source = "Assets/Models/ToyCar/ToyCar.gltf";
+	car.weight = 3.0f;
+	car.minScale = 0.01f;
+	car.maxScale = 0.02f;
+	StressAsset cube;
+	cube.weight = 1.0f;
+	StressAsset never;
+	never.primitive = "MoonSphere";
+	never.weight = 0.0f;
+	desc.assets = { car, cube, never };
+
+	const StressScene scene = GenerateStressScene(desc);
+	size_t cars = 0;
+	for (const SceneFileObject& object : scene.data.objects)
+	{
+		EXPECT_NE(object.primitive, "MoonSphere");
+		if (object.kind == SceneFileObject::Kind::Model)
+		{
+			++cars;
+			EXPECT_EQ(object.source, car.source);
+			EXPECT_GE(object.scale.x, 0.01f);
+			EXPECT_LT(object.scale.x, 0.02f);
+		}
+		else
+		{
+			EXPECT_EQ(object.primitive, "TestCube");
+			EXPECT_EQ(object.scale.x, 1.0f);
+		}
+	}
+	EXPECT_NEAR(static_cast<float>(cars) / 4000.0f, 0.75f, 0.03f);
+}
+
+TEST(StressSceneTest, WaterPlanesDoNotOverlap)
+{
+	StressSceneDesc desc;
+	desc.objectCount = 10000;
+	desc.waterPlaneCount = 5;
+	desc.waterPlaneSize = 400.0f;
+	desc.fireflyCount = 50000;
+	const StressScene scene = GenerateStressScene(desc);
+
+	ASSERT_EQ(scene.waterPlanes.size(), 5u);
+	for (size_t i = 0; i < scene.waterPlanes.size(); ++i)
+	{
+		const StressWaterPlane& a = scene.waterPlanes[i];
+		EXPECT_EQ(a.position.y, desc.waterY);
+		for (size_t j = i + 1; j < scene.waterPlanes.size(); ++j)
+		{
+			const StressWaterPlane& b = scene.waterPlanes[j];
+			const bool apart = std::abs(a.position.x - b.position.x) >= 0.5f * (a.size + b.size) - 1e-3f ||
+				std::abs(a.position.z - b.position.z) >= 0.5f * (a.size + b.size) - 1e-3f;
+			EXPECT_TRUE(apart);
+		}
+	}
+	EXPECT_EQ(scene.fireflyCount, 50000u);
+	EXPECT_EQ(scene.fireflyExtents.x, scene.halfSize);
+}
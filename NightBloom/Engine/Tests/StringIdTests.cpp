@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+// StringIdTests.cpp
+//
+// Unit tests for interned string ids
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/StringId.hpp"
+#include <string>
+#include <unordered_map>
+
+using namespace Nightbloom;
+
+TEST(StringIdTest, LiteralIdsMatchInternedOnes)
+{
+	constexpr StringId compileTime = "Shadow Pass"_sid;
+	static_assert(compileTime.GetValue() == HashString("Shadow Pass"));
+
+	// Known until something interns the text
+	const StringId unknown = "Never Interned"_sid;
+	EXPECT_TRUE(unknown.IsValid());
+	EXPECT_STREQ(unknown.c_str(), "");
+
+	const std::string text = "Shadow Pass";
+	const StringId interned = text;
+	EXPECT_EQ(interned, compileTime);
+	EXPECT_STREQ(compileTime.c_str(), "Shadow Pass");
+	EXPECT_EQ(interned.GetText(), "Shadow Pass");
+
+	EXPECT_NE(StringId("Shadow"), compileTime);
+}
+
+TEST(StringIdTest, EmptyAndNullAreInvalid)
+{
+	EXPECT_FALSE(StringId().IsValid());
+	EXPECT_FALSE(StringId("").IsValid());
+	EXPECT_FALSE(StringId(static_cast<const char*>(nullptr)).IsValid());
+	EXPECT_STREQ(StringId().c_str(), "");
+}
+
+TEST(StringIdTest, InterningATextAgainAddsNothing)
+{
+	const StringId first = "Interned Once";
+	const size_t count = GetInternedStringCount();
+	const char* text = first.c_str();
+
+	const StringId again = std::string("Interned Once");
+	EXPECT_EQ(again, first);
+	EXPECT_EQ(GetInternedStringCount(), count);
+	EXPECT_EQ(again.c_str(), text);   // the same storage
+
+	std::unordered_map<StringId, int> map;
+	map["Interned Once"_sid] = 3;
+	EXPECT_EQ(map.at(again), 3);
+}
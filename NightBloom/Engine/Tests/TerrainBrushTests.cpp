@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+// TerrainBrushTests.cpp
+//
+// Unit tests for sculpt brush weights, stroke rects and the CPU brush apply
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainBrush.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// 64 x 64 heightmap over 64 world units around the origin: one texel per unit
+	constexpr uint32_t kSize = 64;
+
+	TerrainBrushStroke MakeStroke(TerrainBrushMode mode, glm::vec2 center, float radius, float strength = 1.0f)
+	{
+		TerrainBrush brush;
+		brush.mode = mode;
+		brush.center = center;
+		brush.radius = radius;
+		brush.falloff = 0.5f;
+		brush.strength = strength;
+		return MakeTerrainBrushStroke(brush, 0.1f, kSize, kSize, glm::vec3(0.0f), static_cast<float>(kSize));
+	}
+
+	float& At(std::vector<float>& heights, int32_t x, int32_t y)
+	{
+		return heights[static_cast<size_t>(y) * kSize + x];
+	}
+}
+
+TEST(TerrainBrushTest, WeightIsSolidInsideAndFadesToTheRim)
+{
+	EXPECT_FLOAT_EQ(TerrainBrushWeight(0.0f, 10.0f, 0.5f), 1.0f);
+	EXPECT_FLOAT_EQ(TerrainBrushWeight(5.0f, 10.0f, 0.5f), 1.0f);
+	EXPECT_FLOAT_EQ(TerrainBrushWeight(7.5f, 10.0f, 0.5f), 0.5f);
+	EXPECT_FLOAT_EQ(TerrainBrushWeight(10.0f, 10.0f, 0.5f), 0.0f);
+	EXPECT_FLOAT_EQ(TerrainBrushWeight(1.0f, 0.0f, 0.5f), 0.0f);
+}
+
+TEST(TerrainBrushTest, StrokeCoversOnlyTheTexelsUnderTheBrush)
+{
+	const TerrainBrushStroke stroke = MakeStroke(TerrainBrushMode::Raise, glm::vec2(0.0f), 4.0f);
+
+	EXPECT_FLOAT_EQ(stroke.centerTexel.x, 32.0f);
+	EXPECT_FLOAT_EQ(stroke.texelWorldSize.x, 1.0f);
+	EXPECT_FLOAT_EQ(stroke.amount, 0.1f);
+	// Centres 28.5 .. 35.5 lie within 4 of 32
+	EXPECT_EQ(stroke.rect.x, 28);
+	EXPECT_EQ(stroke.rect.width, 8);
+	EXPECT_EQ(stroke.rect.y, 28);
+	EXPECT_EQ(stroke.rect.height, 8);
+}
+
+TEST(TerrainBrushTest, StrokeRectIsClampedToTheMap)
+{
+	const TerrainBrushStroke corner = MakeStroke(TerrainBrushMode::Raise, glm::vec2(-32.0f, 31.0f), 4.0f);
+	EXPECT_EQ(corner.rect.x, 0);
+	EXPECT_EQ(corner.rect.y + corner.rect.height, static_cast<int32_t>(kSize));
+
+	const TerrainBrushStroke outside = MakeStroke(TerrainBrushMode::Raise, glm::vec2(200.0f, 0.0f), 4.0f);
+	EXPECT_TRUE(outside.rect.IsEmpty());
+
+	const TerrainTexelRect grown = corner.rect.Expanded(1, kSize, kSize);
+	EXPECT_EQ(grown.x, 0);
+	EXPECT_EQ(grown.y, corner.rect.y - 1);
+	EXPECT_EQ(grown.y + grown.height, static_cast<int32_t>(kSize));
+}
+
+TEST(TerrainBrushTest, RaiseAndLowerOnlyTouchTheRect)
+{
+	std::vector<float> heights(kSize * kSize, 0.5f);
+	const TerrainBrushStroke stroke = MakeStroke(TerrainBrushMode::Raise, glm::vec2(0.0f), 4.0f);
+	ApplyTerrainBrush(heights.data(), kSize, kSize, 1, stroke);
+
+	EXPECT_NEAR(At(heights, 32, 32), 0.6f, 1e-6f);
+	EXPECT_FLOAT_EQ(At(heights, 20, 32), 0.5f);
+	EXPECT_FLOAT_EQ(At(heights, 32, 40), 0.5f);
+
+	TerrainBrushStroke lower = stroke;
+	lower.mode = TerrainBrushMode::Lower;
+	ApplyTerrainBrush(heights.data(), kSize, kSize, 1, lower);
+	EXPECT_NEAR(At(heights, 32, 32), 0.5f, 1e-6f);
+}
+
+TEST(TerrainBrushTest, HeightsStayNormalised)
+{
+	std::vector<float> heights(kSize * kSize, 0.95f);
+	ApplyTerrainBrush(heights.data(), kSize, kSize, 1, MakeStroke(TerrainBrushMode::Raise, glm::vec2(0.0f), 4.0f, 5.0f));
+	EXPECT_FLOAT_EQ(At(heights, 32, 32), 1.0f);
+
+	ApplyTerrainBrush(heights.data(), kSize, kSize, 1, MakeStroke(TerrainBrushMode::Lower, glm::vec2(0.0f), 4.0f, 50.0f));
+	EXPECT_FLOAT_EQ(At(heights, 32, 32), 0.0f);
+}
+
+TEST(TerrainBrushTest, FlattenMovesTowardsTheTarget)
+{
+	std::vector<float> heights(kSize * kSize, 0.8f);
+	TerrainBrushStroke stroke = MakeStroke(TerrainBrushMode::Flatten, glm::vec2(0.0f), 4.0f, 5.0f);
+	stroke.targetHeight = 0.2f;
+	ApplyTerrainBrush(heights.data(), kSize, kSize, 1, stroke);
+
+	// Half the way at full weight (amount 0.5)
+	EXPECT_NEAR(At(heights, 32, 32), 0.5f, 1e-6f);
+}
+
+TEST(TerrainBrushTest, SmoothReadsHeightsFromBeforeTheStroke)
+{
+	std::vector<float> heights(kSize * kSize, 0.0f);
+	At(heights, 32, 32) = 0.9f;
+	TerrainBrushStroke stroke = MakeStroke(TerrainBrushMode::Smooth, glm::vec2(0.0f), 4.0f, 10.0f);
+	ApplyTerrainBrush(heights.data(), kSize, kSize, 1, stroke);
+
+	// amount 1: texels in the solid core become their 3x3 average of the
+	// original heights
+	EXPECT_NEAR(At(heights, 32, 32), 0.1f, 1e-6f);
+	EXPECT_NEAR(At(heights, 33, 32), 0.1f, 1e-6f);
+	EXPECT_NEAR(At(heights, 31, 31), 0.1f, 1e-6f);
+	EXPECT_FLOAT_EQ(At(heights, 35, 35), 0.0f);
+}
+
+TEST(TerrainBrushTest, StrideSkipsTheOtherChannels)
+{
+	std::vector<float> texels(kSize * kSize * 4, 0.5f);
+	ApplyTerrainBrush(texels.data(), kSize, kSize, 4, MakeStroke(TerrainBrushMode::Raise, glm::vec2(0.0f), 4.0f));
+
+	const size_t centre = (32u * kSize + 32u) * 4;
+	EXPECT_NEAR(texels[centre], 0.6f, 1e-6f);
+	EXPECT_FLOAT_EQ(texels[centre + 1], 0.5f);
+	EXPECT_FLOAT_EQ(texels[centre + 3], 0.5f);
+}
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+// TerrainHeightFieldTests.cpp
+//
+// Unit tests for CPU terrain height/normal queries
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainHeightField.hpp"
+#include <cmath>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// RGBA texels like the heightmap readback; R = value(x, y)
+	template <typename Fn>
+	std::vector<float> MakeTexels(uint32_t width, uint32_t height, Fn value)
+	{
+		std::vector<float> texels(static_cast<size_t>(width) * height * 4, 1.0f);
+		for (uint32_t y = 0; y < height; ++y)
+			for (uint32_t x = 0; x < width; ++x)
+				texels[(static_cast<size_t>(y) * width + x) * 4] = value(x, y);
+		return texels;
+	}
+}
+
+TEST(TerrainHeightFieldTest, TexelCentresReturnTheirOwnHeight)
+{
+	const uint32_t size = 16;
+	auto texels = MakeTexels(size, size, [](uint32_t x, uint32_t y) { return 0.01f * x + 0.02f * y; });
+
+	TerrainHeightField field;
+	field.Assign(texels.data(), size, size, 4);
+	field.SetPlacement(glm::vec3(100.0f, 5.0f, -50.0f), 160.0f, 30.0f);
+	ASSERT_TRUE(field.IsValid());
+
+	// Texel (3, 7) centre: uv = (3.5 / 16, 7.5 / 16)
+	const float x = 100.0f + (3.5f / size - 0.5f) * 160.0f;
+	const float z = -50.0f + (7.5f / size - 0.5f) * 160.0f;
+	EXPECT_NEAR(field.SampleHeight(x, z), 5.0f + (0.03f + 0.14f) * 30.0f, 1e-4f);
+
+	// Halfway between two texel centres is their average
+	const float xMid = 100.0f + (4.0f / size - 0.5f) * 160.0f;
+	EXPECT_NEAR(field.SampleHeight(xMid, z), 5.0f + (0.035f + 0.14f) * 30.0f, 1e-4f);
+}
+
+TEST(TerrainHeightFieldTest, NormalsFollowTheSlope)
+{
+	const uint32_t size = 32;
+	auto flat = MakeTexels(size, size, [](uint32_t, uint32_t) { return 0.5f; });
+	auto rampX = MakeTexels(size, size, [](uint32_t x, uint32_t) { return x / 31.0f; });
+
+	TerrainHeightField field;
+	field.SetPlacement(glm::vec3(0.0f), 100.0f, 20.0f);
+
+	field.Assign(flat.data(), size, size, 4);
+	const glm::vec3 up = field.SampleNormal(3.0f, -7.0f);
+	EXPECT_NEAR(up.y, 1.0f, 1e-5f);
+
+	// Rising towards +x: the normal leans towards -x
+	field.Assign(rampX.data(), size, size, 4);
+	const glm::vec3 n = field.SampleNormal(0.0f, 0.0f);
+	EXPECT_LT(n.x, 0.0f);
+	EXPECT_NEAR(n.z, 0.0f, 1e-5f);
+	EXPECT_NEAR(glm::length(n), 1.0f, 1e-5f);
+
+	// Slope of the ramp is 20 over ~100 units
+	EXPECT_NEAR(-n.x / n.y, 20.0f / 100.0f, 0.02f);
+}
+
+TEST(TerrainHeightFieldTest, OutsideTheTerrainClampsToTheEdge)
+{
+	const uint32_t size = 8;
+	auto texels = MakeTexels(size, size, [](uint32_t x, uint32_t) { return x == 0 ? 0.0f : 1.0f; });
+
+	TerrainHeightField field;
+	field.Assign(texels.data(), size, size, 4);
+	field.SetPlacement(glm::vec3(0.0f), 80.0f, 10.0f);
+
+	EXPECT_FLOAT_EQ(field.SampleHeight(-1000.0f, 0.0f), field.SampleHeight(-40.0f, 0.0f));
+	EXPECT_FLOAT_EQ(field.SampleHeight(1000.0f, 0.0f), field.SampleHeight(40.0f, 0.0f));
+}
+
+TEST(TerrainHeightFieldTest, BatchedSamplingMatchesScalar)
+{
+	const uint32_t size = 64;
+	auto texels = MakeTexels(size, size, [](uint32_t x, uint32_t y)
+		{
+			return 0.5f + 0.5f * std::sin(0.3f * x) * std::cos(0.17f * y);
+		});
+
+	TerrainHeightField field;
+	field.Assign(texels.data(), size, size, 4);
+	field.SetPlacement(glm::vec3(10.0f, -3.0f, 20.0f), 256.0f, 40.0f);
+
+	// Not a multiple of four, and partly outside the terrain
+	std::vector<float> xs, zs;
+	for (int i = 0; i < 103; ++i)
+	{
+		xs.push_back(10.0f + (i * 37 % 300) - 150.0f + 0.123f * i);
+		zs.push_back(20.0f + (i * 53 % 290) - 145.0f - 0.071f * i);
+	}
+
+	std::vector<float> batched(xs.size());
+	field.SampleHeights(xs.data(), zs.data(), batched.data(), xs.size());
+
+	for (size_t i = 0; i < xs.size(); ++i)
+	{
+		EXPECT_FLOAT_EQ(batched[i], field.SampleHeight(xs[i], zs[i])) << "point " << i;
+	}
+}
+
+TEST(TerrainHeightFieldTest, BrushEditsTheSampledSurface)
+{
+	const uint32_t size = 32;
+	auto texels = MakeTexels(size, size, [](uint32_t, uint32_t) { return 0.25f; });
+
+	TerrainHeightField field;
+	field.Assign(texels.data(), size, size, 4);
+	field.SetPlacement(glm::vec3(0.0f), 32.0f, 40.0f);
+
+	TerrainBrush brush;
+	brush.center = glm::vec2(0.5f, 0.5f);
+	brush.radius = 4.0f;
+	brush.strength = 0.25f;
+	field.ApplyBrush(MakeTerrainBrushStroke(brush, 1.0f, size, size, glm::vec3(0.0f), 32.0f));
+
+	// The texel centred on (0.5, 0.5) gained a quarter of the height range
+	EXPECT_NEAR(field.SampleHeight(0.5f, 0.5f), 20.0f, 1e-3f);
+	EXPECT_NEAR(field.SampleHeight(-12.0f, -12.0f), 10.0f, 1e-3f);
+}
+
+TEST(TerrainHeightFieldTest, RaycastFindsTheSurface)
+{
+	const uint32_t size = 32;
+	auto texels = MakeTexels(size, size, [](uint32_t, uint32_t) { return 0.5f; });
+
+	TerrainHeightField field;
+	field.Assign(texels.data(), size, size, 4);
+	field.SetPlacement(glm::vec3(0.0f, 10.0f, 0.0f), 64.0f, 20.0f);
+
+	// Surface at y = 20: straight down from 50, and slanting in from outside
+	float distance = 0.0f;
+	ASSERT_TRUE(field.Raycast(glm::vec3(3.0f, 50.0f, -4.0f), glm::vec3(0.0f, -1.0f, 0.0f), 1000.0f, distance));
+	EXPECT_NEAR(distance, 30.0f, 1e-3f);
+
+	const glm::vec3 dir = glm::normalize(glm::vec3(1.0f, -1.0f, 0.0f));
+	ASSERT_TRUE(field.Raycast(glm::vec3(-60.0f, 50.0f, 0.0f), dir, 1000.0f, distance));
+	EXPECT_NEAR((glm::vec3(-60.0f, 50.0f, 0.0f) + dir * distance).y, 20.0f, 1e-3f);
+
+	// Pointing away, or out of range
+	EXPECT_FALSE(field.Raycast(glm::vec3(0.0f, 50.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 1000.0f, distance));
+	EXPECT_FALSE(field.Raycast(glm::vec3(0.0f, 50.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), 10.0f, distance));
+}
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// TerrainMaterialTests.cpp
+//
+// Unit tests for the baked terrain material weights
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainMaterial.hpp"
+
+using namespace Nightbloom;
+
+TEST(TerrainMaterialTest, WeightsSumToOne)
+{
+	for (float h = 0.0f; h <= 1.0f; h += 0.125f)
+	{
+		for (float normalY = 0.2f; normalY <= 1.0f; normalY += 0.2f)
+		{
+			for (float breakup : { 0.0f, 0.5f, 1.0f })
+			{
+				const glm::vec3 w = TerrainMaterialWeights(h, normalY, breakup);
+				EXPECT_NEAR(w.x + w.y + w.z, 1.0f, 1e-5f);
+				EXPECT_GE(glm::min(w.x, glm::min(w.y, w.z)), 0.0f);
+			}
+		}
+	}
+}
+
+TEST(TerrainMaterialTest, LayersFollowHeightAndSlope)
+{
+	EXPECT_EQ(TerrainDominantLayer(TerrainMaterialWeights(0.1f, 1.0f, 0.5f)), TerrainMaterialLayer::Grass);
+	EXPECT_EQ(TerrainDominantLayer(TerrainMaterialWeights(0.7f, 1.0f, 0.5f)), TerrainMaterialLayer::Dirt);
+	EXPECT_EQ(TerrainDominantLayer(TerrainMaterialWeights(0.95f, 0.85f, 0.5f)), TerrainMaterialLayer::Rock);
+	EXPECT_EQ(TerrainDominantLayer(TerrainMaterialWeights(0.1f, 0.5f, 0.5f)), TerrainMaterialLayer::Rock);
+}
+
+TEST(TerrainMaterialTest, FaintLayersAreDropped)
+{
+	// Flat lowland is grass alone, so the shader takes one sample there
+	const glm::vec3 lowland = TerrainMaterialWeights(0.05f, 1.0f, 0.5f);
+	EXPECT_EQ(TerrainMaterialLayerCount(lowland), 1u);
+	EXPECT_FLOAT_EQ(lowland.x, 1.0f);
+
+	for (float h = 0.0f; h <= 1.0f; h += 0.05f)
+	{
+		const glm::vec3 w = TerrainMaterialWeights(h, 0.9f, 0.3f);
+		for (int i = 0; i < 3; ++i)
+			EXPECT_TRUE(w[i] == 0.0f || w[i] >= TERRAIN_MATERIAL_MIN_WEIGHT);
+	}
+}
+
+TEST(TerrainMaterialTest, BreakupShiftsTheGrassBoundary)
+{
+	const glm::vec3 less = TerrainMaterialWeights(0.4f, 1.0f, 0.0f);
+	const glm::vec3 more = TerrainMaterialWeights(0.4f, 1.0f, 1.0f);
+	EXPECT_GT(more.x, less.x);
+	EXPECT_LT(more.y, less.y);
+}
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+// TerrainQuadtreeTests.cpp
+//
+// Unit tests for CDLOD patch selection
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainQuadtree.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	TerrainQuadtreeSettings MakeSettings()
+	{
+		TerrainQuadtreeSettings settings;
+		settings.worldSize = 256.0f;
+		settings.heightScale = 10.0f;
+		settings.levels = 4;          // leaves are 32 units
+		settings.lodRangeScale = 3.0f;
+		return settings;
+	}
+
+	float TotalArea(const std::vector<TerrainPatch>& patches)
+	{
+		float area = 0.0f;
+		for (const TerrainPatch& patch : patches)
+			area += patch.offsetSize.z * patch.offsetSize.z;
+		return area;
+	}
+}
+
+TEST(TerrainQuadtreeTest, FarCameraSelectsOnlyTheRoot)
+{
+	TerrainQuadtree tree;
+	std::vector<TerrainPatch> patches;
+	tree.Select(MakeSettings(), glm::vec3(100000.0f, 0.0f, 0.0f), patches);
+
+	ASSERT_EQ(patches.size(), 1u);
+	EXPECT_FLOAT_EQ(patches[0].offsetSize.x, -128.0f);
+	EXPECT_FLOAT_EQ(patches[0].offsetSize.z, 256.0f);
+	EXPECT_FLOAT_EQ(patches[0].offsetSize.w, 3.0f);
+}
+
+TEST(TerrainQuadtreeTest, PatchesCoverTheTerrainExactlyOnce)
+{
+	TerrainQuadtree tree;
+	std::vector<TerrainPatch> patches;
+	tree.Select(MakeSettings(), glm::vec3(-100.0f, 5.0f, 40.0f), patches);
+
+	EXPECT_GT(patches.size(), 1u);
+	EXPECT_FLOAT_EQ(TotalArea(patches), 256.0f * 256.0f);
+
+	// No overlaps: sample a grid of points and count the patches holding each
+	for (float x = -127.0f; x < 128.0f; x += 8.0f)
+	{
+		for (float z = -127.0f; z < 128.0f; z += 8.0f)
+		{
+			int hits = 0;
+			for (const TerrainPatch& patch : patches)
+			{
+				const glm::vec4& o = patch.offsetSize;
+				if (x >= o.x && x < o.x + o.z && z >= o.y && z < o.y + o.z)
+					++hits;
+			}
+			EXPECT_EQ(hits, 1) << "at " << x << ", " << z;
+		}
+	}
+}
+
+TEST(TerrainQuadtreeTest, CameraGetsTheFinestLevelAndDetailFallsOff)
+{
+	TerrainQuadtree tree;
+	std::vector<TerrainPatch> patches;
+	const glm::vec3 camera(-100.0f, 5.0f, -100.0f);
+	tree.Select(MakeSettings(), camera, patches);
+
+	float nearestLevel0 = 1e9f;
+	for (const TerrainPatch& patch : patches)
+	{
+		const uint32_t level = static_cast<uint32_t>(patch.offsetSize.w);
+		const glm::vec2 min = glm::vec2(patch.offsetSize);
+		const glm::vec2 closest = glm::clamp(glm::vec2(camera.x, camera.z), min, min + patch.offsetSize.z);
+		const float distance = glm::length(closest - glm::vec2(camera.x, camera.z));
+
+		// A patch's size follows its level
+		EXPECT_FLOAT_EQ(patch.offsetSize.z, 32.0f * static_cast<float>(1u << level));
+
+		if (level == 0)
+			nearestLevel0 = std::min(nearestLevel0, distance);
+
+		// Only the next-coarser range may hold a level's patches
+		if (level + 1 < 4)
+		{
+			EXPECT_LE(distance, tree.GetRange(level + 1));
+		}
+	}
+	EXPECT_FLOAT_EQ(nearestLevel0, 0.0f);
+}
+
+TEST(TerrainQuadtreeTest, MorphBandsEndAtEachLevelsRange)
+{
+	TerrainQuadtree tree;
+	std::vector<TerrainPatch> patches;
+	tree.Select(MakeSettings(), glm::vec3(0.0f), patches);
+
+	EXPECT_FLOAT_EQ(tree.GetRange(0), 96.0f);
+	EXPECT_FLOAT_EQ(tree.GetRange(1), 192.0f);
+
+	for (const TerrainPatch& patch : patches)
+	{
+		const uint32_t level = static_cast<uint32_t>(patch.offsetSize.w);
+		EXPECT_EQ(patch.lodCamera, glm::vec4(0.0f));
+		if (level == 3)
+			continue;  // coarsest level never morphs
+
+		const float bandStart = level == 0 ? 0.0f : tree.GetRange(level - 1);
+		EXPECT_FLOAT_EQ(patch.morphRange.y, tree.GetRange(level));
+		EXPECT_GT(patch.morphRange.x, bandStart);
+		EXPECT_LT(patch.morphRange.x, patch.morphRange.y);
+	}
+}
+
+TEST(TerrainQuadtreeTest, NeighbouringPatchesDifferByAtMostOneLevel)
+{
+	TerrainQuadtree tree;
+	std::vector<TerrainPatch> patches;
+	tree.Select(MakeSettings(), glm::vec3(30.0f, 2.0f, -70.0f), patches);
+
+	auto touches = [](const glm::vec4& a, const glm::vec4& b)
+	{
+		const bool overlapX = a.x <= b.x + b.z && b.x <= a.x + a.z;
+		const bool overlapZ = a.y <= b.y + b.z && b.y <= a.y + a.z;
+		return overlapX && overlapZ;
+	};
+
+	for (size_t i = 0; i < patches.size(); ++i)
+	{
+		for (size_t j = i + 1; j < patches.size(); ++j)
+		{
+			if (touches(patches[i].offsetSize, patches[j].offsetSize))
+			{
+				EXPECT_LE(std::abs(patches[i].offsetSize.w - patches[j].offsetSize.w), 1.0f);
+			}
+		}
+	}
+}
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+// TerrainSunShadowTests.cpp
+//
+// Unit tests for the terrain's heightfield sun shadow: the march, the
+// shadow height it traces, and when the map is due again
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainSunShadow.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// A flat plain at height 0 with a wall `height` high on column wallX
+	struct Wall
+	{
+		float wallX;
+		float height;
+		float operator()(const glm::vec2& texel) const
+		{
+			return std::abs(texel.x - wallX) < 0.5f ? height : 0.0f;
+		}
+	};
+}
+
+TEST(TerrainSunShadowTest, MarchStepsOneTexelAlongTheMajorAxis)
+{
+	const glm::vec3 light = TerrainSunShadowLight(glm::vec3(1.0f, 1.0f, 0.5f));
+	const TerrainSunShadowMarch march = TerrainSunShadowMarchFor(light, 2.0f, 256, 30.0f);
+	EXPECT_FLOAT_EQ(march.step.x, 1.0f);
+	EXPECT_FLOAT_EQ(march.step.y, 0.5f);
+
+	// Sinks by the light's slope over the step's world length
+	const float horizontal = std::sqrt(light.x * light.x + light.z * light.z);
+	EXPECT_NEAR(march.drop, glm::length(march.step) * 2.0f * light.y / horizontal, 1e-5f);
+	EXPECT_EQ(march.steps, static_cast<uint32_t>(std::ceil(30.0f / march.drop)));
+}
+
+TEST(TerrainSunShadowTest, OverheadOrLowLights)
+{
+	EXPECT_EQ(TerrainSunShadowMarchFor(TerrainSunShadowLight(glm::vec3(0.0f, 1.0f, 0.0f)), 1.0f, 64, 30.0f).steps, 0u);
+
+	// A light at or below the horizon marches as if at the minimum elevation,
+	// and never further than the map
+	const glm::vec3 low = TerrainSunShadowLight(glm::vec3(1.0f, -0.2f, 0.0f));
+	const glm::vec3 expected = glm::normalize(glm::vec3(glm::normalize(glm::vec3(1.0f, -0.2f, 0.0f)).x, TERRAIN_SUN_SHADOW_MIN_ELEVATION, 0.0f));
+	EXPECT_NEAR(low.y, expected.y, 1e-5f);
+	EXPECT_EQ(TerrainSunShadowMarchFor(low, 1.0f, 64, 1000.0f).steps, 64u);
+}
+
+TEST(TerrainSunShadowTest, WallShadowsTheTexelsAwayFromTheLight)
+{
+	// Light from +x at 45 degrees: one world unit of drop per texel
+	const glm::vec3 light = glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f));
+	const TerrainSunShadowMarch march = TerrainSunShadowMarchFor(light, 1.0f, 64, 10.0f);
+	const Wall wall{ 32.0f, 10.0f };
+	const glm::ivec2 size(64, 64);
+
+	// Three texels behind a 10-high wall: the ray must start above 7
+	EXPECT_NEAR(TerrainSunShadowHeight(wall, glm::vec2(29.0f, 5.0f), size, march, 10.0f), 7.0f, 1e-4f);
+	EXPECT_NEAR(TerrainSunShadowHeight(wall, glm::vec2(31.0f, 5.0f), size, march, 10.0f), 9.0f, 1e-4f);
+
+	// Past its reach, and on the lit side, a texel holds its own height
+	EXPECT_FLOAT_EQ(TerrainSunShadowHeight(wall, glm::vec2(20.0f, 5.0f), size, march, 10.0f), 0.0f);
+	EXPECT_FLOAT_EQ(TerrainSunShadowHeight(wall, glm::vec2(40.0f, 5.0f), size, march, 10.0f), 0.0f);
+	EXPECT_FLOAT_EQ(TerrainSunShadowHeight(wall, glm::vec2(32.0f, 5.0f), size, march, 10.0f), 10.0f);
+}
+
+TEST(TerrainSunShadowTest, VisibilityFadesOverThePenumbra)
+{
+	TerrainSunShadowData data;
+	data.params = glm::vec4(1.0f, 2.0f, 0.0f, 0.0f);
+
+	EXPECT_FLOAT_EQ(TerrainSunShadowVisibility(5.0f, 5.0f, data), 0.5f);
+	EXPECT_FLOAT_EQ(TerrainSunShadowVisibility(6.0f, 5.0f, data), 1.0f);
+	EXPECT_FLOAT_EQ(TerrainSunShadowVisibility(4.0f, 5.0f, data), 0.0f);
+	EXPECT_FLOAT_EQ(TerrainSunShadowVisibility(0.0f, 5.0f, data), 0.0f);
+}
+
+TEST(TerrainSunShadowTest, RebakesOnlyWhenTheLightTurnsOrTheTerrainChanges)
+{
+	TerrainSunShadowState state;
+	const glm::vec3 sun = glm::normalize(glm::vec3(0.3f, 0.8f, 0.2f));
+	EXPECT_TRUE(state.Update(sun));
+	EXPECT_FALSE(state.Update(sun));
+
+	// A turn under the threshold keeps the map
+	const float small = glm::radians(TERRAIN_SUN_SHADOW_REBAKE_DEG * 0.5f);
+	const glm::vec3 nudged(sun.x * std::cos(small) - sun.y * std::sin(small), sun.x * std::sin(small) + sun.y * std::cos(small), sun.z);
+	EXPECT_FALSE(state.Update(nudged));
+
+	const float large = glm::radians(TERRAIN_SUN_SHADOW_REBAKE_DEG * 2.0f);
+	const glm::vec3 turned(sun.x * std::cos(large) - sun.y * std::sin(large), sun.x * std::sin(large) + sun.y * std::cos(large), sun.z);
+	EXPECT_TRUE(state.Update(turned));
+
+	state.Invalidate();
+	EXPECT_FALSE(state.IsValid());
+	EXPECT_TRUE(state.Update(turned));
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// TerrainTessellationTests.cpp
+//
+// Unit tests for the tessellated terrain's grid size and edge factors
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainTessellation.hpp"
+#include <cmath>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// 60 degree vertical FOV on a 1080 line viewport, 8 pixel target edges
+	const float kProjScaleY = 1.0f / std::tan(glm::radians(30.0f));
+	const float kScreenScale = TerrainTessScreenScale(1080.0f, 8.0f);
+}
+
+TEST(TerrainTessellationTest, BaseQuadsStayEvenAndInRange)
+{
+	EXPECT_EQ(TerrainTessellationBaseQuads(8, 32), 8u);
+	EXPECT_EQ(TerrainTessellationBaseQuads(7, 32), 6u);
+	EXPECT_EQ(TerrainTessellationBaseQuads(0, 32), 2u);
+	EXPECT_EQ(TerrainTessellationBaseQuads(1000, 32), 32u);
+}
+
+TEST(TerrainTessellationTest, NearEdgesSplitMoreThanFarOnes)
+{
+	const glm::vec3 edge(4.0f, 0.0f, 0.0f);
+	const glm::vec3 nearStart(0.0f, -2.0f, -10.0f);
+	const glm::vec3 farStart(0.0f, -2.0f, -1000.0f);
+
+	const float nearFactor = TerrainEdgeTessFactor(nearStart, nearStart + edge, kProjScaleY, kScreenScale, 0.0f);
+	const float farFactor = TerrainEdgeTessFactor(farStart, farStart + edge, kProjScaleY, kScreenScale, 0.0f);
+
+	EXPECT_GT(nearFactor, farFactor);
+	EXPECT_FLOAT_EQ(farFactor, 1.0f);
+	EXPECT_LE(nearFactor, TERRAIN_MAX_TESS_FACTOR);
+}
+
+TEST(TerrainTessellationTest, PiecesCoverAboutTheTargetPixels)
+{
+	const glm::vec3 a(-2.0f, 0.0f, -50.0f);
+	const glm::vec3 b(2.0f, 0.0f, -50.0f);
+	const float factor = TerrainEdgeTessFactor(a, b, kProjScaleY, kScreenScale, 0.0f);
+
+	// The whole edge spans length * projScaleY / distance half-heights of the screen
+	const float edgePixels = 4.0f * kProjScaleY / 50.0f * 540.0f;
+	EXPECT_NEAR(edgePixels / factor, 8.0f, 0.01f);
+}
+
+TEST(TerrainTessellationTest, NeverFinerThanAHeightmapTexel)
+{
+	const glm::vec3 a(0.0f, -1.0f, -1.0f);
+	const glm::vec3 b(4.0f, -1.0f, -1.0f);
+
+	EXPECT_FLOAT_EQ(TerrainEdgeTessFactor(a, b, kProjScaleY, kScreenScale, 0.5f), 8.0f);
+	EXPECT_FLOAT_EQ(TerrainEdgeTessFactor(a, b, kProjScaleY, kScreenScale, 0.0f), TERRAIN_MAX_TESS_FACTOR);
+}
+
+TEST(TerrainTessellationTest, SharedEdgesSplitTheSameWayFromEitherSide)
+{
+	// The neighbouring triangle walks the edge the other way round
+	const glm::vec3 a(3.0f, -5.0f, -20.0f);
+	const glm::vec3 b(1.0f, -4.0f, -22.0f);
+
+	EXPECT_EQ(TerrainEdgeTessFactor(a, b, kProjScaleY, kScreenScale, 0.25f),
+		TerrainEdgeTessFactor(b, a, kProjScaleY, kScreenScale, 0.25f));
+}
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// TerrainTileCacheTests.cpp
+//
+// Unit tests for streaming terrain tile residency
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainTileCache.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Runs Update until the window settles, returning every request issued
+	std::vector<TerrainTileRequest> Settle(TerrainTileCache& cache, TerrainTileCoord desired, uint32_t budget)
+	{
+		std::vector<TerrainTileRequest> all, requests;
+		for (int frame = 0; frame < 1000; ++frame)
+		{
+			cache.Update(desired, budget, requests);
+			all.insert(all.end(), requests.begin(), requests.end());
+			if (requests.empty())
+				break;
+		}
+		return all;
+	}
+}
+
+TEST(TerrainTileCacheTest, FillsTheWindowNearestFirstWithinBudget)
+{
+	TerrainTileCache cache(1);
+	std::vector<TerrainTileRequest> requests;
+
+	cache.Update({ 5, -3 }, 4, requests);
+	ASSERT_EQ(requests.size(), 4u);
+	EXPECT_EQ(requests[0].tile, (TerrainTileCoord{ 5, -3 }));
+	EXPECT_FALSE(cache.HasWindow());
+
+	cache.Update({ 5, -3 }, 100, requests);
+	EXPECT_EQ(requests.size(), 5u);
+	EXPECT_TRUE(cache.HasWindow());
+	EXPECT_EQ(cache.GetCenter(), (TerrainTileCoord{ 5, -3 }));
+
+	cache.Update({ 5, -3 }, 100, requests);
+	EXPECT_TRUE(requests.empty());
+}
+
+TEST(TerrainTileCacheTest, SlotsWrapToroidallyForNegativeTiles)
+{
+	TerrainTileCache cache(1);
+	EXPECT_EQ(cache.GetSlotsPerSide(), 4u);
+	EXPECT_EQ(cache.SlotOf(0), 0u);
+	EXPECT_EQ(cache.SlotOf(5), 1u);
+	EXPECT_EQ(cache.SlotOf(-1), 3u);
+	EXPECT_EQ(cache.SlotOf(-4), 0u);
+}
+
+TEST(TerrainTileCacheTest, StepOnlyGeneratesTheNewRowIntoSpareSlots)
+{
+	TerrainTileCache cache(2);
+	Settle(cache, { 0, 0 }, 100);
+
+	std::vector<TerrainTileRequest> requests;
+	cache.Update({ 1, 0 }, 100, requests);
+
+	ASSERT_EQ(requests.size(), 5u);
+	for (const TerrainTileRequest& request : requests)
+	{
+		EXPECT_EQ(request.tile.x, 3);
+		EXPECT_EQ(request.slotX, cache.SlotOf(3));
+	}
+	EXPECT_EQ(cache.GetCenter(), (TerrainTileCoord{ 1, 0 }));
+	EXPECT_TRUE(cache.IsResident({ -2, 0 }));  // spare column still holds the old edge
+}
+
+TEST(TerrainTileCacheTest, DrawnWindowSurvivesAPartialStep)
+{
+	TerrainTileCache cache(2);
+	Settle(cache, { 0, 0 }, 100);
+
+	// Not enough budget to finish the step: keep drawing the old window
+	std::vector<TerrainTileRequest> requests;
+	cache.Update({ 1, 1 }, 3, requests);
+	EXPECT_EQ(requests.size(), 3u);
+	EXPECT_EQ(cache.GetCenter(), (TerrainTileCoord{ 0, 0 }));
+	EXPECT_TRUE(cache.HasWindow());
+
+	Settle(cache, { 1, 1 }, 3);
+	EXPECT_EQ(cache.GetCenter(), (TerrainTileCoord{ 1, 1 }));
+	EXPECT_TRUE(cache.HasWindow());
+}
+
+TEST(TerrainTileCacheTest, LongMovesWalkOneStepAtATime)
+{
+	TerrainTileCache cache(2);
+	Settle(cache, { 0, 0 }, 100);
+
+	// Every step must keep the current window intact while the next fills in
+	std::vector<TerrainTileRequest> requests;
+	TerrainTileCoord previous = cache.GetCenter();
+	for (int frame = 0; frame < 100 && !(cache.GetCenter() == TerrainTileCoord{ 4, -3 }); ++frame)
+	{
+		cache.Update({ 4, -3 }, 2, requests);
+		const TerrainTileCoord center = cache.GetCenter();
+		EXPECT_LE(std::abs(center.x - previous.x), 1);
+		EXPECT_LE(std::abs(center.z - previous.z), 1);
+		EXPECT_TRUE(cache.HasWindow());
+		previous = center;
+	}
+	EXPECT_EQ(cache.GetCenter(), (TerrainTileCoord{ 4, -3 }));
+}
+
+TEST(TerrainTileCacheTest, FarJumpStartsAnEmptyWindow)
+{
+	TerrainTileCache cache(1);
+	Settle(cache, { 0, 0 }, 100);
+
+	std::vector<TerrainTileRequest> requests;
+	cache.Update({ 50, 50 }, 1, requests);
+	EXPECT_EQ(cache.GetCenter(), (TerrainTileCoord{ 50, 50 }));
+	EXPECT_FALSE(cache.HasWindow());
+	EXPECT_FALSE(cache.IsResident({ 0, 0 }));
+}
+
+TEST(TerrainTileCacheTest, EvictionKeepsTheDrawnAndNextWindows)
+{
+	TerrainTileCache cache(1);
+	Settle(cache, { 0, 0 }, 100);
+	Settle(cache, { 1, 0 }, 100);
+	ASSERT_EQ(cache.GetCenter(), (TerrainTileCoord{ 1, 0 }));
+
+	// The old window's trailing column sits in the spare slots
+	EXPECT_TRUE(cache.IsResident({ -1, 0 }));
+	cache.EvictUnused({ 1, 0 });
+	EXPECT_FALSE(cache.IsResident({ -1, 0 }));
+	EXPECT_FALSE(cache.IsSlotInUse(cache.SlotOf(-1), cache.SlotOf(0)));
+	EXPECT_TRUE(cache.HasWindow());
+
+	// Part way into the next step, its generated tiles are kept
+	std::vector<TerrainTileRequest> requests;
+	cache.Update({ 2, 0 }, 1, requests);
+	ASSERT_EQ(requests.size(), 1u);
+	cache.EvictUnused({ 2, 0 });
+	EXPECT_TRUE(cache.IsResident(requests[0].tile));
+	EXPECT_TRUE(cache.IsSlotInUse(requests[0].slotX, requests[0].slotZ));
+
+	// Walking back regenerates the evicted column
+	Settle(cache, { 1, 0 }, 100);
+	EXPECT_EQ(Settle(cache, { 0, 0 }, 100).size(), 3u);
+}
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// TerrainVirtualTextureTests.cpp
+//
+// Unit tests for the terrain virtual texture's page bookkeeping
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Terrain/TerrainVirtualTexture.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	constexpr uint32_t WINDOW_PAGES = (2 * TERRAIN_VIRTUAL_RADIUS + 1) * (2 * TERRAIN_VIRTUAL_RADIUS + 1);
+}
+
+TEST(TerrainVirtualTextureTest, FreshLevelsFillAtOnce)
+{
+	TerrainVirtualTexture texture;
+	std::vector<TerrainVirtualPageRequest> requests;
+
+	texture.Update(glm::vec2(10.0f, -3.0f), 4, requests);
+	EXPECT_EQ(requests.size(), WINDOW_PAGES * TERRAIN_VIRTUAL_LEVELS);
+	EXPECT_EQ(texture.GetResidentLevelCount(), TERRAIN_VIRTUAL_LEVELS);
+
+	const TerrainVirtualTextureData data = texture.BuildData();
+	EXPECT_EQ(data.config.w, static_cast<float>(TERRAIN_VIRTUAL_LEVELS));
+	EXPECT_EQ(data.levels[0], glm::ivec4(5, -2, 1, 0));
+	EXPECT_EQ(data.levels[2], glm::ivec4(1, -1, 1, 0));
+
+	texture.Update(glm::vec2(10.0f, -3.0f), 4, requests);
+	EXPECT_TRUE(requests.empty());
+}
+
+TEST(TerrainVirtualTextureTest, WalkingSharesTheBudgetFinestFirst)
+{
+	TerrainVirtualTexture texture;
+	std::vector<TerrainVirtualPageRequest> requests;
+	texture.Update(glm::vec2(1.0f), TERRAIN_VIRTUAL_PAGES_PER_FRAME, requests);
+
+	// One finest page east: a new column for level 0 only
+	texture.Update(glm::vec2(3.0f, 1.0f), 4, requests);
+	ASSERT_EQ(requests.size(), 4u);
+	for (const TerrainVirtualPageRequest& request : requests)
+	{
+		EXPECT_EQ(request.level, 0u);
+		EXPECT_EQ(request.page.tile.x, 1 + static_cast<int32_t>(TERRAIN_VIRTUAL_RADIUS));
+	}
+
+	// The old window keeps drawing until the new column is complete
+	EXPECT_EQ(texture.BuildData().levels[0], glm::ivec4(0, 0, 1, 0));
+	texture.Update(glm::vec2(3.0f, 1.0f), 4, requests);
+	EXPECT_EQ(requests.size(), 2 * TERRAIN_VIRTUAL_RADIUS + 1 - 4);
+	EXPECT_EQ(texture.BuildData().levels[0], glm::ivec4(1, 0, 1, 0));
+}
+
+TEST(TerrainVirtualTextureTest, EditsReRenderOnlyResidentPagesUnderThem)
+{
+	TerrainVirtualTexture texture;
+	std::vector<TerrainVirtualPageRequest> requests;
+	texture.Update(glm::vec2(0.5f), TERRAIN_VIRTUAL_PAGES_PER_FRAME, requests);
+
+	// Inside one finest page: that page, and the one page holding it per level
+	requests.clear();
+	texture.CollectResident(glm::vec2(0.2f), glm::vec2(0.8f), requests);
+	ASSERT_EQ(requests.size(), TERRAIN_VIRTUAL_LEVELS);
+	for (uint32_t level = 0; level < TERRAIN_VIRTUAL_LEVELS; ++level)
+		EXPECT_EQ(requests[level].page.tile, (TerrainTileCoord{ 0, 0 }));
+
+	// A rect far away touches nothing; a huge one only the resident windows
+	requests.clear();
+	texture.CollectResident(glm::vec2(5000.0f), glm::vec2(5010.0f), requests);
+	EXPECT_TRUE(requests.empty());
+	texture.CollectResident(glm::vec2(-1.0e5f), glm::vec2(1.0e5f), requests);
+	EXPECT_EQ(requests.size(), WINDOW_PAGES * TERRAIN_VIRTUAL_LEVELS);
+}
+
+TEST(TerrainVirtualTextureTest, ResetEmptiesEveryLevel)
+{
+	TerrainVirtualTexture texture;
+	std::vector<TerrainVirtualPageRequest> requests;
+	texture.Update(glm::vec2(0.0f), TERRAIN_VIRTUAL_PAGES_PER_FRAME, requests);
+
+	texture.Reset();
+	EXPECT_EQ(texture.GetResidentLevelCount(), 0u);
+	EXPECT_EQ(texture.BuildData().levels[3].z, 0);
+	requests.clear();
+	texture.CollectResident(glm::vec2(-10.0f), glm::vec2(10.0f), requests);
+	EXPECT_TRUE(requests.empty());
+}
+
+TEST(TerrainVirtualTextureTest, LevelFollowsThePixelFootprint)
+{
+	const float texel = TerrainVirtualTexelWorldSize(0);
+	EXPECT_EQ(TerrainVirtualLevelFor(texel * 0.5f), 0u);
+	EXPECT_EQ(TerrainVirtualLevelFor(texel), 0u);
+	EXPECT_EQ(TerrainVirtualLevelFor(texel * 1.5f), 1u);
+	EXPECT_EQ(TerrainVirtualLevelFor(texel * 4.0f), 2u);
+	EXPECT_EQ(TerrainVirtualLevelFor(texel * 1.0e4f), TERRAIN_VIRTUAL_LEVELS);
+}
+
+TEST(TerrainVirtualTextureTest, CoverageStopsATexelInsideTheWindow)
+{
+	TerrainVirtualTexture texture;
+	std::vector<TerrainVirtualPageRequest> requests;
+	EXPECT_FALSE(texture.Covers(0, glm::vec2(0.0f)));
+
+	texture.Update(glm::vec2(1.0f), TERRAIN_VIRTUAL_PAGES_PER_FRAME, requests);
+
+	// Level 0's window spans pages -r..r, i.e. [-2r, 2r + 2) in world units
+	const float edge = TERRAIN_VIRTUAL_PAGE_WORLD_SIZE * static_cast<float>(TERRAIN_VIRTUAL_RADIUS + 1);
+	const float texel = TerrainVirtualTexelWorldSize(0);
+	EXPECT_TRUE(texture.Covers(0, glm::vec2(1.0f)));
+	EXPECT_TRUE(texture.Covers(0, glm::vec2(edge - 2.0f * texel, 1.0f)));
+	EXPECT_FALSE(texture.Covers(0, glm::vec2(edge - 0.5f * texel, 1.0f)));
+	EXPECT_TRUE(texture.Covers(1, glm::vec2(edge, 1.0f)));
+}
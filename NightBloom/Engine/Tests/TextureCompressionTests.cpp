@@ -0,0 +1,222 @@
+//------------------------------------------------------------------------------
+// TextureCompressionTests.cpp
+//
+// Unit tests for BCn block compression, mip chains and the KTX2 container
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/TextureCompression.hpp"
+#include "../Renderer/Ktx2.hpp"
+#include "../Renderer/TextureLoader.hpp"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Shading along a colour ramp: most albedo blocks vary along one colour
+	// direction. With planar=true, R and G are independent x/y gradients
+	// instead (normal-map like), which only two-channel formats handle well.
+	ImageData MakeImage(uint32_t width, uint32_t height, bool planar = false)
+	{
+		ImageData image;
+		image.width = width;
+		image.height = height;
+		image.channels = 4;
+		image.pixelSize = 4;
+		image.pixels.resize(size_t(width) * height * 4);
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				uint8_t* p = &image.pixels[(size_t(y) * width + x) * 4];
+				if (planar)
+				{
+					p[0] = static_cast<uint8_t>(x * 255 / std::max(1u, width - 1));
+					p[1] = static_cast<uint8_t>(y * 255 / std::max(1u, height - 1));
+					p[2] = 255;
+					p[3] = 255;
+					continue;
+				}
+				const double l = 60.0 + 120.0 * x / std::max(1u, width - 1) + 50.0 * std::sin((x + y) * 0.3);
+				p[0] = static_cast<uint8_t>(l);
+				p[1] = static_cast<uint8_t>(0.8 * l + 20.0);
+				p[2] = static_cast<uint8_t>(0.5 * l + 40.0);
+				p[3] = static_cast<uint8_t>(255.0 - l / 4.0);
+			}
+		}
+		return image;
+	}
+
+	double Psnr(const uint8_t* a, const std::vector<uint8_t>& b, int channels)
+	{
+		double sum = 0.0;
+		size_t count = 0;
+		for (size_t i = 0; i < b.size(); i += 4)
+		{
+			for (int c = 0; c < channels; ++c, ++count)
+			{
+				const double d = double(a[i + c]) - double(b[i + c]);
+				sum += d * d;
+			}
+		}
+		const double mse = sum / double(count);
+		return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+	}
+
+	double RoundTripPsnr(BlockFormat format, const ImageData& image, int channels)
+	{
+		const auto blocks = CompressImage(format, image.pixels.data(), image.width, image.height);
+		EXPECT_EQ(blocks.size(), GetCompressedSize(format, image.width, image.height));
+		const auto decoded = DecompressImage(format, blocks.data(), image.width, image.height);
+		return Psnr(image.pixels.data(), decoded, channels);
+	}
+
+	std::string TempPath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	std::vector<uint8_t> ReadFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+}
+
+TEST(TextureCompression, BlockFormatsRoundTripWithHighPsnr)
+{
+	// 30x18: partial edge blocks on both axes
+	const ImageData image = MakeImage(30, 18);
+	const ImageData planar = MakeImage(30, 18, true);
+
+	EXPECT_GT(RoundTripPsnr(BlockFormat::BC7, image, 4), 45.0);
+	EXPECT_GT(RoundTripPsnr(BlockFormat::BC1, image, 3), 33.0);
+	EXPECT_GT(RoundTripPsnr(BlockFormat::BC4, image, 1), 38.0);
+	EXPECT_GT(RoundTripPsnr(BlockFormat::BC5, planar, 2), 40.0);
+	EXPECT_EQ(GetCompressedSize(BlockFormat::BC7, 30, 18), 8u * 5u * 16u);
+	EXPECT_EQ(GetCompressedSize(BlockFormat::BC1, 1, 1), 8u);
+}
+
+TEST(TextureCompression, FlatBlocksStayFlat)
+{
+	std::vector<uint8_t> flat;
+	for (int i = 0; i < 16; ++i)
+		flat.insert(flat.end(), { 200, 17, 90, 255 });
+
+	// Mode 6 endpoints carry 7 bits plus a p-bit, so odd and even channels
+	// can't always share one exact colour; they land within one step
+	const auto bc7 = CompressImage(BlockFormat::BC7, flat.data(), 4, 4);
+	const auto decoded = DecompressImage(BlockFormat::BC7, bc7.data(), 4, 4);
+	for (size_t i = 0; i < flat.size(); ++i)
+		EXPECT_LE(std::abs(int(decoded[i]) - int(flat[i])), 1);
+
+	const auto bc5 = CompressImage(BlockFormat::BC5, flat.data(), 4, 4);
+	const auto decodedRG = DecompressImage(BlockFormat::BC5, bc5.data(), 4, 4);
+	for (size_t i = 0; i < flat.size(); i += 4)
+	{
+		EXPECT_EQ(decodedRG[i], 200);
+		EXPECT_EQ(decodedRG[i + 1], 17);
+	}
+}
+
+TEST(TextureCompression, MipChainHalvesToOneTexel)
+{
+	const auto levels = BuildMipChain(MakeImage(20, 8), false);
+	ASSERT_EQ(levels.size(), 5u);   // 20x8, 10x4, 5x2, 2x1, 1x1
+	EXPECT_EQ(levels[2].width, 5u);
+	EXPECT_EQ(levels[2].height, 2u);
+	EXPECT_EQ(levels.back().width, 1u);
+	EXPECT_EQ(levels.back().height, 1u);
+
+	// Normals that cancel out in XY stay unit length after averaging
+	ImageData normals;
+	normals.width = 2;
+	normals.height = 1;
+	normals.pixels = { 255, 128, 128, 255, 0, 128, 255, 255 };
+	const auto normalLevels = BuildMipChain(normals, true);
+	ASSERT_EQ(normalLevels.size(), 2u);
+	const uint8_t* n = normalLevels[1].pixels.data();
+	const float x = n[0] / 127.5f - 1.0f, y = n[1] / 127.5f - 1.0f, z = n[2] / 127.5f - 1.0f;
+	EXPECT_NEAR(std::sqrt(x * x + y * y + z * z), 1.0f, 0.02f);
+}
+
+TEST(TextureCompression, GenerateMipmapsPacksTheChain)
+{
+	ImageData image = MakeImage(20, 8);
+	const auto levels = BuildMipChain(image, false);
+	ASSERT_TRUE(TextureLoader::GenerateMipmaps(image));
+
+	ASSERT_EQ(image.mipOffsets.size(), levels.size());
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		const size_t end = i + 1 < levels.size() ? image.mipOffsets[i + 1] : image.pixels.size();
+		ASSERT_EQ(end - image.mipOffsets[i], levels[i].pixels.size());
+		EXPECT_EQ(0, std::memcmp(image.pixels.data() + image.mipOffsets[i], levels[i].pixels.data(), levels[i].pixels.size()));
+	}
+
+	image.isHDR = true;
+	EXPECT_FALSE(TextureLoader::GenerateMipmaps(image));
+}
+
+TEST(Ktx2, WritesAndParsesMipChain)
+{
+	const ImageData image = MakeImage(16, 8);
+	std::vector<std::vector<uint8_t>> levels;
+	for (const ImageData& mip : BuildMipChain(image, false))
+		levels.push_back(CompressImage(BlockFormat::BC7, mip.pixels.data(), mip.width, mip.height));
+
+	const std::string path = TempPath("nb_ktx2_roundtrip.ktx2");
+	ASSERT_TRUE(WriteKtx2(path, Ktx2Format::BC7_UNORM, 16, 8, levels));
+	const std::vector<uint8_t> bytes = ReadFile(path);
+
+	Ktx2Image parsed;
+	std::string error;
+	ASSERT_TRUE(ParseKtx2(bytes.data(), bytes.size(), parsed, error)) << error;
+	EXPECT_EQ(parsed.format, TextureFormat::BC7_RGBA);
+	EXPECT_EQ(parsed.width, 16u);
+	EXPECT_EQ(parsed.height, 8u);
+	ASSERT_EQ(parsed.levels.size(), levels.size());
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		ASSERT_EQ(parsed.levels[i].size, levels[i].size());
+		EXPECT_EQ(parsed.levels[i].offset % 16, 0u);
+		EXPECT_EQ(0, std::memcmp(bytes.data() + parsed.levels[i].offset, levels[i].data(), levels[i].size()));
+	}
+
+	// A mip whose size doesn't match its extent is refused at write time
+	levels[1].pop_back();
+	EXPECT_FALSE(WriteKtx2(path, Ktx2Format::BC7_UNORM, 16, 8, levels));
+	std::filesystem::remove(path);
+}
+
+TEST(Ktx2, RejectsSupercompressedAndTruncatedFiles)
+{
+	const ImageData image = MakeImage(8, 8);
+	const std::string path = TempPath("nb_ktx2_reject.ktx2");
+	ASSERT_TRUE(WriteKtx2(path, Ktx2Format::BC5_UNORM, 8, 8,
+		{ CompressImage(BlockFormat::BC5, image.pixels.data(), 8, 8) }));
+	std::vector<uint8_t> bytes = ReadFile(path);
+	std::filesystem::remove(path);
+
+	Ktx2Image parsed;
+	std::string error;
+	ASSERT_TRUE(ParseKtx2(bytes.data(), bytes.size(), parsed, error)) << error;
+	EXPECT_EQ(parsed.format, TextureFormat::BC5_RG);
+
+	std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+	EXPECT_FALSE(ParseKtx2(truncated.data(), truncated.size(), parsed, error));
+
+	// supercompressionScheme sits at byte 44; 1 is BasisLZ
+	std::vector<uint8_t> basis = bytes;
+	basis[44] = 1;
+	EXPECT_FALSE(ParseKtx2(basis.data(), basis.size(), parsed, error));
+	EXPECT_NE(error.find("BasisLZ"), std::string::npos);
+
+	bytes[1] = 'X';
+	EXPECT_FALSE(ParseKtx2(bytes.data(), bytes.size(), parsed, error));
+}
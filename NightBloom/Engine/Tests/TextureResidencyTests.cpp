@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+// TextureResidencyTests.cpp
+//
+// Unit tests for streamed-texture mip residency planning
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/TextureResidency.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// Uncompressed RGBA8 chain of a square power-of-two texture
+	std::vector<uint64_t> ChainBytes(uint32_t size)
+	{
+		std::vector<uint64_t> levels;
+		for (uint32_t s = size; ; s /= 2)
+		{
+			levels.push_back(uint64_t(s) * s * 4);
+			if (s == 1)
+				break;
+		}
+		return levels;
+	}
+}
+
+TEST(TextureResidency, RequestedMipMatchesScreenFootprint)
+{
+	EXPECT_EQ(ComputeRequestedMip(1024, 2048.0f, 11), 0u);
+	EXPECT_EQ(ComputeRequestedMip(1024, 1024.0f, 11), 0u);
+	EXPECT_EQ(ComputeRequestedMip(1024, 300.0f, 11), 1u);   // 512 texels still cover 300 pixels
+	EXPECT_EQ(ComputeRequestedMip(1024, 256.0f, 11), 2u);
+	EXPECT_EQ(ComputeRequestedMip(1024, 0.1f, 11), 10u);
+	EXPECT_EQ(ComputeRequestedMip(1024, 0.0f, 11), 10u);
+	EXPECT_EQ(ComputeRequestedMip(1024, 300.0f, 11, 1.0f), 2u);
+}
+
+TEST(TextureResidency, StartsAtTheTailAndStreamsTowardTheRequest)
+{
+	TextureResidency residency;
+	const auto levels = ChainBytes(256);   // 9 levels, tail at 64 = mip 2
+	const auto handle = residency.Register(levels, 2);
+	EXPECT_EQ(residency.GetResidentMip(handle), 2u);
+	EXPECT_EQ(residency.GetResidentBytes(), residency.GetBytes(handle, 2));
+
+	// Nothing requested: nothing to do
+	EXPECT_TRUE(residency.Update(UINT64_MAX, 1).empty());
+
+	residency.Request(handle, 1, 2);
+	residency.Request(handle, 0, 2);   // finest request of the frame wins
+	residency.Request(handle, 3, 2);
+	const auto changes = residency.Update(UINT64_MAX, 2);
+	ASSERT_EQ(changes.size(), 1u);
+	EXPECT_EQ(changes[0].handle, handle);
+	EXPECT_EQ(changes[0].mip, 0u);
+
+	// In flight: no second change, resident bytes unchanged until Complete
+	EXPECT_TRUE(residency.Update(UINT64_MAX, 3).empty());
+	EXPECT_EQ(residency.GetPendingCount(), 1u);
+	EXPECT_EQ(residency.GetResidentBytes(), residency.GetBytes(handle, 2));
+
+	residency.Complete(handle);
+	EXPECT_EQ(residency.GetResidentMip(handle), 0u);
+	EXPECT_EQ(residency.GetPendingCount(), 0u);
+	EXPECT_EQ(residency.GetResidentBytes(), residency.GetBytes(handle, 0));
+}
+
+TEST(TextureResidency, StreamsOnlyAsFarAsTheBudgetAllows)
+{
+	TextureResidency residency;
+	const auto handle = residency.Register(ChainBytes(256), 2);
+
+	// Room for mips 1.. but not the 256 KB mip 0
+	const uint64_t budget = residency.GetBytes(handle, 1) + 100;
+	residency.Request(handle, 0, 1);
+	const auto changes = residency.Update(budget, 1);
+	ASSERT_EQ(changes.size(), 1u);
+	EXPECT_EQ(changes[0].mip, 1u);
+	residency.Complete(handle);
+
+	// Still no room for mip 0 on later frames
+	residency.Request(handle, 0, 2);
+	EXPECT_TRUE(residency.Update(budget, 2).empty());
+}
+
+TEST(TextureResidency, UnwantedLevelsStayCachedUntilTheBudgetNeedsThem)
+{
+	TextureResidency residency;
+	const auto handle = residency.Register(ChainBytes(256), 2);
+	residency.Request(handle, 0, 1);
+	residency.Update(UINT64_MAX, 1);
+	residency.Complete(handle);
+
+	// The request moves away: under budget the levels stay
+	residency.Request(handle, 2, 2);
+	EXPECT_TRUE(residency.Update(UINT64_MAX, 2).empty());
+
+	// Over budget: dropped straight to what is wanted
+	const auto changes = residency.Update(residency.GetBytes(handle, 2), 3);
+	ASSERT_EQ(changes.size(), 1u);
+	EXPECT_EQ(changes[0].mip, 2u);
+	residency.Complete(handle);
+	EXPECT_EQ(residency.GetResidentBytes(), residency.GetBytes(handle, 2));
+}
+
+TEST(TextureResidency, EvictsLeastRecentlyRequestedFirst)
+{
+	TextureResidency residency;
+	const auto older = residency.Register(ChainBytes(256), 2);
+	const auto newer = residency.Register(ChainBytes(256), 2);
+	residency.Request(older, 0, 1);
+	residency.Request(newer, 0, 1);
+	ASSERT_EQ(residency.Update(UINT64_MAX, 1).size(), 2u);
+	residency.Complete(older);
+	residency.Complete(newer);
+
+	// Both are still in use; room for only one full chain plus a tail
+	residency.Request(newer, 0, 5);
+	residency.Request(older, 0, 4);
+	const uint64_t budget = residency.GetBytes(newer, 0) + residency.GetBytes(older, 1);
+	const auto changes = residency.Update(budget, 5);
+	ASSERT_EQ(changes.size(), 1u);
+	EXPECT_EQ(changes[0].handle, older);
+	EXPECT_EQ(changes[0].mip, 1u);
+}
+
+TEST(TextureResidency, StaleRequestsFallBackToTheTail)
+{
+	TextureResidencySettings settings;
+	settings.requestTimeoutFrames = 10;
+	TextureResidency residency(settings);
+	const auto handle = residency.Register(ChainBytes(256), 2);
+
+	residency.Request(handle, 0, 1);
+	EXPECT_EQ(residency.GetWantedMip(handle, 11), 0u);
+	EXPECT_EQ(residency.GetWantedMip(handle, 12), 2u);
+
+	// Requests coarser than the tail still keep the tail
+	residency.Request(handle, 7, 20);
+	EXPECT_EQ(residency.GetWantedMip(handle, 20), 2u);
+}
+
+TEST(TextureResidency, CapsChangesAndUploadBytesPerUpdate)
+{
+	TextureResidencySettings settings;
+	settings.maxChangesPerUpdate = 2;
+	settings.maxUploadBytesPerUpdate = 300 * 1024;
+	TextureResidency residency(settings);
+
+	std::vector<TextureResidency::Handle> handles;
+	for (int i = 0; i < 4; ++i)
+	{
+		handles.push_back(residency.Register(ChainBytes(256), 2));
+		residency.Request(handles.back(), 0, 1);
+	}
+
+	// One 341 KB chain already exceeds the byte cap, but the first change
+	// of an update always goes through
+	auto changes = residency.Update(UINT64_MAX, 1);
+	ASSERT_EQ(changes.size(), 1u);
+
+	// Two changes at most once the chains fit the cap
+	settings.maxUploadBytesPerUpdate = UINT64_MAX;
+	TextureResidency uncapped(settings);
+	for (int i = 0; i < 4; ++i)
+		uncapped.Request(uncapped.Register(ChainBytes(256), 2), 0, 1);
+	EXPECT_EQ(uncapped.Update(UINT64_MAX, 1).size(), 2u);
+}
+
+TEST(TextureResidency, UnregisterReleasesBytesAndHandles)
+{
+	TextureResidency residency;
+	const auto first = residency.Register(ChainBytes(64), 0);
+	const auto second = residency.Register(ChainBytes(128), 1);
+	residency.Request(second, 0, 1);
+	ASSERT_EQ(residency.Update(UINT64_MAX, 1).size(), 1u);
+
+	residency.Unregister(second);
+	EXPECT_EQ(residency.GetPendingCount(), 0u);
+	EXPECT_EQ(residency.GetResidentBytes(), residency.GetBytes(first, 0));
+	EXPECT_FALSE(residency.IsRegistered(second));
+
+	// Completing a change of an unregistered texture is a no-op
+	residency.Complete(second);
+	EXPECT_EQ(residency.Register(ChainBytes(32), 0), second);
+}
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// ThreadPlacementTests.cpp
+//
+// Unit tests for core selection on hybrid CPUs and placement settings
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/ThreadPlacement.hpp"
+
+using namespace Nightbloom;
+
+namespace
+{
+	// 4 performance processors (class 1) then 4 efficiency ones, CPU set ids from 256
+	CpuTopology MakeHybrid()
+	{
+		CpuTopology topology;
+		for (uint32_t i = 0; i < 8; ++i)
+			topology.processors.push_back({ i, 256 + i, static_cast<uint8_t>(i < 4 ? 1 : 0) });
+		return topology;
+	}
+}
+
+TEST(ThreadPlacementTest, ParsesSysfsCpuLists)
+{
+	std::vector<uint32_t> cpus;
+	ASSERT_TRUE(CpuTopology::ParseCpuList("0-3,8,10-11", cpus));
+	EXPECT_EQ(cpus, (std::vector<uint32_t>{ 0, 1, 2, 3, 8, 10, 11 }));
+	ASSERT_TRUE(CpuTopology::ParseCpuList("5", cpus));
+	EXPECT_EQ(cpus, (std::vector<uint32_t>{ 5 }));
+
+	for (const char* bad : { "", "3-1", "a", "1,,2", "-2", "1-" })
+		EXPECT_FALSE(CpuTopology::ParseCpuList(bad, cpus)) << bad;
+	EXPECT_EQ(cpus, (std::vector<uint32_t>{ 5 }));   // untouched on failure
+}
+
+TEST(ThreadPlacementTest, HybridTopologySelectsByEfficiencyClass)
+{
+	const CpuTopology topology = MakeHybrid();
+	EXPECT_TRUE(topology.IsHybrid());
+	EXPECT_EQ(topology.Select(CoreSet::Performance), (std::vector<uint32_t>{ 256, 257, 258, 259 }));
+	EXPECT_EQ(topology.Select(CoreSet::Efficiency), (std::vector<uint32_t>{ 260, 261, 262, 263 }));
+	EXPECT_TRUE(topology.Select(CoreSet::Any).empty());
+	EXPECT_EQ(topology.Count(CoreSet::Performance), 4u);
+	EXPECT_EQ(topology.Count(CoreSet::Any), 8u);
+}
+
+TEST(ThreadPlacementTest, UniformTopologyPinsNothing)
+{
+	CpuTopology topology;
+	for (uint32_t i = 0; i < 6; ++i)
+		topology.processors.push_back({ i, i, 3 });
+
+	EXPECT_FALSE(topology.IsHybrid());
+	EXPECT_TRUE(topology.Select(CoreSet::Performance).empty());
+	EXPECT_TRUE(topology.Select(CoreSet::Efficiency).empty());
+	EXPECT_EQ(topology.Count(CoreSet::Efficiency), 6u);
+}
+
+TEST(ThreadPlacementTest, ParsesSettingsText)
+{
+	ThreadPlacementSettings settings;
+	ASSERT_TRUE(ThreadPlacement::ParseSettings("background=any:normal, Worker=E", settings));
+	EXPECT_TRUE(settings.enabled);
+	EXPECT_EQ(settings.GetRule(ThreadRole::Background).cores, CoreSet::Any);
+	EXPECT_EQ(settings.GetRule(ThreadRole::Background).priority, ThreadPriority::Normal);
+	EXPECT_EQ(settings.GetRule(ThreadRole::Worker).cores, CoreSet::Efficiency);
+	EXPECT_EQ(settings.GetRule(ThreadRole::Worker).priority, ThreadPriority::Normal);   // kept
+	EXPECT_EQ(settings.GetRule(ThreadRole::FrameCritical).priority, ThreadPriority::High);
+
+	ASSERT_TRUE(ThreadPlacement::ParseSettings("off", settings));
+	EXPECT_FALSE(settings.enabled);
+	EXPECT_EQ(settings.GetRule(ThreadRole::Worker).cores, CoreSet::Efficiency);
+
+	for (const char* bad : { "frame", "gpu=any", "worker=fast", "worker=any:urgent" })
+		EXPECT_FALSE(ThreadPlacement::ParseSettings(bad, settings)) << bad;
+	EXPECT_FALSE(settings.enabled);   // untouched on failure
+}
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// TripleBufferTests.cpp
+//
+// Unit tests for the single-producer / single-consumer snapshot handoff
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/TripleBuffer.hpp"
+#include <thread>
+
+using namespace Nightbloom;
+
+TEST(TripleBufferTest, ConsumerSeesOnlyFreshPublishes)
+{
+	TripleBuffer<int> buffer;
+	EXPECT_FALSE(buffer.AcquireLatest());
+
+	buffer.GetWriteSlot() = 7;
+	buffer.Publish();
+	ASSERT_TRUE(buffer.AcquireLatest());
+	EXPECT_EQ(buffer.GetReadSlot(), 7);
+
+	// Nothing new: the read slot stays put
+	EXPECT_FALSE(buffer.AcquireLatest());
+	EXPECT_EQ(buffer.GetReadSlot(), 7);
+}
+
+TEST(TripleBufferTest, SlowConsumerSkipsToTheNewest)
+{
+	TripleBuffer<int> buffer;
+	for (int value = 1; value <= 5; ++value)
+	{
+		buffer.GetWriteSlot() = value;
+		buffer.Publish();
+	}
+
+	ASSERT_TRUE(buffer.AcquireLatest());
+	EXPECT_EQ(buffer.GetReadSlot(), 5);
+}
+
+TEST(TripleBufferTest, ProducerNeverWritesTheReadSlot)
+{
+	TripleBuffer<int> buffer;
+	buffer.GetWriteSlot() = 1;
+	buffer.Publish();
+	ASSERT_TRUE(buffer.AcquireLatest());
+
+	const int* reading = &buffer.GetReadSlot();
+	for (int i = 0; i < 8; ++i)
+	{
+		EXPECT_NE(&buffer.GetWriteSlot(), reading);
+		buffer.Publish();
+	}
+}
+
+TEST(TripleBufferTest, ValuesArriveInOrderAcrossThreads)
+{
+	struct Payload { uint32_t a = 0, b = 0; };
+	TripleBuffer<Payload> buffer;
+	constexpr uint32_t kCount = 100000;
+
+	std::thread producer([&buffer]()
+		{
+			for (uint32_t i = 1; i <= kCount; ++i)
+			{
+				Payload& slot = buffer.GetWriteSlot();
+				slot.a = i;
+				slot.b = i * 3;
+				buffer.Publish();
+			}
+		});
+
+	uint32_t last = 0;
+	while (last < kCount)
+	{
+		if (!buffer.AcquireLatest())
+			continue;
+		const Payload& value = buffer.GetReadSlot();
+		ASSERT_GT(value.a, last);
+		ASSERT_EQ(value.b, value.a * 3);
+		last = value.a;
+	}
+	producer.join();
+}
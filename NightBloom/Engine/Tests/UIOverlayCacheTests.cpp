@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+// UIOverlayCacheTests.cpp
+//
+// Unit tests for when the cached UI overlay is rebuilt
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/UIOverlayCache.hpp"
+
+using namespace Nightbloom;
+
+TEST(UIOverlayCacheTest, UncachedRebuildsEveryFrame)
+{
+	UIOverlayCache cache;
+	for (int i = 0; i < 5; ++i)
+		EXPECT_TRUE(cache.ShouldRefresh(i * 0.001, false));
+	EXPECT_EQ(cache.GetReusedFrames(), 0u);
+}
+
+TEST(UIOverlayCacheTest, CachedRebuildsAtTheRefreshRate)
+{
+	UIOverlayCache cache;
+	UIOverlaySettings settings;
+	settings.cached = true;
+	settings.refreshRate = 10.0f;
+	cache.SetSettings(settings);
+
+	// The first frame after a setting change always rebuilds
+	EXPECT_TRUE(cache.ShouldRefresh(1.0, false));
+	EXPECT_FALSE(cache.ShouldRefresh(1.016, false));
+	EXPECT_FALSE(cache.ShouldRefresh(1.05, false));
+	EXPECT_TRUE(cache.ShouldRefresh(1.1, false));
+	EXPECT_EQ(cache.GetReusedFrames(), 2u);
+
+	// 0: only input or an invalidation rebuilds
+	settings.refreshRate = 0.0f;
+	cache.SetSettings(settings);
+	EXPECT_TRUE(cache.ShouldRefresh(2.0, false));
+	EXPECT_FALSE(cache.ShouldRefresh(60.0, false));
+	cache.Invalidate();
+	EXPECT_TRUE(cache.ShouldRefresh(60.1, false));
+}
+
+TEST(UIOverlayCacheTest, InputRebuildsForTheGraceFrames)
+{
+	UIOverlayCache cache;
+	UIOverlaySettings settings;
+	settings.cached = true;
+	settings.refreshRate = 0.0f;
+	settings.graceFrames = 3;
+	cache.SetSettings(settings);
+	EXPECT_TRUE(cache.ShouldRefresh(0.0, false));
+	EXPECT_FALSE(cache.ShouldRefresh(0.01, false));
+
+	EXPECT_TRUE(cache.ShouldRefresh(0.02, true));
+	EXPECT_TRUE(cache.ShouldRefresh(0.03, false));
+	EXPECT_TRUE(cache.ShouldRefresh(0.04, false));
+	EXPECT_FALSE(cache.ShouldRefresh(0.05, false));
+
+	// A widget held down keeps it live
+	for (int i = 0; i < 10; ++i)
+		EXPECT_TRUE(cache.ShouldRefresh(0.1 + i * 0.01, true));
+}
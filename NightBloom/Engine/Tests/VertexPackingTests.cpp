@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+// VertexPackingTests.cpp
+//
+// Unit tests for compressed (16-byte) mesh vertices
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Renderer/VertexPacking.hpp"
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Nightbloom;
+
+namespace
+{
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	glm::vec3 RandomUnit(std::mt19937& rng)
+	{
+		std::normal_distribution<float> gauss;
+		glm::vec3 v;
+		do { v = glm::vec3(gauss(rng), gauss(rng), gauss(rng)); } while (glm::length(v) < 1e-3f);
+		return glm::normalize(v);
+	}
+}
+
+TEST(VertexPacking, HalfFloatRoundTrip)
+{
+	for (float value : { 0.0f, 1.0f, -2.5f, 0.333f, 1024.0f, 65504.0f, 6.1035e-5f, 3.0e-6f })
+	{
+		const float back = HalfToFloat(FloatToHalf(value));
+		EXPECT_NEAR(back, value, std::abs(value) / 1024.0f + 6e-8f) << value;
+	}
+	EXPECT_EQ(FloatToHalf(1.0f), 0x3C00u);
+	EXPECT_EQ(FloatToHalf(-2.0f), 0xC000u);
+	EXPECT_EQ(FloatToHalf(1.0e6f), 0x7C00u);   // overflows to infinity
+	EXPECT_TRUE(std::isinf(HalfToFloat(0x7C00u)));
+}
+
+TEST(VertexPacking, OctahedralCoversSphere)
+{
+	std::mt19937 rng(3);
+	for (int i = 0; i < 2000; ++i)
+	{
+		const glm::vec3 n = RandomUnit(rng);
+		const glm::vec2 e = OctEncode(n);
+		EXPECT_LE(std::abs(e.x), 1.0f);
+		EXPECT_LE(std::abs(e.y), 1.0f);
+		EXPECT_GT(glm::dot(OctDecode(e), n), 0.99999f);
+	}
+	// Poles and the folded seam
+	for (const glm::vec3& n : { glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 0, 0), glm::vec3(0, -1, 0) })
+		EXPECT_GT(glm::dot(OctDecode(OctEncode(n)), n), 0.99999f);
+}
+
+TEST(VertexPacking, PackedMeshMatchesSource)
+{
+	// A long, flat slab: the worst case for the non-uniform dequant scale
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<Vertex> vertices(1000);
+	glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+	for (Vertex& v : vertices)
+	{
+		v.position = glm::vec3(unit(rng) * 40.0f - 20.0f, unit(rng) * 0.01f, unit(rng) * 3.0f);
+		v.normal = RandomUnit(rng);
+		v.texCoord = glm::vec2(unit(rng) * 4.0f, unit(rng));
+		boundsMin = glm::min(boundsMin, v.position);
+		boundsMax = glm::max(boundsMax, v.position);
+	}
+
+	const VertexQuantization quantization = ComputeVertexQuantization(boundsMin, boundsMax);
+	std::vector<PackedVertex> packed(vertices.size());
+	PackVertices(&vertices.data()->position, &vertices.data()->normal, &vertices.data()->texCoord,
+		sizeof(Vertex), vertices.size(), quantization, packed.data());
+
+	const glm::mat4 dequantize = quantization.GetDequantizeTransform();
+	const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(dequantize)));
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		const Vertex& v = vertices[i];
+		const glm::vec3 position = UnpackPosition(packed[i], quantization);
+		EXPECT_LT(glm::length(position - v.position), 40.0f / 65535.0f) << i;
+
+		// What Mesh.vert computes: unorm position through the dequant matrix
+		const glm::vec3 unorm(packed[i].position[0] / 65535.0f, packed[i].position[1] / 65535.0f, packed[i].position[2] / 65535.0f);
+		EXPECT_LT(glm::length(glm::vec3(dequantize * glm::vec4(unorm, 1.0f)) - position), 1e-4f) << i;
+
+		const glm::vec3 normal = UnpackNormal(packed[i], quantization);
+		EXPECT_GT(glm::dot(normal, v.normal), 0.9995f) << i;
+		const glm::vec3 octahedral = OctDecode(glm::vec2(packed[i].normal[0], packed[i].normal[1]) / 32767.0f);
+		EXPECT_GT(glm::dot(glm::normalize(normalMatrix * octahedral), v.normal), 0.9995f) << i;
+
+		const glm::vec2 texCoord = UnpackTexCoord(packed[i]);
+		EXPECT_NEAR(texCoord.x, v.texCoord.x, 2e-3f);
+		EXPECT_NEAR(texCoord.y, v.texCoord.y, 5e-4f);
+	}
+}
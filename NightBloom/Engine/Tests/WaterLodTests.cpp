@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// WaterLodTests.cpp
+//
+// Unit tests for the water plane's LOD grid settings
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Hydro/WaterLod.hpp"
+
+using namespace Nightbloom;
+
+TEST(WaterLodTest, PatchQuadsAreEvenAndClamped)
+{
+	EXPECT_EQ(WaterLod::GetPatchQuads(32), 32u);
+	EXPECT_EQ(WaterLod::GetPatchQuads(33), 34u);
+	EXPECT_EQ(WaterLod::GetPatchQuads(0), WaterLod::MIN_PATCH_QUADS);
+	EXPECT_EQ(WaterLod::GetPatchQuads(1000), WaterLod::MAX_PATCH_QUADS);
+}
+
+TEST(WaterLodTest, FinestCellsStayWithinTheRequestedSize)
+{
+	for (float worldSize : { 16.0f, 200.0f, 1000.0f, 8192.0f })
+	{
+		const float cell = WaterLod::GetFinestCellSize(worldSize, 32, 0.5f);
+		EXPECT_LE(cell, 0.5f) << worldSize;
+		EXPECT_GT(cell, 0.25f) << worldSize;   // no finer than needed
+	}
+
+	// 16 cells of 0.5 make 8-unit leaves: 200 / 8 = 25 -> 6 levels
+	EXPECT_EQ(WaterLod::GetLevelCount(200.0f, 16, 0.5f), 6u);
+	EXPECT_EQ(WaterLod::GetLevelCount(4.0f, 16, 0.5f), 1u);
+}
+
+TEST(WaterLodTest, PatchCountGrowsSlowlyWithThePlane)
+{
+	// The camera just above the middle of a small plane and one with 1600x
+	// its area: the large one only adds coarser levels
+	TerrainQuadtree quadtree;
+	std::vector<TerrainPatch> small;
+	std::vector<TerrainPatch> large;
+	quadtree.Select(WaterLod::MakeQuadtreeSettings(200.0f, 32, 0.5f, 4.0f), glm::vec3(0.0f, 2.0f, 0.0f), small);
+	quadtree.Select(WaterLod::MakeQuadtreeSettings(8000.0f, 32, 0.5f, 4.0f), glm::vec3(0.0f, 2.0f, 0.0f), large);
+
+	ASSERT_FALSE(small.empty());
+	EXPECT_LT(large.size(), small.size() * 4);
+
+	// The finest patches sit under the camera in both
+	for (const std::vector<TerrainPatch>* patches : { &small, &large })
+	{
+		bool finestUnderCamera = false;
+		for (const TerrainPatch& patch : *patches)
+		{
+			const bool underCamera = patch.offsetSize.x <= 0.0f && patch.offsetSize.y <= 0.0f &&
+				patch.offsetSize.x + patch.offsetSize.z >= 0.0f && patch.offsetSize.y + patch.offsetSize.z >= 0.0f;
+			finestUnderCamera |= underCamera && patch.offsetSize.w == 0.0f;
+		}
+		EXPECT_TRUE(finestUnderCamera);
+	}
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// WindTests.cpp
+//
+// Unit tests for the analytic wind and its toroidal field window
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../VFX/Wind.hpp"
+#include <set>
+#include <utility>
+
+using namespace Nightbloom;
+
+TEST(WindTest, DisabledWindIsStill)
+{
+	WindSettings settings;
+	settings.enabled = false;
+	const WindSample sample = Wind::Evaluate(settings, glm::vec2(12.0f, -40.0f), 3.5f);
+	EXPECT_EQ(sample.sway, glm::vec2(0.0f));
+	EXPECT_EQ(sample.gust, 0.0f);
+	EXPECT_EQ(Wind::Push(sample), 1.0f);
+}
+
+TEST(WindTest, SwayTravelsDownwind)
+{
+	WindSettings settings;
+	settings.directionDeg = 90.0f;   // +Z
+	settings.gustStrength = 0.0f;
+
+	// The wave at z after dt is the wave at z - speed / frequency * dt now
+	const float dt = 0.25f;
+	const float shift = settings.speed / settings.frequency * dt;
+	for (float z : { -30.0f, 0.0f, 17.0f })
+	{
+		const glm::vec2 later = Wind::Evaluate(settings, glm::vec2(0.0f, z), 2.0f + dt).sway;
+		const glm::vec2 now = Wind::Evaluate(settings, glm::vec2(0.0f, z - shift), 2.0f).sway;
+		const float laterTheta = std::atan2(later.y, later.x);
+		const float nowTheta = std::atan2(now.y, now.x);
+		EXPECT_NEAR(std::cos(laterTheta - nowTheta), 1.0f, 1e-4f) << z;
+	}
+}
+
+TEST(WindTest, BladePhaseRotatesTheSway)
+{
+	WindSettings settings;
+	const WindSample sample = Wind::Evaluate(settings, glm::vec2(3.0f, 8.0f), 1.25f);
+	const float amplitude = glm::length(sample.sway);
+	const float theta = std::atan2(sample.sway.y, sample.sway.x);
+	for (float phase : { 0.0f, 1.0f, 2.5f, 4.0f })
+		EXPECT_NEAR(Wind::Sway(sample, phase), amplitude * std::sin(theta + phase), 1e-5f) << phase;
+}
+
+TEST(WindTest, GustsStayWithinTheirStrength)
+{
+	WindSettings settings;
+	float strongest = 0.0f;
+	for (int i = 0; i < 400; ++i)
+	{
+		const WindSample sample = Wind::Evaluate(settings, glm::vec2(i * 0.7f, i * -0.3f), i * 0.05f);
+		EXPECT_GE(sample.gust, 0.0f);
+		EXPECT_LE(sample.gust, settings.gustStrength + 1e-6f);
+		strongest = std::max(strongest, sample.gust);
+	}
+	EXPECT_GT(strongest, 0.5f * settings.gustStrength);
+}
+
+TEST(WindTest, FieldWindowMapsEachCellToOneTexel)
+{
+	const int n = static_cast<int>(Wind::FIELD_RESOLUTION);
+	for (const glm::vec2 camera : { glm::vec2(0.0f), glm::vec2(-123.4f, 567.8f), glm::vec2(1000.0f, -3.0f) })
+	{
+		const glm::ivec2 origin = Wind::FieldOrigin(camera, 4.0f);
+		const glm::ivec2 cameraCell = glm::ivec2(glm::floor(camera / 4.0f));
+		EXPECT_EQ(origin + n / 2, cameraCell);
+
+		std::set<std::pair<int, int>> cells;
+		for (int y = 0; y < n; ++y)
+		{
+			for (int x = 0; x < n; ++x)
+			{
+				const glm::ivec2 cell = Wind::TexelCell(glm::ivec2(x, y), origin);
+				EXPECT_GE(cell.x, origin.x);
+				EXPECT_LT(cell.x, origin.x + n);
+				EXPECT_GE(cell.y, origin.y);
+				EXPECT_LT(cell.y, origin.y + n);
+				// A repeating sampler at uv = cell / n lands on this texel
+				EXPECT_EQ(((cell.x % n) + n) % n, x);
+				EXPECT_EQ(((cell.y % n) + n) % n, y);
+				cells.insert({ cell.x, cell.y });
+			}
+		}
+		EXPECT_EQ(cells.size(), static_cast<size_t>(n * n));
+	}
+}
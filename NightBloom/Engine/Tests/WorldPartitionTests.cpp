@@ -0,0 +1,238 @@
+//------------------------------------------------------------------------------
+// WorldPartitionTests.cpp
+//
+// Unit tests for world-partition cell streaming decisions
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../Core/WorldPartition.hpp"
+#include <algorithm>
+
+using namespace Nightbloom;
+
+namespace
+{
+	WorldPartitionSettings TestSettings()
+	{
+		WorldPartitionSettings settings;
+		settings.cellSize = 10.0f;
+		settings.loadRadius = 15.0f;
+		settings.unloadRadius = 25.0f;
+		settings.prefetchSeconds = 0.0f;
+		settings.memoryBudget = 1ull << 40;
+		settings.maxLoadsInFlight = 100;
+		return settings;
+	}
+
+	// One cell of `bytes` centred on every (x, z) in [-range, range]^2 cells
+	void FillGrid(WorldPartition& partition, int32_t range, uint64_t bytes)
+	{
+		const float size = partition.GetSettings().cellSize;
+		for (int32_t z = -range; z <= range; ++z)
+			for (int32_t x = -range; x <= range; ++x)
+				partition.AddContent(glm::vec3((x + 0.5f) * size, 0.0f, (z + 0.5f) * size), bytes);
+	}
+
+	bool Contains(const std::vector<uint32_t>& cells, uint32_t cell)
+	{
+		return std::find(cells.begin(), cells.end(), cell) != cells.end();
+	}
+
+	// Updates at `position` (marking every load done) until nothing changes
+	void Settle(WorldPartition& partition, const glm::vec3& position, const glm::vec3& velocity = glm::vec3(0.0f))
+	{
+		std::vector<uint32_t> loads, unloads;
+		for (int frame = 0; frame < 100; ++frame)
+		{
+			partition.Update(position, velocity, loads, unloads);
+			for (uint32_t cell : loads)
+				partition.MarkLoaded(cell);
+			if (loads.empty() && unloads.empty())
+				break;
+		}
+	}
+}
+
+TEST(WorldPartitionTest, MapsPositionsToCellsBelowZero)
+{
+	WorldPartition partition(TestSettings());
+
+	EXPECT_EQ(partition.CellOf(glm::vec3(0.0f)), (WorldCellCoord{ 0, 0 }));
+	EXPECT_EQ(partition.CellOf(glm::vec3(9.9f, 100.0f, 10.0f)), (WorldCellCoord{ 0, 1 }));
+	EXPECT_EQ(partition.CellOf(glm::vec3(-0.1f, 0.0f, -10.0f)), (WorldCellCoord{ -1, -1 }));
+	EXPECT_EQ(partition.CellOf(glm::vec3(-10.1f, 0.0f, 25.0f)), (WorldCellCoord{ -2, 2 }));
+}
+
+TEST(WorldPartitionTest, ContentInOneCellSharesIt)
+{
+	WorldPartition partition(TestSettings());
+
+	const uint32_t a = partition.AddContent(glm::vec3(1.0f, 0.0f, 1.0f), 100);
+	const uint32_t b = partition.AddContent(glm::vec3(9.0f, 50.0f, 9.0f), 50);
+	const uint32_t c = partition.AddContent(glm::vec3(-1.0f, 0.0f, 1.0f), 10);
+
+	EXPECT_EQ(a, b);
+	EXPECT_NE(a, c);
+	EXPECT_EQ(partition.GetCellCount(), 2u);
+	EXPECT_EQ(partition.GetBytes(a), 150u);
+	EXPECT_EQ(partition.FindCell({ -1, 0 }), c);
+	EXPECT_EQ(partition.FindCell({ 5, 5 }), WorldPartition::INVALID);
+}
+
+TEST(WorldPartitionTest, LoadsCellsWithinRadiusNearestFirst)
+{
+	WorldPartition partition(TestSettings());
+	FillGrid(partition, 4, 1);
+
+	std::vector<uint32_t> loads, unloads;
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+
+	// Squares within 15 of the centre of cell (0, 0): the 3x3 block and the
+	// four cells two steps out along the axes
+	EXPECT_EQ(loads.size(), 13u);
+	EXPECT_TRUE(unloads.empty());
+	ASSERT_FALSE(loads.empty());
+	EXPECT_EQ(partition.GetCoord(loads[0]), (WorldCellCoord{ 0, 0 }));
+	EXPECT_TRUE(Contains(loads, partition.FindCell({ -2, 0 })));
+	EXPECT_FALSE(Contains(loads, partition.FindCell({ 2, 1 })));
+	EXPECT_FALSE(Contains(loads, partition.FindCell({ 3, 0 })));
+	for (uint32_t cell : loads)
+		EXPECT_EQ(partition.GetState(cell), WorldCellState::Loading);
+
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_TRUE(loads.empty());
+	EXPECT_EQ(partition.GetLoadingCount(), 13u);
+}
+
+TEST(WorldPartitionTest, LimitsLoadsInFlight)
+{
+	WorldPartitionSettings settings = TestSettings();
+	settings.maxLoadsInFlight = 3;
+	WorldPartition partition(settings);
+	FillGrid(partition, 4, 1);
+
+	std::vector<uint32_t> loads, unloads;
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	ASSERT_EQ(loads.size(), 3u);
+	EXPECT_EQ(partition.GetCoord(loads[0]), (WorldCellCoord{ 0, 0 }));
+
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_TRUE(loads.empty());
+
+	partition.MarkLoaded(partition.FindCell({ 0, 0 }));
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_EQ(loads.size(), 1u);
+	EXPECT_EQ(partition.GetLoadedCount(), 1u);
+}
+
+TEST(WorldPartitionTest, UnloadsOnlyPastTheUnloadRadius)
+{
+	WorldPartition partition(TestSettings());
+	FillGrid(partition, 6, 1);
+	Settle(partition, glm::vec3(5.0f, 0.0f, 5.0f));
+
+	const uint32_t west = partition.FindCell({ -2, 0 });
+	ASSERT_EQ(partition.GetState(west), WorldCellState::Loaded);
+
+	// 25 from the camera: no longer wanted, but not past the unload radius
+	std::vector<uint32_t> loads, unloads;
+	partition.Update(glm::vec3(15.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_FALSE(Contains(unloads, west));
+	EXPECT_EQ(partition.GetState(west), WorldCellState::Loaded);
+
+	partition.Update(glm::vec3(35.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_TRUE(Contains(unloads, west));
+	EXPECT_EQ(partition.GetState(west), WorldCellState::Unloaded);
+}
+
+TEST(WorldPartitionTest, CancelsLoadsTheCameraLeftBehind)
+{
+	WorldPartition partition(TestSettings());
+	FillGrid(partition, 8, 1);
+
+	std::vector<uint32_t> loads, unloads;
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	const uint32_t origin = partition.FindCell({ 0, 0 });
+	ASSERT_TRUE(Contains(loads, origin));
+
+	partition.Update(glm::vec3(75.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_TRUE(Contains(unloads, origin));
+	EXPECT_EQ(partition.GetState(origin), WorldCellState::Unloaded);
+
+	// A late completion of the cancelled load changes nothing
+	partition.MarkLoaded(origin);
+	EXPECT_EQ(partition.GetState(origin), WorldCellState::Unloaded);
+}
+
+TEST(WorldPartitionTest, PrefetchesAlongTheVelocity)
+{
+	WorldPartitionSettings settings = TestSettings();
+	settings.prefetchSeconds = 2.0f;
+	WorldPartition partition(settings);
+	FillGrid(partition, 8, 1);
+
+	// Moving +x at 20/s: the prefetch point is 40 ahead, in cell (4, 0)
+	std::vector<uint32_t> loads, unloads;
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(20.0f, 0.0f, 0.0f), loads, unloads);
+	EXPECT_TRUE(Contains(loads, partition.FindCell({ 5, 0 })));
+	EXPECT_FALSE(Contains(loads, partition.FindCell({ -3, 0 })));
+
+	// The camera's own cells still come first
+	ASSERT_FALSE(loads.empty());
+	EXPECT_EQ(partition.GetCoord(loads[0]), (WorldCellCoord{ 0, 0 }));
+}
+
+TEST(WorldPartitionTest, EvictsLeastRecentlyWantedCellsForTheBudget)
+{
+	WorldPartitionSettings settings = TestSettings();
+	settings.loadRadius = 4.0f;
+	settings.unloadRadius = 1000.0f;     // only the budget unloads
+	settings.memoryBudget = 300;
+	WorldPartition partition(settings);
+	FillGrid(partition, 8, 100);
+
+	// Walk east one cell at a time: each step wants one new cell
+	Settle(partition, glm::vec3(5.0f, 0.0f, 5.0f));
+	Settle(partition, glm::vec3(15.0f, 0.0f, 5.0f));
+	Settle(partition, glm::vec3(25.0f, 0.0f, 5.0f));
+	EXPECT_EQ(partition.GetResidentBytes(), 300u);
+
+	Settle(partition, glm::vec3(35.0f, 0.0f, 5.0f));
+	EXPECT_EQ(partition.GetState(partition.FindCell({ 0, 0 })), WorldCellState::Unloaded);
+	EXPECT_EQ(partition.GetState(partition.FindCell({ 1, 0 })), WorldCellState::Loaded);
+	EXPECT_EQ(partition.GetState(partition.FindCell({ 3, 0 })), WorldCellState::Loaded);
+	EXPECT_LE(partition.GetResidentBytes(), 300u);
+}
+
+TEST(WorldPartitionTest, NeverEvictsWantedCells)
+{
+	WorldPartitionSettings settings = TestSettings();
+	settings.memoryBudget = 500;
+	WorldPartition partition(settings);
+	FillGrid(partition, 4, 100);
+
+	Settle(partition, glm::vec3(5.0f, 0.0f, 5.0f));
+	EXPECT_EQ(partition.GetLoadedCount(), 5u);
+	EXPECT_EQ(partition.GetResidentBytes(), 500u);
+	EXPECT_EQ(partition.GetState(partition.FindCell({ 0, 0 })), WorldCellState::Loaded);
+
+	std::vector<uint32_t> loads, unloads;
+	partition.Update(glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f), loads, unloads);
+	EXPECT_TRUE(loads.empty());
+	EXPECT_TRUE(unloads.empty());
+	EXPECT_EQ(partition.GetOverBudgetCount(), 8u);
+}
+
+TEST(WorldPartitionTest, UnloadAllReleasesEverything)
+{
+	WorldPartition partition(TestSettings());
+	FillGrid(partition, 2, 10);
+	Settle(partition, glm::vec3(5.0f, 0.0f, 5.0f));
+	ASSERT_GT(partition.GetResidentBytes(), 0u);
+
+	std::vector<uint32_t> unloads;
+	partition.UnloadAll(unloads);
+	EXPECT_EQ(unloads.size(), 13u);
+	EXPECT_EQ(partition.GetResidentBytes(), 0u);
+	EXPECT_EQ(partition.GetLoadedCount(), 0u);
+}
@@ -8,17 +8,78 @@
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanFrameUploadBuffer.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/Renderer/Vulkan/VulkanQueueTimeline.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/Components/OcclusionCuller.hpp"
 #include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Renderer/NoiseVolumeCache.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/JobSystem.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
+#include <cmath>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		// Matches RaymarchParams in CloudRaymarch.comp
+		struct RaymarchPushConstants
+		{
+			glm::mat4 prevViewProj;
+			glm::ivec4 checkerboard;  // x = block size (1 = march all), yz = marched pixel in the block, w = history valid
+			glm::vec4 temporal;       // xyz = wind scroll since the history was written, w = noise frame
+			glm::vec4 march;          // x = step count scale, y = transmittance cutoff
+			glm::vec4 coverage;       // xy = Hi-Z mip 0 region, z = mip tested, w = 1: skip texels with no sky
+		};
+		static_assert(sizeof(RaymarchPushConstants) == 128, "Must match CloudRaymarch.comp");
+
+		// March profiles: the main view stops at 1% transmittance; the water
+		// reflection (rippled, Fresnel-weighted) stops at 5%
+		constexpr float MAIN_MIN_TRANSMITTANCE = 0.01f;
+		constexpr float REFLECTION_MIN_TRANSMITTANCE = 0.05f;
+
+		// Pyramid level whose 2x2 texels cover a result texel's footprint,
+		// one level coarser so last frame's silhouettes can shift a little
+		uint32_t CoverageMip(uint32_t pyramidWidth, uint32_t resultWidth, uint32_t mipCount)
+		{
+			const float ratio = static_cast<float>(pyramidWidth) / static_cast<float>(std::max(resultWidth, 1u));
+			const uint32_t level = static_cast<uint32_t>(std::ceil(std::log2(std::max(ratio, 1.0f)))) + 1;
+			return std::min(level, mipCount - 1);
+		}
+
+		// Position of the frameInCycle-th marched pixel in a size x size block
+		// (size a power of two): Bayer order, so the pixels marched on
+		// consecutive frames are spread across the block
+		glm::ivec2 CheckerboardOffset(uint32_t frameInCycle, uint32_t size)
+		{
+			for (uint32_t y = 0; y < size; ++y)
+			{
+				for (uint32_t x = 0; x < size; ++x)
+				{
+					uint32_t rank = 0;
+					for (uint32_t bit = size >> 1, weight = 1; bit > 0; bit >>= 1, weight <<= 2)
+					{
+						const uint32_t bx = (x & bit) ? 1u : 0u;
+						const uint32_t by = (y & bit) ? 1u : 0u;
+						rank += weight * (((bx ^ by) << 1) | by);  // 2x2 Bayer: (0,0)=0 (1,1)=1 (1,0)=2 (0,1)=3
+					}
+					if (rank == frameInCycle)
+						return glm::ivec2(static_cast<int>(x), static_cast<int>(y));
+				}
+			}
+			return glm::ivec2(0);
+		}
+	}
+
 	bool CloudSystem::Initialize(Renderer* renderer)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Clouds);
+
 		if (!renderer)
 		{
 			LOG_ERROR("CloudSystem::Initialize — null renderer");
@@ -35,17 +96,18 @@ namespace Nightbloom
 			return false;
 		}
 
-		for (uint32_t i = 0; i < 2; ++i)
+		VulkanFrameUploadBuffer* uploads = renderer->GetFrameUploads();
+		m_ParamsSlot = uploads->Reserve("CloudParams", sizeof(CloudParamsData));
+		if (!m_ParamsSlot.IsValid())
 		{
-			m_ParamsBuffers[i] = m_Resources->CreateUniformBuffer(
-				"CloudParams_" + std::to_string(i), sizeof(CloudParamsData));
-			if (!m_ParamsBuffers[i])
-			{
-				LOG_ERROR("CloudSystem: failed to create params UBO {}", i);
-				return false;
-			}
+			LOG_ERROR("CloudSystem: failed to reserve params UBO");
+			return false;
+		}
 
-			m_DescriptorManager->UpdateCloudParamsBinding(i, m_ParamsBuffers[i]->GetBuffer(), sizeof(CloudParamsData));
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_DescriptorManager->UpdateCloudParamsBinding(i, uploads->GetBuffer(), sizeof(CloudParamsData),
+				uploads->GetOffset(i, m_ParamsSlot));
 		}
 
 		m_ResultDescriptorSet = m_DescriptorManager->AllocateCloudResultSet();
@@ -72,12 +134,69 @@ namespace Nightbloom
 			return false;
 		}
 
+		// Upsample: the main result in, the composite's full-res image out
+		m_UpsampleInputSet = m_DescriptorManager->AllocateCloudResultSet();
+		m_UpsampleOutputSet = m_DescriptorManager->AllocateComputeImageSet();
+		if (m_UpsampleInputSet == VK_NULL_HANDLE || m_UpsampleOutputSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("CloudSystem: failed to allocate upsample descriptor sets");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			m_HistorySets[i] = m_DescriptorManager->AllocateCloudHistorySet();
+			if (m_HistorySets[i] == VK_NULL_HANDLE)
+			{
+				LOG_ERROR("CloudSystem: failed to allocate cloud history descriptor sets");
+				return false;
+			}
+		}
+
+		// Cloud shadow map: one fixed-size image, rewritten whole each frame
+		TextureDesc shadowDesc{};
+		shadowDesc.width = SHADOW_MAP_SIZE;
+		shadowDesc.height = SHADOW_MAP_SIZE;
+		shadowDesc.depth = 1;
+		shadowDesc.mipLevels = 1;
+		shadowDesc.arrayLayers = 1;
+		shadowDesc.format = TextureFormat::RGBA16F;
+		shadowDesc.usage = TextureUsage::Storage | TextureUsage::Sampled;
+		shadowDesc.generateMips = false;
+		shadowDesc.force3D = false;
+
+		m_ShadowMap = new VulkanTexture(static_cast<VulkanDevice*>(renderer->GetDevice()), renderer->GetMemoryManager());
+		m_ShadowOutputSet = m_DescriptorManager->AllocateComputeImageSet();
+		if (!m_ShadowMap->Initialize(shadowDesc) || m_ShadowOutputSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("CloudSystem: failed to create the cloud shadow map");
+			delete m_ShadowMap;
+			m_ShadowMap = nullptr;
+			return false;
+		}
+		m_DescriptorManager->UpdateComputeImageSet(m_ShadowOutputSet, m_ShadowMap->GetStorageImageView());
+
+		m_NoPyramidSet = m_DescriptorManager->AllocateHiZSampleSet();
+		if (m_NoPyramidSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("CloudSystem: failed to allocate the sky coverage descriptor set");
+			return false;
+		}
+		m_DescriptorManager->UpdateHiZSampleSet(m_NoPyramidSet, m_ShadowMap->GetImageView(), m_ShadowMap->GetImageView(),
+			m_ShadowMap->GetSampler());
+
 		if (!CreateComputePipeline())
 		{
 			LOG_ERROR("CloudSystem: failed to create raymarch compute pipeline");
 			return false;
 		}
 
+		if (!CreateUpsamplePipeline())
+		{
+			LOG_ERROR("CloudSystem: failed to create upsample compute pipeline");
+			return false;
+		}
+
 		LOG_INFO("CloudSystem initialized");
 		return true;
 	}
@@ -98,32 +217,50 @@ namespace Nightbloom
 				vkDestroyPipeline(device, m_RaymarchPipeline, nullptr);
 				m_RaymarchPipeline = VK_NULL_HANDLE;
 			}
+			if (m_ShadowPipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_ShadowPipeline, nullptr);
+				m_ShadowPipeline = VK_NULL_HANDLE;
+			}
 			if (m_RaymarchPipelineLayout != VK_NULL_HANDLE)
 			{
 				vkDestroyPipelineLayout(device, m_RaymarchPipelineLayout, nullptr);
 				m_RaymarchPipelineLayout = VK_NULL_HANDLE;
 			}
+			if (m_UpsamplePipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_UpsamplePipeline, nullptr);
+				m_UpsamplePipeline = VK_NULL_HANDLE;
+			}
+			if (m_UpsamplePipelineLayout != VK_NULL_HANDLE)
+			{
+				vkDestroyPipelineLayout(device, m_UpsamplePipelineLayout, nullptr);
+				m_UpsamplePipelineLayout = VK_NULL_HANDLE;
+			}
 		}
 
+		CancelNoiseJobs();
 		DestroyNoiseTextures();
 		DestroyResultImage();
+		delete m_ShadowMap;
+		m_ShadowMap = nullptr;
+		m_ShadowWindow = glm::vec4(0.0f);
 		m_Ready = false;
 
 		LOG_INFO("CloudSystem shut down");
 	}
 
+	// The noise belongs to the generator's cache (Acquire); once the
+	// generator is gone its Cleanup has already freed it
 	void CloudSystem::DestroyNoiseTextures()
 	{
-		if (m_ShapeTexture)
-		{
-			delete m_ShapeTexture;
-			m_ShapeTexture = nullptr;
-		}
-		if (m_DetailTexture)
+		if (NoiseTextureGenerator* noiseGen = m_Renderer ? m_Renderer->GetNoiseGenerator() : nullptr)
 		{
-			delete m_DetailTexture;
-			m_DetailTexture = nullptr;
+			noiseGen->Release(m_ShapeTexture);
+			noiseGen->Release(m_DetailTexture);
 		}
+		m_ShapeTexture = nullptr;
+		m_DetailTexture = nullptr;
 	}
 
 	void CloudSystem::DestroyResultImage()
@@ -138,6 +275,18 @@ namespace Nightbloom
 			delete m_ReflectionResult;
 			m_ReflectionResult = nullptr;
 		}
+		for (VulkanTexture*& history : m_HistoryTextures)
+		{
+			delete history;
+			history = nullptr;
+		}
+		delete m_CompositeResult;
+		m_CompositeResult = nullptr;
+		m_CompositeWidth = 0;
+		m_CompositeHeight = 0;
+		m_CompositeEverWritten = false;
+		m_HistoryEverWritten = false;
+		m_HistoryValid = false;
 		m_ResultWidth = 0;
 		m_ResultHeight = 0;
 		m_ResultImageEverWritten = false;
@@ -146,9 +295,19 @@ namespace Nightbloom
 
 	bool CloudSystem::Regenerate(const CloudDesc& desc)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Clouds);
+
 		m_Ready = false;
 
-		m_Renderer->WaitForIdle();
+		// Every frame slot's noise bindings are rewritten below, so frames
+		// still using them must finish - a wait on the graphics queue's last
+		// submission (which covers async compute, see ResizeResultImage),
+		// not a device idle. RequestRegenerate avoids even that.
+		VulkanQueueTimeline* timeline = static_cast<VulkanDevice*>(m_Renderer->GetDevice())->GetGraphicsTimeline();
+		timeline->Wait(timeline->GetLastSubmittedValue());
+
+		// This desc supersedes anything still generating in the background
+		CancelNoiseJobs();
 
 		NoiseTextureGenerator* noiseGen = m_Renderer->GetNoiseGenerator();
 		ComputeDispatcher* dispatch = m_Renderer->GetComputeDispatcher();
@@ -161,33 +320,35 @@ namespace Nightbloom
 
 		DestroyNoiseTextures();
 
+		// Only the raymarch samples the noise; keep it on the queue that runs it
+		const NoiseConsumer consumer = m_Renderer->IsAsyncComputeEnabled()
+			? NoiseConsumer::Compute : NoiseConsumer::Graphics;
+
+		// Both volumes in one submission: one wait instead of two
 		NoiseTextureDesc shapeDesc = desc.shapeNoise;
 		shapeDesc.debugName = "CloudShape";
-		m_ShapeTexture = noiseGen->Generate(shapeDesc, dispatch);
-		if (!m_ShapeTexture)
-		{
-			LOG_ERROR("CloudSystem::Regenerate — shape noise generation failed");
-			return false;
-		}
-
 		NoiseTextureDesc detailDesc = desc.detailNoise;
 		detailDesc.debugName = "CloudDetail";
-		m_DetailTexture = noiseGen->Generate(detailDesc, dispatch);
-		if (!m_DetailTexture)
+		const std::vector<VulkanTexture*> noise = noiseGen->AcquireMany({ shapeDesc, detailDesc }, dispatch, consumer);
+		m_ShapeTexture = noise[0];
+		m_DetailTexture = noise[1];
+		if (!m_ShapeTexture || !m_DetailTexture)
 		{
-			LOG_ERROR("CloudSystem::Regenerate — detail noise generation failed");
+			LOG_ERROR("CloudSystem::Regenerate — {} noise generation failed", m_ShapeTexture ? "detail" : "shape");
 			DestroyNoiseTextures();
 			return false;
 		}
 
-		for (uint32_t i = 0; i < 2; ++i)
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_DescriptorManager->UpdateCloudTextureBindings(i, m_ShapeTexture, m_DetailTexture);
+			m_NoiseBindingsStale[i] = false;
 		}
 
 		m_CurrentDesc = desc;
+		m_HistoryValid = false;  // reconstructed from the old noise
 
-		if (!ResizeResultImage(m_Renderer->GetWidth(), m_Renderer->GetHeight()))
+		if (!ResizeResultImage(m_Renderer->GetSceneExtent().width, m_Renderer->GetSceneExtent().height))
 		{
 			LOG_ERROR("CloudSystem::Regenerate — failed to create raymarch result image");
 			return false;
@@ -202,20 +363,167 @@ namespace Nightbloom
 		return true;
 	}
 
+	bool CloudSystem::RequestRegenerate(const CloudDesc& desc)
+	{
+		// GenerateInBackground's first noise counts as something to show
+		if (!m_NoiseJobsRunning && (!m_Ready || !m_ShapeTexture || !m_DetailTexture))
+			return Regenerate(desc);
+
+		// Started by the next UpdateParams, once any running jobs are done
+		m_QueuedDesc = desc;
+		return true;
+	}
+
+	bool CloudSystem::GenerateInBackground(const CloudDesc& desc)
+	{
+		if (m_Ready)
+			return RequestRegenerate(desc);
+
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Clouds);
+
+		CancelNoiseJobs();
+		m_CurrentDesc = desc;
+
+		// Nothing samples the result yet, so it can be sized now rather than
+		// at the swap
+		if (!ResizeResultImage(m_Renderer->GetSceneExtent().width, m_Renderer->GetSceneExtent().height))
+		{
+			LOG_ERROR("CloudSystem::GenerateInBackground — failed to create raymarch result image");
+			return false;
+		}
+
+		StartNoiseJobs(desc);
+		return m_NoiseJobsRunning;
+	}
+
+	void CloudSystem::StartNoiseJobs(const CloudDesc& desc)
+	{
+		NoiseTextureGenerator* noiseGen = m_Renderer->GetNoiseGenerator();
+		ComputeDispatcher* dispatch = m_Renderer->GetComputeDispatcher();
+		if (!noiseGen || !dispatch)
+			return;
+
+		const NoiseConsumer consumer = m_Renderer->IsAsyncComputeEnabled()
+			? NoiseConsumer::Compute : NoiseConsumer::Graphics;
+
+		NoiseTextureDesc shapeDesc = desc.shapeNoise;
+		shapeDesc.debugName = "CloudShape";
+		NoiseTextureDesc detailDesc = desc.detailNoise;
+		detailDesc.debugName = "CloudDetail";
+
+		m_ShapeJob = noiseGen->AcquireAsync(shapeDesc, dispatch, consumer);
+		m_DetailJob = noiseGen->AcquireAsync(detailDesc, dispatch, consumer);
+		if (!m_ShapeJob || !m_DetailJob)
+		{
+			LOG_ERROR("CloudSystem: failed to start background noise generation");
+			CancelNoiseJobs();
+			return;
+		}
+
+		m_JobDesc = desc;
+		m_NoiseJobsRunning = true;
+	}
+
+	// Called at the start of UpdateParams: every frame recorded before the
+	// swap has been submitted, so releasing the old noise is safe (evicted
+	// textures wait in the deletion queue), and each frame slot's set is
+	// rebound before that slot records again
+	void CloudSystem::UpdateNoiseJobs()
+	{
+		NoiseTextureGenerator* noiseGen = m_Renderer->GetNoiseGenerator();
+		if (!noiseGen)
+			return;
+
+		if (m_NoiseJobsRunning)
+		{
+			if (m_ShapeJob && noiseGen->PollJob(m_ShapeJob, m_PendingShape) != NoiseJobState::Pending)
+				m_ShapeJob = 0;
+			if (m_DetailJob && noiseGen->PollJob(m_DetailJob, m_PendingDetail) != NoiseJobState::Pending)
+				m_DetailJob = 0;
+			if (m_ShapeJob || m_DetailJob)
+				return;
+
+			m_NoiseJobsRunning = false;
+			if (!m_PendingShape || !m_PendingDetail)
+			{
+				if (m_Ready)
+					LOG_ERROR("CloudSystem: background noise generation failed, keeping the current noise");
+				else
+					LOG_ERROR("CloudSystem: background noise generation failed, clouds stay off");
+				noiseGen->Release(m_PendingShape);
+				noiseGen->Release(m_PendingDetail);
+			}
+			else
+			{
+				DestroyNoiseTextures();
+				m_ShapeTexture = m_PendingShape;
+				m_DetailTexture = m_PendingDetail;
+				for (bool& stale : m_NoiseBindingsStale)
+					stale = true;
+
+				m_CurrentDesc.shapeNoise = m_JobDesc.shapeNoise;
+				m_CurrentDesc.detailNoise = m_JobDesc.detailNoise;
+				m_HistoryValid = false;  // reconstructed from the old noise
+				m_Ready = true;          // the first noise of GenerateInBackground
+
+				LOG_INFO("CloudSystem: background noise swapped in (shape {}x{}x{}, detail {}x{}x{})",
+					m_JobDesc.shapeNoise.width, m_JobDesc.shapeNoise.height, m_JobDesc.shapeNoise.depth,
+					m_JobDesc.detailNoise.width, m_JobDesc.detailNoise.height, m_JobDesc.detailNoise.depth);
+			}
+			m_PendingShape = nullptr;
+			m_PendingDetail = nullptr;
+		}
+
+		if (m_QueuedDesc)
+		{
+			const CloudDesc desc = *m_QueuedDesc;
+			m_QueuedDesc.reset();
+
+			// Non-noise settings are edited on m_CurrentDesc directly
+			if (HashNoiseTextureDesc(desc.shapeNoise) != HashNoiseTextureDesc(m_CurrentDesc.shapeNoise) ||
+				HashNoiseTextureDesc(desc.detailNoise) != HashNoiseTextureDesc(m_CurrentDesc.detailNoise))
+				StartNoiseJobs(desc);
+		}
+	}
+
+	void CloudSystem::CancelNoiseJobs()
+	{
+		// Without a generator its Cleanup has already dropped the jobs
+		if (NoiseTextureGenerator* noiseGen = m_Renderer ? m_Renderer->GetNoiseGenerator() : nullptr)
+		{
+			noiseGen->CancelJob(m_ShapeJob);
+			noiseGen->CancelJob(m_DetailJob);
+			noiseGen->Release(m_PendingShape);
+			noiseGen->Release(m_PendingDetail);
+		}
+		m_ShapeJob = 0;
+		m_DetailJob = 0;
+		m_PendingShape = nullptr;
+		m_PendingDetail = nullptr;
+		m_NoiseJobsRunning = false;
+		m_QueuedDesc.reset();
+	}
+
 	bool CloudSystem::ResizeResultImage(uint32_t viewportWidth, uint32_t viewportHeight)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Clouds);
+
 		if (viewportWidth == 0 || viewportHeight == 0) return true; // minimized window etc - nothing to do yet
 
 		uint32_t newWidth = std::max(1u, static_cast<uint32_t>(viewportWidth * m_CurrentDesc.resolutionScale));
 		uint32_t newHeight = std::max(1u, static_cast<uint32_t>(viewportHeight * m_CurrentDesc.resolutionScale));
 
-		if (m_RaymarchResult && newWidth == m_ResultWidth && newHeight == m_ResultHeight)
+		if (m_RaymarchResult && newWidth == m_ResultWidth && newHeight == m_ResultHeight &&
+			viewportWidth == m_CompositeWidth && viewportHeight == m_CompositeHeight)
 			return true; // already the right size
 
-		m_Renderer->WaitForIdle();
-		DestroyResultImage();
-
+		// Only graphics-queue frames touch the result images (and their sets);
+		// an async compute submission is always waited on by its frame's
+		// graphics submission, so this covers it too
 		auto* vkDevice = static_cast<VulkanDevice*>(m_Renderer->GetDevice());
+		VulkanQueueTimeline* timeline = vkDevice->GetGraphicsTimeline();
+		timeline->Wait(timeline->GetLastSubmittedValue());
+		DestroyResultImage();
 
 		TextureDesc texDesc{};
 		texDesc.width = newWidth;
@@ -228,13 +536,13 @@ namespace Nightbloom
 		texDesc.generateMips = false;
 		texDesc.force3D = false;
 
-		// Helper: allocate + initialize one low-res result image.
+		// Helper: allocate + initialize one result image.
 		auto createResult = [&](const char* label) -> VulkanTexture*
 		{
 			auto* tex = new VulkanTexture(vkDevice, m_Renderer->GetMemoryManager());
 			if (!tex->Initialize(texDesc))
 			{
-				LOG_ERROR("CloudSystem: failed to initialize {} result image ({}x{})", label, newWidth, newHeight);
+				LOG_ERROR("CloudSystem: failed to initialize {} result image ({}x{})", label, texDesc.width, texDesc.height);
 				delete tex;
 				return nullptr;
 			}
@@ -243,7 +551,15 @@ namespace Nightbloom
 
 		m_RaymarchResult = createResult("raymarch");
 		m_ReflectionResult = createResult("reflection");
-		if (!m_RaymarchResult || !m_ReflectionResult)
+		m_HistoryTextures[0] = createResult("history");
+		m_HistoryTextures[1] = createResult("history");
+
+		// The upsample's output, at the full viewport size
+		texDesc.width = viewportWidth;
+		texDesc.height = viewportHeight;
+		m_CompositeResult = createResult("composite");
+
+		if (!m_RaymarchResult || !m_ReflectionResult || !m_HistoryTextures[0] || !m_HistoryTextures[1] || !m_CompositeResult)
 		{
 			DestroyResultImage();
 			return false;
@@ -251,11 +567,17 @@ namespace Nightbloom
 
 		m_ResultWidth = newWidth;
 		m_ResultHeight = newHeight;
+		m_CompositeWidth = viewportWidth;
+		m_CompositeHeight = viewportHeight;
 
-		m_DescriptorManager->UpdateCloudResultSet(m_ResultDescriptorSet, m_RaymarchResult);
+		m_DescriptorManager->UpdateCloudResultSet(m_ResultDescriptorSet, m_CompositeResult);
 		m_DescriptorManager->UpdateComputeImageSet(m_OutputImageSet, m_RaymarchResult->GetStorageImageView());
+		m_DescriptorManager->UpdateCloudResultSet(m_UpsampleInputSet, m_RaymarchResult);
+		m_DescriptorManager->UpdateComputeImageSet(m_UpsampleOutputSet, m_CompositeResult->GetStorageImageView());
 		m_DescriptorManager->UpdateCloudResultSet(m_ReflectionResultSet, m_ReflectionResult);
 		m_DescriptorManager->UpdateComputeImageSet(m_ReflectionOutputImageSet, m_ReflectionResult->GetStorageImageView());
+		for (uint32_t i = 0; i < 2; ++i)
+			m_DescriptorManager->UpdateCloudHistorySet(m_HistorySets[i], m_HistoryTextures[1 - i], m_HistoryTextures[i]);
 
 		LOG_INFO("CloudSystem: raymarch result image (re)created ({}x{}, scale={:.2f})",
 			newWidth, newHeight, m_CurrentDesc.resolutionScale);
@@ -268,19 +590,56 @@ namespace Nightbloom
 		return m_RaymarchResult ? m_RaymarchResult->GetImage() : VK_NULL_HANDLE;
 	}
 
+	VkImage CloudSystem::GetCompositeImage() const
+	{
+		return m_CompositeResult ? m_CompositeResult->GetImage() : VK_NULL_HANDLE;
+	}
+
 	VkImage CloudSystem::GetReflectionResultImage() const
 	{
 		return m_ReflectionResult ? m_ReflectionResult->GetImage() : VK_NULL_HANDLE;
 	}
 
+	VkImage CloudSystem::GetShadowMapImage() const
+	{
+		return m_ShadowMap ? m_ShadowMap->GetImage() : VK_NULL_HANDLE;
+	}
+
+	std::optional<NoiseTextureDesc> CloudSystem::GetResidentNoiseDesc(bool detail) const
+	{
+		const VulkanTexture* texture = detail ? m_DetailTexture : m_ShapeTexture;
+		if (!texture)
+			return std::nullopt;
+
+		NoiseTextureDesc desc = detail ? m_CurrentDesc.detailNoise : m_CurrentDesc.shapeNoise;
+		switch (texture->GetFormat())
+		{
+		case TextureFormat::R8:    desc.format = NoiseTextureFormat::R8; break;
+		case TextureFormat::RG8:   desc.format = NoiseTextureFormat::RG8; break;
+		case TextureFormat::RGBA8: desc.format = NoiseTextureFormat::RGBA8; break;
+		case TextureFormat::BC4_R: desc.format = NoiseTextureFormat::BC4; break;
+		default:                   desc.format = NoiseTextureFormat::RGBA32F; break;
+		}
+		desc.generateMips = texture->GetMipLevels() > 1;
+		return desc;
+	}
+
 	void CloudSystem::UpdateParams(uint32_t frameIndex, float deltaTime)
 	{
+		UpdateNoiseJobs();
 		if (!m_Ready) return;
 
+		if (m_NoiseBindingsStale[frameIndex])
+		{
+			m_DescriptorManager->UpdateCloudTextureBindings(frameIndex, m_ShapeTexture, m_DetailTexture);
+			m_NoiseBindingsStale[frameIndex] = false;
+		}
+
 		m_TotalTime += deltaTime;
 
 		CloudParamsData params;
-		params.layerBounds = glm::vec4(m_CurrentDesc.layerMinY, m_CurrentDesc.layerMaxY, 0.0f, 0.0f);
+		const bool packedShape = m_CurrentDesc.shapeNoise.channels == NoiseChannelLayout::CloudShape;
+		params.layerBounds = glm::vec4(m_CurrentDesc.layerMinY, m_CurrentDesc.layerMaxY, packedShape ? 1.0f : 0.0f, 0.0f);
 
 		glm::vec3 wind = glm::normalize(m_CurrentDesc.windDirection) * m_CurrentDesc.windSpeed;
 		params.wind = glm::vec4(wind, m_TotalTime);
@@ -293,11 +652,26 @@ namespace Nightbloom
 			m_CurrentDesc.densityMultiplier, m_CurrentDesc.extinctionCoefficient,
 			m_CurrentDesc.hgAnisotropy, static_cast<float>(m_CurrentDesc.stepCount));
 
-		void* mapped = m_ParamsBuffers[frameIndex]->GetPersistentMappedPtr();
+		params.sunTint = glm::vec4(m_SunTint, 1.0f);
+
+		// The shadow map's window: centred on the camera, its corner snapped
+		// to whole texels so the shadows don't shimmer as the camera moves
+		m_ShadowWindow = glm::vec4(0.0f);
+		const float shadowExtent = m_CurrentDesc.shadowMapExtent;
+		if (m_ShadowPipeline != VK_NULL_HANDLE && m_ShadowMap && shadowExtent > 0.0f)
+		{
+			const float texel = shadowExtent / static_cast<float>(SHADOW_MAP_SIZE);
+			const glm::vec3 camera = m_Renderer->GetCameraPosition();
+			const glm::vec2 corner = glm::floor((glm::vec2(camera.x, camera.z) - 0.5f * shadowExtent) / texel) * texel;
+			m_ShadowWindow = glm::vec4(corner, shadowExtent, m_CurrentDesc.layerMaxY);
+		}
+		params.shadowWindow = m_ShadowWindow;
+
+		// Called from Renderer::BeginFrame, whose upload flush covers this
+		void* mapped = m_Renderer->GetFrameUploads()->GetMapped(frameIndex, m_ParamsSlot);
 		if (mapped)
 		{
 			memcpy(mapped, &params, sizeof(CloudParamsData));
-			m_ParamsBuffers[frameIndex]->Flush();
 		}
 	}
 
@@ -305,21 +679,80 @@ namespace Nightbloom
 	{
 		if (!m_Ready || !dispatcher || !m_RaymarchResult) return;
 
-		VkImageLayout oldLayout = m_ResultImageEverWritten
-			? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-			: VK_IMAGE_LAYOUT_UNDEFINED;
-		dispatcher->TransitionImageForComputeWrite(cmd, m_RaymarchResult->GetImage(), oldLayout);
+		// On the async compute queue every pixel is rewritten, so last frame's
+		// result is discarded rather than transferred back from graphics.
+		// Last frame's reader was the upsample, a compute shader.
+		if (m_ResultImageEverWritten && !m_Renderer->IsAsyncComputeEnabled())
+			dispatcher->QueueImageBarrier(cmd, m_RaymarchResult->GetImage(),
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+		else
+			dispatcher->QueueImageBarrier(cmd, m_RaymarchResult->GetImage(),
+				VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+				VK_PIPELINE_STAGE_2_NONE_KHR, 0,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
 		m_ResultImageEverWritten = true;
 
-		dispatcher->BindPipeline(cmd, m_RaymarchPipeline);
-		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 0, m_DescriptorManager->GetUniformDescriptorSet(frameIndex));
+		// Last frame wrote one history image and read the other; this one
+		// reverses the roles. Both stay in GENERAL, and their barriers go out
+		// as one batch with the result's and the shadow map's transition (or
+		// the raymarch).
+		const VkAccessFlags2KHR kHistoryAccess = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR |
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR;
+		for (VulkanTexture* history : m_HistoryTextures)
+		{
+			if (m_HistoryEverWritten)
+				dispatcher->QueueImageBarrier(cmd, history->GetImage(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, kHistoryAccess);
+			else
+				dispatcher->QueueImageBarrier(cmd, history->GetImage(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+					VK_PIPELINE_STAGE_2_NONE_KHR, 0,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, kHistoryAccess);
+		}
+		m_HistoryEverWritten = true;
+
+		// The raymarch reads the shadow map, as does the reflection's
+		BakeShadowMap(cmd, dispatcher, frameIndex);
+
+		RecordRaymarch(cmd, dispatcher, frameIndex, m_DescriptorManager->GetUniformDescriptorSet(frameIndex),
+			m_OutputImageSet, true);
+	}
+
+	void CloudSystem::BakeShadowMap(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex)
+	{
+		if (m_ShadowWindow.z <= 0.0f) return;
+
+		// Rewritten whole: last frame's contents are discarded
+		VkImage image = m_ShadowMap->GetImage();
+		dispatcher->TransitionImageForComputeWrite(cmd, image, VK_IMAGE_LAYOUT_UNDEFINED);
+
+		// Set 0 (the camera) is unused: the window is in the params
+		dispatcher->BindPipeline(cmd, m_ShadowPipeline);
 		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 1, m_DescriptorManager->GetCloudDescriptorSet(frameIndex));
 		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 2, m_DescriptorManager->GetLightingDescriptorSet(frameIndex));
-		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 3, m_OutputImageSet);
-
-		uint32_t groupsX = ComputeDispatcher::CalculateGroupCount(m_ResultWidth, 8);
-		uint32_t groupsY = ComputeDispatcher::CalculateGroupCount(m_ResultHeight, 8);
-		dispatcher->Dispatch(cmd, groupsX, groupsY, 1);
+		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 3, m_ShadowOutputSet);
+		const uint32_t groups = ComputeDispatcher::CalculateGroupCount(SHADOW_MAP_SIZE, 8);
+		dispatcher->Dispatch(cmd, groups, groups, 1);
+
+		// For the raymarches that follow; the lit passes' fragment reads are
+		// the render graph's (or the async compute handoff's) to synchronize
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
 	}
 
 	void CloudSystem::DispatchReflectionRaymarch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
@@ -327,24 +760,103 @@ namespace Nightbloom
 	{
 		if (!m_Ready || !dispatcher || !m_ReflectionResult || reflectionUniformSet == VK_NULL_HANDLE) return;
 
-		VkImageLayout oldLayout = m_ReflectionResultEverWritten
+		VkImageLayout oldLayout = (m_ReflectionResultEverWritten && !m_Renderer->IsAsyncComputeEnabled())
 			? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
 			: VK_IMAGE_LAYOUT_UNDEFINED;
 		dispatcher->TransitionImageForComputeWrite(cmd, m_ReflectionResult->GetImage(), oldLayout);
 		m_ReflectionResultEverWritten = true;
 
-		dispatcher->BindPipeline(cmd, m_RaymarchPipeline);
 		// set 0 = the mirror-flipped reflection camera (invView/invProj/cameraPos
 		// the raymarch reconstructs rays from) — the ONLY difference from the main
-		// dispatch. Params/noise (set 1) and lighting (set 2) are identical.
-		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 0, reflectionUniformSet);
+		// dispatch. Params/noise (set 1) and lighting (set 2) are identical. It
+		// marches every pixel, so the history (set 4) is bound but untouched.
+		RecordRaymarch(cmd, dispatcher, frameIndex, reflectionUniformSet, m_ReflectionOutputImageSet, false);
+	}
+
+	void CloudSystem::RecordRaymarch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex,
+		VkDescriptorSet uniformSet, VkDescriptorSet outputSet, bool mainView)
+	{
+		const int size = mainView ? m_CurrentDesc.checkerboardSize : 1;
+		const uint32_t block = (size >= 4) ? 4u : (size >= 2) ? 2u : 1u;
+		const uint32_t historyTarget = mainView ? 1 - m_HistoryIndex : m_HistoryIndex;
+
+		RaymarchPushConstants push{};
+		push.prevViewProj = m_PrevViewProj;
+		push.checkerboard = glm::ivec4(static_cast<int>(block), 0, 0, 0);
+		push.temporal = glm::vec4(0.0f);
+		push.march = mainView
+			? glm::vec4(1.0f, MAIN_MIN_TRANSMITTANCE, 0.0f, 0.0f)
+			: glm::vec4(std::clamp(m_CurrentDesc.reflectionStepScale, 0.1f, 1.0f), REFLECTION_MIN_TRANSMITTANCE, 0.0f, 0.0f);
+		if (mainView && block > 1)
+		{
+			const glm::ivec2 offset = CheckerboardOffset(m_CheckerboardFrame % (block * block), block);
+			push.checkerboard.y = offset.x;
+			push.checkerboard.z = offset.y;
+			push.checkerboard.w = m_HistoryValid ? 1 : 0;
+
+			// The noise is sampled at worldPos + wind * time, so a cloud now
+			// at p was at p + wind * dt when the history was written
+			const glm::vec3 wind = glm::normalize(m_CurrentDesc.windDirection) * m_CurrentDesc.windSpeed;
+			push.temporal = glm::vec4(wind * (m_TotalTime - m_HistoryTime), static_cast<float>(m_CheckerboardFrame % 64));
+		}
+
+		// Sky coverage: the main view on the graphics queue (the pyramid
+		// isn't shared with the compute family), against a pyramid built
+		// from the camera m_PrevViewProj holds - last frame's, unless the
+		// clouds skipped a frame - so the shader can reproject with it
+		VkDescriptorSet pyramidSet = m_NoPyramidSet;
+		const OcclusionCuller* culler = m_Renderer->GetOcclusionCuller();
+		if (mainView && culler && culler->HasPyramid() && !m_Renderer->IsAsyncComputeEnabled() &&
+			culler->GetPyramidViewProjection() == m_PrevViewProj)
+		{
+			const VkExtent2D built = culler->GetBuiltExtent();
+			push.coverage = glm::vec4(static_cast<float>(built.width), static_cast<float>(built.height),
+				static_cast<float>(CoverageMip(built.width, m_ResultWidth, culler->GetMipCount())), 1.0f);
+			pyramidSet = culler->GetPyramidSampleSet();
+		}
+
+		dispatcher->BindPipeline(cmd, m_RaymarchPipeline);
+		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 0, uniformSet);
 		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 1, m_DescriptorManager->GetCloudDescriptorSet(frameIndex));
 		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 2, m_DescriptorManager->GetLightingDescriptorSet(frameIndex));
-		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 3, m_ReflectionOutputImageSet);
+		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 3, outputSet);
+		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 4, m_HistorySets[historyTarget]);
+		dispatcher->BindDescriptorSet(cmd, m_RaymarchPipelineLayout, 5, pyramidSet);
+		dispatcher->PushConstants(cmd, m_RaymarchPipelineLayout, &push, sizeof(push));
 
 		uint32_t groupsX = ComputeDispatcher::CalculateGroupCount(m_ResultWidth, 8);
 		uint32_t groupsY = ComputeDispatcher::CalculateGroupCount(m_ResultHeight, 8);
 		dispatcher->Dispatch(cmd, groupsX, groupsY, 1);
+
+		if (mainView)
+		{
+			// Unjittered camera: the temporal upscaler's sub-pixel jitter is
+			// far below a low-res cloud texel
+			m_PrevViewProj = m_Renderer->GetProjectionMatrix() * m_Renderer->GetViewMatrix();
+			m_HistoryIndex = historyTarget;
+			m_HistoryTime = m_TotalTime;
+			m_HistoryValid = block > 1;  // only checkerboarded dispatches write the history
+			++m_CheckerboardFrame;
+		}
+	}
+
+	void CloudSystem::DispatchUpsample(VkCommandBuffer cmd, ComputeDispatcher* dispatcher)
+	{
+		if (!m_Ready || !dispatcher || !m_CompositeResult) return;
+
+		// Every pixel is rewritten; last frame's reader was the composite
+		dispatcher->TransitionImageForComputeWrite(cmd, m_CompositeResult->GetImage(), m_CompositeEverWritten
+			? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+			: VK_IMAGE_LAYOUT_UNDEFINED);
+		m_CompositeEverWritten = true;
+
+		dispatcher->BindPipeline(cmd, m_UpsamplePipeline);
+		dispatcher->BindDescriptorSet(cmd, m_UpsamplePipelineLayout, 0, m_UpsampleInputSet);
+		dispatcher->BindDescriptorSet(cmd, m_UpsamplePipelineLayout, 1, m_UpsampleOutputSet);
+
+		uint32_t groupsX = ComputeDispatcher::CalculateGroupCount(m_CompositeWidth, 8);
+		uint32_t groupsY = ComputeDispatcher::CalculateGroupCount(m_CompositeHeight, 8);
+		dispatcher->Dispatch(cmd, groupsX, groupsY, 1);
 	}
 
 	void CloudSystem::SubmitDraw(DrawList& drawList) const
@@ -353,7 +865,7 @@ namespace Nightbloom
 
 		// No vertex/index buffer — Clouds.vert generates a full-screen
 		// triangle procedurally from gl_VertexIndex. The composite fragment
-		// shader samples m_RaymarchResult via m_ResultDescriptorSet (bound
+		// shader samples m_CompositeResult via m_ResultDescriptorSet (bound
 		// by CommandRecorder using PipelineType::Clouds - see CommandRecorder.cpp).
 		DrawCommand cmd;
 		cmd.pipeline = PipelineType::Clouds;
@@ -373,7 +885,7 @@ namespace Nightbloom
 
 		auto& assetManager = AssetManager::Get();
 		auto shaderCode = assetManager.LoadShaderBinary("CloudRaymarch.comp.spv");
-		if (shaderCode.empty())
+		if (!shaderCode.IsOpen())
 		{
 			LOG_ERROR("CloudSystem: failed to load CloudRaymarch.comp.spv");
 			return false;
@@ -381,8 +893,8 @@ namespace Nightbloom
 
 		VkShaderModuleCreateInfo moduleInfo{};
 		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		moduleInfo.codeSize = shaderCode.size();
-		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
 
 		VkShaderModule shaderModule = VK_NULL_HANDLE;
 		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
@@ -398,18 +910,27 @@ namespace Nightbloom
 		stageInfo.pName = "main";
 
 		// Matches CloudRaymarch.comp's set layout: 0=FrameUniforms,
-		// 1=cloud shape/detail/params, 2=SceneLighting, 3=output image.
-		VkDescriptorSetLayout setLayouts[4] = {
+		// 1=cloud shape/detail/params, 2=SceneLighting, 3=output image,
+		// 4=history (previous sampled, next storage), 5=Hi-Z pyramid.
+		VkDescriptorSetLayout setLayouts[6] = {
 			m_DescriptorManager->GetUniformSetLayout(),
 			m_DescriptorManager->GetCloudSetLayout(),
 			m_DescriptorManager->GetLightingSetLayout(),
-			m_DescriptorManager->GetComputeImageSetLayout()
+			m_DescriptorManager->GetComputeImageSetLayout(),
+			m_DescriptorManager->GetCloudHistorySetLayout(),
+			m_DescriptorManager->GetHiZSampleSetLayout()
 		};
 
+		VkPushConstantRange pushRange{};
+		pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushRange.size = sizeof(RaymarchPushConstants);
+
 		VkPipelineLayoutCreateInfo layoutInfo{};
 		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		layoutInfo.setLayoutCount = 4;
+		layoutInfo.setLayoutCount = 6;
 		layoutInfo.pSetLayouts = setLayouts;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushRange;
 
 		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_RaymarchPipelineLayout) != VK_SUCCESS)
 		{
@@ -423,20 +944,131 @@ namespace Nightbloom
 		pipelineInfo.stage = stageInfo;
 		pipelineInfo.layout = m_RaymarchPipelineLayout;
 
-		VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_RaymarchPipeline);
+		// The shadow bake compiles on a job worker meanwhile
+		JobCounter shadowDone;
+		JobSystem::Get().Run([this, pipelineInfo]() { CreateShadowPipeline(pipelineInfo); }, &shadowDone);
+
+		VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_RaymarchPipeline);
 
 		vkDestroyShaderModule(device, shaderModule, nullptr);
+		JobSystem::Get().Wait(shadowDone);
 
 		if (result != VK_SUCCESS)
 		{
 			LOG_ERROR("CloudSystem: failed to create raymarch compute pipeline");
+			if (m_ShadowPipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_ShadowPipeline, nullptr);
+				m_ShadowPipeline = VK_NULL_HANDLE;
+			}
 			vkDestroyPipelineLayout(device, m_RaymarchPipelineLayout, nullptr);
 			m_RaymarchPipelineLayout = VK_NULL_HANDLE;
 			return false;
 		}
+		VulkanDebugMarkers::SetName(device, m_RaymarchPipeline, "CloudRaymarch.comp.spv");
 
 		LOG_INFO("CloudSystem: raymarch compute pipeline created");
 		return true;
 	}
 
+	bool CloudSystem::CreateUpsamplePipeline()
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		auto shaderCode = AssetManager::Get().LoadShaderBinary("CloudUpsample.comp.spv");
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("CloudSystem: failed to load CloudUpsample.comp.spv");
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("CloudSystem: failed to create upsample shader module");
+			return false;
+		}
+
+		// Matches CloudUpsample.comp: 0=low-res result (sampled), 1=full-res output
+		VkDescriptorSetLayout setLayouts[2] = {
+			m_DescriptorManager->GetCloudResultSetLayout(),
+			m_DescriptorManager->GetComputeImageSetLayout()
+		};
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 2;
+		layoutInfo.pSetLayouts = setLayouts;
+
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_UpsamplePipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("CloudSystem: failed to create upsample pipeline layout");
+			vkDestroyShaderModule(device, shaderModule, nullptr);
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_UpsamplePipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_UpsamplePipeline);
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("CloudSystem: failed to create upsample compute pipeline");
+			vkDestroyPipelineLayout(device, m_UpsamplePipelineLayout, nullptr);
+			m_UpsamplePipelineLayout = VK_NULL_HANDLE;
+			m_UpsamplePipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_UpsamplePipeline, "CloudUpsample.comp.spv");
+
+		return true;
+	}
+
+	void CloudSystem::CreateShadowPipeline(VkComputePipelineCreateInfo pipelineInfo)
+	{
+		// The shadow map bake shares the raymarch layout. Optional: without it
+		// the clouds cast no shadows (the window stays empty).
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		auto shadowCode = AssetManager::Get().LoadShaderBinary("CloudShadow.comp.spv");
+		if (!shadowCode.IsOpen())
+		{
+			LOG_WARN("CloudSystem: CloudShadow.comp.spv not found - clouds cast no shadows");
+			return;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shadowCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shadowCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_WARN("CloudSystem: failed to create the cloud shadow shader module - clouds cast no shadows");
+			return;
+		}
+
+		pipelineInfo.stage.module = shaderModule;
+		if (vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_ShadowPipeline) != VK_SUCCESS)
+		{
+			LOG_WARN("CloudSystem: failed to create the cloud shadow pipeline - clouds cast no shadows");
+			m_ShadowPipeline = VK_NULL_HANDLE;
+		}
+		VulkanDebugMarkers::SetName(device, m_ShadowPipeline, "CloudShadow.comp.spv");
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+	}
+
 } // namespace Nightbloom
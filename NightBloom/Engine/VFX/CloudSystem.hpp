@@ -11,17 +11,45 @@
 // Performance: the raymarch itself runs in a compute shader
 // (CloudRaymarch.comp) at a LOWER resolution (see m_ResolutionScale) than
 // the screen, writing into m_RaymarchResult. The graphics PipelineType::
-// Clouds pass then just samples that small result (hardware bilinear
-// upscale) and composites it — occlusion against terrain/opaque geometry is
-// still handled entirely by the normal full-resolution GPU depth test in
-// that graphics pass (fixed "at infinity" depth output, depth-test on,
-// write off), completely unchanged from before this optimization — only the
+// Clouds pass then just samples a full-resolution copy of it and composites
+// it — occlusion against terrain/opaque geometry is still handled entirely
+// by the normal full-resolution GPU depth test in that graphics pass (fixed
+// "at infinity" depth output, depth-test on, write off) — only the
 // expensive raymarch content moved to compute, not the occlusion decision.
 //
+// Sky coverage: when the raymarch runs on the graphics queue and last
+// frame's Hi-Z pyramid (OcclusionCuller) lines up with the history camera,
+// texels whose footprint held no sky in that depth are not marched at all
+// and are marked invalid. DispatchUpsample then brings the result to full
+// resolution with a joint bilateral filter (CloudUpsample.comp) that leaves
+// the invalid texels out, so skipping them costs no halo at silhouettes and
+// the raymarch resolution can stay low.
+//
+// Temporal amortization: with checkerboardSize N > 1 only one pixel of each
+// N x N block is marched per frame (cycling through the block in Bayer
+// order); the others reproject last frame's result through the previous
+// view-projection and the wind scroll. The reconstruction is kept in a
+// ping-pong pair of history images next to m_RaymarchResult, so the
+// composite pass and its descriptor set are unchanged.
+//
+// Cloud shadows: before the raymarch, CloudShadow.comp bakes a
+// SHADOW_MAP_SIZE^2 map of the layer around the camera as seen from the sun
+// (a Beer shadow map, see cloud_shadow.glsl). The raymarch reads it for the
+// clouds' self-shadowing and the Renderer binds it at set 0 binding 5, where
+// SampleShadow (shadows.glsl) darkens the ground, meshes and grass under
+// the clouds.
+//
+// With async compute (Renderer::IsAsyncComputeEnabled) the raymarch runs on
+// the compute queue: the noise textures stay on the compute family and the
+// Renderer hands the result images to graphics after each dispatch. The
+// pyramid stays on the graphics family, so every texel is marched there;
+// the upsample still runs, on the graphics queue.
+//
 // Usage:
 //   CloudSystem clouds;
 //   clouds.Initialize(renderer);
 //   clouds.Regenerate(desc);           // rare — rebuilds shape/detail textures
+//   clouds.RequestRegenerate(desc);    // same, in the background (live editing)
 //   renderer->SetCloudSystem(&clouds); // Renderer calls UpdateParams() + DispatchRaymarch() per frame
 //   // Per frame (after BuildDrawList):
 //   clouds.SubmitDraw(drawList);
@@ -31,8 +59,11 @@
 
 #include "Engine/Renderer/NoiseTextureGenerator.hpp"
 #include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/FrameUploadLayout.hpp"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <optional>
 
 namespace Nightbloom
 {
@@ -48,6 +79,9 @@ namespace Nightbloom
 		// Shape (low-frequency Perlin-Worley) and detail (higher-frequency
 		// Worley erosion) noise textures. NoiseTextureDesc.depth must be > 1
 		// for these (real 3D textures, unlike Terrain's flat heightmap).
+		// Any format and channel layout works: the shape may be packed
+		// (NoiseChannelLayout::CloudShape), and with mips the raymarch reads
+		// coarser levels for distant samples.
 		NoiseTextureDesc shapeNoise;
 		NoiseTextureDesc detailNoise;
 
@@ -69,27 +103,46 @@ namespace Nightbloom
 		float extinctionCoefficient = 1.2f;
 		float hgAnisotropy = 0.2f;       // Henyey-Greenstein phase g, forward-scatter bias
 		int   stepCount = 64;            // was 80 — ~20% fewer raymarch steps; the
-		                                 // dithered start + early-out hide the loss
+		                                 // dithered start + early-out hide the loss.
+		                                 // Sets the step size inside clouds; empty
+		                                 // space is crossed in longer steps
 
 		// Raymarch result image resolution = swapchain extent * this scale.
-		// 0.45 (~20% of full pixel count) trades a little upscale softness — fine
-		// for soft clouds — for a meaningful raymarch cost cut. Raise toward 1.0
-		// for crisper clouds, lower for more speed.
-		float resolutionScale = 0.45f;
+		// 0.35 (~12% of full pixel count): the depth-aware upsample keeps
+		// silhouettes clean, leaving only the softness of the clouds
+		// themselves. Raise toward 1.0 for crisper clouds, lower for more speed.
+		float resolutionScale = 0.35f;
+
+		// Pixels marched per frame: one of every checkerboardSize^2 (1 = all,
+		// 2 = a quarter, 4 = a sixteenth); the rest reproject the history.
+		// The main view only — the water reflection always marches every pixel.
+		int   checkerboardSize = 2;
+
+		// Water reflection march: this fraction of stepCount (it also stops
+		// at a higher transmittance, see CloudRaymarch.comp)
+		float reflectionStepScale = 0.5f;
+
+		// World-space side of the cloud shadow map's window, centred on the
+		// camera (0 = no cloud shadows). Covers the raymarch's 8 km reach.
+		float shadowMapExtent = 16000.0f;
 	};
 
-	// Matches CloudParamsUBO in CloudRaymarch.comp exactly (std140, 4x vec4 = 64 bytes)
+	// Matches CloudParamsUBO in cloud_density.glsl exactly (std140, 6x vec4 = 96 bytes)
 	struct CloudParamsData
 	{
-		glm::vec4 layerBounds = glm::vec4(800.0f, 1400.0f, 0.0f, 0.0f); // x=minY, y=maxY
+		glm::vec4 layerBounds = glm::vec4(800.0f, 1400.0f, 0.0f, 0.0f); // x=minY, y=maxY, z=1: CloudShape-packed shape noise
 		glm::vec4 wind        = glm::vec4(8.0f, 0.0f, 2.4f, 0.0f);      // xyz=wind dir*speed, w=totalTime
 		glm::vec4 shape       = glm::vec4(0.0015f, 0.012f, 0.35f, 0.45f); // x=shapeScale,y=detailScale,z=detailStrength,w=coverage
 		glm::vec4 density     = glm::vec4(1.0f, 1.2f, 0.2f, 80.0f);      // x=densityMul,y=extinction,z=hgG,w=stepCount
+		glm::vec4 sunTint     = glm::vec4(1.0f);                         // rgb=atmosphere's transmittance to the sun
+		glm::vec4 shadowWindow = glm::vec4(0.0f);                        // xy=min corner (xz), z=side (0=off), w=layer top
 	};
 
 	class CloudSystem
 	{
 	public:
+		static constexpr uint32_t SHADOW_MAP_SIZE = 256;
+
 		CloudSystem() = default;
 		~CloudSystem() = default;
 
@@ -100,28 +153,52 @@ namespace Nightbloom
 		bool Regenerate(const CloudDesc& desc);
 		void Shutdown();
 
+		// Regenerate without the device stall, for scrubbing noise settings:
+		// the new textures are built in the background while the current
+		// ones stay bound, and UpdateParams swaps them in at a frame
+		// boundary. Only the latest request made meanwhile runs next. Falls
+		// back to Regenerate while there is nothing to show yet.
+		bool RequestRegenerate(const CloudDesc& desc);
+		bool IsRegenerating() const { return m_NoiseJobsRunning || m_QueuedDesc.has_value(); }
+
+		// First noise after Initialize without blocking on it: the volumes
+		// generate in the background and the system turns IsReady at the
+		// UpdateParams that swaps them in. Once ready this is RequestRegenerate.
+		bool GenerateInBackground(const CloudDesc& desc);
+
+		// The light's transmittance through the atmosphere to the cloud layer
+		// (Atmosphere::SunTransmittance; white without one). Taken by the
+		// next UpdateParams.
+		void SetSunTint(const glm::vec3& tint) { m_SunTint = tint; }
+
 		// Advances wind-scroll time and uploads this frame's params UBO.
 		// Called by Renderer::BeginFrame() every frame (via SetCloudSystem).
 		void UpdateParams(uint32_t frameIndex, float deltaTime);
 
 		// Dispatches the low-res raymarch compute pass. Called by
-		// Renderer::RecordComputePass() every frame (via SetCloudSystem),
-		// mirroring FireflySystem's compute dispatch pattern. Caller is
-		// responsible for the compute->fragment barrier afterward (same
+		// Renderer::RecordCommandBuffer every frame (via SetCloudSystem),
+		// mirroring FireflySystem's compute dispatch pattern. The Renderer's
+		// render graph places the compute->fragment barrier afterward (same
 		// split of responsibility as FireflySystem's compute->vertex barrier).
 		void DispatchRaymarch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
 
 		// Second raymarch for the water reflection: same shader, same noise/
 		// params, but fed the mirror-flipped reflection camera at set 0
 		// (reflectionUniformSet) and writing a SEPARATE low-res result image.
-		// Only dispatched by Renderer::RecordComputePass when a WaterSystem is
-		// registered. The reflection pass then composites this result into the
+		// Only dispatched when a WaterSystem is registered and the reflection
+		// pass isn't culled (no water in view). The reflection pass then composites this result into the
 		// reflection target (see GetReflectionResultSet), so the water samples
-		// clouds "for free" with no Water.frag change. Caller owns the
-		// compute->fragment barrier afterward, same as DispatchRaymarch.
+		// clouds "for free" with no Water.frag change. The compute->fragment
+		// barrier afterward is the caller's, same as DispatchRaymarch.
 		void DispatchReflectionRaymarch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
 			uint32_t frameIndex, VkDescriptorSet reflectionUniformSet);
 
+		// Joint bilateral upsample of the main raymarch result into the
+		// full-resolution image the composite samples (GetCompositeImage),
+		// always on the graphics queue. The Renderer's render graph places
+		// the barriers around it: the result read, the composite's read after.
+		void DispatchUpsample(VkCommandBuffer cmd, ComputeDispatcher* dispatcher);
+
 		void SubmitDraw(DrawList& drawList) const;
 
 		bool IsReady() const { return m_Ready; }
@@ -130,12 +207,15 @@ namespace Nightbloom
 		const CloudDesc& GetDesc() const { return m_CurrentDesc; }
 
 		// Recreates the low-res result image at the current resolutionScale
-		// against new dimensions — called on window resize, or when the
-		// panel changes resolutionScale. viewportWidth/Height are the full
-		// (unscaled) swapchain dimensions.
+		// (and the full-res composite image) against new dimensions — called
+		// on window resize, or when the panel changes resolutionScale.
+		// viewportWidth/Height are the (unscaled) scene target dimensions,
+		// Renderer::GetSceneExtent().
 		bool ResizeResultImage(uint32_t viewportWidth, uint32_t viewportHeight);
 
 		VkImage GetRaymarchResultImage() const;
+		// DispatchUpsample's output, what the composite pass samples
+		VkImage GetCompositeImage() const;
 
 		// Reflection variant of the above — the image the mirror-camera raymarch
 		// writes, and the descriptor set the reflection pass's Clouds composite
@@ -143,33 +223,102 @@ namespace Nightbloom
 		VkImage GetReflectionResultImage() const;
 		VkDescriptorSet GetReflectionResultSet() const { return m_ReflectionResultSet; }
 
+		// The cloud shadow map DispatchRaymarch bakes (left SHADER_READ_ONLY,
+		// visible to compute shaders) and the window it covers
+		// this frame - FrameUniformData::cloudShadow; z = 0 while nothing is
+		// baked
+		VulkanTexture* GetShadowMap() const { return m_ShadowMap; }
+		VkImage GetShadowMapImage() const;
+		const glm::vec4& GetShadowWindow() const { return m_ShadowWindow; }
+
+		// The shape (detail = false) or detail noise as it is resident: its
+		// desc with the stored format (BC4 may have become R8) and whether
+		// it has mips - what NoiseVolumePacking.hpp sizes for the debug UI.
+		// nullopt while the texture doesn't exist.
+		std::optional<NoiseTextureDesc> GetResidentNoiseDesc(bool detail) const;
+
 	private:
 		void DestroyNoiseTextures();
+		void StartNoiseJobs(const CloudDesc& desc);
+		void UpdateNoiseJobs();
+		void CancelNoiseJobs();
 		void DestroyResultImage();
 		bool CreateComputePipeline();
+		bool CreateUpsamplePipeline();
+		// CloudShadow.comp over the raymarch's layout (pipelineInfo); runs on a job worker
+		void CreateShadowPipeline(VkComputePipelineCreateInfo pipelineInfo);
+		void BakeShadowMap(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex);
+		void RecordRaymarch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher, uint32_t frameIndex,
+			VkDescriptorSet uniformSet, VkDescriptorSet outputSet, bool mainView);
 
 		Renderer* m_Renderer = nullptr;
 		ResourceManager* m_Resources = nullptr;
 		VulkanDescriptorManager* m_DescriptorManager = nullptr;
 
-		VulkanTexture* m_ShapeTexture = nullptr;  // caller-owned, like Terrain's heightmap
+		VulkanTexture* m_ShapeTexture = nullptr;  // acquired from the noise generator's cache
 		VulkanTexture* m_DetailTexture = nullptr;
+
+		// RequestRegenerate's background generation (see UpdateNoiseJobs)
+		NoiseJob m_ShapeJob = 0;
+		NoiseJob m_DetailJob = 0;
+		VulkanTexture* m_PendingShape = nullptr;
+		VulkanTexture* m_PendingDetail = nullptr;
+		bool m_NoiseJobsRunning = false;
+		CloudDesc m_JobDesc;
+		std::optional<CloudDesc> m_QueuedDesc;
+		// Frame slots whose cloud set still binds the previous noise
+		bool m_NoiseBindingsStale[MAX_FRAMES_IN_FLIGHT] = {};
 		VulkanTexture* m_RaymarchResult = nullptr; // caller-owned, low-res compute output
 		VulkanTexture* m_ReflectionResult = nullptr; // caller-owned, low-res mirror-camera output for water reflection
 
-		VulkanBuffer* m_ParamsBuffers[2] = { nullptr, nullptr }; // double-buffered, owned by ResourceManager
+		FrameUploadSlot m_ParamsSlot;   // in the Renderer's frame upload buffer, one copy per frame in flight
 
-		VkDescriptorSet m_ResultDescriptorSet = VK_NULL_HANDLE; // graphics composite pass's only input (set 1)
+		VkDescriptorSet m_ResultDescriptorSet = VK_NULL_HANDLE; // graphics composite pass's only input: the upsampled result
 		VkDescriptorSet m_OutputImageSet = VK_NULL_HANDLE;      // compute pass's output binding (set 3)
 		VkDescriptorSet m_ReflectionResultSet = VK_NULL_HANDLE;   // reflection composite input (set 0 of Clouds)
 		VkDescriptorSet m_ReflectionOutputImageSet = VK_NULL_HANDLE; // reflection raymarch output binding (set 3)
 
+		// Temporal reconstruction of the main raymarch: history i is written
+		// by the frame that binds m_HistorySets[i] (set 4), which reads the
+		// other one. Kept in GENERAL once written.
+		VulkanTexture* m_HistoryTextures[2] = {};
+		VkDescriptorSet m_HistorySets[2] = {};
+		uint32_t m_HistoryIndex = 0;  // written by the last main dispatch
+		bool m_HistoryEverWritten = false;
+		bool m_HistoryValid = false;
+		glm::mat4 m_PrevViewProj = glm::mat4(1.0f);
+		float m_HistoryTime = 0.0f;   // m_TotalTime of the last main dispatch
+		uint32_t m_CheckerboardFrame = 0;
+
 		// Raw compute pipeline - owned directly, mirrors FireflySystem's
 		// pattern (a continuous per-frame simulation, not a generic
 		// PipelineType graphics draw).
 		VkPipeline       m_RaymarchPipeline = VK_NULL_HANDLE;
 		VkPipelineLayout m_RaymarchPipelineLayout = VK_NULL_HANDLE;
 
+		// Sky coverage test input (set 5 of the raymarch) when there is no
+		// pyramid to bind: the shadow map stands in, never read
+		VkDescriptorSet  m_NoPyramidSet = VK_NULL_HANDLE;
+
+		// Full-resolution upsample (CloudUpsample.comp): reads the main result
+		// through m_UpsampleInputSet, writes m_CompositeResult, which
+		// m_ResultDescriptorSet hands to the composite
+		VulkanTexture*   m_CompositeResult = nullptr;
+		VkDescriptorSet  m_UpsampleInputSet = VK_NULL_HANDLE;
+		VkDescriptorSet  m_UpsampleOutputSet = VK_NULL_HANDLE;
+		VkPipeline       m_UpsamplePipeline = VK_NULL_HANDLE;
+		VkPipelineLayout m_UpsamplePipelineLayout = VK_NULL_HANDLE;
+		uint32_t         m_CompositeWidth = 0;
+		uint32_t         m_CompositeHeight = 0;
+		bool             m_CompositeEverWritten = false;
+
+		// Cloud shadow map: fixed size, rewritten whole every frame by
+		// CloudShadow.comp (same pipeline layout as the raymarch)
+		VulkanTexture*   m_ShadowMap = nullptr;
+		VkDescriptorSet  m_ShadowOutputSet = VK_NULL_HANDLE;   // set 3 of the bake
+		VkPipeline       m_ShadowPipeline = VK_NULL_HANDLE;
+		glm::vec4        m_ShadowWindow = glm::vec4(0.0f);
+
 		uint32_t m_ResultWidth = 0;
 		uint32_t m_ResultHeight = 0;
 		bool m_ResultImageEverWritten = false; // first dispatch transitions from UNDEFINED, not SHADER_READ_ONLY_OPTIMAL
@@ -177,6 +326,7 @@ namespace Nightbloom
 
 		CloudDesc m_CurrentDesc;
 		float m_TotalTime = 0.0f;
+		glm::vec3 m_SunTint = glm::vec3(1.0f);
 		bool m_Ready = false;
 	};
 
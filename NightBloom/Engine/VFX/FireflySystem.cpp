@@ -4,16 +4,83 @@
 
 #include "Engine/VFX/FireflySystem.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/ShaderVariant.hpp"
 #include "Engine/Renderer/Components/ResourceManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanFrameUploadBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
 #include "Engine/Renderer/Components/ComputeDispatcher.hpp"
 #include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Renderer/Frustum.hpp"
 #include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/JobSystem.hpp"
 #include <random>
+#include <cmath>
 
 namespace Nightbloom
 {
+	namespace
+	{
+		// Matches GridParams in firefly_grid.glsl
+		struct FireflyGridPushConstants
+		{
+			glm::vec4  origin;  // xyz = grid minimum corner, w = 1 / cell size
+			glm::uvec4 dims;    // xyz = cells per axis, w = FireflyGrid.comp pass
+		};
+		static_assert(sizeof(FireflyGridPushConstants) == 32, "FireflyGridPushConstants must match firefly_grid.glsl");
+
+		// FireflyGrid.comp passes (dims.w)
+		constexpr uint32_t kGridPassCount = 0;
+		constexpr uint32_t kGridPassScan = 1;
+		constexpr uint32_t kGridPassScatter = 2;
+		constexpr uint32_t kGridPassSnapshot = 3;
+
+		constexpr uint32_t kGridGroupSize = 256;
+		constexpr uint32_t kUpdateGroupSize = 64;
+		constexpr uint32_t kCullGroupSize = 64;
+
+		// Matches CullParams in FireflyCull.comp
+		struct FireflyCullPushConstants
+		{
+			glm::vec4  planes[5];   // Frustum::planes
+			glm::vec4  cameraPos;   // xyz
+			glm::vec4  limits;      // minBrightness, maxDistance, pointDistance, -
+			glm::uvec4 counts;      // agentCount, cull (0: keep every agent), -, -
+		};
+		static_assert(sizeof(FireflyCullPushConstants) == 128, "FireflyCullPushConstants must match FireflyCull.comp");
+
+		// The two draws' arguments before the cull appends to them: a
+		// billboard is 6 vertices, a point 1
+		constexpr VkDrawIndirectCommand kBillboardArgs = { 6, 0, 0, 0 };
+		constexpr VkDrawIndirectCommand kPointArgs = { 1, 0, 0, 0 };
+
+		// Cells at least as wide as the larger interaction radius, so the 27
+		// cells around an agent hold all its neighbours; grown until the
+		// swarm box fits in FireflySystem::MAX_GRID_CELLS
+		FireflyGridPushConstants BuildGrid(const FireflyParamsData& params)
+		{
+			const glm::vec3 boxSize = glm::max(glm::vec3(params.boundsExtent) * 2.0f, glm::vec3(1e-3f));
+			const float volumeCell = std::cbrt(boxSize.x * boxSize.y * boxSize.z / FireflySystem::MAX_GRID_CELLS);
+			float cellSize = glm::max(glm::max(params.params2.x, params.params2.y), glm::max(volumeCell, 1e-3f));
+
+			glm::uvec3 dims;
+			for (;;)
+			{
+				dims = glm::uvec3(glm::max(glm::ceil(boxSize / cellSize), glm::vec3(1.0f)));
+				if (static_cast<uint64_t>(dims.x) * dims.y * dims.z <= FireflySystem::MAX_GRID_CELLS)
+					break;
+				cellSize *= 1.1f;
+			}
+
+			FireflyGridPushConstants grid{};
+			grid.origin = glm::vec4(glm::vec3(params.boundsCenter) - glm::vec3(params.boundsExtent), 1.0f / cellSize);
+			grid.dims = glm::uvec4(dims, kGridPassCount);
+			return grid;
+		}
+	}
+
 	static float RandomFloat(std::mt19937& rng, float min, float max)
 	{
 		std::uniform_real_distribution<float> dist(min, max);
@@ -23,6 +90,8 @@ namespace Nightbloom
 	bool FireflySystem::Initialize(Renderer* renderer, uint32_t agentCount,
 		const glm::vec3& center, const glm::vec3& extents)
 	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Effects);
+
 		if (!renderer)
 		{
 			LOG_ERROR("FireflySystem::Initialize — null renderer");
@@ -79,8 +148,9 @@ namespace Nightbloom
 		}
 
 		// ---- Agent storage buffer (GPU-only, uploaded once) ----------------
+		// Seeds written in place where the device allows, without a staging copy
 		VkDeviceSize agentBufferSize = agentCount * sizeof(FireflyAgentData);
-		m_AgentBuffer = m_Resources->CreateStorageBuffer("FireflyAgents", agentBufferSize, false);
+		m_AgentBuffer = m_Resources->CreateStorageBuffer("FireflyAgents", agentBufferSize, false, true);
 		if (!m_AgentBuffer)
 		{
 			LOG_ERROR("FireflySystem: failed to create agent storage buffer");
@@ -93,18 +163,43 @@ namespace Nightbloom
 			return false;
 		}
 
-		// ---- Params UBOs (double-buffered, CPU-writable every frame) ------
-		for (uint32_t i = 0; i < 2; ++i)
+		// ---- Draw cull lists (GPU-only, rebuilt every frame) -------------
+		// Seeded with every agent as a billboard, which is what the direct
+		// draw reads when the cull pipeline is missing
+		const VkDeviceSize visibleSize = GetVisibleBufferSize();
+		m_VisibleBuffer = m_Resources->CreateStorageBuffer("FireflyVisible", visibleSize, false);
+		m_DrawArgsBuffer = m_Resources->CreateIndirectBuffer("FireflyDrawArgs", GetDrawArgsBufferSize(), false);
+		if (!m_VisibleBuffer || !m_DrawArgsBuffer)
 		{
-			m_ParamsBuffers[i] = m_Resources->CreateUniformBuffer(
-				"FireflyParams_" + std::to_string(i), sizeof(FireflyParamsData));
-			if (!m_ParamsBuffers[i])
-			{
-				LOG_ERROR("FireflySystem: failed to create params UBO {}", i);
-				return false;
-			}
+			LOG_ERROR("FireflySystem: failed to create cull buffers");
+			return false;
+		}
 
-			m_DescriptorManager->UpdateFireflyParamsSet(i, m_ParamsBuffers[i]->GetBuffer(), sizeof(FireflyParamsData));
+		std::vector<uint32_t> visible(agentCount * 2ull, 0u);
+		for (uint32_t i = 0; i < agentCount; ++i)
+			visible[i] = i;
+		VkDrawIndirectCommand drawArgs[2] = { kBillboardArgs, kPointArgs };
+		drawArgs[0].instanceCount = agentCount;
+		if (!m_VisibleBuffer->UploadData(visible.data(), visibleSize, 0, m_Resources->GetTransferCommandPool()) ||
+			!m_DrawArgsBuffer->UploadData(drawArgs, sizeof(drawArgs), 0, m_Resources->GetTransferCommandPool()))
+		{
+			LOG_ERROR("FireflySystem: failed to upload initial cull lists");
+			return false;
+		}
+
+		// ---- Params UBO (a frame upload slot, CPU-written every frame) ---
+		VulkanFrameUploadBuffer* uploads = renderer->GetFrameUploads();
+		m_ParamsSlot = uploads->Reserve("FireflyParams", sizeof(FireflyParamsData));
+		if (!m_ParamsSlot.IsValid())
+		{
+			LOG_ERROR("FireflySystem: failed to reserve params UBO");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_DescriptorManager->UpdateFireflyParamsSet(i, uploads->GetBuffer(), sizeof(FireflyParamsData),
+				uploads->GetOffset(i, m_ParamsSlot));
 		}
 
 		// ---- Storage descriptor set (single, vertex+compute visible) ------
@@ -114,14 +209,50 @@ namespace Nightbloom
 			LOG_ERROR("FireflySystem: failed to allocate storage descriptor set");
 			return false;
 		}
-		m_DescriptorManager->UpdateFireflyStorageSet(m_StorageDescriptorSet, m_AgentBuffer->GetBuffer(), agentBufferSize);
+		m_DescriptorManager->UpdateFireflyStorageSet(m_StorageDescriptorSet,
+			m_AgentBuffer->GetBuffer(), agentBufferSize,
+			m_VisibleBuffer->GetBuffer(), visibleSize,
+			m_DrawArgsBuffer->GetBuffer(), GetDrawArgsBufferSize());
+
+		// ---- Neighbour grid (GPU-only, rebuilt every frame) ----------------
+		const VkDeviceSize cellStartSize = (MAX_GRID_CELLS + 1ull) * sizeof(uint32_t);
+		const VkDeviceSize agentCellSize = agentCount * sizeof(glm::uvec2);
+		const VkDeviceSize sortedSize = agentCount * 2ull * sizeof(glm::vec4);
+		m_CellStartBuffer = m_Resources->CreateStorageBuffer("FireflyGridCells", cellStartSize, false);
+		m_AgentCellBuffer = m_Resources->CreateStorageBuffer("FireflyGridAgentCells", agentCellSize, false);
+		m_SortedAgentBuffer = m_Resources->CreateStorageBuffer("FireflyGridSortedAgents", sortedSize, false);
+		if (!m_CellStartBuffer || !m_AgentCellBuffer || !m_SortedAgentBuffer)
+		{
+			LOG_ERROR("FireflySystem: failed to create neighbour grid buffers");
+			return false;
+		}
+
+		m_GridDescriptorSet = m_DescriptorManager->AllocateFireflyGridSet();
+		if (m_GridDescriptorSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("FireflySystem: failed to allocate grid descriptor set");
+			return false;
+		}
+		m_DescriptorManager->UpdateFireflyGridSet(m_GridDescriptorSet,
+			m_CellStartBuffer->GetBuffer(), cellStartSize,
+			m_AgentCellBuffer->GetBuffer(), agentCellSize,
+			m_SortedAgentBuffer->GetBuffer(), sortedSize);
 
-		if (!CreateComputePipeline())
+		if (!CreateComputePipelines())
 		{
-			LOG_ERROR("FireflySystem: failed to create compute pipeline");
+			LOG_ERROR("FireflySystem: failed to create compute pipelines");
 			return false;
 		}
 
+		// Optional: without it every agent is drawn as a billboard, and
+		// without the point pipeline distant ones stay billboards
+		if (!CreateCullPipeline())
+		{
+			LOG_WARN("FireflySystem: no draw cull pipeline - drawing every agent");
+		}
+		IPipelineManager* pipelines = renderer->GetPipelineManager();
+		m_PointPipeline = pipelines && pipelines->GetPipeline(PipelineType::FireflyPoint) != nullptr;
+
 		m_Ready = true;
 		LOG_INFO("FireflySystem initialized ({} agents)", agentCount);
 		return true;
@@ -138,6 +269,26 @@ namespace Nightbloom
 		VkDevice device = m_Renderer ? m_Renderer->GetVkDevice() : VK_NULL_HANDLE;
 		if (device != VK_NULL_HANDLE)
 		{
+			if (m_CullPipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_CullPipeline, nullptr);
+				m_CullPipeline = VK_NULL_HANDLE;
+			}
+			if (m_CullPipelineLayout != VK_NULL_HANDLE)
+			{
+				vkDestroyPipelineLayout(device, m_CullPipelineLayout, nullptr);
+				m_CullPipelineLayout = VK_NULL_HANDLE;
+			}
+			if (m_TiledPipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_TiledPipeline, nullptr);
+				m_TiledPipeline = VK_NULL_HANDLE;
+			}
+			if (m_GridPipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_GridPipeline, nullptr);
+				m_GridPipeline = VK_NULL_HANDLE;
+			}
 			if (m_ComputePipeline != VK_NULL_HANDLE)
 			{
 				vkDestroyPipeline(device, m_ComputePipeline, nullptr);
@@ -160,6 +311,16 @@ namespace Nightbloom
 		return m_AgentBuffer ? m_AgentBuffer->GetBuffer() : VK_NULL_HANDLE;
 	}
 
+	VkBuffer FireflySystem::GetVisibleBuffer() const
+	{
+		return m_VisibleBuffer ? m_VisibleBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkBuffer FireflySystem::GetDrawArgsBuffer() const
+	{
+		return m_DrawArgsBuffer ? m_DrawArgsBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
 	void FireflySystem::DispatchCompute(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
 		uint32_t frameIndex, float deltaTime)
 	{
@@ -168,21 +329,118 @@ namespace Nightbloom
 		m_TotalTime += deltaTime;
 		m_Params.params1.w = deltaTime;
 		m_Params.params3.x = m_TotalTime;
+		m_Params.params3.w = m_Wind.x * m_WindDrift;
+		m_Params.params4.w = m_Wind.y * m_WindDrift;
 
-		void* mapped = m_ParamsBuffers[frameIndex]->GetPersistentMappedPtr();
+		// Written while recording, after BeginFrame's upload flush
+		VulkanFrameUploadBuffer* uploads = m_Renderer->GetFrameUploads();
+		void* mapped = uploads->GetMapped(frameIndex, m_ParamsSlot);
 		if (mapped)
 		{
 			memcpy(mapped, &m_Params, sizeof(FireflyParamsData));
-			m_ParamsBuffers[frameIndex]->Flush();
+			uploads->Flush(frameIndex, m_ParamsSlot);
 		}
 
-		dispatcher->BindPipeline(cmd, m_ComputePipeline);
+		FireflyGridPushConstants grid = BuildGrid(m_Params);
+		const uint32_t cellCount = grid.dims.x * grid.dims.y * grid.dims.z;
+		const uint32_t agentGroups = ComputeDispatcher::CalculateGroupCount(m_AgentCount, kGridGroupSize);
+		const uint32_t updateGroups = ComputeDispatcher::CalculateGroupCount(m_AgentCount, kUpdateGroupSize);
+
+		// Fewer cells than one 3x3x3 block means every agent would visit
+		// (nearly) all the others anyway, just with the grid build on top
+		m_UsingTiledSearch = (m_NeighborSearch == FireflyNeighborSearch::Tiled) ||
+			(m_NeighborSearch == FireflyNeighborSearch::Auto &&
+				(m_AgentCount <= TILED_AGENT_LIMIT || cellCount < 27));
+
+		dispatcher->BindPipeline(cmd, m_GridPipeline);
 		dispatcher->BindDescriptorSet(cmd, m_ComputePipelineLayout, 0, m_StorageDescriptorSet);
 		dispatcher->BindDescriptorSet(cmd, m_ComputePipelineLayout, 1,
 			m_DescriptorManager->GetFireflyParamsDescriptorSet(frameIndex));
+		dispatcher->BindDescriptorSet(cmd, m_ComputePipelineLayout, 2, m_GridDescriptorSet);
 
-		uint32_t groupCount = ComputeDispatcher::CalculateGroupCount(m_AgentCount, 64);
-		dispatcher->Dispatch(cmd, groupCount, 1, 1);
+		if (m_UsingTiledSearch)
+		{
+			// Position/velocity snapshot in agent order (after last frame's
+			// update has finished reading the old one), then tiled all-pairs
+			dispatcher->ComputeToComputeGlobalBarrier(cmd);
+			grid.dims.w = kGridPassSnapshot;
+			dispatcher->PushConstants(cmd, m_ComputePipelineLayout, &grid, sizeof(FireflyGridPushConstants));
+			dispatcher->Dispatch(cmd, agentGroups, 1, 1);
+			dispatcher->ComputeToComputeGlobalBarrier(cmd);
+
+			dispatcher->BindPipeline(cmd, m_TiledPipeline);
+			dispatcher->Dispatch(cmd, updateGroups, 1, 1);
+			return;
+		}
+
+		const VkBuffer cellStartBuffer = m_CellStartBuffer->GetBuffer();
+		const VkDeviceSize cellStartBytes = (static_cast<VkDeviceSize>(cellCount) + 1) * sizeof(uint32_t);
+
+		// Last frame's update still reads the cell table; clear the counts
+		// once it is done
+		// (a write-after-read: execution only), then make the clear visible
+		dispatcher->QueueBufferBarrier(cmd, cellStartBuffer, cellStartBytes,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, 0, VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR, 0);
+		dispatcher->FlushBarriers(cmd);
+		vkCmdFillBuffer(cmd, cellStartBuffer, 0, cellStartBytes, 0);
+		dispatcher->QueueBufferBarrier(cmd, cellStartBuffer, cellStartBytes,
+			VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+
+		// Count agents per cell, prefix-sum the counts into cell ranges, then
+		// scatter each agent's position/velocity into its cell's range
+		dispatcher->PushConstants(cmd, m_ComputePipelineLayout, &grid, sizeof(FireflyGridPushConstants));
+		dispatcher->Dispatch(cmd, agentGroups, 1, 1);
+		dispatcher->ComputeToComputeGlobalBarrier(cmd);
+
+		grid.dims.w = kGridPassScan;
+		dispatcher->PushConstants(cmd, m_ComputePipelineLayout, &grid, sizeof(FireflyGridPushConstants));
+		dispatcher->Dispatch(cmd, 1, 1, 1);
+		dispatcher->ComputeToComputeGlobalBarrier(cmd);
+
+		grid.dims.w = kGridPassScatter;
+		dispatcher->PushConstants(cmd, m_ComputePipelineLayout, &grid, sizeof(FireflyGridPushConstants));
+		dispatcher->Dispatch(cmd, agentGroups, 1, 1);
+		dispatcher->ComputeToComputeGlobalBarrier(cmd);
+
+		// Same layout, so the sets and push constants stay bound
+		dispatcher->BindPipeline(cmd, m_ComputePipeline);
+		dispatcher->Dispatch(cmd, updateGroups, 1, 1);
+	}
+
+	void FireflySystem::DispatchCull(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
+		const glm::mat4& viewProj, const glm::vec3& cameraPosition)
+	{
+		if (!m_Ready || !dispatcher || !IsCulling()) return;
+
+		const Frustum frustum = Frustum::ExtractFromMatrix(viewProj);
+		FireflyCullPushConstants cull{};
+		for (uint32_t i = 0; i < 5; ++i)
+			cull.planes[i] = frustum.planes[i];
+		cull.cameraPos = glm::vec4(cameraPosition, 0.0f);
+		const float maxDistance = glm::max(m_CullSettings.maxDistance, 0.0f);
+		cull.limits = glm::vec4(m_CullSettings.minBrightness, maxDistance,
+			m_PointPipeline ? glm::min(m_CullSettings.pointDistance, maxDistance) : maxDistance, 0.0f);
+		cull.counts = glm::uvec4(m_AgentCount, m_CullSettings.enabled ? 1u : 0u, 0u, 0u);
+
+		// Last frame's draws read both buffers (single copies, like the
+		// agents): let them finish before the reset and the appends
+		dispatcher->QueueMemoryBarrier(cmd,
+			VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, 0,
+			VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, 0);
+		dispatcher->FlushBarriers(cmd);
+
+		// Reset both instance counts, then make the reset visible to the atomics
+		const VkDrawIndirectCommand drawArgs[2] = { kBillboardArgs, kPointArgs };
+		vkCmdUpdateBuffer(cmd, m_DrawArgsBuffer->GetBuffer(), 0, sizeof(drawArgs), drawArgs);
+		dispatcher->QueueBufferBarrier(cmd, m_DrawArgsBuffer->GetBuffer(), GetDrawArgsBufferSize(),
+			VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+
+		dispatcher->BindPipeline(cmd, m_CullPipeline);
+		dispatcher->BindDescriptorSet(cmd, m_CullPipelineLayout, 0, m_StorageDescriptorSet);
+		dispatcher->PushConstants(cmd, m_CullPipelineLayout, &cull, sizeof(FireflyCullPushConstants));
+		dispatcher->Dispatch(cmd, ComputeDispatcher::CalculateGroupCount(m_AgentCount, kCullGroupSize), 1, 1);
 	}
 
 	void FireflySystem::SubmitDraw(DrawList& drawList) const
@@ -190,7 +448,8 @@ namespace Nightbloom
 		if (!m_Ready) return;
 
 		// No vertex/index buffer — Firefly.vert generates the billboard quad
-		// procedurally from gl_VertexIndex (6 verts per instance, 2 triangles).
+		// procedurally from gl_VertexIndex (6 verts per instance, 2 triangles)
+		// and finds each instance's agent in the visible list.
 		DrawCommand cmd;
 		cmd.pipeline = PipelineType::Firefly;
 		cmd.vertexBuffer = nullptr;
@@ -200,30 +459,144 @@ namespace Nightbloom
 		cmd.hasPushConstants = false;
 		cmd.textureDescriptorSet = m_StorageDescriptorSet;
 
+		if (!IsCulling())
+		{
+			drawList.AddCommand(cmd);
+			return;
+		}
+
+		// Instance counts from FireflyCull.comp, this frame
+		cmd.indirectBuffer = m_DrawArgsBuffer;
+		cmd.indirectOffset = 0;
 		drawList.AddCommand(cmd);
+
+		if (m_PointPipeline)
+		{
+			// FireflyPoint.vert sizes each point from the target's height
+			cmd.pipeline = PipelineType::FireflyPoint;
+			cmd.vertexCount = 1;
+			cmd.indirectOffset = sizeof(VkDrawIndirectCommand);
+			cmd.hasPushConstants = true;
+			cmd.pushConstants.customData = glm::vec4(static_cast<float>(m_Renderer->GetRenderExtent().height), 0.0f, 0.0f, 0.0f);
+			drawList.AddCommand(cmd);
+		}
+	}
+
+	bool FireflySystem::CreateComputePipelines()
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		VkDescriptorSetLayout setLayouts[3] = {
+			m_DescriptorManager->GetFireflyStorageSetLayout(),
+			m_DescriptorManager->GetFireflyParamsSetLayout(),
+			m_DescriptorManager->GetFireflyGridSetLayout()
+		};
+
+		VkPushConstantRange pushRange{};
+		pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushRange.offset = 0;
+		pushRange.size = sizeof(FireflyGridPushConstants);
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 3;
+		layoutInfo.pSetLayouts = setLayouts;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushRange;
+
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_ComputePipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("FireflySystem: failed to create compute pipeline layout");
+			return false;
+		}
+
+		const bool subgroupOps = m_Renderer->GetDevice()->SupportsFeature("subgroup_ops");
+		const std::string gridShader = SelectSubgroupShader("FireflyGrid.comp.spv", subgroupOps);
+
+		// Independent builds against the shared cache: compile them across
+		// the job workers (this thread takes one too)
+		bool built[3] = {};
+		JobCounter done;
+		JobSystem::Get().Run([&]() { built[1] = CreateComputePipeline("FireflyUpdate.comp.spv", m_ComputePipelineLayout, m_ComputePipeline); }, &done);
+		JobSystem::Get().Run([&]() { built[2] = CreateComputePipeline("FireflyUpdateTiled.comp.spv", m_ComputePipelineLayout, m_TiledPipeline); }, &done);
+		built[0] = CreateComputePipeline(gridShader.c_str(), m_ComputePipelineLayout, m_GridPipeline);
+		JobSystem::Get().Wait(done);
+
+		if (!built[0] || !built[1] || !built[2])
+		{
+			for (VkPipeline* pipeline : { &m_GridPipeline, &m_ComputePipeline, &m_TiledPipeline })
+			{
+				if (*pipeline != VK_NULL_HANDLE)
+				{
+					vkDestroyPipeline(device, *pipeline, nullptr);
+					*pipeline = VK_NULL_HANDLE;
+				}
+			}
+			vkDestroyPipelineLayout(device, m_ComputePipelineLayout, nullptr);
+			m_ComputePipelineLayout = VK_NULL_HANDLE;
+			return false;
+		}
+
+		return true;
 	}
 
-	bool FireflySystem::CreateComputePipeline()
+	bool FireflySystem::CreateCullPipeline()
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		VkDescriptorSetLayout setLayout = m_DescriptorManager->GetFireflyStorageSetLayout();
+
+		VkPushConstantRange pushRange{};
+		pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushRange.offset = 0;
+		pushRange.size = sizeof(FireflyCullPushConstants);
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &setLayout;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushRange;
+
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_CullPipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("FireflySystem: failed to create cull pipeline layout");
+			return false;
+		}
+
+		const std::string cullShader = SelectSubgroupShader("FireflyCull.comp.spv",
+			m_Renderer->GetDevice()->SupportsFeature("subgroup_ops"));
+		if (!CreateComputePipeline(cullShader.c_str(), m_CullPipelineLayout, m_CullPipeline))
+		{
+			vkDestroyPipelineLayout(device, m_CullPipelineLayout, nullptr);
+			m_CullPipelineLayout = VK_NULL_HANDLE;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool FireflySystem::CreateComputePipeline(const char* shaderFile, VkPipelineLayout layout, VkPipeline& pipelineOut)
 	{
 		VkDevice device = m_Renderer->GetVkDevice();
 
 		auto& assetManager = AssetManager::Get();
-		auto shaderCode = assetManager.LoadShaderBinary("FireflyUpdate.comp.spv");
-		if (shaderCode.empty())
+		auto shaderCode = assetManager.LoadShaderBinary(shaderFile);
+		if (!shaderCode.IsOpen())
 		{
-			LOG_ERROR("FireflySystem: failed to load FireflyUpdate.comp.spv");
+			LOG_ERROR("FireflySystem: failed to load {}", shaderFile);
 			return false;
 		}
 
 		VkShaderModuleCreateInfo moduleInfo{};
 		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		moduleInfo.codeSize = shaderCode.size();
-		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
 
 		VkShaderModule shaderModule = VK_NULL_HANDLE;
 		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
 		{
-			LOG_ERROR("FireflySystem: failed to create compute shader module");
+			LOG_ERROR("FireflySystem: failed to create shader module for {}", shaderFile);
 			return false;
 		}
 
@@ -233,41 +606,24 @@ namespace Nightbloom
 		stageInfo.module = shaderModule;
 		stageInfo.pName = "main";
 
-		VkDescriptorSetLayout setLayouts[2] = {
-			m_DescriptorManager->GetFireflyStorageSetLayout(),
-			m_DescriptorManager->GetFireflyParamsSetLayout()
-		};
-
-		VkPipelineLayoutCreateInfo layoutInfo{};
-		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		layoutInfo.setLayoutCount = 2;
-		layoutInfo.pSetLayouts = setLayouts;
-
-		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_ComputePipelineLayout) != VK_SUCCESS)
-		{
-			LOG_ERROR("FireflySystem: failed to create compute pipeline layout");
-			vkDestroyShaderModule(device, shaderModule, nullptr);
-			return false;
-		}
-
 		VkComputePipelineCreateInfo pipelineInfo{};
 		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
 		pipelineInfo.stage = stageInfo;
-		pipelineInfo.layout = m_ComputePipelineLayout;
+		pipelineInfo.layout = layout;
 
-		VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_ComputePipeline);
+		VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &pipelineOut);
 
 		vkDestroyShaderModule(device, shaderModule, nullptr);
 
 		if (result != VK_SUCCESS)
 		{
-			LOG_ERROR("FireflySystem: failed to create compute pipeline");
-			vkDestroyPipelineLayout(device, m_ComputePipelineLayout, nullptr);
-			m_ComputePipelineLayout = VK_NULL_HANDLE;
+			LOG_ERROR("FireflySystem: failed to create compute pipeline for {}", shaderFile);
+			pipelineOut = VK_NULL_HANDLE;
 			return false;
 		}
+		VulkanDebugMarkers::SetName(device, pipelineOut, shaderFile);
 
-		LOG_INFO("FireflySystem: compute pipeline created");
+		LOG_INFO("FireflySystem: compute pipeline created ({})", shaderFile);
 		return true;
 	}
 
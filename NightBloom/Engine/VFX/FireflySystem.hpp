@@ -7,25 +7,41 @@
 // + blink pulse), scoped down to a single configurable swarm volume and no
 // special-fly (queen/predator) interaction.
 //
-// Agents live in a single GPU storage buffer, updated every frame by a raw
-// compute pipeline (owned directly here, not via PipelineType — same pattern
+// Agents live in a single GPU storage buffer, updated every frame by raw
+// compute pipelines (owned directly here, not via PipelineType — same pattern
 // as NoiseTextureGenerator, since this is a continuous simulation rather than
-// a one-shot utility or a generic per-frame draw). Rendering goes through the
+// a one-shot utility or a generic per-frame draw). Neighbour queries go
+// through a uniform grid rebuilt each frame (FireflyGrid.comp: count, scan,
+// scatter into a cell-sorted copy), so the update visits only the 27 cells
+// around each agent instead of every other agent. Small swarms skip the
+// grid and test all pairs in shared-memory tiles (FireflyUpdateTiled.comp),
+// which is cheaper below a few thousand agents. Rendering goes through the
 // normal PipelineType::Firefly graphics pipeline, reading the same buffer by
 // instance index.
 //
+// Every frame FireflyCull.comp then compacts the agents worth drawing into a
+// visible-index list and two VkDrawIndirectCommands: fireflies outside the
+// camera frustum, too dim to see or past the cull distance are dropped, and
+// those past the point distance go to a second list drawn as single points
+// (PipelineType::FireflyPoint) instead of 6-vertex billboards. Both draws
+// read their instance counts from the GPU, so most of a large swarm being
+// off screen costs neither vertex work nor additive overdraw.
+//
 // Usage:
 //   FireflySystem fireflies;
 //   fireflies.Initialize(renderer, agentCount, center, extents);
 //   // Per frame, before the main render pass begins:
 //   fireflies.DispatchCompute(cmd, dispatcher, frameIndex, deltaTime);
 //   // (Renderer is responsible for the compute->vertex barrier afterward)
+//   fireflies.DispatchCull(cmd, dispatcher, viewProj, cameraPos);
 //   fireflies.SubmitDraw(drawList);
 //   fireflies.Shutdown();
 //------------------------------------------------------------------------------
 #pragma once
 
 #include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/FrameUploadLayout.hpp"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 
@@ -63,15 +79,40 @@ namespace Nightbloom
 	{
 		glm::vec4 params1 = glm::vec4(1.5f, 0.1f, 0.1f, 0.0f);   // separation, alignment, cohesion, deltaTime
 		glm::vec4 params2 = glm::vec4(4.0f, 1.5f, 1.0f, 10.0f);  // perceptionRadius, separationRadius, minSpeed, maxSpeed
-		glm::vec4 params3 = glm::vec4(0.0f, 0.35f, 2.0f, 0.0f);  // totalTime, wanderStrength, wanderForceScale, unused
-		glm::vec4 params4 = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);   // globalBlinkSpeedScale, globalBlinkAmplitude, agentCount, unused
+		glm::vec4 params3 = glm::vec4(0.0f, 0.35f, 2.0f, 0.0f);  // totalTime, wanderStrength, wanderForceScale, wind force x
+		glm::vec4 params4 = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);   // globalBlinkSpeedScale, globalBlinkAmplitude, agentCount, wind force z
 		glm::vec4 boundsCenter = glm::vec4(0.0f);                // xyz = swarm center
 		glm::vec4 boundsExtent = glm::vec4(50.0f, 20.0f, 50.0f, 0.0f); // xyz = swarm half-extents
 	};
 
+	// Draw culling, tunable from the panel. Distances are from the camera.
+	struct FireflyCullSettings
+	{
+		bool enabled = true;          // off: every agent drawn as a billboard
+		float minBrightness = 0.02f;  // dimmer agents are skipped
+		float maxDistance = 250.0f;   // farther agents are skipped
+		float pointDistance = 60.0f;  // farther agents are drawn as points
+	};
+
+	// How the update finds each agent's neighbours. Auto picks Tiled for
+	// small swarms and whenever the grid would be too coarse to prune.
+	enum class FireflyNeighborSearch : uint8_t
+	{
+		Auto,
+		Grid,
+		Tiled
+	};
+
 	class FireflySystem
 	{
 	public:
+		// Upper bound on grid cells; larger swarms (relative to the
+		// perception radius) get coarser cells rather than more of them
+		static constexpr uint32_t MAX_GRID_CELLS = 65536;
+
+		// Auto uses the tiled all-pairs search up to this many agents
+		static constexpr uint32_t TILED_AGENT_LIMIT = 2048;
+
 		FireflySystem() = default;
 		~FireflySystem() = default;
 
@@ -83,16 +124,41 @@ namespace Nightbloom
 		void Shutdown();
 
 		// Uploads this frame's params (with deltaTime/totalTime baked in),
-		// binds the compute pipeline + descriptor sets, and dispatches.
+		// rebuilds the neighbour grid, then dispatches the update.
 		// Caller (Renderer) is responsible for the compute->vertex barrier
 		// afterward, since it owns the command buffer and barrier helpers.
 		void DispatchCompute(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
 			uint32_t frameIndex, float deltaTime);
 
+		// Fills this frame's visible lists and indirect draws from the
+		// updated agents (FireflyCull.comp). On the graphics queue after
+		// the agents are available; the Renderer orders it against the
+		// update and the draws.
+		void DispatchCull(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
+			const glm::mat4& viewProj, const glm::vec3& cameraPosition);
+
+		// The billboard and point draws DispatchCull fills in, or one
+		// billboard per agent when it is unavailable
 		void SubmitDraw(DrawList& drawList) const;
 
 		bool IsReady() const { return m_Ready; }
 
+		void SetNeighborSearch(FireflyNeighborSearch search) { m_NeighborSearch = search; }
+		FireflyNeighborSearch GetNeighborSearch() const { return m_NeighborSearch; }
+		// Whether the last DispatchCompute took the tiled path (Auto resolved)
+		bool IsUsingTiledSearch() const { return m_UsingTiledSearch; }
+
+		// The wind at the swarm's centre (Wind::Direction * Wind::Push), set by
+		// the Renderer each frame; scaled by the wind drift into a force
+		void SetWind(const glm::vec2& wind) { m_Wind = wind; }
+		void SetWindDrift(float drift) { m_WindDrift = drift; }
+		float GetWindDrift() const { return m_WindDrift; }
+
+		FireflyCullSettings& GetCullSettings() { return m_CullSettings; }
+		const FireflyCullSettings& GetCullSettings() const { return m_CullSettings; }
+		// Whether the draws come from DispatchCull (its pipeline was built)
+		bool IsCulling() const { return m_CullPipeline != VK_NULL_HANDLE; }
+
 		// Live-tunable params — panel writes directly into this each frame
 		FireflyParamsData& GetParams() { return m_Params; }
 		const FireflyParamsData& GetParams() const { return m_Params; }
@@ -101,8 +167,20 @@ namespace Nightbloom
 		VkBuffer GetAgentBuffer() const;
 		VkDeviceSize GetAgentBufferSize() const { return m_AgentCount * sizeof(FireflyAgentData); }
 
+		// For the light cluster gather (LightClusterCuller): each agent is a point light
+		uint32_t GetAgentCount() const { return m_AgentCount; }
+		VkDescriptorSet GetStorageDescriptorSet() const { return m_StorageDescriptorSet; }
+
+		// For the Renderer's graph: written by DispatchCull, read by the draws
+		VkBuffer GetVisibleBuffer() const;
+		VkDeviceSize GetVisibleBufferSize() const { return m_AgentCount * 2ull * sizeof(uint32_t); }
+		VkBuffer GetDrawArgsBuffer() const;
+		VkDeviceSize GetDrawArgsBufferSize() const { return 2 * sizeof(VkDrawIndirectCommand); }
+
 	private:
-		bool CreateComputePipeline();
+		bool CreateComputePipelines();
+		bool CreateComputePipeline(const char* shaderFile, VkPipelineLayout layout, VkPipeline& pipelineOut);
+		bool CreateCullPipeline();
 
 		Renderer* m_Renderer = nullptr;
 		ResourceManager* m_Resources = nullptr;
@@ -110,18 +188,41 @@ namespace Nightbloom
 
 		// GPU resources
 		VulkanBuffer* m_AgentBuffer = nullptr;      // owned by ResourceManager's named buffer cache
-		VulkanBuffer* m_ParamsBuffers[2] = { nullptr, nullptr }; // double-buffered, owned by ResourceManager
+		FrameUploadSlot m_ParamsSlot;                // in the Renderer's frame upload buffer, one copy per frame in flight
+
+		// Neighbour grid (firefly_grid.glsl), owned by ResourceManager
+		VulkanBuffer* m_CellStartBuffer = nullptr;  // MAX_GRID_CELLS + 1 uints
+		VulkanBuffer* m_AgentCellBuffer = nullptr;  // uvec2 per agent
+		VulkanBuffer* m_SortedAgentBuffer = nullptr; // 2x vec4 per agent
+
+		// Draw culling (FireflyCull.comp), owned by ResourceManager
+		VulkanBuffer* m_VisibleBuffer = nullptr;    // billboard list [0, N), point list [N, 2N)
+		VulkanBuffer* m_DrawArgsBuffer = nullptr;   // billboard then point VkDrawIndirectCommand
 
 		VkDescriptorSet m_StorageDescriptorSet = VK_NULL_HANDLE;
+		VkDescriptorSet m_GridDescriptorSet = VK_NULL_HANDLE;
 
-		// Compute pipeline — owned directly (continuous simulation, not a
-		// generic per-frame graphics draw), same pattern as NoiseTextureGenerator
+		// Compute pipelines — owned directly (continuous simulation, not a
+		// generic per-frame graphics draw), same pattern as NoiseTextureGenerator.
+		// All share one layout: agents, params, grid + the grid push constants.
+		VkPipeline       m_GridPipeline = VK_NULL_HANDLE;
 		VkPipeline       m_ComputePipeline = VK_NULL_HANDLE;
+		VkPipeline       m_TiledPipeline = VK_NULL_HANDLE;
 		VkPipelineLayout m_ComputePipelineLayout = VK_NULL_HANDLE;
 
+		// Storage set only; frustum, distances and counts as push constants
+		VkPipeline       m_CullPipeline = VK_NULL_HANDLE;
+		VkPipelineLayout m_CullPipelineLayout = VK_NULL_HANDLE;
+		bool m_PointPipeline = false;   // PipelineType::FireflyPoint was built
+
 		FireflyParamsData m_Params;
+		FireflyCullSettings m_CullSettings;
+		glm::vec2 m_Wind = glm::vec2(0.0f);
+		float m_WindDrift = 0.5f;   // m/s^2 per unit of wind push
 		uint32_t m_AgentCount = 0;
 		float m_TotalTime = 0.0f;
+		FireflyNeighborSearch m_NeighborSearch = FireflyNeighborSearch::Auto;
+		bool m_UsingTiledSearch = false;
 		bool m_Ready = false;
 	};
 
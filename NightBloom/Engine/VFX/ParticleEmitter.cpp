@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+// ParticleEmitter.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/VFX/ParticleEmitter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Nightbloom
+{
+	ParticleEmitterDesc ParticleEmitterDesc::Pollen()
+	{
+		ParticleEmitterDesc desc;
+		desc.name = "Pollen";
+		desc.capacity = 32768;
+		desc.spawnRate = 2500.0f;
+		desc.followCamera = true;
+		desc.center = glm::vec3(0.0f, 3.0f, 0.0f);
+		desc.extents = glm::vec3(40.0f, 8.0f, 40.0f);
+		desc.velocityMin = glm::vec3(-0.1f, -0.05f, -0.1f);
+		desc.velocityMax = glm::vec3(0.1f, 0.1f, 0.1f);
+		desc.lifetimeMin = 8.0f;
+		desc.lifetimeMax = 14.0f;
+		desc.drag = 0.5f;
+		desc.windInfluence = 1.5f;
+		desc.turbulence = 0.4f;
+		desc.turbulenceScale = 0.15f;
+		desc.sizeMin = 0.02f;
+		desc.sizeMax = 0.05f;
+		desc.colorStart = glm::vec4(1.0f, 0.95f, 0.7f, 0.8f);
+		desc.colorEnd = glm::vec4(1.0f, 0.9f, 0.6f, 0.6f);
+		desc.fadeIn = 0.2f;
+		desc.fadeOut = 0.3f;
+		desc.blend = ParticleBlend::Translucent;
+		return desc;
+	}
+
+	ParticleEmitterDesc ParticleEmitterDesc::Rain()
+	{
+		// Falls ~25 m in its life from the top of a box around the camera;
+		// the depth test hides drops that pass through the ground
+		ParticleEmitterDesc desc;
+		desc.name = "Rain";
+		desc.capacity = 131072;
+		desc.spawnRate = 50000.0f;
+		desc.followCamera = true;
+		desc.center = glm::vec3(0.0f, 15.0f, 0.0f);
+		desc.extents = glm::vec3(40.0f, 5.0f, 40.0f);
+		desc.velocityMin = glm::vec3(-0.3f, -12.0f, -0.3f);
+		desc.velocityMax = glm::vec3(0.3f, -10.0f, 0.3f);
+		desc.lifetimeMin = 2.0f;
+		desc.lifetimeMax = 2.5f;
+		desc.windInfluence = 2.0f;
+		desc.sizeMin = 0.008f;
+		desc.sizeMax = 0.012f;
+		desc.stretch = 0.04f;
+		desc.colorStart = glm::vec4(0.7f, 0.75f, 0.8f, 0.35f);
+		desc.colorEnd = desc.colorStart;
+		desc.fadeIn = 0.05f;
+		desc.fadeOut = 0.05f;
+		desc.blend = ParticleBlend::Translucent;
+		return desc;
+	}
+
+	ParticleEmitterDesc ParticleEmitterDesc::Embers()
+	{
+		// Rising from a campfire-sized box, cooling from orange to dull red
+		ParticleEmitterDesc desc;
+		desc.name = "Embers";
+		desc.capacity = 16384;
+		desc.spawnRate = 300.0f;
+		desc.center = glm::vec3(0.0f, 0.5f, 0.0f);
+		desc.extents = glm::vec3(1.0f, 0.2f, 1.0f);
+		desc.velocityMin = glm::vec3(-0.5f, 1.5f, -0.5f);
+		desc.velocityMax = glm::vec3(0.5f, 3.5f, 0.5f);
+		desc.lifetimeMin = 1.5f;
+		desc.lifetimeMax = 3.5f;
+		desc.gravity = glm::vec3(0.0f, 0.3f, 0.0f);   // buoyant
+		desc.drag = 0.3f;
+		desc.windInfluence = 0.8f;
+		desc.turbulence = 2.0f;
+		desc.turbulenceScale = 0.5f;
+		desc.sizeMin = 0.02f;
+		desc.sizeMax = 0.05f;
+		desc.sizeEnd = 0.3f;
+		desc.stretch = 0.02f;
+		desc.colorStart = glm::vec4(6.0f, 2.0f, 0.4f, 1.0f);
+		desc.colorEnd = glm::vec4(1.5f, 0.2f, 0.02f, 1.0f);
+		desc.fadeIn = 0.05f;
+		desc.fadeOut = 0.5f;
+		desc.blend = ParticleBlend::Additive;
+		return desc;
+	}
+
+	std::vector<ParticleRange> PlanParticleRanges(const std::vector<ParticleEmitterDesc>& emitters,
+		uint32_t poolCapacity)
+	{
+		std::vector<ParticleRange> ranges;
+		ranges.reserve(emitters.size());
+
+		uint32_t base = 0;
+		for (const ParticleEmitterDesc& emitter : emitters)
+		{
+			ParticleRange range;
+			range.base = base;
+			range.capacity = std::min(emitter.capacity, poolCapacity - base);
+			base += range.capacity;
+			ranges.push_back(range);
+		}
+		return ranges;
+	}
+
+	uint32_t AccumulateSpawns(float& accumulator, float rate, float deltaTime, uint32_t capacity)
+	{
+		accumulator += std::max(rate, 0.0f) * std::max(deltaTime, 0.0f);
+		const float whole = std::floor(accumulator);
+		if (whole >= static_cast<float>(capacity))
+		{
+			accumulator = 0.0f;
+			return capacity;
+		}
+		accumulator -= whole;
+		return static_cast<uint32_t>(whole);
+	}
+
+	ParticleEmitterGpu PackParticleEmitter(const ParticleEmitterDesc& desc, const ParticleRange& range,
+		uint32_t spawnCount, const glm::vec3& cameraPosition)
+	{
+		const float lifetimeMin = std::max(desc.lifetimeMin, 1e-3f);
+
+		ParticleEmitterGpu gpu{};
+		gpu.center = glm::vec4(GetParticleEmitterCenter(desc, cameraPosition), std::max(desc.drag, 0.0f));
+		gpu.extents = glm::vec4(glm::max(desc.extents, glm::vec3(0.0f)), desc.windInfluence);
+		gpu.velocityMin = glm::vec4(desc.velocityMin, lifetimeMin);
+		gpu.velocityMax = glm::vec4(desc.velocityMax, std::max(desc.lifetimeMax, lifetimeMin));
+		gpu.gravity = glm::vec4(desc.gravity, desc.killHeight);
+		gpu.motion = glm::vec4(desc.turbulence, desc.turbulenceScale,
+			std::max(desc.sizeMin, 0.0f), std::max(desc.sizeMax, desc.sizeMin));
+		gpu.range = glm::uvec4(range.base, range.capacity, std::min(spawnCount, range.capacity), 0u);
+		return gpu;
+	}
+
+} // namespace Nightbloom
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// ParticleEmitter.hpp
+//
+// Emitter definitions for ParticleSystem, and the CPU side of its frame:
+// how the shared particle pool is split between emitters, how many
+// particles each spawns this frame, and the records the simulation shaders
+// read (ParticleEmitterGpu, particle_sim.glsl). An emitter is a spawn box,
+// initial velocity and lifetime ranges, the forces acting on its particles
+// and how they look over their life; Pollen / Rain / Embers are the presets
+// the panel offers.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	// How a particle's color combines with what is behind it. Both are drawn
+	// through the OIT pass when it is on; without it the emitters are sorted
+	// back to front against each other, their particles unsorted.
+	enum class ParticleBlend : uint8_t
+	{
+		Additive,     // glows: embers, sparks
+		Translucent   // covers: pollen, rain, dust
+	};
+
+	struct ParticleEmitterDesc
+	{
+		std::string name = "Emitter";
+		bool enabled = true;           // off: spawns nothing, live particles finish their life
+
+		// Pool share, fixed until the emitter list changes (ParticleSystem
+		// restarts every emitter then)
+		uint32_t capacity = 16384;
+		float spawnRate = 1000.0f;     // particles per second
+
+		// Spawn box; around the camera instead of the world origin when
+		// followCamera is set (weather, ambient dust)
+		glm::vec3 center = glm::vec3(0.0f, 5.0f, 0.0f);
+		glm::vec3 extents = glm::vec3(20.0f, 5.0f, 20.0f);
+		bool followCamera = false;
+
+		glm::vec3 velocityMin = glm::vec3(-0.5f, 0.0f, -0.5f);
+		glm::vec3 velocityMax = glm::vec3(0.5f, 0.5f, 0.5f);
+		float lifetimeMin = 2.0f;      // seconds
+		float lifetimeMax = 4.0f;
+
+		// Forces
+		glm::vec3 gravity = glm::vec3(0.0f);
+		float drag = 0.0f;             // 1/s, slows the particle's own velocity
+		float windInfluence = 0.0f;    // m/s of drift per unit of wind push, on top of it
+		float turbulence = 0.0f;       // m/s^2 of curling noise
+		float turbulenceScale = 0.2f;  // noise frequency, 1/m
+		float killHeight = -1e30f;     // dies on dropping below this y (rain hitting the ground)
+
+		// Look over a particle's life (0 at birth, 1 at death)
+		float sizeMin = 0.05f;         // metres, picked per particle
+		float sizeMax = 0.1f;
+		float sizeEnd = 1.0f;          // size scale reached at death
+		float stretch = 0.0f;          // seconds of motion the billboard stretches along (streaks)
+		glm::vec4 colorStart = glm::vec4(1.0f);  // rgb may exceed 1 (HDR), a = opacity
+		glm::vec4 colorEnd = glm::vec4(1.0f);
+		float fadeIn = 0.1f;           // life fractions faded in / out
+		float fadeOut = 0.3f;
+		ParticleBlend blend = ParticleBlend::Translucent;
+
+		static ParticleEmitterDesc Pollen();
+		static ParticleEmitterDesc Rain();
+		static ParticleEmitterDesc Embers();
+	};
+
+	// An emitter's slice of the pool: particles, dead list and both alive
+	// lists all use [base, base + capacity)
+	struct ParticleRange
+	{
+		uint32_t base = 0;
+		uint32_t capacity = 0;
+	};
+
+	// Hands out the pool in emitter order; an emitter past the end gets what
+	// is left (possibly nothing)
+	std::vector<ParticleRange> PlanParticleRanges(const std::vector<ParticleEmitterDesc>& emitters,
+		uint32_t poolCapacity);
+
+	// Whole particles due this frame at `rate` per second; the fraction is
+	// carried in `accumulator`. Capped at `capacity` (what could possibly be
+	// free), the excess dropped rather than owed.
+	uint32_t AccumulateSpawns(float& accumulator, float rate, float deltaTime, uint32_t capacity);
+
+	// Matches Emitter in particle_sim.glsl (std140, 8x vec4)
+	struct ParticleEmitterGpu
+	{
+		glm::vec4  center;       // xyz = spawn box centre (world), w = drag
+		glm::vec4  extents;      // xyz = half extents, w = wind influence
+		glm::vec4  velocityMin;  // xyz, w = lifetime min
+		glm::vec4  velocityMax;  // xyz, w = lifetime max
+		glm::vec4  gravity;      // xyz, w = kill height
+		glm::vec4  motion;       // turbulence, turbulence scale, size min, size max
+		glm::uvec4 range;        // base, capacity, spawn count, -
+		glm::vec4  reserved;
+	};
+	static_assert(sizeof(ParticleEmitterGpu) == 128, "ParticleEmitterGpu must match particle_sim.glsl");
+
+	ParticleEmitterGpu PackParticleEmitter(const ParticleEmitterDesc& desc, const ParticleRange& range,
+		uint32_t spawnCount, const glm::vec3& cameraPosition);
+
+	// Where the emitter's box is this frame
+	inline glm::vec3 GetParticleEmitterCenter(const ParticleEmitterDesc& desc, const glm::vec3& cameraPosition)
+	{
+		return desc.followCamera ? cameraPosition + desc.center : desc.center;
+	}
+
+} // namespace Nightbloom
@@ -0,0 +1,419 @@
+//------------------------------------------------------------------------------
+// ParticleSystem.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/VFX/ParticleSystem.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Components/ResourceManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDescriptorManager.hpp"
+#include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanFrameUploadBuffer.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDebugMarkers.hpp"
+#include "Engine/Renderer/Components/ComputeDispatcher.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/GpuMemoryTracker.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		// Matches PassParams in particle_sim.glsl
+		struct ParticlePushConstants
+		{
+			glm::vec4  frame;   // deltaTime, total time, wind x, wind z
+			glm::uvec4 info;    // pass, emitter count, frame seed, -
+		};
+		static_assert(sizeof(ParticlePushConstants) == 32, "ParticlePushConstants must match particle_sim.glsl");
+
+		// ParticleSimulate.comp passes (info.x)
+		constexpr uint32_t kPassReset = 0;
+		constexpr uint32_t kPassEmit = 1;
+		constexpr uint32_t kPassPrepare = 2;
+		constexpr uint32_t kPassUpdate = 3;
+		constexpr uint32_t kPassFinalize = 4;
+
+		constexpr uint32_t kGroupSize = 64;
+
+		// The update's VkDispatchIndirectCommand follows the draws
+		constexpr VkDeviceSize kDispatchArgsOffset =
+			ParticleSystem::MAX_EMITTERS * sizeof(VkDrawIndirectCommand);
+	}
+
+	bool ParticleSystem::Initialize(Renderer* renderer, uint32_t poolCapacity)
+	{
+		GpuMemoryScope memoryScope(GpuMemoryCategory::Effects);
+
+		if (!renderer)
+		{
+			LOG_ERROR("ParticleSystem::Initialize — null renderer");
+			return false;
+		}
+
+		m_Renderer = renderer;
+		m_Resources = renderer->GetResourceManager();
+		m_DescriptorManager = renderer->GetDescriptorManager();
+		m_PoolCapacity = std::max(poolCapacity, 1u);
+
+		if (!m_Resources || !m_DescriptorManager)
+		{
+			LOG_ERROR("ParticleSystem::Initialize — renderer subsystems not ready");
+			return false;
+		}
+
+		// ---- Pool buffers (GPU-only, never read back) ----------------------
+		// The particles, lists and counters are filled by the reset pass; the
+		// arguments start zeroed so nothing is drawn before the first Dispatch
+		const VkDeviceSize deadSize = m_PoolCapacity * sizeof(uint32_t);
+		m_ParticleBuffer = m_Resources->CreateStorageBuffer("ParticlePool", GetParticleBufferSize(), false);
+		m_DeadBuffer = m_Resources->CreateStorageBuffer("ParticleDeadList", deadSize, false);
+		m_AliveBuffer = m_Resources->CreateStorageBuffer("ParticleAliveLists", GetAliveBufferSize(), false);
+		m_CounterBuffer = m_Resources->CreateStorageBuffer("ParticleCounters", GetCounterBufferSize(), false);
+		m_ArgsBuffer = m_Resources->CreateIndirectBuffer("ParticleArgs", GetArgsBufferSize(), false);
+		if (!m_ParticleBuffer || !m_DeadBuffer || !m_AliveBuffer || !m_CounterBuffer || !m_ArgsBuffer)
+		{
+			LOG_ERROR("ParticleSystem: failed to create pool buffers");
+			return false;
+		}
+
+		std::vector<uint8_t> zeroArgs(GetArgsBufferSize(), 0);
+		if (!m_ArgsBuffer->UploadData(zeroArgs.data(), GetArgsBufferSize(), 0, m_Resources->GetTransferCommandPool()))
+		{
+			LOG_ERROR("ParticleSystem: failed to clear draw arguments");
+			return false;
+		}
+
+		// ---- Emitter UBO (a frame upload slot, CPU-written every frame) --
+		VulkanFrameUploadBuffer* uploads = renderer->GetFrameUploads();
+		const VkDeviceSize emitterSize = MAX_EMITTERS * sizeof(ParticleEmitterGpu);
+		m_EmitterSlot = uploads->Reserve("ParticleEmitters", emitterSize);
+		if (!m_EmitterSlot.IsValid())
+		{
+			LOG_ERROR("ParticleSystem: failed to reserve emitter UBO");
+			return false;
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_DescriptorManager->UpdateParticleParamsSet(i, uploads->GetBuffer(), emitterSize,
+				uploads->GetOffset(i, m_EmitterSlot));
+		}
+
+		// ---- Storage descriptor set (single, vertex+compute visible) ------
+		m_StorageDescriptorSet = m_DescriptorManager->AllocateParticleStorageSet();
+		if (m_StorageDescriptorSet == VK_NULL_HANDLE)
+		{
+			LOG_ERROR("ParticleSystem: failed to allocate storage descriptor set");
+			return false;
+		}
+		m_DescriptorManager->UpdateParticleStorageSet(m_StorageDescriptorSet,
+			m_ParticleBuffer->GetBuffer(), GetParticleBufferSize(),
+			m_AliveBuffer->GetBuffer(), GetAliveBufferSize(),
+			m_DeadBuffer->GetBuffer(), deadSize,
+			m_CounterBuffer->GetBuffer(), GetCounterBufferSize(),
+			m_ArgsBuffer->GetBuffer(), GetArgsBufferSize());
+
+		if (!CreateComputePipeline())
+		{
+			LOG_ERROR("ParticleSystem: failed to create compute pipeline");
+			return false;
+		}
+
+		m_ResetPending = true;
+		m_Ready = true;
+		LOG_INFO("ParticleSystem initialized ({} particle pool)", m_PoolCapacity);
+		return true;
+	}
+
+	void ParticleSystem::Shutdown()
+	{
+		if (m_Renderer)
+		{
+			m_Renderer->GetDevice()->WaitForIdle();
+			m_Renderer->SetParticleSystem(nullptr); // avoid a dangling pointer once we destroy our resources below
+		}
+
+		VkDevice device = m_Renderer ? m_Renderer->GetVkDevice() : VK_NULL_HANDLE;
+		if (device != VK_NULL_HANDLE)
+		{
+			if (m_Pipeline != VK_NULL_HANDLE)
+			{
+				vkDestroyPipeline(device, m_Pipeline, nullptr);
+				m_Pipeline = VK_NULL_HANDLE;
+			}
+			if (m_PipelineLayout != VK_NULL_HANDLE)
+			{
+				vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+				m_PipelineLayout = VK_NULL_HANDLE;
+			}
+		}
+
+		m_Emitters.clear();
+		m_Ranges.clear();
+		m_SpawnAccumulators.clear();
+		m_Ready = false;
+
+		LOG_INFO("ParticleSystem shut down");
+	}
+
+	uint32_t ParticleSystem::AddEmitter(const ParticleEmitterDesc& desc)
+	{
+		if (m_Emitters.size() >= MAX_EMITTERS)
+		{
+			LOG_WARN("ParticleSystem: at most {} emitters - '{}' not added", MAX_EMITTERS, desc.name);
+			return INVALID_EMITTER;
+		}
+
+		m_Emitters.push_back(desc);
+		RestartEmitters();
+
+		if (m_Ranges.back().capacity < desc.capacity)
+		{
+			LOG_WARN("ParticleSystem: emitter '{}' got {} of the {} particles it asked for",
+				desc.name, m_Ranges.back().capacity, desc.capacity);
+		}
+		return static_cast<uint32_t>(m_Emitters.size() - 1);
+	}
+
+	void ParticleSystem::RemoveEmitter(uint32_t index)
+	{
+		if (index >= m_Emitters.size()) return;
+
+		m_Emitters.erase(m_Emitters.begin() + index);
+		RestartEmitters();
+	}
+
+	void ParticleSystem::RestartEmitters()
+	{
+		m_Ranges = PlanParticleRanges(m_Emitters, m_PoolCapacity);
+		m_SpawnAccumulators.assign(m_Emitters.size(), 0.0f);
+		m_ResetPending = true;
+	}
+
+	VkBuffer ParticleSystem::GetParticleBuffer() const
+	{
+		return m_ParticleBuffer ? m_ParticleBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkBuffer ParticleSystem::GetAliveBuffer() const
+	{
+		return m_AliveBuffer ? m_AliveBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkBuffer ParticleSystem::GetCounterBuffer() const
+	{
+		return m_CounterBuffer ? m_CounterBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	VkBuffer ParticleSystem::GetArgsBuffer() const
+	{
+		return m_ArgsBuffer ? m_ArgsBuffer->GetBuffer() : VK_NULL_HANDLE;
+	}
+
+	void ParticleSystem::Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
+		uint32_t frameIndex, float deltaTime, const glm::vec3& cameraPosition)
+	{
+		if (!m_Ready || !dispatcher || m_Emitters.empty()) return;
+
+		m_TotalTime += deltaTime;
+		++m_FrameCounter;
+
+		// ---- Emitters: this frame's spawns and where their boxes are -----
+		std::array<ParticleEmitterGpu, MAX_EMITTERS> emitters{};
+		uint32_t maxCapacity = 0;
+		uint32_t maxSpawn = 0;
+		const uint32_t emitterCount = GetEmitterCount();
+		for (uint32_t i = 0; i < emitterCount; ++i)
+		{
+			const ParticleEmitterDesc& desc = m_Emitters[i];
+			const ParticleRange& range = m_Ranges[i];
+			const uint32_t spawn = desc.enabled
+				? AccumulateSpawns(m_SpawnAccumulators[i], desc.spawnRate, deltaTime, range.capacity)
+				: 0u;
+			emitters[i] = PackParticleEmitter(desc, range, spawn, cameraPosition);
+			maxCapacity = std::max(maxCapacity, range.capacity);
+			maxSpawn = std::max(maxSpawn, emitters[i].range.z);
+		}
+
+		// Written while recording, after BeginFrame's upload flush
+		VulkanFrameUploadBuffer* uploads = m_Renderer->GetFrameUploads();
+		void* mapped = uploads->GetMapped(frameIndex, m_EmitterSlot);
+		if (mapped)
+		{
+			memcpy(mapped, emitters.data(), sizeof(emitters));
+			uploads->Flush(frameIndex, m_EmitterSlot);
+		}
+
+		ParticlePushConstants push{};
+		push.frame = glm::vec4(deltaTime, m_TotalTime, m_Wind.x, m_Wind.y);
+		push.info = glm::uvec4(kPassReset, emitterCount, m_FrameCounter, 0u);
+
+		// Last frame's draws read the particles, lists and arguments (single
+		// copies, like the firefly agents): let them finish first
+		vkCmdPipelineBarrier(cmd,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+		dispatcher->BindPipeline(cmd, m_Pipeline);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 0, m_StorageDescriptorSet);
+		dispatcher->BindDescriptorSet(cmd, m_PipelineLayout, 1,
+			m_DescriptorManager->GetParticleParamsDescriptorSet(frameIndex));
+
+		// Every slot of every slice back on its dead list
+		if (m_ResetPending && maxCapacity > 0)
+		{
+			dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(ParticlePushConstants));
+			dispatcher->Dispatch(cmd, ComputeDispatcher::CalculateGroupCount(maxCapacity, kGroupSize), emitterCount, 1);
+			dispatcher->ComputeToComputeGlobalBarrier(cmd);
+			m_ResetPending = false;
+		}
+
+		if (maxSpawn > 0)
+		{
+			push.info.x = kPassEmit;
+			dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(ParticlePushConstants));
+			dispatcher->Dispatch(cmd, ComputeDispatcher::CalculateGroupCount(maxSpawn, kGroupSize), emitterCount, 1);
+			dispatcher->ComputeToComputeGlobalBarrier(cmd);
+		}
+
+		// Size the update from the alive counts, on the GPU
+		push.info.x = kPassPrepare;
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(ParticlePushConstants));
+		dispatcher->Dispatch(cmd, 1, 1, 1);
+		// Args to the indirect read, counts to the update: one batch, flushed by the dispatch
+		dispatcher->QueueBufferBarrier(cmd, m_ArgsBuffer->GetBuffer(), GetArgsBufferSize(),
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+			VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR);
+		dispatcher->QueueMemoryBarrier(cmd,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+
+		push.info.x = kPassUpdate;
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(ParticlePushConstants));
+		dispatcher->DispatchIndirect(cmd, m_ArgsBuffer->GetBuffer(), kDispatchArgsOffset);
+		dispatcher->ComputeToComputeGlobalBarrier(cmd);
+
+		// The render graph orders the draws after this
+		push.info.x = kPassFinalize;
+		dispatcher->PushConstants(cmd, m_PipelineLayout, &push, sizeof(ParticlePushConstants));
+		dispatcher->Dispatch(cmd, 1, 1, 1);
+	}
+
+	void ParticleSystem::SubmitDraw(DrawList& drawList, const glm::vec3& cameraPosition) const
+	{
+		if (!m_Ready) return;
+
+		// No vertex/index buffer — Particle.vert builds each billboard from
+		// gl_VertexIndex (6 verts per instance) and finds its particle in
+		// the emitter's current alive list
+		for (uint32_t i = 0; i < GetEmitterCount(); ++i)
+		{
+			const ParticleEmitterDesc& desc = m_Emitters[i];
+			const ParticleRange& range = m_Ranges[i];
+			if (range.capacity == 0) continue;
+
+			DrawCommand cmd;
+			cmd.pipeline = PipelineType::Particle;
+			cmd.vertexBuffer = nullptr;
+			cmd.indexBuffer = nullptr;
+			cmd.vertexCount = 6;
+			cmd.instanceCount = 0;
+			cmd.indirectBuffer = m_ArgsBuffer;
+			cmd.indirectOffset = i * sizeof(VkDrawIndirectCommand);
+			cmd.textureDescriptorSet = m_StorageDescriptorSet;
+
+			// Matches ParticleDraw in Particle.vert. The last column is the
+			// emitter's centre, which DrawSortKey sorts the emitters by.
+			cmd.hasPushConstants = true;
+			cmd.pushConstants.model[0] = desc.colorStart;
+			cmd.pushConstants.model[1] = desc.colorEnd;
+			cmd.pushConstants.model[2] = glm::vec4(desc.sizeEnd, std::max(desc.stretch, 0.0f),
+				desc.blend == ParticleBlend::Additive ? 1.0f : 0.0f, 0.0f);
+			cmd.pushConstants.model[3] = glm::vec4(GetParticleEmitterCenter(desc, cameraPosition), 1.0f);
+			cmd.pushConstants.customData = glm::vec4(static_cast<float>(i), static_cast<float>(range.base),
+				std::max(desc.fadeIn, 1e-3f), std::max(desc.fadeOut, 1e-3f));
+
+			drawList.AddCommand(cmd);
+		}
+	}
+
+	bool ParticleSystem::CreateComputePipeline()
+	{
+		VkDevice device = m_Renderer->GetVkDevice();
+
+		VkDescriptorSetLayout setLayouts[2] = {
+			m_DescriptorManager->GetParticleStorageSetLayout(),
+			m_DescriptorManager->GetParticleParamsSetLayout()
+		};
+
+		VkPushConstantRange pushRange{};
+		pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushRange.offset = 0;
+		pushRange.size = sizeof(ParticlePushConstants);
+
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 2;
+		layoutInfo.pSetLayouts = setLayouts;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushRange;
+
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
+		{
+			LOG_ERROR("ParticleSystem: failed to create compute pipeline layout");
+			return false;
+		}
+
+		const char* shaderFile = "ParticleSimulate.comp.spv";
+		auto& assetManager = AssetManager::Get();
+		auto shaderCode = assetManager.LoadShaderBinary(shaderFile);
+		if (!shaderCode.IsOpen())
+		{
+			LOG_ERROR("ParticleSystem: failed to load {}", shaderFile);
+			return false;
+		}
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = shaderCode.GetSize();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.GetData());
+
+		VkShaderModule shaderModule = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+		{
+			LOG_ERROR("ParticleSystem: failed to create shader module for {}", shaderFile);
+			return false;
+		}
+
+		VkPipelineShaderStageCreateInfo stageInfo{};
+		stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		stageInfo.module = shaderModule;
+		stageInfo.pName = "main";
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = stageInfo;
+		pipelineInfo.layout = m_PipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(device, m_Renderer->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+
+		vkDestroyShaderModule(device, shaderModule, nullptr);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("ParticleSystem: failed to create compute pipeline for {}", shaderFile);
+			m_Pipeline = VK_NULL_HANDLE;
+			return false;
+		}
+		VulkanDebugMarkers::SetName(device, m_Pipeline, shaderFile);
+
+		LOG_INFO("ParticleSystem: compute pipeline created ({})", shaderFile);
+		return true;
+	}
+
+} // namespace Nightbloom
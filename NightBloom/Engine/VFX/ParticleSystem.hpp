@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+// ParticleSystem.hpp
+//
+// Persistent GPU particles for any number of emitters (ParticleEmitter.hpp)
+// sharing one pool. Particles never come back to the CPU: each emitter owns
+// a slice of the pool, a dead list of its free slots and two alive lists
+// that swap every frame, with their counts in a small counter buffer. One
+// compute pipeline (ParticleSimulate.comp) runs the frame in passes:
+//   reset    - after the emitter list changes: every slot dead, no one alive
+//   emit     - pop this frame's spawns off the dead list, append to alive
+//   prepare  - size the update's indirect dispatch from the alive counts
+//   update   - age, integrate and collide the alive particles; survivors
+//              are appended to the other alive list, the rest pushed back
+//              onto the dead list (the compaction)
+//   finalize - swap the lists and write each emitter's VkDrawIndirectCommand
+// so neither the update nor the draws cost more than the live particles.
+// Each emitter is one draw of PipelineType::Particle (6-vertex billboards,
+// Particle.vert), reading its instance count from the GPU.
+//
+// Fireflies keep their own system: their flocking needs the neighbour grid
+// and a fixed swarm, not spawning and dying. Everything else - weather,
+// pollen, sparks - is an emitter here rather than a bespoke system.
+//
+// Runs on the graphics queue, a compute pass of the frame's render graph.
+//
+// Usage:
+//   ParticleSystem particles;
+//   particles.Initialize(renderer, poolCapacity);
+//   particles.AddEmitter(ParticleEmitterDesc::Rain());
+//   // Per frame, before the main render pass begins:
+//   particles.Dispatch(cmd, dispatcher, frameIndex, deltaTime, cameraPos);
+//   particles.SubmitDraw(drawList, cameraPos);
+//   particles.Shutdown();
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Renderer/DrawCommandSystem.hpp"
+#include "Engine/Renderer/FrameConfig.hpp"
+#include "Engine/Renderer/FrameUploadLayout.hpp"
+#include "Engine/VFX/ParticleEmitter.hpp"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Nightbloom
+{
+	class Renderer;
+	class ResourceManager;
+	class VulkanDescriptorManager;
+	class VulkanBuffer;
+	class ComputeDispatcher;
+
+	// 3x vec4 = 48 bytes, matches Particle in particle_sim.glsl
+	struct ParticleData
+	{
+		glm::vec3 position = glm::vec3(0.0f);
+		float     age = 0.0f;
+		glm::vec3 velocity = glm::vec3(0.0f);
+		float     lifetime = 0.0f;
+		float     size = 0.0f;
+		float     random = 0.0f;     // per-particle [0, 1), e.g. for spin
+		float     padding[2] = {};
+	};
+
+	class ParticleSystem
+	{
+	public:
+		// Emitters per system; one draw and one 128-byte record each
+		static constexpr uint32_t MAX_EMITTERS = 16;
+		static constexpr uint32_t INVALID_EMITTER = UINT32_MAX;
+
+		ParticleSystem() = default;
+		~ParticleSystem() = default;
+
+		ParticleSystem(const ParticleSystem&) = delete;
+		ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+		// poolCapacity particles shared by every emitter, allocated up front
+		bool Initialize(Renderer* renderer, uint32_t poolCapacity);
+		void Shutdown();
+
+		// Both restart every emitter (their pool slices move)
+		uint32_t AddEmitter(const ParticleEmitterDesc& desc);
+		void RemoveEmitter(uint32_t index);
+		// After editing an emitter's capacity in place
+		void RestartEmitters();
+
+		uint32_t GetEmitterCount() const { return static_cast<uint32_t>(m_Emitters.size()); }
+		// Live-tunable - the panel writes straight into these
+		ParticleEmitterDesc& GetEmitter(uint32_t index) { return m_Emitters[index]; }
+		const ParticleEmitterDesc& GetEmitter(uint32_t index) const { return m_Emitters[index]; }
+		// The slice the emitter was given (capacity may be less than asked for)
+		const ParticleRange& GetEmitterRange(uint32_t index) const { return m_Ranges[index]; }
+
+		// Uploads the emitters, then records the frame's passes (see above).
+		// The Renderer orders it against the draws.
+		void Dispatch(VkCommandBuffer cmd, ComputeDispatcher* dispatcher,
+			uint32_t frameIndex, float deltaTime, const glm::vec3& cameraPosition);
+
+		// One indirect draw per emitter with a slice
+		void SubmitDraw(DrawList& drawList, const glm::vec3& cameraPosition) const;
+
+		bool IsReady() const { return m_Ready; }
+		bool HasEmitters() const { return !m_Emitters.empty(); }
+
+		// The wind at the camera (Wind::Direction * Wind::Push), set by the
+		// Renderer each frame; each emitter scales it by its wind influence
+		void SetWind(const glm::vec2& wind) { m_Wind = wind; }
+
+		uint32_t GetPoolCapacity() const { return m_PoolCapacity; }
+
+		// For the Renderer's graph: written by Dispatch, read by the draws
+		VkBuffer GetParticleBuffer() const;
+		VkDeviceSize GetParticleBufferSize() const { return m_PoolCapacity * sizeof(ParticleData); }
+		VkBuffer GetAliveBuffer() const;
+		VkDeviceSize GetAliveBufferSize() const { return m_PoolCapacity * 2ull * sizeof(uint32_t); }
+		VkBuffer GetCounterBuffer() const;
+		VkDeviceSize GetCounterBufferSize() const { return MAX_EMITTERS * sizeof(glm::uvec4); }
+		VkBuffer GetArgsBuffer() const;
+		VkDeviceSize GetArgsBufferSize() const
+		{
+			return MAX_EMITTERS * sizeof(VkDrawIndirectCommand) + sizeof(VkDispatchIndirectCommand);
+		}
+
+	private:
+		bool CreateComputePipeline();
+
+		Renderer* m_Renderer = nullptr;
+		ResourceManager* m_Resources = nullptr;
+		VulkanDescriptorManager* m_DescriptorManager = nullptr;
+
+		// GPU-only, owned by ResourceManager's named buffer cache
+		VulkanBuffer* m_ParticleBuffer = nullptr;   // ParticleData per slot
+		VulkanBuffer* m_DeadBuffer = nullptr;       // free slots, per emitter slice
+		VulkanBuffer* m_AliveBuffer = nullptr;      // two lists: [0, N), [N, 2N)
+		VulkanBuffer* m_CounterBuffer = nullptr;    // per emitter: alive[2], dead, current list
+		VulkanBuffer* m_ArgsBuffer = nullptr;       // draw per emitter, then the update's dispatch
+		FrameUploadSlot m_EmitterSlot;              // ParticleEmitterGpu[MAX_EMITTERS], per frame in flight
+
+		VkDescriptorSet m_StorageDescriptorSet = VK_NULL_HANDLE;
+
+		// Owned directly, as FireflySystem's: sets = storage, emitters + the
+		// pass push constants
+		VkPipeline       m_Pipeline = VK_NULL_HANDLE;
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+
+		std::vector<ParticleEmitterDesc> m_Emitters;
+		std::vector<ParticleRange> m_Ranges;
+		std::vector<float> m_SpawnAccumulators;
+		bool m_ResetPending = true;
+
+		glm::vec2 m_Wind = glm::vec2(0.0f);
+		uint32_t m_PoolCapacity = 0;
+		uint32_t m_FrameCounter = 0;
+		float m_TotalTime = 0.0f;
+		bool m_Ready = false;
+	};
+
+} // namespace Nightbloom
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// Wind.hpp
+//
+// The scene's wind, evaluated analytically. WindField.comp bakes it every
+// frame into a small texture around the camera (Renderer's WindField, set 0
+// binding 2 of every scene pass) that grass and the water ripples sample
+// with one fetch; the fireflies, which may run on the async compute queue,
+// take Evaluate at their swarm's centre instead. WindField.comp is a
+// straight port of Evaluate - keep the two in sync.
+//
+// A sample holds the sway wave as a phasor, so a blade's own phase is a
+// rotation of the fetched value rather than a second evaluation:
+//   sway = amplitude * (cos theta, sin theta), theta = speed * t - frequency * along
+//   gust = gustStrength * a pulse behind fronts running downwind
+// "along" / "across" are world xz projected on the wind direction and its
+// perpendicular.
+//
+// The texture is toroidal: world cell c (texelSize metres square) lives in
+// texel c mod FIELD_RESOLUTION, so it is sampled with a repeating sampler at
+// uv = worldXZ / (texelSize * FIELD_RESOLUTION) and the camera moving only
+// changes which cells the texels hold.
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Nightbloom
+{
+	struct WindSettings
+	{
+		bool  enabled = true;
+		float directionDeg = 0.0f;  // heading in the xz plane; 0 = +X, 90 = +Z
+		float speed = 1.0f;         // sway, radians per second
+		float frequency = 0.3f;     // sway, radians per metre downwind
+
+		// Gust fronts: gustSpacing metres apart, moving downwind at gustSpeed;
+		// each pushes for gustWidth of the spacing behind the front
+		float gustStrength = 0.6f;
+		float gustSpeed = 8.0f;
+		float gustSpacing = 60.0f;
+		float gustWidth = 0.35f;
+
+		float texelSize = 4.0f;     // metres per field texel
+	};
+
+	struct WindSample
+	{
+		glm::vec2 sway = glm::vec2(0.0f);  // amplitude * (cos theta, sin theta)
+		float gust = 0.0f;
+	};
+
+	class Wind
+	{
+	public:
+		static constexpr uint32_t FIELD_RESOLUTION = 64;
+
+		static glm::vec2 Direction(const WindSettings& settings)
+		{
+			const float radians = glm::radians(settings.directionDeg);
+			return glm::vec2(std::cos(radians), std::sin(radians));
+		}
+
+		static WindSample Evaluate(const WindSettings& settings, const glm::vec2& worldXZ, float time)
+		{
+			WindSample sample;
+			if (!settings.enabled)
+				return sample;
+
+			const glm::vec2 direction = Direction(settings);
+			const float along = glm::dot(worldXZ, direction);
+			const float across = glm::dot(worldXZ, glm::vec2(-direction.y, direction.x));
+
+			// Slow amplitude drift so neighbouring rows don't sway in lockstep
+			const float theta = settings.speed * time - settings.frequency * along;
+			const float amplitude = 1.0f + 0.3f * std::sin(across * 0.07f + time * 0.13f) * std::sin(along * 0.05f - time * 0.21f);
+			sample.sway = amplitude * glm::vec2(std::cos(theta), std::sin(theta));
+
+			if (settings.gustStrength > 0.0f && settings.gustSpacing > 0.0f)
+			{
+				// Fronts bowed across the wind; behind grows from 0 to 1 as a
+				// front passes and the next one approaches
+				const float front = (along - settings.gustSpeed * time + 6.0f * std::sin(across * 0.045f)) / settings.gustSpacing;
+				const float behind = 1.0f - (front - std::floor(front));
+				const float width = std::max(settings.gustWidth, 0.1f);
+				sample.gust = settings.gustStrength * Smoothstep(0.0f, 0.08f, behind) * (1.0f - Smoothstep(0.08f, width, behind));
+			}
+			return sample;
+		}
+
+		// The sway at a blade whose phase is offset by `phase` radians: the
+		// imaginary part of the phasor rotated by it, in -amplitude..amplitude
+		static float Sway(const WindSample& sample, float phase)
+		{
+			return sample.sway.y * std::cos(phase) + sample.sway.x * std::sin(phase);
+		}
+
+		// Steady push downwind plus the gusts (1 in still gusts)
+		static float Push(const WindSample& sample)
+		{
+			return 1.0f + sample.gust;
+		}
+
+		// First world cell of the window centred on the camera
+		static glm::ivec2 FieldOrigin(const glm::vec2& cameraXZ, float texelSize)
+		{
+			const glm::vec2 cell = glm::floor(cameraXZ / texelSize);
+			return glm::ivec2(cell) - glm::ivec2(static_cast<int>(FIELD_RESOLUTION / 2));
+		}
+
+		// The world cell texel `texel` holds for a window starting at origin:
+		// the one in [origin, origin + FIELD_RESOLUTION) congruent to it
+		static glm::ivec2 TexelCell(const glm::ivec2& texel, const glm::ivec2& origin)
+		{
+			const int n = static_cast<int>(FIELD_RESOLUTION);
+			return origin + ((texel - origin) % n + n) % n;
+		}
+
+		// FrameUniformData::windField: xy = world min corner of the window,
+		// z = its side, w = 1 when the field is baked (0 = still air)
+		static glm::vec4 FieldWindow(const WindSettings& settings, const glm::vec2& cameraXZ)
+		{
+			if (!settings.enabled || settings.texelSize <= 0.0f)
+				return glm::vec4(0.0f);
+			const glm::ivec2 origin = FieldOrigin(cameraXZ, settings.texelSize);
+			return glm::vec4(glm::vec2(origin) * settings.texelSize,
+				settings.texelSize * static_cast<float>(FIELD_RESOLUTION), 1.0f);
+		}
+
+	private:
+		static float Smoothstep(float edge0, float edge1, float x)
+		{
+			const float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
+		}
+	};
+}
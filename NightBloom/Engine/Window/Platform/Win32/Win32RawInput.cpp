@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+// Win32RawInput.cpp
+//------------------------------------------------------------------------------
+
+#include "Engine/Window/Platform/Win32/Win32RawInput.hpp"
+#include "Engine/Input/InputSystem.hpp"
+#include "Core/Logger/Logger.hpp"
+#include "Core/ThreadPlacement.hpp"
+
+#include <chrono>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		constexpr const wchar_t* RAW_INPUT_CLASS = L"NightbloomRawInputClass";
+		constexpr USHORT HID_USAGE_PAGE_GENERIC = 0x01;
+		constexpr USHORT HID_USAGE_GENERIC_MOUSE = 0x02;
+	}
+
+	Win32RawInput::~Win32RawInput()
+	{
+		Stop();
+	}
+
+	bool Win32RawInput::Start(InputSystem* input, HWND focusWindow)
+	{
+		if (IsRunning() || !input)
+			return IsRunning();
+
+		m_Input = input;
+		m_FocusWindow = focusWindow;
+
+		// The thread reports whether the device registration worked
+		std::promise<bool> started;
+		std::future<bool> result = started.get_future();
+		m_Thread = std::thread([this, &started]()
+		{
+			ThreadPlacement::Apply(ThreadRole::FrameCritical);
+			ThreadMain(started);
+		});
+
+		if (!result.get())
+		{
+			m_Thread.join();
+			LOG_WARN("Raw mouse input unavailable; camera look uses cursor deltas");
+			return false;
+		}
+
+		LOG_INFO("Raw mouse input thread started");
+		return true;
+	}
+
+	void Win32RawInput::Stop()
+	{
+		if (!IsRunning())
+			return;
+
+		if (HWND hwnd = m_MessageWindow.load())
+			PostMessageW(hwnd, WM_CLOSE, 0, 0);
+		m_Thread.join();
+		m_Input = nullptr;
+	}
+
+	void Win32RawInput::ThreadMain(std::promise<bool>& started)
+	{
+		// Mostly asleep in GetMessage; when a report arrives it should be
+		// stamped now, not after the scheduler gets round to it
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+
+		HINSTANCE instance = GetModuleHandleW(nullptr);
+		WNDCLASSEXW windowClass = {};
+		windowClass.cbSize = sizeof(windowClass);
+		windowClass.lpfnWndProc = &Win32RawInput::WindowProc;
+		windowClass.hInstance = instance;
+		windowClass.lpszClassName = RAW_INPUT_CLASS;
+		RegisterClassExW(&windowClass);
+
+		HWND hwnd = CreateWindowExW(0, RAW_INPUT_CLASS, L"", 0, 0, 0, 0, 0,
+			HWND_MESSAGE, nullptr, instance, this);
+		if (!hwnd)
+		{
+			UnregisterClassW(RAW_INPUT_CLASS, instance);
+			started.set_value(false);
+			return;
+		}
+
+		// INPUTSINK: a message-only window is never foreground, so without
+		// it no reports arrive. Focus is checked per report instead.
+		RAWINPUTDEVICE device = {};
+		device.usUsagePage = HID_USAGE_PAGE_GENERIC;
+		device.usUsage = HID_USAGE_GENERIC_MOUSE;
+		device.dwFlags = RIDEV_INPUTSINK;
+		device.hwndTarget = hwnd;
+		if (!RegisterRawInputDevices(&device, 1, sizeof(device)))
+		{
+			DestroyWindow(hwnd);
+			UnregisterClassW(RAW_INPUT_CLASS, instance);
+			started.set_value(false);
+			return;
+		}
+
+		m_MessageWindow.store(hwnd);
+		m_Input->SetRawMouseActive(true);
+		started.set_value(true);
+
+		MSG message;
+		while (GetMessageW(&message, nullptr, 0, 0) > 0)
+		{
+			DispatchMessageW(&message);
+		}
+
+		m_Input->SetRawMouseActive(false);
+
+		device.dwFlags = RIDEV_REMOVE;
+		device.hwndTarget = nullptr;
+		RegisterRawInputDevices(&device, 1, sizeof(device));
+		UnregisterClassW(RAW_INPUT_CLASS, instance);
+	}
+
+	void Win32RawInput::HandleInput(HRAWINPUT handle)
+	{
+		const auto timestamp = std::chrono::steady_clock::now();
+
+		RAWINPUT raw;
+		UINT size = sizeof(raw);
+		if (GetRawInputData(handle, RID_INPUT, &raw, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1))
+			return;
+		if (raw.header.dwType != RIM_TYPEMOUSE)
+			return;
+
+		// Tablets and remote desktop report absolute positions; the cursor
+		// path already covers those
+		const RAWMOUSE& mouse = raw.data.mouse;
+		if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) || (mouse.lLastX == 0 && mouse.lLastY == 0))
+			return;
+
+		if (GetForegroundWindow() != m_FocusWindow)
+			return;
+
+		m_Input->PushRawMouseMotion(static_cast<int>(mouse.lLastX), static_cast<int>(mouse.lLastY), timestamp);
+	}
+
+	LRESULT CALLBACK Win32RawInput::WindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
+	{
+		if (message == WM_NCCREATE)
+		{
+			const CREATESTRUCTW* create = reinterpret_cast<const CREATESTRUCTW*>(lParam);
+			SetWindowLongPtrW(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create->lpCreateParams));
+		}
+
+		Win32RawInput* self = reinterpret_cast<Win32RawInput*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+		switch (message)
+		{
+		case WM_INPUT:
+			if (self)
+				self->HandleInput(reinterpret_cast<HRAWINPUT>(lParam));
+			break;  // DefWindowProc releases the report
+
+		case WM_CLOSE:
+			DestroyWindow(hwnd);
+			return 0;
+
+		case WM_DESTROY:
+			if (self)
+				self->m_MessageWindow.store(nullptr);
+			PostQuitMessage(0);
+			return 0;
+		}
+
+		return DefWindowProcW(hwnd, message, wParam, lParam);
+	}
+}
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// Win32RawInput.hpp
+//
+// High-rate mouse path. A dedicated thread owns a message-only window
+// registered for raw mouse input and turns each WM_INPUT report into a
+// timestamped relative-motion event on the InputSystem's lock-free ring.
+// A 1-8 kHz mouse then never waits behind the main thread's frame (the
+// reports would otherwise pile up in its queue until the next pump), and
+// the game thread integrates every sub-frame report instead of sampling
+// the cursor once per frame.
+//
+// Only motion goes this way. Buttons, keys and the cursor position stay on
+// the main window's message pump, where ImGui and focus handling need them;
+// legacy mouse messages are left on so both paths see the same mouse.
+//------------------------------------------------------------------------------
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace Nightbloom
+{
+	class InputSystem;
+
+	class Win32RawInput
+	{
+	public:
+		Win32RawInput() = default;
+		~Win32RawInput();
+
+		// Starts the thread feeding `input`. Reports are only forwarded while
+		// `focusWindow` is the foreground window.
+		bool Start(InputSystem* input, HWND focusWindow);
+		void Stop();
+
+		bool IsRunning() const { return m_Thread.joinable(); }
+
+	private:
+		void ThreadMain(std::promise<bool>& started);
+		void HandleInput(HRAWINPUT handle);
+		static LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
+
+		InputSystem* m_Input = nullptr;
+		HWND m_FocusWindow = nullptr;
+		std::thread m_Thread;
+		std::atomic<HWND> m_MessageWindow{ nullptr };
+
+		Win32RawInput(const Win32RawInput&) = delete;
+		Win32RawInput& operator=(const Win32RawInput&) = delete;
+	};
+}
@@ -8,6 +8,7 @@
 #include "Engine/Window/Platform/Win32/Win32Window.hpp"
 #include "Engine/Input/InputSystem.hpp" 
 #include "Core/Logger/Logger.hpp"
+#include "Core/ThreadPlacement.hpp"
 //#include "Core/Assert.hpp"  // For GUARANTEE_OR_DIE
 #include <windowsx.h>
 
@@ -20,15 +21,48 @@ namespace Nightbloom
 {
 	Win32Window* Win32Window::s_MainWindow = nullptr;
 
-	// Windows message handling procedure
-	LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessageCode, WPARAM wParam, LPARAM lParam)
+	namespace
 	{
-		// ImGui handling (if you're using ImGui)
-#ifdef IMGUI_VERSION
-		if (ImGui_ImplWin32_WndProcHandler(windowHandle, wmMessageCode, wParam, lParam))
-			return true;
-#endif
+		// Engine -> window thread: tear the window down on its own thread
+		constexpr UINT WM_NIGHTBLOOM_DESTROY = WM_APP + 1;
+		// Retries forwarding when the engine thread fell behind
+		constexpr UINT_PTR BACKLOG_TIMER_ID = 1;
+
+		bool IsEngineMessage(UINT message)
+		{
+			switch (message)
+			{
+			case WM_CLOSE:
+			case WM_SIZE:
+			case WM_SETFOCUS:
+			case WM_KILLFOCUS:
+			case WM_KEYDOWN:
+			case WM_KEYUP:
+			case WM_SYSKEYDOWN:
+			case WM_SYSKEYUP:
+			case WM_CHAR:
+			case WM_INPUTLANGCHANGE:
+			case WM_DEVICECHANGE:
+			case WM_MOUSEMOVE:
+			case WM_MOUSELEAVE:
+			case WM_MOUSEWHEEL:
+			case WM_MOUSEHWHEEL:
+			case WM_LBUTTONDOWN: case WM_LBUTTONDBLCLK: case WM_LBUTTONUP:
+			case WM_RBUTTONDOWN: case WM_RBUTTONDBLCLK: case WM_RBUTTONUP:
+			case WM_MBUTTONDOWN: case WM_MBUTTONDBLCLK: case WM_MBUTTONUP:
+			case WM_XBUTTONDOWN: case WM_XBUTTONDBLCLK: case WM_XBUTTONUP:
+				return true;
+			default:
+				return false;
+			}
+		}
+	}
 
+	// Windows message handling procedure. Runs on the window thread: it
+	// forwards what the engine needs and otherwise lets DefWindowProc (and
+	// its modal move/size loops) run without touching engine state.
+	LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessageCode, WPARAM wParam, LPARAM lParam)
+	{
 		// Get the window instance
 		Win32Window* window = Win32Window::GetMainWindowInstance();
 		if (!window)
@@ -36,35 +70,175 @@ namespace Nightbloom
 			return DefWindowProc(windowHandle, wmMessageCode, wParam, lParam);
 		}
 
-		InputSystem* input = window->GetInputSystem();
+		return window->HandleWindowThreadMessage(windowHandle, wmMessageCode, wParam, lParam);
+	}
+
+	LRESULT Win32Window::HandleWindowThreadMessage(HWND windowHandle, UINT wmMessageCode, WPARAM wParam, LPARAM lParam)
+	{
+		// Messages sent during CreateWindowEx arrive before it returns
+		if (!m_Hwnd)
+			m_Hwnd = windowHandle;
 
 		switch (wmMessageCode)
 		{
 		case WM_CLOSE:
-		{
-			window->m_ShuttingDown = true;
-			if (window->m_CloseCallback)
-				window->m_CloseCallback();
+			// The engine decides; the window stays until the engine destroys it
+			PostToEngine(wmMessageCode, wParam, lParam);
+			return 0;
+
+		case WM_NIGHTBLOOM_DESTROY:
+			if (m_DisplayContext)
+			{
+				ReleaseDC(windowHandle, m_DisplayContext);
+				m_DisplayContext = nullptr;
+			}
+			DestroyWindow(windowHandle);
+			return 0;
+
+		case WM_DESTROY:
+			PostQuitMessage(0);
+			return 0;
+
+		case WM_TIMER:
+			if (wParam == BACKLOG_TIMER_ID)
+			{
+				FlushBacklog();
+				return 0;
+			}
+			break;
+
+		case WM_SETCURSOR:
+			// The client-area cursor belongs to ImGui on the engine thread;
+			// replaying this there restores it, DefWindowProc would reset it
+			if (LOWORD(lParam) == HTCLIENT)
+			{
+				PostToEngine(wmMessageCode, wParam, lParam);
+				return TRUE;
+			}
+			break;
+
+		// Capture and leave tracking only work from the thread that owns
+		// the window, so they're done here rather than on replay
+		case WM_LBUTTONDOWN: case WM_RBUTTONDOWN: case WM_MBUTTONDOWN: case WM_XBUTTONDOWN:
+			SetCapture(windowHandle);
+			PostToEngine(wmMessageCode, wParam, lParam);
+			return wmMessageCode == WM_XBUTTONDOWN ? TRUE : 0;  // Must return TRUE for X buttons
+
+		case WM_LBUTTONUP: case WM_RBUTTONUP: case WM_MBUTTONUP: case WM_XBUTTONUP:
+			if ((wParam & (MK_LBUTTON | MK_RBUTTON | MK_MBUTTON | MK_XBUTTON1 | MK_XBUTTON2)) == 0)
+				ReleaseCapture();
+			PostToEngine(wmMessageCode, wParam, lParam);
+			return wmMessageCode == WM_XBUTTONUP ? TRUE : 0;
+
+		case WM_MOUSEMOVE:
+			if (!m_TrackingMouseLeave)
+			{
+				TRACKMOUSEEVENT track = { sizeof(track), TME_LEAVE, windowHandle, 0 };
+				m_TrackingMouseLeave = TrackMouseEvent(&track) != FALSE;
+			}
+			PostToEngine(wmMessageCode, wParam, lParam);
+			return 0;
+
+		case WM_MOUSELEAVE:
+			m_TrackingMouseLeave = false;
+			PostToEngine(wmMessageCode, wParam, lParam);
 			return 0;
+
+		default:
+			if (IsEngineMessage(wmMessageCode))
+			{
+				PostToEngine(wmMessageCode, wParam, lParam);
+				// Input language and device changes still need their default handling
+				if (wmMessageCode != WM_INPUTLANGCHANGE && wmMessageCode != WM_DEVICECHANGE)
+					return 0;
+			}
+			break;
+		}
+
+		return DefWindowProc(windowHandle, wmMessageCode, wParam, lParam);
+	}
+
+	void Win32Window::PostToEngine(UINT message, WPARAM wParam, LPARAM lParam)
+	{
+		const Win32WindowMessage forwarded{ message, wParam, lParam, std::chrono::steady_clock::now() };
+
+		FlushBacklog();
+		if (m_Backlog.empty() && m_Messages.TryPush(forwarded))
+			return;
+
+		// The engine thread is behind (a long frame, a hitch): keep the
+		// message in order behind the rest, merging cursor moves since only
+		// the latest position matters, and retry from a timer that also runs
+		// inside modal loops
+		if (message == WM_MOUSEMOVE && !m_Backlog.empty() && m_Backlog.back().message == WM_MOUSEMOVE)
+			m_Backlog.back() = forwarded;
+		else
+			m_Backlog.push_back(forwarded);
+
+		if (!m_BacklogTimerActive && m_Hwnd)
+			m_BacklogTimerActive = SetTimer(m_Hwnd, BACKLOG_TIMER_ID, 1, nullptr) != 0;
+	}
+
+	void Win32Window::FlushBacklog()
+	{
+		size_t flushed = 0;
+		while (flushed < m_Backlog.size() && m_Messages.TryPush(m_Backlog[flushed]))
+			++flushed;
+		m_Backlog.erase(m_Backlog.begin(), m_Backlog.begin() + flushed);
+
+		if (m_Backlog.empty() && m_BacklogTimerActive)
+		{
+			KillTimer(m_Hwnd, BACKLOG_TIMER_ID);
+			m_BacklogTimerActive = false;
+		}
+	}
+
+	// Engine-thread half: a forwarded message, in the order it arrived
+	void Win32Window::DispatchEngineMessage(const Win32WindowMessage& message)
+	{
+		const UINT wmMessageCode = message.message;
+		const WPARAM wParam = message.wParam;
+		const LPARAM lParam = message.lParam;
+
+		// ImGui handling (if you're using ImGui). Shares the window thread's
+		// input state (AttachThreadInput) for key and capture queries.
+#ifdef IMGUI_VERSION
+		if (ImGui_ImplWin32_WndProcHandler(m_Hwnd, wmMessageCode, wParam, lParam))
+			return;
+#endif
+
+
+		InputSystem* input = GetInputSystem();
+		if (input)
+			input->SetEventTimestamp(message.time);
+
+		switch (wmMessageCode)
+		{
+		case WM_CLOSE:
+		{
+			m_ShuttingDown = true;
+			if (m_CloseCallback)
+				m_CloseCallback();
+			return;
 		}
 
 		case WM_SIZE:
 		{
 			UINT width = LOWORD(lParam);
 			UINT height = HIWORD(lParam);
-			window->m_ClientDimensionsX = width;
-			window->m_ClientDimensionsY = height;
+			m_ClientDimensionsX = width;
+			m_ClientDimensionsY = height;
 
-			if (window->m_ResizeCallback)
-				window->m_ResizeCallback(width, height);
-			return 0;
+			if (m_ResizeCallback)
+				m_ResizeCallback(width, height);
+			return;
 		}
 
 		case WM_SETFOCUS:
 		{
-			if (window->m_FocusCallback)
-				window->m_FocusCallback(true);
-			return 0;
+			if (m_FocusCallback)
+				m_FocusCallback(true);
+			return;
 		}
 
 		case WM_KILLFOCUS:
@@ -73,9 +247,9 @@ namespace Nightbloom
 			if (input)
 				input->ClearState();
 
-			if (window->m_FocusCallback)
-				window->m_FocusCallback(false);
-			return 0;
+			if (m_FocusCallback)
+				m_FocusCallback(false);
+			return;
 		}
 
 		case WM_KEYDOWN:
@@ -91,7 +265,7 @@ namespace Nightbloom
 				// Fallback logging if no input system
 				LOG_TRACE("Key pressed: {}", wParam);
 			}
-			return 0;
+			return;
 		}
 
 		case WM_KEYUP:
@@ -100,7 +274,7 @@ namespace Nightbloom
 				input->OnKeyUp(static_cast<unsigned int>(wParam));
 			else
 				LOG_TRACE("Key released: {}", wParam);
-			return 0;
+			return;
 		}
 
 		case WM_SYSKEYDOWN:  // Handle Alt+ combinations
@@ -110,14 +284,14 @@ namespace Nightbloom
 			{
 				input->OnKeyDown(static_cast<unsigned int>(wParam));
 			}
-			return 0;
+			return;
 		}
 
 		case WM_SYSKEYUP:
 		{
 			if (input)
 				input->OnKeyUp(static_cast<unsigned int>(wParam));
-			return 0;
+			return;
 		}
 
 		case WM_CHAR:
@@ -126,7 +300,7 @@ namespace Nightbloom
 				input->OnChar(static_cast<unsigned int>(wParam));
 			else
 				LOG_TRACE("Character input: {}", (char)wParam);
-			return 0;
+			return;
 		}
 
 		case WM_LBUTTONDOWN:
@@ -134,13 +308,12 @@ namespace Nightbloom
 			if (input)
 			{
 				input->OnMouseButtonDown(0);  // 0 = left button
-				SetCapture(windowHandle);  // Capture mouse even if it leaves window
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: Left Down");
 			}
-			return 0;
+			return;
 		}
 
 		case WM_LBUTTONUP:
@@ -148,13 +321,12 @@ namespace Nightbloom
 			if (input)
 			{
 				input->OnMouseButtonUp(0);  // 0 = left button
-				ReleaseCapture();
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: Left Up");
 			}
-			return 0;
+			return;
 		}
 
 		case WM_RBUTTONDOWN:
@@ -162,13 +334,12 @@ namespace Nightbloom
 			if (input)
 			{
 				input->OnMouseButtonDown(1);  // 1 = right button
-				SetCapture(windowHandle);
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: Right Down");
 			}
-			return 0;
+			return;
 		}
 
 		case WM_RBUTTONUP:
@@ -176,13 +347,12 @@ namespace Nightbloom
 			if (input)
 			{
 				input->OnMouseButtonUp(1);  // 1 = right button
-				ReleaseCapture();
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: Right Up");
 			}
-			return 0;
+			return;
 		}
 
 		case WM_MBUTTONDOWN:
@@ -190,13 +360,12 @@ namespace Nightbloom
 			if (input)
 			{
 				input->OnMouseButtonDown(2);  // 2 = middle button
-				SetCapture(windowHandle);
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: Middle Down");
 			}
-			return 0;
+			return;
 		}
 
 		case WM_MBUTTONUP:
@@ -204,13 +373,12 @@ namespace Nightbloom
 			if (input)
 			{
 				input->OnMouseButtonUp(2);  // 2 = middle button
-				ReleaseCapture();
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: Middle Up");
 			}
-			return 0;
+			return;
 		}
 
 		case WM_XBUTTONDOWN:
@@ -222,13 +390,12 @@ namespace Nightbloom
 					input->OnMouseButtonDown(3);  // 3 = X1
 				else if (button == XBUTTON2)
 					input->OnMouseButtonDown(4);  // 4 = X2
-				SetCapture(windowHandle);
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: X{} Down", button);
 			}
-			return TRUE;  // Must return TRUE for X buttons
+			return;
 		}
 
 		case WM_XBUTTONUP:
@@ -240,13 +407,12 @@ namespace Nightbloom
 					input->OnMouseButtonUp(3);  // 3 = X1
 				else if (button == XBUTTON2)
 					input->OnMouseButtonUp(4);  // 4 = X2
-				ReleaseCapture();
 			}
 			else
 			{
 				LOG_TRACE("Mouse button event: X{} Up", button);
 			}
-			return TRUE;  // Must return TRUE for X buttons
+			return;
 		}
 
 
@@ -262,7 +428,7 @@ namespace Nightbloom
 			{
 				LOG_TRACE("Mouse wheel: {}", wheelDelta);
 			}
-			return 0;
+			return;
 		}
 
 		case WM_MOUSEMOVE:
@@ -278,11 +444,9 @@ namespace Nightbloom
 			// {
 			//     LOG_TRACE("Mouse move: ({}, {})", x, y);
 			// }
-			return 0;
+			return;
 		}
 		}
-
-		return DefWindowProc(windowHandle, wmMessageCode, wParam, lParam);
 	}
 
 	Win32Window::Win32Window(const WindowDesc& desc)
@@ -297,29 +461,76 @@ namespace Nightbloom
 		, m_InputSystem(nullptr)  // Initialize the input system pointer
 	{
 		s_MainWindow = this;
-		CreateOSWindow(desc);
+
+		// The window lives on its own thread so that moving, resizing and
+		// other modal loops inside DefWindowProc never stall the engine
+		// thread, and input keeps being received through long frames
+		std::promise<bool> created;
+		std::future<bool> result = created.get_future();
+		m_WindowThread = std::thread([this, desc, &created]()
+		{
+			ThreadPlacement::Apply(ThreadRole::FrameCritical);
+			WindowThreadMain(desc, created);
+		});
+
+		if (!result.get())
+		{
+			m_WindowThread.join();
+			m_IsOpen = false;
+			return;
+		}
+
+		// Share key state, focus, capture and cursor with the window thread,
+		// so ImGui's GetKeyState/SetCursor calls on replay see its input
+		m_InputThreadsAttached = AttachThreadInput(GetCurrentThreadId(),
+			GetWindowThreadProcessId(m_Hwnd, nullptr), TRUE) != FALSE;
 	}
 
 	Win32Window::~Win32Window()
 	{
+		m_RawInput.Stop();
 		m_InputSystem = nullptr;
 
-		if (m_DisplayContext)
+		if (m_WindowThread.joinable())
 		{
-			ReleaseDC(m_Hwnd, m_DisplayContext);
+			if (m_InputThreadsAttached)
+			{
+				AttachThreadInput(GetCurrentThreadId(), GetWindowThreadProcessId(m_Hwnd, nullptr), FALSE);
+				m_InputThreadsAttached = false;
+			}
+			PostMessage(m_Hwnd, WM_NIGHTBLOOM_DESTROY, 0, 0);
+			m_WindowThread.join();
 		}
 
-		if (m_Hwnd)
+		if (s_MainWindow == this)
 		{
-			DestroyWindow(m_Hwnd);
+			s_MainWindow = nullptr;
 		}
+	}
 
-		UnregisterClass(TEXT("NightbloomWindowClass"), m_Instance);
+	void Win32Window::SetInputSystem(InputSystem* inputSystem)
+	{
+		m_RawInput.Stop();
+		Window::SetInputSystem(inputSystem);
+		if (inputSystem && m_Hwnd)
+			m_RawInput.Start(inputSystem, m_Hwnd);
+	}
 
-		if (s_MainWindow == this)
+	void Win32Window::WindowThreadMain(const WindowDesc& desc, std::promise<bool>& created)
+	{
+		CreateOSWindow(desc);
+		created.set_value(m_Hwnd != nullptr);
+		if (!m_Hwnd)
+			return;
+
+		MSG queuedMessage;
+		while (GetMessage(&queuedMessage, nullptr, 0, 0) > 0)
 		{
-			s_MainWindow = nullptr;
+			TranslateMessage(&queuedMessage);
+			DispatchMessage(&queuedMessage);
 		}
+
+		UnregisterClass(TEXT("NightbloomWindowClass"), m_Instance);
 	}
 
 	void Win32Window::CreateOSWindow(const WindowDesc& desc)
@@ -409,9 +620,12 @@ namespace Nightbloom
 		}
 
 		// Show and update window
-		ShowWindow(m_Hwnd, desc.maximized ? SW_MAXIMIZE : SW_SHOW);
-		SetForegroundWindow(m_Hwnd);
-		SetFocus(m_Hwnd);
+		if (desc.visible)
+		{
+			ShowWindow(m_Hwnd, desc.maximized ? SW_MAXIMIZE : SW_SHOW);
+			SetForegroundWindow(m_Hwnd);
+			SetFocus(m_Hwnd);
+		}
 		UpdateWindow(m_Hwnd);
 
 		// Get display context
@@ -429,6 +643,16 @@ namespace Nightbloom
 
 	void Win32Window::PollEvents()
 	{
+		// Everything the window thread forwarded since the last frame
+		Win32WindowMessage message;
+		while (m_Messages.TryPop(message))
+		{
+			DispatchEngineMessage(message);
+		}
+		if (InputSystem* input = GetInputSystem())
+			input->SetEventTimestamp({});
+
+		// Windows this thread created itself (ImGui's secondary viewports)
 		RunMessagePump();
 	}
 
@@ -479,7 +703,7 @@ namespace Nightbloom
 
 	void Win32Window::SetPosition(int x, int y)
 	{
-		SetWindowPos(m_Hwnd, nullptr, x, y, 0, 0, SWP_NOSIZE | SWP_NOZORDER);
+		SetWindowPos(m_Hwnd, nullptr, x, y, 0, 0, SWP_NOSIZE | SWP_NOZORDER | SWP_ASYNCWINDOWPOS);
 	}
 
 	void Win32Window::SetSize(int width, int height)
@@ -489,17 +713,17 @@ namespace Nightbloom
 		SetWindowPos(m_Hwnd, nullptr, 0, 0,
 			rect.right - rect.left,
 			rect.bottom - rect.top,
-			SWP_NOMOVE | SWP_NOZORDER);
+			SWP_NOMOVE | SWP_NOZORDER | SWP_ASYNCWINDOWPOS);
 	}
 
 	void Win32Window::Show()
 	{
-		ShowWindow(m_Hwnd, SW_SHOW);
+		ShowWindowAsync(m_Hwnd, SW_SHOW);
 	}
 
 	void Win32Window::Hide()
 	{
-		ShowWindow(m_Hwnd, SW_HIDE);
+		ShowWindowAsync(m_Hwnd, SW_HIDE);
 	}
 
 	void Win32Window::Focus()
@@ -510,17 +734,17 @@ namespace Nightbloom
 
 	void Win32Window::Maximize()
 	{
-		ShowWindow(m_Hwnd, SW_MAXIMIZE);
+		ShowWindowAsync(m_Hwnd, SW_MAXIMIZE);
 	}
 
 	void Win32Window::Minimize()
 	{
-		ShowWindow(m_Hwnd, SW_MINIMIZE);
+		ShowWindowAsync(m_Hwnd, SW_MINIMIZE);
 	}
 
 	void Win32Window::Restore()
 	{
-		ShowWindow(m_Hwnd, SW_RESTORE);
+		ShowWindowAsync(m_Hwnd, SW_RESTORE);
 	}
 
 	//std::pair<int, int> Win32Window::GetNormalizedCursorPosition() const
@@ -541,6 +765,24 @@ namespace Nightbloom
 	{
 		return static_cast<float>(m_ClientDimensionsX) / static_cast<float>(m_ClientDimensionsY);
 	}
+
+	float Win32Window::GetRefreshRate() const
+	{
+		// The monitor holding most of the window, as it is set up right now
+		MONITORINFOEXW monitorInfo{};
+		monitorInfo.cbSize = sizeof(monitorInfo);
+		HMONITOR monitor = MonitorFromWindow(m_Hwnd, MONITOR_DEFAULTTONEAREST);
+		if (!monitor || !GetMonitorInfoW(monitor, &monitorInfo))
+			return 0.0f;
+
+		DEVMODEW mode{};
+		mode.dmSize = sizeof(mode);
+		if (!EnumDisplaySettingsW(monitorInfo.szDevice, ENUM_CURRENT_SETTINGS, &mode))
+			return 0.0f;
+
+		// 0 and 1 mean "hardware default"
+		return mode.dmDisplayFrequency > 1 ? static_cast<float>(mode.dmDisplayFrequency) : 0.0f;
+	}
 }
 
 // Global helper function
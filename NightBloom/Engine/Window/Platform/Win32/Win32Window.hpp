@@ -1,12 +1,16 @@
 //------------------------------------------------------------------------------
 // Win32Window.hpp
 //
-// Windows platform window implementation
+// Windows platform window implementation. The window is created and pumped
+// on a dedicated thread; the messages the engine cares about (input, size,
+// focus, close) cross to the engine thread through a lock-free ring and are
+// handled there in PollEvents, so neither thread ever waits on the other.
 // Copyright (c) 2024 Your Name. All rights reserved.
 //------------------------------------------------------------------------------
 #pragma once
 
 #include "Engine/Window/Window.hpp"
+#include "Engine/Window/Platform/Win32/Win32RawInput.hpp"
 // #include "Math/IntVec2.hpp"
 
 #ifndef WIN32_LEAN_AND_MEAN
@@ -14,9 +18,22 @@
 #endif
 #include <windows.h>
 
+#include "Core/SpscRing.hpp"
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
 namespace Nightbloom
 {
-
+	// A message the window thread received, replayed on the engine thread
+	struct Win32WindowMessage
+	{
+		UINT message = 0;
+		WPARAM wParam = 0;
+		LPARAM lParam = 0;
+		std::chrono::steady_clock::time_point time{};
+	};
 
 	class Win32Window : public Window
 	{
@@ -33,6 +50,9 @@ namespace Nightbloom
 		int GetHeight() const override { return m_ClientDimensionsY; }
 		void SetTitle(const std::string& title) override;
 		void SetVSync(bool enabled) override { m_VSync = enabled; }
+		float GetRefreshRate() const override;
+		// Also (re)starts the raw mouse thread feeding the new input system
+		void SetInputSystem(InputSystem* inputSystem) override;
 
 		void SetPosition(int x, int y) override;
 		void SetSize(int width, int height) override;
@@ -55,7 +75,15 @@ namespace Nightbloom
 		static Win32Window* GetMainWindowInstance() { return s_MainWindow; }
 
 	private:
+		// Window thread: creates the window and pumps its messages
+		void WindowThreadMain(const WindowDesc& desc, std::promise<bool>& created);
 		void CreateOSWindow(const WindowDesc& desc);
+		LRESULT HandleWindowThreadMessage(HWND windowHandle, UINT wmMessageCode, WPARAM wParam, LPARAM lParam);
+		void PostToEngine(UINT message, WPARAM wParam, LPARAM lParam);
+		void FlushBacklog();
+
+		// Engine thread: replays forwarded messages, pumps its own windows
+		void DispatchEngineMessage(const Win32WindowMessage& message);
 		void RunMessagePump();
 
 		// Friend function for Windows message handling
@@ -71,6 +99,18 @@ namespace Nightbloom
 		int m_ClientDimensionsX, m_ClientDimensionsY;
 		std::string m_Title;
 
+		Win32RawInput m_RawInput;
+
+		// Window thread -> engine thread hand-off. The backlog and the
+		// tracking flags are only touched by the window thread.
+		static constexpr size_t MESSAGE_RING_CAPACITY = 4096;
+		std::thread m_WindowThread;
+		SpscRing<Win32WindowMessage> m_Messages{ MESSAGE_RING_CAPACITY };
+		std::vector<Win32WindowMessage> m_Backlog;
+		bool m_BacklogTimerActive = false;
+		bool m_TrackingMouseLeave = false;
+		bool m_InputThreadsAttached = false;
+
 		static Win32Window* s_MainWindow;
 		InputSystem* m_InputSystem = nullptr; // Pointer to the input system for handling input events
 	};
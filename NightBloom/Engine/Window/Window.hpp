@@ -36,6 +36,8 @@ namespace Nightbloom
 		virtual int GetHeight() const = 0;
 		virtual void SetTitle(const std::string& title) = 0;
 		virtual void SetVSync(bool enabled) = 0;
+		// Refresh rate of the display the window is on, in Hz (0 = unknown)
+		virtual float GetRefreshRate() const { return 0.0f; }
 
 		//Window manipulation
 		virtual void SetPosition(int x, int y) = 0;
@@ -21,5 +21,6 @@ namespace Nightbloom
 		bool resizable = true;
 		bool vsync = false;
 		bool maximized = false;
+		bool visible = true;    // false: created hidden (offscreen runs such as NightbloomBench)
 	};
 }
\ No newline at end of file
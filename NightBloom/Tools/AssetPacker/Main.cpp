@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// Main.cpp
+//
+// AssetPacker - packs a project's assets and compiled shaders into one
+// archive (see Engine/Core/AssetArchive.hpp) that AssetManager mounts at
+// startup.
+//
+//   AssetPacker [--shaders <dir>] [--output <file>] <root>
+//
+// Everything under <root>/Assets goes in as "Assets/...", and the .spv files
+// in the shader directory as "Shaders/<name>". Cooked .ktx2 files older than
+// their source are left out, as the runtime would ignore them. The archive
+// defaults to <root>/Assets.nbpak.
+//------------------------------------------------------------------------------
+
+#include "Engine/Core/AssetArchive.hpp"
+#include "Engine/Renderer/AssetManager.hpp"
+#include "Engine/Renderer/TextureCooker.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	void PrintUsage()
+	{
+		std::printf("Usage:\n"
+			"  AssetPacker [--shaders <dir>] [--output <file>] <root>\n");
+	}
+
+	// Source image a cooked .ktx2 was made from, if it is still there
+	fs::path FindCookedSource(const fs::path& cooked)
+	{
+		for (const char* ext : { ".png", ".jpg", ".jpeg", ".tga", ".bmp" })
+		{
+			fs::path source = cooked;
+			source.replace_extension(ext);
+			if (fs::exists(source))
+				return source;
+		}
+		return {};
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string root, shaders, output;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--shaders" && i + 1 < argc)
+			shaders = argv[++i];
+		else if (arg == "--output" && i + 1 < argc)
+			output = argv[++i];
+		else if (root.empty())
+			root = arg;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (root.empty() || !fs::is_directory(root))
+	{
+		PrintUsage();
+		return 1;
+	}
+	if (output.empty())
+		output = (fs::path(root) / Nightbloom::AssetManager::ARCHIVE_FILE_NAME).string();
+
+	Nightbloom::AssetArchiveWriter writer;
+	uint32_t failed = 0, stale = 0;
+
+	const fs::path assets = fs::path(root) / "Assets";
+	if (fs::is_directory(assets))
+	{
+		for (const auto& entry : fs::recursive_directory_iterator(assets))
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			const fs::path& path = entry.path();
+			if (path.extension() == ".ktx2")
+			{
+				const fs::path source = FindCookedSource(path);
+				if (!source.empty() && !Nightbloom::IsCookedTextureCurrent(source.string(), path.string()))
+				{
+					std::printf("Skipping stale %s\n", path.string().c_str());
+					++stale;
+					continue;
+				}
+			}
+
+			const std::string entryPath = "Assets/" + path.lexically_relative(assets).generic_string();
+			if (!writer.AddFile(entryPath, path.string()))
+			{
+				std::printf("Can't read %s\n", path.string().c_str());
+				++failed;
+			}
+		}
+	}
+
+	if (!shaders.empty())
+	{
+		if (!fs::is_directory(shaders))
+		{
+			std::printf("Not a directory: %s\n", shaders.c_str());
+			return 1;
+		}
+		for (const auto& entry : fs::directory_iterator(shaders))
+		{
+			if (!entry.is_regular_file() || entry.path().extension() != ".spv")
+				continue;
+			if (!writer.AddFile("Shaders/" + entry.path().filename().string(), entry.path().string()))
+			{
+				std::printf("Can't read %s\n", entry.path().string().c_str());
+				++failed;
+			}
+		}
+	}
+
+	std::string error;
+	if (!writer.Write(output, error))
+	{
+		std::printf("Failed to write %s: %s\n", output.c_str(), error.c_str());
+		return 1;
+	}
+
+	std::printf("%s: %zu entries, %u stale cooked textures skipped, %u failed\n", output.c_str(),
+		writer.GetEntryCount(), stale, failed);
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,398 @@
+//------------------------------------------------------------------------------
+// BenchConfig.cpp
+//------------------------------------------------------------------------------
+
+#include "BenchConfig.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace Nightbloom
+{
+	namespace
+	{
+		using json = nlohmann::json;
+
+		template <typename T>
+		void Read(const json& object, const char* key, T& value)
+		{
+			if (object.contains(key))
+				value = object[key].get<T>();
+		}
+
+		void Read(const json& object, const char* key, glm::vec3& value)
+		{
+			if (!object.contains(key))
+				return;
+			const json& a = object[key];
+			if (!a.is_array() || a.size() != 3)
+				throw std::runtime_error(std::string("\"") + key + "\" must be an array of 3 numbers");
+			value = glm::vec3(a[0].get<float>(), a[1].get<float>(), a[2].get<float>());
+		}
+
+		// Enums by enumerator name, e.g. "PerlinWorley"
+		template <typename E, size_t N>
+		void ReadEnum(const json& object, const char* key, E& value, const char* const (&names)[N])
+		{
+			if (!object.contains(key))
+				return;
+			const std::string name = object[key].get<std::string>();
+			for (size_t i = 0; i < N; ++i)
+			{
+				if (name == names[i])
+				{
+					value = static_cast<E>(i);
+					return;
+				}
+			}
+			throw std::runtime_error(std::string("unknown ") + key + " \"" + name + "\"");
+		}
+
+		void ReadNoise(const json& object, NoiseTextureDesc& noise)
+		{
+			static const char* const noiseTypes[] = { "Perlin", "Worley", "PerlinWorley" };
+			static const char* const formats[] = { "RGBA32F", "R8", "RG8", "RGBA8", "BC4" };
+			static const char* const layouts[] = { "Single", "CloudShape" };
+			Read(object, "width", noise.width);
+			Read(object, "height", noise.height);
+			Read(object, "depth", noise.depth);
+			ReadEnum(object, "noiseType", noise.noiseType, noiseTypes);
+			Read(object, "octaves", noise.octaves);
+			Read(object, "frequency", noise.frequency);
+			Read(object, "persistence", noise.persistence);
+			Read(object, "lacunarity", noise.lacunarity);
+			Read(object, "seed", noise.seed);
+			ReadEnum(object, "format", noise.format, formats);
+			ReadEnum(object, "channels", noise.channels, layouts);
+			Read(object, "generateMips", noise.generateMips);
+		}
+
+		void ReadTerrain(const json& object, TerrainDesc& desc)
+		{
+			// TerrainPanel's defaults
+			desc.noise.width = desc.noise.height = 256;
+			desc.noise.depth = 1;
+			desc.noise.octaves = 6;
+			desc.noise.frequency = 3.0f;
+			desc.noise.seed = 42;
+			desc.noise.debugName = "TerrainHeightmap";
+
+			Read(object, "patchQuads", desc.patchQuads);
+			Read(object, "cellSize", desc.cellSize);
+			Read(object, "lodRangeScale", desc.lodRangeScale);
+			Read(object, "worldSize", desc.worldSize);
+			Read(object, "lodRangeScale", desc.lodRangeScale);
+			Read(object, "heightScale", desc.heightScale);
+			Read(object, "position", desc.position);
+			Read(object, "streaming", desc.streaming);
+			Read(object, "tileWorldSize", desc.tileWorldSize);
+			Read(object, "tileResolution", desc.tileResolution);
+			Read(object, "streamRadius", desc.streamRadius);
+			Read(object, "tilesPerFrame", desc.tilesPerFrame);
+			if (object.contains("noise"))
+				ReadNoise(object["noise"], desc.noise);
+		}
+
+		void ReadGrass(const json& object, GrassDesc& desc)
+		{
+			Read(object, "segments", desc.segments);
+			Read(object, "bladeBaseHalfWidth", desc.bladeBaseHalfWidth);
+			Read(object, "taperPower", desc.taperPower);
+			Read(object, "minTipWidthFraction", desc.minTipWidthFraction);
+			Read(object, "bendAmount", desc.bendAmount);
+			Read(object, "bladeHeight", desc.bladeHeight);
+			Read(object, "heightJitter", desc.heightJitter);
+			Read(object, "patchSize", desc.patchSize);
+			Read(object, "candidateSpacing", desc.candidateSpacing);
+			Read(object, "densityThreshold", desc.densityThreshold);
+			Read(object, "densityFrequency", desc.densityFrequency);
+			Read(object, "densityOctaves", desc.densityOctaves);
+			Read(object, "windStrength", desc.windStrength);
+			Read(object, "slopeThresholdDeg", desc.slopeThresholdDeg);
+			Read(object, "slopeFalloffDeg", desc.slopeFalloffDeg);
+			Read(object, "minApparentWidth", desc.minApparentWidth);
+			Read(object, "maxWidthBoost", desc.maxWidthBoost);
+			Read(object, "lodFullDistance", desc.lodFullDistance);
+			Read(object, "lodFadeDistance", desc.lodFadeDistance);
+			Read(object, "lodFadeBandBlades", desc.lodFadeBandBlades);
+			Read(object, "meshLodDistance", desc.meshLodDistance);
+			Read(object, "farField", desc.farField);
+			Read(object, "farFieldStrength", desc.farFieldStrength);
+			Read(object, "colorVariation", desc.colorVariation);
+			Read(object, "seed", desc.seed);
+		}
+
+		void ReadClouds(const json& object, CloudDesc& desc)
+		{
+			// CloudPanel's defaults
+			desc.shapeNoise.width = desc.shapeNoise.height = desc.shapeNoise.depth = 128;
+			desc.shapeNoise.noiseType = NoiseType::PerlinWorley;
+			desc.shapeNoise.octaves = 5;
+			desc.shapeNoise.frequency = 4.0f;
+			desc.shapeNoise.seed = 1337;
+			desc.shapeNoise.format = NoiseTextureFormat::RGBA8;
+			desc.shapeNoise.channels = NoiseChannelLayout::CloudShape;
+			desc.shapeNoise.generateMips = true;
+			desc.detailNoise.width = desc.detailNoise.height = desc.detailNoise.depth = 32;
+			desc.detailNoise.noiseType = NoiseType::Worley;
+			desc.detailNoise.octaves = 3;
+			desc.detailNoise.frequency = 8.0f;
+			desc.detailNoise.seed = 1338;
+			desc.detailNoise.format = NoiseTextureFormat::BC4;
+			desc.detailNoise.generateMips = true;
+
+			if (object.contains("shapeNoise"))
+				ReadNoise(object["shapeNoise"], desc.shapeNoise);
+			if (object.contains("detailNoise"))
+				ReadNoise(object["detailNoise"], desc.detailNoise);
+			Read(object, "layerMinY", desc.layerMinY);
+			Read(object, "layerMaxY", desc.layerMaxY);
+			Read(object, "windDirection", desc.windDirection);
+			Read(object, "windSpeed", desc.windSpeed);
+			Read(object, "shapeScale", desc.shapeScale);
+			Read(object, "detailScale", desc.detailScale);
+			Read(object, "detailStrength", desc.detailStrength);
+			Read(object, "coverage", desc.coverage);
+			Read(object, "densityMultiplier", desc.densityMultiplier);
+			Read(object, "extinctionCoefficient", desc.extinctionCoefficient);
+			Read(object, "hgAnisotropy", desc.hgAnisotropy);
+			Read(object, "stepCount", desc.stepCount);
+			Read(object, "resolutionScale", desc.resolutionScale);
+			Read(object, "checkerboardSize", desc.checkerboardSize);
+			Read(object, "reflectionStepScale", desc.reflectionStepScale);
+		}
+
+		void ReadWater(const json& object, WaterDesc& desc)
+		{
+			static const char* const waveModes[] = { "Normals", "FFT" };
+			static const char* const reflectionModes[] = { "Planar", "ScreenSpace" };
+
+			Read(object, "resolution", desc.resolution);
+			Read(object, "worldSize", desc.worldSize);
+			Read(object, "waterY", desc.waterY);
+			Read(object, "position", desc.position);
+			ReadEnum(object, "waveMode", desc.waveMode, waveModes);
+			if (object.contains("ocean"))
+			{
+				const json& ocean = object["ocean"];
+				Read(ocean, "resolution", desc.ocean.resolution);
+				Read(ocean, "cascadeCount", desc.ocean.cascadeCount);
+				Read(ocean, "cascadeLengths", desc.ocean.cascadeLengths);
+				Read(ocean, "windSpeed", desc.ocean.windSpeed);
+				Read(ocean, "windAngle", desc.ocean.windAngle);
+				Read(ocean, "amplitude", desc.ocean.amplitude);
+				Read(ocean, "choppiness", desc.ocean.choppiness);
+				Read(ocean, "foam", desc.ocean.foam);
+			}
+			Read(object, "waveAmplitude", desc.waveAmplitude);
+			Read(object, "waveSpeed", desc.waveSpeed);
+			Read(object, "fresnelPower", desc.fresnelPower);
+			Read(object, "alpha", desc.alpha);
+			ReadEnum(object, "reflectionMode", desc.reflectionMode, reflectionModes);
+			Read(object, "planarScale", desc.planarScale);
+			Read(object, "planarMinSize", desc.planarMinSize);
+			Read(object, "planarFoliage", desc.planarFoliage);
+			Read(object, "ssrMaxDistance", desc.ssrMaxDistance);
+			Read(object, "ssrThickness", desc.ssrThickness);
+		}
+
+		void ReadStress(const json& object, StressSceneDesc& desc)
+		{
+			static const char* const distributions[] = { "Uniform", "Grid", "Clustered" };
+
+			Read(object, "name", desc.name);
+			Read(object, "seed", desc.seed);
+			Read(object, "objectCount", desc.objectCount);
+			ReadEnum(object, "distribution", desc.distribution, distributions);
+			Read(object, "areaPerObject", desc.areaPerObject);
+			Read(object, "clusterCount", desc.clusterCount);
+			Read(object, "clusterRadius", desc.clusterRadius);
+			if (object.contains("assets"))
+			{
+				for (const json& a : object["assets"])
+				{
+					StressAsset asset;
+					Read(a, "source", asset.source);
+					Read(a, "primitive", asset.primitive);
+					Read(a, "texture", asset.texture);
+					Read(a, "weight", asset.weight);
+					Read(a, "minScale", asset.minScale);
+					Read(a, "maxScale", asset.maxScale);
+					desc.assets.push_back(asset);
+				}
+			}
+			Read(object, "pointLightCount", desc.pointLightCount);
+			Read(object, "lightRadius", desc.lightRadius);
+			Read(object, "sun", desc.sun);
+			Read(object, "waterPlaneCount", desc.waterPlaneCount);
+			Read(object, "waterPlaneSize", desc.waterPlaneSize);
+			Read(object, "waterY", desc.waterY);
+			Read(object, "fireflyCount", desc.fireflyCount);
+		}
+
+		void ReadStreaming(const json& object, WorldPartitionSettings& settings)
+		{
+			Read(object, "cellSize", settings.cellSize);
+			Read(object, "loadRadius", settings.loadRadius);
+			Read(object, "unloadRadius", settings.unloadRadius);
+			Read(object, "prefetchSeconds", settings.prefetchSeconds);
+			Read(object, "maxLoadsInFlight", settings.maxLoadsInFlight);
+
+			uint64_t budgetMB = settings.memoryBudget >> 20;
+			Read(object, "memoryBudgetMB", budgetMB);
+			settings.memoryBudget = budgetMB << 20;
+		}
+
+		void ReadCapture(const json& object, BenchCaptureConfig& capture)
+		{
+			static const char* const formats[] = { "PNG", "EXR" };
+
+			Read(object, "width", capture.settings.width);
+			Read(object, "height", capture.settings.height);
+			ReadEnum(object, "format", capture.settings.format, formats);
+			Read(object, "exposure", capture.settings.exposure);
+			Read(object, "tonemap", capture.settings.tonemap);
+			Read(object, "readbackSlots", capture.settings.readbackSlots);
+			Read(object, "writerThreads", capture.settings.writerThreads);
+			Read(object, "frames", capture.frames);
+			Read(object, "tileSize", capture.tileSize);
+			Read(object, "directory", capture.directory);
+			if (object.contains("shots"))
+			{
+				for (const json& s : object["shots"])
+				{
+					CameraKey shot;
+					Read(s, "position", shot.position);
+					Read(s, "target", shot.target);
+					capture.shots.push_back(shot);
+				}
+			}
+		}
+	}
+
+	bool BenchConfig::Load(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file.is_open())
+		{
+			LOG_ERROR("Bench: can't open config {}", path);
+			return false;
+		}
+
+		try
+		{
+			const json root = json::parse(file);
+
+			Read(root, "name", name);
+			Read(root, "scene", scene);
+			Read(root, "width", width);
+			Read(root, "height", height);
+			Read(root, "frames", frames);
+			Read(root, "warmupFrames", warmupFrames);
+			Read(root, "timestep", timestep);
+			Read(root, "pipelineStatistics", pipelineStatistics);
+			Read(root, "pipelined", pipelined);
+
+			if (root.contains("camera"))
+			{
+				const json& cam = root["camera"];
+				hasFov = cam.contains("fov");
+				Read(cam, "fov", fov);
+				Read(cam, "near", nearPlane);
+
+				float loop = 0.0f;
+				Read(cam, "loop", loop);
+				camera.SetLoop(loop);
+
+				if (cam.contains("keys"))
+				{
+					for (const json& k : cam["keys"])
+					{
+						CameraKey key;
+						Read(k, "time", key.time);
+						Read(k, "position", key.position);
+						Read(k, "target", key.target);
+						camera.AddKey(key);
+					}
+				}
+			}
+
+			if ((streaming = root.contains("streaming")))
+				ReadStreaming(root["streaming"], streamingSettings);
+			if ((terrain = root.contains("terrain")))
+				ReadTerrain(root["terrain"], terrainDesc);
+			if ((grass = root.contains("grass")))
+				ReadGrass(root["grass"], grassDesc);
+			if ((clouds = root.contains("clouds")))
+				ReadClouds(root["clouds"], cloudDesc);
+			if ((water = root.contains("water")))
+				ReadWater(root["water"], waterDesc);
+			if ((fireflies = root.contains("fireflies")))
+			{
+				const json& ff = root["fireflies"];
+				Read(ff, "count", fireflyConfig.count);
+				Read(ff, "center", fireflyConfig.center);
+				Read(ff, "extents", fireflyConfig.extents);
+			}
+			if ((stress = root.contains("stress")))
+				ReadStress(root["stress"], stressDesc);
+			if (root.contains("capture"))
+				ReadCapture(root["capture"], capture);
+			if (root.contains("regression"))
+			{
+				const json& regression = root["regression"];
+				Read(regression, "frameTolerance", tolerance.frame);
+				Read(regression, "gpuTolerance", tolerance.gpu);
+				Read(regression, "minDeltaMs", tolerance.minDeltaMs);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR("Bench: bad config {}: {}", path, e.what());
+			return false;
+		}
+
+		// Configs kept next to their scenes run from any directory
+		if (!scene.empty() && std::filesystem::path(scene).is_relative())
+		{
+			const std::filesystem::path beside = std::filesystem::path(path).parent_path() / scene;
+			std::error_code ec;
+			if (std::filesystem::is_regular_file(beside, ec))
+				scene = beside.string();
+		}
+
+		// Grass is laid over the terrain square (GrassPanel::BuildDesc)
+		grassDesc.terrainPosition = terrainDesc.position;
+		grassDesc.terrainWorldSize = terrainDesc.worldSize;
+		grassDesc.terrainHeightScale = terrainDesc.heightScale;
+
+		if (stress && (!scene.empty() || streaming))
+		{
+			LOG_ERROR("Bench: {} generates its scene (\"stress\"), so it takes no \"scene\" or \"streaming\"", path);
+			return false;
+		}
+		if (pipelined && streaming)
+		{
+			LOG_ERROR("Bench: {} streams its scene, which can't be \"pipelined\"", path);
+			return false;
+		}
+		if (timestep <= 0.0f || frames == 0)
+		{
+			LOG_ERROR("Bench: {} needs frames > 0 and timestep > 0", path);
+			return false;
+		}
+		if (capture.settings.width == 0 || capture.settings.height == 0 || capture.tileSize < 64)
+		{
+			LOG_ERROR("Bench: {} needs a capture size and a tileSize of at least 64", path);
+			return false;
+		}
+		if (tolerance.frame < 0.0f || tolerance.gpu < 0.0f || tolerance.minDeltaMs < 0.0f)
+		{
+			LOG_ERROR("Bench: {} has a negative regression tolerance", path);
+			return false;
+		}
+		return true;
+	}
+}
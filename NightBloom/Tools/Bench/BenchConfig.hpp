@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// BenchConfig.hpp
+//
+// A NightbloomBench run, read from a JSON file:
+//
+//   {
+//     "name": "valley-flythrough",
+//     "scene": "Assets/Scenes/Valley.nbscene",
+//     "width": 1920, "height": 1080,
+//     "frames": 1200, "warmupFrames": 120, "timestep": 0.016667,
+//     "pipelineStatistics": false, "pipelined": false,
+//     "streaming": { "cellSize": 128, "loadRadius": 384, "unloadRadius": 512,
+//                    "prefetchSeconds": 2, "memoryBudgetMB": 1024, "maxLoadsInFlight": 4 },
+//     "camera": { "fov": 60, "near": 0.1, "loop": 4.0,
+//                 "keys": [ { "time": 0, "position": [0, 20, 80], "target": [0, 5, 0] }, ... ] },
+//     "terrain":   { "resolution": 512, "noise": { "octaves": 6 }, ... },
+//     "grass":     { "candidateSpacing": 0.4, ... },
+//     "clouds":    { "coverage": 0.45, "shapeNoise": { ... }, ... },
+//     "water":     { "waveMode": "FFT", "reflectionMode": "Planar", "ocean": { ... }, ... },
+//     "fireflies": { "count": 1500, "center": [0, 10, 0], "extents": [50, 20, 50] },
+//     "stress":    { "seed": 7, "objectCount": 10000, "distribution": "Clustered",
+//                    "assets": [ { "source": "...", "weight": 3, "minScale": 0.01 }, ... ],
+//                    "pointLightCount": 256, "waterPlaneCount": 4, "fireflyCount": 100000 },
+//     "regression": { "frameTolerance": 0.10, "gpuTolerance": 0.15, "minDeltaMs": 0.1 },
+//     "capture":   { "width": 7680, "height": 4320, "format": "PNG", "frames": 240,
+//                    "directory": "Captures", "exposure": 1.0, "tonemap": true,
+//                    "shots": [ { "position": [0, 20, 80], "target": [0, 5, 0] }, ... ] }
+//   }
+//
+// Only the systems named run; an empty object runs one with the editor's
+// defaults. Desc fields use the C++ member names and keep their defaults
+// when left out. Without camera keys the camera stays at the scene file's
+// pose. A relative scene path is taken from the config file's directory when
+// the scene is there, else from the working directory; other relative paths
+// are taken from the working directory. Flythrough.json next to this file is
+// a starting point, and Scenes/ holds the regression gate's canonical runs.
+//
+// "streaming" loads the scene cell by cell around the camera (SceneStreamer)
+// instead of all at once.
+//
+// "pipelined" simulates each frame on a job while the previous one is
+// recorded (Application::SetFramePipelining): the camera, scene update and
+// scene draw list go into a RenderSnapshot, the renderer-side systems still
+// draw on the main thread. Streaming loads through the renderer, so it
+// can't be pipelined; --capture and --replay runs ignore it.
+//
+// "stress" generates the scene instead of loading one (StressScene.hpp),
+// so neither "scene" nor "streaming" may be given with it. Its water planes
+// take "water"'s desc, or the defaults, apart from where they are and how
+// big; the renderer reflects and simulates waves for the first, the others
+// are drawn flat (Normals). Its fireflyCount replaces "fireflies" with one
+// swarm over the whole scene. --save-scene writes the generated scene out.
+//
+// "regression" is only read by --baseline runs: the tolerance bands the
+// report is compared with its baseline by (see BenchmarkCompare.hpp).
+//
+// "capture" is only read by --capture runs (see Main.cpp): with shots, one
+// still per shot; without, `frames` images along the camera path at
+// timestep intervals. Files are <directory>/<name>_<nnnn>.png (or .exr).
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "Engine/Core/BenchmarkCompare.hpp"
+#include "Engine/Core/CameraPath.hpp"
+#include "Engine/Core/StressScene.hpp"
+#include "Engine/Core/WorldPartition.hpp"
+#include "Engine/Terrain/TerrainSystem.hpp"
+#include "Engine/Foliage/GrassSystem.hpp"
+#include "Engine/VFX/CloudSystem.hpp"
+#include "Engine/Hydro/WaterSystem.hpp"
+#include "Engine/Renderer/OffscreenCapture.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nightbloom
+{
+	struct BenchFireflyConfig
+	{
+		uint32_t count = 1500;
+		glm::vec3 center = glm::vec3(0.0f, 10.0f, 0.0f);
+		glm::vec3 extents = glm::vec3(50.0f, 20.0f, 50.0f);
+	};
+
+	struct BenchCaptureConfig
+	{
+		CaptureSettings settings;
+		uint32_t frames = 0;               // 0: the run's frames
+		uint32_t tileSize = 2048;          // window size, so the largest tile
+		std::string directory = "Captures";
+		std::vector<CameraKey> shots;      // time unused
+	};
+
+	struct BenchConfig
+	{
+		std::string name = "benchmark";
+		std::string scene;                 // empty: no scene objects
+
+		uint32_t width = 1920;
+		uint32_t height = 1080;
+		uint32_t frames = 1000;            // measured
+		uint32_t warmupFrames = 120;       // rendered first, not measured
+		float timestep = 1.0f / 60.0f;     // simulated seconds per frame
+		bool pipelineStatistics = false;   // GPU profiler query counts (costs a little GPU time)
+		bool pipelined = false;            // frame pipelining (simulate frame N+1 while N records)
+
+		bool streaming = false;            // scene through SceneStreamer
+		WorldPartitionSettings streamingSettings;
+
+		CameraPath camera;
+		float fov = 45.0f;                 // camera.fov, else the scene's
+		float nearPlane = 0.1f;
+		bool hasFov = false;
+
+		bool terrain = false;
+		TerrainDesc terrainDesc;
+		bool grass = false;
+		GrassDesc grassDesc;               // terrain bounds are copied from terrainDesc
+		bool clouds = false;
+		CloudDesc cloudDesc;
+		bool water = false;
+		WaterDesc waterDesc;
+		bool fireflies = false;
+		BenchFireflyConfig fireflyConfig;
+		bool stress = false;
+		StressSceneDesc stressDesc;
+		BenchCaptureConfig capture;
+		BenchmarkTolerance tolerance;
+
+		// Logs and returns false on a missing file or malformed JSON
+		bool Load(const std::string& path);
+	};
+}
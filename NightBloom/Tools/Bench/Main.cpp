@@ -0,0 +1,818 @@
+//------------------------------------------------------------------------------
+// Main.cpp
+//
+// NightbloomBench - renders a scene along a scripted camera path for a fixed
+// number of frames and writes CPU/GPU frame-time percentiles and per-pass
+// render counts (draws, binds, barriers, uploads) as JSON, for tracking
+// performance from change to change.
+//
+//   NightbloomBench [--output <file>] [--frames <n>] [--visible] [--capture]
+//                   [--replay <stream.nbdraw>] [--save-scene <file>]
+//                   [--baseline <file> [--update-baseline]] <config.json>
+//
+// The run is described by a config file (see BenchConfig.hpp): the scene,
+// which of terrain/grass/clouds/water/fireflies to add and their descs, and
+// the camera keys. Every frame advances simulated time by the same step, so
+// each run renders the same frames; only the measured times differ. The
+// first warmupFrames aren't measured (pipeline creation, streaming, first
+// uploads).
+//
+// The window stays hidden unless --visible is passed. The renderer still
+// draws into its swapchain (nothing is shown), presenting without V-Sync so
+// the display doesn't cap the frame rate. The report defaults to
+// <name>.bench.json in the working directory.
+//
+// --capture renders the config's "capture" section to image files instead
+// of timing anything (see OffscreenCapture.hpp): stills at any resolution,
+// or a sequence along the camera path. The window is one tile (tileSize)
+// and the main view follows each shot, drawn at a tenth of the scale since
+// nobody sees it; the shot's tiles are auxiliary views with their own
+// readbacks, several frames in flight. Time holds still while a shot's
+// tiles are drawn. The same auxiliary-view limits apply: no water,
+// transparents or clouds, and a single-sample reflection pass is needed.
+//
+// --replay submits a captured draw stream (see DrawStream.hpp; the editor's
+// debug panel captures one) every frame instead of building the scene's
+// draw list: the camera, time and lighting are pinned to the captured
+// frame and nothing is simulated or culled on the CPU, so frame to frame
+// the GPU does the same work and the per-pass timings are comparable across
+// drivers and shader changes. The config still loads the scene the stream's
+// resources come from, and its terrain/grass/clouds/water/fireflies still
+// run their own passes; their draws aren't in the stream.
+//
+// A config with a "stress" section builds a generated scene of the given
+// object, light, water and firefly counts instead of loading one, the same
+// for the same seed (see StressScene.hpp); Scenes/ has 1k/10k/100k ones.
+// --save-scene also writes it to a scene file (binary, or JSON for .json)
+// before the run, for the editor or a "scene" config to open.
+//
+// --baseline compares the report with an earlier one of the same config
+// (see BenchmarkCompare.hpp) by the config's "regression" bands, logs the
+// table and writes it next to the report as <report>.diff.txt. This is the
+// performance regression gate: the Perf.* CTest tests (Tools/CMakeLists.txt,
+// NIGHTBLOOM_PERF_TESTS) run the canonical configs in Scenes/ against
+// Baselines/. --update-baseline copies the report over the baseline instead
+// of comparing, after a change that is meant to move the numbers or on a
+// new machine - baselines are only comparable on the hardware they came from.
+//
+// Exit code 0 on success, 1 on a bad command line, config or draw stream, 2
+// when the engine or the scene failed to start, 3 when the report (or a
+// capture) can't be written, 4 when the report regressed against the
+// baseline, 5 when there is no baseline to compare with (CTest counts
+// the test as skipped) and 6 when the run dropped draws: instances that
+// found no room in the renderer's instance buffer, or replayed draws whose
+// resources the scene doesn't have. Such a run timed less work than the
+// config asks for, so its report is written but not compared.
+//------------------------------------------------------------------------------
+
+#include "BenchConfig.hpp"
+#include "Engine/Core/Application.hpp"
+#include "Engine/Core/BenchmarkCompare.hpp"
+#include "Engine/Core/BenchmarkReport.hpp"
+#include "Engine/Core/CpuProfiler.hpp"
+#include "Engine/Core/Logger/Logger.hpp"
+#include "Engine/Core/Scene.hpp"
+#include "Engine/Core/SceneSerializer.hpp"
+#include "Engine/Core/SceneStreamer.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/DrawStream.hpp"
+#include "Engine/Renderer/Frustum.hpp"
+#include "Engine/Renderer/OffscreenCapture.hpp"
+#include "Engine/Renderer/RenderStats.hpp"
+#include "Engine/Renderer/Components/GpuProfiler.hpp"
+#include "Engine/Renderer/Vulkan/VulkanDevice.hpp"
+#include "Engine/VFX/FireflySystem.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	using namespace Nightbloom;
+
+	void PrintUsage()
+	{
+		std::printf("Usage:\n"
+			"  NightbloomBench [--output <file>] [--frames <n>] [--visible] [--capture]\n"
+			"                  [--replay <stream.nbdraw>] [--save-scene <file>]\n"
+			"                  [--baseline <file> [--update-baseline]] <config.json>\n");
+	}
+
+	bool ReadText(const std::string& path, std::string& text)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			return false;
+		text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// The exit code of a --baseline run whose report was written
+	int CompareWithBaseline(const BenchConfig& config, const std::string& reportPath, const std::string& baselinePath,
+		bool update)
+	{
+		std::error_code ec;
+		if (update)
+		{
+			const std::filesystem::path parent = std::filesystem::path(baselinePath).parent_path();
+			if (!parent.empty())
+				std::filesystem::create_directories(parent, ec);
+			std::filesystem::copy_file(reportPath, baselinePath, std::filesystem::copy_options::overwrite_existing, ec);
+			if (ec)
+			{
+				LOG_ERROR("Bench: can't update baseline {}: {}", baselinePath, ec.message());
+				return 3;
+			}
+			LOG_INFO("Bench '{}': baseline {} updated", config.name, baselinePath);
+			return 0;
+		}
+
+		std::string baseline, report;
+		if (!ReadText(baselinePath, baseline))
+		{
+			LOG_WARN("Bench: no baseline {} - record one on this machine with --update-baseline", baselinePath);
+			return 5;
+		}
+		if (!ReadText(reportPath, report))
+		{
+			LOG_ERROR("Bench: can't read back {}", reportPath);
+			return 3;
+		}
+
+		BenchmarkComparison comparison;
+		std::string error;
+		if (!CompareBenchmarkReports(baseline, report, config.tolerance, comparison, error))
+		{
+			LOG_ERROR("Bench: can't compare with baseline {}: {}", baselinePath, error);
+			return 1;
+		}
+
+		const std::string text = comparison.BuildText();
+		const std::string diffPath = reportPath + ".diff.txt";
+		std::ofstream diff(diffPath, std::ios::trunc);
+		diff << text;
+		if (!diff)
+			LOG_WARN("Bench: can't write {}", diffPath);
+
+		if (comparison.HasRegressions())
+		{
+			LOG_ERROR("Bench '{}': {} metric(s) regressed against {}\n{}", config.name,
+				comparison.Count(BenchmarkVerdict::Regressed), baselinePath, text);
+			return 4;
+		}
+		LOG_INFO("Bench '{}': no regressions against {}\n{}", config.name, baselinePath, text);
+		return 0;
+	}
+
+	// Simulated time per frame while a capture's shot is still being tiled:
+	// as good as still, where 0 would mean the wall clock
+	constexpr float CAPTURE_HOLD_TIMESTEP = 1e-6f;
+
+	WindowDesc MakeWindowDesc(const BenchConfig& config, bool visible, bool capture)
+	{
+		WindowDesc desc;
+		desc.title = "NightbloomBench - " + config.name;
+		desc.width = static_cast<int>(config.width);
+		desc.height = static_cast<int>(config.height);
+		if (capture)
+		{
+			// Auxiliary targets are at most the swapchain's size
+			desc.width = static_cast<int>(std::min(config.capture.settings.width, config.capture.tileSize));
+			desc.height = static_cast<int>(std::min(config.capture.settings.height, config.capture.tileSize));
+		}
+		desc.resizable = false;
+		desc.visible = visible;
+		return desc;
+	}
+
+	class BenchApplication : public Application
+	{
+	public:
+		BenchApplication(const BenchConfig& config, const std::string& outputPath, bool visible, bool capture,
+			const std::string& replayPath, const std::string& saveScenePath)
+			: Application(MakeWindowDesc(config, visible, capture))
+			, m_Config(config)
+			, m_OutputPath(outputPath)
+			, m_CaptureMode(capture)
+			, m_ReplayPath(replayPath)
+			, m_SaveScenePath(saveScenePath)
+		{
+			SetFixedTimestep(m_Config.timestep);
+			GetRenderer()->SetPresentMode(VK_PRESENT_MODE_IMMEDIATE_KHR);
+
+			// Captures and replays drive the renderer from OnUpdate
+			if (m_Config.pipelined)
+			{
+				if (m_CaptureMode || IsReplaying())
+					LOG_WARN("Bench: \"pipelined\" is ignored by --capture and --replay runs");
+				else
+					SetFramePipelining(true);
+			}
+
+			if (m_CaptureMode)
+			{
+				// The main view only selects LOD and shadows for the shot
+				DynamicResolutionSettings resolution;
+				resolution.minScale = resolution.maxScale = 0.1f;
+				GetRenderer()->SetDynamicResolution(resolution);
+			}
+
+			if (GpuProfiler* profiler = GetRenderer()->GetGpuProfiler())
+			{
+				profiler->GetHistory().SetCapacity(m_Config.frames);
+				profiler->SetPipelineStatisticsEnabled(m_Config.pipelineStatistics);
+			}
+		}
+
+		~BenchApplication()
+		{
+			Renderer* renderer = GetRenderer();
+			renderer->WaitForIdle();
+			m_Capture.Shutdown();
+			renderer->SetDrawStreamReplay(nullptr);
+
+			renderer->SetTerrainSystem(nullptr);
+			renderer->SetGrassSystem(nullptr);
+			renderer->SetCloudSystem(nullptr);
+			renderer->SetWaterSystem(nullptr);
+			renderer->SetFireflySystem(nullptr);
+			if (m_Config.terrain) m_Terrain.Shutdown();
+			if (m_Config.grass) m_Grass.Shutdown();
+			if (m_Config.clouds) m_Clouds.Shutdown();
+			if (m_Config.water) m_Water.Shutdown();
+			for (std::unique_ptr<WaterSystem>& water : m_ExtraWater)
+				water->Shutdown();
+			if (m_Config.fireflies) m_Fireflies.Shutdown();
+
+			if (m_Scene)
+				m_Streamer.Close(*m_Scene);
+			m_Scene.reset();
+		}
+
+		int GetExitCode() const { return m_ExitCode; }
+
+		void OnStartup() override
+		{
+			Renderer* renderer = GetRenderer();
+
+			SceneCameraState cameraState;
+			m_Scene = std::make_unique<Scene>();
+			const bool sceneLoaded = m_Config.scene.empty() ||
+				(m_Config.streaming
+					? m_Streamer.Open(*m_Scene, cameraState, m_Config.scene, renderer, m_Config.streamingSettings)
+					: SceneSerializer::Load(*m_Scene, cameraState, m_Config.scene, renderer));
+			if (!sceneLoaded)
+			{
+				Fail(2, "can't load scene " + m_Config.scene);
+				return;
+			}
+			StressScene stress;
+			if (m_Config.stress)
+			{
+				stress = GenerateStressScene(m_Config.stressDesc);
+				SceneSerializer::Build(*m_Scene, cameraState, stress.data, renderer);
+				LOG_INFO("Bench '{}': generated {} objects, {} lights, {} water planes, {} fireflies (seed {})",
+					m_Config.name, m_Scene->GetObjectCount(), m_Scene->GetLightCount(), stress.waterPlanes.size(),
+					stress.fireflyCount, m_Config.stressDesc.seed);
+
+				if (!stress.waterPlanes.empty())
+				{
+					m_Config.water = true;
+					m_Config.waterDesc.position = stress.waterPlanes[0].position;
+					m_Config.waterDesc.waterY = stress.waterPlanes[0].position.y;
+					m_Config.waterDesc.worldSize = stress.waterPlanes[0].size;
+				}
+				if (stress.fireflyCount > 0)
+				{
+					m_Config.fireflies = true;
+					m_Config.fireflyConfig.count = stress.fireflyCount;
+					m_Config.fireflyConfig.center = stress.fireflyCenter;
+					m_Config.fireflyConfig.extents = stress.fireflyExtents;
+				}
+			}
+			if (!m_SaveScenePath.empty())
+			{
+				if (!SceneSerializer::Save(*m_Scene, cameraState, m_SaveScenePath, m_Config.name))
+				{
+					Fail(3, "can't write scene " + m_SaveScenePath);
+					return;
+				}
+				LOG_INFO("Bench '{}': scene saved to {}", m_Config.name, m_SaveScenePath);
+			}
+			if (m_Scene->GetLightCount() > 0)
+				renderer->SetShadowConfig(m_Scene->GetLight(0)->shadowConfig);
+
+			m_Camera = std::make_unique<Camera>();
+			m_Camera->SetPosition(cameraState.position);
+			m_Camera->SetRotation(cameraState.yaw, cameraState.pitch);
+			// Captures: the shot's aspect, so the main view culls and fits
+			// shadows to exactly what the tiles show
+			const float aspect = m_CaptureMode
+				? static_cast<float>(m_Config.capture.settings.width) / static_cast<float>(m_Config.capture.settings.height)
+				: static_cast<float>(renderer->GetWidth()) / static_cast<float>(std::max(renderer->GetHeight(), 1u));
+			m_Camera->SetPerspectiveInfiniteReverseZ(m_Config.hasFov ? m_Config.fov : cameraState.fov, aspect,
+				m_Config.hasFov ? m_Config.nearPlane : cameraState.nearPlane);
+			m_ViewHeight = renderer->GetHeight();
+
+			// Same order and wiring as the editor's panels
+			if (m_Config.terrain)
+			{
+				if (!m_Terrain.Initialize(renderer))
+				{
+					Fail(2, "TerrainSystem::Initialize failed");
+					return;
+				}
+				renderer->SetTerrainSystem(&m_Terrain);
+				m_Terrain.Regenerate(m_Config.terrainDesc);
+			}
+			if (m_Config.grass)
+			{
+				if (!m_Grass.Initialize(renderer) || !m_Grass.Regenerate(m_Config.grassDesc))
+				{
+					Fail(2, "GrassSystem failed to start");
+					return;
+				}
+				renderer->SetGrassSystem(&m_Grass);
+			}
+			if (m_Config.clouds)
+			{
+				if (!m_Clouds.Initialize(renderer) || !m_Clouds.Regenerate(m_Config.cloudDesc))
+				{
+					Fail(2, "CloudSystem failed to start");
+					return;
+				}
+				renderer->SetCloudSystem(&m_Clouds);
+			}
+			if (m_Config.water)
+			{
+				if (!m_Water.Initialize(renderer) || !m_Water.Regenerate(m_Config.waterDesc))
+				{
+					Fail(2, "WaterSystem failed to start");
+					return;
+				}
+				renderer->SetWaterSystem(&m_Water);
+			}
+			// The renderer has one water system: the other planes are only
+			// drawn, so their waves can't be simulated
+			for (size_t i = 1; i < stress.waterPlanes.size(); ++i)
+			{
+				WaterDesc desc = m_Config.waterDesc;
+				desc.position = stress.waterPlanes[i].position;
+				desc.worldSize = stress.waterPlanes[i].size;
+				desc.waveMode = WaterWaveMode::Normals;
+				auto& water = m_ExtraWater.emplace_back(std::make_unique<WaterSystem>());
+				if (!water->Initialize(renderer) || !water->Regenerate(desc))
+				{
+					Fail(2, "WaterSystem failed to start");
+					return;
+				}
+			}
+			if (m_Config.fireflies)
+			{
+				const BenchFireflyConfig& ff = m_Config.fireflyConfig;
+				if (!m_Fireflies.Initialize(renderer, ff.count, ff.center, ff.extents))
+				{
+					Fail(2, "FireflySystem::Initialize failed");
+					return;
+				}
+				renderer->SetFireflySystem(&m_Fireflies);
+			}
+
+			if (m_CaptureMode)
+			{
+				if (!m_Capture.Initialize(renderer, m_Config.capture.settings))
+				{
+					Fail(2, "OffscreenCapture::Initialize failed");
+					return;
+				}
+				m_ShotCount = !m_Config.capture.shots.empty() ? static_cast<uint32_t>(m_Config.capture.shots.size())
+					: m_Config.capture.frames > 0 ? m_Config.capture.frames : m_Config.frames;
+				LOG_INFO("Bench '{}': capturing {} image(s) of {}x{} to {}", m_Config.name, m_ShotCount,
+					m_Config.capture.settings.width, m_Config.capture.settings.height, m_Config.capture.directory);
+				return;
+			}
+
+			if (!m_ReplayPath.empty())
+			{
+				if (!ReadDrawStream(m_ReplayPath, m_Replay))
+				{
+					Fail(1, "can't read draw stream " + m_ReplayPath);
+					return;
+				}
+				renderer->SetDrawStreamReplay(&m_Replay);
+				LOG_INFO("Bench '{}': replaying {} draws from {} ({} skipped at capture)",
+					m_Config.name, m_Replay.draws.size(), m_ReplayPath, m_Replay.skippedDraws);
+			}
+
+			if (m_Config.warmupFrames == 0)
+				BeginMeasuring();
+
+			LOG_INFO("Bench '{}': {} warm-up + {} measured frames at {:.4f} s steps",
+				m_Config.name, m_Config.warmupFrames, m_Config.frames, m_Config.timestep);
+		}
+
+		void OnUpdate(float deltaTime) override
+		{
+			// The renderer takes the replayed frame's camera and lighting
+			if (!m_Camera || IsReplaying())
+				return;
+
+			if (m_CaptureMode)
+			{
+				UpdateCapture();
+			}
+			// Time from the frame count, not summed steps, so it doesn't drift
+			else if (!m_Config.camera.IsEmpty())
+			{
+				const CameraPose pose = m_Config.camera.Evaluate(static_cast<float>(m_FrameCount) * m_Config.timestep);
+				m_Camera->SetPosition(pose.position);
+				m_Camera->SetRotation(pose.yaw, pose.pitch);
+			}
+
+			m_Streamer.Update(*m_Scene, m_Camera->GetPosition(), deltaTime);
+			m_Scene->Update(deltaTime);
+
+			// On the simulation job: OnBuildRenderSnapshot hands the rest over
+			if (IsFramePipeliningEnabled())
+				return;
+
+			Renderer* renderer = GetRenderer();
+			renderer->SetViewMatrix(m_Camera->GetViewMatrix());
+			renderer->SetProjectionMatrix(m_Camera->GetProjectionMatrix());
+			renderer->SetCameraPosition(m_Camera->GetPosition());
+
+			const Frustum lightFrustum = Frustum::ExtractFromMatrix(
+				m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix());
+			renderer->SetLightingData(m_Scene->BuildLightingData(&lightFrustum, m_Camera->GetPosition()));
+			m_Scene->BuildPointLights(m_PointLights, &lightFrustum, m_Camera->GetPosition());
+			renderer->SetPointLights(m_PointLights);
+		}
+
+		// Pipelined runs: what OnUpdate and OnRender give the renderer
+		// otherwise, but the scene's draws only
+		void OnBuildRenderSnapshot(RenderSnapshot& snapshot) override
+		{
+			if (!m_Camera)
+				return;
+
+			snapshot.view = m_Camera->GetViewMatrix();
+			snapshot.projection = m_Camera->GetProjectionMatrix();
+			snapshot.cameraPosition = m_Camera->GetPosition();
+
+			const Frustum frustum = Frustum::ExtractFromMatrix(snapshot.projection * snapshot.view);
+			snapshot.lighting = m_Scene->BuildLightingData(&frustum, snapshot.cameraPosition);
+			m_Scene->BuildPointLights(snapshot.pointLights, &frustum, snapshot.cameraPosition);
+			snapshot.hasLighting = true;
+
+			snapshot.drawList.SetLodView(LodView::FromCamera(snapshot.cameraPosition, m_Camera->GetFov(),
+				static_cast<float>(m_ViewHeight)));
+			m_Scene->BuildDrawList(snapshot.drawList, &frustum);
+		}
+
+		void OnRender() override
+		{
+			if (!m_Camera)
+				return;
+
+			Renderer* renderer = GetRenderer();
+			DrawList& drawList = renderer->GetFrameDrawList();
+			if (IsFramePipeliningEnabled())
+			{
+				// The snapshot's scene draws are in the list already; the
+				// systems add theirs for the camera it was built with
+				const glm::vec3 cameraPosition = renderer->GetCameraPosition();
+				SubmitSystemDraws(drawList, cameraPosition,
+					Frustum::ExtractFromMatrix(renderer->GetProjectionMatrix() * renderer->GetViewMatrix()));
+				drawList.Sort(cameraPosition);
+				return;
+			}
+			if (IsReplaying())
+			{
+				const uint32_t dropped = renderer->BuildDrawStreamList(m_Replay, drawList);
+				if (dropped > 0 && m_FrameCount == 0)
+					LOG_WARN("Bench: {} replayed draws name resources this scene doesn't have", dropped);
+				m_DroppedDraws += dropped;
+				drawList.Sort(m_Replay.cameraPosition);
+				renderer->SubmitDrawList(drawList);
+				return;
+			}
+
+			const glm::vec3 cameraPosition = m_Camera->GetPosition();
+			const Frustum frustum = Frustum::ExtractFromMatrix(m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix());
+
+			// Captures pick LOD for the output's pixels, not the window's
+			const uint32_t viewHeight = m_CaptureMode ? m_Config.capture.settings.height : renderer->GetHeight();
+			drawList.SetLodView(LodView::FromCamera(cameraPosition, m_Camera->GetFov(), static_cast<float>(viewHeight)));
+
+			// Capture tiles, culled in the same pass as the main view
+			AuxiliaryView auxViews[MAX_AUXILIARY_VIEWS];
+			Frustum auxFrusta[MAX_AUXILIARY_VIEWS];
+			const uint32_t auxCount = m_CaptureMode ? m_Capture.PrepareFrame(auxViews) : 0;
+			for (uint32_t i = 0; i < auxCount; ++i)
+				auxFrusta[i] = Frustum::ExtractFromMatrix(auxViews[i].projection * auxViews[i].view);
+			if (m_CaptureMode)
+			{
+				renderer->SetAuxiliaryViews(auxViews, auxCount);
+				m_Capture.SubmitFrame();
+			}
+			m_Scene->BuildDrawList(drawList, &frustum, auxFrusta, auxCount);
+			SubmitSystemDraws(drawList, cameraPosition, frustum);
+
+			drawList.Sort(cameraPosition);
+			renderer->SubmitDrawList(drawList);
+		}
+
+		void OnFrameEnd() override
+		{
+			if (m_CaptureMode)
+			{
+				if (!m_Camera)
+					return;
+				if (m_NextShot == m_ShotCount && m_Capture.IsFinished())
+					FinishCapture();
+				// The next frame starts a new shot, or draws more of this one
+				SetFixedTimestep(m_Capture.HasTilesToDraw() ? CAPTURE_HOLD_TIMESTEP : m_Config.timestep);
+				return;
+			}
+
+			const uint64_t nowNs = CpuProfiler::Now();
+			const uint32_t frame = m_FrameCount++;
+			if (const uint32_t dropped = GetRenderer()->GetDroppedInstanceCount())
+			{
+				if (m_DroppedInstances == 0)
+					LOG_ERROR("Bench: frame {} dropped {} of {} instances (instance buffer full)", frame, dropped,
+						dropped + GetRenderer()->GetInstanceCount());
+				m_DroppedInstances += dropped;
+			}
+			const uint32_t measureEnd = m_Config.warmupFrames + m_Config.frames;
+
+			if (frame + 1 == m_Config.warmupFrames)
+			{
+				BeginMeasuring();
+			}
+			else if (frame >= m_Config.warmupFrames && frame < measureEnd)
+			{
+				// One capture per frame: everything recorded since the last one
+				const CpuProfileCapture capture = CpuProfiler::Get().Capture();
+				CpuProfiler::Get().Clear();
+				m_Report.AddFrame(static_cast<float>(nowNs - m_LastFrameEndNs) * 1e-6f, capture);
+				// Renderer::EndFrame closed this frame's counts
+				m_Report.AddRenderStats(RenderStats::Get().GetLastFrame());
+			}
+			else if (frame >= measureEnd + GetRenderer()->GetFramesInFlight())
+			{
+				// Rendered as many frames again as may be in flight, so the
+				// measured frames' GPU timings have been read back
+				Finish();
+			}
+			m_LastFrameEndNs = nowNs;
+		}
+
+	private:
+		bool IsReplaying() const { return !m_ReplayPath.empty(); }
+
+		// The renderer-side systems' draws, after the scene's
+		void SubmitSystemDraws(DrawList& drawList, const glm::vec3& cameraPosition, const Frustum& frustum)
+		{
+			if (m_Terrain.IsReady())
+			{
+				m_Terrain.UpdateLOD(cameraPosition);
+				m_Terrain.SubmitDraw(drawList);
+			}
+			// Grass maps the whole terrain square, which streaming doesn't have
+			if (m_Grass.IsReady() && m_Terrain.IsReady() && !m_Terrain.IsStreaming())
+				m_Grass.SubmitDraw(drawList, frustum, m_Terrain.GetHeightmapDescriptorSet(), cameraPosition);
+			if (m_Fireflies.IsReady())
+				m_Fireflies.SubmitDraw(drawList);
+			if (m_Clouds.IsReady())
+				m_Clouds.SubmitDraw(drawList);
+			if (m_Water.IsReady())
+			{
+				m_Water.UpdateLOD(cameraPosition);
+				m_Water.SubmitDraw(drawList, &frustum);
+			}
+			for (std::unique_ptr<WaterSystem>& water : m_ExtraWater)
+			{
+				if (!water->IsReady())
+					continue;
+				water->UpdateLOD(cameraPosition);
+				water->SubmitDraw(drawList, &frustum);
+			}
+			GetRenderer()->SubmitSkyDraw(drawList);
+		}
+
+		// The next frame is the first measured one
+		void BeginMeasuring()
+		{
+			CpuProfiler::Get().Clear();
+			if (GpuProfiler* profiler = GetRenderer()->GetGpuProfiler())
+				profiler->GetHistory().Clear();
+			m_Report.Clear();
+			m_LastFrameEndNs = CpuProfiler::Now();
+		}
+
+		// Queues the next shot once the last one's tiles are all drawn: its
+		// camera comes from the shot list, or the path at the shot's time
+		void UpdateCapture()
+		{
+			if (m_Capture.HasTilesToDraw() || m_NextShot == m_ShotCount)
+				return;
+
+			const uint32_t shot = m_NextShot++;
+			if (!m_Config.capture.shots.empty())
+			{
+				const CameraKey& key = m_Config.capture.shots[shot];
+				const CameraPose pose = CameraPath::LookAt(key.position, key.target);
+				m_Camera->SetPosition(pose.position);
+				m_Camera->SetRotation(pose.yaw, pose.pitch);
+			}
+			else if (!m_Config.camera.IsEmpty())
+			{
+				const CameraPose pose = m_Config.camera.Evaluate(static_cast<float>(shot) * m_Config.timestep);
+				m_Camera->SetPosition(pose.position);
+				m_Camera->SetRotation(pose.yaw, pose.pitch);
+			}
+
+			char name[32];
+			std::snprintf(name, sizeof(name), "_%04u.%s", shot,
+				m_Config.capture.settings.format == CaptureFormat::Png ? "png" : "exr");
+
+			CaptureShot capture;
+			capture.view = m_Camera->GetViewMatrix();
+			capture.projection = m_Camera->GetProjectionMatrix();
+			capture.position = m_Camera->GetPosition();
+			capture.path = (std::filesystem::path(m_Config.capture.directory) / (m_Config.name + name)).string();
+			m_Capture.AddShot(capture);
+		}
+
+		void FinishCapture()
+		{
+			m_Capture.Shutdown();
+			const uint32_t written = m_Capture.GetWrittenCount();
+			const uint32_t failed = m_Capture.GetFailedCount();
+			LOG_INFO("Bench '{}': wrote {} image(s) to {}", m_Config.name, written, m_Config.capture.directory);
+			if (failed > 0)
+			{
+				LOG_ERROR("Bench: {} capture(s) failed to write", failed);
+				m_ExitCode = 3;
+			}
+			Quit();
+		}
+
+		void Fail(int exitCode, const std::string& message)
+		{
+			LOG_ERROR("Bench: {}", message);
+			m_ExitCode = exitCode;
+			m_Camera.reset();
+			Quit();
+		}
+
+		void Finish()
+		{
+			BenchmarkInfo info;
+			info.name = m_Config.name;
+			info.scene = m_Config.scene;
+			info.width = GetRenderer()->GetWidth();
+			info.height = GetRenderer()->GetHeight();
+			info.warmupFrames = m_Config.warmupFrames;
+			info.timestep = m_Config.timestep;
+
+			VkPhysicalDeviceProperties properties{};
+			vkGetPhysicalDeviceProperties(static_cast<VulkanDevice*>(GetRenderer()->GetDevice())->GetPhysicalDevice(), &properties);
+			info.device = properties.deviceName;
+
+			const GpuProfiler* profiler = GetRenderer()->GetGpuProfiler();
+			const GpuProfileHistory* gpu = (profiler && profiler->IsSupported()) ? &profiler->GetHistory() : nullptr;
+
+			std::string error;
+			if (!m_Report.WriteJson(m_OutputPath, info, gpu, error))
+			{
+				LOG_ERROR("Bench: can't write {}: {}", m_OutputPath, error);
+				m_ExitCode = 3;
+			}
+			else
+			{
+				const BenchmarkSeries frame = m_Report.GetFrameStats();
+				LOG_INFO("Bench '{}': frame p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms -> {}",
+					m_Config.name, frame.p50, frame.p95, frame.p99, m_OutputPath);
+				if (m_Report.GetLostCpuEvents() > 0)
+					LOG_WARN("Bench: {} CPU scopes were overwritten before a capture", m_Report.GetLostCpuEvents());
+				if (m_DroppedInstances > 0 || m_DroppedDraws > 0)
+				{
+					LOG_ERROR("Bench '{}': {} instances and {} replayed draws were dropped over the run; "
+						"the timings don't cover the whole scene", m_Config.name, m_DroppedInstances, m_DroppedDraws);
+					m_ExitCode = 6;
+				}
+			}
+			Quit();
+		}
+
+		BenchConfig m_Config;
+		std::string m_OutputPath;
+		int m_ExitCode = 0;
+
+		bool m_CaptureMode = false;
+		OffscreenCapture m_Capture;
+		uint32_t m_ShotCount = 0;
+		uint32_t m_NextShot = 0;
+
+		std::string m_ReplayPath;
+		DrawStream m_Replay;
+		std::string m_SaveScenePath;
+
+		std::unique_ptr<Scene> m_Scene;
+		SceneStreamer m_Streamer;
+		std::unique_ptr<Camera> m_Camera;
+		std::vector<LightData> m_PointLights;
+
+		TerrainSystem m_Terrain;
+		GrassSystem m_Grass;
+		CloudSystem m_Clouds;
+		WaterSystem m_Water;
+		std::vector<std::unique_ptr<WaterSystem>> m_ExtraWater;   // a stress scene's other planes
+		FireflySystem m_Fireflies;
+
+		uint32_t m_ViewHeight = 0;   // for the snapshot's LOD view
+		uint32_t m_FrameCount = 0;
+		uint64_t m_LastFrameEndNs = 0;
+		uint64_t m_DroppedInstances = 0;   // over every frame, warmup included
+		uint64_t m_DroppedDraws = 0;
+		BenchmarkReport m_Report;
+	};
+}
+
+int main(int argc, char** argv)
+{
+	std::string configPath, outputPath;
+	long frames = -1;
+	bool visible = false;
+	bool capture = false;
+	std::string replayPath;
+	std::string saveScenePath;
+	std::string baselinePath;
+	bool updateBaseline = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--output" && i + 1 < argc)
+			outputPath = argv[++i];
+		else if (arg == "--frames" && i + 1 < argc)
+			frames = std::strtol(argv[++i], nullptr, 10);
+		else if (arg == "--visible")
+			visible = true;
+		else if (arg == "--capture")
+			capture = true;
+		else if (arg == "--replay" && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (arg == "--save-scene" && i + 1 < argc)
+			saveScenePath = argv[++i];
+		else if (arg == "--baseline" && i + 1 < argc)
+			baselinePath = argv[++i];
+		else if (arg == "--update-baseline")
+			updateBaseline = true;
+		else if (configPath.empty() && arg.rfind("--", 0) != 0)
+			configPath = arg;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (configPath.empty() || (capture && !replayPath.empty()) || (capture && !baselinePath.empty()) ||
+		(updateBaseline && baselinePath.empty()))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	Nightbloom::BenchConfig config;
+	if (!config.Load(configPath))
+		return 1;
+	if (frames > 0)
+		config.frames = static_cast<uint32_t>(frames);
+	if (outputPath.empty())
+		outputPath = config.name + ".bench.json";
+
+	int exitCode = 0;
+	try
+	{
+		BenchApplication app(config, outputPath, visible, capture, replayPath, saveScenePath);
+		app.Run();
+		exitCode = app.GetExitCode();
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "NightbloomBench: %s\n", e.what());
+		return 2;
+	}
+	if (exitCode == 0 && !baselinePath.empty())
+		exitCode = CompareWithBaseline(config, outputPath, baselinePath, updateBaseline);
+	return exitCode;
+}
@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+// Main.cpp
+//
+// TextureCooker - converts source images into BC7/BC5 KTX2 files with
+// precomputed mips (see Engine/Renderer/TextureCooker.hpp).
+//
+//   TextureCooker [--force] <directory>...         cook every stale image
+//   TextureCooker [--normal] <source> <output>     cook one file
+//------------------------------------------------------------------------------
+
+#include "Engine/Renderer/TextureCooker.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf("Usage:\n"
+			"  TextureCooker [--force] <directory>...\n"
+			"  TextureCooker [--normal] <source> <output.ktx2>\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool force = false;
+	bool normal = false;
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--force")
+			force = true;
+		else if (arg == "--normal")
+			normal = true;
+		else
+			paths.push_back(arg);
+	}
+
+	if (paths.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// A single source file and its destination
+	if (paths.size() == 2 && std::filesystem::is_regular_file(paths[0]))
+	{
+		const Nightbloom::TextureKind kind = normal ? Nightbloom::TextureKind::Normal
+			: Nightbloom::GuessTextureKind(paths[0]);
+		return Nightbloom::CookTexture(paths[0], paths[1], kind) ? 0 : 1;
+	}
+
+	uint32_t failed = 0;
+	for (const std::string& directory : paths)
+	{
+		if (!std::filesystem::is_directory(directory))
+		{
+			std::printf("Not a directory: %s\n", directory.c_str());
+			++failed;
+			continue;
+		}
+
+		const Nightbloom::TextureCookStats stats = Nightbloom::CookTextureDirectory(directory, force);
+		std::printf("%s: %u cooked, %u up to date, %u failed\n", directory.c_str(),
+			stats.cooked, stats.upToDate, stats.failed);
+		failed += stats.failed;
+	}
+	return failed == 0 ? 0 : 1;
+}